@@ -0,0 +1,165 @@
+/********************************************************************************
+* ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
+* Copyright (c) 2010-2018 Daniel Chappuis                                       *
+*********************************************************************************
+*                                                                               *
+* This software is provided 'as-is', without any express or implied warranty.   *
+* In no event will the authors be held liable for any damages arising from the  *
+* use of this software.                                                         *
+*                                                                               *
+* Permission is granted to anyone to use this software for any purpose,         *
+* including commercial applications, and to alter it and redistribute it        *
+* freely, subject to the following restrictions:                                *
+*                                                                               *
+* 1. The origin of this software must not be misrepresented; you must not claim *
+*    that you wrote the original software. If you use this software in a        *
+*    product, an acknowledgment in the product documentation would be           *
+*    appreciated but is not required.                                           *
+*                                                                               *
+* 2. Altered source versions must be plainly marked as such, and must not be    *
+*    misrepresented as being the original software.                             *
+*                                                                               *
+* 3. This notice may not be removed or altered from any source distribution.    *
+*                                                                               *
+********************************************************************************/
+
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+// Libraries
+#include "reactphysics3d.h"
+#include <string>
+#include <vector>
+#include <cstring>
+
+/// Reactphysics3D namespace
+namespace reactphysics3d {
+
+// Class Benchmark
+/**
+ * This abstract class represents a headless benchmark scene. The scene is created by the
+ * constructor of the subclass with a given number of bodies and the step() method is called
+ * to advance it by one frame. The benchmarks of a dynamics world also expose the world so
+ * that the statistics of its steps and its profiler can be read. The world of a subclass is
+ * declared after its collision shapes so that it is destroyed first. The sleeping of the
+ * bodies is disabled so that every measured step does the same work. The subclasses keep
+ * their bodies in their order of creation to compute a hash of the state of the scene.
+ */
+class Benchmark {
+
+    private :
+
+        // ---------- Attributes ---------- //
+
+        /// Name of the scene
+        std::string mName;
+
+        /// Number of bodies of the scene
+        uint mNbBodies;
+
+    protected :
+
+        // ---------- Attributes ---------- //
+
+        /// Time step of the simulation
+        decimal mTimeStep;
+
+        /// Bodies of the scene (in their order of creation)
+        std::vector<CollisionBody*> mBodies;
+
+        // ---------- Methods ---------- //
+
+        /// Add the bytes of a value to a FNV-1a hash
+        static void hashValue(uint64& hash, decimal value) {
+            unsigned char bytes[sizeof(decimal)];
+            std::memcpy(bytes, &value, sizeof(decimal));
+            for (unsigned char byte : bytes) {
+                hash = (hash ^ byte) * 1099511628211ull;
+            }
+        }
+
+        /// Add the bytes of a vector to a FNV-1a hash
+        static void hashVector(uint64& hash, const Vector3& vector) {
+            hashValue(hash, vector.x);
+            hashValue(hash, vector.y);
+            hashValue(hash, vector.z);
+        }
+
+    public :
+
+        // ---------- Constants ---------- //
+
+        /// Default time step of the simulation
+        static constexpr decimal DEFAULT_TIME_STEP = decimal(1.0) / decimal(60.0);
+
+        // ---------- Methods ---------- //
+
+        /// Constructor
+        Benchmark(const std::string& name, uint nbBodies)
+            : mName(name), mNbBodies(nbBodies), mTimeStep(DEFAULT_TIME_STEP) {
+
+        }
+
+        /// Destructor
+        virtual ~Benchmark() = default;
+
+        /// Deleted copy-constructor
+        Benchmark(const Benchmark& benchmark) = delete;
+
+        /// Deleted assignment operator
+        Benchmark& operator=(const Benchmark& benchmark) = delete;
+
+        /// Return the name of the scene
+        const std::string& getName() const {
+            return mName;
+        }
+
+        /// Return the number of bodies of the scene
+        uint getNbBodies() const {
+            return mNbBodies;
+        }
+
+        /// Return the time step of the simulation
+        decimal getTimeStep() const {
+            return mTimeStep;
+        }
+
+        /// Set the time step of the simulation
+        void setTimeStep(decimal timeStep) {
+            mTimeStep = timeStep;
+        }
+
+        /// Return a hash of the transforms and velocities of the bodies of the scene
+        /// Two runs of a scene have the same hash only if their states are bit-identical.
+        uint64 computeStateHash() const {
+
+            uint64 hash = 14695981039346656037ull;
+            for (const CollisionBody* body : mBodies) {
+
+                const Transform& transform = body->getTransform();
+                hashVector(hash, transform.getPosition());
+                hashVector(hash, transform.getOrientation().getVectorV());
+                hashValue(hash, transform.getOrientation().w);
+
+                const RigidBody* rigidBody = dynamic_cast<const RigidBody*>(body);
+                if (rigidBody != nullptr) {
+                    hashVector(hash, rigidBody->getLinearVelocity());
+                    hashVector(hash, rigidBody->getAngularVelocity());
+                }
+            }
+
+            return hash;
+        }
+
+        /// Advance the scene by one frame
+        virtual void step()=0;
+
+        /// Return the dynamics world of the scene (null if the scene is not simulated)
+        virtual DynamicsWorld* getDynamicsWorld() {
+            return nullptr;
+        }
+};
+
+}
+
+#endif
@@ -0,0 +1,876 @@
+/********************************************************************************
+* ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
+* Copyright (c) 2010-2018 Daniel Chappuis                                       *
+*********************************************************************************
+*                                                                               *
+* This software is provided 'as-is', without any express or implied warranty.   *
+* In no event will the authors be held liable for any damages arising from the  *
+* use of this software.                                                         *
+*                                                                               *
+* Permission is granted to anyone to use this software for any purpose,         *
+* including commercial applications, and to alter it and redistribute it        *
+* freely, subject to the following restrictions:                                *
+*                                                                               *
+* 1. The origin of this software must not be misrepresented; you must not claim *
+*    that you wrote the original software. If you use this software in a        *
+*    product, an acknowledgment in the product documentation would be           *
+*    appreciated but is not required.                                           *
+*                                                                               *
+* 2. Altered source versions must be plainly marked as such, and must not be    *
+*    misrepresented as being the original software.                             *
+*                                                                               *
+* 3. This notice may not be removed or altered from any source distribution.    *
+*                                                                               *
+********************************************************************************/
+
+// Libraries
+#include "reactphysics3d.h"
+#include "scenes/CubeStackBenchmark.h"
+#include "scenes/HeightFieldBenchmark.h"
+#include "scenes/ConcaveMeshBenchmark.h"
+#include "scenes/JointsBenchmark.h"
+#include "scenes/RaycastBenchmark.h"
+#include "memory/MemoryFootprintBenchmark.h"
+#include "utils/Profiler.h"
+#include <chrono>
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <sstream>
+#include <limits>
+#include <algorithm>
+#include <memory>
+#include <vector>
+#include <map>
+#include <cstdlib>
+
+using namespace reactphysics3d;
+
+// Benchmark of the iterations of the contact solver
+/// A pile of boxes is created and simulated until the contacts are persistent. The world is
+/// then stepped with one and with many velocity iterations (the sleeping is disabled). The
+/// difference between the two timings is the cost of the solver iterations because the other
+/// parts of the step (collision detection, initialization of the constraints, ...) are the same.
+
+namespace solver {
+
+/// Number of boxes along each horizontal axis of the pile
+const uint NB_BOXES_PER_SIDE = 10;
+
+/// Number of layers of boxes of the pile
+const uint NB_LAYERS = 5;
+
+/// Number of steps used to let the pile settle before the measure
+const uint NB_WARMUP_STEPS = 120;
+
+/// Number of measured steps
+const uint NB_MEASURED_STEPS = 100;
+
+/// Number of repetitions of the measure (the fastest one is kept)
+const uint NB_REPETITIONS = 5;
+
+/// Number of velocity iterations of the solver for the measure
+const uint NB_VELOCITY_ITERATIONS = 30;
+
+/// Time step of the simulation
+const decimal TIME_STEP = decimal(1.0) / decimal(60.0);
+
+// Create the pile of boxes
+void createPile(DynamicsWorld& world, BoxShape& boxShape, BoxShape& floorShape) {
+
+    RigidBody* floor = world.createRigidBody(Transform(Vector3(0, -1, 0), Quaternion::identity()));
+    floor->setType(BodyType::STATIC);
+    floor->addCollisionShape(&floorShape, Transform::identity(), decimal(1.0));
+
+    for (uint l=0; l < NB_LAYERS; l++) {
+        for (uint i=0; i < NB_BOXES_PER_SIDE; i++) {
+            for (uint j=0; j < NB_BOXES_PER_SIDE; j++) {
+                const Vector3 position(decimal(i) * decimal(1.01), decimal(0.5) + decimal(l) * decimal(1.01),
+                                       decimal(j) * decimal(1.01));
+                RigidBody* body = world.createRigidBody(Transform(position, Quaternion::identity()));
+                body->addCollisionShape(&boxShape, Transform::identity(), decimal(1.0));
+            }
+        }
+    }
+}
+
+// Return the average time (in milliseconds) of a step of the world
+double measureStep(DynamicsWorld& world, uint nbVelocityIterations) {
+
+    world.setNbIterationsVelocitySolver(nbVelocityIterations);
+
+    double minTime = std::numeric_limits<double>::max();
+    for (uint r=0; r < NB_REPETITIONS; r++) {
+
+        const auto start = std::chrono::high_resolution_clock::now();
+        for (uint i=0; i < NB_MEASURED_STEPS; i++) {
+            world.update(TIME_STEP);
+        }
+        const auto end = std::chrono::high_resolution_clock::now();
+
+        minTime = std::min(minTime, std::chrono::duration<double, std::milli>(end - start).count());
+    }
+
+    return minTime / NB_MEASURED_STEPS;
+}
+
+// Run the benchmark with some world settings
+void runBenchmark(const std::string& name, const WorldSettings& settings) {
+
+    BoxShape boxShape(Vector3(decimal(0.5), decimal(0.5), decimal(0.5)));
+    BoxShape floorShape(Vector3(50, 1, 50));
+
+    DynamicsWorld world(Vector3(0, decimal(-9.81), 0), settings);
+    world.enableSleeping(false);
+    createPile(world, boxShape, floorShape);
+
+    // Let the pile settle
+    for (uint i=0; i < NB_WARMUP_STEPS; i++) {
+        world.update(TIME_STEP);
+    }
+
+    const double stepTime = measureStep(world, 1);
+    const double stepTimeWithIterations = measureStep(world, NB_VELOCITY_ITERATIONS);
+    const double iterationTime = (stepTimeWithIterations - stepTime) / (NB_VELOCITY_ITERATIONS - 1);
+
+    std::cout << std::left << std::setw(24) << name << std::right << std::fixed << std::setprecision(4)
+              << std::setw(12) << stepTime << " ms/step"
+              << std::setw(12) << iterationTime << " ms/iteration" << std::endl;
+}
+
+// Compare the iterations of the contact solvers
+void runContactSolverBenchmarks() {
+
+    std::cout << "Contact solver benchmark (" << NB_BOXES_PER_SIDE * NB_BOXES_PER_SIDE * NB_LAYERS
+              << " boxes)" << std::endl;
+
+    WorldSettings scalarSettings;
+    runBenchmark("Scalar solver", scalarSettings);
+
+    WorldSettings wideSettings;
+    wideSettings.isWideContactSolverEnabled = true;
+    runBenchmark("Wide solver", wideSettings);
+
+    WorldSettings blockSettings;
+    blockSettings.isBlockContactSolverEnabled = true;
+    runBenchmark("Block solver", blockSettings);
+}
+
+}
+
+// Headless benchmarks of the canonical scenes
+/// Each scene is created with several numbers of bodies, simulated for some warm-up steps and
+/// then measured during some steps. The median time of a step is the value compared with a
+/// baseline to detect the performance regressions. The time of the stages of the step comes
+/// from the statistics of the world and, when the library is compiled with the profiler, the
+/// time of each block of code profiled inside DynamicsWorld::update() is also reported.
+
+namespace {
+
+/// Names of the scenes
+const char* const SCENE_NAMES[] = {"cubestack", "heightfield", "concavemesh", "joints", "raycast"};
+
+/// Default numbers of bodies of the scenes
+const uint DEFAULT_SIZES[] = {1000, 10000, 100000};
+
+// Structure BenchmarkResult
+/// Measures of a scene with a given number of bodies
+struct BenchmarkResult {
+
+    /// Name of the scene
+    std::string name;
+
+    /// Number of bodies of the scene
+    uint nbBodies = 0;
+
+    /// Number of worker threads of the task scheduler of the world (zero without scheduler)
+    uint nbThreads = 0;
+
+    /// Number of measured steps
+    uint nbSteps = 0;
+
+    /// Median time of a step (in milliseconds)
+    double msPerStep = 0.0;
+
+    /// Average time of a step (in milliseconds)
+    double meanMsPerStep = 0.0;
+
+    /// Average time of the collision detection of a step (in milliseconds)
+    double collisionDetectionMs = 0.0;
+
+    /// Average time of the broad-phase of a step (in milliseconds)
+    double broadPhaseMs = 0.0;
+
+    /// Average time of the middle-phase and narrow-phase of a step (in milliseconds)
+    double narrowPhaseMs = 0.0;
+
+    /// Average time of the computation of the islands of a step (in milliseconds)
+    double islandsMs = 0.0;
+
+    /// Average time of the constraint solver of a step (in milliseconds)
+    double solverMs = 0.0;
+
+    /// Average number of contact points of a step
+    double nbContactPoints = 0.0;
+
+    /// Average time of the profiled blocks of code of a step (in milliseconds)
+    std::vector<std::pair<std::string, double>> profile;
+};
+
+// Options of the command line
+struct Options {
+
+    /// Names of the scenes to run
+    std::vector<std::string> scenes;
+
+    /// Numbers of bodies of the scenes
+    std::vector<uint> sizes;
+
+    /// Number of steps used to let the scenes settle before the measure
+    uint nbWarmupSteps = 120;
+
+    /// Number of measured steps
+    uint nbSteps = 60;
+
+    /// Path of the JSON file of the results (empty for no file)
+    std::string jsonPath;
+
+    /// Path of the JSON file of the baseline results (empty for no comparison)
+    std::string baselinePath;
+
+    /// Relative slowdown of the median step time above which a result is a regression
+    double threshold = 0.1;
+
+    /// True if the benchmark of the contact solvers must be run instead of the scenes
+    bool runSolvers = false;
+
+    /// Name of the scene to play back (empty to run the benchmarks of the scenes)
+    std::string playbackScene;
+
+    /// Number of frames of the playback
+    uint nbPlaybackFrames = 600;
+
+    /// Number of bodies of the scene of the playback
+    uint nbPlaybackBodies = 1000;
+
+    /// Time step of the playback (in seconds)
+    decimal timeStep = Benchmark::DEFAULT_TIME_STEP;
+
+    /// Numbers of worker threads of the scalability sweep (empty to run the scenes without scheduler)
+    std::vector<uint> threadCounts;
+
+    /// True if the memory footprint of each type of collision shape must be measured instead of running the scenes
+    bool runMemoryFootprint = false;
+};
+
+// Create the benchmark of a scene (null if the name is unknown)
+std::unique_ptr<Benchmark> createBenchmark(const std::string& name, uint nbBodies,
+                                           const WorldSettings& worldSettings = WorldSettings()) {
+
+    if (name == "cubestack") return std::unique_ptr<Benchmark>(new CubeStackBenchmark(nbBodies, worldSettings));
+    if (name == "heightfield") return std::unique_ptr<Benchmark>(new HeightFieldBenchmark(nbBodies, worldSettings));
+    if (name == "concavemesh") return std::unique_ptr<Benchmark>(new ConcaveMeshBenchmark(nbBodies, worldSettings));
+    if (name == "joints") return std::unique_ptr<Benchmark>(new JointsBenchmark(nbBodies, worldSettings));
+    if (name == "raycast") return std::unique_ptr<Benchmark>(new RaycastBenchmark(nbBodies, worldSettings));
+    return std::unique_ptr<Benchmark>();
+}
+
+#ifdef IS_PROFILING_ACTIVE
+
+// Return the total time of the blocks of code profiled inside DynamicsWorld::update()
+std::vector<std::pair<std::string, double>> readProfiledBlocks(Profiler* profiler, uint nbSteps) {
+
+    std::vector<std::pair<std::string, double>> blocks;
+
+    ProfileNodeIterator* iterator = profiler->getIterator();
+    iterator->first();
+    for (int i=0; !iterator->isEnd(); i++, iterator->next()) {
+
+        if (std::string(iterator->getCurrentName()) == "DynamicsWorld::update()") {
+
+            iterator->enterChild(i);
+            for (iterator->first(); !iterator->isEnd(); iterator->next()) {
+                blocks.push_back(std::make_pair(std::string(iterator->getCurrentName()),
+                                                double(iterator->getCurrentTotalTime()) / nbSteps));
+            }
+            break;
+        }
+    }
+
+    delete iterator;
+
+    return blocks;
+}
+
+#endif
+
+// Simulate a scene and measure its steps
+BenchmarkResult runBenchmark(Benchmark& benchmark, const Options& options) {
+
+    BenchmarkResult result;
+    result.name = benchmark.getName();
+    result.nbBodies = benchmark.getNbBodies();
+    result.nbSteps = options.nbSteps;
+
+    // Let the scene settle
+    for (uint i=0; i < options.nbWarmupSteps; i++) {
+        benchmark.step();
+    }
+
+    DynamicsWorld* world = benchmark.getDynamicsWorld();
+
+#ifdef IS_PROFILING_ACTIVE
+    if (world != nullptr) {
+        world->getProfiler()->reset();
+    }
+#endif
+
+    std::vector<double> stepTimes;
+    stepTimes.reserve(options.nbSteps);
+    for (uint i=0; i < options.nbSteps; i++) {
+
+        const auto start = std::chrono::steady_clock::now();
+        benchmark.step();
+        const auto end = std::chrono::steady_clock::now();
+
+        const double stepTime = std::chrono::duration<double, std::milli>(end - start).count();
+        stepTimes.push_back(stepTime);
+        result.meanMsPerStep += stepTime;
+
+        if (world != nullptr) {
+            const StepStatistics& statistics = world->getStepStatistics();
+            result.collisionDetectionMs += statistics.collisionDetectionTime * 1000.0;
+            result.broadPhaseMs += statistics.broadPhaseTime * 1000.0;
+            result.narrowPhaseMs += statistics.narrowPhaseTime * 1000.0;
+            result.islandsMs += statistics.islandsTime * 1000.0;
+            result.solverMs += statistics.solverTime * 1000.0;
+            result.nbContactPoints += statistics.nbContactPoints;
+        }
+    }
+
+    const double nbSteps = double(std::max(options.nbSteps, 1u));
+    result.meanMsPerStep /= nbSteps;
+    result.collisionDetectionMs /= nbSteps;
+    result.broadPhaseMs /= nbSteps;
+    result.narrowPhaseMs /= nbSteps;
+    result.islandsMs /= nbSteps;
+    result.solverMs /= nbSteps;
+    result.nbContactPoints /= nbSteps;
+
+    if (!stepTimes.empty()) {
+        std::sort(stepTimes.begin(), stepTimes.end());
+        result.msPerStep = stepTimes[stepTimes.size() / 2];
+    }
+
+#ifdef IS_PROFILING_ACTIVE
+    if (world != nullptr) {
+        result.profile = readProfiledBlocks(world->getProfiler(), options.nbSteps);
+    }
+#endif
+
+    return result;
+}
+
+// Write a string as a JSON string
+void writeJsonString(std::ostream& stream, const std::string& text) {
+    stream << '"';
+    for (char c : text) {
+        if (c == '"' || c == '\\') stream << '\\';
+        stream << c;
+    }
+    stream << '"';
+}
+
+// Write the results into a JSON file
+/// Each result is written on its own line so that the file can be read back as a baseline
+/// without a complete JSON parser.
+bool writeJson(const std::string& path, const std::vector<BenchmarkResult>& results, const Options& options) {
+
+    std::ofstream file(path);
+    if (!file) {
+        return false;
+    }
+
+    file << std::setprecision(6);
+    file << "{" << std::endl;
+#ifdef IS_DOUBLE_PRECISION_ENABLED
+    file << "\"precision\":\"double\"," << std::endl;
+#else
+    file << "\"precision\":\"float\"," << std::endl;
+#endif
+    file << "\"warmupSteps\":" << options.nbWarmupSteps << "," << std::endl;
+    file << "\"results\":[" << std::endl;
+    for (uint i=0; i < results.size(); i++) {
+
+        const BenchmarkResult& result = results[i];
+        file << "{\"name\":";
+        writeJsonString(file, result.name);
+        file << ",\"bodies\":" << result.nbBodies << ",\"threads\":" << result.nbThreads << ",\"steps\":" << result.nbSteps <<
+                ",\"msPerStep\":" << result.msPerStep << ",\"meanMsPerStep\":" << result.meanMsPerStep <<
+                ",\"stages\":{\"collisionDetectionMs\":" << result.collisionDetectionMs <<
+                ",\"broadPhaseMs\":" << result.broadPhaseMs << ",\"narrowPhaseMs\":" << result.narrowPhaseMs <<
+                ",\"islandsMs\":" << result.islandsMs << ",\"solverMs\":" << result.solverMs << "}" <<
+                ",\"contactPoints\":" << result.nbContactPoints << ",\"profile\":{";
+        for (uint p=0; p < result.profile.size(); p++) {
+            file << (p > 0 ? "," : "");
+            writeJsonString(file, result.profile[p].first);
+            file << ":" << result.profile[p].second;
+        }
+        file << "}}" << (i + 1 < results.size() ? "," : "") << std::endl;
+    }
+    file << "]" << std::endl << "}" << std::endl;
+
+    return true;
+}
+
+// Return the key of a result in a baseline
+std::string getResultKey(const std::string& name, uint nbBodies, uint nbThreads) {
+    return name + "/" + std::to_string(nbBodies) + "/" + std::to_string(nbThreads);
+}
+
+// Return the text of the value of a field in a line of a JSON file written by writeJson()
+bool findJsonField(const std::string& line, const std::string& field, std::string& value) {
+
+    const std::string key = "\"" + field + "\":";
+    const size_t position = line.find(key);
+    if (position == std::string::npos) {
+        return false;
+    }
+
+    size_t begin = position + key.size();
+    size_t end;
+    if (begin < line.size() && line[begin] == '"') {
+        begin++;
+        end = line.find('"', begin);
+    }
+    else {
+        end = line.find_first_of(",}", begin);
+    }
+    if (end == std::string::npos) {
+        return false;
+    }
+
+    value = line.substr(begin, end - begin);
+    return true;
+}
+
+// Read the median step times of the results of a JSON file written by writeJson()
+bool readBaseline(const std::string& path, std::map<std::string, double>& baseline) {
+
+    std::ifstream file(path);
+    if (!file) {
+        return false;
+    }
+
+    std::string line;
+    while (std::getline(file, line)) {
+
+        std::string name, nbBodies, nbThreads, msPerStep;
+        if (findJsonField(line, "name", name) && findJsonField(line, "bodies", nbBodies) &&
+            findJsonField(line, "msPerStep", msPerStep)) {
+
+            // The results written before the thread sweeps have no number of threads
+            const uint threads = findJsonField(line, "threads", nbThreads) ? uint(std::stoul(nbThreads)) : 0;
+            baseline[getResultKey(name, uint(std::stoul(nbBodies)), threads)] = std::stod(msPerStep);
+        }
+    }
+
+    return true;
+}
+
+// Play back a scene from its creation and print the time of its frames and the hash of its final state
+/// Two runs of the same scene with the same options must print the same hash. A different hash
+/// means that a change has modified the simulation and not only its speed.
+int runPlayback(const Options& options) {
+
+    std::unique_ptr<Benchmark> benchmark = createBenchmark(options.playbackScene, options.nbPlaybackBodies);
+    if (!benchmark) {
+        std::cerr << "Unknown scene " << options.playbackScene << std::endl;
+        return 2;
+    }
+    benchmark->setTimeStep(options.timeStep);
+
+    std::vector<double> frameTimes;
+    frameTimes.reserve(options.nbPlaybackFrames);
+    double totalMs = 0.0;
+    for (uint i=0; i < options.nbPlaybackFrames; i++) {
+
+        const auto start = std::chrono::steady_clock::now();
+        benchmark->step();
+        const auto end = std::chrono::steady_clock::now();
+
+        const double frameTime = std::chrono::duration<double, std::milli>(end - start).count();
+        frameTimes.push_back(frameTime);
+        totalMs += frameTime;
+    }
+
+    const uint64 stateHash = benchmark->computeStateHash();
+
+    std::vector<double> sortedFrameTimes(frameTimes);
+    std::sort(sortedFrameTimes.begin(), sortedFrameTimes.end());
+    const double meanMs = totalMs / double(std::max(options.nbPlaybackFrames, 1u));
+    const double medianMs = sortedFrameTimes.empty() ? 0.0 : sortedFrameTimes[sortedFrameTimes.size() / 2];
+    const double p95Ms = sortedFrameTimes.empty() ? 0.0 : sortedFrameTimes[(sortedFrameTimes.size() * 95) / 100];
+    const double maxMs = sortedFrameTimes.empty() ? 0.0 : sortedFrameTimes.back();
+
+    std::ostringstream hashText;
+    hashText << "0x" << std::hex << std::setw(16) << std::setfill('0') << stateHash;
+
+    std::cout << std::fixed << std::setprecision(3) <<
+                 "Scene:      " << benchmark->getName() << " (" << benchmark->getNbBodies() << " bodies)" << std::endl <<
+                 "Frames:     " << options.nbPlaybackFrames << " of " << benchmark->getTimeStep() * 1000.0 << " ms" << std::endl <<
+                 "Total:      " << totalMs << " ms" << std::endl <<
+                 "Mean:       " << meanMs << " ms" << std::endl <<
+                 "Median:     " << medianMs << " ms" << std::endl <<
+                 "95th perc.: " << p95Ms << " ms" << std::endl <<
+                 "Max:        " << maxMs << " ms" << std::endl <<
+                 "State hash: " << hashText.str() << std::endl;
+
+    if (!options.jsonPath.empty()) {
+
+        std::ofstream file(options.jsonPath);
+        if (!file) {
+            std::cerr << "Cannot write the JSON file " << options.jsonPath << std::endl;
+            return 2;
+        }
+
+        file << std::setprecision(6);
+        file << "{\"name\":";
+        writeJsonString(file, benchmark->getName());
+        file << ",\"bodies\":" << benchmark->getNbBodies() << ",\"frames\":" << options.nbPlaybackFrames <<
+                ",\"timeStep\":" << benchmark->getTimeStep() << ",\"totalMs\":" << totalMs <<
+                ",\"meanMs\":" << meanMs << ",\"medianMs\":" << medianMs << ",\"p95Ms\":" << p95Ms <<
+                ",\"maxMs\":" << maxMs << ",\"stateHash\":\"" << hashText.str() << "\",\"frameTimesMs\":[";
+        for (uint i=0; i < frameTimes.size(); i++) {
+            file << (i > 0 ? "," : "") << frameTimes[i];
+        }
+        file << "]}" << std::endl;
+    }
+
+    return 0;
+}
+
+// Return the parallel efficiency of a stage with a number of threads relative to a reference number of threads
+/// The efficiency is one when the time of the stage is divided by the ratio of the numbers of threads.
+double computeEfficiency(double referenceMs, uint nbReferenceThreads, double ms, uint nbThreads) {
+    if (ms <= 0.0 || nbThreads == 0) return 0.0;
+    return (referenceMs * nbReferenceThreads) / (ms * nbThreads);
+}
+
+// Run each scene with a task scheduler for each number of worker threads and print the
+// parallel efficiency of the stages of the steps
+/// The efficiencies are relative to the first number of threads of the sweep. The integration
+/// of the bodies is done by the tasks of the islands and is part of the solver stage.
+int runScalability(const Options& options) {
+
+    std::cout << std::left << std::setw(14) << "Scene" << std::right << std::setw(8) << "Bodies" <<
+                 std::setw(9) << "Threads" << std::setw(12) << "ms/step" << std::setw(10) << "speedup" <<
+                 std::setw(10) << "total" << std::setw(10) << "broad" << std::setw(10) << "narrow" <<
+                 std::setw(10) << "islands" << std::setw(10) << "solver" << std::endl;
+
+    std::vector<BenchmarkResult> results;
+    for (const std::string& scene : options.scenes) {
+        for (uint size : options.sizes) {
+
+            BenchmarkResult reference;
+            for (uint t=0; t < options.threadCounts.size(); t++) {
+
+                // The scheduler is declared before the scene so that it outlives the world
+                DefaultTaskScheduler scheduler(options.threadCounts[t]);
+                WorldSettings worldSettings;
+                worldSettings.taskScheduler = &scheduler;
+
+                std::unique_ptr<Benchmark> benchmark = createBenchmark(scene, size, worldSettings);
+                if (!benchmark) {
+                    std::cerr << "Unknown scene " << scene << std::endl;
+                    return 2;
+                }
+
+                BenchmarkResult result = runBenchmark(*benchmark, options);
+                result.nbThreads = scheduler.getNbWorkers();
+                results.push_back(result);
+                if (t == 0) reference = result;
+
+                const uint n = result.nbThreads;
+                const uint r = reference.nbThreads;
+                std::cout << std::left << std::setw(14) << result.name << std::right << std::setw(8) << result.nbBodies <<
+                             std::setw(9) << n << std::fixed << std::setprecision(3) << std::setw(12) << result.msPerStep <<
+                             std::setprecision(2) << std::setw(10) << (result.msPerStep > 0.0 ? reference.msPerStep / result.msPerStep : 0.0) <<
+                             std::setprecision(0) <<
+                             std::setw(9) << 100.0 * computeEfficiency(reference.msPerStep, r, result.msPerStep, n) << "%" <<
+                             std::setw(9) << 100.0 * computeEfficiency(reference.broadPhaseMs, r, result.broadPhaseMs, n) << "%" <<
+                             std::setw(9) << 100.0 * computeEfficiency(reference.narrowPhaseMs, r, result.narrowPhaseMs, n) << "%" <<
+                             std::setw(9) << 100.0 * computeEfficiency(reference.islandsMs, r, result.islandsMs, n) << "%" <<
+                             std::setw(9) << 100.0 * computeEfficiency(reference.solverMs, r, result.solverMs, n) << "%" << std::endl;
+            }
+        }
+    }
+
+    if (!options.jsonPath.empty() && !writeJson(options.jsonPath, results, options)) {
+        std::cerr << "Cannot write the JSON file " << options.jsonPath << std::endl;
+        return 2;
+    }
+
+    return 0;
+}
+
+// Measure and print the memory footprint of the objects of a world for each type of collision shape
+int runMemoryFootprint(const Options& options) {
+
+    const char* shapeNames[] = {"box", "sphere", "capsule", "convexmesh", "concavemesh", "heightfield"};
+
+    MemoryFootprintBenchmark benchmark;
+    std::vector<MemoryFootprint> footprints;
+
+    std::cout << "Bytes per object (averages including the growth of the containers)" << std::endl;
+    std::cout << std::left << std::setw(14) << "Shape" << std::right << std::setw(8) << "Bodies" <<
+                 std::setw(10) << "body" << std::setw(10) << "proxy" << std::setw(10) << "BVH node" <<
+                 std::setw(10) << "pair" << std::setw(10) << "manifold" << std::setw(10) << "pairs" <<
+                 std::setw(11) << "manifolds" << std::endl;
+
+    for (const char* shapeName : shapeNames) {
+        for (uint size : options.sizes) {
+
+            MemoryFootprint footprint;
+            benchmark.run(shapeName, size, footprint);
+            footprints.push_back(footprint);
+
+            std::cout << std::left << std::setw(14) << footprint.shapeName << std::right << std::setw(8) << footprint.nbBodies <<
+                         std::fixed << std::setprecision(1) << std::setw(10) << footprint.bytesPerBody <<
+                         std::setw(10) << footprint.bytesPerProxyShape << std::setw(10) << footprint.bytesPerTreeNode <<
+                         std::setw(10) << footprint.bytesPerOverlappingPair << std::setw(10) << footprint.bytesPerContactManifold <<
+                         std::setw(10) << footprint.nbOverlappingPairs << std::setw(11) << footprint.nbContactManifolds << std::endl;
+        }
+    }
+
+    if (!options.jsonPath.empty()) {
+
+        std::ofstream file(options.jsonPath);
+        if (!file) {
+            std::cerr << "Cannot write the JSON file " << options.jsonPath << std::endl;
+            return 2;
+        }
+
+        file << std::setprecision(6);
+        file << "{" << std::endl << "\"memory\":[" << std::endl;
+        for (uint i=0; i < footprints.size(); i++) {
+
+            const MemoryFootprint& footprint = footprints[i];
+            file << "{\"shape\":";
+            writeJsonString(file, footprint.shapeName);
+            file << ",\"bodies\":" << footprint.nbBodies << ",\"treeNodes\":" << footprint.nbTreeNodes <<
+                    ",\"overlappingPairs\":" << footprint.nbOverlappingPairs <<
+                    ",\"contactManifolds\":" << footprint.nbContactManifolds <<
+                    ",\"bytesPerBody\":" << footprint.bytesPerBody << ",\"bytesPerProxyShape\":" << footprint.bytesPerProxyShape <<
+                    ",\"bytesPerTreeNode\":" << footprint.bytesPerTreeNode <<
+                    ",\"bytesPerOverlappingPair\":" << footprint.bytesPerOverlappingPair <<
+                    ",\"bytesPerContactManifold\":" << footprint.bytesPerContactManifold << "}" <<
+                    (i + 1 < footprints.size() ? "," : "") << std::endl;
+        }
+        file << "]" << std::endl << "}" << std::endl;
+    }
+
+    return 0;
+}
+
+// Split a comma-separated list
+std::vector<std::string> splitList(const std::string& list) {
+
+    std::vector<std::string> items;
+    std::stringstream stream(list);
+    std::string item;
+    while (std::getline(stream, item, ',')) {
+        if (!item.empty()) {
+            items.push_back(item);
+        }
+    }
+
+    return items;
+}
+
+// Print the usage of the benchmarks
+void printUsage() {
+
+    std::cout << "Usage: benchmarks [options]" << std::endl <<
+                 "  --scenes a,b,...   Scenes to run (cubestack, heightfield, concavemesh, joints, raycast)" << std::endl <<
+                 "  --sizes n,m,...    Numbers of bodies of the scenes (default: 1000,10000,100000)" << std::endl <<
+                 "  --warmup n         Number of steps before the measure (default: 120)" << std::endl <<
+                 "  --steps n          Number of measured steps (default: 60)" << std::endl <<
+                 "  --json file        Write the results into a JSON file" << std::endl <<
+                 "  --baseline file    Compare the results with a JSON file of a previous run" << std::endl <<
+                 "  --threshold x      Relative slowdown of a regression (default: 0.1)" << std::endl <<
+                 "  --solvers          Compare the contact solvers instead of running the scenes" << std::endl <<
+                 "  --threads n,m,...  Run the scenes with each number of worker threads (1,2,4,8,16,32 for instance)" << std::endl <<
+                 "                     and print the parallel efficiency of the stages of the steps" << std::endl <<
+                 "  --memory           Print the bytes per body, proxy shape, tree node, pair and manifold of each" << std::endl <<
+                 "                     type of collision shape instead of running the scenes" << std::endl <<
+                 "  --playback scene   Play back a scene and print its frame times and final state hash" << std::endl <<
+                 "  --frames n         Number of frames of the playback (default: 600)" << std::endl <<
+                 "  --size n           Number of bodies of the playback (default: 1000)" << std::endl <<
+                 "  --timestep dt      Time step of the playback in seconds (default: 1/60)" << std::endl;
+}
+
+// Parse the options of the command line
+bool parseOptions(int argc, char** argv, Options& options) {
+
+    for (int i=1; i < argc; i++) {
+
+        const std::string argument = argv[i];
+        const bool hasValue = i + 1 < argc;
+
+        if (argument == "--scenes" && hasValue) {
+            options.scenes = splitList(argv[++i]);
+        }
+        else if (argument == "--sizes" && hasValue) {
+            options.sizes.clear();
+            for (const std::string& size : splitList(argv[++i])) {
+                options.sizes.push_back(uint(std::strtoul(size.c_str(), nullptr, 10)));
+            }
+        }
+        else if (argument == "--warmup" && hasValue) {
+            options.nbWarmupSteps = uint(std::strtoul(argv[++i], nullptr, 10));
+        }
+        else if (argument == "--steps" && hasValue) {
+            options.nbSteps = uint(std::strtoul(argv[++i], nullptr, 10));
+        }
+        else if (argument == "--json" && hasValue) {
+            options.jsonPath = argv[++i];
+        }
+        else if (argument == "--baseline" && hasValue) {
+            options.baselinePath = argv[++i];
+        }
+        else if (argument == "--threshold" && hasValue) {
+            options.threshold = std::strtod(argv[++i], nullptr);
+        }
+        else if (argument == "--solvers") {
+            options.runSolvers = true;
+        }
+        else if (argument == "--threads" && hasValue) {
+            options.threadCounts.clear();
+            for (const std::string& nbThreads : splitList(argv[++i])) {
+                options.threadCounts.push_back(uint(std::strtoul(nbThreads.c_str(), nullptr, 10)));
+            }
+            if (options.threadCounts.empty()) {
+                return false;
+            }
+        }
+        else if (argument == "--memory") {
+            options.runMemoryFootprint = true;
+        }
+        else if (argument == "--playback" && hasValue) {
+            options.playbackScene = argv[++i];
+        }
+        else if (argument == "--frames" && hasValue) {
+            options.nbPlaybackFrames = uint(std::strtoul(argv[++i], nullptr, 10));
+        }
+        else if (argument == "--size" && hasValue) {
+            options.nbPlaybackBodies = uint(std::strtoul(argv[++i], nullptr, 10));
+        }
+        else if (argument == "--timestep" && hasValue) {
+            options.timeStep = decimal(std::strtod(argv[++i], nullptr));
+            if (options.timeStep <= decimal(0.0)) {
+                return false;
+            }
+        }
+        else {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+}
+
+// Main function
+/// The exit code is 1 if a result is slower than its baseline by more than the threshold
+/// and 2 if the command line or a file is invalid.
+int main(int argc, char** argv) {
+
+    Options options;
+    options.scenes.assign(std::begin(SCENE_NAMES), std::end(SCENE_NAMES));
+    options.sizes.assign(std::begin(DEFAULT_SIZES), std::end(DEFAULT_SIZES));
+
+    if (!parseOptions(argc, argv, options)) {
+        printUsage();
+        return 2;
+    }
+
+    if (options.runSolvers) {
+        solver::runContactSolverBenchmarks();
+        return 0;
+    }
+
+    if (!options.playbackScene.empty()) {
+        return runPlayback(options);
+    }
+
+    if (!options.threadCounts.empty()) {
+        return runScalability(options);
+    }
+
+    if (options.runMemoryFootprint) {
+        return runMemoryFootprint(options);
+    }
+
+    std::map<std::string, double> baseline;
+    if (!options.baselinePath.empty() && !readBaseline(options.baselinePath, baseline)) {
+        std::cerr << "Cannot read the baseline file " << options.baselinePath << std::endl;
+        return 2;
+    }
+
+    std::cout << std::left << std::setw(14) << "Scene" << std::right << std::setw(8) << "Bodies" <<
+                 std::setw(12) << "ms/step" << std::setw(12) << "collision" << std::setw(12) << "islands" <<
+                 std::setw(12) << "solver" << std::setw(12) << "contacts" << std::endl;
+
+    std::vector<BenchmarkResult> results;
+    uint nbRegressions = 0;
+    for (const std::string& scene : options.scenes) {
+        for (uint size : options.sizes) {
+
+            std::unique_ptr<Benchmark> benchmark = createBenchmark(scene, size);
+            if (!benchmark) {
+                std::cerr << "Unknown scene " << scene << std::endl;
+                return 2;
+            }
+
+            const BenchmarkResult result = runBenchmark(*benchmark, options);
+            results.push_back(result);
+
+            std::cout << std::left << std::setw(14) << result.name << std::right << std::setw(8) << result.nbBodies <<
+                         std::fixed << std::setprecision(3) << std::setw(12) << result.msPerStep <<
+                         std::setw(12) << result.collisionDetectionMs << std::setw(12) << result.islandsMs <<
+                         std::setw(12) << result.solverMs << std::setprecision(0) <<
+                         std::setw(12) << result.nbContactPoints;
+
+            // Compare the result with the baseline
+            auto it = baseline.find(getResultKey(result.name, result.nbBodies, result.nbThreads));
+            if (it != baseline.end() && it->second > 0.0) {
+                const double change = result.msPerStep / it->second - 1.0;
+                std::cout << std::setprecision(1) << "   " << std::showpos << change * 100.0 << std::noshowpos << " %";
+                if (change > options.threshold) {
+                    std::cout << " REGRESSION";
+                    nbRegressions++;
+                }
+            }
+            std::cout << std::endl;
+
+            for (const auto& block : result.profile) {
+                std::cout << "    " << std::left << std::setw(60) << block.first << std::right <<
+                             std::setprecision(3) << std::setw(10) << block.second << " ms" << std::endl;
+            }
+        }
+    }
+
+    if (!options.jsonPath.empty() && !writeJson(options.jsonPath, results, options)) {
+        std::cerr << "Cannot write the JSON file " << options.jsonPath << std::endl;
+        return 2;
+    }
+
+    if (nbRegressions > 0) {
+        std::cout << nbRegressions << " regression(s) above " << options.threshold * 100.0 << " %" << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,351 @@
+/********************************************************************************
+* ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
+* Copyright (c) 2010-2018 Daniel Chappuis                                       *
+*********************************************************************************
+*                                                                               *
+* This software is provided 'as-is', without any express or implied warranty.   *
+* In no event will the authors be held liable for any damages arising from the  *
+* use of this software.                                                         *
+*                                                                               *
+* Permission is granted to anyone to use this software for any purpose,         *
+* including commercial applications, and to alter it and redistribute it        *
+* freely, subject to the following restrictions:                                *
+*                                                                               *
+* 1. The origin of this software must not be misrepresented; you must not claim *
+*    that you wrote the original software. If you use this software in a        *
+*    product, an acknowledgment in the product documentation would be           *
+*    appreciated but is not required.                                           *
+*                                                                               *
+* 2. Altered source versions must be plainly marked as such, and must not be    *
+*    misrepresented as being the original software.                             *
+*                                                                               *
+* 3. This notice may not be removed or altered from any source distribution.    *
+*                                                                               *
+********************************************************************************/
+
+
+#ifndef MEMORY_FOOTPRINT_BENCHMARK_H
+#define MEMORY_FOOTPRINT_BENCHMARK_H
+
+// Libraries
+#include "reactphysics3d.h"
+#include <string>
+#include <vector>
+#include <memory>
+#include <cmath>
+
+/// Reactphysics3D namespace
+namespace reactphysics3d {
+
+// Structure MemoryFootprint
+/**
+ * This structure contains the number of bytes allocated by a world for each kind of object
+ * with a given type of collision shape. The numbers are averages over all the objects of the
+ * world and include the growth of the containers of the world (amortized capacity).
+ */
+struct MemoryFootprint {
+
+    /// Name of the type of collision shape
+    std::string shapeName;
+
+    /// Number of bodies with the collision shape
+    uint nbBodies = 0;
+
+    /// Number of nodes of the dynamic AABB tree of the broad-phase
+    uint nbTreeNodes = 0;
+
+    /// Number of overlapping pairs
+    uint nbOverlappingPairs = 0;
+
+    /// Number of contact manifolds
+    uint nbContactManifolds = 0;
+
+    /// Number of bytes of a body without collision shape
+    double bytesPerBody = 0.0;
+
+    /// Number of bytes of a proxy shape (without its nodes of the broad-phase tree)
+    double bytesPerProxyShape = 0.0;
+
+    /// Number of bytes of a node of the broad-phase tree
+    double bytesPerTreeNode = 0.0;
+
+    /// Number of bytes of an overlapping pair without contact
+    double bytesPerOverlappingPair = 0.0;
+
+    /// Number of bytes of a contact manifold (with its contact points)
+    double bytesPerContactManifold = 0.0;
+};
+
+// Class MemoryFootprintBenchmark
+/**
+ * This class measures the memory used by a world for each type of collision shape with the
+ * statistics of the memory tags of the world. A world is created with bodies that all use the
+ * same shape and the memory in use is read after each stage: the creation of the bodies, the
+ * addition of the shapes, a first step where the fat AABBs of the neighbour bodies overlap but
+ * not their shapes (overlapping pairs without contact) and a second step where the shapes
+ * touch (contact manifolds). The concave shapes (triangle mesh and height field) are put on
+ * static bodies and a small dynamic sphere is created above each of them once the static
+ * bodies have been measured. The collision shapes are shared by the bodies, so their own
+ * memory is not part of the footprint.
+ */
+class MemoryFootprintBenchmark {
+
+    private :
+
+        // ---------- Constants ---------- //
+
+        /// Distance between the shapes of two neighbour bodies in the first step (smaller than
+        /// twice the gap of the fat AABBs of the broad-phase)
+        static constexpr decimal SEPARATION = decimal(0.05);
+
+        /// Radius of the spheres dropped onto the concave shapes
+        static constexpr decimal PROBE_RADIUS = decimal(0.25);
+
+        /// Time step of the steps of the world
+        static constexpr decimal TIME_STEP = decimal(1.0) / decimal(60.0);
+
+        // ---------- Attributes ---------- //
+
+        /// Box shape
+        BoxShape mBoxShape;
+
+        /// Sphere shape
+        SphereShape mSphereShape;
+
+        /// Capsule shape
+        CapsuleShape mCapsuleShape;
+
+        /// Vertices of the unit cube of the convex mesh
+        float mConvexMeshVertices[24];
+
+        /// Indices of the vertices of the faces of the unit cube of the convex mesh
+        int mConvexMeshIndices[24];
+
+        /// Faces of the unit cube of the convex mesh
+        PolygonVertexArray::PolygonFace mConvexMeshFaces[6];
+
+        /// Polygon vertex array of the convex mesh
+        std::unique_ptr<PolygonVertexArray> mPolygonVertexArray;
+
+        /// Polyhedron mesh of the convex mesh
+        std::unique_ptr<PolyhedronMesh> mPolyhedronMesh;
+
+        /// Convex mesh shape (created once the polyhedron mesh is filled)
+        std::unique_ptr<ConvexMeshShape> mConvexMeshShape;
+
+        /// Vertices of the unit square of the concave mesh
+        float mConcaveMeshVertices[12];
+
+        /// Indices of the vertices of the two triangles of the concave mesh
+        int mConcaveMeshIndices[6];
+
+        /// Triangle vertex array of the concave mesh
+        std::unique_ptr<TriangleVertexArray> mTriangleVertexArray;
+
+        /// Triangle mesh of the concave mesh
+        TriangleMesh mTriangleMesh;
+
+        /// Concave mesh shape (created once the triangle mesh is filled)
+        std::unique_ptr<ConcaveMeshShape> mConcaveMeshShape;
+
+        /// Heights of the height field (flat)
+        float mHeights[25];
+
+        /// Height field shape with 4x4 cells on a unit square
+        HeightFieldShape mHeightFieldShape;
+
+        /// Sphere shape of the spheres dropped onto the concave shapes
+        SphereShape mProbeShape;
+
+        // ---------- Methods ---------- //
+
+        /// Return the number of bytes in use for all the memory tags of a world
+        static size_t computeNbBytesInUse(const CollisionWorld& world) {
+            size_t nbBytes = 0;
+            for (int tag=0; tag < MemoryManager::NB_MEMORY_TAGS; tag++) {
+                nbBytes += world.getMemoryStatistics(static_cast<MemoryTag>(tag)).nbBytesInUse;
+            }
+            return nbBytes;
+        }
+
+        /// Return the position of a body on a square grid
+        static Vector3 computeGridPosition(uint index, uint nbBodiesPerSide, decimal spacing) {
+            return Vector3(decimal(index % nbBodiesPerSide) * spacing, 0, decimal(index / nbBodiesPerSide) * spacing);
+        }
+
+        /// Fill the vertices, indices and faces of the unit cube of the convex mesh
+        void createConvexMeshCube() {
+
+            for (int v=0; v < 8; v++) {
+                mConvexMeshVertices[3 * v] = (v & 1) ? 0.5f : -0.5f;
+                mConvexMeshVertices[3 * v + 1] = (v & 2) ? 0.5f : -0.5f;
+                mConvexMeshVertices[3 * v + 2] = (v & 4) ? 0.5f : -0.5f;
+            }
+
+            // Counter-clockwise faces seen from outside (-x, +x, -y, +y, -z, +z)
+            const int indices[24] = {0, 4, 6, 2,  1, 3, 7, 5,  0, 1, 5, 4,  2, 6, 7, 3,  0, 2, 3, 1,  4, 5, 7, 6};
+            for (int i=0; i < 24; i++) {
+                mConvexMeshIndices[i] = indices[i];
+            }
+            for (int f=0; f < 6; f++) {
+                mConvexMeshFaces[f].indexBase = 4 * f;
+                mConvexMeshFaces[f].nbVertices = 4;
+            }
+        }
+
+        /// Fill the vertices and indices of the unit square of the concave mesh
+        void createConcaveMeshSquare() {
+
+            const float vertices[12] = {-0.5f, 0, -0.5f,  0.5f, 0, -0.5f,  -0.5f, 0, 0.5f,  0.5f, 0, 0.5f};
+            const int indices[6] = {0, 2, 1,  1, 2, 3};
+            for (int i=0; i < 12; i++) mConcaveMeshVertices[i] = vertices[i];
+            for (int i=0; i < 6; i++) mConcaveMeshIndices[i] = indices[i];
+        }
+
+        /// Return the collision shape with a given name (null if the name is unknown)
+        CollisionShape* getShape(const std::string& shapeName) {
+
+            if (shapeName == "box") return &mBoxShape;
+            if (shapeName == "sphere") return &mSphereShape;
+            if (shapeName == "capsule") return &mCapsuleShape;
+            if (shapeName == "convexmesh") return mConvexMeshShape.get();
+            if (shapeName == "concavemesh") return mConcaveMeshShape.get();
+            if (shapeName == "heightfield") return &mHeightFieldShape;
+            return nullptr;
+        }
+
+    public :
+
+        // ---------- Methods ---------- //
+
+        /// Constructor
+        MemoryFootprintBenchmark()
+            : mBoxShape(Vector3(decimal(0.5), decimal(0.5), decimal(0.5))), mSphereShape(decimal(0.5)),
+              mCapsuleShape(decimal(0.5), decimal(1.0)), mHeights(),
+              mHeightFieldShape(5, 5, decimal(-1.0), decimal(1.0), mHeights,
+                                HeightFieldShape::HeightDataType::HEIGHT_FLOAT_TYPE, 1, decimal(1.0),
+                                Vector3(decimal(0.25), 1, decimal(0.25))),
+              mProbeShape(PROBE_RADIUS) {
+
+            createConvexMeshCube();
+            mPolygonVertexArray.reset(new PolygonVertexArray(8, mConvexMeshVertices, 3 * sizeof(float),
+                                                             mConvexMeshIndices, sizeof(int), 6, mConvexMeshFaces,
+                                                             PolygonVertexArray::VertexDataType::VERTEX_FLOAT_TYPE,
+                                                             PolygonVertexArray::IndexDataType::INDEX_INTEGER_TYPE));
+            mPolyhedronMesh.reset(new PolyhedronMesh(mPolygonVertexArray.get()));
+            mConvexMeshShape.reset(new ConvexMeshShape(mPolyhedronMesh.get()));
+
+            createConcaveMeshSquare();
+            mTriangleVertexArray.reset(new TriangleVertexArray(4, mConcaveMeshVertices, 3 * sizeof(float),
+                                                               2, mConcaveMeshIndices, 3 * sizeof(int),
+                                                               TriangleVertexArray::VertexDataType::VERTEX_FLOAT_TYPE,
+                                                               TriangleVertexArray::IndexDataType::INDEX_INTEGER_TYPE));
+            mTriangleMesh.addSubpart(mTriangleVertexArray.get());
+            mConcaveMeshShape.reset(new ConcaveMeshShape(&mTriangleMesh));
+        }
+
+        /// Deleted copy-constructor
+        MemoryFootprintBenchmark(const MemoryFootprintBenchmark& benchmark) = delete;
+
+        /// Deleted assignment operator
+        MemoryFootprintBenchmark& operator=(const MemoryFootprintBenchmark& benchmark) = delete;
+
+        /// Measure the memory footprint of the objects of a world with a given type of collision shape
+        /// Return false if the name of the shape is unknown.
+        bool run(const std::string& shapeName, uint nbBodies, MemoryFootprint& footprint) {
+
+            CollisionShape* shape = getShape(shapeName);
+            if (shape == nullptr || nbBodies == 0) {
+                return false;
+            }
+
+            footprint = MemoryFootprint();
+            footprint.shapeName = shapeName;
+            footprint.nbBodies = nbBodies;
+
+            const bool isConvex = shape->isConvex();
+            const uint nbBodiesPerSide = static_cast<uint>(std::ceil(std::sqrt(double(nbBodies))));
+
+            // All the shapes are one unit wide. The convex bodies are placed next to each other
+            // and the concave bodies are spaced so that they never overlap.
+            const decimal separatedSpacing = isConvex ? decimal(1.0) + SEPARATION : decimal(2.0);
+            const decimal touchingSpacing = isConvex ? decimal(0.98) : decimal(2.0);
+
+            DynamicsWorld world(Vector3(0, 0, 0));
+            world.enableSleeping(false);
+
+            // Bodies
+            size_t nbBytes = computeNbBytesInUse(world);
+            std::vector<RigidBody*> bodies;
+            bodies.reserve(nbBodies);
+            for (uint i=0; i < nbBodies; i++) {
+                RigidBody* body = world.createRigidBody(Transform(computeGridPosition(i, nbBodiesPerSide, separatedSpacing),
+                                                                  Quaternion::identity()));
+                if (!isConvex) body->setType(BodyType::STATIC);
+                bodies.push_back(body);
+            }
+            footprint.bytesPerBody = double(computeNbBytesInUse(world) - nbBytes) / nbBodies;
+
+            // Proxy shapes and nodes of the broad-phase tree
+            nbBytes = computeNbBytesInUse(world);
+            const size_t nbBroadPhaseBytes = world.getMemoryStatistics(MemoryTag::BroadPhase).nbBytesInUse;
+            for (uint i=0; i < nbBodies; i++) {
+                bodies[i]->addCollisionShape(shape, Transform::identity(), decimal(1.0));
+            }
+            const size_t nbNewBroadPhaseBytes = world.getMemoryStatistics(MemoryTag::BroadPhase).nbBytesInUse - nbBroadPhaseBytes;
+            footprint.nbTreeNodes = 2 * nbBodies - 1;
+            footprint.bytesPerTreeNode = double(nbNewBroadPhaseBytes) / footprint.nbTreeNodes;
+            footprint.bytesPerProxyShape = double(computeNbBytesInUse(world) - nbBytes - nbNewBroadPhaseBytes) / nbBodies;
+
+            // Spheres above the concave shapes (inside the fat AABBs but without contact)
+            std::vector<RigidBody*> probes;
+            if (!isConvex) {
+                for (uint i=0; i < nbBodies; i++) {
+                    const Vector3 position = computeGridPosition(i, nbBodiesPerSide, separatedSpacing) +
+                                             Vector3(0, PROBE_RADIUS + SEPARATION, 0);
+                    RigidBody* probe = world.createRigidBody(Transform(position, Quaternion::identity()));
+                    probe->addCollisionShape(&mProbeShape, Transform::identity(), decimal(1.0));
+                    probes.push_back(probe);
+                }
+            }
+
+            // Overlapping pairs without contact
+            nbBytes = computeNbBytesInUse(world);
+            world.update(TIME_STEP);
+            const uint nbSeparatedPairs = world.getStepStatistics().nbOverlappingPairs;
+            if (nbSeparatedPairs > 0) {
+                footprint.bytesPerOverlappingPair = double(computeNbBytesInUse(world) - nbBytes) / nbSeparatedPairs;
+            }
+
+            // Move the shapes into contact
+            for (uint i=0; i < nbBodies; i++) {
+                const Vector3 position = computeGridPosition(i, nbBodiesPerSide, touchingSpacing);
+                if (isConvex) {
+                    bodies[i]->setTransform(Transform(position, Quaternion::identity()));
+                }
+                else {
+                    probes[i]->setTransform(Transform(position + Vector3(0, PROBE_RADIUS - decimal(0.01), 0),
+                                                      Quaternion::identity()));
+                }
+            }
+
+            // Contact manifolds (the memory of the new overlapping pairs is removed)
+            nbBytes = computeNbBytesInUse(world);
+            world.update(TIME_STEP);
+            const StepStatistics& statistics = world.getStepStatistics();
+            footprint.nbOverlappingPairs = statistics.nbOverlappingPairs;
+            footprint.nbContactManifolds = statistics.nbContactManifolds;
+            if (statistics.nbContactManifolds > 0) {
+                const double nbNewPairs = double(statistics.nbOverlappingPairs) - double(nbSeparatedPairs);
+                footprint.bytesPerContactManifold = (double(computeNbBytesInUse(world)) - double(nbBytes) -
+                                                     nbNewPairs * footprint.bytesPerOverlappingPair) /
+                                                    statistics.nbContactManifolds;
+            }
+
+            return true;
+        }
+};
+
+}
+
+#endif
@@ -0,0 +1,148 @@
+/********************************************************************************
+* ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
+* Copyright (c) 2010-2018 Daniel Chappuis                                       *
+*********************************************************************************
+*                                                                               *
+* This software is provided 'as-is', without any express or implied warranty.   *
+* In no event will the authors be held liable for any damages arising from the  *
+* use of this software.                                                         *
+*                                                                               *
+* Permission is granted to anyone to use this software for any purpose,         *
+* including commercial applications, and to alter it and redistribute it        *
+* freely, subject to the following restrictions:                                *
+*                                                                               *
+* 1. The origin of this software must not be misrepresented; you must not claim *
+*    that you wrote the original software. If you use this software in a        *
+*    product, an acknowledgment in the product documentation would be           *
+*    appreciated but is not required.                                           *
+*                                                                               *
+* 2. Altered source versions must be plainly marked as such, and must not be    *
+*    misrepresented as being the original software.                             *
+*                                                                               *
+* 3. This notice may not be removed or altered from any source distribution.    *
+*                                                                               *
+********************************************************************************/
+
+#ifndef CONTACT_SOLVER_MICRO_BENCHMARKS_H
+#define CONTACT_SOLVER_MICRO_BENCHMARKS_H
+
+// Libraries
+#include "MicroBenchmarkSuite.h"
+#include <memory>
+
+/// Reactphysics3D namespace
+namespace reactphysics3d {
+
+// Class ContactSolverFixture
+/**
+ * This class creates a world where boxes rest side by side on a static floor so that each
+ * box has a single persistent contact manifold with four contact points.
+ */
+class ContactSolverFixture {
+
+    public :
+
+        // ---------- Constants ---------- //
+
+        /// Number of boxes along each side of the floor (and number of manifolds)
+        static const uint NB_BOXES_PER_SIDE = 32;
+
+        /// Number of velocity iterations of a measured step
+        static const uint NB_VELOCITY_ITERATIONS = 21;
+
+        // ---------- Attributes ---------- //
+
+        /// Box shape of the boxes
+        BoxShape boxShape;
+
+        /// Box shape of the floor
+        BoxShape floorShape;
+
+        /// Dynamics world (declared last so that it is destroyed first)
+        DynamicsWorld world;
+
+        // ---------- Methods ---------- //
+
+        /// Constructor
+        ContactSolverFixture(const WorldSettings& settings)
+            : boxShape(Vector3(decimal(0.5), decimal(0.5), decimal(0.5))),
+              floorShape(Vector3(NB_BOXES_PER_SIDE + 1, 1, NB_BOXES_PER_SIDE + 1)),
+              world(Vector3(0, decimal(-9.81), 0), settings) {
+
+            world.enableSleeping(false);
+
+            RigidBody* floor = world.createRigidBody(Transform(Vector3(0, -1, 0), Quaternion::identity()));
+            floor->setType(BodyType::STATIC);
+            floor->addCollisionShape(&floorShape, Transform::identity(), decimal(1.0));
+
+            for (uint i=0; i < NB_BOXES_PER_SIDE; i++) {
+                for (uint j=0; j < NB_BOXES_PER_SIDE; j++) {
+                    const Vector3 position(decimal(2 * i) - decimal(NB_BOXES_PER_SIDE), decimal(0.5),
+                                           decimal(2 * j) - decimal(NB_BOXES_PER_SIDE));
+                    RigidBody* body = world.createRigidBody(Transform(position, Quaternion::identity()));
+                    body->addCollisionShape(&boxShape, Transform::identity(), decimal(1.0));
+                }
+            }
+
+            // Let the contacts become persistent
+            for (uint i=0; i < 60; i++) {
+                world.update(decimal(1.0) / decimal(60.0));
+            }
+        }
+
+        /// Deleted copy-constructor
+        ContactSolverFixture(const ContactSolverFixture& fixture) = delete;
+
+        /// Deleted assignment operator
+        ContactSolverFixture& operator=(const ContactSolverFixture& fixture) = delete;
+
+        /// Return the time (in nanoseconds) of a step with a given number of velocity iterations
+        double measureStep(uint nbVelocityIterations) {
+
+            world.setNbIterationsVelocitySolver(nbVelocityIterations);
+
+            const auto start = std::chrono::steady_clock::now();
+            world.update(decimal(1.0) / decimal(60.0));
+            const auto end = std::chrono::steady_clock::now();
+
+            return std::chrono::duration<double, std::nano>(end - start).count();
+        }
+};
+
+// Add the micro benchmarks of the velocity iterations of the contact solvers
+/// The contact solver can only be run by the world (it needs the islands and the velocity
+/// arrays of the step). Each sample is therefore a step with one velocity iteration and a step
+/// with NB_VELOCITY_ITERATIONS iterations. The difference of their times is the time of the
+/// additional calls of ContactSolver::solve() because the other parts of the steps are the
+/// same. Each operation is the solve of a contact manifold (four contact points) in one
+/// iteration.
+inline void addContactSolverMicroBenchmarks(MicroBenchmarkSuite& suite) {
+
+    auto addSolver = [&suite](const std::string& name, const WorldSettings& settings) {
+
+        std::shared_ptr<ContactSolverFixture> fixture = std::make_shared<ContactSolverFixture>(settings);
+        const uint nbIterations = ContactSolverFixture::NB_VELOCITY_ITERATIONS;
+        const uint nbManifolds = ContactSolverFixture::NB_BOXES_PER_SIDE * ContactSolverFixture::NB_BOXES_PER_SIDE;
+
+        suite.addTimed("ContactSolver::solve() " + name, nbManifolds * (nbIterations - 1), [fixture, nbIterations]() {
+            const double stepTime = fixture->measureStep(1);
+            const double stepTimeWithIterations = fixture->measureStep(nbIterations);
+            return std::max(stepTimeWithIterations - stepTime, 0.0);
+        });
+    };
+
+    WorldSettings scalarSettings;
+    addSolver("scalar", scalarSettings);
+
+    WorldSettings wideSettings;
+    wideSettings.isWideContactSolverEnabled = true;
+    addSolver("wide", wideSettings);
+
+    WorldSettings blockSettings;
+    blockSettings.isBlockContactSolverEnabled = true;
+    addSolver("block", blockSettings);
+}
+
+}
+
+#endif
@@ -0,0 +1,181 @@
+/********************************************************************************
+* ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
+* Copyright (c) 2010-2018 Daniel Chappuis                                       *
+*********************************************************************************
+*                                                                               *
+* This software is provided 'as-is', without any express or implied warranty.   *
+* In no event will the authors be held liable for any damages arising from the  *
+* use of this software.                                                         *
+*                                                                               *
+* Permission is granted to anyone to use this software for any purpose,         *
+* including commercial applications, and to alter it and redistribute it        *
+* freely, subject to the following restrictions:                                *
+*                                                                               *
+* 1. The origin of this software must not be misrepresented; you must not claim *
+*    that you wrote the original software. If you use this software in a        *
+*    product, an acknowledgment in the product documentation would be           *
+*    appreciated but is not required.                                           *
+*                                                                               *
+* 2. Altered source versions must be plainly marked as such, and must not be    *
+*    misrepresented as being the original software.                             *
+*                                                                               *
+* 3. This notice may not be removed or altered from any source distribution.    *
+*                                                                               *
+********************************************************************************/
+
+#ifndef CONTAINERS_MICRO_BENCHMARKS_H
+#define CONTAINERS_MICRO_BENCHMARKS_H
+
+// Libraries
+#include "MicroBenchmarkSuite.h"
+#include "containers/List.h"
+#include "containers/Map.h"
+#include "containers/Set.h"
+#include "memory/MemoryManager.h"
+#include <memory>
+#include <random>
+
+/// Reactphysics3D namespace
+namespace reactphysics3d {
+
+// Class ContainersFixture
+/**
+ * This class contains the keys and the containers of the micro benchmarks of the containers.
+ * The keys are distinct random integers that are inserted in a random order.
+ */
+class ContainersFixture {
+
+    public :
+
+        // ---------- Constants ---------- //
+
+        /// Number of elements of the containers
+        static const uint NB_ELEMENTS = 10000;
+
+        // ---------- Attributes ---------- //
+
+        /// Keys of the elements
+        std::vector<int> keys;
+
+        /// List
+        List<int> list;
+
+        /// Map
+        Map<int, int> map;
+
+        /// Set
+        Set<int> set;
+
+        // ---------- Methods ---------- //
+
+        /// Constructor
+        ContainersFixture()
+            : list(MemoryManager::getBaseAllocator()), map(MemoryManager::getBaseAllocator()),
+              set(MemoryManager::getBaseAllocator()) {
+
+            std::mt19937 generator(1);
+            for (uint i=0; i < NB_ELEMENTS; i++) {
+                keys.push_back(int(i) * 7919);
+            }
+            std::shuffle(keys.begin(), keys.end(), generator);
+        }
+
+        /// Fill the containers with all the keys
+        void fill() {
+
+            list.clear();
+            map.clear();
+            set.clear();
+            for (int key : keys) {
+                list.add(key);
+                map.add(Pair<int, int>(key, key));
+                set.add(key);
+            }
+        }
+
+        /// Deleted copy-constructor
+        ContainersFixture(const ContainersFixture& fixture) = delete;
+
+        /// Deleted assignment operator
+        ContainersFixture& operator=(const ContainersFixture& fixture) = delete;
+};
+
+// Add the micro benchmarks of the List, Map and Set containers
+/// Each operation is the insertion, the search or the removal of an element. The containers
+/// are empty (with no allocated memory) before each insertion sample so that the growth of
+/// the containers is included.
+inline void addContainersMicroBenchmarks(MicroBenchmarkSuite& suite) {
+
+    std::shared_ptr<ContainersFixture> fixture = std::make_shared<ContainersFixture>();
+    const uint nbElements = ContainersFixture::NB_ELEMENTS;
+
+    // List
+    suite.add("List::add", nbElements, [fixture]() {
+        fixture->list = List<int>(MemoryManager::getBaseAllocator());
+    },
+    [fixture]() {
+        for (int key : fixture->keys) {
+            fixture->list.add(key);
+        }
+    });
+    suite.add("List::iterate", nbElements, [fixture]() { fixture->fill(); }, [fixture]() {
+        uint64 sum = 0;
+        for (auto it = fixture->list.begin(); it != fixture->list.end(); ++it) {
+            sum += uint64(*it);
+        }
+        doNotOptimize(sum);
+    });
+    suite.add("List::removeAt (last)", nbElements, [fixture]() { fixture->fill(); }, [fixture]() {
+        while (fixture->list.size() > 0) {
+            fixture->list.removeAt(uint(fixture->list.size() - 1));
+        }
+    });
+
+    // Map
+    suite.add("Map::add", nbElements, [fixture]() {
+        fixture->map = Map<int, int>(MemoryManager::getBaseAllocator());
+    },
+    [fixture]() {
+        for (int key : fixture->keys) {
+            fixture->map.add(Pair<int, int>(key, key));
+        }
+    });
+    suite.add("Map::find", nbElements, [fixture]() { fixture->fill(); }, [fixture]() {
+        uint64 sum = 0;
+        for (int key : fixture->keys) {
+            sum += uint64(fixture->map.find(key)->second);
+        }
+        doNotOptimize(sum);
+    });
+    suite.add("Map::remove", nbElements, [fixture]() { fixture->fill(); }, [fixture]() {
+        for (int key : fixture->keys) {
+            fixture->map.remove(key);
+        }
+    });
+
+    // Set
+    suite.add("Set::add", nbElements, [fixture]() {
+        fixture->set = Set<int>(MemoryManager::getBaseAllocator());
+    },
+    [fixture]() {
+        for (int key : fixture->keys) {
+            fixture->set.add(key);
+        }
+    });
+    suite.add("Set::contains", nbElements, [fixture]() { fixture->fill(); }, [fixture]() {
+        uint64 nbFound = 0;
+        for (int key : fixture->keys) {
+            nbFound += fixture->set.contains(key);
+        }
+        doNotOptimize(nbFound);
+    });
+    suite.add("Set::remove", nbElements, [fixture]() { fixture->fill(); }, [fixture]() {
+        for (int key : fixture->keys) {
+            fixture->set.remove(key);
+        }
+    });
+}
+
+}
+
+#endif
@@ -0,0 +1,212 @@
+/********************************************************************************
+* ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
+* Copyright (c) 2010-2018 Daniel Chappuis                                       *
+*********************************************************************************
+*                                                                               *
+* This software is provided 'as-is', without any express or implied warranty.   *
+* In no event will the authors be held liable for any damages arising from the  *
+* use of this software.                                                         *
+*                                                                               *
+* Permission is granted to anyone to use this software for any purpose,         *
+* including commercial applications, and to alter it and redistribute it        *
+* freely, subject to the following restrictions:                                *
+*                                                                               *
+* 1. The origin of this software must not be misrepresented; you must not claim *
+*    that you wrote the original software. If you use this software in a        *
+*    product, an acknowledgment in the product documentation would be           *
+*    appreciated but is not required.                                           *
+*                                                                               *
+* 2. Altered source versions must be plainly marked as such, and must not be    *
+*    misrepresented as being the original software.                             *
+*                                                                               *
+* 3. This notice may not be removed or altered from any source distribution.    *
+*                                                                               *
+********************************************************************************/
+
+#ifndef DYNAMIC_AABB_TREE_MICRO_BENCHMARKS_H
+#define DYNAMIC_AABB_TREE_MICRO_BENCHMARKS_H
+
+// Libraries
+#include "MicroBenchmarkSuite.h"
+#include "collision/broadphase/DynamicAABBTree.h"
+#include "memory/MemoryManager.h"
+#include "utils/Profiler.h"
+#include <memory>
+#include <random>
+
+/// Reactphysics3D namespace
+namespace reactphysics3d {
+
+// Class TreeCountingCallback
+/**
+ * Overlap and raycast callback of the tree that counts the reported nodes. The rays are
+ * never clipped so that all the leaves hit by a ray are reported.
+ */
+class TreeCountingCallback : public DynamicAABBTreeOverlapCallback, public DynamicAABBTreeRaycastCallback {
+
+    public:
+
+        /// Number of reported nodes
+        uint64 nbNodes = 0;
+
+        /// Called when a node overlaps the AABB of a query
+        virtual void notifyOverlappingNode(int /*nodeId*/) override {
+            nbNodes++;
+        }
+
+        /// Called when the AABB of a node is hit by a ray
+        virtual decimal raycastBroadPhaseShape(int32 /*nodeId*/, const Ray& ray) override {
+            nbNodes++;
+            return ray.maxFraction;
+        }
+};
+
+// Class DynamicAABBTreeFixture
+/**
+ * This class creates random AABBs in a cube for the micro benchmarks of the dynamic AABB tree
+ * with the random displacements, query AABBs and rays of the benchmarks.
+ */
+class DynamicAABBTreeFixture {
+
+    public :
+
+        // ---------- Constants ---------- //
+
+        /// Number of objects in the tree
+        static const uint NB_OBJECTS = 10000;
+
+        /// Number of queries (overlap or raycast) of a sample
+        static const uint NB_QUERIES = 1000;
+
+        // ---------- Attributes ---------- //
+
+#ifdef IS_PROFILING_ACTIVE
+
+        /// Profiler of the trees
+        Profiler profiler;
+
+#endif
+
+        /// AABBs of the objects
+        std::vector<AABB> aabbs;
+
+        /// Displacement of each object at each update
+        std::vector<Vector3> displacements;
+
+        /// Sign of the displacements of the next update
+        decimal displacementSign;
+
+        /// AABBs of the overlap queries
+        std::vector<AABB> queryAABBs;
+
+        /// Rays of the raycast queries
+        std::vector<Ray> rays;
+
+        /// Tree filled with the objects
+        DynamicAABBTree tree;
+
+        /// Node of each object in the filled tree
+        std::vector<int> nodeIds;
+
+        /// Tree used by the insertion benchmark (created before each sample)
+        std::unique_ptr<DynamicAABBTree> insertionTree;
+
+        // ---------- Methods ---------- //
+
+        /// Constructor
+        DynamicAABBTreeFixture()
+            : displacementSign(1), tree(MemoryManager::getBaseAllocator(), DYNAMIC_TREE_AABB_GAP) {
+
+            const float halfWidth = 50.0f;
+            std::mt19937 generator(1);
+            std::uniform_real_distribution<float> coordinate(-halfWidth, halfWidth);
+            std::uniform_real_distribution<float> size(0.5f, 2.0f);
+            std::uniform_real_distribution<float> displacement(-0.2f, 0.2f);
+
+            for (uint i=0; i < NB_OBJECTS; i++) {
+                const Vector3 center(coordinate(generator), coordinate(generator), coordinate(generator));
+                const Vector3 halfSize(size(generator), size(generator), size(generator));
+                aabbs.push_back(AABB(center - halfSize, center + halfSize));
+                displacements.push_back(Vector3(displacement(generator), displacement(generator),
+                                                displacement(generator)));
+            }
+
+            for (uint i=0; i < NB_QUERIES; i++) {
+                const Vector3 center(coordinate(generator), coordinate(generator), coordinate(generator));
+                queryAABBs.push_back(AABB(center - Vector3(2, 2, 2), center + Vector3(2, 2, 2)));
+                rays.push_back(Ray(Vector3(-halfWidth, coordinate(generator), coordinate(generator)),
+                                   Vector3(halfWidth, coordinate(generator), coordinate(generator))));
+            }
+
+#ifdef IS_PROFILING_ACTIVE
+            tree.setProfiler(&profiler);
+#endif
+
+            for (uint i=0; i < NB_OBJECTS; i++) {
+                nodeIds.push_back(tree.addObject(aabbs[i], int32(i), 0));
+            }
+        }
+
+        /// Deleted copy-constructor
+        DynamicAABBTreeFixture(const DynamicAABBTreeFixture& fixture) = delete;
+
+        /// Deleted assignment operator
+        DynamicAABBTreeFixture& operator=(const DynamicAABBTreeFixture& fixture) = delete;
+};
+
+// Add the micro benchmarks of the dynamic AABB tree
+/// Each operation is the insertion or the update of an object or a query. The objects are
+/// moved back and forth by random displacements that are sometimes larger than the gap of
+/// their fat AABB (like the bodies of a simulation).
+inline void addDynamicAABBTreeMicroBenchmarks(MicroBenchmarkSuite& suite) {
+
+    std::shared_ptr<DynamicAABBTreeFixture> fixture = std::make_shared<DynamicAABBTreeFixture>();
+
+    suite.add("DynamicAABBTree::addObject", DynamicAABBTreeFixture::NB_OBJECTS, [fixture]() {
+        fixture->insertionTree.reset(new DynamicAABBTree(MemoryManager::getBaseAllocator(), DYNAMIC_TREE_AABB_GAP));
+#ifdef IS_PROFILING_ACTIVE
+        fixture->insertionTree->setProfiler(&fixture->profiler);
+#endif
+    },
+    [fixture]() {
+        for (uint i=0; i < fixture->aabbs.size(); i++) {
+            fixture->insertionTree->addObject(fixture->aabbs[i], int32(i), 0);
+        }
+    });
+
+    suite.add("DynamicAABBTree::updateObject", DynamicAABBTreeFixture::NB_OBJECTS, [fixture]() {
+        fixture->displacementSign = -fixture->displacementSign;
+    },
+    [fixture]() {
+        uint64 nbReinsertions = 0;
+        for (uint i=0; i < fixture->aabbs.size(); i++) {
+            const Vector3 displacement = fixture->displacementSign * fixture->displacements[i];
+            AABB& aabb = fixture->aabbs[i];
+            aabb.setMin(aabb.getMin() + displacement);
+            aabb.setMax(aabb.getMax() + displacement);
+            nbReinsertions += fixture->tree.updateObject(fixture->nodeIds[i], aabb, displacement);
+        }
+        doNotOptimize(nbReinsertions);
+    });
+
+    suite.add("DynamicAABBTree::reportAllShapesOverlappingWithAABB", DynamicAABBTreeFixture::NB_QUERIES,
+              nullptr, [fixture]() {
+        TreeCountingCallback callback;
+        for (const AABB& aabb : fixture->queryAABBs) {
+            fixture->tree.reportAllShapesOverlappingWithAABB(aabb, callback);
+        }
+        doNotOptimize(callback.nbNodes);
+    });
+
+    suite.add("DynamicAABBTree::raycast", DynamicAABBTreeFixture::NB_QUERIES, nullptr, [fixture]() {
+        TreeCountingCallback callback;
+        for (const Ray& ray : fixture->rays) {
+            fixture->tree.raycast(ray, callback);
+        }
+        doNotOptimize(callback.nbNodes);
+    });
+}
+
+}
+
+#endif
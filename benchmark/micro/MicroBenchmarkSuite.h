@@ -0,0 +1,215 @@
+/********************************************************************************
+* ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
+* Copyright (c) 2010-2018 Daniel Chappuis                                       *
+*********************************************************************************
+*                                                                               *
+* This software is provided 'as-is', without any express or implied warranty.   *
+* In no event will the authors be held liable for any damages arising from the  *
+* use of this software.                                                         *
+*                                                                               *
+* Permission is granted to anyone to use this software for any purpose,         *
+* including commercial applications, and to alter it and redistribute it        *
+* freely, subject to the following restrictions:                                *
+*                                                                               *
+* 1. The origin of this software must not be misrepresented; you must not claim *
+*    that you wrote the original software. If you use this software in a        *
+*    product, an acknowledgment in the product documentation would be           *
+*    appreciated but is not required.                                           *
+*                                                                               *
+* 2. Altered source versions must be plainly marked as such, and must not be    *
+*    misrepresented as being the original software.                             *
+*                                                                               *
+* 3. This notice may not be removed or altered from any source distribution.    *
+*                                                                               *
+********************************************************************************/
+
+#ifndef MICRO_BENCHMARK_SUITE_H
+#define MICRO_BENCHMARK_SUITE_H
+
+// Libraries
+#include "reactphysics3d.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+/// Reactphysics3D namespace
+namespace reactphysics3d {
+
+// Structure MicroBenchmarkStatistics
+/**
+ * Statistics of the samples of a micro benchmark. The times are in nanoseconds per operation.
+ */
+struct MicroBenchmarkStatistics {
+
+    /// Name of the micro benchmark
+    std::string name;
+
+    /// Number of operations of each sample
+    uint nbOperations = 0;
+
+    /// Number of measured samples
+    uint nbSamples = 0;
+
+    /// Median time of an operation
+    double median = 0.0;
+
+    /// Average time of an operation
+    double mean = 0.0;
+
+    /// Standard deviation of the time of an operation
+    double standardDeviation = 0.0;
+
+    /// Minimum time of an operation
+    double min = 0.0;
+
+    /// Maximum time of an operation
+    double max = 0.0;
+};
+
+// Class MicroBenchmarkSuite
+/**
+ * This class runs a list of micro benchmarks. Each micro benchmark is a function that runs
+ * a sample of a given number of operations of a single kernel (a narrow-phase algorithm, an
+ * operation of a tree or of a container, ...). The samples are first run a few times to warm
+ * up the caches and the branch predictors and the time of the following samples is reported
+ * with its median, mean, standard deviation, minimum and maximum.
+ */
+class MicroBenchmarkSuite {
+
+    public :
+
+        // ---------- Types ---------- //
+
+        /// Function that runs a sample and returns its time (in nanoseconds)
+        using SampleFunction = std::function<double()>;
+
+    private :
+
+        // ---------- Types ---------- //
+
+        /// A micro benchmark of the suite
+        struct Entry {
+
+            /// Name of the micro benchmark
+            std::string name;
+
+            /// Number of operations of each sample
+            uint nbOperations;
+
+            /// Function that runs a sample
+            SampleFunction sample;
+        };
+
+        // ---------- Attributes ---------- //
+
+        /// Micro benchmarks of the suite
+        std::vector<Entry> mEntries;
+
+    public :
+
+        // ---------- Methods ---------- //
+
+        /// Add a micro benchmark that measures its own samples
+        void addTimed(const std::string& name, uint nbOperations, const SampleFunction& sample) {
+            mEntries.push_back(Entry{name, nbOperations, sample});
+        }
+
+        /// Add a micro benchmark. The prepare function is called before each sample and is not
+        /// measured (it can be empty).
+        void add(const std::string& name, uint nbOperations, const std::function<void()>& prepare,
+                 const std::function<void()>& run) {
+
+            addTimed(name, nbOperations, [prepare, run]() {
+
+                if (prepare) prepare();
+
+                const auto start = std::chrono::steady_clock::now();
+                run();
+                const auto end = std::chrono::steady_clock::now();
+
+                return std::chrono::duration<double, std::nano>(end - start).count();
+            });
+        }
+
+        /// Run the micro benchmarks whose name contains a filter and print their statistics
+        std::vector<MicroBenchmarkStatistics> run(const std::string& filter, uint nbWarmupSamples,
+                                                  uint nbSamples, std::ostream& output) const {
+
+            std::vector<MicroBenchmarkStatistics> results;
+
+            output << std::left << std::setw(52) << "Micro benchmark (ns/op)" << std::right <<
+                      std::setw(12) << "median" << std::setw(12) << "mean" << std::setw(10) << "stddev" <<
+                      std::setw(12) << "min" << std::setw(12) << "max" << std::endl;
+
+            for (const Entry& entry : mEntries) {
+
+                if (entry.name.find(filter) == std::string::npos) continue;
+
+                for (uint i=0; i < nbWarmupSamples; i++) {
+                    entry.sample();
+                }
+
+                std::vector<double> times;
+                times.reserve(nbSamples);
+                for (uint i=0; i < nbSamples; i++) {
+                    times.push_back(entry.sample() / std::max(entry.nbOperations, 1u));
+                }
+
+                const MicroBenchmarkStatistics statistics = computeStatistics(entry.name, entry.nbOperations, times);
+                results.push_back(statistics);
+
+                output << std::left << std::setw(52) << statistics.name << std::right << std::fixed <<
+                          std::setprecision(2) << std::setw(12) << statistics.median << std::setw(12) <<
+                          statistics.mean << std::setw(9) <<
+                          (statistics.mean > 0.0 ? 100.0 * statistics.standardDeviation / statistics.mean : 0.0) <<
+                          "%" << std::setw(12) << statistics.min << std::setw(12) << statistics.max << std::endl;
+            }
+
+            return results;
+        }
+
+        /// Compute the statistics of the times of the samples
+        static MicroBenchmarkStatistics computeStatistics(const std::string& name, uint nbOperations,
+                                                          std::vector<double> times) {
+
+            MicroBenchmarkStatistics statistics;
+            statistics.name = name;
+            statistics.nbOperations = nbOperations;
+            statistics.nbSamples = uint(times.size());
+            if (times.empty()) return statistics;
+
+            std::sort(times.begin(), times.end());
+            statistics.median = times[times.size() / 2];
+            statistics.min = times.front();
+            statistics.max = times.back();
+
+            for (double time : times) {
+                statistics.mean += time;
+            }
+            statistics.mean /= times.size();
+
+            for (double time : times) {
+                statistics.standardDeviation += (time - statistics.mean) * (time - statistics.mean);
+            }
+            statistics.standardDeviation = std::sqrt(statistics.standardDeviation / times.size());
+
+            return statistics;
+        }
+};
+
+// Variable written by doNotOptimize() (defined in main.cpp)
+extern volatile uint64 doNotOptimizeSink;
+
+// Prevent the compiler from removing the computation of a value
+inline void doNotOptimize(uint64 value) {
+    doNotOptimizeSink = value;
+}
+
+}
+
+#endif
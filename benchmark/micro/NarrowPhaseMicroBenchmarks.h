@@ -0,0 +1,212 @@
+/********************************************************************************
+* ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
+* Copyright (c) 2010-2018 Daniel Chappuis                                       *
+*********************************************************************************
+*                                                                               *
+* This software is provided 'as-is', without any express or implied warranty.   *
+* In no event will the authors be held liable for any damages arising from the  *
+* use of this software.                                                         *
+*                                                                               *
+* Permission is granted to anyone to use this software for any purpose,         *
+* including commercial applications, and to alter it and redistribute it        *
+* freely, subject to the following restrictions:                                *
+*                                                                               *
+* 1. The origin of this software must not be misrepresented; you must not claim *
+*    that you wrote the original software. If you use this software in a        *
+*    product, an acknowledgment in the product documentation would be           *
+*    appreciated but is not required.                                           *
+*                                                                               *
+* 2. Altered source versions must be plainly marked as such, and must not be    *
+*    misrepresented as being the original software.                             *
+*                                                                               *
+* 3. This notice may not be removed or altered from any source distribution.    *
+*                                                                               *
+********************************************************************************/
+
+#ifndef NARROW_PHASE_MICRO_BENCHMARKS_H
+#define NARROW_PHASE_MICRO_BENCHMARKS_H
+
+// Libraries
+#include "MicroBenchmarkSuite.h"
+#include "engine/OverlappingPair.h"
+#include "collision/NarrowPhaseInfo.h"
+#include "collision/narrowphase/GJK/GJKAlgorithm.h"
+#include "collision/narrowphase/SAT/SATAlgorithm.h"
+#include "memory/MemoryManager.h"
+#include <memory>
+#include <random>
+
+/// Reactphysics3D namespace
+namespace reactphysics3d {
+
+// Class NarrowPhaseFixture
+/**
+ * This class creates pairs of shapes with random transforms for the micro benchmarks of the
+ * GJK and SAT algorithms. The second shape of each pair is at a random distance of the first
+ * one so that some pairs are separated, some overlap in the margin and some interpenetrate.
+ */
+class NarrowPhaseFixture {
+
+    public :
+
+        // ---------- Constants ---------- //
+
+        /// Number of pairs of each type of shapes
+        static const uint NB_PAIRS = 256;
+
+        // ---------- Attributes ---------- //
+
+        /// Box shape
+        BoxShape boxShape;
+
+        /// Sphere shape
+        SphereShape sphereShape;
+
+        /// Capsule shape
+        CapsuleShape capsuleShape;
+
+        /// Settings of the overlapping pairs
+        WorldSettings settings;
+
+        /// Collision world of the bodies of the pairs
+        CollisionWorld world;
+
+        /// GJK algorithm
+        GJKAlgorithm gjkAlgorithm;
+
+        /// SAT algorithm
+        SATAlgorithm satAlgorithm;
+
+        /// Overlapping pairs
+        std::vector<OverlappingPair*> pairs;
+
+        /// Narrow-phase infos of the sphere vs box pairs
+        std::vector<NarrowPhaseInfo*> sphereVsBoxInfos;
+
+        /// Narrow-phase infos of the capsule vs box pairs
+        std::vector<NarrowPhaseInfo*> capsuleVsBoxInfos;
+
+        /// Narrow-phase infos of the box vs box pairs
+        std::vector<NarrowPhaseInfo*> boxVsBoxInfos;
+
+        // ---------- Methods ---------- //
+
+        /// Constructor
+        NarrowPhaseFixture()
+            : boxShape(Vector3(decimal(0.5), decimal(0.5), decimal(0.5))), sphereShape(decimal(0.5)),
+              capsuleShape(decimal(0.4), decimal(0.8)), satAlgorithm(MemoryManager::getBaseAllocator()) {
+
+#ifdef IS_PROFILING_ACTIVE
+            gjkAlgorithm.setProfiler(world.getProfiler());
+            satAlgorithm.setProfiler(world.getProfiler());
+#endif
+
+            std::mt19937 generator(1);
+            createPairs(sphereShape, boxShape, generator, sphereVsBoxInfos);
+            createPairs(capsuleShape, boxShape, generator, capsuleVsBoxInfos);
+            createPairs(boxShape, boxShape, generator, boxVsBoxInfos);
+        }
+
+        /// Destructor
+        ~NarrowPhaseFixture() {
+
+            for (std::vector<NarrowPhaseInfo*>* infos : {&sphereVsBoxInfos, &capsuleVsBoxInfos, &boxVsBoxInfos}) {
+                for (NarrowPhaseInfo* info : *infos) {
+                    info->resetContactPoints();
+                    delete info;
+                }
+            }
+            for (OverlappingPair* pair : pairs) {
+                delete pair;
+            }
+        }
+
+        /// Deleted copy-constructor
+        NarrowPhaseFixture(const NarrowPhaseFixture& fixture) = delete;
+
+        /// Deleted assignment operator
+        NarrowPhaseFixture& operator=(const NarrowPhaseFixture& fixture) = delete;
+
+        /// Create the pairs of two shapes with random transforms
+        void createPairs(CollisionShape& shape1, CollisionShape& shape2, std::mt19937& generator,
+                         std::vector<NarrowPhaseInfo*>& infos) {
+
+            MemoryAllocator& allocator = MemoryManager::getBaseAllocator();
+            std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+            std::uniform_real_distribution<float> distance(0.6f, 1.8f);
+            std::uniform_real_distribution<float> angle(0.0f, 3.14159265f);
+
+            for (uint i=0; i < NB_PAIRS; i++) {
+
+                Vector3 direction(unit(generator), unit(generator), unit(generator));
+                if (direction.lengthSquare() < decimal(0.01)) direction = Vector3(1, 0, 0);
+                direction.normalize();
+
+                const Transform transform1(Vector3::zero(), Quaternion::fromEulerAngles(angle(generator),
+                                           angle(generator), angle(generator)));
+                const Transform transform2(direction * distance(generator), Quaternion::fromEulerAngles(angle(generator),
+                                           angle(generator), angle(generator)));
+
+                CollisionBody* body1 = world.createCollisionBody(transform1);
+                CollisionBody* body2 = world.createCollisionBody(transform2);
+                ProxyShape* proxyShape1 = body1->addCollisionShape(&shape1, Transform::identity());
+                ProxyShape* proxyShape2 = body2->addCollisionShape(&shape2, Transform::identity());
+
+                OverlappingPair* pair = new OverlappingPair(proxyShape1, proxyShape2, allocator, allocator, settings);
+                pairs.push_back(pair);
+                infos.push_back(new NarrowPhaseInfo(pair, &shape1, &shape2, transform1, transform2, allocator));
+            }
+        }
+};
+
+// Add the micro benchmarks of the GJK and SAT algorithms
+/// Each operation is the test of a pair with the computation of its contact points (that are
+/// released after the test). The GJK algorithm is only measured with the pairs where it is
+/// used by the engine (a shape with a margin against a polyhedron). The SAT algorithm of two polyhedra uses the separating axis of the
+/// previous test of the pair as in consecutive frames of a simulation.
+inline void addNarrowPhaseMicroBenchmarks(MicroBenchmarkSuite& suite) {
+
+    std::shared_ptr<NarrowPhaseFixture> fixture = std::make_shared<NarrowPhaseFixture>();
+
+    auto addGJK = [&suite, fixture](const std::string& name, std::vector<NarrowPhaseInfo*>* infos) {
+        suite.add("GJKAlgorithm::testCollision " + name, NarrowPhaseFixture::NB_PAIRS, nullptr, [fixture, infos]() {
+            uint64 nbColliding = 0;
+            for (NarrowPhaseInfo* info : *infos) {
+                nbColliding += fixture->gjkAlgorithm.testCollision(info, true) != GJKAlgorithm::GJKResult::SEPARATED;
+                info->resetContactPoints();
+            }
+            doNotOptimize(nbColliding);
+        });
+    };
+    addGJK("sphere/box", &fixture->sphereVsBoxInfos);
+    addGJK("capsule/box", &fixture->capsuleVsBoxInfos);
+
+    suite.add("SATAlgorithm sphere/box", NarrowPhaseFixture::NB_PAIRS, nullptr, [fixture]() {
+        uint64 nbColliding = 0;
+        for (NarrowPhaseInfo* info : fixture->sphereVsBoxInfos) {
+            nbColliding += fixture->satAlgorithm.testCollisionSphereVsConvexPolyhedron(info, true);
+            info->resetContactPoints();
+        }
+        doNotOptimize(nbColliding);
+    });
+    suite.add("SATAlgorithm capsule/box", NarrowPhaseFixture::NB_PAIRS, nullptr, [fixture]() {
+        uint64 nbColliding = 0;
+        for (NarrowPhaseInfo* info : fixture->capsuleVsBoxInfos) {
+            nbColliding += fixture->satAlgorithm.testCollisionCapsuleVsConvexPolyhedron(info, true);
+            info->resetContactPoints();
+        }
+        doNotOptimize(nbColliding);
+    });
+    suite.add("SATAlgorithm box/box", NarrowPhaseFixture::NB_PAIRS, nullptr, [fixture]() {
+        uint64 nbColliding = 0;
+        for (NarrowPhaseInfo* info : fixture->boxVsBoxInfos) {
+            nbColliding += fixture->satAlgorithm.testCollisionConvexPolyhedronVsConvexPolyhedron(info, true);
+            info->resetContactPoints();
+        }
+        doNotOptimize(nbColliding);
+    });
+}
+
+}
+
+#endif
@@ -0,0 +1,143 @@
+/********************************************************************************
+* ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
+* Copyright (c) 2010-2018 Daniel Chappuis                                       *
+*********************************************************************************
+*                                                                               *
+* This software is provided 'as-is', without any express or implied warranty.   *
+* In no event will the authors be held liable for any damages arising from the  *
+* use of this software.                                                         *
+*                                                                               *
+* Permission is granted to anyone to use this software for any purpose,         *
+* including commercial applications, and to alter it and redistribute it        *
+* freely, subject to the following restrictions:                                *
+*                                                                               *
+* 1. The origin of this software must not be misrepresented; you must not claim *
+*    that you wrote the original software. If you use this software in a        *
+*    product, an acknowledgment in the product documentation would be           *
+*    appreciated but is not required.                                           *
+*                                                                               *
+* 2. Altered source versions must be plainly marked as such, and must not be    *
+*    misrepresented as being the original software.                             *
+*                                                                               *
+* 3. This notice may not be removed or altered from any source distribution.    *
+*                                                                               *
+********************************************************************************/
+
+// Libraries
+#include "MicroBenchmarkSuite.h"
+#include "NarrowPhaseMicroBenchmarks.h"
+#include "DynamicAABBTreeMicroBenchmarks.h"
+#include "ContactSolverMicroBenchmarks.h"
+#include "ContainersMicroBenchmarks.h"
+#include <fstream>
+#include <cstdlib>
+
+using namespace reactphysics3d;
+
+// Variable written by doNotOptimize()
+volatile uint64 reactphysics3d::doNotOptimizeSink = 0;
+
+// Micro benchmarks of the kernels of the library
+/// Each micro benchmark measures a single kernel (narrow-phase algorithm, operation of the
+/// dynamic AABB tree, contact solver or container) without the rest of the pipeline so that
+/// a change to a kernel can be measured without the noise of a complete step.
+
+namespace {
+
+// Options of the command line
+struct Options {
+
+    /// Only the micro benchmarks whose name contains this filter are run
+    std::string filter;
+
+    /// Number of samples run before the measure
+    uint nbWarmupSamples = 5;
+
+    /// Number of measured samples
+    uint nbSamples = 30;
+
+    /// Path of the JSON file of the results (empty for no file)
+    std::string jsonPath;
+};
+
+// Write the statistics into a JSON file
+bool writeJson(const std::string& path, const std::vector<MicroBenchmarkStatistics>& results) {
+
+    std::ofstream file(path);
+    if (!file) {
+        return false;
+    }
+
+    file << std::setprecision(6) << "{\"results\":[" << std::endl;
+    for (uint i=0; i < results.size(); i++) {
+        const MicroBenchmarkStatistics& result = results[i];
+        file << "{\"name\":\"" << result.name << "\",\"operations\":" << result.nbOperations <<
+                ",\"samples\":" << result.nbSamples << ",\"medianNs\":" << result.median <<
+                ",\"meanNs\":" << result.mean << ",\"stddevNs\":" << result.standardDeviation <<
+                ",\"minNs\":" << result.min << ",\"maxNs\":" << result.max << "}" <<
+                (i + 1 < results.size() ? "," : "") << std::endl;
+    }
+    file << "]}" << std::endl;
+
+    return true;
+}
+
+// Parse the options of the command line
+bool parseOptions(int argc, char** argv, Options& options) {
+
+    for (int i=1; i < argc; i++) {
+
+        const std::string argument = argv[i];
+        const bool hasValue = i + 1 < argc;
+
+        if (argument == "--filter" && hasValue) {
+            options.filter = argv[++i];
+        }
+        else if (argument == "--warmup" && hasValue) {
+            options.nbWarmupSamples = uint(std::strtoul(argv[++i], nullptr, 10));
+        }
+        else if (argument == "--samples" && hasValue) {
+            options.nbSamples = uint(std::strtoul(argv[++i], nullptr, 10));
+        }
+        else if (argument == "--json" && hasValue) {
+            options.jsonPath = argv[++i];
+        }
+        else {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+}
+
+// Main function
+int main(int argc, char** argv) {
+
+    Options options;
+    if (!parseOptions(argc, argv, options)) {
+        std::cout << "Usage: microbenchmarks [options]" << std::endl <<
+                     "  --filter text   Only run the micro benchmarks whose name contains the text" << std::endl <<
+                     "  --warmup n      Number of samples before the measure (default: 5)" << std::endl <<
+                     "  --samples n     Number of measured samples (default: 30)" << std::endl <<
+                     "  --json file     Write the statistics into a JSON file" << std::endl;
+        return 2;
+    }
+
+    MicroBenchmarkSuite suite;
+    addNarrowPhaseMicroBenchmarks(suite);
+    addDynamicAABBTreeMicroBenchmarks(suite);
+    addContactSolverMicroBenchmarks(suite);
+    addContainersMicroBenchmarks(suite);
+
+    const std::vector<MicroBenchmarkStatistics> results = suite.run(options.filter, options.nbWarmupSamples,
+                                                                    options.nbSamples, std::cout);
+
+    if (!options.jsonPath.empty() && !writeJson(options.jsonPath, results)) {
+        std::cerr << "Cannot write the JSON file " << options.jsonPath << std::endl;
+        return 2;
+    }
+
+    return 0;
+}
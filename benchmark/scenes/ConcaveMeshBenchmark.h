@@ -0,0 +1,149 @@
+/********************************************************************************
+* ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
+* Copyright (c) 2010-2018 Daniel Chappuis                                       *
+*********************************************************************************
+*                                                                               *
+* This software is provided 'as-is', without any express or implied warranty.   *
+* In no event will the authors be held liable for any damages arising from the  *
+* use of this software.                                                         *
+*                                                                               *
+* Permission is granted to anyone to use this software for any purpose,         *
+* including commercial applications, and to alter it and redistribute it        *
+* freely, subject to the following restrictions:                                *
+*                                                                               *
+* 1. The origin of this software must not be misrepresented; you must not claim *
+*    that you wrote the original software. If you use this software in a        *
+*    product, an acknowledgment in the product documentation would be           *
+*    appreciated but is not required.                                           *
+*                                                                               *
+* 2. Altered source versions must be plainly marked as such, and must not be    *
+*    misrepresented as being the original software.                             *
+*                                                                               *
+* 3. This notice may not be removed or altered from any source distribution.    *
+*                                                                               *
+********************************************************************************/
+
+#ifndef CONCAVE_MESH_BENCHMARK_H
+#define CONCAVE_MESH_BENCHMARK_H
+
+// Libraries
+#include "FallingBodiesBenchmark.h"
+#include <vector>
+#include <memory>
+
+/// Reactphysics3D namespace
+namespace reactphysics3d {
+
+// Class ConcaveMeshBenchmark
+/**
+ * This class represents a scene where the bodies are dropped onto a bumpy triangle mesh
+ * that covers the area of the bodies.
+ */
+class ConcaveMeshBenchmark : public FallingBodiesBenchmark {
+
+    private :
+
+        // ---------- Constants ---------- //
+
+        /// Number of vertices of the mesh along each side
+        static const int NB_VERTICES_PER_SIDE = 101;
+
+        // ---------- Attributes ---------- //
+
+        /// Vertices of the mesh
+        std::vector<float> mVertices;
+
+        /// Indices of the vertices of the triangles of the mesh
+        std::vector<int> mIndices;
+
+        /// Vertex array of the triangles of the mesh
+        TriangleVertexArray mTriangleVertexArray;
+
+        /// Triangle mesh
+        TriangleMesh mTriangleMesh;
+
+        /// Shape of the mesh (created once the triangle mesh is filled)
+        std::unique_ptr<ConcaveMeshShape> mConcaveMeshShape;
+
+        /// Dynamics world (declared last so that it is destroyed first)
+        DynamicsWorld mWorld;
+
+        // ---------- Methods ---------- //
+
+        /// Compute the vertices of the mesh so that it covers a square area
+        static std::vector<float> computeVertices(decimal halfWidth) {
+
+            std::vector<float> vertices(3 * NB_VERTICES_PER_SIDE * NB_VERTICES_PER_SIDE);
+            const float cellSize = float(2.0 * halfWidth / (NB_VERTICES_PER_SIDE - 1));
+            for (int i=0; i < NB_VERTICES_PER_SIDE; i++) {
+                for (int j=0; j < NB_VERTICES_PER_SIDE; j++) {
+                    float* vertex = vertices.data() + 3 * (i * NB_VERTICES_PER_SIDE + j);
+                    vertex[0] = float(i) * cellSize - float(halfWidth);
+                    vertex[1] = float(std::sin(0.3 * i) + std::cos(0.3 * j));
+                    vertex[2] = float(j) * cellSize - float(halfWidth);
+                }
+            }
+
+            return vertices;
+        }
+
+        /// Compute the indices of the vertices of the two triangles of each cell of the mesh
+        static std::vector<int> computeIndices() {
+
+            std::vector<int> indices;
+            indices.reserve(6 * (NB_VERTICES_PER_SIDE - 1) * (NB_VERTICES_PER_SIDE - 1));
+            for (int i=0; i < NB_VERTICES_PER_SIDE - 1; i++) {
+                for (int j=0; j < NB_VERTICES_PER_SIDE - 1; j++) {
+                    const int vertex = i * NB_VERTICES_PER_SIDE + j;
+                    indices.push_back(vertex);
+                    indices.push_back(vertex + 1);
+                    indices.push_back(vertex + NB_VERTICES_PER_SIDE);
+                    indices.push_back(vertex + 1);
+                    indices.push_back(vertex + NB_VERTICES_PER_SIDE + 1);
+                    indices.push_back(vertex + NB_VERTICES_PER_SIDE);
+                }
+            }
+
+            return indices;
+        }
+
+    public :
+
+        // ---------- Methods ---------- //
+
+        /// Constructor
+        ConcaveMeshBenchmark(uint nbBodies, const WorldSettings& worldSettings = WorldSettings())
+            : FallingBodiesBenchmark("concavemesh", nbBodies),
+              mVertices(computeVertices(getHalfWidth() + SPACING)), mIndices(computeIndices()),
+              mTriangleVertexArray(NB_VERTICES_PER_SIDE * NB_VERTICES_PER_SIDE, mVertices.data(), 3 * sizeof(float),
+                                   uint(mIndices.size() / 3), mIndices.data(), 3 * sizeof(int),
+                                   TriangleVertexArray::VertexDataType::VERTEX_FLOAT_TYPE,
+                                   TriangleVertexArray::IndexDataType::INDEX_INTEGER_TYPE),
+              mWorld(Vector3(0, decimal(-9.81), 0), worldSettings) {
+
+            mWorld.enableSleeping(false);
+
+            mTriangleMesh.addSubpart(&mTriangleVertexArray);
+            mConcaveMeshShape.reset(new ConcaveMeshShape(&mTriangleMesh));
+
+            RigidBody* ground = mWorld.createRigidBody(Transform::identity());
+            ground->setType(BodyType::STATIC);
+            ground->addCollisionShape(mConcaveMeshShape.get(), Transform::identity(), decimal(1.0));
+
+            createBodies(mWorld, decimal(3.0));
+        }
+
+        /// Advance the scene by one frame
+        virtual void step() override {
+            mWorld.update(mTimeStep);
+        }
+
+        /// Return the dynamics world of the scene
+        virtual DynamicsWorld* getDynamicsWorld() override {
+            return &mWorld;
+        }
+};
+
+}
+
+#endif
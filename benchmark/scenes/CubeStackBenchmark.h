@@ -0,0 +1,125 @@
+/********************************************************************************
+* ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
+* Copyright (c) 2010-2018 Daniel Chappuis                                       *
+*********************************************************************************
+*                                                                               *
+* This software is provided 'as-is', without any express or implied warranty.   *
+* In no event will the authors be held liable for any damages arising from the  *
+* use of this software.                                                         *
+*                                                                               *
+* Permission is granted to anyone to use this software for any purpose,         *
+* including commercial applications, and to alter it and redistribute it        *
+* freely, subject to the following restrictions:                                *
+*                                                                               *
+* 1. The origin of this software must not be misrepresented; you must not claim *
+*    that you wrote the original software. If you use this software in a        *
+*    product, an acknowledgment in the product documentation would be           *
+*    appreciated but is not required.                                           *
+*                                                                               *
+* 2. Altered source versions must be plainly marked as such, and must not be    *
+*    misrepresented as being the original software.                             *
+*                                                                               *
+* 3. This notice may not be removed or altered from any source distribution.    *
+*                                                                               *
+********************************************************************************/
+
+#ifndef CUBE_STACK_BENCHMARK_H
+#define CUBE_STACK_BENCHMARK_H
+
+// Libraries
+#include "Benchmark.h"
+#include <cmath>
+
+/// Reactphysics3D namespace
+namespace reactphysics3d {
+
+// Class CubeStackBenchmark
+/**
+ * This class represents a scene with columns of boxes resting on a static floor. Each box is
+ * in contact with the boxes above and below it so that the steps are dominated by the
+ * persistent contacts and the contact solver.
+ */
+class CubeStackBenchmark : public Benchmark {
+
+    private :
+
+        // ---------- Constants ---------- //
+
+        /// Number of boxes of each column
+        static const uint NB_BOXES_PER_COLUMN = 10;
+
+        /// Distance between the centers of two neighbour columns
+        static constexpr decimal SPACING = decimal(1.5);
+
+        // ---------- Attributes ---------- //
+
+        /// Box shape of the boxes
+        BoxShape mBoxShape;
+
+        /// Box shape of the floor
+        BoxShape mFloorShape;
+
+        /// Dynamics world (declared last so that it is destroyed first)
+        DynamicsWorld mWorld;
+
+        // ---------- Methods ---------- //
+
+        /// Return the number of columns along each side of the floor
+        static uint computeNbColumnsPerSide(uint nbBodies) {
+            const uint nbColumns = (nbBodies + NB_BOXES_PER_COLUMN - 1) / NB_BOXES_PER_COLUMN;
+            return static_cast<uint>(std::ceil(std::sqrt(double(nbColumns))));
+        }
+
+        /// Return the half-width of the square area covered by the columns
+        static decimal computeHalfWidth(uint nbBodies) {
+            return decimal(0.5) * SPACING * decimal(computeNbColumnsPerSide(nbBodies));
+        }
+
+    public :
+
+        // ---------- Methods ---------- //
+
+        /// Constructor
+        CubeStackBenchmark(uint nbBodies, const WorldSettings& worldSettings = WorldSettings())
+            : Benchmark("cubestack", nbBodies), mBoxShape(Vector3(decimal(0.5), decimal(0.5), decimal(0.5))),
+              mFloorShape(Vector3(computeHalfWidth(nbBodies) + 1, 1, computeHalfWidth(nbBodies) + 1)), mWorld(Vector3(0, decimal(-9.81), 0), worldSettings) {
+
+            mWorld.enableSleeping(false);
+
+            const uint nbColumnsPerSide = computeNbColumnsPerSide(nbBodies);
+            const decimal halfWidth = computeHalfWidth(nbBodies) - decimal(0.5) * SPACING;
+
+            // Floor
+            RigidBody* floor = mWorld.createRigidBody(Transform(Vector3(0, -1, 0), Quaternion::identity()));
+            floor->setType(BodyType::STATIC);
+            floor->addCollisionShape(&mFloorShape, Transform::identity(), decimal(1.0));
+
+            // Columns of boxes
+            for (uint i=0; i < nbBodies; i++) {
+
+                const uint column = i / NB_BOXES_PER_COLUMN;
+                const uint level = i % NB_BOXES_PER_COLUMN;
+                const Vector3 position(decimal(column % nbColumnsPerSide) * SPACING - halfWidth,
+                                       decimal(0.5) + decimal(level) * decimal(1.01),
+                                       decimal(column / nbColumnsPerSide) * SPACING - halfWidth);
+
+                RigidBody* body = mWorld.createRigidBody(Transform(position, Quaternion::identity()));
+                mBodies.push_back(body);
+                body->addCollisionShape(&mBoxShape, Transform::identity(), decimal(1.0));
+            }
+        }
+
+        /// Advance the scene by one frame
+        virtual void step() override {
+            mWorld.update(mTimeStep);
+        }
+
+        /// Return the dynamics world of the scene
+        virtual DynamicsWorld* getDynamicsWorld() override {
+            return &mWorld;
+        }
+};
+
+}
+
+#endif
@@ -0,0 +1,117 @@
+/********************************************************************************
+* ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
+* Copyright (c) 2010-2018 Daniel Chappuis                                       *
+*********************************************************************************
+*                                                                               *
+* This software is provided 'as-is', without any express or implied warranty.   *
+* In no event will the authors be held liable for any damages arising from the  *
+* use of this software.                                                         *
+*                                                                               *
+* Permission is granted to anyone to use this software for any purpose,         *
+* including commercial applications, and to alter it and redistribute it        *
+* freely, subject to the following restrictions:                                *
+*                                                                               *
+* 1. The origin of this software must not be misrepresented; you must not claim *
+*    that you wrote the original software. If you use this software in a        *
+*    product, an acknowledgment in the product documentation would be           *
+*    appreciated but is not required.                                           *
+*                                                                               *
+* 2. Altered source versions must be plainly marked as such, and must not be    *
+*    misrepresented as being the original software.                             *
+*                                                                               *
+* 3. This notice may not be removed or altered from any source distribution.    *
+*                                                                               *
+********************************************************************************/
+
+#ifndef FALLING_BODIES_BENCHMARK_H
+#define FALLING_BODIES_BENCHMARK_H
+
+// Libraries
+#include "Benchmark.h"
+#include <cmath>
+
+/// Reactphysics3D namespace
+namespace reactphysics3d {
+
+// Class FallingBodiesBenchmark
+/**
+ * This abstract class represents a scene where boxes, spheres and capsules are dropped in
+ * layers onto a static ground created by the subclass. The bodies are placed on a square grid
+ * of layers of at most NB_BODIES_PER_LAYER_SIDE bodies per side.
+ */
+class FallingBodiesBenchmark : public Benchmark {
+
+    protected :
+
+        // ---------- Constants ---------- //
+
+        /// Number of layers of bodies
+        static const uint NB_LAYERS = 10;
+
+        /// Distance between the centers of two neighbour bodies
+        static constexpr decimal SPACING = decimal(2.0);
+
+        // ---------- Attributes ---------- //
+
+        /// Number of bodies along each side of a layer
+        uint mNbBodiesPerSide;
+
+        /// Box shape of the bodies
+        BoxShape mBoxShape;
+
+        /// Sphere shape of the bodies
+        SphereShape mSphereShape;
+
+        /// Capsule shape of the bodies
+        CapsuleShape mCapsuleShape;
+
+        // ---------- Methods ---------- //
+
+        /// Return the half-width of the square area covered by the bodies
+        decimal getHalfWidth() const {
+            return decimal(0.5) * SPACING * decimal(mNbBodiesPerSide);
+        }
+
+        /// Create the bodies in layers starting at a given height above the ground
+        void createBodies(DynamicsWorld& world, decimal height) {
+
+            const decimal halfWidth = getHalfWidth() - decimal(0.5) * SPACING;
+            for (uint i=0; i < getNbBodies(); i++) {
+
+                const uint layer = i / (mNbBodiesPerSide * mNbBodiesPerSide);
+                const uint row = (i / mNbBodiesPerSide) % mNbBodiesPerSide;
+                const uint column = i % mNbBodiesPerSide;
+
+                // Offset every second layer so that the bodies do not fall exactly on each other
+                const decimal offset = (layer % 2 == 0) ? decimal(0) : decimal(0.25) * SPACING;
+                const Vector3 position(decimal(column) * SPACING - halfWidth + offset,
+                                       height + decimal(layer) * SPACING,
+                                       decimal(row) * SPACING - halfWidth + offset);
+
+                RigidBody* body = world.createRigidBody(Transform(position, Quaternion::identity()));
+                mBodies.push_back(body);
+                switch (i % 3) {
+                    case 0: body->addCollisionShape(&mBoxShape, Transform::identity(), decimal(1.0)); break;
+                    case 1: body->addCollisionShape(&mSphereShape, Transform::identity(), decimal(1.0)); break;
+                    case 2: body->addCollisionShape(&mCapsuleShape, Transform::identity(), decimal(1.0)); break;
+                }
+            }
+        }
+
+    public :
+
+        // ---------- Methods ---------- //
+
+        /// Constructor
+        FallingBodiesBenchmark(const std::string& name, uint nbBodies)
+            : Benchmark(name, nbBodies),
+              mNbBodiesPerSide(static_cast<uint>(std::ceil(std::sqrt(double(nbBodies) / double(NB_LAYERS))))),
+              mBoxShape(Vector3(decimal(0.5), decimal(0.5), decimal(0.5))), mSphereShape(decimal(0.5)),
+              mCapsuleShape(decimal(0.4), decimal(0.8)) {
+
+        }
+};
+
+}
+
+#endif
@@ -0,0 +1,116 @@
+/********************************************************************************
+* ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
+* Copyright (c) 2010-2018 Daniel Chappuis                                       *
+*********************************************************************************
+*                                                                               *
+* This software is provided 'as-is', without any express or implied warranty.   *
+* In no event will the authors be held liable for any damages arising from the  *
+* use of this software.                                                         *
+*                                                                               *
+* Permission is granted to anyone to use this software for any purpose,         *
+* including commercial applications, and to alter it and redistribute it        *
+* freely, subject to the following restrictions:                                *
+*                                                                               *
+* 1. The origin of this software must not be misrepresented; you must not claim *
+*    that you wrote the original software. If you use this software in a        *
+*    product, an acknowledgment in the product documentation would be           *
+*    appreciated but is not required.                                           *
+*                                                                               *
+* 2. Altered source versions must be plainly marked as such, and must not be    *
+*    misrepresented as being the original software.                             *
+*                                                                               *
+* 3. This notice may not be removed or altered from any source distribution.    *
+*                                                                               *
+********************************************************************************/
+
+#ifndef HEIGHT_FIELD_BENCHMARK_H
+#define HEIGHT_FIELD_BENCHMARK_H
+
+// Libraries
+#include "FallingBodiesBenchmark.h"
+#include <vector>
+
+/// Reactphysics3D namespace
+namespace reactphysics3d {
+
+// Class HeightFieldBenchmark
+/**
+ * This class represents a scene where the bodies are dropped onto a bumpy height field
+ * that covers the area of the bodies.
+ */
+class HeightFieldBenchmark : public FallingBodiesBenchmark {
+
+    private :
+
+        // ---------- Constants ---------- //
+
+        /// Number of points of the height field along each side
+        static const int NB_POINTS_PER_SIDE = 101;
+
+        // ---------- Attributes ---------- //
+
+        /// Heights of the points of the height field
+        std::vector<float> mHeights;
+
+        /// Shape of the height field
+        HeightFieldShape mHeightFieldShape;
+
+        /// Dynamics world (declared last so that it is destroyed first)
+        DynamicsWorld mWorld;
+
+        // ---------- Methods ---------- //
+
+        /// Compute the heights of the points of the height field
+        static std::vector<float> computeHeights() {
+
+            std::vector<float> heights(NB_POINTS_PER_SIDE * NB_POINTS_PER_SIDE);
+            for (int i=0; i < NB_POINTS_PER_SIDE; i++) {
+                for (int j=0; j < NB_POINTS_PER_SIDE; j++) {
+                    heights[i * NB_POINTS_PER_SIDE + j] = float(std::sin(0.3 * i) + std::cos(0.3 * j));
+                }
+            }
+
+            return heights;
+        }
+
+        /// Return the size of a cell of the height field so that it covers the bodies with a margin
+        decimal computeCellSize() const {
+            return decimal(2.0) * (getHalfWidth() + SPACING) / decimal(NB_POINTS_PER_SIDE - 1);
+        }
+
+    public :
+
+        // ---------- Methods ---------- //
+
+        /// Constructor
+        HeightFieldBenchmark(uint nbBodies, const WorldSettings& worldSettings = WorldSettings())
+            : FallingBodiesBenchmark("heightfield", nbBodies),
+              mHeights(computeHeights()),
+              mHeightFieldShape(NB_POINTS_PER_SIDE, NB_POINTS_PER_SIDE, decimal(-2.0), decimal(2.0), mHeights.data(),
+                                HeightFieldShape::HeightDataType::HEIGHT_FLOAT_TYPE, 1, decimal(1.0),
+                                Vector3(computeCellSize(), 1, computeCellSize())),
+              mWorld(Vector3(0, decimal(-9.81), 0), worldSettings) {
+
+            mWorld.enableSleeping(false);
+
+            RigidBody* ground = mWorld.createRigidBody(Transform::identity());
+            ground->setType(BodyType::STATIC);
+            ground->addCollisionShape(&mHeightFieldShape, Transform::identity(), decimal(1.0));
+
+            createBodies(mWorld, decimal(3.0));
+        }
+
+        /// Advance the scene by one frame
+        virtual void step() override {
+            mWorld.update(mTimeStep);
+        }
+
+        /// Return the dynamics world of the scene
+        virtual DynamicsWorld* getDynamicsWorld() override {
+            return &mWorld;
+        }
+};
+
+}
+
+#endif
@@ -0,0 +1,120 @@
+/********************************************************************************
+* ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
+* Copyright (c) 2010-2018 Daniel Chappuis                                       *
+*********************************************************************************
+*                                                                               *
+* This software is provided 'as-is', without any express or implied warranty.   *
+* In no event will the authors be held liable for any damages arising from the  *
+* use of this software.                                                         *
+*                                                                               *
+* Permission is granted to anyone to use this software for any purpose,         *
+* including commercial applications, and to alter it and redistribute it        *
+* freely, subject to the following restrictions:                                *
+*                                                                               *
+* 1. The origin of this software must not be misrepresented; you must not claim *
+*    that you wrote the original software. If you use this software in a        *
+*    product, an acknowledgment in the product documentation would be           *
+*    appreciated but is not required.                                           *
+*                                                                               *
+* 2. Altered source versions must be plainly marked as such, and must not be    *
+*    misrepresented as being the original software.                             *
+*                                                                               *
+* 3. This notice may not be removed or altered from any source distribution.    *
+*                                                                               *
+********************************************************************************/
+
+#ifndef JOINTS_BENCHMARK_H
+#define JOINTS_BENCHMARK_H
+
+// Libraries
+#include "Benchmark.h"
+#include <cmath>
+
+/// Reactphysics3D namespace
+namespace reactphysics3d {
+
+// Class JointsBenchmark
+/**
+ * This class represents a scene with horizontal chains of boxes connected by ball-and-socket
+ * joints. The first box of each chain is attached to a static anchor body and the chains
+ * swing under the gravity so that the steps are dominated by the joints.
+ */
+class JointsBenchmark : public Benchmark {
+
+    private :
+
+        // ---------- Constants ---------- //
+
+        /// Number of boxes of each chain
+        static const uint NB_BOXES_PER_CHAIN = 10;
+
+        /// Distance between the centers of two consecutive boxes of a chain
+        static constexpr decimal LINK_LENGTH = decimal(1.0);
+
+        /// Distance between two neighbour chains
+        static constexpr decimal CHAIN_SPACING = decimal(1.5);
+
+        // ---------- Attributes ---------- //
+
+        /// Box shape of the links of the chains
+        BoxShape mBoxShape;
+
+        /// Dynamics world (declared last so that it is destroyed first)
+        DynamicsWorld mWorld;
+
+    public :
+
+        // ---------- Methods ---------- //
+
+        /// Constructor
+        JointsBenchmark(uint nbBodies, const WorldSettings& worldSettings = WorldSettings())
+            : Benchmark("joints", nbBodies), mBoxShape(Vector3(decimal(0.4), decimal(0.2), decimal(0.2))),
+              mWorld(Vector3(0, decimal(-9.81), 0), worldSettings) {
+
+            mWorld.enableSleeping(false);
+
+            const uint nbChains = (nbBodies + NB_BOXES_PER_CHAIN - 1) / NB_BOXES_PER_CHAIN;
+            const uint nbChainsPerSide = static_cast<uint>(std::ceil(std::sqrt(double(nbChains))));
+            const decimal chainLength = decimal(NB_BOXES_PER_CHAIN + 2) * LINK_LENGTH;
+
+            RigidBody* previousBody = nullptr;
+            for (uint i=0; i < nbBodies; i++) {
+
+                const uint chain = i / NB_BOXES_PER_CHAIN;
+                const uint link = i % NB_BOXES_PER_CHAIN;
+                const Vector3 chainStart(decimal(chain % nbChainsPerSide) * chainLength, 0,
+                                         decimal(chain / nbChainsPerSide) * CHAIN_SPACING);
+
+                // Static anchor of the chain
+                if (link == 0) {
+                    previousBody = mWorld.createRigidBody(Transform(chainStart, Quaternion::identity()));
+                    previousBody->setType(BodyType::STATIC);
+                }
+
+                const Vector3 position = chainStart + Vector3(decimal(link + 1) * LINK_LENGTH, 0, 0);
+                RigidBody* body = mWorld.createRigidBody(Transform(position, Quaternion::identity()));
+                mBodies.push_back(body);
+                body->addCollisionShape(&mBoxShape, Transform::identity(), decimal(1.0));
+
+                const Vector3 anchor = position - Vector3(decimal(0.5) * LINK_LENGTH, 0, 0);
+                BallAndSocketJointInfo jointInfo(previousBody, body, anchor);
+                mWorld.createJoint(jointInfo);
+
+                previousBody = body;
+            }
+        }
+
+        /// Advance the scene by one frame
+        virtual void step() override {
+            mWorld.update(mTimeStep);
+        }
+
+        /// Return the dynamics world of the scene
+        virtual DynamicsWorld* getDynamicsWorld() override {
+            return &mWorld;
+        }
+};
+
+}
+
+#endif
@@ -0,0 +1,135 @@
+/********************************************************************************
+* ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
+* Copyright (c) 2010-2018 Daniel Chappuis                                       *
+*********************************************************************************
+*                                                                               *
+* This software is provided 'as-is', without any express or implied warranty.   *
+* In no event will the authors be held liable for any damages arising from the  *
+* use of this software.                                                         *
+*                                                                               *
+* Permission is granted to anyone to use this software for any purpose,         *
+* including commercial applications, and to alter it and redistribute it        *
+* freely, subject to the following restrictions:                                *
+*                                                                               *
+* 1. The origin of this software must not be misrepresented; you must not claim *
+*    that you wrote the original software. If you use this software in a        *
+*    product, an acknowledgment in the product documentation would be           *
+*    appreciated but is not required.                                           *
+*                                                                               *
+* 2. Altered source versions must be plainly marked as such, and must not be    *
+*    misrepresented as being the original software.                             *
+*                                                                               *
+* 3. This notice may not be removed or altered from any source distribution.    *
+*                                                                               *
+********************************************************************************/
+
+#ifndef RAYCAST_BENCHMARK_H
+#define RAYCAST_BENCHMARK_H
+
+// Libraries
+#include "Benchmark.h"
+#include <cmath>
+#include <random>
+#include <vector>
+
+/// Reactphysics3D namespace
+namespace reactphysics3d {
+
+// Class ClosestHitCallback
+/**
+ * Raycast callback that clips the ray at each hit to find the closest hit.
+ */
+class ClosestHitCallback : public RaycastCallback {
+
+    public:
+
+        /// Called when a shape is hit by the ray
+        virtual decimal notifyRaycastHit(const RaycastInfo& raycastInfo) override {
+            return raycastInfo.hitFraction;
+        }
+};
+
+// Class RaycastBenchmark
+/**
+ * This class represents a scene with collision bodies (boxes, spheres and capsules) at random
+ * positions in a cube. Each step casts a batch of random rays through the cube and looks for
+ * the closest hit of each ray.
+ */
+class RaycastBenchmark : public Benchmark {
+
+    private :
+
+        // ---------- Constants ---------- //
+
+        /// Number of rays cast at each step
+        static const uint NB_RAYS_PER_STEP = 1000;
+
+        // ---------- Attributes ---------- //
+
+        /// Box shape of the bodies
+        BoxShape mBoxShape;
+
+        /// Sphere shape of the bodies
+        SphereShape mSphereShape;
+
+        /// Capsule shape of the bodies
+        CapsuleShape mCapsuleShape;
+
+        /// Rays cast at each step
+        std::vector<Ray> mRays;
+
+        /// Collision world (declared last so that it is destroyed first)
+        CollisionWorld mWorld;
+
+    public :
+
+        // ---------- Methods ---------- //
+
+        /// Constructor
+        RaycastBenchmark(uint nbBodies, const WorldSettings& worldSettings = WorldSettings())
+            : Benchmark("raycast", nbBodies), mBoxShape(Vector3(decimal(0.5), decimal(0.5), decimal(0.5))),
+              mSphereShape(decimal(0.5)), mCapsuleShape(decimal(0.4), decimal(0.8)), mWorld(worldSettings) {
+
+            // The bodies fill about one percent of the volume of the cube
+            const decimal halfWidth = decimal(0.5) * decimal(std::cbrt(100.0 * nbBodies));
+
+            std::mt19937 generator(1);
+            std::uniform_real_distribution<float> coordinate(float(-halfWidth), float(halfWidth));
+            std::uniform_real_distribution<float> angle(0.0f, 3.14159265f);
+
+            for (uint i=0; i < nbBodies; i++) {
+
+                const Vector3 position(coordinate(generator), coordinate(generator), coordinate(generator));
+                const Quaternion orientation = Quaternion::fromEulerAngles(angle(generator), angle(generator),
+                                                                          angle(generator));
+                CollisionBody* body = mWorld.createCollisionBody(Transform(position, orientation));
+                mBodies.push_back(body);
+                switch (i % 3) {
+                    case 0: body->addCollisionShape(&mBoxShape, Transform::identity()); break;
+                    case 1: body->addCollisionShape(&mSphereShape, Transform::identity()); break;
+                    case 2: body->addCollisionShape(&mCapsuleShape, Transform::identity()); break;
+                }
+            }
+
+            // Each ray crosses the cube between two random points on opposite faces
+            mRays.reserve(NB_RAYS_PER_STEP);
+            for (uint i=0; i < NB_RAYS_PER_STEP; i++) {
+                const Vector3 point1(-halfWidth, coordinate(generator), coordinate(generator));
+                const Vector3 point2(halfWidth, coordinate(generator), coordinate(generator));
+                mRays.push_back(Ray(point1, point2));
+            }
+        }
+
+        /// Cast the rays of a step
+        virtual void step() override {
+
+            ClosestHitCallback callback;
+            for (uint i=0; i < mRays.size(); i++) {
+                mWorld.raycast(mRays[i], &callback);
+            }
+        }
+};
+
+}
+
+#endif
@@ -55,6 +55,10 @@ class Body {
         /// True if the body has already been added in an island (for sleeping technique)
         bool mIsAlreadyInIsland;
 
+        /// True if a contact manifold or a joint of the body has been removed since
+        /// the last computation of the islands
+        bool mIsConstraintRemoved;
+
         /// True if the body is allowed to go to sleep for better efficiency
         bool mIsAllowedToSleep;
 
@@ -147,6 +151,7 @@ class Body {
         // -------------------- Friendship -------------------- //
 
         friend class DynamicsWorld;
+        friend class ContactManifold;
 };
 
 // Return the id of the body
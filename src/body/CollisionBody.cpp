@@ -41,7 +41,8 @@ using namespace reactphysics3d;
  */
 CollisionBody::CollisionBody(const Transform& transform, CollisionWorld& world, bodyindex id)
               : Body(id), mType(BodyType::DYNAMIC), mTransform(transform), mProxyCollisionShapes(nullptr),
-                mNbCollisionShapes(0), mContactManifoldsList(nullptr), mWorld(world) {
+                mNbCollisionShapes(0), mContactManifoldsIndex(0), mNbContactManifolds(0), mWorld(world),
+                mWorldIndex(0), mIsBeingDestroyed(false) {
 
 #ifdef IS_PROFILING_ACTIVE
         mProfiler = nullptr;
@@ -51,7 +52,7 @@ CollisionBody::CollisionBody(const Transform& transform, CollisionWorld& world,
 
 // Destructor
 CollisionBody::~CollisionBody() {
-    assert(mContactManifoldsList == nullptr);
+    assert(mNbContactManifolds == 0);
 
     // Remove all the proxy collision shapes of the body
     removeAllCollisionShapes();
@@ -77,7 +78,7 @@ ProxyShape* CollisionBody::addCollisionShape(CollisionShape* collisionShape,
 
     // Create a new proxy collision shape to attach the collision shape to the body
     ProxyShape* proxyShape = new (mWorld.mMemoryManager.allocate(MemoryManager::AllocationType::Pool,
-                                      sizeof(ProxyShape))) ProxyShape(this, collisionShape,
+                                      sizeof(ProxyShape), MemoryTag::Shapes)) ProxyShape(this, collisionShape,
                                                                       transform, decimal(1), mWorld.mMemoryManager);
 
 #ifdef IS_PROFILING_ACTIVE
@@ -141,12 +142,12 @@ void CollisionBody::removeCollisionShape(const ProxyShape* proxyShape) {
     if (current == proxyShape) {
         mProxyCollisionShapes = current->mNext;
 
-        if (mIsActive && proxyShape->getBroadPhaseId() != -1) {
+        if (mIsActive && proxyShape->isInCollisionDetection()) {
             mWorld.mCollisionDetection.removeProxyCollisionShape(current);
         }
 
         current->~ProxyShape();
-        mWorld.mMemoryManager.release(MemoryManager::AllocationType::Pool, current, sizeof(ProxyShape));
+        mWorld.mMemoryManager.release(MemoryManager::AllocationType::Pool, current, sizeof(ProxyShape), MemoryTag::Shapes);
         mNbCollisionShapes--;
         return;
     }
@@ -161,12 +162,12 @@ void CollisionBody::removeCollisionShape(const ProxyShape* proxyShape) {
             ProxyShape* elementToRemove = current->mNext;
             current->mNext = elementToRemove->mNext;
 
-            if (mIsActive && proxyShape->getBroadPhaseId() != -1) {
+            if (mIsActive && proxyShape->isInCollisionDetection()) {
                 mWorld.mCollisionDetection.removeProxyCollisionShape(elementToRemove);
             }
 
             elementToRemove->~ProxyShape();
-            mWorld.mMemoryManager.release(MemoryManager::AllocationType::Pool, elementToRemove, sizeof(ProxyShape));
+            mWorld.mMemoryManager.release(MemoryManager::AllocationType::Pool, elementToRemove, sizeof(ProxyShape), MemoryTag::Shapes);
             mNbCollisionShapes--;
             return;
         }
@@ -187,12 +188,12 @@ void CollisionBody::removeAllCollisionShapes() {
         // Remove the proxy collision shape
         ProxyShape* nextElement = current->mNext;
 
-        if (mIsActive && current->getBroadPhaseId() != -1) {
+        if (mIsActive && current->isInCollisionDetection()) {
             mWorld.mCollisionDetection.removeProxyCollisionShape(current);
         }
 
         current->~ProxyShape();
-        mWorld.mMemoryManager.release(MemoryManager::AllocationType::Pool, current, sizeof(ProxyShape));
+        mWorld.mMemoryManager.release(MemoryManager::AllocationType::Pool, current, sizeof(ProxyShape), MemoryTag::Shapes);
 
         // Get the next element in the list
         current = nextElement;
@@ -202,20 +203,20 @@ void CollisionBody::removeAllCollisionShapes() {
 }
 
 // Reset the contact manifold lists
+/// The contact manifolds of the body are stored by the collision detection and rebuilt at
+/// each frame. The body only forgets its range of them.
 void CollisionBody::resetContactManifoldsList() {
+    mNbContactManifolds = 0;
+}
 
-    // Delete the linked list of contact manifolds of that body
-    ContactManifoldListElement* currentElement = mContactManifoldsList;
-    while (currentElement != nullptr) {
-        ContactManifoldListElement* nextElement = currentElement->getNext();
-
-        // Delete the current element
-        currentElement->~ContactManifoldListElement();
-        mWorld.mMemoryManager.release(MemoryManager::AllocationType::Pool, currentElement, sizeof(ContactManifoldListElement));
-
-        currentElement = nextElement;
-    }
-    mContactManifoldsList = nullptr;
+// Return a contact manifold involving this body
+/**
+ * @param index Index of the contact manifold (between zero and getNbContactManifolds() - 1)
+ * @return A pointer to the contact manifold
+ */
+const ContactManifold* CollisionBody::getContactManifold(uint index) const {
+    assert(index < mNbContactManifolds);
+    return mWorld.mCollisionDetection.getBodyContactManifold(mContactManifoldsIndex + index);
 }
 
 // Update the broad-phase state for this body (because it has moved for instance)
@@ -232,7 +233,7 @@ void CollisionBody::updateBroadPhaseState() const {
 // Update the broad-phase state of a proxy collision shape of the body
 void CollisionBody::updateProxyShapeInBroadPhase(ProxyShape* proxyShape, bool forceReinsert) const {
 
-    if (proxyShape->getBroadPhaseId() != -1) {
+    if (proxyShape->isInCollisionDetection()) {
 
         // Recompute the world-space AABB of the collision shape
         AABB aabb;
@@ -243,6 +244,47 @@ void CollisionBody::updateProxyShapeInBroadPhase(ProxyShape* proxyShape, bool fo
     }
 }
 
+// Move a proxy shape of the body between the broad-phase and the query-only shapes
+/// The overlapping pairs of the shape are removed when it becomes a query-only shape.
+/**
+ * @param proxyShape Pointer to a proxy shape of the body
+ * @param isQueryOnly True if the proxy shape must only be used by the queries of the world
+ */
+void CollisionBody::setIsProxyShapeQueryOnly(ProxyShape* proxyShape, bool isQueryOnly) {
+
+    const bool isInCollisionDetection = mIsActive && proxyShape->isInCollisionDetection();
+
+    if (isInCollisionDetection) {
+        mWorld.mCollisionDetection.removeProxyCollisionShape(proxyShape);
+    }
+
+    proxyShape->mIsQueryOnly = isQueryOnly;
+
+    if (isInCollisionDetection) {
+
+        // Compute the world-space AABB of the collision shape
+        AABB aabb;
+        proxyShape->getCollisionShape()->computeAABB(aabb, mTransform * proxyShape->mLocalToBodyTransform);
+
+        mWorld.mCollisionDetection.addProxyCollisionShape(proxyShape, aabb);
+    }
+}
+
+// Set the variable to know whether or not the body is sleeping
+/// The collision detection is notified when the body is woken up so that its
+/// overlapping pairs that have been parked while it was sleeping become active.
+/**
+ * @param isSleeping True if the body is sleeping
+ */
+void CollisionBody::setIsSleeping(bool isSleeping) {
+
+    if (!isSleeping && mIsSleeping) {
+        mWorld.mCollisionDetection.notifyBodyWokenUp(this);
+    }
+
+    Body::setIsSleeping(isSleeping);
+}
+
 // Set whether or not the body is active
 /**
  * @param isActive True if you want to activate the body
@@ -273,7 +315,7 @@ void CollisionBody::setIsActive(bool isActive) {
         // For each proxy shape of the body
         for (ProxyShape* shape = mProxyCollisionShapes; shape != nullptr; shape = shape->mNext) {
 
-            if (shape->getBroadPhaseId() != -1) {
+            if (shape->isInCollisionDetection()) {
 
                 // Remove the proxy shape from the collision detection
                 mWorld.mCollisionDetection.removeProxyCollisionShape(shape);
@@ -306,18 +348,13 @@ int CollisionBody::resetIsAlreadyInIslandAndCountManifolds() {
 
     mIsAlreadyInIsland = false;
 
-    int nbManifolds = 0;
-
     // Reset the mIsAlreadyInIsland variable of the contact manifolds for
     // this body
-    ContactManifoldListElement* currentElement = mContactManifoldsList;
-    while (currentElement != nullptr) {
-        currentElement->getContactManifold()->mIsAlreadyInIsland = false;
-        currentElement = currentElement->getNext();
-        nbManifolds++;
+    for (uint i=0; i < mNbContactManifolds; i++) {
+        mWorld.mCollisionDetection.getBodyContactManifold(mContactManifoldsIndex + i)->mIsAlreadyInIsland = false;
     }
 
-    return nbManifolds;
+    return static_cast<int>(mNbContactManifolds);
 }
 
 // Return true if a point is inside the collision body
@@ -410,6 +447,17 @@ void CollisionBody::setTransform(const Transform& transform) {
              "Body " + std::to_string(mID) + ": Set transform=" + mTransform.to_string());
 }
 
+// Move the body by the opposite of the displacement of the origin of the world
+/// The body keeps its absolute position. Unlike setTransform(), this method is called by the
+/// world for all its bodies when its origin is moved (see CollisionWorld::setOrigin()) and
+/// the broad-phase is moved separately by the world.
+/**
+ * @param shift The displacement of the origin of the world (in the old world-space coordinates)
+ */
+void CollisionBody::shiftOrigin(const Vector3& shift) {
+    mTransform.setPosition(mTransform.getPosition() - shift);
+}
+
 
 // Set the type of the body
 /// The type of the body can either STATIC, KINEMATIC or DYNAMIC as described bellow:
@@ -427,6 +475,14 @@ void CollisionBody::setTransform(const Transform& transform) {
 void CollisionBody::setType(BodyType type) {
     mType = type;
 
+    // The parked overlapping pairs of the body might have become active
+    mWorld.mCollisionDetection.notifyBodyWokenUp(this);
+
+    // The broad-phase may store the shapes of the static bodies separately
+    for (ProxyShape* shape = mProxyCollisionShapes; shape != nullptr; shape = shape->mNext) {
+        mWorld.mCollisionDetection.updateProxyCollisionShapeType(shape);
+    }
+
     if (mType == BodyType::STATIC) {
 
         // Update the broad-phase state of the body
@@ -37,7 +37,7 @@
 namespace reactphysics3d {
 
 // Declarations
-struct ContactManifoldListElement;
+class ContactManifold;
 class ProxyShape;
 class CollisionWorld;
 class CollisionShape;
@@ -79,12 +79,22 @@ class CollisionBody : public Body {
         /// Number of collision shapes
         uint mNbCollisionShapes;
 
-        /// First element of the linked list of contact manifolds involving this body
-        ContactManifoldListElement* mContactManifoldsList;
+        /// Index of the first contact manifold involving this body in the contiguous array of
+        /// the contact manifolds of the bodies of the collision detection
+        uint mContactManifoldsIndex;
+
+        /// Number of contact manifolds involving this body
+        uint mNbContactManifolds;
 
         /// Reference to the world the body belongs to
         CollisionWorld& mWorld;
 
+        /// Index of the body in the list of bodies of the world
+        uint mWorldIndex;
+
+        /// True if the body is being destroyed together with other bodies
+        bool mIsBeingDestroyed;
+
 #ifdef IS_PROFILING_ACTIVE
 
 		/// Pointer to the profiler
@@ -106,10 +116,16 @@ class CollisionBody : public Body {
         /// Update the broad-phase state of a proxy collision shape of the body
         void updateProxyShapeInBroadPhase(ProxyShape* proxyShape, bool forceReinsert = false) const;
 
+        /// Move a proxy shape of the body between the broad-phase and the query-only shapes
+        void setIsProxyShapeQueryOnly(ProxyShape* proxyShape, bool isQueryOnly);
+
         /// Ask the broad-phase to test again the collision shapes of the body for collision
         /// (as if the body has moved).
         void askForBroadPhaseCollisionCheck() const;
 
+        /// Move the body by the opposite of the displacement of the origin of the world
+        virtual void shiftOrigin(const Vector3& shift);
+
         /// Reset the mIsAlreadyInIsland variable of the body and contact manifolds
         int resetIsAlreadyInIslandAndCountManifolds();
 
@@ -138,6 +154,9 @@ class CollisionBody : public Body {
         /// Set whether or not the body is active
         virtual void setIsActive(bool isActive) override;
 
+        /// Set the variable to know whether or not the body is sleeping
+        virtual void setIsSleeping(bool isSleeping) override;
+
         /// Return the current position and orientation
         const Transform& getTransform() const;
 
@@ -151,8 +170,11 @@ class CollisionBody : public Body {
         /// Remove a collision shape from the body
         virtual void removeCollisionShape(const ProxyShape* proxyShape);
 
-        /// Return the first element of the linked list of contact manifolds involving this body
-        const ContactManifoldListElement* getContactManifoldsList() const;
+        /// Return the number of contact manifolds involving this body
+        uint getNbContactManifolds() const;
+
+        /// Return a contact manifold involving this body
+        const ContactManifold* getContactManifold(uint index) const;
 
         /// Return true if a point is inside the collision body
         bool testPointInside(const Vector3& worldPoint) const;
@@ -218,13 +240,12 @@ inline const Transform& CollisionBody::getTransform() const {
     return mTransform;
 }
 
-// Return the first element of the linked list of contact manifolds involving this body
+// Return the number of contact manifolds involving this body
 /**
- * @return A pointer to the first element of the linked-list with the contact
- *         manifolds of this body
+ * @return The number of contact manifolds of the body at the end of the last collision detection
  */
-inline const ContactManifoldListElement* CollisionBody::getContactManifoldsList() const {
-    return mContactManifoldsList;
+inline uint CollisionBody::getNbContactManifolds() const {
+    return mNbContactManifolds;
 }
 
 // Return the linked list of proxy shapes of that body
@@ -37,24 +37,33 @@ using namespace reactphysics3d;
 /**
 * @param transform The transformation of the body
 * @param world The world where the body has been added
+* @param states The store of the dynamic states of the bodies of the world
 * @param id The ID of the body
 */
-RigidBody::RigidBody(const Transform& transform, CollisionWorld& world, bodyindex id)
-          : CollisionBody(transform, world, id), mArrayIndex(0), mInitMass(decimal(1.0)),
-            mCenterOfMassLocal(0, 0, 0), mCenterOfMassWorld(transform.getPosition()),
-            mIsGravityEnabled(true), mMaterial(world.mConfig), mLinearDamping(decimal(0.0)), mAngularDamping(decimal(0.0)),
-            mJointsList(nullptr), mIsCenterOfMassSetByUser(false), mIsInertiaTensorSetByUser(false) {
+RigidBody::RigidBody(const Transform& transform, CollisionWorld& world, RigidBodyStates& states, bodyindex id)
+          : CollisionBody(transform, world, id), mArrayIndex(0), mIsTransformDirty(false), mInitMass(decimal(1.0)),
+            mCenterOfMassLocal(0, 0, 0), mStates(states), mStateIndex(states.addBody(this, transform)),
+            mRigidBodyIndex(0),
+            mIsGravityEnabled(true), mIsBullet(false), mSimulationLevelOfDetail(0), mMaterial(world.mConfig), mLinearDamping(decimal(0.0)), mAngularDamping(decimal(0.0)),
+            mJointsList(nullptr), mIsCenterOfMassSetByUser(false), mIsInertiaTensorSetByUser(false),
+            mBlock(nullptr) {
 
     // Compute the inverse mass
     mMassInverse = decimal(1.0) / mInitMass;
 
     // Update the world inverse inertia tensor
     updateInertiaTensorInverseWorld();
+
+    // The body is alone in its persistent island
+    resetIsland();
 }
 
 // Destructor
 RigidBody::~RigidBody() {
     assert(mJointsList == nullptr);
+
+    // Remove the state of the body from the store
+    mStates.removeBody(mStateIndex);
 }
 
 // Set the type of the body
@@ -83,8 +92,8 @@ void RigidBody::setType(BodyType type) {
     if (mType == BodyType::STATIC) {
 
         // Reset the velocity to zero
-        mLinearVelocity.setToZero();
-        mAngularVelocity.setToZero();
+        mStates.mLinearVelocities[mStateIndex].setToZero();
+        mStates.mAngularVelocities[mStateIndex].setToZero();
     }
 
     // If it is a static or a kinematic body
@@ -93,7 +102,7 @@ void RigidBody::setType(BodyType type) {
         // Reset the inverse mass and inverse inertia tensor to zero
         mMassInverse = decimal(0.0);
         mInertiaTensorLocalInverse.setToZero();
-        mInertiaTensorInverseWorld.setToZero();
+        mStates.mInertiaTensorsInverseWorld[mStateIndex].setToZero();
     }
     else {  // If it is a dynamic body
         mMassInverse = decimal(1.0) / mInitMass;
@@ -117,8 +126,8 @@ void RigidBody::setType(BodyType type) {
     askForBroadPhaseCollisionCheck();
 
     // Reset the force and torque on the body
-    mExternalForce.setToZero();
-    mExternalTorque.setToZero();
+    mStates.mExternalForces[mStateIndex].setToZero();
+    mStates.mExternalTorques[mStateIndex].setToZero();
 }
 
 // Set the local inertia tensor of the body (in local-space coordinates)
@@ -141,6 +150,9 @@ void RigidBody::setInertiaTensorLocal(const Matrix3x3& inertiaTensorLocal) {
     // Update the world inverse inertia tensor
     updateInertiaTensorInverseWorld();
 
+    // The joints of the body must recompute their solver data
+    invalidateJointsSolverData();
+
     RP3D_LOG(mLogger, Logger::Level::Information, Logger::Category::Body,
              "Body " + std::to_string(mID) + ": Set inertiaTensorLocal=" + inertiaTensorLocal.to_string());
 }
@@ -165,6 +177,9 @@ void RigidBody::setInverseInertiaTensorLocal(const Matrix3x3& inverseInertiaTens
     // Update the world inverse inertia tensor
     updateInertiaTensorInverseWorld();
 
+    // The joints of the body must recompute their solver data
+    invalidateJointsSolverData();
+
     RP3D_LOG(mLogger, Logger::Level::Information, Logger::Category::Body,
              "Body " + std::to_string(mID) + ": Set inverseInertiaTensorLocal=" + inverseInertiaTensorLocal.to_string());
 }
@@ -182,14 +197,17 @@ void RigidBody::setCenterOfMassLocal(const Vector3& centerOfMassLocal) {
 
     mIsCenterOfMassSetByUser = true;
 
-    const Vector3 oldCenterOfMass = mCenterOfMassWorld;
+    const Vector3 oldCenterOfMass = mStates.mCentersOfMassWorld[mStateIndex];
     mCenterOfMassLocal = centerOfMassLocal;
 
     // Compute the center of mass in world-space coordinates
-    mCenterOfMassWorld = mTransform * mCenterOfMassLocal;
+    mStates.mCentersOfMassWorld[mStateIndex] = mTransform * mCenterOfMassLocal;
 
     // Update the linear velocity of the center of mass
-    mLinearVelocity += mAngularVelocity.cross(mCenterOfMassWorld - oldCenterOfMass);
+    mStates.mLinearVelocities[mStateIndex] += mStates.mAngularVelocities[mStateIndex].cross(mStates.mCentersOfMassWorld[mStateIndex] - oldCenterOfMass);
+
+    // The joints of the body must recompute their solver data
+    invalidateJointsSolverData();
 
     RP3D_LOG(mLogger, Logger::Level::Information, Logger::Category::Body,
              "Body " + std::to_string(mID) + ": Set centerOfMassLocal=" + centerOfMassLocal.to_string());
@@ -229,7 +247,7 @@ void RigidBody::removeJointFromJointsList(MemoryManager& memoryManager, const Jo
         mJointsList = elementToRemove->next;
         elementToRemove->~JointListElement();
         memoryManager.release(MemoryManager::AllocationType::Pool,
-                              elementToRemove, sizeof(JointListElement));
+                              elementToRemove, sizeof(JointListElement), MemoryTag::Solver);
     }
     else {  // If the element to remove is not the first one in the list
         JointListElement* currentElement = mJointsList;
@@ -239,7 +257,7 @@ void RigidBody::removeJointFromJointsList(MemoryManager& memoryManager, const Jo
                 currentElement->next = elementToRemove->next;
                 elementToRemove->~JointListElement();
                 memoryManager.release(MemoryManager::AllocationType::Pool,
-                                      elementToRemove, sizeof(JointListElement));
+                                      elementToRemove, sizeof(JointListElement), MemoryTag::Solver);
                 break;
             }
             currentElement = currentElement->next;
@@ -269,7 +287,7 @@ ProxyShape* RigidBody::addCollisionShape(CollisionShape* collisionShape,
 
     // Create a new proxy collision shape to attach the collision shape to the body
     ProxyShape* proxyShape = new (mWorld.mMemoryManager.allocate(MemoryManager::AllocationType::Pool,
-                                      sizeof(ProxyShape))) ProxyShape(this, collisionShape,
+                                      sizeof(ProxyShape), MemoryTag::Shapes)) ProxyShape(this, collisionShape,
                                                                       transform, mass, mWorld.mMemoryManager);
 
 #ifdef IS_PROFILING_ACTIVE
@@ -347,6 +365,47 @@ void RigidBody::enableGravity(bool isEnabled) {
              (mIsGravityEnabled ? "true" : "false"));
 }
 
+// Set the variable to know if speculative contacts are created for this rigid body
+/// A bullet body is a small and fast moving body that could go through the other
+/// bodies during a single step (tunneling). Its fat AABB in the broad-phase covers its
+/// motion during the next step and, when its shapes are close to the shapes of another
+/// body without touching them, a speculative contact prevents the body from going
+/// through them. This is more expensive than the discrete collision detection and
+/// should only be used for the bodies that really need it.
+/**
+ * @param isBullet True if the body is a bullet body
+ */
+void RigidBody::setIsBullet(bool isBullet) {
+    mIsBullet = isBullet;
+
+    // The fat AABB of a bullet body must cover its motion
+    if (mIsBullet) updateBroadPhaseState();
+
+    RP3D_LOG(mLogger, Logger::Level::Information, Logger::Category::Body,
+             "Body " + std::to_string(mID) + ": Set isBullet=" +
+             (mIsBullet ? "true" : "false"));
+}
+
+// Set the simulation level of detail of the rigid body
+/// The island of a body with the level of detail L is only simulated every 2^L steps of
+/// the world, with the time accumulated since it was last simulated and with fewer solver
+/// iterations. This can be used for the far away or unobserved bodies. An island is simulated
+/// with the smallest level of detail of its awake bodies. The collision detection of the
+/// body is still computed at every step.
+/**
+ * @param level The level of detail (between zero, the default, and NB_SIMULATION_LEVELS_OF_DETAIL - 1)
+ */
+void RigidBody::setSimulationLevelOfDetail(uint level) {
+
+    assert(level < NB_SIMULATION_LEVELS_OF_DETAIL);
+
+    mSimulationLevelOfDetail = level;
+
+    RP3D_LOG(mLogger, Logger::Level::Information, Logger::Category::Body,
+             "Body " + std::to_string(mID) + ": Set simulationLevelOfDetail=" +
+             std::to_string(mSimulationLevelOfDetail));
+}
+
 // Set the linear damping factor. This is the ratio of the linear velocity
 // that the body will lose every at seconds of simulation.
 /**
@@ -394,15 +453,18 @@ void RigidBody::setLinearVelocity(const Vector3& linearVelocity) {
     if (mType == BodyType::STATIC) return;
 
     // Update the linear velocity of the current body state
-    mLinearVelocity = linearVelocity;
+    mStates.mLinearVelocities[mStateIndex] = linearVelocity;
 
     // If the linear velocity is not zero, awake the body
-    if (mLinearVelocity.lengthSquare() > decimal(0.0)) {
+    if (mStates.mLinearVelocities[mStateIndex].lengthSquare() > decimal(0.0)) {
         setIsSleeping(false);
     }
 
+    // The fat AABB of a bullet body must cover its new motion
+    if (mIsBullet) updateBroadPhaseState();
+
     RP3D_LOG(mLogger, Logger::Level::Information, Logger::Category::Body,
-             "Body " + std::to_string(mID) + ": Set linearVelocity=" + mLinearVelocity.to_string());
+             "Body " + std::to_string(mID) + ": Set linearVelocity=" + mStates.mLinearVelocities[mStateIndex].to_string());
 }
 
 // Set the angular velocity.
@@ -415,15 +477,15 @@ void RigidBody::setAngularVelocity(const Vector3& angularVelocity) {
     if (mType == BodyType::STATIC) return;
 
     // Set the angular velocity
-    mAngularVelocity = angularVelocity;
+    mStates.mAngularVelocities[mStateIndex] = angularVelocity;
 
     // If the velocity is not zero, awake the body
-    if (mAngularVelocity.lengthSquare() > decimal(0.0)) {
+    if (mStates.mAngularVelocities[mStateIndex].lengthSquare() > decimal(0.0)) {
         setIsSleeping(false);
     }
 
     RP3D_LOG(mLogger, Logger::Level::Information, Logger::Category::Body,
-             "Body " + std::to_string(mID) + ": Set angularVelocity=" + mAngularVelocity.to_string());
+             "Body " + std::to_string(mID) + ": Set angularVelocity=" + mStates.mAngularVelocities[mStateIndex].to_string());
 }
 
 // Set the current position and orientation
@@ -436,13 +498,13 @@ void RigidBody::setTransform(const Transform& transform) {
     // Update the transform of the body
     mTransform = transform;
 
-    const Vector3 oldCenterOfMass = mCenterOfMassWorld;
+    const Vector3 oldCenterOfMass = mStates.mCentersOfMassWorld[mStateIndex];
 
     // Compute the new center of mass in world-space coordinates
-    mCenterOfMassWorld = mTransform * mCenterOfMassLocal;
+    mStates.mCentersOfMassWorld[mStateIndex] = mTransform * mCenterOfMassLocal;
 
     // Update the linear velocity of the center of mass
-    mLinearVelocity += mAngularVelocity.cross(mCenterOfMassWorld - oldCenterOfMass);
+    mStates.mLinearVelocities[mStateIndex] += mStates.mAngularVelocities[mStateIndex].cross(mStates.mCentersOfMassWorld[mStateIndex] - oldCenterOfMass);
 
     // Update the world inverse inertia tensor
     updateInertiaTensorInverseWorld();
@@ -454,21 +516,41 @@ void RigidBody::setTransform(const Transform& transform) {
              "Body " + std::to_string(mID) + ": Set transform=" + mTransform.to_string());
 }
 
+// Move the body by the opposite of the displacement of the origin of the world
+/// The velocities, the orientation and the inertia tensor of the body do not change.
+/**
+ * @param shift The displacement of the origin of the world (in the old world-space coordinates)
+ */
+void RigidBody::shiftOrigin(const Vector3& shift) {
+
+    mTransform.setPosition(mTransform.getPosition() - shift);
+    mStates.mCentersOfMassWorld[mStateIndex] -= shift;
+
+    Transform& snapshotTransform = mStates.mSnapshotTransforms[mStateIndex];
+    snapshotTransform.setPosition(snapshotTransform.getPosition() - shift);
+
+    Transform& previousTransform = mStates.mPreviousTransforms[mStateIndex];
+    previousTransform.setPosition(previousTransform.getPosition() - shift);
+}
+
 // Recompute the center of mass, total mass and inertia tensor of the body using all
 // the collision shapes attached to the body.
 void RigidBody::recomputeMassInformation() {
 
+    // The joints of the body must recompute their solver data
+    invalidateJointsSolverData();
+
     mInitMass = decimal(0.0);
     mMassInverse = decimal(0.0);
     if (!mIsInertiaTensorSetByUser) mInertiaTensorLocalInverse.setToZero();
-    if (!mIsInertiaTensorSetByUser) mInertiaTensorInverseWorld.setToZero();
+    if (!mIsInertiaTensorSetByUser) mStates.mInertiaTensorsInverseWorld[mStateIndex].setToZero();
     if (!mIsCenterOfMassSetByUser) mCenterOfMassLocal.setToZero();
     Matrix3x3 inertiaTensorLocal;
     inertiaTensorLocal.setToZero();
 
     // If it is a STATIC or a KINEMATIC body
     if (mType == BodyType::STATIC || mType == BodyType::KINEMATIC) {
-        mCenterOfMassWorld = mTransform.getPosition();
+        mStates.mCentersOfMassWorld[mStateIndex] = mTransform.getPosition();
         return;
     }
 
@@ -487,18 +569,18 @@ void RigidBody::recomputeMassInformation() {
         mMassInverse = decimal(1.0) / mInitMass;
     }
     else {
-        mCenterOfMassWorld = mTransform.getPosition();
+        mStates.mCentersOfMassWorld[mStateIndex] = mTransform.getPosition();
         return;
     }
 
     // Compute the center of mass
-    const Vector3 oldCenterOfMass = mCenterOfMassWorld;
+    const Vector3 oldCenterOfMass = mStates.mCentersOfMassWorld[mStateIndex];
 
     if (!mIsCenterOfMassSetByUser) {
         mCenterOfMassLocal *= mMassInverse;
     }
 
-    mCenterOfMassWorld = mTransform * mCenterOfMassLocal;
+    mStates.mCentersOfMassWorld[mStateIndex] = mTransform * mCenterOfMassLocal;
 
     if (!mIsInertiaTensorSetByUser) {
 
@@ -538,7 +620,16 @@ void RigidBody::recomputeMassInformation() {
     updateInertiaTensorInverseWorld();
 
     // Update the linear velocity of the center of mass
-    mLinearVelocity += mAngularVelocity.cross(mCenterOfMassWorld - oldCenterOfMass);
+    mStates.mLinearVelocities[mStateIndex] += mStates.mAngularVelocities[mStateIndex].cross(mStates.mCentersOfMassWorld[mStateIndex] - oldCenterOfMass);
+}
+
+// Invalidate the solver data cached by the joints of the body after a change of its mass properties
+/// The joints recompute the Jacobians and mass matrices of their constraints at the next step
+void RigidBody::invalidateJointsSolverData() {
+
+    for (JointListElement* element = mJointsList; element != nullptr; element = element->next) {
+        element->joint->mIsSolverDataCached = false;
+    }
 }
 
 // Update the broad-phase state for this body (because it has moved for instance)
@@ -547,7 +638,7 @@ void RigidBody::updateBroadPhaseState() const {
     RP3D_PROFILE("RigidBody::updateBroadPhaseState()", mProfiler);
 
     DynamicsWorld& world = static_cast<DynamicsWorld&>(mWorld);
- 	 const Vector3 displacement = world.mTimeStep * mLinearVelocity;
+ 	 const Vector3 displacement = world.mTimeStep * mStates.mLinearVelocities[mStateIndex];
 
     // For all the proxy collision shapes of the body
     for (ProxyShape* shape = mProxyCollisionShapes; shape != nullptr; shape = shape->mNext) {
@@ -556,8 +647,9 @@ void RigidBody::updateBroadPhaseState() const {
         AABB aabb;
         shape->getCollisionShape()->computeAABB(aabb, mTransform * shape->getLocalToBodyTransform());
 
-        // Update the broad-phase state for the proxy collision shape
-        mWorld.mCollisionDetection.updateProxyCollisionShape(shape, aabb, displacement);
+        // Update the broad-phase state for the proxy collision shape. The fat AABB of a
+        // bullet body is always recomputed so that it covers its motion during the next step
+        mWorld.mCollisionDetection.updateProxyCollisionShape(shape, aabb, displacement, mIsBullet);
     }
 }
 
@@ -30,6 +30,7 @@
 #include <cassert>
 #include "CollisionBody.h"
 #include "engine/Material.h"
+#include "engine/RigidBodyStates.h"
 #include "mathematics/mathematics.h"
 
 /// Namespace reactphysics3d
@@ -41,6 +42,58 @@ class Joint;
 class DynamicsWorld;
 class MemoryManager;
 
+// Structure RigidBodyInfo
+/**
+ * This structure is used to gather the information needed to create a rigid body
+ * with DynamicsWorld::createRigidBodies().
+ */
+struct RigidBodyInfo {
+
+    public :
+
+        // -------------------- Attributes -------------------- //
+
+        /// Transformation from the body local-space to world-space
+        Transform transform;
+
+        /// Type of the body (dynamic by default)
+        BodyType type;
+
+        /// Collision shape added to the body (no collision shape if null)
+        CollisionShape* collisionShape;
+
+        /// Transformation from the collision shape local-space to the body local-space
+        Transform shapeTransform;
+
+        /// Mass (in kilograms) of the collision shape
+        decimal mass;
+
+        /// Constructor
+        RigidBodyInfo(const Transform& bodyTransform, CollisionShape* shape = nullptr,
+                      decimal shapeMass = decimal(1.0))
+                      : transform(bodyTransform), type(BodyType::DYNAMIC), collisionShape(shape),
+                        shapeTransform(Transform::identity()), mass(shapeMass) {}
+};
+
+// Structure RigidBodiesBlock
+/**
+ * This structure is the header of a memory block where the rigid bodies created together
+ * with DynamicsWorld::createRigidBodies() are stored contiguously. The block is released
+ * when its last body is destroyed.
+ */
+struct RigidBodiesBlock {
+
+    public:
+
+        // -------------------- Attributes -------------------- //
+
+        /// Number of bodies of the block that have not been destroyed yet
+        uint nbBodies;
+
+        /// Size of the block in bytes
+        size_t nbBytes;
+};
+
 // Class RigidBody
 /**
  * This class represents a rigid body of the physics
@@ -55,6 +108,31 @@ class RigidBody : public CollisionBody {
         /// Index of the body in arrays for contact/constraint solver
         uint mArrayIndex;
 
+        /// Parent of the body in the tree of its persistent island (the body itself
+        /// if it is the root of the island)
+        RigidBody* mIslandParent;
+
+        /// Next body in the linked list of bodies of the persistent island
+        RigidBody* mIslandNextBody;
+
+        /// Last body of the linked list of bodies of the persistent island (root only)
+        RigidBody* mIslandLastBody;
+
+        /// Number of bodies in the persistent island (root only)
+        uint mIslandNbBodies;
+
+        /// True if the persistent island might be made of several groups of bodies
+        /// that are not connected anymore and should be split (root only)
+        bool mIsIslandSplitCandidate;
+
+        /// Time during which all the awake bodies of the persistent island have been
+        /// almost still (root only)
+        decimal mIslandSleepTime;
+
+        /// True if the transform of the body has been changed by the integration
+        /// since the last update of its broad-phase state
+        bool mIsTransformDirty;
+
     protected :
 
         // -------------------- Attributes -------------------- //
@@ -66,20 +144,15 @@ class RigidBody : public CollisionBody {
         /// The center of mass can therefore be different from the body origin
         Vector3 mCenterOfMassLocal;
 
-        /// Center of mass of the body in world-space coordinates
-        Vector3 mCenterOfMassWorld;
-
-        /// Linear velocity of the body
-        Vector3 mLinearVelocity;
-
-        /// Angular velocity of the body
-        Vector3 mAngularVelocity;
+        /// Store of the dynamic state (velocities, external force and torque, center of
+        /// mass and inverse inertia tensor in world-space) of the bodies of the world
+        RigidBodyStates& mStates;
 
-        /// Current external force on the body
-        Vector3 mExternalForce;
+        /// Index of the state of the body in the state store of the world
+        uint mStateIndex;
 
-        /// Current external torque on the body
-        Vector3 mExternalTorque;
+        /// Index of the body in the list of rigid bodies of the world
+        uint mRigidBodyIndex;
 
         /// Inverse Local inertia tensor of the body (in local-space) set
         /// by the user with respect to the center of mass of the body
@@ -88,15 +161,19 @@ class RigidBody : public CollisionBody {
         /// Inverse of the inertia tensor of the body
         Matrix3x3 mInertiaTensorLocalInverse;
 
-        /// Inverse of the world inertia tensor of the body
-        Matrix3x3 mInertiaTensorInverseWorld;
-
         /// Inverse of the mass of the body
         decimal mMassInverse;
 
         /// True if the gravity needs to be applied to this rigid body
         bool mIsGravityEnabled;
 
+        /// True if speculative contacts are created for this fast moving body so that
+        /// it does not tunnel through the other bodies
+        bool mIsBullet;
+
+        /// Simulation level of detail of the body (its island is simulated every 2^L steps)
+        uint mSimulationLevelOfDetail;
+
         /// Material properties of the rigid body
         Material mMaterial;
 
@@ -115,6 +192,9 @@ class RigidBody : public CollisionBody {
         /// True if the inertia tensor is set by the user
         bool mIsInertiaTensorSetByUser;
 
+        /// Memory block of the body if it has been created with other bodies (null otherwise)
+        RigidBodiesBlock* mBlock;
+
         // -------------------- Methods -------------------- //
 
         /// Remove a joint from the joints list
@@ -123,18 +203,30 @@ class RigidBody : public CollisionBody {
         /// Update the transform of the body after a change of the center of mass
         void updateTransformWithCenterOfMass();
 
+        /// Return the center of mass of the body in world-space coordinates
+        const Vector3& getCenterOfMassWorld() const;
+
         /// Update the broad-phase state for this body (because it has moved for instance)
         virtual void updateBroadPhaseState() const override;
 
         /// Update the world inverse inertia tensor of the body
         void updateInertiaTensorInverseWorld();
 
+        /// Move the body by the opposite of the displacement of the origin of the world
+        virtual void shiftOrigin(const Vector3& shift) override;
+
+        /// Make the body the only body of its persistent island
+        void resetIsland();
+
+        /// Invalidate the solver data cached by the joints of the body after a change of its mass properties
+        void invalidateJointsSolverData();
+
     public :
 
         // -------------------- Methods -------------------- //
 
         /// Constructor
-        RigidBody(const Transform& transform, CollisionWorld& world, bodyindex id);
+        RigidBody(const Transform& transform, CollisionWorld& world, RigidBodyStates& states, bodyindex id);
 
         /// Destructor
         virtual ~RigidBody() override;
@@ -166,6 +258,18 @@ class RigidBody : public CollisionBody {
         /// Set the angular velocity.
         void setAngularVelocity(const Vector3& angularVelocity);
 
+        /// Return the transform of the body when the last asynchronous step was started
+        const Transform& getSnapshotTransform() const;
+
+        /// Return the linear velocity of the body when the last asynchronous step was started
+        const Vector3& getSnapshotLinearVelocity() const;
+
+        /// Return the angular velocity of the body when the last asynchronous step was started
+        const Vector3& getSnapshotAngularVelocity() const;
+
+        /// Return the transform of the body at the beginning of the last step
+        const Transform& getPreviousTransform() const;
+
         /// Set the variable to know whether or not the body is sleeping
         virtual void setIsSleeping(bool isSleeping) override;
 
@@ -193,6 +297,18 @@ class RigidBody : public CollisionBody {
         /// Set the variable to know if the gravity is applied to this rigid body
         void enableGravity(bool isEnabled);
 
+        /// Return true if speculative contacts are created for this rigid body
+        bool isBullet() const;
+
+        /// Set the variable to know if speculative contacts are created for this rigid body
+        void setIsBullet(bool isBullet);
+
+        /// Return the simulation level of detail of the rigid body
+        uint getSimulationLevelOfDetail() const;
+
+        /// Set the simulation level of detail of the rigid body
+        void setSimulationLevelOfDetail(uint level);
+
         /// Return a reference to the material properties of the rigid body
         Material& getMaterial();
 
@@ -249,10 +365,17 @@ class RigidBody : public CollisionBody {
 
         friend class DynamicsWorld;
         friend class ContactSolver;
+        friend class ConstraintSolver;
+        friend class ArticulationSolver;
+        friend class PositionBasedSolver;
+        friend class CollisionDetection;
         friend class BallAndSocketJoint;
         friend class SliderJoint;
         friend class HingeJoint;
         friend class FixedJoint;
+        friend class Joint;
+        friend class RigidBodyStates;
+        friend class Vehicle;
 };
 
 // Method that return the mass of the body
@@ -268,7 +391,7 @@ inline decimal RigidBody::getMass() const {
  * @return The linear velocity vector of the body
  */
 inline Vector3 RigidBody::getLinearVelocity() const {
-    return mLinearVelocity;
+    return mStates.mLinearVelocities[mStateIndex];
 }
 
 // Return the angular velocity of the body
@@ -276,7 +399,44 @@ inline Vector3 RigidBody::getLinearVelocity() const {
  * @return The angular velocity vector of the body
  */
 inline Vector3 RigidBody::getAngularVelocity() const {
-    return mAngularVelocity;
+    return mStates.mAngularVelocities[mStateIndex];
+}
+
+// Return the transform of the body when the last asynchronous step was started
+/// This snapshot can be read while DynamicsWorld::startUpdate() is running
+/**
+ * @return The transform of the body at the beginning of the last asynchronous step
+ */
+inline const Transform& RigidBody::getSnapshotTransform() const {
+    return mStates.mSnapshotTransforms[mStateIndex];
+}
+
+// Return the linear velocity of the body when the last asynchronous step was started
+/// This snapshot can be read while DynamicsWorld::startUpdate() is running
+/**
+ * @return The linear velocity of the body at the beginning of the last asynchronous step
+ */
+inline const Vector3& RigidBody::getSnapshotLinearVelocity() const {
+    return mStates.mSnapshotLinearVelocities[mStateIndex];
+}
+
+// Return the angular velocity of the body when the last asynchronous step was started
+/// This snapshot can be read while DynamicsWorld::startUpdate() is running
+/**
+ * @return The angular velocity of the body at the beginning of the last asynchronous step
+ */
+inline const Vector3& RigidBody::getSnapshotAngularVelocity() const {
+    return mStates.mSnapshotAngularVelocities[mStateIndex];
+}
+
+// Return the transform of the body at the beginning of the last step
+/// This transform is only updated if the interpolation of the transforms is enabled in the
+/// settings of the world (see WorldSettings::isTransformInterpolationEnabled)
+/**
+ * @return The transform of the body at the beginning of the last step
+ */
+inline const Transform& RigidBody::getPreviousTransform() const {
+    return mStates.mPreviousTransforms[mStateIndex];
 }
 
 // Get the inverse local inertia tensor of the body (in body coordinates)
@@ -297,7 +457,7 @@ inline const Matrix3x3& RigidBody::getInverseInertiaTensorLocal() const {
 inline Matrix3x3 RigidBody::getInertiaTensorInverseWorld() const {
 
     // Compute and return the inertia tensor in world coordinates
-    return mInertiaTensorInverseWorld;
+    return mStates.mInertiaTensorsInverseWorld[mStateIndex];
 }
 
 // Update the world inverse inertia tensor of the body
@@ -308,7 +468,7 @@ inline Matrix3x3 RigidBody::getInertiaTensorInverseWorld() const {
 /// current orientation quaternion of the body
 inline void RigidBody::updateInertiaTensorInverseWorld() {
     Matrix3x3 orientation = mTransform.getOrientation().getMatrix();
-    mInertiaTensorInverseWorld = orientation * mInertiaTensorLocalInverse * orientation.getTranspose();
+    mStates.mInertiaTensorsInverseWorld[mStateIndex] = orientation * mInertiaTensorLocalInverse * orientation.getTranspose();
 }
 
 // Return true if the gravity needs to be applied to this rigid body
@@ -319,6 +479,22 @@ inline bool RigidBody::isGravityEnabled() const {
     return mIsGravityEnabled;
 }
 
+// Return true if speculative contacts are created for this rigid body
+/**
+ * @return True if the body is a bullet body
+ */
+inline bool RigidBody::isBullet() const {
+    return mIsBullet;
+}
+
+// Return the simulation level of detail of the rigid body
+/**
+ * @return The simulation level of detail of the body (zero if it is simulated at every step)
+ */
+inline uint RigidBody::getSimulationLevelOfDetail() const {
+    return mSimulationLevelOfDetail;
+}
+
 // Return a reference to the material properties of the rigid body
 /**
  * @return A reference to the material of the body
@@ -363,13 +539,13 @@ inline JointListElement* RigidBody::getJointsList() {
 inline void RigidBody::setIsSleeping(bool isSleeping) {
 
     if (isSleeping) {
-        mLinearVelocity.setToZero();
-        mAngularVelocity.setToZero();
-        mExternalForce.setToZero();
-        mExternalTorque.setToZero();
+        mStates.mLinearVelocities[mStateIndex].setToZero();
+        mStates.mAngularVelocities[mStateIndex].setToZero();
+        mStates.mExternalForces[mStateIndex].setToZero();
+        mStates.mExternalTorques[mStateIndex].setToZero();
     }
 
-    Body::setIsSleeping(isSleeping);
+    CollisionBody::setIsSleeping(isSleeping);
 }
 
 // Apply an external force to the body at its center of mass.
@@ -391,7 +567,7 @@ inline void RigidBody::applyForceToCenterOfMass(const Vector3& force) {
     }
 
     // Add the force
-    mExternalForce += force;
+    mStates.mExternalForces[mStateIndex] += force;
 }
 
 // Apply an external force to the body at a given point (in world-space coordinates).
@@ -416,8 +592,8 @@ inline void RigidBody::applyForce(const Vector3& force, const Vector3& point) {
     }
 
     // Add the force and torque
-    mExternalForce += force;
-    mExternalTorque += (point - mCenterOfMassWorld).cross(force);
+    mStates.mExternalForces[mStateIndex] += force;
+    mStates.mExternalTorques[mStateIndex] += (point - mStates.mCentersOfMassWorld[mStateIndex]).cross(force);
 }
 
 // Apply an external torque to the body.
@@ -439,14 +615,29 @@ inline void RigidBody::applyTorque(const Vector3& torque) {
     }
 
     // Add the torque
-    mExternalTorque += torque;
+    mStates.mExternalTorques[mStateIndex] += torque;
+}
+
+// Return the center of mass of the body in world-space coordinates
+inline const Vector3& RigidBody::getCenterOfMassWorld() const {
+    return mStates.mCentersOfMassWorld[mStateIndex];
 }
 
 /// Update the transform of the body after a change of the center of mass
 inline void RigidBody::updateTransformWithCenterOfMass() {
 
     // Translate the body according to the translation of the center of mass position
-    mTransform.setPosition(mCenterOfMassWorld - mTransform.getOrientation() * mCenterOfMassLocal);
+    mTransform.setPosition(mStates.mCentersOfMassWorld[mStateIndex] - mTransform.getOrientation() * mCenterOfMassLocal);
+}
+
+// Make the body the only body of its persistent island
+inline void RigidBody::resetIsland() {
+    mIslandParent = this;
+    mIslandNextBody = nullptr;
+    mIslandLastBody = this;
+    mIslandNbBodies = 1;
+    mIsIslandSplitCandidate = false;
+    mIslandSleepTime = decimal(0.0);
 }
 
 }
@@ -54,7 +54,7 @@ CollisionCallback::CollisionCallbackInfo::CollisionCallbackInfo(OverlappingPair*
         // Add the contact manifold at the beginning of the linked
         // list of contact manifolds of the first body
         ContactManifoldListElement* element = new (mMemoryManager.allocate(MemoryManager::AllocationType::Pool,
-                                                                           sizeof(ContactManifoldListElement)))
+                                                                           sizeof(ContactManifoldListElement), MemoryTag::ContactManifolds))
                                                       ContactManifoldListElement(contactManifold,
                                                                          contactManifoldElements);
         contactManifoldElements = element;
@@ -75,7 +75,7 @@ CollisionCallback::CollisionCallbackInfo::~CollisionCallbackInfo() {
         // Delete and release memory
         element->~ContactManifoldListElement();
         mMemoryManager.release(MemoryManager::AllocationType::Pool, element,
-                               sizeof(ContactManifoldListElement));
+                               sizeof(ContactManifoldListElement), MemoryTag::ContactManifolds);
 
         element = nextElement;
     }
@@ -26,6 +26,9 @@
 #ifndef REACTPHYSICS3D_COLLISION_CALLBACK_H
 #define REACTPHYSICS3D_COLLISION_CALLBACK_H
 
+// Libraries
+#include "mathematics/Vector3.h"
+
 /// ReactPhysics3D namespace
 namespace reactphysics3d {
 
@@ -37,6 +40,32 @@ class CollisionBody;
 class ProxyShape;
 class MemoryManager;
 
+// Structure ContactHit
+/**
+ * This structure contains a contact point reported by a collision test between two bodies
+ * that fills an array of hits (see CollisionWorld::testCollision()).
+ */
+struct ContactHit {
+
+    /// Pointer to the proxy shape of the first body
+    ProxyShape* proxyShape1;
+
+    /// Pointer to the proxy shape of the second body
+    ProxyShape* proxyShape2;
+
+    /// Contact point on the first proxy shape (in world-space)
+    Vector3 worldPoint1;
+
+    /// Contact point on the second proxy shape (in world-space)
+    Vector3 worldPoint2;
+
+    /// Normal of the contact (in world-space, from the first proxy shape toward the second one)
+    Vector3 worldNormal;
+
+    /// Penetration depth of the contact
+    decimal penetrationDepth;
+};
+
 // Class CollisionCallback
 /**
  * This class can be used to register a callback for collision test queries.
@@ -30,6 +30,8 @@
 #include "body/Body.h"
 #include "collision/shapes/BoxShape.h"
 #include "collision/shapes/ConcaveShape.h"
+#include "collision/shapes/CompoundShape.h"
+#include "collision/shapes/ConcaveMeshShape.h"
 #include "body/RigidBody.h"
 #include "configuration.h"
 #include "collision/CollisionCallback.h"
@@ -41,20 +43,62 @@
 #include "utils/Profiler.h"
 #include "engine/EventListener.h"
 #include "collision/RaycastInfo.h"
+#include "collision/SweepInfo.h"
+#include "collision/DistanceInfo.h"
+#include "collision/shapes/SphereShape.h"
+#include "collision/shapes/TriangleShape.h"
+#include "engine/TaskScheduler.h"
+#include "engine/Timer.h"
+#include "engine/WorldState.h"
+#include "collision/broadphase/AABBTreeBroadPhaseAlgorithm.h"
+#include "collision/broadphase/SweepAndPruneBroadPhaseAlgorithm.h"
+#include "collision/broadphase/GridBroadPhaseAlgorithm.h"
 #include <cassert>
+#include <atomic>
+#include <algorithm>
 
 // We want to use the ReactPhysics3D namespace
 using namespace reactphysics3d;
 using namespace std;
 
+// Static variables initialization
+const decimal CollisionDetection::POINT_QUERY_RADIUS = decimal(0.01);
+const uint CollisionDetection::POINTS_INSIDE_PACKET_SIZE;
 
 // Constructor
 CollisionDetection::CollisionDetection(CollisionWorld* world, MemoryManager& memoryManager)
                    : mMemoryManager(memoryManager), mWorld(world), mNarrowPhaseInfoList(nullptr),
-                     mOverlappingPairs(mMemoryManager.getPoolAllocator()), mBroadPhaseAlgorithm(*this),
-                     mNoCollisionPairs(mMemoryManager.getPoolAllocator()), mIsCollisionShapesAdded(false) {
+                     mOverlappingPairs(mMemoryManager.getPoolAllocator(MemoryTag::BroadPhase)), mBroadPhaseAlgorithm(nullptr),
+                     mQueryOnlyTree(mMemoryManager.getPoolAllocator(MemoryTag::BroadPhase), DYNAMIC_TREE_AABB_GAP),
+                     mNoCollisionPairs(mMemoryManager.getPoolAllocator(MemoryTag::BroadPhase)), mIsCollisionShapesAdded(false),
+                     mOrderedOverlappingPairs(mMemoryManager.getPoolAllocator(MemoryTag::NarrowPhase)),
+                     mContactEvents(mMemoryManager.getPoolAllocator(MemoryTag::NarrowPhase)),
+                     mContactManifolds(mMemoryManager.getPoolAllocator(MemoryTag::NarrowPhase)),
+                     mMiddlePhaseTriangles(mMemoryManager.getPoolAllocator(MemoryTag::NarrowPhase)),
+                     mBodiesContactManifolds(mMemoryManager.getPoolAllocator(MemoryTag::ContactManifolds)), mIsBodyWokenUp(false), mSpeculativeContactsTimeStep(decimal(0.0)),
+                     mNarrowPhasePairCosts(mMemoryManager.getPoolAllocator(MemoryTag::NarrowPhase)),
+                     mBroadPhaseTime(0.0), mNarrowPhaseTime(0.0) {
+
+    // Create the broad-phase algorithm selected in the world settings
+    if (world->mConfig.broadPhaseType == BroadPhaseType::SWEEP_AND_PRUNE) {
+        void* allocatedMemory = mMemoryManager.allocate(MemoryManager::AllocationType::Pool,
+                                                        sizeof(SweepAndPruneBroadPhaseAlgorithm), MemoryTag::BroadPhase);
+        mBroadPhaseAlgorithm = new (allocatedMemory) SweepAndPruneBroadPhaseAlgorithm(*this, world->mConfig);
+    }
+    else if (world->mConfig.broadPhaseType == BroadPhaseType::GRID) {
+        void* allocatedMemory = mMemoryManager.allocate(MemoryManager::AllocationType::Pool,
+                                                        sizeof(GridBroadPhaseAlgorithm), MemoryTag::BroadPhase);
+        mBroadPhaseAlgorithm = new (allocatedMemory) GridBroadPhaseAlgorithm(*this, world->mConfig);
+    }
+    else {
+        void* allocatedMemory = mMemoryManager.allocate(MemoryManager::AllocationType::Pool,
+                                                        sizeof(AABBTreeBroadPhaseAlgorithm), MemoryTag::BroadPhase);
+        mBroadPhaseAlgorithm = new (allocatedMemory) AABBTreeBroadPhaseAlgorithm(*this, world->mConfig);
+    }
 
     // Set the default collision dispatch configuration
+    mDefaultCollisionDispatch.setIsEPAEnabled(world->mConfig.isEPAEnabled);
+    mDefaultCollisionDispatch.setIsGJKSimplexWarmStartEnabled(world->mConfig.isGJKSimplexWarmStartEnabled);
     setCollisionDispatch(&mDefaultCollisionDispatch);
 
     // Fill-in the collision detection matrix with algorithms
@@ -68,20 +112,62 @@ CollisionDetection::CollisionDetection(CollisionWorld* world, MemoryManager& mem
 
 }
 
+// Destructor
+CollisionDetection::~CollisionDetection() {
+
+    // Destroy the broad-phase algorithm
+    const size_t broadPhaseSize = mBroadPhaseAlgorithm->getSizeInBytes();
+    mBroadPhaseAlgorithm->~BroadPhaseAlgorithm();
+    mMemoryManager.release(MemoryManager::AllocationType::Pool, mBroadPhaseAlgorithm, broadPhaseSize, MemoryTag::BroadPhase);
+}
+
 // Compute the collision detection
 void CollisionDetection::computeCollisionDetection() {
 
     RP3D_PROFILE("CollisionDetection::computeCollisionDetection()", mProfiler);
-	    
+
+    computeCollisionDetectionBroadPhase();
+    computeCollisionDetectionNarrowPhase();
+}
+
+// Compute the broad-phase of the collision detection of a step
+/// This is the first part of computeCollisionDetection(). It must be followed by a call to
+/// computeCollisionDetectionNarrowPhase().
+void CollisionDetection::computeCollisionDetectionBroadPhase() {
+
+    mNarrowPhaseStatistics = NarrowPhaseStatistics();
+    mContactEvents.clear();
+
+    // Reset the costs of the pairs and of the types of shapes of the previous collision detection
+    if (mWorld->mConfig.isNarrowPhaseCostsEnabled) {
+        mNarrowPhasePairCosts.clear();
+        for (uint i=0; i < NB_COLLISION_SHAPE_TYPES * NB_COLLISION_SHAPE_TYPES; i++) {
+            mNarrowPhaseShapeTypeCosts[i] = NarrowPhaseShapeTypeCost();
+        }
+    }
+
+    const uint64 startTicks = Timer::getCurrentTicks();
+
     // Compute the broad-phase collision detection
     computeBroadPhase();
 
+    mBroadPhaseTime = double(Timer::getCurrentTicks() - startTicks) * 1.0e-9;
+}
+
+// Compute the middle-phase and the narrow-phase of the collision detection of a step
+/// This is the second part of computeCollisionDetection()
+void CollisionDetection::computeCollisionDetectionNarrowPhase() {
+
+    const uint64 startTicks = Timer::getCurrentTicks();
+
     // Compute the middle-phase collision detection
     computeMiddlePhase();
-    
+
     // Compute the narrow-phase collision detection
     computeNarrowPhase();
 
+    mNarrowPhaseTime = double(Timer::getCurrentTicks() - startTicks) * 1.0e-9;
+
     // Reset the linked list of narrow-phase info
     mNarrowPhaseInfoList = nullptr;
 }
@@ -97,7 +183,7 @@ void CollisionDetection::computeBroadPhase() {
         // Ask the broad-phase to recompute the overlapping pairs of collision
         // shapes. This call can only add new overlapping pairs in the collision
         // detection.
-        mBroadPhaseAlgorithm.computeOverlappingPairs(mMemoryManager);
+        mBroadPhaseAlgorithm->computeOverlappingPairs(mMemoryManager);
     }
 }
 
@@ -106,11 +192,40 @@ void CollisionDetection::computeMiddlePhase() {
 
     RP3D_PROFILE("CollisionDetection::computeMiddlePhase()", mProfiler);
 
-    // For each possible collision pair of bodies
-    Map<Pair<uint, uint>, OverlappingPair*>::Iterator it;
-    for (it = mOverlappingPairs.begin(); it != mOverlappingPairs.end(); ) {
+    // If a body has been woken up, the parked pairs of the awake bodies become active again
+    if (mIsBodyWokenUp) {
+        unparkPairsOfAwakeBodies();
+    }
+
+    const bool isNarrowPhaseCostsEnabled = mWorld->mConfig.isNarrowPhaseCostsEnabled;
+
+    // If a task scheduler can run the middle-phase of the concave and compound pairs in parallel,
+    // the narrow-phase infos of all the pairs are kept per pair until the workers are done
+    TaskScheduler* taskScheduler = getTaskScheduler();
+    const bool isParallel = taskScheduler != nullptr && taskScheduler->getNbWorkers() > 1;
+    const uint maxNbMiddlePhasePairs = isParallel ? mOverlappingPairs.getNbActivePairs() : 0;
+    MemoryAllocator& frameAllocator = mMemoryManager.getSingleFrameAllocator(MemoryTag::NarrowPhase);
+    MiddlePhasePair* middlePhasePairs = nullptr;
+    uint* workerPairsIndices = nullptr;
+    uint nbMiddlePhasePairs = 0;
+    uint nbWorkerPairs = 0;
+    if (maxNbMiddlePhasePairs > 0) {
+        middlePhasePairs = static_cast<MiddlePhasePair*>(frameAllocator.allocate(sizeof(MiddlePhasePair) * maxNbMiddlePhasePairs));
+        workerPairsIndices = static_cast<uint*>(frameAllocator.allocate(sizeof(uint) * maxNbMiddlePhasePairs));
+    }
+
+    // For each active pair of bodies
+    uint i = 0;
+    while (i < mOverlappingPairs.getNbActivePairs()) {
 
-        OverlappingPair* pair = it->second;
+        OverlappingPair* pair = mOverlappingPairs.getPair(i);
+
+        // The pair of two sleeping or static bodies is parked with its contacts (the last active
+        // pair is moved at its index)
+        if (!pair->isActive()) {
+            mOverlappingPairs.park(i);
+            continue;
+        }
 
         // Make all the contact manifolds and contact points of the pair obsolete
         pair->makeContactsObsolete();
@@ -125,19 +240,27 @@ void CollisionDetection::computeMiddlePhase() {
         assert(shape2->getBroadPhaseId() != -1);
         assert(shape1->getBroadPhaseId() != shape2->getBroadPhaseId());
 
-        // Check if the two shapes are still overlapping. Otherwise, we destroy the
-        // overlapping pair
-        if (!mBroadPhaseAlgorithm.testOverlappingShapes(shape1, shape2)) {
+        // The broad-phase reports again all the overlapping shapes of a shape that has moved.
+        // Therefore, if the pair has not been reported since one of its shapes has moved, the
+        // two shapes are not overlapping anymore and we destroy the overlapping pair
+        const uint64 lastMovedStamp = std::max(shape1->mBroadPhaseMovedStamp, shape2->mBroadPhaseMovedStamp);
+        if (mOverlappingPairs.getStamp(i) < lastMovedStamp) {
+
+            if (pair->hadContacts()) {
+                addContactEvent(pair, pair->isTrigger() ? ContactEventType::TRIGGER_EXIT : ContactEventType::CONTACT_END);
+            }
 
             // Destroy the overlapping pair
-            it->second->~OverlappingPair();
+            pair->~OverlappingPair();
+
+            mWorld->mMemoryManager.release(MemoryManager::AllocationType::Pool, pair, sizeof(OverlappingPair), MemoryTag::BroadPhase);
 
-            mWorld->mMemoryManager.release(MemoryManager::AllocationType::Pool, it->second, sizeof(OverlappingPair));
-            it = mOverlappingPairs.remove(it);
+            // The last pair is moved at the index of the removed one
+            mOverlappingPairs.removeAt(i);
             continue;
         }
         else {
-            ++it;
+            i++;
         }
 
         // Check if the collision filtering allows collision between the two shapes
@@ -147,255 +270,2251 @@ void CollisionDetection::computeMiddlePhase() {
             CollisionBody* const body1 = shape1->getBody();
             CollisionBody* const body2 = shape2->getBody();
 
-            // Check that at least one body is awake and not static
-            bool isBody1Active = !body1->isSleeping() && body1->getType() != BodyType::STATIC;
-            bool isBody2Active = !body2->isSleeping() && body2->getType() != BodyType::STATIC;
-            if (!isBody1Active && !isBody2Active) continue;
-
             // Check if the bodies are in the set of bodies that cannot collide between each other
             bodyindexpair bodiesIndex = OverlappingPair::computeBodiesIndexPair(body1, body2);
             if (mNoCollisionPairs.contains(bodiesIndex) > 0) continue;
 
+            // For a trigger, we only test if the two shapes intersect without computing contacts
+            if (pair->isTrigger()) {
+
+                const uint64 startTicks = isNarrowPhaseCostsEnabled ? Timer::getCurrentTicks() : 0;
+
+                const bool isOverlapping = testShapesOverlap(mGJKAlgorithm, shape1->getCollisionShape(),
+                                                             shape1->getLocalToWorldTransform(),
+                                                             shape2->getCollisionShape(),
+                                                             shape2->getLocalToWorldTransform());
+
+                if (isNarrowPhaseCostsEnabled) {
+                    NarrowPhasePairCost& pairCost = mNarrowPhasePairCosts[addNarrowPhasePairCost(pair)];
+                    pairCost.middlePhaseTime = double(Timer::getCurrentTicks() - startTicks) * 1.0e-9;
+                    pairCost.nbTests = 1;
+                }
+                if (isOverlapping != pair->hadContacts()) {
+                    addContactEvent(pair, isOverlapping ? ContactEventType::TRIGGER_ENTER : ContactEventType::TRIGGER_EXIT);
+                    pair->setHadContacts(isOverlapping);
+                }
+
+                continue;
+            }
+
 			bool isShape1Convex = shape1->getCollisionShape()->isConvex();
 			bool isShape2Convex = shape2->getCollisionShape()->isConvex();
+            const bool hasCompoundShape = shape1->getCollisionShape()->getType() == CollisionShapeType::COMPOUND ||
+                                          shape2->getCollisionShape()->getType() == CollisionShapeType::COMPOUND;
 
             // If both shapes are convex
             if (isShape1Convex && isShape2Convex) {
 
+                // If the shapes have almost not moved, we reuse their contacts of the
+                // previous frame instead of computing the narrow-phase
+                if (mWorld->mConfig.isContactReuseEnabled && pair->reuseContacts()) {
+                    mNarrowPhaseStatistics.nbReusedContactPairs++;
+                    continue;
+                }
+
                 // No middle-phase is necessary, simply create a narrow phase info
                 // for the narrow-phase collision detection
-                NarrowPhaseInfo* firstNarrowPhaseInfo = mNarrowPhaseInfoList;
-                mNarrowPhaseInfoList = new (mMemoryManager.allocate(MemoryManager::AllocationType::Frame, sizeof(NarrowPhaseInfo)))
+                NarrowPhaseInfo* narrowPhaseInfo = new (mMemoryManager.allocate(MemoryManager::AllocationType::Frame, sizeof(NarrowPhaseInfo), MemoryTag::NarrowPhase))
                                        NarrowPhaseInfo(pair, shape1->getCollisionShape(),
                                        shape2->getCollisionShape(), shape1->getLocalToWorldTransform(),
-                                       shape2->getLocalToWorldTransform(), mMemoryManager.getSingleFrameAllocator());
-                mNarrowPhaseInfoList->next = firstNarrowPhaseInfo;
+                                       shape2->getLocalToWorldTransform(), mMemoryManager.getSingleFrameAllocator(MemoryTag::NarrowPhase));
 
+                if (isNarrowPhaseCostsEnabled) {
+                    narrowPhaseInfo->pairCostIndex = addNarrowPhasePairCost(pair);
+                }
+
+                if (isParallel) {
+                    MiddlePhasePair* middlePhasePair = new (middlePhasePairs + nbMiddlePhasePairs) MiddlePhasePair();
+                    middlePhasePair->pair = pair;
+                    middlePhasePair->narrowPhaseInfos = narrowPhaseInfo;
+                    nbMiddlePhasePairs++;
+                }
+                else {
+                    narrowPhaseInfo->next = mNarrowPhaseInfoList;
+                    mNarrowPhaseInfoList = narrowPhaseInfo;
+                }
             }
-            // Concave vs Convex algorithm
-            else if ((!isShape1Convex && isShape2Convex) || (!isShape2Convex && isShape1Convex)) {
+            // Concave vs Convex algorithm or compound shape
+            else if (hasCompoundShape || (!isShape1Convex && isShape2Convex) || (!isShape2Convex && isShape1Convex)) {
+
+                // The triangles separated from the convex shape are not culled if a bullet
+                // body might need a speculative contact with them
+                bool isTriangleCullingEnabled = true;
+                if (mSpeculativeContactsTimeStep > decimal(0.0)) {
+                    isTriangleCullingEnabled = !static_cast<RigidBody*>(body1)->isBullet() &&
+                                               !static_cast<RigidBody*>(body2)->isBullet();
+                }
+
+                // The middle-phase of the pair is computed later by a worker (the last frame
+                // collision infos of the pair are then kept until its narrow-phase infos are added)
+                if (isParallel) {
+                    MiddlePhasePair* middlePhasePair = new (middlePhasePairs + nbMiddlePhasePairs) MiddlePhasePair();
+                    middlePhasePair->pair = pair;
+                    middlePhasePair->isComputedByWorker = true;
+                    middlePhasePair->isTriangleCullingEnabled = isTriangleCullingEnabled;
+                    pair->setIsLastFrameInfoAdditionDeferred(true);
+                    workerPairsIndices[nbWorkerPairs] = nbMiddlePhasePairs;
+                    nbWorkerPairs++;
+                    nbMiddlePhasePairs++;
+                    continue;
+                }
+
+                const uint64 startTicks = isNarrowPhaseCostsEnabled ? Timer::getCurrentTicks() : 0;
 
                 NarrowPhaseInfo* narrowPhaseInfo = nullptr;
-                computeConvexVsConcaveMiddlePhase(pair, mMemoryManager.getSingleFrameAllocator(), &narrowPhaseInfo);
+                uint nbCulledTriangles;
+                if (hasCompoundShape) {
+                    nbCulledTriangles = computeCompoundMiddlePhase(pair, frameAllocator, mMiddlePhaseTriangles,
+                                                                   &narrowPhaseInfo, isTriangleCullingEnabled);
+                }
+                else {
+                    nbCulledTriangles = computeConvexVsConcaveMiddlePhase(pair, frameAllocator, mMiddlePhaseTriangles,
+                                                                          &narrowPhaseInfo, isTriangleCullingEnabled);
+                }
+                mNarrowPhaseStatistics.nbCulledTriangles += nbCulledTriangles;
+
+                // The narrow-phase tests and the other triangles are added to the cost of the
+                // pair by the narrow-phase
+                uint pairCostIndex = 0;
+                if (isNarrowPhaseCostsEnabled) {
+                    pairCostIndex = addNarrowPhasePairCost(pair);
+                    NarrowPhasePairCost& pairCost = mNarrowPhasePairCosts[pairCostIndex];
+                    pairCost.middlePhaseTime = double(Timer::getCurrentTicks() - startTicks) * 1.0e-9;
+                    pairCost.nbTriangles = nbCulledTriangles;
+                }
 
                 // Add all the narrow-phase info object reported by the callback into the
                 // list of all the narrow-phase info object
                 while (narrowPhaseInfo != nullptr) {
                     NarrowPhaseInfo* next = narrowPhaseInfo->next;
                     narrowPhaseInfo->next = mNarrowPhaseInfoList;
+                    narrowPhaseInfo->pairCostIndex = pairCostIndex;
                     mNarrowPhaseInfoList = narrowPhaseInfo;
 
-                    narrowPhaseInfo = next;
-                }
-            }
-            // Concave vs Concave shape
-            else {
-                // Not handled
-                continue;
-            }
+                    narrowPhaseInfo = next;
+                }
+            }
+            // Concave vs Concave shape
+            else {
+                // Not handled
+                continue;
+            }
+
+            // Remove the obsolete last frame collision infos
+            pair->clearObsoleteLastFrameCollisionInfos();
+        }
+    }
+
+    if (maxNbMiddlePhasePairs > 0) {
+
+        if (nbWorkerPairs > 0) {
+            computeMiddlePhaseInParallel(*taskScheduler, middlePhasePairs, workerPairsIndices, nbWorkerPairs);
+        }
+        addMiddlePhasePairsNarrowPhaseInfos(middlePhasePairs, nbMiddlePhasePairs);
+
+        frameAllocator.release(workerPairsIndices, sizeof(uint) * maxNbMiddlePhasePairs);
+        frameAllocator.release(middlePhasePairs, sizeof(MiddlePhasePair) * maxNbMiddlePhasePairs);
+    }
+}
+
+// Compute the middle-phase of the concave and compound pairs in parallel
+/// The pairs are split into chunks of MIDDLE_PHASE_CHUNK_SIZE pairs. Each worker takes the next
+/// chunk until all the pairs are computed. A worker creates the narrow-phase infos and the
+/// triangle shapes in its own single frame allocator (they are released with the narrow-phase
+/// infos after the narrow-phase) and reports the triangles into its own triangle batch. The
+/// narrow-phase infos of each pair are kept in the list of the pair.
+/**
+ * @param taskScheduler Task scheduler that runs the workers
+ * @param middlePhasePairs Array of the pairs of the middle-phase
+ * @param workerPairsIndices Indices of the pairs computed by the workers in the array of pairs
+ * @param nbWorkerPairs Number of pairs computed by the workers
+ */
+void CollisionDetection::computeMiddlePhaseInParallel(TaskScheduler& taskScheduler, MiddlePhasePair* middlePhasePairs,
+                                                      const uint* workerPairsIndices, uint nbWorkerPairs) {
+
+    RP3D_PROFILE("CollisionDetection::computeMiddlePhaseInParallel()", mProfiler);
+
+    const bool isNarrowPhaseCostsEnabled = mWorld->mConfig.isNarrowPhaseCostsEnabled;
+    const uint nbChunks = (nbWorkerPairs + MIDDLE_PHASE_CHUNK_SIZE - 1) / MIDDLE_PHASE_CHUNK_SIZE;
+    const uint nbWorkers = std::min(taskScheduler.getNbWorkers(), nbChunks);
+
+    mMemoryManager.createWorkerAllocators(nbWorkers);
+
+    std::atomic<uint> nextChunkIndex(0);
+
+    taskScheduler.parallelFor(nbWorkers, [&](uint workerIndex) {
+
+        SingleFrameAllocator& allocator = mMemoryManager.getWorkerSingleFrameAllocator(workerIndex);
+        MiddlePhaseTriangleBatch triangles(mMemoryManager.getWorkerPoolAllocator(workerIndex));
+
+        // Take the next chunk until all the pairs are computed
+        uint chunkIndex = nextChunkIndex.fetch_add(1);
+        while (chunkIndex < nbChunks) {
+
+            const uint startIndex = chunkIndex * MIDDLE_PHASE_CHUNK_SIZE;
+            const uint endIndex = std::min(startIndex + MIDDLE_PHASE_CHUNK_SIZE, nbWorkerPairs);
+            for (uint i=startIndex; i < endIndex; i++) {
+
+                MiddlePhasePair& middlePhasePair = middlePhasePairs[workerPairsIndices[i]];
+                OverlappingPair* pair = middlePhasePair.pair;
+
+                const uint64 startTicks = isNarrowPhaseCostsEnabled ? Timer::getCurrentTicks() : 0;
+
+                if (pair->getShape1()->getCollisionShape()->getType() == CollisionShapeType::COMPOUND ||
+                    pair->getShape2()->getCollisionShape()->getType() == CollisionShapeType::COMPOUND) {
+                    middlePhasePair.nbCulledTriangles = computeCompoundMiddlePhase(pair, allocator, triangles,
+                                                                                   &middlePhasePair.narrowPhaseInfos,
+                                                                                   middlePhasePair.isTriangleCullingEnabled);
+                }
+                else {
+                    middlePhasePair.nbCulledTriangles = computeConvexVsConcaveMiddlePhase(pair, allocator, triangles,
+                                                                                          &middlePhasePair.narrowPhaseInfos,
+                                                                                          middlePhasePair.isTriangleCullingEnabled);
+                }
+
+                if (isNarrowPhaseCostsEnabled) {
+                    middlePhasePair.middlePhaseTicks = Timer::getCurrentTicks() - startTicks;
+                }
+            }
+
+            chunkIndex = nextChunkIndex.fetch_add(1);
+        }
+    });
+}
+
+// Add the narrow-phase infos of the pairs of the parallel middle-phase in the order of the pairs
+/// The narrow-phase infos are added as if the middle-phase had been computed sequentially so
+/// that the contacts do not depend on the scheduling of the workers. The last frame collision
+/// infos of the pairs computed by the workers are added here.
+/**
+ * @param middlePhasePairs Array of the pairs of the middle-phase
+ * @param nbMiddlePhasePairs Number of pairs in the array
+ */
+void CollisionDetection::addMiddlePhasePairsNarrowPhaseInfos(MiddlePhasePair* middlePhasePairs,
+                                                             uint nbMiddlePhasePairs) {
+
+    for (uint i=0; i < nbMiddlePhasePairs; i++) {
+
+        MiddlePhasePair& middlePhasePair = middlePhasePairs[i];
+        OverlappingPair* pair = middlePhasePair.pair;
+
+        uint pairCostIndex = middlePhasePair.narrowPhaseInfos != nullptr ? middlePhasePair.narrowPhaseInfos->pairCostIndex : 0;
+
+        if (middlePhasePair.isComputedByWorker) {
+
+            pair->setIsLastFrameInfoAdditionDeferred(false);
+            for (NarrowPhaseInfo* info = middlePhasePair.narrowPhaseInfos; info != nullptr; info = info->next) {
+                pair->addLastFrameInfoIfNecessary(info->shape1Id, info->shape2Id);
+            }
+            pair->clearObsoleteLastFrameCollisionInfos();
+
+            mNarrowPhaseStatistics.nbCulledTriangles += middlePhasePair.nbCulledTriangles;
+
+            if (mWorld->mConfig.isNarrowPhaseCostsEnabled) {
+                pairCostIndex = addNarrowPhasePairCost(pair);
+                NarrowPhasePairCost& pairCost = mNarrowPhasePairCosts[pairCostIndex];
+                pairCost.middlePhaseTime = double(middlePhasePair.middlePhaseTicks) * 1.0e-9;
+                pairCost.nbTriangles = middlePhasePair.nbCulledTriangles;
+            }
+        }
+
+        // Add the narrow-phase infos of the pair into the list of all the narrow-phase infos
+        NarrowPhaseInfo* narrowPhaseInfo = middlePhasePair.narrowPhaseInfos;
+        while (narrowPhaseInfo != nullptr) {
+            NarrowPhaseInfo* next = narrowPhaseInfo->next;
+            narrowPhaseInfo->next = mNarrowPhaseInfoList;
+            narrowPhaseInfo->pairCostIndex = pairCostIndex;
+            mNarrowPhaseInfoList = narrowPhaseInfo;
+
+            narrowPhaseInfo = next;
+        }
+    }
+}
+
+// Compute the concave vs convex middle-phase algorithm for a given pair of bodies
+/// If the triangle culling is enabled, the triangles that are separated from the AABB of the
+/// convex shape are removed before their narrow-phase infos are created. This method returns
+/// the number of removed triangles.
+uint CollisionDetection::computeConvexVsConcaveMiddlePhase(OverlappingPair* pair, MemoryAllocator& allocator,
+                                                           MiddlePhaseTriangleBatch& triangles,
+                                                           NarrowPhaseInfo** firstNarrowPhaseInfo,
+                                                           bool isTriangleCullingEnabled) {
+
+    ProxyShape* shape1 = pair->getShape1();
+    ProxyShape* shape2 = pair->getShape2();
+
+    ProxyShape* convexProxyShape;
+    ProxyShape* concaveProxyShape;
+    const ConvexShape* convexShape;
+    const ConcaveShape* concaveShape;
+
+    // Collision shape 1 is convex, collision shape 2 is concave
+    if (shape1->getCollisionShape()->isConvex()) {
+        convexProxyShape = shape1;
+        convexShape = static_cast<const ConvexShape*>(shape1->getCollisionShape());
+        concaveProxyShape = shape2;
+        concaveShape = static_cast<const ConcaveShape*>(shape2->getCollisionShape());
+    }
+    else {  // Collision shape 2 is convex, collision shape 1 is concave
+        convexProxyShape = shape2;
+        convexShape = static_cast<const ConvexShape*>(shape2->getCollisionShape());
+        concaveProxyShape = shape1;
+        concaveShape = static_cast<const ConcaveShape*>(shape1->getCollisionShape());
+    }
+
+    // A sphere or a capsule is tested directly against the cells of a height field by the
+    // narrow-phase (without any triangle shape). The triangles are still used when the triangle
+    // culling is disabled because the speculative contacts of bullets need convex shapes.
+    const CollisionShapeType convexShapeType = convexShape->getType();
+    if (isTriangleCullingEnabled && concaveShape->getName() == CollisionShapeName::HEIGHTFIELD &&
+        (convexShapeType == CollisionShapeType::SPHERE || convexShapeType == CollisionShapeType::CAPSULE) &&
+        selectNarrowPhaseAlgorithm(convexShapeType, CollisionShapeType::CONCAVE_SHAPE) != nullptr) {
+
+        *firstNarrowPhaseInfo = new (allocator.allocate(sizeof(NarrowPhaseInfo))) NarrowPhaseInfo(pair,
+                                         shape1->getCollisionShape(), shape2->getCollisionShape(),
+                                         shape1->getLocalToWorldTransform(), shape2->getLocalToWorldTransform(),
+                                         allocator);
+        return 0;
+    }
+
+    // Set the parameters of the callback object
+    MiddlePhaseTriangleCallback middlePhaseCallback(pair, concaveProxyShape, convexProxyShape,
+                                                    concaveShape, allocator, triangles);
+
+#ifdef IS_PROFILING_ACTIVE
+
+	// Set the profiler
+	middlePhaseCallback.setProfiler(mProfiler);
+
+#endif
+
+    // Compute the convex shape AABB in the local-space of the convex shape
+    const Transform convexToConcaveTransform = concaveProxyShape->getLocalToWorldTransform().getInverse() *
+                                               convexProxyShape->getLocalToWorldTransform();
+    AABB aabb;
+    convexShape->computeAABB(aabb, convexToConcaveTransform);
+
+    // Call the convex vs triangle callback for each triangle of the concave shape
+    concaveShape->testAllTriangles(middlePhaseCallback, aabb);
+
+    // Remove the triangles that cannot touch the convex shape
+    uint nbCulledTriangles = 0;
+    if (isTriangleCullingEnabled) {
+        nbCulledTriangles = middlePhaseCallback.cullSeparatedTriangles(aabb);
+    }
+
+    // Create the narrow-phase infos of all the remaining triangles
+    *firstNarrowPhaseInfo = middlePhaseCallback.createNarrowPhaseInfos();
+
+    return nbCulledTriangles;
+}
+
+// Compute the middle-phase algorithm for a pair of bodies with at least one compound shape
+/// The child shapes of a compound shape whose AABBs overlap with the AABB of the other shape
+/// (in local-space of the compound shape) are found with the BVH of the compound shape. A
+/// narrow-phase info is created for each overlapping child and convex shape, for each pair
+/// of overlapping children of two compound shapes and for each triangle of a concave shape
+/// that overlaps with a child. The ids of the shapes in the last frame collision infos of the
+/// pair are the indices of the children. This method returns the number of culled triangles.
+uint CollisionDetection::computeCompoundMiddlePhase(OverlappingPair* pair, MemoryAllocator& allocator,
+                                                    MiddlePhaseTriangleBatch& triangles,
+                                                    NarrowPhaseInfo** firstNarrowPhaseInfo,
+                                                    bool isTriangleCullingEnabled) {
+
+    CollisionShape* shape1 = pair->getShape1()->getCollisionShape();
+    CollisionShape* shape2 = pair->getShape2()->getCollisionShape();
+    const Transform& shape1ToWorld = pair->getShape1()->getLocalToWorldTransform();
+    const Transform& shape2ToWorld = pair->getShape2()->getLocalToWorldTransform();
+    const bool isShape1Compound = shape1->getType() == CollisionShapeType::COMPOUND;
+    assert(isShape1Compound || shape2->getType() == CollisionShapeType::COMPOUND);
+
+    // The first shape that is tested is a compound shape
+    const CompoundShape* compoundShape = static_cast<const CompoundShape*>(isShape1Compound ? shape1 : shape2);
+    CollisionShape* otherShape = isShape1Compound ? shape2 : shape1;
+    const Transform& compoundToWorld = isShape1Compound ? shape1ToWorld : shape2ToWorld;
+    const Transform& otherToWorld = isShape1Compound ? shape2ToWorld : shape1ToWorld;
+    const Transform worldToCompound = compoundToWorld.getInverse();
+
+    // Create a narrow-phase info for two convex shapes (the first shape of the pair first)
+    auto addNarrowPhaseInfo = [&](CollisionShape* compoundChild, const Transform& compoundChildToWorld,
+                                  uint compoundChildId, CollisionShape* other, const Transform& otherShapeToWorld,
+                                  uint otherId) {
+
+        NarrowPhaseInfo* narrowPhaseInfo = new (allocator.allocate(sizeof(NarrowPhaseInfo))) NarrowPhaseInfo(pair,
+                        isShape1Compound ? compoundChild : other, isShape1Compound ? other : compoundChild,
+                        isShape1Compound ? compoundChildToWorld : otherShapeToWorld,
+                        isShape1Compound ? otherShapeToWorld : compoundChildToWorld,
+                        isShape1Compound ? compoundChildId : otherId, isShape1Compound ? otherId : compoundChildId,
+                        allocator);
+        narrowPhaseInfo->next = *firstNarrowPhaseInfo;
+        *firstNarrowPhaseInfo = narrowPhaseInfo;
+    };
+
+    uint nbCulledTriangles = 0;
+
+    // For each child of the compound shape that overlaps with the AABB of the other shape
+    auto testChild = [&](uint childIndex) {
+
+        CollisionShape* child = compoundShape->getChildShape(childIndex);
+        const Transform childToWorld = compoundToWorld * compoundShape->getChildTransform(childIndex);
+
+        // Compound shape vs convex shape
+        if (otherShape->isConvex()) {
+            addNarrowPhaseInfo(child, childToWorld, childIndex, otherShape, otherToWorld, otherShape->getId());
+        }
+        // Compound shape vs compound shape
+        else if (otherShape->getType() == CollisionShapeType::COMPOUND) {
+
+            const CompoundShape* otherCompoundShape = static_cast<const CompoundShape*>(otherShape);
+
+            // Test the children of the other compound shape that overlap with the AABB of the child
+            AABB childAABB;
+            child->computeAABB(childAABB, otherToWorld.getInverse() * childToWorld);
+            auto testOtherChild = [&](uint otherChildIndex) {
+                addNarrowPhaseInfo(child, childToWorld, childIndex, otherCompoundShape->getChildShape(otherChildIndex),
+                                   otherToWorld * otherCompoundShape->getChildTransform(otherChildIndex),
+                                   otherChildIndex);
+            };
+            otherCompoundShape->testAllChildShapes(childAABB, testOtherChild);
+        }
+        // Compound shape vs concave shape
+        else {
+
+            const ConcaveShape* concaveShape = static_cast<const ConcaveShape*>(otherShape);
+
+            MiddlePhaseTriangleCallback middlePhaseCallback(pair, otherToWorld, child, childToWorld, childIndex,
+                                                            isShape1Compound, concaveShape, allocator,
+                                                            triangles);
+
+#ifdef IS_PROFILING_ACTIVE
+
+            // Set the profiler
+            middlePhaseCallback.setProfiler(mProfiler);
+
+#endif
+
+            // Report the triangles that overlap with the AABB of the child in local-space of the concave shape
+            AABB childAABB;
+            child->computeAABB(childAABB, otherToWorld.getInverse() * childToWorld);
+            concaveShape->testAllTriangles(middlePhaseCallback, childAABB);
+
+            if (isTriangleCullingEnabled) {
+                nbCulledTriangles += middlePhaseCallback.cullSeparatedTriangles(childAABB);
+            }
+
+            // Add the narrow-phase infos of the remaining triangles to the list
+            NarrowPhaseInfo* narrowPhaseInfo = middlePhaseCallback.createNarrowPhaseInfos();
+            while (narrowPhaseInfo != nullptr) {
+                NarrowPhaseInfo* next = narrowPhaseInfo->next;
+                narrowPhaseInfo->next = *firstNarrowPhaseInfo;
+                *firstNarrowPhaseInfo = narrowPhaseInfo;
+                narrowPhaseInfo = next;
+            }
+        }
+    };
+
+    // Compute the AABB of the other shape in local-space of the compound shape
+    AABB otherShapeAABB;
+    otherShape->computeAABB(otherShapeAABB, worldToCompound * otherToWorld);
+    compoundShape->testAllChildShapes(otherShapeAABB, testChild);
+
+    return nbCulledTriangles;
+}
+
+// Compute the narrow-phase collision detection
+void CollisionDetection::computeNarrowPhase() {
+
+    RP3D_PROFILE("CollisionDetection::computeNarrowPhase()", mProfiler);
+
+    TaskScheduler* taskScheduler = getTaskScheduler();
+
+    MemoryAllocator& frameAllocator = mMemoryManager.getSingleFrameAllocator(MemoryTag::NarrowPhase);
+
+    // Compute the number of narrow-phase infos
+    uint nbNarrowPhaseInfos = 0;
+    for (NarrowPhaseInfo* info = mNarrowPhaseInfoList; info != nullptr; info = info->next) {
+        nbNarrowPhaseInfos++;
+        countNarrowPhaseTest(info->collisionShape1, info->collisionShape2);
+    }
+
+    if (nbNarrowPhaseInfos > 0) {
+
+        // Sort the narrow-phase infos into batches with the same types of collision shapes so
+        // that each narrow-phase algorithm tests a whole batch at once
+        NarrowPhaseInfo** narrowPhaseInfos = static_cast<NarrowPhaseInfo**>(
+                    frameAllocator.allocate(sizeof(NarrowPhaseInfo*) * nbNarrowPhaseInfos));
+        uint* batchIndices = static_cast<uint*>(frameAllocator.allocate(sizeof(uint) * nbNarrowPhaseInfos));
+        bool* isColliding = static_cast<bool*>(frameAllocator.allocate(sizeof(bool) * nbNarrowPhaseInfos));
+        bool* isSpeculative = static_cast<bool*>(frameAllocator.allocate(sizeof(bool) * nbNarrowPhaseInfos));
+        sortNarrowPhaseInfosIntoBatches(narrowPhaseInfos, batchIndices);
+
+        // If the narrow-phase can be computed by several workers
+        const bool isParallel = taskScheduler != nullptr && taskScheduler->getNbWorkers() > 1 &&
+                                nbNarrowPhaseInfos > 1;
+        if (isParallel) {
+            computeNarrowPhaseInParallel(*taskScheduler, narrowPhaseInfos, isColliding, isSpeculative,
+                                         nbNarrowPhaseInfos);
+        }
+        else {
+            testNarrowPhaseBatches(narrowPhaseInfos, isColliding, isSpeculative, nbNarrowPhaseInfos,
+                                   frameAllocator);
+        }
+
+        // Process the results in the order of the linked list so that the generated
+        // contacts do not depend on the batches
+        NarrowPhaseInfo* currentNarrowPhaseInfo = mNarrowPhaseInfoList;
+        uint index = 0;
+        while (currentNarrowPhaseInfo != nullptr) {
+
+            NarrowPhaseInfo* nextNarrowPhaseInfo = currentNarrowPhaseInfo->next;
+
+            // Count the runs of the GJK algorithm
+            mNarrowPhaseStatistics.nbGJKTests += currentNarrowPhaseInfo->nbGJKTests;
+            mNarrowPhaseStatistics.nbGJKIterations += currentNarrowPhaseInfo->nbGJKIterations;
+            mNarrowPhaseStatistics.nbGJKWarmStarts += currentNarrowPhaseInfo->nbGJKWarmStarts;
+
+            if (mWorld->mConfig.isNarrowPhaseCostsEnabled) {
+                addNarrowPhaseTestCost(currentNarrowPhaseInfo);
+            }
+
+            const uint batchIndex = batchIndices[index];
+            processNarrowPhaseInfo(currentNarrowPhaseInfo, isColliding[batchIndex], isSpeculative[batchIndex]);
+
+            currentNarrowPhaseInfo = nextNarrowPhaseInfo;
+            index++;
+        }
+
+        // The memory of the workers is not used anymore (the narrow-phase infos created by
+        // a parallel middle-phase are also in the allocators of the workers)
+        mMemoryManager.resetWorkerFrameAllocators();
+
+        frameAllocator.release(isSpeculative, sizeof(bool) * nbNarrowPhaseInfos);
+        frameAllocator.release(isColliding, sizeof(bool) * nbNarrowPhaseInfos);
+        frameAllocator.release(batchIndices, sizeof(uint) * nbNarrowPhaseInfos);
+        frameAllocator.release(narrowPhaseInfos, sizeof(NarrowPhaseInfo*) * nbNarrowPhaseInfos);
+    }
+
+    // Compute the order in which the overlapping pairs are processed
+    computeOverlappingPairsOrder();
+
+    // Convert the potential contact into actual contacts
+    processAllPotentialContacts();
+
+    // Add all the contact manifolds (between colliding bodies) to the bodies
+    addAllContactManifoldsToBodies();
+
+    // Report contacts to the user
+    reportAllContacts();
+
+    mOrderedOverlappingPairs.clear();
+}
+
+// Make the parked pairs with an awake body active again
+/// This is only done when a body has been woken up since the last middle-phase so that the
+/// parked pairs of the sleeping bodies are not visited at each frame.
+void CollisionDetection::unparkPairsOfAwakeBodies() {
+
+    RP3D_PROFILE("CollisionDetection::unparkPairsOfAwakeBodies()", mProfiler);
+
+    for (uint i = mOverlappingPairs.getNbActivePairs(); i < mOverlappingPairs.size(); i++) {
+
+        // The first parked pair (that has already been tested) is moved at the index of the unparked one
+        if (mOverlappingPairs.getPair(i)->isActive()) {
+            mOverlappingPairs.unpark(i);
+        }
+    }
+
+    mIsBodyWokenUp = false;
+}
+
+// Compute the order in which the overlapping pairs are processed after the narrow-phase
+/// The order of the contact manifolds in the bodies (and therefore the order of the
+/// islands contacts and of the contact constraints) follows this order. In deterministic
+/// mode, the pairs are sorted by the ids of their bodies and shapes instead of using the
+/// order of the overlapping pairs map (that depends on the history of the map).
+void CollisionDetection::computeOverlappingPairsOrder() {
+
+    assert(mOrderedOverlappingPairs.size() == 0);
+
+    for (uint i=0; i < mOverlappingPairs.getNbActivePairs(); i++) {
+        mOrderedOverlappingPairs.add(mOverlappingPairs.getPair(i));
+    }
+
+    if (mWorld->mConfig.isDeterministic && mOrderedOverlappingPairs.size() > 1) {
+
+        OverlappingPair** pairs = &(mOrderedOverlappingPairs[0]);
+        std::sort(pairs, pairs + mOrderedOverlappingPairs.size(), [](OverlappingPair* pair1, OverlappingPair* pair2) {
+
+            const bodyindexpair bodies1 = OverlappingPair::computeBodiesIndexPair(pair1->getShape1()->getBody(),
+                                                                                  pair1->getShape2()->getBody());
+            const bodyindexpair bodies2 = OverlappingPair::computeBodiesIndexPair(pair2->getShape1()->getBody(),
+                                                                                  pair2->getShape2()->getBody());
+            if (bodies1.first != bodies2.first) return bodies1.first < bodies2.first;
+            if (bodies1.second != bodies2.second) return bodies1.second < bodies2.second;
+
+            const OverlappingPair::OverlappingPairId id1 = OverlappingPair::computeID(pair1->getShape1(), pair1->getShape2());
+            const OverlappingPair::OverlappingPairId id2 = OverlappingPair::computeID(pair2->getShape1(), pair2->getShape2());
+            if (id1.first != id2.first) return id1.first < id2.first;
+            return id1.second < id2.second;
+        });
+    }
+}
+
+// Add the cost of an overlapping pair to the costs of the current collision detection
+/**
+ * @param pair The overlapping pair
+ * @return The index of the cost of the pair
+ */
+uint CollisionDetection::addNarrowPhasePairCost(OverlappingPair* pair) {
+
+    NarrowPhasePairCost pairCost;
+    pairCost.shape1 = pair->getShape1();
+    pairCost.shape2 = pair->getShape2();
+    mNarrowPhasePairCosts.add(pairCost);
+
+    return mNarrowPhasePairCosts.size() - 1;
+}
+
+// Add the cost of a narrow-phase test to the costs of its pair and of its types of shapes
+void CollisionDetection::addNarrowPhaseTestCost(const NarrowPhaseInfo* narrowPhaseInfo) {
+
+    const double time = double(narrowPhaseInfo->narrowPhaseTicks) * 1.0e-9;
+
+    NarrowPhasePairCost& pairCost = mNarrowPhasePairCosts[narrowPhaseInfo->pairCostIndex];
+    assert(pairCost.shape1 == narrowPhaseInfo->overlappingPair->getShape1());
+    pairCost.narrowPhaseTime += time;
+    pairCost.nbTests++;
+    if (narrowPhaseInfo->collisionShape1->getName() == CollisionShapeName::TRIANGLE ||
+        narrowPhaseInfo->collisionShape2->getName() == CollisionShapeName::TRIANGLE) {
+        pairCost.nbTriangles++;
+    }
+
+    NarrowPhaseShapeTypeCost& shapeTypeCost = mNarrowPhaseShapeTypeCosts[computeNarrowPhaseBatchIndex(
+                narrowPhaseInfo->collisionShape1->getType(), narrowPhaseInfo->collisionShape2->getType())];
+    shapeTypeCost.time += time;
+    shapeTypeCost.nbTests++;
+}
+
+// Return the most expensive overlapping pairs of the last collision detection
+/// The pairs are sorted by decreasing total time (see NarrowPhasePairCost::getTime()). The
+/// costs are only measured if they are enabled in the world settings. The costs are
+/// cleared when a proxy shape is removed from the world.
+/**
+ * @param[out] pairCosts Array of at least nbMaxPairs costs where the costs of the pairs are written
+ * @param nbMaxPairs Maximum number of pairs to return
+ * @return The number of pairs written in the array
+ */
+uint CollisionDetection::getMostExpensiveNarrowPhasePairs(NarrowPhasePairCost* pairCosts, uint nbMaxPairs) const {
+
+    const uint nbPairs = std::min(nbMaxPairs, static_cast<uint>(mNarrowPhasePairCosts.size()));
+    if (nbPairs == 0) return 0;
+
+    const NarrowPhasePairCost* costs = &(mNarrowPhasePairCosts[0]);
+    std::partial_sort_copy(costs, costs + mNarrowPhasePairCosts.size(), pairCosts, pairCosts + nbPairs,
+                           [](const NarrowPhasePairCost& cost1, const NarrowPhasePairCost& cost2) {
+        return cost1.getTime() > cost2.getTime();
+    });
+
+    return nbPairs;
+}
+
+// Count a narrow-phase test in the statistics of the algorithm of its pair of shapes
+void CollisionDetection::countNarrowPhaseTest(const CollisionShape* shape1, const CollisionShape* shape2) {
+
+    mNarrowPhaseStatistics.nbTests++;
+
+    CollisionShapeType shape1Type = shape1->getType();
+    CollisionShapeType shape2Type = shape2->getType();
+
+    // The algorithms do not depend on the order of the shapes
+    if (shape1Type > shape2Type) std::swap(shape1Type, shape2Type);
+
+    switch (shape1Type) {
+        case CollisionShapeType::SPHERE:
+            switch (shape2Type) {
+                case CollisionShapeType::SPHERE: mNarrowPhaseStatistics.nbSphereVsSphereTests++; break;
+                case CollisionShapeType::CAPSULE: mNarrowPhaseStatistics.nbSphereVsCapsuleTests++; break;
+                case CollisionShapeType::CONVEX_POLYHEDRON: mNarrowPhaseStatistics.nbSphereVsConvexPolyhedronTests++; break;
+                default: break;
+            }
+            break;
+        case CollisionShapeType::CAPSULE:
+            switch (shape2Type) {
+                case CollisionShapeType::CAPSULE: mNarrowPhaseStatistics.nbCapsuleVsCapsuleTests++; break;
+                case CollisionShapeType::CONVEX_POLYHEDRON: mNarrowPhaseStatistics.nbCapsuleVsConvexPolyhedronTests++; break;
+                default: break;
+            }
+            break;
+        case CollisionShapeType::CONVEX_POLYHEDRON:
+            if (shape2Type == CollisionShapeType::CONVEX_POLYHEDRON) {
+                mNarrowPhaseStatistics.nbConvexPolyhedronVsConvexPolyhedronTests++;
+                if (shape1->getName() == CollisionShapeName::BOX && shape2->getName() == CollisionShapeName::BOX) {
+                    mNarrowPhaseStatistics.nbBoxVsBoxTests++;
+                }
+            }
+            break;
+        default: break;
+    }
+
+    // The pairs with an implicit convex shape are tested by a single algorithm
+    if (shape2Type == CollisionShapeType::IMPLICIT_CONVEX) {
+        mNarrowPhaseStatistics.nbConvexVsImplicitConvexTests++;
+    }
+
+    // The pairs of a sphere or a capsule and a height field are tested without triangle shapes
+    if (shape2Type == CollisionShapeType::CONCAVE_SHAPE) {
+        mNarrowPhaseStatistics.nbConvexVsHeightFieldTests++;
+    }
+}
+
+// Sort the narrow-phase infos into batches with the same types of collision shapes
+/// The narrow-phase infos of the linked list are sorted with a counting sort on the index
+/// of their batch (the order of the linked list is kept inside each batch). The position
+/// in the batches of the i-th narrow-phase info of the linked list is stored in
+/// batchIndices[i].
+void CollisionDetection::sortNarrowPhaseInfosIntoBatches(NarrowPhaseInfo** narrowPhaseInfos,
+                                                         uint* batchIndices) const {
+
+    const uint nbBatches = NB_COLLISION_SHAPE_TYPES * NB_COLLISION_SHAPE_TYPES;
+
+    // Count the narrow-phase infos of each batch
+    uint batchesStart[nbBatches];
+    for (uint b=0; b < nbBatches; b++) {
+        batchesStart[b] = 0;
+    }
+    for (NarrowPhaseInfo* info = mNarrowPhaseInfoList; info != nullptr; info = info->next) {
+        batchesStart[computeNarrowPhaseBatchIndex(info->collisionShape1->getType(),
+                                                  info->collisionShape2->getType())]++;
+    }
+
+    // Compute the start of each batch
+    uint start = 0;
+    for (uint b=0; b < nbBatches; b++) {
+        const uint nbInfos = batchesStart[b];
+        batchesStart[b] = start;
+        start += nbInfos;
+    }
+
+    // Put each narrow-phase info into its batch
+    uint index = 0;
+    for (NarrowPhaseInfo* info = mNarrowPhaseInfoList; info != nullptr; info = info->next) {
+        const uint batch = computeNarrowPhaseBatchIndex(info->collisionShape1->getType(),
+                                                        info->collisionShape2->getType());
+        narrowPhaseInfos[batchesStart[batch]] = info;
+        batchIndices[index] = batchesStart[batch];
+        batchesStart[batch]++;
+        index++;
+    }
+}
+
+// Run the narrow-phase algorithms of an array of narrow-phase infos sorted into batches
+/// Each run of narrow-phase infos with the same types of collision shapes is tested with a
+/// single call to the narrow-phase algorithm of these types.
+void CollisionDetection::testNarrowPhaseBatches(NarrowPhaseInfo** narrowPhaseInfos, bool* isColliding,
+                                                bool* isSpeculative, uint nbNarrowPhaseInfos,
+                                                MemoryAllocator& allocator) {
+
+    uint startIndex = 0;
+    while (startIndex < nbNarrowPhaseInfos) {
+
+        // Find the end of the run of narrow-phase infos with the same shape types
+        const CollisionShapeType shape1Type = narrowPhaseInfos[startIndex]->collisionShape1->getType();
+        const CollisionShapeType shape2Type = narrowPhaseInfos[startIndex]->collisionShape2->getType();
+        const uint batch = computeNarrowPhaseBatchIndex(shape1Type, shape2Type);
+        uint endIndex = startIndex + 1;
+        while (endIndex < nbNarrowPhaseInfos &&
+               computeNarrowPhaseBatchIndex(narrowPhaseInfos[endIndex]->collisionShape1->getType(),
+                                            narrowPhaseInfos[endIndex]->collisionShape2->getType()) == batch) {
+            endIndex++;
+        }
+
+        const uint64 startTicks = mWorld->mConfig.isNarrowPhaseCostsEnabled ? Timer::getCurrentTicks() : 0;
+
+        // Select the narrow phase algorithm to use according to the two collision shapes
+        NarrowPhaseAlgorithm* narrowPhaseAlgorithm = selectNarrowPhaseAlgorithm(shape1Type, shape2Type);
+
+        // Use the narrow-phase collision detection algorithm to check
+        // if there really is a collision
+        if (narrowPhaseAlgorithm != nullptr) {
+            narrowPhaseAlgorithm->testCollisionBatch(narrowPhaseInfos + startIndex, isColliding + startIndex,
+                                                     endIndex - startIndex, true, allocator);
+        }
+        else {
+            for (uint i=startIndex; i < endIndex; i++) {
+                isColliding[i] = false;
+            }
+        }
+
+        // If the shapes are not colliding, a bullet body might still hit them during the step
+        for (uint i=startIndex; i < endIndex; i++) {
+            isSpeculative[i] = !isColliding[i] && narrowPhaseAlgorithm != nullptr &&
+                               computeSpeculativeContact(narrowPhaseInfos[i]);
+        }
+
+        // Share the time of the batch equally between its tests
+        if (mWorld->mConfig.isNarrowPhaseCostsEnabled) {
+            const uint64 ticks = (Timer::getCurrentTicks() - startTicks) / (endIndex - startIndex);
+            for (uint i=startIndex; i < endIndex; i++) {
+                narrowPhaseInfos[i]->narrowPhaseTicks = ticks;
+            }
+        }
+
+        startIndex = endIndex;
+    }
+}
+
+// Run the narrow-phase algorithms of all the narrow-phase infos in parallel
+/// The narrow-phase infos (sorted into batches) are split into chunks of NARROW_PHASE_CHUNK_SIZE
+/// infos. Each worker takes the next chunk until all the chunks are tested. A worker allocates
+/// the contact points and the temporary memory of the algorithms with its own single frame
+/// allocator. The results are then processed sequentially in the order of the linked list so
+/// that the generated contacts do not depend on the scheduling of the workers.
+void CollisionDetection::computeNarrowPhaseInParallel(TaskScheduler& taskScheduler, NarrowPhaseInfo** narrowPhaseInfos,
+                                                      bool* isColliding, bool* isSpeculative,
+                                                      uint nbNarrowPhaseInfos) {
+
+    const uint nbChunks = (nbNarrowPhaseInfos + NARROW_PHASE_CHUNK_SIZE - 1) / NARROW_PHASE_CHUNK_SIZE;
+    const uint nbWorkers = std::min(taskScheduler.getNbWorkers(), nbChunks);
+
+    mMemoryManager.createWorkerAllocators(nbWorkers);
+
+    std::atomic<uint> nextChunkIndex(0);
+
+    taskScheduler.parallelFor(nbWorkers, [&](uint workerIndex) {
+
+        SingleFrameAllocator& allocator = mMemoryManager.getWorkerSingleFrameAllocator(workerIndex);
+
+        // Take the next chunk until all the chunks are tested
+        uint chunkIndex = nextChunkIndex.fetch_add(1);
+        while (chunkIndex < nbChunks) {
+
+            const uint startIndex = chunkIndex * NARROW_PHASE_CHUNK_SIZE;
+            const uint endIndex = std::min(startIndex + NARROW_PHASE_CHUNK_SIZE, nbNarrowPhaseInfos);
+            for (uint i=startIndex; i < endIndex; i++) {
+                narrowPhaseInfos[i]->contactPointsAllocator = &allocator;
+            }
+
+            testNarrowPhaseBatches(narrowPhaseInfos + startIndex, isColliding + startIndex,
+                                   isSpeculative + startIndex, endIndex - startIndex, allocator);
+
+            chunkIndex = nextChunkIndex.fetch_add(1);
+        }
+    });
+}
+
+// Create a speculative contact for a narrow-phase info whose shapes are not colliding
+/// If one of the two bodies is a bullet rigid body, we compute the closest points of
+/// the two shapes. If the relative velocity of those points along the normal would
+/// close the gap between the shapes during the next step, a speculative contact with
+/// a negative penetration depth is created. The contact solver then only removes the
+/// part of the approaching velocity that would make the shapes interpenetrate. This
+/// method returns true if a speculative contact has been created.
+bool CollisionDetection::computeSpeculativeContact(NarrowPhaseInfo* narrowPhaseInfo) const {
+
+    // The speculative contacts are only used by a dynamics world
+    if (mSpeculativeContactsTimeStep <= decimal(0.0)) return false;
+
+    RigidBody* body1 = static_cast<RigidBody*>(narrowPhaseInfo->overlappingPair->getShape1()->getBody());
+    RigidBody* body2 = static_cast<RigidBody*>(narrowPhaseInfo->overlappingPair->getShape2()->getBody());
+    if (!body1->isBullet() && !body2->isBullet()) return false;
+
+    if (!narrowPhaseInfo->collisionShape1->isConvex() || !narrowPhaseInfo->collisionShape2->isConvex()) {
+        return false;
+    }
+
+    const ConvexShape* shape1 = static_cast<const ConvexShape*>(narrowPhaseInfo->collisionShape1);
+    const ConvexShape* shape2 = static_cast<const ConvexShape*>(narrowPhaseInfo->collisionShape2);
+    const Transform& transform1 = narrowPhaseInfo->shape1ToWorldTransform;
+    const Transform& transform2 = narrowPhaseInfo->shape2ToWorldTransform;
+
+    // Compute the closest points of the two shapes
+    Vector3 localPoint1;
+    Vector3 localPoint2;
+    Vector3 normal;
+    decimal distance;
+    if (!mGJKAlgorithm.computeClosestPoints(shape1, transform1, shape2, transform2,
+                                                       localPoint1, localPoint2, normal, distance)) {
+        return false;
+    }
+
+    // The shapes can be touching without being reported as colliding because of numerical errors
+    distance = std::max(distance, SPECULATIVE_CONTACT_MIN_DISTANCE);
+
+    const Vector3 point1 = transform1 * localPoint1;
+    const Vector3 point2 = transform2 * localPoint2;
+
+    // Compute the velocity at which the two closest points are approaching each other
+    const Vector3 velocity1 = body1->getLinearVelocity() +
+                              body1->getAngularVelocity().cross(point1 - body1->getCenterOfMassWorld());
+    const Vector3 velocity2 = body2->getLinearVelocity() +
+                              body2->getAngularVelocity().cross(point2 - body2->getCenterOfMassWorld());
+    const decimal approachingVelocity = (velocity1 - velocity2).dot(normal);
+
+    // If the gap is not closed during the next step, there is no need for a contact
+    if (approachingVelocity * mSpeculativeContactsTimeStep <= distance) return false;
+
+    narrowPhaseInfo->addSpeculativeContactPoint(normal, distance, localPoint1, localPoint2);
+
+    return true;
+}
+
+// Use the result of the narrow-phase algorithm of a narrow-phase info and destroy it
+/**
+ * @param narrowPhaseInfo The narrow-phase info
+ * @param isColliding True if the narrow-phase algorithm has found a collision
+ * @param isSpeculative True if a speculative contact has been created for the shapes
+ */
+void CollisionDetection::processNarrowPhaseInfo(NarrowPhaseInfo* narrowPhaseInfo, bool isColliding,
+                                                bool isSpeculative) {
+
+    const CollisionShapeType shape1Type = narrowPhaseInfo->collisionShape1->getType();
+    const CollisionShapeType shape2Type = narrowPhaseInfo->collisionShape2->getType();
+
+    // If there is a collision algorithm between those two kinds of shapes
+    if (selectNarrowPhaseAlgorithm(shape1Type, shape2Type) != nullptr) {
+
+        LastFrameCollisionInfo* lastCollisionFrameInfo = narrowPhaseInfo->getLastFrameCollisionInfo();
+
+        if (isColliding) {
+
+            // Add the contact points as a potential contact manifold into the pair
+            narrowPhaseInfo->addContactPointsAsPotentialContactManifold();
+
+            lastCollisionFrameInfo->wasColliding = true;
+        }
+        else {
+
+            // The shapes are not touching yet but the solver needs the speculative contact
+            if (isSpeculative) {
+                narrowPhaseInfo->addContactPointsAsPotentialContactManifold();
+            }
+
+            lastCollisionFrameInfo->wasColliding = false;
+        }
+
+        // The previous frame collision info is now valid
+        lastCollisionFrameInfo->isValid = true;
+
+        if (lastCollisionFrameInfo->wasUsingSAT) {
+            mNarrowPhaseStatistics.nbSATTests++;
+            if (lastCollisionFrameInfo->satWasPreviousAxisUsed) {
+                mNarrowPhaseStatistics.nbSATPreviousAxisHits++;
+            }
+        }
+    }
+
+    // Destroy the narrow phase info and release its memory
+    NarrowPhaseInfo::destroy(narrowPhaseInfo);
+}
+
+// Allow the broadphase to notify the collision detection about an overlapping pair.
+/// This method is called by the broad-phase collision detection algorithm
+void CollisionDetection::broadPhaseNotifyOverlappingPair(ProxyShape* shape1, ProxyShape* shape2) {
+
+    assert(shape1->getBroadPhaseId() != -1);
+    assert(shape2->getBroadPhaseId() != -1);
+    assert(shape1->getBroadPhaseId() != shape2->getBroadPhaseId());
+
+    const uint64 pairKey = OverlappingPairCache::computeKey(shape1, shape2);
+    const uint64 stamp = mBroadPhaseAlgorithm->getBroadPhaseStamp();
+
+    // The broad-phase only reports the pairs that pass the collision filtering
+    assert(testCollisionFilter(shape1, shape2));
+
+    // If the overlapping pair already exists, we only record that it is still overlapping
+    if (mOverlappingPairs.updateStamp(pairKey, stamp)) return;
+
+    // The first shape of the pair is the one with the smallest collision shape type so that the
+    // convex shapes of the pair are given to the narrow-phase algorithms in the order of the
+    // collision matrix
+    if (shape1->getCollisionShape()->getType() > shape2->getCollisionShape()->getType()) {
+        std::swap(shape1, shape2);
+    }
+
+    // Create the overlapping pair and add it into the set of overlapping pairs
+    OverlappingPair* newPair = new (mMemoryManager.allocate(MemoryManager::AllocationType::Pool, sizeof(OverlappingPair), MemoryTag::BroadPhase))
+                              OverlappingPair(shape1, shape2, mMemoryManager.getPoolAllocator(MemoryTag::ContactManifolds),
+                                              mMemoryManager.getSingleFrameAllocator(MemoryTag::NarrowPhase), mWorld->mConfig);
+    assert(newPair != nullptr);
+
+    mOverlappingPairs.add(pairKey, newPair, stamp);
+
+    // Wake up the two bodies
+    shape1->getBody()->setIsSleeping(false);
+    shape2->getBody()->setIsSleeping(false);
+}
+
+// Remove a body from the collision detection
+void CollisionDetection::removeProxyCollisionShape(ProxyShape* proxyShape) {
+
+    // A query-only shape is never part of an overlapping pair
+    if (proxyShape->isQueryOnly()) {
+        assert(proxyShape->mQueryOnlyNodeID != -1);
+        mQueryOnlyTree.removeObject(proxyShape->mQueryOnlyNodeID);
+        proxyShape->mQueryOnlyNodeID = -1;
+        return;
+    }
+
+    assert(proxyShape->getBroadPhaseId() != -1);
+
+    // The costs of the last collision detection might refer to the removed proxy shape
+    mNarrowPhasePairCosts.clear();
+
+    // Remove all the overlapping pairs involving this proxy shape (the pairs of the bodies
+    // destroyed together have already been removed)
+    if (!proxyShape->getBody()->mIsBeingDestroyed) {
+        removeOverlappingPairs(proxyShape);
+    }
+
+    // Remove the body from the broad-phase
+    mBroadPhaseAlgorithm->removeProxyCollisionShape(proxyShape);
+}
+
+// Update a proxy collision shape after the type of its body has changed
+void CollisionDetection::updateProxyCollisionShapeType(ProxyShape* proxyShape) {
+
+    if (proxyShape->getBroadPhaseId() == -1) return;
+
+    const int broadPhaseID = proxyShape->getBroadPhaseId();
+
+    mBroadPhaseAlgorithm->updateProxyCollisionShapeType(proxyShape);
+
+    // The IDs of the overlapping pairs are computed with the broad-phase IDs of the shapes.
+    // If the broad-phase ID has changed, the pairs are removed and will be created again
+    if (proxyShape->getBroadPhaseId() != broadPhaseID) {
+        removeOverlappingPairs(proxyShape);
+    }
+}
+
+// Remove all the overlapping pairs involving a proxy shape
+void CollisionDetection::removeOverlappingPairs(ProxyShape* proxyShape) {
+
+    uint i = 0;
+    while (i < mOverlappingPairs.size()) {
+
+        OverlappingPair* pair = mOverlappingPairs.getPair(i);
+        if (pair->getShape1() == proxyShape || pair->getShape2() == proxyShape) {
+            destroyOverlappingPair(i);
+        }
+        else {
+            i++;
+        }
+    }
+}
+
+// Remove all the overlapping pairs involving the bodies that are being destroyed
+/// The pairs of all the bodies destroyed together are removed in a single pass over the
+/// overlapping pairs instead of one pass for each proxy shape.
+void CollisionDetection::removeOverlappingPairsOfDestroyedBodies() {
+
+    RP3D_PROFILE("CollisionDetection::removeOverlappingPairsOfDestroyedBodies()", mProfiler);
+
+    uint i = 0;
+    while (i < mOverlappingPairs.size()) {
+
+        OverlappingPair* pair = mOverlappingPairs.getPair(i);
+        if (pair->getShape1()->getBody()->mIsBeingDestroyed || pair->getShape2()->getBody()->mIsBeingDestroyed) {
+            destroyOverlappingPair(i);
+        }
+        else {
+            i++;
+        }
+    }
+}
+
+// Destroy the overlapping pair at a given index of the overlapping pairs
+/// The last pair is moved at the index of the destroyed one.
+void CollisionDetection::destroyOverlappingPair(uint index) {
+
+    OverlappingPair* pair = mOverlappingPairs.getPair(index);
+
+    // TODO : Remove all the contact manifold of the overlapping pair from the contact manifolds list of the two bodies involved
+
+    // Remove the contact manifolds of the pair from the contact manifolds of the world
+    // (the manifolds of a parked pair are not in the list)
+    const ContactManifold* manifold = pair->getContactManifoldSet().getContactManifolds();
+    while (manifold != nullptr) {
+        List<const ContactManifold*>::Iterator it = mContactManifolds.find(manifold);
+        if (it != mContactManifolds.end()) {
+            mContactManifolds.remove(it);
+        }
+        manifold = manifold->getNext();
+    }
+
+    // Destroy the overlapping pair
+    pair->~OverlappingPair();
+    mWorld->mMemoryManager.release(MemoryManager::AllocationType::Pool, pair, sizeof(OverlappingPair), MemoryTag::BroadPhase);
+
+    mOverlappingPairs.removeAt(index);
+}
+
+// Add all the contact manifold of colliding pairs to their bodies
+/// The contact manifolds of the bodies are stored in a single contiguous array where the
+/// manifolds of each body are contiguous. The manifolds of each body are first counted, then
+/// each body gets its range in the array (in the order in which the bodies are met) and the
+/// ranges are filled from their end so that the manifolds of a body are in the reverse order
+/// of the processed pairs. The contact manifolds lists of the bodies must have been reset.
+void CollisionDetection::addAllContactManifoldsToBodies() {
+
+    RP3D_PROFILE("CollisionDetection::addAllContactManifoldsToBodies()", mProfiler);
+
+    mBodiesContactManifolds.clear();
+
+    // Count the contact manifolds of each body (the range of a body is not assigned yet)
+    uint nbBodiesContactManifolds = 0;
+    for (uint i=0; i < mOrderedOverlappingPairs.size(); i++) {
+
+        OverlappingPair* pair = mOrderedOverlappingPairs[i];
+        CollisionBody* body1 = pair->getShape1()->getBody();
+        CollisionBody* body2 = pair->getShape2()->getBody();
+
+        for (const ContactManifold* manifold = pair->getContactManifoldSet().getContactManifolds();
+             manifold != nullptr; manifold = manifold->getNext()) {
+
+            if (body1->mNbContactManifolds == 0) body1->mContactManifoldsIndex = INVALID_CONTACT_MANIFOLDS_INDEX;
+            if (body2->mNbContactManifolds == 0) body2->mContactManifoldsIndex = INVALID_CONTACT_MANIFOLDS_INDEX;
+            body1->mNbContactManifolds++;
+            body2->mNbContactManifolds++;
+            nbBodiesContactManifolds += 2;
+        }
+    }
+
+    mBodiesContactManifolds.reserve(nbBodiesContactManifolds);
+    for (uint i=0; i < nbBodiesContactManifolds; i++) {
+        mBodiesContactManifolds.add(nullptr);
+    }
+
+    // For each overlapping pairs in contact during the narrow-phase
+    uint nbAssignedContactManifolds = 0;
+    for (uint i=0; i < mOrderedOverlappingPairs.size(); i++) {
+
+        // Add all the contact manifolds of the pair into the ranges of contact manifolds
+        // of the two bodies involved in the contact
+        addContactManifoldToBody(mOrderedOverlappingPairs[i], nbAssignedContactManifolds);
+    }
+
+    assert(nbAssignedContactManifolds == nbBodiesContactManifolds);
+}
+
+// Write the overlapping pairs and their contacts
+/// The pairs are written in the order of the cache (the active pairs first) with the
+/// broad-phase IDs of their shapes.
+void CollisionDetection::saveState(WorldStateWriter& writer) const {
+
+    writer.write(static_cast<uint32>(mOverlappingPairs.size()));
+    writer.write(static_cast<uint32>(mOverlappingPairs.getNbActivePairs()));
+    writer.write(mIsBodyWokenUp);
+
+    for (uint i=0; i < mOverlappingPairs.size(); i++) {
+
+        const OverlappingPair* pair = mOverlappingPairs.getPair(i);
+
+        writer.write(static_cast<int32>(pair->getShape1()->getBroadPhaseId()));
+        writer.write(static_cast<int32>(pair->getShape2()->getBroadPhaseId()));
+        writer.write(mOverlappingPairs.getStamp(i));
+        pair->saveState(writer);
+    }
+}
+
+// Destroy all the overlapping pairs and their contact manifolds
+/// The contact manifolds mark their bodies as having a removed constraint when they are
+/// destroyed. When a state is restored, this must be done before the flags of the bodies
+/// are read.
+void CollisionDetection::destroyAllOverlappingPairs() {
+
+    while (mOverlappingPairs.size() > 0) {
+
+        const uint lastIndex = mOverlappingPairs.size() - 1;
+        OverlappingPair* pair = mOverlappingPairs.getPair(lastIndex);
+
+        pair->~OverlappingPair();
+        mWorld->mMemoryManager.release(MemoryManager::AllocationType::Pool, pair, sizeof(OverlappingPair), MemoryTag::BroadPhase);
+
+        mOverlappingPairs.removeAt(lastIndex);
+    }
+    mContactManifolds.clear();
+    mContactEvents.clear();
+    mWorld->resetContactManifoldListsOfBodies();
+}
+
+// Create again the pairs written by saveState()
+/// The proxy shapes of the pairs are found with the broad-phase IDs they had when the state
+/// has been saved. The contact manifolds of the bodies and of the world are rebuilt. The
+/// current pairs must have been destroyed with destroyAllOverlappingPairs().
+void CollisionDetection::restoreState(WorldStateReader& reader, const FlatMap<int, ProxyShape*>& savedProxyShapes) {
+
+    assert(mOverlappingPairs.size() == 0);
+
+    const uint32 nbPairs = reader.read<uint32>();
+    const uint32 nbActivePairs = reader.read<uint32>();
+    reader.read(mIsBodyWokenUp);
+
+    // Create the pairs again (without waking up their bodies) in the same order
+    for (uint32 i=0; i < nbPairs; i++) {
+
+        ProxyShape* shape1 = savedProxyShapes[reader.read<int32>()];
+        ProxyShape* shape2 = savedProxyShapes[reader.read<int32>()];
+        const uint64 stamp = reader.read<uint64>();
+
+        OverlappingPair* pair = new (mMemoryManager.allocate(MemoryManager::AllocationType::Pool, sizeof(OverlappingPair), MemoryTag::BroadPhase))
+                                OverlappingPair(shape1, shape2, mMemoryManager.getPoolAllocator(MemoryTag::ContactManifolds),
+                                                mMemoryManager.getSingleFrameAllocator(MemoryTag::NarrowPhase), mWorld->mConfig);
+        assert(pair != nullptr);
+
+        mOverlappingPairs.add(OverlappingPairCache::computeKey(shape1, shape2), pair, stamp);
+        pair->restoreState(reader);
+    }
+
+    // Park the last pairs (parking the last active pair does not move the other pairs)
+    for (uint32 i=nbPairs; i > nbActivePairs; i--) {
+        mOverlappingPairs.park(i - 1);
+    }
+
+    // Add the contact manifolds of the active pairs to the bodies and to the world
+    computeOverlappingPairsOrder();
+    addAllContactManifoldsToBodies();
+    for (uint i=0; i < mOrderedOverlappingPairs.size(); i++) {
+        const ContactManifold* manifold = mOrderedOverlappingPairs[i]->getContactManifoldSet().getContactManifolds();
+        while (manifold != nullptr) {
+            mContactManifolds.add(manifold);
+            manifold = manifold->getNext();
+        }
+    }
+    mOrderedOverlappingPairs.clear();
+}
+
+// Skip the pairs written by saveState() and return false if restoreState() cannot read them
+/// The pairs must refer to the broad-phase IDs of two different saved proxy shapes and a
+/// pair of proxy shapes must not be written twice.
+bool CollisionDetection::checkState(WorldStateReader& reader, const FlatMap<int, ProxyShape*>& savedProxyShapes) const {
+
+    if (!reader.canRead(2 * sizeof(uint32) + sizeof(mIsBodyWokenUp))) return false;
+
+    const uint32 nbPairs = reader.read<uint32>();
+    const uint32 nbActivePairs = reader.read<uint32>();
+    reader.skip(sizeof(mIsBodyWokenUp));
+    if (nbActivePairs > nbPairs) return false;
+
+    FlatSet<uint64> pairKeys(mMemoryManager.getPoolAllocator(MemoryTag::Other));
+    for (uint32 i=0; i < nbPairs; i++) {
+
+        if (!reader.canRead(2 * sizeof(int32) + sizeof(uint64))) return false;
+
+        const int32 broadPhaseId1 = reader.read<int32>();
+        const int32 broadPhaseId2 = reader.read<int32>();
+        reader.skip(sizeof(uint64));
+        if (broadPhaseId1 == broadPhaseId2 || !savedProxyShapes.containsKey(broadPhaseId1) ||
+            !savedProxyShapes.containsKey(broadPhaseId2)) {
+            return false;
+        }
+
+        const ProxyShape* shape1 = savedProxyShapes[broadPhaseId1];
+        const ProxyShape* shape2 = savedProxyShapes[broadPhaseId2];
+        const uint64 pairKey = OverlappingPairCache::computeKey(shape1, shape2);
+        if (pairKeys.contains(pairKey)) return false;
+        pairKeys.add(pairKey);
+
+        if (!OverlappingPair::checkState(reader, shape1, shape2)) return false;
+    }
+
+    return true;
+}
+
+// Ray casting method
+void CollisionDetection::raycast(RaycastCallback* raycastCallback,
+                                        const Ray& ray,
+                                        collisionmask raycastWithCategoryMaskBits) const {
+
+    RP3D_PROFILE("CollisionDetection::raycast()", mProfiler);
+
+    RaycastTest rayCastTest(raycastCallback);
+
+    // Cast the ray against the query-only shapes first and stop if the callback asks for it
+    decimal maxFraction = ray.maxFraction;
+    if (raycastQueryOnlyShapes(ray, rayCastTest, raycastWithCategoryMaskBits, maxFraction)) return;
+
+    // Ask the broad-phase algorithm to call the testRaycastAgainstShape()
+    // callback method for each proxy shape hit by the ray in the broad-phase
+    mBroadPhaseAlgorithm->raycast(Ray(ray.point1, ray.point2, maxFraction), rayCastTest,
+                                  raycastWithCategoryMaskBits);
+}
+
+// Cast a ray against the query-only proxy shapes
+/// The ray is clipped at the hit fractions returned by the callback of the raycast test.
+/**
+ * @param ray The ray to cast
+ * @param raycastTest The raycast test that reports the hits
+ * @param raycastWithCategoryMaskBits Bits mask of the categories of the shapes that can be hit
+ * @param[in,out] maxFraction The maximum fraction of the ray (clipped at the hits)
+ * @return True if the callback has stopped the raycast
+ */
+bool CollisionDetection::raycastQueryOnlyShapes(const Ray& ray, RaycastTest& raycastTest,
+                                                collisionmask raycastWithCategoryMaskBits,
+                                                decimal& maxFraction) const {
+
+    if (mQueryOnlyTree.getNbObjects() == 0) return false;
+
+    bool isStopped = false;
+    auto leafFunction = [&](int nodeId, const Ray& nodeRay) {
+
+        ProxyShape* proxyShape = static_cast<ProxyShape*>(mQueryOnlyTree.getNodeDataPointer(nodeId));
+
+        // Check if the raycast filtering mask allows raycast against this shape
+        if ((raycastWithCategoryMaskBits & proxyShape->getCollisionCategoryBits()) == 0) return decimal(-1.0);
+
+        const decimal hitFraction = raycastTest.raycastAgainstShape(proxyShape, nodeRay);
+        if (hitFraction == decimal(0.0)) {
+            isStopped = true;
+        }
+        else if (hitFraction > decimal(0.0) && hitFraction < maxFraction) {
+            maxFraction = hitFraction;
+        }
+
+        return hitFraction;
+    };
+
+    mQueryOnlyTree.raycastLeaves(Ray(ray.point1, ray.point2, maxFraction), leafFunction, false);
+
+    return isStopped;
+}
+
+// Cast a ray and return its closest hit
+bool CollisionDetection::raycastClosest(const Ray& ray, RaycastHit& hit,
+                                        collisionmask raycastWithCategoryMaskBits) const {
+
+    RP3D_PROFILE("CollisionDetection::raycastClosest()", mProfiler);
+
+    mBroadPhaseAlgorithm->raycastClosest(ray, hit, raycastWithCategoryMaskBits);
+
+    // Cast the ray clipped at the closest hit against the query-only shapes
+    RaycastClosestHitCallback callback;
+    callback.hit = &hit;
+    RaycastTest raycastTest(&callback);
+    decimal maxFraction = hit.hitFraction;
+    raycastQueryOnlyShapes(ray, raycastTest, raycastWithCategoryMaskBits, maxFraction);
+
+    return hit.isHit();
+}
+
+// Return true if a ray hits a shape
+bool CollisionDetection::raycastAny(const Ray& ray, collisionmask raycastWithCategoryMaskBits) const {
+
+    RP3D_PROFILE("CollisionDetection::raycastAny()", mProfiler);
+
+    if (mBroadPhaseAlgorithm->raycastAny(ray, raycastWithCategoryMaskBits)) return true;
+
+    RaycastAnyHitCallback callback;
+    RaycastTest raycastTest(&callback);
+    decimal maxFraction = ray.maxFraction;
+    raycastQueryOnlyShapes(ray, raycastTest, raycastWithCategoryMaskBits, maxFraction);
+
+    return callback.isHit;
+}
+
+// Cast a batch of rays and return the closest hit of each ray
+/// The rays are sorted by the octant of their direction and then along a Morton curve of
+/// their origins. The sorted rays are cast by packets of RAYCAST_PACKET_SIZE rays that
+/// traverse the broad-phase together. If the world has a task scheduler, the packets are
+/// split between the workers. The hit at index i is the closest hit of the ray at index i
+/// (or a hit without proxy shape if the ray does not hit anything).
+/**
+ * @param rays Array with the rays to cast
+ * @param nbRays Number of rays of the batch
+ * @param[out] hits Array with the closest hit of each ray (with nbRays elements)
+ * @param raycastWithCategoryMaskBits Bits mask of the categories of the shapes that can be hit
+ */
+void CollisionDetection::raycastBatch(const Ray* rays, uint nbRays, RaycastHit* hits,
+                                      collisionmask raycastWithCategoryMaskBits) {
+
+    RP3D_PROFILE("CollisionDetection::raycastBatch()", mProfiler);
+
+    if (nbRays == 0) return;
+
+    MemoryAllocator& allocator = mMemoryManager.getBaseAllocator(MemoryTag::BroadPhase);
+
+    // Compute the bounds of the origins of the rays
+    Vector3 originsMin = rays[0].point1;
+    Vector3 originsMax = rays[0].point1;
+    for (uint i=1; i < nbRays; i++) {
+        originsMin = Vector3::min(originsMin, rays[i].point1);
+        originsMax = Vector3::max(originsMax, rays[i].point1);
+    }
+    const Vector3 originsExtent = originsMax - originsMin;
+    const decimal maxCoordinate = decimal(511.0);
+    const Vector3 originsScale(originsExtent.x > decimal(0.0) ? maxCoordinate / originsExtent.x : decimal(0.0),
+                               originsExtent.y > decimal(0.0) ? maxCoordinate / originsExtent.y : decimal(0.0),
+                               originsExtent.z > decimal(0.0) ? maxCoordinate / originsExtent.z : decimal(0.0));
+
+    // Sort the rays (the index of each ray is stored in the low bits of its key)
+    uint64* sortKeys = static_cast<uint64*>(allocator.allocate(nbRays * sizeof(uint64)));
+    for (uint i=0; i < nbRays; i++) {
+        sortKeys[i] = (static_cast<uint64>(computeRaySortKey(rays[i], originsMin, originsScale)) << 32) | i;
+    }
+    std::sort(sortKeys, sortKeys + nbRays);
+
+    // Copy the sorted rays (they are clipped at their hits during the raycast)
+    Ray* sortedRays = static_cast<Ray*>(allocator.allocate(nbRays * sizeof(Ray)));
+    for (uint i=0; i < nbRays; i++) {
+        const Ray& ray = rays[static_cast<uint>(sortKeys[i])];
+        new (sortedRays + i) Ray(ray);
+    }
+
+    const uint nbPackets = (nbRays + RAYCAST_PACKET_SIZE - 1) / RAYCAST_PACKET_SIZE;
+    TaskScheduler* taskScheduler = getTaskScheduler();
+
+    if (taskScheduler != nullptr && nbPackets > RAYCAST_BATCH_CHUNK_SIZE) {
+
+        // The structures built lazily by the queries are built before the workers start
+        mBroadPhaseAlgorithm->prepareParallelQueries();
+
+        const uint nbChunks = (nbPackets + RAYCAST_BATCH_CHUNK_SIZE - 1) / RAYCAST_BATCH_CHUNK_SIZE;
+        const uint nbWorkers = std::min(taskScheduler->getNbWorkers(), nbChunks);
+
+        mMemoryManager.createWorkerAllocators(nbWorkers);
+
+        std::atomic<uint> nextChunkIndex(0);
+
+        taskScheduler->parallelFor(nbWorkers, [&](uint workerIndex) {
+
+            // The raycasts of the concave shapes use the allocator of the worker
+            MemoryAllocator& shapesAllocator = mMemoryManager.getWorkerPoolAllocator(workerIndex);
+
+            // Take the next chunk until all the packets are cast
+            uint chunkIndex = nextChunkIndex.fetch_add(1);
+            while (chunkIndex < nbChunks) {
+
+                const uint startPacket = chunkIndex * RAYCAST_BATCH_CHUNK_SIZE;
+                const uint endPacket = std::min(startPacket + RAYCAST_BATCH_CHUNK_SIZE, nbPackets);
+                raycastPackets(sortedRays, sortKeys, nbRays, hits, startPacket, endPacket,
+                               raycastWithCategoryMaskBits, &shapesAllocator);
+
+                chunkIndex = nextChunkIndex.fetch_add(1);
+            }
+        });
+    }
+    else {
+        raycastPackets(sortedRays, sortKeys, nbRays, hits, 0, nbPackets, raycastWithCategoryMaskBits, nullptr);
+    }
+
+    allocator.release(sortedRays, nbRays * sizeof(Ray));
+    allocator.release(sortKeys, nbRays * sizeof(uint64));
+}
+
+// Cast the packets of rays of a sorted batch in a given range and keep the closest hits
+/// This method may be called by several workers at the same time for different ranges.
+void CollisionDetection::raycastPackets(Ray* sortedRays, const uint64* sortKeys, uint nbRays, RaycastHit* hits,
+                                        uint startPacket, uint endPacket, collisionmask raycastWithCategoryMaskBits,
+                                        MemoryAllocator* shapesAllocator) const {
+
+    RaycastClosestHitCallback callbacks[RAYCAST_PACKET_SIZE];
+    RaycastTest raycastTests[RAYCAST_PACKET_SIZE];
+
+    for (uint p=startPacket; p < endPacket; p++) {
+
+        const uint startRay = p * RAYCAST_PACKET_SIZE;
+        const uint nbPacketRays = std::min(RAYCAST_PACKET_SIZE, nbRays - startRay);
+
+        for (uint i=0; i < nbPacketRays; i++) {
+
+            RaycastHit& hit = hits[static_cast<uint>(sortKeys[startRay + i])];
+            hit = RaycastHit();
+            hit.hitFraction = sortedRays[startRay + i].maxFraction;
+
+            callbacks[i].hit = &hit;
+            raycastTests[i] = RaycastTest(callbacks + i, shapesAllocator);
+        }
+
+        mBroadPhaseAlgorithm->raycastPacket(sortedRays + startRay, nbPacketRays, raycastTests,
+                                            raycastWithCategoryMaskBits);
+
+        // Cast each ray clipped at its closest hit against the query-only shapes
+        if (mQueryOnlyTree.getNbObjects() > 0) {
+            for (uint i=0; i < nbPacketRays; i++) {
+                decimal maxFraction = callbacks[i].hit->hitFraction;
+                raycastQueryOnlyShapes(sortedRays[startRay + i], raycastTests[i], raycastWithCategoryMaskBits,
+                                       maxFraction);
+            }
+        }
+    }
+}
+
+// Return the key used to sort the rays of a batch into coherent packets
+/// The three high bits are the octant of the direction of the ray. The other bits are the
+/// Morton code of the origin of the ray quantized with 9 bits per axis inside the bounds of
+/// the origins of the batch. Rays that go in the same direction from close origins
+/// therefore have close keys.
+uint32 CollisionDetection::computeRaySortKey(const Ray& ray, const Vector3& originsMin,
+                                             const Vector3& originsScale) {
+
+    const Vector3 direction = ray.point2 - ray.point1;
+    const uint32 octant = (direction.x < decimal(0.0) ? 1 : 0) | (direction.y < decimal(0.0) ? 2 : 0) |
+                          (direction.z < decimal(0.0) ? 4 : 0);
+
+    return (octant << 27) | computeMortonCode(ray.point1, originsMin, originsScale);
+}
+
+// Return the Morton code of a point quantized with 9 bits per axis inside some bounds
+/**
+ * @param point The point (inside the bounds)
+ * @param boundsMin Minimum corner of the bounds
+ * @param boundsScale Scale from the bounds to the quantized coordinates (between 0 and 511)
+ * @return The 27 bits Morton code of the point
+ */
+uint32 CollisionDetection::computeMortonCode(const Vector3& point, const Vector3& boundsMin,
+                                             const Vector3& boundsScale) {
+
+    const Vector3 localPoint = point - boundsMin;
+    const uint32 x = static_cast<uint32>(localPoint.x * boundsScale.x);
+    const uint32 y = static_cast<uint32>(localPoint.y * boundsScale.y);
+    const uint32 z = static_cast<uint32>(localPoint.z * boundsScale.z);
+
+    uint32 mortonCode = 0;
+    for (uint32 bit=0; bit < 9; bit++) {
+        mortonCode |= (((x >> bit) & 1) << (3 * bit)) | (((y >> bit) & 1) << (3 * bit + 1)) |
+                      (((z >> bit) & 1) << (3 * bit + 2));
+    }
+
+    return mortonCode;
+}
+
+// Find a proxy shape that contains each point of a batch and return the number of points inside
+/// The points are sorted along a Morton curve of their positions and tested by packets of
+/// POINTS_INSIDE_PACKET_SIZE close points. The broad-phase is traversed once for each packet
+/// with the AABB of its points and each overlapping proxy shape is tested against the points
+/// of the packet inside its fat AABB. If the world has a task scheduler, the packets are
+/// split between the workers.
+/**
+ * @param points Array with the points in world-space coordinates
+ * @param nbPoints Number of points
+ * @param[out] hits Array with a proxy shape that contains each point (or nullptr)
+ * @param categoryMaskBits Bits mask of the categories of the shapes that are tested
+ * @return The number of points that are inside a proxy shape
+ */
+uint CollisionDetection::testPointsInside(const Vector3* points, uint nbPoints, ProxyShape** hits,
+                                          collisionmask categoryMaskBits) {
+
+    RP3D_PROFILE("CollisionDetection::testPointsInside()", mProfiler);
+
+    if (nbPoints == 0) return 0;
+
+    MemoryAllocator& allocator = mMemoryManager.getBaseAllocator(MemoryTag::BroadPhase);
+
+    // Compute the bounds of the points
+    Vector3 pointsMin = points[0];
+    Vector3 pointsMax = points[0];
+    for (uint i=1; i < nbPoints; i++) {
+        pointsMin = Vector3::min(pointsMin, points[i]);
+        pointsMax = Vector3::max(pointsMax, points[i]);
+    }
+    const Vector3 pointsExtent = pointsMax - pointsMin;
+    const decimal maxCoordinate = decimal(511.0);
+    const Vector3 pointsScale(pointsExtent.x > decimal(0.0) ? maxCoordinate / pointsExtent.x : decimal(0.0),
+                              pointsExtent.y > decimal(0.0) ? maxCoordinate / pointsExtent.y : decimal(0.0),
+                              pointsExtent.z > decimal(0.0) ? maxCoordinate / pointsExtent.z : decimal(0.0));
+
+    // Sort the points (the index of each point is stored in the low bits of its key)
+    uint64* sortKeys = static_cast<uint64*>(allocator.allocate(nbPoints * sizeof(uint64)));
+    for (uint i=0; i < nbPoints; i++) {
+        sortKeys[i] = (static_cast<uint64>(computeMortonCode(points[i], pointsMin, pointsScale)) << 32) | i;
+    }
+    std::sort(sortKeys, sortKeys + nbPoints);
+
+    Vector3* sortedPoints = static_cast<Vector3*>(allocator.allocate(nbPoints * sizeof(Vector3)));
+    for (uint i=0; i < nbPoints; i++) {
+        new (sortedPoints + i) Vector3(points[static_cast<uint>(sortKeys[i])]);
+        hits[i] = nullptr;
+    }
+
+    const uint nbPackets = (nbPoints + POINTS_INSIDE_PACKET_SIZE - 1) / POINTS_INSIDE_PACKET_SIZE;
+    TaskScheduler* taskScheduler = getTaskScheduler();
+
+    if (taskScheduler != nullptr && nbPackets > MIN_NB_POINTS_INSIDE_PACKETS_PER_TASK) {
+
+        // The structures built lazily by the queries are built before the workers start
+        mBroadPhaseAlgorithm->prepareParallelQueries();
+
+        taskScheduler->parallelForRange(nbPackets, MIN_NB_POINTS_INSIDE_PACKETS_PER_TASK,
+                                        [&](uint startPacket, uint endPacket) {
+            testPointsInsidePackets(sortedPoints, sortKeys, nbPoints, hits, startPacket, endPacket,
+                                    categoryMaskBits);
+        });
+    }
+    else {
+        testPointsInsidePackets(sortedPoints, sortKeys, nbPoints, hits, 0, nbPackets, categoryMaskBits);
+    }
+
+    allocator.release(sortedPoints, nbPoints * sizeof(Vector3));
+    allocator.release(sortKeys, nbPoints * sizeof(uint64));
+
+    uint nbInsidePoints = 0;
+    for (uint i=0; i < nbPoints; i++) {
+        if (hits[i] != nullptr) nbInsidePoints++;
+    }
+
+    return nbInsidePoints;
+}
+
+// Test the packets of points of a sorted batch in a given range against the proxy shapes
+/// This method may be called by several workers at the same time for different ranges.
+void CollisionDetection::testPointsInsidePackets(const Vector3* sortedPoints, const uint64* sortKeys,
+                                                 uint nbPoints, ProxyShape** hits, uint startPacket,
+                                                 uint endPacket, collisionmask categoryMaskBits) const {
+
+    PointsInsideCallback callback(*this, categoryMaskBits);
+    callback.hits = hits;
+
+    for (uint p=startPacket; p < endPacket; p++) {
+
+        const uint startPoint = p * POINTS_INSIDE_PACKET_SIZE;
+        callback.points = sortedPoints + startPoint;
+        callback.sortKeys = sortKeys + startPoint;
+        callback.nbPoints = std::min(POINTS_INSIDE_PACKET_SIZE, nbPoints - startPoint);
+
+        // Compute the AABB of the points of the packet
+        Vector3 packetMin = callback.points[0];
+        Vector3 packetMax = callback.points[0];
+        for (uint i=1; i < callback.nbPoints; i++) {
+            packetMin = Vector3::min(packetMin, callback.points[i]);
+            packetMax = Vector3::max(packetMax, callback.points[i]);
+        }
+
+        mBroadPhaseAlgorithm->reportAllShapesOverlappingWithAABB(AABB(packetMin, packetMax), callback);
+    }
+}
+
+// Sweep a convex shape between two transforms and report the shapes it hits
+/// The broad-phase is queried with an AABB that contains the shape during the whole
+/// motion and the time of impact with each overlapping shape is computed with the GJK
+/// algorithm. The return value of the callback controls the continuation of the sweep
+/// like the return value of a raycast callback.
+void CollisionDetection::sweep(const ConvexShape* shape, const Transform& startTransform,
+                               const Transform& endTransform, SweepCallback* sweepCallback,
+                               collisionmask sweepWithCategoryMaskBits) {
+
+    RP3D_PROFILE("CollisionDetection::sweep()", mProfiler);
+
+    assert(sweepCallback != nullptr);
+
+    // Ask the broad-phase for the shapes that overlap the swept AABB of the shape
+    const AABB sweptAABB = computeSweptAABB(shape, startTransform, endTransform);
+    List<int> overlappingNodes(mMemoryManager.getPoolAllocator(MemoryTag::NarrowPhase));
+    mBroadPhaseAlgorithm->reportAllShapesOverlappingWithAABB(sweptAABB, overlappingNodes);
+
+    decimal maxFraction = decimal(1.0);
+
+    // For each overlapping proxy shape
+    for (uint i=0; i < overlappingNodes.size(); i++) {
+
+        ProxyShape* proxyShape = mBroadPhaseAlgorithm->getProxyShapeForBroadPhaseId(overlappingNodes[i]);
+
+        // Check if the collision filtering allows the sweep against this shape
+        if ((proxyShape->getCollisionCategoryBits() & sweepWithCategoryMaskBits) == 0 ||
+            !proxyShape->getBody()->isActive()) {
+            continue;
+        }
+
+        SweepInfo sweepInfo;
+        if (!sweepProxyShape(shape, startTransform, endTransform, proxyShape, maxFraction, sweepInfo)) {
+            continue;
+        }
+
+        // Notify the hit to the user
+        const decimal fraction = sweepCallback->notifySweepHit(sweepInfo);
+
+        // If the user wants to stop the sweep
+        if (fraction == decimal(0.0)) {
+            return;
+        }
+
+        // If the user wants to clip the motion
+        if (fraction > decimal(0.0) && fraction < maxFraction) {
+            maxFraction = fraction;
+        }
+    }
+}
+
+// Sweep a convex shape between two transforms and return its earliest hit
+bool CollisionDetection::sweepClosest(const ConvexShape* shape, const Transform& startTransform,
+                                      const Transform& endTransform, SweepInfo& hit,
+                                      collisionmask sweepWithCategoryMaskBits) {
+
+    hit = SweepInfo();
+
+    SweepClosestHitCallback callback;
+    callback.hit = &hit;
+    sweep(shape, startTransform, endTransform, &callback, sweepWithCategoryMaskBits);
+
+    return hit.isHit();
+}
+
+// Return an AABB that contains a convex shape during its motion between two transforms
+/// If the orientation of the shape changes during the motion, the AABB contains the
+/// bounding spheres of the shape (centered at its origin) at the two positions because
+/// the AABBs at the start and end orientations do not contain the rotating shape.
+AABB CollisionDetection::computeSweptAABB(const ConvexShape* shape, const Transform& startTransform,
+                                          const Transform& endTransform) {
+
+    Vector3 minBounds;
+    Vector3 maxBounds;
+    shape->getLocalBounds(minBounds, maxBounds);
+
+    const Vector3& startPosition = startTransform.getPosition();
+    const Vector3& endPosition = endTransform.getPosition();
+
+    if (startTransform.getOrientation() == endTransform.getOrientation()) {
+
+        // Compute the AABB of the local bounds of the shape with its orientation
+        const Vector3 localCenter = decimal(0.5) * (minBounds + maxBounds);
+        const Vector3 localHalfExtents = decimal(0.5) * (maxBounds - minBounds);
+        const Matrix3x3 orientation = startTransform.getOrientation().getMatrix();
+        const Vector3 halfExtents = orientation.getAbsoluteMatrix() * localHalfExtents;
+        const Vector3 center = orientation * localCenter;
+
+        AABB aabb(center - halfExtents + startPosition, center + halfExtents + startPosition);
+        aabb.mergeWithAABB(AABB(center - halfExtents + endPosition, center + halfExtents + endPosition));
+        return aabb;
+    }
+
+    // Radius of a sphere centered at the origin of the shape that contains the shape
+    const Vector3 farthestCorner(std::max(std::abs(minBounds.x), std::abs(maxBounds.x)),
+                                 std::max(std::abs(minBounds.y), std::abs(maxBounds.y)),
+                                 std::max(std::abs(minBounds.z), std::abs(maxBounds.z)));
+    const decimal radius = farthestCorner.length();
+    const Vector3 radiusVector(radius, radius, radius);
+
+    AABB aabb(startPosition - radiusVector, startPosition + radiusVector);
+    aabb.mergeWithAABB(AABB(endPosition - radiusVector, endPosition + radiusVector));
+    return aabb;
+}
+
+// Compute the time of impact of a swept convex shape with a proxy shape of the world
+/// The proxy shape is static during the motion. With a concave shape, the time of impact
+/// is computed with each triangle that overlaps the swept AABB of the shape (in local-space
+/// of the concave shape) and the earliest one is kept (and similarly with the children of
+/// a compound shape). This method returns false if the
+/// proxy shape is not hit before the fraction "maxFraction" of the motion. If the proxy shape
+/// is concave and "hitTriangle" is not null, the earliest hit triangle is also returned.
+bool CollisionDetection::sweepProxyShape(const ConvexShape* shape, const Transform& startTransform,
+                                         const Transform& endTransform, ProxyShape* proxyShape,
+                                         decimal maxFraction, SweepInfo& sweepInfo,
+                                         SweepTriangleHit* hitTriangle) const {
+
+    const Transform proxyShapeToWorld = proxyShape->getLocalToWorldTransform();
+    const CollisionShape* collisionShape = proxyShape->getCollisionShape();
+
+    decimal fraction;
+    Vector3 normal;
+    Vector3 pointOnShape;
+    Vector3 pointOnProxyShape;
+    decimal distance;
+    bool isClosestPointFound;
+
+    if (collisionShape->isConvex()) {
+
+        const ConvexShape* convexShape = static_cast<const ConvexShape*>(collisionShape);
+
+        if (!mGJKAlgorithm.computeTimeOfImpact(shape, startTransform, endTransform, convexShape,
+                                               proxyShapeToWorld, proxyShapeToWorld, fraction, normal) ||
+            fraction > maxFraction) {
+            return false;
+        }
+
+        // Compute the contact point at the time of impact
+        Vector3 closestPointsNormal;
+        isClosestPointFound = mGJKAlgorithm.computeClosestPoints(shape,
+                                  Transform::interpolateTransforms(startTransform, endTransform, fraction),
+                                  convexShape, proxyShapeToWorld, pointOnShape, pointOnProxyShape,
+                                  closestPointsNormal, distance);
+    }
+    else if (collisionShape->getType() == CollisionShapeType::COMPOUND) {
+
+        const CompoundShape* compoundShape = static_cast<const CompoundShape*>(collisionShape);
+
+        // Compute the swept AABB of the shape in local-space of the compound shape
+        const Transform worldToProxyShape = proxyShapeToWorld.getInverse();
+        const AABB localSweptAABB = computeSweptAABB(shape, worldToProxyShape * startTransform,
+                                                     worldToProxyShape * endTransform);
+
+        // Compute the time of impact with the children that overlap the swept AABB and
+        // keep the earliest one
+        bool isHit = false;
+        uint hitChildIndex = 0;
+        auto sweepChild = [&](uint childIndex) {
+
+            const Transform childToWorld = proxyShapeToWorld * compoundShape->getChildTransform(childIndex);
+            decimal childFraction;
+            Vector3 childNormal;
+            if (mGJKAlgorithm.computeTimeOfImpact(shape, startTransform, endTransform,
+                                                  compoundShape->getChildShape(childIndex), childToWorld,
+                                                  childToWorld, childFraction, childNormal) &&
+                childFraction <= maxFraction && (!isHit || childFraction < fraction)) {
+                isHit = true;
+                hitChildIndex = childIndex;
+                fraction = childFraction;
+                normal = childNormal;
+            }
+        };
+        compoundShape->testAllChildShapes(localSweptAABB, sweepChild);
+        if (!isHit) {
+            return false;
+        }
+
+        // Compute the contact point on the earliest hit child at the time of impact
+        const Transform& childTransform = compoundShape->getChildTransform(hitChildIndex);
+        Vector3 pointOnChild;
+        Vector3 closestPointsNormal;
+        isClosestPointFound = mGJKAlgorithm.computeClosestPoints(shape,
+                                  Transform::interpolateTransforms(startTransform, endTransform, fraction),
+                                  compoundShape->getChildShape(hitChildIndex), proxyShapeToWorld * childTransform,
+                                  pointOnShape, pointOnChild, closestPointsNormal, distance);
+        pointOnProxyShape = childTransform * pointOnChild;
+    }
+    else {
+
+        const ConcaveShape* concaveShape = static_cast<const ConcaveShape*>(collisionShape);
+
+        // Compute the swept AABB of the shape in local-space of the concave shape
+        const Transform worldToProxyShape = proxyShapeToWorld.getInverse();
+        const AABB localSweptAABB = computeSweptAABB(shape, worldToProxyShape * startTransform,
+                                                     worldToProxyShape * endTransform);
+
+        // Compute the time of impact with the triangles that overlap the swept AABB
+        SweepTriangleCallback callback(mGJKAlgorithm, shape, startTransform, endTransform,
+                                       proxyShapeToWorld, maxFraction);
+        concaveShape->testAllTriangles(callback, localSweptAABB);
+        if (!callback.isHit) {
+            return false;
+        }
+
+        fraction = callback.hitFraction;
+        normal = callback.hitNormal;
+
+        // Compute the contact point on the earliest hit triangle at the time of impact
+        TriangleShape triangleShape(callback.hitTriangle.vertices, callback.hitTriangle.verticesNormals,
+                                    callback.hitTriangle.shapeId);
+        if (hitTriangle != nullptr) {
+            *hitTriangle = callback.hitTriangle;
+        }
+        Vector3 closestPointsNormal;
+        isClosestPointFound = mGJKAlgorithm.computeClosestPoints(shape,
+                                  Transform::interpolateTransforms(startTransform, endTransform, fraction),
+                                  &triangleShape, proxyShapeToWorld, pointOnShape, pointOnProxyShape,
+                                  closestPointsNormal, distance);
+    }
+
+    // If the shapes overlap at the start of the motion, there is no closest point and
+    // we use the origin of the swept shape at the time of impact as the contact point
+    sweepInfo.worldPoint = isClosestPointFound ? proxyShapeToWorld * pointOnProxyShape :
+                           Transform::interpolateTransforms(startTransform, endTransform, fraction).getPosition();
+    sweepInfo.worldNormal = -normal;
+    sweepInfo.hitFraction = fraction;
+    sweepInfo.body = proxyShape->getBody();
+    sweepInfo.proxyShape = proxyShape;
 
-            // Remove the obsolete last frame collision infos
-            pair->clearObsoleteLastFrameCollisionInfos();
+    return true;
+}
+
+// Compute the distance and the closest points between two convex shapes
+/// The shapes do not have to be attached to bodies of the world.
+/**
+ * @param shape1 The first convex shape
+ * @param shape1ToWorldTransform Local-to-world transform of the first shape
+ * @param shape2 The second convex shape
+ * @param shape2ToWorldTransform Local-to-world transform of the second shape
+ * @param[out] distanceInfo The distance and the closest points of the shapes
+ * @return True if the shapes are separated (and false if they overlap)
+ */
+bool CollisionDetection::computeDistance(const ConvexShape* shape1, const Transform& shape1ToWorldTransform,
+                                         const ConvexShape* shape2, const Transform& shape2ToWorldTransform,
+                                         DistanceInfo& distanceInfo) const {
+
+    RP3D_PROFILE("CollisionDetection::computeDistance()", mProfiler);
+
+    distanceInfo = DistanceInfo();
+    computeShapesDistance(mGJKAlgorithm, shape1, shape1ToWorldTransform, decimal(0.0), shape2,
+                          shape2ToWorldTransform, distanceInfo);
+
+    return !distanceInfo.isOverlapping();
+}
+
+// Compute the distances between the convex shapes of a batch of pairs
+/// The pairs are distributed between the workers of the task scheduler of the world (if
+/// there is one and the batch is large enough).
+/**
+ * @param queries Array with the pairs of shapes
+ * @param nbQueries Number of pairs of shapes
+ * @param[out] distanceInfos Array where the distance of the pair queries[i] is written at index i
+ */
+void CollisionDetection::computeDistanceBatch(const DistanceQuery* queries, uint nbQueries,
+                                              DistanceInfo* distanceInfos) {
+
+    RP3D_PROFILE("CollisionDetection::computeDistanceBatch()", mProfiler);
+
+    auto computeDistances = [this, queries, distanceInfos](uint begin, uint end) {
+        for (uint i=begin; i < end; i++) {
+            distanceInfos[i] = DistanceInfo();
+            computeShapesDistance(mGJKAlgorithm, queries[i].shape1, queries[i].shape1ToWorldTransform, decimal(0.0),
+                                  queries[i].shape2, queries[i].shape2ToWorldTransform, distanceInfos[i]);
         }
+    };
+
+    TaskScheduler* taskScheduler = getTaskScheduler();
+    if (taskScheduler != nullptr && nbQueries > MIN_NB_DISTANCE_QUERIES_PER_TASK) {
+        taskScheduler->parallelForRange(nbQueries, MIN_NB_DISTANCE_QUERIES_PER_TASK, computeDistances);
+    }
+    else {
+        computeDistances(0, nbQueries);
     }
 }
 
-// Compute the concave vs convex middle-phase algorithm for a given pair of bodies
-void CollisionDetection::computeConvexVsConcaveMiddlePhase(OverlappingPair* pair, MemoryAllocator& allocator,
-                                                           NarrowPhaseInfo** firstNarrowPhaseInfo) {
+// Return the closest proxy shape of a point within a maximum distance
+/// The point is a small sphere whose radius is removed from the distances.
+/**
+ * @param point The point in world-space coordinates
+ * @param maxDistance Maximum distance of the proxy shapes
+ * @param[out] hit The closest point on the closest proxy shape (if one is found)
+ * @param categoryMaskBits Bits mask used to filter the proxy shapes
+ * @return True if a proxy shape is closer than the maximum distance
+ */
+bool CollisionDetection::closestPoint(const Vector3& point, decimal maxDistance, DistanceInfo& hit,
+                                      collisionmask categoryMaskBits) const {
+
+    RP3D_PROFILE("CollisionDetection::closestPoint()", mProfiler);
+
+    const SphereShape pointShape(POINT_QUERY_RADIUS);
+    return computeClosestProxyShape(&pointShape, Transform(point, Quaternion::identity()), POINT_QUERY_RADIUS,
+                                    maxDistance, hit, categoryMaskBits);
+}
 
-    ProxyShape* shape1 = pair->getShape1();
-    ProxyShape* shape2 = pair->getShape2();
+// Return the closest proxy shape of a convex shape within a maximum distance
+/**
+ * @param shape The convex shape
+ * @param shapeToWorldTransform Local-to-world transform of the shape
+ * @param maxDistance Maximum distance of the proxy shapes
+ * @param[out] hit The closest points of the shape and of the closest proxy shape (if one is found)
+ * @param categoryMaskBits Bits mask used to filter the proxy shapes
+ * @return True if a proxy shape is closer than the maximum distance
+ */
+bool CollisionDetection::closestPoint(const ConvexShape* shape, const Transform& shapeToWorldTransform,
+                                      decimal maxDistance, DistanceInfo& hit, collisionmask categoryMaskBits) const {
+
+    RP3D_PROFILE("CollisionDetection::closestPoint()", mProfiler);
+
+    return computeClosestProxyShape(shape, shapeToWorldTransform, decimal(0.0), maxDistance, hit, categoryMaskBits);
+}
 
-    ProxyShape* convexProxyShape;
-    ProxyShape* concaveProxyShape;
-    const ConvexShape* convexShape;
-    const ConcaveShape* concaveShape;
+// Return the closest proxy shapes of a batch of points within a maximum distance
+/// The points are distributed between the workers of the task scheduler of the world (if
+/// there is one and the batch is large enough). The queries do not allocate memory.
+/**
+ * @param points Array with the points in world-space coordinates
+ * @param nbPoints Number of points
+ * @param maxDistance Maximum distance of the proxy shapes
+ * @param[out] hits Array where the closest point of the point points[i] is written at index i
+ * @param categoryMaskBits Bits mask used to filter the proxy shapes
+ */
+void CollisionDetection::closestPointBatch(const Vector3* points, uint nbPoints, decimal maxDistance,
+                                           DistanceInfo* hits, collisionmask categoryMaskBits) {
+
+    RP3D_PROFILE("CollisionDetection::closestPointBatch()", mProfiler);
+
+    auto computeClosestPoints = [this, points, maxDistance, hits, categoryMaskBits](uint begin, uint end) {
+        const SphereShape pointShape(POINT_QUERY_RADIUS);
+        for (uint i=begin; i < end; i++) {
+            computeClosestProxyShape(&pointShape, Transform(points[i], Quaternion::identity()), POINT_QUERY_RADIUS,
+                                     maxDistance, hits[i], categoryMaskBits);
+        }
+    };
 
-    // Collision shape 1 is convex, collision shape 2 is concave
-    if (shape1->getCollisionShape()->isConvex()) {
-        convexProxyShape = shape1;
-        convexShape = static_cast<const ConvexShape*>(shape1->getCollisionShape());
-        concaveProxyShape = shape2;
-        concaveShape = static_cast<const ConcaveShape*>(shape2->getCollisionShape());
+    TaskScheduler* taskScheduler = getTaskScheduler();
+    if (taskScheduler != nullptr && nbPoints > MIN_NB_DISTANCE_QUERIES_PER_TASK) {
+
+        // The structures built lazily by the queries are built before the workers start
+        mBroadPhaseAlgorithm->prepareParallelQueries();
+
+        taskScheduler->parallelForRange(nbPoints, MIN_NB_DISTANCE_QUERIES_PER_TASK, computeClosestPoints);
     }
-    else {  // Collision shape 2 is convex, collision shape 1 is concave
-        convexProxyShape = shape2;
-        convexShape = static_cast<const ConvexShape*>(shape2->getCollisionShape());
-        concaveProxyShape = shape1;
-        concaveShape = static_cast<const ConcaveShape*>(shape1->getCollisionShape());
+    else {
+        computeClosestPoints(0, nbPoints);
     }
+}
 
-    // Set the parameters of the callback object
-    MiddlePhaseTriangleCallback middlePhaseCallback(pair, concaveProxyShape, convexProxyShape,
-                                                    concaveShape, allocator);
-
-#ifdef IS_PROFILING_ACTIVE
+// Return the closest proxy shape of a convex shape (shrunk by a distance) within a maximum distance
+/// The broad-phase is queried with the AABB of the shape enlarged by the maximum distance and
+/// the distance to each proxy shape in this AABB is computed with the GJK algorithm.
+bool CollisionDetection::computeClosestProxyShape(const ConvexShape* shape, const Transform& shapeToWorldTransform,
+                                                  decimal shapeShrinkDistance, decimal maxDistance,
+                                                  DistanceInfo& hit, collisionmask categoryMaskBits) const {
 
-	// Set the profiler
-	middlePhaseCallback.setProfiler(mProfiler);
+    assert(maxDistance > decimal(0.0) && maxDistance < DECIMAL_LARGEST);
 
-#endif
+    hit = DistanceInfo();
+    hit.worldPoint1 = shapeToWorldTransform.getPosition();
+    hit.worldPoint2 = hit.worldPoint1;
+    hit.distance = maxDistance;
 
-    // Compute the convex shape AABB in the local-space of the convex shape
-    const Transform convexToConcaveTransform = concaveProxyShape->getLocalToWorldTransform().getInverse() *
-                                               convexProxyShape->getLocalToWorldTransform();
-    AABB aabb;
-    convexShape->computeAABB(aabb, convexToConcaveTransform);
+    AABB aabb = computeSweptAABB(shape, shapeToWorldTransform, shapeToWorldTransform);
+    aabb.inflate(maxDistance, maxDistance, maxDistance);
 
-    // Call the convex vs triangle callback for each triangle of the concave shape
-    concaveShape->testAllTriangles(middlePhaseCallback, aabb);
+    ClosestPointCallback callback(*this, shape, shapeToWorldTransform, shapeShrinkDistance, categoryMaskBits);
+    callback.hit = &hit;
+    mBroadPhaseAlgorithm->reportAllShapesOverlappingWithAABB(aabb, callback);
 
-    // Add all the narrow-phase info object reported by the callback into the
-    // list of all the narrow-phase info object
-    *firstNarrowPhaseInfo = middlePhaseCallback.narrowPhaseInfoList;
+    return hit.isHit();
 }
 
-// Compute the narrow-phase collision detection
-void CollisionDetection::computeNarrowPhase() {
-
-    RP3D_PROFILE("CollisionDetection::computeNarrowPhase()", mProfiler);
+// Compute the distance between a convex shape and a proxy shape if it is smaller than a maximum distance
+/// With a concave shape, the distance is computed with each triangle that overlaps the AABB of
+/// the convex shape enlarged by the maximum distance (in local-space of the concave shape) and
+/// the closest one is kept (and similarly with the children of a compound shape). This method
+/// returns false if the proxy shape is not closer than the maximum distance.
+bool CollisionDetection::computeProxyShapeDistance(const ConvexShape* shape, const Transform& shapeToWorldTransform,
+                                                   decimal shapeShrinkDistance, ProxyShape* proxyShape,
+                                                   decimal maxDistance, DistanceInfo& distanceInfo) const {
 
-    NarrowPhaseInfo* currentNarrowPhaseInfo = mNarrowPhaseInfoList;
-    while (currentNarrowPhaseInfo != nullptr) {
+    const Transform proxyShapeToWorld = proxyShape->getLocalToWorldTransform();
+    const CollisionShape* collisionShape = proxyShape->getCollisionShape();
 
-        // Select the narrow phase algorithm to use according to the two collision shapes
-        const CollisionShapeType shape1Type = currentNarrowPhaseInfo->collisionShape1->getType();
-        const CollisionShapeType shape2Type = currentNarrowPhaseInfo->collisionShape2->getType();
-        NarrowPhaseAlgorithm* narrowPhaseAlgorithm = selectNarrowPhaseAlgorithm(shape1Type, shape2Type);
+    bool isFound;
 
-        // If there is no collision algorithm between those two kinds of shapes, skip it
-        if (narrowPhaseAlgorithm != nullptr) {
+    if (collisionShape->isConvex()) {
 
-            LastFrameCollisionInfo* lastCollisionFrameInfo = currentNarrowPhaseInfo->getLastFrameCollisionInfo();
+        computeShapesDistance(mGJKAlgorithm, shape, shapeToWorldTransform, shapeShrinkDistance,
+                              static_cast<const ConvexShape*>(collisionShape), proxyShapeToWorld, distanceInfo);
+        isFound = distanceInfo.distance < maxDistance;
+    }
+    else {
 
-            // Use the narrow-phase collision detection algorithm to check
-            // if there really is a collision. If a collision occurs, the
-            // notifyContact() callback method will be called.
-            if (narrowPhaseAlgorithm->testCollision(currentNarrowPhaseInfo, true, mMemoryManager.getSingleFrameAllocator())) {
+        // Compute the AABB of the shape enlarged by the maximum distance in local-space of the proxy shape
+        const Transform shapeToProxyShape = proxyShapeToWorld.getInverse() * shapeToWorldTransform;
+        AABB localAABB = computeSweptAABB(shape, shapeToProxyShape, shapeToProxyShape);
+        localAABB.inflate(maxDistance, maxDistance, maxDistance);
 
-                // Add the contact points as a potential contact manifold into the pair                
-                currentNarrowPhaseInfo->addContactPointsAsPotentialContactManifold();
+        distanceInfo.distance = maxDistance;
 
-                lastCollisionFrameInfo->wasColliding = true;
-            }
-            else {
-                lastCollisionFrameInfo->wasColliding = false;
-            }
+        if (collisionShape->getType() == CollisionShapeType::COMPOUND) {
 
-            // The previous frame collision info is now valid
-            lastCollisionFrameInfo->isValid = true;
-        }
+            const CompoundShape* compoundShape = static_cast<const CompoundShape*>(collisionShape);
 
-        NarrowPhaseInfo* narrowPhaseInfoToDelete = currentNarrowPhaseInfo;
-        currentNarrowPhaseInfo = currentNarrowPhaseInfo->next;
+            // Compute the distance with the children that overlap the AABB and keep the closest one
+            isFound = false;
+            auto computeChildDistance = [&](uint childIndex) {
 
-        // Call the destructor
-        narrowPhaseInfoToDelete->~NarrowPhaseInfo();
+                DistanceInfo childDistanceInfo;
+                computeShapesDistance(mGJKAlgorithm, shape, shapeToWorldTransform, shapeShrinkDistance,
+                                      compoundShape->getChildShape(childIndex),
+                                      proxyShapeToWorld * compoundShape->getChildTransform(childIndex),
+                                      childDistanceInfo);
+                if (childDistanceInfo.distance < distanceInfo.distance) {
+                    distanceInfo = childDistanceInfo;
+                    isFound = true;
+                }
+            };
+            compoundShape->testAllChildShapes(localAABB, computeChildDistance);
+        }
+        else {
 
-        // Release the allocated memory for the narrow phase info
-        mMemoryManager.release(MemoryManager::AllocationType::Frame, narrowPhaseInfoToDelete, sizeof(NarrowPhaseInfo));
+            // Compute the distance with the triangles that overlap the AABB and keep the closest one
+            DistanceTriangleCallback callback(mGJKAlgorithm, shape, shapeToWorldTransform, shapeShrinkDistance,
+                                              proxyShapeToWorld, distanceInfo);
+            static_cast<const ConcaveShape*>(collisionShape)->testAllTriangles(callback, localAABB);
+            isFound = callback.isFound;
+        }
     }
 
-    // Convert the potential contact into actual contacts
-    processAllPotentialContacts();
+    if (!isFound) return false;
 
-    // Add all the contact manifolds (between colliding bodies) to the bodies
-    addAllContactManifoldsToBodies();
+    distanceInfo.body = proxyShape->getBody();
+    distanceInfo.proxyShape = proxyShape;
 
-    // Report contacts to the user
-    reportAllContacts();
+    return true;
 }
 
-// Allow the broadphase to notify the collision detection about an overlapping pair.
-/// This method is called by the broad-phase collision detection algorithm
-void CollisionDetection::broadPhaseNotifyOverlappingPair(ProxyShape* shape1, ProxyShape* shape2) {
+// Compute the distance between two convex shapes (the first one is shrunk by a distance)
+/// The distance computed by the GJK algorithm is increased by the shrink distance of the first
+/// shape and its closest point is moved by this distance along the normal. A point query is a
+/// sphere shrunk by its radius. If the shapes overlap, the distance is zero.
+void CollisionDetection::computeShapesDistance(const GJKAlgorithm& gjkAlgorithm,
+                                               const ConvexShape* shape1, const Transform& shape1ToWorldTransform,
+                                               decimal shape1ShrinkDistance, const ConvexShape* shape2,
+                                               const Transform& shape2ToWorldTransform, DistanceInfo& distanceInfo) {
+
+    Vector3 localPoint1;
+    Vector3 localPoint2;
+    Vector3 normal;
+    decimal distance;
+    if (gjkAlgorithm.computeClosestPoints(shape1, shape1ToWorldTransform, shape2, shape2ToWorldTransform,
+                                          localPoint1, localPoint2, normal, distance)) {
+
+        distance += shape1ShrinkDistance;
+        if (distance > decimal(0.0)) {
+            distanceInfo.worldPoint1 = shape1ToWorldTransform * localPoint1 - shape1ShrinkDistance * normal;
+            distanceInfo.worldPoint2 = shape2ToWorldTransform * localPoint2;
+            distanceInfo.worldNormal = normal;
+            distanceInfo.distance = distance;
+            return;
+        }
+    }
 
-    assert(shape1->getBroadPhaseId() != -1);
-    assert(shape2->getBroadPhaseId() != -1);
-    assert(shape1->getBroadPhaseId() != shape2->getBroadPhaseId());
+    // The shapes overlap
+    distanceInfo.worldPoint1 = shape1ToWorldTransform.getPosition();
+    distanceInfo.worldPoint2 = distanceInfo.worldPoint1;
+    distanceInfo.worldNormal.setToZero();
+    distanceInfo.distance = decimal(0.0);
+}
 
-    // Check if the collision filtering allows collision between the two shapes
-    if ((shape1->getCollideWithMaskBits() & shape2->getCollisionCategoryBits()) == 0 ||
-        (shape1->getCollisionCategoryBits() & shape2->getCollideWithMaskBits()) == 0) return;
+// Compute the distance between the convex shape and a triangle
+void DistanceTriangleCallback::testTriangle(const Vector3* trianglePoints, const Vector3* verticesNormals,
+                                            uint shapeId) {
 
-    // Compute the overlapping pair ID
-    Pair<uint, uint> pairID = OverlappingPair::computeID(shape1, shape2);
+    TriangleShape triangleShape(trianglePoints, verticesNormals, shapeId);
+
+    DistanceInfo distanceInfo;
+    CollisionDetection::computeShapesDistance(mGJKAlgorithm, mConvexShape, mConvexShapeToWorldTransform,
+                                              mConvexShapeShrinkDistance, &triangleShape,
+                                              mConcaveShapeToWorldTransform, distanceInfo);
+    if (distanceInfo.distance < mDistanceInfo.distance) {
+        mDistanceInfo = distanceInfo;
+        isFound = true;
+    }
+}
 
-    // Check if the overlapping pair already exists
-    if (mOverlappingPairs.containsKey(pairID)) return;
+// Keep the proxy shape of a broad-phase ID if it is closer than the closest one so far
+void ClosestPointCallback::notifyOverlappingNode(int broadPhaseId) {
 
-    // Create the overlapping pair and add it into the set of overlapping pairs
-    OverlappingPair* newPair = new (mMemoryManager.allocate(MemoryManager::AllocationType::Pool, sizeof(OverlappingPair)))
-                              OverlappingPair(shape1, shape2, mMemoryManager.getPoolAllocator(),
-                                              mMemoryManager.getSingleFrameAllocator(), mWorld->mConfig);
-    assert(newPair != nullptr);
+    ProxyShape* proxyShape = mCollisionDetection.mBroadPhaseAlgorithm->getProxyShapeForBroadPhaseId(broadPhaseId);
 
-    mOverlappingPairs.add(Pair<Pair<uint, uint>, OverlappingPair*>(pairID, newPair));
+    // Check if the collision filtering allows the query against this shape
+    if ((proxyShape->getCollisionCategoryBits() & mCategoryMaskBits) == 0 || !proxyShape->getBody()->isActive()) {
+        return;
+    }
 
-    // Wake up the two bodies
-    shape1->getBody()->setIsSleeping(false);
-    shape2->getBody()->setIsSleeping(false);
+    DistanceInfo distanceInfo;
+    if (mCollisionDetection.computeProxyShapeDistance(mShape, mShapeToWorldTransform, mShapeShrinkDistance,
+                                                      proxyShape, hit->distance, distanceInfo)) {
+        *hit = distanceInfo;
+    }
 }
 
-// Remove a body from the collision detection
-void CollisionDetection::removeProxyCollisionShape(ProxyShape* proxyShape) {
+// Test the points of the packet against the proxy shape of a broad-phase ID
+void PointsInsideCallback::notifyOverlappingNode(int broadPhaseId) {
 
-    assert(proxyShape->getBroadPhaseId() != -1);
+    ProxyShape* proxyShape = mCollisionDetection.mBroadPhaseAlgorithm->getProxyShapeForBroadPhaseId(broadPhaseId);
+
+    // Check if the collision filtering allows the query against this shape
+    if ((proxyShape->getCollisionCategoryBits() & mCategoryMaskBits) == 0 || !proxyShape->getBody()->isActive()) {
+        return;
+    }
 
-    // Remove all the overlapping pairs involving this proxy shape
-    Map<Pair<uint, uint>, OverlappingPair*>::Iterator it;
-    for (it = mOverlappingPairs.begin(); it != mOverlappingPairs.end(); ) {
-        if (it->second->getShape1()->getBroadPhaseId() == proxyShape->getBroadPhaseId()||
-            it->second->getShape2()->getBroadPhaseId() == proxyShape->getBroadPhaseId()) {
+    const AABB& fatAABB = mCollisionDetection.mBroadPhaseAlgorithm->getFatAABB(broadPhaseId);
 
-            // TODO : Remove all the contact manifold of the overlapping pair from the contact manifolds list of the two bodies involved
+    for (uint i=0; i < nbPoints; i++) {
 
-            // Destroy the overlapping pair
-            it->second->~OverlappingPair();
-            mWorld->mMemoryManager.release(MemoryManager::AllocationType::Pool, it->second, sizeof(OverlappingPair));
-            it = mOverlappingPairs.remove(it);
-        }
-        else {
-            ++it;
+        ProxyShape*& hit = hits[static_cast<uint>(sortKeys[i])];
+        if (hit != nullptr || !fatAABB.contains(points[i])) continue;
+
+        if (proxyShape->testPointInside(points[i])) {
+            hit = proxyShape;
         }
     }
-
-    // Remove the body from the broad-phase
-    mBroadPhaseAlgorithm.removeProxyCollisionShape(proxyShape);
 }
 
-void CollisionDetection::addAllContactManifoldsToBodies() {
+// Compute the contacts between the convex shape and a triangle
+void ContactHitsTriangleCallback::testTriangle(const Vector3* trianglePoints, const Vector3* verticesNormals,
+                                               uint shapeId) {
 
-    RP3D_PROFILE("CollisionDetection::addAllContactManifoldsToBodies()", mProfiler);
+    if (nbHits == mMaxNbHits) return;
 
-    // For each overlapping pairs in contact during the narrow-phase
-    Map<Pair<uint, uint>, OverlappingPair*>::Iterator it;
-    for (it = mOverlappingPairs.begin(); it != mOverlappingPairs.end(); ++it) {
+    TriangleShape triangleShape(trianglePoints, verticesNormals, shapeId);
 
-        // Add all the contact manifolds of the pair into the list of contact manifolds
-        // of the two bodies involved in the contact
-        addContactManifoldToBody(it->second);
+    // The convexity of the edges of the triangles of a concave mesh is precomputed by its triangle mesh
+    if (mConcaveShape->getName() == CollisionShapeName::TRIANGLE_MESH) {
+        triangleShape.mEdgesConvexity = static_cast<const ConcaveMeshShape*>(mConcaveShape)->getTriangleEdgesConvexity(shapeId);
+    }
+
+    if (mIsShape1Convex) {
+        mCollisionDetection.computeContactHits(mProxyShape1, mProxyShape2, mConvexShape, mConvexShapeToWorldTransform,
+                                               &triangleShape, mConcaveShapeToWorldTransform, mHits, mMaxNbHits, nbHits);
+    }
+    else {
+        mCollisionDetection.computeContactHits(mProxyShape1, mProxyShape2, &triangleShape, mConcaveShapeToWorldTransform,
+                                               mConvexShape, mConvexShapeToWorldTransform, mHits, mMaxNbHits, nbHits);
     }
 }
 
-// Ray casting method
-void CollisionDetection::raycast(RaycastCallback* raycastCallback,
-                                        const Ray& ray,
-                                        unsigned short raycastWithCategoryMaskBits) const {
+// Test if the convex shape overlaps with a triangle
+void OverlapTriangleCallback::testTriangle(const Vector3* trianglePoints, const Vector3* verticesNormals,
+                                           uint shapeId) {
 
-    RP3D_PROFILE("CollisionDetection::raycast()", mProfiler);
+    if (isOverlapping) return;
 
-    RaycastTest rayCastTest(raycastCallback);
+    TriangleShape triangleShape(trianglePoints, verticesNormals, shapeId);
+    isOverlapping = mGJKAlgorithm.testOverlap(mConvexShape, mConvexShapeToWorldTransform,
+                                              &triangleShape, mConcaveShapeToWorldTransform);
+}
 
-    // Ask the broad-phase algorithm to call the testRaycastAgainstShape()
-    // callback method for each proxy shape hit by the ray in the broad-phase
-    mBroadPhaseAlgorithm.raycast(ray, rayCastTest, raycastWithCategoryMaskBits);
+// Store the proxy shape of a broad-phase ID in the array if it overlaps with the tested shape
+void OverlapHitsCallback::notifyOverlappingNode(int broadPhaseId) {
+
+    if (nbHits == mMaxNbHits) return;
+
+    ProxyShape* proxyShape = isQueryOnlyTree ?
+                static_cast<ProxyShape*>(mCollisionDetection.mQueryOnlyTree.getNodeDataPointer(broadPhaseId)) :
+                mCollisionDetection.mBroadPhaseAlgorithm->getProxyShapeForBroadPhaseId(broadPhaseId);
+
+    // Check if the collision filtering allows the overlap with this shape
+    if ((proxyShape->getCollisionCategoryBits() & mCategoryMaskBits) == 0) return;
+
+    if (mIgnoredBody != nullptr) {
+
+        if (proxyShape->getBody() == mIgnoredBody) return;
+
+        // The proxy shape may have already been reported with another shape of the body
+        for (uint i=0; i < nbHits; i++) {
+            if (mHits[i].proxyShape == proxyShape) return;
+        }
+    }
+
+    if (mShape != nullptr && !mCollisionDetection.testShapeOverlap(mShape, mShapeToWorldTransform, proxyShape)) {
+        return;
+    }
+
+    mHits[nbHits].body = proxyShape->getBody();
+    mHits[nbHits].proxyShape = proxyShape;
+    nbHits++;
+}
+
+// Compute the time of impact of the swept shape with a triangle
+void SweepTriangleCallback::testTriangle(const Vector3* trianglePoints, const Vector3* verticesNormals,
+                                         uint shapeId) {
+
+    TriangleShape triangleShape(trianglePoints, verticesNormals, shapeId);
+
+    decimal fraction;
+    Vector3 normal;
+    if (mGJKAlgorithm.computeTimeOfImpact(mShape, mStartTransform, mEndTransform, &triangleShape,
+                                          mConcaveShapeToWorldTransform, mConcaveShapeToWorldTransform,
+                                          fraction, normal) && fraction <= hitFraction) {
+
+        isHit = true;
+        hitFraction = fraction;
+        hitNormal = normal;
+        hitTriangle.shapeId = shapeId;
+        for (int i=0; i < 3; i++) {
+            hitTriangle.vertices[i] = trianglePoints[i];
+            hitTriangle.verticesNormals[i] = verticesNormals[i];
+        }
+    }
 }
 
-// Add a contact manifold to the linked list of contact manifolds of the two bodies involved
-// in the corresponding contact
-void CollisionDetection::addContactManifoldToBody(OverlappingPair* pair) {
+// Add the contact manifolds of a pair to the contact manifolds of its two bodies
+/// A body whose range has not been assigned yet gets the next free range of the contiguous
+/// array. The index of a body then moves down from the end of its range as it is filled.
+/**
+ * @param pair The overlapping pair with the contact manifolds
+ * @param[in,out] nbAssignedContactManifolds Number of elements of the array in the assigned ranges
+ */
+void CollisionDetection::addContactManifoldToBody(OverlappingPair* pair, uint& nbAssignedContactManifolds) {
 
     assert(pair != nullptr);
 
@@ -409,37 +2528,57 @@ void CollisionDetection::addContactManifoldToBody(OverlappingPair* pair) {
 
         assert(contactManifold->getNbContactPoints() > 0);
 
-        // Add the contact manifold at the beginning of the linked
-        // list of contact manifolds of the first body
-        ContactManifoldListElement* listElement1 = new (mMemoryManager.allocate(MemoryManager::AllocationType::Pool,
-                                                                                sizeof(ContactManifoldListElement)))
-                                                      ContactManifoldListElement(contactManifold,
-                                                                         body1->mContactManifoldsList);
-        body1->mContactManifoldsList = listElement1;
-
-        // Add the contact manifold at the beginning of the linked
-        // list of the contact manifolds of the second body
-        ContactManifoldListElement* listElement2 = new (mMemoryManager.allocate(MemoryManager::AllocationType::Pool,
-                                                                                sizeof(ContactManifoldListElement)))
-                                                      ContactManifoldListElement(contactManifold,
-                                                                         body2->mContactManifoldsList);
-        body2->mContactManifoldsList = listElement2;
+        // Add the contact manifold at the beginning of the range of each body
+        CollisionBody* bodies[2] = {body1, body2};
+        for (int b=0; b < 2; b++) {
+
+            CollisionBody* body = bodies[b];
+            if (body->mContactManifoldsIndex == INVALID_CONTACT_MANIFOLDS_INDEX) {
+                nbAssignedContactManifolds += body->mNbContactManifolds;
+                body->mContactManifoldsIndex = nbAssignedContactManifolds;
+            }
+
+            body->mContactManifoldsIndex--;
+            mBodiesContactManifolds[body->mContactManifoldsIndex] = contactManifold;
+        }
 
         contactManifold = contactManifold->getNext();
     }
 }
 
+// Allocate the memory needed to store a given number of proxy shapes in the broad-phase
+void CollisionDetection::reserveProxyShapes(uint nbProxyShapes) {
+    mBroadPhaseAlgorithm->reserve(nbProxyShapes);
+}
+
+// Allocate the memory needed to store a given number of overlapping pairs
+/// The memory of the pairs is also reserved in the pool allocator
+void CollisionDetection::reservePairs(uint nbPairs) {
+
+    mOverlappingPairs.reserve(nbPairs);
+    mOrderedOverlappingPairs.reserve(nbPairs);
+    mMemoryManager.reservePoolMemory(sizeof(OverlappingPair), nbPairs);
+}
+
+// Allocate the memory needed to add a given number of contact manifolds to the bodies
+/// Each contact manifold needs an element in the contact manifolds of its two bodies.
+/// The memory of the contact manifolds is also reserved in the pool allocator.
+void CollisionDetection::reserveContactManifolds(uint nbContactManifolds) {
+
+    mMemoryManager.reservePoolMemory(sizeof(ContactManifold), nbContactManifolds);
+    mBodiesContactManifolds.reserve(2 * nbContactManifolds);
+}
+
 /// Convert the potential contact into actual contacts
 void CollisionDetection::processAllPotentialContacts() {
 
     RP3D_PROFILE("CollisionDetection::processAllPotentialContacts()", mProfiler);
 
     // For each overlapping pairs in contact during the narrow-phase
-    Map<Pair<uint, uint>, OverlappingPair*>::Iterator it;
-    for (it = mOverlappingPairs.begin(); it != mOverlappingPairs.end(); ++it) {
+    for (uint i=0; i < mOrderedOverlappingPairs.size(); i++) {
 
         // Process the potential contacts of the overlapping pair
-        processPotentialContacts(it->second);
+        processPotentialContacts(mOrderedOverlappingPairs[i]);
     }
 }
 
@@ -473,14 +2612,39 @@ void CollisionDetection::reportAllContacts() {
 
     RP3D_PROFILE("CollisionDetection::reportAllContacts()", mProfiler);
 
+    const bool isStayEventReported = mWorld->mConfig.isContactStayEventReported;
+
+    mContactManifolds.clear();
+
     // For each overlapping pairs in contact during the narrow-phase
-    Map<Pair<uint, uint>, OverlappingPair*>::Iterator it;
-    for (it = mOverlappingPairs.begin(); it != mOverlappingPairs.end(); ++it) {
+    for (uint i=0; i < mOrderedOverlappingPairs.size(); i++) {
+
+        OverlappingPair* pair = mOrderedOverlappingPairs[i];
+        const bool hasContacts = pair->hasContacts();
+
+        // Add a contact event if the pair starts, keeps or stops touching. The events of
+        // a trigger are reported during the middle-phase
+        if (!pair->isTrigger()) {
+            if (hasContacts != pair->hadContacts()) {
+                addContactEvent(pair, hasContacts ? ContactEventType::CONTACT_BEGIN : ContactEventType::CONTACT_END);
+                pair->setHadContacts(hasContacts);
+            }
+            else if (hasContacts && isStayEventReported) {
+                addContactEvent(pair, ContactEventType::CONTACT_STAY);
+            }
+        }
+
+        // Add the contact manifolds of the pair to the list of contact manifolds of the world
+        const ContactManifold* manifold = pair->getContactManifoldSet().getContactManifolds();
+        while (manifold != nullptr) {
+            mContactManifolds.add(manifold);
+            manifold = manifold->getNext();
+        }
 
         // If there is a user callback
-        if (mWorld->mEventListener != nullptr && it->second->hasContacts()) {
+        if (mWorld->mEventListener != nullptr && hasContacts) {
 
-            CollisionCallback::CollisionCallbackInfo collisionInfo(it->second, mMemoryManager);
+            CollisionCallback::CollisionCallbackInfo collisionInfo(pair, mMemoryManager);
 
             // Trigger a callback event to report the new contact to the user
              mWorld->mEventListener->newContact(collisionInfo);
@@ -488,6 +2652,23 @@ void CollisionDetection::reportAllContacts() {
     }
 }
 
+// Add a contact event for an overlapping pair to the buffer of contact events
+void CollisionDetection::addContactEvent(OverlappingPair* pair, ContactEventType type) {
+
+    ProxyShape* shape1 = pair->getShape1();
+    ProxyShape* shape2 = pair->getShape2();
+
+    ContactEvent event;
+    event.type = type;
+    event.body1 = shape1->getBody();
+    event.body2 = shape2->getBody();
+    event.proxyShape1 = shape1;
+    event.proxyShape2 = shape2;
+    event.nbContactPoints = type == ContactEventType::CONTACT_END ? 0 :
+                            uint(pair->getContactManifoldSet().getTotalNbContactPoints());
+    mContactEvents.add(event);
+}
+
 // Compute the middle-phase collision detection between two proxy shapes
 NarrowPhaseInfo* CollisionDetection::computeMiddlePhaseForProxyShapes(OverlappingPair* pair) {
 
@@ -503,15 +2684,23 @@ NarrowPhaseInfo* CollisionDetection::computeMiddlePhaseForProxyShapes(Overlappin
 
     pair->makeLastFrameCollisionInfosObsolete();
 
+    // If one of the shapes is a compound shape
+    if (shape1->getCollisionShape()->getType() == CollisionShapeType::COMPOUND ||
+        shape2->getCollisionShape()->getType() == CollisionShapeType::COMPOUND) {
+
+        // Find the children of the compound shapes that we need to use during the narrow-phase
+        computeCompoundMiddlePhase(pair, mMemoryManager.getPoolAllocator(MemoryTag::NarrowPhase), mMiddlePhaseTriangles,
+                                   &narrowPhaseInfo, true);
+    }
     // If both shapes are convex
-    if ((isShape1Convex && isShape2Convex)) {
+    else if ((isShape1Convex && isShape2Convex)) {
 
         // No middle-phase is necessary, simply create a narrow phase info
         // for the narrow-phase collision detection
         narrowPhaseInfo = new (mMemoryManager.allocate(MemoryManager::AllocationType::Pool,
-                                                       sizeof(NarrowPhaseInfo))) NarrowPhaseInfo(pair, shape1->getCollisionShape(),
+                                                       sizeof(NarrowPhaseInfo), MemoryTag::NarrowPhase)) NarrowPhaseInfo(pair, shape1->getCollisionShape(),
                                        shape2->getCollisionShape(), shape1->getLocalToWorldTransform(),
-                                       shape2->getLocalToWorldTransform(), mMemoryManager.getPoolAllocator());
+                                       shape2->getLocalToWorldTransform(), mMemoryManager.getPoolAllocator(MemoryTag::NarrowPhase));
 
     }
     // Concave vs Convex algorithm
@@ -519,7 +2708,8 @@ NarrowPhaseInfo* CollisionDetection::computeMiddlePhaseForProxyShapes(Overlappin
 
         // Run the middle-phase collision detection algorithm to find the triangles of the concave
         // shape we need to use during the narrow-phase collision detection
-        computeConvexVsConcaveMiddlePhase(pair, mMemoryManager.getPoolAllocator(), &narrowPhaseInfo);
+        computeConvexVsConcaveMiddlePhase(pair, mMemoryManager.getPoolAllocator(MemoryTag::NarrowPhase), mMiddlePhaseTriangles,
+                                          &narrowPhaseInfo, true);
     }
 
     pair->clearObsoleteLastFrameCollisionInfos();
@@ -529,22 +2719,29 @@ NarrowPhaseInfo* CollisionDetection::computeMiddlePhaseForProxyShapes(Overlappin
 
 // Report all the bodies that overlap with the aabb in parameter
 void CollisionDetection::testAABBOverlap(const AABB& aabb, OverlapCallback* overlapCallback,
-                                         unsigned short categoryMaskBits) {
+                                         collisionmask categoryMaskBits) {
     assert(overlapCallback != nullptr);
 
-    Set<bodyindex> reportedBodies(mMemoryManager.getPoolAllocator());
+    Set<bodyindex> reportedBodies(mMemoryManager.getPoolAllocator(MemoryTag::NarrowPhase));
 
     // Ask the broad-phase to get all the overlapping shapes
-    LinkedList<int> overlappingNodes(mMemoryManager.getPoolAllocator());
-    mBroadPhaseAlgorithm.reportAllShapesOverlappingWithAABB(aabb, overlappingNodes);
+    List<int> overlappingNodes(mMemoryManager.getPoolAllocator(MemoryTag::NarrowPhase));
+    mBroadPhaseAlgorithm->reportAllShapesOverlappingWithAABB(aabb, overlappingNodes);
+
+    // The overlapping query-only shapes are stored after the ones of the broad-phase
+    const uint nbBroadPhaseNodes = overlappingNodes.size();
+    if (mQueryOnlyTree.getNbObjects() > 0) {
+        AABBOverlapCallback queryOnlyCallback(overlappingNodes);
+        mQueryOnlyTree.reportAllShapesOverlappingWithAABB(aabb, queryOnlyCallback);
+    }
 
     // For each overlaping proxy shape
-    LinkedList<int>::ListElement* element = overlappingNodes.getListHead();
-    while (element != nullptr) {
+    for (uint i=0; i < overlappingNodes.size(); i++) {
 
         // Get the overlapping proxy shape
-        int broadPhaseId = element->data;
-        ProxyShape* proxyShape = mBroadPhaseAlgorithm.getProxyShapeForBroadPhaseId(broadPhaseId);
+        int nodeId = overlappingNodes[i];
+        ProxyShape* proxyShape = i < nbBroadPhaseNodes ? mBroadPhaseAlgorithm->getProxyShapeForBroadPhaseId(nodeId) :
+                                 static_cast<ProxyShape*>(mQueryOnlyTree.getNodeDataPointer(nodeId));
 
         CollisionBody* overlapBody = proxyShape->getBody();
 
@@ -561,94 +2758,322 @@ void CollisionDetection::testAABBOverlap(const AABB& aabb, OverlapCallback* over
                 overlapCallback->notifyOverlap(overlapBody);
             }
         }
+    }
+}
+
+// Fill an array with the proxy shapes whose AABBs overlap with the aabb in parameter
+/// Unlike the query with an OverlapCallback, each overlapping proxy shape is reported
+/// (not only each body) and nothing is allocated. If more proxy shapes overlap with the
+/// AABB than the size of the array, only the first ones are stored.
+uint CollisionDetection::testAABBOverlap(const AABB& aabb, OverlapHit* hits, uint maxNbHits,
+                                         collisionmask categoryMaskBits) const {
+
+    RP3D_PROFILE("CollisionDetection::testAABBOverlap()", mProfiler);
+
+    OverlapHitsCallback callback(*this, hits, maxNbHits, categoryMaskBits);
+    mBroadPhaseAlgorithm->reportAllShapesOverlappingWithAABB(aabb, callback);
+
+    // Search the query-only shapes as well
+    if (callback.nbHits < maxNbHits && mQueryOnlyTree.getNbObjects() > 0) {
+        callback.isQueryOnlyTree = true;
+        mQueryOnlyTree.reportAllShapesOverlappingWithAABB(aabb, callback);
+    }
+
+    return callback.nbHits;
+}
+
+// Fill an array with the proxy shapes of the other bodies that overlap with a body
+/// Each overlapping proxy shape is reported once, even if it overlaps with several proxy
+/// shapes of the body. The overlaps are tested with the GJK algorithm without creating
+/// any narrow-phase info.
+uint CollisionDetection::testOverlap(const CollisionBody* body, OverlapHit* hits, uint maxNbHits,
+                                     collisionmask categoryMaskBits) const {
+
+    RP3D_PROFILE("CollisionDetection::testOverlap()", mProfiler);
+
+    uint nbHits = 0;
+
+    // For each proxy shape of the body
+    const ProxyShape* bodyProxyShape = body->getProxyShapesList();
+    while (bodyProxyShape != nullptr && nbHits < maxNbHits) {
+
+        OverlapHitsCallback callback(*this, hits, maxNbHits, categoryMaskBits, bodyProxyShape->getCollisionShape(),
+                                     bodyProxyShape->getLocalToWorldTransform(), body);
+        callback.nbHits = nbHits;
+        mBroadPhaseAlgorithm->reportAllShapesOverlappingWithAABB(bodyProxyShape->getWorldAABB(), callback);
+        nbHits = callback.nbHits;
+
+        bodyProxyShape = bodyProxyShape->getNext();
+    }
+
+    return nbHits;
+}
+
+// Fill an array with the proxy shapes that overlap with a convex shape at a given transform
+/// The shape does not have to be attached to a body of the world.
+uint CollisionDetection::testOverlap(const ConvexShape* shape, const Transform& shapeToWorldTransform,
+                                     OverlapHit* hits, uint maxNbHits, collisionmask categoryMaskBits) const {
+
+    RP3D_PROFILE("CollisionDetection::testOverlap()", mProfiler);
+
+    OverlapHitsCallback callback(*this, hits, maxNbHits, categoryMaskBits, shape, shapeToWorldTransform);
+    mBroadPhaseAlgorithm->reportAllShapesOverlappingWithAABB(
+                computeSweptAABB(shape, shapeToWorldTransform, shapeToWorldTransform), callback);
+
+    return callback.nbHits;
+}
+
+// Return true if a collision shape overlaps with a proxy shape (two concave shapes never overlap)
+bool CollisionDetection::testShapeOverlap(const CollisionShape* shape, const Transform& shapeToWorldTransform,
+                                          ProxyShape* proxyShape) const {
+    return testShapesOverlap(mGJKAlgorithm, shape, shapeToWorldTransform, proxyShape->getCollisionShape(),
+                             proxyShape->getLocalToWorldTransform());
+}
+
+// Return true if two collision shapes overlap (two concave shapes never overlap)
+/// A convex shape is tested against the triangles of a concave shape that overlap
+/// with its AABB in local-space of the concave shape.
+bool CollisionDetection::testShapesOverlap(const GJKAlgorithm& gjkAlgorithm,
+                                           const CollisionShape* shape1, const Transform& shape1ToWorldTransform,
+                                           const CollisionShape* shape2, const Transform& shape2ToWorldTransform) {
+
+    // A compound shape overlaps with a shape if one of its children overlaps with it
+    if (shape1->getType() == CollisionShapeType::COMPOUND) {
+        return testCompoundShapeOverlap(gjkAlgorithm, static_cast<const CompoundShape*>(shape1),
+                                        shape1ToWorldTransform, shape2, shape2ToWorldTransform);
+    }
+    if (shape2->getType() == CollisionShapeType::COMPOUND) {
+        return testCompoundShapeOverlap(gjkAlgorithm, static_cast<const CompoundShape*>(shape2),
+                                        shape2ToWorldTransform, shape1, shape1ToWorldTransform);
+    }
 
-        // Go to the next overlapping proxy shape
-        element = element->next;
+    if (shape1->isConvex() && shape2->isConvex()) {
+        return gjkAlgorithm.testOverlap(static_cast<const ConvexShape*>(shape1), shape1ToWorldTransform,
+                                         static_cast<const ConvexShape*>(shape2), shape2ToWorldTransform);
     }
+
+    if (!shape1->isConvex() && !shape2->isConvex()) {
+        return false;
+    }
+
+    const bool isShape1Convex = shape1->isConvex();
+    const ConvexShape* convexShape = static_cast<const ConvexShape*>(isShape1Convex ? shape1 : shape2);
+    const ConcaveShape* concaveShape = static_cast<const ConcaveShape*>(isShape1Convex ? shape2 : shape1);
+    const Transform& convexToWorld = isShape1Convex ? shape1ToWorldTransform : shape2ToWorldTransform;
+    const Transform& concaveToWorld = isShape1Convex ? shape2ToWorldTransform : shape1ToWorldTransform;
+
+    // Test the triangles that overlap with the AABB of the convex shape in local-space of the concave shape
+    const Transform convexToConcave = concaveToWorld.getInverse() * convexToWorld;
+    OverlapTriangleCallback callback(gjkAlgorithm, convexShape, convexToWorld, concaveToWorld);
+    concaveShape->testAllTriangles(callback, computeSweptAABB(convexShape, convexToConcave, convexToConcave));
+
+    return callback.isOverlapping;
+}
+
+// Return true if a child shape of a compound shape overlaps with another collision shape
+/// Only the children whose AABBs overlap with the AABB of the other shape (in local-space of
+/// the compound shape) are tested.
+bool CollisionDetection::testCompoundShapeOverlap(const GJKAlgorithm& gjkAlgorithm,
+                                                  const CompoundShape* compoundShape,
+                                                  const Transform& compoundToWorldTransform,
+                                                  const CollisionShape* shape, const Transform& shapeToWorldTransform) {
+
+    bool isOverlapping = false;
+    auto testChild = [&](uint childIndex) {
+        if (isOverlapping) return;
+        isOverlapping = testShapesOverlap(gjkAlgorithm, compoundShape->getChildShape(childIndex),
+                                          compoundToWorldTransform * compoundShape->getChildTransform(childIndex),
+                                          shape, shapeToWorldTransform);
+    };
+
+    AABB shapeAABB;
+    shape->computeAABB(shapeAABB, compoundToWorldTransform.getInverse() * shapeToWorldTransform);
+    compoundShape->testAllChildShapes(shapeAABB, testChild);
+
+    return isOverlapping;
 }
 
 // Return true if two bodies overlap
+/// The pairs of proxy shapes whose AABBs overlap are tested with the GJK algorithm without
+/// creating any overlapping pair or narrow-phase info.
 bool CollisionDetection::testOverlap(CollisionBody* body1, CollisionBody* body2) {
 
-    // For each proxy shape proxy shape of the first body
-    ProxyShape* body1ProxyShape = body1->getProxyShapesList();
-    while (body1ProxyShape != nullptr) {
+    RP3D_PROFILE("CollisionDetection::testOverlap()", mProfiler);
 
-        AABB aabb1 = body1ProxyShape->getWorldAABB();
+    // For each proxy shape of the first body
+    for (const ProxyShape* body1ProxyShape = body1->getProxyShapesList(); body1ProxyShape != nullptr;
+         body1ProxyShape = body1ProxyShape->getNext()) {
+
+        const AABB aabb1 = body1ProxyShape->getWorldAABB();
+        const Transform shape1ToWorldTransform = body1ProxyShape->getLocalToWorldTransform();
 
         // For each proxy shape of the second body
-        ProxyShape* body2ProxyShape = body2->getProxyShapesList();
-        while (body2ProxyShape != nullptr) {
+        for (const ProxyShape* body2ProxyShape = body2->getProxyShapesList(); body2ProxyShape != nullptr;
+             body2ProxyShape = body2ProxyShape->getNext()) {
+
+            // Test if the AABBs of the two proxy shapes overlap before the shapes
+            if (aabb1.testCollision(body2ProxyShape->getWorldAABB()) &&
+                testShapesOverlap(mGJKAlgorithm, body1ProxyShape->getCollisionShape(), shape1ToWorldTransform,
+                                  body2ProxyShape->getCollisionShape(), body2ProxyShape->getLocalToWorldTransform())) {
+                return true;
+            }
+        }
+    }
 
-            AABB aabb2 = body2ProxyShape->getWorldAABB();
+    // No overlap has been found
+    return false;
+}
 
-            // Test if the AABBs of the two proxy shapes overlap
-            if (aabb1.testCollision(aabb2)) {
+// Fill an array with the contact points between two bodies
+/// Each pair of proxy shapes whose AABBs overlap is tested by the narrow-phase algorithm of its
+/// shapes with a narrow-phase info on the stack (see computeContactHits()). If there are more
+/// contact points than the size of the array, only the first ones are stored.
+uint CollisionDetection::testCollision(CollisionBody* body1, CollisionBody* body2, ContactHit* hits,
+                                       uint maxNbHits) const {
 
-                // Create a temporary overlapping pair
-                OverlappingPair pair(body1ProxyShape, body2ProxyShape, mMemoryManager.getPoolAllocator(),
-                                     mMemoryManager.getPoolAllocator(), mWorld->mConfig);
+    RP3D_PROFILE("CollisionDetection::testCollision()", mProfiler);
 
-                // Compute the middle-phase collision detection between the two shapes
-                NarrowPhaseInfo* narrowPhaseInfo = computeMiddlePhaseForProxyShapes(&pair);
+    uint nbHits = 0;
 
-                bool isColliding = false;
+    // For each proxy shape of the first body
+    for (ProxyShape* body1ProxyShape = body1->getProxyShapesList(); body1ProxyShape != nullptr && nbHits < maxNbHits;
+         body1ProxyShape = body1ProxyShape->getNext()) {
 
-                // For each narrow-phase info object
-                while (narrowPhaseInfo != nullptr) {
+        const AABB aabb1 = body1ProxyShape->getWorldAABB();
+        const Transform shape1ToWorldTransform = body1ProxyShape->getLocalToWorldTransform();
 
-                    // If we have not found a collision yet
-                    if (!isColliding) {
+        // For each proxy shape of the second body whose AABB overlaps with the first one
+        for (ProxyShape* body2ProxyShape = body2->getProxyShapesList(); body2ProxyShape != nullptr && nbHits < maxNbHits;
+             body2ProxyShape = body2ProxyShape->getNext()) {
 
-						const CollisionShapeType shape1Type = narrowPhaseInfo->collisionShape1->getType();
-						const CollisionShapeType shape2Type = narrowPhaseInfo->collisionShape2->getType();
+            if (!aabb1.testCollision(body2ProxyShape->getWorldAABB())) continue;
 
-                        // Select the narrow phase algorithm to use according to the two collision shapes
-                        NarrowPhaseAlgorithm* narrowPhaseAlgorithm = selectNarrowPhaseAlgorithm(shape1Type, shape2Type);
+            computeContactHits(body1ProxyShape, body2ProxyShape, body1ProxyShape->getCollisionShape(),
+                               shape1ToWorldTransform, body2ProxyShape->getCollisionShape(),
+                               body2ProxyShape->getLocalToWorldTransform(), hits, maxNbHits, nbHits);
+        }
+    }
 
-                        // If there is a collision algorithm for those two kinds of shapes
-                        if (narrowPhaseAlgorithm != nullptr) {
+    return nbHits;
+}
 
-                            // Use the narrow-phase collision detection algorithm to check
-                            // if there really is a collision. If a collision occurs, the
-                            // notifyContact() callback method will be called.
-                            isColliding |= narrowPhaseAlgorithm->testCollision(narrowPhaseInfo, false, mMemoryManager.getPoolAllocator());
-                        }
-                    }
+// Compute the contacts between two collision shapes of two proxy shapes and store them in an array
+/// The children of a compound shape and the triangles of a concave shape are tested one by one
+/// as in the middle-phase. Two convex shapes are tested by their narrow-phase algorithm with a
+/// narrow-phase info and a last frame collision info on the stack (nothing is kept between
+/// two tests).
+/**
+ * @param proxyShape1 Proxy shape of the first body
+ * @param proxyShape2 Proxy shape of the second body
+ * @param shape1 Collision shape of the first proxy shape (or one of its children or triangles)
+ * @param shape1ToWorldTransform Local-to-world transform of the first collision shape
+ * @param shape2 Collision shape of the second proxy shape (or one of its children or triangles)
+ * @param shape2ToWorldTransform Local-to-world transform of the second collision shape
+ * @param[out] hits Array where the contact points are stored
+ * @param maxNbHits Size of the array of hits
+ * @param[in,out] nbHits Number of contact points stored in the array
+ */
+void CollisionDetection::computeContactHits(ProxyShape* proxyShape1, ProxyShape* proxyShape2,
+                                            CollisionShape* shape1, const Transform& shape1ToWorldTransform,
+                                            CollisionShape* shape2, const Transform& shape2ToWorldTransform,
+                                            ContactHit* hits, uint maxNbHits, uint& nbHits) const {
+
+    if (nbHits == maxNbHits) return;
+
+    // The children of a compound shape whose AABBs overlap with the other shape are tested
+    if (shape1->getType() == CollisionShapeType::COMPOUND) {
+
+        const CompoundShape* compoundShape = static_cast<const CompoundShape*>(shape1);
+        auto testChild = [&](uint childIndex) {
+            computeContactHits(proxyShape1, proxyShape2, compoundShape->getChildShape(childIndex),
+                               shape1ToWorldTransform * compoundShape->getChildTransform(childIndex),
+                               shape2, shape2ToWorldTransform, hits, maxNbHits, nbHits);
+        };
+
+        AABB shape2AABB;
+        shape2->computeAABB(shape2AABB, shape1ToWorldTransform.getInverse() * shape2ToWorldTransform);
+        compoundShape->testAllChildShapes(shape2AABB, testChild);
+        return;
+    }
+    if (shape2->getType() == CollisionShapeType::COMPOUND) {
+
+        const CompoundShape* compoundShape = static_cast<const CompoundShape*>(shape2);
+        auto testChild = [&](uint childIndex) {
+            computeContactHits(proxyShape1, proxyShape2, shape1, shape1ToWorldTransform,
+                               compoundShape->getChildShape(childIndex),
+                               shape2ToWorldTransform * compoundShape->getChildTransform(childIndex),
+                               hits, maxNbHits, nbHits);
+        };
+
+        AABB shape1AABB;
+        shape1->computeAABB(shape1AABB, shape2ToWorldTransform.getInverse() * shape1ToWorldTransform);
+        compoundShape->testAllChildShapes(shape1AABB, testChild);
+        return;
+    }
 
-                    NarrowPhaseInfo* currentNarrowPhaseInfo = narrowPhaseInfo;
-                    narrowPhaseInfo = narrowPhaseInfo->next;
+    const bool isShape1Convex = shape1->isConvex();
+    const bool isShape2Convex = shape2->isConvex();
+    if (!isShape1Convex && !isShape2Convex) return;
+
+    // A convex shape is tested against the triangles of a concave shape that overlap with its AABB
+    // (except a sphere or a capsule against a height field, which is tested directly)
+    if (!isShape1Convex || !isShape2Convex) {
+
+        CollisionShape* convexShape = isShape1Convex ? shape1 : shape2;
+        const ConcaveShape* concaveShape = static_cast<const ConcaveShape*>(isShape1Convex ? shape2 : shape1);
+        const Transform& convexToWorld = isShape1Convex ? shape1ToWorldTransform : shape2ToWorldTransform;
+        const Transform& concaveToWorld = isShape1Convex ? shape2ToWorldTransform : shape1ToWorldTransform;
+
+        const CollisionShapeType convexShapeType = convexShape->getType();
+        if (concaveShape->getName() != CollisionShapeName::HEIGHTFIELD ||
+            (convexShapeType != CollisionShapeType::SPHERE && convexShapeType != CollisionShapeType::CAPSULE) ||
+            selectNarrowPhaseAlgorithm(convexShapeType, CollisionShapeType::CONCAVE_SHAPE) == nullptr) {
+
+            ContactHitsTriangleCallback callback(*this, proxyShape1, proxyShape2, convexShape, convexToWorld,
+                                                 concaveShape, concaveToWorld, isShape1Convex, hits, maxNbHits,
+                                                 nbHits);
+            AABB aabb;
+            convexShape->computeAABB(aabb, concaveToWorld.getInverse() * convexToWorld);
+            concaveShape->testAllTriangles(callback, aabb);
+            return;
+        }
+    }
 
-                    // Call the destructor
-                    currentNarrowPhaseInfo->~NarrowPhaseInfo();
+    NarrowPhaseAlgorithm* narrowPhaseAlgorithm = selectNarrowPhaseAlgorithm(shape1->getType(), shape2->getType());
+    if (narrowPhaseAlgorithm == nullptr) return;
 
-                    // Release the allocated memory
-                    mMemoryManager.release(MemoryManager::AllocationType::Pool, currentNarrowPhaseInfo, sizeof(NarrowPhaseInfo));
-                }
+    // Only the contact points are allocated
+    MemoryAllocator& allocator = mMemoryManager.getPoolAllocator(MemoryTag::NarrowPhase);
+    LastFrameCollisionInfo lastFrameCollisionInfo;
+    NarrowPhaseInfo narrowPhaseInfo(shape1, shape2, shape1ToWorldTransform, shape2ToWorldTransform,
+                                    &lastFrameCollisionInfo, allocator);
 
-                // Return if we have found a narrow-phase collision
-                if (isColliding) return true;
-            }
+    if (narrowPhaseAlgorithm->testCollision(&narrowPhaseInfo, true, allocator)) {
 
-            // Go to the next proxy shape
-            body2ProxyShape = body2ProxyShape->getNext();
-        }
+        for (const ContactPointInfo* contactPoint = narrowPhaseInfo.contactPoints;
+             contactPoint != nullptr && nbHits < maxNbHits; contactPoint = contactPoint->next) {
 
-        // Go to the next proxy shape
-        body1ProxyShape = body1ProxyShape->getNext();
+            ContactHit& hit = hits[nbHits];
+            hit.proxyShape1 = proxyShape1;
+            hit.proxyShape2 = proxyShape2;
+            hit.worldPoint1 = shape1ToWorldTransform * contactPoint->localPoint1;
+            hit.worldPoint2 = shape2ToWorldTransform * contactPoint->localPoint2;
+            hit.worldNormal = contactPoint->normal;
+            hit.penetrationDepth = contactPoint->penetrationDepth;
+            nbHits++;
+        }
     }
 
-    // No overlap has been found
-    return false;
+    narrowPhaseInfo.resetContactPoints();
 }
 
 // Report all the bodies that overlap with the body in parameter
 void CollisionDetection::testOverlap(CollisionBody* body, OverlapCallback* overlapCallback,
-                                     unsigned short categoryMaskBits) {
+                                     collisionmask categoryMaskBits) {
 
     assert(overlapCallback != nullptr);
 
-    Set<bodyindex> reportedBodies(mMemoryManager.getPoolAllocator());
+    Set<bodyindex> reportedBodies(mMemoryManager.getPoolAllocator(MemoryTag::NarrowPhase));
 
     // For each proxy shape proxy shape of the body
     ProxyShape* bodyProxyShape = body->getProxyShapesList();
@@ -657,21 +3082,20 @@ void CollisionDetection::testOverlap(CollisionBody* body, OverlapCallback* overl
         if (bodyProxyShape->getBroadPhaseId() != -1) {
 
             // Get the AABB of the shape
-            const AABB& shapeAABB = mBroadPhaseAlgorithm.getFatAABB(bodyProxyShape->getBroadPhaseId());
+            const AABB& shapeAABB = mBroadPhaseAlgorithm->getFatAABB(bodyProxyShape->getBroadPhaseId());
 
             // Ask the broad-phase to get all the overlapping shapes
-            LinkedList<int> overlappingNodes(mMemoryManager.getPoolAllocator());
-            mBroadPhaseAlgorithm.reportAllShapesOverlappingWithAABB(shapeAABB, overlappingNodes);
+            List<int> overlappingNodes(mMemoryManager.getPoolAllocator(MemoryTag::NarrowPhase));
+            mBroadPhaseAlgorithm->reportAllShapesOverlappingWithAABB(shapeAABB, overlappingNodes);
 
             const bodyindex bodyId = body->getId();
 
             // For each overlaping proxy shape
-            LinkedList<int>::ListElement* element = overlappingNodes.getListHead();
-            while (element != nullptr) {
+            for (uint i=0; i < overlappingNodes.size(); i++) {
 
                 // Get the overlapping proxy shape
-                int broadPhaseId = element->data;
-                ProxyShape* proxyShape = mBroadPhaseAlgorithm.getProxyShapeForBroadPhaseId(broadPhaseId);
+                int broadPhaseId = overlappingNodes[i];
+                ProxyShape* proxyShape = mBroadPhaseAlgorithm->getProxyShapeForBroadPhaseId(broadPhaseId);
 
                 // If the proxy shape is from a body that we have not already reported collision and the
                 // two proxy collision shapes are not from the same body
@@ -682,8 +3106,8 @@ void CollisionDetection::testOverlap(CollisionBody* body, OverlapCallback* overl
                     if ((proxyShape->getCollisionCategoryBits() & categoryMaskBits) != 0) {
 
                         // Create a temporary overlapping pair
-                        OverlappingPair pair(bodyProxyShape, proxyShape, mMemoryManager.getPoolAllocator(),
-                                             mMemoryManager.getPoolAllocator(), mWorld->mConfig);
+                        OverlappingPair pair(bodyProxyShape, proxyShape, mMemoryManager.getPoolAllocator(MemoryTag::NarrowPhase),
+                                             mMemoryManager.getPoolAllocator(MemoryTag::NarrowPhase), mWorld->mConfig);
 
                         // Compute the middle-phase collision detection between the two shapes
                         NarrowPhaseInfo* narrowPhaseInfo = computeMiddlePhaseForProxyShapes(&pair);
@@ -708,18 +3132,15 @@ void CollisionDetection::testOverlap(CollisionBody* body, OverlapCallback* overl
                                     // Use the narrow-phase collision detection algorithm to check
                                     // if there really is a collision. If a collision occurs, the
                                     // notifyContact() callback method will be called.
-                                    isColliding |= narrowPhaseAlgorithm->testCollision(narrowPhaseInfo, false, mMemoryManager.getPoolAllocator());
+                                    isColliding |= narrowPhaseAlgorithm->testCollision(narrowPhaseInfo, false, mMemoryManager.getPoolAllocator(MemoryTag::NarrowPhase));
                                 }
                             }
 
                             NarrowPhaseInfo* currentNarrowPhaseInfo = narrowPhaseInfo;
                             narrowPhaseInfo = narrowPhaseInfo->next;
 
-                            // Call the destructor
-                            currentNarrowPhaseInfo->~NarrowPhaseInfo();
-
-                            // Release the allocated memory
-                            mMemoryManager.release(MemoryManager::AllocationType::Pool, currentNarrowPhaseInfo, sizeof(NarrowPhaseInfo));
+                            // Destroy the narrow-phase info and release its memory
+                            NarrowPhaseInfo::destroy(currentNarrowPhaseInfo);
                         }
 
                         // Return if we have found a narrow-phase collision
@@ -735,9 +3156,6 @@ void CollisionDetection::testOverlap(CollisionBody* body, OverlapCallback* overl
                         }
                     }
                 }
-
-                // Go to the next overlapping proxy shape
-                element = element->next;
             }
         }
 
@@ -767,8 +3185,8 @@ void CollisionDetection::testCollision(CollisionBody* body1, CollisionBody* body
             if (aabb1.testCollision(aabb2)) {
 
                 // Create a temporary overlapping pair
-                OverlappingPair pair(body1ProxyShape, body2ProxyShape, mMemoryManager.getPoolAllocator(),
-                                     mMemoryManager.getPoolAllocator(), mWorld->mConfig);
+                OverlappingPair pair(body1ProxyShape, body2ProxyShape, mMemoryManager.getPoolAllocator(MemoryTag::NarrowPhase),
+                                     mMemoryManager.getPoolAllocator(MemoryTag::NarrowPhase), mWorld->mConfig);
 
                 // Compute the middle-phase collision detection between the two shapes
                 NarrowPhaseInfo* narrowPhaseInfo = computeMiddlePhaseForProxyShapes(&pair);
@@ -788,7 +3206,7 @@ void CollisionDetection::testCollision(CollisionBody* body1, CollisionBody* body
                         // Use the narrow-phase collision detection algorithm to check
                         // if there really is a collision. If a collision occurs, the
                         // notifyContact() callback method will be called.
-                        if (narrowPhaseAlgorithm->testCollision(narrowPhaseInfo, true, mMemoryManager.getPoolAllocator())) {
+                        if (narrowPhaseAlgorithm->testCollision(narrowPhaseInfo, true, mMemoryManager.getPoolAllocator(MemoryTag::NarrowPhase))) {
 
                             // Add the contact points as a potential contact manifold into the pair
                             narrowPhaseInfo->addContactPointsAsPotentialContactManifold();
@@ -798,11 +3216,8 @@ void CollisionDetection::testCollision(CollisionBody* body1, CollisionBody* body
                     NarrowPhaseInfo* currentNarrowPhaseInfo = narrowPhaseInfo;
                     narrowPhaseInfo = narrowPhaseInfo->next;
 
-                    // Call the destructor
-                    currentNarrowPhaseInfo->~NarrowPhaseInfo();
-
-                    // Release the allocated memory
-                    mMemoryManager.release(MemoryManager::AllocationType::Pool, currentNarrowPhaseInfo, sizeof(NarrowPhaseInfo));
+                    // Destroy the narrow-phase info and release its memory
+                    NarrowPhaseInfo::destroy(currentNarrowPhaseInfo);
                 }
 
                 // Process the potential contacts
@@ -826,7 +3241,7 @@ void CollisionDetection::testCollision(CollisionBody* body1, CollisionBody* body
 }
 
 // Test and report collisions between a body and all the others bodies of the world
-void CollisionDetection::testCollision(CollisionBody* body, CollisionCallback* callback, unsigned short categoryMaskBits) {
+void CollisionDetection::testCollision(CollisionBody* body, CollisionCallback* callback, collisionmask categoryMaskBits) {
 
     assert(callback != nullptr);
 
@@ -837,21 +3252,20 @@ void CollisionDetection::testCollision(CollisionBody* body, CollisionCallback* c
         if (bodyProxyShape->getBroadPhaseId() != -1) {
 
             // Get the AABB of the shape
-            const AABB& shapeAABB = mBroadPhaseAlgorithm.getFatAABB(bodyProxyShape->getBroadPhaseId());
+            const AABB& shapeAABB = mBroadPhaseAlgorithm->getFatAABB(bodyProxyShape->getBroadPhaseId());
 
             // Ask the broad-phase to get all the overlapping shapes
-            LinkedList<int> overlappingNodes(mMemoryManager.getPoolAllocator());
-            mBroadPhaseAlgorithm.reportAllShapesOverlappingWithAABB(shapeAABB, overlappingNodes);
+            List<int> overlappingNodes(mMemoryManager.getPoolAllocator(MemoryTag::NarrowPhase));
+            mBroadPhaseAlgorithm->reportAllShapesOverlappingWithAABB(shapeAABB, overlappingNodes);
 
             const bodyindex bodyId = body->getId();
 
             // For each overlaping proxy shape
-            LinkedList<int>::ListElement* element = overlappingNodes.getListHead();
-            while (element != nullptr) {
+            for (uint i=0; i < overlappingNodes.size(); i++) {
 
                 // Get the overlapping proxy shape
-                int broadPhaseId = element->data;
-                ProxyShape* proxyShape = mBroadPhaseAlgorithm.getProxyShapeForBroadPhaseId(broadPhaseId);
+                int broadPhaseId = overlappingNodes[i];
+                ProxyShape* proxyShape = mBroadPhaseAlgorithm->getProxyShapeForBroadPhaseId(broadPhaseId);
 
                 // If the two proxy collision shapes are not from the same body
                 if (proxyShape->getBody()->getId() != bodyId) {
@@ -860,8 +3274,8 @@ void CollisionDetection::testCollision(CollisionBody* body, CollisionCallback* c
                     if ((proxyShape->getCollisionCategoryBits() & categoryMaskBits) != 0) {
 
                         // Create a temporary overlapping pair
-                        OverlappingPair pair(bodyProxyShape, proxyShape, mMemoryManager.getPoolAllocator(),
-                                             mMemoryManager.getPoolAllocator(), mWorld->mConfig);
+                        OverlappingPair pair(bodyProxyShape, proxyShape, mMemoryManager.getPoolAllocator(MemoryTag::NarrowPhase),
+                                             mMemoryManager.getPoolAllocator(MemoryTag::NarrowPhase), mWorld->mConfig);
 
                         // Compute the middle-phase collision detection between the two shapes
                         NarrowPhaseInfo* narrowPhaseInfo = computeMiddlePhaseForProxyShapes(&pair);
@@ -881,7 +3295,7 @@ void CollisionDetection::testCollision(CollisionBody* body, CollisionCallback* c
                                 // Use the narrow-phase collision detection algorithm to check
                                 // if there really is a collision. If a collision occurs, the
                                 // notifyContact() callback method will be called.
-                                if (narrowPhaseAlgorithm->testCollision(narrowPhaseInfo, true, mMemoryManager.getPoolAllocator())) {
+                                if (narrowPhaseAlgorithm->testCollision(narrowPhaseInfo, true, mMemoryManager.getPoolAllocator(MemoryTag::NarrowPhase))) {
 
                                     // Add the contact points as a potential contact manifold into the pair
                                     narrowPhaseInfo->addContactPointsAsPotentialContactManifold();
@@ -891,11 +3305,8 @@ void CollisionDetection::testCollision(CollisionBody* body, CollisionCallback* c
                             NarrowPhaseInfo* currentNarrowPhaseInfo = narrowPhaseInfo;
                             narrowPhaseInfo = narrowPhaseInfo->next;
 
-                            // Call the destructor
-                            currentNarrowPhaseInfo->~NarrowPhaseInfo();
-
-                            // Release the allocated memory
-                            mMemoryManager.release(MemoryManager::AllocationType::Pool, currentNarrowPhaseInfo, sizeof(NarrowPhaseInfo));
+                            // Destroy the narrow-phase info and release its memory
+                            NarrowPhaseInfo::destroy(currentNarrowPhaseInfo);
                         }
 
                         // Process the potential contacts
@@ -909,9 +3320,6 @@ void CollisionDetection::testCollision(CollisionBody* body, CollisionCallback* c
                         }
                     }
                 }
-
-                // Go to the next overlapping proxy shape
-                element = element->next;
             }
 
             // Go to the next proxy shape
@@ -929,14 +3337,13 @@ void CollisionDetection::testCollision(CollisionCallback* callback) {
     computeBroadPhase();
 
     // For each possible collision pair of bodies
-    Map<Pair<uint, uint>, OverlappingPair*>::Iterator it;
-    for (it = mOverlappingPairs.begin(); it != mOverlappingPairs.end(); ++it) {
+    for (uint i=0; i < mOverlappingPairs.size(); i++) {
 
-        OverlappingPair* originalPair = it->second;
+        OverlappingPair* originalPair = mOverlappingPairs.getPair(i);
 
         // Create a new overlapping pair so that we do not work on the original one
-        OverlappingPair pair(originalPair->getShape1(), originalPair->getShape2(), mMemoryManager.getPoolAllocator(),
-                             mMemoryManager.getPoolAllocator(), mWorld->mConfig);
+        OverlappingPair pair(originalPair->getShape1(), originalPair->getShape2(), mMemoryManager.getPoolAllocator(MemoryTag::NarrowPhase),
+                             mMemoryManager.getPoolAllocator(MemoryTag::NarrowPhase), mWorld->mConfig);
 
         ProxyShape* shape1 = pair.getShape1();
         ProxyShape* shape2 = pair.getShape2();
@@ -945,7 +3352,7 @@ void CollisionDetection::testCollision(CollisionCallback* callback) {
         // that the two shapes are still overlapping.
         if (((shape1->getCollideWithMaskBits() & shape2->getCollisionCategoryBits()) != 0 &&
              (shape1->getCollisionCategoryBits() & shape2->getCollideWithMaskBits()) != 0) &&
-             mBroadPhaseAlgorithm.testOverlappingShapes(shape1, shape2)) {
+             mBroadPhaseAlgorithm->testOverlappingShapes(shape1, shape2)) {
 
             // Compute the middle-phase collision detection between the two shapes
             NarrowPhaseInfo* narrowPhaseInfo = computeMiddlePhaseForProxyShapes(&pair);
@@ -965,7 +3372,7 @@ void CollisionDetection::testCollision(CollisionCallback* callback) {
                     // Use the narrow-phase collision detection algorithm to check
                     // if there really is a collision. If a collision occurs, the
                     // notifyContact() callback method will be called.
-                    if (narrowPhaseAlgorithm->testCollision(narrowPhaseInfo, true, mMemoryManager.getPoolAllocator())) {
+                    if (narrowPhaseAlgorithm->testCollision(narrowPhaseInfo, true, mMemoryManager.getPoolAllocator(MemoryTag::NarrowPhase))) {
 
                         // Add the contact points as a potential contact manifold into the pair
                         narrowPhaseInfo->addContactPointsAsPotentialContactManifold();
@@ -975,11 +3382,8 @@ void CollisionDetection::testCollision(CollisionCallback* callback) {
                 NarrowPhaseInfo* currentNarrowPhaseInfo = narrowPhaseInfo;
                 narrowPhaseInfo = narrowPhaseInfo->next;
 
-                // Call the destructor
-                currentNarrowPhaseInfo->~NarrowPhaseInfo();
-
-                // Release the allocated memory
-                mMemoryManager.release(MemoryManager::AllocationType::Pool, currentNarrowPhaseInfo, sizeof(NarrowPhaseInfo));
+                // Destroy the narrow-phase info and release its memory
+                NarrowPhaseInfo::destroy(currentNarrowPhaseInfo);
             }
 
             // Process the potential contacts
@@ -998,10 +3402,13 @@ void CollisionDetection::testCollision(CollisionCallback* callback) {
 // Fill-in the collision detection matrix
 void CollisionDetection::fillInCollisionMatrix() {
 
-    // For each possible type of collision shape
+    // For each possible pair of types of collision shapes. The collision dispatch is only
+    // asked for the ordered pairs of types and the matrix is symmetric so that the
+    // narrow-phase algorithm of two shapes is found without ordering their types.
     for (int i=0; i<NB_COLLISION_SHAPE_TYPES; i++) {
-        for (int j=0; j<NB_COLLISION_SHAPE_TYPES; j++) {
+        for (int j=i; j<NB_COLLISION_SHAPE_TYPES; j++) {
             mCollisionMatrix[i][j] = mCollisionDispatch->selectAlgorithm(i, j);
+            mCollisionMatrix[j][i] = mCollisionMatrix[i][j];
         }
     }
 }
@@ -1013,6 +3420,17 @@ EventListener* CollisionDetection::getWorldEventListener() {
 
 // Return the world-space AABB of a given proxy shape
 const AABB CollisionDetection::getWorldAABB(const ProxyShape* proxyShape) const {
+
+    if (proxyShape->isQueryOnly()) {
+        assert(proxyShape->mQueryOnlyNodeID != -1);
+        return mQueryOnlyTree.getFatAABB(proxyShape->mQueryOnlyNodeID);
+    }
+
     assert(proxyShape->getBroadPhaseId() > -1);
-    return mBroadPhaseAlgorithm.getFatAABB(proxyShape->getBroadPhaseId());
+    return mBroadPhaseAlgorithm->getFatAABB(proxyShape->getBroadPhaseId());
+}
+
+// Return a pointer to the task scheduler used to execute work in parallel (null if none)
+TaskScheduler* CollisionDetection::getTaskScheduler() const {
+    return mWorld->getTaskScheduler();
 }
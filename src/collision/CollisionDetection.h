@@ -31,22 +31,599 @@
 #include "broadphase/BroadPhaseAlgorithm.h"
 #include "collision/shapes/CollisionShape.h"
 #include "engine/OverlappingPair.h"
+#include "engine/OverlappingPairCache.h"
 #include "collision/narrowphase/DefaultCollisionDispatch.h"
+#include "collision/narrowphase/GJK/GJKAlgorithm.h"
+#include "collision/MiddlePhaseTriangleCallback.h"
+#include "collision/ContactEvent.h"
 #include "containers/Map.h"
 #include "containers/Set.h"
+#include "containers/FlatMap.h"
+#include "containers/FlatSet.h"
+#include "containers/List.h"
 
 /// ReactPhysics3D namespace
 namespace reactphysics3d {
 
 // Declarations
 class CollisionWorld;
+class CollisionDetection;
 class CollisionCallback;
+struct ContactHit;
 class OverlapCallback;
+struct OverlapHit;
 class RaycastCallback;
+struct RaycastHit;
+class SweepCallback;
+struct SweepInfo;
+struct DistanceInfo;
+struct DistanceQuery;
 class ContactPoint;
 class MemoryManager;
 class EventListener;
 class CollisionDispatch;
+class TaskScheduler;
+class WorldStateWriter;
+class WorldStateReader;
+class CompoundShape;
+
+// Structure NarrowPhaseStatistics
+/**
+ * This structure contains the statistics of the last computation of the narrow-phase.
+ */
+struct NarrowPhaseStatistics {
+
+    // -------------------- Attributes -------------------- //
+
+    /// Number of pairs of shapes tested with the SAT algorithm
+    uint nbSATTests = 0;
+
+    /// Number of SAT tests resolved with the minimum separating axis of the previous
+    /// frame without testing all the axes
+    uint nbSATPreviousAxisHits = 0;
+
+    /// Number of pairs of convex shapes that have reused their contacts of the previous
+    /// frame instead of computing the narrow-phase
+    uint nbReusedContactPairs = 0;
+
+    /// Number of triangles of concave shapes removed by the middle-phase because they are
+    /// separated from the AABB of the convex shape
+    uint nbCulledTriangles = 0;
+
+    /// Number of pairs of shapes tested by the narrow-phase (for all the algorithms)
+    uint nbTests = 0;
+
+    /// Number of pairs of shapes tested by the sphere vs sphere algorithm
+    uint nbSphereVsSphereTests = 0;
+
+    /// Number of pairs of shapes tested by the sphere vs capsule algorithm
+    uint nbSphereVsCapsuleTests = 0;
+
+    /// Number of pairs of shapes tested by the capsule vs capsule algorithm
+    uint nbCapsuleVsCapsuleTests = 0;
+
+    /// Number of pairs of shapes tested by the sphere vs convex polyhedron algorithm
+    /// (including the triangles of the concave shapes)
+    uint nbSphereVsConvexPolyhedronTests = 0;
+
+    /// Number of pairs of shapes tested by the capsule vs convex polyhedron algorithm
+    /// (including the triangles of the concave shapes)
+    uint nbCapsuleVsConvexPolyhedronTests = 0;
+
+    /// Number of pairs of shapes tested by the convex polyhedron vs convex polyhedron
+    /// algorithm (including the triangles of the concave shapes)
+    uint nbConvexPolyhedronVsConvexPolyhedronTests = 0;
+
+    /// Number of pairs of boxes tested by the box vs box algorithm (they are also
+    /// counted in the convex polyhedron vs convex polyhedron tests)
+    uint nbBoxVsBoxTests = 0;
+
+    /// Number of pairs of shapes tested by the convex vs implicit convex algorithm
+    /// (the pairs with a cylinder or a cone)
+    uint nbConvexVsImplicitConvexTests = 0;
+
+    /// Number of pairs of a sphere or a capsule and a height field tested by the convex vs
+    /// height field algorithm (without triangle shapes)
+    uint nbConvexVsHeightFieldTests = 0;
+
+    /// Number of runs of the GJK algorithm by the narrow-phase algorithms
+    uint nbGJKTests = 0;
+
+    /// Total number of iterations of the GJK algorithm (the average number of iterations
+    /// of a run is nbGJKIterations / nbGJKTests)
+    uint nbGJKIterations = 0;
+
+    /// Number of runs of the GJK algorithm that have started from the final simplex of
+    /// the previous frame (see WorldSettings::isGJKSimplexWarmStartEnabled)
+    uint nbGJKWarmStarts = 0;
+};
+
+// Structure NarrowPhasePairCost
+/**
+ * This structure contains the cost of the middle-phase and narrow-phase of an overlapping
+ * pair during the last collision detection (see WorldSettings::isNarrowPhaseCostsEnabled).
+ * The narrow-phase algorithms test batches of pairs with the same types of shapes at once.
+ * The narrow-phase time of a pair is therefore an estimation: the time of a batch is shared
+ * equally between its tests.
+ */
+struct NarrowPhasePairCost {
+
+    // -------------------- Attributes -------------------- //
+
+    /// First proxy shape of the pair
+    ProxyShape* shape1 = nullptr;
+
+    /// Second proxy shape of the pair
+    ProxyShape* shape2 = nullptr;
+
+    /// Time spent in the middle-phase of the pair (in seconds). This is the time to find the
+    /// triangles of a concave shape or the children of a compound shape, or the time of the
+    /// overlap test of a trigger
+    double middlePhaseTime = 0.0;
+
+    /// Estimated time spent in the narrow-phase tests of the pair (in seconds)
+    double narrowPhaseTime = 0.0;
+
+    /// Number of narrow-phase tests of the pair (one per triangle or child shape)
+    uint nbTests = 0;
+
+    /// Number of triangles of a concave shape reported by the middle-phase (including the
+    /// triangles culled before the narrow-phase)
+    uint nbTriangles = 0;
+
+    // -------------------- Methods -------------------- //
+
+    /// Return the total time spent in the middle-phase and narrow-phase of the pair
+    double getTime() const {
+        return middlePhaseTime + narrowPhaseTime;
+    }
+};
+
+// Structure NarrowPhaseShapeTypeCost
+/**
+ * This structure contains the cost of the narrow-phase tests between two types of collision
+ * shapes during the last collision detection (see WorldSettings::isNarrowPhaseCostsEnabled).
+ */
+struct NarrowPhaseShapeTypeCost {
+
+    // -------------------- Attributes -------------------- //
+
+    /// Time spent in the narrow-phase tests (in seconds)
+    double time = 0.0;
+
+    /// Number of narrow-phase tests
+    uint nbTests = 0;
+};
+
+// Structure MiddlePhasePair
+/**
+ * This structure contains an overlapping pair that has narrow-phase infos when the middle-phase
+ * of the concave and compound pairs is computed by the workers of a task scheduler. Each pair
+ * keeps its own list of narrow-phase infos and the lists are added to the narrow-phase infos
+ * of the collision detection in the order of the pairs once the workers are done.
+ */
+struct MiddlePhasePair {
+
+    // -------------------- Attributes -------------------- //
+
+    /// Overlapping pair
+    OverlappingPair* pair = nullptr;
+
+    /// Linked list of the narrow-phase infos of the pair
+    NarrowPhaseInfo* narrowPhaseInfos = nullptr;
+
+    /// True if the middle-phase of the pair (concave or compound shape) is computed by a worker
+    bool isComputedByWorker = false;
+
+    /// True if the triangles separated from the convex shape are culled
+    bool isTriangleCullingEnabled = true;
+
+    /// Number of triangles culled by the middle-phase of the pair
+    uint nbCulledTriangles = 0;
+
+    /// Ticks spent in the middle-phase of the pair by the worker
+    uint64 middlePhaseTicks = 0;
+};
+
+// Structure SweepTriangleHit
+/**
+ * This structure contains the triangle of a concave shape that is hit by a swept convex shape.
+ */
+struct SweepTriangleHit {
+
+    // -------------------- Attributes -------------------- //
+
+    /// Vertices of the triangle (in local-space of the concave shape)
+    Vector3 vertices[3];
+
+    /// Normals of the vertices of the triangle
+    Vector3 verticesNormals[3];
+
+    /// Shape id of the triangle
+    uint shapeId = 0;
+};
+
+// Class SweepTriangleCallback
+/**
+ * This class computes the time of impact of a swept convex shape with the triangles
+ * of a concave shape and keeps the earliest triangle that is hit.
+ */
+class SweepTriangleCallback : public TriangleCallback {
+
+    private:
+
+        // -------------------- Attributes -------------------- //
+
+        /// GJK algorithm used to compute the times of impact
+        const GJKAlgorithm& mGJKAlgorithm;
+
+        /// Swept convex shape
+        const ConvexShape* mShape;
+
+        /// Local-to-world transform of the swept shape at the beginning of the motion
+        const Transform& mStartTransform;
+
+        /// Local-to-world transform of the swept shape at the end of the motion
+        const Transform& mEndTransform;
+
+        /// Local-to-world transform of the concave shape
+        const Transform& mConcaveShapeToWorldTransform;
+
+    public:
+
+        // -------------------- Attributes -------------------- //
+
+        /// True if a triangle is hit
+        bool isHit = false;
+
+        /// Fraction of the motion when the earliest triangle is hit (the triangles
+        /// hit after this fraction are ignored)
+        decimal hitFraction;
+
+        /// Normal of the contact from the swept shape toward the earliest hit triangle
+        Vector3 hitNormal;
+
+        /// Earliest hit triangle
+        SweepTriangleHit hitTriangle;
+
+        // -------------------- Methods -------------------- //
+
+        /// Constructor
+        SweepTriangleCallback(const GJKAlgorithm& gjkAlgorithm, const ConvexShape* shape,
+                              const Transform& startTransform, const Transform& endTransform,
+                              const Transform& concaveShapeToWorldTransform, decimal maxFraction)
+            : mGJKAlgorithm(gjkAlgorithm), mShape(shape), mStartTransform(startTransform),
+              mEndTransform(endTransform), mConcaveShapeToWorldTransform(concaveShapeToWorldTransform),
+              hitFraction(maxFraction) {
+
+        }
+
+        /// Compute the time of impact of the swept shape with a triangle
+        virtual void testTriangle(const Vector3* trianglePoints, const Vector3* verticesNormals, uint shapeId) override;
+};
+
+// Class ContactHitsTriangleCallback
+/**
+ * This class computes the contacts between a convex shape and the triangles of a concave
+ * shape for a collision test that fills an array of hits. Each triangle is created on the stack.
+ */
+class ContactHitsTriangleCallback : public TriangleCallback {
+
+    private:
+
+        // -------------------- Attributes -------------------- //
+
+        /// Reference to the collision detection
+        const CollisionDetection& mCollisionDetection;
+
+        /// Proxy shape of the first body
+        ProxyShape* mProxyShape1;
+
+        /// Proxy shape of the second body
+        ProxyShape* mProxyShape2;
+
+        /// Convex shape
+        CollisionShape* mConvexShape;
+
+        /// Local-to-world transform of the convex shape
+        const Transform& mConvexShapeToWorldTransform;
+
+        /// Concave shape
+        const ConcaveShape* mConcaveShape;
+
+        /// Local-to-world transform of the concave shape
+        const Transform& mConcaveShapeToWorldTransform;
+
+        /// True if the convex shape is the shape of the first body
+        bool mIsShape1Convex;
+
+        /// Array where the hits are stored
+        ContactHit* mHits;
+
+        /// Size of the array of hits
+        uint mMaxNbHits;
+
+    public:
+
+        // -------------------- Attributes -------------------- //
+
+        /// Number of hits stored in the array
+        uint& nbHits;
+
+        // -------------------- Methods -------------------- //
+
+        /// Constructor
+        ContactHitsTriangleCallback(const CollisionDetection& collisionDetection, ProxyShape* proxyShape1,
+                                    ProxyShape* proxyShape2, CollisionShape* convexShape,
+                                    const Transform& convexShapeToWorldTransform, const ConcaveShape* concaveShape,
+                                    const Transform& concaveShapeToWorldTransform, bool isShape1Convex,
+                                    ContactHit* hits, uint maxNbHits, uint& nbHits)
+            : mCollisionDetection(collisionDetection), mProxyShape1(proxyShape1), mProxyShape2(proxyShape2),
+              mConvexShape(convexShape), mConvexShapeToWorldTransform(convexShapeToWorldTransform),
+              mConcaveShape(concaveShape), mConcaveShapeToWorldTransform(concaveShapeToWorldTransform),
+              mIsShape1Convex(isShape1Convex), mHits(hits), mMaxNbHits(maxNbHits), nbHits(nbHits) {
+
+        }
+
+        /// Compute the contacts between the convex shape and a triangle
+        virtual void testTriangle(const Vector3* trianglePoints, const Vector3* verticesNormals, uint shapeId) override;
+};
+
+// Class OverlapTriangleCallback
+/**
+ * This class tests if a convex shape overlaps with one of the triangles of a concave shape.
+ */
+class OverlapTriangleCallback : public TriangleCallback {
+
+    private:
+
+        // -------------------- Attributes -------------------- //
+
+        /// GJK algorithm used to test the overlap with the triangles
+        const GJKAlgorithm& mGJKAlgorithm;
+
+        /// Convex shape
+        const ConvexShape* mConvexShape;
+
+        /// Local-to-world transform of the convex shape
+        const Transform& mConvexShapeToWorldTransform;
+
+        /// Local-to-world transform of the concave shape
+        const Transform& mConcaveShapeToWorldTransform;
+
+    public:
+
+        // -------------------- Attributes -------------------- //
+
+        /// True if the convex shape overlaps with a triangle
+        bool isOverlapping = false;
+
+        // -------------------- Methods -------------------- //
+
+        /// Constructor
+        OverlapTriangleCallback(const GJKAlgorithm& gjkAlgorithm, const ConvexShape* convexShape,
+                                const Transform& convexShapeToWorldTransform,
+                                const Transform& concaveShapeToWorldTransform)
+            : mGJKAlgorithm(gjkAlgorithm), mConvexShape(convexShape),
+              mConvexShapeToWorldTransform(convexShapeToWorldTransform),
+              mConcaveShapeToWorldTransform(concaveShapeToWorldTransform) {
+
+        }
+
+        /// Test if the convex shape overlaps with a triangle
+        virtual void testTriangle(const Vector3* trianglePoints, const Vector3* verticesNormals, uint shapeId) override;
+};
+
+// Class DistanceTriangleCallback
+/**
+ * This class computes the distance between a convex shape and the triangles of a concave
+ * shape and keeps the closest triangle.
+ */
+class DistanceTriangleCallback : public TriangleCallback {
+
+    private:
+
+        // -------------------- Attributes -------------------- //
+
+        /// GJK algorithm used to compute the distances
+        const GJKAlgorithm& mGJKAlgorithm;
+
+        /// Convex shape
+        const ConvexShape* mConvexShape;
+
+        /// Local-to-world transform of the convex shape
+        const Transform& mConvexShapeToWorldTransform;
+
+        /// Distance by which the convex shape is shrunk (see CollisionDetection::computeShapesDistance())
+        decimal mConvexShapeShrinkDistance;
+
+        /// Local-to-world transform of the concave shape
+        const Transform& mConcaveShapeToWorldTransform;
+
+        /// Information about the closest triangle
+        DistanceInfo& mDistanceInfo;
+
+    public:
+
+        // -------------------- Attributes -------------------- //
+
+        /// True if a triangle closer than the initial distance of the distance info is found
+        bool isFound = false;
+
+        // -------------------- Methods -------------------- //
+
+        /// Constructor
+        DistanceTriangleCallback(const GJKAlgorithm& gjkAlgorithm, const ConvexShape* convexShape,
+                                 const Transform& convexShapeToWorldTransform, decimal convexShapeShrinkDistance,
+                                 const Transform& concaveShapeToWorldTransform, DistanceInfo& distanceInfo)
+            : mGJKAlgorithm(gjkAlgorithm), mConvexShape(convexShape),
+              mConvexShapeToWorldTransform(convexShapeToWorldTransform),
+              mConvexShapeShrinkDistance(convexShapeShrinkDistance),
+              mConcaveShapeToWorldTransform(concaveShapeToWorldTransform), mDistanceInfo(distanceInfo) {
+
+        }
+
+        /// Compute the distance between the convex shape and a triangle
+        virtual void testTriangle(const Vector3* trianglePoints, const Vector3* verticesNormals, uint shapeId) override;
+};
+
+// Class OverlapHitsCallback
+/**
+ * Broad-phase callback of the overlap queries that fill an array of hits. The proxy
+ * shapes that pass the collision filtering (and that overlap with the query shape if
+ * there is one) are stored in the array until it is full. Nothing is allocated.
+ */
+class OverlapHitsCallback : public DynamicAABBTreeOverlapCallback {
+
+    private:
+
+        // -------------------- Attributes -------------------- //
+
+        /// Reference to the collision detection
+        const CollisionDetection& mCollisionDetection;
+
+        /// Array where the hits are stored
+        OverlapHit* mHits;
+
+        /// Size of the array of hits
+        uint mMaxNbHits;
+
+        /// Bits mask used to filter the proxy shapes
+        collisionmask mCategoryMaskBits;
+
+        /// Shape tested against the proxy shapes (null if only the AABBs are tested)
+        const CollisionShape* mShape;
+
+        /// Local-to-world transform of the tested shape
+        Transform mShapeToWorldTransform;
+
+        /// Body whose proxy shapes are not reported (null if there is no such body)
+        const CollisionBody* mIgnoredBody;
+
+    public:
+
+        // -------------------- Attributes -------------------- //
+
+        /// Number of hits stored in the array
+        uint nbHits = 0;
+
+        /// True if the reported nodes are nodes of the tree of the query-only proxy shapes
+        /// (and not broad-phase IDs)
+        bool isQueryOnlyTree = false;
+
+        // -------------------- Methods -------------------- //
+
+        /// Constructor
+        OverlapHitsCallback(const CollisionDetection& collisionDetection, OverlapHit* hits, uint maxNbHits,
+                            collisionmask categoryMaskBits, const CollisionShape* shape = nullptr,
+                            const Transform& shapeToWorldTransform = Transform::identity(),
+                            const CollisionBody* ignoredBody = nullptr)
+            : mCollisionDetection(collisionDetection), mHits(hits), mMaxNbHits(maxNbHits),
+              mCategoryMaskBits(categoryMaskBits), mShape(shape), mShapeToWorldTransform(shapeToWorldTransform),
+              mIgnoredBody(ignoredBody) {
+
+        }
+
+        /// Store the proxy shape of a broad-phase ID in the array if it overlaps with the tested shape
+        virtual void notifyOverlappingNode(int broadPhaseId) override;
+};
+
+// Class ClosestPointCallback
+/**
+ * Broad-phase callback of the closest point queries. The distance between the query shape
+ * and each proxy shape that passes the collision filtering is computed and the closest proxy
+ * shape is kept. Nothing is allocated.
+ */
+class ClosestPointCallback : public DynamicAABBTreeOverlapCallback {
+
+    private:
+
+        // -------------------- Attributes -------------------- //
+
+        /// Reference to the collision detection
+        const CollisionDetection& mCollisionDetection;
+
+        /// Query shape
+        const ConvexShape* mShape;
+
+        /// Local-to-world transform of the query shape
+        const Transform& mShapeToWorldTransform;
+
+        /// Distance by which the query shape is shrunk (see CollisionDetection::computeShapesDistance())
+        decimal mShapeShrinkDistance;
+
+        /// Bits mask used to filter the proxy shapes
+        collisionmask mCategoryMaskBits;
+
+    public:
+
+        // -------------------- Attributes -------------------- //
+
+        /// Information about the closest proxy shape (its distance is the maximum distance of the query
+        /// until a proxy shape is found)
+        DistanceInfo* hit = nullptr;
+
+        // -------------------- Methods -------------------- //
+
+        /// Constructor
+        ClosestPointCallback(const CollisionDetection& collisionDetection, const ConvexShape* shape,
+                             const Transform& shapeToWorldTransform, decimal shapeShrinkDistance,
+                             collisionmask categoryMaskBits)
+            : mCollisionDetection(collisionDetection), mShape(shape), mShapeToWorldTransform(shapeToWorldTransform),
+              mShapeShrinkDistance(shapeShrinkDistance), mCategoryMaskBits(categoryMaskBits) {
+
+        }
+
+        /// Keep the proxy shape of a broad-phase ID if it is closer than the closest one so far
+        virtual void notifyOverlappingNode(int broadPhaseId) override;
+};
+
+// Class PointsInsideCallback
+/**
+ * This class is used to test a packet of points of a batched point-inside query against
+ * the proxy shapes whose AABB overlaps with the AABB of the packet. Each proxy shape that
+ * passes the collision filtering is tested against the points of the packet that are inside
+ * its fat AABB and that are not already inside another proxy shape.
+ */
+class PointsInsideCallback : public DynamicAABBTreeOverlapCallback {
+
+    private:
+
+        // -------------------- Attributes -------------------- //
+
+        /// Reference to the collision detection
+        const CollisionDetection& mCollisionDetection;
+
+        /// Bits mask used to filter the proxy shapes
+        collisionmask mCategoryMaskBits;
+
+    public:
+
+        // -------------------- Attributes -------------------- //
+
+        /// Sorted points of the packet
+        const Vector3* points = nullptr;
+
+        /// Sort keys of the points of the packet (the index of each point is in the low bits)
+        const uint64* sortKeys = nullptr;
+
+        /// Number of points in the packet
+        uint nbPoints = 0;
+
+        /// Array with the proxy shape that contains each point of the batch
+        ProxyShape** hits = nullptr;
+
+        // -------------------- Methods -------------------- //
+
+        /// Constructor
+        PointsInsideCallback(const CollisionDetection& collisionDetection, collisionmask categoryMaskBits)
+            : mCollisionDetection(collisionDetection), mCategoryMaskBits(categoryMaskBits) {
+
+        }
+
+        /// Test the points of the packet against the proxy shape of a broad-phase ID
+        virtual void notifyOverlappingNode(int broadPhaseId) override;
+};
 
 // Class CollisionDetection
 /**
@@ -59,6 +636,36 @@ class CollisionDetection {
 
     private :
 
+        // -------------------- Constants -------------------- //
+
+        /// Number of narrow-phase infos tested by a worker each time it takes
+        /// new work during the parallel narrow-phase
+        static const uint NARROW_PHASE_CHUNK_SIZE = 32;
+
+        /// Number of concave or compound pairs whose middle-phase is computed by a worker
+        /// each time it takes new work during the parallel middle-phase
+        static const uint MIDDLE_PHASE_CHUNK_SIZE = 4;
+
+        /// Number of ray packets cast by a worker each time it takes new work
+        /// during a parallel batched raycast
+        static const uint RAYCAST_BATCH_CHUNK_SIZE = 16;
+
+        /// Minimum number of queries for each task of a parallel batched distance query
+        static const uint MIN_NB_DISTANCE_QUERIES_PER_TASK = 64;
+
+        /// Number of points of a batched point-inside query that traverse the broad-phase together
+        static const uint POINTS_INSIDE_PACKET_SIZE = 32;
+
+        /// Minimum number of packets of points for each task of a parallel batched point-inside query
+        static const uint MIN_NB_POINTS_INSIDE_PACKETS_PER_TASK = 4;
+
+        /// Radius of the sphere that represents the point of a closest point query
+        static const decimal POINT_QUERY_RADIUS;
+
+        /// Index of the contact manifolds of a body whose range in the contact manifolds
+        /// of the bodies has not been assigned yet
+        static const uint INVALID_CONTACT_MANIFOLDS_INDEX = 0xFFFFFFFF;
+
         // -------------------- Attributes -------------------- //
 
         /// Memory manager
@@ -70,7 +677,8 @@ class CollisionDetection {
         /// Default collision dispatch configuration
         DefaultCollisionDispatch mDefaultCollisionDispatch;
 
-        /// Collision detection matrix (algorithms to use)
+        /// Collision detection matrix (algorithms to use). The matrix is symmetric and indexed
+        /// directly by the two collision shape types
         NarrowPhaseAlgorithm* mCollisionMatrix[NB_COLLISION_SHAPE_TYPES][NB_COLLISION_SHAPE_TYPES];
 
         /// Pointer to the physics world
@@ -80,17 +688,67 @@ class CollisionDetection {
         NarrowPhaseInfo* mNarrowPhaseInfoList;
 
         /// Broad-phase overlapping pairs
-        Map<Pair<uint, uint>, OverlappingPair*> mOverlappingPairs;
+        OverlappingPairCache mOverlappingPairs;
 
         /// Broad-phase algorithm
-        BroadPhaseAlgorithm mBroadPhaseAlgorithm;
+        BroadPhaseAlgorithm* mBroadPhaseAlgorithm;
+
+        /// Tree of the query-only proxy shapes. It is searched by the raycasts and the AABB
+        /// overlap tests but never by the computation of the overlapping pairs
+        DynamicAABBTree mQueryOnlyTree;
 
         /// Set of pair of bodies that cannot collide between each other
-        Set<bodyindexpair> mNoCollisionPairs;
+        FlatSet<bodyindexpair> mNoCollisionPairs;
 
         /// True if some collision shapes have been added previously
         bool mIsCollisionShapesAdded;
 
+        /// Overlapping pairs in the order they are processed after the narrow-phase
+        List<OverlappingPair*> mOrderedOverlappingPairs;
+
+        /// Contact events of the last collision detection
+        List<ContactEvent> mContactEvents;
+
+        /// Contact manifolds of all the overlapping pairs at the end of the last collision
+        /// detection (in the order of the processed overlapping pairs)
+        List<const ContactManifold*> mContactManifolds;
+
+        /// Triangles of a concave shape reported during the middle-phase (reused for all the pairs)
+        MiddlePhaseTriangleBatch mMiddlePhaseTriangles;
+
+        /// Contact manifolds of the bodies at the end of the last collision detection. The
+        /// manifolds of a body are contiguous (see CollisionBody::mContactManifoldsIndex) and
+        /// each manifold is in the ranges of its two bodies
+        List<ContactManifold*> mBodiesContactManifolds;
+
+        /// True if a body has been woken up since the last middle-phase (the parked
+        /// pairs are then tested to find the ones that are active again)
+        bool mIsBodyWokenUp;
+
+        /// GJK algorithm used for the speculative contacts and the sweep queries
+        GJKAlgorithm mGJKAlgorithm;
+
+        /// Time step used to create the speculative contacts of the bullet rigid bodies
+        /// (zero if the speculative contacts are disabled, for instance in a collision world)
+        decimal mSpeculativeContactsTimeStep;
+
+        /// Statistics of the last computation of the narrow-phase
+        NarrowPhaseStatistics mNarrowPhaseStatistics;
+
+        /// Costs of the overlapping pairs during the last collision detection (if enabled)
+        List<NarrowPhasePairCost> mNarrowPhasePairCosts;
+
+        /// Costs of the narrow-phase tests of each pair of types of collision shapes during the
+        /// last collision detection (if enabled), indexed like the batches of the narrow-phase
+        NarrowPhaseShapeTypeCost mNarrowPhaseShapeTypeCosts[NB_COLLISION_SHAPE_TYPES * NB_COLLISION_SHAPE_TYPES];
+
+        /// Time spent in the broad-phase during the last collision detection (in seconds)
+        double mBroadPhaseTime;
+
+        /// Time spent in the middle-phase and narrow-phase during the last collision
+        /// detection (in seconds)
+        double mNarrowPhaseTime;
+
 #ifdef IS_PROFILING_ACTIVE
 
 		/// Pointer to the profiler
@@ -106,12 +764,90 @@ class CollisionDetection {
         /// Compute the middle-phase collision detection
         void computeMiddlePhase();
 
+        /// Compute the middle-phase of the concave and compound pairs in parallel
+        void computeMiddlePhaseInParallel(TaskScheduler& taskScheduler, MiddlePhasePair* middlePhasePairs,
+                                          const uint* workerPairsIndices, uint nbWorkerPairs);
+
+        /// Add the narrow-phase infos of the pairs of the parallel middle-phase in the order of the pairs
+        void addMiddlePhasePairsNarrowPhaseInfos(MiddlePhasePair* middlePhasePairs, uint nbMiddlePhasePairs);
+
         /// Compute the narrow-phase collision detection
         void computeNarrowPhase();
 
-        /// Add a contact manifold to the linked list of contact manifolds of the two bodies
-        /// involved in the corresponding contact.
-        void addContactManifoldToBody(OverlappingPair* pair);
+        /// Sort the narrow-phase infos into batches with the same types of collision shapes
+        void sortNarrowPhaseInfosIntoBatches(NarrowPhaseInfo** narrowPhaseInfos, uint* batchIndices) const;
+
+        /// Add the cost of an overlapping pair to the costs of the current collision detection
+        uint addNarrowPhasePairCost(OverlappingPair* pair);
+
+        /// Add the cost of a narrow-phase test to the costs of its pair and of its types of shapes
+        void addNarrowPhaseTestCost(const NarrowPhaseInfo* narrowPhaseInfo);
+
+        /// Count a narrow-phase test in the statistics of the algorithm of its pair of shapes
+        void countNarrowPhaseTest(const CollisionShape* shape1, const CollisionShape* shape2);
+
+        /// Run the narrow-phase algorithms of an array of narrow-phase infos sorted into batches
+        void testNarrowPhaseBatches(NarrowPhaseInfo** narrowPhaseInfos, bool* isColliding, bool* isSpeculative,
+                                    uint nbNarrowPhaseInfos, MemoryAllocator& allocator);
+
+        /// Run the narrow-phase algorithms of all the narrow-phase infos in parallel
+        void computeNarrowPhaseInParallel(TaskScheduler& taskScheduler, NarrowPhaseInfo** narrowPhaseInfos,
+                                          bool* isColliding, bool* isSpeculative, uint nbNarrowPhaseInfos);
+
+        /// Return the Morton code of a point quantized with 9 bits per axis inside some bounds
+        static uint32 computeMortonCode(const Vector3& point, const Vector3& boundsMin, const Vector3& boundsScale);
+
+        /// Return the key used to sort the rays of a batch into coherent packets
+        static uint32 computeRaySortKey(const Ray& ray, const Vector3& originsMin, const Vector3& originsScale);
+
+        /// Test the packets of points of a sorted batch in a given range against the proxy shapes
+        void testPointsInsidePackets(const Vector3* sortedPoints, const uint64* sortKeys, uint nbPoints,
+                                     ProxyShape** hits, uint startPacket, uint endPacket,
+                                     collisionmask categoryMaskBits) const;
+
+        /// Compute the contacts between two collision shapes of two proxy shapes and store them in an array
+        void computeContactHits(ProxyShape* proxyShape1, ProxyShape* proxyShape2,
+                                CollisionShape* shape1, const Transform& shape1ToWorldTransform,
+                                CollisionShape* shape2, const Transform& shape2ToWorldTransform,
+                                ContactHit* hits, uint maxNbHits, uint& nbHits) const;
+
+        /// Cast a ray against the query-only proxy shapes
+        bool raycastQueryOnlyShapes(const Ray& ray, RaycastTest& raycastTest,
+                                    collisionmask raycastWithCategoryMaskBits, decimal& maxFraction) const;
+
+        /// Cast the packets of rays of a sorted batch in a given range and keep the closest hits
+        void raycastPackets(Ray* sortedRays, const uint64* sortKeys, uint nbRays, RaycastHit* hits,
+                            uint startPacket, uint endPacket, collisionmask raycastWithCategoryMaskBits,
+                            MemoryAllocator* shapesAllocator) const;
+
+        /// Return true if a collision shape overlaps with a proxy shape (two concave shapes never overlap)
+        bool testShapeOverlap(const CollisionShape* shape, const Transform& shapeToWorldTransform,
+                              ProxyShape* proxyShape) const;
+
+        /// Compute the time of impact of a swept convex shape with a proxy shape of the world
+        bool sweepProxyShape(const ConvexShape* shape, const Transform& startTransform,
+                             const Transform& endTransform, ProxyShape* proxyShape,
+                             decimal maxFraction, SweepInfo& sweepInfo,
+                             SweepTriangleHit* hitTriangle = nullptr) const;
+
+        /// Compute the distance between a convex shape and a proxy shape if it is smaller than a maximum distance
+        bool computeProxyShapeDistance(const ConvexShape* shape, const Transform& shapeToWorldTransform,
+                                       decimal shapeShrinkDistance, ProxyShape* proxyShape, decimal maxDistance,
+                                       DistanceInfo& distanceInfo) const;
+
+        /// Return the closest proxy shape of a convex shape (shrunk by a distance) within a maximum distance
+        bool computeClosestProxyShape(const ConvexShape* shape, const Transform& shapeToWorldTransform,
+                                      decimal shapeShrinkDistance, decimal maxDistance, DistanceInfo& hit,
+                                      collisionmask categoryMaskBits) const;
+
+        /// Use the result of the narrow-phase algorithm of a narrow-phase info and destroy it
+        void processNarrowPhaseInfo(NarrowPhaseInfo* narrowPhaseInfo, bool isColliding, bool isSpeculative);
+
+        /// Create a speculative contact for a narrow-phase info whose shapes are not colliding
+        bool computeSpeculativeContact(NarrowPhaseInfo* narrowPhaseInfo) const;
+
+        /// Add the contact manifolds of a pair to the contact manifolds of its two bodies
+        void addContactManifoldToBody(OverlappingPair* pair, uint& nbAssignedContactManifolds);
 
         /// Fill-in the collision detection matrix
         void fillInCollisionMatrix();
@@ -120,16 +856,39 @@ class CollisionDetection {
         NarrowPhaseAlgorithm* selectNarrowPhaseAlgorithm(const CollisionShapeType& shape1Type,
                                                          const CollisionShapeType& shape2Type) const;
 
+        /// Return the index of the batch of the narrow-phase infos of two collision shape types
+        static uint computeNarrowPhaseBatchIndex(const CollisionShapeType& shape1Type,
+                                                 const CollisionShapeType& shape2Type);
+
         /// Add all the contact manifold of colliding pairs to their bodies
         void addAllContactManifoldsToBodies();
 
         /// Compute the concave vs convex middle-phase algorithm for a given pair of bodies
-        void computeConvexVsConcaveMiddlePhase(OverlappingPair* pair, MemoryAllocator& allocator,
-                                               NarrowPhaseInfo** firstNarrowPhaseInfo);
+        uint computeConvexVsConcaveMiddlePhase(OverlappingPair* pair, MemoryAllocator& allocator,
+                                               MiddlePhaseTriangleBatch& triangles,
+                                               NarrowPhaseInfo** firstNarrowPhaseInfo,
+                                               bool isTriangleCullingEnabled);
+
+        /// Compute the middle-phase algorithm for a pair of bodies with at least one compound shape
+        uint computeCompoundMiddlePhase(OverlappingPair* pair, MemoryAllocator& allocator,
+                                        MiddlePhaseTriangleBatch& triangles,
+                                        NarrowPhaseInfo** firstNarrowPhaseInfo, bool isTriangleCullingEnabled);
 
         /// Compute the middle-phase collision detection between two proxy shapes
         NarrowPhaseInfo* computeMiddlePhaseForProxyShapes(OverlappingPair* pair);
 
+        /// Compute the order in which the overlapping pairs are processed after the narrow-phase
+        void computeOverlappingPairsOrder();
+
+        /// Remove all the overlapping pairs involving a proxy shape
+        void removeOverlappingPairs(ProxyShape* proxyShape);
+
+        /// Remove all the overlapping pairs involving the bodies that are being destroyed
+        void removeOverlappingPairsOfDestroyedBodies();
+
+        /// Destroy the overlapping pair at a given index of the overlapping pairs
+        void destroyOverlappingPair(uint index);
+
         /// Convert the potential contact into actual contacts
         void processAllPotentialContacts();
 
@@ -139,6 +898,12 @@ class CollisionDetection {
         /// Report contacts for all the colliding overlapping pairs
         void reportAllContacts();
 
+        /// Make the parked pairs with an awake body active again
+        void unparkPairsOfAwakeBodies();
+
+        /// Add a contact event for an overlapping pair to the buffer of contact events
+        void addContactEvent(OverlappingPair* pair, ContactEventType type);
+
         /// Process the potential contacts where one collion is a concave shape
         void processSmoothMeshContacts(OverlappingPair* pair);
    
@@ -150,7 +915,7 @@ class CollisionDetection {
         CollisionDetection(CollisionWorld* world, MemoryManager& memoryManager);
 
         /// Destructor
-        ~CollisionDetection() = default;
+        ~CollisionDetection();
 
         /// Deleted copy-constructor
         CollisionDetection(const CollisionDetection& collisionDetection) = delete;
@@ -171,6 +936,15 @@ class CollisionDetection {
         void updateProxyCollisionShape(ProxyShape* shape, const AABB& aabb,
                                        const Vector3& displacement = Vector3(0, 0, 0), bool forceReinsert = false);
 
+        /// Update a batch of proxy collision shapes that have moved
+        void updateProxyCollisionShapes(const ProxyShapeUpdate* updates, uint nbUpdates);
+
+        /// Update a proxy collision shape after the type of its body has changed
+        void updateProxyCollisionShapeType(ProxyShape* shape);
+
+        /// Move the broad-phase by the opposite of the displacement of the origin of the world
+        void shiftOrigin(const Vector3& shift);
+
         /// Add a pair of bodies that cannot collide with each other
         void addNoCollisionPair(CollisionBody* body1, CollisionBody* body2);
 
@@ -183,37 +957,182 @@ class CollisionDetection {
         /// Compute the collision detection
         void computeCollisionDetection();
 
+        /// Compute the broad-phase of the collision detection of a step
+        void computeCollisionDetectionBroadPhase();
+
+        /// Compute the middle-phase and the narrow-phase of the collision detection of a step
+        void computeCollisionDetectionNarrowPhase();
+
         /// Ray casting method
         void raycast(RaycastCallback* raycastCallback, const Ray& ray,
-                     unsigned short raycastWithCategoryMaskBits) const;
+                     collisionmask raycastWithCategoryMaskBits) const;
+
+        /// Cast a ray and return its closest hit
+        bool raycastClosest(const Ray& ray, RaycastHit& hit, collisionmask raycastWithCategoryMaskBits) const;
+
+        /// Return true if a ray hits a shape
+        bool raycastAny(const Ray& ray, collisionmask raycastWithCategoryMaskBits) const;
+
+        /// Cast a batch of rays and return the closest hit of each ray
+        void raycastBatch(const Ray* rays, uint nbRays, RaycastHit* hits,
+                          collisionmask raycastWithCategoryMaskBits);
 
         /// Report all the bodies that overlap with the aabb in parameter
-        void testAABBOverlap(const AABB& aabb, OverlapCallback* overlapCallback, unsigned short categoryMaskBits = 0xFFFF);
+        void testAABBOverlap(const AABB& aabb, OverlapCallback* overlapCallback, collisionmask categoryMaskBits = ALL_COLLISION_CATEGORIES);
+
+        /// Fill an array with the proxy shapes whose AABBs overlap with the aabb in parameter
+        uint testAABBOverlap(const AABB& aabb, OverlapHit* hits, uint maxNbHits, collisionmask categoryMaskBits) const;
+
+        /// Fill an array with the proxy shapes of the other bodies that overlap with a body
+        uint testOverlap(const CollisionBody* body, OverlapHit* hits, uint maxNbHits,
+                         collisionmask categoryMaskBits) const;
+
+        /// Fill an array with the proxy shapes that overlap with a convex shape at a given transform
+        uint testOverlap(const ConvexShape* shape, const Transform& shapeToWorldTransform, OverlapHit* hits,
+                         uint maxNbHits, collisionmask categoryMaskBits) const;
 
         /// Return true if two bodies overlap
         bool testOverlap(CollisionBody* body1, CollisionBody* body2);
 
         /// Report all the bodies that overlap with the body in parameter
-        void testOverlap(CollisionBody* body, OverlapCallback* overlapCallback, unsigned short categoryMaskBits = 0xFFFF);
+        void testOverlap(CollisionBody* body, OverlapCallback* overlapCallback, collisionmask categoryMaskBits = ALL_COLLISION_CATEGORIES);
 
         /// Test and report collisions between two bodies
         void testCollision(CollisionBody* body1, CollisionBody* body2, CollisionCallback* callback);
 
+        /// Fill an array with the contact points between two bodies
+        uint testCollision(CollisionBody* body1, CollisionBody* body2, ContactHit* hits,
+                           uint maxNbHits) const;
+
         /// Test and report collisions between a body and all the others bodies of the world
-        void testCollision(CollisionBody* body, CollisionCallback* callback, unsigned short categoryMaskBits = 0xFFFF);
+        void testCollision(CollisionBody* body, CollisionCallback* callback, collisionmask categoryMaskBits = ALL_COLLISION_CATEGORIES);
 
         /// Test and report collisions between all shapes of the world
         void testCollision(CollisionCallback* callback);
 
+        /// Return an AABB that contains a convex shape during its motion between two transforms
+        static AABB computeSweptAABB(const ConvexShape* shape, const Transform& startTransform,
+                                     const Transform& endTransform);
+
+        /// Return true if two collision shapes overlap (two concave shapes never overlap)
+        static bool testShapesOverlap(const GJKAlgorithm& gjkAlgorithm,
+                                      const CollisionShape* shape1, const Transform& shape1ToWorldTransform,
+                                      const CollisionShape* shape2, const Transform& shape2ToWorldTransform);
+
+        /// Compute the distance between two convex shapes (the first one is shrunk by a distance)
+        static void computeShapesDistance(const GJKAlgorithm& gjkAlgorithm,
+                                          const ConvexShape* shape1, const Transform& shape1ToWorldTransform,
+                                          decimal shape1ShrinkDistance, const ConvexShape* shape2,
+                                          const Transform& shape2ToWorldTransform, DistanceInfo& distanceInfo);
+
+        /// Return true if a child shape of a compound shape overlaps with another collision shape
+        static bool testCompoundShapeOverlap(const GJKAlgorithm& gjkAlgorithm,
+                                             const CompoundShape* compoundShape, const Transform& compoundToWorldTransform,
+                                             const CollisionShape* shape, const Transform& shapeToWorldTransform);
+
+        /// Compute the time of impact of two convex shapes moving between two transforms
+        bool testSweep(const ConvexShape* shape1, const Transform& shape1StartTransform,
+                       const Transform& shape1EndTransform, const ConvexShape* shape2,
+                       const Transform& shape2StartTransform, const Transform& shape2EndTransform,
+                       decimal& outFraction, Vector3& outNormal) const;
+
+        /// Sweep a convex shape between two transforms and report the shapes it hits
+        void sweep(const ConvexShape* shape, const Transform& startTransform, const Transform& endTransform,
+                   SweepCallback* sweepCallback, collisionmask sweepWithCategoryMaskBits);
+
+        /// Sweep a convex shape between two transforms and return its earliest hit
+        bool sweepClosest(const ConvexShape* shape, const Transform& startTransform, const Transform& endTransform,
+                          SweepInfo& hit, collisionmask sweepWithCategoryMaskBits);
+
+        /// Compute the distance and the closest points between two convex shapes
+        bool computeDistance(const ConvexShape* shape1, const Transform& shape1ToWorldTransform,
+                             const ConvexShape* shape2, const Transform& shape2ToWorldTransform,
+                             DistanceInfo& distanceInfo) const;
+
+        /// Compute the distances between the convex shapes of a batch of pairs
+        void computeDistanceBatch(const DistanceQuery* queries, uint nbQueries, DistanceInfo* distanceInfos);
+
+        /// Return the closest proxy shape of a point within a maximum distance
+        bool closestPoint(const Vector3& point, decimal maxDistance, DistanceInfo& hit,
+                          collisionmask categoryMaskBits) const;
+
+        /// Return the closest proxy shape of a convex shape within a maximum distance
+        bool closestPoint(const ConvexShape* shape, const Transform& shapeToWorldTransform, decimal maxDistance,
+                          DistanceInfo& hit, collisionmask categoryMaskBits) const;
+
+        /// Return the closest proxy shapes of a batch of points within a maximum distance
+        void closestPointBatch(const Vector3* points, uint nbPoints, decimal maxDistance, DistanceInfo* hits,
+                               collisionmask categoryMaskBits);
+
+        /// Find a proxy shape that contains each point of a batch and return the number of points inside
+        uint testPointsInside(const Vector3* points, uint nbPoints, ProxyShape** hits,
+                              collisionmask categoryMaskBits);
+
         /// Allow the broadphase to notify the collision detection about an overlapping pair.
         void broadPhaseNotifyOverlappingPair(ProxyShape* shape1, ProxyShape* shape2);
 
+        /// Return true if the collision filtering allows two proxy shapes to collide
+        bool testCollisionFilter(const ProxyShape* shape1, const ProxyShape* shape2) const;
+
+        /// Notify that a sleeping or static body has been woken up or has become dynamic
+        void notifyBodyWokenUp(CollisionBody* body);
+
+        /// Return a contact manifold of the contiguous array of the contact manifolds of the bodies
+        ContactManifold* getBodyContactManifold(uint index) const;
+
+        /// Allocate the memory needed to store a given number of proxy shapes in the broad-phase
+        void reserveProxyShapes(uint nbProxyShapes);
+
+        /// Start a batch of proxy shapes that are inserted together into the broad-phase
+        void beginProxyShapesBatch(bool isSpatialGroup = false);
+
+        /// Insert the proxy shapes added since the start of the batch into the broad-phase
+        void endProxyShapesBatch();
+
+        /// Allocate the memory needed to store a given number of overlapping pairs
+        void reservePairs(uint nbPairs);
+
+        /// Allocate the memory needed to add a given number of contact manifolds to the bodies
+        void reserveContactManifolds(uint nbContactManifolds);
+
+        /// Return the statistics of the last computation of the broad-phase
+        const BroadPhaseStatistics& getBroadPhaseStatistics() const;
+
+        /// Compute the metrics of the quality of the trees of the broad-phase
+        bool computeBroadPhaseTreeStatistics(DynamicAABBTreeStatistics& dynamicTreeStatistics,
+                                             DynamicAABBTreeStatistics& staticTreeStatistics) const;
+
+        /// Return the statistics of the last computation of the narrow-phase
+        const NarrowPhaseStatistics& getNarrowPhaseStatistics() const;
+
+        /// Return the most expensive overlapping pairs of the last collision detection
+        uint getMostExpensiveNarrowPhasePairs(NarrowPhasePairCost* pairCosts, uint nbMaxPairs) const;
+
+        /// Return the cost of the narrow-phase tests between two types of collision shapes
+        const NarrowPhaseShapeTypeCost& getNarrowPhaseShapeTypeCost(CollisionShapeType shape1Type,
+                                                                    CollisionShapeType shape2Type) const;
+
+        /// Return the contact events of the last collision detection
+        const List<ContactEvent>& getContactEvents() const;
+
+        /// Return the contact manifolds of the last collision detection
+        const List<const ContactManifold*>& getContactManifolds() const;
+
+        /// Return the time spent in the broad-phase during the last collision detection
+        double getBroadPhaseTime() const;
+
+        /// Return the time spent in the middle-phase and narrow-phase during the last collision detection
+        double getNarrowPhaseTime() const;
+
         /// Return a reference to the memory manager
         MemoryManager& getMemoryManager() const;
 
         /// Return a pointer to the world
         CollisionWorld* getWorld();
 
+        /// Return a pointer to the task scheduler used to execute work in parallel
+        TaskScheduler* getTaskScheduler() const;
+
         /// Return the world event listener
         EventListener* getWorldEventListener();
 
@@ -227,10 +1146,28 @@ class CollisionDetection {
         /// Return the world-space AABB of a given proxy shape
         const AABB getWorldAABB(const ProxyShape* proxyShape) const;
 
+        /// Write the overlapping pairs and their contacts
+        void saveState(WorldStateWriter& writer) const;
+
+        /// Destroy all the overlapping pairs and their contact manifolds
+        void destroyAllOverlappingPairs();
+
+        /// Create again the pairs written by saveState() (the current pairs must have been destroyed)
+        void restoreState(WorldStateReader& reader, const FlatMap<int, ProxyShape*>& savedProxyShapes);
+
+        /// Skip the pairs written by saveState() and return false if restoreState() cannot read them
+        bool checkState(WorldStateReader& reader, const FlatMap<int, ProxyShape*>& savedProxyShapes) const;
+
         // -------------------- Friendship -------------------- //
 
         friend class DynamicsWorld;
         friend class ConvexMeshShape;
+        friend class OverlapHitsCallback;
+        friend class ContactHitsTriangleCallback;
+        friend class ClosestPointCallback;
+        friend class DistanceTriangleCallback;
+        friend class PointsInsideCallback;
+        friend class CharacterController;
 };
 
 // Set the collision dispatch configuration
@@ -252,13 +1189,33 @@ inline void CollisionDetection::setCollisionDispatch(CollisionDispatch* collisio
 // Add a body to the collision detection
 inline void CollisionDetection::addProxyCollisionShape(ProxyShape* proxyShape,
                                                        const AABB& aabb) {
+
+    // A query-only shape is only added to the tree of the query-only shapes
+    if (proxyShape->isQueryOnly()) {
+        proxyShape->mQueryOnlyNodeID = mQueryOnlyTree.addObject(aabb, proxyShape);
+        return;
+    }
     
     // Add the body to the broad-phase
-    mBroadPhaseAlgorithm.addProxyCollisionShape(proxyShape, aabb);
+    mBroadPhaseAlgorithm->addProxyCollisionShape(proxyShape, aabb);
 
     mIsCollisionShapesAdded = true;
 }  
 
+// Start a batch of proxy shapes that are inserted together into the broad-phase
+/**
+ * @param isSpatialGroup True if the proxy shapes of the batch are close to each other (they
+ *                       are then grafted into the broad-phase as a group)
+ */
+inline void CollisionDetection::beginProxyShapesBatch(bool isSpatialGroup) {
+    mBroadPhaseAlgorithm->beginProxyShapesBatch(isSpatialGroup);
+}
+
+// Insert the proxy shapes added since the start of the batch into the broad-phase
+inline void CollisionDetection::endProxyShapesBatch() {
+    mBroadPhaseAlgorithm->endProxyShapesBatch();
+}
+
 // Add a pair of bodies that cannot collide with each other
 inline void CollisionDetection::addNoCollisionPair(CollisionBody* body1,
                                                    CollisionBody* body2) {
@@ -266,9 +1223,15 @@ inline void CollisionDetection::addNoCollisionPair(CollisionBody* body1,
 }
 
 // Remove a pair of bodies that cannot collide with each other
+/// The broad-phase does not report the pairs of bodies that cannot collide. Therefore,
+/// the shapes of the first body are tested again during the next broad-phase.
 inline void CollisionDetection::removeNoCollisionPair(CollisionBody* body1,
                                                       CollisionBody* body2) {
     mNoCollisionPairs.remove(OverlappingPair::computeBodiesIndexPair(body1, body2));
+
+    for (ProxyShape* shape = body1->getProxyShapesList(); shape != nullptr; shape = shape->getNext()) {
+        askForBroadPhaseCollisionCheck(shape);
+    }
 }
 
 // Ask for a collision shape to be tested again during broad-phase.
@@ -277,33 +1240,73 @@ inline void CollisionDetection::removeNoCollisionPair(CollisionBody* body1,
 inline void CollisionDetection::askForBroadPhaseCollisionCheck(ProxyShape* shape) {
 
     if (shape->getBroadPhaseId() != -1) {
-        mBroadPhaseAlgorithm.addMovedCollisionShape(shape->getBroadPhaseId());
+        mBroadPhaseAlgorithm->addMovedCollisionShape(shape->getBroadPhaseId());
     }
 }
 
 // Update a proxy collision shape (that has moved for instance)
 inline void CollisionDetection::updateProxyCollisionShape(ProxyShape* shape, const AABB& aabb,
                                                           const Vector3& displacement, bool forceReinsert) {
-    mBroadPhaseAlgorithm.updateProxyCollisionShape(shape, aabb, displacement);
+
+    if (shape->isQueryOnly()) {
+        mQueryOnlyTree.updateObject(shape->mQueryOnlyNodeID, aabb, displacement, forceReinsert);
+        return;
+    }
+
+    mBroadPhaseAlgorithm->updateProxyCollisionShape(shape, aabb, displacement, forceReinsert);
+}
+
+// Update a batch of proxy collision shapes that have moved
+/// The broad-phase skips the query-only shapes of the batch, which are updated here.
+inline void CollisionDetection::updateProxyCollisionShapes(const ProxyShapeUpdate* updates, uint nbUpdates) {
+
+    mBroadPhaseAlgorithm->updateProxyCollisionShapes(updates, nbUpdates);
+
+    if (mQueryOnlyTree.getNbObjects() > 0) {
+        for (uint i=0; i < nbUpdates; i++) {
+            ProxyShape* shape = updates[i].proxyShape;
+            if (shape->mQueryOnlyNodeID != -1) {
+                mQueryOnlyTree.updateObject(shape->mQueryOnlyNodeID, updates[i].aabb, updates[i].displacement,
+                                            updates[i].forceReinsert);
+            }
+        }
+    }
+}
+
+// Move the broad-phase by the opposite of the displacement of the origin of the world
+/// The fat AABBs are moved in place and the overlapping pairs and their contacts are kept.
+inline void CollisionDetection::shiftOrigin(const Vector3& shift) {
+    mBroadPhaseAlgorithm->shiftOrigin(shift);
+    mQueryOnlyTree.translate(-shift);
+}
+
+// Compute the time of impact of two convex shapes moving between two transforms
+inline bool CollisionDetection::testSweep(const ConvexShape* shape1, const Transform& shape1StartTransform,
+                                          const Transform& shape1EndTransform, const ConvexShape* shape2,
+                                          const Transform& shape2StartTransform, const Transform& shape2EndTransform,
+                                          decimal& outFraction, Vector3& outNormal) const {
+    return mGJKAlgorithm.computeTimeOfImpact(shape1, shape1StartTransform, shape1EndTransform,
+                                             shape2, shape2StartTransform, shape2EndTransform,
+                                             outFraction, outNormal);
 }
 
 // Return the corresponding narrow-phase algorithm
 inline NarrowPhaseAlgorithm* CollisionDetection::selectNarrowPhaseAlgorithm(const CollisionShapeType& shape1Type,
                                                                             const CollisionShapeType& shape2Type) const {
 
-    uint shape1Index = static_cast<unsigned int>(shape1Type);
-    uint shape2Index = static_cast<unsigned int>(shape2Type);
+    // The collision matrix is symmetric (the shape types do not have to be ordered)
+    return mCollisionMatrix[static_cast<uint>(shape1Type)][static_cast<uint>(shape2Type)];
+}
 
-    // Swap the shape types if necessary
-    if (shape1Index > shape2Index) {
-        const uint tempIndex = shape1Index;
-        shape1Index = shape2Index;
-        shape2Index = tempIndex;
-    }
+// Return the index of the batch of the narrow-phase infos of two collision shape types
+/// The two orders of the same shape types are in the same batch (they use the same algorithm).
+inline uint CollisionDetection::computeNarrowPhaseBatchIndex(const CollisionShapeType& shape1Type,
+                                                             const CollisionShapeType& shape2Type) {
 
-    assert(shape1Index <= shape2Index);
+    const uint shape1Index = static_cast<uint>(shape1Type);
+    const uint shape2Index = static_cast<uint>(shape2Type);
 
-    return mCollisionMatrix[shape1Index][shape2Index];
+    return std::min(shape1Index, shape2Index) * NB_COLLISION_SHAPE_TYPES + std::max(shape1Index, shape2Index);
 }
 
 // Return a pointer to the world
@@ -311,6 +1314,92 @@ inline CollisionWorld* CollisionDetection::getWorld() {
     return mWorld;
 }
 
+// Return the statistics of the last computation of the broad-phase
+inline const BroadPhaseStatistics& CollisionDetection::getBroadPhaseStatistics() const {
+    return mBroadPhaseAlgorithm->getStatistics();
+}
+
+// Compute the metrics of the quality of the trees of the broad-phase
+inline bool CollisionDetection::computeBroadPhaseTreeStatistics(DynamicAABBTreeStatistics& dynamicTreeStatistics,
+                                                                DynamicAABBTreeStatistics& staticTreeStatistics) const {
+    return mBroadPhaseAlgorithm->computeTreeStatistics(dynamicTreeStatistics, staticTreeStatistics);
+}
+
+// Return the statistics of the last computation of the narrow-phase
+inline const NarrowPhaseStatistics& CollisionDetection::getNarrowPhaseStatistics() const {
+    return mNarrowPhaseStatistics;
+}
+
+// Return the cost of the narrow-phase tests between two types of collision shapes
+inline const NarrowPhaseShapeTypeCost& CollisionDetection::getNarrowPhaseShapeTypeCost(CollisionShapeType shape1Type,
+                                                                                       CollisionShapeType shape2Type) const {
+    return mNarrowPhaseShapeTypeCosts[computeNarrowPhaseBatchIndex(shape1Type, shape2Type)];
+}
+
+// Notify that a sleeping or static body has been woken up or has become dynamic
+/// The parked pairs will be tested at the next middle-phase and the moved shapes of
+/// the body that have been kept by the broad-phase while it was sleeping will be
+/// tested again against all the shapes.
+inline void CollisionDetection::notifyBodyWokenUp(CollisionBody* body) {
+
+    mIsBodyWokenUp = true;
+
+    for (ProxyShape* shape = body->getProxyShapesList(); shape != nullptr; shape = shape->getNext()) {
+        if (shape->getBroadPhaseId() != -1) {
+            mBroadPhaseAlgorithm->wakeUpProxyCollisionShape(shape->getBroadPhaseId());
+        }
+    }
+}
+
+// Return true if the collision filtering allows two proxy shapes to collide
+/// Two shapes of the same body, two shapes of static bodies, two shapes whose collision
+/// categories and masks do not match and two shapes of bodies that cannot collide with each
+/// other (see addNoCollisionPair()) never collide.
+/**
+ * @param shape1 Pointer to the first proxy shape
+ * @param shape2 Pointer to the second proxy shape
+ * @return True if the two proxy shapes can collide
+ */
+inline bool CollisionDetection::testCollisionFilter(const ProxyShape* shape1, const ProxyShape* shape2) const {
+
+    const CollisionBody* body1 = shape1->getBody();
+    const CollisionBody* body2 = shape2->getBody();
+    if (body1 == body2) return false;
+
+    if ((shape1->getCollideWithMaskBits() & shape2->getCollisionCategoryBits()) == 0 ||
+        (shape1->getCollisionCategoryBits() & shape2->getCollideWithMaskBits()) == 0) return false;
+
+    if (body1->getType() == BodyType::STATIC && body2->getType() == BodyType::STATIC) return false;
+
+    return mNoCollisionPairs.size() == 0 ||
+           !mNoCollisionPairs.contains(OverlappingPair::computeBodiesIndexPair(body1, body2));
+}
+
+// Return the contact events of the last collision detection
+inline const List<ContactEvent>& CollisionDetection::getContactEvents() const {
+    return mContactEvents;
+}
+
+// Return the contact manifolds of the last collision detection
+inline const List<const ContactManifold*>& CollisionDetection::getContactManifolds() const {
+    return mContactManifolds;
+}
+
+// Return a contact manifold of the contiguous array of the contact manifolds of the bodies
+inline ContactManifold* CollisionDetection::getBodyContactManifold(uint index) const {
+    return mBodiesContactManifolds[index];
+}
+
+// Return the time spent in the broad-phase during the last collision detection (in seconds)
+inline double CollisionDetection::getBroadPhaseTime() const {
+    return mBroadPhaseTime;
+}
+
+// Return the time spent in the middle-phase and narrow-phase during the last collision detection (in seconds)
+inline double CollisionDetection::getNarrowPhaseTime() const {
+    return mNarrowPhaseTime;
+}
+
 // Return a reference to the memory manager
 inline MemoryManager& CollisionDetection::getMemoryManager() const {
     return mMemoryManager;
@@ -321,8 +1410,9 @@ inline MemoryManager& CollisionDetection::getMemoryManager() const {
 // Set the profiler
 inline void CollisionDetection::setProfiler(Profiler* profiler) {
 	mProfiler = profiler;
-	mBroadPhaseAlgorithm.setProfiler(profiler);
+	mBroadPhaseAlgorithm->setProfiler(profiler);
 	mCollisionDispatch->setProfiler(profiler);
+	mGJKAlgorithm.setProfiler(profiler);
 }
 
 #endif
@@ -0,0 +1,105 @@
+/********************************************************************************
+* ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
+* Copyright (c) 2010-2018 Daniel Chappuis                                       *
+*********************************************************************************
+*                                                                               *
+* This software is provided 'as-is', without any express or implied warranty.   *
+* In no event will the authors be held liable for any damages arising from the  *
+* use of this software.                                                         *
+*                                                                               *
+* Permission is granted to anyone to use this software for any purpose,         *
+* including commercial applications, and to alter it and redistribute it        *
+* freely, subject to the following restrictions:                                *
+*                                                                               *
+* 1. The origin of this software must not be misrepresented; you must not claim *
+*    that you wrote the original software. If you use this software in a        *
+*    product, an acknowledgment in the product documentation would be           *
+*    appreciated but is not required.                                           *
+*                                                                               *
+* 2. Altered source versions must be plainly marked as such, and must not be    *
+*    misrepresented as being the original software.                             *
+*                                                                               *
+* 3. This notice may not be removed or altered from any source distribution.    *
+*                                                                               *
+********************************************************************************/
+
+#ifndef REACTPHYSICS3D_CONTACT_EVENT_H
+#define REACTPHYSICS3D_CONTACT_EVENT_H
+
+// Libraries
+#include "configuration.h"
+
+/// ReactPhysics3D namespace
+namespace reactphysics3d {
+
+// Declarations
+class CollisionBody;
+class ProxyShape;
+
+// Enumeration ContactEventType
+/// Type of a contact event. A CONTACT_BEGIN event is reported at the first update where two
+/// proxy shapes have contacts, a CONTACT_STAY event at each following update where they still
+/// have contacts (only if WorldSettings::isContactStayEventReported is true) and a CONTACT_END
+/// event at the first update where they do not have contacts anymore. The TRIGGER_ENTER and
+/// TRIGGER_EXIT events are reported when a trigger proxy shape starts and stops intersecting
+/// with another proxy shape (see ProxyShape::setIsTrigger()).
+enum class ContactEventType {CONTACT_BEGIN, CONTACT_STAY, CONTACT_END, TRIGGER_ENTER, TRIGGER_EXIT};
+
+// Structure ContactEvent
+/**
+ * This structure contains a contact event between two proxy shapes. The contact events
+ * are stored in a buffer during the collision detection and can be read after the
+ * update of the world with CollisionWorld::getContactEvents().
+ */
+struct ContactEvent {
+
+    /// Type of the event
+    ContactEventType type;
+
+    /// Pointer to the first collision body
+    CollisionBody* body1;
+
+    /// Pointer to the second collision body
+    CollisionBody* body2;
+
+    /// Pointer to the proxy shape of the first body
+    ProxyShape* proxyShape1;
+
+    /// Pointer to the proxy shape of the second body
+    ProxyShape* proxyShape2;
+
+    /// Number of contact points between the two shapes (zero for a CONTACT_END event and
+    /// for the events of a trigger)
+    uint nbContactPoints;
+};
+
+// Structure ContactImpulse
+/**
+ * This structure contains a summary of the impulses applied by the contact solver to the
+ * contact points of a contact manifold during the last update of the world. The contact
+ * impulses can be read with DynamicsWorld::getContactImpulses().
+ */
+struct ContactImpulse {
+
+    /// Pointer to the first collision body
+    CollisionBody* body1;
+
+    /// Pointer to the second collision body
+    CollisionBody* body2;
+
+    /// Pointer to the proxy shape of the first body
+    ProxyShape* proxyShape1;
+
+    /// Pointer to the proxy shape of the second body
+    ProxyShape* proxyShape2;
+
+    /// Sum of the normal impulses of the contact points of the manifold
+    decimal totalNormalImpulse;
+
+    /// Largest normal impulse of a contact point of the manifold
+    decimal maxNormalImpulse;
+};
+
+}
+
+#endif
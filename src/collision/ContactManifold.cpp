@@ -27,6 +27,7 @@
 #include "ContactManifold.h"
 #include "constraint/ContactPoint.h"
 #include "collision/ContactManifoldInfo.h"
+#include "engine/WorldState.h"
 
 using namespace reactphysics3d;
 
@@ -40,22 +41,97 @@ ContactManifold::ContactManifold(const ContactManifoldInfo* manifoldInfo, ProxyS
                   mWorldSettings(worldSettings) {
     
     // For each contact point info in the manifold
-    const ContactPointInfo* pointInfo = manifoldInfo->getFirstContactPointInfo();
-    while(pointInfo != nullptr) {
+    for (uint i=0; i < manifoldInfo->getNbContactPoints(); i++) {
 
         // Add the new contact point
-        addContactPoint(pointInfo);
+        addContactPoint(&manifoldInfo->getContactPointInfo(i));
+    }
 
-        pointInfo = pointInfo->next;
+    assert(mNbContactPoints <= MAX_CONTACT_POINTS_IN_MANIFOLD);
+    assert(mNbContactPoints > 0);
+}
+
+// Constructor with a state written by saveState()
+ContactManifold::ContactManifold(WorldStateReader& reader, ProxyShape* shape1, ProxyShape* shape2,
+                                 MemoryAllocator& memoryAllocator, const WorldSettings& worldSettings)
+                : mShape1(shape1), mShape2(shape2), mContactPoints(nullptr),
+                  mNbContactPoints(0), mIsAlreadyInIsland(false),
+                  mMemoryAllocator(memoryAllocator), mNext(nullptr), mPrevious(nullptr), mIsObsolete(false),
+                  mWorldSettings(worldSettings) {
+
+    reader.read(mFrictionVector1);
+    reader.read(mFrictionVector2);
+    reader.read(mFrictionImpulse1);
+    reader.read(mFrictionImpulse2);
+    reader.read(mFrictionTwistImpulse);
+    reader.read(mRollingResistanceImpulse);
+
+    // The contact points have been written from the last one and are added again at the
+    // beginning of the linked-list so that they are in the same order
+    const int8 nbContactPoints = reader.read<int8>();
+    for (int8 i=0; i < nbContactPoints; i++) {
+
+        ContactPoint* contactPoint = new (mMemoryAllocator.allocate(sizeof(ContactPoint))) ContactPoint(reader, mWorldSettings);
+        contactPoint->setNext(mContactPoints);
+        contactPoint->setPrevious(nullptr);
+        if (mContactPoints != nullptr) {
+            mContactPoints->setPrevious(contactPoint);
+        }
+        mContactPoints = contactPoint;
+
+        mNbContactPoints++;
     }
 
     assert(mNbContactPoints <= MAX_CONTACT_POINTS_IN_MANIFOLD);
     assert(mNbContactPoints > 0);
 }
 
+// Write the state of the contact manifold and of its contact points
+void ContactManifold::saveState(WorldStateWriter& writer) const {
+
+    writer.write(mFrictionVector1);
+    writer.write(mFrictionVector2);
+    writer.write(mFrictionImpulse1);
+    writer.write(mFrictionImpulse2);
+    writer.write(mFrictionTwistImpulse);
+    writer.write(mRollingResistanceImpulse);
+
+    writer.write(mNbContactPoints);
+    ContactPoint* lastContactPoint = mContactPoints;
+    while (lastContactPoint->getNext() != nullptr) {
+        lastContactPoint = lastContactPoint->getNext();
+    }
+    for (ContactPoint* contactPoint = lastContactPoint; contactPoint != nullptr; contactPoint = contactPoint->getPrevious()) {
+        contactPoint->saveState(writer);
+    }
+}
+
+// Skip a state written by saveState() and return false if it cannot be read
+/// The state cannot be read if it is truncated or if its number of contact points is not valid.
+bool ContactManifold::checkState(WorldStateReader& reader) {
+
+    const size_t stateSize = sizeof(mFrictionVector1) + sizeof(mFrictionVector2) + sizeof(mFrictionImpulse1) +
+                             sizeof(mFrictionImpulse2) + sizeof(mFrictionTwistImpulse) +
+                             sizeof(mRollingResistanceImpulse);
+    if (!reader.canRead(stateSize + sizeof(int8))) return false;
+    reader.skip(stateSize);
+
+    const int8 nbContactPoints = reader.read<int8>();
+    if (nbContactPoints <= 0 || nbContactPoints > MAX_CONTACT_POINTS_IN_MANIFOLD) return false;
+    for (int8 i=0; i < nbContactPoints; i++) {
+        if (!ContactPoint::checkState(reader)) return false;
+    }
+
+    return true;
+}
+
 // Destructor
 ContactManifold::~ContactManifold() {
 
+    // The island of the bodies might not be connected anymore
+    mShape1->getBody()->mIsConstraintRemoved = true;
+    mShape2->getBody()->mIsConstraintRemoved = true;
+
     // Delete all the contact points
     ContactPoint* contactPoint = mContactPoints;
     while(contactPoint != nullptr) {
@@ -178,16 +254,20 @@ void ContactManifold::clearObsoleteContactPoints() {
 
 // Make sure we do not have too much contact points by keeping only the best
 // contact points of the manifold (with largest penetration depth)
-void ContactManifold::reduce() {
+/**
+ * @param nbMaxContactPoints Maximum number of contact points to keep (between 1 and 4)
+ */
+void ContactManifold::reduce(int nbMaxContactPoints) {
 
     assert(mContactPoints != nullptr);
+    assert(nbMaxContactPoints > 0 && nbMaxContactPoints <= MAX_CONTACT_POINTS_IN_MANIFOLD);
 
     // Remove contact points while there is too much contact points
-    while (mNbContactPoints > MAX_CONTACT_POINTS_IN_MANIFOLD) {
+    while (mNbContactPoints > nbMaxContactPoints) {
         removeNonOptimalContactPoint();
     }
 
-    assert(mNbContactPoints <= MAX_CONTACT_POINTS_IN_MANIFOLD && mNbContactPoints > 0);
+    assert(mNbContactPoints <= nbMaxContactPoints && mNbContactPoints > 0);
     assert(mContactPoints != nullptr);
 }
 
@@ -195,7 +275,7 @@ void ContactManifold::reduce() {
 void ContactManifold::removeNonOptimalContactPoint() {
 
     assert(mContactPoints != nullptr);
-    assert(mNbContactPoints > MAX_CONTACT_POINTS_IN_MANIFOLD);
+    assert(mNbContactPoints > 1);
 
     // Get the contact point with the minimum penetration depth among all points
     ContactPoint* contactPoint = mContactPoints;
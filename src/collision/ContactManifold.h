@@ -39,6 +39,8 @@ struct ContactPointInfo;
 class CollisionBody;
 class ContactPoint;
 class DefaultPoolAllocator;
+class WorldStateWriter;
+class WorldStateReader;
 
 // Structure ContactManifoldListElement
 /**
@@ -182,7 +184,7 @@ class ContactManifold {
         void addContactPoint(const ContactPointInfo* contactPointInfo);
 
         /// Make sure we do not have too much contact points by keeping only the best ones
-        void reduce();
+        void reduce(int nbMaxContactPoints);
 
         /// Remove a contact point that is not optimal (with a small penetration depth)
         void removeNonOptimalContactPoint();
@@ -214,6 +216,12 @@ class ContactManifold {
         /// Return the friction twist accumulated impulse
         decimal getFrictionTwistImpulse() const;
 
+        /// Write the state of the contact manifold and of its contact points
+        void saveState(WorldStateWriter& writer) const;
+
+        /// Skip a state written by saveState() and return false if it cannot be read
+        static bool checkState(WorldStateReader& reader);
+
     public:
 
         // -------------------- Methods -------------------- //
@@ -222,6 +230,10 @@ class ContactManifold {
         ContactManifold(const ContactManifoldInfo* manifoldInfo, ProxyShape* shape1, ProxyShape* shape2,
                         MemoryAllocator& memoryAllocator, const WorldSettings& worldSettings);
 
+        /// Constructor with a state written by saveState()
+        ContactManifold(WorldStateReader& reader, ProxyShape* shape1, ProxyShape* shape2,
+                        MemoryAllocator& memoryAllocator, const WorldSettings& worldSettings);
+
         /// Destructor
         ~ContactManifold();
 
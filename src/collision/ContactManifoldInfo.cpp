@@ -25,68 +25,48 @@
 
 // Libraries
 #include "ContactManifoldInfo.h"
-#include "collision/ContactPointInfo.h"
+#include <algorithm>
 
 using namespace reactphysics3d;
 
 // Constructor
-ContactManifoldInfo::ContactManifoldInfo(MemoryAllocator& allocator)
-     : mContactPointsList(nullptr), mNbContactPoints(0), mNext(nullptr), mAllocator(allocator) {
+ContactManifoldInfo::ContactManifoldInfo() : mNbContactPoints(0), mNext(nullptr) {
 
 }
 
-// Destructor
-ContactManifoldInfo::~ContactManifoldInfo() {
-
-    // Remove all the contact points
-    reset();
-}
-
 // Add a new contact point into the manifold
-void ContactManifoldInfo::addContactPoint(ContactPointInfo* contactPointInfo) {
-
-    assert(contactPointInfo->penetrationDepth > decimal(0.0));
-
-    // Add it into the linked list of contact points
-    contactPointInfo->next = mContactPointsList;
-    mContactPointsList = contactPointInfo;
-
-    mNbContactPoints++;
-}
-
-// Remove all the contact points
-void ContactManifoldInfo::reset() {
+/// If the array of contact points is full, the manifold is reduced before the new point
+/// is added.
+void ContactManifoldInfo::addContactPoint(const ContactPointInfo& contactPointInfo,
+                                          const Transform& shape1ToWorldTransform) {
 
-    // Delete all the contact points in the linked list
-    ContactPointInfo* element = mContactPointsList;
-    while(element != nullptr) {
-        ContactPointInfo* elementToDelete = element;
-        element = element->next;
+    assert(contactPointInfo.penetrationDepth != decimal(0.0));
 
-        // Call the constructor
-        elementToDelete->~ContactPointInfo();
+    // If there is no more room for the new contact point
+    if (mNbContactPoints == MAX_CANDIDATE_CONTACT_POINTS_IN_MANIFOLD) {
 
-        // Delete the current element
-        mAllocator.release(elementToDelete, sizeof(ContactPointInfo));
+        // Reduce the number of contact points of the manifold
+        reduce(shape1ToWorldTransform);
+        assert(mNbContactPoints < MAX_CANDIDATE_CONTACT_POINTS_IN_MANIFOLD);
     }
 
-    mContactPointsList = nullptr;
-    mNbContactPoints = 0;
+    // Copy the contact point into the array of contact points
+    mContactPoints[mNbContactPoints] = contactPointInfo;
+    mContactPoints[mNbContactPoints].next = nullptr;
+
+    mNbContactPoints++;
 }
 
 // Return the largest penetration depth among its contact points
 decimal ContactManifoldInfo::getLargestPenetrationDepth() const {
 
-    ContactPointInfo* contactPoint = mContactPointsList;
-    assert(contactPoint != nullptr);
+    assert(mNbContactPoints > 0);
     decimal maxDepth = decimal(0.0);
-    while (contactPoint != nullptr) {
+    for (uint i=0; i < mNbContactPoints; i++) {
 
-        if (contactPoint->penetrationDepth > maxDepth) {
-            maxDepth = contactPoint->penetrationDepth;
+        if (mContactPoints[i].penetrationDepth > maxDepth) {
+            maxDepth = mContactPoints[i].penetrationDepth;
         }
-
-        contactPoint = contactPoint->next;
     }
 
     return maxDepth;
@@ -96,210 +76,234 @@ decimal ContactManifoldInfo::getLargestPenetrationDepth() const {
 // This is based on the technique described by Dirk Gregorius in his
 // "Contacts Creation" GDC presentation. This method will reduce the number of
 // contact points to a maximum of 4 points (but it can be less).
-void ContactManifoldInfo::reduce(const Transform& shape1ToWorldTransform) {
-
-    assert(mContactPointsList != nullptr);
+// The local points of the first shape are copied into one array per axis so that
+// the score (distance or triangle area) of all the points is computed by a single
+// loop without branches before the points are selected.
+// With a smaller budget, the selection stops after the first points (the deepest point
+// is kept if a single point is allowed).
+/**
+ * @param shape1ToWorldTransform Local-to-world transform of the first shape
+ * @param nbMaxContactPoints Maximum number of contact points to keep (between 1 and 4)
+ */
+void ContactManifoldInfo::reduce(const Transform& shape1ToWorldTransform, uint nbMaxContactPoints) {
+
+    assert(mNbContactPoints > 0);
 
     // The following algorithm only works to reduce to a maximum of 4 contact points
     assert(MAX_CONTACT_POINTS_IN_MANIFOLD == 4);
+    assert(nbMaxContactPoints > 0 && nbMaxContactPoints <= MAX_CONTACT_POINTS_IN_MANIFOLD);
 
-    // If there are too many contact points in the manifold
-    if (mNbContactPoints > MAX_CONTACT_POINTS_IN_MANIFOLD) {
+    // If there are not too many contact points in the manifold
+    if (mNbContactPoints <= nbMaxContactPoints) {
+        return;
+    }
 
-        uint nbReducedPoints = 0;
+    const uint nbPoints = mNbContactPoints;
 
-        ContactPointInfo* pointsToKeep[MAX_CONTACT_POINTS_IN_MANIFOLD];
-        for (int i=0; i<MAX_CONTACT_POINTS_IN_MANIFOLD; i++) {
-            pointsToKeep[i] = nullptr;
-        }
+    // Coordinates of the contact points in the local-space of the first shape
+    decimal pointsX[MAX_CANDIDATE_CONTACT_POINTS_IN_MANIFOLD];
+    decimal pointsY[MAX_CANDIDATE_CONTACT_POINTS_IN_MANIFOLD];
+    decimal pointsZ[MAX_CANDIDATE_CONTACT_POINTS_IN_MANIFOLD];
 
-        //  Compute the initial contact point we need to keep.
-        // The first point we keep is always the point in a given
-        // constant direction (in order to always have same contact points
-        // between frames for better stability)
-
-        const Transform worldToShape1Transform = shape1ToWorldTransform.getInverse();
-
-        // Compute the contact normal of the manifold (we use the first contact point)
-        // in the local-space of the first collision shape
-        const Vector3 contactNormalShape1Space = worldToShape1Transform.getOrientation() * mContactPointsList->normal;
-
-        // Compute a search direction
-        const Vector3 searchDirection(1, 1, 1);
-        ContactPointInfo* element = mContactPointsList;
-        pointsToKeep[0] = element;
-        decimal maxDotProduct = searchDirection.dot(element->localPoint1);
-        element = element->next;
-        nbReducedPoints = 1;
-        while(element != nullptr) {
-
-            decimal dotProduct = searchDirection.dot(element->localPoint1);
-            if (dotProduct > maxDotProduct) {
-                maxDotProduct = dotProduct;
-                pointsToKeep[0] = element;
-            }
-            element = element->next;
-        }
-        assert(pointsToKeep[0] != nullptr);
-        assert(nbReducedPoints == 1);
+    // Score of each contact point for the point we are looking for
+    decimal scores[MAX_CANDIDATE_CONTACT_POINTS_IN_MANIFOLD];
 
-        // Compute the second contact point we need to keep.
-        // The second point we keep is the one farthest away from the first point.
+    // True if a contact point has already been selected
+    bool isPointKept[MAX_CANDIDATE_CONTACT_POINTS_IN_MANIFOLD];
 
-        decimal maxDistance = decimal(0.0);
-        element = mContactPointsList;
-        while(element != nullptr) {
+    for (uint i=0; i < nbPoints; i++) {
+        pointsX[i] = mContactPoints[i].localPoint1.x;
+        pointsY[i] = mContactPoints[i].localPoint1.y;
+        pointsZ[i] = mContactPoints[i].localPoint1.z;
+        isPointKept[i] = false;
+    }
 
-            if (element == pointsToKeep[0]) {
-                element = element->next;
-                continue;
-            }
+    uint pointsToKeep[MAX_CONTACT_POINTS_IN_MANIFOLD];
+    uint nbReducedPoints = 0;
 
-            decimal distance = (pointsToKeep[0]->localPoint1 - element->localPoint1).lengthSquare();
-            if (distance >= maxDistance) {
-                maxDistance = distance;
-                pointsToKeep[1] = element;
-                nbReducedPoints = 2;
-            }
-            element = element->next;
-        }
-        assert(pointsToKeep[1] != nullptr);
-        assert(nbReducedPoints == 2);
-
-        // Compute the third contact point we need to keep.
-        // The second point is the one producing the triangle with the larger area
-        // with first and second point.
-
-        // We compute the most positive or most negative triangle area (depending on winding)
-        ContactPointInfo* thirdPointMaxArea = nullptr;
-        ContactPointInfo* thirdPointMinArea = nullptr;
-        decimal minArea = decimal(0.0);
-        decimal maxArea = decimal(0.0);
-        bool isPreviousAreaPositive = true;
-        element = mContactPointsList;
-        while(element != nullptr) {
-
-            if (element == pointsToKeep[0] || element == pointsToKeep[1]) {
-                element = element->next;
-                continue;
-            }
+    const Transform worldToShape1Transform = shape1ToWorldTransform.getInverse();
 
-            const Vector3 newToFirst = pointsToKeep[0]->localPoint1 - element->localPoint1;
-            const Vector3 newToSecond = pointsToKeep[1]->localPoint1 - element->localPoint1;
+    // Compute the contact normal of the manifold (we use the first contact point)
+    // in the local-space of the first collision shape
+    const Vector3 normal = worldToShape1Transform.getOrientation() * mContactPoints[0].normal;
 
-            // Compute the triangle area
-            decimal area = newToFirst.cross(newToSecond).dot(contactNormalShape1Space);
+    //  Compute the initial contact point we need to keep.
+    // The first point we keep is always the point in a given
+    // constant direction (in order to always have same contact points
+    // between frames for better stability). The search direction is (1, 1, 1).
 
-            if (area >= maxArea) {
-                maxArea = area;
-                thirdPointMaxArea = element;
-            }
-            if (area <= minArea) {
-                minArea = area;
-                thirdPointMinArea = element;
+    // If a single point is kept, it is the deepest one
+    if (nbMaxContactPoints == 1) {
+        pointsToKeep[0] = 0;
+        for (uint i=1; i < nbPoints; i++) {
+            if (mContactPoints[i].penetrationDepth > mContactPoints[pointsToKeep[0]].penetrationDepth) {
+                pointsToKeep[0] = i;
             }
-            element = element->next;
         }
-        assert(minArea <= decimal(0.0));
-        assert(maxArea >= decimal(0.0));
-        if (maxArea > (-minArea)) {
-            isPreviousAreaPositive = true;
-            pointsToKeep[2] = thirdPointMaxArea;
-            nbReducedPoints = 3;
+        keepContactPoints(pointsToKeep, 1);
+        return;
+    }
+
+    for (uint i=0; i < nbPoints; i++) {
+        scores[i] = pointsX[i] + pointsY[i] + pointsZ[i];
+    }
+    pointsToKeep[0] = 0;
+    for (uint i=1; i < nbPoints; i++) {
+        if (scores[i] > scores[pointsToKeep[0]]) {
+            pointsToKeep[0] = i;
         }
-        else {
-            isPreviousAreaPositive = false;
-            pointsToKeep[2] = thirdPointMinArea;
-            nbReducedPoints = 3;
+    }
+    isPointKept[pointsToKeep[0]] = true;
+    nbReducedPoints = 1;
+
+    // Compute the second contact point we need to keep.
+    // The second point we keep is the one farthest away from the first point.
+
+    const decimal firstX = pointsX[pointsToKeep[0]];
+    const decimal firstY = pointsY[pointsToKeep[0]];
+    const decimal firstZ = pointsZ[pointsToKeep[0]];
+    for (uint i=0; i < nbPoints; i++) {
+        const decimal dx = firstX - pointsX[i];
+        const decimal dy = firstY - pointsY[i];
+        const decimal dz = firstZ - pointsZ[i];
+        scores[i] = dx * dx + dy * dy + dz * dz;
+    }
+    decimal maxDistance = decimal(0.0);
+    pointsToKeep[1] = 0;
+    for (uint i=0; i < nbPoints; i++) {
+        if (!isPointKept[i] && scores[i] >= maxDistance) {
+            maxDistance = scores[i];
+            pointsToKeep[1] = i;
+            nbReducedPoints = 2;
         }
+    }
+    assert(nbReducedPoints == 2);
+    isPointKept[pointsToKeep[1]] = true;
 
-        // Compute the 4th point by choosing the triangle that add the most
-        // triangle area to the previous triangle and has opposite sign area (opposite winding)
-
-        decimal largestArea = decimal(0.0); // Largest area (positive or negative)
-        element = mContactPointsList;
-
-        if (nbReducedPoints == 3) {
-
-            // For each remaining point
-            while(element != nullptr) {
-
-                if (element == pointsToKeep[0] || element == pointsToKeep[1] || element == pointsToKeep[2]) {
-                element = element->next;
-                continue;
-                }
-
-                // For each edge of the triangle made by the first three points
-                for (uint i=0; i<3; i++) {
-
-                uint edgeVertex1Index = i;
-                uint edgeVertex2Index = i < 2 ? i + 1 : 0;
+    if (nbMaxContactPoints == 2) {
+        keepContactPoints(pointsToKeep, nbReducedPoints);
+        return;
+    }
 
-                const Vector3 newToFirst = pointsToKeep[edgeVertex1Index]->localPoint1 - element->localPoint1;
-                const Vector3 newToSecond = pointsToKeep[edgeVertex2Index]->localPoint1 - element->localPoint1;
+    // Compute the third contact point we need to keep.
+    // The third point is the one producing the triangle with the larger area
+    // with first and second point.
 
-                // Compute the triangle area
-                decimal area = newToFirst.cross(newToSecond).dot(contactNormalShape1Space);
+    // We compute the most positive or most negative triangle area (depending on winding)
+    computeTriangleAreas(pointsX, pointsY, pointsZ, nbPoints, pointsToKeep[0], pointsToKeep[1], normal, scores);
+    uint thirdPointMaxArea = 0;
+    uint thirdPointMinArea = 0;
+    decimal minArea = decimal(0.0);
+    decimal maxArea = decimal(0.0);
+    for (uint i=0; i < nbPoints; i++) {
 
-                // We are looking at the triangle with maximal area (positive or negative).
-                // If the previous area is positive, we are looking at negative area now.
-                // If the previous area is negative, we are looking at the positive area now.
-                if (isPreviousAreaPositive && area <= largestArea) {
-                    largestArea = area;
-                    pointsToKeep[3] = element;
-                    nbReducedPoints = 4;
-                }
-                else if (!isPreviousAreaPositive && area >= largestArea) {
-                    largestArea = area;
-                    pointsToKeep[3] = element;
-                    nbReducedPoints = 4;
-                }
-                }
+        if (isPointKept[i]) continue;
 
-                element = element->next;
-            }
+        if (scores[i] >= maxArea) {
+            maxArea = scores[i];
+            thirdPointMaxArea = i;
         }
+        if (scores[i] <= minArea) {
+            minArea = scores[i];
+            thirdPointMinArea = i;
+        }
+    }
+    assert(minArea <= decimal(0.0));
+    assert(maxArea >= decimal(0.0));
+    const bool isPreviousAreaPositive = maxArea > (-minArea);
+    pointsToKeep[2] = isPreviousAreaPositive ? thirdPointMaxArea : thirdPointMinArea;
+    assert(!isPointKept[pointsToKeep[2]]);
+    isPointKept[pointsToKeep[2]] = true;
+    nbReducedPoints = 3;
+
+    if (nbMaxContactPoints == 3) {
+        keepContactPoints(pointsToKeep, nbReducedPoints);
+        return;
+    }
 
-        // Delete the contact points we do not want to keep from the linked list
-        element = mContactPointsList;
-        ContactPointInfo* previousElement = nullptr;
-        while(element != nullptr) {
-
-            bool deletePoint = true;
+    // Compute the 4th point by choosing the triangle that add the most
+    // triangle area to the previous triangle and has opposite sign area (opposite winding).
+    // If the previous area is positive, we are looking at the most negative area now.
+    // If the previous area is negative, we are looking at the most positive area now.
+
+    decimal edgeAreas[MAX_CANDIDATE_CONTACT_POINTS_IN_MANIFOLD];
+    computeTriangleAreas(pointsX, pointsY, pointsZ, nbPoints, pointsToKeep[0], pointsToKeep[1], normal, scores);
+    for (uint e=1; e < 3; e++) {
+
+        // For each edge of the triangle made by the first three points
+        computeTriangleAreas(pointsX, pointsY, pointsZ, nbPoints, pointsToKeep[e], pointsToKeep[e < 2 ? e + 1 : 0],
+                             normal, edgeAreas);
+        for (uint i=0; i < nbPoints; i++) {
+            scores[i] = isPreviousAreaPositive ? std::min(scores[i], edgeAreas[i]) :
+                                                 std::max(scores[i], edgeAreas[i]);
+        }
+    }
+    decimal largestArea = decimal(0.0); // Largest area (positive or negative)
+    for (uint i=0; i < nbPoints; i++) {
 
-            // Skip the points we want to keep
-            for (uint i=0; i<nbReducedPoints; i++) {
+        if (isPointKept[i]) continue;
 
-                if (element == pointsToKeep[i]) {
+        if ((isPreviousAreaPositive && scores[i] <= largestArea) ||
+            (!isPreviousAreaPositive && scores[i] >= largestArea)) {
+            largestArea = scores[i];
+            pointsToKeep[3] = i;
+            nbReducedPoints = 4;
+        }
+    }
 
-                    previousElement = element;
-                    element = element->next;
-                    deletePoint = false;
-                }
-            }
+    keepContactPoints(pointsToKeep, nbReducedPoints);
+}
 
-            if (deletePoint) {
+// Keep only some contact points and move them at the beginning of the array
+/// The kept contact points stay in the order of the array.
+void ContactManifoldInfo::keepContactPoints(const uint* pointsToKeep, uint nbPointsToKeep) {
 
-                ContactPointInfo* elementToDelete = element;
-                if (previousElement != nullptr) {
-                    previousElement->next = elementToDelete->next;
-                }
-                else {
-                    mContactPointsList = elementToDelete->next;
-                }
-                element = element->next;
+    uint nbKeptPoints = 0;
+    for (uint i=0; i < mNbContactPoints; i++) {
 
-                // Call the destructor
-                elementToDelete->~ContactPointInfo();
+        bool isKept = false;
+        for (uint j=0; j < nbPointsToKeep; j++) {
+            isKept = isKept || pointsToKeep[j] == i;
+        }
 
-                // Delete the current element
-                mAllocator.release(elementToDelete, sizeof(ContactPointInfo));
+        if (isKept) {
+            if (nbKeptPoints != i) {
+                mContactPoints[nbKeptPoints] = mContactPoints[i];
             }
+            nbKeptPoints++;
         }
-
-        assert(nbReducedPoints > 0 && nbReducedPoints <= 4);
-        mNbContactPoints = nbReducedPoints;
     }
-}
 
+    assert(nbKeptPoints == nbPointsToKeep);
+    assert(nbPointsToKeep > 0 && nbPointsToKeep <= MAX_CONTACT_POINTS_IN_MANIFOLD);
+    mNbContactPoints = nbPointsToKeep;
+}
 
+// Compute the signed areas of the triangles made by an edge and each contact point
+/// The area is computed with the coordinates arrays of the contact points and is signed
+/// with the winding of the triangle around the contact normal.
+void ContactManifoldInfo::computeTriangleAreas(const decimal* pointsX, const decimal* pointsY,
+                                               const decimal* pointsZ, uint nbPoints, uint edgeVertex1Index,
+                                               uint edgeVertex2Index, const Vector3& normal, decimal* outAreas) {
+
+    const decimal x1 = pointsX[edgeVertex1Index];
+    const decimal y1 = pointsY[edgeVertex1Index];
+    const decimal z1 = pointsZ[edgeVertex1Index];
+    const decimal x2 = pointsX[edgeVertex2Index];
+    const decimal y2 = pointsY[edgeVertex2Index];
+    const decimal z2 = pointsZ[edgeVertex2Index];
+
+    for (uint i=0; i < nbPoints; i++) {
+
+        // Vectors from the point to the two vertices of the edge
+        const decimal ax = x1 - pointsX[i];
+        const decimal ay = y1 - pointsY[i];
+        const decimal az = z1 - pointsZ[i];
+        const decimal bx = x2 - pointsX[i];
+        const decimal by = y2 - pointsY[i];
+        const decimal bz = z2 - pointsZ[i];
+
+        outAreas[i] = (ay * bz - az * by) * normal.x + (az * bx - ax * bz) * normal.y +
+                      (ax * by - ay * bx) * normal.z;
+    }
+}
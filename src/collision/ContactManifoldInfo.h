@@ -28,22 +28,27 @@
 
 // Libraries
 #include "configuration.h"
+#include "collision/ContactPointInfo.h"
 
 /// ReactPhysics3D namespace
 namespace reactphysics3d {
 
 // Declarations
-class MemoryAllocator;
-struct ContactPointInfo;
 class Transform;
 
 // Constants
 const int8 MAX_CONTACT_POINTS_IN_MANIFOLD = 4;   // Maximum number of contacts in the manifold
 
+// Maximum number of candidate contact points stored in a potential manifold before it is reduced
+const int8 MAX_CANDIDATE_CONTACT_POINTS_IN_MANIFOLD = 8;
+
 // Class ContactManifoldInfo
 /**
  * This class is used to collect the list of ContactPointInfo that come
- * from a collision test between two shapes.
+ * from a collision test between two shapes. The contact points are copied
+ * into a fixed-size array of the manifold. When this array is full, the
+ * manifold is reduced to MAX_CONTACT_POINTS_IN_MANIFOLD points before the
+ * new point is added so that no memory is allocated for the contact points.
  */
 class ContactManifoldInfo {
 
@@ -51,8 +56,8 @@ class ContactManifoldInfo {
 
         // -------------------- Attributes -------------------- //
 
-        /// Linked list with all the contact points
-        ContactPointInfo* mContactPointsList;
+        /// Array with all the contact points
+        ContactPointInfo mContactPoints[MAX_CANDIDATE_CONTACT_POINTS_IN_MANIFOLD];
 
         /// Number of contact points in the manifold
         uint mNbContactPoints;
@@ -60,18 +65,25 @@ class ContactManifoldInfo {
         /// Next element in the linked-list of contact manifold info
         ContactManifoldInfo* mNext;
 
-        /// Reference the the memory allocator where the contact point infos have been allocated
-        MemoryAllocator& mAllocator;
+        // -------------------- Methods -------------------- //
+
+        /// Keep only some contact points and move them at the beginning of the array
+        void keepContactPoints(const uint* pointsToKeep, uint nbPointsToKeep);
+
+        /// Compute the signed areas of the triangles made by an edge and each contact point
+        static void computeTriangleAreas(const decimal* pointsX, const decimal* pointsY,
+                                         const decimal* pointsZ, uint nbPoints, uint edgeVertex1Index,
+                                         uint edgeVertex2Index, const Vector3& normal, decimal* outAreas);
 
     public:
 
         // -------------------- Methods -------------------- //
 
         /// Constructor
-        ContactManifoldInfo(MemoryAllocator& allocator);
+        ContactManifoldInfo();
 
         /// Destructor
-        ~ContactManifoldInfo();
+        ~ContactManifoldInfo() = default;
 
         /// Deleted Copy-constructor
         ContactManifoldInfo(const ContactManifoldInfo& contactManifold) = delete;
@@ -80,13 +92,16 @@ class ContactManifoldInfo {
         ContactManifoldInfo& operator=(const ContactManifoldInfo& contactManifold) = delete;
 
         /// Add a new contact point into the manifold
-        void addContactPoint(ContactPointInfo* contactPointInfo);
+        void addContactPoint(const ContactPointInfo& contactPointInfo, const Transform& shape1ToWorldTransform);
 
         /// Remove all the contact points
         void reset();
 
-        /// Get the first contact point info of the linked list of contact points
-        ContactPointInfo* getFirstContactPointInfo() const;
+        /// Return the number of contact points in the manifold
+        uint getNbContactPoints() const;
+
+        /// Return a contact point info of the manifold
+        const ContactPointInfo& getContactPointInfo(uint index) const;
 
         /// Return the largest penetration depth among its contact points
         decimal getLargestPenetrationDepth() const;
@@ -95,16 +110,28 @@ class ContactManifoldInfo {
         ContactManifoldInfo* getNext();
 
         /// Reduce the number of contact points of the currently computed manifold
-        void reduce(const Transform& shape1ToWorldTransform);
+        void reduce(const Transform& shape1ToWorldTransform,
+                    uint nbMaxContactPoints = MAX_CONTACT_POINTS_IN_MANIFOLD);
 
         // Friendship
         friend class OverlappingPair;
         friend class CollisionDetection;
 };
 
-// Get the first contact point info of the linked list of contact points
-inline ContactPointInfo* ContactManifoldInfo::getFirstContactPointInfo() const {
-    return mContactPointsList;
+// Remove all the contact points
+inline void ContactManifoldInfo::reset() {
+    mNbContactPoints = 0;
+}
+
+// Return the number of contact points in the manifold
+inline uint ContactManifoldInfo::getNbContactPoints() const {
+    return mNbContactPoints;
+}
+
+// Return a contact point info of the manifold
+inline const ContactPointInfo& ContactManifoldInfo::getContactPointInfo(uint index) const {
+    assert(index < mNbContactPoints);
+    return mContactPoints[index];
 }
 
 // Return the pointer to the next manifold info in the linked-list
@@ -114,4 +141,3 @@ inline ContactManifoldInfo* ContactManifoldInfo::getNext() {
 
 }
 #endif
-
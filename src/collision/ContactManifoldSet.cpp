@@ -27,8 +27,10 @@
 #include "ContactManifoldSet.h"
 #include "constraint/ContactPoint.h"
 #include "collision/ContactManifoldInfo.h"
+#include "engine/WorldState.h"
 #include "ProxyShape.h"
 #include "collision/ContactManifold.h"
+#include <algorithm>
 
 using namespace reactphysics3d;
 
@@ -39,7 +41,7 @@ ContactManifoldSet::ContactManifoldSet(ProxyShape* shape1, ProxyShape* shape2,
                      mShape2(shape2), mMemoryAllocator(memoryAllocator), mManifolds(nullptr), mWorldSettings(worldSettings) {
 
     // Compute the maximum number of manifolds allowed between the two shapes
-    mNbMaxManifolds = computeNbMaxContactManifolds(shape1->getCollisionShape(), shape2->getCollisionShape());
+    mNbMaxManifolds = computeNbMaxContactManifolds();
 }
 
 // Destructor
@@ -51,7 +53,7 @@ ContactManifoldSet::~ContactManifoldSet() {
 
 void ContactManifoldSet::addContactManifold(const ContactManifoldInfo* contactManifoldInfo) {
 
-    assert(contactManifoldInfo->getFirstContactPointInfo() != nullptr);
+    assert(contactManifoldInfo->getNbContactPoints() > 0);
 
     // Try to find an existing contact manifold with similar contact normal
     ContactManifold* similarManifold = selectManifoldWithSimilarNormal(contactManifoldInfo);
@@ -83,17 +85,43 @@ int ContactManifoldSet::getTotalNbContactPoints() const {
     return nbPoints;
 }
 
-// Return the maximum number of contact manifolds allowed between to collision shapes
-int ContactManifoldSet::computeNbMaxContactManifolds(const CollisionShape* shape1, const CollisionShape* shape2) {
+// Return the maximum number of contact manifolds allowed between the two proxy shapes
+/// The budget of the world settings is lowered by the budgets of the proxy shapes.
+int ContactManifoldSet::computeNbMaxContactManifolds() const {
 
     // If both shapes are convex
-    if (shape1->isConvex() && shape2->isConvex()) {
-        return mWorldSettings.nbMaxContactManifoldsConvexShape;
+    int nbMaxManifolds;
+    if (mShape1->getCollisionShape()->isConvex() && mShape2->getCollisionShape()->isConvex()) {
+        nbMaxManifolds = mWorldSettings.nbMaxContactManifoldsConvexShape;
 
     }   // If there is at least one concave shape
     else {
-        return mWorldSettings.nbMaxContactManifoldsConcaveShape;
+        nbMaxManifolds = mWorldSettings.nbMaxContactManifoldsConcaveShape;
     }
+
+    if (mShape1->mNbMaxContactManifolds > 0) {
+        nbMaxManifolds = std::min(nbMaxManifolds, mShape1->mNbMaxContactManifolds);
+    }
+    if (mShape2->mNbMaxContactManifolds > 0) {
+        nbMaxManifolds = std::min(nbMaxManifolds, mShape2->mNbMaxContactManifolds);
+    }
+
+    return nbMaxManifolds;
+}
+
+// Return the maximum number of contact points in a contact manifold of the set
+/// The budget of the world settings is lowered by the budgets of the proxy shapes.
+int ContactManifoldSet::computeNbMaxContactPointsInManifold() const {
+
+    int nbMaxContactPoints = mWorldSettings.nbMaxContactPointsInManifold;
+    if (mShape1->mNbMaxContactPointsInManifold > 0) {
+        nbMaxContactPoints = std::min(nbMaxContactPoints, mShape1->mNbMaxContactPointsInManifold);
+    }
+    if (mShape2->mNbMaxContactPointsInManifold > 0) {
+        nbMaxContactPoints = std::min(nbMaxContactPoints, mShape2->mNbMaxContactPointsInManifold);
+    }
+
+    return std::max(1, std::min(nbMaxContactPoints, static_cast<int>(MAX_CONTACT_POINTS_IN_MANIFOLD)));
 }
 
 
@@ -104,9 +132,10 @@ void ContactManifoldSet::updateManifoldWithNewOne(ContactManifold* oldManifold,
    assert(newManifold != nullptr);
 
    // For each contact point of the new manifold
-   ContactPointInfo* contactPointInfo = newManifold->getFirstContactPointInfo();
-   assert(contactPointInfo != nullptr);
-   while (contactPointInfo != nullptr) {
+   assert(newManifold->getNbContactPoints() > 0);
+   for (uint i=0; i < newManifold->getNbContactPoints(); i++) {
+
+       const ContactPointInfo* contactPointInfo = &newManifold->getContactPointInfo(i);
 
        // For each contact point in the old manifold
        bool isSimilarPointFound = false;
@@ -133,8 +162,6 @@ void ContactManifoldSet::updateManifoldWithNewOne(ContactManifold* oldManifold,
            // Add the contact point to the manifold
            oldManifold->addContactPoint(contactPointInfo);
        }
-
-       contactPointInfo = contactPointInfo->next;
    }
 
    // The old manifold is no longer obsolete
@@ -176,8 +203,8 @@ void ContactManifoldSet::removeNonOptimalManifold() {
 ContactManifold* ContactManifoldSet::selectManifoldWithSimilarNormal(const ContactManifoldInfo* contactManifold) const {
 
     // Get the contact normal of the first point of the manifold
-    const ContactPointInfo* contactPoint = contactManifold->getFirstContactPointInfo();
-    assert(contactPoint != nullptr);
+    assert(contactManifold->getNbContactPoints() > 0);
+    const ContactPointInfo* contactPoint = &contactManifold->getContactPointInfo(0);
 
     ContactManifold* manifold = mManifolds;
 
@@ -216,9 +243,62 @@ void ContactManifoldSet::clear() {
         mNbManifolds--;
     }
 
+    mManifolds = nullptr;
+
     assert(mNbManifolds == 0);
 }
 
+// Write the state of the contact manifolds of the set
+/// The manifolds are written from the last one so that they are in the same order when
+/// they are added again at the beginning of the linked-list by restoreState().
+void ContactManifoldSet::saveState(WorldStateWriter& writer) const {
+
+    writer.write(mNbManifolds);
+
+    ContactManifold* lastManifold = mManifolds;
+    while (lastManifold != nullptr && lastManifold->getNext() != nullptr) {
+        lastManifold = lastManifold->getNext();
+    }
+    for (ContactManifold* manifold = lastManifold; manifold != nullptr; manifold = manifold->getPrevious()) {
+        manifold->saveState(writer);
+    }
+}
+
+// Replace the contact manifolds of the set with a state written by saveState()
+void ContactManifoldSet::restoreState(WorldStateReader& reader) {
+
+    clear();
+
+    const int nbManifolds = reader.read<int>();
+    for (int i=0; i < nbManifolds; i++) {
+
+        ContactManifold* manifold = new (mMemoryAllocator.allocate(sizeof(ContactManifold)))
+                                        ContactManifold(reader, mShape1, mShape2, mMemoryAllocator, mWorldSettings);
+        manifold->setPrevious(nullptr);
+        manifold->setNext(mManifolds);
+        if (mManifolds != nullptr) {
+            mManifolds->setPrevious(manifold);
+        }
+        mManifolds = manifold;
+
+        mNbManifolds++;
+    }
+}
+
+// Skip a state written by saveState() and return false if it cannot be read
+bool ContactManifoldSet::checkState(WorldStateReader& reader) {
+
+    if (!reader.canRead(sizeof(int))) return false;
+
+    const int nbManifolds = reader.read<int>();
+    if (nbManifolds < 0) return false;
+    for (int i=0; i < nbManifolds; i++) {
+        if (!ContactManifold::checkState(reader)) return false;
+    }
+
+    return true;
+}
+
 // Create a new contact manifold and add it to the set
 void ContactManifoldSet::createManifold(const ContactManifoldInfo* manifoldInfo) {
 
@@ -272,6 +352,33 @@ void ContactManifoldSet::makeContactsObsolete() {
     }
 }
 
+// Reuse the contact manifolds and contact points of the previous frame
+/// The contacts are not obsolete anymore and the penetration depth of each contact point is
+/// computed again along its normal with the current transforms of the shapes.
+void ContactManifoldSet::reuseContacts() {
+
+    const Transform shape1ToWorldTransform = mShape1->getLocalToWorldTransform();
+    const Transform shape2ToWorldTransform = mShape2->getLocalToWorldTransform();
+
+    ContactManifold* manifold = mManifolds;
+    while (manifold != nullptr) {
+
+        manifold->setIsObsolete(false, true);
+
+        ContactPoint* contactPoint = manifold->getContactPoints();
+        while (contactPoint != nullptr) {
+
+            const Vector3 point1 = shape1ToWorldTransform * contactPoint->getLocalPointOnShape1();
+            const Vector3 point2 = shape2ToWorldTransform * contactPoint->getLocalPointOnShape2();
+            contactPoint->setPenetrationDepth((point1 - point2).dot(contactPoint->getNormal()));
+
+            contactPoint = contactPoint->getNext();
+        }
+
+        manifold = manifold->getNext();
+    }
+}
+
 // Clear the obsolete contact manifolds and contact points
 void ContactManifoldSet::clearObsoleteManifoldsAndContactPoints() {
 
@@ -301,6 +408,10 @@ void ContactManifoldSet::clearObsoleteManifoldsAndContactPoints() {
 // Remove some contact manifolds and contact points if there are too many of them
 void ContactManifoldSet::reduce() {
 
+    // The budgets of the proxy shapes may have changed since the last frame
+    mNbMaxManifolds = computeNbMaxContactManifolds();
+    const int nbMaxContactPoints = computeNbMaxContactPointsInManifold();
+
     // Remove non optimal contact manifold while there are too many manifolds in the set
     while (mNbManifolds > mNbMaxManifolds) {
         removeNonOptimalManifold();
@@ -309,7 +420,7 @@ void ContactManifoldSet::reduce() {
     // Reduce all the contact manifolds in case they have too many contact points
     ContactManifold* manifold = mManifolds;
     while (manifold != nullptr) {
-        manifold->reduce();
+        manifold->reduce(nbMaxContactPoints);
         manifold = manifold->getNext();
     }
 }
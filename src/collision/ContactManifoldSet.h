@@ -35,6 +35,8 @@ class ProxyShape;
 class MemoryAllocator;
 struct WorldSettings;
 class CollisionShape;
+class WorldStateWriter;
+class WorldStateReader;
 
 // Constants
 const int MAX_MANIFOLDS_IN_CONTACT_MANIFOLD_SET = 3;   // Maximum number of contact manifolds in the set
@@ -88,8 +90,8 @@ class ContactManifoldSet {
         /// Update a previous similar manifold with a new one
         void updateManifoldWithNewOne(ContactManifold* oldManifold, const ContactManifoldInfo* newManifold);
 
-        /// Return the maximum number of contact manifolds allowed between to collision shapes
-        int computeNbMaxContactManifolds(const CollisionShape* shape1, const CollisionShape* shape2);
+        /// Return the maximum number of contact manifolds allowed between the two proxy shapes
+        int computeNbMaxContactManifolds() const;
 
         /// Clear the contact manifold set
         void clear();
@@ -126,14 +128,29 @@ class ContactManifoldSet {
         /// Make all the contact manifolds and contact points obsolete
         void makeContactsObsolete();
 
+        /// Reuse the contact manifolds and contact points of the previous frame
+        void reuseContacts();
+
         /// Return the total number of contact points in the set of manifolds
         int getTotalNbContactPoints() const;
 
+        /// Return the maximum number of contact points in a contact manifold of the set
+        int computeNbMaxContactPointsInManifold() const;
+
         /// Clear the obsolete contact manifolds and contact points
         void clearObsoleteManifoldsAndContactPoints();
 
         // Remove some contact manifolds and contact points if there are too many of them
         void reduce();
+
+        /// Write the state of the contact manifolds of the set
+        void saveState(WorldStateWriter& writer) const;
+
+        /// Replace the contact manifolds of the set with a state written by saveState()
+        void restoreState(WorldStateReader& reader);
+
+        /// Skip a state written by saveState() and return false if it cannot be read
+        static bool checkState(WorldStateReader& reader);
 };
 
 // Return the first proxy shape
@@ -56,7 +56,8 @@ struct ContactPointInfo {
         /// Normalized normal vector of the collision contact in world space
         Vector3 normal;
 
-        /// Penetration depth of the contact
+        /// Penetration depth of the contact (negative distance between the shapes for a
+        /// speculative contact of two shapes that are not touching yet)
         decimal penetrationDepth;
 
         /// Contact point of body 1 in local space of body 1
@@ -65,6 +66,11 @@ struct ContactPointInfo {
         /// Contact point of body 2 in local space of body 2
         Vector3 localPoint2;
 
+        /// Identifier of the features of the two shapes (faces, edges or vertices) that
+        /// generated the contact point or zero if unknown. Two contact points of the same
+        /// pair of shapes with the same non-zero identifier are the same persistent contact.
+        uint32 featureId;
+
         /// Pointer to the next contact point info
         ContactPointInfo* next;
 
@@ -73,14 +79,20 @@ struct ContactPointInfo {
 
         // -------------------- Methods -------------------- //
 
+        /// Constructor of an empty contact point (for the arrays of contact points)
+        ContactPointInfo() : penetrationDepth(0), featureId(0), next(nullptr), isUsed(false) {
+
+        }
+
         /// Constructor
         ContactPointInfo(const Vector3& contactNormal, decimal penDepth,
-                         const Vector3& localPt1, const Vector3& localPt2)
+                         const Vector3& localPt1, const Vector3& localPt2, uint32 contactFeatureId = 0)
                          : normal(contactNormal), penetrationDepth(penDepth),
-                           localPoint1(localPt1), localPoint2(localPt2), next(nullptr), isUsed(false) {
+                           localPoint1(localPt1), localPoint2(localPt2), featureId(contactFeatureId),
+                           next(nullptr), isUsed(false) {
 
             assert(contactNormal.lengthSquare() > decimal(0.8));
-            assert(penDepth > decimal(0.0));
+            assert(penDepth != decimal(0.0));
         }
 
         /// Destructor
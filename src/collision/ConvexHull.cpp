@@ -0,0 +1,587 @@
+/********************************************************************************
+* ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
+* Copyright (c) 2010-2018 Daniel Chappuis                                       *
+*********************************************************************************
+*                                                                               *
+* This software is provided 'as-is', without any express or implied warranty.   *
+* In no event will the authors be held liable for any damages arising from the  *
+* use of this software.                                                         *
+*                                                                               *
+* Permission is granted to anyone to use this software for any purpose,         *
+* including commercial applications, and to alter it and redistribute it        *
+* freely, subject to the following restrictions:                                *
+*                                                                               *
+* 1. The origin of this software must not be misrepresented; you must not claim *
+*    that you wrote the original software. If you use this software in a        *
+*    product, an acknowledgment in the product documentation would be           *
+*    appreciated but is not required.                                           *
+*                                                                               *
+* 2. Altered source versions must be plainly marked as such, and must not be    *
+*    misrepresented as being the original software.                             *
+*                                                                               *
+* 3. This notice may not be removed or altered from any source distribution.    *
+*                                                                               *
+********************************************************************************/
+
+// Libraries
+#include "ConvexHull.h"
+#include "memory/MemoryManager.h"
+#include <cmath>
+#include <utility>
+
+using namespace reactphysics3d;
+
+// Index used when a point is not assigned to any face of the hull
+static const uint NO_FACE = ~uint(0);
+
+// Constructor
+/**
+ * Compute the convex hull of a cloud of points. The points are copied and do not have to
+ * remain valid after the construction. When the number of faces is limited, the hull is
+ * computed again with less vertices until it has few enough faces (a hull has at least four
+ * faces).
+ * @param points Array with the points
+ * @param nbPoints Number of points in the array
+ * @param maxNbVertices Maximum number of vertices of the hull (zero for no limit)
+ * @param maxNbFaces Maximum number of faces of the hull (zero for no limit)
+ * @param planeTolerance Distance (in meters) under which a point is considered to be on the
+ *                       plane of a face of the hull (a smaller tolerance is always used to
+ *                       absorb the rounding errors)
+ */
+ConvexHull::ConvexHull(const Vector3* points, uint nbPoints, uint maxNbVertices, uint maxNbFaces,
+                       decimal planeTolerance)
+           : mVertices(MemoryManager::getBaseAllocator()), mIndices(MemoryManager::getBaseAllocator()),
+             mFaces(MemoryManager::getBaseAllocator()), mPolygonVertexArray(nullptr) {
+
+    assert(maxNbVertices == 0 || maxNbVertices >= 4);
+
+    // The tolerance grows with the magnitude of the coordinates of the points
+    Vector3 maxCoordinates = Vector3::zero();
+    for (uint i=0; i < nbPoints; i++) {
+        maxCoordinates = Vector3::max(maxCoordinates, points[i].getAbsoluteVector());
+    }
+    mTolerance = std::max(planeTolerance, decimal(3.0) * MACHINE_EPSILON *
+                          (maxCoordinates.x + maxCoordinates.y + maxCoordinates.z));
+
+    bool isValid = build(points, nbPoints, maxNbVertices);
+    while (isValid && maxNbFaces > 0 && mFaces.size() > maxNbFaces && mVertices.size() > 4) {
+        isValid = build(points, nbPoints, static_cast<uint>(mVertices.size()) - 1);
+    }
+
+    if (isValid) {
+        const PolygonVertexArray::VertexDataType vertexType = sizeof(decimal) == sizeof(float) ?
+                                                              PolygonVertexArray::VertexDataType::VERTEX_FLOAT_TYPE :
+                                                              PolygonVertexArray::VertexDataType::VERTEX_DOUBLE_TYPE;
+        mPolygonVertexArray = new PolygonVertexArray(static_cast<uint>(mVertices.size()), &(mVertices[0]),
+                                                     sizeof(Vector3), &(mIndices[0]), sizeof(uint),
+                                                     static_cast<uint>(mFaces.size()), &(mFaces[0]), vertexType,
+                                                     PolygonVertexArray::IndexDataType::INDEX_INTEGER_TYPE);
+    }
+    else {
+        mVertices.clear();
+        mIndices.clear();
+        mFaces.clear();
+    }
+}
+
+// Destructor
+ConvexHull::~ConvexHull() {
+    delete mPolygonVertexArray;
+}
+
+// Compute the hull of the points with a maximum number of vertices
+/// At each iteration, the point that is the furthest outside of the current hull is added
+/// to the hull: the triangles that are visible from the point are removed and replaced by a
+/// cone of triangles between the point and the edges of the horizon. The points outside of
+/// the removed triangles are then assigned to the new triangles. Return false if the points
+/// are coplanar.
+/**
+ * @param points Array with the points
+ * @param nbPoints Number of points in the array
+ * @param maxNbVertices Maximum number of vertices of the hull (zero for no limit)
+ */
+bool ConvexHull::build(const Vector3* points, uint nbPoints, uint maxNbVertices) {
+
+    mVertices.clear();
+    mIndices.clear();
+    mFaces.clear();
+
+    MemoryAllocator& allocator = MemoryManager::getBaseAllocator();
+    List<HullFace> faces(allocator);
+    List<bool> isHullVertex(allocator, nbPoints);
+    for (uint i=0; i < nbPoints; i++) {
+        isHullVertex.add(false);
+    }
+
+    if (!createInitialTetrahedron(points, nbPoints, faces, isHullVertex)) return false;
+    uint nbHullVertices = 4;
+
+    // Face that each point is outside of (and its distance to this face)
+    List<uint> pointFaces(allocator, nbPoints);
+    List<decimal> pointDistances(allocator, nbPoints);
+    auto assignPoint = [&](uint pointIndex, uint firstFace) {
+        pointFaces[pointIndex] = NO_FACE;
+        pointDistances[pointIndex] = mTolerance;
+        for (uint f=firstFace; f < faces.size(); f++) {
+            if (!faces[f].isValid) continue;
+            const decimal distance = faces[f].getDistance(points[pointIndex]);
+            if (distance > pointDistances[pointIndex]) {
+                pointFaces[pointIndex] = f;
+                pointDistances[pointIndex] = distance;
+            }
+        }
+    };
+    for (uint i=0; i < nbPoints; i++) {
+        pointFaces.add(NO_FACE);
+        pointDistances.add(decimal(0.0));
+        if (!isHullVertex[i]) assignPoint(i, 0);
+    }
+
+    List<uint> visibleFaces(allocator);
+    List<HorizonEdge> horizon(allocator);
+
+    while (maxNbVertices == 0 || nbHullVertices < maxNbVertices) {
+
+        // Find the point that is the furthest outside of the hull
+        uint furthestPoint = nbPoints;
+        decimal maxDistance = decimal(0.0);
+        for (uint i=0; i < nbPoints; i++) {
+            if (pointFaces[i] != NO_FACE && pointDistances[i] > maxDistance) {
+                furthestPoint = i;
+                maxDistance = pointDistances[i];
+            }
+        }
+        if (furthestPoint == nbPoints) break;
+
+        const Vector3& point = points[furthestPoint];
+
+        // Compute the triangles that are visible from the point and the horizon
+        visibleFaces.clear();
+        horizon.clear();
+        computeHorizon(point, faces, pointFaces[furthestPoint], 3, visibleFaces, horizon);
+
+        // The horizon must be a simple loop of edges (it might not be because of the rounding
+        // errors when the point is almost on the plane of a triangle). Otherwise, the point is
+        // ignored.
+        bool isHorizonValid = horizon.size() >= 3;
+        for (uint k=0; k < horizon.size() && isHorizonValid; k++) {
+            const HullFace& face = faces[horizon[k].face];
+            const HullFace& nextFace = faces[horizon[(k + 1) % horizon.size()].face];
+            isHorizonValid = face.vertices[(horizon[k].edge + 1) % 3] ==
+                             nextFace.vertices[horizon[(k + 1) % horizon.size()].edge];
+            for (uint l=0; l < k && isHorizonValid; l++) {
+                isHorizonValid = face.vertices[horizon[k].edge] != faces[horizon[l].face].vertices[horizon[l].edge];
+            }
+        }
+        if (!isHorizonValid) {
+            for (uint v=0; v < visibleFaces.size(); v++) {
+                faces[visibleFaces[v]].isVisible = false;
+            }
+            pointFaces[furthestPoint] = NO_FACE;
+            continue;
+        }
+
+        // Create the cone of triangles between the horizon and the point
+        const uint firstNewFace = static_cast<uint>(faces.size());
+        const uint nbNewFaces = static_cast<uint>(horizon.size());
+        for (uint k=0; k < nbNewFaces; k++) {
+
+            const HullFace& visibleFace = faces[horizon[k].face];
+            const uint vertex1 = visibleFace.vertices[horizon[k].edge];
+            const uint vertex2 = visibleFace.vertices[(horizon[k].edge + 1) % 3];
+            const uint neighbor = visibleFace.neighbors[horizon[k].edge];
+
+            HullFace face;
+            face.vertices[0] = vertex1;
+            face.vertices[1] = vertex2;
+            face.vertices[2] = furthestPoint;
+            face.neighbors[0] = neighbor;
+            face.neighbors[1] = firstNewFace + (k + 1) % nbNewFaces;
+            face.neighbors[2] = firstNewFace + (k + nbNewFaces - 1) % nbNewFaces;
+            face.isValid = true;
+            face.isVisible = false;
+            computeFacePlane(points, face);
+
+            faces[neighbor].neighbors[getEdgeIndex(faces[neighbor], vertex2)] = firstNewFace + k;
+            faces.add(face);
+        }
+
+        // Remove the visible triangles
+        for (uint v=0; v < visibleFaces.size(); v++) {
+            faces[visibleFaces[v]].isValid = false;
+        }
+
+        isHullVertex[furthestPoint] = true;
+        pointFaces[furthestPoint] = NO_FACE;
+        nbHullVertices++;
+
+        // Assign the points outside of the removed triangles to the new triangles
+        for (uint i=0; i < nbPoints; i++) {
+            if (pointFaces[i] != NO_FACE && !faces[pointFaces[i]].isValid) {
+                assignPoint(i, firstNewFace);
+            }
+        }
+    }
+
+    createPolygonFaces(points, nbPoints, faces);
+    removeEdgeVertices();
+
+    return true;
+}
+
+// Create the initial tetrahedron of the hull
+/// The first two vertices are the most distant points among the extreme points along the
+/// axes. The third one is the furthest point from the line between them and the fourth one is
+/// the furthest point from the plane of the first three. Return false if the points are coplanar.
+bool ConvexHull::createInitialTetrahedron(const Vector3* points, uint nbPoints, List<HullFace>& faces,
+                                          List<bool>& isHullVertex) const {
+
+    if (nbPoints < 4) return false;
+
+    // Extreme points along the three axes
+    uint extremePoints[6] = {0, 0, 0, 0, 0, 0};
+    for (uint i=1; i < nbPoints; i++) {
+        for (int axis=0; axis < 3; axis++) {
+            if (points[i][axis] < points[extremePoints[2 * axis]][axis]) extremePoints[2 * axis] = i;
+            if (points[i][axis] > points[extremePoints[2 * axis + 1]][axis]) extremePoints[2 * axis + 1] = i;
+        }
+    }
+
+    // The two most distant extreme points
+    uint vertices[4];
+    decimal maxDistanceSquare = decimal(-1.0);
+    for (int axis=0; axis < 3; axis++) {
+        const decimal distanceSquare = (points[extremePoints[2 * axis + 1]] - points[extremePoints[2 * axis]]).lengthSquare();
+        if (distanceSquare > maxDistanceSquare) {
+            maxDistanceSquare = distanceSquare;
+            vertices[0] = extremePoints[2 * axis];
+            vertices[1] = extremePoints[2 * axis + 1];
+        }
+    }
+    if (maxDistanceSquare <= mTolerance * mTolerance) return false;
+
+    // The furthest point from the line between the first two vertices
+    const Vector3 lineDirection = (points[vertices[1]] - points[vertices[0]]) / std::sqrt(maxDistanceSquare);
+    maxDistanceSquare = decimal(-1.0);
+    for (uint i=0; i < nbPoints; i++) {
+        const decimal distanceSquare = (points[i] - points[vertices[0]]).cross(lineDirection).lengthSquare();
+        if (distanceSquare > maxDistanceSquare) {
+            maxDistanceSquare = distanceSquare;
+            vertices[2] = i;
+        }
+    }
+    if (maxDistanceSquare <= mTolerance * mTolerance) return false;
+
+    // The furthest point from the plane of the first three vertices
+    const Vector3 planeNormal = (points[vertices[1]] - points[vertices[0]]).cross(
+                                 points[vertices[2]] - points[vertices[0]]).getUnit();
+    decimal maxDistance = decimal(-1.0);
+    decimal signedDistance = decimal(0.0);
+    for (uint i=0; i < nbPoints; i++) {
+        const decimal distance = planeNormal.dot(points[i] - points[vertices[0]]);
+        if (std::abs(distance) > maxDistance) {
+            maxDistance = std::abs(distance);
+            signedDistance = distance;
+            vertices[3] = i;
+        }
+    }
+    if (maxDistance <= mTolerance) return false;
+
+    // The first triangle must face away from the fourth vertex
+    if (signedDistance > decimal(0.0)) std::swap(vertices[1], vertices[2]);
+
+    // The four triangles of the tetrahedron (counter-clockwise seen from outside)
+    const uint triangles[4][3] = {{vertices[0], vertices[1], vertices[2]}, {vertices[1], vertices[0], vertices[3]},
+                                  {vertices[2], vertices[1], vertices[3]}, {vertices[0], vertices[2], vertices[3]}};
+    for (uint f=0; f < 4; f++) {
+        HullFace face;
+        face.vertices[0] = triangles[f][0];
+        face.vertices[1] = triangles[f][1];
+        face.vertices[2] = triangles[f][2];
+        face.neighbors[0] = face.neighbors[1] = face.neighbors[2] = 0;
+        face.isValid = true;
+        face.isVisible = false;
+        computeFacePlane(points, face);
+        faces.add(face);
+    }
+
+    // The neighbor across each edge is the triangle with the opposite edge
+    for (uint f=0; f < 4; f++) {
+        for (uint e=0; e < 3; e++) {
+            const uint startVertex = faces[f].vertices[e];
+            const uint endVertex = faces[f].vertices[(e + 1) % 3];
+            for (uint g=0; g < 4; g++) {
+                for (uint h=0; h < 3; h++) {
+                    if (faces[g].vertices[h] == endVertex && faces[g].vertices[(h + 1) % 3] == startVertex) {
+                        faces[f].neighbors[e] = g;
+                    }
+                }
+            }
+        }
+    }
+
+    for (uint v=0; v < 4; v++) {
+        isHullVertex[vertices[v]] = true;
+    }
+
+    return true;
+}
+
+// Compute the ordered edges of the horizon of the triangles visible from a point
+/// The visible triangles are found with a depth-first search from a visible triangle. The
+/// edges of each triangle are visited in counter-clockwise order starting after the edge
+/// that has been crossed to reach it, so that the edges of the horizon are found in
+/// counter-clockwise order around the visible triangles.
+/**
+ * @param point The point that is added to the hull
+ * @param faces The triangles of the hull
+ * @param faceIndex Index of a visible triangle
+ * @param crossedEdge Index of the edge of the triangle that has been crossed to reach it (3
+ *                    for the first triangle of the search)
+ * @param[out] visibleFaces The visible triangles
+ * @param[out] horizon The ordered edges of the horizon
+ */
+void ConvexHull::computeHorizon(const Vector3& point, List<HullFace>& faces, uint faceIndex, uint crossedEdge,
+                                List<uint>& visibleFaces, List<HorizonEdge>& horizon) const {
+
+    faces[faceIndex].isVisible = true;
+    visibleFaces.add(faceIndex);
+
+    const uint firstEdge = crossedEdge < 3 ? crossedEdge + 1 : 0;
+    const uint nbEdges = crossedEdge < 3 ? 2 : 3;
+    for (uint k=0; k < nbEdges; k++) {
+
+        const uint edge = (firstEdge + k) % 3;
+        const uint neighbor = faces[faceIndex].neighbors[edge];
+        if (faces[neighbor].isVisible) continue;
+
+        if (faces[neighbor].getDistance(point) > mTolerance) {
+            const uint neighborEdge = getEdgeIndex(faces[neighbor], faces[faceIndex].vertices[(edge + 1) % 3]);
+            computeHorizon(point, faces, neighbor, neighborEdge, visibleFaces, horizon);
+        }
+        else {
+            horizon.add({faceIndex, edge});
+        }
+    }
+}
+
+// Merge the coplanar triangles of the hull into polygons and store the result
+/// The triangles are grouped with their neighbors whose vertices are on the plane of the
+/// first triangle of the group (up to the tolerance). The polygon of a group is the loop of
+/// its boundary edges. The triangles of a group whose boundary is not a single loop are kept
+/// as separated faces.
+void ConvexHull::createPolygonFaces(const Vector3* points, uint nbPoints, const List<HullFace>& faces) {
+
+    MemoryAllocator& allocator = MemoryManager::getBaseAllocator();
+
+    // Index of the vertex of the hull of each point (-1 if the point is not a vertex)
+    List<int> pointVertices(allocator, nbPoints);
+    for (uint i=0; i < nbPoints; i++) {
+        pointVertices.add(-1);
+    }
+
+    // First triangle of the group of each triangle
+    List<uint> faceGroups(allocator, faces.size());
+    for (uint f=0; f < faces.size(); f++) {
+        faceGroups.add(NO_FACE);
+    }
+
+    List<uint> group(allocator);
+    List<uint> boundaryStarts(allocator);
+    List<uint> boundaryEnds(allocator);
+    List<uint> facePoints(allocator);
+
+    for (uint f=0; f < faces.size(); f++) {
+
+        if (!faces[f].isValid || faceGroups[f] != NO_FACE) continue;
+
+        // Group the coplanar neighbors of the triangle
+        const HullFace& seedFace = faces[f];
+        group.clear();
+        group.add(f);
+        faceGroups[f] = f;
+        for (uint g=0; g < group.size(); g++) {
+            for (uint e=0; e < 3; e++) {
+
+                const uint neighbor = faces[group[g]].neighbors[e];
+                if (faceGroups[neighbor] != NO_FACE) continue;
+
+                const HullFace& neighborFace = faces[neighbor];
+                bool isCoplanar = neighborFace.normal.dot(seedFace.normal) > decimal(0.0);
+                for (uint v=0; v < 3 && isCoplanar; v++) {
+                    isCoplanar = std::abs(seedFace.getDistance(points[neighborFace.vertices[v]])) <= mTolerance;
+                }
+                if (isCoplanar) {
+                    faceGroups[neighbor] = f;
+                    group.add(neighbor);
+                }
+            }
+        }
+
+        // Compute the boundary edges of the group
+        boundaryStarts.clear();
+        boundaryEnds.clear();
+        for (uint g=0; g < group.size(); g++) {
+            for (uint e=0; e < 3; e++) {
+                if (faceGroups[faces[group[g]].neighbors[e]] != f) {
+                    boundaryStarts.add(faces[group[g]].vertices[e]);
+                    boundaryEnds.add(faces[group[g]].vertices[(e + 1) % 3]);
+                }
+            }
+        }
+
+        // Follow the boundary edges to get the polygon
+        facePoints.clear();
+        bool isSingleLoop = true;
+        uint edge = 0;
+        do {
+            facePoints.add(boundaryStarts[edge]);
+            uint nextEdge = NO_FACE;
+            for (uint b=0; b < boundaryStarts.size(); b++) {
+                if (boundaryStarts[b] == boundaryEnds[edge]) {
+                    isSingleLoop &= nextEdge == NO_FACE;
+                    nextEdge = b;
+                }
+            }
+            isSingleLoop &= nextEdge != NO_FACE && facePoints.size() <= boundaryStarts.size();
+            edge = nextEdge;
+        } while (isSingleLoop && edge != 0);
+        isSingleLoop &= facePoints.size() == boundaryStarts.size();
+
+        if (isSingleLoop) {
+            addPolygonFace(points, facePoints, pointVertices);
+        }
+        else {
+            for (uint g=0; g < group.size(); g++) {
+                facePoints.clear();
+                for (uint v=0; v < 3; v++) {
+                    facePoints.add(faces[group[g]].vertices[v]);
+                }
+                addPolygonFace(points, facePoints, pointVertices);
+            }
+        }
+    }
+}
+
+// Remove the vertices in the middle of an edge between two faces
+/// A point that has been added to the hull can end up on an edge of the final hull once its
+/// triangles have been merged with the coplanar ones. Such a vertex belongs to only two faces
+/// and is aligned with its two neighbors in both of them. It is removed from the faces.
+void ConvexHull::removeEdgeVertices() {
+
+    MemoryAllocator& allocator = MemoryManager::getBaseAllocator();
+
+    // Number of faces of each vertex
+    List<uint> nbVertexFaces(allocator, mVertices.size());
+    for (uint v=0; v < mVertices.size(); v++) {
+        nbVertexFaces.add(0);
+    }
+    for (uint i=0; i < mIndices.size(); i++) {
+        nbVertexFaces[mIndices[i]]++;
+    }
+
+    // A vertex is removed if it is aligned with its neighbors in its two faces
+    List<bool> isVertexRemoved(allocator, mVertices.size());
+    for (uint v=0; v < mVertices.size(); v++) {
+        isVertexRemoved.add(nbVertexFaces[v] == 2);
+    }
+    for (uint f=0; f < mFaces.size(); f++) {
+
+        const uint nbFaceVertices = mFaces[f].nbVertices;
+        const uint* faceIndices = &(mIndices[mFaces[f].indexBase]);
+        for (uint v=0; v < nbFaceVertices; v++) {
+            if (!isVertexRemoved[faceIndices[v]]) continue;
+            const Vector3& previousVertex = mVertices[faceIndices[(v + nbFaceVertices - 1) % nbFaceVertices]];
+            const Vector3 edge = mVertices[faceIndices[(v + 1) % nbFaceVertices]] - previousVertex;
+            const decimal distanceSquare = (mVertices[faceIndices[v]] - previousVertex).cross(edge).lengthSquare() /
+                                           edge.lengthSquare();
+            isVertexRemoved[faceIndices[v]] = distanceSquare <= mTolerance * mTolerance;
+        }
+    }
+
+    // Remove the vertices from the faces (and the vertices that are not used anymore)
+    List<Vector3> vertices(allocator, mVertices.size());
+    List<uint> indices(allocator, mIndices.size());
+    List<int> newVertices(allocator, mVertices.size());
+    for (uint v=0; v < mVertices.size(); v++) {
+        newVertices.add(-1);
+    }
+    for (uint f=0; f < mFaces.size(); f++) {
+
+        const uint indexBase = static_cast<uint>(indices.size());
+        for (uint v=0; v < mFaces[f].nbVertices; v++) {
+
+            const uint vertex = mIndices[mFaces[f].indexBase + v];
+            if (isVertexRemoved[vertex]) continue;
+
+            if (newVertices[vertex] < 0) {
+                newVertices[vertex] = static_cast<int>(vertices.size());
+                vertices.add(mVertices[vertex]);
+            }
+            indices.add(static_cast<uint>(newVertices[vertex]));
+        }
+
+        mFaces[f].indexBase = indexBase;
+        mFaces[f].nbVertices = static_cast<uint>(indices.size()) - indexBase;
+        assert(mFaces[f].nbVertices >= 3);
+    }
+
+    mVertices = std::move(vertices);
+    mIndices = std::move(indices);
+}
+
+// Add a polygon face with the given points
+/// The polygon starts at the vertex with the largest triangle with its two next vertices
+/// because the normal of a face of a PolyhedronMesh is computed with its first three vertices.
+/**
+ * @param points Array with the points
+ * @param facePoints Indices of the points of the polygon (counter-clockwise seen from outside)
+ * @param pointVertices Index of the vertex of the hull of each point (-1 if not a vertex yet)
+ */
+void ConvexHull::addPolygonFace(const Vector3* points, const List<uint>& facePoints, List<int>& pointVertices) {
+
+    const uint nbFacePoints = static_cast<uint>(facePoints.size());
+
+    uint firstPoint = 0;
+    decimal maxAreaSquare = decimal(-1.0);
+    for (uint p=0; p < nbFacePoints; p++) {
+        const Vector3& point = points[facePoints[p]];
+        const decimal areaSquare = (points[facePoints[(p + 1) % nbFacePoints]] - point).cross(
+                                    points[facePoints[(p + 2) % nbFacePoints]] - point).lengthSquare();
+        if (areaSquare > maxAreaSquare) {
+            maxAreaSquare = areaSquare;
+            firstPoint = p;
+        }
+    }
+
+    mFaces.add({nbFacePoints, static_cast<uint>(mIndices.size())});
+    for (uint p=0; p < nbFacePoints; p++) {
+        const uint pointIndex = facePoints[(firstPoint + p) % nbFacePoints];
+        if (pointVertices[pointIndex] < 0) {
+            pointVertices[pointIndex] = static_cast<int>(mVertices.size());
+            mVertices.add(points[pointIndex]);
+        }
+        mIndices.add(static_cast<uint>(pointVertices[pointIndex]));
+    }
+}
+
+// Compute the plane of a triangle of the hull
+void ConvexHull::computeFacePlane(const Vector3* points, HullFace& face) {
+
+    const Vector3& point1 = points[face.vertices[0]];
+    face.normal = (points[face.vertices[1]] - point1).cross(points[face.vertices[2]] - point1);
+    const decimal length = face.normal.length();
+    if (length > MACHINE_EPSILON) face.normal /= length;
+    face.offset = face.normal.dot(point1);
+}
+
+// Return the index of an edge in a triangle given its start vertex
+uint ConvexHull::getEdgeIndex(const HullFace& face, uint startVertex) {
+
+    for (uint e=0; e < 3; e++) {
+        if (face.vertices[e] == startVertex) return e;
+    }
+
+    assert(false);
+    return 0;
+}
@@ -0,0 +1,211 @@
+/********************************************************************************
+* ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
+* Copyright (c) 2010-2018 Daniel Chappuis                                       *
+*********************************************************************************
+*                                                                               *
+* This software is provided 'as-is', without any express or implied warranty.   *
+* In no event will the authors be held liable for any damages arising from the  *
+* use of this software.                                                         *
+*                                                                               *
+* Permission is granted to anyone to use this software for any purpose,         *
+* including commercial applications, and to alter it and redistribute it        *
+* freely, subject to the following restrictions:                                *
+*                                                                               *
+* 1. The origin of this software must not be misrepresented; you must not claim *
+*    that you wrote the original software. If you use this software in a        *
+*    product, an acknowledgment in the product documentation would be           *
+*    appreciated but is not required.                                           *
+*                                                                               *
+* 2. Altered source versions must be plainly marked as such, and must not be    *
+*    misrepresented as being the original software.                             *
+*                                                                               *
+* 3. This notice may not be removed or altered from any source distribution.    *
+*                                                                               *
+********************************************************************************/
+
+#ifndef REACTPHYSICS3D_CONVEX_HULL_H
+#define REACTPHYSICS3D_CONVEX_HULL_H
+
+// Libraries
+#include "mathematics/mathematics.h"
+#include "containers/List.h"
+#include "PolygonVertexArray.h"
+
+namespace reactphysics3d {
+
+// Class ConvexHull
+/**
+ * This class computes the convex hull of a cloud of points with the quickhull algorithm.
+ * The hull is stored as an array of vertices and polygon faces that can be used to create a
+ * PolyhedronMesh (and then a ConvexMeshShape) with the PolygonVertexArray returned by
+ * getPolygonVertexArray(). The triangles of the hull that are coplanar (up to the plane
+ * tolerance) are merged into polygon faces. The number of vertices and faces of the hull can
+ * be limited: the points are added to the hull from the furthest to the closest one and the
+ * algorithm stops when the maximum number of vertices is reached. In this case, the hull does
+ * not contain all the points. The data of the PolygonVertexArray is owned by the ConvexHull
+ * object, which must therefore stay alive as long as the PolyhedronMesh is used.
+ */
+class ConvexHull {
+
+    private:
+
+        /// Triangle of the hull during its construction
+        struct HullFace {
+
+            /// Indices of the three points of the triangle (counter-clockwise seen from outside)
+            uint vertices[3];
+
+            /// Index of the neighbor face across each edge (from vertex i to vertex i+1)
+            uint neighbors[3];
+
+            /// Unit normal of the triangle (pointing outside of the hull)
+            Vector3 normal;
+
+            /// Distance of the plane of the triangle from the origin along the normal
+            decimal offset;
+
+            /// False if the triangle has been removed from the hull
+            bool isValid;
+
+            /// True if the triangle is visible from the point being added to the hull
+            bool isVisible;
+
+            /// Return the signed distance of a point to the plane of the triangle
+            decimal getDistance(const Vector3& point) const {
+                return normal.dot(point) - offset;
+            }
+        };
+
+        /// Edge of the horizon of the visible triangles (edge of a visible triangle)
+        struct HorizonEdge {
+
+            /// Index of the visible triangle
+            uint face;
+
+            /// Index of the edge in the visible triangle
+            uint edge;
+        };
+
+        // -------------------- Attributes -------------------- //
+
+        /// Vertices of the hull
+        List<Vector3> mVertices;
+
+        /// Indices of the vertices of the faces of the hull
+        List<uint> mIndices;
+
+        /// Polygon faces of the hull
+        List<PolygonVertexArray::PolygonFace> mFaces;
+
+        /// Polygon vertex array with the vertices and faces of the hull (null if not valid)
+        PolygonVertexArray* mPolygonVertexArray;
+
+        /// Distance under which a point is considered to be on the plane of a face
+        decimal mTolerance;
+
+        // -------------------- Methods -------------------- //
+
+        /// Compute the hull of the points with a maximum number of vertices
+        bool build(const Vector3* points, uint nbPoints, uint maxNbVertices);
+
+        /// Create the initial tetrahedron of the hull
+        bool createInitialTetrahedron(const Vector3* points, uint nbPoints, List<HullFace>& faces,
+                                      List<bool>& isHullVertex) const;
+
+        /// Compute the ordered edges of the horizon of the triangles visible from a point
+        void computeHorizon(const Vector3& point, List<HullFace>& faces, uint faceIndex, uint crossedEdge,
+                            List<uint>& visibleFaces, List<HorizonEdge>& horizon) const;
+
+        /// Merge the coplanar triangles of the hull into polygons and store the result
+        void createPolygonFaces(const Vector3* points, uint nbPoints, const List<HullFace>& faces);
+
+        /// Remove the vertices in the middle of an edge between two faces
+        void removeEdgeVertices();
+
+        /// Add a polygon face with the given points
+        void addPolygonFace(const Vector3* points, const List<uint>& facePoints, List<int>& pointVertices);
+
+        /// Compute the plane of a triangle of the hull
+        static void computeFacePlane(const Vector3* points, HullFace& face);
+
+        /// Return the index of an edge in a triangle given its start vertex
+        static uint getEdgeIndex(const HullFace& face, uint startVertex);
+
+    public:
+
+        // -------------------- Methods -------------------- //
+
+        /// Constructor
+        ConvexHull(const Vector3* points, uint nbPoints, uint maxNbVertices = 0, uint maxNbFaces = 0,
+                   decimal planeTolerance = decimal(0.0));
+
+        /// Destructor
+        ~ConvexHull();
+
+        /// Deleted copy-constructor
+        ConvexHull(const ConvexHull& hull) = delete;
+
+        /// Deleted assignment operator
+        ConvexHull& operator=(const ConvexHull& hull) = delete;
+
+        /// Return true if the hull has been computed (the points are not all coplanar)
+        bool isValid() const;
+
+        /// Return the number of vertices of the hull
+        uint getNbVertices() const;
+
+        /// Return a vertex of the hull
+        const Vector3& getVertex(uint index) const;
+
+        /// Return the number of faces of the hull
+        uint getNbFaces() const;
+
+        /// Return the polygon vertex array with the vertices and faces of the hull
+        PolygonVertexArray* getPolygonVertexArray() const;
+};
+
+// Return true if the hull has been computed (the points are not all coplanar)
+/**
+ * @return False if there are less than four points that are not coplanar
+ */
+inline bool ConvexHull::isValid() const {
+    return mPolygonVertexArray != nullptr;
+}
+
+// Return the number of vertices of the hull
+/**
+ * @return The number of vertices of the hull
+ */
+inline uint ConvexHull::getNbVertices() const {
+    return static_cast<uint>(mVertices.size());
+}
+
+// Return a vertex of the hull
+/**
+ * @param index Index of the vertex
+ * @return The coordinates of the vertex
+ */
+inline const Vector3& ConvexHull::getVertex(uint index) const {
+    assert(index < mVertices.size());
+    return mVertices[index];
+}
+
+// Return the number of faces of the hull
+/**
+ * @return The number of polygon faces of the hull
+ */
+inline uint ConvexHull::getNbFaces() const {
+    return static_cast<uint>(mFaces.size());
+}
+
+// Return the polygon vertex array with the vertices and faces of the hull
+/**
+ * @return A pointer to the polygon vertex array of the hull (null if the hull is not valid)
+ */
+inline PolygonVertexArray* ConvexHull::getPolygonVertexArray() const {
+    return mPolygonVertexArray;
+}
+
+}
+
+#endif
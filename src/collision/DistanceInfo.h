@@ -0,0 +1,107 @@
+/********************************************************************************
+* ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
+* Copyright (c) 2010-2018 Daniel Chappuis                                       *
+*********************************************************************************
+*                                                                               *
+* This software is provided 'as-is', without any express or implied warranty.   *
+* In no event will the authors be held liable for any damages arising from the  *
+* use of this software.                                                         *
+*                                                                               *
+* Permission is granted to anyone to use this software for any purpose,         *
+* including commercial applications, and to alter it and redistribute it        *
+* freely, subject to the following restrictions:                                *
+*                                                                               *
+* 1. The origin of this software must not be misrepresented; you must not claim *
+*    that you wrote the original software. If you use this software in a        *
+*    product, an acknowledgment in the product documentation would be           *
+*    appreciated but is not required.                                           *
+*                                                                               *
+* 2. Altered source versions must be plainly marked as such, and must not be    *
+*    misrepresented as being the original software.                             *
+*                                                                               *
+* 3. This notice may not be removed or altered from any source distribution.    *
+*                                                                               *
+********************************************************************************/
+
+#ifndef REACTPHYSICS3D_DISTANCE_INFO_H
+#define REACTPHYSICS3D_DISTANCE_INFO_H
+
+// Libraries
+#include "mathematics/Transform.h"
+
+/// ReactPhysics3D namespace
+namespace reactphysics3d {
+
+// Declarations
+class CollisionBody;
+class ProxyShape;
+class ConvexShape;
+
+// Structure DistanceInfo
+/**
+ * This structure contains the result of a distance query between two convex shapes
+ * (see CollisionWorld::computeDistance()) or of a closest point query in the world
+ * (see CollisionWorld::closestPoint()). The distance between the shapes includes their
+ * margins. When the shapes overlap, the distance is zero, the normal is the zero vector
+ * and the two points are the origin of the first shape (or the queried point).
+ */
+struct DistanceInfo {
+
+    // -------------------- Attributes -------------------- //
+
+    /// Closest point on the first shape (or the queried point) in world-space coordinates
+    Vector3 worldPoint1;
+
+    /// Closest point on the second shape (or on the closest proxy shape) in world-space coordinates
+    Vector3 worldPoint2;
+
+    /// Unit direction from the first point to the second one in world-space coordinates
+    Vector3 worldNormal;
+
+    /// Distance between the shapes (the maximum distance of the query if no shape is found)
+    decimal distance = decimal(0.0);
+
+    /// Pointer to the body of the closest proxy shape (only set by the closest point queries)
+    CollisionBody* body = nullptr;
+
+    /// Pointer to the closest proxy shape (only set by the closest point queries)
+    ProxyShape* proxyShape = nullptr;
+
+    // -------------------- Methods -------------------- //
+
+    /// Return true if a closest point query has found a proxy shape
+    bool isHit() const {
+        return proxyShape != nullptr;
+    }
+
+    /// Return true if the shapes overlap
+    bool isOverlapping() const {
+        return distance <= decimal(0.0);
+    }
+};
+
+// Structure DistanceQuery
+/**
+ * This structure describes a pair of convex shapes whose distance is computed by a
+ * batched distance query (see CollisionWorld::computeDistanceBatch()).
+ */
+struct DistanceQuery {
+
+    // -------------------- Attributes -------------------- //
+
+    /// First convex shape
+    const ConvexShape* shape1 = nullptr;
+
+    /// Local-to-world transform of the first shape
+    Transform shape1ToWorldTransform;
+
+    /// Second convex shape
+    const ConvexShape* shape2 = nullptr;
+
+    /// Local-to-world transform of the second shape
+    Transform shape2ToWorldTransform;
+};
+
+}
+
+#endif
@@ -25,94 +25,262 @@
 
 // Libraries
 #include "HalfEdgeStructure.h"
-#include "containers/Map.h"
-#include "containers/Pair.h"
 #include "containers/containers_common.h"
+#include <cstring>
+#include <algorithm>
 
 using namespace reactphysics3d;
 
+// Initialization of static variables
+const uint32 HalfEdgeStructure::SERIALIZED_MAGIC = 0x45485052;    // "RPHE" in little-endian
+const uint32 HalfEdgeStructure::SERIALIZED_VERSION = 1;
+
+// Number of integers in the header of a serialized structure (magic number, version, number of
+// vertices, faces, half-edges and vertices of all the faces)
+static const uint SERIALIZED_HEADER_SIZE = 6;
+
+// Read an integer of a serialized structure
+static uint32 readSerializedInteger(const unsigned char* bytes, size_t index) {
+    uint32 value;
+    std::memcpy(&value, bytes + index * sizeof(uint32), sizeof(uint32));
+    return value;
+}
+
+// Write an integer of a serialized structure
+static void writeSerializedInteger(unsigned char* bytes, size_t index, uint32 value) {
+    std::memcpy(bytes + index * sizeof(uint32), &value, sizeof(uint32));
+}
+
 // Initialize the structure (when all vertices and faces have been added)
+/// The half-edges of the faces are numbered face after face and the twin half-edges are paired
+/// by sorting the half-edges with the key of their undirected edge (the indices of their two
+/// vertices) in flat arrays. The two half-edges of the n-th pair (in the order of the second
+/// half-edge of each pair) are the half-edges 2n and 2n + 1 of the structure.
 void HalfEdgeStructure::init() {
 
-    Map<VerticesPair, Edge> edges(mAllocator);
-    Map<VerticesPair, VerticesPair> nextEdges(mAllocator);
-    Map<VerticesPair, uint> mapEdgeToStartVertex(mAllocator);
-    Map<VerticesPair, uint> mapEdgeToIndex(mAllocator);
-    Map<uint, VerticesPair> mapEdgeIndexToKey(mAllocator);
-    Map<uint, VerticesPair> mapFaceIndexToEdgeKey(mAllocator);
+    // Index of the first half-edge of each face (in the order of the faces)
+    List<uint> facesFirstHalfEdges(mAllocator, mFaces.size() + 1);
+    uint nbHalfEdges = 0;
+    for (uint f=0; f < mFaces.size(); f++) {
+        facesFirstHalfEdges.add(nbHalfEdges);
+        nbHalfEdges += static_cast<uint>(mFaces[f].faceVertices.size());
+    }
+    facesFirstHalfEdges.add(nbHalfEdges);
+
+    // Sort the half-edges by the key of their undirected edge
+    struct HalfEdgeKey {
+        uint64 edgeKey;
+        uint halfEdge;
+        bool operator<(const HalfEdgeKey& key) const {
+            return edgeKey < key.edgeKey || (edgeKey == key.edgeKey && halfEdge < key.halfEdge);
+        }
+    };
+    List<HalfEdgeKey> keys(mAllocator, nbHalfEdges);
+    List<uint> halfEdgesStartVertices(mAllocator, nbHalfEdges);
+    for (uint f=0; f < mFaces.size(); f++) {
+        const SmallList<uint, 8>& faceVertices = mFaces[f].faceVertices;
+        for (uint v=0; v < faceVertices.size(); v++) {
+            const uint v1Index = faceVertices[v];
+            const uint v2Index = faceVertices[v == (faceVertices.size() - 1) ? 0 : v + 1];
+            const uint64 edgeKey = (static_cast<uint64>(std::min(v1Index, v2Index)) << 32) | std::max(v1Index, v2Index);
+            keys.add({edgeKey, facesFirstHalfEdges[f] + v});
+            halfEdgesStartVertices.add(v1Index);
+        }
+    }
+    std::sort(&(keys[0]), &(keys[0]) + nbHalfEdges);
 
-    List<VerticesPair> currentFaceEdges(mAllocator, mFaces[0].faceVertices.size());
+    // Twin of each half-edge (the mesh must be closed)
+    List<uint> twinHalfEdges(mAllocator, nbHalfEdges);
+    for (uint h=0; h < nbHalfEdges; h++) {
+        twinHalfEdges.add(0);
+    }
+    for (uint k=0; k + 1 < nbHalfEdges; k += 2) {
+        assert(keys[k].edgeKey == keys[k + 1].edgeKey);
+        assert(k + 2 >= nbHalfEdges || keys[k + 2].edgeKey != keys[k].edgeKey);
+        twinHalfEdges[keys[k].halfEdge] = keys[k + 1].halfEdge;
+        twinHalfEdges[keys[k + 1].halfEdge] = keys[k].halfEdge;
+    }
 
-    // For each face
-    for (uint f=0; f<mFaces.size(); f++) {
+    // Index of each half-edge in the structure (the pairs are numbered in the order of
+    // their second half-edge)
+    List<uint> edgesIndices(mAllocator, nbHalfEdges);
+    for (uint h=0; h < nbHalfEdges; h++) {
+        edgesIndices.add(0);
+    }
+    uint nbEdges = 0;
+    for (uint h=0; h < nbHalfEdges; h++) {
+        if (twinHalfEdges[h] < h) {
+            edgesIndices[twinHalfEdges[h]] = nbEdges;
+            edgesIndices[h] = nbEdges + 1;
+            mVertices[halfEdgesStartVertices[h]].edgeIndex = nbEdges + 1;
+            mVertices[halfEdgesStartVertices[twinHalfEdges[h]]].edgeIndex = nbEdges;
+            nbEdges += 2;
+        }
+    }
+    assert(nbEdges == nbHalfEdges);
 
-        Face face = mFaces[f];
+    // Create the half-edges
+    mEdges.clear();
+    mEdges.reserve(nbHalfEdges);
+    for (uint e=0; e < nbHalfEdges; e++) {
+        mEdges.add(Edge());
+    }
+    for (uint f=0; f < mFaces.size(); f++) {
 
-        VerticesPair firstEdgeKey(0, 0);
+        const uint firstHalfEdge = facesFirstHalfEdges[f];
+        const uint lastHalfEdge = facesFirstHalfEdges[f + 1] - 1;
+        for (uint h=firstHalfEdge; h <= lastHalfEdge; h++) {
+            Edge& edge = mEdges[edgesIndices[h]];
+            edge.vertexIndex = halfEdgesStartVertices[h];
+            edge.twinEdgeIndex = edgesIndices[twinHalfEdges[h]];
+            edge.faceIndex = f;
+            edge.nextEdgeIndex = edgesIndices[h == lastHalfEdge ? firstHalfEdge : h + 1];
+        }
 
-        // For each vertex of the face
-        for (uint v=0; v < face.faceVertices.size(); v++) {
-            uint v1Index = face.faceVertices[v];
-            uint v2Index = face.faceVertices[v == (face.faceVertices.size() - 1) ? 0 : v + 1];
+        mFaces[f].edgeIndex = edgesIndices[lastHalfEdge];
+    }
+}
 
-            const VerticesPair pairV1V2 = VerticesPair(v1Index, v2Index);
+// Return the size in bytes of the serialized structure
+size_t HalfEdgeStructure::getSerializedSizeInBytes() const {
 
-            // Create a new half-edge
-            Edge edge;
-            edge.faceIndex = f;
-            edge.vertexIndex = v1Index;
-            if (v == 0) {
-                firstEdgeKey = pairV1V2;
-            }
-            else if (v >= 1) {
-                nextEdges.add(Pair<VerticesPair, VerticesPair>(currentFaceEdges[currentFaceEdges.size() - 1], pairV1V2));
-            }
-            if (v == (face.faceVertices.size() - 1)) {
-                nextEdges.add(Pair<VerticesPair, VerticesPair>(pairV1V2, firstEdgeKey));
-            }
-            edges.add(Pair<VerticesPair, Edge>(pairV1V2, edge));
+    size_t nbFacesVertices = 0;
+    for (uint f=0; f < mFaces.size(); f++) {
+        nbFacesVertices += mFaces[f].faceVertices.size();
+    }
+
+    return (SERIALIZED_HEADER_SIZE + 2 * mVertices.size() + 2 * mFaces.size() + nbFacesVertices +
+            4 * mEdges.size()) * sizeof(uint32);
+}
+
+// Write the serialized structure into a buffer
+/// The serialized structure is made of 32-bit integers: a header (magic number, version and
+/// number of vertices, faces, half-edges and vertices of all the faces) followed by the vertices,
+/// the faces (half-edge and number of vertices), the vertices of all the faces and the half-edges.
+/// The buffer must have the size given by getSerializedSizeInBytes().
+void HalfEdgeStructure::serialize(void* buffer) const {
 
-            const VerticesPair pairV2V1(v2Index, v1Index);
+    unsigned char* bytes = static_cast<unsigned char*>(buffer);
+
+    uint32 nbFacesVertices = 0;
+    for (uint f=0; f < mFaces.size(); f++) {
+        nbFacesVertices += mFaces[f].faceVertices.size();
+    }
 
-            mapEdgeToStartVertex.add(Pair<VerticesPair, uint>(pairV1V2, v1Index), true);
-            mapEdgeToStartVertex.add(Pair<VerticesPair, uint>(pairV2V1, v2Index), true);
+    size_t index = 0;
+    writeSerializedInteger(bytes, index++, SERIALIZED_MAGIC);
+    writeSerializedInteger(bytes, index++, SERIALIZED_VERSION);
+    writeSerializedInteger(bytes, index++, mVertices.size());
+    writeSerializedInteger(bytes, index++, mFaces.size());
+    writeSerializedInteger(bytes, index++, mEdges.size());
+    writeSerializedInteger(bytes, index++, nbFacesVertices);
 
-            mapFaceIndexToEdgeKey.add(Pair<uint, VerticesPair>(f, pairV1V2), true);
+    for (uint v=0; v < mVertices.size(); v++) {
+        writeSerializedInteger(bytes, index++, mVertices[v].vertexPointIndex);
+        writeSerializedInteger(bytes, index++, mVertices[v].edgeIndex);
+    }
+
+    for (uint f=0; f < mFaces.size(); f++) {
+        writeSerializedInteger(bytes, index++, mFaces[f].edgeIndex);
+        writeSerializedInteger(bytes, index++, mFaces[f].faceVertices.size());
+    }
+
+    for (uint f=0; f < mFaces.size(); f++) {
+        for (uint v=0; v < mFaces[f].faceVertices.size(); v++) {
+            writeSerializedInteger(bytes, index++, mFaces[f].faceVertices[v]);
+        }
+    }
 
-            auto itEdge = edges.find(pairV2V1);
-            if (itEdge != edges.end()) {
+    for (uint e=0; e < mEdges.size(); e++) {
+        writeSerializedInteger(bytes, index++, mEdges[e].vertexIndex);
+        writeSerializedInteger(bytes, index++, mEdges[e].twinEdgeIndex);
+        writeSerializedInteger(bytes, index++, mEdges[e].faceIndex);
+        writeSerializedInteger(bytes, index++, mEdges[e].nextEdgeIndex);
+    }
+}
 
-                const uint edgeIndex = mEdges.size();
+// Load an empty structure from a serialized structure instead of initializing it
+/// The vertices, faces and half-edges are copied from the serialized structure without the
+/// matching of the half-edges of init(). Return false (and leave the structure empty) if the
+/// data is not a valid serialized structure of this version of the library.
+bool HalfEdgeStructure::loadSerialized(const void* data, size_t sizeInBytes) {
 
-                itEdge->second.twinEdgeIndex = edgeIndex + 1;
-                edge.twinEdgeIndex = edgeIndex;
+    assert(mVertices.size() == 0 && mFaces.size() == 0 && mEdges.size() == 0);
 
-                mapEdgeIndexToKey.add(Pair<uint, VerticesPair>(edgeIndex, pairV2V1));
-                mapEdgeIndexToKey.add(Pair<uint, VerticesPair>(edgeIndex + 1, pairV1V2));
+    if (data == nullptr || sizeInBytes < SERIALIZED_HEADER_SIZE * sizeof(uint32)) return false;
 
-                mVertices[v1Index].edgeIndex = edgeIndex + 1;
-                mVertices[v2Index].edgeIndex = edgeIndex;
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    if (readSerializedInteger(bytes, 0) != SERIALIZED_MAGIC ||
+        readSerializedInteger(bytes, 1) != SERIALIZED_VERSION) {
+        return false;
+    }
 
-                mapEdgeToIndex.add(Pair<VerticesPair, uint>(pairV1V2, edgeIndex + 1));
-                mapEdgeToIndex.add(Pair<VerticesPair, uint>(pairV2V1, edgeIndex));
+    const size_t nbVertices = readSerializedInteger(bytes, 2);
+    const size_t nbFaces = readSerializedInteger(bytes, 3);
+    const size_t nbEdges = readSerializedInteger(bytes, 4);
+    const size_t nbFacesVertices = readSerializedInteger(bytes, 5);
+    if (sizeInBytes != (SERIALIZED_HEADER_SIZE + 2 * nbVertices + 2 * nbFaces + nbFacesVertices +
+                        4 * nbEdges) * sizeof(uint32)) {
+        return false;
+    }
 
-                mEdges.add(itEdge->second);
-                mEdges.add(edge);
-            }
+    const size_t verticesIndex = SERIALIZED_HEADER_SIZE;
+    const size_t facesIndex = verticesIndex + 2 * nbVertices;
+    const size_t facesVerticesIndex = facesIndex + 2 * nbFaces;
+    const size_t edgesIndex = facesVerticesIndex + nbFacesVertices;
 
-            currentFaceEdges.add(pairV1V2);
+    // Check that all the indices are valid before creating the structure
+    size_t nbCheckedFacesVertices = 0;
+    for (size_t v=0; v < nbVertices; v++) {
+        if (readSerializedInteger(bytes, verticesIndex + 2 * v + 1) >= nbEdges) return false;
+    }
+    for (size_t f=0; f < nbFaces; f++) {
+        const uint32 nbFaceVertices = readSerializedInteger(bytes, facesIndex + 2 * f + 1);
+        if (readSerializedInteger(bytes, facesIndex + 2 * f) >= nbEdges || nbFaceVertices < 3) return false;
+        nbCheckedFacesVertices += nbFaceVertices;
+    }
+    if (nbCheckedFacesVertices != nbFacesVertices) return false;
+    for (size_t i=0; i < nbFacesVertices; i++) {
+        if (readSerializedInteger(bytes, facesVerticesIndex + i) >= nbVertices) return false;
+    }
+    for (size_t e=0; e < nbEdges; e++) {
+        if (readSerializedInteger(bytes, edgesIndex + 4 * e) >= nbVertices ||
+            readSerializedInteger(bytes, edgesIndex + 4 * e + 1) >= nbEdges ||
+            readSerializedInteger(bytes, edgesIndex + 4 * e + 2) >= nbFaces ||
+            readSerializedInteger(bytes, edgesIndex + 4 * e + 3) >= nbEdges) {
+            return false;
         }
+    }
 
-        currentFaceEdges.clear();
+    mVertices.reserve(nbVertices);
+    for (size_t v=0; v < nbVertices; v++) {
+        Vertex vertex(readSerializedInteger(bytes, verticesIndex + 2 * v));
+        vertex.edgeIndex = readSerializedInteger(bytes, verticesIndex + 2 * v + 1);
+        mVertices.add(vertex);
     }
 
-    // Set next edges
-    for (uint i=0; i < mEdges.size(); i++) {
-        mEdges[i].nextEdgeIndex = mapEdgeToIndex[nextEdges[mapEdgeIndexToKey[i]]];
+    mFaces.reserve(nbFaces);
+    size_t faceVertexIndex = facesVerticesIndex;
+    for (size_t f=0; f < nbFaces; f++) {
+        const uint32 nbFaceVertices = readSerializedInteger(bytes, facesIndex + 2 * f + 1);
+        Face face(mAllocator);
+        face.edgeIndex = readSerializedInteger(bytes, facesIndex + 2 * f);
+        face.faceVertices.reserve(nbFaceVertices);
+        for (uint32 v=0; v < nbFaceVertices; v++) {
+            face.faceVertices.add(readSerializedInteger(bytes, faceVertexIndex++));
+        }
+        mFaces.add(std::move(face));
     }
 
-    // Set face edge
-    for (uint f=0; f < mFaces.size(); f++) {
-        mFaces[f].edgeIndex = mapEdgeToIndex[mapFaceIndexToEdgeKey[f]];
+    mEdges.reserve(nbEdges);
+    for (size_t e=0; e < nbEdges; e++) {
+        Edge edge;
+        edge.vertexIndex = readSerializedInteger(bytes, edgesIndex + 4 * e);
+        edge.twinEdgeIndex = readSerializedInteger(bytes, edgesIndex + 4 * e + 1);
+        edge.faceIndex = readSerializedInteger(bytes, edgesIndex + 4 * e + 2);
+        edge.nextEdgeIndex = readSerializedInteger(bytes, edgesIndex + 4 * e + 3);
+        mEdges.add(edge);
     }
+
+    return true;
 }
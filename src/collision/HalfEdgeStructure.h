@@ -28,6 +28,7 @@
 
 // Libraries
 #include "mathematics/mathematics.h"
+#include "containers/SmallList.h"
 
 namespace reactphysics3d {
 
@@ -54,13 +55,10 @@ class HalfEdgeStructure {
         /// Face
         struct Face {
             uint edgeIndex;             // Index of an half-edge of the face
-            List<uint> faceVertices;	// Index of the vertices of the face
+            SmallList<uint, 8> faceVertices;	// Index of the vertices of the face
 
             /// Constructor
             Face(MemoryAllocator& allocator) : faceVertices(allocator) {}
-
-            /// Constructor
-            Face(List<uint> vertices) : faceVertices(vertices) {}
         };
 
         /// Vertex
@@ -74,6 +72,16 @@ class HalfEdgeStructure {
 
     private:
 
+        // -------------------- Constants -------------------- //
+
+        /// Magic number at the beginning of a serialized structure
+        static const uint32 SERIALIZED_MAGIC;
+
+        /// Version of the format of a serialized structure
+        static const uint32 SERIALIZED_VERSION;
+
+        // -------------------- Attributes -------------------- //
+
         /// Reference to a memory allocator
         MemoryAllocator& mAllocator;
 
@@ -103,7 +111,7 @@ class HalfEdgeStructure {
         uint addVertex(uint vertexPointIndex);
 
         /// Add a face
-        void addFace(List<uint> faceVertices);
+        void addFace(const List<uint>& faceVertices);
 
         /// Return the number of faces
         uint getNbFaces() const;
@@ -123,6 +131,15 @@ class HalfEdgeStructure {
         /// Return a given vertex
         const Vertex& getVertex(uint index) const;
 
+        /// Return the size in bytes of the serialized structure
+        size_t getSerializedSizeInBytes() const;
+
+        /// Write the serialized structure into a buffer
+        void serialize(void* buffer) const;
+
+        /// Load an empty structure from a serialized structure instead of initializing it
+        bool loadSerialized(const void* data, size_t sizeInBytes);
+
 };
 
 // Add a vertex
@@ -140,11 +157,12 @@ inline uint HalfEdgeStructure::addVertex(uint vertexPointIndex) {
  * @param faceVertices List of the vertices in a face (ordered in CCW order as seen from outside
  *                     the polyhedron
  */
-inline void HalfEdgeStructure::addFace(List<uint> faceVertices) {
+inline void HalfEdgeStructure::addFace(const List<uint>& faceVertices) {
 
     // Create a new face
-    Face face(faceVertices);
-    mFaces.add(face);
+    Face face(mAllocator);
+    face.faceVertices.addRange(faceVertices);
+    mFaces.add(std::move(face));
 }
 
 // Return the number of faces
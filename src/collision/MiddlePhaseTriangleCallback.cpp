@@ -28,36 +28,199 @@
 #include "engine/OverlappingPair.h"
 #include "collision/NarrowPhaseInfo.h"
 #include "collision/shapes/TriangleShape.h"
+#include "collision/shapes/ConcaveMeshShape.h"
+#include "collision/shapes/AABB.h"
+#include <cstddef>
+#include <cmath>
+#include <algorithm>
 
 using namespace reactphysics3d;
 
+// Constructor
+MiddlePhaseTriangleCallback::MiddlePhaseTriangleCallback(OverlappingPair* overlappingPair,
+                                                         ProxyShape* concaveProxyShape,
+                                                         ProxyShape* convexProxyShape, const ConcaveShape* concaveShape,
+                                                         MemoryAllocator& allocator, MiddlePhaseTriangleBatch& triangles)
+    : MiddlePhaseTriangleCallback(overlappingPair, concaveProxyShape->getLocalToWorldTransform(),
+                                  convexProxyShape->getCollisionShape(), convexProxyShape->getLocalToWorldTransform(),
+                                  convexProxyShape->getCollisionShape()->getId(),
+                                  overlappingPair->getShape1() == convexProxyShape, concaveShape, allocator, triangles) {
+
+}
+
 // Report collision between a triangle of a concave shape and the convex mesh shape (for middle-phase)
+/// The triangle is only stored into the triangle batch. Its narrow-phase info is created
+/// later by the createNarrowPhaseInfos() method.
 void MiddlePhaseTriangleCallback::testTriangle(const Vector3* trianglePoints, const Vector3* verticesNormals, uint shapeId) {
 
-    // Create a triangle collision shape (the allocated memory for the TriangleShape will be released in the
-	// destructor of the corresponding NarrowPhaseInfo.
-    TriangleShape* triangleShape = new (mAllocator.allocate(sizeof(TriangleShape)))
-                                   TriangleShape(trianglePoints, verticesNormals, shapeId, mAllocator);
+    for (uint i=0; i < 3; i++) {
+        mTriangles.vertices.add(trianglePoints[i]);
+        mTriangles.verticesNormals.add(verticesNormals[i]);
+    }
+    mTriangles.shapeIds.add(shapeId);
+}
+
+// Remove the reported triangles that are separated from the AABB of the convex shape
+/// The AABB of the convex shape is in the local-space of the concave shape (like the triangles).
+/// A triangle is separated from the AABB if the AABB is entirely on one side of the plane of
+/// the triangle or if the AABB of the triangle does not overlap it (the first four separating
+/// axes of the triangle/box SAT test). The triangles are tested by groups of NB_CULLING_LANES
+/// triangles with a kernel without branches that the compiler can turn into SIMD instructions.
+/// The remaining triangles keep their order.
+uint MiddlePhaseTriangleCallback::cullSeparatedTriangles(const AABB& convexShapeAABB) {
+
+    const Vector3 aabbCenter = convexShapeAABB.getCenter();
+    const Vector3 aabbHalfExtents = convexShapeAABB.getExtent() * decimal(0.5);
+
+    TriangleCullingLanes lanes;
+    const uint nbTriangles = mTriangles.getNbTriangles();
+    uint nbKeptTriangles = 0;
+
+    for (uint startIndex=0; startIndex < nbTriangles; startIndex += NB_CULLING_LANES) {
+
+        const uint nbRemainingTriangles = nbTriangles - startIndex;
+        const uint nbLanes = nbRemainingTriangles < NB_CULLING_LANES ? nbRemainingTriangles : NB_CULLING_LANES;
+
+        // Copy the vertices of the group of triangles into the lanes
+        for (uint l=0; l < NB_CULLING_LANES; l++) {
+            for (uint v=0; v < 3; v++) {
+                const Vector3 vertex = l < nbLanes ? mTriangles.vertices[3 * (startIndex + l) + v] : Vector3::zero();
+                for (int k=0; k < 3; k++) {
+                    lanes.vertices[v][k][l] = vertex[k];
+                }
+            }
+        }
+
+        computeSeparatedTrianglesLanes(lanes, aabbCenter, aabbHalfExtents);
+
+        // Move the triangles that are not separated at the end of the kept triangles
+        for (uint l=0; l < nbLanes; l++) {
+
+            if (lanes.isSeparated[l]) continue;
+
+            const uint triangleIndex = startIndex + l;
+            if (triangleIndex != nbKeptTriangles) {
+                for (uint v=0; v < 3; v++) {
+                    mTriangles.vertices[3 * nbKeptTriangles + v] = mTriangles.vertices[3 * triangleIndex + v];
+                    mTriangles.verticesNormals[3 * nbKeptTriangles + v] = mTriangles.verticesNormals[3 * triangleIndex + v];
+                }
+                mTriangles.shapeIds[nbKeptTriangles] = mTriangles.shapeIds[triangleIndex];
+            }
+            nbKeptTriangles++;
+        }
+    }
+
+    mTriangles.truncate(nbKeptTriangles);
+
+    return nbTriangles - nbKeptTriangles;
+}
+
+// Compute which triangles of all the lanes are separated from an AABB
+void MiddlePhaseTriangleCallback::computeSeparatedTrianglesLanes(TriangleCullingLanes& lanes, const Vector3& aabbCenter,
+                                                                 const Vector3& aabbHalfExtents) {
+
+    for (uint l=0; l < NB_CULLING_LANES; l++) {
+
+        // Edges of the triangle relative to the first vertex
+        const decimal edge1X = lanes.vertices[1][0][l] - lanes.vertices[0][0][l];
+        const decimal edge1Y = lanes.vertices[1][1][l] - lanes.vertices[0][1][l];
+        const decimal edge1Z = lanes.vertices[1][2][l] - lanes.vertices[0][2][l];
+        const decimal edge2X = lanes.vertices[2][0][l] - lanes.vertices[0][0][l];
+        const decimal edge2Y = lanes.vertices[2][1][l] - lanes.vertices[0][1][l];
+        const decimal edge2Z = lanes.vertices[2][2][l] - lanes.vertices[0][2][l];
+
+        // Normal of the triangle (not normalized, zero for a degenerate triangle)
+        const decimal normalX = edge1Y * edge2Z - edge1Z * edge2Y;
+        const decimal normalY = edge1Z * edge2X - edge1X * edge2Z;
+        const decimal normalZ = edge1X * edge2Y - edge1Y * edge2X;
+
+        // Distance of the AABB center to the plane of the triangle and projected radius of
+        // the AABB on the normal (both multiplied by the length of the normal)
+        const decimal distance = normalX * (aabbCenter.x - lanes.vertices[0][0][l]) +
+                                 normalY * (aabbCenter.y - lanes.vertices[0][1][l]) +
+                                 normalZ * (aabbCenter.z - lanes.vertices[0][2][l]);
+        const decimal radius = std::abs(normalX) * aabbHalfExtents.x + std::abs(normalY) * aabbHalfExtents.y +
+                               std::abs(normalZ) * aabbHalfExtents.z;
+        bool isSeparated = std::abs(distance) > radius;
+
+        // Test the overlap of the AABB of the triangle with the AABB
+        for (int k=0; k < 3; k++) {
+            const decimal triangleMin = std::min(std::min(lanes.vertices[0][k][l], lanes.vertices[1][k][l]), lanes.vertices[2][k][l]);
+            const decimal triangleMax = std::max(std::max(lanes.vertices[0][k][l], lanes.vertices[1][k][l]), lanes.vertices[2][k][l]);
+            isSeparated = isSeparated | (triangleMin > aabbCenter[k] + aabbHalfExtents[k]) |
+                                        (triangleMax < aabbCenter[k] - aabbHalfExtents[k]);
+        }
+
+        lanes.isSeparated[l] = isSeparated;
+    }
+}
+
+// Create the narrow-phase infos of all the reported triangles
+/// The triangle shapes and the narrow-phase infos of all the triangles are created in a
+/// single memory block (see NarrowPhaseInfoBlock) instead of one allocation per object.
+/// The block is released when its last narrow-phase info is destroyed.
+NarrowPhaseInfo* MiddlePhaseTriangleCallback::createNarrowPhaseInfos() {
+
+    const uint nbTriangles = mTriangles.getNbTriangles();
+    if (nbTriangles == 0) return nullptr;
+
+    // The block contains the header, then the triangle shapes and then the narrow-phase infos
+    static_assert(alignof(TriangleShape) <= alignof(std::max_align_t) &&
+                  alignof(NarrowPhaseInfo) <= alignof(TriangleShape),
+                  "The triangle shapes and the narrow-phase infos must be aligned in the block");
+    const size_t headerSize = ((sizeof(NarrowPhaseInfoBlock) + alignof(std::max_align_t) - 1) /
+                               alignof(std::max_align_t)) * alignof(std::max_align_t);
+    const size_t sizeBytes = headerSize + nbTriangles * (sizeof(TriangleShape) + sizeof(NarrowPhaseInfo));
+    char* memory = static_cast<char*>(mAllocator.allocate(sizeBytes));
+
+    NarrowPhaseInfoBlock* block = new (memory) NarrowPhaseInfoBlock();
+    block->sizeBytes = sizeBytes;
+    block->nbRemainingInfos = nbTriangles;
+    TriangleShape* triangleShapes = reinterpret_cast<TriangleShape*>(memory + headerSize);
+    NarrowPhaseInfo* narrowPhaseInfos = reinterpret_cast<NarrowPhaseInfo*>(memory + headerSize +
+                                                                           nbTriangles * sizeof(TriangleShape));
+
+    const Transform& shape1ToWorldTransform = mIsShape1Convex ? mConvexToWorldTransform : mConcaveToWorldTransform;
+    const Transform& shape2ToWorldTransform = mIsShape1Convex ? mConcaveToWorldTransform : mConvexToWorldTransform;
+
+    // The convexity of the edges of the triangles of a concave mesh is precomputed by its triangle mesh
+    const ConcaveMeshShape* concaveMeshShape = mConcaveShape->getName() == CollisionShapeName::TRIANGLE_MESH ?
+                                               static_cast<const ConcaveMeshShape*>(mConcaveShape) : nullptr;
+
+    // The narrow-phase infos are linked in the reverse order of the triangles
+    NarrowPhaseInfo* narrowPhaseInfoList = nullptr;
+    for (uint i=0; i < nbTriangles; i++) {
+
+        // Create a triangle collision shape
+        TriangleShape* triangleShape = new (triangleShapes + i)
+                                       TriangleShape(&(mTriangles.vertices[3 * i]),
+                                                     &(mTriangles.verticesNormals[3 * i]),
+                                                     mTriangles.shapeIds[i]);
+        if (concaveMeshShape != nullptr) {
+            triangleShape->mEdgesConvexity = concaveMeshShape->getTriangleEdgesConvexity(mTriangles.shapeIds[i]);
+        }
 
 #ifdef IS_PROFILING_ACTIVE
 
-	// Set the profiler to the triangle shape
-	triangleShape->setProfiler(mProfiler);
+        // Set the profiler to the triangle shape
+        triangleShape->setProfiler(mProfiler);
 
 #endif
 
-    bool isShape1Convex = mOverlappingPair->getShape1()->getCollisionShape()->isConvex();
-    ProxyShape* shape1 = isShape1Convex ? mConvexProxyShape : mConcaveProxyShape;
-    ProxyShape* shape2 = isShape1Convex ? mConcaveProxyShape : mConvexProxyShape;
-
-    // Create a narrow phase info for the narrow-phase collision detection
-    NarrowPhaseInfo* firstNarrowPhaseInfo = narrowPhaseInfoList;
-    narrowPhaseInfoList = new (mAllocator.allocate(sizeof(NarrowPhaseInfo)))
-                           NarrowPhaseInfo(mOverlappingPair,
-                           isShape1Convex ? mConvexProxyShape->getCollisionShape() : triangleShape,
-                           isShape1Convex ? triangleShape : mConvexProxyShape->getCollisionShape(),
-                           shape1->getLocalToWorldTransform(),
-                           shape2->getLocalToWorldTransform(),
-                           mAllocator);
-    narrowPhaseInfoList->next = firstNarrowPhaseInfo;
+        // Create a narrow phase info for the narrow-phase collision detection
+        NarrowPhaseInfo* narrowPhaseInfo = new (narrowPhaseInfos + i)
+                               NarrowPhaseInfo(mOverlappingPair,
+                               mIsShape1Convex ? mConvexShape : triangleShape,
+                               mIsShape1Convex ? triangleShape : mConvexShape,
+                               shape1ToWorldTransform, shape2ToWorldTransform,
+                               mIsShape1Convex ? mConvexShapeId : triangleShape->getId(),
+                               mIsShape1Convex ? triangleShape->getId() : mConvexShapeId, mAllocator);
+        narrowPhaseInfo->block = block;
+        narrowPhaseInfo->next = narrowPhaseInfoList;
+        narrowPhaseInfoList = narrowPhaseInfo;
+    }
+
+    mTriangles.clear();
+
+    return narrowPhaseInfoList;
 }
@@ -28,6 +28,7 @@
 
 #include "configuration.h"
 #include "collision/shapes/ConcaveShape.h"
+#include "containers/List.h"
 
 /// Namespace ReactPhysics3D
 namespace reactphysics3d {
@@ -44,31 +45,113 @@ class Profiler;
 struct NarrowPhaseInfo;
 struct Vector3;
 
+// Structure MiddlePhaseTriangleBatch
+/**
+ * This structure contains the triangles of a concave shape that overlap a convex
+ * shape during the middle-phase. The vertices, the vertices normals and the ids of the
+ * triangles are stored in flat arrays (three vertices and normals per triangle). The
+ * arrays are reused for all the pairs so that no memory is allocated while the triangles
+ * of a concave shape are reported.
+ */
+struct MiddlePhaseTriangleBatch {
+
+    /// Vertices of the triangles (in the local-space of the concave shape)
+    List<Vector3> vertices;
+
+    /// Vertices normals of the triangles
+    List<Vector3> verticesNormals;
+
+    /// Ids of the triangles
+    List<uint> shapeIds;
+
+    /// Constructor
+    MiddlePhaseTriangleBatch(MemoryAllocator& allocator)
+        : vertices(allocator), verticesNormals(allocator), shapeIds(allocator) {
+
+    }
+
+    /// Return the number of triangles of the batch
+    uint getNbTriangles() const {
+        return shapeIds.size();
+    }
+
+    /// Remove all the triangles of the batch (the memory of the arrays is kept)
+    void clear() {
+        vertices.clear();
+        verticesNormals.clear();
+        shapeIds.clear();
+    }
+
+    /// Remove the last triangles of the batch to keep only a given number of triangles
+    void truncate(uint nbTriangles) {
+        while (shapeIds.size() > nbTriangles) {
+            shapeIds.removeAt(shapeIds.size() - 1);
+        }
+        while (vertices.size() > 3 * nbTriangles) {
+            vertices.removeAt(vertices.size() - 1);
+            verticesNormals.removeAt(verticesNormals.size() - 1);
+        }
+    }
+};
+
 // Class ConvexVsTriangleCallback
 /**
  * This class is used to report a collision between the triangle
  * of a concave mesh shape and a convex shape during the
- * middle-phase algorithm.
+ * middle-phase algorithm. The triangles are stored into a triangle batch
+ * and the narrow-phase infos of all of them are created at once afterwards.
  */
 class MiddlePhaseTriangleCallback : public TriangleCallback {
 
     protected:
 
+        // -------------------- Constants -------------------- //
+
+        /// Number of triangles tested together by the culling kernel
+        static const uint NB_CULLING_LANES = 4;
+
+        // Structure TriangleCullingLanes
+        /**
+         * Triangles tested together against the AABB of the convex shape by the culling
+         * kernel (one triangle per lane) in a structure of arrays. The unused lanes are
+         * filled with zeros.
+         */
+        struct TriangleCullingLanes {
+
+            /// Coordinates of the three vertices of the triangles
+            decimal vertices[3][3][NB_CULLING_LANES];
+
+            /// Output: true if the triangle is separated from the AABB
+            bool isSeparated[NB_CULLING_LANES];
+        };
+
         /// Broadphase overlapping pair
         OverlappingPair* mOverlappingPair;
 
-        /// Pointer to the concave proxy shape
-        ProxyShape* mConcaveProxyShape;
+        /// Transform from the local-space of the concave shape to world-space
+        Transform mConcaveToWorldTransform;
+
+        /// Pointer to the convex collision shape
+        CollisionShape* mConvexShape;
+
+        /// Transform from the local-space of the convex shape to world-space
+        Transform mConvexToWorldTransform;
 
-        /// Pointer to the convex proxy shape
-        ProxyShape* mConvexProxyShape;
+        /// Id of the convex shape in the last frame collision infos of the pair
+        uint mConvexShapeId;
+
+        /// True if the convex shape is the first shape of the narrow-phase infos
+        bool mIsShape1Convex;
 
         /// Pointer to the concave collision shape
         const ConcaveShape* mConcaveShape;
 
-        /// Reference to the single-frame memory allocator
+        /// Reference to the memory allocator of the narrow-phase infos
         MemoryAllocator& mAllocator;
 
+        /// Batch where the reported triangles are stored
+        MiddlePhaseTriangleBatch& mTriangles;
+
 #ifdef IS_PROFILING_ACTIVE
 
 		/// Pointer to the profiler
@@ -76,25 +159,42 @@ class MiddlePhaseTriangleCallback : public TriangleCallback {
 
 #endif
 
-    public:
+        /// Compute which triangles of all the lanes are separated from an AABB
+        static void computeSeparatedTrianglesLanes(TriangleCullingLanes& lanes, const Vector3& aabbCenter,
+                                                   const Vector3& aabbHalfExtents);
 
-        /// Pointer to the first element of the linked-list of narrow-phase info
-        NarrowPhaseInfo* narrowPhaseInfoList;
+    public:
 
         /// Constructor
         MiddlePhaseTriangleCallback(OverlappingPair* overlappingPair,
                                     ProxyShape* concaveProxyShape,
                                     ProxyShape* convexProxyShape, const ConcaveShape* concaveShape,
-                                    MemoryAllocator& allocator)
-            :mOverlappingPair(overlappingPair), mConcaveProxyShape(concaveProxyShape),
-             mConvexProxyShape(convexProxyShape), mConcaveShape(concaveShape),
-             mAllocator(allocator), narrowPhaseInfoList(nullptr) {
-
+                                    MemoryAllocator& allocator, MiddlePhaseTriangleBatch& triangles);
+
+        /// Constructor with a convex shape that is not the collision shape of a proxy shape
+        MiddlePhaseTriangleCallback(OverlappingPair* overlappingPair, const Transform& concaveToWorldTransform,
+                                    CollisionShape* convexShape, const Transform& convexToWorldTransform,
+                                    uint convexShapeId, bool isShape1Convex, const ConcaveShape* concaveShape,
+                                    MemoryAllocator& allocator, MiddlePhaseTriangleBatch& triangles)
+            :mOverlappingPair(overlappingPair), mConcaveToWorldTransform(concaveToWorldTransform),
+             mConvexShape(convexShape), mConvexToWorldTransform(convexToWorldTransform),
+             mConvexShapeId(convexShapeId), mIsShape1Convex(isShape1Convex), mConcaveShape(concaveShape),
+             mAllocator(allocator), mTriangles(triangles) {
+
+            mTriangles.clear();
         }
 
         /// Test collision between a triangle and the convex mesh shape
         virtual void testTriangle(const Vector3* trianglePoints, const Vector3* verticesNormals, uint shapeId) override;
 
+        /// Remove the reported triangles that are separated from the AABB of the convex shape
+        /// and return the number of removed triangles
+        uint cullSeparatedTriangles(const AABB& convexShapeAABB);
+
+        /// Create the narrow-phase infos of all the reported triangles and return the
+        /// first element of their linked-list
+        NarrowPhaseInfo* createNarrowPhaseInfos();
+
 #ifdef IS_PROFILING_ACTIVE
 
 		/// Set the profiler
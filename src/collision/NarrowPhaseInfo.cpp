@@ -34,13 +34,45 @@ using namespace reactphysics3d;
 // Constructor
 NarrowPhaseInfo::NarrowPhaseInfo(OverlappingPair* pair, CollisionShape* shape1,
                 CollisionShape* shape2, const Transform& shape1Transform,
-                const Transform& shape2Transform, MemoryAllocator& shapeAllocator)
-      : overlappingPair(pair), collisionShape1(shape1), collisionShape2(shape2),
+                const Transform& shape2Transform, MemoryAllocator& allocator)
+      : NarrowPhaseInfo(pair, shape1, shape2, shape1Transform, shape2Transform, shape1->getId(),
+                        shape2->getId(), allocator) {
+
+}
+
+// Constructor with the ids of the shapes in the last frame collision infos of the pair
+/// The ids of the shapes identify the last frame collision info of the two shapes in the
+/// overlapping pair. They are different from the ids of the collision shapes when the shapes
+/// are the children of a compound shape (the ids are then the indices of the children).
+NarrowPhaseInfo::NarrowPhaseInfo(OverlappingPair* pair, CollisionShape* shape1,
+                CollisionShape* shape2, const Transform& shape1Transform,
+                const Transform& shape2Transform, uint shape1Id, uint shape2Id,
+                MemoryAllocator& allocator)
+      : overlappingPair(pair), lastFrameCollisionInfo(nullptr), collisionShape1(shape1), collisionShape2(shape2),
         shape1ToWorldTransform(shape1Transform), shape2ToWorldTransform(shape2Transform),
-        contactPoints(nullptr), next(nullptr), collisionShapeAllocator(shapeAllocator) {
+        shape1Id(shape1Id), shape2Id(shape2Id),
+        contactPoints(nullptr), next(nullptr), allocator(allocator), block(nullptr),
+        contactPointsAllocator(&pair->getTemporaryAllocator()), nbGJKTests(0), nbGJKIterations(0),
+        nbGJKWarmStarts(0), pairCostIndex(0), narrowPhaseTicks(0) {
 
     // Add a collision info for the two collision shapes into the overlapping pair (if not present yet)
-    overlappingPair->addLastFrameInfoIfNecessary(shape1->getId(), shape2->getId());
+    overlappingPair->addLastFrameInfoIfNecessary(shape1Id, shape2Id);
+}
+
+// Constructor without overlapping pair
+/// The narrow-phase info can then be created on the stack by a query that tests two shapes
+/// once. The narrow-phase algorithms use the given last frame collision info and the contact
+/// points are allocated with the allocator of the narrow-phase info.
+NarrowPhaseInfo::NarrowPhaseInfo(CollisionShape* shape1, CollisionShape* shape2, const Transform& shape1Transform,
+                                 const Transform& shape2Transform, LastFrameCollisionInfo* lastFrameInfo,
+                                 MemoryAllocator& allocator)
+      : overlappingPair(nullptr), lastFrameCollisionInfo(lastFrameInfo), collisionShape1(shape1),
+        collisionShape2(shape2), shape1ToWorldTransform(shape1Transform), shape2ToWorldTransform(shape2Transform),
+        shape1Id(shape1->getId()), shape2Id(shape2->getId()), contactPoints(nullptr), next(nullptr),
+        allocator(allocator), block(nullptr), contactPointsAllocator(&allocator), nbGJKTests(0),
+        nbGJKIterations(0), nbGJKWarmStarts(0), pairCostIndex(0), narrowPhaseTicks(0) {
+
+    assert(lastFrameInfo != nullptr);
 }
 
 // Destructor
@@ -48,30 +80,88 @@ NarrowPhaseInfo::~NarrowPhaseInfo() {
 
     assert(contactPoints == nullptr);
 
-	// Release the memory of the TriangleShape (this memory was allocated in the
-	// MiddlePhaseTriangleCallback::testTriangle() method)
-	if (collisionShape1->getName() == CollisionShapeName::TRIANGLE) {
-        collisionShape1->~CollisionShape();
-		collisionShapeAllocator.release(collisionShape1, sizeof(TriangleShape));
-	}
-	if (collisionShape2->getName() == CollisionShapeName::TRIANGLE) {
-        collisionShape2->~CollisionShape();
-        collisionShapeAllocator.release(collisionShape2, sizeof(TriangleShape));
+    // Destroy the TriangleShape (its memory is part of the block created in the
+    // MiddlePhaseTriangleCallback::createNarrowPhaseInfos() method)
+    if (block != nullptr) {
+        if (collisionShape1->getName() == CollisionShapeName::TRIANGLE) {
+            collisionShape1->~CollisionShape();
+        }
+        if (collisionShape2->getName() == CollisionShapeName::TRIANGLE) {
+            collisionShape2->~CollisionShape();
+        }
+    }
+}
+
+// Destroy a narrow-phase info and release its memory
+/// The memory block of the triangles of a concave shape is released with its last
+/// narrow-phase info.
+void NarrowPhaseInfo::destroy(NarrowPhaseInfo* narrowPhaseInfo) {
+
+    MemoryAllocator& allocator = narrowPhaseInfo->allocator;
+    NarrowPhaseInfoBlock* block = narrowPhaseInfo->block;
+
+    // Call the destructor
+    narrowPhaseInfo->~NarrowPhaseInfo();
+
+    // Release the allocated memory
+    if (block == nullptr) {
+        allocator.release(narrowPhaseInfo, sizeof(NarrowPhaseInfo));
+    }
+    else {
+        assert(block->nbRemainingInfos > 0);
+        block->nbRemainingInfos--;
+        if (block->nbRemainingInfos == 0) {
+            allocator.release(block, block->sizeBytes);
+        }
     }
 }
 
 // Add a new contact point
+/**
+ * @param contactNormal Normal of the contact in world-space
+ * @param penDepth Penetration depth of the contact
+ * @param localPt1 Contact point on the first shape (in local-space of the shape)
+ * @param localPt2 Contact point on the second shape (in local-space of the shape)
+ * @param featureId Identifier of the features of the shapes that generated the contact (zero if unknown)
+ */
 void NarrowPhaseInfo::addContactPoint(const Vector3& contactNormal, decimal penDepth,
-                     const Vector3& localPt1, const Vector3& localPt2) {
+                     const Vector3& localPt1, const Vector3& localPt2, uint32 featureId) {
 
     assert(penDepth > decimal(0.0));
 
     // Get the memory allocator
-    MemoryAllocator& allocator = overlappingPair->getTemporaryAllocator();
+    MemoryAllocator& allocator = *contactPointsAllocator;
 
     // Create the contact point info
     ContactPointInfo* contactPointInfo = new (allocator.allocate(sizeof(ContactPointInfo)))
-            ContactPointInfo(contactNormal, penDepth, localPt1, localPt2);
+            ContactPointInfo(contactNormal, penDepth, localPt1, localPt2, featureId);
+
+    // Add it into the linked list of contact points
+    contactPointInfo->next = contactPoints;
+    contactPoints = contactPointInfo;
+}
+
+// Add a new speculative contact point between two shapes that are not touching yet
+/// The contact point is stored with a negative penetration depth (minus the distance
+/// between the shapes) so that the contact solver only prevents the shapes from
+/// closing the gap during the next step.
+/**
+ * @param contactNormal Normal of the contact in world-space
+ * @param distance Distance between the two shapes (positive)
+ * @param localPt1 Closest point on the first shape (in local-space of the shape)
+ * @param localPt2 Closest point on the second shape (in local-space of the shape)
+ */
+void NarrowPhaseInfo::addSpeculativeContactPoint(const Vector3& contactNormal, decimal distance,
+                                                 const Vector3& localPt1, const Vector3& localPt2) {
+
+    assert(distance > decimal(0.0));
+
+    // Get the memory allocator
+    MemoryAllocator& allocator = *contactPointsAllocator;
+
+    // Create the contact point info
+    ContactPointInfo* contactPointInfo = new (allocator.allocate(sizeof(ContactPointInfo)))
+            ContactPointInfo(contactNormal, -distance, localPt1, localPt2);
 
     // Add it into the linked list of contact points
     contactPointInfo->next = contactPoints;
@@ -81,6 +171,9 @@ void NarrowPhaseInfo::addContactPoint(const Vector3& contactNormal, decimal penD
 /// Take all the generated contact points and create a new potential
 /// contact manifold into the overlapping pair
 void NarrowPhaseInfo::addContactPointsAsPotentialContactManifold() {
+
+    // The contact points are copied into the potential contact manifolds of the
+    // pair and released with the allocator used to create them
     overlappingPair->addPotentialContactPoints(this);
 }
 
@@ -88,7 +181,7 @@ void NarrowPhaseInfo::addContactPointsAsPotentialContactManifold() {
 void NarrowPhaseInfo::resetContactPoints() {
 
     // Get the memory allocator
-    MemoryAllocator& allocator = overlappingPair->getTemporaryAllocator();
+    MemoryAllocator& allocator = *contactPointsAllocator;
 
     // For each remaining contact point info
     ContactPointInfo* element = contactPoints;
@@ -38,6 +38,22 @@ struct LastFrameCollisionInfo;
 class ContactManifoldInfo;
 struct ContactPointInfo;
 
+// Structure NarrowPhaseInfoBlock
+/**
+ * Header of a memory block that contains the triangle shapes and the narrow-phase infos
+ * of all the triangles of a concave shape that overlap a convex shape. The triangles of
+ * a pair are created with a single allocation and the block is released when its last
+ * narrow-phase info is destroyed.
+ */
+struct NarrowPhaseInfoBlock {
+
+    /// Size of the memory block (in bytes)
+    size_t sizeBytes;
+
+    /// Number of narrow-phase infos of the block that have not been destroyed yet
+    uint nbRemainingInfos;
+};
+
 // Class NarrowPhaseInfo
 /**
  * This structure regroups different things about a collision shape. This is
@@ -47,9 +63,12 @@ struct NarrowPhaseInfo {
 
     public:
 
-        /// Broadphase overlapping pair
+        /// Broadphase overlapping pair (null for the queries that do not keep any state)
         OverlappingPair* overlappingPair;
 
+        /// Last frame collision info used when there is no overlapping pair
+        LastFrameCollisionInfo* lastFrameCollisionInfo;
+
         /// Pointer to the first collision shape to test collision with
         CollisionShape* collisionShape1;
 
@@ -62,26 +81,75 @@ struct NarrowPhaseInfo {
         /// Transform that maps from collision shape 2 local-space to world-space
         Transform shape2ToWorldTransform;
 
+        /// Id of the first collision shape in the last frame collision infos of the pair
+        uint shape1Id;
+
+        /// Id of the second collision shape in the last frame collision infos of the pair
+        uint shape2Id;
+
         /// Linked-list of contact points created during the narrow-phase
         ContactPointInfo* contactPoints;
 
         /// Pointer to the next element in the linked list
         NarrowPhaseInfo* next;
 
-        /// Memory allocator for the collision shape (Used to release TriangleShape memory in destructor)
-        MemoryAllocator& collisionShapeAllocator;
+        /// Memory allocator used to allocate the narrow-phase info
+        MemoryAllocator& allocator;
+
+        /// Memory block that contains the narrow-phase info and its triangle shape (null if
+        /// the narrow-phase info has been allocated alone)
+        NarrowPhaseInfoBlock* block;
+
+        /// Memory allocator used to allocate the contact points (temporary allocator of
+        /// the overlapping pair by default)
+        MemoryAllocator* contactPointsAllocator;
+
+        /// Number of times the GJK algorithm has been run for the narrow-phase info
+        uint nbGJKTests;
+
+        /// Total number of iterations of the GJK algorithm for the narrow-phase info
+        uint nbGJKIterations;
+
+        /// Number of times the GJK algorithm has started from the simplex of the previous frame
+        uint nbGJKWarmStarts;
+
+        /// Index of the cost of the overlapping pair in the narrow-phase costs of the
+        /// collision detection (only used if the costs are enabled)
+        uint pairCostIndex;
+
+        /// Estimated time of the narrow-phase test (in nanoseconds, only measured if the
+        /// narrow-phase costs are enabled)
+        uint64 narrowPhaseTicks;
 
         /// Constructor
         NarrowPhaseInfo(OverlappingPair* pair, CollisionShape* shape1,
                         CollisionShape* shape2, const Transform& shape1Transform,
-                        const Transform& shape2Transform, MemoryAllocator& shapeAllocator);
+                        const Transform& shape2Transform, MemoryAllocator& allocator);
+
+        /// Constructor with the ids of the shapes in the last frame collision infos of the pair
+        NarrowPhaseInfo(OverlappingPair* pair, CollisionShape* shape1,
+                        CollisionShape* shape2, const Transform& shape1Transform,
+                        const Transform& shape2Transform, uint shape1Id, uint shape2Id,
+                        MemoryAllocator& allocator);
+
+        /// Constructor without overlapping pair
+        NarrowPhaseInfo(CollisionShape* shape1, CollisionShape* shape2, const Transform& shape1Transform,
+                        const Transform& shape2Transform, LastFrameCollisionInfo* lastFrameInfo,
+                        MemoryAllocator& allocator);
 
         /// Destructor
         ~NarrowPhaseInfo();
 
+        /// Destroy a narrow-phase info and release its memory
+        static void destroy(NarrowPhaseInfo* narrowPhaseInfo);
+
         /// Add a new contact point
         void addContactPoint(const Vector3& contactNormal, decimal penDepth,
-                             const Vector3& localPt1, const Vector3& localPt2);
+                             const Vector3& localPt1, const Vector3& localPt2, uint32 featureId = 0);
+
+        /// Add a new speculative contact point between two shapes that are not touching yet
+        void addSpeculativeContactPoint(const Vector3& contactNormal, decimal distance,
+                                        const Vector3& localPt1, const Vector3& localPt2);
 
         /// Create a new potential contact manifold into the overlapping pair using current contact points
         void addContactPointsAsPotentialContactManifold();
@@ -95,7 +163,8 @@ struct NarrowPhaseInfo {
 
 // Get the last collision frame info for temporal coherence
 inline LastFrameCollisionInfo* NarrowPhaseInfo::getLastFrameCollisionInfo() const {
-    return overlappingPair->getLastFrameCollisionInfo(collisionShape1->getId(), collisionShape2->getId());
+    if (overlappingPair == nullptr) return lastFrameCollisionInfo;
+    return overlappingPair->getLastFrameCollisionInfo(shape1Id, shape2Id);
 }
 
 }
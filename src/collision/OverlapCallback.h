@@ -31,6 +31,21 @@ namespace reactphysics3d {
 
 // Declarations
 class CollisionBody;
+class ProxyShape;
+
+// Structure OverlapHit
+/**
+ * This structure contains a proxy shape reported by an overlap query that fills an
+ * array of hits (see CollisionWorld::testAABBOverlap() and CollisionWorld::testOverlap()).
+ */
+struct OverlapHit {
+
+    /// Pointer to the overlapping collision body
+    CollisionBody* body;
+
+    /// Pointer to the overlapping proxy collision shape
+    ProxyShape* proxyShape;
+};
 
 // Class OverlapCallback
 /**
@@ -37,6 +37,22 @@ using namespace reactphysics3d;
  * @param polygonVertexArray Pointer to the array of polygons and their vertices
  */
 PolyhedronMesh::PolyhedronMesh(PolygonVertexArray* polygonVertexArray)
+               : PolyhedronMesh(polygonVertexArray, nullptr, 0) {
+
+}
+
+// Constructor with a serialized half-edge structure
+/**
+ * Create a polyhedron mesh given an array of polygons and the serialized half-edge
+ * structure of the mesh (created by HalfEdgeStructure::serialize()) so that the half-edge
+ * structure does not have to be created. The structure is created as usual if the serialized
+ * structure is not valid for the array of polygons.
+ * @param polygonVertexArray Pointer to the array of polygons and their vertices
+ * @param halfEdgeStructureData Pointer to the serialized half-edge structure (can be null)
+ * @param halfEdgeStructureSizeInBytes Size of the serialized half-edge structure in bytes
+ */
+PolyhedronMesh::PolyhedronMesh(PolygonVertexArray* polygonVertexArray, const void* halfEdgeStructureData,
+                               size_t halfEdgeStructureSizeInBytes)
                : mHalfEdgeStructure(MemoryManager::getBaseAllocator(),
                                     polygonVertexArray->getNbFaces(),
                                     polygonVertexArray->getNbVertices(),
@@ -45,7 +61,9 @@ PolyhedronMesh::PolyhedronMesh(PolygonVertexArray* polygonVertexArray)
    mPolygonVertexArray = polygonVertexArray;
 
    // Create the half-edge structure of the mesh
-   createHalfEdgeStructure();
+   if (!loadHalfEdgeStructure(halfEdgeStructureData, halfEdgeStructureSizeInBytes)) {
+       createHalfEdgeStructure();
+   }
 
    // Create the face normals array
    mFacesNormals = new Vector3[mHalfEdgeStructure.getNbFaces()];
@@ -55,11 +73,25 @@ PolyhedronMesh::PolyhedronMesh(PolygonVertexArray* polygonVertexArray)
 
    // Compute the centroid
    computeCentroid();
+
+   // Create the arrays of vertex coordinates for the support vertex search
+   const uint nbVertices = mHalfEdgeStructure.getNbVertices();
+   mNbPaddedVertices = ((nbVertices + NB_SUPPORT_LANES - 1) / NB_SUPPORT_LANES) * NB_SUPPORT_LANES;
+   mVerticesCoordinates = new decimal[3 * mNbPaddedVertices];
+   computeVerticesCoordinates();
+
+   // Create the arrays of face planes for the raycast
+   const uint nbFaces = mHalfEdgeStructure.getNbFaces();
+   mNbPaddedFaces = ((nbFaces + NB_FACE_LANES - 1) / NB_FACE_LANES) * NB_FACE_LANES;
+   mFacesPlanes = new decimal[4 * mNbPaddedFaces];
+   computeFacesPlanes();
 }
 
 // Destructor
 PolyhedronMesh::~PolyhedronMesh() {
     delete[] mFacesNormals;
+    delete[] mVerticesCoordinates;
+    delete[] mFacesPlanes;
 }
 
 // Create the half-edge structure of the mesh
@@ -93,6 +125,34 @@ void PolyhedronMesh::createHalfEdgeStructure() {
     mHalfEdgeStructure.init();
 }
 
+// Load the half-edge structure of the mesh from a serialized structure
+/// Return false (and leave the structure empty) if the serialized structure is not valid or if
+/// its vertices and faces are not the ones of the array of polygons.
+bool PolyhedronMesh::loadHalfEdgeStructure(const void* data, size_t sizeInBytes) {
+
+    if (data == nullptr) return false;
+
+    HalfEdgeStructure halfEdgeStructure(MemoryManager::getBaseAllocator(), 0, 0, 0);
+    if (!halfEdgeStructure.loadSerialized(data, sizeInBytes)) return false;
+
+    if (halfEdgeStructure.getNbVertices() != mPolygonVertexArray->getNbVertices() ||
+        halfEdgeStructure.getNbFaces() != mPolygonVertexArray->getNbFaces()) {
+        return false;
+    }
+    for (uint v=0; v < halfEdgeStructure.getNbVertices(); v++) {
+        if (halfEdgeStructure.getVertex(v).vertexPointIndex != v) return false;
+    }
+    for (uint f=0; f < halfEdgeStructure.getNbFaces(); f++) {
+        const SmallList<uint, 8>& faceVertices = halfEdgeStructure.getFace(f).faceVertices;
+        if (faceVertices.size() != mPolygonVertexArray->getPolygonFace(f)->nbVertices) return false;
+        for (uint v=0; v < faceVertices.size(); v++) {
+            if (faceVertices[v] != mPolygonVertexArray->getVertexIndexInFace(f, v)) return false;
+        }
+    }
+
+    return mHalfEdgeStructure.loadSerialized(data, sizeInBytes);
+}
+
 /// Return a vertex
 /**
  * @param index Index of a given vertex in the mesh
@@ -155,3 +215,184 @@ void PolyhedronMesh::computeCentroid() {
 
     mCentroid /= getNbVertices();
 }
+
+// Copy the vertices into the arrays of vertex coordinates
+/// The padding at the end of the arrays is filled with copies of the first vertex so that
+/// it can never have a larger dot product than a vertex of the mesh.
+void PolyhedronMesh::computeVerticesCoordinates() {
+
+    decimal* verticesX = mVerticesCoordinates;
+    decimal* verticesY = mVerticesCoordinates + mNbPaddedVertices;
+    decimal* verticesZ = mVerticesCoordinates + 2 * mNbPaddedVertices;
+
+    for (uint v=0; v < mNbPaddedVertices; v++) {
+        const Vector3 vertex = getVertex(v < getNbVertices() ? v : 0);
+        verticesX[v] = vertex.x;
+        verticesY[v] = vertex.y;
+        verticesZ[v] = vertex.z;
+    }
+}
+
+// Compute the arrays of face planes
+/// The plane of a face goes through the first vertex of the face. The padding at the end of
+/// the arrays is filled with planes whose normal is zero and that go through the origin so
+/// that they never clip a ray.
+void PolyhedronMesh::computeFacesPlanes() {
+
+    decimal* normalsX = mFacesPlanes;
+    decimal* normalsY = mFacesPlanes + mNbPaddedFaces;
+    decimal* normalsZ = mFacesPlanes + 2 * mNbPaddedFaces;
+    decimal* distances = mFacesPlanes + 3 * mNbPaddedFaces;
+
+    for (uint f=0; f < mNbPaddedFaces; f++) {
+
+        if (f < getNbFaces()) {
+            const HalfEdgeStructure::Face& face = mHalfEdgeStructure.getFace(f);
+            const HalfEdgeStructure::Vertex& faceVertex = mHalfEdgeStructure.getVertex(face.faceVertices[0]);
+            normalsX[f] = mFacesNormals[f].x;
+            normalsY[f] = mFacesNormals[f].y;
+            normalsZ[f] = mFacesNormals[f].z;
+            distances[f] = mFacesNormals[f].dot(getVertex(faceVertex.vertexPointIndex));
+        }
+        else {
+            normalsX[f] = decimal(0.0);
+            normalsY[f] = decimal(0.0);
+            normalsZ[f] = decimal(0.0);
+            distances[f] = decimal(0.0);
+        }
+    }
+}
+
+// Return the index of the vertex with the largest dot product with a direction
+/// The dot products are computed for NB_SUPPORT_LANES vertices at a time from the arrays of
+/// vertex coordinates. Each lane keeps its own maximum and the lanes are reduced at the end.
+/// The lane loops have no dependency between the lanes so that the compiler can vectorize them.
+uint PolyhedronMesh::computeSupportVertex(const Vector3& direction) const {
+
+    assert(getNbVertices() > 0);
+
+    const decimal* verticesX = mVerticesCoordinates;
+    const decimal* verticesY = mVerticesCoordinates + mNbPaddedVertices;
+    const decimal* verticesZ = mVerticesCoordinates + 2 * mNbPaddedVertices;
+
+    decimal maxDotProducts[NB_SUPPORT_LANES];
+    uint maxVertices[NB_SUPPORT_LANES];
+    for (uint l=0; l < NB_SUPPORT_LANES; l++) {
+        maxDotProducts[l] = DECIMAL_SMALLEST;
+        maxVertices[l] = 0;
+    }
+
+    // For each group of vertices
+    for (uint v=0; v < mNbPaddedVertices; v += NB_SUPPORT_LANES) {
+
+        // For each lane
+        for (uint l=0; l < NB_SUPPORT_LANES; l++) {
+
+            const decimal dotProduct = direction.x * verticesX[v + l] + direction.y * verticesY[v + l] +
+                                       direction.z * verticesZ[v + l];
+            const bool isLarger = dotProduct > maxDotProducts[l];
+            maxDotProducts[l] = isLarger ? dotProduct : maxDotProducts[l];
+            maxVertices[l] = isLarger ? v + l : maxVertices[l];
+        }
+    }
+
+    // Reduce the lanes
+    uint supportVertex = maxVertices[0];
+    decimal maxDotProduct = maxDotProducts[0];
+    for (uint l=1; l < NB_SUPPORT_LANES; l++) {
+        if (maxDotProducts[l] > maxDotProduct) {
+            maxDotProduct = maxDotProducts[l];
+            supportVertex = maxVertices[l];
+        }
+    }
+
+    assert(supportVertex < getNbVertices());
+
+    return supportVertex;
+}
+
+// Clip a ray with the face planes and return true if it enters the polyhedron
+/// The ray "rayPoint + t * rayDirection" (with t between 0 and maxFraction) is clipped with
+/// NB_FACE_LANES face planes at a time from the arrays of face planes, like a slab test. The
+/// faces that the ray enters raise the entry fraction and the faces that it exits lower the
+/// exit fraction. Each lane keeps its own fractions and the lanes are reduced at the end. The
+/// lane loops have no dependency between the lanes so that the compiler can vectorize them.
+/// The method returns false if the ray starts inside the polyhedron.
+/**
+ * @param rayPoint Start point of the ray
+ * @param rayDirection Direction of the ray (not necessarily unit)
+ * @param maxFraction Maximum fraction of the ray
+ * @param[out] hitFraction Fraction of the ray where it enters the polyhedron
+ * @param[out] hitFace Index of the face where the ray enters the polyhedron
+ * @return True if the ray enters the polyhedron between the fractions 0 and maxFraction
+ */
+bool PolyhedronMesh::clipRay(const Vector3& rayPoint, const Vector3& rayDirection, decimal maxFraction,
+                             decimal& hitFraction, uint& hitFace) const {
+
+    const decimal* normalsX = mFacesPlanes;
+    const decimal* normalsY = mFacesPlanes + mNbPaddedFaces;
+    const decimal* normalsZ = mFacesPlanes + 2 * mNbPaddedFaces;
+    const decimal* distances = mFacesPlanes + 3 * mNbPaddedFaces;
+
+    decimal entryFractions[NB_FACE_LANES];
+    decimal exitFractions[NB_FACE_LANES];
+    uint entryFaces[NB_FACE_LANES];
+    bool isOutside[NB_FACE_LANES];
+    for (uint l=0; l < NB_FACE_LANES; l++) {
+        entryFractions[l] = decimal(0.0);
+        exitFractions[l] = maxFraction;
+        entryFaces[l] = mNbPaddedFaces;
+        isOutside[l] = false;
+    }
+
+    // For each group of faces
+    for (uint f=0; f < mNbPaddedFaces; f += NB_FACE_LANES) {
+
+        // For each lane
+        for (uint l=0; l < NB_FACE_LANES; l++) {
+
+            const decimal denom = normalsX[f + l] * rayDirection.x + normalsY[f + l] * rayDirection.y +
+                                  normalsZ[f + l] * rayDirection.z;
+            const decimal dist = distances[f + l] - (normalsX[f + l] * rayPoint.x + normalsY[f + l] * rayPoint.y +
+                                                     normalsZ[f + l] * rayPoint.z);
+            const bool isParallel = denom == decimal(0.0);
+            const decimal t = dist / (isParallel ? decimal(1.0) : denom);
+
+            // A ray parallel to a face plane and outside of it misses the polyhedron
+            isOutside[l] = isOutside[l] || (isParallel && dist < decimal(0.0));
+
+            // Clip the ray as it enters the polyhedron through a face that faces the ray
+            const bool isEntry = denom < decimal(0.0) && t > entryFractions[l];
+            entryFractions[l] = isEntry ? t : entryFractions[l];
+            entryFaces[l] = isEntry ? f + l : entryFaces[l];
+
+            // Clip the ray as it exits the polyhedron through the other faces
+            const bool isExit = denom > decimal(0.0) && t < exitFractions[l];
+            exitFractions[l] = isExit ? t : exitFractions[l];
+        }
+    }
+
+    // Reduce the lanes (the first face with the largest entry fraction is kept)
+    decimal entryFraction = entryFractions[0];
+    decimal exitFraction = exitFractions[0];
+    uint entryFace = entryFaces[0];
+    bool isRayOutside = isOutside[0];
+    for (uint l=1; l < NB_FACE_LANES; l++) {
+        if (entryFractions[l] > entryFraction || (entryFractions[l] == entryFraction && entryFaces[l] < entryFace)) {
+            entryFraction = entryFractions[l];
+            entryFace = entryFaces[l];
+        }
+        exitFraction = std::min(exitFraction, exitFractions[l]);
+        isRayOutside = isRayOutside || isOutside[l];
+    }
+
+    // If the ray does not enter the polyhedron or if the clipped ray is empty
+    if (isRayOutside || entryFace == mNbPaddedFaces || entryFraction > exitFraction) return false;
+
+    assert(entryFace < getNbFaces());
+
+    hitFraction = entryFraction;
+    hitFace = entryFace;
+
+    return true;
+}
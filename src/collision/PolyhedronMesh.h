@@ -43,6 +43,18 @@ class PolygonVertexArray;
  */
 class PolyhedronMesh {
 
+    public:
+
+        // -------------------- Constants -------------------- //
+
+        /// Number of vertices tested together by the support vertex search (the
+        /// arrays of vertex coordinates are padded to a multiple of this number)
+        static const uint NB_SUPPORT_LANES = 8;
+
+        /// Number of face planes clipped together by the raycast (the arrays of face
+        /// planes are padded to a multiple of this number)
+        static const uint NB_FACE_LANES = 8;
+
     private:
 
         // -------------------- Attributes -------------------- //
@@ -60,17 +72,40 @@ class PolyhedronMesh {
         /// Centroid of the polyhedron
         Vector3 mCentroid;
 
+        /// Number of vertices in the arrays of vertex coordinates (with the padding)
+        uint mNbPaddedVertices;
+
+        /// Coordinates of the vertices stored as a structure of arrays (x coordinates, then
+        /// y coordinates, then z coordinates) for the support vertex search
+        decimal* mVerticesCoordinates;
+
+        /// Number of faces in the arrays of face planes (with the padding)
+        uint mNbPaddedFaces;
+
+        /// Planes of the faces stored as a structure of arrays (x, y and z coordinates of the
+        /// normals, then the distances of the planes to the origin) for the raycast
+        decimal* mFacesPlanes;
+
         // -------------------- Methods -------------------- //
 
         /// Create the half-edge structure of the mesh
         void createHalfEdgeStructure();
 
+        /// Load the half-edge structure of the mesh from a serialized structure
+        bool loadHalfEdgeStructure(const void* data, size_t sizeInBytes);
+
         /// Compute the faces normals
         void computeFacesNormals();
 
         /// Compute the centroid of the polyhedron
         void computeCentroid() ;
 
+        /// Copy the vertices into the arrays of vertex coordinates
+        void computeVerticesCoordinates();
+
+        /// Compute the arrays of face planes
+        void computeFacesPlanes();
+
     public:
 
         // -------------------- Methods -------------------- //
@@ -78,6 +113,10 @@ class PolyhedronMesh {
         /// Constructor
         PolyhedronMesh(PolygonVertexArray* polygonVertexArray);
 
+        /// Constructor with a serialized half-edge structure
+        PolyhedronMesh(PolygonVertexArray* polygonVertexArray, const void* halfEdgeStructureData,
+                       size_t halfEdgeStructureSizeInBytes);
+
         /// Destructor
         ~PolyhedronMesh();
 
@@ -98,6 +137,13 @@ class PolyhedronMesh {
 
         /// Return the centroid of the polyhedron
         Vector3 getCentroid() const;
+
+        /// Return the index of the vertex with the largest dot product with a direction
+        uint computeSupportVertex(const Vector3& direction) const;
+
+        /// Clip a ray with the face planes and return true if it enters the polyhedron
+        bool clipRay(const Vector3& rayPoint, const Vector3& rayDirection, decimal maxFraction,
+                     decimal& hitFraction, uint& hitFace) const;
 };
 
 // Return the number of vertices
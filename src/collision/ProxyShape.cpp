@@ -27,6 +27,7 @@
 #include "ProxyShape.h"
 #include "utils/Logger.h"
 #include "collision/RaycastInfo.h"
+#include "collision/ContactManifoldInfo.h"
 #include "memory/MemoryManager.h"
 
 using namespace reactphysics3d;
@@ -40,7 +41,9 @@ using namespace reactphysics3d;
  */
 ProxyShape::ProxyShape(CollisionBody* body, CollisionShape* shape, const Transform& transform, decimal mass, MemoryManager& memoryManager)
            :mMemoryManager(memoryManager), mBody(body), mCollisionShape(shape), mLocalToBodyTransform(transform), mMass(mass),
-            mNext(nullptr), mBroadPhaseID(-1), mUserData(nullptr), mCollisionCategoryBits(0x0001), mCollideWithMaskBits(0xFFFF) {
+            mNext(nullptr), mBroadPhaseID(-1), mQueryOnlyNodeID(-1), mBroadPhaseMovedStamp(0), mBroadPhaseAABBGap(DYNAMIC_TREE_AABB_GAP),
+            mNbBroadPhaseUpdatesInsideFatAABB(0), mUserData(nullptr), mCollisionCategoryBits(0x0001), mCollideWithMaskBits(ALL_COLLISION_CATEGORIES),
+            mIsTrigger(false), mIsQueryOnly(false), mNbMaxContactManifolds(0), mNbMaxContactPointsInManifold(0) {
 
 }
 
@@ -64,9 +67,13 @@ bool ProxyShape::testPointInside(const Vector3& worldPoint) {
 /**
  * @param collisionCategoryBits The collision category bits mask of the proxy shape
  */
-void ProxyShape::setCollisionCategoryBits(unsigned short collisionCategoryBits) {
+void ProxyShape::setCollisionCategoryBits(collisionmask collisionCategoryBits) {
     mCollisionCategoryBits = collisionCategoryBits;
 
+    // The broad-phase filters the pairs with the collision bits, so the overlapping
+    // pairs of the shapes are computed again
+    mBody->askForBroadPhaseCollisionCheck();
+
     RP3D_LOG(mLogger, Logger::Level::Information, Logger::Category::ProxyShape,
              "ProxyShape " + std::to_string(mBroadPhaseID) + ": Set collisionCategoryBits=" +
              std::to_string(mCollisionCategoryBits));
@@ -76,14 +83,89 @@ void ProxyShape::setCollisionCategoryBits(unsigned short collisionCategoryBits)
 /**
  * @param collideWithMaskBits The bits mask that specifies with which collision category this shape will collide
  */
-void ProxyShape::setCollideWithMaskBits(unsigned short collideWithMaskBits) {
+void ProxyShape::setCollideWithMaskBits(collisionmask collideWithMaskBits) {
     mCollideWithMaskBits = collideWithMaskBits;
 
+    // The broad-phase filters the pairs with the collision bits, so the overlapping
+    // pairs of the shapes are computed again
+    mBody->askForBroadPhaseCollisionCheck();
+
     RP3D_LOG(mLogger, Logger::Level::Information, Logger::Category::ProxyShape,
              "ProxyShape " + std::to_string(mBroadPhaseID) + ": Set collideWithMaskBits=" +
              std::to_string(mCollideWithMaskBits));
 }
 
+// Set whether the shape is a trigger
+/// The collision detection only tests if a trigger intersects with the other shapes
+/// and reports a TRIGGER_ENTER or TRIGGER_EXIT contact event (see
+/// CollisionWorld::getContactEvents()) when the intersection starts or stops. No contact
+/// point, contact manifold or contact constraint is created for a trigger. This should
+/// be set before the shape starts overlapping with other shapes.
+/**
+ * @param isTrigger True if the proxy shape is a trigger
+ */
+void ProxyShape::setIsTrigger(bool isTrigger) {
+    mIsTrigger = isTrigger;
+
+    RP3D_LOG(mLogger, Logger::Level::Information, Logger::Category::ProxyShape,
+             "ProxyShape " + std::to_string(mBroadPhaseID) + ": Set isTrigger=" +
+             (isTrigger ? std::string("true") : std::string("false")));
+}
+
+// Set whether the shape is only used by the queries of the world
+/// A query-only shape is moved from the broad-phase into a separate tree that is searched by the
+/// raycasts and the AABB overlap tests of the world but never by the computation of the overlapping
+/// pairs. This can be used for sensors or picking volumes that would otherwise create many pairs.
+/**
+ * @param isQueryOnly True if the proxy shape must only be used by the queries of the world
+ */
+void ProxyShape::setIsQueryOnly(bool isQueryOnly) {
+
+    if (mIsQueryOnly == isQueryOnly) return;
+
+    mBody->setIsProxyShapeQueryOnly(this, isQueryOnly);
+
+    RP3D_LOG(mLogger, Logger::Level::Information, Logger::Category::ProxyShape,
+             "ProxyShape " + std::to_string(mBroadPhaseID) + ": Set isQueryOnly=" +
+             (isQueryOnly ? std::string("true") : std::string("false")));
+}
+
+// Set the maximum number of contact manifolds in the overlapping pairs of the shape
+/// The contacts of a pair are limited by the smallest budget of its two shapes and of the
+/// world settings. This can be used to lower the cost of the contacts of small debris.
+/**
+ * @param nbMaxContactManifolds The maximum number of contact manifolds (zero to use the
+ *                              value of the world settings)
+ */
+void ProxyShape::setNbMaxContactManifolds(int nbMaxContactManifolds) {
+
+    assert(nbMaxContactManifolds >= 0);
+
+    mNbMaxContactManifolds = nbMaxContactManifolds;
+
+    RP3D_LOG(mLogger, Logger::Level::Information, Logger::Category::ProxyShape,
+             "ProxyShape " + std::to_string(mBroadPhaseID) + ": Set nbMaxContactManifolds=" +
+             std::to_string(nbMaxContactManifolds));
+}
+
+// Set the maximum number of contact points in the contact manifolds of the shape
+/// The contacts of a pair are limited by the smallest budget of its two shapes and of the
+/// world settings. This can be used to lower the cost of the contacts of small debris.
+/**
+ * @param nbMaxContactPoints The maximum number of contact points between 1 and 4 (zero to
+ *                           use the value of the world settings)
+ */
+void ProxyShape::setNbMaxContactPointsInManifold(int nbMaxContactPoints) {
+
+    assert(nbMaxContactPoints >= 0 && nbMaxContactPoints <= MAX_CONTACT_POINTS_IN_MANIFOLD);
+
+    mNbMaxContactPointsInManifold = nbMaxContactPoints;
+
+    RP3D_LOG(mLogger, Logger::Level::Information, Logger::Category::ProxyShape,
+             "ProxyShape " + std::to_string(mBroadPhaseID) + ": Set nbMaxContactPointsInManifold=" +
+             std::to_string(nbMaxContactPoints));
+}
+
 // Set the local to parent body transform
 void ProxyShape::setLocalToBodyTransform(const Transform& transform) {
 
@@ -107,6 +189,20 @@ void ProxyShape::setLocalToBodyTransform(const Transform& transform) {
  * @return True if the ray hits the collision shape
  */
 bool ProxyShape::raycast(const Ray& ray, RaycastInfo& raycastInfo) {
+    return raycast(ray, raycastInfo, mMemoryManager.getPoolAllocator(MemoryTag::Shapes));
+}
+
+// Raycast method with feedback information and the allocator of the temporary memory
+/// The allocator is used by the raycast of the concave shapes. A worker thread that casts
+/// rays at the same time as other threads has to use its own allocator.
+/**
+ * @param ray Ray to use for the raycasting
+ * @param[out] raycastInfo Result of the raycasting that is valid only if the
+ *             methods returned true
+ * @param allocator Allocator of the temporary memory of the raycast
+ * @return True if the ray hits the collision shape
+ */
+bool ProxyShape::raycast(const Ray& ray, RaycastInfo& raycastInfo, MemoryAllocator& allocator) {
 
     // If the corresponding body is not active, it cannot be hit by rays
     if (!mBody->isActive()) return false;
@@ -118,7 +214,7 @@ bool ProxyShape::raycast(const Ray& ray, RaycastInfo& raycastInfo) {
                  worldToLocalTransform * ray.point2,
                  ray.maxFraction);
 
-    bool isHit = mCollisionShape->raycast(rayLocal, raycastInfo, this, mMemoryManager.getPoolAllocator());
+    bool isHit = mCollisionShape->raycast(rayLocal, raycastInfo, this, allocator);
 
     // Convert the raycast info into world-space
     raycastInfo.worldPoint = localToWorldTransform * raycastInfo.worldPoint;
@@ -34,6 +34,7 @@ namespace  reactphysics3d {
 
 // Declarations
 class MemoryManager;
+class MemoryAllocator;
 
 // Class ProxyShape
 /**
@@ -72,6 +73,19 @@ class ProxyShape {
         /// Broad-phase ID (node ID in the dynamic AABB tree)
         int mBroadPhaseID;
 
+        /// Node ID of the shape in the tree of the query-only shapes (-1 if the shape
+        /// is not a query-only shape of the world)
+        int mQueryOnlyNodeID;
+
+        /// Stamp of the last broad-phase where the shape has moved (or has been created)
+        uint64 mBroadPhaseMovedStamp;
+
+        /// Gap used to inflate the fat AABB of the shape in the broad-phase
+        decimal mBroadPhaseAABBGap;
+
+        /// Number of consecutive broad-phase updates of the shape inside its fat AABB
+        uint mNbBroadPhaseUpdatesInsideFatAABB;
+
         /// Pointer to user data
         void* mUserData;
 
@@ -81,12 +95,28 @@ class ProxyShape {
         /// together with the mCollideWithMaskBits variable so that given
         /// categories of shapes collide with each other and do not collide with
         /// other categories.
-        unsigned short mCollisionCategoryBits;
+        collisionmask mCollisionCategoryBits;
 
         /// Bits mask used to state which collision categories this shape can
-        /// collide with. This value is 0xFFFF by default. It means that this
+        /// collide with. This value is ALL_COLLISION_CATEGORIES by default. It means that this
         /// proxy shape will collide with every collision categories by default.
-        unsigned short mCollideWithMaskBits;
+        collisionmask mCollideWithMaskBits;
+
+        /// True if the shape is a trigger. The overlap of a trigger with another shape is
+        /// reported with contact events but no contact is created between them.
+        bool mIsTrigger;
+
+        /// True if the shape is only used by the queries of the world (raycasts and AABB
+        /// overlap tests). A query-only shape is never part of an overlapping pair.
+        bool mIsQueryOnly;
+
+        /// Maximum number of contact manifolds in the overlapping pairs of the shape
+        /// (zero to use the value of the world settings)
+        int mNbMaxContactManifolds;
+
+        /// Maximum number of contact points in the contact manifolds of the shape
+        /// (zero to use the value of the world settings)
+        int mNbMaxContactPointsInManifold;
 
 #ifdef IS_PROFILING_ACTIVE
 
@@ -106,6 +136,9 @@ class ProxyShape {
 		/// Return the collision shape
 		CollisionShape* getCollisionShape();
 
+        /// Return true if the shape is in the broad-phase or in the tree of the query-only shapes
+        bool isInCollisionDetection() const;
+
     public:
 
         // -------------------- Methods -------------------- //
@@ -159,17 +192,44 @@ class ProxyShape {
         /// Raycast method with feedback information
         bool raycast(const Ray& ray, RaycastInfo& raycastInfo);
 
+        /// Raycast method with feedback information and the allocator of the temporary memory
+        bool raycast(const Ray& ray, RaycastInfo& raycastInfo, MemoryAllocator& allocator);
+
         /// Return the collision bits mask
-        unsigned short getCollideWithMaskBits() const;
+        collisionmask getCollideWithMaskBits() const;
 
         /// Set the collision bits mask
-        void setCollideWithMaskBits(unsigned short collideWithMaskBits);
+        void setCollideWithMaskBits(collisionmask collideWithMaskBits);
 
         /// Return the collision category bits
-        unsigned short getCollisionCategoryBits() const;
+        collisionmask getCollisionCategoryBits() const;
 
         /// Set the collision category bits
-        void setCollisionCategoryBits(unsigned short collisionCategoryBits);
+        void setCollisionCategoryBits(collisionmask collisionCategoryBits);
+
+        /// Return true if the shape is a trigger
+        bool isTrigger() const;
+
+        /// Set whether the shape is a trigger
+        void setIsTrigger(bool isTrigger);
+
+        /// Return true if the shape is only used by the queries of the world
+        bool isQueryOnly() const;
+
+        /// Set whether the shape is only used by the queries of the world
+        void setIsQueryOnly(bool isQueryOnly);
+
+        /// Return the maximum number of contact manifolds in the overlapping pairs of the shape
+        int getNbMaxContactManifolds() const;
+
+        /// Set the maximum number of contact manifolds in the overlapping pairs of the shape
+        void setNbMaxContactManifolds(int nbMaxContactManifolds);
+
+        /// Return the maximum number of contact points in the contact manifolds of the shape
+        int getNbMaxContactPointsInManifold() const;
+
+        /// Set the maximum number of contact points in the contact manifolds of the shape
+        void setNbMaxContactPointsInManifold(int nbMaxContactPoints);
 
         /// Return the next proxy shape in the linked list of proxy shapes
         ProxyShape* getNext();
@@ -306,7 +366,7 @@ inline const ProxyShape* ProxyShape::getNext() const {
 /**
  * @return The collision category bits mask of the proxy shape
  */
-inline unsigned short ProxyShape::getCollisionCategoryBits() const {
+inline collisionmask ProxyShape::getCollisionCategoryBits() const {
     return mCollisionCategoryBits;
 }
 
@@ -314,15 +374,52 @@ inline unsigned short ProxyShape::getCollisionCategoryBits() const {
 /**
  * @return The bits mask that specifies with which collision category this shape will collide
  */
-inline unsigned short ProxyShape::getCollideWithMaskBits() const {
+inline collisionmask ProxyShape::getCollideWithMaskBits() const {
     return mCollideWithMaskBits;
 }
 
+// Return true if the shape is a trigger
+/**
+ * @return True if the proxy shape is a trigger
+ */
+inline bool ProxyShape::isTrigger() const {
+    return mIsTrigger;
+}
+
+// Return true if the shape is only used by the queries of the world
+/**
+ * @return True if the proxy shape is a query-only shape
+ */
+inline bool ProxyShape::isQueryOnly() const {
+    return mIsQueryOnly;
+}
+
+// Return the maximum number of contact manifolds in the overlapping pairs of the shape
+/**
+ * @return The maximum number of contact manifolds (zero if the value of the world settings is used)
+ */
+inline int ProxyShape::getNbMaxContactManifolds() const {
+    return mNbMaxContactManifolds;
+}
+
+// Return the maximum number of contact points in the contact manifolds of the shape
+/**
+ * @return The maximum number of contact points (zero if the value of the world settings is used)
+ */
+inline int ProxyShape::getNbMaxContactPointsInManifold() const {
+    return mNbMaxContactPointsInManifold;
+}
+
 // Return the broad-phase id
 inline int ProxyShape::getBroadPhaseId() const {
     return mBroadPhaseID;
 }
 
+// Return true if the shape is in the broad-phase or in the tree of the query-only shapes
+inline bool ProxyShape::isInCollisionDetection() const {
+    return mBroadPhaseID != -1 || mQueryOnlyNodeID != -1;
+}
+
 /// Test if the proxy shape overlaps with a given AABB
 /**
 * @param worldAABB The AABB (in world-space coordinates) that will be used to test overlap
@@ -0,0 +1,409 @@
+/********************************************************************************
+* ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
+* Copyright (c) 2010-2018 Daniel Chappuis                                       *
+*********************************************************************************
+*                                                                               *
+* This software is provided 'as-is', without any express or implied warranty.   *
+* In no event will the authors be held liable for any damages arising from the  *
+* use of this software.                                                         *
+*                                                                               *
+* Permission is granted to anyone to use this software for any purpose,         *
+* including commercial applications, and to alter it and redistribute it        *
+* freely, subject to the following restrictions:                                *
+*                                                                               *
+* 1. The origin of this software must not be misrepresented; you must not claim *
+*    that you wrote the original software. If you use this software in a        *
+*    product, an acknowledgment in the product documentation would be           *
+*    appreciated but is not required.                                           *
+*                                                                               *
+* 2. Altered source versions must be plainly marked as such, and must not be    *
+*    misrepresented as being the original software.                             *
+*                                                                               *
+* 3. This notice may not be removed or altered from any source distribution.    *
+*                                                                               *
+********************************************************************************/
+
+// Libraries
+#include "QuantizedBVH.h"
+#include "collision/broadphase/DynamicAABBTree.h"
+#include "mathematics/Ray.h"
+#include "memory/MemoryAllocator.h"
+#include "utils/Profiler.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+using namespace reactphysics3d;
+
+// Initialization of static variables
+const uint QuantizedBVH::MAX_LEAF_TRIANGLES = 4;
+const decimal QuantizedBVH::MAX_QUANTIZED_VALUE = decimal(65535.0);
+const uint32 QuantizedBVH::SERIALIZED_MAGIC = 0x48564251;    // "QBVH" in little-endian
+const uint32 QuantizedBVH::SERIALIZED_VERSION = 2;
+
+// Size of the header of a serialized tree (magic number, version, size of a decimal, number
+// of nodes, number of triangles and padding)
+static const size_t SERIALIZED_HEADER_SIZE = 6 * sizeof(uint32);
+
+// Size of the vectors of a serialized tree (AABB, quantization scale and inverse scale)
+static const size_t SERIALIZED_VECTORS_SIZE = 12 * sizeof(decimal);
+
+// Constructor
+QuantizedBVH::QuantizedBVH(MemoryAllocator& allocator)
+             : mAllocator(allocator), mNodes(nullptr), mOwnsNodes(false), mNbNodes(0),
+               mTriangleIds(nullptr), mNbTriangles(0), mAABB(Vector3::zero(), Vector3::zero()),
+               mQuantizationScale(Vector3::zero()), mInverseQuantizationScale(Vector3::zero()) {
+
+#ifdef IS_PROFILING_ACTIVE
+    mProfiler = nullptr;
+#endif
+
+}
+
+// Destructor
+QuantizedBVH::~QuantizedBVH() {
+    releaseNodes();
+}
+
+// Release the nodes of the tree
+void QuantizedBVH::releaseNodes() {
+
+    if (mNodes != nullptr && mOwnsNodes) {
+        mAllocator.release(const_cast<QuantizedBVHNode*>(mNodes), mNbNodes * sizeof(QuantizedBVHNode));
+        mAllocator.release(const_cast<uint32*>(mTriangleIds), mNbTriangles * sizeof(uint32));
+    }
+
+    mNodes = nullptr;
+    mTriangleIds = nullptr;
+    mOwnsNodes = false;
+    mNbNodes = 0;
+    mNbTriangles = 0;
+}
+
+// Build the tree with the AABBs of some triangles (the ID of a triangle is its index)
+/// The leaves of the tree contain at most maxLeafTriangles triangles (between one
+/// and MAX_LEAF_TRIANGLES).
+void QuantizedBVH::build(const AABB* trianglesAABBs, uint nbTriangles, uint maxLeafTriangles) {
+
+    assert(maxLeafTriangles >= 1 && maxLeafTriangles <= MAX_LEAF_TRIANGLES);
+
+    // Release the previous nodes
+    releaseNodes();
+
+    if (nbTriangles == 0) {
+        mAABB = AABB(Vector3::zero(), Vector3::zero());
+        return;
+    }
+
+    // Compute the AABB of all the triangles
+    mAABB = trianglesAABBs[0];
+    for (uint i=1; i < nbTriangles; i++) {
+        mAABB.mergeWithAABB(trianglesAABBs[i]);
+    }
+
+    // Compute the quantization scale for each axis (an axis where the tree is flat
+    // has a single quantized value)
+    const Vector3 extent = mAABB.getExtent();
+    for (int i=0; i < 3; i++) {
+        mQuantizationScale[i] = extent[i] > MACHINE_EPSILON ? MAX_QUANTIZED_VALUE / extent[i] : decimal(0.0);
+        mInverseQuantizationScale[i] = extent[i] > MACHINE_EPSILON ? extent[i] / MAX_QUANTIZED_VALUE : decimal(0.0);
+    }
+
+    const uint nbNodes = computeNbSubTreeNodes(nbTriangles, maxLeafTriangles);
+    QuantizedBVHNode* nodes = static_cast<QuantizedBVHNode*>(mAllocator.allocate(nbNodes * sizeof(QuantizedBVHNode)));
+    uint32* triangleIds = static_cast<uint32*>(mAllocator.allocate(nbTriangles * sizeof(uint32)));
+    mNodes = nodes;
+    mTriangleIds = triangleIds;
+    mNbTriangles = nbTriangles;
+    mOwnsNodes = true;
+
+    Vector3* centers = static_cast<Vector3*>(mAllocator.allocate(nbTriangles * sizeof(Vector3)));
+    for (uint i=0; i < nbTriangles; i++) {
+        centers[i] = trianglesAABBs[i].getCenter();
+        triangleIds[i] = i;
+    }
+
+    buildSubTree(nodes, trianglesAABBs, centers, triangleIds, 0, nbTriangles, maxLeafTriangles);
+    assert(mNbNodes == nbNodes);
+
+    mAllocator.release(centers, nbTriangles * sizeof(Vector3));
+}
+
+// Return the number of triangles of the left child of a node with some triangles
+/// The number of triangles of the left child is rounded up to a multiple of the maximum
+/// number of triangles in a leaf so that the leaves are full.
+uint QuantizedBVH::computeNbLeftTriangles(uint nbTriangles, uint maxLeafTriangles) {
+
+    assert(nbTriangles > maxLeafTriangles);
+
+    const uint nbLeftTriangles = ((nbTriangles / 2 + maxLeafTriangles - 1) / maxLeafTriangles) * maxLeafTriangles;
+    assert(nbLeftTriangles > 0 && nbLeftTriangles < nbTriangles);
+
+    return nbLeftTriangles;
+}
+
+// Return the number of nodes of the sub-tree of some triangles
+uint QuantizedBVH::computeNbSubTreeNodes(uint nbTriangles, uint maxLeafTriangles) {
+
+    if (nbTriangles <= maxLeafTriangles) return 1;
+
+    const uint nbLeftTriangles = computeNbLeftTriangles(nbTriangles, maxLeafTriangles);
+    return 1 + computeNbSubTreeNodes(nbLeftTriangles, maxLeafTriangles) +
+           computeNbSubTreeNodes(nbTriangles - nbLeftTriangles, maxLeafTriangles);
+}
+
+// Build the sub-tree of some triangles and return the index of its root node
+/// The nodes of the sub-tree are created in depth-first order. The triangles are split
+/// at the median of their centers along the largest axis of the centers bounds. The sub-tree
+/// contains the triangles from index firstTriangle in the array of triangle IDs.
+uint QuantizedBVH::buildSubTree(QuantizedBVHNode* nodes, const AABB* trianglesAABBs, const Vector3* centers,
+                                uint32* triangleIds, uint firstTriangle, uint nbTriangles,
+                                uint maxLeafTriangles) {
+
+    assert(nbTriangles > 0);
+
+    const uint nodeIndex = mNbNodes;
+    mNbNodes++;
+    QuantizedBVHNode& node = nodes[nodeIndex];
+    uint32* subTreeTriangleIds = triangleIds + firstTriangle;
+
+    // Compute the AABB of the triangles and the bounds of their centers
+    AABB aabb = trianglesAABBs[subTreeTriangleIds[0]];
+    AABB centersBounds(centers[subTreeTriangleIds[0]], centers[subTreeTriangleIds[0]]);
+    for (uint i=1; i < nbTriangles; i++) {
+        aabb.mergeWithAABB(trianglesAABBs[subTreeTriangleIds[i]]);
+        centersBounds.mergeWithAABB(AABB(centers[subTreeTriangleIds[i]], centers[subTreeTriangleIds[i]]));
+    }
+    quantize(aabb, node.min, node.max);
+
+    // If the node is a leaf with a cluster of triangles
+    if (nbTriangles <= maxLeafTriangles) {
+        node.escapeIndexOrLeafTriangles = static_cast<int32>(firstTriangle * 4 + nbTriangles - 1);
+        return nodeIndex;
+    }
+
+    // Split the triangles at the median along the largest axis
+    const Vector3 centersExtent = centersBounds.getExtent();
+    const int axis = centersExtent.getMaxAxis();
+    const uint nbLeftTriangles = computeNbLeftTriangles(nbTriangles, maxLeafTriangles);
+    std::nth_element(subTreeTriangleIds, subTreeTriangleIds + nbLeftTriangles, subTreeTriangleIds + nbTriangles,
+                     [centers, axis](uint32 triangle1, uint32 triangle2) {
+        return centers[triangle1][axis] < centers[triangle2][axis];
+    });
+
+    buildSubTree(nodes, trianglesAABBs, centers, triangleIds, firstTriangle, nbLeftTriangles, maxLeafTriangles);
+    buildSubTree(nodes, trianglesAABBs, centers, triangleIds, firstTriangle + nbLeftTriangles,
+                 nbTriangles - nbLeftTriangles, maxLeafTriangles);
+
+    // Store the number of nodes to skip to go over the sub-tree
+    nodes[nodeIndex].escapeIndexOrLeafTriangles = -static_cast<int32>(mNbNodes - nodeIndex);
+
+    return nodeIndex;
+}
+
+// Return the size in bytes of the serialized tree
+size_t QuantizedBVH::getSerializedSizeInBytes() const {
+    return SERIALIZED_HEADER_SIZE + SERIALIZED_VECTORS_SIZE + mNbNodes * sizeof(QuantizedBVHNode) +
+           mNbTriangles * sizeof(uint32);
+}
+
+// Write the serialized tree into a buffer
+/// The serialized tree is made of a header (magic number, version, size of a decimal and numbers
+/// of nodes and triangles), the AABB and the quantization scales of the tree and then the nodes
+/// and the triangle IDs as they are stored in memory. The buffer must have the size given by getSerializedSizeInBytes().
+void QuantizedBVH::serialize(void* buffer) const {
+
+    unsigned char* bytes = static_cast<unsigned char*>(buffer);
+
+    const uint32 header[6] = {SERIALIZED_MAGIC, SERIALIZED_VERSION, static_cast<uint32>(sizeof(decimal)),
+                              static_cast<uint32>(mNbNodes), static_cast<uint32>(mNbTriangles), 0};
+    std::memcpy(bytes, header, SERIALIZED_HEADER_SIZE);
+    bytes += SERIALIZED_HEADER_SIZE;
+
+    const Vector3 vectors[4] = {mAABB.getMin(), mAABB.getMax(), mQuantizationScale, mInverseQuantizationScale};
+    for (int v=0; v < 4; v++) {
+        const decimal values[3] = {vectors[v].x, vectors[v].y, vectors[v].z};
+        std::memcpy(bytes, values, 3 * sizeof(decimal));
+        bytes += 3 * sizeof(decimal);
+    }
+
+    if (mNbNodes > 0) {
+        std::memcpy(bytes, mNodes, mNbNodes * sizeof(QuantizedBVHNode));
+        bytes += mNbNodes * sizeof(QuantizedBVHNode);
+        std::memcpy(bytes, mTriangleIds, mNbTriangles * sizeof(uint32));
+    }
+}
+
+// Load the tree from a serialized tree (the nodes are not copied)
+/// The nodes and the triangle IDs of the tree point directly into the serialized data that must therefore stay
+/// valid (for instance a memory-mapped file) and aligned on four bytes while the tree is used.
+/// Return false (and leave the tree unchanged) if the data is not a serialized tree of this
+/// version of the library with decimals of the same size.
+bool QuantizedBVH::loadSerialized(const void* data, size_t sizeInBytes) {
+
+    if (data == nullptr || sizeInBytes < SERIALIZED_HEADER_SIZE + SERIALIZED_VECTORS_SIZE ||
+        reinterpret_cast<std::uintptr_t>(data) % alignof(QuantizedBVHNode) != 0) {
+        return false;
+    }
+
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+
+    uint32 header[6];
+    std::memcpy(header, bytes, SERIALIZED_HEADER_SIZE);
+    if (header[0] != SERIALIZED_MAGIC || header[1] != SERIALIZED_VERSION || header[2] != sizeof(decimal)) {
+        return false;
+    }
+    const uint nbNodes = header[3];
+    const uint nbTriangles = header[4];
+    if (sizeInBytes != SERIALIZED_HEADER_SIZE + SERIALIZED_VECTORS_SIZE + nbNodes * sizeof(QuantizedBVHNode) +
+                       nbTriangles * sizeof(uint32) || (nbNodes == 0) != (nbTriangles == 0)) {
+        return false;
+    }
+    bytes += SERIALIZED_HEADER_SIZE;
+
+    Vector3 vectors[4];
+    for (int v=0; v < 4; v++) {
+        decimal values[3];
+        std::memcpy(values, bytes, 3 * sizeof(decimal));
+        vectors[v].setAllValues(values[0], values[1], values[2]);
+        bytes += 3 * sizeof(decimal);
+    }
+
+    releaseNodes();
+
+    mAABB = AABB(vectors[0], vectors[1]);
+    mQuantizationScale = vectors[2];
+    mInverseQuantizationScale = vectors[3];
+    mNodes = nbNodes > 0 ? reinterpret_cast<const QuantizedBVHNode*>(bytes) : nullptr;
+    mNbNodes = nbNodes;
+    mTriangleIds = nbTriangles > 0 ? reinterpret_cast<const uint32*>(bytes + nbNodes * sizeof(QuantizedBVHNode)) : nullptr;
+    mNbTriangles = nbTriangles;
+
+    return true;
+}
+
+// Quantize an AABB (rounded outward)
+void QuantizedBVH::quantize(const AABB& aabb, uint16* quantizedMin, uint16* quantizedMax) const {
+
+    for (int i=0; i < 3; i++) {
+
+        const decimal min = (aabb.getMin()[i] - mAABB.getMin()[i]) * mQuantizationScale[i];
+        const decimal max = (aabb.getMax()[i] - mAABB.getMin()[i]) * mQuantizationScale[i];
+
+        quantizedMin[i] = static_cast<uint16>(clamp(std::floor(min), decimal(0.0), MAX_QUANTIZED_VALUE));
+        quantizedMax[i] = static_cast<uint16>(clamp(std::ceil(max), decimal(0.0), MAX_QUANTIZED_VALUE));
+    }
+}
+
+// Return the AABB of a node in local coordinates
+AABB QuantizedBVH::computeNodeAABB(const QuantizedBVHNode& node) const {
+
+    const Vector3& origin = mAABB.getMin();
+    return AABB(Vector3(origin.x + node.min[0] * mInverseQuantizationScale.x,
+                        origin.y + node.min[1] * mInverseQuantizationScale.y,
+                        origin.z + node.min[2] * mInverseQuantizationScale.z),
+                Vector3(origin.x + node.max[0] * mInverseQuantizationScale.x,
+                        origin.y + node.max[1] * mInverseQuantizationScale.y,
+                        origin.z + node.max[2] * mInverseQuantizationScale.z));
+}
+
+// Report the IDs of all the triangles whose quantized AABB overlaps with a given AABB
+/// The callback is called with the ID of each overlapping triangle.
+void QuantizedBVH::reportAllTrianglesOverlappingWithAABB(const AABB& aabb,
+                                                         DynamicAABBTreeOverlapCallback& callback) const {
+
+    if (mNbNodes == 0 || !aabb.testCollision(mAABB)) return;
+
+    // Quantize the AABB and inflate it by one quantum to cover the rounding errors
+    uint16 min[3];
+    uint16 max[3];
+    quantize(aabb, min, max);
+    for (int i=0; i < 3; i++) {
+        if (min[i] > 0) min[i]--;
+        if (max[i] < uint16(65535)) max[i]++;
+    }
+
+    // Walk through the nodes in depth-first order and skip the sub-trees
+    // of the nodes that do not overlap
+    uint nodeIndex = 0;
+    while (nodeIndex < mNbNodes) {
+
+        const QuantizedBVHNode& node = mNodes[nodeIndex];
+
+        const bool isOverlapping = min[0] <= node.max[0] && max[0] >= node.min[0] &&
+                                   min[1] <= node.max[1] && max[1] >= node.min[1] &&
+                                   min[2] <= node.max[2] && max[2] >= node.min[2];
+
+        if (node.isLeaf()) {
+
+            if (isOverlapping) {
+                reportLeafTriangles(node, callback);
+            }
+            nodeIndex++;
+        }
+        else {
+            nodeIndex += isOverlapping ? 1 : static_cast<uint>(-node.escapeIndexOrLeafTriangles);
+        }
+    }
+}
+
+// Report the IDs of the triangles of a leaf to an overlap callback
+void QuantizedBVH::reportLeafTriangles(const QuantizedBVHNode& node, DynamicAABBTreeOverlapCallback& callback) const {
+
+    const uint32* triangleIds = mTriangleIds + node.getLeafFirstTriangle();
+    const uint nbTriangles = node.getLeafNbTriangles();
+    for (uint i=0; i < nbTriangles; i++) {
+        callback.notifyOverlappingNode(static_cast<int>(triangleIds[i]));
+    }
+}
+
+// Ray casting method (the callback is called with the IDs of the hit triangle AABBs)
+void QuantizedBVH::raycast(const Ray& ray, DynamicAABBTreeRaycastCallback& callback) const {
+
+    RP3D_PROFILE("QuantizedBVH::raycast()", mProfiler);
+
+    decimal maxFraction = ray.maxFraction;
+
+    uint nodeIndex = 0;
+    while (nodeIndex < mNbNodes) {
+
+        const QuantizedBVHNode& node = mNodes[nodeIndex];
+
+        Ray rayTemp(ray.point1, ray.point2, maxFraction);
+
+        // Test if the ray intersects with the current node AABB
+        const bool isHit = computeNodeAABB(node).testRayIntersect(rayTemp);
+
+        if (node.isLeaf()) {
+
+            if (isHit) {
+
+                // For each triangle of the leaf
+                const uint32* triangleIds = mTriangleIds + node.getLeafFirstTriangle();
+                const uint nbTriangles = node.getLeafNbTriangles();
+                for (uint i=0; i < nbTriangles; i++) {
+
+                    // Call the callback that will raycast against the triangle
+                    decimal hitFraction = callback.raycastBroadPhaseShape(static_cast<int>(triangleIds[i]), rayTemp);
+
+                    // If the user returned a hitFraction of zero, it means that
+                    // the raycasting should stop here
+                    if (hitFraction == decimal(0.0)) {
+                        return;
+                    }
+
+                    // If the user returned a positive fraction, we update the maximum fraction
+                    if (hitFraction > decimal(0.0) && hitFraction < maxFraction) {
+                        maxFraction = hitFraction;
+                        rayTemp.maxFraction = maxFraction;
+                    }
+                }
+            }
+            nodeIndex++;
+        }
+        else {
+            nodeIndex += isHit ? 1 : static_cast<uint>(-node.escapeIndexOrLeafTriangles);
+        }
+    }
+}
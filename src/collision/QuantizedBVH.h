@@ -0,0 +1,272 @@
+/********************************************************************************
+* ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
+* Copyright (c) 2010-2018 Daniel Chappuis                                       *
+*********************************************************************************
+*                                                                               *
+* This software is provided 'as-is', without any express or implied warranty.   *
+* In no event will the authors be held liable for any damages arising from the  *
+* use of this software.                                                         *
+*                                                                               *
+* Permission is granted to anyone to use this software for any purpose,         *
+* including commercial applications, and to alter it and redistribute it        *
+* freely, subject to the following restrictions:                                *
+*                                                                               *
+* 1. The origin of this software must not be misrepresented; you must not claim *
+*    that you wrote the original software. If you use this software in a        *
+*    product, an acknowledgment in the product documentation would be           *
+*    appreciated but is not required.                                           *
+*                                                                               *
+* 2. Altered source versions must be plainly marked as such, and must not be    *
+*    misrepresented as being the original software.                             *
+*                                                                               *
+* 3. This notice may not be removed or altered from any source distribution.    *
+*                                                                               *
+********************************************************************************/
+
+#ifndef REACTPHYSICS3D_QUANTIZED_BVH_H
+#define REACTPHYSICS3D_QUANTIZED_BVH_H
+
+// Libraries
+#include "configuration.h"
+#include "collision/shapes/AABB.h"
+#include <cassert>
+
+/// Namespace ReactPhysics3D
+namespace reactphysics3d {
+
+// Declarations
+class DynamicAABBTreeOverlapCallback;
+class DynamicAABBTreeRaycastCallback;
+class MemoryAllocator;
+class Profiler;
+struct Ray;
+
+// Structure QuantizedBVHNode
+/**
+ * This structure represents a node of a quantized BVH. The bounds of the node are
+ * stored with 16-bit integers relative to the bounds of the whole tree.
+ */
+struct QuantizedBVHNode {
+
+    /// Quantized minimum coordinates of the AABB of the node
+    uint16 min[3];
+
+    /// Quantized maximum coordinates of the AABB of the node
+    uint16 max[3];
+
+    /// Index of the first triangle in the array of triangle IDs (times four) plus the number
+    /// of triangles minus one for a leaf (positive) or minus the number of nodes of the
+    /// sub-tree of an internal node (negative)
+    int32 escapeIndexOrLeafTriangles;
+
+    /// Return true if the node is a leaf of the tree
+    bool isLeaf() const;
+
+    /// Return the index of the first triangle of a leaf in the array of triangle IDs
+    uint getLeafFirstTriangle() const;
+
+    /// Return the number of triangles of a leaf
+    uint getLeafNbTriangles() const;
+};
+
+// Class QuantizedBVH
+/**
+ * This class represents a static bounding volume hierarchy of triangles that is built once
+ * and never modified. It is used instead of a dynamic AABB tree for the concave meshes. Each
+ * node only takes 16 bytes because its AABB is quantized with 16-bit integers in the bounds
+ * of the whole tree. The nodes are stored in depth-first order and each internal node knows
+ * the size of its sub-tree. Therefore, the tree is traversed without a stack by going to the
+ * next node or by skipping the sub-tree of a node whose AABB is not overlapping. Each leaf
+ * contains a cluster of up to four spatially adjacent triangles whose IDs are consecutive in
+ * an array of triangle IDs so that the tree has about four times fewer nodes than with one
+ * triangle per leaf.
+ */
+class QuantizedBVH {
+
+    public :
+
+        // -------------------- Constants -------------------- //
+
+        /// Maximum number of triangles in a leaf of the tree
+        static const uint MAX_LEAF_TRIANGLES;
+
+    private :
+
+        // -------------------- Constants -------------------- //
+
+        /// Largest quantized coordinate
+        static const decimal MAX_QUANTIZED_VALUE;
+
+        /// Magic number at the beginning of a serialized tree
+        static const uint32 SERIALIZED_MAGIC;
+
+        /// Version of the format of a serialized tree
+        static const uint32 SERIALIZED_VERSION;
+
+        // -------------------- Attributes -------------------- //
+
+        /// Memory allocator
+        MemoryAllocator& mAllocator;
+
+        /// Nodes of the tree in depth-first order
+        const QuantizedBVHNode* mNodes;
+
+        /// True if the nodes and the triangle IDs have been allocated by the tree (false if
+        /// they are stored in a serialized tree owned by the user)
+        bool mOwnsNodes;
+
+        /// Number of nodes of the tree
+        uint mNbNodes;
+
+        /// IDs of the triangles of the leaves (the triangles of a leaf are consecutive)
+        const uint32* mTriangleIds;
+
+        /// Number of triangles of the tree
+        uint mNbTriangles;
+
+        /// AABB of all the triangles of the tree
+        AABB mAABB;
+
+        /// Scaling from the local coordinates (relative to the minimum of the tree AABB) to the
+        /// quantized coordinates
+        Vector3 mQuantizationScale;
+
+        /// Scaling from the quantized coordinates to the local coordinates
+        Vector3 mInverseQuantizationScale;
+
+#ifdef IS_PROFILING_ACTIVE
+
+        /// Pointer to the profiler
+        Profiler* mProfiler;
+
+#endif
+
+        // -------------------- Methods -------------------- //
+
+        /// Build the sub-tree of some triangles and return the index of its root node
+        uint buildSubTree(QuantizedBVHNode* nodes, const AABB* trianglesAABBs, const Vector3* centers,
+                          uint32* triangleIds, uint firstTriangle, uint nbTriangles, uint maxLeafTriangles);
+
+        /// Return the number of triangles of the left child of a node with some triangles
+        static uint computeNbLeftTriangles(uint nbTriangles, uint maxLeafTriangles);
+
+        /// Return the number of nodes of the sub-tree of some triangles
+        static uint computeNbSubTreeNodes(uint nbTriangles, uint maxLeafTriangles);
+
+        /// Report the IDs of the triangles of a leaf to an overlap callback
+        void reportLeafTriangles(const QuantizedBVHNode& node, DynamicAABBTreeOverlapCallback& callback) const;
+
+        /// Release the nodes of the tree
+        void releaseNodes();
+
+        /// Quantize an AABB (rounded outward)
+        void quantize(const AABB& aabb, uint16* quantizedMin, uint16* quantizedMax) const;
+
+        /// Return the AABB of a node in local coordinates
+        AABB computeNodeAABB(const QuantizedBVHNode& node) const;
+
+    public :
+
+        // -------------------- Methods -------------------- //
+
+        /// Constructor
+        QuantizedBVH(MemoryAllocator& allocator);
+
+        /// Destructor
+        ~QuantizedBVH();
+
+        /// Deleted copy-constructor
+        QuantizedBVH(const QuantizedBVH& tree) = delete;
+
+        /// Deleted assignment operator
+        QuantizedBVH& operator=(const QuantizedBVH& tree) = delete;
+
+        /// Build the tree with the AABBs of some triangles (the ID of a triangle is its index)
+        void build(const AABB* trianglesAABBs, uint nbTriangles, uint maxLeafTriangles = MAX_LEAF_TRIANGLES);
+
+        /// Return the size in bytes of the serialized tree
+        size_t getSerializedSizeInBytes() const;
+
+        /// Write the serialized tree into a buffer
+        void serialize(void* buffer) const;
+
+        /// Load the tree from a serialized tree (the nodes are not copied)
+        bool loadSerialized(const void* data, size_t sizeInBytes);
+
+        /// Return the AABB of all the triangles of the tree
+        const AABB& getRootAABB() const;
+
+        /// Return the number of nodes of the tree
+        uint getNbNodes() const;
+
+        /// Return the number of triangles of the tree
+        uint getNbTriangles() const;
+
+        /// Return the memory used by the nodes and the triangle IDs of the tree in bytes
+        size_t getNodesSizeInBytes() const;
+
+        /// Report the IDs of all the triangles whose quantized AABB overlaps with a given AABB
+        void reportAllTrianglesOverlappingWithAABB(const AABB& aabb,
+                                                   DynamicAABBTreeOverlapCallback& callback) const;
+
+        /// Ray casting method (the callback is called with the IDs of the hit triangle AABBs)
+        void raycast(const Ray& ray, DynamicAABBTreeRaycastCallback& callback) const;
+
+#ifdef IS_PROFILING_ACTIVE
+
+        /// Set the profiler
+        void setProfiler(Profiler* profiler);
+
+#endif
+
+};
+
+// Return true if the node is a leaf of the tree
+inline bool QuantizedBVHNode::isLeaf() const {
+    return escapeIndexOrLeafTriangles >= 0;
+}
+
+// Return the index of the first triangle of a leaf in the array of triangle IDs
+inline uint QuantizedBVHNode::getLeafFirstTriangle() const {
+    assert(isLeaf());
+    return static_cast<uint>(escapeIndexOrLeafTriangles) >> 2;
+}
+
+// Return the number of triangles of a leaf
+inline uint QuantizedBVHNode::getLeafNbTriangles() const {
+    assert(isLeaf());
+    return (static_cast<uint>(escapeIndexOrLeafTriangles) & 3) + 1;
+}
+
+// Return the AABB of all the triangles of the tree
+inline const AABB& QuantizedBVH::getRootAABB() const {
+    return mAABB;
+}
+
+// Return the number of nodes of the tree
+inline uint QuantizedBVH::getNbNodes() const {
+    return mNbNodes;
+}
+
+// Return the number of triangles of the tree
+inline uint QuantizedBVH::getNbTriangles() const {
+    return mNbTriangles;
+}
+
+// Return the memory used by the nodes and the triangle IDs of the tree in bytes
+inline size_t QuantizedBVH::getNodesSizeInBytes() const {
+    return mNbNodes * sizeof(QuantizedBVHNode) + mNbTriangles * sizeof(uint32);
+}
+
+#ifdef IS_PROFILING_ACTIVE
+
+// Set the profiler
+inline void QuantizedBVH::setProfiler(Profiler* profiler) {
+    mProfiler = profiler;
+}
+
+#endif
+
+}
+
+#endif
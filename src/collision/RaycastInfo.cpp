@@ -35,7 +35,8 @@ decimal RaycastTest::raycastAgainstShape(ProxyShape* shape, const Ray& ray) {
 
     // Ray casting test against the collision shape
     RaycastInfo raycastInfo;
-    bool isHit = shape->raycast(ray, raycastInfo);
+    bool isHit = allocator != nullptr ? shape->raycast(ray, raycastInfo, *allocator) :
+                                        shape->raycast(ray, raycastInfo);
 
     // If the ray hit the collision shape
     if (isHit) {
@@ -47,3 +48,35 @@ decimal RaycastTest::raycastAgainstShape(ProxyShape* shape, const Ray& ray) {
 
     return ray.maxFraction;
 }
+
+// Copy the information of a raycast hit
+void RaycastHit::setHit(const RaycastInfo& raycastInfo) {
+
+    worldPoint = raycastInfo.worldPoint;
+    worldNormal = raycastInfo.worldNormal;
+    hitFraction = raycastInfo.hitFraction;
+    meshSubpart = raycastInfo.meshSubpart;
+    triangleIndex = raycastInfo.triangleIndex;
+    body = raycastInfo.body;
+    proxyShape = raycastInfo.proxyShape;
+}
+
+// Keep the hit if it is the closest one and clip the ray at the hit
+/// The hits are not reported in order. A hit further than the current closest hit
+/// can be reported before the ray is clipped in the broad-phase.
+decimal RaycastClosestHitCallback::notifyRaycastHit(const RaycastInfo& raycastInfo) {
+
+    if (!hit->isHit() || raycastInfo.hitFraction < hit->hitFraction) {
+        hit->setHit(raycastInfo);
+    }
+
+    return hit->hitFraction;
+}
+
+// Remember the hit and stop the raycast
+decimal RaycastAnyHitCallback::notifyRaycastHit(const RaycastInfo& raycastInfo) {
+
+    isHit = true;
+
+    return decimal(0.0);
+}
@@ -36,6 +36,7 @@ namespace reactphysics3d {
 class CollisionBody;
 class ProxyShape;
 class CollisionShape;
+class MemoryAllocator;
 struct Ray;
 
 // Structure RaycastInfo
@@ -89,6 +90,49 @@ struct RaycastInfo {
         RaycastInfo& operator=(const RaycastInfo& raycastInfo) = delete;
 };
 
+// Structure RaycastHit
+/**
+ * This structure contains the closest hit of a ray of a batch of rays (see
+ * CollisionWorld::raycastBatch()). Unlike RaycastInfo, it can be copied and
+ * stored in an array with the hits of the other rays.
+ */
+struct RaycastHit {
+
+    // -------------------- Attributes -------------------- //
+
+    /// Hit point in world-space coordinates
+    Vector3 worldPoint;
+
+    /// Surface normal at hit point in world-space coordinates
+    Vector3 worldNormal;
+
+    /// Fraction distance of the hit point between point1 and point2 of the ray
+    /// (the max fraction of the ray if the ray does not hit anything)
+    decimal hitFraction = decimal(1.0);
+
+    /// Mesh subpart index that has been hit (only used for triangles mesh and -1 otherwise)
+    int meshSubpart = -1;
+
+    /// Hit triangle index (only used for triangles mesh and -1 otherwise)
+    int triangleIndex = -1;
+
+    /// Pointer to the hit collision body (null if the ray does not hit anything)
+    CollisionBody* body = nullptr;
+
+    /// Pointer to the hit proxy collision shape (null if the ray does not hit anything)
+    ProxyShape* proxyShape = nullptr;
+
+    // -------------------- Methods -------------------- //
+
+    /// Return true if the ray has hit a shape
+    bool isHit() const {
+        return proxyShape != nullptr;
+    }
+
+    /// Copy the information of a raycast hit
+    void setHit(const RaycastInfo& raycastInfo);
+};
+
 // Class RaycastCallback
 /**
  * This class can be used to register a callback for ray casting queries.
@@ -126,6 +170,39 @@ class RaycastCallback {
 
 };
 
+// Class RaycastClosestHitCallback
+/**
+ * Raycast callback that keeps the closest hit of a ray. It is used to compute
+ * the results of a batch of rays and the closest hit of a ray with a broad-phase
+ * that does not have a traversal without callbacks.
+ */
+class RaycastClosestHitCallback : public RaycastCallback {
+
+    public:
+
+        /// Closest hit of the ray
+        RaycastHit* hit = nullptr;
+
+        /// Keep the hit if it is the closest one and clip the ray at the hit
+        virtual decimal notifyRaycastHit(const RaycastInfo& raycastInfo) override;
+};
+
+// Class RaycastAnyHitCallback
+/**
+ * Raycast callback that stops the raycast at the first hit of a ray. It is used
+ * by the occlusion queries.
+ */
+class RaycastAnyHitCallback : public RaycastCallback {
+
+    public:
+
+        /// True if the ray has hit a shape
+        bool isHit = false;
+
+        /// Remember the hit and stop the raycast
+        virtual decimal notifyRaycastHit(const RaycastInfo& raycastInfo) override;
+};
+
 /// Structure RaycastTest
 struct RaycastTest {
 
@@ -134,9 +211,14 @@ struct RaycastTest {
         /// User callback class
         RaycastCallback* userCallback;
 
+        /// Allocator of the temporary memory of the raycasts against the shapes
+        /// (null to use the allocator of the shapes)
+        MemoryAllocator* allocator;
+
         /// Constructor
-        RaycastTest(RaycastCallback* callback) {
+        RaycastTest(RaycastCallback* callback = nullptr, MemoryAllocator* raycastAllocator = nullptr) {
             userCallback = callback;
+            allocator = raycastAllocator;
         }
 
         /// Ray cast test against a proxy shape
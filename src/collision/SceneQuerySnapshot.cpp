@@ -0,0 +1,259 @@
+/********************************************************************************
+* ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
+* Copyright (c) 2010-2018 Daniel Chappuis                                       *
+*********************************************************************************
+*                                                                               *
+* This software is provided 'as-is', without any express or implied warranty.   *
+* In no event will the authors be held liable for any damages arising from the  *
+* use of this software.                                                         *
+*                                                                               *
+* Permission is granted to anyone to use this software for any purpose,         *
+* including commercial applications, and to alter it and redistribute it        *
+* freely, subject to the following restrictions:                                *
+*                                                                               *
+* 1. The origin of this software must not be misrepresented; you must not claim *
+*    that you wrote the original software. If you use this software in a        *
+*    product, an acknowledgment in the product documentation would be           *
+*    appreciated but is not required.                                           *
+*                                                                               *
+* 2. Altered source versions must be plainly marked as such, and must not be    *
+*    misrepresented as being the original software.                             *
+*                                                                               *
+* 3. This notice may not be removed or altered from any source distribution.    *
+*                                                                               *
+********************************************************************************/
+
+// Libraries
+#include "SceneQuerySnapshot.h"
+#include "body/CollisionBody.h"
+#include "collision/ProxyShape.h"
+#include "collision/RaycastInfo.h"
+#include "collision/OverlapCallback.h"
+#include "collision/CollisionDetection.h"
+#include "collision/shapes/ConvexShape.h"
+#include "utils/Profiler.h"
+
+// We want to use the ReactPhysics3D namespace
+using namespace reactphysics3d;
+
+// Constructor
+SceneQuerySnapshot::SceneQuerySnapshot(MemoryAllocator& allocator)
+                   : mAllocator(allocator), mShapes(allocator), mTree(allocator) {
+
+}
+
+// Copy the proxy shapes of the active bodies of a list of bodies into the snapshot
+/// The memory of the snapshot is kept from one update to the next one. This method must
+/// not be called while queries are running on the snapshot.
+/**
+ * @param bodies List of the bodies of the world
+ * @param taskScheduler Task scheduler used to build the tree (null to build it sequentially)
+ */
+void SceneQuerySnapshot::update(const List<CollisionBody*>& bodies, TaskScheduler* taskScheduler) {
+
+    RP3D_PROFILE("SceneQuerySnapshot::update()", mProfiler);
+
+    mShapes.clear();
+    mTree.clear();
+
+    // Copy the proxy shapes of the active bodies
+    for (uint i=0; i < bodies.size(); i++) {
+
+        CollisionBody* body = bodies[i];
+        if (!body->isActive()) continue;
+
+        for (ProxyShape* proxyShape = body->getProxyShapesList(); proxyShape != nullptr;
+             proxyShape = proxyShape->getNext()) {
+
+            const ProxyShape* constProxyShape = proxyShape;
+            mShapes.add({proxyShape, body, constProxyShape->getCollisionShape(), proxyShape->getLocalToWorldTransform(),
+                         proxyShape->getCollisionCategoryBits()});
+        }
+    }
+
+    // Build the tree of the shapes (the shapes do not move in the list anymore)
+    mTree.reserve(static_cast<int>(mShapes.size()));
+    for (uint i=0; i < mShapes.size(); i++) {
+        AABB aabb;
+        mShapes[i].collisionShape->computeAABB(aabb, mShapes[i].localToWorldTransform);
+        mTree.addObjectDeferred(aabb, &(mShapes[i]));
+    }
+    mTree.insertDeferredObjects(taskScheduler);
+}
+
+// Raycast against a shape of the snapshot
+bool SceneQuerySnapshot::raycastShape(const SnapshotShape& shape, const Ray& ray, RaycastInfo& raycastInfo) const {
+
+    // Convert the ray into the local-space of the collision shape
+    const Transform worldToLocalTransform = shape.localToWorldTransform.getInverse();
+    const Ray rayLocal(worldToLocalTransform * ray.point1, worldToLocalTransform * ray.point2, ray.maxFraction);
+
+    if (!shape.collisionShape->raycast(rayLocal, raycastInfo, shape.proxyShape, mAllocator)) return false;
+
+    // Convert the raycast info into world-space
+    raycastInfo.worldPoint = shape.localToWorldTransform * raycastInfo.worldPoint;
+    raycastInfo.worldNormal = shape.localToWorldTransform.getOrientation() * raycastInfo.worldNormal;
+    raycastInfo.worldNormal.normalize();
+
+    return true;
+}
+
+// Ray casting method with a callback
+/// The callback is called for each shape of the snapshot hit by the ray, like with
+/// CollisionWorld::raycast().
+/**
+ * @param ray Ray to use for raycasting
+ * @param raycastCallback Pointer to the class with the callback method
+ * @param raycastWithCategoryMaskBits Bits mask corresponding to the category of
+ *                                    bodies to be raycasted
+ */
+void SceneQuerySnapshot::raycast(const Ray& ray, RaycastCallback* raycastCallback,
+                                 collisionmask raycastWithCategoryMaskBits) const {
+
+    RP3D_PROFILE("SceneQuerySnapshot::raycast()", mProfiler);
+
+    auto raycastLeaf = [&](int32 nodeId, const Ray& clippedRay) {
+
+        const SnapshotShape& shape = getShape(nodeId);
+
+        // Ignore the shapes filtered by the raycast mask or missed by the ray
+        if ((raycastWithCategoryMaskBits & shape.collisionCategoryBits) == 0) return decimal(-1.0);
+        RaycastInfo raycastInfo;
+        if (!raycastShape(shape, clippedRay, raycastInfo)) return decimal(-1.0);
+
+        return raycastCallback->notifyRaycastHit(raycastInfo);
+    };
+
+    mTree.raycastLeaves(ray, raycastLeaf, false);
+}
+
+// Cast a ray and return its closest hit
+/**
+ * @param ray Ray to use for raycasting
+ * @param[out] hit Closest hit of the ray (the proxy shape of the hit is null if the ray
+ *                 does not hit anything)
+ * @param raycastWithCategoryMaskBits Bits mask corresponding to the category of
+ *                                    bodies to be raycasted
+ * @return True if the ray hits a shape
+ */
+bool SceneQuerySnapshot::raycastClosest(const Ray& ray, RaycastHit& hit,
+                                        collisionmask raycastWithCategoryMaskBits) const {
+
+    RP3D_PROFILE("SceneQuerySnapshot::raycastClosest()", mProfiler);
+
+    hit = RaycastHit();
+    hit.hitFraction = ray.maxFraction;
+
+    auto raycastLeaf = [&](int32 nodeId, const Ray& clippedRay) {
+
+        const SnapshotShape& shape = getShape(nodeId);
+
+        // Ignore the shapes filtered by the raycast mask or missed by the ray
+        if ((raycastWithCategoryMaskBits & shape.collisionCategoryBits) == 0) return decimal(-1.0);
+        RaycastInfo raycastInfo;
+        if (!raycastShape(shape, clippedRay, raycastInfo)) return decimal(-1.0);
+
+        if (!hit.isHit() || raycastInfo.hitFraction < hit.hitFraction) {
+            hit.setHit(raycastInfo);
+        }
+
+        return hit.hitFraction;
+    };
+
+    mTree.raycastLeaves(ray, raycastLeaf, true);
+
+    return hit.isHit();
+}
+
+// Return true if a ray hits a shape
+/// The traversal of the tree stops at the first hit (which is not the closest one).
+/**
+ * @param ray Ray to use for raycasting
+ * @param raycastWithCategoryMaskBits Bits mask corresponding to the category of
+ *                                    bodies to be raycasted
+ * @return True if the ray hits a shape
+ */
+bool SceneQuerySnapshot::raycastAny(const Ray& ray, collisionmask raycastWithCategoryMaskBits) const {
+
+    RP3D_PROFILE("SceneQuerySnapshot::raycastAny()", mProfiler);
+
+    bool isHit = false;
+    auto raycastLeaf = [&](int32 nodeId, const Ray& clippedRay) {
+
+        const SnapshotShape& shape = getShape(nodeId);
+
+        // Ignore the shapes filtered by the raycast mask or missed by the ray
+        if ((raycastWithCategoryMaskBits & shape.collisionCategoryBits) == 0) return decimal(-1.0);
+        RaycastInfo raycastInfo;
+        if (!raycastShape(shape, clippedRay, raycastInfo)) return decimal(-1.0);
+
+        // Stop the traversal at the first hit
+        isHit = true;
+        return decimal(0.0);
+    };
+
+    mTree.raycastLeaves(ray, raycastLeaf, false);
+
+    return isHit;
+}
+
+// Fill an array with the proxy shapes whose AABBs overlap with the AABB in parameter
+/**
+ * @param aabb AABB used to test for overlap
+ * @param[out] hits Array where the overlapping proxy shapes are stored
+ * @param maxNbHits Size of the array of hits
+ * @param categoryMaskBits bits mask used to filter the bodies to test overlap with
+ * @return The number of hits stored in the array
+ */
+uint SceneQuerySnapshot::testAABBOverlap(const AABB& aabb, OverlapHit* hits, uint maxNbHits,
+                                         collisionmask categoryMaskBits) const {
+
+    RP3D_PROFILE("SceneQuerySnapshot::testAABBOverlap()", mProfiler);
+
+    SnapshotOverlapCallback callback(*this, hits, maxNbHits, categoryMaskBits, nullptr, Transform::identity());
+    mTree.reportAllShapesOverlappingWithAABB(aabb, callback);
+
+    return callback.nbHits;
+}
+
+// Fill an array with the proxy shapes that overlap with a convex shape at a given transform
+/**
+ * @param shape The convex shape to test overlap with
+ * @param shapeToWorldTransform Local-to-world transform of the shape
+ * @param[out] hits Array where the overlapping proxy shapes are stored
+ * @param maxNbHits Size of the array of hits
+ * @param categoryMaskBits bits mask used to filter the bodies to test overlap with
+ * @return The number of hits stored in the array
+ */
+uint SceneQuerySnapshot::testOverlap(const ConvexShape* shape, const Transform& shapeToWorldTransform,
+                                     OverlapHit* hits, uint maxNbHits, collisionmask categoryMaskBits) const {
+
+    RP3D_PROFILE("SceneQuerySnapshot::testOverlap()", mProfiler);
+
+    SnapshotOverlapCallback callback(*this, hits, maxNbHits, categoryMaskBits, shape, shapeToWorldTransform);
+    mTree.reportAllShapesOverlappingWithAABB(
+                CollisionDetection::computeSweptAABB(shape, shapeToWorldTransform, shapeToWorldTransform), callback);
+
+    return callback.nbHits;
+}
+
+// Store the shape of a leaf of the tree in the array if it overlaps with the tested shape
+void SceneQuerySnapshot::SnapshotOverlapCallback::notifyOverlappingNode(int nodeId) {
+
+    if (nbHits == mMaxNbHits) return;
+
+    const SnapshotShape& shape = mSnapshot.getShape(nodeId);
+
+    // Check if the collision filtering allows the overlap with this shape
+    if ((shape.collisionCategoryBits & mCategoryMaskBits) == 0) return;
+
+    if (mShape != nullptr && !CollisionDetection::testShapesOverlap(mSnapshot.mGJKAlgorithm, mShape,
+                                                                    mShapeToWorldTransform, shape.collisionShape,
+                                                                    shape.localToWorldTransform)) {
+        return;
+    }
+
+    mHits[nbHits].body = shape.body;
+    mHits[nbHits].proxyShape = shape.proxyShape;
+    nbHits++;
+}
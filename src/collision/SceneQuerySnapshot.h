@@ -0,0 +1,235 @@
+/********************************************************************************
+* ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
+* Copyright (c) 2010-2018 Daniel Chappuis                                       *
+*********************************************************************************
+*                                                                               *
+* This software is provided 'as-is', without any express or implied warranty.   *
+* In no event will the authors be held liable for any damages arising from the  *
+* use of this software.                                                         *
+*                                                                               *
+* Permission is granted to anyone to use this software for any purpose,         *
+* including commercial applications, and to alter it and redistribute it        *
+* freely, subject to the following restrictions:                                *
+*                                                                               *
+* 1. The origin of this software must not be misrepresented; you must not claim *
+*    that you wrote the original software. If you use this software in a        *
+*    product, an acknowledgment in the product documentation would be           *
+*    appreciated but is not required.                                           *
+*                                                                               *
+* 2. Altered source versions must be plainly marked as such, and must not be    *
+*    misrepresented as being the original software.                             *
+*                                                                               *
+* 3. This notice may not be removed or altered from any source distribution.    *
+*                                                                               *
+********************************************************************************/
+
+#ifndef REACTPHYSICS3D_SCENE_QUERY_SNAPSHOT_H
+#define REACTPHYSICS3D_SCENE_QUERY_SNAPSHOT_H
+
+// Libraries
+#include "configuration.h"
+#include "collision/broadphase/DynamicAABBTree.h"
+#include "collision/narrowphase/GJK/GJKAlgorithm.h"
+#include "containers/List.h"
+#include "mathematics/mathematics.h"
+
+/// ReactPhysics3D namespace
+namespace reactphysics3d {
+
+// Declarations
+class CollisionBody;
+class ProxyShape;
+class CollisionShape;
+class ConvexShape;
+class RaycastCallback;
+class TaskScheduler;
+class Profiler;
+struct RaycastInfo;
+struct RaycastHit;
+struct OverlapHit;
+
+// Class SceneQuerySnapshot
+/**
+ * This class contains a copy of the proxy shapes of a world at a given time (their
+ * world-space AABBs, transforms, collision shapes and collision categories) with a
+ * dynamic AABB tree over them. The queries of a snapshot only read this copy and the
+ * collision shapes, so that several threads can run them at the same time, between two
+ * steps or while a step started with DynamicsWorld::startUpdate() is running. The
+ * snapshot must be updated again after a body or a proxy shape has been destroyed
+ * because the hits of the queries point to them. The temporary memory of the queries
+ * (for the raycasts against the concave meshes for instance) is allocated with the
+ * base allocator, which is thread-safe by default.
+ */
+class SceneQuerySnapshot {
+
+    private:
+
+        // Structure SnapshotShape
+        /**
+         * Copy of a proxy shape at the time of the snapshot.
+         */
+        struct SnapshotShape {
+
+            /// Pointer to the proxy shape
+            ProxyShape* proxyShape;
+
+            /// Pointer to the body of the proxy shape
+            CollisionBody* body;
+
+            /// Collision shape of the proxy shape
+            const CollisionShape* collisionShape;
+
+            /// Local-to-world transform of the proxy shape
+            Transform localToWorldTransform;
+
+            /// Collision category bits of the proxy shape
+            collisionmask collisionCategoryBits;
+        };
+
+        // Class SnapshotOverlapCallback
+        /**
+         * Overlap callback that stores the shapes of the snapshot that overlap with an AABB
+         * (and with a convex shape if there is one) in an array of hits.
+         */
+        class SnapshotOverlapCallback : public DynamicAABBTreeOverlapCallback {
+
+            private:
+
+                /// Reference to the snapshot
+                const SceneQuerySnapshot& mSnapshot;
+
+                /// Array where the hits are stored
+                OverlapHit* mHits;
+
+                /// Size of the array of hits
+                uint mMaxNbHits;
+
+                /// Bits mask used to filter the shapes
+                collisionmask mCategoryMaskBits;
+
+                /// Convex shape tested against the shapes (null if only the AABBs are tested)
+                const ConvexShape* mShape;
+
+                /// Local-to-world transform of the convex shape
+                Transform mShapeToWorldTransform;
+
+            public:
+
+                /// Number of hits stored in the array
+                uint nbHits = 0;
+
+                /// Constructor
+                SnapshotOverlapCallback(const SceneQuerySnapshot& snapshot, OverlapHit* hits, uint maxNbHits,
+                                        collisionmask categoryMaskBits, const ConvexShape* shape,
+                                        const Transform& shapeToWorldTransform)
+                    : mSnapshot(snapshot), mHits(hits), mMaxNbHits(maxNbHits), mCategoryMaskBits(categoryMaskBits),
+                      mShape(shape), mShapeToWorldTransform(shapeToWorldTransform) {
+
+                }
+
+                /// Store the shape of a leaf of the tree in the array if it overlaps with the tested shape
+                virtual void notifyOverlappingNode(int nodeId) override;
+        };
+
+        // -------------------- Attributes -------------------- //
+
+        /// Allocator of the snapshot and of the temporary memory of the queries
+        MemoryAllocator& mAllocator;
+
+        /// Copies of the proxy shapes
+        List<SnapshotShape> mShapes;
+
+        /// Tree of the world-space AABBs of the shapes (the data of a leaf is a pointer to its shape)
+        DynamicAABBTree mTree;
+
+        /// GJK algorithm used by the shape overlap queries
+        GJKAlgorithm mGJKAlgorithm;
+
+#ifdef IS_PROFILING_ACTIVE
+
+        /// Pointer to the profiler
+        Profiler* mProfiler;
+
+#endif
+
+        // -------------------- Methods -------------------- //
+
+        /// Return the shape of a leaf of the tree
+        const SnapshotShape& getShape(int nodeId) const;
+
+        /// Raycast against a shape of the snapshot
+        bool raycastShape(const SnapshotShape& shape, const Ray& ray, RaycastInfo& raycastInfo) const;
+
+    public:
+
+        // -------------------- Methods -------------------- //
+
+        /// Constructor
+        SceneQuerySnapshot(MemoryAllocator& allocator);
+
+        /// Destructor
+        ~SceneQuerySnapshot() = default;
+
+        /// Deleted copy-constructor
+        SceneQuerySnapshot(const SceneQuerySnapshot& snapshot) = delete;
+
+        /// Deleted assignment operator
+        SceneQuerySnapshot& operator=(const SceneQuerySnapshot& snapshot) = delete;
+
+        /// Copy the proxy shapes of the active bodies of a list of bodies into the snapshot
+        void update(const List<CollisionBody*>& bodies, TaskScheduler* taskScheduler);
+
+        /// Return the number of proxy shapes in the snapshot
+        uint getNbProxyShapes() const;
+
+        /// Ray casting method with a callback
+        void raycast(const Ray& ray, RaycastCallback* raycastCallback,
+                     collisionmask raycastWithCategoryMaskBits = ALL_COLLISION_CATEGORIES) const;
+
+        /// Cast a ray and return its closest hit
+        bool raycastClosest(const Ray& ray, RaycastHit& hit, collisionmask raycastWithCategoryMaskBits = ALL_COLLISION_CATEGORIES) const;
+
+        /// Return true if a ray hits a shape
+        bool raycastAny(const Ray& ray, collisionmask raycastWithCategoryMaskBits = ALL_COLLISION_CATEGORIES) const;
+
+        /// Fill an array with the proxy shapes whose AABBs overlap with the AABB in parameter
+        uint testAABBOverlap(const AABB& aabb, OverlapHit* hits, uint maxNbHits,
+                             collisionmask categoryMaskBits = ALL_COLLISION_CATEGORIES) const;
+
+        /// Fill an array with the proxy shapes that overlap with a convex shape at a given transform
+        uint testOverlap(const ConvexShape* shape, const Transform& shapeToWorldTransform, OverlapHit* hits,
+                         uint maxNbHits, collisionmask categoryMaskBits = ALL_COLLISION_CATEGORIES) const;
+
+#ifdef IS_PROFILING_ACTIVE
+
+        /// Set the profiler
+        void setProfiler(Profiler* profiler);
+
+#endif
+
+};
+
+// Return the shape of a leaf of the tree
+inline const SceneQuerySnapshot::SnapshotShape& SceneQuerySnapshot::getShape(int nodeId) const {
+    return *static_cast<const SnapshotShape*>(mTree.getNodeDataPointer(nodeId));
+}
+
+// Return the number of proxy shapes in the snapshot
+inline uint SceneQuerySnapshot::getNbProxyShapes() const {
+    return static_cast<uint>(mShapes.size());
+}
+
+#ifdef IS_PROFILING_ACTIVE
+
+// Set the profiler
+inline void SceneQuerySnapshot::setProfiler(Profiler* profiler) {
+    mProfiler = profiler;
+    mTree.setProfiler(profiler);
+    mGJKAlgorithm.setProfiler(profiler);
+}
+
+#endif
+
+}
+
+#endif
@@ -0,0 +1,130 @@
+/********************************************************************************
+* ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
+* Copyright (c) 2010-2018 Daniel Chappuis                                       *
+*********************************************************************************
+*                                                                               *
+* This software is provided 'as-is', without any express or implied warranty.   *
+* In no event will the authors be held liable for any damages arising from the  *
+* use of this software.                                                         *
+*                                                                               *
+* Permission is granted to anyone to use this software for any purpose,         *
+* including commercial applications, and to alter it and redistribute it        *
+* freely, subject to the following restrictions:                                *
+*                                                                               *
+* 1. The origin of this software must not be misrepresented; you must not claim *
+*    that you wrote the original software. If you use this software in a        *
+*    product, an acknowledgment in the product documentation would be           *
+*    appreciated but is not required.                                           *
+*                                                                               *
+* 2. Altered source versions must be plainly marked as such, and must not be    *
+*    misrepresented as being the original software.                             *
+*                                                                               *
+* 3. This notice may not be removed or altered from any source distribution.    *
+*                                                                               *
+********************************************************************************/
+
+#ifndef REACTPHYSICS3D_SWEEP_INFO_H
+#define REACTPHYSICS3D_SWEEP_INFO_H
+
+// Libraries
+#include "mathematics/Vector3.h"
+
+/// ReactPhysics3D namespace
+namespace reactphysics3d {
+
+// Declarations
+class CollisionBody;
+class ProxyShape;
+
+// Structure SweepInfo
+/**
+ * This structure contains the information about a hit of a convex shape swept
+ * between two transforms (see CollisionWorld::sweep()).
+ */
+struct SweepInfo {
+
+    // -------------------- Attributes -------------------- //
+
+    /// Contact point on the hit shape at the time of impact in world-space coordinates
+    Vector3 worldPoint;
+
+    /// Surface normal of the hit shape at the contact point in world-space coordinates
+    /// (the zero vector if the swept shape already overlaps the hit shape at the start)
+    Vector3 worldNormal;
+
+    /// Fraction of the motion when the swept shape touches the hit shape. The transform
+    /// of the swept shape at the impact is the interpolation of the start and end
+    /// transforms at this fraction (the end of the motion if nothing is hit).
+    decimal hitFraction = decimal(1.0);
+
+    /// Pointer to the hit collision body (null if nothing is hit)
+    CollisionBody* body = nullptr;
+
+    /// Pointer to the hit proxy collision shape (null if nothing is hit)
+    ProxyShape* proxyShape = nullptr;
+
+    // -------------------- Methods -------------------- //
+
+    /// Return true if the swept shape has hit a shape
+    bool isHit() const {
+        return proxyShape != nullptr;
+    }
+};
+
+// Class SweepCallback
+/**
+ * This class can be used to register a callback for shape sweep queries.
+ * You should implement your own class inherited from this one and implement
+ * the notifySweepHit() method. This method will be called for each ProxyShape
+ * that is hit by the swept shape.
+ */
+class SweepCallback {
+
+    public:
+
+        // -------------------- Methods -------------------- //
+
+        /// Destructor
+        virtual ~SweepCallback() {
+
+        }
+
+        /// This method will be called for each ProxyShape that is hit by the swept
+        /// shape. You cannot make any assumptions about the order of the calls. The
+        /// returned value controls the continuation of the sweep exactly like the
+        /// value returned by RaycastCallback::notifyRaycastHit(): 0.0 terminates the
+        /// sweep, 1.0 continues it as if no hit occurred, the hit fraction clips the
+        /// motion for the next queries and -1.0 ignores this ProxyShape.
+        /**
+         * @param sweepInfo Information about the sweep hit
+         * @return Value that controls the continuation of the sweep after a hit
+         */
+        virtual decimal notifySweepHit(const SweepInfo& sweepInfo)=0;
+};
+
+// Class SweepClosestHitCallback
+/**
+ * Sweep callback that keeps the earliest hit of a swept shape. It is used by
+ * CollisionWorld::sweepClosest().
+ */
+class SweepClosestHitCallback : public SweepCallback {
+
+    public:
+
+        /// Earliest hit of the swept shape
+        SweepInfo* hit = nullptr;
+
+        /// Keep the hit if it is the earliest one and clip the motion at the hit
+        virtual decimal notifySweepHit(const SweepInfo& sweepInfo) override {
+
+            if (sweepInfo.hitFraction <= hit->hitFraction) {
+                *hit = sweepInfo;
+            }
+
+            return sweepInfo.hitFraction;
+        }
+};
+
+}
+
+#endif
@@ -26,11 +26,321 @@
 // Libraries
 #include "TriangleMesh.h"
 #include "memory/MemoryManager.h"
+#include "collision/TriangleVertexArray.h"
+
+#include <cstring>
+#include <algorithm>
 
 using namespace reactphysics3d;
 
+// Initialization of static variables
+const uint32 TriangleMesh::SERIALIZED_MAGIC = 0x4D545052;    // "RPTM" in little-endian
+const uint32 TriangleMesh::SERIALIZED_VERSION = 1;
+const decimal TriangleMesh::CONVEX_EDGE_MIN_SIN_ANGLE = decimal(0.01);
+const uint TriangleMesh::NO_ADJACENT_TRIANGLE;
+const uint8 TriangleMesh::ALL_EDGES_CONVEX;
+
 // Constructor
 TriangleMesh::TriangleMesh()
-             : mTriangleArrays(MemoryManager::getBaseAllocator()) {
+             : mTriangleArrays(MemoryManager::getBaseAllocator()),
+               mQuantizedBVH(MemoryManager::getBaseAllocator()), mIsBVHBuilt(false),
+               mSubpartsFirstTriangleIds(MemoryManager::getBaseAllocator()),
+               mTrianglesEdgesConvexity(MemoryManager::getBaseAllocator()),
+               mTrianglesAdjacency(MemoryManager::getBaseAllocator()) {
+
+}
+
+// Return the ID of the first triangle of each sub-part and the total number of triangles
+/// The triangles of the mesh are numbered sub-part after sub-part.
+void TriangleMesh::computeSubpartsFirstTriangleIds(List<uint>& outFirstTriangleIds) const {
+
+    outFirstTriangleIds.clear();
+    uint nbTriangles = 0;
+    for (uint subPart=0; subPart < getNbSubparts(); subPart++) {
+        outFirstTriangleIds.add(nbTriangles);
+        nbTriangles += getSubpart(subPart)->getNbTriangles();
+    }
+    outFirstTriangleIds.add(nbTriangles);
+}
+
+// Build the BVH of all the triangles if it has not been built yet
+void TriangleMesh::initBVHIfNecessary() {
+
+    if (mIsBVHBuilt) return;
+
+    // Number the triangles of the mesh sub-part after sub-part
+    computeSubpartsFirstTriangleIds(mSubpartsFirstTriangleIds);
+    const uint nbTriangles = mSubpartsFirstTriangleIds[getNbSubparts()];
+
+    MemoryAllocator& allocator = MemoryManager::getBaseAllocator();
+    AABB* trianglesAABBs = static_cast<AABB*>(allocator.allocate(nbTriangles * sizeof(AABB)));
+
+    // For each sub-part of the mesh
+    for (uint subPart=0; subPart < getNbSubparts(); subPart++) {
+
+        // Get the triangle vertex array of the current sub-part
+        TriangleVertexArray* triangleVertexArray = getSubpart(subPart);
+
+        // For each triangle of the sub-part
+        for (uint triangleIndex=0; triangleIndex < triangleVertexArray->getNbTriangles(); triangleIndex++) {
+
+            // Get the triangle vertices (without scaling)
+            Vector3 trianglePoints[3];
+            triangleVertexArray->getTriangleVertices(triangleIndex, trianglePoints);
+
+            // Create the AABB for the triangle
+            new (trianglesAABBs + mSubpartsFirstTriangleIds[subPart] + triangleIndex)
+                    AABB(AABB::createAABBForTriangle(trianglePoints));
+        }
+    }
+
+    // Build the tree with the AABBs of all the triangles
+    mQuantizedBVH.build(trianglesAABBs, nbTriangles);
+
+    allocator.release(trianglesAABBs, nbTriangles * sizeof(AABB));
+
+    mIsBVHBuilt = true;
+}
+
+// Return the offset of the serialized tree in a serialized BVH of the mesh
+/// The serialized BVH of the mesh starts with a header (magic number, version and number of
+/// sub-parts) followed by the ID of the first triangle of each sub-part and the total number of
+/// triangles. The serialized tree starts at the next multiple of 16 bytes.
+size_t TriangleMesh::getSerializedTreeOffset(uint nbSubparts) {
+    const size_t headerSize = (3 + nbSubparts + 1) * sizeof(uint32);
+    return ((headerSize + 15) / 16) * 16;
+}
+
+// Return the size in bytes of the serialized BVH of the mesh
+/// The BVH is built if it has not been built yet.
+size_t TriangleMesh::getSerializedBVHSizeInBytes() {
+
+    initBVHIfNecessary();
+
+    return getSerializedTreeOffset(getNbSubparts()) + mQuantizedBVH.getSerializedSizeInBytes();
+}
+
+// Write the serialized BVH of the mesh into a buffer
+/**
+ * The BVH is built if it has not been built yet. The serialized BVH does not contain the
+ * triangles of the mesh.
+ * @param buffer Buffer with the size given by getSerializedBVHSizeInBytes()
+ */
+void TriangleMesh::serializeBVH(void* buffer) {
+
+    initBVHIfNecessary();
+
+    unsigned char* bytes = static_cast<unsigned char*>(buffer);
+    const size_t treeOffset = getSerializedTreeOffset(getNbSubparts());
+    std::memset(bytes, 0, treeOffset);
+
+    const uint32 header[3] = {SERIALIZED_MAGIC, SERIALIZED_VERSION, static_cast<uint32>(getNbSubparts())};
+    std::memcpy(bytes, header, sizeof(header));
+    for (uint i=0; i < mSubpartsFirstTriangleIds.size(); i++) {
+        const uint32 firstTriangleId = mSubpartsFirstTriangleIds[i];
+        std::memcpy(bytes + sizeof(header) + i * sizeof(uint32), &firstTriangleId, sizeof(uint32));
+    }
+
+    mQuantizedBVH.serialize(bytes + treeOffset);
+}
+
+// Use a serialized BVH of the mesh instead of building it (the data is not copied)
+/**
+ * The nodes of the BVH are used directly from the serialized data that must therefore stay
+ * valid and aligned on four bytes until the mesh is destroyed. This method must be called
+ * after all the sub-parts have been added and before the first ConcaveMeshShape of the mesh
+ * is created. If it returns false, the BVH will be built as usual.
+ * @param data Pointer to the serialized BVH (created by serializeBVH())
+ * @param sizeInBytes Size of the serialized BVH in bytes
+ * @return True if the serialized BVH has been loaded and false if it was not created with
+ *         this version of the library or for the current sub-parts of the mesh
+ */
+bool TriangleMesh::loadSerializedBVH(const void* data, size_t sizeInBytes) {
+
+    if (mIsBVHBuilt || data == nullptr) return false;
+
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    const size_t treeOffset = getSerializedTreeOffset(getNbSubparts());
+    if (sizeInBytes < treeOffset) return false;
+
+    uint32 header[3];
+    std::memcpy(header, bytes, sizeof(header));
+    if (header[0] != SERIALIZED_MAGIC || header[1] != SERIALIZED_VERSION || header[2] != getNbSubparts()) {
+        return false;
+    }
+
+    // Check that the sub-parts have the same number of triangles as the serialized ones
+    uint nbTriangles = 0;
+    for (uint subPart=0; subPart <= getNbSubparts(); subPart++) {
+        uint32 firstTriangleId;
+        std::memcpy(&firstTriangleId, bytes + sizeof(header) + subPart * sizeof(uint32), sizeof(uint32));
+        if (firstTriangleId != nbTriangles) return false;
+        if (subPart < getNbSubparts()) nbTriangles += getSubpart(subPart)->getNbTriangles();
+    }
+
+    if (!mQuantizedBVH.loadSerialized(bytes + treeOffset, sizeInBytes - treeOffset)) return false;
+
+    if (mQuantizedBVH.getNbTriangles() != nbTriangles) {
+        mQuantizedBVH.build(nullptr, 0);
+        return false;
+    }
+
+    computeSubpartsFirstTriangleIds(mSubpartsFirstTriangleIds);
+
+    mIsBVHBuilt = true;
+
+    return true;
+}
+
+// Edge of a triangle of the mesh used to find the adjacent triangles
+struct TriangleMeshEdge {
+
+    /// Vertices of the edge (the smallest one first)
+    Vector3 vertices[2];
+
+    /// ID of the triangle of the edge in the mesh
+    uint triangleId;
+
+    /// Index of the edge in the triangle
+    uint edgeIndex;
+};
+
+// Return true if a vertex is smaller than another one in the lexicographic order
+static bool isVertexSmaller(const Vector3& vertex1, const Vector3& vertex2) {
+    if (vertex1.x != vertex2.x) return vertex1.x < vertex2.x;
+    if (vertex1.y != vertex2.y) return vertex1.y < vertex2.y;
+    return vertex1.z < vertex2.z;
+}
+
+// Return true if an edge is smaller than another one (by their vertices)
+static bool isEdgeSmaller(const TriangleMeshEdge& edge1, const TriangleMeshEdge& edge2) {
+    if (edge1.vertices[0] != edge2.vertices[0]) return isVertexSmaller(edge1.vertices[0], edge2.vertices[0]);
+    return isVertexSmaller(edge1.vertices[1], edge2.vertices[1]);
+}
+
+// Return true if the edge of a triangle is convex with the adjacent triangle
+/// The edge is convex if the vertex of the adjacent triangle that is not on the edge is
+/// below the plane of the triangle (on the side opposite to its normal) with an angle
+/// larger than the minimum angle of a convex edge or if the adjacent triangle is folded
+/// back over the triangle.
+static bool isEdgeConvex(const Vector3* trianglePoints, uint edgeIndex, const Vector3& adjacentTriangleOppositeVertex,
+                         decimal minSinAngle) {
+
+    const Vector3& edgeStart = trianglePoints[edgeIndex];
+    const Vector3 edge = trianglePoints[(edgeIndex + 1) % 3] - edgeStart;
+    const Vector3 normal = (trianglePoints[1] - trianglePoints[0]).cross(trianglePoints[2] - trianglePoints[0]);
+    const decimal edgeLengthSquare = edge.lengthSquare();
+    const decimal normalLength = normal.length();
+    if (edgeLengthSquare < MACHINE_EPSILON || normalLength < MACHINE_EPSILON) return true;
+
+    // Component of the opposite vertex orthogonal to the edge
+    Vector3 toOppositeVertex = adjacentTriangleOppositeVertex - edgeStart;
+    toOppositeVertex -= edge * (toOppositeVertex.dot(edge) / edgeLengthSquare);
+    const decimal distance = toOppositeVertex.length();
+    if (distance < MACHINE_EPSILON) return true;
+
+    // If the adjacent triangle is folded back over the triangle
+    const Vector3& triangleOppositeVertex = trianglePoints[(edgeIndex + 2) % 3];
+    if (toOppositeVertex.dot(triangleOppositeVertex - edgeStart) > decimal(0.0)) return true;
+
+    return -toOppositeVertex.dot(normal) / (distance * normalLength) > minSinAngle;
+}
+
+// Compute the convexity of the edges and the adjacency of the triangles of the mesh
+/**
+ * This method is meant to be called once when the mesh is cooked, after all the sub-parts have
+ * been added and before the mesh is used for collision detection. Two triangles are adjacent if
+ * they share an edge with the same vertices coordinates (in any sub-part). An edge is convex if
+ * the angle between the planes of its two triangles is convex on the front side of the
+ * triangles. The edges on the boundary of the mesh and the edges shared by more than two
+ * triangles are considered convex. The smooth contact normal is only interpolated on the convex
+ * edges. On the other (internal) edges, the normal of the triangle is used which removes the
+ * bumps when a shape slides over the internal edges of the mesh.
+ */
+void TriangleMesh::computeEdgesConvexity() {
+
+    List<uint> firstTriangleIds(MemoryManager::getBaseAllocator());
+    computeSubpartsFirstTriangleIds(firstTriangleIds);
+    const uint nbTriangles = firstTriangleIds[getNbSubparts()];
+
+    mTrianglesEdgesConvexity.clear();
+    mTrianglesAdjacency.clear();
+    if (nbTriangles == 0) return;
+
+    MemoryAllocator& allocator = MemoryManager::getBaseAllocator();
+    const size_t edgesSizeBytes = 3 * nbTriangles * sizeof(TriangleMeshEdge);
+    TriangleMeshEdge* edges = static_cast<TriangleMeshEdge*>(allocator.allocate(edgesSizeBytes));
+    Vector3* vertices = static_cast<Vector3*>(allocator.allocate(3 * nbTriangles * sizeof(Vector3)));
+
+    // Get the edges of all the triangles
+    for (uint subPart=0; subPart < getNbSubparts(); subPart++) {
+
+        TriangleVertexArray* triangleVertexArray = getSubpart(subPart);
+        for (uint triangleIndex=0; triangleIndex < triangleVertexArray->getNbTriangles(); triangleIndex++) {
+
+            const uint triangleId = firstTriangleIds[subPart] + triangleIndex;
+            Vector3* trianglePoints = vertices + 3 * triangleId;
+            triangleVertexArray->getTriangleVertices(triangleIndex, trianglePoints);
+
+            for (uint e=0; e < 3; e++) {
+                TriangleMeshEdge& edge = edges[3 * triangleId + e];
+                const Vector3& vertex1 = trianglePoints[e];
+                const Vector3& vertex2 = trianglePoints[(e + 1) % 3];
+                const bool isVertex1Smaller = isVertexSmaller(vertex1, vertex2);
+                edge.vertices[0] = isVertex1Smaller ? vertex1 : vertex2;
+                edge.vertices[1] = isVertex1Smaller ? vertex2 : vertex1;
+                edge.triangleId = triangleId;
+                edge.edgeIndex = e;
+            }
+        }
+    }
+
+    // Sort the edges such that the edges with the same vertices are consecutive
+    std::sort(edges, edges + 3 * nbTriangles, isEdgeSmaller);
+
+    mTrianglesEdgesConvexity.reserve(nbTriangles);
+    mTrianglesAdjacency.reserve(3 * nbTriangles);
+    for (uint i=0; i < nbTriangles; i++) {
+        mTrianglesEdgesConvexity.add(ALL_EDGES_CONVEX);
+        for (uint e=0; e < 3; e++) {
+            mTrianglesAdjacency.add(NO_ADJACENT_TRIANGLE);
+        }
+    }
+
+    // For each group of edges with the same vertices
+    uint groupStart = 0;
+    while (groupStart < 3 * nbTriangles) {
+
+        uint groupEnd = groupStart + 1;
+        while (groupEnd < 3 * nbTriangles && edges[groupEnd].vertices[0] == edges[groupStart].vertices[0] &&
+               edges[groupEnd].vertices[1] == edges[groupStart].vertices[1]) {
+            groupEnd++;
+        }
+
+        // Only the edges shared by exactly two triangles can be internal edges
+        if (groupEnd - groupStart == 2) {
+
+            const TriangleMeshEdge& edge1 = edges[groupStart];
+            const TriangleMeshEdge& edge2 = edges[groupStart + 1];
+            mTrianglesAdjacency[3 * edge1.triangleId + edge1.edgeIndex] = edge2.triangleId;
+            mTrianglesAdjacency[3 * edge2.triangleId + edge2.edgeIndex] = edge1.triangleId;
+
+            const Vector3* trianglePoints1 = vertices + 3 * edge1.triangleId;
+            const Vector3* trianglePoints2 = vertices + 3 * edge2.triangleId;
+            const Vector3& oppositeVertex1 = trianglePoints1[(edge1.edgeIndex + 2) % 3];
+            const Vector3& oppositeVertex2 = trianglePoints2[(edge2.edgeIndex + 2) % 3];
+
+            if (!isEdgeConvex(trianglePoints1, edge1.edgeIndex, oppositeVertex2, CONVEX_EDGE_MIN_SIN_ANGLE)) {
+                mTrianglesEdgesConvexity[edge1.triangleId] &= ~uint8(1 << edge1.edgeIndex);
+            }
+            if (!isEdgeConvex(trianglePoints2, edge2.edgeIndex, oppositeVertex1, CONVEX_EDGE_MIN_SIN_ANGLE)) {
+                mTrianglesEdgesConvexity[edge2.triangleId] &= ~uint8(1 << edge2.edgeIndex);
+            }
+        }
+
+        groupStart = groupEnd;
+    }
 
+    allocator.release(vertices, 3 * nbTriangles * sizeof(Vector3));
+    allocator.release(edges, edgesSizeBytes);
 }
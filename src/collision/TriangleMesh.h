@@ -29,6 +29,7 @@
 // Libraries
 #include <cassert>
 #include "containers/List.h"
+#include "collision/QuantizedBVH.h"
 
 namespace reactphysics3d {
 
@@ -42,17 +43,77 @@ class MemoryManager;
  * one or several parts. Each part is a set of triangles represented in a
  * TriangleVertexArray object describing all the triangles vertices of the part.
  * A TriangleMesh object can be used to create a ConcaveMeshShape from a triangle
- * mesh for instance.
+ * mesh for instance. The BVH of the triangles is built (without scaling) when the first
+ * ConcaveMeshShape of the mesh is created and it is shared by all the concave mesh
+ * shapes of the mesh, whatever their scaling. Therefore, all the sub-parts must be
+ * added before the first ConcaveMeshShape is created. The BVH can be serialized
+ * offline with serializeBVH() and loaded with loadSerializedBVH() (for instance from
+ * a memory-mapped file) so that it is not built when the level is loaded. The convexity
+ * of the edges and the adjacency of the triangles can also be precomputed with
+ * computeEdgesConvexity() so that the smooth contact normals of the mesh are not
+ * corrected on its internal (flat or concave) edges.
  */
 class TriangleMesh {
 
     protected:
 
+        // -------------------- Constants -------------------- //
+
+        /// Magic number at the beginning of a serialized BVH of a mesh
+        static const uint32 SERIALIZED_MAGIC;
+
+        /// Version of the format of a serialized BVH of a mesh
+        static const uint32 SERIALIZED_VERSION;
+
+        /// Minimum sine of the angle between the planes of two adjacent triangles for their
+        /// common edge to be convex
+        static const decimal CONVEX_EDGE_MIN_SIN_ANGLE;
+
+        // -------------------- Attributes -------------------- //
+
         /// All the triangle arrays of the mesh (one triangle array per part)
         List<TriangleVertexArray*> mTriangleArrays;
 
+        /// Static quantized BVH of the triangles in the local-space of the mesh (without scaling)
+        QuantizedBVH mQuantizedBVH;
+
+        /// True if the BVH of the triangles has been built
+        bool mIsBVHBuilt;
+
+        /// ID of the first triangle of each sub-part of the mesh (the triangles of the mesh are
+        /// numbered sub-part after sub-part) and total number of triangles at the end
+        List<uint> mSubpartsFirstTriangleIds;
+
+        /// Convexity of the three edges of each triangle (bit i is set if the edge between the
+        /// vertices i and i+1 of the triangle is convex). Empty if it has not been computed
+        List<uint8> mTrianglesEdgesConvexity;
+
+        /// Triangle adjacent to each of the three edges of each triangle (three per triangle)
+        List<uint> mTrianglesAdjacency;
+
+        // -------------------- Methods -------------------- //
+
+        /// Return the ID of the first triangle of each sub-part and the total number of triangles
+        void computeSubpartsFirstTriangleIds(List<uint>& outFirstTriangleIds) const;
+
+        /// Build the BVH of all the triangles if it has not been built yet
+        void initBVHIfNecessary();
+
+        /// Return the offset of the serialized tree in a serialized BVH of the mesh
+        static size_t getSerializedTreeOffset(uint nbSubparts);
+
     public:
 
+        // -------------------- Constants -------------------- //
+
+        /// Adjacent triangle of an edge that is on the boundary of the mesh
+        static const uint NO_ADJACENT_TRIANGLE = ~uint(0);
+
+        /// Convexity flags of a triangle whose three edges are convex
+        static const uint8 ALL_EDGES_CONVEX = 0x7;
+
+        // -------------------- Methods -------------------- //
+
         /// Constructor
         TriangleMesh();
 
@@ -67,6 +128,31 @@ class TriangleMesh {
 
         /// Return the number of subparts of the mesh
         uint getNbSubparts() const;
+
+        /// Return the size in bytes of the serialized BVH of the mesh
+        size_t getSerializedBVHSizeInBytes();
+
+        /// Write the serialized BVH of the mesh into a buffer
+        void serializeBVH(void* buffer);
+
+        /// Use a serialized BVH of the mesh instead of building it (the data is not copied)
+        bool loadSerializedBVH(const void* data, size_t sizeInBytes);
+
+        /// Compute the convexity of the edges and the adjacency of the triangles of the mesh
+        void computeEdgesConvexity();
+
+        /// Return true if the convexity of the edges of the mesh has been computed
+        bool hasEdgesConvexity() const;
+
+        /// Return the convexity flags of the three edges of a triangle of the mesh
+        uint8 getTriangleEdgesConvexity(uint triangleId) const;
+
+        /// Return the triangle adjacent to an edge of a triangle of the mesh
+        uint getAdjacentTriangle(uint triangleId, uint edgeIndex) const;
+
+        // ---------- Friendship ----------- //
+
+        friend class ConcaveMeshShape;
 };
 
 // Add a subpart of the mesh
@@ -74,6 +160,7 @@ class TriangleMesh {
  * @param triangleVertexArray Pointer to the TriangleVertexArray to add into the mesh
  */
 inline void TriangleMesh::addSubpart(TriangleVertexArray* triangleVertexArray) {
+    assert(!mIsBVHBuilt);
     mTriangleArrays.add(triangleVertexArray );
 }
 
@@ -95,6 +182,42 @@ inline uint TriangleMesh::getNbSubparts() const {
     return mTriangleArrays.size();
 }
 
+// Return true if the convexity of the edges of the mesh has been computed
+/**
+ * @return True if computeEdgesConvexity() has been called
+ */
+inline bool TriangleMesh::hasEdgesConvexity() const {
+    return mTrianglesEdgesConvexity.size() > 0;
+}
+
+// Return the convexity flags of the three edges of a triangle of the mesh
+/**
+ * The triangles of the mesh are numbered sub-part after sub-part. The bit i of the flags is
+ * set if the edge between the vertices i and i+1 of the triangle is convex. All the edges are
+ * convex if the convexity of the edges has not been computed.
+ * @param triangleId The ID of the triangle in the mesh
+ * @return The convexity flags of the three edges of the triangle
+ */
+inline uint8 TriangleMesh::getTriangleEdgesConvexity(uint triangleId) const {
+    if (!hasEdgesConvexity()) return ALL_EDGES_CONVEX;
+    assert(triangleId < mTrianglesEdgesConvexity.size());
+    return mTrianglesEdgesConvexity[triangleId];
+}
+
+// Return the triangle adjacent to an edge of a triangle of the mesh
+/**
+ * The convexity of the edges must have been computed with computeEdgesConvexity().
+ * @param triangleId The ID of the triangle in the mesh
+ * @param edgeIndex Index of the edge between the vertices edgeIndex and edgeIndex+1 of the triangle
+ * @return The ID of the adjacent triangle or NO_ADJACENT_TRIANGLE if the edge is on the boundary
+ *         of the mesh or shared by more than two triangles
+ */
+inline uint TriangleMesh::getAdjacentTriangle(uint triangleId, uint edgeIndex) const {
+    assert(hasEdgesConvexity());
+    assert(edgeIndex < 3);
+    return mTrianglesAdjacency[3 * triangleId + edgeIndex];
+}
+
 }
 
 #endif
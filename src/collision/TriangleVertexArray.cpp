@@ -27,9 +27,73 @@
 #include "TriangleVertexArray.h"
 #include "mathematics/Vector3.h"
 #include <cassert>
+#include <cmath>
 
 using namespace reactphysics3d;
 
+// Read the coordinates of a vertex (or a normal) stored with a given data type
+template<TriangleVertexArray::VertexDataType vertexDataType>
+static void readVertex(const uchar* vertexPointer, const TriangleVertexArray::VerticesQuantization& quantization,
+                       Vector3& outVertex) {
+
+    const void* pointer = static_cast<const void*>(vertexPointer);
+
+    if (vertexDataType == TriangleVertexArray::VertexDataType::VERTEX_FLOAT_TYPE) {
+        const float* vertex = static_cast<const float*>(pointer);
+        outVertex.setAllValues(decimal(vertex[0]), decimal(vertex[1]), decimal(vertex[2]));
+    }
+    else if (vertexDataType == TriangleVertexArray::VertexDataType::VERTEX_DOUBLE_TYPE) {
+        const double* vertex = static_cast<const double*>(pointer);
+        outVertex.setAllValues(decimal(vertex[0]), decimal(vertex[1]), decimal(vertex[2]));
+    }
+    else {
+        const uint16* vertex = static_cast<const uint16*>(pointer);
+        outVertex.setAllValues(decimal(quantization.origin[0] + vertex[0] * quantization.scale[0]),
+                               decimal(quantization.origin[1] + vertex[1] * quantization.scale[1]),
+                               decimal(quantization.origin[2] + vertex[2] * quantization.scale[2]));
+    }
+}
+
+// Read a vertex normal stored with a given data type
+template<TriangleVertexArray::NormalDataType normalDataType>
+static void readNormal(const uchar* normalPointer, Vector3& outNormal) {
+
+    const void* pointer = static_cast<const void*>(normalPointer);
+
+    if (normalDataType == TriangleVertexArray::NormalDataType::NORMAL_FLOAT_TYPE) {
+        const float* normal = static_cast<const float*>(pointer);
+        outNormal.setAllValues(decimal(normal[0]), decimal(normal[1]), decimal(normal[2]));
+    }
+    else if (normalDataType == TriangleVertexArray::NormalDataType::NORMAL_DOUBLE_TYPE) {
+        const double* normal = static_cast<const double*>(pointer);
+        outNormal.setAllValues(decimal(normal[0]), decimal(normal[1]), decimal(normal[2]));
+    }
+    else {
+
+        // Decode the octahedral normal (the lower half of the octahedron is folded
+        // over the upper half)
+        const int16* encodedNormal = static_cast<const int16*>(pointer);
+        decimal x = decimal(encodedNormal[0]) / decimal(32767.0);
+        decimal y = decimal(encodedNormal[1]) / decimal(32767.0);
+        const decimal z = decimal(1.0) - std::abs(x) - std::abs(y);
+        const decimal fold = std::max(-z, decimal(0.0));
+        x += x >= decimal(0.0) ? -fold : fold;
+        y += y >= decimal(0.0) ? -fold : fold;
+        outNormal.setAllValues(x, y, z);
+        outNormal.normalize();
+    }
+}
+
+// Read the three vertex indices of a triangle stored with a given data type
+template<typename IndexType>
+static void readTriangleIndices(const uchar* triangleIndicesPointer, uint* outVerticesIndices) {
+
+    const IndexType* indices = static_cast<const IndexType*>(static_cast<const void*>(triangleIndicesPointer));
+    outVerticesIndices[0] = indices[0];
+    outVerticesIndices[1] = indices[1];
+    outVerticesIndices[2] = indices[2];
+}
+
 // Constructor without vertices normals
 /// Note that your data will not be copied into the TriangleVertexArray and
 /// therefore, you need to make sure that those data are always valid during
@@ -45,12 +109,15 @@ using namespace reactphysics3d;
  * @param nbTriangles Number of triangles in the array
  * @param indexesStart Pointer to the first triangle index
  * @param indexesStride Number of bytes between the beginning of the three indices of two triangles
- * @param vertexDataType Type of data for the vertices (float, double)
+ * @param vertexDataType Type of data for the vertices (float, double, quantized short)
  * @param indexDataType Type of data for the indices (short, int)
+ * @param verticesQuantization Origin and scale of the quantized vertices (only for the
+ *                             VERTEX_QUANTIZED_SHORT_TYPE data type)
  */
 TriangleVertexArray::TriangleVertexArray(uint nbVertices, const void* verticesStart, uint verticesStride,
                                          uint nbTriangles, const void* indexesStart, uint indexesStride,
-                                         VertexDataType vertexDataType, IndexDataType indexDataType) {
+                                         VertexDataType vertexDataType, IndexDataType indexDataType,
+                                         const VerticesQuantization* verticesQuantization) {
     mNbVertices = nbVertices;
     mVerticesStart = static_cast<const uchar*>(verticesStart);
     mVerticesStride = verticesStride;
@@ -63,6 +130,15 @@ TriangleVertexArray::TriangleVertexArray(uint nbVertices, const void* verticesSt
     mVertexNormaldDataType = NormalDataType::NORMAL_FLOAT_TYPE;
     mIndexDataType = indexDataType;
     mAreVerticesNormalsProvidedByUser = false;
+    initVerticesQuantization(verticesQuantization);
+
+    // The computed normals of the quantized vertices are stored with the octahedral encoding
+    if (mVertexDataType == VertexDataType::VERTEX_QUANTIZED_SHORT_TYPE) {
+        mVertexNormaldDataType = NormalDataType::NORMAL_OCTAHEDRAL_SHORT_TYPE;
+        mVerticesNormalsStride = 2 * sizeof(int16);
+    }
+
+    initTriangleMethods();
 
     // Compute the vertices normals because they are not provided by the user
     computeVerticesNormals();
@@ -82,14 +158,17 @@ TriangleVertexArray::TriangleVertexArray(uint nbVertices, const void* verticesSt
  * @param nbTriangles Number of triangles in the array
  * @param indexesStart Pointer to the first triangle index
  * @param indexesStride Number of bytes between the beginning of two consecutive triangle indices
- * @param vertexDataType Type of data for the vertices (float, double)
+ * @param vertexDataType Type of data for the vertices (float, double, quantized short)
+ * @param normalDataType Type of data for the vertex normals (float, double, octahedral short)
  * @param indexDataType Type of data for the indices (short, int)
+ * @param verticesQuantization Origin and scale of the quantized vertices (only for the
+ *                             VERTEX_QUANTIZED_SHORT_TYPE data type)
  */
 TriangleVertexArray::TriangleVertexArray(uint nbVertices, const void* verticesStart, uint verticesStride,
                                          const void* verticesNormalsStart, uint verticesNormalsStride,
                                          uint nbTriangles, const void* indexesStart, uint indexesStride,
                                          VertexDataType vertexDataType, NormalDataType normalDataType,
-                                         IndexDataType indexDataType) {
+                                         IndexDataType indexDataType, const VerticesQuantization* verticesQuantization) {
 
     mNbVertices = nbVertices;
     mVerticesStart = static_cast<const uchar*>(verticesStart);
@@ -103,6 +182,9 @@ TriangleVertexArray::TriangleVertexArray(uint nbVertices, const void* verticesSt
     mVertexNormaldDataType = normalDataType;
     mIndexDataType = indexDataType;
     mAreVerticesNormalsProvidedByUser = true;
+    initVerticesQuantization(verticesQuantization);
+
+    initTriangleMethods();
 
     assert(mVerticesNormalsStart != nullptr);
 }
@@ -115,15 +197,110 @@ TriangleVertexArray::~TriangleVertexArray() {
 
         // Release the allocated memory
         const void* verticesNormalPointer = static_cast<const void*>(mVerticesNormalsStart);
-        const float* verticesNormals = static_cast<const float*>(verticesNormalPointer);
-        delete[] verticesNormals;
+        if (mVertexNormaldDataType == NormalDataType::NORMAL_OCTAHEDRAL_SHORT_TYPE) {
+            delete[] static_cast<const int16*>(verticesNormalPointer);
+        }
+        else {
+            delete[] static_cast<const float*>(verticesNormalPointer);
+        }
+    }
+}
+
+// Copy the origin and scale of the quantized vertices
+void TriangleVertexArray::initVerticesQuantization(const VerticesQuantization* verticesQuantization) {
+
+    assert(mVertexDataType != VertexDataType::VERTEX_QUANTIZED_SHORT_TYPE || verticesQuantization != nullptr);
+
+    for (int i=0; i < 3; i++) {
+        mVerticesQuantization.origin[i] = verticesQuantization != nullptr ? verticesQuantization->origin[i] : 0.0f;
+        mVerticesQuantization.scale[i] = verticesQuantization != nullptr ? verticesQuantization->scale[i] : 1.0f;
+    }
+}
+
+// Select the methods that return the vertices and normals of a triangle
+/// The methods are specialized for the data types of the array so that the type of the data is
+/// not checked again each time a vertex or a normal is read.
+void TriangleVertexArray::initTriangleMethods() {
+
+    if (mIndexDataType == IndexDataType::INDEX_INTEGER_TYPE) {
+        initTriangleMethodsForIndexType<uint>();
+    }
+    else {
+        initTriangleMethodsForIndexType<ushort>();
+    }
+}
+
+// Select the methods that return the vertices and normals of a triangle for an index type
+template<typename IndexType>
+void TriangleVertexArray::initTriangleMethodsForIndexType() {
+
+    switch (mVertexDataType) {
+        case VertexDataType::VERTEX_FLOAT_TYPE:
+            mGetTriangleVerticesMethod = &TriangleVertexArray::getTriangleVerticesOfTypes<IndexType,
+                                             VertexDataType::VERTEX_FLOAT_TYPE>;
+            break;
+        case VertexDataType::VERTEX_DOUBLE_TYPE:
+            mGetTriangleVerticesMethod = &TriangleVertexArray::getTriangleVerticesOfTypes<IndexType,
+                                             VertexDataType::VERTEX_DOUBLE_TYPE>;
+            break;
+        case VertexDataType::VERTEX_QUANTIZED_SHORT_TYPE:
+            mGetTriangleVerticesMethod = &TriangleVertexArray::getTriangleVerticesOfTypes<IndexType,
+                                             VertexDataType::VERTEX_QUANTIZED_SHORT_TYPE>;
+            break;
+    }
+
+    switch (mVertexNormaldDataType) {
+        case NormalDataType::NORMAL_FLOAT_TYPE:
+            mGetTriangleVerticesNormalsMethod = &TriangleVertexArray::getTriangleVerticesNormalsOfTypes<IndexType,
+                                                    NormalDataType::NORMAL_FLOAT_TYPE>;
+            break;
+        case NormalDataType::NORMAL_DOUBLE_TYPE:
+            mGetTriangleVerticesNormalsMethod = &TriangleVertexArray::getTriangleVerticesNormalsOfTypes<IndexType,
+                                                    NormalDataType::NORMAL_DOUBLE_TYPE>;
+            break;
+        case NormalDataType::NORMAL_OCTAHEDRAL_SHORT_TYPE:
+            mGetTriangleVerticesNormalsMethod = &TriangleVertexArray::getTriangleVerticesNormalsOfTypes<IndexType,
+                                                    NormalDataType::NORMAL_OCTAHEDRAL_SHORT_TYPE>;
+            break;
+    }
+}
+
+// Return the three vertices of a triangle for given index and vertex data types
+template<typename IndexType, TriangleVertexArray::VertexDataType vertexDataType>
+void TriangleVertexArray::getTriangleVerticesOfTypes(uint triangleIndex, Vector3* outTriangleVertices) const {
+
+    assert(triangleIndex < mNbTriangles);
+
+    uint verticesIndices[3];
+    readTriangleIndices<IndexType>(mIndicesStart + triangleIndex * mIndicesStride, verticesIndices);
+
+    for (int k=0; k < 3; k++) {
+        readVertex<vertexDataType>(mVerticesStart + verticesIndices[k] * mVerticesStride, mVerticesQuantization,
+                                   outTriangleVertices[k]);
+    }
+}
+
+// Return the three vertices normals of a triangle for given index and normal data types
+template<typename IndexType, TriangleVertexArray::NormalDataType normalDataType>
+void TriangleVertexArray::getTriangleVerticesNormalsOfTypes(uint triangleIndex,
+                                                            Vector3* outTriangleVerticesNormals) const {
+
+    assert(triangleIndex < mNbTriangles);
+
+    uint verticesIndices[3];
+    readTriangleIndices<IndexType>(mIndicesStart + triangleIndex * mIndicesStride, verticesIndices);
+
+    for (int k=0; k < 3; k++) {
+        readNormal<normalDataType>(mVerticesNormalsStart + verticesIndices[k] * mVerticesNormalsStride,
+                                   outTriangleVerticesNormals[k]);
     }
 }
 
 // Compute the vertices normals when they are not provided by the user
 /// The vertices normals are computed with weighted average of the associated
 /// triangle face normal. The weights are the angle between the associated edges
-/// of neighbor triangle face.
+/// of neighbor triangle face. The normals of the quantized vertices are stored with
+/// the octahedral encoding (four bytes per normal).
 void TriangleVertexArray::computeVerticesNormals() {
 
     // Allocate memory for the vertices normals
@@ -185,7 +362,20 @@ void TriangleVertexArray::computeVerticesNormals() {
         verticesNormals[v + 2] = normal.z;
     }
 
+    // The normals of the quantized vertices are stored with the octahedral encoding
     const void* verticesNormalsPointer = static_cast<const void*>(verticesNormals);
+    if (mVertexNormaldDataType == NormalDataType::NORMAL_OCTAHEDRAL_SHORT_TYPE) {
+
+        int16* encodedNormals = new int16[mNbVertices * 2];
+        for (uint v=0; v < mNbVertices; v++) {
+            const Vector3 normal(verticesNormals[3 * v], verticesNormals[3 * v + 1], verticesNormals[3 * v + 2]);
+            encodeOctahedralNormal(normal, encodedNormals + 2 * v);
+        }
+        delete[] verticesNormals;
+
+        verticesNormalsPointer = static_cast<const void*>(encodedNormals);
+    }
+
     mVerticesNormalsStart = static_cast<const uchar*>(verticesNormalsPointer);
 }
 
@@ -199,97 +389,12 @@ void TriangleVertexArray::getTriangleVerticesIndices(uint triangleIndex, uint* o
     assert(triangleIndex >= 0 && triangleIndex < mNbTriangles);
 
     const uchar* triangleIndicesPointer = mIndicesStart + triangleIndex * mIndicesStride;
-    const void* startTriangleIndices = static_cast<const void*>(triangleIndicesPointer);
-
-    // For each vertex of the triangle
-    for (int i=0; i < 3; i++) {
-
-        // Get the index of the current vertex in the triangle
-        if (mIndexDataType == TriangleVertexArray::IndexDataType::INDEX_INTEGER_TYPE) {
-            outVerticesIndices[i] = static_cast<const uint*>(startTriangleIndices)[i];
-        }
-        else if (mIndexDataType == TriangleVertexArray::IndexDataType::INDEX_SHORT_TYPE) {
-            outVerticesIndices[i] = static_cast<const ushort*>(startTriangleIndices)[i];
-        }
-        else {
-            assert(false);
-        }
-    }
-}
-
-// Return the three vertices coordinates of a triangle
-/**
- * @param triangleIndex Index of a given triangle in the array
- * @param[out] outTriangleVertices Pointer to the three output vertex coordinates
- */
-void TriangleVertexArray::getTriangleVertices(uint triangleIndex, Vector3* outTriangleVertices) const {
 
-    assert(triangleIndex >= 0 && triangleIndex < mNbTriangles);
-
-    // Get the three vertex index of the three vertices of the triangle
-    uint verticesIndices[3];
-    getTriangleVerticesIndices(triangleIndex, verticesIndices);
-
-    // For each vertex of the triangle
-    for (int k=0; k < 3; k++) {
-
-        const uchar* vertexPointerChar = mVerticesStart + verticesIndices[k] * mVerticesStride;
-        const void* vertexPointer = static_cast<const void*>(vertexPointerChar);
-
-        // Get the vertices components of the triangle
-        if (mVertexDataType == TriangleVertexArray::VertexDataType::VERTEX_FLOAT_TYPE) {
-            const float* vertices = static_cast<const float*>(vertexPointer);
-            outTriangleVertices[k][0] = decimal(vertices[0]);
-            outTriangleVertices[k][1] = decimal(vertices[1]);
-            outTriangleVertices[k][2] = decimal(vertices[2]);
-        }
-        else if (mVertexDataType == TriangleVertexArray::VertexDataType::VERTEX_DOUBLE_TYPE) {
-            const double* vertices = static_cast<const double*>(vertexPointer);
-            outTriangleVertices[k][0] = decimal(vertices[0]);
-            outTriangleVertices[k][1] = decimal(vertices[1]);
-            outTriangleVertices[k][2] = decimal(vertices[2]);
-        }
-        else {
-            assert(false);
-        }
+    if (mIndexDataType == TriangleVertexArray::IndexDataType::INDEX_INTEGER_TYPE) {
+        readTriangleIndices<uint>(triangleIndicesPointer, outVerticesIndices);
     }
-}
-
-// Return the three vertices normals of a triangle
-/**
- * @param triangleIndex Index of a given triangle in the array
- * @param[out] outTriangleVerticesNormals Pointer to the three output vertex normals
- */
-void TriangleVertexArray::getTriangleVerticesNormals(uint triangleIndex, Vector3* outTriangleVerticesNormals) const {
-
-    assert(triangleIndex >= 0 && triangleIndex < mNbTriangles);
-
-    // Get the three vertex index of the three vertices of the triangle
-    uint verticesIndices[3];
-    getTriangleVerticesIndices(triangleIndex, verticesIndices);
-
-    // For each vertex of the triangle
-    for (int k=0; k < 3; k++) {
-
-        const uchar* vertexNormalPointerChar = mVerticesNormalsStart + verticesIndices[k] * mVerticesNormalsStride;
-        const void* vertexNormalPointer = static_cast<const void*>(vertexNormalPointerChar);
-
-        // Get the normals from the array
-        if (mVertexNormaldDataType == TriangleVertexArray::NormalDataType::NORMAL_FLOAT_TYPE) {
-            const float* normal = static_cast<const float*>(vertexNormalPointer);
-            outTriangleVerticesNormals[k][0] = decimal(normal[0]);
-            outTriangleVerticesNormals[k][1] = decimal(normal[1]);
-            outTriangleVerticesNormals[k][2] = decimal(normal[2]);
-        }
-        else if (mVertexNormaldDataType == TriangleVertexArray::NormalDataType::NORMAL_DOUBLE_TYPE) {
-            const double* normal = static_cast<const double*>(vertexNormalPointer);
-            outTriangleVerticesNormals[k][0] = decimal(normal[0]);
-            outTriangleVerticesNormals[k][1] = decimal(normal[1]);
-            outTriangleVerticesNormals[k][2] = decimal(normal[2]);
-        }
-        else {
-            assert(false);
-        }
+    else {
+        readTriangleIndices<ushort>(triangleIndicesPointer, outVerticesIndices);
     }
 }
 
@@ -302,24 +407,18 @@ void TriangleVertexArray::getVertex(uint vertexIndex, Vector3* outVertex) {
 
     assert(vertexIndex < mNbVertices);
 
-    const uchar* vertexPointerChar = mVerticesStart + vertexIndex * mVerticesStride;
-    const void* vertexPointer = static_cast<const void*>(vertexPointerChar);
-
-    // Get the vertices components of the triangle
-    if (mVertexDataType == TriangleVertexArray::VertexDataType::VERTEX_FLOAT_TYPE) {
-        const float* vertices = static_cast<const float*>(vertexPointer);
-        (*outVertex)[0] = decimal(vertices[0]);
-        (*outVertex)[1] = decimal(vertices[1]);
-        (*outVertex)[2] = decimal(vertices[2]);
-    }
-    else if (mVertexDataType == TriangleVertexArray::VertexDataType::VERTEX_DOUBLE_TYPE) {
-        const double* vertices = static_cast<const double*>(vertexPointer);
-        (*outVertex)[0] = decimal(vertices[0]);
-        (*outVertex)[1] = decimal(vertices[1]);
-        (*outVertex)[2] = decimal(vertices[2]);
-    }
-    else {
-        assert(false);
+    const uchar* vertexPointer = mVerticesStart + vertexIndex * mVerticesStride;
+
+    switch (mVertexDataType) {
+        case VertexDataType::VERTEX_FLOAT_TYPE:
+            readVertex<VertexDataType::VERTEX_FLOAT_TYPE>(vertexPointer, mVerticesQuantization, *outVertex);
+            break;
+        case VertexDataType::VERTEX_DOUBLE_TYPE:
+            readVertex<VertexDataType::VERTEX_DOUBLE_TYPE>(vertexPointer, mVerticesQuantization, *outVertex);
+            break;
+        case VertexDataType::VERTEX_QUANTIZED_SHORT_TYPE:
+            readVertex<VertexDataType::VERTEX_QUANTIZED_SHORT_TYPE>(vertexPointer, mVerticesQuantization, *outVertex);
+            break;
     }
 }
 
@@ -332,23 +431,58 @@ void TriangleVertexArray::getNormal(uint vertexIndex, Vector3* outNormal) {
 
     assert(vertexIndex < mNbVertices);
 
-    const uchar* vertexNormalPointerChar = mVerticesNormalsStart + vertexIndex * mVerticesNormalsStride;
-    const void* vertexNormalPointer = static_cast<const void*>(vertexNormalPointerChar);
-
-    // Get the normals from the array
-    if (mVertexNormaldDataType == TriangleVertexArray::NormalDataType::NORMAL_FLOAT_TYPE) {
-        const float* normal = static_cast<const float*>(vertexNormalPointer);
-        (*outNormal)[0] = decimal(normal[0]);
-        (*outNormal)[1] = decimal(normal[1]);
-        (*outNormal)[2] = decimal(normal[2]);
+    const uchar* vertexNormalPointer = mVerticesNormalsStart + vertexIndex * mVerticesNormalsStride;
+
+    switch (mVertexNormaldDataType) {
+        case NormalDataType::NORMAL_FLOAT_TYPE:
+            readNormal<NormalDataType::NORMAL_FLOAT_TYPE>(vertexNormalPointer, *outNormal);
+            break;
+        case NormalDataType::NORMAL_DOUBLE_TYPE:
+            readNormal<NormalDataType::NORMAL_DOUBLE_TYPE>(vertexNormalPointer, *outNormal);
+            break;
+        case NormalDataType::NORMAL_OCTAHEDRAL_SHORT_TYPE:
+            readNormal<NormalDataType::NORMAL_OCTAHEDRAL_SHORT_TYPE>(vertexNormalPointer, *outNormal);
+            break;
     }
-    else if (mVertexNormaldDataType == TriangleVertexArray::NormalDataType::NORMAL_DOUBLE_TYPE) {
-        const double* normal = static_cast<const double*>(vertexNormalPointer);
-        (*outNormal)[0] = decimal(normal[0]);
-        (*outNormal)[1] = decimal(normal[1]);
-        (*outNormal)[2] = decimal(normal[2]);
+}
+
+// Quantize the coordinates of a vertex for the VERTEX_QUANTIZED_SHORT_TYPE data type
+/**
+ * @param vertex Coordinates of the vertex
+ * @param verticesQuantization Origin and scale of the quantized vertices of the array
+ * @param[out] outQuantizedVertex Pointer to the three output quantized coordinates
+ */
+void TriangleVertexArray::quantizeVertex(const Vector3& vertex, const VerticesQuantization& verticesQuantization,
+                                         uint16* outQuantizedVertex) {
+
+    for (int i=0; i < 3; i++) {
+        const decimal value = verticesQuantization.scale[i] > 0.0f ?
+                                  (vertex[i] - verticesQuantization.origin[i]) / verticesQuantization.scale[i] :
+                                  decimal(0.0);
+        outQuantizedVertex[i] = static_cast<uint16>(clamp(std::round(value), decimal(0.0), decimal(65535.0)));
     }
-    else {
-        assert(false);
+}
+
+// Encode a unit normal for the NORMAL_OCTAHEDRAL_SHORT_TYPE data type
+/// The normal is projected on the octahedron |x| + |y| + |z| = 1 whose lower half is folded over
+/// its upper half and the two coordinates in the plane z = 0 are stored with 16-bit integers.
+/**
+ * @param normal Unit normal to encode
+ * @param[out] outEncodedNormal Pointer to the two output encoded coordinates
+ */
+void TriangleVertexArray::encodeOctahedralNormal(const Vector3& normal, int16* outEncodedNormal) {
+
+    const decimal length = std::abs(normal.x) + std::abs(normal.y) + std::abs(normal.z);
+    decimal x = length > MACHINE_EPSILON ? normal.x / length : decimal(0.0);
+    decimal y = length > MACHINE_EPSILON ? normal.y / length : decimal(0.0);
+
+    if (normal.z < decimal(0.0)) {
+        const decimal foldedX = (decimal(1.0) - std::abs(y)) * (x >= decimal(0.0) ? decimal(1.0) : decimal(-1.0));
+        const decimal foldedY = (decimal(1.0) - std::abs(x)) * (y >= decimal(0.0) ? decimal(1.0) : decimal(-1.0));
+        x = foldedX;
+        y = foldedY;
     }
+
+    outEncodedNormal[0] = static_cast<int16>(std::round(clamp(x, decimal(-1.0), decimal(1.0)) * decimal(32767.0)));
+    outEncodedNormal[1] = static_cast<int16>(std::round(clamp(y, decimal(-1.0), decimal(1.0)) * decimal(32767.0)));
 }
@@ -48,15 +48,32 @@ class TriangleVertexArray {
 
     public:
 
-        /// Data type for the vertices in the array
-        enum class VertexDataType {VERTEX_FLOAT_TYPE, VERTEX_DOUBLE_TYPE};
+        /// Data type for the vertices in the array (the quantized vertices are three
+        /// unsigned 16-bit integers dequantized with a VerticesQuantization)
+        enum class VertexDataType {VERTEX_FLOAT_TYPE, VERTEX_DOUBLE_TYPE, VERTEX_QUANTIZED_SHORT_TYPE};
 
-        /// Data type for the vertex normals in the array
-        enum class NormalDataType {NORMAL_FLOAT_TYPE, NORMAL_DOUBLE_TYPE};
+        /// Data type for the vertex normals in the array (the octahedral normals are two
+        /// signed 16-bit integers of the octahedral encoding of the normal)
+        enum class NormalDataType {NORMAL_FLOAT_TYPE, NORMAL_DOUBLE_TYPE, NORMAL_OCTAHEDRAL_SHORT_TYPE};
 
         /// Data type for the indices in the array
         enum class IndexDataType {INDEX_INTEGER_TYPE, INDEX_SHORT_TYPE};
 
+        /// Origin and scale of the vertices of the VERTEX_QUANTIZED_SHORT_TYPE data type (the
+        /// coordinates of a vertex are origin + quantizedCoordinates * scale)
+        struct VerticesQuantization {
+
+            /// Coordinates of the vertex with quantized coordinates (0, 0, 0)
+            float origin[3];
+
+            /// Size of a quantization step along each axis
+            float scale[3];
+        };
+
+        /// Type of the methods that return the three vertices (or vertices normals) of a triangle
+        using TriangleVectorsMethod = void (TriangleVertexArray::*)(uint triangleIndex,
+                                                                    Vector3* outTriangleVectors) const;
+
     protected:
 
         // -------------------- Attributes -------------------- //
@@ -99,11 +116,38 @@ class TriangleVertexArray {
         /// True if the vertices normals are provided by the user
         bool mAreVerticesNormalsProvidedByUser;
 
+        /// Origin and scale of the quantized vertices
+        VerticesQuantization mVerticesQuantization;
+
+        /// Method that returns the vertices of a triangle for the data types of the array
+        TriangleVectorsMethod mGetTriangleVerticesMethod;
+
+        /// Method that returns the vertices normals of a triangle for the data types of the array
+        TriangleVectorsMethod mGetTriangleVerticesNormalsMethod;
+
         // -------------------- Methods -------------------- //
 
         /// Compute the vertices normals when they are not provided by the user
         void computeVerticesNormals();
 
+        /// Copy the origin and scale of the quantized vertices
+        void initVerticesQuantization(const VerticesQuantization* verticesQuantization);
+
+        /// Select the methods that return the vertices and normals of a triangle
+        void initTriangleMethods();
+
+        /// Select the methods that return the vertices and normals of a triangle for an index type
+        template<typename IndexType>
+        void initTriangleMethodsForIndexType();
+
+        /// Return the three vertices of a triangle for given index and vertex data types
+        template<typename IndexType, VertexDataType vertexDataType>
+        void getTriangleVerticesOfTypes(uint triangleIndex, Vector3* outTriangleVertices) const;
+
+        /// Return the three vertices normals of a triangle for given index and normal data types
+        template<typename IndexType, NormalDataType normalDataType>
+        void getTriangleVerticesNormalsOfTypes(uint triangleIndex, Vector3* outTriangleVerticesNormals) const;
+
     public:
 
         // -------------------- Methods -------------------- //
@@ -111,14 +155,15 @@ class TriangleVertexArray {
         /// Constructor without vertices normals
         TriangleVertexArray(uint nbVertices, const void* verticesStart, uint verticesStride,
                             uint nbTriangles, const void* indexesStart, uint indexesStride,
-                            VertexDataType vertexDataType, IndexDataType indexDataType);
+                            VertexDataType vertexDataType, IndexDataType indexDataType,
+                            const VerticesQuantization* verticesQuantization = nullptr);
 
         /// Constructor with vertices normals
         TriangleVertexArray(uint nbVertices, const void* verticesStart, uint verticesStride,
                             const void* verticesNormalsStart, uint uverticesNormalsStride,
                             uint nbTriangles, const void* indexesStart, uint indexesStride,
                             VertexDataType vertexDataType, NormalDataType normalDataType,
-                            IndexDataType indexDataType);
+                            IndexDataType indexDataType, const VerticesQuantization* verticesQuantization = nullptr);
 
         /// Destructor
         ~TriangleVertexArray();
@@ -176,8 +221,34 @@ class TriangleVertexArray {
 
         /// Return a vertex normal of the array
         void getNormal(uint vertexIndex, Vector3* outNormal);
+
+        /// Quantize the coordinates of a vertex for the VERTEX_QUANTIZED_SHORT_TYPE data type
+        static void quantizeVertex(const Vector3& vertex, const VerticesQuantization& verticesQuantization,
+                                   uint16* outQuantizedVertex);
+
+        /// Encode a unit normal for the NORMAL_OCTAHEDRAL_SHORT_TYPE data type
+        static void encodeOctahedralNormal(const Vector3& normal, int16* outEncodedNormal);
 };
 
+// Return the vertices coordinates of a triangle
+/**
+ * @param triangleIndex Index of a given triangle in the array
+ * @param[out] outTriangleVertices Pointer to the three output vertex coordinates
+ */
+inline void TriangleVertexArray::getTriangleVertices(uint triangleIndex, Vector3* outTriangleVertices) const {
+    (this->*mGetTriangleVerticesMethod)(triangleIndex, outTriangleVertices);
+}
+
+// Return the three vertices normals of a triangle
+/**
+ * @param triangleIndex Index of a given triangle in the array
+ * @param[out] outTriangleVerticesNormals Pointer to the three output vertex normals
+ */
+inline void TriangleVertexArray::getTriangleVerticesNormals(uint triangleIndex,
+                                                            Vector3* outTriangleVerticesNormals) const {
+    (this->*mGetTriangleVerticesNormalsMethod)(triangleIndex, outTriangleVerticesNormals);
+}
+
 // Return the vertex data type
 /**
  * @return The data type of the vertices in the array
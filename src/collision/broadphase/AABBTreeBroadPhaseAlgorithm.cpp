@@ -0,0 +1,552 @@
+/********************************************************************************
+* ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
+* Copyright (c) 2010-2018 Daniel Chappuis                                       *
+*********************************************************************************
+*                                                                               *
+* This software is provided 'as-is', without any express or implied warranty.   *
+* In no event will the authors be held liable for any damages arising from the  *
+* use of this software.                                                         *
+*                                                                               *
+* Permission is granted to anyone to use this software for any purpose,         *
+* including commercial applications, and to alter it and redistribute it        *
+* freely, subject to the following restrictions:                                *
+*                                                                               *
+* 1. The origin of this software must not be misrepresented; you must not claim *
+*    that you wrote the original software. If you use this software in a        *
+*    product, an acknowledgment in the product documentation would be           *
+*    appreciated but is not required.                                           *
+*                                                                               *
+* 2. Altered source versions must be plainly marked as such, and must not be    *
+*    misrepresented as being the original software.                             *
+*                                                                               *
+* 3. This notice may not be removed or altered from any source distribution.    *
+*                                                                               *
+********************************************************************************/
+
+// Libraries
+#include "AABBTreeBroadPhaseAlgorithm.h"
+#include "collision/CollisionDetection.h"
+#include "collision/RaycastInfo.h"
+#include "utils/Profiler.h"
+#include "memory/MemoryManager.h"
+#include "engine/Timer.h"
+#include <algorithm>
+
+// We want to use the ReactPhysics3D namespace
+using namespace reactphysics3d;
+
+// Constructor
+AABBTreeBroadPhaseAlgorithm::AABBTreeBroadPhaseAlgorithm(CollisionDetection& collisionDetection,
+                                                         const WorldSettings& worldSettings)
+                    :BroadPhaseAlgorithm(collisionDetection, worldSettings),
+                     mDynamicAABBTree(collisionDetection.getMemoryManager().getPoolAllocator(MemoryTag::BroadPhase), DYNAMIC_TREE_AABB_GAP),
+                     mStaticAABBTree(collisionDetection.getMemoryManager().getPoolAllocator(MemoryTag::BroadPhase), DYNAMIC_TREE_AABB_GAP),
+                     mWideAABBTree(collisionDetection.getMemoryManager().getPoolAllocator(MemoryTag::BroadPhase)),
+                     mIsWideAABBTreeEnabled(worldSettings.isWideBroadPhaseTreeEnabled),
+                     mIsStaticAABBTreeEnabled(worldSettings.isStaticBroadPhaseTreeEnabled),
+                     mIsWideAABBTreeUpToDate(false), mIsStaticAABBTreeModified(false),
+                     mIsBulkBuildEnabled(worldSettings.isBroadPhaseTreeBulkBuildEnabled), mIsBatchStarted(false),
+                     mIsSpatialGroupBatch(false), mIsProxyShapesUpdateStarted(false),
+                     mRebuildCostRatio(worldSettings.broadPhaseTreeRebuildCostRatio),
+                     mNbDynamicTreeModifications(0), mDynamicTreeBuildCost(decimal(0.0)),
+                     mMaintenanceTimeBudget(worldSettings.broadPhaseMaintenanceTimeBudget),
+                     mIsDynamicTreeRefinementRunning(false), mIsStaticTreeRefinementRunning(false) {
+
+    mDynamicAABBTree.setIsQueryCountingEnabled(worldSettings.isBroadPhaseQueryStatisticsEnabled);
+    mStaticAABBTree.setIsQueryCountingEnabled(worldSettings.isBroadPhaseQueryStatisticsEnabled);
+}
+
+// Allocate the memory needed to store a given number of proxy shapes
+/// The nodes are allocated in the dynamic AABB tree (the static AABB tree, if enabled, grows
+/// with the shapes of the static bodies)
+void AABBTreeBroadPhaseAlgorithm::reserve(uint nbProxyShapes) {
+
+    BroadPhaseAlgorithm::reserve(nbProxyShapes);
+
+    mDynamicAABBTree.reserve(static_cast<int>(nbProxyShapes));
+}
+
+// Start a batch of proxy shapes whose insertion can be deferred to the end of the batch
+/**
+ * @param isSpatialGroup True if the proxy shapes of the batch are close to each other
+ */
+void AABBTreeBroadPhaseAlgorithm::beginProxyShapesBatch(bool isSpatialGroup) {
+
+    assert(!mIsBatchStarted);
+    mIsBatchStarted = true;
+    mIsSpatialGroupBatch = isSpatialGroup;
+}
+
+// Insert the proxy shapes added since the start of the batch
+/// The new leaves of the dynamic tree are inserted together (the tree is built again with the
+/// surface area heuristic if they are many). The static tree is built again at the next
+/// broad-phase anyway. If the bulk build is enabled, the insertion waits for the next broad-phase.
+/// The shapes of a spatial group are instead built into a sub-tree of each tree and each
+/// sub-tree is grafted into its tree with a single insertion. The static tree is then not
+/// built again because of the group.
+void AABBTreeBroadPhaseAlgorithm::endProxyShapesBatch() {
+
+    assert(mIsBatchStarted);
+    mIsBatchStarted = false;
+
+    if (mIsSpatialGroupBatch) {
+        mIsSpatialGroupBatch = false;
+        if (mDynamicAABBTree.hasDeferredObjects()) {
+            mDynamicAABBTree.insertDeferredObjectsAsSubTree();
+            mIsWideAABBTreeUpToDate = false;
+        }
+        mStaticAABBTree.insertDeferredObjectsAsSubTree();
+        return;
+    }
+
+    if (!mIsBulkBuildEnabled && mDynamicAABBTree.hasDeferredObjects()) {
+        mDynamicAABBTree.insertDeferredObjects(mTaskScheduler);
+        mIsWideAABBTreeUpToDate = false;
+    }
+}
+
+// Return true if a proxy shape has to be stored in the static tree
+bool AABBTreeBroadPhaseAlgorithm::isStaticProxy(const ProxyShape* proxyShape) const {
+    return mIsStaticAABBTreeEnabled && proxyShape->getBody()->getType() == BodyType::STATIC;
+}
+
+// Add a proxy shape into one of the trees and return its broad-phase ID
+int AABBTreeBroadPhaseAlgorithm::addProxy(ProxyShape* proxyShape, const AABB& aabb) {
+
+    if (isStaticProxy(proxyShape)) {
+
+        // The sub-tree of a spatial group is grafted into the static tree without a new build
+        if (!mIsSpatialGroupBatch) {
+            mIsStaticAABBTreeModified = true;
+        }
+        const int nodeID = isInsertionDeferred() ? mStaticAABBTree.addObjectDeferred(aabb, proxyShape) :
+                                                   mStaticAABBTree.addObject(aabb, proxyShape);
+        return computeBroadPhaseId(nodeID, true);
+    }
+
+    mIsWideAABBTreeUpToDate = false;
+    mNbDynamicTreeModifications++;
+
+    const int nodeID = isInsertionDeferred() ? mDynamicAABBTree.addObjectDeferred(aabb, proxyShape) :
+                                               mDynamicAABBTree.addObject(aabb, proxyShape);
+    return computeBroadPhaseId(nodeID, false);
+}
+
+// Remove a proxy shape from its tree
+void AABBTreeBroadPhaseAlgorithm::removeProxy(int broadPhaseID) {
+
+    getTree(broadPhaseID).removeObject(getNodeId(broadPhaseID));
+
+    if (isInStaticTree(broadPhaseID)) {
+        mIsStaticAABBTreeModified = true;
+    }
+    else {
+        mIsWideAABBTreeUpToDate = false;
+        mNbDynamicTreeModifications++;
+    }
+}
+
+// Update the fat AABB of a proxy shape and return true if it has been reinserted
+bool AABBTreeBroadPhaseAlgorithm::updateProxy(int broadPhaseID, const AABB& aabb, const Vector3& displacement,
+                                              decimal gap, bool forceReinsert) {
+
+    // Update the tree according to the movement of the collision shape (during an update of
+    // the moved shapes, the shapes of the dynamic tree are reinserted at the end of the update)
+    const bool isReinsertionDeferred = mIsProxyShapesUpdateStarted && !isInStaticTree(broadPhaseID);
+    bool hasBeenReInserted = getTree(broadPhaseID).updateObject(getNodeId(broadPhaseID), aabb, displacement,
+                                                                gap, forceReinsert, isReinsertionDeferred);
+
+    if (hasBeenReInserted && !isInStaticTree(broadPhaseID)) {
+        mIsWideAABBTreeUpToDate = false;
+        mNbDynamicTreeModifications++;
+    }
+
+    return hasBeenReInserted;
+}
+
+// Start the update of a batch of moved proxy shapes
+void AABBTreeBroadPhaseAlgorithm::beginProxyShapesUpdate() {
+
+    assert(!mIsProxyShapesUpdateStarted);
+    mIsProxyShapesUpdateStarted = true;
+}
+
+// Finish the update of a batch of moved proxy shapes
+/// The shapes of the dynamic tree that have left their fat AABB have been removed from the
+/// tree during the update. They are now inserted together (the tree is built again with the
+/// surface area heuristic if they are many). If the bulk build is enabled, the insertion
+/// waits for the next broad-phase.
+void AABBTreeBroadPhaseAlgorithm::endProxyShapesUpdate() {
+
+    assert(mIsProxyShapesUpdateStarted);
+    mIsProxyShapesUpdateStarted = false;
+
+    if (!mIsBulkBuildEnabled && mDynamicAABBTree.hasDeferredObjects()) {
+        mDynamicAABBTree.insertDeferredObjects(mTaskScheduler);
+        mIsWideAABBTreeUpToDate = false;
+    }
+}
+
+// Move a proxy shape whose body type has changed and return its new broad-phase ID
+int AABBTreeBroadPhaseAlgorithm::updateProxyType(int broadPhaseID) {
+
+    ProxyShape* proxyShape = getProxyShapeForBroadPhaseId(broadPhaseID);
+
+    // If the proxy shape is already in the correct tree
+    if (isStaticProxy(proxyShape) == isInStaticTree(broadPhaseID)) return broadPhaseID;
+
+    // Move the proxy shape into the other tree with the same fat AABB
+    const AABB fatAABB = getFatAABB(broadPhaseID);
+    removeProxy(broadPhaseID);
+    DynamicAABBTree& tree = isStaticProxy(proxyShape) ? mStaticAABBTree : mDynamicAABBTree;
+    const int nodeID = tree.addObject(fatAABB, proxyShape);
+    const int newBroadPhaseID = computeBroadPhaseId(nodeID, isStaticProxy(proxyShape));
+    if (isInStaticTree(newBroadPhaseID)) {
+        mIsStaticAABBTreeModified = true;
+    }
+    else {
+        mIsWideAABBTreeUpToDate = false;
+    }
+
+    return newBroadPhaseID;
+}
+
+// Build the wide AABB tree again if the dynamic AABB tree has been modified
+void AABBTreeBroadPhaseAlgorithm::updateWideAABBTree() const {
+
+    assert(mIsWideAABBTreeEnabled);
+
+    if (!mIsWideAABBTreeUpToDate) {
+        mWideAABBTree.build(mDynamicAABBTree);
+        mIsWideAABBTreeUpToDate = true;
+    }
+}
+
+// Report all the shapes of the dynamic tree that are overlapping with a given AABB
+void AABBTreeBroadPhaseAlgorithm::reportAllDynamicShapesOverlappingWithAABB(const AABB& aabb,
+                                                                            DynamicAABBTreeOverlapCallback& callback) const {
+
+    AABBTreeOverlapCallback treeCallback(callback, false);
+
+    // Ask the AABB tree to report all collision shapes that overlap with this AABB
+    if (isWideAABBTreeUsed()) {
+        updateWideAABBTree();
+        mWideAABBTree.reportAllShapesOverlappingWithAABB(aabb, treeCallback);
+    }
+    else {
+        mDynamicAABBTree.reportAllShapesOverlappingWithAABB(aabb, treeCallback);
+    }
+}
+
+// Report all the shapes that are overlapping with a given AABB
+void AABBTreeBroadPhaseAlgorithm::reportAllShapesOverlappingWithAABB(const AABB& aabb,
+                                                                     DynamicAABBTreeOverlapCallback& callback) const {
+
+    reportAllDynamicShapesOverlappingWithAABB(aabb, callback);
+
+    if (mIsStaticAABBTreeEnabled) {
+        AABBTreeOverlapCallback staticCallback(callback, true);
+        mStaticAABBTree.reportAllShapesOverlappingWithAABB(aabb, staticCallback);
+    }
+}
+
+// Build the dynamic tree again if its cost has grown too much since its last build
+/// The cost of the tree is only computed after a number of modifications of the tree
+/// that is a fraction of its number of shapes so that the check remains cheap. With a
+/// maintenance time budget, a pass of incremental refinement is started instead.
+void AABBTreeBroadPhaseAlgorithm::rebuildDynamicTreeIfNeeded() {
+
+    if (mRebuildCostRatio <= decimal(1.0) || mIsDynamicTreeRefinementRunning) return;
+    if (mNbDynamicTreeModifications < std::max(16, mDynamicAABBTree.getNbObjects() / 4)) return;
+
+    mNbDynamicTreeModifications = 0;
+
+    if (mDynamicAABBTree.computeCost() > mRebuildCostRatio * mDynamicTreeBuildCost) {
+
+        RP3D_PROFILE("AABBTreeBroadPhaseAlgorithm::rebuildDynamicTreeIfNeeded()", mProfiler);
+
+        if (mMaintenanceTimeBudget > decimal(0.0)) {
+            mDynamicAABBTree.startIncrementalRefinement();
+            mIsDynamicTreeRefinementRunning = true;
+            return;
+        }
+
+        mDynamicAABBTree.rebuildWithSAH(mTaskScheduler);
+        mDynamicTreeBuildCost = mDynamicAABBTree.computeCost();
+        mIsWideAABBTreeUpToDate = false;
+    }
+}
+
+// Refine the trees incrementally during the maintenance time budget
+/// The leaves of the trees being refined are reinserted in small groups until the time
+/// budget of the broad-phase is spent. The dynamic tree is refined first. The pass of a
+/// tree continues at the next broad-phase until all its nodes have been visited.
+void AABBTreeBroadPhaseAlgorithm::refineTreesIncrementally() {
+
+    if (!mIsDynamicTreeRefinementRunning && !mIsStaticTreeRefinementRunning) return;
+
+    RP3D_PROFILE("AABBTreeBroadPhaseAlgorithm::refineTreesIncrementally()", mProfiler);
+
+    // Number of nodes visited between two checks of the time
+    const int nbNodesPerCheck = 32;
+
+    const uint64 endTicks = Timer::getCurrentTicks() + static_cast<uint64>(mMaintenanceTimeBudget * decimal(1.0e9));
+
+    do {
+
+        int nbReinsertedLeaves;
+        if (mIsDynamicTreeRefinementRunning) {
+
+            const bool isPassDone = mDynamicAABBTree.refineIncrementally(nbNodesPerCheck, nbReinsertedLeaves);
+            if (nbReinsertedLeaves > 0) mIsWideAABBTreeUpToDate = false;
+            if (isPassDone) {
+                mDynamicTreeBuildCost = mDynamicAABBTree.computeCost();
+                mIsDynamicTreeRefinementRunning = false;
+            }
+        }
+        else {
+            mIsStaticTreeRefinementRunning = !mStaticAABBTree.refineIncrementally(nbNodesPerCheck, nbReinsertedLeaves);
+        }
+        mCurrentStatistics.nbRefinedShapes += static_cast<uint>(nbReinsertedLeaves);
+
+    } while ((mIsDynamicTreeRefinementRunning || mIsStaticTreeRefinementRunning) &&
+             Timer::getCurrentTicks() < endTicks);
+}
+
+// Compute the potential overlapping pairs between the moved shapes and the other shapes
+void AABBTreeBroadPhaseAlgorithm::computePotentialPairs(MemoryManager& memoryManager) {
+
+    // Insert the shapes that have been added since the last broad-phase
+    if (mDynamicAABBTree.hasDeferredObjects()) {
+        mDynamicAABBTree.insertDeferredObjects(mTaskScheduler);
+        mIsWideAABBTreeUpToDate = false;
+    }
+
+    // Build the static tree again with the surface area heuristic if shapes have been
+    // added or removed (or refine it incrementally with a maintenance time budget)
+    if (mIsStaticAABBTreeModified) {
+        if (mMaintenanceTimeBudget > decimal(0.0)) {
+            mStaticAABBTree.insertDeferredObjects(mTaskScheduler);
+            mStaticAABBTree.startIncrementalRefinement();
+            mIsStaticTreeRefinementRunning = true;
+        }
+        else {
+            mStaticAABBTree.rebuildWithSAH(mTaskScheduler);
+        }
+        mIsStaticAABBTreeModified = false;
+    }
+
+    rebuildDynamicTreeIfNeeded();
+
+    refineTreesIncrementally();
+
+    // Build the wide tree before the queries that may be run in parallel
+    if (isWideAABBTreeUsed()) {
+        updateWideAABBTree();
+    }
+
+    BroadPhaseAlgorithm::computePotentialPairs(memoryManager);
+
+    // Add the queries since the previous computation to the statistics
+    mCurrentStatistics.nbQueries = mDynamicAABBTree.getNbQueries() + mStaticAABBTree.getNbQueries();
+    mCurrentStatistics.nbQueryVisitedNodes = mDynamicAABBTree.getNbQueryVisitedNodes() +
+                                             mStaticAABBTree.getNbQueryVisitedNodes();
+    mDynamicAABBTree.resetQueryCounters();
+    mStaticAABBTree.resetQueryCounters();
+}
+
+// Report the shapes that have to be paired with a moved shape
+/// The static shapes are only tested against the shapes of the dynamic tree.
+void AABBTreeBroadPhaseAlgorithm::reportShapesOverlappingWithMovedShape(int broadPhaseId,
+                                                                        List<int>& overlappingNodes) const {
+
+    const AABB& shapeAABB = getFatAABB(broadPhaseId);
+
+    AABBOverlapCallback callback(overlappingNodes);
+
+    if (isInStaticTree(broadPhaseId)) {
+        reportAllDynamicShapesOverlappingWithAABB(shapeAABB, callback);
+    }
+    else {
+        reportAllShapesOverlappingWithAABB(shapeAABB, callback);
+    }
+}
+
+// Ray casting method
+void AABBTreeBroadPhaseAlgorithm::raycast(const Ray& ray, RaycastTest& raycastTest,
+                                          collisionmask raycastWithCategoryMaskBits) const {
+
+    RP3D_PROFILE("AABBTreeBroadPhaseAlgorithm::raycast()", mProfiler);
+
+    BroadPhaseRaycastCallback broadPhaseRaycastCallback(*this, raycastWithCategoryMaskBits, raycastTest);
+
+    AABBTreeRaycastCallback dynamicCallback(broadPhaseRaycastCallback, false);
+    if (isWideAABBTreeUsed()) {
+        updateWideAABBTree();
+        mWideAABBTree.raycast(ray, dynamicCallback);
+    }
+    else {
+        mDynamicAABBTree.raycast(ray, dynamicCallback);
+    }
+
+    // Continue with the static tree if the raycast has not been stopped
+    if (mIsStaticAABBTreeEnabled && !dynamicCallback.isStopped) {
+        AABBTreeRaycastCallback staticCallback(broadPhaseRaycastCallback, true);
+        mStaticAABBTree.raycast(ray, staticCallback);
+    }
+}
+
+// Ray casting method for a packet of at most RAYCAST_PACKET_SIZE rays
+/// The packet traverses the binary trees (and not the wide AABB tree) so that the rays
+/// of the packet share the descent of the trees. The rays are clipped at their hits in
+/// the dynamic tree before they traverse the static tree.
+void AABBTreeBroadPhaseAlgorithm::raycastPacket(Ray* rays, uint nbRays, RaycastTest* raycastTests,
+                                                collisionmask raycastWithCategoryMaskBits) const {
+
+    RP3D_PROFILE("AABBTreeBroadPhaseAlgorithm::raycastPacket()", mProfiler);
+
+    AABBTreeRaycastPacketCallback dynamicCallback(*this, raycastWithCategoryMaskBits, raycastTests, false);
+    mDynamicAABBTree.raycastPacket(rays, nbRays, dynamicCallback);
+
+    if (mIsStaticAABBTreeEnabled) {
+        AABBTreeRaycastPacketCallback staticCallback(*this, raycastWithCategoryMaskBits, raycastTests, true);
+        mStaticAABBTree.raycastPacket(rays, nbRays, staticCallback);
+    }
+}
+
+// Cast a ray and return its closest hit (without a raycast callback)
+/// The binary trees are traversed with the nearest child of each node first and the ray is
+/// clipped at each hit without any virtual call for the leaves. The ray is also clipped at
+/// the closest hit of the dynamic tree before it traverses the static tree.
+bool AABBTreeBroadPhaseAlgorithm::raycastClosest(const Ray& ray, RaycastHit& hit,
+                                                 collisionmask raycastWithCategoryMaskBits) const {
+
+    RP3D_PROFILE("AABBTreeBroadPhaseAlgorithm::raycastClosest()", mProfiler);
+
+    hit = RaycastHit();
+    hit.hitFraction = ray.maxFraction;
+
+    bool isStaticTree = false;
+    auto raycastLeaf = [&](int32 nodeId, const Ray& clippedRay) {
+
+        ProxyShape* proxyShape =
+                AABBTreeBroadPhaseAlgorithm::getProxyShapeForBroadPhaseId(computeBroadPhaseId(nodeId, isStaticTree));
+
+        // Ignore the shapes filtered by the raycast mask or missed by the ray
+        if ((raycastWithCategoryMaskBits & proxyShape->getCollisionCategoryBits()) == 0) return decimal(-1.0);
+        RaycastInfo raycastInfo;
+        if (!proxyShape->raycast(clippedRay, raycastInfo)) return decimal(-1.0);
+
+        if (!hit.isHit() || raycastInfo.hitFraction < hit.hitFraction) {
+            hit.setHit(raycastInfo);
+        }
+
+        return hit.hitFraction;
+    };
+
+    mDynamicAABBTree.raycastLeaves(ray, raycastLeaf, true);
+
+    if (mIsStaticAABBTreeEnabled && hit.hitFraction > decimal(0.0)) {
+        isStaticTree = true;
+        mStaticAABBTree.raycastLeaves(Ray(ray.point1, ray.point2, hit.hitFraction), raycastLeaf, true);
+    }
+
+    return hit.isHit();
+}
+
+// Return true if a ray hits a shape (without a raycast callback)
+/// The traversal of the trees stops at the first hit (which is not the closest one).
+bool AABBTreeBroadPhaseAlgorithm::raycastAny(const Ray& ray, collisionmask raycastWithCategoryMaskBits) const {
+
+    RP3D_PROFILE("AABBTreeBroadPhaseAlgorithm::raycastAny()", mProfiler);
+
+    bool isHit = false;
+    bool isStaticTree = false;
+    auto raycastLeaf = [&](int32 nodeId, const Ray& clippedRay) {
+
+        ProxyShape* proxyShape =
+                AABBTreeBroadPhaseAlgorithm::getProxyShapeForBroadPhaseId(computeBroadPhaseId(nodeId, isStaticTree));
+
+        // Ignore the shapes filtered by the raycast mask or missed by the ray
+        if ((raycastWithCategoryMaskBits & proxyShape->getCollisionCategoryBits()) == 0) return decimal(-1.0);
+        RaycastInfo raycastInfo;
+        if (!proxyShape->raycast(clippedRay, raycastInfo)) return decimal(-1.0);
+
+        // Stop the traversal at the first hit
+        isHit = true;
+        return decimal(0.0);
+    };
+
+    mDynamicAABBTree.raycastLeaves(ray, raycastLeaf, false);
+
+    if (mIsStaticAABBTreeEnabled && !isHit) {
+        isStaticTree = true;
+        mStaticAABBTree.raycastLeaves(ray, raycastLeaf, false);
+    }
+
+    return isHit;
+}
+
+// Build the wide AABB tree if needed so that several threads can then run queries at the same time
+void AABBTreeBroadPhaseAlgorithm::prepareParallelQueries() const {
+    if (isWideAABBTreeUsed()) {
+        updateWideAABBTree();
+    }
+}
+
+// Compute the metrics of the quality of the dynamic and static trees
+/// The statistics of the static tree are empty if the static tree is disabled.
+/**
+ * @param[out] dynamicTreeStatistics The statistics of the tree of the dynamic shapes
+ * @param[out] staticTreeStatistics The statistics of the tree of the static shapes
+ * @return True
+ */
+bool AABBTreeBroadPhaseAlgorithm::computeTreeStatistics(DynamicAABBTreeStatistics& dynamicTreeStatistics,
+                                                        DynamicAABBTreeStatistics& staticTreeStatistics) const {
+
+    mDynamicAABBTree.computeStatistics(dynamicTreeStatistics);
+    mStaticAABBTree.computeStatistics(staticTreeStatistics);
+
+    return true;
+}
+
+// Move all the fat AABBs by the opposite of the displacement of the origin of the world
+/// The AABBs of the trees are moved in place. The structure of the trees and the
+/// overlapping pairs do not change and no shape is reinserted.
+void AABBTreeBroadPhaseAlgorithm::shiftOrigin(const Vector3& shift) {
+
+    mFatAABBsVersion++;
+
+    mDynamicAABBTree.translate(-shift);
+    mStaticAABBTree.translate(-shift);
+    if (mIsWideAABBTreeEnabled && mIsWideAABBTreeUpToDate) {
+        mWideAABBTree.translate(-shift);
+    }
+}
+
+// Called when a overlapping node has been found in the tree
+void AABBTreeOverlapCallback::notifyOverlappingNode(int nodeId) {
+    mCallback.notifyOverlappingNode(AABBTreeBroadPhaseAlgorithm::computeBroadPhaseId(nodeId, mIsStaticTree));
+}
+
+// Called when the AABB of a leaf node is hit by a ray
+decimal AABBTreeRaycastCallback::raycastBroadPhaseShape(int32 nodeId, const Ray& ray) {
+
+    decimal hitFraction = mCallback.raycastBroadPhaseShape(AABBTreeBroadPhaseAlgorithm::computeBroadPhaseId(nodeId, mIsStaticTree),
+                                                           ray);
+
+    // A hit fraction of zero stops the raycast
+    if (hitFraction == decimal(0.0)) {
+        isStopped = true;
+    }
+
+    return hitFraction;
+}
+
+// Called when the AABB of a leaf node is hit by the ray of a packet at a given index
+decimal AABBTreeRaycastPacketCallback::raycastBroadPhaseShape(int32 nodeId, uint rayIndex, const Ray& ray) {
+
+    BroadPhaseRaycastCallback callback(mBroadPhaseAlgorithm, mRaycastWithCategoryMaskBits, mRaycastTests[rayIndex]);
+    return callback.raycastBroadPhaseShape(AABBTreeBroadPhaseAlgorithm::computeBroadPhaseId(nodeId, mIsStaticTree),
+                                           ray);
+}
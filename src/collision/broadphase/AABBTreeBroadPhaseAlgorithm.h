@@ -0,0 +1,426 @@
+/********************************************************************************
+* ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
+* Copyright (c) 2010-2018 Daniel Chappuis                                       *
+*********************************************************************************
+*                                                                               *
+* This software is provided 'as-is', without any express or implied warranty.   *
+* In no event will the authors be held liable for any damages arising from the  *
+* use of this software.                                                         *
+*                                                                               *
+* Permission is granted to anyone to use this software for any purpose,         *
+* including commercial applications, and to alter it and redistribute it        *
+* freely, subject to the following restrictions:                                *
+*                                                                               *
+* 1. The origin of this software must not be misrepresented; you must not claim *
+*    that you wrote the original software. If you use this software in a        *
+*    product, an acknowledgment in the product documentation would be           *
+*    appreciated but is not required.                                           *
+*                                                                               *
+* 2. Altered source versions must be plainly marked as such, and must not be    *
+*    misrepresented as being the original software.                             *
+*                                                                               *
+* 3. This notice may not be removed or altered from any source distribution.    *
+*                                                                               *
+********************************************************************************/
+
+#ifndef REACTPHYSICS3D_AABB_TREE_BROAD_PHASE_ALGORITHM_H
+#define REACTPHYSICS3D_AABB_TREE_BROAD_PHASE_ALGORITHM_H
+
+// Libraries
+#include "BroadPhaseAlgorithm.h"
+#include "DynamicAABBTree.h"
+#include "WideAABBTree.h"
+
+/// Namespace ReactPhysics3D
+namespace reactphysics3d {
+
+// Class AABBTreeOverlapCallback
+/**
+ * Overlap callback that converts the node IDs of one of the trees of the
+ * broad-phase into broad-phase IDs.
+ */
+class AABBTreeOverlapCallback : public DynamicAABBTreeOverlapCallback {
+
+    private:
+
+        /// Callback of the broad-phase that receives the broad-phase IDs of the overlapping nodes
+        DynamicAABBTreeOverlapCallback& mCallback;
+
+        /// True if the nodes are in the static tree
+        bool mIsStaticTree;
+
+    public:
+
+        // Constructor
+        AABBTreeOverlapCallback(DynamicAABBTreeOverlapCallback& callback, bool isStaticTree)
+             : mCallback(callback), mIsStaticTree(isStaticTree) {
+
+        }
+
+        // Called when a overlapping node has been found in the tree
+        virtual void notifyOverlappingNode(int nodeId) override;
+};
+
+// Class AABBTreeRaycastCallback
+/**
+ * Raycast callback that converts the node IDs of one of the trees of the
+ * broad-phase into broad-phase IDs.
+ */
+class AABBTreeRaycastCallback : public DynamicAABBTreeRaycastCallback {
+
+    private:
+
+        /// Raycast callback of the broad-phase
+        BroadPhaseRaycastCallback& mCallback;
+
+        /// True if the nodes are in the static tree
+        bool mIsStaticTree;
+
+    public:
+
+        /// True if the raycast has been stopped by the user
+        bool isStopped;
+
+        // Constructor
+        AABBTreeRaycastCallback(BroadPhaseRaycastCallback& callback, bool isStaticTree)
+             : mCallback(callback), mIsStaticTree(isStaticTree), isStopped(false) {
+
+        }
+
+        // Called when the AABB of a leaf node is hit by a ray
+        virtual decimal raycastBroadPhaseShape(int32 nodeId, const Ray& ray) override;
+};
+
+// Class AABBTreeRaycastPacketCallback
+/**
+ * Raycast callback that converts the node IDs of one of the trees of the
+ * broad-phase into broad-phase IDs for the rays of a packet.
+ */
+class AABBTreeRaycastPacketCallback : public DynamicAABBTreeRaycastPacketCallback {
+
+    private:
+
+        /// Reference to the broad-phase
+        const BroadPhaseAlgorithm& mBroadPhaseAlgorithm;
+
+        /// Bits mask of the categories of the shapes that can be hit
+        collisionmask mRaycastWithCategoryMaskBits;
+
+        /// Raycast test of each ray of the packet
+        RaycastTest* mRaycastTests;
+
+        /// True if the nodes are in the static tree
+        bool mIsStaticTree;
+
+    public:
+
+        // Constructor
+        AABBTreeRaycastPacketCallback(const BroadPhaseAlgorithm& broadPhaseAlgorithm,
+                                      collisionmask raycastWithCategoryMaskBits,
+                                      RaycastTest* raycastTests, bool isStaticTree)
+             : mBroadPhaseAlgorithm(broadPhaseAlgorithm), mRaycastWithCategoryMaskBits(raycastWithCategoryMaskBits),
+               mRaycastTests(raycastTests), mIsStaticTree(isStaticTree) {
+
+        }
+
+        // Called when the AABB of a leaf node is hit by the ray of a packet at a given index
+        virtual decimal raycastBroadPhaseShape(int32 nodeId, uint rayIndex, const Ray& ray) override;
+};
+
+// Class AABBTreeBroadPhaseAlgorithm
+/**
+ * This class implements the broad-phase collision detection with a dynamic AABB
+ * tree. The fat AABBs of the proxy shapes are the leaves of the tree and the pairs
+ * of a moved shape are found with a query of the tree. If it is enabled in the world
+ * settings, the queries traverse a wide AABB tree built from the dynamic AABB tree.
+ *
+ * If the static tree is enabled in the world settings, the shapes of the static bodies
+ * are stored in a second tree. This tree only changes when static shapes are added,
+ * removed or moved by the user and it is built again with the surface area heuristic
+ * at the next step after shapes have been added or removed. The moved dynamic shapes
+ * query the two trees but the moved static shapes only query the dynamic tree because
+ * the pairs between two static shapes are never needed. The broad-phase ID of a shape
+ * is the ID of its node in its tree times two plus one if it is in the static tree.
+ *
+ * If the bulk build is enabled, the added shapes are inserted into the trees at the
+ * beginning of the next broad-phase, which builds the whole tree with the surface area
+ * heuristic when many shapes have been added. The dynamic tree can also be built again
+ * when its cost has grown too much with the updates of the moving shapes. These builds
+ * use the task scheduler of the world. The shapes added in a batch (when many bodies are
+ * created together) are also deferred to the end of the batch and inserted together.
+ *
+ * The wide tree is built before the queries of the moved shapes so that the queries
+ * only read the trees and can be run in parallel.
+ */
+class AABBTreeBroadPhaseAlgorithm : public BroadPhaseAlgorithm {
+
+    protected :
+
+        // -------------------- Attributes -------------------- //
+
+        /// Dynamic AABB tree
+        DynamicAABBTree mDynamicAABBTree;
+
+        /// Dynamic AABB tree of the shapes of the static bodies (if enabled)
+        DynamicAABBTree mStaticAABBTree;
+
+        /// Wide AABB tree built from the dynamic AABB tree for the queries (if enabled)
+        mutable WideAABBTree mWideAABBTree;
+
+        /// True if the queries traverse the wide AABB tree instead of the dynamic AABB tree
+        const bool mIsWideAABBTreeEnabled;
+
+        /// True if the shapes of the static bodies are stored in the static tree
+        const bool mIsStaticAABBTreeEnabled;
+
+        /// True if the wide AABB tree has been built since the last modification of the
+        /// dynamic AABB tree
+        mutable bool mIsWideAABBTreeUpToDate;
+
+        /// True if shapes have been added or removed from the static tree since it has
+        /// been built with the surface area heuristic
+        bool mIsStaticAABBTreeModified;
+
+        /// True if the insertion of the added shapes is deferred to the next broad-phase
+        const bool mIsBulkBuildEnabled;
+
+        /// True if the insertion of the added shapes is deferred to the end of the current batch
+        bool mIsBatchStarted;
+
+        /// True if the shapes of the current batch are grafted into the trees as sub-trees
+        bool mIsSpatialGroupBatch;
+
+        /// True if the reinsertion of the moved shapes of the dynamic tree is deferred to the
+        /// end of the current update of the moved shapes
+        bool mIsProxyShapesUpdateStarted;
+
+        /// Growth ratio of the cost of the dynamic tree that triggers a new build (if larger than one)
+        const decimal mRebuildCostRatio;
+
+        /// Number of modifications of the dynamic tree since its cost has been checked
+        int mNbDynamicTreeModifications;
+
+        /// Cost of the dynamic tree after its last build
+        decimal mDynamicTreeBuildCost;
+
+        /// Time (in seconds) of the incremental refinement of the trees at each broad-phase
+        /// (the trees are built again at once if it is not positive)
+        const decimal mMaintenanceTimeBudget;
+
+        /// True if a pass of incremental refinement of the dynamic tree is running
+        bool mIsDynamicTreeRefinementRunning;
+
+        /// True if a pass of incremental refinement of the static tree is running
+        bool mIsStaticTreeRefinementRunning;
+
+        // -------------------- Methods -------------------- //
+
+        /// Add a proxy shape into one of the trees and return its broad-phase ID
+        virtual int addProxy(ProxyShape* proxyShape, const AABB& aabb) override;
+
+        /// Remove a proxy shape from its tree
+        virtual void removeProxy(int broadPhaseID) override;
+
+        /// Update the fat AABB of a proxy shape and return true if it has been reinserted
+        virtual bool updateProxy(int broadPhaseID, const AABB& aabb, const Vector3& displacement,
+                                 decimal gap, bool forceReinsert) override;
+
+        /// Start the update of a batch of moved proxy shapes
+        virtual void beginProxyShapesUpdate() override;
+
+        /// Finish the update of a batch of moved proxy shapes
+        virtual void endProxyShapesUpdate() override;
+
+        /// Move a proxy shape whose body type has changed and return its new broad-phase ID
+        virtual int updateProxyType(int broadPhaseID) override;
+
+        /// Compute the potential overlapping pairs between the moved shapes and the other shapes
+        virtual void computePotentialPairs(MemoryManager& memoryManager) override;
+
+        /// Report the shapes that have to be paired with a moved shape
+        virtual void reportShapesOverlappingWithMovedShape(int broadPhaseId,
+                                                           List<int>& overlappingNodes) const override;
+
+        /// Build the wide AABB tree again if the dynamic AABB tree has been modified
+        void updateWideAABBTree() const;
+
+        /// Return true if the queries of the dynamic shapes have to use the wide AABB tree
+        bool isWideAABBTreeUsed() const;
+
+        /// Build the dynamic tree again if its cost has grown too much since its last build
+        void rebuildDynamicTreeIfNeeded();
+
+        /// Refine the trees incrementally during the maintenance time budget
+        void refineTreesIncrementally();
+
+        /// Report all the shapes of the dynamic tree that are overlapping with a given AABB
+        void reportAllDynamicShapesOverlappingWithAABB(const AABB& aabb,
+                                                       DynamicAABBTreeOverlapCallback& callback) const;
+
+        /// Return true if a proxy shape has to be stored in the static tree
+        bool isStaticProxy(const ProxyShape* proxyShape) const;
+
+        /// Return true if the insertion of the added shapes into the trees is deferred
+        bool isInsertionDeferred() const;
+
+        /// Return the tree of a broad-phase ID
+        const DynamicAABBTree& getTree(int broadPhaseId) const;
+
+        /// Return the tree of a broad-phase ID
+        DynamicAABBTree& getTree(int broadPhaseId);
+
+        /// Return the broad-phase ID of a node of one of the two trees
+        static int computeBroadPhaseId(int nodeId, bool isStaticTree);
+
+        /// Return the ID of the node of a broad-phase ID in its tree
+        static int getNodeId(int broadPhaseId);
+
+        /// Return true if a broad-phase ID is a node of the static tree
+        static bool isInStaticTree(int broadPhaseId);
+
+    public :
+
+        // -------------------- Methods -------------------- //
+
+        /// Constructor
+        AABBTreeBroadPhaseAlgorithm(CollisionDetection& collisionDetection, const WorldSettings& worldSettings);
+
+        /// Destructor
+        virtual ~AABBTreeBroadPhaseAlgorithm() override = default;
+
+        /// Deleted copy-constructor
+        AABBTreeBroadPhaseAlgorithm(const AABBTreeBroadPhaseAlgorithm& algorithm) = delete;
+
+        /// Deleted assignment operator
+        AABBTreeBroadPhaseAlgorithm& operator=(const AABBTreeBroadPhaseAlgorithm& algorithm) = delete;
+
+        /// Return the number of bytes used by the broad-phase algorithm
+        virtual size_t getSizeInBytes() const override;
+
+        /// Allocate the memory needed to store a given number of proxy shapes
+        virtual void reserve(uint nbProxyShapes) override;
+
+        /// Start a batch of proxy shapes whose insertion can be deferred to the end of the batch
+        virtual void beginProxyShapesBatch(bool isSpatialGroup) override;
+
+        /// Insert the proxy shapes added since the start of the batch
+        virtual void endProxyShapesBatch() override;
+
+        /// Report all the shapes that are overlapping with a given AABB
+        virtual void reportAllShapesOverlappingWithAABB(const AABB& aabb,
+                                                        DynamicAABBTreeOverlapCallback& callback) const override;
+
+        /// Return the proxy shape corresponding to the broad-phase node id in parameter
+        virtual ProxyShape* getProxyShapeForBroadPhaseId(int broadPhaseId) const override;
+
+        /// Return the fat AABB of a given broad-phase shape
+        virtual const AABB& getFatAABB(int broadPhaseId) const override;
+
+        /// Ray casting method
+        virtual void raycast(const Ray& ray, RaycastTest& raycastTest,
+                             collisionmask raycastWithCategoryMaskBits) const override;
+
+        /// Ray casting method for a packet of at most RAYCAST_PACKET_SIZE rays
+        virtual void raycastPacket(Ray* rays, uint nbRays, RaycastTest* raycastTests,
+                                   collisionmask raycastWithCategoryMaskBits) const override;
+
+        /// Cast a ray and return its closest hit (without a raycast callback)
+        virtual bool raycastClosest(const Ray& ray, RaycastHit& hit,
+                                    collisionmask raycastWithCategoryMaskBits) const override;
+
+        /// Return true if a ray hits a shape (without a raycast callback)
+        virtual bool raycastAny(const Ray& ray, collisionmask raycastWithCategoryMaskBits) const override;
+
+        /// Build the wide AABB tree if needed so that several threads can then run queries at the same time
+        virtual void prepareParallelQueries() const override;
+
+        /// Compute the metrics of the quality of the dynamic and static trees
+        virtual bool computeTreeStatistics(DynamicAABBTreeStatistics& dynamicTreeStatistics,
+                                           DynamicAABBTreeStatistics& staticTreeStatistics) const override;
+
+        /// Move all the fat AABBs by the opposite of the displacement of the origin of the world
+        virtual void shiftOrigin(const Vector3& shift) override;
+
+#ifdef IS_PROFILING_ACTIVE
+
+		/// Set the profiler
+		virtual void setProfiler(Profiler* profiler) override;
+
+#endif
+
+        // -------------------- Friendship -------------------- //
+
+        friend class AABBTreeOverlapCallback;
+        friend class AABBTreeRaycastCallback;
+        friend class AABBTreeRaycastPacketCallback;
+};
+
+// Return the number of bytes used by the broad-phase algorithm
+inline size_t AABBTreeBroadPhaseAlgorithm::getSizeInBytes() const {
+    return sizeof(AABBTreeBroadPhaseAlgorithm);
+}
+
+// Return true if the queries of the dynamic shapes have to use the wide AABB tree
+/// The wide tree is built from the dynamic tree and it does not contain the shapes
+/// whose insertion has been deferred.
+inline bool AABBTreeBroadPhaseAlgorithm::isWideAABBTreeUsed() const {
+    return mIsWideAABBTreeEnabled && !mDynamicAABBTree.hasDeferredObjects();
+}
+
+// Return true if the insertion of the added shapes into the trees is deferred
+inline bool AABBTreeBroadPhaseAlgorithm::isInsertionDeferred() const {
+    return mIsBulkBuildEnabled || mIsBatchStarted;
+}
+
+// Return the broad-phase ID of a node of one of the two trees
+inline int AABBTreeBroadPhaseAlgorithm::computeBroadPhaseId(int nodeId, bool isStaticTree) {
+    assert(nodeId >= 0);
+    return 2 * nodeId + (isStaticTree ? 1 : 0);
+}
+
+// Return the ID of the node of a broad-phase ID in its tree
+inline int AABBTreeBroadPhaseAlgorithm::getNodeId(int broadPhaseId) {
+    assert(broadPhaseId >= 0);
+    return broadPhaseId / 2;
+}
+
+// Return true if a broad-phase ID is a node of the static tree
+inline bool AABBTreeBroadPhaseAlgorithm::isInStaticTree(int broadPhaseId) {
+    return (broadPhaseId & 1) != 0;
+}
+
+// Return the tree of a broad-phase ID
+inline const DynamicAABBTree& AABBTreeBroadPhaseAlgorithm::getTree(int broadPhaseId) const {
+    return isInStaticTree(broadPhaseId) ? mStaticAABBTree : mDynamicAABBTree;
+}
+
+// Return the tree of a broad-phase ID
+inline DynamicAABBTree& AABBTreeBroadPhaseAlgorithm::getTree(int broadPhaseId) {
+    return isInStaticTree(broadPhaseId) ? mStaticAABBTree : mDynamicAABBTree;
+}
+
+// Return the fat AABB of a given broad-phase shape
+inline const AABB& AABBTreeBroadPhaseAlgorithm::getFatAABB(int broadPhaseId) const  {
+    return getTree(broadPhaseId).getFatAABB(getNodeId(broadPhaseId));
+}
+
+// Return the proxy shape corresponding to the broad-phase node id in parameter
+inline ProxyShape* AABBTreeBroadPhaseAlgorithm::getProxyShapeForBroadPhaseId(int broadPhaseId) const {
+    return static_cast<ProxyShape*>(getTree(broadPhaseId).getNodeDataPointer(getNodeId(broadPhaseId)));
+}
+
+#ifdef IS_PROFILING_ACTIVE
+
+// Set the profiler
+inline void AABBTreeBroadPhaseAlgorithm::setProfiler(Profiler* profiler) {
+	BroadPhaseAlgorithm::setProfiler(profiler);
+	mDynamicAABBTree.setProfiler(profiler);
+	mStaticAABBTree.setProfiler(profiler);
+	mWideAABBTree.setProfiler(profiler);
+}
+
+#endif
+
+}
+
+#endif
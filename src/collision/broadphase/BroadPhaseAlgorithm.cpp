@@ -29,18 +29,30 @@
 #include "utils/Profiler.h"
 #include "collision/RaycastInfo.h"
 #include "memory/MemoryManager.h"
+#include "engine/TaskScheduler.h"
+#include "engine/WorldState.h"
+#include <atomic>
 
 // We want to use the ReactPhysics3D namespace
 using namespace reactphysics3d;
 
-// Constructor
-BroadPhaseAlgorithm::BroadPhaseAlgorithm(CollisionDetection& collisionDetection)
-                    :mDynamicAABBTree(collisionDetection.getMemoryManager().getPoolAllocator(), DYNAMIC_TREE_AABB_GAP),
-                     mMovedShapes(collisionDetection.getMemoryManager().getPoolAllocator()),
-                     mNbPotentialPairs(0), mNbAllocatedPotentialPairs(8),
-                     mCollisionDetection(collisionDetection) {
+// Initialization of static variables
+const uint BroadPhaseAlgorithm::MOVED_SHAPES_CHUNK_SIZE = 64;
+const decimal BroadPhaseAlgorithm::AABB_GAP_GROW_FACTOR = decimal(2.0);
+const decimal BroadPhaseAlgorithm::AABB_GAP_SHRINK_FACTOR = decimal(0.5);
 
-    MemoryAllocator& poolAllocator = collisionDetection.getMemoryManager().getPoolAllocator();
+// Constructor
+BroadPhaseAlgorithm::BroadPhaseAlgorithm(CollisionDetection& collisionDetection, const WorldSettings& worldSettings)
+                    :mMovedShapes(collisionDetection.getMemoryManager().getPoolAllocator(MemoryTag::BroadPhase)),
+                     mSleepingMovedShapes(collisionDetection.getMemoryManager().getPoolAllocator(MemoryTag::BroadPhase)),
+                     mNbPotentialPairs(0), mNbAllocatedPotentialPairs(8), mArePotentialPairsSorted(false), mBroadPhaseStamp(0), mFatAABBsVersion(0),
+                     mIsAdaptiveAABBGapEnabled(worldSettings.isAdaptiveBroadPhaseAABBGapEnabled),
+                     mMinAABBGap(worldSettings.broadPhaseMinAABBGap), mMaxAABBGap(worldSettings.broadPhaseMaxAABBGap),
+                     mNbUpdatesBeforeAABBGapShrink(worldSettings.nbUpdatesBeforeBroadPhaseAABBGapShrink),
+                     mOverlappingNodes(collisionDetection.getMemoryManager().getPoolAllocator(MemoryTag::BroadPhase)),
+                     mCollisionDetection(collisionDetection), mTaskScheduler(worldSettings.taskScheduler) {
+
+    MemoryAllocator& poolAllocator = collisionDetection.getMemoryManager().getPoolAllocator(MemoryTag::BroadPhase);
 
     // Allocate memory for the array of potential overlapping pairs
     mPotentialPairs = static_cast<BroadPhasePair*>(poolAllocator.allocate(mNbAllocatedPotentialPairs * sizeof(BroadPhasePair)));
@@ -58,12 +70,31 @@ BroadPhaseAlgorithm::BroadPhaseAlgorithm(CollisionDetection& collisionDetection)
 BroadPhaseAlgorithm::~BroadPhaseAlgorithm() {
 
     // Get the memory pool allocatory
-    MemoryAllocator& poolAllocator = mCollisionDetection.getMemoryManager().getPoolAllocator();
+    MemoryAllocator& poolAllocator = mCollisionDetection.getMemoryManager().getPoolAllocator(MemoryTag::BroadPhase);
 
     // Release the memory for the array of potential overlapping pairs
     poolAllocator.release(mPotentialPairs, mNbAllocatedPotentialPairs * sizeof(BroadPhasePair));
 }
 
+// Allocate the memory needed to store a given number of proxy shapes
+void BroadPhaseAlgorithm::reserve(uint nbProxyShapes) {
+    mMovedShapes.reserve(static_cast<int>(nbProxyShapes));
+}
+
+// Start a batch of proxy shapes whose insertion can be deferred to the end of the batch
+/// By default, the proxy shapes of a batch are inserted one by one.
+/**
+ * @param isSpatialGroup True if the proxy shapes of the batch are close to each other
+ */
+void BroadPhaseAlgorithm::beginProxyShapesBatch(bool isSpatialGroup) {
+
+}
+
+// Insert the proxy shapes added since the start of the batch
+void BroadPhaseAlgorithm::endProxyShapesBatch() {
+
+}
+
 // Return true if the two broad-phase collision shapes are overlapping
 bool BroadPhaseAlgorithm::testOverlappingShapes(const ProxyShape* shape1,
                                                        const ProxyShape* shape2) const {
@@ -71,35 +102,30 @@ bool BroadPhaseAlgorithm::testOverlappingShapes(const ProxyShape* shape1,
     if (shape1->getBroadPhaseId() == -1 || shape2->getBroadPhaseId() == -1) return false;
 
     // Get the two AABBs of the collision shapes
-    const AABB& aabb1 = mDynamicAABBTree.getFatAABB(shape1->getBroadPhaseId());
-    const AABB& aabb2 = mDynamicAABBTree.getFatAABB(shape2->getBroadPhaseId());
+    const AABB& aabb1 = getFatAABB(shape1->getBroadPhaseId());
+    const AABB& aabb2 = getFatAABB(shape2->getBroadPhaseId());
 
     // Check if the two AABBs are overlapping
     return aabb1.testCollision(aabb2);
 }
 
-// Ray casting method
-void BroadPhaseAlgorithm::raycast(const Ray& ray, RaycastTest& raycastTest,
-                                         unsigned short raycastWithCategoryMaskBits) const {
-
-    RP3D_PROFILE("BroadPhaseAlgorithm::raycast()", mProfiler);
-
-    BroadPhaseRaycastCallback broadPhaseRaycastCallback(mDynamicAABBTree, raycastWithCategoryMaskBits, raycastTest);
-
-    mDynamicAABBTree.raycast(ray, broadPhaseRaycastCallback);
-}
-
 // Add a proxy collision shape into the broad-phase collision detection
 void BroadPhaseAlgorithm::addProxyCollisionShape(ProxyShape* proxyShape, const AABB& aabb) {
 
     assert(proxyShape->getBroadPhaseId() == -1);
 
-    // Add the collision shape into the dynamic AABB tree and get its broad-phase ID
-    int nodeId = mDynamicAABBTree.addObject(aabb, proxyShape);
+    // Add the collision shape into the spatial structure and get its broad-phase ID
+    int nodeId = addProxy(proxyShape, aabb);
 
     // Set the broad-phase ID of the proxy shape
     proxyShape->mBroadPhaseID = nodeId;
 
+    // The fat AABB of a new shape is inflated with the default gap
+    proxyShape->mBroadPhaseAABBGap = DYNAMIC_TREE_AABB_GAP;
+    proxyShape->mNbBroadPhaseUpdatesInsideFatAABB = 0;
+
+    mFatAABBsVersion++;
+
     // Add the collision shape into the array of bodies that have moved (or have been created)
     // during the last simulation step
     addMovedCollisionShape(proxyShape->getBroadPhaseId());
@@ -114,8 +140,10 @@ void BroadPhaseAlgorithm::removeProxyCollisionShape(ProxyShape* proxyShape) {
 
     proxyShape->mBroadPhaseID = -1;
 
-    // Remove the collision shape from the dynamic AABB tree
-    mDynamicAABBTree.removeObject(broadPhaseID);
+    // Remove the collision shape from the spatial structure
+    removeProxy(broadPhaseID);
+
+    mFatAABBsVersion++;
 
     // Remove the collision shape into the array of shapes that have moved (or have been created)
     // during the last simulation step
@@ -130,60 +158,145 @@ void BroadPhaseAlgorithm::updateProxyCollisionShape(ProxyShape* proxyShape, cons
 
     assert(broadPhaseID >= 0);
 
-    // Update the dynamic AABB tree according to the movement of the collision shape
-    bool hasBeenReInserted = mDynamicAABBTree.updateObject(broadPhaseID, aabb, displacement, forceReinsert);
+    decimal gap = DYNAMIC_TREE_AABB_GAP;
+    bool isShrinking = false;
+
+    // With the adaptive gaps, the gap of a shape grows when the shape leaves its fat AABB
+    // and shrinks when the shape has stayed inside its fat AABB for some updates
+    if (mIsAdaptiveAABBGapEnabled) {
+
+        gap = proxyShape->mBroadPhaseAABBGap;
+
+        if (!getFatAABB(broadPhaseID).contains(aabb)) {
+            gap = std::min(gap * AABB_GAP_GROW_FACTOR, mMaxAABBGap);
+            proxyShape->mNbBroadPhaseUpdatesInsideFatAABB = 0;
+        }
+        else if (!forceReinsert) {
+            proxyShape->mNbBroadPhaseUpdatesInsideFatAABB++;
+            if (proxyShape->mNbBroadPhaseUpdatesInsideFatAABB >= mNbUpdatesBeforeAABBGapShrink &&
+                gap > mMinAABBGap) {
+                gap = std::max(gap * AABB_GAP_SHRINK_FACTOR, mMinAABBGap);
+                proxyShape->mNbBroadPhaseUpdatesInsideFatAABB = 0;
+                isShrinking = true;
+            }
+        }
+
+        proxyShape->mBroadPhaseAABBGap = gap;
+    }
+
+    // Update the spatial structure according to the movement of the collision shape
+    bool hasBeenReInserted = updateProxy(broadPhaseID, aabb, displacement, gap, forceReinsert || isShrinking);
 
     // If the collision shape has moved out of its fat AABB (and therefore has been reinserted
-    // into the tree).
+    // into the spatial structure).
     if (hasBeenReInserted) {
 
+        mFatAABBsVersion++;
+
+        if (isShrinking) {
+            mCurrentStatistics.nbShrunkShapes++;
+        }
+        else {
+            mCurrentStatistics.nbReinsertedShapes++;
+        }
+
         // Add the collision shape into the array of shapes that have moved (or have been created)
         // during the last simulation step
         addMovedCollisionShape(broadPhaseID);
     }
 }
 
-void BroadPhaseAlgorithm::reportAllShapesOverlappingWithAABB(const AABB& aabb,
-                                                             LinkedList<int>& overlappingNodes) const {
+// Notify the broad-phase that a batch of collision shapes have moved
+/// The shapes whose new AABB is still inside their fat AABB are filtered out first (except
+/// with the adaptive gaps because their gaps depend on all their updates). The other shapes
+/// are updated between beginProxyShapesUpdate() and endProxyShapesUpdate() so that the
+/// spatial structure can reinsert them all together at the end of the batch.
+/**
+ * @param updates Array with the new states of the moved proxy shapes
+ * @param nbUpdates Number of elements in the array
+ */
+void BroadPhaseAlgorithm::updateProxyCollisionShapes(const ProxyShapeUpdate* updates, uint nbUpdates) {
+
+    RP3D_PROFILE("BroadPhaseAlgorithm::updateProxyCollisionShapes()", mProfiler);
+
+    beginProxyShapesUpdate();
+
+    for (uint i=0; i < nbUpdates; i++) {
+
+        const ProxyShapeUpdate& update = updates[i];
+
+        // The query-only shapes are not in the broad-phase
+        if (update.proxyShape->getBroadPhaseId() == -1) continue;
+
+        if (!mIsAdaptiveAABBGapEnabled && !update.forceReinsert &&
+            getFatAABB(update.proxyShape->getBroadPhaseId()).contains(update.aabb)) continue;
 
-    AABBOverlapCallback callback(overlappingNodes);
+        updateProxyCollisionShape(update.proxyShape, update.aabb, update.displacement, update.forceReinsert);
+    }
 
-    // Ask the dynamic AABB tree to report all collision shapes that overlap with this AABB
-    mDynamicAABBTree.reportAllShapesOverlappingWithAABB(aabb, callback);
+    endProxyShapesUpdate();
 }
 
-// Compute all the overlapping pairs of collision shapes
-void BroadPhaseAlgorithm::computeOverlappingPairs(MemoryManager& memoryManager) {
+// Start the update of a batch of moved proxy shapes
+/// By default, the moved shapes are reinserted one by one.
+void BroadPhaseAlgorithm::beginProxyShapesUpdate() {
 
-    // TODO : Try to see if we can allocate potential pairs in single frame allocator
+}
 
-    // Reset the potential overlapping pairs
-    mNbPotentialPairs = 0;
+// Finish the update of a batch of moved proxy shapes
+void BroadPhaseAlgorithm::endProxyShapesUpdate() {
 
-    LinkedList<int> overlappingNodes(memoryManager.getPoolAllocator());
+}
 
-    // For all collision shapes that have moved (or have been created) during the
-    // last simulation step
-    for (auto it = mMovedShapes.begin(); it != mMovedShapes.end(); ++it) {
-        int shapeID = *it;
+// Notify the broad-phase that the type of the body of a collision shape has changed
+void BroadPhaseAlgorithm::updateProxyCollisionShapeType(ProxyShape* proxyShape) {
 
-        if (shapeID == -1) continue;
+    int broadPhaseID = proxyShape->getBroadPhaseId();
 
-        AABBOverlapCallback callback(overlappingNodes);
+    assert(broadPhaseID >= 0);
 
-        // Get the AABB of the shape
-        const AABB& shapeAABB = mDynamicAABBTree.getFatAABB(shapeID);
+    // The proxy shape may be moved into another spatial structure with a new ID
+    int newBroadPhaseID = updateProxyType(broadPhaseID);
+    if (newBroadPhaseID != broadPhaseID) {
+        removeMovedCollisionShape(broadPhaseID);
+        proxyShape->mBroadPhaseID = newBroadPhaseID;
+        mFatAABBsVersion++;
+    }
 
-        // Ask the dynamic AABB tree to report all collision shapes that overlap with
-        // this AABB. The method BroadPhase::notifiyOverlappingPair() will be called
-        // by the dynamic AABB tree for each potential overlapping pair.
-        mDynamicAABBTree.reportAllShapesOverlappingWithAABB(shapeAABB, callback);
+    // The overlapping pairs of the shape have to be computed again
+    addMovedCollisionShape(newBroadPhaseID);
+}
 
-        // Add the potential overlapping pairs
-        addOverlappingNodes(shapeID, overlappingNodes);
+// Compute all the overlapping pairs of collision shapes
+void BroadPhaseAlgorithm::computeOverlappingPairs(MemoryManager& memoryManager) {
+
+    // TODO : Try to see if we can allocate potential pairs in single frame allocator
+
+    // Reset the potential overlapping pairs
+    mNbPotentialPairs = 0;
+    mArePotentialPairsSorted = false;
+
+    // Compute the potential overlapping pairs of the shapes that have moved (or have been
+    // created) during the last simulation step
+    computePotentialPairs(memoryManager);
+
+    mCurrentStatistics.nbMovedShapes = static_cast<uint>(mMovedShapes.size());
 
-        // Remove all the elements of the linked list of overlapping nodes
-        overlappingNodes.reset();
+    // Stamp the shapes that have moved so that the collision detection can find their
+    // overlapping pairs that have not been reported again. The moved shapes of sleeping
+    // bodies are not stamped because their pairs with the other sleeping or static shapes
+    // are not reported until their body wakes up.
+    mBroadPhaseStamp++;
+    for (auto it = mMovedShapes.begin(); it != mMovedShapes.end(); ++it) {
+        if (*it == -1) continue;
+        ProxyShape* shape = getProxyShapeForBroadPhaseId(*it);
+        if (shape->getBody()->isSleeping()) {
+            mSleepingMovedShapes.add(*it);
+            mCurrentStatistics.nbSleepingMovedShapes++;
+        }
+        else {
+            shape->mBroadPhaseMovedStamp = mBroadPhaseStamp;
+        }
     }
 
     // Reset the array of collision shapes that have move (or have been created) during the
@@ -191,7 +304,9 @@ void BroadPhaseAlgorithm::computeOverlappingPairs(MemoryManager& memoryManager)
     mMovedShapes.clear();
 
     // Sort the array of potential overlapping pairs in order to remove duplicate pairs
-    std::sort(mPotentialPairs, mPotentialPairs + mNbPotentialPairs, BroadPhasePair::smallerThan);
+    if (!mArePotentialPairsSorted) {
+        std::sort(mPotentialPairs, mPotentialPairs + mNbPotentialPairs, BroadPhasePair::smallerThan);
+    }
 
     // Check all the potential overlapping pairs avoiding duplicates to report unique
     // overlapping pairs
@@ -205,14 +320,22 @@ void BroadPhaseAlgorithm::computeOverlappingPairs(MemoryManager& memoryManager)
         assert(pair->collisionShape1ID != pair->collisionShape2ID);
 
         // Get the two collision shapes of the pair
-        ProxyShape* shape1 = static_cast<ProxyShape*>(mDynamicAABBTree.getNodeDataPointer(pair->collisionShape1ID));
-        ProxyShape* shape2 = static_cast<ProxyShape*>(mDynamicAABBTree.getNodeDataPointer(pair->collisionShape2ID));
+        ProxyShape* shape1 = getProxyShapeForBroadPhaseId(pair->collisionShape1ID);
+        ProxyShape* shape2 = getProxyShapeForBroadPhaseId(pair->collisionShape2ID);
+
+        // The pairs of two sleeping or static shapes that have only been reported by the
+        // moved shapes of sleeping bodies stay frozen until one of the bodies wakes up
+        const bool isFrozenPair = isFrozenShape(shape1) && isFrozenShape(shape2) &&
+                                  shape1->mBroadPhaseMovedStamp != mBroadPhaseStamp &&
+                                  shape2->mBroadPhaseMovedStamp != mBroadPhaseStamp;
 
-        // If the two proxy collision shapes are from the same body, skip it
-        if (shape1->getBody()->getId() != shape2->getBody()->getId()) {
+        // Filter the pairs that cannot collide (same body, static bodies, collision masks,
+        // bodies that cannot collide with each other) before an overlapping pair is created
+        if (!isFrozenPair && mCollisionDetection.testCollisionFilter(shape1, shape2)) {
 
             // Notify the collision detection about the overlapping pair
             mCollisionDetection.broadPhaseNotifyOverlappingPair(shape1, shape2);
+            mCurrentStatistics.nbOverlappingPairs++;
         }
 
         // Skip the duplicate overlapping pairs
@@ -230,11 +353,15 @@ void BroadPhaseAlgorithm::computeOverlappingPairs(MemoryManager& memoryManager)
         }
     }
 
+    // Keep the statistics of this computation and start the ones of the next computation
+    mStatistics = mCurrentStatistics;
+    mCurrentStatistics = BroadPhaseStatistics();
+
     // If the number of potential overlapping pairs is less than the quarter of allocated
     // number of overlapping pairs
     if (mNbPotentialPairs < mNbAllocatedPotentialPairs / 4 && mNbPotentialPairs > 8) {
 
-        MemoryAllocator& poolAllocator = mCollisionDetection.getMemoryManager().getPoolAllocator();
+        MemoryAllocator& poolAllocator = mCollisionDetection.getMemoryManager().getPoolAllocator(MemoryTag::BroadPhase);
 
         // Reduce the number of allocated potential overlapping pairs
         BroadPhasePair* oldPairs = mPotentialPairs;
@@ -247,45 +374,401 @@ void BroadPhaseAlgorithm::computeOverlappingPairs(MemoryManager& memoryManager)
     }
 }
 
-// Notify the broad-phase about a potential overlapping pair in the dynamic AABB tree
-void BroadPhaseAlgorithm::addOverlappingNodes(int referenceNodeId, const LinkedList<int>& overlappingNodes) {
+// Write the state of the broad-phase that is not stored in its proxy shapes
+void BroadPhaseAlgorithm::saveState(WorldStateWriter& writer) const {
+    writer.write(mBroadPhaseStamp);
+}
+
+// Restore the state written by saveState() (before the states of the proxy shapes)
+/// The sets of moved shapes are emptied and filled again by the states of the proxy shapes.
+void BroadPhaseAlgorithm::restoreState(WorldStateReader& reader) {
+    reader.read(mBroadPhaseStamp);
+    mMovedShapes.clear();
+    mSleepingMovedShapes.clear();
+}
 
-    // For each overlapping node in the linked list
-    LinkedList<int>::ListElement* elem = overlappingNodes.getListHead();
-    while (elem != nullptr) {
+// Write the broad-phase state of a proxy shape
+void BroadPhaseAlgorithm::saveProxyShapeState(const ProxyShape* proxyShape, WorldStateWriter& writer) const {
 
-        // If both the nodes are the same, we do not create store the overlapping pair
-        if (referenceNodeId != elem->data) {
+    const int broadPhaseID = proxyShape->getBroadPhaseId();
+    assert(broadPhaseID >= 0);
+
+    const AABB& fatAABB = getFatAABB(broadPhaseID);
+    writer.write(fatAABB.getMin());
+    writer.write(fatAABB.getMax());
+    writer.write(proxyShape->mBroadPhaseAABBGap);
+    writer.write(proxyShape->mNbBroadPhaseUpdatesInsideFatAABB);
+    writer.write(proxyShape->mBroadPhaseMovedStamp);
+    writer.write(mMovedShapes.contains(broadPhaseID));
+    writer.write(mSleepingMovedShapes.contains(broadPhaseID));
+}
+
+// Restore the broad-phase state of a proxy shape written by saveProxyShapeState()
+/// The proxy shape keeps its broad-phase ID and is only reinserted into the spatial
+/// structure if its fat AABB has changed since the state has been saved.
+void BroadPhaseAlgorithm::restoreProxyShapeState(ProxyShape* proxyShape, WorldStateReader& reader) {
+
+    const int broadPhaseID = proxyShape->getBroadPhaseId();
+    assert(broadPhaseID >= 0);
+
+    const Vector3 fatAABBMin = reader.read<Vector3>();
+    const Vector3 fatAABBMax = reader.read<Vector3>();
+    reader.read(proxyShape->mBroadPhaseAABBGap);
+    reader.read(proxyShape->mNbBroadPhaseUpdatesInsideFatAABB);
+    reader.read(proxyShape->mBroadPhaseMovedStamp);
+    const bool isMoved = reader.read<bool>();
+    const bool isSleepingMoved = reader.read<bool>();
+
+    // Set the saved fat AABB without inflating it
+    const AABB& fatAABB = getFatAABB(broadPhaseID);
+    if (fatAABB.getMin() != fatAABBMin || fatAABB.getMax() != fatAABBMax) {
+        updateProxy(broadPhaseID, AABB(fatAABBMin, fatAABBMax), Vector3(0, 0, 0), decimal(0.0), true);
+        mFatAABBsVersion++;
+    }
+
+    if (isMoved) mMovedShapes.add(broadPhaseID);
+    if (isSleepingMoved) mSleepingMovedShapes.add(broadPhaseID);
+}
+
+// Return true if the body of a collision shape is sleeping or static
+bool BroadPhaseAlgorithm::isFrozenShape(const ProxyShape* shape) {
+    const CollisionBody* body = shape->getBody();
+    return body->isSleeping() || body->getType() == BodyType::STATIC;
+}
+
+// Compute the potential overlapping pairs between the moved shapes and the other shapes
+void BroadPhaseAlgorithm::computePotentialPairs(MemoryManager& memoryManager) {
+
+    // If many shapes have moved, run their queries in parallel
+    const uint nbMovedShapes = static_cast<uint>(mMovedShapes.size());
+    if (mTaskScheduler != nullptr && mTaskScheduler->getNbWorkers() > 1 &&
+        nbMovedShapes > 2 * MOVED_SHAPES_CHUNK_SIZE) {
+
+        MemoryAllocator& frameAllocator = memoryManager.getSingleFrameAllocator(MemoryTag::BroadPhase);
+        int* movedShapes = static_cast<int*>(frameAllocator.allocate(nbMovedShapes * sizeof(int)));
+        uint index = 0;
+        for (auto it = mMovedShapes.begin(); it != mMovedShapes.end(); ++it) {
+            movedShapes[index] = *it;
+            index++;
+        }
+
+        computePotentialPairsInParallel(memoryManager, movedShapes, nbMovedShapes);
+
+        frameAllocator.release(movedShapes, nbMovedShapes * sizeof(int));
+
+        return;
+    }
+
+    // For all collision shapes that have moved (or have been created) during the
+    // last simulation step
+    for (auto it = mMovedShapes.begin(); it != mMovedShapes.end(); ++it) {
+        int shapeID = *it;
+
+        if (shapeID == -1) continue;
+
+        // Ask the spatial structure to report all collision shapes that overlap with
+        // the AABB of the shape
+        mOverlappingNodes.clear();
+        reportShapesOverlappingWithMovedShape(shapeID, mOverlappingNodes);
+
+        // Add the potential overlapping pairs
+        addOverlappingNodes(shapeID, mOverlappingNodes);
+    }
+}
+
+// Run the queries of the moved shapes in parallel and merge their pairs
+/// The moved shapes are split into chunks of MOVED_SHAPES_CHUNK_SIZE shapes. Each worker
+/// takes the next chunk until all the shapes are queried and stores the pairs as packed
+/// 64-bit keys with its own single frame allocator. Each worker then sorts its keys and
+/// removes their duplicates. Finally, the sorted keys of the workers are merged into the
+/// array of potential pairs without the pairs that have been found by several workers.
+void BroadPhaseAlgorithm::computePotentialPairsInParallel(MemoryManager& memoryManager, const int* movedShapes,
+                                                          uint nbMovedShapes) {
+
+    RP3D_PROFILE("BroadPhaseAlgorithm::computePotentialPairsInParallel()", mProfiler);
 
-            // If we need to allocate more memory for the array of potential overlapping pairs
-            if (mNbPotentialPairs == mNbAllocatedPotentialPairs) {
+    MemoryAllocator& frameAllocator = memoryManager.getSingleFrameAllocator(MemoryTag::BroadPhase);
 
-                MemoryAllocator& poolAllocator = mCollisionDetection.getMemoryManager().getPoolAllocator();
+    const uint nbChunks = (nbMovedShapes + MOVED_SHAPES_CHUNK_SIZE - 1) / MOVED_SHAPES_CHUNK_SIZE;
+    const uint nbWorkers = std::min(mTaskScheduler->getNbWorkers(), nbChunks);
 
-                // Allocate more memory for the array of potential pairs
-                BroadPhasePair* oldPairs = mPotentialPairs;
-                uint oldNbAllocatedPotentialPairs = mNbAllocatedPotentialPairs;
-                mNbAllocatedPotentialPairs *= 2;
-                mPotentialPairs = static_cast<BroadPhasePair*>(poolAllocator.allocate(mNbAllocatedPotentialPairs * sizeof(BroadPhasePair)));
-                assert(mPotentialPairs);
-                memcpy(mPotentialPairs, oldPairs, mNbPotentialPairs * sizeof(BroadPhasePair));
-                poolAllocator.release(oldPairs, oldNbAllocatedPotentialPairs * sizeof(BroadPhasePair));
+    memoryManager.createWorkerAllocators(nbWorkers);
+
+    // Sorted keys of the pairs found by each worker
+    uint64** workersKeys = static_cast<uint64**>(frameAllocator.allocate(nbWorkers * sizeof(uint64*)));
+    uint* workersNbKeys = static_cast<uint*>(frameAllocator.allocate(nbWorkers * sizeof(uint)));
+
+    std::atomic<uint> nextChunkIndex(0);
+
+    mTaskScheduler->parallelFor(nbWorkers, [&](uint workerIndex) {
+
+        MemoryAllocator& allocator = memoryManager.getWorkerSingleFrameAllocator(workerIndex);
+
+        List<uint64> keys(allocator);
+        List<int> overlappingNodes(allocator);
+
+        // Take the next chunk until all the moved shapes are queried
+        uint chunkIndex = nextChunkIndex.fetch_add(1);
+        while (chunkIndex < nbChunks) {
+
+            const uint startIndex = chunkIndex * MOVED_SHAPES_CHUNK_SIZE;
+            const uint endIndex = std::min(startIndex + MOVED_SHAPES_CHUNK_SIZE, nbMovedShapes);
+            for (uint i=startIndex; i < endIndex; i++) {
+
+                const int shapeID = movedShapes[i];
+
+                if (shapeID == -1) continue;
+
+                overlappingNodes.clear();
+                reportShapesOverlappingWithMovedShape(shapeID, overlappingNodes);
+
+                for (uint j=0; j < overlappingNodes.size(); j++) {
+                    if (overlappingNodes[j] != shapeID) {
+                        keys.add(BroadPhasePair::computeKey(shapeID, overlappingNodes[j]));
+                    }
+                }
             }
 
+            chunkIndex = nextChunkIndex.fetch_add(1);
+        }
+
+        // Sort the keys of the worker and remove their duplicates
+        const uint nbKeys = static_cast<uint>(keys.size());
+        uint64* sortedKeys = static_cast<uint64*>(allocator.allocate(std::max(nbKeys, 1u) * sizeof(uint64)));
+        uint64* tempKeys = static_cast<uint64*>(allocator.allocate(std::max(nbKeys, 1u) * sizeof(uint64)));
+        for (uint i=0; i < nbKeys; i++) {
+            sortedKeys[i] = keys[i];
+        }
+        sortPairKeys(sortedKeys, tempKeys, nbKeys);
+        uint nbUniqueKeys = 0;
+        for (uint i=0; i < nbKeys; i++) {
+            if (nbUniqueKeys == 0 || sortedKeys[i] != sortedKeys[nbUniqueKeys - 1]) {
+                sortedKeys[nbUniqueKeys] = sortedKeys[i];
+                nbUniqueKeys++;
+            }
+        }
+
+        workersKeys[workerIndex] = sortedKeys;
+        workersNbKeys[workerIndex] = nbUniqueKeys;
+    });
+
+    // Merge the sorted keys of the workers into the array of potential pairs
+    uint nbTotalKeys = 0;
+    for (uint w=0; w < nbWorkers; w++) {
+        nbTotalKeys += workersNbKeys[w];
+    }
+    reservePotentialPairs(nbTotalKeys);
+    uint* workersPositions = static_cast<uint*>(frameAllocator.allocate(nbWorkers * sizeof(uint)));
+    for (uint w=0; w < nbWorkers; w++) {
+        workersPositions[w] = 0;
+    }
+    assert(mNbPotentialPairs == 0);
+    while (true) {
+
+        // Find the smallest next key of the workers
+        int minWorker = -1;
+        for (uint w=0; w < nbWorkers; w++) {
+            if (workersPositions[w] < workersNbKeys[w] &&
+                (minWorker < 0 || workersKeys[w][workersPositions[w]] < workersKeys[minWorker][workersPositions[minWorker]])) {
+                minWorker = static_cast<int>(w);
+            }
+        }
+        if (minWorker < 0) break;
+
+        const uint64 key = workersKeys[minWorker][workersPositions[minWorker]];
+        workersPositions[minWorker]++;
+
+        // Skip the pairs that have also been found by another worker
+        if (mNbPotentialPairs > 0 && BroadPhasePair::computeKey(mPotentialPairs[mNbPotentialPairs - 1].collisionShape1ID,
+                                                                mPotentialPairs[mNbPotentialPairs - 1].collisionShape2ID) == key) {
+            continue;
+        }
+
+        mPotentialPairs[mNbPotentialPairs].collisionShape1ID = static_cast<int>(key >> 32);
+        mPotentialPairs[mNbPotentialPairs].collisionShape2ID = static_cast<int>(key & 0xFFFFFFFF);
+        mNbPotentialPairs++;
+    }
+    mArePotentialPairsSorted = true;
+
+    // The memory of the workers is not used anymore
+    memoryManager.resetWorkerFrameAllocators();
+
+    frameAllocator.release(workersPositions, nbWorkers * sizeof(uint));
+    frameAllocator.release(workersNbKeys, nbWorkers * sizeof(uint));
+    frameAllocator.release(workersKeys, nbWorkers * sizeof(uint64*));
+}
+
+// Sort an array of packed pair keys with a radix sort
+/// The keys are sorted one byte at a time from the least significant byte. The bytes
+/// that are the same for all the keys (the high bytes of the small broad-phase IDs for
+/// instance) are skipped. The "tempKeys" array must have the same size as the keys.
+void BroadPhaseAlgorithm::sortPairKeys(uint64* keys, uint64* tempKeys, uint nbKeys) {
+
+    // A small array is sorted with a comparison sort
+    if (nbKeys < 64) {
+        std::sort(keys, keys + nbKeys);
+        return;
+    }
+
+    // Find the bits that are not the same for all the keys
+    uint64 orKeys = 0;
+    uint64 andKeys = ~uint64(0);
+    for (uint i=0; i < nbKeys; i++) {
+        orKeys |= keys[i];
+        andKeys &= keys[i];
+    }
+    const uint64 varyingBits = orKeys ^ andKeys;
+
+    uint64* source = keys;
+    uint64* destination = tempKeys;
+    for (uint shift=0; shift < 64; shift += 8) {
+
+        if (((varyingBits >> shift) & 0xFF) == 0) continue;
+
+        // Count the keys of each value of the byte and compute the first index of each value
+        uint offsets[256] = {0};
+        for (uint i=0; i < nbKeys; i++) {
+            offsets[(source[i] >> shift) & 0xFF]++;
+        }
+        uint offset = 0;
+        for (uint b=0; b < 256; b++) {
+            const uint count = offsets[b];
+            offsets[b] = offset;
+            offset += count;
+        }
+
+        // Move the keys to their sorted position for this byte
+        for (uint i=0; i < nbKeys; i++) {
+            destination[offsets[(source[i] >> shift) & 0xFF]++] = source[i];
+        }
+
+        std::swap(source, destination);
+    }
+
+    if (source != keys) {
+        std::memcpy(keys, source, nbKeys * sizeof(uint64));
+    }
+}
+
+// Notify the broad-phase about a potential overlapping pair in the dynamic AABB tree
+void BroadPhaseAlgorithm::addOverlappingNodes(int referenceNodeId, const List<int>& overlappingNodes) {
+
+    // Allocate the memory of all the pairs at once
+    reservePotentialPairs(mNbPotentialPairs + static_cast<uint>(overlappingNodes.size()));
+
+    // For each overlapping node
+    for (uint i=0; i < overlappingNodes.size(); i++) {
+
+        const int nodeId = overlappingNodes[i];
+
+        // If both the nodes are the same, we do not create store the overlapping pair
+        if (referenceNodeId != nodeId) {
+
             // Add the new potential pair into the array of potential overlapping pairs
-            mPotentialPairs[mNbPotentialPairs].collisionShape1ID = std::min(referenceNodeId, elem->data);
-            mPotentialPairs[mNbPotentialPairs].collisionShape2ID = std::max(referenceNodeId, elem->data);
+            mPotentialPairs[mNbPotentialPairs].collisionShape1ID = std::min(referenceNodeId, nodeId);
+            mPotentialPairs[mNbPotentialPairs].collisionShape2ID = std::max(referenceNodeId, nodeId);
             mNbPotentialPairs++;
         }
+    }
+}
+
+// Add a potential overlapping pair into the array of potential pairs
+void BroadPhaseAlgorithm::addPotentialPair(int broadPhaseId1, int broadPhaseId2) {
+
+    assert(broadPhaseId1 != broadPhaseId2);
+
+    // If we need to allocate more memory for the array of potential overlapping pairs
+    if (mNbPotentialPairs == mNbAllocatedPotentialPairs) {
+        reservePotentialPairs(mNbPotentialPairs + 1);
+    }
+
+    mPotentialPairs[mNbPotentialPairs].collisionShape1ID = std::min(broadPhaseId1, broadPhaseId2);
+    mPotentialPairs[mNbPotentialPairs].collisionShape2ID = std::max(broadPhaseId1, broadPhaseId2);
+    mNbPotentialPairs++;
+}
+
+// Make sure that the array of potential pairs can contain a given number of pairs
+void BroadPhaseAlgorithm::reservePotentialPairs(uint nbPairs) {
+
+    if (nbPairs <= mNbAllocatedPotentialPairs) return;
+
+    MemoryAllocator& poolAllocator = mCollisionDetection.getMemoryManager().getPoolAllocator(MemoryTag::BroadPhase);
 
-        elem = elem->next;
+    // Allocate more memory for the array of potential pairs
+    BroadPhasePair* oldPairs = mPotentialPairs;
+    uint oldNbAllocatedPotentialPairs = mNbAllocatedPotentialPairs;
+    while (mNbAllocatedPotentialPairs < nbPairs) {
+        mNbAllocatedPotentialPairs *= 2;
     }
+    mPotentialPairs = static_cast<BroadPhasePair*>(poolAllocator.allocate(mNbAllocatedPotentialPairs * sizeof(BroadPhasePair)));
+    assert(mPotentialPairs);
+    memcpy(mPotentialPairs, oldPairs, mNbPotentialPairs * sizeof(BroadPhasePair));
+    poolAllocator.release(oldPairs, oldNbAllocatedPotentialPairs * sizeof(BroadPhasePair));
 }
 
 // Called when a overlapping node has been found during the call to
 // DynamicAABBTree:reportAllShapesOverlappingWithAABB()
 void AABBOverlapCallback::notifyOverlappingNode(int nodeId) {
-    mOverlappingNodes.insert(nodeId);
+    mOverlappingNodes.add(nodeId);
+}
+
+// Ray casting method for a packet of at most RAYCAST_PACKET_SIZE rays
+/// The raycast test at index i is used for the ray at index i. The max fractions of the
+/// rays may be clipped at their hits. The default implementation casts the rays of the
+/// packet one by one.
+void BroadPhaseAlgorithm::raycastPacket(Ray* rays, uint nbRays, RaycastTest* raycastTests,
+                                        collisionmask raycastWithCategoryMaskBits) const {
+    for (uint i=0; i < nbRays; i++) {
+        raycast(rays[i], raycastTests[i], raycastWithCategoryMaskBits);
+    }
+}
+
+// Cast a ray and return its closest hit (without a raycast callback)
+/// The hit fraction of the hit is the max fraction of the ray if the ray does not hit anything.
+/// The default implementation uses the raycast of the broad-phase with a callback that keeps
+/// the closest hit.
+bool BroadPhaseAlgorithm::raycastClosest(const Ray& ray, RaycastHit& hit,
+                                         collisionmask raycastWithCategoryMaskBits) const {
+
+    hit = RaycastHit();
+    hit.hitFraction = ray.maxFraction;
+
+    RaycastClosestHitCallback callback;
+    callback.hit = &hit;
+    RaycastTest raycastTest(&callback);
+    raycast(ray, raycastTest, raycastWithCategoryMaskBits);
+
+    return hit.isHit();
+}
+
+// Return true if a ray hits a shape (without a raycast callback)
+/// The default implementation uses the raycast of the broad-phase with a callback that
+/// stops the raycast at the first hit.
+bool BroadPhaseAlgorithm::raycastAny(const Ray& ray, collisionmask raycastWithCategoryMaskBits) const {
+
+    RaycastAnyHitCallback callback;
+    RaycastTest raycastTest(&callback);
+    raycast(ray, raycastTest, raycastWithCategoryMaskBits);
+
+    return callback.isHit;
+}
+
+// Update the structures built lazily by the queries so that several threads
+// can then run queries at the same time
+void BroadPhaseAlgorithm::prepareParallelQueries() const {
+
+}
+
+// Compute the metrics of the quality of the trees of the broad-phase
+/// The broad-phase algorithms without dynamic AABB trees return false.
+/**
+ * @param[out] dynamicTreeStatistics The statistics of the tree of the dynamic shapes
+ * @param[out] staticTreeStatistics The statistics of the tree of the static shapes
+ * @return True if the broad-phase has dynamic AABB trees
+ */
+bool BroadPhaseAlgorithm::computeTreeStatistics(DynamicAABBTreeStatistics& dynamicTreeStatistics,
+                                                DynamicAABBTreeStatistics& staticTreeStatistics) const {
+    return false;
 }
 
 // Called for a broad-phase shape that has to be tested for raycast
@@ -294,7 +777,7 @@ decimal BroadPhaseRaycastCallback::raycastBroadPhaseShape(int32 nodeId, const Ra
     decimal hitFraction = decimal(-1.0);
 
     // Get the proxy shape from the node
-    ProxyShape* proxyShape = static_cast<ProxyShape*>(mDynamicAABBTree.getNodeDataPointer(nodeId));
+    ProxyShape* proxyShape = mBroadPhaseAlgorithm.getProxyShapeForBroadPhaseId(nodeId);
 
     // Check if the raycast filtering mask allows raycast against this shape
     if ((mRaycastWithCategoryMaskBits & proxyShape->getCollisionCategoryBits()) != 0) {
@@ -28,8 +28,8 @@
 
 // Libraries
 #include "DynamicAABBTree.h"
-#include "containers/LinkedList.h"
-#include "containers/Set.h"
+#include "containers/List.h"
+#include "containers/FlatSet.h"
 
 /// Namespace ReactPhysics3D
 namespace reactphysics3d {
@@ -41,6 +41,10 @@ class CollisionBody;
 class ProxyShape;
 class MemoryManager;
 class Profiler;
+class TaskScheduler;
+class WorldStateWriter;
+class WorldStateReader;
+struct RaycastHit;
 
 // Structure BroadPhasePair
 /**
@@ -61,6 +65,68 @@ struct BroadPhasePair {
 
     /// Method used to compare two pairs for sorting algorithm
     static bool smallerThan(const BroadPhasePair& pair1, const BroadPhasePair& pair2);
+
+    /// Return the 64-bit key of a pair (the keys are sorted like the pairs)
+    static uint64 computeKey(int broadPhaseId1, int broadPhaseId2);
+};
+
+// Structure ProxyShapeUpdate
+/**
+ * This structure contains the new state of a proxy shape whose body has moved. An array of
+ * those structures is given to the broad-phase to update all the moved shapes together.
+ */
+struct ProxyShapeUpdate {
+
+    // -------------------- Attributes -------------------- //
+
+    /// Pointer to the proxy shape
+    ProxyShape* proxyShape;
+
+    /// New world-space AABB of the collision shape
+    AABB aabb;
+
+    /// Displacement of the shape during the next step (used to inflate its fat AABB)
+    Vector3 displacement;
+
+    /// True if the fat AABB of the shape must be computed again even if it contains the new AABB
+    bool forceReinsert;
+};
+
+// Structure BroadPhaseStatistics
+/**
+ * This structure contains the statistics of the last computation of the overlapping
+ * pairs of the broad-phase. They can be used to tune the gaps of the fat AABBs of the
+ * world (a larger gap gives less reinsertions but more pairs for the narrow-phase).
+ */
+struct BroadPhaseStatistics {
+
+    // -------------------- Attributes -------------------- //
+
+    /// Number of shapes reinserted into the broad-phase because they have left their fat AABB
+    uint nbReinsertedShapes = 0;
+
+    /// Number of shapes reinserted into the broad-phase to shrink their adaptive gap
+    uint nbShrunkShapes = 0;
+
+    /// Number of moved shapes whose overlapping shapes have been computed
+    uint nbMovedShapes = 0;
+
+    /// Number of shapes reinserted by the incremental refinement of the trees of the broad-phase
+    uint nbRefinedShapes = 0;
+
+    /// Number of unique overlapping pairs found by the broad-phase
+    uint nbOverlappingPairs = 0;
+
+    /// Number of moved shapes of sleeping bodies that have only been paired with the
+    /// shapes of the awake bodies
+    uint nbSleepingMovedShapes = 0;
+
+    /// Number of queries of the trees of the broad-phase since the previous computation
+    /// (only counted if enabled in the world settings and not for the wide tree)
+    uint64 nbQueries = 0;
+
+    /// Number of nodes of the trees visited by these queries
+    uint64 nbQueryVisitedNodes = 0;
 };
 
 // class AABBOverlapCallback
@@ -70,10 +136,10 @@ class AABBOverlapCallback : public DynamicAABBTreeOverlapCallback {
 
     public:
 
-        LinkedList<int>& mOverlappingNodes;
+        List<int>& mOverlappingNodes;
 
         // Constructor
-        AABBOverlapCallback(LinkedList<int>& overlappingNodes)
+        AABBOverlapCallback(List<int>& overlappingNodes)
              : mOverlappingNodes(overlappingNodes) {
 
         }
@@ -86,25 +152,25 @@ class AABBOverlapCallback : public DynamicAABBTreeOverlapCallback {
 
 // Class BroadPhaseRaycastCallback
 /**
- * Callback called when the AABB of a leaf node is hit by a ray the
- * broad-phase Dynamic AABB Tree.
+ * Callback called when the AABB of a broad-phase shape is hit by a ray
+ * in the broad-phase.
  */
 class BroadPhaseRaycastCallback : public DynamicAABBTreeRaycastCallback {
 
     private :
 
-        const DynamicAABBTree& mDynamicAABBTree;
+        const BroadPhaseAlgorithm& mBroadPhaseAlgorithm;
 
-        unsigned short mRaycastWithCategoryMaskBits;
+        collisionmask mRaycastWithCategoryMaskBits;
 
         RaycastTest& mRaycastTest;
 
     public:
 
         // Constructor
-        BroadPhaseRaycastCallback(const DynamicAABBTree& dynamicAABBTree, unsigned short raycastWithCategoryMaskBits,
+        BroadPhaseRaycastCallback(const BroadPhaseAlgorithm& broadPhaseAlgorithm, collisionmask raycastWithCategoryMaskBits,
                                   RaycastTest& raycastTest)
-            : mDynamicAABBTree(dynamicAABBTree), mRaycastWithCategoryMaskBits(raycastWithCategoryMaskBits),
+            : mBroadPhaseAlgorithm(broadPhaseAlgorithm), mRaycastWithCategoryMaskBits(raycastWithCategoryMaskBits),
               mRaycastTest(raycastTest) {
 
         }
@@ -119,25 +185,50 @@ class BroadPhaseRaycastCallback : public DynamicAABBTreeRaycastCallback {
 
 // Class BroadPhaseAlgorithm
 /**
- * This class represents the broad-phase collision detection. The
+ * This abstract class represents the broad-phase collision detection. The
  * goal of the broad-phase collision detection is to compute the pairs of proxy shapes
  * that have their AABBs overlapping. Only those pairs of bodies will be tested
- * later for collision during the narrow-phase collision detection. A dynamic AABB
- * tree data structure is used for fast broad-phase collision detection.
+ * later for collision during the narrow-phase collision detection. The spatial
+ * structure that stores the fat AABBs of the proxy shapes is implemented by the
+ * derived classes (a dynamic AABB tree or a sweep-and-prune) and is selected with
+ * the broad-phase type of the world settings.
+ *
+ * If the world has a task scheduler and many shapes have moved, the queries of the moved
+ * shapes are run in parallel. Each worker stores its pairs as packed 64-bit keys in its
+ * own buffer and sorts them with a radix sort. The sorted buffers are then merged without
+ * the duplicates and the result does not depend on the number of workers.
+ *
+ * With the adaptive gaps of the world settings, each shape has its own gap to inflate its
+ * fat AABB. The gap grows when the shape leaves its fat AABB and shrinks when the shape has
+ * stayed inside its fat AABB for some updates.
  */
 class BroadPhaseAlgorithm {
 
     protected :
 
-        // -------------------- Attributes -------------------- //
+        // -------------------- Constants -------------------- //
+
+        /// Number of moved shapes queried by a worker each time it takes new work
+        /// during the parallel broad-phase
+        static const uint MOVED_SHAPES_CHUNK_SIZE;
 
-        /// Dynamic AABB tree
-        DynamicAABBTree mDynamicAABBTree;
+        /// Factor used to grow the adaptive gap of a shape that has left its fat AABB
+        static const decimal AABB_GAP_GROW_FACTOR;
+
+        /// Factor used to shrink the adaptive gap of a shape that has stayed inside its fat AABB
+        static const decimal AABB_GAP_SHRINK_FACTOR;
+
+        // -------------------- Attributes -------------------- //
 
         /// Set with the broad-phase IDs of all collision shapes that have moved (or have been
         /// created) during the last simulation step. Those are the shapes that need to be tested
         /// for overlapping in the next simulation step.
-        Set<int> mMovedShapes;
+        FlatSet<int> mMovedShapes;
+
+        /// Set with the broad-phase IDs of the moved shapes of sleeping bodies. Those shapes
+        /// have only been paired with the shapes of the awake bodies and are tested again
+        /// against all the shapes when their body wakes up.
+        FlatSet<int> mSleepingMovedShapes;
 
         /// Temporary array of potential overlapping pairs (with potential duplicates)
         BroadPhasePair* mPotentialPairs;
@@ -148,9 +239,44 @@ class BroadPhaseAlgorithm {
         /// Number of allocated elements for the array of potential overlapping pairs
         uint mNbAllocatedPotentialPairs;
 
+        /// True if the potential pairs are already sorted and without duplicates
+        bool mArePotentialPairsSorted;
+
+        /// Stamp of the last computation of the overlapping pairs
+        uint64 mBroadPhaseStamp;
+
+        /// Version of the fat AABBs (incremented each time a shape is added, removed or gets
+        /// a new fat AABB)
+        uint64 mFatAABBsVersion;
+
+        /// True if each shape has its own adaptive gap for its fat AABB
+        bool mIsAdaptiveAABBGapEnabled;
+
+        /// Smallest adaptive gap of the fat AABBs
+        decimal mMinAABBGap;
+
+        /// Largest adaptive gap of the fat AABBs
+        decimal mMaxAABBGap;
+
+        /// Number of consecutive updates of a shape inside its fat AABB before its gap is shrunk
+        uint mNbUpdatesBeforeAABBGapShrink;
+
+        /// Statistics of the shapes reinserted since the last computation of the overlapping pairs
+        BroadPhaseStatistics mCurrentStatistics;
+
+        /// Statistics of the last computation of the overlapping pairs
+        BroadPhaseStatistics mStatistics;
+
+        /// Scratch buffer with the broad-phase IDs reported by the query of a moved shape
+        /// (its memory is kept between the queries and the steps)
+        List<int> mOverlappingNodes;
+
         /// Reference to the collision detection object
         CollisionDetection& mCollisionDetection;
 
+        /// Task scheduler used to run the queries of the moved shapes (null if sequential)
+        TaskScheduler* mTaskScheduler;
+
 #ifdef IS_PROFILING_ACTIVE
 
 		/// Pointer to the profiler
@@ -158,21 +284,76 @@ class BroadPhaseAlgorithm {
 
 #endif
 
+        // -------------------- Methods -------------------- //
+
+        /// Add a proxy shape into the spatial structure and return its broad-phase ID
+        virtual int addProxy(ProxyShape* proxyShape, const AABB& aabb)=0;
+
+        /// Remove a proxy shape from the spatial structure
+        virtual void removeProxy(int broadPhaseID)=0;
+
+        /// Update the fat AABB of a proxy shape and return true if it has changed
+        virtual bool updateProxy(int broadPhaseID, const AABB& aabb, const Vector3& displacement,
+                                 decimal gap, bool forceReinsert)=0;
+
+        /// Move a proxy shape whose body type has changed and return its new broad-phase ID
+        virtual int updateProxyType(int broadPhaseID);
+
+        /// Start the update of a batch of moved proxy shapes
+        virtual void beginProxyShapesUpdate();
+
+        /// Finish the update of a batch of moved proxy shapes
+        virtual void endProxyShapesUpdate();
+
+        /// Compute the potential overlapping pairs between the moved shapes and the other shapes
+        virtual void computePotentialPairs(MemoryManager& memoryManager);
+
+        /// Report the shapes that have to be paired with a moved shape
+        virtual void reportShapesOverlappingWithMovedShape(int broadPhaseId, List<int>& overlappingNodes) const;
+
+        /// Run the queries of the moved shapes in parallel and merge their pairs
+        void computePotentialPairsInParallel(MemoryManager& memoryManager, const int* movedShapes,
+                                             uint nbMovedShapes);
+
+        /// Add a potential overlapping pair into the array of potential pairs
+        void addPotentialPair(int broadPhaseId1, int broadPhaseId2);
+
+        /// Make sure that the array of potential pairs can contain a given number of pairs
+        void reservePotentialPairs(uint nbPairs);
+
+        /// Return true if the body of a collision shape is sleeping or static
+        static bool isFrozenShape(const ProxyShape* shape);
+
+        /// Sort an array of packed pair keys with a radix sort
+        static void sortPairKeys(uint64* keys, uint64* tempKeys, uint nbKeys);
+
     public :
 
         // -------------------- Methods -------------------- //
 
         /// Constructor
-        BroadPhaseAlgorithm(CollisionDetection& collisionDetection);
+        BroadPhaseAlgorithm(CollisionDetection& collisionDetection, const WorldSettings& worldSettings);
 
         /// Destructor
-        ~BroadPhaseAlgorithm();
+        virtual ~BroadPhaseAlgorithm();
 
         /// Deleted copy-constructor
         BroadPhaseAlgorithm(const BroadPhaseAlgorithm& algorithm) = delete;
 
         /// Deleted assignment operator
         BroadPhaseAlgorithm& operator=(const BroadPhaseAlgorithm& algorithm) = delete;
+
+        /// Return the number of bytes used by the broad-phase algorithm
+        virtual size_t getSizeInBytes() const=0;
+
+        /// Allocate the memory needed to store a given number of proxy shapes
+        virtual void reserve(uint nbProxyShapes);
+
+        /// Start a batch of proxy shapes whose insertion can be deferred to the end of the batch
+        virtual void beginProxyShapesBatch(bool isSpatialGroup);
+
+        /// Insert the proxy shapes added since the start of the batch
+        virtual void endProxyShapesBatch();
         
         /// Add a proxy collision shape into the broad-phase collision detection
         void addProxyCollisionShape(ProxyShape* proxyShape, const AABB& aabb);
@@ -184,6 +365,12 @@ class BroadPhaseAlgorithm {
         void updateProxyCollisionShape(ProxyShape* proxyShape, const AABB& aabb,
                                        const Vector3& displacement, bool forceReinsert = false);
 
+        /// Notify the broad-phase that a batch of collision shapes have moved
+        void updateProxyCollisionShapes(const ProxyShapeUpdate* updates, uint nbUpdates);
+
+        /// Notify the broad-phase that the type of the body of a collision shape has changed
+        void updateProxyCollisionShapeType(ProxyShape* proxyShape);
+
         /// Add a collision shape in the array of shapes that have moved in the last simulation step
         /// and that need to be tested again for broad-phase overlapping.
         void addMovedCollisionShape(int broadPhaseID);
@@ -192,31 +379,80 @@ class BroadPhaseAlgorithm {
         /// step and that need to be tested again for broad-phase overlapping.
         void removeMovedCollisionShape(int broadPhaseID);
 
+        /// Notify the broad-phase that the body of a collision shape has woken up
+        void wakeUpProxyCollisionShape(int broadPhaseID);
+
         /// Add potential overlapping pairs in the dynamic AABB tree
-        void addOverlappingNodes(int broadPhaseId1, const LinkedList<int>& overlappingNodes);
+        void addOverlappingNodes(int broadPhaseId1, const List<int>& overlappingNodes);
 
         /// Report all the shapes that are overlapping with a given AABB
-        void reportAllShapesOverlappingWithAABB(const AABB& aabb, LinkedList<int>& overlappingNodes) const;
+        void reportAllShapesOverlappingWithAABB(const AABB& aabb, List<int>& overlappingNodes) const;
+
+        /// Report the broad-phase IDs of all the shapes that are overlapping with a given AABB to a callback
+        virtual void reportAllShapesOverlappingWithAABB(const AABB& aabb,
+                                                        DynamicAABBTreeOverlapCallback& callback) const=0;
 
         /// Compute all the overlapping pairs of collision shapes
         void computeOverlappingPairs(MemoryManager& memoryManager);
 
         /// Return the proxy shape corresponding to the broad-phase node id in parameter
-        ProxyShape* getProxyShapeForBroadPhaseId(int broadPhaseId) const;
+        virtual ProxyShape* getProxyShapeForBroadPhaseId(int broadPhaseId) const=0;
+
+        /// Return the stamp of the last computation of the overlapping pairs
+        uint64 getBroadPhaseStamp() const;
+
+        /// Return the version of the fat AABBs of the shapes
+        uint64 getFatAABBsVersion() const;
+
+        /// Return the statistics of the last computation of the overlapping pairs
+        const BroadPhaseStatistics& getStatistics() const;
 
         /// Return true if the two broad-phase collision shapes are overlapping
         bool testOverlappingShapes(const ProxyShape* shape1, const ProxyShape* shape2) const;
 
         /// Return the fat AABB of a given broad-phase shape
-        const AABB& getFatAABB(int broadPhaseId) const;
+        virtual const AABB& getFatAABB(int broadPhaseId) const=0;
 
         /// Ray casting method
-        void raycast(const Ray& ray, RaycastTest& raycastTest, unsigned short raycastWithCategoryMaskBits) const;
+        virtual void raycast(const Ray& ray, RaycastTest& raycastTest, collisionmask raycastWithCategoryMaskBits) const=0;
+
+        /// Ray casting method for a packet of at most RAYCAST_PACKET_SIZE rays
+        virtual void raycastPacket(Ray* rays, uint nbRays, RaycastTest* raycastTests,
+                                   collisionmask raycastWithCategoryMaskBits) const;
+
+        /// Cast a ray and return its closest hit (without a raycast callback)
+        virtual bool raycastClosest(const Ray& ray, RaycastHit& hit, collisionmask raycastWithCategoryMaskBits) const;
+
+        /// Return true if a ray hits a shape (without a raycast callback)
+        virtual bool raycastAny(const Ray& ray, collisionmask raycastWithCategoryMaskBits) const;
+
+        /// Update the structures built lazily by the queries so that several threads
+        /// can then run queries at the same time
+        virtual void prepareParallelQueries() const;
+
+        /// Compute the metrics of the quality of the trees of the broad-phase
+        virtual bool computeTreeStatistics(DynamicAABBTreeStatistics& dynamicTreeStatistics,
+                                           DynamicAABBTreeStatistics& staticTreeStatistics) const;
+
+        /// Move all the fat AABBs by the opposite of the displacement of the origin of the world
+        virtual void shiftOrigin(const Vector3& shift)=0;
+
+        /// Write the state of the broad-phase that is not stored in its proxy shapes
+        void saveState(WorldStateWriter& writer) const;
+
+        /// Restore the state written by saveState() (before the states of the proxy shapes)
+        void restoreState(WorldStateReader& reader);
+
+        /// Write the broad-phase state of a proxy shape
+        void saveProxyShapeState(const ProxyShape* proxyShape, WorldStateWriter& writer) const;
+
+        /// Restore the broad-phase state of a proxy shape written by saveProxyShapeState()
+        void restoreProxyShapeState(ProxyShape* proxyShape, WorldStateReader& reader);
 
 #ifdef IS_PROFILING_ACTIVE
 
 		/// Set the profiler
-		void setProfiler(Profiler* profiler);
+		virtual void setProfiler(Profiler* profiler);
 
 #endif
 
@@ -232,9 +468,51 @@ inline bool BroadPhasePair::smallerThan(const BroadPhasePair& pair1, const Broad
     return false;
 }
 
-// Return the fat AABB of a given broad-phase shape
-inline const AABB& BroadPhaseAlgorithm::getFatAABB(int broadPhaseId) const  {
-    return mDynamicAABBTree.getFatAABB(broadPhaseId);
+// Report all the shapes that are overlapping with a given AABB
+inline void BroadPhaseAlgorithm::reportAllShapesOverlappingWithAABB(const AABB& aabb,
+                                                                    List<int>& overlappingNodes) const {
+    AABBOverlapCallback callback(overlappingNodes);
+    reportAllShapesOverlappingWithAABB(aabb, callback);
+}
+
+// Report the shapes that have to be paired with a moved shape
+/// This method may be called by several workers at the same time and must only read
+/// the spatial structure.
+inline void BroadPhaseAlgorithm::reportShapesOverlappingWithMovedShape(int broadPhaseId,
+                                                                       List<int>& overlappingNodes) const {
+    reportAllShapesOverlappingWithAABB(getFatAABB(broadPhaseId), overlappingNodes);
+}
+
+// Return the 64-bit key of a pair (the keys are sorted like the pairs)
+/// The smallest broad-phase ID is in the 32 high bits of the key.
+inline uint64 BroadPhasePair::computeKey(int broadPhaseId1, int broadPhaseId2) {
+    assert(broadPhaseId1 >= 0 && broadPhaseId2 >= 0);
+    return (static_cast<uint64>(std::min(broadPhaseId1, broadPhaseId2)) << 32) |
+            static_cast<uint64>(std::max(broadPhaseId1, broadPhaseId2));
+}
+
+// Return the stamp of the last computation of the overlapping pairs
+inline uint64 BroadPhaseAlgorithm::getBroadPhaseStamp() const {
+    return mBroadPhaseStamp;
+}
+
+// Return the version of the fat AABBs of the shapes
+/// The version changes each time a shape is added, removed or gets a new fat AABB. The
+/// result of a query on the fat AABBs can be reused as long as the version has not changed.
+inline uint64 BroadPhaseAlgorithm::getFatAABBsVersion() const {
+    return mFatAABBsVersion;
+}
+
+// Return the statistics of the last computation of the overlapping pairs
+/// The reinsertions are the ones done between the previous computation and this one.
+inline const BroadPhaseStatistics& BroadPhaseAlgorithm::getStatistics() const {
+    return mStatistics;
+}
+
+// Move a proxy shape whose body type has changed and return its new broad-phase ID
+/// The broad-phase algorithms that store all the proxy shapes together keep the same ID.
+inline int BroadPhaseAlgorithm::updateProxyType(int broadPhaseID) {
+    return broadPhaseID;
 }
 
 // Add a collision shape in the array of shapes that have moved in the last simulation step
@@ -249,13 +527,21 @@ inline void BroadPhaseAlgorithm::addMovedCollisionShape(int broadPhaseID) {
 // and that need to be tested again for broad-phase overlapping.
 inline void BroadPhaseAlgorithm::removeMovedCollisionShape(int broadPhaseID) {
 
-    // Remove the broad-phase ID from the set
+    // Remove the broad-phase ID from the sets
     mMovedShapes.remove(broadPhaseID);
+    mSleepingMovedShapes.remove(broadPhaseID);
 }
 
-// Return the proxy shape corresponding to the broad-phase node id in parameter
-inline ProxyShape* BroadPhaseAlgorithm::getProxyShapeForBroadPhaseId(int broadPhaseId) const {
-    return static_cast<ProxyShape*>(mDynamicAABBTree.getNodeDataPointer(broadPhaseId));
+// Notify the broad-phase that the body of a collision shape has woken up
+/// A moved shape of a sleeping body is tested again against all the shapes. While some
+/// moved shapes of sleeping bodies have not been tested against all the shapes, the
+/// shape that wakes up is also tested again because it might overlap with them.
+inline void BroadPhaseAlgorithm::wakeUpProxyCollisionShape(int broadPhaseID) {
+
+    if (mSleepingMovedShapes.size() > 0) {
+        mSleepingMovedShapes.remove(broadPhaseID);
+        mMovedShapes.add(broadPhaseID);
+    }
 }
 
 #ifdef IS_PROFILING_ACTIVE
@@ -263,7 +549,6 @@ inline ProxyShape* BroadPhaseAlgorithm::getProxyShapeForBroadPhaseId(int broadPh
 // Set the profiler
 inline void BroadPhaseAlgorithm::setProfiler(Profiler* profiler) {
 	mProfiler = profiler;
-	mDynamicAABBTree.setProfiler(profiler);
 }
 
 #endif
@@ -271,4 +556,3 @@ inline void BroadPhaseAlgorithm::setProfiler(Profiler* profiler) {
 }
 
 #endif
-
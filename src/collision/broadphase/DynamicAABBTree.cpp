@@ -28,15 +28,44 @@
 #include "BroadPhaseAlgorithm.h"
 #include "containers/Stack.h"
 #include "utils/Profiler.h"
+#include "engine/TaskScheduler.h"
+#include <algorithm>
 
 using namespace reactphysics3d;
 
 // Initialization of static variables
 const int TreeNode::NULL_TREE_NODE = -1;
+const int DynamicAABBTree::SAH_PARALLEL_BUILD_MIN_NB_LEAVES = 1024;
+
+// Destructor of the query context
+DynamicAABBTreeQueryContext::~DynamicAABBTreeQueryContext() {
+
+    // Release the stack if it has been allocated
+    if (mStack != mInitialStack) {
+        mAllocator.release(mStack, mStackCapacity * sizeof(int));
+    }
+}
+
+// Allocate a larger stack
+/// The nodes of the stack are not kept because the stack is only grown at the beginning
+/// of a traversal.
+void DynamicAABBTreeQueryContext::growStack(uint nbNodes) {
+
+    assert(nbNodes > mStackCapacity);
+
+    if (mStack != mInitialStack) {
+        mAllocator.release(mStack, mStackCapacity * sizeof(int));
+    }
+
+    mStackCapacity = std::max(nbNodes, 2 * mStackCapacity);
+    mStack = static_cast<int*>(mAllocator.allocate(mStackCapacity * sizeof(int)));
+    assert(mStack != nullptr);
+}
 
 // Constructor
 DynamicAABBTree::DynamicAABBTree(MemoryAllocator& allocator, decimal extraAABBGap)
-                : mAllocator(allocator), mExtraAABBGap(extraAABBGap) {
+                : mAllocator(allocator), mExtraAABBGap(extraAABBGap), mDeferredLeaves(allocator),
+                  mIsQueryCountingEnabled(false), mNbQueries(0), mNbQueryVisitedNodes(0) {
 
     init();
 }
@@ -51,8 +80,6 @@ DynamicAABBTree::~DynamicAABBTree() {
 // Initialize the tree
 void DynamicAABBTree::init() {
 
-    mRootNodeID = TreeNode::NULL_TREE_NODE;
-    mNbNodes = 0;
     mNbAllocatedNodes = 8;
 
     // Allocate memory for the nodes of the tree
@@ -60,7 +87,20 @@ void DynamicAABBTree::init() {
     assert(mNodes);
     std::memset(mNodes, 0, mNbAllocatedNodes * sizeof(TreeNode));
 
-    // Initialize the allocated nodes
+    clear();
+}
+
+// Remove all the objects from the tree without releasing the memory of the nodes
+/// This is used to fill the tree again with about the same number of objects without
+/// allocating its nodes again.
+void DynamicAABBTree::clear() {
+
+    mRootNodeID = TreeNode::NULL_TREE_NODE;
+    mNbNodes = 0;
+    mDeferredLeaves.clear();
+    mRefinementNodeID = 0;
+
+    // All the allocated nodes are free
     for (int i=0; i<mNbAllocatedNodes - 1; i++) {
         mNodes[i].nextNodeID = i + 1;
         mNodes[i].height = -1;
@@ -75,6 +115,7 @@ void DynamicAABBTree::reset() {
 
     // Free the allocated memory for the nodes
     mAllocator.release(mNodes, mNbAllocatedNodes * sizeof(TreeNode));
+    mDeferredLeaves.clear();
 
     // Initialize the tree
     init();
@@ -89,22 +130,7 @@ int DynamicAABBTree::allocateNode() {
         assert(mNbNodes == mNbAllocatedNodes);
 
         // Allocate more nodes in the tree
-        uint oldNbAllocatedNodes = mNbAllocatedNodes;
-        mNbAllocatedNodes *= 2;
-        TreeNode* oldNodes = mNodes;
-        mNodes = static_cast<TreeNode*>(mAllocator.allocate(mNbAllocatedNodes * sizeof(TreeNode)));
-        assert(mNodes);
-        memcpy(mNodes, oldNodes, mNbNodes * sizeof(TreeNode));
-        mAllocator.release(oldNodes, oldNbAllocatedNodes * sizeof(TreeNode));
-
-        // Initialize the allocated nodes
-        for (int i=mNbNodes; i<mNbAllocatedNodes - 1; i++) {
-            mNodes[i].nextNodeID = i + 1;
-            mNodes[i].height = -1;
-        }
-        mNodes[mNbAllocatedNodes - 1].nextNodeID = TreeNode::NULL_TREE_NODE;
-        mNodes[mNbAllocatedNodes - 1].height = -1;
-        mFreeNodeID = mNbNodes;
+        growNodes(mNbAllocatedNodes * 2);
     }
 
     // Get the next free node
@@ -117,6 +143,39 @@ int DynamicAABBTree::allocateNode() {
     return freeNodeID;
 }
 
+// Allocate a larger array of nodes (the new nodes are added to the free nodes)
+void DynamicAABBTree::growNodes(int nbAllocatedNodes) {
+
+    assert(nbAllocatedNodes > mNbAllocatedNodes);
+
+    const int oldNbAllocatedNodes = mNbAllocatedNodes;
+    TreeNode* oldNodes = mNodes;
+    mNodes = static_cast<TreeNode*>(mAllocator.allocate(nbAllocatedNodes * sizeof(TreeNode)));
+    assert(mNodes);
+    memcpy(mNodes, oldNodes, oldNbAllocatedNodes * sizeof(TreeNode));
+    mAllocator.release(oldNodes, oldNbAllocatedNodes * sizeof(TreeNode));
+    mNbAllocatedNodes = nbAllocatedNodes;
+
+    // Initialize the allocated nodes and put them in front of the free nodes
+    for (int i=oldNbAllocatedNodes; i<mNbAllocatedNodes - 1; i++) {
+        mNodes[i].nextNodeID = i + 1;
+        mNodes[i].height = -1;
+    }
+    mNodes[mNbAllocatedNodes - 1].nextNodeID = mFreeNodeID;
+    mNodes[mNbAllocatedNodes - 1].height = -1;
+    mFreeNodeID = oldNbAllocatedNodes;
+}
+
+// Allocate the nodes needed to store a given number of objects
+/// A tree with n objects has n leaves and n-1 internal nodes
+void DynamicAABBTree::reserve(int nbObjects) {
+
+    const int nbNodes = 2 * nbObjects - 1;
+    if (nbNodes > mNbAllocatedNodes) {
+        growNodes(nbNodes);
+    }
+}
+
 // Release a node
 void DynamicAABBTree::releaseNode(int nodeID) {
 
@@ -160,7 +219,12 @@ void DynamicAABBTree::removeObject(int nodeID) {
     assert(mNodes[nodeID].isLeaf());
 
     // Remove the node from the tree
-    removeLeafNode(nodeID);
+    if (isDeferredLeaf(nodeID)) {
+        mDeferredLeaves.remove(nodeID);
+    }
+    else {
+        removeLeafNode(nodeID);
+    }
     releaseNode(nodeID);
 }
 
@@ -172,6 +236,17 @@ void DynamicAABBTree::removeObject(int nodeID) {
 /// frames. If the "forceReinsert" parameter is true, we force a removal and reinsertion of the node
 /// (this can be useful if the shape AABB has become much smaller than the previous one for instance).
 bool DynamicAABBTree::updateObject(int nodeID, const AABB& newAABB, const Vector3& displacement, bool forceReinsert) {
+    return updateObject(nodeID, newAABB, displacement, mExtraAABBGap, forceReinsert);
+}
+
+// Update the dynamic tree after an object has moved with a given gap for its fat AABB
+/// This method is the same as the previous one but the fat AABB of the node is inflated
+/// with the "gap" parameter instead of the extra gap of the tree (the broad-phase uses it
+/// for the adaptive gaps of the shapes). If the "isReinsertionDeferred" parameter is true, a
+/// node that leaves its fat AABB is removed from the tree and becomes a deferred object that
+/// is inserted by the next call to insertDeferredObjects() (with the other moved objects).
+bool DynamicAABBTree::updateObject(int nodeID, const AABB& newAABB, const Vector3& displacement,
+                                   decimal gap, bool forceReinsert, bool isReinsertionDeferred) {
 
     RP3D_PROFILE("DynamicAABBTree::updateObject()", mProfiler);
 
@@ -185,13 +260,17 @@ bool DynamicAABBTree::updateObject(int nodeID, const AABB& newAABB, const Vector
     }
 
     // If the new AABB is outside the fat AABB, we remove the corresponding node
-    removeLeafNode(nodeID);
+    // (a deferred node is not in the tree and only gets its new fat AABB)
+    const bool isDeferred = isDeferredLeaf(nodeID);
+    if (!isDeferred) {
+        removeLeafNode(nodeID);
+    }
 
-    // Compute the fat AABB by inflating the AABB with a constant gap
+    // Compute the fat AABB by inflating the AABB with the gap
     mNodes[nodeID].aabb = newAABB;
-    const Vector3 gap(mExtraAABBGap, mExtraAABBGap, mExtraAABBGap);
-    mNodes[nodeID].aabb.mMinCoordinates -= gap;
-    mNodes[nodeID].aabb.mMaxCoordinates += gap;
+    const Vector3 gapVector(gap, gap, gap);
+    mNodes[nodeID].aabb.mMinCoordinates -= gapVector;
+    mNodes[nodeID].aabb.mMaxCoordinates += gapVector;
 
     // Inflate the fat AABB in direction of the linear motion of the AABB
     if (displacement.x < decimal(0.0)) {
@@ -215,8 +294,16 @@ bool DynamicAABBTree::updateObject(int nodeID, const AABB& newAABB, const Vector
 
     assert(mNodes[nodeID].aabb.contains(newAABB));
 
-    // Reinsert the node into the tree
-    insertLeafNode(nodeID);
+    // Reinsert the node into the tree (or defer its reinsertion)
+    if (!isDeferred) {
+        if (isReinsertionDeferred) {
+            mNodes[nodeID].parentID = TreeNode::NULL_TREE_NODE;
+            mDeferredLeaves.add(nodeID);
+        }
+        else {
+            insertLeafNode(nodeID);
+        }
+    }
 
     return true;
 }
@@ -224,6 +311,8 @@ bool DynamicAABBTree::updateObject(int nodeID, const AABB& newAABB, const Vector
 // Insert a leaf node in the tree. The process of inserting a new leaf node
 // in the dynamic tree is described in the book "Introduction to Game Physics
 // with Box2D" by Ian Parberry.
+/// The node can also be the root of a sub-tree that is not in the tree yet. The
+/// sub-tree is then grafted as a whole next to the best sibling node.
 void DynamicAABBTree::insertLeafNode(int nodeID) {
 
     // If the tree is empty
@@ -331,7 +420,6 @@ void DynamicAABBTree::insertLeafNode(int nodeID) {
 
         // Balance the sub-tree of the current node if it is not balanced
         currentNodeID = balanceSubTreeAtNode(currentNodeID);
-        assert(mNodes[nodeID].isLeaf());
 
         assert(!mNodes[currentNodeID].isLeaf());
         int leftChild = mNodes[currentNodeID].children[0];
@@ -349,8 +437,6 @@ void DynamicAABBTree::insertLeafNode(int nodeID) {
 
         currentNodeID = mNodes[currentNodeID].parentID;
     }
-
-    assert(mNodes[nodeID].isLeaf());
 }
 
 // Remove a leaf node from the tree
@@ -597,21 +683,40 @@ int DynamicAABBTree::balanceSubTreeAtNode(int nodeID) {
 void DynamicAABBTree::reportAllShapesOverlappingWithAABB(const AABB& aabb,
                                                          DynamicAABBTreeOverlapCallback& callback) const {
 
-    // Create a stack with the nodes to visit
-    Stack<int, 64> stack(mAllocator);
-    stack.push(mRootNodeID);
+    DynamicAABBTreeQueryContext context(mAllocator);
+    reportAllShapesOverlappingWithAABB(aabb, callback, context);
+}
+
+// Report all shapes overlapping with the AABB given in parameter using a query context
+/// The stack of the context is reserved for the height of the tree before the traversal and
+/// the children of a node are prefetched when they are pushed into the stack. A context
+/// that is reused by many queries avoids to allocate the stack of a deep tree at each query.
+/**
+ * @param aabb The AABB of the query
+ * @param callback The callback notified of each leaf overlapping with the AABB
+ * @param context The query context that contains the stack of the traversal
+ */
+void DynamicAABBTree::reportAllShapesOverlappingWithAABB(const AABB& aabb, DynamicAABBTreeOverlapCallback& callback,
+                                                         DynamicAABBTreeQueryContext& context) const {
+
+    uint64 nbVisitedNodes = 0;
+
+    // Reserve the stack with the nodes to visit
+    int* stack = context.reserveStack(getQueryStackSize());
+    uint nbStackNodes = 0;
+    if (mRootNodeID != TreeNode::NULL_TREE_NODE) {
+        stack[nbStackNodes++] = mRootNodeID;
+    }
 
     // While there are still nodes to visit
-    while(stack.getNbElements() > 0) {
+    while(nbStackNodes > 0) {
 
         // Get the next node ID to visit
-        int nodeIDToVisit = stack.pop();
-
-        // Skip it if it is a null node
-        if (nodeIDToVisit == TreeNode::NULL_TREE_NODE) continue;
+        int nodeIDToVisit = stack[--nbStackNodes];
 
         // Get the corresponding node
         const TreeNode* nodeToVisit = mNodes + nodeIDToVisit;
+        nbVisitedNodes++;
 
         // If the AABB in parameter overlaps with the AABB of the node to visit
         if (aabb.testCollision(nodeToVisit->aabb)) {
@@ -625,11 +730,23 @@ void DynamicAABBTree::reportAllShapesOverlappingWithAABB(const AABB& aabb,
             else {  // If the node is not a leaf
 
                 // We need to visit its children
-                stack.push(nodeToVisit->children[0]);
-                stack.push(nodeToVisit->children[1]);
+                RP3D_PREFETCH(mNodes + nodeToVisit->children[0]);
+                RP3D_PREFETCH(mNodes + nodeToVisit->children[1]);
+                assert(nbStackNodes + 2 <= getQueryStackSize());
+                stack[nbStackNodes++] = nodeToVisit->children[0];
+                stack[nbStackNodes++] = nodeToVisit->children[1];
             }
         }
     }
+
+    // Test the leaves that have not been inserted into the tree yet
+    for (uint i=0; i < mDeferredLeaves.size(); i++) {
+        if (aabb.testCollision(mNodes[mDeferredLeaves[i]].aabb)) {
+            callback.notifyOverlappingNode(mDeferredLeaves[i]);
+        }
+    }
+
+    countQuery(nbVisitedNodes + mDeferredLeaves.size());
 }
 
 // Ray casting method
@@ -637,61 +754,551 @@ void DynamicAABBTree::raycast(const Ray& ray, DynamicAABBTreeRaycastCallback &ca
 
     RP3D_PROFILE("DynamicAABBTree::raycast()", mProfiler);
 
-    decimal maxFraction = ray.maxFraction;
+    auto leafFunction = [&callback](int32 nodeID, const Ray& rayTemp) {
+        return callback.raycastBroadPhaseShape(nodeID, rayTemp);
+    };
+    raycastLeaves(ray, leafFunction, false);
+}
+
+// Ray casting method for a packet of at most RAYCAST_PACKET_SIZE rays
+/// The rays of the packet walk through the tree together. A node is tested against all the
+/// rays of the packet that have hit its parent at once and its children are only visited
+/// by the rays that hit the node. The packet therefore descends the tree only once for rays
+/// that are close to each other. The max fraction of each ray is clipped at the hit fractions
+/// returned by the callback and is set to zero if the callback stops the ray (a hit fraction
+/// of zero only stops the ray of this hit). The rays with a max fraction of zero are not cast.
+void DynamicAABBTree::raycastPacket(Ray* rays, uint nbRays, DynamicAABBTreeRaycastPacketCallback& callback) const {
+
+    assert(nbRays <= RAYCAST_PACKET_SIZE);
+
+    RP3D_PROFILE("DynamicAABBTree::raycastPacket()", mProfiler);
+
+    using RayLanes = Vector3Lanes<decimal, RAYCAST_PACKET_SIZE>;
+    using PacketMask = LaneMask<RAYCAST_PACKET_SIZE>;
+
+    // Node to visit with the rays of the packet that have hit its parent
+    struct PacketNode {
+        int nodeID;
+        PacketMask rays;
+    };
+
+    // The unused lanes contain a copy of the first ray and are never active
+    RayLanes points1;
+    RayLanes segments;
+    Lanes<decimal, RAYCAST_PACKET_SIZE> maxFractions;
+    PacketMask isActive;
+    for (uint l=0; l < RAYCAST_PACKET_SIZE; l++) {
+        const Ray& ray = rays[l < nbRays ? l : 0];
+        points1.setLane(l, ray.point1);
+        segments.setLane(l, ray.point2 - ray.point1);
+        maxFractions[l] = ray.maxFraction;
+        isActive[l] = l < nbRays && ray.maxFraction > decimal(0.0);
+    }
+    if (!isActive.any()) return;
+
+    // Report a hit of a leaf to the callback and clip or stop its ray
+    auto raycastLeaf = [&](int nodeID, uint l) {
+
+        decimal hitFraction = callback.raycastBroadPhaseShape(nodeID, l, rays[l]);
+
+        // If the user returned a hitFraction of zero, the ray stops here
+        if (hitFraction == decimal(0.0)) {
+            isActive[l] = false;
+            maxFractions[l] = decimal(0.0);
+            rays[l].maxFraction = decimal(0.0);
+        }
+        else if (hitFraction > decimal(0.0) && hitFraction < maxFractions[l]) {
+            maxFractions[l] = hitFraction;
+            rays[l].maxFraction = hitFraction;
+        }
+    };
+
+    uint64 nbVisitedNodes = 0;
+
+    Stack<PacketNode, 128> stack(mAllocator);
+    stack.push({mRootNodeID, isActive});
+
+    while (stack.getNbElements() > 0) {
+
+        PacketNode packetNode = stack.pop();
+
+        if (packetNode.nodeID == TreeNode::NULL_TREE_NODE) continue;
+
+        // Test the AABB of the node with the rays that are still active (with their
+        // current max fraction)
+        PacketMask isHit = packetNode.rays && isActive;
+        if (!isHit.any()) continue;
+        const TreeNode* node = mNodes + packetNode.nodeID;
+        nbVisitedNodes++;
+        isHit = isHit && node->aabb.testRayIntersect(points1, points1 + maxFractions * segments);
+        if (!isHit.any()) continue;
+
+        if (node->isLeaf()) {
+            for (uint l=0; l < nbRays; l++) {
+                if (isHit[l] && isActive[l]) raycastLeaf(packetNode.nodeID, l);
+            }
+        }
+        else {
+            stack.push({node->children[0], isHit});
+            stack.push({node->children[1], isHit});
+        }
+    }
+
+    // Test the leaves that have not been inserted into the tree yet
+    for (uint i=0; i < mDeferredLeaves.size(); i++) {
+
+        const PacketMask isHit = isActive &&
+                mNodes[mDeferredLeaves[i]].aabb.testRayIntersect(points1, points1 + maxFractions * segments);
+        for (uint l=0; l < nbRays; l++) {
+            if (isHit[l] && isActive[l]) raycastLeaf(mDeferredLeaves[i], l);
+        }
+    }
+
+    countQuery(nbVisitedNodes + mDeferredLeaves.size());
+}
+
+// Insert the deferred objects into the tree
+/// If many objects have been added since the last call (while loading a level for instance),
+/// the whole tree is built again with the surface area heuristic. This is much faster than
+/// inserting the objects one by one and it gives a better tree. Otherwise, the objects are
+/// inserted one by one. The build uses the task scheduler in parameter if it is not null.
+void DynamicAABBTree::insertDeferredObjects(TaskScheduler* taskScheduler) {
+
+    if (mDeferredLeaves.size() == 0) return;
+
+    RP3D_PROFILE("DynamicAABBTree::insertDeferredObjects()", mProfiler);
+
+    const int nbDeferredLeaves = static_cast<int>(mDeferredLeaves.size());
+    const int nbInsertedLeaves = getNbObjects() - nbDeferredLeaves;
+
+    if (nbDeferredLeaves * 4 >= nbInsertedLeaves) {
+        rebuildWithSAH(taskScheduler);
+    }
+    else {
+        for (int i=0; i < nbDeferredLeaves; i++) {
+            insertLeafNode(mDeferredLeaves[i]);
+        }
+        mDeferredLeaves.clear();
+    }
+
+    assert(mDeferredLeaves.size() == 0);
+}
+
+// Insert the deferred objects into the tree as a single sub-tree
+/// The deferred leaves are built into a sub-tree with the surface area heuristic and the
+/// root of the sub-tree is inserted into the tree like a leaf. The cost does not depend on
+/// the number of objects already in the tree. This is meant for a group of objects close to
+/// each other (a chunk of a streamed level for instance). The quality of the tree is worse
+/// than with insertDeferredObjects() if the objects are spread over the tree.
+void DynamicAABBTree::insertDeferredObjectsAsSubTree() {
+
+    if (mDeferredLeaves.size() == 0) return;
+
+    RP3D_PROFILE("DynamicAABBTree::insertDeferredObjectsAsSubTree()", mProfiler);
+
+    const int nbLeaves = static_cast<int>(mDeferredLeaves.size());
+    int* leaves = static_cast<int*>(mAllocator.allocate(nbLeaves * sizeof(int)));
+    for (int i=0; i < nbLeaves; i++) {
+        leaves[i] = mDeferredLeaves[i];
+    }
+    mDeferredLeaves.clear();
+
+    const int nbInternalNodes = nbLeaves - 1;
+    int* internalNodes = static_cast<int*>(mAllocator.allocate(std::max(nbInternalNodes, 1) * sizeof(int)));
+    for (int i=0; i < nbInternalNodes; i++) {
+        internalNodes[i] = allocateNode();
+    }
 
-    Stack<int, 128> stack(mAllocator);
+    // Build the sub-tree and graft it into the tree
+    const int subTreeRootID = buildSubTreeWithSAH(leaves, nbLeaves, internalNodes);
+    mNodes[subTreeRootID].parentID = TreeNode::NULL_TREE_NODE;
+    insertLeafNode(subTreeRootID);
+
+    mAllocator.release(internalNodes, std::max(nbInternalNodes, 1) * sizeof(int));
+    mAllocator.release(leaves, nbLeaves * sizeof(int));
+}
+
+// Move the AABBs of all the nodes by a given translation
+/// The structure of the tree does not change because all the AABBs are moved together.
+void DynamicAABBTree::translate(const Vector3& translation) {
+
+    for (int i=0; i < mNbAllocatedNodes; i++) {
+
+        // If the node is used (in the tree or a deferred leaf)
+        if (mNodes[i].height >= 0) {
+            mNodes[i].aabb.translate(translation);
+        }
+    }
+}
+
+// Return the cost of the queries in the tree
+/// The cost is the sum of the surface areas of the internal nodes divided by the surface
+/// area of the root node. It is the expected number of internal nodes visited by a query
+/// and it grows when the tree degrades with the updates of the moving objects.
+decimal DynamicAABBTree::computeCost() const {
+
+    if (mRootNodeID == TreeNode::NULL_TREE_NODE || mNodes[mRootNodeID].isLeaf()) {
+        return decimal(0.0);
+    }
+
+    const decimal rootSurfaceArea = mNodes[mRootNodeID].aabb.getSurfaceArea();
+    if (rootSurfaceArea <= MACHINE_EPSILON) return decimal(0.0);
+
+    decimal sumSurfaceAreas = decimal(0.0);
+    Stack<int, 64> stack(mAllocator);
     stack.push(mRootNodeID);
+    while (stack.getNbElements() > 0) {
+
+        const TreeNode& node = mNodes[stack.pop()];
+
+        if (!node.isLeaf()) {
+            sumSurfaceAreas += node.aabb.getSurfaceArea();
+            stack.push(node.children[0]);
+            stack.push(node.children[1]);
+        }
+    }
+
+    return sumSurfaceAreas / rootSurfaceArea;
+}
+
+// Compute the metrics of the quality of the tree
+/// The tree is traversed once and the cost of this method is linear in the number of nodes.
+/// The query counters are copied in the statistics but they are not reset.
+/**
+ * @param[out] statistics The statistics of the tree
+ */
+void DynamicAABBTree::computeStatistics(DynamicAABBTreeStatistics& statistics) const {
+
+    statistics = DynamicAABBTreeStatistics();
+    statistics.nbNodes = mNbNodes;
+    statistics.nbDeferredLeaves = static_cast<int>(mDeferredLeaves.size());
+    statistics.cost = computeCost();
+    statistics.nbQueries = getNbQueries();
+    statistics.nbQueryVisitedNodes = getNbQueryVisitedNodes();
+
+    if (mRootNodeID == TreeNode::NULL_TREE_NODE) return;
+
+    statistics.height = mNodes[mRootNodeID].height;
+
+    // Node to visit with its depth in the tree
+    struct NodeDepth {
+        int nodeID;
+        int depth;
+    };
+
+    decimal sumChildrenSurfaceAreas = decimal(0.0);
+    decimal sumOverlapSurfaceAreas = decimal(0.0);
+    Stack<NodeDepth, 64> stack(mAllocator);
+    stack.push({mRootNodeID, 0});
+    while (stack.getNbElements() > 0) {
+
+        const NodeDepth nodeDepth = stack.pop();
+        const TreeNode& node = mNodes[nodeDepth.nodeID];
+
+        if (node.isLeaf()) {
+            statistics.nbLeaves++;
+            statistics.totalLeafDepth += nodeDepth.depth;
+            continue;
+        }
 
-    // Walk through the tree from the root looking for proxy shapes
-    // that overlap with the ray AABB
+        // Surface area of the overlap between the two children of the node
+        const AABB& aabb1 = mNodes[node.children[0]].aabb;
+        const AABB& aabb2 = mNodes[node.children[1]].aabb;
+        sumChildrenSurfaceAreas += aabb1.getSurfaceArea() + aabb2.getSurfaceArea();
+        if (aabb1.testCollision(aabb2)) {
+            const AABB overlap(Vector3::max(aabb1.getMin(), aabb2.getMin()),
+                               Vector3::min(aabb1.getMax(), aabb2.getMax()));
+            sumOverlapSurfaceAreas += overlap.getSurfaceArea();
+        }
+
+        stack.push({node.children[0], nodeDepth.depth + 1});
+        stack.push({node.children[1], nodeDepth.depth + 1});
+    }
+
+    statistics.averageLeafDepth = decimal(statistics.totalLeafDepth) / decimal(statistics.nbLeaves);
+    if (sumChildrenSurfaceAreas > MACHINE_EPSILON) {
+        statistics.siblingOverlapRatio = sumOverlapSurfaceAreas / sumChildrenSurfaceAreas;
+    }
+}
+
+// Start a new pass of the incremental refinement of the tree from its first node
+void DynamicAABBTree::startIncrementalRefinement() {
+    mRefinementNodeID = 0;
+}
+
+// Reinsert the leaves of the next nodes of the incremental refinement of the tree
+/// Each leaf is removed and inserted again at the best place of the current tree. A pass over
+/// all the nodes of the tree gives a tree of better quality at a much smaller cost per call than
+/// rebuildWithSAH(). The leaves keep their IDs and their fat AABBs.
+/**
+ * @param nbNodes Number of nodes of the tree to visit (only the leaves are reinserted)
+ * @param[out] nbReinsertedLeaves Number of leaves reinserted by this call
+ * @return True if all the nodes of the tree have been visited since the start of the pass
+ */
+bool DynamicAABBTree::refineIncrementally(int nbNodes, int& nbReinsertedLeaves) {
+
+    nbReinsertedLeaves = 0;
+
+    const int endNodeID = std::min(mRefinementNodeID + nbNodes, mNbAllocatedNodes);
+    for (; mRefinementNodeID < endNodeID; mRefinementNodeID++) {
+
+        const int nodeID = mRefinementNodeID;
+
+        // Skip the free nodes, the internal nodes, the deferred leaves and a single leaf
+        if (mNodes[nodeID].height != 0 || isDeferredLeaf(nodeID) || nodeID == mRootNodeID) continue;
+
+        removeLeafNode(nodeID);
+        insertLeafNode(nodeID);
+        nbReinsertedLeaves++;
+    }
+
+    return mRefinementNodeID >= mNbAllocatedNodes;
+}
+
+// Rebuild the internal nodes of the tree with the surface area heuristic
+/// The leaf nodes keep their IDs. The internal nodes are built again from the top
+/// with a binned surface area heuristic (SAH). This gives a tree of better quality
+/// than the incremental insertions but it is too expensive to be done at each frame.
+/// The deferred objects are inserted into the tree. If a task scheduler is given, the
+/// top of the tree is built first and its sub-trees are then built in parallel.
+void DynamicAABBTree::rebuildWithSAH(TaskScheduler* taskScheduler) {
+
+    RP3D_PROFILE("DynamicAABBTree::rebuildWithSAH()", mProfiler);
+
+    if (mRootNodeID == TreeNode::NULL_TREE_NODE && mDeferredLeaves.size() == 0) return;
+
+    // Gather the leaf nodes and release the internal nodes of the tree
+    const int nbNodes = mNbNodes;
+    int* leaves = static_cast<int*>(mAllocator.allocate(nbNodes * sizeof(int)));
+    int nbLeaves = 0;
+    Stack<int, 64> stack(mAllocator);
+    stack.push(mRootNodeID);
     while (stack.getNbElements() > 0) {
 
-        // Get the next node in the stack
         int nodeID = stack.pop();
 
-        // If it is a null node, skip it
         if (nodeID == TreeNode::NULL_TREE_NODE) continue;
 
-        // Get the corresponding node
-        const TreeNode* node = mNodes + nodeID;
+        if (mNodes[nodeID].isLeaf()) {
+            leaves[nbLeaves] = nodeID;
+            nbLeaves++;
+        }
+        else {
+            stack.push(mNodes[nodeID].children[0]);
+            stack.push(mNodes[nodeID].children[1]);
+            releaseNode(nodeID);
+        }
+    }
+    for (uint i=0; i < mDeferredLeaves.size(); i++) {
+        leaves[nbLeaves] = mDeferredLeaves[i];
+        nbLeaves++;
+    }
+    mDeferredLeaves.clear();
+
+    // Allocate all the internal nodes before the build so that the sub-trees
+    // can be built in parallel without reallocating the array of nodes
+    const int nbInternalNodes = nbLeaves - 1;
+    int* internalNodes = static_cast<int*>(mAllocator.allocate(std::max(nbInternalNodes, 1) * sizeof(int)));
+    for (int i=0; i < nbInternalNodes; i++) {
+        internalNodes[i] = allocateNode();
+    }
 
-        Ray rayTemp(ray.point1, ray.point2, maxFraction);
+    // Build the tree again
+    if (taskScheduler != nullptr && taskScheduler->getNbWorkers() > 1 &&
+        nbLeaves > 2 * SAH_PARALLEL_BUILD_MIN_NB_LEAVES) {
 
-        // Test if the ray intersects with the current node AABB
-        if (!node->aabb.testRayIntersect(rayTemp)) continue;
+        List<SAHSubTree> subTrees(mAllocator);
+        List<int> topNodes(mAllocator);
+        buildTopOfTreeWithSAH(leaves, nbLeaves, internalNodes, TreeNode::NULL_TREE_NODE, 0, subTrees, topNodes);
 
-        // If the node is a leaf of the tree
-        if (node->isLeaf()) {
+        // Build the sub-trees in parallel
+        taskScheduler->parallelFor(static_cast<uint>(subTrees.size()), [&](uint taskIndex) {
+            SAHSubTree& subTree = subTrees[taskIndex];
+            subTree.rootNodeID = buildSubTreeWithSAH(subTree.leaves, subTree.nbLeaves, subTree.internalNodes);
+        });
 
-            // Call the callback that will raycast again the broad-phase shape
-            decimal hitFraction = callback.raycastBroadPhaseShape(nodeID, rayTemp);
+        // Link the sub-trees to the top of the tree
+        for (uint i=0; i < subTrees.size(); i++) {
+            mNodes[subTrees[i].parentID].children[subTrees[i].childIndex] = subTrees[i].rootNodeID;
+            mNodes[subTrees[i].rootNodeID].parentID = subTrees[i].parentID;
+        }
 
-            // If the user returned a hitFraction of zero, it means that
-            // the raycasting should stop here
-            if (hitFraction == decimal(0.0)) {
-                return;
-            }
+        // Compute the AABBs and heights of the top nodes from the bottom (a parent
+        // node is always before its children in the list)
+        for (int i = static_cast<int>(topNodes.size()) - 1; i >= 0; i--) {
+            const int nodeID = topNodes[i];
+            linkInternalNode(nodeID, mNodes[nodeID].children[0], mNodes[nodeID].children[1]);
+        }
+    }
+    else {
+        mRootNodeID = buildSubTreeWithSAH(leaves, nbLeaves, internalNodes);
+    }
+    mNodes[mRootNodeID].parentID = TreeNode::NULL_TREE_NODE;
+
+    mAllocator.release(internalNodes, std::max(nbInternalNodes, 1) * sizeof(int));
+    mAllocator.release(leaves, nbNodes * sizeof(int));
+}
 
-            // If the user returned a positive fraction
-            if (hitFraction > decimal(0.0)) {
+// Split an array of leaf nodes in two groups with the surface area heuristic
+/// The leaves are split in two groups along the axis where their centers are the
+/// most spread. The centers are put into bins and the split between two bins that
+/// minimizes the sum of the surface areas of the groups times their number of leaves
+/// is selected. The leaves of the first group are moved at the beginning of the array
+/// and the method returns their number.
+int DynamicAABBTree::splitLeavesWithSAH(int* leaves, int nbLeaves) const {
+
+    const int NB_BINS = 16;
+
+    assert(nbLeaves > 1);
+
+    // Compute the bounds of the centers of the leaves
+    Vector3 centersMin = mNodes[leaves[0]].aabb.getCenter();
+    Vector3 centersMax = centersMin;
+    for (int i=1; i < nbLeaves; i++) {
+        const Vector3 center = mNodes[leaves[i]].aabb.getCenter();
+        centersMin = Vector3::min(centersMin, center);
+        centersMax = Vector3::max(centersMax, center);
+    }
+
+    // Select the axis where the centers are the most spread
+    const Vector3 extent = centersMax - centersMin;
+    const int axis = extent.getMaxAxis();
+
+    // If all the centers are at the same position, the leaves are split in two halves
+    int nbLeftLeaves = nbLeaves / 2;
+
+    if (extent[axis] > MACHINE_EPSILON) {
 
-                // We update the maxFraction value and the ray
-                // AABB using the new maximum fraction
-                if (hitFraction < maxFraction) {
-                    maxFraction = hitFraction;
-                }
+        const decimal binScale = decimal(NB_BINS) / extent[axis];
+
+        // Put the leaves into the bins
+        AABB binAABBs[NB_BINS];
+        int binNbLeaves[NB_BINS] = {0};
+        for (int i=0; i < nbLeaves; i++) {
+            const AABB& aabb = mNodes[leaves[i]].aabb;
+            const int bin = std::min(NB_BINS - 1, static_cast<int>((aabb.getCenter()[axis] - centersMin[axis]) * binScale));
+            if (binNbLeaves[bin] == 0) {
+                binAABBs[bin] = aabb;
+            }
+            else {
+                binAABBs[bin].mergeWithAABB(aabb);
             }
+            binNbLeaves[bin]++;
+        }
 
-            // If the user returned a negative fraction, we continue
-            // the raycasting as if the proxy shape did not exist
+        // Compute the surface area of the groups on the right of each split
+        decimal rightCosts[NB_BINS];
+        AABB rightAABB;
+        int nbRightLeaves = 0;
+        for (int b=NB_BINS - 1; b > 0; b--) {
+            if (binNbLeaves[b] > 0) {
+                if (nbRightLeaves == 0) rightAABB = binAABBs[b];
+                else rightAABB.mergeWithAABB(binAABBs[b]);
+                nbRightLeaves += binNbLeaves[b];
+            }
+            rightCosts[b] = nbRightLeaves > 0 ? rightAABB.getSurfaceArea() * decimal(nbRightLeaves) : decimal(0.0);
         }
-        else {  // If the node has children
 
-            // Push its children in the stack of nodes to explore
-            stack.push(node->children[0]);
-            stack.push(node->children[1]);
+        // Find the split with the smallest cost
+        int bestSplit = -1;
+        decimal bestCost = DECIMAL_LARGEST;
+        AABB leftAABB;
+        int nbLeaves0 = 0;
+        for (int b=0; b < NB_BINS - 1; b++) {
+            if (binNbLeaves[b] > 0) {
+                if (nbLeaves0 == 0) leftAABB = binAABBs[b];
+                else leftAABB.mergeWithAABB(binAABBs[b]);
+                nbLeaves0 += binNbLeaves[b];
+            }
+            if (nbLeaves0 == 0 || nbLeaves0 == nbLeaves) continue;
+            const decimal cost = leftAABB.getSurfaceArea() * decimal(nbLeaves0) + rightCosts[b + 1];
+            if (cost < bestCost) {
+                bestCost = cost;
+                bestSplit = b;
+            }
         }
+
+        // The first and last bins are never empty and therefore there is always a split
+        assert(bestSplit >= 0);
+
+        // Move the leaves of the left group at the beginning of the array
+        int* middle = std::partition(leaves, leaves + nbLeaves, [&](int nodeID) {
+            const decimal center = mNodes[nodeID].aabb.getCenter()[axis];
+            return std::min(NB_BINS - 1, static_cast<int>((center - centersMin[axis]) * binScale)) <= bestSplit;
+        });
+        nbLeftLeaves = static_cast<int>(middle - leaves);
     }
+
+    assert(nbLeftLeaves > 0 && nbLeftLeaves < nbLeaves);
+
+    return nbLeftLeaves;
+}
+
+// Build a sub-tree from an array of leaf nodes with the surface area heuristic
+/// The "internalNodes" array contains the IDs of the (nbLeaves - 1) allocated nodes
+/// to use as internal nodes of the sub-tree. The method returns the ID of the root
+/// node of the sub-tree.
+int DynamicAABBTree::buildSubTreeWithSAH(int* leaves, int nbLeaves, const int* internalNodes) {
+
+    assert(nbLeaves > 0);
+
+    if (nbLeaves == 1) return leaves[0];
+
+    const int nbLeftLeaves = splitLeavesWithSAH(leaves, nbLeaves);
+
+    // Build the two sub-trees
+    const int leftChildID = buildSubTreeWithSAH(leaves, nbLeftLeaves, internalNodes + 1);
+    const int rightChildID = buildSubTreeWithSAH(leaves + nbLeftLeaves, nbLeaves - nbLeftLeaves,
+                                                 internalNodes + nbLeftLeaves);
+
+    // Create the internal node
+    const int nodeID = internalNodes[0];
+    linkInternalNode(nodeID, leftChildID, rightChildID);
+
+    return nodeID;
+}
+
+// Build the top of the tree and gather the sub-trees to build in parallel
+/// The large groups of leaves are split like in buildSubTreeWithSAH(). The groups with
+/// less than SAH_PARALLEL_BUILD_MIN_NB_LEAVES leaves are added to the "subTrees" list and
+/// the internal nodes of the top of the tree are added to the "topNodes" list. The AABBs
+/// and heights of the top nodes are computed once the sub-trees have been built.
+void DynamicAABBTree::buildTopOfTreeWithSAH(int* leaves, int nbLeaves, const int* internalNodes, int parentID,
+                                            int childIndex, List<SAHSubTree>& subTrees, List<int>& topNodes) {
+
+    if (nbLeaves <= SAH_PARALLEL_BUILD_MIN_NB_LEAVES) {
+        assert(parentID != TreeNode::NULL_TREE_NODE);
+        subTrees.add(SAHSubTree{leaves, nbLeaves, internalNodes, parentID, childIndex, TreeNode::NULL_TREE_NODE});
+        return;
+    }
+
+    const int nbLeftLeaves = splitLeavesWithSAH(leaves, nbLeaves);
+
+    const int nodeID = internalNodes[0];
+    topNodes.add(nodeID);
+    mNodes[nodeID].parentID = parentID;
+    if (parentID == TreeNode::NULL_TREE_NODE) {
+        mRootNodeID = nodeID;
+    }
+    else {
+        mNodes[parentID].children[childIndex] = nodeID;
+    }
+
+    buildTopOfTreeWithSAH(leaves, nbLeftLeaves, internalNodes + 1, nodeID, 0, subTrees, topNodes);
+    buildTopOfTreeWithSAH(leaves + nbLeftLeaves, nbLeaves - nbLeftLeaves, internalNodes + nbLeftLeaves,
+                          nodeID, 1, subTrees, topNodes);
+}
+
+// Set the children of an internal node and compute its AABB and height
+void DynamicAABBTree::linkInternalNode(int nodeID, int leftChildID, int rightChildID) {
+
+    TreeNode& node = mNodes[nodeID];
+    node.children[0] = leftChildID;
+    node.children[1] = rightChildID;
+    node.aabb.mergeTwoAABBs(mNodes[leftChildID].aabb, mNodes[rightChildID].aabb);
+    node.height = 1 + std::max(mNodes[leftChildID].height, mNodes[rightChildID].height);
+    mNodes[leftChildID].parentID = nodeID;
+    mNodes[rightChildID].parentID = nodeID;
 }
 
 #ifndef NDEBUG
@@ -29,6 +29,10 @@
 // Libraries
 #include "configuration.h"
 #include "collision/shapes/AABB.h"
+#include "containers/List.h"
+#include "containers/Stack.h"
+#include <utility>
+#include <atomic>
 
 /// Namespace ReactPhysics3D
 namespace reactphysics3d {
@@ -42,6 +46,7 @@ struct RaycastTest;
 class AABB;
 class Profiler;
 class MemoryAllocator;
+class TaskScheduler;
 
 
 // Structure TreeNode
@@ -126,6 +131,134 @@ class DynamicAABBTreeRaycastCallback {
 
 };
 
+// Class DynamicAABBTreeRaycastPacketCallback
+/**
+ * Raycast callback in the Dynamic AABB Tree called when the AABB of a leaf
+ * node is hit by one of the rays of a packet.
+ */
+class DynamicAABBTreeRaycastPacketCallback {
+
+    public:
+
+        // Called when the AABB of a leaf node is hit by the ray of a packet at a given index
+        virtual decimal raycastBroadPhaseShape(int32 nodeId, uint rayIndex, const Ray& ray)=0;
+
+        virtual ~DynamicAABBTreeRaycastPacketCallback() = default;
+
+};
+
+// Structure DynamicAABBTreeStatistics
+/**
+ * This structure contains metrics of the quality of a dynamic AABB tree (see
+ * DynamicAABBTree::computeStatistics()). They are cheap enough to be computed from time
+ * to time in order to see when the tree degrades with the updates of the moving objects.
+ */
+struct DynamicAABBTreeStatistics {
+
+    // -------------------- Attributes -------------------- //
+
+    /// Number of nodes of the tree (internal nodes, leaves and deferred leaves)
+    int nbNodes = 0;
+
+    /// Number of leaves inserted into the tree
+    int nbLeaves = 0;
+
+    /// Number of leaves that have been added but not inserted into the tree yet
+    int nbDeferredLeaves = 0;
+
+    /// Height of the tree (zero if the tree is empty or only has a leaf)
+    int height = 0;
+
+    /// Sum of the depths of the leaves inserted into the tree
+    uint64 totalLeafDepth = 0;
+
+    /// Average depth of the leaves inserted into the tree
+    decimal averageLeafDepth = decimal(0.0);
+
+    /// Cost of the queries in the tree (see DynamicAABBTree::computeCost())
+    decimal cost = decimal(0.0);
+
+    /// Sum of the surface areas of the overlaps between two sibling nodes divided by the
+    /// sum of the surface areas of the children of the internal nodes (zero if the siblings
+    /// never overlap). The larger the fat AABBs, the larger the ratio.
+    decimal siblingOverlapRatio = decimal(0.0);
+
+    /// Number of queries (overlap queries, raycasts or packets of rays) counted in the tree
+    uint64 nbQueries = 0;
+
+    /// Number of nodes visited by the queries counted in the tree
+    uint64 nbQueryVisitedNodes = 0;
+};
+
+// Class DynamicAABBTreeQueryContext
+/**
+ * This class contains the stack of nodes used by the traversals of the overlap queries and
+ * raycasts of a dynamic AABB tree. The stack is reserved once for the height of the tree at
+ * the beginning of a traversal (so that the nodes are pushed without any check of capacity)
+ * and a context can be reused by many queries so that a deep tree only allocates its stack
+ * once. A context must not be used by two queries at the same time.
+ */
+class DynamicAABBTreeQueryContext {
+
+    private:
+
+        // -------------------- Constants -------------------- //
+
+        /// Number of nodes of the stack that do not need any allocation
+        static const uint NB_INITIAL_STACK_NODES = 64;
+
+        // -------------------- Attributes -------------------- //
+
+        /// Memory allocator of the stack when it is larger than its initial array
+        MemoryAllocator& mAllocator;
+
+        /// Initial array of the stack
+        int mInitialStack[NB_INITIAL_STACK_NODES];
+
+        /// Nodes of the stack
+        int* mStack;
+
+        /// Number of nodes that can be pushed into the stack
+        uint mStackCapacity;
+
+        // -------------------- Methods -------------------- //
+
+        /// Allocate a larger stack
+        void growStack(uint nbNodes);
+
+    public:
+
+        // -------------------- Methods -------------------- //
+
+        /// Constructor
+        DynamicAABBTreeQueryContext(MemoryAllocator& allocator)
+            : mAllocator(allocator), mStack(mInitialStack), mStackCapacity(NB_INITIAL_STACK_NODES) {
+
+        }
+
+        /// Destructor
+        ~DynamicAABBTreeQueryContext();
+
+        /// Deleted copy-constructor
+        DynamicAABBTreeQueryContext(const DynamicAABBTreeQueryContext& context) = delete;
+
+        /// Deleted assignment operator
+        DynamicAABBTreeQueryContext& operator=(const DynamicAABBTreeQueryContext& context) = delete;
+
+        /// Return a stack where a given number of nodes can be pushed
+        int* reserveStack(uint nbNodes);
+};
+
+// Return a stack where a given number of nodes can be pushed
+inline int* DynamicAABBTreeQueryContext::reserveStack(uint nbNodes) {
+
+    if (nbNodes > mStackCapacity) {
+        growStack(nbNodes);
+    }
+
+    return mStack;
+}
+
 // Class DynamicAABBTree
 /**
  * This class implements a dynamic AABB tree that is used for broad-phase
@@ -138,6 +271,35 @@ class DynamicAABBTree {
 
     private:
 
+        // -------------------- Constants -------------------- //
+
+        /// Minimum number of leaves of a sub-tree built in its own task
+        static const int SAH_PARALLEL_BUILD_MIN_NB_LEAVES;
+
+        // -------------------- Types -------------------- //
+
+        /// Sub-tree built in parallel by a task during a build with the surface area heuristic
+        struct SAHSubTree {
+
+            /// Pointer to the leaves of the sub-tree
+            int* leaves;
+
+            /// Number of leaves of the sub-tree
+            int nbLeaves;
+
+            /// IDs of the internal nodes to use for the sub-tree
+            const int* internalNodes;
+
+            /// ID of the parent node of the sub-tree
+            int parentID;
+
+            /// Index of the sub-tree in the children of its parent node
+            int childIndex;
+
+            /// ID of the root node of the sub-tree once it has been built
+            int rootNodeID;
+        };
+
         // -------------------- Attributes -------------------- //
 
         /// Memory allocator
@@ -162,6 +324,21 @@ class DynamicAABBTree {
         /// without triggering a large modification of the tree which can be costly
         decimal mExtraAABBGap;
 
+        /// IDs of the leaf nodes that have been added but not inserted into the tree yet
+        List<int> mDeferredLeaves;
+
+        /// ID of the next node visited by the incremental refinement of the tree
+        int mRefinementNodeID;
+
+        /// True if the queries and the nodes they visit are counted
+        bool mIsQueryCountingEnabled;
+
+        /// Number of queries since the counters have been reset (if counted)
+        mutable std::atomic<uint64> mNbQueries;
+
+        /// Number of nodes visited by the queries since the counters have been reset (if counted)
+        mutable std::atomic<uint64> mNbQueryVisitedNodes;
+
 #ifdef IS_PROFILING_ACTIVE
 
 		/// Pointer to the profiler
@@ -174,10 +351,13 @@ class DynamicAABBTree {
         /// Allocate and return a node to use in the tree
         int allocateNode();
 
+        /// Allocate a larger array of nodes (the new nodes are added to the free nodes)
+        void growNodes(int nbAllocatedNodes);
+
         /// Release a node
         void releaseNode(int nodeID);
 
-        /// Insert a leaf node in the tree
+        /// Insert a leaf node (or the root of a sub-tree) in the tree
         void insertLeafNode(int nodeID);
 
         /// Remove a leaf node from the tree
@@ -192,9 +372,28 @@ class DynamicAABBTree {
         /// Internally add an object into the tree
         int addObjectInternal(const AABB& aabb);
 
+        /// Return true if a leaf node has been added but not inserted into the tree yet
+        bool isDeferredLeaf(int nodeID) const;
+
+        /// Split an array of leaf nodes in two groups with the surface area heuristic
+        int splitLeavesWithSAH(int* leaves, int nbLeaves) const;
+
+        /// Build a sub-tree from an array of leaf nodes with the surface area heuristic
+        int buildSubTreeWithSAH(int* leaves, int nbLeaves, const int* internalNodes);
+
+        /// Build the top of the tree and gather the sub-trees to build in parallel
+        void buildTopOfTreeWithSAH(int* leaves, int nbLeaves, const int* internalNodes, int parentID,
+                                   int childIndex, List<SAHSubTree>& subTrees, List<int>& topNodes);
+
+        /// Set the children of an internal node and compute its AABB and height
+        void linkInternalNode(int nodeID, int leftChildID, int rightChildID);
+
         /// Initialize the tree
         void init();
 
+        /// Add the nodes visited by a query to the query counters (if enabled)
+        void countQuery(uint64 nbVisitedNodes) const;
+
 #ifndef NDEBUG
 
         /// Check if the tree structure is valid (for debugging purpose)
@@ -221,12 +420,34 @@ class DynamicAABBTree {
         /// Add an object into the tree (where node data is a pointer)
         int addObject(const AABB& aabb, void* data);
 
+        /// Add an object whose insertion into the tree is deferred (where node data is a pointer)
+        int addObjectDeferred(const AABB& aabb, void* data);
+
+        /// Insert the deferred objects into the tree
+        void insertDeferredObjects(TaskScheduler* taskScheduler = nullptr);
+
+        /// Insert the deferred objects into the tree as a single sub-tree
+        void insertDeferredObjectsAsSubTree();
+
+        /// Return true if some objects have not been inserted into the tree yet
+        bool hasDeferredObjects() const;
+
+        /// Return the number of objects in the tree
+        int getNbObjects() const;
+
+        /// Allocate the nodes needed to store a given number of objects
+        void reserve(int nbObjects);
+
         /// Remove an object from the tree
         void removeObject(int nodeID);
 
         /// Update the dynamic tree after an object has moved.
         bool updateObject(int nodeID, const AABB& newAABB, const Vector3& displacement, bool forceReinsert = false);
 
+        /// Update the dynamic tree after an object has moved with a given gap for its fat AABB
+        bool updateObject(int nodeID, const AABB& newAABB, const Vector3& displacement,
+                          decimal gap, bool forceReinsert, bool isReinsertionDeferred = false);
+
         /// Return the fat AABB corresponding to a given node ID
         const AABB& getFatAABB(int nodeID) const;
 
@@ -240,9 +461,28 @@ class DynamicAABBTree {
         void reportAllShapesOverlappingWithAABB(const AABB& aabb,
                                                 DynamicAABBTreeOverlapCallback& callback) const;
 
+        /// Report all shapes overlapping with the AABB given in parameter using a query context
+        void reportAllShapesOverlappingWithAABB(const AABB& aabb, DynamicAABBTreeOverlapCallback& callback,
+                                                DynamicAABBTreeQueryContext& context) const;
+
         /// Ray casting method
         void raycast(const Ray& ray, DynamicAABBTreeRaycastCallback& callback) const;
 
+        /// Ray casting method with a function called for each leaf hit by the ray
+        template<typename LeafFunction>
+        void raycastLeaves(const Ray& ray, LeafFunction& leafFunction, bool isNearestChildFirst) const;
+
+        /// Ray casting method with a function called for each leaf hit by the ray using a query context
+        template<typename LeafFunction>
+        void raycastLeaves(const Ray& ray, LeafFunction& leafFunction, bool isNearestChildFirst,
+                           DynamicAABBTreeQueryContext& context) const;
+
+        /// Return the number of nodes that a query stack must be able to contain for this tree
+        uint getQueryStackSize() const;
+
+        /// Ray casting method for a packet of at most RAYCAST_PACKET_SIZE rays
+        void raycastPacket(Ray* rays, uint nbRays, DynamicAABBTreeRaycastPacketCallback& callback) const;
+
         /// Compute the height of the tree
         int computeHeight();
 
@@ -252,6 +492,39 @@ class DynamicAABBTree {
         /// Clear all the nodes and reset the tree
         void reset();
 
+        /// Remove all the objects from the tree without releasing the memory of the nodes
+        void clear();
+
+        /// Move the AABBs of all the nodes by a given translation
+        void translate(const Vector3& translation);
+
+        /// Rebuild the internal nodes of the tree with the surface area heuristic
+        void rebuildWithSAH(TaskScheduler* taskScheduler = nullptr);
+
+        /// Return the cost of the queries in the tree
+        decimal computeCost() const;
+
+        /// Compute the metrics of the quality of the tree
+        void computeStatistics(DynamicAABBTreeStatistics& statistics) const;
+
+        /// Enable or disable the counting of the queries and of the nodes they visit
+        void setIsQueryCountingEnabled(bool isEnabled);
+
+        /// Return the number of queries since the query counters have been reset
+        uint64 getNbQueries() const;
+
+        /// Return the number of nodes visited by the queries since the query counters have been reset
+        uint64 getNbQueryVisitedNodes() const;
+
+        /// Reset the query counters
+        void resetQueryCounters();
+
+        /// Start a new pass of the incremental refinement of the tree from its first node
+        void startIncrementalRefinement();
+
+        /// Reinsert the leaves of the next nodes of the incremental refinement of the tree
+        bool refineIncrementally(int nbNodes, int& nbReinsertedLeaves);
+
 #ifdef IS_PROFILING_ACTIVE
 
 		/// Set the profiler
@@ -259,6 +532,9 @@ class DynamicAABBTree {
 
 #endif
 
+        // -------------------- Friendship -------------------- //
+
+        friend class WideAABBTree;
 };
 
 // Return true if the node is a leaf of the tree
@@ -286,6 +562,55 @@ inline void* DynamicAABBTree::getNodeDataPointer(int nodeID) const {
     return mNodes[nodeID].dataPointer;
 }
 
+// Return true if a leaf node has been added but not inserted into the tree yet
+inline bool DynamicAABBTree::isDeferredLeaf(int nodeID) const {
+    return mNodes[nodeID].parentID == TreeNode::NULL_TREE_NODE && nodeID != mRootNodeID;
+}
+
+// Return true if some objects have not been inserted into the tree yet
+inline bool DynamicAABBTree::hasDeferredObjects() const {
+    return mDeferredLeaves.size() > 0;
+}
+
+// Return the number of objects in the tree
+inline int DynamicAABBTree::getNbObjects() const {
+
+    // The inserted leaves and internal nodes form a binary tree
+    const int nbDeferredLeaves = static_cast<int>(mDeferredLeaves.size());
+    return nbDeferredLeaves + (mNbNodes - nbDeferredLeaves + 1) / 2;
+}
+
+// Add the nodes visited by a query to the query counters (if enabled)
+inline void DynamicAABBTree::countQuery(uint64 nbVisitedNodes) const {
+    if (mIsQueryCountingEnabled) {
+        mNbQueries.fetch_add(1, std::memory_order_relaxed);
+        mNbQueryVisitedNodes.fetch_add(nbVisitedNodes, std::memory_order_relaxed);
+    }
+}
+
+// Enable or disable the counting of the queries and of the nodes they visit
+/// The counting is disabled by default. When it is enabled, each query adds its number of
+/// visited nodes to two atomic counters (the queries can run in parallel).
+inline void DynamicAABBTree::setIsQueryCountingEnabled(bool isEnabled) {
+    mIsQueryCountingEnabled = isEnabled;
+}
+
+// Return the number of queries since the query counters have been reset
+inline uint64 DynamicAABBTree::getNbQueries() const {
+    return mNbQueries.load(std::memory_order_relaxed);
+}
+
+// Return the number of nodes visited by the queries since the query counters have been reset
+inline uint64 DynamicAABBTree::getNbQueryVisitedNodes() const {
+    return mNbQueryVisitedNodes.load(std::memory_order_relaxed);
+}
+
+// Reset the query counters
+inline void DynamicAABBTree::resetQueryCounters() {
+    mNbQueries.store(0, std::memory_order_relaxed);
+    mNbQueryVisitedNodes.store(0, std::memory_order_relaxed);
+}
+
 // Return the root AABB of the tree
 inline AABB DynamicAABBTree::getRootAABB() const {
     return getFatAABB(mRootNodeID);
@@ -314,6 +639,141 @@ inline int DynamicAABBTree::addObject(const AABB& aabb, void* data) {
     return nodeId;
 }
 
+// Add an object whose insertion into the tree is deferred. The leaf node is created
+/// but it is only inserted into the tree by the next call to insertDeferredObjects().
+/// The queries on the tree still report the deferred objects.
+inline int DynamicAABBTree::addObjectDeferred(const AABB& aabb, void* data) {
+
+    int nodeId = allocateNode();
+
+    const Vector3 gap(mExtraAABBGap, mExtraAABBGap, mExtraAABBGap);
+    mNodes[nodeId].aabb.setMin(aabb.getMin() - gap);
+    mNodes[nodeId].aabb.setMax(aabb.getMax() + gap);
+    mNodes[nodeId].dataPointer = data;
+    mDeferredLeaves.add(nodeId);
+
+    return nodeId;
+}
+
+// Return the number of nodes that a query stack must be able to contain for this tree
+/// The traversals push the two children of a node after having popped it. The stack then
+/// contains at most one pending sibling for each level of the tree above the current node.
+inline uint DynamicAABBTree::getQueryStackSize() const {
+    return mRootNodeID == TreeNode::NULL_TREE_NODE ? 1 : static_cast<uint>(mNodes[mRootNodeID].height) + 2;
+}
+
+// Ray casting method with a function called for each leaf hit by the ray
+/// The function is called with the ID of a leaf and the ray clipped at the current max
+/// fraction. It returns the hit fraction with the same meaning as the hit fraction of
+/// DynamicAABBTreeRaycastCallback. The function is inlined in the traversal and there is
+/// no virtual call for each leaf. If isNearestChildFirst is true, the child of a node whose
+/// center is the nearest along the ray is visited first so that the ray is clipped sooner
+/// when only the closest hit is needed.
+template<typename LeafFunction>
+inline void DynamicAABBTree::raycastLeaves(const Ray& ray, LeafFunction& leafFunction, bool isNearestChildFirst) const {
+
+    DynamicAABBTreeQueryContext context(mAllocator);
+    raycastLeaves(ray, leafFunction, isNearestChildFirst, context);
+}
+
+// Ray casting method with a function called for each leaf hit by the ray using a query context
+/// The stack of the context is reserved for the height of the tree before the traversal and
+/// the children of a node are prefetched when they are pushed into the stack so that their
+/// AABBs are in the cache when they are tested against the ray.
+template<typename LeafFunction>
+void DynamicAABBTree::raycastLeaves(const Ray& ray, LeafFunction& leafFunction, bool isNearestChildFirst,
+                                    DynamicAABBTreeQueryContext& context) const {
+
+    decimal maxFraction = ray.maxFraction;
+    const Vector3 rayDirection = ray.point2 - ray.point1;
+    uint64 nbVisitedNodes = 0;
+
+    int* stack = context.reserveStack(getQueryStackSize());
+    uint nbStackNodes = 0;
+    if (mRootNodeID != TreeNode::NULL_TREE_NODE) {
+        stack[nbStackNodes++] = mRootNodeID;
+    }
+
+    // Walk through the tree from the root looking for proxy shapes
+    // that overlap with the ray AABB
+    while (nbStackNodes > 0) {
+
+        // Get the next node in the stack
+        int nodeID = stack[--nbStackNodes];
+
+        // Get the corresponding node
+        const TreeNode* node = mNodes + nodeID;
+        nbVisitedNodes++;
+
+        Ray rayTemp(ray.point1, ray.point2, maxFraction);
+
+        // Test if the ray intersects with the current node AABB
+        if (!node->aabb.testRayIntersect(rayTemp)) continue;
+
+        // If the node is a leaf of the tree
+        if (node->isLeaf()) {
+
+            // Call the function that will raycast again the broad-phase shape
+            decimal hitFraction = leafFunction(nodeID, rayTemp);
+
+            // If the function returned a hitFraction of zero, it means that
+            // the raycasting should stop here
+            if (hitFraction == decimal(0.0)) {
+                countQuery(nbVisitedNodes);
+                return;
+            }
+
+            // If the function returned a positive fraction, we update the maxFraction value
+            if (hitFraction > decimal(0.0) && hitFraction < maxFraction) {
+                maxFraction = hitFraction;
+            }
+
+            // If the function returned a negative fraction, we continue
+            // the raycasting as if the proxy shape did not exist
+        }
+        else {  // If the node has children
+
+            // Push its children in the stack of nodes to explore (the child
+            // pushed last is visited first)
+            int firstChild = node->children[0];
+            int secondChild = node->children[1];
+            RP3D_PREFETCH(mNodes + firstChild);
+            RP3D_PREFETCH(mNodes + secondChild);
+            if (isNearestChildFirst &&
+                rayDirection.dot(mNodes[firstChild].aabb.getCenter() - mNodes[secondChild].aabb.getCenter()) <
+                decimal(0.0)) {
+                std::swap(firstChild, secondChild);
+            }
+            assert(nbStackNodes + 2 <= getQueryStackSize());
+            stack[nbStackNodes++] = firstChild;
+            stack[nbStackNodes++] = secondChild;
+        }
+    }
+
+    // Test the leaves that have not been inserted into the tree yet
+    for (uint i=0; i < mDeferredLeaves.size(); i++) {
+
+        Ray rayTemp(ray.point1, ray.point2, maxFraction);
+        nbVisitedNodes++;
+
+        if (!mNodes[mDeferredLeaves[i]].aabb.testRayIntersect(rayTemp)) continue;
+
+        decimal hitFraction = leafFunction(mDeferredLeaves[i], rayTemp);
+
+        // Stop the raycasting if the function returned a hitFraction of zero
+        if (hitFraction == decimal(0.0)) {
+            countQuery(nbVisitedNodes);
+            return;
+        }
+
+        if (hitFraction > decimal(0.0) && hitFraction < maxFraction) {
+            maxFraction = hitFraction;
+        }
+    }
+
+    countQuery(nbVisitedNodes);
+}
+
 #ifdef IS_PROFILING_ACTIVE
 
 // Set the profiler
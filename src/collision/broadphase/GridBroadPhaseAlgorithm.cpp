@@ -0,0 +1,381 @@
+/********************************************************************************
+* ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
+* Copyright (c) 2010-2018 Daniel Chappuis                                       *
+*********************************************************************************
+*                                                                               *
+* This software is provided 'as-is', without any express or implied warranty.   *
+* In no event will the authors be held liable for any damages arising from the  *
+* use of this software.                                                         *
+*                                                                               *
+* Permission is granted to anyone to use this software for any purpose,         *
+* including commercial applications, and to alter it and redistribute it        *
+* freely, subject to the following restrictions:                                *
+*                                                                               *
+* 1. The origin of this software must not be misrepresented; you must not claim *
+*    that you wrote the original software. If you use this software in a        *
+*    product, an acknowledgment in the product documentation would be           *
+*    appreciated but is not required.                                           *
+*                                                                               *
+* 2. Altered source versions must be plainly marked as such, and must not be    *
+*    misrepresented as being the original software.                             *
+*                                                                               *
+* 3. This notice may not be removed or altered from any source distribution.    *
+*                                                                               *
+********************************************************************************/
+
+// Libraries
+#include "GridBroadPhaseAlgorithm.h"
+#include "collision/CollisionDetection.h"
+#include "utils/Profiler.h"
+#include "memory/MemoryManager.h"
+#include <cmath>
+
+// We want to use the ReactPhysics3D namespace
+using namespace reactphysics3d;
+
+// Initialization of static variables
+const int32 GridBroadPhaseAlgorithm::MAX_CELL_COORDINATE = (1 << 20) - 1;
+
+// Constructor
+GridBroadPhaseAlgorithm::GridBroadPhaseAlgorithm(CollisionDetection& collisionDetection, const WorldSettings& worldSettings)
+                    :BroadPhaseAlgorithm(collisionDetection, worldSettings),
+                     mCellSize(worldSettings.broadPhaseGridCellSize),
+                     mProxies(collisionDetection.getMemoryManager().getPoolAllocator(MemoryTag::BroadPhase)),
+                     mFreeProxies(collisionDetection.getMemoryManager().getPoolAllocator(MemoryTag::BroadPhase)),
+                     mCells(collisionDetection.getMemoryManager().getPoolAllocator(MemoryTag::BroadPhase)),
+                     mCellIndices(collisionDetection.getMemoryManager().getPoolAllocator(MemoryTag::BroadPhase)),
+                     mMaxExtent(Vector3::zero()), mGridOrigin(Vector3::zero()) {
+
+    assert(mCellSize > decimal(0.0));
+}
+
+// Destructor
+GridBroadPhaseAlgorithm::~GridBroadPhaseAlgorithm() {
+
+    MemoryAllocator& poolAllocator = mCollisionDetection.getMemoryManager().getPoolAllocator(MemoryTag::BroadPhase);
+
+    // Destroy the cells
+    for (uint i=0; i < mCells.size(); i++) {
+        mCells[i]->~GridCell();
+        poolAllocator.release(mCells[i], sizeof(GridCell));
+    }
+}
+
+// Allocate the memory needed to store a given number of proxy shapes
+void GridBroadPhaseAlgorithm::reserve(uint nbProxyShapes) {
+
+    BroadPhaseAlgorithm::reserve(nbProxyShapes);
+
+    mProxies.reserve(nbProxyShapes);
+}
+
+// Return the integer coordinate of the cell that contains a position on an axis
+int32 GridBroadPhaseAlgorithm::computeCellCoordinate(decimal position, int axis) const {
+    const decimal coordinate = std::floor((position - mGridOrigin[axis]) / mCellSize);
+    return static_cast<int32>(clamp(coordinate, decimal(-MAX_CELL_COORDINATE), decimal(MAX_CELL_COORDINATE)));
+}
+
+// Return the key of the cell that contains the center of an AABB
+uint64 GridBroadPhaseAlgorithm::computeCellKey(const AABB& aabb) const {
+    const Vector3 center = aabb.getCenter();
+    return computeCellKey(computeCellCoordinate(center.x, 0), computeCellCoordinate(center.y, 1),
+                          computeCellCoordinate(center.z, 2));
+}
+
+// Return the world-space position of the origin of a cell
+Vector3 GridBroadPhaseAlgorithm::computeCellOrigin(uint64 cellKey) const {
+
+    // Extend the sign of the 21-bit coordinates
+    Vector3 origin;
+    for (int i=0; i < 3; i++) {
+        int32 coordinate = static_cast<int32>((cellKey >> (42 - 21 * i)) & ((uint64(1) << 21) - 1));
+        if (coordinate > MAX_CELL_COORDINATE) coordinate -= (1 << 21);
+        origin[i] = mGridOrigin[i] + decimal(coordinate) * mCellSize;
+    }
+
+    return origin;
+}
+
+// Return the cell with a given key
+GridCell* GridBroadPhaseAlgorithm::getCell(uint64 cellKey) const {
+    assert(mCellIndices.containsKey(cellKey));
+    return mCells[mCellIndices[cellKey]];
+}
+
+// Return the cell with a given key (create it if it does not exist)
+GridCell* GridBroadPhaseAlgorithm::getOrCreateCell(uint64 cellKey) {
+
+    auto it = mCellIndices.find(cellKey);
+    if (it != mCellIndices.end()) {
+        return mCells[it->second];
+    }
+
+    MemoryAllocator& poolAllocator = mCollisionDetection.getMemoryManager().getPoolAllocator(MemoryTag::BroadPhase);
+    GridCell* cell = new (poolAllocator.allocate(sizeof(GridCell))) GridCell(cellKey, computeCellOrigin(cellKey),
+                                                                            poolAllocator);
+
+#ifdef IS_PROFILING_ACTIVE
+    cell->tree.setProfiler(mProfiler);
+#endif
+
+    mCellIndices.add(Pair<uint64, uint>(cellKey, static_cast<uint>(mCells.size())));
+    mCells.add(cell);
+
+    return cell;
+}
+
+// Destroy a cell that does not contain any shape
+void GridBroadPhaseAlgorithm::destroyCell(uint64 cellKey) {
+
+    const uint index = mCellIndices[cellKey];
+    GridCell* cell = mCells[index];
+    assert(cell->tree.getNbObjects() == 0);
+
+    // Move the last cell at the index of the destroyed one
+    const uint lastIndex = static_cast<uint>(mCells.size()) - 1;
+    if (index != lastIndex) {
+        mCells[index] = mCells[lastIndex];
+        mCellIndices[mCells[index]->key] = index;
+    }
+    mCells.removeAt(lastIndex);
+    mCellIndices.remove(cellKey);
+
+    MemoryAllocator& poolAllocator = mCollisionDetection.getMemoryManager().getPoolAllocator(MemoryTag::BroadPhase);
+    cell->~GridCell();
+    poolAllocator.release(cell, sizeof(GridCell));
+}
+
+// Insert a proxy into the tree of a cell and update its fat AABB
+void GridBroadPhaseAlgorithm::insertProxyIntoCell(int broadPhaseID, const AABB& aabb, uint64 cellKey) {
+
+    GridCell* cell = getOrCreateCell(cellKey);
+    GridProxy& proxy = mProxies[broadPhaseID];
+
+    // The AABBs of the tree are relative to the origin of the cell
+    const AABB localAABB(aabb.getMin() - cell->origin, aabb.getMax() - cell->origin);
+    proxy.nodeID = cell->tree.addObject(localAABB, broadPhaseID, 0);
+    proxy.cellKey = cellKey;
+
+    const AABB& localFatAABB = cell->tree.getFatAABB(proxy.nodeID);
+    proxy.aabb.setMin(localFatAABB.getMin() + cell->origin);
+    proxy.aabb.setMax(localFatAABB.getMax() + cell->origin);
+}
+
+// Add a proxy shape into the cell of its AABB and return its broad-phase ID
+int GridBroadPhaseAlgorithm::addProxy(ProxyShape* proxyShape, const AABB& aabb) {
+
+    // Get a free proxy (or add a new one)
+    int broadPhaseID;
+    if (mFreeProxies.size() > 0) {
+        broadPhaseID = mFreeProxies[mFreeProxies.size() - 1];
+        mFreeProxies.removeAt(mFreeProxies.size() - 1);
+    }
+    else {
+        broadPhaseID = static_cast<int>(mProxies.size());
+        mProxies.add(GridProxy());
+    }
+
+    mProxies[broadPhaseID].proxyShape = proxyShape;
+    insertProxyIntoCell(broadPhaseID, aabb, computeCellKey(aabb));
+    mMaxExtent = Vector3::max(mMaxExtent, mProxies[broadPhaseID].aabb.getExtent());
+
+    return broadPhaseID;
+}
+
+// Remove a proxy shape from its cell
+void GridBroadPhaseAlgorithm::removeProxy(int broadPhaseID) {
+
+    GridProxy& proxy = mProxies[broadPhaseID];
+    assert(proxy.proxyShape != nullptr);
+
+    // Remove the proxy from the tree of its cell and destroy the cell if it is empty
+    GridCell* cell = getCell(proxy.cellKey);
+    cell->tree.removeObject(proxy.nodeID);
+    if (cell->tree.getNbObjects() == 0) {
+        destroyCell(proxy.cellKey);
+    }
+
+    proxy.proxyShape = nullptr;
+    mFreeProxies.add(broadPhaseID);
+}
+
+// Update the fat AABB of a proxy shape and return true if it has changed
+bool GridBroadPhaseAlgorithm::updateProxy(int broadPhaseID, const AABB& aabb, const Vector3& displacement,
+                                          decimal gap, bool forceReinsert) {
+
+    GridProxy& proxy = mProxies[broadPhaseID];
+    assert(proxy.proxyShape != nullptr);
+
+    // If the new AABB is still inside the fat AABB of the proxy
+    if (!forceReinsert && proxy.aabb.contains(aabb)) {
+        return false;
+    }
+
+    const uint64 cellKey = computeCellKey(aabb);
+
+    // If the proxy has left its cell, we move it into its new cell
+    if (cellKey != proxy.cellKey) {
+
+        GridCell* oldCell = getCell(proxy.cellKey);
+        oldCell->tree.removeObject(proxy.nodeID);
+        if (oldCell->tree.getNbObjects() == 0) {
+            destroyCell(proxy.cellKey);
+        }
+
+        insertProxyIntoCell(broadPhaseID, aabb, cellKey);
+    }
+
+    // Update the node of the proxy in the tree of its cell
+    GridCell* cell = getCell(cellKey);
+    const AABB localAABB(aabb.getMin() - cell->origin, aabb.getMax() - cell->origin);
+    cell->tree.updateObject(proxy.nodeID, localAABB, displacement, gap, true);
+
+    const AABB& localFatAABB = cell->tree.getFatAABB(proxy.nodeID);
+    proxy.aabb.setMin(localFatAABB.getMin() + cell->origin);
+    proxy.aabb.setMax(localFatAABB.getMax() + cell->origin);
+
+    mMaxExtent = Vector3::max(mMaxExtent, proxy.aabb.getExtent());
+
+    return true;
+}
+
+// Report the shapes of a cell that are overlapping with a world-space AABB
+void GridBroadPhaseAlgorithm::reportShapesOfCellOverlappingWithAABB(const GridCell& cell, const AABB& aabb,
+                                                                    DynamicAABBTreeOverlapCallback& callback,
+                                                                    DynamicAABBTreeQueryContext& context) const {
+
+    const AABB localAABB(aabb.getMin() - cell.origin, aabb.getMax() - cell.origin);
+    if (!localAABB.testCollision(cell.tree.getRootAABB())) return;
+
+    GridCellOverlapCallback cellCallback(cell.tree, callback);
+    cell.tree.reportAllShapesOverlappingWithAABB(localAABB, cellCallback, context);
+}
+
+// Report all the shapes that are overlapping with a given AABB
+void GridBroadPhaseAlgorithm::reportAllShapesOverlappingWithAABB(const AABB& aabb,
+                                                                 DynamicAABBTreeOverlapCallback& callback) const {
+
+    if (mCells.size() == 0) return;
+
+    // The shapes that overlap with the AABB have the center of their AABB (and
+    // therefore their cell) in the AABB inflated by the largest extent of the shapes
+    const Vector3 min = aabb.getMin() - mMaxExtent;
+    const Vector3 max = aabb.getMax() + mMaxExtent;
+    const int32 minX = computeCellCoordinate(min.x, 0);
+    const int32 minY = computeCellCoordinate(min.y, 1);
+    const int32 minZ = computeCellCoordinate(min.z, 2);
+    const int32 maxX = computeCellCoordinate(max.x, 0);
+    const int32 maxY = computeCellCoordinate(max.y, 1);
+    const int32 maxZ = computeCellCoordinate(max.z, 2);
+
+    const uint64 nbCellsInRange = uint64(maxX - minX + 1) * uint64(maxY - minY + 1) * uint64(maxZ - minZ + 1);
+
+    // The trees of all the cells of the query are traversed with the same stack
+    DynamicAABBTreeQueryContext context(MemoryManager::getBaseAllocator());
+
+    // If the range has more cells than the grid, we test all the cells of the grid
+    if (nbCellsInRange > mCells.size()) {
+        for (uint i=0; i < mCells.size(); i++) {
+            reportShapesOfCellOverlappingWithAABB(*(mCells[i]), aabb, callback, context);
+        }
+        return;
+    }
+
+    for (int32 x=minX; x <= maxX; x++) {
+        for (int32 y=minY; y <= maxY; y++) {
+            for (int32 z=minZ; z <= maxZ; z++) {
+
+                auto it = mCellIndices.find(computeCellKey(x, y, z));
+                if (it != mCellIndices.end()) {
+                    reportShapesOfCellOverlappingWithAABB(*(mCells[it->second]), aabb, callback, context);
+                }
+            }
+        }
+    }
+}
+
+// Ray casting method
+void GridBroadPhaseAlgorithm::raycast(const Ray& ray, RaycastTest& raycastTest,
+                                      collisionmask raycastWithCategoryMaskBits) const {
+
+    RP3D_PROFILE("GridBroadPhaseAlgorithm::raycast()", mProfiler);
+
+    BroadPhaseRaycastCallback broadPhaseRaycastCallback(*this, raycastWithCategoryMaskBits, raycastTest);
+
+    decimal maxFraction = ray.maxFraction;
+
+    // For each cell of the grid
+    for (uint i=0; i < mCells.size(); i++) {
+
+        const GridCell& cell = *(mCells[i]);
+
+        // Test the ray relative to the origin of the cell against its tree
+        const Ray localRay(ray.point1 - cell.origin, ray.point2 - cell.origin, maxFraction);
+        if (!cell.tree.getRootAABB().testRayIntersect(localRay)) continue;
+
+        GridCellRaycastCallback callback(broadPhaseRaycastCallback, cell.tree, ray, maxFraction);
+        cell.tree.raycast(localRay, callback);
+
+        // Stop if the user has stopped the raycast
+        if (callback.isStopped) return;
+
+        maxFraction = callback.maxFraction;
+    }
+}
+
+// Move all the fat AABBs by the opposite of the displacement of the origin of the world
+/// The grid is moved with the world so that the shapes stay in the same cells. The AABBs
+/// of the trees of the cells are relative to the origin of their cell and do not change.
+void GridBroadPhaseAlgorithm::shiftOrigin(const Vector3& shift) {
+
+    mFatAABBsVersion++;
+
+    mGridOrigin -= shift;
+
+    for (uint i=0; i < mCells.size(); i++) {
+        mCells[i]->origin -= shift;
+    }
+
+    for (uint i=0; i < mProxies.size(); i++) {
+        if (mProxies[i].proxyShape != nullptr) {
+            mProxies[i].aabb.translate(-shift);
+        }
+    }
+}
+
+#ifdef IS_PROFILING_ACTIVE
+
+// Set the profiler
+void GridBroadPhaseAlgorithm::setProfiler(Profiler* profiler) {
+
+    BroadPhaseAlgorithm::setProfiler(profiler);
+
+    for (uint i=0; i < mCells.size(); i++) {
+        mCells[i]->tree.setProfiler(profiler);
+    }
+}
+
+#endif
+
+// Called when a overlapping node has been found in the tree
+void GridCellOverlapCallback::notifyOverlappingNode(int nodeId) {
+    mCallback.notifyOverlappingNode(mTree.getNodeDataInt(nodeId)[0]);
+}
+
+// Called when the AABB of a leaf node is hit by a ray
+decimal GridCellRaycastCallback::raycastBroadPhaseShape(int32 nodeId, const Ray& ray) {
+
+    // Test the shape with the world-space ray
+    const Ray worldRay(mWorldRay.point1, mWorldRay.point2, ray.maxFraction);
+    decimal hitFraction = mCallback.raycastBroadPhaseShape(mTree.getNodeDataInt(nodeId)[0], worldRay);
+
+    // A hit fraction of zero stops the raycast
+    if (hitFraction == decimal(0.0)) {
+        isStopped = true;
+    }
+    else if (hitFraction > decimal(0.0) && hitFraction < maxFraction) {
+        maxFraction = hitFraction;
+    }
+
+    return hitFraction;
+}
@@ -0,0 +1,322 @@
+/********************************************************************************
+* ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
+* Copyright (c) 2010-2018 Daniel Chappuis                                       *
+*********************************************************************************
+*                                                                               *
+* This software is provided 'as-is', without any express or implied warranty.   *
+* In no event will the authors be held liable for any damages arising from the  *
+* use of this software.                                                         *
+*                                                                               *
+* Permission is granted to anyone to use this software for any purpose,         *
+* including commercial applications, and to alter it and redistribute it        *
+* freely, subject to the following restrictions:                                *
+*                                                                               *
+* 1. The origin of this software must not be misrepresented; you must not claim *
+*    that you wrote the original software. If you use this software in a        *
+*    product, an acknowledgment in the product documentation would be           *
+*    appreciated but is not required.                                           *
+*                                                                               *
+* 2. Altered source versions must be plainly marked as such, and must not be    *
+*    misrepresented as being the original software.                             *
+*                                                                               *
+* 3. This notice may not be removed or altered from any source distribution.    *
+*                                                                               *
+********************************************************************************/
+
+#ifndef REACTPHYSICS3D_GRID_BROAD_PHASE_ALGORITHM_H
+#define REACTPHYSICS3D_GRID_BROAD_PHASE_ALGORITHM_H
+
+// Libraries
+#include "BroadPhaseAlgorithm.h"
+#include "DynamicAABBTree.h"
+#include "containers/List.h"
+#include "containers/Map.h"
+
+/// Namespace ReactPhysics3D
+namespace reactphysics3d {
+
+// Structure GridProxy
+/**
+ * This structure represents a proxy shape in the grid broad-phase.
+ */
+struct GridProxy {
+
+    // -------------------- Attributes -------------------- //
+
+    /// Fat AABB of the proxy shape in world-space
+    AABB aabb;
+
+    /// Pointer to the proxy shape (null if the proxy is free)
+    ProxyShape* proxyShape;
+
+    /// Key of the cell that contains the proxy shape
+    uint64 cellKey;
+
+    /// ID of the node of the proxy shape in the tree of its cell
+    int nodeID;
+};
+
+// Structure GridCell
+/**
+ * This structure represents a cell of the grid broad-phase with the tree of its shapes.
+ * The AABBs of the tree are relative to the origin of the cell.
+ */
+struct GridCell {
+
+    // -------------------- Attributes -------------------- //
+
+    /// Key of the cell (its packed integer coordinates)
+    uint64 key;
+
+    /// Position of the origin of the cell in world-space
+    Vector3 origin;
+
+    /// Dynamic AABB tree of the shapes of the cell (the data of a node is a broad-phase ID)
+    DynamicAABBTree tree;
+
+    // -------------------- Methods -------------------- //
+
+    /// Constructor
+    GridCell(uint64 cellKey, const Vector3& cellOrigin, MemoryAllocator& allocator)
+        : key(cellKey), origin(cellOrigin), tree(allocator, DYNAMIC_TREE_AABB_GAP) {
+
+    }
+};
+
+// Class GridCellOverlapCallback
+/**
+ * Overlap callback that converts the node IDs of the tree of a cell into broad-phase IDs.
+ */
+class GridCellOverlapCallback : public DynamicAABBTreeOverlapCallback {
+
+    private:
+
+        /// Tree of the cell
+        const DynamicAABBTree& mTree;
+
+        /// Callback of the broad-phase that receives the broad-phase IDs of the overlapping nodes
+        DynamicAABBTreeOverlapCallback& mCallback;
+
+    public:
+
+        // Constructor
+        GridCellOverlapCallback(const DynamicAABBTree& tree, DynamicAABBTreeOverlapCallback& callback)
+             : mTree(tree), mCallback(callback) {
+
+        }
+
+        // Called when a overlapping node has been found in the tree
+        virtual void notifyOverlappingNode(int nodeId) override;
+};
+
+// Class GridCellRaycastCallback
+/**
+ * Raycast callback that converts the node IDs of the tree of a cell into broad-phase IDs.
+ * The shapes are tested with the world-space ray.
+ */
+class GridCellRaycastCallback : public DynamicAABBTreeRaycastCallback {
+
+    private:
+
+        /// Raycast callback of the broad-phase
+        BroadPhaseRaycastCallback& mCallback;
+
+        /// Tree of the cell
+        const DynamicAABBTree& mTree;
+
+        /// World-space ray
+        const Ray& mWorldRay;
+
+    public:
+
+        /// Smallest hit fraction returned by the callback
+        decimal maxFraction;
+
+        /// True if the raycast has been stopped by the user
+        bool isStopped;
+
+        // Constructor
+        GridCellRaycastCallback(BroadPhaseRaycastCallback& callback, const DynamicAABBTree& tree,
+                                const Ray& worldRay, decimal rayMaxFraction)
+             : mCallback(callback), mTree(tree), mWorldRay(worldRay), maxFraction(rayMaxFraction), isStopped(false) {
+
+        }
+
+        // Called when the AABB of a leaf node is hit by a ray
+        virtual decimal raycastBroadPhaseShape(int32 nodeId, const Ray& ray) override;
+};
+
+// Class GridBroadPhaseAlgorithm
+/**
+ * This class implements the broad-phase collision detection with a uniform grid of cells
+ * for very large worlds. Each proxy shape belongs to the cell that contains the center of
+ * its fat AABB and each cell has a small dynamic AABB tree with the shapes of the cell.
+ * The AABBs of a tree are relative to the origin of its cell so that the trees do not need
+ * a huge root AABB that spans the whole world. The cells are stored in a hash map with
+ * their integer coordinates. A cell is created when a shape enters it and destroyed when
+ * its last shape leaves it. Therefore, the memory of the broad-phase follows the regions of
+ * the world that are loaded, and a region can be streamed in and out by adding and removing
+ * its bodies.
+ *
+ * Because a shape only belongs to one cell, a query visits the cells that overlap with its
+ * AABB inflated by the extent of the largest shape of the grid. When this range has
+ * more cells than the grid, the query visits all the cells of the grid instead. The shapes
+ * should be smaller than the cells for the queries to stay local.
+ */
+class GridBroadPhaseAlgorithm : public BroadPhaseAlgorithm {
+
+    protected :
+
+        // -------------------- Constants -------------------- //
+
+        /// Largest absolute integer coordinate of a cell (stored with 21 bits)
+        static const int32 MAX_CELL_COORDINATE;
+
+        // -------------------- Attributes -------------------- //
+
+        /// Size of the cells
+        const decimal mCellSize;
+
+        /// Array of the proxies (indexed by the broad-phase IDs)
+        List<GridProxy> mProxies;
+
+        /// Broad-phase IDs of the free proxies of the array that can be reused
+        List<int> mFreeProxies;
+
+        /// Cells of the grid
+        List<GridCell*> mCells;
+
+        /// Map from the key of a cell to its index in the array of cells
+        Map<uint64, uint> mCellIndices;
+
+        /// Largest extent of the fat AABBs that have been added to the grid on each axis
+        Vector3 mMaxExtent;
+
+        /// World-space position of the corner of the cell with integer coordinates (0, 0, 0)
+        Vector3 mGridOrigin;
+
+        // -------------------- Methods -------------------- //
+
+        /// Add a proxy shape into the cell of its AABB and return its broad-phase ID
+        virtual int addProxy(ProxyShape* proxyShape, const AABB& aabb) override;
+
+        /// Remove a proxy shape from its cell
+        virtual void removeProxy(int broadPhaseID) override;
+
+        /// Update the fat AABB of a proxy shape and return true if it has changed
+        virtual bool updateProxy(int broadPhaseID, const AABB& aabb, const Vector3& displacement,
+                                 decimal gap, bool forceReinsert) override;
+
+        /// Return the integer coordinate of the cell that contains a position on an axis
+        int32 computeCellCoordinate(decimal position, int axis) const;
+
+        /// Return the key of the cell that contains the center of an AABB
+        uint64 computeCellKey(const AABB& aabb) const;
+
+        /// Return the key of a cell from its integer coordinates
+        static uint64 computeCellKey(int32 x, int32 y, int32 z);
+
+        /// Return the world-space position of the origin of a cell
+        Vector3 computeCellOrigin(uint64 cellKey) const;
+
+        /// Return the cell with a given key (create it if it does not exist)
+        GridCell* getOrCreateCell(uint64 cellKey);
+
+        /// Return the cell with a given key
+        GridCell* getCell(uint64 cellKey) const;
+
+        /// Destroy a cell that does not contain any shape
+        void destroyCell(uint64 cellKey);
+
+        /// Insert a proxy into the tree of a cell and update its fat AABB
+        void insertProxyIntoCell(int broadPhaseID, const AABB& aabb, uint64 cellKey);
+
+        /// Report the shapes of a cell that are overlapping with a world-space AABB
+        void reportShapesOfCellOverlappingWithAABB(const GridCell& cell, const AABB& aabb,
+                                                   DynamicAABBTreeOverlapCallback& callback,
+                                                   DynamicAABBTreeQueryContext& context) const;
+
+    public :
+
+        // -------------------- Methods -------------------- //
+
+        /// Constructor
+        GridBroadPhaseAlgorithm(CollisionDetection& collisionDetection, const WorldSettings& worldSettings);
+
+        /// Destructor
+        virtual ~GridBroadPhaseAlgorithm() override;
+
+        /// Deleted copy-constructor
+        GridBroadPhaseAlgorithm(const GridBroadPhaseAlgorithm& algorithm) = delete;
+
+        /// Deleted assignment operator
+        GridBroadPhaseAlgorithm& operator=(const GridBroadPhaseAlgorithm& algorithm) = delete;
+
+        /// Return the number of bytes used by the broad-phase algorithm
+        virtual size_t getSizeInBytes() const override;
+
+        /// Allocate the memory needed to store a given number of proxy shapes
+        virtual void reserve(uint nbProxyShapes) override;
+
+        /// Return the number of cells of the grid that contain some shapes
+        uint getNbCells() const;
+
+        /// Report all the shapes that are overlapping with a given AABB
+        virtual void reportAllShapesOverlappingWithAABB(const AABB& aabb,
+                                                        DynamicAABBTreeOverlapCallback& callback) const override;
+
+        /// Return the proxy shape corresponding to the broad-phase id in parameter
+        virtual ProxyShape* getProxyShapeForBroadPhaseId(int broadPhaseId) const override;
+
+        /// Return the fat AABB of a given broad-phase shape
+        virtual const AABB& getFatAABB(int broadPhaseId) const override;
+
+        /// Ray casting method
+        virtual void raycast(const Ray& ray, RaycastTest& raycastTest,
+                             collisionmask raycastWithCategoryMaskBits) const override;
+
+        /// Move all the fat AABBs by the opposite of the displacement of the origin of the world
+        virtual void shiftOrigin(const Vector3& shift) override;
+
+#ifdef IS_PROFILING_ACTIVE
+
+        /// Set the profiler
+        virtual void setProfiler(Profiler* profiler) override;
+
+#endif
+
+};
+
+// Return the number of bytes used by the broad-phase algorithm
+inline size_t GridBroadPhaseAlgorithm::getSizeInBytes() const {
+    return sizeof(GridBroadPhaseAlgorithm);
+}
+
+// Return the number of cells of the grid that contain some shapes
+inline uint GridBroadPhaseAlgorithm::getNbCells() const {
+    return static_cast<uint>(mCells.size());
+}
+
+// Return the fat AABB of a given broad-phase shape
+inline const AABB& GridBroadPhaseAlgorithm::getFatAABB(int broadPhaseId) const  {
+    assert(broadPhaseId >= 0 && broadPhaseId < static_cast<int>(mProxies.size()));
+    return mProxies[broadPhaseId].aabb;
+}
+
+// Return the proxy shape corresponding to the broad-phase id in parameter
+inline ProxyShape* GridBroadPhaseAlgorithm::getProxyShapeForBroadPhaseId(int broadPhaseId) const {
+    assert(broadPhaseId >= 0 && broadPhaseId < static_cast<int>(mProxies.size()));
+    return mProxies[broadPhaseId].proxyShape;
+}
+
+// Return the key of a cell from its integer coordinates
+/// Each coordinate is stored with 21 bits.
+inline uint64 GridBroadPhaseAlgorithm::computeCellKey(int32 x, int32 y, int32 z) {
+    const uint64 mask = (uint64(1) << 21) - 1;
+    return ((static_cast<uint64>(x) & mask) << 42) | ((static_cast<uint64>(y) & mask) << 21) |
+            (static_cast<uint64>(z) & mask);
+}
+
+}
+
+#endif
@@ -0,0 +1,319 @@
+/********************************************************************************
+* ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
+* Copyright (c) 2010-2018 Daniel Chappuis                                       *
+*********************************************************************************
+*                                                                               *
+* This software is provided 'as-is', without any express or implied warranty.   *
+* In no event will the authors be held liable for any damages arising from the  *
+* use of this software.                                                         *
+*                                                                               *
+* Permission is granted to anyone to use this software for any purpose,         *
+* including commercial applications, and to alter it and redistribute it        *
+* freely, subject to the following restrictions:                                *
+*                                                                               *
+* 1. The origin of this software must not be misrepresented; you must not claim *
+*    that you wrote the original software. If you use this software in a        *
+*    product, an acknowledgment in the product documentation would be           *
+*    appreciated but is not required.                                           *
+*                                                                               *
+* 2. Altered source versions must be plainly marked as such, and must not be    *
+*    misrepresented as being the original software.                             *
+*                                                                               *
+* 3. This notice may not be removed or altered from any source distribution.    *
+*                                                                               *
+********************************************************************************/
+
+// Libraries
+#include "SweepAndPruneBroadPhaseAlgorithm.h"
+#include "collision/CollisionDetection.h"
+#include "utils/Profiler.h"
+#include "memory/MemoryManager.h"
+
+// We want to use the ReactPhysics3D namespace
+using namespace reactphysics3d;
+
+// Constructor
+SweepAndPruneBroadPhaseAlgorithm::SweepAndPruneBroadPhaseAlgorithm(CollisionDetection& collisionDetection, const WorldSettings& worldSettings)
+                    :BroadPhaseAlgorithm(collisionDetection, worldSettings),
+                     mProxies(collisionDetection.getMemoryManager().getPoolAllocator(MemoryTag::BroadPhase)),
+                     mFreeProxies(collisionDetection.getMemoryManager().getPoolAllocator(MemoryTag::BroadPhase)),
+                     mSortedProxies(collisionDetection.getMemoryManager().getPoolAllocator(MemoryTag::BroadPhase)),
+                     mNeedsSorting(false), mMaxExtentX(decimal(0.0)) {
+
+}
+
+// Allocate the memory needed to store a given number of proxy shapes
+void SweepAndPruneBroadPhaseAlgorithm::reserve(uint nbProxyShapes) {
+
+    BroadPhaseAlgorithm::reserve(nbProxyShapes);
+
+    mProxies.reserve(nbProxyShapes);
+    mSortedProxies.reserve(nbProxyShapes);
+}
+
+// Add a proxy shape into the sorted array and return its broad-phase ID
+int SweepAndPruneBroadPhaseAlgorithm::addProxy(ProxyShape* proxyShape, const AABB& aabb) {
+
+    // Get a free proxy (or add a new one)
+    int broadPhaseID;
+    if (mFreeProxies.size() > 0) {
+        broadPhaseID = mFreeProxies[mFreeProxies.size() - 1];
+        mFreeProxies.removeAt(mFreeProxies.size() - 1);
+    }
+    else {
+        broadPhaseID = static_cast<int>(mProxies.size());
+        mProxies.add(SweepAndPruneProxy());
+    }
+
+    // Create the fat AABB by inflating the AABB with a constant gap
+    SweepAndPruneProxy& proxy = mProxies[broadPhaseID];
+    const Vector3 gap(DYNAMIC_TREE_AABB_GAP, DYNAMIC_TREE_AABB_GAP, DYNAMIC_TREE_AABB_GAP);
+    proxy.aabb.setMin(aabb.getMin() - gap);
+    proxy.aabb.setMax(aabb.getMax() + gap);
+    proxy.proxyShape = proxyShape;
+    proxy.hasMoved = false;
+
+    // The new proxy is sorted with the other ones before the next query
+    mSortedProxies.add(broadPhaseID);
+    mNeedsSorting = true;
+
+    return broadPhaseID;
+}
+
+// Remove a proxy shape from the sorted array
+void SweepAndPruneBroadPhaseAlgorithm::removeProxy(int broadPhaseID) {
+
+    assert(mProxies[broadPhaseID].proxyShape != nullptr);
+
+    // Remove the proxy from the sorted array (this keeps the array sorted)
+    for (uint i=0; i < mSortedProxies.size(); i++) {
+        if (mSortedProxies[i] == broadPhaseID) {
+            mSortedProxies.removeAt(i);
+            break;
+        }
+    }
+
+    mProxies[broadPhaseID].proxyShape = nullptr;
+    mFreeProxies.add(broadPhaseID);
+}
+
+// Update the fat AABB of a proxy shape and return true if it has changed
+bool SweepAndPruneBroadPhaseAlgorithm::updateProxy(int broadPhaseID, const AABB& aabb, const Vector3& displacement,
+                                                   decimal gap, bool forceReinsert) {
+
+    SweepAndPruneProxy& proxy = mProxies[broadPhaseID];
+    assert(proxy.proxyShape != nullptr);
+
+    // If the new AABB is still inside the fat AABB of the proxy
+    if (!forceReinsert && proxy.aabb.contains(aabb)) {
+        return false;
+    }
+
+    // Compute the fat AABB by inflating the AABB with the gap
+    Vector3 min = aabb.getMin() - Vector3(gap, gap, gap);
+    Vector3 max = aabb.getMax() + Vector3(gap, gap, gap);
+
+    // Inflate the fat AABB in direction of the linear motion of the AABB
+    for (int i=0; i < 3; i++) {
+        if (displacement[i] < decimal(0.0)) {
+            min[i] += DYNAMIC_TREE_AABB_LIN_GAP_MULTIPLIER * displacement[i];
+        }
+        else {
+            max[i] += DYNAMIC_TREE_AABB_LIN_GAP_MULTIPLIER * displacement[i];
+        }
+    }
+
+    proxy.aabb.setMin(min);
+    proxy.aabb.setMax(max);
+
+    assert(proxy.aabb.contains(aabb));
+
+    mNeedsSorting = true;
+
+    return true;
+}
+
+// Sort the proxies again if some fat AABBs have changed
+/// An insertion sort is used because the order of the proxies changes only a little
+/// between two steps (temporal coherence).
+void SweepAndPruneBroadPhaseAlgorithm::sortProxies() const {
+
+    if (!mNeedsSorting) return;
+
+    RP3D_PROFILE("SweepAndPruneBroadPhaseAlgorithm::sortProxies()", mProfiler);
+
+    mMaxExtentX = decimal(0.0);
+
+    for (uint i=0; i < mSortedProxies.size(); i++) {
+
+        const int broadPhaseID = mSortedProxies[i];
+        const AABB& aabb = mProxies[broadPhaseID].aabb;
+        const decimal minX = aabb.getMin().x;
+
+        mMaxExtentX = std::max(mMaxExtentX, aabb.getMax().x - minX);
+
+        // Move the proxy toward the beginning of the array until it is sorted
+        uint j = i;
+        while (j > 0 && mProxies[mSortedProxies[j - 1]].aabb.getMin().x > minX) {
+            mSortedProxies[j] = mSortedProxies[j - 1];
+            j--;
+        }
+        mSortedProxies[j] = broadPhaseID;
+    }
+
+    mNeedsSorting = false;
+}
+
+// Return the index in the sorted array of the first proxy that may overlap with
+// an AABB starting at a given position on the X axis
+uint SweepAndPruneBroadPhaseAlgorithm::findFirstSortedProxy(decimal minX) const {
+
+    assert(!mNeedsSorting);
+
+    // A proxy that starts before minX minus the largest extent ends before minX
+    const decimal startX = minX - mMaxExtentX;
+
+    // Binary search of the first proxy starting at or after startX
+    uint first = 0;
+    uint last = static_cast<uint>(mSortedProxies.size());
+    while (first < last) {
+        const uint middle = (first + last) / 2;
+        if (mProxies[mSortedProxies[middle]].aabb.getMin().x < startX) {
+            first = middle + 1;
+        }
+        else {
+            last = middle;
+        }
+    }
+
+    return first;
+}
+
+// Compute the potential overlapping pairs by sweeping the sorted array
+void SweepAndPruneBroadPhaseAlgorithm::computePotentialPairs(MemoryManager& memoryManager) {
+
+    RP3D_PROFILE("SweepAndPruneBroadPhaseAlgorithm::computePotentialPairs()", mProfiler);
+
+    if (mMovedShapes.size() == 0) return;
+
+    sortProxies();
+
+    // Flag the proxies that have moved (or have been created) during the last step
+    for (auto it = mMovedShapes.begin(); it != mMovedShapes.end(); ++it) {
+        if (*it != -1) mProxies[*it].hasMoved = true;
+    }
+
+    // Sweep the sorted array
+    const uint nbProxies = static_cast<uint>(mSortedProxies.size());
+    for (uint i=0; i < nbProxies; i++) {
+
+        const SweepAndPruneProxy& proxy1 = mProxies[mSortedProxies[i]];
+        const Vector3& min1 = proxy1.aabb.getMin();
+        const Vector3& max1 = proxy1.aabb.getMax();
+
+        // For each proxy that starts before the end of the current one on the X axis
+        for (uint j=i+1; j < nbProxies; j++) {
+
+            const SweepAndPruneProxy& proxy2 = mProxies[mSortedProxies[j]];
+            const Vector3& min2 = proxy2.aabb.getMin();
+            if (min2.x > max1.x) break;
+
+            // Only the pairs with a moved shape have to be tested again
+            if (!proxy1.hasMoved && !proxy2.hasMoved) continue;
+
+            // Test the Y and Z axis
+            const Vector3& max2 = proxy2.aabb.getMax();
+            if (max1.y < min2.y || min1.y > max2.y) continue;
+            if (max1.z < min2.z || min1.z > max2.z) continue;
+
+            addPotentialPair(mSortedProxies[i], mSortedProxies[j]);
+        }
+    }
+
+    // Reset the flags of the moved proxies
+    for (auto it = mMovedShapes.begin(); it != mMovedShapes.end(); ++it) {
+        if (*it != -1) mProxies[*it].hasMoved = false;
+    }
+}
+
+// Report all the shapes that are overlapping with a given AABB
+void SweepAndPruneBroadPhaseAlgorithm::reportAllShapesOverlappingWithAABB(const AABB& aabb,
+                                                                          DynamicAABBTreeOverlapCallback& callback) const {
+
+    sortProxies();
+
+    const uint nbProxies = static_cast<uint>(mSortedProxies.size());
+    for (uint i=findFirstSortedProxy(aabb.getMin().x); i < nbProxies; i++) {
+
+        const int broadPhaseID = mSortedProxies[i];
+        const AABB& proxyAABB = mProxies[broadPhaseID].aabb;
+        if (proxyAABB.getMin().x > aabb.getMax().x) break;
+
+        if (proxyAABB.testCollision(aabb)) {
+            callback.notifyOverlappingNode(broadPhaseID);
+        }
+    }
+}
+
+// Sort the proxies so that several threads can then run queries at the same time
+void SweepAndPruneBroadPhaseAlgorithm::prepareParallelQueries() const {
+    sortProxies();
+}
+
+// Ray casting method
+void SweepAndPruneBroadPhaseAlgorithm::raycast(const Ray& ray, RaycastTest& raycastTest,
+                                               collisionmask raycastWithCategoryMaskBits) const {
+
+    RP3D_PROFILE("SweepAndPruneBroadPhaseAlgorithm::raycast()", mProfiler);
+
+    sortProxies();
+
+    BroadPhaseRaycastCallback broadPhaseRaycastCallback(*this, raycastWithCategoryMaskBits, raycastTest);
+
+    decimal maxFraction = ray.maxFraction;
+
+    // Only the proxies that overlap with the ray on the X axis can be hit
+    const Vector3 rayEnd = ray.point1 + maxFraction * (ray.point2 - ray.point1);
+    const decimal rayMinX = std::min(ray.point1.x, rayEnd.x);
+    const decimal rayMaxX = std::max(ray.point1.x, rayEnd.x);
+
+    const uint nbProxies = static_cast<uint>(mSortedProxies.size());
+    for (uint i=findFirstSortedProxy(rayMinX); i < nbProxies; i++) {
+
+        const int broadPhaseID = mSortedProxies[i];
+        const AABB& proxyAABB = mProxies[broadPhaseID].aabb;
+        if (proxyAABB.getMin().x > rayMaxX) break;
+
+        Ray rayTemp(ray.point1, ray.point2, maxFraction);
+
+        // Test if the ray intersects with the fat AABB of the proxy
+        if (!proxyAABB.testRayIntersect(rayTemp)) continue;
+
+        // Call the callback that will raycast again the broad-phase shape
+        decimal hitFraction = broadPhaseRaycastCallback.raycastBroadPhaseShape(broadPhaseID, rayTemp);
+
+        // If the user returned a hitFraction of zero, it means that
+        // the raycasting should stop here
+        if (hitFraction == decimal(0.0)) {
+            return;
+        }
+
+        // If the user returned a positive fraction, we update the maxFraction value
+        if (hitFraction > decimal(0.0) && hitFraction < maxFraction) {
+            maxFraction = hitFraction;
+        }
+    }
+}
+
+// Move all the fat AABBs by the opposite of the displacement of the origin of the world
+/// The order of the sorted proxies does not change because all the AABBs are moved together.
+void SweepAndPruneBroadPhaseAlgorithm::shiftOrigin(const Vector3& shift) {
+
+    mFatAABBsVersion++;
+
+    for (uint i=0; i < mProxies.size(); i++) {
+        if (mProxies[i].proxyShape != nullptr) {
+            mProxies[i].aabb.translate(-shift);
+        }
+    }
+}
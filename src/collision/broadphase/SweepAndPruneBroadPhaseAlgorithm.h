@@ -0,0 +1,174 @@
+/********************************************************************************
+* ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
+* Copyright (c) 2010-2018 Daniel Chappuis                                       *
+*********************************************************************************
+*                                                                               *
+* This software is provided 'as-is', without any express or implied warranty.   *
+* In no event will the authors be held liable for any damages arising from the  *
+* use of this software.                                                         *
+*                                                                               *
+* Permission is granted to anyone to use this software for any purpose,         *
+* including commercial applications, and to alter it and redistribute it        *
+* freely, subject to the following restrictions:                                *
+*                                                                               *
+* 1. The origin of this software must not be misrepresented; you must not claim *
+*    that you wrote the original software. If you use this software in a        *
+*    product, an acknowledgment in the product documentation would be           *
+*    appreciated but is not required.                                           *
+*                                                                               *
+* 2. Altered source versions must be plainly marked as such, and must not be    *
+*    misrepresented as being the original software.                             *
+*                                                                               *
+* 3. This notice may not be removed or altered from any source distribution.    *
+*                                                                               *
+********************************************************************************/
+
+#ifndef REACTPHYSICS3D_SWEEP_AND_PRUNE_BROAD_PHASE_ALGORITHM_H
+#define REACTPHYSICS3D_SWEEP_AND_PRUNE_BROAD_PHASE_ALGORITHM_H
+
+// Libraries
+#include "BroadPhaseAlgorithm.h"
+#include "containers/List.h"
+
+/// Namespace ReactPhysics3D
+namespace reactphysics3d {
+
+// Structure SweepAndPruneProxy
+/**
+ * This structure represents a proxy shape in the sweep-and-prune broad-phase.
+ */
+struct SweepAndPruneProxy {
+
+    // -------------------- Attributes -------------------- //
+
+    /// Fat AABB of the proxy shape
+    AABB aabb;
+
+    /// Pointer to the proxy shape (null if the proxy is free)
+    ProxyShape* proxyShape;
+
+    /// True if the proxy shape has moved (or has been created) during the last step
+    bool hasMoved;
+};
+
+// Class SweepAndPruneBroadPhaseAlgorithm
+/**
+ * This class implements the broad-phase collision detection with the sweep-and-prune
+ * (sort and sweep) algorithm. The fat AABBs of the proxy shapes are kept sorted by their
+ * minimum on the X axis. Because the shapes move a little between two steps, the array
+ * is almost sorted and an insertion sort restores the order in a time close to linear.
+ * The overlapping pairs are then found by sweeping the sorted array once: the AABBs that
+ * follow an AABB in the array and start before its end on the X axis are tested on the
+ * Y and Z axis. Only the pairs with a moved shape are reported to the collision detection.
+ *
+ * Compared to the dynamic AABB tree, this broad-phase has a linear memory layout and no
+ * tree to update but it sweeps all the shapes at each step with moved shapes. It is
+ * efficient for worlds with many small shapes that move coherently and not much spread
+ * along the X axis.
+ */
+class SweepAndPruneBroadPhaseAlgorithm : public BroadPhaseAlgorithm {
+
+    protected :
+
+        // -------------------- Attributes -------------------- //
+
+        /// Array of the proxies (indexed by the broad-phase IDs)
+        List<SweepAndPruneProxy> mProxies;
+
+        /// Broad-phase IDs of the free proxies of the array that can be reused
+        List<int> mFreeProxies;
+
+        /// Broad-phase IDs of the proxies sorted by the minimum of their fat AABB on the X axis
+        mutable List<int> mSortedProxies;
+
+        /// True if the array of sorted proxies has to be sorted again
+        mutable bool mNeedsSorting;
+
+        /// Largest extent of a fat AABB on the X axis (used to bound the queries)
+        mutable decimal mMaxExtentX;
+
+        // -------------------- Methods -------------------- //
+
+        /// Add a proxy shape into the sorted array and return its broad-phase ID
+        virtual int addProxy(ProxyShape* proxyShape, const AABB& aabb) override;
+
+        /// Remove a proxy shape from the sorted array
+        virtual void removeProxy(int broadPhaseID) override;
+
+        /// Update the fat AABB of a proxy shape and return true if it has changed
+        virtual bool updateProxy(int broadPhaseID, const AABB& aabb, const Vector3& displacement,
+                                 decimal gap, bool forceReinsert) override;
+
+        /// Compute the potential overlapping pairs by sweeping the sorted array
+        virtual void computePotentialPairs(MemoryManager& memoryManager) override;
+
+        /// Sort the proxies again if some fat AABBs have changed
+        void sortProxies() const;
+
+        /// Return the index in the sorted array of the first proxy that may overlap with
+        /// an AABB starting at a given position on the X axis
+        uint findFirstSortedProxy(decimal minX) const;
+
+    public :
+
+        // -------------------- Methods -------------------- //
+
+        /// Constructor
+        SweepAndPruneBroadPhaseAlgorithm(CollisionDetection& collisionDetection, const WorldSettings& worldSettings);
+
+        /// Destructor
+        virtual ~SweepAndPruneBroadPhaseAlgorithm() override = default;
+
+        /// Deleted copy-constructor
+        SweepAndPruneBroadPhaseAlgorithm(const SweepAndPruneBroadPhaseAlgorithm& algorithm) = delete;
+
+        /// Deleted assignment operator
+        SweepAndPruneBroadPhaseAlgorithm& operator=(const SweepAndPruneBroadPhaseAlgorithm& algorithm) = delete;
+
+        /// Return the number of bytes used by the broad-phase algorithm
+        virtual size_t getSizeInBytes() const override;
+
+        /// Allocate the memory needed to store a given number of proxy shapes
+        virtual void reserve(uint nbProxyShapes) override;
+
+        /// Report all the shapes that are overlapping with a given AABB
+        virtual void reportAllShapesOverlappingWithAABB(const AABB& aabb,
+                                                        DynamicAABBTreeOverlapCallback& callback) const override;
+
+        /// Return the proxy shape corresponding to the broad-phase id in parameter
+        virtual ProxyShape* getProxyShapeForBroadPhaseId(int broadPhaseId) const override;
+
+        /// Return the fat AABB of a given broad-phase shape
+        virtual const AABB& getFatAABB(int broadPhaseId) const override;
+
+        /// Ray casting method
+        virtual void raycast(const Ray& ray, RaycastTest& raycastTest,
+                             collisionmask raycastWithCategoryMaskBits) const override;
+
+        /// Sort the proxies so that several threads can then run queries at the same time
+        virtual void prepareParallelQueries() const override;
+
+        /// Move all the fat AABBs by the opposite of the displacement of the origin of the world
+        virtual void shiftOrigin(const Vector3& shift) override;
+};
+
+// Return the number of bytes used by the broad-phase algorithm
+inline size_t SweepAndPruneBroadPhaseAlgorithm::getSizeInBytes() const {
+    return sizeof(SweepAndPruneBroadPhaseAlgorithm);
+}
+
+// Return the fat AABB of a given broad-phase shape
+inline const AABB& SweepAndPruneBroadPhaseAlgorithm::getFatAABB(int broadPhaseId) const  {
+    assert(broadPhaseId >= 0 && broadPhaseId < static_cast<int>(mProxies.size()));
+    return mProxies[broadPhaseId].aabb;
+}
+
+// Return the proxy shape corresponding to the broad-phase id in parameter
+inline ProxyShape* SweepAndPruneBroadPhaseAlgorithm::getProxyShapeForBroadPhaseId(int broadPhaseId) const {
+    assert(broadPhaseId >= 0 && broadPhaseId < static_cast<int>(mProxies.size()));
+    return mProxies[broadPhaseId].proxyShape;
+}
+
+}
+
+#endif
@@ -0,0 +1,325 @@
+/********************************************************************************
+* ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
+* Copyright (c) 2010-2018 Daniel Chappuis                                       *
+*********************************************************************************
+*                                                                               *
+* This software is provided 'as-is', without any express or implied warranty.   *
+* In no event will the authors be held liable for any damages arising from the  *
+* use of this software.                                                         *
+*                                                                               *
+* Permission is granted to anyone to use this software for any purpose,         *
+* including commercial applications, and to alter it and redistribute it        *
+* freely, subject to the following restrictions:                                *
+*                                                                               *
+* 1. The origin of this software must not be misrepresented; you must not claim *
+*    that you wrote the original software. If you use this software in a        *
+*    product, an acknowledgment in the product documentation would be           *
+*    appreciated but is not required.                                           *
+*                                                                               *
+* 2. Altered source versions must be plainly marked as such, and must not be    *
+*    misrepresented as being the original software.                             *
+*                                                                               *
+* 3. This notice may not be removed or altered from any source distribution.    *
+*                                                                               *
+********************************************************************************/
+
+
+// Libraries
+#include "WideAABBTree.h"
+#include "DynamicAABBTree.h"
+#include "containers/Stack.h"
+#include "memory/MemoryAllocator.h"
+#include "utils/Profiler.h"
+#include <cstring>
+
+using namespace reactphysics3d;
+
+// Constructor
+WideAABBTree::WideAABBTree(MemoryAllocator& allocator)
+             : mAllocator(allocator), mNodes(nullptr), mRootNodeIndex(WideTreeNode::NULL_CHILD),
+               mNbNodes(0), mNbAllocatedNodes(0) {
+
+#ifdef IS_PROFILING_ACTIVE
+    mProfiler = nullptr;
+#endif
+
+}
+
+// Destructor
+WideAABBTree::~WideAABBTree() {
+
+    // Free the allocated memory for the nodes
+    if (mNodes != nullptr) {
+        mAllocator.release(mNodes, mNbAllocatedNodes * sizeof(WideTreeNode));
+    }
+}
+
+// Allocate and return a node of the tree
+/// The memory of the nodes must have been reserved before (in the build() method).
+int32 WideAABBTree::allocateNode() {
+    assert(mNbNodes < mNbAllocatedNodes);
+    mNbNodes++;
+    return static_cast<int32>(mNbNodes - 1);
+}
+
+// Set a lane of a node with the AABB of a child
+void WideAABBTree::setChild(int32 nodeIndex, uint lane, const AABB& aabb, int32 child) {
+
+    WideTreeNode& node = mNodes[nodeIndex];
+    const Vector3& min = aabb.getMin();
+    const Vector3& max = aabb.getMax();
+    node.minX[lane] = min.x;
+    node.minY[lane] = min.y;
+    node.minZ[lane] = min.z;
+    node.maxX[lane] = max.x;
+    node.maxY[lane] = max.y;
+    node.maxZ[lane] = max.z;
+    node.children[lane] = child;
+}
+
+// Build the wide tree from a dynamic AABB tree
+/// Each node of the binary tree is collapsed with its descendants until it has four
+/// children. The internal node with the largest volume is expanded first so that the
+/// children of a wide node have similar sizes. The unused lanes of a node have an empty
+/// AABB that never overlaps with anything.
+void WideAABBTree::build(const DynamicAABBTree& tree) {
+
+    RP3D_PROFILE("WideAABBTree::build()", mProfiler);
+
+    mNbNodes = 0;
+    mRootNodeIndex = WideTreeNode::NULL_CHILD;
+
+    if (tree.mRootNodeID == TreeNode::NULL_TREE_NODE) return;
+
+    // The wide tree has less nodes than the binary tree. We reserve the memory for all of
+    // them so that the nodes are not reallocated during the build
+    const uint nbMaxNodes = static_cast<uint>(tree.mNbNodes);
+    if (nbMaxNodes > mNbAllocatedNodes) {
+        if (mNodes != nullptr) {
+            mAllocator.release(mNodes, mNbAllocatedNodes * sizeof(WideTreeNode));
+        }
+        mNbAllocatedNodes = std::max(nbMaxNodes, 2 * mNbAllocatedNodes);
+        mNodes = static_cast<WideTreeNode*>(mAllocator.allocate(mNbAllocatedNodes * sizeof(WideTreeNode)));
+        assert(mNodes != nullptr);
+    }
+
+    const AABB emptyAABB(Vector3(DECIMAL_LARGEST, DECIMAL_LARGEST, DECIMAL_LARGEST),
+                         Vector3(-DECIMAL_LARGEST, -DECIMAL_LARGEST, -DECIMAL_LARGEST));
+
+    // Stack with the pairs (node of the binary tree, node of the wide tree) to build
+    Stack<int32, 64> stack(mAllocator);
+    mRootNodeIndex = allocateNode();
+    stack.push(tree.mRootNodeID);
+    stack.push(mRootNodeIndex);
+
+    while (stack.getNbElements() > 0) {
+
+        const int32 nodeIndex = stack.pop();
+        const int32 binaryNodeID = stack.pop();
+        const TreeNode* binaryNode = tree.mNodes + binaryNodeID;
+
+        // Collapse the binary node with its descendants
+        int32 children[WideTreeNode::NB_CHILDREN];
+        uint nbChildren = 0;
+        if (binaryNode->isLeaf()) {
+            children[nbChildren++] = binaryNodeID;
+        }
+        else {
+            children[nbChildren++] = binaryNode->children[0];
+            children[nbChildren++] = binaryNode->children[1];
+        }
+        while (nbChildren < WideTreeNode::NB_CHILDREN) {
+
+            // Find the internal child with the largest volume
+            int bestChild = -1;
+            decimal bestVolume = decimal(-1.0);
+            for (uint i=0; i < nbChildren; i++) {
+                const TreeNode* child = tree.mNodes + children[i];
+                if (!child->isLeaf() && child->aabb.getVolume() > bestVolume) {
+                    bestChild = static_cast<int>(i);
+                    bestVolume = child->aabb.getVolume();
+                }
+            }
+
+            // If all the children are leaves, the node cannot be expanded anymore
+            if (bestChild < 0) break;
+
+            // Replace the child by its own two children
+            const TreeNode* expandedChild = tree.mNodes + children[bestChild];
+            children[bestChild] = expandedChild->children[0];
+            children[nbChildren++] = expandedChild->children[1];
+        }
+
+        // Set the lanes of the wide node
+        for (uint lane=0; lane < WideTreeNode::NB_CHILDREN; lane++) {
+
+            if (lane >= nbChildren) {
+                setChild(nodeIndex, lane, emptyAABB, WideTreeNode::NULL_CHILD);
+                continue;
+            }
+
+            const TreeNode* child = tree.mNodes + children[lane];
+            if (child->isLeaf()) {
+                setChild(nodeIndex, lane, child->aabb, WideTreeNode::encodeLeaf(children[lane]));
+            }
+            else {
+
+                // The internal child becomes a node of the wide tree that is built later
+                const int32 childIndex = allocateNode();
+                setChild(nodeIndex, lane, child->aabb, childIndex);
+                stack.push(children[lane]);
+                stack.push(childIndex);
+            }
+        }
+    }
+}
+
+// Move the AABBs of all the nodes by a given translation
+void WideAABBTree::translate(const Vector3& translation) {
+
+    for (uint i=0; i < mNbNodes; i++) {
+
+        WideTreeNode& node = mNodes[i];
+        for (uint c=0; c < WideTreeNode::NB_CHILDREN; c++) {
+            if (node.children[c] == WideTreeNode::NULL_CHILD) continue;
+            node.minX[c] += translation.x;
+            node.minY[c] += translation.y;
+            node.minZ[c] += translation.z;
+            node.maxX[c] += translation.x;
+            node.maxY[c] += translation.y;
+            node.maxZ[c] += translation.z;
+        }
+    }
+}
+
+// Report all shapes overlapping with the AABB given in parameter.
+/// The IDs reported to the callback are the IDs of the leaf nodes of the dynamic AABB tree.
+void WideAABBTree::reportAllShapesOverlappingWithAABB(const AABB& aabb,
+                                                      DynamicAABBTreeOverlapCallback& callback) const {
+
+    if (mRootNodeIndex == WideTreeNode::NULL_CHILD) return;
+
+    const Vector3& min = aabb.getMin();
+    const Vector3& max = aabb.getMax();
+
+    // Create a stack with the nodes to visit
+    Stack<int32, 64> stack(mAllocator);
+    stack.push(mRootNodeIndex);
+
+    // While there are still nodes to visit
+    while (stack.getNbElements() > 0) {
+
+        const WideTreeNode& node = mNodes[stack.pop()];
+
+        // Test the AABB in parameter against the AABBs of all the children at once
+        bool isOverlapping[WideTreeNode::NB_CHILDREN];
+        for (uint lane=0; lane < WideTreeNode::NB_CHILDREN; lane++) {
+            isOverlapping[lane] = (max.x >= node.minX[lane]) & (min.x <= node.maxX[lane]) &
+                                  (max.y >= node.minY[lane]) & (min.y <= node.maxY[lane]) &
+                                  (max.z >= node.minZ[lane]) & (min.z <= node.maxZ[lane]);
+        }
+
+        for (uint lane=0; lane < WideTreeNode::NB_CHILDREN; lane++) {
+
+            const int32 child = node.children[lane];
+            if (!isOverlapping[lane] || child == WideTreeNode::NULL_CHILD) continue;
+
+            if (WideTreeNode::isLeaf(child)) {
+
+                // Notify the broad-phase about a new potential overlapping pair
+                callback.notifyOverlappingNode(WideTreeNode::decodeLeaf(child));
+            }
+            else {
+
+                // We need to visit the child
+                stack.push(child);
+            }
+        }
+    }
+}
+
+// Ray casting method
+/// The AABBs of the children of a node are tested against the ray with the same separating
+/// axis test as AABB::testRayIntersect().
+void WideAABBTree::raycast(const Ray& ray, DynamicAABBTreeRaycastCallback& callback) const {
+
+    RP3D_PROFILE("WideAABBTree::raycast()", mProfiler);
+
+    if (mRootNodeIndex == WideTreeNode::NULL_CHILD) return;
+
+    decimal maxFraction = ray.maxFraction;
+
+    // Epsilon term to counteract arithmetic errors when the ray is (near) parallel to an axis
+    const decimal epsilon = decimal(0.00001);
+
+    Stack<int32, 64> stack(mAllocator);
+    stack.push(mRootNodeIndex);
+
+    // Walk through the tree from the root looking for proxy shapes
+    // that overlap with the ray AABB
+    while (stack.getNbElements() > 0) {
+
+        const WideTreeNode& node = mNodes[stack.pop()];
+
+        Ray rayTemp(ray.point1, ray.point2, maxFraction);
+        const Vector3 point2 = ray.point1 + maxFraction * (ray.point2 - ray.point1);
+        const Vector3 d = point2 - ray.point1;
+        const Vector3 sum = ray.point1 + point2;
+        const decimal adx = std::abs(d.x);
+        const decimal ady = std::abs(d.y);
+        const decimal adz = std::abs(d.z);
+
+        // Test the ray against the AABBs of all the children at once
+        bool isHit[WideTreeNode::NB_CHILDREN];
+        for (uint lane=0; lane < WideTreeNode::NB_CHILDREN; lane++) {
+
+            const decimal ex = node.maxX[lane] - node.minX[lane];
+            const decimal ey = node.maxY[lane] - node.minY[lane];
+            const decimal ez = node.maxZ[lane] - node.minZ[lane];
+            const decimal mx = sum.x - node.minX[lane] - node.maxX[lane];
+            const decimal my = sum.y - node.minY[lane] - node.maxY[lane];
+            const decimal mz = sum.z - node.minZ[lane] - node.maxZ[lane];
+
+            // Test if the AABB face normals and the cross products between the face
+            // normals and the ray direction are separating axis
+            isHit[lane] = (std::abs(mx) <= ex + adx) & (std::abs(my) <= ey + ady) & (std::abs(mz) <= ez + adz) &
+                          (std::abs(my * d.z - mz * d.y) <= ey * (adz + epsilon) + ez * (ady + epsilon)) &
+                          (std::abs(mz * d.x - mx * d.z) <= ex * (adz + epsilon) + ez * (adx + epsilon)) &
+                          (std::abs(mx * d.y - my * d.x) <= ex * (ady + epsilon) + ey * (adx + epsilon));
+        }
+
+        for (uint lane=0; lane < WideTreeNode::NB_CHILDREN; lane++) {
+
+            const int32 child = node.children[lane];
+            if (!isHit[lane] || child == WideTreeNode::NULL_CHILD) continue;
+
+            // If the child is a leaf of the tree
+            if (WideTreeNode::isLeaf(child)) {
+
+                // Call the callback that will raycast again the broad-phase shape
+                decimal hitFraction = callback.raycastBroadPhaseShape(WideTreeNode::decodeLeaf(child), rayTemp);
+
+                // If the user returned a hitFraction of zero, it means that
+                // the raycasting should stop here
+                if (hitFraction == decimal(0.0)) {
+                    return;
+                }
+
+                // If the user returned a positive fraction, we update the maxFraction
+                // value and the ray using the new maximum fraction
+                if (hitFraction > decimal(0.0) && hitFraction < maxFraction) {
+                    maxFraction = hitFraction;
+                    rayTemp.maxFraction = maxFraction;
+                }
+
+                // If the user returned a negative fraction, we continue
+                // the raycasting as if the proxy shape did not exist
+            }
+            else {
+
+                // Push the child in the stack of nodes to explore
+                stack.push(child);
+            }
+        }
+    }
+}
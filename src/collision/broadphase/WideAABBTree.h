@@ -0,0 +1,220 @@
+/********************************************************************************
+* ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
+* Copyright (c) 2010-2018 Daniel Chappuis                                       *
+*********************************************************************************
+*                                                                               *
+* This software is provided 'as-is', without any express or implied warranty.   *
+* In no event will the authors be held liable for any damages arising from the  *
+* use of this software.                                                         *
+*                                                                               *
+* Permission is granted to anyone to use this software for any purpose,         *
+* including commercial applications, and to alter it and redistribute it        *
+* freely, subject to the following restrictions:                                *
+*                                                                               *
+* 1. The origin of this software must not be misrepresented; you must not claim *
+*    that you wrote the original software. If you use this software in a        *
+*    product, an acknowledgment in the product documentation would be           *
+*    appreciated but is not required.                                           *
+*                                                                               *
+* 2. Altered source versions must be plainly marked as such, and must not be    *
+*    misrepresented as being the original software.                             *
+*                                                                               *
+* 3. This notice may not be removed or altered from any source distribution.    *
+*                                                                               *
+********************************************************************************/
+
+
+#ifndef REACTPHYSICS3D_WIDE_AABB_TREE_H
+#define REACTPHYSICS3D_WIDE_AABB_TREE_H
+
+// Libraries
+#include "configuration.h"
+#include "collision/shapes/AABB.h"
+
+/// Namespace ReactPhysics3D
+namespace reactphysics3d {
+
+// Declarations
+class DynamicAABBTree;
+class DynamicAABBTreeOverlapCallback;
+class DynamicAABBTreeRaycastCallback;
+class MemoryAllocator;
+class Profiler;
+
+// Structure WideTreeNode
+/**
+ * This structure represents a node of the wide AABB tree. The AABBs of the children
+ * of the node are stored as structure of arrays (one lane per child) so that the
+ * AABBs of all the children are tested at once.
+ */
+struct WideTreeNode {
+
+    // -------------------- Constants -------------------- //
+
+    /// Number of children of a node
+    static const uint NB_CHILDREN = 4;
+
+    /// Null child constant
+    static const int32 NULL_CHILD = -1;
+
+    // -------------------- Attributes -------------------- //
+
+    /// Minimum x coordinates of the AABBs of the children
+    decimal minX[NB_CHILDREN];
+
+    /// Minimum y coordinates of the AABBs of the children
+    decimal minY[NB_CHILDREN];
+
+    /// Minimum z coordinates of the AABBs of the children
+    decimal minZ[NB_CHILDREN];
+
+    /// Maximum x coordinates of the AABBs of the children
+    decimal maxX[NB_CHILDREN];
+
+    /// Maximum y coordinates of the AABBs of the children
+    decimal maxY[NB_CHILDREN];
+
+    /// Maximum z coordinates of the AABBs of the children
+    decimal maxZ[NB_CHILDREN];
+
+    /// Children of the node. A child is either the index of a node of the wide tree (positive),
+    /// the encoded ID of a leaf node of the dynamic AABB tree (smaller than NULL_CHILD) or NULL_CHILD
+    int32 children[NB_CHILDREN];
+
+    // -------------------- Methods -------------------- //
+
+    /// Return true if a child is a leaf
+    static bool isLeaf(int32 child);
+
+    /// Return the encoded child of a leaf node of the dynamic AABB tree
+    static int32 encodeLeaf(int32 nodeID);
+
+    /// Return the ID in the dynamic AABB tree of a leaf child
+    static int32 decodeLeaf(int32 child);
+};
+
+// Class WideAABBTree
+/**
+ * This class is a read-only AABB tree with four children per node that is built from a
+ * dynamic AABB tree. Each node of the wide tree is obtained by collapsing a node of the
+ * binary tree with its children and grand-children. The wide tree has half the depth
+ * of the binary tree and the AABBs of the four children of a node are stored contiguously
+ * as structure of arrays. The overlap and raycast queries therefore visit less nodes and
+ * test the AABBs of all the children of a node in a single loop that the compiler can
+ * vectorize, which reduces the latency of the traversal of large trees.
+ *
+ * The leaves of the wide tree are the leaf nodes of the dynamic AABB tree and the queries
+ * report the same IDs as the queries of the dynamic AABB tree. The wide tree must be built
+ * again when the dynamic AABB tree is modified.
+ */
+class WideAABBTree {
+
+    private:
+
+        // -------------------- Attributes -------------------- //
+
+        /// Memory allocator
+        MemoryAllocator& mAllocator;
+
+        /// Pointer to the memory location of the nodes of the tree
+        WideTreeNode* mNodes;
+
+        /// Index of the root node of the tree
+        int32 mRootNodeIndex;
+
+        /// Number of nodes in the tree
+        uint mNbNodes;
+
+        /// Number of allocated nodes
+        uint mNbAllocatedNodes;
+
+#ifdef IS_PROFILING_ACTIVE
+
+		/// Pointer to the profiler
+		Profiler* mProfiler;
+
+#endif
+
+        // -------------------- Methods -------------------- //
+
+        /// Allocate and return a node of the tree
+        int32 allocateNode();
+
+        /// Set a lane of a node with the AABB of a child
+        void setChild(int32 nodeIndex, uint lane, const AABB& aabb, int32 child);
+
+    public:
+
+        // -------------------- Methods -------------------- //
+
+        /// Constructor
+        WideAABBTree(MemoryAllocator& allocator);
+
+        /// Destructor
+        ~WideAABBTree();
+
+        /// Deleted copy-constructor
+        WideAABBTree(const WideAABBTree& tree) = delete;
+
+        /// Deleted assignment operator
+        WideAABBTree& operator=(const WideAABBTree& tree) = delete;
+
+        /// Build the wide tree from a dynamic AABB tree
+        void build(const DynamicAABBTree& tree);
+
+        /// Move the AABBs of all the nodes by a given translation
+        void translate(const Vector3& translation);
+
+        /// Return the number of nodes of the tree
+        uint getNbNodes() const;
+
+        /// Report all shapes overlapping with the AABB given in parameter.
+        void reportAllShapesOverlappingWithAABB(const AABB& aabb,
+                                                DynamicAABBTreeOverlapCallback& callback) const;
+
+        /// Ray casting method
+        void raycast(const Ray& ray, DynamicAABBTreeRaycastCallback& callback) const;
+
+#ifdef IS_PROFILING_ACTIVE
+
+		/// Set the profiler
+		void setProfiler(Profiler* profiler);
+
+#endif
+
+};
+
+// Return true if a child is a leaf
+inline bool WideTreeNode::isLeaf(int32 child) {
+    return child < NULL_CHILD;
+}
+
+// Return the encoded child of a leaf node of the dynamic AABB tree
+inline int32 WideTreeNode::encodeLeaf(int32 nodeID) {
+    assert(nodeID >= 0);
+    return NULL_CHILD - 1 - nodeID;
+}
+
+// Return the ID in the dynamic AABB tree of a leaf child
+inline int32 WideTreeNode::decodeLeaf(int32 child) {
+    assert(isLeaf(child));
+    return NULL_CHILD - 1 - child;
+}
+
+// Return the number of nodes of the tree
+inline uint WideAABBTree::getNbNodes() const {
+    return mNbNodes;
+}
+
+#ifdef IS_PROFILING_ACTIVE
+
+// Set the profiler
+inline void WideAABBTree::setProfiler(Profiler* profiler) {
+	mProfiler = profiler;
+}
+
+#endif
+
+}
+
+#endif
@@ -0,0 +1,409 @@
+/********************************************************************************
+* ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
+* Copyright (c) 2010-2018 Daniel Chappuis                                       *
+*********************************************************************************
+*                                                                               *
+* This software is provided 'as-is', without any express or implied warranty.   *
+* In no event will the authors be held liable for any damages arising from the  *
+* use of this software.                                                         *
+*                                                                               *
+* Permission is granted to anyone to use this software for any purpose,         *
+* including commercial applications, and to alter it and redistribute it        *
+* freely, subject to the following restrictions:                                *
+*                                                                               *
+* 1. The origin of this software must not be misrepresented; you must not claim *
+*    that you wrote the original software. If you use this software in a        *
+*    product, an acknowledgment in the product documentation would be           *
+*    appreciated but is not required.                                           *
+*                                                                               *
+* 2. Altered source versions must be plainly marked as such, and must not be    *
+*    misrepresented as being the original software.                             *
+*                                                                               *
+* 3. This notice may not be removed or altered from any source distribution.    *
+*                                                                               *
+********************************************************************************/
+
+// Libraries
+#include "BoxVsBoxAlgorithm.h"
+#include "collision/shapes/BoxShape.h"
+#include "collision/NarrowPhaseInfo.h"
+#include "engine/OverlappingPair.h"
+#include "mathematics/mathematics_functions.h"
+#include "utils/Profiler.h"
+
+// We want to use the ReactPhysics3D namespace
+using namespace reactphysics3d;
+
+// Static variables initialization
+const decimal BoxVsBoxAlgorithm::SAME_SEPARATING_AXIS_BIAS = decimal(0.001);
+const decimal BoxVsBoxAlgorithm::PARALLEL_EDGES_EPSILON = decimal(0.000001);
+
+// Compute the narrow-phase collision detection between two boxes
+/// The candidate axes are numbered from 0 to 14: the face normals of box 1 (0 to 2), the
+/// face normals of box 2 (3 to 5) and the cross products of the edge directions i of box 1
+/// and j of box 2 (6 + 3 * i + j).
+bool BoxVsBoxAlgorithm::testCollision(NarrowPhaseInfo* narrowPhaseInfo, bool reportContacts,
+                                      MemoryAllocator& memoryAllocator) {
+
+    RP3D_PROFILE("BoxVsBoxAlgorithm::testCollision()", mProfiler);
+
+    assert(narrowPhaseInfo->collisionShape1->getName() == CollisionShapeName::BOX);
+    assert(narrowPhaseInfo->collisionShape2->getName() == CollisionShapeName::BOX);
+
+    const BoxShape* box1 = static_cast<const BoxShape*>(narrowPhaseInfo->collisionShape1);
+    const BoxShape* box2 = static_cast<const BoxShape*>(narrowPhaseInfo->collisionShape2);
+
+    // Compute the configuration of box 2 in the local-space of box 1
+    BoxPair pair;
+    pair.extent1 = box1->getExtent();
+    pair.extent2 = box2->getExtent();
+    pair.box2ToBox1 = narrowPhaseInfo->shape1ToWorldTransform.getInverse() * narrowPhaseInfo->shape2ToWorldTransform;
+    pair.box1ToBox2 = pair.box2ToBox1.getInverse();
+    pair.rotation = pair.box2ToBox1.getOrientation().getMatrix();
+    for (uint i=0; i < 3; i++) {
+        for (uint j=0; j < 3; j++) {
+            pair.absRotation[i][j] = std::abs(pair.rotation[i][j]) + MACHINE_EPSILON;
+        }
+    }
+
+    LastFrameCollisionInfo* lastFrameCollisionInfo = narrowPhaseInfo->getLastFrameCollisionInfo();
+    lastFrameCollisionInfo->satWasPreviousAxisUsed = false;
+
+    static const uint faceAxes[6] = {2, 0, 2, 0, 1, 1};
+
+    // If the last frame collision info is valid, we first test the minimum separating axis of the previous frame
+    if (lastFrameCollisionInfo->isValid && lastFrameCollisionInfo->wasUsingSAT &&
+        lastFrameCollisionInfo->satMinAxisFaceIndex < 6 &&
+        lastFrameCollisionInfo->satMinEdge1Index < 3 && lastFrameCollisionInfo->satMinEdge2Index < 3) {
+
+        uint previousAxisIndex;
+        if (lastFrameCollisionInfo->satIsAxisFacePolyhedron1) {
+            previousAxisIndex = faceAxes[lastFrameCollisionInfo->satMinAxisFaceIndex];
+        }
+        else if (lastFrameCollisionInfo->satIsAxisFacePolyhedron2) {
+            previousAxisIndex = 3 + faceAxes[lastFrameCollisionInfo->satMinAxisFaceIndex];
+        }
+        else {
+            previousAxisIndex = 6 + 3 * lastFrameCollisionInfo->satMinEdge1Index + lastFrameCollisionInfo->satMinEdge2Index;
+        }
+
+        const decimal penetrationDepth = computePenetrationDepth(pair, previousAxisIndex);
+
+        // If the previous axis is still a separating axis in this frame
+        if (penetrationDepth <= decimal(0.0)) {
+
+            lastFrameCollisionInfo->satWasPreviousAxisUsed = true;
+
+            return false;
+        }
+
+        // If the boxes were colliding on a face in the previous frame and still overlap on its normal,
+        // we directly clip the faces again without testing the other axes
+        if (lastFrameCollisionInfo->wasColliding && previousAxisIndex < 6) {
+
+            uint referenceFaceIndex = lastFrameCollisionInfo->satMinAxisFaceIndex;
+            if (!reportContacts || computeFaceContactPoints(pair, previousAxisIndex, penetrationDepth,
+                                                            narrowPhaseInfo, referenceFaceIndex)) {
+
+                lastFrameCollisionInfo->satMinAxisFaceIndex = referenceFaceIndex;
+                lastFrameCollisionInfo->satWasPreviousAxisUsed = true;
+
+                return true;
+            }
+
+            // The contact manifold is empty. Therefore, we have to test all the axes again
+        }
+    }
+
+    // Find the axis of minimum penetration depth (the face normals are preferred to the
+    // following axes when the depths are almost the same)
+    decimal minPenetrationDepth = DECIMAL_LARGEST;
+    uint minAxisIndex = 0;
+    for (uint axisIndex=0; axisIndex < NB_BOX_AXES; axisIndex++) {
+
+        const decimal penetrationDepth = computePenetrationDepth(pair, axisIndex);
+
+        // If we have found a separating axis
+        if (penetrationDepth <= decimal(0.0)) {
+            minAxisIndex = axisIndex;
+            minPenetrationDepth = penetrationDepth;
+            break;
+        }
+
+        if (penetrationDepth < minPenetrationDepth - SAME_SEPARATING_AXIS_BIAS) {
+            minPenetrationDepth = penetrationDepth;
+            minAxisIndex = axisIndex;
+        }
+    }
+
+    bool isColliding = minPenetrationDepth > decimal(0.0);
+
+    // Compute the contact points along the axis of minimum penetration depth
+    uint referenceFaceIndex = 0;
+    if (isColliding && reportContacts) {
+
+        if (minAxisIndex < 6) {
+
+            // There should be clipping points here. If it is not the case, it might be
+            // because of a numerical issue
+            isColliding = computeFaceContactPoints(pair, minAxisIndex, minPenetrationDepth, narrowPhaseInfo,
+                                                   referenceFaceIndex);
+        }
+        else {
+            computeEdgeContactPoint(pair, minAxisIndex, minPenetrationDepth, narrowPhaseInfo);
+        }
+    }
+    else if (minAxisIndex < 3) {
+        referenceFaceIndex = computeFaceIndex(minAxisIndex, pair.box2ToBox1.getPosition()[minAxisIndex] >= decimal(0.0));
+    }
+    else if (minAxisIndex < 6) {
+        referenceFaceIndex = computeFaceIndex(minAxisIndex - 3, pair.box1ToBox2.getPosition()[minAxisIndex - 3] >= decimal(0.0));
+    }
+
+    // Keep the axis for the temporal coherence of the next frame
+    lastFrameCollisionInfo->satIsAxisFacePolyhedron1 = minAxisIndex < 3;
+    lastFrameCollisionInfo->satIsAxisFacePolyhedron2 = minAxisIndex >= 3 && minAxisIndex < 6;
+    lastFrameCollisionInfo->satMinAxisFaceIndex = referenceFaceIndex;
+    lastFrameCollisionInfo->satMinEdge1Index = minAxisIndex >= 6 ? (minAxisIndex - 6) / 3 : 0;
+    lastFrameCollisionInfo->satMinEdge2Index = minAxisIndex >= 6 ? (minAxisIndex - 6) % 3 : 0;
+
+    return isColliding;
+}
+
+// Return the penetration depth of the boxes along a candidate axis (negative if the axis separates them)
+/// The depth along the cross product of two edges that are almost parallel is DECIMAL_LARGEST
+/// because such an axis cannot be the minimum separating axis.
+decimal BoxVsBoxAlgorithm::computePenetrationDepth(const BoxPair& pair, uint axisIndex) const {
+
+    const Vector3& a = pair.extent1;
+    const Vector3& b = pair.extent2;
+    const Matrix3x3& r = pair.rotation;
+    const Matrix3x3& absR = pair.absRotation;
+    const Vector3& t = pair.box2ToBox1.getPosition();
+
+    // Face normal of box 1
+    if (axisIndex < 3) {
+        const uint i = axisIndex;
+        const decimal radius2 = b.x * absR[i][0] + b.y * absR[i][1] + b.z * absR[i][2];
+        return a[i] + radius2 - std::abs(t[i]);
+    }
+
+    // Face normal of box 2
+    if (axisIndex < 6) {
+        const uint j = axisIndex - 3;
+        const decimal radius1 = a.x * absR[0][j] + a.y * absR[1][j] + a.z * absR[2][j];
+        const decimal distance = t.x * r[0][j] + t.y * r[1][j] + t.z * r[2][j];
+        return radius1 + b[j] - std::abs(distance);
+    }
+
+    // Cross product of the edge direction i of box 1 and j of box 2
+    const uint i = (axisIndex - 6) / 3;
+    const uint j = (axisIndex - 6) % 3;
+    const decimal lengthSquare = decimal(1.0) - r[i][j] * r[i][j];
+    if (lengthSquare < PARALLEL_EDGES_EPSILON) return DECIMAL_LARGEST;
+
+    const uint i1 = (i + 1) % 3;
+    const uint i2 = (i + 2) % 3;
+    const uint j1 = (j + 1) % 3;
+    const uint j2 = (j + 2) % 3;
+    const decimal radius1 = a[i1] * absR[i2][j] + a[i2] * absR[i1][j];
+    const decimal radius2 = b[j1] * absR[i][j2] + b[j2] * absR[i][j1];
+    const decimal distance = t[i2] * r[i1][j] - t[i1] * r[i2][j];
+
+    return (radius1 + radius2 - std::abs(distance)) / std::sqrt(lengthSquare);
+}
+
+// Compute the contact points of a face axis by clipping the incident face against the reference face
+/// The method returns true if contact points have been found
+bool BoxVsBoxAlgorithm::computeFaceContactPoints(const BoxPair& pair, uint axisIndex, decimal penetrationDepth,
+                                                 NarrowPhaseInfo* narrowPhaseInfo, uint& outReferenceFaceIndex) const {
+
+    RP3D_PROFILE("BoxVsBoxAlgorithm::computeFaceContactPoints()", mProfiler);
+
+    assert(axisIndex < 6);
+    assert(penetrationDepth > decimal(0.0));
+
+    const bool isReferenceBox1 = axisIndex < 3;
+    const uint referenceAxis = isReferenceBox1 ? axisIndex : axisIndex - 3;
+    const Vector3& referenceExtent = isReferenceBox1 ? pair.extent1 : pair.extent2;
+    const Vector3& incidentExtent = isReferenceBox1 ? pair.extent2 : pair.extent1;
+    const Transform& incidentToReference = isReferenceBox1 ? pair.box2ToBox1 : pair.box1ToBox2;
+    const Transform& referenceToIncident = isReferenceBox1 ? pair.box1ToBox2 : pair.box2ToBox1;
+
+    // The reference face is the one that faces the center of the incident box
+    const bool isReferencePositive = incidentToReference.getPosition()[referenceAxis] >= decimal(0.0);
+    const decimal referenceSign = isReferencePositive ? decimal(1.0) : decimal(-1.0);
+    Vector3 axisReferenceSpace(0, 0, 0);
+    axisReferenceSpace[referenceAxis] = referenceSign;
+    const uint referenceFaceIndex = computeFaceIndex(referenceAxis, isReferencePositive);
+    outReferenceFaceIndex = referenceFaceIndex;
+
+    // The incident face is the face of the other box that is the most anti-parallel to the reference normal
+    const Vector3 axisIncidentSpace = referenceToIncident.getOrientation() * axisReferenceSpace;
+    const Vector3 absAxisIncidentSpace = axisIncidentSpace.getAbsoluteVector();
+    const uint incidentAxis = absAxisIncidentSpace.getMaxAxis();
+    const bool isIncidentPositive = axisIncidentSpace[incidentAxis] < decimal(0.0);
+    const uint incidentFaceIndex = computeFaceIndex(incidentAxis, isIncidentPositive);
+
+    // Compute the four vertices of the incident face (in the local-space of the reference box)
+    const uint k1 = (incidentAxis + 1) % 3;
+    const uint k2 = (incidentAxis + 2) % 3;
+    Vector3 polygon[2][MAX_NB_CLIPPED_VERTICES];
+    uint32 polygonIds[2][MAX_NB_CLIPPED_VERTICES];
+    static const decimal signs1[4] = {1, -1, -1, 1};
+    static const decimal signs2[4] = {1, 1, -1, -1};
+    for (uint v=0; v < 4; v++) {
+        Vector3 vertex;
+        vertex[incidentAxis] = isIncidentPositive ? incidentExtent[incidentAxis] : -incidentExtent[incidentAxis];
+        vertex[k1] = signs1[v] * incidentExtent[k1];
+        vertex[k2] = signs2[v] * incidentExtent[k2];
+        polygon[0][v] = incidentToReference * vertex;
+        polygonIds[0][v] = v;
+    }
+
+    // Clip the incident face against the four side planes of the reference face
+    const uint u1 = (referenceAxis + 1) % 3;
+    const uint u2 = (referenceAxis + 2) % 3;
+    uint nbVertices = 4;
+    uint current = 0;
+    const uint clipAxes[4] = {u1, u1, u2, u2};
+    for (uint p=0; p < 4 && nbVertices > 0; p++) {
+        const decimal sign = (p % 2 == 0) ? decimal(1.0) : decimal(-1.0);
+        nbVertices = clipPolygonWithBoxPlane(polygon[current], polygonIds[current], nbVertices, clipAxes[p], sign,
+                                             referenceExtent[clipAxes[p]], p, polygon[1 - current], polygonIds[1 - current]);
+        current = 1 - current;
+    }
+
+    // Compute the world normal (from box 1 toward box 2)
+    const Vector3 normalWorld = isReferenceBox1 ?
+                                narrowPhaseInfo->shape1ToWorldTransform.getOrientation() * axisReferenceSpace :
+                                -(narrowPhaseInfo->shape2ToWorldTransform.getOrientation() * axisReferenceSpace);
+
+    // We only keep the clipped points that are below the reference face
+    const decimal referenceFaceOffset = referenceExtent[referenceAxis];
+    bool contactPointsFound = false;
+    for (uint i=0; i < nbVertices; i++) {
+
+        const Vector3& clippedVertex = polygon[current][i];
+        const decimal depth = referenceFaceOffset - referenceSign * clippedVertex[referenceAxis];
+
+        if (depth > decimal(0.0)) {
+
+            contactPointsFound = true;
+
+            // Project the contact point onto the reference face
+            Vector3 contactPointReference = clippedVertex;
+            contactPointReference[referenceAxis] = referenceSign * referenceFaceOffset;
+
+            // Convert the clipped vertex into the local-space of the incident box
+            const Vector3 contactPointIncident = referenceToIncident * clippedVertex;
+
+            // Identify the contact point by the reference face, the incident face and the clipped feature
+            const uint32 featureId = combineIdentifiers(combineIdentifiers(combineIdentifiers(
+                                     isReferenceBox1 ? 3 : 4, referenceFaceIndex), incidentFaceIndex), polygonIds[current][i]);
+
+            narrowPhaseInfo->addContactPoint(normalWorld, depth,
+                                             isReferenceBox1 ? contactPointReference : contactPointIncident,
+                                             isReferenceBox1 ? contactPointIncident : contactPointReference,
+                                             featureId != 0 ? featureId : 1);
+        }
+    }
+
+    return contactPointsFound;
+}
+
+// Compute the contact point between the two closest edges of an edge axis
+void BoxVsBoxAlgorithm::computeEdgeContactPoint(const BoxPair& pair, uint axisIndex, decimal penetrationDepth,
+                                                NarrowPhaseInfo* narrowPhaseInfo) const {
+
+    assert(axisIndex >= 6 && axisIndex < NB_BOX_AXES);
+
+    const uint i = (axisIndex - 6) / 3;
+    const uint j = (axisIndex - 6) % 3;
+    const Vector3& a = pair.extent1;
+    const Vector3& b = pair.extent2;
+
+    // Compute the axis in the local-space of box 1 (oriented from box 1 toward box 2)
+    Vector3 edge1Direction(0, 0, 0);
+    edge1Direction[i] = decimal(1.0);
+    Vector3 edge2Direction(0, 0, 0);
+    edge2Direction[j] = decimal(1.0);
+    Vector3 axis = edge1Direction.cross(pair.box2ToBox1.getOrientation() * edge2Direction).getUnit();
+    if (axis.dot(pair.box2ToBox1.getPosition()) < decimal(0.0)) {
+        axis = -axis;
+    }
+    const Vector3 axisBox2 = pair.box1ToBox2.getOrientation() * axis;
+
+    // Find the edge of box 1 that is the furthest along the axis and the edge of box 2 that is
+    // the furthest along the opposite axis
+    Vector3 edge1Center(0, 0, 0);
+    Vector3 edge2Center(0, 0, 0);
+    uint32 edge1Id = i;
+    uint32 edge2Id = j;
+    for (uint k=0; k < 3; k++) {
+        if (k != i) {
+            edge1Center[k] = axis[k] > decimal(0.0) ? a[k] : -a[k];
+            edge1Id = edge1Id * 2 + (axis[k] > decimal(0.0) ? 1 : 0);
+        }
+        if (k != j) {
+            edge2Center[k] = axisBox2[k] > decimal(0.0) ? -b[k] : b[k];
+            edge2Id = edge2Id * 2 + (axisBox2[k] > decimal(0.0) ? 0 : 1);
+        }
+    }
+
+    // Compute the closest points between the two edges (in the local-space of box 1)
+    const Vector3 edge2A = pair.box2ToBox1 * (edge2Center - b[j] * edge2Direction);
+    const Vector3 edge2B = pair.box2ToBox1 * (edge2Center + b[j] * edge2Direction);
+    Vector3 closestPointEdge1, closestPointEdge2;
+    computeClosestPointBetweenTwoSegments(edge1Center - a[i] * edge1Direction, edge1Center + a[i] * edge1Direction,
+                                          edge2A, edge2B, closestPointEdge1, closestPointEdge2);
+
+    const Vector3 normalWorld = narrowPhaseInfo->shape1ToWorldTransform.getOrientation() * axis;
+
+    // Create the contact point (identified by the two edges)
+    const uint32 featureId = combineIdentifiers(combineIdentifiers(2, edge1Id), edge2Id);
+    narrowPhaseInfo->addContactPoint(normalWorld, penetrationDepth, closestPointEdge1,
+                                     pair.box1ToBox2 * closestPointEdge2, featureId != 0 ? featureId : 1);
+}
+
+// Clip a polygon against the plane "sign * p[axis] = extent" and keep the inner part
+/// This is one step of the Sutherland-Hodgman algorithm. The vertices created on the plane are
+/// identified by the plane and by the direction in which the polygon crosses it. The method
+/// returns the number of vertices of the clipped polygon.
+uint BoxVsBoxAlgorithm::clipPolygonWithBoxPlane(const Vector3* vertices, const uint32* verticesIds, uint nbVertices,
+                                                uint axis, decimal sign, decimal extent, uint32 planeId,
+                                                Vector3* outVertices, uint32* outVerticesIds) {
+
+    uint nbOutVertices = 0;
+
+    uint previous = nbVertices - 1;
+    decimal previousDistance = sign * vertices[previous][axis] - extent;
+    for (uint current=0; current < nbVertices; current++) {
+
+        const decimal currentDistance = sign * vertices[current][axis] - extent;
+
+        // If the edge crosses the plane, we add the intersection point
+        if ((previousDistance > decimal(0.0)) != (currentDistance > decimal(0.0))) {
+
+            assert(nbOutVertices < MAX_NB_CLIPPED_VERTICES);
+            const decimal t = previousDistance / (previousDistance - currentDistance);
+            outVertices[nbOutVertices] = vertices[previous] + t * (vertices[current] - vertices[previous]);
+            outVerticesIds[nbOutVertices] = 8 + 2 * planeId + (currentDistance > decimal(0.0) ? 1 : 0);
+            nbOutVertices++;
+        }
+
+        // If the current vertex is inside, we keep it
+        if (currentDistance <= decimal(0.0)) {
+
+            assert(nbOutVertices < MAX_NB_CLIPPED_VERTICES);
+            outVertices[nbOutVertices] = vertices[current];
+            outVerticesIds[nbOutVertices] = verticesIds[current];
+            nbOutVertices++;
+        }
+
+        previous = current;
+        previousDistance = currentDistance;
+    }
+
+    return nbOutVertices;
+}
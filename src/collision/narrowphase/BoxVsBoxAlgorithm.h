@@ -0,0 +1,143 @@
+/********************************************************************************
+* ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
+* Copyright (c) 2010-2018 Daniel Chappuis                                       *
+*********************************************************************************
+*                                                                               *
+* This software is provided 'as-is', without any express or implied warranty.   *
+* In no event will the authors be held liable for any damages arising from the  *
+* use of this software.                                                         *
+*                                                                               *
+* Permission is granted to anyone to use this software for any purpose,         *
+* including commercial applications, and to alter it and redistribute it        *
+* freely, subject to the following restrictions:                                *
+*                                                                               *
+* 1. The origin of this software must not be misrepresented; you must not claim *
+*    that you wrote the original software. If you use this software in a        *
+*    product, an acknowledgment in the product documentation would be           *
+*    appreciated but is not required.                                           *
+*                                                                               *
+* 2. Altered source versions must be plainly marked as such, and must not be    *
+*    misrepresented as being the original software.                             *
+*                                                                               *
+* 3. This notice may not be removed or altered from any source distribution.    *
+*                                                                               *
+********************************************************************************/
+
+#ifndef REACTPHYSICS3D_BOX_VS_BOX_ALGORITHM_H
+#define	REACTPHYSICS3D_BOX_VS_BOX_ALGORITHM_H
+
+// Libraries
+#include "NarrowPhaseAlgorithm.h"
+#include "mathematics/Transform.h"
+#include "mathematics/Matrix3x3.h"
+
+/// Namespace ReactPhysics3D
+namespace reactphysics3d {
+
+// Class BoxVsBoxAlgorithm
+/**
+ * This class is used to compute the narrow-phase collision detection
+ * between two box collision shapes. This is the separating axis test
+ * specialized for boxes: only the 15 possible axes (the 3 face normals of
+ * each box and the 9 cross products of their edge directions) are tested with
+ * the extents of the boxes instead of their half-edge structures. The incident
+ * face is then clipped analytically against the sides of the reference face
+ * with fixed-size arrays of vertices. The temporal coherence information of the
+ * overlapping pair is shared with the generic SAT algorithm (the face indices are
+ * the ones of the BoxShape and the edge indices are the local axes of the edges).
+ */
+class BoxVsBoxAlgorithm : public NarrowPhaseAlgorithm {
+
+    protected :
+
+        // -------------------- Constants -------------------- //
+
+        /// Number of candidate separating axes between two boxes
+        static const uint NB_BOX_AXES = 15;
+
+        /// Maximum number of vertices of the incident face after clipping
+        /// (each of the four side planes of the reference face adds at most one vertex)
+        static const uint MAX_NB_CLIPPED_VERTICES = 8;
+
+        /// Bias used to prefer an axis over the following ones with almost the same penetration depth
+        static const decimal SAME_SEPARATING_AXIS_BIAS;
+
+        /// Square length under which the cross product of two edge directions is not a valid axis
+        static const decimal PARALLEL_EDGES_EPSILON;
+
+        // Structure BoxPair
+        /**
+         * This structure contains the relative configuration of the two boxes
+         * expressed in the local-space of the first box.
+         */
+        struct BoxPair {
+
+            /// Half-extents of the first box
+            Vector3 extent1;
+
+            /// Half-extents of the second box
+            Vector3 extent2;
+
+            /// Transform from the local-space of box 2 to the local-space of box 1
+            Transform box2ToBox1;
+
+            /// Transform from the local-space of box 1 to the local-space of box 2
+            Transform box1ToBox2;
+
+            /// Rotation of box 2 in box 1 (rotation[i][j] is the dot product of the axes i of box 1 and j of box 2)
+            Matrix3x3 rotation;
+
+            /// Absolute values of the rotation coefficients (with a small epsilon for nearly parallel edges)
+            Matrix3x3 absRotation;
+        };
+
+        // -------------------- Methods -------------------- //
+
+        /// Return the penetration depth of the boxes along a candidate axis (negative if the axis separates them)
+        decimal computePenetrationDepth(const BoxPair& pair, uint axisIndex) const;
+
+        /// Compute the contact points of a face axis by clipping the incident face against the reference face
+        bool computeFaceContactPoints(const BoxPair& pair, uint axisIndex, decimal penetrationDepth,
+                                      NarrowPhaseInfo* narrowPhaseInfo, uint& outReferenceFaceIndex) const;
+
+        /// Compute the contact point between the two closest edges of an edge axis
+        void computeEdgeContactPoint(const BoxPair& pair, uint axisIndex, decimal penetrationDepth,
+                                     NarrowPhaseInfo* narrowPhaseInfo) const;
+
+        /// Return the index of the box face with a given local axis and direction
+        static uint computeFaceIndex(uint axis, bool isPositive);
+
+        /// Clip a polygon against the plane "sign * p[axis] = extent" and keep the inner part
+        static uint clipPolygonWithBoxPlane(const Vector3* vertices, const uint32* verticesIds, uint nbVertices,
+                                            uint axis, decimal sign, decimal extent, uint32 planeId,
+                                            Vector3* outVertices, uint32* outVerticesIds);
+
+    public :
+
+        // -------------------- Methods -------------------- //
+
+        /// Constructor
+        BoxVsBoxAlgorithm() = default;
+
+        /// Destructor
+        virtual ~BoxVsBoxAlgorithm() override = default;
+
+        /// Deleted copy-constructor
+        BoxVsBoxAlgorithm(const BoxVsBoxAlgorithm& algorithm) = delete;
+
+        /// Deleted assignment operator
+        BoxVsBoxAlgorithm& operator=(const BoxVsBoxAlgorithm& algorithm) = delete;
+
+        /// Compute the narrow-phase collision detection between two boxes
+        virtual bool testCollision(NarrowPhaseInfo* narrowPhaseInfo, bool reportContacts, MemoryAllocator& memoryAllocator) override;
+};
+
+// Return the index of the box face with a given local axis and direction
+inline uint BoxVsBoxAlgorithm::computeFaceIndex(uint axis, bool isPositive) {
+    static const uint faceIndices[3][2] = {{3, 1}, {4, 5}, {2, 0}};
+    return faceIndices[axis][isPositive ? 1 : 0];
+}
+
+}
+
+#endif
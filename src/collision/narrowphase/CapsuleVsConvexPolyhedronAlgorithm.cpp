@@ -27,10 +27,14 @@
 #include "CapsuleVsConvexPolyhedronAlgorithm.h"
 #include "SAT/SATAlgorithm.h"
 #include "GJK/GJKAlgorithm.h"
+#include "GJK/VoronoiSimplex.h"
+#include "EPA/EPAAlgorithm.h"
 #include "collision/shapes/CapsuleShape.h"
 #include "collision/shapes/ConvexPolyhedronShape.h"
+#include "collision/shapes/BoxShape.h"
 #include "collision/NarrowPhaseInfo.h"
 #include "collision/ContactPointInfo.h"
+#include "utils/Profiler.h"
 #include <cassert>
 
 // We want to use the ReactPhysics3D namespace
@@ -42,8 +46,24 @@ using namespace reactphysics3d;
 bool CapsuleVsConvexPolyhedronAlgorithm::testCollision(NarrowPhaseInfo* narrowPhaseInfo, bool reportContacts,
                                                        MemoryAllocator& memoryAllocator) {
 
+    // The contacts with a box are directly computed if the inner segment of the capsule is outside of it
+    if (narrowPhaseInfo->collisionShape1->getName() == CollisionShapeName::BOX ||
+        narrowPhaseInfo->collisionShape2->getName() == CollisionShapeName::BOX) {
+
+        bool isColliding;
+        if (testCollisionCapsuleVsBox(narrowPhaseInfo, reportContacts, isColliding)) {
+
+            LastFrameCollisionInfo* lastFrameCollisionInfo = narrowPhaseInfo->getLastFrameCollisionInfo();
+            lastFrameCollisionInfo->wasUsingGJK = false;
+            lastFrameCollisionInfo->wasUsingSAT = false;
+
+            return isColliding;
+        }
+    }
+
     // First, we run the GJK algorithm
     GJKAlgorithm gjkAlgorithm;
+    gjkAlgorithm.setIsSimplexWarmStartEnabled(mIsGJKSimplexWarmStartEnabled);
     SATAlgorithm satAlgorithm(memoryAllocator);
 
 #ifdef IS_PROFILING_ACTIVE
@@ -56,10 +76,10 @@ bool CapsuleVsConvexPolyhedronAlgorithm::testCollision(NarrowPhaseInfo* narrowPh
     // Get the last frame collision info
     LastFrameCollisionInfo* lastFrameCollisionInfo = narrowPhaseInfo->getLastFrameCollisionInfo();
 
-    GJKAlgorithm::GJKResult result = gjkAlgorithm.testCollision(narrowPhaseInfo, reportContacts);
+    // Final simplex of the GJK algorithm (used by the EPA algorithm)
+    VoronoiSimplex simplex;
 
-    lastFrameCollisionInfo->wasUsingGJK = true;
-    lastFrameCollisionInfo->wasUsingSAT = false;
+    GJKAlgorithm::GJKResult result = gjkAlgorithm.testCollision(narrowPhaseInfo, reportContacts, simplex);
 
 	assert(narrowPhaseInfo->collisionShape1->getType() == CollisionShapeType::CONVEX_POLYHEDRON ||
 		   narrowPhaseInfo->collisionShape2->getType() == CollisionShapeType::CONVEX_POLYHEDRON);
@@ -135,6 +155,10 @@ bool CapsuleVsConvexPolyhedronAlgorithm::testCollision(NarrowPhaseInfo* narrowPh
                                                               capsuleSegAPolyhedronSpace, capsuleSegBPolyhedronSpace,
                                                               narrowPhaseInfo, isCapsuleShape1);
                     if (!contactsFound) {
+
+                        lastFrameCollisionInfo->wasUsingGJK = true;
+                        lastFrameCollisionInfo->wasUsingSAT = false;
+
                         return false;
                     }
 
@@ -153,7 +177,30 @@ bool CapsuleVsConvexPolyhedronAlgorithm::testCollision(NarrowPhaseInfo* narrowPh
     // If we have overlap even without the margins (deep penetration)
     if (result == GJKAlgorithm::GJKResult::INTERPENETRATE) {
 
-        // Run the SAT algorithm to find the separating axis and compute contact point
+        // Compute the penetration depth with the EPA algorithm if it is enabled (we only
+        // run the SAT algorithm if the polytope of EPA is degenerate)
+        if (mIsEPAEnabled) {
+
+            EPAAlgorithm epaAlgorithm(memoryAllocator);
+
+#ifdef IS_PROFILING_ACTIVE
+
+            epaAlgorithm.setProfiler(mProfiler);
+
+#endif
+
+            if (epaAlgorithm.testCollision(narrowPhaseInfo, simplex, reportContacts)) {
+
+                lastFrameCollisionInfo->wasUsingGJK = true;
+                lastFrameCollisionInfo->wasUsingSAT = false;
+
+                return true;
+            }
+        }
+
+        // Run the SAT algorithm to find the separating axis and compute contact point (the
+        // SAT algorithm starts with the previous separating axis if it was used in the
+        // previous frame)
         bool isColliding = satAlgorithm.testCollisionCapsuleVsConvexPolyhedron(narrowPhaseInfo, reportContacts);
 
         lastFrameCollisionInfo->wasUsingGJK = false;
@@ -162,5 +209,193 @@ bool CapsuleVsConvexPolyhedronAlgorithm::testCollision(NarrowPhaseInfo* narrowPh
         return isColliding;
     }
 
+    lastFrameCollisionInfo->wasUsingGJK = true;
+    lastFrameCollisionInfo->wasUsingSAT = false;
+
     return false;
 }
+
+// Compute the narrow-phase collision detection between a capsule and a box if the inner segment of the capsule does not touch the box
+/// The method returns false if the inner segment of the capsule touches the box. In this case, the
+/// penetration has to be computed by the GJK and SAT algorithms. Otherwise, the contacts are computed
+/// from the closest points between the segment and the box. If the segment is parallel to the
+/// closest face of the box, two contact points are created at the ends of the part of the segment
+/// that is above the face.
+bool CapsuleVsConvexPolyhedronAlgorithm::testCollisionCapsuleVsBox(NarrowPhaseInfo* narrowPhaseInfo, bool reportContacts,
+                                                                   bool& outIsColliding) const {
+
+    RP3D_PROFILE("CapsuleVsConvexPolyhedronAlgorithm::testCollisionCapsuleVsBox()", mProfiler);
+
+    const bool isCapsuleShape1 = narrowPhaseInfo->collisionShape1->getType() == CollisionShapeType::CAPSULE;
+    const CapsuleShape* capsule = static_cast<const CapsuleShape*>(isCapsuleShape1 ? narrowPhaseInfo->collisionShape1 :
+                                                                                     narrowPhaseInfo->collisionShape2);
+    const BoxShape* box = static_cast<const BoxShape*>(isCapsuleShape1 ? narrowPhaseInfo->collisionShape2 :
+                                                                         narrowPhaseInfo->collisionShape1);
+    const Transform& capsuleToWorld = isCapsuleShape1 ? narrowPhaseInfo->shape1ToWorldTransform :
+                                                        narrowPhaseInfo->shape2ToWorldTransform;
+    const Transform& boxToWorld = isCapsuleShape1 ? narrowPhaseInfo->shape2ToWorldTransform :
+                                                    narrowPhaseInfo->shape1ToWorldTransform;
+
+    const decimal radius = capsule->getRadius();
+    const Vector3 extent = box->getExtent();
+
+    // Compute the inner segment of the capsule in the local-space of the box
+    const Transform capsuleToBox = boxToWorld.getInverse() * capsuleToWorld;
+    const Vector3 segmentPointA = capsuleToBox * Vector3(0, -capsule->getHeight() * decimal(0.5), 0);
+    const Vector3 segmentPointB = capsuleToBox * Vector3(0, capsule->getHeight() * decimal(0.5), 0);
+    const Vector3 segmentDirection = segmentPointB - segmentPointA;
+
+    // Compute the point of the segment that is the closest to the box and its closest point on the box
+    const decimal t = computeSegmentParameterClosestToBox(segmentPointA, segmentDirection, extent);
+    const Vector3 segmentPoint = segmentPointA + t * segmentDirection;
+    const Vector3 boxPoint(std::max(-extent.x, std::min(segmentPoint.x, extent.x)),
+                           std::max(-extent.y, std::min(segmentPoint.y, extent.y)),
+                           std::max(-extent.z, std::min(segmentPoint.z, extent.z)));
+    const Vector3 boxToSegment = segmentPoint - boxPoint;
+    const decimal distanceSquare = boxToSegment.lengthSquare();
+
+    // If the inner segment touches the box, we need the GJK and SAT algorithms
+    if (distanceSquare <= MACHINE_EPSILON) return false;
+
+    outIsColliding = distanceSquare < radius * radius;
+    if (!outIsColliding || !reportContacts) return true;
+
+    const Transform boxToCapsule = capsuleToBox.getInverse();
+    const decimal distance = std::sqrt(distanceSquare);
+    const Vector3 normalBoxSpace = boxToSegment / distance;
+
+    // The contact normal goes from the first shape toward the second one
+    const Vector3 normalWorld = isCapsuleShape1 ? -(boxToWorld.getOrientation() * normalBoxSpace) :
+                                                  boxToWorld.getOrientation() * normalBoxSpace;
+
+    // If the closest feature of the box is a face that is parallel to the segment
+    const decimal segmentLengthSquare = segmentDirection.lengthSquare();
+    const int faceAxis = boxToSegment.getAbsoluteVector().getMaxAxis();
+    const bool isFaceFeature = std::abs(boxToSegment[(faceAxis + 1) % 3]) <= MACHINE_EPSILON &&
+                               std::abs(boxToSegment[(faceAxis + 2) % 3]) <= MACHINE_EPSILON;
+    if (isFaceFeature && segmentLengthSquare > MACHINE_EPSILON &&
+        areOrthogonalVectors(normalBoxSpace, segmentDirection / std::sqrt(segmentLengthSquare))) {
+
+        // Clip the segment with the side planes of the face
+        decimal tMin = decimal(0.0);
+        decimal tMax = decimal(1.0);
+        for (int i=1; i < 3; i++) {
+            const int axis = (faceAxis + i) % 3;
+            if (std::abs(segmentDirection[axis]) > MACHINE_EPSILON) {
+                decimal t1 = (-extent[axis] - segmentPointA[axis]) / segmentDirection[axis];
+                decimal t2 = (extent[axis] - segmentPointA[axis]) / segmentDirection[axis];
+                if (t1 > t2) std::swap(t1, t2);
+                tMin = std::max(tMin, t1);
+                tMax = std::min(tMax, t2);
+            }
+        }
+
+        if (tMax - tMin > MACHINE_EPSILON) {
+
+            const decimal faceSign = boxToSegment[faceAxis] > decimal(0.0) ? decimal(1.0) : decimal(-1.0);
+            bool contactsFound = false;
+            const decimal clippedParameters[2] = {tMin, tMax};
+            for (uint i=0; i < 2; i++) {
+
+                const Vector3 clippedPoint = segmentPointA + clippedParameters[i] * segmentDirection;
+                const decimal penetrationDepth = radius - (faceSign * clippedPoint[faceAxis] - extent[faceAxis]);
+                if (penetrationDepth > decimal(0.0)) {
+
+                    Vector3 contactPointBox = clippedPoint;
+                    contactPointBox[faceAxis] = faceSign * extent[faceAxis];
+                    const Vector3 contactPointCapsule = boxToCapsule * (clippedPoint - radius * normalBoxSpace);
+
+                    narrowPhaseInfo->addContactPoint(normalWorld, penetrationDepth,
+                                                     isCapsuleShape1 ? contactPointCapsule : contactPointBox,
+                                                     isCapsuleShape1 ? contactPointBox : contactPointCapsule);
+                    contactsFound = true;
+                }
+            }
+
+            if (contactsFound) return true;
+        }
+    }
+
+    // Create a single contact point between the closest points
+    const Vector3 contactPointCapsule = boxToCapsule * (segmentPoint - radius * normalBoxSpace);
+    narrowPhaseInfo->addContactPoint(normalWorld, radius - distance,
+                                     isCapsuleShape1 ? contactPointCapsule : boxPoint,
+                                     isCapsuleShape1 ? boxPoint : contactPointCapsule);
+
+    return true;
+}
+
+// Return the parameter of the point of a segment that is the closest to a box
+/// The square distance between the point A + t * D of the segment and the box is a convex piecewise
+/// quadratic function of t whose pieces are separated by the parameters where the segment crosses the
+/// planes of the faces of the box. We find the minimum of the quadratic function of each piece.
+decimal CapsuleVsConvexPolyhedronAlgorithm::computeSegmentParameterClosestToBox(const Vector3& segmentPointA,
+                                                                                const Vector3& segmentDirection,
+                                                                                const Vector3& boxExtent) {
+
+    // Compute the sorted parameters where the segment crosses the planes of the faces
+    decimal parameters[8];
+    uint nbParameters = 0;
+    parameters[nbParameters++] = decimal(0.0);
+    for (int axis=0; axis < 3; axis++) {
+        if (std::abs(segmentDirection[axis]) > MACHINE_EPSILON) {
+            for (int sign=-1; sign <= 1; sign += 2) {
+                const decimal t = (sign * boxExtent[axis] - segmentPointA[axis]) / segmentDirection[axis];
+                if (t > decimal(0.0) && t < decimal(1.0)) {
+                    parameters[nbParameters++] = t;
+                }
+            }
+        }
+    }
+    parameters[nbParameters++] = decimal(1.0);
+
+    // Sort the parameters of the planes (at most six) with an insertion sort
+    for (uint i=2; i + 1 < nbParameters; i++) {
+        const decimal parameter = parameters[i];
+        uint j = i;
+        while (j > 1 && parameters[j - 1] > parameter) {
+            parameters[j] = parameters[j - 1];
+            j--;
+        }
+        parameters[j] = parameter;
+    }
+
+    decimal minDistanceSquare = DECIMAL_LARGEST;
+    decimal minParameter = decimal(0.0);
+    for (uint i=0; i + 1 < nbParameters; i++) {
+
+        // Find the planes of the faces that are outside of the point in the middle of the piece
+        const decimal middle = (parameters[i] + parameters[i + 1]) * decimal(0.5);
+        decimal numerator = decimal(0.0);
+        decimal denominator = decimal(0.0);
+        for (int axis=0; axis < 3; axis++) {
+            const decimal coordinate = segmentPointA[axis] + middle * segmentDirection[axis];
+            if (std::abs(coordinate) > boxExtent[axis]) {
+                const decimal plane = coordinate > decimal(0.0) ? boxExtent[axis] : -boxExtent[axis];
+                numerator -= segmentDirection[axis] * (segmentPointA[axis] - plane);
+                denominator += segmentDirection[axis] * segmentDirection[axis];
+            }
+        }
+
+        // Minimize the quadratic function of the piece
+        decimal t = parameters[i];
+        if (denominator > MACHINE_EPSILON) {
+            t = std::max(parameters[i], std::min(numerator / denominator, parameters[i + 1]));
+        }
+
+        // Compute the square distance between the point of the segment and the box
+        decimal distanceSquare = decimal(0.0);
+        for (int axis=0; axis < 3; axis++) {
+            const decimal coordinate = segmentPointA[axis] + t * segmentDirection[axis];
+            const decimal outside = std::abs(coordinate) - boxExtent[axis];
+            if (outside > decimal(0.0)) distanceSquare += outside * outside;
+        }
+
+        if (distanceSquare < minDistanceSquare) {
+            minDistanceSquare = distanceSquare;
+            minParameter = t;
+        }
+    }
+
+    return minParameter;
+}
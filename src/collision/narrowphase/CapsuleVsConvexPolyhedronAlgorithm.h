@@ -28,6 +28,7 @@
 
 // Libraries
 #include "NarrowPhaseAlgorithm.h"
+#include "mathematics/Vector3.h"
 
 /// Namespace ReactPhysics3D
 namespace reactphysics3d {
@@ -47,12 +48,25 @@ class Body;
  * the polyhedron, we run the SAT algorithm to get the contact points and
  * normal.
  * This is based on the "Robust Contact Creation for Physics Simulation"
- * presentation by Dirk Gregorius.
+ * presentation by Dirk Gregorius. When the polyhedron is a box and the inner
+ * segment of the capsule is outside of it, the contacts are directly computed
+ * from the closest points between the segment and the box.
  */
 class CapsuleVsConvexPolyhedronAlgorithm : public NarrowPhaseAlgorithm {
 
     protected :
 
+        // -------------------- Methods -------------------- //
+
+        /// Compute the narrow-phase collision detection between a capsule and a box if the
+        /// inner segment of the capsule does not touch the box
+        bool testCollisionCapsuleVsBox(NarrowPhaseInfo* narrowPhaseInfo, bool reportContacts,
+                                       bool& outIsColliding) const;
+
+        /// Return the parameter of the point of a segment that is the closest to a box
+        static decimal computeSegmentParameterClosestToBox(const Vector3& segmentPointA, const Vector3& segmentDirection,
+                                                           const Vector3& boxExtent);
+
     public :
 
         // -------------------- Methods -------------------- //
@@ -38,6 +38,27 @@ using namespace reactphysics3d;
 bool ConvexPolyhedronVsConvexPolyhedronAlgorithm::testCollision(NarrowPhaseInfo* narrowPhaseInfo, bool reportContacts,
                                                                 MemoryAllocator& memoryAllocator) {
 
+    // Get the last frame collision info
+    LastFrameCollisionInfo* lastFrameCollisionInfo = narrowPhaseInfo->getLastFrameCollisionInfo();
+
+    // The pairs of boxes only need to test the 15 axes of the boxes
+    if (narrowPhaseInfo->collisionShape1->getName() == CollisionShapeName::BOX &&
+        narrowPhaseInfo->collisionShape2->getName() == CollisionShapeName::BOX) {
+
+#ifdef IS_PROFILING_ACTIVE
+
+        mBoxVsBoxAlgorithm.setProfiler(mProfiler);
+
+#endif
+
+        bool isColliding = mBoxVsBoxAlgorithm.testCollision(narrowPhaseInfo, reportContacts, memoryAllocator);
+
+        lastFrameCollisionInfo->wasUsingSAT = true;
+        lastFrameCollisionInfo->wasUsingGJK = false;
+
+        return isColliding;
+    }
+
     // Run the SAT algorithm to find the separating axis and compute contact point
     SATAlgorithm satAlgorithm(memoryAllocator);
 
@@ -47,9 +68,6 @@ bool ConvexPolyhedronVsConvexPolyhedronAlgorithm::testCollision(NarrowPhaseInfo*
 
 #endif
 
-    // Get the last frame collision info
-    LastFrameCollisionInfo* lastFrameCollisionInfo = narrowPhaseInfo->getLastFrameCollisionInfo();
-
     bool isColliding = satAlgorithm.testCollisionConvexPolyhedronVsConvexPolyhedron(narrowPhaseInfo, reportContacts);
 
     lastFrameCollisionInfo->wasUsingSAT = true;
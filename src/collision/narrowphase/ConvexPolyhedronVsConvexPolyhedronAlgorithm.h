@@ -28,6 +28,7 @@
 
 // Libraries
 #include "NarrowPhaseAlgorithm.h"
+#include "BoxVsBoxAlgorithm.h"
 
 /// Namespace ReactPhysics3D
 namespace reactphysics3d {
@@ -42,12 +43,18 @@ class ContactPoint;
  * between two convex polyhedra. Here we do not use the GJK algorithm but
  * we run the SAT algorithm to get the contact points and normal.
  * This is based on the "Robust Contact Creation for Physics Simulation"
- * presentation by Dirk Gregorius.
+ * presentation by Dirk Gregorius. The pairs of boxes are tested with the
+ * specialized BoxVsBoxAlgorithm.
  */
 class ConvexPolyhedronVsConvexPolyhedronAlgorithm : public NarrowPhaseAlgorithm {
 
     protected :
 
+        // -------------------- Attributes -------------------- //
+
+        /// Separating axis test specialized for two boxes
+        BoxVsBoxAlgorithm mBoxVsBoxAlgorithm;
+
     public :
 
         // -------------------- Methods -------------------- //
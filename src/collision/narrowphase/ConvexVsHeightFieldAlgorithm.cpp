@@ -0,0 +1,274 @@
+/********************************************************************************
+* ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
+* Copyright (c) 2010-2018 Daniel Chappuis                                       *
+*********************************************************************************
+*                                                                               *
+* This software is provided 'as-is', without any express or implied warranty.   *
+* In no event will the authors be held liable for any damages arising from the  *
+* use of this software.                                                         *
+*                                                                               *
+* Permission is granted to anyone to use this software for any purpose,         *
+* including commercial applications, and to alter it and redistribute it        *
+* freely, subject to the following restrictions:                                *
+*                                                                               *
+* 1. The origin of this software must not be misrepresented; you must not claim *
+*    that you wrote the original software. If you use this software in a        *
+*    product, an acknowledgment in the product documentation would be           *
+*    appreciated but is not required.                                           *
+*                                                                               *
+* 2. Altered source versions must be plainly marked as such, and must not be    *
+*    misrepresented as being the original software.                             *
+*                                                                               *
+* 3. This notice may not be removed or altered from any source distribution.    *
+*                                                                               *
+********************************************************************************/
+
+// Libraries
+#include "ConvexVsHeightFieldAlgorithm.h"
+#include "collision/NarrowPhaseInfo.h"
+#include "collision/shapes/SphereShape.h"
+#include "collision/shapes/CapsuleShape.h"
+#include "collision/shapes/HeightFieldShape.h"
+#include "collision/shapes/AABB.h"
+
+// We want to use the ReactPhysics3D namespace
+using namespace reactphysics3d;
+
+// Compute the narrow-phase collision detection between a sphere or a capsule and a height field
+/// The sphere is handled as a capsule with a segment of zero length. Only the cells of the grid
+/// that overlap the AABB of the convex shape and whose heights overlap the heights of this AABB
+/// are tested.
+bool ConvexVsHeightFieldAlgorithm::testCollision(NarrowPhaseInfo* narrowPhaseInfo, bool reportContacts,
+                                                 MemoryAllocator& memoryAllocator) {
+
+    const bool isHeightFieldShape1 = narrowPhaseInfo->collisionShape1->getName() == CollisionShapeName::HEIGHTFIELD;
+    const CollisionShape* convexShape = isHeightFieldShape1 ? narrowPhaseInfo->collisionShape2 :
+                                                              narrowPhaseInfo->collisionShape1;
+    const HeightFieldShape* heightFieldShape = static_cast<const HeightFieldShape*>(isHeightFieldShape1 ?
+                                                   narrowPhaseInfo->collisionShape1 : narrowPhaseInfo->collisionShape2);
+    const Transform& heightFieldToWorld = isHeightFieldShape1 ? narrowPhaseInfo->shape1ToWorldTransform :
+                                                                narrowPhaseInfo->shape2ToWorldTransform;
+    const Transform& convexToWorld = isHeightFieldShape1 ? narrowPhaseInfo->shape2ToWorldTransform :
+                                                           narrowPhaseInfo->shape1ToWorldTransform;
+
+    assert(heightFieldShape->getName() == CollisionShapeName::HEIGHTFIELD);
+    assert(convexShape->getType() == CollisionShapeType::SPHERE ||
+           convexShape->getType() == CollisionShapeType::CAPSULE);
+
+    // The contacts are not computed with the GJK or the SAT algorithm
+    LastFrameCollisionInfo* lastFrameCollisionInfo = narrowPhaseInfo->getLastFrameCollisionInfo();
+    lastFrameCollisionInfo->wasUsingGJK = false;
+    lastFrameCollisionInfo->wasUsingSAT = false;
+
+    // Transforms between the local-spaces of the convex shape and of the height field
+    const Transform convexToHeightField = heightFieldToWorld.getInverse() * convexToWorld;
+    const Transform heightFieldToConvex = convexToHeightField.getInverse();
+
+    // Compute the segment (in local-space of the height field) and the radius of the shape
+    Vector3 segmentPointA;
+    Vector3 segmentPointB;
+    decimal radius;
+    const bool isCapsule = convexShape->getType() == CollisionShapeType::CAPSULE;
+    if (isCapsule) {
+        const CapsuleShape* capsuleShape = static_cast<const CapsuleShape*>(convexShape);
+        const decimal halfHeight = capsuleShape->getHeight() * decimal(0.5);
+        segmentPointA = convexToHeightField * Vector3(0, -halfHeight, 0);
+        segmentPointB = convexToHeightField * Vector3(0, halfHeight, 0);
+        radius = capsuleShape->getRadius();
+    }
+    else {
+        segmentPointA = convexToHeightField.getPosition();
+        segmentPointB = segmentPointA;
+        radius = static_cast<const SphereShape*>(convexShape)->getRadius();
+    }
+
+    // Compute the AABB of the shape in local-space of the height field
+    const Vector3 radiusVector(radius, radius, radius);
+    const AABB aabb(Vector3::min(segmentPointA, segmentPointB) - radiusVector,
+                    Vector3::max(segmentPointA, segmentPointB) + radiusVector);
+
+    // Compute the cells of the grid covered by the AABB
+    int iMin, iMax, jMin, jMax;
+    heightFieldShape->computeOverlappingCells(aabb, iMin, iMax, jMin, jMax);
+
+    const int upAxis = heightFieldShape->getUpAxis();
+    const decimal minHeight = aabb.getMin()[upAxis];
+    const decimal maxHeight = aabb.getMax()[upAxis];
+
+    bool isColliding = false;
+
+    for (int i = iMin; i < iMax; i++) {
+        for (int j = jMin; j < jMax; j++) {
+
+            if (heightFieldShape->isCellHole(i, j)) continue;
+
+            Vector3 cellVertices[4];
+            heightFieldShape->getCellVertices(i, j, cellVertices);
+
+            // If the heights of the cell do not overlap the heights of the AABB
+            decimal cellMinHeight = cellVertices[0][upAxis];
+            decimal cellMaxHeight = cellMinHeight;
+            for (int k = 1; k < 4; k++) {
+                cellMinHeight = std::min(cellMinHeight, cellVertices[k][upAxis]);
+                cellMaxHeight = std::max(cellMaxHeight, cellVertices[k][upAxis]);
+            }
+            if (cellMinHeight > maxHeight || cellMaxHeight < minHeight) continue;
+
+            // Test the two triangles of the cell
+            const Vector3 triangle1[3] = {cellVertices[0], cellVertices[1], cellVertices[2]};
+            const Vector3 triangle2[3] = {cellVertices[2], cellVertices[1], cellVertices[3]};
+            for (const Vector3* triangle : {triangle1, triangle2}) {
+
+                if (testTriangle(narrowPhaseInfo, reportContacts, triangle, segmentPointA, segmentPointB,
+                                 radius, isCapsule, upAxis, isHeightFieldShape1, heightFieldToConvex,
+                                 heightFieldToWorld.getOrientation())) {
+
+                    // If we do not need the contacts, the first colliding triangle is enough
+                    if (!reportContacts) return true;
+
+                    isColliding = true;
+                }
+            }
+        }
+    }
+
+    return isColliding;
+}
+
+// Compute the contacts between a segment with a radius and a triangle of the height field
+/// All the points are in local-space of the height field. The end points of the segment are
+/// tested like spheres: if the projection of an end point is inside the triangle, the
+/// penetration depth is measured along the triangle normal, otherwise it is given by the
+/// closest point of the edges of the triangle. For a capsule, the closest points between the
+/// segment and the edges of the triangle are also tested.
+bool ConvexVsHeightFieldAlgorithm::testTriangle(NarrowPhaseInfo* narrowPhaseInfo, bool reportContacts,
+                                                const Vector3* triangleVertices, const Vector3& segmentPointA,
+                                                const Vector3& segmentPointB, decimal radius, bool isCapsule,
+                                                int upAxis, bool isHeightFieldShape1,
+                                                const Transform& heightFieldToConvex,
+                                                const Quaternion& heightFieldToWorld) const {
+
+    const Vector3& a = triangleVertices[0];
+    const Vector3& b = triangleVertices[1];
+    const Vector3& c = triangleVertices[2];
+
+    // Compute the triangle normal oriented toward the up axis of the height field
+    Vector3 normal = (b - a).cross(c - a);
+    if (normal.lengthSquare() < MACHINE_EPSILON) return false;
+    normal.normalize();
+    if (normal[upAxis] < decimal(0.0)) normal = -normal;
+
+    const decimal radiusSquare = radius * radius;
+    const decimal distanceA = (segmentPointA - a).dot(normal);
+    const decimal distanceB = (segmentPointB - a).dot(normal);
+
+    // If the segment goes through the triangle, an end point can be deeper than the radius
+    bool isSegmentThroughTriangle = false;
+    if (isCapsule && distanceA * distanceB < decimal(0.0)) {
+        const Vector3 intersection = segmentPointA + (segmentPointB - segmentPointA) * (distanceA / (distanceA - distanceB));
+        decimal u, v, w;
+        computeBarycentricCoordinatesInTriangle(a, b, c, intersection, u, v, w);
+        isSegmentThroughTriangle = u >= decimal(0.0) && v >= decimal(0.0) && w >= decimal(0.0);
+    }
+
+    bool isColliding = false;
+
+    // For each end point of the segment
+    const Vector3 endPoints[2] = {segmentPointA, segmentPointB};
+    const decimal endPointDistances[2] = {distanceA, distanceB};
+    const int nbEndPoints = isCapsule ? 2 : 1;
+    for (int k = 0; k < nbEndPoints; k++) {
+
+        const Vector3& point = endPoints[k];
+        const decimal distance = endPointDistances[k];
+        if (distance >= radius) continue;
+
+        // If the projection of the point is inside the triangle
+        const Vector3 projectedPoint = point - distance * normal;
+        decimal u, v, w;
+        computeBarycentricCoordinatesInTriangle(a, b, c, projectedPoint, u, v, w);
+        if (u >= decimal(0.0) && v >= decimal(0.0) && w >= decimal(0.0)) {
+
+            if (distance > -radius || isSegmentThroughTriangle) {
+                if (!reportContacts) return true;
+                addContactPoint(narrowPhaseInfo, projectedPoint, normal, radius - distance,
+                                isHeightFieldShape1, heightFieldToConvex, heightFieldToWorld);
+                isColliding = true;
+            }
+
+            continue;
+        }
+
+        // Compute the closest point of the edges of the triangle
+        Vector3 closestPoint;
+        decimal closestDistanceSquare = DECIMAL_LARGEST;
+        for (int e = 0; e < 3; e++) {
+            const Vector3 edgePoint = computeClosestPointOnSegment(triangleVertices[e],
+                                                                   triangleVertices[(e + 1) % 3], point);
+            const decimal distanceSquare = (point - edgePoint).lengthSquare();
+            if (distanceSquare < closestDistanceSquare) {
+                closestDistanceSquare = distanceSquare;
+                closestPoint = edgePoint;
+            }
+        }
+
+        if (closestDistanceSquare < radiusSquare) {
+            if (!reportContacts) return true;
+            addContactPoint(narrowPhaseInfo, closestPoint, normal, radius - std::sqrt(closestDistanceSquare),
+                            isHeightFieldShape1, heightFieldToConvex, heightFieldToWorld);
+            isColliding = true;
+        }
+    }
+
+    if (!isCapsule) return isColliding;
+
+    // For each edge of the triangle
+    for (int e = 0; e < 3; e++) {
+
+        // Compute the closest points between the segment and the edge
+        Vector3 segmentPoint;
+        Vector3 edgePoint;
+        computeClosestPointBetweenTwoSegments(segmentPointA, segmentPointB, triangleVertices[e],
+                                              triangleVertices[(e + 1) % 3], segmentPoint, edgePoint);
+
+        // The end points of the segment have already been tested
+        if ((segmentPoint - segmentPointA).lengthSquare() < MACHINE_EPSILON ||
+            (segmentPoint - segmentPointB).lengthSquare() < MACHINE_EPSILON) {
+            continue;
+        }
+
+        const decimal distanceSquare = (segmentPoint - edgePoint).lengthSquare();
+        if (distanceSquare >= radiusSquare) continue;
+
+        // The penetration depth is larger if the segment is below the plane of the triangle
+        const decimal distance = std::sqrt(distanceSquare);
+        const bool isAbove = (segmentPoint - a).dot(normal) >= decimal(0.0);
+        const decimal penetrationDepth = isAbove ? radius - distance : radius + distance;
+
+        if (!reportContacts) return true;
+        addContactPoint(narrowPhaseInfo, edgePoint, normal, penetrationDepth, isHeightFieldShape1,
+                        heightFieldToConvex, heightFieldToWorld);
+        isColliding = true;
+    }
+
+    return isColliding;
+}
+
+// Add a contact point between the height field and the convex shape
+/// The contact point of the height field and the normal are in local-space of the height field.
+/// The normal goes from the height field toward the convex shape.
+void ConvexVsHeightFieldAlgorithm::addContactPoint(NarrowPhaseInfo* narrowPhaseInfo, const Vector3& heightFieldPoint,
+                                                   const Vector3& normal, decimal penetrationDepth,
+                                                   bool isHeightFieldShape1, const Transform& heightFieldToConvex,
+                                                   const Quaternion& heightFieldToWorld) const {
+
+    const Vector3 convexPoint = heightFieldToConvex * (heightFieldPoint - normal * penetrationDepth);
+    const Vector3 normalWorld = heightFieldToWorld * normal;
+
+    if (isHeightFieldShape1) {
+        narrowPhaseInfo->addContactPoint(normalWorld, penetrationDepth, heightFieldPoint, convexPoint);
+    }
+    else {
+        narrowPhaseInfo->addContactPoint(-normalWorld, penetrationDepth, convexPoint, heightFieldPoint);
+    }
+}
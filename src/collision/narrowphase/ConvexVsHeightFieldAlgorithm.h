@@ -0,0 +1,88 @@
+/********************************************************************************
+* ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
+* Copyright (c) 2010-2018 Daniel Chappuis                                       *
+*********************************************************************************
+*                                                                               *
+* This software is provided 'as-is', without any express or implied warranty.   *
+* In no event will the authors be held liable for any damages arising from the  *
+* use of this software.                                                         *
+*                                                                               *
+* Permission is granted to anyone to use this software for any purpose,         *
+* including commercial applications, and to alter it and redistribute it        *
+* freely, subject to the following restrictions:                                *
+*                                                                               *
+* 1. The origin of this software must not be misrepresented; you must not claim *
+*    that you wrote the original software. If you use this software in a        *
+*    product, an acknowledgment in the product documentation would be           *
+*    appreciated but is not required.                                           *
+*                                                                               *
+* 2. Altered source versions must be plainly marked as such, and must not be    *
+*    misrepresented as being the original software.                             *
+*                                                                               *
+* 3. This notice may not be removed or altered from any source distribution.    *
+*                                                                               *
+********************************************************************************/
+
+#ifndef REACTPHYSICS3D_CONVEX_VS_HEIGHT_FIELD_ALGORITHM_H
+#define	REACTPHYSICS3D_CONVEX_VS_HEIGHT_FIELD_ALGORITHM_H
+
+// Libraries
+#include "NarrowPhaseAlgorithm.h"
+#include "mathematics/mathematics.h"
+
+/// Namespace ReactPhysics3D
+namespace reactphysics3d {
+
+// Declarations
+class HeightFieldShape;
+
+// Class ConvexVsHeightFieldAlgorithm
+/**
+ * This class is used to compute the narrow-phase collision detection between a sphere or a
+ * capsule and a height field. Instead of creating a triangle shape for each triangle of the
+ * height field that overlaps the convex shape, the algorithm directly reads the vertices of
+ * the cells of the grid covered by the shape and computes the closest points between the
+ * sphere (or the segment of the capsule) and the two triangles of each cell. The contact
+ * normal is always the face normal of the triangle oriented toward the up axis of the height
+ * field (the height field is one-sided like its triangles with smooth vertex normals).
+ */
+class ConvexVsHeightFieldAlgorithm : public NarrowPhaseAlgorithm {
+
+    protected :
+
+        // -------------------- Methods -------------------- //
+
+        /// Compute the contacts between a segment with a radius and a triangle of the height field
+        bool testTriangle(NarrowPhaseInfo* narrowPhaseInfo, bool reportContacts, const Vector3* triangleVertices,
+                          const Vector3& segmentPointA, const Vector3& segmentPointB, decimal radius,
+                          bool isCapsule, int upAxis, bool isHeightFieldShape1,
+                          const Transform& heightFieldToConvex, const Quaternion& heightFieldToWorld) const;
+
+        /// Add a contact point between the height field and the convex shape
+        void addContactPoint(NarrowPhaseInfo* narrowPhaseInfo, const Vector3& heightFieldPoint,
+                             const Vector3& normal, decimal penetrationDepth, bool isHeightFieldShape1,
+                             const Transform& heightFieldToConvex, const Quaternion& heightFieldToWorld) const;
+
+    public :
+
+        // -------------------- Methods -------------------- //
+
+        /// Constructor
+        ConvexVsHeightFieldAlgorithm() = default;
+
+        /// Destructor
+        virtual ~ConvexVsHeightFieldAlgorithm() override = default;
+
+        /// Deleted copy-constructor
+        ConvexVsHeightFieldAlgorithm(const ConvexVsHeightFieldAlgorithm& algorithm) = delete;
+
+        /// Deleted assignment operator
+        ConvexVsHeightFieldAlgorithm& operator=(const ConvexVsHeightFieldAlgorithm& algorithm) = delete;
+
+        /// Compute the narrow-phase collision detection between a sphere or a capsule and a height field
+        virtual bool testCollision(NarrowPhaseInfo* narrowPhaseInfo, bool reportContacts, MemoryAllocator& memoryAllocator) override;
+};
+
+}
+
+#endif
@@ -0,0 +1,132 @@
+/********************************************************************************
+* ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
+* Copyright (c) 2010-2018 Daniel Chappuis                                       *
+*********************************************************************************
+*                                                                               *
+* This software is provided 'as-is', without any express or implied warranty.   *
+* In no event will the authors be held liable for any damages arising from the  *
+* use of this software.                                                         *
+*                                                                               *
+* Permission is granted to anyone to use this software for any purpose,         *
+* including commercial applications, and to alter it and redistribute it        *
+* freely, subject to the following restrictions:                                *
+*                                                                               *
+* 1. The origin of this software must not be misrepresented; you must not claim *
+*    that you wrote the original software. If you use this software in a        *
+*    product, an acknowledgment in the product documentation would be           *
+*    appreciated but is not required.                                           *
+*                                                                               *
+* 2. Altered source versions must be plainly marked as such, and must not be    *
+*    misrepresented as being the original software.                             *
+*                                                                               *
+* 3. This notice may not be removed or altered from any source distribution.    *
+*                                                                               *
+********************************************************************************/
+
+// Libraries
+#include "ConvexVsImplicitConvexAlgorithm.h"
+#include "GJK/GJKAlgorithm.h"
+#include "GJK/VoronoiSimplex.h"
+#include "EPA/EPAAlgorithm.h"
+#include "collision/NarrowPhaseInfo.h"
+#include "collision/shapes/ConvexShape.h"
+#include "utils/Profiler.h"
+
+// We want to use the ReactPhysics3D namespace
+using namespace reactphysics3d;
+
+// Compute the narrow-phase collision detection between a convex and an implicit convex shape
+bool ConvexVsImplicitConvexAlgorithm::testCollision(NarrowPhaseInfo* narrowPhaseInfo, bool reportContacts,
+                                                    MemoryAllocator& memoryAllocator) {
+
+    assert(narrowPhaseInfo->collisionShape1->getType() == CollisionShapeType::IMPLICIT_CONVEX ||
+           narrowPhaseInfo->collisionShape2->getType() == CollisionShapeType::IMPLICIT_CONVEX);
+    assert(narrowPhaseInfo->collisionShape1->isConvex() && narrowPhaseInfo->collisionShape2->isConvex());
+
+    // Get the last frame collision info
+    LastFrameCollisionInfo* lastFrameCollisionInfo = narrowPhaseInfo->getLastFrameCollisionInfo();
+
+    // First, we run the GJK algorithm
+    GJKAlgorithm gjkAlgorithm;
+    gjkAlgorithm.setIsSimplexWarmStartEnabled(mIsGJKSimplexWarmStartEnabled);
+
+#ifdef IS_PROFILING_ACTIVE
+
+    gjkAlgorithm.setProfiler(mProfiler);
+
+#endif
+
+    // Final simplex of the GJK algorithm (used by the EPA algorithm)
+    VoronoiSimplex simplex;
+
+    GJKAlgorithm::GJKResult result = gjkAlgorithm.testCollision(narrowPhaseInfo, reportContacts, simplex);
+
+    lastFrameCollisionInfo->wasUsingGJK = true;
+    lastFrameCollisionInfo->wasUsingSAT = false;
+
+    // If we have found a contact point inside the margins (shallow penetration)
+    if (result == GJKAlgorithm::GJKResult::COLLIDE_IN_MARGIN) {
+        return true;
+    }
+
+    // If we have overlap even without the margins (deep penetration)
+    if (result == GJKAlgorithm::GJKResult::INTERPENETRATE) {
+
+        EPAAlgorithm epaAlgorithm(memoryAllocator);
+
+#ifdef IS_PROFILING_ACTIVE
+
+        epaAlgorithm.setProfiler(mProfiler);
+
+#endif
+
+        if (epaAlgorithm.testCollision(narrowPhaseInfo, simplex, reportContacts)) {
+            return true;
+        }
+
+        // The polytope of EPA is degenerate
+        return computeCenterDirectionContact(narrowPhaseInfo, reportContacts);
+    }
+
+    return false;
+}
+
+// Compute a contact along the direction between the origins of the two shapes
+/// This is used when the penetration depth of overlapping shapes cannot be computed by the
+/// EPA algorithm. The penetration depth is the overlap of the support points of the shapes
+/// (with their margins) along the direction from the origin of shape 1 to the origin of shape 2.
+bool ConvexVsImplicitConvexAlgorithm::computeCenterDirectionContact(NarrowPhaseInfo* narrowPhaseInfo,
+                                                                    bool reportContacts) const {
+
+    const ConvexShape* shape1 = static_cast<const ConvexShape*>(narrowPhaseInfo->collisionShape1);
+    const ConvexShape* shape2 = static_cast<const ConvexShape*>(narrowPhaseInfo->collisionShape2);
+    const Transform& transform1 = narrowPhaseInfo->shape1ToWorldTransform;
+    const Transform& transform2 = narrowPhaseInfo->shape2ToWorldTransform;
+
+    // Transform from local space of shape 2 to local space of shape 1
+    const Transform shape2ToShape1 = transform1.getInverse() * transform2;
+
+    // Direction from the origin of shape 1 to the origin of shape 2 (in local space of shape 1)
+    Vector3 normal = shape2ToShape1.getPosition();
+    if (normal.lengthSquare() < MACHINE_EPSILON) {
+        normal.setAllValues(decimal(0.0), decimal(1.0), decimal(0.0));
+    }
+    normal.normalize();
+
+    // Support points of both shapes (with margins) toward each other
+    const Vector3 supportPoint1 = shape1->getLocalSupportPointWithMargin(normal);
+    const Vector3 supportPoint2 = shape2ToShape1 * shape2->getLocalSupportPointWithMargin(
+                                      shape2ToShape1.getOrientation().getInverse() * (-normal));
+
+    const decimal penetrationDepth = (supportPoint1 - supportPoint2).dot(normal);
+    if (penetrationDepth <= decimal(0.0)) return false;
+
+    if (reportContacts) {
+
+        const Vector3 pointShape2 = shape2ToShape1.getInverse() * (supportPoint1 - normal * penetrationDepth);
+        narrowPhaseInfo->addContactPoint(transform1.getOrientation() * normal, penetrationDepth,
+                                         supportPoint1, pointShape2);
+    }
+
+    return true;
+}
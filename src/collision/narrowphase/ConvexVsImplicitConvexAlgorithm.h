@@ -0,0 +1,76 @@
+/********************************************************************************
+* ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
+* Copyright (c) 2010-2018 Daniel Chappuis                                       *
+*********************************************************************************
+*                                                                               *
+* This software is provided 'as-is', without any express or implied warranty.   *
+* In no event will the authors be held liable for any damages arising from the  *
+* use of this software.                                                         *
+*                                                                               *
+* Permission is granted to anyone to use this software for any purpose,         *
+* including commercial applications, and to alter it and redistribute it        *
+* freely, subject to the following restrictions:                                *
+*                                                                               *
+* 1. The origin of this software must not be misrepresented; you must not claim *
+*    that you wrote the original software. If you use this software in a        *
+*    product, an acknowledgment in the product documentation would be           *
+*    appreciated but is not required.                                           *
+*                                                                               *
+* 2. Altered source versions must be plainly marked as such, and must not be    *
+*    misrepresented as being the original software.                             *
+*                                                                               *
+* 3. This notice may not be removed or altered from any source distribution.    *
+*                                                                               *
+********************************************************************************/
+
+#ifndef REACTPHYSICS3D_CONVEX_VS_IMPLICIT_CONVEX_ALGORITHM_H
+#define	REACTPHYSICS3D_CONVEX_VS_IMPLICIT_CONVEX_ALGORITHM_H
+
+// Libraries
+#include "NarrowPhaseAlgorithm.h"
+
+/// Namespace ReactPhysics3D
+namespace reactphysics3d {
+
+// Class ConvexVsImplicitConvexAlgorithm
+/**
+ * This class is used to compute the narrow-phase collision detection between a convex
+ * shape and an implicit convex shape (a convex shape like the cylinder or the cone that is
+ * only defined by its support function). The GJK algorithm computes the contact when the
+ * shapes only overlap in their margins. When the original objects (without margin) overlap,
+ * the penetration depth is always computed with the EPA algorithm because the SAT algorithm
+ * needs the faces of polyhedra. If the polytope of EPA is degenerate, the contact normal is
+ * the direction between the origins of the two shapes.
+ */
+class ConvexVsImplicitConvexAlgorithm : public NarrowPhaseAlgorithm {
+
+    protected :
+
+        // -------------------- Methods -------------------- //
+
+        /// Compute a contact along the direction between the origins of the two shapes
+        bool computeCenterDirectionContact(NarrowPhaseInfo* narrowPhaseInfo, bool reportContacts) const;
+
+    public :
+
+        // -------------------- Methods -------------------- //
+
+        /// Constructor
+        ConvexVsImplicitConvexAlgorithm() = default;
+
+        /// Destructor
+        virtual ~ConvexVsImplicitConvexAlgorithm() override = default;
+
+        /// Deleted copy-constructor
+        ConvexVsImplicitConvexAlgorithm(const ConvexVsImplicitConvexAlgorithm& algorithm) = delete;
+
+        /// Deleted assignment operator
+        ConvexVsImplicitConvexAlgorithm& operator=(const ConvexVsImplicitConvexAlgorithm& algorithm) = delete;
+
+        /// Compute the narrow-phase collision detection between a convex and an implicit convex shape
+        virtual bool testCollision(NarrowPhaseInfo* narrowPhaseInfo, bool reportContacts, MemoryAllocator& memoryAllocator) override;
+};
+
+}
+
+#endif
@@ -64,6 +64,15 @@ NarrowPhaseAlgorithm* DefaultCollisionDispatch::selectAlgorithm(int type1, int t
         shape2Type == CollisionShapeType::CONVEX_POLYHEDRON) {
         return &mConvexPolyhedronVsConvexPolyhedronAlgorithm;
     }
+    // Convex vs Implicit Convex algorithm
+    if (shape2Type == CollisionShapeType::IMPLICIT_CONVEX) {
+        return &mConvexVsImplicitConvexAlgorithm;
+    }
+    // Sphere or Capsule vs Height Field algorithm
+    if ((shape1Type == CollisionShapeType::SPHERE || shape1Type == CollisionShapeType::CAPSULE) &&
+        shape2Type == CollisionShapeType::CONCAVE_SHAPE) {
+        return &mConvexVsHeightFieldAlgorithm;
+    }
 
     return nullptr;
 }
@@ -34,6 +34,8 @@
 #include "CapsuleVsCapsuleAlgorithm.h"
 #include "CapsuleVsConvexPolyhedronAlgorithm.h"
 #include "ConvexPolyhedronVsConvexPolyhedronAlgorithm.h"
+#include "ConvexVsImplicitConvexAlgorithm.h"
+#include "ConvexVsHeightFieldAlgorithm.h"
 
 namespace reactphysics3d {
 
@@ -65,6 +67,12 @@ class DefaultCollisionDispatch : public CollisionDispatch {
         /// Convex Polyhedron vs Convex Polyhedron collision algorithm
         ConvexPolyhedronVsConvexPolyhedronAlgorithm mConvexPolyhedronVsConvexPolyhedronAlgorithm;
 
+        /// Convex vs Implicit Convex (cylinder, cone) collision algorithm
+        ConvexVsImplicitConvexAlgorithm mConvexVsImplicitConvexAlgorithm;
+
+        /// Sphere or Capsule vs Height Field collision algorithm
+        ConvexVsHeightFieldAlgorithm mConvexVsHeightFieldAlgorithm;
+
     public:
 
         /// Constructor
@@ -77,6 +85,12 @@ class DefaultCollisionDispatch : public CollisionDispatch {
         /// use between two types of collision shapes.
         virtual NarrowPhaseAlgorithm* selectAlgorithm(int type1, int type2) override;
 
+        /// Set to true if the algorithms based on GJK compute the deep penetrations with EPA
+        void setIsEPAEnabled(bool isEnabled);
+
+        /// Set to true if the GJK algorithm starts from the final simplex of the previous frame
+        void setIsGJKSimplexWarmStartEnabled(bool isEnabled);
+
 #ifdef IS_PROFILING_ACTIVE
 
 		/// Set the profiler
@@ -86,6 +100,19 @@ class DefaultCollisionDispatch : public CollisionDispatch {
 
 };
 
+// Set to true if the algorithms based on GJK compute the deep penetrations with EPA
+inline void DefaultCollisionDispatch::setIsEPAEnabled(bool isEnabled) {
+    mSphereVsConvexPolyhedronAlgorithm.setIsEPAEnabled(isEnabled);
+    mCapsuleVsConvexPolyhedronAlgorithm.setIsEPAEnabled(isEnabled);
+}
+
+// Set to true if the GJK algorithm starts from the final simplex of the previous frame
+inline void DefaultCollisionDispatch::setIsGJKSimplexWarmStartEnabled(bool isEnabled) {
+    mSphereVsConvexPolyhedronAlgorithm.setIsGJKSimplexWarmStartEnabled(isEnabled);
+    mCapsuleVsConvexPolyhedronAlgorithm.setIsGJKSimplexWarmStartEnabled(isEnabled);
+    mConvexVsImplicitConvexAlgorithm.setIsGJKSimplexWarmStartEnabled(isEnabled);
+}
+
 #ifdef IS_PROFILING_ACTIVE
 
 // Set the profiler
@@ -99,6 +126,8 @@ inline void DefaultCollisionDispatch::setProfiler(Profiler* profiler) {
 	mSphereVsConvexPolyhedronAlgorithm.setProfiler(profiler);
 	mCapsuleVsConvexPolyhedronAlgorithm.setProfiler(profiler);
 	mConvexPolyhedronVsConvexPolyhedronAlgorithm.setProfiler(profiler);
+	mConvexVsImplicitConvexAlgorithm.setProfiler(profiler);
+	mConvexVsHeightFieldAlgorithm.setProfiler(profiler);
 }
 
 #endif
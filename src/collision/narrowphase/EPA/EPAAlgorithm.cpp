@@ -0,0 +1,391 @@
+/********************************************************************************
+* ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
+* Copyright (c) 2010-2018 Daniel Chappuis                                       *
+*********************************************************************************
+*                                                                               *
+* This software is provided 'as-is', without any express or implied warranty.   *
+* In no event will the authors be held liable for any damages arising from the  *
+* use of this software.                                                         *
+*                                                                               *
+* Permission is granted to anyone to use this software for any purpose,         *
+* including commercial applications, and to alter it and redistribute it        *
+* freely, subject to the following restrictions:                                *
+*                                                                               *
+* 1. The origin of this software must not be misrepresented; you must not claim *
+*    that you wrote the original software. If you use this software in a        *
+*    product, an acknowledgment in the product documentation would be           *
+*    appreciated but is not required.                                           *
+*                                                                               *
+* 2. Altered source versions must be plainly marked as such, and must not be    *
+*    misrepresented as being the original software.                             *
+*                                                                               *
+* 3. This notice may not be removed or altered from any source distribution.    *
+*                                                                               *
+********************************************************************************/
+
+// Libraries
+#include "EPAAlgorithm.h"
+#include "collision/narrowphase/GJK/VoronoiSimplex.h"
+#include "collision/shapes/ConvexShape.h"
+#include "collision/shapes/TriangleShape.h"
+#include "collision/NarrowPhaseInfo.h"
+#include "utils/Profiler.h"
+#include <cassert>
+#include <algorithm>
+
+// We want to use the ReactPhysics3D namespace
+using namespace reactphysics3d;
+
+// Initialization of static variables
+const uint EPAAlgorithm::MAX_ITERATIONS = 64;
+const decimal EPAAlgorithm::DISTANCE_TOLERANCE = decimal(0.0001);
+
+// Constructor
+EPAAlgorithm::EPAAlgorithm(MemoryAllocator& memoryAllocator) : mMemoryAllocator(memoryAllocator) {
+
+#ifdef IS_PROFILING_ACTIVE
+    mProfiler = nullptr;
+#endif
+
+}
+
+// Compute the support point of the Minkowski difference (A-B) in a direction
+/// The support points of both shapes (without margin) are returned in the local-space
+/// of the first shape.
+void EPAAlgorithm::computeSupportPoint(const ConvexShape* shape1, const ConvexShape* shape2,
+                                       const Transform& shape2ToShape1, const Quaternion& rotateToShape2,
+                                       const Vector3& direction, Vector3& outSupportPointA,
+                                       Vector3& outSupportPointB) {
+
+    outSupportPointA = shape1->getLocalSupportPointWithoutMargin(direction);
+    outSupportPointB = shape2ToShape1 * shape2->getLocalSupportPointWithoutMargin(rotateToShape2 * (-direction));
+}
+
+// Complete the vertices of the simplex of the GJK algorithm into a tetrahedron
+/// The GJK algorithm can stop with a simplex of one, two or three vertices when the origin is
+/// on it. In this case, we add the support points of the Minkowski difference in directions
+/// orthogonal to the simplex. This method returns false if the Minkowski difference is flat.
+bool EPAAlgorithm::completeTetrahedron(const ConvexShape* shape1, const ConvexShape* shape2,
+                                       const Transform& shape2ToShape1, const Quaternion& rotateToShape2,
+                                       List<Vector3>& supportPointsA, List<Vector3>& supportPointsB) {
+
+    const decimal toleranceSquare = DISTANCE_TOLERANCE * DISTANCE_TOLERANCE;
+    Vector3 supportPointA, supportPointB;
+
+    // If the simplex is a single point, we add the support point in the first direction of
+    // the axes that gives another point
+    if (supportPointsA.size() == 1) {
+
+        const Vector3 w0 = supportPointsA[0] - supportPointsB[0];
+        const Vector3 directions[6] = {Vector3(1, 0, 0), Vector3(-1, 0, 0), Vector3(0, 1, 0),
+                                       Vector3(0, -1, 0), Vector3(0, 0, 1), Vector3(0, 0, -1)};
+        for (uint i=0; i < 6; i++) {
+            computeSupportPoint(shape1, shape2, shape2ToShape1, rotateToShape2, directions[i], supportPointA, supportPointB);
+            if ((supportPointA - supportPointB - w0).lengthSquare() > toleranceSquare) {
+                supportPointsA.add(supportPointA);
+                supportPointsB.add(supportPointB);
+                break;
+            }
+        }
+
+        if (supportPointsA.size() == 1) return false;
+    }
+
+    // If the simplex is a segment, we add the support point in a direction orthogonal to the
+    // segment that gives a point outside of the line of the segment
+    if (supportPointsA.size() == 2) {
+
+        const Vector3 w0 = supportPointsA[0] - supportPointsB[0];
+        const Vector3 segment = supportPointsA[1] - supportPointsB[1] - w0;
+        const Vector3 orthogonal1 = segment.getOneUnitOrthogonalVector();
+        const Vector3 orthogonal2 = segment.cross(orthogonal1).getUnit();
+        const Vector3 directions[4] = {orthogonal1, -orthogonal1, orthogonal2, -orthogonal2};
+        const decimal segmentLengthSquare = segment.lengthSquare();
+        for (uint i=0; i < 4; i++) {
+            computeSupportPoint(shape1, shape2, shape2ToShape1, rotateToShape2, directions[i], supportPointA, supportPointB);
+            const Vector3 w = supportPointA - supportPointB;
+            if ((w - w0).cross(segment).lengthSquare() > toleranceSquare * segmentLengthSquare) {
+                supportPointsA.add(supportPointA);
+                supportPointsB.add(supportPointB);
+                break;
+            }
+        }
+
+        if (supportPointsA.size() == 2) return false;
+    }
+
+    // If the simplex is a triangle, we add the support point on the side of the triangle
+    // where the Minkowski difference is the farthest from its plane
+    if (supportPointsA.size() == 3) {
+
+        const Vector3 w0 = supportPointsA[0] - supportPointsB[0];
+        const Vector3 w1 = supportPointsA[1] - supportPointsB[1];
+        const Vector3 w2 = supportPointsA[2] - supportPointsB[2];
+        Vector3 normal = (w1 - w0).cross(w2 - w0);
+        if (normal.lengthSquare() < MACHINE_EPSILON) return false;
+        normal.normalize();
+
+        Vector3 supportPointA2, supportPointB2;
+        computeSupportPoint(shape1, shape2, shape2ToShape1, rotateToShape2, normal, supportPointA, supportPointB);
+        computeSupportPoint(shape1, shape2, shape2ToShape1, rotateToShape2, -normal, supportPointA2, supportPointB2);
+        const decimal distance1 = normal.dot(supportPointA - supportPointB - w0);
+        const decimal distance2 = -normal.dot(supportPointA2 - supportPointB2 - w0);
+        if (distance1 < distance2) {
+            supportPointA = supportPointA2;
+            supportPointB = supportPointB2;
+        }
+        if (std::max(distance1, distance2) <= DISTANCE_TOLERANCE) return false;
+
+        supportPointsA.add(supportPointA);
+        supportPointsB.add(supportPointB);
+    }
+
+    return true;
+}
+
+// Add a face to the polytope and return false if the face is degenerate
+bool EPAAlgorithm::addFace(uint vertex1, uint vertex2, uint vertex3, const List<Vector3>& supportPointsA,
+                           const List<Vector3>& supportPointsB, List<PolytopeFace>& faces) {
+
+    const Vector3 w1 = supportPointsA[vertex1] - supportPointsB[vertex1];
+    const Vector3 w2 = supportPointsA[vertex2] - supportPointsB[vertex2];
+    const Vector3 w3 = supportPointsA[vertex3] - supportPointsB[vertex3];
+
+    PolytopeFace face;
+    face.vertices[0] = vertex1;
+    face.vertices[1] = vertex2;
+    face.vertices[2] = vertex3;
+    face.normal = (w2 - w1).cross(w3 - w1);
+    if (face.normal.lengthSquare() < MACHINE_EPSILON * MACHINE_EPSILON) return false;
+    face.normal.normalize();
+    face.distance = face.normal.dot(w1);
+
+    faces.add(face);
+
+    return true;
+}
+
+// Compute the penetration depth and the contact point of two overlapping convex shapes
+/// The simplex is the final simplex of the GJK algorithm run on the original objects
+/// (without margin) when it has found that they overlap. The penetration depth is computed
+/// on the original objects and the margins are then added to it.
+/**
+ * @param shape1 The first convex shape
+ * @param shape1ToWorldTransform Local-space to world-space transform of the first shape
+ * @param shape2 The second convex shape
+ * @param shape2ToWorldTransform Local-space to world-space transform of the second shape
+ * @param simplex Final simplex of the GJK algorithm (in local-space of the first shape)
+ * @param[out] outPointShape1 Contact point on the first shape (in local-space of the first shape)
+ * @param[out] outPointShape2 Contact point on the second shape (in local-space of the second shape)
+ * @param[out] outNormal Unit contact normal from the first shape to the second one (in world-space)
+ * @param[out] outPenetrationDepth Penetration depth of the shapes (with their margins)
+ * @return True if the penetration depth has been computed and false if the polytope is degenerate
+ */
+bool EPAAlgorithm::computePenetrationDepth(const ConvexShape* shape1, const Transform& shape1ToWorldTransform,
+                                           const ConvexShape* shape2, const Transform& shape2ToWorldTransform,
+                                           const VoronoiSimplex& simplex, Vector3& outPointShape1,
+                                           Vector3& outPointShape2, Vector3& outNormal,
+                                           decimal& outPenetrationDepth) const {
+
+    RP3D_PROFILE("EPAAlgorithm::computePenetrationDepth()", mProfiler);
+
+    // Transform from local space of shape 2 to local space of shape 1 (the EPA
+    // algorithm is done in local space of shape 1 like the GJK algorithm)
+    const Transform shape2ToShape1 = shape1ToWorldTransform.getInverse() * shape2ToWorldTransform;
+
+    // Quaternion that transform a direction from local space of shape 1 into local space of shape 2
+    const Quaternion rotateToShape2 = shape2ToWorldTransform.getOrientation().getInverse() *
+                                      shape1ToWorldTransform.getOrientation();
+
+    // Get the vertices of the simplex
+    Vector3 simplexPointsA[4], simplexPointsB[4], simplexPoints[4];
+    const int nbSimplexPoints = simplex.getSimplex(simplexPointsA, simplexPointsB, simplexPoints);
+    if (nbSimplexPoints == 0) return false;
+
+    // Vertices of the polytope (support points of both shapes in local-space of shape 1)
+    List<Vector3> supportPointsA(mMemoryAllocator, MAX_ITERATIONS + 4);
+    List<Vector3> supportPointsB(mMemoryAllocator, MAX_ITERATIONS + 4);
+    for (int i=0; i < nbSimplexPoints; i++) {
+        supportPointsA.add(simplexPointsA[i]);
+        supportPointsB.add(simplexPointsB[i]);
+    }
+
+    // Complete the simplex into a tetrahedron
+    if (!completeTetrahedron(shape1, shape2, shape2ToShape1, rotateToShape2, supportPointsA, supportPointsB)) {
+        return false;
+    }
+
+    // Make sure that the tetrahedron has a positive orientation so that the normals of its faces
+    // point toward its outside
+    const Vector3 w0 = supportPointsA[0] - supportPointsB[0];
+    const decimal volume = (supportPointsA[1] - supportPointsB[1] - w0).dot(
+                (supportPointsA[2] - supportPointsB[2] - w0).cross(supportPointsA[3] - supportPointsB[3] - w0));
+    if (std::abs(volume) < MACHINE_EPSILON) return false;
+    const uint v1 = volume > decimal(0.0) ? 1 : 2;
+    const uint v2 = volume > decimal(0.0) ? 2 : 1;
+
+    // Create the faces of the tetrahedron
+    List<PolytopeFace> faces(mMemoryAllocator, 2 * MAX_ITERATIONS + 4);
+    if (!addFace(0, v2, v1, supportPointsA, supportPointsB, faces) ||
+        !addFace(0, v1, 3, supportPointsA, supportPointsB, faces) ||
+        !addFace(0, 3, v2, supportPointsA, supportPointsB, faces) ||
+        !addFace(v1, v2, 3, supportPointsA, supportPointsB, faces)) {
+        return false;
+    }
+
+    List<PolytopeEdge> horizonEdges(mMemoryAllocator, 16);
+    PolytopeFace closestFace = faces[0];
+
+    for (uint iteration = 0; iteration < MAX_ITERATIONS; iteration++) {
+
+        // Find the face of the polytope that is closest to the origin
+        uint closestFaceIndex = 0;
+        for (uint f=1; f < faces.size(); f++) {
+            if (faces[f].distance < faces[closestFaceIndex].distance) {
+                closestFaceIndex = f;
+            }
+        }
+        closestFace = faces[closestFaceIndex];
+
+        // Compute the support point of the Minkowski difference in the direction of the face normal
+        Vector3 supportPointA, supportPointB;
+        computeSupportPoint(shape1, shape2, shape2ToShape1, rotateToShape2, closestFace.normal,
+                            supportPointA, supportPointB);
+        const Vector3 w = supportPointA - supportPointB;
+
+        // If the face is on the boundary of the Minkowski difference, we have found the
+        // penetration depth
+        if (closestFace.normal.dot(w) - closestFace.distance <= DISTANCE_TOLERANCE) {
+            break;
+        }
+
+        // Add the new vertex to the polytope
+        const uint newVertex = supportPointsA.size();
+        supportPointsA.add(supportPointA);
+        supportPointsB.add(supportPointB);
+
+        // Remove the faces that are visible from the new vertex and compute the edges of the
+        // horizon (the edges of only one removed face)
+        horizonEdges.clear();
+        for (uint f=0; f < faces.size();) {
+
+            const PolytopeFace& face = faces[f];
+            const Vector3 faceVertex = supportPointsA[face.vertices[0]] - supportPointsB[face.vertices[0]];
+            if (face.normal.dot(w - faceVertex) <= decimal(0.0)) {
+                f++;
+                continue;
+            }
+
+            for (uint e=0; e < 3; e++) {
+
+                PolytopeEdge edge;
+                edge.vertex1 = face.vertices[e];
+                edge.vertex2 = face.vertices[(e + 1) % 3];
+
+                // If the twin edge belongs to another removed face, the edge is not on the horizon
+                bool isTwinEdgeFound = false;
+                for (uint h=0; h < horizonEdges.size(); h++) {
+                    if (horizonEdges[h].vertex1 == edge.vertex2 && horizonEdges[h].vertex2 == edge.vertex1) {
+                        horizonEdges.removeAt(h);
+                        isTwinEdgeFound = true;
+                        break;
+                    }
+                }
+                if (!isTwinEdgeFound) {
+                    horizonEdges.add(edge);
+                }
+            }
+
+            faces.removeAt(f);
+        }
+
+        // Create the faces between the horizon and the new vertex
+        bool isDegenerate = false;
+        for (uint h=0; h < horizonEdges.size(); h++) {
+            if (!addFace(horizonEdges[h].vertex1, horizonEdges[h].vertex2, newVertex,
+                         supportPointsA, supportPointsB, faces)) {
+                isDegenerate = true;
+            }
+        }
+
+        // If the polytope cannot be expanded anymore, we keep the last closest face
+        if (isDegenerate || faces.size() == 0) {
+            break;
+        }
+    }
+
+    // Compute the barycentric coordinates of the projection of the origin on the closest face
+    const uint* vertices = closestFace.vertices;
+    const Vector3 a = supportPointsA[vertices[0]] - supportPointsB[vertices[0]];
+    const Vector3 b = supportPointsA[vertices[1]] - supportPointsB[vertices[1]];
+    const Vector3 c = supportPointsA[vertices[2]] - supportPointsB[vertices[2]];
+    const Vector3 projectedOrigin = closestFace.normal * closestFace.distance;
+    const Vector3 ab = b - a;
+    const Vector3 ac = c - a;
+    const Vector3 ap = projectedOrigin - a;
+    const decimal d00 = ab.dot(ab);
+    const decimal d01 = ab.dot(ac);
+    const decimal d11 = ac.dot(ac);
+    const decimal d20 = ap.dot(ab);
+    const decimal d21 = ap.dot(ac);
+    const decimal denominator = d00 * d11 - d01 * d01;
+    decimal u = decimal(1.0) / decimal(3.0);
+    decimal v = u;
+    if (std::abs(denominator) > MACHINE_EPSILON) {
+        u = (d11 * d20 - d01 * d21) / denominator;
+        v = (d00 * d21 - d01 * d20) / denominator;
+    }
+    const decimal t = decimal(1.0) - u - v;
+
+    // Compute the closest points of both original objects (in local-space of shape 1)
+    const Vector3 pointA = t * supportPointsA[vertices[0]] + u * supportPointsA[vertices[1]] +
+                           v * supportPointsA[vertices[2]];
+    const Vector3 pointB = t * supportPointsB[vertices[0]] + u * supportPointsB[vertices[1]] +
+                           v * supportPointsB[vertices[2]];
+
+    // Add the margins of the shapes (the normal points from shape 1 toward shape 2)
+    const Vector3& normal = closestFace.normal;
+    outPenetrationDepth = closestFace.distance + shape1->getMargin() + shape2->getMargin();
+    if (outPenetrationDepth <= decimal(0.0)) return false;
+
+    outPointShape1 = pointA + normal * shape1->getMargin();
+    outPointShape2 = shape2ToShape1.getInverse() * (pointB - normal * shape2->getMargin());
+    outNormal = shape1ToWorldTransform.getOrientation() * normal;
+
+    return true;
+}
+
+// Compute the contact point of the shapes of a narrow-phase info from the final GJK simplex
+/// This method returns false if the penetration depth cannot be computed with EPA, in which
+/// case the narrow-phase algorithm has to use another method (the SAT algorithm).
+bool EPAAlgorithm::testCollision(NarrowPhaseInfo* narrowPhaseInfo, const VoronoiSimplex& simplex,
+                                 bool reportContacts) const {
+
+    assert(narrowPhaseInfo->collisionShape1->isConvex());
+    assert(narrowPhaseInfo->collisionShape2->isConvex());
+
+    const ConvexShape* shape1 = static_cast<const ConvexShape*>(narrowPhaseInfo->collisionShape1);
+    const ConvexShape* shape2 = static_cast<const ConvexShape*>(narrowPhaseInfo->collisionShape2);
+
+    Vector3 pointShape1, pointShape2, normal;
+    decimal penetrationDepth;
+    if (!computePenetrationDepth(shape1, narrowPhaseInfo->shape1ToWorldTransform, shape2,
+                                 narrowPhaseInfo->shape2ToWorldTransform, simplex, pointShape1,
+                                 pointShape2, normal, penetrationDepth)) {
+        return false;
+    }
+
+    if (reportContacts) {
+
+        // Compute smooth triangle mesh contact if one of the two collision shapes is a triangle
+        TriangleShape::computeSmoothTriangleMeshContact(shape1, shape2, pointShape1, pointShape2,
+                                                        narrowPhaseInfo->shape1ToWorldTransform,
+                                                        narrowPhaseInfo->shape2ToWorldTransform,
+                                                        penetrationDepth, normal);
+
+        // Add a new contact point
+        narrowPhaseInfo->addContactPoint(normal, penetrationDepth, pointShape1, pointShape2);
+    }
+
+    return true;
+}
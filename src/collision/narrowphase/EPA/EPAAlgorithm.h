@@ -0,0 +1,177 @@
+/********************************************************************************
+* ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
+* Copyright (c) 2010-2018 Daniel Chappuis                                       *
+*********************************************************************************
+*                                                                               *
+* This software is provided 'as-is', without any express or implied warranty.   *
+* In no event will the authors be held liable for any damages arising from the  *
+* use of this software.                                                         *
+*                                                                               *
+* Permission is granted to anyone to use this software for any purpose,         *
+* including commercial applications, and to alter it and redistribute it        *
+* freely, subject to the following restrictions:                                *
+*                                                                               *
+* 1. The origin of this software must not be misrepresented; you must not claim *
+*    that you wrote the original software. If you use this software in a        *
+*    product, an acknowledgment in the product documentation would be           *
+*    appreciated but is not required.                                           *
+*                                                                               *
+* 2. Altered source versions must be plainly marked as such, and must not be    *
+*    misrepresented as being the original software.                             *
+*                                                                               *
+* 3. This notice may not be removed or altered from any source distribution.    *
+*                                                                               *
+********************************************************************************/
+
+#ifndef REACTPHYSICS3D_EPA_ALGORITHM_H
+#define REACTPHYSICS3D_EPA_ALGORITHM_H
+
+// Libraries
+#include "decimal.h"
+#include "mathematics/mathematics.h"
+#include "containers/List.h"
+
+/// ReactPhysics3D namespace
+namespace reactphysics3d {
+
+// Declarations
+struct NarrowPhaseInfo;
+class ConvexShape;
+class VoronoiSimplex;
+class MemoryAllocator;
+class Profiler;
+
+// Class EPAAlgorithm
+/**
+ * This class implements the Expanding Polytope Algorithm (EPA) that computes the penetration
+ * depth and the contact points of two convex shapes whose original objects (without margin)
+ * overlap. It starts from the final simplex of the GJK algorithm (that contains the origin),
+ * completes it into a tetrahedron and iteratively expands the polytope of the Minkowski
+ * difference (A-B) of the shapes in the direction of its face that is closest to the origin
+ * until this face is on the boundary of the Minkowski difference. This implementation is based
+ * on the book "Collision Detection in Interactive 3D Environments" by Gino van den Bergen.
+ *
+ * The algorithm only needs the support functions of the shapes. Therefore, it works with any
+ * pair of convex shapes. The polytope is stored in lists allocated with the memory allocator
+ * of the narrow-phase.
+ */
+class EPAAlgorithm {
+
+    private :
+
+        // Structure PolytopeFace
+        /**
+         * A triangular face of the polytope. Its vertices are in counter-clockwise order
+         * when the face is seen from the outside of the polytope.
+         */
+        struct PolytopeFace {
+
+            /// Indices of the three vertices of the face
+            uint vertices[3];
+
+            /// Unit outward normal of the face
+            Vector3 normal;
+
+            /// Distance from the origin to the plane of the face
+            decimal distance;
+        };
+
+        // Structure PolytopeEdge
+        /**
+         * An edge of the horizon of the polytope seen from a new vertex
+         */
+        struct PolytopeEdge {
+
+            /// Index of the first vertex of the edge
+            uint vertex1;
+
+            /// Index of the second vertex of the edge
+            uint vertex2;
+        };
+
+        // -------------------- Constants -------------------- //
+
+        /// Maximum number of iterations of the expansion of the polytope
+        static const uint MAX_ITERATIONS;
+
+        /// Distance under which the closest face of the polytope is on the boundary
+        /// of the Minkowski difference
+        static const decimal DISTANCE_TOLERANCE;
+
+        // -------------------- Attributes -------------------- //
+
+        /// Memory allocator of the polytope
+        MemoryAllocator& mMemoryAllocator;
+
+#ifdef IS_PROFILING_ACTIVE
+
+        /// Pointer to the profiler
+        Profiler* mProfiler;
+
+#endif
+
+        // -------------------- Methods -------------------- //
+
+        /// Compute the support point of the Minkowski difference (A-B) in a direction
+        static void computeSupportPoint(const ConvexShape* shape1, const ConvexShape* shape2,
+                                        const Transform& shape2ToShape1, const Quaternion& rotateToShape2,
+                                        const Vector3& direction, Vector3& outSupportPointA,
+                                        Vector3& outSupportPointB);
+
+        /// Complete the vertices of the simplex of the GJK algorithm into a tetrahedron
+        static bool completeTetrahedron(const ConvexShape* shape1, const ConvexShape* shape2,
+                                        const Transform& shape2ToShape1, const Quaternion& rotateToShape2,
+                                        List<Vector3>& supportPointsA, List<Vector3>& supportPointsB);
+
+        /// Add a face to the polytope and return false if the face is degenerate
+        static bool addFace(uint vertex1, uint vertex2, uint vertex3, const List<Vector3>& supportPointsA,
+                            const List<Vector3>& supportPointsB, List<PolytopeFace>& faces);
+
+    public :
+
+        // -------------------- Methods -------------------- //
+
+        /// Constructor
+        EPAAlgorithm(MemoryAllocator& memoryAllocator);
+
+        /// Destructor
+        ~EPAAlgorithm() = default;
+
+        /// Deleted copy-constructor
+        EPAAlgorithm(const EPAAlgorithm& algorithm) = delete;
+
+        /// Deleted assignment operator
+        EPAAlgorithm& operator=(const EPAAlgorithm& algorithm) = delete;
+
+        /// Compute the penetration depth and the contact point of two overlapping convex shapes
+        bool computePenetrationDepth(const ConvexShape* shape1, const Transform& shape1ToWorldTransform,
+                                     const ConvexShape* shape2, const Transform& shape2ToWorldTransform,
+                                     const VoronoiSimplex& simplex, Vector3& outPointShape1,
+                                     Vector3& outPointShape2, Vector3& outNormal,
+                                     decimal& outPenetrationDepth) const;
+
+        /// Compute the contact point of the shapes of a narrow-phase info from the final GJK simplex
+        bool testCollision(NarrowPhaseInfo* narrowPhaseInfo, const VoronoiSimplex& simplex,
+                           bool reportContacts) const;
+
+#ifdef IS_PROFILING_ACTIVE
+
+        /// Set the profiler
+        void setProfiler(Profiler* profiler);
+
+#endif
+
+};
+
+#ifdef IS_PROFILING_ACTIVE
+
+// Set the profiler
+inline void EPAAlgorithm::setProfiler(Profiler* profiler) {
+    mProfiler = profiler;
+}
+
+#endif
+
+}
+
+#endif
@@ -41,15 +41,44 @@ using namespace reactphysics3d;
 /// This method implements the Hybrid Technique for computing the penetration depth by
 /// running the GJK algorithm on original objects (without margin). If the shapes intersect
 /// only in the margins, the method compute the penetration depth and contact points
-/// (of enlarged objects). If the original objects (without margin) intersect, we
-/// call the computePenetrationDepthForEnlargedObjects() method that run the GJK
-/// algorithm on the enlarged object to obtain a simplex polytope that contains the
-/// origin, they we give that simplex polytope to the EPA algorithm which will compute
-/// the correct penetration depth and contact points between the enlarged objects.
+/// (of enlarged objects). If the original objects (without margin) intersect, the
+/// method returns GJKResult::INTERPENETRATE and the narrow-phase algorithm computes
+/// the penetration depth with the SAT algorithm or with the EPA algorithm.
 GJKAlgorithm::GJKResult GJKAlgorithm::testCollision(NarrowPhaseInfo* narrowPhaseInfo, bool reportContacts) {
 
+    // Create a simplex set
+    VoronoiSimplex simplex;
+
+    return testCollision(narrowPhaseInfo, reportContacts, simplex);
+}
+
+// Compute a contact info if the two bounding volumes collide and keep the final simplex
+/// The simplex has to be empty. When the original objects (without margin) intersect, the
+/// final simplex contains the origin and can be given to the EPA algorithm.
+GJKAlgorithm::GJKResult GJKAlgorithm::testCollision(NarrowPhaseInfo* narrowPhaseInfo, bool reportContacts,
+                                                    VoronoiSimplex& simplex) {
+
     RP3D_PROFILE("GJKAlgorithm::testCollision()", mProfiler);
-    
+
+    uint nbIterations = 0;
+    const GJKResult result = computeCollision(narrowPhaseInfo, reportContacts, simplex, nbIterations);
+
+    narrowPhaseInfo->nbGJKTests++;
+    narrowPhaseInfo->nbGJKIterations += nbIterations;
+
+    // Cache the final simplex for the next query of the pair
+    if (mIsSimplexWarmStartEnabled) {
+        cacheSimplex(narrowPhaseInfo, simplex);
+    }
+
+    return result;
+}
+
+// Run the GJK algorithm on the original objects (without margin) of a narrow-phase info
+/// The number of iterations of the algorithm is added to "nbIterations".
+GJKAlgorithm::GJKResult GJKAlgorithm::computeCollision(NarrowPhaseInfo* narrowPhaseInfo, bool reportContacts,
+                                                       VoronoiSimplex& simplex, uint& nbIterations) {
+
     Vector3 suppA;             // Support point of object A
     Vector3 suppB;             // Support point of object B
     Vector3 w;                 // Support point of Minkowski difference A-B
@@ -83,8 +112,7 @@ GJKAlgorithm::GJKResult GJKAlgorithm::testCollision(NarrowPhaseInfo* narrowPhase
     decimal marginSquare = margin * margin;
     assert(margin > decimal(0.0));
 
-    // Create a simplex set
-    VoronoiSimplex simplex;
+    assert(simplex.isEmpty());
 
     // Get the last collision frame info
     LastFrameCollisionInfo* lastFrameCollisionInfo = narrowPhaseInfo->getLastFrameCollisionInfo();
@@ -101,12 +129,30 @@ GJKAlgorithm::GJKResult GJKAlgorithm::testCollision(NarrowPhaseInfo* narrowPhase
 
     // Initialize the upper bound for the square distance
     decimal distSquare = DECIMAL_LARGEST;
-    
+
+    // Start from the final simplex of the previous query of the pair
+    if (mIsSimplexWarmStartEnabled && lastFrameCollisionInfo->isValid && lastFrameCollisionInfo->wasUsingGJK &&
+        startFromCachedSimplex(lastFrameCollisionInfo, body2Tobody1, simplex, v)) {
+
+        narrowPhaseInfo->nbGJKWarmStarts++;
+        distSquare = v.lengthSquare();
+
+        // If the origin is inside the simplex, the original objects intersect
+        if (simplex.isFull() || distSquare <= MACHINE_EPSILON * simplex.getMaxLengthSquareOfAPoint()) {
+            return GJKResult::INTERPENETRATE;
+        }
+    }
+
     do {
-              
+
+        nbIterations++;
+
         // Compute the support points for original objects (without margins) A and B
-        suppA = shape1->getLocalSupportPointWithoutMargin(-v);
-        suppB = body2Tobody1 * shape2->getLocalSupportPointWithoutMargin(rotateToBody2 * v);
+        // (the search of the support vertices of the convex meshes starts from the
+        // support vertices of the previous query of the pair)
+        suppA = shape1->getLocalSupportPointWithoutMarginFromVertex(-v, lastFrameCollisionInfo->gjkSupportVertex1);
+        suppB = body2Tobody1 * shape2->getLocalSupportPointWithoutMarginFromVertex(rotateToBody2 * v,
+                                                                                   lastFrameCollisionInfo->gjkSupportVertex2);
 
         // Compute the support point for the Minkowski difference A-B
         w = suppA - suppB;
@@ -211,3 +257,271 @@ GJKAlgorithm::GJKResult GJKAlgorithm::testCollision(NarrowPhaseInfo* narrowPhase
 
     return GJKResult::INTERPENETRATE;
 }
+
+// Add the cached points of the final simplex of the previous query into the simplex
+/// The cached points of the two shapes are moved with the current transforms of the shapes.
+/// They are points of the current Minkowski difference of the shapes and are therefore a
+/// valid starting simplex. The points that make the simplex affinely dependent are skipped.
+/// This method returns false if the simplex cannot be used (it is then left empty).
+bool GJKAlgorithm::startFromCachedSimplex(const LastFrameCollisionInfo* lastFrameCollisionInfo,
+                                          const Transform& body2ToBody1, VoronoiSimplex& simplex,
+                                          Vector3& v) const {
+
+    assert(simplex.isEmpty());
+
+    for (uint i=0; i < lastFrameCollisionInfo->gjkNbSimplexPoints; i++) {
+
+        const Vector3& suppA = lastFrameCollisionInfo->gjkSimplexPointsShape1[i];
+        const Vector3 suppB = body2ToBody1 * lastFrameCollisionInfo->gjkSimplexPointsShape2[i];
+        const Vector3 w = suppA - suppB;
+
+        if (simplex.isPointInSimplex(w)) continue;
+
+        simplex.addPoint(w, suppA, suppB);
+        if (simplex.isAffinelyDependent()) {
+            simplex.removePoint(simplex.getNbPoints() - 1);
+        }
+    }
+
+    if (simplex.isEmpty()) return false;
+
+    // Compute the point of the simplex closest to the origin
+    if (!simplex.computeClosestPoint(v)) {
+        while (!simplex.isEmpty()) {
+            simplex.removePoint(simplex.getNbPoints() - 1);
+        }
+        v = lastFrameCollisionInfo->gjkSeparatingAxis;
+        return false;
+    }
+
+    return true;
+}
+
+// Cache the points of the final simplex for the next query of the pair
+void GJKAlgorithm::cacheSimplex(NarrowPhaseInfo* narrowPhaseInfo, const VoronoiSimplex& simplex) const {
+
+    LastFrameCollisionInfo* lastFrameCollisionInfo = narrowPhaseInfo->getLastFrameCollisionInfo();
+
+    Vector3 suppPointsA[4];
+    Vector3 suppPointsB[4];
+    Vector3 points[4];
+    const int nbPoints = simplex.getSimplex(suppPointsA, suppPointsB, points);
+
+    // The points of the second shape are stored in local-space of the second shape
+    const Transform body1ToBody2 = narrowPhaseInfo->shape2ToWorldTransform.getInverse() *
+                                   narrowPhaseInfo->shape1ToWorldTransform;
+    for (int i=0; i < nbPoints; i++) {
+        lastFrameCollisionInfo->gjkSimplexPointsShape1[i] = suppPointsA[i];
+        lastFrameCollisionInfo->gjkSimplexPointsShape2[i] = body1ToBody2 * suppPointsB[i];
+    }
+    lastFrameCollisionInfo->gjkNbSimplexPoints = nbPoints;
+}
+
+// Compute the closest points of two convex shapes that do not deeply overlap
+/// The GJK algorithm is run on the original objects (without margin) until the distance
+/// between them has converged. The closest points are then projected on the margins of
+/// the shapes. If the shapes only overlap in their margins, the returned distance is
+/// negative. This method returns false if the original objects (without margin) overlap.
+/**
+ * @param shape1 The first convex shape
+ * @param shape1ToWorldTransform Local-space to world-space transform of the first shape
+ * @param shape2 The second convex shape
+ * @param shape2ToWorldTransform Local-space to world-space transform of the second shape
+ * @param[out] outPointShape1 Closest point on the first shape (in local-space of the first shape)
+ * @param[out] outPointShape2 Closest point on the second shape (in local-space of the second shape)
+ * @param[out] outNormal Unit direction from the first shape to the second one (in world-space)
+ * @param[out] outDistance Distance between the two shapes (with their margins)
+ * @return True if the closest points have been computed
+ */
+bool GJKAlgorithm::computeClosestPoints(const ConvexShape* shape1, const Transform& shape1ToWorldTransform,
+                                        const ConvexShape* shape2, const Transform& shape2ToWorldTransform,
+                                        Vector3& outPointShape1, Vector3& outPointShape2,
+                                        Vector3& outNormal, decimal& outDistance) const {
+
+    RP3D_PROFILE("GJKAlgorithm::computeClosestPoints()", mProfiler);
+
+    // Transform from local space of shape 2 to local space of shape 1 (the GJK
+    // algorithm is done in local space of shape 1)
+    const Transform shape2ToShape1 = shape1ToWorldTransform.getInverse() * shape2ToWorldTransform;
+
+    // Quaternion that transform a direction from local space of shape 1 into local space of shape 2
+    const Quaternion rotateToShape2 = shape2ToWorldTransform.getOrientation().getInverse() *
+                                      shape1ToWorldTransform.getOrientation();
+
+    const decimal margin = shape1->getMargin() + shape2->getMargin();
+
+    VoronoiSimplex simplex;
+
+    // Start with the direction between the origins of the two shapes
+    Vector3 v = -shape2ToShape1.getPosition();
+    if (v.lengthSquare() < MACHINE_EPSILON) {
+        v.setAllValues(0, 1, 0);
+    }
+
+    decimal distSquare = DECIMAL_LARGEST;
+    bool isDistanceFound = false;
+
+    do {
+
+        // Compute the support point of the Minkowski difference A-B (without margins)
+        const Vector3 suppA = shape1->getLocalSupportPointWithoutMargin(-v);
+        const Vector3 suppB = shape2ToShape1 * shape2->getLocalSupportPointWithoutMargin(rotateToShape2 * v);
+        const Vector3 w = suppA - suppB;
+
+        // If the support point does not improve the distance anymore
+        const decimal vDotw = v.dot(w);
+        if (simplex.isPointInSimplex(w) || distSquare - vDotw <= distSquare * REL_ERROR_SQUARE) {
+            isDistanceFound = true;
+            break;
+        }
+
+        simplex.addPoint(w, suppA, suppB);
+
+        if (simplex.isAffinelyDependent() || !simplex.computeClosestPoint(v)) {
+            isDistanceFound = true;
+            break;
+        }
+
+        const decimal prevDistSquare = distSquare;
+        distSquare = v.lengthSquare();
+
+        if (prevDistSquare - distSquare <= MACHINE_EPSILON * prevDistSquare) {
+            simplex.backupClosestPointInSimplex(v);
+            distSquare = v.lengthSquare();
+            isDistanceFound = true;
+            break;
+        }
+
+    } while(!simplex.isFull() && distSquare > MACHINE_EPSILON * simplex.getMaxLengthSquareOfAPoint());
+
+    // If the original objects (without margins) overlap
+    if (!isDistanceFound || distSquare <= MACHINE_EPSILON) {
+        return false;
+    }
+
+    // Compute the closest points of both objects (without margins) and project them on the margins
+    Vector3 pA;
+    Vector3 pB;
+    simplex.computeClosestPointsOfAandB(pA, pB);
+    const decimal dist = std::sqrt(distSquare);
+    outPointShape1 = pA - (shape1->getMargin() / dist) * v;
+    outPointShape2 = shape2ToShape1.getInverse() * (pB + (shape2->getMargin() / dist) * v);
+    outNormal = shape1ToWorldTransform.getOrientation() * (-v / dist);
+    outDistance = dist - margin;
+
+    return true;
+}
+
+// Compute the time of impact of two convex shapes moving between two transforms
+/// This method implements the conservative advancement algorithm described in the
+/// thesis "Impulse-based Dynamic Simulation of Rigid Body Systems" by Brian Mirtich.
+/// At each iteration, the closest points of the shapes are computed with the GJK algorithm
+/// at the current fraction of the motion. The fraction is then advanced by the distance
+/// between the shapes divided by an upper bound of their approaching displacement along
+/// the normal during the whole motion. Because this bound is conservative, the shapes
+/// never overlap before the returned time of impact. If the shapes already overlap at
+/// the beginning of the motion, the fraction is zero and the normal is the zero vector.
+/**
+ * @param shape1 The first convex shape
+ * @param shape1StartTransform Local-to-world transform of the first shape at the beginning of the motion
+ * @param shape1EndTransform Local-to-world transform of the first shape at the end of the motion
+ * @param shape2 The second convex shape
+ * @param shape2StartTransform Local-to-world transform of the second shape at the beginning of the motion
+ * @param shape2EndTransform Local-to-world transform of the second shape at the end of the motion
+ * @param[out] outFraction Fraction of the motion (in [0, 1]) when the shapes start touching
+ * @param[out] outNormal Normal of the contact from the first shape toward the second one (in world-space)
+ * @return True if the shapes touch during the motion
+ */
+bool GJKAlgorithm::computeTimeOfImpact(const ConvexShape* shape1, const Transform& shape1StartTransform,
+                                       const Transform& shape1EndTransform, const ConvexShape* shape2,
+                                       const Transform& shape2StartTransform, const Transform& shape2EndTransform,
+                                       decimal& outFraction, Vector3& outNormal) const {
+
+    RP3D_PROFILE("GJKAlgorithm::computeTimeOfImpact()", mProfiler);
+
+    // Relative linear displacement of the first shape toward the second one during the motion
+    const Vector3 linearDisplacement = (shape1EndTransform.getPosition() - shape1StartTransform.getPosition()) -
+                                       (shape2EndTransform.getPosition() - shape2StartTransform.getPosition());
+
+    // Upper bound of the displacement of the points of the shapes because of their rotations
+    const decimal angularDisplacement =
+            computeMaxRotationDisplacement(shape1, shape1StartTransform.getOrientation(), shape1EndTransform.getOrientation()) +
+            computeMaxRotationDisplacement(shape2, shape2StartTransform.getOrientation(), shape2EndTransform.getOrientation());
+
+    decimal fraction = decimal(0.0);
+    Vector3 normal(0, 0, 0);
+
+    for (int i=0; i < MAX_ITERATIONS_GJK_SWEEP; i++) {
+
+        const Transform transform1 = Transform::interpolateTransforms(shape1StartTransform, shape1EndTransform, fraction);
+        const Transform transform2 = Transform::interpolateTransforms(shape2StartTransform, shape2EndTransform, fraction);
+
+        // Compute the distance between the shapes at the current fraction of the motion
+        Vector3 pointShape1;
+        Vector3 pointShape2;
+        Vector3 currentNormal;
+        decimal distance;
+        if (!computeClosestPoints(shape1, transform1, shape2, transform2, pointShape1, pointShape2,
+                                  currentNormal, distance)) {
+
+            // The shapes overlap (this can only happen at the beginning of the motion
+            // or because of numerical errors)
+            outFraction = fraction;
+            outNormal = normal;
+            return true;
+        }
+
+        normal = currentNormal;
+
+        // If the shapes are touching
+        if (distance <= SWEEP_DISTANCE_TOLERANCE) {
+            outFraction = fraction;
+            outNormal = normal;
+            return true;
+        }
+
+        // If the shapes cannot get closer along the normal, they never touch
+        const decimal maxApproachingDisplacement = linearDisplacement.dot(normal) + angularDisplacement;
+        if (maxApproachingDisplacement <= MACHINE_EPSILON) {
+            return false;
+        }
+
+        // Advance the fraction of the motion without making the shapes overlap
+        fraction += distance / maxApproachingDisplacement;
+        if (fraction > decimal(1.0)) {
+            return false;
+        }
+    }
+
+    // The shapes are very close but the algorithm has not converged. We report the
+    // last fraction that is still safe.
+    outFraction = fraction;
+    outNormal = normal;
+    return true;
+}
+
+// Return an upper bound of the distance traveled by a point of a shape during a rotation
+/**
+ * @param shape The convex shape
+ * @param startOrientation Orientation of the shape at the beginning of the rotation
+ * @param endOrientation Orientation of the shape at the end of the rotation
+ * @return The largest distance traveled by a point of the shape during the rotation
+ */
+decimal GJKAlgorithm::computeMaxRotationDisplacement(const ConvexShape* shape, const Quaternion& startOrientation,
+                                                     const Quaternion& endOrientation) {
+
+    // Compute the angle of the rotation between the two orientations
+    const Quaternion rotation = endOrientation * startOrientation.getInverse();
+    const decimal cosHalfAngle = std::min(std::abs(rotation.w), decimal(1.0));
+    const decimal angle = decimal(2.0) * std::acos(cosHalfAngle);
+
+    // Compute the largest distance between a point of the shape and the origin of the shape
+    Vector3 min;
+    Vector3 max;
+    shape->getLocalBounds(min, max);
+    const Vector3 farthestCorner(std::max(std::abs(min.x), std::abs(max.x)),
+                                 std::max(std::abs(min.y), std::abs(max.y)),
+                                 std::max(std::abs(min.z), std::abs(max.z)));
+
+    return angle * farthestCorner.length();
+}
@@ -28,12 +28,14 @@
 
 // Libraries
 #include "decimal.h"
+#include "mathematics/mathematics.h"
 
 /// ReactPhysics3D namespace
 namespace reactphysics3d {
 
 // Declarations
 class ContactManifoldInfo;
+struct LastFrameCollisionInfo;
 struct NarrowPhaseInfo;
 class ConvexShape;
 class Profiler;
@@ -43,6 +45,8 @@ class VoronoiSimplex;
 constexpr decimal REL_ERROR = decimal(1.0e-3);
 constexpr decimal REL_ERROR_SQUARE = REL_ERROR * REL_ERROR;
 constexpr int MAX_ITERATIONS_GJK_RAYCAST = 32;
+constexpr int MAX_ITERATIONS_GJK_SWEEP = 32;
+constexpr decimal SWEEP_DISTANCE_TOLERANCE = decimal(0.001);
 
 // Class GJKAlgorithm
 /**
@@ -59,10 +63,21 @@ constexpr int MAX_ITERATIONS_GJK_RAYCAST = 32;
  */
 class GJKAlgorithm {
 
+    public :
+
+        enum class GJKResult {
+            SEPARATED,              // The two shapes are separated outside the margin
+            COLLIDE_IN_MARGIN,      // The two shapes overlap only in the margin (shallow penetration)
+            INTERPENETRATE          // The two shapes overlap event without the margin (deep penetration)
+        };
+
     private :
 
         // -------------------- Attributes -------------------- //
 
+        /// True if a query starts from the cached final simplex of the previous query of the pair
+        bool mIsSimplexWarmStartEnabled = false;
+
 #ifdef IS_PROFILING_ACTIVE
 
 		/// Pointer to the profiler
@@ -72,13 +87,22 @@ class GJKAlgorithm {
 
         // -------------------- Methods -------------------- //
 
-    public :
+        /// Run the GJK algorithm on the original objects (without margin) of a narrow-phase info
+        GJKResult computeCollision(NarrowPhaseInfo* narrowPhaseInfo, bool reportContacts,
+                                   VoronoiSimplex& simplex, uint& nbIterations);
 
-        enum class GJKResult {
-            SEPARATED,              // The two shapes are separated outside the margin
-            COLLIDE_IN_MARGIN,      // The two shapes overlap only in the margin (shallow penetration)
-            INTERPENETRATE          // The two shapes overlap event without the margin (deep penetration)
-        };
+        /// Add the cached points of the final simplex of the previous query into the simplex
+        bool startFromCachedSimplex(const LastFrameCollisionInfo* lastFrameCollisionInfo,
+                                    const Transform& body2ToBody1, VoronoiSimplex& simplex, Vector3& v) const;
+
+        /// Cache the points of the final simplex for the next query of the pair
+        void cacheSimplex(NarrowPhaseInfo* narrowPhaseInfo, const VoronoiSimplex& simplex) const;
+
+        /// Return an upper bound of the distance traveled by a point of a shape during a rotation
+        static decimal computeMaxRotationDisplacement(const ConvexShape* shape, const Quaternion& startOrientation,
+                                                      const Quaternion& endOrientation);
+
+    public :
 
         // -------------------- Methods -------------------- //
 
@@ -94,9 +118,31 @@ class GJKAlgorithm {
         /// Deleted assignment operator
         GJKAlgorithm& operator=(const GJKAlgorithm& algorithm) = delete;
 
+        /// Set to true if a query starts from the cached final simplex of the previous query of the pair
+        void setIsSimplexWarmStartEnabled(bool isEnabled);
+
         /// Compute a contact info if the two bounding volumes collide.
         GJKResult testCollision(NarrowPhaseInfo* narrowPhaseInfo, bool reportContacts);
 
+        /// Compute a contact info if the two bounding volumes collide and keep the final simplex
+        GJKResult testCollision(NarrowPhaseInfo* narrowPhaseInfo, bool reportContacts, VoronoiSimplex& simplex);
+
+        /// Compute the closest points of two convex shapes that do not deeply overlap
+        bool computeClosestPoints(const ConvexShape* shape1, const Transform& shape1ToWorldTransform,
+                                  const ConvexShape* shape2, const Transform& shape2ToWorldTransform,
+                                  Vector3& outPointShape1, Vector3& outPointShape2, Vector3& outNormal,
+                                  decimal& outDistance) const;
+
+        /// Return true if two convex shapes overlap
+        bool testOverlap(const ConvexShape* shape1, const Transform& shape1ToWorldTransform,
+                         const ConvexShape* shape2, const Transform& shape2ToWorldTransform) const;
+
+        /// Compute the time of impact of two convex shapes moving between two transforms
+        bool computeTimeOfImpact(const ConvexShape* shape1, const Transform& shape1StartTransform,
+                                 const Transform& shape1EndTransform, const ConvexShape* shape2,
+                                 const Transform& shape2StartTransform, const Transform& shape2EndTransform,
+                                 decimal& outFraction, Vector3& outNormal) const;
+
 #ifdef IS_PROFILING_ACTIVE
 
 		/// Set the profiler
@@ -106,6 +152,26 @@ class GJKAlgorithm {
 
 };
 
+// Return true if two convex shapes overlap
+/// The shapes overlap if the closest points cannot be computed (the shapes without
+/// margins overlap) or if the distance between the shapes with their margins is not positive.
+inline bool GJKAlgorithm::testOverlap(const ConvexShape* shape1, const Transform& shape1ToWorldTransform,
+                                      const ConvexShape* shape2, const Transform& shape2ToWorldTransform) const {
+
+    Vector3 pointShape1;
+    Vector3 pointShape2;
+    Vector3 normal;
+    decimal distance;
+    return !computeClosestPoints(shape1, shape1ToWorldTransform, shape2, shape2ToWorldTransform,
+                                 pointShape1, pointShape2, normal, distance) || distance <= decimal(0.0);
+}
+
+// Set to true if a query starts from the cached final simplex of the previous query of the pair
+/// The final simplex of each query is then cached in the last frame collision info of the pair.
+inline void GJKAlgorithm::setIsSimplexWarmStartEnabled(bool isEnabled) {
+    mIsSimplexWarmStartEnabled = isEnabled;
+}
+
 #ifdef IS_PROFILING_ACTIVE
 
 // Set the profiler
@@ -139,6 +139,9 @@ class VoronoiSimplex {
         /// Return true if the simplex is empty
         bool isEmpty() const;
 
+        /// Return the number of points of the simplex
+        int getNbPoints() const;
+
         /// Return the points of the simplex
         int getSimplex(Vector3* mSuppPointsA, Vector3* mSuppPointsB, Vector3* mPoints) const;
 
@@ -180,6 +183,11 @@ inline bool VoronoiSimplex::isEmpty() const {
     return mNbPoints == 0;
 }
 
+// Return the number of points of the simplex
+inline int VoronoiSimplex::getNbPoints() const {
+    return mNbPoints;
+}
+
 // Set the barycentric coordinates of the closest point
 inline void VoronoiSimplex::setBarycentricCoords(decimal a, decimal b, decimal c, decimal d) {
     mBarycentricCoords[0] = a;
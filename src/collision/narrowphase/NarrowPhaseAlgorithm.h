@@ -27,6 +27,7 @@
 #define REACTPHYSICS3D_NARROW_PHASE_ALGORITHM_H
 
 // Libraries
+#include "configuration.h"
 
 /// Namespace ReactPhysics3D
 namespace reactphysics3d {
@@ -68,8 +69,19 @@ class NarrowPhaseAlgorithm {
 
     protected :
 
+        // -------------------- Constants -------------------- //
+
+        /// Number of pairs of shapes tested together by the batch kernels of the algorithms
+        static const uint NB_NARROW_PHASE_LANES = 4;
+
         // -------------------- Attributes -------------------- //
 
+        /// True if the algorithms based on GJK compute the deep penetrations with EPA
+        bool mIsEPAEnabled = false;
+
+        /// True if the GJK algorithm starts from the final simplex of the previous frame
+        bool mIsGJKSimplexWarmStartEnabled = false;
+
 #ifdef IS_PROFILING_ACTIVE
 
 		/// Pointer to the profiler
@@ -97,6 +109,17 @@ class NarrowPhaseAlgorithm {
         virtual bool testCollision(NarrowPhaseInfo* narrowPhaseInfo, bool reportContacts,
                                    MemoryAllocator& memoryAllocator)=0;
 
+        /// Set to true if the algorithms based on GJK compute the deep penetrations with EPA
+        void setIsEPAEnabled(bool isEnabled);
+
+        /// Set to true if the GJK algorithm starts from the final simplex of the previous frame
+        void setIsGJKSimplexWarmStartEnabled(bool isEnabled);
+
+        /// Compute the contact infos of a batch of narrow-phase infos with the same shape types
+        virtual void testCollisionBatch(NarrowPhaseInfo** narrowPhaseInfos, bool* isColliding,
+                                        uint nbNarrowPhaseInfos, bool reportContacts,
+                                        MemoryAllocator& memoryAllocator);
+
 #ifdef IS_PROFILING_ACTIVE
 
 		/// Set the profiler
@@ -106,6 +129,30 @@ class NarrowPhaseAlgorithm {
 
 };
 
+// Set to true if the algorithms based on GJK compute the deep penetrations with EPA
+/// The algorithms that do not use GJK ignore this value.
+inline void NarrowPhaseAlgorithm::setIsEPAEnabled(bool isEnabled) {
+    mIsEPAEnabled = isEnabled;
+}
+
+// Set to true if the GJK algorithm starts from the final simplex of the previous frame
+/// The algorithms that do not use GJK ignore this value.
+inline void NarrowPhaseAlgorithm::setIsGJKSimplexWarmStartEnabled(bool isEnabled) {
+    mIsGJKSimplexWarmStartEnabled = isEnabled;
+}
+
+// Compute the contact infos of a batch of narrow-phase infos with the same shape types
+/// The result of the narrow-phase info at index i of the batch is stored at index i of
+/// the "isColliding" array. The algorithms override this method to test the whole batch
+/// without a virtual call per narrow-phase info.
+inline void NarrowPhaseAlgorithm::testCollisionBatch(NarrowPhaseInfo** narrowPhaseInfos, bool* isColliding,
+                                                     uint nbNarrowPhaseInfos, bool reportContacts,
+                                                     MemoryAllocator& memoryAllocator) {
+    for (uint i=0; i < nbNarrowPhaseInfos; i++) {
+        isColliding[i] = testCollision(narrowPhaseInfos[i], reportContacts, memoryAllocator);
+    }
+}
+
 #ifdef IS_PROFILING_ACTIVE
 
 // Set the profiler
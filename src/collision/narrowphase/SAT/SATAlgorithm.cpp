@@ -51,6 +51,25 @@ SATAlgorithm::SATAlgorithm(MemoryAllocator& memoryAllocator) : mMemoryAllocator(
 
 }
 
+// Compute the identifier of a contact point from the features that generated it
+/// The identifier is never zero because a zero identifier means that the contact point
+/// has to be matched with the persistent contact points using the distance between them.
+/// This is also what we do with triangles because all the triangles of a mesh share the
+/// same contact manifolds but have the same face and edge indices.
+uint32 SATAlgorithm::computeContactFeatureId(const NarrowPhaseInfo* narrowPhaseInfo, uint32 contactType,
+                                             uint32 featureIndex1, uint32 featureIndex2, uint32 featureIndex3) {
+
+    if (narrowPhaseInfo->collisionShape1->getName() == CollisionShapeName::TRIANGLE ||
+        narrowPhaseInfo->collisionShape2->getName() == CollisionShapeName::TRIANGLE) {
+        return 0;
+    }
+
+    uint32 featureId = combineIdentifiers(combineIdentifiers(combineIdentifiers(contactType, featureIndex1),
+                                                             featureIndex2), featureIndex3);
+
+    return featureId != 0 ? featureId : 1;
+}
+
 // Test collision between a sphere and a convex mesh
 bool SATAlgorithm::testCollisionSphereVsConvexPolyhedron(NarrowPhaseInfo* narrowPhaseInfo, bool reportContacts) const {
 
@@ -176,9 +195,119 @@ bool SATAlgorithm::testCollisionCapsuleVsConvexPolyhedron(NarrowPhaseInfo* narro
     Vector3 separatingAxisCapsuleSpace;
     Vector3 separatingPolyhedronEdgeVertex1;
     Vector3 separatingPolyhedronEdgeVertex2;
+    uint minSeparatingEdgeIndex = 0;
+    bool isPreviousAxisUsed = false;
+
+    LastFrameCollisionInfo* lastFrameCollisionInfo = narrowPhaseInfo->getLastFrameCollisionInfo();
+    lastFrameCollisionInfo->satWasPreviousAxisUsed = false;
+
+    // If the last frame collision info is valid and was also using SAT algorithm
+    if (lastFrameCollisionInfo->isValid && lastFrameCollisionInfo->wasUsingSAT) {
+
+        // We perform temporal coherence, we check the previous minimum separating axis first (the
+        // polyhedron is the first polyhedron of the last frame collision info). If the shapes are
+        // separated along this axis, we directly exit with no collision. If they were colliding and
+        // are still overlapping along this axis, we use it without testing all the other axes.
+
+        // If the previous axis was a face normal of the polyhedron
+        if (lastFrameCollisionInfo->satIsAxisFacePolyhedron1 &&
+            lastFrameCollisionInfo->satMinAxisFaceIndex < polyhedron->getNbFaces()) {
+
+            const uint faceIndex = lastFrameCollisionInfo->satMinAxisFaceIndex;
+
+            Vector3 faceNormalCapsuleSpace;
+            const decimal penetrationDepth = computePolyhedronFaceVsCapsulePenetrationDepth(faceIndex, polyhedron, capsuleShape,
+                                                                                            polyhedronToCapsuleTransform,
+                                                                                            faceNormalCapsuleSpace);
+
+            // If the previous axis is still a separating axis
+            if (penetrationDepth <= decimal(0.0)) {
+
+                lastFrameCollisionInfo->satWasPreviousAxisUsed = true;
+
+                // Return no collision without testing the other axes
+                return false;
+            }
+
+            // If the shapes were colliding and are still overlapping along the previous axis
+            if (lastFrameCollisionInfo->wasColliding) {
+
+                bool contactsFound = true;
+
+                if (reportContacts) {
+
+                    // Convert the inner capsule segment points into the polyhedron local-space
+                    const Transform capsuleToPolyhedronTransform = polyhedronToCapsuleTransform.getInverse();
+                    Vector3 normalWorld = capsuleToWorld.getOrientation() * faceNormalCapsuleSpace;
+                    if (isCapsuleShape1) {
+                        normalWorld = -normalWorld;
+                    }
+
+                    contactsFound = computeCapsulePolyhedronFaceContactPoints(faceIndex, capsuleShape->getRadius(), polyhedron,
+                                                                              penetrationDepth, polyhedronToCapsuleTransform,
+                                                                              normalWorld, faceNormalCapsuleSpace,
+                                                                              capsuleToPolyhedronTransform * capsuleSegA,
+                                                                              capsuleToPolyhedronTransform * capsuleSegB,
+                                                                              narrowPhaseInfo, isCapsuleShape1);
+                }
+
+                // If the contact points have been found, we do not need to test the other axes.
+                // Otherwise, we test all the axes again.
+                if (contactsFound) {
+                    lastFrameCollisionInfo->satWasPreviousAxisUsed = true;
+                    return true;
+                }
+            }
+        }
+        else if (!lastFrameCollisionInfo->satIsAxisFacePolyhedron1 &&
+                 lastFrameCollisionInfo->satMinEdge1Index < polyhedron->getNbHalfEdges()) {
+
+            // The previous axis was the cross product of an edge of the polyhedron and the capsule inner segment
+            const HalfEdgeStructure::Edge& edge = polyhedron->getHalfEdge(lastFrameCollisionInfo->satMinEdge1Index);
+            const HalfEdgeStructure::Edge& twinEdge = polyhedron->getHalfEdge(edge.twinEdgeIndex);
+            const Vector3 edgeVertex1 = polyhedron->getVertexPosition(edge.vertexIndex);
+            const Vector3 edgeVertex2 = polyhedron->getVertexPosition(twinEdge.vertexIndex);
+            const Vector3 edgeDirectionCapsuleSpace = polyhedronToCapsuleTransform.getOrientation() * (edgeVertex2 - edgeVertex1);
+            const Vector3 adjacentFace1Normal = polyhedronToCapsuleTransform.getOrientation() * polyhedron->getFaceNormal(edge.faceIndex);
+            const Vector3 adjacentFace2Normal = polyhedronToCapsuleTransform.getOrientation() * polyhedron->getFaceNormal(twinEdge.faceIndex);
+
+            // The edge is only a candidate axis if it still builds a face of the Minkowski difference
+            if (isMinkowskiFaceCapsuleVsEdge(capsuleSegmentAxis, adjacentFace1Normal, adjacentFace2Normal)) {
+
+                Vector3 outAxis;
+                const decimal penetrationDepth = computeEdgeVsCapsuleInnerSegmentPenetrationDepth(polyhedron, capsuleShape,
+                                                      capsuleSegmentAxis, edgeVertex1,
+                                                      edgeDirectionCapsuleSpace,
+                                                      polyhedronToCapsuleTransform,
+                                                      outAxis);
+
+                // If the previous axis is still a separating axis
+                if (penetrationDepth <= decimal(0.0)) {
+
+                    lastFrameCollisionInfo->satWasPreviousAxisUsed = true;
+
+                    // Return no collision without testing the other axes
+                    return false;
+                }
+
+                // If the shapes were colliding and are still overlapping along the previous axis
+                // (if the edge has become parallel to the capsule, the depth is not valid)
+                if (lastFrameCollisionInfo->wasColliding && penetrationDepth < DECIMAL_LARGEST) {
+
+                    isPreviousAxisUsed = true;
+                    minPenetrationDepth = penetrationDepth;
+                    isMinPenetrationFaceNormal = false;
+                    separatingAxisCapsuleSpace = outAxis;
+                    separatingPolyhedronEdgeVertex1 = edgeVertex1;
+                    separatingPolyhedronEdgeVertex2 = edgeVertex2;
+                    lastFrameCollisionInfo->satWasPreviousAxisUsed = true;
+                }
+            }
+        }
+    }
 
     // For each face of the convex mesh
-    for (uint f = 0; f < polyhedron->getNbFaces(); f++) {
+    for (uint f = 0; !isPreviousAxisUsed && f < polyhedron->getNbFaces(); f++) {
 
         Vector3 outFaceNormalCapsuleSpace;
 
@@ -190,6 +319,10 @@ bool SATAlgorithm::testCollisionCapsuleVsConvexPolyhedron(NarrowPhaseInfo* narro
         // If the penetration depth is negative, we have found a separating axis
         if (penetrationDepth <= decimal(0.0)) {
 
+            lastFrameCollisionInfo->satIsAxisFacePolyhedron1 = true;
+            lastFrameCollisionInfo->satIsAxisFacePolyhedron2 = false;
+            lastFrameCollisionInfo->satMinAxisFaceIndex = f;
+
             return false;
         }
 
@@ -203,7 +336,7 @@ bool SATAlgorithm::testCollisionCapsuleVsConvexPolyhedron(NarrowPhaseInfo* narro
     }
 
     // For each direction that is the cross product of the capsule inner segment and an edge of the polyhedron
-    for (uint e = 0; e < polyhedron->getNbHalfEdges(); e += 2) {
+    for (uint e = 0; !isPreviousAxisUsed && e < polyhedron->getNbHalfEdges(); e += 2) {
 
         // Get an edge from the polyhedron (convert it into the capsule local-space)
         const HalfEdgeStructure::Edge& edge = polyhedron->getHalfEdge(e);
@@ -230,6 +363,10 @@ bool SATAlgorithm::testCollisionCapsuleVsConvexPolyhedron(NarrowPhaseInfo* narro
             // If the penetration depth is negative, we have found a separating axis
             if (penetrationDepth <= decimal(0.0)) {
 
+                lastFrameCollisionInfo->satIsAxisFacePolyhedron1 = false;
+                lastFrameCollisionInfo->satIsAxisFacePolyhedron2 = false;
+                lastFrameCollisionInfo->satMinEdge1Index = e;
+
                 return false;
             }
 
@@ -240,10 +377,19 @@ bool SATAlgorithm::testCollisionCapsuleVsConvexPolyhedron(NarrowPhaseInfo* narro
                 separatingAxisCapsuleSpace = outAxis;
                 separatingPolyhedronEdgeVertex1 = edgeVertex1;
                 separatingPolyhedronEdgeVertex2 = edgeVertex2;
+                minSeparatingEdgeIndex = e;
             }
         }
     }
 
+    // Keep the axis of minimum penetration for the temporal coherence of the next frame
+    if (!isPreviousAxisUsed) {
+        lastFrameCollisionInfo->satIsAxisFacePolyhedron1 = isMinPenetrationFaceNormal;
+        lastFrameCollisionInfo->satIsAxisFacePolyhedron2 = false;
+        lastFrameCollisionInfo->satMinAxisFaceIndex = minFaceIndex;
+        lastFrameCollisionInfo->satMinEdge1Index = minSeparatingEdgeIndex;
+    }
+
     // Convert the inner capsule segment points into the polyhedron local-space
     const Transform capsuleToPolyhedronTransform = polyhedronToCapsuleTransform.getInverse();
     const Vector3 capsuleSegAPolyhedronSpace = capsuleToPolyhedronTransform * capsuleSegA;
@@ -374,8 +520,8 @@ bool SATAlgorithm::computeCapsulePolyhedronFaceContactPoints(uint referenceFaceI
     uint firstEdgeIndex = face.edgeIndex;
     uint edgeIndex = firstEdgeIndex;
 
-    List<Vector3> planesPoints(mMemoryAllocator, 2);
-    List<Vector3> planesNormals(mMemoryAllocator, 2);
+    ClippingList<Vector3> planesPoints(mMemoryAllocator);
+    ClippingList<Vector3> planesNormals(mMemoryAllocator);
 
     // For each adjacent edge of the separating face of the polyhedron
     do {
@@ -401,7 +547,7 @@ bool SATAlgorithm::computeCapsulePolyhedronFaceContactPoints(uint referenceFaceI
     } while(edgeIndex != firstEdgeIndex);
 
     // First we clip the inner segment of the capsule with the four planes of the adjacent faces
-    List<Vector3> clipSegment = clipSegmentWithPlanes(capsuleSegAPolyhedronSpace, capsuleSegBPolyhedronSpace, planesPoints, planesNormals, mMemoryAllocator);
+    ClippingList<Vector3> clipSegment = clipSegmentWithPlanes(capsuleSegAPolyhedronSpace, capsuleSegBPolyhedronSpace, planesPoints, planesNormals, mMemoryAllocator);
 
 	// Project the two clipped points into the polyhedron face
 	const Vector3 delta = faceNormal * (penetrationDepth - capsuleRadius);
@@ -434,10 +580,11 @@ bool SATAlgorithm::computeCapsulePolyhedronFaceContactPoints(uint referenceFaceI
                                                         penetrationDepth, normalWorld);
 
 
-			// Create the contact point
+			// Create the contact point (identified by the polyhedron face and the clipped capsule segment end-point)
             narrowPhaseInfo->addContactPoint(normalWorld, penetrationDepth,
                                              isCapsuleShape1 ? contactPointCapsule : contactPointPolyhedron,
-                                             isCapsuleShape1 ? contactPointPolyhedron : contactPointCapsule);
+                                             isCapsuleShape1 ? contactPointPolyhedron : contactPointCapsule,
+                                             computeContactFeatureId(narrowPhaseInfo, 1, referenceFaceIndex, i, 0));
 		}
 	}
 
@@ -482,6 +629,7 @@ bool SATAlgorithm::testCollisionConvexPolyhedronVsConvexPolyhedron(NarrowPhaseIn
     bool isShape1Triangle = polyhedron1->getName() == CollisionShapeName::TRIANGLE;
 
     LastFrameCollisionInfo* lastFrameCollisionInfo = narrowPhaseInfo->getLastFrameCollisionInfo();
+    lastFrameCollisionInfo->satWasPreviousAxisUsed = false;
 
     // If the last frame collision info is valid and was also using SAT algorithm
     if (lastFrameCollisionInfo->isValid && lastFrameCollisionInfo->wasUsingSAT) {
@@ -497,8 +645,10 @@ bool SATAlgorithm::testCollisionConvexPolyhedronVsConvexPolyhedron(NarrowPhaseIn
             decimal penetrationDepth = testSingleFaceDirectionPolyhedronVsPolyhedron(polyhedron1, polyhedron2, polyhedron1ToPolyhedron2,
                                                  lastFrameCollisionInfo->satMinAxisFaceIndex);
 
-            // If the previous axis was a separating axis and is still a separating axis in this frame
-            if (!lastFrameCollisionInfo->wasColliding && penetrationDepth <= decimal(0.0)) {
+            // If the previous axis is still a separating axis in this frame
+            if (penetrationDepth <= decimal(0.0)) {
+
+                lastFrameCollisionInfo->satWasPreviousAxisUsed = true;
 
                 // Return no collision without running the whole SAT algorithm
                 return false;
@@ -520,6 +670,7 @@ bool SATAlgorithm::testCollisionConvexPolyhedronVsConvexPolyhedron(NarrowPhaseIn
                     lastFrameCollisionInfo->satIsAxisFacePolyhedron1 = isMinPenetrationFaceNormalPolyhedron1;
                     lastFrameCollisionInfo->satIsAxisFacePolyhedron2 = !isMinPenetrationFaceNormalPolyhedron1;
                     lastFrameCollisionInfo->satMinAxisFaceIndex = minFaceIndex;
+                    lastFrameCollisionInfo->satWasPreviousAxisUsed = true;
 
                     // The shapes are still overlapping in the previous axis (the contact manifold is not empty).
                     // Therefore, we can return without running the whole SAT algorithm
@@ -535,8 +686,10 @@ bool SATAlgorithm::testCollisionConvexPolyhedronVsConvexPolyhedron(NarrowPhaseIn
             decimal penetrationDepth = testSingleFaceDirectionPolyhedronVsPolyhedron(polyhedron2, polyhedron1, polyhedron2ToPolyhedron1,
                                                  lastFrameCollisionInfo->satMinAxisFaceIndex);
 
-            // If the previous axis was a separating axis and is still a separating axis in this frame
-            if (!lastFrameCollisionInfo->wasColliding && penetrationDepth <= decimal(0.0)) {
+            // If the previous axis is still a separating axis in this frame
+            if (penetrationDepth <= decimal(0.0)) {
+
+                lastFrameCollisionInfo->satWasPreviousAxisUsed = true;
 
                 // Return no collision without running the whole SAT algorithm
                 return false;
@@ -558,6 +711,7 @@ bool SATAlgorithm::testCollisionConvexPolyhedronVsConvexPolyhedron(NarrowPhaseIn
                     lastFrameCollisionInfo->satIsAxisFacePolyhedron1 = isMinPenetrationFaceNormalPolyhedron1;
                     lastFrameCollisionInfo->satIsAxisFacePolyhedron2 = !isMinPenetrationFaceNormalPolyhedron1;
                     lastFrameCollisionInfo->satMinAxisFaceIndex = minFaceIndex;
+                    lastFrameCollisionInfo->satWasPreviousAxisUsed = true;
 
                     // The shapes are still overlapping in the previous axis (the contact manifold is not empty).
                     // Therefore, we can return without running the whole SAT algorithm
@@ -590,16 +744,19 @@ bool SATAlgorithm::testCollisionConvexPolyhedronVsConvexPolyhedron(NarrowPhaseIn
                 decimal penetrationDepth = computeDistanceBetweenEdges(edge1A, edge2A, polyhedron1Centroid, polyhedron2->getCentroid(),
                            edge1Direction, edge2Direction, isShape1Triangle, separatingAxisPolyhedron2Space);
 
-                // If the shapes were not overlapping in the previous frame and are still not
-                // overlapping in the current one
-                if (!lastFrameCollisionInfo->wasColliding && penetrationDepth <= decimal(0.0)) {
+                // If the previous axis is still a separating axis in this frame
+                if (penetrationDepth <= decimal(0.0)) {
+
+                    lastFrameCollisionInfo->satWasPreviousAxisUsed = true;
 
                     // We have found a separating axis without running the whole SAT algorithm
                     return false;
                 }
 
                 // If the shapes were overlapping on the previous axis and still seem to overlap in this frame
-                if (lastFrameCollisionInfo->wasColliding && penetrationDepth > decimal(0.0)) {
+                // (if the edges have become parallel, the depth is not valid and we run the whole SAT algorithm)
+                if (lastFrameCollisionInfo->wasColliding && penetrationDepth > decimal(0.0) &&
+                    penetrationDepth < DECIMAL_LARGEST) {
 
                     // Compute the closest points between the two edges (in the local-space of poylhedron 2)
                     Vector3 closestPointPolyhedron1Edge, closestPointPolyhedron2Edge;
@@ -642,9 +799,13 @@ bool SATAlgorithm::testCollisionConvexPolyhedronVsConvexPolyhedron(NarrowPhaseIn
                         narrowPhaseInfo->shape1ToWorldTransform, narrowPhaseInfo->shape2ToWorldTransform,
                         penetrationDepth, normalWorld);
 
-                        // Create the contact point
+                        // Create the contact point (identified by the two edges)
                         narrowPhaseInfo->addContactPoint(normalWorld, penetrationDepth,
-                         closestPointPolyhedron1EdgeLocalSpace, closestPointPolyhedron2Edge);
+                         closestPointPolyhedron1EdgeLocalSpace, closestPointPolyhedron2Edge,
+                         computeContactFeatureId(narrowPhaseInfo, 2, lastFrameCollisionInfo->satMinEdge1Index,
+                                                 lastFrameCollisionInfo->satMinEdge2Index, 0));
+
+                        lastFrameCollisionInfo->satWasPreviousAxisUsed = true;
 
                         // The shapes are overlapping on the previous axis (the contact manifold is not empty). Therefore
                         // we return without running the whole SAT algorithm
@@ -694,42 +855,53 @@ bool SATAlgorithm::testCollisionConvexPolyhedronVsConvexPolyhedron(NarrowPhaseIn
         isMinPenetrationFaceNormalPolyhedron1 = false;
     }
 
+    // Compute the arcs of the edges of both polyhedra on the Gauss map of the Minkowski difference
+    // (once per polyhedron instead of once per pair of edges)
+    List<GaussMapEdge> gaussMapEdges1(mMemoryAllocator, polyhedron1->getNbHalfEdges() / 2);
+    List<GaussMapEdge> gaussMapEdges2(mMemoryAllocator, polyhedron2->getNbHalfEdges() / 2);
+    computeGaussMapEdges(polyhedron1, polyhedron1ToPolyhedron2, false, gaussMapEdges1);
+    computeGaussMapEdges(polyhedron2, Transform::identity(), true, gaussMapEdges2);
+
+    const Vector3 polyhedron1Centroid = polyhedron1ToPolyhedron2 * polyhedron1->getCentroid();
+
     // Test the cross products of edges of polyhedron 1 with edges of polyhedron 2 for separating axis
-    for (uint i=0; i < polyhedron1->getNbHalfEdges(); i += 2) {
+    for (uint e1=0; e1 < gaussMapEdges1.size(); e1++) {
 
         // Get an edge of polyhedron 1
-        const HalfEdgeStructure::Edge& edge1 = polyhedron1->getHalfEdge(i);
-
-        const Vector3 edge1A = polyhedron1ToPolyhedron2 * polyhedron1->getVertexPosition(edge1.vertexIndex);
-        const Vector3 edge1B = polyhedron1ToPolyhedron2 * polyhedron1->getVertexPosition(polyhedron1->getHalfEdge(edge1.nextEdgeIndex).vertexIndex);
-        const Vector3 edge1Direction = edge1B - edge1A;
+        const GaussMapEdge& edge1 = gaussMapEdges1[e1];
+        const Vector3 edge1Direction = edge1.vertexB - edge1.vertexA;
 
-        for (uint j=0; j < polyhedron2->getNbHalfEdges(); j += 2) {
+        for (uint e2=0; e2 < gaussMapEdges2.size(); e2++) {
 
             // Get an edge of polyhedron 2
-            const HalfEdgeStructure::Edge& edge2 = polyhedron2->getHalfEdge(j);
+            const GaussMapEdge& edge2 = gaussMapEdges2[e2];
 
-            const Vector3 edge2A = polyhedron2->getVertexPosition(edge2.vertexIndex);
-            const Vector3 edge2B = polyhedron2->getVertexPosition(polyhedron2->getHalfEdge(edge2.nextEdgeIndex).vertexIndex);
-            const Vector3 edge2Direction = edge2B - edge2A;
+            // The arc of the edge 2 must cross the plane of the arc of the edge 1 for the two
+            // arcs to intersect (most of the pairs of edges are pruned by this first test)
+            const decimal cba = edge2.faceNormal1.dot(edge1.arcNormal);
+            const decimal dba = edge2.faceNormal2.dot(edge1.arcNormal);
+            if (cba * dba >= decimal(0.0)) continue;
 
             // If the two edges build a minkowski face (and the cross product is
             // therefore a candidate for separating axis
-            if (testEdgesBuildMinkowskiFace(polyhedron1, edge1, polyhedron2, edge2, polyhedron1ToPolyhedron2)) {
+            const decimal adc = edge1.faceNormal1.dot(edge2.arcNormal);
+            const decimal bdc = edge1.faceNormal2.dot(edge2.arcNormal);
+            if (adc * bdc < decimal(0.0) && cba * bdc > decimal(0.0)) {
+
+                const Vector3 edge2Direction = edge2.vertexB - edge2.vertexA;
 
                 Vector3 separatingAxisPolyhedron2Space;
 
                 // Compute the penetration depth
-                const Vector3 polyhedron1Centroid = polyhedron1ToPolyhedron2 * polyhedron1->getCentroid();
-                decimal penetrationDepth = computeDistanceBetweenEdges(edge1A, edge2A, polyhedron1Centroid, polyhedron2->getCentroid(),
+                decimal penetrationDepth = computeDistanceBetweenEdges(edge1.vertexA, edge2.vertexA, polyhedron1Centroid, polyhedron2->getCentroid(),
                            edge1Direction, edge2Direction, isShape1Triangle, separatingAxisPolyhedron2Space);
 
                 if (penetrationDepth <= decimal(0.0)) {
 
                     lastFrameCollisionInfo->satIsAxisFacePolyhedron1 = false;
                     lastFrameCollisionInfo->satIsAxisFacePolyhedron2 = false;
-                    lastFrameCollisionInfo->satMinEdge1Index = i;
-                    lastFrameCollisionInfo->satMinEdge2Index = j;
+                    lastFrameCollisionInfo->satMinEdge1Index = 2 * e1;
+                    lastFrameCollisionInfo->satMinEdge2Index = 2 * e2;
 
                     // We have found a separating axis
                     return false;
@@ -740,12 +912,12 @@ bool SATAlgorithm::testCollisionConvexPolyhedronVsConvexPolyhedron(NarrowPhaseIn
                     minPenetrationDepth = penetrationDepth;
                     isMinPenetrationFaceNormalPolyhedron1 = false;
                     isMinPenetrationFaceNormal = false;
-                    minSeparatingEdge1Index = i;
-                    minSeparatingEdge2Index = j;
-                    separatingEdge1A = edge1A;
-                    separatingEdge1B = edge1B;
-                    separatingEdge2A = edge2A;
-                    separatingEdge2B = edge2B;
+                    minSeparatingEdge1Index = 2 * e1;
+                    minSeparatingEdge2Index = 2 * e2;
+                    separatingEdge1A = edge1.vertexA;
+                    separatingEdge1B = edge1.vertexB;
+                    separatingEdge2A = edge2.vertexA;
+                    separatingEdge2B = edge2.vertexB;
                     minEdgeVsEdgeSeparatingAxisPolyhedron2Space = separatingAxisPolyhedron2Space;
                 }
             }
@@ -816,9 +988,10 @@ bool SATAlgorithm::testCollisionConvexPolyhedronVsConvexPolyhedron(NarrowPhaseIn
                                                             narrowPhaseInfo->shape1ToWorldTransform, narrowPhaseInfo->shape2ToWorldTransform,
                                                             minPenetrationDepth, normalWorld);
 
-            // Create the contact point
+            // Create the contact point (identified by the two edges)
             narrowPhaseInfo->addContactPoint(normalWorld, minPenetrationDepth,
-                                             closestPointPolyhedron1EdgeLocalSpace, closestPointPolyhedron2Edge);
+                                             closestPointPolyhedron1EdgeLocalSpace, closestPointPolyhedron2Edge,
+                                             computeContactFeatureId(narrowPhaseInfo, 2, minSeparatingEdge1Index, minSeparatingEdge2Index, 0));
         }
 
         lastFrameCollisionInfo->satIsAxisFacePolyhedron1 = false;
@@ -863,14 +1036,17 @@ bool SATAlgorithm::computePolyhedronVsPolyhedronFaceContactPoints(bool isMinPene
     const HalfEdgeStructure::Face& incidentFace = incidentPolyhedron->getFace(incidentFaceIndex);
 
     uint nbIncidentFaceVertices = static_cast<uint>(incidentFace.faceVertices.size());
-    List<Vector3> polygonVertices(mMemoryAllocator, nbIncidentFaceVertices);   // Vertices to clip of the incident face
-    List<Vector3> planesNormals(mMemoryAllocator, nbIncidentFaceVertices);     // Normals of the clipping planes
-    List<Vector3> planesPoints(mMemoryAllocator, nbIncidentFaceVertices);      // Points on the clipping planes
+    ClippingList<Vector3> polygonVertices(mMemoryAllocator, nbIncidentFaceVertices);   // Vertices to clip of the incident face
+    ClippingList<Vector3> planesNormals(mMemoryAllocator, nbIncidentFaceVertices);     // Normals of the clipping planes
+    ClippingList<Vector3> planesPoints(mMemoryAllocator, nbIncidentFaceVertices);      // Points on the clipping planes
+
+    ClippingList<uint32> polygonVerticesIds(mMemoryAllocator, nbIncidentFaceVertices); // Identifiers of the vertices to clip
 
     // Get all the vertices of the incident face (in the reference local-space)
     for (uint i=0; i < incidentFace.faceVertices.size(); i++) {
         const Vector3 faceVertexIncidentSpace = incidentPolyhedron->getVertexPosition(incidentFace.faceVertices[i]);
         polygonVertices.add(incidentToReferenceTransform * faceVertexIncidentSpace);
+        polygonVerticesIds.add(incidentFace.faceVertices[i]);
     }
 
     // Get the reference face clipping planes
@@ -905,7 +1081,9 @@ bool SATAlgorithm::computePolyhedronVsPolyhedronFaceContactPoints(bool isMinPene
     assert(planesNormals.size() == planesPoints.size());
 
     // Clip the reference faces with the adjacent planes of the reference face
-    List<Vector3> clipPolygonVertices = clipPolygonWithPlanes(polygonVertices, planesPoints, planesNormals, mMemoryAllocator);
+    ClippingList<uint32> clipPolygonVerticesIds(mMemoryAllocator, nbIncidentFaceVertices);
+    ClippingList<Vector3> clipPolygonVertices = clipPolygonWithPlanes(polygonVertices, polygonVerticesIds, planesPoints, planesNormals,
+                                                              clipPolygonVerticesIds, mMemoryAllocator);
 
     // We only keep the clipped points that are below the reference face
     const Vector3 referenceFaceVertex = referencePolyhedron->getVertexPosition(referencePolyhedron->getHalfEdge(firstEdgeIndex).vertexIndex);
@@ -936,10 +1114,15 @@ bool SATAlgorithm::computePolyhedronVsPolyhedronFaceContactPoints(bool isMinPene
                                     narrowPhaseInfo->shape1ToWorldTransform, narrowPhaseInfo->shape2ToWorldTransform,
                                     penetrationDepth, outWorldNormal);
 
+            // Identify the contact point by the reference face, the incident face and the clipped feature
+            const uint32 featureId = computeContactFeatureId(narrowPhaseInfo, isMinPenetrationFaceNormalPolyhedron1 ? 3 : 4,
+                                                             minFaceIndex, incidentFaceIndex, clipPolygonVerticesIds[i]);
+
             // Create a new contact point
             narrowPhaseInfo->addContactPoint(outWorldNormal, penetrationDepth,
                              isMinPenetrationFaceNormalPolyhedron1 ? contactPointReferencePolyhedron : contactPointIncidentPolyhedron,
-                             isMinPenetrationFaceNormalPolyhedron1 ? contactPointIncidentPolyhedron : contactPointReferencePolyhedron);
+                             isMinPenetrationFaceNormalPolyhedron1 ? contactPointIncidentPolyhedron : contactPointReferencePolyhedron,
+                             featureId);
         }
     }
 
@@ -1053,6 +1236,36 @@ decimal SATAlgorithm::testFacesDirectionPolyhedronVsPolyhedron(const ConvexPolyh
 }
 
 
+// Compute the arcs on the Gauss map of the edges of a polyhedron
+/// One arc is computed for each pair of twin half-edges (the even half-edges) with the face
+/// normals and the vertices of the edge in the local-space of the second polyhedron. The face
+/// normals of the second polyhedron are negated because we are looking at the Gauss map of
+/// the Minkowski difference of the polyhedrons. The arc normals are the same as in the
+/// method testEdgesBuildMinkowskiFace().
+void SATAlgorithm::computeGaussMapEdges(const ConvexPolyhedronShape* polyhedron, const Transform& polyhedronToPolyhedron2,
+                                        bool isMinkowskiDifferenceSecondShape, List<GaussMapEdge>& outEdges) const {
+
+    RP3D_PROFILE("SATAlgorithm::computeGaussMapEdges", mProfiler);
+
+    const Quaternion& orientation = polyhedronToPolyhedron2.getOrientation();
+    const decimal normalSign = isMinkowskiDifferenceSecondShape ? decimal(-1.0) : decimal(1.0);
+
+    for (uint i=0; i < polyhedron->getNbHalfEdges(); i += 2) {
+
+        const HalfEdgeStructure::Edge& edge = polyhedron->getHalfEdge(i);
+        const HalfEdgeStructure::Edge& twinEdge = polyhedron->getHalfEdge(edge.twinEdgeIndex);
+
+        GaussMapEdge gaussMapEdge;
+        gaussMapEdge.faceNormal1 = normalSign * (orientation * polyhedron->getFaceNormal(edge.faceIndex));
+        gaussMapEdge.faceNormal2 = normalSign * (orientation * polyhedron->getFaceNormal(twinEdge.faceIndex));
+        gaussMapEdge.vertexA = polyhedronToPolyhedron2 * polyhedron->getVertexPosition(edge.vertexIndex);
+        gaussMapEdge.vertexB = polyhedronToPolyhedron2 * polyhedron->getVertexPosition(twinEdge.vertexIndex);
+        gaussMapEdge.arcNormal = gaussMapEdge.vertexA - gaussMapEdge.vertexB;
+
+        outEdges.add(gaussMapEdge);
+    }
+}
+
 // Return true if two edges of two polyhedrons build a minkowski face (and can therefore be a separating axis)
 bool SATAlgorithm::testEdgesBuildMinkowskiFace(const ConvexPolyhedronShape* polyhedron1, const HalfEdgeStructure::Edge& edge1,
                                                const ConvexPolyhedronShape* polyhedron2, const HalfEdgeStructure::Edge& edge2,
@@ -29,6 +29,7 @@
 // Libraries
 #include "decimal.h"
 #include "collision/HalfEdgeStructure.h"
+#include "containers/List.h"
 
 /// ReactPhysics3D namespace
 namespace reactphysics3d {
@@ -53,6 +54,29 @@ class SATAlgorithm {
 
     private :
 
+        // Structure GaussMapEdge
+        /**
+         * Arc of an edge of a polyhedron on the Gauss map and the vertices of the edge
+         * in the local-space of the second polyhedron
+         */
+        struct GaussMapEdge {
+
+            /// Normal of the face of the edge (the first point of the arc)
+            Vector3 faceNormal1;
+
+            /// Normal of the face of the twin edge (the second point of the arc)
+            Vector3 faceNormal2;
+
+            /// Normal of the plane of the arc (the cross product of the face normals)
+            Vector3 arcNormal;
+
+            /// First vertex of the edge
+            Vector3 vertexA;
+
+            /// Second vertex of the edge
+            Vector3 vertexB;
+        };
+
         // -------------------- Attributes -------------------- //
 
         /// Bias used to make sure the SAT algorithm returns the same penetration axis between frames
@@ -72,11 +96,19 @@ class SATAlgorithm {
 
         // -------------------- Methods -------------------- //
 
+        /// Compute the identifier of a contact point from the features that generated it
+        static uint32 computeContactFeatureId(const NarrowPhaseInfo* narrowPhaseInfo, uint32 contactType,
+                                              uint32 featureIndex1, uint32 featureIndex2, uint32 featureIndex3);
+
         /// Return true if two edges of two polyhedrons build a minkowski face (and can therefore be a separating axis)
         bool testEdgesBuildMinkowskiFace(const ConvexPolyhedronShape* polyhedron1, const HalfEdgeStructure::Edge& edge1,
                                          const ConvexPolyhedronShape* polyhedron2, const HalfEdgeStructure::Edge& edge2,
                                          const Transform& polyhedron1ToPolyhedron2) const;
 
+        /// Compute the arcs on the Gauss map of the edges of a polyhedron
+        void computeGaussMapEdges(const ConvexPolyhedronShape* polyhedron, const Transform& polyhedronToPolyhedron2,
+                                  bool isMinkowskiDifferenceSecondShape, List<GaussMapEdge>& outEdges) const;
+
         /// Return true if the arcs AB and CD on the Gauss Map intersect
         bool testGaussMapArcsIntersect(const Vector3& a, const Vector3& b,
                                        const Vector3& c, const Vector3& d,
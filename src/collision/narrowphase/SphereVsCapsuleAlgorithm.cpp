@@ -1,139 +1,279 @@
-/********************************************************************************
-* ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
-* Copyright (c) 2010-2018 Daniel Chappuis                                       *
-*********************************************************************************
-*                                                                               *
-* This software is provided 'as-is', without any express or implied warranty.   *
-* In no event will the authors be held liable for any damages arising from the  *
-* use of this software.                                                         *
-*                                                                               *
-* Permission is granted to anyone to use this software for any purpose,         *
-* including commercial applications, and to alter it and redistribute it        *
-* freely, subject to the following restrictions:                                *
-*                                                                               *
-* 1. The origin of this software must not be misrepresented; you must not claim *
-*    that you wrote the original software. If you use this software in a        *
-*    product, an acknowledgment in the product documentation would be           *
-*    appreciated but is not required.                                           *
-*                                                                               *
-* 2. Altered source versions must be plainly marked as such, and must not be    *
-*    misrepresented as being the original software.                             *
-*                                                                               *
-* 3. This notice may not be removed or altered from any source distribution.    *
-*                                                                               *
-********************************************************************************/
-
-// Libraries
-#include "SphereVsCapsuleAlgorithm.h"
-#include "collision/shapes/SphereShape.h"
-#include "collision/shapes/CapsuleShape.h"
-#include "collision/NarrowPhaseInfo.h"
-
-// We want to use the ReactPhysics3D namespace
-using namespace reactphysics3d;  
-
-// Compute the narrow-phase collision detection between a sphere and a capsule
-// This technique is based on the "Robust Contact Creation for Physics Simulations" presentation
-// by Dirk Gregorius.
-bool SphereVsCapsuleAlgorithm::testCollision(NarrowPhaseInfo* narrowPhaseInfo, bool reportContacts,
-                                             MemoryAllocator& memoryAllocator) {
-
-    bool isSphereShape1 = narrowPhaseInfo->collisionShape1->getType() == CollisionShapeType::SPHERE;
-
-    assert(isSphereShape1 || narrowPhaseInfo->collisionShape1->getType() == CollisionShapeType::CAPSULE);
-
-    // Get the collision shapes
-    const SphereShape* sphereShape = static_cast<const SphereShape*>(isSphereShape1 ? narrowPhaseInfo->collisionShape1 : narrowPhaseInfo->collisionShape2);
-    const CapsuleShape* capsuleShape = static_cast<const CapsuleShape*>(isSphereShape1 ? narrowPhaseInfo->collisionShape2 : narrowPhaseInfo->collisionShape1);
-
-    // Get the transform from sphere local-space to capsule local-space
-    const Transform& sphereToWorldTransform = isSphereShape1 ? narrowPhaseInfo->shape1ToWorldTransform : narrowPhaseInfo->shape2ToWorldTransform;
-    const Transform& capsuleToWorldTransform = isSphereShape1 ? narrowPhaseInfo->shape2ToWorldTransform : narrowPhaseInfo->shape1ToWorldTransform;
-    const Transform worldToCapsuleTransform = capsuleToWorldTransform.getInverse();
-    const Transform sphereToCapsuleSpaceTransform = worldToCapsuleTransform * sphereToWorldTransform;
-
-	// Transform the center of the sphere into the local-space of the capsule shape
-	const Vector3 sphereCenter = sphereToCapsuleSpaceTransform.getPosition();
-
-	// Compute the end-points of the inner segment of the capsule
-    const decimal capsuleHalfHeight = capsuleShape->getHeight() * decimal(0.5);
-    const Vector3 capsuleSegA(0, -capsuleHalfHeight, 0);
-    const Vector3 capsuleSegB(0, capsuleHalfHeight, 0);
-
-    // Compute the point on the inner capsule segment that is the closes to center of sphere
-	const Vector3 closestPointOnSegment = computeClosestPointOnSegment(capsuleSegA, capsuleSegB, sphereCenter);
-
-	// Compute the distance between the sphere center and the closest point on the segment
-	Vector3 sphereCenterToSegment = (closestPointOnSegment - sphereCenter);
-	const decimal sphereSegmentDistanceSquare = sphereCenterToSegment.lengthSquare();
-
-    // Compute the sum of the radius of the sphere and the capsule (virtual sphere)
-    decimal sumRadius = sphereShape->getRadius() + capsuleShape->getRadius();
-    
-    // If the collision shapes overlap
-    if (sphereSegmentDistanceSquare < sumRadius * sumRadius) {
-
-		decimal penetrationDepth;
-		Vector3 normalWorld;
-		Vector3 contactPointSphereLocal;
-		Vector3 contactPointCapsuleLocal;
-
-        if (reportContacts) {
-
-			// If the sphere center is not on the capsule inner segment
-			if (sphereSegmentDistanceSquare > MACHINE_EPSILON) {
-
-				decimal sphereSegmentDistance = std::sqrt(sphereSegmentDistanceSquare);
-				sphereCenterToSegment /= sphereSegmentDistance;
-
-				contactPointSphereLocal = sphereToCapsuleSpaceTransform.getInverse() * (sphereCenter + sphereCenterToSegment * sphereShape->getRadius());
-				contactPointCapsuleLocal = closestPointOnSegment - sphereCenterToSegment * capsuleShape->getRadius();
-
-				normalWorld = capsuleToWorldTransform.getOrientation() * sphereCenterToSegment;
-
-				penetrationDepth = sumRadius - sphereSegmentDistance;
-
-				if (!isSphereShape1) {
-					normalWorld = -normalWorld;
-				}
-			}
-			else {  // If the sphere center is on the capsule inner segment (degenerate case)
-
-				// We take any direction that is orthogonal to the inner capsule segment as a contact normal
-
-				// Capsule inner segment
-				Vector3 capsuleSegment = (capsuleSegB - capsuleSegA).getUnit();
-
-				Vector3 vec1(1, 0, 0);
-				Vector3 vec2(0, 1, 0);
-
-				// Get the vectors (among vec1 and vec2) that is the most orthogonal to the capsule inner segment (smallest absolute dot product)
-				decimal cosA1 = std::abs(capsuleSegment.x);		// abs(vec1.dot(seg2))
-				decimal cosA2 = std::abs(capsuleSegment.y);	    // abs(vec2.dot(seg2))
-
-				penetrationDepth = sumRadius;
-
-				// We choose as a contact normal, any direction that is perpendicular to the inner capsule segment
-				Vector3 normalCapsuleSpace = cosA1 < cosA2 ? capsuleSegment.cross(vec1) : capsuleSegment.cross(vec2);
-				normalWorld = capsuleToWorldTransform.getOrientation() * normalCapsuleSpace;
-
-				// Compute the two local contact points
-				contactPointSphereLocal = sphereToCapsuleSpaceTransform.getInverse() * (sphereCenter + normalCapsuleSpace * sphereShape->getRadius());
-				contactPointCapsuleLocal = sphereCenter - normalCapsuleSpace * capsuleShape->getRadius();
-			}
-
-            if (penetrationDepth <= decimal(0.0)) {
-                return false;
-            }
-
-            // Create the contact info object
-            narrowPhaseInfo->addContactPoint(normalWorld, penetrationDepth,
-                                             isSphereShape1 ? contactPointSphereLocal : contactPointCapsuleLocal,
-                                             isSphereShape1 ? contactPointCapsuleLocal : contactPointSphereLocal);
-        }
-
-        return true;
-    }
-
-    return false;
-}
+/********************************************************************************
+* ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
+* Copyright (c) 2010-2018 Daniel Chappuis                                       *
+*********************************************************************************
+*                                                                               *
+* This software is provided 'as-is', without any express or implied warranty.   *
+* In no event will the authors be held liable for any damages arising from the  *
+* use of this software.                                                         *
+*                                                                               *
+* Permission is granted to anyone to use this software for any purpose,         *
+* including commercial applications, and to alter it and redistribute it        *
+* freely, subject to the following restrictions:                                *
+*                                                                               *
+* 1. The origin of this software must not be misrepresented; you must not claim *
+*    that you wrote the original software. If you use this software in a        *
+*    product, an acknowledgment in the product documentation would be           *
+*    appreciated but is not required.                                           *
+*                                                                               *
+* 2. Altered source versions must be plainly marked as such, and must not be    *
+*    misrepresented as being the original software.                             *
+*                                                                               *
+* 3. This notice may not be removed or altered from any source distribution.    *
+*                                                                               *
+********************************************************************************/
+
+// Libraries
+#include "SphereVsCapsuleAlgorithm.h"
+#include "collision/shapes/SphereShape.h"
+#include "collision/shapes/CapsuleShape.h"
+#include "collision/NarrowPhaseInfo.h"
+
+// We want to use the ReactPhysics3D namespace
+using namespace reactphysics3d;  
+
+// Compute the narrow-phase collision detection between a sphere and a capsule
+// This technique is based on the "Robust Contact Creation for Physics Simulations" presentation
+// by Dirk Gregorius.
+bool SphereVsCapsuleAlgorithm::testCollision(NarrowPhaseInfo* narrowPhaseInfo, bool reportContacts,
+                                             MemoryAllocator& memoryAllocator) {
+
+    bool isSphereShape1 = narrowPhaseInfo->collisionShape1->getType() == CollisionShapeType::SPHERE;
+
+    assert(isSphereShape1 || narrowPhaseInfo->collisionShape1->getType() == CollisionShapeType::CAPSULE);
+
+    // Get the collision shapes
+    const SphereShape* sphereShape = static_cast<const SphereShape*>(isSphereShape1 ? narrowPhaseInfo->collisionShape1 : narrowPhaseInfo->collisionShape2);
+    const CapsuleShape* capsuleShape = static_cast<const CapsuleShape*>(isSphereShape1 ? narrowPhaseInfo->collisionShape2 : narrowPhaseInfo->collisionShape1);
+
+    // Get the transform from sphere local-space to capsule local-space
+    const Transform& sphereToWorldTransform = isSphereShape1 ? narrowPhaseInfo->shape1ToWorldTransform : narrowPhaseInfo->shape2ToWorldTransform;
+    const Transform& capsuleToWorldTransform = isSphereShape1 ? narrowPhaseInfo->shape2ToWorldTransform : narrowPhaseInfo->shape1ToWorldTransform;
+    const Transform worldToCapsuleTransform = capsuleToWorldTransform.getInverse();
+    const Transform sphereToCapsuleSpaceTransform = worldToCapsuleTransform * sphereToWorldTransform;
+
+	// Transform the center of the sphere into the local-space of the capsule shape
+	const Vector3 sphereCenter = sphereToCapsuleSpaceTransform.getPosition();
+
+	// Compute the end-points of the inner segment of the capsule
+    const decimal capsuleHalfHeight = capsuleShape->getHeight() * decimal(0.5);
+    const Vector3 capsuleSegA(0, -capsuleHalfHeight, 0);
+    const Vector3 capsuleSegB(0, capsuleHalfHeight, 0);
+
+    // Compute the point on the inner capsule segment that is the closes to center of sphere
+	const Vector3 closestPointOnSegment = computeClosestPointOnSegment(capsuleSegA, capsuleSegB, sphereCenter);
+
+	// Compute the distance between the sphere center and the closest point on the segment
+	Vector3 sphereCenterToSegment = (closestPointOnSegment - sphereCenter);
+	const decimal sphereSegmentDistanceSquare = sphereCenterToSegment.lengthSquare();
+
+    // Compute the sum of the radius of the sphere and the capsule (virtual sphere)
+    decimal sumRadius = sphereShape->getRadius() + capsuleShape->getRadius();
+    
+    // If the collision shapes overlap
+    if (sphereSegmentDistanceSquare < sumRadius * sumRadius) {
+
+		decimal penetrationDepth;
+		Vector3 normalWorld;
+		Vector3 contactPointSphereLocal;
+		Vector3 contactPointCapsuleLocal;
+
+        if (reportContacts) {
+
+			// If the sphere center is not on the capsule inner segment
+			if (sphereSegmentDistanceSquare > MACHINE_EPSILON) {
+
+				decimal sphereSegmentDistance = std::sqrt(sphereSegmentDistanceSquare);
+				sphereCenterToSegment /= sphereSegmentDistance;
+
+				contactPointSphereLocal = sphereToCapsuleSpaceTransform.getInverse() * (sphereCenter + sphereCenterToSegment * sphereShape->getRadius());
+				contactPointCapsuleLocal = closestPointOnSegment - sphereCenterToSegment * capsuleShape->getRadius();
+
+				normalWorld = capsuleToWorldTransform.getOrientation() * sphereCenterToSegment;
+
+				penetrationDepth = sumRadius - sphereSegmentDistance;
+			}
+			else {  // If the sphere center is on the capsule inner segment (degenerate case)
+
+				// We take any direction that is orthogonal to the inner capsule segment as a contact normal
+
+				// Capsule inner segment
+				Vector3 capsuleSegment = (capsuleSegB - capsuleSegA).getUnit();
+
+				Vector3 vec1(1, 0, 0);
+				Vector3 vec2(0, 1, 0);
+
+				// Get the vectors (among vec1 and vec2) that is the most orthogonal to the capsule inner segment (smallest absolute dot product)
+				decimal cosA1 = std::abs(capsuleSegment.x);		// abs(vec1.dot(seg2))
+				decimal cosA2 = std::abs(capsuleSegment.y);	    // abs(vec2.dot(seg2))
+
+				penetrationDepth = sumRadius;
+
+				// We choose as a contact normal, any direction that is perpendicular to the inner capsule segment
+				Vector3 normalCapsuleSpace = cosA1 < cosA2 ? capsuleSegment.cross(vec1) : capsuleSegment.cross(vec2);
+				normalWorld = capsuleToWorldTransform.getOrientation() * normalCapsuleSpace;
+
+				// Compute the two local contact points
+				contactPointSphereLocal = sphereToCapsuleSpaceTransform.getInverse() * (sphereCenter + normalCapsuleSpace * sphereShape->getRadius());
+				contactPointCapsuleLocal = sphereCenter - normalCapsuleSpace * capsuleShape->getRadius();
+			}
+
+            if (penetrationDepth <= decimal(0.0)) {
+                return false;
+            }
+
+            // The normal goes from the first shape to the second one
+            if (!isSphereShape1) {
+                normalWorld = -normalWorld;
+            }
+
+            // Create the contact info object
+            narrowPhaseInfo->addContactPoint(normalWorld, penetrationDepth,
+                                             isSphereShape1 ? contactPointSphereLocal : contactPointCapsuleLocal,
+                                             isSphereShape1 ? contactPointCapsuleLocal : contactPointSphereLocal);
+        }
+
+        return true;
+    }
+
+    return false;
+}
+
+// Compute the contact infos of a batch of narrow-phase infos
+/// The pairs are tested by groups of NB_NARROW_PHASE_LANES pairs. The center of each sphere
+/// is transformed into the local-space of its capsule and copied with the sizes of the shapes
+/// into a structure of arrays. The contacts of the whole group are then computed in the
+/// local-space of the capsules by a kernel without branches that the compiler can turn into
+/// SIMD instructions.
+void SphereVsCapsuleAlgorithm::testCollisionBatch(NarrowPhaseInfo** narrowPhaseInfos, bool* isColliding,
+                                                  uint nbNarrowPhaseInfos, bool reportContacts,
+                                                  MemoryAllocator& memoryAllocator) {
+
+    SphereCapsulePairLanes lanes;
+    Transform sphereToCapsuleSpaceTransforms[NB_NARROW_PHASE_LANES];
+
+    for (uint startIndex=0; startIndex < nbNarrowPhaseInfos; startIndex += NB_NARROW_PHASE_LANES) {
+
+        const uint nbRemainingInfos = nbNarrowPhaseInfos - startIndex;
+        const uint nbLanes = nbRemainingInfos < NB_NARROW_PHASE_LANES ? nbRemainingInfos : NB_NARROW_PHASE_LANES;
+
+        // Copy the shapes of the group into the lanes
+        for (uint l=0; l < NB_NARROW_PHASE_LANES; l++) {
+
+            if (l < nbLanes) {
+
+                const NarrowPhaseInfo* narrowPhaseInfo = narrowPhaseInfos[startIndex + l];
+
+                const bool isSphereShape1 = narrowPhaseInfo->collisionShape1->getType() == CollisionShapeType::SPHERE;
+                assert(isSphereShape1 || narrowPhaseInfo->collisionShape1->getType() == CollisionShapeType::CAPSULE);
+
+                const SphereShape* sphereShape = static_cast<const SphereShape*>(isSphereShape1 ? narrowPhaseInfo->collisionShape1 : narrowPhaseInfo->collisionShape2);
+                const CapsuleShape* capsuleShape = static_cast<const CapsuleShape*>(isSphereShape1 ? narrowPhaseInfo->collisionShape2 : narrowPhaseInfo->collisionShape1);
+                const Transform& sphereToWorldTransform = isSphereShape1 ? narrowPhaseInfo->shape1ToWorldTransform : narrowPhaseInfo->shape2ToWorldTransform;
+                const Transform& capsuleToWorldTransform = isSphereShape1 ? narrowPhaseInfo->shape2ToWorldTransform : narrowPhaseInfo->shape1ToWorldTransform;
+
+                sphereToCapsuleSpaceTransforms[l] = capsuleToWorldTransform.getInverse() * sphereToWorldTransform;
+                const Vector3& sphereCenter = sphereToCapsuleSpaceTransforms[l].getPosition();
+                for (int k=0; k < 3; k++) {
+                    lanes.sphereCenter[k][l] = sphereCenter[k];
+                }
+                lanes.capsuleHalfHeight[l] = capsuleShape->getHeight() * decimal(0.5);
+                lanes.sphereRadius[l] = sphereShape->getRadius();
+                lanes.capsuleRadius[l] = capsuleShape->getRadius();
+            }
+            else {
+                for (int k=0; k < 3; k++) {
+                    lanes.sphereCenter[k][l] = decimal(0.0);
+                }
+                lanes.capsuleHalfHeight[l] = decimal(0.0);
+                lanes.sphereRadius[l] = decimal(0.0);
+                lanes.capsuleRadius[l] = decimal(0.0);
+            }
+        }
+
+        computeContactLanes(lanes);
+
+        // Create the contact points of the intersecting shapes
+        for (uint l=0; l < nbLanes; l++) {
+
+            isColliding[startIndex + l] = lanes.isColliding[l];
+
+            if (reportContacts && lanes.isColliding[l]) {
+
+                if (lanes.penetrationDepth[l] <= decimal(0.0)) {
+                    isColliding[startIndex + l] = false;
+                    continue;
+                }
+
+                NarrowPhaseInfo* narrowPhaseInfo = narrowPhaseInfos[startIndex + l];
+
+                const bool isSphereShape1 = narrowPhaseInfo->collisionShape1->getType() == CollisionShapeType::SPHERE;
+                const Transform& capsuleToWorldTransform = isSphereShape1 ? narrowPhaseInfo->shape2ToWorldTransform : narrowPhaseInfo->shape1ToWorldTransform;
+
+                const Vector3 normal(lanes.normal[0][l], lanes.normal[1][l], lanes.normal[2][l]);
+                const Vector3 spherePoint(lanes.spherePoint[0][l], lanes.spherePoint[1][l], lanes.spherePoint[2][l]);
+                const Vector3 contactPointCapsuleLocal(lanes.capsulePoint[0][l], lanes.capsulePoint[1][l], lanes.capsulePoint[2][l]);
+                const Vector3 contactPointSphereLocal = sphereToCapsuleSpaceTransforms[l].getInverse() * spherePoint;
+
+                Vector3 normalWorld = capsuleToWorldTransform.getOrientation() * normal;
+                if (!isSphereShape1) {
+                    normalWorld = -normalWorld;
+                }
+
+                narrowPhaseInfo->addContactPoint(normalWorld, lanes.penetrationDepth[l],
+                                                 isSphereShape1 ? contactPointSphereLocal : contactPointCapsuleLocal,
+                                                 isSphereShape1 ? contactPointCapsuleLocal : contactPointSphereLocal);
+            }
+        }
+    }
+}
+
+// Compute the contacts of the pairs of a sphere and a capsule of all the lanes
+/// The closest point of the inner segment of a capsule to the center of a sphere is found by
+/// clamping the Y coordinate of the center. If the center of the sphere is on the segment,
+/// the normal is orthogonal to the segment (like in testCollision()).
+void SphereVsCapsuleAlgorithm::computeContactLanes(SphereCapsulePairLanes& lanes) {
+
+    for (uint l=0; l < NB_NARROW_PHASE_LANES; l++) {
+
+        const decimal centerX = lanes.sphereCenter[0][l];
+        const decimal centerY = lanes.sphereCenter[1][l];
+        const decimal centerZ = lanes.sphereCenter[2][l];
+        const decimal halfHeight = lanes.capsuleHalfHeight[l];
+
+        // Closest point of the inner segment of the capsule to the sphere center
+        const decimal closestY = std::min(std::max(centerY, -halfHeight), halfHeight);
+
+        // Vector from the sphere center to the segment
+        const decimal x = -centerX;
+        const decimal y = closestY - centerY;
+        const decimal z = -centerZ;
+        const decimal squaredDistance = x * x + y * y + z * z;
+        const decimal sumRadius = lanes.sphereRadius[l] + lanes.capsuleRadius[l];
+        const decimal distance = std::sqrt(squaredDistance);
+
+        // Contact normal (orthogonal to the segment in the degenerate case)
+        const bool isDegenerate = squaredDistance <= MACHINE_EPSILON;
+        const decimal inverseDistance = isDegenerate ? decimal(0.0) : decimal(1.0) / distance;
+        const decimal normalX = x * inverseDistance;
+        const decimal normalY = y * inverseDistance;
+        const decimal normalZ = isDegenerate ? decimal(-1.0) : z * inverseDistance;
+
+        // The contact point of the capsule is computed from the sphere center in the degenerate case
+        const decimal capsuleBaseX = isDegenerate ? centerX : decimal(0.0);
+        const decimal capsuleBaseY = isDegenerate ? centerY : closestY;
+        const decimal capsuleBaseZ = isDegenerate ? centerZ : decimal(0.0);
+
+        lanes.isColliding[l] = squaredDistance < sumRadius * sumRadius;
+        lanes.penetrationDepth[l] = isDegenerate ? sumRadius : sumRadius - distance;
+        lanes.normal[0][l] = normalX;
+        lanes.normal[1][l] = normalY;
+        lanes.normal[2][l] = normalZ;
+        lanes.spherePoint[0][l] = centerX + lanes.sphereRadius[l] * normalX;
+        lanes.spherePoint[1][l] = centerY + lanes.sphereRadius[l] * normalY;
+        lanes.spherePoint[2][l] = centerZ + lanes.sphereRadius[l] * normalZ;
+        lanes.capsulePoint[0][l] = capsuleBaseX - lanes.capsuleRadius[l] * normalX;
+        lanes.capsulePoint[1][l] = capsuleBaseY - lanes.capsuleRadius[l] * normalY;
+        lanes.capsulePoint[2][l] = capsuleBaseZ - lanes.capsuleRadius[l] * normalZ;
+    }
+}
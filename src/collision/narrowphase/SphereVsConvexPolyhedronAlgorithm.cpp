@@ -26,8 +26,13 @@
 // Libraries
 #include "SphereVsConvexPolyhedronAlgorithm.h"
 #include "GJK/GJKAlgorithm.h"
+#include "GJK/VoronoiSimplex.h"
+#include "EPA/EPAAlgorithm.h"
 #include "SAT/SATAlgorithm.h"
 #include "collision/NarrowPhaseInfo.h"
+#include "collision/shapes/BoxShape.h"
+#include "collision/shapes/SphereShape.h"
+#include "utils/Profiler.h"
 
 // We want to use the ReactPhysics3D namespace
 using namespace reactphysics3d;
@@ -46,8 +51,19 @@ bool SphereVsConvexPolyhedronAlgorithm::testCollision(NarrowPhaseInfo* narrowPha
     // Get the last frame collision info
     LastFrameCollisionInfo* lastFrameCollisionInfo = narrowPhaseInfo->getLastFrameCollisionInfo();
 
+    // The contact with a box is computed without GJK and SAT
+    if (narrowPhaseInfo->collisionShape1->getName() == CollisionShapeName::BOX ||
+        narrowPhaseInfo->collisionShape2->getName() == CollisionShapeName::BOX) {
+
+        lastFrameCollisionInfo->wasUsingGJK = false;
+        lastFrameCollisionInfo->wasUsingSAT = false;
+
+        return testCollisionSphereVsBox(narrowPhaseInfo, reportContacts);
+    }
+
     // First, we run the GJK algorithm
     GJKAlgorithm gjkAlgorithm;
+    gjkAlgorithm.setIsSimplexWarmStartEnabled(mIsGJKSimplexWarmStartEnabled);
 
 #ifdef IS_PROFILING_ACTIVE
 
@@ -55,7 +71,10 @@ bool SphereVsConvexPolyhedronAlgorithm::testCollision(NarrowPhaseInfo* narrowPha
 
 #endif
 
-    GJKAlgorithm::GJKResult result = gjkAlgorithm.testCollision(narrowPhaseInfo, reportContacts);
+    // Final simplex of the GJK algorithm (used by the EPA algorithm)
+    VoronoiSimplex simplex;
+
+    GJKAlgorithm::GJKResult result = gjkAlgorithm.testCollision(narrowPhaseInfo, reportContacts, simplex);
 
     lastFrameCollisionInfo->wasUsingGJK = true;
     lastFrameCollisionInfo->wasUsingSAT = false;
@@ -70,6 +89,23 @@ bool SphereVsConvexPolyhedronAlgorithm::testCollision(NarrowPhaseInfo* narrowPha
     // If we have overlap even without the margins (deep penetration)
     if (result == GJKAlgorithm::GJKResult::INTERPENETRATE) {
 
+        // Compute the penetration depth with the EPA algorithm if it is enabled (we only
+        // run the SAT algorithm if the polytope of EPA is degenerate)
+        if (mIsEPAEnabled) {
+
+            EPAAlgorithm epaAlgorithm(memoryAllocator);
+
+#ifdef IS_PROFILING_ACTIVE
+
+            epaAlgorithm.setProfiler(mProfiler);
+
+#endif
+
+            if (epaAlgorithm.testCollision(narrowPhaseInfo, simplex, reportContacts)) {
+                return true;
+            }
+        }
+
         // Run the SAT algorithm to find the separating axis and compute contact point
         SATAlgorithm satAlgorithm(memoryAllocator);
 
@@ -89,3 +125,213 @@ bool SphereVsConvexPolyhedronAlgorithm::testCollision(NarrowPhaseInfo* narrowPha
 
     return false;
 }
+
+// Compute the narrow-phase collision detection between a sphere and a box
+/// The closest point of the box to the sphere center is the center clamped into the box.
+/// If the center is inside the box, the contact normal is the normal of the closest face.
+bool SphereVsConvexPolyhedronAlgorithm::testCollisionSphereVsBox(NarrowPhaseInfo* narrowPhaseInfo,
+                                                                 bool reportContacts) const {
+
+    RP3D_PROFILE("SphereVsConvexPolyhedronAlgorithm::testCollisionSphereVsBox()", mProfiler);
+
+    const bool isSphereShape1 = narrowPhaseInfo->collisionShape1->getType() == CollisionShapeType::SPHERE;
+    const SphereShape* sphere = static_cast<const SphereShape*>(isSphereShape1 ? narrowPhaseInfo->collisionShape1 :
+                                                                                 narrowPhaseInfo->collisionShape2);
+    const BoxShape* box = static_cast<const BoxShape*>(isSphereShape1 ? narrowPhaseInfo->collisionShape2 :
+                                                                        narrowPhaseInfo->collisionShape1);
+    const Transform& sphereToWorld = isSphereShape1 ? narrowPhaseInfo->shape1ToWorldTransform :
+                                                      narrowPhaseInfo->shape2ToWorldTransform;
+    const Transform& boxToWorld = isSphereShape1 ? narrowPhaseInfo->shape2ToWorldTransform :
+                                                   narrowPhaseInfo->shape1ToWorldTransform;
+
+    const decimal radius = sphere->getRadius();
+    const Vector3 extent = box->getExtent();
+
+    // Compute the sphere center in the local-space of the box
+    const Vector3 center = boxToWorld.getInverse() * sphereToWorld.getPosition();
+
+    // Clamp the center into the box
+    const Vector3 closestPoint(std::max(-extent.x, std::min(center.x, extent.x)),
+                               std::max(-extent.y, std::min(center.y, extent.y)),
+                               std::max(-extent.z, std::min(center.z, extent.z)));
+
+    Vector3 normalBoxSpace;             // Contact normal from the box toward the sphere
+    Vector3 contactPointBox;
+    decimal penetrationDepth;
+
+    const Vector3 centerToBox = center - closestPoint;
+    const decimal distanceSquare = centerToBox.lengthSquare();
+
+    // If the center is outside the box
+    if (distanceSquare > MACHINE_EPSILON) {
+
+        if (distanceSquare >= radius * radius) return false;
+
+        if (!reportContacts) return true;
+
+        const decimal distance = std::sqrt(distanceSquare);
+        normalBoxSpace = centerToBox / distance;
+        contactPointBox = closestPoint;
+        penetrationDepth = radius - distance;
+    }
+    else {  // If the center is inside the box, we push the sphere out of the closest face
+
+        if (!reportContacts) return true;
+
+        const Vector3 distancesToFaces = extent - center.getAbsoluteVector();
+        const int axis = distancesToFaces.getMinAxis();
+        const decimal sign = center[axis] >= decimal(0.0) ? decimal(1.0) : decimal(-1.0);
+
+        normalBoxSpace.setToZero();
+        normalBoxSpace[axis] = sign;
+        contactPointBox = center;
+        contactPointBox[axis] = sign * extent[axis];
+        penetrationDepth = radius + distancesToFaces[axis];
+    }
+
+    addSphereVsBoxContactPoint(narrowPhaseInfo, center, normalBoxSpace, contactPointBox, penetrationDepth);
+
+    return true;
+}
+
+// Add the contact point between a sphere and a box (computed in the local-space of the box)
+/**
+ * @param narrowPhaseInfo Narrow-phase info of the sphere and the box
+ * @param center Center of the sphere in the local-space of the box
+ * @param normalBoxSpace Contact normal from the box toward the sphere in the local-space of the box
+ * @param contactPointBox Contact point on the box in the local-space of the box
+ * @param penetrationDepth Penetration depth of the contact
+ */
+void SphereVsConvexPolyhedronAlgorithm::addSphereVsBoxContactPoint(NarrowPhaseInfo* narrowPhaseInfo,
+                                                                   const Vector3& center,
+                                                                   const Vector3& normalBoxSpace,
+                                                                   const Vector3& contactPointBox,
+                                                                   decimal penetrationDepth) const {
+
+    const bool isSphereShape1 = narrowPhaseInfo->collisionShape1->getType() == CollisionShapeType::SPHERE;
+    const SphereShape* sphere = static_cast<const SphereShape*>(isSphereShape1 ? narrowPhaseInfo->collisionShape1 :
+                                                                                 narrowPhaseInfo->collisionShape2);
+    const Transform& sphereToWorld = isSphereShape1 ? narrowPhaseInfo->shape1ToWorldTransform :
+                                                      narrowPhaseInfo->shape2ToWorldTransform;
+    const Transform& boxToWorld = isSphereShape1 ? narrowPhaseInfo->shape2ToWorldTransform :
+                                                   narrowPhaseInfo->shape1ToWorldTransform;
+    const decimal radius = sphere->getRadius();
+
+    // Compute the contact point on the sphere in the local-space of the sphere
+    const Transform boxToSphere = sphereToWorld.getInverse() * boxToWorld;
+    const Vector3 contactPointSphere = boxToSphere * (center - radius * normalBoxSpace);
+
+    // The contact normal goes from the first shape toward the second one
+    Vector3 normalWorld = boxToWorld.getOrientation() * normalBoxSpace;
+    if (isSphereShape1) normalWorld = -normalWorld;
+
+    narrowPhaseInfo->addContactPoint(normalWorld, penetrationDepth,
+                                     isSphereShape1 ? contactPointSphere : contactPointBox,
+                                     isSphereShape1 ? contactPointBox : contactPointSphere);
+
+}
+
+// Compute the contact infos of a batch of narrow-phase infos
+/// The closest points of the boxes to the centers of the spheres are computed by the batch
+/// kernel for a group of pairs at once. The separated pairs (most of the pairs of a large number
+/// of small debris) are then rejected without any other work and the contact points of the pairs
+/// whose sphere center is outside the box are created from the closest points. The pairs whose
+/// sphere center is inside the box and the pairs with a polyhedron that is not a box are tested
+/// one by one.
+void SphereVsConvexPolyhedronAlgorithm::testCollisionBatch(NarrowPhaseInfo** narrowPhaseInfos, bool* isColliding,
+                                                           uint nbNarrowPhaseInfos, bool reportContacts,
+                                                           MemoryAllocator& memoryAllocator) {
+
+    SphereBoxPairLanes lanes;
+    bool isBoxLane[NB_NARROW_PHASE_LANES];
+    decimal sphereRadius[NB_NARROW_PHASE_LANES];
+
+    for (uint startIndex=0; startIndex < nbNarrowPhaseInfos; startIndex += NB_NARROW_PHASE_LANES) {
+
+        const uint nbRemainingInfos = nbNarrowPhaseInfos - startIndex;
+        const uint nbLanes = nbRemainingInfos < NB_NARROW_PHASE_LANES ? nbRemainingInfos : NB_NARROW_PHASE_LANES;
+
+        // Copy the pairs of a sphere and a box of the group into the lanes
+        for (uint l=0; l < NB_NARROW_PHASE_LANES; l++) {
+
+            isBoxLane[l] = false;
+
+            if (l < nbLanes) {
+
+                const NarrowPhaseInfo* narrowPhaseInfo = narrowPhaseInfos[startIndex + l];
+
+                const bool isSphereShape1 = narrowPhaseInfo->collisionShape1->getType() == CollisionShapeType::SPHERE;
+                const CollisionShape* polyhedron = isSphereShape1 ? narrowPhaseInfo->collisionShape2 :
+                                                                    narrowPhaseInfo->collisionShape1;
+                isBoxLane[l] = polyhedron->getName() == CollisionShapeName::BOX;
+
+                if (isBoxLane[l]) {
+
+                    const SphereShape* sphere = static_cast<const SphereShape*>(isSphereShape1 ? narrowPhaseInfo->collisionShape1 :
+                                                                                                 narrowPhaseInfo->collisionShape2);
+                    const Transform& sphereToWorld = isSphereShape1 ? narrowPhaseInfo->shape1ToWorldTransform :
+                                                                      narrowPhaseInfo->shape2ToWorldTransform;
+                    const Transform& boxToWorld = isSphereShape1 ? narrowPhaseInfo->shape2ToWorldTransform :
+                                                                   narrowPhaseInfo->shape1ToWorldTransform;
+
+                    lanes.sphereCenter.setLane(l, boxToWorld.getInverse() * sphereToWorld.getPosition());
+                    lanes.boxExtent.setLane(l, static_cast<const BoxShape*>(polyhedron)->getExtent());
+                    sphereRadius[l] = sphere->getRadius();
+                }
+            }
+
+            if (!isBoxLane[l]) {
+                lanes.sphereCenter.setLane(l, Vector3::zero());
+                lanes.boxExtent.setLane(l, Vector3::zero());
+                sphereRadius[l] = decimal(0.0);
+            }
+        }
+
+        computeClosestPointLanes(lanes);
+
+        // Create the contact points of the intersecting shapes
+        for (uint l=0; l < nbLanes; l++) {
+
+            NarrowPhaseInfo* narrowPhaseInfo = narrowPhaseInfos[startIndex + l];
+
+            // The polyhedra that are not boxes are tested with GJK and SAT
+            if (!isBoxLane[l]) {
+                isColliding[startIndex + l] = testCollision(narrowPhaseInfo, reportContacts, memoryAllocator);
+                continue;
+            }
+
+            LastFrameCollisionInfo* lastFrameCollisionInfo = narrowPhaseInfo->getLastFrameCollisionInfo();
+            lastFrameCollisionInfo->wasUsingGJK = false;
+            lastFrameCollisionInfo->wasUsingSAT = false;
+
+            const decimal distanceSquare = lanes.distanceSquare[l];
+
+            // If the center of the sphere is inside the box
+            if (distanceSquare <= MACHINE_EPSILON) {
+                isColliding[startIndex + l] = testCollisionSphereVsBox(narrowPhaseInfo, reportContacts);
+                continue;
+            }
+
+            isColliding[startIndex + l] = distanceSquare < sphereRadius[l] * sphereRadius[l];
+
+            if (reportContacts && isColliding[startIndex + l]) {
+
+                const Vector3 center = lanes.sphereCenter.getLane(l);
+                const Vector3 closestPoint = lanes.closestPoint.getLane(l);
+                const decimal distance = std::sqrt(distanceSquare);
+                addSphereVsBoxContactPoint(narrowPhaseInfo, center, (center - closestPoint) / distance, closestPoint,
+                                           sphereRadius[l] - distance);
+            }
+        }
+    }
+}
+
+// Compute the closest points of the boxes to the centers of the spheres of all the lanes
+/// The closest point is the center of the sphere clamped into the box.
+void SphereVsConvexPolyhedronAlgorithm::computeClosestPointLanes(SphereBoxPairLanes& lanes) {
+
+    lanes.closestPoint.x = LanesN::max(-lanes.boxExtent.x, LanesN::min(lanes.sphereCenter.x, lanes.boxExtent.x));
+    lanes.closestPoint.y = LanesN::max(-lanes.boxExtent.y, LanesN::min(lanes.sphereCenter.y, lanes.boxExtent.y));
+    lanes.closestPoint.z = LanesN::max(-lanes.boxExtent.z, LanesN::min(lanes.sphereCenter.z, lanes.boxExtent.z));
+    lanes.distanceSquare = (lanes.sphereCenter - lanes.closestPoint).lengthSquare();
+}
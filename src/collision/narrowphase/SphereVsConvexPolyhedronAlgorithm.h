@@ -28,6 +28,7 @@
 
 // Libraries
 #include "NarrowPhaseAlgorithm.h"
+#include "mathematics/Vector3Lanes.h"
 
 /// Namespace ReactPhysics3D
 namespace reactphysics3d {
@@ -48,12 +49,55 @@ class Body;
  * (the center of the sphere is inside the polyhedron) we run the SAT
  * algorithm to get the contact point and contact normal.
  * This is based on the "Robust Contact Creation for Physics Simulation"
- * presentation by Dirk Gregorius.
+ * presentation by Dirk Gregorius. When the polyhedron is a box, the contact
+ * is directly computed by clamping the sphere center into the box. A batch of
+ * pairs of a sphere and a box is tested with a kernel that computes the closest
+ * points of several pairs at once (one pair per lane).
  */
 class SphereVsConvexPolyhedronAlgorithm : public NarrowPhaseAlgorithm {
 
     protected :
 
+        /// Lanes of the narrow-phase batch kernels
+        using LanesN = Lanes<decimal, NB_NARROW_PHASE_LANES>;
+
+        /// 3D vectors of the narrow-phase batch kernels
+        using Vector3N = Vector3Lanes<decimal, NB_NARROW_PHASE_LANES>;
+
+        // Structure SphereBoxPairLanes
+        /**
+         * Pairs of a sphere and a box tested together by the batch kernel (one pair per lane)
+         * in a structure of arrays. All the vectors are in the local-space of the boxes. The
+         * unused lanes (and the lanes of the polyhedra that are not boxes) are filled with zeros.
+         */
+        struct SphereBoxPairLanes {
+
+            /// Centers of the spheres
+            Vector3N sphereCenter;
+
+            /// Half-extents of the boxes
+            Vector3N boxExtent;
+
+            /// Output: points of the boxes that are the closest to the centers of the spheres
+            Vector3N closestPoint;
+
+            /// Output: squared distances between the centers of the spheres and the closest points
+            LanesN distanceSquare;
+        };
+
+        // -------------------- Methods -------------------- //
+
+        /// Compute the closest points of the boxes to the centers of the spheres of all the lanes
+        static void computeClosestPointLanes(SphereBoxPairLanes& lanes);
+
+        /// Compute the narrow-phase collision detection between a sphere and a box
+        bool testCollisionSphereVsBox(NarrowPhaseInfo* narrowPhaseInfo, bool reportContacts) const;
+
+        /// Add the contact point between a sphere and a box (computed in the local-space of the box)
+        void addSphereVsBoxContactPoint(NarrowPhaseInfo* narrowPhaseInfo, const Vector3& center,
+                                        const Vector3& normalBoxSpace, const Vector3& contactPointBox,
+                                        decimal penetrationDepth) const;
+
     public :
 
         // -------------------- Methods -------------------- //
@@ -72,6 +116,11 @@ class SphereVsConvexPolyhedronAlgorithm : public NarrowPhaseAlgorithm {
 
         /// Compute the narrow-phase collision detection between a sphere and a convex polyhedron
         virtual bool testCollision(NarrowPhaseInfo* narrowPhaseInfo, bool reportContacts, MemoryAllocator& memoryAllocator) override;
+
+        /// Compute the contact infos of a batch of narrow-phase infos
+        virtual void testCollisionBatch(NarrowPhaseInfo** narrowPhaseInfos, bool* isColliding,
+                                        uint nbNarrowPhaseInfos, bool reportContacts,
+                                        MemoryAllocator& memoryAllocator) override;
 };
 
 }
@@ -1,91 +1,184 @@
-/********************************************************************************
-* ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
-* Copyright (c) 2010-2018 Daniel Chappuis                                       *
-*********************************************************************************
-*                                                                               *
-* This software is provided 'as-is', without any express or implied warranty.   *
-* In no event will the authors be held liable for any damages arising from the  *
-* use of this software.                                                         *
-*                                                                               *
-* Permission is granted to anyone to use this software for any purpose,         *
-* including commercial applications, and to alter it and redistribute it        *
-* freely, subject to the following restrictions:                                *
-*                                                                               *
-* 1. The origin of this software must not be misrepresented; you must not claim *
-*    that you wrote the original software. If you use this software in a        *
-*    product, an acknowledgment in the product documentation would be           *
-*    appreciated but is not required.                                           *
-*                                                                               *
-* 2. Altered source versions must be plainly marked as such, and must not be    *
-*    misrepresented as being the original software.                             *
-*                                                                               *
-* 3. This notice may not be removed or altered from any source distribution.    *
-*                                                                               *
-********************************************************************************/
-
-// Libraries
-#include "SphereVsSphereAlgorithm.h"
-#include "collision/shapes/SphereShape.h"
-#include "collision/NarrowPhaseInfo.h"
-
-// We want to use the ReactPhysics3D namespace
-using namespace reactphysics3d;  
-
-bool SphereVsSphereAlgorithm::testCollision(NarrowPhaseInfo* narrowPhaseInfo, bool reportContacts,
-                                            MemoryAllocator& memoryAllocator) {
-    
-    assert(narrowPhaseInfo->collisionShape1->getType() == CollisionShapeType::SPHERE);
-    assert(narrowPhaseInfo->collisionShape2->getType() == CollisionShapeType::SPHERE);
-
-    // Get the sphere collision shapes
-    const SphereShape* sphereShape1 = static_cast<const SphereShape*>(narrowPhaseInfo->collisionShape1);
-    const SphereShape* sphereShape2 = static_cast<const SphereShape*>(narrowPhaseInfo->collisionShape2);
-
-    // Get the local-space to world-space transforms
-    const Transform& transform1 = narrowPhaseInfo->shape1ToWorldTransform;
-    const Transform& transform2 = narrowPhaseInfo->shape2ToWorldTransform;
-
-    // Compute the distance between the centers
-    Vector3 vectorBetweenCenters = transform2.getPosition() - transform1.getPosition();
-    decimal squaredDistanceBetweenCenters = vectorBetweenCenters.lengthSquare();
-
-    // Compute the sum of the radius
-    decimal sumRadius = sphereShape1->getRadius() + sphereShape2->getRadius();
-    
-    // If the sphere collision shapes intersect
-    if (squaredDistanceBetweenCenters < sumRadius * sumRadius) {
-
-        if (reportContacts) {
-
-            Vector3 centerSphere2InBody1LocalSpace = transform1.getInverse() * transform2.getPosition();
-            Vector3 centerSphere1InBody2LocalSpace = transform2.getInverse() * transform1.getPosition();
-            decimal penetrationDepth = sumRadius - std::sqrt(squaredDistanceBetweenCenters);
-			Vector3 intersectionOnBody1;
-			Vector3 intersectionOnBody2;
-			Vector3 normal;
-
-			// If the two sphere centers are not at the same position
-			if (squaredDistanceBetweenCenters > MACHINE_EPSILON) {
-
-				intersectionOnBody1 = sphereShape1->getRadius() * centerSphere2InBody1LocalSpace.getUnit();
-				intersectionOnBody2 = sphereShape2->getRadius() * centerSphere1InBody2LocalSpace.getUnit();
-				normal = vectorBetweenCenters.getUnit();
-			}
-			else {    // If the sphere centers are at the same position (degenerate case)
-
-				// Take any contact normal direction
-				normal.setAllValues(0, 1, 0);
-
-				intersectionOnBody1 = sphereShape1->getRadius() * (transform1.getInverse().getOrientation() * normal);
-				intersectionOnBody2 = sphereShape2->getRadius() * (transform2.getInverse().getOrientation() * normal);
-			}			
-            
-			// Create the contact info object
-            narrowPhaseInfo->addContactPoint(normal, penetrationDepth, intersectionOnBody1, intersectionOnBody2);
-        }
-
-        return true;
-    }
-
-    return false;
-}
+/********************************************************************************
+* ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
+* Copyright (c) 2010-2018 Daniel Chappuis                                       *
+*********************************************************************************
+*                                                                               *
+* This software is provided 'as-is', without any express or implied warranty.   *
+* In no event will the authors be held liable for any damages arising from the  *
+* use of this software.                                                         *
+*                                                                               *
+* Permission is granted to anyone to use this software for any purpose,         *
+* including commercial applications, and to alter it and redistribute it        *
+* freely, subject to the following restrictions:                                *
+*                                                                               *
+* 1. The origin of this software must not be misrepresented; you must not claim *
+*    that you wrote the original software. If you use this software in a        *
+*    product, an acknowledgment in the product documentation would be           *
+*    appreciated but is not required.                                           *
+*                                                                               *
+* 2. Altered source versions must be plainly marked as such, and must not be    *
+*    misrepresented as being the original software.                             *
+*                                                                               *
+* 3. This notice may not be removed or altered from any source distribution.    *
+*                                                                               *
+********************************************************************************/
+
+// Libraries
+#include "SphereVsSphereAlgorithm.h"
+#include "collision/shapes/SphereShape.h"
+#include "collision/NarrowPhaseInfo.h"
+
+// We want to use the ReactPhysics3D namespace
+using namespace reactphysics3d;  
+
+bool SphereVsSphereAlgorithm::testCollision(NarrowPhaseInfo* narrowPhaseInfo, bool reportContacts,
+                                            MemoryAllocator& memoryAllocator) {
+    
+    assert(narrowPhaseInfo->collisionShape1->getType() == CollisionShapeType::SPHERE);
+    assert(narrowPhaseInfo->collisionShape2->getType() == CollisionShapeType::SPHERE);
+
+    // Get the sphere collision shapes
+    const SphereShape* sphereShape1 = static_cast<const SphereShape*>(narrowPhaseInfo->collisionShape1);
+    const SphereShape* sphereShape2 = static_cast<const SphereShape*>(narrowPhaseInfo->collisionShape2);
+
+    // Compute the distance between the centers
+    Vector3 vectorBetweenCenters = narrowPhaseInfo->shape2ToWorldTransform.getPosition() -
+                                   narrowPhaseInfo->shape1ToWorldTransform.getPosition();
+    decimal squaredDistanceBetweenCenters = vectorBetweenCenters.lengthSquare();
+
+    // Compute the sum of the radius
+    decimal sumRadius = sphereShape1->getRadius() + sphereShape2->getRadius();
+    
+    // If the sphere collision shapes intersect
+    if (squaredDistanceBetweenCenters < sumRadius * sumRadius) {
+
+        if (reportContacts) {
+            addContactPoint(narrowPhaseInfo, vectorBetweenCenters, squaredDistanceBetweenCenters, sumRadius);
+        }
+
+        return true;
+    }
+
+    return false;
+}
+
+// Compute the contact infos of a batch of narrow-phase infos
+/// The pairs of spheres are tested by groups of NB_NARROW_PHASE_LANES pairs. The centers and
+/// the radii of a group are copied into a structure of arrays and the contacts of the whole
+/// group are computed by a kernel without branches that the compiler can turn into SIMD
+/// instructions. The contact points are then created for the intersecting spheres.
+void SphereVsSphereAlgorithm::testCollisionBatch(NarrowPhaseInfo** narrowPhaseInfos, bool* isColliding,
+                                                 uint nbNarrowPhaseInfos, bool reportContacts,
+                                                 MemoryAllocator& memoryAllocator) {
+
+    SpherePairLanes lanes;
+
+    for (uint startIndex=0; startIndex < nbNarrowPhaseInfos; startIndex += NB_NARROW_PHASE_LANES) {
+
+        const uint nbRemainingInfos = nbNarrowPhaseInfos - startIndex;
+        const uint nbLanes = nbRemainingInfos < NB_NARROW_PHASE_LANES ? nbRemainingInfos : NB_NARROW_PHASE_LANES;
+
+        // Copy the spheres of the group into the lanes
+        for (uint l=0; l < NB_NARROW_PHASE_LANES; l++) {
+
+            if (l < nbLanes) {
+
+                const NarrowPhaseInfo* narrowPhaseInfo = narrowPhaseInfos[startIndex + l];
+
+                assert(narrowPhaseInfo->collisionShape1->getType() == CollisionShapeType::SPHERE);
+                assert(narrowPhaseInfo->collisionShape2->getType() == CollisionShapeType::SPHERE);
+
+                lanes.center1.setLane(l, narrowPhaseInfo->shape1ToWorldTransform.getPosition());
+                lanes.center2.setLane(l, narrowPhaseInfo->shape2ToWorldTransform.getPosition());
+                lanes.radius1[l] = static_cast<const SphereShape*>(narrowPhaseInfo->collisionShape1)->getRadius();
+                lanes.radius2[l] = static_cast<const SphereShape*>(narrowPhaseInfo->collisionShape2)->getRadius();
+            }
+            else {
+                lanes.center1.setLane(l, Vector3::zero());
+                lanes.center2.setLane(l, Vector3::zero());
+                lanes.radius1[l] = decimal(0.0);
+                lanes.radius2[l] = decimal(0.0);
+            }
+        }
+
+        computeContactLanes(lanes);
+
+        // Create the contact points of the intersecting spheres
+        for (uint l=0; l < nbLanes; l++) {
+
+            isColliding[startIndex + l] = lanes.isColliding[l];
+
+            if (reportContacts && lanes.isColliding[l]) {
+
+                NarrowPhaseInfo* narrowPhaseInfo = narrowPhaseInfos[startIndex + l];
+
+                narrowPhaseInfo->addContactPoint(lanes.normal.getLane(l), lanes.penetrationDepth[l],
+                                                 narrowPhaseInfo->shape1ToWorldTransform.getInverse() * lanes.point1.getLane(l),
+                                                 narrowPhaseInfo->shape2ToWorldTransform.getInverse() * lanes.point2.getLane(l));
+            }
+        }
+    }
+}
+
+// Compute the contacts of the pairs of spheres of all the lanes
+/// If the centers of two spheres are at the same position, any normal direction is used.
+void SphereVsSphereAlgorithm::computeContactLanes(SpherePairLanes& lanes) {
+
+    const Vector3N vectorBetweenCenters = lanes.center2 - lanes.center1;
+    const LanesN squaredDistance = vectorBetweenCenters.lengthSquare();
+    const LanesN sumRadius = lanes.radius1 + lanes.radius2;
+    const LanesN distance = squaredDistance.getSquareRoot();
+
+    // Contact normal (the Y axis in the degenerate case)
+    const LaneMask<NB_NARROW_PHASE_LANES> isDegenerate = squaredDistance <= LanesN(MACHINE_EPSILON);
+    const LanesN inverseDistance = select(isDegenerate, LanesN(decimal(0.0)), LanesN(decimal(1.0)) / distance);
+    lanes.normal = inverseDistance * vectorBetweenCenters;
+    lanes.normal.y = select(isDegenerate, LanesN(decimal(1.0)), lanes.normal.y);
+
+    // The contact point of the second sphere is on the side of the normal in the
+    // degenerate case (like in testCollision())
+    const LanesN signedRadius2 = select(isDegenerate, lanes.radius2, -lanes.radius2);
+
+    lanes.isColliding = squaredDistance < sumRadius * sumRadius;
+    lanes.penetrationDepth = sumRadius - distance;
+    lanes.point1 = lanes.center1 + lanes.radius1 * lanes.normal;
+    lanes.point2 = lanes.center2 + signedRadius2 * lanes.normal;
+}
+
+// Add the contact point between two intersecting spheres
+void SphereVsSphereAlgorithm::addContactPoint(NarrowPhaseInfo* narrowPhaseInfo, const Vector3& vectorBetweenCenters,
+                                              decimal squaredDistanceBetweenCenters, decimal sumRadius) const {
+
+    const SphereShape* sphereShape1 = static_cast<const SphereShape*>(narrowPhaseInfo->collisionShape1);
+    const SphereShape* sphereShape2 = static_cast<const SphereShape*>(narrowPhaseInfo->collisionShape2);
+
+    // Get the local-space to world-space transforms
+    const Transform& transform1 = narrowPhaseInfo->shape1ToWorldTransform;
+    const Transform& transform2 = narrowPhaseInfo->shape2ToWorldTransform;
+
+    Vector3 centerSphere2InBody1LocalSpace = transform1.getInverse() * transform2.getPosition();
+    Vector3 centerSphere1InBody2LocalSpace = transform2.getInverse() * transform1.getPosition();
+    decimal penetrationDepth = sumRadius - std::sqrt(squaredDistanceBetweenCenters);
+    Vector3 intersectionOnBody1;
+    Vector3 intersectionOnBody2;
+    Vector3 normal;
+
+    // If the two sphere centers are not at the same position
+    if (squaredDistanceBetweenCenters > MACHINE_EPSILON) {
+
+        intersectionOnBody1 = sphereShape1->getRadius() * centerSphere2InBody1LocalSpace.getUnit();
+        intersectionOnBody2 = sphereShape2->getRadius() * centerSphere1InBody2LocalSpace.getUnit();
+        normal = vectorBetweenCenters.getUnit();
+    }
+    else {    // If the sphere centers are at the same position (degenerate case)
+
+        // Take any contact normal direction
+        normal.setAllValues(0, 1, 0);
+
+        intersectionOnBody1 = sphereShape1->getRadius() * (transform1.getInverse().getOrientation() * normal);
+        intersectionOnBody2 = sphereShape2->getRadius() * (transform2.getInverse().getOrientation() * normal);
+    }
+
+    // Create the contact info object
+    narrowPhaseInfo->addContactPoint(normal, penetrationDepth, intersectionOnBody1, intersectionOnBody2);
+}
@@ -1,74 +1,131 @@
-/********************************************************************************
-* ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
-* Copyright (c) 2010-2018 Daniel Chappuis                                       *
-*********************************************************************************
-*                                                                               *
-* This software is provided 'as-is', without any express or implied warranty.   *
-* In no event will the authors be held liable for any damages arising from the  *
-* use of this software.                                                         *
-*                                                                               *
-* Permission is granted to anyone to use this software for any purpose,         *
-* including commercial applications, and to alter it and redistribute it        *
-* freely, subject to the following restrictions:                                *
-*                                                                               *
-* 1. The origin of this software must not be misrepresented; you must not claim *
-*    that you wrote the original software. If you use this software in a        *
-*    product, an acknowledgment in the product documentation would be           *
-*    appreciated but is not required.                                           *
-*                                                                               *
-* 2. Altered source versions must be plainly marked as such, and must not be    *
-*    misrepresented as being the original software.                             *
-*                                                                               *
-* 3. This notice may not be removed or altered from any source distribution.    *
-*                                                                               *
-********************************************************************************/
-
-#ifndef REACTPHYSICS3D_SPHERE_VS_SPHERE_ALGORITHM_H
-#define	REACTPHYSICS3D_SPHERE_VS_SPHERE_ALGORITHM_H
-
-// Libraries
-#include "NarrowPhaseAlgorithm.h"
-
-/// Namespace ReactPhysics3D
-namespace reactphysics3d {
-
-// Declarations
-class ContactPoint;
-class Body;
-
-// Class SphereVsSphereAlgorithm
-/**
- * This class is used to compute the narrow-phase collision detection
- * between two sphere collision shapes. This algorithm finds the contact
- * point and contact normal between two spheres if they are colliding.
- * This case is simple, we do not need to use GJK or SAT algorithm. We
- * directly compute the contact points if any.
- */
-class SphereVsSphereAlgorithm : public NarrowPhaseAlgorithm {
-
-    protected :
-
-    public :
-
-        // -------------------- Methods -------------------- //
-
-        /// Constructor
-        SphereVsSphereAlgorithm() = default;
-
-        /// Destructor
-        virtual ~SphereVsSphereAlgorithm() override = default;
-
-        /// Deleted copy-constructor
-        SphereVsSphereAlgorithm(const SphereVsSphereAlgorithm& algorithm) = delete;
-
-        /// Deleted assignment operator
-        SphereVsSphereAlgorithm& operator=(const SphereVsSphereAlgorithm& algorithm) = delete;
-
-        /// Compute a contact info if the two bounding volume collide
-        virtual bool testCollision(NarrowPhaseInfo* narrowPhaseInfo, bool reportContacts, MemoryAllocator& memoryAllocator) override;
-};
-
-}
-
-#endif
-
+/********************************************************************************
+* ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
+* Copyright (c) 2010-2018 Daniel Chappuis                                       *
+*********************************************************************************
+*                                                                               *
+* This software is provided 'as-is', without any express or implied warranty.   *
+* In no event will the authors be held liable for any damages arising from the  *
+* use of this software.                                                         *
+*                                                                               *
+* Permission is granted to anyone to use this software for any purpose,         *
+* including commercial applications, and to alter it and redistribute it        *
+* freely, subject to the following restrictions:                                *
+*                                                                               *
+* 1. The origin of this software must not be misrepresented; you must not claim *
+*    that you wrote the original software. If you use this software in a        *
+*    product, an acknowledgment in the product documentation would be           *
+*    appreciated but is not required.                                           *
+*                                                                               *
+* 2. Altered source versions must be plainly marked as such, and must not be    *
+*    misrepresented as being the original software.                             *
+*                                                                               *
+* 3. This notice may not be removed or altered from any source distribution.    *
+*                                                                               *
+********************************************************************************/
+
+#ifndef REACTPHYSICS3D_SPHERE_VS_SPHERE_ALGORITHM_H
+#define	REACTPHYSICS3D_SPHERE_VS_SPHERE_ALGORITHM_H
+
+// Libraries
+#include "NarrowPhaseAlgorithm.h"
+#include "mathematics/Vector3.h"
+#include "mathematics/Vector3Lanes.h"
+
+/// Namespace ReactPhysics3D
+namespace reactphysics3d {
+
+// Declarations
+class ContactPoint;
+class Body;
+
+// Class SphereVsSphereAlgorithm
+/**
+ * This class is used to compute the narrow-phase collision detection
+ * between two sphere collision shapes. This algorithm finds the contact
+ * point and contact normal between two spheres if they are colliding.
+ * This case is simple, we do not need to use GJK or SAT algorithm. We
+ * directly compute the contact points if any.
+ */
+class SphereVsSphereAlgorithm : public NarrowPhaseAlgorithm {
+
+    protected :
+
+        /// Lanes of the narrow-phase batch kernels
+        using LanesN = Lanes<decimal, NB_NARROW_PHASE_LANES>;
+
+        /// 3D vectors of the narrow-phase batch kernels
+        using Vector3N = Vector3Lanes<decimal, NB_NARROW_PHASE_LANES>;
+
+        // Structure SpherePairLanes
+        /**
+         * Pairs of spheres tested together by the batch kernel (one pair per lane) in a
+         * structure of arrays. The unused lanes are filled with zeros.
+         */
+        struct SpherePairLanes {
+
+            /// World-space centers of the first spheres
+            Vector3N center1;
+
+            /// World-space centers of the second spheres
+            Vector3N center2;
+
+            /// Radii of the first spheres
+            LanesN radius1;
+
+            /// Radii of the second spheres
+            LanesN radius2;
+
+            /// Output: true if the spheres are intersecting
+            LaneMask<NB_NARROW_PHASE_LANES> isColliding;
+
+            /// Output: world-space contact normal (from sphere 1 to sphere 2)
+            Vector3N normal;
+
+            /// Output: penetration depth of the contact
+            LanesN penetrationDepth;
+
+            /// Output: world-space contact point on the first sphere
+            Vector3N point1;
+
+            /// Output: world-space contact point on the second sphere
+            Vector3N point2;
+        };
+
+        // -------------------- Methods -------------------- //
+
+        /// Compute the contacts of the pairs of spheres of all the lanes
+        static void computeContactLanes(SpherePairLanes& lanes);
+
+        /// Add the contact point between two intersecting spheres
+        void addContactPoint(NarrowPhaseInfo* narrowPhaseInfo, const Vector3& vectorBetweenCenters,
+                             decimal squaredDistanceBetweenCenters, decimal sumRadius) const;
+
+    public :
+
+        // -------------------- Methods -------------------- //
+
+        /// Constructor
+        SphereVsSphereAlgorithm() = default;
+
+        /// Destructor
+        virtual ~SphereVsSphereAlgorithm() override = default;
+
+        /// Deleted copy-constructor
+        SphereVsSphereAlgorithm(const SphereVsSphereAlgorithm& algorithm) = delete;
+
+        /// Deleted assignment operator
+        SphereVsSphereAlgorithm& operator=(const SphereVsSphereAlgorithm& algorithm) = delete;
+
+        /// Compute a contact info if the two bounding volume collide
+        virtual bool testCollision(NarrowPhaseInfo* narrowPhaseInfo, bool reportContacts, MemoryAllocator& memoryAllocator) override;
+
+        /// Compute the contact infos of a batch of narrow-phase infos
+        virtual void testCollisionBatch(NarrowPhaseInfo** narrowPhaseInfos, bool* isColliding,
+                                        uint nbNarrowPhaseInfos, bool reportContacts,
+                                        MemoryAllocator& memoryAllocator) override;
+};
+
+}
+
+#endif
+
@@ -88,12 +88,18 @@ class AABB {
         /// Inflate each side of the AABB by a given size
         void inflate(decimal dx, decimal dy, decimal dz);
 
+        /// Move the AABB by a given translation
+        void translate(const Vector3& translation);
+
         /// Return true if the current AABB is overlapping with the AABB in argument
         bool testCollision(const AABB& aabb) const;
 
         /// Return the volume of the AABB
         decimal getVolume() const;
 
+        /// Return the surface area of the AABB
+        decimal getSurfaceArea() const;
+
         /// Merge the AABB in parameter with the current one
         void mergeWithAABB(const AABB& aabb);
 
@@ -112,6 +118,11 @@ class AABB {
         /// Return true if the ray intersects the AABB
         bool testRayIntersect(const Ray& ray) const;
 
+        /// Return for each lane of a packet of rays true if the ray intersects the AABB
+        template<uint N>
+        LaneMask<N> testRayIntersect(const Vector3Lanes<decimal, N>& points1,
+                                     const Vector3Lanes<decimal, N>& points2) const;
+
         /// Create and return an AABB for a triangle
         static AABB createAABBForTriangle(const Vector3* trianglePoints);
 
@@ -159,6 +170,12 @@ inline void AABB::inflate(decimal dx, decimal dy, decimal dz) {
     mMinCoordinates -= Vector3(dx, dy, dz);
 }
 
+// Move the AABB by a given translation
+inline void AABB::translate(const Vector3& translation) {
+    mMinCoordinates += translation;
+    mMaxCoordinates += translation;
+}
+
 // Return true if the current AABB is overlapping with the AABB in argument.
 /// Two AABBs overlap if they overlap in the three x, y and z axis at the same time
 inline bool AABB::testCollision(const AABB& aabb) const {
@@ -177,6 +194,12 @@ inline decimal AABB::getVolume() const {
     return (diff.x * diff.y * diff.z);
 }
 
+// Return the surface area of the AABB
+inline decimal AABB::getSurfaceArea() const {
+    const Vector3 diff = mMaxCoordinates - mMinCoordinates;
+    return decimal(2.0) * (diff.x * diff.y + diff.y * diff.z + diff.z * diff.x);
+}
+
 // Return true if the AABB of a triangle intersects the AABB
 inline bool AABB::testCollisionTriangleAABB(const Vector3* trianglePoints) const {
 
@@ -199,6 +222,44 @@ inline bool AABB::contains(const Vector3& point) const {
             point.z >= mMinCoordinates.z - MACHINE_EPSILON && point.z <= mMaxCoordinates.z + MACHINE_EPSILON);
 }
 
+// Return for each lane of a packet of rays true if the ray intersects the AABB
+/// This is the same separating axis test as testRayIntersect() done on the N rays of a
+/// packet at once. The second point of each lane is the end of the ray clipped at
+/// its max fraction.
+template<uint N>
+inline LaneMask<N> AABB::testRayIntersect(const Vector3Lanes<decimal, N>& points1,
+                                          const Vector3Lanes<decimal, N>& points2) const {
+
+    const Vector3 e = mMaxCoordinates - mMinCoordinates;
+    const Vector3 center2 = mMinCoordinates + mMaxCoordinates;
+    const Vector3Lanes<decimal, N> d = points2 - points1;
+    const Vector3Lanes<decimal, N> m = points1 + points2 - Vector3Lanes<decimal, N>(center2);
+
+    // Test if the AABB face normals are separating axis
+    Lanes<decimal, N> adx = d.x.getAbsoluteValue();
+    Lanes<decimal, N> ady = d.y.getAbsoluteValue();
+    Lanes<decimal, N> adz = d.z.getAbsoluteValue();
+    LaneMask<N> isSeparated = m.x.getAbsoluteValue() > Lanes<decimal, N>(e.x) + adx ||
+                              m.y.getAbsoluteValue() > Lanes<decimal, N>(e.y) + ady ||
+                              m.z.getAbsoluteValue() > Lanes<decimal, N>(e.z) + adz;
+
+    // Add in an epsilon term to counteract arithmetic errors when segment is
+    // (near) parallel to a coordinate axis
+    const Lanes<decimal, N> epsilon(decimal(0.00001));
+    adx += epsilon;
+    ady += epsilon;
+    adz += epsilon;
+
+    // Test if the cross products between face normals and ray direction are
+    // separating axis
+    isSeparated = isSeparated ||
+                  (m.y * d.z - m.z * d.y).getAbsoluteValue() > e.y * adz + e.z * ady ||
+                  (m.z * d.x - m.x * d.z).getAbsoluteValue() > e.x * adz + e.z * adx ||
+                  (m.x * d.y - m.y * d.x).getAbsoluteValue() > e.x * ady + e.y * adx;
+
+    return !isSeparated;
+}
+
 // Assignment operator
 inline AABB& AABB::operator=(const AABB& aabb) {
     if (this != &aabb) {
@@ -79,6 +79,9 @@ BoxShape::BoxShape(const Vector3& extent)
     mHalfEdgeStructure.addFace(face5);
 
 	mHalfEdgeStructure.init();
+
+    // Cache the local bounds used to compute the AABBs of the shape
+    cacheLocalBounds();
 }
 
 // Return the local inertia tensor of the collision shape
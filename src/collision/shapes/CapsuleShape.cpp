@@ -41,6 +41,9 @@ CapsuleShape::CapsuleShape(decimal radius, decimal height)
             : ConvexShape(CollisionShapeName::CAPSULE, CollisionShapeType::CAPSULE, radius), mHalfHeight(height * decimal(0.5)) {
     assert(radius > decimal(0.0));
     assert(height > decimal(0.0));
+
+    // Cache the local bounds used to compute the AABBs of the shape
+    cacheLocalBounds();
 }
 
 // Return the local inertia tensor of the capsule
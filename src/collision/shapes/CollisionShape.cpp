@@ -33,7 +33,7 @@ using namespace reactphysics3d;
 
 // Constructor
 CollisionShape::CollisionShape(CollisionShapeName name, CollisionShapeType type)
-               : mType(type), mName(name), mId(0) {
+               : mType(type), mName(name), mId(0), mIsLocalBoundsCached(false) {
 
 #ifdef IS_PROFILING_ACTIVE
         mProfiler = nullptr;
@@ -41,9 +41,26 @@ CollisionShape::CollisionShape(CollisionShapeName name, CollisionShapeType type)
 
 }
 
+// Cache the local bounds of the shape to compute its AABBs faster
+/// This has to be called by the constructor of a shape (and each time its bounds change)
+/// once getLocalBounds() returns the final bounds of the shape. The AABBs of the shapes
+/// that do not cache their bounds are computed from getLocalBounds() each time.
+void CollisionShape::cacheLocalBounds() {
+
+    Vector3 minBounds;
+    Vector3 maxBounds;
+    getLocalBounds(minBounds, maxBounds);
+
+    mLocalBoundsCenter = decimal(0.5) * (minBounds + maxBounds);
+    mLocalBoundsHalfExtents = decimal(0.5) * (maxBounds - minBounds);
+    mIsLocalBoundsCached = true;
+}
+
 // Compute the world-space AABB of the collision shape given a transform from shape
-// local-space to world-space. The technique is described in the book Real-Time Collision
-// Detection by Christer Ericson.
+// local-space to world-space. The center of the local bounds is transformed and the
+// half-extents of the AABB are the half-extents of the local bounds multiplied by the
+// absolute values of the rotation matrix. The technique is described in the book
+// Real-Time Collision Detection by Christer Ericson.
 /**
  * @param[out] aabb The axis-aligned bounding box (AABB) of the collision shape
  *                  computed in world-space coordinates
@@ -54,39 +71,23 @@ void CollisionShape::computeAABB(AABB& aabb, const Transform& transform) const {
 
     RP3D_PROFILE("CollisionShape::computeAABB()", mProfiler);
 
-    // Get the local bounds in x,y and z direction
-    Vector3 minBounds;
-    Vector3 maxBounds;
-    getLocalBounds(minBounds, maxBounds);
-
-    const Vector3 translation = transform.getPosition();
-    Matrix3x3 matrix = transform.getOrientation().getMatrix();
-    Vector3 resultMin;
-    Vector3 resultMax;
-
-    // For each of the three axis
-    for (int i=0; i<3; i++) {
+    Vector3 center = mLocalBoundsCenter;
+    Vector3 halfExtents = mLocalBoundsHalfExtents;
 
-        // Add translation component
-        resultMin[i] = translation[i];
-        resultMax[i] = translation[i];
-
-        for (int j=0; j<3; j++) {
-            decimal e = matrix[i][j] * minBounds[j];
-            decimal f = matrix[i][j] * maxBounds[j];
-
-            if (e < f) {
-                resultMin[i] += e;
-                resultMax[i] += f;
-            }
-            else {
-                resultMin[i] += f;
-                resultMax[i] += e;
-            }
-        }
+    // If the bounds of the shape are not cached, we get them
+    if (!mIsLocalBoundsCached) {
+        Vector3 minBounds;
+        Vector3 maxBounds;
+        getLocalBounds(minBounds, maxBounds);
+        center = decimal(0.5) * (minBounds + maxBounds);
+        halfExtents = decimal(0.5) * (maxBounds - minBounds);
     }
 
+    const Matrix3x3 matrix = transform.getOrientation().getMatrix();
+    const Vector3 worldCenter = transform.getPosition() + matrix * center;
+    const Vector3 worldHalfExtents = matrix.getAbsoluteMatrix() * halfExtents;
+
     // Update the AABB with the new minimum and maximum coordinates
-    aabb.setMin(resultMin);
-    aabb.setMax(resultMax);
+    aabb.setMin(worldCenter - worldHalfExtents);
+    aabb.setMax(worldCenter + worldHalfExtents);
 }
@@ -29,6 +29,7 @@
 // Libraries
 #include <cassert>
 #include "configuration.h"
+#include "mathematics/Vector3.h"
 
 /// ReactPhysics3D namespace
 namespace reactphysics3d {
@@ -44,11 +45,11 @@ struct Vector3;
 class Matrix3x3;
     
 /// Type of collision shapes
-enum class CollisionShapeType {SPHERE, CAPSULE, CONVEX_POLYHEDRON, CONCAVE_SHAPE};
-const int NB_COLLISION_SHAPE_TYPES = 4;
+enum class CollisionShapeType {SPHERE, CAPSULE, CONVEX_POLYHEDRON, IMPLICIT_CONVEX, CONCAVE_SHAPE, COMPOUND};
+const int NB_COLLISION_SHAPE_TYPES = 6;
 
 /// Names of collision shapes
-enum class CollisionShapeName { TRIANGLE, SPHERE, CAPSULE, BOX, CONVEX_MESH, TRIANGLE_MESH, HEIGHTFIELD };
+enum class CollisionShapeName { TRIANGLE, SPHERE, CAPSULE, BOX, CONVEX_MESH, TRIANGLE_MESH, HEIGHTFIELD, CYLINDER, CONE, COMPOUND };
 
 // Declarations
 class ProxyShape;
@@ -74,6 +75,15 @@ class CollisionShape {
         /// Unique identifier of the shape inside an overlapping pair
         uint mId;
 
+        /// Center of the local bounds of the shape (cached by cacheLocalBounds())
+        Vector3 mLocalBoundsCenter;
+
+        /// Half-extents of the local bounds of the shape (cached by cacheLocalBounds())
+        Vector3 mLocalBoundsHalfExtents;
+
+        /// True if the local bounds of the shape have been cached
+        bool mIsLocalBoundsCached;
+
 #ifdef IS_PROFILING_ACTIVE
 
 		/// Pointer to the profiler
@@ -92,6 +102,9 @@ class CollisionShape {
         /// Return the number of bytes used by the collision shape
         virtual size_t getSizeInBytes() const = 0;
 
+        /// Cache the local bounds of the shape to compute its AABBs faster
+        void cacheLocalBounds();
+
     public :
 
         // -------------------- Methods -------------------- //
@@ -149,6 +162,8 @@ class CollisionShape {
 
         friend class ProxyShape;
         friend class CollisionWorld;
+        friend class SceneQuerySnapshot;
+        friend class CompoundShape;
 };
 
 // Return the name of the collision shape
@@ -0,0 +1,192 @@
+/********************************************************************************
+* ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
+* Copyright (c) 2010-2018 Daniel Chappuis                                       *
+*********************************************************************************
+*                                                                               *
+* This software is provided 'as-is', without any express or implied warranty.   *
+* In no event will the authors be held liable for any damages arising from the  *
+* use of this software.                                                         *
+*                                                                               *
+* Permission is granted to anyone to use this software for any purpose,         *
+* including commercial applications, and to alter it and redistribute it        *
+* freely, subject to the following restrictions:                                *
+*                                                                               *
+* 1. The origin of this software must not be misrepresented; you must not claim *
+*    that you wrote the original software. If you use this software in a        *
+*    product, an acknowledgment in the product documentation would be           *
+*    appreciated but is not required.                                           *
+*                                                                               *
+* 2. Altered source versions must be plainly marked as such, and must not be    *
+*    misrepresented as being the original software.                             *
+*                                                                               *
+* 3. This notice may not be removed or altered from any source distribution.    *
+*                                                                               *
+********************************************************************************/
+
+// Libraries
+#include "CompoundShape.h"
+#include "collision/ProxyShape.h"
+#include "collision/RaycastInfo.h"
+#include "memory/MemoryManager.h"
+#include <cassert>
+
+using namespace reactphysics3d;
+
+// Constructor
+CompoundShape::CompoundShape()
+              : CollisionShape(CollisionShapeName::COMPOUND, CollisionShapeType::COMPOUND),
+                mChildShapes(MemoryManager::getBaseAllocator()),
+                mChildShapesTree(MemoryManager::getBaseAllocator()),
+                mLocalBounds(Vector3::zero(), Vector3::zero()), mTotalMassWeight(decimal(0.0)) {
+
+}
+
+// Add a convex child shape to the compound shape
+/// The child shapes must be added before the compound shape is added to a body because the
+/// AABB of the proxy shape and the inertia tensor of the body are not updated afterwards.
+/// The AABB of the child is inserted into the BVH of the compound shape.
+/**
+ * @param shape Pointer to the convex collision shape of the child
+ * @param transform Transform from the local-space of the child to the local-space of the
+ *                  compound shape
+ * @param massWeight Weight of the child in the mass of the compound shape (the mass of a
+ *                   child is proportional to its weight)
+ */
+void CompoundShape::addChildShape(ConvexShape* shape, const Transform& transform, decimal massWeight) {
+
+    assert(shape != nullptr);
+    assert(massWeight >= decimal(0.0));
+
+    // Compute the AABB of the child in the local-space of the compound shape
+    AABB childAABB;
+    shape->computeAABB(childAABB, transform);
+
+    // Insert the child into the BVH (the data of its leaf is the index of the child)
+    mChildShapesTree.addObject(childAABB, static_cast<int32>(mChildShapes.size()), 0);
+
+    if (mChildShapes.size() == 0) {
+        mLocalBounds = childAABB;
+    }
+    else {
+        mLocalBounds.mergeWithAABB(childAABB);
+    }
+    cacheLocalBounds();
+
+    mChildShapes.add({shape, transform, massWeight});
+    mTotalMassWeight += massWeight;
+
+#ifdef IS_PROFILING_ACTIVE
+
+    if (mProfiler != nullptr) {
+        shape->setProfiler(mProfiler);
+    }
+
+#endif
+
+}
+
+// Return the local inertia tensor of the compound shape
+/// The mass is shared between the children in proportion of their mass weights. The inertia
+/// tensor of each child is rotated into the local-space of the compound shape and moved to
+/// the origin of the compound shape with the parallel axis theorem. The origin of the
+/// compound shape is assumed to be the center of mass of its children.
+/**
+ * @param[out] tensor The 3x3 inertia tensor matrix of the shape in local-space
+ *                    coordinates
+ * @param mass Mass to use to compute the inertia tensor of the collision shape
+ */
+void CompoundShape::computeLocalInertiaTensor(Matrix3x3& tensor, decimal mass) const {
+
+    tensor.setToZero();
+    if (mTotalMassWeight <= decimal(0.0)) return;
+
+    for (uint i=0; i < mChildShapes.size(); i++) {
+
+        const ChildShape& child = mChildShapes[i];
+        const decimal childMass = mass * child.massWeight / mTotalMassWeight;
+
+        // Inertia tensor of the child rotated into the local-space of the compound shape
+        Matrix3x3 childTensor;
+        child.shape->computeLocalInertiaTensor(childTensor, childMass);
+        const Matrix3x3 rotation = child.transform.getOrientation().getMatrix();
+        tensor += rotation * childTensor * rotation.getTranspose();
+
+        // Parallel axis theorem
+        const Vector3& offset = child.transform.getPosition();
+        const decimal offsetSquare = offset.lengthSquare();
+        Matrix3x3 offsetMatrix(offsetSquare - offset.x * offset.x, -offset.x * offset.y, -offset.x * offset.z,
+                               -offset.y * offset.x, offsetSquare - offset.y * offset.y, -offset.y * offset.z,
+                               -offset.z * offset.x, -offset.z * offset.y, offsetSquare - offset.z * offset.z);
+        tensor += childMass * offsetMatrix;
+    }
+}
+
+// Return true if a point is inside the collision shape
+/// The point is inside the compound shape if it is inside one of the child shapes whose AABB
+/// contains it.
+bool CompoundShape::testPointInside(const Vector3& localPoint, ProxyShape* proxyShape) const {
+
+    bool isInside = false;
+    auto testChild = [&](uint childIndex) {
+        if (isInside) return;
+        const ChildShape& child = mChildShapes[childIndex];
+        const CollisionShape* childShape = child.shape;
+        isInside = childShape->testPointInside(child.transform.getInverse() * localPoint, proxyShape);
+    };
+    testAllChildShapes(AABB(localPoint, localPoint), testChild);
+
+    return isInside;
+}
+
+// Raycast method with feedback information
+/// The ray is tested against the child shapes whose AABB is hit by the ray (the nearest ones
+/// first) and it is clipped at each hit so that the closest hit is returned. The ray and the
+/// hit point and normal are converted between the local-spaces of the compound shape and of
+/// the child.
+bool CompoundShape::raycast(const Ray& ray, RaycastInfo& raycastInfo, ProxyShape* proxyShape,
+                            MemoryAllocator& allocator) const {
+
+    bool isHit = false;
+
+    auto raycastChild = [&](int nodeId, const Ray& clippedRay) -> decimal {
+
+        const ChildShape& child = mChildShapes[mChildShapesTree.getNodeDataInt(nodeId)[0]];
+        const CollisionShape* childShape = child.shape;
+        const Transform compoundToChild = child.transform.getInverse();
+        const Ray childRay(compoundToChild * clippedRay.point1, compoundToChild * clippedRay.point2,
+                           clippedRay.maxFraction);
+
+        RaycastInfo childRaycastInfo;
+        if (!childShape->raycast(childRay, childRaycastInfo, proxyShape, allocator)) {
+            return decimal(-1.0);
+        }
+
+        isHit = true;
+        raycastInfo.body = childRaycastInfo.body;
+        raycastInfo.proxyShape = childRaycastInfo.proxyShape;
+        raycastInfo.hitFraction = childRaycastInfo.hitFraction;
+        raycastInfo.meshSubpart = childRaycastInfo.meshSubpart;
+        raycastInfo.triangleIndex = childRaycastInfo.triangleIndex;
+        raycastInfo.worldPoint = child.transform * childRaycastInfo.worldPoint;
+        raycastInfo.worldNormal = child.transform.getOrientation() * childRaycastInfo.worldNormal;
+
+        return childRaycastInfo.hitFraction;
+    };
+    mChildShapesTree.raycastLeaves(ray, raycastChild, true);
+
+    return isHit;
+}
+
+#ifdef IS_PROFILING_ACTIVE
+
+// Set the profiler
+void CompoundShape::setProfiler(Profiler* profiler) {
+
+    CollisionShape::setProfiler(profiler);
+
+    for (uint i=0; i < mChildShapes.size(); i++) {
+        mChildShapes[i].shape->setProfiler(profiler);
+    }
+}
+
+#endif
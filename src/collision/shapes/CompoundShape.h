@@ -0,0 +1,250 @@
+/********************************************************************************
+* ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
+* Copyright (c) 2010-2018 Daniel Chappuis                                       *
+*********************************************************************************
+*                                                                               *
+* This software is provided 'as-is', without any express or implied warranty.   *
+* In no event will the authors be held liable for any damages arising from the  *
+* use of this software.                                                         *
+*                                                                               *
+* Permission is granted to anyone to use this software for any purpose,         *
+* including commercial applications, and to alter it and redistribute it        *
+* freely, subject to the following restrictions:                                *
+*                                                                               *
+* 1. The origin of this software must not be misrepresented; you must not claim *
+*    that you wrote the original software. If you use this software in a        *
+*    product, an acknowledgment in the product documentation would be           *
+*    appreciated but is not required.                                           *
+*                                                                               *
+* 2. Altered source versions must be plainly marked as such, and must not be    *
+*    misrepresented as being the original software.                             *
+*                                                                               *
+* 3. This notice may not be removed or altered from any source distribution.    *
+*                                                                               *
+********************************************************************************/
+
+#ifndef REACTPHYSICS3D_COMPOUND_SHAPE_H
+#define REACTPHYSICS3D_COMPOUND_SHAPE_H
+
+// Libraries
+#include "ConvexShape.h"
+#include "collision/shapes/AABB.h"
+#include "collision/broadphase/DynamicAABBTree.h"
+#include "containers/List.h"
+
+// ReactPhysics3D namespace
+namespace reactphysics3d {
+
+// Class CompoundShape
+/**
+ * This class represents a collision shape made of several convex child shapes, each one
+ * with its own transform in the local-space of the compound shape. A body with many convex
+ * pieces can use a single proxy shape with a compound shape instead of one proxy shape per
+ * piece: the broad-phase then has a single AABB to update for the body and the child shapes
+ * that overlap with another shape are found during the middle-phase with a static BVH of the
+ * children in the local-space of the compound shape. The children must all be added before
+ * the compound shape is added to a body and the child shapes must not be destroyed before it.
+ * The origin of the compound shape is assumed to be the center of mass of its children.
+ */
+class CompoundShape : public CollisionShape {
+
+    protected :
+
+        // Structure ChildShape
+        /**
+         * A convex child shape of the compound shape with its transform
+         */
+        struct ChildShape {
+
+            /// Convex collision shape of the child
+            ConvexShape* shape;
+
+            /// Transform from the local-space of the child to the local-space of the compound shape
+            Transform transform;
+
+            /// Weight of the child in the mass of the compound shape
+            decimal massWeight;
+        };
+
+        // -------------------- Attributes -------------------- //
+
+        /// Child shapes
+        List<ChildShape> mChildShapes;
+
+        /// BVH of the AABBs of the child shapes (in the local-space of the compound shape)
+        DynamicAABBTree mChildShapesTree;
+
+        /// AABB of all the child shapes (in the local-space of the compound shape)
+        AABB mLocalBounds;
+
+        /// Sum of the mass weights of the child shapes
+        decimal mTotalMassWeight;
+
+        // -------------------- Methods -------------------- //
+
+        /// Return true if a point is inside the collision shape
+        virtual bool testPointInside(const Vector3& localPoint, ProxyShape* proxyShape) const override;
+
+        /// Raycast method with feedback information
+        virtual bool raycast(const Ray& ray, RaycastInfo& raycastInfo, ProxyShape* proxyShape, MemoryAllocator& allocator) const override;
+
+        /// Return the number of bytes used by the collision shape
+        virtual size_t getSizeInBytes() const override;
+
+    public :
+
+        // -------------------- Methods -------------------- //
+
+        /// Constructor
+        CompoundShape();
+
+        /// Destructor
+        virtual ~CompoundShape() override = default;
+
+        /// Deleted copy-constructor
+        CompoundShape(const CompoundShape& shape) = delete;
+
+        /// Deleted assignment operator
+        CompoundShape& operator=(const CompoundShape& shape) = delete;
+
+        /// Add a convex child shape to the compound shape
+        void addChildShape(ConvexShape* shape, const Transform& transform, decimal massWeight = decimal(1.0));
+
+        /// Return the number of child shapes
+        uint getNbChildShapes() const;
+
+        /// Return a child shape
+        ConvexShape* getChildShape(uint index) const;
+
+        /// Return the transform of a child shape (in the local-space of the compound shape)
+        const Transform& getChildTransform(uint index) const;
+
+        /// Call a function with the index of each child shape whose AABB overlaps with a local AABB
+        template<typename ChildFunction>
+        void testAllChildShapes(const AABB& localAABB, ChildFunction& childFunction) const;
+
+        /// Return the local bounds of the shape in x, y and z directions
+        virtual void getLocalBounds(Vector3& min, Vector3& max) const override;
+
+        /// Return true if the collision shape is convex, false if it is concave
+        virtual bool isConvex() const override;
+
+        /// Return true if the collision shape is a polyhedron
+        virtual bool isPolyhedron() const override;
+
+        /// Return the local inertia tensor of the collision shape
+        virtual void computeLocalInertiaTensor(Matrix3x3& tensor, decimal mass) const override;
+
+        /// Return the string representation of the shape
+        virtual std::string to_string() const override;
+
+#ifdef IS_PROFILING_ACTIVE
+
+        /// Set the profiler
+        virtual void setProfiler(Profiler* profiler) override;
+
+#endif
+
+};
+
+// Class CompoundShapeOverlapCallback
+/**
+ * Callback of the BVH of a compound shape that calls a function with the index of each
+ * child shape whose AABB overlaps with the queried AABB.
+ */
+template<typename ChildFunction>
+class CompoundShapeOverlapCallback : public DynamicAABBTreeOverlapCallback {
+
+    private :
+
+        /// BVH of the child shapes
+        const DynamicAABBTree& mChildShapesTree;
+
+        /// Function called with the index of each overlapping child shape
+        ChildFunction& mChildFunction;
+
+    public :
+
+        /// Constructor
+        CompoundShapeOverlapCallback(const DynamicAABBTree& childShapesTree, ChildFunction& childFunction)
+            : mChildShapesTree(childShapesTree), mChildFunction(childFunction) {
+
+        }
+
+        /// Called for each leaf of the BVH that overlaps with the queried AABB
+        virtual void notifyOverlappingNode(int nodeId) override {
+            mChildFunction(static_cast<uint>(mChildShapesTree.getNodeDataInt(nodeId)[0]));
+        }
+};
+
+// Return the number of child shapes
+inline uint CompoundShape::getNbChildShapes() const {
+    return static_cast<uint>(mChildShapes.size());
+}
+
+// Return a child shape
+/**
+ * @param index Index of the child shape (between zero and getNbChildShapes() - 1)
+ * @return A pointer to the convex shape of the child
+ */
+inline ConvexShape* CompoundShape::getChildShape(uint index) const {
+    assert(index < mChildShapes.size());
+    return mChildShapes[index].shape;
+}
+
+// Return the transform of a child shape (in the local-space of the compound shape)
+/**
+ * @param index Index of the child shape (between zero and getNbChildShapes() - 1)
+ * @return The transform from the local-space of the child to the local-space of the compound shape
+ */
+inline const Transform& CompoundShape::getChildTransform(uint index) const {
+    assert(index < mChildShapes.size());
+    return mChildShapes[index].transform;
+}
+
+// Call a function with the index of each child shape whose AABB overlaps with a local AABB
+/**
+ * @param localAABB AABB in the local-space of the compound shape
+ * @param childFunction Function called with the index of each overlapping child shape
+ */
+template<typename ChildFunction>
+inline void CompoundShape::testAllChildShapes(const AABB& localAABB, ChildFunction& childFunction) const {
+
+    CompoundShapeOverlapCallback<ChildFunction> callback(mChildShapesTree, childFunction);
+    mChildShapesTree.reportAllShapesOverlappingWithAABB(localAABB, callback);
+}
+
+// Return the local bounds of the shape in x, y and z directions
+/**
+ * @param min The minimum bounds of the shape in local-space coordinates
+ * @param max The maximum bounds of the shape in local-space coordinates
+ */
+inline void CompoundShape::getLocalBounds(Vector3& min, Vector3& max) const {
+    min = mLocalBounds.getMin();
+    max = mLocalBounds.getMax();
+}
+
+// Return true if the collision shape is convex, false if it is concave
+/// A compound shape is not convex in general (even if its children are).
+inline bool CompoundShape::isConvex() const {
+    return false;
+}
+
+// Return true if the collision shape is a polyhedron
+inline bool CompoundShape::isPolyhedron() const {
+    return false;
+}
+
+// Return the number of bytes used by the collision shape
+inline size_t CompoundShape::getSizeInBytes() const {
+    return sizeof(CompoundShape);
+}
+
+// Return the string representation of the shape
+inline std::string CompoundShape::to_string() const {
+    return "CompoundShape{nbChildShapes=" + std::to_string(mChildShapes.size()) + "}";
+}
+
+}
+
+#endif
@@ -27,60 +27,37 @@
 #include "ConcaveMeshShape.h"
 #include "memory/MemoryManager.h"
 #include "collision/RaycastInfo.h"
+#include "collision/ProxyShape.h"
 #include "collision/TriangleMesh.h"
 #include "utils/Profiler.h"
 #include "collision/TriangleVertexArray.h"
+#include <algorithm>
 
 using namespace reactphysics3d;
 
 // Constructor
+/// The BVH of the triangles is built by the triangle mesh when its first concave mesh
+/// shape is created. The other concave mesh shapes of the mesh share it.
 ConcaveMeshShape::ConcaveMeshShape(TriangleMesh* triangleMesh, const Vector3& scaling)
-                 : ConcaveShape(CollisionShapeName::TRIANGLE_MESH), mDynamicAABBTree(MemoryManager::getBaseAllocator()),
-                   mScaling(scaling) {
+                 : ConcaveShape(CollisionShapeName::TRIANGLE_MESH), mScaling(scaling) {
     mTriangleMesh = triangleMesh;
     mRaycastTestType = TriangleRaycastSide::FRONT;
 
-    // Insert all the triangles into the dynamic AABB tree
-    initBVHTree();
-}
-
-// Insert all the triangles into the dynamic AABB tree
-void ConcaveMeshShape::initBVHTree() {
-
-    // TODO : Try to randomly add the triangles into the tree to obtain a better tree
-
-    // For each sub-part of the mesh
-    for (uint subPart=0; subPart<mTriangleMesh->getNbSubparts(); subPart++) {
+    // Build the BVH of the triangles of the mesh (if it is not already built)
+    mTriangleMesh->initBVHIfNecessary();
 
-        // Get the triangle vertex array of the current sub-part
-        TriangleVertexArray* triangleVertexArray = mTriangleMesh->getSubpart(subPart);
-
-        // For each triangle of the concave mesh
-        for (uint triangleIndex=0; triangleIndex<triangleVertexArray->getNbTriangles(); triangleIndex++) {
-
-            Vector3 trianglePoints[3];
-
-            // Get the triangle vertices
-            triangleVertexArray->getTriangleVertices(triangleIndex, trianglePoints);
+    // Cache the local bounds used to compute the AABBs of the shape
+    cacheLocalBounds();
+}
 
-            // Apply the scaling factor to the vertices
-            trianglePoints[0].x *= mScaling.x;
-            trianglePoints[0].y *= mScaling.y;
-            trianglePoints[0].z *= mScaling.z;
-            trianglePoints[1].x *= mScaling.x;
-            trianglePoints[1].y *= mScaling.y;
-            trianglePoints[1].z *= mScaling.z;
-            trianglePoints[2].x *= mScaling.x;
-            trianglePoints[2].y *= mScaling.y;
-            trianglePoints[2].z *= mScaling.z;
+// Convert an AABB from the local-space of the shape to the space of the mesh without scaling
+AABB ConcaveMeshShape::computeUnscaledAABB(const AABB& localAABB) const {
 
-            // Create the AABB for the triangle
-            AABB aabb = AABB::createAABBForTriangle(trianglePoints);
+    const Vector3 inverseScaling(decimal(1.0) / mScaling.x, decimal(1.0) / mScaling.y, decimal(1.0) / mScaling.z);
+    const Vector3 unscaledMin = localAABB.getMin() * inverseScaling;
+    const Vector3 unscaledMax = localAABB.getMax() * inverseScaling;
 
-            // Add the AABB with the index of the triangle into the dynamic AABB tree
-            mDynamicAABBTree.addObject(aabb, subPart, triangleIndex);
-        }
-    }
+    return AABB(Vector3::min(unscaledMin, unscaledMax), Vector3::max(unscaledMin, unscaledMax));
 }
 
 // Return the three vertices coordinates (in the array outTriangleVertices) of a triangle
@@ -141,11 +118,11 @@ uint ConcaveMeshShape::getNbTriangles(uint subPart) const
 // Use a callback method on all triangles of the concave shape inside a given AABB
 void ConcaveMeshShape::testAllTriangles(TriangleCallback& callback, const AABB& localAABB) const {
 
-    ConvexTriangleAABBOverlapCallback overlapCallback(callback, *this, mDynamicAABBTree);
+    ConvexTriangleAABBOverlapCallback overlapCallback(callback, *this, localAABB);
 
-    // Ask the Dynamic AABB Tree to report all the triangles that are overlapping
-    // with the AABB of the convex shape.
-    mDynamicAABBTree.reportAllShapesOverlappingWithAABB(localAABB, overlapCallback);
+    // Ask the BVH to report all the triangles that are overlapping with the AABB
+    // of the convex shape (the BVH of the mesh is not scaled)
+    getQuantizedBVH().reportAllTrianglesOverlappingWithAABB(computeUnscaledAABB(localAABB), overlapCallback);
 }
 
 // Raycast method with feedback information
@@ -156,7 +133,7 @@ bool ConcaveMeshShape::raycast(const Ray& ray, RaycastInfo& raycastInfo, ProxySh
     RP3D_PROFILE("ConcaveMeshShape::raycast()", mProfiler);
 
     // Create the callback object that will compute ray casting against triangles
-    ConcaveMeshRaycastCallback raycastCallback(mDynamicAABBTree, *this, proxyShape, raycastInfo, ray, allocator);
+    ConcaveMeshRaycastCallback raycastCallback(*this, proxyShape, raycastInfo, ray, allocator);
 
 #ifdef IS_PROFILING_ACTIVE
 
@@ -165,10 +142,13 @@ bool ConcaveMeshShape::raycast(const Ray& ray, RaycastInfo& raycastInfo, ProxySh
 
 #endif
 
-    // Ask the Dynamic AABB Tree to report all AABB nodes that are hit by the ray.
+    // Ask the BVH to report all the triangles whose AABB is hit by the ray.
     // The raycastCallback object will then compute ray casting against the triangles
-    // in the hit AABBs.
-    mDynamicAABBTree.raycast(ray, raycastCallback);
+    // in the hit AABBs. The ray is converted into the space of the BVH of the mesh (not
+    // scaled). The scaling does not change the hit fractions along the ray.
+    const Vector3 inverseScaling(decimal(1.0) / mScaling.x, decimal(1.0) / mScaling.y, decimal(1.0) / mScaling.z);
+    const Ray unscaledRay(ray.point1 * inverseScaling, ray.point2 * inverseScaling, ray.maxFraction);
+    getQuantizedBVH().raycast(unscaledRay, raycastCallback);
 
     raycastCallback.raycastTriangles();
 
@@ -178,79 +158,182 @@ bool ConcaveMeshShape::raycast(const Ray& ray, RaycastInfo& raycastInfo, ProxySh
 // Compute the shape Id for a given triangle of the mesh
 uint ConcaveMeshShape::computeTriangleShapeId(uint subPart, uint triangleIndex) const {
 
-    uint shapeId = 0;
+    const List<uint>& subpartsFirstTriangleIds = mTriangleMesh->mSubpartsFirstTriangleIds;
+    assert(subPart < subpartsFirstTriangleIds.size() - 1);
 
-    uint i=0;
-    while (i < subPart) {
+    return subpartsFirstTriangleIds[subPart] + triangleIndex;
+}
 
-        shapeId += mTriangleMesh->getSubpart(i)->getNbTriangles();
+// Compute the sub-part and the index in the sub-part of a triangle from its shape Id
+void ConcaveMeshShape::computeTriangleSubpartAndIndex(uint triangleShapeId, uint& subPart, uint& triangleIndex) const {
 
-        i++;
-    }
+    const List<uint>& subpartsFirstTriangleIds = mTriangleMesh->mSubpartsFirstTriangleIds;
+    assert(triangleShapeId < subpartsFirstTriangleIds[subpartsFirstTriangleIds.size() - 1]);
 
-    return shapeId + triangleIndex;
+    // Find the last sub-part whose first triangle is not after the triangle
+    const uint* firstTriangleIds = &(subpartsFirstTriangleIds[0]);
+    const uint* nextSubpart = std::upper_bound(firstTriangleIds, firstTriangleIds + subpartsFirstTriangleIds.size(),
+                                               triangleShapeId);
+    subPart = static_cast<uint>(nextSubpart - firstTriangleIds) - 1;
+    triangleIndex = triangleShapeId - firstTriangleIds[subPart];
 }
 
-// Collect all the AABB nodes that are hit by the ray in the Dynamic AABB Tree
-decimal ConcaveMeshRaycastCallback::raycastBroadPhaseShape(int32 nodeId, const Ray& ray) {
+// Collect all the triangles whose AABB is hit by the ray in the BVH of the mesh
+decimal ConcaveMeshRaycastCallback::raycastBroadPhaseShape(int32 triangleId, const Ray& ray) {
 
-    // Add the id of the hit AABB node into
-    mHitAABBNodes.add(nodeId);
+    // Add the id of the hit triangle
+    mHitTriangles.add(triangleId);
 
     return ray.maxFraction;
 }
 
 // Raycast all collision shapes that have been collected
+/// The collected triangles are tested NB_RAYCAST_LANES at a time directly from the vertices of
+/// the mesh and the hit information is only computed for the closest hit triangle.
 void ConcaveMeshRaycastCallback::raycastTriangles() {
 
-    List<int>::Iterator it;
-    decimal smallestHitFraction = mRay.maxFraction;
-
-    for (it = mHitAABBNodes.begin(); it != mHitAABBNodes.end(); ++it) {
-
-        // Get the node data (triangle index and mesh subpart index)
-        int32* data = mDynamicAABBTree.getNodeDataInt(*it);
-
-        // Get the triangle vertices for this node from the concave mesh shape
-        Vector3 trianglePoints[3];
-        mConcaveMeshShape.getTriangleVertices(data[0], data[1], trianglePoints);
-
-        // Get the vertices normals of the triangle
-        Vector3 verticesNormals[3];
-        mConcaveMeshShape.getTriangleVerticesNormals(data[0], data[1], verticesNormals);
-
-        // Create a triangle collision shape
-        TriangleShape triangleShape(trianglePoints, verticesNormals, mConcaveMeshShape.computeTriangleShapeId(data[0], data[1]), mAllocator);
-        triangleShape.setRaycastTestType(mConcaveMeshShape.getRaycastTestType());
-		
-#ifdef IS_PROFILING_ACTIVE
+    RP3D_PROFILE("ConcaveMeshRaycastCallback::raycastTriangles()", mProfiler);
 
-		// Set the profiler to the triangle shape
-		triangleShape.setProfiler(mProfiler);
-
-#endif
+    const TriangleRaycastSide raycastSide = mConcaveMeshShape.getRaycastTestType();
+    decimal smallestHitFraction = mRay.maxFraction;
+    Vector3 closestTrianglePoints[3];
+    Vector3 closestHitPoint;
+    uint closestSubPart = 0;
+    uint closestTriangleIndex = 0;
+
+    TriangleRaycastLanes lanes;
+
+    // For each group of triangles
+    for (uint startIndex=0; startIndex < mHitTriangles.size(); startIndex += NB_RAYCAST_LANES) {
+
+        const uint nbLanes = mHitTriangles.size() - startIndex < NB_RAYCAST_LANES ?
+                             mHitTriangles.size() - startIndex : NB_RAYCAST_LANES;
+
+        // Get the triangle vertices of the lanes from the concave mesh shape
+        for (uint l=0; l < NB_RAYCAST_LANES; l++) {
+
+            Vector3 trianglePoints[3] = {Vector3::zero(), Vector3::zero(), Vector3::zero()};
+            if (l < nbLanes) {
+                uint subPart, triangleIndex;
+                mConcaveMeshShape.computeTriangleSubpartAndIndex(mHitTriangles[startIndex + l], subPart, triangleIndex);
+                mConcaveMeshShape.getTriangleVertices(subPart, triangleIndex, trianglePoints);
+            }
+            for (uint v=0; v < 3; v++) {
+                lanes.vertices[v][0][l] = trianglePoints[v].x;
+                lanes.vertices[v][1][l] = trianglePoints[v].y;
+                lanes.vertices[v][2][l] = trianglePoints[v].z;
+            }
+        }
 
-        // Ray casting test against the collision shape
-        RaycastInfo raycastInfo;
-        bool isTriangleHit = triangleShape.raycast(mRay, raycastInfo, mProxyShape, mAllocator);
+        raycastTrianglesLanes(lanes, mRay, raycastSide);
 
-        // If the ray hit the collision shape
-        if (isTriangleHit && raycastInfo.hitFraction <= smallestHitFraction) {
+        // Keep the closest hit (the last one of the triangles with the same hit fraction)
+        for (uint l=0; l < nbLanes; l++) {
 
-            assert(raycastInfo.hitFraction >= decimal(0.0));
+            if (lanes.isHit[l] && lanes.hitFractions[l] <= smallestHitFraction) {
 
-            mRaycastInfo.body = raycastInfo.body;
-            mRaycastInfo.proxyShape = raycastInfo.proxyShape;
-            mRaycastInfo.hitFraction = raycastInfo.hitFraction;
-            mRaycastInfo.worldPoint = raycastInfo.worldPoint;
-            mRaycastInfo.worldNormal = raycastInfo.worldNormal;
-            mRaycastInfo.meshSubpart = data[0];
-            mRaycastInfo.triangleIndex = data[1];
+                assert(lanes.hitFractions[l] >= decimal(0.0));
 
-            smallestHitFraction = raycastInfo.hitFraction;
-            mIsHit = true;
+                mConcaveMeshShape.computeTriangleSubpartAndIndex(mHitTriangles[startIndex + l], closestSubPart,
+                                                                 closestTriangleIndex);
+                for (uint v=0; v < 3; v++) {
+                    closestTrianglePoints[v].setAllValues(lanes.vertices[v][0][l], lanes.vertices[v][1][l],
+                                                          lanes.vertices[v][2][l]);
+                }
+                closestHitPoint.setAllValues(lanes.hitPoints[0][l], lanes.hitPoints[1][l], lanes.hitPoints[2][l]);
+                smallestHitFraction = lanes.hitFractions[l];
+                mIsHit = true;
+            }
         }
+    }
+
+    if (mIsHit) {
+
+        // The normal of the hit triangle is facing the origin of the ray
+        const Vector3 pq = mRay.point2 - mRay.point1;
+        Vector3 hitNormal = (closestTrianglePoints[1] - closestTrianglePoints[0]).cross(
+                                closestTrianglePoints[2] - closestTrianglePoints[0]);
+        if (hitNormal.dot(pq) > decimal(0.0)) hitNormal = -hitNormal;
+
+        mRaycastInfo.body = mProxyShape->getBody();
+        mRaycastInfo.proxyShape = mProxyShape;
+        mRaycastInfo.hitFraction = smallestHitFraction;
+        mRaycastInfo.worldPoint = closestHitPoint;
+        mRaycastInfo.worldNormal = hitNormal;
+        mRaycastInfo.meshSubpart = closestSubPart;
+        mRaycastInfo.triangleIndex = closestTriangleIndex;
+    }
+}
 
+// Raycast the triangles of all the lanes (with the same test as TriangleShape::raycast())
+/// The line of the ray is tested against the edges of each triangle with scalar triple
+/// products as in TriangleShape::raycast() and with the same operations so that the results are
+/// identical. The lane loop has no branch so that the compiler can vectorize it.
+void ConcaveMeshRaycastCallback::raycastTrianglesLanes(TriangleRaycastLanes& lanes, const Ray& ray,
+                                                       TriangleRaycastSide raycastSide) {
+
+    const Vector3 pq = ray.point2 - ray.point1;
+    const decimal pqLengthSquare = pq.lengthSquare();
+    const bool isFrontTested = raycastSide != TriangleRaycastSide::BACK;
+    const bool isBackTested = raycastSide != TriangleRaycastSide::FRONT;
+
+    for (uint l=0; l < NB_RAYCAST_LANES; l++) {
+
+        const decimal paX = lanes.vertices[0][0][l] - ray.point1.x;
+        const decimal paY = lanes.vertices[0][1][l] - ray.point1.y;
+        const decimal paZ = lanes.vertices[0][2][l] - ray.point1.z;
+        const decimal pbX = lanes.vertices[1][0][l] - ray.point1.x;
+        const decimal pbY = lanes.vertices[1][1][l] - ray.point1.y;
+        const decimal pbZ = lanes.vertices[1][2][l] - ray.point1.z;
+        const decimal pcX = lanes.vertices[2][0][l] - ray.point1.x;
+        const decimal pcY = lanes.vertices[2][1][l] - ray.point1.y;
+        const decimal pcZ = lanes.vertices[2][2][l] - ray.point1.z;
+
+        // Scalar triple products of the line PQ with the edges BC, CA and AB
+        const decimal mX = pq.y * pcZ - pq.z * pcY;
+        const decimal mY = pq.z * pcX - pq.x * pcZ;
+        const decimal mZ = pq.x * pcY - pq.y * pcX;
+        decimal u = pbX * mX + pbY * mY + pbZ * mZ;
+        decimal v = -(paX * mX + paY * mY + paZ * mZ);
+        const decimal nX = pq.y * pbZ - pq.z * pbY;
+        const decimal nY = pq.z * pbX - pq.x * pbZ;
+        const decimal nZ = pq.x * pbY - pq.y * pbX;
+        decimal w = paX * nX + paY * nY + paZ * nZ;
+
+        // The line is inside the edges if the three products have the same sign (or the
+        // sign of the tested side of the triangle)
+        const bool isFrontInside = (u >= decimal(0.0)) & (v >= decimal(0.0)) & (w >= decimal(0.0));
+        const bool isBackInside = (u <= decimal(0.0)) & (v <= decimal(0.0)) & (w <= decimal(0.0));
+        const bool isBothSidesInside = (u * v >= decimal(0.0)) & (u * w >= decimal(0.0));
+        bool isHit = (isFrontTested & isBackTested) ? isBothSidesInside :
+                                                      (isFrontTested ? isFrontInside : isBackInside);
+
+        // The line is in the plane of the triangle (or the triangle is degenerate)
+        const bool isInPlane = (std::fabs(u) < MACHINE_EPSILON) & (std::fabs(v) < MACHINE_EPSILON) &
+                               (std::fabs(w) < MACHINE_EPSILON);
+        isHit = isHit & !isInPlane;
+
+        // Compute the barycentric coordinates of the hit point (a dummy denominator is used
+        // for the lanes that are not hit)
+        const decimal sum = u + v + w;
+        const decimal denom = decimal(1.0) / (isHit ? sum : decimal(1.0));
+        u *= denom;
+        v *= denom;
+        w *= denom;
+
+        const decimal hitPointX = u * lanes.vertices[0][0][l] + v * lanes.vertices[1][0][l] + w * lanes.vertices[2][0][l];
+        const decimal hitPointY = u * lanes.vertices[0][1][l] + v * lanes.vertices[1][1][l] + w * lanes.vertices[2][1][l];
+        const decimal hitPointZ = u * lanes.vertices[0][2][l] + v * lanes.vertices[1][2][l] + w * lanes.vertices[2][2][l];
+
+        // Signed hit fraction along the ray
+        const decimal hitFraction = ((hitPointX - ray.point1.x) * pq.x + (hitPointY - ray.point1.y) * pq.y +
+                                     (hitPointZ - ray.point1.z) * pq.z) / pqLengthSquare;
+
+        lanes.hitPoints[0][l] = hitPointX;
+        lanes.hitPoints[1][l] = hitPointY;
+        lanes.hitPoints[2][l] = hitPointZ;
+        lanes.hitFractions[l] = hitFraction;
+        lanes.isHit[l] = isHit & (hitFraction >= decimal(0.0)) & (hitFraction <= ray.maxFraction);
     }
 }
 
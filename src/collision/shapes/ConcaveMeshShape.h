@@ -29,6 +29,8 @@
 // Libraries
 #include "ConcaveShape.h"
 #include "collision/broadphase/DynamicAABBTree.h"
+#include "collision/QuantizedBVH.h"
+#include "collision/TriangleMesh.h"
 #include "containers/List.h"
 
 namespace reactphysics3d {
@@ -37,7 +39,6 @@ namespace reactphysics3d {
 class ConcaveMeshShape;
 class Profiler;
 class TriangleShape;
-class TriangleMesh;
 
 // class ConvexTriangleAABBOverlapCallback
 class ConvexTriangleAABBOverlapCallback : public DynamicAABBTreeOverlapCallback {
@@ -49,31 +50,57 @@ class ConvexTriangleAABBOverlapCallback : public DynamicAABBTreeOverlapCallback
         // Reference to the concave mesh shape
         const ConcaveMeshShape& mConcaveMeshShape;
 
-        // Reference to the Dynamic AABB tree
-        const DynamicAABBTree& mDynamicAABBTree;
+        // AABB of the query in the local-space of the shape (with scaling)
+        const AABB& mLocalAABB;
 
     public:
 
         // Constructor
         ConvexTriangleAABBOverlapCallback(TriangleCallback& triangleCallback, const ConcaveMeshShape& concaveShape,
-                                          const DynamicAABBTree& dynamicAABBTree)
-          : mTriangleTestCallback(triangleCallback), mConcaveMeshShape(concaveShape), mDynamicAABBTree(dynamicAABBTree) {
+                                          const AABB& localAABB)
+          : mTriangleTestCallback(triangleCallback), mConcaveMeshShape(concaveShape), mLocalAABB(localAABB) {
 
         }
 
-        // Called when a overlapping node has been found during the call to
-        // DynamicAABBTree:reportAllShapesOverlappingWithAABB()
-        virtual void notifyOverlappingNode(int nodeId) override;
+        // Called when a overlapping triangle has been found during the call to
+        // QuantizedBVH:reportAllTrianglesOverlappingWithAABB()
+        virtual void notifyOverlappingNode(int triangleId) override;
 
 };
 
 /// Class ConcaveMeshRaycastCallback
 class ConcaveMeshRaycastCallback : public DynamicAABBTreeRaycastCallback {
 
+    public :
+
+        // -------------------- Constants -------------------- //
+
+        /// Number of triangles tested together against the ray
+        static const uint NB_RAYCAST_LANES = 4;
+
+        // Structure TriangleRaycastLanes
+        /**
+         * Triangles tested together against the ray, stored as a structure of arrays. The
+         * unused lanes have degenerate triangles (all the vertices at zero) that are never hit.
+         */
+        struct TriangleRaycastLanes {
+
+            /// Coordinates (vertices[vertex][axis][lane]) of the vertices of the triangles
+            decimal vertices[3][3][NB_RAYCAST_LANES];
+
+            /// Hit points of the ray (hitPoints[axis][lane])
+            decimal hitPoints[3][NB_RAYCAST_LANES];
+
+            /// Hit fractions of the ray
+            decimal hitFractions[NB_RAYCAST_LANES];
+
+            /// True if the triangle is hit by the ray
+            bool isHit[NB_RAYCAST_LANES];
+        };
+
     private :
 
-        List<int32> mHitAABBNodes;
-        const DynamicAABBTree& mDynamicAABBTree;
+        List<int32> mHitTriangles;
         const ConcaveMeshShape& mConcaveMeshShape;
         ProxyShape* mProxyShape;
         RaycastInfo& mRaycastInfo;
@@ -91,19 +118,23 @@ class ConcaveMeshRaycastCallback : public DynamicAABBTreeRaycastCallback {
     public:
 
         // Constructor
-        ConcaveMeshRaycastCallback(const DynamicAABBTree& dynamicAABBTree, const ConcaveMeshShape& concaveMeshShape,
-                                   ProxyShape* proxyShape, RaycastInfo& raycastInfo, const Ray& ray, MemoryAllocator& allocator)
-            : mHitAABBNodes(allocator), mDynamicAABBTree(dynamicAABBTree), mConcaveMeshShape(concaveMeshShape), mProxyShape(proxyShape),
+        ConcaveMeshRaycastCallback(const ConcaveMeshShape& concaveMeshShape, ProxyShape* proxyShape,
+                                   RaycastInfo& raycastInfo, const Ray& ray, MemoryAllocator& allocator)
+            : mHitTriangles(allocator), mConcaveMeshShape(concaveMeshShape), mProxyShape(proxyShape),
               mRaycastInfo(raycastInfo), mRay(ray), mIsHit(false), mAllocator(allocator) {
 
         }
 
-        /// Collect all the AABB nodes that are hit by the ray in the Dynamic AABB Tree
-        virtual decimal raycastBroadPhaseShape(int32 nodeId, const Ray& ray) override;
+        /// Collect all the triangles whose AABB is hit by the ray in the BVH of the mesh
+        virtual decimal raycastBroadPhaseShape(int32 triangleId, const Ray& ray) override;
 
         /// Raycast all collision shapes that have been collected
         void raycastTriangles();
 
+        /// Raycast the triangles of all the lanes (with the same test as TriangleShape::raycast())
+        static void raycastTrianglesLanes(TriangleRaycastLanes& lanes, const Ray& ray,
+                                          TriangleRaycastSide raycastSide);
+
         /// Return true if a raycast hit has been found
         bool getIsHit() const {
             return mIsHit;
@@ -131,12 +162,9 @@ class ConcaveMeshShape : public ConcaveShape {
 
         // -------------------- Attributes -------------------- //
 
-        /// Triangle mesh
+        /// Triangle mesh (its BVH is shared by all the concave mesh shapes of the mesh)
         TriangleMesh* mTriangleMesh;
 
-        /// Dynamic AABB tree to accelerate collision with the triangles
-        DynamicAABBTree mDynamicAABBTree;
-
         /// Array with computed vertices normals for each TriangleVertexArray of the triangle mesh (only
         /// if the user did not provide its own vertices normals)
         Vector3** mComputedVerticesNormals;
@@ -152,12 +180,18 @@ class ConcaveMeshShape : public ConcaveShape {
         /// Return the number of bytes used by the collision shape
         virtual size_t getSizeInBytes() const override;
 
-        /// Insert all the triangles into the dynamic AABB tree
-        void initBVHTree();
+        /// Return the BVH of the triangles of the mesh (in the space of the mesh without scaling)
+        const QuantizedBVH& getQuantizedBVH() const;
+
+        /// Convert an AABB from the local-space of the shape to the space of the mesh without scaling
+        AABB computeUnscaledAABB(const AABB& localAABB) const;
 
         /// Compute the shape Id for a given triangle of the mesh
         uint computeTriangleShapeId(uint subPart, uint triangleIndex) const;
 
+        /// Compute the sub-part and the index in the sub-part of a triangle from its shape Id
+        void computeTriangleSubpartAndIndex(uint triangleShapeId, uint& subPart, uint& triangleIndex) const;
+
     public:
 
         /// Constructor
@@ -190,6 +224,9 @@ class ConcaveMeshShape : public ConcaveShape {
         /// Return the three vertex normals (in the array outVerticesNormals) of a triangle
         void getTriangleVerticesNormals(uint subPart, uint triangleIndex, Vector3* outVerticesNormals) const;
 
+        /// Return the convexity flags of the three edges of a triangle from its shape Id
+        uint8 getTriangleEdgesConvexity(uint triangleShapeId) const;
+
         /// Return the local bounds of the shape in x, y and z directions.
         virtual void getLocalBounds(Vector3& min, Vector3& max) const override;
 
@@ -225,6 +262,20 @@ inline const Vector3& ConcaveMeshShape::getScaling() const {
     return mScaling;
 }
 
+// Return the convexity flags of the three edges of a triangle from its shape Id
+/**
+ * @param triangleShapeId The shape Id of the triangle (its ID in the triangle mesh)
+ * @return The convexity flags of the edges (see TriangleMesh::getTriangleEdgesConvexity())
+ */
+inline uint8 ConcaveMeshShape::getTriangleEdgesConvexity(uint triangleShapeId) const {
+    return mTriangleMesh->getTriangleEdgesConvexity(triangleShapeId);
+}
+
+// Return the BVH of the triangles of the mesh (in the space of the mesh without scaling)
+inline const QuantizedBVH& ConcaveMeshShape::getQuantizedBVH() const {
+    return mTriangleMesh->mQuantizedBVH;
+}
+
 // Return the local bounds of the shape in x, y and z directions.
 // This method is used to compute the AABB of the box
 /**
@@ -233,11 +284,12 @@ inline const Vector3& ConcaveMeshShape::getScaling() const {
  */
 inline void ConcaveMeshShape::getLocalBounds(Vector3& min, Vector3& max) const {
 
-    // Get the AABB of the whole tree
-    AABB treeAABB = mDynamicAABBTree.getRootAABB();
-
-    min = treeAABB.getMin();
-    max = treeAABB.getMax();
+    // Get the AABB of the whole tree and apply the scaling (that can be negative)
+    const AABB& treeAABB = getQuantizedBVH().getRootAABB();
+    const Vector3 scaledMin = treeAABB.getMin() * mScaling;
+    const Vector3 scaledMax = treeAABB.getMax() * mScaling;
+    min = Vector3::min(scaledMin, scaledMax);
+    max = Vector3::max(scaledMin, scaledMax);
 }
 
 // Return the local inertia tensor of the shape
@@ -257,23 +309,35 @@ inline void ConcaveMeshShape::computeLocalInertiaTensor(Matrix3x3& tensor, decim
                         0, 0, mass);
 }
 
-// Called when a overlapping node has been found during the call to
-// DynamicAABBTree:reportAllShapesOverlappingWithAABB()
-inline void ConvexTriangleAABBOverlapCallback::notifyOverlappingNode(int nodeId) {
+// Called when a overlapping triangle has been found during the call to
+// QuantizedBVH:reportAllTrianglesOverlappingWithAABB()
+inline void ConvexTriangleAABBOverlapCallback::notifyOverlappingNode(int triangleId) {
 
-    // Get the node data (triangle index and mesh subpart index)
-    int32* data = mDynamicAABBTree.getNodeDataInt(nodeId);
+    // Get the mesh subpart and the index of the triangle
+    uint subPart, triangleIndex;
+    mConcaveMeshShape.computeTriangleSubpartAndIndex(triangleId, subPart, triangleIndex);
 
     // Get the triangle vertices for this node from the concave mesh shape
     Vector3 trianglePoints[3];
-    mConcaveMeshShape.getTriangleVertices(data[0], data[1], trianglePoints);
+    mConcaveMeshShape.getTriangleVertices(subPart, triangleIndex, trianglePoints);
+
+    // The triangles of a leaf of the BVH are reported together, so the triangles whose
+    // AABB does not overlap the query AABB are skipped here
+    const Vector3 triangleMin = Vector3::min(Vector3::min(trianglePoints[0], trianglePoints[1]), trianglePoints[2]);
+    const Vector3 triangleMax = Vector3::max(Vector3::max(trianglePoints[0], trianglePoints[1]), trianglePoints[2]);
+    const Vector3& min = mLocalAABB.getMin();
+    const Vector3& max = mLocalAABB.getMax();
+    if (triangleMin.x > max.x || triangleMax.x < min.x || triangleMin.y > max.y || triangleMax.y < min.y ||
+        triangleMin.z > max.z || triangleMax.z < min.z) {
+        return;
+    }
 
     // Get the vertices normals of the triangle
     Vector3 verticesNormals[3];
-    mConcaveMeshShape.getTriangleVerticesNormals(data[0], data[1], verticesNormals);
+    mConcaveMeshShape.getTriangleVerticesNormals(subPart, triangleIndex, verticesNormals);
 
     // Call the callback to test narrow-phase collision with this triangle
-    mTriangleTestCallback.testTriangle(trianglePoints, verticesNormals, mConcaveMeshShape.computeTriangleShapeId(data[0], data[1]));
+    mTriangleTestCallback.testTriangle(trianglePoints, verticesNormals, triangleId);
 }
 
 #ifdef IS_PROFILING_ACTIVE
@@ -283,7 +347,7 @@ inline void ConcaveMeshShape::setProfiler(Profiler* profiler) {
 
     CollisionShape::setProfiler(profiler);
 
-    mDynamicAABBTree.setProfiler(profiler);
+    mTriangleMesh->mQuantizedBVH.setProfiler(profiler);
 }
 
 
@@ -0,0 +1,162 @@
+/********************************************************************************
+* ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
+* Copyright (c) 2010-2018 Daniel Chappuis                                       *
+*********************************************************************************
+*                                                                               *
+* This software is provided 'as-is', without any express or implied warranty.   *
+* In no event will the authors be held liable for any damages arising from the  *
+* use of this software.                                                         *
+*                                                                               *
+* Permission is granted to anyone to use this software for any purpose,         *
+* including commercial applications, and to alter it and redistribute it        *
+* freely, subject to the following restrictions:                                *
+*                                                                               *
+* 1. The origin of this software must not be misrepresented; you must not claim *
+*    that you wrote the original software. If you use this software in a        *
+*    product, an acknowledgment in the product documentation would be           *
+*    appreciated but is not required.                                           *
+*                                                                               *
+* 2. Altered source versions must be plainly marked as such, and must not be    *
+*    misrepresented as being the original software.                             *
+*                                                                               *
+* 3. This notice may not be removed or altered from any source distribution.    *
+*                                                                               *
+********************************************************************************/
+
+// Libraries
+#include "ConeShape.h"
+#include "collision/ProxyShape.h"
+#include "configuration.h"
+#include "collision/RaycastInfo.h"
+#include <cassert>
+
+using namespace reactphysics3d;
+
+// Constructor
+/// The original cone (without margin) is the cone of the shape moved inward by the margin:
+/// its base is raised by the margin and its apex is lowered by the margin divided by the
+/// sine of the half angle of the apex.
+/**
+ * @param radius The radius of the base of the cone (in meters)
+ * @param height The height of the cone (in meters)
+ * @param margin The collision margin (in meters) that rounds the edges of the cone
+ */
+ConeShape::ConeShape(decimal radius, decimal height, decimal margin)
+          : ConvexShape(CollisionShapeName::CONE, CollisionShapeType::IMPLICIT_CONVEX, margin),
+            mRadius(radius), mHeight(height) {
+
+    assert(margin > decimal(0.0));
+    assert(radius > margin);
+
+    const decimal sinHalfAngle = radius / std::sqrt(radius * radius + height * height);
+    mCoreApexY = decimal(0.75) * height - margin / sinHalfAngle;
+    mCoreBaseY = decimal(-0.25) * height + margin;
+    mCoreRadius = radius * (mCoreApexY - mCoreBaseY) / height;
+
+    assert(mCoreApexY > mCoreBaseY);
+
+    // Cache the local bounds used to compute the AABBs of the shape
+    cacheLocalBounds();
+}
+
+// Return the local inertia tensor of the cone
+/// The inertia tensor is computed at the center of mass of the cone (the origin of the shape).
+/**
+ * @param[out] tensor The 3x3 inertia tensor matrix of the shape in local-space
+ *                    coordinates
+ * @param mass Mass to use to compute the inertia tensor of the collision shape
+ */
+void ConeShape::computeLocalInertiaTensor(Matrix3x3& tensor, decimal mass) const {
+
+    const decimal radiusSquare = mRadius * mRadius;
+    const decimal IxxAndzz = decimal(3.0 / 80.0) * mass * (decimal(4.0) * radiusSquare + mHeight * mHeight);
+    const decimal Iyy = decimal(0.3) * mass * radiusSquare;
+    tensor.setAllValues(IxxAndzz, 0.0, 0.0,
+                        0.0, Iyy, 0.0,
+                        0.0, 0.0, IxxAndzz);
+}
+
+// Raycast method with feedback information
+/// The hit is the closest entry point of the ray in the base disk and in the lateral surface
+/// of the cone. The points of the lateral surface satisfy x^2 + z^2 = k^2 * (apexY - y)^2 with
+/// k = radius / height, which gives a quadratic equation in the ray parameter. The rounded
+/// edges of the margin are ignored.
+bool ConeShape::raycast(const Ray& ray, RaycastInfo& raycastInfo, ProxyShape* proxyShape, MemoryAllocator& allocator) const {
+
+    // If the origin of the ray is inside the cone, we return no hit
+    if (testPointInside(ray.point1, proxyShape)) return false;
+
+    const Vector3 rayDirection = ray.point2 - ray.point1;
+    const decimal apexY = decimal(0.75) * mHeight;
+    const decimal baseY = decimal(-0.25) * mHeight;
+    const decimal k = mRadius / mHeight;
+    const decimal kSquare = k * k;
+
+    decimal tHit = DECIMAL_LARGEST;
+    Vector3 hitNormal;
+
+    // Intersection with the base disk (the ray has to go up to enter the cone through its base)
+    if (rayDirection.y > MACHINE_EPSILON) {
+        const decimal t = (baseY - ray.point1.y) / rayDirection.y;
+        if (t >= decimal(0.0)) {
+            const Vector3 point = ray.point1 + t * rayDirection;
+            if (point.x * point.x + point.z * point.z <= mRadius * mRadius) {
+                tHit = t;
+                hitNormal.setAllValues(decimal(0.0), decimal(-1.0), decimal(0.0));
+            }
+        }
+    }
+
+    // Intersection with the lateral surface
+    const decimal w = apexY - ray.point1.y;
+    const decimal a = rayDirection.x * rayDirection.x + rayDirection.z * rayDirection.z -
+                      kSquare * rayDirection.y * rayDirection.y;
+    const decimal b = decimal(2.0) * (ray.point1.x * rayDirection.x + ray.point1.z * rayDirection.z +
+                                      kSquare * w * rayDirection.y);
+    const decimal c = ray.point1.x * ray.point1.x + ray.point1.z * ray.point1.z - kSquare * w * w;
+
+    decimal roots[2];
+    int nbRoots = 0;
+    if (std::abs(a) < MACHINE_EPSILON) {
+        if (std::abs(b) > MACHINE_EPSILON) {
+            roots[nbRoots++] = -c / b;
+        }
+    }
+    else {
+        const decimal discriminant = b * b - decimal(4.0) * a * c;
+        if (discriminant >= decimal(0.0)) {
+            const decimal sqrtDiscriminant = std::sqrt(discriminant);
+            roots[nbRoots++] = (-b - sqrtDiscriminant) / (decimal(2.0) * a);
+            roots[nbRoots++] = (-b + sqrtDiscriminant) / (decimal(2.0) * a);
+        }
+    }
+
+    for (int i=0; i < nbRoots; i++) {
+
+        const decimal t = roots[i];
+        if (t < decimal(0.0) || t >= tHit) continue;
+
+        // The point has to be on the finite cone (and not on the mirrored cone above the apex)
+        const Vector3 point = ray.point1 + t * rayDirection;
+        if (point.y < baseY || point.y > apexY) continue;
+
+        // The ray has to enter the cone at this point
+        const Vector3 normal(point.x, kSquare * (apexY - point.y), point.z);
+        if (normal.dot(rayDirection) >= decimal(0.0)) continue;
+
+        tHit = t;
+        hitNormal = normal;
+    }
+
+    // If there is no hit or if the hit is beyond the maximum raycasting distance
+    if (tHit > ray.maxFraction) return false;
+
+    // Compute the hit information
+    raycastInfo.body = proxyShape->getBody();
+    raycastInfo.proxyShape = proxyShape;
+    raycastInfo.hitFraction = tHit;
+    raycastInfo.worldPoint = ray.point1 + tHit * rayDirection;
+    raycastInfo.worldNormal = hitNormal;
+
+    return true;
+}
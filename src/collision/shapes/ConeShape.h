@@ -0,0 +1,203 @@
+/********************************************************************************
+* ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
+* Copyright (c) 2010-2018 Daniel Chappuis                                       *
+*********************************************************************************
+*                                                                               *
+* This software is provided 'as-is', without any express or implied warranty.   *
+* In no event will the authors be held liable for any damages arising from the  *
+* use of this software.                                                         *
+*                                                                               *
+* Permission is granted to anyone to use this software for any purpose,         *
+* including commercial applications, and to alter it and redistribute it        *
+* freely, subject to the following restrictions:                                *
+*                                                                               *
+* 1. The origin of this software must not be misrepresented; you must not claim *
+*    that you wrote the original software. If you use this software in a        *
+*    product, an acknowledgment in the product documentation would be           *
+*    appreciated but is not required.                                           *
+*                                                                               *
+* 2. Altered source versions must be plainly marked as such, and must not be    *
+*    misrepresented as being the original software.                             *
+*                                                                               *
+* 3. This notice may not be removed or altered from any source distribution.    *
+*                                                                               *
+********************************************************************************/
+
+#ifndef REACTPHYSICS3D_CONE_SHAPE_H
+#define REACTPHYSICS3D_CONE_SHAPE_H
+
+// Libraries
+#include "ConvexShape.h"
+#include "mathematics/mathematics.h"
+
+// ReactPhysics3D namespace
+namespace reactphysics3d {
+
+// Declarations
+class CollisionBody;
+
+// Class ConeShape
+/**
+ * This class represents a cone collision shape defined around the Y axis by the radius of
+ * its base and its height. The apex of the cone points toward the positive Y axis. The origin
+ * of the shape is the center of mass of the cone which is at a quarter of the height above
+ * the base. The cone is not a polyhedron: its support point is computed in constant time from
+ * the direction and the collision detection uses the GJK and EPA algorithms. The original
+ * object (without margin) is a smaller cone inside the shape so that the shape with the
+ * margin keeps the given radius and height with edges rounded by the margin.
+ */
+class ConeShape : public ConvexShape {
+
+    protected :
+
+        // -------------------- Attributes -------------------- //
+
+        /// Radius of the base of the cone
+        decimal mRadius;
+
+        /// Height of the cone
+        decimal mHeight;
+
+        /// Y coordinate of the apex of the original cone (without margin)
+        decimal mCoreApexY;
+
+        /// Y coordinate of the base of the original cone (without margin)
+        decimal mCoreBaseY;
+
+        /// Radius of the base of the original cone (without margin)
+        decimal mCoreRadius;
+
+        // -------------------- Methods -------------------- //
+
+        /// Return a local support point in a given direction without the object margin
+        virtual Vector3 getLocalSupportPointWithoutMargin(const Vector3& direction) const override;
+
+        /// Return true if a point is inside the collision shape
+        virtual bool testPointInside(const Vector3& localPoint, ProxyShape* proxyShape) const override;
+
+        /// Raycast method with feedback information
+        virtual bool raycast(const Ray& ray, RaycastInfo& raycastInfo, ProxyShape* proxyShape, MemoryAllocator& allocator) const override;
+
+        /// Return the number of bytes used by the collision shape
+        virtual size_t getSizeInBytes() const override;
+
+    public :
+
+        // -------------------- Methods -------------------- //
+
+        /// Constructor
+        ConeShape(decimal radius, decimal height, decimal margin = decimal(0.04));
+
+        /// Destructor
+        virtual ~ConeShape() override = default;
+
+        /// Deleted copy-constructor
+        ConeShape(const ConeShape& shape) = delete;
+
+        /// Deleted assignment operator
+        ConeShape& operator=(const ConeShape& shape) = delete;
+
+        /// Return the radius of the base of the cone
+        decimal getRadius() const;
+
+        /// Return the height of the cone
+        decimal getHeight() const;
+
+        /// Return the local bounds of the shape in x, y and z directions
+        virtual void getLocalBounds(Vector3& min, Vector3& max) const override;
+
+        /// Return true if the collision shape is a polyhedron
+        virtual bool isPolyhedron() const override;
+
+        /// Return the local inertia tensor of the collision shape
+        virtual void computeLocalInertiaTensor(Matrix3x3& tensor, decimal mass) const override;
+
+        /// Return the string representation of the shape
+        virtual std::string to_string() const override;
+};
+
+// Return the radius of the base of the cone
+/**
+ * @return The radius of the base of the cone shape (in meters)
+ */
+inline decimal ConeShape::getRadius() const {
+    return mRadius;
+}
+
+// Return the height of the cone
+/**
+ * @return The height of the cone shape (in meters)
+ */
+inline decimal ConeShape::getHeight() const {
+    return mHeight;
+}
+
+// Return the number of bytes used by the collision shape
+inline size_t ConeShape::getSizeInBytes() const {
+    return sizeof(ConeShape);
+}
+
+// Return the local bounds of the shape in x, y and z directions
+/**
+ * @param min The minimum bounds of the shape in local-space coordinates
+ * @param max The maximum bounds of the shape in local-space coordinates
+ */
+inline void ConeShape::getLocalBounds(Vector3& min, Vector3& max) const {
+
+    // Maximum bounds
+    max.x = mRadius;
+    max.y = decimal(0.75) * mHeight;
+    max.z = mRadius;
+
+    // Minimum bounds
+    min.x = -mRadius;
+    min.y = decimal(-0.25) * mHeight;
+    min.z = -mRadius;
+}
+
+// Return true if the collision shape is a polyhedron
+inline bool ConeShape::isPolyhedron() const {
+    return false;
+}
+
+// Return a local support point in a given direction without the object margin
+/// The support point of a cone is either its apex or the point of the rim of its base in the
+/// direction. We return the one with the maximum dot product with the direction.
+inline Vector3 ConeShape::getLocalSupportPointWithoutMargin(const Vector3& direction) const {
+
+    const decimal lengthXZ = std::sqrt(direction.x * direction.x + direction.z * direction.z);
+
+    // If the apex has the maximum dot product
+    if (direction.y * mCoreApexY >= direction.y * mCoreBaseY + mCoreRadius * lengthXZ) {
+        return Vector3(decimal(0.0), mCoreApexY, decimal(0.0));
+    }
+
+    // If the direction is along the axis, the center of the base is a support point
+    if (lengthXZ < MACHINE_EPSILON) {
+        return Vector3(decimal(0.0), mCoreBaseY, decimal(0.0));
+    }
+
+    const decimal factor = mCoreRadius / lengthXZ;
+    return Vector3(direction.x * factor, mCoreBaseY, direction.z * factor);
+}
+
+// Return true if a point is inside the collision shape
+inline bool ConeShape::testPointInside(const Vector3& localPoint, ProxyShape* proxyShape) const {
+
+    const decimal apexY = decimal(0.75) * mHeight;
+    const decimal baseY = decimal(-0.25) * mHeight;
+    if (localPoint.y >= apexY || localPoint.y <= baseY) return false;
+
+    const decimal radius = mRadius * (apexY - localPoint.y) / mHeight;
+    return localPoint.x * localPoint.x + localPoint.z * localPoint.z < radius * radius;
+}
+
+// Return the string representation of the shape
+inline std::string ConeShape::to_string() const {
+    return "ConeShape{height=" + std::to_string(mHeight) + ", radius=" + std::to_string(mRadius) +
+           ", margin=" + std::to_string(mMargin) + "}";
+}
+
+}
+
+#endif
@@ -31,6 +31,9 @@
 
 using namespace reactphysics3d;
 
+// Initialization of static variables
+const uint ConvexMeshShape::HILL_CLIMBING_MIN_NB_VERTICES = 64;
+
 // Constructor to initialize with an array of 3D vertices.
 /// This method creates an internal copy of the input vertices.
 /**
@@ -45,38 +48,93 @@ ConvexMeshShape::ConvexMeshShape(PolyhedronMesh* polyhedronMesh, const Vector3&
 
     // Recalculate the bounds of the mesh
     recalculateBounds();
+
+    // Cache the local bounds used to compute the AABBs of the shape
+    cacheLocalBounds();
 }
 
 // Return a local support point in a given direction without the object margin.
-/// If the edges information is not used for collision detection, this method will go through
-/// the whole vertices list and pick up the vertex with the largest dot product in the support
-/// direction. This is an O(n) process with "n" being the number of vertices in the mesh.
-/// However, if the edges information is used, we can cache the previous support vertex and use
-/// it as a start in a hill-climbing (local search) process to find the new support vertex which
-/// will be in most of the cases very close to the previous one. Using hill-climbing, this method
-/// runs in almost constant time.
+/// This method tests all the vertices of the mesh and picks up the vertex with the largest
+/// dot product in the support direction. This is an O(n) process with "n" being the number
+/// of vertices in the mesh but the vertices are tested in groups of lanes (see
+/// PolyhedronMesh::computeSupportVertex()). The GJK algorithm uses
+/// getLocalSupportPointWithoutMarginFromVertex() instead, which starts from the support
+/// vertex of the previous query on the large meshes.
 Vector3 ConvexMeshShape::getLocalSupportPointWithoutMargin(const Vector3& direction) const {
 
-    decimal maxDotProduct = DECIMAL_SMALLEST;
-    uint indexMaxDotProduct = 0;
+    // Find the vertex with the largest dot product (the direction is scaled into the space
+    // of the unscaled vertices)
+    const uint supportVertex = mPolyhedronMesh->computeSupportVertex(direction * mScaling);
 
-    // For each vertex of the mesh
-    for (uint i=0; i<mPolyhedronMesh->getNbVertices(); i++) {
+    // Return the vertex with the largest dot product in the support direction
+    return mPolyhedronMesh->getVertex(supportVertex) * mScaling;
+}
+
+// Return a local support point without the object margin with a hill-climbing
+// search that starts from a cached support vertex
+/// The search starts from the vertex "supportVertexIndex" and moves to the neighbor vertex
+/// (found with the half-edge structure) with the largest dot product in the support direction
+/// until no neighbor is better. Because the mesh is convex, this local maximum is the support
+/// vertex. The cached vertex is updated with the new support vertex. Since the support vertex
+/// of the next query of a pair is in most cases very close to the previous one, this method
+/// runs in almost constant time. The meshes with less than HILL_CLIMBING_MIN_NB_VERTICES
+/// vertices test all their vertices instead, which is faster for them.
+Vector3 ConvexMeshShape::getLocalSupportPointWithoutMarginFromVertex(const Vector3& direction,
+                                                                     uint& supportVertexIndex) const {
+
+    const HalfEdgeStructure& halfEdgeStructure = mPolyhedronMesh->getHalfEdgeStructure();
+
+    if (halfEdgeStructure.getNbVertices() < HILL_CLIMBING_MIN_NB_VERTICES) {
+        supportVertexIndex = mPolyhedronMesh->computeSupportVertex(direction * mScaling);
+        return mPolyhedronMesh->getVertex(supportVertexIndex) * mScaling;
+    }
+
+    if (supportVertexIndex >= halfEdgeStructure.getNbVertices()) {
+        supportVertexIndex = 0;
+    }
+
+    // Support direction in the space of the unscaled vertices
+    const Vector3 meshDirection = direction * mScaling;
+
+    uint currentVertexIndex = supportVertexIndex;
+    decimal currentDotProduct = meshDirection.dot(mPolyhedronMesh->getVertex(currentVertexIndex));
+
+    bool hasMoved = true;
+    while (hasMoved) {
+
+        hasMoved = false;
+
+        // For each neighbor vertex of the current vertex
+        const uint firstEdgeIndex = halfEdgeStructure.getVertex(currentVertexIndex).edgeIndex;
+        uint edgeIndex = firstEdgeIndex;
+        uint bestVertexIndex = currentVertexIndex;
+        do {
+
+            const HalfEdgeStructure::Edge& edge = halfEdgeStructure.getHalfEdge(edgeIndex);
+            const HalfEdgeStructure::Edge& twinEdge = halfEdgeStructure.getHalfEdge(edge.twinEdgeIndex);
+
+            // The twin edge starts at the neighbor vertex
+            const decimal dotProduct = meshDirection.dot(mPolyhedronMesh->getVertex(twinEdge.vertexIndex));
+            if (dotProduct > currentDotProduct) {
+                currentDotProduct = dotProduct;
+                bestVertexIndex = twinEdge.vertexIndex;
+            }
+
+            // Go to the next edge emanating from the current vertex
+            edgeIndex = twinEdge.nextEdgeIndex;
 
-        // Compute the dot product of the current vertex
-        decimal dotProduct = direction.dot(mPolyhedronMesh->getVertex(i));
+        } while (edgeIndex != firstEdgeIndex);
 
-        // If the current dot product is larger than the maximum one
-        if (dotProduct > maxDotProduct) {
-            indexMaxDotProduct = i;
-            maxDotProduct = dotProduct;
+        if (bestVertexIndex != currentVertexIndex) {
+            currentVertexIndex = bestVertexIndex;
+            hasMoved = true;
         }
     }
 
-    assert(maxDotProduct >= decimal(0.0));
+    supportVertexIndex = currentVertexIndex;
 
     // Return the vertex with the largest dot product in the support direction
-    return mPolyhedronMesh->getVertex(indexMaxDotProduct) * mScaling;
+    return mPolyhedronMesh->getVertex(currentVertexIndex) * mScaling;
 }
 
 // Recompute the bounds of the mesh
@@ -105,82 +163,32 @@ void ConvexMeshShape::recalculateBounds() {
 
 // Raycast method with feedback information
 /// This method implements the technique in the book "Real-time Collision Detection" by
-/// Christer Ericson.
+/// Christer Ericson. The ray is clipped with groups of face planes at a time (see
+/// PolyhedronMesh::clipRay()).
 bool ConvexMeshShape::raycast(const Ray& ray, RaycastInfo& raycastInfo, ProxyShape* proxyShape, MemoryAllocator& allocator) const {
 
     // Ray direction
     Vector3 direction = ray.point2 - ray.point1;
 
-    decimal tMin = decimal(0.0);
-    decimal tMax = ray.maxFraction;
-    Vector3 currentFaceNormal;
-    bool isIntersectionFound = false;
+    // Clip the ray with all the face planes of the convex mesh
+    decimal hitFraction;
+    uint hitFace;
+    if (!mPolyhedronMesh->clipRay(ray.point1, direction, ray.maxFraction, hitFraction, hitFace)) return false;
 
-    const HalfEdgeStructure& halfEdgeStructure = mPolyhedronMesh->getHalfEdgeStructure();
+    // The ray intersects with the convex mesh
+    assert(hitFraction >= decimal(0.0));
+    assert(hitFraction <= ray.maxFraction);
 
-    // For each face of the convex mesh
-    for (uint f=0; f < mPolyhedronMesh->getNbFaces(); f++) {
+    // Compute the hit point
+    Vector3 localHitPoint = ray.point1 + hitFraction * direction;
 
-        const HalfEdgeStructure::Face& face = halfEdgeStructure.getFace(f);
-        const Vector3 faceNormal = mPolyhedronMesh->getFaceNormal(f);
-        const HalfEdgeStructure::Vertex& faceVertex = halfEdgeStructure.getVertex(face.faceVertices[0]);
-        const Vector3 facePoint = mPolyhedronMesh->getVertex(faceVertex.vertexPointIndex);
-        decimal denom = faceNormal.dot(direction);
-        decimal planeD = faceNormal.dot(facePoint);
-        decimal dist = planeD -  faceNormal.dot(ray.point1);
-
-        // If ray is parallel to the face
-        if (denom == decimal(0.0)) {
-
-            // If ray is outside the clipping face, we return no intersection
-            if (dist < decimal(0.0)) return false;
-        }
-        else {
-
-            // Compute the intersection between the ray and the current face plane
-            decimal t = dist / denom;
-
-            // Update the current ray intersection by clipping it with the current face plane
-            // If the place faces the ray
-            if (denom < decimal(0.0)) {
-                // Clip the current ray intersection as it enters the convex mesh
-                if (t > tMin) {
-                    tMin = t;
-                    currentFaceNormal = faceNormal;
-                    isIntersectionFound = true;
-                }
-            }
-            else {
-                // Clip the current ray intersection as it exits the convex mesh
-                if (t < tMax) tMax = t;
-            }
+    raycastInfo.hitFraction = hitFraction;
+    raycastInfo.body = proxyShape->getBody();
+    raycastInfo.proxyShape = proxyShape;
+    raycastInfo.worldPoint = localHitPoint;
+    raycastInfo.worldNormal = mPolyhedronMesh->getFaceNormal(hitFace);
 
-            // If the ray intersection with the convex mesh becomes empty, report no intersection
-            if (tMin > tMax) return false;
-        }
-    }
-
-    if (isIntersectionFound) {
-
-        // The ray intersects with the convex mesh
-        assert(tMin >= decimal(0.0));
-        assert(tMax <= ray.maxFraction);
-        assert(tMin <= tMax);
-        assert(currentFaceNormal.lengthSquare() > decimal(0.0));
-
-        // The ray intersects the three slabs, we compute the hit point
-        Vector3 localHitPoint = ray.point1 + tMin * direction;
-
-        raycastInfo.hitFraction = tMin;
-        raycastInfo.body = proxyShape->getBody();
-        raycastInfo.proxyShape = proxyShape;
-        raycastInfo.worldPoint = localHitPoint;
-        raycastInfo.worldNormal = currentFaceNormal;
-
-        return true;
-    }
-
-    return false;
+    return true;
 }
 
 // Return true if a point is inside the collision shape
@@ -50,6 +50,12 @@ class ConvexMeshShape : public ConvexPolyhedronShape {
 
     protected :
 
+        // -------------------- Constants -------------------- //
+
+        /// Minimum number of vertices of a mesh to use the hill-climbing support search
+        /// (the smaller meshes test all their vertices)
+        static const uint HILL_CLIMBING_MIN_NB_VERTICES;
+
         // -------------------- Attributes -------------------- //
 
         /// Polyhedron structure of the mesh
@@ -72,6 +78,11 @@ class ConvexMeshShape : public ConvexPolyhedronShape {
         /// Return a local support point in a given direction without the object margin.
         virtual Vector3 getLocalSupportPointWithoutMargin(const Vector3& direction) const override;
 
+        /// Return a local support point without the object margin with a hill-climbing
+        /// search that starts from a cached support vertex
+        virtual Vector3 getLocalSupportPointWithoutMarginFromVertex(const Vector3& direction,
+                                                                    uint& supportVertexIndex) const override;
+
         /// Return true if a point is inside the collision shape
         virtual bool testPointInside(const Vector3& localPoint, ProxyShape* proxyShape) const override;
 
@@ -54,3 +54,11 @@ Vector3 ConvexShape::getLocalSupportPointWithMargin(const Vector3& direction) co
 
     return supportPoint;
 }
+
+// Return a local support point without the object margin with a search that starts
+// from a cached support vertex
+/// The shapes without vertices ignore the cached vertex and use the direct support function.
+Vector3 ConvexShape::getLocalSupportPointWithoutMarginFromVertex(const Vector3& direction,
+                                                                 uint& supportVertexIndex) const {
+    return getLocalSupportPointWithoutMargin(direction);
+}
@@ -54,6 +54,11 @@ class ConvexShape : public CollisionShape {
         /// Return a local support point in a given direction without the object margin
         virtual Vector3 getLocalSupportPointWithoutMargin(const Vector3& direction) const=0;
 
+        /// Return a local support point without the object margin with a search that starts
+        /// from a cached support vertex
+        virtual Vector3 getLocalSupportPointWithoutMarginFromVertex(const Vector3& direction,
+                                                                    uint& supportVertexIndex) const;
+
     public :
 
         // -------------------- Methods -------------------- //
@@ -80,6 +85,8 @@ class ConvexShape : public CollisionShape {
 
         friend class GJKAlgorithm;
         friend class SATAlgorithm;
+        friend class EPAAlgorithm;
+        friend class ConvexVsImplicitConvexAlgorithm;
 };
 
 // Return true if the collision shape is convex, false if it is concave
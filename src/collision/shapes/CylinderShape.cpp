@@ -0,0 +1,139 @@
+/********************************************************************************
+* ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
+* Copyright (c) 2010-2018 Daniel Chappuis                                       *
+*********************************************************************************
+*                                                                               *
+* This software is provided 'as-is', without any express or implied warranty.   *
+* In no event will the authors be held liable for any damages arising from the  *
+* use of this software.                                                         *
+*                                                                               *
+* Permission is granted to anyone to use this software for any purpose,         *
+* including commercial applications, and to alter it and redistribute it        *
+* freely, subject to the following restrictions:                                *
+*                                                                               *
+* 1. The origin of this software must not be misrepresented; you must not claim *
+*    that you wrote the original software. If you use this software in a        *
+*    product, an acknowledgment in the product documentation would be           *
+*    appreciated but is not required.                                           *
+*                                                                               *
+* 2. Altered source versions must be plainly marked as such, and must not be    *
+*    misrepresented as being the original software.                             *
+*                                                                               *
+* 3. This notice may not be removed or altered from any source distribution.    *
+*                                                                               *
+********************************************************************************/
+
+// Libraries
+#include "CylinderShape.h"
+#include "collision/ProxyShape.h"
+#include "configuration.h"
+#include "collision/RaycastInfo.h"
+#include <cassert>
+
+using namespace reactphysics3d;
+
+// Constructor
+/**
+ * @param radius The radius of the cylinder (in meters)
+ * @param height The height of the cylinder (in meters)
+ * @param margin The collision margin (in meters) that rounds the edges of the cylinder
+ */
+CylinderShape::CylinderShape(decimal radius, decimal height, decimal margin)
+              : ConvexShape(CollisionShapeName::CYLINDER, CollisionShapeType::IMPLICIT_CONVEX, margin),
+                mRadius(radius), mHalfHeight(height * decimal(0.5)) {
+    assert(margin > decimal(0.0));
+    assert(radius > margin);
+    assert(mHalfHeight > margin);
+
+    // Cache the local bounds used to compute the AABBs of the shape
+    cacheLocalBounds();
+}
+
+// Return the local inertia tensor of the cylinder
+/**
+ * @param[out] tensor The 3x3 inertia tensor matrix of the shape in local-space
+ *                    coordinates
+ * @param mass Mass to use to compute the inertia tensor of the collision shape
+ */
+void CylinderShape::computeLocalInertiaTensor(Matrix3x3& tensor, decimal mass) const {
+
+    const decimal radiusSquare = mRadius * mRadius;
+    const decimal height = mHalfHeight + mHalfHeight;
+    const decimal IxxAndzz = mass * (decimal(3.0) * radiusSquare + height * height) / decimal(12.0);
+    const decimal Iyy = decimal(0.5) * mass * radiusSquare;
+    tensor.setAllValues(IxxAndzz, 0.0, 0.0,
+                        0.0, Iyy, 0.0,
+                        0.0, 0.0, IxxAndzz);
+}
+
+// Raycast method with feedback information
+/// The ray is clipped by the slab between the two caps and by the infinite cylinder around
+/// the Y axis. The hit is the entry point of the intersection of both intervals. The rounded
+/// edges of the margin are ignored.
+bool CylinderShape::raycast(const Ray& ray, RaycastInfo& raycastInfo, ProxyShape* proxyShape, MemoryAllocator& allocator) const {
+
+    const Vector3 rayDirection = ray.point2 - ray.point1;
+    decimal tMin = DECIMAL_SMALLEST;
+    decimal tMax = DECIMAL_LARGEST;
+    bool isCapHit = false;
+
+    // Intersection of the ray with the slab between the two caps
+    if (std::abs(rayDirection.y) < MACHINE_EPSILON) {
+
+        // If the ray is parallel to the caps and its origin is not between them, there is no hit
+        if (ray.point1.y > mHalfHeight || ray.point1.y < -mHalfHeight) return false;
+    }
+    else {
+        decimal t1 = (-mHalfHeight - ray.point1.y) / rayDirection.y;
+        decimal t2 = (mHalfHeight - ray.point1.y) / rayDirection.y;
+        if (t1 > t2) std::swap(t1, t2);
+        tMin = t1;
+        tMax = t2;
+        isCapHit = true;
+    }
+
+    // Intersection of the ray with the infinite cylinder
+    const decimal a = rayDirection.x * rayDirection.x + rayDirection.z * rayDirection.z;
+    const decimal b = ray.point1.x * rayDirection.x + ray.point1.z * rayDirection.z;
+    const decimal c = ray.point1.x * ray.point1.x + ray.point1.z * ray.point1.z - mRadius * mRadius;
+    if (a < MACHINE_EPSILON) {
+
+        // If the ray is parallel to the axis and its origin is outside the cylinder, there is no hit
+        if (c > decimal(0.0)) return false;
+    }
+    else {
+
+        // If the discriminant is negative, the ray misses the infinite cylinder
+        const decimal discriminant = b * b - a * c;
+        if (discriminant < decimal(0.0)) return false;
+
+        const decimal sqrtDiscriminant = std::sqrt(discriminant);
+        const decimal t1 = (-b - sqrtDiscriminant) / a;
+        const decimal t2 = (-b + sqrtDiscriminant) / a;
+        if (t1 > tMin) {
+            tMin = t1;
+            isCapHit = false;
+        }
+        tMax = std::min(tMax, t2);
+    }
+
+    // If the intersection is empty, behind the origin of the ray (the origin is inside the
+    // cylinder) or beyond the maximum raycasting distance, we return no hit
+    if (tMin > tMax || tMin < decimal(0.0) || tMin > ray.maxFraction) return false;
+
+    // Compute the hit information
+    const Vector3 localHitPoint = ray.point1 + tMin * rayDirection;
+    raycastInfo.body = proxyShape->getBody();
+    raycastInfo.proxyShape = proxyShape;
+    raycastInfo.hitFraction = tMin;
+    raycastInfo.worldPoint = localHitPoint;
+    if (isCapHit) {
+        raycastInfo.worldNormal = Vector3(decimal(0.0), rayDirection.y > decimal(0.0) ? decimal(-1.0) : decimal(1.0),
+                                          decimal(0.0));
+    }
+    else {
+        raycastInfo.worldNormal = Vector3(localHitPoint.x, decimal(0.0), localHitPoint.z);
+    }
+
+    return true;
+}
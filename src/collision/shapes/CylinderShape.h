@@ -0,0 +1,185 @@
+/********************************************************************************
+* ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
+* Copyright (c) 2010-2018 Daniel Chappuis                                       *
+*********************************************************************************
+*                                                                               *
+* This software is provided 'as-is', without any express or implied warranty.   *
+* In no event will the authors be held liable for any damages arising from the  *
+* use of this software.                                                         *
+*                                                                               *
+* Permission is granted to anyone to use this software for any purpose,         *
+* including commercial applications, and to alter it and redistribute it        *
+* freely, subject to the following restrictions:                                *
+*                                                                               *
+* 1. The origin of this software must not be misrepresented; you must not claim *
+*    that you wrote the original software. If you use this software in a        *
+*    product, an acknowledgment in the product documentation would be           *
+*    appreciated but is not required.                                           *
+*                                                                               *
+* 2. Altered source versions must be plainly marked as such, and must not be    *
+*    misrepresented as being the original software.                             *
+*                                                                               *
+* 3. This notice may not be removed or altered from any source distribution.    *
+*                                                                               *
+********************************************************************************/
+
+#ifndef REACTPHYSICS3D_CYLINDER_SHAPE_H
+#define REACTPHYSICS3D_CYLINDER_SHAPE_H
+
+// Libraries
+#include "ConvexShape.h"
+#include "mathematics/mathematics.h"
+
+// ReactPhysics3D namespace
+namespace reactphysics3d {
+
+// Declarations
+class CollisionBody;
+
+// Class CylinderShape
+/**
+ * This class represents a cylinder collision shape that is centered at the origin and
+ * defined around the Y axis by its radius and its height. The cylinder is not a polyhedron:
+ * its support point is computed in constant time from the direction and the collision
+ * detection uses the GJK and EPA algorithms. The GJK algorithm needs an object margin. The
+ * original object (without margin) is a smaller cylinder and the margin is added around it
+ * so that the shape keeps the given radius and height with edges rounded by the margin.
+ */
+class CylinderShape : public ConvexShape {
+
+    protected :
+
+        // -------------------- Attributes -------------------- //
+
+        /// Radius of the cylinder
+        decimal mRadius;
+
+        /// Half height of the cylinder
+        decimal mHalfHeight;
+
+        // -------------------- Methods -------------------- //
+
+        /// Return a local support point in a given direction without the object margin
+        virtual Vector3 getLocalSupportPointWithoutMargin(const Vector3& direction) const override;
+
+        /// Return true if a point is inside the collision shape
+        virtual bool testPointInside(const Vector3& localPoint, ProxyShape* proxyShape) const override;
+
+        /// Raycast method with feedback information
+        virtual bool raycast(const Ray& ray, RaycastInfo& raycastInfo, ProxyShape* proxyShape, MemoryAllocator& allocator) const override;
+
+        /// Return the number of bytes used by the collision shape
+        virtual size_t getSizeInBytes() const override;
+
+    public :
+
+        // -------------------- Methods -------------------- //
+
+        /// Constructor
+        CylinderShape(decimal radius, decimal height, decimal margin = decimal(0.04));
+
+        /// Destructor
+        virtual ~CylinderShape() override = default;
+
+        /// Deleted copy-constructor
+        CylinderShape(const CylinderShape& shape) = delete;
+
+        /// Deleted assignment operator
+        CylinderShape& operator=(const CylinderShape& shape) = delete;
+
+        /// Return the radius of the cylinder
+        decimal getRadius() const;
+
+        /// Return the height of the cylinder
+        decimal getHeight() const;
+
+        /// Return the local bounds of the shape in x, y and z directions
+        virtual void getLocalBounds(Vector3& min, Vector3& max) const override;
+
+        /// Return true if the collision shape is a polyhedron
+        virtual bool isPolyhedron() const override;
+
+        /// Return the local inertia tensor of the collision shape
+        virtual void computeLocalInertiaTensor(Matrix3x3& tensor, decimal mass) const override;
+
+        /// Return the string representation of the shape
+        virtual std::string to_string() const override;
+};
+
+// Return the radius of the cylinder
+/**
+ * @return The radius of the cylinder shape (in meters)
+ */
+inline decimal CylinderShape::getRadius() const {
+    return mRadius;
+}
+
+// Return the height of the cylinder
+/**
+ * @return The height of the cylinder shape (in meters)
+ */
+inline decimal CylinderShape::getHeight() const {
+    return mHalfHeight + mHalfHeight;
+}
+
+// Return the number of bytes used by the collision shape
+inline size_t CylinderShape::getSizeInBytes() const {
+    return sizeof(CylinderShape);
+}
+
+// Return the local bounds of the shape in x, y and z directions
+/**
+ * @param min The minimum bounds of the shape in local-space coordinates
+ * @param max The maximum bounds of the shape in local-space coordinates
+ */
+inline void CylinderShape::getLocalBounds(Vector3& min, Vector3& max) const {
+
+    // Maximum bounds
+    max.x = mRadius;
+    max.y = mHalfHeight;
+    max.z = mRadius;
+
+    // Minimum bounds
+    min.x = -mRadius;
+    min.y = -mHalfHeight;
+    min.z = -mRadius;
+}
+
+// Return true if the collision shape is a polyhedron
+inline bool CylinderShape::isPolyhedron() const {
+    return false;
+}
+
+// Return a local support point in a given direction without the object margin
+/// The support point of the original cylinder (whose radius and half height are reduced by
+/// the margin) is on the rim of the cap in the direction of the Y component of the direction.
+inline Vector3 CylinderShape::getLocalSupportPointWithoutMargin(const Vector3& direction) const {
+
+    const decimal radius = mRadius - mMargin;
+    const decimal halfHeight = mHalfHeight - mMargin;
+    const decimal y = direction.y < decimal(0.0) ? -halfHeight : halfHeight;
+
+    const decimal lengthXZSquare = direction.x * direction.x + direction.z * direction.z;
+    if (lengthXZSquare > MACHINE_EPSILON * MACHINE_EPSILON) {
+        const decimal factor = radius / std::sqrt(lengthXZSquare);
+        return Vector3(direction.x * factor, y, direction.z * factor);
+    }
+
+    return Vector3(decimal(0.0), y, decimal(0.0));
+}
+
+// Return true if a point is inside the collision shape
+inline bool CylinderShape::testPointInside(const Vector3& localPoint, ProxyShape* proxyShape) const {
+    return localPoint.y < mHalfHeight && localPoint.y > -mHalfHeight &&
+           localPoint.x * localPoint.x + localPoint.z * localPoint.z < mRadius * mRadius;
+}
+
+// Return the string representation of the shape
+inline std::string CylinderShape::to_string() const {
+    return "CylinderShape{halfHeight=" + std::to_string(mHalfHeight) + ", radius=" + std::to_string(mRadius) +
+           ", margin=" + std::to_string(mMargin) + "}";
+}
+
+}
+
+#endif
@@ -27,6 +27,10 @@
 #include "HeightFieldShape.h"
 #include "collision/RaycastInfo.h"
 #include "utils/Profiler.h"
+#include "memory/MemoryManager.h"
+#include <algorithm>
+#include <cmath>
+#include <type_traits>
 
 using namespace reactphysics3d;
 
@@ -47,16 +51,71 @@ HeightFieldShape::HeightFieldShape(int nbGridColumns, int nbGridRows, decimal mi
                  : ConcaveShape(CollisionShapeName::HEIGHTFIELD), mNbColumns(nbGridColumns), mNbRows(nbGridRows),
                    mWidth(nbGridColumns - 1), mLength(nbGridRows - 1), mMinHeight(minHeight),
                    mMaxHeight(maxHeight), mUpAxis(upAxis), mIntegerHeightScale(integerHeightScale),
-                   mHeightDataType(dataType), mScaling(scaling) {
+                   mHeightDataType(dataType), mTileNbCellColumns(nbGridColumns - 1),
+                   mTileNbCellRows(nbGridRows - 1), mNbTileColumns(1), mNbTileRows(1),
+                   mTilesHeightData(MemoryManager::getBaseAllocator()),
+                   mTilesCellHoles(MemoryManager::getBaseAllocator()), mScaling(scaling),
+                   mBlocksHeightBounds(MemoryManager::getBaseAllocator()),
+                   mLevelsFirstBlock(MemoryManager::getBaseAllocator()),
+                   mLevelsNbColumns(MemoryManager::getBaseAllocator()),
+                   mLevelsNbRows(MemoryManager::getBaseAllocator()) {
+
+    initialize();
+
+    // The grid has a single tile with all the height values
+    setTileData(0, 0, heightFieldData);
+
+    // Cache the local bounds used to compute the AABBs of the shape
+    cacheLocalBounds();
+}
+
+// Constructor of a tiled height field without any resident tile
+/**
+ * The height values of the tiles are set with the setTileData() method. A tile has
+ * nbTileCells x nbTileCells cells and its height values are the (nbTileCells + 1) x (nbTileCells + 1)
+ * grid points of its cells (the grid points on the border between two tiles are in both tiles).
+ * @param nbGridColumns Number of columns in the grid of the height field
+ * @param nbGridRows Number of rows in the grid of the height field
+ * @param nbTileCells Number of columns (and rows) of cells in a tile
+ * @param minHeight Minimum height value of the height field
+ * @param maxHeight Maximum height value of the height field
+ * @param dataType Data type for the height values (int, float, double)
+ * @param upAxis Integer representing the up axis direction (0 for x, 1 for y and 2 for z)
+ * @param integerHeightScale Scaling factor used to scale the height values (only when height values type is integer)
+ */
+HeightFieldShape::HeightFieldShape(int nbGridColumns, int nbGridRows, int nbTileCells, decimal minHeight,
+                                   decimal maxHeight, HeightDataType dataType, int upAxis,
+                                   decimal integerHeightScale, const Vector3& scaling)
+                 : ConcaveShape(CollisionShapeName::HEIGHTFIELD), mNbColumns(nbGridColumns), mNbRows(nbGridRows),
+                   mWidth(nbGridColumns - 1), mLength(nbGridRows - 1), mMinHeight(minHeight),
+                   mMaxHeight(maxHeight), mUpAxis(upAxis), mIntegerHeightScale(integerHeightScale),
+                   mHeightDataType(dataType), mTileNbCellColumns(nbTileCells), mTileNbCellRows(nbTileCells),
+                   mNbTileColumns((nbGridColumns - 1 + nbTileCells - 1) / nbTileCells),
+                   mNbTileRows((nbGridRows - 1 + nbTileCells - 1) / nbTileCells),
+                   mTilesHeightData(MemoryManager::getBaseAllocator()),
+                   mTilesCellHoles(MemoryManager::getBaseAllocator()), mScaling(scaling),
+                   mBlocksHeightBounds(MemoryManager::getBaseAllocator()),
+                   mLevelsFirstBlock(MemoryManager::getBaseAllocator()),
+                   mLevelsNbColumns(MemoryManager::getBaseAllocator()),
+                   mLevelsNbRows(MemoryManager::getBaseAllocator()) {
+
+    assert(nbTileCells >= 1);
+
+    initialize();
+
+    // Cache the local bounds used to compute the AABBs of the shape
+    cacheLocalBounds();
+}
+
+// Compute the local AABB and allocate the tiles and the height pyramid
+void HeightFieldShape::initialize() {
 
-    assert(nbGridColumns >= 2);
-    assert(nbGridRows >= 2);
+    assert(mNbColumns >= 2);
+    assert(mNbRows >= 2);
     assert(mWidth >= 1);
     assert(mLength >= 1);
-    assert(minHeight <= maxHeight);
-    assert(upAxis == 0 || upAxis == 1 || upAxis == 2);
-
-    mHeightFieldData = heightFieldData;
+    assert(mMinHeight <= mMaxHeight);
+    assert(mUpAxis == 0 || mUpAxis == 1 || mUpAxis == 2);
 
     decimal halfHeight = (mMaxHeight - mMinHeight) * decimal(0.5);
     assert(halfHeight >= 0);
@@ -74,6 +133,217 @@ HeightFieldShape::HeightFieldShape(int nbGridColumns, int nbGridRows, decimal mi
         mAABB.setMin(Vector3(-mWidth * decimal(0.5), -mLength * decimal(0.5), -halfHeight));
         mAABB.setMax(Vector3(mWidth * decimal(0.5), mLength * decimal(0.5), halfHeight));
     }
+
+    // No tile is resident yet
+    const int nbTiles = mNbTileColumns * mNbTileRows;
+    mTilesHeightData.reserve(nbTiles);
+    mTilesCellHoles.reserve(nbTiles);
+    for (int i=0; i < nbTiles; i++) {
+        mTilesHeightData.add(nullptr);
+        mTilesCellHoles.add(nullptr);
+    }
+
+    // Select the method that tests the triangles of the cells for the type of the height values
+    // so that the type is not checked again for each height value
+    switch (mHeightDataType) {
+        case HeightDataType::HEIGHT_FLOAT_TYPE:
+            mTestCellsTrianglesMethod = &HeightFieldShape::testCellsTrianglesOfType<float>;
+            break;
+        case HeightDataType::HEIGHT_DOUBLE_TYPE:
+            mTestCellsTrianglesMethod = &HeightFieldShape::testCellsTrianglesOfType<double>;
+            break;
+        case HeightDataType::HEIGHT_INT_TYPE:
+            mTestCellsTrianglesMethod = &HeightFieldShape::testCellsTrianglesOfType<int>;
+            break;
+    }
+
+    initHeightPyramid();
+}
+
+// Allocate the levels of the height pyramid
+/// The blocks are created empty (without any resident cell)
+void HeightFieldShape::initHeightPyramid() {
+
+    // The blocks of the first level are the cells of the grid and each block of the
+    // next level contains (up to) 2x2 blocks of the previous level
+    int nbColumns = mNbColumns - 1;
+    int nbRows = mNbRows - 1;
+    uint nbBlocks = 0;
+    while (true) {
+
+        mLevelsFirstBlock.add(nbBlocks);
+        mLevelsNbColumns.add(nbColumns);
+        mLevelsNbRows.add(nbRows);
+        nbBlocks += nbColumns * nbRows;
+
+        if (nbColumns == 1 && nbRows == 1) break;
+
+        nbColumns = (nbColumns + 1) / 2;
+        nbRows = (nbRows + 1) / 2;
+    }
+
+    mBlocksHeightBounds.reserve(2 * nbBlocks);
+    for (uint i=0; i < nbBlocks; i++) {
+        mBlocksHeightBounds.add(DECIMAL_LARGEST);
+        mBlocksHeightBounds.add(-DECIMAL_LARGEST);
+    }
+}
+
+// Update the minimum and maximum heights of the blocks of the height pyramid that contain some cells
+/// The heights of the cells (i, j) with iMin <= i < iMax and jMin <= j < jMax are recomputed and
+/// then the heights of the blocks of the next levels that contain them. A cell that is a hole
+/// or in a tile that is not resident has an empty range of heights.
+void HeightFieldShape::updateHeightPyramid(int iMin, int iMax, int jMin, int jMax) {
+
+    assert(iMin >= 0 && iMin < iMax && iMax <= mNbColumns - 1);
+    assert(jMin >= 0 && jMin < jMax && jMax <= mNbRows - 1);
+
+    // Height values origin
+    const decimal heightOrigin = -(mMaxHeight - mMinHeight) * decimal(0.5) - mMinHeight;
+
+    for (int j=jMin; j < jMax; j++) {
+        for (int i=iMin; i < iMax; i++) {
+
+            const uint blockIndex = 2 * (mLevelsFirstBlock[0] + j * mLevelsNbColumns[0] + i);
+
+            if (isCellHole(i, j)) {
+                mBlocksHeightBounds[blockIndex] = DECIMAL_LARGEST;
+                mBlocksHeightBounds[blockIndex + 1] = -DECIMAL_LARGEST;
+                continue;
+            }
+
+            const int tileI = i / mTileNbCellColumns;
+            const int tileJ = j / mTileNbCellRows;
+            const int tileIndex = getTileIndex(tileI, tileJ);
+            const int x = i - tileI * mTileNbCellColumns;
+            const int y = j - tileJ * mTileNbCellRows;
+
+            const decimal height1 = getTileHeightAt(tileIndex, x, y);
+            const decimal height2 = getTileHeightAt(tileIndex, x + 1, y);
+            const decimal height3 = getTileHeightAt(tileIndex, x, y + 1);
+            const decimal height4 = getTileHeightAt(tileIndex, x + 1, y + 1);
+            mBlocksHeightBounds[blockIndex] = heightOrigin + std::min(std::min(height1, height2), std::min(height3, height4));
+            mBlocksHeightBounds[blockIndex + 1] = heightOrigin + std::max(std::max(height1, height2), std::max(height3, height4));
+        }
+    }
+
+    // Update the blocks of the next levels that contain the blocks of the previous level
+    const int nbLevels = static_cast<int>(mLevelsFirstBlock.size());
+    for (int level = 1; level < nbLevels; level++) {
+
+        const int previousNbColumns = mLevelsNbColumns[level - 1];
+        const int previousNbRows = mLevelsNbRows[level - 1];
+        iMin = iMin / 2;
+        jMin = jMin / 2;
+        iMax = (iMax + 1) / 2;
+        jMax = (jMax + 1) / 2;
+
+        for (int j=jMin; j < jMax; j++) {
+            for (int i=iMin; i < iMax; i++) {
+
+                decimal minHeight = DECIMAL_LARGEST;
+                decimal maxHeight = -DECIMAL_LARGEST;
+                for (int childJ = 2 * j; childJ < std::min(2 * j + 2, previousNbRows); childJ++) {
+                    for (int childI = 2 * i; childI < std::min(2 * i + 2, previousNbColumns); childI++) {
+                        minHeight = std::min(minHeight, getBlockMinHeight(level - 1, childI, childJ));
+                        maxHeight = std::max(maxHeight, getBlockMaxHeight(level - 1, childI, childJ));
+                    }
+                }
+
+                const uint blockIndex = 2 * (mLevelsFirstBlock[level] + j * mLevelsNbColumns[level] + i);
+                mBlocksHeightBounds[blockIndex] = minHeight;
+                mBlocksHeightBounds[blockIndex + 1] = maxHeight;
+            }
+        }
+    }
+}
+
+// Set the height values (and the holes) of a tile of the height field
+/**
+ * The height values and the hole flags are shared and not copied. They must remain valid until
+ * the tile is removed or set again. The height values must be between the minimum and maximum
+ * heights of the height field. Only the blocks of the height pyramid that contain the tile are updated.
+ * @param tileI Column of the tile
+ * @param tileJ Row of the tile
+ * @param heightData Pointer to the (nbTileCells + 1) x (nbTileCells + 1) height values of the tile
+ *                   (row by row). The grid points of a last tile that are outside of the grid are ignored.
+ * @param cellHoles Pointer to the nbTileCells x nbTileCells flags of the cells of the tile (row by row) where
+ *                  a non-zero flag is a hole in the height field (or null if the tile does not have any hole)
+ */
+void HeightFieldShape::setTileData(int tileI, int tileJ, const void* heightData, const uint8* cellHoles) {
+
+    assert(heightData != nullptr);
+
+    const int tileIndex = getTileIndex(tileI, tileJ);
+    mTilesHeightData[tileIndex] = heightData;
+    mTilesCellHoles[tileIndex] = cellHoles;
+
+    updateHeightPyramid(tileI * mTileNbCellColumns, std::min((tileI + 1) * mTileNbCellColumns, mNbColumns - 1),
+                        tileJ * mTileNbCellRows, std::min((tileJ + 1) * mTileNbCellRows, mNbRows - 1));
+}
+
+// Remove the height values of a tile of the height field
+/**
+ * The cells of the tile do not collide anymore until the tile is set again
+ * @param tileI Column of the tile
+ * @param tileJ Row of the tile
+ */
+void HeightFieldShape::removeTileData(int tileI, int tileJ) {
+
+    const int tileIndex = getTileIndex(tileI, tileJ);
+    mTilesHeightData[tileIndex] = nullptr;
+    mTilesCellHoles[tileIndex] = nullptr;
+
+    updateHeightPyramid(tileI * mTileNbCellColumns, std::min((tileI + 1) * mTileNbCellColumns, mNbColumns - 1),
+                        tileJ * mTileNbCellRows, std::min((tileJ + 1) * mTileNbCellRows, mNbRows - 1));
+}
+
+// Return true if a cell of the grid is a hole (or is in a tile that is not resident)
+/// The cell (i, j) is the rectangle between the grid points (i, j) and (i + 1, j + 1).
+bool HeightFieldShape::isCellHole(int i, int j) const {
+
+    assert(i >= 0 && i < mNbColumns - 1);
+    assert(j >= 0 && j < mNbRows - 1);
+
+    const int tileI = i / mTileNbCellColumns;
+    const int tileJ = j / mTileNbCellRows;
+    const int tileIndex = getTileIndex(tileI, tileJ);
+    if (mTilesHeightData[tileIndex] == nullptr) return true;
+
+    const uint8* cellHoles = mTilesCellHoles[tileIndex];
+    if (cellHoles == nullptr) return false;
+
+    const int x = i - tileI * mTileNbCellColumns;
+    const int y = j - tileJ * mTileNbCellRows;
+    return cellHoles[y * mTileNbCellColumns + x] != 0;
+}
+
+// Return the height of a given (x,y) point in the height field
+/// The grid point must be in a resident tile. A grid point on the border between
+/// two tiles is read from any of them that is resident.
+decimal HeightFieldShape::getHeightAt(int x, int y) const {
+
+    assert(x >= 0 && x < mNbColumns);
+    assert(y >= 0 && y < mNbRows);
+
+    const int tileIMax = std::min(x / mTileNbCellColumns, mNbTileColumns - 1);
+    const int tileJMax = std::min(y / mTileNbCellRows, mNbTileRows - 1);
+    const int tileIMin = (x > 0 && x % mTileNbCellColumns == 0) ? x / mTileNbCellColumns - 1 : tileIMax;
+    const int tileJMin = (y > 0 && y % mTileNbCellRows == 0) ? y / mTileNbCellRows - 1 : tileJMax;
+
+    for (int tileJ = tileJMin; tileJ <= tileJMax; tileJ++) {
+        for (int tileI = tileIMin; tileI <= tileIMax; tileI++) {
+
+            const int tileIndex = getTileIndex(tileI, tileJ);
+            if (mTilesHeightData[tileIndex] != nullptr) {
+                return getTileHeightAt(tileIndex, x - tileI * mTileNbCellColumns, y - tileJ * mTileNbCellRows);
+            }
+        }
+    }
+
+    // The grid point is not in a resident tile
+    assert(false);
+    return 0;
 }
 
 // Return the local bounds of the shape in x, y and z directions.
@@ -93,6 +363,33 @@ void HeightFieldShape::getLocalBounds(Vector3& min, Vector3& max) const {
 // and then for each rectangle in the sub-grid we generate two triangles that we use to test collision.
 void HeightFieldShape::testAllTriangles(TriangleCallback& callback, const AABB& localAABB) const {
 
+   // Compute the sub-grid of cells that overlap the AABB
+   int iMin, iMax, jMin, jMax;
+   computeOverlappingCells(localAABB, iMin, iMax, jMin, jMax);
+
+   // Compute the non-scaled range of heights of the AABB
+   const decimal inverseUpScaling = decimal(1.0) / mScaling[mUpAxis];
+   const decimal minHeight = localAABB.getMin()[mUpAxis] * inverseUpScaling;
+   const decimal maxHeight = localAABB.getMax()[mUpAxis] * inverseUpScaling;
+
+   // Test the cells of the sub-grid (except the last points on each dimension) from the
+   // top of the height pyramid to skip the blocks of cells outside of the heights of the AABB
+   const int topLevel = static_cast<int>(mLevelsNbColumns.size()) - 1;
+   testBlockTriangles(callback, topLevel, 0, 0, iMin, iMax, jMin, jMax, minHeight, maxHeight);
+}
+
+// Compute the sub-grid of cells of the height field that overlap a given AABB
+/// The overlapping cells (i, j) are the ones with iMin <= i < iMax and jMin <= j < jMax.
+/**
+ * @param localAABB The AABB (in local-space of the height field) to test
+ * @param[out] iMin The first column of cells of the sub-grid
+ * @param[out] iMax The column after the last column of cells of the sub-grid
+ * @param[out] jMin The first row of cells of the sub-grid
+ * @param[out] jMax The row after the last row of cells of the sub-grid
+ */
+void HeightFieldShape::computeOverlappingCells(const AABB& localAABB, int& iMin, int& iMax,
+                                               int& jMin, int& jMax) const {
+
    // Compute the non-scaled AABB
    Vector3 inverseScaling(decimal(1.0) / mScaling.x, decimal(1.0) / mScaling.y, decimal(1.0) / mScaling.z);
    AABB aabb(localAABB.getMin() * inverseScaling, localAABB.getMax() * inverseScaling);
@@ -103,10 +400,10 @@ void HeightFieldShape::testAllTriangles(TriangleCallback& callback, const AABB&
    computeMinMaxGridCoordinates(minGridCoords, maxGridCoords, aabb);
 
    // Compute the starting and ending coords of the sub-grid according to the up axis
-   int iMin = 0;
-   int iMax = 0;
-   int jMin = 0;
-   int jMax = 0;
+   iMin = 0;
+   iMax = 0;
+   jMin = 0;
+   jMax = 0;
    switch(mUpAxis) {
         case 0 : iMin = clamp(minGridCoords[1], 0, mNbColumns - 1);
                  iMax = clamp(maxGridCoords[1], 0, mNbColumns - 1);
@@ -129,56 +426,195 @@ void HeightFieldShape::testAllTriangles(TriangleCallback& callback, const AABB&
    assert(iMax >= 0 && iMax < mNbColumns);
    assert(jMin >= 0 && jMin < mNbRows);
    assert(jMax >= 0 && jMax < mNbRows);
+}
 
-   // For each sub-grid points (except the last ones one each dimension)
-   for (int i = iMin; i < iMax; i++) {
-       for (int j = jMin; j < jMax; j++) {
-
-           // Compute the four point of the current quad
-           const Vector3 p1 = getVertexAt(i, j);
-           const Vector3 p2 = getVertexAt(i, j + 1);
-           const Vector3 p3 = getVertexAt(i + 1, j);
-           const Vector3 p4 = getVertexAt(i + 1, j + 1);
-
-           // Generate the first triangle for the current grid rectangle
-           Vector3 trianglePoints[3] = {p1, p2, p3};
-
-           // Compute the triangle normal
-           Vector3 triangle1Normal = (p2 - p1).cross(p3 - p1).getUnit();
-
-           // Use the triangle face normal as vertices normals (this is an aproximation. The correct
-           // solution would be to compute all the normals of the neighbor triangles and use their
-           // weighted average (with incident angle as weight) at the vertices. However, this solution
-           // seems too expensive (it requires to compute the normal of all neighbor triangles instead
-           // and compute the angle of incident edges with asin(). Maybe we could also precompute the
-           // vertices normal at the HeightFieldShape constructor but it will require extra memory to
-           // store them.
-           Vector3 verticesNormals1[3] = {triangle1Normal, triangle1Normal, triangle1Normal};
-
-           // Test collision against the first triangle
-           callback.testTriangle(trianglePoints, verticesNormals1, computeTriangleShapeId(i, j, 0));
-
-           // Generate the second triangle for the current grid rectangle
-           trianglePoints[0] = p3;
-           trianglePoints[1] = p2;
-           trianglePoints[2] = p4;
-
-           // Compute the triangle normal
-           Vector3 triangle2Normal = (p2 - p3).cross(p4 - p3).getUnit();
-
-           // Use the triangle face normal as vertices normals (this is an aproximation. The correct
-           // solution would be to compute all the normals of the neighbor triangles and use their
-           // weighted average (with incident angle as weight) at the vertices. However, this solution
-           // seems too expensive (it requires to compute the normal of all neighbor triangles instead
-           // and compute the angle of incident edges with asin(). Maybe we could also precompute the
-           // vertices normal at the HeightFieldShape constructor but it will require extra memory to
-           // store them.
-           Vector3 verticesNormals2[3] = {triangle2Normal, triangle2Normal, triangle2Normal};
-
-           // Test collision against the second triangle
-           callback.testTriangle(trianglePoints, verticesNormals2, computeTriangleShapeId(i, j, 1));
-       }
-   }
+// Use a callback method on the triangles of the cells of a block of the height pyramid
+/// Only the cells (i, j) with iMin <= i < iMax and jMin <= j < jMax whose heights overlap the
+/// range [minHeight, maxHeight] (non-scaled) are tested.
+void HeightFieldShape::testBlockTriangles(TriangleCallback& callback, int level, int blockI, int blockJ,
+                                          int iMin, int iMax, int jMin, int jMax,
+                                          decimal minHeight, decimal maxHeight) const {
+
+    // If the heights of the block do not overlap the heights range
+    if (getBlockMinHeight(level, blockI, blockJ) > maxHeight ||
+        getBlockMaxHeight(level, blockI, blockJ) < minHeight) {
+        return;
+    }
+
+    // If the cells of the block are outside of the sub-grid
+    const int blockSize = 1 << level;
+    if (blockI * blockSize >= iMax || (blockI + 1) * blockSize <= iMin ||
+        blockJ * blockSize >= jMax || (blockJ + 1) * blockSize <= jMin) {
+        return;
+    }
+
+    // The cells of the small blocks are tested with a loop over their rows
+    if (level <= CELLS_LOOP_LEVEL) {
+        (this->*mTestCellsTrianglesMethod)(callback, std::max(iMin, blockI * blockSize),
+                                           std::min(iMax, (blockI + 1) * blockSize),
+                                           std::max(jMin, blockJ * blockSize),
+                                           std::min(jMax, (blockJ + 1) * blockSize), minHeight, maxHeight);
+        return;
+    }
+
+    // Test the blocks of the previous level inside this block
+    const int childIMax = std::min(2 * blockI + 2, mLevelsNbColumns[level - 1]);
+    const int childJMax = std::min(2 * blockJ + 2, mLevelsNbRows[level - 1]);
+    for (int childI = 2 * blockI; childI < childIMax; childI++) {
+        for (int childJ = 2 * blockJ; childJ < childJMax; childJ++) {
+            testBlockTriangles(callback, level - 1, childI, childJ, iMin, iMax, jMin, jMax, minHeight, maxHeight);
+        }
+    }
+}
+
+// Use a callback method on the two triangles of a cell of the grid
+/// The cell (i, j) is the rectangle between the grid points (i, j) and (i + 1, j + 1).
+void HeightFieldShape::testCellTriangles(TriangleCallback& callback, int i, int j) const {
+
+    // Compute the four point of the current quad
+    Vector3 cellVertices[4];
+    getCellVertices(i, j, cellVertices);
+
+    testCellTriangles(callback, i, j, cellVertices[0], cellVertices[1], cellVertices[2], cellVertices[3]);
+}
+
+// Use a callback method on the two triangles of a cell of the grid with given vertices
+/// The vertices p1, p2, p3 and p4 are the grid points (i, j), (i, j + 1), (i + 1, j) and (i + 1, j + 1).
+void HeightFieldShape::testCellTriangles(TriangleCallback& callback, int i, int j, const Vector3& p1,
+                                         const Vector3& p2, const Vector3& p3, const Vector3& p4) const {
+
+    assert(i >= 0 && i < mNbColumns - 1);
+    assert(j >= 0 && j < mNbRows - 1);
+
+    // Generate the first triangle for the current grid rectangle
+    Vector3 trianglePoints[3] = {p1, p2, p3};
+
+    // Compute the triangle normal
+    Vector3 triangle1Normal = (p2 - p1).cross(p3 - p1).getUnit();
+
+    // Use the triangle face normal as vertices normals (this is an aproximation. The correct
+    // solution would be to compute all the normals of the neighbor triangles and use their
+    // weighted average (with incident angle as weight) at the vertices. However, this solution
+    // seems too expensive (it requires to compute the normal of all neighbor triangles instead
+    // and compute the angle of incident edges with asin(). Maybe we could also precompute the
+    // vertices normal at the HeightFieldShape constructor but it will require extra memory to
+    // store them.
+    Vector3 verticesNormals1[3] = {triangle1Normal, triangle1Normal, triangle1Normal};
+
+    // Test collision against the first triangle
+    callback.testTriangle(trianglePoints, verticesNormals1, computeTriangleShapeId(i, j, 0));
+
+    // Generate the second triangle for the current grid rectangle
+    trianglePoints[0] = p3;
+    trianglePoints[1] = p2;
+    trianglePoints[2] = p4;
+
+    // Compute the triangle normal
+    Vector3 triangle2Normal = (p2 - p3).cross(p4 - p3).getUnit();
+
+    // Use the triangle face normal as vertices normals (see above)
+    Vector3 verticesNormals2[3] = {triangle2Normal, triangle2Normal, triangle2Normal};
+
+    // Test collision against the second triangle
+    callback.testTriangle(trianglePoints, verticesNormals2, computeTriangleShapeId(i, j, 1));
+}
+
+// Use a callback method on the triangles of the cells of a sub-grid for a type of height values
+/// Only the cells (i, j) with iMin <= i < iMax and jMin <= j < jMax whose heights overlap the
+/// range [minHeight, maxHeight] (non-scaled) are tested. The height values are read directly
+/// from the data of the tiles and the two vertices shared by a cell and the next cell of the
+/// same row are only computed once.
+template<typename HeightType>
+void HeightFieldShape::testCellsTrianglesOfType(TriangleCallback& callback, int iMin, int iMax, int jMin, int jMax,
+                                                decimal minHeight, decimal maxHeight) const {
+
+    if (iMin >= iMax || jMin >= jMax) return;
+
+    const decimal heightScale = std::is_integral<HeightType>::value ? mIntegerHeightScale : decimal(1.0);
+    const int nbTileColumnPoints = mTileNbCellColumns + 1;
+
+    // For each tile that contains some cells of the sub-grid
+    for (int tileJ = jMin / mTileNbCellRows; tileJ <= (jMax - 1) / mTileNbCellRows; tileJ++) {
+        for (int tileI = iMin / mTileNbCellColumns; tileI <= (iMax - 1) / mTileNbCellColumns; tileI++) {
+
+            const int tileIndex = getTileIndex(tileI, tileJ);
+            const HeightType* heightData = static_cast<const HeightType*>(mTilesHeightData[tileIndex]);
+            if (heightData == nullptr) continue;
+            const uint8* cellHoles = mTilesCellHoles[tileIndex];
+
+            // Cells of the sub-grid inside the tile
+            const int tileFirstI = tileI * mTileNbCellColumns;
+            const int tileFirstJ = tileJ * mTileNbCellRows;
+            const int cellsIMin = std::max(iMin, tileFirstI);
+            const int cellsIMax = std::min(iMax, tileFirstI + mTileNbCellColumns);
+            const int cellsJMin = std::max(jMin, tileFirstJ);
+            const int cellsJMax = std::min(jMax, tileFirstJ + mTileNbCellRows);
+
+            for (int j = cellsJMin; j < cellsJMax; j++) {
+
+                const int y = j - tileFirstJ;
+                const HeightType* rowHeights = heightData + y * nbTileColumnPoints;
+                const HeightType* nextRowHeights = rowHeights + nbTileColumnPoints;
+
+                // Vertices of the first column of the row
+                int x = cellsIMin - tileFirstI;
+                decimal height1 = decimal(rowHeights[x]) * heightScale;
+                decimal height2 = decimal(nextRowHeights[x]) * heightScale;
+                Vector3 p1 = computeVertexAt(cellsIMin, j, height1);
+                Vector3 p2 = computeVertexAt(cellsIMin, j + 1, height2);
+
+                for (int i = cellsIMin; i < cellsIMax; i++, x++) {
+
+                    // Vertices of the next column of the row
+                    const decimal height3 = decimal(rowHeights[x + 1]) * heightScale;
+                    const decimal height4 = decimal(nextRowHeights[x + 1]) * heightScale;
+                    const Vector3 p3 = computeVertexAt(i + 1, j, height3);
+                    const Vector3 p4 = computeVertexAt(i + 1, j + 1, height4);
+
+                    // Test the cell if it is not a hole and if its heights overlap the heights range
+                    const bool isHole = cellHoles != nullptr && cellHoles[y * mTileNbCellColumns + x] != 0;
+                    if (!isHole &&
+                        std::min(std::min(height1, height2), std::min(height3, height4)) <= maxHeight &&
+                        std::max(std::max(height1, height2), std::max(height3, height4)) >= minHeight) {
+                        testCellTriangles(callback, i, j, p1, p2, p3, p4);
+                    }
+
+                    // The vertices of this column are the first vertices of the next cell
+                    p1 = p3;
+                    p2 = p4;
+                    height1 = height3;
+                    height2 = height4;
+                }
+            }
+        }
+    }
+}
+
+// Return the four vertices (local-coordinates) of a cell of the grid
+/// The vertices are the grid points (i, j), (i, j + 1), (i + 1, j) and (i + 1, j + 1). The two
+/// triangles of the cell are made of the vertices (0, 1, 2) and (2, 1, 3).
+/**
+ * @param i The column of the cell
+ * @param j The row of the cell
+ * @param[out] outVertices Array of four vertices (scaled) of the cell
+ */
+void HeightFieldShape::getCellVertices(int i, int j, Vector3* outVertices) const {
+
+    assert(i >= 0 && i < mNbColumns - 1);
+    assert(j >= 0 && j < mNbRows - 1);
+    assert(!isCellHole(i, j));
+
+    // Tile of the cell
+    const int tileI = i / mTileNbCellColumns;
+    const int tileJ = j / mTileNbCellRows;
+    const int tileIndex = getTileIndex(tileI, tileJ);
+    const int x = i - tileI * mTileNbCellColumns;
+    const int y = j - tileJ * mTileNbCellRows;
+
+    outVertices[0] = computeVertexAt(i, j, getTileHeightAt(tileIndex, x, y));
+    outVertices[1] = computeVertexAt(i, j + 1, getTileHeightAt(tileIndex, x, y + 1));
+    outVertices[2] = computeVertexAt(i + 1, j, getTileHeightAt(tileIndex, x + 1, y));
+    outVertices[3] = computeVertexAt(i + 1, j + 1, getTileHeightAt(tileIndex, x + 1, y + 1));
 }
 
 // Compute the min/max grid coords corresponding to the intersection of the AABB of the height field and
@@ -213,12 +649,12 @@ void HeightFieldShape::computeMinMaxGridCoordinates(int* minCoords, int* maxCoor
 
 // Raycast method with feedback information
 /// Note that only the first triangle hit by the ray in the mesh will be returned, even if
-/// the ray hits many triangles.
+/// the ray hits many triangles. The cells of the grid crossed by the ray are visited in the
+/// order of the ray (2D digital differential analyzer) and the traversal stops at the first
+/// cell with a hit. The triangles of a cell are only tested if the heights of the ray inside
+/// the cell overlap the heights of the cell (a hole has an empty range of heights).
 bool HeightFieldShape::raycast(const Ray& ray, RaycastInfo& raycastInfo, ProxyShape* proxyShape, MemoryAllocator& allocator) const {
 
-    // TODO : Implement raycasting without using an AABB for the ray
-    //        but using a dynamic AABB tree or octree instead
-
     RP3D_PROFILE("HeightFieldShape::raycast()", mProfiler);
 
     TriangleOverlapCallback triangleCallback(ray, proxyShape, raycastInfo, *this, allocator);
@@ -230,20 +666,114 @@ bool HeightFieldShape::raycast(const Ray& ray, RaycastInfo& raycastInfo, ProxySh
 
 #endif
 
-    // Compute the AABB for the ray
-    const Vector3 rayEnd = ray.point1 + ray.maxFraction * (ray.point2 - ray.point1);
-    const AABB rayAABB(Vector3::min(ray.point1, rayEnd), Vector3::max(ray.point1, rayEnd));
+    // Compute the ray in the non-scaled space of the grid (the fraction of a point of the ray
+    // is the same in both spaces)
+    const Vector3 inverseScaling(decimal(1.0) / mScaling.x, decimal(1.0) / mScaling.y, decimal(1.0) / mScaling.z);
+    const Vector3 origin = ray.point1 * inverseScaling;
+    const Vector3 direction = (ray.point2 - ray.point1) * inverseScaling;
+
+    // Clip the ray against the AABB of the height field
+    const decimal epsilon = decimal(0.0001);
+    decimal tMin = decimal(0.0);
+    decimal tMax = ray.maxFraction;
+    for (int axis = 0; axis < 3; axis++) {
+
+        const decimal aabbMin = mAABB.getMin()[axis] - epsilon;
+        const decimal aabbMax = mAABB.getMax()[axis] + epsilon;
 
-    testAllTriangles(triangleCallback, rayAABB);
+        if (std::abs(direction[axis]) < MACHINE_EPSILON) {
+
+            // The ray is parallel to the slab and outside of it
+            if (origin[axis] < aabbMin || origin[axis] > aabbMax) return false;
+        }
+        else {
+
+            decimal t1 = (aabbMin - origin[axis]) / direction[axis];
+            decimal t2 = (aabbMax - origin[axis]) / direction[axis];
+            if (t1 > t2) std::swap(t1, t2);
+
+            tMin = std::max(tMin, t1);
+            tMax = std::min(tMax, t2);
+            if (tMin > tMax) return false;
+        }
+    }
+
+    // Axes of the columns, of the rows and of the heights of the grid
+    const int columnAxis = mUpAxis == 0 ? 1 : 0;
+    const int rowAxis = mUpAxis == 2 ? 1 : 2;
+
+    // Grid coordinates of the ray origin (the grid point (0, 0) is at the minimum of the AABB)
+    const decimal originU = origin[columnAxis] + mWidth * decimal(0.5);
+    const decimal originV = origin[rowAxis] + mLength * decimal(0.5);
+    const decimal directionU = direction[columnAxis];
+    const decimal directionV = direction[rowAxis];
+    const decimal originHeight = origin[mUpAxis];
+    const decimal directionHeight = direction[mUpAxis];
+
+    // Cell of the grid that contains the start of the clipped ray
+    int i = clamp(static_cast<int>(std::floor(originU + tMin * directionU)), 0, mNbColumns - 2);
+    int j = clamp(static_cast<int>(std::floor(originV + tMin * directionV)), 0, mNbRows - 2);
+
+    // Step of the cells and fractions of the ray where it crosses the next column and row lines
+    const int stepI = directionU > decimal(0.0) ? 1 : -1;
+    const int stepJ = directionV > decimal(0.0) ? 1 : -1;
+    const bool isMovingU = std::abs(directionU) >= MACHINE_EPSILON;
+    const bool isMovingV = std::abs(directionV) >= MACHINE_EPSILON;
+    const decimal deltaU = isMovingU ? std::abs(decimal(1.0) / directionU) : DECIMAL_LARGEST;
+    const decimal deltaV = isMovingV ? std::abs(decimal(1.0) / directionV) : DECIMAL_LARGEST;
+    decimal nextU = isMovingU ? (decimal(stepI > 0 ? i + 1 : i) - originU) / directionU : DECIMAL_LARGEST;
+    decimal nextV = isMovingV ? (decimal(stepJ > 0 ? j + 1 : j) - originV) / directionV : DECIMAL_LARGEST;
+
+    decimal tCellEnter = tMin;
+    while (true) {
+
+        const decimal tCellExit = std::min(std::min(nextU, nextV), tMax);
+
+        // Range of heights of the ray inside the cell
+        const decimal rayHeight1 = originHeight + tCellEnter * directionHeight;
+        const decimal rayHeight2 = originHeight + tCellExit * directionHeight;
+
+        // Range of heights of the cell (first level of the height pyramid)
+        const decimal cellMinHeight = getBlockMinHeight(0, i, j);
+        const decimal cellMaxHeight = getBlockMaxHeight(0, i, j);
+
+        // Test the triangles of the cell if the ray can hit them
+        if (std::min(rayHeight1, rayHeight2) <= cellMaxHeight + epsilon &&
+            std::max(rayHeight1, rayHeight2) >= cellMinHeight - epsilon) {
+
+            testCellTriangles(triangleCallback, i, j);
+
+            // The triangles of the next cells can only be hit further along the ray
+            if (triangleCallback.getIsHit()) return true;
+        }
+
+        if (tCellExit >= tMax) break;
+
+        // Move to the next cell along the ray
+        if (nextU < nextV) {
+            i += stepI;
+            nextU += deltaU;
+            if (i < 0 || i >= mNbColumns - 1) break;
+        }
+        else {
+            j += stepJ;
+            nextV += deltaV;
+            if (j < 0 || j >= mNbRows - 1) break;
+        }
+
+        tCellEnter = tCellExit;
+    }
 
     return triangleCallback.getIsHit();
 }
 
 // Return the vertex (local-coordinates) of the height field at a given (x,y) position
 Vector3 HeightFieldShape::getVertexAt(int x, int y) const {
+    return computeVertexAt(x, y, getHeightAt(x, y));
+}
 
-    // Get the height value
-    const decimal height = getHeightAt(x, y);
+// Return the vertex (local-coordinates) of the height field at a given (x,y) position and height
+Vector3 HeightFieldShape::computeVertexAt(int x, int y, decimal height) const {
 
     // Height values origin
     const decimal heightOrigin = -(mMaxHeight - mMinHeight) * decimal(0.5) - mMinHeight;
@@ -268,7 +798,7 @@ Vector3 HeightFieldShape::getVertexAt(int x, int y) const {
 void TriangleOverlapCallback::testTriangle(const Vector3* trianglePoints, const Vector3* verticesNormals, uint shapeId) {
 
     // Create a triangle collision shape
-    TriangleShape triangleShape(trianglePoints, verticesNormals, shapeId, mAllocator);
+    TriangleShape triangleShape(trianglePoints, verticesNormals, shapeId);
     triangleShape.setRaycastTestType(mHeightFieldShape.getRaycastTestType());
 
 #ifdef IS_PROFILING_ACTIVE
@@ -315,6 +845,8 @@ std::string HeightFieldShape::to_string() const {
     ss << ", maxHeight=" << mMaxHeight << std::endl;
     ss << ", upAxis=" << mUpAxis << std::endl;
     ss << ", integerHeightScale=" << mIntegerHeightScale << std::endl;
+    ss << ", nbTileColumns=" << mNbTileColumns << std::endl;
+    ss << ", nbTileRows=" << mNbTileRows << std::endl;
     ss << "}";
 
     return ss.str();
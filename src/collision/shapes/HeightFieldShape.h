@@ -29,6 +29,7 @@
 // Libraries
 #include "ConcaveShape.h"
 #include "collision/shapes/AABB.h"
+#include "containers/List.h"
 
 namespace reactphysics3d {
 
@@ -97,6 +98,19 @@ class TriangleOverlapCallback : public TriangleCallback {
  * your height field. Note that the HeightFieldShape will be re-centered based on its AABB. It means
  * that for instance, if the minimum height value is -200 and the maximum value is 400, the final
  * minimum height of the field in the simulation will be -300 and the maximum height will be 300.
+ *
+ * The grid can also be split into square tiles of cells whose height values are set (paged in)
+ * and removed (paged out) at runtime with the setTileData() and removeTileData() methods so that
+ * only a part of a large terrain needs to be resident in memory. The cells of a tile that is not
+ * resident do not collide. Each tile can also have a flag per cell to make holes in the terrain.
+ * A height field created with the non-tiled constructor has a single tile with all the cells.
+ *
+ * The minimum and maximum heights of the cells of the grid are precomputed in a pyramid where
+ * each block of a level contains (up to) four blocks of the previous level. The overlap queries
+ * and the raycasts skip the blocks of cells whose heights are outside of the heights of the
+ * query (and the blocks without any resident cell). Only the blocks of a tile are updated when
+ * the tile is set or removed. Therefore, the height values of a tile must not be modified while
+ * the tile is resident unless it is set again with the setTileData() method.
  */
 class HeightFieldShape : public ConcaveShape {
 
@@ -105,8 +119,19 @@ class HeightFieldShape : public ConcaveShape {
         /// Data type for the height data of the height field
         enum class HeightDataType {HEIGHT_FLOAT_TYPE, HEIGHT_DOUBLE_TYPE, HEIGHT_INT_TYPE};
 
+        /// Type of the methods that use a callback method on the triangles of the cells of a sub-grid
+        using TestCellsTrianglesMethod = void (HeightFieldShape::*)(TriangleCallback& callback, int iMin, int iMax,
+                                                                   int jMin, int jMax, decimal minHeight,
+                                                                   decimal maxHeight) const;
+
     protected:
 
+        // -------------------- Constants -------------------- //
+
+        /// Level of the height pyramid from which the cells of a block are tested with a loop
+        /// over the rows of the block instead of descending the pyramid down to each cell
+        static constexpr int CELLS_LOOP_LEVEL = 3;
+
         // -------------------- Attributes -------------------- //
 
         /// Number of columns in the grid of the height field
@@ -136,8 +161,23 @@ class HeightFieldShape : public ConcaveShape {
         /// Data type of the height values
         HeightDataType mHeightDataType;
 
-        /// Array of data with all the height values of the height field
-        const void*	mHeightFieldData;
+        /// Number of columns of cells in a tile of the grid
+        int mTileNbCellColumns;
+
+        /// Number of rows of cells in a tile of the grid
+        int mTileNbCellRows;
+
+        /// Number of columns of tiles in the grid
+        int mNbTileColumns;
+
+        /// Number of rows of tiles in the grid
+        int mNbTileRows;
+
+        /// Array of data with the height values of each tile (null if the tile is not resident)
+        List<const void*> mTilesHeightData;
+
+        /// Array with the hole flag of each cell of each tile (null if the tile has no hole)
+        List<const uint8*> mTilesCellHoles;
 
         /// Local AABB of the height field (without scaling)
         AABB mAABB;
@@ -145,6 +185,23 @@ class HeightFieldShape : public ConcaveShape {
         /// Scaling vector
         const Vector3 mScaling;
 
+        /// Minimum and maximum heights (non-scaled) of the blocks of all the levels of the
+        /// height pyramid (two values per block). The blocks of the first level are the cells
+        /// of the grid and the last level has a single block
+        List<decimal> mBlocksHeightBounds;
+
+        /// Index of the first block of each level of the height pyramid
+        List<uint> mLevelsFirstBlock;
+
+        /// Number of columns of blocks of each level of the height pyramid
+        List<int> mLevelsNbColumns;
+
+        /// Number of rows of blocks of each level of the height pyramid
+        List<int> mLevelsNbRows;
+
+        /// Method that tests the triangles of the cells of a sub-grid for the height data type
+        TestCellsTrianglesMethod mTestCellsTrianglesMethod;
+
         // -------------------- Methods -------------------- //
 
         /// Raycast method with feedback information
@@ -167,6 +224,47 @@ class HeightFieldShape : public ConcaveShape {
         /// Compute the min/max grid coords corresponding to the intersection of the AABB of the height field and the AABB to collide
         void computeMinMaxGridCoordinates(int* minCoords, int* maxCoords, const AABB& aabbToCollide) const;
 
+        /// Use a callback method on the two triangles of a cell of the grid
+        void testCellTriangles(TriangleCallback& callback, int i, int j) const;
+
+        /// Use a callback method on the two triangles of a cell of the grid with given vertices
+        void testCellTriangles(TriangleCallback& callback, int i, int j, const Vector3& p1, const Vector3& p2,
+                               const Vector3& p3, const Vector3& p4) const;
+
+        /// Use a callback method on the triangles of the cells of a sub-grid for a type of height values
+        template<typename HeightType>
+        void testCellsTrianglesOfType(TriangleCallback& callback, int iMin, int iMax, int jMin, int jMax,
+                                      decimal minHeight, decimal maxHeight) const;
+
+        /// Compute the local AABB and allocate the tiles and the height pyramid
+        void initialize();
+
+        /// Allocate the levels of the height pyramid
+        void initHeightPyramid();
+
+        /// Update the minimum and maximum heights of the blocks of the height pyramid that contain some cells
+        void updateHeightPyramid(int iMin, int iMax, int jMin, int jMax);
+
+        /// Return the height of a grid point of a resident tile
+        decimal getTileHeightAt(int tileIndex, int x, int y) const;
+
+        /// Return the vertex (local-coordinates) of the height field at a given (x,y) position and height
+        Vector3 computeVertexAt(int x, int y, decimal height) const;
+
+        /// Return the index of a tile of the grid
+        int getTileIndex(int tileI, int tileJ) const;
+
+        /// Use a callback method on the triangles of the cells of a block of the height pyramid
+        void testBlockTriangles(TriangleCallback& callback, int level, int blockI, int blockJ,
+                                int iMin, int iMax, int jMin, int jMax,
+                                decimal minHeight, decimal maxHeight) const;
+
+        /// Return the minimum height (non-scaled) of a block of the height pyramid
+        decimal getBlockMinHeight(int level, int blockI, int blockJ) const;
+
+        /// Return the maximum height (non-scaled) of a block of the height pyramid
+        decimal getBlockMaxHeight(int level, int blockI, int blockJ) const;
+
         /// Compute the shape Id for a given triangle
         uint computeTriangleShapeId(uint iIndex, uint jIndex, uint secondTriangleIncrement) const;
 
@@ -178,6 +276,11 @@ class HeightFieldShape : public ConcaveShape {
                          int upAxis = 1, decimal integerHeightScale = 1.0f,
                          const Vector3& scaling = Vector3(1,1,1));
 
+        /// Constructor of a tiled height field without any resident tile
+        HeightFieldShape(int nbGridColumns, int nbGridRows, int nbTileCells, decimal minHeight, decimal maxHeight,
+                         HeightDataType dataType, int upAxis = 1, decimal integerHeightScale = 1.0f,
+                         const Vector3& scaling = Vector3(1,1,1));
+
         /// Destructor
         virtual ~HeightFieldShape() override = default;
 
@@ -205,12 +308,39 @@ class HeightFieldShape : public ConcaveShape {
         /// Return the type of height value in the height field
         HeightDataType getHeightDataType() const;
 
+        /// Return the up axis of the height field
+        int getUpAxis() const;
+
+        /// Return the number of columns of tiles in the height field
+        int getNbTileColumns() const;
+
+        /// Return the number of rows of tiles in the height field
+        int getNbTileRows() const;
+
+        /// Set the height values (and the holes) of a tile of the height field
+        void setTileData(int tileI, int tileJ, const void* heightData, const uint8* cellHoles = nullptr);
+
+        /// Remove the height values of a tile of the height field
+        void removeTileData(int tileI, int tileJ);
+
+        /// Return true if the height values of a tile are resident
+        bool isTileResident(int tileI, int tileJ) const;
+
+        /// Return true if a cell of the grid is a hole (or is in a tile that is not resident)
+        bool isCellHole(int i, int j) const;
+
         /// Return the local bounds of the shape in x, y and z directions.
         virtual void getLocalBounds(Vector3& min, Vector3& max) const override;
 
         /// Return the local inertia tensor of the collision shape
         virtual void computeLocalInertiaTensor(Matrix3x3& tensor, decimal mass) const override;
 
+        /// Compute the sub-grid of cells of the height field that overlap a given AABB
+        void computeOverlappingCells(const AABB& localAABB, int& iMin, int& iMax, int& jMin, int& jMax) const;
+
+        /// Return the four vertices (local-coordinates) of a cell of the grid
+        void getCellVertices(int i, int j, Vector3* outVertices) const;
+
         /// Use a callback method on all triangles of the concave shape inside a given AABB
         virtual void testAllTriangles(TriangleCallback& callback, const AABB& localAABB) const override;
 
@@ -243,22 +373,69 @@ inline HeightFieldShape::HeightDataType HeightFieldShape::getHeightDataType() co
     return mHeightDataType;
 }
 
+// Return the up axis of the height field
+/**
+ * @return The up axis of the height field (0 for x, 1 for y and 2 for z)
+ */
+inline int HeightFieldShape::getUpAxis() const {
+    return mUpAxis;
+}
+
+// Return the number of columns of tiles in the height field
+inline int HeightFieldShape::getNbTileColumns() const {
+    return mNbTileColumns;
+}
+
+// Return the number of rows of tiles in the height field
+inline int HeightFieldShape::getNbTileRows() const {
+    return mNbTileRows;
+}
+
+// Return the index of a tile of the grid
+inline int HeightFieldShape::getTileIndex(int tileI, int tileJ) const {
+    assert(tileI >= 0 && tileI < mNbTileColumns);
+    assert(tileJ >= 0 && tileJ < mNbTileRows);
+    return tileJ * mNbTileColumns + tileI;
+}
+
+// Return true if the height values of a tile are resident
+inline bool HeightFieldShape::isTileResident(int tileI, int tileJ) const {
+    return mTilesHeightData[getTileIndex(tileI, tileJ)] != nullptr;
+}
+
 // Return the number of bytes used by the collision shape
 inline size_t HeightFieldShape::getSizeInBytes() const {
     return sizeof(HeightFieldShape);
 }
 
-// Return the height of a given (x,y) point in the height field
-inline decimal HeightFieldShape::getHeightAt(int x, int y) const {
+// Return the height of a grid point of a resident tile
+/// The coordinates (x, y) of the grid point are relative to the first grid point of the tile
+inline decimal HeightFieldShape::getTileHeightAt(int tileIndex, int x, int y) const {
+
+    const void* heightData = mTilesHeightData[tileIndex];
+    assert(heightData != nullptr);
+    assert(x >= 0 && x <= mTileNbCellColumns);
+    assert(y >= 0 && y <= mTileNbCellRows);
 
+    const int index = y * (mTileNbCellColumns + 1) + x;
     switch(mHeightDataType) {
-        case HeightDataType::HEIGHT_FLOAT_TYPE : return ((float*)mHeightFieldData)[y * mNbColumns + x];
-        case HeightDataType::HEIGHT_DOUBLE_TYPE : return ((double*)mHeightFieldData)[y * mNbColumns + x];
-        case HeightDataType::HEIGHT_INT_TYPE : return ((int*)mHeightFieldData)[y * mNbColumns + x] * mIntegerHeightScale;
+        case HeightDataType::HEIGHT_FLOAT_TYPE : return ((float*)heightData)[index];
+        case HeightDataType::HEIGHT_DOUBLE_TYPE : return ((double*)heightData)[index];
+        case HeightDataType::HEIGHT_INT_TYPE : return ((int*)heightData)[index] * mIntegerHeightScale;
         default: assert(false); return 0;
     }
 }
 
+// Return the minimum height (non-scaled) of a block of the height pyramid
+inline decimal HeightFieldShape::getBlockMinHeight(int level, int blockI, int blockJ) const {
+    return mBlocksHeightBounds[2 * (mLevelsFirstBlock[level] + blockJ * mLevelsNbColumns[level] + blockI)];
+}
+
+// Return the maximum height (non-scaled) of a block of the height pyramid
+inline decimal HeightFieldShape::getBlockMaxHeight(int level, int blockI, int blockJ) const {
+    return mBlocksHeightBounds[2 * (mLevelsFirstBlock[level] + blockJ * mLevelsNbColumns[level] + blockI) + 1];
+}
+
 // Return the closest inside integer grid value of a given floating grid value
 inline int HeightFieldShape::computeIntegerGridValue(decimal value) const {
     return (value < decimal(0.0)) ? value - decimal(0.5) : value + decimal(0.5);
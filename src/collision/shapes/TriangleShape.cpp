@@ -28,7 +28,9 @@
 #include "collision/ProxyShape.h"
 #include "mathematics/mathematics_functions.h"
 #include "collision/RaycastInfo.h"
+#include "collision/TriangleMesh.h"
 #include "utils/Profiler.h"
+#include "memory/DefaultAllocator.h"
 #include "configuration.h"
 #include <cassert>
 
@@ -45,9 +47,8 @@ using namespace reactphysics3d;
  * @param verticesNormals The three vertices normals for smooth mesh collision
  * @param margin The collision margin (in meters) around the collision shape
  */
-TriangleShape::TriangleShape(const Vector3* vertices, const Vector3* verticesNormals, uint shapeId,
-                             MemoryAllocator& allocator)
-    : ConvexPolyhedronShape(CollisionShapeName::TRIANGLE), mFaces{HalfEdgeStructure::Face(allocator), HalfEdgeStructure::Face(allocator)} {
+TriangleShape::TriangleShape(const Vector3* vertices, const Vector3* verticesNormals, uint shapeId)
+    : ConvexPolyhedronShape(CollisionShapeName::TRIANGLE) {
 
     mPoints[0] = vertices[0];
     mPoints[1] = vertices[1];
@@ -61,18 +62,7 @@ TriangleShape::TriangleShape(const Vector3* vertices, const Vector3* verticesNor
     mVerticesNormals[1] = verticesNormals[1];
     mVerticesNormals[2] = verticesNormals[2];
 
-    // Faces
-    mFaces[0].faceVertices.reserve(3);
-    mFaces[0].faceVertices.add(0);
-    mFaces[0].faceVertices.add(1);
-    mFaces[0].faceVertices.add(2);
-    mFaces[0].edgeIndex = 0;
-
-    mFaces[1].faceVertices.reserve(3);
-    mFaces[1].faceVertices.add(0);
-    mFaces[1].faceVertices.add(2);
-    mFaces[1].faceVertices.add(1);
-    mFaces[1].edgeIndex = 1;
+    mEdgesConvexity = TriangleMesh::ALL_EDGES_CONVEX;
 
     // Edges
     for (uint i=0; i<6; i++) {
@@ -122,6 +112,34 @@ TriangleShape::TriangleShape(const Vector3* vertices, const Vector3* verticesNor
     mId = shapeId;
 }
 
+// Create a face of a triangle with the indices of its three vertices
+HalfEdgeStructure::Face TriangleShape::createTriangleFace(MemoryAllocator& allocator, uint edgeIndex,
+                                                          uint vertex1, uint vertex2, uint vertex3) {
+
+    HalfEdgeStructure::Face face(allocator);
+    face.faceVertices.reserve(3);
+    face.faceVertices.add(vertex1);
+    face.faceVertices.add(vertex2);
+    face.faceVertices.add(vertex3);
+    face.edgeIndex = edgeIndex;
+
+    return face;
+}
+
+// Return a given face of the polyhedron
+/// The two faces are the same for all the triangle shapes. They are created the first time
+/// they are used so that the creation of a triangle shape does not allocate any memory.
+const HalfEdgeStructure::Face& TriangleShape::getFace(uint faceIndex) const {
+    assert(faceIndex < 2);
+
+    // Allocator of the vertices of the faces (declared first so that it is destroyed last)
+    static DefaultAllocator allocator;
+    static const HalfEdgeStructure::Face faces[2] = {createTriangleFace(allocator, 0, 0, 1, 2),
+                                                     createTriangleFace(allocator, 1, 0, 2, 1)};
+
+    return faces[faceIndex];
+}
+
 // This method compute the smooth mesh contact with a triangle in case one of the two collision
 // shapes is a triangle. The idea in this case is to use a smooth vertex normal of the triangle mesh
 // at the contact point instead of the triangle normal to avoid the internal edge collision issue.
@@ -194,10 +212,16 @@ void TriangleShape::computeSmoothMeshContact(Vector3 localContactPointTriangle,
 /// normal of the mesh at this point as the contact normal. This technique is described in the chapter 5
 /// of the Game Physics Pearl book by Gino van der Bergen and Dirk Gregorius. The vertices normals of the
 /// mesh are either provided by the user or precomputed if the user did not provide them. Note that we only
-/// use the interpolated normal if the contact point is on an edge of the triangle. If the contact is in the
-/// middle of the triangle, we return the true triangle normal.
+/// use the interpolated normal if the contact point is on a convex edge of the triangle. If the contact is
+/// in the middle of the triangle or on internal (flat or concave) edges, we return the true triangle normal.
+/// The convexity of the edges is precomputed by the triangle mesh (all the edges are convex otherwise).
 Vector3 TriangleShape::computeSmoothLocalContactNormalForTriangle(const Vector3& localContactPoint) const {
 
+    // If all the edges of the triangle are internal edges of the mesh
+    if (mEdgesConvexity == 0) {
+        return mNormal;
+    }
+
     // Compute the barycentric coordinates of the point in the triangle
     decimal u, v, w;
     computeBarycentricCoordinatesInTriangle(mPoints[0], mPoints[1], mPoints[2], localContactPoint, u, v, w);
@@ -209,6 +233,14 @@ Vector3 TriangleShape::computeSmoothLocalContactNormalForTriangle(const Vector3&
         return mNormal;
     }
 
+    // If the contact is only on internal edges of the mesh, we return the true triangle face normal
+    const bool isOnConvexEdge = ((mEdgesConvexity & 1) != 0 && w <= MACHINE_EPSILON) ||
+                                ((mEdgesConvexity & 2) != 0 && u <= MACHINE_EPSILON) ||
+                                ((mEdgesConvexity & 4) != 0 && v <= MACHINE_EPSILON);
+    if (!isOnConvexEdge) {
+        return mNormal;
+    }
+
     // We compute the contact normal as the barycentric interpolation of the three vertices normals
     return (u * mVerticesNormals[0] + v * mVerticesNormals[1] + w * mVerticesNormals[2]).getUnit();
 }
@@ -289,7 +321,10 @@ bool TriangleShape::raycast(const Ray& ray, RaycastInfo& raycastInfo, ProxyShape
 
     // Compute the local hit point using the barycentric coordinates
     const Vector3 localHitPoint = u * mPoints[0] + v * mPoints[1] + w * mPoints[2];
-    const decimal hitFraction = (localHitPoint - ray.point1).length() / pq.length();
+
+    // Compute the hit fraction along the ray (signed so that an intersection of the line
+    // behind the origin of the ray is rejected)
+    const decimal hitFraction = (localHitPoint - ray.point1).dot(pq) / pq.lengthSquare();
 
     if (hitFraction < decimal(0.0) || hitFraction > ray.maxFraction) return false;
 
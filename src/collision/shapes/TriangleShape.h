@@ -70,12 +70,13 @@ class TriangleShape : public ConvexPolyhedronShape {
         /// Three vertices normals for smooth collision with triangle mesh
         Vector3 mVerticesNormals[3];
 
+        /// Convexity of the three edges of the triangle in its mesh (bit i is set if the edge
+        /// between the vertices i and i+1 is convex)
+        uint8 mEdgesConvexity;
+
         /// Raycast test type for the triangle (front, back, front-back)
         TriangleRaycastSide mRaycastTestType;
 
-        /// Faces information for the two faces of the triangle
-        HalfEdgeStructure::Face mFaces[2];
-
         /// Edges information for the six edges of the triangle
         HalfEdgeStructure::Edge mEdges[6];
 
@@ -100,6 +101,10 @@ class TriangleShape : public ConvexPolyhedronShape {
         /// Generate the id of the shape (used for temporal coherence)
         void generateId();
 
+        /// Create a face of a triangle with the indices of its three vertices
+        static HalfEdgeStructure::Face createTriangleFace(MemoryAllocator& allocator, uint edgeIndex,
+                                                          uint vertex1, uint vertex2, uint vertex3);
+
         // -------------------- Methods -------------------- //
 
         /// This method implements the technique described in Game Physics Pearl book
@@ -112,8 +117,7 @@ class TriangleShape : public ConvexPolyhedronShape {
         // -------------------- Methods -------------------- //
 
         /// Constructor
-        TriangleShape(const Vector3* vertices, const Vector3* verticesNormals,
-                      uint shapeId, MemoryAllocator& allocator);
+        TriangleShape(const Vector3* vertices, const Vector3* verticesNormals, uint shapeId);
 
         /// Destructor
         virtual ~TriangleShape() override = default;
@@ -180,6 +184,7 @@ class TriangleShape : public ConvexPolyhedronShape {
         friend class ConcaveMeshRaycastCallback;
         friend class TriangleOverlapCallback;
         friend class MiddlePhaseTriangleCallback;
+        friend class ContactHitsTriangleCallback;
 };
 
 // Return the number of bytes used by the collision shape
@@ -231,12 +236,6 @@ inline uint TriangleShape::getNbFaces() const {
     return 2;
 }
 
-// Return a given face of the polyhedron
-inline const HalfEdgeStructure::Face& TriangleShape::getFace(uint faceIndex) const {
-    assert(faceIndex < 2);
-    return mFaces[faceIndex];
-}
-
 // Return the number of vertices of the polyhedron
 inline uint TriangleShape::getNbVertices() const {
     return 3;
@@ -44,17 +44,28 @@
     #define LINUX_OS
 #endif
 
+// Hint to load the cache line of an address that will be read soon (no-op if the compiler
+// does not provide a prefetch intrinsic)
+#if defined(__GNUC__) || defined(__clang__)
+    #define RP3D_PREFETCH(address) __builtin_prefetch(address)
+#else
+    #define RP3D_PREFETCH(address) ((void)(address))
+#endif
+
 /// Namespace reactphysics3d
 namespace reactphysics3d {
 
+// Declarations
+class TaskScheduler;
+class MemoryAllocator;
+class SingleFrameAllocator;
+
 // ------------------- Type definitions ------------------- //
 
 using uint = unsigned int;
 using uchar = unsigned char;
 using ushort = unsigned short;
 using luint = long unsigned int;
-using bodyindex = luint;
-using bodyindexpair = Pair<bodyindex, bodyindex>;
 
 using int8 = std::int8_t;
 using uint8 = std::uint8_t;
@@ -62,6 +73,18 @@ using int16 = std::int16_t;
 using uint16 = std::uint16_t;
 using int32 = std::int32_t;
 using uint32 = std::uint32_t;
+using uint64 = std::uint64_t;
+
+using bodyindex = uint64;
+using bodyindexpair = Pair<bodyindex, bodyindex>;
+using jointindex = uint64;
+
+/// Type of the collision category bits and of the collide with mask bits of the proxy shapes
+#if defined(IS_64BIT_COLLISION_MASKS_ENABLED)
+using collisionmask = uint64;
+#else
+using collisionmask = uint32;
+#endif
 
 // ------------------- Enumerations ------------------- //
 
@@ -78,6 +101,32 @@ enum class JointsPositionCorrectionTechnique {BAUMGARTE_JOINTS, NON_LINEAR_GAUSS
 ///                 bodies momentum. This is the option used by default.
 enum class ContactsPositionCorrectionTechnique {BAUMGARTE_CONTACTS, SPLIT_IMPULSES};
 
+/// Algorithm used by the broad-phase collision detection
+/// DYNAMIC_AABB_TREE : The fat AABBs are stored in a dynamic AABB tree. Good for most worlds
+///                     and for worlds with a lot of static shapes or large shapes.
+/// SWEEP_AND_PRUNE : The fat AABBs are kept sorted along the X axis and swept for overlaps.
+///                   Good for worlds with many small shapes that move coherently.
+/// GRID : Each cell of a uniform grid has a dynamic AABB tree with its shapes. Good for very
+///        large worlds whose regions are streamed in and out.
+enum class BroadPhaseType {DYNAMIC_AABB_TREE, SWEEP_AND_PRUNE, GRID};
+
+/// Check of the memory allocations of the steps of a dynamics world (only available when the
+/// library is compiled with the RP3D_ALLOCATION_CHECK_ENABLED option)
+/// DISABLED : The allocations of the steps are counted but not checked
+/// REPORT : A step that allocates memory is counted and logged as a warning
+/// ASSERT : A step that allocates memory is reported and triggers an assertion
+enum class AllocationCheckMode {DISABLED, REPORT, ASSERT};
+
+/// Stages of a step of a dynamics world that is executed one stage at a time
+/// BROAD_PHASE : Broad-phase of the collision detection (the overlapping pairs of shapes)
+/// NARROW_PHASE : Middle-phase and narrow-phase of the collision detection (the contacts)
+/// ISLANDS : Computation of the islands of awake bodies that are simulated at this step
+/// SOLVER : Integration of the bodies and solving of the contacts and joints of the islands,
+///          update of the sleeping bodies and destruction of the broken joints
+/// END_OF_STEP : End of the step (events, reset of the external forces and statistics)
+/// NONE : No step is running
+enum class StepStage {BROAD_PHASE, NARROW_PHASE, ISLANDS, SOLVER, END_OF_STEP, NONE};
+
 // ------------------- Constants ------------------- //
 
 /// Smallest decimal value (negative)
@@ -105,6 +154,30 @@ constexpr decimal DYNAMIC_TREE_AABB_GAP = decimal(0.1);
 /// followin constant with the linear velocity and the elapsed time between two frames.
 constexpr decimal DYNAMIC_TREE_AABB_LIN_GAP_MULTIPLIER = decimal(1.7);
 
+/// Smallest distance between the shapes of a speculative contact. Two shapes that
+/// are touching without being reported as colliding are considered to be at this distance
+constexpr decimal SPECULATIVE_CONTACT_MIN_DISTANCE = decimal(0.0001);
+
+/// Largest difference between one and the square of the length of a quaternion that
+/// is normalized with the approximate inverse square root. A quaternion further away
+/// from the unit length is normalized with an exact square root.
+constexpr decimal APPROXIMATE_NORMALIZATION_MAX_ERROR = decimal(0.01);
+
+/// Collision mask bits with all the collision categories
+constexpr collisionmask ALL_COLLISION_CATEGORIES = ~collisionmask(0);
+
+/// Largest number of rays of a packet that traverses the broad-phase together
+/// during a batched raycast
+constexpr uint RAYCAST_PACKET_SIZE = 8;
+
+/// Number of simulation levels of detail of the rigid bodies. The islands of the
+/// level L are simulated every 2^L steps of the world.
+constexpr uint NB_SIMULATION_LEVELS_OF_DETAIL = 4;
+
+/// Size of a cache line (in bytes) used to align the arrays that are
+/// accessed in the inner loops of the solver
+constexpr size_t CACHE_LINE_SIZE = 64;
+
 /// Current version of ReactPhysics3D
 const std::string RP3D_VERSION = std::string("0.7.0");
 
@@ -141,6 +214,45 @@ struct WorldSettings {
     /// Number of iterations when solving the position constraints of the Sequential Impulse technique
     uint defaultPositionSolverNbIterations = 5;
 
+    /// True if the velocity solver of an island stops iterating once it has converged, that is
+    /// when the largest change of the contact and joint impulses during an iteration is smaller
+    /// than the tolerance. The number of velocity iterations of the world is then the maximum.
+    bool isVelocitySolverEarlyExitEnabled = false;
+
+    /// Largest change of impulse (in N.s) during an iteration of the velocity solver for
+    /// the solver of an island to be considered converged
+    decimal velocitySolverImpulseTolerance = decimal(0.0001);
+
+    /// Minimum number of velocity solver iterations of an island when the early exit is enabled
+    uint minVelocitySolverNbIterations = 2;
+
+    /// True if the position solver of the joints of an island is skipped when the position
+    /// error of the joints measured at the beginning of the step is smaller than the tolerance
+    /// and stops iterating once the error is smaller than the tolerance
+    bool isPositionSolverEarlyExitEnabled = false;
+
+    /// Largest position error of the joints (in meters for a distance and in radians for an
+    /// angle) for the position solver of an island to be skipped or stopped
+    decimal positionSolverErrorTolerance = decimal(0.001);
+
+    /// True if the joints keep the Jacobians, mass matrices and biases of their equality
+    /// constraints from one step to the next while their bodies do not move significantly
+    bool isJointSolverDataCacheEnabled = false;
+
+    /// Largest distance (in meters) and angle (in radians) moved by a body since the solver
+    /// data of its joints has been computed for this data to be reused
+    decimal jointSolverDataCacheTolerance = decimal(0.0001);
+
+    /// True if the resting contact points keep the lever arm products and the inverse mass of
+    /// their penetration constraint from one step to the next while their bodies do not move
+    /// significantly relative to the contact
+    bool isContactSolverDataCacheEnabled = false;
+
+    /// Largest change of the lever arms (in meters) of a resting contact point and largest
+    /// rotation (in radians) of its normal and of its bodies since its solver data has been
+    /// computed for this data to be reused
+    decimal contactSolverDataCacheTolerance = decimal(0.0001);
+
     /// Time (in seconds) that a body must stay still to be considered sleeping
     float defaultTimeBeforeSleep = 1.0f;
 
@@ -160,11 +272,216 @@ struct WorldSettings {
     /// least one concave collision shape.
     int nbMaxContactManifoldsConcaveShape = 3;
 
+    /// Maximum number of contact points in a contact manifold (between 1 and 4). Fewer
+    /// contact points make the contact solver faster but the stacking less stable.
+    int nbMaxContactPointsInManifold = 4;
+
     /// This is used to test if two contact manifold are similar (same contact normal) in order to
     /// merge them. If the cosine of the angle between the normals of the two manifold are larger
     /// than the value bellow, the manifold are considered to be similar.
     decimal cosAngleSimilarContactManifold = decimal(0.95);
 
+    /// Pointer to the task scheduler used to compute the narrow-phase and to simulate the
+    /// islands of a dynamics world in parallel. If null, everything is computed sequentially
+    /// on the calling thread. The result of a step does not depend on the scheduler or on
+    /// its number of workers. The scheduler is not owned by the world and must outlive it.
+    TaskScheduler* taskScheduler = nullptr;
+
+    /// Base memory allocator of the world. If null, the global base allocator of the
+    /// MemoryManager is used (it must then be thread-safe if several worlds are used
+    /// on different threads). The allocator is not owned by the world and must outlive it.
+    MemoryAllocator* baseAllocator = nullptr;
+
+    /// Pool memory allocator of the world. If null, the world creates its own pool
+    /// allocator so that independent worlds can be stepped on different threads. The
+    /// allocator is not owned by the world and must outlive it.
+    MemoryAllocator* poolAllocator = nullptr;
+
+    /// Single frame memory allocator of the world. If null, the world creates its own
+    /// single frame allocator. The allocator is not owned by the world and must outlive it.
+    SingleFrameAllocator* singleFrameAllocator = nullptr;
+
+    /// True if the overlapping pairs are processed in an order that only depends on the
+    /// bodies and collision shapes of the world (sorted by body ids) and not on the history
+    /// of the internal containers. This is slightly slower but two worlds created with the
+    /// same sequence of calls always give bit-identical results (lockstep replays).
+    bool isDeterministic = false;
+
+    /// True if the broad-phase queries (overlapping pairs and raycasts) traverse a wide tree
+    /// with four children per node built from the dynamic AABB tree (see WideAABBTree).
+    /// The wide tree is built again after the dynamic AABB tree has been modified.
+    bool isWideBroadPhaseTreeEnabled = false;
+
+    /// True if the dynamic AABB tree broad-phase stores the shapes of the static bodies in a
+    /// second tree. This tree is built again with the surface area heuristic after shapes have
+    /// been added or removed. The pairs between two static shapes are never computed
+    bool isStaticBroadPhaseTreeEnabled = false;
+
+    /// True if the shapes added to the dynamic AABB tree broad-phase are only inserted into
+    /// the trees at the next step. When many shapes have been added (while loading a level
+    /// for instance), the tree is built at once with the surface area heuristic, which is
+    /// much faster than inserting the shapes one by one and gives a better tree
+    bool isBroadPhaseTreeBulkBuildEnabled = false;
+
+    /// If larger than one, the dynamic AABB tree of the broad-phase is built again with the
+    /// surface area heuristic when its query cost has grown by this ratio since its last build
+    /// (1.3 for 30% for instance). The cost is checked after many updates of the tree
+    decimal broadPhaseTreeRebuildCostRatio = decimal(0.0);
+
+    /// If positive, the rebuilds of the dynamic and static AABB trees of the broad-phase are
+    /// replaced by an incremental refinement of the trees that runs for at most this time at
+    /// each step (in seconds, 0.0002 for 200 microseconds for instance). This avoids the rare
+    /// long steps of the full rebuilds at the cost of trees of slightly lower quality
+    decimal broadPhaseMaintenanceTimeBudget = decimal(0.0);
+
+    /// True if the dynamic AABB tree broad-phase counts its queries and the nodes they
+    /// visit (see BroadPhaseStatistics). This costs two atomic additions per query
+    bool isBroadPhaseQueryStatisticsEnabled = false;
+
+    /// True if the time and the number of tests of the middle-phase and narrow-phase are
+    /// measured for each overlapping pair and each pair of types of collision shapes (see
+    /// CollisionWorld::getMostExpensiveNarrowPhasePairs()). This is meant to find the pairs
+    /// that make the collision detection slow and it costs a few timer calls per pair
+    bool isNarrowPhaseCostsEnabled = false;
+
+    /// Algorithm used by the broad-phase collision detection of the world. The wide and
+    /// static trees above are only used by the dynamic AABB tree broad-phase
+    BroadPhaseType broadPhaseType = BroadPhaseType::DYNAMIC_AABB_TREE;
+
+    /// Size of the cells of the grid broad-phase (see GridBroadPhaseAlgorithm). The cells
+    /// should be larger than most of the shapes of the world
+    decimal broadPhaseGridCellSize = decimal(100.0);
+
+    /// True if each shape of the broad-phase has its own gap to inflate its fat AABB. The gap
+    /// of a shape grows each time the shape leaves its fat AABB and shrinks (together with
+    /// its fat AABB) when the shape has stayed inside its fat AABB for some updates
+    bool isAdaptiveBroadPhaseAABBGapEnabled = false;
+
+    /// Smallest gap of the fat AABBs of the broad-phase with the adaptive gaps
+    decimal broadPhaseMinAABBGap = decimal(0.02);
+
+    /// Largest gap of the fat AABBs of the broad-phase with the adaptive gaps
+    decimal broadPhaseMaxAABBGap = decimal(1.0);
+
+    /// Number of consecutive updates of a shape inside its fat AABB before its gap is
+    /// shrunk with the adaptive gaps
+    uint nbUpdatesBeforeBroadPhaseAABBGapShrink = 60;
+
+    /// True if the contact solver groups the contact manifolds that do not share any dynamic
+    /// body and solves each group at once with structure of arrays lanes (see ContactSolver)
+    bool isWideContactSolverEnabled = false;
+
+    /// True if the joints of each island are sorted by type and the joints of the same type
+    /// are solved in a single loop without virtual calls (see ConstraintSolver)
+    bool isJointBatchingEnabled = false;
+
+    /// True if the joints of each island that form a tree (chains, robot arms, ...) are solved
+    /// exactly with a linear time direct solver instead of the sequential impulses (see
+    /// ArticulationSolver). The joints batching is not used when this solver is enabled.
+    bool isArticulationSolverEnabled = false;
+
+    /// True if only the sleeping bodies connected to a moving body of an island are woken up
+    /// instead of the whole island. The other sleeping bodies of the island are solved as
+    /// bodies with an infinite mass until they are woken up in turn
+    bool isPartialWakeUpEnabled = false;
+
+    /// True if the contacts and joints of each island are colored so that the constraints
+    /// of the same color do not share any body and can be solved in parallel with the task
+    /// scheduler. The result does not depend on the task scheduler or its number of workers.
+    bool isConstraintColoringEnabled = false;
+
+    /// True if the normal impulses of the contact manifolds with two to four contact points
+    /// are solved simultaneously with a block solver instead of one point after the other.
+    /// The stacks of boxes then need less velocity iterations to be stable. The contact
+    /// manifolds are not solved with the wide contact solver when this is enabled.
+    bool isBlockContactSolverEnabled = false;
+
+    /// True if the contacts and the joints are solved by correcting the positions of the
+    /// bodies at each substep (see PositionBasedSolver) instead of with the sequential
+    /// impulses. The world should then be updated with many substeps.
+    bool isPositionBasedSolverEnabled = false;
+
+    /// Compliance (inverse of the stiffness) of the joints solved by the position based solver
+    decimal positionBasedJointsCompliance = decimal(0.0);
+
+    /// Frequency (in Hertz) of the spring used to solve the penetration of the contacts as
+    /// soft constraints instead of with the Baumgarte or split impulses position correction.
+    /// The contacts are rigid if it is zero. The block solver and the split impulses are not
+    /// used for soft contacts.
+    decimal contactFrequency = decimal(0.0);
+
+    /// Damping ratio of the spring of the soft contacts
+    decimal contactDampingRatio = decimal(10.0);
+
+    /// True if the penetration depth of a sphere or a capsule that deeply penetrates a convex
+    /// polyhedron is computed with the EPA algorithm from the final simplex of the GJK algorithm
+    /// (one contact point per step) instead of with the SAT algorithm. The SAT algorithm is
+    /// still used if the polytope of EPA is degenerate (flat shapes like the triangles)
+    bool isEPAEnabled = false;
+
+    /// True if the GJK algorithm of a pair of convex shapes starts from the final simplex of
+    /// its previous query (cached in the last frame collision info of the pair) instead of
+    /// only from the previous separating axis. With a coherent motion, the cached simplex is
+    /// usually close to the final one and the algorithm converges in fewer iterations (see
+    /// the GJK counters of the narrow-phase statistics)
+    bool isGJKSimplexWarmStartEnabled = false;
+
+    /// True if the contact manifolds of two convex shapes are reused without running the
+    /// narrow-phase when the relative transform of the shapes has almost not changed since
+    /// their last narrow-phase. The penetration depths of the contact points are then updated
+    /// with the relative motion of the shapes. The narrow-phase still runs at least every
+    /// nbMaxFramesContactReuse frames
+    bool isContactReuseEnabled = false;
+
+    /// Largest relative translation (in meters) of two shapes for which their contacts are reused
+    decimal contactReuseTranslationThreshold = decimal(0.005);
+
+    /// Largest relative rotation (in radians) of two shapes for which their contacts are reused
+    decimal contactReuseRotationThreshold = decimal(0.01);
+
+    /// Largest number of consecutive frames during which the contacts of two shapes are reused
+    uint nbMaxFramesContactReuse = 4;
+
+    /// True if the integrated orientations of the bodies are normalized with one Newton-Raphson
+    /// iteration of the inverse square root instead of a square root and a division. The
+    /// orientations of the bodies of an island with joints are normalized four or eight at once.
+    /// The orientations are still exactly normalized every nbStepsBetweenExactOrientationNormalizations
+    /// substeps so that the small error of the approximation does not accumulate.
+    bool isApproximateOrientationNormalizationEnabled = false;
+
+    /// Number of substeps between two exact normalizations of the integrated orientations
+    uint nbStepsBetweenExactOrientationNormalizations = 32;
+
+    /// Number of steps between two sorts of the states of the rigid bodies along a Morton curve
+    /// of their positions (zero to disable the sort). The islands are then built and solved in
+    /// this order so that the bodies that are close in space (and usually in the same islands)
+    /// are also close in the state and velocity arrays of the world.
+    uint nbStepsBetweenSpatialSorts = 0;
+
+    /// True if DynamicsWorld::startUpdate() updates the scene query snapshot of the world
+    /// before the step starts. Other threads can then run queries on the snapshot (see
+    /// CollisionWorld::getQuerySnapshot()) while the step is running.
+    bool isQuerySnapshotUpdatedByStartUpdate = false;
+
+    /// True if a CONTACT_STAY event is added to the contact events of the world (see
+    /// CollisionWorld::getContactEvents()) at each update for each pair of proxy shapes that
+    /// still have contacts. Otherwise, only the CONTACT_BEGIN and CONTACT_END events are added.
+    bool isContactStayEventReported = false;
+
+    /// True if the contact solver adds a summary of the impulses of each contact manifold
+    /// with a total normal impulse larger than contactImpulseReportThreshold to the contact
+    /// impulses of the world (see DynamicsWorld::getContactImpulses()) at each update
+    bool isContactImpulseReported = false;
+
+    /// Smallest total normal impulse (in Newton-seconds) of a contact manifold for its
+    /// impulses to be reported
+    decimal contactImpulseReportThreshold = decimal(0.0);
+
+    /// True if the dynamics world keeps the transform of each rigid body at the beginning of
+    /// the last step so that the transforms between the last two steps can be interpolated
+    /// (see DynamicsWorld::getInterpolatedTransforms())
+    bool isTransformInterpolationEnabled = false;
+
     /// Return a string with the world settings
     std::string to_string() const {
 
@@ -179,12 +496,65 @@ struct WorldSettings {
         ss << "isSleepingEnabled=" << isSleepingEnabled << std::endl;
         ss << "defaultVelocitySolverNbIterations=" << defaultVelocitySolverNbIterations << std::endl;
         ss << "defaultPositionSolverNbIterations=" << defaultPositionSolverNbIterations << std::endl;
+        ss << "isVelocitySolverEarlyExitEnabled=" << isVelocitySolverEarlyExitEnabled << std::endl;
+        ss << "velocitySolverImpulseTolerance=" << velocitySolverImpulseTolerance << std::endl;
+        ss << "minVelocitySolverNbIterations=" << minVelocitySolverNbIterations << std::endl;
+        ss << "isPositionSolverEarlyExitEnabled=" << isPositionSolverEarlyExitEnabled << std::endl;
+        ss << "positionSolverErrorTolerance=" << positionSolverErrorTolerance << std::endl;
+        ss << "isJointSolverDataCacheEnabled=" << isJointSolverDataCacheEnabled << std::endl;
+        ss << "jointSolverDataCacheTolerance=" << jointSolverDataCacheTolerance << std::endl;
+        ss << "isContactSolverDataCacheEnabled=" << isContactSolverDataCacheEnabled << std::endl;
+        ss << "contactSolverDataCacheTolerance=" << contactSolverDataCacheTolerance << std::endl;
         ss << "defaultTimeBeforeSleep=" << defaultTimeBeforeSleep << std::endl;
         ss << "defaultSleepLinearVelocity=" << defaultSleepLinearVelocity << std::endl;
         ss << "defaultSleepAngularVelocity=" << defaultSleepAngularVelocity << std::endl;
         ss << "nbMaxContactManifoldsConvexShape=" << nbMaxContactManifoldsConvexShape << std::endl;
         ss << "nbMaxContactManifoldsConcaveShape=" << nbMaxContactManifoldsConcaveShape << std::endl;
+        ss << "nbMaxContactPointsInManifold=" << nbMaxContactPointsInManifold << std::endl;
         ss << "cosAngleSimilarContactManifold=" << cosAngleSimilarContactManifold << std::endl;
+        ss << "taskScheduler=" << taskScheduler << std::endl;
+        ss << "baseAllocator=" << baseAllocator << std::endl;
+        ss << "poolAllocator=" << poolAllocator << std::endl;
+        ss << "singleFrameAllocator=" << singleFrameAllocator << std::endl;
+        ss << "isDeterministic=" << isDeterministic << std::endl;
+        ss << "isWideBroadPhaseTreeEnabled=" << isWideBroadPhaseTreeEnabled << std::endl;
+        ss << "isStaticBroadPhaseTreeEnabled=" << isStaticBroadPhaseTreeEnabled << std::endl;
+        ss << "isBroadPhaseTreeBulkBuildEnabled=" << isBroadPhaseTreeBulkBuildEnabled << std::endl;
+        ss << "broadPhaseTreeRebuildCostRatio=" << broadPhaseTreeRebuildCostRatio << std::endl;
+        ss << "broadPhaseMaintenanceTimeBudget=" << broadPhaseMaintenanceTimeBudget << std::endl;
+        ss << "isBroadPhaseQueryStatisticsEnabled=" << isBroadPhaseQueryStatisticsEnabled << std::endl;
+        ss << "isNarrowPhaseCostsEnabled=" << isNarrowPhaseCostsEnabled << std::endl;
+        ss << "broadPhaseType=" << (broadPhaseType == BroadPhaseType::SWEEP_AND_PRUNE ? "SWEEP_AND_PRUNE" :
+                                    broadPhaseType == BroadPhaseType::GRID ? "GRID" : "DYNAMIC_AABB_TREE") << std::endl;
+        ss << "broadPhaseGridCellSize=" << broadPhaseGridCellSize << std::endl;
+        ss << "isAdaptiveBroadPhaseAABBGapEnabled=" << isAdaptiveBroadPhaseAABBGapEnabled << std::endl;
+        ss << "broadPhaseMinAABBGap=" << broadPhaseMinAABBGap << std::endl;
+        ss << "broadPhaseMaxAABBGap=" << broadPhaseMaxAABBGap << std::endl;
+        ss << "nbUpdatesBeforeBroadPhaseAABBGapShrink=" << nbUpdatesBeforeBroadPhaseAABBGapShrink << std::endl;
+        ss << "isWideContactSolverEnabled=" << isWideContactSolverEnabled << std::endl;
+        ss << "isJointBatchingEnabled=" << isJointBatchingEnabled << std::endl;
+        ss << "isArticulationSolverEnabled=" << isArticulationSolverEnabled << std::endl;
+        ss << "isPartialWakeUpEnabled=" << isPartialWakeUpEnabled << std::endl;
+        ss << "isConstraintColoringEnabled=" << isConstraintColoringEnabled << std::endl;
+        ss << "isBlockContactSolverEnabled=" << isBlockContactSolverEnabled << std::endl;
+        ss << "isPositionBasedSolverEnabled=" << isPositionBasedSolverEnabled << std::endl;
+        ss << "positionBasedJointsCompliance=" << positionBasedJointsCompliance << std::endl;
+        ss << "contactFrequency=" << contactFrequency << std::endl;
+        ss << "contactDampingRatio=" << contactDampingRatio << std::endl;
+        ss << "isEPAEnabled=" << isEPAEnabled << std::endl;
+        ss << "isGJKSimplexWarmStartEnabled=" << isGJKSimplexWarmStartEnabled << std::endl;
+        ss << "isContactReuseEnabled=" << isContactReuseEnabled << std::endl;
+        ss << "contactReuseTranslationThreshold=" << contactReuseTranslationThreshold << std::endl;
+        ss << "contactReuseRotationThreshold=" << contactReuseRotationThreshold << std::endl;
+        ss << "nbMaxFramesContactReuse=" << nbMaxFramesContactReuse << std::endl;
+        ss << "isApproximateOrientationNormalizationEnabled=" << isApproximateOrientationNormalizationEnabled << std::endl;
+        ss << "nbStepsBetweenExactOrientationNormalizations=" << nbStepsBetweenExactOrientationNormalizations << std::endl;
+        ss << "nbStepsBetweenSpatialSorts=" << nbStepsBetweenSpatialSorts << std::endl;
+        ss << "isQuerySnapshotUpdatedByStartUpdate=" << isQuerySnapshotUpdatedByStartUpdate << std::endl;
+        ss << "isContactStayEventReported=" << isContactStayEventReported << std::endl;
+        ss << "isContactImpulseReported=" << isContactImpulseReported << std::endl;
+        ss << "contactImpulseReportThreshold=" << contactImpulseReportThreshold << std::endl;
+        ss << "isTransformInterpolationEnabled=" << isTransformInterpolationEnabled << std::endl;
 
         return ss.str();
     }
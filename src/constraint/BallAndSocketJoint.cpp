@@ -26,6 +26,8 @@
 // Libraries
 #include "BallAndSocketJoint.h"
 #include "engine/ConstraintSolver.h"
+#include "engine/WorldState.h"
+#include "engine/ArticulationSolver.h"
 
 using namespace reactphysics3d;
 
@@ -33,7 +35,7 @@ using namespace reactphysics3d;
 const decimal BallAndSocketJoint::BETA = decimal(0.2);
 
 // Constructor
-BallAndSocketJoint::BallAndSocketJoint(uint id, const BallAndSocketJointInfo& jointInfo)
+BallAndSocketJoint::BallAndSocketJoint(jointindex id, const BallAndSocketJointInfo& jointInfo)
                    : Joint(id, jointInfo), mImpulse(Vector3(0, 0, 0)) {
 
     // Compute the local-space anchor point for each body
@@ -41,6 +43,14 @@ BallAndSocketJoint::BallAndSocketJoint(uint id, const BallAndSocketJointInfo& jo
     mLocalAnchorPointBody2 = mBody2->getTransform().getInverse() * jointInfo.anchorPointWorldSpace;
 }
 
+// Constructor of a copy of a joint between two other bodies
+/// The settings and local frames of the joint are copied but not its impulses.
+BallAndSocketJoint::BallAndSocketJoint(jointindex id, const BallAndSocketJoint& joint, RigidBody* body1, RigidBody* body2)
+                   : Joint(id, joint, body1, body2), mLocalAnchorPointBody1(joint.mLocalAnchorPointBody1),
+                     mLocalAnchorPointBody2(joint.mLocalAnchorPointBody2), mImpulse(Vector3(0, 0, 0)) {
+
+}
+
 // Initialize before solving the constraint
 void BallAndSocketJoint::initBeforeSolve(const ConstraintSolverData& constraintSolverData) {
 
@@ -48,43 +58,61 @@ void BallAndSocketJoint::initBeforeSolve(const ConstraintSolverData& constraintS
     mIndexBody1 = mBody1->mArrayIndex;
     mIndexBody2 = mBody2->mArrayIndex;
 
-    // Get the bodies center of mass and orientations
-    const Vector3& x1 = mBody1->mCenterOfMassWorld;
-    const Vector3& x2 = mBody2->mCenterOfMassWorld;
-    const Quaternion& orientationBody1 = mBody1->getTransform().getOrientation();
-    const Quaternion& orientationBody2 = mBody2->getTransform().getOrientation();
-
-    // Get the inertia tensor of bodies
-    mI1 = mBody1->getInertiaTensorInverseWorld();
-    mI2 = mBody2->getInertiaTensorInverseWorld();
-
-    // Compute the vector from body center to the anchor point in world-space
-    mR1World = orientationBody1 * mLocalAnchorPointBody1;
-    mR2World = orientationBody2 * mLocalAnchorPointBody2;
-
-    // Compute the corresponding skew-symmetric matrices
-    Matrix3x3 skewSymmetricMatrixU1= Matrix3x3::computeSkewSymmetricMatrixForCrossProduct(mR1World);
-    Matrix3x3 skewSymmetricMatrixU2= Matrix3x3::computeSkewSymmetricMatrixForCrossProduct(mR2World);
-
-    // Compute the matrix K=JM^-1J^t (3x3 matrix)
-    decimal inverseMassBodies = mBody1->mMassInverse + mBody2->mMassInverse;
-    Matrix3x3 massMatrix = Matrix3x3(inverseMassBodies, 0, 0,
-                                    0, inverseMassBodies, 0,
-                                    0, 0, inverseMassBodies) +
-                           skewSymmetricMatrixU1 * mI1 * skewSymmetricMatrixU1.getTranspose() +
-                           skewSymmetricMatrixU2 * mI2 * skewSymmetricMatrixU2.getTranspose();
+    // Compute the coefficients of the soft constraint for the current time step
+    computeSoftness(constraintSolverData);
 
-    // Compute the inverse mass matrix K^-1
-    mInverseMassMatrix.setToZero();
-    if (mBody1->getType() == BodyType::DYNAMIC || mBody2->getType() == BodyType::DYNAMIC) {
-        mInverseMassMatrix = massMatrix.getInverse();
+    // If the bodies have not moved since the solver data has been computed, reuse it
+    if (canReuseSolverData(constraintSolverData)) {
+        mPositionError = mCachedPositionError;
     }
-
-    // Compute the bias "b" of the constraint
-    mBiasVector.setToZero();
-    if (mPositionCorrectionTechnique == JointsPositionCorrectionTechnique::BAUMGARTE_JOINTS) {
-        decimal biasFactor = (BETA / constraintSolverData.timeStep);
-        mBiasVector = biasFactor * (x2 + mR2World - x1 - mR1World);
+    else {
+
+        // Get the bodies center of mass and orientations
+        const Vector3& x1 = mBody1->getCenterOfMassWorld();
+        const Vector3& x2 = mBody2->getCenterOfMassWorld();
+        const Quaternion& orientationBody1 = mBody1->getTransform().getOrientation();
+        const Quaternion& orientationBody2 = mBody2->getTransform().getOrientation();
+
+        // Get the inertia tensor of bodies
+        mI1 = mBody1->getInertiaTensorInverseWorld();
+        mI2 = mBody2->getInertiaTensorInverseWorld();
+
+        // Compute the vector from body center to the anchor point in world-space
+        mR1World = orientationBody1 * mLocalAnchorPointBody1;
+        mR2World = orientationBody2 * mLocalAnchorPointBody2;
+
+        // Compute the corresponding skew-symmetric matrices
+        Matrix3x3 skewSymmetricMatrixU1= Matrix3x3::computeSkewSymmetricMatrixForCrossProduct(mR1World);
+        Matrix3x3 skewSymmetricMatrixU2= Matrix3x3::computeSkewSymmetricMatrixForCrossProduct(mR2World);
+
+        // Compute the matrix K=JM^-1J^t (3x3 matrix)
+        decimal inverseMassBodies = mBody1->mMassInverse + mBody2->mMassInverse;
+        Matrix3x3 massMatrix = Matrix3x3(inverseMassBodies, 0, 0,
+                                        0, inverseMassBodies, 0,
+                                        0, 0, inverseMassBodies) +
+                               skewSymmetricMatrixU1 * mI1 * skewSymmetricMatrixU1.getTranspose() +
+                               skewSymmetricMatrixU2 * mI2 * skewSymmetricMatrixU2.getTranspose();
+
+        // Compute the inverse mass matrix K^-1
+        mInverseMassMatrix.setToZero();
+        if (mBody1->getType() == BodyType::DYNAMIC || mBody2->getType() == BodyType::DYNAMIC) {
+            mInverseMassMatrix = massMatrix.getInverse();
+        }
+
+        // Compute the bias "b" of the constraint
+        mBiasVector.setToZero();
+        if (isSoft()) {
+            mBiasVector = mSoftness.biasRate * (x2 + mR2World - x1 - mR1World);
+        }
+        else if (mPositionCorrectionTechnique == JointsPositionCorrectionTechnique::BAUMGARTE_JOINTS) {
+            decimal biasFactor = (BETA / constraintSolverData.timeStep);
+            mBiasVector = biasFactor * (x2 + mR2World - x1 - mR1World);
+        }
+
+        // Measure the position error of the joint
+        mPositionError = (x2 + mR2World - x1 - mR1World).length();
+
+        cacheSolverData(constraintSolverData);
     }
 
     // If warm-starting is not enabled
@@ -123,6 +151,8 @@ void BallAndSocketJoint::warmstart(const ConstraintSolverData& constraintSolverD
 // Solve the velocity constraint
 void BallAndSocketJoint::solveVelocityConstraint(const ConstraintSolverData& constraintSolverData) {
 
+    mVelocityImpulseDelta = decimal(0.0);
+
     // Get the velocities
     Vector3& v1 = constraintSolverData.linearVelocities[mIndexBody1];
     Vector3& v2 = constraintSolverData.linearVelocities[mIndexBody2];
@@ -133,8 +163,10 @@ void BallAndSocketJoint::solveVelocityConstraint(const ConstraintSolverData& con
     const Vector3 Jv = v2 + w2.cross(mR2World) - v1 - w1.cross(mR1World);
 
     // Compute the Lagrange multiplier lambda
-    const Vector3 deltaLambda = mInverseMassMatrix * (-Jv - mBiasVector);
+    const Vector3 deltaLambda = mSoftness.massScale * (mInverseMassMatrix * (-Jv - mBiasVector)) -
+                                mSoftness.impulseScale * mImpulse;
     mImpulse += deltaLambda;
+    updateVelocityImpulseDelta(deltaLambda.getAbsoluteVector().getMaxValue());
 
     // Compute the impulse P=J^T * lambda for the body 1
     const Vector3 linearImpulseBody1 = -deltaLambda;
@@ -155,9 +187,11 @@ void BallAndSocketJoint::solveVelocityConstraint(const ConstraintSolverData& con
 // Solve the position constraint (for position error correction)
 void BallAndSocketJoint::solvePositionConstraint(const ConstraintSolverData& constraintSolverData) {
 
-    // If the error position correction technique is not the non-linear-gauss-seidel, we do
-    // do not execute this method
-    if (mPositionCorrectionTechnique != JointsPositionCorrectionTechnique::NON_LINEAR_GAUSS_SEIDEL) return;
+    // If the error position correction technique is not the non-linear-gauss-seidel or if the
+    // constraint is soft, we do not execute this method
+    if (mPositionCorrectionTechnique != JointsPositionCorrectionTechnique::NON_LINEAR_GAUSS_SEIDEL || isSoft()) return;
+
+    mPositionError = decimal(0.0);
 
     // Get the bodies center of mass and orientations
     Vector3& x1 = constraintSolverData.positions[mIndexBody1];
@@ -195,6 +229,7 @@ void BallAndSocketJoint::solvePositionConstraint(const ConstraintSolverData& con
 
     // Compute the constraint error (value of the C(x) function)
     const Vector3 constraintError = (x2 + mR2World - x1 - mR1World);
+    updatePositionError(constraintError.length());
 
     // Compute the Lagrange multiplier lambda
     // TODO : Do not solve the system by computing the inverse each time and multiplying with the
@@ -225,5 +260,58 @@ void BallAndSocketJoint::solvePositionConstraint(const ConstraintSolverData& con
     x2 += v2;
     q2 += Quaternion(0, w2) * q2 * decimal(0.5);
     q2.normalize();
+
+    invalidateCorrectedSolverData(constraintSolverData);
+}
+
+// Return the number of rows of the equality constraints solved by the articulation solver
+uint BallAndSocketJoint::getNbArticulationRows() const {
+    return isSoft() ? 0 : 3;
 }
 
+// Compute the Jacobian and the bias of the equality constraints
+void BallAndSocketJoint::computeArticulationRows(ArticulationJointRows& rows) const {
+    setAnchorPointArticulationRows(mR1World, mR2World, mBiasVector, rows);
+}
+
+// Add the impulse of the equality constraints computed by the articulation solver
+void BallAndSocketJoint::addArticulationImpulse(const decimal* impulse) {
+    mImpulse += Vector3(impulse[0], impulse[1], impulse[2]);
+}
+
+// Compute the magnitudes of the linear and angular impulses of the joint
+/**
+ * @param[out] linearImpulse Magnitude of the impulse of the translation constraints
+ * @param[out] angularImpulse Magnitude of the impulse of the rotation constraints
+ */
+void BallAndSocketJoint::computeReactionImpulses(decimal& linearImpulse, decimal& angularImpulse) const {
+    linearImpulse = mImpulse.length();
+    angularImpulse = decimal(0.0);
+}
+
+// Construct a copy of the joint between two other bodies in a given memory location
+Joint* BallAndSocketJoint::clone(jointindex id, RigidBody* body1, RigidBody* body2, void* allocatedMemory) const {
+    return new (allocatedMemory) BallAndSocketJoint(id, *this, body1, body2);
+}
+
+// Write the accumulated impulses of the joint
+void BallAndSocketJoint::saveImpulses(WorldStateWriter& writer) const {
+    writer.write(mImpulse);
+}
+
+// Read the accumulated impulses of the joint written by saveImpulses()
+void BallAndSocketJoint::restoreImpulses(WorldStateReader& reader) {
+    reader.read(mImpulse);
+}
+
+// Write the settings of the joint
+void BallAndSocketJoint::saveJointSettings(WorldStateWriter& writer) const {
+    writer.write(mLocalAnchorPointBody1);
+    writer.write(mLocalAnchorPointBody2);
+}
+
+// Read the settings of the joint written by saveJointSettings()
+void BallAndSocketJoint::restoreJointSettings(WorldStateReader& reader) {
+    reader.read(mLocalAnchorPointBody1);
+    reader.read(mLocalAnchorPointBody2);
+}
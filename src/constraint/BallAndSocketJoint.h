@@ -120,12 +120,42 @@ class BallAndSocketJoint : public Joint {
         /// Solve the position constraint (for position error correction)
         virtual void solvePositionConstraint(const ConstraintSolverData& constraintSolverData) override;
 
+        /// Compute the magnitudes of the linear and angular impulses of the joint
+        virtual void computeReactionImpulses(decimal& linearImpulse, decimal& angularImpulse) const override;
+
+        /// Construct a copy of the joint between two other bodies in a given memory location
+        virtual Joint* clone(jointindex id, RigidBody* body1, RigidBody* body2, void* allocatedMemory) const override;
+
+        /// Write the accumulated impulses of the joint
+        virtual void saveImpulses(WorldStateWriter& writer) const override;
+
+        /// Read the accumulated impulses of the joint written by saveImpulses()
+        virtual void restoreImpulses(WorldStateReader& reader) override;
+
+        /// Write the settings of the joint
+        virtual void saveJointSettings(WorldStateWriter& writer) const override;
+
+        /// Read the settings of the joint written by saveJointSettings()
+        virtual void restoreJointSettings(WorldStateReader& reader) override;
+
+        /// Return the number of rows of the equality constraints solved by the articulation solver
+        virtual uint getNbArticulationRows() const override;
+
+        /// Compute the Jacobian and the bias of the equality constraints
+        virtual void computeArticulationRows(ArticulationJointRows& rows) const override;
+
+        /// Add the impulse of the equality constraints computed by the articulation solver
+        virtual void addArticulationImpulse(const decimal* impulse) override;
+
     public :
 
         // -------------------- Methods -------------------- //
 
         /// Constructor
-        BallAndSocketJoint(uint id, const BallAndSocketJointInfo& jointInfo);
+        BallAndSocketJoint(jointindex id, const BallAndSocketJointInfo& jointInfo);
+
+        /// Constructor of a copy of a joint between two other bodies
+        BallAndSocketJoint(jointindex id, const BallAndSocketJoint& joint, RigidBody* body1, RigidBody* body2);
 
         /// Destructor
         virtual ~BallAndSocketJoint() override = default;
@@ -138,6 +168,11 @@ class BallAndSocketJoint : public Joint {
 
         /// Deleted assignment operator
         BallAndSocketJoint& operator=(const BallAndSocketJoint& constraint) = delete;
+
+        // -------------------- Friendship -------------------- //
+
+        friend class ConstraintSolver;
+        friend class PositionBasedSolver;
 };
 
 // Return the number of bytes used by the joint
@@ -26,6 +26,7 @@
 // Libraries
 #include "ContactPoint.h"
 #include "collision/ProxyShape.h"
+#include "engine/WorldState.h"
 
 using namespace reactphysics3d;
 using namespace std;
@@ -36,26 +37,67 @@ ContactPoint::ContactPoint(const ContactPointInfo* contactInfo, const WorldSetti
                mPenetrationDepth(contactInfo->penetrationDepth),
                mLocalPointOnShape1(contactInfo->localPoint1),
                mLocalPointOnShape2(contactInfo->localPoint2),
-               mIsRestingContact(false), mIsObsolete(false), mNext(nullptr), mPrevious(nullptr),
+               mFeatureId(contactInfo->featureId),
+               mIsRestingContact(false), mIsSolverDataCached(false), mIsObsolete(false),
+               mNext(nullptr), mPrevious(nullptr),
                mWorldSettings(worldSettings) {
 
-    assert(mPenetrationDepth > decimal(0.0));
+    assert(mPenetrationDepth != decimal(0.0));
     assert(mNormal.lengthSquare() > decimal(0.8));
 
     mIsObsolete = false;
 }
 
+// Constructor with a state written by saveState()
+ContactPoint::ContactPoint(WorldStateReader& reader, const WorldSettings& worldSettings)
+             : mIsSolverDataCached(false), mIsObsolete(false), mNext(nullptr), mPrevious(nullptr),
+               mWorldSettings(worldSettings) {
+
+    reader.read(mNormal);
+    reader.read(mPenetrationDepth);
+    reader.read(mLocalPointOnShape1);
+    reader.read(mLocalPointOnShape2);
+    reader.read(mFeatureId);
+    reader.read(mIsRestingContact);
+    reader.read(mPenetrationImpulse);
+}
+
+// Write the state of the contact point
+void ContactPoint::saveState(WorldStateWriter& writer) const {
+
+    writer.write(mNormal);
+    writer.write(mPenetrationDepth);
+    writer.write(mLocalPointOnShape1);
+    writer.write(mLocalPointOnShape2);
+    writer.write(mFeatureId);
+    writer.write(mIsRestingContact);
+    writer.write(mPenetrationImpulse);
+}
+
+// Skip a state written by saveState() and return false if it is truncated
+bool ContactPoint::checkState(WorldStateReader& reader) {
+
+    const size_t stateSize = sizeof(mNormal) + sizeof(mPenetrationDepth) + sizeof(mLocalPointOnShape1) +
+                             sizeof(mLocalPointOnShape2) + sizeof(mFeatureId) + sizeof(mIsRestingContact) +
+                             sizeof(mPenetrationImpulse);
+    if (!reader.canRead(stateSize)) return false;
+
+    reader.skip(stateSize);
+    return true;
+}
+
 // Update the contact point with a new one that is similar (very close)
 /// The idea is to keep the cache impulse (for warm starting the contact solver)
 void ContactPoint::update(const ContactPointInfo* contactInfo) {
 
     assert(isSimilarWithContactPoint(contactInfo));
-    assert(contactInfo->penetrationDepth > decimal(0.0));
+    assert(contactInfo->penetrationDepth != decimal(0.0));
 
     mNormal = contactInfo->normal;
     mPenetrationDepth = contactInfo->penetrationDepth;
     mLocalPointOnShape1 = contactInfo->localPoint1;
     mLocalPointOnShape2 = contactInfo->localPoint2;
+    mFeatureId = contactInfo->featureId;
 
     mIsObsolete = false;
 }
@@ -36,6 +36,8 @@ namespace reactphysics3d {
 
 // Declarations
 class CollisionBody;
+class WorldStateWriter;
+class WorldStateReader;
 
 struct NarrowPhaseInfo;
 
@@ -53,7 +55,7 @@ class ContactPoint {
         /// Normalized normal vector of the contact (from body1 toward body2) in world space
         Vector3 mNormal;
 
-        /// Penetration depth
+        /// Penetration depth (negative for a speculative contact)
         decimal mPenetrationDepth;
 
         /// Contact point on proxy shape 1 in local-space of proxy shape 1
@@ -62,12 +64,49 @@ class ContactPoint {
         /// Contact point on proxy shape 2 in local-space of proxy shape 2
         Vector3 mLocalPointOnShape2;
 
+        /// Identifier of the features of the shapes that generated the contact (zero if unknown)
+        uint32 mFeatureId;
+
         /// True if the contact is a resting contact (exists for more than one time step)
         bool mIsRestingContact;
 
         /// Cached penetration impulse
         decimal mPenetrationImpulse;
 
+        /// True if the data of the penetration constraint computed by the contact solver
+        /// can be reused while the bodies do not move significantly relative to the contact
+        bool mIsSolverDataCached;
+
+        /// Vector from the center of mass of body 1 to the contact point when the solver data has been computed
+        Vector3 mCachedR1;
+
+        /// Vector from the center of mass of body 2 to the contact point when the solver data has been computed
+        Vector3 mCachedR2;
+
+        /// Normal of the contact when the solver data has been computed
+        Vector3 mCachedNormal;
+
+        /// Orientation of body 1 when the solver data has been computed
+        Quaternion mCachedOrientationBody1;
+
+        /// Orientation of body 2 when the solver data has been computed
+        Quaternion mCachedOrientationBody2;
+
+        /// Inverse mass of body 1 when the solver data has been computed
+        decimal mCachedMassInverseBody1;
+
+        /// Inverse mass of body 2 when the solver data has been computed
+        decimal mCachedMassInverseBody2;
+
+        /// Cached product of the inverse inertia tensor of body 1 with r1 x n
+        Vector3 mCachedI1TimesR1CrossN;
+
+        /// Cached product of the inverse inertia tensor of body 2 with r2 x n
+        Vector3 mCachedI2TimesR2CrossN;
+
+        /// Cached inverse mass of the penetration constraint
+        decimal mCachedInversePenetrationMass;
+
         /// True if the contact point is obsolete
         bool mIsObsolete;
 
@@ -91,6 +130,9 @@ class ContactPoint {
         /// Set the cached penetration impulse
         void setPenetrationImpulse(decimal impulse);
 
+        /// Set the penetration depth
+        void setPenetrationDepth(decimal depth);
+
 
         /// Set the mIsRestingContact variable
         void setIsRestingContact(bool isRestingContact);
@@ -107,6 +149,12 @@ class ContactPoint {
         /// Return true if the contact point is obsolete
         bool getIsObsolete() const;
 
+        /// Write the state of the contact point
+        void saveState(WorldStateWriter& writer) const;
+
+        /// Skip a state written by saveState() and return false if it is truncated
+        static bool checkState(WorldStateReader& reader);
+
     public :
 
         // -------------------- Methods -------------------- //
@@ -114,6 +162,9 @@ class ContactPoint {
         /// Constructor
         ContactPoint(const ContactPointInfo* contactInfo, const WorldSettings& worldSettings);
 
+        /// Constructor with a state written by saveState()
+        ContactPoint(WorldStateReader& reader, const WorldSettings& worldSettings);
+
         /// Destructor
         ~ContactPoint() = default;
 
@@ -132,6 +183,9 @@ class ContactPoint {
         /// Return the contact point on the second proxy shape in the local-space of the proxy shape
         const Vector3& getLocalPointOnShape2() const;
 
+        /// Return the identifier of the features of the shapes that generated the contact
+        uint32 getFeatureId() const;
+
         /// Return the cached penetration impulse
         decimal getPenetrationImpulse() const;
 
@@ -164,6 +218,11 @@ inline Vector3 ContactPoint::getNormal() const {
     return mNormal;
 }
 
+// Set the penetration depth
+inline void ContactPoint::setPenetrationDepth(decimal depth) {
+    mPenetrationDepth = depth;
+}
+
 // Return the contact point on the first proxy shape in the local-space of the proxy shape
 /**
  * @return The contact point on the first proxy shape in the local-space of the proxy shape
@@ -180,6 +239,15 @@ inline const Vector3& ContactPoint::getLocalPointOnShape2() const {
     return mLocalPointOnShape2;
 }
 
+// Return the identifier of the features of the shapes that generated the contact
+/**
+ * @return The identifier of the features (faces, edges or vertices) of the two shapes
+ *         that generated the contact point or zero if unknown
+ */
+inline uint32 ContactPoint::getFeatureId() const {
+    return mFeatureId;
+}
+
 // Return the cached penetration impulse
 /**
  * @return The penetration impulse
@@ -189,7 +257,15 @@ inline decimal ContactPoint::getPenetrationImpulse() const {
 }
 
 // Return true if the contact point is similar (close enougth) to another given contact point
+/// If the features of the shapes that generated both contact points are known, the contact
+/// points are similar if they have been generated by the same features. Otherwise, they
+/// are similar if they are close to each other.
 inline bool ContactPoint::isSimilarWithContactPoint(const ContactPointInfo* localContactPointBody1) const {
+
+    if (mFeatureId != 0 && localContactPointBody1->featureId != 0) {
+        return mFeatureId == localContactPointBody1->featureId;
+    }
+
     return (localContactPointBody1->localPoint1 - mLocalPointOnShape1).lengthSquare() <= (mWorldSettings.persistentContactDistanceThreshold *
             mWorldSettings.persistentContactDistanceThreshold);
 }
@@ -268,7 +344,8 @@ inline void ContactPoint::setPrevious(ContactPoint* previous) {
 
 // Return the penetration depth of the contact
 /**
- * @return the penetration depth (in meters)
+ * @return the penetration depth (in meters). It is negative for a speculative
+ *         contact between two shapes that are not touching yet
  */
 inline decimal ContactPoint::getPenetrationDepth() const {
     return mPenetrationDepth;
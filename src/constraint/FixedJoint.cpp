@@ -26,6 +26,8 @@
 // Libraries
 #include "FixedJoint.h"
 #include "engine/ConstraintSolver.h"
+#include "engine/WorldState.h"
+#include "engine/ArticulationSolver.h"
 
 using namespace reactphysics3d;
 
@@ -33,7 +35,7 @@ using namespace reactphysics3d;
 const decimal FixedJoint::BETA = decimal(0.2);
 
 // Constructor
-FixedJoint::FixedJoint(uint id, const FixedJointInfo& jointInfo)
+FixedJoint::FixedJoint(jointindex id, const FixedJointInfo& jointInfo)
            : Joint(id, jointInfo), mImpulseTranslation(0, 0, 0), mImpulseRotation(0, 0, 0) {
 
     // Compute the local-space anchor point for each body
@@ -56,6 +58,15 @@ FixedJoint::FixedJoint(uint id, const FixedJointInfo& jointInfo)
 	mInitOrientationDifferenceInv = transform2.getOrientation().getInverse() * transform1.getOrientation();
 }
 
+// Constructor of a copy of a joint between two other bodies
+/// The settings and local frames of the joint are copied but not its impulses.
+FixedJoint::FixedJoint(jointindex id, const FixedJoint& joint, RigidBody* body1, RigidBody* body2)
+           : Joint(id, joint, body1, body2), mLocalAnchorPointBody1(joint.mLocalAnchorPointBody1),
+             mLocalAnchorPointBody2(joint.mLocalAnchorPointBody2), mImpulseTranslation(0, 0, 0), mImpulseRotation(0, 0, 0),
+             mInitOrientationDifferenceInv(joint.mInitOrientationDifferenceInv) {
+
+}
+
 // Initialize before solving the constraint
 void FixedJoint::initBeforeSolve(const ConstraintSolverData& constraintSolverData) {
 
@@ -63,58 +74,82 @@ void FixedJoint::initBeforeSolve(const ConstraintSolverData& constraintSolverDat
     mIndexBody1 = mBody1->mArrayIndex;
     mIndexBody2 = mBody2->mArrayIndex;
 
-    // Get the bodies positions and orientations
-    const Vector3& x1 = mBody1->mCenterOfMassWorld;
-    const Vector3& x2 = mBody2->mCenterOfMassWorld;
-    const Quaternion& orientationBody1 = mBody1->getTransform().getOrientation();
-    const Quaternion& orientationBody2 = mBody2->getTransform().getOrientation();
-
-    // Get the inertia tensor of bodies
-    mI1 = mBody1->getInertiaTensorInverseWorld();
-    mI2 = mBody2->getInertiaTensorInverseWorld();
-
-    // Compute the vector from body center to the anchor point in world-space
-    mR1World = orientationBody1 * mLocalAnchorPointBody1;
-    mR2World = orientationBody2 * mLocalAnchorPointBody2;
-
-    // Compute the corresponding skew-symmetric matrices
-    Matrix3x3 skewSymmetricMatrixU1= Matrix3x3::computeSkewSymmetricMatrixForCrossProduct(mR1World);
-    Matrix3x3 skewSymmetricMatrixU2= Matrix3x3::computeSkewSymmetricMatrixForCrossProduct(mR2World);
+    // Compute the coefficients of the soft constraints for the current time step
+    computeSoftness(constraintSolverData);
 
-    // Compute the matrix K=JM^-1J^t (3x3 matrix) for the 3 translation constraints
-    decimal inverseMassBodies = mBody1->mMassInverse + mBody2->mMassInverse;
-    Matrix3x3 massMatrix = Matrix3x3(inverseMassBodies, 0, 0,
-                                    0, inverseMassBodies, 0,
-                                    0, 0, inverseMassBodies) +
-                           skewSymmetricMatrixU1 * mI1 * skewSymmetricMatrixU1.getTranspose() +
-                           skewSymmetricMatrixU2 * mI2 * skewSymmetricMatrixU2.getTranspose();
-
-    // Compute the inverse mass matrix K^-1 for the 3 translation constraints
-    mInverseMassMatrixTranslation.setToZero();
-    if (mBody1->getType() == BodyType::DYNAMIC || mBody2->getType() == BodyType::DYNAMIC) {
-        mInverseMassMatrixTranslation = massMatrix.getInverse();
-    }
-
-    // Compute the bias "b" of the constraint for the 3 translation constraints
-    decimal biasFactor = (BETA / constraintSolverData.timeStep);
-    mBiasTranslation.setToZero();
-    if (mPositionCorrectionTechnique == JointsPositionCorrectionTechnique::BAUMGARTE_JOINTS) {
-        mBiasTranslation = biasFactor * (x2 + mR2World - x1 - mR1World);
-    }
-
-    // Compute the inverse of the mass matrix K=JM^-1J^t for the 3 rotation
-    // contraints (3x3 matrix)
-    mInverseMassMatrixRotation = mI1 + mI2;
-    if (mBody1->getType() == BodyType::DYNAMIC || mBody2->getType() == BodyType::DYNAMIC) {
-        mInverseMassMatrixRotation = mInverseMassMatrixRotation.getInverse();
+    // If the bodies have not moved since the solver data has been computed, reuse it
+    if (canReuseSolverData(constraintSolverData)) {
+        mPositionError = mCachedPositionError;
     }
-
-    // Compute the bias "b" for the 3 rotation constraints
-    mBiasRotation.setToZero();
-
-    if (mPositionCorrectionTechnique == JointsPositionCorrectionTechnique::BAUMGARTE_JOINTS) {
+    else {
+
+        // Get the bodies positions and orientations
+        const Vector3& x1 = mBody1->getCenterOfMassWorld();
+        const Vector3& x2 = mBody2->getCenterOfMassWorld();
+        const Quaternion& orientationBody1 = mBody1->getTransform().getOrientation();
+        const Quaternion& orientationBody2 = mBody2->getTransform().getOrientation();
+
+        // Get the inertia tensor of bodies
+        mI1 = mBody1->getInertiaTensorInverseWorld();
+        mI2 = mBody2->getInertiaTensorInverseWorld();
+
+        // Compute the vector from body center to the anchor point in world-space
+        mR1World = orientationBody1 * mLocalAnchorPointBody1;
+        mR2World = orientationBody2 * mLocalAnchorPointBody2;
+
+        // Compute the corresponding skew-symmetric matrices
+        Matrix3x3 skewSymmetricMatrixU1= Matrix3x3::computeSkewSymmetricMatrixForCrossProduct(mR1World);
+        Matrix3x3 skewSymmetricMatrixU2= Matrix3x3::computeSkewSymmetricMatrixForCrossProduct(mR2World);
+
+        // Compute the matrix K=JM^-1J^t (3x3 matrix) for the 3 translation constraints
+        decimal inverseMassBodies = mBody1->mMassInverse + mBody2->mMassInverse;
+        Matrix3x3 massMatrix = Matrix3x3(inverseMassBodies, 0, 0,
+                                        0, inverseMassBodies, 0,
+                                        0, 0, inverseMassBodies) +
+                               skewSymmetricMatrixU1 * mI1 * skewSymmetricMatrixU1.getTranspose() +
+                               skewSymmetricMatrixU2 * mI2 * skewSymmetricMatrixU2.getTranspose();
+
+        // Compute the inverse mass matrix K^-1 for the 3 translation constraints
+        mInverseMassMatrixTranslation.setToZero();
+        if (mBody1->getType() == BodyType::DYNAMIC || mBody2->getType() == BodyType::DYNAMIC) {
+            mInverseMassMatrixTranslation = massMatrix.getInverse();
+        }
+
+        // Compute the bias "b" of the constraint for the 3 translation constraints
+        decimal biasFactor = (BETA / constraintSolverData.timeStep);
+        mBiasTranslation.setToZero();
+        if (isSoft()) {
+            mBiasTranslation = mSoftness.biasRate * (x2 + mR2World - x1 - mR1World);
+        }
+        else if (mPositionCorrectionTechnique == JointsPositionCorrectionTechnique::BAUMGARTE_JOINTS) {
+            mBiasTranslation = biasFactor * (x2 + mR2World - x1 - mR1World);
+        }
+
+        // Compute the inverse of the mass matrix K=JM^-1J^t for the 3 rotation
+        // contraints (3x3 matrix)
+        mInverseMassMatrixRotation = mI1 + mI2;
+        if (mBody1->getType() == BodyType::DYNAMIC || mBody2->getType() == BodyType::DYNAMIC) {
+            mInverseMassMatrixRotation = mInverseMassMatrixRotation.getInverse();
+        }
+
+        // Compute the bias "b" for the 3 rotation constraints
+        mBiasRotation.setToZero();
+
+        if (isSoft()) {
+            const Quaternion qError = orientationBody2 * mInitOrientationDifferenceInv * orientationBody1.getInverse();
+            mBiasRotation = mSoftness.biasRate * decimal(2.0) * qError.getVectorV();
+        }
+        else if (mPositionCorrectionTechnique == JointsPositionCorrectionTechnique::BAUMGARTE_JOINTS) {
+            const Quaternion qError = orientationBody2 * mInitOrientationDifferenceInv * orientationBody1.getInverse();
+            mBiasRotation = biasFactor * decimal(2.0) * qError.getVectorV();
+        }
+
+        // Measure the position error of the joint
         const Quaternion qError = orientationBody2 * mInitOrientationDifferenceInv * orientationBody1.getInverse();
-        mBiasRotation = biasFactor * decimal(2.0) * qError.getVectorV();
+        mPositionError = (x2 + mR2World - x1 - mR1World).length();
+        updatePositionError(decimal(2.0) * qError.getVectorV().length());
+
+        cacheSolverData(constraintSolverData);
     }
 
     // If warm-starting is not enabled
@@ -164,6 +199,8 @@ void FixedJoint::warmstart(const ConstraintSolverData& constraintSolverData) {
 // Solve the velocity constraint
 void FixedJoint::solveVelocityConstraint(const ConstraintSolverData& constraintSolverData) {
 
+    mVelocityImpulseDelta = decimal(0.0);
+
     // Get the velocities
     Vector3& v1 = constraintSolverData.linearVelocities[mIndexBody1];
     Vector3& v2 = constraintSolverData.linearVelocities[mIndexBody2];
@@ -180,9 +217,10 @@ void FixedJoint::solveVelocityConstraint(const ConstraintSolverData& constraintS
     const Vector3 JvTranslation = v2 + w2.cross(mR2World) - v1 - w1.cross(mR1World);
 
     // Compute the Lagrange multiplier lambda
-    const Vector3 deltaLambda = mInverseMassMatrixTranslation *
-                               (-JvTranslation - mBiasTranslation);
+    const Vector3 deltaLambda = mSoftness.massScale * (mInverseMassMatrixTranslation *
+                               (-JvTranslation - mBiasTranslation)) - mSoftness.impulseScale * mImpulseTranslation;
     mImpulseTranslation += deltaLambda;
+    updateVelocityImpulseDelta(deltaLambda.getAbsoluteVector().getMaxValue());
 
     // Compute the impulse P=J^T * lambda for body 1
     const Vector3 linearImpulseBody1 = -deltaLambda;
@@ -205,8 +243,10 @@ void FixedJoint::solveVelocityConstraint(const ConstraintSolverData& constraintS
     const Vector3 JvRotation = w2 - w1;
 
     // Compute the Lagrange multiplier lambda for the 3 rotation constraints
-    Vector3 deltaLambda2 = mInverseMassMatrixRotation * (-JvRotation - mBiasRotation);
+    Vector3 deltaLambda2 = mSoftness.massScale * (mInverseMassMatrixRotation * (-JvRotation - mBiasRotation)) -
+                           mSoftness.impulseScale * mImpulseRotation;
     mImpulseRotation += deltaLambda2;
+    updateVelocityImpulseDelta(deltaLambda2.getAbsoluteVector().getMaxValue());
 
     // Compute the impulse P=J^T * lambda for the 3 rotation constraints for body 1
     angularImpulseBody1 = -deltaLambda2;
@@ -221,9 +261,11 @@ void FixedJoint::solveVelocityConstraint(const ConstraintSolverData& constraintS
 // Solve the position constraint (for position error correction)
 void FixedJoint::solvePositionConstraint(const ConstraintSolverData& constraintSolverData) {
 
-    // If the error position correction technique is not the non-linear-gauss-seidel, we do
-    // do not execute this method
-    if (mPositionCorrectionTechnique != JointsPositionCorrectionTechnique::NON_LINEAR_GAUSS_SEIDEL) return;
+    // If the error position correction technique is not the non-linear-gauss-seidel or if the
+    // constraints are soft, we do not execute this method
+    if (mPositionCorrectionTechnique != JointsPositionCorrectionTechnique::NON_LINEAR_GAUSS_SEIDEL || isSoft()) return;
+
+    mPositionError = decimal(0.0);
 
     // Get the bodies positions and orientations
     Vector3& x1 = constraintSolverData.positions[mIndexBody1];
@@ -263,6 +305,7 @@ void FixedJoint::solvePositionConstraint(const ConstraintSolverData& constraintS
 
     // Compute position error for the 3 translation constraints
     const Vector3 errorTranslation = x2 + mR2World - x1 - mR1World;
+    updatePositionError(errorTranslation.length());
 
     // Compute the Lagrange multiplier lambda
     const Vector3 lambdaTranslation = mInverseMassMatrixTranslation * (-errorTranslation);
@@ -328,6 +371,7 @@ void FixedJoint::solvePositionConstraint(const ConstraintSolverData& constraintS
 	// 
 	// If we assume theta is small (error is small) then sin(x) = x so an approximation of the error angles is:
     const Vector3 errorRotation = decimal(2.0) * qError.getVectorV();
+    updatePositionError(errorRotation.length());
 
     // Compute the Lagrange multiplier lambda for the 3 rotation constraints
     Vector3 lambdaRotation = mInverseMassMatrixRotation * (-errorRotation);
@@ -348,5 +392,80 @@ void FixedJoint::solvePositionConstraint(const ConstraintSolverData& constraintS
     // Update the body position/orientation of body 2
     q2 += Quaternion(0, w2) * q2 * decimal(0.5);
     q2.normalize();
+
+    invalidateCorrectedSolverData(constraintSolverData);
 }
 
+// Return the number of rows of the equality constraints solved by the articulation solver
+uint FixedJoint::getNbArticulationRows() const {
+    return isSoft() ? 0 : 6;
+}
+
+// Compute the Jacobian and the bias of the equality constraints
+/// The three rotation constraints have the Jacobian of the velocity w2 - w1
+void FixedJoint::computeArticulationRows(ArticulationJointRows& rows) const {
+
+    setAnchorPointArticulationRows(mR1World, mR2World, mBiasTranslation, rows);
+
+    for (uint i=0; i < 3; i++) {
+
+        decimal* row1 = rows.jacobianBody1 + 6 * (3 + i);
+        decimal* row2 = rows.jacobianBody2 + 6 * (3 + i);
+
+        for (uint j=0; j < 3; j++) {
+            row1[j] = decimal(0.0);
+            row2[j] = decimal(0.0);
+            row1[3 + j] = (i == j) ? decimal(-1.0) : decimal(0.0);
+            row2[3 + j] = (i == j) ? decimal(1.0) : decimal(0.0);
+        }
+
+        rows.bias[3 + i] = mBiasRotation[i];
+    }
+}
+
+// Add the impulse of the equality constraints computed by the articulation solver
+void FixedJoint::addArticulationImpulse(const decimal* impulse) {
+    mImpulseTranslation += Vector3(impulse[0], impulse[1], impulse[2]);
+    mImpulseRotation += Vector3(impulse[3], impulse[4], impulse[5]);
+}
+
+// Compute the magnitudes of the linear and angular impulses of the joint
+/**
+ * @param[out] linearImpulse Magnitude of the impulse of the translation constraints
+ * @param[out] angularImpulse Magnitude of the impulse of the rotation constraints
+ */
+void FixedJoint::computeReactionImpulses(decimal& linearImpulse, decimal& angularImpulse) const {
+    linearImpulse = mImpulseTranslation.length();
+    angularImpulse = mImpulseRotation.length();
+}
+
+// Construct a copy of the joint between two other bodies in a given memory location
+Joint* FixedJoint::clone(jointindex id, RigidBody* body1, RigidBody* body2, void* allocatedMemory) const {
+    return new (allocatedMemory) FixedJoint(id, *this, body1, body2);
+}
+
+// Write the accumulated impulses of the joint
+void FixedJoint::saveImpulses(WorldStateWriter& writer) const {
+    writer.write(mImpulseTranslation);
+    writer.write(mImpulseRotation);
+}
+
+// Read the accumulated impulses of the joint written by saveImpulses()
+void FixedJoint::restoreImpulses(WorldStateReader& reader) {
+    reader.read(mImpulseTranslation);
+    reader.read(mImpulseRotation);
+}
+
+// Write the settings of the joint
+void FixedJoint::saveJointSettings(WorldStateWriter& writer) const {
+    writer.write(mLocalAnchorPointBody1);
+    writer.write(mLocalAnchorPointBody2);
+    writer.write(mInitOrientationDifferenceInv);
+}
+
+// Read the settings of the joint written by saveJointSettings()
+void FixedJoint::restoreJointSettings(WorldStateReader& reader) {
+    reader.read(mLocalAnchorPointBody1);
+    reader.read(mLocalAnchorPointBody2);
+    reader.read(mInitOrientationDifferenceInv);
+}
@@ -26,6 +26,8 @@
 // Libraries
 #include "HingeJoint.h"
 #include "engine/ConstraintSolver.h"
+#include "engine/WorldState.h"
+#include "engine/ArticulationSolver.h"
 
 using namespace reactphysics3d;
 
@@ -33,7 +35,7 @@ using namespace reactphysics3d;
 const decimal HingeJoint::BETA = decimal(0.2);
 
 // Constructor
-HingeJoint::HingeJoint(uint id, const HingeJointInfo& jointInfo)
+HingeJoint::HingeJoint(jointindex id, const HingeJointInfo& jointInfo)
            : Joint(id, jointInfo), mImpulseTranslation(0, 0, 0), mImpulseRotation(0, 0),
              mImpulseLowerLimit(0), mImpulseUpperLimit(0), mImpulseMotor(0),
              mIsLimitEnabled(jointInfo.isLimitEnabled), mIsMotorEnabled(jointInfo.isMotorEnabled),
@@ -63,6 +65,21 @@ HingeJoint::HingeJoint(uint id, const HingeJointInfo& jointInfo)
     mInitOrientationDifferenceInv.inverse();
 }
 
+// Constructor of a copy of a joint between two other bodies
+/// The settings and local frames of the joint are copied but not its impulses.
+HingeJoint::HingeJoint(jointindex id, const HingeJoint& joint, RigidBody* body1, RigidBody* body2)
+           : Joint(id, joint, body1, body2), mLocalAnchorPointBody1(joint.mLocalAnchorPointBody1),
+             mLocalAnchorPointBody2(joint.mLocalAnchorPointBody2), mHingeLocalAxisBody1(joint.mHingeLocalAxisBody1),
+             mHingeLocalAxisBody2(joint.mHingeLocalAxisBody2), mImpulseTranslation(0, 0, 0), mImpulseRotation(0, 0),
+             mImpulseLowerLimit(0), mImpulseUpperLimit(0), mImpulseMotor(0),
+             mInitOrientationDifferenceInv(joint.mInitOrientationDifferenceInv),
+             mIsLimitEnabled(joint.mIsLimitEnabled), mIsMotorEnabled(joint.mIsMotorEnabled),
+             mLowerLimit(joint.mLowerLimit), mUpperLimit(joint.mUpperLimit),
+             mIsLowerLimitViolated(false), mIsUpperLimitViolated(false),
+             mMotorSpeed(joint.mMotorSpeed), mMaxMotorTorque(joint.mMaxMotorTorque) {
+
+}
+
 // Initialize before solving the constraint
 void HingeJoint::initBeforeSolve(const ConstraintSolverData& constraintSolverData) {
 
@@ -70,19 +87,101 @@ void HingeJoint::initBeforeSolve(const ConstraintSolverData& constraintSolverDat
     mIndexBody1 = mBody1->mArrayIndex;
     mIndexBody2 = mBody2->mArrayIndex;
 
+    // Compute the coefficients of the soft equality constraints for the current time step
+    computeSoftness(constraintSolverData);
+
     // Get the bodies positions and orientations
-    const Vector3& x1 = mBody1->mCenterOfMassWorld;
-    const Vector3& x2 = mBody2->mCenterOfMassWorld;
+    const Vector3& x1 = mBody1->getCenterOfMassWorld();
+    const Vector3& x2 = mBody2->getCenterOfMassWorld();
     const Quaternion& orientationBody1 = mBody1->getTransform().getOrientation();
     const Quaternion& orientationBody2 = mBody2->getTransform().getOrientation();
 
-    // Get the inertia tensor of bodies
-    mI1 = mBody1->getInertiaTensorInverseWorld();
-    mI2 = mBody2->getInertiaTensorInverseWorld();
+    // Compute the bias factor of the constraints
+    decimal biasFactor = (BETA / constraintSolverData.timeStep);
 
-    // Compute the vector from body center to the anchor point in world-space
-    mR1World = orientationBody1 * mLocalAnchorPointBody1;
-    mR2World = orientationBody2 * mLocalAnchorPointBody2;
+    // If the bodies have not moved since the solver data has been computed, reuse it
+    if (canReuseSolverData(constraintSolverData)) {
+        mPositionError = mCachedPositionError;
+    }
+    else {
+
+        // Get the inertia tensor of bodies
+        mI1 = mBody1->getInertiaTensorInverseWorld();
+        mI2 = mBody2->getInertiaTensorInverseWorld();
+
+        // Compute the vector from body center to the anchor point in world-space
+        mR1World = orientationBody1 * mLocalAnchorPointBody1;
+        mR2World = orientationBody2 * mLocalAnchorPointBody2;
+
+        // Compute vectors needed in the Jacobian
+        mA1 = orientationBody1 * mHingeLocalAxisBody1;
+        Vector3 a2 = orientationBody2 * mHingeLocalAxisBody2;
+        mA1.normalize();
+        a2.normalize();
+        const Vector3 b2 = a2.getOneUnitOrthogonalVector();
+        const Vector3 c2 = a2.cross(b2);
+        mB2CrossA1 = b2.cross(mA1);
+        mC2CrossA1 = c2.cross(mA1);
+
+        // Compute the corresponding skew-symmetric matrices
+        Matrix3x3 skewSymmetricMatrixU1= Matrix3x3::computeSkewSymmetricMatrixForCrossProduct(mR1World);
+        Matrix3x3 skewSymmetricMatrixU2= Matrix3x3::computeSkewSymmetricMatrixForCrossProduct(mR2World);
+
+        // Compute the inverse mass matrix K=JM^-1J^t for the 3 translation constraints (3x3 matrix)
+        decimal inverseMassBodies = mBody1->mMassInverse + mBody2->mMassInverse;
+        Matrix3x3 massMatrix = Matrix3x3(inverseMassBodies, 0, 0,
+                                        0, inverseMassBodies, 0,
+                                        0, 0, inverseMassBodies) +
+                               skewSymmetricMatrixU1 * mI1 * skewSymmetricMatrixU1.getTranspose() +
+                               skewSymmetricMatrixU2 * mI2 * skewSymmetricMatrixU2.getTranspose();
+        mInverseMassMatrixTranslation.setToZero();
+        if (mBody1->getType() == BodyType::DYNAMIC || mBody2->getType() == BodyType::DYNAMIC) {
+            mInverseMassMatrixTranslation = massMatrix.getInverse();
+        }
+
+        // Compute the bias "b" of the translation constraints
+        mBTranslation.setToZero();
+        if (isSoft()) {
+            mBTranslation = mSoftness.biasRate * (x2 + mR2World - x1 - mR1World);
+        }
+        else if (mPositionCorrectionTechnique == JointsPositionCorrectionTechnique::BAUMGARTE_JOINTS) {
+            mBTranslation = biasFactor * (x2 + mR2World - x1 - mR1World);
+        }
+
+        // Compute the inverse mass matrix K=JM^-1J^t for the 2 rotation constraints (2x2 matrix)
+        Vector3 I1B2CrossA1 = mI1 * mB2CrossA1;
+        Vector3 I1C2CrossA1 = mI1 * mC2CrossA1;
+        Vector3 I2B2CrossA1 = mI2 * mB2CrossA1;
+        Vector3 I2C2CrossA1 = mI2 * mC2CrossA1;
+        const decimal el11 = mB2CrossA1.dot(I1B2CrossA1) +
+                             mB2CrossA1.dot(I2B2CrossA1);
+        const decimal el12 = mB2CrossA1.dot(I1C2CrossA1) +
+                             mB2CrossA1.dot(I2C2CrossA1);
+        const decimal el21 = mC2CrossA1.dot(I1B2CrossA1) +
+                             mC2CrossA1.dot(I2B2CrossA1);
+        const decimal el22 = mC2CrossA1.dot(I1C2CrossA1) +
+                             mC2CrossA1.dot(I2C2CrossA1);
+        const Matrix2x2 matrixKRotation(el11, el12, el21, el22);
+        mInverseMassMatrixRotation.setToZero();
+        if (mBody1->getType() == BodyType::DYNAMIC || mBody2->getType() == BodyType::DYNAMIC) {
+            mInverseMassMatrixRotation = matrixKRotation.getInverse();
+        }
+
+        // Compute the bias "b" of the rotation constraints
+        mBRotation.setToZero();
+        if (isSoft()) {
+            mBRotation = mSoftness.biasRate * Vector2(mA1.dot(b2), mA1.dot(c2));
+        }
+        else if (mPositionCorrectionTechnique == JointsPositionCorrectionTechnique::BAUMGARTE_JOINTS) {
+            mBRotation = biasFactor * Vector2(mA1.dot(b2), mA1.dot(c2));
+        }
+
+        // Measure the position error of the joint
+        mPositionError = (x2 + mR2World - x1 - mR1World).length();
+        updatePositionError(Vector2(mA1.dot(b2), mA1.dot(c2)).length());
+
+        cacheSolverData(constraintSolverData);
+    }
 
     // Compute the current angle around the hinge axis
     decimal hingeAngle = computeCurrentHingeAngle(orientationBody1, orientationBody2);
@@ -101,62 +200,10 @@ void HingeJoint::initBeforeSolve(const ConstraintSolverData& constraintSolverDat
         mImpulseUpperLimit = 0.0;
     }
 
-    // Compute vectors needed in the Jacobian
-    mA1 = orientationBody1 * mHingeLocalAxisBody1;
-    Vector3 a2 = orientationBody2 * mHingeLocalAxisBody2;
-    mA1.normalize();
-    a2.normalize();
-    const Vector3 b2 = a2.getOneUnitOrthogonalVector();
-    const Vector3 c2 = a2.cross(b2);
-    mB2CrossA1 = b2.cross(mA1);
-    mC2CrossA1 = c2.cross(mA1);
-
-    // Compute the corresponding skew-symmetric matrices
-    Matrix3x3 skewSymmetricMatrixU1= Matrix3x3::computeSkewSymmetricMatrixForCrossProduct(mR1World);
-    Matrix3x3 skewSymmetricMatrixU2= Matrix3x3::computeSkewSymmetricMatrixForCrossProduct(mR2World);
-
-    // Compute the inverse mass matrix K=JM^-1J^t for the 3 translation constraints (3x3 matrix)
-    decimal inverseMassBodies = mBody1->mMassInverse + mBody2->mMassInverse;
-    Matrix3x3 massMatrix = Matrix3x3(inverseMassBodies, 0, 0,
-                                    0, inverseMassBodies, 0,
-                                    0, 0, inverseMassBodies) +
-                           skewSymmetricMatrixU1 * mI1 * skewSymmetricMatrixU1.getTranspose() +
-                           skewSymmetricMatrixU2 * mI2 * skewSymmetricMatrixU2.getTranspose();
-    mInverseMassMatrixTranslation.setToZero();
-    if (mBody1->getType() == BodyType::DYNAMIC || mBody2->getType() == BodyType::DYNAMIC) {
-        mInverseMassMatrixTranslation = massMatrix.getInverse();
-    }
-
-    // Compute the bias "b" of the translation constraints
-    mBTranslation.setToZero();
-    decimal biasFactor = (BETA / constraintSolverData.timeStep);
-    if (mPositionCorrectionTechnique == JointsPositionCorrectionTechnique::BAUMGARTE_JOINTS) {
-        mBTranslation = biasFactor * (x2 + mR2World - x1 - mR1World);
-    }
-
-    // Compute the inverse mass matrix K=JM^-1J^t for the 2 rotation constraints (2x2 matrix)
-    Vector3 I1B2CrossA1 = mI1 * mB2CrossA1;
-    Vector3 I1C2CrossA1 = mI1 * mC2CrossA1;
-    Vector3 I2B2CrossA1 = mI2 * mB2CrossA1;
-    Vector3 I2C2CrossA1 = mI2 * mC2CrossA1;
-    const decimal el11 = mB2CrossA1.dot(I1B2CrossA1) +
-                         mB2CrossA1.dot(I2B2CrossA1);
-    const decimal el12 = mB2CrossA1.dot(I1C2CrossA1) +
-                         mB2CrossA1.dot(I2C2CrossA1);
-    const decimal el21 = mC2CrossA1.dot(I1B2CrossA1) +
-                         mC2CrossA1.dot(I2B2CrossA1);
-    const decimal el22 = mC2CrossA1.dot(I1C2CrossA1) +
-                         mC2CrossA1.dot(I2C2CrossA1);
-    const Matrix2x2 matrixKRotation(el11, el12, el21, el22);
-    mInverseMassMatrixRotation.setToZero();
-    if (mBody1->getType() == BodyType::DYNAMIC || mBody2->getType() == BodyType::DYNAMIC) {
-        mInverseMassMatrixRotation = matrixKRotation.getInverse();
-    }
-
-    // Compute the bias "b" of the rotation constraints
-    mBRotation.setToZero();
-    if (mPositionCorrectionTechnique == JointsPositionCorrectionTechnique::BAUMGARTE_JOINTS) {
-        mBRotation = biasFactor * Vector2(mA1.dot(b2), mA1.dot(c2));
+    // Measure the position error of the limits
+    if (mIsLimitEnabled) {
+        updatePositionError(std::min(lowerLimitError, decimal(0.0)));
+        updatePositionError(std::min(upperLimitError, decimal(0.0)));
     }
 
     // If warm-starting is not enabled
@@ -182,13 +229,13 @@ void HingeJoint::initBeforeSolve(const ConstraintSolverData& constraintSolverDat
 
             // Compute the bias "b" of the lower limit constraint
             mBLowerLimit = 0.0;
-            if (mPositionCorrectionTechnique == JointsPositionCorrectionTechnique::BAUMGARTE_JOINTS) {
+            if (mPositionCorrectionTechnique == JointsPositionCorrectionTechnique::BAUMGARTE_JOINTS || isSoft()) {
                 mBLowerLimit = biasFactor * lowerLimitError;
             }
 
             // Compute the bias "b" of the upper limit constraint
             mBUpperLimit = 0.0;
-            if (mPositionCorrectionTechnique == JointsPositionCorrectionTechnique::BAUMGARTE_JOINTS) {
+            if (mPositionCorrectionTechnique == JointsPositionCorrectionTechnique::BAUMGARTE_JOINTS || isSoft()) {
                 mBUpperLimit = biasFactor * upperLimitError;
             }
         }
@@ -254,6 +301,8 @@ void HingeJoint::warmstart(const ConstraintSolverData& constraintSolverData) {
 // Solve the velocity constraint
 void HingeJoint::solveVelocityConstraint(const ConstraintSolverData& constraintSolverData) {
 
+    mVelocityImpulseDelta = decimal(0.0);
+
     // Get the velocities
     Vector3& v1 = constraintSolverData.linearVelocities[mIndexBody1];
     Vector3& v2 = constraintSolverData.linearVelocities[mIndexBody2];
@@ -270,9 +319,11 @@ void HingeJoint::solveVelocityConstraint(const ConstraintSolverData& constraintS
     const Vector3 JvTranslation = v2 + w2.cross(mR2World) - v1 - w1.cross(mR1World);
 
     // Compute the Lagrange multiplier lambda
-    const Vector3 deltaLambdaTranslation = mInverseMassMatrixTranslation *
-                                          (-JvTranslation - mBTranslation);
+    const Vector3 deltaLambdaTranslation = mSoftness.massScale * (mInverseMassMatrixTranslation *
+                                          (-JvTranslation - mBTranslation)) -
+                                          mSoftness.impulseScale * mImpulseTranslation;
     mImpulseTranslation += deltaLambdaTranslation;
+    updateVelocityImpulseDelta(deltaLambdaTranslation.getAbsoluteVector().getMaxValue());
 
     // Compute the impulse P=J^T * lambda of body 1
     const Vector3 linearImpulseBody1 = -deltaLambdaTranslation;
@@ -296,8 +347,11 @@ void HingeJoint::solveVelocityConstraint(const ConstraintSolverData& constraintS
                              -mC2CrossA1.dot(w1) + mC2CrossA1.dot(w2));
 
     // Compute the Lagrange multiplier lambda for the 2 rotation constraints
-    Vector2 deltaLambdaRotation = mInverseMassMatrixRotation * (-JvRotation - mBRotation);
+    Vector2 deltaLambdaRotation = mSoftness.massScale * (mInverseMassMatrixRotation * (-JvRotation - mBRotation)) -
+                                  mSoftness.impulseScale * mImpulseRotation;
     mImpulseRotation += deltaLambdaRotation;
+    updateVelocityImpulseDelta(deltaLambdaRotation.x);
+    updateVelocityImpulseDelta(deltaLambdaRotation.y);
 
     // Compute the impulse P=J^T * lambda for the 2 rotation constraints of body 1
     angularImpulseBody1 = -mB2CrossA1 * deltaLambdaRotation.x -
@@ -312,97 +366,16 @@ void HingeJoint::solveVelocityConstraint(const ConstraintSolverData& constraintS
 
     // Apply the impulse to the body 2
     w2 += mI2 * angularImpulseBody2;
-
-    // --------------- Limits Constraints --------------- //
-
-    if (mIsLimitEnabled) {
-
-        // If the lower limit is violated
-        if (mIsLowerLimitViolated) {
-
-            // Compute J*v for the lower limit constraint
-            const decimal JvLowerLimit = (w2 - w1).dot(mA1);
-
-            // Compute the Lagrange multiplier lambda for the lower limit constraint
-            decimal deltaLambdaLower = mInverseMassMatrixLimitMotor * (-JvLowerLimit -mBLowerLimit);
-            decimal lambdaTemp = mImpulseLowerLimit;
-            mImpulseLowerLimit = std::max(mImpulseLowerLimit + deltaLambdaLower, decimal(0.0));
-            deltaLambdaLower = mImpulseLowerLimit - lambdaTemp;
-
-            // Compute the impulse P=J^T * lambda for the lower limit constraint of body 1
-            const Vector3 angularImpulseBody1 = -deltaLambdaLower * mA1;
-
-            // Apply the impulse to the body 1
-            w1 += mI1 * angularImpulseBody1;
-
-            // Compute the impulse P=J^T * lambda for the lower limit constraint of body 2
-            const Vector3 angularImpulseBody2 = deltaLambdaLower * mA1;
-
-            // Apply the impulse to the body 2
-            w2 += mI2 * angularImpulseBody2;
-        }
-
-        // If the upper limit is violated
-        if (mIsUpperLimitViolated) {
-
-            // Compute J*v for the upper limit constraint
-            const decimal JvUpperLimit = -(w2 - w1).dot(mA1);
-
-            // Compute the Lagrange multiplier lambda for the upper limit constraint
-            decimal deltaLambdaUpper = mInverseMassMatrixLimitMotor * (-JvUpperLimit -mBUpperLimit);
-            decimal lambdaTemp = mImpulseUpperLimit;
-            mImpulseUpperLimit = std::max(mImpulseUpperLimit + deltaLambdaUpper, decimal(0.0));
-            deltaLambdaUpper = mImpulseUpperLimit - lambdaTemp;
-
-            // Compute the impulse P=J^T * lambda for the upper limit constraint of body 1
-            const Vector3 angularImpulseBody1 = deltaLambdaUpper * mA1;
-
-            // Apply the impulse to the body 1
-            w1 += mI1 * angularImpulseBody1;
-
-            // Compute the impulse P=J^T * lambda for the upper limit constraint of body 2
-            const Vector3 angularImpulseBody2 = -deltaLambdaUpper * mA1;
-
-            // Apply the impulse to the body 2
-            w2 += mI2 * angularImpulseBody2;
-        }
-    }
-
-    // --------------- Motor --------------- //
-
-    // If the motor is enabled
-    if (mIsMotorEnabled) {
-
-        // Compute J*v for the motor
-        const decimal JvMotor = mA1.dot(w1 - w2);
-
-        // Compute the Lagrange multiplier lambda for the motor
-        const decimal maxMotorImpulse = mMaxMotorTorque * constraintSolverData.timeStep;
-        decimal deltaLambdaMotor = mInverseMassMatrixLimitMotor * (-JvMotor - mMotorSpeed);
-        decimal lambdaTemp = mImpulseMotor;
-        mImpulseMotor = clamp(mImpulseMotor + deltaLambdaMotor, -maxMotorImpulse, maxMotorImpulse);
-        deltaLambdaMotor = mImpulseMotor - lambdaTemp;
-
-        // Compute the impulse P=J^T * lambda for the motor of body 1
-        const Vector3 angularImpulseBody1 = -deltaLambdaMotor * mA1;
-
-        // Apply the impulse to the body 1
-        w1 += mI1 * angularImpulseBody1;
-
-        // Compute the impulse P=J^T * lambda for the motor of body 2
-        const Vector3 angularImpulseBody2 = deltaLambdaMotor * mA1;
-
-        // Apply the impulse to the body 2
-        w2 += mI2 * angularImpulseBody2;
-    }
 }
 
 // Solve the position constraint (for position error correction)
 void HingeJoint::solvePositionConstraint(const ConstraintSolverData& constraintSolverData) {
 
-    // If the error position correction technique is not the non-linear-gauss-seidel, we do
-    // do not execute this method
-    if (mPositionCorrectionTechnique != JointsPositionCorrectionTechnique::NON_LINEAR_GAUSS_SEIDEL) return;
+    // If the error position correction technique is not the non-linear-gauss-seidel or if the
+    // equality constraints are soft, we do not execute this method
+    if (mPositionCorrectionTechnique != JointsPositionCorrectionTechnique::NON_LINEAR_GAUSS_SEIDEL || isSoft()) return;
+
+    mPositionError = decimal(0.0);
 
     // Get the bodies positions and orientations
     Vector3& x1 = constraintSolverData.positions[mIndexBody1];
@@ -461,6 +434,7 @@ void HingeJoint::solvePositionConstraint(const ConstraintSolverData& constraintS
 
     // Compute position error for the 3 translation constraints
     const Vector3 errorTranslation = x2 + mR2World - x1 - mR1World;
+    updatePositionError(errorTranslation.length());
 
     // Compute the Lagrange multiplier lambda
     const Vector3 lambdaTranslation = mInverseMassMatrixTranslation * (-errorTranslation);
@@ -513,6 +487,7 @@ void HingeJoint::solvePositionConstraint(const ConstraintSolverData& constraintS
 
     // Compute the position error for the 3 rotation constraints
     const Vector2 errorRotation = Vector2(mA1.dot(b2), mA1.dot(c2));
+    updatePositionError(errorRotation.length());
 
     // Compute the Lagrange multiplier lambda for the 3 rotation constraints
     Vector2 lambdaRotation = mInverseMassMatrixRotation * (-errorRotation);
@@ -552,6 +527,8 @@ void HingeJoint::solvePositionConstraint(const ConstraintSolverData& constraintS
         // If the lower limit is violated
         if (mIsLowerLimitViolated) {
 
+            updatePositionError(lowerLimitError);
+
             // Compute the Lagrange multiplier lambda for the lower limit constraint
             decimal lambdaLowerLimit = mInverseMassMatrixLimitMotor * (-lowerLimitError );
 
@@ -579,6 +556,8 @@ void HingeJoint::solvePositionConstraint(const ConstraintSolverData& constraintS
         // If the upper limit is violated
         if (mIsUpperLimitViolated) {
 
+            updatePositionError(upperLimitError);
+
             // Compute the Lagrange multiplier lambda for the upper limit constraint
             decimal lambdaUpperLimit = mInverseMassMatrixLimitMotor * (-upperLimitError);
 
@@ -603,6 +582,8 @@ void HingeJoint::solvePositionConstraint(const ConstraintSolverData& constraintS
             q2.normalize();
         }
     }
+
+    invalidateCorrectedSolverData(constraintSolverData);
 }
 
 
@@ -796,3 +777,159 @@ decimal HingeJoint::computeCurrentHingeAngle(const Quaternion& orientationBody1,
     return computeCorrespondingAngleNearLimits(hingeAngle, mLowerLimit, mUpperLimit);
 }
 
+// Return the number of rows of the equality constraints solved by the articulation solver
+/// A hinge joint with a limit or a motor is solved by the sequential impulses
+uint HingeJoint::getNbArticulationRows() const {
+    return (mIsLimitEnabled || mIsMotorEnabled || isSoft()) ? 0 : 5;
+}
+
+// Compute the Jacobian and the bias of the equality constraints
+/// The two rotation constraints have the Jacobian of the velocities (b2 x a1).(w2 - w1)
+/// and (c2 x a1).(w2 - w1)
+void HingeJoint::computeArticulationRows(ArticulationJointRows& rows) const {
+
+    setAnchorPointArticulationRows(mR1World, mR2World, mBTranslation, rows);
+
+    const Vector3 axes[2] = {mB2CrossA1, mC2CrossA1};
+    for (uint i=0; i < 2; i++) {
+
+        decimal* row1 = rows.jacobianBody1 + 6 * (3 + i);
+        decimal* row2 = rows.jacobianBody2 + 6 * (3 + i);
+
+        for (uint j=0; j < 3; j++) {
+            row1[j] = decimal(0.0);
+            row2[j] = decimal(0.0);
+            row1[3 + j] = -axes[i][j];
+            row2[3 + j] = axes[i][j];
+        }
+
+        rows.bias[3 + i] = mBRotation[i];
+    }
+}
+
+// Add the impulse of the equality constraints computed by the articulation solver
+void HingeJoint::addArticulationImpulse(const decimal* impulse) {
+    mImpulseTranslation += Vector3(impulse[0], impulse[1], impulse[2]);
+    mImpulseRotation += Vector2(impulse[3], impulse[4]);
+}
+
+// Return the largest number of limit and motor rows of the joint during the current step
+uint HingeJoint::getNbMaxLimitMotorRows() const {
+    return (mIsLimitEnabled ? 2 : 0) + (mIsMotorEnabled ? 1 : 0);
+}
+
+// Compute the rows of the active limits and motor of the joint
+/// The lower and upper limits have one row each when they are violated and the motor has a
+/// row when it is enabled. The rows act on the relative angular velocity around the hinge axis.
+/**
+ * @param rows Array where the rows are written
+ * @param constraintSolverData Data of the constraint solver
+ * @return Number of rows of the joint
+ */
+uint HingeJoint::computeLimitMotorRows(JointLimitMotorRow* rows, const ConstraintSolverData& constraintSolverData) {
+
+    uint nbRows = 0;
+
+    if (mIsLimitEnabled) {
+
+        // Lower limit constraint with J*v = (w2 - w1).a1
+        if (mIsLowerLimitViolated) {
+            setLimitMotorRow(rows[nbRows], Vector3::zero(), -mA1, Vector3::zero(), mA1, mInverseMassMatrixLimitMotor,
+                             mBLowerLimit, decimal(0.0), DECIMAL_LARGEST, &mImpulseLowerLimit);
+            nbRows++;
+        }
+
+        // Upper limit constraint with J*v = (w1 - w2).a1
+        if (mIsUpperLimitViolated) {
+            setLimitMotorRow(rows[nbRows], Vector3::zero(), mA1, Vector3::zero(), -mA1, mInverseMassMatrixLimitMotor,
+                             mBUpperLimit, decimal(0.0), DECIMAL_LARGEST, &mImpulseUpperLimit);
+            nbRows++;
+        }
+    }
+
+    // Motor with J*v = (w1 - w2).a1
+    if (mIsMotorEnabled) {
+
+        const decimal maxMotorImpulse = mMaxMotorTorque * constraintSolverData.timeStep;
+        JointLimitMotorRow& row = rows[nbRows];
+        setLimitMotorRow(row, Vector3::zero(), mA1, Vector3::zero(), -mA1, mInverseMassMatrixLimitMotor,
+                         mMotorSpeed, -maxMotorImpulse, maxMotorImpulse, &mImpulseMotor);
+
+        // The motor impulse is applied along -a1 to body 1 and along a1 to body 2 (which is
+        // also the direction of the motor impulse in the warm start)
+        row.angularVelocityChangeBody1 = -row.angularVelocityChangeBody1;
+        row.angularVelocityChangeBody2 = -row.angularVelocityChangeBody2;
+        nbRows++;
+    }
+
+    return nbRows;
+}
+
+// Compute the magnitudes of the linear and angular impulses of the joint
+/// The impulses of the limits and of the motor act around the hinge axis which is
+/// orthogonal to the directions of the two rotation constraints.
+/**
+ * @param[out] linearImpulse Magnitude of the impulse of the translation constraints
+ * @param[out] angularImpulse Magnitude of the impulse of the rotation, limits and motor constraints
+ */
+void HingeJoint::computeReactionImpulses(decimal& linearImpulse, decimal& angularImpulse) const {
+
+    // Impulse applied to body 2 along the hinge axis
+    const decimal axialImpulse = mImpulseLowerLimit - mImpulseUpperLimit + mImpulseMotor;
+
+    linearImpulse = mImpulseTranslation.length();
+    angularImpulse = std::sqrt(mImpulseRotation.lengthSquare() + axialImpulse * axialImpulse);
+}
+
+// Construct a copy of the joint between two other bodies in a given memory location
+Joint* HingeJoint::clone(jointindex id, RigidBody* body1, RigidBody* body2, void* allocatedMemory) const {
+    return new (allocatedMemory) HingeJoint(id, *this, body1, body2);
+}
+
+// Write the accumulated impulses of the joint
+void HingeJoint::saveImpulses(WorldStateWriter& writer) const {
+    writer.write(mImpulseTranslation);
+    writer.write(mImpulseRotation);
+    writer.write(mImpulseLowerLimit);
+    writer.write(mImpulseUpperLimit);
+    writer.write(mImpulseMotor);
+}
+
+// Read the accumulated impulses of the joint written by saveImpulses()
+void HingeJoint::restoreImpulses(WorldStateReader& reader) {
+    reader.read(mImpulseTranslation);
+    reader.read(mImpulseRotation);
+    reader.read(mImpulseLowerLimit);
+    reader.read(mImpulseUpperLimit);
+    reader.read(mImpulseMotor);
+}
+
+// Write the settings of the joint
+void HingeJoint::saveJointSettings(WorldStateWriter& writer) const {
+    writer.write(mLocalAnchorPointBody1);
+    writer.write(mLocalAnchorPointBody2);
+    writer.write(mHingeLocalAxisBody1);
+    writer.write(mHingeLocalAxisBody2);
+    writer.write(mInitOrientationDifferenceInv);
+    writer.write(mIsLimitEnabled);
+    writer.write(mIsMotorEnabled);
+    writer.write(mLowerLimit);
+    writer.write(mUpperLimit);
+    writer.write(mMotorSpeed);
+    writer.write(mMaxMotorTorque);
+}
+
+// Read the settings of the joint written by saveJointSettings()
+void HingeJoint::restoreJointSettings(WorldStateReader& reader) {
+    reader.read(mLocalAnchorPointBody1);
+    reader.read(mLocalAnchorPointBody2);
+    reader.read(mHingeLocalAxisBody1);
+    reader.read(mHingeLocalAxisBody2);
+    reader.read(mInitOrientationDifferenceInv);
+    reader.read(mIsLimitEnabled);
+    reader.read(mIsMotorEnabled);
+    reader.read(mLowerLimit);
+    reader.read(mUpperLimit);
+    reader.read(mMotorSpeed);
+    reader.read(mMaxMotorTorque);
+}
@@ -25,15 +25,250 @@
 
 // Libraries
 #include "Joint.h"
+#include "engine/ArticulationSolver.h"
+#include "engine/ConstraintSolver.h"
+#include "engine/WorldState.h"
 
 using namespace reactphysics3d;
 
 // Constructor
-Joint::Joint(uint id, const JointInfo& jointInfo)
+Joint::Joint(jointindex id, const JointInfo& jointInfo)
            :mId(id), mBody1(jointInfo.body1), mBody2(jointInfo.body2), mType(jointInfo.type),
             mPositionCorrectionTechnique(jointInfo.positionCorrectionTechnique),
-            mIsCollisionEnabled(jointInfo.isCollisionEnabled), mIsAlreadyInIsland(false) {
+            mIsCollisionEnabled(jointInfo.isCollisionEnabled), mIsAlreadyInIsland(false),
+            mVelocityImpulseDelta(decimal(0.0)), mPositionError(decimal(0.0)),
+            mIsSolverDataCached(false), mCachedMassInverseBody1(decimal(0.0)),
+            mCachedMassInverseBody2(decimal(0.0)), mCachedTimeStep(decimal(0.0)), mCachedPositionError(decimal(0.0)),
+            mIsInArticulation(false),
+            mBreakForce(jointInfo.breakForce), mBreakTorque(jointInfo.breakTorque), mIsBroken(false),
+            mFrequency(jointInfo.frequency), mDampingRatio(jointInfo.dampingRatio),
+            mBlock(nullptr), mIsBeingDestroyed(false), mWorldIndex(0) {
 
     assert(mBody1 != nullptr);
     assert(mBody2 != nullptr);
+    assert(mBreakForce >= decimal(0.0));
+    assert(mBreakTorque >= decimal(0.0));
+    assert(mFrequency >= decimal(0.0));
+    assert(mDampingRatio >= decimal(0.0));
+}
+
+// Constructor of a copy of a joint between two other bodies
+/// The settings of the joint are copied but not its state (impulses and solver data).
+Joint::Joint(jointindex id, const Joint& joint, RigidBody* body1, RigidBody* body2)
+           :mId(id), mBody1(body1), mBody2(body2), mType(joint.mType),
+            mPositionCorrectionTechnique(joint.mPositionCorrectionTechnique),
+            mIsCollisionEnabled(joint.mIsCollisionEnabled), mIsAlreadyInIsland(false),
+            mVelocityImpulseDelta(decimal(0.0)), mPositionError(decimal(0.0)),
+            mIsSolverDataCached(false), mCachedMassInverseBody1(decimal(0.0)),
+            mCachedMassInverseBody2(decimal(0.0)), mCachedTimeStep(decimal(0.0)), mCachedPositionError(decimal(0.0)),
+            mIsInArticulation(false),
+            mBreakForce(joint.mBreakForce), mBreakTorque(joint.mBreakTorque), mIsBroken(false),
+            mFrequency(joint.mFrequency), mDampingRatio(joint.mDampingRatio),
+            mBlock(nullptr), mIsBeingDestroyed(false), mWorldIndex(0) {
+
+    assert(mBody1 != nullptr);
+    assert(mBody2 != nullptr);
+}
+
+// Compute the coefficients of the soft equality constraints for the current time step
+/**
+ * @param constraintSolverData Data of the current solve
+ */
+void Joint::computeSoftness(const ConstraintSolverData& constraintSolverData) {
+    mSoftness = SoftConstraintCoefficients::compute(mFrequency, mDampingRatio, constraintSolverData.timeStep);
+}
+
+// Mark the joint as broken if its force or torque exceeds its break threshold
+/// The force and the torque of the joint are the impulses accumulated by its
+/// constraints during the time step divided by the time step.
+/**
+ * @param timeStep Time step of the solver
+ * @return True if the joint has just been broken
+ */
+bool Joint::updateIsBroken(decimal timeStep) {
+
+    assert(!mIsBroken);
+
+    decimal linearImpulse;
+    decimal angularImpulse;
+    computeReactionImpulses(linearImpulse, angularImpulse);
+
+    mIsBroken = linearImpulse > mBreakForce * timeStep || angularImpulse > mBreakTorque * timeStep;
+
+    return mIsBroken;
+}
+
+// Return true if the solver data of the equality constraints computed by the last call to initBeforeSolve() can be reused
+/// The Jacobians, mass matrices and biases of the equality constraints only depend on the
+/// positions, orientations and masses of the bodies and on the time step. They are reused
+/// when the caching is enabled in the world settings, the time step and the inverse masses
+/// are the same and each body has moved by less than the tolerance (a distance and an angle)
+/// since they have been computed.
+/**
+ * @param constraintSolverData Data of the current solve
+ * @return True if the cached solver data of the joint is still valid
+ */
+bool Joint::canReuseSolverData(const ConstraintSolverData& constraintSolverData) const {
+
+    if (!constraintSolverData.isJointSolverDataCacheEnabled || !mIsSolverDataCached) return false;
+    if (constraintSolverData.timeStep != mCachedTimeStep) return false;
+    if (mBody1->mMassInverse != mCachedMassInverseBody1 || mBody2->mMassInverse != mCachedMassInverseBody2) {
+        return false;
+    }
+
+    const decimal tolerance = constraintSolverData.jointSolverDataCacheTolerance;
+
+    // Check the distance moved by the bodies
+    if ((mBody1->getCenterOfMassWorld() - mCachedCenterOfMassBody1).lengthSquare() > tolerance * tolerance ||
+        (mBody2->getCenterOfMassWorld() - mCachedCenterOfMassBody2).lengthSquare() > tolerance * tolerance) {
+        return false;
+    }
+
+    // Check the angle of the rotation of the bodies (twice the vector part of the relative rotation)
+    const Quaternion rotationBody1 = mBody1->getTransform().getOrientation() * mCachedOrientationBody1.getInverse();
+    const Quaternion rotationBody2 = mBody2->getTransform().getOrientation() * mCachedOrientationBody2.getInverse();
+    const decimal halfTolerance = decimal(0.5) * tolerance;
+    return rotationBody1.getVectorV().lengthSquare() <= halfTolerance * halfTolerance &&
+           rotationBody2.getVectorV().lengthSquare() <= halfTolerance * halfTolerance;
+}
+
+// Store the state of the bodies used to compute the solver data of the equality constraints
+/// This method must be called at the end of the computation of the data in initBeforeSolve()
+/// once the position error of the equality constraints has been measured.
+/**
+ * @param constraintSolverData Data of the current solve
+ */
+void Joint::cacheSolverData(const ConstraintSolverData& constraintSolverData) {
+
+    mIsSolverDataCached = constraintSolverData.isJointSolverDataCacheEnabled;
+    mCachedCenterOfMassBody1 = mBody1->getCenterOfMassWorld();
+    mCachedCenterOfMassBody2 = mBody2->getCenterOfMassWorld();
+    mCachedOrientationBody1 = mBody1->getTransform().getOrientation();
+    mCachedOrientationBody2 = mBody2->getTransform().getOrientation();
+    mCachedMassInverseBody1 = mBody1->mMassInverse;
+    mCachedMassInverseBody2 = mBody2->mMassInverse;
+    mCachedTimeStep = constraintSolverData.timeStep;
+    mCachedPositionError = mPositionError;
+}
+
+// Invalidate the cached solver data if the position solver has moved the bodies significantly
+/// The position solver recomputes the solver data of the joint for the corrected positions of
+/// the bodies. This data is only kept if the position error that has been corrected is smaller
+/// than the tolerance of the cache. This method is called at the end of solvePositionConstraint().
+/**
+ * @param constraintSolverData Data of the current solve
+ */
+void Joint::invalidateCorrectedSolverData(const ConstraintSolverData& constraintSolverData) {
+
+    if (mPositionError > constraintSolverData.jointSolverDataCacheTolerance) {
+        mIsSolverDataCached = false;
+    }
+}
+
+// Set the three rows of the constraint that keeps the anchor points of the bodies together
+/// The rows are the ones of the constraint x2 + r2 - x1 - r1 = 0 used by the ball-and-socket,
+/// hinge and fixed joints. Its velocity is v2 + w2 x r2 - v1 - w1 x r1.
+/**
+ * @param r1World Vector from the center of body 1 to the anchor point in world-space
+ * @param r2World Vector from the center of body 2 to the anchor point in world-space
+ * @param bias Bias of the three constraints
+ * @param rows Rows of the joint (the first three rows are set)
+ */
+void Joint::setAnchorPointArticulationRows(const Vector3& r1World, const Vector3& r2World,
+                                           const Vector3& bias, ArticulationJointRows& rows) {
+
+    // Skew-symmetric matrices such that skew(r) * w = r x w
+    const Matrix3x3 skewR1 = Matrix3x3::computeSkewSymmetricMatrixForCrossProduct(r1World);
+    const Matrix3x3 skewR2 = Matrix3x3::computeSkewSymmetricMatrixForCrossProduct(r2World);
+
+    for (uint i=0; i < 3; i++) {
+
+        decimal* row1 = rows.jacobianBody1 + 6 * i;
+        decimal* row2 = rows.jacobianBody2 + 6 * i;
+
+        for (uint j=0; j < 3; j++) {
+            row1[j] = (i == j) ? decimal(-1.0) : decimal(0.0);
+            row2[j] = (i == j) ? decimal(1.0) : decimal(0.0);
+            row1[3 + j] = skewR1[i][j];
+            row2[3 + j] = -skewR2[i][j];
+        }
+
+        rows.bias[i] = bias[i];
+    }
+}
+
+// Set a limit or motor row of the joint
+/// The impulse of the row is applied along the transpose of its Jacobian and the
+/// corresponding velocity changes of the bodies are precomputed.
+/**
+ * @param row Row to set
+ * @param linearJacobianBody1 Linear part of the Jacobian for body 1
+ * @param angularJacobianBody1 Angular part of the Jacobian for body 1
+ * @param linearJacobianBody2 Linear part of the Jacobian for body 2
+ * @param angularJacobianBody2 Angular part of the Jacobian for body 2
+ * @param inverseMass Inverse of the effective mass of the row
+ * @param bias Bias of the row
+ * @param minImpulse Lower bound of the accumulated impulse
+ * @param maxImpulse Upper bound of the accumulated impulse
+ * @param impulse Pointer to the accumulated impulse of the row in the joint
+ */
+void Joint::setLimitMotorRow(JointLimitMotorRow& row, const Vector3& linearJacobianBody1,
+                             const Vector3& angularJacobianBody1, const Vector3& linearJacobianBody2,
+                             const Vector3& angularJacobianBody2, decimal inverseMass, decimal bias,
+                             decimal minImpulse, decimal maxImpulse, decimal* impulse) const {
+
+    row.indexBody1 = mIndexBody1;
+    row.indexBody2 = mIndexBody2;
+    row.linearJacobianBody1 = linearJacobianBody1;
+    row.angularJacobianBody1 = angularJacobianBody1;
+    row.linearJacobianBody2 = linearJacobianBody2;
+    row.angularJacobianBody2 = angularJacobianBody2;
+    row.linearVelocityChangeBody1 = mBody1->mMassInverse * linearJacobianBody1;
+    row.angularVelocityChangeBody1 = mBody1->getInertiaTensorInverseWorld() * angularJacobianBody1;
+    row.linearVelocityChangeBody2 = mBody2->mMassInverse * linearJacobianBody2;
+    row.angularVelocityChangeBody2 = mBody2->getInertiaTensorInverseWorld() * angularJacobianBody2;
+    row.inverseMass = inverseMass;
+    row.bias = bias;
+    row.minImpulse = minImpulse;
+    row.maxImpulse = maxImpulse;
+    row.impulse = impulse;
+}
+
+// Write the state of the joint
+void Joint::saveState(WorldStateWriter& writer) const {
+    saveImpulses(writer);
+}
+
+// Restore the state of the joint written by saveState()
+/// The cached solver data is computed again at the next step because the bodies have moved.
+void Joint::restoreState(WorldStateReader& reader) {
+    restoreImpulses(reader);
+    mIsSolverDataCached = false;
+}
+
+// Write the settings of the joint
+/// The settings are the values given at the creation of the joint or with its setters (anchor
+/// points, axes, limits, motor, ...). They do not contain the bodies and the state of the joint.
+void Joint::saveSettings(WorldStateWriter& writer) const {
+    writer.write(mPositionCorrectionTechnique);
+    writer.write(mIsCollisionEnabled);
+    writer.write(mBreakForce);
+    writer.write(mBreakTorque);
+    writer.write(mFrequency);
+    writer.write(mDampingRatio);
+    saveJointSettings(writer);
+}
+
+// Restore the settings of the joint written by saveSettings()
+/// This must be done before the joint is added into the world because the collision
+/// between its bodies may be disabled.
+void Joint::restoreSettings(WorldStateReader& reader) {
+    reader.read(mPositionCorrectionTechnique);
+    reader.read(mIsCollisionEnabled);
+    reader.read(mBreakForce);
+    reader.read(mBreakTorque);
+    reader.read(mFrequency);
+    reader.read(mDampingRatio);
+    restoreJointSettings(reader);
+    mIsSolverDataCached = false;
 }
@@ -29,6 +29,7 @@
 // Libraries
 #include "configuration.h"
 #include "body/RigidBody.h"
+#include "constraint/SoftConstraint.h"
 #include "mathematics/mathematics.h"
 
 // ReactPhysics3D namespace
@@ -37,9 +38,16 @@ namespace reactphysics3d {
 /// Enumeration for the type of a constraint
 enum class JointType {BALLSOCKETJOINT, SLIDERJOINT, HINGEJOINT, FIXEDJOINT};
 
+/// Number of types of joints
+const uint NB_JOINT_TYPES = 4;
+
 // Class declarations
 struct ConstraintSolverData;
+struct ArticulationJointRows;
+struct JointLimitMotorRow;
 class Joint;
+class WorldStateWriter;
+class WorldStateReader;
 
 // Structure JointListElement
 /**
@@ -66,6 +74,25 @@ struct JointListElement {
         }
 };
 
+// Structure JointsBlock
+/**
+ * This structure is the header of a memory block where the joints created together
+ * with DynamicsWorld::createJoints() are stored contiguously. The block is released
+ * when its last joint is destroyed.
+ */
+struct JointsBlock {
+
+    public:
+
+        // -------------------- Attributes -------------------- //
+
+        /// Number of joints of the block that have not been destroyed yet
+        uint nbJoints;
+
+        /// Size of the block in bytes
+        size_t nbBytes;
+};
+
 // Structure JointInfo
 /**
  * This structure is used to gather the information needed to create a joint.
@@ -92,17 +119,34 @@ struct JointInfo {
         /// True if the two bodies of the joint are allowed to collide with each other
         bool isCollisionEnabled;
 
+        /// Largest force (in Newtons) that the joint can apply to its bodies before it
+        /// breaks. By default, the joint cannot break
+        decimal breakForce;
+
+        /// Largest torque (in Newtons * meters) that the joint can apply to its bodies
+        /// before it breaks. By default, the joint cannot break
+        decimal breakTorque;
+
+        /// Frequency (in Hertz) of the spring used to solve the equality constraints of the
+        /// joint as soft constraints. By default, the frequency is zero and the joint is rigid
+        decimal frequency;
+
+        /// Damping ratio of the spring of the soft equality constraints (one for a critical damping)
+        decimal dampingRatio;
+
         /// Constructor
         JointInfo(JointType constraintType)
                       : body1(nullptr), body2(nullptr), type(constraintType),
                         positionCorrectionTechnique(JointsPositionCorrectionTechnique::NON_LINEAR_GAUSS_SEIDEL),
-                        isCollisionEnabled(true) {}
+                        isCollisionEnabled(true), breakForce(DECIMAL_LARGEST), breakTorque(DECIMAL_LARGEST),
+                        frequency(decimal(0.0)), dampingRatio(decimal(1.0)) {}
 
         /// Constructor
         JointInfo(RigidBody* rigidBody1, RigidBody* rigidBody2, JointType constraintType)
                       : body1(rigidBody1), body2(rigidBody2), type(constraintType),
                         positionCorrectionTechnique(JointsPositionCorrectionTechnique::NON_LINEAR_GAUSS_SEIDEL),
-                        isCollisionEnabled(true) {
+                        isCollisionEnabled(true), breakForce(DECIMAL_LARGEST), breakTorque(DECIMAL_LARGEST),
+                        frequency(decimal(0.0)), dampingRatio(decimal(1.0)) {
         }
 
         /// Destructor
@@ -121,7 +165,7 @@ class Joint {
         // -------------------- Attributes -------------------- //
 
         /// Id of the joint
-        uint mId;
+        jointindex mId;
 
         /// Pointer to the first body of the joint
         RigidBody* const mBody1;
@@ -147,6 +191,75 @@ class Joint {
         /// True if the joint has already been added into an island
         bool mIsAlreadyInIsland;
 
+        /// Largest absolute change of the impulses of the joint during the
+        /// last call to solveVelocityConstraint()
+        decimal mVelocityImpulseDelta;
+
+        /// Largest position error (distance or angle) of the constraints of the joint when it
+        /// was last measured by initBeforeSolve() or solvePositionConstraint()
+        decimal mPositionError;
+
+        /// True if the Jacobians and mass matrices of the equality constraints computed by the
+        /// last call to initBeforeSolve() can be reused while the bodies do not move significantly
+        bool mIsSolverDataCached;
+
+        /// Center of mass of body 1 when the cached solver data has been computed
+        Vector3 mCachedCenterOfMassBody1;
+
+        /// Center of mass of body 2 when the cached solver data has been computed
+        Vector3 mCachedCenterOfMassBody2;
+
+        /// Orientation of body 1 when the cached solver data has been computed
+        Quaternion mCachedOrientationBody1;
+
+        /// Orientation of body 2 when the cached solver data has been computed
+        Quaternion mCachedOrientationBody2;
+
+        /// Inverse mass of body 1 when the cached solver data has been computed
+        decimal mCachedMassInverseBody1;
+
+        /// Inverse mass of body 2 when the cached solver data has been computed
+        decimal mCachedMassInverseBody2;
+
+        /// Time step used to compute the cached solver data
+        decimal mCachedTimeStep;
+
+        /// Position error of the equality constraints when the cached solver data has been computed
+        decimal mCachedPositionError;
+
+        /// True if the equality constraints of the joint are solved by the articulation
+        /// solver during the current step
+        bool mIsInArticulation;
+
+        /// Largest force that the joint can apply to its bodies before it breaks
+        decimal mBreakForce;
+
+        /// Largest torque that the joint can apply to its bodies before it breaks
+        decimal mBreakTorque;
+
+        /// True if the force or the torque of the joint has exceeded its break threshold
+        /// (the joint will be destroyed at the end of the current step)
+        bool mIsBroken;
+
+        /// Frequency (in Hertz) of the spring of the soft equality constraints (zero if rigid)
+        decimal mFrequency;
+
+        /// Damping ratio of the spring of the soft equality constraints
+        decimal mDampingRatio;
+
+        /// Coefficients of the soft equality constraints for the current time step
+        SoftConstraintCoefficients mSoftness;
+
+        /// Memory block that contains the joint if it has been created together with
+        /// other joints (null if the joint has its own allocation)
+        JointsBlock* mBlock;
+
+        /// True if the joint is being destroyed together with other joints
+        bool mIsBeingDestroyed;
+
+        /// Index of the joint in the list of joints of the world
+        uint mWorldIndex;
+
         /// Total number of joints
         static uint mNbTotalNbJoints;
 
@@ -155,6 +268,22 @@ class Joint {
         /// Return true if the joint has already been added into an island
         bool isAlreadyInIsland() const;
 
+        /// Update the largest change of the impulses during the velocity solve
+        void updateVelocityImpulseDelta(decimal deltaLambda);
+
+        /// Update the largest position error of the constraints of the joint
+        void updatePositionError(decimal error);
+
+        /// Return true if the solver data of the equality constraints computed by the last
+        /// call to initBeforeSolve() can be reused
+        bool canReuseSolverData(const ConstraintSolverData& constraintSolverData) const;
+
+        /// Store the state of the bodies used to compute the solver data of the equality constraints
+        void cacheSolverData(const ConstraintSolverData& constraintSolverData);
+
+        /// Invalidate the cached solver data if the position solver has moved the bodies significantly
+        void invalidateCorrectedSolverData(const ConstraintSolverData& constraintSolverData);
+
         /// Return the number of bytes used by the joint
         virtual size_t getSizeInBytes() const = 0;
 
@@ -170,12 +299,85 @@ class Joint {
         /// Solve the position constraint
         virtual void solvePositionConstraint(const ConstraintSolverData& constraintSolverData) = 0;
 
+        /// Return the number of rows of the equality constraints of the joint that can be solved
+        /// by the articulation solver (zero if the joint cannot be part of an articulation)
+        virtual uint getNbArticulationRows() const;
+
+        /// Compute the Jacobian and the bias of the equality constraints (after initBeforeSolve())
+        virtual void computeArticulationRows(ArticulationJointRows& rows) const;
+
+        /// Add the impulse of the equality constraints computed by the articulation solver
+        virtual void addArticulationImpulse(const decimal* impulse);
+
+        /// Set the three rows of the constraint that keeps the anchor points of the bodies together
+        static void setAnchorPointArticulationRows(const Vector3& r1World, const Vector3& r2World,
+                                                   const Vector3& bias, ArticulationJointRows& rows);
+
+        /// Compute the magnitudes of the linear and angular impulses accumulated by the
+        /// constraints of the joint during the current step
+        virtual void computeReactionImpulses(decimal& linearImpulse, decimal& angularImpulse) const = 0;
+
+        /// Write the accumulated impulses of the constraints of the joint (used for warm starting)
+        virtual void saveImpulses(WorldStateWriter& writer) const = 0;
+
+        /// Read the accumulated impulses of the constraints of the joint written by saveImpulses()
+        virtual void restoreImpulses(WorldStateReader& reader) = 0;
+
+        /// Write the settings that are specific to the type of the joint
+        virtual void saveJointSettings(WorldStateWriter& writer) const = 0;
+
+        /// Read the settings of the type of the joint written by saveJointSettings()
+        virtual void restoreJointSettings(WorldStateReader& reader) = 0;
+
+        /// Construct a copy of the joint between two other bodies in a given memory location
+        virtual Joint* clone(jointindex id, RigidBody* body1, RigidBody* body2, void* allocatedMemory) const = 0;
+
+        /// Write the state of the joint
+        void saveState(WorldStateWriter& writer) const;
+
+        /// Restore the state of the joint written by saveState()
+        void restoreState(WorldStateReader& reader);
+
+        /// Write the settings of the joint
+        void saveSettings(WorldStateWriter& writer) const;
+
+        /// Restore the settings of the joint written by saveSettings()
+        void restoreSettings(WorldStateReader& reader);
+
+        /// Return true if the joint can break
+        bool isBreakable() const;
+
+        /// Return true if the equality constraints of the joint are soft
+        bool isSoft() const;
+
+        /// Compute the coefficients of the soft equality constraints for the current time step
+        void computeSoftness(const ConstraintSolverData& constraintSolverData);
+
+        /// Mark the joint as broken if its force or torque exceeds its break threshold
+        bool updateIsBroken(decimal timeStep);
+
+        /// Return the largest number of limit and motor rows of the joint during the current step
+        virtual uint getNbMaxLimitMotorRows() const;
+
+        /// Compute the rows of the active limits and motor of the joint (after initBeforeSolve())
+        /// and return the number of rows
+        virtual uint computeLimitMotorRows(JointLimitMotorRow* rows, const ConstraintSolverData& constraintSolverData);
+
+        /// Set a limit or motor row of the joint
+        void setLimitMotorRow(JointLimitMotorRow& row, const Vector3& linearJacobianBody1,
+                              const Vector3& angularJacobianBody1, const Vector3& linearJacobianBody2,
+                              const Vector3& angularJacobianBody2, decimal inverseMass, decimal bias,
+                              decimal minImpulse, decimal maxImpulse, decimal* impulse) const;
+
     public :
 
         // -------------------- Methods -------------------- //
 
         /// Constructor
-        Joint(uint id, const JointInfo& jointInfo);
+        Joint(jointindex id, const JointInfo& jointInfo);
+
+        /// Constructor of a copy of a joint between two other bodies
+        Joint(jointindex id, const Joint& joint, RigidBody* body1, RigidBody* body2);
 
         /// Destructor
         virtual ~Joint() = default;
@@ -202,7 +404,31 @@ class Joint {
         bool isCollisionEnabled() const;
 
         /// Return the id of the joint
-        uint getId() const;
+        jointindex getId() const;
+
+        /// Return the largest force that the joint can apply to its bodies before it breaks
+        decimal getBreakForce() const;
+
+        /// Set the largest force that the joint can apply to its bodies before it breaks
+        void setBreakForce(decimal breakForce);
+
+        /// Return the largest torque that the joint can apply to its bodies before it breaks
+        decimal getBreakTorque() const;
+
+        /// Set the largest torque that the joint can apply to its bodies before it breaks
+        void setBreakTorque(decimal breakTorque);
+
+        /// Return true if the joint has been broken during the current step
+        bool isBroken() const;
+
+        /// Return the frequency of the spring of the soft equality constraints
+        decimal getFrequency() const;
+
+        /// Return the damping ratio of the spring of the soft equality constraints
+        decimal getDampingRatio() const;
+
+        /// Set the frequency and the damping ratio of the spring of the soft equality constraints
+        void setSoftness(decimal frequency, decimal dampingRatio);
 
         /// Return a string representation
         virtual std::string to_string() const=0;
@@ -212,6 +438,9 @@ class Joint {
         friend class DynamicsWorld;
         friend class Island;
         friend class ConstraintSolver;
+        friend class PositionBasedSolver;
+        friend class ArticulationSolver;
+        friend class RigidBody;
 };
 
 // Return the reference to the body 1
@@ -259,15 +488,142 @@ inline bool Joint::isCollisionEnabled() const {
 /**
  * @return The id of the joint
  */
-inline uint Joint::getId() const {
+inline jointindex Joint::getId() const {
     return mId;
 }
 
+// Return the largest force that the joint can apply to its bodies before it breaks
+/**
+ * @return The break force of the joint (in Newtons)
+ */
+inline decimal Joint::getBreakForce() const {
+    return mBreakForce;
+}
+
+// Set the largest force that the joint can apply to its bodies before it breaks
+/**
+ * @param breakForce The new break force of the joint (in Newtons)
+ */
+inline void Joint::setBreakForce(decimal breakForce) {
+    assert(breakForce >= decimal(0.0));
+    mBreakForce = breakForce;
+}
+
+// Return the largest torque that the joint can apply to its bodies before it breaks
+/**
+ * @return The break torque of the joint (in Newtons * meters)
+ */
+inline decimal Joint::getBreakTorque() const {
+    return mBreakTorque;
+}
+
+// Set the largest torque that the joint can apply to its bodies before it breaks
+/**
+ * @param breakTorque The new break torque of the joint (in Newtons * meters)
+ */
+inline void Joint::setBreakTorque(decimal breakTorque) {
+    assert(breakTorque >= decimal(0.0));
+    mBreakTorque = breakTorque;
+}
+
+// Return true if the joint has been broken during the current step
+/**
+ * @return True if the force or the torque of the joint has exceeded its break threshold
+ */
+inline bool Joint::isBroken() const {
+    return mIsBroken;
+}
+
+// Return the frequency of the spring of the soft equality constraints
+/**
+ * @return The frequency of the spring (in Hertz) or zero if the joint is rigid
+ */
+inline decimal Joint::getFrequency() const {
+    return mFrequency;
+}
+
+// Return the damping ratio of the spring of the soft equality constraints
+/**
+ * @return The damping ratio of the spring
+ */
+inline decimal Joint::getDampingRatio() const {
+    return mDampingRatio;
+}
+
+// Set the frequency and the damping ratio of the spring of the soft equality constraints
+/// With a positive frequency, the equality constraints of the joint behave like a spring
+/// and a damper instead of being corrected by the position correction technique.
+/**
+ * @param frequency Frequency of the spring (in Hertz). Zero makes the joint rigid
+ * @param dampingRatio Damping ratio of the spring (one for a critical damping)
+ */
+inline void Joint::setSoftness(decimal frequency, decimal dampingRatio) {
+    assert(frequency >= decimal(0.0));
+    assert(dampingRatio >= decimal(0.0));
+    mFrequency = frequency;
+    mDampingRatio = dampingRatio;
+
+    // The biases of the equality constraints depend on the softness
+    mIsSolverDataCached = false;
+}
+
+// Return true if the joint can break
+inline bool Joint::isBreakable() const {
+    return mBreakForce < DECIMAL_LARGEST || mBreakTorque < DECIMAL_LARGEST;
+}
+
+// Return true if the equality constraints of the joint are soft
+inline bool Joint::isSoft() const {
+    return mFrequency > decimal(0.0);
+}
+
 // Return true if the joint has already been added into an island
 inline bool Joint::isAlreadyInIsland() const {
     return mIsAlreadyInIsland;
 }
 
+// Update the largest change of the impulses during the velocity solve
+/**
+ * @param deltaLambda Change of an impulse of the joint
+ */
+inline void Joint::updateVelocityImpulseDelta(decimal deltaLambda) {
+    mVelocityImpulseDelta = std::max(mVelocityImpulseDelta, std::abs(deltaLambda));
+}
+
+// Update the largest position error of the constraints of the joint
+/**
+ * @param error Position error of a constraint of the joint (a distance or an angle)
+ */
+inline void Joint::updatePositionError(decimal error) {
+    mPositionError = std::max(mPositionError, std::abs(error));
+}
+
+// Return the number of rows of the equality constraints of the joint that can be solved
+// by the articulation solver
+inline uint Joint::getNbArticulationRows() const {
+    return 0;
+}
+
+// Compute the Jacobian and the bias of the equality constraints
+inline void Joint::computeArticulationRows(ArticulationJointRows& rows) const {
+    assert(false);
+}
+
+// Add the impulse of the equality constraints computed by the articulation solver
+inline void Joint::addArticulationImpulse(const decimal* impulse) {
+    assert(false);
+}
+
+// Return the largest number of limit and motor rows of the joint during the current step
+inline uint Joint::getNbMaxLimitMotorRows() const {
+    return 0;
+}
+
+// Compute the rows of the active limits and motor of the joint
+inline uint Joint::computeLimitMotorRows(JointLimitMotorRow* rows, const ConstraintSolverData& constraintSolverData) {
+    return 0;
+}
+
 }
 
 #endif
@@ -26,6 +26,7 @@
 // Libraries
 #include "SliderJoint.h"
 #include "engine/ConstraintSolver.h"
+#include "engine/WorldState.h"
 
 using namespace reactphysics3d;
 
@@ -33,7 +34,7 @@ using namespace reactphysics3d;
 const decimal SliderJoint::BETA = decimal(0.2);
 
 // Constructor
-SliderJoint::SliderJoint(uint id, const SliderJointInfo& jointInfo)
+SliderJoint::SliderJoint(jointindex id, const SliderJointInfo& jointInfo)
             : Joint(id, jointInfo), mImpulseTranslation(0, 0), mImpulseRotation(0, 0, 0),
               mImpulseLowerLimit(0), mImpulseUpperLimit(0), mImpulseMotor(0),
               mIsLimitEnabled(jointInfo.isLimitEnabled), mIsMotorEnabled(jointInfo.isMotorEnabled),
@@ -71,6 +72,22 @@ SliderJoint::SliderJoint(uint id, const SliderJointInfo& jointInfo)
     mSliderAxisBody1.normalize();
 }
 
+// Constructor of a copy of a joint between two other bodies
+/// The settings and local frames of the joint are copied but not its impulses.
+SliderJoint::SliderJoint(jointindex id, const SliderJoint& joint, RigidBody* body1, RigidBody* body2)
+            : Joint(id, joint, body1, body2), mLocalAnchorPointBody1(joint.mLocalAnchorPointBody1),
+              mLocalAnchorPointBody2(joint.mLocalAnchorPointBody2), mSliderAxisBody1(joint.mSliderAxisBody1),
+              mInitOrientationDifferenceInv(joint.mInitOrientationDifferenceInv),
+              mImpulseTranslation(0, 0), mImpulseRotation(0, 0, 0),
+              mImpulseLowerLimit(0), mImpulseUpperLimit(0), mImpulseMotor(0),
+              mIsLimitEnabled(joint.mIsLimitEnabled), mIsMotorEnabled(joint.mIsMotorEnabled),
+              mSliderAxisWorld(joint.mSliderAxisWorld), mLowerLimit(joint.mLowerLimit),
+              mUpperLimit(joint.mUpperLimit), mIsLowerLimitViolated(false),
+              mIsUpperLimitViolated(false), mMotorSpeed(joint.mMotorSpeed),
+              mMaxMotorForce(joint.mMaxMotorForce) {
+
+}
+
 // Initialize before solving the constraint
 void SliderJoint::initBeforeSolve(const ConstraintSolverData& constraintSolverData) {
 
@@ -78,29 +95,113 @@ void SliderJoint::initBeforeSolve(const ConstraintSolverData& constraintSolverDa
     mIndexBody1 = mBody1->mArrayIndex;
     mIndexBody2 = mBody2->mArrayIndex;
 
+    // Compute the coefficients of the soft equality constraints for the current time step
+    computeSoftness(constraintSolverData);
+
     // Get the bodies positions and orientations
-    const Vector3& x1 = mBody1->mCenterOfMassWorld;
-    const Vector3& x2 = mBody2->mCenterOfMassWorld;
+    const Vector3& x1 = mBody1->getCenterOfMassWorld();
+    const Vector3& x2 = mBody2->getCenterOfMassWorld();
     const Quaternion& orientationBody1 = mBody1->getTransform().getOrientation();
     const Quaternion& orientationBody2 = mBody2->getTransform().getOrientation();
 
-    // Get the inertia tensor of bodies
-    mI1 = mBody1->getInertiaTensorInverseWorld();
-    mI2 = mBody2->getInertiaTensorInverseWorld();
+    // Compute the bias factor of the constraints
+    decimal biasFactor = (BETA / constraintSolverData.timeStep);
 
-    // Vector from body center to the anchor point
-    mR1 = orientationBody1 * mLocalAnchorPointBody1;
-    mR2 = orientationBody2 * mLocalAnchorPointBody2;
+    // If the bodies have not moved since the solver data has been computed, reuse it
+    if (canReuseSolverData(constraintSolverData)) {
+        mPositionError = mCachedPositionError;
+    }
+    else {
+
+        // Get the inertia tensor of bodies
+        mI1 = mBody1->getInertiaTensorInverseWorld();
+        mI2 = mBody2->getInertiaTensorInverseWorld();
+
+        // Vector from body center to the anchor point
+        mR1 = orientationBody1 * mLocalAnchorPointBody1;
+        mR2 = orientationBody2 * mLocalAnchorPointBody2;
+
+        // Compute the vector u (difference between anchor points)
+        const Vector3 u = x2 + mR2 - x1 - mR1;
+
+        // Compute the two orthogonal vectors to the slider axis in world-space
+        mSliderAxisWorld = orientationBody1 * mSliderAxisBody1;
+        mSliderAxisWorld.normalize();
+        mN1 = mSliderAxisWorld.getOneUnitOrthogonalVector();
+        mN2 = mSliderAxisWorld.cross(mN1);
+
+        // Compute the cross products used in the Jacobians
+        mR2CrossN1 = mR2.cross(mN1);
+        mR2CrossN2 = mR2.cross(mN2);
+        mR2CrossSliderAxis = mR2.cross(mSliderAxisWorld);
+        const Vector3 r1PlusU = mR1 + u;
+        mR1PlusUCrossN1 = (r1PlusU).cross(mN1);
+        mR1PlusUCrossN2 = (r1PlusU).cross(mN2);
+        mR1PlusUCrossSliderAxis = (r1PlusU).cross(mSliderAxisWorld);
+
+        // Compute the inverse of the mass matrix K=JM^-1J^t for the 2 translation
+        // constraints (2x2 matrix)
+        decimal sumInverseMass = mBody1->mMassInverse + mBody2->mMassInverse;
+        Vector3 I1R1PlusUCrossN1 = mI1 * mR1PlusUCrossN1;
+        Vector3 I1R1PlusUCrossN2 = mI1 * mR1PlusUCrossN2;
+        Vector3 I2R2CrossN1 = mI2 * mR2CrossN1;
+        Vector3 I2R2CrossN2 = mI2 * mR2CrossN2;
+        const decimal el11 = sumInverseMass + mR1PlusUCrossN1.dot(I1R1PlusUCrossN1) +
+                             mR2CrossN1.dot(I2R2CrossN1);
+        const decimal el12 = mR1PlusUCrossN1.dot(I1R1PlusUCrossN2) +
+                             mR2CrossN1.dot(I2R2CrossN2);
+        const decimal el21 = mR1PlusUCrossN2.dot(I1R1PlusUCrossN1) +
+                             mR2CrossN2.dot(I2R2CrossN1);
+        const decimal el22 = sumInverseMass + mR1PlusUCrossN2.dot(I1R1PlusUCrossN2) +
+                             mR2CrossN2.dot(I2R2CrossN2);
+        Matrix2x2 matrixKTranslation(el11, el12, el21, el22);
+        mInverseMassMatrixTranslationConstraint.setToZero();
+        if (mBody1->getType() == BodyType::DYNAMIC || mBody2->getType() == BodyType::DYNAMIC) {
+            mInverseMassMatrixTranslationConstraint = matrixKTranslation.getInverse();
+        }
+
+        // Compute the bias "b" of the translation constraint
+        mBTranslation.setToZero();
+        if (isSoft()) {
+            mBTranslation.x = u.dot(mN1);
+            mBTranslation.y = u.dot(mN2);
+            mBTranslation *= mSoftness.biasRate;
+        }
+        else if (mPositionCorrectionTechnique == JointsPositionCorrectionTechnique::BAUMGARTE_JOINTS) {
+            mBTranslation.x = u.dot(mN1);
+            mBTranslation.y = u.dot(mN2);
+            mBTranslation *= biasFactor;
+        }
+
+        // Compute the inverse of the mass matrix K=JM^-1J^t for the 3 rotation
+        // contraints (3x3 matrix)
+        mInverseMassMatrixRotationConstraint = mI1 + mI2;
+        if (mBody1->getType() == BodyType::DYNAMIC || mBody2->getType() == BodyType::DYNAMIC) {
+            mInverseMassMatrixRotationConstraint = mInverseMassMatrixRotationConstraint.getInverse();
+        }
+
+        // Compute the bias "b" of the rotation constraint
+        mBRotation.setToZero();
+        if (isSoft()) {
+            const Quaternion qError = orientationBody2 * mInitOrientationDifferenceInv * orientationBody1.getInverse();
+            mBRotation = mSoftness.biasRate * decimal(2.0) * qError.getVectorV();
+        }
+        else if (mPositionCorrectionTechnique == JointsPositionCorrectionTechnique::BAUMGARTE_JOINTS) {
+            const Quaternion qError = orientationBody2 * mInitOrientationDifferenceInv * orientationBody1.getInverse();
+            mBRotation = biasFactor * decimal(2.0) * qError.getVectorV();
+        }
+
+        // Measure the position error of the joint
+        const Quaternion qError = orientationBody2 * mInitOrientationDifferenceInv * orientationBody1.getInverse();
+        mPositionError = Vector2(u.dot(mN1), u.dot(mN2)).length();
+        updatePositionError(decimal(2.0) * qError.getVectorV().length());
+
+        cacheSolverData(constraintSolverData);
+    }
 
     // Compute the vector u (difference between anchor points)
     const Vector3 u = x2 + mR2 - x1 - mR1;
 
-    // Compute the two orthogonal vectors to the slider axis in world-space
-    mSliderAxisWorld = orientationBody1 * mSliderAxisBody1;
-    mSliderAxisWorld.normalize();
-    mN1 = mSliderAxisWorld.getOneUnitOrthogonalVector();
-    mN2 = mSliderAxisWorld.cross(mN1);
-
     // Check if the limit constraints are violated or not
     decimal uDotSliderAxis = u.dot(mSliderAxisWorld);
     decimal lowerLimitError = uDotSliderAxis - mLowerLimit;
@@ -116,57 +217,10 @@ void SliderJoint::initBeforeSolve(const ConstraintSolverData& constraintSolverDa
         mImpulseUpperLimit = 0.0;
     }
 
-    // Compute the cross products used in the Jacobians
-    mR2CrossN1 = mR2.cross(mN1);
-    mR2CrossN2 = mR2.cross(mN2);
-    mR2CrossSliderAxis = mR2.cross(mSliderAxisWorld);
-    const Vector3 r1PlusU = mR1 + u;
-    mR1PlusUCrossN1 = (r1PlusU).cross(mN1);
-    mR1PlusUCrossN2 = (r1PlusU).cross(mN2);
-    mR1PlusUCrossSliderAxis = (r1PlusU).cross(mSliderAxisWorld);
-
-    // Compute the inverse of the mass matrix K=JM^-1J^t for the 2 translation
-    // constraints (2x2 matrix)
-    decimal sumInverseMass = mBody1->mMassInverse + mBody2->mMassInverse;
-    Vector3 I1R1PlusUCrossN1 = mI1 * mR1PlusUCrossN1;
-    Vector3 I1R1PlusUCrossN2 = mI1 * mR1PlusUCrossN2;
-    Vector3 I2R2CrossN1 = mI2 * mR2CrossN1;
-    Vector3 I2R2CrossN2 = mI2 * mR2CrossN2;
-    const decimal el11 = sumInverseMass + mR1PlusUCrossN1.dot(I1R1PlusUCrossN1) +
-                         mR2CrossN1.dot(I2R2CrossN1);
-    const decimal el12 = mR1PlusUCrossN1.dot(I1R1PlusUCrossN2) +
-                         mR2CrossN1.dot(I2R2CrossN2);
-    const decimal el21 = mR1PlusUCrossN2.dot(I1R1PlusUCrossN1) +
-                         mR2CrossN2.dot(I2R2CrossN1);
-    const decimal el22 = sumInverseMass + mR1PlusUCrossN2.dot(I1R1PlusUCrossN2) +
-                         mR2CrossN2.dot(I2R2CrossN2);
-    Matrix2x2 matrixKTranslation(el11, el12, el21, el22);
-    mInverseMassMatrixTranslationConstraint.setToZero();
-    if (mBody1->getType() == BodyType::DYNAMIC || mBody2->getType() == BodyType::DYNAMIC) {
-        mInverseMassMatrixTranslationConstraint = matrixKTranslation.getInverse();
-    }
-
-    // Compute the bias "b" of the translation constraint
-    mBTranslation.setToZero();
-    decimal biasFactor = (BETA / constraintSolverData.timeStep);
-    if (mPositionCorrectionTechnique == JointsPositionCorrectionTechnique::BAUMGARTE_JOINTS) {
-        mBTranslation.x = u.dot(mN1);
-        mBTranslation.y = u.dot(mN2);
-        mBTranslation *= biasFactor;
-    }
-
-    // Compute the inverse of the mass matrix K=JM^-1J^t for the 3 rotation
-    // contraints (3x3 matrix)
-    mInverseMassMatrixRotationConstraint = mI1 + mI2;
-    if (mBody1->getType() == BodyType::DYNAMIC || mBody2->getType() == BodyType::DYNAMIC) {
-        mInverseMassMatrixRotationConstraint = mInverseMassMatrixRotationConstraint.getInverse();
-    }
-
-    // Compute the bias "b" of the rotation constraint
-    mBRotation.setToZero();
-    if (mPositionCorrectionTechnique == JointsPositionCorrectionTechnique::BAUMGARTE_JOINTS) {
-        const Quaternion qError = orientationBody2 * mInitOrientationDifferenceInv * orientationBody1.getInverse();
-        mBRotation = biasFactor * decimal(2.0) * qError.getVectorV();
+    // Measure the position error of the limits
+    if (mIsLimitEnabled) {
+        updatePositionError(std::min(lowerLimitError, decimal(0.0)));
+        updatePositionError(std::min(upperLimitError, decimal(0.0)));
     }
 
     // If the limits are enabled
@@ -181,13 +235,13 @@ void SliderJoint::initBeforeSolve(const ConstraintSolverData& constraintSolverDa
 
         // Compute the bias "b" of the lower limit constraint
         mBLowerLimit = 0.0;
-        if (mPositionCorrectionTechnique == JointsPositionCorrectionTechnique::BAUMGARTE_JOINTS) {
+        if (mPositionCorrectionTechnique == JointsPositionCorrectionTechnique::BAUMGARTE_JOINTS || isSoft()) {
             mBLowerLimit = biasFactor * lowerLimitError;
         }
 
         // Compute the bias "b" of the upper limit constraint
         mBUpperLimit = 0.0;
-        if (mPositionCorrectionTechnique == JointsPositionCorrectionTechnique::BAUMGARTE_JOINTS) {
+        if (mPositionCorrectionTechnique == JointsPositionCorrectionTechnique::BAUMGARTE_JOINTS || isSoft()) {
             mBUpperLimit = biasFactor * upperLimitError;
         }
     }
@@ -275,6 +329,8 @@ void SliderJoint::warmstart(const ConstraintSolverData& constraintSolverData) {
 // Solve the velocity constraint
 void SliderJoint::solveVelocityConstraint(const ConstraintSolverData& constraintSolverData) {
 
+    mVelocityImpulseDelta = decimal(0.0);
+
     // Get the velocities
     Vector3& v1 = constraintSolverData.linearVelocities[mIndexBody1];
     Vector3& v2 = constraintSolverData.linearVelocities[mIndexBody2];
@@ -295,8 +351,11 @@ void SliderJoint::solveVelocityConstraint(const ConstraintSolverData& constraint
     const Vector2 JvTranslation(el1, el2);
 
     // Compute the Lagrange multiplier lambda for the 2 translation constraints
-    Vector2 deltaLambda = mInverseMassMatrixTranslationConstraint * (-JvTranslation -mBTranslation);
+    Vector2 deltaLambda = mSoftness.massScale * (mInverseMassMatrixTranslationConstraint * (-JvTranslation -mBTranslation)) -
+                          mSoftness.impulseScale * mImpulseTranslation;
     mImpulseTranslation += deltaLambda;
+    updateVelocityImpulseDelta(deltaLambda.x);
+    updateVelocityImpulseDelta(deltaLambda.y);
 
     // Compute the impulse P=J^T * lambda for the 2 translation constraints of body 1
     const Vector3 linearImpulseBody1 = -mN1 * deltaLambda.x - mN2 * deltaLambda.y;
@@ -321,8 +380,10 @@ void SliderJoint::solveVelocityConstraint(const ConstraintSolverData& constraint
     const Vector3 JvRotation = w2 - w1;
 
     // Compute the Lagrange multiplier lambda for the 3 rotation constraints
-    Vector3 deltaLambda2 = mInverseMassMatrixRotationConstraint * (-JvRotation - mBRotation);
+    Vector3 deltaLambda2 = mSoftness.massScale * (mInverseMassMatrixRotationConstraint * (-JvRotation - mBRotation)) -
+                           mSoftness.impulseScale * mImpulseRotation;
     mImpulseRotation += deltaLambda2;
+    updateVelocityImpulseDelta(deltaLambda2.getAbsoluteVector().getMaxValue());
 
     // Compute the impulse P=J^T * lambda for the 3 rotation constraints of body 1
     angularImpulseBody1 = -deltaLambda2;
@@ -335,106 +396,16 @@ void SliderJoint::solveVelocityConstraint(const ConstraintSolverData& constraint
 
     // Apply the impulse to the body 2
     w2 += mI2 * angularImpulseBody2;
-
-    // --------------- Limits Constraints --------------- //
-
-    if (mIsLimitEnabled) {
-
-        // If the lower limit is violated
-        if (mIsLowerLimitViolated) {
-
-            // Compute J*v for the lower limit constraint
-            const decimal JvLowerLimit = mSliderAxisWorld.dot(v2) + mR2CrossSliderAxis.dot(w2) -
-                                         mSliderAxisWorld.dot(v1) - mR1PlusUCrossSliderAxis.dot(w1);
-
-            // Compute the Lagrange multiplier lambda for the lower limit constraint
-            decimal deltaLambdaLower = mInverseMassMatrixLimit * (-JvLowerLimit -mBLowerLimit);
-            decimal lambdaTemp = mImpulseLowerLimit;
-            mImpulseLowerLimit = std::max(mImpulseLowerLimit + deltaLambdaLower, decimal(0.0));
-            deltaLambdaLower = mImpulseLowerLimit - lambdaTemp;
-
-            // Compute the impulse P=J^T * lambda for the lower limit constraint of body 1
-            const Vector3 linearImpulseBody1 = -deltaLambdaLower * mSliderAxisWorld;
-            const Vector3 angularImpulseBody1 = -deltaLambdaLower * mR1PlusUCrossSliderAxis;
-
-            // Apply the impulse to the body 1
-            v1 += inverseMassBody1 * linearImpulseBody1;
-            w1 += mI1 * angularImpulseBody1;
-
-            // Compute the impulse P=J^T * lambda for the lower limit constraint of body 2
-            const Vector3 linearImpulseBody2 = deltaLambdaLower * mSliderAxisWorld;
-            const Vector3 angularImpulseBody2 = deltaLambdaLower * mR2CrossSliderAxis;
-
-            // Apply the impulse to the body 2
-            v2 += inverseMassBody2 * linearImpulseBody2;
-            w2 += mI2 * angularImpulseBody2;
-        }
-
-        // If the upper limit is violated
-        if (mIsUpperLimitViolated) {
-
-            // Compute J*v for the upper limit constraint
-            const decimal JvUpperLimit = mSliderAxisWorld.dot(v1) + mR1PlusUCrossSliderAxis.dot(w1)
-                                        - mSliderAxisWorld.dot(v2) - mR2CrossSliderAxis.dot(w2);
-
-            // Compute the Lagrange multiplier lambda for the upper limit constraint
-            decimal deltaLambdaUpper = mInverseMassMatrixLimit * (-JvUpperLimit -mBUpperLimit);
-            decimal lambdaTemp = mImpulseUpperLimit;
-            mImpulseUpperLimit = std::max(mImpulseUpperLimit + deltaLambdaUpper, decimal(0.0));
-            deltaLambdaUpper = mImpulseUpperLimit - lambdaTemp;
-
-            // Compute the impulse P=J^T * lambda for the upper limit constraint of body 1
-            const Vector3 linearImpulseBody1 = deltaLambdaUpper * mSliderAxisWorld;
-            const Vector3 angularImpulseBody1 = deltaLambdaUpper * mR1PlusUCrossSliderAxis;
-
-            // Apply the impulse to the body 1
-            v1 += inverseMassBody1 * linearImpulseBody1;
-            w1 += mI1 * angularImpulseBody1;
-
-            // Compute the impulse P=J^T * lambda for the upper limit constraint of body 2
-            const Vector3 linearImpulseBody2 = -deltaLambdaUpper * mSliderAxisWorld;
-            const Vector3 angularImpulseBody2 = -deltaLambdaUpper * mR2CrossSliderAxis;
-
-            // Apply the impulse to the body 2
-            v2 += inverseMassBody2 * linearImpulseBody2;
-            w2 += mI2 * angularImpulseBody2;
-        }
-    }
-
-    // --------------- Motor --------------- //
-
-    if (mIsMotorEnabled) {
-
-        // Compute J*v for the motor
-        const decimal JvMotor = mSliderAxisWorld.dot(v1) - mSliderAxisWorld.dot(v2);
-
-        // Compute the Lagrange multiplier lambda for the motor
-        const decimal maxMotorImpulse = mMaxMotorForce * constraintSolverData.timeStep;
-        decimal deltaLambdaMotor = mInverseMassMatrixMotor * (-JvMotor - mMotorSpeed);
-        decimal lambdaTemp = mImpulseMotor;
-        mImpulseMotor = clamp(mImpulseMotor + deltaLambdaMotor, -maxMotorImpulse, maxMotorImpulse);
-        deltaLambdaMotor = mImpulseMotor - lambdaTemp;
-
-        // Compute the impulse P=J^T * lambda for the motor of body 1
-        const Vector3 linearImpulseBody1 = deltaLambdaMotor * mSliderAxisWorld;
-
-        // Apply the impulse to the body 1
-        v1 += inverseMassBody1 * linearImpulseBody1;
-
-        // Compute the impulse P=J^T * lambda for the motor of body 2
-        const Vector3 linearImpulseBody2 = -deltaLambdaMotor * mSliderAxisWorld;
-
-        // Apply the impulse to the body 2
-        v2 += inverseMassBody2 * linearImpulseBody2;
-    }
 }
 
 // Solve the position constraint (for position error correction)
 void SliderJoint::solvePositionConstraint(const ConstraintSolverData& constraintSolverData) {
 
-    // If the error position correction technique is not the non-linear-gauss-seidel, we do
-    // do not execute this method
-    if (mPositionCorrectionTechnique != JointsPositionCorrectionTechnique::NON_LINEAR_GAUSS_SEIDEL) return;
+    // If the error position correction technique is not the non-linear-gauss-seidel or if the
+    // equality constraints are soft, we do not execute this method
+    if (mPositionCorrectionTechnique != JointsPositionCorrectionTechnique::NON_LINEAR_GAUSS_SEIDEL || isSoft()) return;
+
+    mPositionError = decimal(0.0);
 
     // Get the bodies positions and orientations
     Vector3& x1 = constraintSolverData.positions[mIndexBody1];
@@ -504,6 +475,7 @@ void SliderJoint::solvePositionConstraint(const ConstraintSolverData& constraint
 
     // Compute the position error for the 2 translation constraints
     const Vector2 translationError(u.dot(mN1), u.dot(mN2));
+    updatePositionError(translationError.length());
 
     // Compute the Lagrange multiplier lambda for the 2 translation constraints
     Vector2 lambdaTranslation = mInverseMassMatrixTranslationConstraint * (-translationError);
@@ -572,6 +544,7 @@ void SliderJoint::solvePositionConstraint(const ConstraintSolverData& constraint
 	// 
 	// If we assume theta is small (error is small) then sin(x) = x so an approximation of the error angles is:
     const Vector3 errorRotation = decimal(2.0) * qError.getVectorV();
+    updatePositionError(errorRotation.length());
 
     // Compute the Lagrange multiplier lambda for the 3 rotation constraints
     Vector3 lambdaRotation = mInverseMassMatrixRotationConstraint * (-errorRotation);
@@ -613,6 +586,8 @@ void SliderJoint::solvePositionConstraint(const ConstraintSolverData& constraint
         // If the lower limit is violated
         if (mIsLowerLimitViolated) {
 
+            updatePositionError(lowerLimitError);
+
             // Compute the Lagrange multiplier lambda for the lower limit constraint
             decimal lambdaLowerLimit = mInverseMassMatrixLimit * (-lowerLimitError);
 
@@ -646,6 +621,8 @@ void SliderJoint::solvePositionConstraint(const ConstraintSolverData& constraint
         // If the upper limit is violated
         if (mIsUpperLimitViolated) {
 
+            updatePositionError(upperLimitError);
+
             // Compute the Lagrange multiplier lambda for the upper limit constraint
             decimal lambdaUpperLimit = mInverseMassMatrixLimit * (-upperLimitError);
 
@@ -676,6 +653,8 @@ void SliderJoint::solvePositionConstraint(const ConstraintSolverData& constraint
             q2.normalize();
         }
     }
+
+    invalidateCorrectedSolverData(constraintSolverData);
 }
 
 // Enable/Disable the limits of the joint
@@ -816,3 +795,119 @@ void SliderJoint::setMaxMotorForce(decimal maxMotorForce) {
         mBody2->setIsSleeping(false);
     }
 }
+
+// Return the largest number of limit and motor rows of the joint during the current step
+uint SliderJoint::getNbMaxLimitMotorRows() const {
+    return (mIsLimitEnabled ? 2 : 0) + (mIsMotorEnabled ? 1 : 0);
+}
+
+// Compute the rows of the active limits and motor of the joint
+/// The lower and upper limits have one row each when they are violated and the motor has a
+/// row when it is enabled. The rows act on the relative velocity along the slider axis.
+/**
+ * @param rows Array where the rows are written
+ * @param constraintSolverData Data of the constraint solver
+ * @return Number of rows of the joint
+ */
+uint SliderJoint::computeLimitMotorRows(JointLimitMotorRow* rows, const ConstraintSolverData& constraintSolverData) {
+
+    uint nbRows = 0;
+
+    if (mIsLimitEnabled) {
+
+        // Lower limit constraint
+        if (mIsLowerLimitViolated) {
+            setLimitMotorRow(rows[nbRows], -mSliderAxisWorld, -mR1PlusUCrossSliderAxis, mSliderAxisWorld,
+                             mR2CrossSliderAxis, mInverseMassMatrixLimit, mBLowerLimit, decimal(0.0),
+                             DECIMAL_LARGEST, &mImpulseLowerLimit);
+            nbRows++;
+        }
+
+        // Upper limit constraint
+        if (mIsUpperLimitViolated) {
+            setLimitMotorRow(rows[nbRows], mSliderAxisWorld, mR1PlusUCrossSliderAxis, -mSliderAxisWorld,
+                             -mR2CrossSliderAxis, mInverseMassMatrixLimit, mBUpperLimit, decimal(0.0),
+                             DECIMAL_LARGEST, &mImpulseUpperLimit);
+            nbRows++;
+        }
+    }
+
+    // Motor
+    if (mIsMotorEnabled) {
+        const decimal maxMotorImpulse = mMaxMotorForce * constraintSolverData.timeStep;
+        setLimitMotorRow(rows[nbRows], mSliderAxisWorld, Vector3::zero(), -mSliderAxisWorld, Vector3::zero(),
+                         mInverseMassMatrixMotor, mMotorSpeed, -maxMotorImpulse, maxMotorImpulse, &mImpulseMotor);
+        nbRows++;
+    }
+
+    return nbRows;
+}
+
+// Compute the magnitudes of the linear and angular impulses of the joint
+/// The impulses of the limits and of the motor act along the slider axis which is
+/// orthogonal to the directions of the two translation constraints.
+/**
+ * @param[out] linearImpulse Magnitude of the impulse of the translation, limits and motor constraints
+ * @param[out] angularImpulse Magnitude of the impulse of the rotation constraints
+ */
+void SliderJoint::computeReactionImpulses(decimal& linearImpulse, decimal& angularImpulse) const {
+
+    // Impulse applied to body 2 along the slider axis
+    const decimal axialImpulse = mImpulseLowerLimit - mImpulseUpperLimit - mImpulseMotor;
+
+    linearImpulse = std::sqrt(mImpulseTranslation.lengthSquare() + axialImpulse * axialImpulse);
+    angularImpulse = mImpulseRotation.length();
+}
+
+// Construct a copy of the joint between two other bodies in a given memory location
+Joint* SliderJoint::clone(jointindex id, RigidBody* body1, RigidBody* body2, void* allocatedMemory) const {
+    return new (allocatedMemory) SliderJoint(id, *this, body1, body2);
+}
+
+// Write the accumulated impulses of the joint
+void SliderJoint::saveImpulses(WorldStateWriter& writer) const {
+    writer.write(mImpulseTranslation);
+    writer.write(mImpulseRotation);
+    writer.write(mImpulseLowerLimit);
+    writer.write(mImpulseUpperLimit);
+    writer.write(mImpulseMotor);
+}
+
+// Read the accumulated impulses of the joint written by saveImpulses()
+void SliderJoint::restoreImpulses(WorldStateReader& reader) {
+    reader.read(mImpulseTranslation);
+    reader.read(mImpulseRotation);
+    reader.read(mImpulseLowerLimit);
+    reader.read(mImpulseUpperLimit);
+    reader.read(mImpulseMotor);
+}
+
+// Write the settings of the joint
+void SliderJoint::saveJointSettings(WorldStateWriter& writer) const {
+    writer.write(mLocalAnchorPointBody1);
+    writer.write(mLocalAnchorPointBody2);
+    writer.write(mSliderAxisBody1);
+    writer.write(mInitOrientationDifferenceInv);
+    writer.write(mIsLimitEnabled);
+    writer.write(mIsMotorEnabled);
+    writer.write(mSliderAxisWorld);
+    writer.write(mLowerLimit);
+    writer.write(mUpperLimit);
+    writer.write(mMotorSpeed);
+    writer.write(mMaxMotorForce);
+}
+
+// Read the settings of the joint written by saveJointSettings()
+void SliderJoint::restoreJointSettings(WorldStateReader& reader) {
+    reader.read(mLocalAnchorPointBody1);
+    reader.read(mLocalAnchorPointBody2);
+    reader.read(mSliderAxisBody1);
+    reader.read(mInitOrientationDifferenceInv);
+    reader.read(mIsLimitEnabled);
+    reader.read(mIsMotorEnabled);
+    reader.read(mSliderAxisWorld);
+    reader.read(mLowerLimit);
+    reader.read(mUpperLimit);
+    reader.read(mMotorSpeed);
+    reader.read(mMaxMotorForce);
+}
@@ -284,12 +284,40 @@ class SliderJoint : public Joint {
         /// Solve the position constraint (for position error correction)
         virtual void solvePositionConstraint(const ConstraintSolverData& constraintSolverData) override;
 
+        /// Compute the magnitudes of the linear and angular impulses of the joint
+        virtual void computeReactionImpulses(decimal& linearImpulse, decimal& angularImpulse) const override;
+
+        /// Construct a copy of the joint between two other bodies in a given memory location
+        virtual Joint* clone(jointindex id, RigidBody* body1, RigidBody* body2, void* allocatedMemory) const override;
+
+        /// Write the accumulated impulses of the joint
+        virtual void saveImpulses(WorldStateWriter& writer) const override;
+
+        /// Read the accumulated impulses of the joint written by saveImpulses()
+        virtual void restoreImpulses(WorldStateReader& reader) override;
+
+        /// Write the settings of the joint
+        virtual void saveJointSettings(WorldStateWriter& writer) const override;
+
+        /// Read the settings of the joint written by saveJointSettings()
+        virtual void restoreJointSettings(WorldStateReader& reader) override;
+
+        /// Return the largest number of limit and motor rows of the joint during the current step
+        virtual uint getNbMaxLimitMotorRows() const override;
+
+        /// Compute the rows of the active limits and motor of the joint
+        virtual uint computeLimitMotorRows(JointLimitMotorRow* rows,
+                                           const ConstraintSolverData& constraintSolverData) override;
+
     public :
 
         // -------------------- Methods -------------------- //
 
         /// Constructor
-        SliderJoint(uint id, const SliderJointInfo& jointInfo);
+        SliderJoint(jointindex id, const SliderJointInfo& jointInfo);
+
+        /// Constructor of a copy of a joint between two other bodies
+        SliderJoint(jointindex id, const SliderJoint& joint, RigidBody* body1, RigidBody* body2);
 
         /// Destructor
         virtual ~SliderJoint() override = default;
@@ -344,6 +372,11 @@ class SliderJoint : public Joint {
 
         /// Return a string representation
         virtual std::string to_string() const override;
+
+        // -------------------- Friendship -------------------- //
+
+        friend class ConstraintSolver;
+        friend class PositionBasedSolver;
 };
 
 // Return true if the limits or the joint are enabled
@@ -0,0 +1,101 @@
+/********************************************************************************
+* ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
+* Copyright (c) 2010-2018 Daniel Chappuis                                       *
+*********************************************************************************
+*                                                                               *
+* This software is provided 'as-is', without any express or implied warranty.   *
+* In no event will the authors be held liable for any damages arising from the  *
+* use of this software.                                                         *
+*                                                                               *
+* Permission is granted to anyone to use this software for any purpose,         *
+* including commercial applications, and to alter it and redistribute it        *
+* freely, subject to the following restrictions:                                *
+*                                                                               *
+* 1. The origin of this software must not be misrepresented; you must not claim *
+*    that you wrote the original software. If you use this software in a        *
+*    product, an acknowledgment in the product documentation would be           *
+*    appreciated but is not required.                                           *
+*                                                                               *
+* 2. Altered source versions must be plainly marked as such, and must not be    *
+*    misrepresented as being the original software.                             *
+*                                                                               *
+* 3. This notice may not be removed or altered from any source distribution.    *
+*                                                                               *
+********************************************************************************/
+
+#ifndef REACTPHYSICS3D_SOFT_CONSTRAINT_H
+#define REACTPHYSICS3D_SOFT_CONSTRAINT_H
+
+// Libraries
+#include "configuration.h"
+
+// ReactPhysics3D namespace
+namespace reactphysics3d {
+
+// Structure SoftConstraintCoefficients
+/**
+ * This structure contains the coefficients used to solve a constraint as an implicit
+ * spring and damper defined by its frequency (in Hertz) and its damping ratio. At each
+ * iteration of the velocity solver, the change of impulse of the constraint is
+ *
+ *     deltaLambda = -massScale * K^-1 * (Jv + biasRate * C) - impulseScale * lambda
+ *
+ * where K is the mass matrix of the constraint, C its position error and lambda its
+ * accumulated impulse. The coefficients are computed in closed form from the implicit
+ * Euler integration of the spring so that the constraint is stable for any stiffness
+ * and time step. The default coefficients (biasRate = 0, massScale = 1, impulseScale = 0)
+ * give a rigid constraint. See "Solver2D" by Erin Catto (2024) for more details.
+ */
+struct SoftConstraintCoefficients {
+
+    // -------------------- Attributes -------------------- //
+
+    /// Factor of the position error in the velocity bias of the constraint (in 1/s)
+    decimal biasRate;
+
+    /// Factor of the rigid change of impulse
+    decimal massScale;
+
+    /// Factor of the accumulated impulse removed at each iteration
+    decimal impulseScale;
+
+    // -------------------- Methods -------------------- //
+
+    /// Constructor of rigid coefficients
+    SoftConstraintCoefficients()
+        : biasRate(decimal(0.0)), massScale(decimal(1.0)), impulseScale(decimal(0.0)) {
+
+    }
+
+    /// Compute the coefficients of a spring of a given frequency and damping ratio
+    static SoftConstraintCoefficients compute(decimal frequency, decimal dampingRatio, decimal timeStep);
+};
+
+// Compute the coefficients of a spring of a given frequency and damping ratio
+/**
+ * @param frequency Frequency of the spring (in Hertz). The constraint is rigid if it is zero
+ * @param dampingRatio Damping ratio of the spring (one for a critical damping)
+ * @param timeStep Time step of the simulation (in seconds)
+ * @return The coefficients of the soft constraint
+ */
+inline SoftConstraintCoefficients SoftConstraintCoefficients::compute(decimal frequency, decimal dampingRatio,
+                                                                      decimal timeStep) {
+
+    SoftConstraintCoefficients coefficients;
+    if (frequency <= decimal(0.0)) return coefficients;
+
+    const decimal omega = PI_TIMES_2 * frequency;
+    const decimal a1 = decimal(2.0) * dampingRatio + timeStep * omega;
+    const decimal a2 = timeStep * omega * a1;
+    const decimal a3 = decimal(1.0) / (decimal(1.0) + a2);
+
+    coefficients.biasRate = omega / a1;
+    coefficients.massScale = a2 * a3;
+    coefficients.impulseScale = a3;
+
+    return coefficients;
+}
+
+}
+
+#endif
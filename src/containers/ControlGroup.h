@@ -0,0 +1,185 @@
+/********************************************************************************
+* ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
+* Copyright (c) 2010-2018 Daniel Chappuis                                       *
+*********************************************************************************
+*                                                                               *
+* This software is provided 'as-is', without any express or implied warranty.   *
+* In no event will the authors be held liable for any damages arising from the  *
+* use of this software.                                                         *
+*                                                                               *
+* Permission is granted to anyone to use this software for any purpose,         *
+* including commercial applications, and to alter it and redistribute it        *
+* freely, subject to the following restrictions:                                *
+*                                                                               *
+* 1. The origin of this software must not be misrepresented; you must not claim *
+*    that you wrote the original software. If you use this software in a        *
+*    product, an acknowledgment in the product documentation would be           *
+*    appreciated but is not required.                                           *
+*                                                                               *
+* 2. Altered source versions must be plainly marked as such, and must not be    *
+*    misrepresented as being the original software.                             *
+*                                                                               *
+* 3. This notice may not be removed or altered from any source distribution.    *
+*                                                                               *
+********************************************************************************/
+
+
+#ifndef REACTPHYSICS3D_CONTROL_GROUP_H
+#define REACTPHYSICS3D_CONTROL_GROUP_H
+
+// Libraries
+#include "configuration.h"
+#include <cstring>
+#include <cassert>
+
+namespace reactphysics3d {
+
+// Class ControlGroup
+/**
+ * This class contains the control bytes of a group of slots of the open addressing hash
+ * tables (FlatMap and FlatSet). The slots of a table are divided in groups of sixteen
+ * slots (a smaller table has a single group whose last control bytes are SENTINEL so that
+ * the small maps and sets do not use sixteen slots). The control byte of a slot is EMPTY, DELETED or the seven low bits of the hash code
+ * of its element when the slot is full. The sixteen control bytes of a group are loaded in
+ * two 64-bit words and compared at the same time with bitwise operations. The result of a
+ * comparison is a mask with one bit for each slot of the group.
+ */
+class ControlGroup {
+
+    private:
+
+        // -------------------- Constants -------------------- //
+
+        /// Word with the lowest bit of each byte set
+        static constexpr uint64 LOW_BITS = 0x0101010101010101;
+
+        /// Word with the highest bit of each byte set
+        static constexpr uint64 HIGH_BITS = 0x8080808080808080;
+
+        // -------------------- Attributes -------------------- //
+
+        /// Control bytes of the eight first slots
+        uint64 mLowBytes;
+
+        /// Control bytes of the eight last slots
+        uint64 mHighBytes;
+
+        // -------------------- Methods -------------------- //
+
+        /// Return a mask with one bit for each byte of a word whose highest bit is set
+        static uint packHighBits(uint64 word) {
+
+            // Move the highest bit of each byte i to the bit 56 + i
+            return static_cast<uint>((((word & HIGH_BITS) >> 7) * uint64(0x0102040810204080)) >> 56);
+        }
+
+    public:
+
+        // -------------------- Constants -------------------- //
+
+        /// Number of slots in a group
+        static constexpr int NB_SLOTS = 16;
+
+        /// Control byte of an empty slot
+        static constexpr uint8 EMPTY = 0x80;
+
+        /// Control byte of a slot whose element has been removed
+        static constexpr uint8 DELETED = 0xFE;
+
+        /// Control byte after the last slot of a table smaller than a group (never matched)
+        static constexpr uint8 SENTINEL = 0xFF;
+
+        /// Number of slots of the smallest table
+        static constexpr int MIN_NB_SLOTS = 4;
+
+        // -------------------- Methods -------------------- //
+
+        /// Constructor
+        explicit ControlGroup(const uint8* controlBytes) {
+            std::memcpy(&mLowBytes, controlBytes, sizeof(uint64));
+            std::memcpy(&mHighBytes, controlBytes + sizeof(uint64), sizeof(uint64));
+        }
+
+        /// Return the mask of the slots whose control byte is equal to a given one
+        /// (some slots can be wrongly reported after a matching slot and must be checked)
+        uint match(uint8 controlByte) const {
+
+            // A byte of (word ^ pattern) is zero when the control byte matches
+            const uint64 pattern = LOW_BITS * controlByte;
+            const uint64 low = mLowBytes ^ pattern;
+            const uint64 high = mHighBytes ^ pattern;
+
+            return packHighBits((low - LOW_BITS) & ~low) | (packHighBits((high - LOW_BITS) & ~high) << 8);
+        }
+
+        /// Return the mask of the empty slots
+        uint matchEmpty() const {
+
+            // Only EMPTY has its highest bit set and its second lowest bit not set
+            return packHighBits(mLowBytes & (~mLowBytes << 6)) | (packHighBits(mHighBytes & (~mHighBytes << 6)) << 8);
+        }
+
+        /// Return the mask of the empty or deleted slots
+        uint matchEmptyOrDeleted() const {
+
+            // Only EMPTY and DELETED have their highest bit set and their lowest bit not set
+            return packHighBits(mLowBytes & (~mLowBytes << 7)) | (packHighBits(mHighBytes & (~mHighBytes << 7)) << 8);
+        }
+
+        /// Return the hash code of a key mixed so that its high bits depend on all the bits of the key
+        static uint64 mixHashCode(size_t hashCode) {
+
+            // Fibonacci hashing (the high bits of the product are the most mixed)
+            return static_cast<uint64>(hashCode) * uint64(0x9E3779B97F4A7C15);
+        }
+
+        /// Return the control byte of a full slot for a mixed hash code (its seven highest bits)
+        static uint8 computeControlByte(uint64 mixedHashCode) {
+            return static_cast<uint8>(mixedHashCode >> 57);
+        }
+
+        /// Return the number of control bytes of a table with a given number of slots
+        static int getNbControlBytes(int nbSlots) {
+            return nbSlots < NB_SLOTS ? NB_SLOTS : nbSlots;
+        }
+
+        /// Return the number of groups of a table with a given number of slots
+        static uint getNbGroups(int nbSlots) {
+            return nbSlots < NB_SLOTS ? 1 : static_cast<uint>(nbSlots) / NB_SLOTS;
+        }
+
+        /// Return the maximum number of elements of a table with a given number of slots
+        /// (a table always keeps an empty slot so that a probe sequence ends)
+        static int getMaxNbElements(int nbSlots) {
+            return nbSlots < NB_SLOTS ? nbSlots - 1 : nbSlots - nbSlots / 8;
+        }
+
+        /// Initialize the control bytes of a table with empty slots
+        static void initialize(uint8* controlBytes, int nbSlots) {
+            assert(nbSlots > 0);
+            const size_t nbBytes = static_cast<size_t>(static_cast<uint>(nbSlots));
+            std::memset(controlBytes, EMPTY, nbBytes * sizeof(uint8));
+            if (nbBytes < static_cast<size_t>(NB_SLOTS)) {
+                std::memset(controlBytes + nbBytes, SENTINEL, (static_cast<size_t>(NB_SLOTS) - nbBytes) * sizeof(uint8));
+            }
+        }
+
+        /// Return the index of the first group to probe for a mixed hash code
+        static uint computeFirstGroup(uint64 mixedHashCode, uint nbGroups) {
+            return static_cast<uint>(mixedHashCode >> 32) & (nbGroups - 1);
+        }
+
+        /// Return the index of the lowest bit set of a non-zero mask
+        static int getLowestBitIndex(uint mask) {
+
+            static const int DE_BRUIJN_INDICES[32] = {0, 1, 28, 2, 29, 14, 24, 3, 30, 22, 20, 15, 25, 17, 4, 8,
+                                                      31, 27, 13, 23, 21, 19, 16, 7, 26, 12, 18, 6, 11, 5, 10, 9};
+
+            assert(mask != 0);
+            return DE_BRUIJN_INDICES[((mask & (0u - mask)) * 0x077CB531u) >> 27];
+        }
+};
+
+}
+
+#endif
@@ -0,0 +1,563 @@
+/********************************************************************************
+* ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
+* Copyright (c) 2010-2018 Daniel Chappuis                                       *
+*********************************************************************************
+*                                                                               *
+* This software is provided 'as-is', without any express or implied warranty.   *
+* In no event will the authors be held liable for any damages arising from the  *
+* use of this software.                                                         *
+*                                                                               *
+* Permission is granted to anyone to use this software for any purpose,         *
+* including commercial applications, and to alter it and redistribute it        *
+* freely, subject to the following restrictions:                                *
+*                                                                               *
+* 1. The origin of this software must not be misrepresented; you must not claim *
+*    that you wrote the original software. If you use this software in a        *
+*    product, an acknowledgment in the product documentation would be           *
+*    appreciated but is not required.                                           *
+*                                                                               *
+* 2. Altered source versions must be plainly marked as such, and must not be    *
+*    misrepresented as being the original software.                             *
+*                                                                               *
+* 3. This notice may not be removed or altered from any source distribution.    *
+*                                                                               *
+********************************************************************************/
+
+
+#ifndef REACTPHYSICS3D_FLAT_MAP_H
+#define REACTPHYSICS3D_FLAT_MAP_H
+
+// Libraries
+#include "memory/MemoryAllocator.h"
+#include "containers/ControlGroup.h"
+#include "containers/Pair.h"
+#include <cstring>
+#include <functional>
+#include <iterator>
+#include <new>
+#include <stdexcept>
+
+namespace reactphysics3d {
+
+// Class FlatMap
+/**
+ * This class represents a generic associative map implemented with an open addressing hash
+ * table. The key/value pairs are stored directly in the slots of the table (without any
+ * allocation per pair) and a control byte for each slot tells if the slot is empty, deleted
+ * or full (with seven bits of the hash code of its key). The control bytes of a group of sixteen
+ * slots are compared at the same time (see ControlGroup) and the groups are probed with a
+ * quadratic sequence. The number of slots is a power of two and at most 7/8 of the slots
+ * are used. A pair is removed by marking its slot as deleted so that the other pairs
+ * do not move and an iterator to the following pair stays valid.
+ */
+template<typename K, typename V>
+class FlatMap {
+
+    private:
+
+        // -------------------- Attributes -------------------- //
+
+        /// Number of pairs in the map
+        int mNbPairs;
+
+        /// Number of pairs that can be added before the table must be rehashed
+        int mNbGrowthLeft;
+
+        /// Number of slots of the table (zero or a power of two)
+        int mCapacity;
+
+        /// Control byte of each slot
+        uint8* mControlBytes;
+
+        /// Key/value pair of each slot (constructed only in the full slots)
+        Pair<K, V>* mPairs;
+
+        /// Memory allocator
+        MemoryAllocator& mAllocator;
+
+        // -------------------- Methods -------------------- //
+
+        /// Return the number of slots needed to store a given number of pairs
+        static int computeCapacity(int nbPairs) {
+
+            int capacity = ControlGroup::MIN_NB_SLOTS;
+            while (ControlGroup::getMaxNbElements(capacity) < nbPairs) {
+                capacity *= 2;
+            }
+
+            return capacity;
+        }
+
+        /// Return the mixed hash code of a key
+        static uint64 computeHashCode(const K& key) {
+            return ControlGroup::mixHashCode(std::hash<K>()(key));
+        }
+
+        /// Return true if a control byte is the one of a full slot
+        static bool isFull(uint8 controlByte) {
+            return (controlByte & 0x80) == 0;
+        }
+
+        /// Return the index of the slot with a given key or -1 if the key is not in the map
+        int findSlot(const K& key, uint64 hashCode) const {
+
+            if (mCapacity == 0) return -1;
+
+            const uint8 controlByte = ControlGroup::computeControlByte(hashCode);
+            const uint nbGroups = ControlGroup::getNbGroups(mCapacity);
+            uint group = ControlGroup::computeFirstGroup(hashCode, nbGroups);
+
+            for (uint i=1; ; i++) {
+
+                const ControlGroup controlGroup(mControlBytes + group * ControlGroup::NB_SLOTS);
+
+                // Compare the keys of the slots with the same control byte
+                for (uint mask = controlGroup.match(controlByte); mask != 0; mask &= mask - 1) {
+                    const int slot = group * ControlGroup::NB_SLOTS + ControlGroup::getLowestBitIndex(mask);
+                    if (mControlBytes[slot] == controlByte && mPairs[slot].first == key) {
+                        return slot;
+                    }
+                }
+
+                // A pair is never stored after a group with an empty slot
+                if (controlGroup.matchEmpty() != 0) return -1;
+
+                group = (group + i) & (nbGroups - 1);
+            }
+        }
+
+        /// Return the first empty or deleted slot of the probe sequence of a hash code
+        int findFreeSlot(uint64 hashCode) const {
+
+            const uint nbGroups = ControlGroup::getNbGroups(mCapacity);
+            uint group = ControlGroup::computeFirstGroup(hashCode, nbGroups);
+
+            for (uint i=1; ; i++) {
+
+                const uint mask = ControlGroup(mControlBytes + group * ControlGroup::NB_SLOTS).matchEmptyOrDeleted();
+                if (mask != 0) {
+                    return group * ControlGroup::NB_SLOTS + ControlGroup::getLowestBitIndex(mask);
+                }
+
+                group = (group + i) & (nbGroups - 1);
+            }
+        }
+
+        /// Allocate a table with a given number of slots and insert the pairs into it again
+        void rehash(int newCapacity) {
+
+            assert(newCapacity >= ControlGroup::MIN_NB_SLOTS && ControlGroup::getMaxNbElements(newCapacity) >= mNbPairs);
+
+            uint8* oldControlBytes = mControlBytes;
+            Pair<K, V>* oldPairs = mPairs;
+            const int oldCapacity = mCapacity;
+
+            mControlBytes = static_cast<uint8*>(mAllocator.allocate(ControlGroup::getNbControlBytes(newCapacity) * sizeof(uint8)));
+            mPairs = static_cast<Pair<K, V>*>(mAllocator.allocate(newCapacity * sizeof(Pair<K, V>)));
+            ControlGroup::initialize(mControlBytes, newCapacity);
+            mCapacity = newCapacity;
+            mNbGrowthLeft = ControlGroup::getMaxNbElements(newCapacity) - mNbPairs;
+
+            if (oldCapacity > 0) {
+
+                // Move the pairs into the new table
+                for (int i=0; i < oldCapacity; i++) {
+                    if (isFull(oldControlBytes[i])) {
+                        const uint64 hashCode = computeHashCode(oldPairs[i].first);
+                        const int slot = findFreeSlot(hashCode);
+                        mControlBytes[slot] = ControlGroup::computeControlByte(hashCode);
+                        new (static_cast<void*>(&mPairs[slot])) Pair<K, V>(oldPairs[i]);
+                        oldPairs[i].~Pair<K, V>();
+                    }
+                }
+
+                mAllocator.release(oldControlBytes, ControlGroup::getNbControlBytes(oldCapacity) * sizeof(uint8));
+                mAllocator.release(oldPairs, oldCapacity * sizeof(Pair<K, V>));
+            }
+        }
+
+        /// Copy the table of another map with the same number of slots
+        void copyTable(const FlatMap<K, V>& map) {
+
+            assert(mCapacity == 0 && map.mCapacity > 0);
+
+            mCapacity = map.mCapacity;
+            mNbPairs = map.mNbPairs;
+            mNbGrowthLeft = map.mNbGrowthLeft;
+            mControlBytes = static_cast<uint8*>(mAllocator.allocate(ControlGroup::getNbControlBytes(mCapacity) * sizeof(uint8)));
+            mPairs = static_cast<Pair<K, V>*>(mAllocator.allocate(mCapacity * sizeof(Pair<K, V>)));
+            std::memcpy(mControlBytes, map.mControlBytes, ControlGroup::getNbControlBytes(mCapacity) * sizeof(uint8));
+
+            for (int i=0; i < mCapacity; i++) {
+                if (isFull(mControlBytes[i])) {
+                    new (static_cast<void*>(&mPairs[i])) Pair<K, V>(map.mPairs[i]);
+                }
+            }
+        }
+
+        /// Remove the pair of a full slot
+        void removeSlot(int slot) {
+
+            assert(isFull(mControlBytes[slot]));
+
+            mPairs[slot].~Pair<K, V>();
+            mNbPairs--;
+
+            // If the group of the slot already has an empty slot, no probe sequence goes past it
+            // and the slot can be empty. Otherwise, it is marked as deleted.
+            const int group = slot / ControlGroup::NB_SLOTS;
+            if (ControlGroup(mControlBytes + group * ControlGroup::NB_SLOTS).matchEmpty() != 0) {
+                mControlBytes[slot] = ControlGroup::EMPTY;
+                mNbGrowthLeft++;
+            }
+            else {
+                mControlBytes[slot] = ControlGroup::DELETED;
+            }
+        }
+
+        /// Return the index of the first full slot from a given slot (or the capacity)
+        int findNextFullSlot(int slot) const {
+
+            while (slot < mCapacity && !isFull(mControlBytes[slot])) {
+                slot++;
+            }
+
+            return slot;
+        }
+
+        /// Clear and release the table
+        void reset() {
+
+            if (mCapacity > 0) {
+
+                clear();
+
+                mAllocator.release(mControlBytes, ControlGroup::getNbControlBytes(mCapacity) * sizeof(uint8));
+                mAllocator.release(mPairs, mCapacity * sizeof(Pair<K, V>));
+
+                mCapacity = 0;
+                mNbGrowthLeft = 0;
+                mControlBytes = nullptr;
+                mPairs = nullptr;
+            }
+        }
+
+    public:
+
+        /// Class Iterator
+        /**
+         * This class represents an iterator for the FlatMap
+         */
+        class Iterator {
+
+            private:
+
+                /// Control bytes of the slots
+                const uint8* mControlBytes;
+
+                /// Key/value pairs of the slots
+                Pair<K, V>* mPairs;
+
+                /// Number of slots of the map
+                int mCapacity;
+
+                /// Index of the current slot
+                int mCurrentSlot;
+
+                /// Advance the iterator
+                void advance() {
+
+                    // If we are trying to move past the end
+                    assert(mCurrentSlot < mCapacity);
+
+                    for (mCurrentSlot += 1; mCurrentSlot < mCapacity; mCurrentSlot++) {
+                        if (isFull(mControlBytes[mCurrentSlot])) return;
+                    }
+                }
+
+            public:
+
+                // Iterator traits
+                using value_type = Pair<K, V>;
+                using difference_type = std::ptrdiff_t;
+                using pointer = Pair<K, V>*;
+                using reference = Pair<K, V>&;
+                using iterator_category = std::forward_iterator_tag;
+
+                /// Constructor
+                Iterator() = default;
+
+                /// Constructor
+                Iterator(const uint8* controlBytes, Pair<K, V>* pairs, int capacity, int currentSlot)
+                     :mControlBytes(controlBytes), mPairs(pairs), mCapacity(capacity), mCurrentSlot(currentSlot) {
+
+                }
+
+                /// Deferencable
+                reference operator*() const {
+                    assert(mCurrentSlot >= 0 && mCurrentSlot < mCapacity);
+                    assert(isFull(mControlBytes[mCurrentSlot]));
+                    return mPairs[mCurrentSlot];
+                }
+
+                /// Deferencable
+                pointer operator->() const {
+                    assert(mCurrentSlot >= 0 && mCurrentSlot < mCapacity);
+                    assert(isFull(mControlBytes[mCurrentSlot]));
+                    return &mPairs[mCurrentSlot];
+                }
+
+                /// Pre increment (++it)
+                Iterator& operator++() {
+                    advance();
+                    return *this;
+                }
+
+                /// Post increment (it++)
+                Iterator operator++(int number) {
+                    Iterator tmp = *this;
+                    advance();
+                    return tmp;
+                }
+
+                /// Equality operator (it == end())
+                bool operator==(const Iterator& iterator) const {
+                    return mCurrentSlot == iterator.mCurrentSlot && mPairs == iterator.mPairs;
+                }
+
+                /// Inequality operator (it != end())
+                bool operator!=(const Iterator& iterator) const {
+                    return !(*this == iterator);
+                }
+
+                // -------------------- Friendship -------------------- //
+
+                friend class FlatMap<K, V>;
+        };
+
+        // -------------------- Methods -------------------- //
+
+        /// Constructor
+        FlatMap(MemoryAllocator& allocator, size_t capacity = 0)
+            : mNbPairs(0), mNbGrowthLeft(0), mCapacity(0), mControlBytes(nullptr), mPairs(nullptr),
+              mAllocator(allocator) {
+
+            if (capacity > 0) {
+                reserve(static_cast<int>(capacity));
+            }
+        }
+
+        /// Copy constructor
+        FlatMap(const FlatMap<K, V>& map)
+            : mNbPairs(0), mNbGrowthLeft(0), mCapacity(0), mControlBytes(nullptr), mPairs(nullptr),
+              mAllocator(map.mAllocator) {
+
+            if (map.mCapacity > 0) {
+                copyTable(map);
+            }
+        }
+
+        /// Destructor
+        ~FlatMap() {
+
+            reset();
+        }
+
+        /// Allocate memory for a given number of pairs
+        void reserve(int nbPairs) {
+
+            if (nbPairs <= mNbPairs + mNbGrowthLeft) return;
+
+            rehash(computeCapacity(nbPairs));
+        }
+
+        /// Return true if the map contains an item with the given key
+        bool containsKey(const K& key) const {
+            return findSlot(key, computeHashCode(key)) != -1;
+        }
+
+        /// Add an element into the map
+        void add(const Pair<K, V>& keyValue, bool insertIfAlreadyPresent = false) {
+
+            const uint64 hashCode = computeHashCode(keyValue.first);
+            int slot = findSlot(keyValue.first, hashCode);
+
+            // If there is already an item with the same key in the map
+            if (slot != -1) {
+
+                if (insertIfAlreadyPresent) {
+
+                    // Replace the previous key/value
+                    mPairs[slot].~Pair<K, V>();
+                    new (static_cast<void*>(&mPairs[slot])) Pair<K, V>(keyValue);
+
+                    return;
+                }
+                else {
+                    throw std::runtime_error("The key and value pair already exists in the map");
+                }
+            }
+
+            if (mCapacity > 0) {
+                slot = findFreeSlot(hashCode);
+            }
+
+            // If an empty slot must be used but the table is full
+            if (slot == -1 || (mNbGrowthLeft == 0 && mControlBytes[slot] == ControlGroup::EMPTY)) {
+
+                // Remove the deleted slots if they are numerous or allocate a larger table
+                const int newCapacity = mCapacity == 0 ? ControlGroup::MIN_NB_SLOTS :
+                                        (mNbPairs <= ControlGroup::getMaxNbElements(mCapacity) / 2 ? mCapacity : 2 * mCapacity);
+                rehash(newCapacity);
+                slot = findFreeSlot(hashCode);
+            }
+
+            if (mControlBytes[slot] == ControlGroup::EMPTY) {
+                mNbGrowthLeft--;
+            }
+            mControlBytes[slot] = ControlGroup::computeControlByte(hashCode);
+            new (static_cast<void*>(&mPairs[slot])) Pair<K, V>(keyValue);
+            mNbPairs++;
+        }
+
+        /// Remove the element pointed by some iterator
+        /// This method returns an iterator pointing to the element after
+        /// the one that has been removed
+        Iterator remove(const Iterator& it) {
+
+            assert(it.mPairs == mPairs);
+            removeSlot(it.mCurrentSlot);
+            return Iterator(mControlBytes, mPairs, mCapacity, findNextFullSlot(it.mCurrentSlot + 1));
+        }
+
+        /// Remove the element from the map with a given key
+        /// This method returns an iterator pointing to the element after
+        /// the one that has been removed
+        Iterator remove(const K& key) {
+
+            const int slot = findSlot(key, computeHashCode(key));
+            if (slot == -1) return end();
+
+            removeSlot(slot);
+            return Iterator(mControlBytes, mPairs, mCapacity, findNextFullSlot(slot + 1));
+        }
+
+        /// Remove all the elements of the map (the table is kept)
+        void clear() {
+
+            if (mCapacity > 0) {
+
+                if (mNbPairs > 0) {
+                    for (int i=0; i < mCapacity; i++) {
+                        if (isFull(mControlBytes[i])) {
+                            mPairs[i].~Pair<K, V>();
+                        }
+                    }
+                }
+
+                ControlGroup::initialize(mControlBytes, mCapacity);
+                mNbPairs = 0;
+                mNbGrowthLeft = ControlGroup::getMaxNbElements(mCapacity);
+            }
+
+            assert(size() == 0);
+        }
+
+        /// Return the number of elements in the map
+        int size() const {
+            return mNbPairs;
+        }
+
+        /// Return the number of slots of the map
+        int capacity() const {
+            return mCapacity;
+        }
+
+        /// Try to find an item of the map given a key.
+        /// The method returns an iterator to the found item or
+        /// an iterator pointing to the end if not found
+        Iterator find(const K& key) const {
+
+            const int slot = findSlot(key, computeHashCode(key));
+            if (slot == -1) return end();
+
+            return Iterator(mControlBytes, mPairs, mCapacity, slot);
+        }
+
+        /// Overloaded index operator
+        V& operator[](const K& key) {
+
+            const int slot = findSlot(key, computeHashCode(key));
+            if (slot == -1) {
+                throw std::runtime_error("No item with given key has been found in the map");
+            }
+
+            return mPairs[slot].second;
+        }
+
+        /// Overloaded index operator
+        const V& operator[](const K& key) const {
+
+            const int slot = findSlot(key, computeHashCode(key));
+            if (slot == -1) {
+                throw std::runtime_error("No item with given key has been found in the map");
+            }
+
+            return mPairs[slot].second;
+        }
+
+        /// Overloaded equality operator
+        bool operator==(const FlatMap<K, V>& map) const {
+
+            if (size() != map.size()) return false;
+
+            for (auto it = begin(); it != end(); ++it) {
+                auto it2 = map.find(it->first);
+                if (it2 == map.end() || it2->second != it->second) {
+                    return false;
+                }
+            }
+
+            return true;
+        }
+
+        /// Overloaded not equal operator
+        bool operator!=(const FlatMap<K, V>& map) const {
+
+            return !((*this) == map);
+        }
+
+        /// Overloaded assignment operator
+        FlatMap<K, V>& operator=(const FlatMap<K, V>& map) {
+
+            // Check for self assignment
+            if (this != &map) {
+
+                // Reset the map
+                reset();
+
+                if (map.mCapacity > 0) {
+                    copyTable(map);
+                }
+            }
+
+            return *this;
+        }
+
+        /// Return a begin iterator
+        Iterator begin() const {
+
+            if (mNbPairs == 0) return end();
+
+            return Iterator(mControlBytes, mPairs, mCapacity, findNextFullSlot(0));
+        }
+
+        /// Return a end iterator
+        Iterator end() const {
+            return Iterator(mControlBytes, mPairs, mCapacity, mCapacity);
+        }
+};
+
+}
+
+#endif
@@ -0,0 +1,521 @@
+/********************************************************************************
+* ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
+* Copyright (c) 2010-2018 Daniel Chappuis                                       *
+*********************************************************************************
+*                                                                               *
+* This software is provided 'as-is', without any express or implied warranty.   *
+* In no event will the authors be held liable for any damages arising from the  *
+* use of this software.                                                         *
+*                                                                               *
+* Permission is granted to anyone to use this software for any purpose,         *
+* including commercial applications, and to alter it and redistribute it        *
+* freely, subject to the following restrictions:                                *
+*                                                                               *
+* 1. The origin of this software must not be misrepresented; you must not claim *
+*    that you wrote the original software. If you use this software in a        *
+*    product, an acknowledgment in the product documentation would be           *
+*    appreciated but is not required.                                           *
+*                                                                               *
+* 2. Altered source versions must be plainly marked as such, and must not be    *
+*    misrepresented as being the original software.                             *
+*                                                                               *
+* 3. This notice may not be removed or altered from any source distribution.    *
+*                                                                               *
+********************************************************************************/
+
+
+#ifndef REACTPHYSICS3D_FLAT_SET_H
+#define REACTPHYSICS3D_FLAT_SET_H
+
+// Libraries
+#include "memory/MemoryAllocator.h"
+#include "containers/ControlGroup.h"
+#include <cstring>
+#include <functional>
+#include <iterator>
+#include <new>
+
+namespace reactphysics3d {
+
+// Class FlatSet
+/**
+ * This class represents a generic set implemented with an open addressing hash table.
+ * The values are stored directly in the slots of the table (without any allocation per
+ * value) and a control byte for each slot tells if the slot is empty, deleted or full
+ * (with seven bits of the hash code of its value). The control bytes of a group of sixteen
+ * slots are compared at the same time (see ControlGroup) and the groups are probed with a
+ * quadratic sequence. The number of slots is a power of two and at most 7/8 of the slots
+ * are used. A value is removed by marking its slot as deleted so that the other values
+ * do not move and an iterator to the following value stays valid.
+ */
+template<typename V>
+class FlatSet {
+
+    private:
+
+        // -------------------- Attributes -------------------- //
+
+        /// Number of values in the set
+        int mNbValues;
+
+        /// Number of values that can be added before the table must be rehashed
+        int mNbGrowthLeft;
+
+        /// Number of slots of the table (zero or a power of two)
+        int mCapacity;
+
+        /// Control byte of each slot
+        uint8* mControlBytes;
+
+        /// Value of each slot (constructed only in the full slots)
+        V* mValues;
+
+        /// Memory allocator
+        MemoryAllocator& mAllocator;
+
+        // -------------------- Methods -------------------- //
+
+        /// Return the number of slots needed to store a given number of values
+        static int computeCapacity(int nbValues) {
+
+            int capacity = ControlGroup::MIN_NB_SLOTS;
+            while (ControlGroup::getMaxNbElements(capacity) < nbValues) {
+                capacity *= 2;
+            }
+
+            return capacity;
+        }
+
+        /// Return the mixed hash code of a value
+        static uint64 computeHashCode(const V& value) {
+            return ControlGroup::mixHashCode(std::hash<V>()(value));
+        }
+
+        /// Return true if a control byte is the one of a full slot
+        static bool isFull(uint8 controlByte) {
+            return (controlByte & 0x80) == 0;
+        }
+
+        /// Return the index of the slot with a given value or -1 if the value is not in the set
+        int findSlot(const V& value, uint64 hashCode) const {
+
+            if (mCapacity == 0) return -1;
+
+            const uint8 controlByte = ControlGroup::computeControlByte(hashCode);
+            const uint nbGroups = ControlGroup::getNbGroups(mCapacity);
+            uint group = ControlGroup::computeFirstGroup(hashCode, nbGroups);
+
+            for (uint i=1; ; i++) {
+
+                const ControlGroup controlGroup(mControlBytes + group * ControlGroup::NB_SLOTS);
+
+                // Compare the values of the slots with the same control byte
+                for (uint mask = controlGroup.match(controlByte); mask != 0; mask &= mask - 1) {
+                    const int slot = group * ControlGroup::NB_SLOTS + ControlGroup::getLowestBitIndex(mask);
+                    if (mControlBytes[slot] == controlByte && mValues[slot] == value) {
+                        return slot;
+                    }
+                }
+
+                // A value is never stored after a group with an empty slot
+                if (controlGroup.matchEmpty() != 0) return -1;
+
+                group = (group + i) & (nbGroups - 1);
+            }
+        }
+
+        /// Return the first empty or deleted slot of the probe sequence of a hash code
+        int findFreeSlot(uint64 hashCode) const {
+
+            const uint nbGroups = ControlGroup::getNbGroups(mCapacity);
+            uint group = ControlGroup::computeFirstGroup(hashCode, nbGroups);
+
+            for (uint i=1; ; i++) {
+
+                const uint mask = ControlGroup(mControlBytes + group * ControlGroup::NB_SLOTS).matchEmptyOrDeleted();
+                if (mask != 0) {
+                    return group * ControlGroup::NB_SLOTS + ControlGroup::getLowestBitIndex(mask);
+                }
+
+                group = (group + i) & (nbGroups - 1);
+            }
+        }
+
+        /// Allocate a table with a given number of slots and insert the values into it again
+        void rehash(int newCapacity) {
+
+            assert(newCapacity >= ControlGroup::MIN_NB_SLOTS && ControlGroup::getMaxNbElements(newCapacity) >= mNbValues);
+
+            uint8* oldControlBytes = mControlBytes;
+            V* oldValues = mValues;
+            const int oldCapacity = mCapacity;
+
+            mControlBytes = static_cast<uint8*>(mAllocator.allocate(ControlGroup::getNbControlBytes(newCapacity) * sizeof(uint8)));
+            mValues = static_cast<V*>(mAllocator.allocate(newCapacity * sizeof(V)));
+            ControlGroup::initialize(mControlBytes, newCapacity);
+            mCapacity = newCapacity;
+            mNbGrowthLeft = ControlGroup::getMaxNbElements(newCapacity) - mNbValues;
+
+            if (oldCapacity > 0) {
+
+                // Move the values into the new table
+                for (int i=0; i < oldCapacity; i++) {
+                    if (isFull(oldControlBytes[i])) {
+                        const uint64 hashCode = computeHashCode(oldValues[i]);
+                        const int slot = findFreeSlot(hashCode);
+                        mControlBytes[slot] = ControlGroup::computeControlByte(hashCode);
+                        new (static_cast<void*>(&mValues[slot])) V(oldValues[i]);
+                        oldValues[i].~V();
+                    }
+                }
+
+                mAllocator.release(oldControlBytes, ControlGroup::getNbControlBytes(oldCapacity) * sizeof(uint8));
+                mAllocator.release(oldValues, oldCapacity * sizeof(V));
+            }
+        }
+
+        /// Copy the table of another set with the same number of slots
+        void copyTable(const FlatSet<V>& set) {
+
+            assert(mCapacity == 0 && set.mCapacity > 0);
+
+            mCapacity = set.mCapacity;
+            mNbValues = set.mNbValues;
+            mNbGrowthLeft = set.mNbGrowthLeft;
+            mControlBytes = static_cast<uint8*>(mAllocator.allocate(ControlGroup::getNbControlBytes(mCapacity) * sizeof(uint8)));
+            mValues = static_cast<V*>(mAllocator.allocate(mCapacity * sizeof(V)));
+            std::memcpy(mControlBytes, set.mControlBytes, ControlGroup::getNbControlBytes(mCapacity) * sizeof(uint8));
+
+            for (int i=0; i < mCapacity; i++) {
+                if (isFull(mControlBytes[i])) {
+                    new (static_cast<void*>(&mValues[i])) V(set.mValues[i]);
+                }
+            }
+        }
+
+        /// Remove the value of a full slot
+        void removeSlot(int slot) {
+
+            assert(isFull(mControlBytes[slot]));
+
+            mValues[slot].~V();
+            mNbValues--;
+
+            // If the group of the slot already has an empty slot, no probe sequence goes past it
+            // and the slot can be empty. Otherwise, it is marked as deleted.
+            const int group = slot / ControlGroup::NB_SLOTS;
+            if (ControlGroup(mControlBytes + group * ControlGroup::NB_SLOTS).matchEmpty() != 0) {
+                mControlBytes[slot] = ControlGroup::EMPTY;
+                mNbGrowthLeft++;
+            }
+            else {
+                mControlBytes[slot] = ControlGroup::DELETED;
+            }
+        }
+
+        /// Return the index of the first full slot from a given slot (or the capacity)
+        int findNextFullSlot(int slot) const {
+
+            while (slot < mCapacity && !isFull(mControlBytes[slot])) {
+                slot++;
+            }
+
+            return slot;
+        }
+
+        /// Clear and release the table
+        void reset() {
+
+            if (mCapacity > 0) {
+
+                clear();
+
+                mAllocator.release(mControlBytes, ControlGroup::getNbControlBytes(mCapacity) * sizeof(uint8));
+                mAllocator.release(mValues, mCapacity * sizeof(V));
+
+                mCapacity = 0;
+                mNbGrowthLeft = 0;
+                mControlBytes = nullptr;
+                mValues = nullptr;
+            }
+        }
+
+    public:
+
+        /// Class Iterator
+        /**
+         * This class represents an iterator for the FlatSet
+         */
+        class Iterator {
+
+            private:
+
+                /// Control bytes of the slots
+                const uint8* mControlBytes;
+
+                /// Values of the slots
+                V* mValues;
+
+                /// Number of slots of the set
+                int mCapacity;
+
+                /// Index of the current slot
+                int mCurrentSlot;
+
+                /// Advance the iterator
+                void advance() {
+
+                    // If we are trying to move past the end
+                    assert(mCurrentSlot < mCapacity);
+
+                    for (mCurrentSlot += 1; mCurrentSlot < mCapacity; mCurrentSlot++) {
+                        if (isFull(mControlBytes[mCurrentSlot])) return;
+                    }
+                }
+
+            public:
+
+                // Iterator traits
+                using value_type = V;
+                using difference_type = std::ptrdiff_t;
+                using pointer = V*;
+                using reference = V&;
+                using iterator_category = std::forward_iterator_tag;
+
+                /// Constructor
+                Iterator() = default;
+
+                /// Constructor
+                Iterator(const uint8* controlBytes, V* values, int capacity, int currentSlot)
+                     :mControlBytes(controlBytes), mValues(values), mCapacity(capacity), mCurrentSlot(currentSlot) {
+
+                }
+
+                /// Deferencable
+                reference operator*() const {
+                    assert(mCurrentSlot >= 0 && mCurrentSlot < mCapacity);
+                    assert(isFull(mControlBytes[mCurrentSlot]));
+                    return mValues[mCurrentSlot];
+                }
+
+                /// Deferencable
+                pointer operator->() const {
+                    assert(mCurrentSlot >= 0 && mCurrentSlot < mCapacity);
+                    assert(isFull(mControlBytes[mCurrentSlot]));
+                    return &mValues[mCurrentSlot];
+                }
+
+                /// Pre increment (++it)
+                Iterator& operator++() {
+                    advance();
+                    return *this;
+                }
+
+                /// Post increment (it++)
+                Iterator operator++(int number) {
+                    Iterator tmp = *this;
+                    advance();
+                    return tmp;
+                }
+
+                /// Equality operator (it == end())
+                bool operator==(const Iterator& iterator) const {
+                    return mCurrentSlot == iterator.mCurrentSlot && mValues == iterator.mValues;
+                }
+
+                /// Inequality operator (it != end())
+                bool operator!=(const Iterator& iterator) const {
+                    return !(*this == iterator);
+                }
+
+                // -------------------- Friendship -------------------- //
+
+                friend class FlatSet<V>;
+        };
+
+        // -------------------- Methods -------------------- //
+
+        /// Constructor
+        FlatSet(MemoryAllocator& allocator, size_t capacity = 0)
+            : mNbValues(0), mNbGrowthLeft(0), mCapacity(0), mControlBytes(nullptr), mValues(nullptr),
+              mAllocator(allocator) {
+
+            if (capacity > 0) {
+                reserve(static_cast<int>(capacity));
+            }
+        }
+
+        /// Copy constructor
+        FlatSet(const FlatSet<V>& set)
+            : mNbValues(0), mNbGrowthLeft(0), mCapacity(0), mControlBytes(nullptr), mValues(nullptr),
+              mAllocator(set.mAllocator) {
+
+            if (set.mCapacity > 0) {
+                copyTable(set);
+            }
+        }
+
+        /// Destructor
+        ~FlatSet() {
+
+            reset();
+        }
+
+        /// Allocate memory for a given number of values
+        void reserve(int nbValues) {
+
+            if (nbValues <= mNbValues + mNbGrowthLeft) return;
+
+            rehash(computeCapacity(nbValues));
+        }
+
+        /// Return true if the set contains a given value
+        bool contains(const V& value) const {
+            return findSlot(value, computeHashCode(value)) != -1;
+        }
+
+        /// Add a value into the set if it is not already in it
+        void add(const V& value) {
+
+            const uint64 hashCode = computeHashCode(value);
+            if (findSlot(value, hashCode) != -1) return;
+
+            int slot = -1;
+            if (mCapacity > 0) {
+                slot = findFreeSlot(hashCode);
+            }
+
+            // If an empty slot must be used but the table is full
+            if (slot == -1 || (mNbGrowthLeft == 0 && mControlBytes[slot] == ControlGroup::EMPTY)) {
+
+                // Remove the deleted slots if they are numerous or allocate a larger table
+                const int newCapacity = mCapacity == 0 ? ControlGroup::MIN_NB_SLOTS :
+                                        (mNbValues <= ControlGroup::getMaxNbElements(mCapacity) / 2 ? mCapacity : 2 * mCapacity);
+                rehash(newCapacity);
+                slot = findFreeSlot(hashCode);
+            }
+
+            if (mControlBytes[slot] == ControlGroup::EMPTY) {
+                mNbGrowthLeft--;
+            }
+            mControlBytes[slot] = ControlGroup::computeControlByte(hashCode);
+            new (static_cast<void*>(&mValues[slot])) V(value);
+            mNbValues++;
+        }
+
+        /// Remove the value pointed by some iterator
+        /// This method returns an iterator pointing to the value after
+        /// the one that has been removed
+        Iterator remove(const Iterator& it) {
+
+            assert(it.mValues == mValues);
+            removeSlot(it.mCurrentSlot);
+            return Iterator(mControlBytes, mValues, mCapacity, findNextFullSlot(it.mCurrentSlot + 1));
+        }
+
+        /// Remove a value from the set
+        /// This method returns an iterator pointing to the value after
+        /// the one that has been removed
+        Iterator remove(const V& value) {
+
+            const int slot = findSlot(value, computeHashCode(value));
+            if (slot == -1) return end();
+
+            removeSlot(slot);
+            return Iterator(mControlBytes, mValues, mCapacity, findNextFullSlot(slot + 1));
+        }
+
+        /// Remove all the values of the set (the table is kept)
+        void clear() {
+
+            if (mCapacity > 0) {
+
+                if (mNbValues > 0) {
+                    for (int i=0; i < mCapacity; i++) {
+                        if (isFull(mControlBytes[i])) {
+                            mValues[i].~V();
+                        }
+                    }
+                }
+
+                ControlGroup::initialize(mControlBytes, mCapacity);
+                mNbValues = 0;
+                mNbGrowthLeft = ControlGroup::getMaxNbElements(mCapacity);
+            }
+
+            assert(size() == 0);
+        }
+
+        /// Return the number of values in the set
+        int size() const {
+            return mNbValues;
+        }
+
+        /// Return the number of slots of the set
+        int capacity() const {
+            return mCapacity;
+        }
+
+        /// Try to find a value of the set.
+        /// The method returns an iterator to the found value or
+        /// an iterator pointing to the end if not found
+        Iterator find(const V& value) const {
+
+            const int slot = findSlot(value, computeHashCode(value));
+            if (slot == -1) return end();
+
+            return Iterator(mControlBytes, mValues, mCapacity, slot);
+        }
+
+        /// Overloaded equality operator
+        bool operator==(const FlatSet<V>& set) const {
+
+            if (size() != set.size()) return false;
+
+            for (auto it = begin(); it != end(); ++it) {
+                if (!set.contains(*it)) return false;
+            }
+
+            return true;
+        }
+
+        /// Overloaded not equal operator
+        bool operator!=(const FlatSet<V>& set) const {
+
+            return !((*this) == set);
+        }
+
+        /// Overloaded assignment operator
+        FlatSet<V>& operator=(const FlatSet<V>& set) {
+
+            // Check for self assignment
+            if (this != &set) {
+
+                // Reset the set
+                reset();
+
+                if (set.mCapacity > 0) {
+                    copyTable(set);
+                }
+            }
+
+            return *this;
+        }
+
+        /// Return a begin iterator
+        Iterator begin() const {
+
+            if (mNbValues == 0) return end();
+
+            return Iterator(mControlBytes, mValues, mCapacity, findNextFullSlot(0));
+        }
+
+        /// Return a end iterator
+        Iterator end() const {
+            return Iterator(mControlBytes, mValues, mCapacity, mCapacity);
+        }
+};
+
+}
+
+#endif
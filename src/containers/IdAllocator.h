@@ -0,0 +1,261 @@
+/********************************************************************************
+* ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
+* Copyright (c) 2010-2018 Daniel Chappuis                                       *
+*********************************************************************************
+*                                                                               *
+* This software is provided 'as-is', without any express or implied warranty.   *
+* In no event will the authors be held liable for any damages arising from the  *
+* use of this software.                                                         *
+*                                                                               *
+* Permission is granted to anyone to use this software for any purpose,         *
+* including commercial applications, and to alter it and redistribute it        *
+* freely, subject to the following restrictions:                                *
+*                                                                               *
+* 1. The origin of this software must not be misrepresented; you must not claim *
+*    that you wrote the original software. If you use this software in a        *
+*    product, an acknowledgment in the product documentation would be           *
+*    appreciated but is not required.                                           *
+*                                                                               *
+* 2. Altered source versions must be plainly marked as such, and must not be    *
+*    misrepresented as being the original software.                             *
+*                                                                               *
+* 3. This notice may not be removed or altered from any source distribution.    *
+*                                                                               *
+********************************************************************************/
+
+#ifndef REACTPHYSICS3D_ID_ALLOCATOR_H
+#define REACTPHYSICS3D_ID_ALLOCATOR_H
+
+// Libraries
+#include "configuration.h"
+#include "containers/List.h"
+#include "engine/WorldState.h"
+#include <cassert>
+
+namespace reactphysics3d {
+
+// Class IdAllocator
+/**
+ * This class allocates the identifiers of the objects of a world (bodies or joints). An
+ * identifier is made of the index of a slot (in the low 32 bits) and of the generation of
+ * this slot (in the high 32 bits). The generation of a slot is incremented each time its
+ * identifier is released so that the identifier of a destroyed object is not given again
+ * to a new object and can be detected as invalid. The free slots are linked together
+ * inside the array of slots so that an identifier is allocated and released in constant
+ * time without any other memory.
+  */
+class IdAllocator {
+
+    private:
+
+        /// A slot of the allocator
+        struct Slot {
+
+            /// Generation of the slot (incremented each time the identifier is released)
+            uint32 generation;
+
+            /// Index of the next free slot if the slot is free (SLOT_USED otherwise)
+            uint32 nextFreeSlot;
+
+            /// Constructor
+            Slot(uint32 nextFree) : generation(0), nextFreeSlot(nextFree) {}
+        };
+
+        // -------------------- Constants -------------------- //
+
+        /// Index used at the end of the list of free slots
+        static const uint32 NO_FREE_SLOT = 0xFFFFFFFF;
+
+        /// Value of the next free slot of a used slot
+        static const uint32 SLOT_USED = 0xFFFFFFFE;
+
+        // -------------------- Attributes -------------------- //
+
+        /// Array of slots
+        List<Slot> mSlots;
+
+        /// Index of the first free slot (NO_FREE_SLOT if there is no free slot)
+        uint32 mFirstFreeSlot;
+
+        /// Number of allocated identifiers
+        uint mNbIds;
+
+        /// Memory allocator of the slots
+        MemoryAllocator& mAllocator;
+
+    public:
+
+        // -------------------- Methods -------------------- //
+
+        /// Constructor
+        IdAllocator(MemoryAllocator& allocator)
+            : mSlots(allocator), mFirstFreeSlot(NO_FREE_SLOT), mNbIds(0), mAllocator(allocator) {
+
+        }
+
+        /// Assignment operator (the copied slots keep the memory allocator of this object)
+        IdAllocator& operator=(const IdAllocator& idAllocator) {
+
+            if (this != &idAllocator) {
+                mSlots = idAllocator.mSlots;
+                mFirstFreeSlot = idAllocator.mFirstFreeSlot;
+                mNbIds = idAllocator.mNbIds;
+            }
+
+            return *this;
+        }
+
+        /// Allocate a new identifier
+        uint64 allocate() {
+
+            uint32 slotIndex;
+
+            // If there is a free slot, we use it
+            if (mFirstFreeSlot != NO_FREE_SLOT) {
+                slotIndex = mFirstFreeSlot;
+                mFirstFreeSlot = mSlots[slotIndex].nextFreeSlot;
+            }
+            else {
+
+                // Create a new slot
+                assert(mSlots.size() < SLOT_USED);
+                slotIndex = static_cast<uint32>(mSlots.size());
+                mSlots.add(Slot(SLOT_USED));
+            }
+
+            mSlots[slotIndex].nextFreeSlot = SLOT_USED;
+            mNbIds++;
+
+            return computeId(slotIndex, mSlots[slotIndex].generation);
+        }
+
+        /// Release an identifier
+        void release(uint64 id) {
+
+            assert(isValid(id));
+
+            const uint32 slotIndex = getSlotIndex(id);
+            Slot& slot = mSlots[slotIndex];
+
+            // Increment the generation of the slot and add it to the free slots
+            slot.generation++;
+            slot.nextFreeSlot = mFirstFreeSlot;
+            mFirstFreeSlot = slotIndex;
+
+            assert(mNbIds > 0);
+            mNbIds--;
+        }
+
+        /// Return true if an identifier has been allocated and not released yet
+        bool isValid(uint64 id) const {
+
+            const uint32 slotIndex = getSlotIndex(id);
+
+            return slotIndex < mSlots.size() && mSlots[slotIndex].nextFreeSlot == SLOT_USED &&
+                   mSlots[slotIndex].generation == getGeneration(id);
+        }
+
+        /// Allocate memory for a given number of identifiers
+        void reserve(uint nbIds) {
+            mSlots.reserve(nbIds);
+        }
+
+        /// Return the number of allocated identifiers
+        uint getNbIds() const {
+            return mNbIds;
+        }
+
+        /// Write the slots of the allocator
+        void save(WorldStateWriter& writer) const {
+            writer.write(static_cast<uint32>(mSlots.size()));
+            for (uint i=0; i < mSlots.size(); i++) {
+                writer.write(mSlots[i].generation);
+                writer.write(mSlots[i].nextFreeSlot);
+            }
+            writer.write(mFirstFreeSlot);
+            writer.write(static_cast<uint32>(mNbIds));
+        }
+
+        /// Replace the slots of the allocator with the ones written by save() and return false
+        /// (without modifying the allocator) if the data is truncated, if the slots are not
+        /// consistent or if the given identifiers are not exactly the allocated ones
+        bool restore(WorldStateReader& reader, const List<uint64>& allocatedIds) {
+
+            if (!reader.canRead(sizeof(uint32))) return false;
+            WorldStateReader slotsReader = reader;
+            const uint32 nbSlots = slotsReader.read<uint32>();
+            if (nbSlots >= SLOT_USED ||
+                !slotsReader.canRead(static_cast<size_t>(nbSlots) * 2 * sizeof(uint32) + 2 * sizeof(uint32))) {
+                return false;
+            }
+
+            List<Slot> slots(mAllocator, nbSlots);
+            uint32 nbUsedSlots = 0;
+            for (uint32 i=0; i < nbSlots; i++) {
+                Slot slot(SLOT_USED);
+                slotsReader.read(slot.generation);
+                slotsReader.read(slot.nextFreeSlot);
+                if (slot.nextFreeSlot == SLOT_USED) {
+                    nbUsedSlots++;
+                }
+                else if (slot.nextFreeSlot != NO_FREE_SLOT && slot.nextFreeSlot >= nbSlots) {
+                    return false;
+                }
+                slots.add(slot);
+            }
+            const uint32 firstFreeSlot = slotsReader.read<uint32>();
+            const uint32 nbIds = slotsReader.read<uint32>();
+            if (nbIds != nbUsedSlots || allocatedIds.size() != nbIds) return false;
+
+            // The free slots must be linked together in a single list
+            const uint32 nbFreeSlots = nbSlots - nbUsedSlots;
+            uint32 nbLinkedSlots = 0;
+            for (uint32 slotIndex = firstFreeSlot; slotIndex != NO_FREE_SLOT; slotIndex = slots[slotIndex].nextFreeSlot) {
+                if (slotIndex >= nbSlots || slots[slotIndex].nextFreeSlot == SLOT_USED || nbLinkedSlots == nbFreeSlots) {
+                    return false;
+                }
+                nbLinkedSlots++;
+            }
+            if (nbLinkedSlots != nbFreeSlots) return false;
+
+            // Each used slot must have exactly one of the given identifiers (the slot of an
+            // identifier is marked as free once it has been found)
+            for (uint i=0; i < allocatedIds.size(); i++) {
+                const uint32 slotIndex = getSlotIndex(allocatedIds[i]);
+                if (slotIndex >= nbSlots || slots[slotIndex].nextFreeSlot != SLOT_USED ||
+                    slots[slotIndex].generation != getGeneration(allocatedIds[i])) {
+                    return false;
+                }
+                slots[slotIndex].nextFreeSlot = NO_FREE_SLOT;
+            }
+            for (uint i=0; i < allocatedIds.size(); i++) {
+                slots[getSlotIndex(allocatedIds[i])].nextFreeSlot = SLOT_USED;
+            }
+
+            mSlots = std::move(slots);
+            mFirstFreeSlot = firstFreeSlot;
+            mNbIds = nbIds;
+            reader = slotsReader;
+
+            return true;
+        }
+
+        /// Return the index of the slot of an identifier
+        static uint32 getSlotIndex(uint64 id) {
+            return static_cast<uint32>(id & 0xFFFFFFFF);
+        }
+
+        /// Return the generation of an identifier
+        static uint32 getGeneration(uint64 id) {
+            return static_cast<uint32>(id >> 32);
+        }
+
+        /// Return the identifier with a given slot index and generation
+        static uint64 computeId(uint32 slotIndex, uint32 generation) {
+            return (static_cast<uint64>(generation) << 32) | slotIndex;
+        }
+};
+
+}
+
+#endif
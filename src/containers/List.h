@@ -33,6 +33,7 @@
 #include <cstring>
 #include <iterator>
 #include <memory>
+#include <utility>
 
 namespace reactphysics3d {
 
@@ -181,6 +182,15 @@ class List {
             addRange(list);
         }
 
+        /// Move constructor (the memory of the list is taken with its allocator)
+        List(List<T>&& list) noexcept
+            : mBuffer(list.mBuffer), mSize(list.mSize), mCapacity(list.mCapacity), mAllocator(list.mAllocator) {
+
+            list.mBuffer = nullptr;
+            list.mSize = 0;
+            list.mCapacity = 0;
+        }
+
         /// Destructor
         ~List() {
 
@@ -207,10 +217,11 @@ class List {
 
                 if (mSize > 0) {
 
-                    // Copy the elements to the new allocated memory location
+                    // Move the elements to the new allocated memory location
                     T* destination = static_cast<T*>(newMemory);
                     T* items = static_cast<T*>(mBuffer);
-                    std::uninitialized_copy(items, items + mSize, destination);
+                    std::uninitialized_copy(std::make_move_iterator(items), std::make_move_iterator(items + mSize),
+                                            destination);
 
                     // Destruct the previous items
                     for (size_t i=0; i<mSize; i++) {
@@ -242,6 +253,37 @@ class List {
             mSize++;
         }
 
+        /// Add an element into the list by moving it
+        void add(T&& element) {
+
+            // If we need to allocate more memory
+            if (mSize == mCapacity) {
+                reserve(mCapacity == 0 ? 1 : mCapacity * 2);
+            }
+
+            // Use the move-constructor to construct the element
+            new (static_cast<char*>(mBuffer) + mSize * sizeof(T)) T(std::move(element));
+
+            mSize++;
+        }
+
+        /// Construct a new element at the end of the list with the given constructor arguments
+        template<typename... Args>
+        T& emplace(Args&&... args) {
+
+            // If we need to allocate more memory
+            if (mSize == mCapacity) {
+                reserve(mCapacity == 0 ? 1 : mCapacity * 2);
+            }
+
+            // Construct the element in place
+            T* element = new (static_cast<char*>(mBuffer) + mSize * sizeof(T)) T(std::forward<Args>(args)...);
+
+            mSize++;
+
+            return *element;
+        }
+
         /// Try to find a given item of the list and return an iterator
         /// pointing to that element if it exists in the list. Otherwise,
         /// this method returns the end() iterator
@@ -378,6 +420,48 @@ class List {
             return *this;
         }
 
+        /// Overloaded move assignment operator
+        /// The memory of the other list is taken if both lists use the same allocator. Otherwise,
+        /// its elements are moved into memory allocated with the allocator of this list.
+        List<T>& operator=(List<T>&& list) {
+
+            if (this != &list) {
+
+                // Clear all the elements
+                clear();
+
+                if (&mAllocator == &list.mAllocator) {
+
+                    // Release the current memory and take the memory of the other list
+                    if (mCapacity > 0) {
+                        mAllocator.release(mBuffer, mCapacity * sizeof(T));
+                    }
+
+                    mBuffer = list.mBuffer;
+                    mSize = list.mSize;
+                    mCapacity = list.mCapacity;
+
+                    list.mBuffer = nullptr;
+                    list.mSize = 0;
+                    list.mCapacity = 0;
+                }
+                else {
+
+                    reserve(list.size());
+
+                    // Move the elements of the other list
+                    for (uint i=0; i<list.size(); i++) {
+                        new (static_cast<char*>(mBuffer) + mSize * sizeof(T)) T(std::move(list[i]));
+                        mSize++;
+                    }
+
+                    list.clear();
+                }
+            }
+
+            return *this;
+        }
+
         /// Return a begin iterator
         Iterator begin() const {
             return Iterator(mBuffer, 0, mSize);
@@ -34,6 +34,7 @@
 #include <stdexcept>
 #include <functional>
 #include <limits>
+#include <utility>
 
 
 namespace reactphysics3d {
@@ -266,6 +267,76 @@ class Map {
             }
         }
 
+        /// Add an element into the map by copying or moving the given pair
+        template<typename P>
+        void addPair(P&& keyValue, bool insertIfAlreadyPresent) {
+
+            if (mCapacity == 0) {
+                initialize(0);
+            }
+
+            // Compute the hash code of the key
+            size_t hashCode = std::hash<K>()(keyValue.first);
+
+            // Compute the corresponding bucket index
+            int bucket = hashCode % mCapacity;
+
+            // Check if the item is already in the map
+            for (int i = mBuckets[bucket]; i >= 0; i = mEntries[i].next) {
+
+                // If there is already an item with the same key in the map
+                if (mEntries[i].hashCode == hashCode && mEntries[i].keyValue->first == keyValue.first) {
+
+                    if (insertIfAlreadyPresent) {
+
+                        // Destruct the previous key/value
+                        mEntries[i].keyValue->~Pair<K, V>();
+
+                        // Copy or move construct the new key/value
+                        new (mEntries[i].keyValue) Pair<K,V>(std::forward<P>(keyValue));
+
+                        return;
+                    }
+                    else {
+                        throw std::runtime_error("The key and value pair already exists in the map");
+                    }
+                }
+            }
+
+            size_t entryIndex;
+
+            // If there are free entries to use
+            if (mNbFreeEntries > 0) {
+                assert(mFreeIndex >= 0);
+                entryIndex = mFreeIndex;
+                mFreeIndex = mEntries[entryIndex].next;
+                mNbFreeEntries--;
+            }
+            else {
+
+                // If we need to allocator more entries
+                if (mNbUsedEntries == mCapacity) {
+
+                    // Allocate more memory
+                    reserve(mCapacity * 2);
+
+                    // Recompute the bucket index
+                    bucket = hashCode % mCapacity;
+                }
+
+                entryIndex = mNbUsedEntries;
+                mNbUsedEntries++;
+            }
+
+            assert(mEntries[entryIndex].keyValue == nullptr);
+            mEntries[entryIndex].hashCode = hashCode;
+            mEntries[entryIndex].next = mBuckets[bucket];
+            mEntries[entryIndex].keyValue = static_cast<Pair<K,V>*>(mAllocator.allocate(sizeof(Pair<K,V>)));
+            assert(mEntries[entryIndex].keyValue != nullptr);
+            new (mEntries[entryIndex].keyValue) Pair<K,V>(std::forward<P>(keyValue));
+            mBuckets[bucket] = entryIndex;
+        }
+
     public:
 
         /// Class Iterator
@@ -420,6 +491,19 @@ class Map {
             }
         }
 
+        /// Move constructor (the memory of the map is taken with its allocator)
+        Map(Map<K, V>&& map) noexcept
+          :mNbUsedEntries(map.mNbUsedEntries), mNbFreeEntries(map.mNbFreeEntries), mCapacity(map.mCapacity),
+           mBuckets(map.mBuckets), mEntries(map.mEntries), mAllocator(map.mAllocator), mFreeIndex(map.mFreeIndex) {
+
+            map.mNbUsedEntries = 0;
+            map.mNbFreeEntries = 0;
+            map.mCapacity = 0;
+            map.mBuckets = nullptr;
+            map.mEntries = nullptr;
+            map.mFreeIndex = -1;
+        }
+
         /// Destructor
         ~Map() {
 
@@ -439,6 +523,9 @@ class Map {
            }
 
            expand(capacity);
+
+           // Prepare the allocations of the elements
+           mAllocator.reserve(sizeof(Pair<K, V>), capacity - size());
         }
 
         /// Return true if the map contains an item with the given key
@@ -448,71 +535,19 @@ class Map {
 
         /// Add an element into the map
         void add(const Pair<K,V>& keyValue, bool insertIfAlreadyPresent = false) {
+            addPair(keyValue, insertIfAlreadyPresent);
+        }
 
-            if (mCapacity == 0) {
-                initialize(0);
-            }
-
-            // Compute the hash code of the key
-            size_t hashCode = std::hash<K>()(keyValue.first);
-
-            // Compute the corresponding bucket index
-            int bucket = hashCode % mCapacity;
-
-            // Check if the item is already in the map
-            for (int i = mBuckets[bucket]; i >= 0; i = mEntries[i].next) {
-
-                // If there is already an item with the same key in the map
-                if (mEntries[i].hashCode == hashCode && mEntries[i].keyValue->first == keyValue.first) {
-
-                    if (insertIfAlreadyPresent) {
-
-                        // Destruct the previous key/value
-                        mEntries[i].keyValue->~Pair<K, V>();
-
-                        // Copy construct the new key/value
-                        new (mEntries[i].keyValue) Pair<K,V>(keyValue);
-
-                        return;
-                    }
-                    else {
-                        throw std::runtime_error("The key and value pair already exists in the map");
-                    }
-                }
-            }
-
-            size_t entryIndex;
-
-            // If there are free entries to use
-            if (mNbFreeEntries > 0) {
-                assert(mFreeIndex >= 0);
-                entryIndex = mFreeIndex;
-                mFreeIndex = mEntries[entryIndex].next;
-                mNbFreeEntries--;
-            }
-            else {
-
-                // If we need to allocator more entries
-                if (mNbUsedEntries == mCapacity) {
-
-                    // Allocate more memory
-                    reserve(mCapacity * 2);
-
-                    // Recompute the bucket index
-                    bucket = hashCode % mCapacity;
-                }
-
-                entryIndex = mNbUsedEntries;
-                mNbUsedEntries++;
-            }
+        /// Add an element into the map by moving it
+        void add(Pair<K,V>&& keyValue, bool insertIfAlreadyPresent = false) {
+            addPair(std::move(keyValue), insertIfAlreadyPresent);
+        }
 
-            assert(mEntries[entryIndex].keyValue == nullptr);
-            mEntries[entryIndex].hashCode = hashCode;
-            mEntries[entryIndex].next = mBuckets[bucket];
-            mEntries[entryIndex].keyValue = static_cast<Pair<K,V>*>(mAllocator.allocate(sizeof(Pair<K,V>)));
-            assert(mEntries[entryIndex].keyValue != nullptr);
-            new (mEntries[entryIndex].keyValue) Pair<K,V>(keyValue);
-            mBuckets[bucket] = entryIndex;
+        /// Add an element into the map with a given key and a value constructed with the given
+        /// arguments (an exception is thrown if the key is already in the map)
+        template<typename... Args>
+        void emplace(const K& key, Args&&... args) {
+            addPair(Pair<K, V>(key, V(std::forward<Args>(args)...)), false);
         }
 
         /// Remove the element pointed by some iterator
@@ -746,6 +781,52 @@ class Map {
             return *this;
         }
 
+        /// Overloaded move assignment operator
+        /// The memory of the other map is taken if both maps use the same allocator. Otherwise,
+        /// its elements are moved into memory allocated with the allocator of this map.
+        Map<K,V>& operator=(Map<K, V>&& map) {
+
+            // Check for self assignment
+            if (this != &map) {
+
+                // Reset the map
+                reset();
+
+                if (&mAllocator == &map.mAllocator) {
+
+                    // Take the memory of the other map
+                    mNbUsedEntries = map.mNbUsedEntries;
+                    mNbFreeEntries = map.mNbFreeEntries;
+                    mCapacity = map.mCapacity;
+                    mBuckets = map.mBuckets;
+                    mEntries = map.mEntries;
+                    mFreeIndex = map.mFreeIndex;
+
+                    map.mNbUsedEntries = 0;
+                    map.mNbFreeEntries = 0;
+                    map.mCapacity = 0;
+                    map.mBuckets = nullptr;
+                    map.mEntries = nullptr;
+                    map.mFreeIndex = -1;
+                }
+                else {
+
+                    reserve(map.size());
+
+                    // Move the elements of the other map
+                    for (int i=0; i < map.mNbUsedEntries; i++) {
+                        if (map.mEntries[i].keyValue != nullptr) {
+                            add(std::move(*(map.mEntries[i].keyValue)));
+                        }
+                    }
+
+                    map.reset();
+                }
+            }
+
+            return *this;
+        }
+
         /// Return a begin iterator
         Iterator begin() const {
 
@@ -32,6 +32,7 @@
 #include "containers/containers_common.h"
 #include <cstring>
 #include <iterator>
+#include <utility>
 
 namespace reactphysics3d {
 
@@ -59,11 +60,22 @@ class Pair {
 
         }
 
+        /// Constructor that moves or copies the two elements
+        template<typename U1, typename U2>
+        Pair(U1&& item1, U2&& item2) : first(std::forward<U1>(item1)), second(std::forward<U2>(item2)) {
+
+        }
+
         /// Copy constructor
         Pair(const Pair<T1, T2>& pair) : first(pair.first), second(pair.second) {
 
         }
 
+        /// Move constructor
+        Pair(Pair<T1, T2>&& pair) : first(std::move(pair.first)), second(std::move(pair.second)) {
+
+        }
+
         /// Destructor
         ~Pair() = default;
 
@@ -83,6 +95,13 @@ class Pair {
             second = pair.second;
             return *this;
         }
+
+        /// Overloaded move assignment operator
+        Pair<T1, T2>& operator=(Pair<T1, T2>&& pair) {
+            first = std::move(pair.first);
+            second = std::move(pair.second);
+            return *this;
+        }
 };
 
 }
@@ -33,6 +33,7 @@
 #include <stdexcept>
 #include <functional>
 #include <limits>
+#include <utility>
 
 
 namespace reactphysics3d {
@@ -265,6 +266,64 @@ class Set {
             }
         }
 
+        /// Add a value into the set by copying or moving it
+        template<typename T>
+        void addValue(T&& value) {
+
+            if (mCapacity == 0) {
+                initialize(0);
+            }
+
+            // Compute the hash code of the value
+            size_t hashCode = std::hash<V>()(value);
+
+            // Compute the corresponding bucket index
+            int bucket = hashCode % mCapacity;
+
+            // Check if the item is already in the set
+            for (int i = mBuckets[bucket]; i >= 0; i = mEntries[i].next) {
+
+                // If there is already an item with the same value in the set
+                if (mEntries[i].hashCode == hashCode && (*mEntries[i].value) == value) {
+
+                    return;
+                }
+            }
+
+            size_t entryIndex;
+
+            // If there are free entries to use
+            if (mNbFreeEntries > 0) {
+                assert(mFreeIndex >= 0);
+                entryIndex = mFreeIndex;
+                mFreeIndex = mEntries[entryIndex].next;
+                mNbFreeEntries--;
+            }
+            else {
+
+                // If we need to allocator more entries
+                if (mNbUsedEntries == mCapacity) {
+
+                    // Allocate more memory
+                    reserve(mCapacity * 2);
+
+                    // Recompute the bucket index
+                    bucket = hashCode % mCapacity;
+                }
+
+                entryIndex = mNbUsedEntries;
+                mNbUsedEntries++;
+            }
+
+            assert(mEntries[entryIndex].value == nullptr);
+            mEntries[entryIndex].hashCode = hashCode;
+            mEntries[entryIndex].next = mBuckets[bucket];
+            mEntries[entryIndex].value = static_cast<V*>(mAllocator.allocate(sizeof(V)));
+            assert(mEntries[entryIndex].value != nullptr);
+            new (mEntries[entryIndex].value) V(std::forward<T>(value));
+            mBuckets[bucket] = entryIndex;
+        }
+
     public:
 
         /// Class Iterator
@@ -419,6 +478,19 @@ class Set {
             }
         }
 
+        /// Move constructor (the memory of the set is taken with its allocator)
+        Set(Set<V>&& set) noexcept
+          :mNbUsedEntries(set.mNbUsedEntries), mNbFreeEntries(set.mNbFreeEntries), mCapacity(set.mCapacity),
+           mBuckets(set.mBuckets), mEntries(set.mEntries), mAllocator(set.mAllocator), mFreeIndex(set.mFreeIndex) {
+
+            set.mNbUsedEntries = 0;
+            set.mNbFreeEntries = 0;
+            set.mCapacity = 0;
+            set.mBuckets = nullptr;
+            set.mEntries = nullptr;
+            set.mFreeIndex = -1;
+        }
+
         /// Destructor
         ~Set() {
 
@@ -438,6 +510,9 @@ class Set {
            }
 
            expand(capacity);
+
+           // Prepare the allocations of the elements
+           mAllocator.reserve(sizeof(V), capacity - size());
         }
 
         /// Return true if the set contains a given value
@@ -447,59 +522,19 @@ class Set {
 
         /// Add a value into the set
         void add(const V& value) {
+            addValue(value);
+        }
 
-            if (mCapacity == 0) {
-                initialize(0);
-            }
-
-            // Compute the hash code of the value
-            size_t hashCode = std::hash<V>()(value);
-
-            // Compute the corresponding bucket index
-            int bucket = hashCode % mCapacity;
-
-            // Check if the item is already in the set
-            for (int i = mBuckets[bucket]; i >= 0; i = mEntries[i].next) {
-
-                // If there is already an item with the same value in the set
-                if (mEntries[i].hashCode == hashCode && (*mEntries[i].value) == value) {
-
-                    return;
-                }
-            }
-
-            size_t entryIndex;
-
-            // If there are free entries to use
-            if (mNbFreeEntries > 0) {
-                assert(mFreeIndex >= 0);
-                entryIndex = mFreeIndex;
-                mFreeIndex = mEntries[entryIndex].next;
-                mNbFreeEntries--;
-            }
-            else {
-
-                // If we need to allocator more entries
-                if (mNbUsedEntries == mCapacity) {
-
-                    // Allocate more memory
-                    reserve(mCapacity * 2);
-
-                    // Recompute the bucket index
-                    bucket = hashCode % mCapacity;
-                }
-
-                entryIndex = mNbUsedEntries;
-                mNbUsedEntries++;
-            }
+        /// Add a value into the set by moving it
+        void add(V&& value) {
+            addValue(std::move(value));
+        }
 
-            assert(mEntries[entryIndex].value == nullptr);
-            mEntries[entryIndex].hashCode = hashCode;
-            mEntries[entryIndex].next = mBuckets[bucket];
-            mEntries[entryIndex].value = static_cast<V*>(mAllocator.allocate(sizeof(V)));
-            assert(mEntries[entryIndex].value != nullptr);
-            new (mEntries[entryIndex].value) V(value);
-            mBuckets[bucket] = entryIndex;
+        /// Add a value constructed with the given arguments into the set (the value is
+        /// constructed before the insertion because its hash code is needed)
+        template<typename... Args>
+        void emplace(Args&&... args) {
+            addValue(V(std::forward<Args>(args)...));
         }
 
         /// Remove the element pointed by some iterator
@@ -687,6 +722,52 @@ class Set {
             return *this;
         }
 
+        /// Overloaded move assignment operator
+        /// The memory of the other set is taken if both sets use the same allocator. Otherwise,
+        /// its elements are moved into memory allocated with the allocator of this set.
+        Set<V>& operator=(Set<V>&& set) {
+
+            // Check for self assignment
+            if (this != &set) {
+
+                // Reset the set
+                reset();
+
+                if (&mAllocator == &set.mAllocator) {
+
+                    // Take the memory of the other set
+                    mNbUsedEntries = set.mNbUsedEntries;
+                    mNbFreeEntries = set.mNbFreeEntries;
+                    mCapacity = set.mCapacity;
+                    mBuckets = set.mBuckets;
+                    mEntries = set.mEntries;
+                    mFreeIndex = set.mFreeIndex;
+
+                    set.mNbUsedEntries = 0;
+                    set.mNbFreeEntries = 0;
+                    set.mCapacity = 0;
+                    set.mBuckets = nullptr;
+                    set.mEntries = nullptr;
+                    set.mFreeIndex = -1;
+                }
+                else {
+
+                    reserve(set.size());
+
+                    // Move the elements of the other set
+                    for (int i=0; i < set.mNbUsedEntries; i++) {
+                        if (set.mEntries[i].value != nullptr) {
+                            add(std::move(*(set.mEntries[i].value)));
+                        }
+                    }
+
+                    set.reset();
+                }
+            }
+
+            return *this;
+        }
+
         /// Return a begin iterator
         Iterator begin() const {
 
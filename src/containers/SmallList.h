@@ -0,0 +1,377 @@
+/********************************************************************************
+* ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
+* Copyright (c) 2010-2018 Daniel Chappuis                                       *
+*********************************************************************************
+*                                                                               *
+* This software is provided 'as-is', without any express or implied warranty.   *
+* In no event will the authors be held liable for any damages arising from the  *
+* use of this software.                                                         *
+*                                                                               *
+* Permission is granted to anyone to use this software for any purpose,         *
+* including commercial applications, and to alter it and redistribute it        *
+* freely, subject to the following restrictions:                                *
+*                                                                               *
+* 1. The origin of this software must not be misrepresented; you must not claim *
+*    that you wrote the original software. If you use this software in a        *
+*    product, an acknowledgment in the product documentation would be           *
+*    appreciated but is not required.                                           *
+*                                                                               *
+* 2. Altered source versions must be plainly marked as such, and must not be    *
+*    misrepresented as being the original software.                             *
+*                                                                               *
+* 3. This notice may not be removed or altered from any source distribution.    *
+*                                                                               *
+********************************************************************************/
+
+#ifndef REACTPHYSICS3D_SMALL_LIST_H
+#define REACTPHYSICS3D_SMALL_LIST_H
+
+// Libraries
+#include "configuration.h"
+#include "memory/MemoryAllocator.h"
+#include "containers/List.h"
+#include <cassert>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <utility>
+
+namespace reactphysics3d {
+
+// Class SmallList
+/**
+ * This class represents a generic list that stores its first N elements inside the object
+ * itself. The memory allocator is only used when the list grows larger than N elements. It
+ * is used for the small collections (the vertices of a face or of a clipped polygon for
+ * instance) that would otherwise need an allocation for a few elements. The elements in the
+ * object are accessed through their offset (not a pointer to the object) so that the list
+ * can be moved in memory like the elements of a List.
+  */
+template<typename T, uint N>
+class SmallList {
+
+    private:
+
+        // -------------------- Attributes -------------------- //
+
+        /// Buffer for the elements stored in the object
+        alignas(T) unsigned char mInlineBuffer[N * sizeof(T)];
+
+        /// Buffer allocated with the memory allocator (null if the elements are in the object)
+        T* mHeapBuffer;
+
+        /// Number of elements in the list
+        size_t mSize;
+
+        /// Number of elements that can be stored without allocating memory
+        size_t mCapacity;
+
+        /// Memory allocator
+        MemoryAllocator& mAllocator;
+
+        // -------------------- Methods -------------------- //
+
+        /// Return a pointer to the elements
+        T* getBuffer() {
+            return mHeapBuffer != nullptr ? mHeapBuffer : reinterpret_cast<T*>(mInlineBuffer);
+        }
+
+        /// Return a pointer to the elements
+        const T* getBuffer() const {
+            return mHeapBuffer != nullptr ? mHeapBuffer : reinterpret_cast<const T*>(mInlineBuffer);
+        }
+
+        /// Take the elements of another list (this list must be empty and stored in the object)
+        void moveElements(SmallList<T, N>& list) {
+
+            assert(mSize == 0 && mHeapBuffer == nullptr);
+
+            if (list.mHeapBuffer != nullptr && &mAllocator == &list.mAllocator) {
+
+                // Take the memory allocated by the other list
+                mHeapBuffer = list.mHeapBuffer;
+                mCapacity = list.mCapacity;
+                mSize = list.mSize;
+
+                list.mHeapBuffer = nullptr;
+                list.mCapacity = N;
+                list.mSize = 0;
+            }
+            else {
+
+                reserve(list.mSize);
+
+                // Move the elements of the other list
+                T* items = getBuffer();
+                for (size_t i=0; i < list.mSize; i++) {
+                    new (static_cast<void*>(items + i)) T(std::move(list[i]));
+                }
+                mSize = list.mSize;
+
+                list.clear();
+            }
+        }
+
+    public:
+
+        // -------------------- Methods -------------------- //
+
+        /// Constructor
+        SmallList(MemoryAllocator& allocator, size_t capacity = 0)
+            : mHeapBuffer(nullptr), mSize(0), mCapacity(N), mAllocator(allocator) {
+
+            reserve(capacity);
+        }
+
+        /// Copy constructor
+        SmallList(const SmallList<T, N>& list)
+            : mHeapBuffer(nullptr), mSize(0), mCapacity(N), mAllocator(list.mAllocator) {
+
+            addRange(list);
+        }
+
+        /// Move constructor (the memory allocated by the list is taken and the elements stored
+        /// in the object are moved)
+        SmallList(SmallList<T, N>&& list)
+            : mHeapBuffer(nullptr), mSize(0), mCapacity(N), mAllocator(list.mAllocator) {
+
+            moveElements(list);
+        }
+
+        /// Destructor
+        ~SmallList() {
+
+            clear();
+
+            // Release the memory allocated on the heap
+            if (mHeapBuffer != nullptr) {
+                mAllocator.release(mHeapBuffer, mCapacity * sizeof(T));
+            }
+        }
+
+        /// Allocate memory for a given number of elements
+        void reserve(size_t capacity) {
+
+            if (capacity <= mCapacity) return;
+
+            // Allocate memory for the new array
+            T* newBuffer = static_cast<T*>(mAllocator.allocate(capacity * sizeof(T)));
+            assert(newBuffer != nullptr);
+
+            // Move the elements to the new allocated memory location and destruct the previous ones
+            T* items = getBuffer();
+            std::uninitialized_copy(std::make_move_iterator(items), std::make_move_iterator(items + mSize), newBuffer);
+            for (size_t i=0; i < mSize; i++) {
+                items[i].~T();
+            }
+
+            // Release the previously allocated memory
+            if (mHeapBuffer != nullptr) {
+                mAllocator.release(mHeapBuffer, mCapacity * sizeof(T));
+            }
+
+            mHeapBuffer = newBuffer;
+            mCapacity = capacity;
+        }
+
+        /// Add an element into the list
+        void add(const T& element) {
+
+            // If we need to allocate more memory
+            if (mSize == mCapacity) {
+                reserve(mCapacity == 0 ? 1 : mCapacity * 2);
+            }
+
+            // Use the copy-constructor to construct the element
+            new (static_cast<void*>(getBuffer() + mSize)) T(element);
+
+            mSize++;
+        }
+
+        /// Add an element into the list by moving it
+        void add(T&& element) {
+
+            // If we need to allocate more memory
+            if (mSize == mCapacity) {
+                reserve(mCapacity == 0 ? 1 : mCapacity * 2);
+            }
+
+            // Use the move-constructor to construct the element
+            new (static_cast<void*>(getBuffer() + mSize)) T(std::move(element));
+
+            mSize++;
+        }
+
+        /// Construct a new element at the end of the list with the given constructor arguments
+        template<typename... Args>
+        T& emplace(Args&&... args) {
+
+            // If we need to allocate more memory
+            if (mSize == mCapacity) {
+                reserve(mCapacity == 0 ? 1 : mCapacity * 2);
+            }
+
+            // Construct the element in place
+            T* element = new (static_cast<void*>(getBuffer() + mSize)) T(std::forward<Args>(args)...);
+
+            mSize++;
+
+            return *element;
+        }
+
+        /// Append another list at the end of the current one
+        void addRange(const SmallList<T, N>& list) {
+
+            reserve(mSize + list.size());
+
+            for (size_t i=0; i < list.size(); i++) {
+                new (static_cast<void*>(getBuffer() + mSize)) T(list[i]);
+                mSize++;
+            }
+        }
+
+        /// Append a List at the end of the current one
+        void addRange(const List<T>& list) {
+
+            reserve(mSize + list.size());
+
+            for (uint i=0; i < list.size(); i++) {
+                new (static_cast<void*>(getBuffer() + mSize)) T(list[i]);
+                mSize++;
+            }
+        }
+
+        /// Remove an element from the list at a given index
+        void removeAt(uint index) {
+
+            assert(index < mSize);
+
+            T* items = getBuffer();
+
+            // Move the following elements to fill in the empty slot
+            for (size_t i=index; i + 1 < mSize; i++) {
+                items[i] = items[i + 1];
+            }
+
+            mSize--;
+            items[mSize].~T();
+        }
+
+        /// Clear the list
+        void clear() {
+
+            // Call the destructor of each element
+            T* items = getBuffer();
+            for (size_t i=0; i < mSize; i++) {
+                items[i].~T();
+            }
+
+            mSize = 0;
+        }
+
+        /// Return the number of elements in the list
+        size_t size() const {
+            return mSize;
+        }
+
+        /// Return the number of elements that can be stored without allocating memory
+        size_t capacity() const {
+            return mCapacity;
+        }
+
+        /// Return true if the elements are stored in the object (no memory has been allocated)
+        bool isInline() const {
+            return mHeapBuffer == nullptr;
+        }
+
+        /// Overloaded index operator
+        T& operator[](const uint index) {
+           assert(index < mSize);
+           return getBuffer()[index];
+        }
+
+        /// Overloaded const index operator
+        const T& operator[](const uint index) const {
+           assert(index < mSize);
+           return getBuffer()[index];
+        }
+
+        /// Overloaded equality operator
+        bool operator==(const SmallList<T, N>& list) const {
+
+            if (mSize != list.mSize) return false;
+
+            const T* items = getBuffer();
+            for (size_t i=0; i < mSize; i++) {
+                if (items[i] != list[i]) {
+                    return false;
+                }
+            }
+
+            return true;
+        }
+
+        /// Overloaded not equal operator
+        bool operator!=(const SmallList<T, N>& list) const {
+
+            return !((*this) == list);
+        }
+
+        /// Overloaded assignment operator
+        SmallList<T, N>& operator=(const SmallList<T, N>& list) {
+
+            if (this != &list) {
+
+                // Clear all the elements
+                clear();
+
+                // Add all the elements of the list to the current one
+                addRange(list);
+            }
+
+            return *this;
+        }
+
+        /// Overloaded move assignment operator
+        SmallList<T, N>& operator=(SmallList<T, N>&& list) {
+
+            if (this != &list) {
+
+                // Clear all the elements and release the allocated memory
+                clear();
+                if (mHeapBuffer != nullptr) {
+                    mAllocator.release(mHeapBuffer, mCapacity * sizeof(T));
+                    mHeapBuffer = nullptr;
+                    mCapacity = N;
+                }
+
+                moveElements(list);
+            }
+
+            return *this;
+        }
+
+        /// Return a pointer to the first element
+        T* begin() {
+            return getBuffer();
+        }
+
+        /// Return a pointer after the last element
+        T* end() {
+            return getBuffer() + mSize;
+        }
+
+        /// Return a pointer to the first element
+        const T* begin() const {
+            return getBuffer();
+        }
+
+        /// Return a pointer after the last element
+        const T* end() const {
+            return getBuffer() + mSize;
+        }
+};
+
+}
+
+#endif
@@ -26,6 +26,9 @@
 #ifndef REACTPHYSICS3D_DECIMAL_H
 #define	REACTPHYSICS3D_DECIMAL_H
 
+// Libraries
+#include <cstddef>
+
 /// ReactPhysiscs3D namespace
 namespace reactphysics3d {
 
@@ -35,6 +38,18 @@ namespace reactphysics3d {
     using decimal = float;
 #endif
 
+#if defined(IS_ALIGNED_VECTOR_STORAGE_ENABLED)   // If the vectors are stored on four aligned lanes
+    /// Alignment (in bytes) of the Vector3 and Quaternion objects. The Vector3 objects have
+    /// a fourth padding component so that each vector fills a 128 bits register in single
+    /// precision and the compiler can load, store and combine it with a single instruction.
+    /// The memory allocators of the library round their sizes to this alignment. The
+    /// allocators given by the user must return memory aligned on 16 bytes.
+    constexpr size_t VECTOR_ALIGNMENT = 16;
+#else
+    /// Alignment (in bytes) of the Vector3 and Quaternion objects
+    constexpr size_t VECTOR_ALIGNMENT = alignof(decimal);
+#endif
+
 }
 
 #endif
@@ -0,0 +1,591 @@
+/********************************************************************************
+* ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
+* Copyright (c) 2010-2018 Daniel Chappuis                                       *
+*********************************************************************************
+*                                                                               *
+* This software is provided 'as-is', without any express or implied warranty.   *
+* In no event will the authors be held liable for any damages arising from the  *
+* use of this software.                                                         *
+*                                                                               *
+* Permission is granted to anyone to use this software for any purpose,         *
+* including commercial applications, and to alter it and redistribute it        *
+* freely, subject to the following restrictions:                                *
+*                                                                               *
+* 1. The origin of this software must not be misrepresented; you must not claim *
+*    that you wrote the original software. If you use this software in a        *
+*    product, an acknowledgment in the product documentation would be           *
+*    appreciated but is not required.                                           *
+*                                                                               *
+* 2. Altered source versions must be plainly marked as such, and must not be    *
+*    misrepresented as being the original software.                             *
+*                                                                               *
+* 3. This notice may not be removed or altered from any source distribution.    *
+*                                                                               *
+********************************************************************************/
+
+// Libraries
+#include "ArticulationSolver.h"
+#include "ConstraintSolver.h"
+#include "engine/Island.h"
+#include "constraint/Joint.h"
+#include "body/RigidBody.h"
+#include "memory/MemoryManager.h"
+#include "utils/Profiler.h"
+
+using namespace reactphysics3d;
+
+// Static variables definition
+const decimal ArticulationSolver::SINGULAR_BLOCK_TOLERANCE = decimal(1e-6);
+
+// Constructor
+ArticulationSolver::ArticulationSolver(MemoryManager& memoryManager, const WorldSettings& worldSettings)
+                   : mWorldSettings(worldSettings), mArena(memoryManager.getBaseAllocator(MemoryTag::Solver)),
+                     mIslands(nullptr), mNbIslands(0), mIslandsNodes(nullptr), mIslandsNbNodes(nullptr),
+                     mIsIslandBuilt(nullptr) {
+
+#ifdef IS_PROFILING_ACTIVE
+
+    mProfiler = nullptr;
+
+#endif
+
+}
+
+// Initialize the solver for the islands of the current step
+/// The memory of the articulations of the previous step is released. The articulations of
+/// an island are built when the island is initialized for the first time during the step.
+void ArticulationSolver::init(Island** islands, uint nbIslands) {
+
+    mArena.reset();
+
+    mIslands = islands;
+    mNbIslands = nbIslands;
+    mIslandsNodes = nullptr;
+    mIslandsNbNodes = nullptr;
+    mIsIslandBuilt = nullptr;
+
+    if (!mWorldSettings.isArticulationSolverEnabled || nbIslands == 0) return;
+
+    mIslandsNodes = static_cast<ArticulationNode**>(mArena.allocate(sizeof(ArticulationNode*) * nbIslands));
+    mIslandsNbNodes = static_cast<uint*>(mArena.allocate(sizeof(uint) * nbIslands));
+    mIsIslandBuilt = static_cast<bool*>(mArena.allocate(sizeof(bool) * nbIslands));
+
+    for (uint i=0; i < nbIslands; i++) {
+        mIslandsNodes[i] = nullptr;
+        mIslandsNbNodes[i] = 0;
+        mIsIslandBuilt[i] = false;
+    }
+}
+
+// Initialize the articulations of an island
+/// This method must be called after the initialization of the joints of the island because
+/// the rows of the constraints are computed by the joints in initBeforeSolve(). If the system
+/// of the articulations is singular (redundant constraints), the joints of the island are
+/// solved by the sequential impulses.
+void ArticulationSolver::initializeForIsland(uint islandIndex) {
+
+    if (mIslandsNbNodes == nullptr) return;
+
+    RP3D_PROFILE("ArticulationSolver::initializeForIsland()", mProfiler);
+
+    assert(islandIndex < mNbIslands);
+
+    if (!mIsIslandBuilt[islandIndex]) {
+        buildArticulations(islandIndex);
+        mIsIslandBuilt[islandIndex] = true;
+    }
+
+    if (mIslandsNbNodes[islandIndex] > 0 && !factorize(islandIndex)) {
+        clearArticulations(islandIndex);
+    }
+}
+
+// Build the trees of the articulations of an island
+/// The dynamic bodies and the supported joints of the island are visited in breadth-first
+/// order from a root so that the parent of a node is always before the node in the array of
+/// nodes. The root of a tree is a joint between a dynamic body and a static or kinematic body
+/// (the base of a robot arm) or a dynamic body if there is no such joint. The leaves of a tree
+/// must be bodies because the diagonal block of a leaf joint is zero. Therefore, the other
+/// joints with a static or kinematic body and the joints that would close a loop are not part
+/// of the articulation and are solved by the sequential impulses.
+void ArticulationSolver::buildArticulations(uint islandIndex) {
+
+    Island* island = mIslands[islandIndex];
+    RigidBody** bodies = island->getBodies();
+    Joint** joints = island->getJoints();
+    const uint nbBodies = island->getNbBodies();
+    const uint nbJoints = island->getNbJoints();
+
+    // The bodies of the island are contiguous in the velocity arrays
+    const uint firstArrayIndex = bodies[0]->mArrayIndex;
+
+    // Count the supported joints of each dynamic body
+    uint* bodiesFirstJoint = static_cast<uint*>(mArena.allocate(sizeof(uint) * (nbBodies + 1)));
+    for (uint b=0; b <= nbBodies; b++) {
+        bodiesFirstJoint[b] = 0;
+    }
+    uint nbArticulationJoints = 0;
+    for (uint j=0; j < nbJoints; j++) {
+
+        Joint* joint = joints[j];
+        joint->mIsInArticulation = false;
+
+        const bool isBody1Dynamic = isBodyMovable(joint->mBody1);
+        const bool isBody2Dynamic = isBodyMovable(joint->mBody2);
+        if (joint->getNbArticulationRows() == 0 || (!isBody1Dynamic && !isBody2Dynamic)) continue;
+
+        nbArticulationJoints++;
+        if (isBody1Dynamic) bodiesFirstJoint[joint->mBody1->mArrayIndex - firstArrayIndex + 1]++;
+        if (isBody2Dynamic) bodiesFirstJoint[joint->mBody2->mArrayIndex - firstArrayIndex + 1]++;
+    }
+
+    if (nbArticulationJoints == 0) return;
+
+    // Compute the adjacency lists of the dynamic bodies
+    for (uint b=0; b < nbBodies; b++) {
+        bodiesFirstJoint[b + 1] += bodiesFirstJoint[b];
+    }
+    uint* bodiesJoints = static_cast<uint*>(mArena.allocate(sizeof(uint) * bodiesFirstJoint[nbBodies]));
+    uint* bodiesNbJoints = static_cast<uint*>(mArena.allocate(sizeof(uint) * nbBodies));
+    for (uint b=0; b < nbBodies; b++) {
+        bodiesNbJoints[b] = 0;
+    }
+    for (uint j=0; j < nbJoints; j++) {
+
+        Joint* joint = joints[j];
+        const bool isBody1Dynamic = isBodyMovable(joint->mBody1);
+        const bool isBody2Dynamic = isBodyMovable(joint->mBody2);
+        if (joint->getNbArticulationRows() == 0 || (!isBody1Dynamic && !isBody2Dynamic)) continue;
+
+        if (isBody1Dynamic) {
+            const uint b = joint->mBody1->mArrayIndex - firstArrayIndex;
+            bodiesJoints[bodiesFirstJoint[b] + bodiesNbJoints[b]] = j;
+            bodiesNbJoints[b]++;
+        }
+        if (isBody2Dynamic) {
+            const uint b = joint->mBody2->mArrayIndex - firstArrayIndex;
+            bodiesJoints[bodiesFirstJoint[b] + bodiesNbJoints[b]] = j;
+            bodiesNbJoints[b]++;
+        }
+    }
+
+    bool* isBodyVisited = static_cast<bool*>(mArena.allocate(sizeof(bool) * nbBodies));
+    for (uint b=0; b < nbBodies; b++) {
+        isBodyVisited[b] = false;
+    }
+    bool* isJointVisited = static_cast<bool*>(mArena.allocate(sizeof(bool) * nbJoints));
+    for (uint j=0; j < nbJoints; j++) {
+        isJointVisited[j] = false;
+    }
+
+    ArticulationNode* nodes = static_cast<ArticulationNode*>(mArena.allocate(sizeof(ArticulationNode) *
+                                                                              (nbBodies + nbArticulationJoints)));
+    ArticulationJointRows* rows = static_cast<ArticulationJointRows*>(mArena.allocate(sizeof(ArticulationJointRows) *
+                                                                                      nbArticulationJoints));
+    uint nbNodes = 0;
+    uint nbRows = 0;
+
+    // Add a body node or a joint node to the articulations
+    auto addBodyNode = [&](RigidBody* body, int parent) {
+        isBodyVisited[body->mArrayIndex - firstArrayIndex] = true;
+        ArticulationNode& node = nodes[nbNodes];
+        node.joint = nullptr;
+        node.rows = nullptr;
+        node.body = body;
+        node.indexBody = body->mArrayIndex;
+        node.dimension = 6;
+        node.parent = parent;
+        nbNodes++;
+    };
+    auto addJointNode = [&](Joint* joint, int parent) {
+        joint->mIsInArticulation = true;
+        ArticulationNode& node = nodes[nbNodes];
+        node.joint = joint;
+        node.rows = &(rows[nbRows]);
+        node.body = nullptr;
+        node.indexBody = 0;
+        node.dimension = joint->getNbArticulationRows();
+        node.parent = parent;
+        nbRows++;
+        nbNodes++;
+    };
+
+    // The roots of the trees are first the joints between a dynamic body and a static or
+    // kinematic body and then the dynamic bodies that are not part of a tree yet
+    for (uint root=0; root < nbJoints + nbBodies; root++) {
+
+        const uint firstNode = nbNodes;
+
+        if (root < nbJoints) {
+
+            Joint* joint = joints[root];
+            const bool isBody1Dynamic = isBodyMovable(joint->mBody1);
+            const bool isBody2Dynamic = isBodyMovable(joint->mBody2);
+            if (isJointVisited[root] || joint->getNbArticulationRows() == 0 || isBody1Dynamic == isBody2Dynamic) continue;
+
+            RigidBody* body = isBody1Dynamic ? joint->mBody1 : joint->mBody2;
+            if (isBodyVisited[body->mArrayIndex - firstArrayIndex]) continue;
+
+            isJointVisited[root] = true;
+            addJointNode(joint, -1);
+            addBodyNode(body, static_cast<int>(firstNode));
+        }
+        else {
+
+            const uint b = root - nbJoints;
+            if (isBodyVisited[b] || bodiesNbJoints[b] == 0) continue;
+
+            addBodyNode(bodies[b], -1);
+        }
+
+        // Visit the tree in breadth-first order (the array of nodes is the queue)
+        for (uint n=firstNode; n < nbNodes; n++) {
+
+            // The children of a joint are added with the joint
+            if (nodes[n].body == nullptr) continue;
+
+            const uint b = nodes[n].indexBody - firstArrayIndex;
+            for (uint k=bodiesFirstJoint[b]; k < bodiesFirstJoint[b] + bodiesNbJoints[b]; k++) {
+
+                const uint j = bodiesJoints[k];
+                if (isJointVisited[j]) continue;
+                isJointVisited[j] = true;
+
+                Joint* joint = joints[j];
+                RigidBody* otherBody = joint->mBody1 == nodes[n].body ? joint->mBody2 : joint->mBody1;
+
+                // A joint with a static or kinematic body would be a leaf of the tree with a
+                // singular diagonal block and a joint with a body of the tree would close a loop
+                if (!isBodyMovable(otherBody) ||
+                    isBodyVisited[otherBody->mArrayIndex - firstArrayIndex]) continue;
+
+                addJointNode(joint, static_cast<int>(n));
+                addBodyNode(otherBody, static_cast<int>(nbNodes - 1));
+            }
+        }
+    }
+
+    assert(nbRows <= nbArticulationJoints);
+
+    mIslandsNodes[islandIndex] = nodes;
+    mIslandsNbNodes[islandIndex] = nbNodes;
+}
+
+// Factorize the system of the articulations of an island
+/// The diagonal blocks D are computed from the leaves to the root with
+/// D_i = H_ii - sum_c H_ic * D_c^-1 * H_ci where c are the children of node i.
+/**
+ * @return False if a diagonal block is singular
+ */
+bool ArticulationSolver::factorize(uint islandIndex) {
+
+    ArticulationNode* nodes = mIslandsNodes[islandIndex];
+    const uint nbNodes = mIslandsNbNodes[islandIndex];
+
+    // Compute the rows of the joints and the diagonal blocks H_ii of the system
+    // (the blocks are accumulated in the dInverse attribute of the nodes before their inversion)
+    for (uint n=0; n < nbNodes; n++) {
+
+        ArticulationNode& node = nodes[n];
+        const uint dimension = node.dimension;
+
+        for (uint k=0; k < dimension * dimension; k++) {
+            node.dInverse[k] = decimal(0.0);
+        }
+
+        if (node.body != nullptr) {
+
+            // Mass matrix of the body
+            const decimal mass = node.body->getMass();
+            const Matrix3x3 inertiaTensorWorld = node.body->getInertiaTensorInverseWorld().getInverse();
+            for (uint i=0; i < 3; i++) {
+                node.dInverse[i * 6 + i] = mass;
+                for (uint j=0; j < 3; j++) {
+                    node.dInverse[(3 + i) * 6 + 3 + j] = inertiaTensorWorld[i][j];
+                }
+            }
+        }
+        else {
+
+            node.rows->nbRows = dimension;
+            node.rows->indexBody1 = node.joint->mIndexBody1;
+            node.rows->indexBody2 = node.joint->mIndexBody2;
+            node.joint->computeArticulationRows(*(node.rows));
+        }
+    }
+
+    // Compute the blocks between the nodes and their parent
+    for (uint n=0; n < nbNodes; n++) {
+
+        ArticulationNode& node = nodes[n];
+        if (node.parent < 0) continue;
+
+        const ArticulationNode& parent = nodes[node.parent];
+
+        if (node.body == nullptr) {
+
+            // Jacobian of the joint for the parent body (rows x 6)
+            const decimal* jacobian = parent.indexBody == node.rows->indexBody1 ? node.rows->jacobianBody1 :
+                                                                                  node.rows->jacobianBody2;
+            for (uint k=0; k < node.dimension * 6; k++) {
+                node.parentBlock[k] = jacobian[k];
+            }
+        }
+        else {
+
+            // Transpose of the Jacobian of the parent joint for the body (6 x rows)
+            const decimal* jacobian = node.indexBody == parent.rows->indexBody1 ? parent.rows->jacobianBody1 :
+                                                                                  parent.rows->jacobianBody2;
+            for (uint i=0; i < 6; i++) {
+                for (uint j=0; j < parent.dimension; j++) {
+                    node.parentBlock[i * parent.dimension + j] = jacobian[j * 6 + i];
+                }
+            }
+        }
+    }
+
+    // Eliminate the nodes from the leaves to the root
+    decimal block[36];
+    for (int n=static_cast<int>(nbNodes) - 1; n >= 0; n--) {
+
+        ArticulationNode& node = nodes[n];
+        const uint dimension = node.dimension;
+
+        for (uint k=0; k < dimension * dimension; k++) {
+            block[k] = node.dInverse[k];
+        }
+        if (!invertMatrix(block, node.dInverse, dimension)) return false;
+
+        if (node.parent < 0) continue;
+
+        ArticulationNode& parent = nodes[node.parent];
+        const uint parentDimension = parent.dimension;
+
+        // Compute L = D^-1 * H_ip
+        for (uint i=0; i < dimension; i++) {
+            for (uint j=0; j < parentDimension; j++) {
+                decimal value = decimal(0.0);
+                for (uint k=0; k < dimension; k++) {
+                    value += node.dInverse[i * dimension + k] * node.parentBlock[k * parentDimension + j];
+                }
+                node.lBlock[i * parentDimension + j] = value;
+            }
+        }
+
+        // Update the diagonal block of the parent with D_p -= H_pi * L
+        for (uint i=0; i < parentDimension; i++) {
+            for (uint j=0; j < parentDimension; j++) {
+                decimal value = decimal(0.0);
+                for (uint k=0; k < dimension; k++) {
+                    value += node.parentBlock[k * parentDimension + i] * node.lBlock[k * parentDimension + j];
+                }
+                parent.dInverse[i * parentDimension + j] -= value;
+            }
+        }
+    }
+
+    return true;
+}
+
+// Remove the joints of an island from the articulation solver
+void ArticulationSolver::clearArticulations(uint islandIndex) {
+
+    ArticulationNode* nodes = mIslandsNodes[islandIndex];
+    for (uint n=0; n < mIslandsNbNodes[islandIndex]; n++) {
+        if (nodes[n].joint != nullptr) nodes[n].joint->mIsInArticulation = false;
+    }
+
+    mIslandsNbNodes[islandIndex] = 0;
+}
+
+// Solve the velocity constraints of the articulations of an island
+/// The velocities of the bodies after the solve exactly satisfy the equality constraints of
+/// the joints of the articulations. The impulses are accumulated into the joints for the
+/// warm starting.
+/**
+ * @param islandIndex Index of the island
+ * @param constraintSolverData Data with the velocities of the bodies
+ * @return The largest absolute change of the impulses of the joints
+ */
+decimal ArticulationSolver::solveVelocityConstraints(uint islandIndex,
+                                                     const ConstraintSolverData& constraintSolverData) {
+
+    assert(hasArticulations(islandIndex));
+
+    ArticulationNode* nodes = mIslandsNodes[islandIndex];
+    const uint nbNodes = mIslandsNbNodes[islandIndex];
+
+    Vector3* linearVelocities = constraintSolverData.linearVelocities;
+    Vector3* angularVelocities = constraintSolverData.angularVelocities;
+
+    // Compute the right-hand side of the system (-Jv - b for the joints)
+    for (uint n=0; n < nbNodes; n++) {
+
+        ArticulationNode& node = nodes[n];
+
+        if (node.body != nullptr) {
+            for (uint i=0; i < 6; i++) {
+                node.vector[i] = decimal(0.0);
+            }
+            continue;
+        }
+
+        const ArticulationJointRows& rows = *(node.rows);
+        const Vector3& v1 = linearVelocities[rows.indexBody1];
+        const Vector3& w1 = angularVelocities[rows.indexBody1];
+        const Vector3& v2 = linearVelocities[rows.indexBody2];
+        const Vector3& w2 = angularVelocities[rows.indexBody2];
+
+        for (uint r=0; r < rows.nbRows; r++) {
+            const decimal* row1 = rows.jacobianBody1 + 6 * r;
+            const decimal* row2 = rows.jacobianBody2 + 6 * r;
+            const decimal Jv = row1[0] * v1.x + row1[1] * v1.y + row1[2] * v1.z +
+                               row1[3] * w1.x + row1[4] * w1.y + row1[5] * w1.z +
+                               row2[0] * v2.x + row2[1] * v2.y + row2[2] * v2.z +
+                               row2[3] * w2.x + row2[4] * w2.y + row2[5] * w2.z;
+            node.vector[r] = -Jv - rows.bias[r];
+        }
+    }
+
+    // Forward substitution from the leaves to the root
+    for (int n=static_cast<int>(nbNodes) - 1; n >= 0; n--) {
+
+        const ArticulationNode& node = nodes[n];
+        if (node.parent < 0) continue;
+
+        ArticulationNode& parent = nodes[node.parent];
+        for (uint j=0; j < parent.dimension; j++) {
+            for (uint i=0; i < node.dimension; i++) {
+                parent.vector[j] -= node.lBlock[i * parent.dimension + j] * node.vector[i];
+            }
+        }
+    }
+
+    // Back substitution from the roots to the leaves
+    decimal solution[6];
+    for (uint n=0; n < nbNodes; n++) {
+
+        ArticulationNode& node = nodes[n];
+        const uint dimension = node.dimension;
+
+        for (uint i=0; i < dimension; i++) {
+            solution[i] = decimal(0.0);
+            for (uint k=0; k < dimension; k++) {
+                solution[i] += node.dInverse[i * dimension + k] * node.vector[k];
+            }
+        }
+
+        if (node.parent >= 0) {
+            const ArticulationNode& parent = nodes[node.parent];
+            for (uint i=0; i < dimension; i++) {
+                for (uint k=0; k < parent.dimension; k++) {
+                    solution[i] -= node.lBlock[i * parent.dimension + k] * parent.vector[k];
+                }
+            }
+        }
+
+        for (uint i=0; i < dimension; i++) {
+            node.vector[i] = solution[i];
+        }
+    }
+
+    // Apply the change of velocity to the bodies and the impulses to the joints
+    decimal impulseDelta = decimal(0.0);
+    for (uint n=0; n < nbNodes; n++) {
+
+        ArticulationNode& node = nodes[n];
+
+        if (node.body != nullptr) {
+            linearVelocities[node.indexBody] += Vector3(node.vector[0], node.vector[1], node.vector[2]);
+            angularVelocities[node.indexBody] += Vector3(node.vector[3], node.vector[4], node.vector[5]);
+            continue;
+        }
+
+        // The unknowns of the joints are the opposite of the impulses
+        decimal impulse[6];
+        decimal jointImpulseDelta = decimal(0.0);
+        for (uint r=0; r < node.dimension; r++) {
+            impulse[r] = -node.vector[r];
+            jointImpulseDelta = std::max(jointImpulseDelta, std::abs(impulse[r]));
+        }
+        node.joint->addArticulationImpulse(impulse);
+        node.joint->mVelocityImpulseDelta = jointImpulseDelta;
+        impulseDelta = std::max(impulseDelta, jointImpulseDelta);
+    }
+
+    return impulseDelta;
+}
+
+// Return true if a body can be moved by the joints of an articulation
+/// The static and kinematic bodies and the sleeping bodies that are used as fixed bodies
+/// by an island with the partial wake-up cannot be moved by the joints.
+/**
+ * @param body Pointer to the body
+ * @return True if the body is an awake dynamic body
+ */
+bool ArticulationSolver::isBodyMovable(const RigidBody* body) {
+    return body->getType() == BodyType::DYNAMIC && !body->isSleeping();
+}
+
+// Invert a square matrix with the Gauss-Jordan elimination
+/// The matrices are stored row by row. The input matrix is modified.
+/**
+ * @param matrix Matrix to invert
+ * @param inverse Inverse of the matrix
+ * @param size Number of rows of the matrix (at most six)
+ * @return False if the matrix is singular
+ */
+bool ArticulationSolver::invertMatrix(decimal* matrix, decimal* inverse, uint size) {
+
+    assert(size <= 6);
+
+    decimal largestElement = decimal(0.0);
+    for (uint i=0; i < size; i++) {
+        for (uint j=0; j < size; j++) {
+            largestElement = std::max(largestElement, std::abs(matrix[i * size + j]));
+            inverse[i * size + j] = (i == j) ? decimal(1.0) : decimal(0.0);
+        }
+    }
+
+    for (uint c=0; c < size; c++) {
+
+        // Find the pivot of the column
+        uint pivotRow = c;
+        for (uint r=c + 1; r < size; r++) {
+            if (std::abs(matrix[r * size + c]) > std::abs(matrix[pivotRow * size + c])) pivotRow = r;
+        }
+        const decimal pivot = matrix[pivotRow * size + c];
+        if (std::abs(pivot) <= SINGULAR_BLOCK_TOLERANCE * largestElement) return false;
+
+        // Swap the rows
+        if (pivotRow != c) {
+            for (uint j=0; j < size; j++) {
+                std::swap(matrix[c * size + j], matrix[pivotRow * size + j]);
+                std::swap(inverse[c * size + j], inverse[pivotRow * size + j]);
+            }
+        }
+
+        // Normalize the pivot row
+        const decimal pivotInverse = decimal(1.0) / pivot;
+        for (uint j=0; j < size; j++) {
+            matrix[c * size + j] *= pivotInverse;
+            inverse[c * size + j] *= pivotInverse;
+        }
+
+        // Eliminate the column in the other rows
+        for (uint r=0; r < size; r++) {
+
+            if (r == c) continue;
+
+            const decimal factor = matrix[r * size + c];
+            if (factor == decimal(0.0)) continue;
+
+            for (uint j=0; j < size; j++) {
+                matrix[r * size + j] -= factor * matrix[c * size + j];
+                inverse[r * size + j] -= factor * inverse[c * size + j];
+            }
+        }
+    }
+
+    return true;
+}
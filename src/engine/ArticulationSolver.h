@@ -0,0 +1,245 @@
+/********************************************************************************
+* ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
+* Copyright (c) 2010-2018 Daniel Chappuis                                       *
+*********************************************************************************
+*                                                                               *
+* This software is provided 'as-is', without any express or implied warranty.   *
+* In no event will the authors be held liable for any damages arising from the  *
+* use of this software.                                                         *
+*                                                                               *
+* Permission is granted to anyone to use this software for any purpose,         *
+* including commercial applications, and to alter it and redistribute it        *
+* freely, subject to the following restrictions:                                *
+*                                                                               *
+* 1. The origin of this software must not be misrepresented; you must not claim *
+*    that you wrote the original software. If you use this software in a        *
+*    product, an acknowledgment in the product documentation would be           *
+*    appreciated but is not required.                                           *
+*                                                                               *
+* 2. Altered source versions must be plainly marked as such, and must not be    *
+*    misrepresented as being the original software.                             *
+*                                                                               *
+* 3. This notice may not be removed or altered from any source distribution.    *
+*                                                                               *
+********************************************************************************/
+
+#ifndef REACTPHYSICS3D_ARTICULATION_SOLVER_H
+#define REACTPHYSICS3D_ARTICULATION_SOLVER_H
+
+// Libraries
+#include "configuration.h"
+#include "memory/ArenaAllocator.h"
+#include <cassert>
+
+namespace reactphysics3d {
+
+// Declarations
+class Joint;
+class RigidBody;
+class Island;
+class Profiler;
+class MemoryManager;
+struct ConstraintSolverData;
+
+// Structure ArticulationJointRows
+/**
+ * This structure contains the rows of the equality constraints of a joint of an
+ * articulation. The Jacobian of each body is stored row by row with six columns
+ * (three for the linear velocity and three for the angular velocity).
+ */
+struct ArticulationJointRows {
+
+    /// Number of rows of the constraints
+    uint nbRows;
+
+    /// Index of body 1 in the velocity arrays
+    uint indexBody1;
+
+    /// Index of body 2 in the velocity arrays
+    uint indexBody2;
+
+    /// Jacobian of the constraints for body 1
+    decimal jacobianBody1[36];
+
+    /// Jacobian of the constraints for body 2
+    decimal jacobianBody2[36];
+
+    /// Bias of the constraints
+    decimal bias[6];
+};
+
+// Structure ArticulationNode
+/**
+ * A node of the tree of an articulation. A node is either a dynamic body or a joint. The
+ * parent of a body is a joint and the parent of a joint is one of its two bodies.
+ */
+struct ArticulationNode {
+
+    /// Joint of the node (null for a body node)
+    Joint* joint;
+
+    /// Rows of the joint constraints (null for a body node)
+    ArticulationJointRows* rows;
+
+    /// Body of the node (null for a joint node)
+    RigidBody* body;
+
+    /// Index of the body in the velocity arrays (body node only)
+    uint indexBody;
+
+    /// Dimension of the node (six for a body and the number of rows for a joint)
+    uint dimension;
+
+    /// Index of the parent node in the nodes of the island (-1 for a root)
+    int parent;
+
+    /// Inverse of the diagonal block D of the factorization
+    decimal dInverse[36];
+
+    /// Block of the system between the node and its parent
+    decimal parentBlock[36];
+
+    /// Product L = D^-1 * parentBlock
+    decimal lBlock[36];
+
+    /// Temporary vector of the solve
+    decimal vector[6];
+};
+
+// Class ArticulationSolver
+/**
+ * This class solves exactly the velocity constraints of the joints of an island that form
+ * a tree (an articulation, like a robot arm or a chain) in a time linear in the number of
+ * joints. It is used instead of the sequential impulses when the articulation solver is
+ * enabled in the world settings.
+ *
+ * The joints are solved in maximal coordinates with the method described by David Baraff in
+ * "Linear-Time Dynamics using Lagrange Multipliers" (SIGGRAPH 1996) that gives the same
+ * velocities as a reduced coordinates (Featherstone) solver. The system
+ *
+ * | M  J^t | | deltaV |   | 0         |
+ * | J  0   | | -lambda| = | -Jv - b   |
+ *
+ * is sparse and its graph (the bodies and the joints) is a tree. Its blocks are eliminated
+ * from the leaves to the root so that the factorization has no fill-in.
+ *
+ * Only the equality constraints of the joints are part of an articulation. The ball-and-socket,
+ * fixed and hinge joints (without limits and motor) with at least one dynamic body are
+ * supported. The static and kinematic bodies are not part of the tree (they have an infinite
+ * mass) and each tree is attached to at most one of them by its root joint. The joints that
+ * would close a loop (between the bodies of a tree or through a second static body) and the
+ * other joints of the island are solved by the sequential impulses. The position errors are
+ * still corrected by the position solver of the joints.
+ */
+class ArticulationSolver {
+
+    private :
+
+        // -------------------- Constants -------------------- //
+
+        /// Relative tolerance used to detect a singular block during the factorization
+        static const decimal SINGULAR_BLOCK_TOLERANCE;
+
+        // -------------------- Attributes -------------------- //
+
+        /// World settings
+        const WorldSettings& mWorldSettings;
+
+        /// Memory arena used to allocate the articulations (reset at each step)
+        ArenaAllocator mArena;
+
+        /// Array of islands of the current step
+        Island** mIslands;
+
+        /// Number of islands of the current step
+        uint mNbIslands;
+
+        /// Nodes of the articulations of each island (ordered from the roots to the leaves)
+        ArticulationNode** mIslandsNodes;
+
+        /// Number of nodes of the articulations of each island
+        uint* mIslandsNbNodes;
+
+        /// True if the articulations of an island have already been built during this step
+        bool* mIsIslandBuilt;
+
+#ifdef IS_PROFILING_ACTIVE
+
+        /// Pointer to the profiler
+        Profiler* mProfiler;
+
+#endif
+
+        // -------------------- Methods -------------------- //
+
+        /// Build the trees of the articulations of an island
+        void buildArticulations(uint islandIndex);
+
+        /// Factorize the system of the articulations of an island
+        bool factorize(uint islandIndex);
+
+        /// Remove the joints of an island from the articulation solver
+        void clearArticulations(uint islandIndex);
+
+        /// Return true if a body can be moved by the joints of an articulation
+        static bool isBodyMovable(const RigidBody* body);
+
+        /// Invert a square matrix with the Gauss-Jordan elimination
+        static bool invertMatrix(decimal* matrix, decimal* inverse, uint size);
+
+    public :
+
+        // -------------------- Methods -------------------- //
+
+        /// Constructor
+        ArticulationSolver(MemoryManager& memoryManager, const WorldSettings& worldSettings);
+
+        /// Destructor
+        ~ArticulationSolver() = default;
+
+        /// Deleted copy-constructor
+        ArticulationSolver(const ArticulationSolver& solver) = delete;
+
+        /// Deleted assignment operator
+        ArticulationSolver& operator=(const ArticulationSolver& solver) = delete;
+
+        /// Initialize the solver for the islands of the current step
+        void init(Island** islands, uint nbIslands);
+
+        /// Initialize the articulations of an island (after the initialization of its joints)
+        void initializeForIsland(uint islandIndex);
+
+        /// Return true if an island has some joints solved by the articulation solver
+        bool hasArticulations(uint islandIndex) const;
+
+        /// Solve the velocity constraints of the articulations of an island and return the
+        /// largest change of impulse
+        decimal solveVelocityConstraints(uint islandIndex, const ConstraintSolverData& constraintSolverData);
+
+#ifdef IS_PROFILING_ACTIVE
+
+        /// Set the profiler
+        void setProfiler(Profiler* profiler);
+
+#endif
+
+};
+
+// Return true if an island has some joints solved by the articulation solver
+inline bool ArticulationSolver::hasArticulations(uint islandIndex) const {
+    assert(islandIndex < mNbIslands);
+    return mIslandsNbNodes != nullptr && mIslandsNbNodes[islandIndex] > 0;
+}
+
+#ifdef IS_PROFILING_ACTIVE
+
+// Set the profiler
+inline void ArticulationSolver::setProfiler(Profiler* profiler) {
+    mProfiler = profiler;
+}
+
+#endif
+
+}
+
+#endif
@@ -0,0 +1,378 @@
+/********************************************************************************
+* ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
+* Copyright (c) 2010-2018 Daniel Chappuis                                       *
+*********************************************************************************
+*                                                                               *
+* This software is provided 'as-is', without any express or implied warranty.   *
+* In no event will the authors be held liable for any damages arising from the  *
+* use of this software.                                                         *
+*                                                                               *
+* Permission is granted to anyone to use this software for any purpose,         *
+* including commercial applications, and to alter it and redistribute it        *
+* freely, subject to the following restrictions:                                *
+*                                                                               *
+* 1. The origin of this software must not be misrepresented; you must not claim *
+*    that you wrote the original software. If you use this software in a        *
+*    product, an acknowledgment in the product documentation would be           *
+*    appreciated but is not required.                                           *
+*                                                                               *
+* 2. Altered source versions must be plainly marked as such, and must not be    *
+*    misrepresented as being the original software.                             *
+*                                                                               *
+* 3. This notice may not be removed or altered from any source distribution.    *
+*                                                                               *
+********************************************************************************/
+
+// Libraries
+#include "CharacterController.h"
+#include "body/CollisionBody.h"
+#include "collision/ProxyShape.h"
+#include "collision/SweepInfo.h"
+#include "collision/shapes/TriangleShape.h"
+#include "memory/MemoryManager.h"
+#include "utils/Profiler.h"
+#include <cmath>
+
+using namespace reactphysics3d;
+
+// Initialization of static variables
+const decimal CharacterController::MIN_MOTION_LENGTH = decimal(0.0001);
+
+// Constructor
+/**
+ * @param settings The settings of the character controller
+ * @param position The position of the center of the capsule in world-space
+ * @param collisionDetection The collision detection of the world of the character
+ * @param memoryManager The memory manager of the world of the character
+ */
+CharacterController::CharacterController(const CharacterControllerSettings& settings, const Vector3& position,
+                                         CollisionDetection& collisionDetection, MemoryManager& memoryManager)
+                    : mSettings(settings), mCollisionDetection(collisionDetection),
+                      mShape(settings.radius, settings.height), mPosition(position),
+                      mMinGroundNormalY(std::cos(settings.maxSlopeAngle)), mIsOnGround(false),
+                      mIsTouchingCeiling(false), mIsTouchingWall(false), mGroundProxyShape(nullptr),
+                      mIsGroundTriangleCached(false),
+                      mCachedShapes(memoryManager.getPoolAllocator(MemoryTag::Containers)),
+                      mCachedFatAABBs(memoryManager.getPoolAllocator(MemoryTag::Containers)),
+                      mCachedFatAABBsVersion(0), mIsQueryCacheValid(false), mNbBroadPhaseQueries(0) {
+
+    assert(settings.contactOffset > decimal(0.0));
+    assert(settings.nbMaxSlideIterations > 0);
+
+#ifdef IS_PROFILING_ACTIVE
+    mProfiler = nullptr;
+#endif
+
+}
+
+// Move the character by a displacement
+/// The vertical part of the displacement (along the y axis) is applied by the up pass (if
+/// it is positive) or by the down pass (if it is negative) and the horizontal part by the
+/// side pass. The character only steps over the obstacles when it walks on the ground. The
+/// state of the ground is updated at the end of the move.
+/**
+ * @param displacement The displacement of the character in world-space
+ */
+void CharacterController::move(const Vector3& displacement) {
+
+    RP3D_PROFILE("CharacterController::move()", mProfiler);
+
+    const Vector3 up(0, 1, 0);
+    const decimal verticalDistance = displacement.y;
+    const Vector3 horizontalDisplacement(displacement.x, decimal(0.0), displacement.z);
+
+    mIsTouchingCeiling = false;
+    mIsTouchingWall = false;
+
+    decimal stepOffset = decimal(0.0);
+    if (mIsOnGround && verticalDistance <= decimal(0.0) &&
+        horizontalDisplacement.lengthSquare() > MIN_MOTION_LENGTH * MIN_MOTION_LENGTH) {
+        stepOffset = mSettings.stepHeight;
+    }
+
+    // Cache the proxy shapes around the largest distance that the capsule can travel during
+    // the move (the three passes, the ground probe and the contact offsets of the slides)
+    const decimal maxMoveDistance = displacement.length() + decimal(2.0) * mSettings.stepHeight +
+                                    mSettings.groundProbeDistance +
+                                    decimal(3 * mSettings.nbMaxSlideIterations + 2) * mSettings.contactOffset;
+    AABB region;
+    mShape.computeAABB(region, getTransform());
+    region.inflate(maxMoveDistance, maxMoveDistance, maxMoveDistance);
+    updateQueryCache(region);
+
+    // Lift the character (a ceiling reduces the height of the step)
+    const decimal startHeight = mPosition.y;
+    slide(up * (stepOffset + std::max(verticalDistance, decimal(0.0))), MovePass::Up);
+    stepOffset = std::min(stepOffset, std::max(mPosition.y - startHeight, decimal(0.0)));
+
+    // Move the character horizontally
+    slide(horizontalDisplacement, MovePass::Side);
+
+    // Put the character back down
+    slide(-up * (stepOffset + std::max(-verticalDistance, decimal(0.0))), MovePass::Down);
+
+    probeGround(verticalDistance <= decimal(0.0));
+}
+
+// Teleport the character at a new position (without sweeping the capsule)
+/**
+ * @param position The new position of the center of the capsule in world-space
+ */
+void CharacterController::setPosition(const Vector3& position) {
+    mPosition = position;
+    resetGround();
+}
+
+// Return the body of the ground
+/**
+ * @return A pointer to the body below the character (null if the character is not on the ground)
+ */
+CollisionBody* CharacterController::getGroundBody() const {
+    return mGroundProxyShape != nullptr ? mGroundProxyShape->getBody() : nullptr;
+}
+
+// Cache the proxy shapes around a region of the world if the cache does not contain it
+/// The cache is filled with a single broad-phase query and contains the proxy shapes whose
+/// fat AABBs overlap with the region inflated by the cache margin. It can be reused while the
+/// fat AABBs of the broad-phase have not changed because the query would give the same shapes.
+/**
+ * @param region The region of the world where the capsule can move
+ */
+void CharacterController::updateQueryCache(const AABB& region) {
+
+    const BroadPhaseAlgorithm* broadPhase = mCollisionDetection.mBroadPhaseAlgorithm;
+    const uint64 fatAABBsVersion = broadPhase->getFatAABBsVersion();
+    if (mIsQueryCacheValid && mCachedFatAABBsVersion == fatAABBsVersion && mCachedRegion.contains(region)) {
+        return;
+    }
+
+    RP3D_PROFILE("CharacterController::updateQueryCache()", mProfiler);
+
+    mCachedRegion = region;
+    mCachedRegion.inflate(mSettings.queryCacheMargin, mSettings.queryCacheMargin, mSettings.queryCacheMargin);
+    mCachedFatAABBsVersion = fatAABBsVersion;
+    mIsQueryCacheValid = true;
+    mNbBroadPhaseQueries++;
+
+    // Query the broad-phase
+    List<int> overlappingNodes(mCollisionDetection.mMemoryManager.getPoolAllocator(MemoryTag::NarrowPhase));
+    broadPhase->reportAllShapesOverlappingWithAABB(mCachedRegion, overlappingNodes);
+
+    mCachedShapes.clear();
+    mCachedFatAABBs.clear();
+    bool isGroundCached = false;
+    for (uint i=0; i < overlappingNodes.size(); i++) {
+
+        ProxyShape* proxyShape = broadPhase->getProxyShapeForBroadPhaseId(overlappingNodes[i]);
+        if ((proxyShape->getCollisionCategoryBits() & mSettings.collideWithMaskBits) == 0) continue;
+
+        mCachedShapes.add(proxyShape);
+        mCachedFatAABBs.add(broadPhase->getFatAABB(overlappingNodes[i]));
+        isGroundCached = isGroundCached || proxyShape == mGroundProxyShape;
+    }
+
+    // The ground of the last move is only kept if its proxy shape is still in the cache
+    if (!isGroundCached) {
+        resetGround();
+    }
+}
+
+// Sweep the capsule against the cached proxy shapes and return its earliest hit
+/// A proxy shape that the capsule overlaps at the beginning of the motion (or that the
+/// capsule moves away from) is ignored.
+/**
+ * @param startPosition Position of the center of the capsule at the beginning of the motion
+ * @param motion Displacement of the capsule
+ * @param[out] hit The earliest hit of the capsule
+ * @param[out] hitTriangle The hit triangle if the earliest hit proxy shape is concave (can be null)
+ * @return True if a proxy shape has been hit
+ */
+bool CharacterController::sweepCapsule(const Vector3& startPosition, const Vector3& motion, SweepInfo& hit,
+                                       SweepTriangleHit* hitTriangle) const {
+
+    const Transform startTransform(startPosition, Quaternion::identity());
+    const Transform endTransform(startPosition + motion, Quaternion::identity());
+    const AABB sweptAABB = CollisionDetection::computeSweptAABB(&mShape, startTransform, endTransform);
+
+    hit = SweepInfo();
+
+    for (uint i=0; i < mCachedShapes.size(); i++) {
+
+        if (!mCachedFatAABBs[i].testCollision(sweptAABB) || !mCachedShapes[i]->getBody()->isActive()) continue;
+
+        SweepInfo sweepInfo;
+        SweepTriangleHit triangle;
+        if (!mCollisionDetection.sweepProxyShape(&mShape, startTransform, endTransform, mCachedShapes[i],
+                                                 hit.hitFraction, sweepInfo, &triangle) ||
+            sweepInfo.worldNormal.dot(motion) >= decimal(0.0)) {
+            continue;
+        }
+
+        if (!hit.isHit() || sweepInfo.hitFraction < hit.hitFraction) {
+            hit = sweepInfo;
+            if (hitTriangle != nullptr) *hitTriangle = triangle;
+        }
+    }
+
+    return hit.isHit();
+}
+
+// Move the capsule and slide it along the surfaces it hits
+/// At each hit, the capsule is moved to the time of impact and pushed away from the surface
+/// by the contact offset (only upward on a walkable surface of the down pass). The rest of
+/// the motion is then projected on the surface. During the side pass, the steep surfaces
+/// are treated as vertical walls so that the character does not climb them. The down pass
+/// stops on the walkable surfaces (the character does not slide down the slopes it can
+/// stand on).
+/**
+ * @param motion The displacement of the capsule
+ * @param pass The pass of the move
+ */
+void CharacterController::slide(const Vector3& motion, MovePass pass) {
+
+    Vector3 remainingMotion = motion;
+
+    for (uint i=0; i < mSettings.nbMaxSlideIterations; i++) {
+
+        if (remainingMotion.lengthSquare() < MIN_MOTION_LENGTH * MIN_MOTION_LENGTH) return;
+
+        SweepInfo hit;
+        if (!sweepCapsule(mPosition, remainingMotion, hit, nullptr)) {
+            mPosition += remainingMotion;
+            return;
+        }
+
+        Vector3 normal = hit.worldNormal;
+        mPosition += remainingMotion * hit.hitFraction;
+        remainingMotion *= decimal(1.0) - hit.hitFraction;
+
+        if (isWalkable(normal)) {
+
+            // The capsule is pushed up (and not along the normal) so that it does not slide down
+            if (pass == MovePass::Down) {
+                mPosition.y += mSettings.contactOffset / normal.y;
+                return;
+            }
+
+            mPosition += normal * mSettings.contactOffset;
+        }
+        else if (normal.y <= -mMinGroundNormalY) {
+            mPosition += normal * mSettings.contactOffset;
+            mIsTouchingCeiling = true;
+        }
+        else {
+            mPosition += normal * mSettings.contactOffset;
+            mIsTouchingWall = true;
+
+            // A steep surface blocks the horizontal motion like a vertical wall
+            if (pass == MovePass::Side) {
+                normal.y = decimal(0.0);
+                if (normal.lengthSquare() < MACHINE_EPSILON) return;
+                normal.normalize();
+            }
+        }
+
+        // Remove the part of the motion toward the surface
+        const decimal normalMotion = remainingMotion.dot(normal);
+        if (normalMotion < decimal(0.0)) {
+            remainingMotion -= normalMotion * normal;
+        }
+    }
+}
+
+// Search the ground below the capsule and snap the capsule to it if needed
+/// The ground of the last move is swept first (only its cached triangle if it is concave).
+/// If it is hit, the probe against the cached proxy shapes is shortened to its time of
+/// impact (with a small margin). If the shortened probe does not find anything because of
+/// the tolerance of the times of impact, the whole probe is swept again.
+/**
+ * @param isSnappingEnabled True if the capsule is moved down to the ground that is found
+ */
+void CharacterController::probeGround(bool isSnappingEnabled) {
+
+    RP3D_PROFILE("CharacterController::probeGround()", mProfiler);
+
+    const decimal probeDistance = mSettings.groundProbeDistance + mSettings.contactOffset;
+    const Vector3 probeMotion(decimal(0.0), -probeDistance, decimal(0.0));
+
+    // Sweep the ground of the last move
+    decimal probeFraction = decimal(1.0);
+    if (mGroundProxyShape != nullptr && mGroundProxyShape->getBody()->isActive()) {
+
+        const Transform startTransform(mPosition, Quaternion::identity());
+        const Transform endTransform(mPosition + probeMotion, Quaternion::identity());
+        decimal fraction;
+        bool isHit;
+        if (mIsGroundTriangleCached) {
+            const Transform groundToWorld = mGroundProxyShape->getLocalToWorldTransform();
+            TriangleShape triangleShape(mGroundTriangle.vertices, mGroundTriangle.verticesNormals,
+                                        mGroundTriangle.shapeId);
+            Vector3 normal;
+            isHit = mCollisionDetection.mGJKAlgorithm.computeTimeOfImpact(&mShape, startTransform, endTransform,
+                                                                         &triangleShape, groundToWorld, groundToWorld,
+                                                                         fraction, normal) &&
+                    normal.y < decimal(0.0);
+        }
+        else {
+            SweepInfo sweepInfo;
+            isHit = mCollisionDetection.sweepProxyShape(&mShape, startTransform, endTransform, mGroundProxyShape,
+                                                        decimal(1.0), sweepInfo) &&
+                    sweepInfo.worldNormal.y > decimal(0.0);
+            fraction = sweepInfo.hitFraction;
+        }
+
+        if (isHit) {
+            probeFraction = std::min(fraction + mSettings.contactOffset / probeDistance, decimal(1.0));
+        }
+    }
+
+    // Sweep the cached proxy shapes
+    SweepInfo hit;
+    SweepTriangleHit hitTriangle;
+    bool isHit = sweepCapsule(mPosition, probeMotion * probeFraction, hit, &hitTriangle);
+    if (isHit) {
+        hit.hitFraction *= probeFraction;
+    }
+    else if (probeFraction < decimal(1.0)) {
+        isHit = sweepCapsule(mPosition, probeMotion, hit, &hitTriangle);
+    }
+
+    if (!isHit || !isWalkable(hit.worldNormal)) {
+        resetGround();
+        return;
+    }
+
+    mIsOnGround = true;
+    mGroundNormal = hit.worldNormal;
+    mGroundPoint = hit.worldPoint;
+    mGroundProxyShape = hit.proxyShape;
+    const ProxyShape* groundProxyShape = hit.proxyShape;
+    mIsGroundTriangleCached = groundProxyShape->getCollisionShape()->getType() == CollisionShapeType::CONCAVE_SHAPE;
+    if (mIsGroundTriangleCached) {
+        mGroundTriangle = hitTriangle;
+    }
+
+    if (isSnappingEnabled) {
+        mPosition += probeMotion * hit.hitFraction;
+        mPosition.y += mSettings.contactOffset / hit.worldNormal.y;
+    }
+}
+
+// Forget the ground of the last move
+void CharacterController::resetGround() {
+    mIsOnGround = false;
+    mGroundNormal.setToZero();
+    mGroundPoint.setToZero();
+    mGroundProxyShape = nullptr;
+    mIsGroundTriangleCached = false;
+}
+
+// Move the character by the opposite of the displacement of the origin of the world
+/**
+ * @param shift The displacement of the origin of the world
+ */
+void CharacterController::shiftOrigin(const Vector3& shift) {
+    mPosition -= shift;
+    mGroundPoint -= shift;
+    mIsQueryCacheValid = false;
+}
@@ -0,0 +1,375 @@
+/********************************************************************************
+* ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
+* Copyright (c) 2010-2018 Daniel Chappuis                                       *
+*********************************************************************************
+*                                                                               *
+* This software is provided 'as-is', without any express or implied warranty.   *
+* In no event will the authors be held liable for any damages arising from the  *
+* use of this software.                                                         *
+*                                                                               *
+* Permission is granted to anyone to use this software for any purpose,         *
+* including commercial applications, and to alter it and redistribute it        *
+* freely, subject to the following restrictions:                                *
+*                                                                               *
+* 1. The origin of this software must not be misrepresented; you must not claim *
+*    that you wrote the original software. If you use this software in a        *
+*    product, an acknowledgment in the product documentation would be           *
+*    appreciated but is not required.                                           *
+*                                                                               *
+* 2. Altered source versions must be plainly marked as such, and must not be    *
+*    misrepresented as being the original software.                             *
+*                                                                               *
+* 3. This notice may not be removed or altered from any source distribution.    *
+*                                                                               *
+********************************************************************************/
+
+#ifndef REACTPHYSICS3D_CHARACTER_CONTROLLER_H
+#define REACTPHYSICS3D_CHARACTER_CONTROLLER_H
+
+// Libraries
+#include "configuration.h"
+#include "mathematics/mathematics.h"
+#include "collision/shapes/CapsuleShape.h"
+#include "collision/shapes/AABB.h"
+#include "collision/CollisionDetection.h"
+#include "containers/List.h"
+
+/// ReactPhysics3D namespace
+namespace reactphysics3d {
+
+// Class declarations
+class CollisionBody;
+class ProxyShape;
+class MemoryManager;
+class Profiler;
+struct SweepInfo;
+
+// Structure CharacterControllerSettings
+/**
+ * This structure contains the settings of a character controller. The character is a
+ * capsule whose axis is the up axis of the world (the y axis).
+ */
+struct CharacterControllerSettings {
+
+    /// Radius of the capsule of the character (in meters)
+    decimal radius = decimal(0.3);
+
+    /// Distance between the centers of the two hemispheres of the capsule (in meters)
+    decimal height = decimal(1.2);
+
+    /// Largest height of an obstacle that the character steps over when it walks (in meters)
+    decimal stepHeight = decimal(0.3);
+
+    /// Largest angle between a surface and the horizontal plane for the character to stand
+    /// on it (in radians). The steeper surfaces block the character like walls.
+    decimal maxSlopeAngle = PI / decimal(4.0);
+
+    /// Distance kept between the capsule and the surfaces it touches (in meters)
+    decimal contactOffset = decimal(0.01);
+
+    /// Distance below the capsule where the ground is searched at the end of a move (in meters)
+    decimal groundProbeDistance = decimal(0.1);
+
+    /// Margin added around the region of a move when the shapes around the character are
+    /// cached (in meters). A larger margin gives less broad-phase queries but more shapes
+    /// to filter at each sweep.
+    decimal queryCacheMargin = decimal(1.0);
+
+    /// Largest number of sweeps of each pass of a move (the motion slides along the surfaces it hits)
+    uint nbMaxSlideIterations = 4;
+
+    /// Bits mask of the collision categories of the proxy shapes that block the character
+    collisionmask collideWithMaskBits = ALL_COLLISION_CATEGORIES;
+};
+
+// Class CharacterController
+/**
+ * This class moves a kinematic character (a capsule) through the proxy shapes of a
+ * collision world. The character is not a body of the world: it is never pushed by the
+ * bodies and it does not push them. Each move slides the capsule along the surfaces it
+ * hits in three passes: an up pass that lifts the character by the step height when it
+ * walks on the ground, a side pass with the horizontal motion and a down pass that puts
+ * the character back down (this is how it climbs the steps). The ground is then probed
+ * below the capsule and the character is snapped to it if it does not move up.
+ *
+ * All the sweeps of a move are computed against a cache of the proxy shapes around the
+ * character instead of querying the broad-phase for each sweep. The cache is the result
+ * of a single broad-phase query with a region larger than the move and it is reused by
+ * the next moves as long as they stay in this region and no fat AABB of the broad-phase
+ * has changed. The ground proxy shape (and the triangle of a concave ground) is also
+ * kept between the moves and swept first by the ground probe. Its time of impact
+ * shortens the probe against the other shapes (a concave shape then only tests the
+ * triangles close to the character). The shapes that the capsule already overlaps at
+ * the beginning of a sweep are ignored so that the character can move out of them.
+ */
+class CharacterController {
+
+    private:
+
+        // -------------------- Types -------------------- //
+
+        /// Pass of a move
+        enum class MovePass {Up, Side, Down};
+
+        // -------------------- Constants -------------------- //
+
+        /// Length of a motion below which the capsule is not swept anymore
+        static const decimal MIN_MOTION_LENGTH;
+
+        // -------------------- Attributes -------------------- //
+
+        /// Settings of the character controller
+        CharacterControllerSettings mSettings;
+
+        /// Collision detection of the world (used to sweep the capsule against the proxy shapes)
+        CollisionDetection& mCollisionDetection;
+
+        /// Capsule shape of the character
+        CapsuleShape mShape;
+
+        /// Position of the center of the capsule in world-space
+        Vector3 mPosition;
+
+        /// Smallest up component of the normal of a surface on which the character can stand
+        decimal mMinGroundNormalY;
+
+        /// True if the character has stood on the ground at the end of the last move
+        bool mIsOnGround;
+
+        /// True if the character has hit a ceiling during the last move
+        bool mIsTouchingCeiling;
+
+        /// True if the character has hit a wall (or a steep slope) during the last move
+        bool mIsTouchingWall;
+
+        /// Normal of the ground at the end of the last move
+        Vector3 mGroundNormal;
+
+        /// Contact point with the ground at the end of the last move
+        Vector3 mGroundPoint;
+
+        /// Proxy shape of the ground at the end of the last move (null if not on the ground)
+        ProxyShape* mGroundProxyShape;
+
+        /// True if the ground proxy shape is concave and its hit triangle is cached
+        bool mIsGroundTriangleCached;
+
+        /// Triangle of the concave ground proxy shape at the end of the last move
+        SweepTriangleHit mGroundTriangle;
+
+        /// Cached proxy shapes whose fat AABBs overlap with the cached region
+        List<ProxyShape*> mCachedShapes;
+
+        /// Fat AABBs of the cached proxy shapes
+        List<AABB> mCachedFatAABBs;
+
+        /// Region of the world of the cached proxy shapes
+        AABB mCachedRegion;
+
+        /// Version of the fat AABBs of the broad-phase when the proxy shapes have been cached
+        uint64 mCachedFatAABBsVersion;
+
+        /// True if the cached proxy shapes can be used
+        bool mIsQueryCacheValid;
+
+        /// Number of broad-phase queries made to fill the cache
+        uint mNbBroadPhaseQueries;
+
+#ifdef IS_PROFILING_ACTIVE
+
+        /// Pointer to the profiler
+        Profiler* mProfiler;
+
+#endif
+
+        // -------------------- Methods -------------------- //
+
+        /// Cache the proxy shapes around a region of the world if the cache does not contain it
+        void updateQueryCache(const AABB& region);
+
+        /// Sweep the capsule against the cached proxy shapes and return its earliest hit
+        bool sweepCapsule(const Vector3& startPosition, const Vector3& motion, SweepInfo& hit,
+                          SweepTriangleHit* hitTriangle) const;
+
+        /// Move the capsule and slide it along the surfaces it hits
+        void slide(const Vector3& motion, MovePass pass);
+
+        /// Search the ground below the capsule and snap the capsule to it if needed
+        void probeGround(bool isSnappingEnabled);
+
+        /// Forget the ground of the last move
+        void resetGround();
+
+        /// Return true if the character can stand on a surface with a given normal
+        bool isWalkable(const Vector3& normal) const;
+
+        /// Move the character by the opposite of the displacement of the origin of the world
+        void shiftOrigin(const Vector3& shift);
+
+#ifdef IS_PROFILING_ACTIVE
+
+        /// Set the profiler
+        void setProfiler(Profiler* profiler);
+
+#endif
+
+    public:
+
+        // -------------------- Methods -------------------- //
+
+        /// Constructor
+        CharacterController(const CharacterControllerSettings& settings, const Vector3& position,
+                            CollisionDetection& collisionDetection, MemoryManager& memoryManager);
+
+        /// Destructor
+        ~CharacterController() = default;
+
+        /// Deleted copy-constructor
+        CharacterController(const CharacterController& controller) = delete;
+
+        /// Deleted assignment operator
+        CharacterController& operator=(const CharacterController& controller) = delete;
+
+        /// Move the character by a displacement
+        void move(const Vector3& displacement);
+
+        /// Return the position of the center of the capsule in world-space
+        const Vector3& getPosition() const;
+
+        /// Teleport the character at a new position (without sweeping the capsule)
+        void setPosition(const Vector3& position);
+
+        /// Return the local-to-world transform of the capsule
+        Transform getTransform() const;
+
+        /// Return the capsule shape of the character
+        const CapsuleShape& getShape() const;
+
+        /// Return true if the character stands on the ground
+        bool isOnGround() const;
+
+        /// Return true if the character has hit a ceiling during the last move
+        bool isTouchingCeiling() const;
+
+        /// Return true if the character has hit a wall during the last move
+        bool isTouchingWall() const;
+
+        /// Return the normal of the ground
+        const Vector3& getGroundNormal() const;
+
+        /// Return the contact point with the ground
+        const Vector3& getGroundPoint() const;
+
+        /// Return the proxy shape of the ground
+        ProxyShape* getGroundProxyShape() const;
+
+        /// Return the body of the ground
+        CollisionBody* getGroundBody() const;
+
+        /// Forget the cached proxy shapes (the next move queries the broad-phase again)
+        void invalidateQueryCache();
+
+        /// Return the number of broad-phase queries made to cache the proxy shapes
+        uint getNbBroadPhaseQueries() const;
+
+        /// Return the settings of the character controller
+        const CharacterControllerSettings& getSettings() const;
+
+        // -------------------- Friendship -------------------- //
+
+        friend class CollisionWorld;
+};
+
+// Return the position of the center of the capsule in world-space
+inline const Vector3& CharacterController::getPosition() const {
+    return mPosition;
+}
+
+// Return the local-to-world transform of the capsule
+inline Transform CharacterController::getTransform() const {
+    return Transform(mPosition, Quaternion::identity());
+}
+
+// Return the capsule shape of the character
+inline const CapsuleShape& CharacterController::getShape() const {
+    return mShape;
+}
+
+// Return true if the character stands on the ground
+/**
+ * @return True if a walkable surface has been found below the capsule at the end of the last move
+ */
+inline bool CharacterController::isOnGround() const {
+    return mIsOnGround;
+}
+
+// Return true if the character has hit a ceiling during the last move
+inline bool CharacterController::isTouchingCeiling() const {
+    return mIsTouchingCeiling;
+}
+
+// Return true if the character has hit a wall during the last move
+/**
+ * @return True if the character has hit a surface that is too steep to stand on
+ */
+inline bool CharacterController::isTouchingWall() const {
+    return mIsTouchingWall;
+}
+
+// Return the normal of the ground
+/**
+ * @return The unit normal of the ground in world-space (only valid if isOnGround() is true)
+ */
+inline const Vector3& CharacterController::getGroundNormal() const {
+    return mGroundNormal;
+}
+
+// Return the contact point with the ground
+/**
+ * @return The contact point in world-space (only valid if isOnGround() is true)
+ */
+inline const Vector3& CharacterController::getGroundPoint() const {
+    return mGroundPoint;
+}
+
+// Return the proxy shape of the ground
+/**
+ * @return A pointer to the proxy shape below the character (null if the character is not on the ground)
+ */
+inline ProxyShape* CharacterController::getGroundProxyShape() const {
+    return mGroundProxyShape;
+}
+
+// Forget the cached proxy shapes (the next move queries the broad-phase again)
+inline void CharacterController::invalidateQueryCache() {
+    mIsQueryCacheValid = false;
+}
+
+// Return the number of broad-phase queries made to cache the proxy shapes
+inline uint CharacterController::getNbBroadPhaseQueries() const {
+    return mNbBroadPhaseQueries;
+}
+
+// Return the settings of the character controller
+inline const CharacterControllerSettings& CharacterController::getSettings() const {
+    return mSettings;
+}
+
+// Return true if the character can stand on a surface with a given normal
+inline bool CharacterController::isWalkable(const Vector3& normal) const {
+    return normal.y >= mMinGroundNormalY;
+}
+
+#ifdef IS_PROFILING_ACTIVE
+
+// Set the profiler
+inline void CharacterController::setProfiler(Profiler* profiler) {
+    mProfiler = profiler;
+    mShape.setProfiler(profiler);
+}
+
+#endif
+
+}
+
+#endif
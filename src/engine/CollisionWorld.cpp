@@ -33,23 +33,28 @@ using namespace reactphysics3d;
 using namespace std;
 
 // Initialization of static fields
-uint CollisionWorld::mNbWorlds = 0;
+std::atomic<uint> CollisionWorld::mNbWorlds(0);
 
 // Constructor
 CollisionWorld::CollisionWorld(const WorldSettings& worldSettings, Logger* logger, Profiler* profiler)
-               : mConfig(worldSettings), mCollisionDetection(this, mMemoryManager), mBodies(mMemoryManager.getPoolAllocator()), mCurrentBodyId(0),
-                 mFreeBodiesIds(mMemoryManager.getPoolAllocator()), mEventListener(nullptr), mName(worldSettings.worldName),
+               : mMemoryManager(worldSettings.baseAllocator, worldSettings.poolAllocator, worldSettings.singleFrameAllocator),
+                 mConfig(worldSettings), mCollisionDetection(this, mMemoryManager), mBodies(mMemoryManager.getPoolAllocator(MemoryTag::Containers)),
+                 mCharacterControllers(mMemoryManager.getPoolAllocator(MemoryTag::Containers)),
+                 mBodyIdAllocator(mMemoryManager.getPoolAllocator(MemoryTag::Containers)), mEventListener(nullptr), mName(worldSettings.worldName),
+                 mQuerySnapshot(MemoryManager::getBaseAllocator()),
                  mIsProfilerCreatedByUser(profiler != nullptr),
                  mIsLoggerCreatedByUser(logger != nullptr) {
 
+    const uint worldIndex = mNbWorlds++;
+
     // Automatically generate a name for the world
     if (mName == "") {
 
         std::stringstream ss;
         ss << "world";
 
-        if (mNbWorlds > 0) {
-            ss << mNbWorlds;
+        if (worldIndex > 0) {
+            ss << worldIndex;
         }
 
         mName = ss.str();
@@ -71,6 +76,7 @@ CollisionWorld::CollisionWorld(const WorldSettings& worldSettings, Logger* logge
 
     // Set the profiler
     mCollisionDetection.setProfiler(mProfiler);
+    mQuerySnapshot.setProfiler(mProfiler);
 
 #endif
 
@@ -91,8 +97,6 @@ CollisionWorld::CollisionWorld(const WorldSettings& worldSettings, Logger* logge
 
 #endif
 
-    mNbWorlds++;
-
     RP3D_LOG(mLogger, Logger::Level::Information, Logger::Category::World,
              "Collision World: Collision world " + mName + " has been created");
     RP3D_LOG(mLogger, Logger::Level::Information, Logger::Category::World,
@@ -105,6 +109,11 @@ CollisionWorld::~CollisionWorld() {
     RP3D_LOG(mLogger, Logger::Level::Information, Logger::Category::World,
              "Collision World: Collision world " + mName + " has been destroyed");
 
+    // Destroy all the character controllers that have not been removed
+    for (int i=mCharacterControllers.size() - 1; i >= 0; i--) {
+        destroyCharacterController(mCharacterControllers[i]);
+    }
+
     // Destroy all the collision bodies that have not been removed
     for (int i=mBodies.size() - 1 ; i >= 0; i--) {
         destroyCollisionBody(mBodies[i]);
@@ -129,6 +138,7 @@ CollisionWorld::~CollisionWorld() {
 #endif
 
     assert(mBodies.size() == 0);
+    assert(mCharacterControllers.size() == 0);
 }
 
 // Create a collision body and add it to the world
@@ -139,20 +149,20 @@ CollisionWorld::~CollisionWorld() {
 CollisionBody* CollisionWorld::createCollisionBody(const Transform& transform) {
 
     // Get the next available body ID
-    bodyindex bodyID = computeNextAvailableBodyId();
+    bodyindex bodyID = mBodyIdAllocator.allocate();
 
     // Largest index cannot be used (it is used for invalid index)
     assert(bodyID < std::numeric_limits<reactphysics3d::bodyindex>::max());
 
     // Create the collision body
     CollisionBody* collisionBody = new (mMemoryManager.allocate(MemoryManager::AllocationType::Pool,
-                                        sizeof(CollisionBody)))
+                                        sizeof(CollisionBody), MemoryTag::Bodies))
                                         CollisionBody(transform, *this, bodyID);
 
     assert(collisionBody != nullptr);
 
     // Add the collision body to the world
-    mBodies.add(collisionBody);
+    addBody(collisionBody);
 
 #ifdef IS_PROFILING_ACTIVE
 
@@ -183,37 +193,94 @@ void CollisionWorld::destroyCollisionBody(CollisionBody* collisionBody) {
     // Remove all the collision shapes of the body
     collisionBody->removeAllCollisionShapes();
 
-    // Add the body ID to the list of free IDs
-    mFreeBodiesIds.add(collisionBody->getId());
+    // Release the body ID
+    mBodyIdAllocator.release(collisionBody->getId());
 
     // Reset the contact manifold list of the body
     collisionBody->resetContactManifoldsList();
 
+    // Remove the collision body from the list of bodies
+    removeBody(collisionBody);
+
     // Call the destructor of the collision body
     collisionBody->~CollisionBody();
 
-    // Remove the collision body from the list of bodies
-    mBodies.remove(collisionBody);
-
     // Free the object from the memory allocator
-    mMemoryManager.release(MemoryManager::AllocationType::Pool, collisionBody, sizeof(CollisionBody));
+    mMemoryManager.release(MemoryManager::AllocationType::Pool, collisionBody, sizeof(CollisionBody), MemoryTag::Bodies);
 }
 
-// Return the next available body ID
-bodyindex CollisionWorld::computeNextAvailableBodyId() {
+// Create a character controller at a given position
+/**
+ * @param position The position of the center of the capsule of the character in world-space
+ * @param settings The settings of the character controller
+ * @return A pointer to the character controller that has been created
+ */
+CharacterController* CollisionWorld::createCharacterController(const Vector3& position,
+                                                               const CharacterControllerSettings& settings) {
+
+    CharacterController* characterController =
+            new (mMemoryManager.allocate(MemoryManager::AllocationType::Pool, sizeof(CharacterController),
+                                         MemoryTag::Bodies))
+            CharacterController(settings, position, mCollisionDetection, mMemoryManager);
+
+#ifdef IS_PROFILING_ACTIVE
+    characterController->setProfiler(mProfiler);
+#endif
+
+    mCharacterControllers.add(characterController);
 
-    // Compute the body ID
-    bodyindex bodyID;
-    if (mFreeBodiesIds.size() != 0) {
-        bodyID = mFreeBodiesIds[mFreeBodiesIds.size() - 1];
-        mFreeBodiesIds.removeAt(mFreeBodiesIds.size() - 1);
+    RP3D_LOG(mLogger, Logger::Level::Information, Logger::Category::World,
+             "Collision World: New character controller created");
+
+    return characterController;
+}
+
+// Destroy a character controller
+/**
+ * @param characterController Pointer to the character controller to destroy
+ */
+void CollisionWorld::destroyCharacterController(CharacterController* characterController) {
+
+    // Remove the character controller from the list (the last one is moved at its index)
+    const uint lastIndex = mCharacterControllers.size() - 1;
+    for (uint i=0; i <= lastIndex; i++) {
+        if (mCharacterControllers[i] == characterController) {
+            mCharacterControllers[i] = mCharacterControllers[lastIndex];
+            mCharacterControllers.removeAt(lastIndex);
+            break;
+        }
     }
-    else {
-        bodyID = mCurrentBodyId;
-        mCurrentBodyId++;
+
+    characterController->~CharacterController();
+    mMemoryManager.release(MemoryManager::AllocationType::Pool, characterController,
+                           sizeof(CharacterController), MemoryTag::Bodies);
+
+    RP3D_LOG(mLogger, Logger::Level::Information, Logger::Category::World,
+             "Collision World: Character controller destroyed");
+}
+
+// Add a body into the list of bodies of the world
+void CollisionWorld::addBody(CollisionBody* body) {
+
+    body->mWorldIndex = static_cast<uint>(mBodies.size());
+    mBodies.add(body);
+}
+
+// Remove a body from the list of bodies of the world
+/// The last body of the list is moved at the index of the removed body so that the
+/// removal is done in constant time
+void CollisionWorld::removeBody(CollisionBody* body) {
+
+    const uint index = body->mWorldIndex;
+    const uint lastIndex = static_cast<uint>(mBodies.size()) - 1;
+    assert(mBodies[index] == body);
+
+    if (index != lastIndex) {
+        mBodies[index] = mBodies[lastIndex];
+        mBodies[index]->mWorldIndex = index;
     }
 
-    return bodyID;
+    mBodies.removeAt(lastIndex);
 }
 
 // Reset all the contact manifolds linked list of each body
@@ -247,13 +314,34 @@ bool CollisionWorld::testAABBOverlap(const CollisionBody* body1,
     return body1AABB.testCollision(body2AABB);
 }
 
+// Compute the collision detection of the world without any simulation
+/// Unlike testCollision(), the overlapping pairs of the proxy shapes are kept from one update to
+/// the next with their contact manifolds and the collision information of the previous frame
+/// used by the narrow-phase algorithms for temporal coherence. After the update, the contact
+/// manifolds of the world (see getContactManifolds()) and of the bodies and the contact events
+/// (see getContactEvents()) are those of this update and the contacts are reported to the event
+/// listener. The bodies are only moved by the user. A DynamicsWorld computes its collision
+/// detection during DynamicsWorld::update() and does not need this method.
+void CollisionWorld::update() {
+
+    RP3D_PROFILE("CollisionWorld::update()", mProfiler);
+
+    // Reset all the contact manifolds lists of each body
+    resetContactManifoldListsOfBodies();
+
+    mCollisionDetection.computeCollisionDetection();
+
+    // Reset the single frame memory allocator
+    mMemoryManager.resetFrameAllocator();
+}
+
 // Report all the bodies which have an AABB that overlaps with the AABB in parameter
 /**
  * @param aabb AABB used to test for overlap
  * @param overlapCallback Pointer to the callback class to report overlap
  * @param categoryMaskBits bits mask used to filter the bodies to test overlap with
  */
-void CollisionWorld::testAABBOverlap(const AABB& aabb, OverlapCallback* overlapCallback, unsigned short categoryMaskBits) {
+void CollisionWorld::testAABBOverlap(const AABB& aabb, OverlapCallback* overlapCallback, collisionmask categoryMaskBits) {
     mCollisionDetection.testAABBOverlap(aabb, overlapCallback, categoryMaskBits);
 }
 
@@ -274,9 +362,74 @@ bool CollisionWorld::testOverlap(CollisionBody* body1, CollisionBody* body2) {
  */
 AABB CollisionWorld::getWorldAABB(const ProxyShape* proxyShape) const {
 
-    if (proxyShape->getBroadPhaseId() == -1) {
+    if (!proxyShape->isInCollisionDetection()) {
         return AABB();
     }
 
    return mCollisionDetection.getWorldAABB(proxyShape);
 }
+
+// Move the origin of the world-space coordinates to an absolute position
+/// The engine stores the positions of the bodies, the AABBs of the broad-phase and the
+/// contacts in decimal precision relative to the origin of the world. In a large world, the
+/// origin can be moved close to the simulated bodies to keep single precision accurate far
+/// from the absolute origin while only this absolute position is stored in double precision.
+/// All the bodies keep their absolute positions, their velocities and their contacts (the
+/// contact points are stored in the local-spaces of the shapes). The whole world is moved in
+/// one pass: the fat AABBs of the broad-phase are translated in place and the shapes are
+/// neither reinserted nor tested again for overlapping pairs. The displacement of the origin
+/// is rounded to decimal precision so that the origin might be slightly different from the
+/// given position. This method must not be called while an asynchronous step of a dynamics
+/// world is running.
+/**
+ * @param origin The new absolute position of the origin of the world
+ */
+void CollisionWorld::setOrigin(const WorldPosition& origin) {
+
+    // Displacement of the origin in the current world-space coordinates. The origin is moved
+    // by the rounded displacement, which is the displacement applied to the bodies.
+    const Vector3 shift = origin - mOrigin;
+    mOrigin = mOrigin + shift;
+
+    if (shift == Vector3::zero()) return;
+
+    // Move all the bodies in the new world-space coordinates
+    for (uint i=0; i < mBodies.size(); i++) {
+        mBodies[i]->shiftOrigin(shift);
+    }
+    for (uint i=0; i < mCharacterControllers.size(); i++) {
+        mCharacterControllers[i]->shiftOrigin(shift);
+    }
+
+    // Move the fat AABBs of the broad-phase in place (without reinserting the shapes and
+    // without computing the overlapping pairs again)
+    mCollisionDetection.shiftOrigin(shift);
+
+    RP3D_LOG(mLogger, Logger::Level::Information, Logger::Category::World,
+             "Collision World: Set origin=" + mOrigin.to_string());
+}
+
+// Allocate the memory needed to store a given number of objects in the world
+/// The arrays of the world, the nodes of the broad-phase tree and the pool allocator are
+/// presized so that the objects can be created and the pairs reported without growing them.
+/**
+ * @param capacities The number of objects that the world is expected to contain
+ */
+void CollisionWorld::reserve(const WorldCapacities& capacities) {
+
+    mBodies.reserve(capacities.nbBodies);
+    mBodyIdAllocator.reserve(capacities.nbBodies);
+    mMemoryManager.reservePoolMemory(sizeof(CollisionBody), capacities.nbBodies);
+
+    reserveCollisionCapacities(capacities);
+}
+
+// Allocate the memory of the proxy shapes, pairs and contacts of the world
+void CollisionWorld::reserveCollisionCapacities(const WorldCapacities& capacities) {
+
+    mCollisionDetection.reserveProxyShapes(capacities.nbProxyShapes);
+    mMemoryManager.reservePoolMemory(sizeof(ProxyShape), capacities.nbProxyShapes);
+
+    mCollisionDetection.reservePairs(capacities.nbOverlappingPairs);
+    mCollisionDetection.reserveContactManifolds(capacities.nbContactManifolds);
+}
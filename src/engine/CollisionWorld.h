@@ -29,9 +29,14 @@
 // Libraries
 #include "mathematics/mathematics.h"
 #include "containers/List.h"
+#include "containers/IdAllocator.h"
 #include "collision/CollisionDetection.h"
+#include "collision/SceneQuerySnapshot.h"
+#include "collision/DistanceInfo.h"
 #include "constraint/Joint.h"
+#include "engine/CharacterController.h"
 #include "memory/MemoryManager.h"
+#include <atomic>
 
 /// Namespace reactphysics3d
 namespace reactphysics3d {
@@ -45,9 +50,34 @@ class ContactPoint;
 class OverlappingPair;
 class CollisionBody;
 struct RaycastInfo;
+struct RaycastHit;
+class SweepCallback;
+struct SweepInfo;
+struct OverlapHit;
 class CollisionCallback;
+struct ContactHit;
 class OverlapCallback;
 
+// Structure WorldCapacities
+/**
+ * This structure contains the number of objects that a world is expected to contain. It is
+ * used to allocate the memory of the world up-front (see CollisionWorld::reserve()).
+ */
+struct WorldCapacities {
+
+    /// Number of bodies
+    uint nbBodies = 0;
+
+    /// Number of proxy shapes
+    uint nbProxyShapes = 0;
+
+    /// Number of overlapping pairs
+    uint nbOverlappingPairs = 0;
+
+    /// Number of contact manifolds
+    uint nbContactManifolds = 0;
+};
+
 // Class CollisionWorld
 /**
  * This class represent a world where it is possible to move bodies
@@ -72,11 +102,11 @@ class CollisionWorld {
         /// All the bodies (rigid and soft) of the world
         List<CollisionBody*> mBodies;
 
-        /// Current body id
-        bodyindex mCurrentBodyId;
+        /// All the character controllers of the world
+        List<CharacterController*> mCharacterControllers;
 
-        /// List of free ids for rigid bodies
-        List<luint> mFreeBodiesIds;
+        /// Allocator of the body ids
+        IdAllocator mBodyIdAllocator;
 
         /// Pointer to an event listener object
         EventListener* mEventListener;
@@ -84,6 +114,12 @@ class CollisionWorld {
         /// Name of the collision world
         std::string mName;
 
+        /// Absolute position of the origin of the world-space coordinates
+        WorldPosition mOrigin;
+
+        /// Copy of the proxy shapes of the world for the concurrent read-only queries
+        SceneQuerySnapshot mQuerySnapshot;
+
 #ifdef IS_PROFILING_ACTIVE
 
 		/// Real-time hierarchical profiler
@@ -102,17 +138,23 @@ class CollisionWorld {
         /// True if the logger has been created by the user
         bool mIsLoggerCreatedByUser;
 
-        /// Total number of worlds
-        static uint mNbWorlds;
+        /// Total number of worlds (the worlds can be created on different threads)
+        static std::atomic<uint> mNbWorlds;
 
         // -------------------- Methods -------------------- //
 
-        /// Return the next available body id
-        bodyindex computeNextAvailableBodyId();
+        /// Add a body into the list of bodies of the world
+        void addBody(CollisionBody* body);
+
+        /// Remove a body from the list of bodies of the world
+        void removeBody(CollisionBody* body);
 
         /// Reset all the contact manifolds linked list of each body
         void resetContactManifoldListsOfBodies();
 
+        /// Allocate the memory of the proxy shapes, pairs and contacts of the world
+        void reserveCollisionCapacities(const WorldCapacities& capacities);
+
     public :
 
         // -------------------- Methods -------------------- //
@@ -136,35 +178,122 @@ class CollisionWorld {
         /// Destroy a collision body
         void destroyCollisionBody(CollisionBody* collisionBody);
 
+        /// Create a character controller at a given position
+        CharacterController* createCharacterController(const Vector3& position,
+                                                       const CharacterControllerSettings& settings = CharacterControllerSettings());
+
+        /// Destroy a character controller
+        void destroyCharacterController(CharacterController* characterController);
+
+        /// Return the number of character controllers in the world
+        uint getNbCharacterControllers() const;
+
+        /// Return a pointer to a given character controller of the world
+        CharacterController* getCharacterController(uint index);
+
         /// Set the collision dispatch configuration
         void setCollisionDispatch(CollisionDispatch* collisionDispatch);
 
+        /// Compute the collision detection of the world without any simulation
+        void update();
+
+        /// Set an event listener object to receive events callbacks.
+        void setEventListener(EventListener* eventListener);
+
+        /// Return the contact manifolds of the world at the end of the last update
+        const List<const ContactManifold*>& getContactManifolds() const;
+
         /// Ray cast method
         void raycast(const Ray& ray, RaycastCallback* raycastCallback,
-                     unsigned short raycastWithCategoryMaskBits = 0xFFFF) const;
+                     collisionmask raycastWithCategoryMaskBits = ALL_COLLISION_CATEGORIES) const;
+
+        /// Cast a ray and return its closest hit
+        bool raycastClosest(const Ray& ray, RaycastHit& hit,
+                            collisionmask raycastWithCategoryMaskBits = ALL_COLLISION_CATEGORIES) const;
+
+        /// Return true if a ray hits a shape (occlusion query)
+        bool raycastAny(const Ray& ray, collisionmask raycastWithCategoryMaskBits = ALL_COLLISION_CATEGORIES) const;
+
+        /// Cast a batch of rays and return the closest hit of each ray
+        void raycastBatch(const Ray* rays, uint nbRays, RaycastHit* hits,
+                          collisionmask raycastWithCategoryMaskBits = ALL_COLLISION_CATEGORIES);
 
         /// Test if the AABBs of two bodies overlap
         bool testAABBOverlap(const CollisionBody* body1,
                              const CollisionBody* body2) const;
 
         /// Report all the bodies which have an AABB that overlaps with the AABB in parameter
-        void testAABBOverlap(const AABB& aabb, OverlapCallback* overlapCallback, unsigned short categoryMaskBits = 0xFFFF);
+        void testAABBOverlap(const AABB& aabb, OverlapCallback* overlapCallback, collisionmask categoryMaskBits = ALL_COLLISION_CATEGORIES);
 
         /// Return true if two bodies overlap
         bool testOverlap(CollisionBody* body1, CollisionBody* body2);
 
         /// Report all the bodies that overlap with the body in parameter
-        void testOverlap(CollisionBody* body, OverlapCallback* overlapCallback, unsigned short categoryMaskBits = 0xFFFF);
+        void testOverlap(CollisionBody* body, OverlapCallback* overlapCallback, collisionmask categoryMaskBits = ALL_COLLISION_CATEGORIES);
+
+        /// Fill an array with the proxy shapes whose AABBs overlap with the AABB in parameter
+        uint testAABBOverlap(const AABB& aabb, OverlapHit* hits, uint maxNbHits,
+                             collisionmask categoryMaskBits = ALL_COLLISION_CATEGORIES) const;
+
+        /// Fill an array with the proxy shapes of the other bodies that overlap with the body in parameter
+        uint testOverlap(const CollisionBody* body, OverlapHit* hits, uint maxNbHits,
+                         collisionmask categoryMaskBits = ALL_COLLISION_CATEGORIES) const;
+
+        /// Fill an array with the proxy shapes that overlap with a convex shape at a given transform
+        uint testOverlap(const ConvexShape* shape, const Transform& shapeToWorldTransform, OverlapHit* hits,
+                         uint maxNbHits, collisionmask categoryMaskBits = ALL_COLLISION_CATEGORIES) const;
 
         /// Test and report collisions between two bodies
         void testCollision(CollisionBody* body1, CollisionBody* body2, CollisionCallback* callback);
 
+        /// Fill an array with the contact points between two bodies
+        uint testCollision(CollisionBody* body1, CollisionBody* body2, ContactHit* hits,
+                           uint maxNbHits) const;
+
         /// Test and report collisions between a body and all the others bodies of the world
-        void testCollision(CollisionBody* body, CollisionCallback* callback, unsigned short categoryMaskBits = 0xFFFF);
+        void testCollision(CollisionBody* body, CollisionCallback* callback, collisionmask categoryMaskBits = ALL_COLLISION_CATEGORIES);
 
         /// Test and report collisions between all shapes of the world
         void testCollision(CollisionCallback* callback);
 
+        /// Compute the time of impact of two convex shapes moving between two transforms
+        bool testSweep(const ConvexShape* shape1, const Transform& shape1StartTransform,
+                       const Transform& shape1EndTransform, const ConvexShape* shape2,
+                       const Transform& shape2StartTransform, const Transform& shape2EndTransform,
+                       decimal& outFraction, Vector3& outNormal) const;
+
+        /// Sweep a convex shape between two transforms and report the shapes it hits
+        void sweep(const ConvexShape* shape, const Transform& startTransform, const Transform& endTransform,
+                   SweepCallback* sweepCallback, collisionmask sweepWithCategoryMaskBits = ALL_COLLISION_CATEGORIES);
+
+        /// Sweep a convex shape between two transforms and return its earliest hit
+        bool sweepClosest(const ConvexShape* shape, const Transform& startTransform, const Transform& endTransform,
+                          SweepInfo& hit, collisionmask sweepWithCategoryMaskBits = ALL_COLLISION_CATEGORIES);
+
+        /// Compute the distance and the closest points between two convex shapes
+        bool computeDistance(const ConvexShape* shape1, const Transform& shape1ToWorldTransform,
+                             const ConvexShape* shape2, const Transform& shape2ToWorldTransform,
+                             DistanceInfo& distanceInfo) const;
+
+        /// Compute the distances between the convex shapes of a batch of pairs
+        void computeDistanceBatch(const DistanceQuery* queries, uint nbQueries, DistanceInfo* distanceInfos);
+
+        /// Return the closest proxy shape of a point within a maximum distance
+        bool closestPoint(const Vector3& point, decimal maxDistance, DistanceInfo& hit,
+                          collisionmask categoryMaskBits = ALL_COLLISION_CATEGORIES) const;
+
+        /// Return the closest proxy shape of a convex shape within a maximum distance
+        bool closestPoint(const ConvexShape* shape, const Transform& shapeToWorldTransform, decimal maxDistance,
+                          DistanceInfo& hit, collisionmask categoryMaskBits = ALL_COLLISION_CATEGORIES) const;
+
+        /// Return the closest proxy shapes of a batch of points within a maximum distance
+        void closestPointBatch(const Vector3* points, uint nbPoints, decimal maxDistance, DistanceInfo* hits,
+                               collisionmask categoryMaskBits = ALL_COLLISION_CATEGORIES);
+
+        /// Find a proxy shape that contains each point of a batch and return the number of points inside
+        uint testPointsInside(const Vector3* points, uint nbPoints, ProxyShape** hits,
+                              collisionmask categoryMaskBits = ALL_COLLISION_CATEGORIES);
+
 #ifdef IS_PROFILING_ACTIVE
 
         /// Return a reference to the profiler
@@ -185,6 +314,62 @@ class CollisionWorld {
         /// Return the name of the world
         const std::string& getName() const;
 
+        /// Return a pointer to the task scheduler used to execute work in parallel
+        TaskScheduler* getTaskScheduler() const;
+
+        /// Copy the current proxy shapes of the world into its scene query snapshot
+        void updateQuerySnapshot();
+
+        /// Return the scene query snapshot of the world
+        const SceneQuerySnapshot& getQuerySnapshot() const;
+
+        /// Return the absolute position of the origin of the world-space coordinates
+        const WorldPosition& getOrigin() const;
+
+        /// Move the origin of the world-space coordinates to an absolute position
+        void setOrigin(const WorldPosition& origin);
+
+        /// Move the origin of the world-space coordinates by a displacement
+        void shiftOrigin(const Vector3& shift);
+
+        /// Return the absolute position of a point given in world-space coordinates
+        WorldPosition getAbsolutePosition(const Vector3& worldPoint) const;
+
+        /// Return the world-space coordinates of an absolute position
+        Vector3 getWorldPoint(const WorldPosition& position) const;
+
+        /// Return the statistics of the last computation of the broad-phase
+        const BroadPhaseStatistics& getBroadPhaseStatistics() const;
+
+        /// Compute the metrics of the quality of the trees of the broad-phase
+        bool computeBroadPhaseTreeStatistics(DynamicAABBTreeStatistics& dynamicTreeStatistics,
+                                             DynamicAABBTreeStatistics& staticTreeStatistics) const;
+
+        /// Return the statistics of the last computation of the narrow-phase
+        const NarrowPhaseStatistics& getNarrowPhaseStatistics() const;
+
+        /// Return the most expensive overlapping pairs of the last collision detection
+        uint getMostExpensiveNarrowPhasePairs(NarrowPhasePairCost* pairCosts, uint nbMaxPairs) const;
+
+        /// Return the cost of the narrow-phase tests between two types of collision shapes
+        const NarrowPhaseShapeTypeCost& getNarrowPhaseShapeTypeCost(CollisionShapeType shape1Type,
+                                                                    CollisionShapeType shape2Type) const;
+
+        /// Return the contact events of the last update of the world
+        const List<ContactEvent>& getContactEvents() const;
+
+        /// Return the statistics of the memory allocated by a subsystem of the engine
+        const MemoryStatistics& getMemoryStatistics(MemoryTag tag) const;
+
+        /// Allocate the memory needed to store a given number of overlapping pairs
+        void reservePairs(uint nbPairs);
+
+        /// Allocate the memory needed to report a given number of contact manifolds to the bodies
+        void reserveContacts(uint nbContactManifolds);
+
+        /// Allocate the memory needed to store a given number of objects in the world
+        virtual void reserve(const WorldCapacities& capacities);
+
         // -------------------- Friendship -------------------- //
 
         friend class CollisionDetection;
@@ -213,10 +398,57 @@ inline void CollisionWorld::setCollisionDispatch(CollisionDispatch* collisionDis
  */
 inline void CollisionWorld::raycast(const Ray& ray,
                                     RaycastCallback* raycastCallback,
-                                    unsigned short raycastWithCategoryMaskBits) const {
+                                    collisionmask raycastWithCategoryMaskBits) const {
     mCollisionDetection.raycast(raycastCallback, ray, raycastWithCategoryMaskBits);
 }
 
+// Cast a ray and return its closest hit
+/// This is faster than raycast() with a callback that keeps the closest hit. With the
+/// dynamic AABB tree broad-phase, the tree is traversed with the nearest children first
+/// and the ray is clipped at each hit without calling any virtual callback.
+/**
+ * @param ray Ray to use for raycasting
+ * @param[out] hit Closest hit of the ray (the proxy shape of the hit is null if the ray
+ *                 does not hit anything)
+ * @param raycastWithCategoryMaskBits Bits mask corresponding to the category of
+ *                                    bodies to be raycasted
+ * @return True if the ray hits a shape
+ */
+inline bool CollisionWorld::raycastClosest(const Ray& ray, RaycastHit& hit,
+                                           collisionmask raycastWithCategoryMaskBits) const {
+    return mCollisionDetection.raycastClosest(ray, hit, raycastWithCategoryMaskBits);
+}
+
+// Return true if a ray hits a shape (occlusion query)
+/// The raycast stops at the first hit, which is not necessarily the closest one.
+/**
+ * @param ray Ray to use for raycasting
+ * @param raycastWithCategoryMaskBits Bits mask corresponding to the category of
+ *                                    bodies to be raycasted
+ * @return True if the ray hits a shape
+ */
+inline bool CollisionWorld::raycastAny(const Ray& ray, collisionmask raycastWithCategoryMaskBits) const {
+    return mCollisionDetection.raycastAny(ray, raycastWithCategoryMaskBits);
+}
+
+// Cast a batch of rays and return the closest hit of each ray
+/// This is faster than casting the rays one by one with raycast() when there are many rays.
+/// The rays are sorted into packets of close rays that traverse the broad-phase together and
+/// the packets are split between the workers of the task scheduler of the world (if any).
+/// The rays are clipped at their closest hit and no raycast callback is needed.
+/**
+ * @param rays Array with the rays to cast
+ * @param nbRays Number of rays of the batch
+ * @param[out] hits Array where the closest hit of the ray at index i is written at index i
+ *                  (the proxy shape of a hit is null if the ray does not hit anything)
+ * @param raycastWithCategoryMaskBits Bits mask corresponding to the category of
+ *                                    bodies to be raycasted
+ */
+inline void CollisionWorld::raycastBatch(const Ray* rays, uint nbRays, RaycastHit* hits,
+                                         collisionmask raycastWithCategoryMaskBits) {
+    mCollisionDetection.raycastBatch(rays, nbRays, hits, raycastWithCategoryMaskBits);
+}
+
 // Test and report collisions between two bodies
 /**
  * @param body1 Pointer to the first body to test
@@ -227,13 +459,29 @@ inline void CollisionWorld::testCollision(CollisionBody* body1, CollisionBody* b
     mCollisionDetection.testCollision(body1, body2, callback);
 }
 
+// Fill an array with the contact points between two bodies
+/// Unlike the query with a CollisionCallback, no overlapping pair or contact manifold is created.
+/// The pairs of proxy shapes whose AABBs overlap are tested by the narrow-phase algorithms on
+/// the stack and the contact points are stored in the array until it is full.
+/**
+ * @param body1 Pointer to the first body to test
+ * @param body2 Pointer to the second body to test
+ * @param[out] hits Array where the contact points are stored
+ * @param maxNbHits Size of the array of hits
+ * @return The number of contact points stored in the array
+ */
+inline uint CollisionWorld::testCollision(CollisionBody* body1, CollisionBody* body2, ContactHit* hits,
+                                          uint maxNbHits) const {
+    return mCollisionDetection.testCollision(body1, body2, hits, maxNbHits);
+}
+
 // Test and report collisions between a body and all the others bodies of the world
 /**
  * @param body Pointer to the body against which we need to test collision
  * @param callback Pointer to the object with the callback method to report contacts
  * @param categoryMaskBits Bits mask corresponding to the category of bodies we need to test collision with
  */
-inline void CollisionWorld::testCollision(CollisionBody* body, CollisionCallback* callback, unsigned short categoryMaskBits) {
+inline void CollisionWorld::testCollision(CollisionBody* body, CollisionCallback* callback, collisionmask categoryMaskBits) {
     mCollisionDetection.testCollision(body, callback, categoryMaskBits);
 }
 
@@ -245,16 +493,224 @@ inline void CollisionWorld::testCollision(CollisionCallback* callback) {
     mCollisionDetection.testCollision(callback);
 }
 
+// Compute the time of impact of two convex shapes moving between two transforms
+/// The shapes move linearly from their start transform to their end transform. This
+/// method returns true if the shapes touch during the motion. In this case, the
+/// fraction of the motion at the first time of impact and the normal of the contact
+/// (from the first shape toward the second one in world-space) are returned. This can
+/// be used to sweep a shape (a character for instance) without testing the collision at
+/// many intermediate positions.
+/**
+ * @param shape1 The first convex shape
+ * @param shape1StartTransform Local-to-world transform of the first shape at the beginning of the motion
+ * @param shape1EndTransform Local-to-world transform of the first shape at the end of the motion
+ * @param shape2 The second convex shape
+ * @param shape2StartTransform Local-to-world transform of the second shape at the beginning of the motion
+ * @param shape2EndTransform Local-to-world transform of the second shape at the end of the motion
+ * @param[out] outFraction Fraction of the motion (in [0, 1]) when the shapes start touching
+ * @param[out] outNormal Normal of the contact at the time of impact (in world-space)
+ * @return True if the shapes touch during the motion
+ */
+inline bool CollisionWorld::testSweep(const ConvexShape* shape1, const Transform& shape1StartTransform,
+                                      const Transform& shape1EndTransform, const ConvexShape* shape2,
+                                      const Transform& shape2StartTransform, const Transform& shape2EndTransform,
+                                      decimal& outFraction, Vector3& outNormal) const {
+    return mCollisionDetection.testSweep(shape1, shape1StartTransform, shape1EndTransform,
+                                         shape2, shape2StartTransform, shape2EndTransform,
+                                         outFraction, outNormal);
+}
+
+// Sweep a convex shape between two transforms and report the shapes it hits
+/// The shape does not have to be attached to a body of the world. The callback is called
+/// for each proxy shape hit by the shape during its motion with the fraction of the motion
+/// at the time of impact, the contact point and the surface normal of the hit shape.
+/// This can be used to move a character (with a capsule for instance) in the world.
+/**
+ * @param shape The convex shape to sweep
+ * @param startTransform Local-to-world transform of the shape at the beginning of the motion
+ * @param endTransform Local-to-world transform of the shape at the end of the motion
+ * @param sweepCallback Pointer to the class with the callback method
+ * @param sweepWithCategoryMaskBits Bits mask corresponding to the category of
+ *                                  bodies to be swept against
+ */
+inline void CollisionWorld::sweep(const ConvexShape* shape, const Transform& startTransform,
+                                  const Transform& endTransform, SweepCallback* sweepCallback,
+                                  collisionmask sweepWithCategoryMaskBits) {
+    mCollisionDetection.sweep(shape, startTransform, endTransform, sweepCallback, sweepWithCategoryMaskBits);
+}
+
+// Sweep a convex shape between two transforms and return its earliest hit
+/**
+ * @param shape The convex shape to sweep
+ * @param startTransform Local-to-world transform of the shape at the beginning of the motion
+ * @param endTransform Local-to-world transform of the shape at the end of the motion
+ * @param[out] hit Earliest hit of the shape (the proxy shape of the hit is null if the
+ *                 shape does not hit anything)
+ * @param sweepWithCategoryMaskBits Bits mask corresponding to the category of
+ *                                  bodies to be swept against
+ * @return True if the shape hits a shape of the world during its motion
+ */
+inline bool CollisionWorld::sweepClosest(const ConvexShape* shape, const Transform& startTransform,
+                                         const Transform& endTransform, SweepInfo& hit,
+                                         collisionmask sweepWithCategoryMaskBits) {
+    return mCollisionDetection.sweepClosest(shape, startTransform, endTransform, hit, sweepWithCategoryMaskBits);
+}
+
+// Compute the distance and the closest points between two convex shapes
+/// The shapes do not have to be attached to bodies of the world. The distance includes the
+/// margins of the shapes. This is much cheaper than computing distances with raycasts.
+/**
+ * @param shape1 The first convex shape
+ * @param shape1ToWorldTransform Local-to-world transform of the first shape
+ * @param shape2 The second convex shape
+ * @param shape2ToWorldTransform Local-to-world transform of the second shape
+ * @param[out] distanceInfo The distance and the closest points of the shapes (the distance
+ *                          is zero if the shapes overlap)
+ * @return True if the shapes are separated
+ */
+inline bool CollisionWorld::computeDistance(const ConvexShape* shape1, const Transform& shape1ToWorldTransform,
+                                            const ConvexShape* shape2, const Transform& shape2ToWorldTransform,
+                                            DistanceInfo& distanceInfo) const {
+    return mCollisionDetection.computeDistance(shape1, shape1ToWorldTransform, shape2, shape2ToWorldTransform,
+                                               distanceInfo);
+}
+
+// Compute the distances between the convex shapes of a batch of pairs
+/// The pairs are computed in parallel if the world has a task scheduler.
+/**
+ * @param queries Array with the pairs of shapes
+ * @param nbQueries Number of pairs of shapes
+ * @param[out] distanceInfos Array where the distance of the pair queries[i] is written at index i
+ */
+inline void CollisionWorld::computeDistanceBatch(const DistanceQuery* queries, uint nbQueries,
+                                                 DistanceInfo* distanceInfos) {
+    mCollisionDetection.computeDistanceBatch(queries, nbQueries, distanceInfos);
+}
+
+// Return the closest proxy shape of a point within a maximum distance
+/// Only the proxy shapes whose AABB is closer than the maximum distance are tested, so
+/// the maximum distance should be as small as possible. If the point is inside a proxy
+/// shape, the distance is zero.
+/**
+ * @param point The point in world-space coordinates
+ * @param maxDistance Maximum distance of the proxy shapes (must be positive and finite)
+ * @param[out] hit The closest point on the closest proxy shape (the proxy shape of the hit
+ *                 is null if there is no proxy shape within the maximum distance)
+ * @param categoryMaskBits Bits mask corresponding to the category of bodies to be queried
+ * @return True if a proxy shape is closer than the maximum distance
+ */
+inline bool CollisionWorld::closestPoint(const Vector3& point, decimal maxDistance, DistanceInfo& hit,
+                                         collisionmask categoryMaskBits) const {
+    return mCollisionDetection.closestPoint(point, maxDistance, hit, categoryMaskBits);
+}
+
+// Return the closest proxy shape of a convex shape within a maximum distance
+/// The shape does not have to be attached to a body of the world.
+/**
+ * @param shape The convex shape
+ * @param shapeToWorldTransform Local-to-world transform of the shape
+ * @param maxDistance Maximum distance of the proxy shapes (must be positive and finite)
+ * @param[out] hit The closest points of the shape and of the closest proxy shape (the
+ *                 proxy shape of the hit is null if there is no proxy shape within the
+ *                 maximum distance)
+ * @param categoryMaskBits Bits mask corresponding to the category of bodies to be queried
+ * @return True if a proxy shape is closer than the maximum distance
+ */
+inline bool CollisionWorld::closestPoint(const ConvexShape* shape, const Transform& shapeToWorldTransform,
+                                         decimal maxDistance, DistanceInfo& hit,
+                                         collisionmask categoryMaskBits) const {
+    return mCollisionDetection.closestPoint(shape, shapeToWorldTransform, maxDistance, hit, categoryMaskBits);
+}
+
+// Return the closest proxy shapes of a batch of points within a maximum distance
+/// The points are queried in parallel if the world has a task scheduler.
+/**
+ * @param points Array with the points in world-space coordinates
+ * @param nbPoints Number of points
+ * @param maxDistance Maximum distance of the proxy shapes (must be positive and finite)
+ * @param[out] hits Array where the closest point of the point points[i] is written at index i
+ * @param categoryMaskBits Bits mask corresponding to the category of bodies to be queried
+ */
+inline void CollisionWorld::closestPointBatch(const Vector3* points, uint nbPoints, decimal maxDistance,
+                                              DistanceInfo* hits, collisionmask categoryMaskBits) {
+    mCollisionDetection.closestPointBatch(points, nbPoints, maxDistance, hits, categoryMaskBits);
+}
+
+// Find a proxy shape that contains each point of a batch and return the number of points inside
+/// The points are sorted along a Morton curve and tested by packets that traverse the
+/// broad-phase together (in parallel if the world has a task scheduler). This is much faster
+/// than calling CollisionBody::testPointInside() for each point and each body. Like
+/// ProxyShape::testPointInside(), a point is never inside a concave shape.
+/**
+ * @param points Array with the points in world-space coordinates
+ * @param nbPoints Number of points
+ * @param[out] hits Array where a proxy shape that contains the point points[i] (or nullptr if
+ *                  the point is not inside any proxy shape) is written at index i
+ * @param categoryMaskBits Bits mask corresponding to the category of bodies to be queried
+ * @return The number of points that are inside a proxy shape
+ */
+inline uint CollisionWorld::testPointsInside(const Vector3* points, uint nbPoints, ProxyShape** hits,
+                                             collisionmask categoryMaskBits) {
+    return mCollisionDetection.testPointsInside(points, nbPoints, hits, categoryMaskBits);
+}
+
 // Report all the bodies that overlap with the body in parameter
 /**
  * @param body Pointer to the collision body to test overlap with
  * @param overlapCallback Pointer to the callback class to report overlap
  * @param categoryMaskBits bits mask used to filter the bodies to test overlap with
  */
-inline void CollisionWorld::testOverlap(CollisionBody* body, OverlapCallback* overlapCallback, unsigned short categoryMaskBits) {
+inline void CollisionWorld::testOverlap(CollisionBody* body, OverlapCallback* overlapCallback, collisionmask categoryMaskBits) {
     mCollisionDetection.testOverlap(body, overlapCallback, categoryMaskBits);
 }
 
+// Fill an array with the proxy shapes whose AABBs overlap with the AABB in parameter
+/// Unlike the query with an OverlapCallback, each overlapping proxy shape is stored (not only
+/// each body) and nothing is allocated. If more proxy shapes overlap than the size of the
+/// array, only the first ones are stored.
+/**
+ * @param aabb AABB used to test for overlap
+ * @param[out] hits Array where the overlapping proxy shapes are stored
+ * @param maxNbHits Size of the array of hits
+ * @param categoryMaskBits bits mask used to filter the bodies to test overlap with
+ * @return The number of hits stored in the array
+ */
+inline uint CollisionWorld::testAABBOverlap(const AABB& aabb, OverlapHit* hits, uint maxNbHits,
+                                            collisionmask categoryMaskBits) const {
+    return mCollisionDetection.testAABBOverlap(aabb, hits, maxNbHits, categoryMaskBits);
+}
+
+// Fill an array with the proxy shapes of the other bodies that overlap with the body in parameter
+/// Each overlapping proxy shape is stored once. The shapes are tested with the GJK algorithm
+/// without computing any contact and nothing is allocated.
+/**
+ * @param body Pointer to the collision body to test overlap with
+ * @param[out] hits Array where the overlapping proxy shapes are stored
+ * @param maxNbHits Size of the array of hits
+ * @param categoryMaskBits bits mask used to filter the bodies to test overlap with
+ * @return The number of hits stored in the array
+ */
+inline uint CollisionWorld::testOverlap(const CollisionBody* body, OverlapHit* hits, uint maxNbHits,
+                                        collisionmask categoryMaskBits) const {
+    return mCollisionDetection.testOverlap(body, hits, maxNbHits, categoryMaskBits);
+}
+
+// Fill an array with the proxy shapes that overlap with a convex shape at a given transform
+/// The shape (a sphere for an area of effect for instance) does not have to be attached
+/// to a body of the world and nothing is allocated.
+/**
+ * @param shape The convex shape to test overlap with
+ * @param shapeToWorldTransform Local-to-world transform of the shape
+ * @param[out] hits Array where the overlapping proxy shapes are stored
+ * @param maxNbHits Size of the array of hits
+ * @param categoryMaskBits bits mask used to filter the bodies to test overlap with
+ * @return The number of hits stored in the array
+ */
+inline uint CollisionWorld::testOverlap(const ConvexShape* shape, const Transform& shapeToWorldTransform,
+                                        OverlapHit* hits, uint maxNbHits, collisionmask categoryMaskBits) const {
+    return mCollisionDetection.testOverlap(shape, shapeToWorldTransform, hits, maxNbHits, categoryMaskBits);
+}
+
 // Return the name of the world
 /**
  * @return Name of the world
@@ -263,6 +719,206 @@ inline const std::string& CollisionWorld::getName() const {
     return mName;
 }
 
+// Return the number of character controllers in the world
+inline uint CollisionWorld::getNbCharacterControllers() const {
+    return mCharacterControllers.size();
+}
+
+// Return a pointer to a given character controller of the world
+/**
+ * @param index Index of the character controller (between zero and getNbCharacterControllers() - 1)
+ * @return A pointer to the character controller
+ */
+inline CharacterController* CollisionWorld::getCharacterController(uint index) {
+    assert(index < mCharacterControllers.size());
+    return mCharacterControllers[index];
+}
+
+// Return the absolute position of the origin of the world-space coordinates
+/**
+ * @return The absolute position (in double precision) of the origin of the world
+ */
+inline const WorldPosition& CollisionWorld::getOrigin() const {
+    return mOrigin;
+}
+
+// Move the origin of the world-space coordinates by a displacement
+/**
+ * @param shift The displacement of the origin (in the current world-space coordinates)
+ */
+inline void CollisionWorld::shiftOrigin(const Vector3& shift) {
+    setOrigin(mOrigin + shift);
+}
+
+// Return the absolute position of a point given in world-space coordinates
+/**
+ * @param worldPoint A point in world-space coordinates
+ * @return The absolute position (in double precision) of the point
+ */
+inline WorldPosition CollisionWorld::getAbsolutePosition(const Vector3& worldPoint) const {
+    return mOrigin + worldPoint;
+}
+
+// Return the world-space coordinates of an absolute position
+/**
+ * @param position An absolute position (in double precision)
+ * @return The point in world-space coordinates (relative to the origin of the world)
+ */
+inline Vector3 CollisionWorld::getWorldPoint(const WorldPosition& position) const {
+    return position - mOrigin;
+}
+
+// Return a pointer to the task scheduler used to execute work in parallel
+/**
+ * @return A pointer to the task scheduler of the world settings (null if the
+ *         world is simulated sequentially)
+ */
+inline TaskScheduler* CollisionWorld::getTaskScheduler() const {
+    return mConfig.taskScheduler;
+}
+
+// Copy the current proxy shapes of the world into its scene query snapshot
+/// The queries of the world itself read the broad-phase and the bodies, which are modified
+/// by the steps, and they must be called from a single thread. The snapshot is a copy that
+/// can be queried from several threads at the same time until it is updated again. This
+/// method must not be called while queries are running on the snapshot.
+inline void CollisionWorld::updateQuerySnapshot() {
+    mQuerySnapshot.update(mBodies, mConfig.taskScheduler);
+}
+
+// Return the scene query snapshot of the world
+/// The snapshot contains the proxy shapes of the active bodies at the time of the last
+/// call to updateQuerySnapshot() (or to DynamicsWorld::startUpdate() if the
+/// isQuerySnapshotUpdatedByStartUpdate setting is enabled).
+/**
+ * @return The snapshot used for the concurrent read-only queries
+ */
+inline const SceneQuerySnapshot& CollisionWorld::getQuerySnapshot() const {
+    return mQuerySnapshot;
+}
+
+// Return the statistics of the last computation of the broad-phase
+/**
+ * @return The number of shapes reinserted into the broad-phase since the previous
+ *         computation and the number of overlapping pairs found by the last one
+ */
+inline const BroadPhaseStatistics& CollisionWorld::getBroadPhaseStatistics() const {
+    return mCollisionDetection.getBroadPhaseStatistics();
+}
+
+// Compute the metrics of the quality of the trees of the broad-phase
+/// The cost of this method is linear in the number of proxy shapes. The statistics contain
+/// the cost of the queries (see DynamicAABBTree::computeCost()), the depths of the leaves
+/// and the overlaps between sibling nodes.
+/**
+ * @param[out] dynamicTreeStatistics The statistics of the tree of the dynamic shapes
+ * @param[out] staticTreeStatistics The statistics of the tree of the static shapes (empty
+ *             if the static tree is disabled in the world settings)
+ * @return False if the broad-phase of the world does not use dynamic AABB trees
+ */
+inline bool CollisionWorld::computeBroadPhaseTreeStatistics(DynamicAABBTreeStatistics& dynamicTreeStatistics,
+                                                            DynamicAABBTreeStatistics& staticTreeStatistics) const {
+    return mCollisionDetection.computeBroadPhaseTreeStatistics(dynamicTreeStatistics, staticTreeStatistics);
+}
+
+// Return the statistics of the last computation of the narrow-phase
+/**
+ * @return The number of pairs tested with the SAT algorithm during the last narrow-phase
+ *         and the number of them resolved with the separating axis of the previous frame
+ */
+inline const NarrowPhaseStatistics& CollisionWorld::getNarrowPhaseStatistics() const {
+    return mCollisionDetection.getNarrowPhaseStatistics();
+}
+
+// Return the most expensive overlapping pairs of the last collision detection
+/// The costs are only measured if WorldSettings::isNarrowPhaseCostsEnabled is true. They are
+/// cleared when a proxy shape is removed from the world.
+/**
+ * @param[out] pairCosts Array of at least nbMaxPairs costs where the costs of the pairs are
+ *             written by decreasing time of the middle-phase and narrow-phase
+ * @param nbMaxPairs Maximum number of pairs to return
+ * @return The number of pairs written in the array
+ */
+inline uint CollisionWorld::getMostExpensiveNarrowPhasePairs(NarrowPhasePairCost* pairCosts, uint nbMaxPairs) const {
+    return mCollisionDetection.getMostExpensiveNarrowPhasePairs(pairCosts, nbMaxPairs);
+}
+
+// Return the cost of the narrow-phase tests between two types of collision shapes
+/**
+ * @param shape1Type Type of the first collision shape
+ * @param shape2Type Type of the second collision shape (the order of the types does not matter)
+ * @return The time and the number of the narrow-phase tests of the last collision detection
+ *         (only measured if WorldSettings::isNarrowPhaseCostsEnabled is true)
+ */
+inline const NarrowPhaseShapeTypeCost& CollisionWorld::getNarrowPhaseShapeTypeCost(CollisionShapeType shape1Type,
+                                                                                   CollisionShapeType shape2Type) const {
+    return mCollisionDetection.getNarrowPhaseShapeTypeCost(shape1Type, shape2Type);
+}
+
+// Return the contact events of the last update of the world
+/// The buffer contains a CONTACT_BEGIN event for each pair of proxy shapes that started
+/// touching during the last update, a CONTACT_END event for each pair that stopped touching
+/// and, if WorldSettings::isContactStayEventReported is true, a CONTACT_STAY event for each
+/// pair that is still touching. The TRIGGER_ENTER and TRIGGER_EXIT events are reported when
+/// a trigger starts and stops intersecting with another shape. The buffer is cleared at the
+/// next update. No event is reported for the pairs removed because a proxy shape or a body
+/// is destroyed.
+/**
+ * @return The list of the contact events of the last update
+ */
+inline const List<ContactEvent>& CollisionWorld::getContactEvents() const {
+    return mCollisionDetection.getContactEvents();
+}
+
+// Set an event listener object to receive events callbacks.
+/// If you use "nullptr" as an argument, the events callbacks will be disabled.
+/**
+ * @param eventListener Pointer to the event listener object that will receive
+ *                      event callbacks during the simulation
+ */
+inline void CollisionWorld::setEventListener(EventListener* eventListener) {
+    mEventListener = eventListener;
+}
+
+// Return the contact manifolds of the world at the end of the last update
+/// The list is filled during the collision detection and is not allocated again at each
+/// call. The contact manifolds of a destroyed body or proxy shape are removed from the list.
+/**
+ * @return A reference to the list of the contact manifolds of the world
+ */
+inline const List<const ContactManifold*>& CollisionWorld::getContactManifolds() const {
+    return mCollisionDetection.getContactManifolds();
+}
+
+// Return the statistics of the memory allocated by a subsystem of the engine
+/**
+ * @param tag The subsystem of the engine
+ * @return The number of bytes in use, the peak number of bytes in use, the number of
+ *         allocations of the last step and the high-water mark of the single frame
+ *         allocations of the subsystem
+ */
+inline const MemoryStatistics& CollisionWorld::getMemoryStatistics(MemoryTag tag) const {
+    return mMemoryManager.getStatistics(tag);
+}
+
+// Allocate the memory needed to store a given number of overlapping pairs
+/// The broad-phase can then report this number of pairs without growing its arrays
+/**
+ * @param nbPairs The number of overlapping pairs
+ */
+inline void CollisionWorld::reservePairs(uint nbPairs) {
+    mCollisionDetection.reservePairs(nbPairs);
+}
+
+// Allocate the memory needed to report a given number of contact manifolds to the bodies
+/// The contact manifolds lists of the bodies can then be built without any allocation
+/**
+ * @param nbContactManifolds The number of contact manifolds
+ */
+inline void CollisionWorld::reserveContacts(uint nbContactManifolds) {
+    mCollisionDetection.reserveContactManifolds(nbContactManifolds);
+}
+
 #ifdef IS_PROFILING_ACTIVE
 
 // Return a pointer to the profiler
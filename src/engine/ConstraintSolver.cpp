@@ -26,12 +26,25 @@
 // Libraries
 #include "ConstraintSolver.h"
 #include "utils/Profiler.h"
+#include "memory/MemoryManager.h"
 #include "engine/Island.h"
+#include "engine/TaskScheduler.h"
+#include "constraint/BallAndSocketJoint.h"
+#include "constraint/SliderJoint.h"
+#include "constraint/HingeJoint.h"
+#include "constraint/FixedJoint.h"
 
 using namespace reactphysics3d;
 
 // Constructor
-ConstraintSolver::ConstraintSolver() : mIsWarmStartingActive(true) {
+ConstraintSolver::ConstraintSolver(MemoryManager& memoryManager, const WorldSettings& worldSettings)
+                 : mWorldSettings(worldSettings), mIsWarmStartingActive(true),
+                   mArena(memoryManager.getBaseAllocator(MemoryTag::Solver)), mIslands(nullptr), mNbIslands(0),
+                   mSortedJoints(nullptr), mIslandsJointTypesFirstIndex(nullptr),
+                   mIslandsFirstBallAndSocketJointIndex(nullptr), mArticulationSolver(memoryManager, worldSettings),
+                   mLimitMotorRows(nullptr), mIslandsFirstLimitMotorRowIndex(nullptr),
+                   mIslandsNbLimitMotorRows(nullptr), mIslandsNbBreakableJoints(nullptr),
+                   mIslandsNbBrokenJoints(nullptr) {
 
 #ifdef IS_PROFILING_ACTIVE
 
@@ -41,11 +54,146 @@ ConstraintSolver::ConstraintSolver() : mIsWarmStartingActive(true) {
 
 }
 
+// Allocate the limit and motor rows and the joints batches of the islands
+/// The joints of the batched islands are sorted by type (keeping the order of the joints
+/// of the island for each type) and the arrays of the ball-and-socket joints batch are
+/// allocated. The memory is allocated in the arena of the solver that is reused from one
+/// step to the next, this method releases the memory of the previous step.
+void ConstraintSolver::init(Island** islands, uint nbIslands) {
+
+    RP3D_PROFILE("ConstraintSolver::init()", mProfiler);
+
+    mArena.reset();
+    mArticulationSolver.init(islands, nbIslands);
+
+    mIslands = islands;
+    mNbIslands = nbIslands;
+    mSortedJoints = nullptr;
+    mIslandsJointTypesFirstIndex = nullptr;
+    mIslandsFirstBallAndSocketJointIndex = nullptr;
+    mLimitMotorRows = nullptr;
+    mIslandsFirstLimitMotorRowIndex = nullptr;
+    mIslandsNbLimitMotorRows = nullptr;
+    mIslandsNbBreakableJoints = nullptr;
+    mIslandsNbBrokenJoints = nullptr;
+
+    if (nbIslands == 0) return;
+
+    // Allocate the limit and motor rows of the joints of the islands and count
+    // the joints of each island that can break
+    mIslandsFirstLimitMotorRowIndex = static_cast<uint*>(mArena.allocate(sizeof(uint) * nbIslands));
+    mIslandsNbLimitMotorRows = static_cast<uint*>(mArena.allocate(sizeof(uint) * nbIslands));
+    mIslandsNbBreakableJoints = static_cast<uint*>(mArena.allocate(sizeof(uint) * nbIslands));
+    mIslandsNbBrokenJoints = static_cast<uint*>(mArena.allocate(sizeof(uint) * nbIslands));
+    uint nbLimitMotorRows = 0;
+    for (uint i=0; i < nbIslands; i++) {
+
+        mIslandsFirstLimitMotorRowIndex[i] = nbLimitMotorRows;
+        mIslandsNbLimitMotorRows[i] = 0;
+        mIslandsNbBreakableJoints[i] = 0;
+        mIslandsNbBrokenJoints[i] = 0;
+
+        Joint** joints = islands[i]->getJoints();
+        for (uint j=0; j < islands[i]->getNbJoints(); j++) {
+            nbLimitMotorRows += joints[j]->getNbMaxLimitMotorRows();
+            if (joints[j]->isBreakable()) mIslandsNbBreakableJoints[i]++;
+        }
+    }
+    if (nbLimitMotorRows > 0) {
+        mLimitMotorRows = static_cast<JointLimitMotorRow*>(mArena.allocate(sizeof(JointLimitMotorRow) * nbLimitMotorRows));
+    }
+
+    if (!mWorldSettings.isJointBatchingEnabled) return;
+
+    // Count the joints of the batched islands
+    uint nbJoints = 0;
+    uint nbBallAndSocketJoints = 0;
+    for (uint i=0; i < nbIslands; i++) {
+
+        if (!isIslandBatched(islands[i])) continue;
+
+        Joint** joints = islands[i]->getJoints();
+        for (uint j=0; j < islands[i]->getNbJoints(); j++) {
+            nbJoints++;
+            if (joints[j]->getType() == JointType::BALLSOCKETJOINT) nbBallAndSocketJoints++;
+        }
+    }
+
+    mIslandsJointTypesFirstIndex = static_cast<uint*>(mArena.allocate(sizeof(uint) * nbIslands * (NB_JOINT_TYPES + 1)));
+    mIslandsFirstBallAndSocketJointIndex = static_cast<uint*>(mArena.allocate(sizeof(uint) * nbIslands));
+    if (nbJoints > 0) {
+        mSortedJoints = static_cast<Joint**>(mArena.allocate(sizeof(Joint*) * nbJoints));
+    }
+
+    // Allocate the arrays of the ball-and-socket joints batch
+    if (nbBallAndSocketJoints > 0) {
+        mBallAndSocketJoints.joints = static_cast<BallAndSocketJoint**>(mArena.allocate(sizeof(BallAndSocketJoint*) * nbBallAndSocketJoints));
+        mBallAndSocketJoints.indexBody1 = static_cast<uint*>(mArena.allocate(sizeof(uint) * nbBallAndSocketJoints));
+        mBallAndSocketJoints.indexBody2 = static_cast<uint*>(mArena.allocate(sizeof(uint) * nbBallAndSocketJoints));
+        mBallAndSocketJoints.massInverseBody1 = static_cast<decimal*>(mArena.allocate(sizeof(decimal) * nbBallAndSocketJoints));
+        mBallAndSocketJoints.massInverseBody2 = static_cast<decimal*>(mArena.allocate(sizeof(decimal) * nbBallAndSocketJoints));
+        mBallAndSocketJoints.r1World = static_cast<Vector3*>(mArena.allocate(sizeof(Vector3) * nbBallAndSocketJoints));
+        mBallAndSocketJoints.r2World = static_cast<Vector3*>(mArena.allocate(sizeof(Vector3) * nbBallAndSocketJoints));
+        mBallAndSocketJoints.inverseInertiaTensorBody1 = static_cast<Matrix3x3*>(mArena.allocate(sizeof(Matrix3x3) * nbBallAndSocketJoints));
+        mBallAndSocketJoints.inverseInertiaTensorBody2 = static_cast<Matrix3x3*>(mArena.allocate(sizeof(Matrix3x3) * nbBallAndSocketJoints));
+        mBallAndSocketJoints.inverseMassMatrix = static_cast<Matrix3x3*>(mArena.allocate(sizeof(Matrix3x3) * nbBallAndSocketJoints));
+        mBallAndSocketJoints.biasVector = static_cast<Vector3*>(mArena.allocate(sizeof(Vector3) * nbBallAndSocketJoints));
+        mBallAndSocketJoints.impulseScale = static_cast<decimal*>(mArena.allocate(sizeof(decimal) * nbBallAndSocketJoints));
+        mBallAndSocketJoints.impulse = static_cast<Vector3*>(mArena.allocate(sizeof(Vector3) * nbBallAndSocketJoints));
+    }
+
+    // Sort the joints of each batched island by type
+    uint sortedIndex = 0;
+    uint ballAndSocketIndex = 0;
+    for (uint i=0; i < nbIslands; i++) {
+
+        uint* typesFirstIndex = mIslandsJointTypesFirstIndex + i * (NB_JOINT_TYPES + 1);
+        mIslandsFirstBallAndSocketJointIndex[i] = ballAndSocketIndex;
+
+        const bool isBatched = isIslandBatched(islands[i]);
+        Joint** joints = islands[i]->getJoints();
+        for (uint t=0; t < NB_JOINT_TYPES; t++) {
+
+            typesFirstIndex[t] = sortedIndex;
+            if (!isBatched) continue;
+
+            for (uint j=0; j < islands[i]->getNbJoints(); j++) {
+                if (static_cast<uint>(joints[j]->getType()) == t) {
+                    mSortedJoints[sortedIndex] = joints[j];
+                    sortedIndex++;
+                }
+            }
+        }
+        typesFirstIndex[NB_JOINT_TYPES] = sortedIndex;
+
+        // The ball-and-socket joints are the first joints of the island
+        const uint ballAndSocketType = static_cast<uint>(JointType::BALLSOCKETJOINT);
+        for (uint j=typesFirstIndex[ballAndSocketType]; j < typesFirstIndex[ballAndSocketType + 1]; j++) {
+            mBallAndSocketJoints.joints[ballAndSocketIndex] = static_cast<BallAndSocketJoint*>(mSortedJoints[j]);
+            ballAndSocketIndex++;
+        }
+    }
+
+    assert(sortedIndex == nbJoints);
+    assert(ballAndSocketIndex == nbBallAndSocketJoints);
+}
+
+// Return true if the joints of an island are solved in batches
+/// The joints of an island that are solved in parallel (by color) or with the articulation
+/// solver are not batched
+bool ConstraintSolver::isIslandBatched(const Island* island) const {
+    return mWorldSettings.isJointBatchingEnabled && !mWorldSettings.isArticulationSolverEnabled &&
+           !(island->getNbJointsColors() > 0 && mWorldSettings.taskScheduler != nullptr);
+}
+
 // Initialize the constraint solver for a given island
-void ConstraintSolver::initializeForIsland(decimal dt, Island* island) {
+void ConstraintSolver::initializeForIsland(decimal dt, uint islandIndex) {
 
     RP3D_PROFILE("ConstraintSolver::initializeForIsland()", mProfiler);
 
+    assert(islandIndex < mNbIslands);
+    Island* island = mIslands[islandIndex];
+
     assert(island != nullptr);
     assert(island->getNbBodies() > 0);
     assert(island->getNbJoints() > 0);
@@ -56,51 +204,464 @@ void ConstraintSolver::initializeForIsland(decimal dt, Island* island) {
     // Initialize the constraint solver data used to initialize and solve the constraints
     mConstraintSolverData.timeStep = mTimeStep;
     mConstraintSolverData.isWarmStartingActive = mIsWarmStartingActive;
+    mConstraintSolverData.isJointSolverDataCacheEnabled = mWorldSettings.isJointSolverDataCacheEnabled;
+    mConstraintSolverData.jointSolverDataCacheTolerance = mWorldSettings.jointSolverDataCacheTolerance;
 
-    // For each joint of the island
+    if (!isIslandBatched(island)) {
+
+        // For each joint of the island
+        Joint** joints = island->getJoints();
+        for (uint i=0; i<island->getNbJoints(); i++) {
+
+            // Initialize the constraint before solving it
+            joints[i]->initBeforeSolve(mConstraintSolverData);
+        }
+
+        // Build the rows of the active limits and motors of the joints
+        initializeLimitMotorRows(islandIndex);
+
+        // Initialize the articulations of the island
+        mArticulationSolver.initializeForIsland(islandIndex);
+
+        return;
+    }
+
+    const uint* typesFirstIndex = getJointTypesFirstIndex(islandIndex);
+    const uint ballAndSocketType = static_cast<uint>(JointType::BALLSOCKETJOINT);
+
+    // Initialize the ball-and-socket joints and copy their data into the batch
+    uint b = mIslandsFirstBallAndSocketJointIndex[islandIndex];
+    for (uint j=typesFirstIndex[ballAndSocketType]; j < typesFirstIndex[ballAndSocketType + 1]; j++) {
+
+        BallAndSocketJoint* joint = mBallAndSocketJoints.joints[b];
+        assert(joint == mSortedJoints[j]);
+        joint->BallAndSocketJoint::initBeforeSolve(mConstraintSolverData);
+
+        mBallAndSocketJoints.indexBody1[b] = joint->mIndexBody1;
+        mBallAndSocketJoints.indexBody2[b] = joint->mIndexBody2;
+        mBallAndSocketJoints.massInverseBody1[b] = joint->mBody1->mMassInverse;
+        mBallAndSocketJoints.massInverseBody2[b] = joint->mBody2->mMassInverse;
+        mBallAndSocketJoints.r1World[b] = joint->mR1World;
+        mBallAndSocketJoints.r2World[b] = joint->mR2World;
+        mBallAndSocketJoints.inverseInertiaTensorBody1[b] = joint->mI1;
+        mBallAndSocketJoints.inverseInertiaTensorBody2[b] = joint->mI2;
+        mBallAndSocketJoints.inverseMassMatrix[b] = joint->mSoftness.massScale * joint->mInverseMassMatrix;
+        mBallAndSocketJoints.biasVector[b] = joint->mBiasVector;
+        mBallAndSocketJoints.impulseScale[b] = joint->mSoftness.impulseScale;
+        mBallAndSocketJoints.impulse[b] = joint->mImpulse;
+
+        b++;
+    }
+
+    // Initialize the other joints
+    applyToJointsOfType<SliderJoint>(typesFirstIndex[static_cast<uint>(JointType::SLIDERJOINT)],
+                                     typesFirstIndex[static_cast<uint>(JointType::SLIDERJOINT) + 1],
+                                     JointSolverOperation::INITIALIZE);
+    applyToJointsOfType<HingeJoint>(typesFirstIndex[static_cast<uint>(JointType::HINGEJOINT)],
+                                    typesFirstIndex[static_cast<uint>(JointType::HINGEJOINT) + 1],
+                                    JointSolverOperation::INITIALIZE);
+    applyToJointsOfType<FixedJoint>(typesFirstIndex[static_cast<uint>(JointType::FIXEDJOINT)],
+                                    typesFirstIndex[static_cast<uint>(JointType::FIXEDJOINT) + 1],
+                                    JointSolverOperation::INITIALIZE);
+
+    // Build the rows of the active limits and motors of the joints
+    initializeLimitMotorRows(islandIndex);
+}
+
+// Build the rows of the active limits and motors of the joints of an island
+/// The joints must have been initialized before
+void ConstraintSolver::initializeLimitMotorRows(uint islandIndex) {
+
+    Island* island = mIslands[islandIndex];
+
+    JointLimitMotorRow* rows = mLimitMotorRows + mIslandsFirstLimitMotorRowIndex[islandIndex];
+    uint nbRows = 0;
     Joint** joints = island->getJoints();
-    for (uint i=0; i<island->getNbJoints(); i++) {
+    for (uint i=0; i < island->getNbJoints(); i++) {
+        if (joints[i]->getNbMaxLimitMotorRows() == 0) continue;
+        nbRows += joints[i]->computeLimitMotorRows(rows + nbRows, mConstraintSolverData);
+    }
+
+    mIslandsNbLimitMotorRows[islandIndex] = nbRows;
+}
+
+// Solve the limit and motor rows of an island
+/**
+ * @param islandIndex Index of the island to solve
+ * @return The largest absolute change of the impulses of the rows during this iteration
+ */
+decimal ConstraintSolver::solveLimitMotorRows(uint islandIndex) {
+
+    Vector3* linearVelocities = mConstraintSolverData.linearVelocities;
+    Vector3* angularVelocities = mConstraintSolverData.angularVelocities;
+
+    decimal impulseDelta = decimal(0.0);
 
-        // Initialize the constraint before solving it
-        joints[i]->initBeforeSolve(mConstraintSolverData);
+    JointLimitMotorRow* rows = mLimitMotorRows + mIslandsFirstLimitMotorRowIndex[islandIndex];
+    const uint nbRows = mIslandsNbLimitMotorRows[islandIndex];
+    for (uint r=0; r < nbRows; r++) {
 
-        // Warm-start the constraint if warm-starting is enabled
-        if (mIsWarmStartingActive) {
+        const JointLimitMotorRow& row = rows[r];
+
+        Vector3& v1 = linearVelocities[row.indexBody1];
+        Vector3& w1 = angularVelocities[row.indexBody1];
+        Vector3& v2 = linearVelocities[row.indexBody2];
+        Vector3& w2 = angularVelocities[row.indexBody2];
+
+        // Compute J*v
+        const decimal Jv = row.linearJacobianBody1.dot(v1) + row.angularJacobianBody1.dot(w1) +
+                           row.linearJacobianBody2.dot(v2) + row.angularJacobianBody2.dot(w2);
+
+        // Compute the Lagrange multiplier lambda and clamp the accumulated impulse
+        const decimal lambdaTemp = *row.impulse;
+        *row.impulse = clamp(lambdaTemp + row.inverseMass * (-Jv - row.bias), row.minImpulse, row.maxImpulse);
+        const decimal deltaLambda = *row.impulse - lambdaTemp;
+        impulseDelta = std::max(impulseDelta, std::abs(deltaLambda));
+
+        // Apply the impulse to the bodies
+        v1 += deltaLambda * row.linearVelocityChangeBody1;
+        w1 += deltaLambda * row.angularVelocityChangeBody1;
+        v2 += deltaLambda * row.linearVelocityChangeBody2;
+        w2 += deltaLambda * row.angularVelocityChangeBody2;
+    }
+
+    return impulseDelta;
+}
+
+// Warm start the constraints of a given island
+void ConstraintSolver::warmStart(uint islandIndex) {
+
+    assert(islandIndex < mNbIslands);
+    Island* island = mIslands[islandIndex];
+
+    assert(island != nullptr);
+    assert(island->getNbJoints() > 0);
+
+    // Warm-start the constraints if warm-starting is enabled
+    if (!mIsWarmStartingActive) return;
+
+    if (!isIslandBatched(island)) {
+
+        // For each joint of the island
+        Joint** joints = island->getJoints();
+        for (uint i=0; i<island->getNbJoints(); i++) {
+
+            // Warm-start the constraint
             joints[i]->warmstart(mConstraintSolverData);
         }
+
+        return;
     }
+
+    const uint* typesFirstIndex = getJointTypesFirstIndex(islandIndex);
+    const uint ballAndSocketType = static_cast<uint>(JointType::BALLSOCKETJOINT);
+    const uint firstBallAndSocketJoint = mIslandsFirstBallAndSocketJointIndex[islandIndex];
+
+    warmStartBallAndSocketJoints(firstBallAndSocketJoint, firstBallAndSocketJoint +
+                                 typesFirstIndex[ballAndSocketType + 1] - typesFirstIndex[ballAndSocketType]);
+    applyToJointsOfType<SliderJoint>(typesFirstIndex[static_cast<uint>(JointType::SLIDERJOINT)],
+                                     typesFirstIndex[static_cast<uint>(JointType::SLIDERJOINT) + 1],
+                                     JointSolverOperation::WARM_START);
+    applyToJointsOfType<HingeJoint>(typesFirstIndex[static_cast<uint>(JointType::HINGEJOINT)],
+                                    typesFirstIndex[static_cast<uint>(JointType::HINGEJOINT) + 1],
+                                    JointSolverOperation::WARM_START);
+    applyToJointsOfType<FixedJoint>(typesFirstIndex[static_cast<uint>(JointType::FIXEDJOINT)],
+                                    typesFirstIndex[static_cast<uint>(JointType::FIXEDJOINT) + 1],
+                                    JointSolverOperation::WARM_START);
 }
 
 // Solve the velocity constraints
-void ConstraintSolver::solveVelocityConstraints(Island* island) {
+/**
+ * @param islandIndex Index of the island to solve
+ * @return The largest absolute change of the impulses of the joints during this iteration
+ */
+decimal ConstraintSolver::solveVelocityConstraints(uint islandIndex) {
 
-    RP3D_PROFILE("ConstraintSolver::solveVelocityConstraints()", mProfiler);
+    assert(islandIndex < mNbIslands);
+    Island* island = mIslands[islandIndex];
 
     assert(island != nullptr);
     assert(island->getNbJoints() > 0);
 
-    // For each joint of the island
     Joint** joints = island->getJoints();
+
+    // If the joints are solved in batches
+    if (isIslandBatched(island)) {
+
+        const uint* typesFirstIndex = getJointTypesFirstIndex(islandIndex);
+        const uint ballAndSocketType = static_cast<uint>(JointType::BALLSOCKETJOINT);
+        const uint firstBallAndSocketJoint = mIslandsFirstBallAndSocketJointIndex[islandIndex];
+
+        decimal impulseDelta = solveBallAndSocketJoints(firstBallAndSocketJoint, firstBallAndSocketJoint +
+                                       typesFirstIndex[ballAndSocketType + 1] - typesFirstIndex[ballAndSocketType]);
+        applyToJointsOfType<SliderJoint>(typesFirstIndex[static_cast<uint>(JointType::SLIDERJOINT)],
+                                         typesFirstIndex[static_cast<uint>(JointType::SLIDERJOINT) + 1],
+                                         JointSolverOperation::SOLVE_VELOCITY);
+        applyToJointsOfType<HingeJoint>(typesFirstIndex[static_cast<uint>(JointType::HINGEJOINT)],
+                                        typesFirstIndex[static_cast<uint>(JointType::HINGEJOINT) + 1],
+                                        JointSolverOperation::SOLVE_VELOCITY);
+        applyToJointsOfType<FixedJoint>(typesFirstIndex[static_cast<uint>(JointType::FIXEDJOINT)],
+                                        typesFirstIndex[static_cast<uint>(JointType::FIXEDJOINT) + 1],
+                                        JointSolverOperation::SOLVE_VELOCITY);
+
+        // Largest change of impulse among the other joints of the island
+        for (uint i=typesFirstIndex[ballAndSocketType + 1]; i < typesFirstIndex[NB_JOINT_TYPES]; i++) {
+            impulseDelta = std::max(impulseDelta, mSortedJoints[i]->mVelocityImpulseDelta);
+        }
+
+        // Solve the limits and motors of the joints
+        return std::max(impulseDelta, solveLimitMotorRows(islandIndex));
+    }
+
+    // Solve exactly the joints of the articulations of the island
+    const bool hasArticulations = mArticulationSolver.hasArticulations(islandIndex);
+    if (hasArticulations) mArticulationSolver.solveVelocityConstraints(islandIndex, mConstraintSolverData);
+
+    // If the joints have been colored, solve the joints of each color in parallel
+    TaskScheduler* taskScheduler = mWorldSettings.taskScheduler;
+    if (island->getNbJointsColors() > 0 && taskScheduler != nullptr) {
+
+        const uint* colorsFirstIndex = island->getJointsColorsFirstIndex();
+        for (uint k=0; k < island->getNbJointsColors(); k++) {
+
+            Joint** colorJoints = joints + colorsFirstIndex[k];
+            taskScheduler->parallelForRange(colorsFirstIndex[k + 1] - colorsFirstIndex[k], MIN_NB_JOINTS_PER_TASK,
+                                            [this, colorJoints](uint begin, uint end) {
+                for (uint i=begin; i < end; i++) {
+                    if (colorJoints[i]->mIsInArticulation) continue;
+                    colorJoints[i]->solveVelocityConstraint(mConstraintSolverData);
+                }
+            });
+        }
+    }
+    else {
+
+        // For each joint of the island
+        for (uint i=0; i<island->getNbJoints(); i++) {
+
+            // The joints of the articulations have already been solved
+            if (hasArticulations && joints[i]->mIsInArticulation) continue;
+
+            // Solve the constraint
+            joints[i]->solveVelocityConstraint(mConstraintSolverData);
+        }
+    }
+
+    // Largest change of impulse among the joints of the island
+    decimal impulseDelta = decimal(0.0);
     for (uint i=0; i<island->getNbJoints(); i++) {
+        impulseDelta = std::max(impulseDelta, joints[i]->mVelocityImpulseDelta);
+    }
 
-        // Solve the constraint
-        joints[i]->solveVelocityConstraint(mConstraintSolverData);
+    // Solve the limits and motors of the joints
+    return std::max(impulseDelta, solveLimitMotorRows(islandIndex));
+}
+
+// Store the accumulated impulses of the batched joints of an island into the joints
+/// The impulses are used to warm start the joints at the next step. The joints of the
+/// island whose force or torque exceeds their break threshold are then marked as broken.
+void ConstraintSolver::storeImpulses(uint islandIndex) {
+
+    assert(islandIndex < mNbIslands);
+
+    if (isIslandBatched(mIslands[islandIndex])) {
+
+        const uint* typesFirstIndex = getJointTypesFirstIndex(islandIndex);
+        const uint ballAndSocketType = static_cast<uint>(JointType::BALLSOCKETJOINT);
+        const uint firstBallAndSocketJoint = mIslandsFirstBallAndSocketJointIndex[islandIndex];
+        const uint endBallAndSocketJoint = firstBallAndSocketJoint + typesFirstIndex[ballAndSocketType + 1] -
+                                           typesFirstIndex[ballAndSocketType];
+
+        for (uint b=firstBallAndSocketJoint; b < endBallAndSocketJoint; b++) {
+            mBallAndSocketJoints.joints[b]->mImpulse = mBallAndSocketJoints.impulse[b];
+        }
+    }
+
+    if (mIslandsNbBreakableJoints[islandIndex] == 0) return;
+
+    // Check the break threshold of the joints that have not been broken yet
+    Island* island = mIslands[islandIndex];
+    Joint** joints = island->getJoints();
+    for (uint i=0; i < island->getNbJoints(); i++) {
+        if (!joints[i]->isBreakable() || joints[i]->mIsBroken) continue;
+        if (joints[i]->updateIsBroken(mTimeStep)) mIslandsNbBrokenJoints[islandIndex]++;
     }
 }
 
 // Solve the position constraints
-void ConstraintSolver::solvePositionConstraints(Island* island) {
+void ConstraintSolver::solvePositionConstraints(uint islandIndex) {
 
-    RP3D_PROFILE("ConstraintSolver::solvePositionConstraints()", mProfiler);
+    assert(islandIndex < mNbIslands);
+    Island* island = mIslands[islandIndex];
 
     assert(island != nullptr);
     assert(island->getNbJoints() > 0);
 
-    // For each joint of the island
     Joint** joints = island->getJoints();
+
+    // If the joints are solved in batches
+    if (isIslandBatched(island)) {
+
+        const uint* typesFirstIndex = getJointTypesFirstIndex(islandIndex);
+        applyToJointsOfType<BallAndSocketJoint>(typesFirstIndex[static_cast<uint>(JointType::BALLSOCKETJOINT)],
+                                                typesFirstIndex[static_cast<uint>(JointType::BALLSOCKETJOINT) + 1],
+                                                JointSolverOperation::SOLVE_POSITION);
+        applyToJointsOfType<SliderJoint>(typesFirstIndex[static_cast<uint>(JointType::SLIDERJOINT)],
+                                         typesFirstIndex[static_cast<uint>(JointType::SLIDERJOINT) + 1],
+                                         JointSolverOperation::SOLVE_POSITION);
+        applyToJointsOfType<HingeJoint>(typesFirstIndex[static_cast<uint>(JointType::HINGEJOINT)],
+                                        typesFirstIndex[static_cast<uint>(JointType::HINGEJOINT) + 1],
+                                        JointSolverOperation::SOLVE_POSITION);
+        applyToJointsOfType<FixedJoint>(typesFirstIndex[static_cast<uint>(JointType::FIXEDJOINT)],
+                                        typesFirstIndex[static_cast<uint>(JointType::FIXEDJOINT) + 1],
+                                        JointSolverOperation::SOLVE_POSITION);
+        return;
+    }
+
+    // If the joints have been colored, solve the joints of each color in parallel
+    TaskScheduler* taskScheduler = mWorldSettings.taskScheduler;
+    if (island->getNbJointsColors() > 0 && taskScheduler != nullptr) {
+
+        const uint* colorsFirstIndex = island->getJointsColorsFirstIndex();
+        for (uint k=0; k < island->getNbJointsColors(); k++) {
+
+            Joint** colorJoints = joints + colorsFirstIndex[k];
+            taskScheduler->parallelForRange(colorsFirstIndex[k + 1] - colorsFirstIndex[k], MIN_NB_JOINTS_PER_TASK,
+                                            [this, colorJoints](uint begin, uint end) {
+                for (uint i=begin; i < end; i++) {
+                    colorJoints[i]->solvePositionConstraint(mConstraintSolverData);
+                }
+            });
+        }
+
+        return;
+    }
+
+    // For each joint of the island
     for (uint i=0; i < island->getNbJoints(); i++) {
 
         // Solve the constraint
         joints[i]->solvePositionConstraint(mConstraintSolverData);
     }
 }
+
+// Return the largest position error of the joints of an island when it was last measured
+/// The error of each joint is measured when the joint is initialized before the velocity
+/// solver and then before its correction at each iteration of the position solver
+/**
+ * @param islandIndex Index of the island
+ * @return The largest position error (distance in meters or angle in radians) of the joints
+ */
+decimal ConstraintSolver::getPositionError(uint islandIndex) const {
+
+    assert(islandIndex < mNbIslands);
+    Island* island = mIslands[islandIndex];
+
+    decimal positionError = decimal(0.0);
+    Joint** joints = island->getJoints();
+    for (uint i=0; i < island->getNbJoints(); i++) {
+        positionError = std::max(positionError, joints[i]->mPositionError);
+    }
+
+    return positionError;
+}
+
+// Warm start the ball-and-socket joints of a batch
+/// This is the same computation as BallAndSocketJoint::warmstart() with the data of the batch
+void ConstraintSolver::warmStartBallAndSocketJoints(uint startIndex, uint endIndex) {
+
+    Vector3* linearVelocities = mConstraintSolverData.linearVelocities;
+    Vector3* angularVelocities = mConstraintSolverData.angularVelocities;
+
+    for (uint b=startIndex; b < endIndex; b++) {
+
+        const uint indexBody1 = mBallAndSocketJoints.indexBody1[b];
+        const uint indexBody2 = mBallAndSocketJoints.indexBody2[b];
+        const Vector3& impulse = mBallAndSocketJoints.impulse[b];
+
+        // Apply the impulse P=J^T * lambda to the body 1
+        linearVelocities[indexBody1] -= mBallAndSocketJoints.massInverseBody1[b] * impulse;
+        angularVelocities[indexBody1] += mBallAndSocketJoints.inverseInertiaTensorBody1[b] *
+                                         impulse.cross(mBallAndSocketJoints.r1World[b]);
+
+        // Apply the impulse P=J^T * lambda to the body 2
+        linearVelocities[indexBody2] += mBallAndSocketJoints.massInverseBody2[b] * impulse;
+        angularVelocities[indexBody2] -= mBallAndSocketJoints.inverseInertiaTensorBody2[b] *
+                                         impulse.cross(mBallAndSocketJoints.r2World[b]);
+    }
+}
+
+// Solve the ball-and-socket joints of a batch and return the largest change of impulse
+/// This is the same computation as BallAndSocketJoint::solveVelocityConstraint() with the
+/// data of the batch
+decimal ConstraintSolver::solveBallAndSocketJoints(uint startIndex, uint endIndex) {
+
+    Vector3* linearVelocities = mConstraintSolverData.linearVelocities;
+    Vector3* angularVelocities = mConstraintSolverData.angularVelocities;
+
+    decimal impulseDelta = decimal(0.0);
+
+    for (uint b=startIndex; b < endIndex; b++) {
+
+        const uint indexBody1 = mBallAndSocketJoints.indexBody1[b];
+        const uint indexBody2 = mBallAndSocketJoints.indexBody2[b];
+        const Vector3& r1World = mBallAndSocketJoints.r1World[b];
+        const Vector3& r2World = mBallAndSocketJoints.r2World[b];
+
+        Vector3& v1 = linearVelocities[indexBody1];
+        Vector3& v2 = linearVelocities[indexBody2];
+        Vector3& w1 = angularVelocities[indexBody1];
+        Vector3& w2 = angularVelocities[indexBody2];
+
+        // Compute J*v
+        const Vector3 Jv = v2 + w2.cross(r2World) - v1 - w1.cross(r1World);
+
+        // Compute the Lagrange multiplier lambda
+        const Vector3 deltaLambda = mBallAndSocketJoints.inverseMassMatrix[b] * (-Jv - mBallAndSocketJoints.biasVector[b]) -
+                                    mBallAndSocketJoints.impulseScale[b] * mBallAndSocketJoints.impulse[b];
+        mBallAndSocketJoints.impulse[b] += deltaLambda;
+        impulseDelta = std::max(impulseDelta, deltaLambda.getAbsoluteVector().getMaxValue());
+
+        // Apply the impulse P=J^T * lambda to the body 1
+        v1 -= mBallAndSocketJoints.massInverseBody1[b] * deltaLambda;
+        w1 += mBallAndSocketJoints.inverseInertiaTensorBody1[b] * deltaLambda.cross(r1World);
+
+        // Apply the impulse P=J^T * lambda to the body 2
+        v2 += mBallAndSocketJoints.massInverseBody2[b] * deltaLambda;
+        w2 -= mBallAndSocketJoints.inverseInertiaTensorBody2[b] * deltaLambda.cross(r2World);
+    }
+
+    return impulseDelta;
+}
+
+// Apply an operation of the solver to the sorted joints of a given type without virtual calls
+template<typename JointClass>
+void ConstraintSolver::applyToJointsOfType(uint startIndex, uint endIndex, JointSolverOperation operation) {
+
+    switch (operation) {
+
+        case JointSolverOperation::INITIALIZE:
+            for (uint i=startIndex; i < endIndex; i++) {
+                static_cast<JointClass*>(mSortedJoints[i])->JointClass::initBeforeSolve(mConstraintSolverData);
+            }
+            break;
+
+        case JointSolverOperation::WARM_START:
+            for (uint i=startIndex; i < endIndex; i++) {
+                static_cast<JointClass*>(mSortedJoints[i])->JointClass::warmstart(mConstraintSolverData);
+            }
+            break;
+
+        case JointSolverOperation::SOLVE_VELOCITY:
+            for (uint i=startIndex; i < endIndex; i++) {
+                static_cast<JointClass*>(mSortedJoints[i])->JointClass::solveVelocityConstraint(mConstraintSolverData);
+            }
+            break;
+
+        case JointSolverOperation::SOLVE_POSITION:
+            for (uint i=startIndex; i < endIndex; i++) {
+                static_cast<JointClass*>(mSortedJoints[i])->JointClass::solvePositionConstraint(mConstraintSolverData);
+            }
+            break;
+    }
+}
@@ -29,13 +29,17 @@
 // Libraries
 #include "configuration.h"
 #include "mathematics/mathematics.h"
+#include "memory/ArenaAllocator.h"
+#include "constraint/Joint.h"
+#include "engine/ArticulationSolver.h"
 
 namespace reactphysics3d {
 
 // Declarations
-class Joint;
+class BallAndSocketJoint;
 class Island;
 class Profiler;
+class MemoryManager;
 
 // Structure ConstraintSolverData
 /**
@@ -64,14 +68,128 @@ struct ConstraintSolverData {
         /// True if warm starting of the solver is active
         bool isWarmStartingActive;
 
+        /// True if the joints reuse the solver data of their equality constraints while their
+        /// bodies do not move significantly
+        bool isJointSolverDataCacheEnabled;
+
+        /// Largest distance (in meters) and angle (in radians) moved by a body for the cached
+        /// solver data of its joints to be reused
+        decimal jointSolverDataCacheTolerance;
+
         /// Constructor
         ConstraintSolverData() :linearVelocities(nullptr), angularVelocities(nullptr),
-                                positions(nullptr), orientations(nullptr) {
+                                positions(nullptr), orientations(nullptr),
+                                isJointSolverDataCacheEnabled(false),
+                                jointSolverDataCacheTolerance(decimal(0.0)) {
 
         }
 
 };
 
+// Structure BallAndSocketJointsBatch
+/**
+ * This structure contains the data of the ball-and-socket joints that are solved
+ * together by the batched joint solver. Each attribute is a contiguous array with
+ * one element per joint so that the solve loop only reads the data it needs.
+ */
+struct BallAndSocketJointsBatch {
+
+    /// Joints of the batch
+    BallAndSocketJoint** joints;
+
+    /// Index of body 1 in the velocity arrays
+    uint* indexBody1;
+
+    /// Index of body 2 in the velocity arrays
+    uint* indexBody2;
+
+    /// Inverse mass of body 1
+    decimal* massInverseBody1;
+
+    /// Inverse mass of body 2
+    decimal* massInverseBody2;
+
+    /// Vector from center of body 1 to the anchor point in world-space
+    Vector3* r1World;
+
+    /// Vector from center of body 2 to the anchor point in world-space
+    Vector3* r2World;
+
+    /// Inverse inertia tensor of body 1 (in world-space)
+    Matrix3x3* inverseInertiaTensorBody1;
+
+    /// Inverse inertia tensor of body 2 (in world-space)
+    Matrix3x3* inverseInertiaTensorBody2;
+
+    /// Inverse mass matrix K=JM^-1J^-t of the constraint (scaled by the mass scale of
+    /// a soft constraint)
+    Matrix3x3* inverseMassMatrix;
+
+    /// Bias vector of the constraint
+    Vector3* biasVector;
+
+    /// Factor of the accumulated impulse removed at each iteration (zero if rigid)
+    decimal* impulseScale;
+
+    /// Accumulated impulse
+    Vector3* impulse;
+};
+
+// Structure JointLimitMotorRow
+/**
+ * This structure contains a one-dimensional limit or motor constraint of a joint that is
+ * active during the current step. The rows of an island are built when its joints are
+ * initialized so that the solver applies all of them with the same loop without testing
+ * the state of the limits and motor of each joint at every iteration.
+ */
+struct JointLimitMotorRow {
+
+    /// Index of body 1 in the velocity arrays
+    uint indexBody1;
+
+    /// Index of body 2 in the velocity arrays
+    uint indexBody2;
+
+    /// Linear part of the Jacobian for body 1
+    Vector3 linearJacobianBody1;
+
+    /// Angular part of the Jacobian for body 1
+    Vector3 angularJacobianBody1;
+
+    /// Linear part of the Jacobian for body 2
+    Vector3 linearJacobianBody2;
+
+    /// Angular part of the Jacobian for body 2
+    Vector3 angularJacobianBody2;
+
+    /// Change of the linear velocity of body 1 for a unit impulse of the row
+    Vector3 linearVelocityChangeBody1;
+
+    /// Change of the angular velocity of body 1 for a unit impulse of the row
+    Vector3 angularVelocityChangeBody1;
+
+    /// Change of the linear velocity of body 2 for a unit impulse of the row
+    Vector3 linearVelocityChangeBody2;
+
+    /// Change of the angular velocity of body 2 for a unit impulse of the row
+    Vector3 angularVelocityChangeBody2;
+
+    /// Inverse of the effective mass of the row
+    decimal inverseMass;
+
+    /// Bias of the row
+    decimal bias;
+
+    /// Lower bound of the accumulated impulse
+    decimal minImpulse;
+
+    /// Upper bound of the accumulated impulse
+    decimal maxImpulse;
+
+    /// Pointer to the accumulated impulse of the row in the joint
+    decimal* impulse;
+};
+
 // Class ConstraintSolver
 /**
  * This class represents the constraint solver that is used to solve constraints between
@@ -140,13 +258,44 @@ struct ConstraintSolverData {
  * constraints at the center of the contact manifold, we need two constraints for tangential
  * friction but also another twist friction constraint to prevent spin of the body around the
  * contact manifold center.
+ *
+ * If the joints of an island have been colored, the joints of each color are solved in
+ * parallel with the task scheduler of the world.
+ *
+ * If the joints batching is enabled in the world settings (and the joints of the island
+ * are not solved in parallel), the joints of each island are sorted by type. The joints of
+ * each type are then solved in a single loop without virtual calls and the ball-and-socket
+ * joints, that are the most common joints of ragdolls, are solved with the contiguous arrays
+ * of a BallAndSocketJointsBatch.
+ *
+ * If the articulation solver is enabled in the world settings, the joints of an island that
+ * form a tree are solved exactly at each iteration by the ArticulationSolver and the other
+ * joints of the island are solved with the sequential impulses.
+ *
+ * The limits and motors of the joints are not solved by the joints themselves. The rows of
+ * the active limits and motors of an island are gathered into a compact array of
+ * JointLimitMotorRow when the island is initialized and they are solved after the other
+ * constraints of the joints at each iteration.
  */
 class ConstraintSolver {
 
     private :
 
+        // -------------------- Constants --------------------- //
+
+        /// Minimum number of joints of a color solved by a single task
+        static const uint MIN_NB_JOINTS_PER_TASK = 8;
+
+        // -------------------- Types -------------------- //
+
+        /// Operations of the solver applied to the joints
+        enum class JointSolverOperation {INITIALIZE, WARM_START, SOLVE_VELOCITY, SOLVE_POSITION};
+
         // -------------------- Attributes -------------------- //
 
+        /// World settings
+        const WorldSettings& mWorldSettings;
+
         /// Current time step
         decimal mTimeStep;
 
@@ -156,30 +305,110 @@ class ConstraintSolver {
         /// Constraint solver data used to initialize and solve the constraints
         ConstraintSolverData mConstraintSolverData;
 
+        /// Memory arena used to allocate the joints batches (reset at each step)
+        ArenaAllocator mArena;
+
+        /// Array of islands of the current step
+        Island** mIslands;
+
+        /// Number of islands of the current step
+        uint mNbIslands;
+
+        /// Joints of the batched islands sorted by type
+        Joint** mSortedJoints;
+
+        /// For each batched island, index of the first joint of each type in the array of
+        /// sorted joints (NB_JOINT_TYPES + 1 entries per island)
+        uint* mIslandsJointTypesFirstIndex;
+
+        /// Index of the first ball-and-socket joint of each island in the batch
+        uint* mIslandsFirstBallAndSocketJointIndex;
+
+        /// Ball-and-socket joints of the batched islands
+        BallAndSocketJointsBatch mBallAndSocketJoints;
+
+        /// Solver of the joints that form articulations
+        ArticulationSolver mArticulationSolver;
+
+        /// Rows of the active limits and motors of the joints of the islands
+        JointLimitMotorRow* mLimitMotorRows;
+
+        /// Index of the first limit or motor row of each island
+        uint* mIslandsFirstLimitMotorRowIndex;
+
+        /// Number of active limit and motor rows of each island
+        uint* mIslandsNbLimitMotorRows;
+
+        /// Number of joints of each island that can break
+        uint* mIslandsNbBreakableJoints;
+
+        /// Number of joints of each island that have been broken during the current step
+        uint* mIslandsNbBrokenJoints;
+
 #ifdef IS_PROFILING_ACTIVE
 
 		/// Pointer to the profiler
 		Profiler* mProfiler;
 #endif
 
+        // -------------------- Methods -------------------- //
+
+        /// Return true if the joints of an island are solved in batches
+        bool isIslandBatched(const Island* island) const;
+
+        /// Return the array with the index of the first joint of each type of an island
+        const uint* getJointTypesFirstIndex(uint islandIndex) const;
+
+        /// Warm start the ball-and-socket joints of a batch
+        void warmStartBallAndSocketJoints(uint startIndex, uint endIndex);
+
+        /// Solve the ball-and-socket joints of a batch and return the largest change of impulse
+        decimal solveBallAndSocketJoints(uint startIndex, uint endIndex);
+
+        /// Build the rows of the active limits and motors of the joints of an island
+        void initializeLimitMotorRows(uint islandIndex);
+
+        /// Solve the limit and motor rows of an island and return the largest change of impulse
+        decimal solveLimitMotorRows(uint islandIndex);
+
+        /// Apply an operation of the solver to the sorted joints of a given type without virtual calls
+        template<typename JointClass>
+        void applyToJointsOfType(uint startIndex, uint endIndex, JointSolverOperation operation);
+
     public :
 
         // -------------------- Methods -------------------- //
 
         /// Constructor
-        ConstraintSolver();
+        ConstraintSolver(MemoryManager& memoryManager, const WorldSettings& worldSettings);
 
         /// Destructor
         ~ConstraintSolver() = default;
 
+        /// Allocate the joints batches of the islands
+        void init(Island** islands, uint nbIslands);
+
         /// Initialize the constraint solver for a given island
-        void initializeForIsland(decimal dt, Island* island);
+        void initializeForIsland(decimal dt, uint islandIndex);
+
+        /// Warm start the constraints of a given island
+        void warmStart(uint islandIndex);
+
+        /// Solve the constraints and return the largest change of impulse of the joints
+        decimal solveVelocityConstraints(uint islandIndex);
 
-        /// Solve the constraints
-        void solveVelocityConstraints(Island* island);
+        /// Store the accumulated impulses of the batched joints of an island into the joints
+        /// and mark the joints that exceed their break threshold
+        void storeImpulses(uint islandIndex);
+
+        /// Return the number of joints of an island that have been broken during the current step
+        uint getNbBrokenJoints(uint islandIndex) const;
 
         /// Solve the position constraints
-        void solvePositionConstraints(Island* island);
+        void solvePositionConstraints(uint islandIndex);
+
+        /// Return the largest position error of the joints of an island when it was last measured
+        decimal getPositionError(uint islandIndex) const;
 
         /// Return true if the Non-Linear-Gauss-Seidel position correction technique is active
         bool getIsNonLinearGaussSeidelPositionCorrectionActive() const;
@@ -226,11 +455,24 @@ inline void ConstraintSolver::setConstrainedPositionsArrays(Vector3* constrained
     mConstraintSolverData.orientations = constrainedOrientations;
 }
 
+// Return the number of joints of an island that have been broken during the current step
+inline uint ConstraintSolver::getNbBrokenJoints(uint islandIndex) const {
+    assert(islandIndex < mNbIslands);
+    return mIslandsNbBrokenJoints[islandIndex];
+}
+
+// Return the array with the index of the first joint of each type of an island
+inline const uint* ConstraintSolver::getJointTypesFirstIndex(uint islandIndex) const {
+    assert(islandIndex < mNbIslands);
+    return mIslandsJointTypesFirstIndex + islandIndex * (NB_JOINT_TYPES + 1);
+}
+
 #ifdef IS_PROFILING_ACTIVE
 
 // Set the profiler
 inline void ConstraintSolver::setProfiler(Profiler* profiler) {
 	mProfiler = profiler;
+	mArticulationSolver.setProfiler(profiler);
 }
 
 #endif
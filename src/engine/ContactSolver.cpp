@@ -30,7 +30,11 @@
 #include "constraint/ContactPoint.h"
 #include "utils/Profiler.h"
 #include "engine/Island.h"
+#include "engine/TaskScheduler.h"
+#include "engine/Vehicle.h"
 #include "collision/ContactManifold.h"
+#include <cstring>
+#include <mutex>
 
 using namespace reactphysics3d;
 using namespace std;
@@ -39,13 +43,21 @@ using namespace std;
 const decimal ContactSolver::BETA = decimal(0.2);
 const decimal ContactSolver::BETA_SPLIT_IMPULSE = decimal(0.2);
 const decimal ContactSolver::SLOP = decimal(0.01);
+const decimal ContactSolver::BLOCK_SOLVER_REGULARIZATION = decimal(0.001);
+const decimal ContactSolver::BLOCK_SOLVER_TOLERANCE = decimal(0.00001);
 
 // Constructor
-ContactSolver::ContactSolver(MemoryManager& memoryManager, const WorldSettings& worldSettings)
-              :mMemoryManager(memoryManager), mSplitLinearVelocities(nullptr),
+ContactSolver::ContactSolver(MemoryManager& memoryManager, const WorldSettings& worldSettings,
+                             const MaterialTable& materialTable)
+              :mMemoryManager(memoryManager), mArena(memoryManager.getBaseAllocator(MemoryTag::Solver)), mSplitLinearVelocities(nullptr),
                mSplitAngularVelocities(nullptr), mContactConstraints(nullptr),
-               mContactPoints(nullptr), mLinearVelocities(nullptr), mAngularVelocities(nullptr),
-               mIsSplitImpulseActive(true), mWorldSettings(worldSettings) {
+               mContactPoints(nullptr), mContactBlocks(nullptr), mNbContactPoints(0), mNbContactManifolds(0), mIslands(nullptr),
+               mNbIslands(0), mIslandsFirstContactManifoldIndex(nullptr), mIslandsFirstContactPointIndex(nullptr),
+               mIslandsSolverFeatures(nullptr), mIslandsNbReusedContactPoints(nullptr),
+               mIslandsContactGroups(nullptr), mIslandsNbContactGroups(nullptr), mIslandsContactGroupsColorsFirstIndex(nullptr),
+               mWheelConstraints(nullptr), mIslandsFirstWheelIndex(nullptr), mLinearVelocities(nullptr), mAngularVelocities(nullptr),
+               mIsSplitImpulseActive(worldSettings.contactFrequency <= decimal(0.0)), mWorldSettings(worldSettings),
+               mMaterialTable(materialTable) {
 
 #ifdef IS_PROFILING_ACTIVE
         mProfiler = nullptr;
@@ -54,16 +66,45 @@ ContactSolver::ContactSolver(MemoryManager& memoryManager, const WorldSettings&
 }
 
 // Initialize the contact constraints
+/// This method allocates the memory for the contact constraints of all the islands.
+/// The constraints of each island must then be initialized with initializeForIsland().
+/// The memory is allocated in the arena of the solver that is reused from one
+/// step to the next, this method releases the memory of the previous step.
 void ContactSolver::init(Island** islands, uint nbIslands, decimal timeStep) {
 
     RP3D_PROFILE("ContactSolver::init()", mProfiler);
 
+    mArena.reset();
+
     mTimeStep = timeStep;
 
+    // Compute the coefficients of the soft contacts for the time step
+    mContactSoftness = SoftConstraintCoefficients::compute(mWorldSettings.contactFrequency,
+                                                           mWorldSettings.contactDampingRatio, timeStep);
+    mIslands = islands;
+    mNbIslands = nbIslands;
+
+    // Allocate the arrays with the index of the first contact manifold and contact point of each island
+    mIslandsFirstContactManifoldIndex = static_cast<uint*>(mArena.allocate(sizeof(uint) * (nbIslands + 1)));
+    mIslandsFirstContactPointIndex = static_cast<uint*>(mArena.allocate(sizeof(uint) * (nbIslands + 1)));
+    assert(mIslandsFirstContactManifoldIndex != nullptr);
+    assert(mIslandsFirstContactPointIndex != nullptr);
+
+    // The solver features of an island are computed when its constraints are initialized
+    mIslandsSolverFeatures = static_cast<uint8*>(mArena.allocate(sizeof(uint8) * nbIslands));
+
+    // The reused contact points of an island are counted when its constraints are initialized
+    mIslandsNbReusedContactPoints = static_cast<uint*>(mArena.allocate(sizeof(uint) * nbIslands));
+    std::memset(mIslandsNbReusedContactPoints, 0, sizeof(uint) * nbIslands);
+
     // TODO : Try not to count manifolds and contact points here
     uint nbContactManifolds = 0;
     uint nbContactPoints = 0;
     for (uint i = 0; i < nbIslands; i++) {
+
+        mIslandsFirstContactManifoldIndex[i] = nbContactManifolds;
+        mIslandsFirstContactPointIndex[i] = nbContactPoints;
+
         uint nbManifoldsInIsland = islands[i]->getNbContactManifolds();
         nbContactManifolds += nbManifoldsInIsland;
 
@@ -71,47 +112,85 @@ void ContactSolver::init(Island** islands, uint nbIslands, decimal timeStep) {
             nbContactPoints += islands[i]->getContactManifolds()[j]->getNbContactPoints();
         }
     }
+    mIslandsFirstContactManifoldIndex[nbIslands] = nbContactManifolds;
+    mIslandsFirstContactPointIndex[nbIslands] = nbContactPoints;
+
+    // Allocate the arrays with the groups of contact manifolds of the wide contact solver.
+    // The groups of an island are computed the first time the island is initialized.
+    mIslandsContactGroups = nullptr;
+    mIslandsNbContactGroups = nullptr;
+    mIslandsContactGroupsColorsFirstIndex = nullptr;
+    if (mWorldSettings.isWideContactSolverEnabled && !mWorldSettings.isBlockContactSolverEnabled && nbIslands > 0) {
+        mIslandsContactGroups = static_cast<ContactGroupSolver**>(mArena.allocate(sizeof(ContactGroupSolver*) * nbIslands));
+        mIslandsNbContactGroups = static_cast<uint*>(mArena.allocate(sizeof(uint) * nbIslands));
+        mIslandsContactGroupsColorsFirstIndex = static_cast<uint**>(mArena.allocate(sizeof(uint*) * nbIslands));
+        for (uint i=0; i < nbIslands; i++) {
+            mIslandsContactGroups[i] = nullptr;
+            mIslandsNbContactGroups[i] = 0;
+            mIslandsContactGroupsColorsFirstIndex[i] = nullptr;
+        }
+    }
 
-    mNbContactManifolds = 0;
-    mNbContactPoints = 0;
+    mNbContactManifolds = nbContactManifolds;
+    mNbContactPoints = nbContactPoints;
+
+    // The wheel constraints are allocated by initWheels()
+    mWheelConstraints = nullptr;
+    mIslandsFirstWheelIndex = nullptr;
 
     mContactConstraints = nullptr;
+    mContactConstraintsColdData = nullptr;
     mContactPoints = nullptr;
+    mContactPointsColdData = nullptr;
+    mContactBlocks = nullptr;
 
     if (nbContactManifolds == 0 || nbContactPoints == 0) return;
 
     // TODO : Count exactly the number of constraints to allocate here
-    mContactPoints = static_cast<ContactPointSolver*>(mMemoryManager.allocate(MemoryManager::AllocationType::Frame,
-                                                                              sizeof(ContactPointSolver) * nbContactPoints));
+    mContactPoints = static_cast<ContactPointSolver*>(mArena.allocate(sizeof(ContactPointSolver) * nbContactPoints));
+    mContactPointsColdData = static_cast<ContactPointSolverColdData*>(mArena.allocate(sizeof(ContactPointSolverColdData) * nbContactPoints));
     assert(mContactPoints != nullptr);
+    assert(mContactPointsColdData != nullptr);
 
-    mContactConstraints = static_cast<ContactManifoldSolver*>(mMemoryManager.allocate(MemoryManager::AllocationType::Frame,
-                                                                                      sizeof(ContactManifoldSolver) * nbContactManifolds));
+    mContactConstraints = static_cast<ContactManifoldSolver*>(mArena.allocate(sizeof(ContactManifoldSolver) * nbContactManifolds));
+    mContactConstraintsColdData = static_cast<ContactManifoldSolverColdData*>(mArena.allocate(sizeof(ContactManifoldSolverColdData) * nbContactManifolds));
     assert(mContactConstraints != nullptr);
+    assert(mContactConstraintsColdData != nullptr);
 
-    // For each island of the world
-    for (uint islandIndex = 0; islandIndex < nbIslands; islandIndex++) {
-
-        if (islands[islandIndex]->getNbContactManifolds() > 0) {
-            initializeForIsland(islands[islandIndex]);
-        }
+    // The block solver does not support the soft contacts
+    if (mWorldSettings.isBlockContactSolverEnabled && !isContactSoft()) {
+        mContactBlocks = static_cast<ContactManifoldBlockSolver*>(mArena.allocate(sizeof(ContactManifoldBlockSolver) * nbContactManifolds));
+        assert(mContactBlocks != nullptr);
     }
-
-    // Warmstarting
-    warmStart();
 }
 
 // Initialize the constraint solver for a given island
-void ContactSolver::initializeForIsland(Island* island) {
+/// If the contacts are reprojected, the penetration depth of each contact point is
+/// recomputed from the current transforms of the bodies instead of using the depth
+/// computed by the narrow-phase. This is used to reuse the contacts of the
+/// narrow-phase between the substeps of a step.
+/**
+ * @param islandIndex Index of the island to initialize
+ * @param reprojectContacts True if the penetration depths must be recomputed
+ */
+void ContactSolver::initializeForIsland(uint islandIndex, bool reprojectContacts) {
 
     RP3D_PROFILE("ContactSolver::initializeForIsland()", mProfiler);
 
-    assert(island != nullptr);
+    assert(islandIndex < mNbIslands);
+    Island* island = mIslands[islandIndex];
     assert(island->getNbBodies() > 0);
     assert(island->getNbContactManifolds() > 0);
     assert(mSplitLinearVelocities != nullptr);
     assert(mSplitAngularVelocities != nullptr);
 
+    // Index of the first contact manifold and contact point of the island in the constraints arrays
+    uint manifoldIndex = mIslandsFirstContactManifoldIndex[islandIndex];
+    uint contactPointIndex = mIslandsFirstContactPointIndex[islandIndex];
+
+    mIslandsSolverFeatures[islandIndex] = 0;
+    mIslandsNbReusedContactPoints[islandIndex] = 0;
+
     // For each contact manifold of the island
     ContactManifold** contactManifolds = island->getContactManifolds();
     for (uint i=0; i<island->getNbContactManifolds(); i++) {
@@ -131,31 +210,43 @@ void ContactSolver::initializeForIsland(Island* island) {
         const ProxyShape* shape2 = externalManifold->getShape2();
 
         // Get the position of the two bodies
-        const Vector3& x1 = body1->mCenterOfMassWorld;
-        const Vector3& x2 = body2->mCenterOfMassWorld;
+        const Vector3& x1 = body1->getCenterOfMassWorld();
+        const Vector3& x2 = body2->getCenterOfMassWorld();
 
         // Initialize the internal contact manifold structure using the external
         // contact manifold
-        new (mContactConstraints + mNbContactManifolds) ContactManifoldSolver();
-        mContactConstraints[mNbContactManifolds].indexBody1 = body1->mArrayIndex;
-        mContactConstraints[mNbContactManifolds].indexBody2 = body2->mArrayIndex;
-        mContactConstraints[mNbContactManifolds].inverseInertiaTensorBody1 = body1->getInertiaTensorInverseWorld();
-        mContactConstraints[mNbContactManifolds].inverseInertiaTensorBody2 = body2->getInertiaTensorInverseWorld();
-        mContactConstraints[mNbContactManifolds].massInverseBody1 = body1->mMassInverse;
-        mContactConstraints[mNbContactManifolds].massInverseBody2 = body2->mMassInverse;
-        mContactConstraints[mNbContactManifolds].nbContacts = externalManifold->getNbContactPoints();
-        mContactConstraints[mNbContactManifolds].frictionCoefficient = computeMixedFrictionCoefficient(body1, body2);
-        mContactConstraints[mNbContactManifolds].rollingResistanceFactor = computeMixedRollingResistance(body1, body2);
-        mContactConstraints[mNbContactManifolds].externalContactManifold = externalManifold;
-        mContactConstraints[mNbContactManifolds].normal.setToZero();
-        mContactConstraints[mNbContactManifolds].frictionPointBody1.setToZero();
-        mContactConstraints[mNbContactManifolds].frictionPointBody2.setToZero();
+        new (mContactConstraints + manifoldIndex) ContactManifoldSolver();
+        mContactConstraints[manifoldIndex].indexBody1 = body1->mArrayIndex;
+        mContactConstraints[manifoldIndex].indexBody2 = body2->mArrayIndex;
+        mContactConstraints[manifoldIndex].inverseInertiaTensorBody1 = body1->getInertiaTensorInverseWorld();
+        mContactConstraints[manifoldIndex].inverseInertiaTensorBody2 = body2->getInertiaTensorInverseWorld();
+        mContactConstraints[manifoldIndex].massInverseBody1 = body1->mMassInverse;
+        mContactConstraints[manifoldIndex].massInverseBody2 = body2->mMassInverse;
+        mContactConstraints[manifoldIndex].isBody1Dynamic = body1->getType() == BodyType::DYNAMIC;
+        mContactConstraints[manifoldIndex].isBody2Dynamic = body2->getType() == BodyType::DYNAMIC;
+        mContactConstraints[manifoldIndex].nbContacts = externalManifold->getNbContactPoints();
+        mContactConstraints[manifoldIndex].contactPointIndex = contactPointIndex;
+        // Combine the materials of the two bodies (precomputed for registered materials)
+        const MaterialPairProperties materialProperties = mMaterialTable.computePairProperties(body1->getMaterial(),
+                                                                                               body2->getMaterial());
+        mContactConstraints[manifoldIndex].frictionCoefficient = materialProperties.frictionCoefficient;
+        mContactConstraints[manifoldIndex].rollingResistanceFactor = materialProperties.rollingResistance;
+        if (mContactConstraints[manifoldIndex].rollingResistanceFactor > decimal(0.0)) {
+            mIslandsSolverFeatures[islandIndex] |= SOLVER_FEATURE_ROLLING_RESISTANCE;
+        }
+        new (mContactConstraintsColdData + manifoldIndex) ContactManifoldSolverColdData();
+        mContactConstraintsColdData[manifoldIndex].externalContactManifold = externalManifold;
+        mContactConstraints[manifoldIndex].normal.setToZero();
+
+        // Points on the bodies where to apply the friction constraints
+        Vector3 frictionPointBody1(0, 0, 0);
+        Vector3 frictionPointBody2(0, 0, 0);
 
         // Get the velocities of the bodies
-        const Vector3& v1 = mLinearVelocities[mContactConstraints[mNbContactManifolds].indexBody1];
-        const Vector3& w1 = mAngularVelocities[mContactConstraints[mNbContactManifolds].indexBody1];
-        const Vector3& v2 = mLinearVelocities[mContactConstraints[mNbContactManifolds].indexBody2];
-        const Vector3& w2 = mAngularVelocities[mContactConstraints[mNbContactManifolds].indexBody2];
+        const Vector3& v1 = mLinearVelocities[mContactConstraints[manifoldIndex].indexBody1];
+        const Vector3& w1 = mAngularVelocities[mContactConstraints[manifoldIndex].indexBody1];
+        const Vector3& v2 = mLinearVelocities[mContactConstraints[manifoldIndex].indexBody2];
+        const Vector3& w2 = mAngularVelocities[mContactConstraints[manifoldIndex].indexBody2];
 
         // For each  contact point of the contact manifold
         ContactPoint* externalContact = externalManifold->getContactPoints();
@@ -166,163 +257,661 @@ void ContactSolver::initializeForIsland(Island* island) {
             Vector3 p1 = shape1->getLocalToWorldTransform() * externalContact->getLocalPointOnShape1();
             Vector3 p2 = shape2->getLocalToWorldTransform() * externalContact->getLocalPointOnShape2();
 
-            new (mContactPoints + mNbContactPoints) ContactPointSolver();
-            mContactPoints[mNbContactPoints].externalContact = externalContact;
-            mContactPoints[mNbContactPoints].normal = externalContact->getNormal();
-            mContactPoints[mNbContactPoints].r1.x = p1.x - x1.x;
-            mContactPoints[mNbContactPoints].r1.y = p1.y - x1.y;
-            mContactPoints[mNbContactPoints].r1.z = p1.z - x1.z;
-            mContactPoints[mNbContactPoints].r2.x = p2.x - x2.x;
-            mContactPoints[mNbContactPoints].r2.y = p2.y - x2.y;
-            mContactPoints[mNbContactPoints].r2.z = p2.z - x2.z;
-            mContactPoints[mNbContactPoints].penetrationDepth = externalContact->getPenetrationDepth();
-            mContactPoints[mNbContactPoints].isRestingContact = externalContact->getIsRestingContact();
+            new (mContactPoints + contactPointIndex) ContactPointSolver();
+            new (mContactPointsColdData + contactPointIndex) ContactPointSolverColdData();
+            mContactPointsColdData[contactPointIndex].externalContact = externalContact;
+            mContactPoints[contactPointIndex].normal = externalContact->getNormal();
+            mContactPoints[contactPointIndex].r1.x = p1.x - x1.x;
+            mContactPoints[contactPointIndex].r1.y = p1.y - x1.y;
+            mContactPoints[contactPointIndex].r1.z = p1.z - x1.z;
+            mContactPoints[contactPointIndex].r2.x = p2.x - x2.x;
+            mContactPoints[contactPointIndex].r2.y = p2.y - x2.y;
+            mContactPoints[contactPointIndex].r2.z = p2.z - x2.z;
+            const decimal penetrationDepth = reprojectContacts ?
+                        (p1 - p2).dot(mContactPoints[contactPointIndex].normal) :
+                        externalContact->getPenetrationDepth();
+            mContactPointsColdData[contactPointIndex].isRestingContact = externalContact->getIsRestingContact();
+
+            // Compute the penetration depth bias "b" of the constraint
+            // (the penetration of a soft contact is corrected by the spring of the constraint)
+            const decimal beta = mIsSplitImpulseActive ? BETA_SPLIT_IMPULSE : BETA;
+            const decimal biasRate = isContactSoft() ? mContactSoftness.biasRate : beta / mTimeStep;
+            mContactPoints[contactPointIndex].biasPenetrationDepth = 0.0;
+            if (penetrationDepth > SLOP) mContactPoints[contactPointIndex].biasPenetrationDepth = -biasRate *
+                    max(0.0f, float(penetrationDepth - SLOP));
             externalContact->setIsRestingContact(true);
-            mContactPoints[mNbContactPoints].penetrationImpulse = externalContact->getPenetrationImpulse();
-            mContactPoints[mNbContactPoints].penetrationSplitImpulse = 0.0;
+            mContactPoints[contactPointIndex].penetrationImpulse = externalContact->getPenetrationImpulse();
+            mContactPoints[contactPointIndex].penetrationSplitImpulse = 0.0;
 
-            mContactConstraints[mNbContactManifolds].frictionPointBody1.x += p1.x;
-            mContactConstraints[mNbContactManifolds].frictionPointBody1.y += p1.y;
-            mContactConstraints[mNbContactManifolds].frictionPointBody1.z += p1.z;
-            mContactConstraints[mNbContactManifolds].frictionPointBody2.x += p2.x;
-            mContactConstraints[mNbContactManifolds].frictionPointBody2.y += p2.y;
-            mContactConstraints[mNbContactManifolds].frictionPointBody2.z += p2.z;
+            frictionPointBody1.x += p1.x;
+            frictionPointBody1.y += p1.y;
+            frictionPointBody1.z += p1.z;
+            frictionPointBody2.x += p2.x;
+            frictionPointBody2.y += p2.y;
+            frictionPointBody2.z += p2.z;
 
             // Compute the velocity difference
-            //deltaV = v2 + w2.cross(mContactPoints[mNbContactPoints].r2) - v1 - w1.cross(mContactPoints[mNbContactPoints].r1);
-            Vector3 deltaV(v2.x + w2.y * mContactPoints[mNbContactPoints].r2.z - w2.z * mContactPoints[mNbContactPoints].r2.y
-                           - v1.x - w1.y * mContactPoints[mNbContactPoints].r1.z - w1.z * mContactPoints[mNbContactPoints].r1.y,
-                           v2.y + w2.z * mContactPoints[mNbContactPoints].r2.x - w2.x * mContactPoints[mNbContactPoints].r2.z
-                           - v1.y - w1.z * mContactPoints[mNbContactPoints].r1.x - w1.x * mContactPoints[mNbContactPoints].r1.z,
-                           v2.z + w2.x * mContactPoints[mNbContactPoints].r2.y - w2.y * mContactPoints[mNbContactPoints].r2.x
-                           - v1.z - w1.x * mContactPoints[mNbContactPoints].r1.y - w1.y * mContactPoints[mNbContactPoints].r1.x);
-
-            // r1CrossN = mContactPoints[mNbContactPoints].r1.cross(mContactPoints[mNbContactPoints].normal);
-            Vector3 r1CrossN(mContactPoints[mNbContactPoints].r1.y * mContactPoints[mNbContactPoints].normal.z -
-                             mContactPoints[mNbContactPoints].r1.z * mContactPoints[mNbContactPoints].normal.y,
-                             mContactPoints[mNbContactPoints].r1.z * mContactPoints[mNbContactPoints].normal.x -
-                             mContactPoints[mNbContactPoints].r1.x * mContactPoints[mNbContactPoints].normal.z,
-                             mContactPoints[mNbContactPoints].r1.x * mContactPoints[mNbContactPoints].normal.y -
-                             mContactPoints[mNbContactPoints].r1.y * mContactPoints[mNbContactPoints].normal.x);
-            // r2CrossN = mContactPoints[mNbContactPoints].r2.cross(mContactPoints[mNbContactPoints].normal);
-            Vector3 r2CrossN(mContactPoints[mNbContactPoints].r2.y * mContactPoints[mNbContactPoints].normal.z -
-                             mContactPoints[mNbContactPoints].r2.z * mContactPoints[mNbContactPoints].normal.y,
-                             mContactPoints[mNbContactPoints].r2.z * mContactPoints[mNbContactPoints].normal.x -
-                             mContactPoints[mNbContactPoints].r2.x * mContactPoints[mNbContactPoints].normal.z,
-                             mContactPoints[mNbContactPoints].r2.x * mContactPoints[mNbContactPoints].normal.y -
-                             mContactPoints[mNbContactPoints].r2.y * mContactPoints[mNbContactPoints].normal.x);
-
-            mContactPoints[mNbContactPoints].i1TimesR1CrossN = mContactConstraints[mNbContactManifolds].inverseInertiaTensorBody1 * r1CrossN;
-            mContactPoints[mNbContactPoints].i2TimesR2CrossN = mContactConstraints[mNbContactManifolds].inverseInertiaTensorBody2 * r2CrossN;
-
-            // Compute the inverse mass matrix K for the penetration constraint
-            decimal massPenetration = mContactConstraints[mNbContactManifolds].massInverseBody1 + mContactConstraints[mNbContactManifolds].massInverseBody2 +
-                    ((mContactPoints[mNbContactPoints].i1TimesR1CrossN).cross(mContactPoints[mNbContactPoints].r1)).dot(mContactPoints[mNbContactPoints].normal) +
-                    ((mContactPoints[mNbContactPoints].i2TimesR2CrossN).cross(mContactPoints[mNbContactPoints].r2)).dot(mContactPoints[mNbContactPoints].normal);
-            mContactPoints[mNbContactPoints].inversePenetrationMass = massPenetration > decimal(0.0) ? decimal(1.0) / massPenetration : decimal(0.0);
+            //deltaV = v2 + w2.cross(mContactPoints[contactPointIndex].r2) - v1 - w1.cross(mContactPoints[contactPointIndex].r1);
+            Vector3 deltaV(v2.x + w2.y * mContactPoints[contactPointIndex].r2.z - w2.z * mContactPoints[contactPointIndex].r2.y
+                           - v1.x - w1.y * mContactPoints[contactPointIndex].r1.z - w1.z * mContactPoints[contactPointIndex].r1.y,
+                           v2.y + w2.z * mContactPoints[contactPointIndex].r2.x - w2.x * mContactPoints[contactPointIndex].r2.z
+                           - v1.y - w1.z * mContactPoints[contactPointIndex].r1.x - w1.x * mContactPoints[contactPointIndex].r1.z,
+                           v2.z + w2.x * mContactPoints[contactPointIndex].r2.y - w2.y * mContactPoints[contactPointIndex].r2.x
+                           - v1.z - w1.x * mContactPoints[contactPointIndex].r1.y - w1.y * mContactPoints[contactPointIndex].r1.x);
+
+            // A resting contact point whose bodies have not moved significantly relative to the
+            // contact reuses the lever arm products and the inverse mass computed at a previous step
+            if (mContactPointsColdData[contactPointIndex].isRestingContact &&
+                canReuseContactPointSolverData(externalContact, mContactPoints[contactPointIndex], body1, body2)) {
+
+                mContactPoints[contactPointIndex].i1TimesR1CrossN = externalContact->mCachedI1TimesR1CrossN;
+                mContactPoints[contactPointIndex].i2TimesR2CrossN = externalContact->mCachedI2TimesR2CrossN;
+                mContactPoints[contactPointIndex].inversePenetrationMass = externalContact->mCachedInversePenetrationMass;
+                mIslandsNbReusedContactPoints[islandIndex]++;
+            }
+            else {
+
+                // r1CrossN = mContactPoints[contactPointIndex].r1.cross(mContactPoints[contactPointIndex].normal);
+                Vector3 r1CrossN(mContactPoints[contactPointIndex].r1.y * mContactPoints[contactPointIndex].normal.z -
+                                 mContactPoints[contactPointIndex].r1.z * mContactPoints[contactPointIndex].normal.y,
+                                 mContactPoints[contactPointIndex].r1.z * mContactPoints[contactPointIndex].normal.x -
+                                 mContactPoints[contactPointIndex].r1.x * mContactPoints[contactPointIndex].normal.z,
+                                 mContactPoints[contactPointIndex].r1.x * mContactPoints[contactPointIndex].normal.y -
+                                 mContactPoints[contactPointIndex].r1.y * mContactPoints[contactPointIndex].normal.x);
+                // r2CrossN = mContactPoints[contactPointIndex].r2.cross(mContactPoints[contactPointIndex].normal);
+                Vector3 r2CrossN(mContactPoints[contactPointIndex].r2.y * mContactPoints[contactPointIndex].normal.z -
+                                 mContactPoints[contactPointIndex].r2.z * mContactPoints[contactPointIndex].normal.y,
+                                 mContactPoints[contactPointIndex].r2.z * mContactPoints[contactPointIndex].normal.x -
+                                 mContactPoints[contactPointIndex].r2.x * mContactPoints[contactPointIndex].normal.z,
+                                 mContactPoints[contactPointIndex].r2.x * mContactPoints[contactPointIndex].normal.y -
+                                 mContactPoints[contactPointIndex].r2.y * mContactPoints[contactPointIndex].normal.x);
+
+                mContactPoints[contactPointIndex].i1TimesR1CrossN = mContactConstraints[manifoldIndex].inverseInertiaTensorBody1 * r1CrossN;
+                mContactPoints[contactPointIndex].i2TimesR2CrossN = mContactConstraints[manifoldIndex].inverseInertiaTensorBody2 * r2CrossN;
+
+                // Compute the inverse mass matrix K for the penetration constraint
+                decimal massPenetration = mContactConstraints[manifoldIndex].massInverseBody1 + mContactConstraints[manifoldIndex].massInverseBody2 +
+                        ((mContactPoints[contactPointIndex].i1TimesR1CrossN).cross(mContactPoints[contactPointIndex].r1)).dot(mContactPoints[contactPointIndex].normal) +
+                        ((mContactPoints[contactPointIndex].i2TimesR2CrossN).cross(mContactPoints[contactPointIndex].r2)).dot(mContactPoints[contactPointIndex].normal);
+                mContactPoints[contactPointIndex].inversePenetrationMass = massPenetration > decimal(0.0) ? decimal(1.0) / massPenetration : decimal(0.0);
+
+                cacheContactPointSolverData(externalContact, mContactPoints[contactPointIndex], body1, body2);
+            }
 
             // Compute the restitution velocity bias "b". We compute this here instead
             // of inside the solve() method because we need to use the velocity difference
             // at the beginning of the contact. Note that if it is a resting contact (normal
             // velocity bellow a given threshold), we do not add a restitution velocity bias
-            mContactPoints[mNbContactPoints].restitutionBias = 0.0;
-            // deltaVDotN = deltaV.dot(mContactPoints[mNbContactPoints].normal);
-            decimal deltaVDotN = deltaV.x * mContactPoints[mNbContactPoints].normal.x +
-                                 deltaV.y * mContactPoints[mNbContactPoints].normal.y +
-                                 deltaV.z * mContactPoints[mNbContactPoints].normal.z;
-            const decimal restitutionFactor = computeMixedRestitutionFactor(body1, body2);
+            mContactPoints[contactPointIndex].restitutionBias = 0.0;
+            // deltaVDotN = deltaV.dot(mContactPoints[contactPointIndex].normal);
+            decimal deltaVDotN = deltaV.x * mContactPoints[contactPointIndex].normal.x +
+                                 deltaV.y * mContactPoints[contactPointIndex].normal.y +
+                                 deltaV.z * mContactPoints[contactPointIndex].normal.z;
             if (deltaVDotN < -mWorldSettings.restitutionVelocityThreshold) {
-                mContactPoints[mNbContactPoints].restitutionBias = restitutionFactor * deltaVDotN;
+                mContactPoints[contactPointIndex].restitutionBias = materialProperties.bounciness * deltaVDotN;
             }
 
-            mContactConstraints[mNbContactManifolds].normal.x += mContactPoints[mNbContactPoints].normal.x;
-            mContactConstraints[mNbContactManifolds].normal.y += mContactPoints[mNbContactPoints].normal.y;
-            mContactConstraints[mNbContactManifolds].normal.z += mContactPoints[mNbContactPoints].normal.z;
+            // For a speculative contact (negative penetration depth), the shapes are allowed
+            // to approach each other until the gap between them is closed at the end of the step
+            if (penetrationDepth < decimal(0.0)) {
+                mContactPoints[contactPointIndex].restitutionBias = -penetrationDepth / mTimeStep;
+            }
 
-            mNbContactPoints++;
+            mContactConstraints[manifoldIndex].normal.x += mContactPoints[contactPointIndex].normal.x;
+            mContactConstraints[manifoldIndex].normal.y += mContactPoints[contactPointIndex].normal.y;
+            mContactConstraints[manifoldIndex].normal.z += mContactPoints[contactPointIndex].normal.z;
+
+            contactPointIndex++;
 
             externalContact = externalContact->getNext();
         }
 
-        mContactConstraints[mNbContactManifolds].frictionPointBody1 /=static_cast<decimal>(mContactConstraints[mNbContactManifolds].nbContacts);
-        mContactConstraints[mNbContactManifolds].frictionPointBody2 /=static_cast<decimal>(mContactConstraints[mNbContactManifolds].nbContacts);
-        mContactConstraints[mNbContactManifolds].r1Friction.x = mContactConstraints[mNbContactManifolds].frictionPointBody1.x - x1.x;
-        mContactConstraints[mNbContactManifolds].r1Friction.y = mContactConstraints[mNbContactManifolds].frictionPointBody1.y - x1.y;
-        mContactConstraints[mNbContactManifolds].r1Friction.z = mContactConstraints[mNbContactManifolds].frictionPointBody1.z - x1.z;
-        mContactConstraints[mNbContactManifolds].r2Friction.x = mContactConstraints[mNbContactManifolds].frictionPointBody2.x - x2.x;
-        mContactConstraints[mNbContactManifolds].r2Friction.y = mContactConstraints[mNbContactManifolds].frictionPointBody2.y - x2.y;
-        mContactConstraints[mNbContactManifolds].r2Friction.z = mContactConstraints[mNbContactManifolds].frictionPointBody2.z - x2.z;
-        mContactConstraints[mNbContactManifolds].oldFrictionVector1 = externalManifold->getFrictionVector1();
-        mContactConstraints[mNbContactManifolds].oldFrictionVector2 = externalManifold->getFrictionVector2();
+        frictionPointBody1 /=static_cast<decimal>(mContactConstraints[manifoldIndex].nbContacts);
+        frictionPointBody2 /=static_cast<decimal>(mContactConstraints[manifoldIndex].nbContacts);
+        mContactConstraints[manifoldIndex].r1Friction.x = frictionPointBody1.x - x1.x;
+        mContactConstraints[manifoldIndex].r1Friction.y = frictionPointBody1.y - x1.y;
+        mContactConstraints[manifoldIndex].r1Friction.z = frictionPointBody1.z - x1.z;
+        mContactConstraints[manifoldIndex].r2Friction.x = frictionPointBody2.x - x2.x;
+        mContactConstraints[manifoldIndex].r2Friction.y = frictionPointBody2.y - x2.y;
+        mContactConstraints[manifoldIndex].r2Friction.z = frictionPointBody2.z - x2.z;
+        mContactConstraintsColdData[manifoldIndex].oldFrictionVector1 = externalManifold->getFrictionVector1();
+        mContactConstraintsColdData[manifoldIndex].oldFrictionVector2 = externalManifold->getFrictionVector2();
 
         // Initialize the accumulated impulses with the previous step accumulated impulses
-        mContactConstraints[mNbContactManifolds].friction1Impulse = externalManifold->getFrictionImpulse1();
-        mContactConstraints[mNbContactManifolds].friction2Impulse = externalManifold->getFrictionImpulse2();
-        mContactConstraints[mNbContactManifolds].frictionTwistImpulse = externalManifold->getFrictionTwistImpulse();
+        mContactConstraints[manifoldIndex].friction1Impulse = externalManifold->getFrictionImpulse1();
+        mContactConstraints[manifoldIndex].friction2Impulse = externalManifold->getFrictionImpulse2();
+        mContactConstraints[manifoldIndex].frictionTwistImpulse = externalManifold->getFrictionTwistImpulse();
 
         // Compute the inverse K matrix for the rolling resistance constraint
         bool isBody1DynamicType = body1->getType() == BodyType::DYNAMIC;
         bool isBody2DynamicType = body2->getType() == BodyType::DYNAMIC;
-        mContactConstraints[mNbContactManifolds].inverseRollingResistance.setToZero();
-        if (mContactConstraints[mNbContactManifolds].rollingResistanceFactor > 0 && (isBody1DynamicType || isBody2DynamicType)) {
+        mContactConstraints[manifoldIndex].inverseRollingResistance.setToZero();
+        if (mContactConstraints[manifoldIndex].rollingResistanceFactor > 0 && (isBody1DynamicType || isBody2DynamicType)) {
 
-            mContactConstraints[mNbContactManifolds].inverseRollingResistance = mContactConstraints[mNbContactManifolds].inverseInertiaTensorBody1 + mContactConstraints[mNbContactManifolds].inverseInertiaTensorBody2;
-            decimal det = mContactConstraints[mNbContactManifolds].inverseRollingResistance.getDeterminant();
+            mContactConstraints[manifoldIndex].inverseRollingResistance = mContactConstraints[manifoldIndex].inverseInertiaTensorBody1 + mContactConstraints[manifoldIndex].inverseInertiaTensorBody2;
+            decimal det = mContactConstraints[manifoldIndex].inverseRollingResistance.getDeterminant();
 
             // If the matrix is not inversible
             if (approxEqual(det, decimal(0.0))) {
-               mContactConstraints[mNbContactManifolds].inverseRollingResistance.setToZero();
+               mContactConstraints[manifoldIndex].inverseRollingResistance.setToZero();
             }
             else {
-               mContactConstraints[mNbContactManifolds].inverseRollingResistance = mContactConstraints[mNbContactManifolds].inverseRollingResistance.getInverse();
+               mContactConstraints[manifoldIndex].inverseRollingResistance = mContactConstraints[manifoldIndex].inverseRollingResistance.getInverse();
             }
         }
 
-        mContactConstraints[mNbContactManifolds].normal.normalize();
-
-        // deltaVFrictionPoint = v2 + w2.cross(mContactConstraints[mNbContactManifolds].r2Friction) -
-        //                              v1 - w1.cross(mContactConstraints[mNbContactManifolds].r1Friction);
-        Vector3 deltaVFrictionPoint(v2.x + w2.y * mContactConstraints[mNbContactManifolds].r2Friction.z -
-                                    w2.z * mContactConstraints[mNbContactManifolds].r2Friction.y -
-                                      v1.x - w1.y * mContactConstraints[mNbContactManifolds].r1Friction.z -
-                                      w1.z * mContactConstraints[mNbContactManifolds].r1Friction.y,
-                                   v2.y + w2.z * mContactConstraints[mNbContactManifolds].r2Friction.x -
-                                    w2.x * mContactConstraints[mNbContactManifolds].r2Friction.z -
-                                      v1.y - w1.z * mContactConstraints[mNbContactManifolds].r1Friction.x -
-                                      w1.x * mContactConstraints[mNbContactManifolds].r1Friction.z,
-                                   v2.z + w2.x * mContactConstraints[mNbContactManifolds].r2Friction.y -
-                                    w2.y * mContactConstraints[mNbContactManifolds].r2Friction.x -
-                                      v1.z - w1.x * mContactConstraints[mNbContactManifolds].r1Friction.y -
-                                      w1.y * mContactConstraints[mNbContactManifolds].r1Friction.x);
+        mContactConstraints[manifoldIndex].normal.normalize();
+
+        // deltaVFrictionPoint = v2 + w2.cross(mContactConstraints[manifoldIndex].r2Friction) -
+        //                              v1 - w1.cross(mContactConstraints[manifoldIndex].r1Friction);
+        Vector3 deltaVFrictionPoint(v2.x + w2.y * mContactConstraints[manifoldIndex].r2Friction.z -
+                                    w2.z * mContactConstraints[manifoldIndex].r2Friction.y -
+                                      v1.x - w1.y * mContactConstraints[manifoldIndex].r1Friction.z -
+                                      w1.z * mContactConstraints[manifoldIndex].r1Friction.y,
+                                   v2.y + w2.z * mContactConstraints[manifoldIndex].r2Friction.x -
+                                    w2.x * mContactConstraints[manifoldIndex].r2Friction.z -
+                                      v1.y - w1.z * mContactConstraints[manifoldIndex].r1Friction.x -
+                                      w1.x * mContactConstraints[manifoldIndex].r1Friction.z,
+                                   v2.z + w2.x * mContactConstraints[manifoldIndex].r2Friction.y -
+                                    w2.y * mContactConstraints[manifoldIndex].r2Friction.x -
+                                      v1.z - w1.x * mContactConstraints[manifoldIndex].r1Friction.y -
+                                      w1.y * mContactConstraints[manifoldIndex].r1Friction.x);
 
         // Compute the friction vectors
-        computeFrictionVectors(deltaVFrictionPoint, mContactConstraints[mNbContactManifolds]);
+        computeFrictionVectors(deltaVFrictionPoint, mContactConstraints[manifoldIndex]);
 
         // Compute the inverse mass matrix K for the friction constraints at the center of
         // the contact manifold
-        mContactConstraints[mNbContactManifolds].r1CrossT1 = mContactConstraints[mNbContactManifolds].r1Friction.cross(mContactConstraints[mNbContactManifolds].frictionVector1);
-        mContactConstraints[mNbContactManifolds].r1CrossT2 = mContactConstraints[mNbContactManifolds].r1Friction.cross(mContactConstraints[mNbContactManifolds].frictionVector2);
-        mContactConstraints[mNbContactManifolds].r2CrossT1 = mContactConstraints[mNbContactManifolds].r2Friction.cross(mContactConstraints[mNbContactManifolds].frictionVector1);
-        mContactConstraints[mNbContactManifolds].r2CrossT2 = mContactConstraints[mNbContactManifolds].r2Friction.cross(mContactConstraints[mNbContactManifolds].frictionVector2);
-        decimal friction1Mass = mContactConstraints[mNbContactManifolds].massInverseBody1 + mContactConstraints[mNbContactManifolds].massInverseBody2 +
-                                ((mContactConstraints[mNbContactManifolds].inverseInertiaTensorBody1 * mContactConstraints[mNbContactManifolds].r1CrossT1).cross(mContactConstraints[mNbContactManifolds].r1Friction)).dot(
-                                mContactConstraints[mNbContactManifolds].frictionVector1) +
-                                ((mContactConstraints[mNbContactManifolds].inverseInertiaTensorBody2 * mContactConstraints[mNbContactManifolds].r2CrossT1).cross(mContactConstraints[mNbContactManifolds].r2Friction)).dot(
-                                mContactConstraints[mNbContactManifolds].frictionVector1);
-        decimal friction2Mass = mContactConstraints[mNbContactManifolds].massInverseBody1 + mContactConstraints[mNbContactManifolds].massInverseBody2 +
-                                ((mContactConstraints[mNbContactManifolds].inverseInertiaTensorBody1 * mContactConstraints[mNbContactManifolds].r1CrossT2).cross(mContactConstraints[mNbContactManifolds].r1Friction)).dot(
-                                mContactConstraints[mNbContactManifolds].frictionVector2) +
-                                ((mContactConstraints[mNbContactManifolds].inverseInertiaTensorBody2 * mContactConstraints[mNbContactManifolds].r2CrossT2).cross(mContactConstraints[mNbContactManifolds].r2Friction)).dot(
-                                mContactConstraints[mNbContactManifolds].frictionVector2);
-        decimal frictionTwistMass = mContactConstraints[mNbContactManifolds].normal.dot(mContactConstraints[mNbContactManifolds].inverseInertiaTensorBody1 *
-                                       mContactConstraints[mNbContactManifolds].normal) +
-                                    mContactConstraints[mNbContactManifolds].normal.dot(mContactConstraints[mNbContactManifolds].inverseInertiaTensorBody2 *
-                                       mContactConstraints[mNbContactManifolds].normal);
-        mContactConstraints[mNbContactManifolds].inverseFriction1Mass = friction1Mass > decimal(0.0) ? decimal(1.0) / friction1Mass : decimal(0.0);
-        mContactConstraints[mNbContactManifolds].inverseFriction2Mass = friction2Mass > decimal(0.0) ? decimal(1.0) / friction2Mass : decimal(0.0);
-        mContactConstraints[mNbContactManifolds].inverseTwistFrictionMass = frictionTwistMass > decimal(0.0) ? decimal(1.0) / frictionTwistMass : decimal(0.0);
-
-        mNbContactManifolds++;
+        mContactConstraints[manifoldIndex].r1CrossT1 = mContactConstraints[manifoldIndex].r1Friction.cross(mContactConstraints[manifoldIndex].frictionVector1);
+        mContactConstraints[manifoldIndex].r1CrossT2 = mContactConstraints[manifoldIndex].r1Friction.cross(mContactConstraints[manifoldIndex].frictionVector2);
+        mContactConstraints[manifoldIndex].r2CrossT1 = mContactConstraints[manifoldIndex].r2Friction.cross(mContactConstraints[manifoldIndex].frictionVector1);
+        mContactConstraints[manifoldIndex].r2CrossT2 = mContactConstraints[manifoldIndex].r2Friction.cross(mContactConstraints[manifoldIndex].frictionVector2);
+        decimal friction1Mass = mContactConstraints[manifoldIndex].massInverseBody1 + mContactConstraints[manifoldIndex].massInverseBody2 +
+                                ((mContactConstraints[manifoldIndex].inverseInertiaTensorBody1 * mContactConstraints[manifoldIndex].r1CrossT1).cross(mContactConstraints[manifoldIndex].r1Friction)).dot(
+                                mContactConstraints[manifoldIndex].frictionVector1) +
+                                ((mContactConstraints[manifoldIndex].inverseInertiaTensorBody2 * mContactConstraints[manifoldIndex].r2CrossT1).cross(mContactConstraints[manifoldIndex].r2Friction)).dot(
+                                mContactConstraints[manifoldIndex].frictionVector1);
+        decimal friction2Mass = mContactConstraints[manifoldIndex].massInverseBody1 + mContactConstraints[manifoldIndex].massInverseBody2 +
+                                ((mContactConstraints[manifoldIndex].inverseInertiaTensorBody1 * mContactConstraints[manifoldIndex].r1CrossT2).cross(mContactConstraints[manifoldIndex].r1Friction)).dot(
+                                mContactConstraints[manifoldIndex].frictionVector2) +
+                                ((mContactConstraints[manifoldIndex].inverseInertiaTensorBody2 * mContactConstraints[manifoldIndex].r2CrossT2).cross(mContactConstraints[manifoldIndex].r2Friction)).dot(
+                                mContactConstraints[manifoldIndex].frictionVector2);
+        decimal frictionTwistMass = mContactConstraints[manifoldIndex].normal.dot(mContactConstraints[manifoldIndex].inverseInertiaTensorBody1 *
+                                       mContactConstraints[manifoldIndex].normal) +
+                                    mContactConstraints[manifoldIndex].normal.dot(mContactConstraints[manifoldIndex].inverseInertiaTensorBody2 *
+                                       mContactConstraints[manifoldIndex].normal);
+        mContactConstraints[manifoldIndex].inverseFriction1Mass = friction1Mass > decimal(0.0) ? decimal(1.0) / friction1Mass : decimal(0.0);
+        mContactConstraints[manifoldIndex].inverseFriction2Mass = friction2Mass > decimal(0.0) ? decimal(1.0) / friction2Mass : decimal(0.0);
+        mContactConstraints[manifoldIndex].inverseTwistFrictionMass = frictionTwistMass > decimal(0.0) ? decimal(1.0) / frictionTwistMass : decimal(0.0);
+
+        // Compute the matrix K of the normal constraints for the block solver
+        if (mContactBlocks != nullptr) {
+            initializeBlockSolver(manifoldIndex);
+        }
+
+        manifoldIndex++;
+    }
+
+    assert(manifoldIndex == mIslandsFirstContactManifoldIndex[islandIndex + 1]);
+    assert(contactPointIndex == mIslandsFirstContactPointIndex[islandIndex + 1]);
+
+    // Group the contact manifolds for the wide contact solver (only once per step
+    // because the groups do not change between the substeps)
+    if (mIslandsContactGroups != nullptr && mIslandsContactGroups[islandIndex] == nullptr) {
+        computeContactGroups(islandIndex);
+    }
+}
+
+// Compute the matrix K of the block contact solver for a contact manifold
+/// The element (i, j) of the matrix is the change of the relative normal velocity at the
+/// contact point i caused by a unit normal impulse at the contact point j.
+/**
+ * @param c Index of the contact manifold in the contact constraints array
+ */
+void ContactSolver::initializeBlockSolver(uint c) {
+
+    const ContactManifoldSolver& manifold = mContactConstraints[c];
+    ContactManifoldBlockSolver& block = mContactBlocks[c];
+    const ContactPointSolver* points = mContactPoints + manifold.contactPointIndex;
+    const decimal sumMassInverse = manifold.massInverseBody1 + manifold.massInverseBody2;
+
+    // Cross products of the vectors r1 and r2 with the normal of each contact point
+    Vector3 r1CrossN[MAX_CONTACT_POINTS_IN_MANIFOLD];
+    Vector3 r2CrossN[MAX_CONTACT_POINTS_IN_MANIFOLD];
+    for (int8 i=0; i < manifold.nbContacts; i++) {
+        r1CrossN[i] = points[i].r1.cross(points[i].normal);
+        r2CrossN[i] = points[i].r2.cross(points[i].normal);
+    }
+
+    for (int8 i=0; i < manifold.nbContacts; i++) {
+        for (int8 j=0; j < manifold.nbContacts; j++) {
+            block.normalMass[i][j] = sumMassInverse * points[i].normal.dot(points[j].normal) +
+                                     r1CrossN[i].dot(points[j].i1TimesR1CrossN) +
+                                     r2CrossN[i].dot(points[j].i2TimesR2CrossN);
+        }
+
+        // Regularize the matrix so that it can be inverted with redundant contact points
+        block.normalMass[i][i] *= decimal(1.0) + BLOCK_SOLVER_REGULARIZATION;
+    }
+
+    // Start with all the contact points active
+    block.normalActiveSet = static_cast<uint8>((1u << manifold.nbContacts) - 1);
+    block.splitActiveSet = block.normalActiveSet;
+}
+
+// Solve the mixed linear complementarity problem of the normal impulses of a contact manifold
+/// We look for the impulses x such that the relative normal velocities w = K * x + q satisfy
+/// x >= 0, w >= 0 and x_i * w_i = 0 for each contact point i. The set of active contact points
+/// of the last solution is tried first because it rarely changes between two iterations. Then,
+/// the sets of active contact points (x_i > 0 and w_i = 0) are enumerated from the largest one to
+/// the empty one and the first set with a valid solution is kept. The method returns false if
+/// there is no valid set (this only happens with a degenerate matrix).
+/**
+ * @param block The block solver data of the contact manifold
+ * @param relativeVelocities The vector q
+ * @param nbContacts Number of contact points of the manifold
+ * @param[in,out] activeSet Set of active contact points of the last solution
+ * @param[out] outImpulses The impulses x
+ * @return True if a solution has been found
+ */
+bool ContactSolver::solveBlockNormalImpulses(const ContactManifoldBlockSolver& block, const decimal* relativeVelocities,
+                                             int8 nbContacts, uint8& activeSet, decimal* outImpulses) {
+
+    assert(nbContacts > 0 && nbContacts <= MAX_CONTACT_POINTS_IN_MANIFOLD);
+
+    const uint8 nbSets = static_cast<uint8>(1u << nbContacts);
+
+    if (activeSet < nbSets && solveBlockNormalImpulsesWithSet(block, relativeVelocities, nbContacts, activeSet, outImpulses)) {
+        return true;
+    }
+
+    for (int8 nbActiveContacts = nbContacts; nbActiveContacts >= 0; nbActiveContacts--) {
+        for (uint8 set = 0; set < nbSets; set++) {
+
+            // Count the active contact points of the set
+            int8 nbSetContacts = 0;
+            for (int8 i=0; i < nbContacts; i++) {
+                if (set & (1u << i)) nbSetContacts++;
+            }
+
+            if (nbSetContacts == nbActiveContacts && set != activeSet &&
+                solveBlockNormalImpulsesWithSet(block, relativeVelocities, nbContacts, set, outImpulses)) {
+
+                activeSet = set;
+                return true;
+            }
+        }
+    }
+
+    return false;
+}
+
+// Solve the normal impulses of a contact manifold with a given set of active contact points
+/// The impulses of the active contact points are computed such that their relative normal
+/// velocity is zero. The method returns false if the solution is not valid, that is if one
+/// of the impulses is negative or one of the inactive contact points is approaching.
+/**
+ * @param block The block solver data of the contact manifold
+ * @param relativeVelocities The vector q
+ * @param nbContacts Number of contact points of the manifold
+ * @param activeSet Set of active contact points (one bit per point)
+ * @param[out] outImpulses The impulses x
+ * @return True if the solution is valid
+ */
+bool ContactSolver::solveBlockNormalImpulsesWithSet(const ContactManifoldBlockSolver& block, const decimal* relativeVelocities,
+                                                    int8 nbContacts, uint8 activeSet, decimal* outImpulses) {
+
+    // Get the indices of the active contact points of the set
+    int8 activeContacts[MAX_CONTACT_POINTS_IN_MANIFOLD];
+    int8 n = 0;
+    for (int8 i=0; i < nbContacts; i++) {
+        if (activeSet & (1u << i)) {
+            activeContacts[n++] = i;
+        }
+    }
+
+    // Build the linear system K_active * x_active = -q_active
+    decimal system[MAX_CONTACT_POINTS_IN_MANIFOLD][MAX_CONTACT_POINTS_IN_MANIFOLD + 1];
+    for (int8 r=0; r < n; r++) {
+        for (int8 k=0; k < n; k++) {
+            system[r][k] = block.normalMass[activeContacts[r]][activeContacts[k]];
+        }
+        system[r][n] = -relativeVelocities[activeContacts[r]];
+    }
+
+    // Solve the system with a Gaussian elimination with partial pivoting
+    for (int8 k=0; k < n; k++) {
+
+        int8 pivot = k;
+        for (int8 r=k+1; r < n; r++) {
+            if (std::abs(system[r][k]) > std::abs(system[pivot][k])) pivot = r;
+        }
+        if (std::abs(system[pivot][k]) <= MACHINE_EPSILON) return false;
+        if (pivot != k) {
+            for (int8 l=k; l <= n; l++) std::swap(system[k][l], system[pivot][l]);
+        }
+        for (int8 r=k+1; r < n; r++) {
+            const decimal factor = system[r][k] / system[k][k];
+            for (int8 l=k; l <= n; l++) system[r][l] -= factor * system[k][l];
+        }
+    }
+
+    decimal impulses[MAX_CONTACT_POINTS_IN_MANIFOLD] = {0};
+    for (int8 r=n-1; r >= 0; r--) {
+        decimal value = system[r][n];
+        for (int8 k=r+1; k < n; k++) value -= system[r][k] * impulses[activeContacts[k]];
+        impulses[activeContacts[r]] = value / system[r][r];
+
+        // The impulses of the active contact points cannot be negative
+        if (impulses[activeContacts[r]] < decimal(0.0)) return false;
+    }
+
+    // The inactive contact points must not be approaching
+    for (int8 i=0; i < nbContacts; i++) {
+        if (activeSet & (1u << i)) continue;
+        decimal w = relativeVelocities[i];
+        for (int8 j=0; j < nbContacts; j++) w += block.normalMass[i][j] * impulses[j];
+        if (w < -BLOCK_SOLVER_TOLERANCE) return false;
+    }
+
+    for (int8 i=0; i < nbContacts; i++) {
+        outImpulses[i] = impulses[i];
+    }
+
+    return true;
+}
+
+// Solve the normal impulses (or split impulses) of a contact manifold at once with the block solver
+/// The given velocities of the two bodies are updated with the change of the impulses. Nothing is
+/// changed if the block solver has not found a solution and the method returns false.
+/**
+ * @param c Index of the contact manifold in the contact constraints array
+ * @param isSplitImpulse True to solve the split impulses with the split velocities
+ * @param[in,out] v1 Linear velocity of body 1
+ * @param[in,out] w1 Angular velocity of body 1
+ * @param[in,out] v2 Linear velocity of body 2
+ * @param[in,out] w2 Angular velocity of body 2
+ * @param[in,out] impulseDelta Largest absolute change of impulse during the iteration
+ * @return True if the impulses have been solved
+ */
+bool ContactSolver::solveContactManifoldBlock(uint c, bool isSplitImpulse, Vector3& v1, Vector3& w1,
+                                              Vector3& v2, Vector3& w2, decimal& impulseDelta) {
+
+    const ContactManifoldSolver& manifold = mContactConstraints[c];
+    ContactPointSolver* points = mContactPoints + manifold.contactPointIndex;
+    ContactManifoldBlockSolver& block = mContactBlocks[c];
+
+    // Compute the vector q = J*v + b - K * x with the current impulses x
+    decimal relativeVelocities[MAX_CONTACT_POINTS_IN_MANIFOLD];
+    for (int8 i=0; i < manifold.nbContacts; i++) {
+
+        const Vector3 deltaV = v2 + w2.cross(points[i].r2) - v1 - w1.cross(points[i].r1);
+        decimal b = isSplitImpulse ? points[i].biasPenetrationDepth : points[i].restitutionBias;
+        if (!isSplitImpulse && !mIsSplitImpulseActive) b += points[i].biasPenetrationDepth;
+
+        relativeVelocities[i] = deltaV.dot(points[i].normal) + b;
+        for (int8 j=0; j < manifold.nbContacts; j++) {
+            const decimal impulse = isSplitImpulse ? points[j].penetrationSplitImpulse : points[j].penetrationImpulse;
+            relativeVelocities[i] -= block.normalMass[i][j] * impulse;
+        }
+    }
+
+    decimal impulses[MAX_CONTACT_POINTS_IN_MANIFOLD];
+    uint8& activeSet = isSplitImpulse ? block.splitActiveSet : block.normalActiveSet;
+    if (!solveBlockNormalImpulses(block, relativeVelocities, manifold.nbContacts, activeSet, impulses)) {
+        return false;
+    }
+
+    // Apply the change of the impulses to the bodies
+    for (int8 i=0; i < manifold.nbContacts; i++) {
+
+        decimal& impulse = isSplitImpulse ? points[i].penetrationSplitImpulse : points[i].penetrationImpulse;
+        const decimal deltaLambda = impulses[i] - impulse;
+        impulse = impulses[i];
+        if (!isSplitImpulse) impulseDelta = std::max(impulseDelta, std::abs(deltaLambda));
+
+        const Vector3 linearImpulse = points[i].normal * deltaLambda;
+        v1 -= manifold.massInverseBody1 * linearImpulse;
+        w1 -= points[i].i1TimesR1CrossN * deltaLambda;
+        v2 += manifold.massInverseBody2 * linearImpulse;
+        w2 += points[i].i2TimesR2CrossN * deltaLambda;
+    }
+
+    return true;
+}
+
+// Group the contact manifolds of an island for the wide contact solver
+/// Each contact manifold is added to one of the last created groups that is not full and
+/// that does not contain any of its dynamic bodies. Otherwise, a new group is created.
+/// The static and kinematic bodies can be shared by the manifolds of a group because the
+/// contact solver never changes their velocity.
+/**
+ * @param islandIndex Index of the island
+ */
+void ContactSolver::computeContactGroups(uint islandIndex) {
+
+    RP3D_PROFILE("ContactSolver::computeContactGroups()", mProfiler);
+
+    const uint firstManifoldIndex = mIslandsFirstContactManifoldIndex[islandIndex];
+    const uint nbManifolds = mIslandsFirstContactManifoldIndex[islandIndex + 1] - firstManifoldIndex;
+    assert(nbManifolds > 0);
+
+    // Group of each contact manifold, number of manifolds of each group and dynamic
+    // bodies of each group (-1 for a static or kinematic body)
+    uint* manifoldsGroup = static_cast<uint*>(mArena.allocate(sizeof(uint) * nbManifolds));
+    uint* groupsNbLanes = static_cast<uint*>(mArena.allocate(sizeof(uint) * nbManifolds));
+    int32* groupsBodies = static_cast<int32*>(mArena.allocate(sizeof(int32) * nbManifolds * 2 * NB_CONTACT_LANES));
+    uint nbGroups = 0;
+
+    // If the contact manifolds have been colored, the groups of the manifolds of each
+    // color are created after the groups of the previous color
+    const Island* island = mIslands[islandIndex];
+    const uint nbColors = island->getNbContactManifoldsColors();
+    const uint* manifoldsColorsFirstIndex = island->getContactManifoldsColorsFirstIndex();
+    uint* groupsColorsFirstIndex = nullptr;
+    if (nbColors > 0) {
+        groupsColorsFirstIndex = static_cast<uint*>(mArena.allocate(sizeof(uint) * (nbColors + 1)));
+    }
+    uint color = 0;
+    uint firstGroupOfColor = 0;
+
+    for (uint m=0; m < nbManifolds; m++) {
+
+        const ContactManifoldSolver& manifold = mContactConstraints[firstManifoldIndex + m];
+
+        // If the manifold is the first one of a color
+        while (color < nbColors && manifoldsColorsFirstIndex[color] == m) {
+            groupsColorsFirstIndex[color] = nbGroups;
+            firstGroupOfColor = nbGroups;
+            color++;
+        }
+
+        // Only the dynamic bodies cannot be shared by the manifolds of a group
+        const int32 body1 = manifold.isBody1Dynamic ? manifold.indexBody1 : -1;
+        const int32 body2 = manifold.isBody2Dynamic ? manifold.indexBody2 : -1;
+
+        // Look for a group among the last created ones. The manifold must be added after the
+        // last group that shares a body with it so that the manifolds sharing a body are still
+        // solved in the same order as with the scalar solver
+        uint group = nbGroups;
+        const uint firstSearchedGroup = std::max(firstGroupOfColor, nbGroups > NB_SEARCHED_CONTACT_GROUPS ?
+                                                                    nbGroups - NB_SEARCHED_CONTACT_GROUPS : 0);
+        for (uint g=nbGroups; g > firstSearchedGroup; g--) {
+
+            bool isSharingBody = false;
+            const int32* bodies = groupsBodies + (g - 1) * 2 * NB_CONTACT_LANES;
+            for (uint b=0; b < 2 * groupsNbLanes[g - 1]; b++) {
+                if (bodies[b] != -1 && (bodies[b] == body1 || bodies[b] == body2)) {
+                    isSharingBody = true;
+                    break;
+                }
+            }
+
+            if (isSharingBody) break;
+            if (groupsNbLanes[g - 1] < NB_CONTACT_LANES) group = g - 1;
+        }
+
+        // Create a new group if needed
+        if (group == nbGroups) {
+            groupsNbLanes[group] = 0;
+            nbGroups++;
+        }
+
+        // Add the manifold into the group
+        int32* bodies = groupsBodies + group * 2 * NB_CONTACT_LANES;
+        bodies[2 * groupsNbLanes[group]] = body1;
+        bodies[2 * groupsNbLanes[group] + 1] = body2;
+        groupsNbLanes[group]++;
+        manifoldsGroup[m] = group;
+    }
+
+    // Allocate the groups of the island
+    ContactGroupSolver* groups = static_cast<ContactGroupSolver*>(mArena.allocate(sizeof(ContactGroupSolver) * nbGroups));
+    for (uint g=0; g < nbGroups; g++) {
+        groups[g].nbLanes = 0;
+        groups[g].nbMaxContacts = 0;
+    }
+
+    // Add the manifolds into the lanes of their group
+    uint contactPointIndex = mIslandsFirstContactPointIndex[islandIndex];
+    for (uint m=0; m < nbManifolds; m++) {
+
+        const uint manifoldIndex = firstManifoldIndex + m;
+        ContactGroupSolver& group = groups[manifoldsGroup[m]];
+        const uint lane = group.nbLanes;
+
+        group.manifoldIndices[lane] = manifoldIndex;
+        group.contactPointIndices[lane] = contactPointIndex;
+        group.indexBody1[lane] = mContactConstraints[manifoldIndex].indexBody1;
+        group.indexBody2[lane] = mContactConstraints[manifoldIndex].indexBody2;
+        group.nbMaxContacts = std::max(group.nbMaxContacts, mContactConstraints[manifoldIndex].nbContacts);
+        group.nbLanes++;
+
+        contactPointIndex += mContactConstraints[manifoldIndex].nbContacts;
+    }
+
+    // The unused lanes read the velocities of the bodies of the first lane
+    for (uint g=0; g < nbGroups; g++) {
+        for (uint lane = groups[g].nbLanes; lane < NB_CONTACT_LANES; lane++) {
+            groups[g].indexBody1[lane] = groups[g].indexBody1[0];
+            groups[g].indexBody2[lane] = groups[g].indexBody2[0];
+        }
+    }
+
+    if (nbColors > 0) {
+        while (color < nbColors) {
+            groupsColorsFirstIndex[color] = nbGroups;
+            color++;
+        }
+        groupsColorsFirstIndex[nbColors] = nbGroups;
+    }
+
+    mIslandsContactGroups[islandIndex] = groups;
+    mIslandsNbContactGroups[islandIndex] = nbGroups;
+    mIslandsContactGroupsColorsFirstIndex[islandIndex] = groupsColorsFirstIndex;
+}
+
+// Copy the contact constraints of an island into the groups of the wide contact solver
+/// This is done after the warm starting because it changes the accumulated impulses
+/**
+ * @param islandIndex Index of the island
+ */
+void ContactSolver::packContactGroups(uint islandIndex) {
+
+    ContactGroupSolver* groups = mIslandsContactGroups[islandIndex];
+    for (uint g=0; g < mIslandsNbContactGroups[islandIndex]; g++) {
+
+        ContactManifoldLanes& lanes = groups[g].lanes;
+
+        // The unused lanes and contact points are filled with zeros so that
+        // they do not apply any impulse
+        std::memset(&lanes, 0, sizeof(ContactManifoldLanes));
+
+        for (uint lane=0; lane < groups[g].nbLanes; lane++) {
+
+            const ContactManifoldSolver& manifold = mContactConstraints[groups[g].manifoldIndices[lane]];
+
+            lanes.massInverseBody1[lane] = manifold.massInverseBody1;
+            lanes.massInverseBody2[lane] = manifold.massInverseBody2;
+            for (uint i=0; i < 3; i++) {
+                for (uint j=0; j < 3; j++) {
+                    lanes.inverseInertiaTensorBody1[3 * i + j][lane] = manifold.inverseInertiaTensorBody1[i][j];
+                    lanes.inverseInertiaTensorBody2[3 * i + j][lane] = manifold.inverseInertiaTensorBody2[i][j];
+                    lanes.inverseRollingResistance[3 * i + j][lane] = manifold.inverseRollingResistance[i][j];
+                }
+            }
+            lanes.frictionCoefficient[lane] = manifold.frictionCoefficient;
+            lanes.rollingResistanceFactor[lane] = manifold.rollingResistanceFactor;
+            for (uint i=0; i < 3; i++) {
+                lanes.normal[i][lane] = manifold.normal[i];
+                lanes.r1Friction[i][lane] = manifold.r1Friction[i];
+                lanes.r2Friction[i][lane] = manifold.r2Friction[i];
+                lanes.r1CrossT1[i][lane] = manifold.r1CrossT1[i];
+                lanes.r1CrossT2[i][lane] = manifold.r1CrossT2[i];
+                lanes.r2CrossT1[i][lane] = manifold.r2CrossT1[i];
+                lanes.r2CrossT2[i][lane] = manifold.r2CrossT2[i];
+                lanes.frictionVector1[i][lane] = manifold.frictionVector1[i];
+                lanes.frictionVector2[i][lane] = manifold.frictionVector2[i];
+                lanes.rollingResistanceImpulse[i][lane] = manifold.rollingResistanceImpulse[i];
+            }
+            lanes.inverseFriction1Mass[lane] = manifold.inverseFriction1Mass;
+            lanes.inverseFriction2Mass[lane] = manifold.inverseFriction2Mass;
+            lanes.inverseTwistFrictionMass[lane] = manifold.inverseTwistFrictionMass;
+            lanes.friction1Impulse[lane] = manifold.friction1Impulse;
+            lanes.friction2Impulse[lane] = manifold.friction2Impulse;
+            lanes.frictionTwistImpulse[lane] = manifold.frictionTwistImpulse;
+
+            for (int8 k=0; k < manifold.nbContacts; k++) {
+
+                const ContactPointSolver& point = mContactPoints[groups[g].contactPointIndices[lane] + k];
+                ContactPointLanes& pointLanes = lanes.points[k];
+
+                for (uint i=0; i < 3; i++) {
+                    pointLanes.normal[i][lane] = point.normal[i];
+                    pointLanes.r1[i][lane] = point.r1[i];
+                    pointLanes.r2[i][lane] = point.r2[i];
+                    pointLanes.i1TimesR1CrossN[i][lane] = point.i1TimesR1CrossN[i];
+                    pointLanes.i2TimesR2CrossN[i][lane] = point.i2TimesR2CrossN[i];
+                }
+
+                pointLanes.biasPenetrationDepth[lane] = point.biasPenetrationDepth;
+                pointLanes.restitutionBias[lane] = point.restitutionBias;
+                pointLanes.penetrationImpulse[lane] = point.penetrationImpulse;
+                pointLanes.penetrationSplitImpulse[lane] = point.penetrationSplitImpulse;
+                pointLanes.inversePenetrationMass[lane] = point.inversePenetrationMass;
+            }
+        }
+    }
+}
+
+// Copy the impulses of the groups of the wide contact solver back into the contact constraints
+/**
+ * @param islandIndex Index of the island
+ */
+void ContactSolver::unpackContactGroups(uint islandIndex) {
+
+    ContactGroupSolver* groups = mIslandsContactGroups[islandIndex];
+    for (uint g=0; g < mIslandsNbContactGroups[islandIndex]; g++) {
+
+        const ContactManifoldLanes& lanes = groups[g].lanes;
+
+        for (uint lane=0; lane < groups[g].nbLanes; lane++) {
+
+            ContactManifoldSolver& manifold = mContactConstraints[groups[g].manifoldIndices[lane]];
+
+            manifold.friction1Impulse = lanes.friction1Impulse[lane];
+            manifold.friction2Impulse = lanes.friction2Impulse[lane];
+            manifold.frictionTwistImpulse = lanes.frictionTwistImpulse[lane];
+            manifold.rollingResistanceImpulse.setAllValues(lanes.rollingResistanceImpulse[0][lane],
+                                                           lanes.rollingResistanceImpulse[1][lane],
+                                                           lanes.rollingResistanceImpulse[2][lane]);
+
+            for (int8 k=0; k < manifold.nbContacts; k++) {
+                ContactPointSolver& point = mContactPoints[groups[g].contactPointIndices[lane] + k];
+                point.penetrationImpulse = lanes.points[k].penetrationImpulse[lane];
+                point.penetrationSplitImpulse = lanes.points[k].penetrationSplitImpulse[lane];
+            }
+        }
     }
 }
 
@@ -330,21 +919,22 @@ void ContactSolver::initializeForIsland(Island* island) {
 /// For each constraint, we apply the previous impulse (from the previous step)
 /// at the beginning. With this technique, we will converge faster towards
 /// the solution of the linear system
-void ContactSolver::warmStart() {
+void ContactSolver::warmStart(uint islandIndex) {
 
-    RP3D_PROFILE("ContactSolver::warmStart()", mProfiler);
+    assert(islandIndex < mNbIslands);
 
-    uint contactPointIndex = 0;
+    uint contactPointIndex = mIslandsFirstContactPointIndex[islandIndex];
 
     // For each constraint
-    for (uint c=0; c<mNbContactManifolds; c++) {
+    for (uint c=mIslandsFirstContactManifoldIndex[islandIndex];
+         c < mIslandsFirstContactManifoldIndex[islandIndex + 1]; c++) {
 
         bool atLeastOneRestingContactPoint = false;
 
         for (short int i=0; i<mContactConstraints[c].nbContacts; i++) {
 
             // If it is not a new contact (this contact was already existing at last time step)
-            if (mContactPoints[contactPointIndex].isRestingContact) {
+            if (mContactPointsColdData[contactPointIndex].isRestingContact) {
 
                 atLeastOneRestingContactPoint = true;
 
@@ -386,12 +976,12 @@ void ContactSolver::warmStart() {
 
             // Project the old friction impulses (with old friction vectors) into the new friction
             // vectors to get the new friction impulses
-            Vector3 oldFrictionImpulse(mContactConstraints[c].friction1Impulse * mContactConstraints[c].oldFrictionVector1.x +
-                                         mContactConstraints[c].friction2Impulse * mContactConstraints[c].oldFrictionVector2.x,
-                                       mContactConstraints[c].friction1Impulse * mContactConstraints[c].oldFrictionVector1.y +
-                                         mContactConstraints[c].friction2Impulse * mContactConstraints[c].oldFrictionVector2.y,
-                                       mContactConstraints[c].friction1Impulse * mContactConstraints[c].oldFrictionVector1.z +
-                                         mContactConstraints[c].friction2Impulse * mContactConstraints[c].oldFrictionVector2.z);
+            Vector3 oldFrictionImpulse(mContactConstraints[c].friction1Impulse * mContactConstraintsColdData[c].oldFrictionVector1.x +
+                                         mContactConstraints[c].friction2Impulse * mContactConstraintsColdData[c].oldFrictionVector2.x,
+                                       mContactConstraints[c].friction1Impulse * mContactConstraintsColdData[c].oldFrictionVector1.y +
+                                         mContactConstraints[c].friction2Impulse * mContactConstraintsColdData[c].oldFrictionVector2.y,
+                                       mContactConstraints[c].friction1Impulse * mContactConstraintsColdData[c].oldFrictionVector1.z +
+                                         mContactConstraints[c].friction2Impulse * mContactConstraintsColdData[c].oldFrictionVector2.z);
             mContactConstraints[c].friction1Impulse = oldFrictionImpulse.dot(mContactConstraints[c].frictionVector1);
             mContactConstraints[c].friction2Impulse = oldFrictionImpulse.dot(mContactConstraints[c].frictionVector2);
 
@@ -480,334 +1070,1182 @@ void ContactSolver::warmStart() {
             mContactConstraints[c].rollingResistanceImpulse.setToZero();
         }
     }
+
+    // Copy the constraints into the groups of the wide contact solver
+    if (mIslandsContactGroups != nullptr) packContactGroups(islandIndex);
 }
 
 // Solve the contacts
-void ContactSolver::solve() {
+/// If the manifolds (or groups) of a color are solved by several tasks, each task computes
+/// the largest change of impulse of its range and the results are merged under a lock.
+/**
+ * @param islandIndex Index of the island
+ * @return The largest absolute change of the contact impulses during this iteration
+ */
+decimal ContactSolver::solve(uint islandIndex) {
+
+    assert(islandIndex < mNbIslands);
+
+    decimal impulseDelta = decimal(0.0);
+    std::mutex impulseDeltaMutex;
+
+    // The manifolds (or groups) of a color can be solved in parallel
+    TaskScheduler* taskScheduler = mWorldSettings.taskScheduler;
+    const Island* island = mIslands[islandIndex];
+    const bool isSolvedInParallel = island->getNbContactManifoldsColors() > 0 && taskScheduler != nullptr;
+
+    // If the wide contact solver is used
+    if (mIslandsContactGroups != nullptr) {
+
+        ContactGroupSolver* groups = mIslandsContactGroups[islandIndex];
+
+        // Solve the groups of each color in parallel
+        if (isSolvedInParallel) {
+
+            const uint* colorsFirstIndex = mIslandsContactGroupsColorsFirstIndex[islandIndex];
+            for (uint k=0; k < island->getNbContactManifoldsColors(); k++) {
+
+                ContactGroupSolver* colorGroups = groups + colorsFirstIndex[k];
+                taskScheduler->parallelForRange(colorsFirstIndex[k + 1] - colorsFirstIndex[k],
+                                                MIN_NB_CONTACT_MANIFOLDS_PER_TASK / NB_CONTACT_LANES,
+                                                [this, colorGroups, &impulseDelta, &impulseDeltaMutex](uint begin, uint end) {
+                    decimal rangeImpulseDelta = decimal(0.0);
+                    for (uint g=begin; g < end; g++) {
+                        rangeImpulseDelta = std::max(rangeImpulseDelta, solveContactGroup(colorGroups[g]));
+                    }
+
+                    std::lock_guard<std::mutex> lock(impulseDeltaMutex);
+                    impulseDelta = std::max(impulseDelta, rangeImpulseDelta);
+                });
+            }
+
+            return impulseDelta;
+        }
+
+        // Solve the groups of contact manifolds of the island
+        for (uint g=0; g < mIslandsNbContactGroups[islandIndex]; g++) {
+            impulseDelta = std::max(impulseDelta, solveContactGroup(groups[g]));
+        }
+
+        return impulseDelta;
+    }
+
+    // Select the solver loop compiled for the features used by the island
+    const SolveContactManifoldsMethod solveContactManifoldsMethod =
+            SOLVE_CONTACT_MANIFOLDS_METHODS[getIslandSolverFeatures(islandIndex)];
+
+    // Solve the contact manifolds of each color in parallel
+    if (isSolvedInParallel) {
+
+        const uint* colorsFirstIndex = island->getContactManifoldsColorsFirstIndex();
+        for (uint k=0; k < island->getNbContactManifoldsColors(); k++) {
+
+            const uint firstManifoldIndex = mIslandsFirstContactManifoldIndex[islandIndex] + colorsFirstIndex[k];
+            taskScheduler->parallelForRange(colorsFirstIndex[k + 1] - colorsFirstIndex[k], MIN_NB_CONTACT_MANIFOLDS_PER_TASK,
+                                            [this, firstManifoldIndex, solveContactManifoldsMethod, &impulseDelta,
+                                             &impulseDeltaMutex](uint begin, uint end) {
+                const decimal rangeImpulseDelta = (this->*solveContactManifoldsMethod)(firstManifoldIndex + begin,
+                                                                                       firstManifoldIndex + end);
+
+                std::lock_guard<std::mutex> lock(impulseDeltaMutex);
+                impulseDelta = std::max(impulseDelta, rangeImpulseDelta);
+            });
+        }
+
+        return impulseDelta;
+    }
+
+    // Solve the contact manifolds of the island
+    return (this->*solveContactManifoldsMethod)(mIslandsFirstContactManifoldIndex[islandIndex],
+                                                mIslandsFirstContactManifoldIndex[islandIndex + 1]);
+}
 
-    RP3D_PROFILE("ContactSolver::solve()", mProfiler);
+// Solve the contacts of a contact manifold
+/// The velocities of the bodies are copied into local variables and only the velocities
+/// of the dynamic bodies are written back at the end. Therefore, the contact manifolds
+/// that do not share any dynamic body can be solved concurrently. The solver features are
+/// template parameters so that the branches of the disabled features are removed at compile time.
+/**
+ * @param c Index of the contact manifold in the contact constraints array
+ * @return The largest absolute change of the impulses of the contact manifold
+ */
+template<bool isSplitImpulseActive, bool isRollingResistanceActive, bool isBlockSolverActive>
+decimal ContactSolver::solveContactManifold(uint c) {
 
     decimal deltaLambda;
+    decimal impulseDelta = decimal(0.0);
     decimal lambdaTemp;
-    uint contactPointIndex = 0;
 
-    // For each contact manifold
-    for (uint c=0; c<mNbContactManifolds; c++) {
+    uint contactPointIndex = mContactConstraints[c].contactPointIndex;
 
-        decimal sumPenetrationImpulse = 0.0;
+    decimal sumPenetrationImpulse = 0.0;
 
-        // Get the constrained velocities
-        const Vector3& v1 = mLinearVelocities[mContactConstraints[c].indexBody1];
-        const Vector3& w1 = mAngularVelocities[mContactConstraints[c].indexBody1];
-        const Vector3& v2 = mLinearVelocities[mContactConstraints[c].indexBody2];
-        const Vector3& w2 = mAngularVelocities[mContactConstraints[c].indexBody2];
+    // Get the constrained velocities
+    Vector3 v1 = mLinearVelocities[mContactConstraints[c].indexBody1];
+    Vector3 w1 = mAngularVelocities[mContactConstraints[c].indexBody1];
+    Vector3 v2 = mLinearVelocities[mContactConstraints[c].indexBody2];
+    Vector3 w2 = mAngularVelocities[mContactConstraints[c].indexBody2];
 
-        for (short int i=0; i<mContactConstraints[c].nbContacts; i++) {
-
-            // --------- Penetration --------- //
+    // Get the split velocities
+    Vector3 v1Split, w1Split, v2Split, w2Split;
+    if (isSplitImpulseActive) {
+        v1Split = mSplitLinearVelocities[mContactConstraints[c].indexBody1];
+        w1Split = mSplitAngularVelocities[mContactConstraints[c].indexBody1];
+        v2Split = mSplitLinearVelocities[mContactConstraints[c].indexBody2];
+        w2Split = mSplitAngularVelocities[mContactConstraints[c].indexBody2];
+    }
 
-            // Compute J*v
-            //Vector3 deltaV = v2 + w2.cross(mContactPoints[contactPointIndex].r2) - v1 - w1.cross(mContactPoints[contactPointIndex].r1);
-            Vector3 deltaV(v2.x + w2.y * mContactPoints[contactPointIndex].r2.z - w2.z * mContactPoints[contactPointIndex].r2.y - v1.x -
-                           w1.y * mContactPoints[contactPointIndex].r1.z + w1.z * mContactPoints[contactPointIndex].r1.y,
-                           v2.y + w2.z * mContactPoints[contactPointIndex].r2.x - w2.x * mContactPoints[contactPointIndex].r2.z - v1.y -
-                           w1.z * mContactPoints[contactPointIndex].r1.x + w1.x * mContactPoints[contactPointIndex].r1.z,
-                           v2.z + w2.x * mContactPoints[contactPointIndex].r2.y - w2.y * mContactPoints[contactPointIndex].r2.x - v1.z -
-                           w1.x * mContactPoints[contactPointIndex].r1.y + w1.y * mContactPoints[contactPointIndex].r1.x);
-            decimal deltaVDotN = deltaV.x * mContactPoints[contactPointIndex].normal.x + deltaV.y * mContactPoints[contactPointIndex].normal.y +
-                                 deltaV.z * mContactPoints[contactPointIndex].normal.z;
-            decimal Jv = deltaVDotN;
+    // Solve the normal impulses of all the contact points at once with the block solver. If it
+    // does not find a solution, the contact points are solved one after the other below.
+    int8 nbSequentialContacts = mContactConstraints[c].nbContacts;
+    if (isBlockSolverActive && mContactConstraints[c].nbContacts > 1 &&
+        solveContactManifoldBlock(c, false, v1, w1, v2, w2, impulseDelta)) {
 
-            // Compute the bias "b" of the constraint
-            decimal beta = mIsSplitImpulseActive ? BETA_SPLIT_IMPULSE : BETA;
-            decimal biasPenetrationDepth = 0.0;
-            if (mContactPoints[contactPointIndex].penetrationDepth > SLOP) biasPenetrationDepth = -(beta/mTimeStep) *
-                    max(0.0f, float(mContactPoints[contactPointIndex].penetrationDepth - SLOP));
-            decimal b = biasPenetrationDepth + mContactPoints[contactPointIndex].restitutionBias;
+        // If the split impulses are not solved, the position error is corrected at the next iteration
+        if (isSplitImpulseActive) {
+            solveContactManifoldBlock(c, true, v1Split, w1Split, v2Split, w2Split, impulseDelta);
+        }
 
-            // Compute the Lagrange multiplier lambda
-            if (mIsSplitImpulseActive) {
-                deltaLambda = - (Jv + mContactPoints[contactPointIndex].restitutionBias) *
-                        mContactPoints[contactPointIndex].inversePenetrationMass;
-            }
-            else {
-                deltaLambda = - (Jv + b) * mContactPoints[contactPointIndex].inversePenetrationMass;
-            }
-            lambdaTemp = mContactPoints[contactPointIndex].penetrationImpulse;
-            mContactPoints[contactPointIndex].penetrationImpulse = std::max(mContactPoints[contactPointIndex].penetrationImpulse +
-                                                       deltaLambda, decimal(0.0));
-            deltaLambda = mContactPoints[contactPointIndex].penetrationImpulse - lambdaTemp;
+        for (int8 i=0; i < mContactConstraints[c].nbContacts; i++) {
+            sumPenetrationImpulse += mContactPoints[contactPointIndex + i].penetrationImpulse;
+        }
 
-            Vector3 linearImpulse(mContactPoints[contactPointIndex].normal.x * deltaLambda,
-                                  mContactPoints[contactPointIndex].normal.y * deltaLambda,
-                                  mContactPoints[contactPointIndex].normal.z * deltaLambda);
+        nbSequentialContacts = 0;
+    }
 
-            // Update the velocities of the body 1 by applying the impulse P
-            mLinearVelocities[mContactConstraints[c].indexBody1].x -= mContactConstraints[c].massInverseBody1 * linearImpulse.x;
-            mLinearVelocities[mContactConstraints[c].indexBody1].y -= mContactConstraints[c].massInverseBody1 * linearImpulse.y;
-            mLinearVelocities[mContactConstraints[c].indexBody1].z -= mContactConstraints[c].massInverseBody1 * linearImpulse.z;
+    for (short int i=0; i<nbSequentialContacts; i++) {
 
-            mAngularVelocities[mContactConstraints[c].indexBody1].x -= mContactPoints[contactPointIndex].i1TimesR1CrossN.x * deltaLambda;
-            mAngularVelocities[mContactConstraints[c].indexBody1].y -= mContactPoints[contactPointIndex].i1TimesR1CrossN.y * deltaLambda;
-            mAngularVelocities[mContactConstraints[c].indexBody1].z -= mContactPoints[contactPointIndex].i1TimesR1CrossN.z * deltaLambda;
+        // --------- Penetration --------- //
 
-            // Update the velocities of the body 2 by applying the impulse P
-            mLinearVelocities[mContactConstraints[c].indexBody2].x += mContactConstraints[c].massInverseBody2 * linearImpulse.x;
-            mLinearVelocities[mContactConstraints[c].indexBody2].y += mContactConstraints[c].massInverseBody2 * linearImpulse.y;
-            mLinearVelocities[mContactConstraints[c].indexBody2].z += mContactConstraints[c].massInverseBody2 * linearImpulse.z;
+        // Compute J*v
+        //Vector3 deltaV = v2 + w2.cross(mContactPoints[contactPointIndex].r2) - v1 - w1.cross(mContactPoints[contactPointIndex].r1);
+        Vector3 deltaV(v2.x + w2.y * mContactPoints[contactPointIndex].r2.z - w2.z * mContactPoints[contactPointIndex].r2.y - v1.x -
+                       w1.y * mContactPoints[contactPointIndex].r1.z + w1.z * mContactPoints[contactPointIndex].r1.y,
+                       v2.y + w2.z * mContactPoints[contactPointIndex].r2.x - w2.x * mContactPoints[contactPointIndex].r2.z - v1.y -
+                       w1.z * mContactPoints[contactPointIndex].r1.x + w1.x * mContactPoints[contactPointIndex].r1.z,
+                       v2.z + w2.x * mContactPoints[contactPointIndex].r2.y - w2.y * mContactPoints[contactPointIndex].r2.x - v1.z -
+                       w1.x * mContactPoints[contactPointIndex].r1.y + w1.y * mContactPoints[contactPointIndex].r1.x);
+        decimal deltaVDotN = deltaV.x * mContactPoints[contactPointIndex].normal.x + deltaV.y * mContactPoints[contactPointIndex].normal.y +
+                             deltaV.z * mContactPoints[contactPointIndex].normal.z;
+        decimal Jv = deltaVDotN;
+
+        // Compute the bias "b" of the constraint
+        const decimal biasPenetrationDepth = mContactPoints[contactPointIndex].biasPenetrationDepth;
+        decimal b = biasPenetrationDepth + mContactPoints[contactPointIndex].restitutionBias;
 
-            mAngularVelocities[mContactConstraints[c].indexBody2].x += mContactPoints[contactPointIndex].i2TimesR2CrossN.x * deltaLambda;
-            mAngularVelocities[mContactConstraints[c].indexBody2].y += mContactPoints[contactPointIndex].i2TimesR2CrossN.y * deltaLambda;
-            mAngularVelocities[mContactConstraints[c].indexBody2].z += mContactPoints[contactPointIndex].i2TimesR2CrossN.z * deltaLambda;
+        // Compute the Lagrange multiplier lambda
+        if (isSplitImpulseActive) {
+            deltaLambda = - (Jv + mContactPoints[contactPointIndex].restitutionBias) *
+                    mContactPoints[contactPointIndex].inversePenetrationMass;
+        }
+        else {
+            deltaLambda = - (Jv + b) * mContactPoints[contactPointIndex].inversePenetrationMass * mContactSoftness.massScale -
+                          mContactSoftness.impulseScale * mContactPoints[contactPointIndex].penetrationImpulse;
+        }
+        lambdaTemp = mContactPoints[contactPointIndex].penetrationImpulse;
+        mContactPoints[contactPointIndex].penetrationImpulse = std::max(mContactPoints[contactPointIndex].penetrationImpulse +
+                                                   deltaLambda, decimal(0.0));
+        deltaLambda = mContactPoints[contactPointIndex].penetrationImpulse - lambdaTemp;
+        impulseDelta = std::max(impulseDelta, std::abs(deltaLambda));
 
-            sumPenetrationImpulse += mContactPoints[contactPointIndex].penetrationImpulse;
+        Vector3 linearImpulse(mContactPoints[contactPointIndex].normal.x * deltaLambda,
+                              mContactPoints[contactPointIndex].normal.y * deltaLambda,
+                              mContactPoints[contactPointIndex].normal.z * deltaLambda);
 
-            // If the split impulse position correction is active
-            if (mIsSplitImpulseActive) {
+        // Update the velocities of the body 1 by applying the impulse P
+        v1.x -= mContactConstraints[c].massInverseBody1 * linearImpulse.x;
+        v1.y -= mContactConstraints[c].massInverseBody1 * linearImpulse.y;
+        v1.z -= mContactConstraints[c].massInverseBody1 * linearImpulse.z;
 
-                // Split impulse (position correction)
-                const Vector3& v1Split = mSplitLinearVelocities[mContactConstraints[c].indexBody1];
-                const Vector3& w1Split = mSplitAngularVelocities[mContactConstraints[c].indexBody1];
-                const Vector3& v2Split = mSplitLinearVelocities[mContactConstraints[c].indexBody2];
-                const Vector3& w2Split = mSplitAngularVelocities[mContactConstraints[c].indexBody2];
-
-                //Vector3 deltaVSplit = v2Split + w2Split.cross(mContactPoints[contactPointIndex].r2) - v1Split - w1Split.cross(mContactPoints[contactPointIndex].r1);
-                Vector3 deltaVSplit(v2Split.x + w2Split.y * mContactPoints[contactPointIndex].r2.z - w2Split.z * mContactPoints[contactPointIndex].r2.y - v1Split.x -
-                                    w1Split.y * mContactPoints[contactPointIndex].r1.z + w1Split.z * mContactPoints[contactPointIndex].r1.y,
-                                    v2Split.y + w2Split.z * mContactPoints[contactPointIndex].r2.x - w2Split.x * mContactPoints[contactPointIndex].r2.z - v1Split.y -
-                                    w1Split.z * mContactPoints[contactPointIndex].r1.x + w1Split.x * mContactPoints[contactPointIndex].r1.z,
-                                    v2Split.z + w2Split.x * mContactPoints[contactPointIndex].r2.y - w2Split.y * mContactPoints[contactPointIndex].r2.x - v1Split.z -
-                                    w1Split.x * mContactPoints[contactPointIndex].r1.y + w1Split.y * mContactPoints[contactPointIndex].r1.x);
-                decimal JvSplit = deltaVSplit.x * mContactPoints[contactPointIndex].normal.x +
-                                  deltaVSplit.y * mContactPoints[contactPointIndex].normal.y +
-                                  deltaVSplit.z * mContactPoints[contactPointIndex].normal.z;
-                decimal deltaLambdaSplit = - (JvSplit + biasPenetrationDepth) *
-                        mContactPoints[contactPointIndex].inversePenetrationMass;
-                decimal lambdaTempSplit = mContactPoints[contactPointIndex].penetrationSplitImpulse;
-                mContactPoints[contactPointIndex].penetrationSplitImpulse = std::max(
-                            mContactPoints[contactPointIndex].penetrationSplitImpulse +
-                            deltaLambdaSplit, decimal(0.0));
-                deltaLambdaSplit = mContactPoints[contactPointIndex].penetrationSplitImpulse - lambdaTempSplit;
-
-                Vector3 linearImpulse(mContactPoints[contactPointIndex].normal.x * deltaLambdaSplit,
-                                      mContactPoints[contactPointIndex].normal.y * deltaLambdaSplit,
-                                      mContactPoints[contactPointIndex].normal.z * deltaLambdaSplit);
+        w1.x -= mContactPoints[contactPointIndex].i1TimesR1CrossN.x * deltaLambda;
+        w1.y -= mContactPoints[contactPointIndex].i1TimesR1CrossN.y * deltaLambda;
+        w1.z -= mContactPoints[contactPointIndex].i1TimesR1CrossN.z * deltaLambda;
 
-                // Update the velocities of the body 1 by applying the impulse P
-                mSplitLinearVelocities[mContactConstraints[c].indexBody1].x -= mContactConstraints[c].massInverseBody1 * linearImpulse.x;
-                mSplitLinearVelocities[mContactConstraints[c].indexBody1].y -= mContactConstraints[c].massInverseBody1 * linearImpulse.y;
-                mSplitLinearVelocities[mContactConstraints[c].indexBody1].z -= mContactConstraints[c].massInverseBody1 * linearImpulse.z;
+        // Update the velocities of the body 2 by applying the impulse P
+        v2.x += mContactConstraints[c].massInverseBody2 * linearImpulse.x;
+        v2.y += mContactConstraints[c].massInverseBody2 * linearImpulse.y;
+        v2.z += mContactConstraints[c].massInverseBody2 * linearImpulse.z;
+
+        w2.x += mContactPoints[contactPointIndex].i2TimesR2CrossN.x * deltaLambda;
+        w2.y += mContactPoints[contactPointIndex].i2TimesR2CrossN.y * deltaLambda;
+        w2.z += mContactPoints[contactPointIndex].i2TimesR2CrossN.z * deltaLambda;
+
+        sumPenetrationImpulse += mContactPoints[contactPointIndex].penetrationImpulse;
+
+        // If the split impulse position correction is active
+        if (isSplitImpulseActive) {
+
+            // Split impulse (position correction)
+
+            //Vector3 deltaVSplit = v2Split + w2Split.cross(mContactPoints[contactPointIndex].r2) - v1Split - w1Split.cross(mContactPoints[contactPointIndex].r1);
+            Vector3 deltaVSplit(v2Split.x + w2Split.y * mContactPoints[contactPointIndex].r2.z - w2Split.z * mContactPoints[contactPointIndex].r2.y - v1Split.x -
+                                w1Split.y * mContactPoints[contactPointIndex].r1.z + w1Split.z * mContactPoints[contactPointIndex].r1.y,
+                                v2Split.y + w2Split.z * mContactPoints[contactPointIndex].r2.x - w2Split.x * mContactPoints[contactPointIndex].r2.z - v1Split.y -
+                                w1Split.z * mContactPoints[contactPointIndex].r1.x + w1Split.x * mContactPoints[contactPointIndex].r1.z,
+                                v2Split.z + w2Split.x * mContactPoints[contactPointIndex].r2.y - w2Split.y * mContactPoints[contactPointIndex].r2.x - v1Split.z -
+                                w1Split.x * mContactPoints[contactPointIndex].r1.y + w1Split.y * mContactPoints[contactPointIndex].r1.x);
+            decimal JvSplit = deltaVSplit.x * mContactPoints[contactPointIndex].normal.x +
+                              deltaVSplit.y * mContactPoints[contactPointIndex].normal.y +
+                              deltaVSplit.z * mContactPoints[contactPointIndex].normal.z;
+            decimal deltaLambdaSplit = - (JvSplit + biasPenetrationDepth) *
+                    mContactPoints[contactPointIndex].inversePenetrationMass;
+            decimal lambdaTempSplit = mContactPoints[contactPointIndex].penetrationSplitImpulse;
+            mContactPoints[contactPointIndex].penetrationSplitImpulse = std::max(
+                        mContactPoints[contactPointIndex].penetrationSplitImpulse +
+                        deltaLambdaSplit, decimal(0.0));
+            deltaLambdaSplit = mContactPoints[contactPointIndex].penetrationSplitImpulse - lambdaTempSplit;
+
+            Vector3 linearImpulse(mContactPoints[contactPointIndex].normal.x * deltaLambdaSplit,
+                                  mContactPoints[contactPointIndex].normal.y * deltaLambdaSplit,
+                                  mContactPoints[contactPointIndex].normal.z * deltaLambdaSplit);
 
-                mSplitAngularVelocities[mContactConstraints[c].indexBody1].x -= mContactPoints[contactPointIndex].i1TimesR1CrossN.x * deltaLambdaSplit;
-                mSplitAngularVelocities[mContactConstraints[c].indexBody1].y -= mContactPoints[contactPointIndex].i1TimesR1CrossN.y * deltaLambdaSplit;
-                mSplitAngularVelocities[mContactConstraints[c].indexBody1].z -= mContactPoints[contactPointIndex].i1TimesR1CrossN.z * deltaLambdaSplit;
+            // Update the velocities of the body 1 by applying the impulse P
+            v1Split.x -= mContactConstraints[c].massInverseBody1 * linearImpulse.x;
+            v1Split.y -= mContactConstraints[c].massInverseBody1 * linearImpulse.y;
+            v1Split.z -= mContactConstraints[c].massInverseBody1 * linearImpulse.z;
 
-                // Update the velocities of the body 1 by applying the impulse P
-                mSplitLinearVelocities[mContactConstraints[c].indexBody2].x += mContactConstraints[c].massInverseBody2 * linearImpulse.x;
-                mSplitLinearVelocities[mContactConstraints[c].indexBody2].y += mContactConstraints[c].massInverseBody2 * linearImpulse.y;
-                mSplitLinearVelocities[mContactConstraints[c].indexBody2].z += mContactConstraints[c].massInverseBody2 * linearImpulse.z;
+            w1Split.x -= mContactPoints[contactPointIndex].i1TimesR1CrossN.x * deltaLambdaSplit;
+            w1Split.y -= mContactPoints[contactPointIndex].i1TimesR1CrossN.y * deltaLambdaSplit;
+            w1Split.z -= mContactPoints[contactPointIndex].i1TimesR1CrossN.z * deltaLambdaSplit;
 
-                mSplitAngularVelocities[mContactConstraints[c].indexBody2].x += mContactPoints[contactPointIndex].i2TimesR2CrossN.x * deltaLambdaSplit;
-                mSplitAngularVelocities[mContactConstraints[c].indexBody2].y += mContactPoints[contactPointIndex].i2TimesR2CrossN.y * deltaLambdaSplit;
-                mSplitAngularVelocities[mContactConstraints[c].indexBody2].z += mContactPoints[contactPointIndex].i2TimesR2CrossN.z * deltaLambdaSplit;
-            }
+            // Update the velocities of the body 1 by applying the impulse P
+            v2Split.x += mContactConstraints[c].massInverseBody2 * linearImpulse.x;
+            v2Split.y += mContactConstraints[c].massInverseBody2 * linearImpulse.y;
+            v2Split.z += mContactConstraints[c].massInverseBody2 * linearImpulse.z;
 
-            contactPointIndex++;
+            w2Split.x += mContactPoints[contactPointIndex].i2TimesR2CrossN.x * deltaLambdaSplit;
+            w2Split.y += mContactPoints[contactPointIndex].i2TimesR2CrossN.y * deltaLambdaSplit;
+            w2Split.z += mContactPoints[contactPointIndex].i2TimesR2CrossN.z * deltaLambdaSplit;
         }
 
-        // ------ First friction constraint at the center of the contact manifol ------ //
+        contactPointIndex++;
+    }
+
+    // ------ First friction constraint at the center of the contact manifol ------ //
+
+    // Compute J*v
+    // deltaV = v2 + w2.cross(mContactConstraints[c].r2Friction) - v1 - w1.cross(mContactConstraints[c].r1Friction);
+    Vector3 deltaV(v2.x + w2.y * mContactConstraints[c].r2Friction.z - w2.z * mContactConstraints[c].r2Friction.y - v1.x -
+                   w1.y * mContactConstraints[c].r1Friction.z + w1.z * mContactConstraints[c].r1Friction.y,
+                   v2.y + w2.z * mContactConstraints[c].r2Friction.x - w2.x * mContactConstraints[c].r2Friction.z - v1.y -
+                   w1.z * mContactConstraints[c].r1Friction.x + w1.x * mContactConstraints[c].r1Friction.z,
+                   v2.z + w2.x * mContactConstraints[c].r2Friction.y - w2.y * mContactConstraints[c].r2Friction.x - v1.z -
+                   w1.x * mContactConstraints[c].r1Friction.y + w1.y * mContactConstraints[c].r1Friction.x);
+    decimal Jv = deltaV.x * mContactConstraints[c].frictionVector1.x +
+                 deltaV.y * mContactConstraints[c].frictionVector1.y +
+                 deltaV.z * mContactConstraints[c].frictionVector1.z;
+
+    // Compute the Lagrange multiplier lambda
+    deltaLambda = -Jv * mContactConstraints[c].inverseFriction1Mass;
+    decimal frictionLimit = mContactConstraints[c].frictionCoefficient * sumPenetrationImpulse;
+    lambdaTemp = mContactConstraints[c].friction1Impulse;
+    mContactConstraints[c].friction1Impulse = std::max(-frictionLimit,
+                                                std::min(mContactConstraints[c].friction1Impulse +
+                                                         deltaLambda, frictionLimit));
+    deltaLambda = mContactConstraints[c].friction1Impulse - lambdaTemp;
+    impulseDelta = std::max(impulseDelta, std::abs(deltaLambda));
+
+    // Compute the impulse P=J^T * lambda
+    Vector3 angularImpulseBody1(-mContactConstraints[c].r1CrossT1.x * deltaLambda,
+                                -mContactConstraints[c].r1CrossT1.y * deltaLambda,
+                                -mContactConstraints[c].r1CrossT1.z * deltaLambda);
+    Vector3 linearImpulseBody2(mContactConstraints[c].frictionVector1.x * deltaLambda,
+                               mContactConstraints[c].frictionVector1.y * deltaLambda,
+                               mContactConstraints[c].frictionVector1.z * deltaLambda);
+    Vector3 angularImpulseBody2(mContactConstraints[c].r2CrossT1.x * deltaLambda,
+                                mContactConstraints[c].r2CrossT1.y * deltaLambda,
+                                mContactConstraints[c].r2CrossT1.z * deltaLambda);
+
+    // Update the velocities of the body 1 by applying the impulse P
+    v1.x -= mContactConstraints[c].massInverseBody1 * linearImpulseBody2.x;
+    v1.y -= mContactConstraints[c].massInverseBody1 * linearImpulseBody2.y;
+    v1.z -= mContactConstraints[c].massInverseBody1 * linearImpulseBody2.z;
+
+    w1 += mContactConstraints[c].inverseInertiaTensorBody1 * angularImpulseBody1;
+
+    // Update the velocities of the body 2 by applying the impulse P
+    v2.x += mContactConstraints[c].massInverseBody2 * linearImpulseBody2.x;
+    v2.y += mContactConstraints[c].massInverseBody2 * linearImpulseBody2.y;
+    v2.z += mContactConstraints[c].massInverseBody2 * linearImpulseBody2.z;
+
+    w2 += mContactConstraints[c].inverseInertiaTensorBody2 * angularImpulseBody2;
+
+    // ------ Second friction constraint at the center of the contact manifol ----- //
+
+    // Compute J*v
+    //deltaV = v2 + w2.cross(mContactConstraints[c].r2Friction) - v1 - w1.cross(mContactConstraints[c].r1Friction);
+    deltaV.x = v2.x + w2.y * mContactConstraints[c].r2Friction.z - v2.z * mContactConstraints[c].r2Friction.y  - v1.x -
+               w1.y * mContactConstraints[c].r1Friction.z + w1.z * mContactConstraints[c].r1Friction.y;
+    deltaV.y = v2.y + w2.z * mContactConstraints[c].r2Friction.x - v2.x * mContactConstraints[c].r2Friction.z  - v1.y -
+               w1.z * mContactConstraints[c].r1Friction.x + w1.x * mContactConstraints[c].r1Friction.z;
+    deltaV.z = v2.z + w2.x * mContactConstraints[c].r2Friction.y - v2.y * mContactConstraints[c].r2Friction.x  - v1.z -
+               w1.x * mContactConstraints[c].r1Friction.y + w1.y * mContactConstraints[c].r1Friction.x;
+    Jv = deltaV.x * mContactConstraints[c].frictionVector2.x + deltaV.y * mContactConstraints[c].frictionVector2.y +
+         deltaV.z * mContactConstraints[c].frictionVector2.z;
+
+    // Compute the Lagrange multiplier lambda
+    deltaLambda = -Jv * mContactConstraints[c].inverseFriction2Mass;
+    frictionLimit = mContactConstraints[c].frictionCoefficient * sumPenetrationImpulse;
+    lambdaTemp = mContactConstraints[c].friction2Impulse;
+    mContactConstraints[c].friction2Impulse = std::max(-frictionLimit,
+                                                std::min(mContactConstraints[c].friction2Impulse +
+                                                         deltaLambda, frictionLimit));
+    deltaLambda = mContactConstraints[c].friction2Impulse - lambdaTemp;
+    impulseDelta = std::max(impulseDelta, std::abs(deltaLambda));
+
+    // Compute the impulse P=J^T * lambda
+    angularImpulseBody1.x = -mContactConstraints[c].r1CrossT2.x * deltaLambda;
+    angularImpulseBody1.y = -mContactConstraints[c].r1CrossT2.y * deltaLambda;
+    angularImpulseBody1.z = -mContactConstraints[c].r1CrossT2.z * deltaLambda;
+
+    linearImpulseBody2.x = mContactConstraints[c].frictionVector2.x * deltaLambda;
+    linearImpulseBody2.y = mContactConstraints[c].frictionVector2.y * deltaLambda;
+    linearImpulseBody2.z = mContactConstraints[c].frictionVector2.z * deltaLambda;
+
+    angularImpulseBody2.x = mContactConstraints[c].r2CrossT2.x * deltaLambda;
+    angularImpulseBody2.y = mContactConstraints[c].r2CrossT2.y * deltaLambda;
+    angularImpulseBody2.z = mContactConstraints[c].r2CrossT2.z * deltaLambda;
+
+    // Update the velocities of the body 1 by applying the impulse P
+    v1.x -= mContactConstraints[c].massInverseBody1 * linearImpulseBody2.x;
+    v1.y -= mContactConstraints[c].massInverseBody1 * linearImpulseBody2.y;
+    v1.z -= mContactConstraints[c].massInverseBody1 * linearImpulseBody2.z;
+    w1 += mContactConstraints[c].inverseInertiaTensorBody1 * angularImpulseBody1;
+
+    // Update the velocities of the body 2 by applying the impulse P
+    v2.x += mContactConstraints[c].massInverseBody2 * linearImpulseBody2.x;
+    v2.y += mContactConstraints[c].massInverseBody2 * linearImpulseBody2.y;
+    v2.z += mContactConstraints[c].massInverseBody2 * linearImpulseBody2.z;
+    w2 += mContactConstraints[c].inverseInertiaTensorBody2 * angularImpulseBody2;
+
+    // ------ Twist friction constraint at the center of the contact manifol ------ //
+
+    // Compute J*v
+    deltaV = w2 - w1;
+    Jv = deltaV.x * mContactConstraints[c].normal.x + deltaV.y * mContactConstraints[c].normal.y +
+         deltaV.z * mContactConstraints[c].normal.z;
+
+    deltaLambda = -Jv * (mContactConstraints[c].inverseTwistFrictionMass);
+    frictionLimit = mContactConstraints[c].frictionCoefficient * sumPenetrationImpulse;
+    lambdaTemp = mContactConstraints[c].frictionTwistImpulse;
+    mContactConstraints[c].frictionTwistImpulse = std::max(-frictionLimit,
+                                                    std::min(mContactConstraints[c].frictionTwistImpulse
+                                                             + deltaLambda, frictionLimit));
+    deltaLambda = mContactConstraints[c].frictionTwistImpulse - lambdaTemp;
+    impulseDelta = std::max(impulseDelta, std::abs(deltaLambda));
+
+    // Compute the impulse P=J^T * lambda
+    angularImpulseBody2.x = mContactConstraints[c].normal.x * deltaLambda;
+    angularImpulseBody2.y = mContactConstraints[c].normal.y * deltaLambda;
+    angularImpulseBody2.z = mContactConstraints[c].normal.z * deltaLambda;
+
+    // Update the velocities of the body 1 by applying the impulse P
+    w1 -= mContactConstraints[c].inverseInertiaTensorBody1 * angularImpulseBody2;
+
+    // Update the velocities of the body 1 by applying the impulse P
+    w2 += mContactConstraints[c].inverseInertiaTensorBody2 * angularImpulseBody2;
+
+    // --------- Rolling resistance constraint at the center of the contact manifold --------- //
+
+    if (isRollingResistanceActive && mContactConstraints[c].rollingResistanceFactor > 0) {
 
         // Compute J*v
-        // deltaV = v2 + w2.cross(mContactConstraints[c].r2Friction) - v1 - w1.cross(mContactConstraints[c].r1Friction);
-        Vector3 deltaV(v2.x + w2.y * mContactConstraints[c].r2Friction.z - w2.z * mContactConstraints[c].r2Friction.y - v1.x -
-                       w1.y * mContactConstraints[c].r1Friction.z + w1.z * mContactConstraints[c].r1Friction.y,
-                       v2.y + w2.z * mContactConstraints[c].r2Friction.x - w2.x * mContactConstraints[c].r2Friction.z - v1.y -
-                       w1.z * mContactConstraints[c].r1Friction.x + w1.x * mContactConstraints[c].r1Friction.z,
-                       v2.z + w2.x * mContactConstraints[c].r2Friction.y - w2.y * mContactConstraints[c].r2Friction.x - v1.z -
-                       w1.x * mContactConstraints[c].r1Friction.y + w1.y * mContactConstraints[c].r1Friction.x);
-        decimal Jv = deltaV.x * mContactConstraints[c].frictionVector1.x +
-                     deltaV.y * mContactConstraints[c].frictionVector1.y +
-                     deltaV.z * mContactConstraints[c].frictionVector1.z;
+        const Vector3 JvRolling = w2 - w1;
 
         // Compute the Lagrange multiplier lambda
-        decimal deltaLambda = -Jv * mContactConstraints[c].inverseFriction1Mass;
-        decimal frictionLimit = mContactConstraints[c].frictionCoefficient * sumPenetrationImpulse;
-        lambdaTemp = mContactConstraints[c].friction1Impulse;
-        mContactConstraints[c].friction1Impulse = std::max(-frictionLimit,
-                                                    std::min(mContactConstraints[c].friction1Impulse +
-                                                             deltaLambda, frictionLimit));
-        deltaLambda = mContactConstraints[c].friction1Impulse - lambdaTemp;
-
-        // Compute the impulse P=J^T * lambda
-        Vector3 angularImpulseBody1(-mContactConstraints[c].r1CrossT1.x * deltaLambda,
-                                    -mContactConstraints[c].r1CrossT1.y * deltaLambda,
-                                    -mContactConstraints[c].r1CrossT1.z * deltaLambda);
-        Vector3 linearImpulseBody2(mContactConstraints[c].frictionVector1.x * deltaLambda,
-                                   mContactConstraints[c].frictionVector1.y * deltaLambda,
-                                   mContactConstraints[c].frictionVector1.z * deltaLambda);
-        Vector3 angularImpulseBody2(mContactConstraints[c].r2CrossT1.x * deltaLambda,
-                                    mContactConstraints[c].r2CrossT1.y * deltaLambda,
-                                    mContactConstraints[c].r2CrossT1.z * deltaLambda);
+        Vector3 deltaLambdaRolling = mContactConstraints[c].inverseRollingResistance * (-JvRolling);
+        decimal rollingLimit = mContactConstraints[c].rollingResistanceFactor * sumPenetrationImpulse;
+        Vector3 lambdaTempRolling = mContactConstraints[c].rollingResistanceImpulse;
+        mContactConstraints[c].rollingResistanceImpulse = clamp(mContactConstraints[c].rollingResistanceImpulse +
+                                                             deltaLambdaRolling, rollingLimit);
+        deltaLambdaRolling = mContactConstraints[c].rollingResistanceImpulse - lambdaTempRolling;
 
         // Update the velocities of the body 1 by applying the impulse P
-        mLinearVelocities[mContactConstraints[c].indexBody1].x -= mContactConstraints[c].massInverseBody1 * linearImpulseBody2.x;
-        mLinearVelocities[mContactConstraints[c].indexBody1].y -= mContactConstraints[c].massInverseBody1 * linearImpulseBody2.y;
-        mLinearVelocities[mContactConstraints[c].indexBody1].z -= mContactConstraints[c].massInverseBody1 * linearImpulseBody2.z;
-
-        mAngularVelocities[mContactConstraints[c].indexBody1] += mContactConstraints[c].inverseInertiaTensorBody1 * angularImpulseBody1;
+        w1 -= mContactConstraints[c].inverseInertiaTensorBody1 * deltaLambdaRolling;
 
         // Update the velocities of the body 2 by applying the impulse P
-        mLinearVelocities[mContactConstraints[c].indexBody2].x += mContactConstraints[c].massInverseBody2 * linearImpulseBody2.x;
-        mLinearVelocities[mContactConstraints[c].indexBody2].y += mContactConstraints[c].massInverseBody2 * linearImpulseBody2.y;
-        mLinearVelocities[mContactConstraints[c].indexBody2].z += mContactConstraints[c].massInverseBody2 * linearImpulseBody2.z;
+        w2 += mContactConstraints[c].inverseInertiaTensorBody2 * deltaLambdaRolling;
+    }
+
+    // Write back the velocities of the dynamic bodies
+    if (mContactConstraints[c].isBody1Dynamic) {
+        mLinearVelocities[mContactConstraints[c].indexBody1] = v1;
+        mAngularVelocities[mContactConstraints[c].indexBody1] = w1;
+        if (isSplitImpulseActive) {
+            mSplitLinearVelocities[mContactConstraints[c].indexBody1] = v1Split;
+            mSplitAngularVelocities[mContactConstraints[c].indexBody1] = w1Split;
+        }
+    }
+    if (mContactConstraints[c].isBody2Dynamic) {
+        mLinearVelocities[mContactConstraints[c].indexBody2] = v2;
+        mAngularVelocities[mContactConstraints[c].indexBody2] = w2;
+        if (isSplitImpulseActive) {
+            mSplitLinearVelocities[mContactConstraints[c].indexBody2] = v2Split;
+            mSplitAngularVelocities[mContactConstraints[c].indexBody2] = w2Split;
+        }
+    }
+
+    return impulseDelta;
+}
+
+// Solve the contacts of a range of contact manifolds
+/**
+ * @param firstIndex Index of the first contact manifold of the range in the contact constraints array
+ * @param endIndex Index after the last contact manifold of the range
+ * @return The largest absolute change of the impulses of the contact manifolds
+ */
+template<bool isSplitImpulseActive, bool isRollingResistanceActive, bool isBlockSolverActive>
+decimal ContactSolver::solveContactManifolds(uint firstIndex, uint endIndex) {
+
+    decimal impulseDelta = decimal(0.0);
+    for (uint c=firstIndex; c < endIndex; c++) {
+        impulseDelta = std::max(impulseDelta,
+                                solveContactManifold<isSplitImpulseActive, isRollingResistanceActive, isBlockSolverActive>(c));
+    }
 
-        mAngularVelocities[mContactConstraints[c].indexBody2] += mContactConstraints[c].inverseInertiaTensorBody2 * angularImpulseBody2;
+    return impulseDelta;
+}
+
+// Instantiations of solveContactManifolds() indexed by the solver features
+const ContactSolver::SolveContactManifoldsMethod
+ContactSolver::SOLVE_CONTACT_MANIFOLDS_METHODS[ContactSolver::NB_SOLVER_FEATURES_COMBINATIONS] = {
+    &ContactSolver::solveContactManifolds<false, false, false>,
+    &ContactSolver::solveContactManifolds<true, false, false>,
+    &ContactSolver::solveContactManifolds<false, true, false>,
+    &ContactSolver::solveContactManifolds<true, true, false>,
+    &ContactSolver::solveContactManifolds<false, false, true>,
+    &ContactSolver::solveContactManifolds<true, false, true>,
+    &ContactSolver::solveContactManifolds<false, true, true>,
+    &ContactSolver::solveContactManifolds<true, true, true>
+};
+
+// Return the solver features of the contact manifolds of an island
+/// The split impulses and the block solver are enabled for the whole step and the rolling
+/// resistance is only used if at least one contact manifold of the island has a rolling
+/// resistance factor.
+uint8 ContactSolver::getIslandSolverFeatures(uint islandIndex) const {
+
+    uint8 features = mIslandsSolverFeatures[islandIndex];
+    if (mIsSplitImpulseActive) features |= SOLVER_FEATURE_SPLIT_IMPULSE;
+    if (mContactBlocks != nullptr) features |= SOLVER_FEATURE_BLOCK_SOLVER;
+
+    return features;
+}
+
+// Return true if the cached solver data of a resting contact point can be reused
+/// The products of the inverse inertia tensors with the lever arms and the inverse mass of the
+/// penetration constraint only depend on the lever arms, the normal and the masses and
+/// orientations of the bodies. They are reused when the caching is enabled in the world settings,
+/// the inverse masses are the same and the lever arms, the normal and the orientations of the
+/// bodies have changed by less than the tolerance (a distance and an angle) since they have
+/// been computed. The lever arms of the current step are always used by the solver.
+/**
+ * @param contactPoint The external contact point
+ * @param contactPointSolver The contact point constraint with the lever arms and normal of the current step
+ * @param body1 Pointer to the first body of the contact
+ * @param body2 Pointer to the second body of the contact
+ * @return True if the cached solver data of the contact point is still valid
+ */
+bool ContactSolver::canReuseContactPointSolverData(const ContactPoint* contactPoint,
+                                                   const ContactPointSolver& contactPointSolver,
+                                                   const RigidBody* body1, const RigidBody* body2) const {
+
+    if (!mWorldSettings.isContactSolverDataCacheEnabled || !contactPoint->mIsSolverDataCached) return false;
+    if (body1->mMassInverse != contactPoint->mCachedMassInverseBody1 ||
+        body2->mMassInverse != contactPoint->mCachedMassInverseBody2) {
+        return false;
+    }
 
-        // ------ Second friction constraint at the center of the contact manifol ----- //
+    const decimal tolerance = mWorldSettings.contactSolverDataCacheTolerance;
+    const decimal toleranceSquare = tolerance * tolerance;
+
+    // Check the change of the lever arms and of the normal
+    if ((contactPointSolver.r1 - contactPoint->mCachedR1).lengthSquare() > toleranceSquare ||
+        (contactPointSolver.r2 - contactPoint->mCachedR2).lengthSquare() > toleranceSquare ||
+        (contactPointSolver.normal - contactPoint->mCachedNormal).lengthSquare() > toleranceSquare) {
+        return false;
+    }
+
+    // Check the angle of the rotation of the bodies (twice the vector part of the relative rotation)
+    const Quaternion rotationBody1 = body1->getTransform().getOrientation() * contactPoint->mCachedOrientationBody1.getInverse();
+    const Quaternion rotationBody2 = body2->getTransform().getOrientation() * contactPoint->mCachedOrientationBody2.getInverse();
+    const decimal halfTolerance = decimal(0.5) * tolerance;
+    return rotationBody1.getVectorV().lengthSquare() <= halfTolerance * halfTolerance &&
+           rotationBody2.getVectorV().lengthSquare() <= halfTolerance * halfTolerance;
+}
+
+// Store the solver data of a contact point and the state of the bodies used to compute it
+/**
+ * @param contactPoint The external contact point
+ * @param contactPointSolver The initialized contact point constraint
+ * @param body1 Pointer to the first body of the contact
+ * @param body2 Pointer to the second body of the contact
+ */
+void ContactSolver::cacheContactPointSolverData(ContactPoint* contactPoint, const ContactPointSolver& contactPointSolver,
+                                                const RigidBody* body1, const RigidBody* body2) const {
+
+    contactPoint->mIsSolverDataCached = mWorldSettings.isContactSolverDataCacheEnabled;
+    if (!contactPoint->mIsSolverDataCached) return;
+
+    contactPoint->mCachedR1 = contactPointSolver.r1;
+    contactPoint->mCachedR2 = contactPointSolver.r2;
+    contactPoint->mCachedNormal = contactPointSolver.normal;
+    contactPoint->mCachedOrientationBody1 = body1->getTransform().getOrientation();
+    contactPoint->mCachedOrientationBody2 = body2->getTransform().getOrientation();
+    contactPoint->mCachedMassInverseBody1 = body1->mMassInverse;
+    contactPoint->mCachedMassInverseBody2 = body2->mMassInverse;
+    contactPoint->mCachedI1TimesR1CrossN = contactPointSolver.i1TimesR1CrossN;
+    contactPoint->mCachedI2TimesR2CrossN = contactPointSolver.i2TimesR2CrossN;
+    contactPoint->mCachedInversePenetrationMass = contactPointSolver.inversePenetrationMass;
+}
+
+// Solve the contacts of a group of contact manifolds with the wide contact solver
+/// The computations are exactly the same as in solve() but they are done for all the
+/// lanes of the group at once. The velocities of the bodies of the group are gathered
+/// into local arrays and written back at the end. This is only valid because a dynamic
+/// body cannot be part of two lanes of the same group.
+/**
+ * @param group The group of contact manifolds to solve
+ * @return The largest absolute change of the impulses of the group
+ */
+decimal ContactSolver::solveContactGroup(ContactGroupSolver& group) {
+
+    const uint N = NB_CONTACT_LANES;
+    ContactManifoldLanes& c = group.lanes;
+    decimal impulseDelta = decimal(0.0);
+
+    // Gather the constrained velocities of the bodies
+    decimal v1[3][N], w1[3][N], v2[3][N], w2[3][N];
+    for (uint lane=0; lane < N; lane++) {
+        const Vector3& linearVelocity1 = mLinearVelocities[group.indexBody1[lane]];
+        const Vector3& angularVelocity1 = mAngularVelocities[group.indexBody1[lane]];
+        const Vector3& linearVelocity2 = mLinearVelocities[group.indexBody2[lane]];
+        const Vector3& angularVelocity2 = mAngularVelocities[group.indexBody2[lane]];
+        for (uint i=0; i < 3; i++) {
+            v1[i][lane] = linearVelocity1[i];
+            w1[i][lane] = angularVelocity1[i];
+            v2[i][lane] = linearVelocity2[i];
+            w2[i][lane] = angularVelocity2[i];
+        }
+    }
+
+    // Gather the split velocities of the bodies
+    decimal v1Split[3][N], w1Split[3][N], v2Split[3][N], w2Split[3][N];
+    if (mIsSplitImpulseActive) {
+        for (uint lane=0; lane < N; lane++) {
+            const Vector3& linearVelocity1 = mSplitLinearVelocities[group.indexBody1[lane]];
+            const Vector3& angularVelocity1 = mSplitAngularVelocities[group.indexBody1[lane]];
+            const Vector3& linearVelocity2 = mSplitLinearVelocities[group.indexBody2[lane]];
+            const Vector3& angularVelocity2 = mSplitAngularVelocities[group.indexBody2[lane]];
+            for (uint i=0; i < 3; i++) {
+                v1Split[i][lane] = linearVelocity1[i];
+                w1Split[i][lane] = angularVelocity1[i];
+                v2Split[i][lane] = linearVelocity2[i];
+                w2Split[i][lane] = angularVelocity2[i];
+            }
+        }
+    }
+
+    decimal sumPenetrationImpulse[N];
+    for (uint lane=0; lane < N; lane++) sumPenetrationImpulse[lane] = decimal(0.0);
+
+    // For each contact point of the manifolds
+    for (int8 k=0; k < group.nbMaxContacts; k++) {
+
+        ContactPointLanes& p = c.points[k];
+
+        // --------- Penetration --------- //
+
+        for (uint lane=0; lane < N; lane++) {
+
+            // Compute J*v
+            const decimal deltaVX = v2[0][lane] + w2[1][lane] * p.r2[2][lane] - w2[2][lane] * p.r2[1][lane] - v1[0][lane] -
+                                    w1[1][lane] * p.r1[2][lane] + w1[2][lane] * p.r1[1][lane];
+            const decimal deltaVY = v2[1][lane] + w2[2][lane] * p.r2[0][lane] - w2[0][lane] * p.r2[2][lane] - v1[1][lane] -
+                                    w1[2][lane] * p.r1[0][lane] + w1[0][lane] * p.r1[2][lane];
+            const decimal deltaVZ = v2[2][lane] + w2[0][lane] * p.r2[1][lane] - w2[1][lane] * p.r2[0][lane] - v1[2][lane] -
+                                    w1[0][lane] * p.r1[1][lane] + w1[1][lane] * p.r1[0][lane];
+            const decimal Jv = deltaVX * p.normal[0][lane] + deltaVY * p.normal[1][lane] + deltaVZ * p.normal[2][lane];
+
+            // Compute the Lagrange multiplier lambda
+            decimal deltaLambda;
+            if (mIsSplitImpulseActive) {
+                deltaLambda = - (Jv + p.restitutionBias[lane]) * p.inversePenetrationMass[lane];
+            }
+            else {
+                const decimal b = p.biasPenetrationDepth[lane] + p.restitutionBias[lane];
+                deltaLambda = - (Jv + b) * p.inversePenetrationMass[lane] * mContactSoftness.massScale -
+                              mContactSoftness.impulseScale * p.penetrationImpulse[lane];
+            }
+            const decimal lambdaTemp = p.penetrationImpulse[lane];
+            p.penetrationImpulse[lane] = std::max(p.penetrationImpulse[lane] + deltaLambda, decimal(0.0));
+            deltaLambda = p.penetrationImpulse[lane] - lambdaTemp;
+            impulseDelta = std::max(impulseDelta, std::abs(deltaLambda));
+
+            // Update the velocities of the bodies by applying the impulse P
+            for (uint i=0; i < 3; i++) {
+                const decimal linearImpulse = p.normal[i][lane] * deltaLambda;
+                v1[i][lane] -= c.massInverseBody1[lane] * linearImpulse;
+                w1[i][lane] -= p.i1TimesR1CrossN[i][lane] * deltaLambda;
+                v2[i][lane] += c.massInverseBody2[lane] * linearImpulse;
+                w2[i][lane] += p.i2TimesR2CrossN[i][lane] * deltaLambda;
+            }
+
+            sumPenetrationImpulse[lane] += p.penetrationImpulse[lane];
+        }
+
+        // If the split impulse position correction is active
+        if (mIsSplitImpulseActive) {
+
+            for (uint lane=0; lane < N; lane++) {
+
+                // Split impulse (position correction)
+                const decimal deltaVSplitX = v2Split[0][lane] + w2Split[1][lane] * p.r2[2][lane] - w2Split[2][lane] * p.r2[1][lane] -
+                                             v1Split[0][lane] - w1Split[1][lane] * p.r1[2][lane] + w1Split[2][lane] * p.r1[1][lane];
+                const decimal deltaVSplitY = v2Split[1][lane] + w2Split[2][lane] * p.r2[0][lane] - w2Split[0][lane] * p.r2[2][lane] -
+                                             v1Split[1][lane] - w1Split[2][lane] * p.r1[0][lane] + w1Split[0][lane] * p.r1[2][lane];
+                const decimal deltaVSplitZ = v2Split[2][lane] + w2Split[0][lane] * p.r2[1][lane] - w2Split[1][lane] * p.r2[0][lane] -
+                                             v1Split[2][lane] - w1Split[0][lane] * p.r1[1][lane] + w1Split[1][lane] * p.r1[0][lane];
+                const decimal JvSplit = deltaVSplitX * p.normal[0][lane] + deltaVSplitY * p.normal[1][lane] +
+                                        deltaVSplitZ * p.normal[2][lane];
+                decimal deltaLambdaSplit = - (JvSplit + p.biasPenetrationDepth[lane]) * p.inversePenetrationMass[lane];
+                const decimal lambdaTempSplit = p.penetrationSplitImpulse[lane];
+                p.penetrationSplitImpulse[lane] = std::max(p.penetrationSplitImpulse[lane] + deltaLambdaSplit, decimal(0.0));
+                deltaLambdaSplit = p.penetrationSplitImpulse[lane] - lambdaTempSplit;
+
+                // Update the split velocities of the bodies by applying the impulse P
+                for (uint i=0; i < 3; i++) {
+                    const decimal linearImpulse = p.normal[i][lane] * deltaLambdaSplit;
+                    v1Split[i][lane] -= c.massInverseBody1[lane] * linearImpulse;
+                    w1Split[i][lane] -= p.i1TimesR1CrossN[i][lane] * deltaLambdaSplit;
+                    v2Split[i][lane] += c.massInverseBody2[lane] * linearImpulse;
+                    w2Split[i][lane] += p.i2TimesR2CrossN[i][lane] * deltaLambdaSplit;
+                }
+            }
+        }
+    }
+
+    // ------ First friction constraint at the center of the contact manifold ------ //
+
+    for (uint lane=0; lane < N; lane++) {
 
         // Compute J*v
-        //deltaV = v2 + w2.cross(mContactConstraints[c].r2Friction) - v1 - w1.cross(mContactConstraints[c].r1Friction);
-        deltaV.x = v2.x + w2.y * mContactConstraints[c].r2Friction.z - v2.z * mContactConstraints[c].r2Friction.y  - v1.x -
-                   w1.y * mContactConstraints[c].r1Friction.z + w1.z * mContactConstraints[c].r1Friction.y;
-        deltaV.y = v2.y + w2.z * mContactConstraints[c].r2Friction.x - v2.x * mContactConstraints[c].r2Friction.z  - v1.y -
-                   w1.z * mContactConstraints[c].r1Friction.x + w1.x * mContactConstraints[c].r1Friction.z;
-        deltaV.z = v2.z + w2.x * mContactConstraints[c].r2Friction.y - v2.y * mContactConstraints[c].r2Friction.x  - v1.z -
-                   w1.x * mContactConstraints[c].r1Friction.y + w1.y * mContactConstraints[c].r1Friction.x;
-        Jv = deltaV.x * mContactConstraints[c].frictionVector2.x + deltaV.y * mContactConstraints[c].frictionVector2.y +
-             deltaV.z * mContactConstraints[c].frictionVector2.z;
+        const decimal deltaVX = v2[0][lane] + w2[1][lane] * c.r2Friction[2][lane] - w2[2][lane] * c.r2Friction[1][lane] - v1[0][lane] -
+                                w1[1][lane] * c.r1Friction[2][lane] + w1[2][lane] * c.r1Friction[1][lane];
+        const decimal deltaVY = v2[1][lane] + w2[2][lane] * c.r2Friction[0][lane] - w2[0][lane] * c.r2Friction[2][lane] - v1[1][lane] -
+                                w1[2][lane] * c.r1Friction[0][lane] + w1[0][lane] * c.r1Friction[2][lane];
+        const decimal deltaVZ = v2[2][lane] + w2[0][lane] * c.r2Friction[1][lane] - w2[1][lane] * c.r2Friction[0][lane] - v1[2][lane] -
+                                w1[0][lane] * c.r1Friction[1][lane] + w1[1][lane] * c.r1Friction[0][lane];
+        const decimal Jv = deltaVX * c.frictionVector1[0][lane] + deltaVY * c.frictionVector1[1][lane] +
+                           deltaVZ * c.frictionVector1[2][lane];
 
         // Compute the Lagrange multiplier lambda
-        deltaLambda = -Jv * mContactConstraints[c].inverseFriction2Mass;
-        frictionLimit = mContactConstraints[c].frictionCoefficient * sumPenetrationImpulse;
-        lambdaTemp = mContactConstraints[c].friction2Impulse;
-        mContactConstraints[c].friction2Impulse = std::max(-frictionLimit,
-                                                    std::min(mContactConstraints[c].friction2Impulse +
-                                                             deltaLambda, frictionLimit));
-        deltaLambda = mContactConstraints[c].friction2Impulse - lambdaTemp;
+        decimal deltaLambda = -Jv * c.inverseFriction1Mass[lane];
+        const decimal frictionLimit = c.frictionCoefficient[lane] * sumPenetrationImpulse[lane];
+        const decimal lambdaTemp = c.friction1Impulse[lane];
+        c.friction1Impulse[lane] = std::max(-frictionLimit, std::min(c.friction1Impulse[lane] + deltaLambda, frictionLimit));
+        deltaLambda = c.friction1Impulse[lane] - lambdaTemp;
+        impulseDelta = std::max(impulseDelta, std::abs(deltaLambda));
 
         // Compute the impulse P=J^T * lambda
-        angularImpulseBody1.x = -mContactConstraints[c].r1CrossT2.x * deltaLambda;
-        angularImpulseBody1.y = -mContactConstraints[c].r1CrossT2.y * deltaLambda;
-        angularImpulseBody1.z = -mContactConstraints[c].r1CrossT2.z * deltaLambda;
+        decimal angularImpulseBody1[3], angularImpulseBody2[3];
+        for (uint i=0; i < 3; i++) {
+            angularImpulseBody1[i] = -c.r1CrossT1[i][lane] * deltaLambda;
+            angularImpulseBody2[i] = c.r2CrossT1[i][lane] * deltaLambda;
+            const decimal linearImpulseBody2 = c.frictionVector1[i][lane] * deltaLambda;
+            v1[i][lane] -= c.massInverseBody1[lane] * linearImpulseBody2;
+            v2[i][lane] += c.massInverseBody2[lane] * linearImpulseBody2;
+        }
+
+        // Update the angular velocities of the bodies by applying the impulse P
+        for (uint i=0; i < 3; i++) {
+            w1[i][lane] += c.inverseInertiaTensorBody1[3 * i][lane] * angularImpulseBody1[0] +
+                           c.inverseInertiaTensorBody1[3 * i + 1][lane] * angularImpulseBody1[1] +
+                           c.inverseInertiaTensorBody1[3 * i + 2][lane] * angularImpulseBody1[2];
+            w2[i][lane] += c.inverseInertiaTensorBody2[3 * i][lane] * angularImpulseBody2[0] +
+                           c.inverseInertiaTensorBody2[3 * i + 1][lane] * angularImpulseBody2[1] +
+                           c.inverseInertiaTensorBody2[3 * i + 2][lane] * angularImpulseBody2[2];
+        }
+    }
 
-        linearImpulseBody2.x = mContactConstraints[c].frictionVector2.x * deltaLambda;
-        linearImpulseBody2.y = mContactConstraints[c].frictionVector2.y * deltaLambda;
-        linearImpulseBody2.z = mContactConstraints[c].frictionVector2.z * deltaLambda;
+    // ------ Second friction constraint at the center of the contact manifold ----- //
 
-        angularImpulseBody2.x = mContactConstraints[c].r2CrossT2.x * deltaLambda;
-        angularImpulseBody2.y = mContactConstraints[c].r2CrossT2.y * deltaLambda;
-        angularImpulseBody2.z = mContactConstraints[c].r2CrossT2.z * deltaLambda;
+    for (uint lane=0; lane < N; lane++) {
 
-        // Update the velocities of the body 1 by applying the impulse P
-        mLinearVelocities[mContactConstraints[c].indexBody1].x -= mContactConstraints[c].massInverseBody1 * linearImpulseBody2.x;
-        mLinearVelocities[mContactConstraints[c].indexBody1].y -= mContactConstraints[c].massInverseBody1 * linearImpulseBody2.y;
-        mLinearVelocities[mContactConstraints[c].indexBody1].z -= mContactConstraints[c].massInverseBody1 * linearImpulseBody2.z;
-        mAngularVelocities[mContactConstraints[c].indexBody1] += mContactConstraints[c].inverseInertiaTensorBody1 * angularImpulseBody1;
+        // Compute J*v (this uses the same terms as the scalar solver so that both solvers
+        // give exactly the same result)
+        const decimal deltaVX = v2[0][lane] + w2[1][lane] * c.r2Friction[2][lane] - v2[2][lane] * c.r2Friction[1][lane] - v1[0][lane] -
+                                w1[1][lane] * c.r1Friction[2][lane] + w1[2][lane] * c.r1Friction[1][lane];
+        const decimal deltaVY = v2[1][lane] + w2[2][lane] * c.r2Friction[0][lane] - v2[0][lane] * c.r2Friction[2][lane] - v1[1][lane] -
+                                w1[2][lane] * c.r1Friction[0][lane] + w1[0][lane] * c.r1Friction[2][lane];
+        const decimal deltaVZ = v2[2][lane] + w2[0][lane] * c.r2Friction[1][lane] - v2[1][lane] * c.r2Friction[0][lane] - v1[2][lane] -
+                                w1[0][lane] * c.r1Friction[1][lane] + w1[1][lane] * c.r1Friction[0][lane];
+        const decimal Jv = deltaVX * c.frictionVector2[0][lane] + deltaVY * c.frictionVector2[1][lane] +
+                           deltaVZ * c.frictionVector2[2][lane];
 
-        // Update the velocities of the body 2 by applying the impulse P
-        mLinearVelocities[mContactConstraints[c].indexBody2].x += mContactConstraints[c].massInverseBody2 * linearImpulseBody2.x;
-        mLinearVelocities[mContactConstraints[c].indexBody2].y += mContactConstraints[c].massInverseBody2 * linearImpulseBody2.y;
-        mLinearVelocities[mContactConstraints[c].indexBody2].z += mContactConstraints[c].massInverseBody2 * linearImpulseBody2.z;
-        mAngularVelocities[mContactConstraints[c].indexBody2] += mContactConstraints[c].inverseInertiaTensorBody2 * angularImpulseBody2;
+        // Compute the Lagrange multiplier lambda
+        decimal deltaLambda = -Jv * c.inverseFriction2Mass[lane];
+        const decimal frictionLimit = c.frictionCoefficient[lane] * sumPenetrationImpulse[lane];
+        const decimal lambdaTemp = c.friction2Impulse[lane];
+        c.friction2Impulse[lane] = std::max(-frictionLimit, std::min(c.friction2Impulse[lane] + deltaLambda, frictionLimit));
+        deltaLambda = c.friction2Impulse[lane] - lambdaTemp;
+        impulseDelta = std::max(impulseDelta, std::abs(deltaLambda));
+
+        // Compute the impulse P=J^T * lambda
+        decimal angularImpulseBody1[3], angularImpulseBody2[3];
+        for (uint i=0; i < 3; i++) {
+            angularImpulseBody1[i] = -c.r1CrossT2[i][lane] * deltaLambda;
+            angularImpulseBody2[i] = c.r2CrossT2[i][lane] * deltaLambda;
+            const decimal linearImpulseBody2 = c.frictionVector2[i][lane] * deltaLambda;
+            v1[i][lane] -= c.massInverseBody1[lane] * linearImpulseBody2;
+            v2[i][lane] += c.massInverseBody2[lane] * linearImpulseBody2;
+        }
+
+        // Update the angular velocities of the bodies by applying the impulse P
+        for (uint i=0; i < 3; i++) {
+            w1[i][lane] += c.inverseInertiaTensorBody1[3 * i][lane] * angularImpulseBody1[0] +
+                           c.inverseInertiaTensorBody1[3 * i + 1][lane] * angularImpulseBody1[1] +
+                           c.inverseInertiaTensorBody1[3 * i + 2][lane] * angularImpulseBody1[2];
+            w2[i][lane] += c.inverseInertiaTensorBody2[3 * i][lane] * angularImpulseBody2[0] +
+                           c.inverseInertiaTensorBody2[3 * i + 1][lane] * angularImpulseBody2[1] +
+                           c.inverseInertiaTensorBody2[3 * i + 2][lane] * angularImpulseBody2[2];
+        }
+    }
 
-        // ------ Twist friction constraint at the center of the contact manifol ------ //
+    // ------ Twist friction constraint at the center of the contact manifold ------ //
+
+    for (uint lane=0; lane < N; lane++) {
 
         // Compute J*v
-        deltaV = w2 - w1;
-        Jv = deltaV.x * mContactConstraints[c].normal.x + deltaV.y * mContactConstraints[c].normal.y +
-             deltaV.z * mContactConstraints[c].normal.z;
-
-        deltaLambda = -Jv * (mContactConstraints[c].inverseTwistFrictionMass);
-        frictionLimit = mContactConstraints[c].frictionCoefficient * sumPenetrationImpulse;
-        lambdaTemp = mContactConstraints[c].frictionTwistImpulse;
-        mContactConstraints[c].frictionTwistImpulse = std::max(-frictionLimit,
-                                                        std::min(mContactConstraints[c].frictionTwistImpulse
-                                                                 + deltaLambda, frictionLimit));
-        deltaLambda = mContactConstraints[c].frictionTwistImpulse - lambdaTemp;
+        const decimal Jv = (w2[0][lane] - w1[0][lane]) * c.normal[0][lane] + (w2[1][lane] - w1[1][lane]) * c.normal[1][lane] +
+                           (w2[2][lane] - w1[2][lane]) * c.normal[2][lane];
+
+        decimal deltaLambda = -Jv * c.inverseTwistFrictionMass[lane];
+        const decimal frictionLimit = c.frictionCoefficient[lane] * sumPenetrationImpulse[lane];
+        const decimal lambdaTemp = c.frictionTwistImpulse[lane];
+        c.frictionTwistImpulse[lane] = std::max(-frictionLimit, std::min(c.frictionTwistImpulse[lane] + deltaLambda, frictionLimit));
+        deltaLambda = c.frictionTwistImpulse[lane] - lambdaTemp;
+        impulseDelta = std::max(impulseDelta, std::abs(deltaLambda));
 
         // Compute the impulse P=J^T * lambda
-        angularImpulseBody2.x = mContactConstraints[c].normal.x * deltaLambda;
-        angularImpulseBody2.y = mContactConstraints[c].normal.y * deltaLambda;
-        angularImpulseBody2.z = mContactConstraints[c].normal.z * deltaLambda;
+        decimal angularImpulseBody2[3];
+        for (uint i=0; i < 3; i++) {
+            angularImpulseBody2[i] = c.normal[i][lane] * deltaLambda;
+        }
 
-        // Update the velocities of the body 1 by applying the impulse P
-        mAngularVelocities[mContactConstraints[c].indexBody1] -= mContactConstraints[c].inverseInertiaTensorBody1 * angularImpulseBody2;
+        // Update the angular velocities of the bodies by applying the impulse P
+        for (uint i=0; i < 3; i++) {
+            w1[i][lane] -= c.inverseInertiaTensorBody1[3 * i][lane] * angularImpulseBody2[0] +
+                           c.inverseInertiaTensorBody1[3 * i + 1][lane] * angularImpulseBody2[1] +
+                           c.inverseInertiaTensorBody1[3 * i + 2][lane] * angularImpulseBody2[2];
+            w2[i][lane] += c.inverseInertiaTensorBody2[3 * i][lane] * angularImpulseBody2[0] +
+                           c.inverseInertiaTensorBody2[3 * i + 1][lane] * angularImpulseBody2[1] +
+                           c.inverseInertiaTensorBody2[3 * i + 2][lane] * angularImpulseBody2[2];
+        }
+    }
 
-        // Update the velocities of the body 1 by applying the impulse P
-        mAngularVelocities[mContactConstraints[c].indexBody2] += mContactConstraints[c].inverseInertiaTensorBody2 * angularImpulseBody2;
+    // --------- Rolling resistance constraint at the center of the contact manifold --------- //
 
-        // --------- Rolling resistance constraint at the center of the contact manifold --------- //
+    for (uint lane=0; lane < N; lane++) {
 
-        if (mContactConstraints[c].rollingResistanceFactor > 0) {
+        if (c.rollingResistanceFactor[lane] > 0) {
 
             // Compute J*v
-            const Vector3 JvRolling = w2 - w1;
+            const Vector3 JvRolling(w2[0][lane] - w1[0][lane], w2[1][lane] - w1[1][lane], w2[2][lane] - w1[2][lane]);
 
             // Compute the Lagrange multiplier lambda
-            Vector3 deltaLambdaRolling = mContactConstraints[c].inverseRollingResistance * (-JvRolling);
-            decimal rollingLimit = mContactConstraints[c].rollingResistanceFactor * sumPenetrationImpulse;
-            Vector3 lambdaTempRolling = mContactConstraints[c].rollingResistanceImpulse;
-            mContactConstraints[c].rollingResistanceImpulse = clamp(mContactConstraints[c].rollingResistanceImpulse +
-                                                                 deltaLambdaRolling, rollingLimit);
-            deltaLambdaRolling = mContactConstraints[c].rollingResistanceImpulse - lambdaTempRolling;
+            const Matrix3x3 inverseRollingResistance(c.inverseRollingResistance[0][lane], c.inverseRollingResistance[1][lane],
+                                                     c.inverseRollingResistance[2][lane], c.inverseRollingResistance[3][lane],
+                                                     c.inverseRollingResistance[4][lane], c.inverseRollingResistance[5][lane],
+                                                     c.inverseRollingResistance[6][lane], c.inverseRollingResistance[7][lane],
+                                                     c.inverseRollingResistance[8][lane]);
+            Vector3 deltaLambdaRolling = inverseRollingResistance * (-JvRolling);
+            const decimal rollingLimit = c.rollingResistanceFactor[lane] * sumPenetrationImpulse[lane];
+            const Vector3 lambdaTempRolling(c.rollingResistanceImpulse[0][lane], c.rollingResistanceImpulse[1][lane],
+                                            c.rollingResistanceImpulse[2][lane]);
+            const Vector3 rollingResistanceImpulse = clamp(lambdaTempRolling + deltaLambdaRolling, rollingLimit);
+            deltaLambdaRolling = rollingResistanceImpulse - lambdaTempRolling;
+
+            // Update the angular velocities of the bodies by applying the impulse P
+            for (uint i=0; i < 3; i++) {
+                c.rollingResistanceImpulse[i][lane] = rollingResistanceImpulse[i];
+                w1[i][lane] -= c.inverseInertiaTensorBody1[3 * i][lane] * deltaLambdaRolling.x +
+                               c.inverseInertiaTensorBody1[3 * i + 1][lane] * deltaLambdaRolling.y +
+                               c.inverseInertiaTensorBody1[3 * i + 2][lane] * deltaLambdaRolling.z;
+                w2[i][lane] += c.inverseInertiaTensorBody2[3 * i][lane] * deltaLambdaRolling.x +
+                               c.inverseInertiaTensorBody2[3 * i + 1][lane] * deltaLambdaRolling.y +
+                               c.inverseInertiaTensorBody2[3 * i + 2][lane] * deltaLambdaRolling.z;
+            }
+        }
+    }
 
-            // Update the velocities of the body 1 by applying the impulse P
-            mAngularVelocities[mContactConstraints[c].indexBody1] -= mContactConstraints[c].inverseInertiaTensorBody1 * deltaLambdaRolling;
+    // Write back the velocities of the dynamic bodies of the used lanes
+    for (uint lane=0; lane < group.nbLanes; lane++) {
 
-            // Update the velocities of the body 2 by applying the impulse P
-            mAngularVelocities[mContactConstraints[c].indexBody2] += mContactConstraints[c].inverseInertiaTensorBody2 * deltaLambdaRolling;
+        const ContactManifoldSolver& manifold = mContactConstraints[group.manifoldIndices[lane]];
+
+        if (manifold.isBody1Dynamic) {
+            mLinearVelocities[group.indexBody1[lane]].setAllValues(v1[0][lane], v1[1][lane], v1[2][lane]);
+            mAngularVelocities[group.indexBody1[lane]].setAllValues(w1[0][lane], w1[1][lane], w1[2][lane]);
+            if (mIsSplitImpulseActive) {
+                mSplitLinearVelocities[group.indexBody1[lane]].setAllValues(v1Split[0][lane], v1Split[1][lane], v1Split[2][lane]);
+                mSplitAngularVelocities[group.indexBody1[lane]].setAllValues(w1Split[0][lane], w1Split[1][lane], w1Split[2][lane]);
+            }
+        }
+        if (manifold.isBody2Dynamic) {
+            mLinearVelocities[group.indexBody2[lane]].setAllValues(v2[0][lane], v2[1][lane], v2[2][lane]);
+            mAngularVelocities[group.indexBody2[lane]].setAllValues(w2[0][lane], w2[1][lane], w2[2][lane]);
+            if (mIsSplitImpulseActive) {
+                mSplitLinearVelocities[group.indexBody2[lane]].setAllValues(v2Split[0][lane], v2Split[1][lane], v2Split[2][lane]);
+                mSplitAngularVelocities[group.indexBody2[lane]].setAllValues(w2Split[0][lane], w2Split[1][lane], w2Split[2][lane]);
+            }
         }
     }
+
+    return impulseDelta;
 }
 
-// Compute the collision restitution factor from the restitution factor of each body
-decimal ContactSolver::computeMixedRestitutionFactor(RigidBody* body1,
-                                                            RigidBody* body2) const {
-    decimal restitution1 = body1->getMaterial().getBounciness();
-    decimal restitution2 = body2->getMaterial().getBounciness();
+// Allocate the constraints of the wheels of the vehicles of the islands
+/// The island of the chassis of each vehicle (Vehicle::mIslandIndex) must have been set
+/// for the islands of the current step. The constraints of the wheels that touch the
+/// ground are sorted by island with a counting sort. This method must be called after
+/// init() because it allocates the constraints in the arena of the step.
+/**
+ * @param vehicles The vehicles of the world
+ */
+void ContactSolver::initWheels(const List<Vehicle*>& vehicles) {
+
+    RP3D_PROFILE("ContactSolver::initWheels()", mProfiler);
+
+    mIslandsFirstWheelIndex = static_cast<uint*>(mArena.allocate(sizeof(uint) * (mNbIslands + 1)));
+    assert(mIslandsFirstWheelIndex != nullptr);
+    for (uint i=0; i <= mNbIslands; i++) {
+        mIslandsFirstWheelIndex[i] = 0;
+    }
+
+    // Count the wheels in contact of each island
+    for (uint v=0; v < vehicles.size(); v++) {
+
+        const Vehicle* vehicle = vehicles[v];
+        if (vehicle->mIslandIndex == Vehicle::NO_ISLAND) continue;
+        assert(vehicle->mIslandIndex < mNbIslands);
+
+        for (uint w=0; w < vehicle->mWheels.size(); w++) {
+            if (vehicle->mWheels[w].isInContact) mIslandsFirstWheelIndex[vehicle->mIslandIndex + 1]++;
+        }
+    }
+
+    for (uint i=0; i < mNbIslands; i++) {
+        mIslandsFirstWheelIndex[i + 1] += mIslandsFirstWheelIndex[i];
+    }
+
+    const uint nbWheels = mIslandsFirstWheelIndex[mNbIslands];
+    mWheelConstraints = nullptr;
+    if (nbWheels == 0) return;
+
+    mWheelConstraints = static_cast<WheelConstraintSolver*>(mArena.allocate(sizeof(WheelConstraintSolver) * nbWheels));
+    assert(mWheelConstraints != nullptr);
+
+    // Place the wheels at the index of their island (the first indices are shifted during the
+    // placement and restored afterwards)
+    for (uint v=0; v < vehicles.size(); v++) {
 
-    // Return the largest restitution factor
-    return (restitution1 > restitution2) ? restitution1 : restitution2;
+        Vehicle* vehicle = vehicles[v];
+        if (vehicle->mIslandIndex == Vehicle::NO_ISLAND) continue;
+
+        for (uint w=0; w < vehicle->mWheels.size(); w++) {
+            if (!vehicle->mWheels[w].isInContact) continue;
+
+            WheelConstraintSolver& constraint = mWheelConstraints[mIslandsFirstWheelIndex[vehicle->mIslandIndex]];
+            constraint.vehicle = vehicle;
+            constraint.wheelIndex = w;
+            mIslandsFirstWheelIndex[vehicle->mIslandIndex]++;
+        }
+    }
+
+    for (uint i=mNbIslands; i > 0; i--) {
+        mIslandsFirstWheelIndex[i] = mIslandsFirstWheelIndex[i - 1];
+    }
+    mIslandsFirstWheelIndex[0] = 0;
+}
+
+// Initialize the wheel constraints of a given island
+/// The ground under a wheel is the plane of the hit of its ray. The length of the
+/// suspension is recomputed from the current transform of the chassis by intersecting
+/// the ray of the wheel with this plane (like the reprojected contacts of the substeps).
+/**
+ * @param islandIndex Index of the island
+ */
+void ContactSolver::initializeWheelsForIsland(uint islandIndex) {
+
+    RP3D_PROFILE("ContactSolver::initializeWheelsForIsland()", mProfiler);
+
+    assert(islandIndex < mNbIslands);
+
+    for (uint c=mIslandsFirstWheelIndex[islandIndex]; c < mIslandsFirstWheelIndex[islandIndex + 1]; c++) {
+
+        WheelConstraintSolver& constraint = mWheelConstraints[c];
+        const Vehicle* vehicle = constraint.vehicle;
+        const Vehicle::Wheel& wheel = vehicle->mWheels[constraint.wheelIndex];
+        const WheelSettings& settings = wheel.settings;
+        const RigidBody* chassis = vehicle->mChassis;
+
+        constraint.indexBody = chassis->mArrayIndex;
+        constraint.massInverse = chassis->mMassInverse;
+        const Matrix3x3 inverseInertiaTensor = chassis->getInertiaTensorInverseWorld();
+
+        // Intersect the ray of the wheel with the plane of the ground
+        const Ray ray = vehicle->computeWheelRay(constraint.wheelIndex);
+        const decimal rayLength = settings.suspensionRestLength + settings.radius;
+        const Vector3 down = (ray.point2 - ray.point1) / rayLength;
+        const Vector3& normal = wheel.contactNormal;
+        const decimal normalDotDown = normal.dot(down);
+        const decimal distance = normalDotDown < -MACHINE_EPSILON ?
+                                 normal.dot(wheel.contactPoint - ray.point1) / normalDotDown : rayLength;
+        const Vector3 contactPoint = ray.point1 + down * distance;
+        const Vector3 r = contactPoint - chassis->getCenterOfMassWorld();
+
+        // Directions of the tire in the plane of the ground
+        Vector3 forward = vehicle->computeWheelForwardAxis(constraint.wheelIndex);
+        forward -= forward.dot(normal) * normal;
+        if (forward.lengthSquare() < MACHINE_EPSILON) forward = normal.getOneUnitOrthogonalVector();
+        forward.normalize();
+        constraint.normal = normal;
+        constraint.forward = forward;
+        constraint.side = normal.cross(forward);
+
+        constraint.rCrossNormal = r.cross(constraint.normal);
+        constraint.rCrossForward = r.cross(constraint.forward);
+        constraint.rCrossSide = r.cross(constraint.side);
+        constraint.iTimesRCrossNormal = inverseInertiaTensor * constraint.rCrossNormal;
+        constraint.iTimesRCrossForward = inverseInertiaTensor * constraint.rCrossForward;
+        constraint.iTimesRCrossSide = inverseInertiaTensor * constraint.rCrossSide;
+
+        const decimal normalMass = constraint.massInverse + constraint.rCrossNormal.dot(constraint.iTimesRCrossNormal);
+        const decimal forwardMass = constraint.massInverse + constraint.rCrossForward.dot(constraint.iTimesRCrossForward);
+        const decimal sideMass = constraint.massInverse + constraint.rCrossSide.dot(constraint.iTimesRCrossSide);
+        constraint.inverseNormalMass = normalMass > decimal(0.0) ? decimal(1.0) / normalMass : decimal(0.0);
+        constraint.inverseForwardMass = forwardMass > decimal(0.0) ? decimal(1.0) / forwardMass : decimal(0.0);
+        constraint.inverseSideMass = sideMass > decimal(0.0) ? decimal(1.0) / sideMass : decimal(0.0);
+
+        // Velocity of the ground at the contact point (the velocities of the bodies of the
+        // other islands are read here because the islands are initialized sequentially)
+        constraint.groundVelocity.setToZero();
+        const RigidBody* ground = static_cast<const RigidBody*>(wheel.groundBody);
+        if (ground->getType() != BodyType::STATIC) {
+            constraint.groundVelocity = ground->getLinearVelocity() +
+                                        ground->getAngularVelocity().cross(contactPoint - ground->getCenterOfMassWorld());
+        }
+
+        constraint.suspensionError = distance - settings.radius - settings.suspensionRestLength;
+        constraint.suspensionSoftness = SoftConstraintCoefficients::compute(settings.suspensionFrequency,
+                                                                            settings.suspensionDampingRatio, mTimeStep);
+        constraint.maxSuspensionImpulse = settings.maxSuspensionForce * mTimeStep;
+        constraint.frictionCoefficient = settings.frictionCoefficient;
+        constraint.driveImpulse = wheel.engineForce * mTimeStep;
+        constraint.brakeImpulse = wheel.brakeForce * mTimeStep;
+
+        constraint.suspensionImpulse = wheel.suspensionImpulse;
+        constraint.forwardImpulse = wheel.forwardImpulse;
+        constraint.sideImpulse = wheel.sideImpulse;
+    }
+}
+
+// Warm start the wheel constraints of a given island
+/**
+ * @param islandIndex Index of the island
+ */
+void ContactSolver::warmStartWheels(uint islandIndex) {
+
+    assert(islandIndex < mNbIslands);
+
+    for (uint c=mIslandsFirstWheelIndex[islandIndex]; c < mIslandsFirstWheelIndex[islandIndex + 1]; c++) {
+
+        const WheelConstraintSolver& constraint = mWheelConstraints[c];
+
+        const Vector3 impulse = constraint.normal * constraint.suspensionImpulse +
+                                constraint.forward * constraint.forwardImpulse +
+                                constraint.side * constraint.sideImpulse;
+        mLinearVelocities[constraint.indexBody] += constraint.massInverse * impulse;
+        mAngularVelocities[constraint.indexBody] += constraint.iTimesRCrossNormal * constraint.suspensionImpulse +
+                                                    constraint.iTimesRCrossForward * constraint.forwardImpulse +
+                                                    constraint.iTimesRCrossSide * constraint.sideImpulse;
+    }
 }
 
-// Compute the mixed friction coefficient from the friction coefficient of each body
-decimal ContactSolver::computeMixedFrictionCoefficient(RigidBody *body1,
-                                                              RigidBody *body2) const {
-    // Use the geometric mean to compute the mixed friction coefficient
-    return std::sqrt(body1->getMaterial().getFrictionCoefficient() *
-                body2->getMaterial().getFrictionCoefficient());
+// Solve the wheel constraints of a given island
+/// The suspension pushes the chassis away from the ground as a spring. The friction
+/// impulses of the tire are bounded by the friction coefficient times the impulse of the
+/// suspension. The longitudinal impulse is also bounded around the impulse of the engine
+/// by the impulse of the brake (a free wheel without brake does not apply any longitudinal
+/// impulse).
+/**
+ * @param islandIndex Index of the island
+ * @return The largest absolute change of the wheel impulses during this iteration
+ */
+decimal ContactSolver::solveWheels(uint islandIndex) {
+
+    assert(islandIndex < mNbIslands);
+
+    decimal impulseDelta = decimal(0.0);
+
+    for (uint c=mIslandsFirstWheelIndex[islandIndex]; c < mIslandsFirstWheelIndex[islandIndex + 1]; c++) {
+
+        WheelConstraintSolver& constraint = mWheelConstraints[c];
+        Vector3& v = mLinearVelocities[constraint.indexBody];
+        Vector3& w = mAngularVelocities[constraint.indexBody];
+
+        // --------- Suspension --------- //
+
+        decimal relativeVelocity = v.dot(constraint.normal) + w.dot(constraint.rCrossNormal) -
+                                   constraint.groundVelocity.dot(constraint.normal);
+        const SoftConstraintCoefficients& softness = constraint.suspensionSoftness;
+        decimal deltaLambda = -softness.massScale * constraint.inverseNormalMass *
+                              (relativeVelocity + softness.biasRate * constraint.suspensionError) -
+                              softness.impulseScale * constraint.suspensionImpulse;
+        decimal lambdaTemp = constraint.suspensionImpulse;
+        constraint.suspensionImpulse = clamp(lambdaTemp + deltaLambda, decimal(0.0), constraint.maxSuspensionImpulse);
+        deltaLambda = constraint.suspensionImpulse - lambdaTemp;
+        impulseDelta = std::max(impulseDelta, std::abs(deltaLambda));
+
+        v += constraint.massInverse * deltaLambda * constraint.normal;
+        w += deltaLambda * constraint.iTimesRCrossNormal;
+
+        const decimal frictionLimit = constraint.frictionCoefficient * constraint.suspensionImpulse;
+
+        // --------- Longitudinal friction --------- //
+
+        relativeVelocity = v.dot(constraint.forward) + w.dot(constraint.rCrossForward) -
+                           constraint.groundVelocity.dot(constraint.forward);
+        deltaLambda = -constraint.inverseForwardMass * relativeVelocity;
+        const decimal minForwardImpulse = clamp(constraint.driveImpulse - constraint.brakeImpulse,
+                                                -frictionLimit, frictionLimit);
+        const decimal maxForwardImpulse = clamp(constraint.driveImpulse + constraint.brakeImpulse,
+                                                -frictionLimit, frictionLimit);
+        lambdaTemp = constraint.forwardImpulse;
+        constraint.forwardImpulse = clamp(lambdaTemp + deltaLambda, minForwardImpulse, maxForwardImpulse);
+        deltaLambda = constraint.forwardImpulse - lambdaTemp;
+        impulseDelta = std::max(impulseDelta, std::abs(deltaLambda));
+
+        v += constraint.massInverse * deltaLambda * constraint.forward;
+        w += deltaLambda * constraint.iTimesRCrossForward;
+
+        // --------- Lateral friction --------- //
+
+        relativeVelocity = v.dot(constraint.side) + w.dot(constraint.rCrossSide) -
+                           constraint.groundVelocity.dot(constraint.side);
+        deltaLambda = -constraint.inverseSideMass * relativeVelocity;
+        lambdaTemp = constraint.sideImpulse;
+        constraint.sideImpulse = clamp(lambdaTemp + deltaLambda, -frictionLimit, frictionLimit);
+        deltaLambda = constraint.sideImpulse - lambdaTemp;
+        impulseDelta = std::max(impulseDelta, std::abs(deltaLambda));
+
+        v += constraint.massInverse * deltaLambda * constraint.side;
+        w += deltaLambda * constraint.iTimesRCrossSide;
+    }
+
+    return impulseDelta;
 }
 
-// Compute th mixed rolling resistance factor between two bodies
-inline decimal ContactSolver::computeMixedRollingResistance(RigidBody* body1,
-                                                            RigidBody* body2) const {
-    return decimal(0.5f) * (body1->getMaterial().getRollingResistance() + body2->getMaterial().getRollingResistance());
+// Store the impulses of the wheel constraints of an island in the wheels
+/// The impulses are used to warm start the solver at the next step and the force of
+/// the suspension is reported to the vehicle.
+/**
+ * @param islandIndex Index of the island
+ */
+void ContactSolver::storeWheelsImpulses(uint islandIndex) {
+
+    assert(islandIndex < mNbIslands);
+
+    for (uint c=mIslandsFirstWheelIndex[islandIndex]; c < mIslandsFirstWheelIndex[islandIndex + 1]; c++) {
+
+        const WheelConstraintSolver& constraint = mWheelConstraints[c];
+        Vehicle::Wheel& wheel = constraint.vehicle->mWheels[constraint.wheelIndex];
+
+        wheel.suspensionImpulse = constraint.suspensionImpulse;
+        wheel.forwardImpulse = constraint.forwardImpulse;
+        wheel.sideImpulse = constraint.sideImpulse;
+        wheel.suspensionForce = constraint.suspensionImpulse / mTimeStep;
+        wheel.suspensionLength = constraint.suspensionError + wheel.settings.suspensionRestLength;
+    }
 }
 
 // Store the computed impulses to use them to
 // warm start the solver at the next iteration
-void ContactSolver::storeImpulses() {
+/**
+ * @param islandIndex Index of the island
+ */
+void ContactSolver::storeImpulses(uint islandIndex) {
 
-    RP3D_PROFILE("ContactSolver::storeImpulses()", mProfiler);
+    assert(islandIndex < mNbIslands);
 
-    uint contactPointIndex = 0;
+    // Get the impulses computed by the wide contact solver
+    if (mIslandsContactGroups != nullptr) unpackContactGroups(islandIndex);
+
+    uint contactPointIndex = mIslandsFirstContactPointIndex[islandIndex];
 
     // For each contact manifold
-    for (uint c=0; c<mNbContactManifolds; c++) {
+    for (uint c=mIslandsFirstContactManifoldIndex[islandIndex];
+         c < mIslandsFirstContactManifoldIndex[islandIndex + 1]; c++) {
 
         for (short int i=0; i<mContactConstraints[c].nbContacts; i++) {
 
-            mContactPoints[contactPointIndex].externalContact->setPenetrationImpulse(mContactPoints[contactPointIndex].penetrationImpulse);
+            mContactPointsColdData[contactPointIndex].externalContact->setPenetrationImpulse(mContactPoints[contactPointIndex].penetrationImpulse);
 
             contactPointIndex++;
         }
 
-        mContactConstraints[c].externalContactManifold->setFrictionImpulse1(mContactConstraints[c].friction1Impulse);
-        mContactConstraints[c].externalContactManifold->setFrictionImpulse2(mContactConstraints[c].friction2Impulse);
-        mContactConstraints[c].externalContactManifold->setFrictionTwistImpulse(mContactConstraints[c].frictionTwistImpulse);
-        mContactConstraints[c].externalContactManifold->setRollingResistanceImpulse(mContactConstraints[c].rollingResistanceImpulse);
-        mContactConstraints[c].externalContactManifold->setFrictionVector1(mContactConstraints[c].frictionVector1);
-        mContactConstraints[c].externalContactManifold->setFrictionVector2(mContactConstraints[c].frictionVector2);
+        mContactConstraintsColdData[c].externalContactManifold->setFrictionImpulse1(mContactConstraints[c].friction1Impulse);
+        mContactConstraintsColdData[c].externalContactManifold->setFrictionImpulse2(mContactConstraints[c].friction2Impulse);
+        mContactConstraintsColdData[c].externalContactManifold->setFrictionTwistImpulse(mContactConstraints[c].frictionTwistImpulse);
+        mContactConstraintsColdData[c].externalContactManifold->setRollingResistanceImpulse(mContactConstraints[c].rollingResistanceImpulse);
+        mContactConstraintsColdData[c].externalContactManifold->setFrictionVector1(mContactConstraints[c].frictionVector1);
+        mContactConstraintsColdData[c].externalContactManifold->setFrictionVector2(mContactConstraints[c].frictionVector2);
+    }
+}
+
+// Add the impulses of the contact manifolds with a total normal impulse larger than a threshold to a list of contact impulses
+/// This method must be called once the impulses of all the islands have been stored. It is not
+/// done in storeImpulses() because the islands might be solved in parallel.
+/**
+ * @param contactImpulses The list where the contact impulses are added
+ * @param threshold Smallest total normal impulse of a reported contact manifold
+ */
+void ContactSolver::reportContactImpulses(List<ContactImpulse>& contactImpulses, decimal threshold) const {
+
+    RP3D_PROFILE("ContactSolver::reportContactImpulses()", mProfiler);
+
+    for (uint islandIndex=0; islandIndex < mNbIslands; islandIndex++) {
+
+        uint contactPointIndex = mIslandsFirstContactPointIndex[islandIndex];
+
+        // For each contact manifold of the island
+        for (uint c=mIslandsFirstContactManifoldIndex[islandIndex];
+             c < mIslandsFirstContactManifoldIndex[islandIndex + 1]; c++) {
+
+            decimal totalImpulse = decimal(0.0);
+            decimal maxImpulse = decimal(0.0);
+            for (short int i=0; i<mContactConstraints[c].nbContacts; i++) {
+                const decimal impulse = mContactPoints[contactPointIndex].penetrationImpulse;
+                totalImpulse += impulse;
+                maxImpulse = std::max(maxImpulse, impulse);
+                contactPointIndex++;
+            }
+
+            if (totalImpulse > threshold) {
+
+                const ContactManifold* manifold = mContactConstraintsColdData[c].externalContactManifold;
+
+                ContactImpulse contactImpulse;
+                contactImpulse.body1 = manifold->getBody1();
+                contactImpulse.body2 = manifold->getBody2();
+                contactImpulse.proxyShape1 = manifold->getShape1();
+                contactImpulse.proxyShape2 = manifold->getShape2();
+                contactImpulse.totalNormalImpulse = totalImpulse;
+                contactImpulse.maxNormalImpulse = maxImpulse;
+                contactImpulses.add(contactImpulse);
+            }
+        }
     }
 }
 
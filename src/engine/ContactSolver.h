@@ -30,6 +30,12 @@
 #include "configuration.h"
 #include "mathematics/Vector3.h"
 #include "mathematics/Matrix3x3.h"
+#include "collision/ContactManifoldInfo.h"
+#include "collision/ContactEvent.h"
+#include "memory/ArenaAllocator.h"
+#include "containers/List.h"
+#include "constraint/SoftConstraint.h"
+#include "engine/MaterialTable.h"
 
 /// ReactPhysics3D namespace
 namespace reactphysics3d {
@@ -42,6 +48,7 @@ class MemoryManager;
 class Profiler;
 class Island;
 class RigidBody;
+class Vehicle;
 
 // Class Contact Solver
 /**
@@ -111,21 +118,47 @@ class RigidBody;
  * constraints at the center of the contact manifold, we need two constraints for tangential
  * friction but also another twist friction constraint to prevent spin of the body around the
  * contact manifold center.
+ *
+ * If the wide contact solver is enabled in the world settings, the contact manifolds of
+ * an island are grouped by NB_CONTACT_LANES manifolds that do not share any dynamic body.
+ * The constraints of a group are stored in a structure of arrays (one lane per manifold)
+ * and the whole group is solved at once with loops over the lanes that the compiler can
+ * turn into SIMD instructions. Because the manifolds of a group are independent, solving
+ * a group gives exactly the same result as solving its manifolds one after the other.
+ *
+ * If the block contact solver is enabled in the world settings, the normal impulses of
+ * the contact points of a manifold with two to four points are solved simultaneously
+ * instead of one point after the other. The mixed linear complementarity problem is
+ * solved by enumerating the sets of active contact points (total enumeration). A resting
+ * box then gets its normal impulses in a single iteration whereas the sequential solver
+ * needs many iterations to balance them between the points. The wide contact solver is
+ * not used when the block solver is enabled.
+ *
+ * The wheels of the vehicles that touch the ground are also solved with the contacts of
+ * the island of their chassis. The suspension of a wheel is a soft constraint along the
+ * normal of the ground and the tire has a longitudinal and a lateral friction constraint
+ * at the contact point. The engine and the brake of a wheel only change the bounds of its
+ * longitudinal friction impulse. The ground is seen as a body with an infinite mass.
  */
 class ContactSolver {
 
+    public:
+
+        // -------------------- Constants --------------------- //
+
+        /// Number of contact manifolds solved together by the wide contact solver
+        static const uint NB_CONTACT_LANES = 4;
+
     private:
 
         // Structure ContactPointSolver
         /**
          * Contact solver internal data structure that to store all the
-         * information relative to a contact point
+         * information relative to a contact point that is used at each
+         * iteration of the solver
          */
         struct ContactPointSolver {
 
-            /// Pointer to the external contact
-            ContactPoint* externalContact;
-
             /// Normal vector of the contact
             Vector3 normal;
 
@@ -135,10 +168,10 @@ class ContactSolver {
             /// Vector from the body 2 center to the contact point
             Vector3 r2;
 
-            /// Penetration depth
-            decimal penetrationDepth;
+            /// Penetration depth bias
+            decimal biasPenetrationDepth;
 
-            /// Velocity restitution bias
+            /// Velocity restitution bias (or allowed approaching velocity of a speculative contact)
             decimal restitutionBias;
 
             /// Accumulated normal impulse
@@ -155,6 +188,17 @@ class ContactSolver {
 
             /// Cross product of r2 with the contact normal
             Vector3 i2TimesR2CrossN;
+        };
+
+        // Structure ContactPointSolverColdData
+        /**
+         * Data of a contact point that is only used to initialize the solver and to
+         * store the impulses at the end. It is not used by the solver iterations.
+         */
+        struct ContactPointSolverColdData {
+
+            /// Pointer to the external contact
+            ContactPoint* externalContact;
 
             /// True if the contact was existing last time step
             bool isRestingContact;
@@ -163,19 +207,30 @@ class ContactSolver {
         // Structure ContactManifoldSolver
         /**
          * Contact solver internal data structure to store all the
-         * information relative to a contact manifold.
+         * information relative to a contact manifold that is used at each
+         * iteration of the solver. The data used at the beginning of the
+         * iterations (bodies and number of contact points) comes first.
          */
         struct ContactManifoldSolver {
 
-            /// Pointer to the external contact manifold
-            ContactManifold* externalContactManifold;
-
             /// Index of body 1 in the constraint solver
             int32 indexBody1;
 
             /// Index of body 2 in the constraint solver
             int32 indexBody2;
 
+            /// Number of contact points
+            int8 nbContacts;
+
+            /// True if the body 1 is a dynamic body
+            bool isBody1Dynamic;
+
+            /// True if the body 2 is a dynamic body
+            bool isBody2Dynamic;
+
+            /// Index of the first contact point of the manifold in the contact points array
+            uint contactPointIndex;
+
             /// Inverse of the mass of body 1
             decimal massInverseBody1;
 
@@ -199,12 +254,6 @@ class ContactSolver {
             /// Average normal vector of the contact manifold
             Vector3 normal;
 
-            /// Point on body 1 where to apply the friction constraints
-            Vector3 frictionPointBody1;
-
-            /// Point on body 2 where to apply the friction constraints
-            Vector3 frictionPointBody2;
-
             /// R1 vector for the friction constraints
             Vector3 r1Friction;
 
@@ -241,12 +290,6 @@ class ContactSolver {
             /// Second friction direction at contact manifold center
             Vector3 frictionVector2;
 
-            /// Old 1st friction direction at contact manifold center
-            Vector3 oldFrictionVector1;
-
-            /// Old 2nd friction direction at contact manifold center
-            Vector3 oldFrictionVector2;
-
             /// First friction direction impulse at manifold center
             decimal friction1Impulse;
 
@@ -258,13 +301,295 @@ class ContactSolver {
 
             /// Rolling resistance impulse
             Vector3 rollingResistanceImpulse;
+        };
 
-            /// Number of contact points
-            int8 nbContacts;
+        // Structure ContactManifoldSolverColdData
+        /**
+         * Data of a contact manifold that is only used to warm start the solver and
+         * to store the impulses at the end. It is not used by the solver iterations.
+         */
+        struct ContactManifoldSolverColdData {
+
+            /// Pointer to the external contact manifold
+            ContactManifold* externalContactManifold;
+
+            /// Old 1st friction direction at contact manifold center
+            Vector3 oldFrictionVector1;
+
+            /// Old 2nd friction direction at contact manifold center
+            Vector3 oldFrictionVector2;
+        };
+
+        // Structure ContactManifoldBlockSolver
+        /**
+         * Data of a contact manifold used by the block contact solver to solve
+         * the normal impulses of all the contact points of the manifold at once.
+         */
+        struct ContactManifoldBlockSolver {
+
+            /// Matrix K of the normal constraints of the contact points (regularized)
+            decimal normalMass[MAX_CONTACT_POINTS_IN_MANIFOLD][MAX_CONTACT_POINTS_IN_MANIFOLD];
+
+            /// Set of active contact points (one bit per point) of the last solution of the normal impulses
+            uint8 normalActiveSet;
+
+            /// Set of active contact points (one bit per point) of the last solution of the split impulses
+            uint8 splitActiveSet;
+        };
+
+        // Structure ContactPointLanes
+        /**
+         * Contact points of a group of contact manifolds (one point per lane) used by
+         * the wide contact solver. The unused lanes are filled with zeros.
+         */
+        struct ContactPointLanes {
+
+            /// Normal vector of the contacts
+            decimal normal[3][NB_CONTACT_LANES];
+
+            /// Vectors from the body 1 center to the contact points
+            decimal r1[3][NB_CONTACT_LANES];
+
+            /// Vectors from the body 2 center to the contact points
+            decimal r2[3][NB_CONTACT_LANES];
+
+            /// Bias of the penetration depth correction
+            decimal biasPenetrationDepth[NB_CONTACT_LANES];
+
+            /// Velocity restitution bias
+            decimal restitutionBias[NB_CONTACT_LANES];
+
+            /// Accumulated normal impulses
+            decimal penetrationImpulse[NB_CONTACT_LANES];
+
+            /// Accumulated split impulses for penetration correction
+            decimal penetrationSplitImpulse[NB_CONTACT_LANES];
+
+            /// Inverse of the matrix K for the penenetration
+            decimal inversePenetrationMass[NB_CONTACT_LANES];
+
+            /// Inverse inertia tensor of body 1 times the cross product of r1 with the contact normal
+            decimal i1TimesR1CrossN[3][NB_CONTACT_LANES];
+
+            /// Inverse inertia tensor of body 2 times the cross product of r2 with the contact normal
+            decimal i2TimesR2CrossN[3][NB_CONTACT_LANES];
+        };
+
+        // Structure ContactManifoldLanes
+        /**
+         * Constraints of a group of contact manifolds stored in a structure of
+         * arrays (one manifold per lane) used by the wide contact solver.
+         */
+        struct ContactManifoldLanes {
+
+            /// Inverse of the mass of body 1
+            decimal massInverseBody1[NB_CONTACT_LANES];
+
+            /// Inverse of the mass of body 2
+            decimal massInverseBody2[NB_CONTACT_LANES];
+
+            /// Inverse inertia tensor of body 1 (row major)
+            decimal inverseInertiaTensorBody1[9][NB_CONTACT_LANES];
+
+            /// Inverse inertia tensor of body 2 (row major)
+            decimal inverseInertiaTensorBody2[9][NB_CONTACT_LANES];
+
+            /// Mix friction coefficient for the two bodies
+            decimal frictionCoefficient[NB_CONTACT_LANES];
+
+            /// Rolling resistance factor between the two bodies
+            decimal rollingResistanceFactor[NB_CONTACT_LANES];
+
+            /// Average normal vector of the contact manifolds
+            decimal normal[3][NB_CONTACT_LANES];
+
+            /// R1 vectors for the friction constraints
+            decimal r1Friction[3][NB_CONTACT_LANES];
+
+            /// R2 vectors for the friction constraints
+            decimal r2Friction[3][NB_CONTACT_LANES];
+
+            /// Cross products of r1 with 1st friction vector
+            decimal r1CrossT1[3][NB_CONTACT_LANES];
+
+            /// Cross products of r1 with 2nd friction vector
+            decimal r1CrossT2[3][NB_CONTACT_LANES];
+
+            /// Cross products of r2 with 1st friction vector
+            decimal r2CrossT1[3][NB_CONTACT_LANES];
+
+            /// Cross products of r2 with 2nd friction vector
+            decimal r2CrossT2[3][NB_CONTACT_LANES];
+
+            /// First friction directions
+            decimal frictionVector1[3][NB_CONTACT_LANES];
+
+            /// Second friction directions
+            decimal frictionVector2[3][NB_CONTACT_LANES];
+
+            /// Matrix K for the first friction constraints
+            decimal inverseFriction1Mass[NB_CONTACT_LANES];
+
+            /// Matrix K for the second friction constraints
+            decimal inverseFriction2Mass[NB_CONTACT_LANES];
+
+            /// Matrix K for the twist friction constraints
+            decimal inverseTwistFrictionMass[NB_CONTACT_LANES];
+
+            /// First friction direction impulses
+            decimal friction1Impulse[NB_CONTACT_LANES];
+
+            /// Second friction direction impulses
+            decimal friction2Impulse[NB_CONTACT_LANES];
+
+            /// Twist friction impulses
+            decimal frictionTwistImpulse[NB_CONTACT_LANES];
+
+            /// Matrix K for the rolling resistance constraints (row major)
+            decimal inverseRollingResistance[9][NB_CONTACT_LANES];
+
+            /// Rolling resistance impulses
+            decimal rollingResistanceImpulse[3][NB_CONTACT_LANES];
+
+            /// Contact points of the manifolds
+            ContactPointLanes points[MAX_CONTACT_POINTS_IN_MANIFOLD];
+        };
+
+        // Structure ContactGroupSolver
+        /**
+         * Group of contact manifolds that do not share any dynamic body and
+         * that are solved together by the wide contact solver.
+         */
+        struct ContactGroupSolver {
+
+            /// Number of contact manifolds in the group
+            uint nbLanes;
+
+            /// Largest number of contact points of the manifolds of the group
+            int8 nbMaxContacts;
+
+            /// Index of the contact manifold of each lane in the contact constraints array
+            uint manifoldIndices[NB_CONTACT_LANES];
+
+            /// Index of the first contact point of each lane in the contact points array
+            uint contactPointIndices[NB_CONTACT_LANES];
+
+            /// Index of body 1 of each lane in the velocity arrays
+            int32 indexBody1[NB_CONTACT_LANES];
+
+            /// Index of body 2 of each lane in the velocity arrays
+            int32 indexBody2[NB_CONTACT_LANES];
+
+            /// Constraints of the group
+            ContactManifoldLanes lanes;
+        };
+
+        // Structure WheelConstraintSolver
+        /**
+         * Constraints of a wheel of a vehicle that touches the ground.
+         */
+        struct WheelConstraintSolver {
+
+            /// Vehicle of the wheel
+            Vehicle* vehicle;
+
+            /// Index of the wheel in the vehicle
+            uint wheelIndex;
+
+            /// Index of the chassis in the velocity arrays
+            int32 indexBody;
+
+            /// Inverse of the mass of the chassis
+            decimal massInverse;
+
+            /// Normal of the ground
+            Vector3 normal;
+
+            /// Longitudinal direction of the tire (in the plane of the ground)
+            Vector3 forward;
+
+            /// Lateral direction of the tire (in the plane of the ground)
+            Vector3 side;
+
+            /// Cross product of the vector from the center of mass to the contact point with the normal
+            Vector3 rCrossNormal;
+
+            /// Cross product of the vector from the center of mass to the contact point with the forward direction
+            Vector3 rCrossForward;
+
+            /// Cross product of the vector from the center of mass to the contact point with the side direction
+            Vector3 rCrossSide;
+
+            /// Inverse inertia tensor of the chassis times rCrossNormal
+            Vector3 iTimesRCrossNormal;
+
+            /// Inverse inertia tensor of the chassis times rCrossForward
+            Vector3 iTimesRCrossForward;
+
+            /// Inverse inertia tensor of the chassis times rCrossSide
+            Vector3 iTimesRCrossSide;
+
+            /// Velocity of the ground at the contact point
+            Vector3 groundVelocity;
+
+            /// Inverse of the matrix K of the suspension
+            decimal inverseNormalMass;
+
+            /// Inverse of the matrix K of the longitudinal friction
+            decimal inverseForwardMass;
+
+            /// Inverse of the matrix K of the lateral friction
+            decimal inverseSideMass;
+
+            /// Difference between the current length and the rest length of the suspension
+            decimal suspensionError;
+
+            /// Coefficients of the spring of the suspension
+            SoftConstraintCoefficients suspensionSoftness;
+
+            /// Largest impulse of the suspension
+            decimal maxSuspensionImpulse;
+
+            /// Friction coefficient of the tire
+            decimal frictionCoefficient;
+
+            /// Impulse of the engine during the time step
+            decimal driveImpulse;
+
+            /// Largest impulse of the brake during the time step
+            decimal brakeImpulse;
+
+            /// Accumulated impulse of the suspension
+            decimal suspensionImpulse;
+
+            /// Accumulated impulse of the longitudinal friction
+            decimal forwardImpulse;
+
+            /// Accumulated impulse of the lateral friction
+            decimal sideImpulse;
         };
 
         // -------------------- Constants --------------------- //
 
+        /// Maximum number of the last created groups that are tested when we look
+        /// for a group to add a contact manifold into
+        static const uint NB_SEARCHED_CONTACT_GROUPS = 8;
+
+        /// Minimum number of contact manifolds of a color solved by a single task
+        static const uint MIN_NB_CONTACT_MANIFOLDS_PER_TASK = 16;
+
+        /// Solver feature of the split impulses position correction
+        static const uint8 SOLVER_FEATURE_SPLIT_IMPULSE = 1;
+
+        /// Solver feature of the rolling resistance (at least one contact manifold of the island)
+        static const uint8 SOLVER_FEATURE_ROLLING_RESISTANCE = 2;
+
+        /// Solver feature of the block contact solver
+        static const uint8 SOLVER_FEATURE_BLOCK_SOLVER = 4;
+
+        /// Number of combinations of the solver features
+        static const uint NB_SOLVER_FEATURES_COMBINATIONS = 8;
+
         /// Beta value for the penetration depth position correction without split impulses
         static const decimal BETA;
 
@@ -274,11 +599,28 @@ class ContactSolver {
         /// Slop distance (allowed penetration distance between bodies)
         static const decimal SLOP;
 
+        /// Relative value added to the diagonal of the matrix K of the block solver. The normal
+        /// constraints of four coplanar contact points are redundant and the matrix is singular
+        /// without it.
+        static const decimal BLOCK_SOLVER_REGULARIZATION;
+
+        /// Largest negative relative velocity of an inactive contact point accepted by the block solver
+        static const decimal BLOCK_SOLVER_TOLERANCE;
+
+        /// Method that solves a range of contact manifolds
+        using SolveContactManifoldsMethod = decimal (ContactSolver::*)(uint, uint);
+
+        /// Instantiation of solveContactManifolds() for each combination of solver features
+        static const SolveContactManifoldsMethod SOLVE_CONTACT_MANIFOLDS_METHODS[NB_SOLVER_FEATURES_COMBINATIONS];
+
         // -------------------- Attributes -------------------- //
 
         /// Memory manager
         MemoryManager& mMemoryManager;
 
+        /// Arena used to allocate the contact constraints (reused from one step to the next)
+        ArenaAllocator mArena;
+
         /// Split linear velocities for the position contact solver (split impulse)
         Vector3* mSplitLinearVelocities;
 
@@ -288,18 +630,67 @@ class ContactSolver {
         /// Current time step
         decimal mTimeStep;
 
-        /// Contact constraints
+        /// Contact constraints (aligned on a cache line)
         ContactManifoldSolver* mContactConstraints;
 
-        /// Contact points
+        /// Data of the contact constraints that is not used by the solver iterations
+        ContactManifoldSolverColdData* mContactConstraintsColdData;
+
+        /// Contact points (aligned on a cache line)
         ContactPointSolver* mContactPoints;
 
+        /// Data of the contact points that is not used by the solver iterations
+        ContactPointSolverColdData* mContactPointsColdData;
+
+        /// Data of the block contact solver for each contact constraint (null if the block solver is disabled)
+        ContactManifoldBlockSolver* mContactBlocks;
+
         /// Number of contact point constraints
         uint mNbContactPoints;
 
         /// Number of contact constraints
         uint mNbContactManifolds;
 
+        /// Array with the islands of the current step
+        Island** mIslands;
+
+        /// Number of islands of the current step
+        uint mNbIslands;
+
+        /// Index of the first contact constraint of each island (the last element
+        /// of the array is the total number of contact constraints)
+        uint* mIslandsFirstContactManifoldIndex;
+
+        /// Index of the first contact point constraint of each island (the last element
+        /// of the array is the total number of contact point constraints)
+        uint* mIslandsFirstContactPointIndex;
+
+        /// Solver features used by the contact manifolds of each island (computed when the
+        /// constraints of the island are initialized)
+        uint8* mIslandsSolverFeatures;
+
+        /// Number of contact points of each island whose cached solver data has been reused
+        /// when the constraints of the island have been initialized
+        uint* mIslandsNbReusedContactPoints;
+
+        /// Groups of contact manifolds of each island for the wide contact solver
+        /// (null if the groups of the island have not been computed yet)
+        ContactGroupSolver** mIslandsContactGroups;
+
+        /// Number of groups of contact manifolds of each island for the wide contact solver
+        uint* mIslandsNbContactGroups;
+
+        /// Index of the first group of each color of each island for the wide contact
+        /// solver (null if the contact manifolds of the island have not been colored)
+        uint** mIslandsContactGroupsColorsFirstIndex;
+
+        /// Constraints of the wheels of the vehicles that touch the ground (sorted by island)
+        WheelConstraintSolver* mWheelConstraints;
+
+        /// Index of the first wheel constraint of each island (the last element of the array
+        /// is the total number of wheel constraints). Null if there is no vehicle.
+        uint* mIslandsFirstWheelIndex;
+
         /// Array of linear velocities
         Vector3* mLinearVelocities;
 
@@ -309,9 +700,16 @@ class ContactSolver {
         /// True if the split impulse position correction is active
         bool mIsSplitImpulseActive;
 
+        /// Coefficients of the soft penetration constraints for the current time step
+        /// (rigid coefficients if the contacts are not soft)
+        SoftConstraintCoefficients mContactSoftness;
+
         /// World settings
         const WorldSettings& mWorldSettings;
 
+        /// Table of the materials of the world used to combine the materials of the bodies
+        const MaterialTable& mMaterialTable;
+
 #ifdef IS_PROFILING_ACTIVE
 
 		/// Pointer to the profiler
@@ -321,41 +719,95 @@ class ContactSolver {
 
         // -------------------- Methods -------------------- //
 
-        /// Compute the collision restitution factor from the restitution factor of each body
-        decimal computeMixedRestitutionFactor(RigidBody* body1,
-                                              RigidBody* body2) const;
-
-        /// Compute the mixed friction coefficient from the friction coefficient of each body
-        decimal computeMixedFrictionCoefficient(RigidBody* body1,
-                                                RigidBody* body2) const;
-
-        /// Compute th mixed rolling resistance factor between two bodies
-        decimal computeMixedRollingResistance(RigidBody* body1, RigidBody* body2) const;
-
         /// Compute the two unit orthogonal vectors "t1" and "t2" that span the tangential friction
         /// plane for a contact manifold. The two vectors have to be
         /// such that : t1 x t2 = contactNormal.
         void computeFrictionVectors(const Vector3& deltaVelocity,
                                     ContactManifoldSolver& contactPoint) const;
 
-        /// Warm start the solver.
-        void warmStart();
+        /// Compute the matrix K of the block contact solver for a contact manifold
+        void initializeBlockSolver(uint c);
+
+        /// Solve the mixed linear complementarity problem of the normal impulses of a contact manifold
+        static bool solveBlockNormalImpulses(const ContactManifoldBlockSolver& block, const decimal* relativeVelocities,
+                                             int8 nbContacts, uint8& activeSet, decimal* outImpulses);
+
+        /// Solve the normal impulses of a contact manifold with a given set of active contact points
+        static bool solveBlockNormalImpulsesWithSet(const ContactManifoldBlockSolver& block, const decimal* relativeVelocities,
+                                                    int8 nbContacts, uint8 activeSet, decimal* outImpulses);
+
+        /// Solve the normal impulses (or split impulses) of a contact manifold at once with the block solver
+        bool solveContactManifoldBlock(uint c, bool isSplitImpulse, Vector3& v1, Vector3& w1,
+                                       Vector3& v2, Vector3& w2, decimal& impulseDelta);
+
+        /// Group the contact manifolds of an island for the wide contact solver
+        void computeContactGroups(uint islandIndex);
+
+        /// Copy the contact constraints of an island into the groups of the wide contact solver
+        void packContactGroups(uint islandIndex);
+
+        /// Copy the impulses of the groups of the wide contact solver back into the contact constraints
+        void unpackContactGroups(uint islandIndex);
+
+        /// Solve the contacts of a contact manifold and return the largest change of impulse
+        template<bool isSplitImpulseActive, bool isRollingResistanceActive, bool isBlockSolverActive>
+        decimal solveContactManifold(uint c);
+
+        /// Solve the contacts of a range of contact manifolds and return the largest change of impulse
+        template<bool isSplitImpulseActive, bool isRollingResistanceActive, bool isBlockSolverActive>
+        decimal solveContactManifolds(uint firstIndex, uint endIndex);
+
+        /// Return the solver features of the contact manifolds of an island
+        uint8 getIslandSolverFeatures(uint islandIndex) const;
+
+        /// Return true if the cached solver data of a resting contact point can be reused
+        bool canReuseContactPointSolverData(const ContactPoint* contactPoint, const ContactPointSolver& contactPointSolver,
+                                            const RigidBody* body1, const RigidBody* body2) const;
+
+        /// Store the solver data of a contact point and the state of the bodies used to compute it
+        void cacheContactPointSolverData(ContactPoint* contactPoint, const ContactPointSolver& contactPointSolver,
+                                         const RigidBody* body1, const RigidBody* body2) const;
+
+        /// Solve a group of contact manifolds with the wide contact solver and return the largest change of impulse
+        decimal solveContactGroup(ContactGroupSolver& group);
 
    public:
 
         // -------------------- Methods -------------------- //
 
         /// Constructor
-        ContactSolver(MemoryManager& memoryManager, const WorldSettings& worldSettings);
+        ContactSolver(MemoryManager& memoryManager, const WorldSettings& worldSettings,
+                      const MaterialTable& materialTable);
 
         /// Destructor
         ~ContactSolver() = default;
 
-        /// Initialize the contact constraints
+        /// Allocate the contact constraints of the islands
         void init(Island** islands, uint nbIslands, decimal timeStep);
 
-        /// Initialize the constraint solver for a given island
-        void initializeForIsland(Island* island);
+        /// Initialize the contact constraints of a given island
+        void initializeForIsland(uint islandIndex, bool reprojectContacts = false);
+
+        /// Warm start the contact constraints of a given island
+        void warmStart(uint islandIndex);
+
+        /// Allocate the constraints of the wheels of the vehicles of the islands
+        void initWheels(const List<Vehicle*>& vehicles);
+
+        /// Return the number of wheel constraints of a given island
+        uint getNbWheels(uint islandIndex) const;
+
+        /// Initialize the wheel constraints of a given island
+        void initializeWheelsForIsland(uint islandIndex);
+
+        /// Warm start the wheel constraints of a given island
+        void warmStartWheels(uint islandIndex);
+
+        /// Solve the wheel constraints of a given island and return the largest change of impulse
+        decimal solveWheels(uint islandIndex);
+
+        /// Store the impulses of the wheel constraints of an island in the wheels
+        void storeWheelsImpulses(uint islandIndex);
 
         /// Set the split velocities arrays
         void setSplitVelocitiesArrays(Vector3* splitLinearVelocities,
@@ -365,19 +817,35 @@ class ContactSolver {
         void setConstrainedVelocitiesArrays(Vector3* constrainedLinearVelocities,
                                             Vector3* constrainedAngularVelocities);
 
-        /// Store the computed impulses to use them to
+        /// Store the computed impulses of an island to use them to
         /// warm start the solver at the next iteration
-        void storeImpulses();
+        void storeImpulses(uint islandIndex);
 
-        /// Solve the contacts
-        void solve();
+        /// Add the impulses of the contact manifolds with a total normal impulse larger
+        /// than a threshold to a list of contact impulses
+        void reportContactImpulses(List<ContactImpulse>& contactImpulses, decimal threshold) const;
+
+        /// Solve the contacts of a given island and return the largest change of impulse
+        decimal solve(uint islandIndex);
 
         /// Return true if the split impulses position correction technique is used for contacts
         bool isSplitImpulseActive() const;
 
+        /// Return the number of contact points whose cached solver data has been reused during the last step
+        uint getNbReusedContactPoints() const;
+
+        /// Return true if the penetration of the contacts is solved with soft constraints
+        bool isContactSoft() const;
+
         /// Activate or Deactivate the split impulses for contacts
         void setIsSplitImpulseActive(bool isActive);
 
+        /// Return the largest number of bytes used by the contact constraints of a step
+        size_t getMemoryHighWaterMark() const;
+
+        /// Return the number of bytes reserved for the contact constraints
+        size_t getMemoryCapacity() const;
+
 #ifdef IS_PROFILING_ACTIVE
 
 		/// Set the profiler
@@ -408,14 +876,54 @@ inline void ContactSolver::setConstrainedVelocitiesArrays(Vector3* constrainedLi
     mAngularVelocities = constrainedAngularVelocities;
 }
 
+// Return the number of wheel constraints of a given island
+/**
+ * @param islandIndex Index of the island
+ * @return The number of wheels of the vehicles of the island that touch the ground
+ */
+inline uint ContactSolver::getNbWheels(uint islandIndex) const {
+    assert(islandIndex < mNbIslands);
+    if (mIslandsFirstWheelIndex == nullptr) return 0;
+    return mIslandsFirstWheelIndex[islandIndex + 1] - mIslandsFirstWheelIndex[islandIndex];
+}
+
 // Return true if the split impulses position correction technique is used for contacts
 inline bool ContactSolver::isSplitImpulseActive() const {
     return mIsSplitImpulseActive;
 }
 
+// Return the number of contact points whose cached solver data has been reused during the last step
+/// The islands that have not been initialized during the step (because of their simulation
+/// level of detail) are counted as islands without reused contact points.
+inline uint ContactSolver::getNbReusedContactPoints() const {
+
+    uint nbReusedContactPoints = 0;
+    for (uint i=0; i < mNbIslands; i++) {
+        nbReusedContactPoints += mIslandsNbReusedContactPoints[i];
+    }
+
+    return nbReusedContactPoints;
+}
+
+// Return the largest number of bytes used by the contact constraints of a step
+inline size_t ContactSolver::getMemoryHighWaterMark() const {
+    return mArena.getHighWaterMark();
+}
+
+// Return the number of bytes reserved for the contact constraints
+inline size_t ContactSolver::getMemoryCapacity() const {
+    return mArena.getCapacity();
+}
+
+// Return true if the penetration of the contacts is solved with soft constraints
+inline bool ContactSolver::isContactSoft() const {
+    return mWorldSettings.contactFrequency > decimal(0.0);
+}
+
 // Activate or Deactivate the split impulses for contacts
+/// The split impulses are never used for soft contacts.
 inline void ContactSolver::setIsSplitImpulseActive(bool isActive) {
-    mIsSplitImpulseActive = isActive;
+    mIsSplitImpulseActive = isActive && !isContactSoft();
 }
 
 #ifdef IS_PROFILING_ACTIVE
@@ -0,0 +1,297 @@
+/********************************************************************************
+* ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
+* Copyright (c) 2010-2018 Daniel Chappuis                                       *
+*********************************************************************************
+*                                                                               *
+* This software is provided 'as-is', without any express or implied warranty.   *
+* In no event will the authors be held liable for any damages arising from the  *
+* use of this software.                                                         *
+*                                                                               *
+* Permission is granted to anyone to use this software for any purpose,         *
+* including commercial applications, and to alter it and redistribute it        *
+* freely, subject to the following restrictions:                                *
+*                                                                               *
+* 1. The origin of this software must not be misrepresented; you must not claim *
+*    that you wrote the original software. If you use this software in a        *
+*    product, an acknowledgment in the product documentation would be           *
+*    appreciated but is not required.                                           *
+*                                                                               *
+* 2. Altered source versions must be plainly marked as such, and must not be    *
+*    misrepresented as being the original software.                             *
+*                                                                               *
+* 3. This notice may not be removed or altered from any source distribution.    *
+*                                                                               *
+********************************************************************************/
+
+// Libraries
+#include "DefaultTaskScheduler.h"
+#include <cassert>
+
+using namespace reactphysics3d;
+
+// Constructor
+/**
+ * @param nbWorkers Number of tasks that can be executed at the same time (including
+ *                  the thread that submits the tasks). If zero, the number of hardware
+ *                  threads is used.
+ */
+DefaultTaskScheduler::DefaultTaskScheduler(uint nbWorkers)
+                     : mNbWorkers(nbWorkers), mThreads(nullptr), mTaskRanges(nullptr), mFunction(nullptr),
+                       mSubmissionCounter(0), mNbBusyWorkers(0), mIsStopping(false),
+                       mNbStartedJobs(0), mIsJobThreadStopping(false) {
+
+    if (mNbWorkers == 0) {
+        mNbWorkers = std::thread::hardware_concurrency();
+    }
+    if (mNbWorkers == 0) {
+        mNbWorkers = 1;
+    }
+
+    mTaskRanges = new TaskRange[mNbWorkers];
+    for (uint i=0; i < mNbWorkers; i++) {
+        mTaskRanges[i].nextTaskIndex = 0;
+        mTaskRanges[i].endTaskIndex = 0;
+    }
+
+    // Start the worker threads (the calling thread is the worker zero)
+    if (mNbWorkers > 1) {
+        mThreads = new std::thread[mNbWorkers - 1];
+        for (uint i=1; i < mNbWorkers; i++) {
+            mThreads[i - 1] = std::thread(&DefaultTaskScheduler::runWorker, this, i);
+        }
+    }
+
+    // Start the thread of the background jobs
+    mJobThread = std::thread(&DefaultTaskScheduler::runJobs, this);
+}
+
+// Destructor
+DefaultTaskScheduler::~DefaultTaskScheduler() {
+
+    // Ask the job thread to exit once the started jobs are finished
+    {
+        std::lock_guard<std::mutex> lock(mJobMutex);
+        mIsJobThreadStopping = true;
+    }
+    mJobStartedCondition.notify_one();
+    mJobThread.join();
+
+    // Ask the worker threads to exit
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mIsStopping = true;
+    }
+    mTasksSubmittedCondition.notify_all();
+
+    // Wait for the worker threads
+    for (uint i=1; i < mNbWorkers; i++) {
+        mThreads[i - 1].join();
+    }
+
+    delete[] mThreads;
+    delete[] mTaskRanges;
+}
+
+// Execute the function for each task index in [0, nbTasks)
+/// This method returns when all the tasks are finished. If it is called while other
+/// tasks are being executed (from another thread or from inside a task), the tasks are
+/// executed sequentially on the calling thread.
+void DefaultTaskScheduler::parallelFor(uint nbTasks, const TaskFunction& function) {
+
+    if (nbTasks == 0) return;
+
+    std::unique_lock<std::mutex> lock(mMutex);
+
+    // If the tasks cannot be distributed between the workers
+    if (mNbWorkers == 1 || nbTasks == 1 || mFunction != nullptr) {
+
+        lock.unlock();
+
+        // Execute the tasks on the calling thread
+        for (uint i=0; i < nbTasks; i++) {
+            function(i);
+        }
+
+        return;
+    }
+
+    // Split the tasks between the workers
+    for (uint i=0; i < mNbWorkers; i++) {
+        mTaskRanges[i].nextTaskIndex = static_cast<uint>((static_cast<luint>(nbTasks) * i) / mNbWorkers);
+        mTaskRanges[i].endTaskIndex = static_cast<uint>((static_cast<luint>(nbTasks) * (i + 1)) / mNbWorkers);
+    }
+
+    mFunction = &function;
+    mNbBusyWorkers = mNbWorkers - 1;
+    mSubmissionCounter++;
+
+    lock.unlock();
+
+    // Wake up the worker threads
+    mTasksSubmittedCondition.notify_all();
+
+    // The calling thread also executes tasks
+    executeTasks(0, function);
+
+    // Wait until all the worker threads have finished
+    lock.lock();
+    mTasksFinishedCondition.wait(lock, [this]() { return mNbBusyWorkers == 0; });
+    mFunction = nullptr;
+}
+
+// Main loop of a worker thread
+void DefaultTaskScheduler::runWorker(uint workerIndex) {
+
+    luint lastSubmissionCounter = 0;
+
+    std::unique_lock<std::mutex> lock(mMutex);
+
+    while (true) {
+
+        // Wait until new tasks are submitted
+        mTasksSubmittedCondition.wait(lock, [this, lastSubmissionCounter]() {
+            return mIsStopping || mSubmissionCounter != lastSubmissionCounter;
+        });
+
+        if (mIsStopping) return;
+
+        lastSubmissionCounter = mSubmissionCounter;
+        const TaskFunction* function = mFunction;
+        assert(function != nullptr);
+
+        lock.unlock();
+
+        executeTasks(workerIndex, *function);
+
+        lock.lock();
+
+        // Notify the submitting thread if this was the last busy worker
+        assert(mNbBusyWorkers > 0);
+        mNbBusyWorkers--;
+        if (mNbBusyWorkers == 0) {
+            mTasksFinishedCondition.notify_one();
+        }
+    }
+}
+
+// Execute the tasks of a worker range and steal the tasks of the other workers
+void DefaultTaskScheduler::executeTasks(uint workerIndex, const TaskFunction& function) {
+
+    // For each range, starting with the range of the worker
+    for (uint r=0; r < mNbWorkers; r++) {
+
+        TaskRange& range = mTaskRanges[(workerIndex + r) % mNbWorkers];
+
+        // Take the next task of the range until the range is empty
+        uint taskIndex = range.nextTaskIndex.fetch_add(1);
+        while (taskIndex < range.endTaskIndex) {
+
+            function(taskIndex);
+
+            taskIndex = range.nextTaskIndex.fetch_add(1);
+        }
+    }
+}
+
+// Start to execute a function on the job thread once its predecessor jobs are finished
+/// The function can submit tasks with parallelFor(). They are distributed between the
+/// workers unless other tasks are being executed at the same time. The job is queued
+/// immediately if its predecessors are already finished. Otherwise, it is queued when its
+/// last predecessor finishes.
+/**
+ * @param function Function to execute
+ * @param predecessorJobIds Array with the identifiers of the jobs that must be finished first
+ * @param nbPredecessorJobs Number of predecessor jobs in the array
+ * @return The identifier of the job to give to waitJob()
+ */
+luint DefaultTaskScheduler::startJob(const JobFunction& function, const luint* predecessorJobIds,
+                                     uint nbPredecessorJobs) {
+
+    luint jobId;
+    bool isReady;
+    {
+        std::lock_guard<std::mutex> lock(mJobMutex);
+
+        mNbStartedJobs++;
+        jobId = mNbStartedJobs;
+
+        Job& job = mJobs[jobId];
+        job.function = function;
+        job.nbRemainingPredecessorJobs = 0;
+
+        // Register the job as a successor of its predecessors that are not finished yet
+        for (uint i=0; i < nbPredecessorJobs; i++) {
+            assert(predecessorJobIds[i] < jobId);
+            auto predecessor = mJobs.find(predecessorJobIds[i]);
+            if (predecessor != mJobs.end()) {
+                predecessor->second.successorJobIds.push_back(jobId);
+                job.nbRemainingPredecessorJobs++;
+            }
+        }
+
+        isReady = job.nbRemainingPredecessorJobs == 0;
+        if (isReady) mReadyJobIds.push_back(jobId);
+    }
+    if (isReady) mJobStartedCondition.notify_one();
+
+    return jobId;
+}
+
+// Wait until a job started with startJob() is finished
+/**
+ * @param jobId Identifier returned by startJob()
+ */
+void DefaultTaskScheduler::waitJob(luint jobId) {
+
+    std::unique_lock<std::mutex> lock(mJobMutex);
+    assert(jobId <= mNbStartedJobs);
+
+    mJobFinishedCondition.wait(lock, [this, jobId]() { return mJobs.find(jobId) == mJobs.end(); });
+}
+
+// Main loop of the job thread
+/// The thread that finishes a job queues the successors of the job whose predecessors are
+/// now all finished. The thread exits when it is stopping and no job is left (a job that
+/// waits for its predecessors always has a predecessor that is queued or running).
+void DefaultTaskScheduler::runJobs() {
+
+    std::unique_lock<std::mutex> lock(mJobMutex);
+
+    while (true) {
+
+        // Wait until a job is ready
+        mJobStartedCondition.wait(lock, [this]() { return mIsJobThreadStopping || !mReadyJobIds.empty(); });
+
+        if (mReadyJobIds.empty()) {
+            assert(mJobs.empty());
+            return;
+        }
+
+        const luint jobId = mReadyJobIds.front();
+        mReadyJobIds.pop_front();
+        JobFunction function = std::move(mJobs[jobId].function);
+
+        lock.unlock();
+
+        function();
+
+        lock.lock();
+
+        // Queue the successors of the job whose last predecessor was this job
+        auto job = mJobs.find(jobId);
+        assert(job != mJobs.end());
+        const std::vector<luint>& successorJobIds = job->second.successorJobIds;
+        for (uint i=0; i < successorJobIds.size(); i++) {
+            const luint successorJobId = successorJobIds[i];
+            Job& successor = mJobs[successorJobId];
+            assert(successor.nbRemainingPredecessorJobs > 0);
+            successor.nbRemainingPredecessorJobs--;
+            if (successor.nbRemainingPredecessorJobs == 0) {
+                mReadyJobIds.push_back(successorJobId);
+            }
+        }
+        mJobs.erase(job);
+
+        mJobFinishedCondition.notify_all();
+    }
+}
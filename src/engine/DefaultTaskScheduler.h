@@ -0,0 +1,182 @@
+/********************************************************************************
+* ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
+* Copyright (c) 2010-2018 Daniel Chappuis                                       *
+*********************************************************************************
+*                                                                               *
+* This software is provided 'as-is', without any express or implied warranty.   *
+* In no event will the authors be held liable for any damages arising from the  *
+* use of this software.                                                         *
+*                                                                               *
+* Permission is granted to anyone to use this software for any purpose,         *
+* including commercial applications, and to alter it and redistribute it        *
+* freely, subject to the following restrictions:                                *
+*                                                                               *
+* 1. The origin of this software must not be misrepresented; you must not claim *
+*    that you wrote the original software. If you use this software in a        *
+*    product, an acknowledgment in the product documentation would be           *
+*    appreciated but is not required.                                           *
+*                                                                               *
+* 2. Altered source versions must be plainly marked as such, and must not be    *
+*    misrepresented as being the original software.                             *
+*                                                                               *
+* 3. This notice may not be removed or altered from any source distribution.    *
+*                                                                               *
+********************************************************************************/
+
+#ifndef REACTPHYSICS3D_DEFAULT_TASK_SCHEDULER_H
+#define REACTPHYSICS3D_DEFAULT_TASK_SCHEDULER_H
+
+// Libraries
+#include "engine/TaskScheduler.h"
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <unordered_map>
+#include <vector>
+
+/// ReactPhysics3D namespace
+namespace reactphysics3d {
+
+// Class DefaultTaskScheduler
+/**
+ * This class represents a default task scheduler that uses a pool of std::thread
+ * worker threads. When tasks are submitted, the range of task indices is split
+ * between the workers. Each worker executes the tasks of its own range and then
+ * steals the remaining tasks of the other workers when it has nothing left to do.
+ * The thread that submits the tasks also works until all the tasks are finished.
+ * The jobs started with startJob() are executed one after the other by an additional
+ * thread of the scheduler. A job waits in the scheduler until its predecessor jobs are
+ * finished and is then queued by the thread that has finished its last predecessor, so it
+ * does not delay the jobs started after it.
+ */
+class DefaultTaskScheduler : public TaskScheduler {
+
+    private:
+
+        /// Range of task indices assigned to a worker
+        struct TaskRange {
+
+            /// Index of the next task to execute in the range
+            std::atomic<uint> nextTaskIndex;
+
+            /// Index after the last task of the range
+            uint endTaskIndex;
+
+            /// Padding to avoid false sharing between the ranges of the workers
+            char padding[64];
+        };
+
+        /// Job started with startJob() that is not finished yet
+        struct Job {
+
+            /// Function of the job
+            JobFunction function;
+
+            /// Number of predecessor jobs that are not finished yet
+            uint nbRemainingPredecessorJobs;
+
+            /// Identifiers of the jobs that wait for this job to be finished
+            std::vector<luint> successorJobIds;
+        };
+
+        // -------------------- Attributes -------------------- //
+
+        /// Number of workers (including the thread that submits the tasks)
+        uint mNbWorkers;
+
+        /// Array with the worker threads
+        std::thread* mThreads;
+
+        /// Array with the range of tasks of each worker
+        TaskRange* mTaskRanges;
+
+        /// Mutex used to synchronize the workers
+        std::mutex mMutex;
+
+        /// Condition variable used to wake up the workers when tasks are submitted
+        std::condition_variable mTasksSubmittedCondition;
+
+        /// Condition variable used to notify that all the workers have finished
+        std::condition_variable mTasksFinishedCondition;
+
+        /// Pointer to the function of the tasks currently executed (null if none)
+        const TaskFunction* mFunction;
+
+        /// Counter incremented each time new tasks are submitted to the workers
+        luint mSubmissionCounter;
+
+        /// Number of worker threads that are still executing the current tasks
+        uint mNbBusyWorkers;
+
+        /// True if the worker threads must exit
+        bool mIsStopping;
+
+        /// Thread that executes the jobs started with startJob()
+        std::thread mJobThread;
+
+        /// Mutex used to synchronize the job thread
+        std::mutex mJobMutex;
+
+        /// Condition variable used to wake up the job thread when a job is started
+        std::condition_variable mJobStartedCondition;
+
+        /// Condition variable used to notify that a job is finished
+        std::condition_variable mJobFinishedCondition;
+
+        /// Jobs that have been started and are not finished yet (with their identifier as key)
+        std::unordered_map<luint, Job> mJobs;
+
+        /// Identifiers of the jobs whose predecessors are finished (in the order they became ready)
+        std::deque<luint> mReadyJobIds;
+
+        /// Number of jobs started with startJob() (identifier of the last started job)
+        luint mNbStartedJobs;
+
+        /// True if the job thread must exit
+        bool mIsJobThreadStopping;
+
+        // -------------------- Methods -------------------- //
+
+        /// Main loop of a worker thread
+        void runWorker(uint workerIndex);
+
+        /// Execute the tasks of a worker range and steal the tasks of the other workers
+        void executeTasks(uint workerIndex, const TaskFunction& function);
+
+        /// Main loop of the job thread
+        void runJobs();
+
+    public:
+
+        // -------------------- Methods -------------------- //
+
+        /// Constructor
+        DefaultTaskScheduler(uint nbWorkers = 0);
+
+        /// Destructor
+        virtual ~DefaultTaskScheduler() override;
+
+        /// Return the maximum number of tasks that can be executed at the same time
+        virtual uint getNbWorkers() const override;
+
+        /// Execute the function for each task index in [0, nbTasks)
+        virtual void parallelFor(uint nbTasks, const TaskFunction& function) override;
+
+        /// Start to execute a function on the job thread once its predecessor jobs are finished
+        virtual luint startJob(const JobFunction& function, const luint* predecessorJobIds = nullptr,
+                               uint nbPredecessorJobs = 0) override;
+
+        /// Wait until a job started with startJob() is finished
+        virtual void waitJob(luint jobId) override;
+};
+
+// Return the maximum number of tasks that can be executed at the same time
+inline uint DefaultTaskScheduler::getNbWorkers() const {
+    return mNbWorkers;
+}
+
+}
+
+#endif
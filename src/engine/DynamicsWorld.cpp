@@ -31,8 +31,17 @@
 #include "constraint/FixedJoint.h"
 #include "utils/Profiler.h"
 #include "engine/EventListener.h"
+#include "engine/SolverIterationsPolicy.h"
 #include "engine/Island.h"
+#include "engine/TaskScheduler.h"
+#include "engine/Timer.h"
+#include "engine/WorldState.h"
 #include "collision/ContactManifold.h"
+#include "collision/RaycastInfo.h"
+#include "containers/FlatMap.h"
+#include "mathematics/QuaternionLanes.h"
+#include <utility>
+#include <algorithm>
 
 // Namespaces
 using namespace reactphysics3d;
@@ -48,25 +57,55 @@ using namespace std;
 DynamicsWorld::DynamicsWorld(const Vector3& gravity, const WorldSettings& worldSettings,
                              Logger* logger, Profiler* profiler)
               : CollisionWorld(worldSettings, logger, profiler),
-                mContactSolver(mMemoryManager, mConfig),
+                mMaterialTable(mConfig, mMemoryManager.getPoolAllocator(MemoryTag::Containers)),
+                mContactSolver(mMemoryManager, mConfig, mMaterialTable), mConstraintSolver(mMemoryManager, mConfig),
+                mPositionBasedSolver(mMemoryManager, mConfig, mMaterialTable),
                 mNbVelocitySolverIterations(mConfig.defaultVelocitySolverNbIterations),
+                mTotalNbVelocitySolverIterations(0),
                 mNbPositionSolverIterations(mConfig.defaultPositionSolverNbIterations),
-                mIsSleepingEnabled(mConfig.isSleepingEnabled), mRigidBodies(mMemoryManager.getPoolAllocator()),
-                mJoints(mMemoryManager.getPoolAllocator()), mGravity(gravity), mTimeStep(decimal(1.0f / 60.0f)),
-                mIsGravityEnabled(true), mConstrainedLinearVelocities(nullptr),
+                mIsSleepingEnabled(mConfig.isSleepingEnabled), mRigidBodies(mMemoryManager.getPoolAllocator(MemoryTag::Containers)),
+                mRigidBodyStates(mMemoryManager.getBaseAllocator(MemoryTag::Containers)),
+                mJoints(mMemoryManager.getPoolAllocator(MemoryTag::Containers)),
+                mParticleSystems(mMemoryManager.getPoolAllocator(MemoryTag::Containers)),
+                mVehicles(mMemoryManager.getPoolAllocator(MemoryTag::Containers)), mGravity(gravity), mTimeStep(decimal(1.0f / 60.0f)),
+                mIsGravityEnabled(true), mIsOrientationNormalizationApproximate(false),
+                mNbStepsSinceExactOrientationNormalization(0), mNbStepsSinceSpatialSort(0),
+                mNbSpatiallySortedBodies(0), mConstrainedLinearVelocities(nullptr),
                 mConstrainedAngularVelocities(nullptr), mSplitLinearVelocities(nullptr),
                 mSplitAngularVelocities(nullptr), mConstrainedPositions(nullptr),
-                mConstrainedOrientations(nullptr), mNbIslands(0), mIslands(nullptr),
+                mConstrainedOrientations(nullptr), mArrayBodies(nullptr), mNbIslands(0), mIslands(nullptr), mIslandsFirstIndex(0),
+                mLevelsOfDetailStepCounter(0), mNbSkippedIslands(0), mIslandToSplit(nullptr), mIsIslandsRebuildRequested(false),
+                mFixedSleepingBodies(mMemoryManager.getPoolAllocator(MemoryTag::Containers)),
+                mContactImpulses(mMemoryManager.getPoolAllocator(MemoryTag::Containers)),
+                mUpdateJobId(0), mIsUpdateRunning(false), mNextStepStage(StepStage::NONE), mStepTimeStep(decimal(0.0)),
+                mStepNbSubsteps(1), mStepStartTicks(0), mStepCollisionDetectionTicks(0), mStepIslandsTicks(0),
+                mStepSolverTicks(0), mSolverIterationsPolicy(nullptr),
                 mSleepLinearVelocity(mConfig.defaultSleepLinearVelocity),
                 mSleepAngularVelocity(mConfig.defaultSleepAngularVelocity),
                 mTimeBeforeSleep(mConfig.defaultTimeBeforeSleep),
-                mFreeJointsIDs(mMemoryManager.getPoolAllocator()), mCurrentJointId(0) {
+                mJointIdAllocator(mMemoryManager.getPoolAllocator(MemoryTag::Containers)) {
+
+    for (uint i=0; i < NB_SIMULATION_LEVELS_OF_DETAIL; i++) {
+        mLevelsOfDetailTimeSteps[i] = decimal(0.0);
+    }
+
+#ifdef IS_ALLOCATION_CHECK_ACTIVE
+
+    mAllocationCheckMode = AllocationCheckMode::DISABLED;
+    mNbAllocationsLastUpdate = 0;
+    mNbAllocationsBeforeUpdate = 0;
+    mNbHeapAllocationsBeforeUpdate = 0;
+    mNbHeapAllocationsLastUpdate = 0;
+    mNbAllocatingUpdates = 0;
+
+#endif
 
 #ifdef IS_PROFILING_ACTIVE
 
 	// Set the profiler
     mConstraintSolver.setProfiler(mProfiler);
     mContactSolver.setProfiler(mProfiler);
+    mPositionBasedSolver.setProfiler(mProfiler);
 
 #endif
 
@@ -78,18 +117,33 @@ DynamicsWorld::DynamicsWorld(const Vector3& gravity, const WorldSettings& worldS
 // Destructor
 DynamicsWorld::~DynamicsWorld() {
 
+    // Wait for the end of a step running in the background
+    if (mIsUpdateRunning) waitUpdate();
+
     // Destroy all the joints that have not been removed
     for (int i=mJoints.size() - 1; i >= 0; i--) {
         destroyJoint(mJoints[i]);
     }
 
+    // Destroy all the vehicles that have not been removed (before their chassis)
+    for (int i=mVehicles.size() - 1; i >= 0; i--) {
+        destroyVehicle(mVehicles[i]);
+    }
+
     // Destroy all the rigid bodies that have not been removed
     for (int i=mRigidBodies.size() - 1; i >= 0; i--) {
         destroyRigidBody(mRigidBodies[i]);
     }
 
+    // Destroy all the particle systems that have not been removed
+    for (int i=mParticleSystems.size() - 1; i >= 0; i--) {
+        destroyParticleSystem(mParticleSystems[i]);
+    }
+
     assert(mJoints.size() == 0);
     assert(mRigidBodies.size() == 0);
+    assert(mParticleSystems.size() == 0);
+    assert(mVehicles.size() == 0);
 
 #ifdef IS_PROFILING_ACTIVE
 
@@ -102,19 +156,182 @@ DynamicsWorld::~DynamicsWorld() {
 }
 
 // Update the physics simulation
+/// The collision detection is computed once for the whole time step. If several
+/// substeps are used, the velocity and position integration and the constraints
+/// solving are repeated for each substep with a smaller time step. The contacts of
+/// the collision detection are reused for all the substeps and their penetration
+/// depths are recomputed from the new positions of the bodies. This is cheaper than
+/// calling update() several times and improves the stability of stacks. This executes
+/// all the stages of the step (see beginStep()) at once.
+/**
+ * @param timeStep The amount of time to step the simulation by (in seconds)
+ * @param nbSubsteps Number of substeps used to solve the constraints
+ */
+void DynamicsWorld::update(decimal timeStep, uint nbSubsteps) {
+
+    beginStep(timeStep, nbSubsteps);
+
+    RP3D_PROFILE("DynamicsWorld::update()", mProfiler);
+
+    while (executeNextStepStage()) {}
+}
+
+// Begin a step of the physics simulation whose stages are executed one at a time
+/// The stages of the step are then executed in order by executeNextStepStage(). The
+/// application can do its own work between two stages or execute each stage on a different
+/// thread (but only one stage at a time). The world must not be modified until the last stage
+/// has been executed. A step of update() is the same as a step executed stage by stage.
 /**
  * @param timeStep The amount of time to step the simulation by (in seconds)
+ * @param nbSubsteps Number of substeps used to solve the constraints
  */
-void DynamicsWorld::update(decimal timeStep) {
+void DynamicsWorld::beginStep(decimal timeStep, uint nbSubsteps) {
+
+    assert(nbSubsteps > 0);
+    assert(mNextStepStage == StepStage::NONE);
 
 #ifdef IS_PROFILING_ACTIVE
     // Increment the frame counter of the profiler
     mProfiler->incrementFrameCounter();
 #endif
 
-    RP3D_PROFILE("DynamicsWorld::update()", mProfiler);
+#ifdef IS_ALLOCATION_CHECK_ACTIVE
+
+    // Number of allocations before the step
+    mNbAllocationsBeforeUpdate = mMemoryManager.getNbAllocationsCurrentFrame();
+    mNbHeapAllocationsBeforeUpdate = DefaultAllocator::getNbAllocations();
+
+#endif
+
+    // Keep the transforms of the bodies before the step to interpolate them
+    if (mConfig.isTransformInterpolationEnabled) mRigidBodyStates.savePreviousTransforms();
+
+    mStepTimeStep = timeStep;
+    mStepNbSubsteps = nbSubsteps;
+    mStepStartTicks = Timer::getCurrentTicks();
+    mNextStepStage = StepStage::BROAD_PHASE;
+}
+
+// Execute the next stage of the step started with beginStep()
+/**
+ * @return True if some stages of the step remain to be executed and false if the
+ *         step is finished
+ */
+bool DynamicsWorld::executeNextStepStage() {
+
+    assert(mNextStepStage != StepStage::NONE);
+
+    switch (mNextStepStage) {
+
+        case StepStage::BROAD_PHASE:
+            executeBroadPhaseStage();
+            mNextStepStage = StepStage::NARROW_PHASE;
+            break;
+
+        case StepStage::NARROW_PHASE:
+            executeNarrowPhaseStage();
+            mNextStepStage = StepStage::ISLANDS;
+            break;
+
+        case StepStage::ISLANDS:
+            executeIslandsStage();
+            mNextStepStage = StepStage::SOLVER;
+            break;
+
+        case StepStage::SOLVER:
+            executeSolverStage();
+            mNextStepStage = StepStage::END_OF_STEP;
+            break;
+
+        case StepStage::END_OF_STEP:
+            executeEndOfStepStage();
+            mNextStepStage = StepStage::NONE;
+            break;
+
+        case StepStage::NONE:
+            break;
+    }
+
+    return mNextStepStage != StepStage::NONE;
+}
+
+// Compute the transforms of all the rigid bodies interpolated between the last two steps
+/// The interpolation of the transforms must be enabled in the settings of the world
+/// (isTransformInterpolationEnabled). The transform of a body is interpolated between its
+/// transform at the beginning of the last step and its current transform. The transforms
+/// of the bodies that have not moved during the last step are copied. The interpolation
+/// factor is usually given by Timer::computeInterpolationFactor().
+/**
+ * @param interpolationFactor Interpolation factor between the two transforms (in [0, 1])
+ * @param[out] outTransforms Array with getNbRigidBodies() transforms where the interpolated
+ *                           transform of the body getRigidBody(i) is written at index i
+ */
+void DynamicsWorld::getInterpolatedTransforms(decimal interpolationFactor, Transform* outTransforms) const {
+
+    assert(mConfig.isTransformInterpolationEnabled);
+    assert(interpolationFactor >= decimal(0.0) && interpolationFactor <= decimal(1.0));
+
+    // The states are read in order and the transforms are written at the indices of the bodies
+    for (uint i=0; i < mRigidBodyStates.getNbStates(); i++) {
+
+        const RigidBody* body = mRigidBodyStates.mBodies[i];
+        const Transform& previousTransform = mRigidBodyStates.mPreviousTransforms[i];
+        const Transform& transform = body->getTransform();
+
+        outTransforms[body->mRigidBodyIndex] = previousTransform == transform ? transform :
+                            Transform::interpolateTransforms(previousTransform, transform, interpolationFactor);
+    }
+}
+
+// Write the transforms of all the rigid bodies as packed floats for the rendering
+/// This method exports the transforms of all the bodies in a single pass so that they can be
+/// uploaded at once into a buffer of the GPU (for instanced rendering for example). Eight
+/// floats are written for each body: the position of the body, 1.0 if the body is sleeping
+/// and 0.0 otherwise, and the orientation quaternion (x, y, z, w). The transforms are
+/// interpolated between the last two steps if the interpolation of the transforms is
+/// enabled in the settings of the world (see getInterpolatedTransforms()).
+/**
+ * @param interpolationFactor Interpolation factor between the two transforms (in [0, 1])
+ * @param[out] outData Array with 8 * getNbRigidBodies() floats where the transform of
+ *                     the body getRigidBody(i) is written at index 8 * i
+ */
+void DynamicsWorld::getRenderTransforms(decimal interpolationFactor, float* outData) const {
+
+    assert(interpolationFactor >= decimal(0.0) && interpolationFactor <= decimal(1.0));
+
+    // The states are read in order and the transforms are written at the indices of the bodies
+    for (uint i=0; i < mRigidBodyStates.getNbStates(); i++) {
+
+        const RigidBody* body = mRigidBodyStates.mBodies[i];
+        Transform transform = body->getTransform();
+        if (mConfig.isTransformInterpolationEnabled && mRigidBodyStates.mPreviousTransforms[i] != transform) {
+            transform = Transform::interpolateTransforms(mRigidBodyStates.mPreviousTransforms[i], transform,
+                                                         interpolationFactor);
+        }
 
-    mTimeStep = timeStep;
+        const Vector3& position = transform.getPosition();
+        const Quaternion& orientation = transform.getOrientation();
+        float* data = outData + 8 * body->mRigidBodyIndex;
+        data[0] = static_cast<float>(position.x);
+        data[1] = static_cast<float>(position.y);
+        data[2] = static_cast<float>(position.z);
+        data[3] = body->isSleeping() ? 1.0f : 0.0f;
+        data[4] = static_cast<float>(orientation.x);
+        data[5] = static_cast<float>(orientation.y);
+        data[6] = static_cast<float>(orientation.z);
+        data[7] = static_cast<float>(orientation.w);
+    }
+}
+
+// Execute the broad-phase stage of a step
+/// The lists of contact manifolds of the bodies are reset, the states of the bodies are
+/// sorted spatially (periodically) and the broad-phase computes the overlapping pairs.
+void DynamicsWorld::executeBroadPhaseStage() {
+
+    RP3D_PROFILE("DynamicsWorld::executeBroadPhaseStage()", mProfiler);
+
+    // Time step of a substep
+    mTimeStep = mStepTimeStep / decimal(mStepNbSubsteps);
 
     // Notify the event listener about the beginning of an internal tick
     if (mEventListener != nullptr) mEventListener->beginInternalTick();
@@ -122,28 +339,151 @@ void DynamicsWorld::update(decimal timeStep) {
     // Reset all the contact manifolds lists of each body
     resetContactManifoldListsOfBodies();
 
-    // Compute the collision detection
-    mCollisionDetection.computeCollisionDetection();
+    // Periodically sort the states of the bodies along a Morton curve of their positions (the
+    // states of a step started with startUpdate() have already been sorted before the snapshot)
+    if (!mIsUpdateRunning) updateSpatialSort();
+
+    // Compute the broad-phase of the collision detection (the speculative contacts cover the whole step)
+    mCollisionDetection.mSpeculativeContactsTimeStep = mStepTimeStep;
+    mCollisionDetection.computeCollisionDetectionBroadPhase();
+}
+
+// Execute the narrow-phase stage of a step
+void DynamicsWorld::executeNarrowPhaseStage() {
+
+    RP3D_PROFILE("DynamicsWorld::executeNarrowPhaseStage()", mProfiler);
+
+    // Compute the middle-phase and the narrow-phase of the collision detection
+    mCollisionDetection.computeCollisionDetectionNarrowPhase();
+
+    // Find the ground under the wheels of the vehicles
+    if (mVehicles.size() > 0) updateVehiclesWheels();
+
+    mStepCollisionDetectionTicks = Timer::getCurrentTicks();
+}
+
+// Execute the islands stage of a step
+/// The islands of awake bodies are computed and the islands simulated at this step are
+/// selected with their simulation level of detail.
+void DynamicsWorld::executeIslandsStage() {
+
+    RP3D_PROFILE("DynamicsWorld::executeIslandsStage()", mProfiler);
 
     // Compute the islands (separate groups of bodies with constraints between each others)
     computeIslands();
 
-    // Integrate the velocities
-    integrateRigidBodiesVelocities();
+    // Select the islands that are simulated at this step with their simulation level of detail
+    selectDueIslands(mStepTimeStep, mLevelsFirstIsland, mLevelsTimeSteps);
+
+    mStepIslandsTicks = Timer::getCurrentTicks();
+}
 
-    // Solve the contacts and constraints
-    solveContactsAndConstraints();
+// Execute the solver stage of a step
+/// For each simulation level of detail, the velocities are integrated, the constraints
+/// are solved and the positions are integrated during each substep. The sleeping bodies
+/// are then updated and the broken joints are destroyed.
+void DynamicsWorld::executeSolverStage() {
 
-    // Integrate the position and orientation of each body
-    integrateRigidBodiesPositions();
+    RP3D_PROFILE("DynamicsWorld::executeSolverStage()", mProfiler);
 
-    // Solve the position correction for constraints
-    solvePositionCorrection();
+    Island** islands = mIslands;
+    const uint nbIslands = mNbIslands;
+    const uint nbSubsteps = mStepNbSubsteps;
 
-    // Update the state (positions and velocities) of the bodies
-    updateBodiesState();
+    // If the islands are solved sequentially, the broad-phase state of the bodies
+    // is updated in the same pass as their position during the last substep
+    const bool isBroadPhaseUpdatedBySolver = getTaskScheduler() == nullptr;
+
+    mContactImpulses.clear();
+    mTotalNbVelocitySolverIterations = 0;
+    if (mSolverIterationsPolicy != nullptr) mSolverIterationsPolicy->beginStep();
+
+    // The islands of each simulation level of detail are solved together with the time
+    // accumulated by their level (the solvers use a single time step for all their islands)
+    for (uint level=0; level < NB_SIMULATION_LEVELS_OF_DETAIL; level++) {
+
+        mIslandsFirstIndex = mLevelsFirstIsland[level];
+        mIslands = islands + mLevelsFirstIsland[level];
+        mNbIslands = mLevelsFirstIsland[level + 1] - mLevelsFirstIsland[level];
+        if (mNbIslands == 0) continue;
+
+        // Time step of a substep
+        mTimeStep = mLevelsTimeSteps[level] / decimal(nbSubsteps);
+
+        // Color the constraints of the islands so that they can be solved in parallel
+        if (mConfig.isConstraintColoringEnabled) colorIslandsConstraints();
+
+        // Allocate the velocity arrays and the contact constraints of the islands
+        initIslands();
+
+        // For each substep
+        for (uint substep=0; substep < nbSubsteps; substep++) {
+
+            // Integrate the velocities and initialize the constraints of the islands
+            initIslandsConstraints(substep > 0);
+
+            // The approximately normalized orientations are periodically normalized exactly
+            if (mConfig.isApproximateOrientationNormalizationEnabled) {
+                mNbStepsSinceExactOrientationNormalization++;
+                mIsOrientationNormalizationApproximate = mNbStepsSinceExactOrientationNormalization <
+                                                         mConfig.nbStepsBetweenExactOrientationNormalizations;
+                if (!mIsOrientationNormalizationApproximate) mNbStepsSinceExactOrientationNormalization = 0;
+            }
+
+            // Solve the constraints and integrate the positions of the islands
+            solveIslands(isBroadPhaseUpdatedBySolver && substep == nbSubsteps - 1);
+        }
+
+        // Report the significant impulses applied by the contact solver
+        if (mConfig.isContactImpulseReported && !mConfig.isPositionBasedSolverEnabled) {
+            mContactSolver.reportContactImpulses(mContactImpulses, mConfig.contactImpulseReportThreshold);
+        }
+
+        // Update the broad-phase state of the bodies that have moved
+        if (!isBroadPhaseUpdatedBySolver) updateBodiesBroadPhaseState();
+
+        // Count the velocity solver iterations of the islands
+        for (uint i=0; i < mNbIslands; i++) {
+            mTotalNbVelocitySolverIterations += mIslands[i]->getNbDoneVelocitySolverIterations();
+        }
+
+        mTimeStep = mLevelsTimeSteps[level];
+
+        if (mIsSleepingEnabled) updateSleepingBodies();
+
+        // Destroy the joints that have exceeded their break threshold (before the
+        // constraint solver is initialized with the islands of the next level)
+        destroyBrokenJoints();
+    }
+
+    mIslandsFirstIndex = 0;
+    mIslands = islands;
+    mNbIslands = nbIslands;
+
+    // Restore the mass of the sleeping bodies used as fixed bodies by the islands
+    restoreFixedSleepingBodies();
+
+    // Step the particles (they collide with the proxy shapes at their positions after the step)
+    const Vector3 particlesGravity = mIsGravityEnabled ? mGravity : Vector3::zero();
+    for (uint i=0; i < mParticleSystems.size(); i++) {
+        mParticleSystems[i]->update(mStepTimeStep, particlesGravity, getTaskScheduler());
+    }
+
+    // Rotate the wheels of the vehicles whose chassis is awake
+    for (uint i=0; i < mVehicles.size(); i++) {
+        const RigidBody* chassis = mVehicles[i]->getChassis();
+        if (chassis->isActive() && !chassis->isSleeping()) mVehicles[i]->updateWheelsRotation(mStepTimeStep);
+    }
+
+    mStepSolverTicks = Timer::getCurrentTicks();
+}
 
-    if (mIsSleepingEnabled) updateSleepingBodies();
+// Execute the last stage of a step
+/// The event listener is notified about the end of the step, the external forces are reset,
+/// the statistics of the step are computed and the single frame allocator is reset.
+void DynamicsWorld::executeEndOfStepStage() {
+
+    mTimeStep = mStepTimeStep;
 
     // Notify the event listener about the end of an internal tick
     if (mEventListener != nullptr) mEventListener->endInternalTick();
@@ -151,670 +491,2835 @@ void DynamicsWorld::update(decimal timeStep) {
     // Reset the external force and torque applied to the bodies
     resetBodiesForceAndTorque();
 
+    computeStepStatistics();
+    mStepStatistics.collisionDetectionTime = double(mStepCollisionDetectionTicks - mStepStartTicks) * 1.0e-9;
+    mStepStatistics.broadPhaseTime = mCollisionDetection.getBroadPhaseTime();
+    mStepStatistics.narrowPhaseTime = mCollisionDetection.getNarrowPhaseTime();
+    mStepStatistics.islandsTime = double(mStepIslandsTicks - mStepCollisionDetectionTicks) * 1.0e-9;
+    mStepStatistics.solverTime = double(mStepSolverTicks - mStepIslandsTicks) * 1.0e-9;
+    mStepStatistics.totalTime = double(Timer::getCurrentTicks() - mStepStartTicks) * 1.0e-9;
+
+#ifdef IS_ALLOCATION_CHECK_ACTIVE
+    mNbAllocationsLastUpdate = mMemoryManager.getNbAllocationsCurrentFrame() - mNbAllocationsBeforeUpdate;
+#endif
+
     // Reset the single frame memory allocator
     mMemoryManager.resetFrameAllocator();
+
+#ifdef IS_ALLOCATION_CHECK_ACTIVE
+    mNbHeapAllocationsLastUpdate = DefaultAllocator::getNbAllocations() - mNbHeapAllocationsBeforeUpdate;
+    checkUpdateAllocations();
+#endif
 }
 
-// Integrate position and orientation of the rigid bodies.
-/// The positions and orientations of the bodies are integrated using
-/// the sympletic Euler time stepping scheme.
-void DynamicsWorld::integrateRigidBodiesPositions() {
+#ifdef IS_ALLOCATION_CHECK_ACTIVE
 
-    RP3D_PROFILE("DynamicsWorld::integrateRigidBodiesPositions()", mProfiler);
-    
-    // For each island of the world
-    for (uint i=0; i < mNbIslands; i++) {
+// Check the memory allocations of the last step
+void DynamicsWorld::checkUpdateAllocations() {
 
-        RigidBody** bodies = mIslands[i]->getBodies();
+    if (mAllocationCheckMode == AllocationCheckMode::DISABLED) return;
+    if (mNbAllocationsLastUpdate == 0 && mNbHeapAllocationsLastUpdate == 0) return;
 
-        // For each body of the island
-        for (uint b=0; b < mIslands[i]->getNbBodies(); b++) {
+    mNbAllocatingUpdates++;
 
-            // Get the constrained velocity
-            uint indexArray = bodies[b]->mArrayIndex;
-            Vector3 newLinVelocity = mConstrainedLinearVelocities[indexArray];
-            Vector3 newAngVelocity = mConstrainedAngularVelocities[indexArray];
+    RP3D_LOG(mLogger, Logger::Level::Warning, Logger::Category::World,
+             "Dynamics World: The step has done " + std::to_string(mNbAllocationsLastUpdate) +
+             " allocations and " + std::to_string(mNbHeapAllocationsLastUpdate) + " heap allocations");
 
-            // Add the split impulse velocity from Contact Solver (only used
-            // to update the position)
-            if (mContactSolver.isSplitImpulseActive()) {
+    assert(mAllocationCheckMode != AllocationCheckMode::ASSERT && "A step of a steady state has allocated memory");
+}
 
-                newLinVelocity += mSplitLinearVelocities[indexArray];
-                newAngVelocity += mSplitAngularVelocities[indexArray];
-            }
+#endif
+
+// Start to update the physics simulation in a job of the task scheduler
+/// The step is submitted with TaskScheduler::startJob() to the task scheduler of the
+/// world and this method returns without waiting for it. If the world has no task
+/// scheduler, the step is executed before this method returns. Before the step starts,
+/// the transform and velocities of every rigid body are copied into a snapshot that can
+/// be read with RigidBody::getSnapshotTransform() (and the other snapshot getters) while
+/// the step is running. Until waitUpdate() has been called, no other method of the world
+/// or of its bodies and joints must be called. The other worlds can be used and updated
+/// during that time.
+/**
+ * @param timeStep The amount of time to step the simulation by (in seconds)
+ * @param nbSubsteps Number of substeps used to solve the constraints
+ */
+void DynamicsWorld::startUpdate(decimal timeStep, uint nbSubsteps) {
 
-            // Get current position and orientation of the body
-            const Vector3& currentPosition = bodies[b]->mCenterOfMassWorld;
-            const Quaternion& currentOrientation = bodies[b]->getTransform().getOrientation();
+    assert(!mIsUpdateRunning);
 
-            // Update the new constrained position and orientation of the body
-            mConstrainedPositions[indexArray] = currentPosition + newLinVelocity * mTimeStep;
-            mConstrainedOrientations[indexArray] = currentOrientation +
-                                                   Quaternion(0, newAngVelocity) *
-                                                   currentOrientation * decimal(0.5) * mTimeStep;
-        }
+    // Sort the states of the bodies before the snapshot because the snapshot getters of
+    // the bodies read their state index while the step is running
+    updateSpatialSort();
+
+    // Take the snapshot of the state of the bodies at the end of the previous step
+    mRigidBodyStates.takeSnapshot();
+
+    // Copy the proxy shapes for the queries that run during the step
+    if (mConfig.isQuerySnapshotUpdatedByStartUpdate) updateQuerySnapshot();
+
+    mIsUpdateRunning = true;
+
+    TaskScheduler* taskScheduler = getTaskScheduler();
+    if (taskScheduler != nullptr) {
+        mUpdateJobId = taskScheduler->startJob([this, timeStep, nbSubsteps]() {
+            update(timeStep, nbSubsteps);
+        });
+    }
+    else {
+        update(timeStep, nbSubsteps);
     }
 }
 
-// Update the postion/orientation of the bodies
-void DynamicsWorld::updateBodiesState() {
+// Wait until the update started with startUpdate() is finished
+void DynamicsWorld::waitUpdate() {
 
-    RP3D_PROFILE("DynamicsWorld::updateBodiesState()", mProfiler);
+    assert(mIsUpdateRunning);
 
-    // For each island of the world
-    for (uint islandIndex = 0; islandIndex < mNbIslands; islandIndex++) {
+    TaskScheduler* taskScheduler = getTaskScheduler();
+    if (taskScheduler != nullptr) {
+        taskScheduler->waitJob(mUpdateJobId);
+    }
+    mIsUpdateRunning = false;
+}
 
-        // For each body of the island
-        RigidBody** bodies = mIslands[islandIndex]->getBodies();
+// Integrate position and orientation of the rigid bodies of an island.
+/// The positions and orientations of the bodies are integrated using
+/// the sympletic Euler time stepping scheme.
+/**
+ * @param island Pointer to the island
+ */
+void DynamicsWorld::integrateRigidBodiesPositions(Island* island) {
 
-        for (uint b=0; b < mIslands[islandIndex]->getNbBodies(); b++) {
+    integrateRigidBodiesPositions(island->mBodiesFirstArrayIndex,
+                                  island->mBodiesFirstArrayIndex + island->getNbBodies());
 
-            uint index = bodies[b]->mArrayIndex;
+    // Normalize the integrated orientations of the island (they are otherwise
+    // normalized exactly by updateBodiesState())
+    if (mIsOrientationNormalizationApproximate) {
+        normalizeConstrainedOrientations(island);
+    }
+}
 
-            // Update the linear and angular velocity of the body
-            bodies[b]->mLinearVelocity = mConstrainedLinearVelocities[index];
-            bodies[b]->mAngularVelocity = mConstrainedAngularVelocities[index];
+// Integrate the positions and orientations of a range of entries of the velocity arrays
+/// The entries of the velocity arrays are independent and different ranges can be
+/// integrated concurrently (the entries of the bodies of an island are contiguous).
+/**
+ * @param startIndex Index of the first entry of the range in the velocity arrays
+ * @param endIndex Index of the end of the range (excluded)
+ */
+void DynamicsWorld::integrateRigidBodiesPositions(uint startIndex, uint endIndex) {
 
-            // Update the position of the center of mass of the body
-            bodies[b]->mCenterOfMassWorld = mConstrainedPositions[index];
+    for (uint indexArray = startIndex; indexArray < endIndex; indexArray++) {
 
-            // Update the orientation of the body
-            bodies[b]->mTransform.setOrientation(mConstrainedOrientations[index].getUnit());
+        const RigidBody* body = mArrayBodies[indexArray];
 
-            // Update the transform of the body (using the new center of mass and new orientation)
-            bodies[b]->updateTransformWithCenterOfMass();
+        // Get the constrained velocity of the entry
+        Vector3 newLinVelocity = mConstrainedLinearVelocities[indexArray];
+        Vector3 newAngVelocity = mConstrainedAngularVelocities[indexArray];
 
-            // Update the world inverse inertia tensor of the body
-            bodies[b]->updateInertiaTensorInverseWorld();
+        // Add the split impulse velocity from Contact Solver (only used
+        // to update the position)
+        if (mContactSolver.isSplitImpulseActive()) {
 
-            // Update the broad-phase state of the body
-            bodies[b]->updateBroadPhaseState();
+            newLinVelocity += mSplitLinearVelocities[indexArray];
+            newAngVelocity += mSplitAngularVelocities[indexArray];
         }
+
+        // Get current position and orientation of the body
+        const Vector3& currentPosition = mRigidBodyStates.mCentersOfMassWorld[body->mStateIndex];
+        const Quaternion& currentOrientation = body->getTransform().getOrientation();
+
+        // Update the new constrained position and orientation of the body
+        mConstrainedPositions[indexArray] = currentPosition + newLinVelocity * mTimeStep;
+        mConstrainedOrientations[indexArray] = currentOrientation +
+                                               Quaternion(0, newAngVelocity) *
+                                               currentOrientation * decimal(0.5) * mTimeStep;
     }
 }
 
-// Initialize the bodies velocities arrays for the next simulation step.
-void DynamicsWorld::initVelocityArrays() {
+// Approximately normalize the integrated orientations of the bodies of an island
+/// The constrained orientations of an island are contiguous and are normalized
+/// NB_ORIENTATION_LANES at once. The orientations of the bodies that do not rotate are
+/// left untouched so that updateBodiesState() still sees that these bodies have not moved.
+/**
+ * @param island Pointer to the island
+ */
+void DynamicsWorld::normalizeConstrainedOrientations(Island* island) {
 
-    RP3D_PROFILE("DynamicsWorld::initVelocityArrays()", mProfiler);
+    using OrientationLanes = QuaternionLanes<decimal, NB_ORIENTATION_LANES>;
+    using VelocityLanes = Vector3Lanes<decimal, NB_ORIENTATION_LANES>;
 
-    // Allocate memory for the bodies velocity arrays
-    uint nbBodies = mRigidBodies.size();
+    const uint firstIndex = island->mBodiesFirstArrayIndex;
+    const uint endIndex = firstIndex + island->getNbBodies();
+    const bool isSplitImpulseActive = mContactSolver.isSplitImpulseActive();
+    const Lanes<decimal, NB_ORIENTATION_LANES> zero(decimal(0.0));
 
-    mSplitLinearVelocities = static_cast<Vector3*>(mMemoryManager.allocate(MemoryManager::AllocationType::Frame,
-                                                                           nbBodies * sizeof(Vector3)));
-    mSplitAngularVelocities = static_cast<Vector3*>(mMemoryManager.allocate(MemoryManager::AllocationType::Frame,
-                                                                            nbBodies * sizeof(Vector3)));
-    mConstrainedLinearVelocities = static_cast<Vector3*>(mMemoryManager.allocate(MemoryManager::AllocationType::Frame,
-                                                                                 nbBodies * sizeof(Vector3)));
-    mConstrainedAngularVelocities = static_cast<Vector3*>(mMemoryManager.allocate(MemoryManager::AllocationType::Frame,
-                                                                                  nbBodies * sizeof(Vector3)));
-    mConstrainedPositions = static_cast<Vector3*>(mMemoryManager.allocate(MemoryManager::AllocationType::Frame,
-                                                                          nbBodies * sizeof(Vector3)));
-    mConstrainedOrientations = static_cast<Quaternion*>(mMemoryManager.allocate(MemoryManager::AllocationType::Frame,
-                                                                                nbBodies * sizeof(Quaternion)));
-    assert(mSplitLinearVelocities != nullptr);
-    assert(mSplitAngularVelocities != nullptr);
-    assert(mConstrainedLinearVelocities != nullptr);
-    assert(mConstrainedAngularVelocities != nullptr);
-    assert(mConstrainedPositions != nullptr);
-    assert(mConstrainedOrientations != nullptr);
+    uint index = firstIndex;
+    for (; index + NB_ORIENTATION_LANES <= endIndex; index += NB_ORIENTATION_LANES) {
+
+        VelocityLanes angularVelocities = VelocityLanes::load(mConstrainedAngularVelocities + index);
+        if (isSplitImpulseActive) angularVelocities += VelocityLanes::load(mSplitAngularVelocities + index);
+        const LaneMask<NB_ORIENTATION_LANES> isRotating = angularVelocities.lengthSquare() > zero;
 
-    // Initialize the map of body indexes in the velocity arrays
-    uint i = 0;
-    for (List<RigidBody*>::Iterator it = mRigidBodies.begin(); it != mRigidBodies.end(); ++it) {
+        const OrientationLanes orientations = OrientationLanes::load(mConstrainedOrientations + index);
+        const OrientationLanes unitOrientations = orientations.getApproximateUnit();
+        OrientationLanes(select(isRotating, unitOrientations.x, orientations.x),
+                         select(isRotating, unitOrientations.y, orientations.y),
+                         select(isRotating, unitOrientations.z, orientations.z),
+                         select(isRotating, unitOrientations.w, orientations.w)).store(mConstrainedOrientations + index);
+    }
 
-        mSplitLinearVelocities[i].setToZero();
-        mSplitAngularVelocities[i].setToZero();
+    // Remaining orientations
+    for (; index < endIndex; index++) {
 
-        (*it)->mArrayIndex = i++;
+        Vector3 angularVelocity = mConstrainedAngularVelocities[index];
+        if (isSplitImpulseActive) angularVelocity += mSplitAngularVelocities[index];
+        if (angularVelocity.lengthSquare() > decimal(0.0)) {
+            mConstrainedOrientations[index] = mConstrainedOrientations[index].getApproximateUnit();
+        }
     }
 }
 
-// Integrate the velocities of rigid bodies.
-/// This method only set the temporary velocities but does not update
-/// the actual velocitiy of the bodies. The velocities updated in this method
-/// might violate the constraints and will be corrected in the constraint and
-/// contact solver.
-void DynamicsWorld::integrateRigidBodiesVelocities() {
+// Update the postion/orientation of the bodies of an island
+/**
+ * @param island Pointer to the island
+ * @param updateBroadPhase True if the broad-phase state of the bodies must also be updated
+ */
+void DynamicsWorld::updateBodiesState(Island* island, bool updateBroadPhase) {
 
-    RP3D_PROFILE("DynamicsWorld::integrateRigidBodiesVelocities()", mProfiler);
+    // For each body of the island
+    RigidBody** bodies = island->getBodies();
 
-    // Initialize the bodies velocity arrays
-    initVelocityArrays();
+    for (uint b=0; b < island->getNbBodies(); b++) {
 
-    // For each island of the world
-    for (uint i=0; i < mNbIslands; i++) {
+        // The static bodies (and the sleeping bodies used as fixed bodies) do not move
+        // and can be shared by several islands
+        if (bodies[b]->getType() == BodyType::STATIC || bodies[b]->isSleeping()) continue;
 
-        RigidBody** bodies = mIslands[i]->getBodies();
+        uint index = bodies[b]->mArrayIndex;
+        uint stateIndex = bodies[b]->mStateIndex;
 
-        // For each body of the island
-        for (uint b=0; b < mIslands[i]->getNbBodies(); b++) {
+        // Update the linear and angular velocity of the body
+        mRigidBodyStates.mLinearVelocities[stateIndex] = mConstrainedLinearVelocities[index];
+        mRigidBodyStates.mAngularVelocities[stateIndex] = mConstrainedAngularVelocities[index];
 
-            // Insert the body into the map of constrained velocities
-            uint indexBody = bodies[b]->mArrayIndex;
+        // If the body has moved
+        if (mConstrainedPositions[index] != mRigidBodyStates.mCentersOfMassWorld[stateIndex] ||
+            !(mConstrainedOrientations[index] == bodies[b]->mTransform.getOrientation())) {
 
-            assert(mSplitLinearVelocities[indexBody] == Vector3(0, 0, 0));
-            assert(mSplitAngularVelocities[indexBody] == Vector3(0, 0, 0));
+            // Update the position of the center of mass of the body
+            mRigidBodyStates.mCentersOfMassWorld[stateIndex] = mConstrainedPositions[index];
 
-            // Integrate the external force to get the new velocity of the body
-            mConstrainedLinearVelocities[indexBody] = bodies[b]->getLinearVelocity() +
-                                        mTimeStep * bodies[b]->mMassInverse * bodies[b]->mExternalForce;
-            mConstrainedAngularVelocities[indexBody] = bodies[b]->getAngularVelocity() +
-                                        mTimeStep * bodies[b]->getInertiaTensorInverseWorld() *
-                                        bodies[b]->mExternalTorque;
+            // Update the orientation of the body (the orientation has already been
+            // normalized if the approximate normalization is used)
+            bodies[b]->mTransform.setOrientation(mIsOrientationNormalizationApproximate ?
+                                                 mConstrainedOrientations[index] :
+                                                 mConstrainedOrientations[index].getUnit());
 
-            // If the gravity has to be applied to this rigid body
-            if (bodies[b]->isGravityEnabled() && mIsGravityEnabled) {
+            // Update the transform of the body (using the new center of mass and new orientation)
+            bodies[b]->updateTransformWithCenterOfMass();
 
-                // Integrate the gravity force
-                mConstrainedLinearVelocities[indexBody] += mTimeStep * bodies[b]->mMassInverse *
-                        bodies[b]->getMass() * mGravity;
-            }
+            // Update the world inverse inertia tensor of the body
+            bodies[b]->updateInertiaTensorInverseWorld();
 
-            // Apply the velocity damping
-            // Damping force : F_c = -c' * v (c=damping factor)
-            // Equation      : m * dv/dt = -c' * v
-            //                 => dv/dt = -c * v (with c=c'/m)
-            //                 => dv/dt + c * v = 0
-            // Solution      : v(t) = v0 * e^(-c * t)
-            //                 => v(t + dt) = v0 * e^(-c(t + dt))
-            //                              = v0 * e^(-ct) * e^(-c * dt)
-            //                              = v(t) * e^(-c * dt)
-            //                 => v2 = v1 * e^(-c * dt)
-            // Using Taylor Serie for e^(-x) : e^x ~ 1 + x + x^2/2! + ...
-            //                              => e^(-x) ~ 1 - x
-            //                 => v2 = v1 * (1 - c * dt)
-            decimal linDampingFactor = bodies[b]->getLinearDamping();
-            decimal angDampingFactor = bodies[b]->getAngularDamping();
-            decimal linearDamping = pow(decimal(1.0) - linDampingFactor, mTimeStep);
-            decimal angularDamping = pow(decimal(1.0) - angDampingFactor, mTimeStep);
-            mConstrainedLinearVelocities[indexBody] *= linearDamping;
-            mConstrainedAngularVelocities[indexBody] *= angularDamping;
+            bodies[b]->mIsTransformDirty = true;
+        }
 
-            indexBody++;
+        // Update the broad-phase state of the body if it has moved
+        if (updateBroadPhase && bodies[b]->mIsTransformDirty) {
+            bodies[b]->updateBroadPhaseState();
+            bodies[b]->mIsTransformDirty = false;
         }
     }
 }
 
-// Solve the contacts and constraints
-void DynamicsWorld::solveContactsAndConstraints() {
+// Integrate the positions and orientations and update the state of the bodies of an island
+/// This is the same as integrateRigidBodiesPositions() followed by updateBodiesState() but
+/// the bodies are only visited once. It can only be used for an island without joints
+/// because the position error correction of the joints needs to run between the two.
+/**
+ * @param island Pointer to the island
+ * @param updateBroadPhase True if the broad-phase state of the bodies must also be updated
+ */
+void DynamicsWorld::integrateAndUpdateBodiesState(Island* island, bool updateBroadPhase) {
 
-    RP3D_PROFILE("DynamicsWorld::solveContactsAndConstraints()", mProfiler);
+    assert(island->getNbJoints() == 0);
 
-    // Set the velocities arrays
-    mContactSolver.setSplitVelocitiesArrays(mSplitLinearVelocities, mSplitAngularVelocities);
-    mContactSolver.setConstrainedVelocitiesArrays(mConstrainedLinearVelocities,
-                                                  mConstrainedAngularVelocities);
-    mConstraintSolver.setConstrainedVelocitiesArrays(mConstrainedLinearVelocities,
-                                                     mConstrainedAngularVelocities);
-    mConstraintSolver.setConstrainedPositionsArrays(mConstrainedPositions,
-                                                    mConstrainedOrientations);
+    RigidBody** bodies = island->getBodies();
+    const bool isSplitImpulseActive = mContactSolver.isSplitImpulseActive();
+    const decimal halfTimeStep = decimal(0.5) * mTimeStep;
 
-    // ---------- Solve velocity constraints for joints and contacts ---------- //
+    // For each body of the island
+    for (uint b=0; b < island->getNbBodies(); b++) {
 
-    // Initialize the contact solver
-    mContactSolver.init(mIslands, mNbIslands, mTimeStep);
+        // The static bodies (and the sleeping bodies used as fixed bodies) do not move
+        // and can be shared by several islands
+        if (bodies[b]->getType() == BodyType::STATIC || bodies[b]->isSleeping()) continue;
 
-    // For each island of the world
-    for (uint islandIndex = 0; islandIndex < mNbIslands; islandIndex++) {
+        const uint index = bodies[b]->mArrayIndex;
+        const uint stateIndex = bodies[b]->mStateIndex;
 
-        // If there are constraints to solve
-        if (mIslands[islandIndex]->getNbJoints() > 0) {
+        // Get the constrained velocity
+        const Vector3& linearVelocity = mConstrainedLinearVelocities[index];
+        const Vector3& angularVelocity = mConstrainedAngularVelocities[index];
 
-            // Initialize the constraint solver
-            mConstraintSolver.initializeForIsland(mTimeStep, mIslands[islandIndex]);
+        // Add the split impulse velocity from Contact Solver (only used
+        // to update the position)
+        Vector3 newLinVelocity = linearVelocity;
+        Vector3 newAngVelocity = angularVelocity;
+        if (isSplitImpulseActive) {
+            newLinVelocity += mSplitLinearVelocities[index];
+            newAngVelocity += mSplitAngularVelocities[index];
         }
-    }
 
-    // For each iteration of the velocity solver
-    for (uint i=0; i<mNbVelocitySolverIterations; i++) {
+        // Update the linear and angular velocity of the body
+        mRigidBodyStates.mLinearVelocities[stateIndex] = linearVelocity;
+        mRigidBodyStates.mAngularVelocities[stateIndex] = angularVelocity;
 
-        for (uint islandIndex = 0; islandIndex < mNbIslands; islandIndex++) {
+        // If the body moves (a kinematic body for instance might not move)
+        if (newLinVelocity != Vector3::zero() || newAngVelocity != Vector3::zero()) {
 
-            // Solve the constraints
-            if (mIslands[islandIndex]->getNbJoints() > 0) {
+            // Integrate the position of the center of mass of the body
+            mRigidBodyStates.mCentersOfMassWorld[stateIndex] += newLinVelocity * mTimeStep;
 
-                mConstraintSolver.solveVelocityConstraints(mIslands[islandIndex]);
-            }
+            // Integrate the orientation of the body
+            const Quaternion& currentOrientation = bodies[b]->mTransform.getOrientation();
+            const Quaternion newOrientation = currentOrientation + Quaternion(0, newAngVelocity) *
+                                              currentOrientation * halfTimeStep;
+            bodies[b]->mTransform.setOrientation(mIsOrientationNormalizationApproximate ?
+                                                 newOrientation.getApproximateUnit() :
+                                                 newOrientation.getUnit());
+
+            // Update the transform of the body (using the new center of mass and new orientation)
+            bodies[b]->updateTransformWithCenterOfMass();
+
+            // Update the world inverse inertia tensor of the body
+            bodies[b]->updateInertiaTensorInverseWorld();
+
+            bodies[b]->mIsTransformDirty = true;
         }
 
-        mContactSolver.solve();
+        // Update the broad-phase state of the body if it has moved
+        if (updateBroadPhase && bodies[b]->mIsTransformDirty) {
+            bodies[b]->updateBroadPhaseState();
+            bodies[b]->mIsTransformDirty = false;
+        }
     }
-
-    mContactSolver.storeImpulses();
 }
 
-// Solve the position error correction of the constraints
-void DynamicsWorld::solvePositionCorrection() {
+// Update the broad-phase state of the bodies of the islands
+/// This is done after the islands have been solved because the broad-phase is shared by
+/// all the bodies of the world. The proxy shapes of the moved bodies are first gathered and
+/// their new AABBs are computed (in parallel ranges if a task scheduler has been set). The
+/// broad-phase is then updated with all the moved shapes in a single batch so that the
+/// shapes that have left their fat AABB are reinserted together.
+void DynamicsWorld::updateBodiesBroadPhaseState() {
+
+    RP3D_PROFILE("DynamicsWorld::updateBodiesBroadPhaseState()", mProfiler);
+
+    // Count the proxy shapes of the bodies that have been moved by the integration
+    uint nbShapes = 0;
+    for (uint islandIndex = 0; islandIndex < mNbIslands; islandIndex++) {
+
+        RigidBody** bodies = mIslands[islandIndex]->getBodies();
+        for (uint b=0; b < mIslands[islandIndex]->getNbBodies(); b++) {
+            if (bodies[b]->mIsTransformDirty) nbShapes += bodies[b]->mNbCollisionShapes;
+        }
+    }
+
+    if (nbShapes == 0) return;
 
-    RP3D_PROFILE("DynamicsWorld::solvePositionCorrection()", mProfiler);
+    // Gather the proxy shapes of the moved bodies (a static body can be in several islands
+    // but its dirty flag is cleared the first time it is visited)
+    ProxyShapeUpdate* updates = static_cast<ProxyShapeUpdate*>(
+                mMemoryManager.allocate(MemoryManager::AllocationType::Frame,
+                                        sizeof(ProxyShapeUpdate) * nbShapes, MemoryTag::BroadPhase));
+    uint nbUpdates = 0;
+    for (uint islandIndex = 0; islandIndex < mNbIslands; islandIndex++) {
+
+        RigidBody** bodies = mIslands[islandIndex]->getBodies();
+        for (uint b=0; b < mIslands[islandIndex]->getNbBodies(); b++) {
 
-    // Do not continue if there is no constraints
-    if (mJoints.size() == 0) return;
+            if (!bodies[b]->mIsTransformDirty) continue;
+
+            const Vector3 displacement = mTimeStep * mRigidBodyStates.mLinearVelocities[bodies[b]->mStateIndex];
+
+            // The fat AABB of a bullet body is always recomputed so that it covers its
+            // motion during the next step
+            for (ProxyShape* shape = bodies[b]->getProxyShapesList(); shape != nullptr; shape = shape->getNext()) {
+                ProxyShapeUpdate& update = updates[nbUpdates];
+                update.proxyShape = shape;
+                update.displacement = displacement;
+                update.forceReinsert = bodies[b]->mIsBullet;
+                nbUpdates++;
+            }
+
+            bodies[b]->mIsTransformDirty = false;
+        }
+    }
+
+    assert(nbUpdates == nbShapes);
+
+    // Compute the world-space AABBs of the moved shapes
+    TaskScheduler* taskScheduler = getTaskScheduler();
+    if (taskScheduler != nullptr && nbUpdates >= 2 * MIN_NB_SHAPES_PER_AABB_TASK) {
+
+        taskScheduler->parallelForRange(nbUpdates, MIN_NB_SHAPES_PER_AABB_TASK,
+                                        [updates](uint begin, uint end) {
+            computeProxyShapesAABBs(updates, begin, end);
+        });
+    }
+    else {
+        computeProxyShapesAABBs(updates, 0, nbUpdates);
+    }
+
+    // Update the broad-phase with all the moved shapes
+    mCollisionDetection.updateProxyCollisionShapes(updates, nbUpdates);
+
+    mMemoryManager.release(MemoryManager::AllocationType::Frame, updates,
+                           sizeof(ProxyShapeUpdate) * nbShapes, MemoryTag::BroadPhase);
+}
+
+// Compute the world-space AABBs of a range of moved proxy shapes
+/**
+ * @param updates Array with the moved proxy shapes
+ * @param startIndex Index of the first proxy shape of the range
+ * @param endIndex Index after the last proxy shape of the range
+ */
+void DynamicsWorld::computeProxyShapesAABBs(ProxyShapeUpdate* updates, uint startIndex, uint endIndex) {
+
+    for (uint i = startIndex; i < endIndex; i++) {
+        const ProxyShape* shape = updates[i].proxyShape;
+        shape->getCollisionShape()->computeAABB(updates[i].aabb, shape->getLocalToWorldTransform());
+    }
+}
+
+// Initialize the bodies velocities arrays for the next simulation step.
+/// Each body of an island has its own entry in the arrays. Because a static body
+/// can be part of several islands, it has a different entry for each of its
+/// islands so that the islands never share any entry and can be solved in parallel.
+void DynamicsWorld::initVelocityArrays() {
+
+    RP3D_PROFILE("DynamicsWorld::initVelocityArrays()", mProfiler);
+
+    // Compute the number of entries of the arrays
+    uint nbBodies = 0;
+    for (uint i=0; i < mNbIslands; i++) {
+        nbBodies += mIslands[i]->getNbBodies();
+    }
+
+    // Allocate memory for the bodies velocity arrays
+    mSplitLinearVelocities = static_cast<Vector3*>(mMemoryManager.allocate(MemoryManager::AllocationType::Frame,
+                                                                           nbBodies * sizeof(Vector3), MemoryTag::Solver));
+    mSplitAngularVelocities = static_cast<Vector3*>(mMemoryManager.allocate(MemoryManager::AllocationType::Frame,
+                                                                            nbBodies * sizeof(Vector3), MemoryTag::Solver));
+    mConstrainedLinearVelocities = static_cast<Vector3*>(mMemoryManager.allocate(MemoryManager::AllocationType::Frame,
+                                                                                 nbBodies * sizeof(Vector3), MemoryTag::Solver));
+    mConstrainedAngularVelocities = static_cast<Vector3*>(mMemoryManager.allocate(MemoryManager::AllocationType::Frame,
+                                                                                  nbBodies * sizeof(Vector3), MemoryTag::Solver));
+    mConstrainedPositions = static_cast<Vector3*>(mMemoryManager.allocate(MemoryManager::AllocationType::Frame,
+                                                                          nbBodies * sizeof(Vector3), MemoryTag::Solver));
+    mConstrainedOrientations = static_cast<Quaternion*>(mMemoryManager.allocate(MemoryManager::AllocationType::Frame,
+                                                                                nbBodies * sizeof(Quaternion), MemoryTag::Solver));
+    mArrayBodies = static_cast<RigidBody**>(mMemoryManager.allocate(MemoryManager::AllocationType::Frame,
+                                                                    nbBodies * sizeof(RigidBody*), MemoryTag::Solver));
+    assert(mSplitLinearVelocities != nullptr);
+    assert(mSplitAngularVelocities != nullptr);
+    assert(mConstrainedLinearVelocities != nullptr);
+    assert(mConstrainedAngularVelocities != nullptr);
+    assert(mConstrainedPositions != nullptr);
+    assert(mConstrainedOrientations != nullptr);
+    assert(mArrayBodies != nullptr);
+}
+
+// Integrate the velocities of all the entries of the velocity arrays
+/// This method only set the temporary velocities but does not update
+/// the actual velocitiy of the bodies. The velocities updated in this method
+/// might violate the constraints and will be corrected in the constraint and
+/// contact solver. The entries are independent and are integrated in parallel
+/// ranges if a task scheduler has been set.
+/**
+ * @param nbArrayBodies Number of entries in the velocity arrays
+ */
+void DynamicsWorld::integrateRigidBodiesVelocities(uint nbArrayBodies) {
+
+    RP3D_PROFILE("DynamicsWorld::integrateRigidBodiesVelocities()", mProfiler);
+
+    TaskScheduler* taskScheduler = getTaskScheduler();
+    if (taskScheduler != nullptr && nbArrayBodies >= 2 * MIN_NB_BODIES_PER_INTEGRATION_TASK) {
+
+        taskScheduler->parallelForRange(nbArrayBodies, MIN_NB_BODIES_PER_INTEGRATION_TASK,
+                                        [this](uint begin, uint end) {
+            integrateRigidBodiesVelocities(begin, end);
+        });
+    }
+    else {
+        integrateRigidBodiesVelocities(0, nbArrayBodies);
+    }
+}
+
+// Integrate the velocities of a range of entries of the velocity arrays
+/// The entries are processed by groups of NB_INTEGRATION_LANES lanes. The gravity and
+/// damping factors of each lane are computed first and the velocities of the group are
+/// then integrated together.
+/**
+ * @param startIndex Index of the first entry of the range in the velocity arrays
+ * @param endIndex Index of the end of the range (excluded)
+ */
+void DynamicsWorld::integrateRigidBodiesVelocities(uint startIndex, uint endIndex) {
+
+    using DecimalLanes = Lanes<decimal, NB_INTEGRATION_LANES>;
+    using VelocityLanes = Vector3Lanes<decimal, NB_INTEGRATION_LANES>;
+
+    const VelocityLanes gravity(mIsGravityEnabled ? mGravity : Vector3::zero());
+
+    for (uint index = startIndex; index < endIndex; index += NB_INTEGRATION_LANES) {
+
+        const uint nbLanes = std::min(uint(NB_INTEGRATION_LANES), endIndex - index);
+
+        uint stateIndices[NB_INTEGRATION_LANES];
+        DecimalLanes massInverseTimeStep;
+        DecimalLanes gravityFactor;
+        DecimalLanes linearDamping;
+        DecimalLanes angularDamping;
+        VelocityLanes angularVelocityChanges;
+
+        // Gather the data of each lane (the unused lanes of the last group repeat the first entry)
+        for (uint l=0; l < NB_INTEGRATION_LANES; l++) {
+
+            const RigidBody* body = mArrayBodies[index + (l < nbLanes ? l : 0)];
+            const uint stateIndex = body->mStateIndex;
+            stateIndices[l] = stateIndex;
+
+            massInverseTimeStep.values[l] = mTimeStep * body->mMassInverse;
+            gravityFactor.values[l] = body->isGravityEnabled() ?
+                                      massInverseTimeStep.values[l] * body->getMass() : decimal(0.0);
+
+            // Apply the velocity damping
+            // Damping force : F_c = -c' * v (c=damping factor)
+            // Equation      : m * dv/dt = -c' * v
+            //                 => dv/dt = -c * v (with c=c'/m)
+            //                 => dv/dt + c * v = 0
+            // Solution      : v(t) = v0 * e^(-c * t)
+            //                 => v(t + dt) = v0 * e^(-c(t + dt))
+            //                              = v0 * e^(-ct) * e^(-c * dt)
+            //                              = v(t) * e^(-c * dt)
+            //                 => v2 = v1 * e^(-c * dt)
+            // Using Taylor Serie for e^(-x) : e^x ~ 1 + x + x^2/2! + ...
+            //                              => e^(-x) ~ 1 - x
+            //                 => v2 = v1 * (1 - c * dt)
+            const decimal linDampingFactor = body->getLinearDamping();
+            const decimal angDampingFactor = body->getAngularDamping();
+            linearDamping.values[l] = linDampingFactor > decimal(0.0) ?
+                                      pow(decimal(1.0) - linDampingFactor, mTimeStep) : decimal(1.0);
+            angularDamping.values[l] = angDampingFactor > decimal(0.0) ?
+                                       pow(decimal(1.0) - angDampingFactor, mTimeStep) : decimal(1.0);
+
+            angularVelocityChanges.setLane(l, mTimeStep * mRigidBodyStates.mInertiaTensorsInverseWorld[stateIndex] *
+                                              mRigidBodyStates.mExternalTorques[stateIndex]);
+        }
+
+        // Integrate the external forces, the gravity and the damping
+        VelocityLanes linearVelocities = VelocityLanes::gather(mRigidBodyStates.mLinearVelocities, stateIndices) +
+                                         massInverseTimeStep *
+                                         VelocityLanes::gather(mRigidBodyStates.mExternalForces, stateIndices);
+        linearVelocities += gravityFactor * gravity;
+        linearVelocities = linearDamping * linearVelocities;
+        const VelocityLanes angularVelocities = angularDamping *
+                (VelocityLanes::gather(mRigidBodyStates.mAngularVelocities, stateIndices) + angularVelocityChanges);
+
+        if (nbLanes == NB_INTEGRATION_LANES) {
+            linearVelocities.store(mConstrainedLinearVelocities + index);
+            angularVelocities.store(mConstrainedAngularVelocities + index);
+        }
+        else {
+            for (uint l=0; l < nbLanes; l++) {
+                mConstrainedLinearVelocities[index + l] = linearVelocities.getLane(l);
+                mConstrainedAngularVelocities[index + l] = angularVelocities.getLane(l);
+            }
+        }
+
+        for (uint l=0; l < nbLanes; l++) {
+            mSplitLinearVelocities[index + l].setToZero();
+            mSplitAngularVelocities[index + l].setToZero();
+        }
+    }
+}
+
+// Allocate the velocity arrays and the contact constraints of the islands
+void DynamicsWorld::initIslands() {
+
+    RP3D_PROFILE("DynamicsWorld::initIslands()", mProfiler);
+
+    // Initialize the bodies velocity arrays
+    initVelocityArrays();
+
+    // Choose the number of solver iterations of the islands
+    computeIslandsNbSolverIterations();
+
+    // Set the velocities arrays
+    mContactSolver.setSplitVelocitiesArrays(mSplitLinearVelocities, mSplitAngularVelocities);
+    mContactSolver.setConstrainedVelocitiesArrays(mConstrainedLinearVelocities,
+                                                  mConstrainedAngularVelocities);
+    mConstraintSolver.setConstrainedVelocitiesArrays(mConstrainedLinearVelocities,
+                                                     mConstrainedAngularVelocities);
+    mConstraintSolver.setConstrainedPositionsArrays(mConstrainedPositions,
+                                                    mConstrainedOrientations);
+
+    // The position based solver replaces the contact and the constraint solvers
+    if (mConfig.isPositionBasedSolverEnabled) {
+
+        uint nbBodies = 0;
+        for (uint i=0; i < mNbIslands; i++) {
+            nbBodies += mIslands[i]->getNbBodies();
+        }
+
+        mPositionBasedSolver.setBodiesArrays(mConstrainedLinearVelocities, mConstrainedAngularVelocities,
+                                             mConstrainedPositions, mConstrainedOrientations);
+        mPositionBasedSolver.init(mIslands, mNbIslands, nbBodies);
+        return;
+    }
+
+    // Allocate the contact constraints
+    mContactSolver.init(mIslands, mNbIslands, mTimeStep);
+    mConstraintSolver.init(mIslands, mNbIslands);
+
+    // Allocate the constraints of the wheels of the vehicles
+    if (mVehicles.size() > 0) {
+        computeVehiclesIslands();
+        mContactSolver.initWheels(mVehicles);
+    }
+}
+
+// Cast the rays of the wheels of all the vehicles with a batched query
+/// The rays of the wheels of the vehicles whose chassis is awake are cast together with
+/// CollisionDetection::raycastBatch() (one batch for each collision mask of the wheels,
+/// usually a single one) and the closest hit of each ray becomes the contact of its wheel.
+void DynamicsWorld::updateVehiclesWheels() {
+
+    RP3D_PROFILE("DynamicsWorld::updateVehiclesWheels()", mProfiler);
+
+    // A vehicle is done if its chassis is not simulated or if its rays have been cast
+    bool* isVehicleDone = static_cast<bool*>(mMemoryManager.allocate(MemoryManager::AllocationType::Frame,
+                                                                    sizeof(bool) * mVehicles.size(), MemoryTag::Solver));
+    uint nbMaxRays = 0;
+    for (uint v=0; v < mVehicles.size(); v++) {
+        const RigidBody* chassis = mVehicles[v]->getChassis();
+        isVehicleDone[v] = !chassis->isActive() || chassis->isSleeping();
+        if (!isVehicleDone[v]) nbMaxRays += mVehicles[v]->getNbWheels();
+    }
+
+    if (nbMaxRays == 0) return;
+
+    Ray* rays = static_cast<Ray*>(mMemoryManager.allocate(MemoryManager::AllocationType::Frame,
+                                                          sizeof(Ray) * nbMaxRays, MemoryTag::Solver));
+    RaycastHit* hits = static_cast<RaycastHit*>(mMemoryManager.allocate(MemoryManager::AllocationType::Frame,
+                                                                        sizeof(RaycastHit) * nbMaxRays, MemoryTag::Solver));
+
+    for (uint v=0; v < mVehicles.size(); v++) {
+
+        if (isVehicleDone[v]) continue;
+        const collisionmask maskBits = mVehicles[v]->getSettings().wheelsCollideWithMaskBits;
+
+        // Gather the rays of the vehicles with the same collision mask
+        uint nbRays = 0;
+        for (uint k=v; k < mVehicles.size(); k++) {
+            if (isVehicleDone[k] || mVehicles[k]->getSettings().wheelsCollideWithMaskBits != maskBits) continue;
+            for (uint w=0; w < mVehicles[k]->getNbWheels(); w++) {
+                new (rays + nbRays) Ray(mVehicles[k]->computeWheelRay(w));
+                new (hits + nbRays) RaycastHit();
+                nbRays++;
+            }
+        }
+
+        mCollisionDetection.raycastBatch(rays, nbRays, hits, maskBits);
+
+        // Update the contacts of the wheels (in the same order)
+        nbRays = 0;
+        for (uint k=v; k < mVehicles.size(); k++) {
+            if (isVehicleDone[k] || mVehicles[k]->getSettings().wheelsCollideWithMaskBits != maskBits) continue;
+            for (uint w=0; w < mVehicles[k]->getNbWheels(); w++) {
+                mVehicles[k]->updateWheelContact(w, hits[nbRays]);
+                nbRays++;
+            }
+            isVehicleDone[k] = true;
+        }
+    }
+}
+
+// Find the island of the chassis of each vehicle in the islands of the current level
+/// The islands are identified by the root of their persistent island. The island index of
+/// a vehicle whose chassis is not simulated at this level is Vehicle::NO_ISLAND.
+void DynamicsWorld::computeVehiclesIslands() {
+
+    RP3D_PROFILE("DynamicsWorld::computeVehiclesIslands()", mProfiler);
+
+    FlatMap<RigidBody*, uint> rootsIslands(mMemoryManager.getSingleFrameAllocator(MemoryTag::Solver), mNbIslands);
+    for (uint i=0; i < mNbIslands; i++) {
+        rootsIslands.add(Pair<RigidBody*, uint>(mIslands[i]->mPersistentIslandRoot, i));
+    }
+
+    for (uint v=0; v < mVehicles.size(); v++) {
+
+        Vehicle* vehicle = mVehicles[v];
+        vehicle->mIslandIndex = Vehicle::NO_ISLAND;
+
+        RigidBody* chassis = vehicle->getChassis();
+        if (chassis->getType() != BodyType::DYNAMIC || !chassis->isActive() || chassis->isSleeping()) continue;
+
+        auto it = rootsIslands.find(findIslandRoot(chassis));
+        if (it != rootsIslands.end()) vehicle->mIslandIndex = it->second;
+    }
+}
+
+// Compute the number of velocity and position solver iterations of each island
+/// Without a solver iterations policy, every island uses the number of iterations of
+/// the world divided by 2^L for its simulation level of detail L (at least one iteration).
+/// Otherwise, the policy is asked for the iterations of each island in order.
+void DynamicsWorld::computeIslandsNbSolverIterations() {
+
+    RP3D_PROFILE("DynamicsWorld::computeIslandsNbSolverIterations()", mProfiler);
+
+    for (uint i=0; i < mNbIslands; i++) {
+
+        Island* island = mIslands[i];
+        const uint level = island->mSimulationLevelOfDetail;
+        island->mNbVelocitySolverIterations = std::max(mNbVelocitySolverIterations >> level,
+                                                       std::min(mNbVelocitySolverIterations, 1u));
+        island->mNbPositionSolverIterations = std::max(mNbPositionSolverIterations >> level,
+                                                       std::min(mNbPositionSolverIterations, 1u));
+
+        if (mSolverIterationsPolicy == nullptr) continue;
+
+        IslandSolverInfo islandInfo;
+        islandInfo.islandIndex = mIslandsFirstIndex + i;
+        islandInfo.simulationLevelOfDetail = level;
+        islandInfo.nbBodies = island->getNbBodies();
+        islandInfo.nbContactManifolds = island->getNbContactManifolds();
+        islandInfo.nbJoints = island->getNbJoints();
+
+        islandInfo.nbContactPoints = 0;
+        for (uint m=0; m < island->getNbContactManifolds(); m++) {
+            islandInfo.nbContactPoints += island->getContactManifolds()[m]->getNbContactPoints();
+        }
+
+        // Compute the ratio between the largest and the smallest mass of the dynamic bodies
+        decimal minMass = DECIMAL_LARGEST;
+        decimal maxMass = decimal(0.0);
+        for (uint b=0; b < island->getNbBodies(); b++) {
+            const RigidBody* body = island->getBodies()[b];
+            if (body->getType() == BodyType::DYNAMIC) {
+                minMass = std::min(minMass, body->getMass());
+                maxMass = std::max(maxMass, body->getMass());
+            }
+        }
+        islandInfo.maxMassRatio = maxMass > decimal(0.0) ? maxMass / minMass : decimal(1.0);
+
+        mSolverIterationsPolicy->computeNbIterations(islandInfo, island->mNbVelocitySolverIterations,
+                                                     island->mNbPositionSolverIterations);
+    }
+}
+
+// Integrate the velocities and initialize the contacts and joints of the islands
+/// The velocities of all the bodies are integrated first (in parallel if a task scheduler
+/// has been set). The contacts and joints are then initialized sequentially because the
+/// entries of a static body in the velocity arrays depend on the island that is currently
+/// initialized.
+/**
+ * @param reprojectContacts True if the penetration depths of the contacts must be
+ *                          recomputed from the current positions (substeps after the first one)
+ */
+void DynamicsWorld::initIslandsConstraints(bool reprojectContacts) {
+
+    RP3D_PROFILE("DynamicsWorld::initIslandsConstraints()", mProfiler);
+
+    // Set the entries of the bodies of the islands in the velocity arrays
+    uint arrayIndex = 0;
+    for (uint islandIndex = 0; islandIndex < mNbIslands; islandIndex++) {
+
+        Island* island = mIslands[islandIndex];
+        RigidBody** bodies = island->getBodies();
+        island->mBodiesFirstArrayIndex = arrayIndex;
+        for (uint b=0; b < island->getNbBodies(); b++) {
+            mArrayBodies[arrayIndex] = bodies[b];
+            arrayIndex++;
+        }
+    }
+
+    // Integrate the velocities of all the entries (the contact constraints use them)
+    integrateRigidBodiesVelocities(arrayIndex);
+
+    // For each island of the world
+    for (uint islandIndex = 0; islandIndex < mNbIslands; islandIndex++) {
+
+        Island* island = mIslands[islandIndex];
+
+        // Set the index of the bodies of the island in the velocity arrays
+        RigidBody** bodies = island->getBodies();
+        for (uint b=0; b < island->getNbBodies(); b++) {
+            bodies[b]->mArrayIndex = island->mBodiesFirstArrayIndex + b;
+        }
+
+        // Initialize the contacts and joints of the position based solver
+        if (mConfig.isPositionBasedSolverEnabled) {
+            if (island->getNbContactManifolds() > 0 || island->getNbJoints() > 0) {
+                mPositionBasedSolver.initializeForIsland(islandIndex);
+            }
+            continue;
+        }
+
+        // Initialize the contact constraints
+        if (island->getNbContactManifolds() > 0) {
+            mContactSolver.initializeForIsland(islandIndex, reprojectContacts);
+        }
+
+        // Initialize the wheels constraints
+        if (mContactSolver.getNbWheels(islandIndex) > 0) {
+            mContactSolver.initializeWheelsForIsland(islandIndex);
+        }
+
+        // Initialize the joints constraints
+        if (island->getNbJoints() > 0) {
+            mConstraintSolver.initializeForIsland(mTimeStep, islandIndex);
+        }
+    }
+}
+
+// Solve the constraints and integrate the positions of all the islands
+/// If a task scheduler has been set in the world settings, each island is
+/// solved as a separate task. Otherwise, the islands are solved sequentially.
+/**
+ * @param updateBroadPhase True if the broad-phase state of the bodies must be updated
+ *                         together with their positions (only if solved sequentially)
+ */
+void DynamicsWorld::solveIslands(bool updateBroadPhase) {
+
+    RP3D_PROFILE("DynamicsWorld::solveIslands()", mProfiler);
+
+    TaskScheduler* taskScheduler = getTaskScheduler();
+    if (taskScheduler != nullptr) {
+
+        // The broad-phase is shared by all the islands
+        assert(!updateBroadPhase);
+
+        // Solve each island in a different task
+        taskScheduler->parallelFor(mNbIslands, [this](uint islandIndex) {
+            solveIsland(islandIndex, false);
+        });
+    }
+    else {
+
+        // For each island of the world
+        for (uint islandIndex = 0; islandIndex < mNbIslands; islandIndex++) {
+            solveIsland(islandIndex, updateBroadPhase);
+        }
+    }
+}
+
+// Solve the constraints and integrate the positions of an island
+/// The islands do not share any data that is modified here, therefore this method
+/// can be called concurrently for different islands.
+/**
+ * @param islandIndex Index of the island to solve
+ * @param updateBroadPhase True if the broad-phase state of the bodies must also be updated
+ */
+void DynamicsWorld::solveIsland(uint islandIndex, bool updateBroadPhase) {
+
+    Island* island = mIslands[islandIndex];
+    const bool hasContacts = island->getNbContactManifolds() > 0;
+    const bool hasJoints = island->getNbJoints() > 0;
+
+    // With the position based solver, the positions are corrected by the constraints
+    // and the velocities are derived from the displacement of the bodies
+    if (mConfig.isPositionBasedSolverEnabled) {
+
+        if (!hasContacts && !hasJoints) {
+            integrateAndUpdateBodiesState(island, updateBroadPhase);
+            return;
+        }
+
+        mPositionBasedSolver.solveIsland(islandIndex, mTimeStep);
+        updateBodiesState(island, updateBroadPhase);
+        return;
+    }
+
+    // ---------- Solve velocity constraints for joints and contacts ---------- //
+
+    const bool hasWheels = mContactSolver.getNbWheels(islandIndex) > 0;
+
+    // Warm start the constraints
+    if (hasContacts) mContactSolver.warmStart(islandIndex);
+    if (hasWheels) mContactSolver.warmStartWheels(islandIndex);
+    if (hasJoints) mConstraintSolver.warmStart(islandIndex);
+
+    // For each iteration of the velocity solver
+    uint nbIterations = 0;
+    for (uint i=0; i<island->getNbVelocitySolverIterations(); i++) {
+
+        decimal impulseDelta = decimal(0.0);
+
+        // Solve the constraints
+        if (hasJoints) impulseDelta = mConstraintSolver.solveVelocityConstraints(islandIndex);
+
+        // Solve the contacts
+        if (hasContacts) impulseDelta = std::max(impulseDelta, mContactSolver.solve(islandIndex));
+
+        // Solve the wheels of the vehicles
+        if (hasWheels) impulseDelta = std::max(impulseDelta, mContactSolver.solveWheels(islandIndex));
+
+        nbIterations++;
+
+        // Stop iterating if the impulses of the island do not change anymore
+        if (mConfig.isVelocitySolverEarlyExitEnabled && nbIterations >= mConfig.minVelocitySolverNbIterations &&
+            impulseDelta < mConfig.velocitySolverImpulseTolerance) {
+            break;
+        }
+    }
+    island->mNbDoneVelocitySolverIterations += nbIterations;
+
+    if (hasContacts) mContactSolver.storeImpulses(islandIndex);
+    if (hasWheels) mContactSolver.storeWheelsImpulses(islandIndex);
+    if (hasJoints) mConstraintSolver.storeImpulses(islandIndex);
+
+    // Without joints, the positions are integrated and the state of the bodies
+    // is updated in a single pass
+    if (!hasJoints) {
+        integrateAndUpdateBodiesState(island, updateBroadPhase);
+        return;
+    }
+
+    // Integrate the position and orientation of each body
+    integrateRigidBodiesPositions(island);
+
+    // ---------- Solve the position error correction for the constraints ---------- //
+
+    // For each iteration of the position (error correction) solver
+    for (uint i=0; i<island->getNbPositionSolverIterations(); i++) {
+
+        // If the early exit is enabled, stop as soon as the joints errors are negligible (the
+        // errors measured during the velocity stage may skip the position solver entirely)
+        if (mConfig.isPositionSolverEarlyExitEnabled &&
+            mConstraintSolver.getPositionError(islandIndex) < mConfig.positionSolverErrorTolerance) {
+            break;
+        }
+
+        // Solve the position constraints
+        mConstraintSolver.solvePositionConstraints(islandIndex);
+    }
+
+    // Update the state (positions and velocities) of the bodies
+    updateBodiesState(island, updateBroadPhase);
+}
+
+// Allocate the memory needed to store a given number of rigid bodies
+/// The bodies can then be created without growing the arrays of the world
+/**
+ * @param nbBodies The number of rigid bodies of the world
+ */
+void DynamicsWorld::reserveBodies(uint nbBodies) {
+
+    mBodies.reserve(nbBodies);
+    mRigidBodies.reserve(nbBodies);
+    mBodyIdAllocator.reserve(nbBodies);
+    mRigidBodyStates.reserve(nbBodies);
+}
+
+// Allocate the memory needed to store a given number of objects in the world
+/// The memory of the rigid bodies is reserved instead of the one of the collision bodies
+/**
+ * @param capacities The number of objects that the world is expected to contain
+ */
+void DynamicsWorld::reserve(const WorldCapacities& capacities) {
+
+    reserveBodies(capacities.nbBodies);
+    mMemoryManager.reservePoolMemory(sizeof(RigidBody), capacities.nbBodies);
+
+    reserveCollisionCapacities(capacities);
+}
+
+// Create a copy of the world with the same bodies, proxy shapes, joints and state
+/**
+ * The bodies and joints of the clone have the same IDs and the same indices (see
+ * getRigidBody() and getJoint()) as in this world, and stepping the clone gives the same
+ * results as stepping this world. The collision shapes (and therefore the BVHs of the
+ * triangle meshes) are shared with this world and must outlive the clone. The memory of
+ * all the objects of the clone is reserved at once and its joints are stored in a single
+ * memory block. The event listener, the logger and the profiler of this world are not
+ * used by the clone. This method must not be called while an update started with
+ * startUpdate() is running.
+ * @return Pointer to the new world (that must be deleted by the user)
+ */
+DynamicsWorld* DynamicsWorld::clone() const {
+
+    assert(!mIsUpdateRunning);
+
+    DynamicsWorld* world = new DynamicsWorld(mGravity, mConfig);
+
+    // Settings of the world that have been changed after its creation
+    world->mNbVelocitySolverIterations = mNbVelocitySolverIterations;
+    world->mNbPositionSolverIterations = mNbPositionSolverIterations;
+    world->mIsSleepingEnabled = mIsSleepingEnabled;
+    world->mIsGravityEnabled = mIsGravityEnabled;
+    world->mSleepLinearVelocity = mSleepLinearVelocity;
+    world->mSleepAngularVelocity = mSleepAngularVelocity;
+    world->mTimeBeforeSleep = mTimeBeforeSleep;
+    world->mSolverIterationsPolicy = mSolverIterationsPolicy;
+    world->mContactSolver.setIsSplitImpulseActive(mContactSolver.isSplitImpulseActive());
+    world->mMaterialTable = mMaterialTable;
+
+    // Reserve the memory of all the objects of the clone
+    WorldCapacities capacities;
+    capacities.nbBodies = mBodies.size();
+    for (uint i=0; i < mBodies.size(); i++) {
+        capacities.nbProxyShapes += mBodies[i]->mNbCollisionShapes;
+    }
+    capacities.nbOverlappingPairs = mCollisionDetection.mOverlappingPairs.size();
+    capacities.nbContactManifolds = mCollisionDetection.mContactManifolds.size();
+    world->reserve(capacities);
+
+    MemoryAllocator& allocator = world->mMemoryManager.getPoolAllocator(MemoryTag::Other);
+    List<bool> isRigidBody(allocator, mBodies.size());
+    for (uint i=0; i < mBodies.size(); i++) {
+        isRigidBody.add(false);
+    }
+    for (uint i=0; i < mRigidBodies.size(); i++) {
+        isRigidBody[mRigidBodies[i]->mWorldIndex] = true;
+    }
+
+    // Create the bodies in the same order (with the same IDs)
+    List<const ProxyShape*> shapes(allocator);
+    for (uint i=0; i < mBodies.size(); i++) {
+
+        const CollisionBody* body = mBodies[i];
+        CollisionBody* clonedBody = isRigidBody[i] ? world->createRigidBody(body->mTransform) :
+                                                     world->createCollisionBody(body->mTransform);
+        clonedBody->mID = body->mID;
+        clonedBody->mIsAllowedToSleep = body->mIsAllowedToSleep;
+        clonedBody->mUserData = body->mUserData;
+        if (isRigidBody[i]) {
+            static_cast<RigidBody*>(clonedBody)->setType(body->mType);
+        }
+        else {
+            clonedBody->setType(body->mType);
+        }
+
+        // The proxy shapes are added at the beginning of the list of the body
+        shapes.clear();
+        for (const ProxyShape* shape = body->getProxyShapesList(); shape != nullptr; shape = shape->getNext()) {
+            shapes.add(shape);
+        }
+        for (uint s = shapes.size(); s > 0; s--) {
+
+            const ProxyShape* shape = shapes[s - 1];
+            ProxyShape* clonedShape = isRigidBody[i] ?
+                        static_cast<RigidBody*>(clonedBody)->addCollisionShape(shape->mCollisionShape,
+                                                                               shape->mLocalToBodyTransform, shape->mMass) :
+                        clonedBody->addCollisionShape(shape->mCollisionShape, shape->mLocalToBodyTransform);
+            clonedShape->mUserData = shape->mUserData;
+            clonedShape->mCollisionCategoryBits = shape->mCollisionCategoryBits;
+            clonedShape->mCollideWithMaskBits = shape->mCollideWithMaskBits;
+            clonedShape->mIsTrigger = shape->mIsTrigger;
+            clonedShape->setIsQueryOnly(shape->mIsQueryOnly);
+        }
+
+        // Mass properties and settings of a rigid body (that may have been set by the user)
+        if (isRigidBody[i]) {
+
+            const RigidBody* rigidBody = static_cast<const RigidBody*>(body);
+            RigidBody* clonedRigidBody = static_cast<RigidBody*>(clonedBody);
+            clonedRigidBody->mInitMass = rigidBody->mInitMass;
+            clonedRigidBody->mMassInverse = rigidBody->mMassInverse;
+            clonedRigidBody->mCenterOfMassLocal = rigidBody->mCenterOfMassLocal;
+            clonedRigidBody->mUserInertiaTensorLocalInverse = rigidBody->mUserInertiaTensorLocalInverse;
+            clonedRigidBody->mInertiaTensorLocalInverse = rigidBody->mInertiaTensorLocalInverse;
+            clonedRigidBody->mIsCenterOfMassSetByUser = rigidBody->mIsCenterOfMassSetByUser;
+            clonedRigidBody->mIsInertiaTensorSetByUser = rigidBody->mIsInertiaTensorSetByUser;
+            clonedRigidBody->mIsGravityEnabled = rigidBody->mIsGravityEnabled;
+            clonedRigidBody->mIsBullet = rigidBody->mIsBullet;
+            clonedRigidBody->mSimulationLevelOfDetail = rigidBody->mSimulationLevelOfDetail;
+            clonedRigidBody->mMaterial = rigidBody->mMaterial;
+            clonedRigidBody->mLinearDamping = rigidBody->mLinearDamping;
+            clonedRigidBody->mAngularDamping = rigidBody->mAngularDamping;
+        }
+
+        if (!body->mIsActive) {
+            clonedBody->setIsActive(false);
+        }
+    }
+    world->mBodyIdAllocator = mBodyIdAllocator;
+
+    // The rigid bodies of the clone are in the same order as the ones of this world
+    for (uint i=0; i < mRigidBodies.size(); i++) {
+        RigidBody* clonedRigidBody = static_cast<RigidBody*>(world->mBodies[mRigidBodies[i]->mWorldIndex]);
+        world->mRigidBodies[i] = clonedRigidBody;
+        clonedRigidBody->mRigidBodyIndex = i;
+    }
+
+    // Copy the joints into a single memory block (with the same IDs)
+    if (mJoints.size() > 0) {
+
+        size_t nbBytes = alignBlockSize(sizeof(JointsBlock));
+        for (uint i=0; i < mJoints.size(); i++) {
+            nbBytes += alignBlockSize(getJointSizeInBytes(mJoints[i]->getType()));
+        }
+
+        char* memory = static_cast<char*>(world->mMemoryManager.allocate(MemoryManager::AllocationType::Base, nbBytes,
+                                                                         MemoryTag::Solver));
+        JointsBlock* block = new (memory) JointsBlock();
+        block->nbJoints = mJoints.size();
+        block->nbBytes = nbBytes;
+        memory += alignBlockSize(sizeof(JointsBlock));
+
+        for (uint i=0; i < mJoints.size(); i++) {
+
+            const Joint* joint = mJoints[i];
+            RigidBody* body1 = world->mRigidBodies[joint->mBody1->mRigidBodyIndex];
+            RigidBody* body2 = world->mRigidBodies[joint->mBody2->mRigidBodyIndex];
+
+            Joint* clonedJoint = joint->clone(joint->mId, body1, body2, memory);
+            clonedJoint->mBlock = block;
+            memory += alignBlockSize(getJointSizeInBytes(joint->getType()));
+
+            world->addJoint(clonedJoint);
+        }
+    }
+    world->mJointIdAllocator = mJointIdAllocator;
+
+    // Copy the state of this world into the clone
+    const size_t stateSize = getStateSizeInBytes();
+    void* state = world->mMemoryManager.allocate(MemoryManager::AllocationType::Base, stateSize, MemoryTag::Other);
+    WorldStateWriter writer(state);
+    writeState(writer, stateSize);
+
+    WorldStateReader reader(state, stateSize);
+    FlatMap<int, ProxyShape*> savedProxyShapes(allocator);
+    const bool isStateCompatible = world->readStateHeader(reader, stateSize, savedProxyShapes);
+    assert(isStateCompatible);
+    (void)isStateCompatible;
+    world->readState(reader, savedProxyShapes);
+
+    world->mMemoryManager.release(MemoryManager::AllocationType::Base, state, stateSize, MemoryTag::Other);
+
+    return world;
+}
+
+// Create a rigid body into the physics world
+/**
+ * @param transform Transformation from body local-space to world-space
+ * @return A pointer to the body that has been created in the world
+ */
+RigidBody* DynamicsWorld::createRigidBody(const Transform& transform) {
+
+    // Compute the body ID
+    bodyindex bodyID = mBodyIdAllocator.allocate();
+
+    // Largest index cannot be used (it is used for invalid index)
+    assert(bodyID < std::numeric_limits<reactphysics3d::bodyindex>::max());
+
+    // Create the rigid body
+    RigidBody* rigidBody = new (mMemoryManager.allocate(MemoryManager::AllocationType::Pool,
+                                                        sizeof(RigidBody), MemoryTag::Bodies)) RigidBody(transform, *this, mRigidBodyStates, bodyID);
+    assert(rigidBody != nullptr);
+
+    // Give the registered default material to the body
+    rigidBody->mMaterial = mMaterialTable.getMaterial(Material::DEFAULT_ID);
+
+    // Add the rigid body to the physics world
+    addBody(rigidBody);
+    rigidBody->mRigidBodyIndex = static_cast<uint>(mRigidBodies.size());
+    mRigidBodies.add(rigidBody);
+
+#ifdef IS_PROFILING_ACTIVE
+    rigidBody->setProfiler(mProfiler);
+#endif
+
+#ifdef IS_LOGGING_ACTIVE
+   rigidBody->setLogger(mLogger);
+#endif
+
+    RP3D_LOG(mLogger, Logger::Level::Information, Logger::Category::Body,
+             "Body " + std::to_string(bodyID) + ": New collision body created");
+
+    // Return the pointer to the rigid body
+    return rigidBody;
+}
+
+// Create several rigid bodies with their collision shapes into the physics world
+/// The bodies are stored contiguously in a single memory block that is released when all
+/// of them have been destroyed. The proxy shapes of the collision shapes are inserted
+/// together into the broad-phase at the end of the call (with a single build of the tree
+/// when many shapes are added) instead of one by one. This is much faster to create the
+/// thousands of bodies of a level for instance. If the bodies are a spatial group (the bodies of
+/// a chunk of a streamed level for instance), their proxy shapes are built into a sub-tree of
+/// the broad-phase that is grafted into the tree with a single insertion. The cost then does
+/// not depend on the number of bodies already in the world but the broad-phase is slower if
+/// the bodies of the group are not close to each other.
+/**
+ * @param bodiesInfos Array with the information that is necessary to create each body
+ * @param nbBodies Number of bodies to create
+ * @param[out] bodies Array where the pointers to the created bodies are written
+ * @param isSpatialGroup True if the bodies are close to each other and are inserted into the
+ *                       broad-phase as a group
+ */
+void DynamicsWorld::createRigidBodies(const RigidBodyInfo* bodiesInfos, uint nbBodies, RigidBody** bodies,
+                                      bool isSpatialGroup) {
+
+    if (nbBodies == 0) return;
+
+    RP3D_PROFILE("DynamicsWorld::createRigidBodies()", mProfiler);
+
+    // Allocate the memory block of the bodies
+    const size_t nbBytes = alignBlockSize(sizeof(RigidBodiesBlock)) + nbBodies * alignBlockSize(sizeof(RigidBody));
+    char* memory = static_cast<char*>(mMemoryManager.allocate(MemoryManager::AllocationType::Base, nbBytes, MemoryTag::Bodies));
+    RigidBodiesBlock* block = new (memory) RigidBodiesBlock();
+    block->nbBodies = nbBodies;
+    block->nbBytes = nbBytes;
+    memory += alignBlockSize(sizeof(RigidBodiesBlock));
+
+    // Allocate the memory of the lists of the world and of the proxy shapes
+    uint nbProxyShapes = 0;
+    for (uint i=0; i < nbBodies; i++) {
+        if (bodiesInfos[i].collisionShape != nullptr) nbProxyShapes++;
+    }
+    reserveBodies(mBodies.size() + nbBodies);
+    mMemoryManager.reservePoolMemory(sizeof(ProxyShape), nbProxyShapes);
+
+    mCollisionDetection.beginProxyShapesBatch(isSpatialGroup);
+
+    for (uint i=0; i < nbBodies; i++) {
+
+        const RigidBodyInfo& info = bodiesInfos[i];
+
+        bodyindex bodyID = mBodyIdAllocator.allocate();
+        assert(bodyID < std::numeric_limits<reactphysics3d::bodyindex>::max());
+
+        // Construct the rigid body in the block and add it to the physics world
+        RigidBody* rigidBody = new (memory) RigidBody(info.transform, *this, mRigidBodyStates, bodyID);
+        rigidBody->mMaterial = mMaterialTable.getMaterial(Material::DEFAULT_ID);
+        rigidBody->mBlock = block;
+        memory += alignBlockSize(sizeof(RigidBody));
+
+        addBody(rigidBody);
+        rigidBody->mRigidBodyIndex = static_cast<uint>(mRigidBodies.size());
+        mRigidBodies.add(rigidBody);
+
+#ifdef IS_PROFILING_ACTIVE
+        rigidBody->setProfiler(mProfiler);
+#endif
+
+#ifdef IS_LOGGING_ACTIVE
+        rigidBody->setLogger(mLogger);
+#endif
+
+        // The type is set before the collision shape so that the shape goes into the right tree
+        if (info.type != BodyType::DYNAMIC) {
+            rigidBody->setType(info.type);
+        }
+
+        if (info.collisionShape != nullptr) {
+            rigidBody->addCollisionShape(info.collisionShape, info.shapeTransform, info.mass);
+        }
+
+        bodies[i] = rigidBody;
+    }
+
+    // Insert the new proxy shapes into the broad-phase
+    mCollisionDetection.endProxyShapesBatch();
+
+    RP3D_LOG(mLogger, Logger::Level::Information, Logger::Category::Body,
+             std::to_string(nbBodies) + " rigid bodies created");
+}
+
+// Destroy a rigid body and all the joints which it belongs
+/**
+ * @param rigidBody Pointer to the body you want to destroy
+ */
+void DynamicsWorld::destroyRigidBody(RigidBody* rigidBody) {
+
+    RP3D_LOG(mLogger, Logger::Level::Information, Logger::Category::Body,
+             "Body " + std::to_string(rigidBody->getId()) + ": rigid body destroyed");
+
+    // Remove all the collision shapes of the body
+    rigidBody->removeAllCollisionShapes();
+
+    // Remove the body from its persistent island (the other bodies of the island
+    // are merged again at the next step if they are still connected)
+    splitIsland(findIslandRoot(rigidBody));
+
+    // Release the body ID
+    mBodyIdAllocator.release(rigidBody->getId());
+
+    // Destroy all the joints in which the rigid body to be destroyed is involved
+    JointListElement* element;
+    for (element = rigidBody->mJointsList; element != nullptr; element = element->next) {
+        destroyJoint(element->joint);
+    }
+
+    // Reset the contact manifold list of the body
+    rigidBody->resetContactManifoldsList();
+
+    // Remove the rigid body from the lists of bodies (the last rigid body is moved at its index)
+    removeBody(rigidBody);
+    const uint index = rigidBody->mRigidBodyIndex;
+    const uint lastIndex = static_cast<uint>(mRigidBodies.size()) - 1;
+    assert(mRigidBodies[index] == rigidBody);
+    if (index != lastIndex) {
+        mRigidBodies[index] = mRigidBodies[lastIndex];
+        mRigidBodies[index]->mRigidBodyIndex = index;
+    }
+    mRigidBodies.removeAt(lastIndex);
+
+    RigidBodiesBlock* block = rigidBody->mBlock;
+
+    // Call the destructor of the rigid body
+    rigidBody->~RigidBody();
+
+    // If the body has its own allocation
+    if (block == nullptr) {
+
+        // Free the object from the memory allocator
+        mMemoryManager.release(MemoryManager::AllocationType::Pool, rigidBody, sizeof(RigidBody), MemoryTag::Bodies);
+    }
+    else {
+
+        // Release the memory block once all its bodies have been destroyed
+        assert(block->nbBodies > 0);
+        block->nbBodies--;
+        if (block->nbBodies == 0) {
+            mMemoryManager.release(MemoryManager::AllocationType::Base, block, block->nbBytes, MemoryTag::Bodies);
+        }
+    }
+}
+
+// Destroy several rigid bodies and all the joints which they belong
+/// The overlapping pairs of all the bodies are removed in a single pass over the overlapping
+/// pairs instead of one pass for each collision shape. This is much faster to unload the
+/// bodies of a chunk of a streamed level for instance.
+/**
+ * @param bodies Array with the pointers to the bodies you want to destroy
+ * @param nbBodies Number of bodies to destroy
+ */
+void DynamicsWorld::destroyRigidBodies(RigidBody* const* bodies, uint nbBodies) {
+
+    if (nbBodies == 0) return;
+
+    RP3D_PROFILE("DynamicsWorld::destroyRigidBodies()", mProfiler);
+
+    for (uint i=0; i < nbBodies; i++) {
+        assert(bodies[i] != nullptr);
+        assert(!bodies[i]->mIsBeingDestroyed);
+        bodies[i]->mIsBeingDestroyed = true;
+    }
+
+    // Remove the overlapping pairs of all the bodies at once
+    mCollisionDetection.removeOverlappingPairsOfDestroyedBodies();
+
+    for (uint i=0; i < nbBodies; i++) {
+        destroyRigidBody(bodies[i]);
+    }
+}
+
+// Create a joint between two bodies in the world and return a pointer to the new joint
+/**
+ * @param jointInfo The information that is necessary to create the joint
+ * @return A pointer to the joint that has been created in the world
+ */
+Joint* DynamicsWorld::createJoint(const JointInfo& jointInfo) {
+
+    // Allocate memory to create the new joint
+    void* allocatedMemory = mMemoryManager.allocate(MemoryManager::AllocationType::Pool,
+                                                    getJointSizeInBytes(jointInfo.type), MemoryTag::Solver);
+
+    // Construct the joint and add it into the world
+    Joint* newJoint = constructJoint(jointInfo, mJointIdAllocator.allocate(), allocatedMemory);
+    addJoint(newJoint);
+
+    // Return the pointer to the created joint
+    return newJoint;
+}
+
+// Create several joints between bodies in the world
+/// The joints are stored contiguously in a single memory block that is released when
+/// all of them have been destroyed. The joints can be destroyed one by one with
+/// destroyJoint() or together with destroyJoints().
+/**
+ * @param jointsInfos Array with the information that is necessary to create each joint
+ * @param nbJoints Number of joints to create
+ * @param[out] joints Array where the pointers to the created joints are written
+ */
+void DynamicsWorld::createJoints(const JointInfo* const* jointsInfos, uint nbJoints, Joint** joints) {
+
+    if (nbJoints == 0) return;
+
+    // Compute the size of the memory block of the joints
+    size_t nbBytes = alignBlockSize(sizeof(JointsBlock));
+    for (uint i=0; i < nbJoints; i++) {
+        nbBytes += alignBlockSize(getJointSizeInBytes(jointsInfos[i]->type));
+    }
+
+    // Allocate the memory block
+    char* memory = static_cast<char*>(mMemoryManager.allocate(MemoryManager::AllocationType::Base, nbBytes, MemoryTag::Solver));
+    JointsBlock* block = new (memory) JointsBlock();
+    block->nbJoints = nbJoints;
+    block->nbBytes = nbBytes;
+    memory += alignBlockSize(sizeof(JointsBlock));
+
+    mJoints.reserve(mJoints.size() + nbJoints);
+
+    // Construct the joints in the block and add them into the world
+    for (uint i=0; i < nbJoints; i++) {
+
+        joints[i] = constructJoint(*jointsInfos[i], mJointIdAllocator.allocate(), memory);
+        joints[i]->mBlock = block;
+        memory += alignBlockSize(getJointSizeInBytes(jointsInfos[i]->type));
+
+        addJoint(joints[i]);
+    }
+}
+
+// Destroy a joint
+/**
+ * @param joint Pointer to the joint you want to destroy
+ */
+void DynamicsWorld::destroyJoint(Joint* joint) {
+
+    assert(joint != nullptr);
+
+    // Remove the joint from the world (the last joint is moved at its index)
+    const uint index = joint->mWorldIndex;
+    const uint lastIndex = static_cast<uint>(mJoints.size()) - 1;
+    assert(mJoints[index] == joint);
+    if (index != lastIndex) {
+        mJoints[index] = mJoints[lastIndex];
+        mJoints[index]->mWorldIndex = index;
+    }
+    mJoints.removeAt(lastIndex);
+
+    releaseJoint(joint);
+}
+
+// Destroy several joints
+/// The joints are removed from the list of joints of the world in a single pass.
+/**
+ * @param joints Array with the pointers to the joints you want to destroy
+ * @param nbJoints Number of joints to destroy
+ */
+void DynamicsWorld::destroyJoints(Joint* const* joints, uint nbJoints) {
+
+    if (nbJoints == 0) return;
+
+    for (uint i=0; i < nbJoints; i++) {
+        assert(joints[i] != nullptr);
+        assert(!joints[i]->mIsBeingDestroyed);
+        joints[i]->mIsBeingDestroyed = true;
+    }
+
+    // Remove the joints from the world (keeping the order of the other joints)
+    uint nbRemainingJoints = 0;
+    for (uint i=0; i < mJoints.size(); i++) {
+        if (!mJoints[i]->mIsBeingDestroyed) {
+            mJoints[nbRemainingJoints] = mJoints[i];
+            mJoints[nbRemainingJoints]->mWorldIndex = nbRemainingJoints;
+            nbRemainingJoints++;
+        }
+    }
+    assert(mJoints.size() - nbRemainingJoints == nbJoints);
+    while (mJoints.size() > nbRemainingJoints) {
+        mJoints.removeAt(mJoints.size() - 1);
+    }
+
+    for (uint i=0; i < nbJoints; i++) {
+        releaseJoint(joints[i]);
+    }
+}
+
+// Create a particle system in the world
+/**
+ * @param settings The settings of the particle system
+ * @return A pointer to the particle system that has been created
+ */
+ParticleSystem* DynamicsWorld::createParticleSystem(const ParticleSystemSettings& settings) {
+
+    ParticleSystem* particleSystem = new (mMemoryManager.allocate(MemoryManager::AllocationType::Pool,
+                                          sizeof(ParticleSystem), MemoryTag::Bodies))
+                                          ParticleSystem(settings, mCollisionDetection, mMemoryManager);
+
+#ifdef IS_PROFILING_ACTIVE
+    particleSystem->setProfiler(mProfiler);
+#endif
+
+    mParticleSystems.add(particleSystem);
+
+    RP3D_LOG(mLogger, Logger::Level::Information, Logger::Category::World,
+             "Dynamics World: New particle system created");
+
+    return particleSystem;
+}
+
+// Destroy a particle system and all its particles
+/**
+ * @param particleSystem Pointer to the particle system to destroy
+ */
+void DynamicsWorld::destroyParticleSystem(ParticleSystem* particleSystem) {
+
+    // Remove the particle system from the list (the last particle system is moved at its index)
+    const uint lastIndex = mParticleSystems.size() - 1;
+    for (uint i=0; i <= lastIndex; i++) {
+        if (mParticleSystems[i] == particleSystem) {
+            mParticleSystems[i] = mParticleSystems[lastIndex];
+            mParticleSystems.removeAt(lastIndex);
+            break;
+        }
+    }
+
+    particleSystem->~ParticleSystem();
+    mMemoryManager.release(MemoryManager::AllocationType::Pool, particleSystem, sizeof(ParticleSystem), MemoryTag::Bodies);
+
+    RP3D_LOG(mLogger, Logger::Level::Information, Logger::Category::World,
+             "Dynamics World: Particle system destroyed");
+}
+
+// Create a vehicle with a rigid body as chassis
+/// The wheels are then added with Vehicle::addWheel(). The vehicle must be destroyed
+/// before its chassis.
+/**
+ * @param chassis The dynamic rigid body of the chassis
+ * @param settings The settings of the vehicle
+ * @return A pointer to the vehicle that has been created
+ */
+Vehicle* DynamicsWorld::createVehicle(RigidBody* chassis, const VehicleSettings& settings) {
+
+    Vehicle* vehicle = new (mMemoryManager.allocate(MemoryManager::AllocationType::Pool,
+                            sizeof(Vehicle), MemoryTag::Bodies)) Vehicle(chassis, settings, mMemoryManager);
+
+    mVehicles.add(vehicle);
+
+    RP3D_LOG(mLogger, Logger::Level::Information, Logger::Category::World,
+             "Dynamics World: New vehicle created");
+
+    return vehicle;
+}
+
+// Destroy a vehicle (its chassis is not destroyed)
+/**
+ * @param vehicle Pointer to the vehicle to destroy
+ */
+void DynamicsWorld::destroyVehicle(Vehicle* vehicle) {
+
+    // Remove the vehicle from the list (the last vehicle is moved at its index)
+    const uint lastIndex = mVehicles.size() - 1;
+    for (uint i=0; i <= lastIndex; i++) {
+        if (mVehicles[i] == vehicle) {
+            mVehicles[i] = mVehicles[lastIndex];
+            mVehicles.removeAt(lastIndex);
+            break;
+        }
+    }
+
+    vehicle->~Vehicle();
+    mMemoryManager.release(MemoryManager::AllocationType::Pool, vehicle, sizeof(Vehicle), MemoryTag::Bodies);
+
+    RP3D_LOG(mLogger, Logger::Level::Information, Logger::Category::World,
+             "Dynamics World: Vehicle destroyed");
+}
+
+// Return the size in bytes of a joint of a given type
+size_t DynamicsWorld::getJointSizeInBytes(JointType type) {
+
+    switch(type) {
+        case JointType::BALLSOCKETJOINT: return sizeof(BallAndSocketJoint);
+        case JointType::SLIDERJOINT: return sizeof(SliderJoint);
+        case JointType::HINGEJOINT: return sizeof(HingeJoint);
+        case JointType::FIXEDJOINT: return sizeof(FixedJoint);
+    }
+
+    assert(false);
+    return 0;
+}
+
+// Construct a joint in a given memory location
+/**
+ * @param jointInfo The information that is necessary to create the joint
+ * @param jointId Id of the new joint
+ * @param allocatedMemory Memory where the joint is constructed
+ * @return A pointer to the constructed joint
+ */
+Joint* DynamicsWorld::constructJoint(const JointInfo& jointInfo, jointindex jointId, void* allocatedMemory) {
+
+    switch(jointInfo.type) {
+
+        // Ball-and-Socket joint
+        case JointType::BALLSOCKETJOINT:
+        {
+            const BallAndSocketJointInfo& info = static_cast<const BallAndSocketJointInfo&>(
+                                                                                        jointInfo);
+            return new (allocatedMemory) BallAndSocketJoint(jointId, info);
+        }
+
+        // Slider joint
+        case JointType::SLIDERJOINT:
+        {
+            const SliderJointInfo& info = static_cast<const SliderJointInfo&>(jointInfo);
+            return new (allocatedMemory) SliderJoint(jointId, info);
+        }
+
+        // Hinge joint
+        case JointType::HINGEJOINT:
+        {
+            const HingeJointInfo& info = static_cast<const HingeJointInfo&>(jointInfo);
+            return new (allocatedMemory) HingeJoint(jointId, info);
+        }
+
+        // Fixed joint
+        case JointType::FIXEDJOINT:
+        {
+            const FixedJointInfo& info = static_cast<const FixedJointInfo&>(jointInfo);
+            return new (allocatedMemory) FixedJoint(jointId, info);
+        }
+    }
+
+    assert(false);
+    return nullptr;
+}
+
+// Construct a joint of a given type with default settings in a given memory location
+/**
+ * @param type Type of the joint
+ * @param jointId Id of the new joint
+ * @param body1 First body of the joint
+ * @param body2 Second body of the joint
+ * @param allocatedMemory Memory where the joint is constructed
+ * @return A pointer to the constructed joint
+ */
+Joint* DynamicsWorld::constructJointWithDefaultSettings(JointType type, jointindex jointId, RigidBody* body1,
+                                                        RigidBody* body2, void* allocatedMemory) {
+
+    const Vector3 anchorPoint = body1->getTransform().getPosition();
+    const Vector3 axis(decimal(1.0), decimal(0.0), decimal(0.0));
+
+    switch(type) {
+        case JointType::BALLSOCKETJOINT:
+            return constructJoint(BallAndSocketJointInfo(body1, body2, anchorPoint), jointId, allocatedMemory);
+        case JointType::SLIDERJOINT:
+            return constructJoint(SliderJointInfo(body1, body2, anchorPoint, axis), jointId, allocatedMemory);
+        case JointType::HINGEJOINT:
+            return constructJoint(HingeJointInfo(body1, body2, anchorPoint, axis), jointId, allocatedMemory);
+        case JointType::FIXEDJOINT:
+            return constructJoint(FixedJointInfo(body1, body2, anchorPoint), jointId, allocatedMemory);
+    }
+
+    assert(false);
+    return nullptr;
+}
+
+// Add a new joint into the world and into the joint list of its bodies
+void DynamicsWorld::addJoint(Joint* joint) {
+
+    // If the collision between the two bodies of the constraint is disabled
+    if (!joint->isCollisionEnabled()) {
+
+        // Add the pair of bodies in the set of body pairs that cannot collide with each other
+        mCollisionDetection.addNoCollisionPair(joint->getBody1(), joint->getBody2());
+    }
+
+    // Add the joint into the world
+    joint->mWorldIndex = static_cast<uint>(mJoints.size());
+    mJoints.add(joint);
+
+    RP3D_LOG(mLogger, Logger::Level::Information, Logger::Category::Joint,
+             "Joint " + std::to_string(joint->getId()) + ": New joint created");
+    RP3D_LOG(mLogger, Logger::Level::Information, Logger::Category::Joint,
+             "Joint " + std::to_string(joint->getId()) + ": " + joint->to_string());
+
+    // Add the joint into the joint list of the bodies involved in the joint
+    addJointToBody(joint);
+}
+
+// Remove a joint from its bodies and release its memory
+/// The joint must have been removed from the list of joints of the world before
+void DynamicsWorld::releaseJoint(Joint* joint) {
+
+    RP3D_LOG(mLogger, Logger::Level::Information, Logger::Category::Joint,
+             "Joint " + std::to_string(joint->getId()) + ": joint destroyed");
+
+    // If the collision between the two bodies of the constraint was disabled
+    if (!joint->isCollisionEnabled()) {
+
+        // Remove the pair of bodies from the set of body pairs that cannot collide with each other
+        mCollisionDetection.removeNoCollisionPair(joint->getBody1(), joint->getBody2());
+    }
+
+    // Wake up the two bodies of the joint
+    joint->getBody1()->setIsSleeping(false);
+    joint->getBody2()->setIsSleeping(false);
+
+    // The island of the bodies might not be connected anymore
+    joint->getBody1()->mIsConstraintRemoved = true;
+    joint->getBody2()->mIsConstraintRemoved = true;
+
+    // Remove the joint from the joint list of the bodies involved in the joint
+    joint->mBody1->removeJointFromJointsList(mMemoryManager, joint);
+    joint->mBody2->removeJointFromJointsList(mMemoryManager, joint);
+
+    size_t nbBytes = joint->getSizeInBytes();
+    JointsBlock* block = joint->mBlock;
+
+    // Release the joint ID
+    mJointIdAllocator.release(joint->getId());
+
+    // Call the destructor of the joint
+    joint->~Joint();
+
+    // If the joint has its own allocation
+    if (block == nullptr) {
+
+        // Release the allocated memory
+        mMemoryManager.release(MemoryManager::AllocationType::Pool, joint, nbBytes, MemoryTag::Solver);
+    }
+    else {
+
+        // Release the memory block once all its joints have been destroyed
+        assert(block->nbJoints > 0);
+        block->nbJoints--;
+        if (block->nbJoints == 0) {
+            mMemoryManager.release(MemoryManager::AllocationType::Base, block, block->nbBytes, MemoryTag::Solver);
+        }
+    }
+}
+
+// Compute the counters of the statistics of the last step
+/// The times of the stages of the step are measured by update().
+void DynamicsWorld::computeStepStatistics() {
+
+    mStepStatistics.broadPhase = mCollisionDetection.getBroadPhaseStatistics();
+    mStepStatistics.narrowPhase = mCollisionDetection.getNarrowPhaseStatistics();
+    mStepStatistics.nbIslands = mNbIslands;
+    mStepStatistics.nbSkippedIslands = mNbSkippedIslands;
+    mStepStatistics.nbSpatiallySortedBodies = mNbSpatiallySortedBodies;
+    mStepStatistics.nbVelocitySolverIterations = mTotalNbVelocitySolverIterations;
+    mStepStatistics.nbReusedContactPoints = mConfig.isPositionBasedSolverEnabled ? 0 :
+                                            mContactSolver.getNbReusedContactPoints();
+
+    // Count the awake bodies
+    mStepStatistics.nbAwakeBodies = 0;
+    for (uint b=0; b < mRigidBodies.size(); b++) {
+        const RigidBody* body = mRigidBodies[b];
+        if (body->getType() != BodyType::STATIC && body->isActive() && !body->isSleeping()) {
+            mStepStatistics.nbAwakeBodies++;
+        }
+    }
+
+    // Count the contacts of the active overlapping pairs
+    const OverlappingPairCache& pairs = mCollisionDetection.mOverlappingPairs;
+    mStepStatistics.nbOverlappingPairs = pairs.size();
+    mStepStatistics.nbParkedOverlappingPairs = pairs.size() - pairs.getNbActivePairs();
+    mStepStatistics.nbContactManifolds = 0;
+    mStepStatistics.nbContactPoints = 0;
+    for (uint p=0; p < pairs.getNbActivePairs(); p++) {
+        const ContactManifoldSet& manifoldSet = pairs.getPair(p)->getContactManifoldSet();
+        mStepStatistics.nbContactManifolds += static_cast<uint>(manifoldSet.getNbContactManifolds());
+        mStepStatistics.nbContactPoints += static_cast<uint>(manifoldSet.getTotalNbContactPoints());
+    }
+}
+
+// Destroy the joints that have been broken during the current step
+/// The joints are marked as broken by the constraint solver. Only the islands
+/// with broken joints are visited. The event listener is notified before each
+/// broken joint is destroyed.
+void DynamicsWorld::destroyBrokenJoints() {
+
+    RP3D_PROFILE("DynamicsWorld::destroyBrokenJoints()", mProfiler);
+
+    // The break thresholds are ignored by the position based solver
+    if (mConfig.isPositionBasedSolverEnabled) return;
+
+    for (uint i=0; i < mNbIslands; i++) {
+
+        if (mIslands[i]->getNbJoints() == 0 || mConstraintSolver.getNbBrokenJoints(i) == 0) continue;
+
+        Joint** joints = mIslands[i]->getJoints();
+        for (uint j=0; j < mIslands[i]->getNbJoints(); j++) {
+
+            if (!joints[j]->isBroken()) continue;
+
+            RP3D_LOG(mLogger, Logger::Level::Information, Logger::Category::Joint,
+                     "Joint " + std::to_string(joints[j]->getId()) + ": joint broken");
+
+            if (mEventListener != nullptr) mEventListener->jointBroken(joints[j]);
+
+            destroyJoint(joints[j]);
+        }
+    }
+}
+
+// Add the joint to the list of joints of the two bodies involved in the joint
+void DynamicsWorld::addJointToBody(Joint* joint) {
+
+    assert(joint != nullptr);
+
+    // Add the joint at the beginning of the linked list of joints of the first body
+    void* allocatedMemory1 = mMemoryManager.allocate(MemoryManager::AllocationType::Pool,
+                                                     sizeof(JointListElement), MemoryTag::Solver);
+    JointListElement* jointListElement1 = new (allocatedMemory1) JointListElement(joint,
+                                                                     joint->mBody1->mJointsList);
+    joint->mBody1->mJointsList = jointListElement1;
+
+    RP3D_LOG(mLogger, Logger::Level::Information, Logger::Category::Body,
+             "Body " + std::to_string(joint->mBody1->getId()) + ": Joint " + std::to_string(joint->getId()) +
+             " added to body");
+
+    // Add the joint at the beginning of the linked list of joints of the second body
+    void* allocatedMemory2 = mMemoryManager.allocate(MemoryManager::AllocationType::Pool,
+                                                     sizeof(JointListElement), MemoryTag::Solver);
+    JointListElement* jointListElement2 = new (allocatedMemory2) JointListElement(joint,
+                                                                     joint->mBody2->mJointsList);
+    joint->mBody2->mJointsList = jointListElement2;
+
+    RP3D_LOG(mLogger, Logger::Level::Information, Logger::Category::Body,
+             "Body " + std::to_string(joint->mBody2->getId()) + ": Joint " + std::to_string(joint->getId()) +
+             " added to body");
+}
+
+// Sort the states of the rigid bodies if the number of steps between two spatial sorts is reached
+void DynamicsWorld::updateSpatialSort() {
+
+    mNbSpatiallySortedBodies = 0;
+    if (mConfig.nbStepsBetweenSpatialSorts > 0) {
+        mNbStepsSinceSpatialSort++;
+        if (mNbStepsSinceSpatialSort >= mConfig.nbStepsBetweenSpatialSorts) {
+            sortRigidBodiesSpatially();
+            mNbStepsSinceSpatialSort = 0;
+        }
+    }
+}
+
+// Sort the states of the rigid bodies along a Morton curve of their positions
+/// The positions of the bodies are quantized with 10 bits per axis inside the bounds of all
+/// the positions and the bits of the three coordinates are interleaved. The islands are
+/// computed in the order of the states, so the bodies that are close in space are also close
+/// in the state arrays, in the islands and in the velocity arrays of the solver. The bodies
+/// with the same code keep the order of their creation so that the sort is deterministic.
+void DynamicsWorld::sortRigidBodiesSpatially() {
+
+    RP3D_PROFILE("DynamicsWorld::sortRigidBodiesSpatially()", mProfiler);
+
+    const uint nbStates = mRigidBodyStates.getNbStates();
+    if (nbStates < 2) return;
+
+    // Compute the bounds of the positions of the bodies
+    Vector3 minPosition = mRigidBodyStates.mCentersOfMassWorld[0];
+    Vector3 maxPosition = minPosition;
+    for (uint i=1; i < nbStates; i++) {
+        minPosition = Vector3::min(minPosition, mRigidBodyStates.mCentersOfMassWorld[i]);
+        maxPosition = Vector3::max(maxPosition, mRigidBodyStates.mCentersOfMassWorld[i]);
+    }
+    const Vector3 extent = maxPosition - minPosition;
+    const decimal maxExtent = std::max(std::max(extent.x, extent.y), std::max(extent.z, MACHINE_EPSILON));
+    const decimal scale = decimal(1023.0) / maxExtent;
+
+    // Compute the sort key of each state (the Morton code and the index of the body in the world)
+    uint64* keys = static_cast<uint64*>(mMemoryManager.allocate(MemoryManager::AllocationType::Frame,
+                                                                sizeof(uint64) * nbStates, MemoryTag::Solver));
+    for (uint i=0; i < nbStates; i++) {
+
+        const Vector3 position = (mRigidBodyStates.mCentersOfMassWorld[i] - minPosition) * scale;
+        const uint32 x = static_cast<uint32>(position.x);
+        const uint32 y = static_cast<uint32>(position.y);
+        const uint32 z = static_cast<uint32>(position.z);
+        uint32 mortonCode = 0;
+        for (uint32 bit=0; bit < 10; bit++) {
+            mortonCode |= (((x >> bit) & 1) << (3 * bit)) | (((y >> bit) & 1) << (3 * bit + 1)) |
+                          (((z >> bit) & 1) << (3 * bit + 2));
+        }
+
+        keys[i] = (static_cast<uint64>(mortonCode) << 32) | mRigidBodyStates.mBodies[i]->mRigidBodyIndex;
+    }
+    std::sort(keys, keys + nbStates);
+
+    // Compute the new order of the states
+    uint* order = static_cast<uint*>(mMemoryManager.allocate(MemoryManager::AllocationType::Frame,
+                                                             sizeof(uint) * nbStates, MemoryTag::Solver));
+    mNbSpatiallySortedBodies = 0;
+    for (uint i=0; i < nbStates; i++) {
+        const uint rigidBodyIndex = static_cast<uint>(keys[i] & 0xFFFFFFFF);
+        order[i] = mRigidBodies[rigidBodyIndex]->mStateIndex;
+        if (order[i] != i) mNbSpatiallySortedBodies++;
+    }
+
+    mRigidBodyStates.reorder(order);
+}
+
+// Compute the islands of awake bodies.
+/// An island is an isolated group of rigid bodies that have constraints (joints or contacts)
+/// between each other. The islands are persistent: each non-static body belongs to a
+/// persistent island (a disjoint-set forest with a linked list of the bodies of each set).
+/// At each time step, the islands of the bodies connected by a contact or a joint are
+/// merged. The islands are never split when a constraint is removed. Instead, an island
+/// where a contact manifold or a joint has been removed is marked as a split candidate and
+/// the largest candidate is split at the beginning of the next step (its bodies that are still connected
+/// are merged again right after). A persistent island can therefore temporarily contain
+/// several groups of bodies that are not connected anymore, which is still valid for the
+/// solver. Then, an island of the solver is created for each persistent island that
+/// contains an awake body. When a rebuild has been requested (see rebuildIslands()), all
+/// the persistent islands of the awake bodies are rebuilt instead of being merged.
+void DynamicsWorld::computeIslands() {
+
+    RP3D_PROFILE("DynamicsWorld::computeIslands()", mProfiler);
+
+    if (mIsIslandsRebuildRequested) {
+        rebuildPersistentIslands();
+        mIsIslandsRebuildRequested = false;
+    }
+    else {
+
+        // Split the island that has been selected at the previous step
+        if (mIslandToSplit != nullptr) {
+            splitIsland(findIslandRoot(mIslandToSplit));
+            mIslandToSplit = nullptr;
+        }
+
+        // Merge the islands of the bodies connected by a contact or a joint
+        uniteConstrainedBodies(nullptr, 0, mRigidBodyStates.getNbStates());
+    }
+
+    uint nbBodies = mRigidBodies.size();
+
+    // Allocate and create the array of islands pointer. This memory is allocated
+    // in the single frame allocator
+    mIslands = static_cast<Island**>(mMemoryManager.allocate(MemoryManager::AllocationType::Frame,
+                                                             sizeof(Island*) * nbBodies, MemoryTag::Solver));
+    mNbIslands = 0;
+
+    uint nbBodiesIslandToSplit = 0;
+
+    // For each rigid body of the world (in the order of their states)
+    for (uint b=0; b < mRigidBodyStates.getNbStates(); b++) {
+
+        RigidBody* body = mRigidBodyStates.mBodies[b];
+
+        // If the body has already been added to an island, we go to the next body
+        if (body->mIsAlreadyInIsland) continue;
+
+        // If the body is static, sleeping or inactive, we go to the next body
+        if (body->getType() == BodyType::STATIC || body->isSleeping() || !body->isActive()) continue;
+
+        RigidBody* islandRoot = findIslandRoot(body);
+
+        // Compute the maximum number of contact manifolds and joints of the island
+        uint nbMaxContactManifolds = 0;
+        uint nbMaxJoints = 0;
+        for (RigidBody* islandBody = islandRoot; islandBody != nullptr; islandBody = islandBody->mIslandNextBody) {
+
+            nbMaxContactManifolds += islandBody->mNbContactManifolds;
+            for (JointListElement* jointElement = islandBody->mJointsList; jointElement != nullptr;
+                 jointElement = jointElement->next) {
+                nbMaxJoints++;
+            }
+        }
+
+        // Create the new island (the static bodies connected to the island are also added into it)
+        void* allocatedMemoryIsland = mMemoryManager.allocate(MemoryManager::AllocationType::Frame,
+                                                              sizeof(Island), MemoryTag::Solver);
+        Island* island = new (allocatedMemoryIsland) Island(islandRoot->mIslandNbBodies + nbMaxContactManifolds + nbMaxJoints,
+                                                            nbMaxContactManifolds, nbMaxJoints, mMemoryManager);
+        island->mPersistentIslandRoot = islandRoot;
+
+        // With the partial wake-up, only the sleeping neighbors of the moving bodies are woken up
+        if (mConfig.isPartialWakeUpEnabled) {
+            wakeUpNeighborsOfMovingBodies(islandRoot);
+        }
+
+        // For each body of the persistent island
+        for (RigidBody* islandBody = islandRoot; islandBody != nullptr; islandBody = islandBody->mIslandNextBody) {
+
+            // A body that has become static or inactive is not part of the island anymore
+            if (islandBody->getType() == BodyType::STATIC || !islandBody->isActive()) {
+                islandRoot->mIsIslandSplitCandidate = true;
+                continue;
+            }
+
+            // If a constraint of the body has been removed, the island might not be connected anymore
+            if (islandBody->mIsConstraintRemoved) {
+                islandRoot->mIsIslandSplitCandidate = true;
+                islandBody->mIsConstraintRemoved = false;
+            }
+
+            // With the partial wake-up, the sleeping bodies are only added to the island as
+            // fixed bodies if they are connected to an awake body
+            if (islandBody->isSleeping()) {
+                if (mConfig.isPartialWakeUpEnabled) continue;
+
+                // Awake the body if it is sleeping
+                islandBody->setIsSleeping(false);
+            }
+
+            // Add the body into the island
+            island->addBody(islandBody);
+            islandBody->mIsAlreadyInIsland = true;
+            island->mSimulationLevelOfDetail = std::min(island->mSimulationLevelOfDetail,
+                                                        islandBody->mSimulationLevelOfDetail);
+        }
+
+        // For each body of the persistent island
+        for (RigidBody* islandBody = islandRoot; islandBody != nullptr; islandBody = islandBody->mIslandNextBody) {
+
+            // The constraints of the sleeping bodies used as fixed bodies are not solved
+            if (!islandBody->mIsAlreadyInIsland || islandBody->isSleeping()) continue;
+
+            // For each contact manifold in which the current body is involded
+            for (uint i=0; i < islandBody->mNbContactManifolds; i++) {
+
+                ContactManifold* contactManifold =
+                        mCollisionDetection.getBodyContactManifold(islandBody->mContactManifoldsIndex + i);
+
+                assert(contactManifold->getNbContactPoints() > 0);
+
+                // Check if the current contact manifold has already been added into an island
+                if (contactManifold->isAlreadyInIsland()) continue;
+
+                // Get the other body of the contact manifold
+                RigidBody* body1 = dynamic_cast<RigidBody*>(contactManifold->getBody1());
+                RigidBody* body2 = dynamic_cast<RigidBody*>(contactManifold->getBody2());
+
+                // If the colliding body is a RigidBody (and not a CollisionBody instead)
+                if (body1 != nullptr && body2 != nullptr) {
+
+                    // Add the contact manifold into the island
+                    island->addContactManifold(contactManifold);
+                    contactManifold->mIsAlreadyInIsland = true;
+
+                    // Add the other body into the island if it is a static body
+                    RigidBody* otherBody = (body1->getId() == islandBody->getId()) ? body2 : body1;
+                    if (!otherBody->mIsAlreadyInIsland) {
+                        addFixedBodyToIsland(island, otherBody);
+                    }
+                }
+            }
+
+            // For each joint in which the current body is involved
+            JointListElement* jointElement;
+            for (jointElement = islandBody->mJointsList; jointElement != nullptr;
+                 jointElement = jointElement->next) {
+
+                Joint* joint = jointElement->joint;
+
+                // Check if the current joint has already been added into an island
+                if (joint->isAlreadyInIsland()) continue;
+
+                // Add the joint into the island
+                island->addJoint(joint);
+                joint->mIsAlreadyInIsland = true;
+
+                // Add the other body into the island if it is a static body
+                RigidBody* body1 = static_cast<RigidBody*>(joint->getBody1());
+                RigidBody* body2 = static_cast<RigidBody*>(joint->getBody2());
+                RigidBody* otherBody = (body1->getId() == islandBody->getId()) ? body2 : body1;
+                if (!otherBody->mIsAlreadyInIsland) {
+                    addFixedBodyToIsland(island, otherBody);
+                }
+            }
+        }
+
+        // Reset the isAlreadyIsland variable of the static (and sleeping) bodies so that
+        // they can also be included in the other islands
+        for (uint i=0; i < island->mNbBodies; i++) {
+
+            if (island->mBodies[i]->getType() == BodyType::STATIC || island->mBodies[i]->isSleeping()) {
+                island->mBodies[i]->mIsAlreadyInIsland = false;
+            }
+        }
+
+        // Select the largest split candidate to be split at the next step
+        if (islandRoot->mIsIslandSplitCandidate && islandRoot->mIslandNbBodies > nbBodiesIslandToSplit) {
+            mIslandToSplit = islandRoot;
+            nbBodiesIslandToSplit = islandRoot->mIslandNbBodies;
+        }
+
+        mIslands[mNbIslands] = island;
+        mNbIslands++;
+    }
+
+    // Reset the isAlreadyInIsland variables of the bodies, contact manifolds and joints of the islands
+    for (uint i=0; i < mNbIslands; i++) {
+
+        for (uint b=0; b < mIslands[i]->mNbBodies; b++) {
+            mIslands[i]->mBodies[b]->mIsAlreadyInIsland = false;
+        }
+        for (uint c=0; c < mIslands[i]->mNbContactManifolds; c++) {
+            mIslands[i]->mContactManifolds[c]->mIsAlreadyInIsland = false;
+        }
+        for (uint j=0; j < mIslands[i]->mNbJoints; j++) {
+            mIslands[i]->mJoints[j]->mIsAlreadyInIsland = false;
+        }
+    }
+}
+
+// Select the islands that are simulated at the current step and sort them by level of detail
+/// The islands of the simulation level of detail L are simulated every 2^L steps with the
+/// time accumulated by their level since it was last simulated. The other islands are removed
+/// from the islands of the step and their bodies keep their state until their level is
+/// simulated again. The selected islands keep their order inside each level.
+/**
+ * @param timeStep Time step of the current step (in seconds)
+ * @param[out] levelsFirstIsland Index of the first island of each level (the last element
+ *                               is the number of selected islands)
+ * @param[out] levelsTimeSteps Time step of the islands of each level (in seconds)
+ */
+void DynamicsWorld::selectDueIslands(decimal timeStep, uint* levelsFirstIsland, decimal* levelsTimeSteps) {
+
+    RP3D_PROFILE("DynamicsWorld::selectDueIslands()", mProfiler);
+
+    // Accumulate the time of each level and select the levels simulated at this step
+    bool isLevelDue[NB_SIMULATION_LEVELS_OF_DETAIL];
+    uint levelsNbIslands[NB_SIMULATION_LEVELS_OF_DETAIL];
+    for (uint level=0; level < NB_SIMULATION_LEVELS_OF_DETAIL; level++) {
+
+        mLevelsOfDetailTimeSteps[level] += timeStep;
+        levelsTimeSteps[level] = mLevelsOfDetailTimeSteps[level];
+        isLevelDue[level] = (mLevelsOfDetailStepCounter & ((1u << level) - 1)) == 0;
+        if (isLevelDue[level]) mLevelsOfDetailTimeSteps[level] = decimal(0.0);
+        levelsNbIslands[level] = 0;
+    }
+    mLevelsOfDetailStepCounter = (mLevelsOfDetailStepCounter + 1) & ((1u << (NB_SIMULATION_LEVELS_OF_DETAIL - 1)) - 1);
+
+    // Count the selected islands of each level
+    for (uint i=0; i < mNbIslands; i++) {
+        const uint level = mIslands[i]->mSimulationLevelOfDetail;
+        if (isLevelDue[level]) levelsNbIslands[level]++;
+    }
+    levelsFirstIsland[0] = 0;
+    for (uint level=0; level < NB_SIMULATION_LEVELS_OF_DETAIL; level++) {
+        levelsFirstIsland[level + 1] = levelsFirstIsland[level] + levelsNbIslands[level];
+    }
+    const uint nbSelectedIslands = levelsFirstIsland[NB_SIMULATION_LEVELS_OF_DETAIL];
+    mNbSkippedIslands = mNbIslands - nbSelectedIslands;
+
+    // If all the islands have the full simulation rate, they are already in order
+    if (levelsNbIslands[0] == mNbIslands) return;
+
+    if (nbSelectedIslands == 0) {
+        mNbIslands = 0;
+        return;
+    }
+
+    // Place the selected islands of each level after the ones of the previous levels
+    Island** islands = static_cast<Island**>(mMemoryManager.allocate(MemoryManager::AllocationType::Frame,
+                                                                     sizeof(Island*) * nbSelectedIslands, MemoryTag::Solver));
+    uint levelsNextIsland[NB_SIMULATION_LEVELS_OF_DETAIL];
+    std::copy(levelsFirstIsland, levelsFirstIsland + NB_SIMULATION_LEVELS_OF_DETAIL, levelsNextIsland);
+    for (uint i=0; i < mNbIslands; i++) {
+        const uint level = mIslands[i]->mSimulationLevelOfDetail;
+        if (isLevelDue[level]) {
+            islands[levelsNextIsland[level]] = mIslands[i];
+            levelsNextIsland[level]++;
+        }
+    }
+
+    mIslands = islands;
+    mNbIslands = nbSelectedIslands;
+}
+
+// Color the contact manifolds and the joints of the islands
+/// The constraints of each island are reordered by color. Two contact manifolds of the
+/// same color do not share any dynamic body and two joints of the same color do not share
+/// any body (the joints also modify the velocity of the static bodies). Therefore, the
+/// constraints of a color can be solved in parallel inside a single island. Solving the
+/// constraints sequentially in the new order gives exactly the same result.
+void DynamicsWorld::colorIslandsConstraints() {
+
+    RP3D_PROFILE("DynamicsWorld::colorIslandsConstraints()", mProfiler);
+
+    // For each island of the world
+    for (uint i=0; i < mNbIslands; i++) {
+
+        Island* island = mIslands[i];
+
+        // The index of the bodies in the velocity arrays is computed later. Until then,
+        // we use it for the index of the body in the island.
+        RigidBody** bodies = island->getBodies();
+        for (uint b=0; b < island->getNbBodies(); b++) {
+            bodies[b]->mArrayIndex = b;
+        }
+
+        // Colors already used by the constraints of each body (one bit per color)
+        uint64* bodiesColors = static_cast<uint64*>(mMemoryManager.allocate(MemoryManager::AllocationType::Frame,
+                                                                            sizeof(uint64) * island->getNbBodies(), MemoryTag::Solver));
+
+        if (island->mNbContactManifolds > 0) {
+            std::fill(bodiesColors, bodiesColors + island->getNbBodies(), 0);
+            island->mContactManifoldsColorsFirstIndex = colorConstraints(island->mContactManifolds, island->mNbContactManifolds,
+                                                                         bodiesColors, true, island->mNbContactManifoldsColors);
+        }
+        if (island->mNbJoints > 0) {
+            std::fill(bodiesColors, bodiesColors + island->getNbBodies(), 0);
+            island->mJointsColorsFirstIndex = colorConstraints(island->mJoints, island->mNbJoints, bodiesColors,
+                                                               false, island->mNbJointsColors);
+        }
+
+        mMemoryManager.release(MemoryManager::AllocationType::Frame, bodiesColors, sizeof(uint64) * island->getNbBodies(), MemoryTag::Solver);
+    }
+}
+
+// Color an array of constraints (contact manifolds or joints) and reorder it by color
+/// A greedy coloring is used: each constraint gets the smallest color that is not used
+/// by the other constraints of its bodies. The colors of a body are tracked with a bit
+/// mask. If all the tracked colors are used, the constraint gets a new color of its own.
+/**
+ * @param constraints Array of constraints to color
+ * @param nbConstraints Number of constraints
+ * @param bodiesColors Array with the colors of each body of the island (initialized to zero)
+ * @param areNonDynamicBodiesShared True if the static and kinematic bodies can be shared
+ *                                  by several constraints of the same color
+ * @param[out] nbColors Number of colors
+ * @return Index of the first constraint of each color (the last element is the number
+ *         of constraints)
+ */
+template<typename Constraint>
+uint* DynamicsWorld::colorConstraints(Constraint** constraints, uint nbConstraints, uint64* bodiesColors,
+                                      bool areNonDynamicBodiesShared, uint& nbColors) {
+
+    // Number of colors that can be tracked in the bit mask of a body
+    const uint nbTrackedColors = 64;
+
+    uint* constraintsColors = static_cast<uint*>(mMemoryManager.allocate(MemoryManager::AllocationType::Frame,
+                                                                         sizeof(uint) * nbConstraints, MemoryTag::Solver));
+
+    nbColors = 0;
+    uint nbUntrackedColors = 0;
+
+    // For each constraint
+    for (uint c=0; c < nbConstraints; c++) {
+
+        RigidBody* body1 = static_cast<RigidBody*>(constraints[c]->getBody1());
+        RigidBody* body2 = static_cast<RigidBody*>(constraints[c]->getBody2());
+        const bool isBody1Shared = areNonDynamicBodiesShared && body1->getType() != BodyType::DYNAMIC;
+        const bool isBody2Shared = areNonDynamicBodiesShared && body2->getType() != BodyType::DYNAMIC;
+
+        // Get the colors used by the other constraints of the bodies
+        uint64 usedColors = 0;
+        if (!isBody1Shared) usedColors |= bodiesColors[body1->mArrayIndex];
+        if (!isBody2Shared) usedColors |= bodiesColors[body2->mArrayIndex];
+
+        uint color;
+        if (usedColors != ~uint64(0)) {
+
+            // Find the smallest free color
+            color = 0;
+            while ((usedColors & (uint64(1) << color)) != 0) color++;
+
+            if (!isBody1Shared) bodiesColors[body1->mArrayIndex] |= uint64(1) << color;
+            if (!isBody2Shared) bodiesColors[body2->mArrayIndex] |= uint64(1) << color;
+        }
+        else {
+
+            // The constraint is alone in its color
+            color = nbTrackedColors + nbUntrackedColors;
+            nbUntrackedColors++;
+        }
+
+        constraintsColors[c] = color;
+        nbColors = std::max(nbColors, color + 1);
+    }
+
+    // Compute the index of the first constraint of each color
+    uint* colorsFirstIndex = static_cast<uint*>(mMemoryManager.allocate(MemoryManager::AllocationType::Frame,
+                                                                        sizeof(uint) * (nbColors + 1), MemoryTag::Solver));
+    std::fill(colorsFirstIndex, colorsFirstIndex + nbColors + 1, 0);
+    for (uint c=0; c < nbConstraints; c++) {
+        colorsFirstIndex[constraintsColors[c] + 1]++;
+    }
+    for (uint k=0; k < nbColors; k++) {
+        colorsFirstIndex[k + 1] += colorsFirstIndex[k];
+    }
+
+    // Reorder the constraints by color (keeping their order inside a color)
+    Constraint** sortedConstraints = static_cast<Constraint**>(mMemoryManager.allocate(MemoryManager::AllocationType::Frame,
+                                                                                       sizeof(Constraint*) * nbConstraints, MemoryTag::Solver));
+    uint* nextIndex = static_cast<uint*>(mMemoryManager.allocate(MemoryManager::AllocationType::Frame, sizeof(uint) * nbColors, MemoryTag::Solver));
+    std::copy(colorsFirstIndex, colorsFirstIndex + nbColors, nextIndex);
+    for (uint c=0; c < nbConstraints; c++) {
+        sortedConstraints[nextIndex[constraintsColors[c]]] = constraints[c];
+        nextIndex[constraintsColors[c]]++;
+    }
+    std::copy(sortedConstraints, sortedConstraints + nbConstraints, constraints);
+
+    mMemoryManager.release(MemoryManager::AllocationType::Frame, nextIndex, sizeof(uint) * nbColors, MemoryTag::Solver);
+    mMemoryManager.release(MemoryManager::AllocationType::Frame, sortedConstraints, sizeof(Constraint*) * nbConstraints, MemoryTag::Solver);
+    mMemoryManager.release(MemoryManager::AllocationType::Frame, constraintsColors, sizeof(uint) * nbConstraints, MemoryTag::Solver);
+
+    return colorsFirstIndex;
+}
+
+// Return the root body of the persistent island of a body
+/// The path from the body to the root is compressed on the way (path halving).
+/**
+ * @param body Pointer to a non-static body
+ * @return Pointer to the root body of the island
+ */
+RigidBody* DynamicsWorld::findIslandRoot(RigidBody* body) {
+
+    while (body->mIslandParent != body) {
+        body->mIslandParent = body->mIslandParent->mIslandParent;
+        body = body->mIslandParent;
+    }
 
-    // For each island of the world
-    for (uint islandIndex = 0; islandIndex < mNbIslands; islandIndex++) {
+    return body;
+}
 
-        // ---------- Solve the position error correction for the constraints ---------- //
+// Merge the persistent islands of two bodies
+/// The island with the smallest number of bodies is merged into the other one.
+/**
+ * @param body1 Pointer to the first body
+ * @param body2 Pointer to the second body
+ */
+void DynamicsWorld::mergeIslands(RigidBody* body1, RigidBody* body2) {
 
-        if (mIslands[islandIndex]->getNbJoints() > 0) {
+    RigidBody* root1 = findIslandRoot(body1);
+    RigidBody* root2 = findIslandRoot(body2);
 
-            // For each iteration of the position (error correction) solver
-            for (uint i=0; i<mNbPositionSolverIterations; i++) {
+    if (root1 == root2) return;
 
-                // Solve the position constraints
-                mConstraintSolver.solvePositionConstraints(mIslands[islandIndex]);
-            }
-        }
+    if (root1->mIslandNbBodies < root2->mIslandNbBodies) {
+        std::swap(root1, root2);
     }
+
+    // Append the bodies of the second island to the first one
+    root2->mIslandParent = root1;
+    root1->mIslandLastBody->mIslandNextBody = root2;
+    root1->mIslandLastBody = root2->mIslandLastBody;
+    root1->mIslandNbBodies += root2->mIslandNbBodies;
+    root1->mIsIslandSplitCandidate = root1->mIsIslandSplitCandidate || root2->mIsIslandSplitCandidate;
+    root1->mIslandSleepTime = std::min(root1->mIslandSleepTime, root2->mIslandSleepTime);
 }
 
-// Create a rigid body into the physics world
+// Split a persistent island into islands with a single body
 /**
- * @param transform Transformation from body local-space to world-space
- * @return A pointer to the body that has been created in the world
+ * @param islandRoot Pointer to the root body of the island
  */
-RigidBody* DynamicsWorld::createRigidBody(const Transform& transform) {
+void DynamicsWorld::splitIsland(RigidBody* islandRoot) {
 
-    // Compute the body ID
-    bodyindex bodyID = computeNextAvailableBodyId();
+    assert(islandRoot->mIslandParent == islandRoot);
 
-    // Largest index cannot be used (it is used for invalid index)
-    assert(bodyID < std::numeric_limits<reactphysics3d::bodyindex>::max());
+    if (mIslandToSplit == islandRoot) {
+        mIslandToSplit = nullptr;
+    }
 
-    // Create the rigid body
-    RigidBody* rigidBody = new (mMemoryManager.allocate(MemoryManager::AllocationType::Pool,
-                                                        sizeof(RigidBody))) RigidBody(transform, *this, bodyID);
-    assert(rigidBody != nullptr);
+    RigidBody* body = islandRoot;
+    while (body != nullptr) {
 
-    // Add the rigid body to the physics world
-    mBodies.add(rigidBody);
-    mRigidBodies.add(rigidBody);
+        RigidBody* nextBody = body->mIslandNextBody;
+        body->resetIsland();
+        body = nextBody;
+    }
+}
 
-#ifdef IS_PROFILING_ACTIVE
-    rigidBody->setProfiler(mProfiler);
-#endif
+// Rebuild the persistent islands of the awake bodies from their constraints
+/// Each persistent island that contains an awake body is split and the islands are then
+/// computed again from the contacts and joints of the awake bodies. The sets are first
+/// computed with a concurrent disjoint-set forest over the states of the bodies (the
+/// constraints of the bodies are processed in parallel ranges if a task scheduler has been
+/// set and the roots of the states are then found in parallel). The bodies of the
+/// persistent islands of the sleeping bodies are kept together in their set. Finally, the
+/// persistent islands are linked in the order of the states of their bodies.
+void DynamicsWorld::rebuildPersistentIslands() {
 
-#ifdef IS_LOGGING_ACTIVE
-   rigidBody->setLogger(mLogger);
-#endif
+    RP3D_PROFILE("DynamicsWorld::rebuildPersistentIslands()", mProfiler);
 
-    RP3D_LOG(mLogger, Logger::Level::Information, Logger::Category::Body,
-             "Body " + std::to_string(bodyID) + ": New collision body created");
+    const uint nbStates = mRigidBodyStates.getNbStates();
+    mIslandToSplit = nullptr;
 
-    // Return the pointer to the rigid body
-    return rigidBody;
-}
+    // Split the persistent islands that contain an awake body (each body keeps the sleep
+    // time of its island so that the merged islands get the smallest sleep time again)
+    for (uint b=0; b < nbStates; b++) {
 
-// Destroy a rigid body and all the joints which it belongs
-/**
- * @param rigidBody Pointer to the body you want to destroy
- */
-void DynamicsWorld::destroyRigidBody(RigidBody* rigidBody) {
+        RigidBody* body = mRigidBodyStates.mBodies[b];
+        if (body->getType() == BodyType::STATIC || body->isSleeping() || !body->isActive()) continue;
 
-    RP3D_LOG(mLogger, Logger::Level::Information, Logger::Category::Body,
-             "Body " + std::to_string(rigidBody->getId()) + ": rigid body destroyed");
+        RigidBody* islandBody = findIslandRoot(body);
+        const decimal islandSleepTime = islandBody->mIslandSleepTime;
+        while (islandBody != nullptr) {
 
-    // Remove all the collision shapes of the body
-    rigidBody->removeAllCollisionShapes();
+            RigidBody* nextBody = islandBody->mIslandNextBody;
+            islandBody->resetIsland();
+            islandBody->mIslandSleepTime = islandSleepTime;
+            islandBody = nextBody;
+        }
+    }
 
-    // Add the body ID to the list of free IDs
-    mFreeBodiesIds.add(rigidBody->getId());
+    // Create the nodes of the disjoint-set forest (the parent index is in the low 32 bits of
+    // a node and the rank of the node in the high 32 bits). The bodies of a remaining
+    // persistent island point to the root of the island.
+    std::atomic<uint64>* nodes = static_cast<std::atomic<uint64>*>(
+                mMemoryManager.allocate(MemoryManager::AllocationType::Frame,
+                                        sizeof(std::atomic<uint64>) * nbStates, MemoryTag::Solver));
+    for (uint b=0; b < nbStates; b++) {
+        RigidBody* body = mRigidBodyStates.mBodies[b];
+        const uint parentIndex = body->getType() == BodyType::STATIC ? b : findIslandRoot(body)->mStateIndex;
+        new (nodes + b) std::atomic<uint64>(parentIndex);
+    }
 
-    // Destroy all the joints in which the rigid body to be destroyed is involved
-    JointListElement* element;
-    for (element = rigidBody->mJointsList; element != nullptr; element = element->next) {
-        destroyJoint(element->joint);
+    // Merge the sets of the bodies connected by a contact or a joint and find the root of each state
+    uint* roots = static_cast<uint*>(mMemoryManager.allocate(MemoryManager::AllocationType::Frame,
+                                                             sizeof(uint) * nbStates, MemoryTag::Solver));
+    TaskScheduler* taskScheduler = getTaskScheduler();
+    if (taskScheduler != nullptr && nbStates >= 2 * MIN_NB_BODIES_PER_ISLANDS_REBUILD_TASK) {
+
+        taskScheduler->parallelForRange(nbStates, MIN_NB_BODIES_PER_ISLANDS_REBUILD_TASK,
+                                        [this, nodes](uint begin, uint end) {
+            uniteConstrainedBodies(nodes, begin, end);
+        });
+        taskScheduler->parallelForRange(nbStates, MIN_NB_BODIES_PER_ISLANDS_REBUILD_TASK,
+                                        [nodes, roots](uint begin, uint end) {
+            for (uint b = begin; b < end; b++) roots[b] = findNodeRoot(nodes, b);
+        });
+    }
+    else {
+        uniteConstrainedBodies(nodes, 0, nbStates);
+        for (uint b=0; b < nbStates; b++) roots[b] = findNodeRoot(nodes, b);
     }
 
-    // Reset the contact manifold list of the body
-    rigidBody->resetContactManifoldsList();
+    // Link the persistent islands of each set in the order of the states. The first body of
+    // each set gives its persistent island to the set (the roots of the disjoint-set forest
+    // depend on the order of the concurrent merges and are only used as keys).
+    RigidBody** setsFirstBodies = static_cast<RigidBody**>(mMemoryManager.allocate(MemoryManager::AllocationType::Frame,
+                                                                                 sizeof(RigidBody*) * nbStates, MemoryTag::Solver));
+    std::fill(setsFirstBodies, setsFirstBodies + nbStates, nullptr);
+    for (uint b=0; b < nbStates; b++) {
 
-    // Call the destructor of the rigid body
-    rigidBody->~RigidBody();
+        RigidBody* body = mRigidBodyStates.mBodies[b];
+        if (body->getType() == BodyType::STATIC) continue;
 
-    // Remove the rigid body from the list of rigid bodies
-    mBodies.remove(rigidBody);
-    mRigidBodies.remove(rigidBody);
+        if (setsFirstBodies[roots[b]] == nullptr) {
+            setsFirstBodies[roots[b]] = body;
+        }
+        else {
+            mergeIslands(setsFirstBodies[roots[b]], body);
+        }
+    }
 
-    // Free the object from the memory allocator
-    mMemoryManager.release(MemoryManager::AllocationType::Pool, rigidBody, sizeof(RigidBody));
+    mMemoryManager.release(MemoryManager::AllocationType::Frame, setsFirstBodies, sizeof(RigidBody*) * nbStates, MemoryTag::Solver);
+    mMemoryManager.release(MemoryManager::AllocationType::Frame, roots, sizeof(uint) * nbStates, MemoryTag::Solver);
+    mMemoryManager.release(MemoryManager::AllocationType::Frame, nodes, sizeof(std::atomic<uint64>) * nbStates, MemoryTag::Solver);
 }
 
-// Create a joint between two bodies in the world and return a pointer to the new joint
+// Merge the islands of the bodies connected by a contact or a joint to a range of bodies
+/// Only the constraints of the awake bodies are considered because there are no contacts
+/// between two sleeping bodies. The bodies are visited in the order of their states (see
+/// sortRigidBodiesSpatially()). Without a disjoint-set forest, the persistent islands of
+/// the bodies are merged directly (this is not thread-safe). Otherwise, the sets of the
+/// states of the bodies are merged in the forest and different ranges can be processed
+/// concurrently.
 /**
- * @param jointInfo The information that is necessary to create the joint
- * @return A pointer to the joint that has been created in the world
+ * @param nodes Nodes of the concurrent disjoint-set forest of the states (null to merge
+ *              the persistent islands directly)
+ * @param startIndex Index of the first state of the range
+ * @param endIndex Index of the end of the range (excluded)
  */
-Joint* DynamicsWorld::createJoint(const JointInfo& jointInfo) {
+void DynamicsWorld::uniteConstrainedBodies(std::atomic<uint64>* nodes, uint startIndex, uint endIndex) {
 
-    Joint* newJoint = nullptr;
+    for (uint b = startIndex; b < endIndex; b++) {
 
-    // Get the next available joint ID
-    uint jointId = computeNextAvailableJointId();
+        RigidBody* body = mRigidBodyStates.mBodies[b];
 
-    // Allocate memory to create the new joint
-    switch(jointInfo.type) {
+        if (body->getType() == BodyType::STATIC || body->isSleeping() || !body->isActive()) continue;
 
-        // Ball-and-Socket joint
-        case JointType::BALLSOCKETJOINT:
-        {
-            void* allocatedMemory = mMemoryManager.allocate(MemoryManager::AllocationType::Pool,
-                                                            sizeof(BallAndSocketJoint));
-            const BallAndSocketJointInfo& info = static_cast<const BallAndSocketJointInfo&>(
-                                                                                        jointInfo);
-            newJoint = new (allocatedMemory) BallAndSocketJoint(jointId, info);
-            break;
-        }
+        // For each contact manifold in which the body is involded
+        for (uint i=0; i < body->mNbContactManifolds; i++) {
 
-        // Slider joint
-        case JointType::SLIDERJOINT:
-        {
-            void* allocatedMemory = mMemoryManager.allocate(MemoryManager::AllocationType::Pool,
-                                                            sizeof(SliderJoint));
-            const SliderJointInfo& info = static_cast<const SliderJointInfo&>(jointInfo);
-            newJoint = new (allocatedMemory) SliderJoint(jointId, info);
-            break;
-        }
+            ContactManifold* contactManifold = mCollisionDetection.getBodyContactManifold(body->mContactManifoldsIndex + i);
 
-        // Hinge joint
-        case JointType::HINGEJOINT:
-        {
-            void* allocatedMemory = mMemoryManager.allocate(MemoryManager::AllocationType::Pool,
-                                                            sizeof(HingeJoint));
-            const HingeJointInfo& info = static_cast<const HingeJointInfo&>(jointInfo);
-            newJoint = new (allocatedMemory) HingeJoint(jointId, info);
-            break;
-        }
+            // Get the other body of the contact manifold
+            RigidBody* body1 = dynamic_cast<RigidBody*>(contactManifold->getBody1());
+            RigidBody* body2 = dynamic_cast<RigidBody*>(contactManifold->getBody2());
 
-        // Fixed joint
-        case JointType::FIXEDJOINT:
-        {
-            void* allocatedMemory = mMemoryManager.allocate(MemoryManager::AllocationType::Pool,
-                                                            sizeof(FixedJoint));
-            const FixedJointInfo& info = static_cast<const FixedJointInfo&>(jointInfo);
-            newJoint = new (allocatedMemory) FixedJoint(jointId, info);
-            break;
-        }
+            // If the colliding body is a RigidBody (and not a CollisionBody instead)
+            if (body1 != nullptr && body2 != nullptr) {
 
-        default:
-        {
-            assert(false);
-            return nullptr;
+                RigidBody* otherBody = (body1->getId() == body->getId()) ? body2 : body1;
+                if (otherBody->getType() != BodyType::STATIC) {
+                    if (nodes == nullptr) mergeIslands(body, otherBody);
+                    else uniteNodes(nodes, b, otherBody->mStateIndex);
+                }
+            }
         }
-    }
 
-    // If the collision between the two bodies of the constraint is disabled
-    if (!jointInfo.isCollisionEnabled) {
+        // For each joint in which the body is involved
+        JointListElement* jointElement;
+        for (jointElement = body->mJointsList; jointElement != nullptr; jointElement = jointElement->next) {
 
-        // Add the pair of bodies in the set of body pairs that cannot collide with each other
-        mCollisionDetection.addNoCollisionPair(jointInfo.body1, jointInfo.body2);
+            RigidBody* body1 = static_cast<RigidBody*>(jointElement->joint->getBody1());
+            RigidBody* body2 = static_cast<RigidBody*>(jointElement->joint->getBody2());
+            RigidBody* otherBody = (body1->getId() == body->getId()) ? body2 : body1;
+            if (otherBody->getType() != BodyType::STATIC) {
+                if (nodes == nullptr) mergeIslands(body, otherBody);
+                else uniteNodes(nodes, b, otherBody->mStateIndex);
+            }
+        }
     }
+}
 
-    // Add the joint into the world
-    mJoints.add(newJoint);
+// Return the root of a node of a concurrent disjoint-set forest
+/// The path is compressed on the way (path halving) with a compare-and-swap that is allowed
+/// to fail if another thread has modified the node in the meantime.
+/**
+ * @param nodes Nodes of the forest (parent index in the low 32 bits and rank in the high 32 bits)
+ * @param index Index of the node
+ * @return Index of the root node of the set of the node
+ */
+uint DynamicsWorld::findNodeRoot(std::atomic<uint64>* nodes, uint index) {
 
-    RP3D_LOG(mLogger, Logger::Level::Information, Logger::Category::Joint,
-             "Joint " + std::to_string(newJoint->getId()) + ": New joint created");
-    RP3D_LOG(mLogger, Logger::Level::Information, Logger::Category::Joint,
-             "Joint " + std::to_string(newJoint->getId()) + ": " + newJoint->to_string());
+    while (true) {
 
-    // Add the joint into the joint list of the bodies involved in the joint
-    addJointToBody(newJoint);
+        uint64 node = nodes[index].load(std::memory_order_acquire);
+        const uint parent = static_cast<uint>(node & 0xFFFFFFFF);
+        if (parent == index) return index;
 
-    // Return the pointer to the created joint
-    return newJoint;
+        const uint grandParent = static_cast<uint>(nodes[parent].load(std::memory_order_acquire) & 0xFFFFFFFF);
+        if (grandParent != parent) {
+            nodes[index].compare_exchange_weak(node, (node & ~uint64(0xFFFFFFFF)) | grandParent,
+                                               std::memory_order_acq_rel);
+        }
+        index = parent;
+    }
 }
 
-// Destroy a joint
+// Merge the sets of two nodes of a concurrent disjoint-set forest
+/// This is a lock-free union by rank: the root with the smallest rank (or the largest index
+/// for equal ranks) is linked to the other root with a compare-and-swap that only succeeds if
+/// it is still a root with the same rank. Otherwise, the roots are found again.
 /**
- * @param joint Pointer to the joint you want to destroy
+ * @param nodes Nodes of the forest (parent index in the low 32 bits and rank in the high 32 bits)
+ * @param index1 Index of the first node
+ * @param index2 Index of the second node
  */
-void DynamicsWorld::destroyJoint(Joint* joint) {
+void DynamicsWorld::uniteNodes(std::atomic<uint64>* nodes, uint index1, uint index2) {
 
-    assert(joint != nullptr);
+    while (true) {
 
-    RP3D_LOG(mLogger, Logger::Level::Information, Logger::Category::Joint,
-             "Joint " + std::to_string(joint->getId()) + ": joint destroyed");
+        uint root1 = findNodeRoot(nodes, index1);
+        uint root2 = findNodeRoot(nodes, index2);
+        if (root1 == root2) return;
 
-    // If the collision between the two bodies of the constraint was disabled
-    if (!joint->isCollisionEnabled()) {
+        uint64 node1 = nodes[root1].load(std::memory_order_acquire);
+        uint64 node2 = nodes[root2].load(std::memory_order_acquire);
+        if ((node1 & 0xFFFFFFFF) != root1 || (node2 & 0xFFFFFFFF) != root2) continue;
 
-        // Remove the pair of bodies from the set of body pairs that cannot collide with each other
-        mCollisionDetection.removeNoCollisionPair(joint->getBody1(), joint->getBody2());
+        uint rank1 = static_cast<uint>(node1 >> 32);
+        uint rank2 = static_cast<uint>(node2 >> 32);
+        if (rank1 < rank2 || (rank1 == rank2 && root1 > root2)) {
+            std::swap(root1, root2);
+            std::swap(node1, node2);
+            std::swap(rank1, rank2);
+        }
+
+        // Link the second root to the first one
+        if (!nodes[root2].compare_exchange_strong(node2, (static_cast<uint64>(rank2) << 32) | root1,
+                                                  std::memory_order_acq_rel)) continue;
+
+        // Increase the rank of the new root (this can fail if it has been modified in the meantime)
+        if (rank1 == rank2) {
+            nodes[root1].compare_exchange_strong(node1, (static_cast<uint64>(rank1 + 1) << 32) | root1,
+                                                 std::memory_order_acq_rel);
+        }
+
+        return;
     }
+}
 
-    // Wake up the two bodies of the joint
-    joint->getBody1()->setIsSleeping(false);
-    joint->getBody2()->setIsSleeping(false);
+// Wake up the sleeping bodies connected to a moving body of a persistent island.
+/// This is used by the partial wake-up. The woken bodies have a zero velocity and therefore
+/// only wake up their own neighbors at the next step if they start moving.
+/**
+ * @param islandRoot Pointer to the root body of the island
+ */
+void DynamicsWorld::wakeUpNeighborsOfMovingBodies(RigidBody* islandRoot) {
 
-    // Remove the joint from the world
-    mJoints.remove(joint);
+    const decimal sleepLinearVelocitySquare = mSleepLinearVelocity * mSleepLinearVelocity;
+    const decimal sleepAngularVelocitySquare = mSleepAngularVelocity * mSleepAngularVelocity;
 
-    // Remove the joint from the joint list of the bodies involved in the joint
-    joint->mBody1->removeJointFromJointsList(mMemoryManager, joint);
-    joint->mBody2->removeJointFromJointsList(mMemoryManager, joint);
+    for (RigidBody* body = islandRoot; body != nullptr; body = body->mIslandNextBody) {
 
-    size_t nbBytes = joint->getSizeInBytes();
+        if (body->getType() == BodyType::STATIC || body->isSleeping() || !body->isActive()) continue;
 
-    // Add the joint ID to the list of free IDs
-    mFreeJointsIDs.add(joint->getId());
+        // If the body is almost still, it does not disturb its neighbors
+        if (body->getLinearVelocity().lengthSquare() <= sleepLinearVelocitySquare &&
+            body->getAngularVelocity().lengthSquare() <= sleepAngularVelocitySquare) continue;
 
-    // Call the destructor of the joint
-    joint->~Joint();
+        // Wake up the bodies in contact with the moving body
+        for (uint i=0; i < body->mNbContactManifolds; i++) {
 
-    // Add the joint ID to the list of free IDs
-    mFreeJointsIDs.add(joint->getId());
+            ContactManifold* contactManifold = mCollisionDetection.getBodyContactManifold(body->mContactManifoldsIndex + i);
+            RigidBody* body1 = dynamic_cast<RigidBody*>(contactManifold->getBody1());
+            RigidBody* body2 = dynamic_cast<RigidBody*>(contactManifold->getBody2());
+            if (body1 != nullptr && body2 != nullptr) {
+                RigidBody* otherBody = (body1->getId() == body->getId()) ? body2 : body1;
+                if (otherBody->isSleeping() && otherBody->getType() != BodyType::STATIC) {
+                    otherBody->setIsSleeping(false);
+                }
+            }
+        }
 
-    // Release the allocated memory
-    mMemoryManager.release(MemoryManager::AllocationType::Pool, joint, nbBytes);
-}
+        // Wake up the bodies connected to the moving body by a joint
+        for (JointListElement* jointElement = body->mJointsList; jointElement != nullptr;
+             jointElement = jointElement->next) {
 
-// Add the joint to the list of joints of the two bodies involved in the joint
-void DynamicsWorld::addJointToBody(Joint* joint) {
+            RigidBody* body1 = static_cast<RigidBody*>(jointElement->joint->getBody1());
+            RigidBody* body2 = static_cast<RigidBody*>(jointElement->joint->getBody2());
+            RigidBody* otherBody = (body1->getId() == body->getId()) ? body2 : body1;
+            if (otherBody->isSleeping() && otherBody->getType() != BodyType::STATIC) {
+                otherBody->setIsSleeping(false);
+            }
+        }
+    }
+}
 
-    assert(joint != nullptr);
+// Wake up the persistent islands of several bodies in a single pass
+/**
+ * The sleeping bodies of the persistent island of each sleeping body of the array are woken up
+ * together (with the partial wake-up, only the bodies of the array are woken up). An island is
+ * only woken up once, whatever the number of its bodies in the array, because its bodies are
+ * not sleeping anymore when the next ones are processed. Calling this method before applying
+ * forces to many bodies (for an explosion for instance) avoids waking up their islands one
+ * body at a time during the calls of RigidBody::applyForce().
+ * @param bodies Array with pointers to the bodies to wake up
+ * @param nbBodies Number of bodies in the array
+ * @return The number of bodies that have been woken up
+ */
+uint DynamicsWorld::wakeBodies(RigidBody* const* bodies, uint nbBodies) {
 
-    // Add the joint at the beginning of the linked list of joints of the first body
-    void* allocatedMemory1 = mMemoryManager.allocate(MemoryManager::AllocationType::Pool,
-                                                     sizeof(JointListElement));
-    JointListElement* jointListElement1 = new (allocatedMemory1) JointListElement(joint,
-                                                                     joint->mBody1->mJointsList);
-    joint->mBody1->mJointsList = jointListElement1;
+    RP3D_PROFILE("DynamicsWorld::wakeBodies()", mProfiler);
 
-    RP3D_LOG(mLogger, Logger::Level::Information, Logger::Category::Body,
-             "Body " + std::to_string(joint->mBody1->getId()) + ": Joint " + std::to_string(joint->getId()) +
-             " added to body");
+    uint nbWokenBodies = 0;
 
-    // Add the joint at the beginning of the linked list of joints of the second body
-    void* allocatedMemory2 = mMemoryManager.allocate(MemoryManager::AllocationType::Pool,
-                                                     sizeof(JointListElement));
-    JointListElement* jointListElement2 = new (allocatedMemory2) JointListElement(joint,
-                                                                     joint->mBody2->mJointsList);
-    joint->mBody2->mJointsList = jointListElement2;
+    for (uint i=0; i < nbBodies; i++) {
 
-    RP3D_LOG(mLogger, Logger::Level::Information, Logger::Category::Body,
-             "Body " + std::to_string(joint->mBody2->getId()) + ": Joint " + std::to_string(joint->getId()) +
-             " added to body");
-}
+        RigidBody* body = bodies[i];
+        if (body->getType() == BodyType::STATIC || !body->isSleeping() || !body->isActive()) continue;
 
-// Return the next available joint Id
-uint DynamicsWorld::computeNextAvailableJointId() {
+        if (mConfig.isPartialWakeUpEnabled) {
+            body->setIsSleeping(false);
+            nbWokenBodies++;
+            continue;
+        }
 
-    // Compute the joint ID
-    uint jointId;
-    if (mFreeJointsIDs.size() != 0) {
-        jointId = mFreeJointsIDs[mFreeJointsIDs.size() - 1];
-        mFreeJointsIDs.removeAt(mFreeJointsIDs.size() - 1);
-    }
-    else {
-        jointId = mCurrentJointId;
-        mCurrentJointId++;
+        // Wake up all the bodies of the persistent island of the body
+        RigidBody* islandRoot = findIslandRoot(body);
+        for (RigidBody* islandBody = islandRoot; islandBody != nullptr; islandBody = islandBody->mIslandNextBody) {
+            if (islandBody->getType() != BodyType::STATIC && islandBody->isSleeping() && islandBody->isActive()) {
+                islandBody->setIsSleeping(false);
+                nbWokenBodies++;
+            }
+        }
+        islandRoot->mIslandSleepTime = decimal(0.0);
     }
 
-    return jointId;
+    return nbWokenBodies;
 }
 
-// Compute the islands of awake bodies.
-/// An island is an isolated group of rigid bodies that have constraints (joints or contacts)
-/// between each other. This method computes the islands at each time step as follows: For each
-/// awake rigid body, we run a Depth First Search (DFS) through the constraint graph of that body
-/// (graph where nodes are the bodies and where the edges are the constraints between the bodies) to
-/// find all the bodies that are connected with it (the bodies that share joints or contacts with
-/// it). Then, we create an island with this group of connected bodies.
-void DynamicsWorld::computeIslands() {
-
-    RP3D_PROFILE("DynamicsWorld::computeIslands()", mProfiler);
+// Wake up the persistent islands of the bodies whose AABBs overlap with an AABB
+/**
+ * The rigid bodies with a proxy shape whose fat AABB in the broad-phase overlaps with the
+ * AABB are found with a single query of the broad-phase and their islands are woken up
+ * with wakeBodies(). This can be used to wake up the region of an explosion before
+ * applying its forces.
+ * @param aabb The AABB of the region in world-space
+ * @param categoryMaskBits Bits mask of the collision categories of the proxy shapes to consider
+ * @return The number of bodies that have been woken up
+ */
+uint DynamicsWorld::wakeRegion(const AABB& aabb, collisionmask categoryMaskBits) {
 
-    uint nbBodies = mRigidBodies.size();
+    RP3D_PROFILE("DynamicsWorld::wakeRegion()", mProfiler);
 
-    // Allocate and create the array of islands pointer. This memory is allocated
-    // in the single frame allocator
-    mIslands = static_cast<Island**>(mMemoryManager.allocate(MemoryManager::AllocationType::Frame,
-                                                             sizeof(Island*) * nbBodies));
-    mNbIslands = 0;
+    const BroadPhaseAlgorithm* broadPhase = mCollisionDetection.mBroadPhaseAlgorithm;
 
-    int nbContactManifolds = 0;
+    List<int> overlappingNodes(mMemoryManager.getPoolAllocator(MemoryTag::Other));
+    broadPhase->reportAllShapesOverlappingWithAABB(aabb, overlappingNodes);
 
-    // Reset all the isAlreadyInIsland variables of bodies, joints and contact manifolds
-    for (List<RigidBody*>::Iterator it = mRigidBodies.begin(); it != mRigidBodies.end(); ++it) {
-        int nbBodyManifolds = (*it)->resetIsAlreadyInIslandAndCountManifolds();
-        nbContactManifolds += nbBodyManifolds;
-    }
-    for (List<Joint*>::Iterator it = mJoints.begin(); it != mJoints.end(); ++it) {
-        (*it)->mIsAlreadyInIsland = false;
-    }
+    // Collect the sleeping rigid bodies of the overlapping proxy shapes
+    List<RigidBody*> sleepingBodies(mMemoryManager.getPoolAllocator(MemoryTag::Other));
+    for (uint i=0; i < overlappingNodes.size(); i++) {
 
-    // Create a stack (using an array) for the rigid bodies to visit during the Depth First Search
-    size_t nbBytesStack = sizeof(RigidBody*) * nbBodies;
-    RigidBody** stackBodiesToVisit = static_cast<RigidBody**>(mMemoryManager.allocate(MemoryManager::AllocationType::Frame,
-                                                                                      nbBytesStack));
+        ProxyShape* proxyShape = broadPhase->getProxyShapeForBroadPhaseId(overlappingNodes[i]);
+        if ((proxyShape->getCollisionCategoryBits() & categoryMaskBits) == 0) continue;
 
-    // For each rigid body of the world
-    for (List<RigidBody*>::Iterator it = mRigidBodies.begin(); it != mRigidBodies.end(); ++it) {
+        RigidBody* body = dynamic_cast<RigidBody*>(proxyShape->getBody());
+        if (body != nullptr && body->isSleeping()) {
+            sleepingBodies.add(body);
+        }
+    }
 
-        RigidBody* body = *it;
+    if (sleepingBodies.size() == 0) return 0;
 
-        // If the body has already been added to an island, we go to the next body
-        if (body->mIsAlreadyInIsland) continue;
+    return wakeBodies(&(sleepingBodies[0]), sleepingBodies.size());
+}
 
-        // If the body is static, we go to the next body
-        if (body->getType() == BodyType::STATIC) continue;
+// Apply a radial impulse (an explosion) to the dynamic bodies around a point
+/**
+ * The bodies are found with a single query of the broad-phase with the AABB of the sphere of
+ * the impulse. The distance of a body to the center is the distance to the closest world AABB
+ * of its proxy shapes (with the categories of the mask) and the bodies further than the radius
+ * are ignored. The impulse is applied at the center of mass of each body in the direction from
+ * the center of the impulse to its center of mass and its magnitude decreases with the distance
+ * according to the falloff. If occluders are given, the rays from the center to the centers of
+ * mass of the bodies are cast in a batch and the bodies whose ray first hits a proxy shape of
+ * another body are ignored. The sleeping bodies are woken up with wakeBodies() and the
+ * impulses are then applied directly to the linear velocities of the bodies in a single pass.
+ * This method must not be called during an update of the world.
+ * @param center The center of the impulse in world-space
+ * @param radius The radius of the sphere of the impulse
+ * @param impulse The magnitude of the impulse at the center (in Newton * seconds)
+ * @param falloff The decrease of the impulse with the distance to the center
+ * @param categoryMaskBits Bits mask of the collision categories of the proxy shapes of the bodies
+ * @param occludersCategoryMaskBits Bits mask of the collision categories of the proxy shapes that
+ *                                  block the impulse (the occlusion is not tested if it is zero)
+ * @return The number of bodies to which the impulse has been applied
+ */
+uint DynamicsWorld::applyRadialImpulse(const Vector3& center, decimal radius, decimal impulse,
+                                       RadialFalloff falloff, collisionmask categoryMaskBits,
+                                       collisionmask occludersCategoryMaskBits) {
 
-        // If the body is sleeping or inactive, we go to the next body
-        if (body->isSleeping() || !body->isActive()) continue;
+    RP3D_PROFILE("DynamicsWorld::applyRadialImpulse()", mProfiler);
 
-        // Reset the stack of bodies to visit
-        uint stackIndex = 0;
-        stackBodiesToVisit[stackIndex] = body;
-        stackIndex++;
-        body->mIsAlreadyInIsland = true;
+    assert(radius > decimal(0.0));
 
-        // Create the new island
-        void* allocatedMemoryIsland = mMemoryManager.allocate(MemoryManager::AllocationType::Frame,
-                                                              sizeof(Island));
-        mIslands[mNbIslands] = new (allocatedMemoryIsland) Island(nbBodies, nbContactManifolds, mJoints.size(),
-                                                                  mMemoryManager);
+    const BroadPhaseAlgorithm* broadPhase = mCollisionDetection.mBroadPhaseAlgorithm;
+    MemoryAllocator& allocator = mMemoryManager.getPoolAllocator(MemoryTag::Other);
 
-        // While there are still some bodies to visit in the stack
-        while (stackIndex > 0) {
+    const Vector3 radiusVector(radius, radius, radius);
+    List<int> overlappingNodes(allocator);
+    broadPhase->reportAllShapesOverlappingWithAABB(AABB(center - radiusVector, center + radiusVector),
+                                                   overlappingNodes);
 
-            // Get the next body to visit from the stack
-            stackIndex--;
-            RigidBody* bodyToVisit = stackBodiesToVisit[stackIndex];
-            assert(bodyToVisit->isActive());
+    // Find the dynamic bodies inside the sphere and their distances to the center
+    List<RigidBody*> bodies(allocator);
+    List<decimal> distances(allocator);
+    FlatMap<RigidBody*, uint> bodiesIndices(allocator);
+    for (uint i=0; i < overlappingNodes.size(); i++) {
 
-            // Awake the body if it is sleeping
-            bodyToVisit->setIsSleeping(false);
+        ProxyShape* proxyShape = broadPhase->getProxyShapeForBroadPhaseId(overlappingNodes[i]);
+        if ((proxyShape->getCollisionCategoryBits() & categoryMaskBits) == 0) continue;
 
-            // Add the body into the island
-            mIslands[mNbIslands]->addBody(bodyToVisit);
+        RigidBody* body = dynamic_cast<RigidBody*>(proxyShape->getBody());
+        if (body == nullptr || body->getType() != BodyType::DYNAMIC || !body->isActive()) continue;
 
-            // If the current body is static, we do not want to perform the DFS
-            // search across that body
-            if (bodyToVisit->getType() == BodyType::STATIC) continue;
+        const AABB aabb = proxyShape->getWorldAABB();
+        const Vector3 closestPoint = Vector3::max(aabb.getMin(), Vector3::min(aabb.getMax(), center));
+        const decimal distance = (closestPoint - center).length();
+        if (distance > radius) continue;
 
-            // For each contact manifold in which the current body is involded
-            ContactManifoldListElement* contactElement;
-            for (contactElement = bodyToVisit->mContactManifoldsList; contactElement != nullptr;
-                 contactElement = contactElement->getNext()) {
+        auto it = bodiesIndices.find(body);
+        if (it == bodiesIndices.end()) {
+            bodiesIndices.add(Pair<RigidBody*, uint>(body, bodies.size()));
+            bodies.add(body);
+            distances.add(distance);
+        }
+        else if (distance < distances[it->second]) {
+            distances[it->second] = distance;
+        }
+    }
 
-                ContactManifold* contactManifold = contactElement->getContactManifold();
+    if (bodies.size() == 0) return 0;
 
-                assert(contactManifold->getNbContactPoints() > 0);
+    // Remove the bodies whose ray from the center first hits another body
+    if (occludersCategoryMaskBits != 0) {
 
-                // Check if the current contact manifold has already been added into an island
-                if (contactManifold->isAlreadyInIsland()) continue;
+        List<Ray> rays(allocator, bodies.size());
+        List<RaycastHit> hits(allocator, bodies.size());
+        for (uint i=0; i < bodies.size(); i++) {
+            rays.add(Ray(center, bodies[i]->getCenterOfMassWorld()));
+            hits.add(RaycastHit());
+        }
 
-                // Get the other body of the contact manifold
-                RigidBody* body1 = dynamic_cast<RigidBody*>(contactManifold->getBody1());
-                RigidBody* body2 = dynamic_cast<RigidBody*>(contactManifold->getBody2());
+        mCollisionDetection.raycastBatch(&(rays[0]), rays.size(), &(hits[0]), occludersCategoryMaskBits);
 
-                // If the colliding body is a RigidBody (and not a CollisionBody instead)
-                if (body1 != nullptr && body2 != nullptr) {
+        uint nbVisibleBodies = 0;
+        for (uint i=0; i < bodies.size(); i++) {
+            if (hits[i].isHit() && hits[i].body != bodies[i]) continue;
+            bodies[nbVisibleBodies] = bodies[i];
+            distances[nbVisibleBodies] = distances[i];
+            nbVisibleBodies++;
+        }
+        while (bodies.size() > nbVisibleBodies) {
+            bodies.removeAt(bodies.size() - 1);
+            distances.removeAt(distances.size() - 1);
+        }
 
-                    // Add the contact manifold into the island
-                    mIslands[mNbIslands]->addContactManifold(contactManifold);
-                    contactManifold->mIsAlreadyInIsland = true;
+        if (bodies.size() == 0) return 0;
+    }
 
-                    RigidBody* otherBody = (body1->getId() == bodyToVisit->getId()) ? body2 : body1;
+    // Wake up the islands of the sleeping bodies together
+    wakeBodies(&(bodies[0]), bodies.size());
 
-                    // Check if the other body has already been added to the island
-                    if (otherBody->mIsAlreadyInIsland) continue;
+    // Apply the impulses to the linear velocities of the bodies
+    uint nbImpulses = 0;
+    for (uint i=0; i < bodies.size(); i++) {
 
-                    // Insert the other body into the stack of bodies to visit
-                    stackBodiesToVisit[stackIndex] = otherBody;
-                    stackIndex++;
-                    otherBody->mIsAlreadyInIsland = true;
-                }
-            }
+        RigidBody* body = bodies[i];
+        const Vector3 direction = body->getCenterOfMassWorld() - center;
+        const decimal directionLength = direction.length();
+        if (directionLength < MACHINE_EPSILON) continue;
 
-            // For each joint in which the current body is involved
-            JointListElement* jointElement;
-            for (jointElement = bodyToVisit->mJointsList; jointElement != nullptr;
-                 jointElement = jointElement->next) {
+        const decimal t = distances[i] / radius;
+        decimal magnitude = impulse;
+        switch (falloff) {
+            case RadialFalloff::CONSTANT: break;
+            case RadialFalloff::LINEAR: magnitude *= decimal(1.0) - t; break;
+            case RadialFalloff::QUADRATIC: magnitude *= (decimal(1.0) - t) * (decimal(1.0) - t); break;
+        }
 
-                Joint* joint = jointElement->joint;
+        mRigidBodyStates.mLinearVelocities[body->mStateIndex] += direction * (magnitude * body->mMassInverse /
+                                                                              directionLength);
+        nbImpulses++;
+    }
 
-                // Check if the current joint has already been added into an island
-                if (joint->isAlreadyInIsland()) continue;
+    return nbImpulses;
+}
 
-                // Add the joint into the island
-                mIslands[mNbIslands]->addJoint(joint);
-                joint->mIsAlreadyInIsland = true;
+// Add a body that cannot be moved by the constraints of an island into the island.
+/// This is a static body or, with the partial wake-up, a sleeping body connected to an
+/// awake body of the island. A sleeping dynamic body is given an infinite mass until the
+/// end of the step so that it is not moved by the solvers.
+/**
+ * @param island Pointer to the island
+ * @param body Pointer to the static or sleeping body
+ */
+void DynamicsWorld::addFixedBodyToIsland(Island* island, RigidBody* body) {
 
-                // Get the other body of the contact manifold
-                RigidBody* body1 = static_cast<RigidBody*>(joint->getBody1());
-                RigidBody* body2 = static_cast<RigidBody*>(joint->getBody2());
-                RigidBody* otherBody = (body1->getId() == bodyToVisit->getId()) ? body2 : body1;
+    if (body->getType() == BodyType::STATIC) {
+        body->setIsSleeping(false);
+    }
+    else {
 
-                // Check if the other body has already been added to the island
-                if (otherBody->mIsAlreadyInIsland) continue;
+        assert(mConfig.isPartialWakeUpEnabled && body->isSleeping());
 
-                // Insert the other body into the stack of bodies to visit
-                stackBodiesToVisit[stackIndex] = otherBody;
-                stackIndex++;
-                otherBody->mIsAlreadyInIsland = true;
-            }
+        if (body->getType() == BodyType::DYNAMIC && body->mMassInverse > decimal(0.0)) {
+            body->mMassInverse = decimal(0.0);
+            body->mStates.mInertiaTensorsInverseWorld[body->mStateIndex].setToZero();
+            mFixedSleepingBodies.add(body);
         }
+    }
 
-        // Reset the isAlreadyIsland variable of the static bodies so that they
-        // can also be included in the other islands
-        for (uint i=0; i < mIslands[mNbIslands]->mNbBodies; i++) {
+    island->addBody(body);
+    body->mIsAlreadyInIsland = true;
+}
 
-            if (mIslands[mNbIslands]->mBodies[i]->getType() == BodyType::STATIC) {
-                mIslands[mNbIslands]->mBodies[i]->mIsAlreadyInIsland = false;
-            }
-        }
+// Restore the mass of the sleeping bodies that have been used as fixed bodies by the islands
+void DynamicsWorld::restoreFixedSleepingBodies() {
 
-        mNbIslands++;
-     }
+    for (uint i=0; i < mFixedSleepingBodies.size(); i++) {
+
+        RigidBody* body = mFixedSleepingBodies[i];
+        body->mMassInverse = decimal(1.0) / body->mInitMass;
+        body->updateInertiaTensorInverseWorld();
+    }
+    mFixedSleepingBodies.clear();
 }
 
 // Put bodies to sleep if needed.
-/// For each island, if all the bodies have been almost still for a long enough period of
-/// time, we put all the bodies of the island to sleep.
+/// For each island, if all the awake bodies have been almost still for a long enough period
+/// of time, we put all the bodies of the island to sleep. The time is tracked by the root of
+/// the persistent island and the bodies are only tested until one of them is moving.
 void DynamicsWorld::updateSleepingBodies() {
 
     RP3D_PROFILE("DynamicsWorld::updateSleepingBodies()", mProfiler);
@@ -825,43 +3330,46 @@ void DynamicsWorld::updateSleepingBodies() {
     // For each island of the world
     for (uint i=0; i<mNbIslands; i++) {
 
-        decimal minSleepTime = DECIMAL_LARGEST;
+        RigidBody* islandRoot = mIslands[i]->mPersistentIslandRoot;
 
-        // For each body of the island
+        // Check if all the awake bodies of the island are almost still
+        bool isIslandStill = true;
         RigidBody** bodies = mIslands[i]->getBodies();
         for (uint b=0; b < mIslands[i]->getNbBodies(); b++) {
 
-            // Skip static bodies
-            if (bodies[b]->getType() == BodyType::STATIC) continue;
+            // Skip the static bodies and the sleeping bodies used as fixed bodies
+            if (bodies[b]->getType() == BodyType::STATIC || bodies[b]->isSleeping()) continue;
 
-            // If the body is velocity is large enough to stay awake
+            // If the body velocity is large enough to stay awake
             if (bodies[b]->getLinearVelocity().lengthSquare() > sleepLinearVelocitySquare ||
                 bodies[b]->getAngularVelocity().lengthSquare() > sleepAngularVelocitySquare ||
                 !bodies[b]->isAllowedToSleep()) {
 
-                // Reset the sleep time of the body
-                bodies[b]->mSleepTime = decimal(0.0);
-                minSleepTime = decimal(0.0);
+                isIslandStill = false;
+                break;
             }
-            else {  // If the body velocity is bellow the sleeping velocity threshold
+        }
 
-                // Increase the sleep time
-                bodies[b]->mSleepTime += mTimeStep;
-                if (bodies[b]->mSleepTime < minSleepTime) {
-                    minSleepTime = bodies[b]->mSleepTime;
-                }
-            }
+        if (!isIslandStill) {
+
+            // Reset the sleep time of the island
+            islandRoot->mIslandSleepTime = decimal(0.0);
+            continue;
         }
 
+        // Increase the sleep time of the island
+        islandRoot->mIslandSleepTime += mTimeStep;
+
         // If the velocity of all the bodies of the island is under the
         // sleeping velocity threshold for a period of time larger than
         // the time required to become a sleeping body
-        if (minSleepTime >= mTimeBeforeSleep) {
+        if (islandRoot->mIslandSleepTime >= mTimeBeforeSleep) {
 
             // Put all the bodies of the island to sleep
             for (uint b=0; b < mIslands[i]->getNbBodies(); b++) {
                 bodies[b]->setIsSleeping(true);
             }
+            islandRoot->mIslandSleepTime = decimal(0.0);
         }
     }
 }
@@ -892,31 +3400,15 @@ void DynamicsWorld::enableSleeping(bool isSleepingEnabled) {
 }
 
 // Return the list of all contacts of the world
+/// This method returns a copy of the list returned by getContactManifolds() that
+/// should be used instead to avoid allocating a new list at each call.
 /**
- * @return A pointer to the first contact manifold in the linked-list of manifolds
+ * @return A list with the contact manifolds of the world
  */
 List<const ContactManifold*> DynamicsWorld::getContactsList() {
 
-    List<const ContactManifold*> contactManifolds(mMemoryManager.getPoolAllocator());
-
-    // For each currently overlapping pair of bodies
-    Map<Pair<uint, uint>, OverlappingPair*>::Iterator it;
-    for (it = mCollisionDetection.mOverlappingPairs.begin();
-         it != mCollisionDetection.mOverlappingPairs.end(); ++it) {
-
-        OverlappingPair* pair = it->second;
-
-        // For each contact manifold of the pair
-        const ContactManifoldSet& manifoldSet = pair->getContactManifoldSet();
-        ContactManifold* manifold = manifoldSet.getContactManifolds();
-        while (manifold != nullptr) {
-
-            // Get the contact manifold
-            contactManifolds.add(manifold);
-
-            manifold = manifold->getNext();
-        }
-    }
+    List<const ContactManifold*> contactManifolds(mMemoryManager.getPoolAllocator(MemoryTag::Other));
+    contactManifolds.addRange(mCollisionDetection.getContactManifolds());
 
     // Return all the contact manifold
     return contactManifolds;
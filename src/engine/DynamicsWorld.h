@@ -32,6 +32,13 @@
 #include "configuration.h"
 #include "utils/Logger.h"
 #include "engine/ContactSolver.h"
+#include "engine/MaterialTable.h"
+#include "engine/PositionBasedSolver.h"
+#include "engine/RigidBodyStates.h"
+#include "engine/ParticleSystem.h"
+#include "engine/Vehicle.h"
+#include <atomic>
+#include <cstddef>
 
 /// Namespace ReactPhysics3D
 namespace reactphysics3d {
@@ -40,6 +47,102 @@ namespace reactphysics3d {
 class CollisionDetection;
 class Island;
 class RigidBody;
+class SolverIterationsPolicy;
+class WorldStateWriter;
+class WorldStateReader;
+
+/// Falloff of a radial impulse with the distance to its center (see DynamicsWorld::applyRadialImpulse())
+enum class RadialFalloff {CONSTANT, LINEAR, QUADRATIC};
+
+// Structure StepStatistics
+/**
+ * This structure contains the statistics of the last step of a dynamics world. They are
+ * computed at the end of each call to DynamicsWorld::update() without any allocation and
+ * can be read with DynamicsWorld::getStepStatistics() (for instance to feed a metrics
+ * pipeline). The times are measured with a monotonic clock and are given in seconds.
+ */
+struct StepStatistics {
+
+    // -------------------- Attributes -------------------- //
+
+    /// Number of rigid bodies that are neither static nor sleeping at the end of the step
+    uint nbAwakeBodies = 0;
+
+    /// Number of islands solved during the step
+    uint nbIslands = 0;
+
+    /// Number of islands that have not been solved during the step because of their
+    /// simulation level of detail
+    uint nbSkippedIslands = 0;
+
+    /// Number of rigid bodies whose state has been moved by the spatial sort of the step
+    uint nbSpatiallySortedBodies = 0;
+
+    /// Statistics of the broad-phase (moved shapes and potential overlapping pairs)
+    BroadPhaseStatistics broadPhase;
+
+    /// Statistics of the narrow-phase (number of tests of each algorithm)
+    NarrowPhaseStatistics narrowPhase;
+
+    /// Number of overlapping pairs of shapes of the collision detection
+    uint nbOverlappingPairs = 0;
+
+    /// Number of overlapping pairs of sleeping or static bodies that are parked out of the
+    /// active pairs of the collision detection
+    uint nbParkedOverlappingPairs = 0;
+
+    /// Number of contact manifolds at the end of the step
+    uint nbContactManifolds = 0;
+
+    /// Number of contact points at the end of the step
+    uint nbContactPoints = 0;
+
+    /// Number of resting contact points whose cached solver data has been reused by the
+    /// contact solver during the step
+    uint nbReusedContactPoints = 0;
+
+    /// Total number of velocity solver iterations done by the islands
+    uint nbVelocitySolverIterations = 0;
+
+    /// Time spent in the collision detection
+    double collisionDetectionTime = 0.0;
+
+    /// Time spent in the broad-phase of the collision detection
+    double broadPhaseTime = 0.0;
+
+    /// Time spent in the middle-phase and narrow-phase of the collision detection
+    double narrowPhaseTime = 0.0;
+
+    /// Time spent to compute and initialize the islands
+    double islandsTime = 0.0;
+
+    /// Time spent to solve the constraints and integrate the bodies of the islands
+    double solverTime = 0.0;
+
+    /// Total time of the step
+    double totalTime = 0.0;
+};
+
+// Structure MotionQuantization
+/**
+ * This structure contains the precisions of the quantized motions of rigid bodies written by
+ * DynamicsWorld::saveMotions(). The coordinates of the positions and velocities are written
+ * as 32-bit integers in steps of these precisions and the orientations are written with the
+ * smallest-three encoding in 32 bits.
+ */
+struct MotionQuantization {
+
+    // -------------------- Attributes -------------------- //
+
+    /// Precision of the positions (in meters)
+    decimal positionPrecision = decimal(0.001);
+
+    /// Precision of the linear velocities (in meters per second)
+    decimal linearVelocityPrecision = decimal(0.001);
+
+    /// Precision of the angular velocities (in radians per second)
+    decimal angularVelocityPrecision = decimal(0.001);
+};
 
 // Class DynamicsWorld
 /**
@@ -51,17 +154,46 @@ class DynamicsWorld : public CollisionWorld {
 
     protected :
 
+        // -------------------- Constants -------------------- //
+
+        /// Number of orientations normalized together by the approximate normalization
+        static const uint NB_ORIENTATION_LANES = 4;
+
+        /// Number of bodies whose velocities are integrated together
+        static const uint NB_INTEGRATION_LANES = 4;
+
+        /// Minimum number of bodies for each task of the integration of the velocities
+        static const uint MIN_NB_BODIES_PER_INTEGRATION_TASK = 256;
+
+        /// Minimum number of bodies for each task of the rebuild of the persistent islands
+        static const uint MIN_NB_BODIES_PER_ISLANDS_REBUILD_TASK = 64;
+
+        /// Minimum number of proxy shapes for each task of the computation of the AABBs of the moved shapes
+        static const uint MIN_NB_SHAPES_PER_AABB_TASK = 128;
+
         // -------------------- Attributes -------------------- //
 
+        /// Table of the registered materials and of the combined properties of their pairs
+        MaterialTable mMaterialTable;
+
         /// Contact solver
         ContactSolver mContactSolver;
 
         /// Constraint solver
         ConstraintSolver mConstraintSolver;
 
+        /// Position based solver of the contacts and joints (if enabled in the world settings)
+        PositionBasedSolver mPositionBasedSolver;
+
         /// Number of iterations for the velocity solver of the Sequential Impulses technique
         uint mNbVelocitySolverIterations;
 
+        /// Total number of velocity solver iterations done by the islands during the last step
+        uint mTotalNbVelocitySolverIterations;
+
+        /// Statistics of the last step
+        StepStatistics mStepStatistics;
+
         /// Number of iterations for the position solver of the Sequential Impulses technique
         uint mNbPositionSolverIterations;
 
@@ -71,9 +203,18 @@ class DynamicsWorld : public CollisionWorld {
         /// All the rigid bodies of the physics world
         List<RigidBody*> mRigidBodies;
 
+        /// Dynamic state of all the rigid bodies of the world stored in contiguous arrays
+        RigidBodyStates mRigidBodyStates;
+
         /// All the joints of the world
         List<Joint*> mJoints;
 
+        /// All the particle systems of the world
+        List<ParticleSystem*> mParticleSystems;
+
+        /// All the vehicles of the world
+        List<Vehicle*> mVehicles;
+
         /// Gravity vector of the world
         Vector3 mGravity;
 
@@ -83,6 +224,19 @@ class DynamicsWorld : public CollisionWorld {
         /// True if the gravity force is on
         bool mIsGravityEnabled;
 
+        /// True if the orientations integrated during the current substep are normalized
+        /// with the approximate inverse square root
+        bool mIsOrientationNormalizationApproximate;
+
+        /// Number of substeps since the last exact normalization of the integrated orientations
+        uint mNbStepsSinceExactOrientationNormalization;
+
+        /// Number of steps since the last spatial sort of the states of the rigid bodies
+        uint mNbStepsSinceSpatialSort;
+
+        /// Number of rigid bodies whose state has been moved by the spatial sort of the current step
+        uint mNbSpatiallySortedBodies;
+
         /// Array of constrained linear velocities (state of the linear velocities
         /// after solving the constraints)
         Vector3* mConstrainedLinearVelocities;
@@ -103,12 +257,103 @@ class DynamicsWorld : public CollisionWorld {
         /// Array of constrained rigid bodies orientation (for position error correction)
         Quaternion* mConstrainedOrientations;
 
+        /// Rigid body of each entry of the velocity arrays
+        RigidBody** mArrayBodies;
+
         /// Number of islands in the world
         uint mNbIslands;
 
         /// Array with all the islands of awaken bodies
         Island** mIslands;
 
+        /// Index of the first island of mIslands in the islands of the current step (the
+        /// islands of each simulation level of detail are solved separately)
+        uint mIslandsFirstIndex;
+
+        /// Number of steps of the world modulo the period of the largest simulation level of detail
+        uint mLevelsOfDetailStepCounter;
+
+        /// Time accumulated by each simulation level of detail since its islands were last simulated
+        decimal mLevelsOfDetailTimeSteps[NB_SIMULATION_LEVELS_OF_DETAIL];
+
+        /// Number of islands that are not simulated at the current step because of their level of detail
+        uint mNbSkippedIslands;
+
+        /// Root body of the persistent island that will be split at the next step (null if none)
+        RigidBody* mIslandToSplit;
+
+        /// True if the persistent islands of the awake bodies must be rebuilt at the next step
+        bool mIsIslandsRebuildRequested;
+
+        /// Sleeping bodies that are used with an infinite mass by the islands of the current
+        /// step (with the partial wake-up)
+        List<RigidBody*> mFixedSleepingBodies;
+
+        /// Impulses of the contact manifolds reported by the contact solver during the last step
+        List<ContactImpulse> mContactImpulses;
+
+        /// Identifier of the task scheduler job that runs the step started with startUpdate()
+        luint mUpdateJobId;
+
+        /// True if a step started with startUpdate() has not been waited for yet
+        bool mIsUpdateRunning;
+
+        /// Next stage of the step started with beginStep() (NONE if no step is running)
+        StepStage mNextStepStage;
+
+        /// Time step of the running step (in seconds)
+        decimal mStepTimeStep;
+
+        /// Number of substeps of the running step
+        uint mStepNbSubsteps;
+
+        /// Ticks at the beginning of the running step
+        uint64 mStepStartTicks;
+
+        /// Ticks at the end of the collision detection of the running step
+        uint64 mStepCollisionDetectionTicks;
+
+        /// Ticks at the end of the computation of the islands of the running step
+        uint64 mStepIslandsTicks;
+
+        /// Ticks at the end of the solver stage of the running step
+        uint64 mStepSolverTicks;
+
+        /// Index of the first island of each simulation level of detail in the islands of the
+        /// running step (the last element is the number of islands)
+        uint mLevelsFirstIsland[NB_SIMULATION_LEVELS_OF_DETAIL + 1];
+
+        /// Time step of the islands of each simulation level of detail in the running step
+        decimal mLevelsTimeSteps[NB_SIMULATION_LEVELS_OF_DETAIL];
+
+        /// Policy used to choose the number of solver iterations of each island (null if none)
+        SolverIterationsPolicy* mSolverIterationsPolicy;
+
+#ifdef IS_ALLOCATION_CHECK_ACTIVE
+
+        /// Mode of the check of the memory allocations of the steps
+        AllocationCheckMode mAllocationCheckMode;
+
+        /// Number of allocations with the pool and base allocators during the last step
+        uint mNbAllocationsLastUpdate;
+
+        /// Number of allocations with the pool and base allocators before the running step
+        uint mNbAllocationsBeforeUpdate;
+
+        /// Number of allocations of the default base allocator before the running step
+        uint64 mNbHeapAllocationsBeforeUpdate;
+
+        /// Number of allocations of the default base allocator (system heap) during the last step
+        uint64 mNbHeapAllocationsLastUpdate;
+
+        /// Number of steps that have allocated memory while the check was enabled
+        uint mNbAllocatingUpdates;
+
+        /// Check the memory allocations of the last step
+        void checkUpdateAllocations();
+
+#endif
+
         /// Sleep linear velocity threshold
         decimal mSleepLinearVelocity;
 
@@ -119,16 +364,19 @@ class DynamicsWorld : public CollisionWorld {
         /// becomes smaller than the sleep velocity.
         decimal mTimeBeforeSleep;
 
-        /// List of free ID for joints
-        List<luint> mFreeJointsIDs;
-
-        /// Current joint id
-        uint mCurrentJointId;
+        /// Allocator of the joint ids
+        IdAllocator mJointIdAllocator;
 
         // -------------------- Methods -------------------- //
 
-        /// Integrate the positions and orientations of rigid bodies.
-        void integrateRigidBodiesPositions();
+        /// Integrate the positions and orientations of the rigid bodies of an island.
+        void integrateRigidBodiesPositions(Island* island);
+
+        /// Integrate the positions and orientations of a range of entries of the velocity arrays
+        void integrateRigidBodiesPositions(uint startIndex, uint endIndex);
+
+        /// Approximately normalize the integrated orientations of the bodies of an island
+        void normalizeConstrainedOrientations(Island* island);
 
         /// Reset the external force and torque applied to the bodies
         void resetBodiesForceAndTorque();
@@ -136,29 +384,178 @@ class DynamicsWorld : public CollisionWorld {
         /// Initialize the bodies velocities arrays for the next simulation step.
         void initVelocityArrays();
 
-        /// Integrate the velocities of rigid bodies.
-        void integrateRigidBodiesVelocities();
+        /// Integrate the velocities of all the rigid bodies of the islands
+        void integrateRigidBodiesVelocities(uint nbArrayBodies);
 
-        /// Solve the contacts and constraints
-        void solveContactsAndConstraints();
+        /// Integrate the velocities of a range of entries of the velocity arrays
+        void integrateRigidBodiesVelocities(uint startIndex, uint endIndex);
 
-        /// Solve the position error correction of the constraints
-        void solvePositionCorrection();
+        /// Allocate the velocity arrays and the contact constraints of the islands
+        void initIslands();
+
+        /// Cast the rays of the wheels of all the vehicles with a batched query
+        void updateVehiclesWheels();
+
+        /// Find the island of the chassis of each vehicle in the islands of the current level
+        void computeVehiclesIslands();
+
+        /// Compute the number of velocity and position solver iterations of each island
+        void computeIslandsNbSolverIterations();
+
+        /// Integrate the velocities and initialize the contacts and joints of the islands
+        void initIslandsConstraints(bool reprojectContacts);
+
+        /// Solve the constraints and integrate the positions of all the islands
+        void solveIslands(bool updateBroadPhase);
+
+        /// Solve the constraints and integrate the positions of an island
+        void solveIsland(uint islandIndex, bool updateBroadPhase);
+
+        /// Execute the broad-phase stage of a step
+        void executeBroadPhaseStage();
+
+        /// Execute the narrow-phase stage of a step
+        void executeNarrowPhaseStage();
+
+        /// Execute the islands stage of a step
+        void executeIslandsStage();
+
+        /// Execute the solver stage of a step
+        void executeSolverStage();
+
+        /// Execute the last stage of a step
+        void executeEndOfStepStage();
 
         /// Compute the islands of awake bodies.
         void computeIslands();
 
-        /// Update the postion/orientation of the bodies
-        void updateBodiesState();
+        /// Select the islands simulated at the current step and sort them by level of detail
+        void selectDueIslands(decimal timeStep, uint* levelsFirstIsland, decimal* levelsTimeSteps);
+
+        /// Sort the states of the rigid bodies if the number of steps between two spatial sorts is reached
+        void updateSpatialSort();
+
+        /// Sort the states of the rigid bodies along a Morton curve of their positions
+        void sortRigidBodiesSpatially();
+
+        /// Color the contact manifolds and the joints of the islands
+        void colorIslandsConstraints();
+
+        /// Color an array of constraints (contact manifolds or joints) and reorder it by color
+        template<typename Constraint>
+        uint* colorConstraints(Constraint** constraints, uint nbConstraints, uint64* bodiesColors,
+                               bool areNonDynamicBodiesShared, uint& nbColors);
+
+        /// Return the root body of the persistent island of a body
+        RigidBody* findIslandRoot(RigidBody* body);
+
+        /// Merge the persistent islands of two bodies
+        void mergeIslands(RigidBody* body1, RigidBody* body2);
+
+        /// Split a persistent island into islands with a single body
+        void splitIsland(RigidBody* islandRoot);
+
+        /// Rebuild the persistent islands of the awake bodies from their constraints
+        void rebuildPersistentIslands();
+
+        /// Merge the islands of the constraints of a range of bodies in a concurrent disjoint-set forest
+        void uniteConstrainedBodies(std::atomic<uint64>* nodes, uint startIndex, uint endIndex);
+
+        /// Return the root of a node of a concurrent disjoint-set forest
+        static uint findNodeRoot(std::atomic<uint64>* nodes, uint index);
+
+        /// Merge the sets of two nodes of a concurrent disjoint-set forest
+        static void uniteNodes(std::atomic<uint64>* nodes, uint index1, uint index2);
+
+        /// Wake up the sleeping bodies connected to a moving body of a persistent island
+        void wakeUpNeighborsOfMovingBodies(RigidBody* islandRoot);
+
+        /// Add a body that cannot be moved by the constraints of an island into the island
+        void addFixedBodyToIsland(Island* island, RigidBody* body);
+
+        /// Restore the mass of the sleeping bodies that have been used as fixed bodies by the islands
+        void restoreFixedSleepingBodies();
+
+        /// Update the postion/orientation of the bodies of an island
+        void updateBodiesState(Island* island, bool updateBroadPhase);
+
+        /// Integrate the positions and orientations and update the state of the bodies of an island
+        void integrateAndUpdateBodiesState(Island* island, bool updateBroadPhase);
+
+        /// Update the broad-phase state of the bodies of the islands
+        void updateBodiesBroadPhaseState();
+
+        /// Compute the world-space AABBs of a range of moved proxy shapes
+        static void computeProxyShapesAABBs(ProxyShapeUpdate* updates, uint startIndex, uint endIndex);
 
         /// Put bodies to sleep if needed.
         void updateSleepingBodies();
 
+        /// Destroy the joints that have been broken during the current step
+        void destroyBrokenJoints();
+
+        /// Compute the counters of the statistics of the last step
+        void computeStepStatistics();
+
+        /// Return the size in bytes of a joint of a given type
+        static size_t getJointSizeInBytes(JointType type);
+
+        /// Return an object size rounded up so that the next object of a block is aligned
+        static size_t alignBlockSize(size_t size);
+
+        /// Construct a joint in a given memory location
+        Joint* constructJoint(const JointInfo& jointInfo, jointindex jointId, void* allocatedMemory);
+
+        /// Construct a joint of a given type with default settings in a given memory location
+        Joint* constructJointWithDefaultSettings(JointType type, jointindex jointId, RigidBody* body1,
+                                                 RigidBody* body2, void* allocatedMemory);
+
+        /// Add a new joint into the world and into the joint list of its bodies
+        void addJoint(Joint* joint);
+
+        /// Remove a joint from its bodies and release its memory
+        void releaseJoint(Joint* joint);
+
         /// Add the joint to the list of joints of the two bodies involved in the joint
         void addJointToBody(Joint* joint);
 
-        /// Return the next available joint id
-        uint computeNextAvailableJointId();
+        /// Write the state of the world (with a given total size in its header)
+        void writeState(WorldStateWriter& writer, uint64 sizeInBytes) const;
+
+        /// Read the header of a saved state and return false if it has not been written for
+        /// the current bodies, proxy shapes and joints
+        bool readStateHeader(WorldStateReader& reader, size_t sizeInBytes,
+                             FlatMap<int, ProxyShape*>& savedProxyShapes) const;
+
+        /// Skip the content of a saved state after its header and return false if readState() cannot read it
+        bool checkStateContent(WorldStateReader& reader, const FlatMap<int, ProxyShape*>& savedProxyShapes) const;
+
+        /// Read the content of a saved state after its header
+        void readState(WorldStateReader& reader, const FlatMap<int, ProxyShape*>& savedProxyShapes);
+
+        /// Write the bodies, proxy shapes, joints and state of the world (with a given total size
+        /// in its header)
+        void writeWorld(WorldStateWriter& writer, const FlatMap<const CollisionShape*, uint32>* shapeIndices,
+                        uint64 sizeInBytes) const;
+
+        /// Create the bodies, proxy shapes and joints of a saved world and restore its state
+        bool readWorld(WorldStateReader& reader, CollisionShape* const* shapes, uint nbShapes);
+
+        /// Write the type, transform, proxy shapes and properties of a body
+        void writeBody(WorldStateWriter& writer, const CollisionBody* body, bool isRigidBody,
+                       const FlatMap<const CollisionShape*, uint32>* shapeIndices) const;
+
+        /// Create a body with the type, transform, proxy shapes and properties written by writeBody()
+        bool readBody(WorldStateReader& reader, bool isRigidBody, CollisionShape* const* shapes,
+                      uint nbShapes, CollisionBody*& body);
+
+        /// Write a rigid body with its velocities (with a given total size in its header)
+        void writeRigidBody(WorldStateWriter& writer, const RigidBody* body,
+                            const FlatMap<const CollisionShape*, uint32>* shapeIndices, uint64 sizeInBytes) const;
+
+        /// Write the motions of rigid bodies that are different from the ones of a baseline
+        void writeMotions(WorldStateWriter& writer, const RigidBody* const* bodies, uint nbBodies,
+                          const void* baseline, const MotionQuantization* quantization) const;
 
     public :
 
@@ -178,7 +575,31 @@ class DynamicsWorld : public CollisionWorld {
         DynamicsWorld& operator=(const DynamicsWorld& world) = delete;
 
         /// Update the physics simulation
-        void update(decimal timeStep);
+        void update(decimal timeStep, uint nbSubsteps = 1);
+
+        /// Begin a step of the physics simulation whose stages are executed one at a time
+        void beginStep(decimal timeStep, uint nbSubsteps = 1);
+
+        /// Execute the next stage of the step started with beginStep()
+        bool executeNextStepStage();
+
+        /// Compute the transforms of all the rigid bodies interpolated between the last two steps
+        void getInterpolatedTransforms(decimal interpolationFactor, Transform* outTransforms) const;
+
+        /// Write the transforms of all the rigid bodies as packed floats for the rendering
+        void getRenderTransforms(decimal interpolationFactor, float* outData) const;
+
+        /// Return the next stage of the step started with beginStep()
+        StepStage getNextStepStage() const;
+
+        /// Start to update the physics simulation in a job of the task scheduler
+        void startUpdate(decimal timeStep, uint nbSubsteps = 1);
+
+        /// Wait until the update started with startUpdate() is finished
+        void waitUpdate();
+
+        /// Return true if an update started with startUpdate() has not been waited for yet
+        bool isUpdateRunning() const;
 
         /// Get the number of iterations for the velocity constraint solver
         uint getNbIterationsVelocitySolver() const;
@@ -186,30 +607,139 @@ class DynamicsWorld : public CollisionWorld {
         /// Set the number of iterations for the velocity constraint solver
         void setNbIterationsVelocitySolver(uint nbIterations);
 
+        /// Return the total number of velocity solver iterations done by the islands during the last step
+        uint getTotalNbVelocitySolverIterations() const;
+
+        /// Return the statistics of the last step
+        const StepStatistics& getStepStatistics() const;
+
+        /// Return the table of the materials of the world
+        MaterialTable& getMaterialTable();
+
         /// Get the number of iterations for the position constraint solver
         uint getNbIterationsPositionSolver() const;
 
         /// Set the number of iterations for the position constraint solver
         void setNbIterationsPositionSolver(uint nbIterations);
 
+        /// Set the policy used to choose the number of solver iterations of each island
+        void setSolverIterationsPolicy(SolverIterationsPolicy* policy);
+
         /// Set the position correction technique used for contacts
         void setContactsPositionCorrectionTechnique(ContactsPositionCorrectionTechnique technique);
 
         /// Set the position correction technique used for joints
         void setJointsPositionCorrectionTechnique(JointsPositionCorrectionTechnique technique);
 
+        /// Return the largest number of bytes used by the contact solver in a step
+        size_t getSolverMemoryHighWaterMark() const;
+
+        /// Return the number of bytes reserved by the contact solver
+        size_t getSolverMemoryCapacity() const;
+
+        /// Allocate the memory needed to store a given number of rigid bodies
+        void reserveBodies(uint nbBodies);
+
+        /// Allocate the memory needed to store a given number of objects in the world
+        virtual void reserve(const WorldCapacities& capacities) override;
+
+        /// Return the size in bytes of the current state of the world
+        size_t getStateSizeInBytes() const;
+
+        /// Write the current state of the world into a buffer
+        void saveState(void* buffer) const;
+
+        /// Restore a state of the world written by saveState()
+        bool restoreState(const void* data, size_t sizeInBytes);
+
+        /// Create a copy of the world with the same bodies, proxy shapes, joints and state
+        DynamicsWorld* clone() const;
+
+        /// Return the size in bytes of the saved world
+        size_t getWorldSizeInBytes() const;
+
+        /// Write the bodies, proxy shapes, joints and state of the world into a buffer
+        void saveWorld(void* buffer, const CollisionShape* const* shapes, uint nbShapes) const;
+
+        /// Create a new world from a world written by saveWorld()
+        static DynamicsWorld* loadWorld(const void* data, size_t sizeInBytes, CollisionShape* const* shapes,
+                                        uint nbShapes, const WorldSettings& worldSettings = WorldSettings());
+
+        /// Return the size in bytes of a saved rigid body
+        size_t getRigidBodySizeInBytes(const RigidBody* body) const;
+
+        /// Write a rigid body with its proxy shapes, its properties and its velocities into a buffer
+        void saveRigidBody(const RigidBody* body, void* buffer, const CollisionShape* const* shapes,
+                           uint nbShapes) const;
+
+        /// Create a rigid body in this world from a rigid body written by saveRigidBody()
+        RigidBody* loadRigidBody(const void* data, size_t sizeInBytes, CollisionShape* const* shapes,
+                                 uint nbShapes);
+
+        /// Return the size in bytes of the saved motions of some rigid bodies
+        size_t getMotionsSizeInBytes(const RigidBody* const* bodies, uint nbBodies, const void* baseline = nullptr,
+                                     const MotionQuantization* quantization = nullptr) const;
+
+        /// Write the transforms and velocities of some rigid bodies into a buffer
+        void saveMotions(const RigidBody* const* bodies, uint nbBodies, void* buffer, const void* baseline = nullptr,
+                         const MotionQuantization* quantization = nullptr) const;
+
+        /// Set the transforms and velocities of rigid bodies from motions written by saveMotions()
+        bool restoreMotions(RigidBody* const* bodies, uint nbBodies, const void* data, size_t sizeInBytes);
+
+#ifdef IS_ALLOCATION_CHECK_ACTIVE
+
+        /// Set the mode of the check of the memory allocations of the steps
+        void setAllocationCheckMode(AllocationCheckMode mode);
+
+        /// Return the number of allocations with the pool and base allocators during the last step
+        uint getNbAllocationsLastUpdate() const;
+
+        /// Return the number of allocations of the system heap during the last step
+        uint64 getNbHeapAllocationsLastUpdate() const;
+
+        /// Return the number of steps that have allocated memory while the check was enabled
+        uint getNbAllocatingUpdates() const;
+
+#endif
+
         /// Create a rigid body into the physics world.
         RigidBody* createRigidBody(const Transform& transform);
 
+        /// Create several rigid bodies with their collision shapes into the physics world
+        void createRigidBodies(const RigidBodyInfo* bodiesInfos, uint nbBodies, RigidBody** bodies,
+                               bool isSpatialGroup = false);
+
         /// Destroy a rigid body and all the joints which it belongs
         void destroyRigidBody(RigidBody* rigidBody);
 
+        /// Destroy several rigid bodies and all the joints which they belong
+        void destroyRigidBodies(RigidBody* const* bodies, uint nbBodies);
+
         /// Create a joint between two bodies in the world and return a pointer to the new joint
         Joint* createJoint(const JointInfo& jointInfo);
 
+        /// Create several joints between bodies in the world
+        void createJoints(const JointInfo* const* jointsInfos, uint nbJoints, Joint** joints);
+
         /// Destroy a joint
         void destroyJoint(Joint* joint);
 
+        /// Destroy several joints
+        void destroyJoints(Joint* const* joints, uint nbJoints);
+
+        /// Create a particle system in the world
+        ParticleSystem* createParticleSystem(const ParticleSystemSettings& settings = ParticleSystemSettings());
+
+        /// Destroy a particle system and all its particles
+        void destroyParticleSystem(ParticleSystem* particleSystem);
+
+        /// Create a vehicle with a rigid body as chassis
+        Vehicle* createVehicle(RigidBody* chassis, const VehicleSettings& settings = VehicleSettings());
+
+        /// Destroy a vehicle (its chassis is not destroyed)
+        void destroyVehicle(Vehicle* vehicle);
+
         /// Return the gravity vector of the world
         Vector3 getGravity() const;
 
@@ -228,6 +758,24 @@ class DynamicsWorld : public CollisionWorld {
         /// Return the number of joints in the world
         uint getNbJoints() const;
 
+        /// Return a rigid body of the world
+        RigidBody* getRigidBody(uint index);
+
+        /// Return a joint of the world
+        Joint* getJoint(uint index);
+
+        /// Return the number of particle systems in the world
+        uint getNbParticleSystems() const;
+
+        /// Return a particle system of the world
+        ParticleSystem* getParticleSystem(uint index);
+
+        /// Return the number of vehicles in the world
+        uint getNbVehicles() const;
+
+        /// Return a vehicle of the world
+        Vehicle* getVehicle(uint index);
+
         /// Return true if the sleeping technique is enabled
         bool isSleepingEnabled() const;
 
@@ -252,12 +800,27 @@ class DynamicsWorld : public CollisionWorld {
         /// Set the time a body is required to stay still before sleeping
         void setTimeBeforeSleep(decimal timeBeforeSleep);
 
-        /// Set an event listener object to receive events callbacks.
-        void setEventListener(EventListener* eventListener);
+        /// Rebuild the persistent islands of the awake bodies at the next update
+        void rebuildIslands();
+
+        /// Wake up the persistent islands of several bodies in a single pass
+        uint wakeBodies(RigidBody* const* bodies, uint nbBodies);
+
+        /// Wake up the persistent islands of the bodies whose AABBs overlap with an AABB
+        uint wakeRegion(const AABB& aabb, collisionmask categoryMaskBits = ALL_COLLISION_CATEGORIES);
+
+        /// Apply a radial impulse (an explosion) to the dynamic bodies around a point
+        uint applyRadialImpulse(const Vector3& center, decimal radius, decimal impulse,
+                                RadialFalloff falloff = RadialFalloff::LINEAR,
+                                collisionmask categoryMaskBits = ALL_COLLISION_CATEGORIES,
+                                collisionmask occludersCategoryMaskBits = 0);
 
         /// Return the list of all contacts of the world
         List<const ContactManifold*> getContactsList();
 
+        /// Return the impulses of the contact manifolds reported during the last update
+        const List<ContactImpulse>& getContactImpulses() const;
+
         // -------------------- Friendship -------------------- //
 
         friend class RigidBody;
@@ -266,12 +829,24 @@ class DynamicsWorld : public CollisionWorld {
 // Reset the external force and torque applied to the bodies
 inline void DynamicsWorld::resetBodiesForceAndTorque() {
 
-    // For each body of the world
-    List<RigidBody*>::Iterator it;
-    for (it = mRigidBodies.begin(); it != mRigidBodies.end(); ++it) {
-        (*it)->mExternalForce.setToZero();
-        (*it)->mExternalTorque.setToZero();
-    }
+    mRigidBodyStates.resetForcesAndTorques();
+}
+
+// Return the next stage of the step started with beginStep()
+/**
+ * @return The stage executed by the next call to executeNextStepStage() (NONE if no
+ *         step is running)
+ */
+inline StepStage DynamicsWorld::getNextStepStage() const {
+    return mNextStepStage;
+}
+
+// Return true if an update started with startUpdate() has not been waited for yet
+/**
+ * @return True if a step started with startUpdate() has not been waited for yet
+ */
+inline bool DynamicsWorld::isUpdateRunning() const {
+    return mIsUpdateRunning;
 }
 
 // Get the number of iterations for the velocity constraint solver
@@ -293,6 +868,36 @@ inline void DynamicsWorld::setNbIterationsVelocitySolver(uint nbIterations) {
              "Dynamics World: Set nb iterations velocity solver to " + std::to_string(nbIterations));
 }
 
+// Return the total number of velocity solver iterations done by the islands during the last step
+/// Without the early exit of the velocity solver (see WorldSettings) and without a solver
+/// iterations policy, this is the number of velocity iterations times the number of islands
+/// and substeps of the step.
+/**
+ * @return The sum of the number of velocity solver iterations of all the islands
+ */
+inline uint DynamicsWorld::getTotalNbVelocitySolverIterations() const {
+    return mTotalNbVelocitySolverIterations;
+}
+
+// Return the statistics of the last step
+/**
+ * @return The number of awake bodies, islands, pairs, narrow-phase tests, contacts and
+ *         solver iterations of the last step and the time spent in each of its stages
+ */
+inline const StepStatistics& DynamicsWorld::getStepStatistics() const {
+    return mStepStatistics;
+}
+
+// Return the table of the materials of the world
+/// The materials registered in the table have precomputed (and overridable) combined
+/// properties for each pair of materials that are used by the contact solvers.
+/**
+ * @return A reference to the material table of the world
+ */
+inline MaterialTable& DynamicsWorld::getMaterialTable() {
+    return mMaterialTable;
+}
+
 // Get the number of iterations for the position constraint solver
 /**
  * @return The number of iterations of the position constraint solver
@@ -312,6 +917,16 @@ inline void DynamicsWorld::setNbIterationsPositionSolver(uint nbIterations) {
              "Dynamics World: Set nb iterations position solver to " + std::to_string(nbIterations));
 }
 
+// Set the policy used to choose the number of solver iterations of each island
+/// If you use "nullptr" as an argument, all the islands use the number of iterations
+/// of the world. The policy is not owned by the world and must outlive it.
+/**
+ * @param policy Pointer to the policy that chooses the number of iterations of each island
+ */
+inline void DynamicsWorld::setSolverIterationsPolicy(SolverIterationsPolicy* policy) {
+    mSolverIterationsPolicy = policy;
+}
+
 // Set the position correction technique used for contacts
 /**
  * @param technique Technique used for the position correction (Baumgarte or Split Impulses)
@@ -340,6 +955,62 @@ inline void DynamicsWorld::setJointsPositionCorrectionTechnique(
     }
 }
 
+// Return the largest number of bytes used by the contact solver in a step
+/// The memory of the contact solver is kept from one step to the next and only
+/// grows when a step needs more memory than the current capacity.
+/**
+ * @return The largest number of bytes used by the contact constraints of a step
+ */
+inline size_t DynamicsWorld::getSolverMemoryHighWaterMark() const {
+    return mContactSolver.getMemoryHighWaterMark();
+}
+
+// Return the number of bytes reserved by the contact solver
+/**
+ * @return The capacity (in bytes) of the memory arena of the contact solver
+ */
+inline size_t DynamicsWorld::getSolverMemoryCapacity() const {
+    return mContactSolver.getMemoryCapacity();
+}
+
+#ifdef IS_ALLOCATION_CHECK_ACTIVE
+
+// Set the mode of the check of the memory allocations of the steps
+/// Enable the check once the world has reached a steady state (after the first steps
+/// and after the memory has been reserved with reserveBodies(), reservePairs() and
+/// reserveContacts()). A step of a steady state must then not allocate any memory.
+/**
+ * @param mode The mode of the check
+ */
+inline void DynamicsWorld::setAllocationCheckMode(AllocationCheckMode mode) {
+    mAllocationCheckMode = mode;
+}
+
+// Return the number of allocations with the pool and base allocators during the last step
+/**
+ * @return The number of allocations of the memory manager of the world during the last step
+ */
+inline uint DynamicsWorld::getNbAllocationsLastUpdate() const {
+    return mNbAllocationsLastUpdate;
+}
+
+// Return the number of allocations of the system heap during the last step
+/// These are the allocations of the default base allocator. They also include the
+/// allocations of the other threads (and other worlds) during the step.
+/**
+ * @return The number of allocations of the default base allocator during the last step
+ */
+inline uint64 DynamicsWorld::getNbHeapAllocationsLastUpdate() const {
+    return mNbHeapAllocationsLastUpdate;
+}
+
+// Return the number of steps that have allocated memory while the check was enabled
+inline uint DynamicsWorld::getNbAllocatingUpdates() const {
+    return mNbAllocatingUpdates;
+}
+
+#endif
+
 // Return the gravity vector of the world
 /**
  * @return The current gravity vector (in meter per seconds squared)
@@ -387,7 +1058,13 @@ inline uint DynamicsWorld::getNbRigidBodies() const {
     return mRigidBodies.size();
 }
 
-/// Return the number of joints in the world
+/// Return an object size rounded up so that the next object of a block is aligned
+inline size_t DynamicsWorld::alignBlockSize(size_t size) {
+    const size_t alignment = alignof(std::max_align_t);
+    return (size + alignment - 1) / alignment * alignment;
+}
+
+// Return the number of joints in the world
 /**
  * @return Number of joints in the world
  */
@@ -395,6 +1072,66 @@ inline uint DynamicsWorld::getNbJoints() const {
     return mJoints.size();
 }
 
+// Return a rigid body of the world
+/// The index of a body changes when another body is destroyed.
+/**
+ * @param index Index of the body (between zero and getNbRigidBodies() - 1)
+ * @return Pointer to the rigid body
+ */
+inline RigidBody* DynamicsWorld::getRigidBody(uint index) {
+    assert(index < mRigidBodies.size());
+    return mRigidBodies[index];
+}
+
+// Return a joint of the world
+/// The index of a joint changes when another joint is destroyed.
+/**
+ * @param index Index of the joint (between zero and getNbJoints() - 1)
+ * @return Pointer to the joint
+ */
+inline Joint* DynamicsWorld::getJoint(uint index) {
+    assert(index < mJoints.size());
+    return mJoints[index];
+}
+
+// Return the number of particle systems in the world
+/**
+ * @return Number of particle systems in the world
+ */
+inline uint DynamicsWorld::getNbParticleSystems() const {
+    return mParticleSystems.size();
+}
+
+// Return a particle system of the world
+/// The index of a particle system changes when another particle system is destroyed.
+/**
+ * @param index Index of the particle system (between zero and getNbParticleSystems() - 1)
+ * @return Pointer to the particle system
+ */
+inline ParticleSystem* DynamicsWorld::getParticleSystem(uint index) {
+    assert(index < mParticleSystems.size());
+    return mParticleSystems[index];
+}
+
+// Return the number of vehicles in the world
+/**
+ * @return Number of vehicles in the world
+ */
+inline uint DynamicsWorld::getNbVehicles() const {
+    return mVehicles.size();
+}
+
+// Return a vehicle of the world
+/// The index of a vehicle changes when another vehicle is destroyed.
+/**
+ * @param index Index of the vehicle (between zero and getNbVehicles() - 1)
+ * @return Pointer to the vehicle
+ */
+inline Vehicle* DynamicsWorld::getVehicle(uint index) {
+    assert(index < mVehicles.size());
+    return mVehicles[index];
+}
+
 // Return true if the sleeping technique is enabled
 /**
  * @return True if the sleeping technique is enabled and false otherwise
@@ -470,14 +1207,25 @@ inline void DynamicsWorld::setTimeBeforeSleep(decimal timeBeforeSleep) {
              "Dynamics World: timeBeforeSleep= " + std::to_string(timeBeforeSleep));
 }
 
-// Set an event listener object to receive events callbacks.
-/// If you use "nullptr" as an argument, the events callbacks will be disabled.
+// Rebuild the persistent islands of the awake bodies at the next update
+/// The persistent islands are otherwise updated incrementally and an island is only split
+/// once in a while when some of its constraints have been removed. After large changes of
+/// the scene, this method requests a full rebuild of the islands of the awake bodies from
+/// their current contacts and joints (it is done in parallel if a task scheduler is set).
+inline void DynamicsWorld::rebuildIslands() {
+    mIsIslandsRebuildRequested = true;
+}
+
+// Return the impulses of the contact manifolds reported during the last update
+/// The list is only filled if WorldSettings::isContactImpulseReported is true. It contains
+/// the contact manifolds with a total normal impulse larger than the
+/// WorldSettings::contactImpulseReportThreshold during the last substep. The position
+/// based solver does not report any contact impulse.
 /**
- * @param eventListener Pointer to the event listener object that will receive
- *                      event callbacks during the simulation
+ * @return A reference to the list of the reported contact impulses
  */
-inline void DynamicsWorld::setEventListener(EventListener* eventListener) {
-    mEventListener = eventListener;
+inline const List<ContactImpulse>& DynamicsWorld::getContactImpulses() const {
+    return mContactImpulses;
 }
 
 }
@@ -31,6 +31,9 @@
 
 namespace reactphysics3d {
 
+// Declarations
+class Joint;
+
 // Class EventListener
 /**
  * This class can be used to receive event callbacks from the physics engine.
@@ -66,6 +69,14 @@ class EventListener {
         /// engine will do several internal simulation steps. This method is
         /// called at the end of each internal simulation step.
         virtual void endInternalTick() {}
+
+        /// Called when the force or the torque of a joint has exceeded its break threshold.
+        /// The joint is destroyed by the world right after this call, therefore the
+        /// pointer to the joint must not be used anymore when this method returns.
+        /**
+         * @param joint Pointer to the joint that is broken
+         */
+        virtual void jointBroken(Joint* joint) {}
 };
 
 }
@@ -0,0 +1,139 @@
+/********************************************************************************
+* ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
+* Copyright (c) 2010-2018 Daniel Chappuis                                       *
+*********************************************************************************
+*                                                                               *
+* This software is provided 'as-is', without any express or implied warranty.   *
+* In no event will the authors be held liable for any damages arising from the  *
+* use of this software.                                                         *
+*                                                                               *
+* Permission is granted to anyone to use this software for any purpose,         *
+* including commercial applications, and to alter it and redistribute it        *
+* freely, subject to the following restrictions:                                *
+*                                                                               *
+* 1. The origin of this software must not be misrepresented; you must not claim *
+*    that you wrote the original software. If you use this software in a        *
+*    product, an acknowledgment in the product documentation would be           *
+*    appreciated but is not required.                                           *
+*                                                                               *
+* 2. Altered source versions must be plainly marked as such, and must not be    *
+*    misrepresented as being the original software.                             *
+*                                                                               *
+* 3. This notice may not be removed or altered from any source distribution.    *
+*                                                                               *
+********************************************************************************/
+
+// Libraries
+#include "FixedStepScheduler.h"
+#include "engine/DynamicsWorld.h"
+#include <algorithm>
+#include <cmath>
+
+using namespace reactphysics3d;
+
+// Constructor
+/// By default, at most four steps are taken per frame, the time budget of a frame is one
+/// time step and the solvers can go down to half of their nominal numbers of iterations.
+/**
+ * @param world Pointer to the world to step (it must outlive the scheduler)
+ * @param timeStep Fixed time step of the steps (in seconds)
+ */
+FixedStepScheduler::FixedStepScheduler(DynamicsWorld* world, decimal timeStep)
+                   : mWorld(world), mTimeStep(timeStep), mMaxNbStepsPerFrame(4),
+                     mFrameTimeBudget(double(timeStep)), mAccumulator(0.0), mAverageStepCost(0.0),
+                     mNominalNbIterationsVelocity(world->getNbIterationsVelocitySolver()),
+                     mNominalNbIterationsPosition(world->getNbIterationsPositionSolver()),
+                     mMinNbIterationsVelocity(std::max(mNominalNbIterationsVelocity / 2, 1u)),
+                     mMinNbIterationsPosition(std::max(mNominalNbIterationsPosition / 2, 1u)),
+                     mNbStepsLastFrame(0), mNbDroppedSteps(0), mTimeDilation(1.0), mIsBehind(false) {
+
+    assert(world != nullptr);
+    assert(timeStep > decimal(0.0));
+}
+
+// Set the minimum numbers of solver iterations when the scheduler is behind
+/**
+ * @param nbIterationsVelocity Minimum number of iterations of the velocity solver
+ * @param nbIterationsPosition Minimum number of iterations of the position solver
+ */
+void FixedStepScheduler::setMinNbSolverIterations(uint nbIterationsVelocity, uint nbIterationsPosition) {
+
+    mMinNbIterationsVelocity = std::min(nbIterationsVelocity, mNominalNbIterationsVelocity);
+    mMinNbIterationsPosition = std::min(nbIterationsPosition, mNominalNbIterationsPosition);
+}
+
+// Advance the world by the elapsed time of a frame and return the number of steps taken
+/// The elapsed time is accumulated and fixed steps are taken while a whole time step has been
+/// accumulated, up to the maximum number of steps per frame and as long as the cost of the
+/// next step (predicted with the average measured cost of the steps) fits in the time budget
+/// of the frame. The time of the steps that could not be taken is then dropped so that it is
+/// not carried over to the next frames, and the number of solver iterations is adapted.
+/**
+ * @param frameTime Elapsed time since the previous frame (in seconds)
+ * @return The number of steps taken during the frame
+ */
+uint FixedStepScheduler::update(double frameTime) {
+
+    assert(frameTime >= 0.0);
+
+    mAccumulator += frameTime;
+
+    const double timeStep = double(mTimeStep);
+    double frameCost = 0.0;
+    uint nbSteps = 0;
+
+    while (mAccumulator >= timeStep && nbSteps < mMaxNbStepsPerFrame) {
+
+        // Stop if the next step would exceed the time budget of the frame
+        if (nbSteps > 0 && mFrameTimeBudget > 0.0 && frameCost + mAverageStepCost > mFrameTimeBudget) break;
+
+        mWorld->update(mTimeStep);
+        mAccumulator -= timeStep;
+        nbSteps++;
+
+        // Update the average cost of a step with the measured cost of this step
+        const double stepCost = mWorld->getStepStatistics().totalTime;
+        frameCost += stepCost;
+        mAverageStepCost = mAverageStepCost == 0.0 ? stepCost : 0.9 * mAverageStepCost + 0.1 * stepCost;
+    }
+
+    // Drop the time that could not be simulated during this frame
+    mIsBehind = mAccumulator >= timeStep;
+    if (mIsBehind) {
+        const double nbDroppedSteps = std::floor(mAccumulator / timeStep);
+        mNbDroppedSteps += static_cast<uint64>(nbDroppedSteps);
+        mAccumulator -= nbDroppedSteps * timeStep;
+    }
+
+    mNbStepsLastFrame = nbSteps;
+    mTimeDilation = frameTime > 0.0 ? std::min(nbSteps * timeStep / frameTime, 1.0) : 1.0;
+
+    adaptNbSolverIterations();
+
+    return nbSteps;
+}
+
+// Lower or raise the number of solver iterations of the world
+/// The numbers of iterations are changed by one per frame to avoid oscillations between
+/// the frames that are behind and the frames that are not.
+void FixedStepScheduler::adaptNbSolverIterations() {
+
+    uint nbIterationsVelocity = mWorld->getNbIterationsVelocitySolver();
+    uint nbIterationsPosition = mWorld->getNbIterationsPositionSolver();
+
+    if (mIsBehind) {
+        if (nbIterationsVelocity > mMinNbIterationsVelocity) nbIterationsVelocity--;
+        if (nbIterationsPosition > mMinNbIterationsPosition) nbIterationsPosition--;
+    }
+    else {
+        if (nbIterationsVelocity < mNominalNbIterationsVelocity) nbIterationsVelocity++;
+        if (nbIterationsPosition < mNominalNbIterationsPosition) nbIterationsPosition++;
+    }
+
+    if (nbIterationsVelocity != mWorld->getNbIterationsVelocitySolver()) {
+        mWorld->setNbIterationsVelocitySolver(nbIterationsVelocity);
+    }
+    if (nbIterationsPosition != mWorld->getNbIterationsPositionSolver()) {
+        mWorld->setNbIterationsPositionSolver(nbIterationsPosition);
+    }
+}
@@ -0,0 +1,235 @@
+/********************************************************************************
+* ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
+* Copyright (c) 2010-2018 Daniel Chappuis                                       *
+*********************************************************************************
+*                                                                               *
+* This software is provided 'as-is', without any express or implied warranty.   *
+* In no event will the authors be held liable for any damages arising from the  *
+* use of this software.                                                         *
+*                                                                               *
+* Permission is granted to anyone to use this software for any purpose,         *
+* including commercial applications, and to alter it and redistribute it        *
+* freely, subject to the following restrictions:                                *
+*                                                                               *
+* 1. The origin of this software must not be misrepresented; you must not claim *
+*    that you wrote the original software. If you use this software in a        *
+*    product, an acknowledgment in the product documentation would be           *
+*    appreciated but is not required.                                           *
+*                                                                               *
+* 2. Altered source versions must be plainly marked as such, and must not be    *
+*    misrepresented as being the original software.                             *
+*                                                                               *
+* 3. This notice may not be removed or altered from any source distribution.    *
+*                                                                               *
+********************************************************************************/
+
+#ifndef REACTPHYSICS3D_FIXED_STEP_SCHEDULER_H
+#define REACTPHYSICS3D_FIXED_STEP_SCHEDULER_H
+
+// Libraries
+#include "configuration.h"
+#include <cassert>
+
+/// ReactPhysics3D namespace
+namespace reactphysics3d {
+
+// Declarations
+class DynamicsWorld;
+
+// Class FixedStepScheduler
+/**
+ * This class steps a dynamics world with a fixed time step from the elapsed time of the
+ * frames of the application. It accumulates the elapsed time like the Timer class but it
+ * protects the application against the "spiral of death": when a step costs more than
+ * the time it simulates, the accumulated time grows and each frame would run more and
+ * more steps. The scheduler runs at most a given number of steps per frame and stops
+ * when the measured cost of the steps of the frame reaches a time budget (at least one
+ * step is always taken to guarantee progress). The time that cannot be simulated is
+ * dropped, which slows down the simulated time (time dilation) instead of freezing the
+ * application.
+ *
+ * When the scheduler is behind (some time has been dropped), it also lowers the number
+ * of iterations of the velocity and position solvers of the world by one per frame down
+ * to a minimum, and raises them back by one per frame to their nominal values when it
+ * has caught up again. An overloaded world therefore degrades gracefully by trading
+ * accuracy for speed. The nominal numbers of iterations are the ones of the world when
+ * the scheduler is created.
+ */
+class FixedStepScheduler {
+
+    private :
+
+        // -------------------- Attributes -------------------- //
+
+        /// Stepped world
+        DynamicsWorld* mWorld;
+
+        /// Fixed time step of the steps
+        decimal mTimeStep;
+
+        /// Maximum number of steps per frame
+        uint mMaxNbStepsPerFrame;
+
+        /// Maximum measured cost in seconds of the steps of a frame (zero for no budget)
+        double mFrameTimeBudget;
+
+        /// Accumulated time that has not been simulated yet
+        double mAccumulator;
+
+        /// Average measured cost of a step in seconds
+        double mAverageStepCost;
+
+        /// Nominal number of iterations of the velocity solver
+        uint mNominalNbIterationsVelocity;
+
+        /// Nominal number of iterations of the position solver
+        uint mNominalNbIterationsPosition;
+
+        /// Minimum number of iterations of the velocity solver when the scheduler is behind
+        uint mMinNbIterationsVelocity;
+
+        /// Minimum number of iterations of the position solver when the scheduler is behind
+        uint mMinNbIterationsPosition;
+
+        /// Number of steps taken during the last frame
+        uint mNbStepsLastFrame;
+
+        /// Number of steps dropped since the creation of the scheduler
+        uint64 mNbDroppedSteps;
+
+        /// Ratio between the simulated time and the elapsed time of the last frame
+        double mTimeDilation;
+
+        /// True if some time has been dropped during the last frame
+        bool mIsBehind;
+
+        // -------------------- Methods -------------------- //
+
+        /// Lower or raise the number of solver iterations of the world
+        void adaptNbSolverIterations();
+
+    public :
+
+        // -------------------- Methods -------------------- //
+
+        /// Constructor
+        FixedStepScheduler(DynamicsWorld* world, decimal timeStep);
+
+        /// Destructor
+        ~FixedStepScheduler() = default;
+
+        /// Deleted copy-constructor
+        FixedStepScheduler(const FixedStepScheduler& scheduler) = delete;
+
+        /// Deleted assignment operator
+        FixedStepScheduler& operator=(const FixedStepScheduler& scheduler) = delete;
+
+        /// Advance the world by the elapsed time of a frame and return the number of steps taken
+        uint update(double frameTime);
+
+        /// Return the fixed time step of the steps
+        decimal getTimeStep() const;
+
+        /// Return the maximum number of steps per frame
+        uint getMaxNbStepsPerFrame() const;
+
+        /// Set the maximum number of steps per frame
+        void setMaxNbStepsPerFrame(uint maxNbSteps);
+
+        /// Return the maximum measured cost in seconds of the steps of a frame
+        double getFrameTimeBudget() const;
+
+        /// Set the maximum measured cost in seconds of the steps of a frame
+        void setFrameTimeBudget(double budget);
+
+        /// Set the minimum numbers of solver iterations when the scheduler is behind
+        void setMinNbSolverIterations(uint nbIterationsVelocity, uint nbIterationsPosition);
+
+        /// Return the interpolation factor between the last two steps for the rendering
+        decimal computeInterpolationFactor() const;
+
+        /// Return the average measured cost of a step in seconds
+        double getAverageStepCost() const;
+
+        /// Return the number of steps taken during the last frame
+        uint getNbStepsLastFrame() const;
+
+        /// Return the number of steps dropped since the creation of the scheduler
+        uint64 getNbDroppedSteps() const;
+
+        /// Return the ratio between the simulated time and the elapsed time of the last frame
+        double getTimeDilation() const;
+
+        /// Return true if some time has been dropped during the last frame
+        bool isBehind() const;
+};
+
+// Return the fixed time step of the steps
+inline decimal FixedStepScheduler::getTimeStep() const {
+    return mTimeStep;
+}
+
+// Return the maximum number of steps per frame
+inline uint FixedStepScheduler::getMaxNbStepsPerFrame() const {
+    return mMaxNbStepsPerFrame;
+}
+
+// Set the maximum number of steps per frame
+/**
+ * @param maxNbSteps Maximum number of steps per frame (at least one)
+ */
+inline void FixedStepScheduler::setMaxNbStepsPerFrame(uint maxNbSteps) {
+    assert(maxNbSteps > 0);
+    mMaxNbStepsPerFrame = maxNbSteps;
+}
+
+// Return the maximum measured cost in seconds of the steps of a frame
+inline double FixedStepScheduler::getFrameTimeBudget() const {
+    return mFrameTimeBudget;
+}
+
+// Set the maximum measured cost in seconds of the steps of a frame
+/**
+ * @param budget Time budget in seconds (zero to only limit the number of steps per frame)
+ */
+inline void FixedStepScheduler::setFrameTimeBudget(double budget) {
+    assert(budget >= 0.0);
+    mFrameTimeBudget = budget;
+}
+
+// Return the interpolation factor between the last two steps for the rendering
+/**
+ * @return The fraction of a time step that has been accumulated but not simulated yet
+ */
+inline decimal FixedStepScheduler::computeInterpolationFactor() const {
+    return decimal(mAccumulator / double(mTimeStep));
+}
+
+// Return the average measured cost of a step in seconds
+inline double FixedStepScheduler::getAverageStepCost() const {
+    return mAverageStepCost;
+}
+
+// Return the number of steps taken during the last frame
+inline uint FixedStepScheduler::getNbStepsLastFrame() const {
+    return mNbStepsLastFrame;
+}
+
+// Return the number of steps dropped since the creation of the scheduler
+inline uint64 FixedStepScheduler::getNbDroppedSteps() const {
+    return mNbDroppedSteps;
+}
+
+// Return the ratio between the simulated time and the elapsed time of the last frame
+inline double FixedStepScheduler::getTimeDilation() const {
+    return mTimeDilation;
+}
+
+// Return true if some time has been dropped during the last frame
+inline bool FixedStepScheduler::isBehind() const {
+    return mIsBehind;
+}
+
+}
+
+#endif
@@ -32,15 +32,20 @@ using namespace reactphysics3d;
 // Constructor
 Island::Island(uint nbMaxBodies, uint nbMaxContactManifolds, uint nbMaxJoints, MemoryManager& memoryManager)
        : mBodies(nullptr), mContactManifolds(nullptr), mJoints(nullptr), mNbBodies(0),
-         mNbContactManifolds(0), mNbJoints(0) {
+         mBodiesFirstArrayIndex(0), mNbContactManifolds(0), mNbJoints(0),
+         mContactManifoldsColorsFirstIndex(nullptr),
+         mNbContactManifoldsColors(0), mJointsColorsFirstIndex(nullptr), mNbJointsColors(0),
+         mNbVelocitySolverIterations(0), mNbPositionSolverIterations(0),
+         mNbDoneVelocitySolverIterations(0), mPersistentIslandRoot(nullptr),
+         mSimulationLevelOfDetail(NB_SIMULATION_LEVELS_OF_DETAIL - 1) {
 
     // Allocate memory for the arrays on the single frame allocator
     mBodies = static_cast<RigidBody**>(memoryManager.allocate(MemoryManager::AllocationType::Frame,
-                                                              sizeof(RigidBody*) * nbMaxBodies));
+                                                              sizeof(RigidBody*) * nbMaxBodies, MemoryTag::Solver));
     mContactManifolds = static_cast<ContactManifold**>(memoryManager.allocate(MemoryManager::AllocationType::Frame,
-                                                                              sizeof(ContactManifold*) * nbMaxContactManifolds));
+                                                                              sizeof(ContactManifold*) * nbMaxContactManifolds, MemoryTag::Solver));
     mJoints = static_cast<Joint**>(memoryManager.allocate(MemoryManager::AllocationType::Frame,
-                                                          sizeof(Joint*) * nbMaxJoints));
+                                                          sizeof(Joint*) * nbMaxJoints, MemoryTag::Solver));
 }
 
 // Destructor
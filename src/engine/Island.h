@@ -59,12 +59,45 @@ class Island {
         /// Current number of bodies in the island
         uint mNbBodies;
 
+        /// Index of the first body of the island in the velocity and position arrays of the
+        /// current step (the bodies of the island are contiguous in these arrays)
+        uint mBodiesFirstArrayIndex;
+
         /// Current number of contact manifold in the island
         uint mNbContactManifolds;
 
         /// Current number of joints in the island
         uint mNbJoints;
 
+        /// Index of the first contact manifold of each color in the contact manifolds array
+        /// (the last element is the number of contact manifolds) or null if not colored
+        uint* mContactManifoldsColorsFirstIndex;
+
+        /// Number of colors of the contact manifolds
+        uint mNbContactManifoldsColors;
+
+        /// Index of the first joint of each color in the joints array (the last
+        /// element is the number of joints) or null if not colored
+        uint* mJointsColorsFirstIndex;
+
+        /// Number of colors of the joints
+        uint mNbJointsColors;
+
+        /// Maximum number of iterations of the velocity solver for the island
+        uint mNbVelocitySolverIterations;
+
+        /// Number of iterations of the position solver for the island
+        uint mNbPositionSolverIterations;
+
+        /// Number of velocity solver iterations done for the island during the current step
+        uint mNbDoneVelocitySolverIterations;
+
+        /// Root body of the persistent island from which the island has been created
+        RigidBody* mPersistentIslandRoot;
+
+        /// Simulation level of detail of the island (the smallest one of its awake bodies)
+        uint mSimulationLevelOfDetail;
+
     public:
 
         // -------------------- Methods -------------------- //
@@ -109,14 +142,39 @@ class Island {
         /// Return a pointer to the array of joints
         Joint** getJoints();
 
+        /// Return the number of colors of the contact manifolds (zero if not colored)
+        uint getNbContactManifoldsColors() const;
+
+        /// Return the index of the first contact manifold of each color
+        const uint* getContactManifoldsColorsFirstIndex() const;
+
+        /// Return the number of colors of the joints (zero if not colored)
+        uint getNbJointsColors() const;
+
+        /// Return the index of the first joint of each color
+        const uint* getJointsColorsFirstIndex() const;
+
+        /// Return the maximum number of iterations of the velocity solver for the island
+        uint getNbVelocitySolverIterations() const;
+
+        /// Return the number of iterations of the position solver for the island
+        uint getNbPositionSolverIterations() const;
+
+        /// Return the number of velocity solver iterations done for the island during the current step
+        uint getNbDoneVelocitySolverIterations() const;
+
+        /// Return the simulation level of detail of the island
+        uint getSimulationLevelOfDetail() const;
+
         // -------------------- Friendship -------------------- //
 
         friend class DynamicsWorld;
 };
 
 // Add a body into the island
+/// A sleeping body is only added as a fixed body of the island with the partial wake-up
+/// (see DynamicsWorld::addFixedBodyToIsland()).
 inline void Island::addBody(RigidBody* body) {
-    assert(!body->isSleeping());
     mBodies[mNbBodies] = body;
     mNbBodies++;
 }
@@ -163,6 +221,53 @@ inline Joint** Island::getJoints() {
     return mJoints;
 }
 
+// Return the number of colors of the contact manifolds (zero if not colored)
+/// The contact manifolds of a color are contiguous in the contact manifolds array
+/// and do not share any dynamic body.
+inline uint Island::getNbContactManifoldsColors() const {
+    return mNbContactManifoldsColors;
+}
+
+// Return the index of the first contact manifold of each color
+inline const uint* Island::getContactManifoldsColorsFirstIndex() const {
+    return mContactManifoldsColorsFirstIndex;
+}
+
+// Return the number of colors of the joints (zero if not colored)
+/// The joints of a color are contiguous in the joints array and do not share any body.
+inline uint Island::getNbJointsColors() const {
+    return mNbJointsColors;
+}
+
+// Return the index of the first joint of each color
+inline const uint* Island::getJointsColorsFirstIndex() const {
+    return mJointsColorsFirstIndex;
+}
+
+// Return the maximum number of iterations of the velocity solver for the island
+/// This is the number of iterations of the world unless a SolverIterationsPolicy is
+/// used. The velocity solver can do less iterations if its early exit is enabled.
+inline uint Island::getNbVelocitySolverIterations() const {
+    return mNbVelocitySolverIterations;
+}
+
+// Return the number of iterations of the position solver for the island
+inline uint Island::getNbPositionSolverIterations() const {
+    return mNbPositionSolverIterations;
+}
+
+// Return the number of velocity solver iterations done for the island during the current step
+/// This is the sum of the iterations of all the substeps of the step.
+inline uint Island::getNbDoneVelocitySolverIterations() const {
+    return mNbDoneVelocitySolverIterations;
+}
+
+// Return the simulation level of detail of the island
+/// The island is simulated every 2^L steps of the world where L is its level of detail.
+inline uint Island::getSimulationLevelOfDetail() const {
+    return mSimulationLevelOfDetail;
+}
+
 }
 
 #endif
@@ -32,13 +32,14 @@ using namespace reactphysics3d;
 Material::Material(const WorldSettings& worldSettings)
          : mFrictionCoefficient(worldSettings.defaultFrictionCoefficient),
            mRollingResistance(worldSettings.defaultRollingRestistance),
-           mBounciness(worldSettings.defaultBounciness) {
+           mBounciness(worldSettings.defaultBounciness), mId(UNREGISTERED_ID) {
 
 }
 
 // Copy-constructor
 Material::Material(const Material& material)
          : mFrictionCoefficient(material.mFrictionCoefficient),
-           mRollingResistance(material.mRollingResistance), mBounciness(material.mBounciness) {
+           mRollingResistance(material.mRollingResistance), mBounciness(material.mBounciness),
+           mId(material.mId) {
 
 }
@@ -32,6 +32,9 @@
 
 namespace reactphysics3d {
 
+// Declarations
+class MaterialTable;
+
 // Class Material
 /**
  * This class contains the material properties of a rigid body that will be use for
@@ -53,8 +56,19 @@ class Material {
         /// Bounciness during collisions (between 0 and 1) where 1 is for a very bouncy body
         decimal mBounciness;
 
+        /// ID of the material in the material table of the world (UNREGISTERED_ID if not registered)
+        uint16 mId;
+
     public :
 
+        // -------------------- Constants -------------------- //
+
+        /// ID of the default material of the bodies in the material table of the world
+        static const uint16 DEFAULT_ID = 0;
+
+        /// ID of a material that is not registered in a material table
+        static const uint16 UNREGISTERED_ID = 0xFFFF;
+
         // -------------------- Methods -------------------- //
 
         /// Constructor
@@ -84,11 +98,18 @@ class Material {
         /// Set the rolling resistance factor
         void setRollingResistance(decimal rollingResistance);
 
+        /// Return the ID of the material in the material table of the world
+        uint16 getId() const;
+
         /// Return a string representation for the material
         std::string to_string() const;
 
         /// Overloaded assignment operator
         Material& operator=(const Material& material);
+
+        // -------------------- Friendship -------------------- //
+
+        friend class MaterialTable;
 };
 
 // Return the bounciness
@@ -108,6 +129,7 @@ inline decimal Material::getBounciness() const {
 inline void Material::setBounciness(decimal bounciness) {
     assert(bounciness >= decimal(0.0) && bounciness <= decimal(1.0));
     mBounciness = bounciness;
+    mId = UNREGISTERED_ID;
 }
 
 // Return the friction coefficient
@@ -127,6 +149,7 @@ inline decimal Material::getFrictionCoefficient() const {
 inline void Material::setFrictionCoefficient(decimal frictionCoefficient) {
     assert(frictionCoefficient >= decimal(0.0));
     mFrictionCoefficient = frictionCoefficient;
+    mId = UNREGISTERED_ID;
 }
 
 // Return the rolling resistance factor. If this value is larger than zero,
@@ -148,6 +171,16 @@ inline decimal Material::getRollingResistance() const {
 inline void Material::setRollingResistance(decimal rollingResistance) {
     assert(rollingResistance >= 0);
     mRollingResistance = rollingResistance;
+    mId = UNREGISTERED_ID;
+}
+
+// Return the ID of the material in the material table of the world
+/// A modified material is not registered anymore and its ID is UNREGISTERED_ID.
+/**
+ * @return The ID of the material or UNREGISTERED_ID if the material is not registered
+ */
+inline uint16 Material::getId() const {
+    return mId;
 }
 
 // Return a string representation for the material
@@ -170,6 +203,7 @@ inline Material& Material::operator=(const Material& material) {
         mFrictionCoefficient = material.mFrictionCoefficient;
         mBounciness = material.mBounciness;
         mRollingResistance = material.mRollingResistance;
+        mId = material.mId;
     }
 
     // Return this material
@@ -0,0 +1,107 @@
+/********************************************************************************
+* ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
+* Copyright (c) 2010-2018 Daniel Chappuis                                       *
+*********************************************************************************
+*                                                                               *
+* This software is provided 'as-is', without any express or implied warranty.   *
+* In no event will the authors be held liable for any damages arising from the  *
+* use of this software.                                                         *
+*                                                                               *
+* Permission is granted to anyone to use this software for any purpose,         *
+* including commercial applications, and to alter it and redistribute it        *
+* freely, subject to the following restrictions:                                *
+*                                                                               *
+* 1. The origin of this software must not be misrepresented; you must not claim *
+*    that you wrote the original software. If you use this software in a        *
+*    product, an acknowledgment in the product documentation would be           *
+*    appreciated but is not required.                                           *
+*                                                                               *
+* 2. Altered source versions must be plainly marked as such, and must not be    *
+*    misrepresented as being the original software.                             *
+*                                                                               *
+* 3. This notice may not be removed or altered from any source distribution.    *
+*                                                                               *
+********************************************************************************/
+
+// Libraries
+#include "MaterialTable.h"
+#include <cmath>
+#include <algorithm>
+
+using namespace reactphysics3d;
+
+// Constructor
+/// The default material of the bodies is registered with the ID zero.
+MaterialTable::MaterialTable(const WorldSettings& worldSettings, MemoryAllocator& allocator)
+              : mMaterials(allocator), mPairsProperties(allocator) {
+
+    Material defaultMaterial(worldSettings);
+    registerMaterial(defaultMaterial);
+    assert(defaultMaterial.getId() == Material::DEFAULT_ID);
+}
+
+// Combine the properties of two materials with the default combine rules
+/// The friction coefficient is the geometric mean of the two coefficients, the bounciness is
+/// the largest one and the rolling resistance factor is the mean of the two factors.
+MaterialPairProperties MaterialTable::combineMaterials(const Material& material1, const Material& material2) {
+
+    MaterialPairProperties properties;
+    properties.frictionCoefficient = std::sqrt(material1.getFrictionCoefficient() * material2.getFrictionCoefficient());
+    properties.bounciness = std::max(material1.getBounciness(), material2.getBounciness());
+    properties.rollingResistance = decimal(0.5) * (material1.getRollingResistance() + material2.getRollingResistance());
+
+    return properties;
+}
+
+// Register a material and return its ID
+/**
+ * The ID of the material is set and the properties of its pairs with all the registered
+ * materials are computed with the default combine rules. The material can then be given to
+ * the bodies of the world with RigidBody::setMaterial().
+ * @param material The material to register
+ * @return The ID of the material in the table
+ */
+uint16 MaterialTable::registerMaterial(Material& material) {
+
+    const uint nbMaterials = mMaterials.size();
+    assert(nbMaterials < Material::UNREGISTERED_ID);
+
+    material.mId = static_cast<uint16>(nbMaterials);
+    mMaterials.add(material);
+
+    // Copy the properties of the pairs (with their overrides) into a larger table
+    // and combine the new pairs
+    const uint newNbMaterials = nbMaterials + 1;
+    const List<MaterialPairProperties> oldPairsProperties(mPairsProperties);
+    mPairsProperties.clear();
+    mPairsProperties.reserve(newNbMaterials * newNbMaterials);
+    for (uint i=0; i < newNbMaterials; i++) {
+        for (uint j=0; j < newNbMaterials; j++) {
+            if (i < nbMaterials && j < nbMaterials) {
+                mPairsProperties.add(oldPairsProperties[i * nbMaterials + j]);
+            }
+            else {
+                mPairsProperties.add(combineMaterials(mMaterials[i], mMaterials[j]));
+            }
+        }
+    }
+
+    return material.mId;
+}
+
+// Override the combined properties of a pair of registered materials
+/**
+ * @param materialId1 The ID of the first material
+ * @param materialId2 The ID of the second material
+ * @param properties The combined properties of the contacts between the two materials
+ */
+void MaterialTable::setPairProperties(uint16 materialId1, uint16 materialId2, const MaterialPairProperties& properties) {
+
+    assert(materialId1 < mMaterials.size() && materialId2 < mMaterials.size());
+    assert(properties.frictionCoefficient >= decimal(0.0));
+    assert(properties.bounciness >= decimal(0.0) && properties.bounciness <= decimal(1.0));
+    assert(properties.rollingResistance >= decimal(0.0));
+
+    mPairsProperties[materialId1 * mMaterials.size() + materialId2] = properties;
+    mPairsProperties[materialId2 * mMaterials.size() + materialId1] = properties;
+}
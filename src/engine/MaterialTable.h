@@ -0,0 +1,152 @@
+/********************************************************************************
+* ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
+* Copyright (c) 2010-2018 Daniel Chappuis                                       *
+*********************************************************************************
+*                                                                               *
+* This software is provided 'as-is', without any express or implied warranty.   *
+* In no event will the authors be held liable for any damages arising from the  *
+* use of this software.                                                         *
+*                                                                               *
+* Permission is granted to anyone to use this software for any purpose,         *
+* including commercial applications, and to alter it and redistribute it        *
+* freely, subject to the following restrictions:                                *
+*                                                                               *
+* 1. The origin of this software must not be misrepresented; you must not claim *
+*    that you wrote the original software. If you use this software in a        *
+*    product, an acknowledgment in the product documentation would be           *
+*    appreciated but is not required.                                           *
+*                                                                               *
+* 2. Altered source versions must be plainly marked as such, and must not be    *
+*    misrepresented as being the original software.                             *
+*                                                                               *
+* 3. This notice may not be removed or altered from any source distribution.    *
+*                                                                               *
+********************************************************************************/
+
+#ifndef REACTPHYSICS3D_MATERIAL_TABLE_H
+#define REACTPHYSICS3D_MATERIAL_TABLE_H
+
+// Libraries
+#include "engine/Material.h"
+#include "containers/List.h"
+
+namespace reactphysics3d {
+
+// Structure MaterialPairProperties
+/**
+ * This structure contains the combined material properties used by the contact
+ * solvers for the contacts between the bodies of two materials.
+ */
+struct MaterialPairProperties {
+
+    // -------------------- Attributes -------------------- //
+
+    /// Friction coefficient of the contacts
+    decimal frictionCoefficient;
+
+    /// Bounciness (restitution factor) of the contacts
+    decimal bounciness;
+
+    /// Rolling resistance factor of the contacts
+    decimal rollingResistance;
+};
+
+// Class MaterialTable
+/**
+ * This class contains the materials registered in a dynamics world and the combined
+ * properties of each pair of registered materials. A registered material has a small
+ * integer ID and the properties of a pair are precomputed in a dense table, so the contact
+ * solvers only have to read one entry of the table for each contact manifold. The combined
+ * properties of a pair can be overridden (for instance to give a very low friction to ice
+ * on rubber). The default material of the bodies (built from the world settings) is
+ * registered with the ID zero. A material whose properties are changed after its
+ * registration is not registered anymore and the properties of its pairs are computed
+ * with the default combine rules for each contact manifold.
+ */
+class MaterialTable {
+
+    private :
+
+        // -------------------- Attributes -------------------- //
+
+        /// Registered materials (indexed by their IDs)
+        List<Material> mMaterials;
+
+        /// Combined properties of each pair of registered materials (row-major square table)
+        List<MaterialPairProperties> mPairsProperties;
+
+        // -------------------- Methods -------------------- //
+
+        /// Combine the properties of two materials with the default combine rules
+        static MaterialPairProperties combineMaterials(const Material& material1, const Material& material2);
+
+    public :
+
+        // -------------------- Methods -------------------- //
+
+        /// Constructor
+        MaterialTable(const WorldSettings& worldSettings, MemoryAllocator& allocator);
+
+        /// Destructor
+        ~MaterialTable() = default;
+
+        /// Register a material and return its ID
+        uint16 registerMaterial(Material& material);
+
+        /// Return the number of registered materials
+        uint getNbMaterials() const;
+
+        /// Return a registered material
+        const Material& getMaterial(uint16 materialId) const;
+
+        /// Override the combined properties of a pair of registered materials
+        void setPairProperties(uint16 materialId1, uint16 materialId2, const MaterialPairProperties& properties);
+
+        /// Return the combined properties of a pair of registered materials
+        const MaterialPairProperties& getPairProperties(uint16 materialId1, uint16 materialId2) const;
+
+        /// Return the combined properties of two materials (registered or not)
+        MaterialPairProperties computePairProperties(const Material& material1, const Material& material2) const;
+};
+
+// Return the number of registered materials
+inline uint MaterialTable::getNbMaterials() const {
+    return mMaterials.size();
+}
+
+// Return a registered material
+/**
+ * @param materialId The ID of the material
+ * @return The registered material
+ */
+inline const Material& MaterialTable::getMaterial(uint16 materialId) const {
+    assert(materialId < mMaterials.size());
+    return mMaterials[materialId];
+}
+
+// Return the combined properties of a pair of registered materials
+/**
+ * @param materialId1 The ID of the first material
+ * @param materialId2 The ID of the second material
+ * @return The combined properties of the two materials
+ */
+inline const MaterialPairProperties& MaterialTable::getPairProperties(uint16 materialId1, uint16 materialId2) const {
+    assert(materialId1 < mMaterials.size() && materialId2 < mMaterials.size());
+    return mPairsProperties[materialId1 * mMaterials.size() + materialId2];
+}
+
+// Return the combined properties of two materials (registered or not)
+/// The properties of two registered materials are read in the table and the properties
+/// are combined with the default rules if one of the materials is not registered.
+inline MaterialPairProperties MaterialTable::computePairProperties(const Material& material1,
+                                                                   const Material& material2) const {
+    if (material1.getId() != Material::UNREGISTERED_ID && material2.getId() != Material::UNREGISTERED_ID) {
+        return getPairProperties(material1.getId(), material2.getId());
+    }
+
+    return combineMaterials(material1, material2);
+}
+
+}
+
+#endif
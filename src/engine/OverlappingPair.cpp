@@ -30,6 +30,9 @@
 #include "collision/NarrowPhaseInfo.h"
 #include "containers/containers_common.h"
 #include "collision/ContactPointInfo.h"
+#include "engine/WorldState.h"
+#include <algorithm>
+#include <cmath>
 
 using namespace reactphysics3d;
 
@@ -39,23 +42,16 @@ OverlappingPair::OverlappingPair(ProxyShape* shape1, ProxyShape* shape2,
                                  const WorldSettings& worldSettings)
                 : mContactManifoldSet(shape1, shape2, persistentMemoryAllocator, worldSettings), mPotentialContactManifolds(nullptr),
                   mPersistentAllocator(persistentMemoryAllocator), mTempMemoryAllocator(temporaryMemoryAllocator),
-                  mLastFrameCollisionInfos(mPersistentAllocator), mWorldSettings(worldSettings) {
+                  mHasConvexLastFrameCollisionInfo(false), mConcaveLastFrameCollisionInfos(mPersistentAllocator),
+                  mWorldSettings(worldSettings),
+                  mLastNarrowPhaseRelativeTransform(Transform::identity()), mNbFramesContactsReused(0),
+                  mHadContacts(false), mIsLastFrameInfoAdditionDeferred(false) {
     
 }         
 
 // Destructor
 OverlappingPair::~OverlappingPair() {
 	assert(mPotentialContactManifolds == nullptr);
-
-    // Remove all the remaining last frame collision info
-    for (auto it = mLastFrameCollisionInfos.begin(); it != mLastFrameCollisionInfos.end(); ++it) {
-
-        // Call the constructor
-        it->second->~LastFrameCollisionInfo();
-
-        // Release memory
-        mPersistentAllocator.release(it->second, sizeof(LastFrameCollisionInfo));
-    }
 }
 
 // Create a new potential contact manifold using contact-points from narrow-phase
@@ -63,11 +59,27 @@ void OverlappingPair::addPotentialContactPoints(NarrowPhaseInfo* narrowPhaseInfo
 
     assert(narrowPhaseInfo->contactPoints != nullptr);
 
-    // For each potential contact point to add
-    ContactPointInfo* contactPoint = narrowPhaseInfo->contactPoints;
-    while (contactPoint != nullptr) {
+    const Transform& shape1ToWorldTransform = mContactManifoldSet.getShape1()->getLocalToWorldTransform();
+
+    // The contact points of a child of a compound shape are in local-space of the child. We
+    // convert them into the local-space of the compound shape (the space of the proxy shape)
+    const bool isShape1Compound = getShape1()->getCollisionShape()->getType() == CollisionShapeType::COMPOUND;
+    const bool isShape2Compound = getShape2()->getCollisionShape()->getType() == CollisionShapeType::COMPOUND;
+    if (isShape1Compound || isShape2Compound) {
+
+        const Transform child1ToShape1 = shape1ToWorldTransform.getInverse() * narrowPhaseInfo->shape1ToWorldTransform;
+        const Transform child2ToShape2 = getShape2()->getLocalToWorldTransform().getInverse() *
+                                         narrowPhaseInfo->shape2ToWorldTransform;
+        for (ContactPointInfo* contactPoint = narrowPhaseInfo->contactPoints; contactPoint != nullptr;
+             contactPoint = contactPoint->next) {
+            if (isShape1Compound) contactPoint->localPoint1 = child1ToShape1 * contactPoint->localPoint1;
+            if (isShape2Compound) contactPoint->localPoint2 = child2ToShape2 * contactPoint->localPoint2;
+        }
+    }
 
-        ContactPointInfo* nextContactPoint = contactPoint->next;
+    // For each potential contact point to add
+    for (const ContactPointInfo* contactPoint = narrowPhaseInfo->contactPoints; contactPoint != nullptr;
+         contactPoint = contactPoint->next) {
 
         // Look if the contact point correspond to an existing potential manifold
         // (if the contact point normal is similar to the normal of an existing manifold)
@@ -76,15 +88,15 @@ void OverlappingPair::addPotentialContactPoints(NarrowPhaseInfo* narrowPhaseInfo
         while(manifold != nullptr) {
 
             // Get the first contact point
-            const ContactPointInfo* point = manifold->getFirstContactPointInfo();
-            assert(point != nullptr);
+            assert(manifold->getNbContactPoints() > 0);
+            const ContactPointInfo* point = &manifold->getContactPointInfo(0);
 
             // If we have found a corresponding manifold for the new contact point
             // (a manifold with a similar contact normal direction)
             if (point->normal.dot(contactPoint->normal) >= mWorldSettings.cosAngleSimilarContactManifold) {
 
                 // Add the contact point to the manifold
-                manifold->addContactPoint(contactPoint);
+                manifold->addContactPoint(*contactPoint, shape1ToWorldTransform);
 
                similarManifoldFound = true;
 
@@ -99,22 +111,61 @@ void OverlappingPair::addPotentialContactPoints(NarrowPhaseInfo* narrowPhaseInfo
 
             // Create a new potential contact manifold
             ContactManifoldInfo* manifoldInfo = new (mTempMemoryAllocator.allocate(sizeof(ContactManifoldInfo)))
-                                            ContactManifoldInfo(mTempMemoryAllocator);
+                                            ContactManifoldInfo();
 
             // Add the manifold into the linked-list of potential contact manifolds
             manifoldInfo->mNext = mPotentialContactManifolds;
             mPotentialContactManifolds = manifoldInfo;
 
             // Add the contact point to the manifold
-            manifoldInfo->addContactPoint(contactPoint);
+            manifoldInfo->addContactPoint(*contactPoint, shape1ToWorldTransform);
         }
-
-        contactPoint = nextContactPoint;
     }
 
-    // All the contact point info of the narrow-phase info have been moved
+    // All the contact point info of the narrow-phase info have been copied
     // into the potential contacts of the overlapping pair
-    narrowPhaseInfo->contactPoints = nullptr;
+    narrowPhaseInfo->resetContactPoints();
+}
+
+// Reuse the contacts of the previous frame if the shapes have almost not moved
+/// The contacts are reused (and the narrow-phase of the pair does not have to be computed)
+/// if the pair has some contacts, if the relative transform of the shapes has changed less
+/// than the thresholds of the world settings since the last narrow-phase of the pair and if
+/// the contacts have not been reused for too many frames already. Otherwise, the current
+/// relative transform is stored for the narrow-phase that has to be computed.
+/**
+ * @return True if the contacts of the previous frame have been reused
+ */
+bool OverlappingPair::reuseContacts() {
+
+    const Transform relativeTransform = getShape1()->getLocalToWorldTransform().getInverse() *
+                                        getShape2()->getLocalToWorldTransform();
+
+    if (mContactManifoldSet.getNbContactManifolds() > 0 &&
+        mNbFramesContactsReused < mWorldSettings.nbMaxFramesContactReuse) {
+
+        // Compute the relative motion since the last narrow-phase
+        const decimal translation = (relativeTransform.getPosition() -
+                                     mLastNarrowPhaseRelativeTransform.getPosition()).length();
+        const Quaternion rotation = relativeTransform.getOrientation() *
+                                    mLastNarrowPhaseRelativeTransform.getOrientation().getInverse();
+        const decimal sinHalfAngle = std::min(rotation.getVectorV().length(), decimal(1.0));
+        const decimal angle = decimal(2.0) * std::asin(sinHalfAngle);
+
+        if (translation <= mWorldSettings.contactReuseTranslationThreshold &&
+            angle <= mWorldSettings.contactReuseRotationThreshold) {
+
+            mContactManifoldSet.reuseContacts();
+            mNbFramesContactsReused++;
+
+            return true;
+        }
+    }
+
+    mLastNarrowPhaseRelativeTransform = relativeTransform;
+    mNbFramesContactsReused = 0;
+
+    return false;
 }
 
 // Clear all the potential contact manifolds
@@ -138,12 +189,14 @@ void OverlappingPair::clearPotentialContactManifolds() {
 // Reduce the number of contact points of all the potential contact manifolds
 void OverlappingPair::reducePotentialContactManifolds() {
 
+    const uint nbMaxContactPoints = static_cast<uint>(mContactManifoldSet.computeNbMaxContactPointsInManifold());
+
     // For each potential contact manifold
     ContactManifoldInfo* manifold = mPotentialContactManifolds;
     while (manifold != nullptr) {
 
         // Reduce the number of contact points of the manifold
-        manifold->reduce(mContactManifoldSet.getShape1()->getLocalToWorldTransform());
+        manifold->reduce(mContactManifoldSet.getShape1()->getLocalToWorldTransform(), nbMaxContactPoints);
 
         manifold = manifold->getNext();
     }
@@ -151,55 +204,145 @@ void OverlappingPair::reducePotentialContactManifolds() {
 
 
 // Add a new last frame collision info if it does not exist for the given shapes already
+/// The collision info of a convex pair is stored in the pair. The collision info of a concave
+/// pair is inserted at its sorted position in the list of the pair. Nothing is done while the
+/// addition is deferred (see setIsLastFrameInfoAdditionDeferred()).
 void OverlappingPair::addLastFrameInfoIfNecessary(uint shapeId1, uint shapeId2) {
 
-    // Try to get the corresponding last frame collision info
-    const ShapeIdPair shapeIdPair(shapeId1, shapeId2);
-    auto it = mLastFrameCollisionInfos.find(shapeIdPair);
+    if (mIsLastFrameInfoAdditionDeferred) return;
+
+    if (!hasConcaveShape()) {
+
+        // If there is no collision info for those two shapes already
+        if (!mHasConvexLastFrameCollisionInfo) {
+            mConvexLastFrameCollisionInfo = LastFrameCollisionInfo();
+            mHasConvexLastFrameCollisionInfo = true;
+        }
+        else {
+
+            // The existing collision info is not obsolete
+            mConvexLastFrameCollisionInfo.isObsolete = false;
+        }
 
-    // If there is no collision info for those two shapes already
-    if (it == mLastFrameCollisionInfos.end()) {
+        return;
+    }
 
-        // Create a new collision info
-        LastFrameCollisionInfo* collisionInfo = new (mPersistentAllocator.allocate(sizeof(LastFrameCollisionInfo)))
-                                                LastFrameCollisionInfo();
+    const uint index = findConcaveLastFrameCollisionInfo(shapeId1, shapeId2);
+    if (index < mConcaveLastFrameCollisionInfos.size()) {
+        ShapesLastFrameCollisionInfo& element = mConcaveLastFrameCollisionInfos[index];
+        if (element.shapeIds.first == shapeId1 && element.shapeIds.second == shapeId2) {
 
-        // Add it into the map of collision infos
-        mLastFrameCollisionInfos.add(Pair<ShapeIdPair, LastFrameCollisionInfo*>(shapeIdPair, collisionInfo));
+            // The existing collision info is not obsolete
+            element.info.isObsolete = false;
+            return;
+        }
     }
-    else {
 
-       // The existing collision info is not obsolete
-       it->second->isObsolete = false;
+    // Create a new collision info at the end of the list and move it to its sorted position
+    mConcaveLastFrameCollisionInfos.emplace(ShapeIdPair(shapeId1, shapeId2));
+    for (uint i = static_cast<uint>(mConcaveLastFrameCollisionInfos.size()) - 1; i > index; i--) {
+        std::swap(mConcaveLastFrameCollisionInfos[i], mConcaveLastFrameCollisionInfos[i - 1]);
     }
 }
 
-
 // Delete all the obsolete last frame collision info
+/// The remaining collision infos of a concave pair are compacted in place and stay sorted.
 void OverlappingPair::clearObsoleteLastFrameCollisionInfos() {
 
-    // For each collision info
-    for (auto it = mLastFrameCollisionInfos.begin(); it != mLastFrameCollisionInfos.end(); ) {
-
-        // If the collision info is obsolete
-        if (it->second->isObsolete) {
-
-            // Delete it
-            it->second->~LastFrameCollisionInfo();
-            mPersistentAllocator.release(it->second, sizeof(LastFrameCollisionInfo));
+    if (mHasConvexLastFrameCollisionInfo && mConvexLastFrameCollisionInfo.isObsolete) {
+        mHasConvexLastFrameCollisionInfo = false;
+    }
 
-            it = mLastFrameCollisionInfos.remove(it);
-        }
-        else {
-            ++it;
+    const uint nbCollisionInfos = static_cast<uint>(mConcaveLastFrameCollisionInfos.size());
+    uint nbKeptCollisionInfos = 0;
+    for (uint i=0; i < nbCollisionInfos; i++) {
+        if (!mConcaveLastFrameCollisionInfos[i].info.isObsolete) {
+            if (i != nbKeptCollisionInfos) {
+                mConcaveLastFrameCollisionInfos[nbKeptCollisionInfos] = mConcaveLastFrameCollisionInfos[i];
+            }
+            nbKeptCollisionInfos++;
         }
     }
+
+    // Remove the obsolete collision infos that are now at the end of the list
+    for (uint i = nbCollisionInfos; i > nbKeptCollisionInfos; i--) {
+        mConcaveLastFrameCollisionInfos.removeAt(i - 1);
+    }
 }
 
 // Make all the last frame collision infos obsolete
 void OverlappingPair::makeLastFrameCollisionInfosObsolete() {
 
-    for (auto it = mLastFrameCollisionInfos.begin(); it != mLastFrameCollisionInfos.end(); ++it) {
-        it->second->isObsolete = true;
+    mConvexLastFrameCollisionInfo.isObsolete = true;
+
+    for (uint i=0; i < mConcaveLastFrameCollisionInfos.size(); i++) {
+        mConcaveLastFrameCollisionInfos[i].info.isObsolete = true;
+    }
+}
+
+// Write the persistent state of the pair (contacts and last frame collision infos)
+void OverlappingPair::saveState(WorldStateWriter& writer) const {
+
+    writer.write(mHadContacts);
+    writer.write(mLastNarrowPhaseRelativeTransform);
+    writer.write(mNbFramesContactsReused);
+
+    const uint32 nbConvexCollisionInfos = mHasConvexLastFrameCollisionInfo ? 1 : 0;
+    writer.write(static_cast<uint32>(nbConvexCollisionInfos + mConcaveLastFrameCollisionInfos.size()));
+    if (mHasConvexLastFrameCollisionInfo) {
+        writer.write(static_cast<uint32>(getShape1()->getCollisionShape()->getId()));
+        writer.write(static_cast<uint32>(getShape2()->getCollisionShape()->getId()));
+        writer.write(mConvexLastFrameCollisionInfo);
+    }
+    for (uint i=0; i < mConcaveLastFrameCollisionInfos.size(); i++) {
+        const ShapesLastFrameCollisionInfo& element = mConcaveLastFrameCollisionInfos[i];
+        writer.write(static_cast<uint32>(element.shapeIds.first));
+        writer.write(static_cast<uint32>(element.shapeIds.second));
+        writer.write(element.info);
+    }
+
+    mContactManifoldSet.saveState(writer);
+}
+
+// Restore the persistent state of a new pair written by saveState()
+void OverlappingPair::restoreState(WorldStateReader& reader) {
+
+    assert(!mHasConvexLastFrameCollisionInfo && mConcaveLastFrameCollisionInfos.size() == 0);
+
+    reader.read(mHadContacts);
+    reader.read(mLastNarrowPhaseRelativeTransform);
+    reader.read(mNbFramesContactsReused);
+
+    const uint32 nbLastFrameCollisionInfos = reader.read<uint32>();
+    for (uint32 i=0; i < nbLastFrameCollisionInfos; i++) {
+
+        const uint32 shapeId1 = reader.read<uint32>();
+        const uint32 shapeId2 = reader.read<uint32>();
+        addLastFrameInfoIfNecessary(shapeId1, shapeId2);
+        reader.read(*getLastFrameCollisionInfo(shapeId1, shapeId2));
+    }
+
+    mContactManifoldSet.restoreState(reader);
+}
+
+// Skip a state written by saveState() for a pair of two proxy shapes and return false if it cannot be read
+/// A pair without a concave shape has at most one last frame collision info.
+bool OverlappingPair::checkState(WorldStateReader& reader, const ProxyShape* shape1, const ProxyShape* shape2) {
+
+    const size_t stateSize = sizeof(mHadContacts) + sizeof(mLastNarrowPhaseRelativeTransform) +
+                             sizeof(mNbFramesContactsReused);
+    if (!reader.canRead(stateSize + sizeof(uint32))) return false;
+    reader.skip(stateSize);
+
+    const uint32 nbLastFrameCollisionInfos = reader.read<uint32>();
+    const bool hasConcaveShape = !shape1->getCollisionShape()->isConvex() || !shape2->getCollisionShape()->isConvex();
+    if (!hasConcaveShape && nbLastFrameCollisionInfos > 1) return false;
+
+    const size_t infoSize = 2 * sizeof(uint32) + sizeof(LastFrameCollisionInfo);
+    for (uint32 i=0; i < nbLastFrameCollisionInfos; i++) {
+        if (!reader.canRead(infoSize)) return false;
+        reader.skip(infoSize);
     }
+
+    return ContactManifoldSet::checkState(reader);
 }
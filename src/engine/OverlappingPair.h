@@ -29,7 +29,7 @@
 // Libraries
 #include "collision/ContactManifoldSet.h"
 #include "collision/ProxyShape.h"
-#include "containers/Map.h"
+#include "containers/List.h"
 #include "containers/Pair.h"
 #include "containers/containers_common.h"
 
@@ -39,6 +39,8 @@ namespace reactphysics3d {
 // Declarations
 struct NarrowPhaseInfo;
 class CollisionShape;
+class WorldStateWriter;
+class WorldStateReader;
 
 // Structure LastFrameCollisionInfo
 /**
@@ -67,6 +69,24 @@ struct LastFrameCollisionInfo {
     /// Previous separating axis
     Vector3 gjkSeparatingAxis;
 
+    /// Previous support vertex of the first shape (for the hill-climbing of convex meshes)
+    uint gjkSupportVertex1;
+
+    /// Previous support vertex of the second shape (for the hill-climbing of convex meshes)
+    uint gjkSupportVertex2;
+
+    /// Number of points of the final simplex of the previous GJK query (only cached when
+    /// the warm start of GJK from its previous simplex is enabled)
+    uint gjkNbSimplexPoints;
+
+    /// Points of the first shape of the final simplex of the previous GJK query (in
+    /// local-space of the first shape)
+    Vector3 gjkSimplexPointsShape1[4];
+
+    /// Points of the second shape of the final simplex of the previous GJK query (in
+    /// local-space of the second shape)
+    Vector3 gjkSimplexPointsShape2[4];
+
     // SAT Algorithm
     bool satIsAxisFacePolyhedron1;
     bool satIsAxisFacePolyhedron2;
@@ -74,6 +94,10 @@ struct LastFrameCollisionInfo {
     uint satMinEdge1Index;
     uint satMinEdge2Index;
 
+    /// True if the last SAT test has been resolved with the previous minimum separating axis
+    /// without testing all the axes
+    bool satWasPreviousAxisUsed;
+
     /// Constructor
     LastFrameCollisionInfo() {
 
@@ -84,6 +108,15 @@ struct LastFrameCollisionInfo {
         wasUsingGJK = false;
 
         gjkSeparatingAxis = Vector3(0, 1, 0);
+        gjkSupportVertex1 = 0;
+        gjkSupportVertex2 = 0;
+        gjkNbSimplexPoints = 0;
+        satIsAxisFacePolyhedron1 = false;
+        satIsAxisFacePolyhedron2 = false;
+        satMinAxisFaceIndex = 0;
+        satMinEdge1Index = 0;
+        satMinEdge2Index = 0;
+        satWasPreviousAxisUsed = false;
     }
 };
 
@@ -104,6 +137,21 @@ class OverlappingPair {
 
     private:
 
+        /// Temporal coherence collision data of two collision shapes of a concave pair
+        struct ShapesLastFrameCollisionInfo {
+
+            /// Ids of the two collision shapes
+            ShapeIdPair shapeIds;
+
+            /// Collision data of the last frame
+            LastFrameCollisionInfo info;
+
+            /// Constructor
+            ShapesLastFrameCollisionInfo(const ShapeIdPair& shapeIds) : shapeIds(shapeIds) {
+
+            }
+        };
+
         // -------------------- Attributes -------------------- //
 
         /// Set of persistent contact manifolds
@@ -118,16 +166,43 @@ class OverlappingPair {
         /// Memory allocator used to allocated memory for the ContactManifoldInfo and ContactPointInfo
         MemoryAllocator& mTempMemoryAllocator;
 
-        /// Temporal coherence collision data for each overlapping collision shapes of this pair.
-        /// Temporal coherence data store collision information about the last frame.
-        /// If two convex shapes overlap, we have a single collision data but if one shape is concave,
-        /// we might have collision data for several overlapping triangles. The key in the map is the
-        /// shape Ids of the two collision shapes.
-        Map<ShapeIdPair, LastFrameCollisionInfo*> mLastFrameCollisionInfos;
+        /// Temporal coherence collision data of the two shapes of a convex pair. A pair of two
+        /// convex shapes has a single collision data that is stored directly in the pair
+        LastFrameCollisionInfo mConvexLastFrameCollisionInfo;
+
+        /// True if the collision data of the convex pair exists (it has been added and has not
+        /// been cleared since)
+        bool mHasConvexLastFrameCollisionInfo;
+
+        /// Temporal coherence collision data of a concave pair. If one shape is concave, we might
+        /// have collision data for several overlapping triangles. The data are stored by value and
+        /// sorted by the shape Ids of the two collision shapes to be found with a binary search
+        List<ShapesLastFrameCollisionInfo> mConcaveLastFrameCollisionInfos;
 
         /// World settings
         const WorldSettings& mWorldSettings;
 
+        /// Transform of the second shape in the local-space of the first shape at the last
+        /// narrow-phase of the pair (used to reuse the contacts)
+        Transform mLastNarrowPhaseRelativeTransform;
+
+        /// Number of consecutive frames for which the contacts have been reused
+        uint mNbFramesContactsReused;
+
+        /// True if the pair had contacts at the end of the previous collision detection or,
+        /// for a trigger, if the two shapes were intersecting (used to report the contact events)
+        bool mHadContacts;
+
+        /// True if the last frame collision infos of the narrow-phase infos created for the pair
+        /// are added later by the caller (when the middle-phase of the pair runs on a worker)
+        bool mIsLastFrameInfoAdditionDeferred;
+
+        // -------------------- Methods -------------------- //
+
+        /// Return the index of the first concave collision data whose shape Ids are not smaller
+        /// than the given ones
+        uint findConcaveLastFrameCollisionInfo(uint shapeId1, uint shapeId2) const;
+
     public:
 
         // -------------------- Methods -------------------- //
@@ -175,6 +250,21 @@ class OverlappingPair {
 		/// Return true if the overlapping pair has contact manifolds with contacts
 		bool hasContacts() const;
 
+        /// Return true if one of the shapes of the pair is a trigger
+        bool isTrigger() const;
+
+        /// Return true if one of the bodies of the pair is awake and not static
+        bool isActive() const;
+
+        /// Return true if the pair had contacts at the end of the previous collision detection
+        bool hadContacts() const;
+
+        /// Set whether the pair had contacts at the end of the collision detection
+        void setHadContacts(bool hadContacts);
+
+        /// Set whether the last frame collision infos of the new narrow-phase infos are added later
+        void setIsLastFrameInfoAdditionDeferred(bool isDeferred);
+
         /// Return a pointer to the first potential contact manifold in the linked-list
         ContactManifoldInfo* getPotentialContactManifolds();
 
@@ -184,6 +274,9 @@ class OverlappingPair {
         /// Make the contact manifolds and contact points obsolete
         void makeContactsObsolete();
 
+        /// Reuse the contacts of the previous frame if the shapes have almost not moved
+        bool reuseContacts();
+
         /// Clear the obsolete contact manifold and contact points
         void clearObsoleteManifoldsAndContactPoints();
 
@@ -202,11 +295,20 @@ class OverlappingPair {
         /// Make all the last frame collision infos obsolete
         void makeLastFrameCollisionInfosObsolete();
 
+        /// Write the persistent state of the pair (contacts and last frame collision infos)
+        void saveState(WorldStateWriter& writer) const;
+
+        /// Restore the persistent state of a new pair written by saveState()
+        void restoreState(WorldStateReader& reader);
+
+        /// Skip a state written by saveState() for a pair of two proxy shapes and return false if it cannot be read
+        static bool checkState(WorldStateReader& reader, const ProxyShape* shape1, const ProxyShape* shape2);
+
         /// Return the pair of bodies index
         static OverlappingPairId computeID(ProxyShape* shape1, ProxyShape* shape2);
 
         /// Return the pair of bodies index of the pair
-        static bodyindexpair computeBodiesIndexPair(CollisionBody* body1, CollisionBody* body2);
+        static bodyindexpair computeBodiesIndexPair(const CollisionBody* body1, const CollisionBody* body2);
 
         // -------------------- Friendship -------------------- //
 
@@ -230,12 +332,7 @@ inline void OverlappingPair::addContactManifold(const ContactManifoldInfo* conta
 
 // Return the last frame collision info for a given shape id or nullptr if none is found
 inline LastFrameCollisionInfo* OverlappingPair::getLastFrameCollisionInfo(ShapeIdPair& shapeIds) {
-    Map<ShapeIdPair, LastFrameCollisionInfo*>::Iterator it = mLastFrameCollisionInfos.find(shapeIds);
-    if (it != mLastFrameCollisionInfos.end()) {
-        return it->second;
-    }
-
-    return nullptr;
+    return getLastFrameCollisionInfo(shapeIds.first, shapeIds.second);
 }
 
 // Return the contact manifold
@@ -262,8 +359,8 @@ inline OverlappingPair::OverlappingPairId OverlappingPair::computeID(ProxyShape*
 }
 
 // Return the pair of bodies index
-inline bodyindexpair OverlappingPair::computeBodiesIndexPair(CollisionBody* body1,
-                                                             CollisionBody* body2) {
+inline bodyindexpair OverlappingPair::computeBodiesIndexPair(const CollisionBody* body1,
+                                                             const CollisionBody* body2) {
 
     // Construct the pair of body index
     bodyindexpair indexPair = body1->getId() < body2->getId() ?
@@ -289,6 +386,42 @@ inline bool OverlappingPair::hasContacts() const {
 	return mContactManifoldSet.getContactManifolds() != nullptr;
 }
 
+// Return true if one of the shapes of the pair is a trigger
+inline bool OverlappingPair::isTrigger() const {
+    return getShape1()->isTrigger() || getShape2()->isTrigger();
+}
+
+// Return true if one of the bodies of the pair is awake and not static
+/// The pairs that are not active are not tested by the collision detection.
+inline bool OverlappingPair::isActive() const {
+    const CollisionBody* body1 = getShape1()->getBody();
+    const CollisionBody* body2 = getShape2()->getBody();
+    return (!body1->isSleeping() && body1->getType() != BodyType::STATIC) ||
+           (!body2->isSleeping() && body2->getType() != BodyType::STATIC);
+}
+
+// Return true if the pair had contacts at the end of the previous collision detection
+inline bool OverlappingPair::hadContacts() const {
+    return mHadContacts;
+}
+
+// Set whether the pair had contacts at the end of the collision detection
+inline void OverlappingPair::setHadContacts(bool hadContacts) {
+    mHadContacts = hadContacts;
+}
+
+// Set whether the last frame collision infos of the new narrow-phase infos are added later
+/// The last frame collision infos are allocated with the persistent allocator of the pair that
+/// is shared with the other pairs. When the narrow-phase infos of the pair are created by a
+/// worker, the infos must be added afterwards with addLastFrameInfoIfNecessary() by the thread
+/// that owns the allocator.
+/**
+ * @param isDeferred True if the last frame collision infos are added later by the caller
+ */
+inline void OverlappingPair::setIsLastFrameInfoAdditionDeferred(bool isDeferred) {
+    mIsLastFrameInfoAdditionDeferred = isDeferred;
+}
+
 // Return a pointer to the first potential contact manifold in the linked-list
 inline ContactManifoldInfo* OverlappingPair::getPotentialContactManifolds() {
     return mPotentialContactManifolds;
@@ -304,9 +437,43 @@ inline void OverlappingPair::reduceContactManifolds() {
    mContactManifoldSet.reduce();
 }
 
-// Return the last frame collision info for a given pair of shape ids
+// Return the index of the first concave collision data whose shape Ids are not smaller than the given ones
+inline uint OverlappingPair::findConcaveLastFrameCollisionInfo(uint shapeId1, uint shapeId2) const {
+
+    uint min = 0;
+    uint max = static_cast<uint>(mConcaveLastFrameCollisionInfos.size());
+    while (min < max) {
+        const uint middle = (min + max) / 2;
+        const ShapeIdPair& shapeIds = mConcaveLastFrameCollisionInfos[middle].shapeIds;
+        if (shapeIds.first < shapeId1 || (shapeIds.first == shapeId1 && shapeIds.second < shapeId2)) {
+            min = middle + 1;
+        }
+        else {
+            max = middle;
+        }
+    }
+
+    return min;
+}
+
+// Return the last frame collision info for a given pair of shape ids or nullptr if none is found
+/// The returned pointer stays valid until a collision info is added to or removed from the pair.
 inline LastFrameCollisionInfo* OverlappingPair::getLastFrameCollisionInfo(uint shapeId1, uint shapeId2) const {
-    return mLastFrameCollisionInfos[ShapeIdPair(shapeId1, shapeId2)];
+
+    if (!hasConcaveShape()) {
+        return mHasConvexLastFrameCollisionInfo ?
+                   const_cast<LastFrameCollisionInfo*>(&mConvexLastFrameCollisionInfo) : nullptr;
+    }
+
+    const uint index = findConcaveLastFrameCollisionInfo(shapeId1, shapeId2);
+    if (index < mConcaveLastFrameCollisionInfos.size()) {
+        const ShapesLastFrameCollisionInfo& element = mConcaveLastFrameCollisionInfos[index];
+        if (element.shapeIds.first == shapeId1 && element.shapeIds.second == shapeId2) {
+            return const_cast<LastFrameCollisionInfo*>(&element.info);
+        }
+    }
+
+    return nullptr;
 }
 
 }
@@ -0,0 +1,273 @@
+/********************************************************************************
+* ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
+* Copyright (c) 2010-2018 Daniel Chappuis                                       *
+*********************************************************************************
+*                                                                               *
+* This software is provided 'as-is', without any express or implied warranty.   *
+* In no event will the authors be held liable for any damages arising from the  *
+* use of this software.                                                         *
+*                                                                               *
+* Permission is granted to anyone to use this software for any purpose,         *
+* including commercial applications, and to alter it and redistribute it        *
+* freely, subject to the following restrictions:                                *
+*                                                                               *
+* 1. The origin of this software must not be misrepresented; you must not claim *
+*    that you wrote the original software. If you use this software in a        *
+*    product, an acknowledgment in the product documentation would be           *
+*    appreciated but is not required.                                           *
+*                                                                               *
+* 2. Altered source versions must be plainly marked as such, and must not be    *
+*    misrepresented as being the original software.                             *
+*                                                                               *
+* 3. This notice may not be removed or altered from any source distribution.    *
+*                                                                               *
+********************************************************************************/
+
+// Libraries
+#include "OverlappingPairCache.h"
+#include "collision/ProxyShape.h"
+#include "collision/broadphase/BroadPhaseAlgorithm.h"
+#include "memory/MemoryAllocator.h"
+#include <algorithm>
+#include <cstring>
+
+using namespace reactphysics3d;
+
+// Initialization of static variables
+const int OverlappingPairCache::EMPTY_SLOT = -1;
+const uint OverlappingPairCache::INIT_NB_SLOTS = 64;
+
+// Constructor
+OverlappingPairCache::OverlappingPairCache(MemoryAllocator& allocator)
+                     : mAllocator(allocator), mNbPairs(0), mNbActivePairs(0), mNbAllocatedPairs(INIT_NB_SLOTS / 2),
+                       mNbSlots(INIT_NB_SLOTS) {
+
+    mPairs = static_cast<OverlappingPair**>(mAllocator.allocate(mNbAllocatedPairs * sizeof(OverlappingPair*)));
+    mPairKeys = static_cast<uint64*>(mAllocator.allocate(mNbAllocatedPairs * sizeof(uint64)));
+    mPairStamps = static_cast<uint64*>(mAllocator.allocate(mNbAllocatedPairs * sizeof(uint64)));
+
+    mSlotKeys = static_cast<uint64*>(mAllocator.allocate(mNbSlots * sizeof(uint64)));
+    mSlotPairIndices = static_cast<int*>(mAllocator.allocate(mNbSlots * sizeof(int)));
+    std::fill(mSlotPairIndices, mSlotPairIndices + mNbSlots, EMPTY_SLOT);
+}
+
+// Destructor
+OverlappingPairCache::~OverlappingPairCache() {
+
+    mAllocator.release(mPairs, mNbAllocatedPairs * sizeof(OverlappingPair*));
+    mAllocator.release(mPairKeys, mNbAllocatedPairs * sizeof(uint64));
+    mAllocator.release(mPairStamps, mNbAllocatedPairs * sizeof(uint64));
+    mAllocator.release(mSlotKeys, mNbSlots * sizeof(uint64));
+    mAllocator.release(mSlotPairIndices, mNbSlots * sizeof(int));
+}
+
+// Return the key of the pair of two proxy shapes
+/// The key is the same as the key of the pairs of the broad-phase.
+uint64 OverlappingPairCache::computeKey(const ProxyShape* shape1, const ProxyShape* shape2) {
+
+    assert(shape1->getBroadPhaseId() >= 0 && shape2->getBroadPhaseId() >= 0);
+    assert(shape1->getBroadPhaseId() != shape2->getBroadPhaseId());
+
+    return BroadPhasePair::computeKey(shape1->getBroadPhaseId(), shape2->getBroadPhaseId());
+}
+
+// Return the slot of a key or the empty slot where it would be inserted
+uint OverlappingPairCache::findSlot(uint64 key) const {
+
+    uint slot = computeHomeSlot(key);
+    while (mSlotPairIndices[slot] != EMPTY_SLOT && mSlotKeys[slot] != key) {
+        slot = (slot + 1) & (mNbSlots - 1);
+    }
+
+    return slot;
+}
+
+// Return the pair with a given key (null if there is no such pair)
+OverlappingPair* OverlappingPairCache::find(uint64 key) const {
+
+    const uint slot = findSlot(key);
+    return mSlotPairIndices[slot] == EMPTY_SLOT ? nullptr : mPairs[mSlotPairIndices[slot]];
+}
+
+// Set the stamp of the pair with a given key and return false if there is no such pair
+bool OverlappingPairCache::updateStamp(uint64 key, uint64 stamp) {
+
+    const uint slot = findSlot(key);
+    if (mSlotPairIndices[slot] == EMPTY_SLOT) return false;
+
+    mPairStamps[mSlotPairIndices[slot]] = stamp;
+
+    return true;
+}
+
+// Add a pair whose key is not in the cache
+void OverlappingPairCache::add(uint64 key, OverlappingPair* pair, uint64 stamp) {
+
+    assert(find(key) == nullptr);
+
+    if (mNbPairs == mNbAllocatedPairs) {
+        growPairs(mNbAllocatedPairs * 2);
+    }
+
+    // Keep the load factor of the hash table below one half
+    if (2 * (mNbPairs + 1) > mNbSlots) {
+        growSlots(mNbSlots * 2);
+    }
+
+    const uint slot = findSlot(key);
+    mSlotKeys[slot] = key;
+    mSlotPairIndices[slot] = static_cast<int>(mNbPairs);
+
+    mPairs[mNbPairs] = pair;
+    mPairKeys[mNbPairs] = key;
+    mPairStamps[mNbPairs] = stamp;
+    mNbPairs++;
+
+    // A new pair is active
+    unpark(mNbPairs - 1);
+}
+
+// Remove a pair (the last pair is moved at its index)
+/// If the pair is active, the last active pair is moved at its index and the
+/// last pair is moved at the index of the last active pair.
+void OverlappingPairCache::removeAt(uint index) {
+
+    assert(index < mNbPairs);
+
+    if (index < mNbActivePairs) {
+        park(index);
+        index = mNbActivePairs;
+    }
+
+    removeSlot(findSlot(mPairKeys[index]));
+
+    // Move the last pair at the index of the removed one
+    const uint lastIndex = mNbPairs - 1;
+    if (index != lastIndex) {
+        mPairs[index] = mPairs[lastIndex];
+        mPairKeys[index] = mPairKeys[lastIndex];
+        mPairStamps[index] = mPairStamps[lastIndex];
+        mSlotPairIndices[findSlot(mPairKeys[index])] = static_cast<int>(index);
+    }
+    mNbPairs--;
+}
+
+// Park an active pair (the last active pair is moved at its index)
+void OverlappingPairCache::park(uint index) {
+
+    assert(index < mNbActivePairs);
+
+    mNbActivePairs--;
+    swapPairs(index, mNbActivePairs);
+}
+
+// Make a parked pair active again (the first parked pair is moved at its index)
+void OverlappingPairCache::unpark(uint index) {
+
+    assert(index >= mNbActivePairs && index < mNbPairs);
+
+    swapPairs(index, mNbActivePairs);
+    mNbActivePairs++;
+}
+
+// Swap two pairs of the dense arrays
+void OverlappingPairCache::swapPairs(uint index1, uint index2) {
+
+    if (index1 == index2) return;
+
+    std::swap(mPairs[index1], mPairs[index2]);
+    std::swap(mPairKeys[index1], mPairKeys[index2]);
+    std::swap(mPairStamps[index1], mPairStamps[index2]);
+    mSlotPairIndices[findSlot(mPairKeys[index1])] = static_cast<int>(index1);
+    mSlotPairIndices[findSlot(mPairKeys[index2])] = static_cast<int>(index2);
+}
+
+// Allocate the memory needed to store a given number of pairs
+/// The pairs can then be added without any allocation until their number exceeds it
+void OverlappingPairCache::reserve(uint nbPairs) {
+
+    if (nbPairs > mNbAllocatedPairs) {
+        growPairs(nbPairs);
+    }
+
+    // Keep the load factor of the hash table below one half
+    uint nbSlots = mNbSlots;
+    while (2 * nbPairs > nbSlots) {
+        nbSlots *= 2;
+    }
+    if (nbSlots > mNbSlots) {
+        growSlots(nbSlots);
+    }
+}
+
+// Make a slot empty and move the following keys of its cluster back
+/// With linear probing, a key can be moved into the empty slot if its home
+/// slot is not between the empty slot and its current slot.
+void OverlappingPairCache::removeSlot(uint slot) {
+
+    assert(mSlotPairIndices[slot] != EMPTY_SLOT);
+
+    const uint mask = mNbSlots - 1;
+    uint emptySlot = slot;
+    uint nextSlot = slot;
+    while (true) {
+
+        nextSlot = (nextSlot + 1) & mask;
+        if (mSlotPairIndices[nextSlot] == EMPTY_SLOT) break;
+
+        // Distances from the home slot of the key to the empty slot and to its current slot
+        const uint homeSlot = computeHomeSlot(mSlotKeys[nextSlot]);
+        const uint distanceToEmpty = (emptySlot - homeSlot) & mask;
+        const uint distanceToCurrent = (nextSlot - homeSlot) & mask;
+
+        if (distanceToEmpty < distanceToCurrent) {
+            mSlotKeys[emptySlot] = mSlotKeys[nextSlot];
+            mSlotPairIndices[emptySlot] = mSlotPairIndices[nextSlot];
+            emptySlot = nextSlot;
+        }
+    }
+
+    mSlotPairIndices[emptySlot] = EMPTY_SLOT;
+}
+
+// Allocate larger arrays for the pairs
+void OverlappingPairCache::growPairs(uint newNbAllocatedPairs) {
+
+    assert(newNbAllocatedPairs > mNbAllocatedPairs);
+
+    OverlappingPair** newPairs = static_cast<OverlappingPair**>(mAllocator.allocate(newNbAllocatedPairs * sizeof(OverlappingPair*)));
+    uint64* newPairKeys = static_cast<uint64*>(mAllocator.allocate(newNbAllocatedPairs * sizeof(uint64)));
+    uint64* newPairStamps = static_cast<uint64*>(mAllocator.allocate(newNbAllocatedPairs * sizeof(uint64)));
+    std::memcpy(newPairs, mPairs, mNbPairs * sizeof(OverlappingPair*));
+    std::memcpy(newPairKeys, mPairKeys, mNbPairs * sizeof(uint64));
+    std::memcpy(newPairStamps, mPairStamps, mNbPairs * sizeof(uint64));
+
+    mAllocator.release(mPairs, mNbAllocatedPairs * sizeof(OverlappingPair*));
+    mAllocator.release(mPairKeys, mNbAllocatedPairs * sizeof(uint64));
+    mAllocator.release(mPairStamps, mNbAllocatedPairs * sizeof(uint64));
+
+    mPairs = newPairs;
+    mPairKeys = newPairKeys;
+    mPairStamps = newPairStamps;
+    mNbAllocatedPairs = newNbAllocatedPairs;
+}
+
+// Allocate a larger hash table and insert the pairs into it again
+void OverlappingPairCache::growSlots(uint nbSlots) {
+
+    assert(nbSlots > mNbSlots);
+
+    mAllocator.release(mSlotKeys, mNbSlots * sizeof(uint64));
+    mAllocator.release(mSlotPairIndices, mNbSlots * sizeof(int));
+
+    mNbSlots = nbSlots;
+    mSlotKeys = static_cast<uint64*>(mAllocator.allocate(mNbSlots * sizeof(uint64)));
+    mSlotPairIndices = static_cast<int*>(mAllocator.allocate(mNbSlots * sizeof(int)));
+    std::fill(mSlotPairIndices, mSlotPairIndices + mNbSlots, EMPTY_SLOT);
+
+    for (uint i=0; i < mNbPairs; i++) {
+        const uint slot = findSlot(mPairKeys[i]);
+        mSlotKeys[slot] = mPairKeys[i];
+        mSlotPairIndices[slot] = static_cast<int>(i);
+    }
+}
@@ -0,0 +1,209 @@
+/********************************************************************************
+* ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
+* Copyright (c) 2010-2018 Daniel Chappuis                                       *
+*********************************************************************************
+*                                                                               *
+* This software is provided 'as-is', without any express or implied warranty.   *
+* In no event will the authors be held liable for any damages arising from the  *
+* use of this software.                                                         *
+*                                                                               *
+* Permission is granted to anyone to use this software for any purpose,         *
+* including commercial applications, and to alter it and redistribute it        *
+* freely, subject to the following restrictions:                                *
+*                                                                               *
+* 1. The origin of this software must not be misrepresented; you must not claim *
+*    that you wrote the original software. If you use this software in a        *
+*    product, an acknowledgment in the product documentation would be           *
+*    appreciated but is not required.                                           *
+*                                                                               *
+* 2. Altered source versions must be plainly marked as such, and must not be    *
+*    misrepresented as being the original software.                             *
+*                                                                               *
+* 3. This notice may not be removed or altered from any source distribution.    *
+*                                                                               *
+********************************************************************************/
+
+#ifndef REACTPHYSICS3D_OVERLAPPING_PAIR_CACHE_H
+#define REACTPHYSICS3D_OVERLAPPING_PAIR_CACHE_H
+
+// Libraries
+#include "configuration.h"
+#include <cassert>
+
+/// ReactPhysics3D namespace
+namespace reactphysics3d {
+
+// Declarations
+class OverlappingPair;
+class ProxyShape;
+class MemoryAllocator;
+
+// Class OverlappingPairCache
+/**
+ * This class stores the overlapping pairs of the collision detection. The pairs are stored
+ * in dense arrays (that are iterated by the collision detection) and a hash table with open
+ * addressing and linear probing maps the 64-bit key of a pair (the two broad-phase IDs of its
+ * shapes) to its index in the dense arrays. The keys of the table are stored in their own
+ * contiguous array so that a lookup only compares consecutive keys. A pair is removed by
+ * moving the last pair at its index and the table is kept without tombstones with a backward
+ * shift deletion.
+ *
+ * Each pair also has the stamp of the last broad-phase that has reported it. When a shape
+ * moves, the broad-phase reports again all its overlapping shapes. Therefore, a pair whose
+ * stamp is older than the last broad-phase where one of its shapes has moved is not
+ * overlapping anymore and the pairs of the shapes that have not moved are never tested.
+ *
+ * The pairs of two sleeping or static bodies are parked at the end of the dense arrays. The
+ * collision detection only iterates over the active pairs at the beginning of the arrays and
+ * the parked pairs keep their contacts until one of their bodies is woken up.
+ */
+class OverlappingPairCache {
+
+    private:
+
+        // -------------------- Constants -------------------- //
+
+        /// Index of an empty slot of the hash table
+        static const int EMPTY_SLOT;
+
+        /// Initial number of slots of the hash table (a power of two)
+        static const uint INIT_NB_SLOTS;
+
+        // -------------------- Attributes -------------------- //
+
+        /// Memory allocator
+        MemoryAllocator& mAllocator;
+
+        /// Overlapping pairs
+        OverlappingPair** mPairs;
+
+        /// Keys of the overlapping pairs
+        uint64* mPairKeys;
+
+        /// Stamp of the last broad-phase that has reported each pair
+        uint64* mPairStamps;
+
+        /// Number of pairs
+        uint mNbPairs;
+
+        /// Number of active pairs (the pairs after them are parked)
+        uint mNbActivePairs;
+
+        /// Number of allocated elements of the arrays of the pairs
+        uint mNbAllocatedPairs;
+
+        /// Keys of the slots of the hash table
+        uint64* mSlotKeys;
+
+        /// Index of the pair of each slot of the hash table (EMPTY_SLOT if the slot is empty)
+        int* mSlotPairIndices;
+
+        /// Number of slots of the hash table (a power of two)
+        uint mNbSlots;
+
+        // -------------------- Methods -------------------- //
+
+        /// Return the slot where the search of a key starts
+        uint computeHomeSlot(uint64 key) const;
+
+        /// Return the slot of a key or the empty slot where it would be inserted
+        uint findSlot(uint64 key) const;
+
+        /// Allocate larger arrays for the pairs
+        void growPairs(uint nbAllocatedPairs);
+
+        /// Allocate a larger hash table and insert the pairs into it again
+        void growSlots(uint nbSlots);
+
+        /// Make a slot empty and move the following keys of its cluster back
+        void removeSlot(uint slot);
+
+        /// Swap two pairs of the dense arrays
+        void swapPairs(uint index1, uint index2);
+
+    public:
+
+        // -------------------- Methods -------------------- //
+
+        /// Constructor
+        OverlappingPairCache(MemoryAllocator& allocator);
+
+        /// Destructor
+        ~OverlappingPairCache();
+
+        /// Deleted copy-constructor
+        OverlappingPairCache(const OverlappingPairCache& cache) = delete;
+
+        /// Deleted assignment operator
+        OverlappingPairCache& operator=(const OverlappingPairCache& cache) = delete;
+
+        /// Return the key of the pair of two proxy shapes
+        static uint64 computeKey(const ProxyShape* shape1, const ProxyShape* shape2);
+
+        /// Return the number of pairs
+        uint size() const;
+
+        /// Return the number of active pairs
+        uint getNbActivePairs() const;
+
+        /// Return a pair
+        OverlappingPair* getPair(uint index) const;
+
+        /// Return the stamp of the last broad-phase that has reported a pair
+        uint64 getStamp(uint index) const;
+
+        /// Return the pair with a given key (null if there is no such pair)
+        OverlappingPair* find(uint64 key) const;
+
+        /// Set the stamp of the pair with a given key and return false if there is no such pair
+        bool updateStamp(uint64 key, uint64 stamp);
+
+        /// Add a pair whose key is not in the cache
+        void add(uint64 key, OverlappingPair* pair, uint64 stamp);
+
+        /// Remove a pair (the last pair is moved at its index)
+        void removeAt(uint index);
+
+        /// Park an active pair (the last active pair is moved at its index)
+        void park(uint index);
+
+        /// Make a parked pair active again (the first parked pair is moved at its index)
+        void unpark(uint index);
+
+        /// Allocate the memory needed to store a given number of pairs
+        void reserve(uint nbPairs);
+};
+
+// Return the number of pairs
+inline uint OverlappingPairCache::size() const {
+    return mNbPairs;
+}
+
+// Return the number of active pairs
+inline uint OverlappingPairCache::getNbActivePairs() const {
+    return mNbActivePairs;
+}
+
+// Return a pair
+inline OverlappingPair* OverlappingPairCache::getPair(uint index) const {
+    assert(index < mNbPairs);
+    return mPairs[index];
+}
+
+// Return the stamp of the last broad-phase that has reported a pair
+inline uint64 OverlappingPairCache::getStamp(uint index) const {
+    assert(index < mNbPairs);
+    return mPairStamps[index];
+}
+
+// Return the slot where the search of a key starts
+inline uint OverlappingPairCache::computeHomeSlot(uint64 key) const {
+
+    // Fibonacci hashing of the key (the high bits of the product are the most mixed)
+    const uint64 hash = key * uint64(0x9E3779B97F4A7C15);
+    return static_cast<uint>(hash >> 32) & (mNbSlots - 1);
+}
+
+}
+
+#endif
@@ -0,0 +1,395 @@
+/********************************************************************************
+* ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
+* Copyright (c) 2010-2018 Daniel Chappuis                                       *
+*********************************************************************************
+*                                                                               *
+* This software is provided 'as-is', without any express or implied warranty.   *
+* In no event will the authors be held liable for any damages arising from the  *
+* use of this software.                                                         *
+*                                                                               *
+* Permission is granted to anyone to use this software for any purpose,         *
+* including commercial applications, and to alter it and redistribute it        *
+* freely, subject to the following restrictions:                                *
+*                                                                               *
+* 1. The origin of this software must not be misrepresented; you must not claim *
+*    that you wrote the original software. If you use this software in a        *
+*    product, an acknowledgment in the product documentation would be           *
+*    appreciated but is not required.                                           *
+*                                                                               *
+* 2. Altered source versions must be plainly marked as such, and must not be    *
+*    misrepresented as being the original software.                             *
+*                                                                               *
+* 3. This notice may not be removed or altered from any source distribution.    *
+*                                                                               *
+********************************************************************************/
+
+// Libraries
+#include "ParticleSystem.h"
+#include "TaskScheduler.h"
+#include "collision/CollisionDetection.h"
+#include "collision/RaycastInfo.h"
+#include "memory/MemoryManager.h"
+#include "utils/Profiler.h"
+#include <cmath>
+
+using namespace reactphysics3d;
+
+// Return the cell coordinates of a position in a grid with a given inverse cell size
+static void computeParticleCell(const Vector3& position, decimal inverseCellSize, int32 cell[3]) {
+    cell[0] = static_cast<int32>(std::floor(position.x * inverseCellSize));
+    cell[1] = static_cast<int32>(std::floor(position.y * inverseCellSize));
+    cell[2] = static_cast<int32>(std::floor(position.z * inverseCellSize));
+}
+
+// Return the index in a table (whose size is a power of two) of the cell with given coordinates
+static uint32 hashParticleCell(int32 x, int32 y, int32 z, uint32 tableMask) {
+    const uint32 hash = (static_cast<uint32>(x) * 73856093u) ^ (static_cast<uint32>(y) * 19349663u) ^
+                        (static_cast<uint32>(z) * 83492791u);
+    return hash & tableMask;
+}
+
+// Constructor
+/**
+ * @param settings The settings of the particle system
+ * @param collisionDetection The collision detection of the world of the particles
+ * @param memoryManager The memory manager of the world of the particles
+ */
+ParticleSystem::ParticleSystem(const ParticleSystemSettings& settings, CollisionDetection& collisionDetection,
+                               MemoryManager& memoryManager)
+               : mSettings(settings), mCollisionDetection(collisionDetection), mMemoryManager(memoryManager),
+                 mNbParticles(0), mCapacity(0), mPositions(nullptr), mVelocities(nullptr),
+                 mContactNormals(nullptr) {
+
+    assert(settings.radius > decimal(0.0));
+
+#ifdef IS_PROFILING_ACTIVE
+    mProfiler = nullptr;
+#endif
+
+}
+
+// Destructor
+ParticleSystem::~ParticleSystem() {
+
+    if (mCapacity > 0) {
+        mMemoryManager.release(MemoryManager::AllocationType::Base, mPositions,
+                               mCapacity * 3 * sizeof(Vector3), MemoryTag::Bodies);
+    }
+}
+
+// Reallocate the arrays with a larger capacity
+void ParticleSystem::allocate(uint capacity) {
+
+    assert(capacity > mCapacity);
+
+    void* buffer = mMemoryManager.allocate(MemoryManager::AllocationType::Base, capacity * 3 * sizeof(Vector3),
+                                           MemoryTag::Bodies);
+
+    Vector3* newPositions = static_cast<Vector3*>(buffer);
+    Vector3* newVelocities = newPositions + capacity;
+    Vector3* newContactNormals = newVelocities + capacity;
+
+    // Move the current particles into the new arrays
+    for (uint i=0; i < mNbParticles; i++) {
+        new (newPositions + i) Vector3(mPositions[i]);
+        new (newVelocities + i) Vector3(mVelocities[i]);
+        new (newContactNormals + i) Vector3(mContactNormals[i]);
+    }
+
+    // Release the previous arrays
+    if (mCapacity > 0) {
+        mMemoryManager.release(MemoryManager::AllocationType::Base, mPositions,
+                               mCapacity * 3 * sizeof(Vector3), MemoryTag::Bodies);
+    }
+
+    mPositions = newPositions;
+    mVelocities = newVelocities;
+    mContactNormals = newContactNormals;
+    mCapacity = capacity;
+}
+
+// Allocate the memory needed to store a given number of particles
+/**
+ * @param capacity Number of particles that can be added without allocating memory
+ */
+void ParticleSystem::reserve(uint capacity) {
+    if (capacity > mCapacity) allocate(capacity);
+}
+
+// Add a particle and return its index
+/**
+ * @param position The position of the particle in world-space
+ * @param velocity The linear velocity of the particle (in meters per second)
+ * @return The index of the particle
+ */
+uint ParticleSystem::addParticle(const Vector3& position, const Vector3& velocity) {
+
+    if (mNbParticles == mCapacity) {
+        allocate(mCapacity == 0 ? INITIAL_CAPACITY : 2 * mCapacity);
+    }
+
+    const uint index = mNbParticles;
+    new (mPositions + index) Vector3(position);
+    new (mVelocities + index) Vector3(velocity);
+    new (mContactNormals + index) Vector3(0, 0, 0);
+    mNbParticles++;
+
+    return index;
+}
+
+// Remove a particle (the last particle is moved at its index)
+/**
+ * @param index Index of the particle to remove
+ */
+void ParticleSystem::removeParticle(uint index) {
+
+    assert(index < mNbParticles);
+
+    const uint lastIndex = mNbParticles - 1;
+    if (index != lastIndex) {
+        mPositions[index] = mPositions[lastIndex];
+        mVelocities[index] = mVelocities[lastIndex];
+        mContactNormals[index] = mContactNormals[lastIndex];
+    }
+    mNbParticles--;
+}
+
+// Remove all the particles
+/// The memory of the particles is kept to add new particles.
+void ParticleSystem::clear() {
+    mNbParticles = 0;
+}
+
+// Step the particles
+/// The velocities are integrated with the gravity and the damping, the overlapping particles
+/// are pushed apart and their velocities are computed from their displacements. The particles
+/// are then moved out of the proxy shapes they have hit during their motion.
+/**
+ * @param timeStep The time step (in seconds)
+ * @param gravity The gravity applied to the particles
+ * @param taskScheduler Task scheduler used to collide the particles in parallel (sequential if null)
+ */
+void ParticleSystem::update(decimal timeStep, const Vector3& gravity, TaskScheduler* taskScheduler) {
+
+    RP3D_PROFILE("ParticleSystem::update()", mProfiler);
+
+    if (mNbParticles == 0 || timeStep <= decimal(0.0)) return;
+
+    Vector3* previousPositions = static_cast<Vector3*>(mMemoryManager.allocate(MemoryManager::AllocationType::Frame,
+                                                        mNbParticles * sizeof(Vector3), MemoryTag::Bodies));
+
+    // Integrate the velocities and the positions
+    const decimal dampingFactor = decimal(1.0) / (decimal(1.0) + timeStep * mSettings.linearDamping);
+    for (uint i=0; i < mNbParticles; i++) {
+        new (previousPositions + i) Vector3(mPositions[i]);
+        mVelocities[i] = (mVelocities[i] + timeStep * gravity) * dampingFactor;
+        mPositions[i] += timeStep * mVelocities[i];
+    }
+
+    // Push apart the overlapping particles and compute the velocities from the displacements
+    if (mSettings.isParticleCollisionEnabled && mNbParticles > 1) {
+
+        for (uint i=0; i < mSettings.nbParticleCollisionIterations; i++) {
+            solveParticleCollisions(taskScheduler);
+        }
+
+        const decimal inverseTimeStep = decimal(1.0) / timeStep;
+        for (uint i=0; i < mNbParticles; i++) {
+            mVelocities[i] = (mPositions[i] - previousPositions[i]) * inverseTimeStep;
+        }
+    }
+
+    solveShapeCollisions(previousPositions);
+}
+
+// Push apart the overlapping particles
+/// The particles are sorted into the cells of a uniform grid whose cells have the size of
+/// the diameter of the particles so that the particles overlapping a particle are in the
+/// 27 cells around its cell. Each particle computes its own correction (half the overlap
+/// with each of its neighbors) from the current positions and the corrections are applied
+/// at the end.
+/**
+ * @param taskScheduler Task scheduler used to compute the corrections in parallel (sequential if null)
+ */
+void ParticleSystem::solveParticleCollisions(TaskScheduler* taskScheduler) {
+
+    RP3D_PROFILE("ParticleSystem::solveParticleCollisions()", mProfiler);
+
+    const uint nbParticles = mNbParticles;
+    const decimal diameter = decimal(2.0) * mSettings.radius;
+    const decimal inverseCellSize = decimal(1.0) / diameter;
+
+    // The size of the table is the smallest power of two that is at least twice the number of particles
+    uint32 tableSize = 1;
+    while (tableSize < 2 * nbParticles) tableSize <<= 1;
+    const uint32 tableMask = tableSize - 1;
+
+    uint32* particlesCells = static_cast<uint32*>(mMemoryManager.allocate(MemoryManager::AllocationType::Frame,
+                                                   nbParticles * sizeof(uint32), MemoryTag::Bodies));
+    uint32* sortedParticles = static_cast<uint32*>(mMemoryManager.allocate(MemoryManager::AllocationType::Frame,
+                                                   nbParticles * sizeof(uint32), MemoryTag::Bodies));
+    uint32* cellsStarts = static_cast<uint32*>(mMemoryManager.allocate(MemoryManager::AllocationType::Frame,
+                                               (tableSize + 1) * sizeof(uint32), MemoryTag::Bodies));
+    Vector3* corrections = static_cast<Vector3*>(mMemoryManager.allocate(MemoryManager::AllocationType::Frame,
+                                                 nbParticles * sizeof(Vector3), MemoryTag::Bodies));
+
+    // Sort the particles by cell with a counting sort
+    for (uint32 c=0; c <= tableSize; c++) cellsStarts[c] = 0;
+    for (uint i=0; i < nbParticles; i++) {
+        int32 cell[3];
+        computeParticleCell(mPositions[i], inverseCellSize, cell);
+        particlesCells[i] = hashParticleCell(cell[0], cell[1], cell[2], tableMask);
+        cellsStarts[particlesCells[i]]++;
+    }
+    for (uint32 c=1; c <= tableSize; c++) cellsStarts[c] += cellsStarts[c - 1];
+    for (uint i=nbParticles; i > 0; i--) {
+        sortedParticles[--cellsStarts[particlesCells[i - 1]]] = i - 1;
+    }
+
+    // Compute the correction of each particle from the particles of the cells around it
+    const Vector3* positions = mPositions;
+    auto computeCorrections = [=](uint begin, uint end) {
+
+        const decimal diameterSquare = diameter * diameter;
+
+        for (uint i=begin; i < end; i++) {
+
+            Vector3 correction(0, 0, 0);
+            int32 cell[3];
+            computeParticleCell(positions[i], inverseCellSize, cell);
+
+            // Table indices of the visited cells (different cells can share an index)
+            uint32 visitedCells[27];
+            uint nbVisitedCells = 0;
+
+            for (int32 x=cell[0] - 1; x <= cell[0] + 1; x++) {
+                for (int32 y=cell[1] - 1; y <= cell[1] + 1; y++) {
+                    for (int32 z=cell[2] - 1; z <= cell[2] + 1; z++) {
+
+                        const uint32 tableIndex = hashParticleCell(x, y, z, tableMask);
+
+                        bool isVisited = false;
+                        for (uint v=0; v < nbVisitedCells; v++) {
+                            isVisited |= visitedCells[v] == tableIndex;
+                        }
+                        if (isVisited) continue;
+                        visitedCells[nbVisitedCells++] = tableIndex;
+
+                        for (uint32 k=cellsStarts[tableIndex]; k < cellsStarts[tableIndex + 1]; k++) {
+
+                            const uint32 j = sortedParticles[k];
+                            if (j == i) continue;
+
+                            const Vector3 delta = positions[i] - positions[j];
+                            const decimal distanceSquare = delta.lengthSquare();
+                            if (distanceSquare >= diameterSquare || distanceSquare < MACHINE_EPSILON) continue;
+
+                            // Each particle of the pair moves by half the overlap
+                            const decimal distance = std::sqrt(distanceSquare);
+                            correction += delta * (decimal(0.5) * (diameter - distance) / distance);
+                        }
+                    }
+                }
+            }
+
+            corrections[i] = correction;
+        }
+    };
+
+    if (taskScheduler != nullptr) {
+        taskScheduler->parallelForRange(nbParticles, MIN_NB_PARTICLES_PER_TASK, computeCorrections);
+    }
+    else {
+        computeCorrections(0, nbParticles);
+    }
+
+    for (uint i=0; i < nbParticles; i++) {
+        mPositions[i] += corrections[i];
+    }
+}
+
+// Collide the particles with the proxy shapes of the world
+/// A ray is cast from the previous position of each particle to its new position extended by
+/// the radius of the particle, along its motion or toward the surface it was touching at the
+/// previous step (to keep a resting or sliding particle on the surface). When the ray hits a
+/// proxy shape, the particle is placed at one radius from the hit point along the surface normal
+/// and the normal velocity is reflected with the bounciness. The tangential velocity is reduced
+/// by the friction coefficient times the change of normal velocity (Coulomb friction).
+/**
+ * @param previousPositions Positions of the particles at the beginning of the step
+ */
+void ParticleSystem::solveShapeCollisions(const Vector3* previousPositions) {
+
+    RP3D_PROFILE("ParticleSystem::solveShapeCollisions()", mProfiler);
+
+    const decimal radius = mSettings.radius;
+
+    Ray* rays = static_cast<Ray*>(mMemoryManager.allocate(MemoryManager::AllocationType::Frame,
+                                  mNbParticles * sizeof(Ray), MemoryTag::Bodies));
+    uint32* raysParticles = static_cast<uint32*>(mMemoryManager.allocate(MemoryManager::AllocationType::Frame,
+                                                 mNbParticles * sizeof(uint32), MemoryTag::Bodies));
+
+    // Create the rays of the particles that have moved or that were in contact
+    uint nbRays = 0;
+    for (uint i=0; i < mNbParticles; i++) {
+
+        Vector3 probeDirection = -mContactNormals[i];
+        if (probeDirection.isZero()) {
+            const Vector3 motion = mPositions[i] - previousPositions[i];
+            const decimal motionLengthSquare = motion.lengthSquare();
+            if (motionLengthSquare < MACHINE_EPSILON) continue;
+            probeDirection = motion / std::sqrt(motionLengthSquare);
+        }
+
+        new (rays + nbRays) Ray(previousPositions[i], mPositions[i] + radius * probeDirection);
+        raysParticles[nbRays] = i;
+        nbRays++;
+    }
+
+    if (nbRays == 0) {
+        for (uint i=0; i < mNbParticles; i++) mContactNormals[i].setToZero();
+        return;
+    }
+
+    RaycastHit* hits = static_cast<RaycastHit*>(mMemoryManager.allocate(MemoryManager::AllocationType::Frame,
+                                                nbRays * sizeof(RaycastHit), MemoryTag::Bodies));
+    for (uint r=0; r < nbRays; r++) new (hits + r) RaycastHit();
+
+    mCollisionDetection.raycastBatch(rays, nbRays, hits, mSettings.collideWithMaskBits);
+
+    for (uint i=0; i < mNbParticles; i++) mContactNormals[i].setToZero();
+
+    for (uint r=0; r < nbRays; r++) {
+
+        if (!hits[r].isHit()) continue;
+
+        const uint i = raysParticles[r];
+        Vector3 normal = hits[r].worldNormal;
+        const decimal normalLengthSquare = normal.lengthSquare();
+        if (normalLengthSquare < MACHINE_EPSILON) continue;
+        normal /= std::sqrt(normalLengthSquare);
+
+        mPositions[i] = hits[r].worldPoint + radius * normal;
+        mContactNormals[i] = normal;
+
+        const decimal normalVelocity = mVelocities[i].dot(normal);
+        if (normalVelocity >= decimal(0.0)) continue;
+
+        // The particles do not bounce at low velocities (as the contacts of the rigid bodies)
+        const decimal restitution = -normalVelocity > mSettings.restitutionVelocityThreshold ? mSettings.bounciness :
+                                                                                      decimal(0.0);
+        const decimal normalVelocityChange = -(decimal(1.0) + restitution) * normalVelocity;
+
+        Vector3 tangentVelocity = mVelocities[i] - normalVelocity * normal;
+        const decimal tangentSpeed = tangentVelocity.length();
+        const decimal frictionVelocityChange = mSettings.frictionCoefficient * normalVelocityChange;
+        if (tangentSpeed <= frictionVelocityChange) {
+            tangentVelocity.setToZero();
+        }
+        else {
+            tangentVelocity *= decimal(1.0) - frictionVelocityChange / tangentSpeed;
+        }
+
+        mVelocities[i] = tangentVelocity - restitution * normalVelocity * normal;
+    }
+}
@@ -0,0 +1,323 @@
+/********************************************************************************
+* ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
+* Copyright (c) 2010-2018 Daniel Chappuis                                       *
+*********************************************************************************
+*                                                                               *
+* This software is provided 'as-is', without any express or implied warranty.   *
+* In no event will the authors be held liable for any damages arising from the  *
+* use of this software.                                                         *
+*                                                                               *
+* Permission is granted to anyone to use this software for any purpose,         *
+* including commercial applications, and to alter it and redistribute it        *
+* freely, subject to the following restrictions:                                *
+*                                                                               *
+* 1. The origin of this software must not be misrepresented; you must not claim *
+*    that you wrote the original software. If you use this software in a        *
+*    product, an acknowledgment in the product documentation would be           *
+*    appreciated but is not required.                                           *
+*                                                                               *
+* 2. Altered source versions must be plainly marked as such, and must not be    *
+*    misrepresented as being the original software.                             *
+*                                                                               *
+* 3. This notice may not be removed or altered from any source distribution.    *
+*                                                                               *
+********************************************************************************/
+
+#ifndef REACTPHYSICS3D_PARTICLE_SYSTEM_H
+#define REACTPHYSICS3D_PARTICLE_SYSTEM_H
+
+// Libraries
+#include "configuration.h"
+#include "mathematics/mathematics.h"
+
+/// ReactPhysics3D namespace
+namespace reactphysics3d {
+
+// Class declarations
+class CollisionDetection;
+class MemoryManager;
+class TaskScheduler;
+class Profiler;
+
+// Structure ParticleSystemSettings
+/**
+ * This structure contains the settings of a particle system. All the particles of a
+ * system are spheres with the same radius.
+ */
+struct ParticleSystemSettings {
+
+    /// Radius of the particles (in meters)
+    decimal radius = decimal(0.05);
+
+    /// Bounciness of the particles when they hit a proxy shape (between 0 and 1)
+    decimal bounciness = decimal(0.2);
+
+    /// Normal velocity below which the particles do not bounce on the proxy shapes
+    decimal restitutionVelocityThreshold = decimal(1.0);
+
+    /// Friction coefficient between the particles and the proxy shapes
+    decimal frictionCoefficient = decimal(0.3);
+
+    /// Linear damping of the velocity of the particles
+    decimal linearDamping = decimal(0.0);
+
+    /// Number of iterations used to separate the overlapping particles at each step
+    uint nbParticleCollisionIterations = 2;
+
+    /// True if the particles collide with each other
+    bool isParticleCollisionEnabled = true;
+
+    /// Bits mask of the collision categories of the proxy shapes that the particles hit
+    collisionmask collideWithMaskBits = ALL_COLLISION_CATEGORIES;
+};
+
+// Class ParticleSystem
+/**
+ * This class simulates a large number of small spheres with the same radius (sand, debris
+ * or projectiles for instance) that would be much too expensive to simulate as rigid bodies
+ * with a proxy shape each. The positions and velocities of the particles are stored in
+ * contiguous arrays (structure of arrays) and a particle is only identified by its index in
+ * those arrays. When a particle is removed, the last particle is moved into its slot.
+ *
+ * The particles are stepped at the end of the solver stage of their dynamics world. They
+ * collide with each other through a uniform grid of cells whose size is the diameter of the
+ * particles (a hash of the cell coordinates gives the cell of the grid in a table), which is
+ * rebuilt with a counting sort at each iteration instead of using a dynamic AABB tree. The
+ * overlapping particles are pushed apart (position-based) and their velocities are derived
+ * from their displacements. The corrections of all the particles are computed from the same
+ * positions and applied together so that the result does not depend on the order of the
+ * particles and they can be computed in parallel. The particles collide with the proxy shapes
+ * of the world with a batch of rays cast through the broad-phase along their motion (or
+ * toward the shape they were touching at the previous step). The coupling is one-way: the
+ * bodies are never pushed by the particles.
+ */
+class ParticleSystem {
+
+    private:
+
+        // -------------------- Constants -------------------- //
+
+        /// Number of particles allocated the first time a particle is added
+        static const uint INITIAL_CAPACITY = 64;
+
+        /// Minimum number of particles for each task of the collisions between particles
+        static const uint MIN_NB_PARTICLES_PER_TASK = 256;
+
+        // -------------------- Attributes -------------------- //
+
+        /// Settings of the particle system
+        ParticleSystemSettings mSettings;
+
+        /// Collision detection of the world (used to cast the rays of the particles)
+        CollisionDetection& mCollisionDetection;
+
+        /// Memory manager of the world
+        MemoryManager& mMemoryManager;
+
+        /// Number of particles
+        uint mNbParticles;
+
+        /// Number of particles that can be stored before the arrays need to grow
+        uint mCapacity;
+
+        /// Position of each particle
+        Vector3* mPositions;
+
+        /// Linear velocity of each particle
+        Vector3* mVelocities;
+
+        /// Normal of the surface touched by each particle at the last step (zero if the
+        /// particle did not touch any proxy shape)
+        Vector3* mContactNormals;
+
+#ifdef IS_PROFILING_ACTIVE
+
+        /// Pointer to the profiler
+        Profiler* mProfiler;
+
+#endif
+
+        // -------------------- Methods -------------------- //
+
+        /// Reallocate the arrays with a larger capacity
+        void allocate(uint capacity);
+
+        /// Push apart the overlapping particles
+        void solveParticleCollisions(TaskScheduler* taskScheduler);
+
+        /// Collide the particles with the proxy shapes of the world
+        void solveShapeCollisions(const Vector3* previousPositions);
+
+        /// Step the particles
+        void update(decimal timeStep, const Vector3& gravity, TaskScheduler* taskScheduler);
+
+#ifdef IS_PROFILING_ACTIVE
+
+        /// Set the profiler
+        void setProfiler(Profiler* profiler);
+
+#endif
+
+    public:
+
+        // -------------------- Methods -------------------- //
+
+        /// Constructor
+        ParticleSystem(const ParticleSystemSettings& settings, CollisionDetection& collisionDetection,
+                       MemoryManager& memoryManager);
+
+        /// Destructor
+        ~ParticleSystem();
+
+        /// Deleted copy-constructor
+        ParticleSystem(const ParticleSystem& system) = delete;
+
+        /// Deleted assignment operator
+        ParticleSystem& operator=(const ParticleSystem& system) = delete;
+
+        /// Add a particle and return its index
+        uint addParticle(const Vector3& position, const Vector3& velocity = Vector3::zero());
+
+        /// Remove a particle (the last particle is moved at its index)
+        void removeParticle(uint index);
+
+        /// Remove all the particles
+        void clear();
+
+        /// Allocate the memory needed to store a given number of particles
+        void reserve(uint capacity);
+
+        /// Return the number of particles
+        uint getNbParticles() const;
+
+        /// Return the array with the positions of the particles
+        const Vector3* getPositions() const;
+
+        /// Return the array with the velocities of the particles
+        const Vector3* getVelocities() const;
+
+        /// Return the position of a particle
+        const Vector3& getPosition(uint index) const;
+
+        /// Set the position of a particle
+        void setPosition(uint index, const Vector3& position);
+
+        /// Return the linear velocity of a particle
+        const Vector3& getVelocity(uint index) const;
+
+        /// Set the linear velocity of a particle
+        void setVelocity(uint index, const Vector3& velocity);
+
+        /// Return true if a particle has touched a proxy shape during the last step
+        bool isInContact(uint index) const;
+
+        /// Return the normal of the surface touched by a particle during the last step
+        const Vector3& getContactNormal(uint index) const;
+
+        /// Return the settings of the particle system
+        const ParticleSystemSettings& getSettings() const;
+
+        // -------------------- Friendship -------------------- //
+
+        friend class DynamicsWorld;
+};
+
+// Return the number of particles
+inline uint ParticleSystem::getNbParticles() const {
+    return mNbParticles;
+}
+
+// Return the array with the positions of the particles
+/**
+ * @return Array with getNbParticles() positions (invalidated when a particle is added)
+ */
+inline const Vector3* ParticleSystem::getPositions() const {
+    return mPositions;
+}
+
+// Return the array with the velocities of the particles
+/**
+ * @return Array with getNbParticles() velocities (invalidated when a particle is added)
+ */
+inline const Vector3* ParticleSystem::getVelocities() const {
+    return mVelocities;
+}
+
+// Return the position of a particle
+/**
+ * @param index Index of the particle
+ * @return The position of the particle in world-space
+ */
+inline const Vector3& ParticleSystem::getPosition(uint index) const {
+    assert(index < mNbParticles);
+    return mPositions[index];
+}
+
+// Set the position of a particle
+/**
+ * @param index Index of the particle
+ * @param position The new position of the particle in world-space
+ */
+inline void ParticleSystem::setPosition(uint index, const Vector3& position) {
+    assert(index < mNbParticles);
+    mPositions[index] = position;
+    mContactNormals[index].setToZero();
+}
+
+// Return the linear velocity of a particle
+/**
+ * @param index Index of the particle
+ * @return The linear velocity of the particle (in meters per second)
+ */
+inline const Vector3& ParticleSystem::getVelocity(uint index) const {
+    assert(index < mNbParticles);
+    return mVelocities[index];
+}
+
+// Set the linear velocity of a particle
+/**
+ * @param index Index of the particle
+ * @param velocity The new linear velocity of the particle (in meters per second)
+ */
+inline void ParticleSystem::setVelocity(uint index, const Vector3& velocity) {
+    assert(index < mNbParticles);
+    mVelocities[index] = velocity;
+}
+
+// Return true if a particle has touched a proxy shape during the last step
+/**
+ * @param index Index of the particle
+ * @return True if the particle has touched a proxy shape
+ */
+inline bool ParticleSystem::isInContact(uint index) const {
+    assert(index < mNbParticles);
+    return !mContactNormals[index].isZero();
+}
+
+// Return the normal of the surface touched by a particle during the last step
+/**
+ * @param index Index of the particle
+ * @return The unit normal of the surface in world-space (zero if the particle is not in contact)
+ */
+inline const Vector3& ParticleSystem::getContactNormal(uint index) const {
+    assert(index < mNbParticles);
+    return mContactNormals[index];
+}
+
+// Return the settings of the particle system
+inline const ParticleSystemSettings& ParticleSystem::getSettings() const {
+    return mSettings;
+}
+
+#ifdef IS_PROFILING_ACTIVE
+
+// Set the profiler
+inline void ParticleSystem::setProfiler(Profiler* profiler) {
+    mProfiler = profiler;
+}
+
+#endif
+
+}
+
+#endif
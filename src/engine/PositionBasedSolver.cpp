@@ -0,0 +1,611 @@
+/********************************************************************************
+* ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
+* Copyright (c) 2010-2018 Daniel Chappuis                                       *
+*********************************************************************************
+*                                                                               *
+* This software is provided 'as-is', without any express or implied warranty.   *
+* In no event will the authors be held liable for any damages arising from the  *
+* use of this software.                                                         *
+*                                                                               *
+* Permission is granted to anyone to use this software for any purpose,         *
+* including commercial applications, and to alter it and redistribute it        *
+* freely, subject to the following restrictions:                                *
+*                                                                               *
+* 1. The origin of this software must not be misrepresented; you must not claim *
+*    that you wrote the original software. If you use this software in a        *
+*    product, an acknowledgment in the product documentation would be           *
+*    appreciated but is not required.                                           *
+*                                                                               *
+* 2. Altered source versions must be plainly marked as such, and must not be    *
+*    misrepresented as being the original software.                             *
+*                                                                               *
+* 3. This notice may not be removed or altered from any source distribution.    *
+*                                                                               *
+********************************************************************************/
+
+
+// Libraries
+#include "PositionBasedSolver.h"
+#include "engine/Island.h"
+#include "body/RigidBody.h"
+#include "collision/ContactManifold.h"
+#include "collision/ProxyShape.h"
+#include "constraint/ContactPoint.h"
+#include "constraint/BallAndSocketJoint.h"
+#include "constraint/SliderJoint.h"
+#include "constraint/HingeJoint.h"
+#include "constraint/FixedJoint.h"
+#include "memory/MemoryManager.h"
+#include "utils/Profiler.h"
+
+using namespace reactphysics3d;
+
+// Static variables definition
+const decimal PositionBasedSolver::PENETRATION_SLOP = decimal(0.005);
+
+// Constructor
+PositionBasedSolver::PositionBasedSolver(MemoryManager& memoryManager, const WorldSettings& worldSettings,
+                                         const MaterialTable& materialTable)
+                    : mWorldSettings(worldSettings), mMaterialTable(materialTable), mArena(memoryManager.getBaseAllocator(MemoryTag::Solver)),
+                      mIslands(nullptr), mNbIslands(0), mContacts(nullptr), mIslandsFirstContactIndex(nullptr),
+                      mIslandsNbContacts(nullptr), mJointsLambdas(nullptr), mIslandsFirstJointIndex(nullptr),
+                      mJointsBodiesIndices(nullptr), mIslandsFirstBodyIndex(nullptr),
+                      mPreviousPositions(nullptr), mPreviousOrientations(nullptr), mLinearVelocities(nullptr),
+                      mAngularVelocities(nullptr), mPositions(nullptr), mOrientations(nullptr),
+                      mInverseMasses(nullptr), mInverseInertiaTensors(nullptr), mTimeStep(decimal(0.0)) {
+
+#ifdef IS_PROFILING_ACTIVE
+
+        mProfiler = nullptr;
+#endif
+
+}
+
+// Allocate the contacts and the bodies arrays of the islands of the current step
+/// The memory is allocated in the arena of the solver that is reused from one step to the next
+/**
+ * @param islands Array of islands of the current step
+ * @param nbIslands Number of islands
+ * @param nbBodies Number of entries of the bodies arrays (for all the islands)
+ */
+void PositionBasedSolver::init(Island** islands, uint nbIslands, uint nbBodies) {
+
+    RP3D_PROFILE("PositionBasedSolver::init()", mProfiler);
+
+    mArena.reset();
+
+    mIslands = islands;
+    mNbIslands = nbIslands;
+    mContacts = nullptr;
+    mJointsLambdas = nullptr;
+    mJointsBodiesIndices = nullptr;
+
+    if (nbIslands == 0) return;
+
+    // Count the contact points and the joints of the islands
+    mIslandsFirstContactIndex = static_cast<uint*>(mArena.allocate(sizeof(uint) * nbIslands));
+    mIslandsNbContacts = static_cast<uint*>(mArena.allocate(sizeof(uint) * nbIslands));
+    mIslandsFirstJointIndex = static_cast<uint*>(mArena.allocate(sizeof(uint) * nbIslands));
+    mIslandsFirstBodyIndex = static_cast<uint*>(mArena.allocate(sizeof(uint) * nbIslands));
+    uint nbContacts = 0;
+    uint nbJoints = 0;
+    for (uint i=0; i < nbIslands; i++) {
+
+        mIslandsFirstContactIndex[i] = nbContacts;
+        mIslandsNbContacts[i] = 0;
+        mIslandsFirstJointIndex[i] = nbJoints;
+
+        ContactManifold** manifolds = islands[i]->getContactManifolds();
+        for (uint m=0; m < islands[i]->getNbContactManifolds(); m++) {
+            nbContacts += manifolds[m]->getNbContactPoints();
+        }
+        nbJoints += islands[i]->getNbJoints();
+    }
+
+    if (nbContacts > 0) {
+        mContacts = static_cast<PositionBasedContact*>(mArena.allocate(sizeof(PositionBasedContact) * nbContacts));
+    }
+    if (nbJoints > 0) {
+        mJointsLambdas = static_cast<decimal*>(mArena.allocate(sizeof(decimal) * NB_LAMBDAS_PER_JOINT * nbJoints));
+        mJointsBodiesIndices = static_cast<uint*>(mArena.allocate(sizeof(uint) * 2 * nbJoints));
+    }
+
+    mPreviousPositions = static_cast<Vector3*>(mArena.allocate(sizeof(Vector3) * nbBodies));
+    mPreviousOrientations = static_cast<Quaternion*>(mArena.allocate(sizeof(Quaternion) * nbBodies));
+    mInverseMasses = static_cast<decimal*>(mArena.allocate(sizeof(decimal) * nbBodies));
+    mInverseInertiaTensors = static_cast<Matrix3x3*>(mArena.allocate(sizeof(Matrix3x3) * nbBodies));
+}
+
+// Initialize the contacts and the joints of an island for the next substep
+/// This must be called after the velocities of the bodies of the island have been integrated.
+/// The indices of the bodies in the arrays are stored here because the index of a static
+/// body depends on the island that has been initialized last.
+/**
+ * @param islandIndex Index of the island
+ */
+void PositionBasedSolver::initializeForIsland(uint islandIndex) {
+
+    RP3D_PROFILE("PositionBasedSolver::initializeForIsland()", mProfiler);
+
+    assert(islandIndex < mNbIslands);
+    Island* island = mIslands[islandIndex];
+
+    // The bodies of an island are stored contiguously in the arrays
+    mIslandsFirstBodyIndex[islandIndex] = island->getBodies()[0]->mArrayIndex;
+
+    // Store the indices of the bodies of the joints
+    Joint** joints = island->getJoints();
+    uint* jointsBodiesIndices = mJointsBodiesIndices + 2 * mIslandsFirstJointIndex[islandIndex];
+    for (uint j=0; j < island->getNbJoints(); j++) {
+        jointsBodiesIndices[2 * j] = joints[j]->mBody1->mArrayIndex;
+        jointsBodiesIndices[2 * j + 1] = joints[j]->mBody2->mArrayIndex;
+    }
+
+    uint contactIndex = mIslandsFirstContactIndex[islandIndex];
+
+    // For each contact manifold of the island
+    ContactManifold** manifolds = island->getContactManifolds();
+    for (uint m=0; m < island->getNbContactManifolds(); m++) {
+
+        RigidBody* body1 = static_cast<RigidBody*>(manifolds[m]->getBody1());
+        RigidBody* body2 = static_cast<RigidBody*>(manifolds[m]->getBody2());
+        const ProxyShape* shape1 = manifolds[m]->getShape1();
+        const ProxyShape* shape2 = manifolds[m]->getShape2();
+
+        // Mix the materials of the two bodies as the contact solver does
+        const MaterialPairProperties materialProperties = mMaterialTable.computePairProperties(body1->getMaterial(),
+                                                                                               body2->getMaterial());
+        const decimal frictionCoefficient = materialProperties.frictionCoefficient;
+        const decimal restitutionFactor = materialProperties.bounciness;
+
+        const Vector3& v1 = mLinearVelocities[body1->mArrayIndex];
+        const Vector3& w1 = mAngularVelocities[body1->mArrayIndex];
+        const Vector3& v2 = mLinearVelocities[body2->mArrayIndex];
+        const Vector3& w2 = mAngularVelocities[body2->mArrayIndex];
+
+        // For each contact point of the manifold
+        for (ContactPoint* point = manifolds[m]->getContactPoints(); point != nullptr; point = point->getNext()) {
+
+            PositionBasedContact& contact = mContacts[contactIndex];
+            contact.indexBody1 = body1->mArrayIndex;
+            contact.indexBody2 = body2->mArrayIndex;
+            contact.localPointBody1 = shape1->getLocalToBodyTransform() * point->getLocalPointOnShape1() -
+                                      body1->mCenterOfMassLocal;
+            contact.localPointBody2 = shape2->getLocalToBodyTransform() * point->getLocalPointOnShape2() -
+                                      body2->mCenterOfMassLocal;
+            contact.normal = point->getNormal();
+            contact.frictionCoefficient = frictionCoefficient;
+            contact.restitutionFactor = restitutionFactor;
+            contact.normalLambda = decimal(0.0);
+            contact.tangentLambda = decimal(0.0);
+
+            // Normal relative velocity of the contact points before the substep
+            const Vector3 r1 = body1->getTransform().getOrientation() * contact.localPointBody1;
+            const Vector3 r2 = body2->getTransform().getOrientation() * contact.localPointBody2;
+            contact.normalVelocity = (v1 + w1.cross(r1) - v2 - w2.cross(r2)).dot(contact.normal);
+
+            contactIndex++;
+        }
+    }
+
+    mIslandsNbContacts[islandIndex] = contactIndex - mIslandsFirstContactIndex[islandIndex];
+}
+
+// Solve the constraints of an island during a substep
+/// The positions of the bodies are predicted, corrected by the constraints and the
+/// velocities of the bodies are then derived from their displacement.
+/**
+ * @param islandIndex Index of the island
+ * @param timeStep Time step of the substep
+ */
+void PositionBasedSolver::solveIsland(uint islandIndex, decimal timeStep) {
+
+    assert(islandIndex < mNbIslands);
+    assert(timeStep > decimal(0.0));
+    Island* island = mIslands[islandIndex];
+
+    mTimeStep = timeStep;
+    const decimal halfTimeStep = decimal(0.5) * timeStep;
+
+    // Predict the positions and orientations of the bodies
+    RigidBody** bodies = island->getBodies();
+    const uint firstBodyIndex = mIslandsFirstBodyIndex[islandIndex];
+    for (uint b=0; b < island->getNbBodies(); b++) {
+
+        const uint index = firstBodyIndex + b;
+
+        mPreviousPositions[index] = bodies[b]->getCenterOfMassWorld();
+        mPreviousOrientations[index] = bodies[b]->getTransform().getOrientation();
+
+        // The static bodies (and the sleeping bodies used as fixed bodies) do not move
+        if (isBodyFixed(bodies[b])) {
+            mInverseMasses[index] = decimal(0.0);
+            mInverseInertiaTensors[index].setToZero();
+            mPositions[index] = mPreviousPositions[index];
+            mOrientations[index] = mPreviousOrientations[index];
+            continue;
+        }
+
+        mInverseMasses[index] = bodies[b]->mMassInverse;
+        mInverseInertiaTensors[index] = bodies[b]->getInertiaTensorInverseWorld();
+
+        mPositions[index] = mPreviousPositions[index] + mLinearVelocities[index] * timeStep;
+        mOrientations[index] = mPreviousOrientations[index] + Quaternion(0, mAngularVelocities[index]) *
+                               mPreviousOrientations[index] * halfTimeStep;
+        mOrientations[index].normalize();
+    }
+
+    // Reset the Lagrange multipliers of the joints
+    decimal* jointsLambdas = mJointsLambdas + NB_LAMBDAS_PER_JOINT * mIslandsFirstJointIndex[islandIndex];
+    for (uint i=0; i < NB_LAMBDAS_PER_JOINT * island->getNbJoints(); i++) {
+        jointsLambdas[i] = decimal(0.0);
+    }
+
+    // Correct the positions with the constraints
+    const uint nbIterations = std::max(island->getNbPositionSolverIterations(), uint(1));
+    for (uint i=0; i < nbIterations; i++) {
+
+        Joint** joints = island->getJoints();
+        const uint* jointsBodiesIndices = mJointsBodiesIndices + 2 * mIslandsFirstJointIndex[islandIndex];
+        for (uint j=0; j < island->getNbJoints(); j++) {
+            solveJointPositions(joints[j], jointsBodiesIndices[2 * j], jointsBodiesIndices[2 * j + 1],
+                                jointsLambdas + NB_LAMBDAS_PER_JOINT * j);
+        }
+
+        solveContactsPositions(islandIndex);
+    }
+
+    // Compute the velocities of the bodies from their displacement
+    const decimal inverseTimeStep = decimal(1.0) / timeStep;
+    for (uint b=0; b < island->getNbBodies(); b++) {
+
+        if (isBodyFixed(bodies[b])) continue;
+
+        const uint index = firstBodyIndex + b;
+
+        mLinearVelocities[index] = (mPositions[index] - mPreviousPositions[index]) * inverseTimeStep;
+
+        const Quaternion deltaOrientation = mOrientations[index] * mPreviousOrientations[index].getInverse();
+        mAngularVelocities[index] = decimal(2.0) * inverseTimeStep * deltaOrientation.getVectorV();
+        if (deltaOrientation.w < decimal(0.0)) mAngularVelocities[index] = -mAngularVelocities[index];
+    }
+
+    // Apply the restitution and the dynamic friction of the contacts. The contacts are only
+    // computed once per step and the bodies that touch during the step can push each other with
+    // a large velocity. The normal velocities are therefore solved with the velocity iterations
+    // of the island so that this velocity is not transmitted to the other contacts.
+    solveContactsVelocities(islandIndex, true);
+    for (uint i=1; i < island->getNbVelocitySolverIterations(); i++) {
+        solveContactsVelocities(islandIndex, false);
+    }
+}
+
+// Return true if a body is not moved by the solver
+/// The static bodies and the sleeping bodies used as fixed bodies by an island do not move
+/// and can be shared by several islands
+bool PositionBasedSolver::isBodyFixed(const RigidBody* body) {
+    return body->getType() == BodyType::STATIC || body->isSleeping();
+}
+
+// Return the generalized inverse mass of a body for a correction at a point along a direction
+/**
+ * @param indexBody Index of the body
+ * @param r Vector from the center of mass of the body to the point in world-space
+ * @param direction Unit direction of the correction
+ * @return The generalized inverse mass
+ */
+decimal PositionBasedSolver::computeGeneralizedInverseMass(uint indexBody, const Vector3& r,
+                                                           const Vector3& direction) const {
+
+    const Vector3 rCrossN = r.cross(direction);
+    return mInverseMasses[indexBody] + rCrossN.dot(mInverseInertiaTensors[indexBody] * rCrossN);
+}
+
+// Apply a positional correction between two points of two bodies
+/// The point of body 1 is moved along the correction and the point of body 2 in the opposite
+/// direction so that the distance between the two points is reduced by the length of the correction.
+/**
+ * @param indexBody1 Index of body 1
+ * @param indexBody2 Index of body 2
+ * @param r1 Vector from the center of mass of body 1 to its point in world-space
+ * @param r2 Vector from the center of mass of body 2 to its point in world-space
+ * @param correction Correction of the point of body 1 relative to the point of body 2
+ * @param compliance Compliance (inverse of the stiffness) of the constraint
+ * @param lambda Accumulated Lagrange multiplier of the constraint during the substep
+ */
+void PositionBasedSolver::applyPositionalCorrection(uint indexBody1, uint indexBody2, const Vector3& r1,
+                                                    const Vector3& r2, const Vector3& correction,
+                                                    decimal compliance, decimal& lambda) {
+
+    const decimal error = correction.length();
+    if (error <= MACHINE_EPSILON) return;
+    const Vector3 direction = correction / error;
+
+    const decimal inverseMass = computeGeneralizedInverseMass(indexBody1, r1, direction) +
+                                computeGeneralizedInverseMass(indexBody2, r2, direction);
+    const decimal alpha = compliance / (mTimeStep * mTimeStep);
+    if (inverseMass + alpha <= decimal(0.0)) return;
+
+    const decimal deltaLambda = (error - alpha * lambda) / (inverseMass + alpha);
+    lambda += deltaLambda;
+    const Vector3 impulse = deltaLambda * direction;
+
+    // Move body 1
+    mPositions[indexBody1] += mInverseMasses[indexBody1] * impulse;
+    mOrientations[indexBody1] += Quaternion(0, mInverseInertiaTensors[indexBody1] * r1.cross(impulse)) *
+                                 mOrientations[indexBody1] * decimal(0.5);
+    mOrientations[indexBody1].normalize();
+
+    // Move body 2
+    mPositions[indexBody2] -= mInverseMasses[indexBody2] * impulse;
+    mOrientations[indexBody2] -= Quaternion(0, mInverseInertiaTensors[indexBody2] * r2.cross(impulse)) *
+                                 mOrientations[indexBody2] * decimal(0.5);
+    mOrientations[indexBody2].normalize();
+}
+
+// Apply an angular correction between two bodies
+/// Body 1 is rotated around the correction vector and body 2 in the opposite direction
+/// so that their relative rotation is reduced by the length of the correction.
+/**
+ * @param indexBody1 Index of body 1
+ * @param indexBody2 Index of body 2
+ * @param correction Rotation vector (axis times angle) of body 1 relative to body 2
+ * @param compliance Compliance (inverse of the stiffness) of the constraint
+ * @param lambda Accumulated Lagrange multiplier of the constraint during the substep
+ */
+void PositionBasedSolver::applyAngularCorrection(uint indexBody1, uint indexBody2, const Vector3& correction,
+                                                 decimal compliance, decimal& lambda) {
+
+    const decimal angle = correction.length();
+    if (angle <= MACHINE_EPSILON) return;
+    const Vector3 axis = correction / angle;
+
+    const decimal inverseMass = axis.dot(mInverseInertiaTensors[indexBody1] * axis) +
+                                axis.dot(mInverseInertiaTensors[indexBody2] * axis);
+    const decimal alpha = compliance / (mTimeStep * mTimeStep);
+    if (inverseMass + alpha <= decimal(0.0)) return;
+
+    const decimal deltaLambda = (angle - alpha * lambda) / (inverseMass + alpha);
+    lambda += deltaLambda;
+    const Vector3 impulse = deltaLambda * axis;
+
+    mOrientations[indexBody1] += Quaternion(0, mInverseInertiaTensors[indexBody1] * impulse) *
+                                 mOrientations[indexBody1] * decimal(0.5);
+    mOrientations[indexBody1].normalize();
+
+    mOrientations[indexBody2] -= Quaternion(0, mInverseInertiaTensors[indexBody2] * impulse) *
+                                 mOrientations[indexBody2] * decimal(0.5);
+    mOrientations[indexBody2].normalize();
+}
+
+// Apply an impulse at a point of two bodies
+/// The impulse is applied to body 1 and the opposite impulse to body 2.
+void PositionBasedSolver::applyImpulse(uint indexBody1, uint indexBody2, const Vector3& r1, const Vector3& r2,
+                                       const Vector3& impulse) {
+
+    mLinearVelocities[indexBody1] += mInverseMasses[indexBody1] * impulse;
+    mAngularVelocities[indexBody1] += mInverseInertiaTensors[indexBody1] * r1.cross(impulse);
+    mLinearVelocities[indexBody2] -= mInverseMasses[indexBody2] * impulse;
+    mAngularVelocities[indexBody2] -= mInverseInertiaTensors[indexBody2] * r2.cross(impulse);
+}
+
+// Solve the position constraints of the contacts of an island
+/// The contact points that penetrate are pushed apart along the contact normal. A small
+/// penetration is kept so that the collision detection still reports the resting contacts
+/// at the next step. The static friction then cancels the tangential displacement of the
+/// contact points during the substep as long as the friction force stays inside the friction
+/// cone.
+void PositionBasedSolver::solveContactsPositions(uint islandIndex) {
+
+    PositionBasedContact* contacts = mContacts + mIslandsFirstContactIndex[islandIndex];
+    const uint nbContacts = mIslandsNbContacts[islandIndex];
+
+    // Push the bodies apart along the normal of the penetrating contacts
+    for (uint c=0; c < nbContacts; c++) {
+
+        PositionBasedContact& contact = contacts[c];
+        const uint index1 = contact.indexBody1;
+        const uint index2 = contact.indexBody2;
+
+        // Penetration depth of the contact points at the current positions
+        const Vector3 r1 = mOrientations[index1] * contact.localPointBody1;
+        const Vector3 r2 = mOrientations[index2] * contact.localPointBody2;
+        const decimal penetrationDepth = (mPositions[index1] + r1 - mPositions[index2] - r2).dot(contact.normal);
+        if (penetrationDepth <= PENETRATION_SLOP) continue;
+
+        applyPositionalCorrection(index1, index2, r1, r2, (PENETRATION_SLOP - penetrationDepth) * contact.normal,
+                                  decimal(0.0), contact.normalLambda);
+    }
+
+    // Apply the static friction after all the normal corrections so that the rotation
+    // given to a body by the normal correction of one of its contact points is not
+    // cancelled by the friction of this point before the other points are corrected
+    for (uint c=0; c < nbContacts; c++) {
+
+        PositionBasedContact& contact = contacts[c];
+        if (contact.normalLambda <= decimal(0.0)) continue;
+
+        const uint index1 = contact.indexBody1;
+        const uint index2 = contact.indexBody2;
+
+        // Relative tangential displacement of the contact points during the substep
+        const Vector3 r1 = mOrientations[index1] * contact.localPointBody1;
+        const Vector3 r2 = mOrientations[index2] * contact.localPointBody2;
+        const Vector3 previousPoint1 = mPreviousPositions[index1] + mPreviousOrientations[index1] * contact.localPointBody1;
+        const Vector3 previousPoint2 = mPreviousPositions[index2] + mPreviousOrientations[index2] * contact.localPointBody2;
+        const Vector3 displacement = (mPositions[index1] + r1 - previousPoint1) - (mPositions[index2] + r2 - previousPoint2);
+        const Vector3 tangentDisplacement = displacement - displacement.dot(contact.normal) * contact.normal;
+        const decimal tangentLength = tangentDisplacement.length();
+        if (tangentLength <= MACHINE_EPSILON) continue;
+
+        // Apply the static friction only if it stays inside the friction cone
+        const Vector3 tangent = tangentDisplacement / tangentLength;
+        const decimal inverseMass = computeGeneralizedInverseMass(index1, r1, tangent) +
+                                    computeGeneralizedInverseMass(index2, r2, tangent);
+        if (inverseMass <= decimal(0.0)) continue;
+        if (contact.tangentLambda + tangentLength / inverseMass < contact.frictionCoefficient * contact.normalLambda) {
+            applyPositionalCorrection(index1, index2, r1, r2, -tangentDisplacement, decimal(0.0),
+                                      contact.tangentLambda);
+        }
+    }
+}
+
+// Solve the velocities of the contacts of an island (restitution and dynamic friction)
+/// This is only applied to the contacts that have been corrected during the substep
+/**
+ * @param islandIndex Index of the island
+ * @param isFrictionApplied True if the dynamic friction must also be applied
+ */
+void PositionBasedSolver::solveContactsVelocities(uint islandIndex, bool isFrictionApplied) {
+
+    const decimal timeStep2 = mTimeStep * mTimeStep;
+
+    PositionBasedContact* contacts = mContacts + mIslandsFirstContactIndex[islandIndex];
+    for (uint c=0; c < mIslandsNbContacts[islandIndex]; c++) {
+
+        const PositionBasedContact& contact = contacts[c];
+        if (contact.normalLambda <= decimal(0.0)) continue;
+
+        const uint index1 = contact.indexBody1;
+        const uint index2 = contact.indexBody2;
+        const Vector3 r1 = mOrientations[index1] * contact.localPointBody1;
+        const Vector3 r2 = mOrientations[index2] * contact.localPointBody2;
+
+        // Relative velocity of the contact points
+        const Vector3 velocity = mLinearVelocities[index1] + mAngularVelocities[index1].cross(r1) -
+                                 mLinearVelocities[index2] - mAngularVelocities[index2].cross(r2);
+        const decimal normalVelocity = velocity.dot(contact.normal);
+        const Vector3 tangentVelocity = velocity - normalVelocity * contact.normal;
+        const decimal tangentSpeed = tangentVelocity.length();
+
+        Vector3 deltaVelocity(0, 0, 0);
+
+        // Dynamic friction (bounded by the normal force of the substep)
+        if (isFrictionApplied && tangentSpeed > MACHINE_EPSILON) {
+            const decimal normalForce = contact.normalLambda / timeStep2;
+            deltaVelocity -= tangentVelocity / tangentSpeed *
+                             std::min(mTimeStep * contact.frictionCoefficient * normalForce, tangentSpeed);
+        }
+
+        // Restitution (the slow contacts do not bounce). The normal velocity is also set when
+        // the bodies separate so that the penetration removed during the substep does not
+        // make them bounce.
+        const decimal restitution = contact.normalVelocity > mWorldSettings.restitutionVelocityThreshold ?
+                                    contact.restitutionFactor : decimal(0.0);
+        const decimal targetNormalVelocity = -restitution * std::max(contact.normalVelocity, decimal(0.0));
+        deltaVelocity += (targetNormalVelocity - normalVelocity) * contact.normal;
+
+        const decimal deltaSpeed = deltaVelocity.length();
+        if (deltaSpeed <= MACHINE_EPSILON) continue;
+
+        const Vector3 direction = deltaVelocity / deltaSpeed;
+        const decimal inverseMass = computeGeneralizedInverseMass(index1, r1, direction) +
+                                    computeGeneralizedInverseMass(index2, r2, direction);
+        if (inverseMass <= decimal(0.0)) continue;
+
+        applyImpulse(index1, index2, r1, r2, deltaVelocity / inverseMass);
+    }
+}
+
+// Solve the position constraints of a joint
+/// The anchor points of the ball-and-socket, hinge and fixed joints are kept together. The
+/// slider joint only keeps its anchor points on its axis (and between its limits). The
+/// orientation of the bodies is fixed for the fixed and slider joints and the hinge joint
+/// keeps its axis aligned in the two bodies (and its angle between its limits).
+/**
+ * @param joint Joint to solve
+ * @param indexBody1 Index of body 1 of the joint in the position arrays
+ * @param indexBody2 Index of body 2 of the joint in the position arrays
+ * @param lambdas Lagrange multipliers of the constraints of the joint during the substep
+ */
+void PositionBasedSolver::solveJointPositions(Joint* joint, uint indexBody1, uint indexBody2, decimal* lambdas) {
+
+    const uint index1 = indexBody1;
+    const uint index2 = indexBody2;
+    const Vector3& x1 = mPositions[index1];
+    const Vector3& x2 = mPositions[index2];
+    const Quaternion& q1 = mOrientations[index1];
+    const Quaternion& q2 = mOrientations[index2];
+    const decimal compliance = mWorldSettings.positionBasedJointsCompliance;
+
+    switch (joint->getType()) {
+
+        case JointType::BALLSOCKETJOINT:
+        {
+            const BallAndSocketJoint* ballAndSocketJoint = static_cast<const BallAndSocketJoint*>(joint);
+            const Vector3 r1 = q1 * ballAndSocketJoint->mLocalAnchorPointBody1;
+            const Vector3 r2 = q2 * ballAndSocketJoint->mLocalAnchorPointBody2;
+            applyPositionalCorrection(index1, index2, r1, r2, x2 + r2 - x1 - r1, compliance, lambdas[0]);
+            break;
+        }
+
+        case JointType::FIXEDJOINT:
+        {
+            const FixedJoint* fixedJoint = static_cast<const FixedJoint*>(joint);
+
+            // Rotation that brings body 1 to its initial orientation relative to body 2
+            const Quaternion qError = q2 * fixedJoint->mInitOrientationDifferenceInv * q1.getInverse();
+            const decimal sign = qError.w < decimal(0.0) ? decimal(-2.0) : decimal(2.0);
+            applyAngularCorrection(index1, index2, sign * qError.getVectorV(), compliance, lambdas[1]);
+
+            const Vector3 r1 = q1 * fixedJoint->mLocalAnchorPointBody1;
+            const Vector3 r2 = q2 * fixedJoint->mLocalAnchorPointBody2;
+            applyPositionalCorrection(index1, index2, r1, r2, x2 + r2 - x1 - r1, compliance, lambdas[0]);
+            break;
+        }
+
+        case JointType::HINGEJOINT:
+        {
+            HingeJoint* hingeJoint = static_cast<HingeJoint*>(joint);
+
+            // Align the hinge axis of the two bodies
+            Vector3 a1 = q1 * hingeJoint->mHingeLocalAxisBody1;
+            const Vector3 a2 = q2 * hingeJoint->mHingeLocalAxisBody2;
+            applyAngularCorrection(index1, index2, a1.cross(a2), compliance, lambdas[1]);
+
+            // Keep the hinge angle between the limits
+            if (hingeJoint->mIsLimitEnabled) {
+
+                a1 = q1 * hingeJoint->mHingeLocalAxisBody1;
+                hingeJoint->mA1 = a1;
+                const decimal angle = hingeJoint->computeCurrentHingeAngle(q1, q2);
+                if (angle < hingeJoint->mLowerLimit) {
+                    applyAngularCorrection(index1, index2, (angle - hingeJoint->mLowerLimit) * a1, compliance, lambdas[2]);
+                }
+                else if (angle > hingeJoint->mUpperLimit) {
+                    applyAngularCorrection(index1, index2, (angle - hingeJoint->mUpperLimit) * a1, compliance, lambdas[2]);
+                }
+            }
+
+            const Vector3 r1 = q1 * hingeJoint->mLocalAnchorPointBody1;
+            const Vector3 r2 = q2 * hingeJoint->mLocalAnchorPointBody2;
+            applyPositionalCorrection(index1, index2, r1, r2, x2 + r2 - x1 - r1, compliance, lambdas[0]);
+            break;
+        }
+
+        case JointType::SLIDERJOINT:
+        {
+            const SliderJoint* sliderJoint = static_cast<const SliderJoint*>(joint);
+
+            // Keep the initial orientation of the bodies relative to each other
+            const Quaternion qError = q2 * sliderJoint->mInitOrientationDifferenceInv * q1.getInverse();
+            const decimal sign = qError.w < decimal(0.0) ? decimal(-2.0) : decimal(2.0);
+            applyAngularCorrection(index1, index2, sign * qError.getVectorV(), compliance, lambdas[1]);
+
+            // Translation of the anchor point of body 2 along the slider axis
+            const Vector3 r1 = q1 * sliderJoint->mLocalAnchorPointBody1;
+            const Vector3 r2 = q2 * sliderJoint->mLocalAnchorPointBody2;
+            const Vector3 axis = (q1 * sliderJoint->mSliderAxisBody1).getUnit();
+            const Vector3 u = x2 + r2 - x1 - r1;
+            decimal translation = u.dot(axis);
+            if (sliderJoint->mIsLimitEnabled) {
+                translation = clamp(translation, sliderJoint->mLowerLimit, sliderJoint->mUpperLimit);
+            }
+
+            // Move the anchor point of body 2 on the axis (between the limits)
+            const Vector3 r1OnAxis = r1 + translation * axis;
+            applyPositionalCorrection(index1, index2, r1OnAxis, r2, x2 + r2 - x1 - r1OnAxis, compliance, lambdas[0]);
+            break;
+        }
+    }
+}
@@ -0,0 +1,285 @@
+/********************************************************************************
+* ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
+* Copyright (c) 2010-2018 Daniel Chappuis                                       *
+*********************************************************************************
+*                                                                               *
+* This software is provided 'as-is', without any express or implied warranty.   *
+* In no event will the authors be held liable for any damages arising from the  *
+* use of this software.                                                         *
+*                                                                               *
+* Permission is granted to anyone to use this software for any purpose,         *
+* including commercial applications, and to alter it and redistribute it        *
+* freely, subject to the following restrictions:                                *
+*                                                                               *
+* 1. The origin of this software must not be misrepresented; you must not claim *
+*    that you wrote the original software. If you use this software in a        *
+*    product, an acknowledgment in the product documentation would be           *
+*    appreciated but is not required.                                           *
+*                                                                               *
+* 2. Altered source versions must be plainly marked as such, and must not be    *
+*    misrepresented as being the original software.                             *
+*                                                                               *
+* 3. This notice may not be removed or altered from any source distribution.    *
+*                                                                               *
+********************************************************************************/
+
+
+#ifndef REACTPHYSICS3D_POSITION_BASED_SOLVER_H
+#define REACTPHYSICS3D_POSITION_BASED_SOLVER_H
+
+// Libraries
+#include "configuration.h"
+#include "mathematics/Vector3.h"
+#include "mathematics/Quaternion.h"
+#include "mathematics/Matrix3x3.h"
+#include "memory/ArenaAllocator.h"
+#include "engine/MaterialTable.h"
+#include <cassert>
+
+namespace reactphysics3d {
+
+// Declarations
+class Joint;
+class RigidBody;
+class Island;
+class MemoryManager;
+class ContactPoint;
+class Profiler;
+
+// Structure PositionBasedContact
+/**
+ * This structure contains a contact point solved by the position based solver
+ */
+struct PositionBasedContact {
+
+    /// Index of body 1 in the position arrays
+    uint indexBody1;
+
+    /// Index of body 2 in the position arrays
+    uint indexBody2;
+
+    /// Contact point on body 1 relative to its center of mass in body 1 local-space
+    Vector3 localPointBody1;
+
+    /// Contact point on body 2 relative to its center of mass in body 2 local-space
+    Vector3 localPointBody2;
+
+    /// Unit normal of the contact (from body 1 toward body 2) in world-space
+    Vector3 normal;
+
+    /// Mixed friction coefficient of the two bodies
+    decimal frictionCoefficient;
+
+    /// Mixed restitution factor of the two bodies
+    decimal restitutionFactor;
+
+    /// Normal relative velocity (positive when the bodies approach) before the substep
+    decimal normalVelocity;
+
+    /// Accumulated Lagrange multiplier of the normal constraint during the substep
+    decimal normalLambda;
+
+    /// Accumulated Lagrange multiplier of the static friction constraint during the substep
+    decimal tangentLambda;
+};
+
+// Class PositionBasedSolver
+/**
+ * This class solves the contacts and the joints of the islands with the extended position
+ * based dynamics (XPBD) described by Matthias Müller et al. in "Detailed Rigid Body
+ * Simulation with Extended Position Based Dynamics" (SCA 2020). It replaces the ContactSolver
+ * and the ConstraintSolver when the position based solver is enabled in the world settings.
+ *
+ * At each substep of DynamicsWorld::update(), the positions and orientations of the bodies of
+ * an island are predicted from their velocities (which already contain the external forces).
+ * The constraints then directly correct the predicted positions and orientations and the new
+ * velocities of the bodies are derived from their displacement during the substep. Finally,
+ * the restitution and the dynamic friction of the contacts are applied to the velocities. The
+ * contact points are only computed once per step by the collision detection, therefore the
+ * normal velocities of the contacts are solved with the velocity iterations of the island.
+ * This is only stable with small time steps, therefore a world that uses this solver should
+ * be updated with many substeps and a few (often a single) position iterations.
+ *
+ * The joints are solved as position constraints with the compliance (inverse of the stiffness)
+ * of the world settings. The limits of the hinge and slider joints are supported but their
+ * motors and the break thresholds of the joints are ignored by this solver.
+ */
+class PositionBasedSolver {
+
+    private :
+
+        // -------------------- Constants -------------------- //
+
+        /// Penetration depth that is not corrected so that the resting contacts are kept
+        static const decimal PENETRATION_SLOP;
+
+        /// Number of Lagrange multipliers of each joint (translation, rotation and limit)
+        static const uint NB_LAMBDAS_PER_JOINT = 3;
+
+        // -------------------- Attributes -------------------- //
+
+        /// World settings
+        const WorldSettings& mWorldSettings;
+
+        /// Table of the materials of the world used to combine the materials of the bodies
+        const MaterialTable& mMaterialTable;
+
+        /// Memory arena used to allocate the contacts of the islands (reset at each step)
+        ArenaAllocator mArena;
+
+        /// Array of islands of the current step
+        Island** mIslands;
+
+        /// Number of islands of the current step
+        uint mNbIslands;
+
+        /// Contacts of all the islands
+        PositionBasedContact* mContacts;
+
+        /// Index of the first contact of each island in the contacts array
+        uint* mIslandsFirstContactIndex;
+
+        /// Number of contacts of each island
+        uint* mIslandsNbContacts;
+
+        /// Accumulated Lagrange multipliers of the joints of all the islands during the substep
+        decimal* mJointsLambdas;
+
+        /// Index of the first joint of each island in the joints Lagrange multipliers
+        uint* mIslandsFirstJointIndex;
+
+        /// Index of the two bodies of the joints of all the islands in the position arrays
+        uint* mJointsBodiesIndices;
+
+        /// Index of the first body of each island in the position arrays
+        uint* mIslandsFirstBodyIndex;
+
+        /// Position of the center of mass of the bodies at the beginning of the substep
+        Vector3* mPreviousPositions;
+
+        /// Orientation of the bodies at the beginning of the substep
+        Quaternion* mPreviousOrientations;
+
+        /// Array of the linear velocities of the bodies
+        Vector3* mLinearVelocities;
+
+        /// Array of the angular velocities of the bodies
+        Vector3* mAngularVelocities;
+
+        /// Array of the positions of the center of mass of the bodies
+        Vector3* mPositions;
+
+        /// Array of the orientations of the bodies
+        Quaternion* mOrientations;
+
+        /// Inverse mass of the bodies during the substep
+        decimal* mInverseMasses;
+
+        /// World inverse inertia tensor of the bodies at the beginning of the substep
+        Matrix3x3* mInverseInertiaTensors;
+
+        /// Time step of the current substep
+        decimal mTimeStep;
+
+#ifdef IS_PROFILING_ACTIVE
+
+        /// Pointer to the profiler
+        Profiler* mProfiler;
+
+#endif
+
+        // -------------------- Methods -------------------- //
+
+        /// Return true if a body is not moved by the solver
+        static bool isBodyFixed(const RigidBody* body);
+
+        /// Return the generalized inverse mass of a body for a correction at a point along a direction
+        decimal computeGeneralizedInverseMass(uint indexBody, const Vector3& r, const Vector3& direction) const;
+
+        /// Apply a positional correction between two points of two bodies
+        void applyPositionalCorrection(uint indexBody1, uint indexBody2, const Vector3& r1, const Vector3& r2,
+                                       const Vector3& correction, decimal compliance, decimal& lambda);
+
+        /// Apply an angular correction between two bodies
+        void applyAngularCorrection(uint indexBody1, uint indexBody2, const Vector3& correction,
+                                    decimal compliance, decimal& lambda);
+
+        /// Apply an impulse at a point of two bodies
+        void applyImpulse(uint indexBody1, uint indexBody2, const Vector3& r1, const Vector3& r2,
+                          const Vector3& impulse);
+
+        /// Solve the position constraints of the contacts of an island
+        void solveContactsPositions(uint islandIndex);
+
+        /// Solve the velocities of the contacts of an island (restitution and dynamic friction)
+        void solveContactsVelocities(uint islandIndex, bool isFrictionApplied);
+
+        /// Solve the position constraints of a joint
+        void solveJointPositions(Joint* joint, uint indexBody1, uint indexBody2, decimal* lambdas);
+
+    public :
+
+        // -------------------- Methods -------------------- //
+
+        /// Constructor
+        PositionBasedSolver(MemoryManager& memoryManager, const WorldSettings& worldSettings,
+                            const MaterialTable& materialTable);
+
+        /// Destructor
+        ~PositionBasedSolver() = default;
+
+        /// Deleted copy-constructor
+        PositionBasedSolver(const PositionBasedSolver& solver) = delete;
+
+        /// Deleted assignment operator
+        PositionBasedSolver& operator=(const PositionBasedSolver& solver) = delete;
+
+        /// Allocate the contacts and the bodies arrays of the islands of the current step
+        void init(Island** islands, uint nbIslands, uint nbBodies);
+
+        /// Initialize the contacts and the joints of an island for the next substep
+        void initializeForIsland(uint islandIndex);
+
+        /// Solve the constraints of an island during a substep
+        void solveIsland(uint islandIndex, decimal timeStep);
+
+        /// Set the arrays of the velocities and of the positions of the bodies
+        void setBodiesArrays(Vector3* linearVelocities, Vector3* angularVelocities,
+                             Vector3* positions, Quaternion* orientations);
+
+#ifdef IS_PROFILING_ACTIVE
+
+        /// Set the profiler
+        void setProfiler(Profiler* profiler);
+
+#endif
+
+};
+
+// Set the arrays of the velocities and of the positions of the bodies
+inline void PositionBasedSolver::setBodiesArrays(Vector3* linearVelocities, Vector3* angularVelocities,
+                                                 Vector3* positions, Quaternion* orientations) {
+
+    assert(linearVelocities != nullptr);
+    assert(angularVelocities != nullptr);
+    assert(positions != nullptr);
+    assert(orientations != nullptr);
+
+    mLinearVelocities = linearVelocities;
+    mAngularVelocities = angularVelocities;
+    mPositions = positions;
+    mOrientations = orientations;
+}
+
+#ifdef IS_PROFILING_ACTIVE
+
+// Set the profiler
+inline void PositionBasedSolver::setProfiler(Profiler* profiler) {
+    mProfiler = profiler;
+}
+
+#endif
+
+}
+
+#endif
@@ -0,0 +1,244 @@
+/********************************************************************************
+* ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
+* Copyright (c) 2010-2018 Daniel Chappuis                                       *
+*********************************************************************************
+*                                                                               *
+* This software is provided 'as-is', without any express or implied warranty.   *
+* In no event will the authors be held liable for any damages arising from the  *
+* use of this software.                                                         *
+*                                                                               *
+* Permission is granted to anyone to use this software for any purpose,         *
+* including commercial applications, and to alter it and redistribute it        *
+* freely, subject to the following restrictions:                                *
+*                                                                               *
+* 1. The origin of this software must not be misrepresented; you must not claim *
+*    that you wrote the original software. If you use this software in a        *
+*    product, an acknowledgment in the product documentation would be           *
+*    appreciated but is not required.                                           *
+*                                                                               *
+* 2. Altered source versions must be plainly marked as such, and must not be    *
+*    misrepresented as being the original software.                             *
+*                                                                               *
+* 3. This notice may not be removed or altered from any source distribution.    *
+*                                                                               *
+********************************************************************************/
+
+// Libraries
+#include "RigidBodyStates.h"
+#include "memory/MemoryAllocator.h"
+#include "body/RigidBody.h"
+#include <cassert>
+
+// We want to use the ReactPhysics3D namespace
+using namespace reactphysics3d;
+
+// Constructor
+RigidBodyStates::RigidBodyStates(MemoryAllocator& allocator)
+                :mAllocator(allocator), mNbStates(0), mCapacity(0), mBodies(nullptr),
+                 mLinearVelocities(nullptr), mAngularVelocities(nullptr), mExternalForces(nullptr),
+                 mExternalTorques(nullptr), mCentersOfMassWorld(nullptr), mInertiaTensorsInverseWorld(nullptr),
+                 mSnapshotTransforms(nullptr), mSnapshotLinearVelocities(nullptr), mSnapshotAngularVelocities(nullptr),
+                 mPreviousTransforms(nullptr) {
+
+}
+
+// Destructor
+RigidBodyStates::~RigidBodyStates() {
+
+    assert(mNbStates == 0);
+
+    if (mCapacity > 0) {
+        mAllocator.release(mInertiaTensorsInverseWorld, computeSizeBytes(mCapacity));
+    }
+}
+
+// Reallocate the arrays with a larger capacity
+/// All the arrays are stored in a single memory block
+void RigidBodyStates::allocate(uint capacity) {
+
+    assert(capacity > mCapacity);
+
+    void* buffer = mAllocator.allocate(computeSizeBytes(capacity));
+
+    // The matrices are stored first and the pointers last to keep every array aligned
+    Matrix3x3* newInertiaTensorsInverseWorld = static_cast<Matrix3x3*>(buffer);
+    Vector3* newLinearVelocities = reinterpret_cast<Vector3*>(newInertiaTensorsInverseWorld + capacity);
+    Vector3* newAngularVelocities = newLinearVelocities + capacity;
+    Vector3* newExternalForces = newAngularVelocities + capacity;
+    Vector3* newExternalTorques = newExternalForces + capacity;
+    Vector3* newCentersOfMassWorld = newExternalTorques + capacity;
+    Vector3* newSnapshotLinearVelocities = newCentersOfMassWorld + capacity;
+    Vector3* newSnapshotAngularVelocities = newSnapshotLinearVelocities + capacity;
+    Transform* newSnapshotTransforms = reinterpret_cast<Transform*>(newSnapshotAngularVelocities + capacity);
+    Transform* newPreviousTransforms = newSnapshotTransforms + capacity;
+    RigidBody** newBodies = reinterpret_cast<RigidBody**>(newPreviousTransforms + capacity);
+
+    // Move the current states into the new arrays
+    for (uint i=0; i < mNbStates; i++) {
+        new (newInertiaTensorsInverseWorld + i) Matrix3x3(mInertiaTensorsInverseWorld[i]);
+        new (newLinearVelocities + i) Vector3(mLinearVelocities[i]);
+        new (newAngularVelocities + i) Vector3(mAngularVelocities[i]);
+        new (newExternalForces + i) Vector3(mExternalForces[i]);
+        new (newExternalTorques + i) Vector3(mExternalTorques[i]);
+        new (newCentersOfMassWorld + i) Vector3(mCentersOfMassWorld[i]);
+        new (newSnapshotLinearVelocities + i) Vector3(mSnapshotLinearVelocities[i]);
+        new (newSnapshotAngularVelocities + i) Vector3(mSnapshotAngularVelocities[i]);
+        new (newSnapshotTransforms + i) Transform(mSnapshotTransforms[i]);
+        new (newPreviousTransforms + i) Transform(mPreviousTransforms[i]);
+        newBodies[i] = mBodies[i];
+    }
+
+    // Release the previous arrays
+    if (mCapacity > 0) {
+        mAllocator.release(mInertiaTensorsInverseWorld, computeSizeBytes(mCapacity));
+    }
+
+    mInertiaTensorsInverseWorld = newInertiaTensorsInverseWorld;
+    mLinearVelocities = newLinearVelocities;
+    mAngularVelocities = newAngularVelocities;
+    mExternalForces = newExternalForces;
+    mExternalTorques = newExternalTorques;
+    mCentersOfMassWorld = newCentersOfMassWorld;
+    mSnapshotLinearVelocities = newSnapshotLinearVelocities;
+    mSnapshotAngularVelocities = newSnapshotAngularVelocities;
+    mSnapshotTransforms = newSnapshotTransforms;
+    mPreviousTransforms = newPreviousTransforms;
+    mBodies = newBodies;
+    mCapacity = capacity;
+}
+
+// Allocate the memory needed to store the states of a given number of bodies
+void RigidBodyStates::reserve(uint capacity) {
+
+    if (capacity > mCapacity) {
+        allocate(capacity);
+    }
+}
+
+// Add the state of a new body and return its index
+/**
+ * @param body Pointer to the new rigid body
+ * @param transform Initial transform of the body
+ * @return The index of the state of the body in the arrays
+ */
+uint RigidBodyStates::addBody(RigidBody* body, const Transform& transform) {
+
+    // If we need to allocate more memory for the states
+    if (mNbStates == mCapacity) {
+        allocate(mCapacity == 0 ? INITIAL_CAPACITY : mCapacity * 2);
+    }
+
+    const uint index = mNbStates;
+    new (mLinearVelocities + index) Vector3(0, 0, 0);
+    new (mAngularVelocities + index) Vector3(0, 0, 0);
+    new (mExternalForces + index) Vector3(0, 0, 0);
+    new (mExternalTorques + index) Vector3(0, 0, 0);
+    new (mCentersOfMassWorld + index) Vector3(transform.getPosition());
+    new (mInertiaTensorsInverseWorld + index) Matrix3x3();
+    new (mSnapshotLinearVelocities + index) Vector3(0, 0, 0);
+    new (mSnapshotAngularVelocities + index) Vector3(0, 0, 0);
+    new (mSnapshotTransforms + index) Transform(transform);
+    new (mPreviousTransforms + index) Transform(transform);
+    mBodies[index] = body;
+
+    mNbStates++;
+
+    return index;
+}
+
+// Remove the state of a body
+/// The state of the last body is moved into the slot of the removed body
+/**
+ * @param index Index of the state to remove
+ */
+void RigidBodyStates::removeBody(uint index) {
+
+    assert(index < mNbStates);
+
+    const uint lastIndex = mNbStates - 1;
+
+    if (index != lastIndex) {
+
+        // Move the last state into the slot of the removed one
+        moveState(lastIndex, index);
+
+        // Update the index of the moved body
+        mBodies[index]->mStateIndex = index;
+    }
+
+    mNbStates--;
+}
+
+// Move the states of the bodies into a new order
+/// The state at the index order[i] is moved at the index i. The permutation is applied in
+/// place by following its cycles: the state of the first slot of a cycle is kept aside and
+/// each other state of the cycle is moved once. The order array is modified by this method.
+/**
+ * @param order For each new index of a state, the current index of the state
+ */
+void RigidBodyStates::reorder(uint* order) {
+
+    for (uint start=0; start < mNbStates; start++) {
+
+        if (order[start] == start) continue;
+
+        // Keep the state of the first slot of the cycle
+        const Vector3 linearVelocity = mLinearVelocities[start];
+        const Vector3 angularVelocity = mAngularVelocities[start];
+        const Vector3 externalForce = mExternalForces[start];
+        const Vector3 externalTorque = mExternalTorques[start];
+        const Vector3 centerOfMassWorld = mCentersOfMassWorld[start];
+        const Matrix3x3 inertiaTensorInverseWorld = mInertiaTensorsInverseWorld[start];
+        const Vector3 snapshotLinearVelocity = mSnapshotLinearVelocities[start];
+        const Vector3 snapshotAngularVelocity = mSnapshotAngularVelocities[start];
+        const Transform snapshotTransform = mSnapshotTransforms[start];
+        const Transform previousTransform = mPreviousTransforms[start];
+        RigidBody* body = mBodies[start];
+
+        // Move the other states of the cycle
+        uint index = start;
+        while (order[index] != start) {
+            const uint nextIndex = order[index];
+            moveState(nextIndex, index);
+            order[index] = index;
+            index = nextIndex;
+        }
+
+        // The kept state goes into the last slot of the cycle
+        mLinearVelocities[index] = linearVelocity;
+        mAngularVelocities[index] = angularVelocity;
+        mExternalForces[index] = externalForce;
+        mExternalTorques[index] = externalTorque;
+        mCentersOfMassWorld[index] = centerOfMassWorld;
+        mInertiaTensorsInverseWorld[index] = inertiaTensorInverseWorld;
+        mSnapshotLinearVelocities[index] = snapshotLinearVelocity;
+        mSnapshotAngularVelocities[index] = snapshotAngularVelocity;
+        mSnapshotTransforms[index] = snapshotTransform;
+        mPreviousTransforms[index] = previousTransform;
+        mBodies[index] = body;
+        order[index] = index;
+    }
+
+    // Update the indices of the states in the bodies
+    for (uint i=0; i < mNbStates; i++) {
+        mBodies[i]->mStateIndex = i;
+    }
+}
+
+// Copy the current transform and velocities of all the bodies into the snapshot arrays
+void RigidBodyStates::takeSnapshot() {
+
+    for (uint i=0; i < mNbStates; i++) {
+        mSnapshotTransforms[i] = mBodies[i]->getTransform();
+        mSnapshotLinearVelocities[i] = mLinearVelocities[i];
+        mSnapshotAngularVelocities[i] = mAngularVelocities[i];
+    }
+}
+
+// Copy the current transform of all the bodies into the previous transforms array
+void RigidBodyStates::savePreviousTransforms() {
+
+    for (uint i=0; i < mNbStates; i++) {
+        mPreviousTransforms[i] = mBodies[i]->getTransform();
+    }
+}
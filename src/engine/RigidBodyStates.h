@@ -0,0 +1,200 @@
+/********************************************************************************
+* ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
+* Copyright (c) 2010-2018 Daniel Chappuis                                       *
+*********************************************************************************
+*                                                                               *
+* This software is provided 'as-is', without any express or implied warranty.   *
+* In no event will the authors be held liable for any damages arising from the  *
+* use of this software.                                                         *
+*                                                                               *
+* Permission is granted to anyone to use this software for any purpose,         *
+* including commercial applications, and to alter it and redistribute it        *
+* freely, subject to the following restrictions:                                *
+*                                                                               *
+* 1. The origin of this software must not be misrepresented; you must not claim *
+*    that you wrote the original software. If you use this software in a        *
+*    product, an acknowledgment in the product documentation would be           *
+*    appreciated but is not required.                                           *
+*                                                                               *
+* 2. Altered source versions must be plainly marked as such, and must not be    *
+*    misrepresented as being the original software.                             *
+*                                                                               *
+* 3. This notice may not be removed or altered from any source distribution.    *
+*                                                                               *
+********************************************************************************/
+
+#ifndef REACTPHYSICS3D_RIGID_BODY_STATES_H
+#define REACTPHYSICS3D_RIGID_BODY_STATES_H
+
+// Libraries
+#include "configuration.h"
+#include "mathematics/mathematics.h"
+
+/// ReactPhysics3D namespace
+namespace reactphysics3d {
+
+// Class declarations
+class MemoryAllocator;
+class RigidBody;
+
+// Class RigidBodyStates
+/**
+ * This class stores the dynamic state (velocities, external forces, center of
+ * mass and inverse inertia tensor in world-space) of all the rigid bodies of a
+ * world in contiguous arrays (structure of arrays). A rigid body only keeps the
+ * index of its state in those arrays. This way, the loops of the dynamics world
+ * that go through all the bodies stream through dense memory. When a body is
+ * removed, the state of the last body is moved into its slot so that the arrays
+ * always stay packed. The store also keeps a snapshot of the transform and
+ * velocities of the bodies that can be read while the world is being updated
+ * in a background thread.
+ */
+class RigidBodyStates {
+
+    private:
+
+        // -------------------- Constants -------------------- //
+
+        /// Number of states allocated the first time a body is added
+        static const uint INITIAL_CAPACITY = 16;
+
+        // -------------------- Attributes -------------------- //
+
+        /// Memory allocator
+        MemoryAllocator& mAllocator;
+
+        /// Number of states in the arrays
+        uint mNbStates;
+
+        /// Number of states that can be stored before the arrays need to grow
+        uint mCapacity;
+
+        /// Rigid body of each state
+        RigidBody** mBodies;
+
+        /// Linear velocity of each body
+        Vector3* mLinearVelocities;
+
+        /// Angular velocity of each body
+        Vector3* mAngularVelocities;
+
+        /// Current external force of each body
+        Vector3* mExternalForces;
+
+        /// Current external torque of each body
+        Vector3* mExternalTorques;
+
+        /// Center of mass of each body in world-space coordinates
+        Vector3* mCentersOfMassWorld;
+
+        /// Inverse of the inertia tensor of each body in world-space coordinates
+        Matrix3x3* mInertiaTensorsInverseWorld;
+
+        /// Transform of each body when the last snapshot has been taken
+        Transform* mSnapshotTransforms;
+
+        /// Linear velocity of each body when the last snapshot has been taken
+        Vector3* mSnapshotLinearVelocities;
+
+        /// Angular velocity of each body when the last snapshot has been taken
+        Vector3* mSnapshotAngularVelocities;
+
+        /// Transform of each body at the beginning of the last step (only updated if the
+        /// interpolation of the transforms is enabled in the world settings)
+        Transform* mPreviousTransforms;
+
+        // -------------------- Methods -------------------- //
+
+        /// Return the number of bytes needed to store the states of a given number of bodies
+        static size_t computeSizeBytes(uint capacity);
+
+        /// Reallocate the arrays with a larger capacity
+        void allocate(uint capacity);
+
+        /// Copy the state at an index into the slot of another index
+        void moveState(uint fromIndex, uint toIndex);
+
+    public:
+
+        // -------------------- Methods -------------------- //
+
+        /// Constructor
+        RigidBodyStates(MemoryAllocator& allocator);
+
+        /// Destructor
+        ~RigidBodyStates();
+
+        /// Deleted copy-constructor
+        RigidBodyStates(const RigidBodyStates& states) = delete;
+
+        /// Deleted assignment operator
+        RigidBodyStates& operator=(const RigidBodyStates& states) = delete;
+
+        /// Add the state of a new body and return its index
+        uint addBody(RigidBody* body, const Transform& transform);
+
+        /// Allocate the memory needed to store the states of a given number of bodies
+        void reserve(uint capacity);
+
+        /// Remove the state of a body
+        void removeBody(uint index);
+
+        /// Return the number of states in the arrays
+        uint getNbStates() const;
+
+        /// Move the states of the bodies into a new order
+        void reorder(uint* order);
+
+        /// Reset the external force and torque of all the bodies
+        void resetForcesAndTorques();
+
+        /// Copy the current transform and velocities of all the bodies into the snapshot arrays
+        void takeSnapshot();
+
+        /// Copy the current transform of all the bodies into the previous transforms array
+        void savePreviousTransforms();
+
+        // -------------------- Friendship -------------------- //
+
+        friend class RigidBody;
+        friend class DynamicsWorld;
+};
+
+// Return the number of states in the arrays
+inline uint RigidBodyStates::getNbStates() const {
+    return mNbStates;
+}
+
+// Return the number of bytes needed to store the states of a given number of bodies
+inline size_t RigidBodyStates::computeSizeBytes(uint capacity) {
+    return capacity * (sizeof(Matrix3x3) + 2 * sizeof(Transform) + 8 * sizeof(Vector3) + sizeof(RigidBody*));
+}
+
+// Copy the state at an index into the slot of another index
+inline void RigidBodyStates::moveState(uint fromIndex, uint toIndex) {
+
+    mLinearVelocities[toIndex] = mLinearVelocities[fromIndex];
+    mAngularVelocities[toIndex] = mAngularVelocities[fromIndex];
+    mExternalForces[toIndex] = mExternalForces[fromIndex];
+    mExternalTorques[toIndex] = mExternalTorques[fromIndex];
+    mCentersOfMassWorld[toIndex] = mCentersOfMassWorld[fromIndex];
+    mInertiaTensorsInverseWorld[toIndex] = mInertiaTensorsInverseWorld[fromIndex];
+    mSnapshotLinearVelocities[toIndex] = mSnapshotLinearVelocities[fromIndex];
+    mSnapshotAngularVelocities[toIndex] = mSnapshotAngularVelocities[fromIndex];
+    mSnapshotTransforms[toIndex] = mSnapshotTransforms[fromIndex];
+    mPreviousTransforms[toIndex] = mPreviousTransforms[fromIndex];
+    mBodies[toIndex] = mBodies[fromIndex];
+}
+
+// Reset the external force and torque of all the bodies
+inline void RigidBodyStates::resetForcesAndTorques() {
+
+    for (uint i=0; i < mNbStates; i++) {
+        mExternalForces[i].setToZero();
+        mExternalTorques[i].setToZero();
+    }
+}
+
+}
+
+#endif
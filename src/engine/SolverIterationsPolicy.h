@@ -0,0 +1,103 @@
+/********************************************************************************
+* ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
+* Copyright (c) 2010-2018 Daniel Chappuis                                       *
+*********************************************************************************
+*                                                                               *
+* This software is provided 'as-is', without any express or implied warranty.   *
+* In no event will the authors be held liable for any damages arising from the  *
+* use of this software.                                                         *
+*                                                                               *
+* Permission is granted to anyone to use this software for any purpose,         *
+* including commercial applications, and to alter it and redistribute it        *
+* freely, subject to the following restrictions:                                *
+*                                                                               *
+* 1. The origin of this software must not be misrepresented; you must not claim *
+*    that you wrote the original software. If you use this software in a        *
+*    product, an acknowledgment in the product documentation would be           *
+*    appreciated but is not required.                                           *
+*                                                                               *
+* 2. Altered source versions must be plainly marked as such, and must not be    *
+*    misrepresented as being the original software.                             *
+*                                                                               *
+* 3. This notice may not be removed or altered from any source distribution.    *
+*                                                                               *
+********************************************************************************/
+
+#ifndef REACTPHYSICS3D_SOLVER_ITERATIONS_POLICY_H
+#define REACTPHYSICS3D_SOLVER_ITERATIONS_POLICY_H
+
+// Libraries
+#include "configuration.h"
+
+namespace reactphysics3d {
+
+// Structure IslandSolverInfo
+/**
+ * This structure contains the information about an island that is given to a
+ * SolverIterationsPolicy to choose the number of solver iterations of the island.
+ */
+struct IslandSolverInfo {
+
+    /// Index of the island in the islands of the current step
+    uint islandIndex;
+
+    /// Number of bodies of the island (including the static and kinematic ones)
+    uint nbBodies;
+
+    /// Number of contact manifolds of the island
+    uint nbContactManifolds;
+
+    /// Number of contact points of the island
+    uint nbContactPoints;
+
+    /// Number of joints of the island
+    uint nbJoints;
+
+    /// Ratio between the largest and the smallest mass of the dynamic bodies of the island
+    decimal maxMassRatio;
+
+    /// Simulation level of detail of the island (it is simulated every 2^L steps)
+    uint simulationLevelOfDetail;
+};
+
+// Class SolverIterationsPolicy
+/**
+ * This class can be used to choose the number of iterations of the velocity and position
+ * solvers of each island. For instance, tall stacks of bodies or large mass ratios can
+ * get more iterations than some small debris. In order to use it, you need to create a
+ * new class that inherits from this one and register it in the physics world using the
+ * DynamicsWorld::setSolverIterationsPolicy() method. At each step, the beginStep() method
+ * is called and then computeNbIterations() is called for each island, in order and on
+ * the thread that updates the world, so that a policy can share an iterations budget
+ * between the islands of a step.
+ */
+class SolverIterationsPolicy {
+
+    public :
+
+        /// Constructor
+        SolverIterationsPolicy() = default;
+
+        /// Destructor
+        virtual ~SolverIterationsPolicy() = default;
+
+        /// Called at the beginning of each step before the iterations of the islands are chosen
+        virtual void beginStep() {}
+
+        /// Choose the number of solver iterations of an island
+        /**
+         * @param islandInfo Information about the island
+         * @param nbVelocityIterations Number of iterations of the velocity solver of the island.
+         *                             It is initialized with the number of iterations of the world
+         *                             divided by 2^L for the simulation level of detail L.
+         * @param nbPositionIterations Number of iterations of the position solver of the island.
+         *                             It is initialized with the number of iterations of the world
+         *                             divided by 2^L for the simulation level of detail L.
+         */
+        virtual void computeNbIterations(const IslandSolverInfo& islandInfo, uint& nbVelocityIterations,
+                                         uint& nbPositionIterations)=0;
+};
+
+}
+
+#endif
@@ -0,0 +1,75 @@
+/********************************************************************************
+* ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
+* Copyright (c) 2010-2018 Daniel Chappuis                                       *
+*********************************************************************************
+*                                                                               *
+* This software is provided 'as-is', without any express or implied warranty.   *
+* In no event will the authors be held liable for any damages arising from the  *
+* use of this software.                                                         *
+*                                                                               *
+* Permission is granted to anyone to use this software for any purpose,         *
+* including commercial applications, and to alter it and redistribute it        *
+* freely, subject to the following restrictions:                                *
+*                                                                               *
+* 1. The origin of this software must not be misrepresented; you must not claim *
+*    that you wrote the original software. If you use this software in a        *
+*    product, an acknowledgment in the product documentation would be           *
+*    appreciated but is not required.                                           *
+*                                                                               *
+* 2. Altered source versions must be plainly marked as such, and must not be    *
+*    misrepresented as being the original software.                             *
+*                                                                               *
+* 3. This notice may not be removed or altered from any source distribution.    *
+*                                                                               *
+********************************************************************************/
+
+// Libraries
+#include "TaskScheduler.h"
+#include <algorithm>
+#include <cassert>
+
+using namespace reactphysics3d;
+
+// Execute a function for ranges of items in parallel
+/// This is useful when the work of a single item is too small to be worth a task.
+/**
+ * @param nbItems Number of items
+ * @param minNbItemsPerTask Minimum number of items of a range (except for the last one)
+ * @param function Function to execute for each range of items
+ */
+void TaskScheduler::parallelForRange(uint nbItems, uint minNbItemsPerTask, const RangeFunction& function) {
+
+    assert(minNbItemsPerTask > 0);
+
+    if (nbItems == 0) return;
+
+    const uint nbTasks = std::min(getNbWorkers(), (nbItems + minNbItemsPerTask - 1) / minNbItemsPerTask);
+
+    parallelFor(nbTasks, [nbItems, nbTasks, &function](uint taskIndex) {
+        const uint begin = static_cast<uint>((static_cast<luint>(nbItems) * taskIndex) / nbTasks);
+        const uint end = static_cast<uint>((static_cast<luint>(nbItems) * (taskIndex + 1)) / nbTasks);
+        function(begin, end);
+    });
+}
+
+// Start to execute a function in the background once its predecessor jobs are finished
+/**
+ * @param function Function to execute
+ * @param predecessorJobIds Array with the identifiers of the jobs that must be finished first
+ * @param nbPredecessorJobs Number of predecessor jobs in the array
+ * @return The identifier of the job to give to waitJob()
+ */
+luint TaskScheduler::startJob(const JobFunction& function, const luint* predecessorJobIds, uint nbPredecessorJobs) {
+
+    function();
+
+    return 0;
+}
+
+// Wait until a job started with startJob() is finished
+/**
+ * @param jobId Identifier returned by startJob()
+ */
+void TaskScheduler::waitJob(luint jobId) {
+
+}
@@ -0,0 +1,98 @@
+/********************************************************************************
+* ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
+* Copyright (c) 2010-2018 Daniel Chappuis                                       *
+*********************************************************************************
+*                                                                               *
+* This software is provided 'as-is', without any express or implied warranty.   *
+* In no event will the authors be held liable for any damages arising from the  *
+* use of this software.                                                         *
+*                                                                               *
+* Permission is granted to anyone to use this software for any purpose,         *
+* including commercial applications, and to alter it and redistribute it        *
+* freely, subject to the following restrictions:                                *
+*                                                                               *
+* 1. The origin of this software must not be misrepresented; you must not claim *
+*    that you wrote the original software. If you use this software in a        *
+*    product, an acknowledgment in the product documentation would be           *
+*    appreciated but is not required.                                           *
+*                                                                               *
+* 2. Altered source versions must be plainly marked as such, and must not be    *
+*    misrepresented as being the original software.                             *
+*                                                                               *
+* 3. This notice may not be removed or altered from any source distribution.    *
+*                                                                               *
+********************************************************************************/
+
+#ifndef REACTPHYSICS3D_TASK_SCHEDULER_H
+#define REACTPHYSICS3D_TASK_SCHEDULER_H
+
+// Libraries
+#include "configuration.h"
+#include <functional>
+
+/// ReactPhysics3D namespace
+namespace reactphysics3d {
+
+// Class TaskScheduler
+/**
+ * Abstract class with the basic interface of a task scheduler. A task scheduler
+ * is used by the engine to execute independent pieces of work (for instance the
+ * simulation of the different islands of a dynamics world) in parallel. All the
+ * parallel work of the engine is submitted through this interface and the engine
+ * never creates threads by itself. The user can implement this interface to run
+ * the engine tasks on their own job system or use the DefaultTaskScheduler class.
+ * A scheduler can be shared by several worlds.
+ */
+class TaskScheduler {
+
+    public:
+
+        /// Function executed by a task with the index of the task as parameter
+        using TaskFunction = std::function<void(uint taskIndex)>;
+
+        /// Function executed by a task with a range [begin, end) of items as parameter
+        using RangeFunction = std::function<void(uint begin, uint end)>;
+
+        /// Function executed by a background job
+        using JobFunction = std::function<void()>;
+
+        /// Constructor
+        TaskScheduler() = default;
+
+        /// Destructor
+        virtual ~TaskScheduler() = default;
+
+        /// Deleted copy-constructor
+        TaskScheduler(const TaskScheduler& scheduler) = delete;
+
+        /// Deleted assignment operator
+        TaskScheduler& operator=(const TaskScheduler& scheduler) = delete;
+
+        /// Return the maximum number of tasks that can be executed at the same time
+        virtual uint getNbWorkers() const=0;
+
+        /// Execute the function for each task index in [0, nbTasks) and return when all
+        /// the tasks are finished. The tasks can be executed in any order.
+        virtual void parallelFor(uint nbTasks, const TaskFunction& function)=0;
+
+        /// Split the items [0, nbItems) into at most one range per worker (with at least
+        /// minNbItemsPerTask items per range) and execute the function for each range
+        void parallelForRange(uint nbItems, uint minNbItemsPerTask, const RangeFunction& function);
+
+        /// Start to execute a function in the background once the jobs with the given
+        /// identifiers (its predecessors) are finished and return an identifier of the job
+        /// that must be given to waitJob() or used as a predecessor of other jobs. The function
+        /// can call parallelFor(). The default implementation executes the function immediately
+        /// on the calling thread (its predecessors are then already finished). It can be
+        /// overridden to run the job on a thread of a job system.
+        virtual luint startJob(const JobFunction& function, const luint* predecessorJobIds = nullptr,
+                               uint nbPredecessorJobs = 0);
+
+        /// Wait until a job started with startJob() is finished. The default
+        /// implementation does nothing.
+        virtual void waitJob(luint jobId);
+};
+
+}
+
+#endif
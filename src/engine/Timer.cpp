@@ -35,27 +35,8 @@ Timer::Timer(double timeStep) : mTimeStep(timeStep), mLastUpdateTime(0), mDeltaT
 }
 
 // Return the current time of the system in seconds
+/// The time is given by a monotonic clock and therefore does not jump when the
+/// system time is changed.
 long double Timer::getCurrentSystemTime() {
-
-    #if defined(WINDOWS_OS)
-        LARGE_INTEGER ticksPerSecond;
-        LARGE_INTEGER ticks;
-        QueryPerformanceFrequency(&ticksPerSecond);
-        QueryPerformanceCounter(&ticks);
-        return ((long double)(ticks.QuadPart) / (long double)(ticksPerSecond.QuadPart));
-    #else
-        // Initialize the lastUpdateTime with the current time in seconds
-        timeval timeValue;
-        gettimeofday(&timeValue, nullptr);
-        return (timeValue.tv_sec + (timeValue.tv_usec / 1000000.0));
-    #endif
+    return static_cast<long double>(getCurrentTicks()) * 1.0e-9L;
 }
-
-
-
-
-
-
-
-
-
@@ -29,6 +29,7 @@
 // Libraries
 #include <ctime>
 #include <cassert>
+#include <chrono>
 #include "configuration.h"
 
 #if defined(WINDOWS_OS)   // For Windows platform
@@ -117,6 +118,9 @@ class Timer {
 
         /// Return the current time of the system in seconds
         static long double getCurrentSystemTime();
+
+        /// Return the current value of the monotonic clock in nanoseconds
+        static uint64 getCurrentTicks();
 };
 
 // Return the timestep of the physics engine
@@ -191,6 +195,15 @@ inline void Timer::update() {
     mAccumulator += mDeltaTime;
 }
 
+// Return the current value of the monotonic clock in nanoseconds
+/// The clock is steady (it never goes backward when the system time is changed) and
+/// has the best resolution available on the platform. Its origin is arbitrary and it
+/// should only be used to measure durations.
+inline uint64 Timer::getCurrentTicks() {
+    return static_cast<uint64>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
 }
 
  #endif
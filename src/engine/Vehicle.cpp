@@ -0,0 +1,209 @@
+/********************************************************************************
+* ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
+* Copyright (c) 2010-2018 Daniel Chappuis                                       *
+*********************************************************************************
+*                                                                               *
+* This software is provided 'as-is', without any express or implied warranty.   *
+* In no event will the authors be held liable for any damages arising from the  *
+* use of this software.                                                         *
+*                                                                               *
+* Permission is granted to anyone to use this software for any purpose,         *
+* including commercial applications, and to alter it and redistribute it        *
+* freely, subject to the following restrictions:                                *
+*                                                                               *
+* 1. The origin of this software must not be misrepresented; you must not claim *
+*    that you wrote the original software. If you use this software in a        *
+*    product, an acknowledgment in the product documentation would be           *
+*    appreciated but is not required.                                           *
+*                                                                               *
+* 2. Altered source versions must be plainly marked as such, and must not be    *
+*    misrepresented as being the original software.                             *
+*                                                                               *
+* 3. This notice may not be removed or altered from any source distribution.    *
+*                                                                               *
+********************************************************************************/
+
+// Libraries
+#include "Vehicle.h"
+#include "body/RigidBody.h"
+#include "collision/RaycastInfo.h"
+#include "memory/MemoryManager.h"
+#include <cmath>
+
+using namespace reactphysics3d;
+
+// Return the rotation of a given angle around a unit axis
+static Quaternion computeAxisRotation(const Vector3& axis, decimal angle) {
+    return Quaternion(axis * std::sin(decimal(0.5) * angle), std::cos(decimal(0.5) * angle));
+}
+
+// Constructor
+/**
+ * @param chassis The rigid body of the chassis
+ * @param settings The settings of the vehicle
+ * @param memoryManager The memory manager of the world of the vehicle
+ */
+Vehicle::Vehicle(RigidBody* chassis, const VehicleSettings& settings, MemoryManager& memoryManager)
+        : mSettings(settings), mChassis(chassis), mWheels(memoryManager.getPoolAllocator(MemoryTag::Containers)),
+          mIslandIndex(NO_ISLAND) {
+
+    assert(chassis != nullptr);
+    assert(approxEqual(settings.upAxis.lengthSquare(), decimal(1.0)));
+    assert(approxEqual(settings.forwardAxis.lengthSquare(), decimal(1.0)));
+    assert(std::abs(settings.upAxis.dot(settings.forwardAxis)) < decimal(0.001));
+}
+
+// Add a wheel to the vehicle and return its index
+/**
+ * @param settings The settings of the wheel
+ * @return The index of the new wheel
+ */
+uint Vehicle::addWheel(const WheelSettings& settings) {
+
+    assert(settings.radius > decimal(0.0));
+    assert(settings.suspensionRestLength >= decimal(0.0));
+    assert(settings.suspensionFrequency > decimal(0.0));
+
+    Wheel wheel;
+    wheel.settings = settings;
+    wheel.suspensionLength = settings.suspensionRestLength;
+    mWheels.add(wheel);
+
+    return mWheels.size() - 1;
+}
+
+// Set the steering angle of a wheel
+/**
+ * @param index Index of the wheel
+ * @param angle The angle of the wheel around the up axis of the chassis (in radians)
+ */
+void Vehicle::setSteeringAngle(uint index, decimal angle) {
+    assert(index < mWheels.size());
+    if (angle != mWheels[index].steeringAngle) mChassis->setIsSleeping(false);
+    mWheels[index].steeringAngle = angle;
+}
+
+// Set the force applied by the engine to a wheel
+/// The force is applied at the contact point of the wheel along its forward axis (a
+/// negative force drives the vehicle backward). It is limited by the friction of the tire.
+/**
+ * @param index Index of the wheel
+ * @param force The engine force (in Newtons)
+ */
+void Vehicle::setEngineForce(uint index, decimal force) {
+    assert(index < mWheels.size());
+    if (force != decimal(0.0)) mChassis->setIsSleeping(false);
+    mWheels[index].engineForce = force;
+}
+
+// Set the largest force applied by the brake of a wheel
+/// The brake opposes the rolling of the wheel with a force up to this value (it is
+/// limited by the friction of the tire).
+/**
+ * @param index Index of the wheel
+ * @param force The brake force (in Newtons)
+ */
+void Vehicle::setBrakeForce(uint index, decimal force) {
+    assert(index < mWheels.size());
+    assert(force >= decimal(0.0));
+    if (force != decimal(0.0)) mChassis->setIsSleeping(false);
+    mWheels[index].brakeForce = force;
+}
+
+// Return the transform of a wheel (in world-space)
+/// The center of the wheel is at the end of its suspension. The wheel is rotated around the
+/// up axis of the chassis by its steering angle and around its axle by its rotation angle.
+/**
+ * @param index Index of the wheel
+ * @return The transform of the wheel
+ */
+Transform Vehicle::getWheelTransform(uint index) const {
+
+    assert(index < mWheels.size());
+    const Wheel& wheel = mWheels[index];
+    const Transform& chassisTransform = mChassis->getTransform();
+
+    const Vector3 center = chassisTransform * (wheel.settings.connectionPoint - mSettings.upAxis * wheel.suspensionLength);
+    const Vector3 axle = mSettings.upAxis.cross(mSettings.forwardAxis);
+    const Quaternion orientation = chassisTransform.getOrientation() *
+                                   computeAxisRotation(mSettings.upAxis, wheel.steeringAngle) *
+                                   computeAxisRotation(axle, wheel.rotationAngle);
+
+    return Transform(center, orientation);
+}
+
+// Return the speed of the chassis along its forward axis
+/**
+ * @return The speed of the chassis (negative if the vehicle moves backward)
+ */
+decimal Vehicle::getForwardSpeed() const {
+    return mChassis->getLinearVelocity().dot(mChassis->getTransform().getOrientation() * mSettings.forwardAxis);
+}
+
+// Return the ray of the suspension of a wheel
+/// The ray goes from the connection point of the wheel along the down axis of the chassis
+/// and its length is the rest length of the suspension plus the radius of the wheel.
+Ray Vehicle::computeWheelRay(uint index) const {
+
+    const WheelSettings& settings = mWheels[index].settings;
+    const Transform& chassisTransform = mChassis->getTransform();
+
+    const Vector3 start = chassisTransform * settings.connectionPoint;
+    const Vector3 down = chassisTransform.getOrientation() * (-mSettings.upAxis);
+
+    return Ray(start, start + down * (settings.suspensionRestLength + settings.radius));
+}
+
+// Update the contact of a wheel with the closest hit of its ray
+/// The impulses of a wheel that does not touch the ground anymore are reset so that
+/// they are not used to warm start the solver when it touches the ground again.
+void Vehicle::updateWheelContact(uint index, const RaycastHit& hit) {
+
+    Wheel& wheel = mWheels[index];
+
+    if (hit.isHit()) {
+        wheel.isInContact = true;
+        wheel.contactPoint = hit.worldPoint;
+        wheel.contactNormal = hit.worldNormal;
+        wheel.groundBody = hit.body;
+        wheel.suspensionLength = hit.hitFraction * (wheel.settings.suspensionRestLength + wheel.settings.radius) -
+                                 wheel.settings.radius;
+        return;
+    }
+
+    wheel.isInContact = false;
+    wheel.groundBody = nullptr;
+    wheel.suspensionLength = wheel.settings.suspensionRestLength;
+    wheel.suspensionForce = decimal(0.0);
+    wheel.suspensionImpulse = decimal(0.0);
+    wheel.forwardImpulse = decimal(0.0);
+    wheel.sideImpulse = decimal(0.0);
+}
+
+// Return the forward axis of a wheel (in world-space)
+Vector3 Vehicle::computeWheelForwardAxis(uint index) const {
+    const Vector3 localForward = computeAxisRotation(mSettings.upAxis, mWheels[index].steeringAngle) * mSettings.forwardAxis;
+    return mChassis->getTransform().getOrientation() * localForward;
+}
+
+// Rotate the wheels around their axle from the velocity of the chassis
+/// A wheel rolls without slipping at the velocity of the chassis at its connection point.
+/**
+ * @param timeStep The time step of the last step (in seconds)
+ */
+void Vehicle::updateWheelsRotation(decimal timeStep) {
+
+    const Vector3 linearVelocity = mChassis->getLinearVelocity();
+    const Vector3 angularVelocity = mChassis->getAngularVelocity();
+    const Vector3& centerOfMass = mChassis->getCenterOfMassWorld();
+
+    for (uint i=0; i < mWheels.size(); i++) {
+
+        Wheel& wheel = mWheels[i];
+        const Vector3 connectionPoint = mChassis->getTransform() * wheel.settings.connectionPoint;
+        const Vector3 velocity = linearVelocity + angularVelocity.cross(connectionPoint - centerOfMass);
+
+        wheel.rotationAngle += velocity.dot(computeWheelForwardAxis(i)) / wheel.settings.radius * timeStep;
+        wheel.rotationAngle = std::fmod(wheel.rotationAngle, PI_TIMES_2);
+    }
+}
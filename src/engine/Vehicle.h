@@ -0,0 +1,399 @@
+/********************************************************************************
+* ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
+* Copyright (c) 2010-2018 Daniel Chappuis                                       *
+*********************************************************************************
+*                                                                               *
+* This software is provided 'as-is', without any express or implied warranty.   *
+* In no event will the authors be held liable for any damages arising from the  *
+* use of this software.                                                         *
+*                                                                               *
+* Permission is granted to anyone to use this software for any purpose,         *
+* including commercial applications, and to alter it and redistribute it        *
+* freely, subject to the following restrictions:                                *
+*                                                                               *
+* 1. The origin of this software must not be misrepresented; you must not claim *
+*    that you wrote the original software. If you use this software in a        *
+*    product, an acknowledgment in the product documentation would be           *
+*    appreciated but is not required.                                           *
+*                                                                               *
+* 2. Altered source versions must be plainly marked as such, and must not be    *
+*    misrepresented as being the original software.                             *
+*                                                                               *
+* 3. This notice may not be removed or altered from any source distribution.    *
+*                                                                               *
+********************************************************************************/
+
+#ifndef REACTPHYSICS3D_VEHICLE_H
+#define REACTPHYSICS3D_VEHICLE_H
+
+// Libraries
+#include "configuration.h"
+#include "mathematics/mathematics.h"
+#include "containers/List.h"
+
+/// ReactPhysics3D namespace
+namespace reactphysics3d {
+
+// Class declarations
+class RigidBody;
+class CollisionBody;
+class MemoryManager;
+struct RaycastHit;
+
+// Structure WheelSettings
+/**
+ * This structure contains the settings of a wheel of a vehicle. The suspension of the
+ * wheel is a spring between its connection point on the chassis and the center of the
+ * wheel along the down axis of the chassis.
+ */
+struct WheelSettings {
+
+    /// Point of the chassis where the suspension is attached (in local-space of the chassis)
+    Vector3 connectionPoint = Vector3(0, 0, 0);
+
+    /// Radius of the wheel (in meters)
+    decimal radius = decimal(0.4);
+
+    /// Length of the suspension when it is not compressed (in meters)
+    decimal suspensionRestLength = decimal(0.4);
+
+    /// Frequency of the spring of the suspension (in Hertz)
+    decimal suspensionFrequency = decimal(2.0);
+
+    /// Damping ratio of the spring of the suspension (one for a critical damping)
+    decimal suspensionDampingRatio = decimal(0.5);
+
+    /// Largest force applied by the suspension (in Newtons)
+    decimal maxSuspensionForce = decimal(100000.0);
+
+    /// Friction coefficient between the tire and the ground
+    decimal frictionCoefficient = decimal(1.0);
+};
+
+// Structure VehicleSettings
+/**
+ * This structure contains the settings of a vehicle.
+ */
+struct VehicleSettings {
+
+    /// Up axis of the chassis (in local-space of the chassis)
+    Vector3 upAxis = Vector3(0, 1, 0);
+
+    /// Forward axis of the chassis (in local-space of the chassis)
+    Vector3 forwardAxis = Vector3(0, 0, 1);
+
+    /// Bits mask of the collision categories of the proxy shapes that the wheels touch
+    collisionmask wheelsCollideWithMaskBits = ALL_COLLISION_CATEGORIES;
+};
+
+// Class Vehicle
+/**
+ * This class represents a raycast vehicle: a rigid body (the chassis) on wheels that are
+ * not simulated as bodies. Each wheel is a ray cast from its connection point along the
+ * down axis of the chassis. The rays of all the wheels of the vehicles of a dynamics world
+ * are cast with a single batched query after the narrow-phase of each step. The suspension
+ * and the friction of the tires are then solved by the contact solver together with the
+ * contacts of the island of the chassis (the engine and brake forces are applied through
+ * the bounds of the longitudinal friction of the tires). The ground is not pushed by the
+ * wheels. A ray that starts inside a convex proxy shape does not hit it, therefore the
+ * connection points should be inside the shapes of the chassis (otherwise the categories
+ * of the chassis must be excluded from the wheels collision mask).
+ */
+class Vehicle {
+
+    private:
+
+        // Structure Wheel
+        /**
+         * Settings, controls and state of a wheel.
+         */
+        struct Wheel {
+
+            /// Settings of the wheel
+            WheelSettings settings;
+
+            /// Angle of the wheel around the up axis of the chassis (in radians)
+            decimal steeringAngle = decimal(0.0);
+
+            /// Force applied by the engine along the forward axis of the wheel
+            decimal engineForce = decimal(0.0);
+
+            /// Largest force applied by the brake
+            decimal brakeForce = decimal(0.0);
+
+            /// True if the wheel touches the ground
+            bool isInContact = false;
+
+            /// Contact point on the ground (in world-space)
+            Vector3 contactPoint;
+
+            /// Normal of the ground at the contact point (in world-space)
+            Vector3 contactNormal;
+
+            /// Body of the ground (null if the wheel does not touch the ground)
+            CollisionBody* groundBody = nullptr;
+
+            /// Current length of the suspension
+            decimal suspensionLength;
+
+            /// Force applied by the suspension during the last step
+            decimal suspensionForce = decimal(0.0);
+
+            /// Accumulated impulse of the suspension (for warm starting)
+            decimal suspensionImpulse = decimal(0.0);
+
+            /// Accumulated impulse of the longitudinal friction (for warm starting)
+            decimal forwardImpulse = decimal(0.0);
+
+            /// Accumulated impulse of the lateral friction (for warm starting)
+            decimal sideImpulse = decimal(0.0);
+
+            /// Rotation angle of the wheel around its axle (in radians)
+            decimal rotationAngle = decimal(0.0);
+        };
+
+        // -------------------- Attributes -------------------- //
+
+        /// Settings of the vehicle
+        VehicleSettings mSettings;
+
+        /// Chassis of the vehicle
+        RigidBody* mChassis;
+
+        /// Wheels of the vehicle
+        List<Wheel> mWheels;
+
+        /// Index of the island of the chassis in the islands solved by the contact
+        /// solver (NO_ISLAND if the chassis is not simulated)
+        uint mIslandIndex;
+
+        // -------------------- Methods -------------------- //
+
+        /// Return the ray of the suspension of a wheel
+        Ray computeWheelRay(uint index) const;
+
+        /// Update the contact of a wheel with the closest hit of its ray
+        void updateWheelContact(uint index, const RaycastHit& hit);
+
+        /// Return the forward axis of a wheel (in world-space)
+        Vector3 computeWheelForwardAxis(uint index) const;
+
+        /// Rotate the wheels around their axle from the velocity of the chassis
+        void updateWheelsRotation(decimal timeStep);
+
+    public:
+
+        // -------------------- Constants -------------------- //
+
+        /// Island index of a vehicle whose chassis is not simulated
+        static const uint NO_ISLAND = ~uint(0);
+
+        // -------------------- Methods -------------------- //
+
+        /// Constructor
+        Vehicle(RigidBody* chassis, const VehicleSettings& settings, MemoryManager& memoryManager);
+
+        /// Destructor
+        ~Vehicle() = default;
+
+        /// Deleted copy-constructor
+        Vehicle(const Vehicle& vehicle) = delete;
+
+        /// Deleted assignment operator
+        Vehicle& operator=(const Vehicle& vehicle) = delete;
+
+        /// Add a wheel to the vehicle and return its index
+        uint addWheel(const WheelSettings& settings);
+
+        /// Return the number of wheels
+        uint getNbWheels() const;
+
+        /// Return the chassis of the vehicle
+        RigidBody* getChassis() const;
+
+        /// Return the settings of the vehicle
+        const VehicleSettings& getSettings() const;
+
+        /// Return the settings of a wheel
+        const WheelSettings& getWheelSettings(uint index) const;
+
+        /// Set the steering angle of a wheel
+        void setSteeringAngle(uint index, decimal angle);
+
+        /// Return the steering angle of a wheel
+        decimal getSteeringAngle(uint index) const;
+
+        /// Set the force applied by the engine to a wheel
+        void setEngineForce(uint index, decimal force);
+
+        /// Return the force applied by the engine to a wheel
+        decimal getEngineForce(uint index) const;
+
+        /// Set the largest force applied by the brake of a wheel
+        void setBrakeForce(uint index, decimal force);
+
+        /// Return the largest force applied by the brake of a wheel
+        decimal getBrakeForce(uint index) const;
+
+        /// Return true if a wheel touches the ground
+        bool isWheelInContact(uint index) const;
+
+        /// Return the contact point of a wheel on the ground
+        const Vector3& getWheelContactPoint(uint index) const;
+
+        /// Return the normal of the ground under a wheel
+        const Vector3& getWheelContactNormal(uint index) const;
+
+        /// Return the body of the ground under a wheel
+        CollisionBody* getWheelGroundBody(uint index) const;
+
+        /// Return the current length of the suspension of a wheel
+        decimal getSuspensionLength(uint index) const;
+
+        /// Return the force applied by the suspension of a wheel during the last step
+        decimal getSuspensionForce(uint index) const;
+
+        /// Return the rotation angle of a wheel around its axle
+        decimal getWheelRotationAngle(uint index) const;
+
+        /// Return the transform of a wheel (in world-space)
+        Transform getWheelTransform(uint index) const;
+
+        /// Return the speed of the chassis along its forward axis
+        decimal getForwardSpeed() const;
+
+        // -------------------- Friendship -------------------- //
+
+        friend class DynamicsWorld;
+        friend class ContactSolver;
+};
+
+// Return the number of wheels
+inline uint Vehicle::getNbWheels() const {
+    return mWheels.size();
+}
+
+// Return the chassis of the vehicle
+inline RigidBody* Vehicle::getChassis() const {
+    return mChassis;
+}
+
+// Return the settings of the vehicle
+inline const VehicleSettings& Vehicle::getSettings() const {
+    return mSettings;
+}
+
+// Return the settings of a wheel
+/**
+ * @param index Index of the wheel
+ * @return The settings of the wheel
+ */
+inline const WheelSettings& Vehicle::getWheelSettings(uint index) const {
+    assert(index < mWheels.size());
+    return mWheels[index].settings;
+}
+
+// Return the steering angle of a wheel
+/**
+ * @param index Index of the wheel
+ * @return The angle of the wheel around the up axis of the chassis (in radians)
+ */
+inline decimal Vehicle::getSteeringAngle(uint index) const {
+    assert(index < mWheels.size());
+    return mWheels[index].steeringAngle;
+}
+
+// Return the force applied by the engine to a wheel
+/**
+ * @param index Index of the wheel
+ * @return The engine force (in Newtons)
+ */
+inline decimal Vehicle::getEngineForce(uint index) const {
+    assert(index < mWheels.size());
+    return mWheels[index].engineForce;
+}
+
+// Return the largest force applied by the brake of a wheel
+/**
+ * @param index Index of the wheel
+ * @return The brake force (in Newtons)
+ */
+inline decimal Vehicle::getBrakeForce(uint index) const {
+    assert(index < mWheels.size());
+    return mWheels[index].brakeForce;
+}
+
+// Return true if a wheel touches the ground
+/**
+ * @param index Index of the wheel
+ * @return True if the ray of the wheel has hit the ground at the last step
+ */
+inline bool Vehicle::isWheelInContact(uint index) const {
+    assert(index < mWheels.size());
+    return mWheels[index].isInContact;
+}
+
+// Return the contact point of a wheel on the ground
+/**
+ * @param index Index of the wheel
+ * @return The contact point in world-space (only valid if the wheel is in contact)
+ */
+inline const Vector3& Vehicle::getWheelContactPoint(uint index) const {
+    assert(index < mWheels.size());
+    return mWheels[index].contactPoint;
+}
+
+// Return the normal of the ground under a wheel
+/**
+ * @param index Index of the wheel
+ * @return The normal of the ground in world-space (only valid if the wheel is in contact)
+ */
+inline const Vector3& Vehicle::getWheelContactNormal(uint index) const {
+    assert(index < mWheels.size());
+    return mWheels[index].contactNormal;
+}
+
+// Return the body of the ground under a wheel
+/**
+ * @param index Index of the wheel
+ * @return A pointer to the body hit by the ray of the wheel at the last step (null
+ *         if the wheel is not in contact)
+ */
+inline CollisionBody* Vehicle::getWheelGroundBody(uint index) const {
+    assert(index < mWheels.size());
+    return mWheels[index].groundBody;
+}
+
+// Return the current length of the suspension of a wheel
+/**
+ * @param index Index of the wheel
+ * @return The length of the suspension (the rest length if the wheel is not in contact)
+ */
+inline decimal Vehicle::getSuspensionLength(uint index) const {
+    assert(index < mWheels.size());
+    return mWheels[index].suspensionLength;
+}
+
+// Return the force applied by the suspension of a wheel during the last step
+/**
+ * @param index Index of the wheel
+ * @return The force of the suspension (in Newtons)
+ */
+inline decimal Vehicle::getSuspensionForce(uint index) const {
+    assert(index < mWheels.size());
+    return mWheels[index].suspensionForce;
+}
+
+// Return the rotation angle of a wheel around its axle
+/**
+ * @param index Index of the wheel
+ * @return The rotation angle of the wheel (in radians)
+ */
+inline decimal Vehicle::getWheelRotationAngle(uint index) const {
+    assert(index < mWheels.size());
+    return mWheels[index].rotationAngle;
+}
+
+}
+
+#endif
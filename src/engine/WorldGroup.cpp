@@ -0,0 +1,173 @@
+/********************************************************************************
+* ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
+* Copyright (c) 2010-2018 Daniel Chappuis                                       *
+*********************************************************************************
+*                                                                               *
+* This software is provided 'as-is', without any express or implied warranty.   *
+* In no event will the authors be held liable for any damages arising from the  *
+* use of this software.                                                         *
+*                                                                               *
+* Permission is granted to anyone to use this software for any purpose,         *
+* including commercial applications, and to alter it and redistribute it        *
+* freely, subject to the following restrictions:                                *
+*                                                                               *
+* 1. The origin of this software must not be misrepresented; you must not claim *
+*    that you wrote the original software. If you use this software in a        *
+*    product, an acknowledgment in the product documentation would be           *
+*    appreciated but is not required.                                           *
+*                                                                               *
+* 2. Altered source versions must be plainly marked as such, and must not be    *
+*    misrepresented as being the original software.                             *
+*                                                                               *
+* 3. This notice may not be removed or altered from any source distribution.    *
+*                                                                               *
+********************************************************************************/
+
+// Libraries
+#include "WorldGroup.h"
+#include "engine/DynamicsWorld.h"
+#include "engine/TaskScheduler.h"
+#include <algorithm>
+
+using namespace reactphysics3d;
+
+// Constructor
+/**
+ * @param taskScheduler Task scheduler used to step the worlds in parallel (the worlds are
+ *                      stepped sequentially on the calling thread if null). The scheduler
+ *                      is not owned by the group and must outlive it.
+ * @param allocator Memory allocator of the lists of the group
+ */
+WorldGroup::WorldGroup(TaskScheduler* taskScheduler, MemoryAllocator& allocator)
+           : mTaskScheduler(taskScheduler), mWorlds(allocator), mSortedWorlds(allocator),
+             mWorkersWorlds(allocator), mWorkersStarts(allocator), mWorkersCosts(allocator),
+             mWorldsWorkers(allocator) {
+
+}
+
+// Add a world to the group
+/// The world is not owned by the group and must be removed from it before it is destroyed.
+/**
+ * @param world Pointer to the world to add
+ */
+void WorldGroup::addWorld(DynamicsWorld* world) {
+
+    assert(world != nullptr);
+    assert(std::find(mWorlds.begin(), mWorlds.end(), world) == mWorlds.end());
+
+    mWorlds.add(world);
+}
+
+// Remove a world from the group
+/// The last world of the group is moved at the index of the removed world.
+/**
+ * @param world Pointer to the world to remove
+ */
+void WorldGroup::removeWorld(DynamicsWorld* world) {
+
+    for (uint i=0; i < mWorlds.size(); i++) {
+        if (mWorlds[i] == world) {
+            mWorlds[i] = mWorlds[mWorlds.size() - 1];
+            mWorlds.removeAt(mWorlds.size() - 1);
+            return;
+        }
+    }
+
+    assert(false);
+}
+
+// Distribute the worlds between a given number of workers with the costs of their previous step
+/// The worlds are sorted by decreasing cost and each one is assigned to the worker with
+/// the smallest total cost (or the fewest worlds if the costs are equal). The assignment
+/// only depends on the costs so that it is the same with any task scheduler.
+void WorldGroup::assignWorldsToWorkers(uint nbWorkers) {
+
+    const uint nbWorlds = mWorlds.size();
+
+    // Sort the worlds by decreasing cost of their previous step
+    mSortedWorlds.clear();
+    for (uint i=0; i < nbWorlds; i++) {
+        mSortedWorlds.add(i);
+    }
+    uint* sortedWorlds = &(mSortedWorlds[0]);
+    std::sort(sortedWorlds, sortedWorlds + nbWorlds, [this](uint world1, uint world2) {
+        const double cost1 = mWorlds[world1]->getStepStatistics().totalTime;
+        const double cost2 = mWorlds[world2]->getStepStatistics().totalTime;
+        return cost1 > cost2 || (cost1 == cost2 && world1 < world2);
+    });
+
+    // Assign each world to the worker with the smallest cost
+    mWorkersCosts.clear();
+    mWorkersStarts.clear();
+    for (uint w=0; w <= nbWorkers; w++) {
+        mWorkersCosts.add(0.0);
+        mWorkersStarts.add(0);
+    }
+    mWorldsWorkers.clear();
+    for (uint i=0; i < nbWorlds; i++) {
+        mWorldsWorkers.add(0);
+    }
+    for (uint i=0; i < nbWorlds; i++) {
+
+        uint bestWorker = 0;
+        for (uint w=1; w < nbWorkers; w++) {
+            if (mWorkersCosts[w] < mWorkersCosts[bestWorker] ||
+                (mWorkersCosts[w] == mWorkersCosts[bestWorker] && mWorkersStarts[w] < mWorkersStarts[bestWorker])) {
+                bestWorker = w;
+            }
+        }
+
+        const uint world = mSortedWorlds[i];
+        mWorldsWorkers[world] = bestWorker;
+        mWorkersCosts[bestWorker] += mWorlds[world]->getStepStatistics().totalTime;
+        mWorkersStarts[bestWorker]++;
+    }
+
+    // Compute the end of the worlds of each worker from the numbers of worlds of the workers
+    uint end = 0;
+    for (uint w=0; w <= nbWorkers; w++) {
+        end += mWorkersStarts[w];
+        mWorkersStarts[w] = end;
+    }
+
+    // Store the worlds of each worker contiguously in decreasing order of cost (the
+    // ends become the starts of the workers)
+    mWorkersWorlds.clear();
+    for (uint i=0; i < nbWorlds; i++) {
+        mWorkersWorlds.add(0);
+    }
+    for (uint i=nbWorlds; i > 0; i--) {
+        const uint world = mSortedWorlds[i - 1];
+        mWorkersWorlds[--mWorkersStarts[mWorldsWorkers[world]]] = world;
+    }
+}
+
+// Step all the worlds of the group
+/// Each world is stepped with DynamicsWorld::update() by a single worker of the task
+/// scheduler and the method returns when all the worlds have been stepped.
+/**
+ * @param timeStep The amount of time to step the worlds forward (in seconds)
+ * @param nbSubsteps Number of substeps of the solver in each world
+ */
+void WorldGroup::update(decimal timeStep, uint nbSubsteps) {
+
+    const uint nbWorlds = mWorlds.size();
+    const uint nbWorkers = mTaskScheduler != nullptr ? std::min(mTaskScheduler->getNbWorkers(), nbWorlds) : 1;
+
+    // If the worlds are stepped sequentially
+    if (nbWorkers <= 1) {
+        for (uint i=0; i < nbWorlds; i++) {
+            mWorlds[i]->update(timeStep, nbSubsteps);
+        }
+        return;
+    }
+
+    assignWorldsToWorkers(nbWorkers);
+
+    // Step the worlds of each worker in parallel
+    mTaskScheduler->parallelFor(nbWorkers, [this, timeStep, nbSubsteps](uint worker) {
+        for (uint i=mWorkersStarts[worker]; i < mWorkersStarts[worker + 1]; i++) {
+            mWorlds[mWorkersWorlds[i]]->update(timeStep, nbSubsteps);
+        }
+    });
+}
@@ -0,0 +1,146 @@
+/********************************************************************************
+* ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
+* Copyright (c) 2010-2018 Daniel Chappuis                                       *
+*********************************************************************************
+*                                                                               *
+* This software is provided 'as-is', without any express or implied warranty.   *
+* In no event will the authors be held liable for any damages arising from the  *
+* use of this software.                                                         *
+*                                                                               *
+* Permission is granted to anyone to use this software for any purpose,         *
+* including commercial applications, and to alter it and redistribute it        *
+* freely, subject to the following restrictions:                                *
+*                                                                               *
+* 1. The origin of this software must not be misrepresented; you must not claim *
+*    that you wrote the original software. If you use this software in a        *
+*    product, an acknowledgment in the product documentation would be           *
+*    appreciated but is not required.                                           *
+*                                                                               *
+* 2. Altered source versions must be plainly marked as such, and must not be    *
+*    misrepresented as being the original software.                             *
+*                                                                               *
+* 3. This notice may not be removed or altered from any source distribution.    *
+*                                                                               *
+********************************************************************************/
+
+#ifndef REACTPHYSICS3D_WORLD_GROUP_H
+#define REACTPHYSICS3D_WORLD_GROUP_H
+
+// Libraries
+#include "configuration.h"
+#include "containers/List.h"
+
+/// ReactPhysics3D namespace
+namespace reactphysics3d {
+
+// Declarations
+class DynamicsWorld;
+class TaskScheduler;
+class MemoryAllocator;
+
+// Class WorldGroup
+/**
+ * This class steps a group of independent dynamics worlds (the arenas of a game server
+ * for instance) with a single call. The worlds are distributed between the workers of a
+ * task scheduler and each world is stepped by a single worker. Since each world has its
+ * own memory allocators, the worlds do not share anything while they are stepped.
+ *
+ * The worlds are balanced between the workers with their cost of the previous step (the
+ * total time of their StepStatistics): the most expensive worlds are assigned first, each
+ * one to the worker with the smallest cost so far (longest processing time first). The
+ * worlds that have never been stepped are spread evenly.
+ *
+ * A world of the group can use the task scheduler of the group for its own parallel
+ * stages. With the DefaultTaskScheduler, these stages are then executed by the worker
+ * that steps the world.
+ */
+class WorldGroup {
+
+    private :
+
+        // -------------------- Attributes -------------------- //
+
+        /// Task scheduler used to step the worlds in parallel (sequential if null)
+        TaskScheduler* mTaskScheduler;
+
+        /// Worlds of the group
+        List<DynamicsWorld*> mWorlds;
+
+        /// Indices of the worlds sorted by decreasing cost of their previous step
+        List<uint> mSortedWorlds;
+
+        /// Indices of the worlds of each worker (the worlds of a worker are contiguous)
+        List<uint> mWorkersWorlds;
+
+        /// Index in mWorkersWorlds of the first world of each worker (and the end of the last one)
+        List<uint> mWorkersStarts;
+
+        /// Total cost of the worlds assigned to each worker
+        List<double> mWorkersCosts;
+
+        /// Index of the worker of each world
+        List<uint> mWorldsWorkers;
+
+        // -------------------- Methods -------------------- //
+
+        /// Distribute the worlds between a given number of workers with the costs of their previous step
+        void assignWorldsToWorkers(uint nbWorkers);
+
+    public :
+
+        // -------------------- Methods -------------------- //
+
+        /// Constructor
+        WorldGroup(TaskScheduler* taskScheduler, MemoryAllocator& allocator);
+
+        /// Destructor
+        ~WorldGroup() = default;
+
+        /// Deleted copy-constructor
+        WorldGroup(const WorldGroup& group) = delete;
+
+        /// Deleted assignment operator
+        WorldGroup& operator=(const WorldGroup& group) = delete;
+
+        /// Add a world to the group
+        void addWorld(DynamicsWorld* world);
+
+        /// Remove a world from the group
+        void removeWorld(DynamicsWorld* world);
+
+        /// Return the number of worlds of the group
+        uint getNbWorlds() const;
+
+        /// Return a world of the group
+        DynamicsWorld* getWorld(uint index) const;
+
+        /// Return the task scheduler of the group
+        TaskScheduler* getTaskScheduler() const;
+
+        /// Step all the worlds of the group
+        void update(decimal timeStep, uint nbSubsteps = 1);
+};
+
+// Return the number of worlds of the group
+inline uint WorldGroup::getNbWorlds() const {
+    return mWorlds.size();
+}
+
+// Return a world of the group
+/**
+ * @param index Index of the world in the group (the order changes when a world is removed)
+ * @return A pointer to the world
+ */
+inline DynamicsWorld* WorldGroup::getWorld(uint index) const {
+    assert(index < mWorlds.size());
+    return mWorlds[index];
+}
+
+// Return the task scheduler of the group
+inline TaskScheduler* WorldGroup::getTaskScheduler() const {
+    return mTaskScheduler;
+}
+
+}
+
+#endif
@@ -0,0 +1,460 @@
+/********************************************************************************
+* ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
+* Copyright (c) 2010-2018 Daniel Chappuis                                       *
+*********************************************************************************
+*                                                                               *
+* This software is provided 'as-is', without any express or implied warranty.   *
+* In no event will the authors be held liable for any damages arising from the  *
+* use of this software.                                                         *
+*                                                                               *
+* Permission is granted to anyone to use this software for any purpose,         *
+* including commercial applications, and to alter it and redistribute it        *
+* freely, subject to the following restrictions:                                *
+*                                                                               *
+* 1. The origin of this software must not be misrepresented; you must not claim *
+*    that you wrote the original software. If you use this software in a        *
+*    product, an acknowledgment in the product documentation would be           *
+*    appreciated but is not required.                                           *
+*                                                                               *
+* 2. Altered source versions must be plainly marked as such, and must not be    *
+*    misrepresented as being the original software.                             *
+*                                                                               *
+* 3. This notice may not be removed or altered from any source distribution.    *
+*                                                                               *
+********************************************************************************/
+
+// Libraries
+#include "WorldRecorder.h"
+#include "engine/DynamicsWorld.h"
+#include "engine/WorldState.h"
+#include "body/RigidBody.h"
+#include <cstring>
+
+using namespace reactphysics3d;
+
+// Constants
+const uint32 WorldRecorder::LOG_MAGIC = 0x4c575052;    // "RPWL" in little-endian
+const uint32 WorldRecorder::LOG_VERSION = 1;
+
+// Constructor
+/// The current state of the world is saved as the first keyframe of the log.
+/**
+ * @param world Pointer to the world to record (it must outlive the recorder)
+ * @param shapes Array with all the collision shapes of the proxy shapes of the world
+ *               (the array must outlive the recorder)
+ * @param nbShapes Number of collision shapes in the array
+ * @param nbUpdatesPerKeyframe Number of updates recorded between two keyframes
+ * @param allocator Memory allocator of the keyframes and of the commands
+ */
+WorldRecorder::WorldRecorder(DynamicsWorld* world, const CollisionShape* const* shapes, uint nbShapes,
+                             uint nbUpdatesPerKeyframe, MemoryAllocator& allocator)
+              : mAllocator(allocator), mWorld(world), mShapes(shapes), mNbShapes(nbShapes),
+                mNbUpdatesPerKeyframe(nbUpdatesPerKeyframe), mPreviousKeyframe(nullptr),
+                mPreviousKeyframeSize(0), mPreviousCommands(allocator), mNbPreviousUpdates(0),
+                mKeyframe(nullptr), mKeyframeSize(0), mCommands(allocator), mNbUpdates(0) {
+
+    assert(world != nullptr);
+    assert(nbUpdatesPerKeyframe > 0);
+
+    saveKeyframe();
+}
+
+// Destructor
+WorldRecorder::~WorldRecorder() {
+
+    if (mPreviousKeyframe != nullptr) mAllocator.release(mPreviousKeyframe, mPreviousKeyframeSize);
+    mAllocator.release(mKeyframe, mKeyframeSize);
+}
+
+// Save the world as the current keyframe
+/// The current keyframe and its commands become the previous ones and the older ones
+/// are dropped.
+void WorldRecorder::saveKeyframe() {
+
+    if (mKeyframe != nullptr) {
+
+        if (mPreviousKeyframe != nullptr) mAllocator.release(mPreviousKeyframe, mPreviousKeyframeSize);
+        mPreviousKeyframe = mKeyframe;
+        mPreviousKeyframeSize = mKeyframeSize;
+
+        // Swap the lists of commands to reuse their memory
+        List<unsigned char> previousCommands(std::move(mPreviousCommands));
+        mPreviousCommands = std::move(mCommands);
+        mCommands = std::move(previousCommands);
+        mCommands.clear();
+        mNbPreviousUpdates = mNbUpdates;
+        mNbUpdates = 0;
+    }
+
+    mKeyframeSize = mWorld->getWorldSizeInBytes();
+    mKeyframe = static_cast<unsigned char*>(mAllocator.allocate(mKeyframeSize));
+    mWorld->saveWorld(mKeyframe, mShapes, mNbShapes);
+}
+
+// Append a value to the commands
+template<typename T>
+void WorldRecorder::writeValue(const T& value) {
+
+    const unsigned char* bytes = reinterpret_cast<const unsigned char*>(&value);
+    for (size_t i=0; i < sizeof(T); i++) {
+        mCommands.add(bytes[i]);
+    }
+}
+
+// Append a command with the ID of its body to the commands
+void WorldRecorder::writeCommand(RecordedCommand command, const RigidBody* body) {
+
+    writeValue(command);
+    writeValue(body->getId());
+}
+
+// Create a rigid body in the world and record it
+/**
+ * @param transform Transform of the body
+ * @return A pointer to the new body
+ */
+RigidBody* WorldRecorder::createRigidBody(const Transform& transform) {
+
+    RigidBody* body = mWorld->createRigidBody(transform);
+
+    writeCommand(RecordedCommand::CREATE_RIGID_BODY, body);
+    writeValue(transform);
+
+    return body;
+}
+
+// Destroy a rigid body of the world and record it
+/**
+ * @param body Pointer to the body to destroy
+ */
+void WorldRecorder::destroyRigidBody(RigidBody* body) {
+
+    writeCommand(RecordedCommand::DESTROY_RIGID_BODY, body);
+
+    mWorld->destroyRigidBody(body);
+}
+
+// Add a collision shape to a rigid body and record it
+/**
+ * @param body Pointer to the body
+ * @param collisionShape Collision shape (it must be in the array of shapes of the recorder)
+ * @param transform Transform of the collision shape in the local-space of the body
+ * @param mass Mass of the collision shape
+ * @return A pointer to the new proxy shape
+ */
+ProxyShape* WorldRecorder::addCollisionShape(RigidBody* body, CollisionShape* collisionShape,
+                                             const Transform& transform, decimal mass) {
+
+    uint32 shapeIndex = 0;
+    while (shapeIndex < mNbShapes && mShapes[shapeIndex] != collisionShape) shapeIndex++;
+    assert(shapeIndex < mNbShapes);
+
+    writeCommand(RecordedCommand::ADD_COLLISION_SHAPE, body);
+    writeValue(shapeIndex);
+    writeValue(transform);
+    writeValue(mass);
+
+    return body->addCollisionShape(collisionShape, transform, mass);
+}
+
+// Set the transform of a rigid body and record it
+void WorldRecorder::setTransform(RigidBody* body, const Transform& transform) {
+
+    writeCommand(RecordedCommand::SET_TRANSFORM, body);
+    writeValue(transform);
+
+    body->setTransform(transform);
+}
+
+// Set the linear velocity of a rigid body and record it
+void WorldRecorder::setLinearVelocity(RigidBody* body, const Vector3& linearVelocity) {
+
+    writeCommand(RecordedCommand::SET_LINEAR_VELOCITY, body);
+    writeValue(linearVelocity);
+
+    body->setLinearVelocity(linearVelocity);
+}
+
+// Set the angular velocity of a rigid body and record it
+void WorldRecorder::setAngularVelocity(RigidBody* body, const Vector3& angularVelocity) {
+
+    writeCommand(RecordedCommand::SET_ANGULAR_VELOCITY, body);
+    writeValue(angularVelocity);
+
+    body->setAngularVelocity(angularVelocity);
+}
+
+// Apply a force at the center of mass of a rigid body and record it
+void WorldRecorder::applyForceToCenterOfMass(RigidBody* body, const Vector3& force) {
+
+    writeCommand(RecordedCommand::APPLY_FORCE_TO_CENTER_OF_MASS, body);
+    writeValue(force);
+
+    body->applyForceToCenterOfMass(force);
+}
+
+// Apply a force at a given point of a rigid body and record it
+void WorldRecorder::applyForce(RigidBody* body, const Vector3& force, const Vector3& point) {
+
+    writeCommand(RecordedCommand::APPLY_FORCE, body);
+    writeValue(force);
+    writeValue(point);
+
+    body->applyForce(force, point);
+}
+
+// Apply a torque to a rigid body and record it
+void WorldRecorder::applyTorque(RigidBody* body, const Vector3& torque) {
+
+    writeCommand(RecordedCommand::APPLY_TORQUE, body);
+    writeValue(torque);
+
+    body->applyTorque(torque);
+}
+
+// Update the world and record it
+/// A new keyframe is saved after the update if nbUpdatesPerKeyframe updates have been
+/// recorded since the current one.
+/**
+ * @param timeStep Time step of the update
+ * @param nbSubsteps Number of substeps of the update
+ */
+void WorldRecorder::update(decimal timeStep, uint nbSubsteps) {
+
+    writeValue(RecordedCommand::UPDATE);
+    writeValue(timeStep);
+    writeValue(static_cast<uint32>(nbSubsteps));
+
+    mWorld->update(timeStep, nbSubsteps);
+
+    mNbUpdates++;
+    if (mNbUpdates == mNbUpdatesPerKeyframe) {
+        saveKeyframe();
+    }
+}
+
+// Return the size in bytes of the saved log
+/**
+ * @return The size of the buffer needed by saveLog()
+ */
+size_t WorldRecorder::getLogSizeInBytes() const {
+
+    const size_t headerSize = 3 * sizeof(uint32) + 2 * sizeof(uint64);
+
+    if (mPreviousKeyframe != nullptr) {
+        return headerSize + mPreviousKeyframeSize + mPreviousCommands.size() + mCommands.size();
+    }
+
+    return headerSize + mKeyframeSize + mCommands.size();
+}
+
+// Write the log (a keyframe and the commands recorded since) into a buffer
+/// The log starts at the previous keyframe if there is one so that it always contains
+/// at least the last nbUpdatesPerKeyframe updates. It contains no pointer and can be
+/// written to a file to be replayed on another machine by a WorldReplayer.
+/**
+ * @param buffer Buffer with the size given by getLogSizeInBytes()
+ */
+void WorldRecorder::saveLog(void* buffer) const {
+
+    const bool hasPreviousKeyframe = mPreviousKeyframe != nullptr;
+    const unsigned char* keyframe = hasPreviousKeyframe ? mPreviousKeyframe : mKeyframe;
+    const size_t keyframeSize = hasPreviousKeyframe ? mPreviousKeyframeSize : mKeyframeSize;
+    const size_t nbPreviousCommandBytes = hasPreviousKeyframe ? mPreviousCommands.size() : 0;
+
+    WorldStateWriter writer(buffer);
+    writer.write(LOG_MAGIC);
+    writer.write(LOG_VERSION);
+    writer.write(static_cast<uint32>(getNbRecordedUpdates()));
+    writer.write(static_cast<uint64>(keyframeSize));
+    writer.write(static_cast<uint64>(nbPreviousCommandBytes + mCommands.size()));
+
+    unsigned char* data = static_cast<unsigned char*>(buffer) + writer.getSizeInBytes();
+    std::memcpy(data, keyframe, keyframeSize);
+    data += keyframeSize;
+    if (nbPreviousCommandBytes > 0) {
+        std::memcpy(data, &mPreviousCommands[0], nbPreviousCommandBytes);
+        data += nbPreviousCommandBytes;
+    }
+    if (mCommands.size() > 0) {
+        std::memcpy(data, &mCommands[0], mCommands.size());
+    }
+}
+
+// Constructor
+/// The keyframe of the log is loaded into a new world (see DynamicsWorld::loadWorld()) and
+/// the commands are copied: the log is not needed anymore after the call.
+/**
+ * @param log Pointer to the log (written by WorldRecorder::saveLog())
+ * @param sizeInBytes Size of the log in bytes
+ * @param shapes Array with the collision shapes given to the recorder (in the same order).
+ *               The shapes and the array must outlive the replayer.
+ * @param nbShapes Number of collision shapes in the array
+ * @param allocator Memory allocator of the commands
+ * @param worldSettings Settings of the replayed world
+ */
+WorldReplayer::WorldReplayer(const void* log, size_t sizeInBytes, CollisionShape* const* shapes, uint nbShapes,
+                             MemoryAllocator& allocator, const WorldSettings& worldSettings)
+              : mWorld(nullptr), mShapes(shapes), mNbShapes(nbShapes), mCommands(allocator), mOffset(0),
+                mBodies(allocator), mNbReplayedUpdates(0), mLongestUpdateIndex(0), mLongestUpdateTime(0.0) {
+
+    if (log == nullptr) return;
+
+    WorldStateReader reader(log, sizeInBytes);
+
+    const size_t headerSize = 3 * sizeof(uint32) + 2 * sizeof(uint64);
+    if (!reader.canRead(headerSize)) return;
+
+    if (reader.read<uint32>() != WorldRecorder::LOG_MAGIC || reader.read<uint32>() != WorldRecorder::LOG_VERSION) {
+        return;
+    }
+    reader.read<uint32>();
+    const uint64 keyframeSize = reader.read<uint64>();
+    const uint64 nbCommandBytes = reader.read<uint64>();
+    if (headerSize + keyframeSize + nbCommandBytes != sizeInBytes) return;
+
+    const unsigned char* data = static_cast<const unsigned char*>(log) + headerSize;
+    mWorld = DynamicsWorld::loadWorld(data, static_cast<size_t>(keyframeSize), shapes, nbShapes, worldSettings);
+    if (mWorld == nullptr) return;
+
+    // The bodies of the loaded world have the same IDs as in the recorded world
+    for (uint i=0; i < mWorld->getNbRigidBodies(); i++) {
+        RigidBody* body = mWorld->getRigidBody(i);
+        mBodies.add(Pair<bodyindex, RigidBody*>(body->getId(), body));
+    }
+
+    data += keyframeSize;
+    mCommands.reserve(static_cast<size_t>(nbCommandBytes));
+    for (uint64 i=0; i < nbCommandBytes; i++) {
+        mCommands.add(data[i]);
+    }
+}
+
+// Destructor
+WorldReplayer::~WorldReplayer() {
+    delete mWorld;
+}
+
+// Read a value of the commands
+template<typename T>
+T WorldReplayer::readValue() {
+
+    assert(mOffset + sizeof(T) <= mCommands.size());
+
+    T value;
+    std::memcpy(static_cast<void*>(&value), &mCommands[static_cast<uint>(mOffset)], sizeof(T));
+    mOffset += sizeof(T);
+
+    return value;
+}
+
+// Read the ID of a body and return the corresponding body of the world
+RigidBody* WorldReplayer::readBody() {
+
+    auto it = mBodies.find(readValue<bodyindex>());
+    assert(it != mBodies.end());
+
+    return it->second;
+}
+
+// Replay the commands until the next update (included)
+/**
+ * @return False if there is no update left to replay in the log
+ */
+bool WorldReplayer::replayNextUpdate() {
+
+    assert(isValid());
+
+    while (mOffset < mCommands.size()) {
+
+        const RecordedCommand command = readValue<RecordedCommand>();
+
+        switch (command) {
+
+            case RecordedCommand::CREATE_RIGID_BODY:
+            {
+                const bodyindex recordedId = readValue<bodyindex>();
+                RigidBody* body = mWorld->createRigidBody(readValue<Transform>());
+                mBodies.add(Pair<bodyindex, RigidBody*>(recordedId, body), true);
+                break;
+            }
+            case RecordedCommand::DESTROY_RIGID_BODY:
+            {
+                const bodyindex recordedId = readValue<bodyindex>();
+                auto it = mBodies.find(recordedId);
+                assert(it != mBodies.end());
+                mWorld->destroyRigidBody(it->second);
+                mBodies.remove(recordedId);
+                break;
+            }
+            case RecordedCommand::ADD_COLLISION_SHAPE:
+            {
+                RigidBody* body = readBody();
+                const uint32 shapeIndex = readValue<uint32>();
+                assert(shapeIndex < mNbShapes);
+                const Transform transform = readValue<Transform>();
+                body->addCollisionShape(mShapes[shapeIndex], transform, readValue<decimal>());
+                break;
+            }
+            case RecordedCommand::SET_TRANSFORM:
+            {
+                RigidBody* body = readBody();
+                body->setTransform(readValue<Transform>());
+                break;
+            }
+            case RecordedCommand::SET_LINEAR_VELOCITY:
+            {
+                RigidBody* body = readBody();
+                body->setLinearVelocity(readValue<Vector3>());
+                break;
+            }
+            case RecordedCommand::SET_ANGULAR_VELOCITY:
+            {
+                RigidBody* body = readBody();
+                body->setAngularVelocity(readValue<Vector3>());
+                break;
+            }
+            case RecordedCommand::APPLY_FORCE_TO_CENTER_OF_MASS:
+            {
+                RigidBody* body = readBody();
+                body->applyForceToCenterOfMass(readValue<Vector3>());
+                break;
+            }
+            case RecordedCommand::APPLY_FORCE:
+            {
+                RigidBody* body = readBody();
+                const Vector3 force = readValue<Vector3>();
+                body->applyForce(force, readValue<Vector3>());
+                break;
+            }
+            case RecordedCommand::APPLY_TORQUE:
+            {
+                RigidBody* body = readBody();
+                body->applyTorque(readValue<Vector3>());
+                break;
+            }
+            case RecordedCommand::UPDATE:
+            {
+                const decimal timeStep = readValue<decimal>();
+                mWorld->update(timeStep, readValue<uint32>());
+
+                // Keep the longest update to find the spike of the recorded workload
+                const double updateTime = mWorld->getStepStatistics().totalTime;
+                if (mNbReplayedUpdates == 0 || updateTime > mLongestUpdateTime) {
+                    mLongestUpdateIndex = mNbReplayedUpdates;
+                    mLongestUpdateTime = updateTime;
+                }
+                mNbReplayedUpdates++;
+
+                return true;
+            }
+        }
+    }
+
+    return false;
+}
+
+// Replay all the remaining commands of the log
+void WorldReplayer::replay() {
+    while (replayNextUpdate()) {}
+}
@@ -0,0 +1,324 @@
+/********************************************************************************
+* ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
+* Copyright (c) 2010-2018 Daniel Chappuis                                       *
+*********************************************************************************
+*                                                                               *
+* This software is provided 'as-is', without any express or implied warranty.   *
+* In no event will the authors be held liable for any damages arising from the  *
+* use of this software.                                                         *
+*                                                                               *
+* Permission is granted to anyone to use this software for any purpose,         *
+* including commercial applications, and to alter it and redistribute it        *
+* freely, subject to the following restrictions:                                *
+*                                                                               *
+* 1. The origin of this software must not be misrepresented; you must not claim *
+*    that you wrote the original software. If you use this software in a        *
+*    product, an acknowledgment in the product documentation would be           *
+*    appreciated but is not required.                                           *
+*                                                                               *
+* 2. Altered source versions must be plainly marked as such, and must not be    *
+*    misrepresented as being the original software.                             *
+*                                                                               *
+* 3. This notice may not be removed or altered from any source distribution.    *
+*                                                                               *
+********************************************************************************/
+
+#ifndef REACTPHYSICS3D_WORLD_RECORDER_H
+#define REACTPHYSICS3D_WORLD_RECORDER_H
+
+// Libraries
+#include "configuration.h"
+#include "containers/List.h"
+#include "containers/Map.h"
+#include "mathematics/Transform.h"
+
+/// ReactPhysics3D namespace
+namespace reactphysics3d {
+
+// Declarations
+class DynamicsWorld;
+class RigidBody;
+class ProxyShape;
+class CollisionShape;
+class MemoryAllocator;
+
+/// Type of a command recorded by a WorldRecorder
+enum class RecordedCommand : uint8 {CREATE_RIGID_BODY, DESTROY_RIGID_BODY, ADD_COLLISION_SHAPE,
+                                    SET_TRANSFORM, SET_LINEAR_VELOCITY, SET_ANGULAR_VELOCITY,
+                                    APPLY_FORCE_TO_CENTER_OF_MASS, APPLY_FORCE, APPLY_TORQUE, UPDATE};
+
+// Class WorldRecorder
+/**
+ * This class records the workload of a dynamics world so that it can be reproduced
+ * later with a WorldReplayer (for instance on a development machine to profile a spike
+ * of a production server). The recorder saves the whole world (see DynamicsWorld::saveWorld())
+ * as a keyframe and then appends a compact command to its log for each call made through
+ * it: the call is forwarded to the world and its arguments are written with the IDs of
+ * the bodies instead of pointers.
+ *
+ * To bound the memory of the log, a new keyframe is saved each time a given number of
+ * updates have been recorded and the commands older than the previous keyframe are
+ * dropped. The saved log therefore always contains the last nbUpdatesPerKeyframe to
+ * 2 * nbUpdatesPerKeyframe recorded updates.
+ *
+ * All the calls that change the world while it is recorded (creation and destruction of
+ * the rigid bodies, forces, transforms, velocities and updates) must be made through the
+ * recorder. The collision shapes of the proxy shapes must be in the array given to the
+ * constructor and the same array must be given to the replayer.
+ */
+class WorldRecorder {
+
+    private :
+
+        // -------------------- Attributes -------------------- //
+
+        /// Memory allocator of the keyframes and of the commands
+        MemoryAllocator& mAllocator;
+
+        /// Recorded world
+        DynamicsWorld* mWorld;
+
+        /// Array with the collision shapes of the proxy shapes of the world
+        const CollisionShape* const* mShapes;
+
+        /// Number of collision shapes in the array
+        uint mNbShapes;
+
+        /// Number of updates recorded between two keyframes
+        uint mNbUpdatesPerKeyframe;
+
+        /// Previous keyframe (null if a single keyframe has been saved)
+        unsigned char* mPreviousKeyframe;
+
+        /// Size in bytes of the previous keyframe
+        size_t mPreviousKeyframeSize;
+
+        /// Commands recorded between the previous keyframe and the current one
+        List<unsigned char> mPreviousCommands;
+
+        /// Number of updates recorded between the previous keyframe and the current one
+        uint mNbPreviousUpdates;
+
+        /// Current keyframe
+        unsigned char* mKeyframe;
+
+        /// Size in bytes of the current keyframe
+        size_t mKeyframeSize;
+
+        /// Commands recorded since the current keyframe
+        List<unsigned char> mCommands;
+
+        /// Number of updates recorded since the current keyframe
+        uint mNbUpdates;
+
+        // -------------------- Methods -------------------- //
+
+        /// Save the world as the current keyframe
+        void saveKeyframe();
+
+        /// Append a value to the commands
+        template<typename T>
+        void writeValue(const T& value);
+
+        /// Append a command with the ID of its body to the commands
+        void writeCommand(RecordedCommand command, const RigidBody* body);
+
+    public :
+
+        // -------------------- Constants -------------------- //
+
+        /// Magic number at the beginning of a saved log
+        static const uint32 LOG_MAGIC;
+
+        /// Version of the format of a saved log
+        static const uint32 LOG_VERSION;
+
+        // -------------------- Methods -------------------- //
+
+        /// Constructor
+        WorldRecorder(DynamicsWorld* world, const CollisionShape* const* shapes, uint nbShapes,
+                      uint nbUpdatesPerKeyframe, MemoryAllocator& allocator);
+
+        /// Destructor
+        ~WorldRecorder();
+
+        /// Deleted copy-constructor
+        WorldRecorder(const WorldRecorder& recorder) = delete;
+
+        /// Deleted assignment operator
+        WorldRecorder& operator=(const WorldRecorder& recorder) = delete;
+
+        /// Return the recorded world
+        DynamicsWorld* getWorld() const;
+
+        /// Create a rigid body in the world and record it
+        RigidBody* createRigidBody(const Transform& transform);
+
+        /// Destroy a rigid body of the world and record it
+        void destroyRigidBody(RigidBody* body);
+
+        /// Add a collision shape to a rigid body and record it
+        ProxyShape* addCollisionShape(RigidBody* body, CollisionShape* collisionShape,
+                                      const Transform& transform, decimal mass);
+
+        /// Set the transform of a rigid body and record it
+        void setTransform(RigidBody* body, const Transform& transform);
+
+        /// Set the linear velocity of a rigid body and record it
+        void setLinearVelocity(RigidBody* body, const Vector3& linearVelocity);
+
+        /// Set the angular velocity of a rigid body and record it
+        void setAngularVelocity(RigidBody* body, const Vector3& angularVelocity);
+
+        /// Apply a force at the center of mass of a rigid body and record it
+        void applyForceToCenterOfMass(RigidBody* body, const Vector3& force);
+
+        /// Apply a force at a given point of a rigid body and record it
+        void applyForce(RigidBody* body, const Vector3& force, const Vector3& point);
+
+        /// Apply a torque to a rigid body and record it
+        void applyTorque(RigidBody* body, const Vector3& torque);
+
+        /// Update the world and record it
+        void update(decimal timeStep, uint nbSubsteps = 1);
+
+        /// Return the number of updates in the saved log
+        uint getNbRecordedUpdates() const;
+
+        /// Return the size in bytes of the saved log
+        size_t getLogSizeInBytes() const;
+
+        /// Write the log (a keyframe and the commands recorded since) into a buffer
+        void saveLog(void* buffer) const;
+};
+
+// Class WorldReplayer
+/**
+ * This class replays a log written by a WorldRecorder. It loads the keyframe of the
+ * log into a new world and executes the recorded commands on it with the same bodies
+ * and in the same order. The replayed world does the same work as the recorded one but
+ * its results can differ by rounding errors because the broad-phase of the loaded world
+ * can find the new overlapping pairs in a different order. The updates of the replayed
+ * world are measured and profiled like the updates of any other world (with the profiler
+ * of the world if IS_PROFILING_ACTIVE is defined), which allows to reproduce a spike of
+ * a production server and to optimize it on a development machine.
+ */
+class WorldReplayer {
+
+    private :
+
+        // -------------------- Attributes -------------------- //
+
+        /// Replayed world (null if the log is not valid)
+        DynamicsWorld* mWorld;
+
+        /// Collision shapes of the proxy shapes of the world
+        CollisionShape* const* mShapes;
+
+        /// Number of collision shapes in the array
+        uint mNbShapes;
+
+        /// Commands of the log
+        List<unsigned char> mCommands;
+
+        /// Offset of the next command to replay
+        size_t mOffset;
+
+        /// Bodies of the world with their ID in the recorded world
+        Map<bodyindex, RigidBody*> mBodies;
+
+        /// Number of updates replayed so far
+        uint mNbReplayedUpdates;
+
+        /// Index of the longest update replayed so far
+        uint mLongestUpdateIndex;
+
+        /// Duration in seconds of the longest update replayed so far
+        double mLongestUpdateTime;
+
+        // -------------------- Methods -------------------- //
+
+        /// Read a value of the commands
+        template<typename T>
+        T readValue();
+
+        /// Read the ID of a body and return the corresponding body of the world
+        RigidBody* readBody();
+
+    public :
+
+        // -------------------- Methods -------------------- //
+
+        /// Constructor
+        WorldReplayer(const void* log, size_t sizeInBytes, CollisionShape* const* shapes, uint nbShapes,
+                      MemoryAllocator& allocator, const WorldSettings& worldSettings = WorldSettings());
+
+        /// Destructor
+        ~WorldReplayer();
+
+        /// Deleted copy-constructor
+        WorldReplayer(const WorldReplayer& replayer) = delete;
+
+        /// Deleted assignment operator
+        WorldReplayer& operator=(const WorldReplayer& replayer) = delete;
+
+        /// Return true if the log has been loaded
+        bool isValid() const;
+
+        /// Return the replayed world
+        DynamicsWorld* getWorld() const;
+
+        /// Replay the commands until the next update (included)
+        bool replayNextUpdate();
+
+        /// Replay all the remaining commands of the log
+        void replay();
+
+        /// Return the number of updates replayed so far
+        uint getNbReplayedUpdates() const;
+
+        /// Return the index of the longest update replayed so far
+        uint getLongestUpdateIndex() const;
+
+        /// Return the duration in seconds of the longest update replayed so far
+        double getLongestUpdateTime() const;
+};
+
+// Return the recorded world
+inline DynamicsWorld* WorldRecorder::getWorld() const {
+    return mWorld;
+}
+
+// Return the number of updates in the saved log
+inline uint WorldRecorder::getNbRecordedUpdates() const {
+    return mNbPreviousUpdates + mNbUpdates;
+}
+
+// Return true if the log has been loaded
+inline bool WorldReplayer::isValid() const {
+    return mWorld != nullptr;
+}
+
+// Return the replayed world
+inline DynamicsWorld* WorldReplayer::getWorld() const {
+    return mWorld;
+}
+
+// Return the number of updates replayed so far
+inline uint WorldReplayer::getNbReplayedUpdates() const {
+    return mNbReplayedUpdates;
+}
+
+// Return the index of the longest update replayed so far
+inline uint WorldReplayer::getLongestUpdateIndex() const {
+    return mLongestUpdateIndex;
+}
+
+// Return the duration in seconds of the longest update replayed so far
+inline double WorldReplayer::getLongestUpdateTime() const {
+    return mLongestUpdateTime;
+}
+
+}
+
+#endif
@@ -0,0 +1,1325 @@
+/********************************************************************************
+* ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
+* Copyright (c) 2010-2018 Daniel Chappuis                                       *
+*********************************************************************************
+*                                                                               *
+* This software is provided 'as-is', without any express or implied warranty.   *
+* In no event will the authors be held liable for any damages arising from the  *
+* use of this software.                                                         *
+*                                                                               *
+* Permission is granted to anyone to use this software for any purpose,         *
+* including commercial applications, and to alter it and redistribute it        *
+* freely, subject to the following restrictions:                                *
+*                                                                               *
+* 1. The origin of this software must not be misrepresented; you must not claim *
+*    that you wrote the original software. If you use this software in a        *
+*    product, an acknowledgment in the product documentation would be           *
+*    appreciated but is not required.                                           *
+*                                                                               *
+* 2. Altered source versions must be plainly marked as such, and must not be    *
+*    misrepresented as being the original software.                             *
+*                                                                               *
+* 3. This notice may not be removed or altered from any source distribution.    *
+*                                                                               *
+********************************************************************************/
+
+// Libraries
+#include "DynamicsWorld.h"
+#include "engine/WorldState.h"
+#include "containers/FlatMap.h"
+#include <algorithm>
+#include <cmath>
+
+// Namespaces
+using namespace reactphysics3d;
+
+// Magic number at the beginning of a saved state of the world ("RPWS" in little-endian)
+static const uint32 STATE_MAGIC = 0x53575052;
+
+// Version of the format of a saved state of the world
+static const uint32 STATE_VERSION = 4;
+
+// Index written in a saved state instead of a null rigid body
+static const uint32 STATE_NULL_BODY_INDEX = 0xFFFFFFFF;
+
+// Magic number at the beginning of a saved world ("RPWW" in little-endian)
+static const uint32 WORLD_MAGIC = 0x57575052;
+
+// Version of the format of a saved world
+static const uint32 WORLD_VERSION = 2;
+
+// Magic number at the beginning of a saved rigid body ("RPWB" in little-endian)
+static const uint32 BODY_MAGIC = 0x42575052;
+
+// Magic number at the beginning of saved motions of rigid bodies ("RPWM" in little-endian)
+static const uint32 MOTIONS_MAGIC = 0x4D575052;
+
+// Magic number at the beginning of saved quantized motions of rigid bodies ("RPWQ" in little-endian)
+static const uint32 QUANTIZED_MOTIONS_MAGIC = 0x51575052;
+
+// Maximum size in bytes of a saved motion of a rigid body
+static const size_t MAX_MOTION_SIZE = 64;
+
+// Square root of two
+static const decimal SQRT_TWO = decimal(1.41421356237309504880);
+
+// Return the nearest fixed-point integer of a value with a given precision (clamped to the
+// range of the integers)
+static int32 quantizeMotionValue(decimal value, decimal precision) {
+
+    const double quantizedValue = std::round(double(value) / double(precision));
+    return static_cast<int32>(std::max(-2147483647.0, std::min(2147483647.0, quantizedValue)));
+}
+
+// Encode a unit quaternion with the smallest-three encoding
+/// The largest component is dropped (its index is stored in the two highest bits) and its sign
+/// is made positive (the opposite quaternion is the same rotation). The three other components
+/// are in the range [-1/sqrt(2), 1/sqrt(2)] and are quantized with 10 bits each.
+static uint32 encodeSmallestThree(const Quaternion& quaternion) {
+
+    const decimal components[4] = {quaternion.x, quaternion.y, quaternion.z, quaternion.w};
+    uint32 largestIndex = 0;
+    for (uint32 i=1; i < 4; i++) {
+        if (std::abs(components[i]) > std::abs(components[largestIndex])) largestIndex = i;
+    }
+    const decimal sign = components[largestIndex] < decimal(0.0) ? decimal(-1.0) : decimal(1.0);
+
+    uint32 code = largestIndex << 30;
+    uint32 shift = 20;
+    for (uint32 i=0; i < 4; i++) {
+        if (i == largestIndex) continue;
+        const decimal normalized = (sign * components[i] * SQRT_TWO + decimal(1.0)) * decimal(0.5);
+        const decimal clamped = std::max(decimal(0.0), std::min(decimal(1.0), normalized));
+        code |= static_cast<uint32>(std::round(clamped * decimal(1023.0))) << shift;
+        shift -= 10;
+    }
+
+    return code;
+}
+
+// Decode a unit quaternion encoded with encodeSmallestThree()
+static Quaternion decodeSmallestThree(uint32 code) {
+
+    const uint32 largestIndex = code >> 30;
+    decimal components[4];
+    decimal sumSquares = decimal(0.0);
+    uint32 shift = 20;
+    for (uint32 i=0; i < 4; i++) {
+        if (i == largestIndex) continue;
+        const decimal normalized = decimal((code >> shift) & 1023) / decimal(1023.0);
+        components[i] = (normalized * decimal(2.0) - decimal(1.0)) / SQRT_TWO;
+        sumSquares += components[i] * components[i];
+        shift -= 10;
+    }
+    components[largestIndex] = std::sqrt(std::max(decimal(0.0), decimal(1.0) - sumSquares));
+
+    return Quaternion(components[0], components[1], components[2], components[3]).getUnit();
+}
+
+// Return the size in bytes of the header of saved motions
+static size_t getMotionsHeaderSize(bool isQuantized) {
+    return 4 * sizeof(uint32) + (isQuantized ? 3 * sizeof(decimal) : 0);
+}
+
+// Return the size in bytes of a saved motion
+static size_t getMotionSize(bool isQuantized) {
+    return isQuantized ? 2 * sizeof(uint32) + 9 * sizeof(int32) :
+                         sizeof(uint32) + sizeof(Transform) + 2 * sizeof(Vector3);
+}
+
+// Read the header of saved motions and return false if it has not been written for a given number of bodies
+static bool readMotionsHeader(WorldStateReader& reader, size_t sizeInBytes, uint nbBodies,
+                              MotionQuantization& quantization, bool& isQuantized, uint32& nbMotions) {
+
+    if (!reader.canRead(getMotionsHeaderSize(false))) return false;
+
+    const uint32 magic = reader.read<uint32>();
+    if (magic != MOTIONS_MAGIC && magic != QUANTIZED_MOTIONS_MAGIC) return false;
+    isQuantized = magic == QUANTIZED_MOTIONS_MAGIC;
+    if (isQuantized && sizeInBytes < getMotionsHeaderSize(true)) return false;
+
+    if (reader.read<uint32>() != sizeof(decimal) || reader.read<uint32>() != nbBodies) return false;
+
+    if (isQuantized) {
+        reader.read(quantization.positionPrecision);
+        reader.read(quantization.linearVelocityPrecision);
+        reader.read(quantization.angularVelocityPrecision);
+    }
+    nbMotions = reader.read<uint32>();
+
+    return true;
+}
+
+// Write the motion of a rigid body (quantized if the quantization is not null)
+static void writeMotion(WorldStateWriter& writer, uint32 index, const RigidBody* body,
+                        const MotionQuantization* quantization) {
+
+    const Transform& transform = body->getTransform();
+
+    writer.write(index);
+    if (quantization != nullptr) {
+        const Vector3& position = transform.getPosition();
+        const Vector3 linearVelocity = body->getLinearVelocity();
+        const Vector3 angularVelocity = body->getAngularVelocity();
+        writer.write(quantizeMotionValue(position.x, quantization->positionPrecision));
+        writer.write(quantizeMotionValue(position.y, quantization->positionPrecision));
+        writer.write(quantizeMotionValue(position.z, quantization->positionPrecision));
+        writer.write(encodeSmallestThree(transform.getOrientation()));
+        writer.write(quantizeMotionValue(linearVelocity.x, quantization->linearVelocityPrecision));
+        writer.write(quantizeMotionValue(linearVelocity.y, quantization->linearVelocityPrecision));
+        writer.write(quantizeMotionValue(linearVelocity.z, quantization->linearVelocityPrecision));
+        writer.write(quantizeMotionValue(angularVelocity.x, quantization->angularVelocityPrecision));
+        writer.write(quantizeMotionValue(angularVelocity.y, quantization->angularVelocityPrecision));
+        writer.write(quantizeMotionValue(angularVelocity.z, quantization->angularVelocityPrecision));
+    }
+    else {
+        writer.write(transform);
+        writer.write(body->getLinearVelocity());
+        writer.write(body->getAngularVelocity());
+    }
+}
+
+// Return the size in bytes of the current state of the world
+/// The size changes with the overlapping pairs and the contacts of the world.
+/**
+ * @return The size of the buffer needed by saveState()
+ */
+size_t DynamicsWorld::getStateSizeInBytes() const {
+
+    WorldStateWriter writer(nullptr);
+    writeState(writer, 0);
+    return writer.getSizeInBytes();
+}
+
+// Write the current state of the world into a buffer
+/**
+ * The state contains everything that changes during a step (transforms, velocities and
+ * forces of the bodies, sleeping state, persistent islands, broad-phase state of the proxy
+ * shapes, overlapping pairs with their contacts and the accumulated impulses of the joints).
+ * Restoring it with restoreState() and stepping again with the same inputs gives exactly
+ * the same results. The state does not contain the bodies, proxy shapes and joints
+ * themselves nor their properties (mass, materials, collision masks, ...). This method
+ * must not be called while an update started with startUpdate() is running.
+ * @param buffer Buffer with the size given by getStateSizeInBytes()
+ */
+void DynamicsWorld::saveState(void* buffer) const {
+
+    assert(!mIsUpdateRunning);
+
+    WorldStateWriter writer(buffer);
+    writeState(writer, getStateSizeInBytes());
+}
+
+// Restore a state of the world written by saveState()
+/**
+ * The world must have the same bodies, proxy shapes and joints as when the state has been
+ * saved (for instance, the state cannot be restored anymore after a joint has broken). The
+ * state can also be restored into a clone of the world where it has been saved. The
+ * contact events and impulses of the last step are discarded and the cached solver data of
+ * the joints is computed again at the next step. This method must not be called while an
+ * update started with startUpdate() is running.
+ * @param data Pointer to the state (written by saveState())
+ * @param sizeInBytes Size of the state in bytes
+ * @return True if the state has been restored and false (without modifying the world) if it
+ *         was not saved by this version of the library or for the current bodies, proxy
+ *         shapes and joints of the world or if it is corrupted
+ */
+bool DynamicsWorld::restoreState(const void* data, size_t sizeInBytes) {
+
+    assert(!mIsUpdateRunning);
+
+    if (data == nullptr) return false;
+
+    WorldStateReader reader(data, sizeInBytes);
+    FlatMap<int, ProxyShape*> savedProxyShapes(mMemoryManager.getPoolAllocator(MemoryTag::Other));
+    if (!readStateHeader(reader, sizeInBytes, savedProxyShapes)) return false;
+
+    readState(reader, savedProxyShapes);
+
+    return true;
+}
+
+// Read the content of a saved state after its header
+/// The content must have been checked by readStateHeader() (see checkStateContent()).
+void DynamicsWorld::readState(WorldStateReader& reader, const FlatMap<int, ProxyShape*>& savedProxyShapes) {
+
+    BroadPhaseAlgorithm* broadPhase = mCollisionDetection.mBroadPhaseAlgorithm;
+
+    // Destroy the current pairs first because their contact manifolds modify the bodies
+    mCollisionDetection.destroyAllOverlappingPairs();
+
+    // World
+    reader.read(mOrigin);
+    reader.read(mNbStepsSinceExactOrientationNormalization);
+    reader.read(mNbStepsSinceSpatialSort);
+    reader.read(mLevelsOfDetailStepCounter);
+    for (uint i=0; i < NB_SIMULATION_LEVELS_OF_DETAIL; i++) {
+        reader.read(mLevelsOfDetailTimeSteps[i]);
+    }
+    const uint32 islandToSplitIndex = reader.read<uint32>();
+    mIslandToSplit = islandToSplitIndex != STATE_NULL_BODY_INDEX ? mRigidBodies[islandToSplitIndex] : nullptr;
+    reader.read(mIsIslandsRebuildRequested);
+    broadPhase->restoreState(reader);
+
+    // Bodies and their proxy shapes
+    for (uint i=0; i < mBodies.size(); i++) {
+
+        CollisionBody* body = mBodies[i];
+
+        reader.read(body->mTransform);
+        reader.read(body->mIsSleeping);
+        reader.read(body->mSleepTime);
+        reader.read(body->mIsConstraintRemoved);
+
+        for (ProxyShape* shape = body->getProxyShapesList(); shape != nullptr; shape = shape->getNext()) {
+            if (shape->getBroadPhaseId() != -1) {
+                broadPhase->restoreProxyShapeState(shape, reader);
+            }
+            else if (shape->isQueryOnly()) {
+
+                // The query-only shapes are not saved and are moved to the restored transform
+                body->updateProxyShapeInBroadPhase(shape, true);
+            }
+        }
+    }
+
+    // Order of the states of the rigid bodies (see sortRigidBodiesSpatially())
+    if (mRigidBodyStates.getNbStates() > 0) {
+        uint* order = static_cast<uint*>(mMemoryManager.allocate(MemoryManager::AllocationType::Base,
+                                                                 sizeof(uint) * mRigidBodyStates.getNbStates(),
+                                                                 MemoryTag::Other));
+        for (uint i=0; i < mRigidBodyStates.getNbStates(); i++) {
+            order[i] = mRigidBodies[reader.read<uint32>()]->mStateIndex;
+        }
+        mRigidBodyStates.reorder(order);
+        mMemoryManager.release(MemoryManager::AllocationType::Base, order,
+                               sizeof(uint) * mRigidBodyStates.getNbStates(), MemoryTag::Other);
+    }
+
+    // Dynamic state and persistent islands of the rigid bodies
+    auto readBody = [this, &reader]() {
+        const uint32 index = reader.read<uint32>();
+        return index != STATE_NULL_BODY_INDEX ? mRigidBodies[index] : nullptr;
+    };
+    for (uint i=0; i < mRigidBodies.size(); i++) {
+
+        RigidBody* body = mRigidBodies[i];
+        const uint stateIndex = body->mStateIndex;
+
+        reader.read(mRigidBodyStates.mLinearVelocities[stateIndex]);
+        reader.read(mRigidBodyStates.mAngularVelocities[stateIndex]);
+        reader.read(mRigidBodyStates.mExternalForces[stateIndex]);
+        reader.read(mRigidBodyStates.mExternalTorques[stateIndex]);
+        reader.read(mRigidBodyStates.mCentersOfMassWorld[stateIndex]);
+        reader.read(mRigidBodyStates.mSnapshotTransforms[stateIndex]);
+        reader.read(mRigidBodyStates.mSnapshotLinearVelocities[stateIndex]);
+        reader.read(mRigidBodyStates.mSnapshotAngularVelocities[stateIndex]);
+        reader.read(mRigidBodyStates.mPreviousTransforms[stateIndex]);
+
+        body->mIslandParent = readBody();
+        body->mIslandNextBody = readBody();
+        body->mIslandLastBody = readBody();
+        reader.read(body->mIslandNbBodies);
+        reader.read(body->mIsIslandSplitCandidate);
+        reader.read(body->mIslandSleepTime);
+        reader.read(body->mIsTransformDirty);
+
+        body->updateInertiaTensorInverseWorld();
+    }
+
+    // Joints
+    for (uint i=0; i < mJoints.size(); i++) {
+        mJoints[i]->restoreState(reader);
+    }
+
+    // Overlapping pairs and contacts
+    mCollisionDetection.restoreState(reader, savedProxyShapes);
+    mContactImpulses.clear();
+
+    assert(!reader.canRead(1));
+}
+
+// Return the size in bytes of the saved world
+/// The size changes with the objects of the world and with its state.
+/**
+ * @return The size of the buffer needed by saveWorld()
+ */
+size_t DynamicsWorld::getWorldSizeInBytes() const {
+
+    WorldStateWriter writer(nullptr);
+    writeWorld(writer, nullptr, 0);
+    return writer.getSizeInBytes();
+}
+
+// Write the bodies, proxy shapes, joints and state of the world into a buffer
+/**
+ * The saved world contains the settings of the world that can be changed after its creation,
+ * the bodies with their proxy shapes and their properties, the joints with their settings and
+ * the state of the world (see saveState()). The collision shapes are not saved: a proxy shape
+ * refers to its collision shape by its index in the array of collision shapes given here and
+ * the same array must be given to loadWorld(). The saved world contains no pointer and can
+ * be loaded from anywhere in memory (for instance from a memory-mapped file). The user data
+ * of the objects, the solver iterations policy and the event listener are not saved. This
+ * method must not be called while an update started with startUpdate() is running.
+ * @param buffer Buffer with the size given by getWorldSizeInBytes()
+ * @param shapes Array with all the collision shapes of the proxy shapes of the world
+ * @param nbShapes Number of collision shapes in the array
+ */
+void DynamicsWorld::saveWorld(void* buffer, const CollisionShape* const* shapes, uint nbShapes) const {
+
+    assert(!mIsUpdateRunning);
+
+    FlatMap<const CollisionShape*, uint32> shapeIndices(MemoryManager::getBaseAllocator());
+    shapeIndices.reserve(static_cast<int>(nbShapes));
+    for (uint i=0; i < nbShapes; i++) {
+        shapeIndices.add(Pair<const CollisionShape*, uint32>(shapes[i], i));
+    }
+
+    WorldStateWriter writer(buffer);
+    writeWorld(writer, &shapeIndices, getWorldSizeInBytes());
+}
+
+// Create a new world from a world written by saveWorld()
+/**
+ * The bodies, proxy shapes and joints are created with the same IDs and in the same order
+ * as in the saved world and stepping the new world gives the same results as stepping the
+ * saved one. The proxy shapes are inserted together into the broad-phase. The data is read
+ * in place and is not needed anymore after the call. The collision shapes (and the triangle
+ * meshes of the concave mesh shapes) must outlive the new world.
+ * @param data Pointer to the saved world (written by saveWorld())
+ * @param sizeInBytes Size of the saved world in bytes
+ * @param shapes Array with the collision shapes given to saveWorld() (in the same order)
+ * @param nbShapes Number of collision shapes in the array
+ * @param worldSettings Settings of the new world
+ * @return Pointer to the new world (that must be deleted by the user) or null if the data
+ *         has not been written by this version of the library or refers to a missing shape
+ */
+DynamicsWorld* DynamicsWorld::loadWorld(const void* data, size_t sizeInBytes, CollisionShape* const* shapes,
+                                        uint nbShapes, const WorldSettings& worldSettings) {
+
+    if (data == nullptr) return nullptr;
+
+    WorldStateReader reader(data, sizeInBytes);
+
+    const size_t headerSize = 3 * sizeof(uint32) + sizeof(uint64) + sizeof(Vector3);
+    if (!reader.canRead(headerSize)) return nullptr;
+
+    if (reader.read<uint32>() != WORLD_MAGIC || reader.read<uint32>() != WORLD_VERSION ||
+        reader.read<uint32>() != sizeof(decimal) || reader.read<uint64>() != sizeInBytes) {
+        return nullptr;
+    }
+
+    DynamicsWorld* world = new DynamicsWorld(reader.read<Vector3>(), worldSettings);
+    if (!world->readWorld(reader, shapes, nbShapes)) {
+        delete world;
+        return nullptr;
+    }
+
+    return world;
+}
+
+// Return the size in bytes of a saved rigid body
+/**
+ * @param body Pointer to a rigid body of the world
+ * @return The size of the buffer needed by saveRigidBody()
+ */
+size_t DynamicsWorld::getRigidBodySizeInBytes(const RigidBody* body) const {
+
+    WorldStateWriter writer(nullptr);
+    writeRigidBody(writer, body, nullptr, 0);
+    return writer.getSizeInBytes();
+}
+
+// Write a rigid body with its proxy shapes, its properties and its velocities into a buffer
+/**
+ * This is used to migrate a body to another world (for instance to the world of another
+ * process that simulates a neighbouring region of a larger world): the body is saved here,
+ * destroyed in this world and created in the other world with loadRigidBody(). It can also be
+ * used to create a copy of the body in the other world (a ghost body that is usually made
+ * kinematic and moved with restoreMotions()). As with saveWorld(), the collision shapes are
+ * saved as their indices in the array in parameter and the joints of the body, its user data
+ * and its contacts are not saved.
+ * @param body Pointer to a rigid body of the world
+ * @param buffer Buffer with the size given by getRigidBodySizeInBytes()
+ * @param shapes Array with all the collision shapes of the proxy shapes of the body
+ * @param nbShapes Number of collision shapes in the array
+ */
+void DynamicsWorld::saveRigidBody(const RigidBody* body, void* buffer, const CollisionShape* const* shapes,
+                                  uint nbShapes) const {
+
+    assert(!mIsUpdateRunning);
+
+    FlatMap<const CollisionShape*, uint32> shapeIndices(MemoryManager::getBaseAllocator());
+    shapeIndices.reserve(static_cast<int>(nbShapes));
+    for (uint i=0; i < nbShapes; i++) {
+        shapeIndices.add(Pair<const CollisionShape*, uint32>(shapes[i], i));
+    }
+
+    WorldStateWriter writer(buffer);
+    writeRigidBody(writer, body, &shapeIndices, getRigidBodySizeInBytes(body));
+}
+
+// Create a rigid body in this world from a rigid body written by saveRigidBody()
+/**
+ * The new body has a new ID in this world and the transform, properties and velocities of the
+ * saved body. The data is not needed anymore after the call.
+ * @param data Pointer to the saved rigid body (written by saveRigidBody())
+ * @param sizeInBytes Size of the saved rigid body in bytes
+ * @param shapes Array with the collision shapes given to saveRigidBody() (in the same order)
+ * @param nbShapes Number of collision shapes in the array
+ * @return Pointer to the new rigid body or null if the data has not been written by this
+ *         version of the library or refers to a missing shape
+ */
+RigidBody* DynamicsWorld::loadRigidBody(const void* data, size_t sizeInBytes, CollisionShape* const* shapes,
+                                        uint nbShapes) {
+
+    assert(!mIsUpdateRunning);
+
+    if (data == nullptr) return nullptr;
+
+    WorldStateReader reader(data, sizeInBytes);
+
+    const size_t headerSize = 3 * sizeof(uint32) + sizeof(uint64);
+    if (!reader.canRead(headerSize)) return nullptr;
+
+    if (reader.read<uint32>() != BODY_MAGIC || reader.read<uint32>() != WORLD_VERSION ||
+        reader.read<uint32>() != sizeof(decimal) || reader.read<uint64>() != sizeInBytes) {
+        return nullptr;
+    }
+
+    CollisionBody* body;
+    if (!readBody(reader, true, shapes, nbShapes, body) || !reader.canRead(2 * sizeof(Vector3))) {
+        if (body != nullptr) destroyRigidBody(static_cast<RigidBody*>(body));
+        return nullptr;
+    }
+
+    RigidBody* rigidBody = static_cast<RigidBody*>(body);
+    rigidBody->setLinearVelocity(reader.read<Vector3>());
+    rigidBody->setAngularVelocity(reader.read<Vector3>());
+
+    return rigidBody;
+}
+
+// Return the size in bytes of the saved motions of some rigid bodies
+/**
+ * @param bodies Array of rigid bodies of the world
+ * @param nbBodies Number of rigid bodies in the array
+ * @param baseline Pointer to previously saved motions of the same bodies (or null)
+ * @param quantization Pointer to the quantization of the motions (or null to save exact motions)
+ * @return The size of the buffer needed by saveMotions() with the same parameters
+ */
+size_t DynamicsWorld::getMotionsSizeInBytes(const RigidBody* const* bodies, uint nbBodies, const void* baseline,
+                                            const MotionQuantization* quantization) const {
+
+    WorldStateWriter writer(nullptr);
+    writeMotions(writer, bodies, nbBodies, baseline, quantization);
+    return writer.getSizeInBytes();
+}
+
+// Write the transforms and velocities of some rigid bodies into a buffer
+/**
+ * This is a compact state used to update the copies of bodies simulated by another world
+ * (for instance the kinematic ghost bodies that mirror the bodies near the border of the
+ * region of another process or the bodies of a client replicated over the network). A motion
+ * is written for each body of the array unless a baseline is given: in this case, only the
+ * motions that are different from the ones in the baseline are written (the sleeping bodies
+ * are not written for instance). The baseline is usually the last motions that have been
+ * received by the other world. With a quantization, the positions and velocities are written
+ * as fixed-point integers and the orientations with the smallest-three encoding, and a motion
+ * is only different from the baseline if its quantized values are different (the motions that
+ * only change by less than the precision are not written).
+ * @param bodies Array of rigid bodies of the world
+ * @param nbBodies Number of rigid bodies in the array
+ * @param buffer Buffer with the size given by getMotionsSizeInBytes()
+ * @param baseline Pointer to motions previously saved for the same array of bodies (or null)
+ * @param quantization Pointer to the quantization of the motions (or null to save exact motions)
+ */
+void DynamicsWorld::saveMotions(const RigidBody* const* bodies, uint nbBodies, void* buffer, const void* baseline,
+                                const MotionQuantization* quantization) const {
+
+    WorldStateWriter writer(buffer);
+    writeMotions(writer, bodies, nbBodies, baseline, quantization);
+}
+
+// Set the transforms and velocities of rigid bodies from motions written by saveMotions()
+/**
+ * The array of bodies has the same number of bodies as the one given to saveMotions() and
+ * a body of this array receives the motion of the body at the same index. The bodies can be in
+ * another world. The bodies without a motion in the data (because it was the same as in the
+ * baseline) are not changed. The quantized motions are restored with the quantization written
+ * in the data.
+ * @param bodies Array of rigid bodies
+ * @param nbBodies Number of rigid bodies in the array
+ * @param data Pointer to the saved motions (written by saveMotions())
+ * @param sizeInBytes Size of the saved motions in bytes
+ * @return True if the motions have been applied and false if the data is not valid for
+ *         this number of bodies
+ */
+bool DynamicsWorld::restoreMotions(RigidBody* const* bodies, uint nbBodies, const void* data,
+                                   size_t sizeInBytes) {
+
+    assert(!mIsUpdateRunning);
+
+    if (data == nullptr) return false;
+
+    WorldStateReader reader(data, sizeInBytes);
+
+    MotionQuantization quantization;
+    bool isQuantized;
+    uint32 nbMotions;
+    if (!readMotionsHeader(reader, sizeInBytes, nbBodies, quantization, isQuantized, nbMotions)) return false;
+    if (sizeInBytes != getMotionsHeaderSize(isQuantized) + nbMotions * getMotionSize(isQuantized)) return false;
+
+    for (uint32 i=0; i < nbMotions; i++) {
+
+        const uint32 index = reader.read<uint32>();
+        if (index >= nbBodies) return false;
+
+        RigidBody* body = bodies[index];
+        if (isQuantized) {
+            Vector3 position;
+            Vector3 linearVelocity;
+            Vector3 angularVelocity;
+            position.x = reader.read<int32>() * quantization.positionPrecision;
+            position.y = reader.read<int32>() * quantization.positionPrecision;
+            position.z = reader.read<int32>() * quantization.positionPrecision;
+            const Quaternion orientation = decodeSmallestThree(reader.read<uint32>());
+            linearVelocity.x = reader.read<int32>() * quantization.linearVelocityPrecision;
+            linearVelocity.y = reader.read<int32>() * quantization.linearVelocityPrecision;
+            linearVelocity.z = reader.read<int32>() * quantization.linearVelocityPrecision;
+            angularVelocity.x = reader.read<int32>() * quantization.angularVelocityPrecision;
+            angularVelocity.y = reader.read<int32>() * quantization.angularVelocityPrecision;
+            angularVelocity.z = reader.read<int32>() * quantization.angularVelocityPrecision;
+            body->setTransform(Transform(position, orientation));
+            body->setLinearVelocity(linearVelocity);
+            body->setAngularVelocity(angularVelocity);
+        }
+        else {
+            body->setTransform(reader.read<Transform>());
+            body->setLinearVelocity(reader.read<Vector3>());
+            body->setAngularVelocity(reader.read<Vector3>());
+        }
+    }
+
+    return true;
+}
+
+// Write the bodies, proxy shapes, joints and state of the world (with a given total size in its header)
+/// The collision shapes are written as their indices in the map in parameter (or zero if the
+/// map is null to compute the size).
+void DynamicsWorld::writeWorld(WorldStateWriter& writer, const FlatMap<const CollisionShape*, uint32>* shapeIndices,
+                               uint64 sizeInBytes) const {
+
+    // Header
+    writer.write(WORLD_MAGIC);
+    writer.write(WORLD_VERSION);
+    writer.write(static_cast<uint32>(sizeof(decimal)));
+    writer.write(sizeInBytes);
+
+    // Settings of the world that can be changed after its creation
+    writer.write(mGravity);
+    writer.write(static_cast<uint32>(mNbVelocitySolverIterations));
+    writer.write(static_cast<uint32>(mNbPositionSolverIterations));
+    writer.write(mIsSleepingEnabled);
+    writer.write(mIsGravityEnabled);
+    writer.write(mSleepLinearVelocity);
+    writer.write(mSleepAngularVelocity);
+    writer.write(mTimeBeforeSleep);
+    writer.write(mContactSolver.isSplitImpulseActive());
+
+    uint32 nbProxyShapes = 0;
+    for (uint i=0; i < mBodies.size(); i++) {
+        nbProxyShapes += mBodies[i]->mNbCollisionShapes;
+    }
+    writer.write(static_cast<uint32>(mBodies.size()));
+    writer.write(static_cast<uint32>(mRigidBodies.size()));
+    writer.write(nbProxyShapes);
+
+    List<bool> isRigidBody(MemoryManager::getBaseAllocator(), mBodies.size());
+    for (uint i=0; i < mBodies.size(); i++) {
+        isRigidBody.add(false);
+    }
+    for (uint i=0; i < mRigidBodies.size(); i++) {
+        isRigidBody[mRigidBodies[i]->mWorldIndex] = true;
+    }
+
+    // Bodies and their proxy shapes
+    for (uint i=0; i < mBodies.size(); i++) {
+        writer.write(isRigidBody[i]);
+        writer.write(mBodies[i]->mID);
+        writeBody(writer, mBodies[i], isRigidBody[i], shapeIndices);
+    }
+    mBodyIdAllocator.save(writer);
+
+    // Order of the rigid bodies
+    for (uint i=0; i < mRigidBodies.size(); i++) {
+        writer.write(static_cast<uint32>(mRigidBodies[i]->mWorldIndex));
+    }
+
+    // Joints (their types are written first to allocate their memory block at once)
+    writer.write(static_cast<uint32>(mJoints.size()));
+    for (uint i=0; i < mJoints.size(); i++) {
+        writer.write(mJoints[i]->getType());
+    }
+    for (uint i=0; i < mJoints.size(); i++) {
+
+        const Joint* joint = mJoints[i];
+
+        writer.write(joint->mId);
+        writer.write(static_cast<uint32>(joint->mBody1->mRigidBodyIndex));
+        writer.write(static_cast<uint32>(joint->mBody2->mRigidBodyIndex));
+        joint->saveSettings(writer);
+    }
+    mJointIdAllocator.save(writer);
+
+    // State of the world
+    WorldStateWriter stateSizeWriter(nullptr);
+    writeState(stateSizeWriter, 0);
+    const uint64 stateSize = stateSizeWriter.getSizeInBytes();
+    writer.write(stateSize);
+    writeState(writer, stateSize);
+}
+
+// Write a rigid body with its velocities (with a given total size in its header)
+/// The collision shapes are written as their indices in the map in parameter (or zero if the
+/// map is null to compute the size).
+void DynamicsWorld::writeRigidBody(WorldStateWriter& writer, const RigidBody* body,
+                                   const FlatMap<const CollisionShape*, uint32>* shapeIndices,
+                                   uint64 sizeInBytes) const {
+
+    // Header
+    writer.write(BODY_MAGIC);
+    writer.write(WORLD_VERSION);
+    writer.write(static_cast<uint32>(sizeof(decimal)));
+    writer.write(sizeInBytes);
+
+    writeBody(writer, body, true, shapeIndices);
+    writer.write(body->getLinearVelocity());
+    writer.write(body->getAngularVelocity());
+}
+
+// Write the motions of rigid bodies that are different from the ones of a baseline
+/// The motions are compared with the ones of the baseline once written (quantized or not). The
+/// motions of the baseline are sorted by index of body and are read together with the bodies
+/// of the array. A baseline written for another number of bodies or with another quantization
+/// is ignored.
+void DynamicsWorld::writeMotions(WorldStateWriter& writer, const RigidBody* const* bodies, uint nbBodies,
+                                 const void* baseline, const MotionQuantization* quantization) const {
+
+    const bool isQuantized = quantization != nullptr;
+    assert(!isQuantized || (quantization->positionPrecision > decimal(0.0) &&
+                            quantization->linearVelocityPrecision > decimal(0.0) &&
+                            quantization->angularVelocityPrecision > decimal(0.0)));
+    const size_t headerSize = getMotionsHeaderSize(isQuantized);
+    const size_t motionSize = getMotionSize(isQuantized);
+    assert(motionSize <= MAX_MOTION_SIZE);
+
+    // Number of motions in the baseline (if it is valid for this array of bodies)
+    uint32 nbBaselineMotions = 0;
+    const unsigned char* baselineMotions = static_cast<const unsigned char*>(baseline) + headerSize;
+    if (baseline != nullptr) {
+        WorldStateReader baselineReader(baseline, headerSize);
+        MotionQuantization baselineQuantization;
+        bool isBaselineQuantized;
+        uint32 nbMotions;
+        if (readMotionsHeader(baselineReader, headerSize, nbBodies, baselineQuantization, isBaselineQuantized,
+                              nbMotions) && isBaselineQuantized == isQuantized &&
+            (!isQuantized || (baselineQuantization.positionPrecision == quantization->positionPrecision &&
+                              baselineQuantization.linearVelocityPrecision == quantization->linearVelocityPrecision &&
+                              baselineQuantization.angularVelocityPrecision == quantization->angularVelocityPrecision))) {
+            nbBaselineMotions = nbMotions;
+        }
+    }
+
+    // The motions are counted in a first pass and written after the header in a second pass
+    uint32 nbMotions = 0;
+    for (uint32 pass=0; pass < 2; pass++) {
+
+        if (pass == 1) {
+
+            // Header
+            writer.write(isQuantized ? QUANTIZED_MOTIONS_MAGIC : MOTIONS_MAGIC);
+            writer.write(static_cast<uint32>(sizeof(decimal)));
+            writer.write(static_cast<uint32>(nbBodies));
+            if (isQuantized) {
+                writer.write(quantization->positionPrecision);
+                writer.write(quantization->linearVelocityPrecision);
+                writer.write(quantization->angularVelocityPrecision);
+            }
+            writer.write(nbMotions);
+        }
+
+        uint32 baselineIndex = 0;
+        for (uint32 i=0; i < nbBodies; i++) {
+
+            unsigned char motion[MAX_MOTION_SIZE];
+            WorldStateWriter motionWriter(motion);
+            writeMotion(motionWriter, i, bodies[i], quantization);
+
+            // Skip the motion if it is the same as in the baseline
+            bool isInBaseline = false;
+            while (baselineIndex < nbBaselineMotions) {
+
+                const unsigned char* baselineMotion = baselineMotions + baselineIndex * motionSize;
+                uint32 index;
+                std::memcpy(&index, baselineMotion, sizeof(uint32));
+                if (index > i) break;
+                baselineIndex++;
+                if (index == i) {
+                    isInBaseline = std::memcmp(baselineMotion, motion, motionSize) == 0;
+                    break;
+                }
+            }
+            if (isInBaseline) continue;
+
+            if (pass == 0) {
+                nbMotions++;
+            }
+            else {
+                writeMotion(writer, i, bodies[i], quantization);
+            }
+        }
+    }
+}
+
+// Create the bodies, proxy shapes and joints of a saved world and restore its state
+/// The reader is after the gravity of the header written by writeWorld(). This method returns
+/// false if the data is truncated, if it refers to a missing collision shape, body or joint
+/// or if the state is not valid.
+bool DynamicsWorld::readWorld(WorldStateReader& reader, CollisionShape* const* shapes, uint nbShapes) {
+
+    const size_t settingsSize = 5 * sizeof(uint32) + 3 * sizeof(bool) + sizeof(mSleepLinearVelocity) +
+                                sizeof(mSleepAngularVelocity) + sizeof(mTimeBeforeSleep);
+    if (!reader.canRead(settingsSize)) return false;
+
+    // Settings of the world that can be changed after its creation
+    mNbVelocitySolverIterations = reader.read<uint32>();
+    mNbPositionSolverIterations = reader.read<uint32>();
+    reader.read(mIsSleepingEnabled);
+    reader.read(mIsGravityEnabled);
+    reader.read(mSleepLinearVelocity);
+    reader.read(mSleepAngularVelocity);
+    reader.read(mTimeBeforeSleep);
+    mContactSolver.setIsSplitImpulseActive(reader.read<bool>());
+
+    // Reserve the memory of all the objects
+    const uint32 nbBodies = reader.read<uint32>();
+    const uint32 nbRigidBodies = reader.read<uint32>();
+    WorldCapacities capacities;
+    capacities.nbBodies = nbBodies;
+    capacities.nbProxyShapes = reader.read<uint32>();
+
+    // Do not reserve the memory of objects that cannot be in the data
+    const size_t minBodiesSize = static_cast<size_t>(nbBodies) * (sizeof(bool) + sizeof(bodyindex)) +
+                                 static_cast<size_t>(capacities.nbProxyShapes) * (sizeof(uint32) + sizeof(Transform));
+    if (nbRigidBodies > nbBodies || !reader.canRead(minBodiesSize)) return false;
+    reserve(capacities);
+
+    // Create the bodies in the same order and insert their proxy shapes together into the
+    // broad-phase. The bodies get their saved IDs once the ID allocator has been restored so
+    // that a world that is not completely read can still be destroyed.
+    bool isValid = true;
+    mCollisionDetection.beginProxyShapesBatch();
+    List<bodyindex> savedBodyIds(mMemoryManager.getPoolAllocator(MemoryTag::Other), nbBodies);
+    List<bool> isUnorderedRigidBody(mMemoryManager.getPoolAllocator(MemoryTag::Other), nbBodies);
+    for (uint32 i=0; i < nbBodies && isValid; i++) {
+
+        if (!reader.canRead(sizeof(bool) + sizeof(bodyindex))) {
+            isValid = false;
+            break;
+        }
+        const bool isRigidBody = reader.read<bool>();
+        savedBodyIds.add(reader.read<bodyindex>());
+        isUnorderedRigidBody.add(isRigidBody);
+
+        CollisionBody* body;
+        isValid = readBody(reader, isRigidBody, shapes, nbShapes, body);
+    }
+    mCollisionDetection.endProxyShapesBatch();
+    if (!isValid) return false;
+
+    if (!mBodyIdAllocator.restore(reader, savedBodyIds)) return false;
+    for (uint32 i=0; i < nbBodies; i++) {
+        mBodies[i]->mID = savedBodyIds[i];
+    }
+
+    // The rigid bodies are in the same order as in the saved world. The saved indices are all
+    // checked (each one must refer to a different rigid body) before the order is changed.
+    if (nbRigidBodies != mRigidBodies.size() || !reader.canRead(nbRigidBodies * sizeof(uint32))) return false;
+    List<uint32> rigidBodiesOrder(mMemoryManager.getPoolAllocator(MemoryTag::Other), nbRigidBodies);
+    for (uint32 i=0; i < nbRigidBodies; i++) {
+        const uint32 bodyIndex = reader.read<uint32>();
+        if (bodyIndex >= nbBodies || !isUnorderedRigidBody[bodyIndex]) return false;
+        isUnorderedRigidBody[bodyIndex] = false;
+        rigidBodiesOrder.add(bodyIndex);
+    }
+    for (uint32 i=0; i < nbRigidBodies; i++) {
+        RigidBody* rigidBody = static_cast<RigidBody*>(mBodies[rigidBodiesOrder[i]]);
+        mRigidBodies[i] = rigidBody;
+        rigidBody->mRigidBodyIndex = i;
+    }
+
+    // Create the joints into a single memory block (with the saved IDs once the ID allocator
+    // has been restored)
+    if (!reader.canRead(sizeof(uint32))) return false;
+    const uint32 nbJoints = reader.read<uint32>();
+    List<jointindex> savedJointIds(mMemoryManager.getPoolAllocator(MemoryTag::Other), nbJoints);
+    if (nbJoints > 0) {
+
+        if (!reader.canRead(nbJoints * sizeof(JointType))) return false;
+        List<JointType> jointTypes(mMemoryManager.getPoolAllocator(MemoryTag::Other), nbJoints);
+        size_t nbBytes = alignBlockSize(sizeof(JointsBlock));
+        for (uint32 i=0; i < nbJoints; i++) {
+            jointTypes.add(reader.read<JointType>());
+            if (static_cast<uint>(jointTypes[i]) >= NB_JOINT_TYPES) return false;
+            nbBytes += alignBlockSize(getJointSizeInBytes(jointTypes[i]));
+        }
+
+        char* memory = static_cast<char*>(mMemoryManager.allocate(MemoryManager::AllocationType::Base, nbBytes,
+                                                                  MemoryTag::Solver));
+        JointsBlock* block = new (memory) JointsBlock();
+        block->nbJoints = 0;
+        block->nbBytes = nbBytes;
+        memory += alignBlockSize(sizeof(JointsBlock));
+
+        for (uint32 i=0; i < nbJoints; i++) {
+
+            const JointType type = jointTypes[i];
+            if (!reader.canRead(sizeof(jointindex) + 2 * sizeof(uint32))) {
+                isValid = false;
+                break;
+            }
+            savedJointIds.add(reader.read<jointindex>());
+            const uint32 body1Index = reader.read<uint32>();
+            const uint32 body2Index = reader.read<uint32>();
+            if (body1Index >= nbRigidBodies || body2Index >= nbRigidBodies || body1Index == body2Index) {
+                isValid = false;
+                break;
+            }
+
+            // The joint is constructed with default settings that are then replaced by the saved ones
+            Joint* joint = constructJointWithDefaultSettings(type, mJointIdAllocator.allocate(),
+                                                             mRigidBodies[body1Index], mRigidBodies[body2Index],
+                                                             memory);
+            WorldStateWriter settingsWriter(nullptr);
+            joint->saveSettings(settingsWriter);
+            if (!reader.canRead(settingsWriter.getSizeInBytes())) {
+                mJointIdAllocator.release(joint->getId());
+                joint->~Joint();
+                isValid = false;
+                break;
+            }
+            joint->restoreSettings(reader);
+            joint->mBlock = block;
+            memory += alignBlockSize(getJointSizeInBytes(type));
+
+            // The block is released when its last joint is destroyed
+            block->nbJoints++;
+            addJoint(joint);
+        }
+
+        // The joints that have been added are destroyed with the world
+        if (block->nbJoints == 0) {
+            mMemoryManager.release(MemoryManager::AllocationType::Base, block, block->nbBytes, MemoryTag::Solver);
+        }
+        if (!isValid) return false;
+    }
+    if (!mJointIdAllocator.restore(reader, savedJointIds)) return false;
+    for (uint32 i=0; i < nbJoints; i++) {
+        mJoints[i]->mId = savedJointIds[i];
+    }
+
+    // State of the world
+    if (!reader.canRead(sizeof(uint64))) return false;
+    const uint64 stateSize = reader.read<uint64>();
+    if (!reader.canRead(static_cast<size_t>(stateSize))) return false;
+    FlatMap<int, ProxyShape*> savedProxyShapes(mMemoryManager.getPoolAllocator(MemoryTag::Other));
+    if (!readStateHeader(reader, static_cast<size_t>(stateSize), savedProxyShapes)) return false;
+    readState(reader, savedProxyShapes);
+
+    return true;
+}
+
+// Write the type, transform, proxy shapes and properties of a body
+/// The collision shapes are written as their indices in the map in parameter (or zero if the
+/// map is null to compute the size). The ID of the body is not written.
+void DynamicsWorld::writeBody(WorldStateWriter& writer, const CollisionBody* body, bool isRigidBody,
+                              const FlatMap<const CollisionShape*, uint32>* shapeIndices) const {
+
+    writer.write(body->mType);
+    writer.write(body->mTransform);
+    writer.write(body->mIsAllowedToSleep);
+    writer.write(body->mIsActive);
+
+    // The proxy shapes are written in the reverse order of the list of the body because
+    // they are added at the beginning of the list
+    List<const ProxyShape*> bodyShapes(MemoryManager::getBaseAllocator());
+    for (const ProxyShape* shape = body->getProxyShapesList(); shape != nullptr; shape = shape->getNext()) {
+        bodyShapes.add(shape);
+    }
+    writer.write(static_cast<uint32>(bodyShapes.size()));
+    for (uint s = bodyShapes.size(); s > 0; s--) {
+
+        const ProxyShape* shape = bodyShapes[s - 1];
+
+        uint32 shapeIndex = 0;
+        if (shapeIndices != nullptr) {
+            assert(shapeIndices->containsKey(shape->mCollisionShape));
+            shapeIndex = (*shapeIndices)[shape->mCollisionShape];
+        }
+        writer.write(shapeIndex);
+        writer.write(shape->mLocalToBodyTransform);
+        writer.write(shape->mMass);
+        writer.write(shape->mCollisionCategoryBits);
+        writer.write(shape->mCollideWithMaskBits);
+        writer.write(shape->mIsTrigger);
+        writer.write(shape->mIsQueryOnly);
+    }
+
+    // Mass properties and settings of a rigid body
+    if (isRigidBody) {
+
+        const RigidBody* rigidBody = static_cast<const RigidBody*>(body);
+        writer.write(rigidBody->mInitMass);
+        writer.write(rigidBody->mMassInverse);
+        writer.write(rigidBody->mCenterOfMassLocal);
+        writer.write(rigidBody->mUserInertiaTensorLocalInverse);
+        writer.write(rigidBody->mInertiaTensorLocalInverse);
+        writer.write(rigidBody->mIsCenterOfMassSetByUser);
+        writer.write(rigidBody->mIsInertiaTensorSetByUser);
+        writer.write(rigidBody->mIsGravityEnabled);
+        writer.write(rigidBody->mIsBullet);
+        writer.write(static_cast<uint32>(rigidBody->mSimulationLevelOfDetail));
+        writer.write(rigidBody->mMaterial.getFrictionCoefficient());
+        writer.write(rigidBody->mMaterial.getRollingResistance());
+        writer.write(rigidBody->mMaterial.getBounciness());
+        writer.write(rigidBody->mLinearDamping);
+        writer.write(rigidBody->mAngularDamping);
+    }
+}
+
+// Create a body with the type, transform, proxy shapes and properties written by writeBody()
+/// The body is created with a new ID. This method returns false if the data is truncated, if
+/// the type or the level of detail of the body is not valid or if a proxy shape refers to a
+/// missing collision shape. In this case, the body is null if it has not been created yet. Otherwise, it has been created (with only a part of its proxy shapes)
+/// and must be destroyed by the caller.
+bool DynamicsWorld::readBody(WorldStateReader& reader, bool isRigidBody, CollisionShape* const* shapes,
+                             uint nbShapes, CollisionBody*& body) {
+
+    body = nullptr;
+
+    const size_t bodySize = sizeof(BodyType) + sizeof(Transform) + 2 * sizeof(bool) + sizeof(uint32);
+    if (!reader.canRead(bodySize)) return false;
+
+    const BodyType type = reader.read<BodyType>();
+    if (type != BodyType::STATIC && type != BodyType::KINEMATIC && type != BodyType::DYNAMIC) return false;
+    const Transform transform = reader.read<Transform>();
+
+    body = isRigidBody ? createRigidBody(transform) : createCollisionBody(transform);
+    reader.read(body->mIsAllowedToSleep);
+    const bool isActive = reader.read<bool>();
+    if (isRigidBody) {
+        static_cast<RigidBody*>(body)->setType(type);
+    }
+    else {
+        body->setType(type);
+    }
+
+    const uint32 nbBodyShapes = reader.read<uint32>();
+    const size_t shapeSize = sizeof(uint32) + sizeof(Transform) + sizeof(decimal) +
+                             sizeof(ProxyShape::mCollisionCategoryBits) + sizeof(ProxyShape::mCollideWithMaskBits) +
+                             2 * sizeof(bool);
+    for (uint32 s=0; s < nbBodyShapes; s++) {
+
+        if (!reader.canRead(shapeSize)) return false;
+
+        const uint32 shapeIndex = reader.read<uint32>();
+        const Transform shapeTransform = reader.read<Transform>();
+        const decimal mass = reader.read<decimal>();
+        if (shapeIndex >= nbShapes) return false;
+
+        ProxyShape* shape = isRigidBody ?
+                    static_cast<RigidBody*>(body)->addCollisionShape(shapes[shapeIndex], shapeTransform, mass) :
+                    body->addCollisionShape(shapes[shapeIndex], shapeTransform);
+        reader.read(shape->mCollisionCategoryBits);
+        reader.read(shape->mCollideWithMaskBits);
+        reader.read(shape->mIsTrigger);
+        shape->setIsQueryOnly(reader.read<bool>());
+    }
+
+    // Mass properties and settings of a rigid body
+    if (isRigidBody) {
+
+        RigidBody* rigidBody = static_cast<RigidBody*>(body);
+        const size_t rigidBodySize = sizeof(rigidBody->mInitMass) + sizeof(rigidBody->mMassInverse) +
+                                     sizeof(rigidBody->mCenterOfMassLocal) +
+                                     sizeof(rigidBody->mUserInertiaTensorLocalInverse) +
+                                     sizeof(rigidBody->mInertiaTensorLocalInverse) + 4 * sizeof(bool) +
+                                     sizeof(uint32) + 3 * sizeof(decimal) + sizeof(rigidBody->mLinearDamping) +
+                                     sizeof(rigidBody->mAngularDamping);
+        if (!reader.canRead(rigidBodySize)) return false;
+
+        reader.read(rigidBody->mInitMass);
+        reader.read(rigidBody->mMassInverse);
+        reader.read(rigidBody->mCenterOfMassLocal);
+        reader.read(rigidBody->mUserInertiaTensorLocalInverse);
+        reader.read(rigidBody->mInertiaTensorLocalInverse);
+        reader.read(rigidBody->mIsCenterOfMassSetByUser);
+        reader.read(rigidBody->mIsInertiaTensorSetByUser);
+        reader.read(rigidBody->mIsGravityEnabled);
+        reader.read(rigidBody->mIsBullet);
+        const uint32 levelOfDetail = reader.read<uint32>();
+        if (levelOfDetail >= NB_SIMULATION_LEVELS_OF_DETAIL) return false;
+        rigidBody->mSimulationLevelOfDetail = levelOfDetail;
+        rigidBody->mMaterial.setFrictionCoefficient(reader.read<decimal>());
+        rigidBody->mMaterial.setRollingResistance(reader.read<decimal>());
+        rigidBody->mMaterial.setBounciness(reader.read<decimal>());
+        reader.read(rigidBody->mLinearDamping);
+        reader.read(rigidBody->mAngularDamping);
+    }
+
+    if (!isActive) {
+        body->setIsActive(false);
+    }
+
+    return true;
+}
+
+// Write the state of the world (with a given total size in its header)
+/// The header describes the bodies, proxy shapes and joints of the world so that a state
+/// is only restored into a world with the same objects.
+void DynamicsWorld::writeState(WorldStateWriter& writer, uint64 sizeInBytes) const {
+
+    const BroadPhaseAlgorithm* broadPhase = mCollisionDetection.mBroadPhaseAlgorithm;
+
+    // Header
+    writer.write(STATE_MAGIC);
+    writer.write(STATE_VERSION);
+    writer.write(static_cast<uint32>(sizeof(decimal)));
+    writer.write(sizeInBytes);
+    writer.write(static_cast<uint32>(mBodies.size()));
+    writer.write(static_cast<uint32>(mRigidBodies.size()));
+    writer.write(static_cast<uint32>(mJoints.size()));
+    for (uint i=0; i < mBodies.size(); i++) {
+        writer.write(mBodies[i]->getId());
+        uint32 nbProxyShapes = 0;
+        for (const ProxyShape* shape = mBodies[i]->getProxyShapesList(); shape != nullptr; shape = shape->getNext()) {
+            if (shape->getBroadPhaseId() != -1) nbProxyShapes++;
+        }
+        writer.write(nbProxyShapes);
+        for (const ProxyShape* shape = mBodies[i]->getProxyShapesList(); shape != nullptr; shape = shape->getNext()) {
+            if (shape->getBroadPhaseId() != -1) writer.write(static_cast<int32>(shape->getBroadPhaseId()));
+        }
+    }
+    for (uint i=0; i < mJoints.size(); i++) {
+        writer.write(static_cast<uint32>(mJoints[i]->getType()));
+    }
+
+    // World
+    writer.write(mOrigin);
+    writer.write(mNbStepsSinceExactOrientationNormalization);
+    writer.write(mNbStepsSinceSpatialSort);
+    writer.write(mLevelsOfDetailStepCounter);
+    for (uint i=0; i < NB_SIMULATION_LEVELS_OF_DETAIL; i++) {
+        writer.write(mLevelsOfDetailTimeSteps[i]);
+    }
+    writer.write(mIslandToSplit != nullptr ? static_cast<uint32>(mIslandToSplit->mRigidBodyIndex) : STATE_NULL_BODY_INDEX);
+    writer.write(mIsIslandsRebuildRequested);
+    broadPhase->saveState(writer);
+
+    // Bodies and their proxy shapes
+    for (uint i=0; i < mBodies.size(); i++) {
+
+        const CollisionBody* body = mBodies[i];
+
+        writer.write(body->mTransform);
+        writer.write(body->mIsSleeping);
+        writer.write(body->mSleepTime);
+        writer.write(body->mIsConstraintRemoved);
+
+        for (const ProxyShape* shape = body->getProxyShapesList(); shape != nullptr; shape = shape->getNext()) {
+            if (shape->getBroadPhaseId() != -1) {
+                broadPhase->saveProxyShapeState(shape, writer);
+            }
+        }
+    }
+
+    // Order of the states of the rigid bodies (see sortRigidBodiesSpatially())
+    for (uint i=0; i < mRigidBodyStates.getNbStates(); i++) {
+        writer.write(static_cast<uint32>(mRigidBodyStates.mBodies[i]->mRigidBodyIndex));
+    }
+
+    // Dynamic state and persistent islands of the rigid bodies
+    auto writeBody = [&writer](const RigidBody* body) {
+        writer.write(body != nullptr ? static_cast<uint32>(body->mRigidBodyIndex) : STATE_NULL_BODY_INDEX);
+    };
+    for (uint i=0; i < mRigidBodies.size(); i++) {
+
+        const RigidBody* body = mRigidBodies[i];
+        const uint stateIndex = body->mStateIndex;
+
+        writer.write(mRigidBodyStates.mLinearVelocities[stateIndex]);
+        writer.write(mRigidBodyStates.mAngularVelocities[stateIndex]);
+        writer.write(mRigidBodyStates.mExternalForces[stateIndex]);
+        writer.write(mRigidBodyStates.mExternalTorques[stateIndex]);
+        writer.write(mRigidBodyStates.mCentersOfMassWorld[stateIndex]);
+        writer.write(mRigidBodyStates.mSnapshotTransforms[stateIndex]);
+        writer.write(mRigidBodyStates.mSnapshotLinearVelocities[stateIndex]);
+        writer.write(mRigidBodyStates.mSnapshotAngularVelocities[stateIndex]);
+        writer.write(mRigidBodyStates.mPreviousTransforms[stateIndex]);
+
+        writeBody(body->mIslandParent);
+        writeBody(body->mIslandNextBody);
+        writeBody(body->mIslandLastBody);
+        writer.write(body->mIslandNbBodies);
+        writer.write(body->mIsIslandSplitCandidate);
+        writer.write(body->mIslandSleepTime);
+        writer.write(body->mIsTransformDirty);
+    }
+
+    // Joints
+    for (uint i=0; i < mJoints.size(); i++) {
+        mJoints[i]->saveState(writer);
+    }
+
+    // Overlapping pairs and contacts
+    mCollisionDetection.saveState(writer);
+}
+
+// Read the header of a saved state and return false if it has not been written for the
+// current bodies, proxy shapes and joints
+/// The proxy shapes of the world are mapped to the broad-phase IDs they had when the state
+/// has been saved and the reader is left at the beginning of the content of the state. The
+/// content is also checked (see checkStateContent()) so that readState() never fails after
+/// it has started to modify the world.
+bool DynamicsWorld::readStateHeader(WorldStateReader& reader, size_t sizeInBytes,
+                                    FlatMap<int, ProxyShape*>& savedProxyShapes) const {
+
+    const size_t headerSize = 6 * sizeof(uint32) + sizeof(uint64);
+    if (!reader.canRead(headerSize)) return false;
+
+    if (reader.read<uint32>() != STATE_MAGIC || reader.read<uint32>() != STATE_VERSION ||
+        reader.read<uint32>() != sizeof(decimal) || reader.read<uint64>() != sizeInBytes ||
+        reader.read<uint32>() != mBodies.size() || reader.read<uint32>() != mRigidBodies.size() ||
+        reader.read<uint32>() != mJoints.size()) {
+        return false;
+    }
+
+    // The bodies must have the same IDs and the same number of proxy shapes in the broad-phase
+    for (uint i=0; i < mBodies.size(); i++) {
+
+        if (!reader.canRead(sizeof(bodyindex) + sizeof(uint32))) return false;
+        if (reader.read<bodyindex>() != mBodies[i]->getId()) return false;
+
+        uint32 nbProxyShapes = reader.read<uint32>();
+        for (ProxyShape* shape = mBodies[i]->getProxyShapesList(); shape != nullptr; shape = shape->getNext()) {
+            if (shape->getBroadPhaseId() == -1) continue;
+            if (nbProxyShapes == 0 || !reader.canRead(sizeof(int32))) return false;
+            const int32 savedBroadPhaseId = reader.read<int32>();
+            if (savedProxyShapes.containsKey(savedBroadPhaseId)) return false;
+            savedProxyShapes.add(Pair<int, ProxyShape*>(savedBroadPhaseId, shape));
+            nbProxyShapes--;
+        }
+        if (nbProxyShapes != 0) return false;
+    }
+
+    // The joints must have the same types
+    for (uint i=0; i < mJoints.size(); i++) {
+        if (!reader.canRead(sizeof(uint32)) || reader.read<uint32>() != static_cast<uint32>(mJoints[i]->getType())) {
+            return false;
+        }
+    }
+
+    // The content is checked with a copy of the reader
+    WorldStateReader contentReader = reader;
+    return checkStateContent(contentReader, savedProxyShapes);
+}
+
+// Skip the content of a saved state after its header and return false if readState() cannot read it
+/// The content cannot be read if it is truncated or too long, if it contains the index of a
+/// missing rigid body, if the order of the states is not a permutation of the rigid bodies
+/// or if the overlapping pairs are not valid. The world is not modified.
+bool DynamicsWorld::checkStateContent(WorldStateReader& reader, const FlatMap<int, ProxyShape*>& savedProxyShapes) const {
+
+    const uint32 nbRigidBodies = static_cast<uint32>(mRigidBodies.size());
+    auto checkBodyIndex = [&reader, nbRigidBodies]() {
+        if (!reader.canRead(sizeof(uint32))) return false;
+        const uint32 index = reader.read<uint32>();
+        return index == STATE_NULL_BODY_INDEX || index < nbRigidBodies;
+    };
+
+    // World
+    const size_t worldSize = sizeof(mOrigin) + sizeof(mNbStepsSinceExactOrientationNormalization) +
+                             sizeof(mNbStepsSinceSpatialSort) + sizeof(mLevelsOfDetailStepCounter) +
+                             sizeof(mLevelsOfDetailTimeSteps);
+    if (!reader.canRead(worldSize)) return false;
+    reader.skip(worldSize);
+    if (!checkBodyIndex()) return false;
+    WorldStateWriter broadPhaseWriter(nullptr);
+    mCollisionDetection.mBroadPhaseAlgorithm->saveState(broadPhaseWriter);
+    const size_t broadPhaseSize = sizeof(mIsIslandsRebuildRequested) + broadPhaseWriter.getSizeInBytes();
+    if (!reader.canRead(broadPhaseSize)) return false;
+    reader.skip(broadPhaseSize);
+
+    // Bodies and their proxy shapes
+    for (uint i=0; i < mBodies.size(); i++) {
+
+        const CollisionBody* body = mBodies[i];
+
+        WorldStateWriter bodyWriter(nullptr);
+        bodyWriter.write(body->mTransform);
+        bodyWriter.write(body->mIsSleeping);
+        bodyWriter.write(body->mSleepTime);
+        bodyWriter.write(body->mIsConstraintRemoved);
+        for (const ProxyShape* shape = body->getProxyShapesList(); shape != nullptr; shape = shape->getNext()) {
+            if (shape->getBroadPhaseId() != -1) {
+                mCollisionDetection.mBroadPhaseAlgorithm->saveProxyShapeState(shape, bodyWriter);
+            }
+        }
+        if (!reader.canRead(bodyWriter.getSizeInBytes())) return false;
+        reader.skip(bodyWriter.getSizeInBytes());
+    }
+
+    // Order of the states of the rigid bodies (each rigid body exactly once)
+    if (mRigidBodyStates.getNbStates() != nbRigidBodies) return false;
+    List<bool> isOrderedRigidBody(MemoryManager::getBaseAllocator(), nbRigidBodies);
+    for (uint32 i=0; i < nbRigidBodies; i++) {
+        isOrderedRigidBody.add(false);
+    }
+    for (uint32 i=0; i < nbRigidBodies; i++) {
+        if (!reader.canRead(sizeof(uint32))) return false;
+        const uint32 index = reader.read<uint32>();
+        if (index >= nbRigidBodies || isOrderedRigidBody[index]) return false;
+        isOrderedRigidBody[index] = true;
+    }
+
+    // Dynamic state and persistent islands of the rigid bodies
+    for (uint i=0; i < mRigidBodies.size(); i++) {
+
+        const RigidBody* body = mRigidBodies[i];
+
+        const size_t stateSize = 7 * sizeof(Vector3) + 2 * sizeof(Transform);
+        if (!reader.canRead(stateSize)) return false;
+        reader.skip(stateSize);
+
+        if (!checkBodyIndex() || !checkBodyIndex() || !checkBodyIndex()) return false;
+
+        const size_t islandSize = sizeof(body->mIslandNbBodies) + sizeof(body->mIsIslandSplitCandidate) +
+                                  sizeof(body->mIslandSleepTime) + sizeof(body->mIsTransformDirty);
+        if (!reader.canRead(islandSize)) return false;
+        reader.skip(islandSize);
+    }
+
+    // Joints
+    for (uint i=0; i < mJoints.size(); i++) {
+        WorldStateWriter jointWriter(nullptr);
+        mJoints[i]->saveState(jointWriter);
+        if (!reader.canRead(jointWriter.getSizeInBytes())) return false;
+        reader.skip(jointWriter.getSizeInBytes());
+    }
+
+    // Overlapping pairs and contacts
+    if (!mCollisionDetection.checkState(reader, savedProxyShapes)) return false;
+
+    return !reader.canRead(1);
+}
@@ -0,0 +1,138 @@
+/********************************************************************************
+* ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
+* Copyright (c) 2010-2018 Daniel Chappuis                                       *
+*********************************************************************************
+*                                                                               *
+* This software is provided 'as-is', without any express or implied warranty.   *
+* In no event will the authors be held liable for any damages arising from the  *
+* use of this software.                                                         *
+*                                                                               *
+* Permission is granted to anyone to use this software for any purpose,         *
+* including commercial applications, and to alter it and redistribute it        *
+* freely, subject to the following restrictions:                                *
+*                                                                               *
+* 1. The origin of this software must not be misrepresented; you must not claim *
+*    that you wrote the original software. If you use this software in a        *
+*    product, an acknowledgment in the product documentation would be           *
+*    appreciated but is not required.                                           *
+*                                                                               *
+* 2. Altered source versions must be plainly marked as such, and must not be    *
+*    misrepresented as being the original software.                             *
+*                                                                               *
+* 3. This notice may not be removed or altered from any source distribution.    *
+*                                                                               *
+********************************************************************************/
+
+#ifndef REACTPHYSICS3D_WORLD_STATE_H
+#define REACTPHYSICS3D_WORLD_STATE_H
+
+// Libraries
+#include "configuration.h"
+#include <cstring>
+
+/// ReactPhysics3D namespace
+namespace reactphysics3d {
+
+// Class WorldStateWriter
+/**
+ * This class writes the values of the state of a world one after the other into a
+ * binary buffer (see DynamicsWorld::saveState()). The values are copied byte by byte
+ * and must therefore not contain pointers. If the buffer is null, the values are not
+ * written but their size is still counted.
+ */
+class WorldStateWriter {
+
+    private:
+
+        // -------------------- Attributes -------------------- //
+
+        /// Buffer where the values are written (null to only count their size)
+        unsigned char* mBuffer;
+
+        /// Number of bytes written so far
+        size_t mSizeInBytes;
+
+    public:
+
+        // -------------------- Methods -------------------- //
+
+        /// Constructor
+        WorldStateWriter(void* buffer)
+            : mBuffer(static_cast<unsigned char*>(buffer)), mSizeInBytes(0) {
+
+        }
+
+        /// Write a value
+        template<typename T>
+        void write(const T& value) {
+            if (mBuffer != nullptr) std::memcpy(mBuffer + mSizeInBytes, &value, sizeof(T));
+            mSizeInBytes += sizeof(T);
+        }
+
+        /// Return the number of bytes written so far
+        size_t getSizeInBytes() const {
+            return mSizeInBytes;
+        }
+};
+
+// Class WorldStateReader
+/**
+ * This class reads the values of the state of a world in the order in which they have
+ * been written by a WorldStateWriter (see DynamicsWorld::restoreState()).
+ */
+class WorldStateReader {
+
+    private:
+
+        // -------------------- Attributes -------------------- //
+
+        /// Data of the state
+        const unsigned char* mData;
+
+        /// Size of the data in bytes
+        size_t mSizeInBytes;
+
+        /// Number of bytes read so far
+        size_t mOffset;
+
+    public:
+
+        // -------------------- Methods -------------------- //
+
+        /// Constructor
+        WorldStateReader(const void* data, size_t sizeInBytes)
+            : mData(static_cast<const unsigned char*>(data)), mSizeInBytes(sizeInBytes), mOffset(0) {
+
+        }
+
+        /// Read a value
+        template<typename T>
+        void read(T& value) {
+            assert(mOffset + sizeof(T) <= mSizeInBytes);
+            std::memcpy(static_cast<void*>(&value), mData + mOffset, sizeof(T));
+            mOffset += sizeof(T);
+        }
+
+        /// Read and return a value
+        template<typename T>
+        T read() {
+            T value;
+            read(value);
+            return value;
+        }
+
+        /// Skip a given number of bytes
+        void skip(size_t sizeInBytes) {
+            assert(mOffset + sizeInBytes <= mSizeInBytes);
+            mOffset += sizeInBytes;
+        }
+
+        /// Return true if a given number of bytes can still be read
+        bool canRead(size_t sizeInBytes) const {
+            return mOffset + sizeInBytes <= mSizeInBytes;
+        }
+};
+
+}
+
+#endif
@@ -0,0 +1,431 @@
+/********************************************************************************
+* ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
+* Copyright (c) 2010-2018 Daniel Chappuis                                       *
+*********************************************************************************
+*                                                                               *
+* This software is provided 'as-is', without any express or implied warranty.   *
+* In no event will the authors be held liable for any damages arising from the  *
+* use of this software.                                                         *
+*                                                                               *
+* Permission is granted to anyone to use this software for any purpose,         *
+* including commercial applications, and to alter it and redistribute it        *
+* freely, subject to the following restrictions:                                *
+*                                                                               *
+* 1. The origin of this software must not be misrepresented; you must not claim *
+*    that you wrote the original software. If you use this software in a        *
+*    product, an acknowledgment in the product documentation would be           *
+*    appreciated but is not required.                                           *
+*                                                                               *
+* 2. Altered source versions must be plainly marked as such, and must not be    *
+*    misrepresented as being the original software.                             *
+*                                                                               *
+* 3. This notice may not be removed or altered from any source distribution.    *
+*                                                                               *
+********************************************************************************/
+
+
+#ifndef REACTPHYSICS3D_LANES_H
+#define REACTPHYSICS3D_LANES_H
+
+// Libraries
+#include "configuration.h"
+#include <cmath>
+#include <cassert>
+
+/// ReactPhysics3D namespace
+namespace reactphysics3d {
+
+// Struct LaneMask
+/**
+ * This class represents a boolean for each of the N lanes of a group. The masks are the
+ * results of the comparisons of lanes and are used to select the values of the lanes
+ * without branches.
+ */
+template<uint N>
+struct LaneMask {
+
+    public:
+
+        // -------------------- Attributes -------------------- //
+
+        /// Value of each lane
+        bool values[N];
+
+        // -------------------- Methods -------------------- //
+
+        /// Constructor (the lanes are not initialized)
+        LaneMask() = default;
+
+        /// Constructor with the same value for all the lanes
+        explicit LaneMask(bool value);
+
+        /// Return true if at least one lane is true
+        bool any() const;
+
+        /// Return true if all the lanes are true
+        bool all() const;
+
+        /// Return the number of true lanes
+        uint count() const;
+
+        /// Overloaded operator to access the value of a lane
+        bool& operator[](uint lane);
+
+        /// Overloaded operator to access the value of a lane
+        const bool& operator[](uint lane) const;
+};
+
+// Struct Lanes
+/**
+ * This class represents N values of type T stored next to each other (one per lane). All
+ * the operations are done lane by lane in loops without branches that the compiler can
+ * turn into SIMD instructions. The values can be loaded from and stored into arrays of
+ * structures with the gather() and scatter() methods.
+ */
+template<typename T, uint N>
+struct Lanes {
+
+    public:
+
+        // -------------------- Attributes -------------------- //
+
+        /// Value of each lane
+        T values[N];
+
+        // -------------------- Methods -------------------- //
+
+        /// Constructor (the lanes are not initialized)
+        Lanes() = default;
+
+        /// Constructor with the same value for all the lanes
+        explicit Lanes(T value);
+
+        /// Return the lanes with the values of the first N elements of an array
+        static Lanes load(const T* array);
+
+        /// Return the lanes with the values of the elements of an array at some indices
+        static Lanes gather(const T* array, const uint* indices);
+
+        /// Store the values of the lanes into the first N elements of an array
+        void store(T* array) const;
+
+        /// Store the values of the lanes into the elements of an array at some indices
+        void scatter(T* array, const uint* indices) const;
+
+        /// Return the square root of each lane
+        Lanes getSquareRoot() const;
+
+        /// Return the absolute value of each lane
+        Lanes getAbsoluteValue() const;
+
+        /// Return the smallest value of the lanes
+        T horizontalMin() const;
+
+        /// Return the largest value of the lanes
+        T horizontalMax() const;
+
+        /// Return the sum of the values of the lanes
+        T horizontalSum() const;
+
+        /// Return the smallest value of each lane of two lanes
+        static Lanes min(const Lanes& lanes1, const Lanes& lanes2);
+
+        /// Return the largest value of each lane of two lanes
+        static Lanes max(const Lanes& lanes1, const Lanes& lanes2);
+
+        /// Overloaded operator to access the value of a lane
+        T& operator[](uint lane);
+
+        /// Overloaded operator to access the value of a lane
+        const T& operator[](uint lane) const;
+
+        /// Overloaded operator for addition with assignment
+        Lanes& operator+=(const Lanes& lanes);
+
+        /// Overloaded operator for substraction with assignment
+        Lanes& operator-=(const Lanes& lanes);
+
+        /// Overloaded operator for multiplication with assignment
+        Lanes& operator*=(const Lanes& lanes);
+};
+
+// Constructor with the same value for all the lanes
+template<uint N>
+inline LaneMask<N>::LaneMask(bool value) {
+    for (uint l=0; l < N; l++) values[l] = value;
+}
+
+// Return true if at least one lane is true
+template<uint N>
+inline bool LaneMask<N>::any() const {
+    bool result = false;
+    for (uint l=0; l < N; l++) result |= values[l];
+    return result;
+}
+
+// Return true if all the lanes are true
+template<uint N>
+inline bool LaneMask<N>::all() const {
+    bool result = true;
+    for (uint l=0; l < N; l++) result &= values[l];
+    return result;
+}
+
+// Return the number of true lanes
+template<uint N>
+inline uint LaneMask<N>::count() const {
+    uint result = 0;
+    for (uint l=0; l < N; l++) result += values[l] ? 1 : 0;
+    return result;
+}
+
+// Overloaded operator to access the value of a lane
+template<uint N>
+inline bool& LaneMask<N>::operator[](uint lane) {
+    assert(lane < N);
+    return values[lane];
+}
+
+// Overloaded operator to access the value of a lane
+template<uint N>
+inline const bool& LaneMask<N>::operator[](uint lane) const {
+    assert(lane < N);
+    return values[lane];
+}
+
+// Overloaded operator for the logical and of two masks
+template<uint N>
+inline LaneMask<N> operator&&(const LaneMask<N>& mask1, const LaneMask<N>& mask2) {
+    LaneMask<N> result;
+    for (uint l=0; l < N; l++) result.values[l] = mask1.values[l] && mask2.values[l];
+    return result;
+}
+
+// Overloaded operator for the logical or of two masks
+template<uint N>
+inline LaneMask<N> operator||(const LaneMask<N>& mask1, const LaneMask<N>& mask2) {
+    LaneMask<N> result;
+    for (uint l=0; l < N; l++) result.values[l] = mask1.values[l] || mask2.values[l];
+    return result;
+}
+
+// Overloaded operator for the logical negation of a mask
+template<uint N>
+inline LaneMask<N> operator!(const LaneMask<N>& mask) {
+    LaneMask<N> result;
+    for (uint l=0; l < N; l++) result.values[l] = !mask.values[l];
+    return result;
+}
+
+// Constructor with the same value for all the lanes
+template<typename T, uint N>
+inline Lanes<T, N>::Lanes(T value) {
+    for (uint l=0; l < N; l++) values[l] = value;
+}
+
+// Return the lanes with the values of the first N elements of an array
+template<typename T, uint N>
+inline Lanes<T, N> Lanes<T, N>::load(const T* array) {
+    Lanes result;
+    for (uint l=0; l < N; l++) result.values[l] = array[l];
+    return result;
+}
+
+// Return the lanes with the values of the elements of an array at some indices
+template<typename T, uint N>
+inline Lanes<T, N> Lanes<T, N>::gather(const T* array, const uint* indices) {
+    Lanes result;
+    for (uint l=0; l < N; l++) result.values[l] = array[indices[l]];
+    return result;
+}
+
+// Store the values of the lanes into the first N elements of an array
+template<typename T, uint N>
+inline void Lanes<T, N>::store(T* array) const {
+    for (uint l=0; l < N; l++) array[l] = values[l];
+}
+
+// Store the values of the lanes into the elements of an array at some indices
+template<typename T, uint N>
+inline void Lanes<T, N>::scatter(T* array, const uint* indices) const {
+    for (uint l=0; l < N; l++) array[indices[l]] = values[l];
+}
+
+// Return the square root of each lane
+template<typename T, uint N>
+inline Lanes<T, N> Lanes<T, N>::getSquareRoot() const {
+    Lanes result;
+    for (uint l=0; l < N; l++) result.values[l] = std::sqrt(values[l]);
+    return result;
+}
+
+// Return the absolute value of each lane
+template<typename T, uint N>
+inline Lanes<T, N> Lanes<T, N>::getAbsoluteValue() const {
+    Lanes result;
+    for (uint l=0; l < N; l++) result.values[l] = std::abs(values[l]);
+    return result;
+}
+
+// Return the smallest value of the lanes
+template<typename T, uint N>
+inline T Lanes<T, N>::horizontalMin() const {
+    T result = values[0];
+    for (uint l=1; l < N; l++) result = values[l] < result ? values[l] : result;
+    return result;
+}
+
+// Return the largest value of the lanes
+template<typename T, uint N>
+inline T Lanes<T, N>::horizontalMax() const {
+    T result = values[0];
+    for (uint l=1; l < N; l++) result = values[l] > result ? values[l] : result;
+    return result;
+}
+
+// Return the sum of the values of the lanes
+template<typename T, uint N>
+inline T Lanes<T, N>::horizontalSum() const {
+    T result = values[0];
+    for (uint l=1; l < N; l++) result += values[l];
+    return result;
+}
+
+// Return the smallest value of each lane of two lanes
+template<typename T, uint N>
+inline Lanes<T, N> Lanes<T, N>::min(const Lanes& lanes1, const Lanes& lanes2) {
+    Lanes result;
+    for (uint l=0; l < N; l++) result.values[l] = lanes1.values[l] < lanes2.values[l] ? lanes1.values[l] : lanes2.values[l];
+    return result;
+}
+
+// Return the largest value of each lane of two lanes
+template<typename T, uint N>
+inline Lanes<T, N> Lanes<T, N>::max(const Lanes& lanes1, const Lanes& lanes2) {
+    Lanes result;
+    for (uint l=0; l < N; l++) result.values[l] = lanes1.values[l] > lanes2.values[l] ? lanes1.values[l] : lanes2.values[l];
+    return result;
+}
+
+// Overloaded operator to access the value of a lane
+template<typename T, uint N>
+inline T& Lanes<T, N>::operator[](uint lane) {
+    assert(lane < N);
+    return values[lane];
+}
+
+// Overloaded operator to access the value of a lane
+template<typename T, uint N>
+inline const T& Lanes<T, N>::operator[](uint lane) const {
+    assert(lane < N);
+    return values[lane];
+}
+
+// Overloaded operator for addition with assignment
+template<typename T, uint N>
+inline Lanes<T, N>& Lanes<T, N>::operator+=(const Lanes& lanes) {
+    for (uint l=0; l < N; l++) values[l] += lanes.values[l];
+    return *this;
+}
+
+// Overloaded operator for substraction with assignment
+template<typename T, uint N>
+inline Lanes<T, N>& Lanes<T, N>::operator-=(const Lanes& lanes) {
+    for (uint l=0; l < N; l++) values[l] -= lanes.values[l];
+    return *this;
+}
+
+// Overloaded operator for multiplication with assignment
+template<typename T, uint N>
+inline Lanes<T, N>& Lanes<T, N>::operator*=(const Lanes& lanes) {
+    for (uint l=0; l < N; l++) values[l] *= lanes.values[l];
+    return *this;
+}
+
+// Overloaded operator for addition
+template<typename T, uint N>
+inline Lanes<T, N> operator+(const Lanes<T, N>& lanes1, const Lanes<T, N>& lanes2) {
+    Lanes<T, N> result;
+    for (uint l=0; l < N; l++) result.values[l] = lanes1.values[l] + lanes2.values[l];
+    return result;
+}
+
+// Overloaded operator for substraction
+template<typename T, uint N>
+inline Lanes<T, N> operator-(const Lanes<T, N>& lanes1, const Lanes<T, N>& lanes2) {
+    Lanes<T, N> result;
+    for (uint l=0; l < N; l++) result.values[l] = lanes1.values[l] - lanes2.values[l];
+    return result;
+}
+
+// Overloaded operator for the negative of lanes
+template<typename T, uint N>
+inline Lanes<T, N> operator-(const Lanes<T, N>& lanes) {
+    Lanes<T, N> result;
+    for (uint l=0; l < N; l++) result.values[l] = -lanes.values[l];
+    return result;
+}
+
+// Overloaded operator for multiplication
+template<typename T, uint N>
+inline Lanes<T, N> operator*(const Lanes<T, N>& lanes1, const Lanes<T, N>& lanes2) {
+    Lanes<T, N> result;
+    for (uint l=0; l < N; l++) result.values[l] = lanes1.values[l] * lanes2.values[l];
+    return result;
+}
+
+// Overloaded operator for multiplication with a number
+template<typename T, uint N>
+inline Lanes<T, N> operator*(T number, const Lanes<T, N>& lanes) {
+    Lanes<T, N> result;
+    for (uint l=0; l < N; l++) result.values[l] = number * lanes.values[l];
+    return result;
+}
+
+// Overloaded operator for division
+template<typename T, uint N>
+inline Lanes<T, N> operator/(const Lanes<T, N>& lanes1, const Lanes<T, N>& lanes2) {
+    Lanes<T, N> result;
+    for (uint l=0; l < N; l++) result.values[l] = lanes1.values[l] / lanes2.values[l];
+    return result;
+}
+
+// Overloaded operator for the lane by lane comparison "smaller than"
+template<typename T, uint N>
+inline LaneMask<N> operator<(const Lanes<T, N>& lanes1, const Lanes<T, N>& lanes2) {
+    LaneMask<N> result;
+    for (uint l=0; l < N; l++) result.values[l] = lanes1.values[l] < lanes2.values[l];
+    return result;
+}
+
+// Overloaded operator for the lane by lane comparison "smaller or equal"
+template<typename T, uint N>
+inline LaneMask<N> operator<=(const Lanes<T, N>& lanes1, const Lanes<T, N>& lanes2) {
+    LaneMask<N> result;
+    for (uint l=0; l < N; l++) result.values[l] = lanes1.values[l] <= lanes2.values[l];
+    return result;
+}
+
+// Overloaded operator for the lane by lane comparison "larger than"
+template<typename T, uint N>
+inline LaneMask<N> operator>(const Lanes<T, N>& lanes1, const Lanes<T, N>& lanes2) {
+    return lanes2 < lanes1;
+}
+
+// Overloaded operator for the lane by lane comparison "larger or equal"
+template<typename T, uint N>
+inline LaneMask<N> operator>=(const Lanes<T, N>& lanes1, const Lanes<T, N>& lanes2) {
+    return lanes2 <= lanes1;
+}
+
+// Return the values of the first lanes where the mask is true and of the second lanes elsewhere
+template<typename T, uint N>
+inline Lanes<T, N> select(const LaneMask<N>& mask, const Lanes<T, N>& lanes1, const Lanes<T, N>& lanes2) {
+    Lanes<T, N> result;
+    for (uint l=0; l < N; l++) result.values[l] = mask.values[l] ? lanes1.values[l] : lanes2.values[l];
+    return result;
+}
+
+}
+
+#endif
@@ -41,7 +41,7 @@ class Matrix3x3;
  * This class represents a quaternion. We use the notation :
  * q = (x*i, y*j, z*k, w) to represent a quaternion.
  */
-struct Quaternion {
+struct alignas(VECTOR_ALIGNMENT) Quaternion {
 
     public :
 
@@ -109,6 +109,9 @@ struct Quaternion {
         /// Return the unit quaternion
         Quaternion getUnit() const;
 
+        /// Return the unit quaternion of an almost unit quaternion without a square root
+        Quaternion getApproximateUnit() const;
+
         /// Return the conjugate quaternion
         Quaternion getConjugate() const;
 
@@ -270,6 +273,22 @@ inline Quaternion Quaternion::getUnit() const {
                       z / lengthQuaternion, w / lengthQuaternion);
 }
 
+// Return the unit quaternion of an almost unit quaternion without a square root
+/// The inverse of the length is approximated with one Newton-Raphson iteration of the
+/// inverse square root of the square length l starting at one: 1/sqrt(l) ~ (3 - l) / 2.
+/// The error on the square length of the result is about 3/4 (l - 1)^2. The exact
+/// unit quaternion is returned if l is not close enough to one for the approximation.
+inline Quaternion Quaternion::getApproximateUnit() const {
+
+    const decimal lengthSquareQuaternion = lengthSquare();
+    if (std::abs(lengthSquareQuaternion - decimal(1.0)) > APPROXIMATE_NORMALIZATION_MAX_ERROR) {
+        return getUnit();
+    }
+
+    const decimal inverseLength = decimal(0.5) * (decimal(3.0) - lengthSquareQuaternion);
+    return Quaternion(x * inverseLength, y * inverseLength, z * inverseLength, w * inverseLength);
+}
+
 // Return the identity quaternion
 inline Quaternion Quaternion::identity() {
     return Quaternion(0.0, 0.0, 0.0, 1.0);
@@ -348,18 +367,20 @@ inline Quaternion Quaternion::operator*(const Quaternion& quaternion) const {
 /// This methods rotates a point given the rotation of a quaternion.
 inline Vector3 Quaternion::operator*(const Vector3& point) const {
 
-    /* The following code is equivalent to this
+    /* The following code is equivalent to this for a unit quaternion
      * Quaternion p(point.x, point.y, point.z, 0.0);
      * return (((*this) * p) * getConjugate()).getVectorV();
+     *
+     * With v = (x, y, z) and t = 2 (v x point), the rotated point is
+     * point + w t + v x t, which needs 15 multiplications instead of 28.
     */
 
-    const decimal prodX = w * point.x + y * point.z - z * point.y;
-    const decimal prodY = w * point.y + z * point.x - x * point.z;
-    const decimal prodZ = w * point.z + x * point.y - y * point.x;
-    const decimal prodW = -x * point.x - y * point.y - z * point.z;
-    return Vector3(w * prodX - prodY * z + prodZ * y - prodW * x,
-                   w * prodY - prodZ * x + prodX * z - prodW * y,
-                   w * prodZ - prodX * y + prodY * x - prodW * z);
+    const decimal tX = decimal(2.0) * (y * point.z - z * point.y);
+    const decimal tY = decimal(2.0) * (z * point.x - x * point.z);
+    const decimal tZ = decimal(2.0) * (x * point.y - y * point.x);
+    return Vector3(point.x + w * tX + y * tZ - z * tY,
+                   point.y + w * tY + z * tX - x * tZ,
+                   point.z + w * tZ + x * tY - y * tX);
 }
 
 // Overloaded operator for the assignment
@@ -0,0 +1,231 @@
+/********************************************************************************
+* ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
+* Copyright (c) 2010-2018 Daniel Chappuis                                       *
+*********************************************************************************
+*                                                                               *
+* This software is provided 'as-is', without any express or implied warranty.   *
+* In no event will the authors be held liable for any damages arising from the  *
+* use of this software.                                                         *
+*                                                                               *
+* Permission is granted to anyone to use this software for any purpose,         *
+* including commercial applications, and to alter it and redistribute it        *
+* freely, subject to the following restrictions:                                *
+*                                                                               *
+* 1. The origin of this software must not be misrepresented; you must not claim *
+*    that you wrote the original software. If you use this software in a        *
+*    product, an acknowledgment in the product documentation would be           *
+*    appreciated but is not required.                                           *
+*                                                                               *
+* 2. Altered source versions must be plainly marked as such, and must not be    *
+*    misrepresented as being the original software.                             *
+*                                                                               *
+* 3. This notice may not be removed or altered from any source distribution.    *
+*                                                                               *
+********************************************************************************/
+
+
+#ifndef REACTPHYSICS3D_QUATERNION_LANES_H
+#define REACTPHYSICS3D_QUATERNION_LANES_H
+
+// Libraries
+#include "Vector3Lanes.h"
+#include "Quaternion.h"
+
+/// ReactPhysics3D namespace
+namespace reactphysics3d {
+
+// Struct QuaternionLanes
+/**
+ * This class represents N quaternions stored as a structure of arrays. The quaternions
+ * are assumed to be unit quaternions (orientations) as in the batched kernels.
+ */
+template<typename T, uint N>
+struct QuaternionLanes {
+
+    public:
+
+        // -------------------- Attributes -------------------- //
+
+        /// Component x of each lane
+        Lanes<T, N> x;
+
+        /// Component y of each lane
+        Lanes<T, N> y;
+
+        /// Component z of each lane
+        Lanes<T, N> z;
+
+        /// Component w of each lane
+        Lanes<T, N> w;
+
+        // -------------------- Methods -------------------- //
+
+        /// Constructor (the lanes are not initialized)
+        QuaternionLanes() = default;
+
+        /// Constructor with the same quaternion for all the lanes
+        explicit QuaternionLanes(const Quaternion& quaternion);
+
+        /// Constructor with the components of each lane
+        QuaternionLanes(const Lanes<T, N>& newX, const Lanes<T, N>& newY,
+                        const Lanes<T, N>& newZ, const Lanes<T, N>& newW);
+
+        /// Return the lanes with the first N quaternions of an array
+        static QuaternionLanes load(const Quaternion* array);
+
+        /// Return the lanes with the quaternions of an array at some indices
+        static QuaternionLanes gather(const Quaternion* array, const uint* indices);
+
+        /// Store the lanes into the first N quaternions of an array
+        void store(Quaternion* array) const;
+
+        /// Store the lanes into the quaternions of an array at some indices
+        void scatter(Quaternion* array, const uint* indices) const;
+
+        /// Return the quaternion of a lane
+        Quaternion getLane(uint lane) const;
+
+        /// Set the quaternion of a lane
+        void setLane(uint lane, const Quaternion& quaternion);
+
+        /// Return the vector v=(x y z) of each lane
+        Vector3Lanes<T, N> getVectorV() const;
+
+        /// Return the square of the length of each lane
+        Lanes<T, N> lengthSquare() const;
+
+        /// Return the unit quaternion of each lane of almost unit quaternions without a square root
+        QuaternionLanes getApproximateUnit() const;
+
+        /// Return the conjugate of each lane
+        QuaternionLanes getConjugate() const;
+
+        /// Overloaded operator for the multiplication of each lane with the lane of another quaternion
+        QuaternionLanes operator*(const QuaternionLanes& quaternion) const;
+
+        /// Overloaded operator to rotate each lane of a point by the lane of the quaternion
+        Vector3Lanes<T, N> operator*(const Vector3Lanes<T, N>& point) const;
+};
+
+// Constructor with the same quaternion for all the lanes
+template<typename T, uint N>
+inline QuaternionLanes<T, N>::QuaternionLanes(const Quaternion& quaternion)
+         : x(quaternion.x), y(quaternion.y), z(quaternion.z), w(quaternion.w) {
+
+}
+
+// Constructor with the components of each lane
+template<typename T, uint N>
+inline QuaternionLanes<T, N>::QuaternionLanes(const Lanes<T, N>& newX, const Lanes<T, N>& newY,
+                                              const Lanes<T, N>& newZ, const Lanes<T, N>& newW)
+         : x(newX), y(newY), z(newZ), w(newW) {
+
+}
+
+// Return the lanes with the first N quaternions of an array
+template<typename T, uint N>
+inline QuaternionLanes<T, N> QuaternionLanes<T, N>::load(const Quaternion* array) {
+    QuaternionLanes result;
+    for (uint l=0; l < N; l++) result.setLane(l, array[l]);
+    return result;
+}
+
+// Return the lanes with the quaternions of an array at some indices
+template<typename T, uint N>
+inline QuaternionLanes<T, N> QuaternionLanes<T, N>::gather(const Quaternion* array, const uint* indices) {
+    QuaternionLanes result;
+    for (uint l=0; l < N; l++) result.setLane(l, array[indices[l]]);
+    return result;
+}
+
+// Store the lanes into the first N quaternions of an array
+template<typename T, uint N>
+inline void QuaternionLanes<T, N>::store(Quaternion* array) const {
+    for (uint l=0; l < N; l++) array[l] = getLane(l);
+}
+
+// Store the lanes into the quaternions of an array at some indices
+template<typename T, uint N>
+inline void QuaternionLanes<T, N>::scatter(Quaternion* array, const uint* indices) const {
+    for (uint l=0; l < N; l++) array[indices[l]] = getLane(l);
+}
+
+// Return the quaternion of a lane
+template<typename T, uint N>
+inline Quaternion QuaternionLanes<T, N>::getLane(uint lane) const {
+    return Quaternion(x[lane], y[lane], z[lane], w[lane]);
+}
+
+// Set the quaternion of a lane
+template<typename T, uint N>
+inline void QuaternionLanes<T, N>::setLane(uint lane, const Quaternion& quaternion) {
+    x[lane] = quaternion.x;
+    y[lane] = quaternion.y;
+    z[lane] = quaternion.z;
+    w[lane] = quaternion.w;
+}
+
+// Return the vector v=(x y z) of each lane
+template<typename T, uint N>
+inline Vector3Lanes<T, N> QuaternionLanes<T, N>::getVectorV() const {
+    return Vector3Lanes<T, N>(x, y, z);
+}
+
+// Return the square of the length of each lane
+template<typename T, uint N>
+inline Lanes<T, N> QuaternionLanes<T, N>::lengthSquare() const {
+    return x * x + y * y + z * z + w * w;
+}
+
+// Return the unit quaternion of each lane of almost unit quaternions without a square root
+/// This uses the same approximation as Quaternion::getApproximateUnit(). The square root
+/// is only computed if a lane is too far from the unit length for the approximation.
+template<typename T, uint N>
+inline QuaternionLanes<T, N> QuaternionLanes<T, N>::getApproximateUnit() const {
+
+    const Lanes<T, N> lengthSquareLanes = lengthSquare();
+    Lanes<T, N> inverseLength = T(0.5) * (Lanes<T, N>(T(3.0)) - lengthSquareLanes);
+
+    const LaneMask<N> isFar = lengthSquareLanes > Lanes<T, N>(T(1.0) + APPROXIMATE_NORMALIZATION_MAX_ERROR) ||
+                              lengthSquareLanes < Lanes<T, N>(T(1.0) - APPROXIMATE_NORMALIZATION_MAX_ERROR);
+    if (isFar.any()) {
+        inverseLength = select(isFar, Lanes<T, N>(T(1.0)) / lengthSquareLanes.getSquareRoot(), inverseLength);
+    }
+
+    return QuaternionLanes(x * inverseLength, y * inverseLength, z * inverseLength, w * inverseLength);
+}
+
+// Return the conjugate of each lane
+template<typename T, uint N>
+inline QuaternionLanes<T, N> QuaternionLanes<T, N>::getConjugate() const {
+    return QuaternionLanes(-x, -y, -z, w);
+}
+
+// Overloaded operator for the multiplication of each lane with the lane of another quaternion
+template<typename T, uint N>
+inline QuaternionLanes<T, N> QuaternionLanes<T, N>::operator*(const QuaternionLanes& quaternion) const {
+    return QuaternionLanes(w * quaternion.x + quaternion.w * x + y * quaternion.z - z * quaternion.y,
+                           w * quaternion.y + quaternion.w * y + z * quaternion.x - x * quaternion.z,
+                           w * quaternion.z + quaternion.w * z + x * quaternion.y - y * quaternion.x,
+                           w * quaternion.w - x * quaternion.x - y * quaternion.y - z * quaternion.z);
+}
+
+// Overloaded operator to rotate each lane of a point by the lane of the quaternion
+/// This uses the same formula as Quaternion::operator*(const Vector3&): with v = (x, y, z)
+/// and t = 2 (v x point), the rotated point is point + w t + v x t.
+template<typename T, uint N>
+inline Vector3Lanes<T, N> QuaternionLanes<T, N>::operator*(const Vector3Lanes<T, N>& point) const {
+    const Vector3Lanes<T, N> v = getVectorV();
+    const Vector3Lanes<T, N> t = T(2.0) * v.cross(point);
+    return point + w * t + v.cross(t);
+}
+
+/// Four quaternions stored as a structure of arrays
+using Quaternionx4 = QuaternionLanes<decimal, 4>;
+
+/// Eight quaternions stored as a structure of arrays
+using Quaternionx8 = QuaternionLanes<decimal, 8>;
+
+}
+
+#endif
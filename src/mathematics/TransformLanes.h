@@ -0,0 +1,149 @@
+/********************************************************************************
+* ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
+* Copyright (c) 2010-2018 Daniel Chappuis                                       *
+*********************************************************************************
+*                                                                               *
+* This software is provided 'as-is', without any express or implied warranty.   *
+* In no event will the authors be held liable for any damages arising from the  *
+* use of this software.                                                         *
+*                                                                               *
+* Permission is granted to anyone to use this software for any purpose,         *
+* including commercial applications, and to alter it and redistribute it        *
+* freely, subject to the following restrictions:                                *
+*                                                                               *
+* 1. The origin of this software must not be misrepresented; you must not claim *
+*    that you wrote the original software. If you use this software in a        *
+*    product, an acknowledgment in the product documentation would be           *
+*    appreciated but is not required.                                           *
+*                                                                               *
+* 2. Altered source versions must be plainly marked as such, and must not be    *
+*    misrepresented as being the original software.                             *
+*                                                                               *
+* 3. This notice may not be removed or altered from any source distribution.    *
+*                                                                               *
+********************************************************************************/
+
+
+#ifndef REACTPHYSICS3D_TRANSFORM_LANES_H
+#define REACTPHYSICS3D_TRANSFORM_LANES_H
+
+// Libraries
+#include "QuaternionLanes.h"
+#include "Transform.h"
+
+/// ReactPhysics3D namespace
+namespace reactphysics3d {
+
+// Struct TransformLanes
+/**
+ * This class represents N rigid transforms (a position and an orientation) stored as a
+ * structure of arrays.
+ */
+template<typename T, uint N>
+struct TransformLanes {
+
+    public:
+
+        // -------------------- Attributes -------------------- //
+
+        /// Position of each lane
+        Vector3Lanes<T, N> position;
+
+        /// Orientation of each lane
+        QuaternionLanes<T, N> orientation;
+
+        // -------------------- Methods -------------------- //
+
+        /// Constructor (the lanes are not initialized)
+        TransformLanes() = default;
+
+        /// Constructor with the same transform for all the lanes
+        explicit TransformLanes(const Transform& transform);
+
+        /// Constructor with the position and orientation of each lane
+        TransformLanes(const Vector3Lanes<T, N>& newPosition, const QuaternionLanes<T, N>& newOrientation);
+
+        /// Return the lanes with the transforms of an array at some indices
+        static TransformLanes gather(const Transform* array, const uint* indices);
+
+        /// Return the transform of a lane
+        Transform getLane(uint lane) const;
+
+        /// Set the transform of a lane
+        void setLane(uint lane, const Transform& transform);
+
+        /// Return the inverse of each lane
+        TransformLanes getInverse() const;
+
+        /// Overloaded operator to transform each lane of a point by the lane of the transform
+        Vector3Lanes<T, N> operator*(const Vector3Lanes<T, N>& point) const;
+
+        /// Overloaded operator to compose each lane with the lane of another transform
+        TransformLanes operator*(const TransformLanes& transform) const;
+};
+
+// Constructor with the same transform for all the lanes
+template<typename T, uint N>
+inline TransformLanes<T, N>::TransformLanes(const Transform& transform)
+         : position(transform.getPosition()), orientation(transform.getOrientation()) {
+
+}
+
+// Constructor with the position and orientation of each lane
+template<typename T, uint N>
+inline TransformLanes<T, N>::TransformLanes(const Vector3Lanes<T, N>& newPosition,
+                                            const QuaternionLanes<T, N>& newOrientation)
+         : position(newPosition), orientation(newOrientation) {
+
+}
+
+// Return the lanes with the transforms of an array at some indices
+template<typename T, uint N>
+inline TransformLanes<T, N> TransformLanes<T, N>::gather(const Transform* array, const uint* indices) {
+    TransformLanes result;
+    for (uint l=0; l < N; l++) result.setLane(l, array[indices[l]]);
+    return result;
+}
+
+// Return the transform of a lane
+template<typename T, uint N>
+inline Transform TransformLanes<T, N>::getLane(uint lane) const {
+    return Transform(position.getLane(lane), orientation.getLane(lane));
+}
+
+// Set the transform of a lane
+template<typename T, uint N>
+inline void TransformLanes<T, N>::setLane(uint lane, const Transform& transform) {
+    position.setLane(lane, transform.getPosition());
+    orientation.setLane(lane, transform.getOrientation());
+}
+
+// Return the inverse of each lane
+template<typename T, uint N>
+inline TransformLanes<T, N> TransformLanes<T, N>::getInverse() const {
+    const QuaternionLanes<T, N> inverseOrientation = orientation.getConjugate();
+    return TransformLanes(inverseOrientation * (-position), inverseOrientation);
+}
+
+// Overloaded operator to transform each lane of a point by the lane of the transform
+template<typename T, uint N>
+inline Vector3Lanes<T, N> TransformLanes<T, N>::operator*(const Vector3Lanes<T, N>& point) const {
+    return orientation * point + position;
+}
+
+// Overloaded operator to compose each lane with the lane of another transform
+template<typename T, uint N>
+inline TransformLanes<T, N> TransformLanes<T, N>::operator*(const TransformLanes& transform) const {
+    return TransformLanes(position + orientation * transform.position,
+                          orientation * transform.orientation);
+}
+
+/// Four transforms stored as a structure of arrays
+using Transformx4 = TransformLanes<decimal, 4>;
+
+/// Eight transforms stored as a structure of arrays
+using Transformx8 = TransformLanes<decimal, 8>;
+
+}
+
+#endif
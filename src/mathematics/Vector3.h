@@ -39,7 +39,7 @@ namespace reactphysics3d {
 /**
  * This class represents a 3D vector.
  */
-struct Vector3 {
+struct alignas(VECTOR_ALIGNMENT) Vector3 {
 
     public:
 
@@ -54,6 +54,17 @@ struct Vector3 {
         /// Component z
         decimal z;
 
+#if defined(IS_ALIGNED_VECTOR_STORAGE_ENABLED)
+
+    private:
+
+        /// Unused fourth component that pads the vector to four lanes (always zero)
+        decimal mPadding = decimal(0.0);
+
+    public:
+
+#endif
+
         // -------------------- Methods -------------------- //
 
         /// Constructor of the struct Vector3
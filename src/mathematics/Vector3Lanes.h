@@ -0,0 +1,273 @@
+/********************************************************************************
+* ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
+* Copyright (c) 2010-2018 Daniel Chappuis                                       *
+*********************************************************************************
+*                                                                               *
+* This software is provided 'as-is', without any express or implied warranty.   *
+* In no event will the authors be held liable for any damages arising from the  *
+* use of this software.                                                         *
+*                                                                               *
+* Permission is granted to anyone to use this software for any purpose,         *
+* including commercial applications, and to alter it and redistribute it        *
+* freely, subject to the following restrictions:                                *
+*                                                                               *
+* 1. The origin of this software must not be misrepresented; you must not claim *
+*    that you wrote the original software. If you use this software in a        *
+*    product, an acknowledgment in the product documentation would be           *
+*    appreciated but is not required.                                           *
+*                                                                               *
+* 2. Altered source versions must be plainly marked as such, and must not be    *
+*    misrepresented as being the original software.                             *
+*                                                                               *
+* 3. This notice may not be removed or altered from any source distribution.    *
+*                                                                               *
+********************************************************************************/
+
+
+#ifndef REACTPHYSICS3D_VECTOR3_LANES_H
+#define REACTPHYSICS3D_VECTOR3_LANES_H
+
+// Libraries
+#include "Lanes.h"
+#include "Vector3.h"
+
+/// ReactPhysics3D namespace
+namespace reactphysics3d {
+
+// Struct Vector3Lanes
+/**
+ * This class represents N 3D vectors stored as a structure of arrays (the x, y and z
+ * coordinates of the N lanes are stored next to each other). It is used by the batched
+ * kernels to do the same vector operations on several pairs at once.
+ */
+template<typename T, uint N>
+struct Vector3Lanes {
+
+    public:
+
+        // -------------------- Attributes -------------------- //
+
+        /// Component x of each lane
+        Lanes<T, N> x;
+
+        /// Component y of each lane
+        Lanes<T, N> y;
+
+        /// Component z of each lane
+        Lanes<T, N> z;
+
+        // -------------------- Methods -------------------- //
+
+        /// Constructor (the lanes are not initialized)
+        Vector3Lanes() = default;
+
+        /// Constructor with the same vector for all the lanes
+        explicit Vector3Lanes(const Vector3& vector);
+
+        /// Constructor with the components of each lane
+        Vector3Lanes(const Lanes<T, N>& newX, const Lanes<T, N>& newY, const Lanes<T, N>& newZ);
+
+        /// Return the lanes with the first N vectors of an array
+        static Vector3Lanes load(const Vector3* array);
+
+        /// Return the lanes with the vectors of an array at some indices
+        static Vector3Lanes gather(const Vector3* array, const uint* indices);
+
+        /// Store the lanes into the first N vectors of an array
+        void store(Vector3* array) const;
+
+        /// Store the lanes into the vectors of an array at some indices
+        void scatter(Vector3* array, const uint* indices) const;
+
+        /// Return the vector of a lane
+        Vector3 getLane(uint lane) const;
+
+        /// Set the vector of a lane
+        void setLane(uint lane, const Vector3& vector);
+
+        /// Return the squared length of each lane
+        Lanes<T, N> lengthSquare() const;
+
+        /// Return the length of each lane
+        Lanes<T, N> length() const;
+
+        /// Return the dot product of each lane with the lane of another vector
+        Lanes<T, N> dot(const Vector3Lanes& vector) const;
+
+        /// Return the cross product of each lane with the lane of another vector
+        Vector3Lanes cross(const Vector3Lanes& vector) const;
+
+        /// Return the smallest component of all the lanes along each axis
+        Vector3 horizontalMin() const;
+
+        /// Return the largest component of all the lanes along each axis
+        Vector3 horizontalMax() const;
+
+        /// Overloaded operator for addition with assignment
+        Vector3Lanes& operator+=(const Vector3Lanes& vector);
+
+        /// Overloaded operator for substraction with assignment
+        Vector3Lanes& operator-=(const Vector3Lanes& vector);
+};
+
+// Constructor with the same vector for all the lanes
+template<typename T, uint N>
+inline Vector3Lanes<T, N>::Vector3Lanes(const Vector3& vector)
+         : x(vector.x), y(vector.y), z(vector.z) {
+
+}
+
+// Constructor with the components of each lane
+template<typename T, uint N>
+inline Vector3Lanes<T, N>::Vector3Lanes(const Lanes<T, N>& newX, const Lanes<T, N>& newY,
+                                        const Lanes<T, N>& newZ)
+         : x(newX), y(newY), z(newZ) {
+
+}
+
+// Return the lanes with the first N vectors of an array
+template<typename T, uint N>
+inline Vector3Lanes<T, N> Vector3Lanes<T, N>::load(const Vector3* array) {
+    Vector3Lanes result;
+    for (uint l=0; l < N; l++) result.setLane(l, array[l]);
+    return result;
+}
+
+// Return the lanes with the vectors of an array at some indices
+template<typename T, uint N>
+inline Vector3Lanes<T, N> Vector3Lanes<T, N>::gather(const Vector3* array, const uint* indices) {
+    Vector3Lanes result;
+    for (uint l=0; l < N; l++) result.setLane(l, array[indices[l]]);
+    return result;
+}
+
+// Store the lanes into the first N vectors of an array
+template<typename T, uint N>
+inline void Vector3Lanes<T, N>::store(Vector3* array) const {
+    for (uint l=0; l < N; l++) array[l] = getLane(l);
+}
+
+// Store the lanes into the vectors of an array at some indices
+template<typename T, uint N>
+inline void Vector3Lanes<T, N>::scatter(Vector3* array, const uint* indices) const {
+    for (uint l=0; l < N; l++) array[indices[l]] = getLane(l);
+}
+
+// Return the vector of a lane
+template<typename T, uint N>
+inline Vector3 Vector3Lanes<T, N>::getLane(uint lane) const {
+    return Vector3(x[lane], y[lane], z[lane]);
+}
+
+// Set the vector of a lane
+template<typename T, uint N>
+inline void Vector3Lanes<T, N>::setLane(uint lane, const Vector3& vector) {
+    x[lane] = vector.x;
+    y[lane] = vector.y;
+    z[lane] = vector.z;
+}
+
+// Return the squared length of each lane
+template<typename T, uint N>
+inline Lanes<T, N> Vector3Lanes<T, N>::lengthSquare() const {
+    return dot(*this);
+}
+
+// Return the length of each lane
+template<typename T, uint N>
+inline Lanes<T, N> Vector3Lanes<T, N>::length() const {
+    return lengthSquare().getSquareRoot();
+}
+
+// Return the dot product of each lane with the lane of another vector
+template<typename T, uint N>
+inline Lanes<T, N> Vector3Lanes<T, N>::dot(const Vector3Lanes& vector) const {
+    return x * vector.x + y * vector.y + z * vector.z;
+}
+
+// Return the cross product of each lane with the lane of another vector
+template<typename T, uint N>
+inline Vector3Lanes<T, N> Vector3Lanes<T, N>::cross(const Vector3Lanes& vector) const {
+    return Vector3Lanes(y * vector.z - z * vector.y,
+                        z * vector.x - x * vector.z,
+                        x * vector.y - y * vector.x);
+}
+
+// Return the smallest component of all the lanes along each axis
+template<typename T, uint N>
+inline Vector3 Vector3Lanes<T, N>::horizontalMin() const {
+    return Vector3(x.horizontalMin(), y.horizontalMin(), z.horizontalMin());
+}
+
+// Return the largest component of all the lanes along each axis
+template<typename T, uint N>
+inline Vector3 Vector3Lanes<T, N>::horizontalMax() const {
+    return Vector3(x.horizontalMax(), y.horizontalMax(), z.horizontalMax());
+}
+
+// Overloaded operator for addition with assignment
+template<typename T, uint N>
+inline Vector3Lanes<T, N>& Vector3Lanes<T, N>::operator+=(const Vector3Lanes& vector) {
+    x += vector.x;
+    y += vector.y;
+    z += vector.z;
+    return *this;
+}
+
+// Overloaded operator for substraction with assignment
+template<typename T, uint N>
+inline Vector3Lanes<T, N>& Vector3Lanes<T, N>::operator-=(const Vector3Lanes& vector) {
+    x -= vector.x;
+    y -= vector.y;
+    z -= vector.z;
+    return *this;
+}
+
+// Overloaded operator for addition
+template<typename T, uint N>
+inline Vector3Lanes<T, N> operator+(const Vector3Lanes<T, N>& vector1, const Vector3Lanes<T, N>& vector2) {
+    return Vector3Lanes<T, N>(vector1.x + vector2.x, vector1.y + vector2.y, vector1.z + vector2.z);
+}
+
+// Overloaded operator for substraction
+template<typename T, uint N>
+inline Vector3Lanes<T, N> operator-(const Vector3Lanes<T, N>& vector1, const Vector3Lanes<T, N>& vector2) {
+    return Vector3Lanes<T, N>(vector1.x - vector2.x, vector1.y - vector2.y, vector1.z - vector2.z);
+}
+
+// Overloaded operator for the negative of vectors
+template<typename T, uint N>
+inline Vector3Lanes<T, N> operator-(const Vector3Lanes<T, N>& vector) {
+    return Vector3Lanes<T, N>(-vector.x, -vector.y, -vector.z);
+}
+
+// Overloaded operator for multiplication of each lane with a number
+template<typename T, uint N>
+inline Vector3Lanes<T, N> operator*(const Lanes<T, N>& number, const Vector3Lanes<T, N>& vector) {
+    return Vector3Lanes<T, N>(number * vector.x, number * vector.y, number * vector.z);
+}
+
+// Overloaded operator for multiplication of all the lanes with a number
+template<typename T, uint N>
+inline Vector3Lanes<T, N> operator*(T number, const Vector3Lanes<T, N>& vector) {
+    return Vector3Lanes<T, N>(number * vector.x, number * vector.y, number * vector.z);
+}
+
+// Return the vectors of the first lanes where the mask is true and of the second lanes elsewhere
+template<typename T, uint N>
+inline Vector3Lanes<T, N> select(const LaneMask<N>& mask, const Vector3Lanes<T, N>& vector1,
+                                 const Vector3Lanes<T, N>& vector2) {
+    return Vector3Lanes<T, N>(select(mask, vector1.x, vector2.x),
+                              select(mask, vector1.y, vector2.y),
+                              select(mask, vector1.z, vector2.z));
+}
+
+/// Four 3D vectors stored as a structure of arrays
+using Vector3x4 = Vector3Lanes<decimal, 4>;
+
+/// Eight 3D vectors stored as a structure of arrays
+using Vector3x8 = Vector3Lanes<decimal, 8>;
+
+}
+
+#endif
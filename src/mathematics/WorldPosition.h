@@ -0,0 +1,122 @@
+/********************************************************************************
+* ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
+* Copyright (c) 2010-2018 Daniel Chappuis                                       *
+*********************************************************************************
+*                                                                               *
+* This software is provided 'as-is', without any express or implied warranty.   *
+* In no event will the authors be held liable for any damages arising from the  *
+* use of this software.                                                         *
+*                                                                               *
+* Permission is granted to anyone to use this software for any purpose,         *
+* including commercial applications, and to alter it and redistribute it        *
+* freely, subject to the following restrictions:                                *
+*                                                                               *
+* 1. The origin of this software must not be misrepresented; you must not claim *
+*    that you wrote the original software. If you use this software in a        *
+*    product, an acknowledgment in the product documentation would be           *
+*    appreciated but is not required.                                           *
+*                                                                               *
+* 2. Altered source versions must be plainly marked as such, and must not be    *
+*    misrepresented as being the original software.                             *
+*                                                                               *
+* 3. This notice may not be removed or altered from any source distribution.    *
+*                                                                               *
+********************************************************************************/
+
+
+#ifndef REACTPHYSICS3D_WORLD_POSITION_H
+#define REACTPHYSICS3D_WORLD_POSITION_H
+
+// Libraries
+#include "Vector3.h"
+#include <string>
+
+/// ReactPhysics3D namespace
+namespace reactphysics3d {
+
+// Struct WorldPosition
+/**
+ * This class represents an absolute position in a large world. Its coordinates are always
+ * stored in double precision whatever the precision of the decimal type. The engine works
+ * with decimal coordinates relative to the origin of the world (see CollisionWorld::setOrigin())
+ * and a WorldPosition is only used to convert between the absolute and the relative positions.
+ */
+struct WorldPosition {
+
+    public:
+
+        // -------------------- Attributes -------------------- //
+
+        /// Component x
+        double x;
+
+        /// Component y
+        double y;
+
+        /// Component z
+        double z;
+
+        // -------------------- Methods -------------------- //
+
+        /// Constructor
+        WorldPosition();
+
+        /// Constructor with arguments
+        WorldPosition(double newX, double newY, double newZ);
+
+        /// Return the position moved by a relative vector
+        WorldPosition operator+(const Vector3& vector) const;
+
+        /// Return the vector from another position to this position (in decimal precision)
+        Vector3 operator-(const WorldPosition& position) const;
+
+        /// Overloaded operator for the equality condition
+        bool operator==(const WorldPosition& position) const;
+
+        /// Overloaded operator for the not equal condition
+        bool operator!=(const WorldPosition& position) const;
+
+        /// Return the string representation
+        std::string to_string() const;
+};
+
+// Constructor
+inline WorldPosition::WorldPosition() : x(0.0), y(0.0), z(0.0) {
+
+}
+
+// Constructor with arguments
+inline WorldPosition::WorldPosition(double newX, double newY, double newZ) : x(newX), y(newY), z(newZ) {
+
+}
+
+// Return the position moved by a relative vector
+inline WorldPosition WorldPosition::operator+(const Vector3& vector) const {
+    return WorldPosition(x + double(vector.x), y + double(vector.y), z + double(vector.z));
+}
+
+// Return the vector from another position to this position (in decimal precision)
+/// The difference is computed in double precision before it is rounded so that the
+/// result is accurate when the two positions are close to each other.
+inline Vector3 WorldPosition::operator-(const WorldPosition& position) const {
+    return Vector3(decimal(x - position.x), decimal(y - position.y), decimal(z - position.z));
+}
+
+// Overloaded operator for the equality condition
+inline bool WorldPosition::operator==(const WorldPosition& position) const {
+    return x == position.x && y == position.y && z == position.z;
+}
+
+// Overloaded operator for the not equal condition
+inline bool WorldPosition::operator!=(const WorldPosition& position) const {
+    return !(*this == position);
+}
+
+// Return the string representation
+inline std::string WorldPosition::to_string() const {
+    return "WorldPosition(" + std::to_string(x) + "," + std::to_string(y) + "," + std::to_string(z) + ")";
+}
+
+}
+
+#endif
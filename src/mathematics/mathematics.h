@@ -34,6 +34,11 @@
 #include "Vector2.h"
 #include "Transform.h"
 #include "Ray.h"
+#include "Lanes.h"
+#include "Vector3Lanes.h"
+#include "QuaternionLanes.h"
+#include "TransformLanes.h"
+#include "WorldPosition.h"
 #include "configuration.h"
 #include "mathematics_functions.h"
 #include <cstdio>
@@ -221,14 +221,14 @@ decimal reactphysics3d::computePointToLineDistance(const Vector3& linePointA, co
 
 // Clip a segment against multiple planes and return the clipped segment vertices
 // This method implements the Sutherland–Hodgman clipping algorithm
-List<Vector3> reactphysics3d::clipSegmentWithPlanes(const Vector3& segA, const Vector3& segB,
-                                                           const List<Vector3>& planesPoints,
-                                                           const List<Vector3>& planesNormals,
-                                                           MemoryAllocator& allocator) {
+ClippingList<Vector3> reactphysics3d::clipSegmentWithPlanes(const Vector3& segA, const Vector3& segB,
+                                                            const ClippingList<Vector3>& planesPoints,
+                                                            const ClippingList<Vector3>& planesNormals,
+                                                            MemoryAllocator& allocator) {
     assert(planesPoints.size() == planesNormals.size());
 
-    List<Vector3> inputVertices(allocator, 2);
-    List<Vector3> outputVertices(allocator, 2);
+    ClippingList<Vector3> inputVertices(allocator);
+    ClippingList<Vector3> outputVertices(allocator);
 
     inputVertices.add(segA);
     inputVertices.add(segB);
@@ -296,21 +296,38 @@ List<Vector3> reactphysics3d::clipSegmentWithPlanes(const Vector3& segA, const V
 
 // Clip a polygon against multiple planes and return the clipped polygon vertices
 // This method implements the Sutherland–Hodgman clipping algorithm
-List<Vector3> reactphysics3d::clipPolygonWithPlanes(const List<Vector3>& polygonVertices, const List<Vector3>& planesPoints,
-                                                    const List<Vector3>& planesNormals, MemoryAllocator& allocator) {
+// If the identifiers of the vertices are given, each clipped vertex gets the identifier of its
+// original vertex or the identifier of its segment and clipping plane if it is an intersection
+static ClippingList<Vector3> clipPolygonVerticesWithPlanes(const ClippingList<Vector3>& polygonVertices,
+                                                           const ClippingList<uint32>* polygonVerticesIds,
+                                                           const ClippingList<Vector3>& planesPoints,
+                                                           const ClippingList<Vector3>& planesNormals,
+                                                           ClippingList<uint32>* outClippedVerticesIds, MemoryAllocator& allocator) {
 
     assert(planesPoints.size() == planesNormals.size());
+    assert((polygonVerticesIds == nullptr) == (outClippedVerticesIds == nullptr));
 
         uint nbMaxElements = polygonVertices.size() + planesPoints.size();
-        List<Vector3> inputVertices(allocator, nbMaxElements);
-        List<Vector3> outputVertices(allocator, nbMaxElements);
+        ClippingList<Vector3> inputVertices(allocator, nbMaxElements);
+        ClippingList<Vector3> outputVertices(allocator, nbMaxElements);
 
         inputVertices.addRange(polygonVertices);
 
+        ClippingList<uint32> inputIds(allocator);
+        ClippingList<uint32> outputIds(allocator);
+        const bool hasIds = polygonVerticesIds != nullptr;
+        if (hasIds) {
+            assert(polygonVerticesIds->size() == polygonVertices.size());
+            inputIds.reserve(nbMaxElements);
+            outputIds.reserve(nbMaxElements);
+            inputIds.addRange(*polygonVerticesIds);
+        }
+
         // For each clipping plane
         for (uint p=0; p<planesPoints.size(); p++) {
 
             outputVertices.clear();
+            outputIds.clear();
 
             uint nbInputVertices = inputVertices.size();
             uint vStart = nbInputVertices - 1;
@@ -335,14 +352,17 @@ List<Vector3> reactphysics3d::clipPolygonWithPlanes(const List<Vector3>& polygon
 
                         if (t >= decimal(0) && t <= decimal(1.0)) {
                             outputVertices.add(v1 + t * (v2 - v1));
+                            if (hasIds) outputIds.add(combineIdentifiers(combineIdentifiers(inputIds[vStart], inputIds[vEnd]), p));
                         }
                         else {
                             outputVertices.add(v2);
+                            if (hasIds) outputIds.add(inputIds[vEnd]);
                         }
                     }
 
                     // Add the second vertex
                     outputVertices.add(v2);
+                    if (hasIds) outputIds.add(inputIds[vEnd]);
                 }
                 else {  // If the second vertex is behind the clipping plane
 
@@ -354,9 +374,11 @@ List<Vector3> reactphysics3d::clipPolygonWithPlanes(const List<Vector3>& polygon
 
                         if (t >= decimal(0.0) && t <= decimal(1.0)) {
                             outputVertices.add(v1 + t * (v2 - v1));
+                            if (hasIds) outputIds.add(combineIdentifiers(combineIdentifiers(inputIds[vStart], inputIds[vEnd]), p));
                         }
                         else {
                             outputVertices.add(v1);
+                            if (hasIds) outputIds.add(inputIds[vStart]);
                         }
                     }
                 }
@@ -365,11 +387,54 @@ List<Vector3> reactphysics3d::clipPolygonWithPlanes(const List<Vector3>& polygon
             }
 
             inputVertices = outputVertices;
+            if (hasIds) inputIds = outputIds;
+        }
+
+        if (hasIds) {
+            outClippedVerticesIds->clear();
+            outClippedVerticesIds->addRange(outputIds);
         }
 
         return outputVertices;
 }
 
+// Clip a polygon against multiple planes and return the clipped polygon vertices
+// This method implements the Sutherland–Hodgman clipping algorithm
+ClippingList<Vector3> reactphysics3d::clipPolygonWithPlanes(const ClippingList<Vector3>& polygonVertices,
+                                                            const ClippingList<Vector3>& planesPoints,
+                                                            const ClippingList<Vector3>& planesNormals,
+                                                            MemoryAllocator& allocator) {
+
+    return clipPolygonVerticesWithPlanes(polygonVertices, nullptr, planesPoints, planesNormals, nullptr, allocator);
+}
+
+// Clip a polygon against multiple planes and return the clipped polygon vertices and their identifiers
+/// Each clipped vertex gets the identifier of the polygon vertex it comes from or, if it is the
+/// intersection between an edge of the polygon and a clipping plane, an identifier computed from
+/// the identifiers of the edge vertices and the index of the plane. The identifiers of the clipped
+/// vertices are therefore the same as long as the same features of the polygon are clipped by
+/// the same planes.
+ClippingList<Vector3> reactphysics3d::clipPolygonWithPlanes(const ClippingList<Vector3>& polygonVertices,
+                                                            const ClippingList<uint32>& polygonVerticesIds,
+                                                            const ClippingList<Vector3>& planesPoints,
+                                                            const ClippingList<Vector3>& planesNormals,
+                                                            ClippingList<uint32>& outClippedVerticesIds,
+                                                            MemoryAllocator& allocator) {
+
+    return clipPolygonVerticesWithPlanes(polygonVertices, &polygonVerticesIds, planesPoints, planesNormals,
+                                         &outClippedVerticesIds, allocator);
+}
+
+// Combine two identifiers into a new one
+/// The result depends on the order of the two identifiers.
+uint32 reactphysics3d::combineIdentifiers(uint32 id1, uint32 id2) {
+
+    std::size_t seed = id1;
+    hash_combine<uint32>(seed, id2);
+
+    return static_cast<uint32>(seed);
+}
+
 // Project a point onto a plane that is given by a point and its unit length normal
 Vector3 reactphysics3d::projectPointOntoPlane(const Vector3& point, const Vector3& unitPlaneNormal, const Vector3& planePoint) {
 	return point - unitPlaneNormal.dot(point - planePoint) * unitPlaneNormal;
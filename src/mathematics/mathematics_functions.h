@@ -33,6 +33,8 @@
 #include <cassert>
 #include <cmath>
 #include "containers/List.h"
+#include "containers/SmallList.h"
+#include "containers/containers_common.h"
 
 /// ReactPhysics3D namespace
 namespace reactphysics3d {
@@ -40,6 +42,11 @@ namespace reactphysics3d {
 struct Vector3;
 struct Vector2;
 
+/// List of the vertices, planes and identifiers used by the clipping functions (the clipped
+/// polygons usually have a few vertices that are stored without allocating memory)
+template<typename T>
+using ClippingList = SmallList<T, 8>;
+
 // ---------- Mathematics functions ---------- //
 
 /// Function to test if two real numbers are (almost) equal
@@ -111,14 +118,25 @@ decimal computePlaneSegmentIntersection(const Vector3& segA, const Vector3& segB
 decimal computePointToLineDistance(const Vector3& linePointA, const Vector3& linePointB, const Vector3& point);
 
 /// Clip a segment against multiple planes and return the clipped segment vertices
-List<Vector3> clipSegmentWithPlanes(const Vector3& segA, const Vector3& segB,
-                                                           const List<Vector3>& planesPoints,
-                                                           const List<Vector3>& planesNormals,
-                                                           MemoryAllocator& allocator);
+ClippingList<Vector3> clipSegmentWithPlanes(const Vector3& segA, const Vector3& segB,
+                                            const ClippingList<Vector3>& planesPoints,
+                                            const ClippingList<Vector3>& planesNormals,
+                                            MemoryAllocator& allocator);
 
 /// Clip a polygon against multiple planes and return the clipped polygon vertices
-List<Vector3> clipPolygonWithPlanes(const List<Vector3>& polygonVertices, const List<Vector3>& planesPoints,
-                                    const List<Vector3>& planesNormals, MemoryAllocator& allocator);
+ClippingList<Vector3> clipPolygonWithPlanes(const ClippingList<Vector3>& polygonVertices,
+                                            const ClippingList<Vector3>& planesPoints,
+                                            const ClippingList<Vector3>& planesNormals, MemoryAllocator& allocator);
+
+/// Clip a polygon against multiple planes and return the clipped polygon vertices and their identifiers
+ClippingList<Vector3> clipPolygonWithPlanes(const ClippingList<Vector3>& polygonVertices,
+                                            const ClippingList<uint32>& polygonVerticesIds,
+                                            const ClippingList<Vector3>& planesPoints,
+                                            const ClippingList<Vector3>& planesNormals,
+                                            ClippingList<uint32>& outClippedVerticesIds, MemoryAllocator& allocator);
+
+/// Combine two identifiers into a new one
+uint32 combineIdentifiers(uint32 id1, uint32 id2);
 
 /// Project a point onto a plane that is given by a point and its unit length normal
 Vector3 projectPointOntoPlane(const Vector3& point, const Vector3& planeNormal, const Vector3& planePoint);
@@ -0,0 +1,155 @@
+/********************************************************************************
+* ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
+* Copyright (c) 2010-2018 Daniel Chappuis                                       *
+*********************************************************************************
+*                                                                               *
+* This software is provided 'as-is', without any express or implied warranty.   *
+* In no event will the authors be held liable for any damages arising from the  *
+* use of this software.                                                         *
+*                                                                               *
+* Permission is granted to anyone to use this software for any purpose,         *
+* including commercial applications, and to alter it and redistribute it        *
+* freely, subject to the following restrictions:                                *
+*                                                                               *
+* 1. The origin of this software must not be misrepresented; you must not claim *
+*    that you wrote the original software. If you use this software in a        *
+*    product, an acknowledgment in the product documentation would be           *
+*    appreciated but is not required.                                           *
+*                                                                               *
+* 2. Altered source versions must be plainly marked as such, and must not be    *
+*    misrepresented as being the original software.                             *
+*                                                                               *
+* 3. This notice may not be removed or altered from any source distribution.    *
+*                                                                               *
+********************************************************************************/
+
+// Libraries
+#include "ArenaAllocator.h"
+#include <cassert>
+#include <cstdint>
+
+using namespace reactphysics3d;
+
+// Header of a memory block allocated when the buffer of the arena is full
+struct OverflowBlockHeader {
+
+    /// Next overflow block
+    void* next;
+
+    /// Total size (in bytes) of the block (including the header)
+    size_t size;
+};
+
+// Return the offset of the first aligned location of a block
+static size_t alignedOffset(size_t offset) {
+    return (offset + CACHE_LINE_SIZE - 1) & ~(CACHE_LINE_SIZE - 1);
+}
+
+// Return the first location aligned on a cache line after a given pointer
+static char* alignPointer(void* pointer) {
+    const uintptr_t address = reinterpret_cast<uintptr_t>(pointer);
+    return reinterpret_cast<char*>(alignedOffset(static_cast<size_t>(address)));
+}
+
+// Constructor
+ArenaAllocator::ArenaAllocator(MemoryAllocator& baseAllocator)
+    : mBaseAllocator(baseAllocator), mMemoryBlock(nullptr), mMemoryBufferStart(nullptr), mCapacity(0),
+      mCurrentOffset(0), mNbAllocatedBytes(0), mHighWaterMark(0), mOverflowBlocks(nullptr) {
+
+    allocateBuffer(INIT_NB_BYTES);
+}
+
+// Destructor
+ArenaAllocator::~ArenaAllocator() {
+
+    releaseOverflowBlocks();
+
+    mBaseAllocator.release(mMemoryBlock, mCapacity + CACHE_LINE_SIZE);
+}
+
+// Release the memory blocks allocated because the buffer was full
+void ArenaAllocator::releaseOverflowBlocks() {
+
+    while (mOverflowBlocks != nullptr) {
+        OverflowBlockHeader* header = static_cast<OverflowBlockHeader*>(mOverflowBlocks);
+        mOverflowBlocks = header->next;
+        mBaseAllocator.release(header, header->size);
+    }
+}
+
+// Allocate the memory buffer with a given capacity
+void ArenaAllocator::allocateBuffer(size_t capacity) {
+
+    // Release the previous buffer
+    if (mMemoryBlock != nullptr) {
+        mBaseAllocator.release(mMemoryBlock, mCapacity + CACHE_LINE_SIZE);
+    }
+
+    mCapacity = alignedOffset(capacity);
+
+    // Allocate one more cache line to be able to align the beginning of the buffer
+    mMemoryBlock = mBaseAllocator.allocate(mCapacity + CACHE_LINE_SIZE);
+    assert(mMemoryBlock != nullptr);
+    mMemoryBufferStart = alignPointer(mMemoryBlock);
+}
+
+// Allocate memory of a given size (in bytes) and return a pointer to the
+// allocated memory. The returned memory is aligned on a cache line.
+void* ArenaAllocator::allocate(size_t size) {
+
+    const size_t alignedSize = alignedOffset(size);
+    mNbAllocatedBytes += alignedSize;
+    if (mNbAllocatedBytes > mHighWaterMark) {
+        mHighWaterMark = mNbAllocatedBytes;
+    }
+
+    // If there is enough remaining memory in the buffer
+    if (mCurrentOffset + alignedSize <= mCapacity) {
+
+        void* nextAvailableMemory = mMemoryBufferStart + mCurrentOffset;
+        mCurrentOffset += alignedSize;
+
+        return nextAvailableMemory;
+    }
+
+    // Otherwise, allocate a new block with the base allocator. It will be
+    // released (and the buffer will grow) on the next reset() call
+    const size_t blockSize = sizeof(OverflowBlockHeader) + CACHE_LINE_SIZE + alignedSize;
+    void* block = mBaseAllocator.allocate(blockSize);
+    assert(block != nullptr);
+
+    OverflowBlockHeader* header = static_cast<OverflowBlockHeader*>(block);
+    header->next = mOverflowBlocks;
+    header->size = blockSize;
+    mOverflowBlocks = block;
+
+    return alignPointer(static_cast<char*>(block) + sizeof(OverflowBlockHeader));
+}
+
+// Release previously allocated memory.
+/// The memory of the arena is only released by the reset() method.
+void ArenaAllocator::release(void* pointer, size_t size) {
+
+}
+
+// Release all the memory allocated since the last reset
+/// If the buffer was too small since the last reset, it grows (at least doubles)
+/// so that all the allocations fit in the buffer next time.
+void ArenaAllocator::reset() {
+
+    // If some memory had to be allocated because the buffer was full
+    if (mOverflowBlocks != nullptr) {
+
+        releaseOverflowBlocks();
+
+        // Grow the buffer geometrically
+        size_t newCapacity = mCapacity * 2;
+        while (newCapacity < mNbAllocatedBytes) {
+            newCapacity *= 2;
+        }
+        allocateBuffer(newCapacity);
+    }
+
+    mCurrentOffset = 0;
+    mNbAllocatedBytes = 0;
+}
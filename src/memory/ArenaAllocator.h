@@ -0,0 +1,134 @@
+/********************************************************************************
+* ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
+* Copyright (c) 2010-2018 Daniel Chappuis                                       *
+*********************************************************************************
+*                                                                               *
+* This software is provided 'as-is', without any express or implied warranty.   *
+* In no event will the authors be held liable for any damages arising from the  *
+* use of this software.                                                         *
+*                                                                               *
+* Permission is granted to anyone to use this software for any purpose,         *
+* including commercial applications, and to alter it and redistribute it        *
+* freely, subject to the following restrictions:                                *
+*                                                                               *
+* 1. The origin of this software must not be misrepresented; you must not claim *
+*    that you wrote the original software. If you use this software in a        *
+*    product, an acknowledgment in the product documentation would be           *
+*    appreciated but is not required.                                           *
+*                                                                               *
+* 2. Altered source versions must be plainly marked as such, and must not be    *
+*    misrepresented as being the original software.                             *
+*                                                                               *
+* 3. This notice may not be removed or altered from any source distribution.    *
+*                                                                               *
+********************************************************************************/
+
+#ifndef REACTPHYSICS3D_ARENA_ALLOCATOR_H
+#define REACTPHYSICS3D_ARENA_ALLOCATOR_H
+
+// Libraries
+#include "MemoryAllocator.h"
+#include "configuration.h"
+
+/// ReactPhysics3D namespace
+namespace reactphysics3d {
+
+// Class ArenaAllocator
+/**
+ * This class represents a persistent arena used to allocate memory that is
+ * only needed until the next call to reset(). Contrary to the global single frame
+ * allocator, each arena owns its memory block and keeps it from one frame to the
+ * next. Every allocation is aligned on a cache line. When a frame needs more memory
+ * than the capacity of the block, the missing memory is allocated with the base
+ * allocator and the block grows geometrically on the next reset() so that no
+ * allocation is made in the steady state.
+ */
+class ArenaAllocator : public SingleFrameAllocator {
+
+    private :
+
+        // -------------------- Constants -------------------- //
+
+        /// Initial capacity (in bytes) of the arena
+        static const size_t INIT_NB_BYTES = 16384;
+
+        // -------------------- Attributes -------------------- //
+
+        /// Base memory allocator used to allocate the memory block
+        MemoryAllocator& mBaseAllocator;
+
+        /// Memory block allocated with the base allocator (not aligned)
+        void* mMemoryBlock;
+
+        /// Pointer to the beginning of the aligned memory buffer
+        char* mMemoryBufferStart;
+
+        /// Total size (in bytes) of the aligned memory buffer
+        size_t mCapacity;
+
+        /// Offset of the next available memory location in the buffer
+        size_t mCurrentOffset;
+
+        /// Number of bytes allocated since the last reset (including the overflow)
+        size_t mNbAllocatedBytes;
+
+        /// Largest number of bytes allocated between two resets
+        size_t mHighWaterMark;
+
+        /// Linked list of the memory blocks allocated since the last reset
+        /// because the buffer was full
+        void* mOverflowBlocks;
+
+        // -------------------- Methods -------------------- //
+
+        /// Allocate the memory buffer with a given capacity
+        void allocateBuffer(size_t capacity);
+
+        /// Release the memory blocks allocated because the buffer was full
+        void releaseOverflowBlocks();
+
+    public :
+
+        // -------------------- Methods -------------------- //
+
+        /// Constructor
+        ArenaAllocator(MemoryAllocator& baseAllocator);
+
+        /// Destructor
+        virtual ~ArenaAllocator() override;
+
+        /// Deleted copy-constructor
+        ArenaAllocator(const ArenaAllocator& allocator) = delete;
+
+        /// Deleted assignment operator
+        ArenaAllocator& operator=(const ArenaAllocator& allocator) = delete;
+
+        /// Allocate memory of a given size (in bytes)
+        virtual void* allocate(size_t size) override;
+
+        /// Release previously allocated memory.
+        virtual void release(void* pointer, size_t size) override;
+
+        /// Release all the memory allocated since the last reset
+        virtual void reset() override;
+
+        /// Return the capacity (in bytes) of the memory buffer
+        size_t getCapacity() const;
+
+        /// Return the largest number of bytes allocated between two resets
+        size_t getHighWaterMark() const;
+};
+
+// Return the capacity (in bytes) of the memory buffer
+inline size_t ArenaAllocator::getCapacity() const {
+    return mCapacity;
+}
+
+// Return the largest number of bytes allocated between two resets
+inline size_t ArenaAllocator::getHighWaterMark() const {
+    return mHighWaterMark;
+}
+
+}
+
+#endif
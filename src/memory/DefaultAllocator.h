@@ -28,8 +28,13 @@
 
 // Libraries
 #include "memory/MemoryAllocator.h"
+#include "configuration.h"
 #include <cstdlib>
 
+#ifdef IS_ALLOCATION_CHECK_ACTIVE
+#include <atomic>
+#endif
+
 /// ReactPhysics3D namespace
 namespace reactphysics3d {
 
@@ -39,6 +44,18 @@ namespace reactphysics3d {
  */
 class DefaultAllocator : public MemoryAllocator {
 
+#ifdef IS_ALLOCATION_CHECK_ACTIVE
+
+    private:
+
+        /// Return the counter of the allocations of all the default allocators
+        static std::atomic<uint64>& getNbAllocationsCounter() {
+            static std::atomic<uint64> nbAllocations(0);
+            return nbAllocations;
+        }
+
+#endif
+
     public:
 
         /// Destructor
@@ -50,6 +67,11 @@ class DefaultAllocator : public MemoryAllocator {
         /// Allocate memory of a given size (in bytes) and return a pointer to the
         /// allocated memory.
         virtual void* allocate(size_t size) override {
+
+#ifdef IS_ALLOCATION_CHECK_ACTIVE
+            getNbAllocationsCounter().fetch_add(1, std::memory_order_relaxed);
+#endif
+
             return malloc(size);
         }
 
@@ -57,6 +79,15 @@ class DefaultAllocator : public MemoryAllocator {
         virtual void release(void* pointer, size_t size) override {
             free(pointer);
         }
+
+#ifdef IS_ALLOCATION_CHECK_ACTIVE
+
+        /// Return the number of allocations of all the default allocators (in all the threads)
+        static uint64 getNbAllocations() {
+            return getNbAllocationsCounter().load(std::memory_order_relaxed);
+        }
+
+#endif
 };
 
 }
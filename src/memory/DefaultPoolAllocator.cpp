@@ -28,22 +28,36 @@
 #include "MemoryManager.h"
 #include <cstdlib>
 #include <cassert>
+#include <algorithm>
 
 using namespace reactphysics3d;
 
 // Initialization of static variables
-bool DefaultPoolAllocator::isMapSizeToHeadIndexInitialized = false;
 size_t DefaultPoolAllocator::mUnitSizes[NB_HEAPS];
-int DefaultPoolAllocator::mMapSizeToHeapIndex[MAX_UNIT_SIZE + 1];
+int DefaultPoolAllocator::mMapSizeToHeapIndex[MAX_SMALL_UNIT_SIZE + 1];
+int DefaultPoolAllocator::mMapLargeSizeToHeapIndex[MAX_UNIT_SIZE / LARGE_UNIT_SIZE_GRANULARITY + 1];
 
 // Constructor
-DefaultPoolAllocator::DefaultPoolAllocator() {
+/**
+ * @param maxUnitSize Maximum size (in bytes) of the memory allocated by the pool (at most
+ *                    MAX_UNIT_SIZE). The larger allocations are made with the base allocator.
+ * @param releaseWatermark Memory (in bytes) of the free memory units above which the memory
+ *                         blocks without used units are given back to the base allocator
+ * @param baseAllocator Allocator of the memory blocks (the global base allocator of the
+ *                      MemoryManager if null)
+ */
+DefaultPoolAllocator::DefaultPoolAllocator(size_t maxUnitSize, size_t releaseWatermark, MemoryAllocator* baseAllocator)
+                     : mBaseAllocator(baseAllocator != nullptr ? baseAllocator : &MemoryManager::getBaseAllocator()),
+                       mMaxUnitSize(maxUnitSize), mReleaseWatermark(releaseWatermark),
+                       mNextReleaseNbFreeBytes(releaseWatermark), mNbFreeBytes(0) {
+
+    assert(maxUnitSize <= MAX_UNIT_SIZE);
 
     // Allocate some memory to manage the blocks
     mNbAllocatedMemoryBlocks = 64;
     mNbCurrentMemoryBlocks = 0;
     const size_t sizeToAllocate = mNbAllocatedMemoryBlocks * sizeof(MemoryBlock);
-    mMemoryBlocks = static_cast<MemoryBlock*>(MemoryManager::getBaseAllocator().allocate(sizeToAllocate));
+    mMemoryBlocks = static_cast<MemoryBlock*>(mBaseAllocator->allocate(sizeToAllocate));
     memset(mMemoryBlocks, 0, sizeToAllocate);
     memset(mFreeMemoryUnits, 0, sizeof(mFreeMemoryUnits));
 
@@ -51,31 +65,55 @@ DefaultPoolAllocator::DefaultPoolAllocator() {
         mNbTimesAllocateMethodCalled = 0;
 #endif
 
-    // If the mMapSizeToHeapIndex has not been initialized yet
-    if (!isMapSizeToHeadIndexInitialized) {
+    // The tables are shared by all the pool allocators and initialized once (a static
+    // local variable is initialized safely even if several threads create a pool allocator)
+    static const bool isHeapsInitialized = initializeHeaps();
+    (void)isHeapsInitialized;
+}
 
-        // Initialize the array that contains the sizes the memory units that will
-        // be allocated in each different heap
-        for (uint i=0; i < NB_HEAPS; i++) {
-            mUnitSizes[i] = (i+1) * 8;
-        }
+// Initialize the sizes of the memory units and the lookup tables of the heaps
+bool DefaultPoolAllocator::initializeHeaps() {
 
-        // Initialize the lookup table that maps the size to allocated to the
-        // corresponding heap we will use for the allocation
-        uint j = 0;
-        mMapSizeToHeapIndex[0] = -1;    // This element should not be used
-        for (uint i=1; i <= MAX_UNIT_SIZE; i++) {
-            if (i <= mUnitSizes[j]) {
-                mMapSizeToHeapIndex[i] = j;
-            }
-            else {
-                j++;
-                mMapSizeToHeapIndex[i] = j;
-            }
+    // Initialize the array that contains the sizes the memory units that will
+    // be allocated in each different heap
+    for (uint i=0; i < NB_SMALL_HEAPS; i++) {
+        mUnitSizes[i] = (i+1) * 8;
+    }
+
+    // The sizes of the large memory units have four classes per power of two
+    for (uint i=0; i < NB_LARGE_HEAPS; i++) {
+        const size_t powerOfTwo = MAX_SMALL_UNIT_SIZE << (i / 4);
+        mUnitSizes[NB_SMALL_HEAPS + i] = powerOfTwo + (i % 4 + 1) * (powerOfTwo / 4);
+    }
+    assert(mUnitSizes[NB_HEAPS - 1] == MAX_UNIT_SIZE);
+
+    // Initialize the lookup table that maps the size to allocated to the
+    // corresponding heap we will use for the allocation
+    uint j = 0;
+    mMapSizeToHeapIndex[0] = -1;    // This element should not be used
+    // The heaps whose unit size is not a multiple of the alignment of the vectors are
+    // skipped so that all the returned memory units are aligned (see VECTOR_ALIGNMENT)
+    for (uint i=1; i <= MAX_SMALL_UNIT_SIZE; i++) {
+        while (i > mUnitSizes[j] || mUnitSizes[j] % VECTOR_ALIGNMENT != 0) {
+            j++;
         }
+        mMapSizeToHeapIndex[i] = j;
+    }
 
-        isMapSizeToHeadIndexInitialized = true;
+    // Initialize the lookup table of the large memory units (the sizes of the
+    // large memory units are multiples of the granularity)
+    j = NB_SMALL_HEAPS;
+    for (uint i=0; i <= MAX_UNIT_SIZE / LARGE_UNIT_SIZE_GRANULARITY; i++) {
+        const size_t size = i * LARGE_UNIT_SIZE_GRANULARITY;
+        if (size <= MAX_SMALL_UNIT_SIZE) {
+            mMapLargeSizeToHeapIndex[i] = -1;    // This element should not be used
+            continue;
+        }
+        while (size > mUnitSizes[j]) j++;
+        mMapLargeSizeToHeapIndex[i] = j;
     }
+
+    return true;
 }
 
 // Destructor
@@ -83,10 +121,10 @@ DefaultPoolAllocator::~DefaultPoolAllocator() {
 
     // Release the memory allocated for each block
     for (uint i=0; i<mNbCurrentMemoryBlocks; i++) {
-        MemoryManager::getBaseAllocator().release(mMemoryBlocks[i].memoryUnits, BLOCK_SIZE);
+        mBaseAllocator->release(mMemoryBlocks[i].memoryUnits, getBlockSize(mMemoryBlocks[i].heapIndex));
     }
 
-    MemoryManager::getBaseAllocator().release(mMemoryBlocks, mNbAllocatedMemoryBlocks * sizeof(MemoryBlock));
+    mBaseAllocator->release(mMemoryBlocks, mNbAllocatedMemoryBlocks * sizeof(MemoryBlock));
 
 #ifndef NDEBUG
         // Check that the allocate() and release() methods have been called the same
@@ -108,15 +146,16 @@ void* DefaultPoolAllocator::allocate(size_t size) {
 #endif
 
     // If we need to allocate more than the maximum memory unit size
-    if (size > MAX_UNIT_SIZE) {
+    if (size > mMaxUnitSize) {
 
         // Allocate memory using default allocation
-        return MemoryManager::getBaseAllocator().allocate(size);
+        return mBaseAllocator->allocate(size);
     }
 
     // Get the index of the heap that will take care of the allocation request
-    int indexHeap = mMapSizeToHeapIndex[size];
+    int indexHeap = getHeapIndex(size);
     assert(indexHeap >= 0 && indexHeap < NB_HEAPS);
+    const size_t unitSize = mUnitSizes[indexHeap];
 
     // If there still are free memory units in the corresponding heap
     if (mFreeMemoryUnits[indexHeap] != nullptr) {
@@ -124,49 +163,94 @@ void* DefaultPoolAllocator::allocate(size_t size) {
         // Return a pointer to the memory unit
         MemoryUnit* unit = mFreeMemoryUnits[indexHeap];
         mFreeMemoryUnits[indexHeap] = unit->nextUnit;
+        mNbFreeBytes -= unitSize;
         return unit;
     }
     else {  // If there is no more free memory units in the corresponding heap
 
-        // If we need to allocate more memory to contains the blocks
-        if (mNbCurrentMemoryBlocks == mNbAllocatedMemoryBlocks) {
+        // Allocate a new memory block for the corresponding heap
+        allocateMemoryBlock(indexHeap);
 
-            // Allocate more memory to contain the blocks
-            MemoryBlock* currentMemoryBlocks = mMemoryBlocks;
-            mNbAllocatedMemoryBlocks += 64;
-            mMemoryBlocks = static_cast<MemoryBlock*>(MemoryManager::getBaseAllocator().allocate(mNbAllocatedMemoryBlocks * sizeof(MemoryBlock)));
-            memcpy(mMemoryBlocks, currentMemoryBlocks, mNbCurrentMemoryBlocks * sizeof(MemoryBlock));
-            memset(mMemoryBlocks + mNbCurrentMemoryBlocks, 0, 64 * sizeof(MemoryBlock));
-            MemoryManager::getBaseAllocator().release(currentMemoryBlocks, mNbCurrentMemoryBlocks * sizeof(MemoryBlock));
-        }
+        // Return the pointer to the first memory unit of the new allocated block
+        MemoryUnit* unit = mFreeMemoryUnits[indexHeap];
+        mFreeMemoryUnits[indexHeap] = unit->nextUnit;
+        mNbFreeBytes -= unitSize;
+        return unit;
+    }
+}
 
-        // Allocate a new memory blocks for the corresponding heap and divide it in many
-        // memory units
-        MemoryBlock* newBlock = mMemoryBlocks + mNbCurrentMemoryBlocks;
-        newBlock->memoryUnits = static_cast<MemoryUnit*>(MemoryManager::getBaseAllocator().allocate(BLOCK_SIZE));
-        assert(newBlock->memoryUnits != nullptr);
-        size_t unitSize = mUnitSizes[indexHeap];
-        uint nbUnits = BLOCK_SIZE / unitSize;
-        assert(nbUnits * unitSize <= BLOCK_SIZE);
-        void* memoryUnitsStart = static_cast<void*>(newBlock->memoryUnits);
-        char* memoryUnitsStartChar = static_cast<char*>(memoryUnitsStart);
-        for (size_t i=0; i < nbUnits - 1; i++) {
-            void* unitPointer = static_cast<void*>(memoryUnitsStartChar + unitSize * i);
-            void* nextUnitPointer = static_cast<void*>(memoryUnitsStartChar + unitSize * (i+1));
-            MemoryUnit* unit = static_cast<MemoryUnit*>(unitPointer);
-            MemoryUnit* nextUnit = static_cast<MemoryUnit*>(nextUnitPointer);
-            unit->nextUnit = nextUnit;
-        }
-        void* lastUnitPointer = static_cast<void*>(memoryUnitsStartChar + unitSize*(nbUnits-1));
-        MemoryUnit* lastUnit = static_cast<MemoryUnit*>(lastUnitPointer);
-        lastUnit->nextUnit = nullptr;
+// Allocate a new memory block for a heap, add its units to the free units and
+// return their number
+uint DefaultPoolAllocator::allocateMemoryBlock(int indexHeap) {
 
-        // Add the new allocated block into the list of free memory units in the heap
-        mFreeMemoryUnits[indexHeap] = newBlock->memoryUnits->nextUnit;
-        mNbCurrentMemoryBlocks++;
+    const size_t unitSize = mUnitSizes[indexHeap];
 
-        // Return the pointer to the first memory unit of the new allocated block
-        return newBlock->memoryUnits;
+    // If we need to allocate more memory to contains the blocks
+    if (mNbCurrentMemoryBlocks == mNbAllocatedMemoryBlocks) {
+
+        // Allocate more memory to contain the blocks
+        MemoryBlock* currentMemoryBlocks = mMemoryBlocks;
+        mNbAllocatedMemoryBlocks += 64;
+        mMemoryBlocks = static_cast<MemoryBlock*>(mBaseAllocator->allocate(mNbAllocatedMemoryBlocks * sizeof(MemoryBlock)));
+        memcpy(mMemoryBlocks, currentMemoryBlocks, mNbCurrentMemoryBlocks * sizeof(MemoryBlock));
+        memset(mMemoryBlocks + mNbCurrentMemoryBlocks, 0, 64 * sizeof(MemoryBlock));
+        mBaseAllocator->release(currentMemoryBlocks, mNbCurrentMemoryBlocks * sizeof(MemoryBlock));
+    }
+
+    // Allocate a new memory blocks for the corresponding heap and divide it in many
+    // memory units
+    const size_t blockSize = getBlockSize(indexHeap);
+    MemoryBlock* newBlock = mMemoryBlocks + mNbCurrentMemoryBlocks;
+    newBlock->memoryUnits = static_cast<MemoryUnit*>(mBaseAllocator->allocate(blockSize));
+    newBlock->heapIndex = indexHeap;
+    assert(newBlock->memoryUnits != nullptr);
+    uint nbUnits = blockSize / unitSize;
+    assert(nbUnits * unitSize <= blockSize);
+    void* memoryUnitsStart = static_cast<void*>(newBlock->memoryUnits);
+    char* memoryUnitsStartChar = static_cast<char*>(memoryUnitsStart);
+    for (size_t i=0; i < nbUnits - 1; i++) {
+        void* unitPointer = static_cast<void*>(memoryUnitsStartChar + unitSize * i);
+        void* nextUnitPointer = static_cast<void*>(memoryUnitsStartChar + unitSize * (i+1));
+        MemoryUnit* unit = static_cast<MemoryUnit*>(unitPointer);
+        MemoryUnit* nextUnit = static_cast<MemoryUnit*>(nextUnitPointer);
+        unit->nextUnit = nextUnit;
+    }
+    void* lastUnitPointer = static_cast<void*>(memoryUnitsStartChar + unitSize*(nbUnits-1));
+    MemoryUnit* lastUnit = static_cast<MemoryUnit*>(lastUnitPointer);
+    lastUnit->nextUnit = mFreeMemoryUnits[indexHeap];
+
+    // Add the new allocated block into the list of free memory units in the heap
+    mFreeMemoryUnits[indexHeap] = newBlock->memoryUnits;
+    mNbCurrentMemoryBlocks++;
+    mNbFreeBytes += nbUnits * unitSize;
+
+    return nbUnits;
+}
+
+// Allocate the memory blocks needed for a given number of allocations of a given size
+/// The allocations of this size will not need memory from the base allocator until their
+/// number exceeds the given one. The reserved memory is not released by the watermark.
+void DefaultPoolAllocator::reserve(size_t size, size_t nbAllocations) {
+
+    // The allocations larger than the maximum unit size are made with the base allocator
+    if (size == 0 || size > mMaxUnitSize) return;
+
+    const int indexHeap = getHeapIndex(size);
+    assert(indexHeap >= 0 && indexHeap < NB_HEAPS);
+
+    // Count the free memory units of the heap
+    size_t nbFreeUnits = 0;
+    for (MemoryUnit* unit = mFreeMemoryUnits[indexHeap]; unit != nullptr; unit = unit->nextUnit) {
+        nbFreeUnits++;
+    }
+
+    while (nbFreeUnits < nbAllocations) {
+        nbFreeUnits += allocateMemoryBlock(indexHeap);
+    }
+
+    // Wait until the free memory doubles before trying to release the free memory blocks
+    if (mNbFreeBytes * 2 > mNextReleaseNbFreeBytes) {
+        mNextReleaseNbFreeBytes = mNbFreeBytes * 2;
     }
 }
 
@@ -181,15 +265,15 @@ void DefaultPoolAllocator::release(void* pointer, size_t size) {
 #endif
 
     // If the size is larger than the maximum memory unit size
-    if (size > MAX_UNIT_SIZE) {
+    if (size > mMaxUnitSize) {
 
         // Release the memory using the default deallocation
-        MemoryManager::getBaseAllocator().release(pointer, size);
+        mBaseAllocator->release(pointer, size);
         return;
     }
 
     // Get the index of the heap that has handled the corresponding allocation request
-    int indexHeap = mMapSizeToHeapIndex[size];
+    int indexHeap = getHeapIndex(size);
     assert(indexHeap >= 0 && indexHeap < NB_HEAPS);
 
     // Insert the released memory unit into the list of free memory units of the
@@ -197,4 +281,110 @@ void DefaultPoolAllocator::release(void* pointer, size_t size) {
     MemoryUnit* releasedUnit = static_cast<MemoryUnit*>(pointer);
     releasedUnit->nextUnit = mFreeMemoryUnits[indexHeap];
     mFreeMemoryUnits[indexHeap] = releasedUnit;
+    mNbFreeBytes += mUnitSizes[indexHeap];
+
+    // If there is too much free memory, give the free memory blocks back to the base allocator
+    if (mNbFreeBytes > mNextReleaseNbFreeBytes) {
+        releaseFreeBlocks();
+    }
+}
+
+// Return the index of the memory block that contains a memory unit
+/// The memory blocks must be sorted by address
+uint DefaultPoolAllocator::findMemoryBlock(const MemoryUnit* unit) const {
+
+    // Find the last memory block that starts before the unit
+    uint first = 0;
+    uint last = mNbCurrentMemoryBlocks;
+    while (last - first > 1) {
+        const uint middle = (first + last) / 2;
+        if (mMemoryBlocks[middle].memoryUnits <= unit) first = middle;
+        else last = middle;
+    }
+
+    assert(mMemoryBlocks[first].memoryUnits <= unit);
+    assert(reinterpret_cast<const char*>(unit) < reinterpret_cast<const char*>(mMemoryBlocks[first].memoryUnits) +
+                                                 getBlockSize(mMemoryBlocks[first].heapIndex));
+
+    return first;
+}
+
+// Release the memory blocks whose memory units are all free
+/// This method is called when the memory of the free memory units exceeds the release
+/// watermark but it can also be called at any time (for instance after a large event
+/// in the world). Its cost is proportional to the number of free memory units.
+void DefaultPoolAllocator::releaseFreeBlocks() {
+
+    if (mNbCurrentMemoryBlocks > 0) {
+
+        // Sort the memory blocks by address to find the block of a memory unit
+        std::sort(mMemoryBlocks, mMemoryBlocks + mNbCurrentMemoryBlocks,
+                  [](const MemoryBlock& block1, const MemoryBlock& block2) {
+            return block1.memoryUnits < block2.memoryUnits;
+        });
+
+        // Count the free memory units of each block
+        const size_t nbFreeUnitsSize = mNbCurrentMemoryBlocks * sizeof(uint);
+        uint* nbFreeUnits = static_cast<uint*>(mBaseAllocator->allocate(nbFreeUnitsSize));
+        memset(nbFreeUnits, 0, nbFreeUnitsSize);
+        for (int h=0; h < NB_HEAPS; h++) {
+            for (MemoryUnit* unit = mFreeMemoryUnits[h]; unit != nullptr; unit = unit->nextUnit) {
+                nbFreeUnits[findMemoryBlock(unit)]++;
+            }
+        }
+
+        // Find the blocks whose memory units are all free (their number of free units is
+        // replaced by one if the block is released and zero otherwise)
+        bool isHeapWithReleasedBlock[NB_HEAPS] = {false};
+        bool isBlockReleased = false;
+        for (uint i=0; i < mNbCurrentMemoryBlocks; i++) {
+            const int heapIndex = mMemoryBlocks[i].heapIndex;
+            const uint nbUnits = getBlockSize(heapIndex) / mUnitSizes[heapIndex];
+            nbFreeUnits[i] = nbFreeUnits[i] == nbUnits ? 1 : 0;
+            if (nbFreeUnits[i] == 1) {
+                isHeapWithReleasedBlock[heapIndex] = true;
+                isBlockReleased = true;
+            }
+        }
+
+        if (isBlockReleased) {
+
+            // Remove the memory units of the released blocks from the lists of free units
+            for (int h=0; h < NB_HEAPS; h++) {
+
+                if (!isHeapWithReleasedBlock[h]) continue;
+
+                MemoryUnit** previousNextUnit = &mFreeMemoryUnits[h];
+                for (MemoryUnit* unit = mFreeMemoryUnits[h]; unit != nullptr; unit = unit->nextUnit) {
+                    if (nbFreeUnits[findMemoryBlock(unit)] == 0) {
+                        *previousNextUnit = unit;
+                        previousNextUnit = &unit->nextUnit;
+                    }
+                }
+                *previousNextUnit = nullptr;
+            }
+
+            // Release the blocks and remove them from the array of blocks
+            uint nbKeptBlocks = 0;
+            for (uint i=0; i < mNbCurrentMemoryBlocks; i++) {
+                const int heapIndex = mMemoryBlocks[i].heapIndex;
+                if (nbFreeUnits[i] == 1) {
+                    const size_t blockSize = getBlockSize(heapIndex);
+                    mNbFreeBytes -= (blockSize / mUnitSizes[heapIndex]) * mUnitSizes[heapIndex];
+                    mBaseAllocator->release(mMemoryBlocks[i].memoryUnits, blockSize);
+                }
+                else {
+                    mMemoryBlocks[nbKeptBlocks] = mMemoryBlocks[i];
+                    nbKeptBlocks++;
+                }
+            }
+            mNbCurrentMemoryBlocks = nbKeptBlocks;
+        }
+
+        mBaseAllocator->release(nbFreeUnits, nbFreeUnitsSize);
+    }
+
+    // The free memory units that remain are in blocks that are still used. Wait until
+    // the free memory doubles before trying again to avoid scanning the units too often.
+    mNextReleaseNbFreeBytes = mNbFreeBytes * 2 > mReleaseWatermark ? mNbFreeBytes * 2 : mReleaseWatermark;
 }
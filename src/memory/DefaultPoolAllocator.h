@@ -29,6 +29,7 @@
 // Libraries
 #include "configuration.h"
 #include "MemoryAllocator.h"
+#include <cassert>
 
 /// ReactPhysics3D namespace
 namespace reactphysics3d {
@@ -39,6 +40,12 @@ namespace reactphysics3d {
  * It allows us to allocate small blocks of memory (smaller or equal to 1024 bytes)
  * efficiently. This implementation is inspired by the small block allocator
  * described here : http://www.codeproject.com/useritems/Small_Block_Allocator.asp
+ *
+ * The units larger than 1024 bytes (up to a maximum unit size given to the constructor)
+ * are allocated from heaps with four size classes per power of two and with larger memory
+ * blocks. The larger allocations are made with the base allocator. When the memory of the
+ * free units exceeds a watermark, the memory blocks whose units are all free are given
+ * back to the base allocator.
  */
 class DefaultPoolAllocator : public MemoryAllocator {
 
@@ -73,21 +80,47 @@ class DefaultPoolAllocator : public MemoryAllocator {
 
                 /// Pointer to the first element of a linked-list of memory unity.
                 MemoryUnit* memoryUnits;
+
+                /// Index of the heap of the memory units of the block
+                int heapIndex;
         };
 
         // -------------------- Constants -------------------- //
 
+        /// Number of heaps of the small memory units (multiples of 8 bytes)
+        static const int NB_SMALL_HEAPS = 128;
+
+        /// Number of heaps of the large memory units
+        static const int NB_LARGE_HEAPS = 16;
+
         /// Number of heaps
-        static const int NB_HEAPS = 128;
+        static const int NB_HEAPS = NB_SMALL_HEAPS + NB_LARGE_HEAPS;
+
+        /// Maximum size of a small memory unit
+        static const size_t MAX_SMALL_UNIT_SIZE = 1024;
+
+        /// Granularity of the sizes of the large memory units
+        static const size_t LARGE_UNIT_SIZE_GRANULARITY = 256;
+
+        /// Number of memory units in a memory block of a heap of large memory units
+        static const uint NB_UNITS_PER_LARGE_BLOCK = 8;
+
+        /// Size a memory chunk of a heap of small memory units
+        static const size_t BLOCK_SIZE = 16 * MAX_SMALL_UNIT_SIZE;
+
+    public :
 
         /// Maximum memory unit size. An allocation request of a size smaller or equal to
-        /// this size will be handled using the small block allocator. However, for an
-        /// allocation request larger than the maximum block size, the standard malloc()
+        /// this size can be handled using the pool allocator. However, for an
+        /// allocation request larger than the maximum unit size, the base allocator
         /// will be used.
-        static const size_t MAX_UNIT_SIZE = 1024;
+        static const size_t MAX_UNIT_SIZE = 16384;
 
-        /// Size a memory chunk
-        static const size_t BLOCK_SIZE = 16 * MAX_UNIT_SIZE;
+        /// Default memory (in bytes) of the free memory units above which the memory
+        /// blocks without used units are released
+        static const size_t DEFAULT_RELEASE_WATERMARK = 4194304; // 4Mb
+
+    private :
 
         // -------------------- Attributes -------------------- //
 
@@ -96,10 +129,28 @@ class DefaultPoolAllocator : public MemoryAllocator {
 
         /// Lookup table that map the size to allocate to the index of the
         /// corresponding heap we will use for the allocation.
-        static int mMapSizeToHeapIndex[MAX_UNIT_SIZE + 1];
+        static int mMapSizeToHeapIndex[MAX_SMALL_UNIT_SIZE + 1];
+
+        /// Lookup table that map the size (divided by the granularity) of a large
+        /// memory unit to the index of the corresponding heap
+        static int mMapLargeSizeToHeapIndex[MAX_UNIT_SIZE / LARGE_UNIT_SIZE_GRANULARITY + 1];
+
+        /// Base memory allocator of the memory blocks
+        MemoryAllocator* mBaseAllocator;
+
+        /// Maximum size of the memory units allocated by the pool
+        size_t mMaxUnitSize;
 
-        /// True if the mMapSizeToHeapIndex array has already been initialized
-        static bool isMapSizeToHeadIndexInitialized;
+        /// Memory (in bytes) of the free memory units above which the memory blocks
+        /// without used units are released
+        size_t mReleaseWatermark;
+
+        /// Memory (in bytes) of the free memory units above which we try to
+        /// release the memory blocks without used units next time
+        size_t mNextReleaseNbFreeBytes;
+
+        /// Memory (in bytes) of the free memory units of all the heaps
+        size_t mNbFreeBytes;
 
         /// Pointers to the first free memory unit for each heap
         MemoryUnit* mFreeMemoryUnits[NB_HEAPS];
@@ -121,12 +172,32 @@ class DefaultPoolAllocator : public MemoryAllocator {
         int mNbTimesAllocateMethodCalled;
 #endif
 
+        // -------------------- Methods -------------------- //
+
+        /// Initialize the sizes of the memory units and the lookup tables of the heaps
+        static bool initializeHeaps();
+
+        /// Return the index of the heap of the memory units of a given size
+        static int getHeapIndex(size_t size);
+
+        /// Return the size (in bytes) of a memory block of a heap
+        static size_t getBlockSize(int heapIndex);
+
+        /// Return the index of the memory block that contains a memory unit
+        uint findMemoryBlock(const MemoryUnit* unit) const;
+
+        /// Allocate a new memory block for a heap, add its units to the free units and
+        /// return their number
+        uint allocateMemoryBlock(int indexHeap);
+
     public :
 
         // -------------------- Methods -------------------- //
 
         /// Constructor
-        DefaultPoolAllocator();
+        DefaultPoolAllocator(size_t maxUnitSize = MAX_UNIT_SIZE,
+                             size_t releaseWatermark = DEFAULT_RELEASE_WATERMARK,
+                             MemoryAllocator* baseAllocator = nullptr);
 
         /// Destructor
         virtual ~DefaultPoolAllocator() override;
@@ -140,8 +211,37 @@ class DefaultPoolAllocator : public MemoryAllocator {
 
         /// Release previously allocated memory.
         virtual void release(void* pointer, size_t size) override;
+
+        /// Allocate the memory blocks needed for a given number of allocations of a given size
+        virtual void reserve(size_t size, size_t nbAllocations) override;
+
+        /// Release the memory blocks whose memory units are all free
+        void releaseFreeBlocks();
+
+        /// Return the number of memory blocks allocated with the base allocator
+        uint getNbMemoryBlocks() const;
 };
 
+// Return the index of the heap of the memory units of a given size
+inline int DefaultPoolAllocator::getHeapIndex(size_t size) {
+
+    assert(size > 0 && size <= MAX_UNIT_SIZE);
+
+    if (size <= MAX_SMALL_UNIT_SIZE) return mMapSizeToHeapIndex[size];
+
+    return mMapLargeSizeToHeapIndex[(size + LARGE_UNIT_SIZE_GRANULARITY - 1) / LARGE_UNIT_SIZE_GRANULARITY];
+}
+
+// Return the size (in bytes) of a memory block of a heap
+inline size_t DefaultPoolAllocator::getBlockSize(int heapIndex) {
+    return heapIndex < NB_SMALL_HEAPS ? BLOCK_SIZE : NB_UNITS_PER_LARGE_BLOCK * mUnitSizes[heapIndex];
+}
+
+// Return the number of memory blocks allocated with the base allocator
+inline uint DefaultPoolAllocator::getNbMemoryBlocks() const {
+    return mNbCurrentMemoryBlocks;
+}
+
 }
 
 #endif
@@ -31,41 +31,60 @@
 
 using namespace reactphysics3d;
 
+// Header of a memory block chained to the buffer of the single frame allocator
+struct alignas(VECTOR_ALIGNMENT) ChainedBlockHeader {
+
+    /// Previous chained block
+    void* next;
+
+    /// Total size (in bytes) of the block (including the header)
+    size_t size;
+};
+
 // Constructor
-DefaultSingleFrameAllocator::DefaultSingleFrameAllocator()
-    : mBaseMemoryAllocator(&MemoryManager::getBaseAllocator()),
+/**
+ * @param baseAllocator Allocator of the memory buffer (the global base allocator of the
+ *                      MemoryManager if null)
+ */
+DefaultSingleFrameAllocator::DefaultSingleFrameAllocator(MemoryAllocator* baseAllocator)
+    : mBaseMemoryAllocator(baseAllocator != nullptr ? baseAllocator : &MemoryManager::getBaseAllocator()),
       mTotalSizeBytes(INIT_SINGLE_FRAME_ALLOCATOR_NB_BYTES),
-      mCurrentOffset(0), mNbFramesTooMuchAllocated(0), mNeedToAllocatedMore(false) {
+      mCurrentOffset(0), mNbFramesTooMuchAllocated(0), mChainedBlocks(nullptr),
+      mChainedBlocksSizeBytes(0) {
 
     // Allocate a whole block of memory at the beginning
     mMemoryBufferStart = static_cast<char*>(mBaseMemoryAllocator->allocate(mTotalSizeBytes));
     assert(mMemoryBufferStart != nullptr);
+
+    mCurrentBlockStart = mMemoryBufferStart;
+    mCurrentBlockSizeBytes = mTotalSizeBytes;
 }
 
 // Destructor
 DefaultSingleFrameAllocator::~DefaultSingleFrameAllocator() {
 
+    releaseChainedBlocks();
+
     // Release the memory allocated at the beginning
     mBaseMemoryAllocator->release(mMemoryBufferStart, mTotalSizeBytes);
 }
 
-
 // Allocate memory of a given size (in bytes) and return a pointer to the
 // allocated memory.
 void* DefaultSingleFrameAllocator::allocate(size_t size) {
 
-    // Check that there is enough remaining memory in the buffer
-    if (mCurrentOffset + size > mTotalSizeBytes) {
+    // Round the size so that the next allocation is aligned for the vectors
+    size = (size + VECTOR_ALIGNMENT - 1) & ~(VECTOR_ALIGNMENT - 1);
 
-        // We need to allocate more memory next time reset() is called
-        mNeedToAllocatedMore = true;
+    // If there is not enough remaining memory in the current block
+    if (mCurrentOffset + size > mCurrentBlockSizeBytes) {
 
-        // Return default memory allocation
-        return mBaseMemoryAllocator->allocate(size);
+        // Continue the allocations in a new block chained to the buffer
+        chainBlock(size);
     }
 
     // Next available memory location
-    void* nextAvailableMemory = mMemoryBufferStart + mCurrentOffset;
+    void* nextAvailableMemory = mCurrentBlockStart + mCurrentOffset;
 
     // Increment the offset
     mCurrentOffset += size;
@@ -74,23 +93,69 @@ void* DefaultSingleFrameAllocator::allocate(size_t size) {
     return nextAvailableMemory;
 }
 
-// Release previously allocated memory.
-void DefaultSingleFrameAllocator::release(void* pointer, size_t size) {
+// Chain a new block of memory with at least a given size (in bytes) available
+/// The remaining memory of the previous block is not used anymore until the next reset.
+void DefaultSingleFrameAllocator::chainBlock(size_t size) {
+
+    const size_t availableSize = size > CHAINED_BLOCK_NB_BYTES ? size : CHAINED_BLOCK_NB_BYTES;
+    const size_t blockSize = sizeof(ChainedBlockHeader) + availableSize;
+    void* block = mBaseMemoryAllocator->allocate(blockSize);
+    assert(block != nullptr);
 
-    // If allocated memory is not within the single frame allocation range
-    char* p = static_cast<char*>(pointer);
-    if (p < mMemoryBufferStart || p > mMemoryBufferStart + mTotalSizeBytes) {
+    ChainedBlockHeader* header = static_cast<ChainedBlockHeader*>(block);
+    header->next = mChainedBlocks;
+    header->size = blockSize;
+    mChainedBlocks = block;
+    mChainedBlocksSizeBytes += blockSize;
 
-        // Use default deallocation
-        mBaseMemoryAllocator->release(pointer, size);
+    mCurrentBlockStart = static_cast<char*>(block) + sizeof(ChainedBlockHeader);
+    mCurrentBlockSizeBytes = availableSize;
+    mCurrentOffset = 0;
+}
+
+// Release the blocks chained to the buffer
+void DefaultSingleFrameAllocator::releaseChainedBlocks() {
+
+    while (mChainedBlocks != nullptr) {
+        ChainedBlockHeader* header = static_cast<ChainedBlockHeader*>(mChainedBlocks);
+        mChainedBlocks = header->next;
+        mBaseMemoryAllocator->release(header, header->size);
     }
+
+    mChainedBlocksSizeBytes = 0;
+}
+
+// Release previously allocated memory.
+/// The memory of a single frame is only released by the reset() method.
+void DefaultSingleFrameAllocator::release(void* pointer, size_t size) {
+
 }
 
 // Reset the marker of the current allocated memory
+/// If some blocks had to be chained to the buffer during the frame, the buffer and the
+/// chained blocks are coalesced into a single buffer large enough for the whole frame.
 void DefaultSingleFrameAllocator::reset() {
 
-    // If too much memory is allocated
-    if (mCurrentOffset < mTotalSizeBytes / 2) {
+    // If some blocks have been chained to the buffer
+    if (mChainedBlocks != nullptr) {
+
+        const size_t newTotalSizeBytes = mTotalSizeBytes + mChainedBlocksSizeBytes;
+
+        releaseChainedBlocks();
+
+        // Release the memory allocated at the beginning
+        mBaseMemoryAllocator->release(mMemoryBufferStart, mTotalSizeBytes);
+
+        // Allocate a single block with the memory of the buffer and of the chained blocks
+        mTotalSizeBytes = newTotalSizeBytes;
+        mMemoryBufferStart = static_cast<char*>(mBaseMemoryAllocator->allocate(mTotalSizeBytes));
+        assert(mMemoryBufferStart != nullptr);
+
+        mNbFramesTooMuchAllocated = 0;
+    }
+    // If too much memory is allocated (the buffer is never shrunk below its initial size so that
+    // the steps of a steady state do not allocate memory)
+    else if (mCurrentOffset < mTotalSizeBytes / 2 && mTotalSizeBytes > INIT_SINGLE_FRAME_ALLOCATOR_NB_BYTES) {
 
         mNbFramesTooMuchAllocated++;
 
@@ -101,7 +166,9 @@ void DefaultSingleFrameAllocator::reset() {
 
             // Divide the total memory to allocate by two
             mTotalSizeBytes /= 2;
-            if (mTotalSizeBytes == 0) mTotalSizeBytes = 1;
+            if (mTotalSizeBytes < INIT_SINGLE_FRAME_ALLOCATOR_NB_BYTES) {
+                mTotalSizeBytes = INIT_SINGLE_FRAME_ALLOCATOR_NB_BYTES;
+            }
 
             // Allocate a whole block of memory at the beginning
             mMemoryBufferStart = static_cast<char*>(mBaseMemoryAllocator->allocate(mTotalSizeBytes));
@@ -114,23 +181,8 @@ void DefaultSingleFrameAllocator::reset() {
         mNbFramesTooMuchAllocated = 0;
     }
 
-    // If we need to allocate more memory
-    if (mNeedToAllocatedMore) {
-
-        // Release the memory allocated at the beginning
-        mBaseMemoryAllocator->release(mMemoryBufferStart, mTotalSizeBytes);
-
-        // Multiply the total memory to allocate by two
-        mTotalSizeBytes *= 2;
-
-        // Allocate a whole block of memory at the beginning
-        mMemoryBufferStart = static_cast<char*>(mBaseMemoryAllocator->allocate(mTotalSizeBytes));
-        assert(mMemoryBufferStart != nullptr);
-
-        mNeedToAllocatedMore = false;
-        mNbFramesTooMuchAllocated = 0;
-    }
-
-    // Reset the current offset at the beginning of the block
+    // Reset the current offset at the beginning of the buffer
+    mCurrentBlockStart = mMemoryBufferStart;
+    mCurrentBlockSizeBytes = mTotalSizeBytes;
     mCurrentOffset = 0;
 }
@@ -36,7 +36,11 @@ namespace reactphysics3d {
 // Class DefaultSingleFrameAllocator
 /**
  * This class represent a memory allocator used to efficiently allocate
- * memory on the heap that is used during a single frame.
+ * memory on the heap that is used during a single frame. When the buffer
+ * is full, blocks of memory are chained to it on demand so that the
+ * allocations of a frame never fall back to the base allocator for each
+ * object. The buffer and the chained blocks are coalesced into a single
+ * larger buffer at the next reset.
  */
 class DefaultSingleFrameAllocator : public SingleFrameAllocator {
 
@@ -51,6 +55,9 @@ class DefaultSingleFrameAllocator : public SingleFrameAllocator {
         /// Initial size (in bytes) of the single frame allocator
         static const size_t INIT_SINGLE_FRAME_ALLOCATOR_NB_BYTES = 1048576; // 1Mb
 
+        /// Minimum size (in bytes) of a block chained to the buffer when it is full
+        static const size_t CHAINED_BLOCK_NB_BYTES = 65536; // 64Kb
+
         // -------------------- Attributes -------------------- //
 		/// Cached memory allocator used on construction
 		MemoryAllocator* mBaseMemoryAllocator;
@@ -61,22 +68,41 @@ class DefaultSingleFrameAllocator : public SingleFrameAllocator {
         /// Pointer to the beginning of the allocated memory block
         char* mMemoryBufferStart;
 
-        /// Pointer to the next available memory location in the buffer
+        /// Pointer to the beginning of the block where the memory is currently allocated
+        /// (the buffer or the last chained block)
+        char* mCurrentBlockStart;
+
+        /// Size (in bytes) of the block where the memory is currently allocated
+        size_t mCurrentBlockSizeBytes;
+
+        /// Pointer to the next available memory location in the current block
         size_t mCurrentOffset;
 
         /// Current number of frames since we detected too much memory
         /// is allocated
         size_t mNbFramesTooMuchAllocated;
 
-        /// True if we need to allocate more memory in the next reset() call
-        bool mNeedToAllocatedMore;
+        /// Linked list of the blocks chained to the buffer since the last reset
+        /// (the last chained block first)
+        void* mChainedBlocks;
+
+        /// Total size (in bytes) of the blocks chained to the buffer since the last reset
+        size_t mChainedBlocksSizeBytes;
+
+        // -------------------- Methods -------------------- //
+
+        /// Chain a new block of memory with at least a given size (in bytes) available
+        void chainBlock(size_t size);
+
+        /// Release the blocks chained to the buffer
+        void releaseChainedBlocks();
 
     public :
 
         // -------------------- Methods -------------------- //
 
         /// Constructor
-        DefaultSingleFrameAllocator();
+        DefaultSingleFrameAllocator(MemoryAllocator* baseAllocator = nullptr);
 
         /// Destructor
         virtual ~DefaultSingleFrameAllocator() override;
@@ -92,8 +118,16 @@ class DefaultSingleFrameAllocator : public SingleFrameAllocator {
 
         /// Reset the marker of the current allocated memory
         virtual void reset() override;
+
+        /// Return the size (in bytes) of the buffer
+        size_t getCapacity() const;
 };
 
+// Return the size (in bytes) of the buffer
+inline size_t DefaultSingleFrameAllocator::getCapacity() const {
+    return mTotalSizeBytes;
+}
+
 }
 
 #endif
@@ -55,6 +55,10 @@ class MemoryAllocator {
 
         /// Release previously allocated memory.
         virtual void release(void* pointer, size_t size)=0;
+
+        /// Prepare a given number of allocations of a given size (in bytes) in advance
+        /// (nothing is done by default)
+        virtual void reserve(size_t size, size_t nbAllocations) {}
 };
 
 /**
@@ -25,14 +25,127 @@
 
 // Libraries
 #include "MemoryManager.h"
+#include <new>
 
 using namespace reactphysics3d;
 
 // Static variables
 DefaultAllocator MemoryManager::mDefaultAllocator;
-DefaultSingleFrameAllocator MemoryManager::mDefaultSingleFrameAllocator;
-DefaultPoolAllocator MemoryManager::mDefaultPoolAllocator;
-MemoryAllocator* MemoryManager::mBaseAllocator = &mDefaultAllocator;
-MemoryAllocator* MemoryManager::mPoolAllocator = &mDefaultPoolAllocator;
-SingleFrameAllocator* MemoryManager::mSingleFrameAllocator = &mDefaultSingleFrameAllocator;
+MemoryAllocator* MemoryManager::mGlobalBaseAllocator = &mDefaultAllocator;
 
+// Constructor
+/// The pool and single frame allocators that are not given are created by the memory manager
+/// with its base allocator.
+/**
+ * @param baseAllocator Base allocator of the memory manager (the global base allocator if null)
+ * @param poolAllocator Pool allocator of the memory manager (a new pool allocator if null)
+ * @param singleFrameAllocator Single frame allocator of the memory manager (a new single
+ *                             frame allocator if null)
+ */
+MemoryManager::MemoryManager(MemoryAllocator* baseAllocator, MemoryAllocator* poolAllocator,
+                             SingleFrameAllocator* singleFrameAllocator)
+              : mBaseAllocator(baseAllocator != nullptr ? baseAllocator : mGlobalBaseAllocator),
+                mDefaultPoolAllocator(nullptr), mDefaultSingleFrameAllocator(nullptr),
+                mPoolAllocator(poolAllocator), mSingleFrameAllocator(singleFrameAllocator),
+                mWorkersAllocators(nullptr), mNbWorkersAllocators(0) {
+
+    // Create the allocators that have not been given
+    if (mPoolAllocator == nullptr) {
+        mDefaultPoolAllocator = new (mBaseAllocator->allocate(sizeof(DefaultPoolAllocator)))
+                DefaultPoolAllocator(DefaultPoolAllocator::MAX_UNIT_SIZE, DefaultPoolAllocator::DEFAULT_RELEASE_WATERMARK,
+                                     mBaseAllocator);
+        mPoolAllocator = mDefaultPoolAllocator;
+    }
+    if (mSingleFrameAllocator == nullptr) {
+        mDefaultSingleFrameAllocator = new (mBaseAllocator->allocate(sizeof(DefaultSingleFrameAllocator)))
+                DefaultSingleFrameAllocator(mBaseAllocator);
+        mSingleFrameAllocator = mDefaultSingleFrameAllocator;
+    }
+
+    // Initialize the tagged allocators
+    for (int type=0; type < NB_ALLOCATION_TYPES; type++) {
+        for (int tag=0; tag < NB_MEMORY_TAGS; tag++) {
+            mTaggedAllocators[type][tag].mMemoryManager = this;
+            mTaggedAllocators[type][tag].mAllocationType = static_cast<AllocationType>(type);
+            mTaggedAllocators[type][tag].mTag = static_cast<MemoryTag>(tag);
+        }
+    }
+}
+
+// Destructor
+MemoryManager::~MemoryManager() {
+
+    // Destroy the allocators of the workers
+    for (uint i=0; i < mNbWorkersAllocators; i++) {
+        mWorkersAllocators[i]->~WorkerAllocators();
+        mBaseAllocator->release(mWorkersAllocators[i], sizeof(WorkerAllocators));
+    }
+
+    if (mWorkersAllocators != nullptr) {
+        mBaseAllocator->release(mWorkersAllocators, mNbWorkersAllocators * sizeof(WorkerAllocators*));
+    }
+
+    // Destroy the allocators created by the memory manager
+    if (mDefaultPoolAllocator != nullptr) {
+        mDefaultPoolAllocator->~DefaultPoolAllocator();
+        mBaseAllocator->release(mDefaultPoolAllocator, sizeof(DefaultPoolAllocator));
+    }
+    if (mDefaultSingleFrameAllocator != nullptr) {
+        mDefaultSingleFrameAllocator->~DefaultSingleFrameAllocator();
+        mBaseAllocator->release(mDefaultSingleFrameAllocator, sizeof(DefaultSingleFrameAllocator));
+    }
+}
+
+// Create the missing allocators of the workers of a task scheduler
+/// This method must be called before the parallel tasks start. The allocators are shared
+/// by all the parallel stages of the engine and they are kept until the memory manager is
+/// destroyed.
+void MemoryManager::createWorkerAllocators(uint nbWorkers) {
+
+    if (nbWorkers <= mNbWorkersAllocators) return;
+
+    WorkerAllocators** workersAllocators = static_cast<WorkerAllocators**>(
+                mBaseAllocator->allocate(nbWorkers * sizeof(WorkerAllocators*)));
+    for (uint i=0; i < mNbWorkersAllocators; i++) {
+        workersAllocators[i] = mWorkersAllocators[i];
+    }
+    for (uint i=mNbWorkersAllocators; i < nbWorkers; i++) {
+        workersAllocators[i] = new (mBaseAllocator->allocate(sizeof(WorkerAllocators))) WorkerAllocators(mBaseAllocator);
+    }
+
+    if (mWorkersAllocators != nullptr) {
+        mBaseAllocator->release(mWorkersAllocators, mNbWorkersAllocators * sizeof(WorkerAllocators*));
+    }
+
+    mWorkersAllocators = workersAllocators;
+    mNbWorkersAllocators = nbWorkers;
+}
+
+// Reset the single frame allocators of the workers
+/// This method must be called when the memory allocated by the workers in their single
+/// frame allocators is not used anymore.
+void MemoryManager::resetWorkerFrameAllocators() {
+
+    for (uint i=0; i < mNbWorkersAllocators; i++) {
+        mWorkersAllocators[i]->singleFrameAllocator.reset();
+    }
+}
+
+// Reset the single frame allocator
+/// The statistics of the current frame of each memory tag become the statistics of the last frame
+void MemoryManager::resetFrameAllocator() {
+
+    mSingleFrameAllocator->reset();
+
+    for (int tag=0; tag < NB_MEMORY_TAGS; tag++) {
+
+        MemoryStatistics& statistics = mStatistics[tag];
+        statistics.nbAllocationsLastFrame = statistics.nbAllocationsCurrentFrame;
+        statistics.nbFrameBytesLastFrame = statistics.nbFrameBytesCurrentFrame;
+        if (statistics.nbFrameBytesCurrentFrame > statistics.frameBytesHighWaterMark) {
+            statistics.frameBytesHighWaterMark = statistics.nbFrameBytesCurrentFrame;
+        }
+        statistics.nbAllocationsCurrentFrame = 0;
+        statistics.nbFrameBytesCurrentFrame = 0;
+    }
+}
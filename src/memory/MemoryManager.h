@@ -31,6 +31,8 @@
 #include "memory/DefaultPoolAllocator.h"
 #include "memory/MemoryAllocator.h"
 #include "memory/DefaultSingleFrameAllocator.h"
+#include "memory/WorkerPoolAllocator.h"
+#include <cassert>
 
 /// Namespace ReactPhysics3D
 namespace reactphysics3d {
@@ -38,32 +40,100 @@ namespace reactphysics3d {
 // Declarations
 class MemoryAllocator;
 
+/// Subsystems of the engine used to tag the memory allocations
+enum class MemoryTag {BroadPhase, NarrowPhase, ContactManifolds, Solver, Shapes, Bodies, Containers, Other};
+
+// Structure MemoryStatistics
+/**
+ * This structure contains the statistics of the memory allocated by a subsystem of the
+ * engine (a memory tag). A frame is the interval between two resets of the single frame
+ * allocator (one step of a dynamics world).
+ */
+struct MemoryStatistics {
+
+    // -------------------- Attributes -------------------- //
+
+    /// Number of bytes currently allocated with the pool and base allocators
+    size_t nbBytesInUse = 0;
+
+    /// Largest number of bytes allocated at the same time with the pool and base allocators
+    size_t peakNbBytesInUse = 0;
+
+    /// Number of allocations with the pool and base allocators during the current frame
+    uint nbAllocationsCurrentFrame = 0;
+
+    /// Number of allocations with the pool and base allocators during the last frame
+    uint nbAllocationsLastFrame = 0;
+
+    /// Number of bytes allocated with the single frame allocator during the current frame
+    size_t nbFrameBytesCurrentFrame = 0;
+
+    /// Number of bytes allocated with the single frame allocator during the last frame
+    size_t nbFrameBytesLastFrame = 0;
+
+    /// Largest number of bytes allocated with the single frame allocator during a frame
+    size_t frameBytesHighWaterMark = 0;
+};
+
 // Class MemoryManager
 /**
  * The memory manager is used to store the different memory allocators that are used
- * by the library.
+ * by the library. Each world has its own memory manager with its own pool allocator and
+ * single frame allocator (created by the manager or given by the user) so that independent
+ * worlds can be used on different threads without any lock. Only the global base allocator
+ * (malloc/free by default) is shared by the memory managers that are not given a base
+ * allocator. The memory manager also has a pool allocator and a single frame allocator for
+ * each worker of a task scheduler so that the parallel stages of the engine can allocate
+ * memory without any lock.
  */
 class MemoryManager {
 
     private:
+
+       // Structure WorkerAllocators
+       /**
+        * Memory allocators of a single worker of a task scheduler
+        */
+       struct WorkerAllocators {
+
+           /// Pool allocator of the worker
+           WorkerPoolAllocator poolAllocator;
+
+           /// Single frame allocator of the worker
+           DefaultSingleFrameAllocator singleFrameAllocator;
+
+           /// Constructor
+           WorkerAllocators(MemoryAllocator* baseAllocator)
+               : poolAllocator(baseAllocator), singleFrameAllocator(baseAllocator) {}
+       };
 		
        /// Default malloc/free memory allocator
        static DefaultAllocator mDefaultAllocator;
-	   
-       /// Default single frame memory allocator
-       static DefaultSingleFrameAllocator mDefaultSingleFrameAllocator;
 
-       /// Default pool memory allocator
-       static DefaultPoolAllocator mDefaultPoolAllocator;
+       /// Pointer to the global base memory allocator (used by the memory managers created
+       /// without a base allocator and by the containers that do not belong to a world)
+       static MemoryAllocator* mGlobalBaseAllocator;
+
+       /// Base memory allocator of this memory manager
+       MemoryAllocator* mBaseAllocator;
+
+       /// Pool allocator created by this memory manager (null if it has been given by the user)
+       DefaultPoolAllocator* mDefaultPoolAllocator;
+
+       /// Single frame allocator created by this memory manager (null if it has been given by the user)
+       DefaultSingleFrameAllocator* mDefaultSingleFrameAllocator;
+
+       /// Memory pool allocator of this memory manager
+       MemoryAllocator* mPoolAllocator;
 
-       /// Pointer to the base memory allocator to use
-       static MemoryAllocator* mBaseAllocator;
+       /// Single frame stack allocator of this memory manager
+       SingleFrameAllocator* mSingleFrameAllocator;
 
-       /// Single frame stack allocator
-       static SingleFrameAllocator* mSingleFrameAllocator;
+       /// Array with the allocators of each worker of a task scheduler
+       WorkerAllocators** mWorkersAllocators;
 
-       /// Memory pool allocator
-       static MemoryAllocator* mPoolAllocator;
+       /// Number of workers with allocators
+       uint mNbWorkersAllocators;
 
     public:
 
@@ -74,60 +144,165 @@ class MemoryManager {
            Frame,   // Single frame memory allocator
        };
 
+       /// Number of memory tags
+       static const int NB_MEMORY_TAGS = 8;
+
+       /// Number of memory allocation types
+       static const int NB_ALLOCATION_TYPES = 3;
+
+       // Class TaggedAllocator
+       /**
+        * Allocator that allocates memory of a given type with a memory tag through
+        * the memory manager. It is used to account the memory of the containers and
+        * of the objects that receive a memory allocator.
+        */
+       class TaggedAllocator : public MemoryAllocator {
+
+           private:
+
+               /// Memory manager
+               MemoryManager* mMemoryManager;
+
+               /// Type of the allocated memory
+               AllocationType mAllocationType;
+
+               /// Tag of the allocated memory
+               MemoryTag mTag;
+
+           public:
+
+               /// Constructor
+               TaggedAllocator() : mMemoryManager(nullptr), mAllocationType(AllocationType::Pool),
+                                   mTag(MemoryTag::Other) {}
+
+               /// Destructor
+               virtual ~TaggedAllocator() override = default;
+
+               /// Allocate memory of a given size (in bytes)
+               virtual void* allocate(size_t size) override;
+
+               /// Release previously allocated memory.
+               virtual void release(void* pointer, size_t size) override;
+
+               /// Prepare a given number of allocations of a given size (in bytes) in advance
+               virtual void reserve(size_t size, size_t nbAllocations) override;
+
+               // ---------- Friendship ---------- //
+
+               friend class MemoryManager;
+       };
+
+    private:
+
+       /// Statistics of the allocated memory of each tag
+       MemoryStatistics mStatistics[NB_MEMORY_TAGS];
+
+       /// Tagged allocators of each allocation type and each tag
+       TaggedAllocator mTaggedAllocators[NB_ALLOCATION_TYPES][NB_MEMORY_TAGS];
+
+    public:
+
        /// Constructor
-       MemoryManager() = default;
+       MemoryManager(MemoryAllocator* baseAllocator = nullptr, MemoryAllocator* poolAllocator = nullptr,
+                     SingleFrameAllocator* singleFrameAllocator = nullptr);
 
        /// Destructor
-       ~MemoryManager() = default;
+       ~MemoryManager();
+
+       /// Deleted copy-constructor
+       MemoryManager(const MemoryManager& memoryManager) = delete;
+
+       /// Deleted assignment operator
+       MemoryManager& operator=(const MemoryManager& memoryManager) = delete;
 
         /// Allocate memory of a given type
-        void* allocate(AllocationType allocationType, size_t size);
+        void* allocate(AllocationType allocationType, size_t size, MemoryTag tag = MemoryTag::Other);
 
         /// Release previously allocated memory.
-        void release(AllocationType allocationType, void* pointer, size_t size);
+        void release(AllocationType allocationType, void* pointer, size_t size, MemoryTag tag = MemoryTag::Other);
 
         /// Return the pool allocator
         MemoryAllocator& getPoolAllocator();
 
+        /// Return the pool allocator that tags the allocations
+        MemoryAllocator& getPoolAllocator(MemoryTag tag);
+
         /// Return the single frame stack allocator
         SingleFrameAllocator& getSingleFrameAllocator();
 
-        /// Return the base memory allocator
+        /// Return the single frame allocator that tags the allocations
+        MemoryAllocator& getSingleFrameAllocator(MemoryTag tag);
+
+        /// Return the global base memory allocator
         static MemoryAllocator& getBaseAllocator();
-		
-        /// Set the base memory allocator
-        static void setBaseAllocator(MemoryAllocator* memoryAllocator);
 
-        /// Set the single frame memory allocator
-        static void setSingleFrameAllocator(SingleFrameAllocator* singleFrameAllocator);
+        /// Return the base memory allocator that tags the allocations
+        MemoryAllocator& getBaseAllocator(MemoryTag tag);
 
-        /// Set the pool memory allocator
-        static void setPoolAllocator(MemoryAllocator* poolAllocator);
+        /// Return the statistics of the memory allocated with a given tag
+        const MemoryStatistics& getStatistics(MemoryTag tag) const;
+
+        /// Return the number of allocations with the pool and base allocators of all the tags
+        /// during the current frame
+        uint getNbAllocationsCurrentFrame() const;
+
+        /// Prepare a given number of allocations of a given size with the pool allocator
+        void reservePoolMemory(size_t size, uint nbAllocations);
+		
+        /// Set the global base memory allocator
+        static void setBaseAllocator(MemoryAllocator* memoryAllocator);
 
         /// Reset the single frame allocator
         void resetFrameAllocator();
+
+        /// Create the missing allocators of the workers of a task scheduler
+        void createWorkerAllocators(uint nbWorkers);
+
+        /// Return the number of workers with allocators
+        uint getNbWorkerAllocators() const;
+
+        /// Return the pool allocator of a worker of a task scheduler
+        WorkerPoolAllocator& getWorkerPoolAllocator(uint workerIndex);
+
+        /// Return the single frame allocator of a worker of a task scheduler
+        SingleFrameAllocator& getWorkerSingleFrameAllocator(uint workerIndex);
+
+        /// Reset the single frame allocators of the workers
+        void resetWorkerFrameAllocators();
 };
 
 // Allocate memory of a given type
-inline void* MemoryManager::allocate(AllocationType allocationType, size_t size) {
+/// The memory must be released with the same type and the same tag
+inline void* MemoryManager::allocate(AllocationType allocationType, size_t size, MemoryTag tag) {
 
-    switch (allocationType) {
-       case AllocationType::Base: return mBaseAllocator->allocate(size);
-       case AllocationType::Pool: return mPoolAllocator->allocate(size);
-       case AllocationType::Frame: return mSingleFrameAllocator->allocate(size);
+    MemoryStatistics& statistics = mStatistics[static_cast<int>(tag)];
+
+    if (allocationType == AllocationType::Frame) {
+        statistics.nbFrameBytesCurrentFrame += size;
+        return mSingleFrameAllocator->allocate(size);
     }
 
-    return nullptr;
+    statistics.nbBytesInUse += size;
+    statistics.nbAllocationsCurrentFrame++;
+    if (statistics.nbBytesInUse > statistics.peakNbBytesInUse) {
+        statistics.peakNbBytesInUse = statistics.nbBytesInUse;
+    }
+
+    return allocationType == AllocationType::Base ? mBaseAllocator->allocate(size) : mPoolAllocator->allocate(size);
 }
 
 // Release previously allocated memory.
-inline void MemoryManager::release(AllocationType allocationType, void* pointer, size_t size) {
+inline void MemoryManager::release(AllocationType allocationType, void* pointer, size_t size, MemoryTag tag) {
 
     switch (allocationType) {
        case AllocationType::Base: mBaseAllocator->release(pointer, size); break;
        case AllocationType::Pool: mPoolAllocator->release(pointer, size); break;
-       case AllocationType::Frame: mSingleFrameAllocator->release(pointer, size); break;
+       case AllocationType::Frame: mSingleFrameAllocator->release(pointer, size); return;
     }
+
+    MemoryStatistics& statistics = mStatistics[static_cast<int>(tag)];
+    assert(statistics.nbBytesInUse >= size);
+    statistics.nbBytesInUse -= size;
 }
 
 // Return the pool allocator
@@ -135,34 +310,97 @@ inline MemoryAllocator& MemoryManager::getPoolAllocator() {
    return *mPoolAllocator;
 }
 
+// Return the pool allocator that tags the allocations
+inline MemoryAllocator& MemoryManager::getPoolAllocator(MemoryTag tag) {
+   return mTaggedAllocators[static_cast<int>(AllocationType::Pool)][static_cast<int>(tag)];
+}
+
+// Return the single frame allocator that tags the allocations
+inline MemoryAllocator& MemoryManager::getSingleFrameAllocator(MemoryTag tag) {
+   return mTaggedAllocators[static_cast<int>(AllocationType::Frame)][static_cast<int>(tag)];
+}
+
+// Return the base memory allocator that tags the allocations
+inline MemoryAllocator& MemoryManager::getBaseAllocator(MemoryTag tag) {
+   return mTaggedAllocators[static_cast<int>(AllocationType::Base)][static_cast<int>(tag)];
+}
+
+// Return the statistics of the memory allocated with a given tag
+inline const MemoryStatistics& MemoryManager::getStatistics(MemoryTag tag) const {
+    return mStatistics[static_cast<int>(tag)];
+}
+
 // Return the single frame stack allocator
 inline SingleFrameAllocator& MemoryManager::getSingleFrameAllocator() {
    return *mSingleFrameAllocator;
 }
 
-// Return the base memory allocator
+// Return the global base memory allocator
 inline MemoryAllocator& MemoryManager::getBaseAllocator() {
-    return *mBaseAllocator;
+    return *mGlobalBaseAllocator;
 }
 
-// Set the base memory allocator
+// Set the global base memory allocator
+/// The allocator must be thread-safe if worlds created without a base allocator are
+/// used on different threads. The memory managers that already exist keep their base allocator.
 inline void MemoryManager::setBaseAllocator(MemoryAllocator* baseAllocator) {
-    mBaseAllocator = baseAllocator;
+    mGlobalBaseAllocator = baseAllocator;
+}
+
+// Return the number of allocations with the pool and base allocators of all the tags
+// during the current frame
+inline uint MemoryManager::getNbAllocationsCurrentFrame() const {
+
+    uint nbAllocations = 0;
+    for (int tag=0; tag < NB_MEMORY_TAGS; tag++) {
+        nbAllocations += mStatistics[tag].nbAllocationsCurrentFrame;
+    }
+
+    return nbAllocations;
+}
+
+// Prepare a given number of allocations of a given size with the pool allocator
+/// The allocations will then not need more memory from the base allocator
+inline void MemoryManager::reservePoolMemory(size_t size, uint nbAllocations) {
+    mPoolAllocator->reserve(size, nbAllocations);
+}
+
+// Allocate memory of a given size (in bytes)
+inline void* MemoryManager::TaggedAllocator::allocate(size_t size) {
+    return mMemoryManager->allocate(mAllocationType, size, mTag);
+}
+
+// Release previously allocated memory.
+inline void MemoryManager::TaggedAllocator::release(void* pointer, size_t size) {
+    mMemoryManager->release(mAllocationType, pointer, size, mTag);
+}
+
+// Prepare a given number of allocations of a given size (in bytes) in advance
+inline void MemoryManager::TaggedAllocator::reserve(size_t size, size_t nbAllocations) {
+    if (mAllocationType == AllocationType::Pool) {
+        mMemoryManager->reservePoolMemory(size, static_cast<uint>(nbAllocations));
+    }
 }
 
-// Set the base memory allocator
-inline void MemoryManager::setSingleFrameAllocator(SingleFrameAllocator* singleFrameAllocator) {
-    mSingleFrameAllocator = singleFrameAllocator;
+// Return the number of workers with allocators
+inline uint MemoryManager::getNbWorkerAllocators() const {
+    return mNbWorkersAllocators;
 }
 
-// Set the pool memory allocator
-inline void MemoryManager::setPoolAllocator(MemoryAllocator* poolAllocator) {
-    mPoolAllocator = poolAllocator;
+// Return the pool allocator of a worker of a task scheduler
+/// The allocators must have been created with createWorkerAllocators() before
+/// the parallel tasks start. The allocator must only be used by the worker.
+inline WorkerPoolAllocator& MemoryManager::getWorkerPoolAllocator(uint workerIndex) {
+    assert(workerIndex < mNbWorkersAllocators);
+    return mWorkersAllocators[workerIndex]->poolAllocator;
 }
 
-// Reset the single frame allocator
-inline void MemoryManager::resetFrameAllocator() {
-   mSingleFrameAllocator->reset();
+// Return the single frame allocator of a worker of a task scheduler
+/// The allocators must have been created with createWorkerAllocators() before
+/// the parallel tasks start. The allocator must only be used by the worker.
+inline SingleFrameAllocator& MemoryManager::getWorkerSingleFrameAllocator(uint workerIndex) {
+    assert(workerIndex < mNbWorkersAllocators);
+    return mWorkersAllocators[workerIndex]->singleFrameAllocator;
 }
 
 }
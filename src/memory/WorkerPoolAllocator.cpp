@@ -0,0 +1,114 @@
+/********************************************************************************
+* ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
+* Copyright (c) 2010-2018 Daniel Chappuis                                       *
+*********************************************************************************
+*                                                                               *
+* This software is provided 'as-is', without any express or implied warranty.   *
+* In no event will the authors be held liable for any damages arising from the  *
+* use of this software.                                                         *
+*                                                                               *
+* Permission is granted to anyone to use this software for any purpose,         *
+* including commercial applications, and to alter it and redistribute it        *
+* freely, subject to the following restrictions:                                *
+*                                                                               *
+* 1. The origin of this software must not be misrepresented; you must not claim *
+*    that you wrote the original software. If you use this software in a        *
+*    product, an acknowledgment in the product documentation would be           *
+*    appreciated but is not required.                                           *
+*                                                                               *
+* 2. Altered source versions must be plainly marked as such, and must not be    *
+*    misrepresented as being the original software.                             *
+*                                                                               *
+* 3. This notice may not be removed or altered from any source distribution.    *
+*                                                                               *
+********************************************************************************/
+
+// Libraries
+#include "WorkerPoolAllocator.h"
+#include <cassert>
+
+using namespace reactphysics3d;
+
+// Constructor
+/**
+ * @param baseAllocator Allocator of the memory blocks of the pool (the global base allocator
+ *                      of the MemoryManager if null)
+ */
+WorkerPoolAllocator::WorkerPoolAllocator(MemoryAllocator* baseAllocator)
+                    : mPoolAllocator(DefaultPoolAllocator::MAX_UNIT_SIZE, DefaultPoolAllocator::DEFAULT_RELEASE_WATERMARK,
+                                     baseAllocator),
+                      mRemoteReleases(nullptr) {
+
+}
+
+// Destructor
+WorkerPoolAllocator::~WorkerPoolAllocator() {
+
+    // Release the memory released by the other workers before destroying the pool
+    flushRemoteReleases();
+}
+
+// Allocate memory of a given size (in bytes) and return a pointer to the
+// allocated memory.
+/// This method must only be called by the worker thread of the allocator.
+void* WorkerPoolAllocator::allocate(size_t size) {
+
+    // We cannot allocate zero bytes
+    if (size == 0) return nullptr;
+
+    // Reuse the memory released by the other workers
+    if (mRemoteReleases.load(std::memory_order_relaxed) != nullptr) {
+        flushRemoteReleases();
+    }
+
+    void* allocatedMemory = mPoolAllocator.allocate(size + sizeof(AllocationHeader));
+    AllocationHeader* header = static_cast<AllocationHeader*>(allocatedMemory);
+    header->owner = this;
+    header->size = size;
+
+    return static_cast<void*>(header + 1);
+}
+
+// Release previously allocated memory (by this allocator or by another worker allocator)
+/// This method must only be called by the worker thread of the allocator. If the memory
+/// has been allocated by another worker allocator, it is handed back to this allocator
+/// without any lock.
+void WorkerPoolAllocator::release(void* pointer, size_t size) {
+
+    // Cannot release a 0-byte allocated memory
+    if (size == 0) return;
+
+    AllocationHeader* header = static_cast<AllocationHeader*>(pointer) - 1;
+    assert(header->size == size);
+
+    if (header->owner == this) {
+        mPoolAllocator.release(header, size + sizeof(AllocationHeader));
+    }
+    else {
+        header->owner->pushRemoteRelease(header);
+    }
+}
+
+// Push memory of this allocator released by another worker
+void WorkerPoolAllocator::pushRemoteRelease(AllocationHeader* header) {
+
+    AllocationHeader* head = mRemoteReleases.load(std::memory_order_relaxed);
+    do {
+        header->nextRemoteRelease = head;
+    } while (!mRemoteReleases.compare_exchange_weak(head, header, std::memory_order_release,
+                                                    std::memory_order_relaxed));
+}
+
+// Put the memory released by the other workers back into the pool
+/// This method must only be called by the worker thread of the allocator (or when
+/// no other worker is running)
+void WorkerPoolAllocator::flushRemoteReleases() {
+
+    // Take the whole list at once (the other workers only push to the list)
+    AllocationHeader* header = mRemoteReleases.exchange(nullptr, std::memory_order_acquire);
+    while (header != nullptr) {
+        AllocationHeader* nextHeader = header->nextRemoteRelease;
+        mPoolAllocator.release(header, header->size + sizeof(AllocationHeader));
+        header = nextHeader;
+    }
+}
@@ -0,0 +1,111 @@
+/********************************************************************************
+* ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
+* Copyright (c) 2010-2018 Daniel Chappuis                                       *
+*********************************************************************************
+*                                                                               *
+* This software is provided 'as-is', without any express or implied warranty.   *
+* In no event will the authors be held liable for any damages arising from the  *
+* use of this software.                                                         *
+*                                                                               *
+* Permission is granted to anyone to use this software for any purpose,         *
+* including commercial applications, and to alter it and redistribute it        *
+* freely, subject to the following restrictions:                                *
+*                                                                               *
+* 1. The origin of this software must not be misrepresented; you must not claim *
+*    that you wrote the original software. If you use this software in a        *
+*    product, an acknowledgment in the product documentation would be           *
+*    appreciated but is not required.                                           *
+*                                                                               *
+* 2. Altered source versions must be plainly marked as such, and must not be    *
+*    misrepresented as being the original software.                             *
+*                                                                               *
+* 3. This notice may not be removed or altered from any source distribution.    *
+*                                                                               *
+********************************************************************************/
+
+#ifndef REACTPHYSICS3D_WORKER_POOL_ALLOCATOR_H
+#define REACTPHYSICS3D_WORKER_POOL_ALLOCATOR_H
+
+// Libraries
+#include "configuration.h"
+#include "DefaultPoolAllocator.h"
+#include <atomic>
+
+/// ReactPhysics3D namespace
+namespace reactphysics3d {
+
+// Class WorkerPoolAllocator
+/**
+ * This class is a pool memory allocator used by a single worker thread of a task scheduler.
+ * A worker allocates and releases its memory without any lock. Each allocation has a small
+ * header with the allocator that owns the memory. When a worker releases memory that has been
+ * allocated by another worker (with its own worker allocator), the memory is pushed on a
+ * lock-free list of the owner allocator and the owner puts it back in its pool the next time
+ * it allocates memory (or when flushRemoteReleases() is called).
+ */
+class WorkerPoolAllocator : public MemoryAllocator {
+
+    private :
+
+        // -------------------- Internal Classes -------------------- //
+
+        // Structure AllocationHeader
+        /**
+         * Header stored before the memory of each allocation
+         */
+        struct alignas(VECTOR_ALIGNMENT) AllocationHeader {
+
+            /// Allocator that owns the memory (or next released memory of the list of
+            /// the memory released by the other workers)
+            union {
+                WorkerPoolAllocator* owner;
+                AllocationHeader* nextRemoteRelease;
+            };
+
+            /// Size (in bytes) of the allocated memory (without the header)
+            size_t size;
+        };
+
+        // -------------------- Attributes -------------------- //
+
+        /// Pool allocator of the worker
+        DefaultPoolAllocator mPoolAllocator;
+
+        /// Linked-list of the memory of this allocator released by the other workers
+        std::atomic<AllocationHeader*> mRemoteReleases;
+
+        // -------------------- Methods -------------------- //
+
+        /// Push memory of this allocator released by another worker
+        void pushRemoteRelease(AllocationHeader* header);
+
+    public :
+
+        // -------------------- Methods -------------------- //
+
+        /// Constructor
+        WorkerPoolAllocator(MemoryAllocator* baseAllocator = nullptr);
+
+        /// Destructor
+        virtual ~WorkerPoolAllocator() override;
+
+        /// Deleted copy-constructor
+        WorkerPoolAllocator(const WorkerPoolAllocator& allocator) = delete;
+
+        /// Deleted assignment operator
+        WorkerPoolAllocator& operator=(const WorkerPoolAllocator& allocator) = delete;
+
+        /// Allocate memory of a given size (in bytes) and return a pointer to the
+        /// allocated memory.
+        virtual void* allocate(size_t size) override;
+
+        /// Release previously allocated memory (by this allocator or by another worker allocator)
+        virtual void release(void* pointer, size_t size) override;
+
+        /// Put the memory released by the other workers back into the pool
+        void flushRemoteReleases();
+};
+
+}
+
+#endif
@@ -40,13 +40,26 @@
 #include "body/CollisionBody.h"
 #include "body/RigidBody.h"
 #include "engine/DynamicsWorld.h"
+#include "engine/ParticleSystem.h"
+#include "engine/CharacterController.h"
+#include "engine/Vehicle.h"
 #include "engine/CollisionWorld.h"
 #include "engine/Material.h"
+#include "engine/MaterialTable.h"
 #include "engine/EventListener.h"
+#include "engine/SolverIterationsPolicy.h"
+#include "engine/TaskScheduler.h"
+#include "engine/DefaultTaskScheduler.h"
+#include "engine/WorldGroup.h"
+#include "engine/WorldRecorder.h"
+#include "engine/FixedStepScheduler.h"
 #include "collision/shapes/CollisionShape.h"
 #include "collision/shapes/BoxShape.h"
 #include "collision/shapes/SphereShape.h"
 #include "collision/shapes/CapsuleShape.h"
+#include "collision/shapes/CylinderShape.h"
+#include "collision/shapes/ConeShape.h"
+#include "collision/shapes/CompoundShape.h"
 #include "collision/shapes/ConvexMeshShape.h"
 #include "collision/shapes/ConcaveMeshShape.h"
 #include "collision/shapes/HeightFieldShape.h"
@@ -54,12 +67,17 @@
 #include "collision/shapes/AABB.h"
 #include "collision/ProxyShape.h"
 #include "collision/RaycastInfo.h"
+#include "collision/SweepInfo.h"
+#include "collision/DistanceInfo.h"
+#include "collision/SceneQuerySnapshot.h"
 #include "collision/TriangleMesh.h"
 #include "collision/PolyhedronMesh.h"
 #include "collision/TriangleVertexArray.h"
 #include "collision/PolygonVertexArray.h"
+#include "collision/ConvexHull.h"
 #include "collision/CollisionCallback.h"
 #include "collision/OverlapCallback.h"
+#include "collision/ContactEvent.h"
 #include "constraint/BallAndSocketJoint.h"
 #include "constraint/SliderJoint.h"
 #include "constraint/HingeJoint.h"
@@ -0,0 +1,133 @@
+/********************************************************************************
+* ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
+* Copyright (c) 2010-2018 Daniel Chappuis                                       *
+*********************************************************************************
+*                                                                               *
+* This software is provided 'as-is', without any express or implied warranty.   *
+* In no event will the authors be held liable for any damages arising from the  *
+* use of this software.                                                         *
+*                                                                               *
+* Permission is granted to anyone to use this software for any purpose,         *
+* including commercial applications, and to alter it and redistribute it        *
+* freely, subject to the following restrictions:                                *
+*                                                                               *
+* 1. The origin of this software must not be misrepresented; you must not claim *
+*    that you wrote the original software. If you use this software in a        *
+*    product, an acknowledgment in the product documentation would be           *
+*    appreciated but is not required.                                           *
+*                                                                               *
+* 2. Altered source versions must be plainly marked as such, and must not be    *
+*    misrepresented as being the original software.                             *
+*                                                                               *
+* 3. This notice may not be removed or altered from any source distribution.    *
+*                                                                               *
+********************************************************************************/
+
+// If the hardware counters of the profiler are enabled
+#if defined(IS_PROFILING_ACTIVE) && defined(IS_PROFILING_HARDWARE_COUNTERS_ACTIVE)
+
+// Libraries
+#include "HardwareCounters.h"
+#include <cstring>
+
+#if defined(__linux__)
+    #include <linux/perf_event.h>
+    #include <sys/syscall.h>
+    #include <unistd.h>
+#endif
+
+using namespace reactphysics3d;
+
+// Constructor (opens the counters of the calling thread)
+HardwareCounters::HardwareCounters() : mIsAvailable(false) {
+
+    for (int i=0; i < NB_HARDWARE_COUNTERS; i++) {
+        mFileDescriptors[i] = -1;
+    }
+
+#if defined(__linux__)
+
+    const uint64 configs[NB_HARDWARE_COUNTERS] = {PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS,
+                                                  PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_HW_BRANCH_MISSES};
+
+    for (int i=0; i < NB_HARDWARE_COUNTERS; i++) {
+
+        perf_event_attr attributes;
+        std::memset(&attributes, 0, sizeof(perf_event_attr));
+        attributes.type = PERF_TYPE_HARDWARE;
+        attributes.size = sizeof(perf_event_attr);
+        attributes.config = configs[i];
+        attributes.exclude_kernel = 1;
+        attributes.exclude_hv = 1;
+        attributes.read_format = PERF_FORMAT_GROUP;
+
+        // Count the calling thread on any CPU
+        mFileDescriptors[i] = static_cast<int>(syscall(SYS_perf_event_open, &attributes, 0, -1,
+                                                       i == 0 ? -1 : mFileDescriptors[0], 0));
+        if (mFileDescriptors[i] < 0) {
+            close();
+            return;
+        }
+    }
+
+    mIsAvailable = true;
+
+#endif
+}
+
+// Destructor
+HardwareCounters::~HardwareCounters() {
+    close();
+}
+
+// Close the counters
+void HardwareCounters::close() {
+
+#if defined(__linux__)
+    for (int i=NB_HARDWARE_COUNTERS - 1; i >= 0; i--) {
+        if (mFileDescriptors[i] >= 0) {
+            ::close(mFileDescriptors[i]);
+            mFileDescriptors[i] = -1;
+        }
+    }
+#endif
+
+    mIsAvailable = false;
+}
+
+// Read the current values of the counters
+void HardwareCounters::read(uint64* values) const {
+
+#if defined(__linux__)
+    if (mIsAvailable) {
+
+        // Values of the group (number of counters followed by their values)
+        uint64 data[1 + NB_HARDWARE_COUNTERS];
+        if (::read(mFileDescriptors[0], data, sizeof(data)) == static_cast<ssize_t>(sizeof(data))) {
+            for (int i=0; i < NB_HARDWARE_COUNTERS; i++) {
+                values[i] = data[1 + i];
+            }
+            return;
+        }
+    }
+#endif
+
+    for (int i=0; i < NB_HARDWARE_COUNTERS; i++) {
+        values[i] = 0;
+    }
+}
+
+// Return the name of a counter
+const char* HardwareCounters::getCounterName(HardwareCounter counter) {
+
+    switch (counter) {
+        case HardwareCounter::Cycles: return "cycles";
+        case HardwareCounter::Instructions: return "instructions";
+        case HardwareCounter::CacheMisses: return "LLC misses";
+        case HardwareCounter::BranchMisses: return "branch misses";
+    }
+
+    return "";
+}
+
+#endif
@@ -0,0 +1,104 @@
+/********************************************************************************
+* ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
+* Copyright (c) 2010-2018 Daniel Chappuis                                       *
+*********************************************************************************
+*                                                                               *
+* This software is provided 'as-is', without any express or implied warranty.   *
+* In no event will the authors be held liable for any damages arising from the  *
+* use of this software.                                                         *
+*                                                                               *
+* Permission is granted to anyone to use this software for any purpose,         *
+* including commercial applications, and to alter it and redistribute it        *
+* freely, subject to the following restrictions:                                *
+*                                                                               *
+* 1. The origin of this software must not be misrepresented; you must not claim *
+*    that you wrote the original software. If you use this software in a        *
+*    product, an acknowledgment in the product documentation would be           *
+*    appreciated but is not required.                                           *
+*                                                                               *
+* 2. Altered source versions must be plainly marked as such, and must not be    *
+*    misrepresented as being the original software.                             *
+*                                                                               *
+* 3. This notice may not be removed or altered from any source distribution.    *
+*                                                                               *
+********************************************************************************/
+
+#ifndef REACTPHYSICS3D_HARDWARE_COUNTERS_H
+#define REACTPHYSICS3D_HARDWARE_COUNTERS_H
+
+// If the hardware counters of the profiler are enabled
+#if defined(IS_PROFILING_ACTIVE) && defined(IS_PROFILING_HARDWARE_COUNTERS_ACTIVE)
+
+// Libraries
+#include "configuration.h"
+
+/// ReactPhysics3D namespace
+namespace reactphysics3d {
+
+/// Hardware performance counters measured by the profiler
+enum class HardwareCounter {Cycles, Instructions, CacheMisses, BranchMisses};
+const int NB_HARDWARE_COUNTERS = 4;
+
+// Class HardwareCounters
+/**
+ * This class reads the hardware performance counters (cycles, instructions retired,
+ * last level cache misses and branch mispredictions) of the thread that has created it.
+ * The counters are opened as a single group with the perf_event interface of Linux so
+ * that they are read together with a single system call. They only count the user space
+ * code of the thread. If the counters are not available (other platform, virtual
+ * machine without a performance monitoring unit or perf_event_paranoid setting), the
+ * values read are always zero.
+ */
+class HardwareCounters {
+
+    private :
+
+        // -------------------- Attributes -------------------- //
+
+        /// File descriptors of the counters (the first one is the leader of the group)
+        int mFileDescriptors[NB_HARDWARE_COUNTERS];
+
+        /// True if the counters have been opened
+        bool mIsAvailable;
+
+        // -------------------- Methods -------------------- //
+
+        /// Close the counters
+        void close();
+
+    public :
+
+        // -------------------- Methods -------------------- //
+
+        /// Constructor (opens the counters of the calling thread)
+        HardwareCounters();
+
+        /// Destructor
+        ~HardwareCounters();
+
+        /// Deleted copy-constructor
+        HardwareCounters(const HardwareCounters& counters) = delete;
+
+        /// Deleted assignment operator
+        HardwareCounters& operator=(const HardwareCounters& counters) = delete;
+
+        /// Return true if the counters are available
+        bool isAvailable() const;
+
+        /// Read the current values of the counters
+        void read(uint64* values) const;
+
+        /// Return the name of a counter
+        static const char* getCounterName(HardwareCounter counter);
+};
+
+// Return true if the counters are available
+inline bool HardwareCounters::isAvailable() const {
+    return mIsAvailable;
+}
+
+}
+
+#endif
+
+#endif
@@ -32,18 +32,43 @@
 using namespace reactphysics3d;
 
 // Constructor
-Logger::Logger()
-       : mDestinations(MemoryManager::getBaseAllocator()), mFormatters(MemoryManager::getBaseAllocator())
+/**
+ * @param bufferCapacity Number of messages that can be waiting to be written into the
+ *                       destinations (rounded up to a power of two)
+ */
+Logger::Logger(uint bufferCapacity)
+       : mDestinations(MemoryManager::getBaseAllocator()), mFormatters(MemoryManager::getBaseAllocator()),
+         mEnabledLevels(0), mNbRecords(1), mEnqueuePosition(0), mDequeuePosition(0), mNbDroppedMessages(0),
+         mNbReportedDroppedMessages(0), mIsFlusherStopping(false)
 {
 
     // Create the log formatters
     mFormatters.add(Pair<Format, Formatter*>(Format::Text, new TextFormatter()));
     mFormatters.add(Pair<Format, Formatter*>(Format::HTML, new HtmlFormatter()));
+
+    // Create the ring buffer
+    while (mNbRecords < bufferCapacity || mNbRecords < 2) mNbRecords *= 2;
+    mRecords = new Record[mNbRecords];
+    for (size_t i=0; i < mNbRecords; i++) {
+        mRecords[i].sequence.store(i, std::memory_order_relaxed);
+        mRecords[i].message.reserve(RECORD_MESSAGE_CAPACITY);
+    }
+
+    // Start the background thread that writes the messages
+    mFlusherThread = std::thread(&Logger::runFlusher, this);
 }
 
 // Destructor
 Logger::~Logger() {
 
+    // Stop the background thread
+    {
+        std::lock_guard<std::mutex> lock(mFlusherMutex);
+        mIsFlusherStopping = true;
+    }
+    mFlusherCondition.notify_one();
+    mFlusherThread.join();
+
     removeAllDestinations();
 
     // Remove all the loggers
@@ -51,6 +76,8 @@ Logger::~Logger() {
 
        delete it->second;
     }
+
+    delete[] mRecords;
 }
 
 // Return the corresponding formatter
@@ -67,20 +94,33 @@ Logger::Formatter* Logger::getFormatter(Format format) const {
 // Add a log file destination to the logger
 void Logger::addFileDestination(const std::string& filePath, uint logLevelFlag, Format format) {
 
+    std::lock_guard<std::mutex> lock(mMutex);
+
     FileDestination* destination = new FileDestination(filePath, logLevelFlag, getFormatter(format));
     mDestinations.add(destination);
+    mEnabledLevels.fetch_or(logLevelFlag);
 }
 
 /// Add a stream destination to the logger
 void Logger::addStreamDestination(std::ostream& outputStream, uint logLevelFlag, Format format) {
 
+    std::lock_guard<std::mutex> lock(mMutex);
+
     StreamDestination* destination = new StreamDestination(outputStream, logLevelFlag, getFormatter(format));
     mDestinations.add(destination);
+    mEnabledLevels.fetch_or(logLevelFlag);
 }
 
 // Remove all logs destination previously set
+/// The messages logged before are written into the destinations before they are removed.
 void Logger::removeAllDestinations() {
 
+    std::lock_guard<std::mutex> lock(mMutex);
+
+    writeRecords();
+
+    mEnabledLevels.store(0);
+
     // Delete all the destinations
     for (uint i=0; i<mDestinations.size(); i++) {
         delete mDestinations[i];
@@ -90,21 +130,123 @@ void Logger::removeAllDestinations() {
 }
 
 // Log something
+/// The message is copied into the ring buffer and will be written into the destinations
+/// by the background thread. This method does not lock and does not allocate memory
+/// (unless the message is longer than the memory reserved for a message).
 void Logger::log(Level level, Category category, const std::string& message) {
 
-    // Get current time
-    auto now = std::chrono::system_clock::now();
-    auto time = std::chrono::system_clock::to_time_t(now);
+    // Reserve a record of the ring buffer
+    size_t position = mEnqueuePosition.load(std::memory_order_relaxed);
+    Record* record;
+    while (true) {
+
+        record = &(mRecords[position & (mNbRecords - 1)]);
+        const size_t sequence = record->sequence.load(std::memory_order_acquire);
+        const std::ptrdiff_t difference = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(position);
+
+        // If the record is free, try to take it
+        if (difference == 0) {
+            if (mEnqueuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                break;
+            }
+        }
+        else if (difference < 0) {
+
+            // The ring buffer is full
+            mNbDroppedMessages.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        else {
+
+            // Another thread has taken the record
+            position = mEnqueuePosition.load(std::memory_order_relaxed);
+        }
+    }
+
+    // Fill the record and publish it to the consumer
+    record->time = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
+    record->level = level;
+    record->category = category;
+    record->message.assign(message);
+    record->sequence.store(position + 1, std::memory_order_release);
+
+    // Wake up the background thread when half of the ring buffer has been filled since
+    // the last wake up so that a burst of messages does not fill the whole buffer
+    if ((position & ((mNbRecords >> 1) - 1)) == 0) {
+        mFlusherCondition.notify_one();
+    }
+}
+
+// Write all the messages logged so far into the destinations
+void Logger::flush() {
 
-    mMutex.lock();
+    std::lock_guard<std::mutex> lock(mMutex);
+    writeRecords();
+}
+
+// Write the messages of the ring buffer into the destinations (the mutex must be locked)
+void Logger::writeRecords() {
+
+    bool isWritten = false;
+
+    while (true) {
+
+        Record& record = mRecords[mDequeuePosition & (mNbRecords - 1)];
+
+        // Stop at the first record that has not been published yet
+        if (record.sequence.load(std::memory_order_acquire) != mDequeuePosition + 1) break;
+
+        // For each destination that accepts the level of the message
+        for (auto it = mDestinations.begin(); it != mDestinations.end(); ++it) {
+            if (((*it)->levelFlag & static_cast<uint>(record.level)) != 0) {
+                (*it)->write(record.time, record.message, record.level, record.category);
+            }
+        }
+
+        // Give the record back to the producers
+        record.sequence.store(mDequeuePosition + mNbRecords, std::memory_order_release);
+        mDequeuePosition++;
+        isWritten = true;
+    }
 
-    // For each destination
-    for (auto it = mDestinations.begin(); it != mDestinations.end(); ++it) {
+    // Report the messages that have been dropped since the last report
+    const uint64 nbDroppedMessages = mNbDroppedMessages.load(std::memory_order_relaxed);
+    if (nbDroppedMessages != mNbReportedDroppedMessages) {
+
+        const time_t time = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
+        const std::string message = "Logger: " + std::to_string(nbDroppedMessages - mNbReportedDroppedMessages) +
+                                    " messages have been dropped because the buffer was full";
+        for (auto it = mDestinations.begin(); it != mDestinations.end(); ++it) {
+            if (((*it)->levelFlag & static_cast<uint>(Level::Warning)) != 0) {
+                (*it)->write(time, message, Level::Warning, Category::World);
+            }
+        }
+
+        mNbReportedDroppedMessages = nbDroppedMessages;
+        isWritten = true;
+    }
 
-        (*it)->write(time, message, level, category);
+    // Flush the output streams once for all the messages
+    if (isWritten) {
+        for (auto it = mDestinations.begin(); it != mDestinations.end(); ++it) {
+            (*it)->flush();
+        }
     }
+}
+
+// Main loop of the background thread
+void Logger::runFlusher() {
 
-    mMutex.unlock();
+    std::unique_lock<std::mutex> flusherLock(mFlusherMutex);
+
+    while (!mIsFlusherStopping) {
+
+        mFlusherCondition.wait_for(flusherLock, std::chrono::milliseconds(int(FLUSH_PERIOD_MS)));
+
+        flusherLock.unlock();
+        flush();
+        flusherLock.lock();
+    }
 }
 
 #endif
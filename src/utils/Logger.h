@@ -38,6 +38,12 @@
 #include <sstream>
 #include <iomanip>
 #include <mutex>
+#include <atomic>
+#include <thread>
+#include <condition_variable>
+#include <chrono>
+#include <cstddef>
+#include <ctime>
 
 /// ReactPhysics3D namespace
 namespace reactphysics3d {
@@ -45,7 +51,12 @@ namespace reactphysics3d {
 // Class Logger
 /**
  * This class is used to log information, warnings or errors during the execution of the
- * library code for easier debugging.
+ * library code for easier debugging. A message is not formatted and not written by the
+ * thread that logs it. It is copied into a bounded ring buffer without any lock (several
+ * threads can log at the same time) and a background thread formats the messages of the
+ * buffer and writes them into the destinations. The RP3D_LOG macro does not even build
+ * the message when its level is not enabled in any destination. If the buffer is full,
+ * the message is dropped (see getNbDroppedMessages()).
  */
 class Logger {
 
@@ -87,6 +98,18 @@ class Logger {
             return "";
         }
 
+        /// Convert a time into the local time (this can be called by several threads)
+        static std::tm getLocalTime(time_t time) {
+
+            std::tm localTime;
+#if defined(WINDOWS_OS)
+            localtime_s(&localTime, &time);
+#else
+            localtime_r(&time, &localTime);
+#endif
+            return localTime;
+        }
+
         /// Log formatter
         class Formatter {
 
@@ -136,11 +159,12 @@ class Logger {
                     // Get current date
                     auto now = std::chrono::system_clock::now();
                     auto time = std::chrono::system_clock::to_time_t(now);
+                    const std::tm localTime = getLocalTime(time);
 
                     std::stringstream ss;
                     ss << "ReactPhysics3D Logs" << std::endl;
                     ss << "ReactPhysics3D Version: " << RP3D_VERSION << std::endl;
-                    ss << "Date: " << std::put_time(std::localtime(&time), "%Y-%m-%d") << std::endl;
+                    ss << "Date: " << std::put_time(&localTime, "%Y-%m-%d") << std::endl;
                     ss << "---------------------------------------------------------" << std::endl;
 
                     return ss.str();
@@ -149,10 +173,11 @@ class Logger {
                 /// Format a log message
                 virtual std::string format(const time_t& time, const std::string& message,
                                            Level level, Category category) override {
+                    const std::tm localTime = getLocalTime(time);
                     std::stringstream ss;
 
                     // Time
-                    ss << std::put_time(std::localtime(&time), "%X") << " ";
+                    ss << std::put_time(&localTime, "%X") << " ";
 
                     // Level
                     ss << getLevelName(level) << " ";
@@ -177,6 +202,7 @@ class Logger {
                     // Get current date
                     auto now = std::chrono::system_clock::now();
                     auto time = std::chrono::system_clock::to_time_t(now);
+                    const std::tm localTime = getLocalTime(time);
 
                     std::stringstream ss;
                     ss << "<!DOCTYPE HTML>" << std::endl;
@@ -189,7 +215,7 @@ class Logger {
                     ss << "<h1>ReactPhysics3D Logs</h1>" << std::endl;
                     ss << "<div class='general_info'>" << std::endl;
                     ss << "<p>ReactPhysics3D version: " << RP3D_VERSION << "</p>" << std::endl;
-                    ss << "<p>Date: " << std::put_time(std::localtime(&time), "%Y-%m-%d") << "</p>" << std::endl;
+                    ss << "<p>Date: " << std::put_time(&localTime, "%Y-%m-%d") << "</p>" << std::endl;
                     ss << "</div>" << std::endl;
                     ss << "<hr>";
 
@@ -287,13 +313,14 @@ class Logger {
                 virtual std::string format(const time_t& time, const std::string& message,
                                            Level level, Category category) override {
 
+                    const std::tm localTime = getLocalTime(time);
                     std::stringstream ss;
 
                     ss << "<div class='line " + toLowerCase(getCategoryName(category)) + " " + toLowerCase(getLevelName(level)) + "'>";
 
                     // Time
                     ss << "<div class='time'>";
-                    ss << std::put_time(std::localtime(&time), "%X");
+                    ss << std::put_time(&localTime, "%X");
                     ss << "</div>";
 
                     // Level
@@ -343,6 +370,9 @@ class Logger {
 
                 /// Write a message into the output stream
                 virtual void write(const time_t& time, const std::string& message, Level level, Category category) = 0;
+
+                /// Flush the messages written into the output stream
+                virtual void flush() = 0;
         };
 
         class FileDestination : public Destination {
@@ -384,7 +414,12 @@ class Logger {
 
                 /// Write a message into the output stream
                 virtual void write(const time_t& time, const std::string& message, Level level, Category category) override {
-                    mFileStream << formatter->format(time, message, level, category) << std::endl << std::flush;
+                    mFileStream << formatter->format(time, message, level, category) << '\n';
+                }
+
+                /// Flush the messages written into the output stream
+                virtual void flush() override {
+                    mFileStream.flush();
                 }
         };
 
@@ -415,13 +450,45 @@ class Logger {
 
                 /// Write a message into the output stream
                 virtual void write(const time_t& time, const std::string& message, Level level, Category category) override {
-                    mOutputStream << formatter->format(time, message, level, category) << std::endl << std::flush;
+                    mOutputStream << formatter->format(time, message, level, category) << '\n';
+                }
+
+                /// Flush the messages written into the output stream
+                virtual void flush() override {
+                    mOutputStream.flush();
                 }
         };
 
 
     private:
 
+        /// Message stored in the ring buffer
+        struct Record {
+
+            /// Sequence number used to synchronize the producers and the consumer
+            std::atomic<size_t> sequence;
+
+            /// Time of the message
+            time_t time;
+
+            /// Level of the message
+            Level level;
+
+            /// Category of the message
+            Category category;
+
+            /// Message (its memory is reserved once and reused by the next messages)
+            std::string message;
+        };
+
+        // -------------------- Constants -------------------- //
+
+        /// Number of characters reserved for the message of each record of the ring buffer
+        static const size_t RECORD_MESSAGE_CAPACITY = 256;
+
+        /// Period of the background thread that writes the messages (in milliseconds)
+        static const int FLUSH_PERIOD_MS = 10;
+
         // -------------------- Attributes -------------------- //
 
         /// All the log destinations
@@ -430,24 +497,74 @@ class Logger {
         /// Map a log format to the given formatter object
         Map<Format, Formatter*> mFormatters;
 
-        /// Mutex
+        /// Mutex of the consumer of the ring buffer and of the destinations
         std::mutex mMutex;
 
+        /// Levels enabled by at least one destination
+        std::atomic<uint> mEnabledLevels;
+
+        /// Ring buffer of the messages that have not been written yet
+        Record* mRecords;
+
+        /// Number of records of the ring buffer (a power of two)
+        size_t mNbRecords;
+
+        /// Position of the next record to fill in the ring buffer
+        std::atomic<size_t> mEnqueuePosition;
+
+        /// Position of the next record to write into the destinations
+        size_t mDequeuePosition;
+
+        /// Number of messages dropped because the ring buffer was full
+        std::atomic<uint64> mNbDroppedMessages;
+
+        /// Number of dropped messages already reported into the destinations
+        uint64 mNbReportedDroppedMessages;
+
+        /// Thread that writes the messages into the destinations
+        std::thread mFlusherThread;
+
+        /// Mutex used to wake up and stop the background thread
+        std::mutex mFlusherMutex;
+
+        /// Condition variable used to wake up and stop the background thread
+        std::condition_variable mFlusherCondition;
+
+        /// True if the background thread must stop
+        bool mIsFlusherStopping;
+
         // -------------------- Methods -------------------- //
 
         /// Return the corresponding formatter
         Formatter* getFormatter(Format format) const;
 
+        /// Write the messages of the ring buffer into the destinations (the mutex must be locked)
+        void writeRecords();
+
+        /// Main loop of the background thread
+        void runFlusher();
+
     public :
 
+        // -------------------- Constants -------------------- //
+
+        /// Default number of messages of the ring buffer
+        static const uint DEFAULT_BUFFER_CAPACITY = 1024;
+
         // -------------------- Methods -------------------- //
 
         /// Constructor
-        Logger();
+        Logger(uint bufferCapacity = DEFAULT_BUFFER_CAPACITY);
 
         /// Destructor
         ~Logger();
 
+        /// Deleted copy-constructor
+        Logger(const Logger& logger) = delete;
+
+        /// Deleted assignment operator
+        Logger& operator=(const Logger& logger) = delete;
+
         /// Add a file destination to the logger
         void addFileDestination(const std::string& filePath, uint logLevelFlag, Format format);
 
@@ -457,10 +574,29 @@ class Logger {
         /// Remove all logs destination previously set
         void removeAllDestinations();
 
+        /// Return true if a level is enabled in at least one destination
+        bool isLevelEnabled(Level level) const;
+
         /// Log something
         void log(Level level, Category category, const std::string& message);
+
+        /// Write all the messages logged so far into the destinations
+        void flush();
+
+        /// Return the number of messages dropped because the buffer was full
+        uint64 getNbDroppedMessages() const;
 };
 
+// Return true if a level is enabled in at least one destination
+inline bool Logger::isLevelEnabled(Level level) const {
+    return (mEnabledLevels.load(std::memory_order_relaxed) & static_cast<uint>(level)) != 0;
+}
+
+// Return the number of messages dropped because the buffer was full
+inline uint64 Logger::getNbDroppedMessages() const {
+    return mNbDroppedMessages.load(std::memory_order_relaxed);
+}
+
 }
 
 // Hash function for struct VerticesPair
@@ -475,8 +611,9 @@ namespace std {
   };
 }
 
-// Use this macro to log something
-#define RP3D_LOG(logger, level, category, message) logger->log(level, category, message)
+// Use this macro to log something (the message is only built if its level is enabled)
+#define RP3D_LOG(logger, level, category, message) \
+    do { if ((logger)->isLevelEnabled(level)) (logger)->log(level, category, message); } while (false)
 
 // If the logging is not enabled
 #else
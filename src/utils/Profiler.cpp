@@ -33,11 +33,20 @@
 
 using namespace reactphysics3d;
 
+// Static thread-local cache of the buffers
+thread_local uint64 Profiler::mCachedProfilerId = 0;
+thread_local ProfileThreadBuffer* Profiler::mCachedThreadBuffer = nullptr;
+
 // Constructor
 ProfileNode::ProfileNode(const char* name, ProfileNode* parentNode)
     :mName(name), mNbTotalCalls(0), mStartingTime(0), mTotalTime(0),
      mRecursionCounter(0), mParentNode(parentNode), mChildNode(nullptr),
      mSiblingNode(nullptr) {
+#ifdef IS_PROFILING_HARDWARE_COUNTERS_ACTIVE
+    for (int i=0; i < NB_HARDWARE_COUNTERS; i++) {
+        mStartingCounters[i] = 0;
+    }
+#endif
     reset();
 }
 
@@ -70,31 +79,41 @@ ProfileNode* ProfileNode::findSubNode(const char* name) {
 }
 
 // Called when we enter the block of code corresponding to this profile node
-void ProfileNode::enterBlockOfCode() {
+void ProfileNode::enterBlockOfCode(const ProfileEvent& event) {
     mNbTotalCalls++;
 
     // If the current code is not called recursively
     if (mRecursionCounter == 0) {
 
-        // Get the current system time to initialize the starting time of
-        // the profiling of the current block of code
-        mStartingTime = Timer::getCurrentSystemTime() * 1000.0L;
+        // Initialize the starting time of the profiling of the current block of code
+        mStartingTime = event.ticks;
+
+#ifdef IS_PROFILING_HARDWARE_COUNTERS_ACTIVE
+        for (int i=0; i < NB_HARDWARE_COUNTERS; i++) {
+            mStartingCounters[i] = event.counters[i];
+        }
+#endif
     }
 
     mRecursionCounter++;
 }
 
 // Called when we exit the block of code corresponding to this profile node
-bool ProfileNode::exitBlockOfCode() {
+bool ProfileNode::exitBlockOfCode(const ProfileEvent& event) {
     mRecursionCounter--;
 
     if (mRecursionCounter == 0 && mNbTotalCalls != 0) {
 
-        // Get the current system time
-        long double currentTime = Timer::getCurrentSystemTime() * 1000.0L;
+        // Increase the total elasped time (in milliseconds) in the current block of code
+        mTotalTime += static_cast<long double>(event.ticks - mStartingTime) * 1.0e-6L;
 
-        // Increase the total elasped time in the current block of code
-        mTotalTime += currentTime - mStartingTime;
+#ifdef IS_PROFILING_HARDWARE_COUNTERS_ACTIVE
+        for (int i=0; i < NB_HARDWARE_COUNTERS; i++) {
+            if (event.counters[i] > mStartingCounters[i]) {
+                mTotalCounters[i] += event.counters[i] - mStartingCounters[i];
+            }
+        }
+#endif
     }
 
     // Return true if the current code is not recursing
@@ -105,6 +124,11 @@ bool ProfileNode::exitBlockOfCode() {
 void ProfileNode::reset() {
     mNbTotalCalls = 0;
     mTotalTime = 0.0L;
+#ifdef IS_PROFILING_HARDWARE_COUNTERS_ACTIVE
+    for (int i=0; i < NB_HARDWARE_COUNTERS; i++) {
+        mTotalCounters[i] = 0;
+    }
+#endif
 
     // Reset the child node
     if (mChildNode != nullptr) {
@@ -155,10 +179,66 @@ void ProfileNodeIterator::enterParent() {
 }
 
 // Constructor
-Profiler::Profiler() :mRootNode("Root", nullptr), mDestinations(MemoryManager::getBaseAllocator()) {
+ProfileThreadBuffer::ProfileThreadBuffer(std::thread::id threadId, uint capacity)
+    :mThreadId(threadId), mEvents(new ProfileEvent[capacity]), mNbEvents(0), mCapacity(capacity),
+     mRootNode("Root", nullptr), mCurrentNode(&mRootNode), mIsTimelineCaptureEnabled(false),
+     mTimeline(MemoryManager::getBaseAllocator()) {
+
+    assert(capacity > 0);
+}
+
+// Destructor
+ProfileThreadBuffer::~ProfileThreadBuffer() {
+    delete[] mEvents;
+}
+
+// Replay the recorded events into the profiler tree and empty the buffer
+void ProfileThreadBuffer::flushEvents() {
+
+    for (uint i=0; i<mNbEvents; i++) {
+
+        const ProfileEvent& event = mEvents[i];
+
+        if (mIsTimelineCaptureEnabled) {
+            mTimeline.add(event);
+        }
+
+        // If the event is the entry into a block of code
+        if (event.name != nullptr) {
+
+            // Look for the node in the tree that corresponds to the block of
+            // code to profile
+            if (event.name != mCurrentNode->getName()) {
+                mCurrentNode = mCurrentNode->findSubNode(event.name);
+            }
+
+            // Start profile the node
+            mCurrentNode->enterBlockOfCode(event);
+        }
+        else {
+
+            // Go to the parent node unless if the current block
+            // of code is recursing
+            if (mCurrentNode->exitBlockOfCode(event)) {
+                mCurrentNode = mCurrentNode->getParentNode();
+            }
+        }
+    }
+
+    mNbEvents = 0;
+}
+
+// Constructor
+Profiler::Profiler(uint eventBufferCapacity)
+    :mId(computeNextProfilerId()), mEventBufferCapacity(eventBufferCapacity),
+     mThreadBuffers(MemoryManager::getBaseAllocator()), mIsTimelineCaptureEnabled(false),
+     mTimelineFrameTicks(MemoryManager::getBaseAllocator()), mTimelineFirstFrame(0),
+     mDestinations(MemoryManager::getBaseAllocator()) {
+
+    // Create the buffer of the thread that creates the profiler
+    findThreadBuffer();
 
-	mCurrentNode = &mRootNode;
-    mProfilingStartTime = Timer::getCurrentSystemTime() * 1000.0L;
+    mProfilingStartTime = Timer::getCurrentTicks();
 	mFrameCounter = 0;
 }
 
@@ -170,6 +250,56 @@ Profiler::~Profiler() {
 	destroy();
 }
 
+// Return a new unique identifier for a profiler
+uint64 Profiler::computeNextProfilerId() {
+
+    // The identifier zero is used for an empty cache
+    static std::atomic<uint64> nextProfilerId(1);
+    return nextProfilerId++;
+}
+
+// Find or create the buffer of the current thread
+/// This method is only called the first time a thread uses the profiler (or when the
+/// thread has used another profiler in between) and is therefore allowed to lock.
+ProfileThreadBuffer* Profiler::findThreadBuffer() {
+
+    const std::thread::id threadId = std::this_thread::get_id();
+
+    std::lock_guard<std::mutex> lock(mMutex);
+
+    // Look for the buffer of the thread
+    ProfileThreadBuffer* buffer = nullptr;
+    for (uint i=0; i<mThreadBuffers.size(); i++) {
+        if (mThreadBuffers[i]->getThreadId() == threadId) {
+            buffer = mThreadBuffers[i];
+            break;
+        }
+    }
+
+    // If the thread has not used the profiler yet, we create its buffer
+    if (buffer == nullptr) {
+        buffer = new ProfileThreadBuffer(threadId, mEventBufferCapacity);
+        buffer->setIsTimelineCaptureEnabled(mIsTimelineCaptureEnabled);
+        mThreadBuffers.add(buffer);
+    }
+
+    // Store the buffer in the thread-local cache
+    mCachedProfilerId = mId;
+    mCachedThreadBuffer = buffer;
+
+    return buffer;
+}
+
+// Replay the recorded events of all the threads into their profiler trees
+void Profiler::flushAllEvents() {
+
+    std::lock_guard<std::mutex> lock(mMutex);
+
+    for (uint i=0; i<mThreadBuffers.size(); i++) {
+        mThreadBuffers[i]->flushEvents();
+    }
+}
+
 // Remove all logs destination previously set
 void Profiler::removeAllDestinations() {
 
@@ -181,54 +311,166 @@ void Profiler::removeAllDestinations() {
     mDestinations.clear();
 }
 
-// Method called when we want to start profiling a block of code.
-void Profiler::startProfilingBlock(const char* name) {
+// Reset the timing data of the profiler (but not the profiler tree structure)
+void Profiler::reset() {
+
+    flushAllEvents();
 
-    // Look for the node in the tree that corresponds to the block of
-    // code to profile
-    if (name != mCurrentNode->getName()) {
-        mCurrentNode = mCurrentNode->findSubNode(name);
+    for (uint i=0; i<mThreadBuffers.size(); i++) {
+        mThreadBuffers[i]->getRootNode()->reset();
     }
 
-    // Start profile the node
-    mCurrentNode->enterBlockOfCode();
+    mProfilingStartTime = Timer::getCurrentTicks();
+    ProfileEvent rootEvent = {"Root", mProfilingStartTime};
+    mThreadBuffers[0]->getRootNode()->enterBlockOfCode(rootEvent);
+    mFrameCounter = 0;
+
+    clearTimeline();
 }
 
-// Method called at the end of the scope where the
-// startProfilingBlock() method has been called.
-void Profiler::stopProfilingBlock() {
+// Enable or disable the capture of the timeline of the events of every frame
+/// When the capture is enabled, every event recorded by the threads is also kept in
+/// the timeline of the thread. The timeline grows with the number of captured frames
+/// and should only be enabled to record a few seconds of the simulation. It is printed
+/// into the destinations with the Chrome trace format. This method must be called
+/// while the other threads are not profiling (between two frames).
+void Profiler::setIsTimelineCaptureEnabled(bool isEnabled) {
+
+    // Replay the previous events so that they are not added to the timeline
+    flushAllEvents();
+
+    mIsTimelineCaptureEnabled = isEnabled;
 
-    // Go to the parent node unless if the current block
-    // of code is recursing
-    if (mCurrentNode->exitBlockOfCode()) {
-        mCurrentNode = mCurrentNode->getParentNode();
+    std::lock_guard<std::mutex> lock(mMutex);
+
+    for (uint i=0; i<mThreadBuffers.size(); i++) {
+        mThreadBuffers[i]->setIsTimelineCaptureEnabled(isEnabled);
+    }
+
+    if (isEnabled && mTimelineFrameTicks.size() == 0) {
+        mTimelineFirstFrame = mFrameCounter + 1;
     }
 }
 
-// Reset the timing data of the profiler (but not the profiler tree structure)
-void Profiler::reset() {
-    mRootNode.reset();
-    mRootNode.enterBlockOfCode();
-    mFrameCounter = 0;
-    mProfilingStartTime = Timer::getCurrentSystemTime() * 1000.0L;
+// Remove all the events of the timeline
+void Profiler::clearTimeline() {
+
+    flushAllEvents();
+
+    std::lock_guard<std::mutex> lock(mMutex);
+
+    for (uint i=0; i<mThreadBuffers.size(); i++) {
+        mThreadBuffers[i]->clearTimeline();
+    }
+
+    mTimelineFrameTicks.clear();
+    mTimelineFirstFrame = mFrameCounter + 1;
 }
 
 // Print the report of the profiler in a given output stream
+/// The tree of the thread that has created the profiler is printed first and is followed
+/// by the trees of the other threads (the worker threads of the task scheduler).
 void Profiler::printReport() {
 
+    flushAllEvents();
+
     // For each destination
     for (auto it = mDestinations.begin(); it != mDestinations.end(); ++it) {
 
-        ProfileNodeIterator* iterator = Profiler::getIterator();
+        switch ((*it)->format) {
+            case Format::Text: printTextReport((*it)->getOutputStream()); break;
+            case Format::ChromeTrace: printChromeTraceReport((*it)->getOutputStream()); break;
+        }
+    }
+}
+
+// Print the text report of the profiler trees into a stream
+void Profiler::printTextReport(std::ostream& outputStream) {
+
+    // For each thread that has used the profiler
+    for (uint i=0; i<mThreadBuffers.size(); i++) {
+
+        if (i > 0) {
+            outputStream << "=============== Thread " << i << " ===============" << std::endl;
+        }
+
+#ifdef IS_PROFILING_HARDWARE_COUNTERS_ACTIVE
+        if (!mThreadBuffers[i]->getHardwareCounters().isAvailable()) {
+            outputStream << "(hardware counters unavailable)" << std::endl;
+        }
+#endif
+
+        ProfileNodeIterator* iterator = Profiler::getIterator(i);
 
         // Recursively print the report of each node of the profiler tree
-        printRecursiveNodeReport(iterator, 0, (*it)->getOutputStream());
+        printRecursiveNodeReport(iterator, 0, outputStream);
 
         // Destroy the iterator
         destroyIterator(iterator);
     }
 }
 
+// Print the timeline of the events into a stream in the Chrome trace event format
+/// Each profiled block of code is a pair of begin ("B") and end ("E") events on the track
+/// of its thread and the beginning of each frame is a global instant ("i") event. The
+/// timestamps are in microseconds since the start of the profiling.
+void Profiler::printChromeTraceReport(std::ostream& outputStream) {
+
+    // Write a timestamp in microseconds with a nanosecond precision
+    auto writeTimestamp = [this, &outputStream](uint64 ticks) {
+        const uint64 time = ticks > mProfilingStartTime ? ticks - mProfilingStartTime : 0;
+        outputStream << (time / 1000) << "." << static_cast<char>('0' + (time / 100) % 10) <<
+                        static_cast<char>('0' + (time / 10) % 10) << static_cast<char>('0' + time % 10);
+    };
+
+    outputStream << "{\"traceEvents\":[" << std::endl;
+    bool isFirstEvent = true;
+
+    // Frames
+    for (uint f=0; f<mTimelineFrameTicks.size(); f++) {
+        outputStream << (isFirstEvent ? "" : ",\n") << "{\"name\":\"Frame " << (mTimelineFirstFrame + f) <<
+                        "\",\"ph\":\"i\",\"s\":\"g\",\"pid\":0,\"tid\":0,\"ts\":";
+        writeTimestamp(mTimelineFrameTicks[f]);
+        outputStream << "}";
+        isFirstEvent = false;
+    }
+
+    // For each thread that has used the profiler
+    for (uint i=0; i<mThreadBuffers.size(); i++) {
+
+        outputStream << (isFirstEvent ? "" : ",\n") << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":" << i <<
+                        ",\"args\":{\"name\":\"" <<
+                        (i == 0 ? std::string("Main thread") : "Thread " + std::to_string(i)) << "\"}}";
+        isFirstEvent = false;
+
+        const List<ProfileEvent>& timeline = mThreadBuffers[i]->getTimeline();
+        for (uint e=0; e<timeline.size(); e++) {
+
+            const ProfileEvent& event = timeline[e];
+
+            outputStream << ",\n{";
+            if (event.name != nullptr) {
+
+                // The names of the blocks of code are escaped as JSON strings
+                outputStream << "\"name\":\"";
+                for (const char* c = event.name; *c != '\0'; c++) {
+                    if (*c == '"' || *c == '\\') outputStream << '\\';
+                    outputStream << *c;
+                }
+                outputStream << "\",\"ph\":\"B\",";
+            }
+            else {
+                outputStream << "\"ph\":\"E\",";
+            }
+            outputStream << "\"pid\":0,\"tid\":" << i << ",\"ts\":";
+            writeTimestamp(event.ticks);
+            outputStream << "}";
+        }
+    }
+
+    outputStream << std::endl << "]}" << std::endl;
+}
+
 // Add a file destination to the profiler
 void Profiler::addFileDestination(const std::string& filePath, Format format) {
 
@@ -278,6 +520,25 @@ void Profiler::printRecursiveNodeReport(ProfileNodeIterator* iterator,
                         fraction << " % | " << (currentTotalTime / (long double) (nbFrames)) <<
                         " ms/frame (" << iterator->getCurrentNbTotalCalls() << " calls)" <<
                         std::endl;
+
+#ifdef IS_PROFILING_HARDWARE_COUNTERS_ACTIVE
+
+        // Print the instructions per cycle and the counters per call of the block of code
+        const uint64 nbCycles = iterator->getCurrentTotalCounter(HardwareCounter::Cycles);
+        const uint nbCalls = iterator->getCurrentNbTotalCalls();
+        if (nbCycles > 0 && nbCalls > 0) {
+            const uint64 nbInstructions = iterator->getCurrentTotalCounter(HardwareCounter::Instructions);
+            for (int j=0; j<spacing; j++) outputStream << " ";
+            outputStream << "|        IPC " << (static_cast<long double>(nbInstructions) / nbCycles);
+            for (int c=1; c < NB_HARDWARE_COUNTERS; c++) {
+                const HardwareCounter counter = static_cast<HardwareCounter>(c);
+                outputStream << " | " << (static_cast<long double>(iterator->getCurrentTotalCounter(counter)) / nbCalls) <<
+                                " " << HardwareCounters::getCounterName(counter) << "/call";
+            }
+            outputStream << std::endl;
+        }
+
+#endif
         totalTime += currentTotalTime;
     }
 
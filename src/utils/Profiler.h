@@ -32,12 +32,36 @@
 // Libraries
 #include "configuration.h"
 #include "engine/Timer.h"
+#include "utils/HardwareCounters.h"
 #include <fstream>
+#include <mutex>
+#include <thread>
+#include <atomic>
 #include "containers/List.h"
 
 /// ReactPhysics3D namespace
 namespace reactphysics3d {
 
+// Structure ProfileEvent
+/**
+ * An event recorded by a thread when it enters or exits a profiled block of code.
+ */
+struct ProfileEvent {
+
+    /// Name of the block of code (null for the exit of a block)
+    const char* name;
+
+    /// Value of the monotonic clock when the event has been recorded (in nanoseconds)
+    uint64 ticks;
+
+#ifdef IS_PROFILING_HARDWARE_COUNTERS_ACTIVE
+
+    /// Values of the hardware counters of the thread when the event has been recorded
+    uint64 counters[NB_HARDWARE_COUNTERS];
+
+#endif
+};
+
 // Class ProfileNode
 /**
  * It represents a profile sample in the profiler tree.
@@ -54,12 +78,22 @@ class ProfileNode {
         /// Total number of calls of this node
         uint mNbTotalCalls;
 
-        /// Starting time of the sampling of corresponding block of code
-        long double mStartingTime;
+        /// Starting time of the sampling of corresponding block of code (in ticks)
+        uint64 mStartingTime;
 
         /// Total time spent in the block of code
         long double mTotalTime;
 
+#ifdef IS_PROFILING_HARDWARE_COUNTERS_ACTIVE
+
+        /// Values of the hardware counters when the sampling of the block of code has started
+        uint64 mStartingCounters[NB_HARDWARE_COUNTERS];
+
+        /// Total increase of the hardware counters in the block of code
+        uint64 mTotalCounters[NB_HARDWARE_COUNTERS];
+
+#endif
+
         /// Recursion counter
         int mRecursionCounter;
 
@@ -103,11 +137,18 @@ class ProfileNode {
         /// Return the total time spent in the block of code
         long double getTotalTime() const;
 
+#ifdef IS_PROFILING_HARDWARE_COUNTERS_ACTIVE
+
+        /// Return the total increase of a hardware counter in the block of code
+        uint64 getTotalCounter(HardwareCounter counter) const;
+
+#endif
+
         /// Called when we enter the block of code corresponding to this profile node
-        void enterBlockOfCode();
+        void enterBlockOfCode(const ProfileEvent& event);
 
         /// Called when we exit the block of code corresponding to this profile node
-        bool exitBlockOfCode();
+        bool exitBlockOfCode(const ProfileEvent& event);
 
         /// Reset the profiling of the node
         void reset();
@@ -166,6 +207,13 @@ class ProfileNodeIterator {
         /// Return the total number of calls of the current node
         uint getCurrentNbTotalCalls();
 
+#ifdef IS_PROFILING_HARDWARE_COUNTERS_ACTIVE
+
+        /// Return the total increase of a hardware counter in the current node
+        uint64 getCurrentTotalCounter(HardwareCounter counter);
+
+#endif
+
         /// Return the name of the current parent node
         const char* getCurrentParentName();
 
@@ -176,17 +224,118 @@ class ProfileNodeIterator {
         uint getCurrentParentNbTotalCalls();
 };
 
+// Class ProfileThreadBuffer
+/**
+ * This class contains the profiling data of a single thread. The events of the thread
+ * are recorded into a preallocated buffer without any lookup in the profiler tree and
+ * without any allocation. They are replayed into the profiler tree of the thread when
+ * the buffer is full or when the profiler needs the report.
+ */
+class ProfileThreadBuffer {
+
+    private :
+
+        // -------------------- Attributes -------------------- //
+
+        /// Identifier of the thread that records the events
+        std::thread::id mThreadId;
+
+        /// Preallocated array of events
+        ProfileEvent* mEvents;
+
+        /// Number of events in the buffer
+        uint mNbEvents;
+
+        /// Maximum number of events in the buffer
+        uint mCapacity;
+
+        /// Root node of the profiler tree of the thread
+        ProfileNode mRootNode;
+
+        /// Current node of the profiler tree when the events are replayed
+        ProfileNode* mCurrentNode;
+
+#ifdef IS_PROFILING_HARDWARE_COUNTERS_ACTIVE
+
+        /// Hardware counters of the thread
+        HardwareCounters mHardwareCounters;
+
+#endif
+
+        /// True if the replayed events are also kept in the timeline
+        bool mIsTimelineCaptureEnabled;
+
+        /// Timeline of all the events of the thread since the capture has been enabled
+        List<ProfileEvent> mTimeline;
+
+    public :
+
+        // -------------------- Methods -------------------- //
+
+        /// Constructor
+        ProfileThreadBuffer(std::thread::id threadId, uint capacity);
+
+        /// Destructor
+        ~ProfileThreadBuffer();
+
+        /// Deleted copy-constructor
+        ProfileThreadBuffer(const ProfileThreadBuffer& buffer) = delete;
+
+        /// Deleted assignment operator
+        ProfileThreadBuffer& operator=(const ProfileThreadBuffer& buffer) = delete;
+
+        /// Return the identifier of the thread
+        std::thread::id getThreadId() const;
+
+        /// Return the root node of the profiler tree of the thread
+        ProfileNode* getRootNode();
+
+#ifdef IS_PROFILING_HARDWARE_COUNTERS_ACTIVE
+
+        /// Return the hardware counters of the thread
+        const HardwareCounters& getHardwareCounters() const;
+
+#endif
+
+        /// Record the entry into a block of code
+        void recordStart(const char* name);
+
+        /// Record the exit of the current block of code
+        void recordStop();
+
+        /// Replay the recorded events into the profiler tree and empty the buffer
+        void flushEvents();
+
+        /// Enable or disable the capture of the timeline of the events
+        void setIsTimelineCaptureEnabled(bool isEnabled);
+
+        /// Return the timeline of the events of the thread
+        const List<ProfileEvent>& getTimeline() const;
+
+        /// Remove all the events of the timeline
+        void clearTimeline();
+};
+
 // Class Profiler
 /**
  * This is the main class of the profiler. This profiler is based on "Real-Time Hierarchical
  * Profiling" article from "Game Programming Gems 3" by Greg Hjelstrom and Byon Garrabrant.
+ * Each thread that profiles some code records its events into its own buffer and has its
+ * own profiler tree. Therefore, the profiler can be used by the worker threads of the task
+ * scheduler without any lock. The events of the buffers are merged into the trees at the
+ * beginning of each frame and before the report is printed. This must happen while the
+ * other threads are not profiling (between two parallel tasks).
  */
 class Profiler {
 
     public:
 
-        /// Format of the profiling data (text, ...)
-        enum class Format {Text};
+        /// Format of the profiling data. The text format is a report of the accumulated
+        /// times of the profiler trees. The Chrome trace format is the timeline of all the
+        /// events captured since the timeline capture has been enabled (see
+        /// setIsTimelineCaptureEnabled()) in the JSON trace event format of the Chrome
+        /// tracing tools (chrome://tracing, Perfetto, Tracy import-chrome).
+        enum class Format {Text, ChromeTrace};
 
         /// Profile destination
         class Destination {
@@ -279,21 +428,48 @@ class Profiler {
 
         // -------------------- Attributes -------------------- //
 
-        /// Root node of the profiler tree
-        ProfileNode mRootNode;
+        /// Unique identifier of the profiler (used by the thread-local cache of the buffers)
+        uint64 mId;
 
-        /// Current node in the current execution
-        ProfileNode* mCurrentNode;
+        /// Maximum number of events in the buffer of each thread
+        uint mEventBufferCapacity;
+
+        /// Buffers of the threads (the first one is the buffer of the thread that created the profiler)
+        List<ProfileThreadBuffer*> mThreadBuffers;
+
+        /// Mutex used when a new thread registers its buffer
+        std::mutex mMutex;
 
         /// Frame counter
         uint mFrameCounter;
 
-        /// Starting profiling time
-        long double mProfilingStartTime;
+        /// Starting profiling time (in ticks)
+        uint64 mProfilingStartTime;
+
+        /// True if the events are kept in the timeline of each thread
+        bool mIsTimelineCaptureEnabled;
+
+        /// Time of the beginning of each frame of the timeline (in ticks)
+        List<uint64> mTimelineFrameTicks;
+
+        /// Number of the first frame of the timeline
+        uint mTimelineFirstFrame;
+
+        /// Identifier of the profiler of the buffer in the cache of the current thread
+        static thread_local uint64 mCachedProfilerId;
+
+        /// Buffer of the current thread for the profiler in the cache
+        static thread_local ProfileThreadBuffer* mCachedThreadBuffer;
 
         /// All the output destinations
         List<Destination*> mDestinations;
 
+        /// Print the text report of the profiler trees into a stream
+        void printTextReport(std::ostream& outputStream);
+
+        /// Print the timeline of the events into a stream in the Chrome trace event format
+        void printChromeTraceReport(std::ostream& outputStream);
+
         /// Recursively print the report of a given node of the profiler tree
         void printRecursiveNodeReport(ProfileNodeIterator* iterator,  int spacing,
                                       std::ostream &outputStream);
@@ -301,15 +477,34 @@ class Profiler {
 		/// Destroy a previously allocated iterator
 		void destroyIterator(ProfileNodeIterator* iterator);
 
+        /// Return the buffer of the current thread
+        ProfileThreadBuffer* getThreadBuffer();
+
+        /// Find or create the buffer of the current thread
+        ProfileThreadBuffer* findThreadBuffer();
+
+        /// Replay the recorded events of all the threads into their profiler trees
+        void flushAllEvents();
+
+        /// Return a new unique identifier for a profiler
+        static uint64 computeNextProfilerId();
+
 		/// Destroy the profiler (release the memory)
 		void destroy();
 
     public :
 
+        // -------------------- Methods -------------------- //
+
+        // -------------------- Constants -------------------- //
+
+        /// Default maximum number of events in the buffer of each thread
+        static const uint DEFAULT_EVENT_BUFFER_CAPACITY = 8192;
+
         // -------------------- Methods -------------------- //
 
 		/// Constructor
-        Profiler();
+        Profiler(uint eventBufferCapacity = DEFAULT_EVENT_BUFFER_CAPACITY);
 
 		/// Destructor
 		~Profiler();
@@ -333,8 +528,11 @@ class Profiler {
         /// Increment the frame counter
         void incrementFrameCounter();
 
-        /// Return an iterator over the profiler tree starting at the root
-        ProfileNodeIterator* getIterator();
+        /// Return the number of threads that have used the profiler
+        uint getNbThreads();
+
+        /// Return an iterator over the profiler tree of a thread starting at the root
+        ProfileNodeIterator* getIterator(uint threadIndex = 0);
 
         // Add a file destination to the profiler
         void addFileDestination(const std::string& filePath, Format format);
@@ -347,6 +545,15 @@ class Profiler {
 
         /// Print the report of the profiler in every output destinations
         void printReport();
+
+        /// Enable or disable the capture of the timeline of the events of every frame
+        void setIsTimelineCaptureEnabled(bool isEnabled);
+
+        /// Return true if the timeline of the events is captured
+        bool getIsTimelineCaptureEnabled() const;
+
+        /// Remove all the events of the timeline
+        void clearTimeline();
 };
 
 // Class ProfileSample
@@ -411,6 +618,25 @@ inline uint ProfileNodeIterator::getCurrentNbTotalCalls() {
     return mCurrentChildNode->getNbTotalCalls();
 }
 
+#ifdef IS_PROFILING_HARDWARE_COUNTERS_ACTIVE
+
+// Return the total increase of a hardware counter in the current node
+inline uint64 ProfileNodeIterator::getCurrentTotalCounter(HardwareCounter counter) {
+    return mCurrentChildNode->getTotalCounter(counter);
+}
+
+// Return the total increase of a hardware counter in the block of code
+inline uint64 ProfileNode::getTotalCounter(HardwareCounter counter) const {
+    return mTotalCounters[static_cast<int>(counter)];
+}
+
+// Return the hardware counters of the thread
+inline const HardwareCounters& ProfileThreadBuffer::getHardwareCounters() const {
+    return mHardwareCounters;
+}
+
+#endif
+
 // Return the name of the current parent node
 inline const char* ProfileNodeIterator::getCurrentParentName() {
     return mCurrentParentNode->getName();
@@ -473,18 +699,125 @@ inline uint Profiler::getNbFrames() {
 
 // Return the elasped time since the start/reset of the profiling
 inline long double Profiler::getElapsedTimeSinceStart() {
-    long double currentTime = Timer::getCurrentSystemTime() * 1000.0L;
-    return currentTime - mProfilingStartTime;
+    return static_cast<long double>(Timer::getCurrentTicks() - mProfilingStartTime) * 1.0e-6L;
 }
 
 // Increment the frame counter
+/// The events recorded by the threads during the previous frame are merged into the
+/// profiler trees so that the buffers do not have to be flushed during the frame.
 inline void Profiler::incrementFrameCounter() {
+    flushAllEvents();
     mFrameCounter++;
+
+    if (mIsTimelineCaptureEnabled) {
+        mTimelineFrameTicks.add(Timer::getCurrentTicks());
+    }
 }
 
-// Return an iterator over the profiler tree starting at the root
-inline ProfileNodeIterator* Profiler::getIterator() {
-    return new ProfileNodeIterator(&mRootNode);
+// Return true if the timeline of the events is captured
+inline bool Profiler::getIsTimelineCaptureEnabled() const {
+    return mIsTimelineCaptureEnabled;
+}
+
+// Return the number of threads that have used the profiler
+inline uint Profiler::getNbThreads() {
+    std::lock_guard<std::mutex> lock(mMutex);
+    return static_cast<uint>(mThreadBuffers.size());
+}
+
+// Return an iterator over the profiler tree of a thread starting at the root
+inline ProfileNodeIterator* Profiler::getIterator(uint threadIndex) {
+    flushAllEvents();
+    assert(threadIndex < mThreadBuffers.size());
+    return new ProfileNodeIterator(mThreadBuffers[threadIndex]->getRootNode());
+}
+
+// Return the buffer of the current thread
+inline ProfileThreadBuffer* Profiler::getThreadBuffer() {
+
+    // If the buffer of the thread for this profiler is in the thread-local cache
+    if (mCachedProfilerId == mId) {
+        return mCachedThreadBuffer;
+    }
+
+    return findThreadBuffer();
+}
+
+// Method called when we want to start profiling a block of code.
+inline void Profiler::startProfilingBlock(const char* name) {
+    getThreadBuffer()->recordStart(name);
+}
+
+// Method called at the end of the scope where the
+// startProfilingBlock() method has been called.
+inline void Profiler::stopProfilingBlock() {
+    getThreadBuffer()->recordStop();
+}
+
+// Return the identifier of the thread
+inline std::thread::id ProfileThreadBuffer::getThreadId() const {
+    return mThreadId;
+}
+
+// Return the root node of the profiler tree of the thread
+inline ProfileNode* ProfileThreadBuffer::getRootNode() {
+    return &mRootNode;
+}
+
+// Enable or disable the capture of the timeline of the events
+inline void ProfileThreadBuffer::setIsTimelineCaptureEnabled(bool isEnabled) {
+    mIsTimelineCaptureEnabled = isEnabled;
+}
+
+// Return the timeline of the events of the thread
+inline const List<ProfileEvent>& ProfileThreadBuffer::getTimeline() const {
+    return mTimeline;
+}
+
+// Remove all the events of the timeline
+inline void ProfileThreadBuffer::clearTimeline() {
+    mTimeline.clear();
+}
+
+// Record the entry into a block of code
+inline void ProfileThreadBuffer::recordStart(const char* name) {
+
+    // If the buffer is full, replay its events first (before reading the clock so
+    // that the time to flush the buffer is not added to the block of code)
+    if (mNbEvents == mCapacity) {
+        flushEvents();
+    }
+
+    mEvents[mNbEvents].name = name;
+#ifdef IS_PROFILING_HARDWARE_COUNTERS_ACTIVE
+    mHardwareCounters.read(mEvents[mNbEvents].counters);
+#endif
+    mEvents[mNbEvents].ticks = Timer::getCurrentTicks();
+    mNbEvents++;
+}
+
+// Record the exit of the current block of code
+inline void ProfileThreadBuffer::recordStop() {
+
+    const uint64 ticks = Timer::getCurrentTicks();
+#ifdef IS_PROFILING_HARDWARE_COUNTERS_ACTIVE
+    uint64 counters[NB_HARDWARE_COUNTERS];
+    mHardwareCounters.read(counters);
+#endif
+
+    // If the buffer is full, replay its events first
+    if (mNbEvents == mCapacity) {
+        flushEvents();
+    }
+
+    mEvents[mNbEvents].name = nullptr;
+    mEvents[mNbEvents].ticks = ticks;
+#ifdef IS_PROFILING_HARDWARE_COUNTERS_ACTIVE
+    for (int i=0; i < NB_HARDWARE_COUNTERS; i++) {
+        mEvents[mNbEvents].counters[i] = counters[i];
+    }
+#endif
+    mNbEvents++;
 }
 
 // Destroy a previously allocated iterator
@@ -494,7 +827,11 @@ inline void Profiler::destroyIterator(ProfileNodeIterator* iterator) {
 
 // Destroy the profiler (release the memory)
 inline void Profiler::destroy() {
-    mRootNode.destroy();
+
+    for (uint i=0; i<mThreadBuffers.size(); i++) {
+        delete mThreadBuffers[i];
+    }
+    mThreadBuffers.clear();
 }
 
 }
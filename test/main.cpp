@@ -29,6 +29,7 @@
 #include "tests/mathematics/TestVector3.h"
 #include "tests/mathematics/TestTransform.h"
 #include "tests/mathematics/TestQuaternion.h"
+#include "tests/mathematics/TestLanes.h"
 #include "tests/mathematics/TestMatrix2x2.h"
 #include "tests/mathematics/TestMatrix3x3.h"
 #include "tests/mathematics/TestMathematicsFunctions.h"
@@ -37,11 +38,41 @@
 #include "tests/collision/TestCollisionWorld.h"
 #include "tests/collision/TestAABB.h"
 #include "tests/collision/TestDynamicAABBTree.h"
+#include "tests/collision/TestQuantizedBVH.h"
+#include "tests/collision/TestNarrowPhaseBatch.h"
+#include "tests/collision/TestBoxVsBoxAlgorithm.h"
+#include "tests/collision/TestConvexVsHeightFieldAlgorithm.h"
+#include "tests/collision/TestCylinderAndConeShapes.h"
+#include "tests/collision/TestCompoundShape.h"
+#include "tests/collision/TestConvexMeshShape.h"
+#include "tests/collision/TestConvexHull.h"
+#include "tests/collision/TestHeightFieldShape.h"
+#include "tests/collision/TestConcaveMeshShape.h"
+#include "tests/collision/TestContactManifoldInfo.h"
 #include "tests/collision/TestHalfEdgeStructure.h"
 #include "tests/collision/TestTriangleVertexArray.h"
 #include "tests/containers/TestList.h"
+#include "tests/containers/TestSmallList.h"
+#include "tests/containers/TestIdAllocator.h"
 #include "tests/containers/TestMap.h"
 #include "tests/containers/TestSet.h"
+#include "tests/containers/TestFlatMap.h"
+#include "tests/containers/TestFlatSet.h"
+#include "tests/engine/TestDynamicsWorld.h"
+#include "tests/engine/TestOverlappingPairCache.h"
+#include "tests/engine/TestOverlappingPair.h"
+#include "tests/engine/TestParticleSystem.h"
+#include "tests/engine/TestCharacterController.h"
+#include "tests/engine/TestVehicle.h"
+#include "tests/engine/TestTaskScheduler.h"
+#include "tests/engine/TestWorldGroup.h"
+#include "tests/engine/TestWorldRecorder.h"
+#include "tests/engine/TestFixedStepScheduler.h"
+#include "tests/memory/TestArenaAllocator.h"
+#include "tests/memory/TestPoolAllocator.h"
+#include "tests/memory/TestSingleFrameAllocator.h"
+#include "tests/memory/TestMemoryStatistics.h"
+#include "tests/memory/TestWorkerPoolAllocator.h"
 
 using namespace reactphysics3d;
 
@@ -52,8 +83,20 @@ int main() {
     // ---------- Containers tests ---------- //
 
     testSuite.addTest(new TestList("List"));
+    testSuite.addTest(new TestSmallList("SmallList"));
+    testSuite.addTest(new TestIdAllocator("IdAllocator"));
     testSuite.addTest(new TestMap("Map"));
     testSuite.addTest(new TestSet("Set"));
+    testSuite.addTest(new TestFlatMap("FlatMap"));
+    testSuite.addTest(new TestFlatSet("FlatSet"));
+
+    // ---------- Memory tests ---------- //
+
+    testSuite.addTest(new TestArenaAllocator("ArenaAllocator"));
+    testSuite.addTest(new TestPoolAllocator("PoolAllocator"));
+    testSuite.addTest(new TestSingleFrameAllocator("SingleFrameAllocator"));
+    testSuite.addTest(new TestMemoryStatistics("MemoryStatistics"));
+    testSuite.addTest(new TestWorkerPoolAllocator("WorkerPoolAllocator"));
 
     // ---------- Mathematics tests ---------- //
 
@@ -61,6 +104,7 @@ int main() {
     testSuite.addTest(new TestVector3("Vector3"));
     testSuite.addTest(new TestTransform("Transform"));
     testSuite.addTest(new TestQuaternion("Quaternion"));
+    testSuite.addTest(new TestLanes("Lanes"));
     testSuite.addTest(new TestMatrix3x3("Matrix3x3"));
     testSuite.addTest(new TestMatrix2x2("Matrix2x2"));
     testSuite.addTest(new TestMathematicsFunctions("Maths Functions"));
@@ -73,8 +117,32 @@ int main() {
     testSuite.addTest(new TestRaycast("Raycasting"));
     testSuite.addTest(new TestCollisionWorld("CollisionWorld"));
     testSuite.addTest(new TestDynamicAABBTree("DynamicAABBTree"));
+    testSuite.addTest(new TestQuantizedBVH("QuantizedBVH"));
+    testSuite.addTest(new TestNarrowPhaseBatch("NarrowPhaseBatch"));
+    testSuite.addTest(new TestBoxVsBoxAlgorithm("BoxVsBoxAlgorithm"));
+    testSuite.addTest(new TestConvexVsHeightFieldAlgorithm("ConvexVsHeightFieldAlgorithm"));
+    testSuite.addTest(new TestCylinderAndConeShapes("CylinderAndConeShapes"));
+    testSuite.addTest(new TestCompoundShape("CompoundShape"));
+    testSuite.addTest(new TestConvexMeshShape("ConvexMeshShape"));
+    testSuite.addTest(new TestConvexHull("ConvexHull"));
+    testSuite.addTest(new TestHeightFieldShape("HeightFieldShape"));
+    testSuite.addTest(new TestConcaveMeshShape("ConcaveMeshShape"));
+    testSuite.addTest(new TestContactManifoldInfo("ContactManifoldInfo"));
     testSuite.addTest(new TestHalfEdgeStructure("HalfEdgeStructure"));
 
+    // ---------- Engine tests ---------- //
+
+    testSuite.addTest(new TestTaskScheduler("TaskScheduler"));
+    testSuite.addTest(new TestOverlappingPairCache("OverlappingPairCache"));
+    testSuite.addTest(new TestOverlappingPair("OverlappingPair"));
+    testSuite.addTest(new TestDynamicsWorld("DynamicsWorld"));
+    testSuite.addTest(new TestParticleSystem("ParticleSystem"));
+    testSuite.addTest(new TestCharacterController("CharacterController"));
+    testSuite.addTest(new TestVehicle("Vehicle"));
+    testSuite.addTest(new TestWorldGroup("WorldGroup"));
+    testSuite.addTest(new TestWorldRecorder("WorldRecorder"));
+    testSuite.addTest(new TestFixedStepScheduler("FixedStepScheduler"));
+
     // Run the tests
     testSuite.run();
 
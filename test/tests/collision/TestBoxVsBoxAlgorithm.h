@@ -0,0 +1,253 @@
+/********************************************************************************
+* ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
+* Copyright (c) 2010-2016 Daniel Chappuis                                       *
+*********************************************************************************
+*                                                                               *
+* This software is provided 'as-is', without any express or implied warranty.   *
+* In no event will the authors be held liable for any damages arising from the  *
+* use of this software.                                                         *
+*                                                                               *
+* Permission is granted to anyone to use this software for any purpose,         *
+* including commercial applications, and to alter it and redistribute it        *
+* freely, subject to the following restrictions:                                *
+*                                                                               *
+* 1. The origin of this software must not be misrepresented; you must not claim *
+*    that you wrote the original software. If you use this software in a        *
+*    product, an acknowledgment in the product documentation would be           *
+*    appreciated but is not required.                                           *
+*                                                                               *
+* 2. Altered source versions must be plainly marked as such, and must not be    *
+*    misrepresented as being the original software.                             *
+*                                                                               *
+* 3. This notice may not be removed or altered from any source distribution.    *
+*                                                                               *
+********************************************************************************/
+
+#ifndef TEST_BOX_VS_BOX_ALGORITHM_H
+#define TEST_BOX_VS_BOX_ALGORITHM_H
+
+// Libraries
+#include "Test.h"
+#include "engine/CollisionWorld.h"
+#include "engine/DynamicsWorld.h"
+#include "engine/OverlappingPair.h"
+#include "collision/NarrowPhaseInfo.h"
+#include "collision/ContactPointInfo.h"
+#include "collision/shapes/BoxShape.h"
+#include "collision/narrowphase/BoxVsBoxAlgorithm.h"
+#include "collision/narrowphase/SAT/SATAlgorithm.h"
+#include "memory/MemoryManager.h"
+
+/// Reactphysics3D namespace
+namespace reactphysics3d {
+
+// Class TestBoxVsBoxAlgorithm
+/**
+ * Unit test for the box vs box narrow-phase algorithm. The algorithm must find the
+ * same collisions and contacts as the generic SAT algorithm for convex polyhedra.
+ */
+class TestBoxVsBoxAlgorithm : public Test {
+
+    private :
+
+        // ---------- Atributes ---------- //
+
+        CollisionWorld* mWorld;
+        BoxShape* mBoxShape1;
+        BoxShape* mBoxShape2;
+
+        // ---------- Methods ---------- //
+
+        /// Return the contact point with the largest penetration depth
+        static const ContactPointInfo* getDeepestContactPoint(const NarrowPhaseInfo* info) {
+
+            const ContactPointInfo* deepestPoint = info->contactPoints;
+            for (const ContactPointInfo* point = info->contactPoints; point != nullptr; point = point->next) {
+                if (point->penetrationDepth > deepestPoint->penetrationDepth) deepestPoint = point;
+            }
+            return deepestPoint;
+        }
+
+        /// Return true if each contact point is separated by its penetration depth along its normal
+        bool areContactPointsConsistent(const NarrowPhaseInfo* info) const {
+
+            bool isConsistent = info->contactPoints != nullptr;
+            for (const ContactPointInfo* point = info->contactPoints; point != nullptr; point = point->next) {
+                const Vector3 worldPoint1 = info->shape1ToWorldTransform * point->localPoint1;
+                const Vector3 worldPoint2 = info->shape2ToWorldTransform * point->localPoint2;
+                isConsistent &= point->penetrationDepth > decimal(0.0);
+                isConsistent &= approxEqual(worldPoint1 - worldPoint2, point->normal * point->penetrationDepth,
+                                            decimal(0.0001));
+            }
+            return isConsistent;
+        }
+
+        /// Test a pair of boxes with the box vs box algorithm and with the SAT algorithm
+        /// (the SAT algorithm computes the normal of an edge contact from the centroid
+        /// of the first shape and it is therefore not exactly along the separating axis)
+        void testBoxes(const Transform& transform1, const Transform& transform2, bool isCollisionExpected,
+                       bool isEdgeContact = false) {
+
+            MemoryAllocator& allocator = MemoryManager::getBaseAllocator();
+            WorldSettings settings;
+
+            CollisionBody* body1 = mWorld->createCollisionBody(transform1);
+            CollisionBody* body2 = mWorld->createCollisionBody(transform2);
+            ProxyShape* shape1 = body1->addCollisionShape(mBoxShape1, Transform::identity());
+            ProxyShape* shape2 = body2->addCollisionShape(mBoxShape2, Transform::identity());
+
+            OverlappingPair boxPair(shape1, shape2, allocator, allocator, settings);
+            OverlappingPair satPair(shape1, shape2, allocator, allocator, settings);
+            NarrowPhaseInfo boxInfo(&boxPair, mBoxShape1, mBoxShape2, transform1, transform2, allocator);
+            NarrowPhaseInfo satInfo(&satPair, mBoxShape1, mBoxShape2, transform1, transform2, allocator);
+
+            BoxVsBoxAlgorithm boxAlgorithm;
+            SATAlgorithm satAlgorithm(allocator);
+            const bool isBoxColliding = boxAlgorithm.testCollision(&boxInfo, true, allocator);
+            const bool isSATColliding = satAlgorithm.testCollisionConvexPolyhedronVsConvexPolyhedron(&satInfo, true);
+
+            rp3d_test(isBoxColliding == isCollisionExpected);
+            rp3d_test(isSATColliding == isCollisionExpected);
+
+            if (isBoxColliding && isSATColliding) {
+
+                rp3d_test(areContactPointsConsistent(&boxInfo));
+                rp3d_test(isEdgeContact || areContactPointsConsistent(&satInfo));
+
+                // The deepest contact points have the same penetration depth and normal
+                const ContactPointInfo* boxPoint = getDeepestContactPoint(&boxInfo);
+                const ContactPointInfo* satPoint = getDeepestContactPoint(&satInfo);
+                rp3d_test(approxEqual(boxPoint->penetrationDepth, satPoint->penetrationDepth, decimal(0.0001)));
+                rp3d_test(approxEqual(boxPoint->normal, satPoint->normal, decimal(0.0001)) ||
+                          (isEdgeContact && boxPoint->normal.dot(satPoint->normal) > decimal(0.9)));
+
+                // Testing the pair again uses the minimum separating axis of the previous frame
+                LastFrameCollisionInfo* lastFrameInfo = boxInfo.getLastFrameCollisionInfo();
+                lastFrameInfo->isValid = true;
+                lastFrameInfo->wasColliding = true;
+                lastFrameInfo->wasUsingSAT = true;
+                boxInfo.resetContactPoints();
+                rp3d_test(boxAlgorithm.testCollision(&boxInfo, true, allocator));
+                rp3d_test(areContactPointsConsistent(&boxInfo));
+                rp3d_test(approxEqual(getDeepestContactPoint(&boxInfo)->penetrationDepth, boxPoint->penetrationDepth,
+                                      decimal(0.0001)));
+            }
+
+            boxInfo.resetContactPoints();
+            satInfo.resetContactPoints();
+            mWorld->destroyCollisionBody(body1);
+            mWorld->destroyCollisionBody(body2);
+        }
+
+    public :
+
+        // ---------- Methods ---------- //
+
+        /// Constructor
+        TestBoxVsBoxAlgorithm(const std::string& name) : Test(name) {
+
+            mWorld = new CollisionWorld();
+            mBoxShape1 = new BoxShape(Vector3(decimal(0.5), decimal(0.5), decimal(0.5)));
+            mBoxShape2 = new BoxShape(Vector3(decimal(1.0), decimal(0.25), decimal(0.6)));
+        }
+
+        /// Destructor
+        virtual ~TestBoxVsBoxAlgorithm() {
+            delete mWorld;
+            delete mBoxShape1;
+            delete mBoxShape2;
+        }
+
+        /// Run the tests
+        void run() {
+
+            testFaceContacts();
+            testEdgeContacts();
+            testSeparatedBoxes();
+            testStatistics();
+        }
+
+        /// Test boxes in contact on a face of one of them
+        void testFaceContacts() {
+
+            // Box resting on the other one
+            testBoxes(Transform(Vector3(0, 0, 0), Quaternion::identity()),
+                      Transform(Vector3(decimal(0.2), decimal(0.73), decimal(-0.1)), Quaternion::identity()), true);
+
+            // Box rotated around the normal of the face
+            testBoxes(Transform(Vector3(0, 0, 0), Quaternion::identity()),
+                      Transform(Vector3(decimal(0.1), decimal(0.72), 0), Quaternion::fromEulerAngles(0, decimal(0.7), 0)), true);
+
+            // Reference face on the second box
+            testBoxes(Transform(Vector3(decimal(0.3), decimal(0.74), decimal(0.2)), Quaternion::fromEulerAngles(0, decimal(0.4), 0)),
+                      Transform(Vector3(0, 0, 0), Quaternion::identity()), true);
+
+            // Tilted box with a corner in the face of the other one
+            const Quaternion tilt = Quaternion::fromEulerAngles(decimal(0.4), 0, decimal(0.3));
+            Vector3 lowestVertex = tilt * Vector3(decimal(-0.5), decimal(-0.5), decimal(-0.5));
+            for (int x=-1; x <= 1; x += 2) {
+                for (int y=-1; y <= 1; y += 2) {
+                    for (int z=-1; z <= 1; z += 2) {
+                        const Vector3 vertex = tilt * Vector3(decimal(0.5) * x, decimal(0.5) * y, decimal(0.5) * z);
+                        if (vertex.y < lowestVertex.y) lowestVertex = vertex;
+                    }
+                }
+            }
+            testBoxes(Transform(Vector3(0, decimal(0.25) - lowestVertex.y - decimal(0.05), 0), tilt),
+                      Transform(Vector3(0, 0, 0), Quaternion::identity()), true);
+        }
+
+        /// Test boxes in contact on crossing edges
+        void testEdgeContacts() {
+
+            const decimal pi = decimal(3.14159265358979323846);
+
+            // Edge of the first box along z and edge of the second box along x
+            const decimal edge1Height = decimal(0.5) * std::sqrt(decimal(2.0));
+            const decimal edge2Height = (decimal(0.25) + decimal(0.6)) * std::sqrt(decimal(0.5));
+            testBoxes(Transform(Vector3(0, 0, 0), Quaternion::fromEulerAngles(0, 0, pi / decimal(4.0))),
+                      Transform(Vector3(0, edge1Height + edge2Height - decimal(0.02), 0),
+                                Quaternion::fromEulerAngles(pi / decimal(4.0), 0, 0)), true, true);
+        }
+
+        /// Test boxes that are not colliding
+        void testSeparatedBoxes() {
+
+            const decimal pi = decimal(3.14159265358979323846);
+
+            // Boxes far from each other
+            testBoxes(Transform(Vector3(0, 0, 0), Quaternion::identity()),
+                      Transform(Vector3(5, 0, 0), Quaternion::fromEulerAngles(decimal(0.2), decimal(0.3), 0)), false);
+
+            // Boxes only separated by the cross product of two edges
+            const decimal edge1Height = decimal(0.5) * std::sqrt(decimal(2.0));
+            const decimal edge2Height = (decimal(0.25) + decimal(0.6)) * std::sqrt(decimal(0.5));
+            testBoxes(Transform(Vector3(0, 0, 0), Quaternion::fromEulerAngles(0, 0, pi / decimal(4.0))),
+                      Transform(Vector3(0, edge1Height + edge2Height + decimal(0.02), 0),
+                                Quaternion::fromEulerAngles(pi / decimal(4.0), 0, 0)), false);
+        }
+
+        /// Test that the pairs of boxes are counted in the narrow-phase statistics
+        void testStatistics() {
+
+            DynamicsWorld world(Vector3(0, decimal(-9.81), 0));
+
+            RigidBody* floor = world.createRigidBody(Transform(Vector3(0, 0, 0), Quaternion::identity()));
+            floor->setType(BodyType::STATIC);
+            floor->addCollisionShape(mBoxShape2, Transform::identity(), decimal(1.0));
+            RigidBody* box = world.createRigidBody(Transform(Vector3(0, decimal(0.74), 0), Quaternion::identity()));
+            box->addCollisionShape(mBoxShape1, Transform::identity(), decimal(1.0));
+
+            world.update(decimal(1.0) / decimal(60.0));
+
+            const NarrowPhaseStatistics& statistics = world.getStepStatistics().narrowPhase;
+            rp3d_test(statistics.nbConvexPolyhedronVsConvexPolyhedronTests == 1);
+            rp3d_test(statistics.nbBoxVsBoxTests == 1);
+            rp3d_test(statistics.nbSATTests == 1);
+            rp3d_test(world.getStepStatistics().nbContactPoints == 4);
+        }
+};
+
+}
+
+#endif
@@ -245,6 +245,20 @@ class WorldOverlapCallback : public OverlapCallback {
 		}
 };
 
+/// Sweep callback
+class WorldSweepCallback : public SweepCallback {
+
+	public:
+
+		std::vector<SweepInfo> sweepHits;
+
+		/// This method will be called for each proxy shape hit by the swept shape
+		virtual decimal notifySweepHit(const SweepInfo& sweepInfo) override {
+			sweepHits.push_back(sweepInfo);
+			return decimal(1.0);
+		}
+};
+
 // Class TestCollisionWorld
 /**
  * Unit test for the CollisionWorld class.
@@ -489,6 +503,8 @@ class TestCollisionWorld : public Test {
             testBoxVsBoxCollision();
             testBoxVsConvexMeshCollision();
             testBoxVsCapsuleCollision();
+            testSphereInsideBoxCollision();
+            testCapsuleLyingOnBoxCollision();
             testBoxVsConcaveMeshCollision();
 
             testCapsuleVsCapsuleCollision();
@@ -497,6 +513,16 @@ class TestCollisionWorld : public Test {
             testConvexMeshVsConvexMeshCollision();
             testConvexMeshVsCapsuleCollision();
             testConvexMeshVsConcaveMeshCollision();
+
+            testSweep();
+            testSweepWorld();
+            testOverlapHits();
+            testContactHits();
+            testUpdate();
+            testDistanceQueries();
+            testPointsInside();
+
+            testEPADeepPenetration();
         }
 
 		void testNoCollisions() {
@@ -2479,6 +2505,78 @@ class TestCollisionWorld : public Test {
             mCapsuleBody1->setTransform(initTransform2);
         }
 
+        /// Test a sphere whose center is inside a box (the sphere is pushed out of the closest face)
+        void testSphereInsideBoxCollision() {
+
+            Transform initTransform1 = mBoxBody1->getTransform();
+            Transform initTransform2 = mSphereBody1->getTransform();
+
+            Transform transform1(Vector3(10, 20, 50), Quaternion::identity());
+            Transform transform2(Vector3(10, 22, 50), Quaternion::identity());
+            mBoxBody1->setTransform(transform1);
+            mSphereBody1->setTransform(transform2);
+
+            mCollisionCallback.reset();
+            mWorld->testCollision(mBoxBody1, mSphereBody1, &mCollisionCallback);
+
+            rp3d_test(mCollisionCallback.areProxyShapesColliding(mBoxProxyShape1, mSphereProxyShape1));
+
+            const CollisionData* collisionData = mCollisionCallback.getCollisionData(mBoxProxyShape1, mSphereProxyShape1);
+            rp3d_test(collisionData != nullptr);
+            rp3d_test(collisionData->getTotalNbContactPoints() == 1);
+
+            bool swappedBodiesCollisionData = collisionData->getBody1()->getId() != mBoxBody1->getId();
+
+            Vector3 localBody1Point1(0, 3, 0);
+            Vector3 localBody2Point1(0, -3, 0);
+            decimal penetrationDepth1 = 4.0f;
+            rp3d_test(collisionData->hasContactPointSimilarTo(swappedBodiesCollisionData ? localBody2Point1 : localBody1Point1,
+                                                         swappedBodiesCollisionData ? localBody1Point1 : localBody2Point1,
+                                                         penetrationDepth1));
+
+            // reset the init transforms
+            mBoxBody1->setTransform(initTransform1);
+            mSphereBody1->setTransform(initTransform2);
+        }
+
+        /// Test a capsule lying on the face of a box (two contact points are created at the ends
+        /// of the capsule inner segment)
+        void testCapsuleLyingOnBoxCollision() {
+
+            Transform initTransform1 = mBoxBody1->getTransform();
+            Transform initTransform2 = mCapsuleBody1->getTransform();
+
+            Transform transform1(Vector3(10, 20, 50), Quaternion::identity());
+            Transform transform2(Vector3(10, decimal(24.5), 50), Quaternion::fromEulerAngles(0, 0, rp3d::PI * 0.5f));
+            mBoxBody1->setTransform(transform1);
+            mCapsuleBody1->setTransform(transform2);
+
+            mCollisionCallback.reset();
+            mWorld->testCollision(mBoxBody1, mCapsuleBody1, &mCollisionCallback);
+
+            rp3d_test(mCollisionCallback.areProxyShapesColliding(mBoxProxyShape1, mCapsuleProxyShape1));
+
+            const CollisionData* collisionData = mCollisionCallback.getCollisionData(mBoxProxyShape1, mCapsuleProxyShape1);
+            rp3d_test(collisionData != nullptr);
+            rp3d_test(collisionData->getTotalNbContactPoints() == 2);
+
+            bool swappedBodiesCollisionData = collisionData->getBody1()->getId() != mBoxBody1->getId();
+
+            // The contact points are below the ends of the inner segment of the capsule
+            decimal penetrationDepth = 0.5f;
+            for (int sign=-1; sign <= 1; sign += 2) {
+                Vector3 localBody1Point(decimal(3 * sign), 3, 0);
+                Vector3 localBody2Point = transform2.getInverse() * Vector3(decimal(10 + 3 * sign), decimal(22.5), 50);
+                rp3d_test(collisionData->hasContactPointSimilarTo(swappedBodiesCollisionData ? localBody2Point : localBody1Point,
+                                                             swappedBodiesCollisionData ? localBody1Point : localBody2Point,
+                                                             penetrationDepth));
+            }
+
+            // reset the init transforms
+            mBoxBody1->setTransform(initTransform1);
+            mCapsuleBody1->setTransform(initTransform2);
+        }
+
         void testBoxVsConcaveMeshCollision() {
 
             Transform initTransform1 = mBoxBody1->getTransform();
@@ -3032,6 +3130,567 @@ class TestCollisionWorld : public Test {
             mCapsuleBody1->setTransform(initTransform1);
             mConcaveMeshBody->setTransform(initTransform2);
         }
+
+        void testSweep() {
+
+            decimal fraction;
+            Vector3 normal;
+            const Transform origin = Transform::identity();
+
+            // ----- Sphere moving toward a static box ----- //
+
+            const Transform sphereStart(Vector3(-20, 0, 0), Quaternion::identity());
+            const Transform sphereEnd(Vector3(20, 0, 0), Quaternion::identity());
+            rp3d_test(mWorld->testSweep(mSphereShape1, sphereStart, sphereEnd, mBoxShape1, origin, origin,
+                                        fraction, normal));
+            rp3d_test(approxEqual(fraction, decimal(0.35), decimal(0.001)));
+            rp3d_test(approxEqual(normal.x, decimal(1.0), decimal(0.01)));
+
+            // The sphere passes above the box
+            const Transform sphereStartAbove(Vector3(-20, 10, 0), Quaternion::identity());
+            const Transform sphereEndAbove(Vector3(20, 10, 0), Quaternion::identity());
+            rp3d_test(!mWorld->testSweep(mSphereShape1, sphereStartAbove, sphereEndAbove, mBoxShape1, origin, origin,
+                                         fraction, normal));
+
+            // The sphere stops before the box
+            const Transform sphereEndBefore(Vector3(-10, 0, 0), Quaternion::identity());
+            rp3d_test(!mWorld->testSweep(mSphereShape1, sphereStart, sphereEndBefore, mBoxShape1, origin, origin,
+                                         fraction, normal));
+
+            // ----- Two spheres moving toward each other ----- //
+
+            const Transform sphere1Start(Vector3(-10, 0, 0), Quaternion::identity());
+            const Transform sphere2Start(Vector3(10, 0, 0), Quaternion::identity());
+            rp3d_test(mWorld->testSweep(mSphereShape1, sphere1Start, origin, mSphereShape2, sphere2Start, origin,
+                                        fraction, normal));
+            rp3d_test(approxEqual(fraction, decimal(0.6), decimal(0.001)));
+            rp3d_test(approxEqual(normal.x, decimal(1.0), decimal(0.01)));
+
+            // ----- Capsule rotating next to a static box ----- //
+
+            // The lower end of the capsule touches the box when the sinus of the angle of the rotation is 2/3
+            const Transform capsuleStart(Vector3(-7, 0, 0), Quaternion::identity());
+            const Transform capsuleEnd(Vector3(-7, 0, 0), Quaternion::fromEulerAngles(0, 0, PI / decimal(2.0)));
+            rp3d_test(mWorld->testSweep(mCapsuleShape1, capsuleStart, capsuleEnd, mBoxShape1, origin, origin,
+                                        fraction, normal));
+            const decimal expectedFraction = std::asin(decimal(2.0) / decimal(3.0)) / (PI / decimal(2.0));
+            rp3d_test(approxEqual(fraction, expectedFraction, decimal(0.005)));
+            rp3d_test(approxEqual(normal.x, decimal(1.0), decimal(0.01)));
+
+            // ----- Shapes that already overlap ----- //
+
+            rp3d_test(mWorld->testSweep(mBoxShape1, origin, sphereEnd, mSphereShape1, origin, origin,
+                                        fraction, normal));
+            rp3d_test(approxEqual(fraction, decimal(0.0)));
+        }
+
+        void testSweepWorld() {
+
+            CollisionWorld* world = new CollisionWorld();
+
+            CollisionBody* boxBody = world->createCollisionBody(Transform::identity());
+            ProxyShape* boxProxyShape = boxBody->addCollisionShape(mBoxShape1, Transform::identity());
+            boxProxyShape->setCollisionCategoryBits(0x0001);
+
+            CollisionBody* sphereBody = world->createCollisionBody(Transform(Vector3(20, 0, 0), Quaternion::identity()));
+            ProxyShape* sphereProxyShape = sphereBody->addCollisionShape(mSphereShape1, Transform::identity());
+            sphereProxyShape->setCollisionCategoryBits(0x0002);
+
+            CollisionBody* meshBody = world->createCollisionBody(Transform(Vector3(60, -10, 0), Quaternion::identity()));
+            ProxyShape* meshProxyShape = meshBody->addCollisionShape(mConcaveMeshShape, Transform::identity());
+
+            // ----- Sphere swept through the box and the other sphere ----- //
+
+            const Transform sphereStart(Vector3(-20, 0, 0), Quaternion::identity());
+            const Transform sphereEnd(Vector3(40, 0, 0), Quaternion::identity());
+
+            WorldSweepCallback callback;
+            world->sweep(mSphereShape1, sphereStart, sphereEnd, &callback);
+            rp3d_test(callback.sweepHits.size() == 2);
+            for (uint i=0; i < callback.sweepHits.size(); i++) {
+                const SweepInfo& hit = callback.sweepHits[i];
+                rp3d_test(hit.proxyShape == boxProxyShape || hit.proxyShape == sphereProxyShape);
+                const decimal expectedFraction = hit.proxyShape == boxProxyShape ? decimal(14.0 / 60.0) : decimal(34.0 / 60.0);
+                rp3d_test(approxEqual(hit.hitFraction, expectedFraction, decimal(0.001)));
+            }
+
+            SweepInfo hit;
+            rp3d_test(world->sweepClosest(mSphereShape1, sphereStart, sphereEnd, hit));
+            rp3d_test(hit.body == boxBody);
+            rp3d_test(hit.proxyShape == boxProxyShape);
+            rp3d_test(approxEqual(hit.hitFraction, decimal(14.0 / 60.0), decimal(0.001)));
+            rp3d_test(approxEqual(hit.worldNormal, Vector3(-1, 0, 0), decimal(0.01)));
+            rp3d_test(approxEqual(hit.worldPoint.x, decimal(-3.0), decimal(0.01)));
+
+            // The box is filtered out with the category mask
+            rp3d_test(world->sweepClosest(mSphereShape1, sphereStart, sphereEnd, hit, 0x0002));
+            rp3d_test(hit.proxyShape == sphereProxyShape);
+            rp3d_test(approxEqual(hit.hitFraction, decimal(34.0 / 60.0), decimal(0.001)));
+            rp3d_test(approxEqual(hit.worldPoint.x, decimal(17.0), decimal(0.01)));
+
+            // The sphere passes above the shapes
+            const Transform sphereStartAbove(Vector3(-20, 10, 0), Quaternion::identity());
+            const Transform sphereEndAbove(Vector3(40, 10, 0), Quaternion::identity());
+            rp3d_test(!world->sweepClosest(mSphereShape1, sphereStartAbove, sphereEndAbove, hit));
+            rp3d_test(!hit.isHit());
+
+            // ----- Capsule swept down onto the concave mesh ----- //
+
+            const Transform capsuleStart(Vector3(60, 0, 0), Quaternion::identity());
+            const Transform capsuleEnd(Vector3(60, -20, 0), Quaternion::identity());
+            rp3d_test(world->sweepClosest(mCapsuleShape1, capsuleStart, capsuleEnd, hit));
+            rp3d_test(hit.proxyShape == meshProxyShape);
+            rp3d_test(approxEqual(hit.hitFraction, decimal(0.25), decimal(0.005)));
+            rp3d_test(approxEqual(hit.worldNormal, Vector3(0, 1, 0), decimal(0.01)));
+            rp3d_test(approxEqual(hit.worldPoint.y, decimal(-10.0), decimal(0.01)));
+
+            // ----- Rotating box that already overlaps the box of the world ----- //
+
+            const Transform boxStart(Vector3(4, 0, 0), Quaternion::identity());
+            const Transform boxEnd(Vector3(4, 0, 0), Quaternion::fromEulerAngles(0, PI / decimal(4.0), 0));
+            rp3d_test(world->sweepClosest(mBoxShape1, boxStart, boxEnd, hit));
+            rp3d_test(hit.proxyShape == boxProxyShape);
+            rp3d_test(approxEqual(hit.hitFraction, decimal(0.0)));
+
+            delete world;
+        }
+
+        void testDistanceQueries() {
+
+            DefaultTaskScheduler scheduler(4);
+            WorldSettings settings;
+            settings.taskScheduler = &scheduler;
+            CollisionWorld* world = new CollisionWorld(settings);
+
+            CollisionBody* boxBody = world->createCollisionBody(Transform::identity());
+            ProxyShape* boxProxyShape = boxBody->addCollisionShape(mBoxShape1, Transform::identity());
+            boxProxyShape->setCollisionCategoryBits(0x0001);
+
+            CollisionBody* sphereBody = world->createCollisionBody(Transform(Vector3(20, 0, 0), Quaternion::identity()));
+            ProxyShape* sphereProxyShape = sphereBody->addCollisionShape(mSphereShape1, Transform::identity());
+            sphereProxyShape->setCollisionCategoryBits(0x0002);
+
+            CollisionBody* meshBody = world->createCollisionBody(Transform(Vector3(60, -10, 0), Quaternion::identity()));
+            ProxyShape* meshProxyShape = meshBody->addCollisionShape(mConcaveMeshShape, Transform::identity());
+
+            // ----- Distance between two shapes ----- //
+
+            DistanceInfo distanceInfo;
+            const Transform sphereTransform(Vector3(10, 0, 0), Quaternion::identity());
+            rp3d_test(world->computeDistance(mSphereShape1, sphereTransform, mBoxShape1, Transform::identity(), distanceInfo));
+            rp3d_test(approxEqual(distanceInfo.distance, decimal(4.0), decimal(0.001)));
+            rp3d_test(approxEqual(distanceInfo.worldPoint1, Vector3(7, 0, 0), decimal(0.001)));
+            rp3d_test(approxEqual(distanceInfo.worldPoint2, Vector3(3, 0, 0), decimal(0.001)));
+            rp3d_test(approxEqual(distanceInfo.worldNormal, Vector3(-1, 0, 0), decimal(0.001)));
+            rp3d_test(distanceInfo.proxyShape == nullptr);
+
+            // Overlapping shapes
+            rp3d_test(!world->computeDistance(mSphereShape1, Transform(Vector3(4, 0, 0), Quaternion::identity()),
+                                              mBoxShape1, Transform::identity(), distanceInfo));
+            rp3d_test(distanceInfo.isOverlapping());
+            rp3d_test(distanceInfo.distance == decimal(0.0));
+
+            // A batch of pairs large enough to be computed in parallel gives the same distances
+            const uint nbQueries = 300;
+            DistanceQuery queries[nbQueries];
+            DistanceInfo distanceInfos[nbQueries];
+            for (uint i=0; i < nbQueries; i++) {
+                queries[i].shape1 = mSphereShape1;
+                queries[i].shape1ToWorldTransform = Transform(Vector3(decimal(4.0) + decimal(i) * decimal(0.1), decimal(i % 7), 0),
+                                                              Quaternion::identity());
+                queries[i].shape2 = i % 2 == 0 ? static_cast<const ConvexShape*>(mBoxShape1) : mCapsuleShape1;
+                queries[i].shape2ToWorldTransform = Transform::identity();
+            }
+            world->computeDistanceBatch(queries, nbQueries, distanceInfos);
+            bool isSameDistances = true;
+            for (uint i=0; i < nbQueries; i++) {
+                world->computeDistance(queries[i].shape1, queries[i].shape1ToWorldTransform, queries[i].shape2,
+                                       queries[i].shape2ToWorldTransform, distanceInfo);
+                isSameDistances &= distanceInfos[i].distance == distanceInfo.distance;
+                isSameDistances &= distanceInfos[i].worldPoint2 == distanceInfo.worldPoint2;
+            }
+            rp3d_test(isSameDistances);
+            rp3d_test(distanceInfos[0].isOverlapping());
+            rp3d_test(approxEqual(distanceInfos[294].distance, decimal(33.4) - decimal(6.0), decimal(0.01)));
+
+            // ----- Closest point of a point ----- //
+
+            DistanceInfo hit;
+            rp3d_test(world->closestPoint(Vector3(0, 10, 0), decimal(20.0), hit));
+            rp3d_test(hit.body == boxBody);
+            rp3d_test(hit.proxyShape == boxProxyShape);
+            rp3d_test(approxEqual(hit.distance, decimal(7.0), decimal(0.001)));
+            rp3d_test(approxEqual(hit.worldPoint1, Vector3(0, 10, 0), decimal(0.001)));
+            rp3d_test(approxEqual(hit.worldPoint2, Vector3(0, 3, 0), decimal(0.001)));
+            rp3d_test(approxEqual(hit.worldNormal, Vector3(0, -1, 0), decimal(0.001)));
+
+            // The sphere is closer than the box unless it is filtered out with the category mask
+            rp3d_test(world->closestPoint(Vector3(12, 0, 0), decimal(20.0), hit));
+            rp3d_test(hit.proxyShape == sphereProxyShape);
+            rp3d_test(approxEqual(hit.distance, decimal(5.0), decimal(0.001)));
+            rp3d_test(approxEqual(hit.worldPoint2, Vector3(17, 0, 0), decimal(0.001)));
+            rp3d_test(world->closestPoint(Vector3(12, 0, 0), decimal(20.0), hit, 0x0001));
+            rp3d_test(hit.proxyShape == boxProxyShape);
+            rp3d_test(approxEqual(hit.distance, decimal(9.0), decimal(0.001)));
+
+            // No shape within the maximum distance
+            rp3d_test(!world->closestPoint(Vector3(0, 10, 0), decimal(5.0), hit));
+            rp3d_test(!hit.isHit());
+            rp3d_test(hit.distance == decimal(5.0));
+
+            // Point inside the box
+            rp3d_test(world->closestPoint(Vector3(1, 1, 1), decimal(5.0), hit));
+            rp3d_test(hit.proxyShape == boxProxyShape);
+            rp3d_test(hit.isOverlapping());
+
+            // Point above the concave mesh
+            rp3d_test(world->closestPoint(Vector3(60, -7, 0), decimal(5.0), hit));
+            rp3d_test(hit.proxyShape == meshProxyShape);
+            rp3d_test(approxEqual(hit.distance, decimal(3.0), decimal(0.01)));
+            rp3d_test(approxEqual(hit.worldPoint2.y, decimal(-10.0), decimal(0.01)));
+
+            // ----- Closest point of a convex shape ----- //
+
+            rp3d_test(world->closestPoint(mCapsuleShape1, Transform(Vector3(60, -3, 0), Quaternion::identity()),
+                                          decimal(5.0), hit));
+            rp3d_test(hit.proxyShape == meshProxyShape);
+            rp3d_test(approxEqual(hit.distance, decimal(2.0), decimal(0.01)));
+            rp3d_test(approxEqual(hit.worldPoint1.y, decimal(-8.0), decimal(0.01)));
+            rp3d_test(approxEqual(hit.worldNormal, Vector3(0, -1, 0), decimal(0.01)));
+
+            // ----- Batch of points ----- //
+
+            const uint nbPoints = 300;
+            Vector3 points[nbPoints];
+            DistanceInfo hits[nbPoints];
+            for (uint i=0; i < nbPoints; i++) {
+                points[i] = Vector3(decimal(-10.0) + decimal(i) * decimal(0.25), decimal(i % 5) - decimal(5.0), decimal(i % 3));
+            }
+            world->closestPointBatch(points, nbPoints, decimal(6.0), hits);
+            bool isSameHits = true;
+            uint nbHits = 0;
+            for (uint i=0; i < nbPoints; i++) {
+                const bool isHit = world->closestPoint(points[i], decimal(6.0), hit);
+                isSameHits &= hits[i].isHit() == isHit && hits[i].proxyShape == hit.proxyShape;
+                isSameHits &= hits[i].distance == hit.distance;
+                if (isHit) nbHits++;
+            }
+            rp3d_test(isSameHits);
+            rp3d_test(nbHits > 0 && nbHits < nbPoints);
+
+            delete world;
+        }
+
+        void testPointsInside() {
+
+            DefaultTaskScheduler scheduler(4);
+            WorldSettings settings;
+            settings.taskScheduler = &scheduler;
+            CollisionWorld* world = new CollisionWorld(settings);
+
+            CollisionBody* boxBody = world->createCollisionBody(Transform::identity());
+            ProxyShape* boxProxyShape = boxBody->addCollisionShape(mBoxShape1, Transform::identity());
+            boxProxyShape->setCollisionCategoryBits(0x0001);
+
+            CollisionBody* sphereBody = world->createCollisionBody(Transform(Vector3(8, 0, 0), Quaternion::identity()));
+            ProxyShape* sphereProxyShape = sphereBody->addCollisionShape(mSphereShape1, Transform::identity());
+            sphereProxyShape->setCollisionCategoryBits(0x0002);
+
+            CollisionBody* capsuleBody = world->createCollisionBody(Transform(Vector3(-8, 0, 0),
+                                                                    Quaternion::fromEulerAngles(0, 0, decimal(0.5))));
+            ProxyShape* capsuleProxyShape = capsuleBody->addCollisionShape(mCapsuleShape1, Transform::identity());
+            capsuleProxyShape->setCollisionCategoryBits(0x0002);
+
+            // A grid of points around the bodies (enough points to be tested in parallel)
+            const uint nbPoints = 16 * 12 * 12;
+            Vector3* points = new Vector3[nbPoints];
+            ProxyShape** hits = new ProxyShape*[nbPoints];
+            uint index = 0;
+            for (uint x=0; x < 16; x++) {
+                for (uint y=0; y < 12; y++) {
+                    for (uint z=0; z < 12; z++) {
+                        points[index++] = Vector3(decimal(x) * decimal(1.6) - decimal(12.5),
+                                                  decimal(y) * decimal(0.9) - decimal(5.2),
+                                                  decimal(z) * decimal(0.9) - decimal(4.7));
+                    }
+                }
+            }
+
+            // The batch gives the same result as the tests of each point against each body
+            uint nbInsidePoints = world->testPointsInside(points, nbPoints, hits);
+            bool isSameResults = true;
+            uint nbExpectedInsidePoints = 0;
+            for (uint i=0; i < nbPoints; i++) {
+                ProxyShape* expectedHit = nullptr;
+                if (boxBody->testPointInside(points[i])) expectedHit = boxProxyShape;
+                else if (sphereBody->testPointInside(points[i])) expectedHit = sphereProxyShape;
+                else if (capsuleBody->testPointInside(points[i])) expectedHit = capsuleProxyShape;
+                if (expectedHit != nullptr) nbExpectedInsidePoints++;
+                isSameResults &= hits[i] == expectedHit;
+            }
+            rp3d_test(isSameResults);
+            rp3d_test(nbInsidePoints == nbExpectedInsidePoints);
+            rp3d_test(nbInsidePoints > 0 && nbInsidePoints < nbPoints);
+
+            // The proxy shapes are filtered with the category mask
+            nbInsidePoints = world->testPointsInside(points, nbPoints, hits, 0x0002);
+            bool isBoxFiltered = true;
+            for (uint i=0; i < nbPoints; i++) {
+                isBoxFiltered &= hits[i] != boxProxyShape;
+                isBoxFiltered &= (hits[i] != nullptr) == (sphereBody->testPointInside(points[i]) ||
+                                                          capsuleBody->testPointInside(points[i]));
+            }
+            rp3d_test(isBoxFiltered);
+            rp3d_test(nbInsidePoints < nbExpectedInsidePoints);
+
+            // A small batch is tested without the task scheduler
+            const Vector3 fewPoints[3] = {Vector3(1, 1, 1), Vector3(9, 0, 0), Vector3(4, 4, 4)};
+            ProxyShape* fewHits[3];
+            rp3d_test(world->testPointsInside(fewPoints, 3, fewHits) == 2);
+            rp3d_test(fewHits[0] == boxProxyShape);
+            rp3d_test(fewHits[1] == sphereProxyShape);
+            rp3d_test(fewHits[2] == nullptr);
+
+            delete[] points;
+            delete[] hits;
+            delete world;
+        }
+
+        void testOverlapHits() {
+
+            CollisionWorld* world = new CollisionWorld();
+
+            CollisionBody* boxBody = world->createCollisionBody(Transform::identity());
+            ProxyShape* boxProxyShape = boxBody->addCollisionShape(mBoxShape1, Transform::identity());
+            boxProxyShape->setCollisionCategoryBits(0x0001);
+
+            CollisionBody* sphereBody = world->createCollisionBody(Transform(Vector3(20, 0, 0), Quaternion::identity()));
+            ProxyShape* sphereProxyShape = sphereBody->addCollisionShape(mSphereShape1, Transform::identity());
+            sphereProxyShape->setCollisionCategoryBits(0x0002);
+
+            CollisionBody* meshBody = world->createCollisionBody(Transform(Vector3(60, -10, 0), Quaternion::identity()));
+            ProxyShape* meshProxyShape = meshBody->addCollisionShape(mConcaveMeshShape, Transform::identity());
+
+            OverlapHit hits[4];
+
+            // ----- AABB queries ----- //
+
+            const AABB aabb(Vector3(-4, -4, -4), Vector3(25, 4, 4));
+            rp3d_test(world->testAABBOverlap(aabb, hits, 4) == 2);
+            rp3d_test(hits[0].proxyShape != hits[1].proxyShape);
+            for (uint i=0; i < 2; i++) {
+                rp3d_test(hits[i].proxyShape == boxProxyShape || hits[i].proxyShape == sphereProxyShape);
+                rp3d_test(hits[i].body == hits[i].proxyShape->getBody());
+            }
+
+            // The array is full after the first hit
+            rp3d_test(world->testAABBOverlap(aabb, hits, 1) == 1);
+
+            // The box is filtered out with the category mask
+            rp3d_test(world->testAABBOverlap(aabb, hits, 4, 0x0002) == 1);
+            rp3d_test(hits[0].proxyShape == sphereProxyShape);
+
+            // ----- Shape queries ----- //
+
+            rp3d_test(world->testOverlap(mSphereShape1, Transform(Vector3(0, 5.5, 0), Quaternion::identity()), hits, 4) == 1);
+            rp3d_test(hits[0].body == boxBody);
+            rp3d_test(hits[0].proxyShape == boxProxyShape);
+
+            // The AABBs overlap but the sphere does not touch the corner of the box
+            rp3d_test(world->testOverlap(mSphereShape1, Transform(Vector3(5.5, 5.5, 0), Quaternion::identity()), hits, 4) == 0);
+
+            // Sphere against the concave mesh
+            rp3d_test(world->testOverlap(mSphereShape1, Transform(Vector3(60, -8, 0), Quaternion::identity()), hits, 4) == 1);
+            rp3d_test(hits[0].proxyShape == meshProxyShape);
+            rp3d_test(world->testOverlap(mSphereShape1, Transform(Vector3(60, -6, 0), Quaternion::identity()), hits, 4) == 0);
+
+            // ----- Body queries ----- //
+
+            // Both shapes of the body overlap with the box that must be reported once
+            CollisionBody* queryBody = world->createCollisionBody(Transform(Vector3(5, 0, 0), Quaternion::identity()));
+            queryBody->addCollisionShape(mBoxShape1, Transform::identity());
+            queryBody->addCollisionShape(mSphereShape1, Transform(Vector3(-1, 0, 0), Quaternion::identity()));
+            rp3d_test(world->testOverlap(queryBody, hits, 4) == 1);
+            rp3d_test(hits[0].proxyShape == boxProxyShape);
+
+            // Body touching the concave mesh
+            queryBody->setTransform(Transform(Vector3(60, -7, 0), Quaternion::identity()));
+            rp3d_test(world->testOverlap(queryBody, hits, 4) == 1);
+            rp3d_test(hits[0].proxyShape == meshProxyShape);
+
+            queryBody->setTransform(Transform(Vector3(40, 0, 0), Quaternion::identity()));
+            rp3d_test(world->testOverlap(queryBody, hits, 4) == 0);
+
+            delete world;
+        }
+
+        void testContactHits() {
+
+            Transform initTransform1 = mSphereBody1->getTransform();
+            Transform initTransform2 = mSphereBody2->getTransform();
+            Transform initTransform3 = mConcaveMeshBody->getTransform();
+
+            ContactHit hits[8];
+
+            // ----- Sphere vs sphere ----- //
+
+            mSphereBody1->setTransform(Transform(Vector3(10, 20, 50), Quaternion::identity()));
+            mSphereBody2->setTransform(Transform(Vector3(17, 20, 50), Quaternion::identity()));
+
+            rp3d_test(mWorld->testOverlap(mSphereBody1, mSphereBody2));
+            rp3d_test(mWorld->testCollision(mSphereBody1, mSphereBody2, hits, 8) == 1);
+            rp3d_test(hits[0].proxyShape1 == mSphereProxyShape1);
+            rp3d_test(hits[0].proxyShape2 == mSphereProxyShape2);
+            rp3d_test(approxEqual(hits[0].worldPoint1, Vector3(13, 20, 50), decimal(0.001)));
+            rp3d_test(approxEqual(hits[0].worldPoint2, Vector3(12, 20, 50), decimal(0.001)));
+            rp3d_test(approxEqual(hits[0].worldNormal, Vector3(1, 0, 0), decimal(0.001)));
+            rp3d_test(approxEqual(hits[0].penetrationDepth, decimal(1.0), decimal(0.001)));
+
+            // The order of the bodies gives the order of the proxy shapes and the direction of the normal
+            rp3d_test(mWorld->testCollision(mSphereBody2, mSphereBody1, hits, 8) == 1);
+            rp3d_test(hits[0].proxyShape1 == mSphereProxyShape2);
+            rp3d_test(approxEqual(hits[0].worldNormal, Vector3(-1, 0, 0), decimal(0.001)));
+
+            // Nothing is stored in an empty array
+            rp3d_test(mWorld->testCollision(mSphereBody1, mSphereBody2, hits, 0) == 0);
+
+            // The spheres do not touch anymore
+            mSphereBody2->setTransform(Transform(Vector3(19, 20, 50), Quaternion::identity()));
+            rp3d_test(!mWorld->testOverlap(mSphereBody1, mSphereBody2));
+            rp3d_test(mWorld->testCollision(mSphereBody1, mSphereBody2, hits, 8) == 0);
+
+            // ----- Sphere vs concave mesh ----- //
+
+            mSphereBody1->setTransform(Transform(Vector3(10, decimal(22.98), 50), Quaternion::identity()));
+            mConcaveMeshBody->setTransform(Transform(Vector3(10, 20, 50), Quaternion::identity()));
+
+            rp3d_test(mWorld->testOverlap(mSphereBody1, mConcaveMeshBody));
+            const uint nbHits = mWorld->testCollision(mSphereBody1, mConcaveMeshBody, hits, 8);
+            rp3d_test(nbHits > 0);
+            for (uint i=0; i < nbHits; i++) {
+                rp3d_test(hits[i].proxyShape1 == mSphereProxyShape1);
+                rp3d_test(hits[i].proxyShape2 == mConcaveMeshProxyShape);
+                rp3d_test(hits[i].penetrationDepth > decimal(0.0));
+                rp3d_test(hits[i].worldNormal.y < decimal(0.0));
+            }
+
+            // Reset the init transforms
+            mSphereBody1->setTransform(initTransform1);
+            mSphereBody2->setTransform(initTransform2);
+            mConcaveMeshBody->setTransform(initTransform3);
+        }
+
+        void testUpdate() {
+
+            CollisionWorld* world = new CollisionWorld();
+
+            CollisionBody* boxBody1 = world->createCollisionBody(Transform::identity());
+            ProxyShape* boxProxyShape1 = boxBody1->addCollisionShape(mBoxShape1, Transform::identity());
+            CollisionBody* boxBody2 = world->createCollisionBody(Transform(Vector3(0, 5, 0), Quaternion::identity()));
+            boxBody2->addCollisionShape(mBoxShape1, Transform::identity());
+
+            // The boxes start touching
+            world->update();
+            rp3d_test(world->getContactManifolds().size() == 1);
+            rp3d_test(boxBody1->getNbContactManifolds() == 1);
+            rp3d_test(world->getContactEvents().size() == 1);
+            rp3d_test(world->getContactEvents()[0].type == ContactEventType::CONTACT_BEGIN);
+            rp3d_test(world->getContactEvents()[0].proxyShape1 == boxProxyShape1 ||
+                      world->getContactEvents()[0].proxyShape2 == boxProxyShape1);
+            const ContactManifold* manifold = world->getContactManifolds()[0];
+
+            // The pair and its contact manifold are kept and the SAT algorithm starts from the
+            // axis of the previous update
+            world->update();
+            rp3d_test(world->getContactManifolds().size() == 1);
+            rp3d_test(world->getContactManifolds()[0] == manifold);
+            rp3d_test(world->getContactEvents().size() == 0);
+            rp3d_test(world->getNarrowPhaseStatistics().nbSATPreviousAxisHits > 0);
+
+            // The boxes stop touching
+            boxBody2->setTransform(Transform(Vector3(0, 20, 0), Quaternion::identity()));
+            world->update();
+            rp3d_test(world->getContactManifolds().size() == 0);
+            rp3d_test(boxBody1->getNbContactManifolds() == 0);
+            rp3d_test(world->getContactEvents().size() == 1);
+            rp3d_test(world->getContactEvents()[0].type == ContactEventType::CONTACT_END);
+
+            delete world;
+        }
+
+        void testEPADeepPenetration() {
+
+            // World that computes the deep penetrations of the GJK pairs with EPA
+            WorldSettings settings;
+            settings.isEPAEnabled = true;
+            CollisionWorld* world = new CollisionWorld(settings);
+
+            CollisionBody* boxBody = world->createCollisionBody(Transform(Vector3(14, 20, 50), Quaternion::identity()));
+            ProxyShape* boxProxyShape = boxBody->addCollisionShape(mBoxShape1, Transform::identity());
+
+            /********************************************************************************
+            * Test Sphere vs Box deep penetration                                           *
+            *********************************************************************************/
+
+            // The center of the sphere is inside the box, 1.5 units behind the face x = -3
+            CollisionBody* sphereBody = world->createCollisionBody(Transform(Vector3(12.5, 20, 50), Quaternion::identity()));
+            ProxyShape* sphereProxyShape = sphereBody->addCollisionShape(mSphereShape1, Transform::identity());
+
+            mCollisionCallback.reset();
+            world->testCollision(sphereBody, boxBody, &mCollisionCallback);
+
+            rp3d_test(mCollisionCallback.areProxyShapesColliding(sphereProxyShape, boxProxyShape));
+
+            const CollisionData* collisionData = mCollisionCallback.getCollisionData(sphereProxyShape, boxProxyShape);
+            rp3d_test(collisionData != nullptr);
+            rp3d_test(collisionData->getNbContactManifolds() == 1);
+            rp3d_test(collisionData->getTotalNbContactPoints() == 1);
+
+            bool swappedBodiesCollisionData = collisionData->getBody1()->getId() != sphereBody->getId();
+
+            // Same contact point as the one computed by the SAT algorithm
+            Vector3 localBody1Point(3, 0, 0);
+            Vector3 localBody2Point(-3, 0, 0);
+            rp3d_test(collisionData->hasContactPointSimilarTo(swappedBodiesCollisionData ? localBody2Point : localBody1Point,
+                                                              swappedBodiesCollisionData ? localBody1Point : localBody2Point,
+                                                              decimal(4.5)));
+
+            world->destroyCollisionBody(sphereBody);
+
+            /********************************************************************************
+            * Test Capsule vs Box deep penetration                                          *
+            *********************************************************************************/
+
+            // The segment of the capsule is inside the box, 1.5 units behind the face x = -3
+            CollisionBody* capsuleBody = world->createCollisionBody(Transform(Vector3(12.5, 20, 50), Quaternion::identity()));
+            ProxyShape* capsuleProxyShape = capsuleBody->addCollisionShape(mCapsuleShape1, Transform::identity());
+
+            mCollisionCallback.reset();
+            world->testCollision(capsuleBody, boxBody, &mCollisionCallback);
+
+            rp3d_test(mCollisionCallback.areProxyShapesColliding(capsuleProxyShape, boxProxyShape));
+
+            collisionData = mCollisionCallback.getCollisionData(capsuleProxyShape, boxProxyShape);
+            rp3d_test(collisionData != nullptr);
+            rp3d_test(collisionData->getNbContactManifolds() == 1);
+            rp3d_test(collisionData->getTotalNbContactPoints() >= 1);
+
+            swappedBodiesCollisionData = collisionData->getBody1()->getId() != capsuleBody->getId();
+
+            // The contact points are on the face x = -3 of the box
+            for (uint i=0; i < collisionData->contactManifolds[0].contactPoints.size(); i++) {
+
+                const CollisionPointData& point = collisionData->contactManifolds[0].contactPoints[i];
+                const Vector3& capsulePoint = swappedBodiesCollisionData ? point.localPointBody2 : point.localPointBody1;
+                const Vector3& boxPoint = swappedBodiesCollisionData ? point.localPointBody1 : point.localPointBody2;
+
+                rp3d_test(approxEqual(point.penetrationDepth, decimal(3.5), decimal(0.001)));
+                rp3d_test(approxEqual(capsulePoint.x, decimal(2.0), decimal(0.001)));
+                rp3d_test(approxEqual(boxPoint.x, decimal(-3.0), decimal(0.001)));
+            }
+
+            delete world;
+        }
  };
 
 }
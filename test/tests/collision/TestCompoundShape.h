@@ -0,0 +1,307 @@
+/********************************************************************************
+* ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
+* Copyright (c) 2010-2018 Daniel Chappuis                                       *
+*********************************************************************************
+*                                                                               *
+* This software is provided 'as-is', without any express or implied warranty.   *
+* In no event will the authors be held liable for any damages arising from the  *
+* use of this software.                                                         *
+*                                                                               *
+* Permission is granted to anyone to use this software for any purpose,         *
+* including commercial applications, and to alter it and redistribute it        *
+* freely, subject to the following restrictions:                                *
+*                                                                               *
+* 1. The origin of this software must not be misrepresented; you must not claim *
+*    that you wrote the original software. If you use this software in a        *
+*    product, an acknowledgment in the product documentation would be           *
+*    appreciated but is not required.                                           *
+*                                                                               *
+* 2. Altered source versions must be plainly marked as such, and must not be    *
+*    misrepresented as being the original software.                             *
+*                                                                               *
+* 3. This notice may not be removed or altered from any source distribution.    *
+*                                                                               *
+********************************************************************************/
+
+#ifndef TEST_COMPOUND_SHAPE_H
+#define TEST_COMPOUND_SHAPE_H
+
+// Libraries
+#include "Test.h"
+#include "engine/CollisionWorld.h"
+#include "engine/DynamicsWorld.h"
+#include "collision/RaycastInfo.h"
+#include "collision/SweepInfo.h"
+#include "collision/OverlapCallback.h"
+#include "collision/shapes/BoxShape.h"
+#include "collision/shapes/SphereShape.h"
+#include "collision/shapes/HeightFieldShape.h"
+#include "collision/shapes/CompoundShape.h"
+
+/// Reactphysics3D namespace
+namespace reactphysics3d {
+
+// Class TestCompoundShape
+/**
+ * Unit test for the compound collision shape
+ */
+class TestCompoundShape : public Test {
+
+    private :
+
+        // ---------- Constants ---------- //
+
+        static const int NB_POINTS = 10;
+
+        // ---------- Atributes ---------- //
+
+        CollisionWorld* mWorld;
+        BoxShape* mBoxShape;
+        BoxShape* mFloorBoxShape;
+        SphereShape* mSphereShape;
+        HeightFieldShape* mHeightFieldShape;
+        float mHeights[NB_POINTS * NB_POINTS];
+
+        /// Compound shape made of two boxes at x = -1 and x = 1
+        CompoundShape* mCompoundShape;
+
+        /// Compound shape made of two large boxes used as a floor
+        CompoundShape* mFloorCompoundShape;
+
+        CollisionBody* mCompoundBody;
+        ProxyShape* mCompoundProxyShape;
+
+        // ---------- Methods ---------- //
+
+        /// Drop the compound shape on a static floor and return its final transform
+        Transform dropCompoundShape(CollisionShape* floorShape, const Quaternion& orientation,
+                                    uint& nbBoxVsBoxTests) {
+
+            DynamicsWorld world(Vector3(0, decimal(-9.81), 0));
+
+            RigidBody* floor = world.createRigidBody(Transform::identity());
+            floor->setType(BodyType::STATIC);
+            floor->addCollisionShape(floorShape, Transform::identity(), decimal(1.0));
+            RigidBody* body = world.createRigidBody(Transform(Vector3(0, decimal(1.5), 0), orientation));
+            body->addCollisionShape(mCompoundShape, Transform::identity(), decimal(2.0));
+
+            nbBoxVsBoxTests = 0;
+            for (int i=0; i < 120; i++) {
+                world.update(decimal(1.0) / decimal(60.0));
+                nbBoxVsBoxTests += world.getStepStatistics().narrowPhase.nbBoxVsBoxTests;
+            }
+
+            return body->getTransform();
+        }
+
+    public :
+
+        // ---------- Methods ---------- //
+
+        /// Constructor
+        TestCompoundShape(const std::string& name) : Test(name) {
+
+            mWorld = new CollisionWorld();
+            mBoxShape = new BoxShape(Vector3(decimal(0.5), decimal(0.5), decimal(0.5)));
+            mFloorBoxShape = new BoxShape(Vector3(decimal(2.0), decimal(0.5), decimal(4.0)));
+            mSphereShape = new SphereShape(decimal(0.25));
+
+            // Flat height field with the heights at zero
+            for (int i=0; i < NB_POINTS * NB_POINTS; i++) {
+                mHeights[i] = 0.0f;
+            }
+            mHeightFieldShape = new HeightFieldShape(NB_POINTS, NB_POINTS, -1, 1, mHeights,
+                                                     HeightFieldShape::HeightDataType::HEIGHT_FLOAT_TYPE);
+
+            mCompoundShape = new CompoundShape();
+            mCompoundShape->addChildShape(mBoxShape, Transform(Vector3(-1, 0, 0), Quaternion::identity()));
+            mCompoundShape->addChildShape(mBoxShape, Transform(Vector3(1, 0, 0), Quaternion::identity()));
+
+            mFloorCompoundShape = new CompoundShape();
+            mFloorCompoundShape->addChildShape(mFloorBoxShape, Transform(Vector3(-2, 0, 0), Quaternion::identity()));
+            mFloorCompoundShape->addChildShape(mFloorBoxShape, Transform(Vector3(2, 0, 0), Quaternion::identity()));
+
+            mCompoundBody = mWorld->createCollisionBody(Transform(Vector3(10, 0, 0), Quaternion::identity()));
+            mCompoundProxyShape = mCompoundBody->addCollisionShape(mCompoundShape, Transform::identity());
+        }
+
+        /// Destructor
+        virtual ~TestCompoundShape() {
+            delete mWorld;
+            delete mCompoundShape;
+            delete mFloorCompoundShape;
+            delete mBoxShape;
+            delete mFloorBoxShape;
+            delete mSphereShape;
+            delete mHeightFieldShape;
+        }
+
+        /// Run the tests
+        void run() {
+
+            testProperties();
+            testInertiaTensor();
+            testPointInside();
+            testRaycast();
+            testOverlap();
+            testSweep();
+            testDynamicsWorld();
+        }
+
+        /// Test the type, the children and the bounds of the compound shape
+        void testProperties() {
+
+            rp3d_test(mCompoundShape->getType() == CollisionShapeType::COMPOUND);
+            rp3d_test(mCompoundShape->getName() == CollisionShapeName::COMPOUND);
+            rp3d_test(!mCompoundShape->isConvex() && !mCompoundShape->isPolyhedron());
+
+            rp3d_test(mCompoundShape->getNbChildShapes() == 2);
+            rp3d_test(mCompoundShape->getChildShape(0) == mBoxShape);
+            rp3d_test(approxEqual(mCompoundShape->getChildTransform(1).getPosition(), Vector3(1, 0, 0)));
+
+            Vector3 min, max;
+            mCompoundShape->getLocalBounds(min, max);
+            rp3d_test(approxEqual(min, Vector3(decimal(-1.5), decimal(-0.5), decimal(-0.5)), decimal(0.000001)));
+            rp3d_test(approxEqual(max, Vector3(decimal(1.5), decimal(0.5), decimal(0.5)), decimal(0.000001)));
+
+            // The broad-phase AABB of the proxy shape contains the two children
+            const AABB aabb = mCompoundProxyShape->getWorldAABB();
+            rp3d_test(aabb.contains(Vector3(decimal(8.6), 0, 0)) && aabb.contains(Vector3(decimal(11.4), 0, 0)));
+
+            // The cached local bounds are rotated with the shape
+            AABB rotatedAABB;
+            mCompoundShape->computeAABB(rotatedAABB, Transform(Vector3(1, 2, 3),
+                                        Quaternion::fromEulerAngles(0, 0, decimal(PI / 2.0))));
+            rp3d_test(approxEqual(rotatedAABB.getMin(), Vector3(decimal(0.5), decimal(0.5), decimal(2.5)), decimal(0.00001)));
+            rp3d_test(approxEqual(rotatedAABB.getMax(), Vector3(decimal(1.5), decimal(3.5), decimal(3.5)), decimal(0.00001)));
+        }
+
+        /// Test the inertia tensor of the compound shape
+        void testInertiaTensor() {
+
+            // Each box has half of the mass and is moved one meter away from the origin along X
+            Matrix3x3 tensor;
+            mCompoundShape->computeLocalInertiaTensor(tensor, decimal(2.0));
+            rp3d_test(approxEqual(tensor[0][0], decimal(1.0 / 3.0), decimal(0.00001)));
+            rp3d_test(approxEqual(tensor[1][1], decimal(7.0 / 3.0), decimal(0.00001)));
+            rp3d_test(approxEqual(tensor[2][2], decimal(7.0 / 3.0), decimal(0.00001)));
+            rp3d_test(approxEqual(tensor[0][1], decimal(0.0)) && approxEqual(tensor[1][2], decimal(0.0)));
+        }
+
+        /// Test the testPointInside() method of the compound shape
+        void testPointInside() {
+
+            const Vector3 center(10, 0, 0);
+            rp3d_test(mCompoundProxyShape->testPointInside(center + Vector3(1, 0, 0)));
+            rp3d_test(mCompoundProxyShape->testPointInside(center + Vector3(decimal(-1.2), decimal(0.3), 0)));
+            rp3d_test(!mCompoundProxyShape->testPointInside(center));
+            rp3d_test(!mCompoundProxyShape->testPointInside(center + Vector3(1, decimal(0.6), 0)));
+        }
+
+        /// Test the raycasting against the compound shape
+        void testRaycast() {
+
+            const Vector3 center(10, 0, 0);
+
+            // Ray along X hitting the nearest child first
+            RaycastInfo raycastInfo1;
+            rp3d_test(mCompoundProxyShape->raycast(Ray(center + Vector3(5, 0, 0), center + Vector3(-5, 0, 0)),
+                                                   raycastInfo1));
+            rp3d_test(raycastInfo1.proxyShape == mCompoundProxyShape);
+            rp3d_test(approxEqual(raycastInfo1.hitFraction, decimal(0.35), decimal(0.0001)));
+            rp3d_test(approxEqual(raycastInfo1.worldPoint, center + Vector3(decimal(1.5), 0, 0), decimal(0.0001)));
+            rp3d_test(approxEqual(raycastInfo1.worldNormal, Vector3(1, 0, 0), decimal(0.0001)));
+
+            // Ray along Y hitting the top of the first child
+            RaycastInfo raycastInfo2;
+            rp3d_test(mCompoundProxyShape->raycast(Ray(center + Vector3(-1, 5, 0), center + Vector3(-1, -5, 0)),
+                                                   raycastInfo2));
+            rp3d_test(approxEqual(raycastInfo2.hitFraction, decimal(0.45), decimal(0.0001)));
+            rp3d_test(approxEqual(raycastInfo2.worldPoint, center + Vector3(-1, decimal(0.5), 0), decimal(0.0001)));
+            rp3d_test(approxEqual(raycastInfo2.worldNormal, Vector3(0, 1, 0), decimal(0.0001)));
+
+            // Ray going through the gap between the two children
+            RaycastInfo raycastInfo3;
+            rp3d_test(!mCompoundProxyShape->raycast(Ray(center + Vector3(0, 5, 0), center + Vector3(0, -5, 0)),
+                                                    raycastInfo3));
+
+            // Closest hit in the world
+            RaycastHit hit;
+            rp3d_test(mWorld->raycastClosest(Ray(center + Vector3(-5, 0, 0), center + Vector3(5, 0, 0)), hit));
+            rp3d_test(approxEqual(hit.worldPoint, center + Vector3(decimal(-1.5), 0, 0), decimal(0.0001)));
+        }
+
+        /// Test the overlap queries with the compound shape
+        void testOverlap() {
+
+            const Vector3 center(10, 0, 0);
+            OverlapHit hits[4];
+
+            // Sphere in the gap between the two children
+            rp3d_test(mWorld->testOverlap(mSphereShape, Transform(center, Quaternion::identity()), hits, 4) == 0);
+
+            // Sphere touching the second child
+            rp3d_test(mWorld->testOverlap(mSphereShape, Transform(center + Vector3(1, decimal(0.6), 0),
+                                                                  Quaternion::identity()), hits, 4) == 1);
+            rp3d_test(hits[0].proxyShape == mCompoundProxyShape);
+
+            // Body with a sphere between the children and body with a sphere touching the first child
+            CollisionBody* body1 = mWorld->createCollisionBody(Transform(center, Quaternion::identity()));
+            body1->addCollisionShape(mSphereShape, Transform::identity());
+            CollisionBody* body2 = mWorld->createCollisionBody(Transform(center + Vector3(decimal(-1.6), 0, 0),
+                                                                         Quaternion::identity()));
+            body2->addCollisionShape(mSphereShape, Transform::identity());
+
+            rp3d_test(!mWorld->testOverlap(mCompoundBody, body1));
+            rp3d_test(mWorld->testOverlap(mCompoundBody, body2));
+
+            mWorld->destroyCollisionBody(body1);
+            mWorld->destroyCollisionBody(body2);
+        }
+
+        /// Test a sphere swept against the compound shape
+        void testSweep() {
+
+            const Vector3 center(10, 0, 0);
+
+            SweepInfo hit;
+            rp3d_test(mWorld->sweepClosest(mSphereShape, Transform(center + Vector3(5, 0, 0), Quaternion::identity()),
+                                           Transform(center + Vector3(-5, 0, 0), Quaternion::identity()), hit));
+            rp3d_test(hit.proxyShape == mCompoundProxyShape);
+            rp3d_test(approxEqual(hit.hitFraction, decimal(0.325), decimal(0.01)));
+            rp3d_test(approxEqual(hit.worldPoint, center + Vector3(decimal(1.5), 0, 0), decimal(0.05)));
+
+            // Sweep through the gap between the children
+            rp3d_test(!mWorld->sweepClosest(mSphereShape, Transform(center + Vector3(0, 5, 0), Quaternion::identity()),
+                                            Transform(center + Vector3(0, -5, 0), Quaternion::identity()), hit));
+        }
+
+        /// Test the compound shape falling on a box, on another compound shape and on a height field
+        void testDynamicsWorld() {
+
+            uint nbBoxVsBoxTests;
+
+            // The compound shape rests on the box without tilting
+            Transform transform = dropCompoundShape(mFloorBoxShape, Quaternion::identity(), nbBoxVsBoxTests);
+            rp3d_test(nbBoxVsBoxTests > 0);
+            rp3d_test(approxEqual(transform.getPosition().y, decimal(1.0), decimal(0.05)));
+            rp3d_test(approxEqual(transform.getOrientation().getMatrix() * Vector3(1, 0, 0), Vector3(1, 0, 0),
+                                  decimal(0.01)));
+
+            // The compound shape lies across the two children of the compound floor
+            transform = dropCompoundShape(mFloorCompoundShape, Quaternion::fromEulerAngles(0, PI * decimal(0.5), 0),
+                                          nbBoxVsBoxTests);
+            rp3d_test(nbBoxVsBoxTests > 0);
+            rp3d_test(approxEqual(transform.getPosition().y, decimal(1.0), decimal(0.05)));
+
+            // The compound shape rests on the triangles of the height field
+            transform = dropCompoundShape(mHeightFieldShape, Quaternion::identity(), nbBoxVsBoxTests);
+            rp3d_test(approxEqual(transform.getPosition().y, decimal(0.5), decimal(0.05)));
+            rp3d_test(approxEqual(transform.getOrientation().getMatrix() * Vector3(1, 0, 0), Vector3(1, 0, 0),
+                                  decimal(0.01)));
+        }
+ };
+
+}
+
+#endif
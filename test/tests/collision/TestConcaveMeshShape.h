@@ -0,0 +1,403 @@
+/********************************************************************************
+* ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
+* Copyright (c) 2010-2018 Daniel Chappuis                                       *
+*********************************************************************************
+*                                                                               *
+* This software is provided 'as-is', without any express or implied warranty.   *
+* In no event will the authors be held liable for any damages arising from the  *
+* use of this software.                                                         *
+*                                                                               *
+* Permission is granted to anyone to use this software for any purpose,         *
+* including commercial applications, and to alter it and redistribute it        *
+* freely, subject to the following restrictions:                                *
+*                                                                               *
+* 1. The origin of this software must not be misrepresented; you must not claim *
+*    that you wrote the original software. If you use this software in a        *
+*    product, an acknowledgment in the product documentation would be           *
+*    appreciated but is not required.                                           *
+*                                                                               *
+* 2. Altered source versions must be plainly marked as such, and must not be    *
+*    misrepresented as being the original software.                             *
+*                                                                               *
+* 3. This notice may not be removed or altered from any source distribution.    *
+*                                                                               *
+********************************************************************************/
+
+#ifndef TEST_CONCAVE_MESH_SHAPE_H
+#define TEST_CONCAVE_MESH_SHAPE_H
+
+// Libraries
+#include "Test.h"
+#include "TestHeightFieldShape.h"
+#include "engine/CollisionWorld.h"
+#include "collision/shapes/ConcaveMeshShape.h"
+#include "collision/TriangleMesh.h"
+#include "collision/TriangleVertexArray.h"
+#include "collision/RaycastInfo.h"
+#include "collision/shapes/TriangleShape.h"
+#include <cmath>
+#include <vector>
+
+/// Reactphysics3D namespace
+namespace reactphysics3d {
+
+// Class TestConcaveMeshShape
+/**
+ * Unit test for the concave mesh shapes that share the BVH of their triangle mesh
+ */
+class TestConcaveMeshShape : public Test {
+
+    private :
+
+        // ---------- Atributes ---------- //
+
+        /// Number of vertices on each side of the grid of the mesh
+        static const int NB_SIDE_VERTICES = 9;
+
+        /// Vertices of the mesh
+        float mVertices[NB_SIDE_VERTICES * NB_SIDE_VERTICES * 3];
+
+        /// Indices of the triangles of the mesh
+        int mIndices[(NB_SIDE_VERTICES - 1) * (NB_SIDE_VERTICES - 1) * 2 * 3];
+
+        TriangleVertexArray* mTriangleVertexArray;
+        TriangleMesh* mTriangleMesh;
+
+    public :
+
+        // ---------- Methods ---------- //
+
+        /// Constructor
+        TestConcaveMeshShape(const std::string& name) : Test(name) {
+
+            // Bumpy grid in the x-z plane
+            for (int i=0; i < NB_SIDE_VERTICES; i++) {
+                for (int j=0; j < NB_SIDE_VERTICES; j++) {
+                    float* vertex = mVertices + 3 * (i * NB_SIDE_VERTICES + j);
+                    vertex[0] = float(i) - 4.0f;
+                    vertex[1] = float(std::sin(0.9 * i) + std::cos(0.7 * j));
+                    vertex[2] = float(j) - 4.0f;
+                }
+            }
+            int index = 0;
+            for (int i=0; i < NB_SIDE_VERTICES - 1; i++) {
+                for (int j=0; j < NB_SIDE_VERTICES - 1; j++) {
+                    const int vertex = i * NB_SIDE_VERTICES + j;
+                    mIndices[index++] = vertex;
+                    mIndices[index++] = vertex + 1;
+                    mIndices[index++] = vertex + NB_SIDE_VERTICES;
+                    mIndices[index++] = vertex + 1;
+                    mIndices[index++] = vertex + NB_SIDE_VERTICES + 1;
+                    mIndices[index++] = vertex + NB_SIDE_VERTICES;
+                }
+            }
+
+            mTriangleVertexArray = new TriangleVertexArray(NB_SIDE_VERTICES * NB_SIDE_VERTICES, mVertices, 3 * sizeof(float),
+                                                           (NB_SIDE_VERTICES - 1) * (NB_SIDE_VERTICES - 1) * 2, mIndices,
+                                                           3 * sizeof(int),
+                                                           TriangleVertexArray::VertexDataType::VERTEX_FLOAT_TYPE,
+                                                           TriangleVertexArray::IndexDataType::INDEX_INTEGER_TYPE);
+            mTriangleMesh = new TriangleMesh();
+            mTriangleMesh->addSubpart(mTriangleVertexArray);
+        }
+
+        /// Destructor
+        virtual ~TestConcaveMeshShape() {
+            delete mTriangleMesh;
+            delete mTriangleVertexArray;
+        }
+
+        /// Run the tests
+        void run() override {
+            testScaledInstances();
+            testSerializedBVH();
+            testRaycastLanes();
+            testEdgesConvexity();
+        }
+
+        /// Test the convexity of the edges and the adjacency of the triangles of a strip
+        /// of triangles with a ridge in the middle
+        void testEdgesConvexity() {
+
+            // Strip along the x axis with two vertices at each x coordinate and four quads
+            const float heights[5] = {0.0f, 0.0f, 0.5f, 0.0f, 0.0f};
+            float vertices[5 * 2 * 3];
+            for (int k=0; k < 5; k++) {
+                for (int r=0; r < 2; r++) {
+                    float* vertex = vertices + 3 * (2 * k + r);
+                    vertex[0] = float(k) - 2.0f;
+                    vertex[1] = heights[k];
+                    vertex[2] = float(r);
+                }
+            }
+            int indices[4 * 2 * 3];
+            for (int k=0; k < 4; k++) {
+                const int a = 2 * k;
+                const int b = a + 1;
+                const int c = a + 2;
+                const int d = a + 3;
+                int* triangles = indices + 6 * k;
+                triangles[0] = a; triangles[1] = b; triangles[2] = c;
+                triangles[3] = b; triangles[4] = d; triangles[5] = c;
+            }
+
+            TriangleVertexArray vertexArray(10, vertices, 3 * sizeof(float), 8, indices, 3 * sizeof(int),
+                                            TriangleVertexArray::VertexDataType::VERTEX_FLOAT_TYPE,
+                                            TriangleVertexArray::IndexDataType::INDEX_INTEGER_TYPE);
+            TriangleMesh mesh;
+            mesh.addSubpart(&vertexArray);
+
+            rp3d_test(!mesh.hasEdgesConvexity());
+            rp3d_test(mesh.getTriangleEdgesConvexity(3) == TriangleMesh::ALL_EDGES_CONVEX);
+
+            mesh.computeEdgesConvexity();
+            rp3d_test(mesh.hasEdgesConvexity());
+
+            // The boundary edges and the ridge are convex. The diagonals of the quads are flat and
+            // the two other edges across the strip are concave.
+            const uint8 expectedConvexity[8] = {5, 1, 4, 3, 5, 1, 4, 3};
+            for (uint t=0; t < 8; t++) {
+                rp3d_test(mesh.getTriangleEdgesConvexity(t) == expectedConvexity[t]);
+            }
+
+            for (uint k=0; k < 4; k++) {
+                const uint first = 2 * k;
+                const uint second = first + 1;
+                rp3d_test(mesh.getAdjacentTriangle(first, 0) == (k > 0 ? first - 1 : TriangleMesh::NO_ADJACENT_TRIANGLE));
+                rp3d_test(mesh.getAdjacentTriangle(first, 1) == second);
+                rp3d_test(mesh.getAdjacentTriangle(first, 2) == TriangleMesh::NO_ADJACENT_TRIANGLE);
+                rp3d_test(mesh.getAdjacentTriangle(second, 0) == TriangleMesh::NO_ADJACENT_TRIANGLE);
+                rp3d_test(mesh.getAdjacentTriangle(second, 1) == (k < 3 ? second + 1 : TriangleMesh::NO_ADJACENT_TRIANGLE));
+                rp3d_test(mesh.getAdjacentTriangle(second, 2) == first);
+            }
+
+            // The edges shared by triangles of different sub-parts are found
+            TriangleMesh twoPartsMesh;
+            twoPartsMesh.addSubpart(&vertexArray);
+            twoPartsMesh.addSubpart(&vertexArray);
+            twoPartsMesh.computeEdgesConvexity();
+
+            // The boundary edges are shared by two triangles folded back over each other and the
+            // other edges are shared by more than two triangles, so all the edges are convex
+            rp3d_test(twoPartsMesh.getAdjacentTriangle(0, 2) == 8);
+            rp3d_test(twoPartsMesh.getAdjacentTriangle(8, 2) == 0);
+            rp3d_test(twoPartsMesh.getAdjacentTriangle(0, 1) == TriangleMesh::NO_ADJACENT_TRIANGLE);
+            rp3d_test(twoPartsMesh.getTriangleEdgesConvexity(0) == TriangleMesh::ALL_EDGES_CONVEX);
+        }
+
+        /// Test that the raycast of triangles by lanes gives the same results as the
+        /// raycast of triangle shapes
+        void testRaycastLanes() {
+
+            // Pseudo-random generator of the triangles and rays
+            uint32 seed = 1234;
+            auto random = [&seed](decimal min, decimal max) {
+                seed = seed * 1664525u + 1013904223u;
+                return min + (max - min) * decimal(seed >> 8) / decimal(1 << 24);
+            };
+
+            const TriangleRaycastSide sides[3] = {TriangleRaycastSide::FRONT, TriangleRaycastSide::BACK,
+                                                  TriangleRaycastSide::FRONT_AND_BACK};
+            uint nbDifferences = 0;
+            uint nbHits = 0;
+
+            CollisionWorld world;
+            CollisionBody* body = world.createCollisionBody(Transform::identity());
+
+            for (int i=0; i < 300; i++) {
+
+                const Ray ray(Vector3(random(-2, 2), random(-2, 2), random(-5, -3)),
+                              Vector3(random(-2, 2), random(-2, 2), random(3, 5)), random(decimal(0.3), 1));
+
+                ConcaveMeshRaycastCallback::TriangleRaycastLanes lanes;
+                Vector3 trianglesPoints[ConcaveMeshRaycastCallback::NB_RAYCAST_LANES][3];
+                for (uint l=0; l < ConcaveMeshRaycastCallback::NB_RAYCAST_LANES; l++) {
+                    for (uint v=0; v < 3; v++) {
+                        trianglesPoints[l][v] = Vector3(random(-2, 2), random(-2, 2), random(-1, 1));
+                        for (int k=0; k < 3; k++) lanes.vertices[v][k][l] = trianglesPoints[l][v][k];
+                    }
+                }
+
+                const TriangleRaycastSide side = sides[i % 3];
+                ConcaveMeshRaycastCallback::raycastTrianglesLanes(lanes, ray, side);
+
+                for (uint l=0; l < ConcaveMeshRaycastCallback::NB_RAYCAST_LANES; l++) {
+
+                    const Vector3 normals[3] = {Vector3(0, 0, 1), Vector3(0, 0, 1), Vector3(0, 0, 1)};
+                    TriangleShape triangleShape(trianglesPoints[l], normals, 0);
+                    triangleShape.setRaycastTestType(side);
+                    ProxyShape* proxyShape = body->addCollisionShape(&triangleShape, Transform::identity());
+                    RaycastInfo raycastInfo;
+                    const bool isHit = proxyShape->raycast(ray, raycastInfo);
+                    body->removeCollisionShape(proxyShape);
+
+                    if (isHit != lanes.isHit[l]) nbDifferences++;
+                    if (isHit && lanes.isHit[l]) {
+                        nbHits++;
+                        if (raycastInfo.hitFraction != lanes.hitFractions[l]) nbDifferences++;
+                        if (raycastInfo.worldPoint != Vector3(lanes.hitPoints[0][l], lanes.hitPoints[1][l],
+                                                              lanes.hitPoints[2][l])) {
+                            nbDifferences++;
+                        }
+                    }
+                }
+            }
+
+            rp3d_test(nbHits > 0);
+            rp3d_test(nbDifferences == 0);
+
+            world.destroyCollisionBody(body);
+        }
+
+        /// Test that a mesh that uses the serialized BVH of another mesh reports the same
+        /// triangles in the overlap queries
+        void testSerializedBVH() {
+
+            // Buffer aligned on eight bytes
+            const size_t size = mTriangleMesh->getSerializedBVHSizeInBytes();
+            std::vector<uint64> data((size + sizeof(uint64) - 1) / sizeof(uint64));
+            mTriangleMesh->serializeBVH(data.data());
+
+            TriangleMesh loadedMesh;
+            loadedMesh.addSubpart(mTriangleVertexArray);
+            rp3d_test(loadedMesh.loadSerializedBVH(data.data(), size));
+
+            // A serialized BVH cannot be loaded in a mesh with other sub-parts
+            TriangleMesh otherMesh;
+            otherMesh.addSubpart(mTriangleVertexArray);
+            otherMesh.addSubpart(mTriangleVertexArray);
+            rp3d_test(!otherMesh.loadSerializedBVH(data.data(), size));
+
+            // A serialized BVH of another version cannot be loaded
+            std::vector<uint64> otherVersionData(data);
+            reinterpret_cast<unsigned char*>(otherVersionData.data())[4]++;
+            TriangleMesh otherVersionMesh;
+            otherVersionMesh.addSubpart(mTriangleVertexArray);
+            rp3d_test(!otherVersionMesh.loadSerializedBVH(otherVersionData.data(), size));
+
+            ConcaveMeshShape shape(mTriangleMesh);
+            ConcaveMeshShape loadedShape(&loadedMesh);
+            ConcaveMeshShape otherShape(&otherMesh);
+
+            Vector3 min, max, loadedMin, loadedMax;
+            shape.getLocalBounds(min, max);
+            loadedShape.getLocalBounds(loadedMin, loadedMax);
+            rp3d_test(approxEqual(min, loadedMin));
+            rp3d_test(approxEqual(max, loadedMax));
+
+            for (int q=0; q < 50; q++) {
+
+                const decimal t = decimal(q) / decimal(50.0);
+                const Vector3 center = min + (max - min) * t;
+                const AABB queryAABB(center - Vector3(1, 1, 1), center + Vector3(decimal(1.5), 1, decimal(0.5)));
+
+                TriangleCollector triangles;
+                TriangleCollector loadedTriangles;
+                TriangleCollector otherTriangles;
+                shape.testAllTriangles(triangles, queryAABB);
+                loadedShape.testAllTriangles(loadedTriangles, queryAABB);
+                otherShape.testAllTriangles(otherTriangles, queryAABB);
+
+                rp3d_test(loadedTriangles.shapeIds.size() == triangles.shapeIds.size());
+                for (uint i=0; i < triangles.shapeIds.size(); i++) {
+                    rp3d_test(loadedTriangles.hasShapeId(triangles.shapeIds[i]));
+                }
+
+                // The other mesh has a built BVH with both sub-parts
+                rp3d_test(otherTriangles.shapeIds.size() == 2 * triangles.shapeIds.size());
+            }
+        }
+
+        /// Test the overlap queries and the raycasts of concave mesh shapes with different
+        /// scalings that share the BVH of the same mesh
+        void testScaledInstances() {
+
+            const Vector3 scalings[3] = {Vector3(1, 1, 1), Vector3(decimal(2.0), decimal(0.5), decimal(3.0)),
+                                         Vector3(decimal(0.3), decimal(4.0), decimal(1.2))};
+            ConcaveMeshShape* shapes[3];
+            for (int s=0; s < 3; s++) {
+                shapes[s] = new ConcaveMeshShape(mTriangleMesh, scalings[s]);
+            }
+
+            CollisionWorld world;
+            CollisionBody* body = world.createCollisionBody(Transform::identity());
+
+            // Pseudo-random generator of the queries
+            uint32 seed = 4242;
+            auto random = [&seed](decimal min, decimal max) {
+                seed = seed * 1664525u + 1013904223u;
+                return min + (max - min) * decimal(seed >> 8) / decimal(1 << 24);
+            };
+
+            const uint nbTriangles = shapes[0]->getNbTriangles(0);
+
+            for (int s=0; s < 3; s++) {
+
+                ConcaveMeshShape* shape = shapes[s];
+                ProxyShape* proxyShape = body->addCollisionShape(shape, Transform::identity());
+
+                // The bounds of the shape are the scaled bounds of the mesh
+                Vector3 min, max, unscaledMin, unscaledMax;
+                shape->getLocalBounds(min, max);
+                shapes[0]->getLocalBounds(unscaledMin, unscaledMax);
+                rp3d_test(approxEqual(min, unscaledMin * scalings[s], decimal(0.0001)));
+                rp3d_test(approxEqual(max, unscaledMax * scalings[s], decimal(0.0001)));
+
+                for (int q=0; q < 50; q++) {
+
+                    // Every scaled triangle that overlaps a random AABB is reported
+                    const Vector3 point1(random(min.x, max.x), random(min.y, max.y), random(min.z, max.z));
+                    const Vector3 point2(random(min.x, max.x), random(min.y, max.y), random(min.z, max.z));
+                    const AABB queryAABB(Vector3::min(point1, point2), Vector3::max(point1, point2));
+
+                    TriangleCollector queryTriangles;
+                    shape->testAllTriangles(queryTriangles, queryAABB);
+
+                    for (uint t=0; t < nbTriangles; t++) {
+                        Vector3 trianglePoints[3];
+                        shape->getTriangleVertices(0, t, trianglePoints);
+                        const bool isOverlapping = AABB::createAABBForTriangle(trianglePoints).testCollision(queryAABB);
+                        rp3d_test(queryTriangles.hasShapeId(t) == isOverlapping);
+                    }
+
+                    // A vertical ray hits the same triangle as a brute force raycast
+                    const decimal x = random(min.x, max.x);
+                    const decimal z = random(min.z, max.z);
+                    const Ray ray(Vector3(x, max.y + 1, z), Vector3(x, min.y - 1, z));
+
+                    RaycastInfo raycastInfo;
+                    const bool isHit = proxyShape->raycast(ray, raycastInfo);
+
+                    // Brute force raycast against all the triangles of the mesh
+                    RaycastInfo bruteForceRaycastInfo;
+                    ConcaveMeshRaycastCallback callback(*shape, proxyShape, bruteForceRaycastInfo, ray,
+                                                        MemoryManager::getBaseAllocator());
+#ifdef IS_PROFILING_ACTIVE
+                    callback.setProfiler(world.getProfiler());
+#endif
+                    for (uint t=0; t < nbTriangles; t++) {
+                        callback.raycastBroadPhaseShape(t, ray);
+                    }
+                    callback.raycastTriangles();
+                    const bool isBruteForceHit = callback.getIsHit();
+                    const decimal bruteForceHitFraction = bruteForceRaycastInfo.hitFraction;
+
+                    rp3d_test(isHit == isBruteForceHit);
+                    if (isHit && isBruteForceHit) {
+                        rp3d_test(approxEqual(raycastInfo.hitFraction, bruteForceHitFraction, decimal(0.0001)));
+                    }
+                }
+
+                body->removeCollisionShape(proxyShape);
+            }
+
+            world.destroyCollisionBody(body);
+            for (int s=0; s < 3; s++) {
+                delete shapes[s];
+            }
+        }
+};
+
+}
+
+#endif
@@ -0,0 +1,185 @@
+/********************************************************************************
+* ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
+* Copyright (c) 2010-2016 Daniel Chappuis                                       *
+*********************************************************************************
+*                                                                               *
+* This software is provided 'as-is', without any express or implied warranty.   *
+* In no event will the authors be held liable for any damages arising from the  *
+* use of this software.                                                         *
+*                                                                               *
+* Permission is granted to anyone to use this software for any purpose,         *
+* including commercial applications, and to alter it and redistribute it        *
+* freely, subject to the following restrictions:                                *
+*                                                                               *
+* 1. The origin of this software must not be misrepresented; you must not claim *
+*    that you wrote the original software. If you use this software in a        *
+*    product, an acknowledgment in the product documentation would be           *
+*    appreciated but is not required.                                           *
+*                                                                               *
+* 2. Altered source versions must be plainly marked as such, and must not be    *
+*    misrepresented as being the original software.                             *
+*                                                                               *
+* 3. This notice may not be removed or altered from any source distribution.    *
+*                                                                               *
+********************************************************************************/
+
+
+#ifndef TEST_CONTACT_MANIFOLD_INFO_H
+#define TEST_CONTACT_MANIFOLD_INFO_H
+
+// Libraries
+#include "reactphysics3d.h"
+#include "collision/ContactManifoldInfo.h"
+
+/// Reactphysics3D namespace
+namespace reactphysics3d {
+
+// Class TestContactManifoldInfo
+/**
+ * Unit test for the ContactManifoldInfo class.
+ */
+class TestContactManifoldInfo : public Test {
+
+    private :
+
+        // ---------- Atributes ---------- //
+
+        /// Transform of the first shape
+        Transform mShape1ToWorldTransform;
+
+    public :
+
+        // ---------- Methods ---------- //
+
+        /// Constructor
+        TestContactManifoldInfo(const std::string& name) : Test(name) {
+
+            mShape1ToWorldTransform = Transform(Vector3(2, -3, 5), Quaternion::identity());
+        }
+
+        /// Destructor
+        virtual ~TestContactManifoldInfo() {
+
+        }
+
+        /// Run the tests
+        void run() {
+            testAddContactPoints();
+            testReduce();
+            testReduceWithBudget();
+        }
+
+        /// Return true if the manifold has a contact point with a given local point of shape 1
+        bool hasContactPoint(const ContactManifoldInfo& manifold, const Vector3& localPoint1) const {
+
+            for (uint i=0; i < manifold.getNbContactPoints(); i++) {
+                if (approxEqual(manifold.getContactPointInfo(i).localPoint1, localPoint1)) {
+                    return true;
+                }
+            }
+
+            return false;
+        }
+
+        void testAddContactPoints() {
+
+            ContactManifoldInfo manifold;
+            rp3d_test(manifold.getNbContactPoints() == 0);
+
+            const Vector3 normal(0, 0, 1);
+            manifold.addContactPoint(ContactPointInfo(normal, decimal(0.5), Vector3(1, 0, 0), Vector3(1, 0, 0)),
+                                     mShape1ToWorldTransform);
+            manifold.addContactPoint(ContactPointInfo(normal, decimal(1.5), Vector3(0, 1, 0), Vector3(0, 1, 0)),
+                                     mShape1ToWorldTransform);
+            manifold.addContactPoint(ContactPointInfo(normal, decimal(1.0), Vector3(0, 0, 0), Vector3(0, 0, 0)),
+                                     mShape1ToWorldTransform);
+
+            rp3d_test(manifold.getNbContactPoints() == 3);
+            rp3d_test(approxEqual(manifold.getLargestPenetrationDepth(), decimal(1.5)));
+            rp3d_test(approxEqual(manifold.getContactPointInfo(1).penetrationDepth, decimal(1.5)));
+
+            // The reduction does nothing with less than four contact points
+            manifold.reduce(mShape1ToWorldTransform);
+            rp3d_test(manifold.getNbContactPoints() == 3);
+
+            manifold.reset();
+            rp3d_test(manifold.getNbContactPoints() == 0);
+        }
+
+        void testReduce() {
+
+            ContactManifoldInfo manifold;
+            const Vector3 normal(0, 0, 1);
+
+            // Add a 5x5 grid of contact points in the plane z = 0 (more points than the
+            // capacity of the manifold that has to be reduced while the points are added)
+            for (int i=-2; i <= 2; i++) {
+                for (int j=-2; j <= 2; j++) {
+
+                    const Vector3 point(i, j, 0);
+                    manifold.addContactPoint(ContactPointInfo(normal, decimal(1.0), point, point),
+                                             mShape1ToWorldTransform);
+
+                    rp3d_test(manifold.getNbContactPoints() <= uint(MAX_CANDIDATE_CONTACT_POINTS_IN_MANIFOLD));
+                }
+            }
+
+            manifold.reduce(mShape1ToWorldTransform);
+
+            // The four corners of the grid are kept
+            rp3d_test(manifold.getNbContactPoints() == 4);
+            rp3d_test(hasContactPoint(manifold, Vector3(2, 2, 0)));
+            rp3d_test(hasContactPoint(manifold, Vector3(-2, -2, 0)));
+            rp3d_test(hasContactPoint(manifold, Vector3(2, -2, 0)));
+            rp3d_test(hasContactPoint(manifold, Vector3(-2, 2, 0)));
+        }
+
+        /// Add a 3x2 grid of contact points in the plane z = 0 (the point (0, 1, 0) is the deepest)
+        void addGridContactPoints(ContactManifoldInfo& manifold) {
+
+            const Vector3 normal(0, 0, 1);
+            for (int i=-1; i <= 1; i++) {
+                for (int j=-1; j <= 1; j += 2) {
+                    const Vector3 point(i, j, 0);
+                    const decimal depth = i == 0 && j == 1 ? decimal(2.0) : decimal(1.0);
+                    manifold.addContactPoint(ContactPointInfo(normal, depth, point, point), mShape1ToWorldTransform);
+                }
+            }
+        }
+
+        void testReduceWithBudget() {
+
+            ContactManifoldInfo manifold;
+
+            // With three points, the first two points and the point of the largest triangle are kept
+            addGridContactPoints(manifold);
+            manifold.reduce(mShape1ToWorldTransform, 3);
+            rp3d_test(manifold.getNbContactPoints() == 3);
+            rp3d_test(hasContactPoint(manifold, Vector3(1, 1, 0)));
+            rp3d_test(hasContactPoint(manifold, Vector3(-1, -1, 0)));
+            rp3d_test(hasContactPoint(manifold, Vector3(1, -1, 0)) || hasContactPoint(manifold, Vector3(-1, 1, 0)));
+
+            // With two points, the two farthest corners are kept
+            manifold.reset();
+            addGridContactPoints(manifold);
+            manifold.reduce(mShape1ToWorldTransform, 2);
+            rp3d_test(manifold.getNbContactPoints() == 2);
+            rp3d_test(hasContactPoint(manifold, Vector3(1, 1, 0)));
+            rp3d_test(hasContactPoint(manifold, Vector3(-1, -1, 0)));
+
+            // With a single point, the deepest point is kept
+            manifold.reset();
+            addGridContactPoints(manifold);
+            manifold.reduce(mShape1ToWorldTransform, 1);
+            rp3d_test(manifold.getNbContactPoints() == 1);
+            rp3d_test(hasContactPoint(manifold, Vector3(0, 1, 0)));
+
+            // A manifold within the budget is not reduced
+            manifold.reduce(mShape1ToWorldTransform, 2);
+            rp3d_test(manifold.getNbContactPoints() == 1);
+        }
+ };
+
+}
+
+#endif
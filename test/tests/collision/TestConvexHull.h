@@ -0,0 +1,245 @@
+/********************************************************************************
+* ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
+* Copyright (c) 2010-2018 Daniel Chappuis                                       *
+*********************************************************************************
+*                                                                               *
+* This software is provided 'as-is', without any express or implied warranty.   *
+* In no event will the authors be held liable for any damages arising from the  *
+* use of this software.                                                         *
+*                                                                               *
+* Permission is granted to anyone to use this software for any purpose,         *
+* including commercial applications, and to alter it and redistribute it        *
+* freely, subject to the following restrictions:                                *
+*                                                                               *
+* 1. The origin of this software must not be misrepresented; you must not claim *
+*    that you wrote the original software. If you use this software in a        *
+*    product, an acknowledgment in the product documentation would be           *
+*    appreciated but is not required.                                           *
+*                                                                               *
+* 2. Altered source versions must be plainly marked as such, and must not be    *
+*    misrepresented as being the original software.                             *
+*                                                                               *
+* 3. This notice may not be removed or altered from any source distribution.    *
+*                                                                               *
+********************************************************************************/
+
+#ifndef TEST_CONVEX_HULL_H
+#define TEST_CONVEX_HULL_H
+
+// Libraries
+#include "Test.h"
+#include "collision/ConvexHull.h"
+#include "collision/PolyhedronMesh.h"
+#include "collision/shapes/ConvexMeshShape.h"
+#include <cmath>
+#include <vector>
+
+/// Reactphysics3D namespace
+namespace reactphysics3d {
+
+// Class TestConvexHull
+/**
+ * Unit test for the ConvexHull class
+ */
+class TestConvexHull : public Test {
+
+    private :
+
+        // ---------- Methods ---------- //
+
+        /// Return true if all the points are inside the hull (up to a tolerance)
+        bool arePointsInside(const std::vector<Vector3>& points, const PolyhedronMesh& mesh, decimal tolerance) {
+
+            for (uint f=0; f < mesh.getNbFaces(); f++) {
+                const Vector3 normal = mesh.getFaceNormal(f);
+                const Vector3 facePoint = mesh.getVertex(mesh.getHalfEdgeStructure().getFace(f).faceVertices[0]);
+                for (uint i=0; i < points.size(); i++) {
+                    if (normal.dot(points[i] - facePoint) > tolerance) return false;
+                }
+            }
+
+            return true;
+        }
+
+        /// Return true if the faces of the mesh are planar and its normals point outside
+        bool areFacesValid(const PolyhedronMesh& mesh, decimal tolerance) {
+
+            const Vector3 centroid = mesh.getCentroid();
+            for (uint f=0; f < mesh.getNbFaces(); f++) {
+                const Vector3 normal = mesh.getFaceNormal(f);
+                const SmallList<uint, 8>& faceVertices = mesh.getHalfEdgeStructure().getFace(f).faceVertices;
+                const Vector3 facePoint = mesh.getVertex(faceVertices[0]);
+                if (normal.dot(facePoint - centroid) <= decimal(0.0)) return false;
+                for (uint v=1; v < faceVertices.size(); v++) {
+                    if (std::abs(normal.dot(mesh.getVertex(faceVertices[v]) - facePoint)) > tolerance) return false;
+                }
+            }
+
+            return true;
+        }
+
+        /// Return points on a sphere (with a deterministic pseudo-random generator)
+        std::vector<Vector3> createSpherePoints(uint nbPoints, decimal radius) {
+
+            std::vector<Vector3> points;
+            uint32 seed = 12345;
+            while (points.size() < nbPoints) {
+                Vector3 point;
+                for (int i=0; i < 3; i++) {
+                    seed = seed * 1664525u + 1013904223u;
+                    point[i] = decimal(seed >> 8) / decimal(1 << 24) * decimal(2.0) - decimal(1.0);
+                }
+                if (point.lengthSquare() > decimal(0.01)) {
+                    points.push_back(point.getUnit() * radius);
+                }
+            }
+
+            return points;
+        }
+
+    public :
+
+        // ---------- Methods ---------- //
+
+        /// Constructor
+        TestConvexHull(const std::string& name) : Test(name) {
+
+        }
+
+        /// Run the tests
+        void run() {
+            testBox();
+            testPrism();
+            testPointCloud();
+            testVertexAndFaceBudget();
+            testDegeneratePoints();
+        }
+
+        /// Test the hull of the corners of a box with points on its faces, edges and inside
+        void testBox() {
+
+            std::vector<Vector3> points;
+            for (int x=-1; x <= 1; x++) {
+                for (int y=-1; y <= 1; y++) {
+                    for (int z=-1; z <= 1; z++) {
+                        points.push_back(Vector3(decimal(x) * 2, decimal(y) * 3, decimal(z)));
+                        points.push_back(Vector3(decimal(x), decimal(y) * decimal(1.5), decimal(z) * decimal(0.5)));
+                    }
+                }
+            }
+
+            ConvexHull hull(points.data(), static_cast<uint>(points.size()));
+            rp3d_test(hull.isValid());
+
+            // The coplanar triangles are merged into the six quads of the box
+            rp3d_test(hull.getNbVertices() == 8);
+            rp3d_test(hull.getNbFaces() == 6);
+            for (uint v=0; v < hull.getNbVertices(); v++) {
+                const Vector3& vertex = hull.getVertex(v);
+                rp3d_test(std::abs(vertex.x) == 2 && std::abs(vertex.y) == 3 && std::abs(vertex.z) == 1);
+            }
+
+            PolyhedronMesh mesh(hull.getPolygonVertexArray());
+            rp3d_test(mesh.getNbFaces() == 6);
+            rp3d_test(mesh.getHalfEdgeStructure().getNbHalfEdges() == 24);
+            rp3d_test(areFacesValid(mesh, decimal(0.0001)));
+            rp3d_test(arePointsInside(points, mesh, decimal(0.0001)));
+            rp3d_test(approxEqual(mesh.getCentroid(), Vector3::zero(), decimal(0.0001)));
+        }
+
+        /// Test the hull of a prism with many sides
+        void testPrism() {
+
+            const uint nbSides = 32;
+            std::vector<Vector3> points;
+            for (uint i=0; i < nbSides; i++) {
+                const decimal angle = decimal(2.0) * PI * decimal(i) / decimal(nbSides);
+                points.push_back(Vector3(std::cos(angle) * 3, decimal(-2.0), std::sin(angle) * 3));
+                points.push_back(Vector3(std::cos(angle) * 3, decimal(2.0), std::sin(angle) * 3));
+                points.push_back(Vector3(std::cos(angle), 0, std::sin(angle)));
+            }
+
+            ConvexHull hull(points.data(), static_cast<uint>(points.size()));
+            rp3d_test(hull.isValid());
+            rp3d_test(hull.getNbVertices() == 2 * nbSides);
+            rp3d_test(hull.getNbFaces() == nbSides + 2);
+
+            PolyhedronMesh mesh(hull.getPolygonVertexArray());
+            rp3d_test(areFacesValid(mesh, decimal(0.0001)));
+            rp3d_test(arePointsInside(points, mesh, decimal(0.0001)));
+        }
+
+        /// Test the hull of points on a sphere and inside it
+        void testPointCloud() {
+
+            std::vector<Vector3> points = createSpherePoints(300, decimal(2.0));
+            for (uint i=0; i < 100; i++) {
+                points.push_back(points[i] * decimal(0.5));
+            }
+
+            ConvexHull hull(points.data(), static_cast<uint>(points.size()));
+            rp3d_test(hull.isValid());
+            rp3d_test(hull.getNbVertices() == 300);
+
+            // The hull is a closed polyhedron (Euler characteristic of 2)
+            PolyhedronMesh mesh(hull.getPolygonVertexArray());
+            const HalfEdgeStructure& halfEdgeStructure = mesh.getHalfEdgeStructure();
+            rp3d_test(halfEdgeStructure.getNbVertices() + halfEdgeStructure.getNbFaces() ==
+                      halfEdgeStructure.getNbHalfEdges() / 2 + 2);
+            rp3d_test(areFacesValid(mesh, decimal(0.0001)));
+            rp3d_test(arePointsInside(points, mesh, decimal(0.0001)));
+        }
+
+        /// Test the limits on the number of vertices and faces of the hull
+        void testVertexAndFaceBudget() {
+
+            const std::vector<Vector3> points = createSpherePoints(200, decimal(1.0));
+
+            ConvexHull vertexLimitedHull(points.data(), static_cast<uint>(points.size()), 24);
+            rp3d_test(vertexLimitedHull.isValid());
+            rp3d_test(vertexLimitedHull.getNbVertices() <= 24 && vertexLimitedHull.getNbVertices() >= 20);
+
+            // The vertices of the hull are the input points furthest apart
+            PolyhedronMesh vertexLimitedMesh(vertexLimitedHull.getPolygonVertexArray());
+            rp3d_test(areFacesValid(vertexLimitedMesh, decimal(0.0001)));
+            rp3d_test(!arePointsInside(points, vertexLimitedMesh, decimal(0.0001)));
+            rp3d_test(arePointsInside(points, vertexLimitedMesh, decimal(0.5)));
+
+            ConvexHull faceLimitedHull(points.data(), static_cast<uint>(points.size()), 0, 20);
+            rp3d_test(faceLimitedHull.isValid());
+            rp3d_test(faceLimitedHull.getNbFaces() <= 20 && faceLimitedHull.getNbFaces() >= 4);
+
+            // A convex mesh shape can be created with the hull
+            PolyhedronMesh faceLimitedMesh(faceLimitedHull.getPolygonVertexArray());
+            rp3d_test(areFacesValid(faceLimitedMesh, decimal(0.0001)));
+            ConvexMeshShape shape(&faceLimitedMesh);
+            Vector3 min, max;
+            shape.getLocalBounds(min, max);
+            rp3d_test(min.x >= decimal(-1.0001) && max.x <= decimal(1.0001));
+            rp3d_test(max.x - min.x > decimal(1.0));
+        }
+
+        /// Test that the hull of coplanar or too few points is not valid
+        void testDegeneratePoints() {
+
+            const Vector3 coplanarPoints[5] = {Vector3(0, 1, 0), Vector3(1, 1, 0), Vector3(0, 1, 1),
+                                               Vector3(1, 1, 1), Vector3(decimal(0.5), 1, 2)};
+            ConvexHull coplanarHull(coplanarPoints, 5);
+            rp3d_test(!coplanarHull.isValid());
+            rp3d_test(coplanarHull.getPolygonVertexArray() == nullptr);
+            rp3d_test(coplanarHull.getNbVertices() == 0 && coplanarHull.getNbFaces() == 0);
+
+            ConvexHull tooFewPointsHull(coplanarPoints, 3);
+            rp3d_test(!tooFewPointsHull.isValid());
+
+            const Vector3 tetrahedronPoints[4] = {Vector3(0, 0, 0), Vector3(1, 0, 0), Vector3(0, 1, 0),
+                                                  Vector3(0, 0, 1)};
+            ConvexHull tetrahedronHull(tetrahedronPoints, 4);
+            rp3d_test(tetrahedronHull.isValid());
+            rp3d_test(tetrahedronHull.getNbVertices() == 4 && tetrahedronHull.getNbFaces() == 4);
+        }
+ };
+
+}
+
+#endif
@@ -0,0 +1,364 @@
+/********************************************************************************
+* ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
+* Copyright (c) 2010-2016 Daniel Chappuis                                       *
+*********************************************************************************
+*                                                                               *
+* This software is provided 'as-is', without any express or implied warranty.   *
+* In no event will the authors be held liable for any damages arising from the  *
+* use of this software.                                                         *
+*                                                                               *
+* Permission is granted to anyone to use this software for any purpose,         *
+* including commercial applications, and to alter it and redistribute it        *
+* freely, subject to the following restrictions:                                *
+*                                                                               *
+* 1. The origin of this software must not be misrepresented; you must not claim *
+*    that you wrote the original software. If you use this software in a        *
+*    product, an acknowledgment in the product documentation would be           *
+*    appreciated but is not required.                                           *
+*                                                                               *
+* 2. Altered source versions must be plainly marked as such, and must not be    *
+*    misrepresented as being the original software.                             *
+*                                                                               *
+* 3. This notice may not be removed or altered from any source distribution.    *
+*                                                                               *
+********************************************************************************/
+
+#ifndef TEST_CONVEX_MESH_SHAPE_H
+#define TEST_CONVEX_MESH_SHAPE_H
+
+// Libraries
+#include "Test.h"
+#include "collision/shapes/ConvexMeshShape.h"
+#include "collision/PolyhedronMesh.h"
+#include "collision/PolygonVertexArray.h"
+#include <cmath>
+#include <vector>
+
+/// Reactphysics3D namespace
+namespace reactphysics3d {
+
+// Class TestableConvexMeshShape
+/**
+ * Convex mesh shape that gives access to its support functions
+ */
+class TestableConvexMeshShape : public ConvexMeshShape {
+
+    public :
+
+        TestableConvexMeshShape(PolyhedronMesh* polyhedronMesh, const Vector3& scaling)
+            : ConvexMeshShape(polyhedronMesh, scaling) {
+
+        }
+
+        using ConvexMeshShape::getLocalSupportPointWithoutMargin;
+        using ConvexMeshShape::getLocalSupportPointWithoutMarginFromVertex;
+};
+
+// Class TestConvexMeshShape
+/**
+ * Unit test for the support functions of the ConvexMeshShape class
+ */
+class TestConvexMeshShape : public Test {
+
+    private :
+
+        // ---------- Atributes ---------- //
+
+        /// Number of sides of the prism mesh
+        static const int NB_SIDES = 64;
+
+        /// Vertices of the prism
+        float mVertices[2 * NB_SIDES * 3];
+
+        /// Indices of the faces of the prism
+        int mIndices[2 * NB_SIDES + 4 * NB_SIDES];
+
+        /// Faces of the prism
+        PolygonVertexArray::PolygonFace mFaces[NB_SIDES + 2];
+
+        PolygonVertexArray* mPolygonVertexArray;
+        PolyhedronMesh* mPolyhedronMesh;
+
+        /// Vertices of the tetrahedron
+        float mTetrahedronVertices[4 * 3];
+
+        /// Indices of the faces of the tetrahedron
+        int mTetrahedronIndices[4 * 3];
+
+        /// Faces of the tetrahedron
+        PolygonVertexArray::PolygonFace mTetrahedronFaces[4];
+
+        PolygonVertexArray* mTetrahedronPolygonVertexArray;
+        PolyhedronMesh* mTetrahedronPolyhedronMesh;
+
+    public :
+
+        // ---------- Methods ---------- //
+
+        /// Constructor
+        TestConvexMeshShape(const std::string& name) : Test(name) {
+
+            // Create a prism with a regular polygon base (the vertices 0 to NB_SIDES - 1 are
+            // the bottom ring and the next ones are the top ring)
+            for (int i=0; i < NB_SIDES; i++) {
+                const float angle = float(2.0 * PI * i / NB_SIDES);
+                const float x = 3.0f * std::cos(angle);
+                const float z = 3.0f * std::sin(angle);
+                mVertices[3 * i] = x; mVertices[3 * i + 1] = -2.0f; mVertices[3 * i + 2] = z;
+                mVertices[3 * (NB_SIDES + i)] = x;
+                mVertices[3 * (NB_SIDES + i) + 1] = 2.0f;
+                mVertices[3 * (NB_SIDES + i) + 2] = z;
+            }
+
+            int index = 0;
+
+            // Bottom face
+            mFaces[0].indexBase = index;
+            mFaces[0].nbVertices = NB_SIDES;
+            for (int i=0; i < NB_SIDES; i++) {
+                mIndices[index++] = i;
+            }
+
+            // Top face
+            mFaces[1].indexBase = index;
+            mFaces[1].nbVertices = NB_SIDES;
+            for (int i=NB_SIDES - 1; i >= 0; i--) {
+                mIndices[index++] = NB_SIDES + i;
+            }
+
+            // Side faces
+            for (int i=0; i < NB_SIDES; i++) {
+                const int next = (i + 1) % NB_SIDES;
+                mFaces[2 + i].indexBase = index;
+                mFaces[2 + i].nbVertices = 4;
+                mIndices[index++] = i;
+                mIndices[index++] = NB_SIDES + i;
+                mIndices[index++] = NB_SIDES + next;
+                mIndices[index++] = next;
+            }
+
+            mPolygonVertexArray = new PolygonVertexArray(2 * NB_SIDES, mVertices, 3 * sizeof(float),
+                                                         mIndices, sizeof(int), NB_SIDES + 2, mFaces,
+                                                         PolygonVertexArray::VertexDataType::VERTEX_FLOAT_TYPE,
+                                                         PolygonVertexArray::IndexDataType::INDEX_INTEGER_TYPE);
+            mPolyhedronMesh = new PolyhedronMesh(mPolygonVertexArray);
+
+            // Create a tetrahedron (its number of vertices is not a multiple of the number of lanes)
+            const float tetrahedronVertices[12] = {1, -1, -1,  -1, -1, -1,  0, -1, 2,  0, 3, 0};
+            const int tetrahedronIndices[12] = {0, 1, 2,  0, 3, 1,  1, 3, 2,  2, 3, 0};
+            for (int i=0; i < 12; i++) {
+                mTetrahedronVertices[i] = tetrahedronVertices[i];
+                mTetrahedronIndices[i] = tetrahedronIndices[i];
+            }
+            for (int f=0; f < 4; f++) {
+                mTetrahedronFaces[f].indexBase = 3 * f;
+                mTetrahedronFaces[f].nbVertices = 3;
+            }
+            mTetrahedronPolygonVertexArray = new PolygonVertexArray(4, mTetrahedronVertices, 3 * sizeof(float),
+                                                                    mTetrahedronIndices, sizeof(int), 4, mTetrahedronFaces,
+                                                                    PolygonVertexArray::VertexDataType::VERTEX_FLOAT_TYPE,
+                                                                    PolygonVertexArray::IndexDataType::INDEX_INTEGER_TYPE);
+            mTetrahedronPolyhedronMesh = new PolyhedronMesh(mTetrahedronPolygonVertexArray);
+        }
+
+        /// Destructor
+        virtual ~TestConvexMeshShape() {
+            delete mPolyhedronMesh;
+            delete mPolygonVertexArray;
+            delete mTetrahedronPolyhedronMesh;
+            delete mTetrahedronPolygonVertexArray;
+        }
+
+        /// Run the tests
+        void run() {
+            testHillClimbingSupportPoint(Vector3(1, 1, 1));
+            testHillClimbingSupportPoint(Vector3(2, 0.5, 1));
+            testSupportVertexLanes(mPolyhedronMesh);
+            testSupportVertexLanes(mTetrahedronPolyhedronMesh);
+            testSerializedHalfEdgeStructure();
+            testRaycastLanes(mPolyhedronMesh);
+        }
+
+        /// Test that the clipping of a ray with groups of face planes gives the same result
+        /// as the clipping with one face plane at a time (the number of faces of the mesh is
+        /// not a multiple of the number of lanes)
+        void testRaycastLanes(PolyhedronMesh* mesh) {
+
+            const HalfEdgeStructure& halfEdgeStructure = mesh->getHalfEdgeStructure();
+
+            uint nbHits = 0;
+            uint nbDifferences = 0;
+
+            for (int i=0; i < 300; i++) {
+
+                // Rays toward the mesh from points around it (some of them miss it or are too short)
+                const decimal angle = decimal(i) * decimal(0.13);
+                const Vector3 rayPoint(decimal(6.0) * std::cos(angle), decimal(4.0) * std::sin(decimal(0.7) * angle),
+                                       decimal(6.0) * std::sin(angle));
+                const Vector3 target(std::sin(decimal(1.3) * angle), std::cos(decimal(0.9) * angle), decimal(0.5));
+                const Vector3 rayDirection = target - rayPoint;
+                const decimal maxFraction = i % 5 == 0 ? decimal(0.1) : decimal(1.0);
+
+                // Clip the ray with one face plane at a time
+                decimal tMin = decimal(0.0);
+                decimal tMax = maxFraction;
+                uint expectedFace = 0;
+                bool isExpectedHit = false;
+                bool isOutside = false;
+                for (uint f=0; f < mesh->getNbFaces(); f++) {
+                    const HalfEdgeStructure::Face& face = halfEdgeStructure.getFace(f);
+                    const Vector3 faceNormal = mesh->getFaceNormal(f);
+                    const Vector3 facePoint = mesh->getVertex(halfEdgeStructure.getVertex(face.faceVertices[0]).vertexPointIndex);
+                    const decimal denom = faceNormal.dot(rayDirection);
+                    const decimal dist = faceNormal.dot(facePoint) - faceNormal.dot(rayPoint);
+                    if (denom == decimal(0.0)) {
+                        isOutside |= dist < decimal(0.0);
+                        continue;
+                    }
+                    const decimal t = dist / denom;
+                    if (denom < decimal(0.0) && t > tMin) {
+                        tMin = t;
+                        expectedFace = f;
+                        isExpectedHit = true;
+                    }
+                    else if (denom > decimal(0.0) && t < tMax) {
+                        tMax = t;
+                    }
+                }
+                isExpectedHit &= !isOutside && tMin <= tMax;
+
+                decimal hitFraction;
+                uint hitFace;
+                const bool isHit = mesh->clipRay(rayPoint, rayDirection, maxFraction, hitFraction, hitFace);
+
+                if (isHit != isExpectedHit) {
+                    nbDifferences++;
+                }
+                else if (isHit) {
+                    nbHits++;
+                    if (hitFace != expectedFace || !approxEqual(hitFraction, tMin, decimal(0.0001))) nbDifferences++;
+                }
+            }
+
+            rp3d_test(nbDifferences == 0);
+            rp3d_test(nbHits > 0 && nbHits < 300);
+
+            // A ray that starts inside the mesh does not hit it
+            decimal hitFraction;
+            uint hitFace;
+            rp3d_test(!mesh->clipRay(mesh->getCentroid(), Vector3(1, 0, 0), decimal(1.0), hitFraction, hitFace));
+        }
+
+        /// Test that a polyhedron mesh created with the serialized half-edge structure of
+        /// another mesh has the same half-edge structure
+        void testSerializedHalfEdgeStructure() {
+
+            const HalfEdgeStructure& structure = mPolyhedronMesh->getHalfEdgeStructure();
+            const size_t size = structure.getSerializedSizeInBytes();
+            std::vector<unsigned char> data(size);
+            structure.serialize(data.data());
+
+            PolyhedronMesh loadedMesh(mPolygonVertexArray, data.data(), size);
+            const HalfEdgeStructure& loadedStructure = loadedMesh.getHalfEdgeStructure();
+
+            rp3d_test(loadedStructure.getNbVertices() == structure.getNbVertices());
+            rp3d_test(loadedStructure.getNbFaces() == structure.getNbFaces());
+            rp3d_test(loadedStructure.getNbHalfEdges() == structure.getNbHalfEdges());
+            for (uint v=0; v < structure.getNbVertices(); v++) {
+                rp3d_test(loadedStructure.getVertex(v).vertexPointIndex == structure.getVertex(v).vertexPointIndex);
+                rp3d_test(loadedStructure.getVertex(v).edgeIndex == structure.getVertex(v).edgeIndex);
+            }
+            for (uint f=0; f < structure.getNbFaces(); f++) {
+                rp3d_test(loadedStructure.getFace(f).edgeIndex == structure.getFace(f).edgeIndex);
+                rp3d_test(loadedStructure.getFace(f).faceVertices.size() == structure.getFace(f).faceVertices.size());
+                rp3d_test(approxEqual(loadedMesh.getFaceNormal(f), mPolyhedronMesh->getFaceNormal(f)));
+            }
+            for (uint e=0; e < structure.getNbHalfEdges(); e++) {
+                const HalfEdgeStructure::Edge& edge = structure.getHalfEdge(e);
+                const HalfEdgeStructure::Edge& loadedEdge = loadedStructure.getHalfEdge(e);
+                rp3d_test(loadedEdge.vertexIndex == edge.vertexIndex);
+                rp3d_test(loadedEdge.twinEdgeIndex == edge.twinEdgeIndex);
+                rp3d_test(loadedEdge.faceIndex == edge.faceIndex);
+                rp3d_test(loadedEdge.nextEdgeIndex == edge.nextEdgeIndex);
+            }
+
+            // The structure is created as usual if the serialized structure is not the one of the
+            // polygons of the mesh or has another version
+            PolyhedronMesh otherMesh(mTetrahedronPolygonVertexArray, data.data(), size);
+            rp3d_test(otherMesh.getHalfEdgeStructure().getNbVertices() == 4);
+            rp3d_test(otherMesh.getHalfEdgeStructure().getNbHalfEdges() == 12);
+
+            data[4]++;
+            PolyhedronMesh otherVersionMesh(mPolygonVertexArray, data.data(), size);
+            rp3d_test(otherVersionMesh.getHalfEdgeStructure().getNbHalfEdges() == structure.getNbHalfEdges());
+        }
+
+        /// Test that the search of the support vertex by groups of lanes gives the same
+        /// result as a scalar loop over the vertices
+        void testSupportVertexLanes(PolyhedronMesh* mesh) {
+
+            uint nbDifferences = 0;
+
+            for (int i=0; i < 200; i++) {
+
+                const decimal angle = decimal(i) * decimal(0.1);
+                const Vector3 direction(std::cos(angle), std::sin(decimal(0.7) * angle), std::sin(angle));
+
+                decimal maxDotProduct = DECIMAL_SMALLEST;
+                for (uint v=0; v < mesh->getNbVertices(); v++) {
+                    maxDotProduct = std::max(maxDotProduct, direction.dot(mesh->getVertex(v)));
+                }
+
+                const uint supportVertex = mesh->computeSupportVertex(direction);
+                rp3d_test(supportVertex < mesh->getNbVertices());
+                if (!approxEqual(direction.dot(mesh->getVertex(supportVertex)), maxDotProduct, decimal(0.0001))) {
+                    nbDifferences++;
+                }
+            }
+
+            rp3d_test(nbDifferences == 0);
+        }
+
+        /// Test that the hill-climbing support function returns the same support point as
+        /// the search over all the vertices when the direction changes coherently or not
+        void testHillClimbingSupportPoint(const Vector3& scaling) {
+
+            TestableConvexMeshShape shape(mPolyhedronMesh, scaling);
+
+            uint cachedVertex = 0;
+            uint nbDifferences = 0;
+            uint nbDifferencesOutOfRangeCache = 0;
+
+            for (int i=0; i < 500; i++) {
+
+                // Direction that slowly rotates around the prism
+                const decimal angle = decimal(i) * decimal(0.05);
+                const Vector3 direction(std::cos(angle), std::sin(decimal(0.3) * angle), std::sin(angle));
+
+                const Vector3 bruteForcePoint = shape.getLocalSupportPointWithoutMargin(direction);
+                const Vector3 hillClimbingPoint = shape.getLocalSupportPointWithoutMarginFromVertex(direction,
+                                                                                                    cachedVertex);
+                if (!approxEqual(direction.dot(bruteForcePoint), direction.dot(hillClimbingPoint),
+                                 decimal(0.0001))) {
+                    nbDifferences++;
+                }
+
+                // A search from an invalid cached vertex must still find the support point
+                uint invalidVertex = 10000;
+                const Vector3 point = shape.getLocalSupportPointWithoutMarginFromVertex(-direction,
+                                                                                         invalidVertex);
+                if (!approxEqual((-direction).dot(shape.getLocalSupportPointWithoutMargin(-direction)),
+                                 (-direction).dot(point), decimal(0.0001))) {
+                    nbDifferencesOutOfRangeCache++;
+                }
+                rp3d_test(invalidVertex < uint(2 * NB_SIDES));
+            }
+
+            rp3d_test(nbDifferences == 0);
+            rp3d_test(nbDifferencesOutOfRangeCache == 0);
+        }
+ };
+
+}
+
+#endif
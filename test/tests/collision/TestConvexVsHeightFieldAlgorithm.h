@@ -0,0 +1,316 @@
+/********************************************************************************
+* ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
+* Copyright (c) 2010-2016 Daniel Chappuis                                       *
+*********************************************************************************
+*                                                                               *
+* This software is provided 'as-is', without any express or implied warranty.   *
+* In no event will the authors be held liable for any damages arising from the  *
+* use of this software.                                                         *
+*                                                                               *
+* Permission is granted to anyone to use this software for any purpose,         *
+* including commercial applications, and to alter it and redistribute it        *
+* freely, subject to the following restrictions:                                *
+*                                                                               *
+* 1. The origin of this software must not be misrepresented; you must not claim *
+*    that you wrote the original software. If you use this software in a        *
+*    product, an acknowledgment in the product documentation would be           *
+*    appreciated but is not required.                                           *
+*                                                                               *
+* 2. Altered source versions must be plainly marked as such, and must not be    *
+*    misrepresented as being the original software.                             *
+*                                                                               *
+* 3. This notice may not be removed or altered from any source distribution.    *
+*                                                                               *
+********************************************************************************/
+
+#ifndef TEST_CONVEX_VS_HEIGHT_FIELD_ALGORITHM_H
+#define TEST_CONVEX_VS_HEIGHT_FIELD_ALGORITHM_H
+
+// Libraries
+#include "Test.h"
+#include "engine/CollisionWorld.h"
+#include "engine/DynamicsWorld.h"
+#include "engine/OverlappingPair.h"
+#include "collision/NarrowPhaseInfo.h"
+#include "collision/ContactPointInfo.h"
+#include "collision/shapes/SphereShape.h"
+#include "collision/shapes/CapsuleShape.h"
+#include "collision/shapes/HeightFieldShape.h"
+#include "collision/narrowphase/ConvexVsHeightFieldAlgorithm.h"
+#include "memory/MemoryManager.h"
+
+/// Reactphysics3D namespace
+namespace reactphysics3d {
+
+// Class TestConvexVsHeightFieldAlgorithm
+/**
+ * Unit test for the sphere and capsule vs height field narrow-phase algorithm
+ */
+class TestConvexVsHeightFieldAlgorithm : public Test {
+
+    private :
+
+        // ---------- Atributes ---------- //
+
+        /// Number of columns and rows of the grids
+        static const int NB_POINTS = 5;
+
+        CollisionWorld* mWorld;
+        float mHeights[NB_POINTS * NB_POINTS];
+        uint8 mCellHoles[(NB_POINTS - 1) * (NB_POINTS - 1)];
+        HeightFieldShape* mHeightFieldShape;
+        HeightFieldShape* mZUpHeightFieldShape;
+        HeightFieldShape* mTiledHeightFieldShape;
+        SphereShape* mSphereShape;
+        CapsuleShape* mCapsuleShape;
+
+        // ---------- Methods ---------- //
+
+        /// Return the contact point with the largest penetration depth
+        static const ContactPointInfo* getDeepestContactPoint(const NarrowPhaseInfo* info) {
+
+            const ContactPointInfo* deepestPoint = info->contactPoints;
+            for (const ContactPointInfo* point = info->contactPoints; point != nullptr; point = point->next) {
+                if (point->penetrationDepth > deepestPoint->penetrationDepth) deepestPoint = point;
+            }
+            return deepestPoint;
+        }
+
+        /// Return true if each contact point is separated by its penetration depth along its normal
+        bool areContactPointsConsistent(const NarrowPhaseInfo* info) const {
+
+            bool isConsistent = info->contactPoints != nullptr;
+            for (const ContactPointInfo* point = info->contactPoints; point != nullptr; point = point->next) {
+                const Vector3 worldPoint1 = info->shape1ToWorldTransform * point->localPoint1;
+                const Vector3 worldPoint2 = info->shape2ToWorldTransform * point->localPoint2;
+                isConsistent &= point->penetrationDepth > decimal(0.0);
+                isConsistent &= approxEqual(worldPoint1 - worldPoint2, point->normal * point->penetrationDepth,
+                                            decimal(0.0001));
+            }
+            return isConsistent;
+        }
+
+        /// Test a pair of shapes with the convex vs height field algorithm and return the normal
+        /// and the penetration depth of the deepest contact point
+        bool testShapes(CollisionShape* collisionShape1, const Transform& transform1,
+                        CollisionShape* collisionShape2, const Transform& transform2,
+                        Vector3& outNormal, decimal& outPenetrationDepth) {
+
+            MemoryAllocator& allocator = MemoryManager::getBaseAllocator();
+            WorldSettings settings;
+
+            CollisionBody* body1 = mWorld->createCollisionBody(transform1);
+            CollisionBody* body2 = mWorld->createCollisionBody(transform2);
+            ProxyShape* shape1 = body1->addCollisionShape(collisionShape1, Transform::identity());
+            ProxyShape* shape2 = body2->addCollisionShape(collisionShape2, Transform::identity());
+
+            OverlappingPair pair(shape1, shape2, allocator, allocator, settings);
+            NarrowPhaseInfo info(&pair, collisionShape1, collisionShape2, transform1, transform2, allocator);
+
+            ConvexVsHeightFieldAlgorithm algorithm;
+            const bool isColliding = algorithm.testCollision(&info, true, allocator);
+
+            // The algorithm finds the same collision without computing the contacts
+            rp3d_test(algorithm.testCollision(&info, false, allocator) == isColliding);
+
+            if (isColliding) {
+                rp3d_test(areContactPointsConsistent(&info));
+                const ContactPointInfo* deepestPoint = getDeepestContactPoint(&info);
+                outNormal = deepestPoint->normal;
+                outPenetrationDepth = deepestPoint->penetrationDepth;
+            }
+
+            info.resetContactPoints();
+            mWorld->destroyCollisionBody(body1);
+            mWorld->destroyCollisionBody(body2);
+
+            return isColliding;
+        }
+
+    public :
+
+        // ---------- Methods ---------- //
+
+        /// Constructor
+        TestConvexVsHeightFieldAlgorithm(const std::string& name) : Test(name) {
+
+            // Flat grids with the heights at zero
+            for (int i=0; i < NB_POINTS * NB_POINTS; i++) {
+                mHeights[i] = 0.0f;
+            }
+
+            mWorld = new CollisionWorld();
+            mHeightFieldShape = new HeightFieldShape(NB_POINTS, NB_POINTS, -1, 1, mHeights,
+                                                     HeightFieldShape::HeightDataType::HEIGHT_FLOAT_TYPE);
+            mZUpHeightFieldShape = new HeightFieldShape(NB_POINTS, NB_POINTS, -1, 1, mHeights,
+                                                        HeightFieldShape::HeightDataType::HEIGHT_FLOAT_TYPE, 2);
+
+            // Tiled grid with a single tile and a hole at the cell (1, 1)
+            mTiledHeightFieldShape = new HeightFieldShape(NB_POINTS, NB_POINTS, NB_POINTS - 1, -1, 1,
+                                                          HeightFieldShape::HeightDataType::HEIGHT_FLOAT_TYPE);
+            for (int i=0; i < (NB_POINTS - 1) * (NB_POINTS - 1); i++) {
+                mCellHoles[i] = 0;
+            }
+            mCellHoles[1 * (NB_POINTS - 1) + 1] = 1;
+            mTiledHeightFieldShape->setTileData(0, 0, mHeights, mCellHoles);
+
+            mSphereShape = new SphereShape(decimal(0.5));
+            mCapsuleShape = new CapsuleShape(decimal(0.5), decimal(1.0));
+        }
+
+        /// Destructor
+        virtual ~TestConvexVsHeightFieldAlgorithm() {
+            delete mWorld;
+            delete mHeightFieldShape;
+            delete mZUpHeightFieldShape;
+            delete mTiledHeightFieldShape;
+            delete mSphereShape;
+            delete mCapsuleShape;
+        }
+
+        /// Run the tests
+        void run() override {
+            testSphere();
+            testCapsule();
+            testHoles();
+            testDynamicsWorld();
+        }
+
+        /// Test the contacts between a sphere and a height field
+        void testSphere() {
+
+            Vector3 normal;
+            decimal penetrationDepth;
+
+            // Sphere touching the height field (the normal goes from the height field to the sphere)
+            rp3d_test(testShapes(mHeightFieldShape, Transform::identity(),
+                                 mSphereShape, Transform(Vector3(decimal(0.3), decimal(0.4), decimal(0.2)), Quaternion::identity()),
+                                 normal, penetrationDepth));
+            rp3d_test(approxEqual(normal, Vector3(0, 1, 0), decimal(0.0001)));
+            rp3d_test(approxEqual(penetrationDepth, decimal(0.1), decimal(0.0001)));
+
+            // Same contact with the sphere as the first shape
+            rp3d_test(testShapes(mSphereShape, Transform(Vector3(decimal(0.3), decimal(0.4), decimal(0.2)), Quaternion::identity()),
+                                 mHeightFieldShape, Transform::identity(),
+                                 normal, penetrationDepth));
+            rp3d_test(approxEqual(normal, Vector3(0, -1, 0), decimal(0.0001)));
+            rp3d_test(approxEqual(penetrationDepth, decimal(0.1), decimal(0.0001)));
+
+            // Sphere with its center below the height field
+            rp3d_test(testShapes(mHeightFieldShape, Transform::identity(),
+                                 mSphereShape, Transform(Vector3(decimal(-0.6), decimal(-0.2), decimal(0.7)), Quaternion::identity()),
+                                 normal, penetrationDepth));
+            rp3d_test(approxEqual(normal, Vector3(0, 1, 0), decimal(0.0001)));
+            rp3d_test(approxEqual(penetrationDepth, decimal(0.7), decimal(0.0001)));
+
+            // Sphere touching the border of the height field
+            rp3d_test(testShapes(mHeightFieldShape, Transform::identity(),
+                                 mSphereShape, Transform(Vector3(decimal(2.3), 0, 0), Quaternion::identity()),
+                                 normal, penetrationDepth));
+            rp3d_test(approxEqual(penetrationDepth, decimal(0.2), decimal(0.0001)));
+
+            // Sphere above the height field
+            rp3d_test(!testShapes(mHeightFieldShape, Transform::identity(),
+                                  mSphereShape, Transform(Vector3(decimal(0.3), decimal(0.6), decimal(0.2)), Quaternion::identity()),
+                                  normal, penetrationDepth));
+
+            // Sphere touching a height field with the z up axis
+            rp3d_test(testShapes(mZUpHeightFieldShape, Transform::identity(),
+                                 mSphereShape, Transform(Vector3(decimal(0.3), decimal(0.2), decimal(0.4)), Quaternion::identity()),
+                                 normal, penetrationDepth));
+            rp3d_test(approxEqual(normal, Vector3(0, 0, 1), decimal(0.0001)));
+            rp3d_test(approxEqual(penetrationDepth, decimal(0.1), decimal(0.0001)));
+
+            // Sphere touching a rotated height field
+            const Quaternion rotation = Quaternion::fromEulerAngles(0, 0, PI * decimal(0.25));
+            rp3d_test(testShapes(mHeightFieldShape, Transform(Vector3::zero(), rotation),
+                                 mSphereShape, Transform(rotation * Vector3(decimal(0.3), decimal(0.4), decimal(0.2)), Quaternion::identity()),
+                                 normal, penetrationDepth));
+            rp3d_test(approxEqual(normal, rotation * Vector3(0, 1, 0), decimal(0.0001)));
+            rp3d_test(approxEqual(penetrationDepth, decimal(0.1), decimal(0.0001)));
+        }
+
+        /// Test the contacts between a capsule and a height field
+        void testCapsule() {
+
+            Vector3 normal;
+            decimal penetrationDepth;
+
+            // Capsule lying on the height field
+            const Quaternion lyingRotation = Quaternion::fromEulerAngles(0, 0, PI * decimal(0.5));
+            rp3d_test(testShapes(mHeightFieldShape, Transform::identity(),
+                                 mCapsuleShape, Transform(Vector3(decimal(0.1), decimal(0.4), decimal(0.3)), lyingRotation),
+                                 normal, penetrationDepth));
+            rp3d_test(approxEqual(normal, Vector3(0, 1, 0), decimal(0.0001)));
+            rp3d_test(approxEqual(penetrationDepth, decimal(0.1), decimal(0.0001)));
+
+            // Capsule standing on the height field
+            rp3d_test(testShapes(mCapsuleShape, Transform(Vector3(decimal(0.1), decimal(0.9), decimal(0.3)), Quaternion::identity()),
+                                 mHeightFieldShape, Transform::identity(),
+                                 normal, penetrationDepth));
+            rp3d_test(approxEqual(normal, Vector3(0, -1, 0), decimal(0.0001)));
+            rp3d_test(approxEqual(penetrationDepth, decimal(0.1), decimal(0.0001)));
+
+            // Capsule going through the height field (its lowest end point is pushed up)
+            rp3d_test(testShapes(mHeightFieldShape, Transform::identity(),
+                                 mCapsuleShape, Transform(Vector3(decimal(0.1), 0, decimal(0.3)), Quaternion::identity()),
+                                 normal, penetrationDepth));
+            rp3d_test(approxEqual(normal, Vector3(0, 1, 0), decimal(0.0001)));
+            rp3d_test(approxEqual(penetrationDepth, decimal(1.0), decimal(0.0001)));
+
+            // Capsule above the height field
+            rp3d_test(!testShapes(mHeightFieldShape, Transform::identity(),
+                                  mCapsuleShape, Transform(Vector3(decimal(0.1), decimal(0.6), decimal(0.3)), lyingRotation),
+                                  normal, penetrationDepth));
+        }
+
+        /// Test that the holes of a height field do not collide
+        void testHoles() {
+
+            Vector3 normal;
+            decimal penetrationDepth;
+            SphereShape smallSphere(decimal(0.2));
+
+            // The cell (1, 1) is the square between (-1, -1) and (0, 0) in the x-z plane
+            rp3d_test(!testShapes(mTiledHeightFieldShape, Transform::identity(),
+                                  &smallSphere, Transform(Vector3(decimal(-0.5), decimal(0.1), decimal(-0.5)), Quaternion::identity()),
+                                  normal, penetrationDepth));
+            rp3d_test(testShapes(mTiledHeightFieldShape, Transform::identity(),
+                                 &smallSphere, Transform(Vector3(decimal(0.5), decimal(0.1), decimal(0.5)), Quaternion::identity()),
+                                 normal, penetrationDepth));
+            rp3d_test(approxEqual(penetrationDepth, decimal(0.1), decimal(0.0001)));
+        }
+
+        /// Test a sphere and a capsule falling on a height field in a dynamics world
+        void testDynamicsWorld() {
+
+            DynamicsWorld world(Vector3(0, decimal(-9.81), 0));
+
+            RigidBody* ground = world.createRigidBody(Transform::identity());
+            ground->setType(BodyType::STATIC);
+            ground->addCollisionShape(mHeightFieldShape, Transform::identity(), decimal(1.0));
+            RigidBody* sphere = world.createRigidBody(Transform(Vector3(-1, 1, 0), Quaternion::identity()));
+            sphere->addCollisionShape(mSphereShape, Transform::identity(), decimal(1.0));
+            RigidBody* capsule = world.createRigidBody(Transform(Vector3(1, 2, 0), Quaternion::identity()));
+            capsule->addCollisionShape(mCapsuleShape, Transform::identity(), decimal(1.0));
+
+            uint nbHeightFieldTests = 0;
+            uint nbTriangleTests = 0;
+            for (int i=0; i < 120; i++) {
+                world.update(decimal(1.0) / decimal(60.0));
+                const NarrowPhaseStatistics& statistics = world.getStepStatistics().narrowPhase;
+                nbHeightFieldTests += statistics.nbConvexVsHeightFieldTests;
+                nbTriangleTests += statistics.nbSphereVsConvexPolyhedronTests + statistics.nbCapsuleVsConvexPolyhedronTests;
+            }
+
+            // The shapes rest on the height field without any triangle shape
+            rp3d_test(nbHeightFieldTests > 0);
+            rp3d_test(nbTriangleTests == 0);
+            rp3d_test(approxEqual(sphere->getTransform().getPosition().y, decimal(0.5), decimal(0.05)));
+            rp3d_test(approxEqual(capsule->getTransform().getPosition().y, decimal(1.0), decimal(0.05)));
+        }
+};
+
+}
+
+#endif
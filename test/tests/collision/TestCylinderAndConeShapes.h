@@ -0,0 +1,377 @@
+/********************************************************************************
+* ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
+* Copyright (c) 2010-2018 Daniel Chappuis                                       *
+*********************************************************************************
+*                                                                               *
+* This software is provided 'as-is', without any express or implied warranty.   *
+* In no event will the authors be held liable for any damages arising from the  *
+* use of this software.                                                         *
+*                                                                               *
+* Permission is granted to anyone to use this software for any purpose,         *
+* including commercial applications, and to alter it and redistribute it        *
+* freely, subject to the following restrictions:                                *
+*                                                                               *
+* 1. The origin of this software must not be misrepresented; you must not claim *
+*    that you wrote the original software. If you use this software in a        *
+*    product, an acknowledgment in the product documentation would be           *
+*    appreciated but is not required.                                           *
+*                                                                               *
+* 2. Altered source versions must be plainly marked as such, and must not be    *
+*    misrepresented as being the original software.                             *
+*                                                                               *
+* 3. This notice may not be removed or altered from any source distribution.    *
+*                                                                               *
+********************************************************************************/
+
+#ifndef TEST_CYLINDER_AND_CONE_SHAPES_H
+#define TEST_CYLINDER_AND_CONE_SHAPES_H
+
+// Libraries
+#include "Test.h"
+#include "engine/CollisionWorld.h"
+#include "engine/DynamicsWorld.h"
+#include "engine/OverlappingPair.h"
+#include "collision/NarrowPhaseInfo.h"
+#include "collision/ContactPointInfo.h"
+#include "collision/RaycastInfo.h"
+#include "collision/shapes/BoxShape.h"
+#include "collision/shapes/SphereShape.h"
+#include "collision/shapes/CylinderShape.h"
+#include "collision/shapes/ConeShape.h"
+#include "collision/narrowphase/ConvexVsImplicitConvexAlgorithm.h"
+#include "memory/MemoryManager.h"
+
+/// Reactphysics3D namespace
+namespace reactphysics3d {
+
+// Class TestCylinderAndConeShapes
+/**
+ * Unit test for the cylinder and cone collision shapes and for the convex vs
+ * implicit convex narrow-phase algorithm.
+ */
+class TestCylinderAndConeShapes : public Test {
+
+    private :
+
+        // ---------- Atributes ---------- //
+
+        CollisionWorld* mWorld;
+        CylinderShape* mCylinderShape;
+        ConeShape* mConeShape;
+        BoxShape* mBoxShape;
+        SphereShape* mSphereShape;
+
+        CollisionBody* mCylinderBody;
+        CollisionBody* mConeBody;
+        ProxyShape* mCylinderProxyShape;
+        ProxyShape* mConeProxyShape;
+
+        // ---------- Methods ---------- //
+
+        /// Return true if each contact point is separated by its penetration depth along its normal
+        bool areContactPointsConsistent(const NarrowPhaseInfo* info) const {
+
+            bool isConsistent = info->contactPoints != nullptr;
+            for (const ContactPointInfo* point = info->contactPoints; point != nullptr; point = point->next) {
+                const Vector3 worldPoint1 = info->shape1ToWorldTransform * point->localPoint1;
+                const Vector3 worldPoint2 = info->shape2ToWorldTransform * point->localPoint2;
+                isConsistent &= point->penetrationDepth > decimal(0.0);
+                isConsistent &= approxEqual(worldPoint1 - worldPoint2, point->normal * point->penetrationDepth,
+                                            decimal(0.001));
+            }
+            return isConsistent;
+        }
+
+        /// Test a pair of shapes with the convex vs implicit convex algorithm and return the
+        /// normal and penetration depth of the first contact point
+        bool testShapes(CollisionShape* collisionShape1, const Transform& transform1,
+                        CollisionShape* collisionShape2, const Transform& transform2,
+                        Vector3& outNormal, decimal& outPenetrationDepth) {
+
+            MemoryAllocator& allocator = MemoryManager::getBaseAllocator();
+            WorldSettings settings;
+
+            CollisionBody* body1 = mWorld->createCollisionBody(transform1);
+            CollisionBody* body2 = mWorld->createCollisionBody(transform2);
+            ProxyShape* shape1 = body1->addCollisionShape(collisionShape1, Transform::identity());
+            ProxyShape* shape2 = body2->addCollisionShape(collisionShape2, Transform::identity());
+
+            OverlappingPair pair(shape1, shape2, allocator, allocator, settings);
+            NarrowPhaseInfo info(&pair, collisionShape1, collisionShape2, transform1, transform2, allocator);
+
+            ConvexVsImplicitConvexAlgorithm algorithm;
+            const bool isColliding = algorithm.testCollision(&info, true, allocator);
+
+            if (isColliding) {
+                rp3d_test(areContactPointsConsistent(&info));
+                outNormal = info.contactPoints->normal;
+                outPenetrationDepth = info.contactPoints->penetrationDepth;
+            }
+
+            info.resetContactPoints();
+            mWorld->destroyCollisionBody(body1);
+            mWorld->destroyCollisionBody(body2);
+
+            return isColliding;
+        }
+
+    public :
+
+        // ---------- Methods ---------- //
+
+        /// Constructor
+        TestCylinderAndConeShapes(const std::string& name) : Test(name) {
+
+            mWorld = new CollisionWorld();
+            mCylinderShape = new CylinderShape(decimal(1.0), decimal(2.0));
+            mConeShape = new ConeShape(decimal(1.0), decimal(2.0));
+            mBoxShape = new BoxShape(Vector3(decimal(2.0), decimal(0.5), decimal(2.0)));
+            mSphereShape = new SphereShape(decimal(0.5));
+
+            mCylinderBody = mWorld->createCollisionBody(Transform(Vector3(10, 0, 0), Quaternion::identity()));
+            mCylinderProxyShape = mCylinderBody->addCollisionShape(mCylinderShape, Transform::identity());
+            mConeBody = mWorld->createCollisionBody(Transform(Vector3(-10, 0, 0), Quaternion::identity()));
+            mConeProxyShape = mConeBody->addCollisionShape(mConeShape, Transform::identity());
+        }
+
+        /// Destructor
+        virtual ~TestCylinderAndConeShapes() {
+            delete mWorld;
+            delete mCylinderShape;
+            delete mConeShape;
+            delete mBoxShape;
+            delete mSphereShape;
+        }
+
+        /// Run the tests
+        void run() {
+
+            testProperties();
+            testInertiaTensor();
+            testPointInside();
+            testRaycast();
+            testCollisions();
+            testDynamicsWorld();
+            testGJKSimplexWarmStart();
+        }
+
+        /// Test the type, the dimensions and the bounds of the shapes
+        void testProperties() {
+
+            rp3d_test(mCylinderShape->getType() == CollisionShapeType::IMPLICIT_CONVEX);
+            rp3d_test(mCylinderShape->getName() == CollisionShapeName::CYLINDER);
+            rp3d_test(mConeShape->getType() == CollisionShapeType::IMPLICIT_CONVEX);
+            rp3d_test(mConeShape->getName() == CollisionShapeName::CONE);
+            rp3d_test(mCylinderShape->isConvex() && !mCylinderShape->isPolyhedron());
+            rp3d_test(mConeShape->isConvex() && !mConeShape->isPolyhedron());
+
+            rp3d_test(approxEqual(mCylinderShape->getRadius(), decimal(1.0)));
+            rp3d_test(approxEqual(mCylinderShape->getHeight(), decimal(2.0)));
+            rp3d_test(approxEqual(mConeShape->getRadius(), decimal(1.0)));
+            rp3d_test(approxEqual(mConeShape->getHeight(), decimal(2.0)));
+
+            Vector3 min, max;
+            mCylinderShape->getLocalBounds(min, max);
+            rp3d_test(approxEqual(min, Vector3(-1, -1, -1), decimal(0.000001)));
+            rp3d_test(approxEqual(max, Vector3(1, 1, 1), decimal(0.000001)));
+
+            // The origin of the cone is its center of mass (a quarter of the height above the base)
+            mConeShape->getLocalBounds(min, max);
+            rp3d_test(approxEqual(min, Vector3(-1, decimal(-0.5), -1), decimal(0.000001)));
+            rp3d_test(approxEqual(max, Vector3(1, decimal(1.5), 1), decimal(0.000001)));
+        }
+
+        /// Test the inertia tensors of the shapes
+        void testInertiaTensor() {
+
+            Matrix3x3 tensor;
+            mCylinderShape->computeLocalInertiaTensor(tensor, decimal(2.0));
+            rp3d_test(approxEqual(tensor[0][0], decimal(7.0 / 6.0), decimal(0.00001)));
+            rp3d_test(approxEqual(tensor[1][1], decimal(1.0), decimal(0.00001)));
+            rp3d_test(approxEqual(tensor[2][2], decimal(7.0 / 6.0), decimal(0.00001)));
+            rp3d_test(approxEqual(tensor[0][1], decimal(0.0)) && approxEqual(tensor[1][2], decimal(0.0)));
+
+            mConeShape->computeLocalInertiaTensor(tensor, decimal(2.0));
+            rp3d_test(approxEqual(tensor[0][0], decimal(0.6), decimal(0.00001)));
+            rp3d_test(approxEqual(tensor[1][1], decimal(0.6), decimal(0.00001)));
+            rp3d_test(approxEqual(tensor[2][2], decimal(0.6), decimal(0.00001)));
+        }
+
+        /// Test the testPointInside() methods of the shapes
+        void testPointInside() {
+
+            const Vector3 cylinderCenter(10, 0, 0);
+            rp3d_test(mCylinderProxyShape->testPointInside(cylinderCenter + Vector3(0, decimal(0.9), 0)));
+            rp3d_test(mCylinderProxyShape->testPointInside(cylinderCenter + Vector3(decimal(0.9), 0, 0)));
+            rp3d_test(mCylinderProxyShape->testPointInside(cylinderCenter + Vector3(decimal(0.6), decimal(-0.9), decimal(0.6))));
+            rp3d_test(!mCylinderProxyShape->testPointInside(cylinderCenter + Vector3(decimal(0.8), 0, decimal(0.8))));
+            rp3d_test(!mCylinderProxyShape->testPointInside(cylinderCenter + Vector3(0, decimal(1.1), 0)));
+
+            const Vector3 coneCenter(-10, 0, 0);
+            rp3d_test(mConeProxyShape->testPointInside(coneCenter));
+            rp3d_test(mConeProxyShape->testPointInside(coneCenter + Vector3(0, decimal(1.4), 0)));
+            rp3d_test(mConeProxyShape->testPointInside(coneCenter + Vector3(decimal(0.9), decimal(-0.4), 0)));
+            rp3d_test(!mConeProxyShape->testPointInside(coneCenter + Vector3(0, decimal(1.6), 0)));
+            rp3d_test(!mConeProxyShape->testPointInside(coneCenter + Vector3(decimal(0.9), decimal(0.2), 0)));
+            rp3d_test(!mConeProxyShape->testPointInside(coneCenter + Vector3(0, decimal(-0.6), 0)));
+        }
+
+        /// Test the raycasting against the shapes
+        void testRaycast() {
+
+            const Vector3 cylinderCenter(10, 0, 0);
+
+            // Ray hitting the side of the cylinder
+            RaycastInfo raycastInfo1;
+            rp3d_test(mCylinderProxyShape->raycast(Ray(cylinderCenter + Vector3(5, 0, 0), cylinderCenter + Vector3(-5, 0, 0)),
+                                                   raycastInfo1));
+            rp3d_test(raycastInfo1.proxyShape == mCylinderProxyShape);
+            rp3d_test(approxEqual(raycastInfo1.hitFraction, decimal(0.4), decimal(0.0001)));
+            rp3d_test(approxEqual(raycastInfo1.worldPoint, cylinderCenter + Vector3(1, 0, 0), decimal(0.0001)));
+            rp3d_test(approxEqual(raycastInfo1.worldNormal, Vector3(1, 0, 0), decimal(0.0001)));
+
+            // Ray hitting the top cap of the cylinder
+            RaycastInfo raycastInfo2;
+            rp3d_test(mCylinderProxyShape->raycast(Ray(cylinderCenter + Vector3(decimal(0.5), 5, 0),
+                                                       cylinderCenter + Vector3(decimal(0.5), -5, 0)), raycastInfo2));
+            rp3d_test(approxEqual(raycastInfo2.hitFraction, decimal(0.4), decimal(0.0001)));
+            rp3d_test(approxEqual(raycastInfo2.worldNormal, Vector3(0, 1, 0), decimal(0.0001)));
+
+            // Rays missing the cylinder, starting inside it or too short
+            RaycastInfo raycastInfo3;
+            rp3d_test(!mCylinderProxyShape->raycast(Ray(cylinderCenter + Vector3(5, 2, 0), cylinderCenter + Vector3(-5, 2, 0)),
+                                                    raycastInfo3));
+            rp3d_test(!mCylinderProxyShape->raycast(Ray(cylinderCenter, cylinderCenter + Vector3(5, 0, 0)), raycastInfo3));
+            rp3d_test(!mCylinderProxyShape->raycast(Ray(cylinderCenter + Vector3(5, 0, 0), cylinderCenter + Vector3(-5, 0, 0),
+                                                        decimal(0.3)), raycastInfo3));
+
+            const Vector3 coneCenter(-10, 0, 0);
+
+            // Ray hitting the base of the cone
+            RaycastInfo raycastInfo4;
+            rp3d_test(mConeProxyShape->raycast(Ray(coneCenter + Vector3(0, -5, 0), coneCenter + Vector3(0, 5, 0)), raycastInfo4));
+            rp3d_test(approxEqual(raycastInfo4.hitFraction, decimal(0.45), decimal(0.0001)));
+            rp3d_test(approxEqual(raycastInfo4.worldNormal, Vector3(0, -1, 0), decimal(0.0001)));
+
+            // Ray hitting the lateral surface of the cone
+            RaycastInfo raycastInfo5;
+            rp3d_test(mConeProxyShape->raycast(Ray(coneCenter + Vector3(5, 0, 0), coneCenter + Vector3(-5, 0, 0)), raycastInfo5));
+            rp3d_test(approxEqual(raycastInfo5.hitFraction, decimal(0.425), decimal(0.0001)));
+            rp3d_test(approxEqual(raycastInfo5.worldPoint, coneCenter + Vector3(decimal(0.75), 0, 0), decimal(0.0001)));
+            rp3d_test(approxEqual(raycastInfo5.worldNormal, Vector3(2, 1, 0).getUnit(), decimal(0.0001)));
+
+            // Rays missing the cone (above the apex) or starting inside it
+            RaycastInfo raycastInfo6;
+            rp3d_test(!mConeProxyShape->raycast(Ray(coneCenter + Vector3(5, decimal(1.6), 0), coneCenter + Vector3(-5, decimal(1.6), 0)),
+                                                raycastInfo6));
+            rp3d_test(!mConeProxyShape->raycast(Ray(coneCenter, coneCenter + Vector3(5, 0, 0)), raycastInfo6));
+        }
+
+        /// Test the contacts computed by the convex vs implicit convex algorithm
+        void testCollisions() {
+
+            Vector3 normal;
+            decimal penetrationDepth;
+
+            // Cylinder standing on a box with a penetration inside the margins (GJK)
+            rp3d_test(testShapes(mBoxShape, Transform::identity(),
+                                 mCylinderShape, Transform(Vector3(decimal(0.3), decimal(1.48), 0), Quaternion::identity()),
+                                 normal, penetrationDepth));
+            rp3d_test(approxEqual(normal, Vector3(0, 1, 0), decimal(0.001)));
+            rp3d_test(approxEqual(penetrationDepth, decimal(0.02), decimal(0.001)));
+
+            // Cylinder deeply penetrating the box (EPA)
+            rp3d_test(testShapes(mBoxShape, Transform::identity(),
+                                 mCylinderShape, Transform(Vector3(decimal(0.3), decimal(1.2), 0), Quaternion::identity()),
+                                 normal, penetrationDepth));
+            rp3d_test(approxEqual(normal, Vector3(0, 1, 0), decimal(0.001)));
+            rp3d_test(approxEqual(penetrationDepth, decimal(0.3), decimal(0.001)));
+
+            // Cylinder above the box
+            rp3d_test(!testShapes(mBoxShape, Transform::identity(),
+                                  mCylinderShape, Transform(Vector3(0, decimal(1.6), 0), Quaternion::identity()),
+                                  normal, penetrationDepth));
+
+            // Sphere touching the base of the cone
+            rp3d_test(testShapes(mConeShape, Transform::identity(),
+                                 mSphereShape, Transform(Vector3(decimal(0.2), decimal(-0.9), 0), Quaternion::identity()),
+                                 normal, penetrationDepth));
+            rp3d_test(approxEqual(normal, Vector3(0, -1, 0), decimal(0.001)));
+            rp3d_test(approxEqual(penetrationDepth, decimal(0.1), decimal(0.001)));
+
+            // Cylinder lying across another one
+            rp3d_test(testShapes(mCylinderShape, Transform::identity(),
+                                 mCylinderShape, Transform(Vector3(0, decimal(1.8), 0),
+                                                           Quaternion::fromEulerAngles(0, 0, PI * decimal(0.5))),
+                                 normal, penetrationDepth));
+            rp3d_test(approxEqual(normal, Vector3(0, 1, 0), decimal(0.001)));
+            rp3d_test(approxEqual(penetrationDepth, decimal(0.2), decimal(0.001)));
+        }
+
+        /// Test a cylinder falling on a box in a dynamics world
+        void testDynamicsWorld() {
+
+            DynamicsWorld world(Vector3(0, decimal(-9.81), 0));
+
+            RigidBody* floor = world.createRigidBody(Transform(Vector3(0, 0, 0), Quaternion::identity()));
+            floor->setType(BodyType::STATIC);
+            floor->addCollisionShape(mBoxShape, Transform::identity(), decimal(1.0));
+            RigidBody* cylinder = world.createRigidBody(Transform(Vector3(0, decimal(2.0), 0), Quaternion::identity()));
+            cylinder->addCollisionShape(mCylinderShape, Transform::identity(), decimal(1.0));
+
+            uint nbImplicitConvexTests = 0;
+            for (int i=0; i < 120; i++) {
+                world.update(decimal(1.0) / decimal(60.0));
+                nbImplicitConvexTests += world.getStepStatistics().narrowPhase.nbConvexVsImplicitConvexTests;
+            }
+
+            // The cylinder rests on the box (its center is one meter above the face of the box
+            // whether it stands on a cap or lies on its side)
+            rp3d_test(nbImplicitConvexTests > 0);
+            rp3d_test(approxEqual(cylinder->getTransform().getPosition().y, decimal(1.5), decimal(0.05)));
+        }
+
+        /// Test the GJK algorithm started from the simplex of the previous frame
+        void testGJKSimplexWarmStart() {
+
+            uint nbGJKTests[2] = {0, 0};
+            uint nbGJKIterations[2] = {0, 0};
+            uint nbGJKWarmStarts[2] = {0, 0};
+
+            for (int k=0; k < 2; k++) {
+
+                WorldSettings settings;
+                settings.isGJKSimplexWarmStartEnabled = (k == 1);
+                DynamicsWorld world(Vector3(0, decimal(-9.81), 0), settings);
+
+                RigidBody* floor = world.createRigidBody(Transform(Vector3(0, 0, 0), Quaternion::identity()));
+                floor->setType(BodyType::STATIC);
+                floor->addCollisionShape(mBoxShape, Transform::identity(), decimal(1.0));
+                RigidBody* cylinder = world.createRigidBody(Transform(Vector3(0, decimal(2.0), 0), Quaternion::identity()));
+                cylinder->addCollisionShape(mCylinderShape, Transform::identity(), decimal(1.0));
+
+                for (int i=0; i < 120; i++) {
+                    world.update(decimal(1.0) / decimal(60.0));
+                    const NarrowPhaseStatistics& statistics = world.getStepStatistics().narrowPhase;
+                    nbGJKTests[k] += statistics.nbGJKTests;
+                    nbGJKIterations[k] += statistics.nbGJKIterations;
+                    nbGJKWarmStarts[k] += statistics.nbGJKWarmStarts;
+                }
+
+                // The warm start does not change the resting position of the cylinder
+                rp3d_test(approxEqual(cylinder->getTransform().getPosition().y, decimal(1.5), decimal(0.05)));
+            }
+
+            // Only the world with the warm start reuses the simplices of the previous frames
+            rp3d_test(nbGJKTests[0] > 0 && nbGJKTests[1] > 0);
+            rp3d_test(nbGJKWarmStarts[0] == 0);
+            rp3d_test(nbGJKWarmStarts[1] > 0);
+
+            // The warm start reduces the average number of iterations of the GJK algorithm
+            rp3d_test(nbGJKIterations[1] * nbGJKTests[0] < nbGJKIterations[0] * nbGJKTests[1]);
+        }
+};
+
+}
+
+#endif
@@ -29,8 +29,10 @@
 // Libraries
 #include "Test.h"
 #include "collision/broadphase/DynamicAABBTree.h"
+#include "collision/broadphase/WideAABBTree.h"
 #include "memory/MemoryManager.h"
 #include "utils/Profiler.h"
+#include "engine/DefaultTaskScheduler.h"
 
 /// Reactphysics3D namespace
 namespace reactphysics3d {
@@ -106,6 +108,14 @@ class TestDynamicAABBTree : public Test {
             testBasicsMethods();
             testOverlapping();
             testRaycast();
+            testWideAABBTree();
+            testRebuildWithSAH();
+            testBulkBuild();
+            testIncrementalRefinement();
+            testSubTreeInsertion();
+            testDeferredReinsertion();
+            testStatistics();
+            testQueryContext();
 
         }
 
@@ -540,6 +550,562 @@ class TestDynamicAABBTree : public Test {
             rp3d_test(mRaycastCallback.isHit(object3Id));
             rp3d_test(mRaycastCallback.isHit(object4Id));
 
+#ifdef IS_PROFILING_ACTIVE
+			delete profiler;
+#endif
+        }
+
+        /// Return true if the two lists contain the same node IDs
+        static bool isSameNodes(std::vector<int> nodes1, std::vector<int> nodes2) {
+            std::sort(nodes1.begin(), nodes1.end());
+            std::sort(nodes2.begin(), nodes2.end());
+            return nodes1 == nodes2;
+        }
+
+        void testWideAABBTree() {
+
+            DynamicAABBTree tree(MemoryManager::getBaseAllocator());
+            WideAABBTree wideTree(MemoryManager::getBaseAllocator());
+
+#ifdef IS_PROFILING_ACTIVE
+			/// Pointer to the profiler
+			Profiler* profiler = new Profiler();
+			tree.setProfiler(profiler);
+			wideTree.setProfiler(profiler);
+#endif
+
+            TestOverlapCallback wideOverlapCallback;
+            DynamicTreeRaycastCallback wideRaycastCallback;
+
+            // An empty wide tree does not report anything
+            wideTree.build(tree);
+            wideTree.reportAllShapesOverlappingWithAABB(AABB(Vector3(-100, -100, -100), Vector3(100, 100, 100)),
+                                                        wideOverlapCallback);
+            rp3d_test(wideOverlapCallback.mOverlapNodes.empty());
+
+            // A wide tree with a single object
+            int data = 1;
+            const int objectId = tree.addObject(AABB(Vector3(0, 0, 0), Vector3(1, 1, 1)), &data);
+            wideTree.build(tree);
+            wideTree.reportAllShapesOverlappingWithAABB(AABB(Vector3(-1, -1, -1), Vector3(2, 2, 2)), wideOverlapCallback);
+            rp3d_test(wideOverlapCallback.mOverlapNodes.size() == 1 && wideOverlapCallback.isOverlapping(objectId));
+            tree.removeObject(objectId);
+
+            // Add a grid of objects and remove some of them
+            std::vector<int> objectIds;
+            for (int x=0; x < 10; x++) {
+                for (int y=0; y < 10; y++) {
+                    for (int z=0; z < 3; z++) {
+                        const Vector3 min(decimal(3 * x), decimal(3 * y) + decimal(0.1) * decimal(x), decimal(4 * z));
+                        const Vector3 size(decimal(1 + (x + z) % 3), decimal(1 + y % 2), decimal(2));
+                        objectIds.push_back(tree.addObject(AABB(min, min + size), &data));
+                    }
+                }
+            }
+            for (uint i=0; i < objectIds.size(); i += 7) {
+                tree.removeObject(objectIds[i]);
+            }
+            wideTree.build(tree);
+
+            // The wide tree has about a third as many nodes as objects
+            rp3d_test(wideTree.getNbNodes() > 0);
+            rp3d_test(wideTree.getNbNodes() < objectIds.size() / 2);
+
+            // The wide tree reports the same overlapping nodes as the dynamic tree
+            for (int i=0; i < 20; i++) {
+                const Vector3 min(decimal(i * 1.7 - 5), decimal(i * 1.3 - 3), decimal(i % 5) * decimal(2.5) - decimal(2));
+                const AABB aabb(min, min + Vector3(decimal(4 + i % 3), decimal(2 + i % 4), decimal(3)));
+                mOverlapCallback.reset();
+                wideOverlapCallback.reset();
+                tree.reportAllShapesOverlappingWithAABB(aabb, mOverlapCallback);
+                wideTree.reportAllShapesOverlappingWithAABB(aabb, wideOverlapCallback);
+                rp3d_test(isSameNodes(mOverlapCallback.mOverlapNodes, wideOverlapCallback.mOverlapNodes));
+            }
+
+            // The wide tree reports the same nodes hit by the rays as the dynamic tree
+            size_t nbHits = 0;
+            for (int i=0; i < 20; i++) {
+                const Ray ray(Vector3(decimal(-5), decimal(i * 1.5), decimal(i % 4) * decimal(3)),
+                              Vector3(decimal(40), decimal(30 - i), decimal(6 - i % 3)), decimal(0.2) + decimal(i) * decimal(0.04));
+                mRaycastCallback.reset();
+                wideRaycastCallback.reset();
+                tree.raycast(ray, mRaycastCallback);
+                wideTree.raycast(ray, wideRaycastCallback);
+                rp3d_test(isSameNodes(mRaycastCallback.mHitNodes, wideRaycastCallback.mHitNodes));
+                nbHits += wideRaycastCallback.mHitNodes.size();
+            }
+            rp3d_test(nbHits > 0);
+
+#ifdef IS_PROFILING_ACTIVE
+			delete profiler;
+#endif
+        }
+
+        void testRebuildWithSAH() {
+
+            DynamicAABBTree tree(MemoryManager::getBaseAllocator());
+
+#ifdef IS_PROFILING_ACTIVE
+			/// Pointer to the profiler
+			Profiler* profiler = new Profiler();
+			tree.setProfiler(profiler);
+#endif
+
+            int data = 1;
+
+            // Rebuilding an empty tree does nothing
+            tree.rebuildWithSAH();
+            mOverlapCallback.reset();
+            tree.reportAllShapesOverlappingWithAABB(AABB(Vector3(-100, -100, -100), Vector3(100, 100, 100)), mOverlapCallback);
+            rp3d_test(mOverlapCallback.mOverlapNodes.empty());
+
+            // Add a grid of objects
+            std::vector<int> objectIds;
+            for (int x=0; x < 12; x++) {
+                for (int z=0; z < 12; z++) {
+                    const Vector3 min(decimal(2 * x), decimal((x * z) % 3), decimal(2 * z));
+                    objectIds.push_back(tree.addObject(AABB(min, min + Vector3(decimal(1 + x % 2), 1, 1)), &data));
+                }
+            }
+
+            // Compute the overlapping nodes before the rebuild
+            std::vector<std::vector<int>> overlapNodes;
+            for (int i=0; i < 10; i++) {
+                const Vector3 min(decimal(i * 2.3 - 2), decimal(-1), decimal(i * 1.9 - 1));
+                mOverlapCallback.reset();
+                tree.reportAllShapesOverlappingWithAABB(AABB(min, min + Vector3(5, 3, 4)), mOverlapCallback);
+                overlapNodes.push_back(mOverlapCallback.mOverlapNodes);
+            }
+
+            tree.rebuildWithSAH();
+
+            // The objects keep their IDs and their fat AABBs
+            for (uint i=0; i < objectIds.size(); i++) {
+                const AABB& fatAABB = tree.getFatAABB(objectIds[i]);
+                rp3d_test(tree.getNodeDataPointer(objectIds[i]) == &data);
+                rp3d_test(fatAABB.getMax().y - fatAABB.getMin().y == decimal(1));
+            }
+
+            // The rebuilt tree reports the same overlapping nodes
+            for (int i=0; i < 10; i++) {
+                const Vector3 min(decimal(i * 2.3 - 2), decimal(-1), decimal(i * 1.9 - 1));
+                mOverlapCallback.reset();
+                tree.reportAllShapesOverlappingWithAABB(AABB(min, min + Vector3(5, 3, 4)), mOverlapCallback);
+                rp3d_test(isSameNodes(overlapNodes[i], mOverlapCallback.mOverlapNodes));
+            }
+
+            // The rebuilt tree can still be modified
+            tree.removeObject(objectIds[0]);
+            const int newObjectId = tree.addObject(AABB(Vector3(-10, -10, -10), Vector3(-9, -9, -9)), &data);
+            mOverlapCallback.reset();
+            tree.reportAllShapesOverlappingWithAABB(AABB(Vector3(-11, -11, -11), Vector3(0.5, 0.5, 0.5)), mOverlapCallback);
+            rp3d_test(mOverlapCallback.mOverlapNodes.size() == 1 && mOverlapCallback.isOverlapping(newObjectId));
+
+#ifdef IS_PROFILING_ACTIVE
+			delete profiler;
+#endif
+        }
+
+        /// Return the AABB of the i-th object of the bulk build test
+        static AABB getBulkObjectAABB(int i) {
+            const Vector3 min(decimal((i * 37) % 101), decimal((i * 13) % 29), decimal((i * 71) % 97));
+            return AABB(min, min + Vector3(decimal(1 + i % 3), decimal(1 + i % 2), 1));
+        }
+
+        /// Report the overlapping nodes of the queries of the bulk build test
+        std::vector<std::vector<int>> computeBulkOverlapNodes(const DynamicAABBTree& tree) {
+            std::vector<std::vector<int>> overlapNodes;
+            for (int i=0; i < 20; i++) {
+                const Vector3 min(decimal(i * 5.3), decimal(i % 7), decimal(i * 4.1));
+                mOverlapCallback.reset();
+                tree.reportAllShapesOverlappingWithAABB(AABB(min, min + Vector3(6, 4, 5)), mOverlapCallback);
+                overlapNodes.push_back(mOverlapCallback.mOverlapNodes);
+            }
+            mRaycastCallback.reset();
+            tree.raycast(Ray(Vector3(-1, 5, -1), Vector3(110, 5, 110)), mRaycastCallback);
+            overlapNodes.push_back(mRaycastCallback.mHitNodes);
+            return overlapNodes;
+        }
+
+        static bool isSameOverlapNodes(const std::vector<std::vector<int>>& nodes1,
+                                       const std::vector<std::vector<int>>& nodes2) {
+            if (nodes1.size() != nodes2.size()) return false;
+            for (uint i=0; i < nodes1.size(); i++) {
+                if (!isSameNodes(nodes1[i], nodes2[i])) return false;
+            }
+            return true;
+        }
+
+        void testBulkBuild() {
+
+            const int nbObjects = 5000;
+            int data = 1;
+
+            DynamicAABBTree incrementalTree(MemoryManager::getBaseAllocator());
+            DynamicAABBTree tree(MemoryManager::getBaseAllocator());
+            DynamicAABBTree parallelTree(MemoryManager::getBaseAllocator());
+
+#ifdef IS_PROFILING_ACTIVE
+			/// Pointer to the profiler
+			Profiler* profiler = new Profiler();
+			incrementalTree.setProfiler(profiler);
+			tree.setProfiler(profiler);
+			parallelTree.setProfiler(profiler);
+#endif
+
+            for (int i=0; i < nbObjects; i++) {
+                incrementalTree.addObject(getBulkObjectAABB(i), &data);
+                rp3d_test(tree.addObjectDeferred(getBulkObjectAABB(i), &data) ==
+                          parallelTree.addObjectDeferred(getBulkObjectAABB(i), &data));
+            }
+            rp3d_test(tree.hasDeferredObjects());
+            rp3d_test(tree.getNbObjects() == nbObjects);
+
+            // The deferred objects are reported by the queries before their insertion
+            const std::vector<std::vector<int>> overlapNodes = computeBulkOverlapNodes(tree);
+            std::vector<std::vector<int>> incrementalOverlapNodes = computeBulkOverlapNodes(incrementalTree);
+            for (uint i=0; i < overlapNodes.size(); i++) {
+                rp3d_test(overlapNodes[i].size() == incrementalOverlapNodes[i].size());
+            }
+
+            // Build the trees sequentially and in parallel
+            tree.insertDeferredObjects();
+            DefaultTaskScheduler scheduler(4);
+            parallelTree.insertDeferredObjects(&scheduler);
+            rp3d_test(!tree.hasDeferredObjects() && !parallelTree.hasDeferredObjects());
+            rp3d_test(tree.getNbObjects() == nbObjects && parallelTree.getNbObjects() == nbObjects);
+
+            // The built trees report the same nodes and the parallel build gives the same tree
+            rp3d_test(isSameOverlapNodes(overlapNodes, computeBulkOverlapNodes(tree)));
+            rp3d_test(isSameOverlapNodes(overlapNodes, computeBulkOverlapNodes(parallelTree)));
+            rp3d_test(approxEqual(tree.computeCost(), parallelTree.computeCost(), decimal(0.001) * tree.computeCost()));
+
+            // The tree built with the surface area heuristic is better than the incremental one
+            rp3d_test(tree.computeCost() < incrementalTree.computeCost());
+
+            // A few deferred objects are inserted one by one and can be updated or
+            // removed before their insertion
+            const int object1Id = tree.addObjectDeferred(AABB(Vector3(-10, -10, -10), Vector3(-9, -9, -9)), &data);
+            const int object2Id = tree.addObjectDeferred(AABB(Vector3(-20, -20, -20), Vector3(-19, -19, -19)), &data);
+            tree.removeObject(object2Id);
+            rp3d_test(tree.updateObject(object1Id, AABB(Vector3(-30, -10, -10), Vector3(-29, -9, -9)), Vector3::zero()));
+            rp3d_test(tree.getNbObjects() == nbObjects + 1);
+            mOverlapCallback.reset();
+            tree.reportAllShapesOverlappingWithAABB(AABB(Vector3(-40, -40, -40), Vector3(-5, -5, -5)), mOverlapCallback);
+            rp3d_test(mOverlapCallback.mOverlapNodes.size() == 1 && mOverlapCallback.isOverlapping(object1Id));
+            tree.insertDeferredObjects();
+            mOverlapCallback.reset();
+            tree.reportAllShapesOverlappingWithAABB(AABB(Vector3(-40, -40, -40), Vector3(-5, -5, -5)), mOverlapCallback);
+            rp3d_test(mOverlapCallback.mOverlapNodes.size() == 1 && mOverlapCallback.isOverlapping(object1Id));
+            rp3d_test(tree.getNbObjects() == nbObjects + 1);
+
+#ifdef IS_PROFILING_ACTIVE
+			delete profiler;
+#endif
+        }
+
+        void testIncrementalRefinement() {
+
+            const int nbObjects = 2000;
+            int data = 1;
+
+            DynamicAABBTree tree(MemoryManager::getBaseAllocator());
+
+#ifdef IS_PROFILING_ACTIVE
+			/// Pointer to the profiler
+			Profiler* profiler = new Profiler();
+			tree.setProfiler(profiler);
+#endif
+
+            // Insert the objects and move them so that the tree degrades
+            std::vector<int> objectIds;
+            for (int i=0; i < nbObjects; i++) {
+                objectIds.push_back(tree.addObject(getBulkObjectAABB(i), &data));
+            }
+            for (int i=0; i < nbObjects; i++) {
+                tree.updateObject(objectIds[i], getBulkObjectAABB((i * 7) % nbObjects), Vector3::zero(), true);
+            }
+            const std::vector<std::vector<int>> overlapNodes = computeBulkOverlapNodes(tree);
+            const decimal cost = tree.computeCost();
+
+            // A pass of refinement reinserts every leaf in small groups
+            tree.startIncrementalRefinement();
+            int nbReinsertedLeaves = 0;
+            int nbCalls = 0;
+            bool isPassDone = false;
+            while (!isPassDone) {
+                int nbLeaves;
+                isPassDone = tree.refineIncrementally(64, nbLeaves);
+                rp3d_test(nbLeaves <= 64);
+                nbReinsertedLeaves += nbLeaves;
+                nbCalls++;
+            }
+            rp3d_test(nbReinsertedLeaves == nbObjects);
+            rp3d_test(nbCalls > 1);
+
+            // The refined tree reports the same nodes and is not worse than before
+            rp3d_test(tree.getNbObjects() == nbObjects);
+            rp3d_test(isSameOverlapNodes(overlapNodes, computeBulkOverlapNodes(tree)));
+            rp3d_test(tree.computeCost() <= cost);
+
+#ifdef IS_PROFILING_ACTIVE
+			delete profiler;
+#endif
+        }
+
+        void testSubTreeInsertion() {
+
+            const int nbObjects = 2000;
+            const int nbGroupObjects = 300;
+            int data = 1;
+
+            DynamicAABBTree tree(MemoryManager::getBaseAllocator());
+
+#ifdef IS_PROFILING_ACTIVE
+			/// Pointer to the profiler
+			Profiler* profiler = new Profiler();
+			tree.setProfiler(profiler);
+#endif
+
+            for (int i=0; i < nbObjects; i++) {
+                tree.addObject(getBulkObjectAABB(i), &data);
+            }
+            const std::vector<std::vector<int>> overlapNodes = computeBulkOverlapNodes(tree);
+
+            // Add a group of objects and graft them into the tree as a sub-tree
+            std::vector<int> groupObjectIds;
+            for (int i=0; i < nbGroupObjects; i++) {
+                groupObjectIds.push_back(tree.addObjectDeferred(getBulkObjectAABB(nbObjects + i), &data));
+            }
+            const std::vector<std::vector<int>> groupOverlapNodes = computeBulkOverlapNodes(tree);
+            tree.insertDeferredObjectsAsSubTree();
+            rp3d_test(!tree.hasDeferredObjects());
+            rp3d_test(tree.getNbObjects() == nbObjects + nbGroupObjects);
+            rp3d_test(isSameOverlapNodes(groupOverlapNodes, computeBulkOverlapNodes(tree)));
+
+            // A single object is grafted like a leaf
+            const int objectId = tree.addObjectDeferred(AABB(Vector3(-10, -10, -10), Vector3(-9, -9, -9)), &data);
+            tree.insertDeferredObjectsAsSubTree();
+            mOverlapCallback.reset();
+            tree.reportAllShapesOverlappingWithAABB(AABB(Vector3(-40, -40, -40), Vector3(-5, -5, -5)), mOverlapCallback);
+            rp3d_test(mOverlapCallback.mOverlapNodes.size() == 1 && mOverlapCallback.isOverlapping(objectId));
+            tree.removeObject(objectId);
+
+            // The objects of the group can be removed from the tree
+            for (uint i=0; i < groupObjectIds.size(); i++) {
+                tree.removeObject(groupObjectIds[i]);
+            }
+            rp3d_test(tree.getNbObjects() == nbObjects);
+            rp3d_test(isSameOverlapNodes(overlapNodes, computeBulkOverlapNodes(tree)));
+
+#ifdef IS_PROFILING_ACTIVE
+			delete profiler;
+#endif
+        }
+
+        void testDeferredReinsertion() {
+
+            const int nbObjects = 2000;
+            int data = 1;
+
+            DynamicAABBTree incrementalTree(MemoryManager::getBaseAllocator());
+            DynamicAABBTree tree(MemoryManager::getBaseAllocator());
+
+#ifdef IS_PROFILING_ACTIVE
+			/// Pointer to the profiler
+			Profiler* profiler = new Profiler();
+			incrementalTree.setProfiler(profiler);
+			tree.setProfiler(profiler);
+#endif
+
+            std::vector<int> objectIds;
+            for (int i=0; i < nbObjects; i++) {
+                incrementalTree.addObject(getBulkObjectAABB(i), &data);
+                objectIds.push_back(tree.addObject(getBulkObjectAABB(i), &data));
+            }
+
+            // An object that stays inside its fat AABB is not removed from the tree
+            const decimal gap = DYNAMIC_TREE_AABB_GAP;
+            rp3d_test(!tree.updateObject(objectIds[0], getBulkObjectAABB(0), Vector3::zero(), gap, false, true));
+            rp3d_test(!tree.hasDeferredObjects());
+
+            // Move a few objects (inserted one by one) and then most of the objects (the tree
+            // is built again). The moved objects are reported by the queries before their insertion.
+            const int nbMovedObjects[2] = {100, 1500};
+            for (int m=0; m < 2; m++) {
+
+                for (int i=0; i < nbMovedObjects[m]; i++) {
+                    const AABB aabb = getBulkObjectAABB((i * 7 + m) % nbObjects);
+                    incrementalTree.updateObject(objectIds[i], aabb, Vector3::zero(), gap, true);
+                    rp3d_test(tree.updateObject(objectIds[i], aabb, Vector3::zero(), gap, true, true));
+                }
+
+                // A deferred object can move again before its insertion
+                const AABB aabb = getBulkObjectAABB((nbMovedObjects[m] + m) % nbObjects);
+                incrementalTree.updateObject(objectIds[0], aabb, Vector3::zero(), gap, true);
+                rp3d_test(tree.updateObject(objectIds[0], aabb, Vector3::zero(), gap, true, true));
+
+                rp3d_test(tree.hasDeferredObjects());
+                rp3d_test(tree.getNbObjects() == nbObjects);
+                const std::vector<std::vector<int>> overlapNodes = computeBulkOverlapNodes(incrementalTree);
+                rp3d_test(isSameOverlapNodes(overlapNodes, computeBulkOverlapNodes(tree)));
+
+                tree.insertDeferredObjects();
+                rp3d_test(!tree.hasDeferredObjects());
+                rp3d_test(tree.getNbObjects() == nbObjects);
+                rp3d_test(isSameOverlapNodes(overlapNodes, computeBulkOverlapNodes(tree)));
+            }
+
+#ifdef IS_PROFILING_ACTIVE
+			delete profiler;
+#endif
+        }
+
+        void testStatistics() {
+
+            DynamicAABBTree tree(MemoryManager::getBaseAllocator());
+
+#ifdef IS_PROFILING_ACTIVE
+			/// Pointer to the profiler
+			Profiler* profiler = new Profiler();
+			tree.setProfiler(profiler);
+#endif
+
+            int data = 1;
+            DynamicAABBTreeStatistics statistics;
+
+            // Empty tree
+            tree.computeStatistics(statistics);
+            rp3d_test(statistics.nbNodes == 0);
+            rp3d_test(statistics.nbLeaves == 0);
+            rp3d_test(statistics.height == 0);
+            rp3d_test(statistics.cost == decimal(0.0));
+
+            // Four objects that do not overlap
+            for (int i=0; i < 4; i++) {
+                const Vector3 min(decimal(3 * i), 0, 0);
+                tree.addObject(AABB(min, min + Vector3(1, 1, 1)), &data);
+            }
+            tree.computeStatistics(statistics);
+            rp3d_test(statistics.nbNodes == 7);
+            rp3d_test(statistics.nbLeaves == 4);
+            rp3d_test(statistics.nbDeferredLeaves == 0);
+            rp3d_test(statistics.height >= 2);
+            rp3d_test(statistics.totalLeafDepth >= 8);
+            rp3d_test(approxEqual(statistics.averageLeafDepth, decimal(statistics.totalLeafDepth) / decimal(4.0)));
+            rp3d_test(statistics.cost == tree.computeCost());
+            rp3d_test(statistics.siblingOverlapRatio == decimal(0.0));
+
+            // An object that overlaps with all the others
+            tree.addObject(AABB(Vector3(0, 0, 0), Vector3(10, 1, 1)), &data);
+            tree.computeStatistics(statistics);
+            rp3d_test(statistics.nbLeaves == 5);
+            rp3d_test(statistics.siblingOverlapRatio > decimal(0.0));
+            rp3d_test(statistics.siblingOverlapRatio < decimal(1.0));
+
+            // The queries are not counted by default
+            const AABB queryAABB(Vector3(-1, -1, -1), Vector3(2, 2, 2));
+            mOverlapCallback.reset();
+            tree.reportAllShapesOverlappingWithAABB(queryAABB, mOverlapCallback);
+            rp3d_test(tree.getNbQueries() == 0);
+            rp3d_test(tree.getNbQueryVisitedNodes() == 0);
+
+            // Count an overlap query and a raycast
+            tree.setIsQueryCountingEnabled(true);
+            mOverlapCallback.reset();
+            tree.reportAllShapesOverlappingWithAABB(queryAABB, mOverlapCallback);
+            rp3d_test(tree.getNbQueries() == 1);
+            rp3d_test(tree.getNbQueryVisitedNodes() >= 3);
+            rp3d_test(tree.getNbQueryVisitedNodes() <= 9);
+            const uint64 nbOverlapVisitedNodes = tree.getNbQueryVisitedNodes();
+            mRaycastCallback.reset();
+            tree.raycast(Ray(Vector3(-5, decimal(0.5), decimal(0.5)), Vector3(20, decimal(0.5), decimal(0.5))), mRaycastCallback);
+            rp3d_test(tree.getNbQueries() == 2);
+            rp3d_test(tree.getNbQueryVisitedNodes() == nbOverlapVisitedNodes + 9);
+            tree.computeStatistics(statistics);
+            rp3d_test(statistics.nbQueries == 2);
+            rp3d_test(statistics.nbQueryVisitedNodes == tree.getNbQueryVisitedNodes());
+
+            // The deferred leaves are visited by all the queries
+            tree.resetQueryCounters();
+            rp3d_test(tree.getNbQueries() == 0);
+            tree.addObjectDeferred(AABB(Vector3(50, 50, 50), Vector3(51, 51, 51)), &data);
+            tree.computeStatistics(statistics);
+            rp3d_test(statistics.nbDeferredLeaves == 1);
+            rp3d_test(statistics.nbLeaves == 5);
+            mOverlapCallback.reset();
+            tree.reportAllShapesOverlappingWithAABB(AABB(Vector3(100, 100, 100), Vector3(101, 101, 101)), mOverlapCallback);
+            rp3d_test(tree.getNbQueries() == 1);
+            rp3d_test(tree.getNbQueryVisitedNodes() == 2);
+
+#ifdef IS_PROFILING_ACTIVE
+			delete profiler;
+#endif
+        }
+
+        void testQueryContext() {
+
+            DynamicAABBTree tree(MemoryManager::getBaseAllocator());
+
+#ifdef IS_PROFILING_ACTIVE
+			/// Pointer to the profiler
+			Profiler* profiler = new Profiler();
+			tree.setProfiler(profiler);
+#endif
+
+            int data = 1;
+            DynamicAABBTreeQueryContext context(MemoryManager::getBaseAllocator());
+
+            // Empty tree
+            mOverlapCallback.reset();
+            tree.reportAllShapesOverlappingWithAABB(AABB(Vector3(-1, -1, -1), Vector3(1, 1, 1)), mOverlapCallback, context);
+            rp3d_test(mOverlapCallback.mOverlapNodes.size() == 0);
+            rp3d_test(tree.getQueryStackSize() == 1);
+
+            // A grid of objects
+            for (int i=0; i < 10; i++) {
+                for (int j=0; j < 10; j++) {
+                    const Vector3 min(decimal(2 * i), decimal(2 * j), 0);
+                    tree.addObject(AABB(min, min + Vector3(1, 1, 1)), &data);
+                }
+            }
+            DynamicAABBTreeStatistics statistics;
+            tree.computeStatistics(statistics);
+            rp3d_test(tree.getQueryStackSize() == uint(statistics.height) + 2);
+
+            // The queries with a reused context report the same nodes as the queries without context
+            TestOverlapCallback contextCallback;
+            for (int k=0; k < 5; k++) {
+                const Vector3 min(decimal(4 * k) - decimal(0.5), decimal(3 * k), -1);
+                const AABB aabb(min, min + Vector3(decimal(3.0), decimal(5.0), 2));
+                mOverlapCallback.reset();
+                contextCallback.reset();
+                tree.reportAllShapesOverlappingWithAABB(aabb, mOverlapCallback);
+                tree.reportAllShapesOverlappingWithAABB(aabb, contextCallback, context);
+                rp3d_test(mOverlapCallback.mOverlapNodes.size() > 0);
+                rp3d_test(contextCallback.mOverlapNodes.size() == mOverlapCallback.mOverlapNodes.size());
+                for (uint n=0; n < contextCallback.mOverlapNodes.size(); n++) {
+                    rp3d_test(mOverlapCallback.isOverlapping(contextCallback.mOverlapNodes[n]));
+                }
+            }
+
+            // A context with a grown stack gives the same raycast results
+            rp3d_test(context.reserveStack(1000) != nullptr);
+            const Ray ray(Vector3(-5, decimal(0.5), decimal(0.5)), Vector3(30, decimal(0.5), decimal(0.5)));
+            mRaycastCallback.reset();
+            tree.raycast(ray, mRaycastCallback);
+            std::vector<int> contextHitNodes;
+            auto leafFunction = [&contextHitNodes](int32 nodeId, const Ray& clippedRay) {
+                contextHitNodes.push_back(nodeId);
+                return decimal(1.0);
+            };
+            tree.raycastLeaves(ray, leafFunction, true, context);
+            rp3d_test(mRaycastCallback.mHitNodes.size() == 10);
+            rp3d_test(contextHitNodes.size() == mRaycastCallback.mHitNodes.size());
+            for (uint n=0; n < contextHitNodes.size(); n++) {
+                rp3d_test(mRaycastCallback.isHit(contextHitNodes[n]));
+            }
+
 #ifdef IS_PROFILING_ACTIVE
 			delete profiler;
 #endif
@@ -42,6 +42,7 @@ class TestHalfEdgeStructure : public Test {
         void run() {
             testCube();
             testTetrahedron();
+            testPrism();
         }
 
         void testCube() {
@@ -257,6 +258,66 @@ class TestHalfEdgeStructure : public Test {
                 rp3d_test(firstEdgeIndex == edgeIndex);
             }
         }
+
+        void testPrism() {
+
+            // Create the half-edge structure for a prism with many sides (the vertices 0 to
+            // nbSides - 1 are the bottom ring and the next ones are the top ring)
+            const uint nbSides = 100;
+            rp3d::HalfEdgeStructure prism(mAllocator, nbSides + 2, 2 * nbSides, 6 * nbSides);
+            for (uint v=0; v < 2 * nbSides; v++) {
+                prism.addVertex(v);
+            }
+            List<uint> faceVertices(mAllocator, nbSides);
+            for (uint i=0; i < nbSides; i++) {
+                faceVertices.add(i);
+            }
+            prism.addFace(faceVertices);
+            faceVertices.clear();
+            for (uint i=0; i < nbSides; i++) {
+                faceVertices.add(2 * nbSides - 1 - i);
+            }
+            prism.addFace(faceVertices);
+            for (uint i=0; i < nbSides; i++) {
+                faceVertices.clear();
+                faceVertices.add((i + 1) % nbSides);
+                faceVertices.add(i);
+                faceVertices.add(nbSides + i);
+                faceVertices.add(nbSides + (i + 1) % nbSides);
+                prism.addFace(faceVertices);
+            }
+
+            prism.init();
+
+            rp3d_test(prism.getNbFaces() == nbSides + 2);
+            rp3d_test(prism.getNbVertices() == 2 * nbSides);
+            rp3d_test(prism.getNbHalfEdges() == 6 * nbSides);
+
+            // The twin half-edges are next to each other
+            bool isValid = true;
+            for (uint e=0; e < prism.getNbHalfEdges(); e++) {
+                const rp3d::HalfEdgeStructure::Edge& edge = prism.getHalfEdge(e);
+                isValid &= edge.twinEdgeIndex == (e % 2 == 0 ? e + 1 : e - 1);
+                isValid &= prism.getHalfEdge(edge.nextEdgeIndex).vertexIndex ==
+                           prism.getHalfEdge(edge.twinEdgeIndex).vertexIndex;
+                isValid &= prism.getHalfEdge(edge.nextEdgeIndex).faceIndex == edge.faceIndex;
+            }
+            for (uint v=0; v < prism.getNbVertices(); v++) {
+                isValid &= prism.getHalfEdge(prism.getVertex(v).edgeIndex).vertexIndex == v;
+            }
+            rp3d_test(isValid);
+
+            // Each face is a loop of its half-edges
+            for (uint f=0; f < prism.getNbFaces(); f++) {
+                const uint nbFaceVertices = static_cast<uint>(prism.getFace(f).faceVertices.size());
+                uint edgeIndex = prism.getFace(f).edgeIndex;
+                for (uint e=0; e < nbFaceVertices; e++) {
+                    rp3d_test(prism.getHalfEdge(edgeIndex).faceIndex == f);
+                    edgeIndex = prism.getHalfEdge(edgeIndex).nextEdgeIndex;
+                }
+                rp3d_test(edgeIndex == prism.getFace(f).edgeIndex);
+            }
+        }
  };
 
 }
@@ -0,0 +1,327 @@
+/********************************************************************************
+* ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
+* Copyright (c) 2010-2018 Daniel Chappuis                                       *
+*********************************************************************************
+*                                                                               *
+* This software is provided 'as-is', without any express or implied warranty.   *
+* In no event will the authors be held liable for any damages arising from the  *
+* use of this software.                                                         *
+*                                                                               *
+* Permission is granted to anyone to use this software for any purpose,         *
+* including commercial applications, and to alter it and redistribute it        *
+* freely, subject to the following restrictions:                                *
+*                                                                               *
+* 1. The origin of this software must not be misrepresented; you must not claim *
+*    that you wrote the original software. If you use this software in a        *
+*    product, an acknowledgment in the product documentation would be           *
+*    appreciated but is not required.                                           *
+*                                                                               *
+* 2. Altered source versions must be plainly marked as such, and must not be    *
+*    misrepresented as being the original software.                             *
+*                                                                               *
+* 3. This notice may not be removed or altered from any source distribution.    *
+*                                                                               *
+********************************************************************************/
+
+#ifndef TEST_HEIGHT_FIELD_SHAPE_H
+#define TEST_HEIGHT_FIELD_SHAPE_H
+
+// Libraries
+#include "Test.h"
+#include "collision/shapes/HeightFieldShape.h"
+#include "engine/CollisionWorld.h"
+#include "collision/RaycastInfo.h"
+#include <cmath>
+#include <vector>
+
+/// Reactphysics3D namespace
+namespace reactphysics3d {
+
+// Class TriangleCollector
+/**
+ * Triangle callback that stores the AABB and the shape id of the reported triangles
+ */
+class TriangleCollector : public TriangleCallback {
+
+    public:
+
+        std::vector<AABB> trianglesAABB;
+        std::vector<uint> shapeIds;
+
+        void testTriangle(const Vector3* trianglePoints, const Vector3* /*verticesNormals*/, uint shapeId) override {
+            trianglesAABB.push_back(AABB::createAABBForTriangle(trianglePoints));
+            shapeIds.push_back(shapeId);
+        }
+
+        bool hasShapeId(uint shapeId) const {
+            for (uint i=0; i < shapeIds.size(); i++) {
+                if (shapeIds[i] == shapeId) return true;
+            }
+            return false;
+        }
+};
+
+// Class TestHeightFieldShape
+/**
+ * Unit test for the overlap queries of the HeightFieldShape class
+ */
+class TestHeightFieldShape : public Test {
+
+    private :
+
+        // ---------- Atributes ---------- //
+
+        /// Number of columns of the grid
+        static const int NB_COLUMNS = 37;
+
+        /// Number of rows of the grid
+        static const int NB_ROWS = 21;
+
+        /// Heights of the grid
+        float mHeights[NB_COLUMNS * NB_ROWS];
+
+    public :
+
+        // ---------- Methods ---------- //
+
+        /// Constructor
+        TestHeightFieldShape(const std::string& name) : Test(name) {
+
+            for (int j=0; j < NB_ROWS; j++) {
+                for (int i=0; i < NB_COLUMNS; i++) {
+                    mHeights[j * NB_COLUMNS + i] = float(3.0 * std::sin(0.3 * i) + 2.0 * std::cos(0.5 * j));
+                }
+            }
+        }
+
+        /// Run the tests
+        void run() override {
+            testOverlapQueries();
+            testHeightDataTypes();
+            testTiles();
+        }
+
+        /// Test that the overlap queries only skip the triangles outside of the query AABB
+        void testOverlapQueries() {
+
+            // Pseudo-random generator of the query AABBs
+            uint32 seed = 6789;
+            auto random = [&seed](decimal min, decimal max) {
+                seed = seed * 1664525u + 1013904223u;
+                return min + (max - min) * decimal(seed >> 8) / decimal(1 << 24);
+            };
+
+            for (int upAxis = 0; upAxis < 3; upAxis++) {
+
+                HeightFieldShape shape(NB_COLUMNS, NB_ROWS, -5, 5, mHeights, HeightFieldShape::HeightDataType::HEIGHT_FLOAT_TYPE,
+                                       upAxis, 1, Vector3(decimal(1.5), decimal(0.7), decimal(2.0)));
+
+                Vector3 min, max;
+                shape.getLocalBounds(min, max);
+
+                // All the triangles of the height field
+                TriangleCollector allTriangles;
+                shape.testAllTriangles(allTriangles, AABB(min - Vector3(1, 1, 1), max + Vector3(1, 1, 1)));
+                rp3d_test(allTriangles.shapeIds.size() == uint(2 * (NB_COLUMNS - 1) * (NB_ROWS - 1)));
+
+                // An AABB above the height field does not report any triangle
+                Vector3 aboveMin = min;
+                Vector3 aboveMax = max;
+                aboveMin[upAxis] = max[upAxis] + decimal(1.0);
+                aboveMax[upAxis] = max[upAxis] + decimal(2.0);
+                TriangleCollector aboveTriangles;
+                shape.testAllTriangles(aboveTriangles, AABB(aboveMin, aboveMax));
+                rp3d_test(aboveTriangles.shapeIds.size() == 0);
+
+                // A thin AABB at the middle height of the field reports less triangles than the
+                // whole field
+                Vector3 thinMin = min;
+                Vector3 thinMax = max;
+                thinMin[upAxis] = decimal(-0.1);
+                thinMax[upAxis] = decimal(0.1);
+                TriangleCollector thinTriangles;
+                shape.testAllTriangles(thinTriangles, AABB(thinMin, thinMax));
+                rp3d_test(thinTriangles.shapeIds.size() > 0);
+                rp3d_test(thinTriangles.shapeIds.size() < allTriangles.shapeIds.size());
+
+                // Every triangle that overlaps a random AABB is reported
+                for (int q=0; q < 100; q++) {
+
+                    Vector3 point1(random(min.x, max.x), random(min.y, max.y), random(min.z, max.z));
+                    Vector3 point2(random(min.x, max.x), random(min.y, max.y), random(min.z, max.z));
+                    const AABB queryAABB(Vector3(std::min(point1.x, point2.x), std::min(point1.y, point2.y), std::min(point1.z, point2.z)),
+                                         Vector3(std::max(point1.x, point2.x), std::max(point1.y, point2.y), std::max(point1.z, point2.z)));
+
+                    TriangleCollector queryTriangles;
+                    shape.testAllTriangles(queryTriangles, queryAABB);
+
+                    for (uint t=0; t < allTriangles.shapeIds.size(); t++) {
+                        if (allTriangles.trianglesAABB[t].testCollision(queryAABB)) {
+                            rp3d_test(queryTriangles.hasShapeId(allTriangles.shapeIds[t]));
+                        }
+                    }
+                }
+            }
+        }
+
+        /// Test that the height fields with double and integer height values report the same
+        /// triangles as the height field with float values
+        void testHeightDataTypes() {
+
+            double doubleHeights[NB_COLUMNS * NB_ROWS];
+            int integerHeights[NB_COLUMNS * NB_ROWS];
+            float roundedHeights[NB_COLUMNS * NB_ROWS];
+            for (int i=0; i < NB_COLUMNS * NB_ROWS; i++) {
+                doubleHeights[i] = mHeights[i];
+                integerHeights[i] = int(std::round(mHeights[i] * 4.0f));
+                roundedHeights[i] = float(integerHeights[i]) * 0.25f;
+            }
+
+            HeightFieldShape floatShape(NB_COLUMNS, NB_ROWS, -5, 5, mHeights, HeightFieldShape::HeightDataType::HEIGHT_FLOAT_TYPE);
+            HeightFieldShape doubleShape(NB_COLUMNS, NB_ROWS, -5, 5, doubleHeights, HeightFieldShape::HeightDataType::HEIGHT_DOUBLE_TYPE);
+            HeightFieldShape roundedShape(NB_COLUMNS, NB_ROWS, -5, 5, roundedHeights, HeightFieldShape::HeightDataType::HEIGHT_FLOAT_TYPE);
+            HeightFieldShape integerShape(NB_COLUMNS, NB_ROWS, -20, 20, integerHeights, HeightFieldShape::HeightDataType::HEIGHT_INT_TYPE,
+                                          1, decimal(0.25));
+
+            // Thin AABB at the middle height of the field
+            Vector3 min, max;
+            floatShape.getLocalBounds(min, max);
+            const AABB queryAABB(Vector3(min.x, decimal(-0.5), min.z), Vector3(max.x, decimal(0.5), max.z));
+
+            TriangleCollector floatTriangles;
+            floatShape.testAllTriangles(floatTriangles, queryAABB);
+            TriangleCollector doubleTriangles;
+            doubleShape.testAllTriangles(doubleTriangles, queryAABB);
+            TriangleCollector roundedTriangles;
+            roundedShape.testAllTriangles(roundedTriangles, queryAABB);
+            TriangleCollector integerTriangles;
+            integerShape.testAllTriangles(integerTriangles, queryAABB);
+
+            rp3d_test(floatTriangles.shapeIds.size() > 0);
+            rp3d_test(doubleTriangles.shapeIds == floatTriangles.shapeIds);
+            rp3d_test(roundedTriangles.shapeIds.size() > 0);
+            rp3d_test(integerTriangles.shapeIds == roundedTriangles.shapeIds);
+
+            uint nbDifferences = 0;
+            for (uint t=0; t < integerTriangles.shapeIds.size(); t++) {
+                if (!approxEqual(integerTriangles.trianglesAABB[t].getMin(), roundedTriangles.trianglesAABB[t].getMin()) ||
+                    !approxEqual(integerTriangles.trianglesAABB[t].getMax(), roundedTriangles.trianglesAABB[t].getMax())) {
+                    nbDifferences++;
+                }
+            }
+            rp3d_test(nbDifferences == 0);
+        }
+
+        /// Test the tiles of a height field that are set and removed and the holes of the cells
+        void testTiles() {
+
+            const int NB_TILE_CELLS = 8;
+            const int nbTileHeights = (NB_TILE_CELLS + 1) * (NB_TILE_CELLS + 1);
+
+            HeightFieldShape shape(NB_COLUMNS, NB_ROWS, -5, 5, mHeights, HeightFieldShape::HeightDataType::HEIGHT_FLOAT_TYPE);
+            HeightFieldShape tiledShape(NB_COLUMNS, NB_ROWS, NB_TILE_CELLS, -5, 5,
+                                        HeightFieldShape::HeightDataType::HEIGHT_FLOAT_TYPE);
+            rp3d_test(tiledShape.getNbTileColumns() == 5);
+            rp3d_test(tiledShape.getNbTileRows() == 3);
+
+            Vector3 min, max;
+            shape.getLocalBounds(min, max);
+            const AABB allAABB(min - Vector3(1, 1, 1), max + Vector3(1, 1, 1));
+
+            // A tiled height field without resident tiles does not report any triangle
+            TriangleCollector noTriangles;
+            tiledShape.testAllTriangles(noTriangles, allAABB);
+            rp3d_test(noTriangles.shapeIds.size() == 0);
+            rp3d_test(tiledShape.isCellHole(3, 4));
+
+            // Copy the heights of the grid into the tiles (the grid points outside of the grid are unused)
+            std::vector<float> tilesHeights(15 * nbTileHeights, 0.0f);
+            for (int tileJ = 0; tileJ < 3; tileJ++) {
+                for (int tileI = 0; tileI < 5; tileI++) {
+                    float* tileHeights = &tilesHeights[(tileJ * 5 + tileI) * nbTileHeights];
+                    for (int y=0; y <= NB_TILE_CELLS; y++) {
+                        for (int x=0; x <= NB_TILE_CELLS; x++) {
+                            const int i = tileI * NB_TILE_CELLS + x;
+                            const int j = tileJ * NB_TILE_CELLS + y;
+                            if (i < NB_COLUMNS && j < NB_ROWS) {
+                                tileHeights[y * (NB_TILE_CELLS + 1) + x] = mHeights[j * NB_COLUMNS + i];
+                            }
+                        }
+                    }
+                    tiledShape.setTileData(tileI, tileJ, tileHeights);
+                }
+            }
+
+            // With all the tiles resident, the triangles are the ones of the non-tiled height field
+            TriangleCollector allTriangles;
+            shape.testAllTriangles(allTriangles, allAABB);
+            TriangleCollector allTiledTriangles;
+            tiledShape.testAllTriangles(allTiledTriangles, allAABB);
+            rp3d_test(allTiledTriangles.shapeIds.size() == allTriangles.shapeIds.size());
+            uint nbDifferences = 0;
+            for (uint t=0; t < allTriangles.shapeIds.size(); t++) {
+                bool isFound = false;
+                for (uint u=0; u < allTiledTriangles.shapeIds.size(); u++) {
+                    if (allTiledTriangles.shapeIds[u] == allTriangles.shapeIds[t]) {
+                        isFound = allTiledTriangles.trianglesAABB[u].getMin() == allTriangles.trianglesAABB[t].getMin() &&
+                                  allTiledTriangles.trianglesAABB[u].getMax() == allTriangles.trianglesAABB[t].getMax();
+                    }
+                }
+                if (!isFound) nbDifferences++;
+            }
+            rp3d_test(nbDifferences == 0);
+            rp3d_test(tiledShape.getVertexAt(16, 8) == shape.getVertexAt(16, 8));
+
+            // Make a hole at the cell (10, 11) of the tile (1, 1)
+            uint8 cellHoles[NB_TILE_CELLS * NB_TILE_CELLS] = {0};
+            cellHoles[3 * NB_TILE_CELLS + 2] = 1;
+            tiledShape.setTileData(1, 1, &tilesHeights[(1 * 5 + 1) * nbTileHeights], cellHoles);
+            rp3d_test(tiledShape.isCellHole(10, 11));
+            rp3d_test(!tiledShape.isCellHole(11, 11));
+            TriangleCollector holeTriangles;
+            tiledShape.testAllTriangles(holeTriangles, allAABB);
+            rp3d_test(holeTriangles.shapeIds.size() == allTriangles.shapeIds.size() - 2);
+            rp3d_test(!holeTriangles.hasShapeId((11 * (NB_COLUMNS - 1) + 10) * 2));
+            rp3d_test(!holeTriangles.hasShapeId((11 * (NB_COLUMNS - 1) + 10) * 2 + 1));
+
+            // Remove the tile (2, 0)
+            tiledShape.removeTileData(2, 0);
+            rp3d_test(!tiledShape.isTileResident(2, 0));
+            rp3d_test(tiledShape.isTileResident(3, 0));
+            rp3d_test(tiledShape.isCellHole(16, 0));
+            TriangleCollector removedTriangles;
+            tiledShape.testAllTriangles(removedTriangles, allAABB);
+            rp3d_test(removedTriangles.shapeIds.size() == allTriangles.shapeIds.size() - 2 - 2 * NB_TILE_CELLS * NB_TILE_CELLS);
+
+            // A grid point on the border of a removed tile is read from a neighbor tile
+            rp3d_test(tiledShape.getHeightAt(16, 8) == mHeights[8 * NB_COLUMNS + 16]);
+
+            // A ray does not hit a hole or a tile that is not resident
+            CollisionWorld world;
+            CollisionBody* body = world.createCollisionBody(Transform::identity());
+            ProxyShape* proxyShape = body->addCollisionShape(&tiledShape, Transform::identity());
+            auto raycastCell = [&](int i, int j) {
+                const decimal x = min.x + decimal(i) + decimal(0.5);
+                const decimal z = min.z + decimal(j) + decimal(0.5);
+                RaycastInfo raycastInfo;
+                return proxyShape->raycast(Ray(Vector3(x, 10, z), Vector3(x, -10, z)), raycastInfo);
+            };
+            rp3d_test(raycastCell(11, 11));
+            rp3d_test(!raycastCell(10, 11));
+            rp3d_test(!raycastCell(18, 3));
+            rp3d_test(raycastCell(26, 3));
+
+            // The overlap queries and the raycasts use the tile again when it is set
+            tiledShape.setTileData(2, 0, &tilesHeights[2 * nbTileHeights]);
+            rp3d_test(raycastCell(18, 3));
+            TriangleCollector reloadedTriangles;
+            tiledShape.testAllTriangles(reloadedTriangles, allAABB);
+            rp3d_test(reloadedTriangles.shapeIds.size() == allTriangles.shapeIds.size() - 2);
+
+            body->removeCollisionShape(proxyShape);
+        }
+};
+
+}
+
+#endif
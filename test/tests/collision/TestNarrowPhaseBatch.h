@@ -0,0 +1,392 @@
+/********************************************************************************
+* ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
+* Copyright (c) 2010-2016 Daniel Chappuis                                       *
+*********************************************************************************
+*                                                                               *
+* This software is provided 'as-is', without any express or implied warranty.   *
+* In no event will the authors be held liable for any damages arising from the  *
+* use of this software.                                                         *
+*                                                                               *
+* Permission is granted to anyone to use this software for any purpose,         *
+* including commercial applications, and to alter it and redistribute it        *
+* freely, subject to the following restrictions:                                *
+*                                                                               *
+* 1. The origin of this software must not be misrepresented; you must not claim *
+*    that you wrote the original software. If you use this software in a        *
+*    product, an acknowledgment in the product documentation would be           *
+*    appreciated but is not required.                                           *
+*                                                                               *
+* 2. Altered source versions must be plainly marked as such, and must not be    *
+*    misrepresented as being the original software.                             *
+*                                                                               *
+* 3. This notice may not be removed or altered from any source distribution.    *
+*                                                                               *
+********************************************************************************/
+
+#ifndef TEST_NARROW_PHASE_BATCH_H
+#define TEST_NARROW_PHASE_BATCH_H
+
+// Libraries
+#include "Test.h"
+#include "engine/CollisionWorld.h"
+#include "engine/OverlappingPair.h"
+#include "collision/NarrowPhaseInfo.h"
+#include "collision/ContactPointInfo.h"
+#include "collision/shapes/SphereShape.h"
+#include "collision/shapes/CapsuleShape.h"
+#include "collision/shapes/BoxShape.h"
+#include "collision/shapes/HeightFieldShape.h"
+#include "collision/shapes/TriangleShape.h"
+#include "collision/MiddlePhaseTriangleCallback.h"
+#include "collision/narrowphase/SphereVsSphereAlgorithm.h"
+#include "collision/narrowphase/SphereVsCapsuleAlgorithm.h"
+#include "collision/narrowphase/SphereVsConvexPolyhedronAlgorithm.h"
+#include "memory/MemoryManager.h"
+#include "memory/DefaultAllocator.h"
+
+/// Reactphysics3D namespace
+namespace reactphysics3d {
+
+// Class BytesCountingAllocator
+/**
+ * Memory allocator that counts its allocations and releases and their sizes
+ */
+class BytesCountingAllocator : public DefaultAllocator {
+
+    public:
+
+        uint nbAllocations = 0;
+        uint nbReleases = 0;
+        size_t nbAllocatedBytes = 0;
+        size_t nbReleasedBytes = 0;
+
+        virtual void* allocate(size_t size) override {
+            nbAllocations++;
+            nbAllocatedBytes += size;
+            return DefaultAllocator::allocate(size);
+        }
+
+        virtual void release(void* pointer, size_t size) override {
+            nbReleases++;
+            nbReleasedBytes += size;
+            DefaultAllocator::release(pointer, size);
+        }
+};
+
+// Class TestNarrowPhaseBatch
+/**
+ * Unit test for the batch kernels of the narrow-phase algorithms. The batch
+ * kernels must give the same contacts as the test of a single pair.
+ */
+class TestNarrowPhaseBatch : public Test {
+
+    private :
+
+        // ---------- Atributes ---------- //
+
+        CollisionWorld* mWorld;
+        SphereShape* mSphereShape1;
+        SphereShape* mSphereShape2;
+        CapsuleShape* mCapsuleShape;
+        BoxShape* mBoxShape;
+        List<ProxyShape*> mSphereProxyShapes;
+        List<ProxyShape*> mCapsuleProxyShapes;
+        List<ProxyShape*> mBoxProxyShapes;
+
+        // ---------- Methods ---------- //
+
+        /// Return the collision shape of a proxy shape
+        static CollisionShape* getCollisionShape(const ProxyShape* proxyShape) {
+            return const_cast<CollisionShape*>(proxyShape->getCollisionShape());
+        }
+
+        /// Return true if two lists of contact points are the same
+        bool isSameContactPoint(const ContactPointInfo* point1, const ContactPointInfo* point2) const {
+
+            if (point1 == nullptr || point2 == nullptr) return point1 == point2;
+
+            const decimal epsilon = decimal(0.0001);
+            return point1->next == nullptr && point2->next == nullptr &&
+                   approxEqual(point1->penetrationDepth, point2->penetrationDepth, epsilon) &&
+                   approxEqual(point1->normal, point2->normal, epsilon) &&
+                   approxEqual(point1->localPoint1, point2->localPoint1, epsilon) &&
+                   approxEqual(point1->localPoint2, point2->localPoint2, epsilon);
+        }
+
+        /// Test the pairs between two lists of proxy shapes one by one and with a batch
+        void testBatch(NarrowPhaseAlgorithm& algorithm, const List<ProxyShape*>& shapes1,
+                       const List<ProxyShape*>& shapes2) {
+
+            MemoryAllocator& allocator = MemoryManager::getBaseAllocator();
+            WorldSettings settings;
+
+            List<OverlappingPair*> pairs(allocator);
+            List<NarrowPhaseInfo*> singleInfos(allocator);
+            List<NarrowPhaseInfo*> batchInfos(allocator);
+            for (uint i=0; i < shapes1.size(); i++) {
+                for (uint j=0; j < shapes2.size(); j++) {
+                    if (shapes1[i] == shapes2[j]) continue;
+                    OverlappingPair* pair = new OverlappingPair(shapes1[i], shapes2[j], allocator, allocator, settings);
+                    pairs.add(pair);
+                    for (uint k=0; k < 2; k++) {
+                        NarrowPhaseInfo* info = new NarrowPhaseInfo(pair, getCollisionShape(shapes1[i]),
+                                                                    getCollisionShape(shapes2[j]),
+                                                                    shapes1[i]->getLocalToWorldTransform(),
+                                                                    shapes2[j]->getLocalToWorldTransform(), allocator);
+                        if (k == 0) singleInfos.add(info);
+                        else batchInfos.add(info);
+                    }
+                }
+            }
+
+            // The batch is larger than the number of lanes and does not fill its last group
+            rp3d_test(batchInfos.size() > 4);
+
+            bool* isColliding = new bool[batchInfos.size()];
+            algorithm.testCollisionBatch(&(batchInfos[0]), isColliding, batchInfos.size(), true, allocator);
+
+            uint nbCollidingPairs = 0;
+            for (uint i=0; i < singleInfos.size(); i++) {
+                const bool isSingleColliding = algorithm.testCollision(singleInfos[i], true, allocator);
+                rp3d_test(isSingleColliding == isColliding[i]);
+                rp3d_test(isSameContactPoint(singleInfos[i]->contactPoints, batchInfos[i]->contactPoints));
+                if (isSingleColliding) nbCollidingPairs++;
+            }
+            rp3d_test(nbCollidingPairs > 0);
+            rp3d_test(nbCollidingPairs < singleInfos.size());
+
+            delete[] isColliding;
+            for (uint i=0; i < singleInfos.size(); i++) {
+                singleInfos[i]->resetContactPoints();
+                batchInfos[i]->resetContactPoints();
+                delete singleInfos[i];
+                delete batchInfos[i];
+            }
+            for (uint i=0; i < pairs.size(); i++) {
+                delete pairs[i];
+            }
+        }
+
+    public :
+
+        // ---------- Methods ---------- //
+
+        /// Constructor
+        TestNarrowPhaseBatch(const std::string& name)
+            : Test(name), mSphereProxyShapes(MemoryManager::getBaseAllocator()),
+              mCapsuleProxyShapes(MemoryManager::getBaseAllocator()),
+              mBoxProxyShapes(MemoryManager::getBaseAllocator()) {
+
+            mWorld = new CollisionWorld();
+            mSphereShape1 = new SphereShape(decimal(1.0));
+            mSphereShape2 = new SphereShape(decimal(0.5));
+            mCapsuleShape = new CapsuleShape(decimal(0.5), decimal(2.0));
+            mBoxShape = new BoxShape(Vector3(decimal(1.0), decimal(0.6), decimal(1.5)));
+
+            // Spheres that overlap, touch at the same center or are separated
+            const Vector3 spherePositions[5] = {Vector3(0, 0, 0), Vector3(decimal(1.2), decimal(0.3), 0),
+                                                Vector3(0, 0, 0), Vector3(10, 0, 0), Vector3(0, decimal(-1.4), decimal(0.2))};
+            for (uint i=0; i < 5; i++) {
+                const Quaternion orientation = Quaternion::fromEulerAngles(decimal(0.3) * decimal(i), decimal(0.1), 0);
+                CollisionBody* body = mWorld->createCollisionBody(Transform(spherePositions[i], orientation));
+                mSphereProxyShapes.add(body->addCollisionShape(i % 2 == 0 ? mSphereShape1 : mSphereShape2,
+                                                               Transform::identity()));
+            }
+
+            // Capsules with a sphere center on their inner segment, at their end or away from them
+            const Vector3 capsulePositions[3] = {Vector3(0, decimal(0.5), 0), Vector3(decimal(1.5), decimal(2.2), 0),
+                                                 Vector3(-20, 0, 0)};
+            for (uint i=0; i < 3; i++) {
+                const Quaternion orientation = Quaternion::fromEulerAngles(0, 0, decimal(0.5) * decimal(i));
+                CollisionBody* body = mWorld->createCollisionBody(Transform(capsulePositions[i], orientation));
+                mCapsuleProxyShapes.add(body->addCollisionShape(mCapsuleShape, Transform::identity()));
+            }
+
+            // Boxes that contain a sphere center, that touch spheres from outside or are away from them
+            const Vector3 boxPositions[3] = {Vector3(0, decimal(0.2), 0), Vector3(decimal(1.8), decimal(-1.3), decimal(0.4)),
+                                             Vector3(0, 0, 30)};
+            for (uint i=0; i < 3; i++) {
+                const Quaternion orientation = Quaternion::fromEulerAngles(decimal(0.2) * decimal(i), 0, decimal(0.4));
+                CollisionBody* body = mWorld->createCollisionBody(Transform(boxPositions[i], orientation));
+                mBoxProxyShapes.add(body->addCollisionShape(mBoxShape, Transform::identity()));
+            }
+        }
+
+        /// Destructor
+        virtual ~TestNarrowPhaseBatch() {
+            delete mWorld;
+            delete mSphereShape1;
+            delete mSphereShape2;
+            delete mCapsuleShape;
+            delete mBoxShape;
+        }
+
+        /// Run the tests
+        void run() {
+
+            testSphereVsSphere();
+            testSphereVsCapsule();
+            testSphereVsBox();
+            testMiddlePhaseTriangles();
+            testTriangleCulling();
+        }
+
+        void testSphereVsSphere() {
+
+            SphereVsSphereAlgorithm algorithm;
+            testBatch(algorithm, mSphereProxyShapes, mSphereProxyShapes);
+        }
+
+        void testSphereVsCapsule() {
+
+            SphereVsCapsuleAlgorithm algorithm;
+            testBatch(algorithm, mSphereProxyShapes, mCapsuleProxyShapes);
+            testBatch(algorithm, mCapsuleProxyShapes, mSphereProxyShapes);
+        }
+
+        void testSphereVsBox() {
+
+            SphereVsConvexPolyhedronAlgorithm algorithm;
+#ifdef IS_PROFILING_ACTIVE
+            algorithm.setProfiler(mWorld->getProfiler());
+#endif
+            testBatch(algorithm, mSphereProxyShapes, mBoxProxyShapes);
+            testBatch(algorithm, mBoxProxyShapes, mSphereProxyShapes);
+        }
+
+        /// Test that the narrow-phase infos of the triangles of a concave shape are created
+        /// with a single allocation and that their memory is released with the last of them
+        void testMiddlePhaseTriangles() {
+
+            MemoryAllocator& allocator = MemoryManager::getBaseAllocator();
+            WorldSettings settings;
+
+            float heights[25];
+            for (int i=0; i < 25; i++) heights[i] = float(i % 3);
+            HeightFieldShape heightFieldShape(5, 5, 0, 2, heights, HeightFieldShape::HeightDataType::HEIGHT_FLOAT_TYPE);
+            CollisionBody* body = mWorld->createCollisionBody(Transform::identity());
+            ProxyShape* heightFieldProxyShape = body->addCollisionShape(&heightFieldShape, Transform::identity());
+            ProxyShape* sphereProxyShape = mSphereProxyShapes[0];
+
+            OverlappingPair pair(sphereProxyShape, heightFieldProxyShape, allocator, allocator, settings);
+            BytesCountingAllocator countingAllocator;
+            MiddlePhaseTriangleBatch triangles(allocator);
+            MiddlePhaseTriangleCallback callback(&pair, heightFieldProxyShape, sphereProxyShape, &heightFieldShape,
+                                                 countingAllocator, triangles);
+
+            // Report all the triangles of the height field
+            heightFieldShape.testAllTriangles(callback, AABB(Vector3(-10, -10, -10), Vector3(10, 10, 10)));
+            rp3d_test(triangles.getNbTriangles() == 32);
+            rp3d_test(countingAllocator.nbAllocations == 0);
+
+            NarrowPhaseInfo* narrowPhaseInfo = callback.createNarrowPhaseInfos();
+            rp3d_test(countingAllocator.nbAllocations == 1);
+            rp3d_test(triangles.getNbTriangles() == 0);
+
+            uint nbNarrowPhaseInfos = 0;
+            while (narrowPhaseInfo != nullptr) {
+
+                // The convex shape is the first shape of the pair
+                rp3d_test(narrowPhaseInfo->collisionShape1 == getCollisionShape(sphereProxyShape));
+                rp3d_test(narrowPhaseInfo->collisionShape2->getName() == CollisionShapeName::TRIANGLE);
+
+                NarrowPhaseInfo* nextNarrowPhaseInfo = narrowPhaseInfo->next;
+                NarrowPhaseInfo::destroy(narrowPhaseInfo);
+                narrowPhaseInfo = nextNarrowPhaseInfo;
+                nbNarrowPhaseInfos++;
+
+                // The memory is only released with the last narrow-phase info
+                rp3d_test(countingAllocator.nbReleases == (nbNarrowPhaseInfos == 32 ? 1u : 0u));
+            }
+            rp3d_test(nbNarrowPhaseInfos == 32);
+            rp3d_test(countingAllocator.nbReleasedBytes == countingAllocator.nbAllocatedBytes);
+
+            // No triangle gives no narrow-phase info and no allocation
+            heightFieldShape.testAllTriangles(callback, AABB(Vector3(20, 20, 20), Vector3(21, 21, 21)));
+            rp3d_test(callback.createNarrowPhaseInfos() == nullptr);
+            rp3d_test(countingAllocator.nbAllocations == 1);
+
+            mWorld->destroyCollisionBody(body);
+        }
+
+        /// Test that the middle-phase only culls the triangles that do not touch the convex shape
+        void testTriangleCulling() {
+
+            MemoryAllocator& allocator = MemoryManager::getBaseAllocator();
+            WorldSettings settings;
+
+            float heights[64];
+            for (int i=0; i < 64; i++) heights[i] = float((i * 7) % 5) * 0.5f;
+            HeightFieldShape heightFieldShape(8, 8, 0, 2, heights, HeightFieldShape::HeightDataType::HEIGHT_FLOAT_TYPE);
+            CollisionBody* heightFieldBody = mWorld->createCollisionBody(Transform::identity());
+            ProxyShape* heightFieldProxyShape = heightFieldBody->addCollisionShape(&heightFieldShape, Transform::identity());
+
+            SphereVsConvexPolyhedronAlgorithm algorithm;
+#ifdef IS_PROFILING_ACTIVE
+            algorithm.setProfiler(mWorld->getProfiler());
+#endif
+            MiddlePhaseTriangleBatch triangles(allocator);
+            uint nbTotalCulledTriangles = 0;
+            uint nbTotalKeptTriangles = 0;
+
+            for (int s=0; s < 40; s++) {
+
+                // Sphere moving above and through the height field
+                const Vector3 center(decimal(-3.0) + decimal(0.15) * decimal(s), decimal(-1.5) + decimal(0.07) * decimal(s),
+                                     decimal(2.5) - decimal(0.12) * decimal(s));
+                CollisionBody* sphereBody = mWorld->createCollisionBody(Transform(center, Quaternion::identity()));
+                ProxyShape* sphereProxyShape = sphereBody->addCollisionShape(mSphereShape2, Transform::identity());
+
+                OverlappingPair pair(sphereProxyShape, heightFieldProxyShape, allocator, allocator, settings);
+                MiddlePhaseTriangleCallback callback(&pair, heightFieldProxyShape, sphereProxyShape, &heightFieldShape,
+                                                     allocator, triangles);
+
+                AABB sphereAABB;
+                mSphereShape2->computeAABB(sphereAABB, sphereProxyShape->getLocalToWorldTransform());
+                heightFieldShape.testAllTriangles(callback, sphereAABB);
+
+                // Copy the reported triangles
+                MiddlePhaseTriangleBatch reportedTriangles(allocator);
+                reportedTriangles.vertices.addRange(triangles.vertices);
+                reportedTriangles.verticesNormals.addRange(triangles.verticesNormals);
+                reportedTriangles.shapeIds.addRange(triangles.shapeIds);
+
+                const uint nbCulledTriangles = callback.cullSeparatedTriangles(sphereAABB);
+                rp3d_test(nbCulledTriangles + triangles.getNbTriangles() == reportedTriangles.getNbTriangles());
+                nbTotalCulledTriangles += nbCulledTriangles;
+                nbTotalKeptTriangles += triangles.getNbTriangles();
+
+                // A culled triangle does not collide with the sphere
+                for (uint t=0; t < reportedTriangles.getNbTriangles(); t++) {
+
+                    bool isKept = false;
+                    for (uint k=0; k < triangles.getNbTriangles(); k++) {
+                        if (triangles.shapeIds[k] == reportedTriangles.shapeIds[t]) {
+                            rp3d_test(approxEqual(triangles.vertices[3 * k], reportedTriangles.vertices[3 * t]));
+                            isKept = true;
+                        }
+                    }
+                    if (isKept) continue;
+
+                    TriangleShape triangleShape(&(reportedTriangles.vertices[3 * t]), &(reportedTriangles.verticesNormals[3 * t]),
+                                                reportedTriangles.shapeIds[t]);
+                    NarrowPhaseInfo info(&pair, mSphereShape2, &triangleShape, sphereProxyShape->getLocalToWorldTransform(),
+                                         Transform::identity(), allocator);
+                    rp3d_test(!algorithm.testCollision(&info, true, allocator));
+                    info.resetContactPoints();
+                }
+
+                triangles.clear();
+                mWorld->destroyCollisionBody(sphereBody);
+            }
+
+            rp3d_test(nbTotalCulledTriangles > 0);
+            rp3d_test(nbTotalKeptTriangles > 0);
+
+            mWorld->destroyCollisionBody(heightFieldBody);
+        }
+};
+
+}
+
+#endif
@@ -0,0 +1,278 @@
+/********************************************************************************
+* ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
+* Copyright (c) 2010-2016 Daniel Chappuis                                       *
+*********************************************************************************
+*                                                                               *
+* This software is provided 'as-is', without any express or implied warranty.   *
+* In no event will the authors be held liable for any damages arising from the  *
+* use of this software.                                                         *
+*                                                                               *
+* Permission is granted to anyone to use this software for any purpose,         *
+* including commercial applications, and to alter it and redistribute it        *
+* freely, subject to the following restrictions:                                *
+*                                                                               *
+* 1. The origin of this software must not be misrepresented; you must not claim *
+*    that you wrote the original software. If you use this software in a        *
+*    product, an acknowledgment in the product documentation would be           *
+*    appreciated but is not required.                                           *
+*                                                                               *
+* 2. Altered source versions must be plainly marked as such, and must not be    *
+*    misrepresented as being the original software.                             *
+*                                                                               *
+* 3. This notice may not be removed or altered from any source distribution.    *
+*                                                                               *
+********************************************************************************/
+
+#ifndef TEST_QUANTIZED_BVH_H
+#define TEST_QUANTIZED_BVH_H
+
+// Libraries
+#include "Test.h"
+#include "TestDynamicAABBTree.h"
+#include "collision/QuantizedBVH.h"
+#include "memory/MemoryManager.h"
+#include <vector>
+
+/// Reactphysics3D namespace
+namespace reactphysics3d {
+
+// Class TestQuantizedBVH
+/**
+ * Unit test for the QuantizedBVH class
+ */
+class TestQuantizedBVH : public Test {
+
+    private :
+
+        // ---------- Atributes ---------- //
+
+        TestOverlapCallback mOverlapCallback;
+        DynamicTreeRaycastCallback mRaycastCallback;
+
+        // ---------- Methods ---------- //
+
+        /// Return the AABB of a triangle of the test mesh
+        static AABB getTriangleAABB(int i) {
+            const Vector3 min(decimal((i * 37) % 101) * decimal(0.1), decimal((i * 13) % 29) * decimal(0.01),
+                              decimal((i * 71) % 97) * decimal(0.1));
+            return AABB(min, min + Vector3(decimal(0.1 + (i % 3) * 0.05), decimal(0.02), decimal(0.1)));
+        }
+
+    public :
+
+        // ---------- Methods ---------- //
+
+        /// Constructor
+        TestQuantizedBVH(const std::string& name) : Test(name) {
+
+        }
+
+        /// Run the tests
+        void run() {
+
+            testEmptyTree();
+            testOverlap();
+            testRaycast();
+            testClusterLeaves();
+        }
+
+        void testEmptyTree() {
+
+            QuantizedBVH tree(MemoryManager::getBaseAllocator());
+
+#ifdef IS_PROFILING_ACTIVE
+			/// Pointer to the profiler
+			Profiler* profiler = new Profiler();
+			tree.setProfiler(profiler);
+#endif
+
+            tree.build(nullptr, 0);
+            rp3d_test(tree.getNbNodes() == 0);
+
+            mOverlapCallback.reset();
+            tree.reportAllTrianglesOverlappingWithAABB(AABB(Vector3(-1, -1, -1), Vector3(1, 1, 1)), mOverlapCallback);
+            rp3d_test(mOverlapCallback.mOverlapNodes.size() == 0);
+
+            // A flat tree with a single triangle
+            AABB aabb(Vector3(1, 0, 1), Vector3(2, 0, 3));
+            tree.build(&aabb, 1);
+            rp3d_test(tree.getNbNodes() == 1);
+            tree.reportAllTrianglesOverlappingWithAABB(AABB(Vector3(0, -1, 0), Vector3(1.5, 1, 1.5)), mOverlapCallback);
+            rp3d_test(mOverlapCallback.isOverlapping(0));
+            mOverlapCallback.reset();
+            tree.reportAllTrianglesOverlappingWithAABB(AABB(Vector3(0, 0.5, 0), Vector3(1.5, 1, 1.5)), mOverlapCallback);
+            rp3d_test(mOverlapCallback.mOverlapNodes.size() == 0);
+
+#ifdef IS_PROFILING_ACTIVE
+			delete profiler;
+#endif
+        }
+
+        void testOverlap() {
+
+            const int nbTriangles = 3000;
+            std::vector<AABB> aabbs;
+            for (int i=0; i < nbTriangles; i++) {
+                aabbs.push_back(getTriangleAABB(i));
+            }
+
+            QuantizedBVH tree(MemoryManager::getBaseAllocator());
+
+#ifdef IS_PROFILING_ACTIVE
+			/// Pointer to the profiler
+			Profiler* profiler = new Profiler();
+			tree.setProfiler(profiler);
+#endif
+
+            tree.build(aabbs.data(), nbTriangles, 1);
+
+            // A node takes 16 bytes and there is one triangle per leaf
+            rp3d_test(sizeof(QuantizedBVHNode) == 16);
+            rp3d_test(tree.getNbNodes() == 2 * nbTriangles - 1);
+            rp3d_test(tree.getNodesSizeInBytes() == (2 * nbTriangles - 1) * sizeof(QuantizedBVHNode) +
+                                                    nbTriangles * sizeof(uint32));
+            rp3d_test(approxEqual(tree.getRootAABB().getMin().y, 0));
+
+            // The overlapping triangles are the same as with a brute force test except the
+            // triangles that are in the margin of the quantization
+            bool isSuperset = true;
+            bool isTight = true;
+            for (int i=0; i < 50; i++) {
+
+                const Vector3 min(decimal(i * 0.21), decimal((i % 5) * 0.05), decimal(i * 0.17));
+                const AABB query(min, min + Vector3(decimal(0.6), decimal(0.04), decimal(0.5)));
+                AABB inflatedQuery = query;
+                inflatedQuery.inflate(decimal(0.01), decimal(0.01), decimal(0.01));
+
+                mOverlapCallback.reset();
+                tree.reportAllTrianglesOverlappingWithAABB(query, mOverlapCallback);
+
+                for (int t=0; t < nbTriangles; t++) {
+                    if (aabbs[t].testCollision(query)) isSuperset &= mOverlapCallback.isOverlapping(t);
+                }
+                for (uint n=0; n < mOverlapCallback.mOverlapNodes.size(); n++) {
+                    isTight &= aabbs[mOverlapCallback.mOverlapNodes[n]].testCollision(inflatedQuery);
+                }
+            }
+            rp3d_test(isSuperset);
+            rp3d_test(isTight);
+
+#ifdef IS_PROFILING_ACTIVE
+			delete profiler;
+#endif
+        }
+
+        void testRaycast() {
+
+            const int nbTriangles = 3000;
+            std::vector<AABB> aabbs;
+            for (int i=0; i < nbTriangles; i++) {
+                aabbs.push_back(getTriangleAABB(i));
+            }
+
+            QuantizedBVH tree(MemoryManager::getBaseAllocator());
+
+#ifdef IS_PROFILING_ACTIVE
+			/// Pointer to the profiler
+			Profiler* profiler = new Profiler();
+			tree.setProfiler(profiler);
+#endif
+
+            tree.build(aabbs.data(), nbTriangles, 1);
+
+            // All the triangles whose AABB is hit by a ray are reported
+            bool isSuperset = true;
+            for (int i=0; i < 30; i++) {
+
+                const Ray ray(Vector3(decimal(i * 0.3), 2, decimal(-1 + i * 0.1)),
+                              Vector3(decimal(10 - i * 0.2), -1, decimal(11 - i * 0.3)));
+
+                mRaycastCallback.reset();
+                tree.raycast(ray, mRaycastCallback);
+
+                for (int t=0; t < nbTriangles; t++) {
+                    if (aabbs[t].testRayIntersect(ray)) isSuperset &= mRaycastCallback.isHit(t);
+                }
+            }
+            rp3d_test(isSuperset);
+
+            // A ray that misses the tree does not hit any triangle
+            mRaycastCallback.reset();
+            tree.raycast(Ray(Vector3(-5, 5, -5), Vector3(20, 5, 20)), mRaycastCallback);
+            rp3d_test(mRaycastCallback.mHitNodes.size() == 0);
+
+#ifdef IS_PROFILING_ACTIVE
+			delete profiler;
+#endif
+        }
+
+        /// Test the tree with clusters of triangles in the leaves
+        void testClusterLeaves() {
+
+            const int nbTriangles = 3001;
+            std::vector<AABB> aabbs;
+            for (int i=0; i < nbTriangles; i++) {
+                aabbs.push_back(getTriangleAABB(i));
+            }
+
+            QuantizedBVH tree(MemoryManager::getBaseAllocator());
+
+#ifdef IS_PROFILING_ACTIVE
+			/// Pointer to the profiler
+			Profiler* profiler = new Profiler();
+			tree.setProfiler(profiler);
+#endif
+
+            tree.build(aabbs.data(), nbTriangles);
+
+            // The triangles of a left child are a multiple of the maximum number of triangles
+            // of a leaf, so all the leaves are full except the last one
+            const uint nbFullLeaves = nbTriangles / QuantizedBVH::MAX_LEAF_TRIANGLES;
+            rp3d_test(tree.getNbTriangles() == uint(nbTriangles));
+            rp3d_test(tree.getNbNodes() == 2 * (nbFullLeaves + 1) - 1);
+
+            // Each triangle is in exactly one leaf
+            mOverlapCallback.reset();
+            tree.reportAllTrianglesOverlappingWithAABB(tree.getRootAABB(), mOverlapCallback);
+            rp3d_test(mOverlapCallback.mOverlapNodes.size() == uint(nbTriangles));
+            std::vector<bool> isReported(nbTriangles, false);
+            bool isReportedOnce = true;
+            for (uint n=0; n < mOverlapCallback.mOverlapNodes.size(); n++) {
+                isReportedOnce &= !isReported[mOverlapCallback.mOverlapNodes[n]];
+                isReported[mOverlapCallback.mOverlapNodes[n]] = true;
+            }
+            rp3d_test(isReportedOnce);
+
+            // All the triangles whose AABB overlaps a query or is hit by a ray are reported
+            bool isSuperset = true;
+            for (int i=0; i < 50; i++) {
+
+                const Vector3 min(decimal(i * 0.21), decimal((i % 5) * 0.05), decimal(i * 0.17));
+                const AABB query(min, min + Vector3(decimal(0.6), decimal(0.04), decimal(0.5)));
+
+                mOverlapCallback.reset();
+                tree.reportAllTrianglesOverlappingWithAABB(query, mOverlapCallback);
+                for (int t=0; t < nbTriangles; t++) {
+                    if (aabbs[t].testCollision(query)) isSuperset &= mOverlapCallback.isOverlapping(t);
+                }
+
+                const Ray ray(Vector3(decimal(i * 0.2), 2, decimal(-1 + i * 0.1)),
+                              Vector3(decimal(10 - i * 0.2), -1, decimal(11 - i * 0.3)));
+
+                mRaycastCallback.reset();
+                tree.raycast(ray, mRaycastCallback);
+                for (int t=0; t < nbTriangles; t++) {
+                    if (aabbs[t].testRayIntersect(ray)) isSuperset &= mRaycastCallback.isHit(t);
+                }
+            }
+            rp3d_test(isSuperset);
+
+#ifdef IS_PROFILING_ACTIVE
+			delete profiler;
+#endif
+        }
+ };
+
+}
+
+#endif
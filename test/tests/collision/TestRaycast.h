@@ -40,6 +40,7 @@
 #include "collision/TriangleMesh.h"
 #include "collision/TriangleVertexArray.h"
 #include "collision/RaycastInfo.h"
+#include "engine/DefaultTaskScheduler.h"
 
 /// Reactphysics3D namespace
 namespace reactphysics3d {
@@ -89,6 +90,25 @@ class WorldRaycastCallback : public RaycastCallback {
         }
 };
 
+/// Class ClosestRaycastCallback
+class ClosestRaycastCallback : public RaycastCallback {
+
+    public:
+
+        ProxyShape* proxyShape = nullptr;
+        decimal hitFraction = decimal(1.0);
+
+        virtual decimal notifyRaycastHit(const RaycastInfo& info) override {
+
+            if (proxyShape == nullptr || info.hitFraction < hitFraction) {
+                proxyShape = info.proxyShape;
+                hitFraction = info.hitFraction;
+            }
+
+            return hitFraction;
+        }
+};
+
 // Class TestPointInside
 /**
  * Unit test for the CollisionBody::testPointInside() method.
@@ -102,8 +122,6 @@ class TestRaycast : public Test {
         // Raycast callback class
         WorldRaycastCallback mCallback;
 
-        DefaultAllocator mAllocator;
-
         // Epsilon
         decimal epsilon;
 
@@ -208,7 +226,7 @@ class TestRaycast : public Test {
             triangleVertices[1] = Vector3(105, 100, 0);
             triangleVertices[2] = Vector3(100, 103, 0);
             Vector3 triangleVerticesNormals[3] = {Vector3(0, 0, 1), Vector3(0, 0, 1), Vector3(0, 0, 1)};
-            mTriangleShape = new TriangleShape(triangleVertices, triangleVerticesNormals, 0, mAllocator);
+            mTriangleShape = new TriangleShape(triangleVertices, triangleVerticesNormals, 0);
             mTriangleProxyShape = mTriangleBody->addCollisionShape(mTriangleShape, mShapeTransform);
 
             mCapsuleShape = new CapsuleShape(2, 5);
@@ -336,6 +354,8 @@ class TestRaycast : public Test {
             testTriangle();
             testConcaveMesh();
             testHeightField();
+            testHeightFieldGridTraversal();
+            testRaycastBatch();
         }
 
         /// Test the ProxyBoxShape::raycast(), CollisionBody::raycast() and
@@ -2049,6 +2069,153 @@ class TestRaycast : public Test {
             mWorld->raycast(Ray(ray14.point1, ray14.point2, decimal(0.8)), &mCallback);
             rp3d_test(mCallback.isHit);
         }
+        /// Compare the closest hits of a batch of rays and of the closest-hit and any-hit
+        /// raycasts with the closest hits of the same rays cast with a callback (with the
+        /// different broad-phases and with a task scheduler)
+        void testRaycastBatch() {
+
+            DefaultTaskScheduler scheduler(3);
+
+            for (uint c=0; c < 8; c++) {
+
+                WorldSettings settings;
+                settings.broadPhaseType = c % 4 == 2 ? BroadPhaseType::SWEEP_AND_PRUNE :
+                                          c % 4 == 3 ? BroadPhaseType::GRID : BroadPhaseType::DYNAMIC_AABB_TREE;
+                settings.isStaticBroadPhaseTreeEnabled = c % 4 == 1;
+                settings.broadPhaseGridCellSize = decimal(8.0);
+                settings.taskScheduler = c < 4 ? nullptr : &scheduler;
+                CollisionWorld world(settings);
+
+                // A grid of spheres, boxes and concave meshes (rays can hit several of them)
+                for (int i=0; i < 6; i++) {
+                    for (int j=0; j < 6; j++) {
+                        CollisionBody* body = world.createCollisionBody(Transform(Vector3(i * 5 - 12, 0, j * 5 - 12),
+                                                                                  Quaternion::identity()));
+                        CollisionShape* shape = (i + j) % 3 == 0 ? static_cast<CollisionShape*>(mSphereShape) :
+                                                (i + j) % 3 == 1 ? static_cast<CollisionShape*>(mBoxShape) :
+                                                                   static_cast<CollisionShape*>(mConcaveMeshShape);
+                        if (j % 2 == 0) body->setType(BodyType::STATIC);
+                        ProxyShape* proxyShape = body->addCollisionShape(shape, Transform::identity());
+                        proxyShape->setCollisionCategoryBits(i < 3 ? CATEGORY1 : CATEGORY2);
+                    }
+                }
+
+                // Rays from points around the grid toward points of the grid (more rays than
+                // needed for the parallel raycast)
+                std::vector<Ray> rays;
+                for (int i=0; i < 400; i++) {
+                    const Vector3 origin(decimal((i * 37) % 41 - 20), decimal(15 - (i * 11) % 9), decimal((i * 23) % 43 - 21));
+                    const Vector3 target(decimal((i * 13) % 29 - 14), decimal((i * 7) % 5 - 2), decimal((i * 17) % 31 - 15));
+                    rays.push_back(Ray(origin, target, i % 4 == 0 ? decimal(0.6) : decimal(1.0)));
+                }
+
+                for (uint m=0; m < 2; m++) {
+
+                    const unsigned short categoryMask = m == 0 ? 0xFFFF : CATEGORY2;
+
+                    std::vector<RaycastHit> hits(rays.size());
+                    world.raycastBatch(&(rays[0]), static_cast<uint>(rays.size()), &(hits[0]), categoryMask);
+
+                    uint nbHits = 0;
+                    for (uint r=0; r < rays.size(); r++) {
+
+                        ClosestRaycastCallback callback;
+                        world.raycast(rays[r], &callback, categoryMask);
+
+                        RaycastHit closestHit;
+                        rp3d_test(world.raycastClosest(rays[r], closestHit, categoryMask) == closestHit.isHit());
+                        rp3d_test(closestHit.isHit() == (callback.proxyShape != nullptr));
+                        rp3d_test(world.raycastAny(rays[r], categoryMask) == (callback.proxyShape != nullptr));
+                        if (closestHit.isHit()) {
+                            rp3d_test(approxEqual(closestHit.hitFraction, callback.hitFraction, epsilon));
+                            rp3d_test(closestHit.body == closestHit.proxyShape->getBody());
+                        }
+
+                        rp3d_test(hits[r].isHit() == (callback.proxyShape != nullptr));
+                        if (hits[r].isHit()) {
+                            nbHits++;
+                            rp3d_test(approxEqual(hits[r].hitFraction, callback.hitFraction, epsilon));
+                            rp3d_test(hits[r].body == hits[r].proxyShape->getBody());
+                            rp3d_test(hits[r].hitFraction <= rays[r].maxFraction);
+                        }
+                        else {
+                            rp3d_test(hits[r].hitFraction == rays[r].maxFraction);
+                        }
+                    }
+                    rp3d_test(nbHits > 0);
+                }
+            }
+        }
+
+        /// Compare the raycast of height fields (that walks through the cells of the grid along
+        /// the ray) with a brute force raycast against all the triangles of the height field
+        void testHeightFieldGridTraversal() {
+
+            const int nbColumns = 33;
+            const int nbRows = 17;
+            float heights[nbColumns * nbRows];
+            for (int j=0; j < nbRows; j++) {
+                for (int i=0; i < nbColumns; i++) {
+                    heights[j * nbColumns + i] = float(3.0 * std::sin(0.4 * i) + 2.0 * std::cos(0.3 * j));
+                }
+            }
+
+            CollisionWorld world;
+            CollisionBody* body = world.createCollisionBody(Transform::identity());
+
+            // Pseudo-random generator of the rays
+            uint32 seed = 12345;
+            auto random = [&seed](decimal min, decimal max) {
+                seed = seed * 1664525u + 1013904223u;
+                return min + (max - min) * decimal(seed >> 8) / decimal(1 << 24);
+            };
+
+            for (int upAxis = 0; upAxis < 3; upAxis++) {
+
+                HeightFieldShape shape(nbColumns, nbRows, -5, 5, heights, HeightFieldShape::HeightDataType::HEIGHT_FLOAT_TYPE,
+                                       upAxis, 1, Vector3(decimal(1.5), decimal(0.7), decimal(2.0)));
+                ProxyShape* proxyShape = body->addCollisionShape(&shape, Transform::identity());
+
+                Vector3 min, max;
+                shape.getLocalBounds(min, max);
+                min -= Vector3(5, 5, 5);
+                max += Vector3(5, 5, 5);
+
+                uint nbHits = 0;
+                for (int r=0; r < 300; r++) {
+
+                    const Vector3 point1(random(min.x, max.x), random(min.y, max.y), random(min.z, max.z));
+                    const Vector3 point2(random(min.x, max.x), random(min.y, max.y), random(min.z, max.z));
+                    const Ray ray(point1, point2, random(decimal(0.2), decimal(1.0)));
+
+                    RaycastInfo raycastInfo;
+                    const bool isHit = proxyShape->raycast(ray, raycastInfo);
+
+                    // Brute force raycast
+                    RaycastInfo bruteForceRaycastInfo;
+                    TriangleOverlapCallback callback(ray, proxyShape, bruteForceRaycastInfo, shape,
+                                                     MemoryManager::getBaseAllocator());
+#ifdef IS_PROFILING_ACTIVE
+                    callback.setProfiler(world.getProfiler());
+#endif
+                    shape.testAllTriangles(callback, AABB(Vector3(-1000, -1000, -1000), Vector3(1000, 1000, 1000)));
+
+                    rp3d_test(isHit == callback.getIsHit());
+                    if (isHit && callback.getIsHit()) {
+                        nbHits++;
+                        rp3d_test(approxEqual(raycastInfo.hitFraction, bruteForceRaycastInfo.hitFraction, decimal(0.0001)));
+                        rp3d_test(approxEqual(raycastInfo.worldPoint, bruteForceRaycastInfo.worldPoint, decimal(0.001)));
+                    }
+                }
+
+                // Some of the rays hit the height field
+                rp3d_test(nbHits > 0);
+
+                body->removeCollisionShape(proxyShape);
+            }
+
+            world.destroyCollisionBody(body);
+        }
 };
 
 }
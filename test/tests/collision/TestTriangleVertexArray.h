@@ -251,6 +251,91 @@ class TestTriangleVertexArray : public Test {
             rp3d_test(approxEqual(triangle1Normals[0], mNormal0, decimal(0.000001)));
             rp3d_test(approxEqual(triangle1Normals[1], mNormal3, decimal(0.000001)));
             rp3d_test(approxEqual(triangle1Normals[2], mNormal1, decimal(0.000001)));
+
+            testQuantizedVertexArray();
+        }
+
+        /// Test the arrays with 16-bit quantized vertices and octahedral normals
+        void testQuantizedVertexArray() {
+
+            // Quantization step of 1/4096 so that the vertices are quantized exactly
+            TriangleVertexArray::VerticesQuantization quantization;
+            for (int i=0; i < 3; i++) {
+                quantization.origin[i] = -8.0f;
+                quantization.scale[i] = 1.0f / 4096.0f;
+            }
+
+            const Vector3 vertices[4] = {mVertex0, mVertex1, mVertex2, mVertex3};
+            const Vector3 normals[4] = {mNormal0, mNormal1, mNormal2, mNormal3};
+            uint16 quantizedVertices[4 * 3];
+            int16 encodedNormals[4 * 2];
+            for (int v=0; v < 4; v++) {
+                TriangleVertexArray::quantizeVertex(vertices[v], quantization, quantizedVertices + 3 * v);
+                TriangleVertexArray::encodeOctahedralNormal(normals[v], encodedNormals + 2 * v);
+            }
+
+            // Array with the normals provided by the user
+            TriangleVertexArray userNormalsArray(4, quantizedVertices, 3 * sizeof(uint16), encodedNormals,
+                                                 2 * sizeof(int16), 2, mIndices1, 3 * sizeof(uint),
+                                                 TriangleVertexArray::VertexDataType::VERTEX_QUANTIZED_SHORT_TYPE,
+                                                 TriangleVertexArray::NormalDataType::NORMAL_OCTAHEDRAL_SHORT_TYPE,
+                                                 TriangleVertexArray::IndexDataType::INDEX_INTEGER_TYPE, &quantization);
+
+            // Array with the computed normals (stored with the octahedral encoding)
+            TriangleVertexArray computedNormalsArray(4, quantizedVertices, 3 * sizeof(uint16), 2, mIndices1,
+                                                     3 * sizeof(uint),
+                                                     TriangleVertexArray::VertexDataType::VERTEX_QUANTIZED_SHORT_TYPE,
+                                                     TriangleVertexArray::IndexDataType::INDEX_INTEGER_TYPE,
+                                                     &quantization);
+            rp3d_test(computedNormalsArray.getVertexNormalDataType() ==
+                      TriangleVertexArray::NormalDataType::NORMAL_OCTAHEDRAL_SHORT_TYPE);
+            rp3d_test(computedNormalsArray.getVerticesNormalsStride() == 2 * sizeof(int16));
+
+            for (uint t=0; t < 2; t++) {
+
+                Vector3 expectedVertices[3];
+                Vector3 expectedNormals[3];
+                mTriangleVertexArray1->getTriangleVertices(t, expectedVertices);
+                mTriangleVertexArray1->getTriangleVerticesNormals(t, expectedNormals);
+
+                Vector3 triangleVertices[3];
+                Vector3 userNormals[3];
+                Vector3 computedNormals[3];
+                userNormalsArray.getTriangleVertices(t, triangleVertices);
+                userNormalsArray.getTriangleVerticesNormals(t, userNormals);
+                computedNormalsArray.getTriangleVerticesNormals(t, computedNormals);
+
+                uint indices[3];
+                userNormalsArray.getTriangleVerticesIndices(t, indices);
+
+                for (int k=0; k < 3; k++) {
+                    rp3d_test(approxEqual(triangleVertices[k], expectedVertices[k], decimal(0.000001)));
+                    rp3d_test(approxEqual(userNormals[k], normals[indices[k]], decimal(0.001)));
+                    rp3d_test(approxEqual(computedNormals[k], expectedNormals[k], decimal(0.001)));
+                }
+            }
+
+            Vector3 vertex;
+            userNormalsArray.getVertex(3, &vertex);
+            rp3d_test(approxEqual(vertex, mVertex3, decimal(0.000001)));
+
+            // The octahedral encoding of normals in all the octants (and along the axes)
+            for (int i=0; i < 27; i++) {
+                Vector3 normal(decimal(i % 3 - 1), decimal((i / 3) % 3 - 1), decimal(i / 9 - 1));
+                normal += Vector3(decimal(0.1) * (i % 2), decimal(0.0), decimal(0.2));
+                normal.normalize();
+
+                int16 encodedNormal[2];
+                TriangleVertexArray::encodeOctahedralNormal(normal, encodedNormal);
+                TriangleVertexArray normalArray(1, quantizedVertices, 3 * sizeof(uint16), encodedNormal,
+                                                2 * sizeof(int16), 0, mIndices1, 3 * sizeof(uint),
+                                                TriangleVertexArray::VertexDataType::VERTEX_QUANTIZED_SHORT_TYPE,
+                                                TriangleVertexArray::NormalDataType::NORMAL_OCTAHEDRAL_SHORT_TYPE,
+                                                TriangleVertexArray::IndexDataType::INDEX_INTEGER_TYPE, &quantization);
+                Vector3 decodedNormal;
+                normalArray.getNormal(0, &decodedNormal);
+                rp3d_test(approxEqual(decodedNormal, normal, decimal(0.001)));
+            }
         }
 
 };
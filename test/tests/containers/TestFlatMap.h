@@ -0,0 +1,298 @@
+/********************************************************************************
+* ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
+* Copyright (c) 2010-2018 Daniel Chappuis                                       *
+*********************************************************************************
+*                                                                               *
+* This software is provided 'as-is', without any express or implied warranty.   *
+* In no event will the authors be held liable for any damages arising from the  *
+* use of this software.                                                         *
+*                                                                               *
+* Permission is granted to anyone to use this software for any purpose,         *
+* including commercial applications, and to alter it and redistribute it        *
+* freely, subject to the following restrictions:                                *
+*                                                                               *
+* 1. The origin of this software must not be misrepresented; you must not claim *
+*    that you wrote the original software. If you use this software in a        *
+*    product, an acknowledgment in the product documentation would be           *
+*    appreciated but is not required.                                           *
+*                                                                               *
+* 2. Altered source versions must be plainly marked as such, and must not be    *
+*    misrepresented as being the original software.                             *
+*                                                                               *
+* 3. This notice may not be removed or altered from any source distribution.    *
+*                                                                               *
+********************************************************************************/
+
+
+#ifndef TEST_FLAT_MAP_H
+#define TEST_FLAT_MAP_H
+
+// Libraries
+#include "Test.h"
+#include "containers/FlatMap.h"
+#include "memory/DefaultAllocator.h"
+
+// Key to test flat map with always same hash values
+namespace reactphysics3d {
+    struct TestFlatKey {
+        int key;
+
+        TestFlatKey(int k) :key(k) {}
+
+        bool operator==(const TestFlatKey& testKey) const {
+            return key == testKey.key;
+        }
+    };
+}
+
+// Hash function for struct TestFlatKey
+namespace std {
+
+  template <> struct hash<reactphysics3d::TestFlatKey> {
+
+    size_t operator()(const reactphysics3d::TestFlatKey& key) const {
+        return 1;
+    }
+  };
+}
+
+/// Reactphysics3D namespace
+namespace reactphysics3d {
+
+// Class TestFlatMap
+/**
+ * Unit test for the FlatMap class
+ */
+class TestFlatMap : public Test {
+
+    private :
+
+        // ---------- Atributes ---------- //
+
+        DefaultAllocator mAllocator;
+
+    public :
+
+        // ---------- Methods ---------- //
+
+        /// Constructor
+        TestFlatMap(const std::string& name) : Test(name) {
+
+        }
+
+        /// Run the tests
+        void run() {
+
+            testConstructors();
+            testReserve();
+            testAddRemoveClear();
+            testSameHashCodes();
+            testIndexing();
+            testEquality();
+            testAssignment();
+            testIterators();
+        }
+
+        void testConstructors() {
+
+            FlatMap<int, std::string> map1(mAllocator);
+            rp3d_test(map1.capacity() == 0);
+            rp3d_test(map1.size() == 0);
+
+            FlatMap<int, std::string> map2(mAllocator, 100);
+            rp3d_test(map2.capacity() >= 100);
+            rp3d_test(map2.size() == 0);
+
+            FlatMap<int, std::string> map3(mAllocator);
+            map3.add(Pair<int, std::string>(1, "test1"));
+            map3.add(Pair<int, std::string>(2, "test2"));
+            FlatMap<int, std::string> map4(map3);
+            rp3d_test(map4.size() == 2);
+            rp3d_test(map4[1] == "test1");
+            rp3d_test(map4[2] == "test2");
+        }
+
+        void testReserve() {
+
+            FlatMap<int, int> map(mAllocator);
+            map.reserve(1000);
+            const int capacity = map.capacity();
+            rp3d_test(capacity >= 1000);
+
+            // The reserved pairs can be added without a larger table
+            for (int i=0; i < 1000; i++) {
+                map.add(Pair<int, int>(i, 2 * i));
+            }
+            rp3d_test(map.capacity() == capacity);
+            rp3d_test(map.size() == 1000);
+
+            map.reserve(10);
+            rp3d_test(map.capacity() == capacity);
+        }
+
+        void testAddRemoveClear() {
+
+            FlatMap<int, int> map(mAllocator);
+            for (int i=0; i < 5000; i++) {
+                map.add(Pair<int, int>(i, i + 1));
+            }
+            rp3d_test(map.size() == 5000);
+
+            bool isValid = true;
+            for (int i=0; i < 5000; i++) {
+                isValid &= map.containsKey(i) && map[i] == i + 1;
+            }
+            rp3d_test(isValid);
+            rp3d_test(!map.containsKey(5000));
+
+            // Replace a value
+            map.add(Pair<int, int>(10, 20), true);
+            rp3d_test(map[10] == 20);
+            rp3d_test(map.size() == 5000);
+
+            // Remove the even keys
+            for (int i=0; i < 5000; i += 2) {
+                map.remove(i);
+            }
+            rp3d_test(map.size() == 2500);
+            isValid = true;
+            for (int i=0; i < 5000; i++) {
+                isValid &= map.containsKey(i) == (i % 2 == 1);
+            }
+            rp3d_test(isValid);
+            rp3d_test(map.remove(0) == map.end());
+
+            // Add and remove many times without growing the table (the deleted slots are reused)
+            const int capacity = map.capacity();
+            for (int i=0; i < 20000; i++) {
+                map.add(Pair<int, int>(10000 + i, i));
+                map.remove(10000 + i);
+            }
+            rp3d_test(map.capacity() == capacity);
+            rp3d_test(map.size() == 2500);
+
+            map.clear();
+            rp3d_test(map.size() == 0);
+            rp3d_test(map.begin() == map.end());
+            rp3d_test(!map.containsKey(1));
+            map.add(Pair<int, int>(1, 2));
+            rp3d_test(map[1] == 2);
+        }
+
+        void testSameHashCodes() {
+
+            // The keys with the same hash code are stored in several groups
+            FlatMap<TestFlatKey, int> map(mAllocator);
+            for (int i=0; i < 100; i++) {
+                map.add(Pair<TestFlatKey, int>(TestFlatKey(i), i));
+            }
+            rp3d_test(map.size() == 100);
+
+            for (int i=0; i < 100; i += 3) {
+                map.remove(TestFlatKey(i));
+            }
+
+            bool isValid = true;
+            for (int i=0; i < 100; i++) {
+                isValid &= map.containsKey(TestFlatKey(i)) == (i % 3 != 0);
+                if (i % 3 != 0) {
+                    isValid &= map[TestFlatKey(i)] == i;
+                }
+            }
+            rp3d_test(isValid);
+        }
+
+        void testIndexing() {
+
+            FlatMap<int, int> map(mAllocator);
+            map.add(Pair<int, int>(2, 3));
+            map.add(Pair<int, int>(5, 6));
+
+            map[2] = 4;
+            rp3d_test(map[2] == 4);
+            rp3d_test(map.find(5)->second == 6);
+            rp3d_test(map.find(7) == map.end());
+
+            bool isExceptionThrown = false;
+            try {
+                map[7];
+            }
+            catch (const std::runtime_error&) {
+                isExceptionThrown = true;
+            }
+            rp3d_test(isExceptionThrown);
+        }
+
+        void testEquality() {
+
+            FlatMap<std::string, int> map1(mAllocator, 10);
+            FlatMap<std::string, int> map2(mAllocator, 2);
+            rp3d_test(map1 == map2);
+
+            map1.add(Pair<std::string, int>("a", 1));
+            map1.add(Pair<std::string, int>("b", 2));
+            map2.add(Pair<std::string, int>("b", 2));
+            rp3d_test(map1 != map2);
+
+            map2.add(Pair<std::string, int>("a", 1));
+            rp3d_test(map1 == map2);
+
+            map2.add(Pair<std::string, int>("a", 3), true);
+            rp3d_test(map1 != map2);
+        }
+
+        void testAssignment() {
+
+            FlatMap<int, int> map1(mAllocator);
+            map1.add(Pair<int, int>(1, 3));
+            map1.add(Pair<int, int>(2, 6));
+
+            FlatMap<int, int> map2(mAllocator);
+            map2.add(Pair<int, int>(5, 5));
+            map2 = map1;
+            rp3d_test(map2 == map1);
+            rp3d_test(!map2.containsKey(5));
+
+            FlatMap<int, int> map3(mAllocator);
+            map2 = map3;
+            rp3d_test(map2.size() == 0);
+        }
+
+        void testIterators() {
+
+            FlatMap<int, int> map(mAllocator);
+            rp3d_test(map.begin() == map.end());
+
+            for (int i=0; i < 100; i++) {
+                map.add(Pair<int, int>(i, i));
+            }
+
+            int sum = 0;
+            for (auto it = map.begin(); it != map.end(); ++it) {
+                sum += it->second;
+            }
+            rp3d_test(sum == 4950);
+
+            // Remove the odd keys while iterating
+            for (auto it = map.begin(); it != map.end(); ) {
+                if (it->first % 2 == 1) {
+                    it = map.remove(it);
+                }
+                else {
+                    ++it;
+                }
+            }
+            rp3d_test(map.size() == 50);
+
+            int nbPairs = 0;
+            for (auto it = map.begin(); it != map.end(); ++it) {
+                rp3d_test(it->first % 2 == 0);
+                nbPairs++;
+            }
+            rp3d_test(nbPairs == 50);
+        }
+ };
+
+}
+
+#endif
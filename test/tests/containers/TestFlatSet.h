@@ -0,0 +1,200 @@
+/********************************************************************************
+* ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
+* Copyright (c) 2010-2018 Daniel Chappuis                                       *
+*********************************************************************************
+*                                                                               *
+* This software is provided 'as-is', without any express or implied warranty.   *
+* In no event will the authors be held liable for any damages arising from the  *
+* use of this software.                                                         *
+*                                                                               *
+* Permission is granted to anyone to use this software for any purpose,         *
+* including commercial applications, and to alter it and redistribute it        *
+* freely, subject to the following restrictions:                                *
+*                                                                               *
+* 1. The origin of this software must not be misrepresented; you must not claim *
+*    that you wrote the original software. If you use this software in a        *
+*    product, an acknowledgment in the product documentation would be           *
+*    appreciated but is not required.                                           *
+*                                                                               *
+* 2. Altered source versions must be plainly marked as such, and must not be    *
+*    misrepresented as being the original software.                             *
+*                                                                               *
+* 3. This notice may not be removed or altered from any source distribution.    *
+*                                                                               *
+********************************************************************************/
+
+
+#ifndef TEST_FLAT_SET_H
+#define TEST_FLAT_SET_H
+
+// Libraries
+#include "Test.h"
+#include "containers/FlatSet.h"
+#include "memory/DefaultAllocator.h"
+
+/// Reactphysics3D namespace
+namespace reactphysics3d {
+
+// Class TestFlatSet
+/**
+ * Unit test for the FlatSet class
+ */
+class TestFlatSet : public Test {
+
+    private :
+
+        // ---------- Atributes ---------- //
+
+        DefaultAllocator mAllocator;
+
+    public :
+
+        // ---------- Methods ---------- //
+
+        /// Constructor
+        TestFlatSet(const std::string& name) : Test(name) {
+
+        }
+
+        /// Run the tests
+        void run() {
+
+            testConstructors();
+            testAddRemoveClear();
+            testPairValues();
+            testEqualityAssignment();
+            testIterators();
+        }
+
+        void testConstructors() {
+
+            FlatSet<std::string> set1(mAllocator);
+            rp3d_test(set1.capacity() == 0);
+            rp3d_test(set1.size() == 0);
+
+            FlatSet<std::string> set2(mAllocator, 100);
+            rp3d_test(set2.capacity() >= 100);
+            rp3d_test(set2.size() == 0);
+
+            FlatSet<int> set3(mAllocator);
+            set3.add(10);
+            set3.add(20);
+            set3.add(20);
+            rp3d_test(set3.size() == 2);
+
+            FlatSet<int> set4(set3);
+            rp3d_test(set4.size() == 2);
+            rp3d_test(set4.contains(10));
+            rp3d_test(set4.contains(20));
+        }
+
+        void testAddRemoveClear() {
+
+            FlatSet<int> set(mAllocator);
+            for (int i=0; i < 3000; i++) {
+                set.add(i * 7);
+            }
+            rp3d_test(set.size() == 3000);
+
+            bool isValid = true;
+            for (int i=0; i < 3000 * 7; i++) {
+                isValid &= set.contains(i) == (i % 7 == 0);
+            }
+            rp3d_test(isValid);
+
+            for (int i=0; i < 3000; i += 2) {
+                set.remove(i * 7);
+            }
+            rp3d_test(set.size() == 1500);
+            rp3d_test(!set.contains(0));
+            rp3d_test(set.contains(7));
+            rp3d_test(set.find(7) != set.end());
+            rp3d_test(set.find(0) == set.end());
+
+            // The set is cleared at each frame (like the moved shapes of the broad-phase)
+            const int capacity = set.capacity();
+            for (int frame=0; frame < 10; frame++) {
+                set.clear();
+                rp3d_test(set.size() == 0);
+                for (int i=0; i < 1000; i++) {
+                    set.add(i);
+                }
+                rp3d_test(set.size() == 1000);
+            }
+            rp3d_test(set.capacity() == capacity);
+        }
+
+        void testPairValues() {
+
+            FlatSet<Pair<uint, uint>> set(mAllocator);
+            for (uint i=0; i < 50; i++) {
+                for (uint j=i+1; j < 50; j++) {
+                    set.add(Pair<uint, uint>(i, j));
+                }
+            }
+            rp3d_test(set.size() == 50 * 49 / 2);
+            rp3d_test(set.contains(Pair<uint, uint>(3, 40)));
+            rp3d_test(!set.contains(Pair<uint, uint>(40, 3)));
+
+            set.remove(Pair<uint, uint>(3, 40));
+            rp3d_test(!set.contains(Pair<uint, uint>(3, 40)));
+            rp3d_test(set.size() == 50 * 49 / 2 - 1);
+        }
+
+        void testEqualityAssignment() {
+
+            FlatSet<int> set1(mAllocator);
+            FlatSet<int> set2(mAllocator, 50);
+            rp3d_test(set1 == set2);
+
+            set1.add(1);
+            set1.add(2);
+            set2.add(2);
+            rp3d_test(set1 != set2);
+            set2.add(1);
+            rp3d_test(set1 == set2);
+
+            FlatSet<int> set3(mAllocator);
+            set3.add(8);
+            set3 = set1;
+            rp3d_test(set3 == set1);
+            rp3d_test(!set3.contains(8));
+        }
+
+        void testIterators() {
+
+            FlatSet<int> set(mAllocator);
+            rp3d_test(set.begin() == set.end());
+
+            for (int i=0; i < 100; i++) {
+                set.add(i);
+            }
+
+            int sum = 0;
+            for (auto it = set.begin(); it != set.end(); ++it) {
+                sum += *it;
+            }
+            rp3d_test(sum == 4950);
+
+            // Remove the multiples of three while iterating
+            for (auto it = set.begin(); it != set.end(); ) {
+                if (*it % 3 == 0) {
+                    it = set.remove(it);
+                }
+                else {
+                    ++it;
+                }
+            }
+            rp3d_test(set.size() == 66);
+
+            bool isValid = true;
+            for (auto it = set.begin(); it != set.end(); ++it) {
+                isValid &= *it % 3 != 0;
+            }
+            rp3d_test(isValid);
+        }
+ };
+
+}
+
+#endif
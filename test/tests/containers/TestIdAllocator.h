@@ -0,0 +1,200 @@
+/********************************************************************************
+* ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
+* Copyright (c) 2010-2016 Daniel Chappuis                                       *
+*********************************************************************************
+*                                                                               *
+* This software is provided 'as-is', without any express or implied warranty.   *
+* In no event will the authors be held liable for any damages arising from the  *
+* use of this software.                                                         *
+*                                                                               *
+* Permission is granted to anyone to use this software for any purpose,         *
+* including commercial applications, and to alter it and redistribute it        *
+* freely, subject to the following restrictions:                                *
+*                                                                               *
+* 1. The origin of this software must not be misrepresented; you must not claim *
+*    that you wrote the original software. If you use this software in a        *
+*    product, an acknowledgment in the product documentation would be           *
+*    appreciated but is not required.                                           *
+*                                                                               *
+* 2. Altered source versions must be plainly marked as such, and must not be    *
+*    misrepresented as being the original software.                             *
+*                                                                               *
+* 3. This notice may not be removed or altered from any source distribution.    *
+*                                                                               *
+********************************************************************************/
+
+#ifndef TEST_ID_ALLOCATOR_H
+#define TEST_ID_ALLOCATOR_H
+
+// Libraries
+#include "Test.h"
+#include "containers/IdAllocator.h"
+#include "memory/DefaultAllocator.h"
+#include <cstring>
+
+/// Reactphysics3D namespace
+namespace reactphysics3d {
+
+// Class TestIdAllocator
+/**
+ * Unit test for the IdAllocator class
+ */
+class TestIdAllocator : public Test {
+
+    private :
+
+        // ---------- Atributes ---------- //
+
+        DefaultAllocator mAllocator;
+
+    public :
+
+        // ---------- Methods ---------- //
+
+        /// Constructor
+        TestIdAllocator(const std::string& name) : Test(name) {
+
+        }
+
+        /// Run the tests
+        void run() {
+
+            testAllocateRelease();
+            testGenerations();
+            testSaveAndRestore();
+        }
+
+        void testAllocateRelease() {
+
+            IdAllocator allocator(mAllocator);
+            rp3d_test(allocator.getNbIds() == 0);
+
+            // The first identifiers are the indices of the slots
+            uint64 id0 = allocator.allocate();
+            uint64 id1 = allocator.allocate();
+            uint64 id2 = allocator.allocate();
+            rp3d_test(id0 == 0);
+            rp3d_test(id1 == 1);
+            rp3d_test(id2 == 2);
+            rp3d_test(allocator.getNbIds() == 3);
+            rp3d_test(allocator.isValid(id0));
+            rp3d_test(allocator.isValid(id1));
+            rp3d_test(allocator.isValid(id2));
+            rp3d_test(!allocator.isValid(3));
+
+            allocator.release(id1);
+            rp3d_test(allocator.getNbIds() == 2);
+            rp3d_test(!allocator.isValid(id1));
+            rp3d_test(allocator.isValid(id0));
+            rp3d_test(allocator.isValid(id2));
+
+            // The last released slot is used first
+            allocator.release(id0);
+            uint64 id3 = allocator.allocate();
+            uint64 id4 = allocator.allocate();
+            uint64 id5 = allocator.allocate();
+            rp3d_test(IdAllocator::getSlotIndex(id3) == 0);
+            rp3d_test(IdAllocator::getSlotIndex(id4) == 1);
+            rp3d_test(IdAllocator::getSlotIndex(id5) == 3);
+            rp3d_test(allocator.getNbIds() == 4);
+
+            // Many identifiers
+            IdAllocator allocator2(mAllocator);
+            allocator2.reserve(1000);
+            List<uint64> ids(mAllocator);
+            for (uint i=0; i < 1000; i++) {
+                ids.add(allocator2.allocate());
+            }
+            for (uint i=0; i < 1000; i += 2) {
+                allocator2.release(ids[i]);
+            }
+            rp3d_test(allocator2.getNbIds() == 500);
+            bool isValid = true;
+            for (uint i=0; i < 1000; i++) {
+                isValid &= allocator2.isValid(ids[i]) == (i % 2 == 1);
+            }
+            rp3d_test(isValid);
+        }
+
+        void testGenerations() {
+
+            IdAllocator allocator(mAllocator);
+
+            uint64 id0 = allocator.allocate();
+            rp3d_test(IdAllocator::getGeneration(id0) == 0);
+
+            // A released identifier is never given again for the same slot
+            allocator.release(id0);
+            uint64 id1 = allocator.allocate();
+            rp3d_test(id1 != id0);
+            rp3d_test(IdAllocator::getSlotIndex(id1) == IdAllocator::getSlotIndex(id0));
+            rp3d_test(IdAllocator::getGeneration(id1) == 1);
+            rp3d_test(!allocator.isValid(id0));
+            rp3d_test(allocator.isValid(id1));
+
+            allocator.release(id1);
+            uint64 id2 = allocator.allocate();
+            rp3d_test(IdAllocator::getGeneration(id2) == 2);
+            rp3d_test(id2 == IdAllocator::computeId(0, 2));
+            rp3d_test(!allocator.isValid(id1));
+            rp3d_test(allocator.isValid(id2));
+        }
+
+        void testSaveAndRestore() {
+
+            IdAllocator allocator(mAllocator);
+            List<uint64> ids(mAllocator);
+            for (uint i=0; i < 6; i++) {
+                ids.add(allocator.allocate());
+            }
+            allocator.release(ids[1]);
+            allocator.release(ids[4]);
+            ids.removeAt(4);
+            ids.removeAt(1);
+
+            WorldStateWriter sizeWriter(nullptr);
+            allocator.save(sizeWriter);
+            List<unsigned char> data(mAllocator);
+            for (size_t i=0; i < sizeWriter.getSizeInBytes(); i++) {
+                data.add(0);
+            }
+            WorldStateWriter writer(&data[0]);
+            allocator.save(writer);
+
+            // The restored allocator gives the same identifiers
+            IdAllocator restoredAllocator(mAllocator);
+            WorldStateReader reader(&data[0], data.size());
+            rp3d_test(restoredAllocator.restore(reader, ids));
+            rp3d_test(!reader.canRead(1));
+            rp3d_test(restoredAllocator.getNbIds() == 4);
+            rp3d_test(restoredAllocator.isValid(ids[3]));
+            rp3d_test(restoredAllocator.allocate() == allocator.allocate());
+
+            // The slots are not restored if they are truncated or if the identifiers are not
+            // exactly the allocated ones
+            IdAllocator otherAllocator(mAllocator);
+            WorldStateReader truncatedReader(&data[0], data.size() - 1);
+            rp3d_test(!otherAllocator.restore(truncatedReader, ids));
+            List<uint64> duplicatedIds(ids);
+            duplicatedIds[1] = duplicatedIds[0];
+            WorldStateReader duplicatedIdsReader(&data[0], data.size());
+            rp3d_test(!otherAllocator.restore(duplicatedIdsReader, duplicatedIds));
+            ids.removeAt(0);
+            WorldStateReader missingIdReader(&data[0], data.size());
+            rp3d_test(!otherAllocator.restore(missingIdReader, ids));
+            rp3d_test(otherAllocator.getNbIds() == 0);
+
+            // The free slots must be linked in a single list
+            List<unsigned char> corruptedData(data);
+            const uint32 freeSlot = 4;
+            std::memcpy(&corruptedData[sizeof(uint32) + 1 * 2 * sizeof(uint32) + sizeof(uint32)], &freeSlot, sizeof(uint32));
+            ids.add(IdAllocator::computeId(0, 0));
+            WorldStateReader corruptedReader(&corruptedData[0], corruptedData.size());
+            rp3d_test(!otherAllocator.restore(corruptedReader, ids));
+            rp3d_test(otherAllocator.getNbIds() == 0);
+        }
+ };
+
+}
+
+#endif
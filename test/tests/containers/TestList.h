@@ -66,6 +66,7 @@ class TestList : public Test {
             testEquality();
             testReserve();
             testIterators();
+            testMoveAndEmplace();
         }
 
         void testConstructors() {
@@ -401,6 +402,82 @@ class TestList : public Test {
             rp3d_test(list1 == list2);
         }
 
+        void testMoveAndEmplace() {
+
+            // ----- Move constructor ----- //
+
+            List<std::string> list1(mAllocator);
+            list1.add("test1");
+            list1.add("test2");
+            list1.add("test3");
+            size_t capacity = list1.capacity();
+
+            List<std::string> list2(std::move(list1));
+            rp3d_test(list1.size() == 0);
+            rp3d_test(list1.capacity() == 0);
+            rp3d_test(list2.size() == 3);
+            rp3d_test(list2.capacity() == capacity);
+            rp3d_test(list2[0] == "test1");
+            rp3d_test(list2[2] == "test3");
+
+            // The moved list can be used again
+            list1.add("test4");
+            rp3d_test(list1.size() == 1);
+            rp3d_test(list1[0] == "test4");
+
+            // ----- Move assignment with the same allocator ----- //
+
+            List<std::string> list3(mAllocator);
+            list3.add("test5");
+            list3 = std::move(list2);
+            rp3d_test(list2.size() == 0);
+            rp3d_test(list2.capacity() == 0);
+            rp3d_test(list3.size() == 3);
+            rp3d_test(list3.capacity() == capacity);
+            rp3d_test(list3[1] == "test2");
+
+            // ----- Move assignment with another allocator ----- //
+
+            DefaultAllocator otherAllocator;
+            List<std::string> list4(otherAllocator);
+            list4 = std::move(list3);
+            rp3d_test(list3.size() == 0);
+            rp3d_test(list4.size() == 3);
+            rp3d_test(list4[0] == "test1");
+            rp3d_test(list4[1] == "test2");
+            rp3d_test(list4[2] == "test3");
+
+            // ----- Add with move and emplace ----- //
+
+            List<std::string> list5(mAllocator);
+            std::string text("test6");
+            list5.add(std::move(text));
+            std::string& element = list5.emplace(3, 'a');
+            rp3d_test(element == "aaa");
+            list5.emplace("test7");
+            rp3d_test(list5.size() == 3);
+            rp3d_test(list5[0] == "test6");
+            rp3d_test(list5[1] == "aaa");
+            rp3d_test(list5[2] == "test7");
+
+            List<List<int>> lists(mAllocator);
+            lists.emplace(mAllocator, 10);
+            lists[0].add(1);
+            lists.add(List<int>(mAllocator));
+            for (int i=0; i<10; i++) {
+                lists[1].add(i);
+            }
+            List<int> list6(mAllocator);
+            list6.add(7);
+            lists.add(std::move(list6));
+            rp3d_test(lists.size() == 3);
+            rp3d_test(lists[0].capacity() == 10);
+            rp3d_test(lists[1].size() == 10);
+            rp3d_test(lists[1][9] == 9);
+            rp3d_test(lists[2][0] == 7);
+            rp3d_test(list6.size() == 0);
+        }
+
  };
 
 }
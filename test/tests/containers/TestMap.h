@@ -91,6 +91,7 @@ class TestMap : public Test {
             testEquality();
             testAssignment();
             testIterators();
+            testMoveAndEmplace();
         }
 
         void testConstructors() {
@@ -426,6 +427,75 @@ class TestMap : public Test {
             }
             rp3d_test(map1.size() == size);
         }
+
+        void testMoveAndEmplace() {
+
+            // ----- Move constructor ----- //
+
+            Map<int, std::string> map1(mAllocator);
+            map1.add(Pair<int, std::string>(1, "test1"));
+            map1.add(Pair<int, std::string>(2, "test2"));
+            map1.add(Pair<int, std::string>(3, "test3"));
+            int capacity = map1.capacity();
+
+            Map<int, std::string> map2(std::move(map1));
+            rp3d_test(map1.size() == 0);
+            rp3d_test(map1.capacity() == 0);
+            rp3d_test(map2.size() == 3);
+            rp3d_test(map2.capacity() == capacity);
+            rp3d_test(map2[1] == "test1");
+            rp3d_test(map2[3] == "test3");
+
+            // The moved map can be used again
+            map1.add(Pair<int, std::string>(4, "test4"));
+            rp3d_test(map1.size() == 1);
+            rp3d_test(map1[4] == "test4");
+
+            // ----- Move assignment with the same allocator ----- //
+
+            Map<int, std::string> map3(mAllocator);
+            map3.add(Pair<int, std::string>(5, "test5"));
+            map3 = std::move(map2);
+            rp3d_test(map2.size() == 0);
+            rp3d_test(map3.size() == 3);
+            rp3d_test(map3.capacity() == capacity);
+            rp3d_test(!map3.containsKey(5));
+            rp3d_test(map3[2] == "test2");
+
+            // ----- Move assignment with another allocator ----- //
+
+            DefaultAllocator otherAllocator;
+            Map<int, std::string> map4(otherAllocator);
+            map4 = std::move(map3);
+            rp3d_test(map3.size() == 0);
+            rp3d_test(map4.size() == 3);
+            rp3d_test(map4[1] == "test1");
+            rp3d_test(map4[2] == "test2");
+            rp3d_test(map4[3] == "test3");
+
+            // ----- Add with move and emplace ----- //
+
+            Map<int, std::string> map5(mAllocator);
+            Pair<int, std::string> pair(1, "test6");
+            map5.add(std::move(pair));
+            map5.emplace(2, 3, 'a');
+            map5.emplace(3, "test7");
+            rp3d_test(map5.size() == 3);
+            rp3d_test(map5[1] == "test6");
+            rp3d_test(map5[2] == "aaa");
+            rp3d_test(map5[3] == "test7");
+
+            bool isExceptionThrown = false;
+            try {
+                map5.emplace(2, "test8");
+            }
+            catch (const std::runtime_error&) {
+                isExceptionThrown = true;
+            }
+            rp3d_test(isExceptionThrown);
+            rp3d_test(map5[2] == "aaa");
+        }
+
  };
 
 }
@@ -90,6 +90,7 @@ class TestSet : public Test {
             testEquality();
             testAssignment();
             testIterators();
+            testMoveAndEmplace();
         }
 
         void testConstructors() {
@@ -410,6 +411,64 @@ class TestSet : public Test {
             }
             rp3d_test(set1.size() == size);
         }
+
+        void testMoveAndEmplace() {
+
+            // ----- Move constructor ----- //
+
+            Set<std::string> set1(mAllocator);
+            set1.add("test1");
+            set1.add("test2");
+            set1.add("test3");
+            int capacity = set1.capacity();
+
+            Set<std::string> set2(std::move(set1));
+            rp3d_test(set1.size() == 0);
+            rp3d_test(set1.capacity() == 0);
+            rp3d_test(set2.size() == 3);
+            rp3d_test(set2.capacity() == capacity);
+            rp3d_test(set2.contains("test1"));
+            rp3d_test(set2.contains("test3"));
+
+            // The moved set can be used again
+            set1.add("test4");
+            rp3d_test(set1.size() == 1);
+            rp3d_test(set1.contains("test4"));
+
+            // ----- Move assignment with the same allocator ----- //
+
+            Set<std::string> set3(mAllocator);
+            set3.add("test5");
+            set3 = std::move(set2);
+            rp3d_test(set2.size() == 0);
+            rp3d_test(set3.size() == 3);
+            rp3d_test(set3.capacity() == capacity);
+            rp3d_test(!set3.contains("test5"));
+            rp3d_test(set3.contains("test2"));
+
+            // ----- Move assignment with another allocator ----- //
+
+            DefaultAllocator otherAllocator;
+            Set<std::string> set4(otherAllocator);
+            set4 = std::move(set3);
+            rp3d_test(set3.size() == 0);
+            rp3d_test(set4.size() == 3);
+            rp3d_test(set4.contains("test1"));
+            rp3d_test(set4.contains("test2"));
+            rp3d_test(set4.contains("test3"));
+
+            // ----- Add with move and emplace ----- //
+
+            Set<std::string> set5(mAllocator);
+            std::string text("test6");
+            set5.add(std::move(text));
+            set5.emplace(3, 'a');
+            set5.emplace("aaa");
+            rp3d_test(set5.size() == 2);
+            rp3d_test(set5.contains("test6"));
+            rp3d_test(set5.contains("aaa"));
+        }
+
  };
 
 }
@@ -0,0 +1,373 @@
+/********************************************************************************
+* ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
+* Copyright (c) 2010-2016 Daniel Chappuis                                       *
+*********************************************************************************
+*                                                                               *
+* This software is provided 'as-is', without any express or implied warranty.   *
+* In no event will the authors be held liable for any damages arising from the  *
+* use of this software.                                                         *
+*                                                                               *
+* Permission is granted to anyone to use this software for any purpose,         *
+* including commercial applications, and to alter it and redistribute it        *
+* freely, subject to the following restrictions:                                *
+*                                                                               *
+* 1. The origin of this software must not be misrepresented; you must not claim *
+*    that you wrote the original software. If you use this software in a        *
+*    product, an acknowledgment in the product documentation would be           *
+*    appreciated but is not required.                                           *
+*                                                                               *
+* 2. Altered source versions must be plainly marked as such, and must not be    *
+*    misrepresented as being the original software.                             *
+*                                                                               *
+* 3. This notice may not be removed or altered from any source distribution.    *
+*                                                                               *
+********************************************************************************/
+
+#ifndef TEST_SMALL_LIST_H
+#define TEST_SMALL_LIST_H
+
+// Libraries
+#include "Test.h"
+#include "containers/SmallList.h"
+#include "memory/DefaultAllocator.h"
+
+/// Reactphysics3D namespace
+namespace reactphysics3d {
+
+// Class TestSmallList
+/**
+ * Unit test for the SmallList class
+ */
+class TestSmallList : public Test {
+
+    private :
+
+        // ---------- Atributes ---------- //
+
+        DefaultAllocator mAllocator;
+
+    public :
+
+        // ---------- Methods ---------- //
+
+        /// Constructor
+        TestSmallList(const std::string& name) : Test(name) {
+
+        }
+
+        /// Run the tests
+        void run() {
+
+            testConstructors();
+            testAddRemoveClear();
+            testAssignment();
+            testEquality();
+            testReserve();
+            testIterators();
+            testMoveAndEmplace();
+            testMove();
+        }
+
+        void testConstructors() {
+
+            // ----- Constructors ----- //
+
+            SmallList<int, 4> list1(mAllocator);
+            rp3d_test(list1.capacity() == 4);
+            rp3d_test(list1.size() == 0);
+            rp3d_test(list1.isInline());
+
+            SmallList<int, 4> list2(mAllocator, 100);
+            rp3d_test(list2.capacity() == 100);
+            rp3d_test(list2.size() == 0);
+            rp3d_test(!list2.isInline());
+
+            SmallList<int, 4> list3(mAllocator);
+            list3.add(1);
+            list3.add(2);
+            list3.add(3);
+            rp3d_test(list3.capacity() == 4);
+            rp3d_test(list3.size() == 3);
+            rp3d_test(list3.isInline());
+
+            // ----- Copy Constructors ----- //
+
+            SmallList<int, 4> list4(list1);
+            rp3d_test(list4.capacity() == 4);
+            rp3d_test(list4.size() == 0);
+
+            SmallList<int, 4> list5(list3);
+            rp3d_test(list5.capacity() == 4);
+            rp3d_test(list5.size() == list3.size());
+            rp3d_test(list5.isInline());
+            for (uint i=0; i<list3.size(); i++) {
+                rp3d_test(list5[i] == list3[i]);
+            }
+        }
+
+        void testAddRemoveClear() {
+
+            // ----- Test add() ----- //
+
+            SmallList<int, 4> list1(mAllocator);
+            list1.add(4);
+            list1.add(6);
+            list1.add(9);
+            list1.add(2);
+            rp3d_test(list1.size() == 4);
+            rp3d_test(list1.isInline());
+
+            // The fifth element does not fit in the object anymore
+            list1.add(5);
+            rp3d_test(list1.size() == 5);
+            rp3d_test(list1.capacity() == 8);
+            rp3d_test(!list1.isInline());
+            rp3d_test(list1[0] == 4);
+            rp3d_test(list1[1] == 6);
+            rp3d_test(list1[2] == 9);
+            rp3d_test(list1[3] == 2);
+            rp3d_test(list1[4] == 5);
+
+            // ----- Test addRange() ----- //
+
+            SmallList<int, 4> list2(mAllocator);
+            list2.add(1);
+            list2.addRange(list1);
+            rp3d_test(list2.size() == 6);
+            rp3d_test(list2[0] == 1);
+            rp3d_test(list2[1] == 4);
+            rp3d_test(list2[5] == 5);
+
+            List<int> list3(mAllocator);
+            list3.add(7);
+            list3.add(8);
+            SmallList<int, 4> list4(mAllocator);
+            list4.addRange(list3);
+            rp3d_test(list4.size() == 2);
+            rp3d_test(list4.isInline());
+            rp3d_test(list4[0] == 7);
+            rp3d_test(list4[1] == 8);
+
+            // ----- Test removeAt() ----- //
+
+            list1.removeAt(0);
+            rp3d_test(list1.size() == 4);
+            rp3d_test(list1[0] == 6);
+            rp3d_test(list1[3] == 5);
+            list1.removeAt(3);
+            rp3d_test(list1.size() == 3);
+            rp3d_test(list1[2] == 2);
+            list1.removeAt(1);
+            rp3d_test(list1.size() == 2);
+            rp3d_test(list1[0] == 6);
+            rp3d_test(list1[1] == 2);
+
+            // ----- Test clear() ----- //
+
+            list1.clear();
+            rp3d_test(list1.size() == 0);
+            rp3d_test(list1.capacity() == 8);
+            list1.add(1);
+            rp3d_test(list1.size() == 1);
+            rp3d_test(list1[0] == 1);
+
+            // ----- Test with elements that have a destructor ----- //
+
+            SmallList<std::string, 2> list5(mAllocator);
+            list5.add("test1");
+            list5.add("test2");
+            list5.add("test3");
+            rp3d_test(list5.size() == 3);
+            rp3d_test(list5[0] == "test1");
+            rp3d_test(list5[1] == "test2");
+            rp3d_test(list5[2] == "test3");
+            list5.removeAt(0);
+            rp3d_test(list5[0] == "test2");
+            rp3d_test(list5[1] == "test3");
+        }
+
+        void testAssignment() {
+
+            SmallList<int, 4> list1(mAllocator);
+            list1.add(1);
+            list1.add(2);
+            list1.add(3);
+
+            SmallList<int, 4> list2(mAllocator);
+            list2.add(5);
+            list2.add(6);
+
+            SmallList<int, 4> list3(mAllocator);
+            for (int i=0; i<10; i++) {
+                list3.add(i);
+            }
+
+            list2 = list1;
+            rp3d_test(list2.size() == list1.size());
+            rp3d_test(list2[0] == 1);
+            rp3d_test(list2[1] == 2);
+            rp3d_test(list2[2] == 3);
+
+            list1 = list3;
+            rp3d_test(list1.size() == 10);
+            for (int i=0; i<10; i++) {
+                rp3d_test(list1[i] == i);
+            }
+
+            list3 = list2;
+            rp3d_test(list3.size() == 3);
+            rp3d_test(list3[2] == 3);
+        }
+
+        void testEquality() {
+
+            SmallList<int, 4> list1(mAllocator);
+            list1.add(1);
+            list1.add(2);
+            list1.add(3);
+
+            SmallList<int, 4> list2(mAllocator);
+            list2.add(1);
+            list2.add(2);
+
+            SmallList<int, 4> list3(mAllocator);
+            list3.add(1);
+            list3.add(2);
+            list3.add(3);
+
+            SmallList<int, 4> list4(mAllocator, 10);
+            list4.add(1);
+            list4.add(2);
+            list4.add(3);
+
+            rp3d_test(list1 == list1);
+            rp3d_test(list1 != list2);
+            rp3d_test(list1 == list3);
+            rp3d_test(list1 == list4);
+            list3[2] = 5;
+            rp3d_test(list1 != list3);
+        }
+
+        void testReserve() {
+
+            SmallList<int, 4> list1(mAllocator);
+            list1.reserve(2);
+            rp3d_test(list1.capacity() == 4);
+            rp3d_test(list1.isInline());
+            list1.add(1);
+            list1.add(2);
+            list1.reserve(20);
+            rp3d_test(list1.capacity() == 20);
+            rp3d_test(!list1.isInline());
+            rp3d_test(list1.size() == 2);
+            rp3d_test(list1[0] == 1);
+            rp3d_test(list1[1] == 2);
+            list1.reserve(10);
+            rp3d_test(list1.capacity() == 20);
+        }
+
+        void testIterators() {
+
+            SmallList<int, 4> list1(mAllocator);
+            rp3d_test(list1.begin() == list1.end());
+
+            list1.add(5);
+            list1.add(6);
+            list1.add(8);
+            int sum = 0;
+            for (int value : list1) {
+                sum += value;
+            }
+            rp3d_test(sum == 19);
+
+            list1.add(-1);
+            list1.add(2);
+            sum = 0;
+            for (int value : list1) {
+                sum += value;
+            }
+            rp3d_test(sum == 20);
+        }
+
+        void testMove() {
+
+            // The elements stored in the object must still be found when the list is moved in
+            // memory by a List of lists (with memmove)
+            List<SmallList<int, 4>> lists(mAllocator);
+            for (int i=0; i<20; i++) {
+                SmallList<int, 4> list(mAllocator);
+                for (int j=0; j <= i % 6; j++) {
+                    list.add(i + j);
+                }
+                lists.add(list);
+            }
+            lists.removeAt(0);
+            for (uint i=0; i<lists.size(); i++) {
+                rp3d_test(lists[i].size() == (i + 1) % 6 + 1);
+                rp3d_test(lists[i][0] == int(i + 1));
+            }
+        }
+
+        void testMoveAndEmplace() {
+
+            // ----- Move the elements stored in the object ----- //
+
+            SmallList<std::string, 4> list1(mAllocator);
+            list1.add("test1");
+            list1.add("test2");
+
+            SmallList<std::string, 4> list2(std::move(list1));
+            rp3d_test(list1.size() == 0);
+            rp3d_test(list2.size() == 2);
+            rp3d_test(list2.isInline());
+            rp3d_test(list2[0] == "test1");
+            rp3d_test(list2[1] == "test2");
+
+            // ----- Move the allocated memory ----- //
+
+            SmallList<std::string, 4> list3(mAllocator);
+            for (int i=0; i<10; i++) {
+                list3.add(std::to_string(i));
+            }
+            const std::string* elements = list3.begin();
+
+            SmallList<std::string, 4> list4(std::move(list3));
+            rp3d_test(list3.size() == 0);
+            rp3d_test(list3.isInline());
+            rp3d_test(list4.size() == 10);
+            rp3d_test(list4.begin() == elements);
+            rp3d_test(list4[9] == "9");
+
+            // ----- Move assignment ----- //
+
+            list2 = std::move(list4);
+            rp3d_test(list4.size() == 0);
+            rp3d_test(list2.size() == 10);
+            rp3d_test(list2.begin() == elements);
+
+            DefaultAllocator otherAllocator;
+            SmallList<std::string, 4> list5(otherAllocator);
+            list5 = std::move(list2);
+            rp3d_test(list2.size() == 0);
+            rp3d_test(list5.size() == 10);
+            rp3d_test(list5.begin() != elements);
+            rp3d_test(list5[0] == "0");
+            rp3d_test(list5[9] == "9");
+
+            // ----- Add with move and emplace ----- //
+
+            SmallList<std::string, 4> list6(mAllocator);
+            std::string text("test6");
+            list6.add(std::move(text));
+            std::string& element = list6.emplace(3, 'a');
+            rp3d_test(element == "aaa");
+            rp3d_test(list6.size() == 2);
+            rp3d_test(list6[0] == "test6");
+            rp3d_test(list6[1] == "aaa");
+        }
+
+ };
+
+}
+
+#endif
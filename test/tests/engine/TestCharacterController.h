@@ -0,0 +1,306 @@
+/********************************************************************************
+* ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
+* Copyright (c) 2010-2018 Daniel Chappuis                                       *
+*********************************************************************************
+*                                                                               *
+* This software is provided 'as-is', without any express or implied warranty.   *
+* In no event will the authors be held liable for any damages arising from the  *
+* use of this software.                                                         *
+*                                                                               *
+* Permission is granted to anyone to use this software for any purpose,         *
+* including commercial applications, and to alter it and redistribute it        *
+* freely, subject to the following restrictions:                                *
+*                                                                               *
+* 1. The origin of this software must not be misrepresented; you must not claim *
+*    that you wrote the original software. If you use this software in a        *
+*    product, an acknowledgment in the product documentation would be           *
+*    appreciated but is not required.                                           *
+*                                                                               *
+* 2. Altered source versions must be plainly marked as such, and must not be    *
+*    misrepresented as being the original software.                             *
+*                                                                               *
+* 3. This notice may not be removed or altered from any source distribution.    *
+*                                                                               *
+********************************************************************************/
+
+#ifndef TEST_CHARACTER_CONTROLLER_H
+#define TEST_CHARACTER_CONTROLLER_H
+
+// Libraries
+#include "Test.h"
+#include "reactphysics3d.h"
+
+/// Reactphysics3D namespace
+namespace reactphysics3d {
+
+// Class TestCharacterController
+/**
+ * Unit test for the CharacterController class
+ */
+class TestCharacterController : public Test {
+
+    private :
+
+        // ---------- Atributes ---------- //
+
+        BoxShape mFloorShape;
+
+        BoxShape mWallShape;
+
+        BoxShape mStepShape;
+
+        BoxShape mSlopeShape;
+
+    public :
+
+        // ---------- Methods ---------- //
+
+        /// Constructor
+        TestCharacterController(const std::string& name)
+            : Test(name), mFloorShape(Vector3(20, decimal(0.5), 20)), mWallShape(Vector3(decimal(0.5), 2, 20)),
+              mStepShape(Vector3(1, decimal(0.5), 2)), mSlopeShape(Vector3(4, decimal(0.5), 4)) {
+
+        }
+
+        /// Run the tests
+        void run() {
+
+            testCreateAndDestroy();
+            testWalkOnFloor();
+            testWalls();
+            testSteps();
+            testSlopes();
+            testQueryCache();
+        }
+
+        /// Create a static box whose top face is at a given height
+        CollisionBody* createBox(CollisionWorld& world, BoxShape& shape, const Vector3& topCenter,
+                                 const Quaternion& orientation = Quaternion::identity()) {
+            const Vector3 center = topCenter - orientation * Vector3(0, shape.getExtent().y, 0);
+            CollisionBody* body = world.createCollisionBody(Transform(center, orientation));
+            body->addCollisionShape(&shape, Transform::identity());
+            return body;
+        }
+
+        /// Return the height of the center of a character standing on the ground at y = 0
+        static decimal getStandingHeight(const CharacterController* character) {
+            const CharacterControllerSettings& settings = character->getSettings();
+            return decimal(0.5) * settings.height + settings.radius + settings.contactOffset;
+        }
+
+        void testCreateAndDestroy() {
+
+            CollisionWorld world;
+
+            CharacterControllerSettings settings;
+            settings.radius = decimal(0.4);
+            CharacterController* character1 = world.createCharacterController(Vector3(1, 2, 3), settings);
+            CharacterController* character2 = world.createCharacterController(Vector3(4, 5, 6));
+            rp3d_test(world.getNbCharacterControllers() == 2);
+            rp3d_test(world.getCharacterController(0) == character1);
+            rp3d_test(character1->getPosition() == Vector3(1, 2, 3));
+            rp3d_test(character1->getShape().getRadius() == decimal(0.4));
+            rp3d_test(character2->getTransform().getPosition() == Vector3(4, 5, 6));
+            rp3d_test(!character1->isOnGround());
+            rp3d_test(character1->getGroundBody() == nullptr);
+
+            // A move in an empty world is not blocked
+            character1->move(Vector3(1, -1, 0));
+            rp3d_test(character1->getPosition() == Vector3(2, 1, 3));
+            rp3d_test(!character1->isOnGround());
+
+            // The last character controller is moved at the index of the destroyed one
+            world.destroyCharacterController(character1);
+            rp3d_test(world.getNbCharacterControllers() == 1);
+            rp3d_test(world.getCharacterController(0) == character2);
+        }
+
+        void testWalkOnFloor() {
+
+            CollisionWorld world;
+            CollisionBody* floor = createBox(world, mFloorShape, Vector3(0, 0, 0));
+
+            CharacterController* character = world.createCharacterController(Vector3(0, 2, 0));
+            const decimal standingHeight = getStandingHeight(character);
+
+            // The character falls on the floor
+            for (uint i=0; i < 20; i++) {
+                character->move(Vector3(0, decimal(-0.2), 0));
+            }
+            rp3d_test(character->isOnGround());
+            rp3d_test(character->getGroundBody() == floor);
+            rp3d_test(approxEqual(character->getPosition().y, standingHeight, decimal(0.002)));
+            rp3d_test(approxEqual(character->getGroundNormal().y, decimal(1.0), decimal(0.001)));
+            rp3d_test(approxEqual(character->getGroundPoint().y, decimal(0.0), decimal(0.002)));
+
+            // The character walks on the floor without moving vertically
+            for (uint i=0; i < 10; i++) {
+                character->move(Vector3(decimal(0.1), decimal(-0.05), decimal(0.1)));
+                rp3d_test(character->isOnGround());
+            }
+            rp3d_test(approxEqual(character->getPosition().x, decimal(1.0), decimal(0.001)));
+            rp3d_test(approxEqual(character->getPosition().z, decimal(1.0), decimal(0.001)));
+            rp3d_test(approxEqual(character->getPosition().y, standingHeight, decimal(0.002)));
+            rp3d_test(!character->isTouchingWall() && !character->isTouchingCeiling());
+
+            // The character jumps
+            character->move(Vector3(0, decimal(0.5), 0));
+            rp3d_test(!character->isOnGround());
+            rp3d_test(approxEqual(character->getPosition().y, standingHeight + decimal(0.5), decimal(0.002)));
+
+            // A teleported character forgets its ground
+            character->move(Vector3(0, decimal(-0.6), 0));
+            rp3d_test(character->isOnGround());
+            character->setPosition(Vector3(0, 5, 0));
+            rp3d_test(!character->isOnGround() && character->getGroundProxyShape() == nullptr);
+        }
+
+        void testWalls() {
+
+            CollisionWorld world;
+            createBox(world, mFloorShape, Vector3(0, 0, 0));
+            createBox(world, mWallShape, Vector3(decimal(2.5), 4, 0));
+
+            CharacterController* character = world.createCharacterController(Vector3(0, 2, 0));
+            character->move(Vector3(0, -2, 0));
+            rp3d_test(character->isOnGround());
+
+            // The character slides along the wall
+            character->move(Vector3(3, 0, 1));
+            const decimal radius = character->getSettings().radius;
+            rp3d_test(character->isTouchingWall());
+            rp3d_test(character->getPosition().x < decimal(2.0) - radius);
+            rp3d_test(character->getPosition().x > decimal(2.0) - radius - decimal(0.02));
+            rp3d_test(approxEqual(character->getPosition().z, decimal(1.0), decimal(0.002)));
+            rp3d_test(character->isOnGround());
+
+            // The character hits a ceiling
+            createBox(world, mFloorShape, Vector3(0, decimal(3.0), 0));
+            character->move(Vector3(-1, 2, 0));
+            rp3d_test(character->isTouchingCeiling());
+            rp3d_test(character->getPosition().y + decimal(0.5) * character->getSettings().height + radius < decimal(2.0));
+        }
+
+        void testSteps() {
+
+            CollisionWorld world;
+            createBox(world, mFloorShape, Vector3(0, 0, 0));
+
+            // A low step and a high step
+            createBox(world, mStepShape, Vector3(decimal(2.5), decimal(0.2), 0));
+            createBox(world, mStepShape, Vector3(decimal(2.5), decimal(0.6), 5));
+
+            CharacterController* lowCharacter = world.createCharacterController(Vector3(0, 2, 0));
+            CharacterController* highCharacter = world.createCharacterController(Vector3(0, 2, 5));
+            lowCharacter->move(Vector3(0, -2, 0));
+            highCharacter->move(Vector3(0, -2, 0));
+
+            for (uint i=0; i < 30; i++) {
+                lowCharacter->move(Vector3(decimal(0.1), decimal(-0.1), 0));
+                highCharacter->move(Vector3(decimal(0.1), decimal(-0.1), 0));
+            }
+
+            // The character climbs the low step
+            const decimal standingHeight = getStandingHeight(lowCharacter);
+            rp3d_test(lowCharacter->isOnGround());
+            rp3d_test(approxEqual(lowCharacter->getPosition().x, decimal(3.0), decimal(0.05)));
+            rp3d_test(approxEqual(lowCharacter->getPosition().y, standingHeight + decimal(0.2), decimal(0.002)));
+
+            // The high step blocks the character
+            rp3d_test(highCharacter->isOnGround());
+            rp3d_test(highCharacter->isTouchingWall());
+            rp3d_test(highCharacter->getPosition().x < decimal(1.5) - highCharacter->getSettings().radius);
+            rp3d_test(approxEqual(highCharacter->getPosition().y, standingHeight, decimal(0.002)));
+        }
+
+        void testSlopes() {
+
+            CollisionWorld world;
+
+            // A gentle slope and a steep slope (rotated around the z axis)
+            const decimal gentleAngle = decimal(20.0) * PI / decimal(180.0);
+            const decimal steepAngle = decimal(60.0) * PI / decimal(180.0);
+            createBox(world, mSlopeShape, Vector3(0, 0, 0), Quaternion::fromEulerAngles(0, 0, gentleAngle));
+            createBox(world, mSlopeShape, Vector3(0, 0, 20), Quaternion::fromEulerAngles(0, 0, steepAngle));
+
+            CharacterController* gentleCharacter = world.createCharacterController(Vector3(0, 3, 0));
+            CharacterController* steepCharacter = world.createCharacterController(Vector3(0, 5, 20));
+            for (uint i=0; i < 30; i++) {
+                gentleCharacter->move(Vector3(0, decimal(-0.2), 0));
+                steepCharacter->move(Vector3(0, decimal(-0.2), 0));
+            }
+
+            // The character stands on the gentle slope without sliding down
+            rp3d_test(gentleCharacter->isOnGround());
+            rp3d_test(approxEqual(gentleCharacter->getGroundNormal().y, std::cos(gentleAngle), decimal(0.01)));
+            rp3d_test(approxEqual(gentleCharacter->getPosition().x, decimal(0.0), decimal(0.001)));
+
+            // The character walks up the gentle slope
+            const decimal startHeight = gentleCharacter->getPosition().y;
+            for (uint i=0; i < 10; i++) {
+                gentleCharacter->move(Vector3(decimal(0.1), decimal(-0.05), 0));
+            }
+            rp3d_test(gentleCharacter->isOnGround());
+            rp3d_test(gentleCharacter->getPosition().y > startHeight + decimal(0.3));
+
+            // The character slides down the steep slope and does not stand on it
+            rp3d_test(!steepCharacter->isOnGround());
+            rp3d_test(steepCharacter->isTouchingWall());
+            rp3d_test(steepCharacter->getPosition().x < decimal(-0.5));
+        }
+
+        void testQueryCache() {
+
+            float heights[32 * 32];
+            for (uint i=0; i < 32 * 32; i++) {
+                heights[i] = 0.0f;
+            }
+            HeightFieldShape heightFieldShape(32, 32, -1, 1, heights, HeightFieldShape::HeightDataType::HEIGHT_FLOAT_TYPE);
+
+            CollisionWorld world;
+            CollisionBody* ground = world.createCollisionBody(Transform::identity());
+            ground->addCollisionShape(&heightFieldShape, Transform::identity());
+            CollisionBody* box = createBox(world, mStepShape, Vector3(20, 0, 0));
+
+            // The characters fall on the ground
+            CharacterController* character = world.createCharacterController(Vector3(-5, 2, 0));
+            CharacterController* uncachedCharacter = world.createCharacterController(Vector3(-5, 2, 0));
+            for (uint i=0; i < 10; i++) {
+                character->move(Vector3(0, decimal(-0.2), 0));
+                uncachedCharacter->move(Vector3(0, decimal(-0.2), 0));
+            }
+            const uint nbQueries = character->getNbBroadPhaseQueries();
+            const uint nbUncachedQueries = uncachedCharacter->getNbBroadPhaseQueries();
+
+            // One character uses its cache and the other one queries the broad-phase at each move
+            for (uint i=0; i < 40; i++) {
+                const Vector3 displacement(decimal(0.02), decimal(-0.2), decimal(0.01) * decimal(i % 5));
+                character->move(displacement);
+                uncachedCharacter->invalidateQueryCache();
+                uncachedCharacter->move(displacement);
+            }
+
+            // The characters stand on the concave ground and are at the same position
+            rp3d_test(character->isOnGround() && uncachedCharacter->isOnGround());
+            rp3d_test(character->getGroundBody() == ground);
+            rp3d_test(approxEqual(character->getPosition().y, getStandingHeight(character), decimal(0.002)));
+            rp3d_test(approxEqual(character->getPosition(), uncachedCharacter->getPosition(), decimal(0.0001)));
+            rp3d_test(character->getNbBroadPhaseQueries() == nbQueries);
+            rp3d_test(uncachedCharacter->getNbBroadPhaseQueries() == nbUncachedQueries + 40);
+
+            // A new fat AABB in the broad-phase invalidates the cache
+            box->setTransform(Transform(Vector3(30, 0, 0), Quaternion::identity()));
+            character->move(Vector3(decimal(0.01), 0, 0));
+            rp3d_test(character->getNbBroadPhaseQueries() == nbQueries + 1);
+            rp3d_test(character->isOnGround());
+
+            // A move out of the cached region queries the broad-phase again
+            character->move(Vector3(5, 0, 0));
+            rp3d_test(character->getNbBroadPhaseQueries() == nbQueries + 2);
+            rp3d_test(character->isOnGround());
+        }
+};
+
+}
+
+#endif
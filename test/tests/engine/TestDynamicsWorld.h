@@ -0,0 +1,4383 @@
+/********************************************************************************
+* ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
+* Copyright (c) 2010-2018 Daniel Chappuis                                       *
+*********************************************************************************
+*                                                                               *
+* This software is provided 'as-is', without any express or implied warranty.   *
+* In no event will the authors be held liable for any damages arising from the  *
+* use of this software.                                                         *
+*                                                                               *
+* Permission is granted to anyone to use this software for any purpose,         *
+* including commercial applications, and to alter it and redistribute it        *
+* freely, subject to the following restrictions:                                *
+*                                                                               *
+* 1. The origin of this software must not be misrepresented; you must not claim *
+*    that you wrote the original software. If you use this software in a        *
+*    product, an acknowledgment in the product documentation would be           *
+*    appreciated but is not required.                                           *
+*                                                                               *
+* 2. Altered source versions must be plainly marked as such, and must not be    *
+*    misrepresented as being the original software.                             *
+*                                                                               *
+* 3. This notice may not be removed or altered from any source distribution.    *
+*                                                                               *
+********************************************************************************/
+
+#ifndef TEST_DYNAMICS_WORLD_H
+#define TEST_DYNAMICS_WORLD_H
+
+// Libraries
+#include "reactphysics3d.h"
+#include "Test.h"
+#include <cstring>
+#include <thread>
+#include <vector>
+
+/// Reactphysics3D namespace
+namespace reactphysics3d {
+
+// Class ContactOrderListener
+/**
+ * Event listener that checks that the contacts are reported by increasing body ids
+ */
+class ContactOrderListener : public EventListener {
+
+    public:
+
+        /// Ids of the bodies of the last reported contact
+        bodyindexpair lastBodies = bodyindexpair(0, 0);
+
+        /// True if all the contacts have been reported in the order of the body ids
+        bool isSorted = true;
+
+        /// Number of reported contacts
+        uint nbContacts = 0;
+
+        virtual void beginInternalTick() override {
+            lastBodies = bodyindexpair(0, 0);
+        }
+
+        virtual void newContact(const CollisionCallback::CollisionCallbackInfo& collisionInfo) override {
+
+            bodyindexpair bodies = OverlappingPair::computeBodiesIndexPair(collisionInfo.body1, collisionInfo.body2);
+            if ((bodies.first < lastBodies.first ||
+                                   (bodies.first == lastBodies.first && bodies.second < lastBodies.second))) {
+                isSorted = false;
+            }
+            lastBodies = bodies;
+            nbContacts++;
+        }
+};
+
+// Class BodyOverlapCallback
+/**
+ * Overlap callback that records the bodies overlapping a given AABB
+ */
+class BodyOverlapCallback : public OverlapCallback {
+
+    public:
+
+        /// Bodies reported by the broad-phase
+        std::vector<CollisionBody*> bodies;
+
+        virtual void notifyOverlap(CollisionBody* collisionBody) override {
+            bodies.push_back(collisionBody);
+        }
+
+        bool hasOverlap(CollisionBody* body) const {
+            return std::find(bodies.begin(), bodies.end(), body) != bodies.end();
+        }
+};
+
+// Class BodyRaycastCallback
+/**
+ * Raycast callback that records the bodies hit by a ray
+ */
+class BodyRaycastCallback : public RaycastCallback {
+
+    public:
+
+        /// Bodies hit by the ray
+        std::vector<CollisionBody*> bodies;
+
+        virtual decimal notifyRaycastHit(const RaycastInfo& raycastInfo) override {
+            bodies.push_back(raycastInfo.body);
+
+            // Report all the hits along the ray
+            return decimal(1.0);
+        }
+};
+
+// Class TestSolverIterationsPolicy
+/**
+ * Policy that gives more iterations to the large islands
+ */
+class TestSolverIterationsPolicy : public SolverIterationsPolicy {
+
+    public :
+
+        uint nbSteps = 0;
+        uint nbLargeIslands = 0;
+        uint nbSmallIslands = 0;
+        decimal maxMassRatio = decimal(0.0);
+
+        virtual void beginStep() override {
+            nbSteps++;
+            nbLargeIslands = 0;
+            nbSmallIslands = 0;
+        }
+
+        virtual void computeNbIterations(const IslandSolverInfo& islandInfo, uint& nbVelocityIterations,
+                                         uint& nbPositionIterations) override {
+
+            maxMassRatio = std::max(maxMassRatio, islandInfo.maxMassRatio);
+
+            if (islandInfo.nbBodies > 3) {
+                nbLargeIslands++;
+                nbVelocityIterations = 20;
+            }
+            else {
+                nbSmallIslands++;
+                nbVelocityIterations = 2;
+                nbPositionIterations = 1;
+            }
+        }
+};
+
+// Class JointBreakListener
+/**
+ * Event listener that records the joints that are broken
+ */
+class JointBreakListener : public EventListener {
+
+    public:
+
+        /// Ids of the broken joints
+        std::vector<uint> brokenJointsIds;
+
+        virtual void jointBroken(Joint* joint) override {
+            brokenJointsIds.push_back(joint->getId());
+        }
+};
+
+// Class TestDynamicsWorld
+/**
+ * Unit test for the DynamicsWorld class
+ */
+class TestDynamicsWorld : public Test {
+
+    private :
+
+        // ---------- Atributes ---------- //
+
+        /// Number of stacks of boxes in the test scene
+        static const uint NB_STACKS = 8;
+
+        /// Number of boxes in each stack of the test scene
+        static const uint NB_BOXES_PER_STACK = 4;
+
+        /// Box collision shape used for the dynamic bodies
+        BoxShape* mBoxShape;
+
+        /// Box collision shape used for the floor
+        BoxShape* mFloorShape;
+
+        /// Sphere collision shape used for the dynamic bodies
+        SphereShape* mSphereShape;
+
+        /// Capsule collision shape used for the dynamic bodies
+        CapsuleShape* mCapsuleShape;
+
+    public :
+
+        // ---------- Methods ---------- //
+
+        /// Constructor
+        TestDynamicsWorld(const std::string& name) : Test(name) {
+
+            mBoxShape = new BoxShape(Vector3(decimal(0.5), decimal(0.5), decimal(0.5)));
+            mFloorShape = new BoxShape(Vector3(50, 1, 50));
+            mSphereShape = new SphereShape(decimal(0.5));
+            mCapsuleShape = new CapsuleShape(decimal(0.4), decimal(0.6));
+        }
+
+        /// Destructor
+        virtual ~TestDynamicsWorld() {
+
+            delete mBoxShape;
+            delete mFloorShape;
+            delete mSphereShape;
+            delete mCapsuleShape;
+        }
+
+        /// Run the tests
+        void run() {
+
+            testParallelIslands();
+            testParallelNarrowPhase();
+            testParallelMiddlePhase();
+            testParallelIntegration();
+            testParallelBroadPhase();
+            testDeterministicMode();
+            testSubsteps();
+            testPersistentIslands();
+            testIslandsRebuild();
+            testRigidBodyStates();
+            testTransformDirtyBodies();
+            testAsynchronousUpdate();
+            testQuerySnapshot();
+            testWideContactSolver();
+            testConstraintColoring();
+            testSolverMemory();
+            testVelocitySolverEarlyExit();
+            testSolverIterationsPolicy();
+            testBlockContactSolver();
+            testRollingResistanceIslands();
+            testMaterialTable();
+            testContactSolverDataCache();
+            testBulletRigidBody();
+            testJointBatching();
+            testArticulationSolver();
+            testPartialWakeUp();
+            testWakeBodies();
+            testRadialImpulse();
+            testBreakableJoints();
+            testBulkJoints();
+            testPositionBasedSolver();
+            testPositionSolverEarlyExit();
+            testJointSolverDataCache();
+            testSoftConstraints();
+            testWideBroadPhaseTree();
+            testSweepAndPruneBroadPhase();
+            testGridBroadPhase();
+            testStaticBroadPhaseTree();
+            testBroadPhaseTreeBulkBuild();
+            testBroadPhaseMaintenanceTimeBudget();
+            testAdaptiveBroadPhaseAABBGap();
+            testSATPreviousAxisStatistics();
+            testContactReuse();
+            testBodyAndJointIds();
+            testStepStatistics();
+            testBodyContactManifolds();
+            testContactBudgets();
+            testWorldOrigin();
+            testShiftOriginBroadPhase();
+            testApproximateOrientationNormalization();
+            testSpatialSort();
+            testSpatialSortWithAsynchronousUpdate();
+            testSimulationLevelsOfDetail();
+            testStepStages();
+            testContactEvents();
+            testContactManifolds();
+            testContactImpulses();
+            testTriggers();
+            testQueryOnlyShapes();
+            testBroadPhaseCollisionFilter();
+            testSleepingPairs();
+            testSleepingMovedShapes();
+            testBroadPhaseTreeStatistics();
+            testNarrowPhaseCosts();
+            testSaveAndRestoreState();
+            testCloneWorld();
+            testSaveAndLoadWorld();
+            testMigrationAndGhostBodies();
+            testQuantizedMotions();
+            testInterpolatedTransforms();
+            testCreateRigidBodies();
+            testSpatialGroups();
+            testIndependentWorldsOnThreads();
+        }
+
+        /// Return true if the bodies of two lists are exactly in the same state
+        bool isSameState(const List<RigidBody*>& bodies1, const List<RigidBody*>& bodies2) {
+
+            bool isSameState = true;
+            for (uint i=0; i < bodies1.size(); i++) {
+                const Transform& transform1 = bodies1[i]->getTransform();
+                const Transform& transform2 = bodies2[i]->getTransform();
+                isSameState &= transform1.getPosition() == transform2.getPosition();
+                isSameState &= transform1.getOrientation() == transform2.getOrientation();
+                isSameState &= bodies1[i]->getLinearVelocity() == bodies2[i]->getLinearVelocity();
+            }
+
+            return isSameState;
+        }
+
+        /// Create a scene with several independent stacks of boxes on a static floor
+        void createScene(DynamicsWorld& world, List<RigidBody*>& bodies) {
+
+            // Create the static floor that is shared by all the islands
+            RigidBody* floor = world.createRigidBody(Transform(Vector3(0, -1, 0), Quaternion::identity()));
+            floor->setType(BodyType::STATIC);
+            floor->addCollisionShape(mFloorShape, Transform::identity(), decimal(1.0));
+
+            for (uint s=0; s < NB_STACKS; s++) {
+
+                RigidBody* previousBody = nullptr;
+
+                for (uint b=0; b < NB_BOXES_PER_STACK; b++) {
+
+                    const Vector3 position(decimal(s) * decimal(4.0) - decimal(14.0), decimal(0.5) + decimal(b) * decimal(1.05),
+                                           decimal(0.1) * decimal(b));
+                    RigidBody* body = world.createRigidBody(Transform(position, Quaternion::identity()));
+                    body->addCollisionShape(mBoxShape, Transform::identity(), decimal(1.0));
+                    bodies.add(body);
+
+                    // Link the boxes of every other stack with joints
+                    if (s % 2 == 0 && previousBody != nullptr) {
+                        BallAndSocketJointInfo jointInfo(previousBody, body, position - Vector3(0, decimal(0.5), 0));
+                        world.createJoint(jointInfo);
+                    }
+
+                    previousBody = body;
+                }
+
+                // Attach the top box of the last stack to the static floor
+                if (s == NB_STACKS - 1) {
+                    BallAndSocketJointInfo jointInfo(floor, previousBody, previousBody->getTransform().getPosition());
+                    world.createJoint(jointInfo);
+                }
+            }
+        }
+
+        void testParallelIslands() {
+
+            DefaultTaskScheduler scheduler(4);
+
+            WorldSettings sequentialSettings;
+            WorldSettings parallelSettings;
+            parallelSettings.taskScheduler = &scheduler;
+
+            DynamicsWorld sequentialWorld(Vector3(0, decimal(-9.81), 0), sequentialSettings);
+            DynamicsWorld parallelWorld(Vector3(0, decimal(-9.81), 0), parallelSettings);
+
+            List<RigidBody*> sequentialBodies(MemoryManager::getBaseAllocator());
+            List<RigidBody*> parallelBodies(MemoryManager::getBaseAllocator());
+            createScene(sequentialWorld, sequentialBodies);
+            createScene(parallelWorld, parallelBodies);
+
+            // Simulate the two worlds
+            for (uint i=0; i < 120; i++) {
+                sequentialWorld.update(decimal(1.0) / decimal(60.0));
+                parallelWorld.update(decimal(1.0) / decimal(60.0));
+            }
+
+            // The islands are independent and must give exactly the same result
+            rp3d_test(isSameState(sequentialBodies, parallelBodies));
+
+            // The boxes must rest on the floor
+            rp3d_test(sequentialBodies[1]->getTransform().getPosition().y > decimal(0.0));
+        }
+
+        /// Create a pile of boxes, spheres and capsules falling on a static floor
+        void createPile(DynamicsWorld& world, List<RigidBody*>& bodies) {
+
+            RigidBody* floor = world.createRigidBody(Transform(Vector3(0, -1, 0), Quaternion::identity()));
+            floor->setType(BodyType::STATIC);
+            floor->addCollisionShape(mFloorShape, Transform::identity(), decimal(1.0));
+
+            for (uint i=0; i < 200; i++) {
+
+                const Vector3 position(decimal(i % 6) * decimal(1.1) - decimal(3.0), decimal(0.6) + decimal(i / 36) * decimal(1.2),
+                                       decimal((i / 6) % 6) * decimal(1.1) - decimal(3.0) + decimal(0.2) * decimal(i % 2));
+                RigidBody* body = world.createRigidBody(Transform(position, Quaternion::fromEulerAngles(0, decimal(0.1) * decimal(i), 0)));
+
+                CollisionShape* shape = mBoxShape;
+                if (i % 3 == 1) shape = mSphereShape;
+                else if (i % 3 == 2) shape = mCapsuleShape;
+                body->addCollisionShape(shape, Transform::identity(), decimal(1.0));
+                bodies.add(body);
+            }
+        }
+
+        void testParallelNarrowPhase() {
+
+            DefaultTaskScheduler scheduler(4);
+
+            WorldSettings sequentialSettings;
+            WorldSettings parallelSettings;
+            parallelSettings.taskScheduler = &scheduler;
+
+            DynamicsWorld sequentialWorld(Vector3(0, decimal(-9.81), 0), sequentialSettings);
+            DynamicsWorld parallelWorld(Vector3(0, decimal(-9.81), 0), parallelSettings);
+
+            List<RigidBody*> sequentialBodies(MemoryManager::getBaseAllocator());
+            List<RigidBody*> parallelBodies(MemoryManager::getBaseAllocator());
+            createPile(sequentialWorld, sequentialBodies);
+            createPile(parallelWorld, parallelBodies);
+
+            // Simulate the two worlds
+            for (uint i=0; i < 90; i++) {
+                sequentialWorld.update(decimal(1.0) / decimal(60.0));
+                parallelWorld.update(decimal(1.0) / decimal(60.0));
+            }
+
+            // The contacts are merged in a deterministic order and must give exactly the same result
+            rp3d_test(isSameState(sequentialBodies, parallelBodies));
+        }
+
+        /// Create bodies with convex and compound shapes falling on a concave shape
+        void createBodiesOnConcaveShape(DynamicsWorld& world, CollisionShape* concaveShape,
+                                        CollisionShape* compoundShape, List<RigidBody*>& bodies) {
+
+            RigidBody* ground = world.createRigidBody(Transform::identity());
+            ground->setType(BodyType::STATIC);
+            ground->addCollisionShape(concaveShape, Transform::identity(), decimal(1.0));
+
+            for (uint i=0; i < 64; i++) {
+
+                const Vector3 position(decimal(i % 8) * decimal(1.6) - decimal(6.0), decimal(1.5) + decimal(i / 32),
+                                       decimal((i / 8) % 4) * decimal(3.2) - decimal(6.0));
+                RigidBody* body = world.createRigidBody(Transform(position, Quaternion::fromEulerAngles(0, decimal(0.2) * decimal(i), 0)));
+
+                CollisionShape* shape = mBoxShape;
+                if (i % 4 == 1) shape = mSphereShape;
+                else if (i % 4 == 2) shape = mCapsuleShape;
+                else if (i % 4 == 3) shape = compoundShape;
+                body->addCollisionShape(shape, Transform::identity(), decimal(1.0));
+                bodies.add(body);
+            }
+        }
+
+        void testParallelMiddlePhase() {
+
+            float heights[256];
+            for (uint i=0; i < 256; i++) {
+                heights[i] = float(std::sin(0.7 * (i % 16)) * 0.3 + std::cos(0.5 * (i / 16)) * 0.2);
+            }
+            HeightFieldShape heightFieldShape(16, 16, -1, 1, heights, HeightFieldShape::HeightDataType::HEIGHT_FLOAT_TYPE);
+            CompoundShape compoundShape;
+            compoundShape.addChildShape(mBoxShape, Transform(Vector3(decimal(-0.5), 0, 0), Quaternion::identity()));
+            compoundShape.addChildShape(mSphereShape, Transform(Vector3(decimal(0.5), 0, 0), Quaternion::identity()));
+
+            DefaultTaskScheduler scheduler(4);
+
+            WorldSettings parallelSettings;
+            parallelSettings.taskScheduler = &scheduler;
+
+            DynamicsWorld sequentialWorld(Vector3(0, decimal(-9.81), 0));
+            DynamicsWorld parallelWorld(Vector3(0, decimal(-9.81), 0), parallelSettings);
+
+            List<RigidBody*> sequentialBodies(MemoryManager::getBaseAllocator());
+            List<RigidBody*> parallelBodies(MemoryManager::getBaseAllocator());
+            createBodiesOnConcaveShape(sequentialWorld, &heightFieldShape, &compoundShape, sequentialBodies);
+            createBodiesOnConcaveShape(parallelWorld, &heightFieldShape, &compoundShape, parallelBodies);
+
+            // The narrow-phase infos of the concave and compound pairs computed by the workers
+            // are added in the order of the pairs and give exactly the same contacts
+            uint nbCulledTriangles = 0;
+            bool isSameCulling = true;
+            for (uint i=0; i < 90; i++) {
+                sequentialWorld.update(decimal(1.0) / decimal(60.0));
+                parallelWorld.update(decimal(1.0) / decimal(60.0));
+                nbCulledTriangles += sequentialWorld.getNarrowPhaseStatistics().nbCulledTriangles;
+                isSameCulling &= sequentialWorld.getNarrowPhaseStatistics().nbCulledTriangles ==
+                                 parallelWorld.getNarrowPhaseStatistics().nbCulledTriangles;
+            }
+            rp3d_test(nbCulledTriangles > 0);
+            rp3d_test(isSameCulling);
+            rp3d_test(isSameState(sequentialBodies, parallelBodies));
+
+            // The bodies rest on the height field
+            bool isOnHeightField = true;
+            for (uint b=0; b < parallelBodies.size(); b++) {
+                isOnHeightField &= parallelBodies[b]->getTransform().getPosition().y > decimal(-1.5);
+            }
+            rp3d_test(isOnHeightField);
+        }
+
+        /// Create bodies with different forces, damping and gravity that do not collide
+        void createFreeBodies(DynamicsWorld& world, List<RigidBody*>& bodies) {
+
+            for (uint i=0; i < 1003; i++) {
+
+                const Vector3 position(decimal(i % 32) * 3, decimal(i / 32) * 3, 0);
+                RigidBody* body = world.createRigidBody(Transform(position, Quaternion::identity()));
+                body->addCollisionShape(mSphereShape, Transform::identity(), decimal(1.0) + decimal(i % 5));
+                body->setLinearDamping(decimal(0.1) * decimal(i % 4));
+                body->setAngularDamping(decimal(0.05) * decimal(i % 3));
+                body->enableGravity(i % 7 != 0);
+                body->setAngularVelocity(Vector3(decimal(i % 3), 1, 0));
+                if (i % 11 == 0) body->setType(BodyType::KINEMATIC);
+                bodies.add(body);
+            }
+        }
+
+        void testParallelIntegration() {
+
+            DefaultTaskScheduler scheduler(4);
+
+            WorldSettings parallelSettings;
+            parallelSettings.taskScheduler = &scheduler;
+
+            DynamicsWorld sequentialWorld(Vector3(0, decimal(-9.81), 0));
+            DynamicsWorld parallelWorld(Vector3(0, decimal(-9.81), 0), parallelSettings);
+
+            List<RigidBody*> sequentialBodies(MemoryManager::getBaseAllocator());
+            List<RigidBody*> parallelBodies(MemoryManager::getBaseAllocator());
+            createFreeBodies(sequentialWorld, sequentialBodies);
+            createFreeBodies(parallelWorld, parallelBodies);
+
+            for (uint i=0; i < 30; i++) {
+                for (uint b=0; b < sequentialBodies.size(); b += 2) {
+                    sequentialBodies[b]->applyForceToCenterOfMass(Vector3(decimal(b % 9), 0, 1));
+                    parallelBodies[b]->applyForceToCenterOfMass(Vector3(decimal(b % 9), 0, 1));
+                }
+                sequentialWorld.update(decimal(1.0) / decimal(60.0));
+                parallelWorld.update(decimal(1.0) / decimal(60.0));
+            }
+
+            // The velocities of the bodies are integrated independently
+            rp3d_test(isSameState(sequentialBodies, parallelBodies));
+
+            // A body without gravity only moves with the applied forces
+            rp3d_test(sequentialBodies[0]->getTransform().getPosition().y == decimal(0.0));
+            rp3d_test(sequentialBodies[1]->getTransform().getPosition().y < decimal(-1.0));
+            rp3d_test(sequentialBodies[3]->getLinearVelocity().length() < decimal(30 * 9.81 / 60.0));
+
+            // Gravity of the world disabled
+            sequentialWorld.setIsGratityEnabled(false);
+            const Vector3 velocity = sequentialBodies[8]->getLinearVelocity();
+            sequentialWorld.update(decimal(1.0) / decimal(60.0));
+            rp3d_test(sequentialBodies[8]->getLinearVelocity() == velocity);
+        }
+
+        void testParallelBroadPhase() {
+
+            DefaultTaskScheduler scheduler(3);
+
+            WorldSettings sequentialSettings;
+            sequentialSettings.isStaticBroadPhaseTreeEnabled = true;
+            sequentialSettings.isWideBroadPhaseTreeEnabled = true;
+            WorldSettings parallelSettings = sequentialSettings;
+            parallelSettings.taskScheduler = &scheduler;
+
+            DynamicsWorld sequentialWorld(Vector3(0, decimal(-9.81), 0), sequentialSettings);
+            DynamicsWorld parallelWorld(Vector3(0, decimal(-9.81), 0), parallelSettings);
+
+            List<RigidBody*> sequentialBodies(MemoryManager::getBaseAllocator());
+            List<RigidBody*> parallelBodies(MemoryManager::getBaseAllocator());
+            createPile(sequentialWorld, sequentialBodies);
+            createPile(parallelWorld, parallelBodies);
+
+            // All the shapes of the piles have moved at the first step and their queries
+            // are run in parallel. The pairs are merged in the same order as the sequential ones
+            for (uint i=0; i < 60; i++) {
+                sequentialWorld.update(decimal(1.0) / decimal(60.0));
+                parallelWorld.update(decimal(1.0) / decimal(60.0));
+            }
+
+            rp3d_test(isSameState(sequentialBodies, parallelBodies));
+        }
+
+        void testDeterministicMode() {
+
+            DefaultTaskScheduler scheduler1(1);
+            DefaultTaskScheduler scheduler3(3);
+
+            WorldSettings settings1;
+            settings1.isDeterministic = true;
+            settings1.taskScheduler = &scheduler1;
+            WorldSettings settings3;
+            settings3.isDeterministic = true;
+            settings3.taskScheduler = &scheduler3;
+
+            DynamicsWorld world1(Vector3(0, decimal(-9.81), 0), settings1);
+            DynamicsWorld world3(Vector3(0, decimal(-9.81), 0), settings3);
+
+            ContactOrderListener listener;
+            world3.setEventListener(&listener);
+
+            List<RigidBody*> bodies1(MemoryManager::getBaseAllocator());
+            List<RigidBody*> bodies3(MemoryManager::getBaseAllocator());
+            createPile(world1, bodies1);
+            createPile(world3, bodies3);
+
+            for (uint i=0; i < 60; i++) {
+                world1.update(decimal(1.0) / decimal(60.0));
+                world3.update(decimal(1.0) / decimal(60.0));
+            }
+
+            // The result does not depend on the number of workers
+            rp3d_test(isSameState(bodies1, bodies3));
+
+            // The overlapping pairs are processed in the order of the body ids
+            rp3d_test(listener.nbContacts > 0);
+            rp3d_test(listener.isSorted);
+        }
+
+        void testSubsteps() {
+
+            DynamicsWorld world(Vector3(0, decimal(-9.81), 0));
+
+            RigidBody* floor = world.createRigidBody(Transform(Vector3(0, -1, 0), Quaternion::identity()));
+            floor->setType(BodyType::STATIC);
+            floor->addCollisionShape(mFloorShape, Transform::identity(), decimal(1.0));
+
+            // A box that falls without any contact
+            RigidBody* fallingBox = world.createRigidBody(Transform(Vector3(20, 10, 0), Quaternion::identity()));
+            fallingBox->addCollisionShape(mBoxShape, Transform::identity(), decimal(1.0));
+            fallingBox->setLinearDamping(decimal(0.0));
+
+            // A stack of boxes resting on the floor
+            List<RigidBody*> stack(MemoryManager::getBaseAllocator());
+            for (uint b=0; b < 6; b++) {
+                RigidBody* body = world.createRigidBody(Transform(Vector3(0, decimal(0.5) + decimal(b), 0), Quaternion::identity()));
+                body->addCollisionShape(mBoxShape, Transform::identity(), decimal(1.0));
+                stack.add(body);
+            }
+
+            // Simulate one second with four substeps per step
+            for (uint i=0; i < 60; i++) {
+                world.update(decimal(1.0) / decimal(60.0), 4);
+            }
+
+            // The falling box is integrated with the time step of the substeps
+            // (semi-implicit Euler : y = y0 - g * dt^2 * n * (n + 1) / 2)
+            const decimal dt = decimal(1.0) / decimal(240.0);
+            const decimal expectedY = decimal(10.0) - decimal(9.81) * dt * dt * decimal(240 * 241) / decimal(2.0);
+            rp3d_test(approxEqual(fallingBox->getTransform().getPosition().y, expectedY, decimal(0.001)));
+
+            // The contacts reused during the substeps keep the stack on the floor
+            rp3d_test(approxEqual(stack[0]->getTransform().getPosition().y, decimal(0.5), decimal(0.05)));
+            rp3d_test(approxEqual(stack[5]->getTransform().getPosition().y, decimal(5.5), decimal(0.1)));
+            rp3d_test(approxEqual(stack[5]->getTransform().getPosition().x, decimal(0.0), decimal(0.05)));
+        }
+
+        void testPersistentIslands() {
+
+            DynamicsWorld world(Vector3(0, decimal(-9.81), 0));
+
+            RigidBody* floor = world.createRigidBody(Transform(Vector3(0, -1, 0), Quaternion::identity()));
+            floor->setType(BodyType::STATIC);
+            floor->addCollisionShape(mFloorShape, Transform::identity(), decimal(1.0));
+
+            // Two boxes in contact that are merged into the same island
+            RigidBody* restingBox = world.createRigidBody(Transform(Vector3(0, decimal(0.5), 0), Quaternion::identity()));
+            restingBox->addCollisionShape(mBoxShape, Transform::identity(), decimal(1.0));
+            RigidBody* movingBox = world.createRigidBody(Transform(Vector3(decimal(0.99), decimal(0.5), 0), Quaternion::identity()));
+            movingBox->addCollisionShape(mBoxShape, Transform::identity(), decimal(1.0));
+
+            // A box linked to the moving box with a joint
+            RigidBody* linkedBox = world.createRigidBody(Transform(Vector3(decimal(2.5), decimal(0.5), 0), Quaternion::identity()));
+            linkedBox->addCollisionShape(mBoxShape, Transform::identity(), decimal(1.0));
+            BallAndSocketJointInfo jointInfo(movingBox, linkedBox, Vector3(decimal(1.75), decimal(0.5), 0));
+            world.createJoint(jointInfo);
+
+            // The moving box goes away from the resting box forever
+            for (uint i=0; i < 180; i++) {
+                movingBox->setLinearVelocity(Vector3(2, 0, 0));
+                world.update(decimal(1.0) / decimal(60.0));
+            }
+
+            // The island of the two first boxes has been split when their contact has
+            // disappeared, so that the resting box can go to sleep
+            rp3d_test(restingBox->isSleeping());
+            rp3d_test(!movingBox->isSleeping());
+            rp3d_test(!linkedBox->isSleeping());
+
+            // Destroying a body of an island leaves the other bodies of the island valid
+            world.destroyRigidBody(linkedBox);
+            for (uint i=0; i < 10; i++) {
+                movingBox->setLinearVelocity(Vector3(2, 0, 0));
+                world.update(decimal(1.0) / decimal(60.0));
+            }
+            rp3d_test(movingBox->getTransform().getPosition().x > decimal(5.0));
+        }
+
+        void testIslandsRebuild() {
+
+            DefaultTaskScheduler scheduler(4);
+
+            WorldSettings parallelSettings;
+            parallelSettings.taskScheduler = &scheduler;
+
+            DynamicsWorld sequentialWorld(Vector3(0, decimal(-9.81), 0));
+            DynamicsWorld parallelWorld(Vector3(0, decimal(-9.81), 0), parallelSettings);
+
+            List<RigidBody*> sequentialBodies(MemoryManager::getBaseAllocator());
+            List<RigidBody*> parallelBodies(MemoryManager::getBaseAllocator());
+            createPile(sequentialWorld, sequentialBodies);
+            createPile(parallelWorld, parallelBodies);
+
+            // The islands rebuilt in parallel are linked in the same order as the sequential ones
+            for (uint i=0; i < 60; i++) {
+                if (i % 10 == 5) {
+                    sequentialWorld.rebuildIslands();
+                    parallelWorld.rebuildIslands();
+                }
+                sequentialWorld.update(decimal(1.0) / decimal(60.0));
+                parallelWorld.update(decimal(1.0) / decimal(60.0));
+            }
+            rp3d_test(isSameState(sequentialBodies, parallelBodies));
+
+            // The islands keep their sleep time when they are rebuilt
+            DynamicsWorld world(Vector3(0, decimal(-9.81), 0));
+            RigidBody* floor = world.createRigidBody(Transform(Vector3(0, -1, 0), Quaternion::identity()));
+            floor->setType(BodyType::STATIC);
+            floor->addCollisionShape(mFloorShape, Transform::identity(), decimal(1.0));
+            RigidBody* bottomBox = world.createRigidBody(Transform(Vector3(0, decimal(0.5), 0), Quaternion::identity()));
+            bottomBox->addCollisionShape(mBoxShape, Transform::identity(), decimal(1.0));
+            RigidBody* topBox = world.createRigidBody(Transform(Vector3(0, decimal(1.5), 0), Quaternion::identity()));
+            topBox->addCollisionShape(mBoxShape, Transform::identity(), decimal(1.0));
+
+            for (uint i=0; i < 180; i++) {
+                world.rebuildIslands();
+                world.update(decimal(1.0) / decimal(60.0));
+            }
+            rp3d_test(bottomBox->isSleeping());
+            rp3d_test(topBox->isSleeping());
+        }
+
+        void testRigidBodyStates() {
+
+            DynamicsWorld world(Vector3(0, 0, 0));
+
+            // Create more bodies than the initial capacity of the state store
+            List<RigidBody*> bodies(MemoryManager::getBaseAllocator());
+            for (uint i=0; i < 40; i++) {
+                RigidBody* body = world.createRigidBody(Transform(Vector3(decimal(i) * decimal(2.0), 0, 0), Quaternion::identity()));
+                body->addCollisionShape(mSphereShape, Transform::identity(), decimal(1.0));
+                body->setLinearVelocity(Vector3(decimal(i), 0, 0));
+                body->setAngularVelocity(Vector3(0, decimal(i), 0));
+                bodies.add(body);
+            }
+
+            // Destroy some bodies so that the states of the last bodies are moved
+            world.destroyRigidBody(bodies[0]);
+            world.destroyRigidBody(bodies[17]);
+            world.destroyRigidBody(bodies[39]);
+
+            // The remaining bodies still have their own state
+            bool isStateValid = true;
+            for (uint i=1; i < 39; i++) {
+                if (i == 17) continue;
+                isStateValid &= bodies[i]->getLinearVelocity() == Vector3(decimal(i), 0, 0);
+                isStateValid &= bodies[i]->getAngularVelocity() == Vector3(0, decimal(i), 0);
+            }
+            rp3d_test(isStateValid);
+
+            // The bodies are integrated with their own state
+            world.update(decimal(1.0) / decimal(60.0));
+            rp3d_test(approxEqual(bodies[38]->getTransform().getPosition().x,
+                                  decimal(76.0) + decimal(38.0) / decimal(60.0), decimal(0.001)));
+            rp3d_test(approxEqual(bodies[1]->getTransform().getPosition().x,
+                                  decimal(2.0) + decimal(1.0) / decimal(60.0), decimal(0.001)));
+        }
+
+        void testTransformDirtyBodies() {
+
+            DynamicsWorld world(Vector3(0, decimal(-9.81), 0));
+
+            // A kinematic body that does not move
+            const Transform initialTransform(Vector3(0, 5, 0), Quaternion(decimal(0.1), decimal(0.2), decimal(0.3), decimal(0.9)));
+            RigidBody* idleBody = world.createRigidBody(initialTransform);
+            idleBody->setType(BodyType::KINEMATIC);
+            idleBody->addCollisionShape(mBoxShape, Transform::identity(), decimal(1.0));
+
+            // A kinematic body that moves
+            RigidBody* movingBody = world.createRigidBody(Transform(Vector3(0, -5, 0), Quaternion::identity()));
+            movingBody->setType(BodyType::KINEMATIC);
+            movingBody->addCollisionShape(mBoxShape, Transform::identity(), decimal(1.0));
+            movingBody->setLinearVelocity(Vector3(10, 0, 0));
+
+            world.enableSleeping(false);
+
+            for (uint i=0; i < 60; i++) {
+                world.update(decimal(1.0) / decimal(60.0));
+            }
+
+            // The transform of the idle body has not been touched
+            rp3d_test(idleBody->getTransform().getPosition() == initialTransform.getPosition());
+            rp3d_test(idleBody->getTransform().getOrientation() == initialTransform.getOrientation());
+
+            // The broad-phase has been updated for the moving body
+            BodyOverlapCallback callback;
+            world.testAABBOverlap(AABB(Vector3(9, -6, -1), Vector3(11, -4, 1)), &callback);
+            rp3d_test(callback.hasOverlap(movingBody));
+            rp3d_test(!callback.hasOverlap(idleBody));
+
+            BodyOverlapCallback callbackStart;
+            world.testAABBOverlap(AABB(Vector3(-1, -6, -1), Vector3(1, -4, 1)), &callbackStart);
+            rp3d_test(!callbackStart.hasOverlap(movingBody));
+        }
+
+        void testAsynchronousUpdate() {
+
+            // The step of the asynchronous world is a job of the scheduler shared by the worlds
+            DefaultTaskScheduler scheduler(4);
+            WorldSettings settings;
+            settings.taskScheduler = &scheduler;
+
+            DynamicsWorld synchronousWorld(Vector3(0, decimal(-9.81), 0), settings);
+            DynamicsWorld asynchronousWorld(Vector3(0, decimal(-9.81), 0), settings);
+
+            List<RigidBody*> synchronousBodies(MemoryManager::getBaseAllocator());
+            List<RigidBody*> asynchronousBodies(MemoryManager::getBaseAllocator());
+            createPile(synchronousWorld, synchronousBodies);
+            createPile(asynchronousWorld, asynchronousBodies);
+
+            bool isSnapshotValid = true;
+            for (uint i=0; i < 30; i++) {
+
+                asynchronousWorld.startUpdate(decimal(1.0) / decimal(60.0));
+                rp3d_test(asynchronousWorld.isUpdateRunning());
+
+                // While the step is running, the snapshot contains the result of the previous step
+                for (uint b=0; b < synchronousBodies.size(); b++) {
+                    isSnapshotValid &= asynchronousBodies[b]->getSnapshotTransform().getPosition() ==
+                                       synchronousBodies[b]->getTransform().getPosition();
+                    isSnapshotValid &= asynchronousBodies[b]->getSnapshotLinearVelocity() ==
+                                       synchronousBodies[b]->getLinearVelocity();
+                }
+
+                // Another world is updated while the step is running
+                synchronousWorld.update(decimal(1.0) / decimal(60.0));
+
+                asynchronousWorld.waitUpdate();
+                rp3d_test(!asynchronousWorld.isUpdateRunning());
+            }
+
+            rp3d_test(isSnapshotValid);
+            rp3d_test(isSameState(synchronousBodies, asynchronousBodies));
+
+            // The world waits for a running step before being destroyed
+            asynchronousWorld.startUpdate(decimal(1.0) / decimal(60.0));
+        }
+
+        void testQuerySnapshot() {
+
+            WorldSettings settings;
+            settings.isQuerySnapshotUpdatedByStartUpdate = true;
+            DynamicsWorld world(Vector3(0, decimal(-9.81), 0), settings);
+
+            List<RigidBody*> bodies(MemoryManager::getBaseAllocator());
+            createPile(world, bodies);
+
+            const uint nbRays = 64;
+            const uint nbThreads = 4;
+
+            bool isSnapshotValid = true;
+            for (uint step=0; step < 20; step++) {
+
+                // Raycast the live world before the step
+                RaycastHit expectedHits[nbRays];
+                bool expectedIsHit[nbRays];
+                for (uint r=0; r < nbRays; r++) {
+                    const Vector3 origin(decimal(r % 8) * decimal(0.8) - decimal(3.0), 20, decimal(r / 8) * decimal(0.8) - decimal(3.0));
+                    expectedIsHit[r] = world.raycastClosest(Ray(origin, origin - Vector3(0, 40, 0)), expectedHits[r]);
+                }
+
+                world.startUpdate(decimal(1.0) / decimal(60.0));
+                rp3d_test(world.getQuerySnapshot().getNbProxyShapes() == 201);
+
+                // While the step is running, several threads query the snapshot of the previous state
+                const SceneQuerySnapshot& snapshot = world.getQuerySnapshot();
+                bool isThreadValid[nbThreads];
+                std::thread threads[nbThreads];
+                for (uint t=0; t < nbThreads; t++) {
+                    isThreadValid[t] = true;
+                    threads[t] = std::thread([&, t]() {
+                        for (uint r=t; r < nbRays; r += nbThreads) {
+                            const Vector3 origin(decimal(r % 8) * decimal(0.8) - decimal(3.0), 20, decimal(r / 8) * decimal(0.8) - decimal(3.0));
+                            const Ray ray(origin, origin - Vector3(0, 40, 0));
+                            RaycastHit hit;
+                            const bool isHit = snapshot.raycastClosest(ray, hit);
+                            isThreadValid[t] &= isHit == expectedIsHit[r] && snapshot.raycastAny(ray) == isHit;
+                            if (isHit && expectedIsHit[r]) {
+                                isThreadValid[t] &= hit.body == expectedHits[r].body &&
+                                                    hit.proxyShape == expectedHits[r].proxyShape &&
+                                                    approxEqual(hit.hitFraction, expectedHits[r].hitFraction, decimal(0.0001));
+                            }
+                        }
+                    });
+                }
+                for (uint t=0; t < nbThreads; t++) {
+                    threads[t].join();
+                    isSnapshotValid &= isThreadValid[t];
+                }
+
+                world.waitUpdate();
+            }
+
+            rp3d_test(isSnapshotValid);
+
+            // Outside of startUpdate(), the snapshot is only updated on request
+            world.update(decimal(1.0) / decimal(60.0));
+            OverlapHit hits[256];
+            bodies[0]->setTransform(Transform(Vector3(100, 0, 100), Quaternion::identity()));
+            const AABB farAABB(Vector3(99, -1, 99), Vector3(101, 1, 101));
+            rp3d_test(world.getQuerySnapshot().testAABBOverlap(farAABB, hits, 256) == 0);
+            world.updateQuerySnapshot();
+            rp3d_test(world.getQuerySnapshot().testAABBOverlap(farAABB, hits, 256) == 1);
+            rp3d_test(hits[0].body == bodies[0]);
+        }
+
+        void testWideContactSolver() {
+
+            WorldSettings scalarSettings;
+            WorldSettings wideSettings;
+            wideSettings.isWideContactSolverEnabled = true;
+
+            DynamicsWorld scalarWorld(Vector3(0, decimal(-9.81), 0), scalarSettings);
+            DynamicsWorld wideWorld(Vector3(0, decimal(-9.81), 0), wideSettings);
+
+            List<RigidBody*> scalarBodies(MemoryManager::getBaseAllocator());
+            List<RigidBody*> wideBodies(MemoryManager::getBaseAllocator());
+            createPile(scalarWorld, scalarBodies);
+            createPile(wideWorld, wideBodies);
+
+            for (uint i=0; i < 90; i++) {
+                scalarWorld.update(decimal(1.0) / decimal(60.0));
+                wideWorld.update(decimal(1.0) / decimal(60.0));
+            }
+
+            // The manifolds sharing a body are solved in the same order by both solvers
+            rp3d_test(isSameState(scalarBodies, wideBodies));
+
+            // Same test without the split impulses
+            scalarWorld.setContactsPositionCorrectionTechnique(ContactsPositionCorrectionTechnique::BAUMGARTE_CONTACTS);
+            wideWorld.setContactsPositionCorrectionTechnique(ContactsPositionCorrectionTechnique::BAUMGARTE_CONTACTS);
+            for (uint i=0; i < 30; i++) {
+                scalarWorld.update(decimal(1.0) / decimal(60.0));
+                wideWorld.update(decimal(1.0) / decimal(60.0));
+            }
+            rp3d_test(isSameState(scalarBodies, wideBodies));
+
+            // The bodies must rest on the floor
+            bool isAboveFloor = true;
+            for (uint b=0; b < wideBodies.size(); b++) {
+                isAboveFloor &= wideBodies[b]->getTransform().getPosition().y > decimal(0.0);
+            }
+            rp3d_test(isAboveFloor);
+        }
+
+        /// Create a chain of boxes linked with joints with a second row of boxes on top
+        /// (all the bodies are in a single island)
+        void createChain(DynamicsWorld& world, List<RigidBody*>& bodies) {
+
+            RigidBody* floor = world.createRigidBody(Transform(Vector3(0, -1, 0), Quaternion::identity()));
+            floor->setType(BodyType::STATIC);
+            floor->addCollisionShape(mFloorShape, Transform::identity(), decimal(1.0));
+
+            RigidBody* previousBody = nullptr;
+            for (uint i=0; i < 60; i++) {
+
+                const Vector3 position(decimal(i) * decimal(1.001) - decimal(30.0), decimal(0.5), 0);
+                RigidBody* body = world.createRigidBody(Transform(position, Quaternion::identity()));
+                body->addCollisionShape(mBoxShape, Transform::identity(), decimal(1.0));
+                bodies.add(body);
+
+                if (previousBody != nullptr) {
+                    BallAndSocketJointInfo jointInfo(previousBody, body, position - Vector3(decimal(0.5), 0, 0));
+                    world.createJoint(jointInfo);
+                }
+                previousBody = body;
+
+                RigidBody* topBody = world.createRigidBody(Transform(position + Vector3(decimal(0.3), decimal(1.05), 0),
+                                                                     Quaternion::identity()));
+                topBody->addCollisionShape(i % 2 == 0 ? static_cast<CollisionShape*>(mBoxShape) : mSphereShape,
+                                           Transform::identity(), decimal(1.0));
+                bodies.add(topBody);
+            }
+
+            // Attach the first box of the chain to the static floor
+            BallAndSocketJointInfo jointInfo(floor, bodies[0], bodies[0]->getTransform().getPosition());
+            world.createJoint(jointInfo);
+        }
+
+        void testConstraintColoring() {
+
+            DefaultTaskScheduler scheduler(4);
+
+            WorldSettings sequentialSettings;
+            sequentialSettings.isConstraintColoringEnabled = true;
+            WorldSettings parallelSettings;
+            parallelSettings.isConstraintColoringEnabled = true;
+            parallelSettings.taskScheduler = &scheduler;
+
+            DynamicsWorld sequentialWorld(Vector3(0, decimal(-9.81), 0), sequentialSettings);
+            DynamicsWorld parallelWorld(Vector3(0, decimal(-9.81), 0), parallelSettings);
+
+            List<RigidBody*> sequentialBodies(MemoryManager::getBaseAllocator());
+            List<RigidBody*> parallelBodies(MemoryManager::getBaseAllocator());
+            createChain(sequentialWorld, sequentialBodies);
+            createChain(parallelWorld, parallelBodies);
+
+            for (uint i=0; i < 60; i++) {
+                sequentialWorld.update(decimal(1.0) / decimal(60.0));
+                parallelWorld.update(decimal(1.0) / decimal(60.0));
+            }
+
+            // The constraints of a color are independent and the result does not depend on the scheduler
+            rp3d_test(isSameState(sequentialBodies, parallelBodies));
+
+            // Same test with the wide contact solver
+            sequentialSettings.isWideContactSolverEnabled = true;
+            parallelSettings.isWideContactSolverEnabled = true;
+            DynamicsWorld sequentialWideWorld(Vector3(0, decimal(-9.81), 0), sequentialSettings);
+            DynamicsWorld parallelWideWorld(Vector3(0, decimal(-9.81), 0), parallelSettings);
+
+            List<RigidBody*> sequentialWideBodies(MemoryManager::getBaseAllocator());
+            List<RigidBody*> parallelWideBodies(MemoryManager::getBaseAllocator());
+            createChain(sequentialWideWorld, sequentialWideBodies);
+            createChain(parallelWideWorld, parallelWideBodies);
+
+            for (uint i=0; i < 60; i++) {
+                sequentialWideWorld.update(decimal(1.0) / decimal(60.0));
+                parallelWideWorld.update(decimal(1.0) / decimal(60.0));
+            }
+
+            rp3d_test(isSameState(sequentialWideBodies, parallelWideBodies));
+
+            // The bodies must rest on the floor
+            bool isAboveFloor = true;
+            for (uint b=0; b < parallelBodies.size(); b++) {
+                isAboveFloor &= parallelBodies[b]->getTransform().getPosition().y > decimal(0.0);
+                isAboveFloor &= parallelWideBodies[b]->getTransform().getPosition().y > decimal(0.0);
+            }
+            rp3d_test(isAboveFloor);
+        }
+
+        void testSolverMemory() {
+
+            WorldSettings settings;
+            settings.isSleepingEnabled = false;
+            DynamicsWorld world(Vector3(0, decimal(-9.81), 0), settings);
+
+            List<RigidBody*> bodies(MemoryManager::getBaseAllocator());
+            createPile(world, bodies);
+
+            for (uint i=0; i < 60; i++) {
+                world.update(decimal(1.0) / decimal(60.0));
+            }
+
+            rp3d_test(world.getSolverMemoryHighWaterMark() > 0);
+            rp3d_test(world.getSolverMemoryCapacity() > 0);
+
+            // Once the pile is resting, the memory of the contact solver is reused
+            const size_t capacity = world.getSolverMemoryCapacity();
+            for (uint i=0; i < 60; i++) {
+                world.update(decimal(1.0) / decimal(60.0));
+            }
+            rp3d_test(world.getSolverMemoryCapacity() == capacity);
+            rp3d_test(world.getSolverMemoryHighWaterMark() <= 2 * capacity);
+        }
+
+        void testVelocitySolverEarlyExit() {
+
+            WorldSettings settings;
+            settings.isSleepingEnabled = false;
+            DynamicsWorld fixedWorld(Vector3(0, decimal(-9.81), 0), settings);
+            settings.isVelocitySolverEarlyExitEnabled = true;
+            DynamicsWorld earlyExitWorld(Vector3(0, decimal(-9.81), 0), settings);
+
+            // Boxes resting on the floor (one island per box)
+            List<RigidBody*> fixedBodies(MemoryManager::getBaseAllocator());
+            List<RigidBody*> earlyExitBodies(MemoryManager::getBaseAllocator());
+            DynamicsWorld* worlds[2] = {&fixedWorld, &earlyExitWorld};
+            List<RigidBody*>* bodies[2] = {&fixedBodies, &earlyExitBodies};
+            for (uint w=0; w < 2; w++) {
+
+                RigidBody* floor = worlds[w]->createRigidBody(Transform(Vector3(0, -1, 0), Quaternion::identity()));
+                floor->setType(BodyType::STATIC);
+                floor->addCollisionShape(mFloorShape, Transform::identity(), decimal(1.0));
+
+                for (uint i=0; i < 10; i++) {
+                    RigidBody* body = worlds[w]->createRigidBody(Transform(Vector3(decimal(i) * decimal(3.0) - decimal(15.0), decimal(0.5), 0),
+                                                                           Quaternion::identity()));
+                    body->addCollisionShape(mBoxShape, Transform::identity(), decimal(1.0));
+                    bodies[w]->add(body);
+                }
+            }
+
+            for (uint i=0; i < 120; i++) {
+                fixedWorld.update(decimal(1.0) / decimal(60.0));
+                earlyExitWorld.update(decimal(1.0) / decimal(60.0));
+            }
+
+            // Without the early exit, each island does all the iterations
+            rp3d_test(fixedWorld.getTotalNbVelocitySolverIterations() == 10 * fixedWorld.getNbIterationsVelocitySolver());
+
+            // The resting contacts converge before the maximum number of iterations
+            const uint nbIterations = earlyExitWorld.getTotalNbVelocitySolverIterations();
+            rp3d_test(nbIterations >= 10 * settings.minVelocitySolverNbIterations);
+            rp3d_test(nbIterations < 10 * earlyExitWorld.getNbIterationsVelocitySolver());
+
+            // The boxes still rest on the floor
+            bool isResting = true;
+            for (uint b=0; b < earlyExitBodies.size(); b++) {
+                isResting &= std::abs(earlyExitBodies[b]->getTransform().getPosition().y - fixedBodies[b]->getTransform().getPosition().y) < decimal(0.01);
+            }
+            rp3d_test(isResting);
+
+            // The joints converge too
+            DynamicsWorld chainWorld(Vector3(0, decimal(-9.81), 0), settings);
+            List<RigidBody*> chainBodies(MemoryManager::getBaseAllocator());
+            createChain(chainWorld, chainBodies);
+            for (uint i=0; i < 120; i++) {
+                chainWorld.update(decimal(1.0) / decimal(60.0));
+            }
+            rp3d_test(chainWorld.getTotalNbVelocitySolverIterations() < chainWorld.getNbIterationsVelocitySolver());
+            bool isAboveFloor = true;
+            for (uint b=0; b < chainBodies.size(); b++) {
+                isAboveFloor &= chainBodies[b]->getTransform().getPosition().y > decimal(0.0);
+            }
+            rp3d_test(isAboveFloor);
+        }
+
+        void testSolverIterationsPolicy() {
+
+            WorldSettings settings;
+            settings.isSleepingEnabled = false;
+            DynamicsWorld world(Vector3(0, decimal(-9.81), 0), settings);
+
+            TestSolverIterationsPolicy policy;
+            world.setSolverIterationsPolicy(&policy);
+
+            RigidBody* floor = world.createRigidBody(Transform(Vector3(0, -1, 0), Quaternion::identity()));
+            floor->setType(BodyType::STATIC);
+            floor->addCollisionShape(mFloorShape, Transform::identity(), decimal(1.0));
+
+            // A stack of five boxes with a heavy box on top (one large island)
+            List<RigidBody*> stackBodies(MemoryManager::getBaseAllocator());
+            for (uint i=0; i < 5; i++) {
+                RigidBody* body = world.createRigidBody(Transform(Vector3(0, decimal(0.5) + decimal(i), 0), Quaternion::identity()));
+                body->addCollisionShape(mBoxShape, Transform::identity(), decimal(1.0));
+                if (i == 4) body->setMass(decimal(10.0));
+                stackBodies.add(body);
+            }
+
+            // Some isolated debris (small islands)
+            for (uint i=0; i < 4; i++) {
+                RigidBody* body = world.createRigidBody(Transform(Vector3(decimal(5.0) + decimal(2.0) * decimal(i), decimal(0.5), 0),
+                                                                  Quaternion::identity()));
+                body->addCollisionShape(mBoxShape, Transform::identity(), decimal(1.0));
+            }
+
+            for (uint i=0; i < 60; i++) {
+                world.update(decimal(1.0) / decimal(60.0));
+            }
+
+            rp3d_test(policy.nbSteps == 60);
+            rp3d_test(policy.nbLargeIslands == 1);
+            rp3d_test(policy.nbSmallIslands == 4);
+            rp3d_test(approxEqual(policy.maxMassRatio, decimal(10.0)));
+            rp3d_test(world.getTotalNbVelocitySolverIterations() == 20 + 4 * 2);
+
+            // The stack must still be standing
+            bool isStanding = true;
+            for (uint b=0; b < stackBodies.size(); b++) {
+                isStanding &= std::abs(stackBodies[b]->getTransform().getPosition().y - (decimal(0.5) + decimal(b))) < decimal(0.05);
+            }
+            rp3d_test(isStanding);
+
+            // Without policy, the islands use the iterations of the world
+            world.setSolverIterationsPolicy(nullptr);
+            world.update(decimal(1.0) / decimal(60.0));
+            rp3d_test(world.getTotalNbVelocitySolverIterations() == 5 * world.getNbIterationsVelocitySolver());
+            rp3d_test(policy.nbSteps == 60);
+        }
+
+        /// Create a stack of boxes on the floor and return the largest speed of the boxes
+        /// during the last steps of the simulation
+        decimal simulateStack(DynamicsWorld& world, List<RigidBody*>& bodies, uint nbBoxes, uint nbSteps) {
+
+            RigidBody* floor = world.createRigidBody(Transform(Vector3(0, -1, 0), Quaternion::identity()));
+            floor->setType(BodyType::STATIC);
+            floor->addCollisionShape(mFloorShape, Transform::identity(), decimal(1.0));
+
+            for (uint i=0; i < nbBoxes; i++) {
+                RigidBody* body = world.createRigidBody(Transform(Vector3(0, decimal(0.5) + decimal(i), 0), Quaternion::identity()));
+                body->addCollisionShape(mBoxShape, Transform::identity(), decimal(1.0));
+                bodies.add(body);
+            }
+
+            decimal maxSpeed = decimal(0.0);
+            for (uint i=0; i < nbSteps; i++) {
+                world.update(decimal(1.0) / decimal(60.0));
+                if (i >= nbSteps - 60) {
+                    for (uint b=0; b < bodies.size(); b++) {
+                        maxSpeed = std::max(maxSpeed, bodies[b]->getLinearVelocity().length());
+                        maxSpeed = std::max(maxSpeed, bodies[b]->getAngularVelocity().length());
+                    }
+                }
+            }
+
+            return maxSpeed;
+        }
+
+        void testBlockContactSolver() {
+
+            WorldSettings settings;
+            settings.isSleepingEnabled = false;
+            settings.defaultVelocitySolverNbIterations = 3;
+            DynamicsWorld sequentialWorld(Vector3(0, decimal(-9.81), 0), settings);
+            settings.isBlockContactSolverEnabled = true;
+            DynamicsWorld blockWorld(Vector3(0, decimal(-9.81), 0), settings);
+
+            List<RigidBody*> sequentialBodies(MemoryManager::getBaseAllocator());
+            List<RigidBody*> blockBodies(MemoryManager::getBaseAllocator());
+            const decimal sequentialSpeed = simulateStack(sequentialWorld, sequentialBodies, 10, 300);
+            const decimal blockSpeed = simulateStack(blockWorld, blockBodies, 10, 300);
+
+            // With few iterations, the block solver keeps the stack still and standing
+            rp3d_test(blockSpeed < sequentialSpeed);
+            const Vector3 sequentialTop = sequentialBodies[9]->getTransform().getPosition();
+            const Vector3 blockTop = blockBodies[9]->getTransform().getPosition();
+            rp3d_test(blockTop.y > sequentialTop.y);
+            rp3d_test(blockTop.y > decimal(9.0));
+            rp3d_test(Vector2(blockTop.x, blockTop.z).length() < Vector2(sequentialTop.x, sequentialTop.z).length());
+
+            // The wide contact solver is not used with the block solver
+            settings.isWideContactSolverEnabled = true;
+            DynamicsWorld wideBlockWorld(Vector3(0, decimal(-9.81), 0), settings);
+            List<RigidBody*> wideBlockBodies(MemoryManager::getBaseAllocator());
+            simulateStack(wideBlockWorld, wideBlockBodies, 10, 300);
+            rp3d_test(isSameState(blockBodies, wideBlockBodies));
+        }
+
+        void testRollingResistanceIslands() {
+
+            WorldSettings settings;
+            settings.isSleepingEnabled = false;
+            DynamicsWorld world(Vector3(0, decimal(-9.81), 0), settings);
+
+            RigidBody* floor = world.createRigidBody(Transform(Vector3(0, decimal(-0.5), 0), Quaternion::identity()));
+            floor->setType(BodyType::STATIC);
+            floor->addCollisionShape(mFloorShape, Transform::identity(), decimal(1.0));
+
+            // Two spheres rolling on the floor in two different islands, only the first one with
+            // rolling resistance (the solver of each island is compiled for its features)
+            RigidBody* spheres[2];
+            for (uint i=0; i < 2; i++) {
+                spheres[i] = world.createRigidBody(Transform(Vector3(decimal(4.0) * decimal(i), decimal(0.5), 0),
+                                                             Quaternion::identity()));
+                spheres[i]->addCollisionShape(mSphereShape, Transform::identity(), decimal(1.0));
+                spheres[i]->setLinearVelocity(Vector3(0, 0, decimal(2.0)));
+                spheres[i]->setAngularVelocity(Vector3(decimal(4.0), 0, 0));
+            }
+            spheres[0]->getMaterial().setRollingResistance(decimal(0.05));
+
+            for (uint i=0; i < 60; i++) {
+                world.update(decimal(1.0) / decimal(60.0));
+            }
+
+            rp3d_test(spheres[1]->getLinearVelocity().z > decimal(1.9));
+            rp3d_test(spheres[0]->getLinearVelocity().z < decimal(1.8));
+            rp3d_test(spheres[0]->getLinearVelocity().z > decimal(0.0));
+        }
+
+        void testMaterialTable() {
+
+            WorldSettings settings;
+            settings.isSleepingEnabled = false;
+            DynamicsWorld world(Vector3(0, decimal(-9.81), 0), settings);
+            MaterialTable& table = world.getMaterialTable();
+
+            // The default material of the bodies is registered with the world
+            rp3d_test(table.getNbMaterials() == 1);
+            RigidBody* floor = world.createRigidBody(Transform(Vector3(0, -1, 0), Quaternion::identity()));
+            floor->setType(BodyType::STATIC);
+            floor->addCollisionShape(mFloorShape, Transform::identity(), decimal(1.0));
+            rp3d_test(floor->getMaterial().getId() == Material::DEFAULT_ID);
+
+            Material rubber(settings);
+            rubber.setFrictionCoefficient(decimal(1.0));
+            Material ice(settings);
+            ice.setFrictionCoefficient(decimal(0.3));
+            rp3d_test(rubber.getId() == Material::UNREGISTERED_ID);
+            const uint16 rubberId = table.registerMaterial(rubber);
+            const uint16 iceId = table.registerMaterial(ice);
+            rp3d_test(rubberId == 1 && iceId == 2 && ice.getId() == iceId);
+
+            // The pairs are combined with the default rules unless they are overridden
+            const MaterialPairProperties& combined = table.getPairProperties(iceId, rubberId);
+            rp3d_test(approxEqual(combined.frictionCoefficient, std::sqrt(decimal(0.3)), decimal(0.0001)));
+            MaterialPairProperties iceOnRubber = combined;
+            iceOnRubber.frictionCoefficient = decimal(0.0);
+            table.setPairProperties(rubberId, iceId, iceOnRubber);
+            rp3d_test(table.getPairProperties(iceId, rubberId).frictionCoefficient == decimal(0.0));
+
+            // Registering another material keeps the overridden pairs
+            Material wood(settings);
+            table.registerMaterial(wood);
+            rp3d_test(table.getPairProperties(iceId, rubberId).frictionCoefficient == decimal(0.0));
+
+            floor->setMaterial(rubber);
+
+            // The first box uses the registered ice and the second one a modified copy of it
+            // (not registered anymore) that is combined with the default rules
+            RigidBody* boxes[2];
+            for (uint i=0; i < 2; i++) {
+                boxes[i] = world.createRigidBody(Transform(Vector3(0, decimal(0.5), decimal(4.0) * decimal(i)),
+                                                           Quaternion::identity()));
+                boxes[i]->addCollisionShape(mBoxShape, Transform::identity(), decimal(1.0));
+                boxes[i]->setLinearVelocity(Vector3(decimal(3.0), 0, 0));
+                boxes[i]->setMaterial(ice);
+            }
+            boxes[1]->getMaterial().setFrictionCoefficient(decimal(0.3));
+            rp3d_test(boxes[1]->getMaterial().getId() == Material::UNREGISTERED_ID);
+
+            for (uint i=0; i < 30; i++) {
+                world.update(decimal(1.0) / decimal(60.0));
+            }
+
+            rp3d_test(boxes[0]->getLinearVelocity().x > decimal(2.9));
+            rp3d_test(boxes[1]->getLinearVelocity().x < decimal(1.0));
+        }
+
+        /// Simulate a stack of boxes resting on a floor and return the positions of the boxes
+        /// and the number of reused contact points during the last step
+        uint simulateRestingStack(const WorldSettings& settings, List<Vector3>& positions) {
+
+            DynamicsWorld world(Vector3(0, decimal(-9.81), 0), settings);
+
+            RigidBody* floor = world.createRigidBody(Transform(Vector3(0, -1, 0), Quaternion::identity()));
+            floor->setType(BodyType::STATIC);
+            floor->addCollisionShape(mFloorShape, Transform::identity(), decimal(1.0));
+
+            List<RigidBody*> boxes(MemoryManager::getBaseAllocator());
+            for (uint i=0; i < 4; i++) {
+                RigidBody* box = world.createRigidBody(Transform(Vector3(0, decimal(0.5) + decimal(i), 0),
+                                                                 Quaternion::identity()));
+                box->addCollisionShape(mBoxShape, Transform::identity(), decimal(1.0));
+                boxes.add(box);
+            }
+
+            for (uint i=0; i < 120; i++) {
+                world.update(decimal(1.0) / decimal(60.0));
+            }
+
+            for (uint i=0; i < boxes.size(); i++) {
+                positions.add(boxes[i]->getTransform().getPosition());
+            }
+
+            return world.getStepStatistics().nbReusedContactPoints;
+        }
+
+        void testContactSolverDataCache() {
+
+            WorldSettings settings;
+            settings.isSleepingEnabled = false;
+            WorldSettings cacheSettings = settings;
+            cacheSettings.isContactSolverDataCacheEnabled = true;
+
+            // The resting contacts that reuse their solver data give the same result as the
+            // contacts that recompute it at each step
+            List<Vector3> positions(MemoryManager::getBaseAllocator());
+            List<Vector3> cachePositions(MemoryManager::getBaseAllocator());
+            const uint nbReusedContactPoints = simulateRestingStack(settings, positions);
+            const uint cacheNbReusedContactPoints = simulateRestingStack(cacheSettings, cachePositions);
+            rp3d_test(nbReusedContactPoints == 0);
+            rp3d_test(cacheNbReusedContactPoints > 0);
+            for (uint i=0; i < positions.size(); i++) {
+                rp3d_test((cachePositions[i] - positions[i]).length() < decimal(0.001));
+                rp3d_test(std::abs(cachePositions[i].y - (decimal(0.5) + decimal(i))) < decimal(0.05));
+            }
+        }
+
+        /// Shoot fast spheres at a thin static wall and return the smallest and largest
+        /// final positions of the spheres along the direction of the shots
+        void shootSpheresAtWall(bool isBullet, TaskScheduler* scheduler, decimal& outMinZ, decimal& outMaxZ) {
+
+            BoxShape wallShape(Vector3(20, 2, decimal(0.05)));
+
+            WorldSettings settings;
+            settings.taskScheduler = scheduler;
+            DynamicsWorld world(Vector3(0, 0, 0), settings);
+
+            RigidBody* wall = world.createRigidBody(Transform::identity());
+            wall->setType(BodyType::STATIC);
+            wall->addCollisionShape(&wallShape, Transform::identity(), decimal(1.0));
+            wall->getMaterial().setBounciness(decimal(0.0));
+
+            // Each sphere moves 5 meters during a step
+            List<RigidBody*> spheres(MemoryManager::getBaseAllocator());
+            for (uint i=0; i < 10; i++) {
+                const Vector3 position(decimal(-15.0) + decimal(3.0) * decimal(i), 0, -3);
+                RigidBody* sphere = world.createRigidBody(Transform(position, Quaternion::identity()));
+                sphere->addCollisionShape(mSphereShape, Transform::identity(), decimal(1.0));
+                sphere->getMaterial().setBounciness(decimal(0.0));
+                sphere->setIsBullet(isBullet);
+                sphere->setLinearVelocity(Vector3(0, 0, 300));
+                spheres.add(sphere);
+            }
+
+            for (uint i=0; i < 10; i++) {
+                world.update(decimal(1.0) / decimal(60.0));
+            }
+
+            outMinZ = DECIMAL_LARGEST;
+            outMaxZ = -DECIMAL_LARGEST;
+            for (uint i=0; i < spheres.size(); i++) {
+                outMinZ = std::min(outMinZ, spheres[i]->getTransform().getPosition().z);
+                outMaxZ = std::max(outMaxZ, spheres[i]->getTransform().getPosition().z);
+            }
+        }
+
+        void testBulletRigidBody() {
+
+            decimal minZ, maxZ;
+
+            // Fast spheres go through the thin wall with the discrete collision detection
+            shootSpheresAtWall(false, nullptr, minZ, maxZ);
+            rp3d_test(minZ > decimal(10.0));
+
+            // Bullet spheres are stopped by the wall without going through it
+            shootSpheresAtWall(true, nullptr, minZ, maxZ);
+            rp3d_test(maxZ < decimal(-0.5));
+            rp3d_test(minZ > decimal(-0.6));
+
+            // The same speculative contacts are created by the parallel narrow-phase
+            DefaultTaskScheduler scheduler(4);
+            shootSpheresAtWall(true, &scheduler, minZ, maxZ);
+            rp3d_test(maxZ < decimal(-0.5));
+            rp3d_test(minZ > decimal(-0.6));
+        }
+
+        /// Create a horizontal chain of boxes hanging from a static body and linked with
+        /// the different types of joints
+        void createJointsChain(DynamicsWorld& world, List<RigidBody*>& bodies) {
+
+            RigidBody* anchor = world.createRigidBody(Transform(Vector3(0, 10, 0), Quaternion::identity()));
+            anchor->setType(BodyType::STATIC);
+            bodies.add(anchor);
+
+            for (uint i=1; i <= 16; i++) {
+
+                const Vector3 position(decimal(i), 10, 0);
+                RigidBody* body = world.createRigidBody(Transform(position, Quaternion::identity()));
+                body->addCollisionShape(mSphereShape, Transform::identity(), decimal(1.0));
+                const Vector3 anchorPoint = position - Vector3(decimal(0.5), 0, 0);
+
+                switch (i % 4) {
+                    case 0: world.createJoint(BallAndSocketJointInfo(bodies[i - 1], body, anchorPoint)); break;
+                    case 1: world.createJoint(HingeJointInfo(bodies[i - 1], body, anchorPoint, Vector3(0, 0, 1))); break;
+                    case 2: world.createJoint(BallAndSocketJointInfo(bodies[i - 1], body, anchorPoint)); break;
+                    case 3: world.createJoint(FixedJointInfo(bodies[i - 1], body, anchorPoint)); break;
+                }
+
+                bodies.add(body);
+            }
+        }
+
+        /// Return the largest distance between two consecutive bodies of a list
+        decimal computeMaxDistance(const List<RigidBody*>& bodies) {
+
+            decimal maxDistance = decimal(0.0);
+            for (uint i=1; i < bodies.size(); i++) {
+                const Vector3 distance = bodies[i]->getTransform().getPosition() - bodies[i - 1]->getTransform().getPosition();
+                maxDistance = std::max(maxDistance, distance.length());
+            }
+
+            return maxDistance;
+        }
+
+        void testJointBatching() {
+
+            WorldSettings settings;
+            DynamicsWorld world(Vector3(0, decimal(-9.81), 0), settings);
+            settings.isJointBatchingEnabled = true;
+            DynamicsWorld batchedWorld(Vector3(0, decimal(-9.81), 0), settings);
+
+            // With only ball-and-socket joints, the joints are solved in the same order
+            // and with the same computations
+            List<RigidBody*> bodies(MemoryManager::getBaseAllocator());
+            List<RigidBody*> batchedBodies(MemoryManager::getBaseAllocator());
+            createChain(world, bodies);
+            createChain(batchedWorld, batchedBodies);
+
+            for (uint i=0; i < 60; i++) {
+                world.update(decimal(1.0) / decimal(60.0));
+                batchedWorld.update(decimal(1.0) / decimal(60.0));
+            }
+            rp3d_test(isSameState(bodies, batchedBodies));
+
+            // With different types of joints, the batched joints are solved in another order
+            // but the bodies must still be linked together
+            DynamicsWorld chainWorld(Vector3(0, decimal(-9.81), 0), settings);
+            DynamicsWorld otherChainWorld(Vector3(0, decimal(-9.81), 0), settings);
+            List<RigidBody*> chainBodies(MemoryManager::getBaseAllocator());
+            List<RigidBody*> otherChainBodies(MemoryManager::getBaseAllocator());
+            createJointsChain(chainWorld, chainBodies);
+            createJointsChain(otherChainWorld, otherChainBodies);
+
+            for (uint i=0; i < 120; i++) {
+                chainWorld.update(decimal(1.0) / decimal(60.0));
+                otherChainWorld.update(decimal(1.0) / decimal(60.0));
+            }
+            rp3d_test(isSameState(chainBodies, otherChainBodies));
+            rp3d_test(computeMaxDistance(chainBodies) < decimal(1.05));
+            rp3d_test(chainBodies[16]->getTransform().getPosition().y < decimal(9.0));
+        }
+
+        /// Simulate a horizontal chain of spheres hanging from a static body with a side branch
+        /// at every fifth link and return the largest distance between the anchor points of the
+        /// joints of the chain at the end of the simulation
+        decimal simulateHangingChain(const WorldSettings& settings, bool isLoopClosed, uint nbVelocityIterations) {
+
+            DynamicsWorld world(Vector3(0, decimal(-9.81), 0), settings);
+            world.enableSleeping(false);
+            world.setNbIterationsVelocitySolver(nbVelocityIterations);
+            world.setNbIterationsPositionSolver(1);
+
+            List<RigidBody*> bodies(MemoryManager::getBaseAllocator());
+            RigidBody* anchor = world.createRigidBody(Transform(Vector3(0, 20, 0), Quaternion::identity()));
+            anchor->setType(BodyType::STATIC);
+            bodies.add(anchor);
+
+            for (uint i=1; i <= 20; i++) {
+
+                const Vector3 position(decimal(i), 20, 0);
+                RigidBody* body = world.createRigidBody(Transform(position, Quaternion::identity()));
+                body->addCollisionShape(mSphereShape, Transform::identity(), decimal(1.0));
+
+                BallAndSocketJointInfo jointInfo(bodies[i - 1], body, position - Vector3(decimal(0.5), 0, 0));
+                jointInfo.isCollisionEnabled = false;
+                world.createJoint(jointInfo);
+
+                // Add a branch with a hinge joint
+                if (i % 5 == 0) {
+                    RigidBody* branch = world.createRigidBody(Transform(position - Vector3(0, 1, 0), Quaternion::identity()));
+                    branch->addCollisionShape(mSphereShape, Transform::identity(), decimal(1.0));
+                    HingeJointInfo hingeInfo(body, branch, position - Vector3(0, decimal(0.5), 0), Vector3(0, 0, 1));
+                    hingeInfo.isCollisionEnabled = false;
+                    world.createJoint(hingeInfo);
+                }
+
+                bodies.add(body);
+            }
+
+            // Close a loop between two links of the chain
+            if (isLoopClosed) {
+                const Vector3 position = bodies[6]->getTransform().getPosition() - Vector3(0, 1, 0);
+                RigidBody* body = world.createRigidBody(Transform(position, Quaternion::identity()));
+                body->addCollisionShape(mBoxShape, Transform::identity(), decimal(1.0));
+                FixedJointInfo jointInfo1(bodies[6], body, position);
+                jointInfo1.isCollisionEnabled = false;
+                world.createJoint(jointInfo1);
+                FixedJointInfo jointInfo2(bodies[7], body, position + Vector3(1, 0, 0));
+                jointInfo2.isCollisionEnabled = false;
+                world.createJoint(jointInfo2);
+            }
+
+            for (uint i=0; i < 60; i++) {
+                world.update(decimal(1.0) / decimal(60.0));
+            }
+
+            decimal maxError = decimal(0.0);
+            for (uint i=1; i < bodies.size(); i++) {
+                const Vector3 anchor1 = bodies[i - 1]->getTransform() * Vector3(decimal(0.5), 0, 0);
+                const Vector3 anchor2 = bodies[i]->getTransform() * Vector3(decimal(-0.5), 0, 0);
+                maxError = std::max(maxError, (anchor2 - anchor1).length());
+            }
+
+            return maxError;
+        }
+
+        void testArticulationSolver() {
+
+            WorldSettings settings;
+            WorldSettings articulationSettings;
+            articulationSettings.isArticulationSolverEnabled = true;
+
+            // With a single velocity iteration, the articulation solver keeps the chain together
+            // better than the sequential impulses with many iterations
+            const decimal error = simulateHangingChain(settings, false, 1);
+            const decimal articulationError = simulateHangingChain(articulationSettings, false, 1);
+            const decimal manyIterationsError = simulateHangingChain(settings, false, 50);
+            rp3d_test(articulationError < decimal(0.25) * error);
+            rp3d_test(articulationError < manyIterationsError);
+
+            // The joints that close a loop are solved by the sequential impulses
+            const decimal loopError = simulateHangingChain(settings, true, 1);
+            const decimal articulationLoopError = simulateHangingChain(articulationSettings, true, 1);
+            rp3d_test(articulationLoopError < decimal(0.25) * loopError);
+        }
+
+        /// Create a horizontal chain of spheres connected by ball and socket joints in a world
+        /// without gravity, simulate it until it sleeps and push the first sphere of the chain
+        void createSleepingChain(DynamicsWorld& world, List<RigidBody*>& bodies) {
+
+            for (uint i=0; i < 10; i++) {
+
+                const Vector3 position(decimal(i), 0, 0);
+                RigidBody* body = world.createRigidBody(Transform(position, Quaternion::identity()));
+                body->addCollisionShape(mSphereShape, Transform::identity(), decimal(1.0));
+                body->setLinearDamping(decimal(0.9));
+                body->setAngularDamping(decimal(0.9));
+
+                if (i > 0) {
+                    BallAndSocketJointInfo jointInfo(bodies[i - 1], body, position - Vector3(decimal(0.5), 0, 0));
+                    jointInfo.isCollisionEnabled = false;
+                    world.createJoint(jointInfo);
+                }
+
+                bodies.add(body);
+            }
+
+            for (uint i=0; i < 120; i++) {
+                world.update(decimal(1.0) / decimal(60.0));
+            }
+            for (uint i=0; i < bodies.size(); i++) {
+                rp3d_test(bodies[i]->isSleeping());
+            }
+
+            bodies[0]->setLinearVelocity(Vector3(0, 0, decimal(0.5)));
+            world.update(decimal(1.0) / decimal(60.0));
+        }
+
+        void testPartialWakeUp() {
+
+            // By default, the whole island is woken up
+            {
+                DynamicsWorld world(Vector3(0, 0, 0));
+                List<RigidBody*> bodies(MemoryManager::getBaseAllocator());
+                createSleepingChain(world, bodies);
+                for (uint i=0; i < bodies.size(); i++) {
+                    rp3d_test(!bodies[i]->isSleeping());
+                }
+            }
+
+            // With the partial wake-up, only the neighbors of the moving sphere are woken up
+            // and the other spheres of the chain are not moved by the solver
+            WorldSettings settings;
+            settings.isPartialWakeUpEnabled = true;
+            DynamicsWorld world(Vector3(0, 0, 0), settings);
+            List<RigidBody*> bodies(MemoryManager::getBaseAllocator());
+            createSleepingChain(world, bodies);
+
+            rp3d_test(!bodies[0]->isSleeping());
+            rp3d_test(!bodies[1]->isSleeping());
+            rp3d_test(bodies[0]->getTransform().getPosition().z > decimal(0.0));
+            for (uint i=2; i < bodies.size(); i++) {
+                rp3d_test(bodies[i]->isSleeping());
+                rp3d_test(bodies[i]->getTransform().getPosition() == Vector3(decimal(i), 0, 0));
+                rp3d_test(bodies[i]->getLinearVelocity() == Vector3::zero());
+            }
+
+            // The mass of the spheres used as fixed bodies has been restored
+            rp3d_test(approxEqual(bodies[2]->getMass(), decimal(1.0)));
+
+            // The chain goes to sleep again once the motion has been damped
+            uint nbSteps = 0;
+            bool isChainSleeping = false;
+            while (!isChainSleeping && nbSteps < 600) {
+                world.update(decimal(1.0) / decimal(60.0));
+                nbSteps++;
+                isChainSleeping = true;
+                for (uint i=0; i < bodies.size(); i++) {
+                    isChainSleeping = isChainSleeping && bodies[i]->isSleeping();
+                }
+            }
+            rp3d_test(isChainSleeping);
+            rp3d_test(bodies[9]->getTransform().getPosition().z >= decimal(0.0));
+
+            // The spheres still move together
+            bodies[9]->setLinearVelocity(Vector3(0, decimal(2.0), 0));
+            for (uint i=0; i < 60; i++) {
+                world.update(decimal(1.0) / decimal(60.0));
+            }
+            for (uint i=1; i < bodies.size(); i++) {
+                const Vector3 anchor1 = bodies[i - 1]->getTransform() * Vector3(decimal(0.5), 0, 0);
+                const Vector3 anchor2 = bodies[i]->getTransform() * Vector3(decimal(-0.5), 0, 0);
+                rp3d_test((anchor2 - anchor1).length() < decimal(0.1));
+            }
+        }
+
+        /// Create two sleeping horizontal chains of spheres (connected by ball and socket joints) at
+        /// a large distance from each other in a world without gravity
+        void createTwoSleepingChains(DynamicsWorld& world, List<RigidBody*>& chain1, List<RigidBody*>& chain2) {
+
+            for (uint c=0; c < 2; c++) {
+
+                List<RigidBody*>& bodies = c == 0 ? chain1 : chain2;
+                for (uint i=0; i < 10; i++) {
+
+                    const Vector3 position(decimal(i), decimal(20 * c), 0);
+                    RigidBody* body = world.createRigidBody(Transform(position, Quaternion::identity()));
+                    body->addCollisionShape(mSphereShape, Transform::identity(), decimal(1.0));
+
+                    if (i > 0) {
+                        BallAndSocketJointInfo jointInfo(bodies[i - 1], body, position - Vector3(decimal(0.5), 0, 0));
+                        jointInfo.isCollisionEnabled = false;
+                        world.createJoint(jointInfo);
+                    }
+
+                    bodies.add(body);
+                }
+            }
+
+            for (uint i=0; i < 120; i++) {
+                world.update(decimal(1.0) / decimal(60.0));
+            }
+            for (uint i=0; i < 10; i++) {
+                rp3d_test(chain1[i]->isSleeping());
+                rp3d_test(chain2[i]->isSleeping());
+            }
+        }
+
+        void testWakeBodies() {
+
+            {
+                DynamicsWorld world(Vector3(0, 0, 0));
+                List<RigidBody*> chain1(MemoryManager::getBaseAllocator());
+                List<RigidBody*> chain2(MemoryManager::getBaseAllocator());
+                createTwoSleepingChains(world, chain1, chain2);
+
+                // The island of the first chain is only woken up once
+                RigidBody* bodies[4] = {chain1[3], chain1[5], chain1[3], chain1[7]};
+                rp3d_test(world.wakeBodies(bodies, 4) == 10);
+                for (uint i=0; i < 10; i++) {
+                    rp3d_test(!chain1[i]->isSleeping());
+                    rp3d_test(chain2[i]->isSleeping());
+                }
+                rp3d_test(world.wakeBodies(bodies, 4) == 0);
+
+                // The region of the first sphere of the second chain wakes up the whole chain
+                const AABB region(Vector3(decimal(-0.2), decimal(19.8), decimal(-0.2)),
+                                  Vector3(decimal(0.2), decimal(20.2), decimal(0.2)));
+                rp3d_test(world.wakeRegion(region) == 10);
+                for (uint i=0; i < 10; i++) {
+                    rp3d_test(!chain2[i]->isSleeping());
+                }
+                rp3d_test(world.wakeRegion(region) == 0);
+
+                // A region without bodies does not wake up anything
+                world.update(decimal(1.0) / decimal(60.0));
+                const AABB emptyRegion(Vector3(50, 50, 50), Vector3(51, 51, 51));
+                rp3d_test(world.wakeRegion(emptyRegion) == 0);
+            }
+
+            // With the partial wake-up, only the bodies of the array are woken up
+            WorldSettings settings;
+            settings.isPartialWakeUpEnabled = true;
+            DynamicsWorld world(Vector3(0, 0, 0), settings);
+            List<RigidBody*> chain1(MemoryManager::getBaseAllocator());
+            List<RigidBody*> chain2(MemoryManager::getBaseAllocator());
+            createTwoSleepingChains(world, chain1, chain2);
+
+            RigidBody* bodies[3] = {chain1[3], chain1[3], chain2[0]};
+            rp3d_test(world.wakeBodies(bodies, 3) == 2);
+            rp3d_test(!chain1[3]->isSleeping());
+            rp3d_test(chain1[4]->isSleeping());
+            rp3d_test(!chain2[0]->isSleeping());
+            rp3d_test(chain2[1]->isSleeping());
+        }
+
+        void testRadialImpulse() {
+
+            DynamicsWorld world(Vector3(0, 0, 0));
+
+            // Spheres around the center and a static wall between the center and the last sphere
+            const Vector3 positions[4] = {Vector3(decimal(1.5), 0, 0), Vector3(0, 0, decimal(3.0)),
+                                          Vector3(decimal(8.0), 0, 0), Vector3(decimal(-3.0), 0, 0)};
+            RigidBody* spheres[4];
+            for (uint i=0; i < 4; i++) {
+                spheres[i] = world.createRigidBody(Transform(positions[i], Quaternion::identity()));
+                spheres[i]->addCollisionShape(mSphereShape, Transform::identity(), decimal(1.0));
+            }
+            RigidBody* wall = world.createRigidBody(Transform(Vector3(decimal(-1.5), 0, 0), Quaternion::identity()));
+            wall->setType(BodyType::STATIC);
+            wall->addCollisionShape(mBoxShape, Transform::identity(), decimal(1.0));
+
+            for (uint i=0; i < 120; i++) {
+                world.update(decimal(1.0) / decimal(60.0));
+            }
+            rp3d_test(spheres[0]->isSleeping());
+
+            // The occluded sphere is not pushed
+            rp3d_test(world.applyRadialImpulse(Vector3::zero(), decimal(5.0), decimal(2.0), RadialFalloff::LINEAR,
+                                               ALL_COLLISION_CATEGORIES, ALL_COLLISION_CATEGORIES) == 2);
+            rp3d_test(!spheres[0]->isSleeping());
+            rp3d_test(spheres[0]->getLinearVelocity().x > spheres[1]->getLinearVelocity().z);
+            rp3d_test(spheres[1]->getLinearVelocity().z > decimal(0.0));
+            rp3d_test(approxEqual(spheres[0]->getLinearVelocity().x, decimal(1.6), decimal(0.001)));
+            rp3d_test(spheres[2]->getLinearVelocity() == Vector3::zero());
+            rp3d_test(spheres[3]->getLinearVelocity() == Vector3::zero());
+            rp3d_test(wall->getLinearVelocity() == Vector3::zero());
+
+            // Without the occlusion test, the sphere behind the wall is pushed away from the center
+            rp3d_test(world.applyRadialImpulse(Vector3::zero(), decimal(5.0), decimal(1.0), RadialFalloff::CONSTANT) == 3);
+            rp3d_test(approxEqual(spheres[3]->getLinearVelocity().x, decimal(-1.0), decimal(0.001)));
+            rp3d_test(spheres[2]->getLinearVelocity() == Vector3::zero());
+
+            world.update(decimal(1.0) / decimal(60.0));
+            rp3d_test(spheres[0]->getTransform().getPosition().x > decimal(1.5));
+            rp3d_test(spheres[3]->getTransform().getPosition().x < decimal(-3.0));
+        }
+
+        /// Hang a sphere of mass 1 below a static body with a ball and socket joint and simulate it
+        /// for one second. Return the number of joints remaining in the world.
+        uint simulateHangingSphere(decimal breakForce, JointBreakListener& listener) {
+
+            DynamicsWorld world(Vector3(0, decimal(-9.81), 0));
+            world.setEventListener(&listener);
+
+            RigidBody* anchor = world.createRigidBody(Transform(Vector3(0, 2, 0), Quaternion::identity()));
+            anchor->setType(BodyType::STATIC);
+            RigidBody* sphere = world.createRigidBody(Transform(Vector3(0, 1, 0), Quaternion::identity()));
+            sphere->addCollisionShape(mSphereShape, Transform::identity(), decimal(1.0));
+
+            BallAndSocketJointInfo jointInfo(anchor, sphere, Vector3(0, decimal(1.5), 0));
+            jointInfo.breakForce = breakForce;
+            Joint* joint = world.createJoint(jointInfo);
+            rp3d_test(joint->getBreakForce() == breakForce);
+            rp3d_test(joint->getBreakTorque() == DECIMAL_LARGEST);
+
+            for (uint i=0; i < 60; i++) {
+                world.update(decimal(1.0) / decimal(60.0));
+            }
+
+            return world.getNbJoints();
+        }
+
+        void testBreakableJoints() {
+
+            // The joint holds the weight of the sphere if its break force is large enough
+            JointBreakListener strongJointListener;
+            rp3d_test(simulateHangingSphere(decimal(20.0), strongJointListener) == 1);
+            rp3d_test(strongJointListener.brokenJointsIds.empty());
+
+            // Otherwise, the joint is broken and destroyed by the world
+            JointBreakListener weakJointListener;
+            rp3d_test(simulateHangingSphere(decimal(5.0), weakJointListener) == 0);
+            rp3d_test(weakJointListener.brokenJointsIds.size() == 1);
+
+            // A broken joint does not hold the sphere anymore
+            DynamicsWorld world(Vector3(0, decimal(-9.81), 0));
+            JointBreakListener listener;
+            world.setEventListener(&listener);
+            RigidBody* anchor = world.createRigidBody(Transform(Vector3(0, 2, 0), Quaternion::identity()));
+            anchor->setType(BodyType::STATIC);
+            RigidBody* sphere = world.createRigidBody(Transform(Vector3(0, 1, 0), Quaternion::identity()));
+            sphere->addCollisionShape(mSphereShape, Transform::identity(), decimal(1.0));
+            FixedJointInfo jointInfo(anchor, sphere, Vector3(0, decimal(1.5), 0));
+            Joint* joint = world.createJoint(jointInfo);
+            joint->setBreakTorque(decimal(100.0));
+            joint->setBreakForce(decimal(5.0));
+            for (uint i=0; i < 60; i++) {
+                world.update(decimal(1.0) / decimal(60.0));
+            }
+            rp3d_test(listener.brokenJointsIds.size() == 1);
+            rp3d_test(world.getNbJoints() == 0);
+            rp3d_test(sphere->getTransform().getPosition().y < decimal(0.0));
+        }
+
+        void testBulkJoints() {
+
+            DynamicsWorld world(Vector3(0, decimal(-9.81), 0));
+
+            RigidBody* anchor = world.createRigidBody(Transform(Vector3(0, 10, 0), Quaternion::identity()));
+            anchor->setType(BodyType::STATIC);
+
+            // Create a chain of spheres with joints of every type
+            const uint NB_JOINTS = 8;
+            List<RigidBody*> bodies(MemoryManager::getBaseAllocator());
+            bodies.add(anchor);
+            for (uint i=1; i <= NB_JOINTS; i++) {
+                RigidBody* body = world.createRigidBody(Transform(Vector3(decimal(i), 10, 0), Quaternion::identity()));
+                body->addCollisionShape(mSphereShape, Transform::identity(), decimal(1.0));
+                bodies.add(body);
+            }
+
+            const Vector3 axis(0, 0, 1);
+            List<JointInfo*> jointsInfos(MemoryManager::getBaseAllocator());
+            for (uint i=0; i < NB_JOINTS; i++) {
+                const Vector3 anchorPoint(decimal(i) + decimal(0.5), 10, 0);
+                switch (i % 4) {
+                    case 0: jointsInfos.add(new BallAndSocketJointInfo(bodies[i], bodies[i + 1], anchorPoint)); break;
+                    case 1: jointsInfos.add(new HingeJointInfo(bodies[i], bodies[i + 1], anchorPoint, axis)); break;
+                    case 2: jointsInfos.add(new SliderJointInfo(bodies[i], bodies[i + 1], anchorPoint, Vector3(1, 0, 0))); break;
+                    default: jointsInfos.add(new FixedJointInfo(bodies[i], bodies[i + 1], anchorPoint)); break;
+                }
+                jointsInfos[i]->isCollisionEnabled = false;
+            }
+
+            Joint* joints[NB_JOINTS];
+            world.createJoints(&(jointsInfos[0]), NB_JOINTS, joints);
+            rp3d_test(world.getNbJoints() == NB_JOINTS);
+            for (uint i=0; i < NB_JOINTS; i++) {
+                rp3d_test(joints[i]->getType() == jointsInfos[i]->type);
+                rp3d_test(joints[i]->getBody1() == bodies[i]);
+                rp3d_test(joints[i]->getBody2() == bodies[i + 1]);
+                for (uint j=0; j < i; j++) {
+                    rp3d_test(joints[i]->getId() != joints[j]->getId());
+                }
+                delete jointsInfos[i];
+            }
+
+            // A joint created separately gets a different id
+            BallAndSocketJointInfo jointInfo(anchor, bodies[NB_JOINTS], Vector3(decimal(NB_JOINTS), 10, 0));
+            Joint* singleJoint = world.createJoint(jointInfo);
+            for (uint i=0; i < NB_JOINTS; i++) {
+                rp3d_test(singleJoint->getId() != joints[i]->getId());
+            }
+
+            for (uint i=0; i < 60; i++) {
+                world.update(decimal(1.0) / decimal(60.0));
+            }
+
+            // The joints (except the sliders) keep the spheres together
+            for (uint i=1; i < NB_JOINTS; i++) {
+                if (joints[i]->getType() == JointType::SLIDERJOINT) continue;
+                const decimal distance = (bodies[i + 1]->getTransform().getPosition() -
+                                          bodies[i]->getTransform().getPosition()).length();
+                rp3d_test(distance < decimal(1.2));
+            }
+
+            // Destroy some joints of the block one by one and the others together
+            world.destroyJoint(joints[3]);
+            world.destroyJoint(singleJoint);
+            rp3d_test(world.getNbJoints() == NB_JOINTS - 1);
+            Joint* remainingJoints[] = {joints[0], joints[5], joints[7]};
+            world.destroyJoints(remainingJoints, 3);
+            rp3d_test(world.getNbJoints() == NB_JOINTS - 4);
+            rp3d_test(bodies[1]->getJointsList()->joint == joints[1]);
+            rp3d_test(bodies[1]->getJointsList()->next == nullptr);
+
+            world.update(decimal(1.0) / decimal(60.0));
+
+            // The remaining joints are destroyed with the world
+        }
+
+        void testPositionBasedSolver() {
+
+            WorldSettings settings;
+            settings.isSleepingEnabled = false;
+            settings.isPositionBasedSolverEnabled = true;
+
+            // A stack of boxes stays still and standing with many substeps and a single iteration
+            DynamicsWorld stackWorld(Vector3(0, decimal(-9.81), 0), settings);
+            stackWorld.setNbIterationsPositionSolver(1);
+            RigidBody* floor = stackWorld.createRigidBody(Transform(Vector3(0, -1, 0), Quaternion::identity()));
+            floor->setType(BodyType::STATIC);
+            floor->addCollisionShape(mFloorShape, Transform::identity(), decimal(1.0));
+            List<RigidBody*> boxes(MemoryManager::getBaseAllocator());
+            for (uint i=0; i < 5; i++) {
+                RigidBody* body = stackWorld.createRigidBody(Transform(Vector3(0, decimal(0.5) + decimal(i), 0), Quaternion::identity()));
+                body->addCollisionShape(mBoxShape, Transform::identity(), decimal(1.0));
+                boxes.add(body);
+            }
+            for (uint i=0; i < 180; i++) {
+                stackWorld.update(decimal(1.0) / decimal(60.0), 20);
+            }
+            for (uint i=0; i < boxes.size(); i++) {
+                const Vector3 position = boxes[i]->getTransform().getPosition();
+                rp3d_test(std::abs(position.y - decimal(0.5) - decimal(i)) < decimal(0.05));
+                rp3d_test(Vector2(position.x, position.z).length() < decimal(0.05));
+                rp3d_test(boxes[i]->getLinearVelocity().length() < decimal(0.1));
+            }
+
+            // The joints of a hanging chain keep their anchor points together
+            DynamicsWorld chainWorld(Vector3(0, decimal(-9.81), 0), settings);
+            chainWorld.setNbIterationsPositionSolver(1);
+            List<RigidBody*> bodies(MemoryManager::getBaseAllocator());
+            RigidBody* anchor = chainWorld.createRigidBody(Transform(Vector3(0, 20, 0), Quaternion::identity()));
+            anchor->setType(BodyType::STATIC);
+            bodies.add(anchor);
+            for (uint i=1; i <= 20; i++) {
+                const Vector3 position(decimal(i), 20, 0);
+                RigidBody* body = chainWorld.createRigidBody(Transform(position, Quaternion::identity()));
+                body->addCollisionShape(mSphereShape, Transform::identity(), decimal(1.0));
+                BallAndSocketJointInfo jointInfo(bodies[i - 1], body, position - Vector3(decimal(0.5), 0, 0));
+                jointInfo.isCollisionEnabled = false;
+                chainWorld.createJoint(jointInfo);
+                bodies.add(body);
+            }
+            for (uint i=0; i < 120; i++) {
+                chainWorld.update(decimal(1.0) / decimal(60.0), 20);
+            }
+            for (uint i=1; i < bodies.size(); i++) {
+                const Vector3 anchorPointBody1 = bodies[i - 1]->getTransform() * Vector3(decimal(0.5), 0, 0);
+                const Vector3 anchorPointBody2 = bodies[i]->getTransform() * Vector3(decimal(-0.5), 0, 0);
+                rp3d_test((anchorPointBody2 - anchorPointBody1).length() < decimal(0.01));
+            }
+            rp3d_test(bodies[20]->getTransform().getPosition().y < decimal(20.0));
+        }
+
+        void testPositionSolverEarlyExit() {
+
+            WorldSettings settings;
+            WorldSettings earlyExitSettings;
+            earlyExitSettings.isPositionSolverEarlyExitEnabled = true;
+            WorldSettings skippedSettings;
+            skippedSettings.isPositionSolverEarlyExitEnabled = true;
+            skippedSettings.positionSolverErrorTolerance = decimal(1000.0);
+
+            // The early exit only skips the position iterations with a negligible error
+            const decimal error = simulateHangingChain(settings, false, 1);
+            const decimal earlyExitError = simulateHangingChain(earlyExitSettings, false, 1);
+            rp3d_test(earlyExitError < error + earlyExitSettings.positionSolverErrorTolerance);
+
+            // With a large tolerance, the position solver is never executed
+            const decimal skippedError = simulateHangingChain(skippedSettings, false, 1);
+            rp3d_test(skippedError > error);
+        }
+
+        /// Hang four boxes from a static body with the four types of joints, simulate the world
+        /// (changing the mass of a box once the boxes are at rest) and return the box positions
+        void simulateHangingBoxes(const WorldSettings& settings, List<Vector3>& positions) {
+
+            DynamicsWorld world(Vector3(0, decimal(-9.81), 0), settings);
+            RigidBody* anchor = world.createRigidBody(Transform(Vector3(0, 10, 0), Quaternion::identity()));
+            anchor->setType(BodyType::STATIC);
+
+            List<RigidBody*> boxes(MemoryManager::getBaseAllocator());
+            for (uint i=0; i < 4; i++) {
+
+                const Vector3 anchorPoint(decimal(2 * i), 10, 0);
+                RigidBody* body = world.createRigidBody(Transform(anchorPoint - Vector3(0, 1, 0), Quaternion::identity()));
+                body->addCollisionShape(mBoxShape, Transform::identity(), decimal(1.0));
+
+                switch (i) {
+                    case 0: world.createJoint(BallAndSocketJointInfo(anchor, body, anchorPoint)); break;
+                    case 1: world.createJoint(HingeJointInfo(anchor, body, anchorPoint, Vector3(0, 0, 1))); break;
+                    case 2: world.createJoint(SliderJointInfo(anchor, body, anchorPoint, Vector3(0, 1, 0),
+                                                              decimal(-0.5), decimal(0.5))); break;
+                    case 3: world.createJoint(FixedJointInfo(anchor, body, anchorPoint)); break;
+                }
+
+                boxes.add(body);
+            }
+
+            for (uint i=0; i < 120; i++) {
+                world.update(decimal(1.0) / decimal(60.0));
+            }
+            boxes[3]->setMass(decimal(4.0));
+            for (uint i=0; i < 60; i++) {
+                world.update(decimal(1.0) / decimal(60.0));
+            }
+
+            for (uint i=0; i < boxes.size(); i++) {
+                positions.add(boxes[i]->getTransform().getPosition());
+            }
+        }
+
+        void testJointSolverDataCache() {
+
+            WorldSettings settings;
+            settings.isSleepingEnabled = false;
+            settings.isPositionSolverEarlyExitEnabled = true;
+            WorldSettings cacheSettings = settings;
+            cacheSettings.isJointSolverDataCacheEnabled = true;
+
+            // The joints that reuse their solver data while their bodies are at rest give
+            // the same result as the joints that recompute it at each step
+            List<Vector3> positions(MemoryManager::getBaseAllocator());
+            List<Vector3> cachePositions(MemoryManager::getBaseAllocator());
+            simulateHangingBoxes(settings, positions);
+            simulateHangingBoxes(cacheSettings, cachePositions);
+            for (uint i=0; i < positions.size(); i++) {
+                rp3d_test((cachePositions[i] - positions[i]).length() < decimal(0.001));
+            }
+
+            // The slider joint keeps its box at its lower limit
+            rp3d_test(std::abs(cachePositions[2].y - decimal(8.5)) < decimal(0.01));
+        }
+
+        /// Hang a box by its center from a static body with a ball-and-socket joint of a given
+        /// frequency, simulate the world and return the height of the box
+        decimal simulateSoftJoint(const WorldSettings& settings, decimal frequency) {
+
+            DynamicsWorld world(Vector3(0, decimal(-9.81), 0), settings);
+            RigidBody* anchor = world.createRigidBody(Transform(Vector3(0, 10, 0), Quaternion::identity()));
+            anchor->setType(BodyType::STATIC);
+            RigidBody* box = world.createRigidBody(Transform(Vector3(0, 10, 0), Quaternion::identity()));
+            box->addCollisionShape(mBoxShape, Transform::identity(), decimal(1.0));
+
+            BallAndSocketJointInfo jointInfo(anchor, box, Vector3(0, 10, 0));
+            jointInfo.frequency = frequency;
+            jointInfo.dampingRatio = decimal(1.0);
+            world.createJoint(jointInfo);
+
+            for (uint i=0; i < 300; i++) {
+                world.update(decimal(1.0) / decimal(60.0));
+            }
+
+            return box->getTransform().getPosition().y;
+        }
+
+        void testSoftConstraints() {
+
+            WorldSettings settings;
+            settings.isSleepingEnabled = false;
+            WorldSettings batchingSettings = settings;
+            batchingSettings.isJointBatchingEnabled = true;
+
+            // A rigid joint keeps the box at its anchor point
+            rp3d_test(std::abs(simulateSoftJoint(settings, decimal(0.0)) - decimal(10.0)) < decimal(0.01));
+
+            // A soft joint behaves like a spring: the box settles at the static stretch g / (2 * pi * f)^2
+            const decimal omega = PI_TIMES_2 * decimal(1.0);
+            const decimal softHeight = simulateSoftJoint(settings, decimal(1.0));
+            rp3d_test(std::abs(softHeight - (decimal(10.0) - decimal(9.81) / (omega * omega))) < decimal(0.01));
+            rp3d_test(std::abs(simulateSoftJoint(batchingSettings, decimal(1.0)) - softHeight) < decimal(0.001));
+
+            // A stiff spring is stable at the frequency of the time step
+            rp3d_test(std::abs(simulateSoftJoint(settings, decimal(60.0)) - decimal(10.0)) < decimal(0.01));
+
+            // A box resting on the floor with soft contacts stays at rest
+            WorldSettings contactSettings = settings;
+            contactSettings.contactFrequency = decimal(30.0);
+            DynamicsWorld world(Vector3(0, decimal(-9.81), 0), contactSettings);
+            RigidBody* floor = world.createRigidBody(Transform(Vector3(0, -1, 0), Quaternion::identity()));
+            floor->setType(BodyType::STATIC);
+            floor->addCollisionShape(mFloorShape, Transform::identity(), decimal(1.0));
+            RigidBody* box = world.createRigidBody(Transform(Vector3(0, decimal(0.5), 0), Quaternion::identity()));
+            box->addCollisionShape(mBoxShape, Transform::identity(), decimal(1.0));
+            for (uint i=0; i < 300; i++) {
+                world.update(decimal(1.0) / decimal(60.0));
+            }
+            rp3d_test(std::abs(box->getTransform().getPosition().y - decimal(0.5)) < decimal(0.02));
+            rp3d_test(box->getLinearVelocity().length() < decimal(0.01));
+        }
+
+        void testWideBroadPhaseTree() {
+
+            WorldSettings settings;
+            settings.isDeterministic = true;
+            WorldSettings wideSettings = settings;
+            wideSettings.isWideBroadPhaseTreeEnabled = true;
+
+            DynamicsWorld world(Vector3(0, decimal(-9.81), 0), settings);
+            DynamicsWorld wideWorld(Vector3(0, decimal(-9.81), 0), wideSettings);
+
+            List<RigidBody*> bodies(MemoryManager::getBaseAllocator());
+            List<RigidBody*> wideBodies(MemoryManager::getBaseAllocator());
+            createPile(world, bodies);
+            createPile(wideWorld, wideBodies);
+
+            for (uint i=0; i < 60; i++) {
+                world.update(decimal(1.0) / decimal(60.0));
+                wideWorld.update(decimal(1.0) / decimal(60.0));
+            }
+
+            // The wide tree finds the same overlapping pairs as the dynamic AABB tree
+            rp3d_test(isSameState(bodies, wideBodies));
+
+            // The queries between two steps use a wide tree that includes the last modifications
+            const AABB aabb = bodies[0]->getAABB();
+            world.destroyRigidBody(bodies[0]);
+            wideWorld.destroyRigidBody(wideBodies[0]);
+            BodyOverlapCallback callback;
+            BodyOverlapCallback wideCallback;
+            world.testAABBOverlap(aabb, &callback);
+            wideWorld.testAABBOverlap(aabb, &wideCallback);
+            rp3d_test(!wideCallback.bodies.empty());
+            rp3d_test(callback.bodies.size() == wideCallback.bodies.size());
+            rp3d_test(!wideCallback.hasOverlap(wideBodies[0]));
+        }
+
+        void testSweepAndPruneBroadPhase() {
+
+            WorldSettings settings;
+            settings.isDeterministic = true;
+            WorldSettings sapSettings = settings;
+            sapSettings.broadPhaseType = BroadPhaseType::SWEEP_AND_PRUNE;
+
+            DynamicsWorld world(Vector3(0, decimal(-9.81), 0), settings);
+            DynamicsWorld sapWorld(Vector3(0, decimal(-9.81), 0), sapSettings);
+
+            List<RigidBody*> bodies(MemoryManager::getBaseAllocator());
+            List<RigidBody*> sapBodies(MemoryManager::getBaseAllocator());
+            createPile(world, bodies);
+            createPile(sapWorld, sapBodies);
+
+            for (uint i=0; i < 60; i++) {
+                world.update(decimal(1.0) / decimal(60.0));
+                sapWorld.update(decimal(1.0) / decimal(60.0));
+            }
+
+            // The sweep-and-prune finds the same overlapping pairs as the dynamic AABB tree
+            rp3d_test(isSameState(bodies, sapBodies));
+
+            // The queries see the bodies destroyed since the last step
+            const AABB aabb = bodies[0]->getAABB();
+            world.destroyRigidBody(bodies[0]);
+            sapWorld.destroyRigidBody(sapBodies[0]);
+            BodyOverlapCallback callback;
+            BodyOverlapCallback sapCallback;
+            world.testAABBOverlap(aabb, &callback);
+            sapWorld.testAABBOverlap(aabb, &sapCallback);
+            rp3d_test(!sapCallback.bodies.empty());
+            rp3d_test(callback.bodies.size() == sapCallback.bodies.size());
+            rp3d_test(!sapCallback.hasOverlap(sapBodies[0]));
+
+            // A ray through the pile hits the same bodies
+            const Ray ray(Vector3(-10, decimal(0.6), decimal(-2.9)), Vector3(10, decimal(0.6), decimal(-2.9)));
+            BodyRaycastCallback raycastCallback;
+            BodyRaycastCallback sapRaycastCallback;
+            world.raycast(ray, &raycastCallback);
+            sapWorld.raycast(ray, &sapRaycastCallback);
+            rp3d_test(!sapRaycastCallback.bodies.empty());
+            rp3d_test(raycastCallback.bodies.size() == sapRaycastCallback.bodies.size());
+        }
+
+        void testGridBroadPhase() {
+
+            WorldSettings settings;
+            settings.isDeterministic = true;
+            WorldSettings gridSettings = settings;
+            gridSettings.broadPhaseType = BroadPhaseType::GRID;
+
+            // Small cells so that the pile spans many cells and the bodies move between cells
+            gridSettings.broadPhaseGridCellSize = decimal(1.5);
+
+            DynamicsWorld world(Vector3(0, decimal(-9.81), 0), settings);
+            DynamicsWorld gridWorld(Vector3(0, decimal(-9.81), 0), gridSettings);
+
+            List<RigidBody*> bodies(MemoryManager::getBaseAllocator());
+            List<RigidBody*> gridBodies(MemoryManager::getBaseAllocator());
+            createPile(world, bodies);
+            createPile(gridWorld, gridBodies);
+
+            for (uint i=0; i < 60; i++) {
+                world.update(decimal(1.0) / decimal(60.0));
+                gridWorld.update(decimal(1.0) / decimal(60.0));
+            }
+
+            // The grid finds the same overlapping pairs as the dynamic AABB tree
+            rp3d_test(isSameState(bodies, gridBodies));
+
+            // The queries see the bodies destroyed since the last step
+            const AABB aabb = bodies[0]->getAABB();
+            world.destroyRigidBody(bodies[0]);
+            gridWorld.destroyRigidBody(gridBodies[0]);
+            BodyOverlapCallback callback;
+            BodyOverlapCallback gridCallback;
+            world.testAABBOverlap(aabb, &callback);
+            gridWorld.testAABBOverlap(aabb, &gridCallback);
+            rp3d_test(!gridCallback.bodies.empty());
+            rp3d_test(callback.bodies.size() == gridCallback.bodies.size());
+            rp3d_test(!gridCallback.hasOverlap(gridBodies[0]));
+
+            // A ray through the pile hits the same bodies
+            const Ray ray(Vector3(-10, decimal(0.6), decimal(-2.9)), Vector3(10, decimal(0.6), decimal(-2.9)));
+            BodyRaycastCallback raycastCallback;
+            BodyRaycastCallback gridRaycastCallback;
+            world.raycast(ray, &raycastCallback);
+            gridWorld.raycast(ray, &gridRaycastCallback);
+            rp3d_test(!gridRaycastCallback.bodies.empty());
+            rp3d_test(raycastCallback.bodies.size() == gridRaycastCallback.bodies.size());
+
+            // A body far away from the origin falls on its own floor
+            RigidBody* farFloor = gridWorld.createRigidBody(Transform(Vector3(20000, -1, -20000), Quaternion::identity()));
+            farFloor->setType(BodyType::STATIC);
+            farFloor->addCollisionShape(mBoxShape, Transform::identity(), decimal(1.0));
+            RigidBody* farBody = gridWorld.createRigidBody(Transform(Vector3(20000, decimal(0.5), -20000), Quaternion::identity()));
+            farBody->addCollisionShape(mBoxShape, Transform::identity(), decimal(1.0));
+            for (uint i=0; i < 60; i++) {
+                gridWorld.update(decimal(1.0) / decimal(60.0));
+            }
+            rp3d_test(farBody->getTransform().getPosition().y > decimal(-0.1));
+
+            // The far region can be unloaded
+            gridWorld.destroyRigidBody(farBody);
+            gridWorld.destroyRigidBody(farFloor);
+            gridWorld.update(decimal(1.0) / decimal(60.0));
+        }
+
+        void testStaticBroadPhaseTree() {
+
+            WorldSettings settings;
+            WorldSettings staticSettings;
+            staticSettings.isStaticBroadPhaseTreeEnabled = true;
+
+            DynamicsWorld world(Vector3(0, decimal(-9.81), 0), settings);
+            DynamicsWorld staticWorld(Vector3(0, decimal(-9.81), 0), staticSettings);
+
+            List<RigidBody*> bodies(MemoryManager::getBaseAllocator());
+            List<RigidBody*> staticBodies(MemoryManager::getBaseAllocator());
+
+            for (uint w=0; w < 2; w++) {
+
+                DynamicsWorld& currentWorld = w == 0 ? world : staticWorld;
+                List<RigidBody*>& currentBodies = w == 0 ? bodies : staticBodies;
+
+                RigidBody* floor = currentWorld.createRigidBody(Transform(Vector3(0, -1, 0), Quaternion::identity()));
+                floor->setType(BodyType::STATIC);
+                floor->addCollisionShape(mFloorShape, Transform::identity(), decimal(1.0));
+
+                // Add two walls of overlapping static boxes
+                for (int i=0; i < 40; i++) {
+                    const Vector3 position(decimal(i % 10) * decimal(0.9) - decimal(4.5), decimal(0.5) + decimal(i / 10 % 2),
+                                           i < 20 ? decimal(-4.5) : decimal(4.5));
+                    RigidBody* wall = currentWorld.createRigidBody(Transform(position, Quaternion::identity()));
+                    wall->setType(BodyType::STATIC);
+                    wall->addCollisionShape(mBoxShape, Transform::identity(), decimal(1.0));
+                }
+
+                // Add boxes falling on the floor between the walls
+                for (int i=0; i < 12; i++) {
+                    const Vector3 position(decimal(i % 4) * decimal(2.0) - decimal(3.0), decimal(1.0), decimal(i / 4) * decimal(2.0) - decimal(2.0));
+                    RigidBody* body = currentWorld.createRigidBody(Transform(position, Quaternion::identity()));
+                    body->addCollisionShape(mBoxShape, Transform::identity(), decimal(1.0));
+                    currentBodies.add(body);
+                }
+            }
+
+            for (uint i=0; i < 60; i++) {
+                world.update(decimal(1.0) / decimal(60.0));
+                staticWorld.update(decimal(1.0) / decimal(60.0));
+            }
+
+            // The boxes rest on the static floor in the two worlds
+            for (uint i=0; i < bodies.size(); i++) {
+                rp3d_test(approxEqual(staticBodies[i]->getTransform().getPosition().y, decimal(0.5), decimal(0.01)));
+                rp3d_test(approxEqual(bodies[i]->getTransform().getPosition().y,
+                                      staticBodies[i]->getTransform().getPosition().y, decimal(0.01)));
+            }
+
+            // A box that becomes static moves into the static tree and collides again with
+            // the floor when it becomes dynamic
+            staticBodies[0]->setType(BodyType::STATIC);
+            staticBodies[0]->setTransform(Transform(staticBodies[0]->getTransform().getPosition() + Vector3(0, 1, 0),
+                                                    Quaternion::identity()));
+            for (uint i=0; i < 10; i++) {
+                staticWorld.update(decimal(1.0) / decimal(60.0));
+            }
+            rp3d_test(approxEqual(staticBodies[0]->getTransform().getPosition().y, decimal(1.5), decimal(0.01)));
+            staticBodies[0]->setType(BodyType::DYNAMIC);
+            for (uint i=0; i < 120; i++) {
+                staticWorld.update(decimal(1.0) / decimal(60.0));
+            }
+            rp3d_test(approxEqual(staticBodies[0]->getTransform().getPosition().y, decimal(0.5), decimal(0.02)));
+
+            // The queries report the shapes of the two trees
+            const AABB aabb(Vector3(-6, -2, -6), Vector3(6, 2, 6));
+            BodyOverlapCallback callback;
+            BodyOverlapCallback staticCallback;
+            world.testAABBOverlap(aabb, &callback);
+            staticWorld.testAABBOverlap(aabb, &staticCallback);
+            rp3d_test(staticCallback.hasOverlap(staticBodies[0]));
+            rp3d_test(callback.bodies.size() == staticCallback.bodies.size());
+
+            const Ray ray(Vector3(-10, decimal(0.5), decimal(-4.5)), Vector3(10, decimal(0.5), decimal(-4.5)));
+            BodyRaycastCallback raycastCallback;
+            BodyRaycastCallback staticRaycastCallback;
+            world.raycast(ray, &raycastCallback);
+            staticWorld.raycast(ray, &staticRaycastCallback);
+            rp3d_test(!staticRaycastCallback.bodies.empty());
+            rp3d_test(raycastCallback.bodies.size() == staticRaycastCallback.bodies.size());
+        }
+
+        void testBroadPhaseTreeBulkBuild() {
+
+            DefaultTaskScheduler scheduler(4);
+
+            WorldSettings settings;
+            WorldSettings bulkSettings;
+            bulkSettings.isBroadPhaseTreeBulkBuildEnabled = true;
+            bulkSettings.broadPhaseTreeRebuildCostRatio = decimal(1.1);
+            bulkSettings.isStaticBroadPhaseTreeEnabled = true;
+            bulkSettings.isWideBroadPhaseTreeEnabled = true;
+            bulkSettings.taskScheduler = &scheduler;
+
+            DynamicsWorld world(Vector3(0, decimal(-9.81), 0), settings);
+            DynamicsWorld bulkWorld(Vector3(0, decimal(-9.81), 0), bulkSettings);
+
+            List<RigidBody*> bodies(MemoryManager::getBaseAllocator());
+            List<RigidBody*> bulkBodies(MemoryManager::getBaseAllocator());
+
+            for (uint w=0; w < 2; w++) {
+
+                DynamicsWorld& currentWorld = w == 0 ? world : bulkWorld;
+                List<RigidBody*>& currentBodies = w == 0 ? bodies : bulkBodies;
+
+                RigidBody* floor = currentWorld.createRigidBody(Transform(Vector3(0, -1, 0), Quaternion::identity()));
+                floor->setType(BodyType::STATIC);
+                floor->addCollisionShape(mFloorShape, Transform::identity(), decimal(1.0));
+
+                // Add a grid of falling boxes
+                for (int i=0; i < 64; i++) {
+                    const Vector3 position(decimal(i % 8) * decimal(1.5) - decimal(5.0), decimal(1.0) + decimal(0.25) * decimal(i % 3),
+                                           decimal(i / 8) * decimal(1.5) - decimal(5.0));
+                    RigidBody* body = currentWorld.createRigidBody(Transform(position, Quaternion::identity()));
+                    body->addCollisionShape(mBoxShape, Transform::identity(), decimal(1.0));
+                    currentBodies.add(body);
+                }
+            }
+
+            // The shapes that are not inserted into the trees yet are reported by the queries
+            const AABB aabb(Vector3(-3, 0, -3), Vector3(3, 2, 3));
+            BodyOverlapCallback callback;
+            BodyOverlapCallback bulkCallback;
+            world.testAABBOverlap(aabb, &callback);
+            bulkWorld.testAABBOverlap(aabb, &bulkCallback);
+            rp3d_test(!bulkCallback.bodies.empty());
+            rp3d_test(callback.bodies.size() == bulkCallback.bodies.size());
+
+            for (uint i=0; i < 120; i++) {
+                world.update(decimal(1.0) / decimal(60.0));
+                bulkWorld.update(decimal(1.0) / decimal(60.0));
+            }
+
+            // The boxes rest on the floor in the two worlds
+            for (uint i=0; i < bodies.size(); i++) {
+                rp3d_test(approxEqual(bulkBodies[i]->getTransform().getPosition().y, decimal(0.5), decimal(0.02)));
+                rp3d_test(approxEqual(bodies[i]->getTransform().getPosition().y,
+                                      bulkBodies[i]->getTransform().getPosition().y, decimal(0.02)));
+            }
+
+            const Ray ray(Vector3(-10, decimal(0.5), decimal(-0.5)), Vector3(10, decimal(0.5), decimal(-0.5)));
+            BodyRaycastCallback raycastCallback;
+            BodyRaycastCallback bulkRaycastCallback;
+            world.raycast(ray, &raycastCallback);
+            bulkWorld.raycast(ray, &bulkRaycastCallback);
+            rp3d_test(!bulkRaycastCallback.bodies.empty());
+            rp3d_test(raycastCallback.bodies.size() == bulkRaycastCallback.bodies.size());
+        }
+
+        void testBroadPhaseMaintenanceTimeBudget() {
+
+            WorldSettings settings;
+            settings.isStaticBroadPhaseTreeEnabled = true;
+            settings.broadPhaseTreeRebuildCostRatio = decimal(1.1);
+            settings.broadPhaseMaintenanceTimeBudget = decimal(0.0002);
+            DynamicsWorld world(Vector3(0, decimal(-9.81), 0), settings);
+
+            // A floor made of several static bodies and a grid of falling boxes
+            for (int i=0; i < 4; i++) {
+                RigidBody* floor = world.createRigidBody(Transform(Vector3(decimal(40 * i), -1, 0), Quaternion::identity()));
+                floor->setType(BodyType::STATIC);
+                floor->addCollisionShape(mFloorShape, Transform::identity(), decimal(1.0));
+            }
+            List<RigidBody*> bodies(MemoryManager::getBaseAllocator());
+            for (int i=0; i < 64; i++) {
+                const Vector3 position(decimal(i % 8) * decimal(1.5) - decimal(5.0), decimal(1.0) + decimal(0.25) * decimal(i % 3),
+                                       decimal(i / 8) * decimal(1.5) - decimal(5.0));
+                RigidBody* body = world.createRigidBody(Transform(position, Quaternion::identity()));
+                body->addCollisionShape(mBoxShape, Transform::identity(), decimal(1.0));
+                bodies.add(body);
+            }
+
+            // The static tree is refined incrementally instead of being built again
+            world.update(decimal(1.0) / decimal(60.0));
+            rp3d_test(world.getStepStatistics().broadPhase.nbRefinedShapes > 0);
+
+            for (uint i=0; i < 120; i++) {
+                world.update(decimal(1.0) / decimal(60.0));
+            }
+
+            // The boxes rest on the floor
+            for (uint i=0; i < bodies.size(); i++) {
+                rp3d_test(approxEqual(bodies[i]->getTransform().getPosition().y, decimal(0.5), decimal(0.02)));
+            }
+        }
+
+        void testAdaptiveBroadPhaseAABBGap() {
+
+            const BroadPhaseType types[3] = {BroadPhaseType::DYNAMIC_AABB_TREE, BroadPhaseType::SWEEP_AND_PRUNE,
+                                             BroadPhaseType::GRID};
+
+            for (uint t=0; t < 3; t++) {
+
+                // The bodies do not sleep so that the shapes at rest keep being updated
+                WorldSettings settings;
+                settings.isSleepingEnabled = false;
+                settings.broadPhaseType = types[t];
+                settings.broadPhaseGridCellSize = decimal(4.0);
+                WorldSettings adaptiveSettings = settings;
+                adaptiveSettings.isAdaptiveBroadPhaseAABBGapEnabled = true;
+                adaptiveSettings.nbUpdatesBeforeBroadPhaseAABBGapShrink = 30;
+
+                DynamicsWorld world(Vector3(0, decimal(-9.81), 0), settings);
+                DynamicsWorld adaptiveWorld(Vector3(0, decimal(-9.81), 0), adaptiveSettings);
+
+                List<RigidBody*> bodies(MemoryManager::getBaseAllocator());
+                List<RigidBody*> adaptiveBodies(MemoryManager::getBaseAllocator());
+
+                for (uint w=0; w < 2; w++) {
+
+                    DynamicsWorld& currentWorld = w == 0 ? world : adaptiveWorld;
+                    List<RigidBody*>& currentBodies = w == 0 ? bodies : adaptiveBodies;
+
+                    RigidBody* floor = currentWorld.createRigidBody(Transform(Vector3(0, -1, 0), Quaternion::identity()));
+                    floor->setType(BodyType::STATIC);
+                    floor->addCollisionShape(mFloorShape, Transform::identity(), decimal(1.0));
+
+                    // Add a grid of boxes falling from different heights
+                    for (int i=0; i < 64; i++) {
+                        const Vector3 position(decimal(i % 8) * decimal(1.5) - decimal(5.0), decimal(1.0) + decimal(i % 4),
+                                               decimal(i / 8) * decimal(1.5) - decimal(5.0));
+                        RigidBody* body = currentWorld.createRigidBody(Transform(position, Quaternion::identity()));
+                        body->addCollisionShape(mBoxShape, Transform::identity(), decimal(1.0));
+                        currentBodies.add(body);
+                    }
+                }
+
+                uint nbReinsertedShapes = 0;
+                uint nbAdaptiveReinsertedShapes = 0;
+                uint nbAdaptiveShrunkShapes = 0;
+                for (uint i=0; i < 240; i++) {
+                    world.update(decimal(1.0) / decimal(60.0));
+                    adaptiveWorld.update(decimal(1.0) / decimal(60.0));
+
+                    const BroadPhaseStatistics& statistics = world.getBroadPhaseStatistics();
+                    const BroadPhaseStatistics& adaptiveStatistics = adaptiveWorld.getBroadPhaseStatistics();
+                    rp3d_test(statistics.nbShrunkShapes == 0);
+                    if (i > 0) {
+                        rp3d_test(adaptiveStatistics.nbMovedShapes == adaptiveStatistics.nbReinsertedShapes +
+                                                                      adaptiveStatistics.nbShrunkShapes);
+                    }
+                    nbReinsertedShapes += statistics.nbReinsertedShapes;
+                    nbAdaptiveReinsertedShapes += adaptiveStatistics.nbReinsertedShapes;
+                    nbAdaptiveShrunkShapes += adaptiveStatistics.nbShrunkShapes;
+                }
+
+                // The gaps of the falling shapes have grown and the gaps of the shapes at rest
+                // have shrunk
+                rp3d_test(nbAdaptiveReinsertedShapes < nbReinsertedShapes);
+                rp3d_test(nbAdaptiveShrunkShapes > 0);
+
+                // The boxes rest on the floor
+                for (uint i=0; i < adaptiveBodies.size(); i++) {
+                    rp3d_test(approxEqual(adaptiveBodies[i]->getTransform().getPosition().y, decimal(0.5), decimal(0.02)));
+                }
+            }
+        }
+
+        void testSATPreviousAxisStatistics() {
+
+            WorldSettings settings;
+            settings.isSleepingEnabled = false;
+            DynamicsWorld world(Vector3(0, decimal(-9.81), 0), settings);
+
+            CapsuleShape capsuleShape(decimal(0.3), decimal(1.0));
+
+            RigidBody* floor = world.createRigidBody(Transform(Vector3(0, -1, 0), Quaternion::identity()));
+            floor->setType(BodyType::STATIC);
+            floor->addCollisionShape(mFloorShape, Transform::identity(), decimal(1.0));
+
+            // Add boxes and capsules lying on the floor
+            List<RigidBody*> boxes(MemoryManager::getBaseAllocator());
+            for (int i=0; i < 8; i++) {
+                const Vector3 boxPosition(decimal(i) * decimal(2.0) - decimal(8.0), decimal(0.5), decimal(-2.0));
+                RigidBody* box = world.createRigidBody(Transform(boxPosition, Quaternion::identity()));
+                box->addCollisionShape(mBoxShape, Transform::identity(), decimal(1.0));
+                boxes.add(box);
+
+                const Vector3 capsulePosition(decimal(i) * decimal(2.0) - decimal(8.0), decimal(0.3), decimal(2.0));
+                const Quaternion lyingOrientation = Quaternion::fromEulerAngles(0, 0, PI * decimal(0.5));
+                RigidBody* capsule = world.createRigidBody(Transform(capsulePosition, lyingOrientation));
+                capsule->addCollisionShape(&capsuleShape, Transform::identity(), decimal(1.0));
+            }
+
+            uint nbSATTests = 0;
+            uint nbSATPreviousAxisHits = 0;
+            for (uint i=0; i < 120; i++) {
+                world.update(decimal(1.0) / decimal(60.0));
+
+                const NarrowPhaseStatistics& statistics = world.getNarrowPhaseStatistics();
+                rp3d_test(statistics.nbSATPreviousAxisHits <= statistics.nbSATTests);
+
+                // Skip the first frames where the contacts are created
+                if (i >= 10) {
+                    nbSATTests += statistics.nbSATTests;
+                    nbSATPreviousAxisHits += statistics.nbSATPreviousAxisHits;
+                }
+            }
+
+            // The resting contacts are resolved with the axis of the previous frame most of the time
+            rp3d_test(nbSATTests > 0);
+            rp3d_test(nbSATPreviousAxisHits * 2 > nbSATTests);
+
+            // The boxes still rest on the floor
+            for (uint i=0; i < boxes.size(); i++) {
+                rp3d_test(approxEqual(boxes[i]->getTransform().getPosition().y, decimal(0.5), decimal(0.02)));
+            }
+        }
+        void testContactReuse() {
+
+            WorldSettings settings;
+            settings.isSleepingEnabled = false;
+            settings.isContactReuseEnabled = true;
+            DynamicsWorld world(Vector3(0, decimal(-9.81), 0), settings);
+
+            RigidBody* floor = world.createRigidBody(Transform(Vector3(0, -1, 0), Quaternion::identity()));
+            floor->setType(BodyType::STATIC);
+            floor->addCollisionShape(mFloorShape, Transform::identity(), decimal(1.0));
+
+            // Add boxes resting on the floor
+            List<RigidBody*> boxes(MemoryManager::getBaseAllocator());
+            for (int i=0; i < 8; i++) {
+                const Vector3 boxPosition(decimal(i) * decimal(2.0) - decimal(8.0), decimal(0.5), decimal(0.0));
+                RigidBody* box = world.createRigidBody(Transform(boxPosition, Quaternion::identity()));
+                box->addCollisionShape(mBoxShape, Transform::identity(), decimal(1.0));
+                boxes.add(box);
+            }
+
+            // Box falling on the floor
+            RigidBody* fallingBox = world.createRigidBody(Transform(Vector3(10, 3, 0), Quaternion::identity()));
+            fallingBox->addCollisionShape(mBoxShape, Transform::identity(), decimal(1.0));
+
+            uint nbReusedContactPairs = 0;
+            for (uint i=0; i < 120; i++) {
+                world.update(decimal(1.0) / decimal(60.0));
+
+                const NarrowPhaseStatistics& statistics = world.getNarrowPhaseStatistics();
+                nbReusedContactPairs += statistics.nbReusedContactPairs;
+
+                // The pairs reuse their contacts at most nbMaxFramesContactReuse frames in a row
+                rp3d_test(statistics.nbReusedContactPairs <= boxes.size() + 1);
+            }
+
+            // Most of the resting contacts have been reused
+            rp3d_test(nbReusedContactPairs > 120 * boxes.size() / 2);
+
+            // The boxes still rest on the floor
+            for (uint i=0; i < boxes.size(); i++) {
+                rp3d_test(approxEqual(boxes[i]->getTransform().getPosition().y, decimal(0.5), decimal(0.02)));
+            }
+
+            // The falling box has been stopped by the floor
+            rp3d_test(approxEqual(fallingBox->getTransform().getPosition().y, decimal(0.5), decimal(0.1)));
+        }
+
+        void testBodyAndJointIds() {
+
+            DynamicsWorld world(Vector3(0, 0, 0));
+
+            List<RigidBody*> bodies(MemoryManager::getBaseAllocator());
+            for (uint i=0; i < 10; i++) {
+                RigidBody* body = world.createRigidBody(Transform(Vector3(decimal(i) * decimal(3.0), 0, 0), Quaternion::identity()));
+                body->addCollisionShape(mSphereShape, Transform::identity(), decimal(1.0));
+                bodies.add(body);
+            }
+
+            BallAndSocketJointInfo jointInfo(bodies[0], bodies[1], Vector3(decimal(1.5), 0, 0));
+            Joint* joint = world.createJoint(jointInfo);
+            const jointindex jointId = joint->getId();
+
+            // The id of a destroyed body is not given again to a new body (even if its slot is reused)
+            const bodyindex destroyedBodyId = bodies[4]->getId();
+            world.destroyRigidBody(bodies[4]);
+            bodies.removeAt(4);
+            RigidBody* newBody = world.createRigidBody(Transform(Vector3(0, 5, 0), Quaternion::identity()));
+            newBody->addCollisionShape(mSphereShape, Transform::identity(), decimal(1.0));
+            rp3d_test(newBody->getId() != destroyedBodyId);
+            rp3d_test(IdAllocator::getSlotIndex(newBody->getId()) == IdAllocator::getSlotIndex(destroyedBodyId));
+            bodies.add(newBody);
+
+            world.destroyJoint(joint);
+            Joint* newJoint = world.createJoint(jointInfo);
+            rp3d_test(newJoint->getId() != jointId);
+            rp3d_test(IdAllocator::getSlotIndex(newJoint->getId()) == IdAllocator::getSlotIndex(jointId));
+
+            // Destroy bodies in the middle, at the beginning and at the end of the lists of the world
+            world.destroyRigidBody(bodies[5]);
+            world.destroyRigidBody(bodies[0]);
+            world.destroyRigidBody(bodies[9]);
+            rp3d_test(world.getNbRigidBodies() == 7);
+            rp3d_test(world.getNbJoints() == 0);
+
+            // The remaining bodies are still simulated
+            bodies[3]->setLinearVelocity(Vector3(0, 1, 0));
+            world.update(decimal(1.0) / decimal(60.0));
+            rp3d_test(bodies[3]->getTransform().getPosition().y > decimal(0.0));
+
+            // The remaining bodies are destroyed with the world
+        }
+
+        void testBodyContactManifolds() {
+
+            DynamicsWorld world(Vector3(0, decimal(-9.81), 0));
+
+            RigidBody* floor = world.createRigidBody(Transform(Vector3(0, -1, 0), Quaternion::identity()));
+            floor->setType(BodyType::STATIC);
+            floor->addCollisionShape(mFloorShape, Transform::identity(), decimal(1.0));
+
+            // Three bodies resting on the floor and one body falling from high above
+            const Vector3 positions[4] = {Vector3(-5, decimal(0.5), 0), Vector3(0, decimal(0.5), 0),
+                                          Vector3(5, decimal(0.5), 0), Vector3(0, 20, 10)};
+            RigidBody* bodies[4];
+            for (uint i=0; i < 4; i++) {
+                bodies[i] = world.createRigidBody(Transform(positions[i], Quaternion::identity()));
+                bodies[i]->addCollisionShape(mBoxShape, Transform::identity(), decimal(1.0));
+            }
+
+            for (uint i=0; i < 5; i++) {
+                world.update(decimal(1.0) / decimal(60.0));
+            }
+
+            // The floor has the contact manifold of each resting body
+            rp3d_test(floor->getNbContactManifolds() == 3);
+            bool areManifoldsOfFloor = true;
+            for (uint i=0; i < floor->getNbContactManifolds(); i++) {
+                const ContactManifold* manifold = floor->getContactManifold(i);
+                areManifoldsOfFloor &= manifold->getBody1() == floor || manifold->getBody2() == floor;
+            }
+            rp3d_test(areManifoldsOfFloor);
+
+            // Each resting body shares its single contact manifold with the floor
+            for (uint i=0; i < 3; i++) {
+                rp3d_test(bodies[i]->getNbContactManifolds() == 1);
+                const ContactManifold* manifold = bodies[i]->getContactManifold(0);
+                rp3d_test(manifold->getBody1() == bodies[i] || manifold->getBody2() == bodies[i]);
+                rp3d_test(manifold->getBody1() == floor || manifold->getBody2() == floor);
+            }
+            rp3d_test(bodies[3]->getNbContactManifolds() == 0);
+
+            // The contacts of a body are removed when it becomes static
+            bodies[0]->setType(BodyType::STATIC);
+            rp3d_test(bodies[0]->getNbContactManifolds() == 0);
+        }
+
+        void testContactBudgets() {
+
+            // The world keeps at most two contact points per manifold
+            WorldSettings settings;
+            settings.nbMaxContactPointsInManifold = 2;
+            DynamicsWorld world(Vector3(0, decimal(-9.81), 0), settings);
+
+            RigidBody* floor = world.createRigidBody(Transform(Vector3(0, -1, 0), Quaternion::identity()));
+            floor->setType(BodyType::STATIC);
+            floor->addCollisionShape(mFloorShape, Transform::identity(), decimal(1.0));
+
+            RigidBody* bodies[2];
+            ProxyShape* proxyShapes[2];
+            for (uint i=0; i < 2; i++) {
+                bodies[i] = world.createRigidBody(Transform(Vector3(decimal(i) * decimal(5.0), decimal(0.5), 0),
+                                                            Quaternion::identity()));
+                proxyShapes[i] = bodies[i]->addCollisionShape(mBoxShape, Transform::identity(), decimal(1.0));
+            }
+
+            // The budget of a proxy shape lowers the budget of the world
+            rp3d_test(proxyShapes[1]->getNbMaxContactPointsInManifold() == 0);
+            proxyShapes[1]->setNbMaxContactPointsInManifold(1);
+            rp3d_test(proxyShapes[1]->getNbMaxContactPointsInManifold() == 1);
+
+            for (uint i=0; i < 5; i++) {
+                world.update(decimal(1.0) / decimal(60.0));
+            }
+
+            rp3d_test(bodies[0]->getNbContactManifolds() == 1);
+            rp3d_test(bodies[0]->getContactManifold(0)->getNbContactPoints() == 2);
+            rp3d_test(bodies[1]->getNbContactManifolds() == 1);
+            rp3d_test(bodies[1]->getContactManifold(0)->getNbContactPoints() == 1);
+
+            // A larger budget of a proxy shape does not raise the budget of the world
+            proxyShapes[1]->setNbMaxContactPointsInManifold(4);
+            world.update(decimal(1.0) / decimal(60.0));
+            rp3d_test(bodies[1]->getContactManifold(0)->getNbContactPoints() == 2);
+
+            // Without budget, a box resting on the floor has four contact points
+            DynamicsWorld defaultWorld(Vector3(0, decimal(-9.81), 0));
+            RigidBody* defaultFloor = defaultWorld.createRigidBody(Transform(Vector3(0, -1, 0), Quaternion::identity()));
+            defaultFloor->setType(BodyType::STATIC);
+            defaultFloor->addCollisionShape(mFloorShape, Transform::identity(), decimal(1.0));
+            RigidBody* defaultBody = defaultWorld.createRigidBody(Transform(Vector3(0, decimal(0.5), 0),
+                                                                            Quaternion::identity()));
+            ProxyShape* defaultProxyShape = defaultBody->addCollisionShape(mBoxShape, Transform::identity(), decimal(1.0));
+
+            for (uint i=0; i < 5; i++) {
+                defaultWorld.update(decimal(1.0) / decimal(60.0));
+            }
+            rp3d_test(defaultBody->getContactManifold(0)->getNbContactPoints() == 4);
+
+            // The budget of the manifolds of the proxy shape is applied at the next update
+            defaultProxyShape->setNbMaxContactManifolds(1);
+            defaultProxyShape->setNbMaxContactPointsInManifold(3);
+            defaultWorld.update(decimal(1.0) / decimal(60.0));
+            rp3d_test(defaultBody->getNbContactManifolds() == 1);
+            rp3d_test(defaultBody->getContactManifold(0)->getNbContactPoints() == 3);
+        }
+
+        void testStepStatistics() {
+
+            DynamicsWorld world(Vector3(0, decimal(-9.81), 0));
+
+            RigidBody* floor = world.createRigidBody(Transform(Vector3(0, -1, 0), Quaternion::identity()));
+            floor->setType(BodyType::STATIC);
+            floor->addCollisionShape(mFloorShape, Transform::identity(), decimal(1.0));
+
+            // Three separated bodies resting on the floor and one body falling from high above
+            const Vector3 positions[4] = {Vector3(-5, decimal(0.5), 0), Vector3(0, decimal(0.5), 0),
+                                          Vector3(5, decimal(0.5), 0), Vector3(0, 20, 10)};
+            for (uint i=0; i < 4; i++) {
+                RigidBody* body = world.createRigidBody(Transform(positions[i], Quaternion::identity()));
+                body->addCollisionShape(i == 0 ? static_cast<CollisionShape*>(mSphereShape) :
+                                        i == 1 ? static_cast<CollisionShape*>(mCapsuleShape) : mBoxShape,
+                                        Transform::identity(), decimal(1.0));
+            }
+
+            for (uint i=0; i < 5; i++) {
+                world.update(decimal(1.0) / decimal(60.0));
+            }
+
+            const StepStatistics& statistics = world.getStepStatistics();
+            rp3d_test(statistics.nbAwakeBodies == 4);
+            rp3d_test(statistics.nbIslands == 4);
+
+            // The falling body does not overlap anything
+            rp3d_test(statistics.nbOverlappingPairs == 3);
+            rp3d_test(statistics.nbContactManifolds == 3);
+            rp3d_test(statistics.nbContactPoints >= 3);
+
+            // Each body on the floor is tested by its own narrow-phase algorithm (unless its
+            // contacts have been reused from the previous step)
+            const NarrowPhaseStatistics& narrowPhase = statistics.narrowPhase;
+            rp3d_test(narrowPhase.nbTests + narrowPhase.nbReusedContactPairs == 3);
+            rp3d_test(narrowPhase.nbTests == narrowPhase.nbSphereVsSphereTests + narrowPhase.nbSphereVsCapsuleTests +
+                                             narrowPhase.nbCapsuleVsCapsuleTests + narrowPhase.nbSphereVsConvexPolyhedronTests +
+                                             narrowPhase.nbCapsuleVsConvexPolyhedronTests +
+                                             narrowPhase.nbConvexPolyhedronVsConvexPolyhedronTests);
+            rp3d_test(narrowPhase.nbSphereVsSphereTests == 0 && narrowPhase.nbCapsuleVsCapsuleTests == 0);
+
+            rp3d_test(statistics.nbVelocitySolverIterations == world.getTotalNbVelocitySolverIterations());
+            rp3d_test(statistics.nbVelocitySolverIterations > 0);
+
+            rp3d_test(statistics.collisionDetectionTime >= 0.0 && statistics.islandsTime >= 0.0 &&
+                      statistics.solverTime >= 0.0);
+            rp3d_test(statistics.totalTime > 0.0);
+            rp3d_test(statistics.collisionDetectionTime + statistics.islandsTime + statistics.solverTime <=
+                      statistics.totalTime);
+            rp3d_test(statistics.broadPhaseTime >= 0.0 && statistics.narrowPhaseTime >= 0.0);
+            rp3d_test(statistics.broadPhaseTime + statistics.narrowPhaseTime <= statistics.collisionDetectionTime);
+        }
+
+        void testWorldOrigin() {
+
+            WorldSettings settings;
+            settings.isSleepingEnabled = false;
+            DynamicsWorld world(Vector3(0, decimal(-9.81), 0), settings);
+
+            // The origin of the world is far from the absolute origin
+            const WorldPosition origin(10000000.0, 0.0, -3000000.0);
+            world.setOrigin(origin);
+            rp3d_test(world.getOrigin() == origin);
+
+            RigidBody* floor = world.createRigidBody(Transform(Vector3(0, -1, 0), Quaternion::identity()));
+            floor->setType(BodyType::STATIC);
+            floor->addCollisionShape(mFloorShape, Transform::identity(), decimal(1.0));
+            RigidBody* box = world.createRigidBody(Transform(Vector3(0, decimal(0.5), 0), Quaternion::identity()));
+            ProxyShape* boxProxyShape = box->addCollisionShape(mBoxShape, Transform::identity(), decimal(1.0));
+            RigidBody* sphere = world.createRigidBody(Transform(Vector3(5, 10, 0), Quaternion::identity()));
+            sphere->addCollisionShape(mSphereShape, Transform::identity(), decimal(1.0));
+            sphere->setAngularVelocity(Vector3(0, 2, 0));
+
+            for (uint i=0; i < 30; i++) {
+                world.update(decimal(1.0) / decimal(60.0));
+            }
+
+            // The absolute position of a body is the origin plus its world-space position
+            const WorldPosition boxPosition = world.getAbsolutePosition(box->getTransform().getPosition());
+            rp3d_test(boxPosition.x == origin.x + double(box->getTransform().getPosition().x));
+            rp3d_test(approxEqual(world.getWorldPoint(boxPosition), box->getTransform().getPosition()));
+            const WorldPosition spherePosition = world.getAbsolutePosition(sphere->getTransform().getPosition());
+            const Vector3 sphereLinearVelocity = sphere->getLinearVelocity();
+            const Vector3 sphereAngularVelocity = sphere->getAngularVelocity();
+            const AABB boxAABB = world.getWorldAABB(boxProxyShape);
+
+            // Move the origin: the bodies keep their absolute positions and their velocities
+            const Vector3 shift(10, 0, 5);
+            world.shiftOrigin(shift);
+            rp3d_test(world.getOrigin() == WorldPosition(origin.x + 10.0, 0.0, origin.z + 5.0));
+            rp3d_test(approxEqual(world.getWorldPoint(boxPosition), box->getTransform().getPosition(), decimal(0.0001)));
+            rp3d_test(approxEqual(world.getWorldPoint(spherePosition), sphere->getTransform().getPosition(),
+                                  decimal(0.0001)));
+            rp3d_test(sphere->getLinearVelocity() == sphereLinearVelocity);
+            rp3d_test(sphere->getAngularVelocity() == sphereAngularVelocity);
+            rp3d_test(approxEqual(world.getWorldAABB(boxProxyShape).getMin(), boxAABB.getMin() - shift, decimal(0.01)));
+            rp3d_test(approxEqual(world.getWorldAABB(boxProxyShape).getMax(), boxAABB.getMax() - shift, decimal(0.01)));
+
+            for (uint i=0; i < 90; i++) {
+                world.update(decimal(1.0) / decimal(60.0));
+            }
+
+            // The box still rests on the floor and the sphere has bounced on the floor
+            rp3d_test(approxEqual(box->getTransform().getPosition().y, decimal(0.5), decimal(0.02)));
+            rp3d_test(approxEqual(box->getTransform().getPosition().x, decimal(-10.0), decimal(0.02)));
+            rp3d_test(sphere->getTransform().getPosition().y > decimal(0.45));
+            rp3d_test(std::abs(world.getAbsolutePosition(sphere->getTransform().getPosition()).x - (origin.x + 5.0)) < 0.05);
+        }
+
+        void testShiftOriginBroadPhase() {
+
+            const Vector3 shift(decimal(1000.25), decimal(-0.5), decimal(-2500.75));
+
+            for (uint type=0; type < 4; type++) {
+
+                WorldSettings settings;
+                settings.isDeterministic = true;
+                settings.isSleepingEnabled = false;
+                if (type == 1) {
+                    settings.isWideBroadPhaseTreeEnabled = true;
+                    settings.isStaticBroadPhaseTreeEnabled = true;
+                }
+                else if (type == 2) {
+                    settings.broadPhaseType = BroadPhaseType::SWEEP_AND_PRUNE;
+                }
+                else if (type == 3) {
+                    settings.broadPhaseType = BroadPhaseType::GRID;
+                    settings.broadPhaseGridCellSize = decimal(1.5);
+                }
+
+                DynamicsWorld world(Vector3(0, decimal(-9.81), 0), settings);
+                DynamicsWorld shiftedWorld(Vector3(0, decimal(-9.81), 0), settings);
+                List<RigidBody*> bodies(MemoryManager::getBaseAllocator());
+                List<RigidBody*> shiftedBodies(MemoryManager::getBaseAllocator());
+                createPile(world, bodies);
+                createPile(shiftedWorld, shiftedBodies);
+
+                for (uint i=0; i < 60; i++) {
+                    world.update(decimal(1.0) / decimal(60.0));
+                    shiftedWorld.update(decimal(1.0) / decimal(60.0));
+                }
+
+                shiftedWorld.shiftOrigin(shift);
+
+                // The fat AABBs have been moved with the bodies
+                for (uint i=0; i < bodies.size(); i++) {
+                    const ProxyShape* proxyShape = bodies[i]->getProxyShapesList();
+                    const ProxyShape* shiftedProxyShape = shiftedBodies[i]->getProxyShapesList();
+                    rp3d_test(approxEqual(shiftedWorld.getWorldAABB(shiftedProxyShape).getMin() + shift,
+                                          world.getWorldAABB(proxyShape).getMin(), decimal(0.001)));
+                    rp3d_test(approxEqual(shiftedWorld.getWorldAABB(shiftedProxyShape).getMax() + shift,
+                                          world.getWorldAABB(proxyShape).getMax(), decimal(0.001)));
+                }
+
+                // The queries in the new world-space coordinates find the same bodies
+                const AABB aabb(Vector3(-2, 0, -2), Vector3(2, 3, 2));
+                const AABB shiftedAABB(aabb.getMin() - shift, aabb.getMax() - shift);
+                BodyOverlapCallback callback;
+                BodyOverlapCallback shiftedCallback;
+                world.testAABBOverlap(aabb, &callback);
+                shiftedWorld.testAABBOverlap(shiftedAABB, &shiftedCallback);
+                rp3d_test(!callback.bodies.empty());
+                rp3d_test(callback.bodies.size() == shiftedCallback.bodies.size());
+
+                const Ray ray(Vector3(-10, decimal(0.6), decimal(-2.9)), Vector3(10, decimal(0.6), decimal(-2.9)));
+                const Ray shiftedRay(ray.point1 - shift, ray.point2 - shift);
+                BodyRaycastCallback raycastCallback;
+                BodyRaycastCallback shiftedRaycastCallback;
+                world.raycast(ray, &raycastCallback);
+                shiftedWorld.raycast(shiftedRay, &shiftedRaycastCallback);
+                rp3d_test(!raycastCallback.bodies.empty());
+                rp3d_test(raycastCallback.bodies.size() == shiftedRaycastCallback.bodies.size());
+
+                // The shapes are not reinserted into the broad-phase because of the shift and
+                // the overlapping pairs are kept
+                world.update(decimal(1.0) / decimal(60.0));
+                shiftedWorld.update(decimal(1.0) / decimal(60.0));
+                const BroadPhaseStatistics& statistics = world.getBroadPhaseStatistics();
+                const BroadPhaseStatistics& shiftedStatistics = shiftedWorld.getBroadPhaseStatistics();
+                rp3d_test(shiftedStatistics.nbReinsertedShapes <= statistics.nbReinsertedShapes + bodies.size() / 10);
+                rp3d_test(shiftedStatistics.nbMovedShapes <= statistics.nbMovedShapes + bodies.size() / 10);
+                rp3d_test(shiftedWorld.getStepStatistics().nbOverlappingPairs + bodies.size() / 10 >=
+                          world.getStepStatistics().nbOverlappingPairs);
+
+                for (uint i=0; i < bodies.size(); i++) {
+                    rp3d_test(approxEqual(shiftedBodies[i]->getTransform().getPosition() + shift,
+                                          bodies[i]->getTransform().getPosition(), decimal(0.01)));
+                }
+            }
+        }
+
+        void testApproximateOrientationNormalization() {
+
+            WorldSettings exactSettings;
+            exactSettings.isSleepingEnabled = false;
+            WorldSettings approximateSettings = exactSettings;
+            approximateSettings.isApproximateOrientationNormalizationEnabled = true;
+            approximateSettings.nbStepsBetweenExactOrientationNormalizations = 16;
+
+            DynamicsWorld exactWorld(Vector3::zero(), exactSettings);
+            DynamicsWorld approximateWorld(Vector3::zero(), approximateSettings);
+            DynamicsWorld* worlds[2] = {&exactWorld, &approximateWorld};
+            std::vector<RigidBody*> bodies[2];
+
+            for (uint w=0; w < 2; w++) {
+
+                // Spinning bodies without joints
+                for (uint i=0; i < 4; i++) {
+                    RigidBody* body = worlds[w]->createRigidBody(Transform(Vector3(decimal(i) * 5, 0, 0),
+                                                                           Quaternion::identity()));
+                    body->addCollisionShape(mBoxShape, Transform::identity(), decimal(1.0));
+                    body->setAngularVelocity(Vector3(decimal(i), decimal(3.0), decimal(-2.0)));
+                    bodies[w].push_back(body);
+                }
+
+                // A chain of six spinning bodies linked by joints (the orientations of
+                // its island are normalized four at once and then one by one)
+                RigidBody* previousBody = nullptr;
+                for (uint i=0; i < 6; i++) {
+                    RigidBody* body = worlds[w]->createRigidBody(Transform(Vector3(decimal(i) * 2, 20, 0),
+                                                                           Quaternion::identity()));
+                    body->addCollisionShape(mSphereShape, Transform::identity(), decimal(1.0));
+                    body->setAngularVelocity(Vector3(decimal(1.0), decimal(i), decimal(0.5)));
+                    if (previousBody != nullptr) {
+                        BallAndSocketJointInfo jointInfo(previousBody, body, Vector3(decimal(i) * 2 - 1, 20, 0));
+                        worlds[w]->createJoint(jointInfo);
+                    }
+                    bodies[w].push_back(body);
+                    previousBody = body;
+                }
+            }
+
+            for (uint i=0; i < 100; i++) {
+                exactWorld.update(decimal(1.0) / decimal(60.0));
+                approximateWorld.update(decimal(1.0) / decimal(60.0));
+            }
+
+            // The orientations stay unit and close to the exactly normalized ones
+            for (uint b=0; b < bodies[1].size(); b++) {
+                const Quaternion& exactOrientation = bodies[0][b]->getTransform().getOrientation();
+                const Quaternion& orientation = bodies[1][b]->getTransform().getOrientation();
+                rp3d_test(approxEqual(orientation.length(), decimal(1.0), decimal(0.0001)));
+                rp3d_test(approxEqual(orientation.getVectorV(), exactOrientation.getVectorV(), decimal(0.001)));
+                rp3d_test(approxEqual(orientation.w, exactOrientation.w, decimal(0.001)));
+            }
+        }
+
+
+        void testSpatialSort() {
+
+            WorldSettings settings;
+            settings.isSleepingEnabled = false;
+            WorldSettings sortedSettings = settings;
+            sortedSettings.nbStepsBetweenSpatialSorts = 1;
+
+            DynamicsWorld world(Vector3::zero(), settings);
+            DynamicsWorld sortedWorld(Vector3::zero(), sortedSettings);
+            DynamicsWorld* worlds[2] = {&world, &sortedWorld};
+            std::vector<RigidBody*> bodies[2];
+
+            // Separated bodies created in a scrambled order along the X axis
+            for (uint w=0; w < 2; w++) {
+                for (uint i=0; i < 8; i++) {
+                    const decimal x = decimal((i * 5) % 8) * decimal(3.0);
+                    RigidBody* body = worlds[w]->createRigidBody(Transform(Vector3(x, 0, 0), Quaternion::identity()));
+                    body->addCollisionShape(mSphereShape, Transform::identity(), decimal(1.0));
+                    body->setLinearVelocity(Vector3(0, decimal(i), 0));
+                    bodies[w].push_back(body);
+                }
+            }
+
+            // The first sort moves the states and the next one keeps them in place
+            world.update(decimal(1.0) / decimal(60.0));
+            sortedWorld.update(decimal(1.0) / decimal(60.0));
+            rp3d_test(world.getStepStatistics().nbSpatiallySortedBodies == 0);
+            rp3d_test(sortedWorld.getStepStatistics().nbSpatiallySortedBodies > 0);
+            sortedWorld.update(decimal(1.0) / decimal(60.0));
+            rp3d_test(sortedWorld.getStepStatistics().nbSpatiallySortedBodies == 0);
+            world.update(decimal(1.0) / decimal(60.0));
+
+            // Each body keeps its own velocity after the sort and after destroying bodies
+            for (uint w=0; w < 2; w++) {
+                worlds[w]->destroyRigidBody(bodies[w][2]);
+                worlds[w]->destroyRigidBody(bodies[w][5]);
+                bodies[w].erase(bodies[w].begin() + 5);
+                bodies[w].erase(bodies[w].begin() + 2);
+            }
+            for (uint i=0; i < 10; i++) {
+                world.update(decimal(1.0) / decimal(60.0));
+                sortedWorld.update(decimal(1.0) / decimal(60.0));
+            }
+            bool isSameState = true;
+            for (uint b=0; b < bodies[0].size(); b++) {
+                isSameState &= bodies[1][b]->getLinearVelocity() == bodies[0][b]->getLinearVelocity();
+                isSameState &= bodies[1][b]->getTransform().getPosition() == bodies[0][b]->getTransform().getPosition();
+            }
+            rp3d_test(isSameState);
+
+            // The order of the states is part of the saved state
+            const size_t stateSize = sortedWorld.getStateSizeInBytes();
+            std::vector<unsigned char> state(stateSize);
+            sortedWorld.saveState(state.data());
+            for (uint i=0; i < 20; i++) {
+                sortedWorld.update(decimal(1.0) / decimal(60.0));
+            }
+            std::vector<Vector3> positions;
+            for (uint b=0; b < bodies[1].size(); b++) {
+                positions.push_back(bodies[1][b]->getTransform().getPosition());
+            }
+            rp3d_test(sortedWorld.restoreState(state.data(), stateSize));
+            for (uint i=0; i < 20; i++) {
+                sortedWorld.update(decimal(1.0) / decimal(60.0));
+            }
+            isSameState = true;
+            for (uint b=0; b < bodies[1].size(); b++) {
+                isSameState &= bodies[1][b]->getTransform().getPosition() == positions[b];
+            }
+            rp3d_test(isSameState);
+        }
+
+        void testSpatialSortWithAsynchronousUpdate() {
+
+            DefaultTaskScheduler scheduler(4);
+            WorldSettings settings;
+            settings.isSleepingEnabled = false;
+            settings.nbStepsBetweenSpatialSorts = 1;
+            settings.taskScheduler = &scheduler;
+            DynamicsWorld world(Vector3::zero(), settings);
+
+            // Bodies in separated lanes that cross each other along the X axis
+            std::vector<RigidBody*> bodies;
+            for (uint i=0; i < 16; i++) {
+                const decimal x = decimal((i * 5) % 16) * decimal(2.0);
+                RigidBody* body = world.createRigidBody(Transform(Vector3(x, decimal(i) * decimal(2.0), 0), Quaternion::identity()));
+                body->addCollisionShape(mSphereShape, Transform::identity(), decimal(1.0));
+                body->setLinearVelocity(Vector3(i % 2 == 0 ? decimal(60.0) : decimal(-60.0), 0, 0));
+                bodies.push_back(body);
+            }
+
+            // The states are sorted before the snapshot, so the snapshot of each body stays
+            // valid while the step is running
+            uint nbSortedBodies = 0;
+            bool isSnapshotValid = true;
+            std::vector<Transform> transforms(bodies.size());
+            std::vector<Vector3> velocities(bodies.size());
+            for (uint step=0; step < 30; step++) {
+
+                for (uint b=0; b < bodies.size(); b++) {
+                    transforms[b] = bodies[b]->getTransform();
+                    velocities[b] = bodies[b]->getLinearVelocity();
+                }
+
+                world.startUpdate(decimal(1.0) / decimal(60.0));
+                for (uint i=0; i < 100; i++) {
+                    for (uint b=0; b < bodies.size(); b++) {
+                        isSnapshotValid &= bodies[b]->getSnapshotTransform().getPosition() == transforms[b].getPosition();
+                        isSnapshotValid &= bodies[b]->getSnapshotLinearVelocity() == velocities[b];
+                    }
+                }
+                world.waitUpdate();
+
+                nbSortedBodies += world.getStepStatistics().nbSpatiallySortedBodies;
+            }
+
+            rp3d_test(isSnapshotValid);
+            rp3d_test(nbSortedBodies > 0);
+        }
+
+        void testSimulationLevelsOfDetail() {
+
+            WorldSettings settings;
+            settings.isSleepingEnabled = false;
+            DynamicsWorld world(Vector3(0, decimal(-9.81), 0), settings);
+            const decimal timeStep = decimal(1.0) / decimal(60.0);
+
+            // Two falling bodies simulated at every step and every four steps
+            RigidBody* nearBody = world.createRigidBody(Transform(Vector3(0, 10, 0), Quaternion::identity()));
+            nearBody->addCollisionShape(mSphereShape, Transform::identity(), decimal(1.0));
+            RigidBody* farBody = world.createRigidBody(Transform(Vector3(100, 10, 0), Quaternion::identity()));
+            farBody->addCollisionShape(mSphereShape, Transform::identity(), decimal(1.0));
+            farBody->setSimulationLevelOfDetail(2);
+            rp3d_test(farBody->getSimulationLevelOfDetail() == 2);
+
+            // All the levels are simulated at the first step
+            world.update(timeStep);
+            rp3d_test(world.getStepStatistics().nbIslands == 2);
+            rp3d_test(world.getStepStatistics().nbSkippedIslands == 0);
+            rp3d_test(approxEqual(farBody->getLinearVelocity().y, nearBody->getLinearVelocity().y, decimal(0.0001)));
+
+            // The far body is left unchanged during the next three steps
+            const Vector3 farPosition = farBody->getTransform().getPosition();
+            for (uint i=0; i < 3; i++) {
+                world.update(timeStep);
+                rp3d_test(world.getStepStatistics().nbIslands == 1);
+                rp3d_test(world.getStepStatistics().nbSkippedIslands == 1);
+                rp3d_test(farBody->getTransform().getPosition() == farPosition);
+            }
+            rp3d_test(nearBody->getLinearVelocity().y < farBody->getLinearVelocity().y);
+
+            // Then it is simulated with the accumulated time and catches up with the near body
+            world.update(timeStep);
+            rp3d_test(world.getStepStatistics().nbSkippedIslands == 0);
+            rp3d_test(approxEqual(farBody->getLinearVelocity().y, nearBody->getLinearVelocity().y, decimal(0.0001)));
+            rp3d_test(farBody->getTransform().getPosition().y < farPosition.y);
+
+            // A body at the full rate simulates its whole island at the full rate
+            farBody->setSimulationLevelOfDetail(0);
+            world.update(timeStep);
+            rp3d_test(world.getStepStatistics().nbSkippedIslands == 0);
+        }
+
+        void testStepStages() {
+
+            WorldSettings settings;
+            DynamicsWorld world(Vector3(0, decimal(-9.81), 0), settings);
+            DynamicsWorld stagedWorld(Vector3(0, decimal(-9.81), 0), settings);
+            DynamicsWorld* worlds[2] = {&world, &stagedWorld};
+            std::vector<RigidBody*> bodies[2];
+
+            // A stack of boxes on a floor in both worlds
+            for (uint w=0; w < 2; w++) {
+                RigidBody* floor = worlds[w]->createRigidBody(Transform(Vector3(0, -1, 0), Quaternion::identity()));
+                floor->setType(BodyType::STATIC);
+                floor->addCollisionShape(mFloorShape, Transform::identity(), decimal(1.0));
+                for (int i=0; i < 5; i++) {
+                    RigidBody* body = worlds[w]->createRigidBody(Transform(Vector3(0, decimal(0.5 + 1.1 * i), 0),
+                                                                           Quaternion::identity()));
+                    body->addCollisionShape(mBoxShape, Transform::identity(), decimal(1.0));
+                    bodies[w].push_back(body);
+                }
+            }
+
+            // The stages are executed in order
+            const StepStage stages[5] = {StepStage::BROAD_PHASE, StepStage::NARROW_PHASE, StepStage::ISLANDS,
+                                         StepStage::SOLVER, StepStage::END_OF_STEP};
+            rp3d_test(stagedWorld.getNextStepStage() == StepStage::NONE);
+            stagedWorld.beginStep(decimal(1.0) / decimal(60.0), 2);
+            for (uint i=0; i < 5; i++) {
+                rp3d_test(stagedWorld.getNextStepStage() == stages[i]);
+                rp3d_test(stagedWorld.executeNextStepStage() == (i < 4));
+            }
+            rp3d_test(stagedWorld.getNextStepStage() == StepStage::NONE);
+            world.update(decimal(1.0) / decimal(60.0), 2);
+
+            // A step executed stage by stage is the same as a step of update()
+            for (uint i=0; i < 60; i++) {
+                world.update(decimal(1.0) / decimal(60.0), 2);
+                stagedWorld.beginStep(decimal(1.0) / decimal(60.0), 2);
+                while (stagedWorld.executeNextStepStage()) {}
+            }
+            bool isSameState = true;
+            for (uint b=0; b < bodies[0].size(); b++) {
+                isSameState &= bodies[1][b]->getTransform().getPosition() == bodies[0][b]->getTransform().getPosition();
+                isSameState &= bodies[1][b]->getLinearVelocity() == bodies[0][b]->getLinearVelocity();
+            }
+            rp3d_test(isSameState);
+            rp3d_test(stagedWorld.getStepStatistics().nbContactPoints == world.getStepStatistics().nbContactPoints);
+        }
+
+        void testContactEvents() {
+
+            for (uint k=0; k < 2; k++) {
+
+                WorldSettings settings;
+                settings.isSleepingEnabled = false;
+                settings.isContactStayEventReported = k == 1;
+                DynamicsWorld world(Vector3(0, 0, 0), settings);
+
+                RigidBody* floor = world.createRigidBody(Transform(Vector3(0, -1, 0), Quaternion::identity()));
+                floor->setType(BodyType::STATIC);
+                ProxyShape* floorProxyShape = floor->addCollisionShape(mFloorShape, Transform::identity(), decimal(1.0));
+                RigidBody* sphere = world.createRigidBody(Transform(Vector3(0, 5, 0), Quaternion::identity()));
+                ProxyShape* sphereProxyShape = sphere->addCollisionShape(mSphereShape, Transform::identity(), decimal(1.0));
+
+                world.update(decimal(1.0) / decimal(60.0));
+                rp3d_test(world.getContactEvents().size() == 0);
+
+                // The sphere starts touching the floor
+                sphere->setTransform(Transform(Vector3(0, decimal(0.45), 0), Quaternion::identity()));
+                world.update(decimal(1.0) / decimal(60.0));
+                rp3d_test(world.getContactEvents().size() == 1);
+                const ContactEvent& beginEvent = world.getContactEvents()[0];
+                rp3d_test(beginEvent.type == ContactEventType::CONTACT_BEGIN);
+                rp3d_test((beginEvent.body1 == floor && beginEvent.body2 == sphere) ||
+                          (beginEvent.body1 == sphere && beginEvent.body2 == floor));
+                rp3d_test((beginEvent.proxyShape1 == floorProxyShape && beginEvent.proxyShape2 == sphereProxyShape) ||
+                          (beginEvent.proxyShape1 == sphereProxyShape && beginEvent.proxyShape2 == floorProxyShape));
+                rp3d_test(beginEvent.nbContactPoints > 0);
+
+                // The sphere stays on the floor
+                sphere->setTransform(Transform(Vector3(0, decimal(0.45), 0), Quaternion::identity()));
+                sphere->setLinearVelocity(Vector3::zero());
+                world.update(decimal(1.0) / decimal(60.0));
+                if (settings.isContactStayEventReported) {
+                    rp3d_test(world.getContactEvents().size() == 1);
+                    rp3d_test(world.getContactEvents()[0].type == ContactEventType::CONTACT_STAY);
+                    rp3d_test(world.getContactEvents()[0].nbContactPoints > 0);
+                }
+                else {
+                    rp3d_test(world.getContactEvents().size() == 0);
+                }
+
+                // The sphere leaves the floor
+                sphere->setTransform(Transform(Vector3(0, 5, 0), Quaternion::identity()));
+                sphere->setLinearVelocity(Vector3::zero());
+                world.update(decimal(1.0) / decimal(60.0));
+                rp3d_test(world.getContactEvents().size() == 1);
+                rp3d_test(world.getContactEvents()[0].type == ContactEventType::CONTACT_END);
+                rp3d_test(world.getContactEvents()[0].nbContactPoints == 0);
+
+                world.update(decimal(1.0) / decimal(60.0));
+                rp3d_test(world.getContactEvents().size() == 0);
+            }
+        }
+
+        void testContactManifolds() {
+
+            DynamicsWorld world(Vector3(0, decimal(-9.81), 0));
+
+            List<RigidBody*> bodies(MemoryManager::getBaseAllocator());
+            createPile(world, bodies);
+
+            for (uint i=0; i < 10; i++) {
+
+                world.update(decimal(1.0) / decimal(60.0));
+
+                // The persistent list contains the same manifolds as the allocated list
+                const List<const ContactManifold*>& manifolds = world.getContactManifolds();
+                List<const ContactManifold*> contactsList = world.getContactsList();
+                rp3d_test(manifolds.size() > 0);
+                rp3d_test(manifolds.size() == contactsList.size());
+                bool isSameList = true;
+                for (uint m=0; m < manifolds.size(); m++) {
+                    isSameList &= manifolds[m] == contactsList[m];
+                    isSameList &= manifolds[m]->getNbContactPoints() > 0;
+                }
+                rp3d_test(isSameList);
+            }
+
+            // The manifolds of a destroyed body are removed from the list
+            RigidBody* body = bodies[0];
+            world.destroyRigidBody(body);
+            const List<const ContactManifold*>& manifolds = world.getContactManifolds();
+            bool isBodyRemoved = true;
+            for (uint m=0; m < manifolds.size(); m++) {
+                isBodyRemoved &= manifolds[m]->getBody1() != body && manifolds[m]->getBody2() != body;
+            }
+            rp3d_test(isBodyRemoved);
+        }
+
+        void testContactImpulses() {
+
+            const decimal threshold = decimal(0.5);
+
+            WorldSettings settings;
+            settings.isContactImpulseReported = true;
+            settings.contactImpulseReportThreshold = threshold;
+            DynamicsWorld world(Vector3(0, decimal(-9.81), 0), settings);
+
+            List<RigidBody*> bodies(MemoryManager::getBaseAllocator());
+            createPile(world, bodies);
+
+            for (uint i=0; i < 10; i++) {
+
+                world.update(decimal(1.0) / decimal(60.0));
+
+                // Compute the manifolds with impulses larger than the threshold
+                const List<const ContactManifold*>& manifolds = world.getContactManifolds();
+                uint nbExpectedImpulses = 0;
+                decimal expectedTotalImpulse = decimal(0.0);
+                decimal expectedMaxImpulse = decimal(0.0);
+                for (uint m=0; m < manifolds.size(); m++) {
+                    decimal totalImpulse = decimal(0.0);
+                    decimal maxImpulse = decimal(0.0);
+                    for (ContactPoint* point = manifolds[m]->getContactPoints(); point != nullptr; point = point->getNext()) {
+                        totalImpulse += point->getPenetrationImpulse();
+                        maxImpulse = std::max(maxImpulse, point->getPenetrationImpulse());
+                    }
+                    if (totalImpulse > threshold) {
+                        nbExpectedImpulses++;
+                        expectedTotalImpulse += totalImpulse;
+                        expectedMaxImpulse = std::max(expectedMaxImpulse, maxImpulse);
+                    }
+                }
+
+                const List<ContactImpulse>& impulses = world.getContactImpulses();
+                rp3d_test(impulses.size() == nbExpectedImpulses);
+
+                decimal totalImpulse = decimal(0.0);
+                decimal maxImpulse = decimal(0.0);
+                bool isAboveThreshold = true;
+                for (uint c=0; c < impulses.size(); c++) {
+                    isAboveThreshold &= impulses[c].totalNormalImpulse > threshold;
+                    isAboveThreshold &= impulses[c].maxNormalImpulse <= impulses[c].totalNormalImpulse;
+                    totalImpulse += impulses[c].totalNormalImpulse;
+                    maxImpulse = std::max(maxImpulse, impulses[c].maxNormalImpulse);
+                }
+                rp3d_test(isAboveThreshold);
+                rp3d_test(approxEqual(totalImpulse, expectedTotalImpulse, decimal(0.001)));
+                rp3d_test(approxEqual(maxImpulse, expectedMaxImpulse, decimal(0.0001)));
+            }
+
+            rp3d_test(world.getContactImpulses().size() > 0);
+        }
+
+        void testTriggers() {
+
+            WorldSettings settings;
+            settings.isSleepingEnabled = false;
+            DynamicsWorld world(Vector3(0, 0, 0), settings);
+
+            // Static trigger volume
+            RigidBody* volume = world.createRigidBody(Transform(Vector3(0, 0, 0), Quaternion::identity()));
+            volume->setType(BodyType::STATIC);
+            ProxyShape* volumeProxyShape = volume->addCollisionShape(mBoxShape, Transform::identity(), decimal(1.0));
+            volumeProxyShape->setIsTrigger(true);
+            rp3d_test(volumeProxyShape->isTrigger());
+
+            // The sphere moves through the trigger volume
+            RigidBody* sphere = world.createRigidBody(Transform(Vector3(-3, 0, 0), Quaternion::identity()));
+            sphere->addCollisionShape(mSphereShape, Transform::identity(), decimal(1.0));
+            sphere->setLinearVelocity(Vector3(6, 0, 0));
+
+            uint nbEnterEvents = 0;
+            uint nbExitEvents = 0;
+            bool isInsideWhenEntering = true;
+            bool hasContacts = false;
+            for (uint i=0; i < 60; i++) {
+
+                world.update(decimal(1.0) / decimal(60.0));
+
+                const List<ContactEvent>& events = world.getContactEvents();
+                for (uint e=0; e < events.size(); e++) {
+                    rp3d_test(events[e].proxyShape1 == volumeProxyShape || events[e].proxyShape2 == volumeProxyShape);
+                    rp3d_test(events[e].nbContactPoints == 0);
+                    if (events[e].type == ContactEventType::TRIGGER_ENTER) {
+                        nbEnterEvents++;
+                        isInsideWhenEntering &= sphere->getTransform().getPosition().x > decimal(-1.01);
+                    }
+                    else if (events[e].type == ContactEventType::TRIGGER_EXIT) {
+                        nbExitEvents++;
+                    }
+                }
+
+                hasContacts |= world.getContactManifolds().size() > 0;
+            }
+
+            // The sphere has crossed the trigger without any contact
+            rp3d_test(nbEnterEvents == 1);
+            rp3d_test(nbExitEvents == 1);
+            rp3d_test(isInsideWhenEntering);
+            rp3d_test(!hasContacts);
+            rp3d_test(approxEqual(sphere->getLinearVelocity().x, decimal(6.0), decimal(0.0001)));
+            rp3d_test(sphere->getTransform().getPosition().x > decimal(2.0));
+        }
+
+        void testQueryOnlyShapes() {
+
+            WorldSettings settings;
+            settings.isSleepingEnabled = false;
+            DynamicsWorld world(Vector3(0, 0, 0), settings);
+
+            // A query-only shape that overlaps with a dynamic box
+            RigidBody* sensor = world.createRigidBody(Transform(Vector3(0, 0, 0), Quaternion::identity()));
+            sensor->setType(BodyType::STATIC);
+            ProxyShape* sensorProxyShape = sensor->addCollisionShape(mBoxShape, Transform::identity(), decimal(1.0));
+            sensorProxyShape->setIsQueryOnly(true);
+            rp3d_test(sensorProxyShape->isQueryOnly());
+            rp3d_test(sensorProxyShape->getBroadPhaseId() == -1);
+
+            RigidBody* box = world.createRigidBody(Transform(Vector3(decimal(0.5), 0, 0), Quaternion::identity()));
+            ProxyShape* boxProxyShape = box->addCollisionShape(mBoxShape, Transform::identity(), decimal(1.0));
+
+            // The query-only shape is never part of an overlapping pair
+            world.update(decimal(1.0) / decimal(60.0));
+            rp3d_test(world.getBroadPhaseStatistics().nbOverlappingPairs == 0);
+            rp3d_test(world.getContactManifolds().size() == 0);
+
+            // The queries find the query-only shape
+            RaycastHit hit;
+            rp3d_test(world.raycastClosest(Ray(Vector3(-10, 0, 0), Vector3(10, 0, 0)), hit));
+            rp3d_test(hit.proxyShape == sensorProxyShape);
+            rp3d_test(world.raycastAny(Ray(Vector3(-10, 0, 0), Vector3(-5, 0, 0))) == false);
+            rp3d_test(world.raycastAny(Ray(Vector3(-10, 0, 0), Vector3(0, 0, 0))));
+
+            Ray rays[2] = {Ray(Vector3(-10, 0, 0), Vector3(10, 0, 0)), Ray(Vector3(10, 0, 0), Vector3(-10, 0, 0))};
+            RaycastHit hits[2];
+            world.raycastBatch(rays, 2, hits);
+            rp3d_test(hits[0].proxyShape == sensorProxyShape);
+            rp3d_test(hits[1].proxyShape == boxProxyShape);
+
+            OverlapHit overlapHits[4];
+            const uint nbHits = world.testAABBOverlap(AABB(Vector3(-1, -1, -1), Vector3(1, 1, 1)), overlapHits, 4);
+            rp3d_test(nbHits == 2);
+            rp3d_test(overlapHits[0].proxyShape == sensorProxyShape || overlapHits[1].proxyShape == sensorProxyShape);
+
+            // The query-only shape follows its body
+            sensor->setTransform(Transform(Vector3(0, 5, 0), Quaternion::identity()));
+            rp3d_test(!world.raycastAny(Ray(Vector3(-10, 0, 0), Vector3(-2, 0, 0))));
+            rp3d_test(world.raycastClosest(Ray(Vector3(-10, 5, 0), Vector3(10, 5, 0)), hit));
+            rp3d_test(hit.proxyShape == sensorProxyShape);
+
+            // The shape collides again when it is moved back into the broad-phase
+            sensor->setTransform(Transform(Vector3(0, 0, 0), Quaternion::identity()));
+            sensorProxyShape->setIsQueryOnly(false);
+            rp3d_test(sensorProxyShape->getBroadPhaseId() != -1);
+            world.update(decimal(1.0) / decimal(60.0));
+            rp3d_test(world.getBroadPhaseStatistics().nbOverlappingPairs == 1);
+            rp3d_test(world.getContactManifolds().size() > 0);
+        }
+
+        void testBroadPhaseCollisionFilter() {
+
+            WorldSettings settings;
+            settings.isSleepingEnabled = false;
+            DynamicsWorld world(Vector3(0, 0, 0), settings);
+
+            // Two bodies whose collision categories and masks do not match (with a category
+            // that does not fit into 16 bits)
+            const collisionmask category = collisionmask(1) << 20;
+            RigidBody* body1 = world.createRigidBody(Transform(Vector3(0, 0, 0), Quaternion::identity()));
+            ProxyShape* shape1 = body1->addCollisionShape(mBoxShape, Transform::identity(), decimal(1.0));
+            shape1->setCollisionCategoryBits(category);
+            RigidBody* body2 = world.createRigidBody(Transform(Vector3(decimal(0.5), 0, 0), Quaternion::identity()));
+            ProxyShape* shape2 = body2->addCollisionShape(mBoxShape, Transform::identity(), decimal(1.0));
+            shape2->setCollideWithMaskBits(ALL_COLLISION_CATEGORIES & ~category);
+
+            // Two static bodies
+            RigidBody* body3 = world.createRigidBody(Transform(Vector3(10, 0, 0), Quaternion::identity()));
+            body3->setType(BodyType::STATIC);
+            body3->addCollisionShape(mBoxShape, Transform::identity(), decimal(1.0));
+            RigidBody* body4 = world.createRigidBody(Transform(Vector3(decimal(10.5), 0, 0), Quaternion::identity()));
+            body4->setType(BodyType::STATIC);
+            body4->addCollisionShape(mBoxShape, Transform::identity(), decimal(1.0));
+
+            // Two bodies that cannot collide because of a joint
+            RigidBody* body5 = world.createRigidBody(Transform(Vector3(20, 0, 0), Quaternion::identity()));
+            body5->addCollisionShape(mBoxShape, Transform::identity(), decimal(1.0));
+            RigidBody* body6 = world.createRigidBody(Transform(Vector3(decimal(20.5), 0, 0), Quaternion::identity()));
+            body6->addCollisionShape(mBoxShape, Transform::identity(), decimal(1.0));
+            BallAndSocketJointInfo jointInfo(body5, body6, Vector3(decimal(20.25), 0, 0));
+            jointInfo.isCollisionEnabled = false;
+            Joint* joint = world.createJoint(jointInfo);
+
+            // Two bodies that collide
+            RigidBody* body7 = world.createRigidBody(Transform(Vector3(30, 0, 0), Quaternion::identity()));
+            body7->addCollisionShape(mBoxShape, Transform::identity(), decimal(1.0));
+            RigidBody* body8 = world.createRigidBody(Transform(Vector3(decimal(30.5), 0, 0), Quaternion::identity()));
+            body8->addCollisionShape(mBoxShape, Transform::identity(), decimal(1.0));
+
+            // Only the last pair is reported by the broad-phase
+            world.update(decimal(1.0) / decimal(60.0));
+            rp3d_test(world.getBroadPhaseStatistics().nbOverlappingPairs == 1);
+
+            // The shapes are tested again when the collision filtering changes
+            world.destroyJoint(joint);
+            shape2->setCollideWithMaskBits(ALL_COLLISION_CATEGORIES);
+            world.update(decimal(1.0) / decimal(60.0));
+            rp3d_test(world.getBroadPhaseStatistics().nbOverlappingPairs >= 2);
+
+            bool isBody1Colliding = false;
+            bool isBody5Colliding = false;
+            const List<const ContactManifold*>& manifolds = world.getContactManifolds();
+            for (uint m=0; m < manifolds.size(); m++) {
+                isBody1Colliding |= manifolds[m]->getBody1() == body1 || manifolds[m]->getBody2() == body1;
+                isBody5Colliding |= manifolds[m]->getBody1() == body5 || manifolds[m]->getBody2() == body5;
+            }
+            rp3d_test(isBody1Colliding);
+            rp3d_test(isBody5Colliding);
+        }
+
+        void testSleepingPairs() {
+
+            DynamicsWorld world(Vector3(0, decimal(-9.81), 0));
+
+            RigidBody* floor = world.createRigidBody(Transform(Vector3(0, -1, 0), Quaternion::identity()));
+            floor->setType(BodyType::STATIC);
+            floor->addCollisionShape(mFloorShape, Transform::identity(), decimal(1.0));
+
+            // A stack of two boxes resting on the floor
+            RigidBody* box1 = world.createRigidBody(Transform(Vector3(0, decimal(0.5), 0), Quaternion::identity()));
+            box1->addCollisionShape(mBoxShape, Transform::identity(), decimal(1.0));
+            RigidBody* box2 = world.createRigidBody(Transform(Vector3(0, decimal(1.5), 0), Quaternion::identity()));
+            box2->addCollisionShape(mBoxShape, Transform::identity(), decimal(1.0));
+
+            for (uint i=0; i < 240; i++) {
+                world.update(decimal(1.0) / decimal(60.0));
+            }
+            rp3d_test(box1->isSleeping());
+            rp3d_test(box2->isSleeping());
+
+            // The pairs of the sleeping bodies are parked with their contacts
+            world.update(decimal(1.0) / decimal(60.0));
+            const StepStatistics& statistics = world.getStepStatistics();
+            rp3d_test(statistics.nbOverlappingPairs >= 2);
+            rp3d_test(statistics.nbParkedOverlappingPairs == statistics.nbOverlappingPairs);
+            rp3d_test(statistics.nbContactManifolds == 0);
+            rp3d_test(world.getNarrowPhaseStatistics().nbTests == 0);
+
+            // Waking up a body makes its pairs active again with their contacts (the other
+            // bodies of the island are woken up by the island computation of the first step)
+            box2->setIsSleeping(false);
+            world.update(decimal(1.0) / decimal(60.0));
+            world.update(decimal(1.0) / decimal(60.0));
+            rp3d_test(!box1->isSleeping());
+            rp3d_test(world.getStepStatistics().nbParkedOverlappingPairs == 0);
+            rp3d_test(world.getStepStatistics().nbContactManifolds >= 2);
+            rp3d_test(approxEqual(box2->getTransform().getPosition().y, decimal(1.5), decimal(0.05)));
+        }
+
+        void testSleepingMovedShapes() {
+
+            DynamicsWorld world(Vector3(0, 0, 0));
+
+            // Two sleeping bodies whose shapes overlap but cannot collide
+            const collisionmask category = 0x0002;
+            RigidBody* body1 = world.createRigidBody(Transform(Vector3(0, 0, 0), Quaternion::identity()));
+            ProxyShape* shape1 = body1->addCollisionShape(mBoxShape, Transform::identity(), decimal(1.0));
+            shape1->setCollisionCategoryBits(category);
+            RigidBody* body2 = world.createRigidBody(Transform(Vector3(decimal(0.5), 0, 0), Quaternion::identity()));
+            ProxyShape* shape2 = body2->addCollisionShape(mBoxShape, Transform::identity(), decimal(1.0));
+            shape2->setCollideWithMaskBits(ALL_COLLISION_CATEGORIES & ~category);
+            world.update(decimal(1.0) / decimal(60.0));
+            body1->setIsSleeping(true);
+            body2->setIsSleeping(true);
+
+            // The moved shape of a sleeping body is not paired with the other sleeping shapes
+            shape2->setCollideWithMaskBits(ALL_COLLISION_CATEGORIES);
+            world.update(decimal(1.0) / decimal(60.0));
+            rp3d_test(world.getBroadPhaseStatistics().nbSleepingMovedShapes == 1);
+            rp3d_test(world.getBroadPhaseStatistics().nbOverlappingPairs == 0);
+            rp3d_test(world.getStepStatistics().nbOverlappingPairs == 0);
+            rp3d_test(body1->isSleeping());
+            rp3d_test(body2->isSleeping());
+
+            // The pair is created when one of the bodies wakes up
+            body1->setIsSleeping(false);
+            world.update(decimal(1.0) / decimal(60.0));
+            rp3d_test(world.getStepStatistics().nbOverlappingPairs == 1);
+            rp3d_test(!body2->isSleeping());
+        }
+
+        void testBroadPhaseTreeStatistics() {
+
+            WorldSettings settings;
+            settings.isBroadPhaseQueryStatisticsEnabled = true;
+            DynamicsWorld world(Vector3(0, decimal(-9.81), 0), settings);
+            DynamicsWorld defaultWorld(Vector3(0, decimal(-9.81), 0));
+
+            for (uint i=0; i < 10; i++) {
+                const Transform transform(Vector3(decimal(i) * decimal(1.5), 0, 0), Quaternion::identity());
+                world.createRigidBody(transform)->addCollisionShape(mBoxShape, Transform::identity(), decimal(1.0));
+                defaultWorld.createRigidBody(transform)->addCollisionShape(mBoxShape, Transform::identity(), decimal(1.0));
+            }
+            world.update(decimal(1.0) / decimal(60.0));
+            defaultWorld.update(decimal(1.0) / decimal(60.0));
+
+            // The queries of the moved shapes are counted
+            const BroadPhaseStatistics& statistics = world.getBroadPhaseStatistics();
+            rp3d_test(statistics.nbQueries >= statistics.nbMovedShapes);
+            rp3d_test(statistics.nbQueryVisitedNodes >= statistics.nbQueries);
+            rp3d_test(defaultWorld.getBroadPhaseStatistics().nbQueries == 0);
+            rp3d_test(defaultWorld.getBroadPhaseStatistics().nbQueryVisitedNodes == 0);
+
+            // The metrics of the trees
+            DynamicAABBTreeStatistics dynamicTreeStatistics;
+            DynamicAABBTreeStatistics staticTreeStatistics;
+            rp3d_test(world.computeBroadPhaseTreeStatistics(dynamicTreeStatistics, staticTreeStatistics));
+            rp3d_test(dynamicTreeStatistics.nbLeaves == 10);
+            rp3d_test(dynamicTreeStatistics.nbNodes == 19);
+            rp3d_test(dynamicTreeStatistics.height >= 4);
+            rp3d_test(dynamicTreeStatistics.cost > decimal(0.0));
+            rp3d_test(staticTreeStatistics.nbLeaves == 0);
+
+            // The other broad-phase algorithms have no tree
+            WorldSettings gridSettings;
+            gridSettings.broadPhaseType = BroadPhaseType::GRID;
+            DynamicsWorld gridWorld(Vector3(0, decimal(-9.81), 0), gridSettings);
+            rp3d_test(!gridWorld.computeBroadPhaseTreeStatistics(dynamicTreeStatistics, staticTreeStatistics));
+        }
+
+        void testNarrowPhaseCosts() {
+
+            float heights[64];
+            for (uint i=0; i < 64; i++) {
+                heights[i] = 0.0f;
+            }
+            HeightFieldShape heightFieldShape(8, 8, -1, 1, heights, HeightFieldShape::HeightDataType::HEIGHT_FLOAT_TYPE);
+            BoxShape largeBoxShape(Vector3(1, 1, 1));
+
+            WorldSettings settings;
+            settings.isNarrowPhaseCostsEnabled = true;
+            DynamicsWorld world(Vector3(0, decimal(-9.81), 0), settings);
+
+            // A large box on a height field and two boxes touching each other
+            RigidBody* ground = world.createRigidBody(Transform::identity());
+            ground->setType(BodyType::STATIC);
+            ProxyShape* heightFieldProxyShape = ground->addCollisionShape(&heightFieldShape, Transform::identity(), decimal(1.0));
+            RigidBody* largeBox = world.createRigidBody(Transform(Vector3(0, decimal(0.9), 0), Quaternion::identity()));
+            ProxyShape* largeBoxProxyShape = largeBox->addCollisionShape(&largeBoxShape, Transform::identity(), decimal(1.0));
+            world.createRigidBody(Transform(Vector3(20, 0, 0), Quaternion::identity()))
+                    ->addCollisionShape(mBoxShape, Transform::identity(), decimal(1.0));
+            world.createRigidBody(Transform(Vector3(decimal(20.9), 0, 0), Quaternion::identity()))
+                    ->addCollisionShape(mBoxShape, Transform::identity(), decimal(1.0));
+
+            world.update(decimal(1.0) / decimal(60.0));
+            world.update(decimal(1.0) / decimal(60.0));
+
+            // The two pairs are sorted by decreasing time
+            NarrowPhasePairCost pairCosts[4];
+            rp3d_test(world.getMostExpensiveNarrowPhasePairs(pairCosts, 4) == 2);
+            rp3d_test(pairCosts[0].getTime() >= pairCosts[1].getTime());
+            rp3d_test(world.getMostExpensiveNarrowPhasePairs(pairCosts, 1) == 1);
+
+            // The triangles of the height field are counted for its pair
+            uint nbTriangleTests = 0;
+            bool isHeightFieldPairFound = false;
+            world.getMostExpensiveNarrowPhasePairs(pairCosts, 4);
+            for (uint i=0; i < 2; i++) {
+                if (pairCosts[i].shape1 == heightFieldProxyShape || pairCosts[i].shape2 == heightFieldProxyShape) {
+                    isHeightFieldPairFound = pairCosts[i].shape1 == largeBoxProxyShape ||
+                                             pairCosts[i].shape2 == largeBoxProxyShape;
+                    rp3d_test(pairCosts[i].nbTriangles >= 8);
+                    rp3d_test(pairCosts[i].nbTests >= 1);
+                    rp3d_test(pairCosts[i].nbTests <= pairCosts[i].nbTriangles);
+                    rp3d_test(pairCosts[i].getTime() > 0.0);
+                    nbTriangleTests = pairCosts[i].nbTests;
+                }
+                else {
+                    rp3d_test(pairCosts[i].nbTests == 1);
+                    rp3d_test(pairCosts[i].nbTriangles == 0);
+                }
+            }
+            rp3d_test(isHeightFieldPairFound);
+
+            // The tests of the triangles and of the two boxes are convex polyhedron tests
+            const NarrowPhaseShapeTypeCost& polyhedronCost = world.getNarrowPhaseShapeTypeCost(
+                        CollisionShapeType::CONVEX_POLYHEDRON, CollisionShapeType::CONVEX_POLYHEDRON);
+            rp3d_test(polyhedronCost.nbTests == nbTriangleTests + 1);
+            rp3d_test(polyhedronCost.nbTests == world.getNarrowPhaseStatistics().nbTests);
+            rp3d_test(world.getNarrowPhaseShapeTypeCost(CollisionShapeType::SPHERE, CollisionShapeType::SPHERE).nbTests == 0);
+
+            // The costs are cleared when a proxy shape is removed
+            largeBox->removeCollisionShape(largeBoxProxyShape);
+            rp3d_test(world.getMostExpensiveNarrowPhasePairs(pairCosts, 4) == 0);
+
+            // The costs are not measured by default
+            DynamicsWorld defaultWorld(Vector3(0, decimal(-9.81), 0));
+            defaultWorld.createRigidBody(Transform::identity())->addCollisionShape(mBoxShape, Transform::identity(), decimal(1.0));
+            defaultWorld.createRigidBody(Transform(Vector3(decimal(0.9), 0, 0), Quaternion::identity()))
+                    ->addCollisionShape(mBoxShape, Transform::identity(), decimal(1.0));
+            defaultWorld.update(decimal(1.0) / decimal(60.0));
+            rp3d_test(defaultWorld.getMostExpensiveNarrowPhasePairs(pairCosts, 4) == 0);
+        }
+
+
+        void testSaveAndRestoreState() {
+
+            DynamicsWorld world(Vector3(0, decimal(-9.81), 0));
+            List<RigidBody*> bodies(MemoryManager::getBaseAllocator());
+            createScene(world, bodies);
+
+            for (uint i=0; i < 30; i++) {
+                world.update(decimal(1.0) / decimal(60.0));
+            }
+
+            // Save the state while the boxes are in contact
+            const size_t stateSize = world.getStateSizeInBytes();
+            std::vector<unsigned char> state(stateSize);
+            world.saveState(state.data());
+            rp3d_test(world.getStateSizeInBytes() == stateSize);
+
+            List<Transform> transforms(MemoryManager::getBaseAllocator());
+            List<Vector3> velocities(MemoryManager::getBaseAllocator());
+            for (uint i=0; i < 60; i++) {
+                world.update(decimal(1.0) / decimal(60.0));
+            }
+            for (uint i=0; i < bodies.size(); i++) {
+                transforms.add(bodies[i]->getTransform());
+                velocities.add(bodies[i]->getLinearVelocity());
+            }
+
+            // Stepping again from the restored state gives exactly the same results
+            rp3d_test(world.restoreState(state.data(), stateSize));
+            for (uint i=0; i < 60; i++) {
+                world.update(decimal(1.0) / decimal(60.0));
+            }
+            bool isSameState = true;
+            for (uint i=0; i < bodies.size(); i++) {
+                isSameState &= bodies[i]->getTransform().getPosition() == transforms[i].getPosition();
+                isSameState &= bodies[i]->getTransform().getOrientation() == transforms[i].getOrientation();
+                isSameState &= bodies[i]->getLinearVelocity() == velocities[i];
+            }
+            rp3d_test(isSameState);
+
+            // A rejected state does not modify the world
+            uint nbRejectedStates = 0;
+            bool isWorldModified = false;
+            auto restoreCorruptedState = [&](const std::vector<unsigned char>& corruptedState) {
+                std::vector<unsigned char> stateBefore(world.getStateSizeInBytes());
+                world.saveState(stateBefore.data());
+                if (world.restoreState(corruptedState.data(), corruptedState.size())) {
+                    rp3d_test(world.restoreState(state.data(), stateSize));
+                    return;
+                }
+                nbRejectedStates++;
+                std::vector<unsigned char> stateAfter(world.getStateSizeInBytes());
+                world.saveState(stateAfter.data());
+                isWorldModified |= stateAfter != stateBefore;
+            };
+
+            // A truncated state with a consistent size in its header is not restored
+            for (size_t size = 6 * sizeof(uint32) + sizeof(uint64); size < stateSize; size += 7) {
+                std::vector<unsigned char> truncatedState(state.begin(), state.begin() + size);
+                const uint64 truncatedSize = size;
+                std::memcpy(truncatedState.data() + 3 * sizeof(uint32), &truncatedSize, sizeof(uint64));
+                restoreCorruptedState(truncatedState);
+            }
+            rp3d_test(nbRejectedStates == (stateSize - 6 * sizeof(uint32) - sizeof(uint64) + 6) / 7);
+
+            // A state with the index of a missing rigid body (instead of an index or of a null
+            // body) or with an order of the states that is not a permutation is not restored
+            const uint32 nbRigidBodies = world.getNbRigidBodies();
+            uint nbCorruptedIndices = 0;
+            nbRejectedStates = 0;
+            for (size_t offset = 0; offset + sizeof(uint32) <= stateSize; offset++) {
+                uint32 value;
+                std::memcpy(&value, state.data() + offset, sizeof(uint32));
+                if (value != 0xFFFFFFFF && (value < 2 || value >= nbRigidBodies)) continue;
+                std::vector<unsigned char> corruptedState(state);
+                std::memcpy(corruptedState.data() + offset, &nbRigidBodies, sizeof(uint32));
+                restoreCorruptedState(corruptedState);
+                if (value != 0xFFFFFFFF) {
+                    const uint32 duplicatedIndex = 0;
+                    std::memcpy(corruptedState.data() + offset, &duplicatedIndex, sizeof(uint32));
+                    restoreCorruptedState(corruptedState);
+                }
+                nbCorruptedIndices++;
+            }
+            rp3d_test(nbCorruptedIndices > nbRigidBodies);
+            rp3d_test(nbRejectedStates >= nbRigidBodies);
+            rp3d_test(!isWorldModified);
+            rp3d_test(world.restoreState(state.data(), stateSize));
+
+            // A state is not restored if it is truncated, corrupted or saved for other objects
+            rp3d_test(!world.restoreState(state.data(), stateSize - 1));
+            std::vector<unsigned char> corruptedState(state);
+            corruptedState[0] = 0;
+            rp3d_test(!world.restoreState(corruptedState.data(), stateSize));
+            DynamicsWorld otherWorld(Vector3(0, decimal(-9.81), 0));
+            List<RigidBody*> otherBodies(MemoryManager::getBaseAllocator());
+            createScene(otherWorld, otherBodies);
+            world.destroyRigidBody(bodies[bodies.size() - 1]);
+            rp3d_test(!world.restoreState(state.data(), stateSize));
+            rp3d_test(otherWorld.restoreState(state.data(), stateSize));
+        }
+
+        void testCloneWorld() {
+
+            DynamicsWorld world(Vector3(0, decimal(-9.81), 0));
+            List<RigidBody*> bodies(MemoryManager::getBaseAllocator());
+            createScene(world, bodies);
+            world.setNbIterationsVelocitySolver(12);
+
+            for (uint i=0; i < 30; i++) {
+                world.update(decimal(1.0) / decimal(60.0));
+            }
+
+            // The clone has the same bodies and joints with the same IDs
+            DynamicsWorld* clonedWorld = world.clone();
+            rp3d_test(clonedWorld->getNbRigidBodies() == world.getNbRigidBodies());
+            rp3d_test(clonedWorld->getNbJoints() == world.getNbJoints());
+            rp3d_test(clonedWorld->getNbIterationsVelocitySolver() == 12);
+            List<RigidBody*> allBodies(MemoryManager::getBaseAllocator());
+            List<RigidBody*> clonedBodies(MemoryManager::getBaseAllocator());
+            bool isSameIds = true;
+            for (uint i=0; i < world.getNbRigidBodies(); i++) {
+                allBodies.add(world.getRigidBody(i));
+                clonedBodies.add(clonedWorld->getRigidBody(i));
+                isSameIds &= allBodies[i]->getId() == clonedBodies[i]->getId();
+                isSameIds &= allBodies[i]->getType() == clonedBodies[i]->getType();
+                isSameIds &= allBodies[i]->getMass() == clonedBodies[i]->getMass();
+            }
+            for (uint i=0; i < world.getNbJoints(); i++) {
+                isSameIds &= world.getJoint(i)->getId() == clonedWorld->getJoint(i)->getId();
+                isSameIds &= clonedWorld->getJoint(i)->getBody1()->getId() == world.getJoint(i)->getBody1()->getId();
+            }
+            rp3d_test(isSameIds);
+            rp3d_test(isSameState(allBodies, clonedBodies));
+
+            // The two worlds are simulated independently with the same results
+            for (uint i=0; i < 60; i++) {
+                world.update(decimal(1.0) / decimal(60.0));
+                clonedWorld->update(decimal(1.0) / decimal(60.0));
+            }
+            rp3d_test(isSameState(allBodies, clonedBodies));
+
+            // Moving a body of the clone does not move the body of the world
+            const Vector3 position = allBodies[1]->getTransform().getPosition();
+            clonedBodies[1]->setTransform(Transform(Vector3(0, 20, 0), Quaternion::identity()));
+            clonedWorld->update(decimal(1.0) / decimal(60.0));
+            rp3d_test(allBodies[1]->getTransform().getPosition() == position);
+
+            // A state of the world can be restored into the clone
+            std::vector<unsigned char> state(world.getStateSizeInBytes());
+            world.saveState(state.data());
+            rp3d_test(clonedWorld->restoreState(state.data(), state.size()));
+            rp3d_test(isSameState(allBodies, clonedBodies));
+
+            delete clonedWorld;
+        }
+
+        void testSaveAndLoadWorld() {
+
+            DynamicsWorld world(Vector3(0, decimal(-9.81), 0));
+            List<RigidBody*> bodies(MemoryManager::getBaseAllocator());
+            createScene(world, bodies);
+            world.setNbIterationsVelocitySolver(12);
+
+            // A hinge joint with a limit and a motor and a destroyed body (for the IDs)
+            HingeJointInfo hingeInfo(bodies[1], bodies[NB_BOXES_PER_STACK + 1], bodies[1]->getTransform().getPosition(),
+                                     Vector3(0, 0, 1), decimal(-0.5), decimal(0.5), decimal(1.0), decimal(2.0));
+            world.createJoint(hingeInfo);
+            RigidBody* destroyedBody = world.createRigidBody(Transform(Vector3(0, 30, 0), Quaternion::identity()));
+            world.destroyRigidBody(destroyedBody);
+            bodies[2]->getMaterial().setBounciness(decimal(0.3));
+
+            for (uint i=0; i < 30; i++) {
+                world.update(decimal(1.0) / decimal(60.0));
+            }
+
+            // Save the world with its collision shapes
+            CollisionShape* shapes[] = {mBoxShape, mFloorShape};
+            const size_t worldSize = world.getWorldSizeInBytes();
+            std::vector<unsigned char> data(worldSize);
+            world.saveWorld(data.data(), shapes, 2);
+            rp3d_test(world.getWorldSizeInBytes() == worldSize);
+
+            // The loaded world has the same bodies and joints with the same IDs
+            DynamicsWorld* loadedWorld = DynamicsWorld::loadWorld(data.data(), worldSize, shapes, 2);
+            rp3d_test(loadedWorld != nullptr);
+            rp3d_test(loadedWorld->getNbRigidBodies() == world.getNbRigidBodies());
+            rp3d_test(loadedWorld->getNbJoints() == world.getNbJoints());
+            rp3d_test(loadedWorld->getNbIterationsVelocitySolver() == 12);
+            List<RigidBody*> allBodies(MemoryManager::getBaseAllocator());
+            List<RigidBody*> loadedBodies(MemoryManager::getBaseAllocator());
+            bool isSameIds = true;
+            for (uint i=0; i < world.getNbRigidBodies(); i++) {
+                allBodies.add(world.getRigidBody(i));
+                loadedBodies.add(loadedWorld->getRigidBody(i));
+                isSameIds &= allBodies[i]->getId() == loadedBodies[i]->getId();
+                isSameIds &= allBodies[i]->getType() == loadedBodies[i]->getType();
+                isSameIds &= allBodies[i]->getMass() == loadedBodies[i]->getMass();
+                isSameIds &= allBodies[i]->getMaterial().getBounciness() == loadedBodies[i]->getMaterial().getBounciness();
+            }
+            for (uint i=0; i < world.getNbJoints(); i++) {
+                isSameIds &= world.getJoint(i)->getId() == loadedWorld->getJoint(i)->getId();
+                isSameIds &= world.getJoint(i)->getType() == loadedWorld->getJoint(i)->getType();
+                isSameIds &= loadedWorld->getJoint(i)->getBody2()->getId() == world.getJoint(i)->getBody2()->getId();
+            }
+            rp3d_test(isSameIds);
+            rp3d_test(isSameState(allBodies, loadedBodies));
+
+            // The two worlds are simulated with the same results
+            for (uint i=0; i < 60; i++) {
+                world.update(decimal(1.0) / decimal(60.0));
+                loadedWorld->update(decimal(1.0) / decimal(60.0));
+            }
+            rp3d_test(isSameState(allBodies, loadedBodies));
+
+            // The new bodies get the same IDs in the two worlds
+            RigidBody* newBody = world.createRigidBody(Transform::identity());
+            RigidBody* newLoadedBody = loadedWorld->createRigidBody(Transform::identity());
+            rp3d_test(newBody->getId() == newLoadedBody->getId());
+
+            delete loadedWorld;
+
+            // A world is not loaded if it is truncated, corrupted or refers to a missing shape
+            rp3d_test(DynamicsWorld::loadWorld(data.data(), worldSize - 1, shapes, 2) == nullptr);
+            std::vector<unsigned char> corruptedData(data);
+            corruptedData[0] = 0;
+            rp3d_test(DynamicsWorld::loadWorld(corruptedData.data(), worldSize, shapes, 2) == nullptr);
+            rp3d_test(DynamicsWorld::loadWorld(data.data(), worldSize, shapes, 1) == nullptr);
+
+            // A truncated world with a consistent size in its header is not loaded either
+            bool isTruncatedWorldLoaded = false;
+            for (size_t size = 3 * sizeof(uint32) + sizeof(uint64); size < worldSize; size += 13) {
+                std::vector<unsigned char> truncatedData(data.begin(), data.begin() + size);
+                const uint64 truncatedSize = size;
+                std::memcpy(truncatedData.data() + 3 * sizeof(uint32), &truncatedSize, sizeof(uint64));
+                DynamicsWorld* truncatedWorld = DynamicsWorld::loadWorld(truncatedData.data(), size, shapes, 2);
+                isTruncatedWorldLoaded |= truncatedWorld != nullptr;
+                delete truncatedWorld;
+            }
+            rp3d_test(!isTruncatedWorldLoaded);
+
+            // A world with the index of a missing rigid body or with a body type that is not
+            // valid (a dynamic body with another type) is not loaded
+            const uint32 nbRigidBodies = world.getNbRigidBodies();
+            uint nbCorruptedIndices = 0;
+            uint nbRejectedWorlds = 0;
+            for (size_t offset = 0; offset + sizeof(uint32) <= worldSize; offset++) {
+                uint32 value;
+                std::memcpy(&value, data.data() + offset, sizeof(uint32));
+                if (value != 0xFFFFFFFF && (value < 2 || value >= nbRigidBodies)) continue;
+                std::vector<unsigned char> corruptedWorldData(data);
+                std::memcpy(corruptedWorldData.data() + offset, &nbRigidBodies, sizeof(uint32));
+                DynamicsWorld* corruptedWorld = DynamicsWorld::loadWorld(corruptedWorldData.data(), worldSize, shapes, 2);
+                if (corruptedWorld == nullptr) nbRejectedWorlds++;
+                delete corruptedWorld;
+                nbCorruptedIndices++;
+            }
+            rp3d_test(nbCorruptedIndices > nbRigidBodies);
+            rp3d_test(nbRejectedWorlds > nbRigidBodies);
+        }
+
+        void testMigrationAndGhostBodies() {
+
+            // Two worlds that simulate two neighbouring regions with their own floor
+            DynamicsWorld worldA(Vector3(0, decimal(-9.81), 0));
+            DynamicsWorld worldB(Vector3(0, decimal(-9.81), 0));
+            RigidBody* floorA = worldA.createRigidBody(Transform(Vector3(0, -1, 0), Quaternion::identity()));
+            floorA->setType(BodyType::STATIC);
+            floorA->addCollisionShape(mFloorShape, Transform::identity(), decimal(1.0));
+            RigidBody* floorB = worldB.createRigidBody(Transform(Vector3(0, -1, 0), Quaternion::identity()));
+            floorB->setType(BodyType::STATIC);
+            floorB->addCollisionShape(mFloorShape, Transform::identity(), decimal(1.0));
+
+            RigidBody* body = worldA.createRigidBody(Transform(Vector3(1, 5, 0), Quaternion::identity()));
+            body->addCollisionShape(mBoxShape, Transform::identity(), decimal(2.0));
+            body->setLinearVelocity(Vector3(1, 0, 0));
+            body->getMaterial().setBounciness(decimal(0.3));
+
+            // Create a kinematic ghost of the body near the border in the other world
+            CollisionShape* shapes[] = {mBoxShape, mFloorShape};
+            std::vector<unsigned char> bodyData(worldA.getRigidBodySizeInBytes(body));
+            worldA.saveRigidBody(body, bodyData.data(), shapes, 2);
+            RigidBody* ghost = worldB.loadRigidBody(bodyData.data(), bodyData.size(), shapes, 2);
+            rp3d_test(ghost != nullptr);
+            rp3d_test(ghost->getMass() == body->getMass());
+            ghost->setType(BodyType::KINEMATIC);
+            rp3d_test(ghost->getTransform() == body->getTransform());
+            rp3d_test(ghost->getLinearVelocity() == body->getLinearVelocity());
+            rp3d_test(ghost->getMaterial().getBounciness() == body->getMaterial().getBounciness());
+            rp3d_test(ghost->getProxyShapesList() != nullptr);
+
+            // Full motions of the mirrored bodies (the floors are mirrored too)
+            const RigidBody* mirroredBodies[] = {floorA, body};
+            RigidBody* ghostBodies[] = {floorB, ghost};
+            std::vector<unsigned char> baseline(worldA.getMotionsSizeInBytes(mirroredBodies, 2));
+            worldA.saveMotions(mirroredBodies, 2, baseline.data());
+            rp3d_test(worldB.restoreMotions(ghostBodies, 2, baseline.data(), baseline.size()));
+
+            // After a step, the motions that differ from the baseline only contain the falling body
+            worldA.update(decimal(1.0) / decimal(60.0));
+            const size_t deltaSize = worldA.getMotionsSizeInBytes(mirroredBodies, 2, baseline.data());
+            rp3d_test(deltaSize < baseline.size());
+            std::vector<unsigned char> delta(deltaSize);
+            worldA.saveMotions(mirroredBodies, 2, delta.data(), baseline.data());
+            rp3d_test(worldB.restoreMotions(ghostBodies, 2, delta.data(), delta.size()));
+            rp3d_test(ghost->getTransform() == body->getTransform());
+            rp3d_test(ghost->getLinearVelocity() == body->getLinearVelocity());
+            rp3d_test(floorB->getTransform().getPosition() == Vector3(0, -1, 0));
+
+            // Motions written for another number of bodies or truncated are not restored
+            rp3d_test(!worldB.restoreMotions(ghostBodies, 1, delta.data(), delta.size()));
+            rp3d_test(!worldB.restoreMotions(ghostBodies, 2, delta.data(), delta.size() - 1));
+
+            // Migrate the body to the other world (where it replaces its ghost)
+            for (uint i=0; i < 30; i++) {
+                worldA.update(decimal(1.0) / decimal(60.0));
+            }
+            bodyData.resize(worldA.getRigidBodySizeInBytes(body));
+            worldA.saveRigidBody(body, bodyData.data(), shapes, 2);
+            const Transform transform = body->getTransform();
+            const Vector3 linearVelocity = body->getLinearVelocity();
+            worldA.destroyRigidBody(body);
+            worldB.destroyRigidBody(ghost);
+            RigidBody* migratedBody = worldB.loadRigidBody(bodyData.data(), bodyData.size(), shapes, 2);
+            rp3d_test(migratedBody != nullptr);
+            rp3d_test(migratedBody->getType() == BodyType::DYNAMIC);
+            rp3d_test(migratedBody->getTransform() == transform);
+            rp3d_test(migratedBody->getLinearVelocity() == linearVelocity);
+            rp3d_test(worldA.getNbRigidBodies() == 1);
+            rp3d_test(worldB.getNbRigidBodies() == 2);
+
+            // The migrated body keeps being simulated in the other world
+            for (uint i=0; i < 30; i++) {
+                worldB.update(decimal(1.0) / decimal(60.0));
+            }
+            rp3d_test(migratedBody->getTransform().getPosition().y < transform.getPosition().y);
+
+            // A body is not loaded if it is truncated or refers to a missing shape
+            rp3d_test(worldB.loadRigidBody(bodyData.data(), bodyData.size() - 1, shapes, 2) == nullptr);
+            rp3d_test(worldB.loadRigidBody(bodyData.data(), bodyData.size(), shapes, 0) == nullptr);
+            rp3d_test(worldB.getNbRigidBodies() == 2);
+        }
+
+        void testQuantizedMotions() {
+
+            DynamicsWorld world(Vector3(0, decimal(-9.81), 0));
+            DynamicsWorld replicaWorld(Vector3(0, decimal(-9.81), 0));
+            RigidBody* bodies[4];
+            RigidBody* replicas[4];
+            for (uint i=0; i < 4; i++) {
+                const Quaternion orientation = Quaternion::fromEulerAngles(decimal(0.3) * i, decimal(-0.7), decimal(1.1) * i);
+                const Transform transform(Vector3(decimal(3.0) * i, 10, decimal(-0.25)), orientation);
+                bodies[i] = world.createRigidBody(transform);
+                bodies[i]->addCollisionShape(mBoxShape, Transform::identity(), decimal(1.0));
+                bodies[i]->setAngularVelocity(Vector3(decimal(0.5) * i, 0, 1));
+                replicas[i] = replicaWorld.createRigidBody(Transform::identity());
+                replicas[i]->setType(BodyType::KINEMATIC);
+            }
+            bodies[3]->setType(BodyType::STATIC);
+
+            MotionQuantization quantization;
+            quantization.positionPrecision = decimal(0.01);
+
+            // The quantized motions are smaller than the exact ones
+            const size_t size = world.getMotionsSizeInBytes(bodies, 4, nullptr, &quantization);
+            rp3d_test(size < world.getMotionsSizeInBytes(bodies, 4));
+            std::vector<unsigned char> baseline(size);
+            world.saveMotions(bodies, 4, baseline.data(), nullptr, &quantization);
+            rp3d_test(replicaWorld.restoreMotions(replicas, 4, baseline.data(), size));
+
+            // The restored motions are the original ones within the precisions
+            auto isSameMotion = [](const RigidBody* body, const RigidBody* replica) {
+                const Quaternion& orientation1 = body->getTransform().getOrientation();
+                const Quaternion& orientation2 = replica->getTransform().getOrientation();
+                const decimal orientationDot = std::abs(orientation1.dot(orientation2));
+                return (body->getTransform().getPosition() - replica->getTransform().getPosition()).length() < decimal(0.01) &&
+                       orientationDot > decimal(0.99999) &&
+                       (body->getLinearVelocity() - replica->getLinearVelocity()).length() < decimal(0.002) &&
+                       (body->getAngularVelocity() - replica->getAngularVelocity()).length() < decimal(0.002);
+            };
+            bool isSame = true;
+            for (uint i=0; i < 4; i++) {
+                isSame &= isSameMotion(bodies[i], replicas[i]);
+            }
+            rp3d_test(isSame);
+
+            // A motion that changes by less than the precision is not written
+            bodies[0]->setTransform(Transform(bodies[0]->getTransform().getPosition() + Vector3(decimal(0.001), 0, 0),
+                                              bodies[0]->getTransform().getOrientation()));
+            bodies[0]->setAngularVelocity(bodies[0]->getAngularVelocity());
+            rp3d_test(world.getMotionsSizeInBytes(bodies, 4, baseline.data(), &quantization) <
+                      world.getMotionsSizeInBytes(bodies, 4, nullptr, &quantization));
+
+            // After a step, only the moving bodies are written (the static body is not)
+            world.update(decimal(1.0) / decimal(60.0));
+            const size_t deltaSize = world.getMotionsSizeInBytes(bodies, 4, baseline.data(), &quantization);
+            std::vector<unsigned char> delta(deltaSize);
+            world.saveMotions(bodies, 4, delta.data(), baseline.data(), &quantization);
+            rp3d_test(deltaSize < size);
+            rp3d_test(replicaWorld.restoreMotions(replicas, 4, delta.data(), deltaSize));
+            isSame = true;
+            for (uint i=0; i < 4; i++) {
+                isSame &= isSameMotion(bodies[i], replicas[i]);
+            }
+            rp3d_test(isSame);
+
+            // A baseline with another quantization is ignored
+            MotionQuantization otherQuantization;
+            rp3d_test(world.getMotionsSizeInBytes(bodies, 4, baseline.data(), &otherQuantization) == size);
+        }
+
+        void testInterpolatedTransforms() {
+
+            WorldSettings settings;
+            settings.isTransformInterpolationEnabled = true;
+            DynamicsWorld world(Vector3(0, decimal(-9.81), 0), settings);
+            RigidBody* floor = world.createRigidBody(Transform(Vector3(0, -1, 0), Quaternion::identity()));
+            floor->setType(BodyType::STATIC);
+            floor->addCollisionShape(mFloorShape, Transform::identity(), decimal(1.0));
+            RigidBody* body = world.createRigidBody(Transform(Vector3(0, 5, 0), Quaternion::identity()));
+            body->addCollisionShape(mBoxShape, Transform::identity(), decimal(1.0));
+            body->setAngularVelocity(Vector3(0, 2, 0));
+
+            for (uint i=0; i < 10; i++) {
+                world.update(decimal(1.0) / decimal(60.0));
+            }
+            const Transform previousTransform = body->getPreviousTransform();
+            rp3d_test(previousTransform.getPosition().y > body->getTransform().getPosition().y);
+
+            // The interpolated transforms go from the previous to the current transforms
+            Transform transforms[2];
+            world.getInterpolatedTransforms(decimal(0.0), transforms);
+            rp3d_test(transforms[0] == floor->getTransform());
+            rp3d_test(approxEqual(transforms[1].getPosition(), previousTransform.getPosition(), decimal(0.0001)));
+            world.getInterpolatedTransforms(decimal(1.0), transforms);
+            rp3d_test(approxEqual(transforms[1].getPosition(), body->getTransform().getPosition(), decimal(0.0001)));
+            rp3d_test(std::abs(transforms[1].getOrientation().dot(body->getTransform().getOrientation())) > decimal(0.99999));
+            world.getInterpolatedTransforms(decimal(0.5), transforms);
+            const Vector3 middle = (previousTransform.getPosition() + body->getTransform().getPosition()) * decimal(0.5);
+            rp3d_test(approxEqual(transforms[1].getPosition(), middle, decimal(0.0001)));
+            rp3d_test(transforms[0] == floor->getTransform());
+
+            // The render transforms are packed floats with the same interpolation
+            float renderTransforms[16];
+            world.getRenderTransforms(decimal(0.5), renderTransforms);
+            rp3d_test(approxEqual(decimal(renderTransforms[9]), middle.y, decimal(0.0001)));
+            rp3d_test(renderTransforms[11] == 0.0f);
+            rp3d_test(approxEqual(decimal(renderTransforms[13]), transforms[1].getOrientation().y, decimal(0.0001)));
+            rp3d_test(approxEqual(decimal(renderTransforms[15]), transforms[1].getOrientation().w, decimal(0.0001)));
+            rp3d_test(renderTransforms[1] == -1.0f && renderTransforms[7] == 1.0f);
+            body->setIsSleeping(true);
+            world.getRenderTransforms(decimal(0.5), renderTransforms);
+            rp3d_test(renderTransforms[11] == 1.0f);
+            body->setIsSleeping(false);
+
+            // The previous transforms are moved with the origin of the world
+            world.shiftOrigin(Vector3(10, 0, 0));
+            rp3d_test(approxEqual(body->getPreviousTransform().getPosition(),
+                                  previousTransform.getPosition() - Vector3(10, 0, 0), decimal(0.0001)));
+        }
+
+        void testCreateRigidBodies() {
+
+            DynamicsWorld world(Vector3(0, decimal(-9.81), 0));
+            DynamicsWorld batchWorld(Vector3(0, decimal(-9.81), 0));
+
+            // Create the same floor and grid of falling boxes one by one and in a batch
+            List<RigidBodyInfo> infos(MemoryManager::getBaseAllocator());
+            RigidBodyInfo floorInfo(Transform(Vector3(0, -1, 0), Quaternion::identity()), mFloorShape);
+            floorInfo.type = BodyType::STATIC;
+            infos.add(floorInfo);
+            for (int i=0; i < 64; i++) {
+                const Vector3 position(decimal(i % 8) * decimal(1.5) - decimal(5.0), decimal(1.0) + decimal(0.25) * decimal(i % 3),
+                                       decimal(i / 8) * decimal(1.5) - decimal(5.0));
+                infos.add(RigidBodyInfo(Transform(position, Quaternion::identity()), mBoxShape, decimal(2.0)));
+            }
+
+            List<RigidBody*> bodies(MemoryManager::getBaseAllocator());
+            for (uint i=0; i < infos.size(); i++) {
+                RigidBody* body = world.createRigidBody(infos[i].transform);
+                body->setType(infos[i].type);
+                body->addCollisionShape(infos[i].collisionShape, infos[i].shapeTransform, infos[i].mass);
+                bodies.add(body);
+            }
+
+            List<RigidBody*> batchBodies(MemoryManager::getBaseAllocator(), infos.size());
+            for (uint i=0; i < infos.size(); i++) {
+                batchBodies.add(nullptr);
+            }
+            batchWorld.createRigidBodies(&(infos[0]), infos.size(), &(batchBodies[0]));
+
+            rp3d_test(batchWorld.getNbRigidBodies() == infos.size());
+            rp3d_test(batchBodies[0]->getType() == BodyType::STATIC);
+            bool isSameBody = true;
+            for (uint i=0; i < infos.size(); i++) {
+                isSameBody &= batchBodies[i]->getId() == bodies[i]->getId();
+                isSameBody &= batchBodies[i]->getMass() == bodies[i]->getMass();
+                isSameBody &= batchBodies[i]->getProxyShapesList() != nullptr;
+                isSameBody &= batchBodies[i]->getTransform().getPosition() == bodies[i]->getTransform().getPosition();
+            }
+            rp3d_test(isSameBody);
+
+            // The shapes of the batch are in the broad-phase
+            const AABB aabb(Vector3(-3, 0, -3), Vector3(3, 2, 3));
+            BodyOverlapCallback callback;
+            BodyOverlapCallback batchCallback;
+            world.testAABBOverlap(aabb, &callback);
+            batchWorld.testAABBOverlap(aabb, &batchCallback);
+            rp3d_test(!batchCallback.bodies.empty());
+            rp3d_test(callback.bodies.size() == batchCallback.bodies.size());
+
+            for (uint i=0; i < 120; i++) {
+                world.update(decimal(1.0) / decimal(60.0));
+                batchWorld.update(decimal(1.0) / decimal(60.0));
+            }
+
+            // The boxes rest on the floor in the two worlds
+            for (uint i=1; i < bodies.size(); i++) {
+                rp3d_test(approxEqual(batchBodies[i]->getTransform().getPosition().y, decimal(0.5), decimal(0.02)));
+                rp3d_test(approxEqual(bodies[i]->getTransform().getPosition().y,
+                                      batchBodies[i]->getTransform().getPosition().y, decimal(0.02)));
+            }
+
+            // The bodies of the batch can be destroyed one by one and with the world
+            for (uint i=0; i < batchBodies.size(); i += 2) {
+                batchWorld.destroyRigidBody(batchBodies[i]);
+            }
+            rp3d_test(batchWorld.getNbRigidBodies() == infos.size() / 2);
+            batchWorld.update(decimal(1.0) / decimal(60.0));
+        }
+
+        void testSpatialGroups() {
+
+            DynamicsWorld world(Vector3(0, decimal(-9.81), 0));
+            BoxShape tileShape(Vector3(2, 1, 2));
+
+            // A static floor far from the chunk so that the trees are not empty
+            RigidBody* farFloor = world.createRigidBody(Transform(Vector3(200, -1, 0), Quaternion::identity()));
+            farFloor->setType(BodyType::STATIC);
+            farFloor->addCollisionShape(mFloorShape, Transform::identity(), decimal(1.0));
+
+            // Load a chunk of static tiles as a spatial group
+            List<RigidBodyInfo> infos(MemoryManager::getBaseAllocator());
+            for (int i=0; i < 16; i++) {
+                RigidBodyInfo info(Transform(Vector3(decimal(i % 4) * 4 - 6, -1, decimal(i / 4) * 4 - 6),
+                                             Quaternion::identity()), &tileShape);
+                info.type = BodyType::STATIC;
+                infos.add(info);
+            }
+            List<RigidBody*> tiles(MemoryManager::getBaseAllocator(), infos.size());
+            for (uint i=0; i < infos.size(); i++) {
+                tiles.add(nullptr);
+            }
+            world.createRigidBodies(&(infos[0]), infos.size(), &(tiles[0]), true);
+            rp3d_test(world.getNbRigidBodies() == infos.size() + 1);
+
+            // Boxes fall on the tiles of the chunk
+            List<RigidBody*> boxes(MemoryManager::getBaseAllocator());
+            for (int i=0; i < 9; i++) {
+                RigidBody* box = world.createRigidBody(Transform(Vector3(decimal(i % 3) * 3 - 3, 1,
+                                                                         decimal(i / 3) * 3 - 3), Quaternion::identity()));
+                box->addCollisionShape(mBoxShape, Transform::identity(), decimal(1.0));
+                boxes.add(box);
+            }
+
+            // The shapes of the group are in the broad-phase
+            BodyOverlapCallback callback;
+            world.testAABBOverlap(AABB(Vector3(-8, -2, -8), Vector3(8, decimal(-0.5), 8)), &callback);
+            rp3d_test(callback.bodies.size() == infos.size());
+
+            for (uint i=0; i < 120; i++) {
+                world.update(decimal(1.0) / decimal(60.0));
+            }
+            for (uint i=0; i < boxes.size(); i++) {
+                rp3d_test(approxEqual(boxes[i]->getTransform().getPosition().y, decimal(0.5), decimal(0.02)));
+            }
+
+            // Unload the chunk: the boxes are woken up and fall
+            world.destroyRigidBodies(&(tiles[0]), tiles.size());
+            rp3d_test(world.getNbRigidBodies() == boxes.size() + 1);
+            for (uint i=0; i < boxes.size(); i++) {
+                boxes[i]->setIsSleeping(false);
+            }
+            for (uint i=0; i < 30; i++) {
+                world.update(decimal(1.0) / decimal(60.0));
+            }
+            for (uint i=0; i < boxes.size(); i++) {
+                rp3d_test(boxes[i]->getTransform().getPosition().y < decimal(0.0));
+            }
+        }
+
+        void simulateIndependentWorld(const WorldSettings& settings, Vector3& position) {
+
+            DynamicsWorld world(Vector3(0, decimal(-9.81), 0), settings);
+            List<RigidBody*> bodies(MemoryManager::getBaseAllocator());
+            createScene(world, bodies);
+
+            for (uint i=0; i < 60; i++) {
+                world.update(decimal(1.0) / decimal(60.0));
+            }
+
+            position = bodies[bodies.size() / 2]->getTransform().getPosition();
+        }
+
+        void testIndependentWorldsOnThreads() {
+
+            // Reference simulation on the calling thread
+            WorldSettings settings;
+            Vector3 referencePosition;
+            simulateIndependentWorld(settings, referencePosition);
+
+            // Each world has its own allocators and can be created and stepped on its own thread
+            const uint nbWorlds = 4;
+            Vector3 positions[nbWorlds];
+            std::thread threads[nbWorlds];
+            for (uint w=0; w < nbWorlds; w++) {
+                threads[w] = std::thread([&, w]() { simulateIndependentWorld(settings, positions[w]); });
+            }
+            for (uint w=0; w < nbWorlds; w++) {
+                threads[w].join();
+            }
+
+            for (uint w=0; w < nbWorlds; w++) {
+                rp3d_test(positions[w] == referencePosition);
+            }
+
+            // The pool and single frame allocators can also be given to the world
+            DefaultPoolAllocator poolAllocator;
+            DefaultSingleFrameAllocator frameAllocator;
+            WorldSettings allocatorsSettings;
+            allocatorsSettings.poolAllocator = &poolAllocator;
+            allocatorsSettings.singleFrameAllocator = &frameAllocator;
+            Vector3 position;
+            simulateIndependentWorld(allocatorsSettings, position);
+            rp3d_test(position == referencePosition);
+        }
+};
+
+}
+
+#endif
@@ -0,0 +1,145 @@
+/********************************************************************************
+* ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
+* Copyright (c) 2010-2018 Daniel Chappuis                                       *
+*********************************************************************************
+*                                                                               *
+* This software is provided 'as-is', without any express or implied warranty.   *
+* In no event will the authors be held liable for any damages arising from the  *
+* use of this software.                                                         *
+*                                                                               *
+* Permission is granted to anyone to use this software for any purpose,         *
+* including commercial applications, and to alter it and redistribute it        *
+* freely, subject to the following restrictions:                                *
+*                                                                               *
+* 1. The origin of this software must not be misrepresented; you must not claim *
+*    that you wrote the original software. If you use this software in a        *
+*    product, an acknowledgment in the product documentation would be           *
+*    appreciated but is not required.                                           *
+*                                                                               *
+* 2. Altered source versions must be plainly marked as such, and must not be    *
+*    misrepresented as being the original software.                             *
+*                                                                               *
+* 3. This notice may not be removed or altered from any source distribution.    *
+*                                                                               *
+********************************************************************************/
+
+#ifndef TEST_FIXED_STEP_SCHEDULER_H
+#define TEST_FIXED_STEP_SCHEDULER_H
+
+// Libraries
+#include "Test.h"
+#include "reactphysics3d.h"
+
+/// Reactphysics3D namespace
+namespace reactphysics3d {
+
+// Class TestFixedStepScheduler
+/**
+ * Unit test for the FixedStepScheduler class
+ */
+class TestFixedStepScheduler : public Test {
+
+    private :
+
+        // ---------- Atributes ---------- //
+
+        BoxShape mBoxShape;
+
+    public :
+
+        // ---------- Methods ---------- //
+
+        /// Constructor
+        TestFixedStepScheduler(const std::string& name)
+            : Test(name), mBoxShape(Vector3(decimal(0.5), decimal(0.5), decimal(0.5))) {
+
+        }
+
+        /// Run the tests
+        void run() {
+
+            testFixedSteps();
+            testMaxNbStepsPerFrame();
+            testFrameTimeBudget();
+        }
+
+        void testFixedSteps() {
+
+            DynamicsWorld world(Vector3(0, decimal(-9.81), 0));
+            RigidBody* body = world.createRigidBody(Transform(Vector3(0, 10, 0), Quaternion::identity()));
+            body->addCollisionShape(&mBoxShape, Transform::identity(), decimal(1.0));
+
+            FixedStepScheduler scheduler(&world, decimal(0.01));
+            scheduler.setFrameTimeBudget(0.0);
+            rp3d_test(scheduler.getTimeStep() == decimal(0.01));
+
+            // The elapsed time is accumulated until a whole time step is available
+            rp3d_test(scheduler.update(0.005) == 0);
+            rp3d_test(approxEqual(scheduler.computeInterpolationFactor(), decimal(0.5), decimal(0.0001)));
+            rp3d_test(scheduler.update(0.025) == 3);
+            rp3d_test(scheduler.getNbStepsLastFrame() == 3);
+            rp3d_test(approxEqual(scheduler.computeInterpolationFactor(), decimal(0.0), decimal(0.0001)));
+            rp3d_test(!scheduler.isBehind());
+            rp3d_test(scheduler.getNbDroppedSteps() == 0);
+            rp3d_test(scheduler.getAverageStepCost() > 0.0);
+            rp3d_test(body->getTransform().getPosition().y < decimal(10.0));
+        }
+
+        void testMaxNbStepsPerFrame() {
+
+            DynamicsWorld world(Vector3(0, decimal(-9.81), 0));
+            RigidBody* body = world.createRigidBody(Transform(Vector3(0, 10, 0), Quaternion::identity()));
+            body->addCollisionShape(&mBoxShape, Transform::identity(), decimal(1.0));
+            const uint nbIterationsVelocity = world.getNbIterationsVelocitySolver();
+            const uint nbIterationsPosition = world.getNbIterationsPositionSolver();
+
+            FixedStepScheduler scheduler(&world, decimal(0.01));
+            scheduler.setFrameTimeBudget(0.0);
+            scheduler.setMaxNbStepsPerFrame(4);
+            scheduler.setMinNbSolverIterations(nbIterationsVelocity - 2, nbIterationsPosition - 2);
+
+            // A long frame only runs the maximum number of steps and the remaining time is dropped
+            rp3d_test(scheduler.update(0.1) == 4);
+            rp3d_test(scheduler.isBehind());
+            rp3d_test(scheduler.getNbDroppedSteps() == 6);
+            rp3d_test(approxEqual(decimal(scheduler.getTimeDilation()), decimal(0.4), decimal(0.0001)));
+            rp3d_test(scheduler.computeInterpolationFactor() < decimal(1.0));
+            rp3d_test(world.getNbIterationsVelocitySolver() == nbIterationsVelocity - 1);
+            rp3d_test(world.getNbIterationsPositionSolver() == nbIterationsPosition - 1);
+
+            // The time is not carried over and the solver iterations do not go below the minimum
+            rp3d_test(scheduler.update(0.1) == 4);
+            rp3d_test(scheduler.update(0.1) == 4);
+            rp3d_test(world.getNbIterationsVelocitySolver() == nbIterationsVelocity - 2);
+            rp3d_test(world.getNbIterationsPositionSolver() == nbIterationsPosition - 2);
+
+            // The solver iterations go back to their nominal values when the scheduler has caught up
+            for (uint i=0; i < 3; i++) {
+                rp3d_test(scheduler.update(0.01) == 1);
+                rp3d_test(!scheduler.isBehind());
+            }
+            rp3d_test(approxEqual(decimal(scheduler.getTimeDilation()), decimal(1.0), decimal(0.0001)));
+            rp3d_test(world.getNbIterationsVelocitySolver() == nbIterationsVelocity);
+            rp3d_test(world.getNbIterationsPositionSolver() == nbIterationsPosition);
+        }
+
+        void testFrameTimeBudget() {
+
+            DynamicsWorld world(Vector3(0, decimal(-9.81), 0));
+            RigidBody* body = world.createRigidBody(Transform(Vector3(0, 10, 0), Quaternion::identity()));
+            body->addCollisionShape(&mBoxShape, Transform::identity(), decimal(1.0));
+
+            // With a tiny time budget, a single step is taken per frame to guarantee progress
+            FixedStepScheduler scheduler(&world, decimal(0.01));
+            scheduler.setFrameTimeBudget(1.0e-12);
+            rp3d_test(scheduler.getFrameTimeBudget() == 1.0e-12);
+            rp3d_test(scheduler.getMaxNbStepsPerFrame() == 4);
+            rp3d_test(scheduler.update(0.03) == 1);
+            rp3d_test(scheduler.isBehind());
+            rp3d_test(scheduler.getNbDroppedSteps() == 2);
+        }
+};
+
+}
+
+#endif
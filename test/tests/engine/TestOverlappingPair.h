@@ -0,0 +1,178 @@
+/********************************************************************************
+* ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
+* Copyright (c) 2010-2018 Daniel Chappuis                                       *
+*********************************************************************************
+*                                                                               *
+* This software is provided 'as-is', without any express or implied warranty.   *
+* In no event will the authors be held liable for any damages arising from the  *
+* use of this software.                                                         *
+*                                                                               *
+* Permission is granted to anyone to use this software for any purpose,         *
+* including commercial applications, and to alter it and redistribute it        *
+* freely, subject to the following restrictions:                                *
+*                                                                               *
+* 1. The origin of this software must not be misrepresented; you must not claim *
+*    that you wrote the original software. If you use this software in a        *
+*    product, an acknowledgment in the product documentation would be           *
+*    appreciated but is not required.                                           *
+*                                                                               *
+* 2. Altered source versions must be plainly marked as such, and must not be    *
+*    misrepresented as being the original software.                             *
+*                                                                               *
+* 3. This notice may not be removed or altered from any source distribution.    *
+*                                                                               *
+********************************************************************************/
+
+#ifndef TEST_OVERLAPPING_PAIR_H
+#define TEST_OVERLAPPING_PAIR_H
+
+// Libraries
+#include "Test.h"
+#include "engine/CollisionWorld.h"
+#include "engine/OverlappingPair.h"
+#include "collision/shapes/SphereShape.h"
+#include "collision/shapes/HeightFieldShape.h"
+#include "memory/DefaultAllocator.h"
+
+/// Reactphysics3D namespace
+namespace reactphysics3d {
+
+// Class TestOverlappingPair
+/**
+ * Unit test for the last frame collision infos of the OverlappingPair class
+ */
+class TestOverlappingPair : public Test {
+
+    private :
+
+        // ---------- Atributes ---------- //
+
+        DefaultAllocator mAllocator;
+
+        WorldSettings mWorldSettings;
+
+        CollisionWorld* mWorld;
+
+        SphereShape* mSphereShape;
+
+        HeightFieldShape* mHeightFieldShape;
+
+        float mHeights[9];
+
+        ProxyShape* mSphereProxyShape1;
+
+        ProxyShape* mSphereProxyShape2;
+
+        ProxyShape* mHeightFieldProxyShape;
+
+    public :
+
+        // ---------- Methods ---------- //
+
+        /// Constructor
+        TestOverlappingPair(const std::string& name) : Test(name) {
+
+            for (int i=0; i < 9; i++) mHeights[i] = 0;
+
+            mWorld = new CollisionWorld();
+            mSphereShape = new SphereShape(1);
+            mHeightFieldShape = new HeightFieldShape(3, 3, -1, 1, mHeights, HeightFieldShape::HeightDataType::HEIGHT_FLOAT_TYPE);
+
+            CollisionBody* body1 = mWorld->createCollisionBody(Transform::identity());
+            CollisionBody* body2 = mWorld->createCollisionBody(Transform::identity());
+            CollisionBody* body3 = mWorld->createCollisionBody(Transform::identity());
+            mSphereProxyShape1 = body1->addCollisionShape(mSphereShape, Transform::identity());
+            mSphereProxyShape2 = body2->addCollisionShape(mSphereShape, Transform::identity());
+            mHeightFieldProxyShape = body3->addCollisionShape(mHeightFieldShape, Transform::identity());
+        }
+
+        /// Destructor
+        virtual ~TestOverlappingPair() {
+
+            delete mWorld;
+            delete mSphereShape;
+            delete mHeightFieldShape;
+        }
+
+        /// Run the tests
+        void run() {
+
+            testConvexPair();
+            testConcavePair();
+        }
+
+        /// Test the single last frame collision info of a convex pair
+        void testConvexPair() {
+
+            OverlappingPair pair(mSphereProxyShape1, mSphereProxyShape2, mAllocator, mAllocator, mWorldSettings);
+            const uint id1 = mSphereShape->getId();
+
+            rp3d_test(pair.getLastFrameCollisionInfo(id1, id1) == nullptr);
+
+            pair.addLastFrameInfoIfNecessary(id1, id1);
+            LastFrameCollisionInfo* info = pair.getLastFrameCollisionInfo(id1, id1);
+            rp3d_test(info != nullptr);
+            rp3d_test(!info->isValid);
+            info->isValid = true;
+
+            // The info used during the frame is kept
+            pair.makeLastFrameCollisionInfosObsolete();
+            pair.addLastFrameInfoIfNecessary(id1, id1);
+            pair.clearObsoleteLastFrameCollisionInfos();
+            rp3d_test(pair.getLastFrameCollisionInfo(id1, id1) == info);
+            rp3d_test(info->isValid);
+
+            // The info not used during the frame is removed
+            pair.makeLastFrameCollisionInfosObsolete();
+            pair.clearObsoleteLastFrameCollisionInfos();
+            rp3d_test(pair.getLastFrameCollisionInfo(id1, id1) == nullptr);
+
+            // A new info starts without data of the previous frames
+            pair.addLastFrameInfoIfNecessary(id1, id1);
+            rp3d_test(!pair.getLastFrameCollisionInfo(id1, id1)->isValid);
+        }
+
+        /// Test the sorted last frame collision infos of a concave pair
+        void testConcavePair() {
+
+            OverlappingPair pair(mSphereProxyShape1, mHeightFieldProxyShape, mAllocator, mAllocator, mWorldSettings);
+            const uint id1 = mSphereShape->getId();
+
+            // Add the infos of the triangles in an arbitrary order
+            const uint triangleIds[8] = {5, 2, 7, 0, 3, 6, 1, 4};
+            for (int i=0; i < 8; i++) {
+                pair.addLastFrameInfoIfNecessary(id1, triangleIds[i]);
+                pair.getLastFrameCollisionInfo(id1, triangleIds[i])->gjkSupportVertex1 = triangleIds[i];
+            }
+
+            bool areAllInfosFound = true;
+            for (uint i=0; i < 8; i++) {
+                LastFrameCollisionInfo* info = pair.getLastFrameCollisionInfo(id1, i);
+                areAllInfosFound &= info != nullptr && info->gjkSupportVertex1 == i;
+            }
+            rp3d_test(areAllInfosFound);
+            rp3d_test(pair.getLastFrameCollisionInfo(id1, 8) == nullptr);
+            rp3d_test(pair.getLastFrameCollisionInfo(id1 + 1, 0) == nullptr);
+
+            // Only the infos of the even triangles are used during the next frame
+            pair.makeLastFrameCollisionInfosObsolete();
+            for (uint i=0; i < 8; i += 2) {
+                pair.addLastFrameInfoIfNecessary(id1, i);
+            }
+            pair.addLastFrameInfoIfNecessary(id1, 9);
+            pair.clearObsoleteLastFrameCollisionInfos();
+
+            bool areInfosKept = true;
+            for (uint i=0; i < 8; i++) {
+                LastFrameCollisionInfo* info = pair.getLastFrameCollisionInfo(id1, i);
+                areInfosKept &= (i % 2 == 0) ? (info != nullptr && info->gjkSupportVertex1 == i) : info == nullptr;
+            }
+            rp3d_test(areInfosKept);
+            rp3d_test(pair.getLastFrameCollisionInfo(id1, 9) != nullptr);
+            rp3d_test(pair.getLastFrameCollisionInfo(id1, 9)->gjkSupportVertex1 == 0);
+        }
+ };
+
+}
+
+#endif
@@ -0,0 +1,160 @@
+/********************************************************************************
+* ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
+* Copyright (c) 2010-2018 Daniel Chappuis                                       *
+*********************************************************************************
+*                                                                               *
+* This software is provided 'as-is', without any express or implied warranty.   *
+* In no event will the authors be held liable for any damages arising from the  *
+* use of this software.                                                         *
+*                                                                               *
+* Permission is granted to anyone to use this software for any purpose,         *
+* including commercial applications, and to alter it and redistribute it        *
+* freely, subject to the following restrictions:                                *
+*                                                                               *
+* 1. The origin of this software must not be misrepresented; you must not claim *
+*    that you wrote the original software. If you use this software in a        *
+*    product, an acknowledgment in the product documentation would be           *
+*    appreciated but is not required.                                           *
+*                                                                               *
+* 2. Altered source versions must be plainly marked as such, and must not be    *
+*    misrepresented as being the original software.                             *
+*                                                                               *
+* 3. This notice may not be removed or altered from any source distribution.    *
+*                                                                               *
+********************************************************************************/
+
+#ifndef TEST_OVERLAPPING_PAIR_CACHE_H
+#define TEST_OVERLAPPING_PAIR_CACHE_H
+
+// Libraries
+#include "Test.h"
+#include "engine/OverlappingPairCache.h"
+#include "memory/DefaultAllocator.h"
+#include <cstdint>
+
+/// Reactphysics3D namespace
+namespace reactphysics3d {
+
+// Class TestOverlappingPairCache
+/**
+ * Unit test for the OverlappingPairCache class
+ */
+class TestOverlappingPairCache : public Test {
+
+    private :
+
+        // ---------- Atributes ---------- //
+
+        DefaultAllocator mAllocator;
+
+        // ---------- Methods ---------- //
+
+        /// Return a fake pair pointer for a key (the cache never dereferences the pairs)
+        static OverlappingPair* fakePair(uint64 key) {
+            return reinterpret_cast<OverlappingPair*>(static_cast<uintptr_t>(key + 1) * 8);
+        }
+
+        /// Return the key of a pair of broad-phase IDs
+        static uint64 key(uint64 id1, uint64 id2) {
+            return (id1 << 32) | id2;
+        }
+
+    public :
+
+        // ---------- Methods ---------- //
+
+        /// Constructor
+        TestOverlappingPairCache(const std::string& name) : Test(name) {
+
+        }
+
+        /// Run the tests
+        void run() {
+
+            testAddFind();
+            testStamps();
+            testRemove();
+        }
+
+        void testAddFind() {
+
+            OverlappingPairCache cache(mAllocator);
+            rp3d_test(cache.size() == 0);
+            rp3d_test(cache.find(key(0, 1)) == nullptr);
+
+            // Add enough pairs to grow the arrays and the hash table several times
+            for (uint64 i=0; i < 40; i++) {
+                for (uint64 j=i+1; j < 40; j++) {
+                    cache.add(key(i, j), fakePair(key(i, j)), 0);
+                }
+            }
+            rp3d_test(cache.size() == 40 * 39 / 2);
+
+            bool areAllPairsFound = true;
+            for (uint64 i=0; i < 40; i++) {
+                for (uint64 j=i+1; j < 40; j++) {
+                    areAllPairsFound &= cache.find(key(i, j)) == fakePair(key(i, j));
+                }
+            }
+            rp3d_test(areAllPairsFound);
+            rp3d_test(cache.find(key(40, 41)) == nullptr);
+            rp3d_test(cache.find(key(1, 0)) == nullptr);
+        }
+
+        void testStamps() {
+
+            OverlappingPairCache cache(mAllocator);
+            cache.add(key(1, 2), fakePair(key(1, 2)), 3);
+            cache.add(key(1, 3), fakePair(key(1, 3)), 4);
+
+            rp3d_test(cache.getStamp(0) == 3);
+            rp3d_test(cache.getStamp(1) == 4);
+
+            rp3d_test(cache.updateStamp(key(1, 2), 7));
+            rp3d_test(!cache.updateStamp(key(2, 3), 7));
+            rp3d_test(cache.getStamp(0) == 7);
+            rp3d_test(cache.getStamp(1) == 4);
+            rp3d_test(cache.size() == 2);
+        }
+
+        void testRemove() {
+
+            OverlappingPairCache cache(mAllocator);
+            for (uint64 i=0; i < 500; i++) {
+                cache.add(key(i, i + 1), fakePair(key(i, i + 1)), i);
+            }
+
+            // Remove every other pair (the last pair is moved at the index of a removed one)
+            uint index = 0;
+            while (index < cache.size()) {
+                if (cache.getStamp(index) % 2 == 0) {
+                    cache.removeAt(index);
+                }
+                else {
+                    index++;
+                }
+            }
+            rp3d_test(cache.size() == 250);
+
+            // The remaining pairs are still found after the backward shifts of the hash table
+            bool isCacheValid = true;
+            for (uint64 i=0; i < 500; i++) {
+                OverlappingPair* pair = cache.find(key(i, i + 1));
+                isCacheValid &= (i % 2 == 0) ? pair == nullptr : pair == fakePair(key(i, i + 1));
+            }
+            for (uint i=0; i < cache.size(); i++) {
+                const uint64 stamp = cache.getStamp(i);
+                isCacheValid &= cache.getPair(i) == fakePair(key(stamp, stamp + 1));
+            }
+            rp3d_test(isCacheValid);
+
+            // A removed key can be added again
+            cache.add(key(0, 1), fakePair(key(0, 1)), 0);
+            rp3d_test(cache.find(key(0, 1)) == fakePair(key(0, 1)));
+            rp3d_test(cache.size() == 251);
+        }
+ };
+
+}
+
+#endif
@@ -0,0 +1,258 @@
+/********************************************************************************
+* ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
+* Copyright (c) 2010-2018 Daniel Chappuis                                       *
+*********************************************************************************
+*                                                                               *
+* This software is provided 'as-is', without any express or implied warranty.   *
+* In no event will the authors be held liable for any damages arising from the  *
+* use of this software.                                                         *
+*                                                                               *
+* Permission is granted to anyone to use this software for any purpose,         *
+* including commercial applications, and to alter it and redistribute it        *
+* freely, subject to the following restrictions:                                *
+*                                                                               *
+* 1. The origin of this software must not be misrepresented; you must not claim *
+*    that you wrote the original software. If you use this software in a        *
+*    product, an acknowledgment in the product documentation would be           *
+*    appreciated but is not required.                                           *
+*                                                                               *
+* 2. Altered source versions must be plainly marked as such, and must not be    *
+*    misrepresented as being the original software.                             *
+*                                                                               *
+* 3. This notice may not be removed or altered from any source distribution.    *
+*                                                                               *
+********************************************************************************/
+
+#ifndef TEST_PARTICLE_SYSTEM_H
+#define TEST_PARTICLE_SYSTEM_H
+
+// Libraries
+#include "Test.h"
+#include "reactphysics3d.h"
+
+/// Reactphysics3D namespace
+namespace reactphysics3d {
+
+// Class TestParticleSystem
+/**
+ * Unit test for the ParticleSystem class
+ */
+class TestParticleSystem : public Test {
+
+    private :
+
+        // ---------- Atributes ---------- //
+
+        BoxShape mFloorShape;
+
+    public :
+
+        // ---------- Methods ---------- //
+
+        /// Constructor
+        TestParticleSystem(const std::string& name)
+            : Test(name), mFloorShape(Vector3(10, decimal(0.1), 10)) {
+
+        }
+
+        /// Run the tests
+        void run() {
+
+            testAddAndRemoveParticles();
+            testParticleCollisions();
+            testParticlesOnFloor();
+            testFastParticles();
+            testParallelParticles();
+        }
+
+        /// Create a static floor whose top face is at y = 0
+        void createFloor(DynamicsWorld& world) {
+            RigidBody* floor = world.createRigidBody(Transform(Vector3(0, decimal(-0.1), 0), Quaternion::identity()));
+            floor->setType(BodyType::STATIC);
+            floor->addCollisionShape(&mFloorShape, Transform::identity(), decimal(1.0));
+        }
+
+        void testAddAndRemoveParticles() {
+
+            DynamicsWorld world(Vector3(0, decimal(-9.81), 0));
+
+            ParticleSystem* particles = world.createParticleSystem();
+            rp3d_test(world.getNbParticleSystems() == 1);
+            rp3d_test(world.getParticleSystem(0) == particles);
+
+            // Enough particles to grow the arrays several times
+            for (uint i=0; i < 200; i++) {
+                rp3d_test(particles->addParticle(Vector3(decimal(i), 0, 0), Vector3(0, decimal(i), 0)) == i);
+            }
+            rp3d_test(particles->getNbParticles() == 200);
+            rp3d_test(particles->getPosition(150) == Vector3(150, 0, 0));
+            rp3d_test(particles->getVelocities()[150] == Vector3(0, 150, 0));
+            rp3d_test(!particles->isInContact(150));
+
+            // The last particle is moved at the index of the removed particle
+            particles->removeParticle(10);
+            rp3d_test(particles->getNbParticles() == 199);
+            rp3d_test(particles->getPositions()[10] == Vector3(199, 0, 0));
+            rp3d_test(particles->getVelocity(10) == Vector3(0, 199, 0));
+
+            particles->clear();
+            rp3d_test(particles->getNbParticles() == 0);
+
+            ParticleSystem* otherParticles = world.createParticleSystem();
+            world.destroyParticleSystem(particles);
+            rp3d_test(world.getNbParticleSystems() == 1);
+            rp3d_test(world.getParticleSystem(0) == otherParticles);
+        }
+
+        void testParticleCollisions() {
+
+            DynamicsWorld world(Vector3(0, 0, 0));
+
+            ParticleSystemSettings settings;
+            settings.radius = decimal(0.05);
+            ParticleSystem* particles = world.createParticleSystem(settings);
+
+            // Two overlapping particles are pushed apart by the same distance
+            particles->addParticle(Vector3(decimal(-0.02), 0, 0));
+            particles->addParticle(Vector3(decimal(0.03), 0, 0));
+
+            // A particle far from the others is not moved
+            particles->addParticle(Vector3(5, 5, 5));
+
+            world.update(decimal(1.0) / decimal(60.0));
+
+            const Vector3& position1 = particles->getPosition(0);
+            const Vector3& position2 = particles->getPosition(1);
+            rp3d_test(approxEqual((position2 - position1).length(), decimal(0.1), decimal(0.001)));
+            rp3d_test(approxEqual(position1.x + position2.x, decimal(0.01), decimal(0.0001)));
+            rp3d_test(particles->getVelocity(0).x < decimal(0.0));
+            rp3d_test(particles->getVelocity(1).x > decimal(0.0));
+            rp3d_test(particles->getPosition(2) == Vector3(5, 5, 5));
+
+            // Without collisions between the particles, the particles are not moved
+            settings.isParticleCollisionEnabled = false;
+            ParticleSystem* ghostParticles = world.createParticleSystem(settings);
+            ghostParticles->addParticle(Vector3(decimal(-0.02), 0, 0));
+            ghostParticles->addParticle(Vector3(decimal(0.03), 0, 0));
+
+            world.update(decimal(1.0) / decimal(60.0));
+
+            rp3d_test(ghostParticles->getPosition(0) == Vector3(decimal(-0.02), 0, 0));
+            rp3d_test(ghostParticles->getPosition(1) == Vector3(decimal(0.03), 0, 0));
+        }
+
+        void testParticlesOnFloor() {
+
+            DynamicsWorld world(Vector3(0, decimal(-9.81), 0));
+            createFloor(world);
+
+            ParticleSystemSettings settings;
+            settings.radius = decimal(0.05);
+            ParticleSystem* particles = world.createParticleSystem(settings);
+
+            // Falling particles and a particle sliding on the floor
+            for (uint i=0; i < 10; i++) {
+                particles->addParticle(Vector3(decimal(i) * decimal(0.5) - decimal(2.5), decimal(1.0), 0));
+            }
+            particles->addParticle(Vector3(0, decimal(0.05), 2), Vector3(decimal(1.0), 0, 0));
+
+            for (uint i=0; i < 120; i++) {
+                world.update(decimal(1.0) / decimal(60.0));
+            }
+
+            // The particles rest on the floor
+            bool isOnFloor = true;
+            for (uint i=0; i < particles->getNbParticles(); i++) {
+                isOnFloor &= approxEqual(particles->getPosition(i).y, settings.radius, decimal(0.01));
+                isOnFloor &= particles->getVelocity(i).length() < decimal(0.2);
+                isOnFloor &= particles->isInContact(i);
+                isOnFloor &= approxEqual(particles->getContactNormal(i).y, decimal(1.0), decimal(0.001));
+            }
+            rp3d_test(isOnFloor);
+
+            // The friction has stopped the sliding particle
+            rp3d_test(particles->getPosition(10).x > decimal(0.05));
+            rp3d_test(particles->getPosition(10).x < decimal(0.5));
+        }
+
+        void testFastParticles() {
+
+            DynamicsWorld world(Vector3(0, decimal(-9.81), 0));
+            createFloor(world);
+
+            ParticleSystemSettings settings;
+            settings.radius = decimal(0.02);
+            settings.bounciness = decimal(0.5);
+            ParticleSystem* particles = world.createParticleSystem(settings);
+
+            // A projectile that crosses the thin floor within a single step
+            particles->addParticle(Vector3(0, decimal(1.0), 0), Vector3(0, decimal(-200.0), 0));
+
+            world.update(decimal(1.0) / decimal(60.0));
+
+            rp3d_test(approxEqual(particles->getPosition(0).y, settings.radius, decimal(0.001)));
+            rp3d_test(particles->getVelocity(0).y > decimal(90.0));
+            rp3d_test(particles->isInContact(0));
+
+            // The particles do not hit the shapes outside of their collision mask
+            settings.collideWithMaskBits = 0;
+            ParticleSystem* otherParticles = world.createParticleSystem(settings);
+            otherParticles->addParticle(Vector3(0, decimal(1.0), 0), Vector3(0, decimal(-200.0), 0));
+
+            world.update(decimal(1.0) / decimal(60.0));
+
+            rp3d_test(otherParticles->getPosition(0).y < decimal(-1.0));
+            rp3d_test(!otherParticles->isInContact(0));
+        }
+
+        /// Create a pile of particles falling on a floor
+        void createPile(DynamicsWorld& world, ParticleSystem*& particles) {
+
+            createFloor(world);
+
+            particles = world.createParticleSystem();
+            for (uint x=0; x < 16; x++) {
+                for (uint y=0; y < 16; y++) {
+                    for (uint z=0; z < 8; z++) {
+                        particles->addParticle(Vector3(decimal(x) * decimal(0.09), decimal(0.5) + decimal(y) * decimal(0.09),
+                                                       decimal(z) * decimal(0.09)));
+                    }
+                }
+            }
+        }
+
+        void testParallelParticles() {
+
+            DefaultTaskScheduler scheduler(4);
+
+            WorldSettings parallelSettings;
+            parallelSettings.taskScheduler = &scheduler;
+
+            DynamicsWorld sequentialWorld(Vector3(0, decimal(-9.81), 0));
+            DynamicsWorld parallelWorld(Vector3(0, decimal(-9.81), 0), parallelSettings);
+
+            ParticleSystem* sequentialParticles;
+            ParticleSystem* parallelParticles;
+            createPile(sequentialWorld, sequentialParticles);
+            createPile(parallelWorld, parallelParticles);
+
+            for (uint i=0; i < 60; i++) {
+                sequentialWorld.update(decimal(1.0) / decimal(60.0));
+                parallelWorld.update(decimal(1.0) / decimal(60.0));
+            }
+
+            // The corrections of the particles do not depend on the order of their computation
+            bool isSamePositions = true;
+            bool isAboveFloor = true;
+            for (uint i=0; i < sequentialParticles->getNbParticles(); i++) {
+                isSamePositions &= sequentialParticles->getPosition(i) == parallelParticles->getPosition(i);
+                isAboveFloor &= sequentialParticles->getPosition(i).y > decimal(0.0);
+            }
+            rp3d_test(isSamePositions);
+            rp3d_test(isAboveFloor);
+        }
+};
+
+}
+
+#endif
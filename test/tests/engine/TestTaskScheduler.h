@@ -0,0 +1,247 @@
+/********************************************************************************
+* ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
+* Copyright (c) 2010-2018 Daniel Chappuis                                       *
+*********************************************************************************
+*                                                                               *
+* This software is provided 'as-is', without any express or implied warranty.   *
+* In no event will the authors be held liable for any damages arising from the  *
+* use of this software.                                                         *
+*                                                                               *
+* Permission is granted to anyone to use this software for any purpose,         *
+* including commercial applications, and to alter it and redistribute it        *
+* freely, subject to the following restrictions:                                *
+*                                                                               *
+* 1. The origin of this software must not be misrepresented; you must not claim *
+*    that you wrote the original software. If you use this software in a        *
+*    product, an acknowledgment in the product documentation would be           *
+*    appreciated but is not required.                                           *
+*                                                                               *
+* 2. Altered source versions must be plainly marked as such, and must not be    *
+*    misrepresented as being the original software.                             *
+*                                                                               *
+* 3. This notice may not be removed or altered from any source distribution.    *
+*                                                                               *
+********************************************************************************/
+
+#ifndef TEST_TASK_SCHEDULER_H
+#define TEST_TASK_SCHEDULER_H
+
+// Libraries
+#include "Test.h"
+#include "engine/DefaultTaskScheduler.h"
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+/// Reactphysics3D namespace
+namespace reactphysics3d {
+
+// Class TestTaskScheduler
+/**
+ * Unit test for the DefaultTaskScheduler class
+ */
+class TestTaskScheduler : public Test {
+
+    public :
+
+        // ---------- Methods ---------- //
+
+        /// Constructor
+        TestTaskScheduler(const std::string& name) : Test(name) {
+
+        }
+
+        /// Run the tests
+        void run() {
+
+            testParallelFor();
+            testParallelForRange();
+            testJobs();
+            testChainedJobs();
+        }
+
+        void testParallelFor() {
+
+            DefaultTaskScheduler scheduler(4);
+            rp3d_test(scheduler.getNbWorkers() == 4);
+
+            const uint nbTasks = 1000;
+            int counters[nbTasks];
+            for (uint i=0; i < nbTasks; i++) counters[i] = 0;
+
+            // Each task must be executed exactly once
+            scheduler.parallelFor(nbTasks, [&counters](uint taskIndex) {
+                counters[taskIndex]++;
+            });
+
+            bool isEachTaskExecutedOnce = true;
+            for (uint i=0; i < nbTasks; i++) {
+                isEachTaskExecutedOnce &= counters[i] == 1;
+            }
+            rp3d_test(isEachTaskExecutedOnce);
+
+            // Tasks submitted from inside a task are executed by the calling thread
+            scheduler.parallelFor(4, [&scheduler, &counters](uint taskIndex) {
+                scheduler.parallelFor(10, [&counters, taskIndex](uint subTaskIndex) {
+                    counters[taskIndex * 10 + subTaskIndex]++;
+                });
+            });
+
+            bool isEachSubTaskExecutedOnce = true;
+            for (uint i=0; i < 40; i++) {
+                isEachSubTaskExecutedOnce &= counters[i] == 2;
+            }
+            rp3d_test(isEachSubTaskExecutedOnce);
+
+            // Nothing to do without tasks
+            scheduler.parallelFor(0, [&counters](uint taskIndex) {
+                counters[taskIndex]++;
+            });
+            rp3d_test(counters[nbTasks - 1] == 1);
+
+            // A scheduler with a single worker executes the tasks on the calling thread
+            DefaultTaskScheduler sequentialScheduler(1);
+            rp3d_test(sequentialScheduler.getNbWorkers() == 1);
+            sequentialScheduler.parallelFor(nbTasks, [&counters](uint taskIndex) {
+                counters[taskIndex]++;
+            });
+            rp3d_test(counters[0] == 3);
+            rp3d_test(counters[nbTasks - 1] == 2);
+        }
+
+        void testParallelForRange() {
+
+            DefaultTaskScheduler scheduler(4);
+
+            const uint nbItems = 1000;
+            int counters[nbItems];
+            for (uint i=0; i < nbItems; i++) counters[i] = 0;
+            std::atomic<uint> nbRanges(0);
+            std::atomic<uint> nbSmallRanges(0);
+
+            // Each item must be in exactly one range
+            scheduler.parallelForRange(nbItems, 100, [&](uint begin, uint end) {
+                for (uint i=begin; i < end; i++) counters[i]++;
+                if (end - begin < 100) nbSmallRanges++;
+                nbRanges++;
+            });
+
+            bool isEachItemExecutedOnce = true;
+            for (uint i=0; i < nbItems; i++) {
+                isEachItemExecutedOnce &= counters[i] == 1;
+            }
+            rp3d_test(isEachItemExecutedOnce);
+
+            // There is at most one range per worker
+            rp3d_test(nbRanges == 4);
+            rp3d_test(nbSmallRanges == 0);
+
+            // A small number of items is not split into small ranges
+            nbRanges = 0;
+            scheduler.parallelForRange(150, 100, [&](uint begin, uint end) {
+                for (uint i=begin; i < end; i++) counters[i]++;
+                nbRanges++;
+            });
+            rp3d_test(nbRanges == 2);
+            rp3d_test(counters[0] == 2);
+            rp3d_test(counters[149] == 2);
+            rp3d_test(counters[150] == 1);
+        }
+
+        void testJobs() {
+
+            DefaultTaskScheduler scheduler(4);
+
+            const uint nbTasks = 1000;
+            std::atomic<uint> nbExecutedTasks(0);
+            std::atomic<uint> nbJobTasks(0);
+
+            // A job can submit tasks while the calling thread submits its own tasks
+            const luint firstJobId = scheduler.startJob([&]() {
+                scheduler.parallelFor(nbTasks, [&](uint taskIndex) { nbJobTasks++; });
+            });
+            const luint secondJobId = scheduler.startJob([&]() { nbJobTasks += 10; });
+            scheduler.parallelFor(nbTasks, [&](uint taskIndex) { nbExecutedTasks++; });
+            rp3d_test(nbExecutedTasks == nbTasks);
+
+            // The jobs are finished when they have been waited for
+            scheduler.waitJob(secondJobId);
+            rp3d_test(nbJobTasks == nbTasks + 10);
+            scheduler.waitJob(firstJobId);
+
+            // The base scheduler executes the job on the calling thread
+            DefaultTaskScheduler sequentialScheduler(1);
+            const luint jobId = sequentialScheduler.TaskScheduler::startJob([&]() { nbJobTasks++; });
+            rp3d_test(nbJobTasks == nbTasks + 11);
+            sequentialScheduler.TaskScheduler::waitJob(jobId);
+        }
+
+        void testChainedJobs() {
+
+            DefaultTaskScheduler scheduler(4);
+
+            // Order in which the jobs are executed
+            std::atomic<uint> nbExecutedJobs(0);
+            uint order[6];
+            auto orderedJob = [&nbExecutedJobs, &order](uint job) {
+                return [&nbExecutedJobs, &order, job]() { order[job] = nbExecutedJobs++; };
+            };
+
+            // Diamond: job 0 before jobs 1 and 2, which are both before job 3
+            const luint job0 = scheduler.startJob([&]() {
+                std::this_thread::sleep_for(std::chrono::milliseconds(20));
+                orderedJob(0)();
+            });
+            const luint job1 = scheduler.startJob(orderedJob(1), &job0, 1);
+            const luint job2 = scheduler.startJob([&]() {
+                scheduler.parallelFor(100, [](uint taskIndex) {});
+                orderedJob(2)();
+            }, &job0, 1);
+            const luint predecessorsOfJob3[] = {job1, job2};
+            const luint job3 = scheduler.startJob(orderedJob(3), predecessorsOfJob3, 2);
+
+            // A job started after the waiting jobs is not delayed by them
+            const luint job4 = scheduler.startJob(orderedJob(4));
+
+            scheduler.waitJob(job3);
+            rp3d_test(order[0] == 0);
+            rp3d_test(order[4] == 1);
+            rp3d_test(order[1] > order[0] && order[2] > order[0]);
+            rp3d_test(order[3] == 4);
+            scheduler.waitJob(job4);
+
+            // A job whose predecessor is already finished is executed immediately
+            const luint job5 = scheduler.startJob(orderedJob(5), &job0, 1);
+            scheduler.waitJob(job5);
+            rp3d_test(order[5] == 5);
+            rp3d_test(nbExecutedJobs == 6);
+
+            // A long chain of jobs started before the first one is finished
+            const uint nbChainedJobs = 100;
+            luint previousJobId = scheduler.startJob([]() {
+                std::this_thread::sleep_for(std::chrono::milliseconds(5));
+            });
+            uint nbJobsInOrder = 0;
+            uint lastJob = 0;
+            for (uint i=1; i <= nbChainedJobs; i++) {
+                previousJobId = scheduler.startJob([&nbJobsInOrder, &lastJob, i]() {
+                    if (lastJob == i - 1) nbJobsInOrder++;
+                    lastJob = i;
+                }, &previousJobId, 1);
+            }
+            scheduler.waitJob(previousJobId);
+            rp3d_test(nbJobsInOrder == nbChainedJobs);
+
+            // The base scheduler executes a chained job on the calling thread
+            DefaultTaskScheduler sequentialScheduler(1);
+            nbExecutedJobs = 0;
+            const luint firstJobId = sequentialScheduler.TaskScheduler::startJob(orderedJob(0));
+            sequentialScheduler.TaskScheduler::startJob(orderedJob(1), &firstJobId, 1);
+            rp3d_test(nbExecutedJobs == 2);
+            rp3d_test(order[0] == 0 && order[1] == 1);
+        }
+};
+
+}
+
+#endif
@@ -0,0 +1,301 @@
+/********************************************************************************
+* ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
+* Copyright (c) 2010-2018 Daniel Chappuis                                       *
+*********************************************************************************
+*                                                                               *
+* This software is provided 'as-is', without any express or implied warranty.   *
+* In no event will the authors be held liable for any damages arising from the  *
+* use of this software.                                                         *
+*                                                                               *
+* Permission is granted to anyone to use this software for any purpose,         *
+* including commercial applications, and to alter it and redistribute it        *
+* freely, subject to the following restrictions:                                *
+*                                                                               *
+* 1. The origin of this software must not be misrepresented; you must not claim *
+*    that you wrote the original software. If you use this software in a        *
+*    product, an acknowledgment in the product documentation would be           *
+*    appreciated but is not required.                                           *
+*                                                                               *
+* 2. Altered source versions must be plainly marked as such, and must not be    *
+*    misrepresented as being the original software.                             *
+*                                                                               *
+* 3. This notice may not be removed or altered from any source distribution.    *
+*                                                                               *
+********************************************************************************/
+
+#ifndef TEST_VEHICLE_H
+#define TEST_VEHICLE_H
+
+// Libraries
+#include "Test.h"
+#include "reactphysics3d.h"
+
+/// Reactphysics3D namespace
+namespace reactphysics3d {
+
+// Class TestVehicle
+/**
+ * Unit test for the Vehicle class
+ */
+class TestVehicle : public Test {
+
+    private :
+
+        // ---------- Atributes ---------- //
+
+        BoxShape mFloorShape;
+
+        BoxShape mChassisShape;
+
+        /// Mass of the chassis of the vehicles
+        const decimal mChassisMass = decimal(1000.0);
+
+    public :
+
+        // ---------- Methods ---------- //
+
+        /// Constructor
+        TestVehicle(const std::string& name)
+            : Test(name), mFloorShape(Vector3(100, decimal(0.5), 100)), mChassisShape(Vector3(1, decimal(0.25), 2)) {
+
+        }
+
+        /// Run the tests
+        void run() {
+
+            testCreateAndDestroy();
+            testSuspension();
+            testEngineAndBrake();
+            testLateralFriction();
+            testSeveralVehicles();
+        }
+
+        /// Create a static floor whose top face is at y = 0
+        RigidBody* createFloor(DynamicsWorld& world) {
+            RigidBody* floor = world.createRigidBody(Transform(Vector3(0, decimal(-0.5), 0), Quaternion::identity()));
+            floor->setType(BodyType::STATIC);
+            floor->addCollisionShape(&mFloorShape, Transform::identity(), decimal(1.0));
+            return floor;
+        }
+
+        /// Create a vehicle with four wheels (the rear wheels have the indices 2 and 3)
+        Vehicle* createVehicle(DynamicsWorld& world, const Vector3& position,
+                               decimal frictionCoefficient = decimal(1.0)) {
+
+            RigidBody* chassis = world.createRigidBody(Transform(position, Quaternion::identity()));
+            chassis->addCollisionShape(&mChassisShape, Transform::identity(), mChassisMass);
+
+            Vehicle* vehicle = world.createVehicle(chassis);
+            for (int z=1; z >= -1; z -= 2) {
+                for (int x=-1; x <= 1; x += 2) {
+                    WheelSettings wheelSettings;
+                    wheelSettings.connectionPoint = Vector3(decimal(0.9) * decimal(x), decimal(-0.2), decimal(1.6) * decimal(z));
+                    wheelSettings.frictionCoefficient = frictionCoefficient;
+                    vehicle->addWheel(wheelSettings);
+                }
+            }
+
+            return vehicle;
+        }
+
+        /// Return the total force of the suspensions of a vehicle
+        static decimal getTotalSuspensionForce(const Vehicle* vehicle) {
+            decimal force = decimal(0.0);
+            for (uint w=0; w < vehicle->getNbWheels(); w++) {
+                force += vehicle->getSuspensionForce(w);
+            }
+            return force;
+        }
+
+        void testCreateAndDestroy() {
+
+            DynamicsWorld world(Vector3(0, decimal(-9.81), 0));
+
+            Vehicle* vehicle1 = createVehicle(world, Vector3(0, 5, 0));
+            Vehicle* vehicle2 = createVehicle(world, Vector3(10, 5, 0));
+            rp3d_test(world.getNbVehicles() == 2);
+            rp3d_test(world.getVehicle(1) == vehicle2);
+            rp3d_test(vehicle1->getNbWheels() == 4);
+            rp3d_test(vehicle1->getWheelSettings(3).connectionPoint == Vector3(decimal(0.9), decimal(-0.2), decimal(-1.6)));
+            rp3d_test(vehicle1->getSuspensionLength(0) == vehicle1->getWheelSettings(0).suspensionRestLength);
+            rp3d_test(!vehicle1->isWheelInContact(0));
+            rp3d_test(vehicle1->getWheelGroundBody(0) == nullptr);
+
+            vehicle1->setSteeringAngle(0, decimal(0.2));
+            vehicle1->setEngineForce(2, decimal(100.0));
+            vehicle1->setBrakeForce(3, decimal(50.0));
+            rp3d_test(vehicle1->getSteeringAngle(0) == decimal(0.2));
+            rp3d_test(vehicle1->getEngineForce(2) == decimal(100.0));
+            rp3d_test(vehicle1->getBrakeForce(3) == decimal(50.0));
+
+            // The wheels of a vehicle in the air do not touch anything
+            world.update(decimal(1.0) / decimal(60.0));
+            rp3d_test(!vehicle1->isWheelInContact(0));
+            rp3d_test(getTotalSuspensionForce(vehicle1) == decimal(0.0));
+
+            // The last vehicle is moved at the index of the destroyed one (the chassis is not destroyed)
+            RigidBody* chassis = vehicle1->getChassis();
+            world.destroyVehicle(vehicle1);
+            rp3d_test(world.getNbVehicles() == 1);
+            rp3d_test(world.getVehicle(0) == vehicle2);
+            rp3d_test(world.getNbRigidBodies() == 2);
+            world.destroyRigidBody(chassis);
+        }
+
+        void testSuspension() {
+
+            DynamicsWorld world(Vector3(0, decimal(-9.81), 0));
+            RigidBody* floor = createFloor(world);
+            Vehicle* vehicle = createVehicle(world, Vector3(0, decimal(0.9), 0));
+
+            for (uint i=0; i < 120; i++) {
+                world.update(decimal(1.0) / decimal(60.0));
+            }
+
+            // The chassis rests on its wheels without touching the floor
+            const Vector3 position = vehicle->getChassis()->getTransform().getPosition();
+            rp3d_test(position.y - mChassisShape.getExtent().y > decimal(0.5));
+            rp3d_test(vehicle->getChassis()->getLinearVelocity().length() < decimal(0.01));
+            for (uint w=0; w < vehicle->getNbWheels(); w++) {
+                rp3d_test(vehicle->isWheelInContact(w));
+                rp3d_test(vehicle->getWheelGroundBody(w) == floor);
+                rp3d_test(approxEqual(vehicle->getWheelContactNormal(w), Vector3(0, 1, 0), decimal(0.001)));
+                rp3d_test(approxEqual(vehicle->getWheelContactPoint(w).y, decimal(0.0), decimal(0.001)));
+                rp3d_test(vehicle->getSuspensionLength(w) < vehicle->getWheelSettings(w).suspensionRestLength);
+                rp3d_test(vehicle->getSuspensionLength(w) > decimal(0.0));
+            }
+
+            // The suspensions carry the weight of the chassis
+            rp3d_test(approxEqual(getTotalSuspensionForce(vehicle), mChassisMass * decimal(9.81), decimal(100.0)));
+
+            // The wheel is at the end of its suspension
+            const Transform wheelTransform = vehicle->getWheelTransform(0);
+            rp3d_test(approxEqual(wheelTransform.getPosition().y, vehicle->getWheelSettings(0).radius, decimal(0.001)));
+        }
+
+        void testEngineAndBrake() {
+
+            DynamicsWorld world(Vector3(0, decimal(-9.81), 0));
+            createFloor(world);
+            Vehicle* vehicle = createVehicle(world, Vector3(0, decimal(0.9), 0));
+            RigidBody* chassis = vehicle->getChassis();
+
+            for (uint i=0; i < 60; i++) {
+                world.update(decimal(1.0) / decimal(60.0));
+            }
+
+            // The engine pushes the vehicle forward (the rear wheels drive the vehicle)
+            const decimal engineForce = decimal(2000.0);
+            vehicle->setEngineForce(2, engineForce);
+            vehicle->setEngineForce(3, engineForce);
+            for (uint i=0; i < 60; i++) {
+                world.update(decimal(1.0) / decimal(60.0));
+            }
+            const decimal expectedSpeed = decimal(2.0) * engineForce / mChassisMass;
+            rp3d_test(approxEqual(vehicle->getForwardSpeed(), expectedSpeed, decimal(0.1)));
+            rp3d_test(chassis->getTransform().getPosition().z > decimal(0.5));
+            rp3d_test(std::abs(chassis->getTransform().getPosition().x) < decimal(0.01));
+            rp3d_test(vehicle->getWheelRotationAngle(0) != decimal(0.0));
+
+            // The brakes stop the vehicle
+            vehicle->setEngineForce(2, decimal(0.0));
+            vehicle->setEngineForce(3, decimal(0.0));
+            for (uint w=0; w < vehicle->getNbWheels(); w++) {
+                vehicle->setBrakeForce(w, decimal(3000.0));
+            }
+            for (uint i=0; i < 90; i++) {
+                world.update(decimal(1.0) / decimal(60.0));
+            }
+            rp3d_test(std::abs(vehicle->getForwardSpeed()) < decimal(0.05));
+
+            // The engine force is limited by the friction of the tires
+            for (uint w=0; w < vehicle->getNbWheels(); w++) {
+                vehicle->setBrakeForce(w, decimal(0.0));
+                vehicle->setEngineForce(w, decimal(100000.0));
+            }
+            for (uint i=0; i < 60; i++) {
+                world.update(decimal(1.0) / decimal(60.0));
+            }
+            rp3d_test(vehicle->getForwardSpeed() < decimal(1.1) * decimal(9.81));
+        }
+
+        void testLateralFriction() {
+
+            DynamicsWorld world(Vector3(0, decimal(-9.81), 0));
+            createFloor(world);
+
+            // The friction is low enough for the vehicle not to roll over
+            Vehicle* vehicle = createVehicle(world, Vector3(0, decimal(0.9), 0), decimal(0.5));
+            RigidBody* chassis = vehicle->getChassis();
+
+            for (uint i=0; i < 60; i++) {
+                world.update(decimal(1.0) / decimal(60.0));
+            }
+
+            // The tires stop a sideways motion of the vehicle
+            chassis->setLinearVelocity(Vector3(3, 0, 0));
+            for (uint i=0; i < 60; i++) {
+                world.update(decimal(1.0) / decimal(60.0));
+            }
+            rp3d_test(std::abs(chassis->getLinearVelocity().x) < decimal(0.05));
+
+            // A free wheel rolls without slowing down the vehicle
+            chassis->setLinearVelocity(Vector3(0, 0, 3));
+            for (uint i=0; i < 30; i++) {
+                world.update(decimal(1.0) / decimal(60.0));
+            }
+            rp3d_test(approxEqual(vehicle->getForwardSpeed(), decimal(3.0), decimal(0.05)));
+
+            // A steered vehicle turns
+            vehicle->setSteeringAngle(0, decimal(0.3));
+            vehicle->setSteeringAngle(1, decimal(0.3));
+            for (uint i=0; i < 60; i++) {
+                world.update(decimal(1.0) / decimal(60.0));
+            }
+            rp3d_test(std::abs(chassis->getAngularVelocity().y) > decimal(0.1));
+        }
+
+        void testSeveralVehicles() {
+
+            DefaultTaskScheduler scheduler(4);
+
+            WorldSettings parallelSettings;
+            parallelSettings.taskScheduler = &scheduler;
+
+            DynamicsWorld sequentialWorld(Vector3(0, decimal(-9.81), 0));
+            DynamicsWorld parallelWorld(Vector3(0, decimal(-9.81), 0), parallelSettings);
+            createFloor(sequentialWorld);
+            createFloor(parallelWorld);
+
+            // The rays of the wheels of all the vehicles are cast in a single batch
+            for (uint i=0; i < 8; i++) {
+                const Vector3 position(decimal(i) * decimal(4.0), decimal(0.9), 0);
+                createVehicle(sequentialWorld, position)->setEngineForce(2, decimal(500.0) * decimal(i));
+                createVehicle(parallelWorld, position)->setEngineForce(2, decimal(500.0) * decimal(i));
+            }
+
+            for (uint i=0; i < 60; i++) {
+                sequentialWorld.update(decimal(1.0) / decimal(60.0));
+                parallelWorld.update(decimal(1.0) / decimal(60.0));
+            }
+
+            // The islands of the vehicles are solved independently
+            bool isSameTransforms = true;
+            bool isOnWheels = true;
+            for (uint i=0; i < sequentialWorld.getNbVehicles(); i++) {
+                const Vehicle* vehicle = sequentialWorld.getVehicle(i);
+                isSameTransforms &= vehicle->getChassis()->getTransform() ==
+                                    parallelWorld.getVehicle(i)->getChassis()->getTransform();
+                for (uint w=0; w < vehicle->getNbWheels(); w++) {
+                    isOnWheels &= vehicle->isWheelInContact(w);
+                }
+            }
+            rp3d_test(isSameTransforms);
+            rp3d_test(isOnWheels);
+            rp3d_test(sequentialWorld.getVehicle(7)->getForwardSpeed() > sequentialWorld.getVehicle(1)->getForwardSpeed());
+        }
+};
+
+}
+
+#endif
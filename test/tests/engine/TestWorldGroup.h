@@ -0,0 +1,169 @@
+/********************************************************************************
+* ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
+* Copyright (c) 2010-2018 Daniel Chappuis                                       *
+*********************************************************************************
+*                                                                               *
+* This software is provided 'as-is', without any express or implied warranty.   *
+* In no event will the authors be held liable for any damages arising from the  *
+* use of this software.                                                         *
+*                                                                               *
+* Permission is granted to anyone to use this software for any purpose,         *
+* including commercial applications, and to alter it and redistribute it        *
+* freely, subject to the following restrictions:                                *
+*                                                                               *
+* 1. The origin of this software must not be misrepresented; you must not claim *
+*    that you wrote the original software. If you use this software in a        *
+*    product, an acknowledgment in the product documentation would be           *
+*    appreciated but is not required.                                           *
+*                                                                               *
+* 2. Altered source versions must be plainly marked as such, and must not be    *
+*    misrepresented as being the original software.                             *
+*                                                                               *
+* 3. This notice may not be removed or altered from any source distribution.    *
+*                                                                               *
+********************************************************************************/
+
+#ifndef TEST_WORLD_GROUP_H
+#define TEST_WORLD_GROUP_H
+
+// Libraries
+#include "Test.h"
+#include "reactphysics3d.h"
+
+/// Reactphysics3D namespace
+namespace reactphysics3d {
+
+// Class TestWorldGroup
+/**
+ * Unit test for the WorldGroup class
+ */
+class TestWorldGroup : public Test {
+
+    private :
+
+        // ---------- Atributes ---------- //
+
+        BoxShape mBoxShape;
+
+        BoxShape mFloorShape;
+
+    public :
+
+        // ---------- Methods ---------- //
+
+        /// Constructor
+        TestWorldGroup(const std::string& name)
+            : Test(name), mBoxShape(Vector3(decimal(0.5), decimal(0.5), decimal(0.5))),
+              mFloorShape(Vector3(30, 1, 30)) {
+
+        }
+
+        /// Run the tests
+        void run() {
+
+            testUpdateGroup();
+            testRemoveWorld();
+        }
+
+        /// Create an arena with a floor and a number of falling boxes
+        void createArena(DynamicsWorld& world, uint nbBoxes, List<RigidBody*>& bodies) {
+
+            RigidBody* floor = world.createRigidBody(Transform(Vector3(0, -1, 0), Quaternion::identity()));
+            floor->setType(BodyType::STATIC);
+            floor->addCollisionShape(&mFloorShape, Transform::identity(), decimal(1.0));
+
+            for (uint i=0; i < nbBoxes; i++) {
+                const Vector3 position(decimal(i % 8) * decimal(1.5) - decimal(5.0), decimal(1.0) + decimal(i / 64) * decimal(1.5),
+                                       decimal((i / 8) % 8) * decimal(1.5) - decimal(5.0));
+                RigidBody* body = world.createRigidBody(Transform(position, Quaternion::identity()));
+                body->addCollisionShape(&mBoxShape, Transform::identity(), decimal(1.0));
+                bodies.add(body);
+            }
+        }
+
+        void testUpdateGroup() {
+
+            DefaultTaskScheduler scheduler(4);
+
+            // Arenas of different sizes stepped by a group and the same arenas stepped one by one
+            const uint nbArenas = 10;
+            DynamicsWorld* worlds[nbArenas];
+            DynamicsWorld* referenceWorlds[nbArenas];
+            List<RigidBody*> bodies(MemoryManager::getBaseAllocator());
+            List<RigidBody*> referenceBodies(MemoryManager::getBaseAllocator());
+
+            WorldGroup group(&scheduler, MemoryManager::getBaseAllocator());
+            rp3d_test(group.getTaskScheduler() == &scheduler);
+            for (uint a=0; a < nbArenas; a++) {
+
+                const uint nbBoxes = a % 3 == 0 ? 128 : 8;
+
+                worlds[a] = new DynamicsWorld(Vector3(0, decimal(-9.81), 0));
+                createArena(*worlds[a], nbBoxes, bodies);
+                group.addWorld(worlds[a]);
+
+                referenceWorlds[a] = new DynamicsWorld(Vector3(0, decimal(-9.81), 0));
+                createArena(*referenceWorlds[a], nbBoxes, referenceBodies);
+            }
+            rp3d_test(group.getNbWorlds() == nbArenas);
+
+            for (uint i=0; i < 60; i++) {
+                group.update(decimal(1.0) / decimal(60.0));
+                for (uint a=0; a < nbArenas; a++) {
+                    referenceWorlds[a]->update(decimal(1.0) / decimal(60.0));
+                }
+            }
+
+            // Each world of the group is stepped once per update, as if it was alone
+            bool isSameTransforms = true;
+            for (uint i=0; i < bodies.size(); i++) {
+                isSameTransforms &= bodies[i]->getTransform().getPosition() == referenceBodies[i]->getTransform().getPosition();
+                isSameTransforms &= bodies[i]->getTransform().getOrientation() == referenceBodies[i]->getTransform().getOrientation();
+            }
+            rp3d_test(isSameTransforms);
+            for (uint a=0; a < nbArenas; a++) {
+                rp3d_test(worlds[a]->getStepStatistics().totalTime > 0.0);
+            }
+
+            for (uint a=0; a < nbArenas; a++) {
+                group.removeWorld(worlds[a]);
+                delete worlds[a];
+                delete referenceWorlds[a];
+            }
+            rp3d_test(group.getNbWorlds() == 0);
+        }
+
+        void testRemoveWorld() {
+
+            // The worlds are stepped sequentially without a task scheduler
+            WorldGroup group(nullptr, MemoryManager::getBaseAllocator());
+            DynamicsWorld world1(Vector3(0, decimal(-9.81), 0));
+            DynamicsWorld world2(Vector3(0, decimal(-9.81), 0));
+            DynamicsWorld world3(Vector3(0, decimal(-9.81), 0));
+            List<RigidBody*> bodies(MemoryManager::getBaseAllocator());
+            createArena(world1, 1, bodies);
+            createArena(world2, 1, bodies);
+            createArena(world3, 1, bodies);
+
+            group.addWorld(&world1);
+            group.addWorld(&world2);
+            group.addWorld(&world3);
+
+            // The last world is moved at the index of the removed world
+            group.removeWorld(&world1);
+            rp3d_test(group.getNbWorlds() == 2);
+            rp3d_test(group.getWorld(0) == &world3);
+            rp3d_test(group.getWorld(1) == &world2);
+
+            group.update(decimal(1.0) / decimal(60.0));
+
+            // The removed world has not been stepped
+            rp3d_test(bodies[0]->getTransform().getPosition().y == decimal(1.0));
+            rp3d_test(bodies[1]->getTransform().getPosition().y < decimal(1.0));
+            rp3d_test(bodies[2]->getTransform().getPosition().y < decimal(1.0));
+        }
+};
+
+}
+
+#endif
@@ -0,0 +1,163 @@
+/********************************************************************************
+* ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
+* Copyright (c) 2010-2018 Daniel Chappuis                                       *
+*********************************************************************************
+*                                                                               *
+* This software is provided 'as-is', without any express or implied warranty.   *
+* In no event will the authors be held liable for any damages arising from the  *
+* use of this software.                                                         *
+*                                                                               *
+* Permission is granted to anyone to use this software for any purpose,         *
+* including commercial applications, and to alter it and redistribute it        *
+* freely, subject to the following restrictions:                                *
+*                                                                               *
+* 1. The origin of this software must not be misrepresented; you must not claim *
+*    that you wrote the original software. If you use this software in a        *
+*    product, an acknowledgment in the product documentation would be           *
+*    appreciated but is not required.                                           *
+*                                                                               *
+* 2. Altered source versions must be plainly marked as such, and must not be    *
+*    misrepresented as being the original software.                             *
+*                                                                               *
+* 3. This notice may not be removed or altered from any source distribution.    *
+*                                                                               *
+********************************************************************************/
+
+#ifndef TEST_WORLD_RECORDER_H
+#define TEST_WORLD_RECORDER_H
+
+// Libraries
+#include "Test.h"
+#include "reactphysics3d.h"
+
+/// Reactphysics3D namespace
+namespace reactphysics3d {
+
+// Class TestWorldRecorder
+/**
+ * Unit test for the WorldRecorder and WorldReplayer classes
+ */
+class TestWorldRecorder : public Test {
+
+    private :
+
+        // ---------- Atributes ---------- //
+
+        BoxShape mBoxShape;
+
+        BoxShape mFloorShape;
+
+    public :
+
+        // ---------- Methods ---------- //
+
+        /// Constructor
+        TestWorldRecorder(const std::string& name)
+            : Test(name), mBoxShape(Vector3(decimal(0.5), decimal(0.5), decimal(0.5))),
+              mFloorShape(Vector3(30, 1, 30)) {
+
+        }
+
+        /// Run the tests
+        void run() {
+
+            testRecordAndReplay();
+            testInvalidLog();
+        }
+
+        void testRecordAndReplay() {
+
+            CollisionShape* shapes[] = {&mFloorShape, &mBoxShape};
+
+            DynamicsWorld world(Vector3(0, decimal(-9.81), 0));
+            RigidBody* floor = world.createRigidBody(Transform(Vector3(0, -1, 0), Quaternion::identity()));
+            floor->setType(BodyType::STATIC);
+            floor->addCollisionShape(&mFloorShape, Transform::identity(), decimal(1.0));
+
+            WorldRecorder recorder(&world, shapes, 2, 20, MemoryManager::getBaseAllocator());
+            rp3d_test(recorder.getWorld() == &world);
+            rp3d_test(recorder.getNbRecordedUpdates() == 0);
+
+            RigidBody* boxes[4];
+            for (uint i=0; i < 4; i++) {
+                boxes[i] = recorder.createRigidBody(Transform(Vector3(decimal(i) * decimal(1.5), 1, 0), Quaternion::identity()));
+                recorder.addCollisionShape(boxes[i], &mBoxShape, Transform::identity(), decimal(1.0));
+            }
+
+            RigidBody* newBox = nullptr;
+            for (uint i=0; i < 50; i++) {
+
+                if (i == 22) {
+                    recorder.setTransform(boxes[1], Transform(Vector3(2, 3, 1), Quaternion::identity()));
+                    recorder.setLinearVelocity(boxes[2], Vector3(1, 2, 0));
+                    recorder.setAngularVelocity(boxes[2], Vector3(0, 3, 0));
+                }
+                if (i == 25) {
+                    newBox = recorder.createRigidBody(Transform(Vector3(0, 4, 0), Quaternion::identity()));
+                    recorder.addCollisionShape(newBox, &mBoxShape, Transform::identity(), decimal(2.0));
+                }
+                if (i == 30) {
+                    recorder.destroyRigidBody(boxes[3]);
+                }
+                if (i >= 35 && i < 40) {
+                    recorder.applyForceToCenterOfMass(boxes[0], Vector3(0, 20, 0));
+                    recorder.applyForce(newBox, Vector3(5, 0, 0), newBox->getTransform().getPosition() + Vector3(0, decimal(0.5), 0));
+                    recorder.applyTorque(boxes[1], Vector3(0, 2, 0));
+                }
+
+                recorder.update(decimal(1.0) / decimal(60.0));
+            }
+
+            // Keyframes have been saved after the updates 20 and 40 and the log starts at the first one
+            rp3d_test(recorder.getNbRecordedUpdates() == 30);
+
+            const size_t sizeInBytes = recorder.getLogSizeInBytes();
+            unsigned char* log = new unsigned char[sizeInBytes];
+            recorder.saveLog(log);
+
+            WorldReplayer replayer(log, sizeInBytes, shapes, 2, MemoryManager::getBaseAllocator());
+            delete[] log;
+            rp3d_test(replayer.isValid());
+
+            // The replayed world starts at the update 20
+            DynamicsWorld* replayedWorld = replayer.getWorld();
+            rp3d_test(replayedWorld->getNbRigidBodies() == 5);
+
+            rp3d_test(replayer.replayNextUpdate());
+            rp3d_test(replayer.getNbReplayedUpdates() == 1);
+            replayer.replay();
+            rp3d_test(replayer.getNbReplayedUpdates() == 30);
+            rp3d_test(!replayer.replayNextUpdate());
+            rp3d_test(replayer.getLongestUpdateIndex() < 30);
+            rp3d_test(replayer.getLongestUpdateTime() > 0.0);
+
+            // The replayed world has the same bodies at the same positions as the recorded one
+            // (up to the rounding differences of the contacts created in a different order)
+            rp3d_test(replayedWorld->getNbRigidBodies() == world.getNbRigidBodies());
+            bool isSamePositions = true;
+            for (uint i=0; i < world.getNbRigidBodies(); i++) {
+                const Vector3& position = world.getRigidBody(i)->getTransform().getPosition();
+                const Vector3& replayedPosition = replayedWorld->getRigidBody(i)->getTransform().getPosition();
+                isSamePositions &= world.getRigidBody(i)->getId() == replayedWorld->getRigidBody(i)->getId();
+                isSamePositions &= approxEqual(position, replayedPosition, decimal(0.01));
+            }
+            rp3d_test(isSamePositions);
+        }
+
+        void testInvalidLog() {
+
+            CollisionShape* shapes[] = {&mBoxShape};
+
+            WorldReplayer nullReplayer(nullptr, 0, shapes, 1, MemoryManager::getBaseAllocator());
+            rp3d_test(!nullReplayer.isValid());
+            rp3d_test(nullReplayer.getWorld() == nullptr);
+
+            unsigned char data[64] = {};
+            WorldReplayer invalidReplayer(data, sizeof(data), shapes, 1, MemoryManager::getBaseAllocator());
+            rp3d_test(!invalidReplayer.isValid());
+        }
+};
+
+}
+
+#endif
@@ -0,0 +1,282 @@
+/********************************************************************************
+* ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
+* Copyright (c) 2010-2018 Daniel Chappuis                                       *
+*********************************************************************************
+*                                                                               *
+* This software is provided 'as-is', without any express or implied warranty.   *
+* In no event will the authors be held liable for any damages arising from the  *
+* use of this software.                                                         *
+*                                                                               *
+* Permission is granted to anyone to use this software for any purpose,         *
+* including commercial applications, and to alter it and redistribute it        *
+* freely, subject to the following restrictions:                                *
+*                                                                               *
+* 1. The origin of this software must not be misrepresented; you must not claim *
+*    that you wrote the original software. If you use this software in a        *
+*    product, an acknowledgment in the product documentation would be           *
+*    appreciated but is not required.                                           *
+*                                                                               *
+* 2. Altered source versions must be plainly marked as such, and must not be    *
+*    misrepresented as being the original software.                             *
+*                                                                               *
+* 3. This notice may not be removed or altered from any source distribution.    *
+*                                                                               *
+********************************************************************************/
+
+
+#ifndef TEST_LANES_H
+#define TEST_LANES_H
+
+// Libraries
+#include "Test.h"
+#include "mathematics/TransformLanes.h"
+#include "mathematics/mathematics_functions.h"
+
+/// Reactphysics3D namespace
+namespace reactphysics3d {
+
+// Class TestLanes
+/**
+ * Unit test for the Lanes, Vector3Lanes, QuaternionLanes and TransformLanes classes. The
+ * results of each lane are compared with the results of the scalar classes.
+ */
+class TestLanes : public Test {
+
+    private :
+
+        // ---------- Atributes ---------- //
+
+        /// Test vectors
+        Vector3 mVectors[8];
+
+        /// Test unit quaternions
+        Quaternion mQuaternions[8];
+
+        /// Test transforms
+        Transform mTransforms[8];
+
+        // ---------- Methods ---------- //
+
+        /// Return true if two numbers are approximately equal
+        static bool approxEqualNumbers(decimal number1, decimal number2) {
+            return approxEqual(number1, number2, decimal(0.0001));
+        }
+
+        /// Return true if two vectors are approximately equal
+        static bool approxEqualVectors(const Vector3& vector1, const Vector3& vector2) {
+            return approxEqual(vector1, vector2, decimal(0.0001));
+        }
+
+    public :
+
+        // ---------- Methods ---------- //
+
+        /// Constructor
+        TestLanes(const std::string& name) : Test(name) {
+
+            for (uint i=0; i < 8; i++) {
+                mVectors[i] = Vector3(decimal(i) - decimal(3.5), decimal(2.0) * decimal(i) + decimal(1.0),
+                                      decimal(5.0) - decimal(i) * decimal(i));
+                Vector3 axis(decimal(1.0), decimal(i), decimal(2.0));
+                axis.normalize();
+                const decimal angle = decimal(0.3) * decimal(i + 1);
+                mQuaternions[i] = Quaternion(axis * std::sin(angle / decimal(2.0)), std::cos(angle / decimal(2.0)));
+            }
+            for (uint i=0; i < 8; i++) {
+                mTransforms[i] = Transform(mVectors[(i + 3) % 8], mQuaternions[(i + 5) % 8]);
+            }
+        }
+
+        /// Run the tests
+        void run() {
+            testLanes();
+            testVector3Lanes<4>();
+            testVector3Lanes<8>();
+            testQuaternionLanes<4>();
+            testQuaternionLanes<8>();
+            testTransformLanes<4>();
+            testTransformLanes<8>();
+        }
+
+        /// Test the lanes of numbers and the masks
+        void testLanes() {
+
+            const decimal values[4] = {decimal(3.0), decimal(-1.0), decimal(4.0), decimal(2.0)};
+            const Lanes<decimal, 4> lanes1 = Lanes<decimal, 4>::load(values);
+            const Lanes<decimal, 4> lanes2(decimal(2.5));
+
+            rp3d_test(approxEqualNumbers(lanes1.horizontalMin(), decimal(-1.0)));
+            rp3d_test(approxEqualNumbers(lanes1.horizontalMax(), decimal(4.0)));
+            rp3d_test(approxEqualNumbers(lanes1.horizontalSum(), decimal(8.0)));
+
+            const LaneMask<4> mask = lanes1 < lanes2;
+            rp3d_test(!mask[0] && mask[1] && !mask[2] && mask[3]);
+            rp3d_test(mask.any());
+            rp3d_test(!mask.all());
+            rp3d_test(mask.count() == 2);
+            rp3d_test((mask || !mask).all());
+            rp3d_test(!(mask && !mask).any());
+
+            const Lanes<decimal, 4> selected = select(mask, lanes1, lanes2);
+            rp3d_test(approxEqualNumbers(selected[0], decimal(2.5)));
+            rp3d_test(approxEqualNumbers(selected[1], decimal(-1.0)));
+            rp3d_test(approxEqualNumbers(selected[2], decimal(2.5)));
+            rp3d_test(approxEqualNumbers(selected[3], decimal(2.0)));
+
+            const Lanes<decimal, 4> minimum = Lanes<decimal, 4>::min(lanes1, lanes2);
+            const Lanes<decimal, 4> maximum = Lanes<decimal, 4>::max(lanes1, lanes2);
+            const Lanes<decimal, 4> absolute = lanes1.getAbsoluteValue();
+            const Lanes<decimal, 4> root = absolute.getSquareRoot();
+            const Lanes<decimal, 4> sum = lanes1 + decimal(2.0) * lanes2 - lanes1 * lanes2;
+            for (uint l=0; l < 4; l++) {
+                rp3d_test(approxEqualNumbers(minimum[l], std::min(values[l], decimal(2.5))));
+                rp3d_test(approxEqualNumbers(maximum[l], std::max(values[l], decimal(2.5))));
+                rp3d_test(approxEqualNumbers(absolute[l], std::abs(values[l])));
+                rp3d_test(approxEqualNumbers(root[l], std::sqrt(std::abs(values[l]))));
+                rp3d_test(approxEqualNumbers(sum[l], values[l] + decimal(5.0) - values[l] * decimal(2.5)));
+            }
+
+            // Gather and scatter with indices
+            const uint indices[4] = {3, 0, 2, 1};
+            const Lanes<decimal, 4> gathered = Lanes<decimal, 4>::gather(values, indices);
+            rp3d_test(approxEqualNumbers(gathered[0], decimal(2.0)));
+            rp3d_test(approxEqualNumbers(gathered[1], decimal(3.0)));
+            decimal scattered[4];
+            gathered.scatter(scattered, indices);
+            for (uint l=0; l < 4; l++) {
+                rp3d_test(approxEqualNumbers(scattered[l], values[l]));
+            }
+        }
+
+        /// Test the lanes of 3D vectors
+        template<uint N>
+        void testVector3Lanes() {
+
+            uint indices[N];
+            for (uint l=0; l < N; l++) indices[l] = (l * 3 + 1) % 8;
+
+            const Vector3Lanes<decimal, N> vectors1 = Vector3Lanes<decimal, N>::load(mVectors);
+            const Vector3Lanes<decimal, N> vectors2 = Vector3Lanes<decimal, N>::gather(mVectors, indices);
+
+            const Lanes<decimal, N> dot = vectors1.dot(vectors2);
+            const Lanes<decimal, N> length = vectors1.length();
+            const Vector3Lanes<decimal, N> cross = vectors1.cross(vectors2);
+            const Vector3Lanes<decimal, N> combination = vectors1 + decimal(2.0) * vectors2 - dot * vectors1;
+            const LaneMask<N> isLonger = vectors1.lengthSquare() > vectors2.lengthSquare();
+            const Vector3Lanes<decimal, N> longest = select(isLonger, vectors1, vectors2);
+
+            Vector3 minimum = mVectors[0];
+            Vector3 maximum = mVectors[0];
+            for (uint l=0; l < N; l++) {
+
+                const Vector3& vector1 = mVectors[l];
+                const Vector3& vector2 = mVectors[indices[l]];
+
+                rp3d_test(approxEqualVectors(vectors2.getLane(l), vector2));
+                rp3d_test(approxEqualNumbers(dot[l], vector1.dot(vector2)));
+                rp3d_test(approxEqualNumbers(length[l], vector1.length()));
+                rp3d_test(approxEqualVectors(cross.getLane(l), vector1.cross(vector2)));
+                rp3d_test(approxEqualVectors(combination.getLane(l),
+                                             vector1 + decimal(2.0) * vector2 - vector1.dot(vector2) * vector1));
+                rp3d_test(approxEqualVectors(longest.getLane(l),
+                          vector1.lengthSquare() > vector2.lengthSquare() ? vector1 : vector2));
+
+                minimum = Vector3::min(minimum, vector1);
+                maximum = Vector3::max(maximum, vector1);
+            }
+
+            rp3d_test(approxEqualVectors(vectors1.horizontalMin(), minimum));
+            rp3d_test(approxEqualVectors(vectors1.horizontalMax(), maximum));
+
+            // Scatter the lanes back into an array
+            Vector3 scattered[8];
+            vectors2.scatter(scattered, indices);
+            for (uint l=0; l < N; l++) {
+                rp3d_test(approxEqualVectors(scattered[indices[l]], mVectors[indices[l]]));
+            }
+        }
+
+        /// Test the lanes of quaternions
+        template<uint N>
+        void testQuaternionLanes() {
+
+            uint indices1[N];
+            uint indices2[N];
+            for (uint l=0; l < N; l++) {
+                indices1[l] = l;
+                indices2[l] = (l + 5) % 8;
+            }
+
+            const QuaternionLanes<decimal, N> quaternions1 = QuaternionLanes<decimal, N>::gather(mQuaternions, indices1);
+            const QuaternionLanes<decimal, N> quaternions2 = QuaternionLanes<decimal, N>::gather(mQuaternions, indices2);
+            const Vector3Lanes<decimal, N> points = Vector3Lanes<decimal, N>::load(mVectors);
+
+            const QuaternionLanes<decimal, N> product = quaternions1 * quaternions2;
+            const QuaternionLanes<decimal, N> conjugate = quaternions1.getConjugate();
+            const Vector3Lanes<decimal, N> rotated = quaternions1 * points;
+
+            for (uint l=0; l < N; l++) {
+
+                const Quaternion& quaternion1 = mQuaternions[indices1[l]];
+                const Quaternion& quaternion2 = mQuaternions[indices2[l]];
+                const Quaternion expectedProduct = quaternion1 * quaternion2;
+                const Quaternion expectedConjugate = quaternion1.getConjugate();
+
+                rp3d_test(approxEqualNumbers(product.getLane(l).x, expectedProduct.x));
+                rp3d_test(approxEqualNumbers(product.getLane(l).y, expectedProduct.y));
+                rp3d_test(approxEqualNumbers(product.getLane(l).z, expectedProduct.z));
+                rp3d_test(approxEqualNumbers(product.getLane(l).w, expectedProduct.w));
+                rp3d_test(conjugate.getLane(l) == expectedConjugate);
+                rp3d_test(approxEqualVectors(rotated.getLane(l), quaternion1 * mVectors[l]));
+            }
+
+            // Almost unit quaternions (and one quaternion too far from the unit length
+            // for the approximation) are normalized without a square root
+            Quaternion scaledQuaternions[N];
+            for (uint l=0; l < N; l++) {
+                scaledQuaternions[l] = mQuaternions[l] * (l == 1 ? decimal(2.0) : decimal(1.0) + decimal(0.001) * l);
+            }
+            QuaternionLanes<decimal, N>::load(scaledQuaternions).getApproximateUnit().store(scaledQuaternions);
+            for (uint l=0; l < N; l++) {
+                rp3d_test(approxEqualNumbers(scaledQuaternions[l].x, mQuaternions[l].x));
+                rp3d_test(approxEqualNumbers(scaledQuaternions[l].y, mQuaternions[l].y));
+                rp3d_test(approxEqualNumbers(scaledQuaternions[l].z, mQuaternions[l].z));
+                rp3d_test(approxEqualNumbers(scaledQuaternions[l].w, mQuaternions[l].w));
+            }
+        }
+
+        /// Test the lanes of transforms
+        template<uint N>
+        void testTransformLanes() {
+
+            uint indices1[N];
+            uint indices2[N];
+            for (uint l=0; l < N; l++) {
+                indices1[l] = (l + 2) % 8;
+                indices2[l] = (7 - l) % 8;
+            }
+
+            const TransformLanes<decimal, N> transforms1 = TransformLanes<decimal, N>::gather(mTransforms, indices1);
+            const TransformLanes<decimal, N> transforms2 = TransformLanes<decimal, N>::gather(mTransforms, indices2);
+            const Vector3Lanes<decimal, N> points = Vector3Lanes<decimal, N>::load(mVectors);
+
+            const Vector3Lanes<decimal, N> transformed = transforms1 * points;
+            const Vector3Lanes<decimal, N> inverseTransformed = transforms1.getInverse() * points;
+            const TransformLanes<decimal, N> composition = transforms1 * transforms2;
+
+            for (uint l=0; l < N; l++) {
+
+                const Transform& transform1 = mTransforms[indices1[l]];
+                const Transform& transform2 = mTransforms[indices2[l]];
+
+                rp3d_test(approxEqualVectors(transformed.getLane(l), transform1 * mVectors[l]));
+                rp3d_test(approxEqualVectors(inverseTransformed.getLane(l), transform1.getInverse() * mVectors[l]));
+                rp3d_test(approxEqualVectors(composition.getLane(l) * mVectors[l],
+                                             (transform1 * transform2) * mVectors[l]));
+            }
+        }
+};
+
+}
+
+#endif
@@ -186,13 +186,13 @@ class TestMathematicsFunctions : public Test {
             segmentVertices.push_back(Vector3(-6, 3, 0));
             segmentVertices.push_back(Vector3(8, 3, 0));
 
-            List<Vector3> planesNormals(mAllocator, 2);
-            List<Vector3> planesPoints(mAllocator, 2);
+            ClippingList<Vector3> planesNormals(mAllocator);
+            ClippingList<Vector3> planesPoints(mAllocator);
             planesNormals.add(Vector3(-1, 0, 0));
             planesPoints.add(Vector3(4, 0, 0));
 
-            List<Vector3> clipSegmentVertices = clipSegmentWithPlanes(segmentVertices[0], segmentVertices[1],
-                                                                             planesPoints, planesNormals, mAllocator);
+            ClippingList<Vector3> clipSegmentVertices = clipSegmentWithPlanes(segmentVertices[0], segmentVertices[1],
+                                                                                     planesPoints, planesNormals, mAllocator);
             rp3d_test(clipSegmentVertices.size() == 2);
             rp3d_test(approxEqual(clipSegmentVertices[0].x, -6, 0.000001));
             rp3d_test(approxEqual(clipSegmentVertices[0].y, 3, 0.000001));
@@ -235,14 +235,14 @@ class TestMathematicsFunctions : public Test {
             rp3d_test(clipSegmentVertices.size() == 0);
 
             // Test clipPolygonWithPlanes()
-            List<Vector3> polygonVertices(mAllocator);
+            ClippingList<Vector3> polygonVertices(mAllocator);
             polygonVertices.add(Vector3(-4, 2, 0));
             polygonVertices.add(Vector3(7, 2, 0));
             polygonVertices.add(Vector3(7, 4, 0));
             polygonVertices.add(Vector3(-4, 4, 0));
 
-            List<Vector3> polygonPlanesNormals(mAllocator);
-            List<Vector3> polygonPlanesPoints(mAllocator);
+            ClippingList<Vector3> polygonPlanesNormals(mAllocator);
+            ClippingList<Vector3> polygonPlanesPoints(mAllocator);
             polygonPlanesNormals.add(Vector3(1, 0, 0));
             polygonPlanesPoints.add(Vector3(0, 0, 0));
             polygonPlanesNormals.add(Vector3(0, 1, 0));
@@ -252,7 +252,7 @@ class TestMathematicsFunctions : public Test {
             polygonPlanesNormals.add(Vector3(0, -1, 0));
             polygonPlanesPoints.add(Vector3(10, 5, 0));
 
-            List<Vector3> clipPolygonVertices = clipPolygonWithPlanes(polygonVertices, polygonPlanesPoints, polygonPlanesNormals, mAllocator);
+            ClippingList<Vector3> clipPolygonVertices = clipPolygonWithPlanes(polygonVertices, polygonPlanesPoints, polygonPlanesNormals, mAllocator);
             rp3d_test(clipPolygonVertices.size() == 4);
             rp3d_test(approxEqual(clipPolygonVertices[0].x, 0, 0.000001));
             rp3d_test(approxEqual(clipPolygonVertices[0].y, 2, 0.000001));
@@ -267,6 +267,41 @@ class TestMathematicsFunctions : public Test {
             rp3d_test(approxEqual(clipPolygonVertices[3].y, 4, 0.000001));
             rp3d_test(approxEqual(clipPolygonVertices[3].z, 0, 0.000001));
 
+            // Test clipPolygonWithPlanes() with the identifiers of the vertices
+            ClippingList<uint32> polygonVerticesIds(mAllocator);
+            polygonVerticesIds.add(10);
+            polygonVerticesIds.add(11);
+            polygonVerticesIds.add(12);
+            polygonVerticesIds.add(13);
+
+            ClippingList<uint32> clipPolygonVerticesIds(mAllocator);
+            ClippingList<Vector3> clipPolygonVertices2 = clipPolygonWithPlanes(polygonVertices, polygonVerticesIds, polygonPlanesPoints,
+                                                                              polygonPlanesNormals, clipPolygonVerticesIds, mAllocator);
+            rp3d_test(clipPolygonVertices2.size() == 4);
+            rp3d_test(clipPolygonVerticesIds.size() == 4);
+            for (uint i=0; i < clipPolygonVertices2.size(); i++) {
+                rp3d_test(approxEqual(clipPolygonVertices2[i], clipPolygonVertices[i], decimal(0.000001)));
+            }
+            rp3d_test(clipPolygonVerticesIds[1] == 11);
+            rp3d_test(clipPolygonVerticesIds[2] == 12);
+            rp3d_test(clipPolygonVerticesIds[0] != clipPolygonVerticesIds[3]);
+            for (uint i=10; i <= 13; i++) {
+                rp3d_test(clipPolygonVerticesIds[0] != i);
+                rp3d_test(clipPolygonVerticesIds[3] != i);
+            }
+
+            // The identifiers do not change if the polygon moves but is clipped by the same planes
+            for (uint i=0; i < polygonVertices.size(); i++) {
+                polygonVertices[i] += Vector3(decimal(0.5), decimal(0.2), 0);
+            }
+            ClippingList<uint32> clipPolygonVerticesIds2(mAllocator);
+            clipPolygonWithPlanes(polygonVertices, polygonVerticesIds, polygonPlanesPoints, polygonPlanesNormals,
+                                  clipPolygonVerticesIds2, mAllocator);
+            rp3d_test(clipPolygonVerticesIds2.size() == 4);
+            for (uint i=0; i < clipPolygonVerticesIds2.size(); i++) {
+                rp3d_test(clipPolygonVerticesIds2[i] == clipPolygonVerticesIds[i]);
+            }
+
         }
 
  };
@@ -129,6 +129,11 @@ class TestQuaternion : public Test {
             // Test method that returns a unit quaternion
             rp3d_test(approxEqual(quaternion.getUnit().length(), 1.0));
 
+            // Test method that returns an approximate unit quaternion
+            const Quaternion almostUnitQuaternion = mQuaternion1 * decimal(1.002);
+            rp3d_test(approxEqual(almostUnitQuaternion.getApproximateUnit().length(), 1.0, decimal(0.00001)));
+            rp3d_test(approxEqual(quaternion.getApproximateUnit().length(), 1.0));
+
             // Test the normalization method
             Quaternion quaternion2(4, 5, 6, 7);
             quaternion2.normalize();
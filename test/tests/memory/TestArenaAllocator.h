@@ -0,0 +1,163 @@
+/********************************************************************************
+* ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
+* Copyright (c) 2010-2018 Daniel Chappuis                                       *
+*********************************************************************************
+*                                                                               *
+* This software is provided 'as-is', without any express or implied warranty.   *
+* In no event will the authors be held liable for any damages arising from the  *
+* use of this software.                                                         *
+*                                                                               *
+* Permission is granted to anyone to use this software for any purpose,         *
+* including commercial applications, and to alter it and redistribute it        *
+* freely, subject to the following restrictions:                                *
+*                                                                               *
+* 1. The origin of this software must not be misrepresented; you must not claim *
+*    that you wrote the original software. If you use this software in a        *
+*    product, an acknowledgment in the product documentation would be           *
+*    appreciated but is not required.                                           *
+*                                                                               *
+* 2. Altered source versions must be plainly marked as such, and must not be    *
+*    misrepresented as being the original software.                             *
+*                                                                               *
+* 3. This notice may not be removed or altered from any source distribution.    *
+*                                                                               *
+********************************************************************************/
+
+#ifndef TEST_ARENA_ALLOCATOR_H
+#define TEST_ARENA_ALLOCATOR_H
+
+// Libraries
+#include "Test.h"
+#include "memory/ArenaAllocator.h"
+#include "memory/DefaultAllocator.h"
+#include <cstdint>
+
+/// Reactphysics3D namespace
+namespace reactphysics3d {
+
+// Class CountingAllocator
+/**
+ * Base allocator that counts the number of allocations
+ */
+class CountingAllocator : public DefaultAllocator {
+
+    public :
+
+        int nbAllocations = 0;
+        int nbReleases = 0;
+
+        virtual void* allocate(size_t size) override {
+            nbAllocations++;
+            return DefaultAllocator::allocate(size);
+        }
+
+        virtual void release(void* pointer, size_t size) override {
+            nbReleases++;
+            DefaultAllocator::release(pointer, size);
+        }
+};
+
+// Class TestArenaAllocator
+/**
+ * Unit test for the ArenaAllocator class
+ */
+class TestArenaAllocator : public Test {
+
+    private :
+
+        // ---------- Atributes ---------- //
+
+        CountingAllocator mBaseAllocator;
+
+    public :
+
+        // ---------- Methods ---------- //
+
+        /// Constructor
+        TestArenaAllocator(const std::string& name) : Test(name) {
+
+        }
+
+        /// Run the tests
+        void run() {
+
+            testAlignment();
+            testGrowth();
+            testRelease();
+        }
+
+        void testAlignment() {
+
+            ArenaAllocator arena(mBaseAllocator);
+
+            void* memory1 = arena.allocate(3);
+            void* memory2 = arena.allocate(100);
+            void* memory3 = arena.allocate(1);
+            rp3d_test(reinterpret_cast<uintptr_t>(memory1) % CACHE_LINE_SIZE == 0);
+            rp3d_test(reinterpret_cast<uintptr_t>(memory2) % CACHE_LINE_SIZE == 0);
+            rp3d_test(reinterpret_cast<uintptr_t>(memory3) % CACHE_LINE_SIZE == 0);
+            rp3d_test(static_cast<char*>(memory2) - static_cast<char*>(memory1) == CACHE_LINE_SIZE);
+            rp3d_test(static_cast<char*>(memory3) - static_cast<char*>(memory2) == 2 * CACHE_LINE_SIZE);
+            rp3d_test(arena.getHighWaterMark() == 4 * CACHE_LINE_SIZE);
+
+            // The memory is reused after a reset
+            arena.reset();
+            rp3d_test(arena.allocate(10) == memory1);
+            rp3d_test(arena.getHighWaterMark() == 4 * CACHE_LINE_SIZE);
+        }
+
+        void testGrowth() {
+
+            ArenaAllocator arena(mBaseAllocator);
+            const size_t initCapacity = arena.getCapacity();
+            rp3d_test(initCapacity > 0);
+
+            // Allocate more memory than the capacity in a single frame
+            void* memory1 = arena.allocate(initCapacity / 2);
+            void* memory2 = arena.allocate(initCapacity);
+            rp3d_test(memory1 != nullptr);
+            rp3d_test(memory2 != nullptr);
+            rp3d_test(reinterpret_cast<uintptr_t>(memory2) % CACHE_LINE_SIZE == 0);
+            rp3d_test(arena.getCapacity() == initCapacity);
+            rp3d_test(arena.getHighWaterMark() == initCapacity + initCapacity / 2);
+
+            // The arena grows geometrically on reset
+            arena.reset();
+            rp3d_test(arena.getCapacity() == 2 * initCapacity);
+
+            // In the steady state, the base allocator is not used anymore
+            const int nbAllocations = mBaseAllocator.nbAllocations;
+            for (int i=0; i < 10; i++) {
+                arena.allocate(initCapacity / 2);
+                arena.allocate(initCapacity);
+                arena.reset();
+            }
+            rp3d_test(mBaseAllocator.nbAllocations == nbAllocations);
+            rp3d_test(arena.getCapacity() == 2 * initCapacity);
+
+            // The arena grows enough for a large frame in a single reset
+            arena.allocate(10 * initCapacity);
+            arena.reset();
+            rp3d_test(arena.getCapacity() >= 10 * initCapacity);
+            rp3d_test(arena.getHighWaterMark() >= 10 * initCapacity);
+        }
+
+        void testRelease() {
+
+            const int nbAllocations = mBaseAllocator.nbAllocations;
+            const int nbReleases = mBaseAllocator.nbReleases;
+
+            {
+                ArenaAllocator arena(mBaseAllocator);
+                void* memory = arena.allocate(2 * arena.getCapacity());
+                arena.release(memory, 0);
+            }
+
+            // All the memory is released by the destructor
+            rp3d_test(mBaseAllocator.nbAllocations - nbAllocations == mBaseAllocator.nbReleases - nbReleases);
+        }
+ };
+
+}
+
+#endif
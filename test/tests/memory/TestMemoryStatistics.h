@@ -0,0 +1,226 @@
+/********************************************************************************
+* ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
+* Copyright (c) 2010-2018 Daniel Chappuis                                       *
+*********************************************************************************
+*                                                                               *
+* This software is provided 'as-is', without any express or implied warranty.   *
+* In no event will the authors be held liable for any damages arising from the  *
+* use of this software.                                                         *
+*                                                                               *
+* Permission is granted to anyone to use this software for any purpose,         *
+* including commercial applications, and to alter it and redistribute it        *
+* freely, subject to the following restrictions:                                *
+*                                                                               *
+* 1. The origin of this software must not be misrepresented; you must not claim *
+*    that you wrote the original software. If you use this software in a        *
+*    product, an acknowledgment in the product documentation would be           *
+*    appreciated but is not required.                                           *
+*                                                                               *
+* 2. Altered source versions must be plainly marked as such, and must not be    *
+*    misrepresented as being the original software.                             *
+*                                                                               *
+* 3. This notice may not be removed or altered from any source distribution.    *
+*                                                                               *
+********************************************************************************/
+
+#ifndef TEST_MEMORY_STATISTICS_H
+#define TEST_MEMORY_STATISTICS_H
+
+// Libraries
+#include "Test.h"
+#include "engine/DynamicsWorld.h"
+#include "body/RigidBody.h"
+#include "collision/shapes/BoxShape.h"
+#include "memory/DefaultSingleFrameAllocator.h"
+#include "memory/DefaultPoolAllocator.h"
+
+/// Reactphysics3D namespace
+namespace reactphysics3d {
+
+// Class TestMemoryStatistics
+/**
+ * Unit test for the statistics of the memory allocated by the subsystems of a world
+ */
+class TestMemoryStatistics : public Test {
+
+    private :
+
+        // ---------- Methods ---------- //
+
+        /// Step a world until its steady state and check that its steps do not allocate memory
+        void testSteadyStateWorld(const WorldSettings& settings) {
+
+            DynamicsWorld world(Vector3(0, -9.81, 0), settings);
+            BoxShape floorShape(Vector3(20, 1, 20));
+            BoxShape boxShape(Vector3(1, 1, 1));
+
+            // Reserve the memory of the bodies, pairs and contacts of the world
+            const int nbBoxes = 16;
+            world.reserveBodies(nbBoxes + 1);
+            world.reservePairs(4 * nbBoxes);
+            world.reserveContacts(4 * nbBoxes);
+
+            // The reserved arrays do not grow when the bodies are created
+            const size_t containersBytes = world.getMemoryStatistics(MemoryTag::Containers).nbBytesInUse;
+            RigidBody* floor = world.createRigidBody(Transform::identity());
+            floor->setType(BodyType::STATIC);
+            floor->addCollisionShape(&floorShape, Transform::identity(), decimal(1.0));
+            for (int i=0; i < nbBoxes; i++) {
+                RigidBody* box = world.createRigidBody(Transform(Vector3(decimal(-12.0) + (i % 4) * 6,
+                                                                         decimal(2.0),
+                                                                         decimal(-12.0) + (i / 4) * 6),
+                                                                 Quaternion::identity()));
+                box->addCollisionShape(&boxShape, Transform::identity(), decimal(1.0));
+            }
+            rp3d_test(world.getMemoryStatistics(MemoryTag::Containers).nbBytesInUse == containersBytes);
+
+            for (int i=0; i < 30; i++) {
+                world.update(decimal(1.0) / decimal(60.0));
+            }
+
+            // The steps of the steady state (boxes resting on the floor) do not allocate memory
+#ifdef IS_ALLOCATION_CHECK_ACTIVE
+            world.setAllocationCheckMode(AllocationCheckMode::REPORT);
+#endif
+            bool hasAllocated = false;
+            for (int i=0; i < 180; i++) {
+                world.update(decimal(1.0) / decimal(60.0));
+                for (int tag=0; tag < MemoryManager::NB_MEMORY_TAGS; tag++) {
+                    hasAllocated |= world.getMemoryStatistics(static_cast<MemoryTag>(tag)).nbAllocationsLastFrame > 0;
+                }
+            }
+            rp3d_test(!hasAllocated);
+
+#ifdef IS_ALLOCATION_CHECK_ACTIVE
+            rp3d_test(world.getNbAllocatingUpdates() == 0);
+            rp3d_test(world.getNbAllocationsLastUpdate() == 0);
+            rp3d_test(world.getNbHeapAllocationsLastUpdate() == 0);
+#endif
+        }
+
+        /// Reserve the capacities of a world and check that its bodies do not need more memory
+        /// blocks in the pool allocator
+        void testReservedWorld(const WorldSettings& settings, const DefaultPoolAllocator& poolAllocator) {
+
+            DynamicsWorld world(Vector3(0, -9.81, 0), settings);
+            BoxShape boxShape(Vector3(1, 1, 1));
+
+            const int nbBoxes = 64;
+            WorldCapacities capacities;
+            capacities.nbBodies = nbBoxes;
+            capacities.nbProxyShapes = nbBoxes;
+            capacities.nbOverlappingPairs = 4 * nbBoxes;
+            capacities.nbContactManifolds = 4 * nbBoxes;
+            world.reserve(capacities);
+
+            const uint nbMemoryBlocks = poolAllocator.getNbMemoryBlocks();
+            const size_t containersBytes = world.getMemoryStatistics(MemoryTag::Containers).nbBytesInUse;
+
+            // Create a grid of touching boxes
+            for (int i=0; i < nbBoxes; i++) {
+                RigidBody* box = world.createRigidBody(Transform(Vector3(decimal(1.99) * (i % 8), 0,
+                                                                         decimal(1.99) * (i / 8)),
+                                                                 Quaternion::identity()));
+                box->addCollisionShape(&boxShape, Transform::identity(), decimal(1.0));
+                box->enableGravity(false);
+            }
+            rp3d_test(poolAllocator.getNbMemoryBlocks() == nbMemoryBlocks);
+
+            // The arrays of the world and the overlapping pairs do not grow during the step
+            world.update(decimal(1.0) / decimal(60.0));
+            rp3d_test(world.getBroadPhaseStatistics().nbOverlappingPairs > 0);
+            rp3d_test(world.getMemoryStatistics(MemoryTag::Containers).nbBytesInUse == containersBytes);
+        }
+
+    public :
+
+        // ---------- Methods ---------- //
+
+        /// Constructor
+        TestMemoryStatistics(const std::string& name) : Test(name) {
+
+        }
+
+        /// Run the tests
+        void run() {
+
+            testSubsystemsStatistics();
+            testSteadyStateAllocations();
+            testWorldReserve();
+        }
+
+        void testSubsystemsStatistics() {
+
+            DynamicsWorld world(Vector3(0, -9.81, 0));
+            BoxShape boxShape(Vector3(1, 1, 1));
+
+            const size_t bodiesBytes = world.getMemoryStatistics(MemoryTag::Bodies).nbBytesInUse;
+            const size_t shapesBytes = world.getMemoryStatistics(MemoryTag::Shapes).nbBytesInUse;
+
+            // Create a stack of boxes on a static floor
+            RigidBody* floor = world.createRigidBody(Transform::identity());
+            floor->setType(BodyType::STATIC);
+            floor->addCollisionShape(&boxShape, Transform::identity(), decimal(1.0));
+            List<RigidBody*> boxes(MemoryManager::getBaseAllocator());
+            for (int i=0; i < 5; i++) {
+                RigidBody* box = world.createRigidBody(Transform(Vector3(0, decimal(2.0) + i * decimal(2.01), 0),
+                                                                 Quaternion::identity()));
+                box->addCollisionShape(&boxShape, Transform::identity(), decimal(1.0));
+                boxes.add(box);
+            }
+
+            rp3d_test(world.getMemoryStatistics(MemoryTag::Bodies).nbBytesInUse >= bodiesBytes + 6 * sizeof(RigidBody));
+            rp3d_test(world.getMemoryStatistics(MemoryTag::Shapes).nbBytesInUse >= shapesBytes + 6 * sizeof(ProxyShape));
+
+            for (int i=0; i < 60; i++) {
+                world.update(decimal(1.0) / decimal(60.0));
+            }
+
+            // The broad-phase, the contacts and the solver have allocated memory
+            rp3d_test(world.getMemoryStatistics(MemoryTag::BroadPhase).nbBytesInUse > 0);
+            rp3d_test(world.getMemoryStatistics(MemoryTag::ContactManifolds).nbBytesInUse > 0);
+            rp3d_test(world.getMemoryStatistics(MemoryTag::Solver).frameBytesHighWaterMark > 0);
+            rp3d_test(world.getMemoryStatistics(MemoryTag::NarrowPhase).frameBytesHighWaterMark > 0);
+
+            // The frame statistics are those of the last step
+            const MemoryStatistics& solverStatistics = world.getMemoryStatistics(MemoryTag::Solver);
+            rp3d_test(solverStatistics.nbFrameBytesLastFrame > 0);
+            rp3d_test(solverStatistics.nbFrameBytesCurrentFrame == 0);
+            rp3d_test(solverStatistics.nbFrameBytesLastFrame <= solverStatistics.frameBytesHighWaterMark);
+            rp3d_test(solverStatistics.peakNbBytesInUse >= solverStatistics.nbBytesInUse);
+
+            // Destroying the bodies releases their memory
+            const size_t peakBodiesBytes = world.getMemoryStatistics(MemoryTag::Bodies).peakNbBytesInUse;
+            for (uint i=0; i < boxes.size(); i++) {
+                world.destroyRigidBody(boxes[i]);
+            }
+            world.destroyRigidBody(floor);
+            rp3d_test(world.getMemoryStatistics(MemoryTag::Bodies).nbBytesInUse == bodiesBytes);
+            rp3d_test(world.getMemoryStatistics(MemoryTag::Shapes).nbBytesInUse == shapesBytes);
+            rp3d_test(world.getMemoryStatistics(MemoryTag::Bodies).peakNbBytesInUse == peakBodiesBytes);
+        }
+
+        void testSteadyStateAllocations() {
+
+            // Use a single frame allocator whose size does not depend on the previous tests
+            DefaultSingleFrameAllocator frameAllocator;
+            WorldSettings settings;
+            settings.singleFrameAllocator = &frameAllocator;
+
+            testSteadyStateWorld(settings);
+        }
+
+        void testWorldReserve() {
+
+            // Use a pool allocator whose memory blocks do not depend on the previous tests
+            DefaultPoolAllocator poolAllocator;
+            WorldSettings settings;
+            settings.poolAllocator = &poolAllocator;
+
+            testReservedWorld(settings, poolAllocator);
+        }
+ };
+
+}
+
+#endif
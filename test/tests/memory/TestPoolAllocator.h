@@ -0,0 +1,188 @@
+/********************************************************************************
+* ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
+* Copyright (c) 2010-2018 Daniel Chappuis                                       *
+*********************************************************************************
+*                                                                               *
+* This software is provided 'as-is', without any express or implied warranty.   *
+* In no event will the authors be held liable for any damages arising from the  *
+* use of this software.                                                         *
+*                                                                               *
+* Permission is granted to anyone to use this software for any purpose,         *
+* including commercial applications, and to alter it and redistribute it        *
+* freely, subject to the following restrictions:                                *
+*                                                                               *
+* 1. The origin of this software must not be misrepresented; you must not claim *
+*    that you wrote the original software. If you use this software in a        *
+*    product, an acknowledgment in the product documentation would be           *
+*    appreciated but is not required.                                           *
+*                                                                               *
+* 2. Altered source versions must be plainly marked as such, and must not be    *
+*    misrepresented as being the original software.                             *
+*                                                                               *
+* 3. This notice may not be removed or altered from any source distribution.    *
+*                                                                               *
+********************************************************************************/
+
+#ifndef TEST_POOL_ALLOCATOR_H
+#define TEST_POOL_ALLOCATOR_H
+
+// Libraries
+#include "Test.h"
+#include "TestArenaAllocator.h"
+#include "memory/DefaultPoolAllocator.h"
+#include "memory/MemoryManager.h"
+#include <vector>
+#include <cstdint>
+
+/// Reactphysics3D namespace
+namespace reactphysics3d {
+
+// Class TestPoolAllocator
+/**
+ * Unit test for the DefaultPoolAllocator class
+ */
+class TestPoolAllocator : public Test {
+
+    private :
+
+        // ---------- Atributes ---------- //
+
+        CountingAllocator mBaseAllocator;
+
+        /// Base allocator of the memory manager before the test
+        MemoryAllocator* mPreviousBaseAllocator;
+
+    public :
+
+        // ---------- Methods ---------- //
+
+        /// Constructor
+        TestPoolAllocator(const std::string& name) : Test(name), mPreviousBaseAllocator(nullptr) {
+
+        }
+
+        /// Run the tests
+        void run() {
+
+            // The pool allocators of the tests use the counting base allocator
+            mPreviousBaseAllocator = &MemoryManager::getBaseAllocator();
+            MemoryManager::setBaseAllocator(&mBaseAllocator);
+
+            testLargeUnits();
+            testReleaseFreeBlocks();
+            testReleaseWatermark();
+            testVectorAlignment();
+
+            MemoryManager::setBaseAllocator(mPreviousBaseAllocator);
+
+            rp3d_test(mBaseAllocator.nbAllocations == mBaseAllocator.nbReleases);
+        }
+
+        void testVectorAlignment() {
+
+            DefaultPoolAllocator pool;
+
+            // The memory units of all the sizes are aligned for the vectors
+            void* memory[64];
+            for (uint i=0; i < 64; i++) {
+                memory[i] = pool.allocate(i + 1);
+                rp3d_test(reinterpret_cast<std::uintptr_t>(memory[i]) % VECTOR_ALIGNMENT == 0);
+            }
+            for (uint i=0; i < 64; i++) {
+                pool.release(memory[i], i + 1);
+            }
+        }
+
+        void testLargeUnits() {
+
+            DefaultPoolAllocator pool;
+            const int nbAllocations = mBaseAllocator.nbAllocations;
+
+            // The memory units larger than 1024 bytes share a memory block
+            void* memory1 = pool.allocate(3000);
+            void* memory2 = pool.allocate(2900);
+            memset(memory1, 1, 3000);
+            memset(memory2, 2, 2900);
+            rp3d_test(mBaseAllocator.nbAllocations == nbAllocations + 1);
+            rp3d_test(pool.getNbMemoryBlocks() == 1);
+
+            // The memory units are reused
+            pool.release(memory1, 3000);
+            rp3d_test(pool.allocate(3000) == memory1);
+
+            // The allocations larger than the maximum unit size use the base allocator
+            void* memory3 = pool.allocate(DefaultPoolAllocator::MAX_UNIT_SIZE + 1);
+            rp3d_test(mBaseAllocator.nbAllocations == nbAllocations + 2);
+            pool.release(memory3, DefaultPoolAllocator::MAX_UNIT_SIZE + 1);
+
+            pool.release(memory1, 3000);
+            pool.release(memory2, 2900);
+
+            // The maximum unit size of the pool can be smaller
+            DefaultPoolAllocator smallPool(1024);
+            void* memory4 = smallPool.allocate(3000);
+            rp3d_test(smallPool.getNbMemoryBlocks() == 0);
+            smallPool.release(memory4, 3000);
+        }
+
+        void testReleaseFreeBlocks() {
+
+            DefaultPoolAllocator pool;
+
+            // Allocate units in several memory blocks
+            std::vector<void*> memories;
+            for (int i=0; i < 2000; i++) {
+                memories.push_back(pool.allocate(64));
+                memset(memories.back(), 3, 64);
+            }
+            const uint nbBlocks = pool.getNbMemoryBlocks();
+            rp3d_test(nbBlocks >= 8);
+
+            // A block with a used unit is not released
+            for (uint i=0; i < memories.size(); i++) {
+                if (i % 2 == 1) pool.release(memories[i], 64);
+            }
+            pool.releaseFreeBlocks();
+            rp3d_test(pool.getNbMemoryBlocks() == nbBlocks);
+
+            // The free units of the remaining blocks are still available
+            void* memory = pool.allocate(64);
+            memset(memory, 4, 64);
+            pool.release(memory, 64);
+
+            // The blocks whose units are all free are released
+            for (uint i=0; i < memories.size(); i++) {
+                if (i % 2 == 0) pool.release(memories[i], 64);
+            }
+            pool.releaseFreeBlocks();
+            rp3d_test(pool.getNbMemoryBlocks() == 0);
+
+            // The pool can allocate again
+            memory = pool.allocate(64);
+            memset(memory, 5, 64);
+            rp3d_test(pool.getNbMemoryBlocks() == 1);
+            pool.release(memory, 64);
+        }
+
+        void testReleaseWatermark() {
+
+            // Pool that releases its free blocks above 64 Kb of free memory
+            DefaultPoolAllocator pool(DefaultPoolAllocator::MAX_UNIT_SIZE, 65536);
+
+            std::vector<void*> memories;
+            for (int i=0; i < 4000; i++) {
+                memories.push_back(pool.allocate(128));
+            }
+            const uint nbBlocks = pool.getNbMemoryBlocks();
+
+            // The free blocks are released while the memory is released
+            for (uint i=0; i < memories.size(); i++) {
+                pool.release(memories[i], 128);
+            }
+            rp3d_test(pool.getNbMemoryBlocks() < nbBlocks / 2);
+        }
+};
+
+}
+
+#endif
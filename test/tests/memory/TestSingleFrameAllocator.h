@@ -0,0 +1,136 @@
+/********************************************************************************
+* ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
+* Copyright (c) 2010-2018 Daniel Chappuis                                       *
+*********************************************************************************
+*                                                                               *
+* This software is provided 'as-is', without any express or implied warranty.   *
+* In no event will the authors be held liable for any damages arising from the  *
+* use of this software.                                                         *
+*                                                                               *
+* Permission is granted to anyone to use this software for any purpose,         *
+* including commercial applications, and to alter it and redistribute it        *
+* freely, subject to the following restrictions:                                *
+*                                                                               *
+* 1. The origin of this software must not be misrepresented; you must not claim *
+*    that you wrote the original software. If you use this software in a        *
+*    product, an acknowledgment in the product documentation would be           *
+*    appreciated but is not required.                                           *
+*                                                                               *
+* 2. Altered source versions must be plainly marked as such, and must not be    *
+*    misrepresented as being the original software.                             *
+*                                                                               *
+* 3. This notice may not be removed or altered from any source distribution.    *
+*                                                                               *
+********************************************************************************/
+
+#ifndef TEST_SINGLE_FRAME_ALLOCATOR_H
+#define TEST_SINGLE_FRAME_ALLOCATOR_H
+
+// Libraries
+#include "Test.h"
+#include "TestArenaAllocator.h"
+#include "memory/DefaultSingleFrameAllocator.h"
+#include "memory/MemoryManager.h"
+#include "mathematics/Vector3.h"
+#include <cstdint>
+
+/// Reactphysics3D namespace
+namespace reactphysics3d {
+
+// Class TestSingleFrameAllocator
+/**
+ * Unit test for the DefaultSingleFrameAllocator class
+ */
+class TestSingleFrameAllocator : public Test {
+
+    private :
+
+        // ---------- Atributes ---------- //
+
+        CountingAllocator mBaseAllocator;
+
+        // ---------- Methods ---------- //
+
+        /// Allocate the memory of a frame and write into it
+        void allocateFrame(DefaultSingleFrameAllocator& allocator, size_t capacity) {
+
+            memset(allocator.allocate(capacity / 2), 1, capacity / 2);
+            memset(allocator.allocate(capacity), 2, capacity);
+            for (int i=0; i < 1000; i++) {
+                memset(allocator.allocate(32), 3, 32);
+            }
+        }
+
+    public :
+
+        // ---------- Methods ---------- //
+
+        /// Constructor
+        TestSingleFrameAllocator(const std::string& name) : Test(name) {
+
+        }
+
+        /// Run the tests
+        void run() {
+
+            testChainedBlocks();
+            testVectorAlignment();
+        }
+
+        void testVectorAlignment() {
+
+            DefaultSingleFrameAllocator allocator;
+
+            // The allocations of all the sizes are aligned for the vectors
+            for (uint i=0; i < 64; i++) {
+                void* memory = allocator.allocate(i + 1);
+                rp3d_test(reinterpret_cast<std::uintptr_t>(memory) % VECTOR_ALIGNMENT == 0);
+            }
+            void* vectors = allocator.allocate(10 * sizeof(Vector3));
+            rp3d_test(reinterpret_cast<std::uintptr_t>(vectors) % alignof(Vector3) == 0);
+
+            allocator.reset();
+        }
+
+        void testChainedBlocks() {
+
+            // The allocator uses the base allocator of the memory manager when it is created
+            MemoryAllocator& previousBaseAllocator = MemoryManager::getBaseAllocator();
+            MemoryManager::setBaseAllocator(&mBaseAllocator);
+            DefaultSingleFrameAllocator* allocator = new DefaultSingleFrameAllocator();
+            MemoryManager::setBaseAllocator(&previousBaseAllocator);
+
+            const size_t capacity = allocator->getCapacity();
+            rp3d_test(mBaseAllocator.nbAllocations == 1);
+
+            // When the buffer is full, a block is chained for the large allocation and
+            // another one for all the small allocations
+            rp3d_test(allocator->allocate(capacity / 2) != nullptr);
+            rp3d_test(allocator->allocate(capacity) != nullptr);
+            rp3d_test(mBaseAllocator.nbAllocations == 2);
+            for (int i=0; i < 1000; i++) {
+                rp3d_test(allocator->allocate(32) != nullptr);
+            }
+            rp3d_test(mBaseAllocator.nbAllocations == 3);
+
+            // The buffer and the chained blocks are coalesced at reset
+            allocator->reset();
+            rp3d_test(mBaseAllocator.nbReleases == 3);
+            rp3d_test(mBaseAllocator.nbAllocations == 4);
+            rp3d_test(allocator->getCapacity() >= capacity / 2 + capacity + 32000);
+
+            // The next frames fit in the buffer
+            for (int i=0; i < 3; i++) {
+                allocateFrame(*allocator, capacity);
+                allocator->reset();
+            }
+            rp3d_test(mBaseAllocator.nbAllocations == 4);
+
+            delete allocator;
+            rp3d_test(mBaseAllocator.nbReleases == mBaseAllocator.nbAllocations);
+        }
+};
+
+}
+
+#endif
@@ -0,0 +1,190 @@
+/********************************************************************************
+* ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
+* Copyright (c) 2010-2018 Daniel Chappuis                                       *
+*********************************************************************************
+*                                                                               *
+* This software is provided 'as-is', without any express or implied warranty.   *
+* In no event will the authors be held liable for any damages arising from the  *
+* use of this software.                                                         *
+*                                                                               *
+* Permission is granted to anyone to use this software for any purpose,         *
+* including commercial applications, and to alter it and redistribute it        *
+* freely, subject to the following restrictions:                                *
+*                                                                               *
+* 1. The origin of this software must not be misrepresented; you must not claim *
+*    that you wrote the original software. If you use this software in a        *
+*    product, an acknowledgment in the product documentation would be           *
+*    appreciated but is not required.                                           *
+*                                                                               *
+* 2. Altered source versions must be plainly marked as such, and must not be    *
+*    misrepresented as being the original software.                             *
+*                                                                               *
+* 3. This notice may not be removed or altered from any source distribution.    *
+*                                                                               *
+********************************************************************************/
+
+#ifndef TEST_WORKER_POOL_ALLOCATOR_H
+#define TEST_WORKER_POOL_ALLOCATOR_H
+
+// Libraries
+#include "Test.h"
+#include "memory/WorkerPoolAllocator.h"
+#include "memory/MemoryManager.h"
+#include "engine/DefaultTaskScheduler.h"
+#include <atomic>
+
+/// Reactphysics3D namespace
+namespace reactphysics3d {
+
+// Class TestWorkerPoolAllocator
+/**
+ * Unit test for the WorkerPoolAllocator class and the worker allocators of the MemoryManager
+ */
+class TestWorkerPoolAllocator : public Test {
+
+    private :
+
+        // ---------- Atributes ---------- //
+
+        /// Number of workers of the parallel test
+        static const uint NB_WORKERS = 4;
+
+        /// Number of allocations of each worker of the parallel test
+        static const uint NB_ALLOCATIONS = 2000;
+
+        // ---------- Methods ---------- //
+
+        /// Return the size of an allocation of the parallel test
+        static size_t getAllocationSize(uint index) {
+            return 1 + (index * 37) % 1500;
+        }
+
+    public :
+
+        // ---------- Methods ---------- //
+
+        /// Constructor
+        TestWorkerPoolAllocator(const std::string& name) : Test(name) {
+
+        }
+
+        /// Run the tests
+        void run() {
+
+            testRelease();
+            testMemoryManager();
+            testParallelRelease();
+        }
+
+        void testRelease() {
+
+            WorkerPoolAllocator allocator1;
+            WorkerPoolAllocator allocator2;
+
+            // The memory released by its allocator is reused
+            void* memory1 = allocator1.allocate(24);
+            allocator1.release(memory1, 24);
+            rp3d_test(allocator1.allocate(24) == memory1);
+
+            // The memory released by another allocator is given back to its allocator
+            void* memory2 = allocator1.allocate(100);
+            allocator2.release(memory2, 100);
+            void* memory3 = allocator2.allocate(100);
+            rp3d_test(memory3 != memory2);
+            rp3d_test(allocator1.allocate(100) == memory2);
+
+            allocator1.release(memory1, 24);
+            allocator1.release(memory2, 100);
+            allocator1.release(memory3, 100);
+            allocator2.flushRemoteReleases();
+        }
+
+        void testMemoryManager() {
+
+            MemoryManager memoryManager;
+            rp3d_test(memoryManager.getNbWorkerAllocators() == 0);
+
+            memoryManager.createWorkerAllocators(2);
+            rp3d_test(memoryManager.getNbWorkerAllocators() == 2);
+            WorkerPoolAllocator* poolAllocator = &memoryManager.getWorkerPoolAllocator(1);
+            SingleFrameAllocator* frameAllocator = &memoryManager.getWorkerSingleFrameAllocator(1);
+            rp3d_test(static_cast<MemoryAllocator*>(poolAllocator) != &memoryManager.getWorkerPoolAllocator(0));
+
+            // The allocators of the workers are kept when more workers are needed
+            memoryManager.createWorkerAllocators(1);
+            rp3d_test(memoryManager.getNbWorkerAllocators() == 2);
+            memoryManager.createWorkerAllocators(3);
+            rp3d_test(memoryManager.getNbWorkerAllocators() == 3);
+            rp3d_test(&memoryManager.getWorkerPoolAllocator(1) == poolAllocator);
+            rp3d_test(&memoryManager.getWorkerSingleFrameAllocator(1) == frameAllocator);
+
+            void* memory = memoryManager.getWorkerSingleFrameAllocator(2).allocate(64);
+            rp3d_test(memory != nullptr);
+            memoryManager.resetWorkerFrameAllocators();
+            rp3d_test(memoryManager.getWorkerSingleFrameAllocator(2).allocate(64) == memory);
+            memoryManager.resetWorkerFrameAllocators();
+        }
+
+        /// Each worker releases the memory allocated by another worker while it is allocating
+        void testParallelRelease() {
+
+            DefaultTaskScheduler scheduler(NB_WORKERS);
+            MemoryManager memoryManager;
+            memoryManager.createWorkerAllocators(NB_WORKERS);
+
+            unsigned char* memories[NB_WORKERS][NB_ALLOCATIONS];
+            unsigned char* newMemories[NB_WORKERS][NB_ALLOCATIONS];
+            std::atomic<uint> nbCorruptions(0);
+
+            scheduler.parallelFor(NB_WORKERS, [&](uint workerIndex) {
+                WorkerPoolAllocator& allocator = memoryManager.getWorkerPoolAllocator(workerIndex);
+                for (uint i=0; i < NB_ALLOCATIONS; i++) {
+                    const size_t size = getAllocationSize(i);
+                    memories[workerIndex][i] = static_cast<unsigned char*>(allocator.allocate(size));
+                    memset(memories[workerIndex][i], int(workerIndex + 1), size);
+                }
+            });
+
+            scheduler.parallelFor(NB_WORKERS, [&](uint workerIndex) {
+                WorkerPoolAllocator& allocator = memoryManager.getWorkerPoolAllocator(workerIndex);
+                const uint otherWorkerIndex = (workerIndex + 1) % NB_WORKERS;
+                for (uint i=0; i < NB_ALLOCATIONS; i++) {
+
+                    // Release the memory of the other worker
+                    const size_t size = getAllocationSize(i);
+                    for (size_t k=0; k < size; k++) {
+                        if (memories[otherWorkerIndex][i][k] != otherWorkerIndex + 1) {
+                            nbCorruptions++;
+                            break;
+                        }
+                    }
+                    allocator.release(memories[otherWorkerIndex][i], size);
+
+                    // Allocate new memory (that can reuse the memory released by the other worker)
+                    newMemories[workerIndex][i] = static_cast<unsigned char*>(allocator.allocate(size));
+                    memset(newMemories[workerIndex][i], int(workerIndex + 1), size);
+                }
+            });
+
+            scheduler.parallelFor(NB_WORKERS, [&](uint workerIndex) {
+                WorkerPoolAllocator& allocator = memoryManager.getWorkerPoolAllocator(workerIndex);
+                for (uint i=0; i < NB_ALLOCATIONS; i++) {
+                    const size_t size = getAllocationSize(i);
+                    for (size_t k=0; k < size; k++) {
+                        if (newMemories[workerIndex][i][k] != workerIndex + 1) {
+                            nbCorruptions++;
+                            break;
+                        }
+                    }
+                    allocator.release(newMemories[workerIndex][i], size);
+                }
+                allocator.flushRemoteReleases();
+            });
+
+            rp3d_test(nbCorruptions == 0);
+        }
+};
+
+}
+
+#endif
@@ -88,6 +88,9 @@ class Box : public PhysicsObject {
 
         /// Update the transform matrix of the object
         virtual void updateTransform(float interpolationFactor) override;
+
+        /// Return the scaling matrix of the mesh to render the object with instancing
+        virtual const openglframework::Matrix4* getInstanceScalingMatrix() const override;
 };
 
 // Update the transform matrix of the object
@@ -95,5 +98,9 @@ inline void Box::updateTransform(float interpolationFactor) {
 	mTransformMatrix = computeTransform(interpolationFactor, mScalingMatrix);
 }
 
+// Return the scaling matrix of the mesh to render the object with instancing
+inline const openglframework::Matrix4* Box::getInstanceScalingMatrix() const {
+    return &mScalingMatrix;
+}
 
 #endif
@@ -96,6 +96,9 @@ class Capsule : public PhysicsObject {
 
         /// Update the transform matrix of the object
         virtual void updateTransform(float interpolationFactor) override;
+
+        /// Return the scaling matrix of the mesh to render the object with instancing
+        virtual const openglframework::Matrix4* getInstanceScalingMatrix() const override;
 };
 
 // Update the transform matrix of the object
@@ -103,4 +106,9 @@ inline void Capsule::updateTransform(float interpolationFactor) {
 	mTransformMatrix = computeTransform(interpolationFactor, mScalingMatrix);
 }
 
+// Return the scaling matrix of the mesh to render the object with instancing
+inline const openglframework::Matrix4* Capsule::getInstanceScalingMatrix() const {
+    return &mScalingMatrix;
+}
+
 #endif
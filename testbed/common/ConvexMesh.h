@@ -92,6 +92,9 @@ class ConvexMesh : public PhysicsObject {
 
         /// Update the transform matrix of the object
         virtual void updateTransform(float interpolationFactor) override;
+
+        /// Return the scaling matrix of the mesh to render the object with instancing
+        virtual const openglframework::Matrix4* getInstanceScalingMatrix() const override;
 };
 
 // Update the transform matrix of the object
@@ -99,4 +102,9 @@ inline void ConvexMesh::updateTransform(float interpolationFactor) {
     mTransformMatrix = computeTransform(interpolationFactor, mScalingMatrix);
 }
 
+// Return the scaling matrix of the mesh to render the object with instancing
+inline const openglframework::Matrix4* ConvexMesh::getInstanceScalingMatrix() const {
+    return &mScalingMatrix;
+}
+
 #endif
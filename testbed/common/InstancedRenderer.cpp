@@ -0,0 +1,300 @@
+/********************************************************************************
+* ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
+* Copyright (c) 2010-2016 Daniel Chappuis                                       *
+*********************************************************************************
+*                                                                               *
+* This software is provided 'as-is', without any express or implied warranty.   *
+* In no event will the authors be held liable for any damages arising from the  *
+* use of this software.                                                         *
+*                                                                               *
+* Permission is granted to anyone to use this software for any purpose,         *
+* including commercial applications, and to alter it and redistribute it        *
+* freely, subject to the following restrictions:                                *
+*                                                                               *
+* 1. The origin of this software must not be misrepresented; you must not claim *
+*    that you wrote the original software. If you use this software in a        *
+*    product, an acknowledgment in the product documentation would be           *
+*    appreciated but is not required.                                           *
+*                                                                               *
+* 2. Altered source versions must be plainly marked as such, and must not be    *
+*    misrepresented as being the original software.                             *
+*                                                                               *
+* 3. This notice may not be removed or altered from any source distribution.    *
+*                                                                               *
+********************************************************************************/
+
+// Libraries
+#include "InstancedRenderer.h"
+#include <unordered_map>
+
+// Initialize static variables
+const GLuint InstancedRenderer::TRANSFORMS_TEXTURE_UNIT = 7;
+const int InstancedRenderer::NB_FLOATS_PER_INSTANCE = 12;
+
+// Constructor
+InstancedRenderer::InstancedRenderer()
+                  : mTransformsBufferID(0), mTransformsTextureID(0), mNbObjects(0), mNbBodies(0) {
+
+}
+
+// Destructor
+/// The objects of the scene may already be destroyed and are therefore not accessed here.
+InstancedRenderer::~InstancedRenderer() {
+
+    for (std::vector<Batch*>::iterator it = mBatches.begin(); it != mBatches.end(); ++it) {
+        delete *it;
+    }
+
+    if (mTransformsBufferID != 0) {
+        glDeleteTextures(1, &mTransformsTextureID);
+        glDeleteBuffers(1, &mTransformsBufferID);
+    }
+}
+
+// Update the batches of the objects and upload the transforms of the bodies
+/// The batches are built again when the number of objects of the scene or the number of
+/// bodies of the world has changed. The transforms of all the bodies are then exported
+/// from the world and uploaded with a single copy. They are interpolated by the world if
+/// the interpolation of the transforms is enabled in its settings.
+void InstancedRenderer::update(const std::vector<PhysicsObject*>& objects, rp3d::DynamicsWorld& world,
+                               float interpolationFactor) {
+
+    if (mTransformsBufferID == 0) {
+        glGenBuffers(1, &mTransformsBufferID);
+        glGenTextures(1, &mTransformsTextureID);
+    }
+
+    if (objects.size() != mNbObjects || world.getNbRigidBodies() != mNbBodies) {
+        buildBatches(objects, world);
+    }
+
+    // Export the transforms of all the bodies and upload them at once
+    mTransforms.resize(8 * mNbBodies);
+    if (mNbBodies > 0) world.getRenderTransforms(interpolationFactor, mTransforms.data());
+
+    glBindBuffer(GL_TEXTURE_BUFFER, mTransformsBufferID);
+    glBufferData(GL_TEXTURE_BUFFER, mTransforms.size() * sizeof(float), nullptr, GL_STREAM_DRAW);
+    glBufferSubData(GL_TEXTURE_BUFFER, 0, mTransforms.size() * sizeof(float), mTransforms.data());
+    glBindBuffer(GL_TEXTURE_BUFFER, 0);
+}
+
+// Build the batches of the objects and upload their per-instance data
+/// The objects with a rigid body that can be rendered with instancing are grouped by mesh.
+/// The per-instance data of an object is the index of its body in the world, the diagonal
+/// of its scaling matrix, its color and its sleeping color.
+void InstancedRenderer::buildBatches(const std::vector<PhysicsObject*>& objects, rp3d::DynamicsWorld& world) {
+
+    destroyBatches();
+
+    mNbObjects = objects.size();
+    mNbBodies = world.getNbRigidBodies();
+
+    // Index of each body in the world
+    std::unordered_map<const rp3d::CollisionBody*, float> bodyIndices;
+    bodyIndices.reserve(mNbBodies);
+    for (rp3d::uint i=0; i < mNbBodies; i++) {
+        bodyIndices[world.getRigidBody(i)] = static_cast<float>(i);
+    }
+
+    for (std::vector<PhysicsObject*>::const_iterator it = objects.begin(); it != objects.end(); ++it) {
+
+        PhysicsObject* object = *it;
+        object->setIsRenderedWithInstancing(false);
+
+        if (object->getInstanceScalingMatrix() == nullptr || object->getMeshPath().empty() ||
+            bodyIndices.find(object->getCollisionBody()) == bodyIndices.end()) {
+            continue;
+        }
+
+        // Find the batch of the mesh of the object
+        Batch* batch = nullptr;
+        for (std::vector<Batch*>::iterator itBatch = mBatches.begin(); itBatch != mBatches.end(); ++itBatch) {
+            if ((*itBatch)->meshPath == object->getMeshPath()) {
+                batch = *itBatch;
+                break;
+            }
+        }
+        if (batch == nullptr) {
+            batch = new Batch();
+            batch->meshPath = object->getMeshPath();
+            createBatchVBOAndVAO(batch, *object);
+            mBatches.push_back(batch);
+        }
+
+        batch->objects.push_back(object);
+        object->setIsRenderedWithInstancing(true);
+    }
+
+    // Upload the per-instance data of each batch
+    std::vector<float> instances;
+    for (std::vector<Batch*>::iterator itBatch = mBatches.begin(); itBatch != mBatches.end(); ++itBatch) {
+
+        Batch* batch = *itBatch;
+
+        instances.clear();
+        instances.reserve(batch->objects.size() * NB_FLOATS_PER_INSTANCE);
+        for (std::vector<PhysicsObject*>::iterator it = batch->objects.begin(); it != batch->objects.end(); ++it) {
+
+            const openglframework::Matrix4& scalingMatrix = *((*it)->getInstanceScalingMatrix());
+            const openglframework::Color& color = (*it)->getColor();
+            const openglframework::Color& sleepingColor = (*it)->getSleepingColor();
+
+            instances.push_back(bodyIndices[(*it)->getCollisionBody()]);
+            instances.push_back(scalingMatrix.getValue(0, 0));
+            instances.push_back(scalingMatrix.getValue(1, 1));
+            instances.push_back(scalingMatrix.getValue(2, 2));
+            instances.push_back(color.r);
+            instances.push_back(color.g);
+            instances.push_back(color.b);
+            instances.push_back(color.a);
+            instances.push_back(sleepingColor.r);
+            instances.push_back(sleepingColor.g);
+            instances.push_back(sleepingColor.b);
+            instances.push_back(sleepingColor.a);
+        }
+
+        batch->vboInstances.create();
+        batch->vboInstances.bind();
+        batch->vboInstances.copyDataIntoVBO(instances.size() * sizeof(float), instances.data(), GL_STATIC_DRAW);
+        batch->vboInstances.unbind();
+    }
+}
+
+// Create the Vertex Buffer Objects and the Vertex Array Object of a batch
+void InstancedRenderer::createBatchVBOAndVAO(Batch* batch, PhysicsObject& mesh) {
+
+    // Create the VBO for the vertices data
+    batch->vboVertices.create();
+    batch->vboVertices.bind();
+    size_t sizeVertices = mesh.getNbVertices() * sizeof(openglframework::Vector3);
+    batch->vboVertices.copyDataIntoVBO(sizeVertices, mesh.getVerticesPointer(), GL_STATIC_DRAW);
+    batch->vboVertices.unbind();
+
+    // Create the VBO for the normals data
+    batch->vboNormals.create();
+    batch->vboNormals.bind();
+    size_t sizeNormals = mesh.getNbVertices() * sizeof(openglframework::Vector3);
+    batch->vboNormals.copyDataIntoVBO(sizeNormals, mesh.getNormalsPointer(), GL_STATIC_DRAW);
+    batch->vboNormals.unbind();
+
+    // Create the VBO for the indices data
+    batch->nbIndices = mesh.getNbFaces(0) * 3;
+    batch->vboIndices.create();
+    batch->vboIndices.bind();
+    batch->vboIndices.copyDataIntoVBO(batch->nbIndices * sizeof(unsigned int), mesh.getIndicesPointer(), GL_STATIC_DRAW);
+    batch->vboIndices.unbind();
+
+    // Create the VAO with the VBO of indices
+    batch->vao.create();
+    batch->vao.bind();
+    batch->vboIndices.bind();
+    batch->vao.unbind();
+}
+
+// Render the batches with an instanced shader
+/// The shader must be bound. The depth pass uses shaders/instanced.vert with the depth
+/// fragment shader and the attributes of the colors are then ignored.
+void InstancedRenderer::render(openglframework::Shader& shader, const openglframework::Matrix4& worldToCameraMatrix) {
+
+    if (mBatches.empty()) return;
+
+    shader.setMatrix4x4Uniform("worldToCameraMatrix", worldToCameraMatrix);
+
+    // Bind the texture buffer with the transforms of the bodies
+    glActiveTexture(GL_TEXTURE0 + TRANSFORMS_TEXTURE_UNIT);
+    glBindTexture(GL_TEXTURE_BUFFER, mTransformsTextureID);
+    glTexBuffer(GL_TEXTURE_BUFFER, GL_RGBA32F, mTransformsBufferID);
+    shader.setIntUniform("transformsSampler", TRANSFORMS_TEXTURE_UNIT);
+
+    // Get the location of shader attribute variables
+    GLint vertexPositionLoc = shader.getAttribLocation("vertexPosition");
+    GLint vertexNormalLoc = shader.getAttribLocation("vertexNormal", false);
+    GLint instanceDataLoc = shader.getAttribLocation("instanceData");
+    GLint instanceColorLoc = shader.getAttribLocation("instanceColor", false);
+    GLint instanceSleepingColorLoc = shader.getAttribLocation("instanceSleepingColor", false);
+
+    const GLsizei stride = NB_FLOATS_PER_INSTANCE * sizeof(float);
+
+    for (std::vector<Batch*>::iterator it = mBatches.begin(); it != mBatches.end(); ++it) {
+
+        Batch* batch = *it;
+
+        batch->vao.bind();
+
+        batch->vboVertices.bind();
+        glEnableVertexAttribArray(vertexPositionLoc);
+        glVertexAttribPointer(vertexPositionLoc, 3, GL_FLOAT, GL_FALSE, 0, (char*)nullptr);
+
+        batch->vboNormals.bind();
+        if (vertexNormalLoc != -1) glVertexAttribPointer(vertexNormalLoc, 3, GL_FLOAT, GL_FALSE, 0, (char*)nullptr);
+        if (vertexNormalLoc != -1) glEnableVertexAttribArray(vertexNormalLoc);
+
+        // Per-instance data (index of the body and scaling, color and sleeping color)
+        batch->vboInstances.bind();
+        glEnableVertexAttribArray(instanceDataLoc);
+        glVertexAttribPointer(instanceDataLoc, 4, GL_FLOAT, GL_FALSE, stride, (char*)nullptr);
+        glVertexAttribDivisor(instanceDataLoc, 1);
+        if (instanceColorLoc != -1) {
+            glEnableVertexAttribArray(instanceColorLoc);
+            glVertexAttribPointer(instanceColorLoc, 4, GL_FLOAT, GL_FALSE, stride, (char*)nullptr + 4 * sizeof(float));
+            glVertexAttribDivisor(instanceColorLoc, 1);
+        }
+        if (instanceSleepingColorLoc != -1) {
+            glEnableVertexAttribArray(instanceSleepingColorLoc);
+            glVertexAttribPointer(instanceSleepingColorLoc, 4, GL_FLOAT, GL_FALSE, stride, (char*)nullptr + 8 * sizeof(float));
+            glVertexAttribDivisor(instanceSleepingColorLoc, 1);
+        }
+
+        glDrawElementsInstanced(GL_TRIANGLES, batch->nbIndices, GL_UNSIGNED_INT, (char*)nullptr,
+                                static_cast<GLsizei>(batch->objects.size()));
+
+        glVertexAttribDivisor(instanceDataLoc, 0);
+        glDisableVertexAttribArray(instanceDataLoc);
+        if (instanceColorLoc != -1) {
+            glVertexAttribDivisor(instanceColorLoc, 0);
+            glDisableVertexAttribArray(instanceColorLoc);
+        }
+        if (instanceSleepingColorLoc != -1) {
+            glVertexAttribDivisor(instanceSleepingColorLoc, 0);
+            glDisableVertexAttribArray(instanceSleepingColorLoc);
+        }
+        glDisableVertexAttribArray(vertexPositionLoc);
+        if (vertexNormalLoc != -1) glDisableVertexAttribArray(vertexNormalLoc);
+
+        batch->vboInstances.unbind();
+
+        // Unbind the VAO
+        batch->vao.unbind();
+    }
+
+    glBindTexture(GL_TEXTURE_BUFFER, 0);
+    glActiveTexture(GL_TEXTURE0);
+}
+
+// Destroy the batches
+void InstancedRenderer::destroyBatches() {
+
+    for (std::vector<Batch*>::iterator it = mBatches.begin(); it != mBatches.end(); ++it) {
+        for (std::vector<PhysicsObject*>::iterator itObject = (*it)->objects.begin(); itObject != (*it)->objects.end(); ++itObject) {
+            (*itObject)->setIsRenderedWithInstancing(false);
+        }
+        delete *it;
+    }
+    mBatches.clear();
+    mNbObjects = 0;
+    mNbBodies = 0;
+}
+
+// Stop rendering the objects with instancing and destroy the OpenGL objects
+/// The objects of the scene must still exist when this method is called.
+void InstancedRenderer::destroy() {
+
+    destroyBatches();
+
+    if (mTransformsBufferID != 0) {
+        glDeleteTextures(1, &mTransformsTextureID);
+        glDeleteBuffers(1, &mTransformsBufferID);
+        mTransformsTextureID = 0;
+        mTransformsBufferID = 0;
+    }
+}
@@ -0,0 +1,143 @@
+/********************************************************************************
+ * ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
+ * Copyright (c) 2010-2016 Daniel Chappuis                                       *
+ *********************************************************************************
+ *                                                                               *
+ * This software is provided 'as-is', without any express or implied warranty.   *
+ * In no event will the authors be held liable for any damages arising from the  *
+ * use of this software.                                                         *
+ *                                                                               *
+ * Permission is granted to anyone to use this software for any purpose,         *
+ * including commercial applications, and to alter it and redistribute it        *
+ * freely, subject to the following restrictions:                                *
+ *                                                                               *
+ * 1. The origin of this software must not be misrepresented; you must not claim *
+ *    that you wrote the original software. If you use this software in a        *
+ *    product, an acknowledgment in the product documentation would be           *
+ *    appreciated but is not required.                                           *
+ *                                                                               *
+ * 2. Altered source versions must be plainly marked as such, and must not be    *
+ *    misrepresented as being the original software.                             *
+ *                                                                               *
+ * 3. This notice may not be removed or altered from any source distribution.    *
+ *                                                                               *
+ ********************************************************************************/
+
+#ifndef INSTANCED_RENDERER_H
+#define INSTANCED_RENDERER_H
+
+// Libraries
+#include "openglframework.h"
+#include "reactphysics3d.h"
+#include "PhysicsObject.h"
+#include <vector>
+
+// Class InstancedRenderer
+/// This class renders the rigid bodies of a dynamics world that share the same mesh with a
+/// single instanced draw call per mesh. The transforms of all the bodies are exported at once
+/// with DynamicsWorld::getRenderTransforms() and uploaded into a texture buffer that is read
+/// by the vertex shader (shaders/instanced.vert). The per-instance data (index of the body,
+/// scaling and colors) only changes when bodies are added or removed from the scene and is
+/// uploaded again in that case only. This keeps the cost of the rendering low enough to
+/// display scenes with a very large number of bodies.
+class InstancedRenderer {
+
+    private :
+
+        // -------------------- Constants -------------------- //
+
+        /// Texture unit of the texture buffer with the transforms of the bodies
+        static const GLuint TRANSFORMS_TEXTURE_UNIT;
+
+        /// Number of floats of the per-instance data of an object
+        static const int NB_FLOATS_PER_INSTANCE;
+
+        // -------------------- Types -------------------- //
+
+        /// Objects that share a mesh and that are drawn with a single draw call
+        struct Batch {
+
+            /// Path of the mesh file of the objects
+            std::string meshPath;
+
+            /// Number of indices of the mesh
+            GLsizei nbIndices;
+
+            /// Vertex Buffer Object for the vertices data
+            openglframework::VertexBufferObject vboVertices;
+
+            /// Vertex Buffer Object for the normals data
+            openglframework::VertexBufferObject vboNormals;
+
+            /// Vertex Buffer Object for the indices
+            openglframework::VertexBufferObject vboIndices;
+
+            /// Vertex Buffer Object for the per-instance data
+            openglframework::VertexBufferObject vboInstances;
+
+            /// Vertex Array Object for the vertex data
+            openglframework::VertexArrayObject vao;
+
+            /// Objects of the batch
+            std::vector<PhysicsObject*> objects;
+
+            /// Constructor
+            Batch() : nbIndices(0), vboVertices(GL_ARRAY_BUFFER), vboNormals(GL_ARRAY_BUFFER),
+                      vboIndices(GL_ELEMENT_ARRAY_BUFFER), vboInstances(GL_ARRAY_BUFFER) {
+
+            }
+        };
+
+        // -------------------- Attributes -------------------- //
+
+        /// Batches of objects (one for each mesh)
+        std::vector<Batch*> mBatches;
+
+        /// Transforms of the bodies exported from the world (8 floats per body)
+        std::vector<float> mTransforms;
+
+        /// ID of the buffer with the transforms of the bodies
+        GLuint mTransformsBufferID;
+
+        /// ID of the texture buffer that gives access to the transforms in the shaders
+        GLuint mTransformsTextureID;
+
+        /// Number of objects of the scene when the batches have been built
+        size_t mNbObjects;
+
+        /// Number of rigid bodies of the world when the batches have been built
+        rp3d::uint mNbBodies;
+
+        // -------------------- Methods -------------------- //
+
+        /// Build the batches of the objects and upload their per-instance data
+        void buildBatches(const std::vector<PhysicsObject*>& objects, rp3d::DynamicsWorld& world);
+
+        /// Create the Vertex Buffer Objects and the Vertex Array Object of a batch
+        void createBatchVBOAndVAO(Batch* batch, PhysicsObject& mesh);
+
+        /// Destroy the batches
+        void destroyBatches();
+
+    public :
+
+        // -------------------- Methods -------------------- //
+
+        /// Constructor
+        InstancedRenderer();
+
+        /// Destructor
+        ~InstancedRenderer();
+
+        /// Update the batches of the objects and upload the transforms of the bodies
+        void update(const std::vector<PhysicsObject*>& objects, rp3d::DynamicsWorld& world,
+                    float interpolationFactor);
+
+        /// Render the batches with an instanced shader
+        void render(openglframework::Shader& shader, const openglframework::Matrix4& worldToCameraMatrix);
+
+        /// Stop rendering the objects with instancing and destroy the OpenGL objects
+        void destroy();
+};
+
+#endif
@@ -32,11 +32,14 @@ PhysicsObject::PhysicsObject() : openglframework::Mesh() {
     mBody = nullptr;
     mColor = openglframework::Color(1, 1, 1, 1);
     mSleepingColor = openglframework::Color(1, 0, 0, 1);
+    mIsRenderedWithInstancing = false;
 }
 
 /// Constructor
 PhysicsObject::PhysicsObject(const std::string& meshPath) : PhysicsObject() {
 
+    mMeshPath = meshPath;
+
     // Load the mesh from a file
     openglframework::MeshReaderWriter::loadMeshFromFile(meshPath, *this);
 
@@ -47,6 +47,12 @@ class PhysicsObject : public openglframework::Mesh {
         /// Sleeping color
         openglframework::Color mSleepingColor;
 
+        /// Path of the mesh file of the object (empty if the mesh is not loaded from a file)
+        std::string mMeshPath;
+
+        /// True if the object is currently rendered by an InstancedRenderer
+        bool mIsRenderedWithInstancing;
+
         // Compute the new transform matrix
         openglframework::Matrix4 computeTransform(float interpolationFactor,
                                                  const openglframework::Matrix4 &scalingMatrix);
@@ -65,9 +71,15 @@ class PhysicsObject : public openglframework::Mesh {
 		/// Render the sphere at the correct position and with the correct orientation
         virtual void render(openglframework::Shader& shader, const openglframework::Matrix4& worldToCameraMatrix)=0;
 
+        /// Return the color of the box
+        const openglframework::Color& getColor() const;
+
         /// Set the color of the box
         void setColor(const openglframework::Color& color);
 
+        /// Return the sleeping color of the box
+        const openglframework::Color& getSleepingColor() const;
+
         /// Set the sleeping color of the box
         void setSleepingColor(const openglframework::Color& color);
 
@@ -82,13 +94,35 @@ class PhysicsObject : public openglframework::Mesh {
 
         /// Return a pointer to the rigid body of the box
         reactphysics3d::RigidBody* getRigidBody();
+
+        /// Return the path of the mesh file of the object
+        const std::string& getMeshPath() const;
+
+        /// Return the scaling matrix of the mesh if the object can be rendered with instancing
+        virtual const openglframework::Matrix4* getInstanceScalingMatrix() const;
+
+        /// Return true if the object is currently rendered by an InstancedRenderer
+        bool isRenderedWithInstancing() const;
+
+        /// Set whether the object is currently rendered by an InstancedRenderer
+        void setIsRenderedWithInstancing(bool isRenderedWithInstancing);
 };
 
+// Return the color of the box
+inline const openglframework::Color& PhysicsObject::getColor() const {
+    return mColor;
+}
+
 // Set the color of the box
 inline void PhysicsObject::setColor(const openglframework::Color& color) {
     mColor = color;
 }
 
+// Return the sleeping color of the box
+inline const openglframework::Color& PhysicsObject::getSleepingColor() const {
+    return mSleepingColor;
+}
+
 // Set the sleeping color of the box
 inline void PhysicsObject::setSleepingColor(const openglframework::Color& color) {
     mSleepingColor = color;
@@ -109,5 +143,27 @@ inline rp3d::RigidBody* PhysicsObject::getRigidBody() {
     return dynamic_cast<rp3d::RigidBody*>(mBody);
 }
 
+// Return the path of the mesh file of the object
+inline const std::string& PhysicsObject::getMeshPath() const {
+    return mMeshPath;
+}
+
+// Return the scaling matrix of the mesh if the object can be rendered with instancing
+/// The objects that share a mesh file and that return a scaling matrix are drawn together
+/// by an InstancedRenderer. The other objects are rendered one by one.
+inline const openglframework::Matrix4* PhysicsObject::getInstanceScalingMatrix() const {
+    return nullptr;
+}
+
+// Return true if the object is currently rendered by an InstancedRenderer
+inline bool PhysicsObject::isRenderedWithInstancing() const {
+    return mIsRenderedWithInstancing;
+}
+
+// Set whether the object is currently rendered by an InstancedRenderer
+inline void PhysicsObject::setIsRenderedWithInstancing(bool isRenderedWithInstancing) {
+    mIsRenderedWithInstancing = isRenderedWithInstancing;
+}
+
 #endif
 
@@ -92,6 +92,9 @@ class Sphere : public PhysicsObject {
 
         /// Update the transform matrix of the object
         virtual void updateTransform(float interpolationFactor) override;
+
+        /// Return the scaling matrix of the mesh to render the object with instancing
+        virtual const openglframework::Matrix4* getInstanceScalingMatrix() const override;
 };
 
 // Update the transform matrix of the object
@@ -99,4 +102,9 @@ inline void Sphere::updateTransform(float interpolationFactor) {
     mTransformMatrix = computeTransform(interpolationFactor, mScalingMatrix);
 }
 
+// Return the scaling matrix of the mesh to render the object with instancing
+inline const openglframework::Matrix4* Sphere::getInstanceScalingMatrix() const {
+    return &mScalingMatrix;
+}
+
 #endif
@@ -0,0 +1,80 @@
+#version 330
+
+/********************************************************************************
+* OpenGL-Framework                                                              *
+* Copyright (c) 2015 Daniel Chappuis                                            *
+*********************************************************************************
+*                                                                               *
+* This software is provided 'as-is', without any express or implied warranty.   *
+* In no event will the authors be held liable for any damages arising from the  *
+* use of this software.                                                         *
+*                                                                               *
+* Permission is granted to anyone to use this software for any purpose,         *
+* including commercial applications, and to alter it and redistribute it        *
+* freely, subject to the following restrictions:                                *
+*                                                                               *
+* 1. The origin of this software must not be misrepresented; you must not claim *
+*    that you wrote the original software. If you use this software in a        *
+*    product, an acknowledgment in the product documentation would be           *
+*    appreciated but is not required.                                           *
+*                                                                               *
+* 2. Altered source versions must be plainly marked as such, and must not be    *
+*    misrepresented as being the original software.                             *
+*                                                                               *
+* 3. This notice may not be removed or altered from any source distribution.    *
+*                                                                               *
+********************************************************************************/
+
+// Uniform variables
+uniform mat4 worldToCameraMatrix;       // World-space to camera-space matrix
+uniform mat4 worldToLight0CameraMatrix; // World-space to light0 camera-space matrix (for shadow mapping)
+uniform mat4 projectionMatrix;          // Projection matrix
+uniform mat4 shadowMapProjectionMatrix; // Shadow map projection matrix
+uniform samplerBuffer transformsSampler; // Transforms of the bodies (position and sleeping flag, orientation)
+
+// In variables
+in vec4 vertexPosition;
+in vec3 vertexNormal;
+in vec4 instanceData;                   // Index of the body of the instance and scaling of the mesh
+in vec4 instanceColor;                  // Color of the instance
+in vec4 instanceSleepingColor;          // Color of the instance when its body is sleeping
+
+// Out variables
+out vec3 vertexPosCameraSpace;      // Camera-space position of the vertex
+out vec3 vertexNormalCameraSpace;   // Vertex normal in camera-space
+out vec4 shadowMapCoords;           // Shadow map texture coords
+out vec4 vertexColor;               // Color of the vertex
+
+// Rotate a vector with a unit quaternion
+vec3 rotate(vec4 q, vec3 v) {
+    return v + 2.0 * cross(q.xyz, cross(q.xyz, v) + q.w * v);
+}
+
+void main() {
+
+    // Get the transform of the body of the instance
+    int bodyIndex = int(instanceData.x);
+    vec4 positionAndSleeping = texelFetch(transformsSampler, 2 * bodyIndex);
+    vec4 orientation = texelFetch(transformsSampler, 2 * bodyIndex + 1);
+    vec3 scaling = instanceData.yzw;
+
+    // Compute the world-space vertex position
+    vec4 positionWorldSpace = vec4(rotate(orientation, scaling * vertexPosition.xyz) + positionAndSleeping.xyz, 1.0);
+
+    // Compute the vertex position
+    vec4 positionCameraSpace = worldToCameraMatrix * positionWorldSpace;
+    vertexPosCameraSpace = positionCameraSpace.xyz;
+
+    // Compute the camera-space surface normal (inverse transpose of the scaling)
+    vec3 normalWorldSpace = rotate(orientation, vertexNormal / scaling);
+    vertexNormalCameraSpace = mat3(worldToCameraMatrix) * normalWorldSpace;
+
+    // Get the color of the instance
+    vertexColor = positionAndSleeping.w > 0.5 ? instanceSleepingColor : instanceColor;
+
+    // Compute the texture coords of the vertex in the shadow map
+    shadowMapCoords = shadowMapProjectionMatrix * worldToLight0CameraMatrix * positionWorldSpace;
+
+    // Compute the clip-space vertex coordinates
+    gl_Position = projectionMatrix * positionCameraSpace;
+}
@@ -429,6 +429,13 @@ void Gui::createSettingsPanel() {
         mApp->mIsWireframeEnabled = value;
     });
 
+    // Enable/Disable instanced rendering
+    CheckBox* checkboxInstancing = new CheckBox(mRenderingPanel, "Instanced rendering");
+    checkboxInstancing->setChecked(mApp->mIsInstancedRenderingEnabled);
+    checkboxInstancing->setCallback([&](bool value) {
+        mApp->mIsInstancedRenderingEnabled = value;
+    });
+
     mPhysicsPanel->setVisible(true);
     mRenderingPanel->setVisible(false);
 }
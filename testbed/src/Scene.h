@@ -136,6 +136,9 @@ class Scene {
         /// True if we render shapes in wireframe mode
         bool mIsWireframeEnabled;
 
+        /// True if the bodies that share a mesh are rendered with instancing
+        bool mIsInstancedRenderingEnabled;
+
         // -------------------- Methods -------------------- //
 
         /// Set the scene position (where the camera needs to look at)
@@ -230,6 +233,12 @@ class Scene {
         /// Enable/disbale wireframe rendering
         void setIsWireframeEnabled(bool isEnabled);
 
+        /// Return true if instanced rendering is enabled
+        bool getIsInstancedRenderingEnabled() const;
+
+        /// Enable/disable instanced rendering
+        void setIsInstancedRenderingEnabled(bool isEnabled);
+
         /// Return all the contact points of the scene
         std::vector<ContactPoint> virtual getContactPoints();
 
@@ -306,6 +315,16 @@ inline void Scene::setIsWireframeEnabled(bool isEnabled) {
     mIsWireframeEnabled = isEnabled;
 }
 
+// Return true if instanced rendering is enabled
+inline bool Scene::getIsInstancedRenderingEnabled() const {
+    return mIsInstancedRenderingEnabled;
+}
+
+// Enable/disable instanced rendering
+inline void Scene::setIsInstancedRenderingEnabled(bool isEnabled) {
+    mIsInstancedRenderingEnabled = isEnabled;
+}
+
 // Return all the contact points of the scene
 inline std::vector<ContactPoint> Scene::getContactPoints() {
 
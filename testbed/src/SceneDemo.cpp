@@ -49,6 +49,8 @@ SceneDemo::SceneDemo(const std::string& name, EngineSettings& settings, float sc
                      mDepthShader("shaders/depth.vert", "shaders/depth.frag"),
                      mPhongShader("shaders/phong.vert", "shaders/phong.frag"),
 					 mColorShader("shaders/color.vert", "shaders/color.frag"),
+                     mInstancedPhongShader("shaders/instanced.vert", "shaders/instanced.frag"),
+                     mInstancedDepthShader("shaders/instanced.vert", "shaders/depth.frag"),
                      mQuadShader("shaders/quad.vert", "shaders/quad.frag"),
                      mVBOQuad(GL_ARRAY_BUFFER), mMeshFolderPath("meshes/"),
                      mPhysicsWorld(nullptr) {
@@ -96,6 +98,8 @@ SceneDemo::~SceneDemo() {
 	mPhongShader.destroy();
 	mQuadShader.destroy();
 	mColorShader.destroy();
+    mInstancedPhongShader.destroy();
+    mInstancedDepthShader.destroy();
 
     // Destroy the contact points
     removeAllContactPoints();
@@ -112,9 +116,20 @@ void SceneDemo::update() {
     // Update the contact points
     updateContactPoints();
 
+    // Upload the transforms of all the bodies for the objects rendered with instancing
+    const bool isInstancedRendering = isInstancedRenderingActive();
+    if (isInstancedRendering) {
+        mInstancedRenderer.update(mPhysicsObjects, *getDynamicsWorld(), mInterpolationFactor);
+    }
+    else {
+        mInstancedRenderer.destroy();
+    }
+
 	// Update the position and orientation of the physics objects
 	for (std::vector<PhysicsObject*>::iterator it = mPhysicsObjects.begin(); it != mPhysicsObjects.end(); ++it) {
 
+        if (isInstancedRendering && (*it)->isRenderedWithInstancing()) continue;
+
 		// Update the transform used for the rendering
 		(*it)->updateTransform(mInterpolationFactor);
 	}
@@ -173,6 +188,14 @@ void SceneDemo::render() {
         // Unbind the shader
         mDepthShader.unbind();
 
+        // Render the objects of the scene rendered with instancing
+        if (isInstancedRenderingActive()) {
+            mInstancedDepthShader.bind();
+            mInstancedDepthShader.setMatrix4x4Uniform("projectionMatrix", shadowMapProjMatrix);
+            mInstancedRenderer.render(mInstancedDepthShader, worldToLightCameraMatrix);
+            mInstancedDepthShader.unbind();
+        }
+
         mFBOShadowMap.unbind();
 
         glDisable(GL_POLYGON_OFFSET_FILL);
@@ -202,6 +225,19 @@ void SceneDemo::render() {
     mPhongShader.setVector2Uniform("shadowMapDimension", Vector2(SHADOWMAP_WIDTH, SHADOWMAP_HEIGHT));
 	mPhongShader.unbind();
 
+    // Set the variables of the instanced phong shader
+    mInstancedPhongShader.bind();
+    mInstancedPhongShader.setMatrix4x4Uniform("projectionMatrix", mCamera.getProjectionMatrix());
+    mInstancedPhongShader.setMatrix4x4Uniform("shadowMapProjectionMatrix", mShadowMapBiasMatrix * shadowMapProjMatrix);
+    mInstancedPhongShader.setMatrix4x4Uniform("worldToLight0CameraMatrix", worldToLightCameraMatrix);
+    mInstancedPhongShader.setVector3Uniform("light0PosCameraSpace", worldToCameraMatrix * mLight0.getOrigin());
+    mInstancedPhongShader.setVector3Uniform("lightAmbientColor", Vector3(0.4f, 0.4f, 0.4f));
+    mInstancedPhongShader.setVector3Uniform("light0DiffuseColor", Vector3(diffCol.r, diffCol.g, diffCol.b));
+    mInstancedPhongShader.setIntUniform("shadowMapSampler", textureUnit);
+    mInstancedPhongShader.setIntUniform("isShadowEnabled", mIsShadowMappingEnabled);
+    mInstancedPhongShader.setVector2Uniform("shadowMapDimension", Vector2(SHADOWMAP_WIDTH, SHADOWMAP_HEIGHT));
+    mInstancedPhongShader.unbind();
+
 	// Set the variables of the color shader
 	mColorShader.bind();
 	mColorShader.setMatrix4x4Uniform("projectionMatrix", mCamera.getProjectionMatrix());
@@ -219,6 +255,15 @@ void SceneDemo::render() {
     // Render the objects of the scene
     renderSinglePass(mPhongShader, worldToCameraMatrix);
 
+    // Render the objects of the scene rendered with instancing
+    if (isInstancedRenderingActive()) {
+        if (mIsWireframeEnabled) glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
+        mInstancedPhongShader.bind();
+        mInstancedRenderer.render(mInstancedPhongShader, worldToCameraMatrix);
+        mInstancedPhongShader.unbind();
+        if (mIsWireframeEnabled) glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
+    }
+
     // Render the contact points
     if (mIsContactPointsDisplayed) {
         renderContactPoints(mPhongShader, worldToCameraMatrix);
@@ -245,8 +290,10 @@ void SceneDemo::renderSinglePass(openglframework::Shader& shader, const openglfr
     // Bind the shader
 	shader.bind();
 
-	// Render all the physics objects of the scene
+	// Render all the physics objects of the scene (except the ones rendered with instancing)
+    const bool isInstancedRendering = isInstancedRenderingActive();
 	for (std::vector<PhysicsObject*>::iterator it = mPhysicsObjects.begin(); it != mPhysicsObjects.end(); ++it) {
+        if (isInstancedRendering && (*it)->isRenderedWithInstancing()) continue;
         (*it)->render(mIsWireframeEnabled ? mColorShader : shader, worldToCameraMatrix);
 	}
 
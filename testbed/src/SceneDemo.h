@@ -31,6 +31,7 @@
 #include "VisualContactPoint.h"
 #include "reactphysics3d.h"
 #include "PhysicsObject.h"
+#include "InstancedRenderer.h"
 
 // Constants
 const int SHADOWMAP_WIDTH = 2048;
@@ -77,6 +78,15 @@ class SceneDemo : public Scene {
 		/// Constant color shader
 		openglframework::Shader mColorShader;
 
+        /// Phong shader for the objects rendered with instancing
+        openglframework::Shader mInstancedPhongShader;
+
+        /// Depth shader for the objects rendered with instancing
+        openglframework::Shader mInstancedDepthShader;
+
+        /// Renderer of the objects that share a mesh with instancing
+        InstancedRenderer mInstancedRenderer;
+
         // TODO : Delete this
         openglframework::Shader mQuadShader;
 
@@ -131,6 +141,9 @@ class SceneDemo : public Scene {
         /// Return a reference to the dynamics world
         const rp3d::DynamicsWorld* getDynamicsWorld() const;
 
+        /// Return true if the objects that share a mesh are currently rendered with instancing
+        bool isInstancedRenderingActive() const;
+
     public:
 
         // -------------------- Methods -------------------- //
@@ -184,6 +197,11 @@ inline const rp3d::DynamicsWorld* SceneDemo::getDynamicsWorld() const {
     return dynamic_cast<rp3d::DynamicsWorld*>(mPhysicsWorld);
 }
 
+// Return true if the objects that share a mesh are currently rendered with instancing
+inline bool SceneDemo::isInstancedRenderingActive() const {
+    return mIsInstancedRenderingEnabled && getDynamicsWorld() != nullptr;
+}
+
 #endif
 
 
@@ -62,7 +62,7 @@ TestbedApplication::TestbedApplication(bool isFullscreen)
                      mSinglePhysicsStepEnabled(false), mSinglePhysicsStepDone(false),
                      mWindowToFramebufferRatio(Vector2(1, 1)), mIsShadowMappingEnabled(true),
                      mIsContactPointsDisplayed(false), mIsAABBsDisplayed(false), mIsWireframeEnabled(false),
-                     mIsVSyncEnabled(true) {
+                     mIsInstancedRenderingEnabled(true), mIsVSyncEnabled(true) {
 
     init();
 
@@ -207,6 +207,9 @@ void TestbedApplication::update() {
     // Enable/Disable wireframe mode
     mCurrentScene->setIsWireframeEnabled(mIsWireframeEnabled);
 
+    // Enable/Disable instanced rendering
+    mCurrentScene->setIsInstancedRenderingEnabled(mIsInstancedRenderingEnabled);
+
     // Update the scene
     mCurrentScene->update();
 }
@@ -109,6 +109,9 @@ class TestbedApplication : public Screen {
         /// True if the wireframe rendering is enabled
         bool mIsWireframeEnabled;
 
+        /// True if the instanced rendering is enabled
+        bool mIsInstancedRenderingEnabled;
+
         /// True if vsync is enabled
         bool mIsVSyncEnabled;
 